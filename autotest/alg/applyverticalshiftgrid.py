@@ -322,3 +322,28 @@ def test_applyverticalshiftgrid_7():
 
 
 
+
+###############################################################################
+# Test NUM_THREADS and GRID_CACHE_SIZE options
+
+
+def test_applyverticalshiftgrid_num_threads_and_grid_cache():
+
+    src_ds = gdal.Open('../gcore/data/byte.tif')
+    src_ds = gdal.Translate('', src_ds, format='MEM',
+                            width=20, height=40)
+    grid_ds = gdal.Translate('', src_ds, format='MEM')
+
+    out_ds = gdal.ApplyVerticalShiftGrid(src_ds, grid_ds,
+                                         options=['BLOCKSIZE=15'])
+    ref_data = out_ds.ReadRaster()
+
+    # Tiny grid cache, so that grid blocks get evicted and warped again
+    out_ds = gdal.ApplyVerticalShiftGrid(src_ds, grid_ds,
+                                         options=['BLOCKSIZE=15',
+                                                  'NUM_THREADS=4',
+                                                  'GRID_CACHE_SIZE=0'])
+    assert out_ds.ReadRaster() == ref_data
+    out_ds.FlushCache()
+    assert out_ds.ReadRaster() == ref_data
+    assert out_ds.GetRasterBand(1).Checksum() == 10038
@@ -347,6 +347,35 @@ def test_contour_raster_acquisition_error():
                                         options = [ "LEVEL_INTERVAL=1",
                                                     "ID_FIELD=0"] ) != 0
 
+###############################################################################
+# Check that NUM_THREADS gives the same result as the single-threaded mode
+
+
+@pytest.mark.parametrize("polygonize", ['NO', 'YES'])
+def test_contour_num_threads(polygonize):
+
+    def get_geoms(num_threads):
+        ogr_ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+        ogr_lyr = ogr_ds.CreateLayer('contour')
+        field_defn = ogr.FieldDefn('ID', ogr.OFTInteger)
+        ogr_lyr.CreateField(field_defn)
+        field_defn = ogr.FieldDefn('elev', ogr.OFTReal)
+        ogr_lyr.CreateField(field_defn)
+
+        ds = gdal.Open('data/contour_in.tif')
+        assert gdal.ContourGenerateEx(ds.GetRasterBand(1), ogr_lyr,
+                                      options = [ "LEVEL_INTERVAL=10",
+                                                  "ID_FIELD=0",
+                                                  "ELEV_FIELD=1",
+                                                  "POLYGONIZE=" + polygonize,
+                                                  "NUM_THREADS=" + num_threads] ) == 0
+        return [(f.GetField('elev'), f.GetGeometryRef().ExportToWkt()) for f in ogr_lyr]
+
+    ref = get_geoms('1')
+    assert ref
+    assert get_geoms('4') == ref
+    assert get_geoms('ALL_CPUS') == ref
+
 ###############################################################################
 # Cleanup
 
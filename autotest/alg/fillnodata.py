@@ -87,3 +87,17 @@ def test_fillnodata_nodata(width, height, input_ar, maxSearchDist, expected):
                     maskBand = None, smoothingIterations = 0)
     ar = ds.ReadRaster()
     assert struct.unpack('B' * npixels, ar) == expected
+
+
+def test_fillnodata_num_threads():
+
+    def fill(options):
+        ds = gdal.Translate('', 'data/pat.tif', format='MEM')
+        ds.GetRasterBand(1).SetNoDataValue(0)
+        gdal.FillNodata(targetBand = ds.GetRasterBand(1),
+                        maxSearchDist = 5,
+                        maskBand = None, smoothingIterations = 1,
+                        options = options)
+        return ds.ReadRaster()
+
+    assert fill(['NUM_THREADS=4']) == fill([])
@@ -327,3 +327,25 @@ def test_polygonize_7():
 
     for key, value in dn_area_raster.items():
         assert abs(value - dn_area_vector[key]) < pixel_area, 'polygonized vector area not match raster area'
+
+###############################################################################
+# Test that NUM_THREADS produces the same features, in the same order.
+
+def test_polygonize_num_threads():
+
+    src_ds = gdal.Open('data/polygonize_check_area.tif')
+    src_band = src_ds.GetRasterBand(1)
+
+    def polygonize(options):
+        mem_ds = ogr.GetDriverByName('Memory').CreateDataSource('out')
+        mem_layer = mem_ds.CreateLayer('poly', None, ogr.wkbPolygon)
+        mem_layer.CreateField(ogr.FieldDefn('DN', ogr.OFTInteger))
+        result = gdal.Polygonize(src_band, src_band.GetMaskBand(), mem_layer,
+                                 0, options)
+        assert result == 0, 'Polygonize failed'
+        return [(f.GetField('DN'), f.GetGeometryRef().ExportToWkt())
+                for f in mem_layer]
+
+    ref = polygonize([])
+    assert ref
+    assert polygonize(['NUM_THREADS=4']) == ref
@@ -31,7 +31,11 @@
 
 
 
+import math
+import struct
+
 from osgeo import gdal
+import gdaltest
 import pytest
 
 ###############################################################################
@@ -128,6 +132,79 @@ def test_proximity_3():
     if cs != cs_expected:
         print('Got: ', cs)
         pytest.fail('got wrong checksum')
-    
 
+###############################################################################
+# Check that the multi-threaded implementation computes exact distances
+
+
+def test_proximity_num_threads():
+
+    src_ds = gdal.Open('data/pat.tif')
+    src_band = src_ds.GetRasterBand(1)
+    xsize = src_ds.RasterXSize
+    ysize = src_ds.RasterYSize
+    src_data = struct.unpack('B' * xsize * ysize, src_band.ReadRaster())
+    targets = [(i % xsize, i // xsize)
+               for i in range(xsize * ysize) if src_data[i] in (64, 65)]
+
+    dst_ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize, 1,
+                                                gdal.GDT_Float32)
+    dst_band = dst_ds.GetRasterBand(1)
+    gdal.ComputeProximity(src_band, dst_band,
+                          options=['VALUES=65,64',
+                                   'MAXDIST=7',
+                                   'MINDIST=2',
+                                   'NODATA=-1',
+                                   'NUM_THREADS=4'])
+    got = struct.unpack('f' * xsize * ysize,
+                        dst_band.ReadRaster(buf_type=gdal.GDT_Float32))
+
+    for y in range(ysize):
+        for x in range(xsize):
+            dist = min(math.sqrt((x - tx) ** 2 + (y - ty) ** 2)
+                       for (tx, ty) in targets)
+            expected = dist if 2 <= dist <= 7 else -1
+            assert got[y * xsize + x] == pytest.approx(expected, abs=1e-5), \
+                (x, y)
+
+###############################################################################
+# Check that NUM_THREADS is ignored when MAXDIST is not set
+
+
+def test_proximity_num_threads_without_maxdist():
 
+    src_ds = gdal.Open('data/pat.tif')
+    src_band = src_ds.GetRasterBand(1)
+
+    def compute(options):
+        dst_ds = gdal.GetDriverByName('MEM').Create('', 25, 25, 1,
+                                                    gdal.GDT_Float32)
+        gdal.ComputeProximity(src_band, dst_ds.GetRasterBand(1),
+                              options=['VALUES=65,64', 'NODATA=-1'] + options)
+        return dst_ds.GetRasterBand(1).ReadRaster()
+
+    expected = compute([])
+    with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+        assert compute([]) == expected
+    assert compute(['NUM_THREADS=4']) == expected
+
+###############################################################################
+# Try MINDIST option
+
+
+def test_proximity_mindist():
+
+    src_ds = gdal.Open('data/pat.tif')
+    src_band = src_ds.GetRasterBand(1)
+
+    dst_ds = gdal.GetDriverByName('MEM').Create('', 25, 25, 1,
+                                                gdal.GDT_Float32)
+    dst_band = dst_ds.GetRasterBand(1)
+    gdal.ComputeProximity(src_band, dst_band,
+                          options=['VALUES=65,64',
+                                   'MINDIST=3',
+                                   'NODATA=-1'])
+    got = struct.unpack('f' * 25 * 25,
+                        dst_band.ReadRaster(buf_type=gdal.GDT_Float32))
+    assert min(got) == -1
+    assert min(v for v in got if v != -1) >= 3
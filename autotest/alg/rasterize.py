@@ -422,3 +422,47 @@ def test_rasterize_merge_alg_add_polygon(wkt):
                 0, 10, 10, 10, 10,
                 0, 10, 10, 10, 10,)
     assert got == expected, '%s' % str(got)
+
+###############################################################################
+# Test that the multi-threaded mode gives the same result as the
+# single-threaded one
+
+
+@pytest.mark.parametrize("options",
+                         ['', '-add', '-at', '-add -at'],
+                         ids=['replace', 'add', 'all_touched', 'add_all_touched'])
+def test_rasterize_num_threads(options):
+
+    sr_wkt = 'LOCAL_CS["arbitrary"]'
+    sr = osr.SpatialReference(sr_wkt)
+
+    data_source = ogr.GetDriverByName('MEMORY').CreateDataSource('')
+    layer = data_source.CreateLayer('', sr)
+    layer.CreateField(ogr.FieldDefn('val', ogr.OFTReal))
+    for i in range(300):
+        x = (i * 37) % 97
+        y = (i * 53) % 283
+        w = 1 + i % 11
+        h = 1 + (i * 7) % 23
+        if i % 3 == 0:
+            wkt = 'LINESTRING(%f %f,%f %f,%f %f)' % (
+                x, y, x + w, y + h / 2.0, x + w / 3.0, y + h)
+        else:
+            wkt = 'POLYGON((%f %f,%f %f,%f %f,%f %f))' % (
+                x + 0.3, y, x + w, y + 0.7, x + w / 2.0, y + h, x + 0.3, y)
+        feature = ogr.Feature(layer.GetLayerDefn())
+        feature.SetField('val', i + 1)
+        feature.SetGeometryDirectly(ogr.CreateGeometryFromWkt(wkt))
+        layer.CreateFeature(feature)
+
+    res = []
+    for num_threads in (1, 4):
+        ds = gdal.GetDriverByName('Mem').Create('', 100, 300, 1,
+                                                gdal.GDT_Float32)
+        ds.SetGeoTransform([0, 1, 0, 300, 0, -1])
+        ds.SetProjection(sr_wkt)
+        assert gdal.Rasterize(ds, data_source,
+                              options=options + ' -a val -optim RASTER '
+                              '-chunkysize 128 -num_threads %d' % num_threads)
+        res.append(ds.ReadRaster())
+    assert res[0] == res[1]
@@ -1776,3 +1776,59 @@ def test_warp_rms_2():
     ds = gdal.Open('data/utmsmall_rms.vrt')
     # 29818 on non-Intel archs
     assert ds.GetRasterBand(1).Checksum() in (29818, 29819)
+
+###############################################################################
+# Test that chunks whose source is only made of missing tiles are skipped
+
+
+def test_warp_skip_empty_source():
+
+    src_filename = '/vsimem/test_warp_skip_empty_source.tif'
+    src_ds = gdal.GetDriverByName('GTiff').Create(
+        src_filename, 1024, 1024, 1,
+        options=['TILED=YES', 'SPARSE_OK=YES'])
+    src_ds.SetGeoTransform([0, 1, 0, 0, 0, -1])
+    src_ds.GetRasterBand(1).SetNoDataValue(0)
+    src_ds.GetRasterBand(1).WriteRaster(0, 0, 256, 256, b'\x01' * (256 * 256))
+    src_ds = None
+
+    src_ds = gdal.Open(src_filename)
+    assert src_ds.GetRasterBand(1).GetDataCoverageStatus(512, 512, 512, 512) == \
+        gdal.GDAL_DATA_COVERAGE_STATUS_EMPTY
+    checksums = []
+    for skip in ('NO', 'YES'):
+        with gdaltest.config_option('GDALWARP_SKIP_EMPTY_SOURCE', skip):
+            out_ds = gdal.Warp('', src_ds, format='MEM',
+                               warpOptions=['SKIP_NOSOURCE=YES'],
+                               warpMemoryLimit=65536, dstNodata=0)
+        checksums.append(out_ds.GetRasterBand(1).Checksum())
+        out_ds = None
+    src_ds = None
+    gdal.GetDriverByName('GTiff').Delete(src_filename)
+
+    assert checksums[0] == checksums[1]
+
+
+###############################################################################
+# Test that the cubic resampling of masked non-Byte data gives the same
+# results as the general case (which does not use the AVX2 code path)
+
+
+@pytest.mark.parametrize('dt', [gdal.GDT_Int16, gdal.GDT_Int32,
+                                gdal.GDT_UInt32, gdal.GDT_Float32,
+                                gdal.GDT_Float64])
+def test_warp_cubic_with_nodata_same_as_general_case(dt):
+
+    src_ds = gdal.Translate('', '../gcore/data/byte.tif', format='MEM',
+                            outputType=dt)
+    src_ds.GetRasterBand(1).SetNoDataValue(148)
+
+    res = []
+    for general_case in ('NO', 'YES'):
+        out_ds = gdal.Warp('', src_ds, format='MEM',
+                           resampleAlg=gdal.GRA_Cubic,
+                           outputBounds=[440770, 3750810, 441910, 3751290],
+                           xRes=37, yRes=37,
+                           warpOptions=['USE_GENERAL_CASE=' + general_case])
+        res.append(out_ds.GetRasterBand(1).ReadRaster())
+    assert res[0] == res[1]
@@ -0,0 +1,65 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Minimal driver plugin used by testdeferredplugin.
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdal_priv.h"
+
+// Records in a configuration option that the plugin has been registered, so
+// that testdeferredplugin can check when the driver manager loaded it.
+
+static int DeferredTestIdentify( GDALOpenInfo* poOpenInfo )
+{
+    return STARTS_WITH_CI(poOpenInfo->pszFilename, "DEFERREDTEST:");
+}
+
+static GDALDataset* DeferredTestOpen( GDALOpenInfo* poOpenInfo )
+{
+    if( !DeferredTestIdentify(poOpenInfo) )
+        return nullptr;
+    GDALDriver* poMEMDriver = GetGDALDriverManager()->GetDriverByName("MEM");
+    if( poMEMDriver == nullptr )
+        return nullptr;
+    return poMEMDriver->Create("", 1, 1, 1, GDT_Byte, nullptr);
+}
+
+extern "C" void CPL_DLL GDALRegister_DEFERREDTEST();
+
+void GDALRegister_DEFERREDTEST()
+{
+    CPLSetConfigOption("DEFERRED_TEST_PLUGIN_LOADED", "YES");
+
+    if( GDALGetDriverByName("DEFERREDTEST") != nullptr )
+        return;
+
+    GDALDriver* poDriver = new GDALDriver();
+    poDriver->SetDescription("DEFERREDTEST");
+    poDriver->SetMetadataItem(GDAL_DCAP_RASTER, "YES");
+    poDriver->SetMetadataItem(GDAL_DMD_LONGNAME, "Deferred loading test");
+    poDriver->pfnIdentify = DeferredTestIdentify;
+    poDriver->pfnOpen = DeferredTestOpen;
+    GetGDALDriverManager()->RegisterDriver(poDriver);
+}
@@ -0,0 +1,1471 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Micro and macro benchmarks of GDAL hot paths
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+// Benchmark runner whose JSON output follows the layout of the Google
+// Benchmark library, so that its tools (e.g. compare.py) and
+// gdal/perftests/compare_benchmarks.py can be used to compare two runs.
+//
+// Usage: gdal_benchmark [-list] [-filter pattern[,pattern]*]
+//                       [-min_time seconds] [-repetitions N]
+//                       [-format console|json|csv] [-o filename]
+//                       [--config key value]*
+
+#include "cpl_conv.h"
+#include "cpl_json.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+#include "gdal_alg.h"
+#include "gdal_priv.h"
+#include "gdalwarper.h"
+#include "ogrsf_frmts.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define HAVE_MOCK_HTTP_SERVER
+#endif
+
+// Prevents the compiler from optimizing away the work of benchmarks.
+static volatile double gdfSink = 0;
+
+static void Usage()
+{
+    printf("Usage: gdal_benchmark [-list] [-filter pattern[,pattern]*]\n");
+    printf("                      [-min_time seconds] [-repetitions N]\n");
+    printf("                      [-format console|json|csv] [-o filename]\n");
+    printf("\n");
+    printf("A benchmark is run if its name contains one of the patterns.\n");
+    printf("Patterns starting with '-' exclude benchmarks.\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                             Benchmark                                */
+/************************************************************************/
+
+struct Benchmark
+{
+    std::string           osName{};
+    // Called once before the first iteration. Returns false if the
+    // benchmark cannot run in this build (missing driver, ...)
+    std::function<bool()> fnSetup{};
+    // One iteration
+    std::function<void()> fnRun{};
+    double                dfItemsPerIteration = 0;
+    double                dfBytesPerIteration = 0;
+};
+
+struct BenchmarkRun
+{
+    int    iRepetition = 0;
+    GIntBig nIterations = 0;
+    double dfRealTime = 0; // in nanoseconds per iteration
+    double dfCPUTime = 0;  // in nanoseconds per iteration
+};
+
+static std::vector<Benchmark> gaoBenchmarks;
+
+static void Register( const std::string& osName,
+                      std::function<bool()> fnSetup,
+                      std::function<void()> fnRun,
+                      double dfItemsPerIteration = 0,
+                      double dfBytesPerIteration = 0 )
+{
+    Benchmark oBench;
+    oBench.osName = osName;
+    oBench.fnSetup = std::move(fnSetup);
+    oBench.fnRun = std::move(fnRun);
+    oBench.dfItemsPerIteration = dfItemsPerIteration;
+    oBench.dfBytesPerIteration = dfBytesPerIteration;
+    gaoBenchmarks.emplace_back(std::move(oBench));
+}
+
+/************************************************************************/
+/*                           MatchFilter()                              */
+/************************************************************************/
+
+static bool MatchFilter( const std::string& osName,
+                         const CPLStringList& aosFilters )
+{
+    bool bHasPositive = false;
+    bool bMatch = false;
+    for( int i = 0; i < aosFilters.size(); i++ )
+    {
+        const char* pszPattern = aosFilters[i];
+        if( pszPattern[0] == '-' )
+        {
+            if( osName.find(pszPattern + 1) != std::string::npos )
+                return false;
+        }
+        else
+        {
+            bHasPositive = true;
+            if( osName.find(pszPattern) != std::string::npos )
+                bMatch = true;
+        }
+    }
+    return !bHasPositive || bMatch;
+}
+
+/************************************************************************/
+/*                          RunIterations()                             */
+/************************************************************************/
+
+static BenchmarkRun RunIterations( const Benchmark& oBench,
+                                   GIntBig nIterations )
+{
+    const auto oStart = std::chrono::steady_clock::now();
+    const std::clock_t nStartCPU = std::clock();
+    for( GIntBig i = 0; i < nIterations; i++ )
+        oBench.fnRun();
+    const std::clock_t nEndCPU = std::clock();
+    const auto oEnd = std::chrono::steady_clock::now();
+
+    BenchmarkRun oRun;
+    oRun.nIterations = nIterations;
+    oRun.dfRealTime =
+        std::chrono::duration<double, std::nano>(oEnd - oStart).count() /
+        static_cast<double>(nIterations);
+    oRun.dfCPUTime =
+        static_cast<double>(nEndCPU - nStartCPU) * 1e9 / CLOCKS_PER_SEC /
+        static_cast<double>(nIterations);
+    return oRun;
+}
+
+/************************************************************************/
+/*                          RunBenchmark()                              */
+/************************************************************************/
+
+// Grows the number of iterations until a run lasts at least dfMinTime
+// seconds, then does nRepetitions runs with that number of iterations.
+static std::vector<BenchmarkRun> RunBenchmark( const Benchmark& oBench,
+                                               double dfMinTime,
+                                               int nRepetitions )
+{
+    // Warm-up
+    oBench.fnRun();
+
+    GIntBig nIterations = 1;
+    BenchmarkRun oRun;
+    while( true )
+    {
+        oRun = RunIterations(oBench, nIterations);
+        const double dfElapsed =
+            oRun.dfRealTime * static_cast<double>(nIterations) * 1e-9;
+        if( dfElapsed >= dfMinTime || nIterations >= 1000 * 1000 * 1000 )
+            break;
+        // Aim 40% above the minimum time, but grow by at most 10x.
+        double dfMultiplier = 10;
+        if( dfElapsed > 0 )
+            dfMultiplier = std::min(10.0, dfMinTime * 1.4 / dfElapsed);
+        nIterations = std::max(nIterations + 1,
+            static_cast<GIntBig>(static_cast<double>(nIterations) *
+                                 dfMultiplier));
+    }
+
+    std::vector<BenchmarkRun> aoRuns;
+    aoRuns.push_back(oRun);
+    for( int i = 1; i < nRepetitions; i++ )
+    {
+        aoRuns.push_back(RunIterations(oBench, nIterations));
+        aoRuns.back().iRepetition = i;
+    }
+    return aoRuns;
+}
+
+/************************************************************************/
+/*                           Aggregates                                 */
+/************************************************************************/
+
+static double Mean( const std::vector<double>& adfValues )
+{
+    double dfSum = 0;
+    for( double dfVal: adfValues )
+        dfSum += dfVal;
+    return dfSum / static_cast<double>(adfValues.size());
+}
+
+static double Median( const std::vector<double>& adfValuesIn )
+{
+    std::vector<double> adfValues(adfValuesIn);
+    std::sort(adfValues.begin(), adfValues.end());
+    const size_t nMid = adfValues.size() / 2;
+    if( adfValues.size() % 2 )
+        return adfValues[nMid];
+    return (adfValues[nMid - 1] + adfValues[nMid]) / 2;
+}
+
+static double StdDev( const std::vector<double>& adfValues )
+{
+    if( adfValues.size() < 2 )
+        return 0;
+    const double dfMean = Mean(adfValues);
+    double dfSum = 0;
+    for( double dfVal: adfValues )
+        dfSum += (dfVal - dfMean) * (dfVal - dfMean);
+    return sqrt(dfSum / static_cast<double>(adfValues.size() - 1));
+}
+
+/************************************************************************/
+/*                              Reporter                                */
+/************************************************************************/
+
+struct ReportEntry
+{
+    std::string osName{};
+    std::string osRunName{};
+    std::string osAggregateName{}; // empty for iteration runs
+    int         nRepetitions = 1;
+    int         iRepetition = 0;
+    GIntBig     nIterations = 0;
+    double      dfRealTime = 0;
+    double      dfCPUTime = 0;
+    double      dfItemsPerSecond = 0;
+    double      dfBytesPerSecond = 0;
+};
+
+static std::vector<ReportEntry> BuildReportEntries(
+    const Benchmark& oBench, const std::vector<BenchmarkRun>& aoRuns )
+{
+    std::vector<ReportEntry> aoEntries;
+    const int nRepetitions = static_cast<int>(aoRuns.size());
+    auto fillRates = [&oBench](ReportEntry& oEntry)
+    {
+        if( oEntry.dfRealTime > 0 )
+        {
+            oEntry.dfItemsPerSecond =
+                oBench.dfItemsPerIteration * 1e9 / oEntry.dfRealTime;
+            oEntry.dfBytesPerSecond =
+                oBench.dfBytesPerIteration * 1e9 / oEntry.dfRealTime;
+        }
+    };
+    for( const auto& oRun: aoRuns )
+    {
+        ReportEntry oEntry;
+        oEntry.osName = oBench.osName;
+        oEntry.osRunName = oBench.osName;
+        oEntry.nRepetitions = nRepetitions;
+        oEntry.iRepetition = oRun.iRepetition;
+        oEntry.nIterations = oRun.nIterations;
+        oEntry.dfRealTime = oRun.dfRealTime;
+        oEntry.dfCPUTime = oRun.dfCPUTime;
+        fillRates(oEntry);
+        aoEntries.push_back(oEntry);
+    }
+    if( nRepetitions > 1 )
+    {
+        std::vector<double> adfReal, adfCPU;
+        for( const auto& oRun: aoRuns )
+        {
+            adfReal.push_back(oRun.dfRealTime);
+            adfCPU.push_back(oRun.dfCPUTime);
+        }
+        const struct
+        {
+            const char* pszName;
+            double (*pfn)(const std::vector<double>&);
+        } asAggregates[] = {
+            { "mean", Mean },
+            { "median", Median },
+            { "stddev", StdDev },
+        };
+        for( const auto& sAggregate: asAggregates )
+        {
+            ReportEntry oEntry;
+            oEntry.osName = oBench.osName + '_' + sAggregate.pszName;
+            oEntry.osRunName = oBench.osName;
+            oEntry.osAggregateName = sAggregate.pszName;
+            oEntry.nRepetitions = nRepetitions;
+            oEntry.nIterations = nRepetitions;
+            oEntry.dfRealTime = sAggregate.pfn(adfReal);
+            oEntry.dfCPUTime = sAggregate.pfn(adfCPU);
+            if( oEntry.osAggregateName != "stddev" )
+                fillRates(oEntry);
+            aoEntries.push_back(oEntry);
+        }
+    }
+    return aoEntries;
+}
+
+static std::string FormatTime( double dfNanoSec )
+{
+    if( dfNanoSec >= 1e9 )
+        return CPLSPrintf("%.3f s", dfNanoSec * 1e-9);
+    if( dfNanoSec >= 1e6 )
+        return CPLSPrintf("%.3f ms", dfNanoSec * 1e-6);
+    if( dfNanoSec >= 1e3 )
+        return CPLSPrintf("%.3f us", dfNanoSec * 1e-3);
+    return CPLSPrintf("%.1f ns", dfNanoSec);
+}
+
+static std::string FormatRate( const ReportEntry& oEntry )
+{
+    if( oEntry.dfBytesPerSecond > 0 )
+        return CPLSPrintf("%.1f MB/s", oEntry.dfBytesPerSecond / 1e6);
+    if( oEntry.dfItemsPerSecond > 0 )
+        return CPLSPrintf("%.3f M items/s", oEntry.dfItemsPerSecond / 1e6);
+    return std::string();
+}
+
+static void PrintConsoleEntry( const ReportEntry& oEntry )
+{
+    printf("%-60s %14s %14s %12" CPL_FRMT_GB_WITHOUT_PREFIX "d %s\n",
+           oEntry.osName.c_str(),
+           FormatTime(oEntry.dfRealTime).c_str(),
+           FormatTime(oEntry.dfCPUTime).c_str(),
+           oEntry.nIterations,
+           FormatRate(oEntry).c_str());
+    fflush(stdout);
+}
+
+static CPLJSONObject GetContext()
+{
+    CPLJSONObject oContext;
+    char szDate[64] = {};
+    const time_t nNow = time(nullptr);
+    strftime(szDate, sizeof(szDate), "%Y-%m-%dT%H:%M:%SZ", gmtime(&nNow));
+    oContext.Add("date", szDate);
+    oContext.Add("num_cpus", CPLGetNumCPUs());
+    oContext.Add("gdal_version", GDALVersionInfo("RELEASE_NAME"));
+    oContext.Add("gdal_version_num",
+                 atoi(GDALVersionInfo("VERSION_NUM")));
+#ifdef DEBUG
+    oContext.Add("library_build_type", "debug");
+#else
+    oContext.Add("library_build_type", "release");
+#endif
+    return oContext;
+}
+
+static std::string FormatJSON( const std::vector<ReportEntry>& aoEntries )
+{
+    CPLJSONDocument oDoc;
+    CPLJSONObject oRoot = oDoc.GetRoot();
+    oRoot.Add("context", GetContext());
+    CPLJSONArray oBenchmarks;
+    for( const auto& oEntry: aoEntries )
+    {
+        CPLJSONObject oObj;
+        oObj.Add("name", oEntry.osName);
+        oObj.Add("run_name", oEntry.osRunName);
+        oObj.Add("run_type", oEntry.osAggregateName.empty() ?
+                                "iteration" : "aggregate");
+        oObj.Add("repetitions", oEntry.nRepetitions);
+        if( oEntry.osAggregateName.empty() )
+            oObj.Add("repetition_index", oEntry.iRepetition);
+        else
+            oObj.Add("aggregate_name", oEntry.osAggregateName);
+        oObj.Add("iterations", static_cast<GInt64>(oEntry.nIterations));
+        oObj.Add("real_time", oEntry.dfRealTime);
+        oObj.Add("cpu_time", oEntry.dfCPUTime);
+        oObj.Add("time_unit", "ns");
+        if( oEntry.dfItemsPerSecond > 0 )
+            oObj.Add("items_per_second", oEntry.dfItemsPerSecond);
+        if( oEntry.dfBytesPerSecond > 0 )
+            oObj.Add("bytes_per_second", oEntry.dfBytesPerSecond);
+        oBenchmarks.Add(oObj);
+    }
+    oRoot.Add("benchmarks", oBenchmarks);
+    return oRoot.Format(CPLJSONObject::PrettyFormat::Pretty);
+}
+
+static std::string FormatCSV( const std::vector<ReportEntry>& aoEntries )
+{
+    std::string osRet("name,iterations,real_time,cpu_time,time_unit,"
+                      "bytes_per_second,items_per_second\n");
+    for( const auto& oEntry: aoEntries )
+    {
+        osRet += CPLSPrintf("\"%s\"," CPL_FRMT_GIB ",%.17g,%.17g,ns,",
+                            oEntry.osName.c_str(), oEntry.nIterations,
+                            oEntry.dfRealTime, oEntry.dfCPUTime);
+        if( oEntry.dfBytesPerSecond > 0 )
+            osRet += CPLSPrintf("%.17g", oEntry.dfBytesPerSecond);
+        osRet += ',';
+        if( oEntry.dfItemsPerSecond > 0 )
+            osRet += CPLSPrintf("%.17g", oEntry.dfItemsPerSecond);
+        osRet += '\n';
+    }
+    return osRet;
+}
+
+/************************************************************************/
+/*                          Helpers                                     */
+/************************************************************************/
+
+static const char* const BENCH_DIR = "/vsimem/gdal_benchmark";
+
+// Creates a MEM dataset filled with a deterministic, moderately
+// compressible pattern.
+static GDALDatasetUniquePtr CreateMEMDataset( int nXSize, int nYSize,
+                                              int nBands,
+                                              GDALDataType eDT )
+{
+    GDALDriver* poDrv = GetGDALDriverManager()->GetDriverByName("MEM");
+    if( poDrv == nullptr )
+        return nullptr;
+    GDALDatasetUniquePtr poDS(
+        poDrv->Create("", nXSize, nYSize, nBands, eDT, nullptr));
+    if( poDS == nullptr )
+        return nullptr;
+    double adfGT[6] = { 0, 1, 0, 0, 0, -1 };
+    poDS->SetGeoTransform(adfGT);
+    std::vector<double> adfLine(nXSize);
+    for( int iBand = 0; iBand < nBands; iBand++ )
+    {
+        for( int iY = 0; iY < nYSize; iY++ )
+        {
+            for( int iX = 0; iX < nXSize; iX++ )
+            {
+                adfLine[iX] = ((iX / 4 + iY / 3 + iBand * 31) % 200) +
+                              ((iX ^ iY) & 15);
+            }
+            CPL_IGNORE_RET_VAL(poDS->GetRasterBand(iBand + 1)->RasterIO(
+                GF_Write, 0, iY, nXSize, 1, &adfLine[0], nXSize, 1,
+                GDT_Float64, 0, 0, nullptr));
+        }
+    }
+    return poDS;
+}
+
+static const GDALDataType aeRasterTypes[] = {
+    GDT_Byte, GDT_UInt16, GDT_Int16, GDT_Float32, GDT_Float64 };
+
+/************************************************************************/
+/*                      RegisterCopyWordsBenchmarks()                   */
+/************************************************************************/
+
+static void RegisterCopyWordsBenchmarks()
+{
+    constexpr int N_WORDS = 256 * 256;
+    // Large enough for the biggest type and strides of up to 4 words.
+    std::shared_ptr<std::vector<GByte>> pabyIn =
+        std::make_shared<std::vector<GByte>>(N_WORDS * 16 * 4);
+    std::shared_ptr<std::vector<GByte>> pabyOut =
+        std::make_shared<std::vector<GByte>>(N_WORDS * 16 * 4);
+    for( size_t i = 0; i < pabyIn->size(); i++ )
+        (*pabyIn)[i] = static_cast<GByte>((i * 37) % 101);
+
+    const GDALDataType aeTypes[] = {
+        GDT_Byte, GDT_UInt16, GDT_Int16, GDT_UInt32, GDT_Int32,
+        GDT_Float32, GDT_Float64 };
+    for( GDALDataType eSrcType: aeTypes )
+    {
+        for( GDALDataType eDstType: aeTypes )
+        {
+            const int nSrcSize = GDALGetDataTypeSizeBytes(eSrcType);
+            const int nDstSize = GDALGetDataTypeSizeBytes(eDstType);
+            Register(
+                std::string("GDALCopyWords/") +
+                    GDALGetDataTypeName(eSrcType) + "_to_" +
+                    GDALGetDataTypeName(eDstType),
+                [](){ return true; },
+                [pabyIn, pabyOut, eSrcType, eDstType, nSrcSize, nDstSize]()
+                {
+                    GDALCopyWords(pabyIn->data(), eSrcType, nSrcSize,
+                                  pabyOut->data(), eDstType, nDstSize,
+                                  N_WORDS);
+                },
+                N_WORDS, static_cast<double>(N_WORDS) * nDstSize);
+        }
+    }
+
+    // Pixel-interleaved <--> band-interleaved Byte cases, as used when
+    // reading RGB(A) images.
+    for( int nStride = 2; nStride <= 4; nStride++ )
+    {
+        Register(
+            CPLSPrintf("GDALCopyWords/Byte_stride%d_to_packed", nStride),
+            [](){ return true; },
+            [pabyIn, pabyOut, nStride]()
+            {
+                GDALCopyWords(pabyIn->data(), GDT_Byte, nStride,
+                              pabyOut->data(), GDT_Byte, 1, N_WORDS);
+            },
+            N_WORDS, N_WORDS);
+        Register(
+            CPLSPrintf("GDALCopyWords/Byte_packed_to_stride%d", nStride),
+            [](){ return true; },
+            [pabyIn, pabyOut, nStride]()
+            {
+                GDALCopyWords(pabyIn->data(), GDT_Byte, 1,
+                              pabyOut->data(), GDT_Byte, nStride, N_WORDS);
+            },
+            N_WORDS, N_WORDS);
+    }
+}
+
+/************************************************************************/
+/*                        RegisterWarpBenchmarks()                      */
+/************************************************************************/
+
+namespace {
+struct WarpFixture
+{
+    GDALDatasetUniquePtr poSrcDS{};
+    GDALDatasetUniquePtr poDstDS{};
+    void*                hTransformArg = nullptr;
+    GDALWarpOperation    oOperation{};
+
+    WarpFixture() = default;
+    WarpFixture(const WarpFixture&) = delete;
+    WarpFixture& operator=(const WarpFixture&) = delete;
+
+    ~WarpFixture()
+    {
+        if( hTransformArg )
+            GDALDestroyGenImgProjTransformer(hTransformArg);
+    }
+};
+} // namespace
+
+static void RegisterWarpBenchmarks()
+{
+    constexpr int SRC_SIZE = 1024;
+    constexpr int DST_SIZE = 800;
+    const struct
+    {
+        const char*      pszName;
+        GDALResampleAlg  eAlg;
+    } asAlgs[] = {
+        { "near", GRA_NearestNeighbour },
+        { "bilinear", GRA_Bilinear },
+        { "cubic", GRA_Cubic },
+        { "cubicspline", GRA_CubicSpline },
+        { "lanczos", GRA_Lanczos },
+        { "average", GRA_Average },
+        { "mode", GRA_Mode },
+    };
+    for( GDALDataType eDT: aeRasterTypes )
+    {
+        for( const auto& sAlg: asAlgs )
+        {
+            auto poFixture = std::make_shared<WarpFixture>();
+            const GDALResampleAlg eAlg = sAlg.eAlg;
+            Register(
+                std::string("Warp/") + sAlg.pszName + '/' +
+                    GDALGetDataTypeName(eDT),
+                [poFixture, eDT, eAlg]()
+                {
+                    poFixture->poSrcDS =
+                        CreateMEMDataset(SRC_SIZE, SRC_SIZE, 1, eDT);
+                    if( poFixture->poSrcDS == nullptr )
+                        return false;
+                    poFixture->poDstDS = CreateMEMDataset(DST_SIZE, DST_SIZE,
+                                                          1, eDT);
+                    if( poFixture->poDstDS == nullptr )
+                        return false;
+                    const double dfRes =
+                        static_cast<double>(SRC_SIZE) / DST_SIZE;
+                    double adfGT[6] = { 0, dfRes, 0, 0, 0, -dfRes };
+                    poFixture->poDstDS->SetGeoTransform(adfGT);
+
+                    poFixture->hTransformArg =
+                        GDALCreateGenImgProjTransformer2(
+                            GDALDataset::ToHandle(poFixture->poSrcDS.get()),
+                            GDALDataset::ToHandle(poFixture->poDstDS.get()),
+                            nullptr);
+                    if( poFixture->hTransformArg == nullptr )
+                        return false;
+
+                    GDALWarpOptions* psWO = GDALCreateWarpOptions();
+                    psWO->hSrcDS =
+                        GDALDataset::ToHandle(poFixture->poSrcDS.get());
+                    psWO->hDstDS =
+                        GDALDataset::ToHandle(poFixture->poDstDS.get());
+                    psWO->nBandCount = 1;
+                    psWO->panSrcBands =
+                        static_cast<int*>(CPLMalloc(sizeof(int)));
+                    psWO->panSrcBands[0] = 1;
+                    psWO->panDstBands =
+                        static_cast<int*>(CPLMalloc(sizeof(int)));
+                    psWO->panDstBands[0] = 1;
+                    psWO->eResampleAlg = eAlg;
+                    psWO->eWorkingDataType = eDT;
+                    psWO->pfnTransformer = GDALGenImgProjTransform;
+                    psWO->pTransformerArg = poFixture->hTransformArg;
+                    psWO->papszWarpOptions = CSLSetNameValue(
+                        psWO->papszWarpOptions, "INIT_DEST", "0");
+                    const bool bOK =
+                        poFixture->oOperation.Initialize(psWO) == CE_None;
+                    GDALDestroyWarpOptions(psWO);
+                    return bOK;
+                },
+                [poFixture]()
+                {
+                    CPL_IGNORE_RET_VAL(poFixture->oOperation.ChunkAndWarpImage(
+                        0, 0, DST_SIZE, DST_SIZE));
+                },
+                static_cast<double>(DST_SIZE) * DST_SIZE,
+                static_cast<double>(DST_SIZE) * DST_SIZE *
+                    GDALGetDataTypeSizeBytes(eDT));
+        }
+    }
+}
+
+/************************************************************************/
+/*                      RegisterOverviewBenchmarks()                    */
+/************************************************************************/
+
+static void RegisterOverviewBenchmarks()
+{
+    constexpr int SRC_SIZE = 2048;
+    constexpr int OVR_SIZE = SRC_SIZE / 2;
+    const char* const apszResampling[] = {
+        "NEAREST", "AVERAGE", "RMS", "BILINEAR", "CUBIC", "CUBICSPLINE",
+        "LANCZOS", "GAUSS", "MODE" };
+    for( GDALDataType eDT: aeRasterTypes )
+    {
+        for( const char* pszResampling: apszResampling )
+        {
+            struct OverviewFixture
+            {
+                GDALDatasetUniquePtr poSrcDS{};
+                GDALDatasetUniquePtr poOvrDS{};
+            };
+            auto poFixture = std::make_shared<OverviewFixture>();
+            Register(
+                std::string("Overview/") + CPLString(pszResampling).tolower() +
+                    '/' + GDALGetDataTypeName(eDT),
+                [poFixture, eDT]()
+                {
+                    poFixture->poSrcDS =
+                        CreateMEMDataset(SRC_SIZE, SRC_SIZE, 1, eDT);
+                    poFixture->poOvrDS =
+                        CreateMEMDataset(OVR_SIZE, OVR_SIZE, 1, eDT);
+                    return poFixture->poSrcDS != nullptr &&
+                           poFixture->poOvrDS != nullptr;
+                },
+                [poFixture, pszResampling]()
+                {
+                    GDALRasterBandH hOvrBand = GDALRasterBand::ToHandle(
+                        poFixture->poOvrDS->GetRasterBand(1));
+                    CPL_IGNORE_RET_VAL(GDALRegenerateOverviews(
+                        GDALRasterBand::ToHandle(
+                            poFixture->poSrcDS->GetRasterBand(1)),
+                        1, &hOvrBand, pszResampling, nullptr, nullptr));
+                },
+                static_cast<double>(OVR_SIZE) * OVR_SIZE,
+                static_cast<double>(SRC_SIZE) * SRC_SIZE *
+                    GDALGetDataTypeSizeBytes(eDT));
+        }
+    }
+}
+
+/************************************************************************/
+/*                        RegisterGTiffBenchmarks()                     */
+/************************************************************************/
+
+static bool IsGTiffCodecAvailable( const char* pszCodec )
+{
+    GDALDriver* poDrv = GetGDALDriverManager()->GetDriverByName("GTiff");
+    if( poDrv == nullptr )
+        return false;
+    const char* pszOptions =
+        poDrv->GetMetadataItem(GDAL_DMD_CREATIONOPTIONLIST);
+    return pszOptions != nullptr &&
+           strstr(pszOptions,
+                  CPLSPrintf("<Value>%s</Value>", pszCodec)) != nullptr;
+}
+
+static void RegisterGTiffBenchmarks()
+{
+    constexpr int SIZE = 1024;
+    constexpr int BANDS = 3;
+    const double dfBytes = static_cast<double>(SIZE) * SIZE * BANDS;
+
+    // Shared by all codecs
+    auto poSrcDS = std::make_shared<GDALDatasetUniquePtr>();
+    auto getSrcDS = [poSrcDS]()
+    {
+        if( *poSrcDS == nullptr )
+            *poSrcDS = CreateMEMDataset(SIZE, SIZE, BANDS, GDT_Byte);
+        return poSrcDS->get();
+    };
+
+    const char* const apszCodecs[] = {
+        "NONE", "PACKBITS", "LZW", "DEFLATE", "ZSTD", "LZMA", "LERC",
+        "JPEG", "WEBP" };
+    for( const char* pszCodec: apszCodecs )
+    {
+        CPLStringList aosOptions;
+        aosOptions.SetNameValue("TILED", "YES");
+        aosOptions.SetNameValue("COMPRESS", pszCodec);
+        if( EQUAL(pszCodec, "JPEG") )
+            aosOptions.SetNameValue("PHOTOMETRIC", "YCBCR");
+        if( EQUAL(pszCodec, "LZW") || EQUAL(pszCodec, "DEFLATE") ||
+            EQUAL(pszCodec, "ZSTD") )
+            aosOptions.SetNameValue("PREDICTOR", "2");
+
+        const std::string osEncodeFilename(
+            CPLSPrintf("%s/encode_%s.tif", BENCH_DIR, pszCodec));
+        const std::string osDecodeFilename(
+            CPLSPrintf("%s/decode_%s.tif", BENCH_DIR, pszCodec));
+        const std::string osCodec(pszCodec);
+
+        auto encode = [getSrcDS, aosOptions](const std::string& osFilename)
+        {
+            GDALDriver* poDrv =
+                GetGDALDriverManager()->GetDriverByName("GTiff");
+            GDALDataset* poSrc = getSrcDS();
+            if( poDrv == nullptr || poSrc == nullptr )
+                return false;
+            GDALDatasetUniquePtr poDS(poDrv->CreateCopy(
+                osFilename.c_str(), poSrc, false,
+                const_cast<char**>(aosOptions.List()),
+                nullptr, nullptr));
+            return poDS != nullptr;
+        };
+
+        Register(
+            "GTiff/encode/" + osCodec,
+            [osCodec]() { return IsGTiffCodecAvailable(osCodec.c_str()); },
+            [encode, osEncodeFilename]()
+            {
+                CPL_IGNORE_RET_VAL(encode(osEncodeFilename));
+            },
+            SIZE * SIZE, dfBytes);
+
+        Register(
+            "GTiff/decode/" + osCodec,
+            [osCodec, encode, osDecodeFilename]()
+            {
+                return IsGTiffCodecAvailable(osCodec.c_str()) &&
+                       encode(osDecodeFilename);
+            },
+            [osDecodeFilename]()
+            {
+                // Reopen to avoid hitting the block cache.
+                GDALDatasetUniquePtr poDS(GDALDataset::Open(
+                    osDecodeFilename.c_str(), GDAL_OF_RASTER));
+                if( poDS == nullptr )
+                    return;
+                std::vector<GByte> abyBuffer(SIZE * SIZE * BANDS);
+                CPL_IGNORE_RET_VAL(poDS->RasterIO(
+                    GF_Read, 0, 0, SIZE, SIZE, &abyBuffer[0], SIZE, SIZE,
+                    GDT_Byte, BANDS, nullptr, 0, 0, 0, nullptr));
+                gdfSink = gdfSink + abyBuffer[SIZE * SIZE];
+            },
+            SIZE * SIZE, dfBytes);
+    }
+}
+
+/************************************************************************/
+/*                        RegisterOGRBenchmarks()                       */
+/************************************************************************/
+
+constexpr int N_FEATURES = 10000;
+
+// Fills a layer with N_FEATURES point features with attributes.
+static bool FillLayer( OGRLayer* poLayer )
+{
+    OGRFieldDefn oFieldInt("ival", OFTInteger);
+    OGRFieldDefn oFieldReal("dval", OFTReal);
+    OGRFieldDefn oFieldStr("sval", OFTString);
+    oFieldStr.SetWidth(32);
+    if( poLayer->CreateField(&oFieldInt) != OGRERR_NONE ||
+        poLayer->CreateField(&oFieldReal) != OGRERR_NONE ||
+        poLayer->CreateField(&oFieldStr) != OGRERR_NONE )
+    {
+        return false;
+    }
+    static const char* const apszWords[] = {
+        "foo", "bar", "baz", "qux", "quux", "corge", "grault", "garply" };
+    CPL_IGNORE_RET_VAL(poLayer->StartTransaction());
+    for( int i = 0; i < N_FEATURES; i++ )
+    {
+        OGRFeature oFeature(poLayer->GetLayerDefn());
+        oFeature.SetField(0, (i * 7919) % N_FEATURES);
+        oFeature.SetField(1, i * 0.125 - 100);
+        oFeature.SetField(2, CPLSPrintf("%s_%d", apszWords[i % 8], i % 97));
+        oFeature.SetGeometryDirectly(
+            new OGRPoint(2 + (i % 100) * 0.01, 49 + (i / 100) * 0.01));
+        if( poLayer->CreateFeature(&oFeature) != OGRERR_NONE )
+            return false;
+    }
+    CPL_IGNORE_RET_VAL(poLayer->CommitTransaction());
+    return true;
+}
+
+static void RegisterOGRReadBenchmarks()
+{
+    const struct
+    {
+        const char* pszDriver;
+        const char* pszExtension;
+        const char* pszLayerCreationOption;
+    } asDrivers[] = {
+        { "ESRI Shapefile", "shp", nullptr },
+        { "GPKG", "gpkg", nullptr },
+        { "GeoJSON", "geojson", nullptr },
+        { "FlatGeobuf", "fgb", nullptr },
+        { "CSV", "csv", "GEOMETRY=AS_XY" },
+        { "MapInfo File", "tab", nullptr },
+    };
+    for( const auto& sDriver: asDrivers )
+    {
+        const std::string osDriver(sDriver.pszDriver);
+        const std::string osFilename(
+            CPLSPrintf("%s/ogr_%s/points.%s", BENCH_DIR,
+                       sDriver.pszExtension, sDriver.pszExtension));
+        const std::string osLCO(sDriver.pszLayerCreationOption ?
+                                sDriver.pszLayerCreationOption : "");
+        Register(
+            "OGR/read/" + osDriver,
+            [osDriver, osFilename, osLCO]()
+            {
+                GDALDriver* poDrv =
+                    GetGDALDriverManager()->GetDriverByName(osDriver.c_str());
+                if( poDrv == nullptr )
+                    return false;
+                VSIMkdirRecursive(CPLGetPath(osFilename.c_str()), 0755);
+                GDALDatasetUniquePtr poDS(poDrv->Create(
+                    osFilename.c_str(), 0, 0, 0, GDT_Unknown, nullptr));
+                if( poDS == nullptr )
+                    return false;
+                CPLStringList aosLCO;
+                if( !osLCO.empty() )
+                    aosLCO.AddString(osLCO.c_str());
+                OGRSpatialReference oSRS;
+                oSRS.SetWellKnownGeogCS("WGS84");
+                oSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+                OGRLayer* poLayer = poDS->CreateLayer(
+                    "points", &oSRS, wkbPoint, aosLCO.List());
+                return poLayer != nullptr && FillLayer(poLayer);
+            },
+            [osFilename]()
+            {
+                // Reopen, as some drivers (GeoJSON) load all features
+                // at opening.
+                GDALDatasetUniquePtr poDS(GDALDataset::Open(
+                    osFilename.c_str(), GDAL_OF_VECTOR));
+                if( poDS == nullptr || poDS->GetLayerCount() == 0 )
+                    return;
+                OGRLayer* poLayer = poDS->GetLayer(0);
+                double dfSum = 0;
+                for( auto& poFeature: poLayer )
+                {
+                    dfSum += poFeature->GetFieldAsDouble(1);
+                    const OGRGeometry* poGeom = poFeature->GetGeometryRef();
+                    if( poGeom &&
+                        wkbFlatten(poGeom->getGeometryType()) == wkbPoint )
+                    {
+                        dfSum += poGeom->toPoint()->getX();
+                    }
+                }
+                gdfSink = gdfSink + dfSum;
+            },
+            N_FEATURES);
+    }
+}
+
+static void RegisterOGRSQLBenchmarks()
+{
+    auto poDS = std::make_shared<GDALDatasetUniquePtr>();
+    auto setup = [poDS]()
+    {
+        if( *poDS != nullptr )
+            return true;
+        GDALDriver* poDrv =
+            GetGDALDriverManager()->GetDriverByName("Memory");
+        if( poDrv == nullptr )
+            return false;
+        poDS->reset(poDrv->Create("", 0, 0, 0, GDT_Unknown, nullptr));
+        if( *poDS == nullptr )
+            return false;
+        OGRLayer* poLayer =
+            (*poDS)->CreateLayer("points", nullptr, wkbPoint, nullptr);
+        return poLayer != nullptr && FillLayer(poLayer);
+    };
+
+    Register(
+        "OGRSQL/attribute_filter",
+        setup,
+        [poDS]()
+        {
+            OGRLayer* poLayer = (*poDS)->GetLayer(0);
+            poLayer->SetAttributeFilter(
+                "ival > 2500 AND (sval LIKE 'ba%' OR dval < 0)");
+            GIntBig nCount = 0;
+            for( auto& poFeature: poLayer )
+            {
+                CPL_IGNORE_RET_VAL(poFeature);
+                nCount ++;
+            }
+            poLayer->SetAttributeFilter(nullptr);
+            gdfSink = gdfSink + static_cast<double>(nCount);
+        },
+        N_FEATURES);
+
+    const struct
+    {
+        const char* pszName;
+        const char* pszSQL;
+    } asQueries[] = {
+        { "select_where",
+          "SELECT ival, dval FROM points WHERE ival BETWEEN 1000 AND 9000 "
+          "AND sval IN ('foo_1', 'bar_2', 'baz_3') OR dval > 1000" },
+        { "order_by", "SELECT * FROM points ORDER BY sval, dval DESC" },
+        { "aggregate",
+          "SELECT COUNT(*), MIN(dval), MAX(dval), AVG(dval), SUM(ival) "
+          "FROM points" },
+        { "distinct", "SELECT DISTINCT sval FROM points" },
+        { "expressions",
+          "SELECT ival * 2 + 1 AS a, CONCAT(sval, '_x') AS b, "
+          "CAST(dval AS integer) AS c FROM points" },
+    };
+    for( const auto& sQuery: asQueries )
+    {
+        const std::string osSQL(sQuery.pszSQL);
+        Register(
+            std::string("OGRSQL/") + sQuery.pszName,
+            setup,
+            [poDS, osSQL]()
+            {
+                OGRLayer* poLayer =
+                    (*poDS)->ExecuteSQL(osSQL.c_str(), nullptr, nullptr);
+                if( poLayer == nullptr )
+                    return;
+                GIntBig nCount = 0;
+                for( auto& poFeature: poLayer )
+                {
+                    CPL_IGNORE_RET_VAL(poFeature);
+                    nCount ++;
+                }
+                (*poDS)->ReleaseResultSet(poLayer);
+                gdfSink = gdfSink + static_cast<double>(nCount);
+            },
+            N_FEATURES);
+    }
+}
+
+#ifdef HAVE_MOCK_HTTP_SERVER
+
+/************************************************************************/
+/*                           MockHTTPServer                             */
+/************************************************************************/
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace {
+
+// Minimal HTTP/1.1 server on the loopback interface, serving in-memory
+// resources. Supports HEAD, GET and single range GET requests, with
+// persistent connections, which is what /vsicurl/ needs.
+class MockHTTPServer
+{
+    int                                          m_nListenFD = -1;
+    int                                          m_nPort = 0;
+    std::atomic<bool>                            m_bStop{false};
+    std::thread                                  m_oAcceptThread{};
+    std::vector<std::thread>                     m_aoConnectionThreads{};
+    std::map<std::string, std::vector<GByte>>    m_oResources{};
+
+    // Waits until fd is readable. Returns false if the server is stopping.
+    bool WaitReadable( int fd ) const
+    {
+        while( !m_bStop )
+        {
+            struct pollfd sPollFD;
+            sPollFD.fd = fd;
+            sPollFD.events = POLLIN;
+            sPollFD.revents = 0;
+            if( poll(&sPollFD, 1, 100) > 0 )
+                return true;
+        }
+        return false;
+    }
+
+    static bool SendAll( int fd, const void* pData, size_t nSize )
+    {
+        const char* pabyData = static_cast<const char*>(pData);
+        while( nSize > 0 )
+        {
+            const ssize_t nSent = send(fd, pabyData, nSize, MSG_NOSIGNAL);
+            if( nSent <= 0 )
+                return false;
+            pabyData += nSent;
+            nSize -= static_cast<size_t>(nSent);
+        }
+        return true;
+    }
+
+    bool HandleRequest( int fd, const std::string& osRequest ) const
+    {
+        const CPLStringList aosTokens(
+            CSLTokenizeString2(osRequest.c_str(), " \r\n", 0));
+        if( aosTokens.size() < 2 )
+            return false;
+        const bool bHead = EQUAL(aosTokens[0], "HEAD");
+        const auto oIter = m_oResources.find(aosTokens[1]);
+        if( oIter == m_oResources.end() )
+        {
+            const char szResponse[] =
+                "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+            return SendAll(fd, szResponse, strlen(szResponse));
+        }
+        const std::vector<GByte>& abyData = oIter->second;
+        const size_t nSize = abyData.size();
+
+        size_t nStart = 0;
+        size_t nEnd = nSize == 0 ? 0 : nSize - 1;
+        bool bRange = false;
+        const size_t nRangePos = CPLString(osRequest).ifind("Range: bytes=");
+        if( !bHead && nRangePos != std::string::npos )
+        {
+            const char* pszRange =
+                osRequest.c_str() + nRangePos + strlen("Range: bytes=");
+            nStart = static_cast<size_t>(CPLAtoGIntBig(pszRange));
+            const char* pszDash = strchr(pszRange, '-');
+            if( pszDash && pszDash[1] >= '0' && pszDash[1] <= '9' )
+                nEnd = std::min(nEnd,
+                    static_cast<size_t>(CPLAtoGIntBig(pszDash + 1)));
+            if( nStart >= nSize || nStart > nEnd )
+            {
+                const std::string osResponse(CPLSPrintf(
+                    "HTTP/1.1 416 Range Not Satisfiable\r\n"
+                    "Content-Range: bytes */%llu\r\n"
+                    "Content-Length: 0\r\n\r\n",
+                    static_cast<unsigned long long>(nSize)));
+                return SendAll(fd, osResponse.data(), osResponse.size());
+            }
+            bRange = true;
+        }
+
+        const size_t nLength = nSize == 0 ? 0 : nEnd - nStart + 1;
+        std::string osHeader;
+        if( bRange )
+        {
+            osHeader = CPLSPrintf(
+                "HTTP/1.1 206 Partial Content\r\n"
+                "Content-Range: bytes %llu-%llu/%llu\r\n",
+                static_cast<unsigned long long>(nStart),
+                static_cast<unsigned long long>(nEnd),
+                static_cast<unsigned long long>(nSize));
+        }
+        else
+        {
+            osHeader = "HTTP/1.1 200 OK\r\n";
+        }
+        osHeader += CPLSPrintf("Content-Length: %llu\r\n"
+                               "Accept-Ranges: bytes\r\n\r\n",
+                               static_cast<unsigned long long>(nLength));
+        if( !SendAll(fd, osHeader.data(), osHeader.size()) )
+            return false;
+        if( bHead || nLength == 0 )
+            return true;
+        return SendAll(fd, &abyData[nStart], nLength);
+    }
+
+    void HandleConnection( int fd ) const
+    {
+        std::string osBuffer;
+        char szBuffer[4096];
+        while( true )
+        {
+            size_t nHeaderEnd;
+            while( (nHeaderEnd = osBuffer.find("\r\n\r\n")) ==
+                                                        std::string::npos )
+            {
+                if( !WaitReadable(fd) )
+                {
+                    close(fd);
+                    return;
+                }
+                const ssize_t nRead = recv(fd, szBuffer, sizeof(szBuffer), 0);
+                if( nRead <= 0 )
+                {
+                    close(fd);
+                    return;
+                }
+                osBuffer.append(szBuffer, static_cast<size_t>(nRead));
+            }
+            const std::string osRequest(osBuffer.substr(0, nHeaderEnd + 2));
+            osBuffer.erase(0, nHeaderEnd + 4);
+            if( !HandleRequest(fd, osRequest) )
+            {
+                close(fd);
+                return;
+            }
+        }
+    }
+
+    void AcceptLoop()
+    {
+        while( WaitReadable(m_nListenFD) )
+        {
+            const int fd = accept(m_nListenFD, nullptr, nullptr);
+            if( fd < 0 )
+                continue;
+            m_aoConnectionThreads.emplace_back(
+                [this, fd]() { HandleConnection(fd); });
+        }
+    }
+
+  public:
+    MockHTTPServer() = default;
+    MockHTTPServer(const MockHTTPServer&) = delete;
+    MockHTTPServer& operator=(const MockHTTPServer&) = delete;
+
+    ~MockHTTPServer() { Stop(); }
+
+    // Resources must be added before Start().
+    void AddResource( const std::string& osPath, std::vector<GByte>&& abyData )
+    {
+        m_oResources[osPath] = std::move(abyData);
+    }
+
+    bool Start()
+    {
+        m_nListenFD = socket(AF_INET, SOCK_STREAM, 0);
+        if( m_nListenFD < 0 )
+            return false;
+        struct sockaddr_in sAddr;
+        memset(&sAddr, 0, sizeof(sAddr));
+        sAddr.sin_family = AF_INET;
+        sAddr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        sAddr.sin_port = 0;
+        socklen_t nAddrLen = sizeof(sAddr);
+        if( bind(m_nListenFD, reinterpret_cast<struct sockaddr*>(&sAddr),
+                 sizeof(sAddr)) != 0 ||
+            listen(m_nListenFD, 16) != 0 ||
+            getsockname(m_nListenFD, reinterpret_cast<struct sockaddr*>(&sAddr),
+                        &nAddrLen) != 0 )
+        {
+            close(m_nListenFD);
+            m_nListenFD = -1;
+            return false;
+        }
+        m_nPort = ntohs(sAddr.sin_port);
+        m_oAcceptThread = std::thread([this]() { AcceptLoop(); });
+        return true;
+    }
+
+    void Stop()
+    {
+        if( m_nListenFD < 0 )
+            return;
+        m_bStop = true;
+        m_oAcceptThread.join();
+        for( auto& oThread: m_aoConnectionThreads )
+            oThread.join();
+        m_aoConnectionThreads.clear();
+        close(m_nListenFD);
+        m_nListenFD = -1;
+    }
+
+    std::string GetURL( const std::string& osPath ) const
+    {
+        return CPLSPrintf("/vsicurl/http://127.0.0.1:%d%s",
+                          m_nPort, osPath.c_str());
+    }
+};
+
+} // namespace
+
+/************************************************************************/
+/*                      RegisterVSICurlBenchmarks()                     */
+/************************************************************************/
+
+static bool IsVSICurlAvailable()
+{
+    const CPLStringList aosPrefixes(VSIGetFileSystemsPrefixes());
+    return aosPrefixes.FindString("/vsicurl/") >= 0;
+}
+
+static void RegisterVSICurlBenchmarks()
+{
+    constexpr size_t FILE_SIZE = 16 * 1024 * 1024;
+    constexpr size_t SEQUENTIAL_CHUNK_SIZE = 1024 * 1024;
+    constexpr int N_RANDOM_READS = 256;
+    constexpr size_t RANDOM_READ_SIZE = 16 * 1024;
+    constexpr int TIFF_SIZE = 2048;
+
+    struct VSICurlFixture
+    {
+        std::unique_ptr<MockHTTPServer> poServer{};
+
+        ~VSICurlFixture()
+        {
+            if( poServer )
+                CPLSetConfigOption("GDAL_DISABLE_READDIR_ON_OPEN", nullptr);
+        }
+    };
+    auto poFixture = std::make_shared<VSICurlFixture>();
+    auto setup = [poFixture]()
+    {
+        if( poFixture->poServer != nullptr )
+            return true;
+        if( !IsVSICurlAvailable() )
+            return false;
+
+        std::unique_ptr<MockHTTPServer> poNewServer(new MockHTTPServer());
+
+        std::vector<GByte> abyRaw(FILE_SIZE);
+        for( size_t i = 0; i < FILE_SIZE; i++ )
+            abyRaw[i] = static_cast<GByte>((i * 2654435761U) >> 24);
+        poNewServer->AddResource("/raw.bin", std::move(abyRaw));
+
+        // Tiled DEFLATE GeoTIFF, served from a copy of its bytes.
+        GDALDriver* poDrv = GetGDALDriverManager()->GetDriverByName("GTiff");
+        auto poSrcDS = CreateMEMDataset(TIFF_SIZE, TIFF_SIZE, 1, GDT_Byte);
+        if( poDrv && poSrcDS )
+        {
+            const std::string osTmp(CPLSPrintf("%s/vsicurl.tif", BENCH_DIR));
+            const char* const apszOptions[] = {
+                "TILED=YES", "COMPRESS=DEFLATE", nullptr };
+            GDALClose(poDrv->CreateCopy(
+                osTmp.c_str(), poSrcDS.get(), false,
+                const_cast<char**>(apszOptions), nullptr, nullptr));
+            vsi_l_offset nLength = 0;
+            GByte* pabyData = VSIGetMemFileBuffer(osTmp.c_str(), &nLength,
+                                                  FALSE);
+            if( pabyData )
+            {
+                poNewServer->AddResource("/test.tif",
+                    std::vector<GByte>(pabyData, pabyData + nLength));
+            }
+            VSIUnlink(osTmp.c_str());
+        }
+
+        if( !poNewServer->Start() )
+            return false;
+        poFixture->poServer = std::move(poNewServer);
+        // Avoid listing the root "directory" of the server when opening.
+        CPLSetConfigOption("GDAL_DISABLE_READDIR_ON_OPEN", "EMPTY_DIR");
+        return true;
+    };
+
+    Register(
+        "VSICurl/sequential_read",
+        setup,
+        [poFixture]()
+        {
+            VSICurlClearCache();
+            VSILFILE* fp = VSIFOpenL(
+                poFixture->poServer->GetURL("/raw.bin").c_str(), "rb");
+            if( fp == nullptr )
+                return;
+            std::vector<GByte> abyBuffer(SEQUENTIAL_CHUNK_SIZE);
+            while( VSIFReadL(&abyBuffer[0], 1, abyBuffer.size(), fp) ==
+                                                        abyBuffer.size() )
+            {
+                gdfSink = gdfSink + abyBuffer[0];
+            }
+            VSIFCloseL(fp);
+        },
+        0, FILE_SIZE);
+
+    Register(
+        "VSICurl/random_read",
+        setup,
+        [poFixture]()
+        {
+            VSICurlClearCache();
+            VSILFILE* fp = VSIFOpenL(
+                poFixture->poServer->GetURL("/raw.bin").c_str(), "rb");
+            if( fp == nullptr )
+                return;
+            std::vector<GByte> abyBuffer(RANDOM_READ_SIZE);
+            for( int i = 0; i < N_RANDOM_READS; i++ )
+            {
+                const vsi_l_offset nOffset = static_cast<vsi_l_offset>(
+                    (static_cast<GUInt64>(i) * 2654435761U) %
+                    (FILE_SIZE - RANDOM_READ_SIZE));
+                VSIFSeekL(fp, nOffset, SEEK_SET);
+                if( VSIFReadL(&abyBuffer[0], 1, RANDOM_READ_SIZE, fp) ==
+                                                        RANDOM_READ_SIZE )
+                {
+                    gdfSink = gdfSink + abyBuffer[0];
+                }
+            }
+            VSIFCloseL(fp);
+        },
+        N_RANDOM_READS,
+        static_cast<double>(N_RANDOM_READS) * RANDOM_READ_SIZE);
+
+    Register(
+        "VSICurl/gtiff_read",
+        setup,
+        [poFixture]()
+        {
+            VSICurlClearCache();
+            GDALDatasetUniquePtr poDS(GDALDataset::Open(
+                poFixture->poServer->GetURL("/test.tif").c_str(), GDAL_OF_RASTER));
+            if( poDS == nullptr )
+                return;
+            std::vector<GByte> abyBuffer(
+                static_cast<size_t>(TIFF_SIZE) * TIFF_SIZE);
+            CPL_IGNORE_RET_VAL(poDS->GetRasterBand(1)->RasterIO(
+                GF_Read, 0, 0, TIFF_SIZE, TIFF_SIZE, &abyBuffer[0],
+                TIFF_SIZE, TIFF_SIZE, GDT_Byte, 0, 0, nullptr));
+            gdfSink = gdfSink + abyBuffer[0];
+        },
+        static_cast<double>(TIFF_SIZE) * TIFF_SIZE,
+        static_cast<double>(TIFF_SIZE) * TIFF_SIZE);
+
+}
+
+#endif // HAVE_MOCK_HTTP_SERVER
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main(int argc, char** argv)
+{
+    GDALAllRegister();
+
+    argc = GDALGeneralCmdLineProcessor(argc, &argv, 0);
+    if( argc < 1 )
+        exit(-argc);
+
+    CPLStringList aosFilters;
+    double dfMinTime = 0.5;
+    int nRepetitions = 1;
+    std::string osFormat("console");
+    std::string osOutput;
+    bool bList = false;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-list") )
+            bList = true;
+        else if( EQUAL(argv[i], "-filter") && i + 1 < argc )
+            aosFilters = CSLTokenizeString2(argv[++i], ",", 0);
+        else if( EQUAL(argv[i], "-min_time") && i + 1 < argc )
+            dfMinTime = CPLAtof(argv[++i]);
+        else if( EQUAL(argv[i], "-repetitions") && i + 1 < argc )
+            nRepetitions = std::max(1, atoi(argv[++i]));
+        else if( EQUAL(argv[i], "-format") && i + 1 < argc )
+            osFormat = CPLString(argv[++i]).tolower();
+        else if( EQUAL(argv[i], "-o") && i + 1 < argc )
+            osOutput = argv[++i];
+        else
+            Usage();
+    }
+    if( osFormat != "console" && osFormat != "json" && osFormat != "csv" )
+        Usage();
+
+    RegisterCopyWordsBenchmarks();
+    RegisterWarpBenchmarks();
+    RegisterOverviewBenchmarks();
+    RegisterGTiffBenchmarks();
+    RegisterOGRReadBenchmarks();
+    RegisterOGRSQLBenchmarks();
+#ifdef HAVE_MOCK_HTTP_SERVER
+    RegisterVSICurlBenchmarks();
+#endif
+
+    std::vector<ReportEntry> aoEntries;
+    // Progress goes to stderr when the report goes to stdout.
+    FILE* fpLog = (osFormat == "console" || !osOutput.empty()) ?
+                                                        stdout : stderr;
+    if( osFormat == "console" && !bList )
+    {
+        printf("%-60s %14s %14s %12s %s\n",
+               "Benchmark", "Time", "CPU", "Iterations", "Throughput");
+    }
+    for( const auto& oBench: gaoBenchmarks )
+    {
+        if( !MatchFilter(oBench.osName, aosFilters) )
+            continue;
+        if( bList )
+        {
+            printf("%s\n", oBench.osName.c_str());
+            continue;
+        }
+        if( !oBench.fnSetup() )
+        {
+            fprintf(fpLog, "%-60s (skipped)\n", oBench.osName.c_str());
+            continue;
+        }
+        const auto aoRuns = RunBenchmark(oBench, dfMinTime, nRepetitions);
+        for( const auto& oEntry: BuildReportEntries(oBench, aoRuns) )
+        {
+            if( osFormat == "console" )
+                PrintConsoleEntry(oEntry);
+            else
+            {
+                fprintf(fpLog, "%s\n", oEntry.osName.c_str());
+                fflush(fpLog);
+            }
+            aoEntries.push_back(oEntry);
+        }
+    }
+
+    int nRet = 0;
+    if( !bList && osFormat != "console" )
+    {
+        const std::string osReport = osFormat == "json" ?
+            FormatJSON(aoEntries) : FormatCSV(aoEntries);
+        if( osOutput.empty() )
+        {
+            printf("%s\n", osReport.c_str());
+        }
+        else
+        {
+            VSILFILE* fp = VSIFOpenL(osOutput.c_str(), "wb");
+            if( fp == nullptr ||
+                VSIFWriteL(osReport.data(), 1, osReport.size(), fp) !=
+                                                            osReport.size() )
+            {
+                fprintf(stderr, "Cannot write %s\n", osOutput.c_str());
+                nRet = 1;
+            }
+            if( fp )
+                VSIFCloseL(fp);
+        }
+    }
+
+    // Release fixtures, and stop the HTTP server, before GDAL cleanup.
+    gaoBenchmarks.clear();
+    VSIRmdirRecursive(BENCH_DIR);
+
+    CSLDestroy(argv);
+    GDALDestroyDriverManager();
+
+    return nRet;
+}
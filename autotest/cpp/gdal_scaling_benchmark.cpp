@@ -0,0 +1,892 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Multi-threaded scaling benchmark of read, write, warp and
+ *           feature scan workloads
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+// Where multireadtest and testmultithreadedwriting check the correctness of
+// concurrent accesses, this program measures how throughput scales with the
+// number of threads. Each workload processes a fixed amount of work (strong
+// scaling), split in small units that threads pull from a shared counter,
+// each thread using its own dataset handle, so that the remaining
+// serialization comes from GDAL shared state: block cache, driver manager,
+// pools...
+//
+// For each thread count, the report gives the throughput, the speedup and
+// efficiency relatively to one thread, the CPU utilization (low values mean
+// that threads are waiting), and the time spent waiting for the block cache
+// locks (GDAL_RB_LOCK_WAIT_STATS). Lock contention is also logged by builds
+// with DEBUG_CONTENTION when running with
+// --config GDAL_RB_LOCK_DEBUG_CONTENTION YES --debug LOCK
+
+#include "cpl_conv.h"
+#include "cpl_json.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+#include "gdal_priv.h"
+#include "gdal_utils.h"
+#include "ogr_spatialref.h"
+#include "ogrsf_frmts.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <sys/time.h>
+#define HAVE_GETRUSAGE
+#endif
+
+static void Usage()
+{
+    printf("Usage: gdal_scaling_benchmark [-workload read|write|warp|scan[,...]]\n");
+    printf("                              [-storage vsimem|local[,...]] [-tmpdir dir]\n");
+    printf("                              [-threads max_threads] [-thread_list n[,n]*]\n");
+    printf("                              [-size pixels] [-blocksize pixels]\n");
+    printf("                              [-co NAME=VALUE]* [-features count]\n");
+    printf("                              [-min_time seconds]\n");
+    printf("                              [-format text|json|csv] [-o filename]\n");
+    printf("\n");
+    printf("All workloads are run on both storages by default, with 1, 2, 4...\n");
+    printf("threads up to the number of CPUs.\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                              Options                                 */
+/************************************************************************/
+
+struct Options
+{
+    CPLStringList aosWorkloads{};
+    CPLStringList aosStorages{};
+    std::string   osTmpDir{};
+    std::vector<int> anThreads{};
+    int           nSize = 4096;
+    int           nBlockSize = 256;
+    int           nBands = 3;
+    CPLStringList aosCreationOptions{};
+    int           nFeatures = 500000;
+    double        dfMinTime = 1.0;
+};
+
+/************************************************************************/
+/*                              Result                                  */
+/************************************************************************/
+
+struct Result
+{
+    std::string osWorkload{};
+    std::string osStorage{};
+    int         nThreads = 0;
+    int         nPasses = 0;
+    double      dfWallTime = 0;     // seconds, for all passes
+    double      dfCPUTime = 0;      // seconds, for all passes
+    double      dfItems = 0;        // for all passes
+    double      dfBytes = 0;        // for all passes
+    double      dfLockWaitTime = 0; // seconds, for all passes
+    std::string osUnit{};
+
+    double GetRate() const
+    {
+        return dfWallTime > 0 ?
+            (dfBytes > 0 ? dfBytes : dfItems) / dfWallTime : 0;
+    }
+};
+
+/************************************************************************/
+/*                              Workload                                */
+/************************************************************************/
+
+struct WorkItems
+{
+    double dfItems = 0;
+    double dfBytes = 0;
+};
+
+struct Workload
+{
+    std::string osName{};
+    std::string osUnit{};
+    // Creates the input data in the directory. Returns false on error.
+    std::function<bool(const std::string&)> fnSetup{};
+    // Runs one pass with the specified number of threads.
+    std::function<WorkItems(const std::string&, int)> fnPass{};
+};
+
+static Options goOptions;
+
+/************************************************************************/
+/*                            RunThreads()                              */
+/************************************************************************/
+
+// Runs fnWorker(iThread) in nThreads threads, and waits for them.
+static void RunThreads( int nThreads, const std::function<void(int)>& fnWorker )
+{
+    std::vector<std::thread> aoThreads;
+    for( int i = 1; i < nThreads; ++i )
+        aoThreads.emplace_back(fnWorker, i);
+    fnWorker(0);
+    for( auto& oThread: aoThreads )
+        oThread.join();
+}
+
+/************************************************************************/
+/*                          GetProcessCPUTime()                         */
+/************************************************************************/
+
+static double GetProcessCPUTime()
+{
+#ifdef HAVE_GETRUSAGE
+    struct rusage sUsage;
+    if( getrusage(RUSAGE_SELF, &sUsage) != 0 )
+        return 0;
+    return sUsage.ru_utime.tv_sec + sUsage.ru_utime.tv_usec * 1e-6 +
+           sUsage.ru_stime.tv_sec + sUsage.ru_stime.tv_usec * 1e-6;
+#else
+    return 0;
+#endif
+}
+
+/************************************************************************/
+/*                          Raster workloads                            */
+/************************************************************************/
+
+static std::string GetSourceRasterName( const std::string& osDir )
+{
+    return CPLFormFilename(osDir.c_str(), "source", "tif");
+}
+
+static bool SetupRaster( const std::string& osDir )
+{
+    const std::string osFilename(GetSourceRasterName(osDir));
+    VSIStatBufL sStat;
+    if( VSIStatL(osFilename.c_str(), &sStat) == 0 )
+        return true;
+
+    auto poDrv = GetGDALDriverManager()->GetDriverByName("GTiff");
+    if( poDrv == nullptr )
+        return false;
+    CPLStringList aosOptions(goOptions.aosCreationOptions);
+    aosOptions.SetNameValue("TILED", "YES");
+    aosOptions.SetNameValue("BLOCKXSIZE",
+                            CPLSPrintf("%d", goOptions.nBlockSize));
+    aosOptions.SetNameValue("BLOCKYSIZE",
+                            CPLSPrintf("%d", goOptions.nBlockSize));
+    GDALDatasetUniquePtr poDS(poDrv->Create(
+        osFilename.c_str(), goOptions.nSize, goOptions.nSize,
+        goOptions.nBands, GDT_Byte, aosOptions.List()));
+    if( poDS == nullptr )
+        return false;
+
+    // 20x20 degrees over Europe, so that the warp workload reprojects
+    // to Web Mercator a non-trivial area.
+    const double adfGT[6] = { -10.0, 20.0 / goOptions.nSize, 0.0,
+                              60.0, 0.0, -20.0 / goOptions.nSize };
+    poDS->SetGeoTransform(const_cast<double*>(adfGT));
+    OGRSpatialReference oSRS;
+    oSRS.SetFromUserInput("WGS84");
+    oSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+    poDS->SetSpatialRef(&oSRS);
+
+    // A smooth pattern with some noise, to get realistic compression ratios.
+    std::vector<GByte> abyLine(goOptions.nSize);
+    GUInt32 nSeed = 1;
+    for( int iBand = 1; iBand <= goOptions.nBands; ++iBand )
+    {
+        auto poBand = poDS->GetRasterBand(iBand);
+        for( int iY = 0; iY < goOptions.nSize; ++iY )
+        {
+            for( int iX = 0; iX < goOptions.nSize; ++iX )
+            {
+                nSeed = nSeed * 1103515245U + 12345U;
+                abyLine[iX] = static_cast<GByte>(
+                    ((iX + iY * iBand) >> 3) + ((nSeed >> 16) & 7));
+            }
+            if( poBand->RasterIO(GF_Write, 0, iY, goOptions.nSize, 1,
+                                 abyLine.data(), goOptions.nSize, 1, GDT_Byte,
+                                 0, 0, nullptr) != CE_None )
+                return false;
+        }
+    }
+    CPLErrorReset();
+    poDS->FlushCache();
+    return CPLGetLastErrorType() != CE_Failure;
+}
+
+// Reads the source raster tile by tile.
+static WorkItems ReadPass( const std::string& osDir, int nThreads )
+{
+    const std::string osFilename(GetSourceRasterName(osDir));
+    const int nBlockSize = goOptions.nBlockSize;
+    const int nTilesPerRow = DIV_ROUND_UP(goOptions.nSize, nBlockSize);
+    const int nTiles = nTilesPerRow * nTilesPerRow;
+    std::atomic<int> nNextTile{0};
+
+    RunThreads(nThreads, [&](int)
+    {
+        GDALDatasetUniquePtr poDS(GDALDataset::Open(osFilename.c_str(),
+                                                    GDAL_OF_RASTER));
+        if( poDS == nullptr )
+            return;
+        std::vector<GByte> abyBuffer(
+            static_cast<size_t>(nBlockSize) * nBlockSize * goOptions.nBands);
+        while( true )
+        {
+            const int iTile = nNextTile++;
+            if( iTile >= nTiles )
+                break;
+            const int nXOff = (iTile % nTilesPerRow) * nBlockSize;
+            const int nYOff = (iTile / nTilesPerRow) * nBlockSize;
+            const int nXSize = std::min(nBlockSize, goOptions.nSize - nXOff);
+            const int nYSize = std::min(nBlockSize, goOptions.nSize - nYOff);
+            CPL_IGNORE_RET_VAL(poDS->RasterIO(
+                GF_Read, nXOff, nYOff, nXSize, nYSize,
+                abyBuffer.data(), nXSize, nYSize, GDT_Byte,
+                goOptions.nBands, nullptr, 0, 0, 0, nullptr));
+        }
+    });
+
+    WorkItems sItems;
+    sItems.dfItems = nTiles;
+    sItems.dfBytes = static_cast<double>(goOptions.nSize) * goOptions.nSize *
+                     goOptions.nBands;
+    return sItems;
+}
+
+// Each thread writes the tiles it pulls into its own output file.
+static WorkItems WritePass( const std::string& osDir, int nThreads )
+{
+    const int nBlockSize = goOptions.nBlockSize;
+    const int nTilesPerRow = DIV_ROUND_UP(goOptions.nSize, nBlockSize);
+    const int nTiles = nTilesPerRow * nTilesPerRow;
+    std::atomic<int> nNextTile{0};
+    auto poDrv = GetGDALDriverManager()->GetDriverByName("GTiff");
+
+    CPLStringList aosOptions(goOptions.aosCreationOptions);
+    aosOptions.SetNameValue("TILED", "YES");
+    aosOptions.SetNameValue("BLOCKXSIZE", CPLSPrintf("%d", nBlockSize));
+    aosOptions.SetNameValue("BLOCKYSIZE", CPLSPrintf("%d", nBlockSize));
+    aosOptions.SetNameValue("SPARSE_OK", "YES");
+
+    RunThreads(nThreads, [&](int iThread)
+    {
+        const std::string osFilename(CPLFormFilename(
+            osDir.c_str(), CPLSPrintf("out_%d", iThread), "tif"));
+        GDALDatasetUniquePtr poDS(poDrv->Create(
+            osFilename.c_str(), goOptions.nSize, goOptions.nSize,
+            goOptions.nBands, GDT_Byte, aosOptions.List()));
+        if( poDS == nullptr )
+            return;
+        std::vector<GByte> abyBuffer(
+            static_cast<size_t>(nBlockSize) * nBlockSize * goOptions.nBands);
+        while( true )
+        {
+            const int iTile = nNextTile++;
+            if( iTile >= nTiles )
+                break;
+            const int nXOff = (iTile % nTilesPerRow) * nBlockSize;
+            const int nYOff = (iTile / nTilesPerRow) * nBlockSize;
+            const int nXSize = std::min(nBlockSize, goOptions.nSize - nXOff);
+            const int nYSize = std::min(nBlockSize, goOptions.nSize - nYOff);
+            for( size_t i = 0; i < abyBuffer.size(); ++i )
+                abyBuffer[i] = static_cast<GByte>((i >> 4) + iTile);
+            CPL_IGNORE_RET_VAL(poDS->RasterIO(
+                GF_Write, nXOff, nYOff, nXSize, nYSize,
+                abyBuffer.data(), nXSize, nYSize, GDT_Byte,
+                goOptions.nBands, nullptr, 0, 0, 0, nullptr));
+        }
+        // Flushing and compressing are part of the workload.
+        poDS.reset();
+        VSIUnlink(osFilename.c_str());
+    });
+
+    WorkItems sItems;
+    sItems.dfItems = nTiles;
+    sItems.dfBytes = static_cast<double>(goOptions.nSize) * goOptions.nSize *
+                     goOptions.nBands;
+    return sItems;
+}
+
+// Reprojects the source raster to Web Mercator, in chunks of lines.
+static WorkItems WarpPass( const std::string& osDir, int nThreads )
+{
+    const std::string osFilename(GetSourceRasterName(osDir));
+    // Web Mercator extent of the source.
+    const double dfMinX = -1113194.908;
+    const double dfMaxX = 1113194.908;
+    const double dfMinY = 4865942.280;
+    const double dfMaxY = 8399737.890;
+    const int nXSize = goOptions.nSize;
+    const int nYSize = goOptions.nSize;
+    const int nChunkLines = 128;
+    const int nChunks = DIV_ROUND_UP(nYSize, nChunkLines);
+    const double dfResY = (dfMaxY - dfMinY) / nYSize;
+    std::atomic<int> nNextChunk{0};
+
+    RunThreads(nThreads, [&](int)
+    {
+        GDALDatasetUniquePtr poSrcDS(GDALDataset::Open(osFilename.c_str(),
+                                                       GDAL_OF_RASTER));
+        if( poSrcDS == nullptr )
+            return;
+        GDALDatasetH hSrcDS = GDALDataset::ToHandle(poSrcDS.get());
+        while( true )
+        {
+            const int iChunk = nNextChunk++;
+            if( iChunk >= nChunks )
+                break;
+            const int nLines =
+                std::min(nChunkLines, nYSize - iChunk * nChunkLines);
+            const double dfChunkMaxY = dfMaxY - iChunk * nChunkLines * dfResY;
+            const double dfChunkMinY = dfChunkMaxY - nLines * dfResY;
+            CPLStringList aosArgv;
+            aosArgv.AddString("-of");
+            aosArgv.AddString("MEM");
+            aosArgv.AddString("-t_srs");
+            aosArgv.AddString("EPSG:3857");
+            aosArgv.AddString("-te");
+            aosArgv.AddString(CPLSPrintf("%.17g", dfMinX));
+            aosArgv.AddString(CPLSPrintf("%.17g", dfChunkMinY));
+            aosArgv.AddString(CPLSPrintf("%.17g", dfMaxX));
+            aosArgv.AddString(CPLSPrintf("%.17g", dfChunkMaxY));
+            aosArgv.AddString("-ts");
+            aosArgv.AddString(CPLSPrintf("%d", nXSize));
+            aosArgv.AddString(CPLSPrintf("%d", nLines));
+            aosArgv.AddString("-r");
+            aosArgv.AddString("bilinear");
+            // Threads are already used at the chunk level.
+            aosArgv.AddString("-wo");
+            aosArgv.AddString("NUM_THREADS=1");
+            GDALWarpAppOptions* psOptions =
+                GDALWarpAppOptionsNew(aosArgv.List(), nullptr);
+            GDALDatasetH hOutDS =
+                GDALWarp("", nullptr, 1, &hSrcDS, psOptions, nullptr);
+            GDALWarpAppOptionsFree(psOptions);
+            if( hOutDS )
+                GDALClose(hOutDS);
+        }
+    });
+
+    WorkItems sItems;
+    sItems.dfItems = static_cast<double>(nXSize) * nYSize;
+    return sItems;
+}
+
+/************************************************************************/
+/*                          Vector workload                             */
+/************************************************************************/
+
+static std::string GetSourceVectorName( const std::string& osDir )
+{
+    return CPLFormFilename(osDir.c_str(), "source", "shp");
+}
+
+static bool SetupVector( const std::string& osDir )
+{
+    const std::string osFilename(GetSourceVectorName(osDir));
+    VSIStatBufL sStat;
+    if( VSIStatL(osFilename.c_str(), &sStat) == 0 )
+        return true;
+
+    auto poDrv = GetGDALDriverManager()->GetDriverByName("ESRI Shapefile");
+    if( poDrv == nullptr )
+        return false;
+    GDALDatasetUniquePtr poDS(poDrv->Create(osFilename.c_str(), 0, 0, 0,
+                                            GDT_Unknown, nullptr));
+    if( poDS == nullptr )
+        return false;
+    auto poLayer = poDS->CreateLayer("source", nullptr, wkbLineString,
+                                     nullptr);
+    if( poLayer == nullptr )
+        return false;
+    OGRFieldDefn oFieldInt("int", OFTInteger);
+    OGRFieldDefn oFieldReal("real", OFTReal);
+    OGRFieldDefn oFieldStr("str", OFTString);
+    oFieldStr.SetWidth(32);
+    if( poLayer->CreateField(&oFieldInt) != OGRERR_NONE ||
+        poLayer->CreateField(&oFieldReal) != OGRERR_NONE ||
+        poLayer->CreateField(&oFieldStr) != OGRERR_NONE )
+        return false;
+    for( int i = 0; i < goOptions.nFeatures; ++i )
+    {
+        OGRFeature oFeature(poLayer->GetLayerDefn());
+        oFeature.SetField(0, i);
+        oFeature.SetField(1, i * 0.5);
+        oFeature.SetField(2, CPLSPrintf("feature %d", i));
+        OGRLineString* poLS = new OGRLineString();
+        for( int j = 0; j < 8; ++j )
+            poLS->addPoint((i % 1000) + j * 0.1, (i / 1000) + (j % 2) * 0.1);
+        oFeature.SetGeometryDirectly(poLS);
+        if( poLayer->CreateFeature(&oFeature) != OGRERR_NONE )
+            return false;
+    }
+    return true;
+}
+
+// Scans the features in chunks, using SetNextByIndex() to position each
+// thread at the start of its chunks.
+static WorkItems ScanPass( const std::string& osDir, int nThreads )
+{
+    const std::string osFilename(GetSourceVectorName(osDir));
+    constexpr int CHUNK_SIZE = 4096;
+    const int nChunks = DIV_ROUND_UP(goOptions.nFeatures, CHUNK_SIZE);
+    std::atomic<int> nNextChunk{0};
+
+    RunThreads(nThreads, [&](int)
+    {
+        GDALDatasetUniquePtr poDS(GDALDataset::Open(osFilename.c_str(),
+                                                    GDAL_OF_VECTOR));
+        if( poDS == nullptr )
+            return;
+        OGRLayer* poLayer = poDS->GetLayer(0);
+        double dfSum = 0;
+        while( true )
+        {
+            const int iChunk = nNextChunk++;
+            if( iChunk >= nChunks )
+                break;
+            if( poLayer->SetNextByIndex(
+                    static_cast<GIntBig>(iChunk) * CHUNK_SIZE) != OGRERR_NONE )
+                break;
+            for( int i = 0; i < CHUNK_SIZE; ++i )
+            {
+                std::unique_ptr<OGRFeature> poFeature(
+                                                poLayer->GetNextFeature());
+                if( poFeature == nullptr )
+                    break;
+                dfSum += poFeature->GetFieldAsDouble(1);
+                const OGRGeometry* poGeom = poFeature->GetGeometryRef();
+                if( poGeom )
+                {
+                    OGREnvelope sEnvelope;
+                    poGeom->getEnvelope(&sEnvelope);
+                    dfSum += sEnvelope.MaxX;
+                }
+            }
+        }
+        CPL_IGNORE_RET_VAL(dfSum);
+    });
+
+    WorkItems sItems;
+    sItems.dfItems = goOptions.nFeatures;
+    return sItems;
+}
+
+/************************************************************************/
+/*                            Measure()                                 */
+/************************************************************************/
+
+// Runs passes until the minimum time is reached.
+static Result Measure( const Workload& oWorkload, const std::string& osDir,
+                       const std::string& osStorage, int nThreads )
+{
+    Result oResult;
+    oResult.osWorkload = oWorkload.osName;
+    oResult.osStorage = osStorage;
+    oResult.osUnit = oWorkload.osUnit;
+    oResult.nThreads = nThreads;
+
+    GDALCacheStatistics sStatsBefore;
+    GDALGetCacheStatistics(&sStatsBefore);
+    const double dfCPUTimeBefore = GetProcessCPUTime();
+    const auto nStart = std::chrono::steady_clock::now();
+    do
+    {
+        const WorkItems sItems = oWorkload.fnPass(osDir, nThreads);
+        oResult.dfItems += sItems.dfItems;
+        oResult.dfBytes += sItems.dfBytes;
+        oResult.nPasses++;
+        oResult.dfWallTime = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - nStart).count();
+    } while( oResult.dfWallTime < goOptions.dfMinTime );
+    oResult.dfCPUTime = GetProcessCPUTime() - dfCPUTimeBefore;
+    GDALCacheStatistics sStatsAfter;
+    GDALGetCacheStatistics(&sStatsAfter);
+    oResult.dfLockWaitTime =
+        sStatsAfter.dfLockWaitTime - sStatsBefore.dfLockWaitTime;
+    return oResult;
+}
+
+/************************************************************************/
+/*                             Reports                                  */
+/************************************************************************/
+
+// Returns the result with one thread of the same workload and storage.
+static const Result* GetBaseline( const std::vector<Result>& aoResults,
+                                  const Result& oResult )
+{
+    for( const auto& oOther: aoResults )
+    {
+        if( oOther.osWorkload == oResult.osWorkload &&
+            oOther.osStorage == oResult.osStorage && oOther.nThreads == 1 )
+            return &oOther;
+    }
+    return nullptr;
+}
+
+struct Derived
+{
+    double dfSpeedup = 0;
+    double dfEfficiency = 0;
+    double dfCPUUtilization = 0;
+    double dfLockWaitRatio = 0;
+};
+
+static Derived GetDerived( const std::vector<Result>& aoResults,
+                           const Result& oResult )
+{
+    Derived sDerived;
+    const Result* poBaseline = GetBaseline(aoResults, oResult);
+    if( poBaseline && poBaseline->GetRate() > 0 )
+    {
+        sDerived.dfSpeedup = oResult.GetRate() / poBaseline->GetRate();
+        sDerived.dfEfficiency = sDerived.dfSpeedup / oResult.nThreads;
+    }
+    const double dfThreadTime = oResult.dfWallTime * oResult.nThreads;
+    if( dfThreadTime > 0 )
+    {
+        sDerived.dfCPUUtilization = oResult.dfCPUTime / dfThreadTime;
+        sDerived.dfLockWaitRatio = oResult.dfLockWaitTime / dfThreadTime;
+    }
+    return sDerived;
+}
+
+static std::string FormatRate( const Result& oResult )
+{
+    if( oResult.dfBytes > 0 )
+        return CPLSPrintf("%.1f MB/s", oResult.GetRate() / (1024 * 1024));
+    if( oResult.GetRate() >= 1e6 )
+        return CPLSPrintf("%.2f M%s/s", oResult.GetRate() / 1e6,
+                          oResult.osUnit.c_str());
+    return CPLSPrintf("%.0f %s/s", oResult.GetRate(), oResult.osUnit.c_str());
+}
+
+static std::string FormatText( const std::vector<Result>& aoResults )
+{
+    std::string osRet;
+    osRet += CPLSPrintf("%-8s %-8s %7s %8s %18s %8s %10s %8s %10s\n",
+                        "Workload", "Storage", "Threads", "Time",
+                        "Throughput", "Speedup", "Efficiency", "CPU",
+                        "Lock wait");
+    for( const auto& oResult: aoResults )
+    {
+        const Derived sDerived = GetDerived(aoResults, oResult);
+        osRet += CPLSPrintf("%-8s %-8s %7d %7.3fs %18s %7.2fx %9.0f%% %7.0f%% "
+                            "%9.1f%%\n",
+                            oResult.osWorkload.c_str(),
+                            oResult.osStorage.c_str(),
+                            oResult.nThreads,
+                            oResult.dfWallTime / oResult.nPasses,
+                            FormatRate(oResult).c_str(),
+                            sDerived.dfSpeedup,
+                            sDerived.dfEfficiency * 100,
+                            sDerived.dfCPUUtilization * 100,
+                            sDerived.dfLockWaitRatio * 100);
+    }
+    // Point out the likely scaling bottlenecks.
+    for( const auto& oResult: aoResults )
+    {
+        const Derived sDerived = GetDerived(aoResults, oResult);
+        if( oResult.nThreads == 1 || sDerived.dfEfficiency >= 0.7 )
+            continue;
+        if( sDerived.dfLockWaitRatio >= 0.05 )
+        {
+            osRet += CPLSPrintf("%s/%s with %d threads: block cache lock "
+                                "contention (%.0f%% of the thread time)\n",
+                                oResult.osWorkload.c_str(),
+                                oResult.osStorage.c_str(), oResult.nThreads,
+                                sDerived.dfLockWaitRatio * 100);
+        }
+#ifdef HAVE_GETRUSAGE
+        else if( sDerived.dfCPUUtilization < 0.7 )
+        {
+            osRet += CPLSPrintf("%s/%s with %d threads: threads are idle "
+                                "%.0f%% of the time (locks or I/O)\n",
+                                oResult.osWorkload.c_str(),
+                                oResult.osStorage.c_str(), oResult.nThreads,
+                                (1 - sDerived.dfCPUUtilization) * 100);
+        }
+#endif
+    }
+    return osRet;
+}
+
+static std::string FormatJSON( const std::vector<Result>& aoResults )
+{
+    CPLJSONObject oRoot;
+    CPLJSONObject oContext;
+    oContext.Add("gdal_version", GDALVersionInfo("RELEASE_NAME"));
+    oContext.Add("num_cpus", CPLGetNumCPUs());
+    oContext.Add("size", goOptions.nSize);
+    oContext.Add("block_size", goOptions.nBlockSize);
+    oContext.Add("features", goOptions.nFeatures);
+    oContext.Add("cache_max", GDALGetCacheMax64());
+    oRoot.Add("context", oContext);
+    CPLJSONArray oArray;
+    for( const auto& oResult: aoResults )
+    {
+        const Derived sDerived = GetDerived(aoResults, oResult);
+        CPLJSONObject oObj;
+        oObj.Add("workload", oResult.osWorkload);
+        oObj.Add("storage", oResult.osStorage);
+        oObj.Add("threads", oResult.nThreads);
+        oObj.Add("passes", oResult.nPasses);
+        oObj.Add("time_per_pass", oResult.dfWallTime / oResult.nPasses);
+        if( oResult.dfBytes > 0 )
+            oObj.Add("bytes_per_second", oResult.GetRate());
+        else
+            oObj.Add(oResult.osUnit + "_per_second", oResult.GetRate());
+        oObj.Add("speedup", sDerived.dfSpeedup);
+        oObj.Add("efficiency", sDerived.dfEfficiency);
+#ifdef HAVE_GETRUSAGE
+        oObj.Add("cpu_utilization", sDerived.dfCPUUtilization);
+#endif
+        oObj.Add("lock_wait_time", oResult.dfLockWaitTime);
+        oArray.Add(oObj);
+    }
+    oRoot.Add("results", oArray);
+    return oRoot.Format(CPLJSONObject::PrettyFormat::Pretty);
+}
+
+static std::string FormatCSV( const std::vector<Result>& aoResults )
+{
+    std::string osRet("workload,storage,threads,passes,time_per_pass,rate,"
+                      "rate_unit,speedup,efficiency,cpu_utilization,"
+                      "lock_wait_time\n");
+    for( const auto& oResult: aoResults )
+    {
+        const Derived sDerived = GetDerived(aoResults, oResult);
+        osRet += CPLSPrintf("%s,%s,%d,%d,%.6f,%.6g,%s,%.4f,%.4f,%.4f,%.6f\n",
+                            oResult.osWorkload.c_str(),
+                            oResult.osStorage.c_str(),
+                            oResult.nThreads, oResult.nPasses,
+                            oResult.dfWallTime / oResult.nPasses,
+                            oResult.GetRate(),
+                            oResult.dfBytes > 0 ? "bytes" :
+                                                oResult.osUnit.c_str(),
+                            sDerived.dfSpeedup, sDerived.dfEfficiency,
+                            sDerived.dfCPUUtilization,
+                            oResult.dfLockWaitTime);
+    }
+    return osRet;
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main(int argc, char** argv)
+{
+    // Must be set before the first use of the block cache.
+    if( CPLGetConfigOption("GDAL_RB_LOCK_WAIT_STATS", nullptr) == nullptr )
+        CPLSetConfigOption("GDAL_RB_LOCK_WAIT_STATS", "YES");
+
+    GDALAllRegister();
+
+    argc = GDALGeneralCmdLineProcessor(argc, &argv, 0);
+    if( argc < 1 )
+        exit(-argc);
+
+    std::string osFormat("text");
+    std::string osOutput;
+    int nMaxThreads = CPLGetNumCPUs();
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-workload") && i + 1 < argc )
+            goOptions.aosWorkloads = CSLTokenizeString2(argv[++i], ",", 0);
+        else if( EQUAL(argv[i], "-storage") && i + 1 < argc )
+            goOptions.aosStorages = CSLTokenizeString2(argv[++i], ",", 0);
+        else if( EQUAL(argv[i], "-tmpdir") && i + 1 < argc )
+            goOptions.osTmpDir = argv[++i];
+        else if( EQUAL(argv[i], "-threads") && i + 1 < argc )
+            nMaxThreads = std::max(1, atoi(argv[++i]));
+        else if( EQUAL(argv[i], "-thread_list") && i + 1 < argc )
+        {
+            const CPLStringList aosList(
+                CSLTokenizeString2(argv[++i], ",", 0));
+            for( int j = 0; j < aosList.size(); ++j )
+                goOptions.anThreads.push_back(std::max(1, atoi(aosList[j])));
+        }
+        else if( EQUAL(argv[i], "-size") && i + 1 < argc )
+            goOptions.nSize = std::max(1, atoi(argv[++i]));
+        else if( EQUAL(argv[i], "-blocksize") && i + 1 < argc )
+            goOptions.nBlockSize = std::max(16, atoi(argv[++i]) / 16 * 16);
+        else if( EQUAL(argv[i], "-co") && i + 1 < argc )
+            goOptions.aosCreationOptions.AddString(argv[++i]);
+        else if( EQUAL(argv[i], "-features") && i + 1 < argc )
+            goOptions.nFeatures = std::max(1, atoi(argv[++i]));
+        else if( EQUAL(argv[i], "-min_time") && i + 1 < argc )
+            goOptions.dfMinTime = CPLAtof(argv[++i]);
+        else if( EQUAL(argv[i], "-format") && i + 1 < argc )
+            osFormat = CPLString(argv[++i]).tolower();
+        else if( EQUAL(argv[i], "-o") && i + 1 < argc )
+            osOutput = argv[++i];
+        else
+            Usage();
+    }
+    if( osFormat != "text" && osFormat != "json" && osFormat != "csv" )
+        Usage();
+
+    if( goOptions.anThreads.empty() )
+    {
+        for( int n = 1; n < nMaxThreads; n *= 2 )
+            goOptions.anThreads.push_back(n);
+        goOptions.anThreads.push_back(nMaxThreads);
+    }
+    // The baseline is needed for the speedup.
+    if( std::find(goOptions.anThreads.begin(), goOptions.anThreads.end(),
+                  1) == goOptions.anThreads.end() )
+        goOptions.anThreads.insert(goOptions.anThreads.begin(), 1);
+
+    if( goOptions.aosWorkloads.empty() )
+        goOptions.aosWorkloads = CSLTokenizeString2("read,write,warp,scan",
+                                                    ",", 0);
+    if( goOptions.aosStorages.empty() )
+        goOptions.aosStorages = CSLTokenizeString2("vsimem,local", ",", 0);
+    if( goOptions.aosCreationOptions.FetchNameValue("COMPRESS") == nullptr )
+        goOptions.aosCreationOptions.SetNameValue("COMPRESS", "DEFLATE");
+
+    std::vector<Workload> aoWorkloads;
+    {
+        Workload oWorkload;
+        oWorkload.osName = "read";
+        oWorkload.osUnit = "tiles";
+        oWorkload.fnSetup = SetupRaster;
+        oWorkload.fnPass = ReadPass;
+        aoWorkloads.push_back(oWorkload);
+    }
+    {
+        Workload oWorkload;
+        oWorkload.osName = "write";
+        oWorkload.osUnit = "tiles";
+        oWorkload.fnSetup = [](const std::string&) { return true; };
+        oWorkload.fnPass = WritePass;
+        aoWorkloads.push_back(oWorkload);
+    }
+    {
+        Workload oWorkload;
+        oWorkload.osName = "warp";
+        oWorkload.osUnit = "pixels";
+        oWorkload.fnSetup = SetupRaster;
+        oWorkload.fnPass = WarpPass;
+        aoWorkloads.push_back(oWorkload);
+    }
+    {
+        Workload oWorkload;
+        oWorkload.osName = "scan";
+        oWorkload.osUnit = "features";
+        oWorkload.fnSetup = SetupVector;
+        oWorkload.fnPass = ScanPass;
+        aoWorkloads.push_back(oWorkload);
+    }
+
+    // Progress goes to stderr when the report goes to stdout.
+    FILE* fpLog = (osFormat == "text" || !osOutput.empty()) ? stdout : stderr;
+    std::vector<Result> aoResults;
+    int nRet = 0;
+    for( int iStorage = 0; iStorage < goOptions.aosStorages.size();
+         ++iStorage )
+    {
+        const std::string osStorage(goOptions.aosStorages[iStorage]);
+        std::string osDir;
+        if( osStorage == "vsimem" )
+            osDir = "/vsimem/gdal_scaling_benchmark";
+        else if( osStorage == "local" )
+        {
+            osDir = goOptions.osTmpDir.empty() ?
+                std::string(CPLGenerateTempFilename("gdal_scaling_benchmark")) :
+                std::string(CPLFormFilename(goOptions.osTmpDir.c_str(),
+                                            "gdal_scaling_benchmark",
+                                            nullptr));
+        }
+        else
+            Usage();
+        if( VSIMkdir(osDir.c_str(), 0755) != 0 )
+        {
+            fprintf(stderr, "Cannot create %s\n", osDir.c_str());
+            nRet = 1;
+            continue;
+        }
+
+        for( const auto& oWorkload: aoWorkloads )
+        {
+            if( goOptions.aosWorkloads.FindString(
+                                    oWorkload.osName.c_str()) < 0 )
+                continue;
+            if( !oWorkload.fnSetup(osDir) )
+            {
+                fprintf(stderr, "Cannot create the data of the %s workload\n",
+                        oWorkload.osName.c_str());
+                nRet = 1;
+                continue;
+            }
+            for( int nThreads: goOptions.anThreads )
+            {
+                fprintf(fpLog, "Running %s on %s with %d thread(s)...\n",
+                        oWorkload.osName.c_str(), osStorage.c_str(),
+                        nThreads);
+                fflush(fpLog);
+                aoResults.push_back(
+                    Measure(oWorkload, osDir, osStorage, nThreads));
+            }
+        }
+        VSIRmdirRecursive(osDir.c_str());
+    }
+
+    const std::string osReport =
+        osFormat == "json" ? FormatJSON(aoResults) :
+        osFormat == "csv" ? FormatCSV(aoResults) : FormatText(aoResults);
+    if( osOutput.empty() )
+    {
+        printf("%s%s", osFormat == "text" ? "\n" : "", osReport.c_str());
+    }
+    else
+    {
+        VSILFILE* fp = VSIFOpenL(osOutput.c_str(), "wb");
+        if( fp == nullptr ||
+            VSIFWriteL(osReport.data(), 1, osReport.size(), fp) !=
+                                                        osReport.size() )
+        {
+            fprintf(stderr, "Cannot write %s\n", osOutput.c_str());
+            nRet = 1;
+        }
+        if( fp )
+            VSIFCloseL(fp);
+    }
+
+    CSLDestroy(argv);
+    GDALDestroyDriverManager();
+
+    return nRet;
+}
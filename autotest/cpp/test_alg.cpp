@@ -32,8 +32,16 @@
 #include "cpl_conv.h"
 
 #include "gdal_alg.h"
+#include "gdal_alg_priv.h"
 #include "gdalwarper.h"
 #include "gdal_priv.h"
+#include "ogr_spatialref.h"
+#include "ogrsf_frmts.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
 
 namespace tut
 {
@@ -290,5 +298,513 @@ namespace tut
         GDALClose(hWarpedVRT);
     }
 
+    // Test GDALCreateWarpPlanTransformer()
+    template<> template<> void object::test<9>()
+    {
+        OGRSpatialReference oSrcSRS;
+        oSrcSRS.importFromEPSG(4326);
+        oSrcSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+        OGRSpatialReference oDstSRS;
+        oDstSRS.importFromEPSG(32631);
+        oDstSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+        const double adfSrcGeoTransform[6] = { 0, 0.01, 0, 50, 0, -0.01 };
+        const double adfDstGeoTransform[6] = { 300000, 1000, 0, 5540000, 0, -1000 };
+        void* hBase = GDALCreateGenImgProjTransformer4(
+            OGRSpatialReference::ToHandle(&oSrcSRS), adfSrcGeoTransform,
+            OGRSpatialReference::ToHandle(&oDstSRS), adfDstGeoTransform,
+            nullptr);
+        ensure( hBase != nullptr );
+
+        void* hPlan = GDALCreateWarpPlanTransformer(
+            GDALGenImgProjTransform, hBase, 200, 100, 8, nullptr);
+        ensure( hPlan != nullptr );
+
+        // Check interpolated values against the exact transformer
+        const double adfDstX[] = { 0.5, 10.25, 123.5, 199.9, 64 };
+        const double adfDstY[] = { 0.5, 80.75, 33.5, 99.9, 64 };
+        for( int i = 0; i < 5; i++ )
+        {
+            double dfX = adfDstX[i];
+            double dfY = adfDstY[i];
+            double dfZ = 0;
+            int bSuccess = FALSE;
+            ensure( GDALWarpPlanTransform(hPlan, TRUE, 1,
+                                          &dfX, &dfY, &dfZ, &bSuccess) );
+            ensure( bSuccess );
+            double dfExpectedX = adfDstX[i];
+            double dfExpectedY = adfDstY[i];
+            dfZ = 0;
+            GDALGenImgProjTransform(hBase, TRUE, 1, &dfExpectedX,
+                                    &dfExpectedY, &dfZ, &bSuccess);
+            ensure( bSuccess );
+            ensure( fabs(dfX - dfExpectedX) < 0.2 );
+            ensure( fabs(dfY - dfExpectedY) < 0.2 );
+        }
+
+        // Source to destination is delegated to the base transformer
+        {
+            double dfX = 500;
+            double dfY = 250;
+            double dfZ = 0;
+            int bSuccess = FALSE;
+            ensure( GDALWarpPlanTransform(hPlan, FALSE, 1,
+                                          &dfX, &dfY, &dfZ, &bSuccess) );
+            double dfExpectedX = 500;
+            double dfExpectedY = 250;
+            dfZ = 0;
+            GDALGenImgProjTransform(hBase, FALSE, 1, &dfExpectedX,
+                                    &dfExpectedY, &dfZ, &bSuccess);
+            ensure_equals( dfX, dfExpectedX );
+            ensure_equals( dfY, dfExpectedY );
+        }
+        GDALDestroyGenImgProjTransformer(hBase);
+
+        // Serialization round trip
+        CPLXMLNode* psTree =
+            GDALSerializeTransformer(GDALWarpPlanTransform, hPlan);
+        ensure( psTree != nullptr );
+        GDALTransformerFunc pfnFunc = nullptr;
+        void* hPlan2 = nullptr;
+        ensure_equals( GDALDeserializeTransformer(psTree, &pfnFunc, &hPlan2),
+                       CE_None );
+        CPLDestroyXMLNode(psTree);
+        ensure( pfnFunc == GDALWarpPlanTransform );
+        ensure( hPlan2 != nullptr );
+
+        void* hClone = GDALCloneTransformer(hPlan2);
+        ensure( hClone != nullptr );
+        double adfX[2] = { 123.5, 210 };
+        double adfY[2] = { 33.5, 50 };
+        double adfZ[2] = { 0, 0 };
+        int abSuccess[2] = { FALSE, FALSE };
+        ensure( GDALWarpPlanTransform(hPlan, TRUE, 2,
+                                      adfX, adfY, adfZ, abSuccess) );
+        for( void* hOther: { hPlan2, hClone } )
+        {
+            double adfX2[2] = { 123.5, 210 };
+            double adfY2[2] = { 33.5, 50 };
+            double adfZ2[2] = { 0, 0 };
+            int abSuccess2[2] = { FALSE, FALSE };
+            ensure( GDALWarpPlanTransform(hOther, TRUE, 2,
+                                          adfX2, adfY2, adfZ2, abSuccess2) );
+            for( int i = 0; i < 2; i++ )
+            {
+                ensure( abSuccess2[i] );
+                ensure_equals( adfX2[i], adfX[i] );
+                ensure_equals( adfY2[i], adfY[i] );
+            }
+        }
+
+        GDALDestroyTransformer(hClone);
+        GDALDestroyTransformer(hPlan2);
+        GDALDestroyWarpPlanTransformer(hPlan);
+    }
+
+    static int nCountedTransformPoints = 0;
+    static int CountingGenImgProjTransform( void *pTransformArg, int bDstToSrc,
+                                            int nPointCount,
+                                            double *x, double *y, double *z,
+                                            int *panSuccess )
+    {
+        nCountedTransformPoints += nPointCount;
+        return GDALGenImgProjTransform(pTransformArg, bDstToSrc, nPointCount,
+                                       x, y, z, panSuccess);
+    }
+
+    // Test the 2D grid mode of GDALApproxTransform()
+    template<> template<> void object::test<10>()
+    {
+        OGRSpatialReference oSrcSRS;
+        oSrcSRS.importFromEPSG(4326);
+        oSrcSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+        OGRSpatialReference oDstSRS;
+        oDstSRS.importFromEPSG(32631);
+        oDstSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+        const double adfSrcGeoTransform[6] = { 0, 0.01, 0, 50, 0, -0.01 };
+        const double adfDstGeoTransform[6] = { 300000, 100, 0, 5540000, 0, -100 };
+        void* hBase = GDALCreateGenImgProjTransformer4(
+            OGRSpatialReference::ToHandle(&oSrcSRS), adfSrcGeoTransform,
+            OGRSpatialReference::ToHandle(&oDstSRS), adfDstGeoTransform,
+            nullptr);
+        ensure( hBase != nullptr );
+
+        const int nXSize = 500;
+        const int nYSize = 100;
+        const double dfMaxError = 0.125;
+        int anPointCount[2] = { 0, 0 };
+        for( int iStep = 0; iStep < 2; iStep++ )
+        {
+            CPLSetConfigOption("GDAL_APPROX_TRANSFORMER_GRID_STEP",
+                               iStep == 0 ? nullptr : "16");
+            void* hApprox = GDALCreateApproxTransformer(
+                CountingGenImgProjTransform, hBase, dfMaxError);
+            CPLSetConfigOption("GDAL_APPROX_TRANSFORMER_GRID_STEP", nullptr);
+            ensure( hApprox != nullptr );
+            nCountedTransformPoints = 0;
+            std::vector<double> adfX(nXSize), adfY(nXSize), adfZ(nXSize);
+            std::vector<int> abSuccess(nXSize);
+            for( int iY = 0; iY < nYSize; iY++ )
+            {
+                for( int iX = 0; iX < nXSize; iX++ )
+                {
+                    adfX[iX] = iX + 0.5;
+                    adfY[iX] = iY + 0.5;
+                    adfZ[iX] = 0;
+                }
+                ensure( GDALApproxTransform(hApprox, TRUE, nXSize,
+                                            adfX.data(), adfY.data(),
+                                            adfZ.data(), abSuccess.data()) );
+                for( int iX = 0; iX < nXSize; iX++ )
+                {
+                    double dfX = iX + 0.5;
+                    double dfY = iY + 0.5;
+                    double dfZ = 0;
+                    int bSuccess = FALSE;
+                    GDALGenImgProjTransform(hBase, TRUE, 1,
+                                            &dfX, &dfY, &dfZ, &bSuccess);
+                    ensure( bSuccess );
+                    ensure( abSuccess[iX] );
+                    ensure( fabs(adfX[iX] - dfX) + fabs(adfY[iX] - dfY) <=
+                            1.5 * dfMaxError );
+                }
+            }
+            anPointCount[iStep] = nCountedTransformPoints;
+            GDALDestroyApproxTransformer(hApprox);
+        }
+        // The grid must save exact transformations.
+        ensure( anPointCount[1] < anPointCount[0] );
+
+        GDALDestroyGenImgProjTransformer(hBase);
+    }
+
+    // Test that GDALViewshedGenerateMulti() counts the single viewsheds
+    template<> template<> void object::test<11>()
+    {
+        GDALDriver* poMEMDriver =
+            GetGDALDriverManager()->GetDriverByName("MEM");
+        if( poMEMDriver == nullptr )
+            return;
+        const int nSize = 32;
+        std::unique_ptr<GDALDataset> poDEM(
+            poMEMDriver->Create("", nSize, nSize, 1, GDT_Float32, nullptr));
+        const double adfGeoTransform[6] = { 0, 10, 0, nSize * 10, 0, -10 };
+        poDEM->SetGeoTransform(const_cast<double*>(adfGeoTransform));
+        std::vector<float> afDEM(nSize * nSize);
+        for( int iY = 0; iY < nSize; iY++ )
+        {
+            for( int iX = 0; iX < nSize; iX++ )
+            {
+                afDEM[iY * nSize + iX] = static_cast<float>(
+                    100 * std::sin(iX * 0.3) * std::cos(iY * 0.2));
+            }
+        }
+        ensure_equals( poDEM->GetRasterBand(1)->RasterIO(GF_Write,
+                            0, 0, nSize, nSize, afDEM.data(), nSize, nSize,
+                            GDT_Float32, 0, 0, nullptr), CE_None );
+        GDALRasterBandH hBand =
+            GDALRasterBand::ToHandle(poDEM->GetRasterBand(1));
+
+        const double adfX[] = { 15, 155, 305, 95 };
+        const double adfY[] = { 305, 165, 15, 95 };
+        const double adfHeight[] = { 10, 2, 30, 5 };
+        const int nObservers = 4;
+
+        std::vector<GUInt32> anExpected(nSize * nSize);
+        for( int i = 0; i < nObservers; i++ )
+        {
+            GDALDatasetH hSingle = GDALViewshedGenerate(
+                hBand, "MEM", "", nullptr, adfX[i], adfY[i], adfHeight[i],
+                0.0, 1, 0, 0, -1, 0.0, GVM_Edge, 0.0, nullptr, nullptr,
+                GVOT_NORMAL, nullptr);
+            ensure( hSingle != nullptr );
+            std::vector<GUInt32> anSingle(nSize * nSize);
+            ensure_equals( GDALRasterIO(GDALGetRasterBand(hSingle, 1),
+                                GF_Read, 0, 0, nSize, nSize, anSingle.data(),
+                                nSize, nSize, GDT_UInt32, 0, 0), CE_None );
+            GDALClose(hSingle);
+            for( int j = 0; j < nSize * nSize; j++ )
+                anExpected[j] += anSingle[j];
+        }
+
+        for( const char* pszNumThreads: { "1", "3" } )
+        {
+            const char* const apszOptions[] = {
+                CPLSPrintf("NUM_THREADS=%s", pszNumThreads), nullptr };
+            GDALDatasetH hMulti = GDALViewshedGenerateMulti(
+                hBand, "MEM", "", nullptr, nObservers, adfX, adfY, adfHeight,
+                0.0, 0.0, GVM_Edge, 0.0, nullptr, nullptr, apszOptions);
+            ensure( hMulti != nullptr );
+            ensure_equals( GDALGetRasterDataType(GDALGetRasterBand(hMulti, 1)),
+                           GDT_UInt16 );
+            std::vector<GUInt32> anGot(nSize * nSize);
+            ensure_equals( GDALRasterIO(GDALGetRasterBand(hMulti, 1),
+                                GF_Read, 0, 0, nSize, nSize, anGot.data(),
+                                nSize, nSize, GDT_UInt32, 0, 0), CE_None );
+            GDALClose(hMulti);
+            ensure( anGot == anExpected );
+        }
+    }
+
+    // Test GDALCreateSummedAreaTable() and window sums / averages
+    template<> template<> void object::test<12>()
+    {
+        GDALDriver* poMEMDriver =
+            GetGDALDriverManager()->GetDriverByName("MEM");
+        if( poMEMDriver == nullptr )
+            return;
+        const int nXSize = 37;
+        const int nYSize = 23;
+        std::unique_ptr<GDALDataset> poDS(
+            poMEMDriver->Create("", nXSize, nYSize, 1, GDT_Float32, nullptr));
+        std::vector<float> afData(nXSize * nYSize);
+        for( int i = 0; i < nXSize * nYSize; i++ )
+            afData[i] = static_cast<float>((i * 37) % 101);
+        GDALRasterBand* poBand = poDS->GetRasterBand(1);
+        ensure_equals( poBand->RasterIO(GF_Write, 0, 0, nXSize, nYSize,
+                                        afData.data(), nXSize, nYSize,
+                                        GDT_Float32, 0, 0, nullptr),
+                       CE_None );
+
+        const auto BruteForceSum = [&](int nXOff, int nYOff, int nW, int nH,
+                                       double& dfSum, double& dfCount,
+                                       bool bNoData)
+        {
+            dfSum = 0;
+            dfCount = 0;
+            for( int iY = nYOff; iY < nYOff + nH; iY++ )
+            {
+                for( int iX = nXOff; iX < nXOff + nW; iX++ )
+                {
+                    const float fVal = afData[iY * nXSize + iX];
+                    if( bNoData && fVal == 0 )
+                        continue;
+                    dfSum += fVal;
+                    dfCount += 1;
+                }
+            }
+        };
+
+        for( const bool bNoData : { false, true } )
+        {
+            if( bNoData )
+                poBand->SetNoDataValue(0);
+            GDALSummedAreaTable* psSAT = GDALCreateSummedAreaTable(
+                GDALRasterBand::ToHandle(poBand), nullptr, nullptr, nullptr);
+            ensure( psSAT != nullptr );
+
+            const int anWindows[][4] = {
+                { 0, 0, nXSize, nYSize }, { 0, 0, 1, 1 }, { 3, 5, 10, 7 },
+                { nXSize - 1, nYSize - 1, 1, 1 }, { 20, 0, 17, 23 } };
+            for( const auto& anWindow : anWindows )
+            {
+                double dfSum = 0;
+                double dfCount = 0;
+                GDALSummedAreaTableGetSum(psSAT, anWindow[0], anWindow[1],
+                                          anWindow[2], anWindow[3],
+                                          &dfSum, &dfCount);
+                double dfExpectedSum = 0;
+                double dfExpectedCount = 0;
+                BruteForceSum(anWindow[0], anWindow[1], anWindow[2],
+                              anWindow[3], dfExpectedSum, dfExpectedCount,
+                              bNoData);
+                ensure_equals( dfSum, dfExpectedSum );
+                ensure_equals( dfCount, dfExpectedCount );
+            }
+
+            // Pixels partially covered by the window are weighted.
+            double dfSum = 0;
+            double dfCount = 0;
+            ensure( GDALSummedAreaTableGetSum(psSAT, 2.5, 3, 1, 1,
+                                              &dfSum, &dfCount) );
+            double dfExpectedSum = 0;
+            double dfExpectedCount = 0;
+            BruteForceSum(2, 3, 2, 1, dfExpectedSum, dfExpectedCount,
+                          bNoData);
+            ensure( std::fabs(dfSum - 0.5 * dfExpectedSum) < 1e-10 );
+            ensure( std::fabs(dfCount - 0.5 * dfExpectedCount) < 1e-10 );
+
+            // Average downsampling by a factor of 3 of the top-left
+            // 36x21 pixels.
+            std::vector<double> adfAverage(12 * 7);
+            ensure_equals( GDALSummedAreaTableAverage(psSAT, 0, 0, 36, 21,
+                                                      adfAverage.data(),
+                                                      12, 7, -1), CE_None );
+            for( int iY = 0; iY < 7; iY++ )
+            {
+                for( int iX = 0; iX < 12; iX++ )
+                {
+                    BruteForceSum(iX * 3, iY * 3, 3, 3, dfExpectedSum,
+                                  dfExpectedCount, bNoData);
+                    const double dfExpected = dfExpectedCount > 0 ?
+                        dfExpectedSum / dfExpectedCount : -1;
+                    ensure( std::fabs(adfAverage[iY * 12 + iX] -
+                                      dfExpected) < 1e-10 );
+                }
+            }
+
+            GDALDestroySummedAreaTable(psSAT);
+        }
+    }
+
+    // Test GDALZonalStatistics()
+    template<> template<> void object::test<13>()
+    {
+        GDALDriver* poMEMDriver =
+            GetGDALDriverManager()->GetDriverByName("MEM");
+        GDALDriver* poMemoryDriver =
+            GetGDALDriverManager()->GetDriverByName("Memory");
+        if( poMEMDriver == nullptr || poMemoryDriver == nullptr )
+            return;
+        const int nXSize = 20;
+        const int nYSize = 15;
+        std::unique_ptr<GDALDataset> poDS(
+            poMEMDriver->Create("", nXSize, nYSize, 1, GDT_Float32, nullptr));
+        double adfGT[6] = { 100, 1, 0, 200, 0, -1 };
+        poDS->SetGeoTransform(adfGT);
+        std::vector<float> afData(nXSize * nYSize);
+        for( int i = 0; i < nXSize * nYSize; i++ )
+            afData[i] = static_cast<float>((i * 7) % 13);
+        GDALRasterBand* poBand = poDS->GetRasterBand(1);
+        ensure_equals( poBand->RasterIO(GF_Write, 0, 0, nXSize, nYSize,
+                                        afData.data(), nXSize, nYSize,
+                                        GDT_Float32, 0, 0, nullptr),
+                       CE_None );
+
+        std::unique_ptr<GDALDataset> poVecDS(
+            poMemoryDriver->Create("", 0, 0, 0, GDT_Unknown, nullptr));
+        OGRLayer* poZoneLayer =
+            poVecDS->CreateLayer("zones", nullptr, wkbPolygon, nullptr);
+        // Zones aligned on pixel boundaries: columns 2 to 5 and lines 5 to 9,
+        // then columns 10 to 19 and lines 0 to 14.
+        const char* const apszZones[] = {
+            "POLYGON((102 195,106 195,106 190,102 190,102 195))",
+            "POLYGON((110 200,120 200,120 185,110 185,110 200))" };
+        const int anZoneWindows[][4] = { { 2, 5, 4, 5 }, { 10, 0, 10, 15 } };
+        for( const char* pszWKT : apszZones )
+        {
+            OGRFeature oFeature(poZoneLayer->GetLayerDefn());
+            OGRGeometry* poGeom = nullptr;
+            OGRGeometryFactory::createFromWkt(pszWKT, nullptr, &poGeom);
+            oFeature.SetGeometryDirectly(poGeom);
+            ensure_equals( poZoneLayer->CreateFeature(&oFeature),
+                           OGRERR_NONE );
+        }
+
+        for( const char* pszCoverage : { "CENTER", "FRACTIONAL" } )
+        {
+            for( const char* pszNumThreads : { "1", "3" } )
+            {
+                OGRLayer* poOutLayer =
+                    poVecDS->CreateLayer(CPLSPrintf("out_%s_%s", pszCoverage,
+                                                    pszNumThreads),
+                                         nullptr, wkbNone, nullptr);
+                CPLStringList aosOptions;
+                aosOptions.SetNameValue("COVERAGE", pszCoverage);
+                aosOptions.SetNameValue("NUM_THREADS", pszNumThreads);
+                ensure_equals( GDALZonalStatistics(
+                    GDALRasterBand::ToHandle(poBand),
+                    OGRLayer::ToHandle(poZoneLayer),
+                    OGRLayer::ToHandle(poOutLayer),
+                    aosOptions.List(), nullptr, nullptr), CE_None );
+                ensure_equals( poOutLayer->GetFeatureCount(), 2 );
+
+                poOutLayer->ResetReading();
+                for( const auto& anWindow : anZoneWindows )
+                {
+                    std::unique_ptr<OGRFeature> poFeature(
+                        poOutLayer->GetNextFeature());
+                    ensure( poFeature != nullptr );
+                    double dfSum = 0;
+                    double dfMin = 1e10;
+                    double dfMax = -1e10;
+                    for( int iY = anWindow[1];
+                         iY < anWindow[1] + anWindow[3]; iY++ )
+                    {
+                        for( int iX = anWindow[0];
+                             iX < anWindow[0] + anWindow[2]; iX++ )
+                        {
+                            const double dfVal = afData[iY * nXSize + iX];
+                            dfSum += dfVal;
+                            dfMin = std::min(dfMin, dfVal);
+                            dfMax = std::max(dfMax, dfVal);
+                        }
+                    }
+                    const double dfCount = anWindow[2] * anWindow[3];
+                    ensure( std::fabs(poFeature->GetFieldAsDouble("count") -
+                                      dfCount) < 1e-8 );
+                    ensure( std::fabs(poFeature->GetFieldAsDouble("sum") -
+                                      dfSum) < 1e-8 );
+                    ensure( std::fabs(poFeature->GetFieldAsDouble("mean") -
+                                      dfSum / dfCount) < 1e-8 );
+                    ensure_equals( poFeature->GetFieldAsDouble("min"), dfMin );
+                    ensure_equals( poFeature->GetFieldAsDouble("max"), dfMax );
+                }
+            }
+        }
+    }
+
+    // Test GDALChecksumImage() and GDALHashImage() with several threads
+    template<> template<> void object::test<14>()
+    {
+        GDALDriver* poMEMDriver =
+            GetGDALDriverManager()->GetDriverByName("MEM");
+        if( poMEMDriver == nullptr )
+            return;
+        const int nXSize = 2500;
+        const int nYSize = 600;
+        std::unique_ptr<GDALDataset> poDS(
+            poMEMDriver->Create("", nXSize, nYSize, 1, GDT_Int16, nullptr));
+        std::vector<GInt16> anData(nXSize * nYSize);
+        for( int i = 0; i < nXSize * nYSize; i++ )
+            anData[i] = static_cast<GInt16>((i * 37) % 65521 - 32000);
+        GDALRasterBand* poBand = poDS->GetRasterBand(1);
+        ensure_equals( poBand->RasterIO(GF_Write, 0, 0, nXSize, nYSize,
+                                        anData.data(), nXSize, nYSize,
+                                        GDT_Int16, 0, 0, nullptr),
+                       CE_None );
+        GDALRasterBandH hBand = GDALRasterBand::ToHandle(poBand);
+
+        int nExpectedChecksum = 0;
+        {
+            const int anPrimes[11] =
+                { 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43 };
+            int iPrime = 0;
+            for( int i = 0; i < nXSize * nYSize; i++ )
+            {
+                nExpectedChecksum += anData[i] % anPrimes[iPrime++];
+                if( iPrime > 10 )
+                    iPrime = 0;
+                nExpectedChecksum &= 0xffff;
+            }
+        }
+
+        ensure_equals( GDALChecksumImage(hBand, 0, 0, nXSize, nYSize),
+                       nExpectedChecksum );
+        CPLSetConfigOption("GDAL_NUM_THREADS", "4");
+        ensure_equals( GDALChecksumImage(hBand, 0, 0, nXSize, nYSize),
+                       nExpectedChecksum );
+        CPLSetConfigOption("GDAL_NUM_THREADS", nullptr);
+
+        char* pszHash = GDALHashImage(hBand, 0, 0, nXSize, nYSize, nullptr);
+        ensure( pszHash != nullptr );
+        ensure_equals( strlen(pszHash), 64U );
+        const CPLString osHash(pszHash);
+        CPLFree(pszHash);
+
+        const char* const apszOptions[] = { "NUM_THREADS=4", nullptr };
+        pszHash = GDALHashImage(hBand, 0, 0, nXSize, nYSize, apszOptions);
+        ensure_equals( CPLString(pszHash), osHash );
+        CPLFree(pszHash);
+
+        // Any change of a value changes the hash.
+        GInt16 nVal = anData[nXSize * 300 + 1500] + 1;
+        ensure_equals( poBand->RasterIO(GF_Write, 1500, 300, 1, 1,
+                                        &nVal, 1, 1, GDT_Int16,
+                                        0, 0, nullptr),
+                       CE_None );
+        pszHash = GDALHashImage(hBand, 0, 0, nXSize, nYSize, apszOptions);
+        ensure( CPLString(pszHash) != osHash );
+        CPLFree(pszHash);
+    }
 
 } // namespace tut
@@ -37,6 +37,7 @@
 #include "cpl_string.h"
 #include "cpl_safemaths.hpp"
 #include "cpl_time.h"
+#include "cpl_trace.h"
 #include "cpl_json.h"
 #include "cpl_json_streaming_parser.h"
 #include "cpl_json_streaming_writer.h"
@@ -44,10 +45,17 @@
 #include "cpl_http.h"
 #include "cpl_auto_close.h"
 #include "cpl_minixml.h"
+#include "cpl_open_hash_map.h"
+#include "cpl_packed_rtree.h"
 #include "cpl_worker_thread_pool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <vector>
 
 static bool gbGotError = false;
 static void CPL_STDCALL myErrorHandler(CPLErr, CPLErrorNum, const char*)
@@ -71,7 +79,7 @@ namespace tut
     };
 
     // Register test group
-    typedef test_group<test_cpl_data> group;
+    typedef test_group<test_cpl_data, 100> group;
     typedef group::object object;
     group test_cpl_group("CPL");
 
@@ -3090,4 +3098,601 @@ namespace tut
         VSIUnlink("/vsimem/.gdal/gdalrc");
     }
 
+    // Test VSIFReadAsyncL() and VSIFWaitAsyncL()
+    template<>
+    template<>
+    void object::test<45>()
+    {
+        VSILFILE* fp = VSIFOpenL("/vsimem/test_read_async.bin", "wb");
+        ensure( fp != nullptr );
+        for( int i = 0; i < 1000; ++i )
+        {
+            const GByte ch = static_cast<GByte>(i % 256);
+            ensure_equals( VSIFWriteL(&ch, 1, 1, fp), 1U );
+        }
+        VSIFCloseL(fp);
+
+        fp = VSIFOpenL("/vsimem/test_read_async.bin", "rb");
+        ensure( fp != nullptr );
+
+        struct Result
+        {
+            std::mutex oMutex{};
+            int nCalls = 0;
+            int nRet = 0;
+        };
+        const auto Callback = [](int nRet, void* pUserData)
+        {
+            Result* psResult = static_cast<Result*>(pUserData);
+            std::lock_guard<std::mutex> oLock(psResult->oMutex);
+            psResult->nCalls++;
+            if( nRet != 0 )
+                psResult->nRet = nRet;
+        };
+
+        Result sResult;
+        GByte abyBuf1[10] = {};
+        GByte abyBuf2[20] = {};
+        void* apData[] = { abyBuf1, abyBuf2 };
+        const vsi_l_offset anOffsets[] = { 5, 512 };
+        const size_t anSizes[] = { sizeof(abyBuf1), sizeof(abyBuf2) };
+        ensure_equals( VSIFReadAsyncL(2, apData, anOffsets, anSizes,
+                                      Callback, &sResult, fp), 0 );
+        GByte abyBuf3[1] = {};
+        void* apData3[] = { abyBuf3 };
+        const vsi_l_offset anOffsets3[] = { 999 };
+        const size_t anSizes3[] = { sizeof(abyBuf3) };
+        ensure_equals( VSIFReadAsyncL(1, apData3, anOffsets3, anSizes3,
+                                      Callback, &sResult, fp), 0 );
+        VSIFWaitAsyncL(fp);
+        ensure_equals( sResult.nCalls, 2 );
+        ensure_equals( sResult.nRet, 0 );
+        ensure_equals( abyBuf1[0], 5 );
+        ensure_equals( abyBuf1[9], 14 );
+        ensure_equals( abyBuf2[0], 0 );
+        ensure_equals( abyBuf2[19], 19 );
+        ensure_equals( abyBuf3[0], 999 % 256 );
+
+        // Read beyond end of file
+        Result sResult2;
+        const vsi_l_offset anOffsets4[] = { 995 };
+        const size_t anSizes4[] = { sizeof(abyBuf1) };
+        ensure_equals( VSIFReadAsyncL(1, apData, anOffsets4, anSizes4,
+                                      Callback, &sResult2, fp), 0 );
+        // VSIFCloseL() waits for pending reads
+        VSIFCloseL(fp);
+        ensure_equals( sResult2.nCalls, 1 );
+        ensure_equals( sResult2.nRet, -1 );
+
+        VSIUnlink("/vsimem/test_read_async.bin");
+    }
+
+    // Test concurrent CPLGetConfigOption() and CPLSetConfigOption()
+    template<>
+    template<>
+    void object::test<46>()
+    {
+        CPLSetConfigOption("CPL_TEST_CONFIG_A", "A");
+        CPLWorkerThreadPool oPool;
+        ensure(oPool.Setup(4, nullptr, nullptr));
+
+        struct ReaderData
+        {
+            bool bOK = true;
+        };
+        const auto reader = [](void* pData)
+        {
+            auto psData = static_cast<ReaderData*>(pData);
+            for( int i = 0; i < 100000; i++ )
+            {
+                if( strcmp(CPLGetConfigOption("CPL_TEST_CONFIG_A", ""), "A") != 0 )
+                    psData->bOK = false;
+                // The value of CPL_TEST_CONFIG_B is freed when it is set
+                // again, so get a copy of the list.
+                char** papszOptions = CPLGetConfigOptions();
+                const char* pszB =
+                    CSLFetchNameValueDef(papszOptions, "CPL_TEST_CONFIG_B", "");
+                if( !EQUAL(pszB, "") && !EQUAL(pszB, "B1") && !EQUAL(pszB, "B2") )
+                    psData->bOK = false;
+                CSLDestroy(papszOptions);
+            }
+        };
+        std::vector<ReaderData> asData(4);
+        for( auto& sData: asData )
+            oPool.SubmitJob(reader, &sData);
+        for( int i = 0; i < 1000; i++ )
+        {
+            CPLSetConfigOption("CPL_TEST_CONFIG_B", (i % 3) == 0 ? nullptr :
+                                                    (i % 3) == 1 ? "B1" : "B2");
+        }
+        oPool.WaitCompletion();
+        for( const auto& sData: asData )
+            ensure(sData.bOK);
+
+        // Thread-local options still override global ones
+        CPLSetThreadLocalConfigOption("CPL_TEST_CONFIG_A", "TL");
+        ensure_equals(CPLGetConfigOption("CPL_TEST_CONFIG_A", ""), "TL");
+        CPLSetThreadLocalConfigOption("CPL_TEST_CONFIG_A", nullptr);
+        ensure_equals(CPLGetConfigOption("CPL_TEST_CONFIG_A", ""), "A");
+
+        CPLSetConfigOption("CPL_TEST_CONFIG_A", nullptr);
+        CPLSetConfigOption("CPL_TEST_CONFIG_B", nullptr);
+        ensure_equals(CPLGetConfigOption("CPL_TEST_CONFIG_A", "unset"), "unset");
+    }
+
+    // Test nested job queues waited from worker threads of the same pool
+    template<>
+    template<>
+    void object::test<47>()
+    {
+        // A pool with 2 threads would deadlock if waiting on nested jobs
+        // blocked worker threads.
+        CPLWorkerThreadPool oPool;
+        ensure(oPool.Setup(2, nullptr, nullptr));
+
+        struct OuterData
+        {
+            CPLWorkerThreadPool* poPool = nullptr;
+            std::atomic<int>* pnCounter = nullptr;
+            CPLThreadFunc pfnInner = nullptr;
+        };
+        const auto inner = [](void* pData)
+        {
+            (*static_cast<std::atomic<int>*>(pData)) ++;
+        };
+        const auto outer = [](void* pData)
+        {
+            OuterData* psData = static_cast<OuterData*>(pData);
+            auto poQueue = psData->poPool->CreateJobQueue();
+            for( int i = 0; i < 10; i++ )
+                poQueue->SubmitJob(psData->pfnInner, psData->pnCounter);
+            poQueue->WaitCompletion();
+        };
+
+        std::atomic<int> nCounter(0);
+        std::vector<OuterData> asData(8);
+        auto poQueue = oPool.CreateJobQueue();
+        for( auto& sData: asData )
+        {
+            sData.poPool = &oPool;
+            sData.pnCounter = &nCounter;
+            sData.pfnInner = inner;
+            poQueue->SubmitJob(outer, &sData);
+        }
+        poQueue->WaitCompletion();
+        ensure_equals(nCounter.load(), 80);
+
+        // Jobs submitted directly to the pool are also run
+        for( int i = 0; i < 10; i++ )
+            oPool.SubmitJob(inner, &nCounter);
+        oPool.WaitCompletion();
+        ensure_equals(nCounter.load(), 90);
+    }
+
+    // Test CPLParseXMLStringArena()
+    template<>
+    template<>
+    void object::test<48>()
+    {
+        const char* const apszDocs[] = {
+            "<?xml version=\"1.0\"?><VRTDataset rasterXSize=\"10\" a='x&amp;y'>"
+            "\n<!-- comment --><B>te&lt;xt</B><![CDATA[<raw>]]><C/>"
+            "</VRTDataset>",
+            "<?valbuddy_schematron ../foo.sch?><a>b</a>",
+            "no structure",
+        };
+        for( const char* pszDoc: apszDocs )
+        {
+            CPLXMLTreeCloser oTree(CPLParseXMLString(pszDoc));
+            CPLXMLArenaTreeCloser oArenaTree(CPLParseXMLStringArena(pszDoc));
+            ensure(oTree.get() != nullptr);
+            ensure(oArenaTree.get() != nullptr);
+            char* pszExpected = CPLSerializeXMLTree(oTree.get());
+            char* pszGot = CPLSerializeXMLTree(oArenaTree.get());
+            ensure_equals(std::string(pszGot), std::string(pszExpected));
+            CPLFree(pszExpected);
+            CPLFree(pszGot);
+        }
+
+        // Document larger than the first arena block
+        std::string osDoc("<root>");
+        for( int i = 0; i < 10000; i++ )
+            osDoc += "<item id=\"" + std::to_string(i) + "\">" +
+                     std::to_string(i) + "</item>";
+        osDoc += "</root>";
+        {
+            CPLXMLArenaTreeCloser oArenaTree(
+                CPLParseXMLStringArena(osDoc.c_str()));
+            ensure(oArenaTree.get() != nullptr);
+            int nCount = 0;
+            for( const CPLXMLNode* psIter = oArenaTree->psChild;
+                 psIter; psIter = psIter->psNext )
+            {
+                ensure_equals(atoi(CPLGetXMLValue(psIter, "id", "")), nCount);
+                ensure_equals(atoi(CPLGetXMLValue(psIter, nullptr, "")), nCount);
+                nCount++;
+            }
+            ensure_equals(nCount, 10000);
+        }
+
+        // Errors
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure(CPLParseXMLStringArena("<a><b></a>") == nullptr);
+        CPLPopErrorHandler();
+        ensure(CPLParseXMLStringArena("") == nullptr);
+    }
+
+    // Test CPLFormatDoubleShortest()
+    template<>
+    template<>
+    void object::test<49>()
+    {
+        const struct
+        {
+            double dfVal;
+            const char* pszExpected;
+        } asTests[] = {
+            { 0.0, "0" },
+            { 1.0, "1" },
+            { -2.5, "-2.5" },
+            { 0.1, "0.1" },
+            { 0.1 + 0.2, "0.30000000000000004" },
+            { -45.123, "-45.123" },
+            { 0.000123, "0.000123" },
+            { 1.0 / 3, "0.3333333333333333" },
+            { 1.5e-6, "1.5e-06" },
+            { 1e20, "1e+20" },
+            { 1234567890123.25, "1234567890123.25" },
+        };
+        for( const auto& sTest: asTests )
+        {
+            char szBuffer[32];
+            const int nLen = CPLFormatDoubleShortest(szBuffer, sizeof(szBuffer),
+                                                     sTest.dfVal);
+            ensure_equals(std::string(szBuffer), sTest.pszExpected);
+            ensure_equals(nLen, static_cast<int>(strlen(sTest.pszExpected)));
+            ensure_equals(CPLAtof(szBuffer), sTest.dfVal);
+        }
+
+        // Round-trip of arbitrary values
+        double dfVal = 1.0;
+        for( int i = 0; i < 10000; i++ )
+        {
+            dfVal = dfVal * 1.0001 + 0.123456789;
+            char szBuffer[32];
+            ensure(CPLFormatDoubleShortest(szBuffer, sizeof(szBuffer),
+                                           dfVal) > 0);
+            ensure_equals(CPLAtof(szBuffer), dfVal);
+        }
+
+        char szSmall[4];
+        ensure_equals(CPLFormatDoubleShortest(szSmall, sizeof(szSmall),
+                                              1.25), 0);
+    }
+
+    // Test CPLOpenHashMap
+    template<>
+    template<>
+    void object::test<50>()
+    {
+        CPLOpenHashMap<int, int> oMap;
+        ensure(oMap.Empty());
+        ensure(oMap.Find(1) == nullptr);
+        ensure(!oMap.Erase(1));
+
+        const int N = 10000;
+        for( int i = 0; i < N; i++ )
+        {
+            auto oRet = oMap.Insert(i, 2 * i);
+            ensure(oRet.second);
+            ensure_equals(*oRet.first, 2 * i);
+        }
+        ensure_equals(oMap.Size(), static_cast<size_t>(N));
+        ensure(!oMap.Insert(5, 0).second);
+        ensure_equals(*oMap.Find(5), 10);
+
+        // Remove odd keys and check that even ones are still reachable
+        // after backward shifting
+        for( int i = 1; i < N; i += 2 )
+            ensure(oMap.Erase(i));
+        ensure(!oMap.Erase(1));
+        ensure_equals(oMap.Size(), static_cast<size_t>(N / 2));
+        oMap.ShrinkToFit();
+        for( int i = 0; i < N; i++ )
+        {
+            const int* pnVal = oMap.Find(i);
+            if( (i % 2) == 0 )
+            {
+                ensure(pnVal != nullptr);
+                ensure_equals(*pnVal, 2 * i);
+            }
+            else
+            {
+                ensure(pnVal == nullptr);
+            }
+        }
+
+        int nSum = 0;
+        int nCount = 0;
+        ensure(oMap.ForEach([&nSum, &nCount](const int&, int& nVal)
+                            { nSum += nVal; nCount ++; return true; }));
+        ensure_equals(nCount, N / 2);
+        ensure_equals(nSum, N * (N / 2 - 1));
+        ensure(!oMap.ForEach([](const int&, int&) { return false; }));
+
+        oMap.Clear();
+        ensure(oMap.Empty());
+        ensure(oMap.Find(0) == nullptr);
+
+        // Degenerate hash function: everything collides
+        struct ConstantHash
+        {
+            size_t operator()(int) const { return 0; }
+        };
+        CPLOpenHashMap<int, int, ConstantHash> oMapCollision;
+        for( int i = 0; i < 100; i++ )
+            oMapCollision.Insert(i, i);
+        for( int i = 0; i < 100; i += 3 )
+            ensure(oMapCollision.Erase(i));
+        for( int i = 0; i < 100; i++ )
+            ensure_equals(oMapCollision.Find(i) != nullptr, (i % 3) != 0);
+
+        // Check CPLHashSet replacement and deferred rehash semantics
+        CPLHashSet* set = CPLHashSetNew(CPLHashSetHashStr,
+                                        CPLHashSetEqualStr, CPLFree);
+        for( int i = 0; i < 1000; i++ )
+            ensure(CPLHashSetInsert(set, CPLStrdup(CPLSPrintf("%d", i))));
+        char* pszReplacement = CPLStrdup("500");
+        ensure(!CPLHashSetInsert(set, pszReplacement));
+        ensure(CPLHashSetLookup(set, "500") == pszReplacement);
+        for( int i = 0; i < 1000; i += 2 )
+            ensure(CPLHashSetRemoveDeferRehash(set, CPLSPrintf("%d", i)));
+        ensure_equals(CPLHashSetSize(set), 500);
+        for( int i = 1; i < 1000; i += 2 )
+            ensure(CPLHashSetLookup(set, CPLSPrintf("%d", i)) != nullptr);
+        CPLHashSetClear(set);
+        ensure_equals(CPLHashSetSize(set), 0);
+        ensure(CPLHashSetInsert(set, CPLStrdup("foo")));
+        CPLHashSetDestroy(set);
+    }
+
+    // Test CPLPackedRTree
+    template<>
+    template<>
+    void object::test<51>()
+    {
+        {
+            CPLPackedRTree oEmpty(nullptr, 0);
+            std::vector<size_t> anItems{ 1 };
+            const CPLRectObj sAoi = { -1, -1, 1, 1 };
+            oEmpty.Search(sAoi, anItems);
+            ensure(anItems.empty());
+        }
+
+        // Grid of 100x100 unit squares, with 3 children per node to get a
+        // deep tree.
+        std::vector<CPLRectObj> asBounds;
+        for( int j = 0; j < 100; j++ )
+        {
+            for( int i = 0; i < 100; i++ )
+            {
+                const CPLRectObj sRect = { i + 0.25, j + 0.25,
+                                           i + 0.75, j + 0.75 };
+                asBounds.push_back(sRect);
+            }
+        }
+        CPLPackedRTree oTree(asBounds.data(), asBounds.size(), 3);
+        ensure_equals(oTree.GetItemCount(), asBounds.size());
+
+        std::vector<size_t> anItems;
+        const CPLRectObj sAoi = { 10, 20, 12.5, 20.5 };
+        oTree.Search(sAoi, anItems);
+        std::sort(anItems.begin(), anItems.end());
+        ensure_equals(anItems.size(), static_cast<size_t>(3));
+        ensure_equals(anItems[0], static_cast<size_t>(20 * 100 + 10));
+        ensure_equals(anItems[1], static_cast<size_t>(20 * 100 + 11));
+        ensure_equals(anItems[2], static_cast<size_t>(20 * 100 + 12));
+
+        const CPLRectObj sAoiNothing = { 10.8, 20.8, 11.2, 21.2 };
+        oTree.Search(sAoiNothing, anItems);
+        ensure(anItems.empty());
+
+        const CPLRectObj sAoiAll = { -1, -1, 101, 101 };
+        oTree.Search(sAoiAll, anItems);
+        ensure_equals(anItems.size(), asBounds.size());
+    }
+
+    // Test CPLStrtod() fast path and CPLFormatDoubleShortestFixed()
+    template<>
+    template<>
+    void object::test<52>()
+    {
+        const struct
+        {
+            const char* pszStr;
+            double      dfVal;
+            int         nConsumed;
+        } asTests[] = {
+            { "0", 0.0, 1 },
+            { "1.5", 1.5, 3 },
+            { "-2.25e2", -225.0, 7 },
+            { "1.5e", 1.5, 3 },
+            { "1.5e+", 1.5, 3 },
+            { "0.1", 0.1, 3 },
+            { ".5", 0.5, 2 },
+            { "1e22", 1e22, 4 },
+            { "1e23", 1e23, 4 },
+            { "123e25", 1.23e27, 6 },
+            { "9007199254740993", 9007199254740992.0, 16 },
+            { "3.14159265358979323846", 3.14159265358979323846, 22 },
+            { "4.9e-324", 4.9e-324, 8 },
+            { "0x10", 16.0, 4 },
+            { "12,5", 12.0, 2 },
+            { "1.25 2", 1.25, 4 },
+        };
+        for( const auto& sTest: asTests )
+        {
+            char* pszEnd = nullptr;
+            const double dfVal = CPLStrtod(sTest.pszStr, &pszEnd);
+            ensure_equals(sTest.pszStr, dfVal, sTest.dfVal);
+            ensure_equals(sTest.pszStr,
+                          static_cast<int>(pszEnd - sTest.pszStr),
+                          sTest.nConsumed);
+        }
+
+        // Negative zero
+        const double dfNegZero = CPLAtof("-0.0");
+        ensure_equals(dfNegZero, 0.0);
+        ensure(std::signbit(dfNegZero));
+
+        ensure_equals(CPLAtofDelim("12,5", ','), 12.5);
+
+        char szBuffer[32];
+        ensure_equals(CPLFormatDoubleShortestFixed(szBuffer, sizeof(szBuffer),
+                                                   -12.375, 3), 7);
+        ensure_equals(std::string(szBuffer), std::string("-12.375"));
+        ensure_equals(CPLFormatDoubleShortestFixed(szBuffer, sizeof(szBuffer),
+                                                   -12.375, 2), 0);
+        ensure_equals(CPLFormatDoubleShortestFixed(szBuffer, sizeof(szBuffer),
+                                                   1e-7, 17), 0);
+    }
+
+    // Test CPLTraceSpan
+    template<>
+    template<>
+    void object::test<53>()
+    {
+        const char* pszFilename = "/vsimem/test_cpl_trace.json";
+        ensure(CPLTraceStart(pszFilename, "CHROME"));
+        ensure(CPLTraceIsEnabled());
+        {
+            CPLTraceSpan oOuter("test", "outer");
+            ensure(oOuter.IsActive());
+            oOuter.AddArg("str", "value");
+            oOuter.AddArg("int", static_cast<GIntBig>(123));
+            CPL_TRACE_SPAN("test", "inner");
+        }
+        ensure(CPLTraceStop());
+        ensure(!CPLTraceIsEnabled());
+        {
+            CPLTraceSpan oSpan("test", "not_recorded");
+            ensure(!oSpan.IsActive());
+        }
+
+        CPLJSONDocument oDoc;
+        ensure(oDoc.Load(pszFilename));
+        auto oEvents = oDoc.GetRoot().GetArray("traceEvents");
+        ensure_equals(oEvents.Size(), 2);
+        ensure_equals(oEvents[0].GetString("name"), std::string("outer"));
+        ensure_equals(oEvents[0].GetString("cat"), std::string("test"));
+        ensure_equals(oEvents[0].GetString("args/str"), std::string("value"));
+        ensure_equals(oEvents[0].GetLong("args/int"), 123);
+        ensure_equals(oEvents[1].GetString("name"), std::string("inner"));
+        ensure(oEvents[1].GetDouble("ts") >= oEvents[0].GetDouble("ts"));
+        ensure(oEvents[1].GetDouble("dur") <= oEvents[0].GetDouble("dur"));
+
+        ensure(CPLTraceStart(pszFilename, "OTLP"));
+        {
+            CPL_TRACE_SPAN("test", "outer");
+            CPL_TRACE_SPAN("test", "inner");
+        }
+        ensure(CPLTraceStop());
+        ensure(oDoc.Load(pszFilename));
+        auto oSpans = oDoc.GetRoot().GetArray(
+            "resourceSpans")[0].GetArray("scopeSpans")[0].GetArray("spans");
+        ensure_equals(oSpans.Size(), 2);
+        ensure_equals(oSpans[1].GetString("parentSpanId"),
+                      oSpans[0].GetString("spanId"));
+        ensure_equals(oSpans[0].GetString("traceId"),
+                      oSpans[1].GetString("traceId"));
+        VSIUnlink(pszFilename);
+    }
+
+    // Test VSIIOTraceStart() / VSIIOTraceReplay()
+    template<>
+    template<>
+    void object::test<54>()
+    {
+        const char* pszTraceFilename = "/vsimem/test_vsi_io_trace.txt";
+        const char* pszSrcFilename = "/vsimem/test_vsi_io_trace/src/a.bin";
+        const char* pszDstFilename = "/vsimem/test_vsi_io_trace/dst/a.bin";
+        std::vector<GByte> abyData(10000);
+        for( size_t i = 0; i < abyData.size(); ++i )
+            abyData[i] = static_cast<GByte>(i);
+        VSIFCloseL(VSIFileFromMemBuffer(pszSrcFilename, abyData.data(),
+                                        abyData.size(), FALSE));
+
+        CPLStringList aosOptions;
+        aosOptions.SetNameValue("PREFIX", "/vsimem/test_vsi_io_trace/");
+        ensure(VSIIOTraceStart(pszTraceFilename, aosOptions.List()));
+        VSILFILE* fp = VSIFOpenL(pszSrcFilename, "rb");
+        ensure(fp != nullptr);
+        GByte abyBuffer[300];
+        ensure_equals(VSIFSeekL(fp, 100, SEEK_SET), 0);
+        ensure_equals(VSIFReadL(abyBuffer, 1, 10, fp), 10U);
+        ensure_equals(abyBuffer[0], 100);
+        ensure_equals(VSIFSeekL(fp, 9995, SEEK_SET), 0);
+        ensure_equals(VSIFReadL(abyBuffer, 1, 10, fp), 5U);
+        void* apData[2] = { abyBuffer, abyBuffer + 100 };
+        const vsi_l_offset anOffsets[2] = { 0, 5000 };
+        const size_t anSizes[2] = { 100, 200 };
+        ensure_equals(VSIFReadMultiRangeL(2, apData, anOffsets, anSizes, fp),
+                      0);
+        VSIFCloseL(fp);
+        VSIStatBufL sStat;
+        ensure_equals(VSIStatL(pszSrcFilename, &sStat), 0);
+        // Not recorded because of PREFIX
+        CPL_IGNORE_RET_VAL(VSIStatL("/vsimem/other", &sStat));
+        ensure(VSIIOTraceStop());
+
+        // Not recorded after stop
+        fp = VSIFOpenL(pszSrcFilename, "rb");
+        ensure(fp != nullptr);
+        VSIFCloseL(fp);
+
+        // Replay against a copy
+        VSIFCloseL(VSIFileFromMemBuffer(pszDstFilename, abyData.data(),
+                                        abyData.size(), FALSE));
+        CPLStringList aosReplayOptions;
+        aosReplayOptions.SetNameValue("SOURCE_PREFIX",
+                                      "/vsimem/test_vsi_io_trace/src/");
+        aosReplayOptions.SetNameValue("TARGET_PREFIX",
+                                      "/vsimem/test_vsi_io_trace/dst/");
+        CPLStringList aosStats(VSIIOTraceReplay(pszTraceFilename,
+                                                aosReplayOptions.List()));
+        ensure(!aosStats.empty());
+        ensure_equals(CPLString(aosStats.FetchNameValueDef("OPEN_COUNT", "")),
+                      "1");
+        ensure_equals(CPLString(aosStats.FetchNameValueDef("READ_COUNT", "")),
+                      "2");
+        ensure_equals(
+            CPLString(aosStats.FetchNameValueDef("MULTIRANGE_COUNT", "")),
+            "1");
+        ensure_equals(CPLString(aosStats.FetchNameValueDef("STAT_COUNT", "")),
+                      "1");
+        ensure_equals(CPLString(aosStats.FetchNameValueDef("CLOSE_COUNT", "")),
+                      "1");
+        ensure_equals(CPLString(aosStats.FetchNameValueDef("READ_BYTES", "")),
+                      "315");
+        ensure_equals(
+            CPLString(aosStats.FetchNameValueDef("MISMATCH_COUNT", "")), "0");
+
+        // Replay against a truncated copy
+        VSIFCloseL(VSIFileFromMemBuffer(pszDstFilename, abyData.data(),
+                                        1000, FALSE));
+        aosStats.Assign(VSIIOTraceReplay(pszTraceFilename,
+                                         aosReplayOptions.List()));
+        ensure_equals(
+            CPLString(aosStats.FetchNameValueDef("MISMATCH_COUNT", "")), "2");
+
+        VSIUnlink(pszSrcFilename);
+        VSIUnlink(pszDstFilename);
+
+        // Not a trace
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure(VSIIOTraceReplay(pszSrcFilename, nullptr) == nullptr);
+        CPLPopErrorHandler();
+        VSIUnlink(pszTraceFilename);
+    }
+
 } // namespace tut
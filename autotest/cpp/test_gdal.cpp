@@ -25,6 +25,8 @@
 
 #include "gdal_unit_test.h"
 
+#include "gdal_alg.h"
+#include "gdal_perf_counters.h"
 #include "gdal_priv.h"
 #include "gdal_utils.h"
 #include "gdal_priv_templates.hpp"
@@ -33,6 +35,7 @@
 
 #include <limits>
 #include <string>
+#include <vector>
 
 #include "test_data.h"
 
@@ -1424,6 +1427,19 @@ namespace tut
             ensure( !poTMS->hasVariableMatrixWidth() );
         }
 
+        // Zoom level selection
+        {
+            const std::vector<double> adfRes{ 8, 4, 2, 1 };
+            ensure_equals( gdal::TileMatrixSet::selectZoomLevel(adfRes, 4, nullptr), 1 );
+            ensure_equals( gdal::TileMatrixSet::selectZoomLevel(adfRes, 2.5, "AUTO"), 2 );
+            ensure_equals( gdal::TileMatrixSet::selectZoomLevel(adfRes, 3.5, "AUTO"), 1 );
+            ensure_equals( gdal::TileMatrixSet::selectZoomLevel(adfRes, 2.5, "LOWER"), 1 );
+            ensure_equals( gdal::TileMatrixSet::selectZoomLevel(adfRes, 2.5, "UPPER"), 2 );
+            ensure_equals( gdal::TileMatrixSet::selectZoomLevel(adfRes, 1 + 1e-10, "UPPER"), 3 );
+            ensure_equals( gdal::TileMatrixSet::selectZoomLevel(adfRes, 100, "LOWER"), 0 );
+            ensure_equals( gdal::TileMatrixSet::selectZoomLevel(adfRes, 0.5, "AUTO"), -1 );
+        }
+
         // Invalid scaleDenominator
         {
             CPLPushErrorHandler(CPLQuietErrorHandler);
@@ -1754,4 +1770,526 @@ namespace tut
         ensure( GDALBufferHasOnlyNoData(&float64nan, float64nan, 1, 1, 1, 1, 64, GSF_FLOATING_POINT) );
         ensure( !GDALBufferHasOnlyNoData(&float64nan, 0.0, 1, 1, 1, 1, 64, GSF_FLOATING_POINT) );
     }
+
+    // Test block cache partitions
+    template<> template<> void object::test<23>()
+    {
+        const char* pszFilename = "/vsimem/test_cache_partition.tif";
+        {
+            auto poDrv = GDALDriver::FromHandle(GDALGetDriverByName("GTiff"));
+            const char* const apszOptions[] = { "TILED=YES",
+                                                "BLOCKXSIZE=64",
+                                                "BLOCKYSIZE=64", nullptr };
+            GDALDatasetUniquePtr poDS(poDrv->Create(
+                pszFilename, 256, 256, 1, GDT_Byte,
+                const_cast<char**>(apszOptions)));
+            ensure( poDS != nullptr );
+            poDS->GetRasterBand(1)->Fill(1);
+        }
+
+        ensure( GDALGetCachePartitionMax("test_partition") < 0 );
+        ensure( GDALSetCachePartitionMax("test_partition", 32 * 1024) );
+        ensure_equals( GDALGetCachePartitionMax("test_partition"), 32 * 1024 );
+
+        const char* const apszOpenOptions[] = {
+            "CACHE_PARTITION=test_partition", nullptr };
+        GDALDatasetUniquePtr poDS(GDALDataset::Open(
+            pszFilename, GDAL_OF_RASTER, nullptr, apszOpenOptions));
+        ensure( poDS != nullptr );
+        ensure( poDS->GetCachePartition() != nullptr );
+        ensure_equals( std::string(poDS->GetCachePartition()),
+                       std::string("test_partition") );
+
+        const GIntBig nCacheUsedBefore = GDALGetCacheUsed64();
+        std::vector<GByte> abyBuffer(256 * 256);
+        ensure_equals( poDS->GetRasterBand(1)->RasterIO(GF_Read,
+                            0, 0, 256, 256, &abyBuffer[0], 256, 256, GDT_Byte,
+                            0, 0, nullptr), CE_None );
+        ensure_equals( abyBuffer[0], 1 );
+        ensure_equals( abyBuffer[256 * 256 - 1], 1 );
+        // Blocks of the partition are not accounted in the default pool
+        ensure_equals( GDALGetCacheUsed64(), nCacheUsedBefore );
+
+        GIntBig nUsed = 0;
+        GIntBig nHits = 0;
+        GIntBig nMisses = 0;
+        GIntBig nEvictions = 0;
+        ensure( GDALGetCachePartitionStatistics("test_partition", &nUsed,
+                                                &nHits, &nMisses,
+                                                &nEvictions) );
+        ensure_equals( nMisses, 16 );
+        ensure( nEvictions > 0 );
+        ensure( nUsed > 0 );
+        ensure( nUsed <= 32 * 1024 );
+
+        // Read again the last block, which must be cached.
+        ensure_equals( poDS->GetRasterBand(1)->RasterIO(GF_Read,
+                            192, 192, 64, 64, &abyBuffer[0], 64, 64, GDT_Byte,
+                            0, 0, nullptr), CE_None );
+        GIntBig nHitsAfter = 0;
+        ensure( GDALGetCachePartitionStatistics("test_partition", nullptr,
+                                                &nHitsAfter, &nMisses,
+                                                nullptr) );
+        ensure( nHitsAfter > nHits );
+        ensure_equals( nMisses, 16 );
+
+        ensure( !GDALGetCachePartitionStatistics("non_existing", nullptr,
+                                                 nullptr, nullptr, nullptr) );
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure_equals( poDS->SetCachePartition("non_existing"), CE_Failure );
+        CPLPopErrorHandler();
+
+        // Back to the default pool
+        ensure_equals( poDS->SetCachePartition(nullptr), CE_None );
+        ensure( poDS->GetCachePartition() == nullptr );
+        ensure( GDALGetCachePartitionStatistics("test_partition", &nUsed,
+                                                nullptr, nullptr, nullptr) );
+        ensure_equals( nUsed, 0 );
+
+        poDS.reset();
+        VSIUnlink(pszFilename);
+    }
+
+    // Test block cache statistics
+    template<> template<> void object::test<24>()
+    {
+        const char* pszFilename = "/vsimem/test_cache_statistics.tif";
+        auto poDrv = GDALDriver::FromHandle(GDALGetDriverByName("GTiff"));
+        const char* const apszOptions[] = { "TILED=YES",
+                                            "BLOCKXSIZE=64",
+                                            "BLOCKYSIZE=64", nullptr };
+        GDALDatasetUniquePtr poDS(poDrv->Create(
+            pszFilename, 128, 128, 1, GDT_Byte,
+            const_cast<char**>(apszOptions)));
+        ensure( poDS != nullptr );
+        auto poBand = poDS->GetRasterBand(1);
+
+        GDALCacheStatistics sGlobalBefore;
+        GDALGetCacheStatistics(&sGlobalBefore);
+
+        GDALCacheStatistics sStats;
+        poBand->GetCacheStatistics(&sStats);
+        ensure_equals( sStats.nHits, 0 );
+        ensure_equals( sStats.nMisses, 0 );
+
+        std::vector<GByte> abyBuffer(128 * 128, 1);
+        ensure_equals( poBand->RasterIO(GF_Write, 0, 0, 128, 128,
+                                         &abyBuffer[0], 128, 128, GDT_Byte,
+                                         0, 0, nullptr), CE_None );
+        poBand->GetCacheStatistics(&sStats);
+        ensure_equals( sStats.nMisses, 4 );
+        ensure( sStats.nBytesResident >= 4 * 64 * 64 );
+
+        ensure_equals( poBand->RasterIO(GF_Read, 0, 0, 128, 128,
+                                         &abyBuffer[0], 128, 128, GDT_Byte,
+                                         0, 0, nullptr), CE_None );
+        poBand->GetCacheStatistics(&sStats);
+        ensure_equals( sStats.nHits, 4 );
+        ensure_equals( sStats.nMisses, 4 );
+
+        poDS->FlushCache();
+        poBand->GetCacheStatistics(&sStats);
+        ensure_equals( sStats.nDirtyFlushes, 4 );
+        ensure_equals( sStats.nBytesResident, 0 );
+
+        GDALCacheStatistics sGlobalAfter;
+        GDALGetCacheStatistics(&sGlobalAfter);
+        ensure( sGlobalAfter.nHits >= sGlobalBefore.nHits + 4 );
+        ensure( sGlobalAfter.nMisses >= sGlobalBefore.nMisses + 4 );
+        ensure( sGlobalAfter.nDirtyFlushes >= sGlobalBefore.nDirtyFlushes + 4 );
+
+        poDS.reset();
+        VSIUnlink(pszFilename);
+    }
+
+    // Test background prefetching of AdviseRead() windows
+    template<> template<> void object::test<25>()
+    {
+        const char* pszFilename = "/vsimem/test_advise_read_prefetch.tif";
+        auto poDrv = GDALDriver::FromHandle(GDALGetDriverByName("GTiff"));
+        const char* const apszOptions[] = { "TILED=YES",
+                                            "BLOCKXSIZE=32",
+                                            "BLOCKYSIZE=32",
+                                            "COMPRESS=DEFLATE", nullptr };
+        std::vector<GByte> abyRef(2 * 160 * 96);
+        for( size_t i = 0; i < abyRef.size(); ++i )
+            abyRef[i] = static_cast<GByte>((i * 7) % 251);
+        {
+            GDALDatasetUniquePtr poDS(poDrv->Create(
+                pszFilename, 160, 96, 2, GDT_Byte,
+                const_cast<char**>(apszOptions)));
+            ensure( poDS != nullptr );
+            ensure_equals( poDS->RasterIO(GF_Write, 0, 0, 160, 96,
+                                          &abyRef[0], 160, 96, GDT_Byte,
+                                          2, nullptr, 0, 0, 0, nullptr),
+                           CE_None );
+        }
+
+        CPLSetConfigOption("GDAL_ADVISE_READ_PREFETCH", "YES");
+        {
+            GDALDatasetUniquePtr poDS(GDALDataset::Open(pszFilename));
+            ensure( poDS != nullptr );
+            ensure_equals( poDS->AdviseRead(0, 0, 160, 96, 160, 96, GDT_Byte,
+                                            2, nullptr, nullptr), CE_None );
+            std::vector<GByte> abyBuffer(abyRef.size());
+            // Read by chunks of lines, as a scanline oriented consumer
+            for( int iY = 0; iY < 96; iY += 16 )
+            {
+                ensure_equals( poDS->RasterIO(GF_Read, 0, iY, 160, 16,
+                                              &abyBuffer[iY * 160], 160, 16,
+                                              GDT_Byte, 2, nullptr,
+                                              0, 0, 160 * 96, nullptr),
+                               CE_None );
+            }
+            ensure( abyBuffer == abyRef );
+
+            // Prefetching a window, and closing before reading it
+            ensure_equals( poDS->GetRasterBand(1)->AdviseRead(
+                                    32, 32, 64, 64, 64, 64, GDT_Byte,
+                                    nullptr), CE_None );
+            poDS->FlushCache();
+        }
+        CPLSetConfigOption("GDAL_ADVISE_READ_PREFETCH", nullptr);
+
+        VSIUnlink(pszFilename);
+    }
+
+    // Test GDALDatasetRasterIOBatch()
+    template<> template<> void object::test<26>()
+    {
+        const char* pszFilename = "/vsimem/test_rasterio_batch.tif";
+        auto poDrv = GDALDriver::FromHandle(GDALGetDriverByName("GTiff"));
+        const char* const apszOptions[] = { "TILED=YES",
+                                            "BLOCKXSIZE=16",
+                                            "BLOCKYSIZE=16", nullptr };
+        std::vector<GByte> abyRef(2 * 64 * 48);
+        for( size_t i = 0; i < abyRef.size(); ++i )
+            abyRef[i] = static_cast<GByte>((i * 13) % 253);
+        {
+            GDALDatasetUniquePtr poDS(poDrv->Create(
+                pszFilename, 64, 48, 2, GDT_Byte,
+                const_cast<char**>(apszOptions)));
+            ensure( poDS != nullptr );
+            ensure_equals( poDS->RasterIO(GF_Write, 0, 0, 64, 48,
+                                          &abyRef[0], 64, 48, GDT_Byte,
+                                          2, nullptr, 0, 0, 0, nullptr),
+                           CE_None );
+        }
+
+        GDALDatasetUniquePtr poDS(GDALDataset::Open(pszFilename));
+        ensure( poDS != nullptr );
+
+        std::vector<GByte> abyWin1(2 * 10 * 20);
+        std::vector<GByte> abyWin2(2 * 30 * 5);
+        std::vector<GByte> abyWin3(2 * 8 * 6);
+        GDALRasterIOWindow asWindows[3];
+        memset(asWindows, 0, sizeof(asWindows));
+        asWindows[0].nXOff = 3;
+        asWindows[0].nYOff = 7;
+        asWindows[0].nXSize = 10;
+        asWindows[0].nYSize = 20;
+        asWindows[0].pData = &abyWin1[0];
+        asWindows[0].nBufXSize = 10;
+        asWindows[0].nBufYSize = 20;
+        asWindows[1].nXOff = 30;
+        asWindows[1].nYOff = 40;
+        asWindows[1].nXSize = 30;
+        asWindows[1].nYSize = 5;
+        asWindows[1].pData = &abyWin2[0];
+        asWindows[1].nBufXSize = 30;
+        asWindows[1].nBufYSize = 5;
+        // Subsampled window, with pixel interleaved buffer
+        asWindows[2].nXOff = 0;
+        asWindows[2].nYOff = 0;
+        asWindows[2].nXSize = 16;
+        asWindows[2].nYSize = 12;
+        asWindows[2].pData = &abyWin3[0];
+        asWindows[2].nBufXSize = 8;
+        asWindows[2].nBufYSize = 6;
+        asWindows[2].nPixelSpace = 2;
+        asWindows[2].nLineSpace = 2 * 8;
+        asWindows[2].nBandSpace = 1;
+        ensure_equals( GDALDatasetRasterIOBatch(
+                            GDALDataset::ToHandle(poDS.get()),
+                            3, asWindows, GDT_Byte, 2, nullptr, nullptr),
+                       CE_None );
+
+        for( int iBand = 0; iBand < 2; ++iBand )
+        {
+            for( int iY = 0; iY < 20; ++iY )
+                for( int iX = 0; iX < 10; ++iX )
+                    ensure_equals( abyWin1[iBand * 200 + iY * 10 + iX],
+                                   abyRef[iBand * 64 * 48 +
+                                          (7 + iY) * 64 + 3 + iX] );
+            for( int iY = 0; iY < 5; ++iY )
+                for( int iX = 0; iX < 30; ++iX )
+                    ensure_equals( abyWin2[iBand * 150 + iY * 30 + iX],
+                                   abyRef[iBand * 64 * 48 +
+                                          (40 + iY) * 64 + 30 + iX] );
+            for( int iY = 0; iY < 6; ++iY )
+                for( int iX = 0; iX < 8; ++iX )
+                    ensure_equals( abyWin3[(iY * 8 + iX) * 2 + iBand],
+                                   abyRef[iBand * 64 * 48 +
+                                          (2 * iY + 1) * 64 + 2 * iX + 1] );
+        }
+
+        // Invalid window
+        asWindows[1].nXOff = 60;
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure_equals( GDALDatasetRasterIOBatch(
+                            GDALDataset::ToHandle(poDS.get()),
+                            2, asWindows, GDT_Byte, 2, nullptr, nullptr),
+                       CE_Failure );
+        CPLPopErrorHandler();
+
+        poDS.reset();
+        VSIUnlink(pszFilename);
+    }
+
+    // Test GDALRasterBand::ComputePercentiles()
+    template<> template<> void object::test<27>()
+    {
+        auto poDrv = GDALDriver::FromHandle(GDALGetDriverByName("MEM"));
+        GDALDatasetUniquePtr poDS(poDrv->Create("", 10, 10, 1, GDT_Byte,
+                                                nullptr));
+        ensure( poDS != nullptr );
+        std::vector<GByte> abyValues(100);
+        for( int i = 0; i < 100; ++i )
+            abyValues[i] = static_cast<GByte>(99 - i);
+        auto poBand = poDS->GetRasterBand(1);
+        ensure_equals( poBand->RasterIO(GF_Write, 0, 0, 10, 10,
+                                        &abyValues[0], 10, 10, GDT_Byte,
+                                        0, 0, nullptr),
+                       CE_None );
+
+        const double adfPercentiles[] = { 0, 2, 50, 98, 100 };
+        double adfValues[5] = { 0 };
+        // No default histogram yet
+        ensure_equals( poBand->ComputePercentiles(5, adfPercentiles,
+                                                  adfValues, FALSE,
+                                                  nullptr, nullptr),
+                       CE_Warning );
+        ensure_equals( poBand->ComputePercentiles(5, adfPercentiles,
+                                                  adfValues, TRUE,
+                                                  nullptr, nullptr),
+                       CE_None );
+        ensure_distance( adfValues[0], 0.0, 1e-10 );
+        ensure_distance( adfValues[1], 1.98, 1e-10 );
+        ensure_distance( adfValues[2], 49.5, 1e-10 );
+        ensure_distance( adfValues[3], 97.02, 1e-10 );
+        ensure_distance( adfValues[4], 99.0, 1e-10 );
+
+        // The histogram has been stored, so that it is available without
+        // forcing its computation.
+        const double dfMedian = 50;
+        double dfValue = 0;
+        ensure_equals( GDALComputeRasterPercentiles(
+                            GDALRasterBand::ToHandle(poBand), 1,
+                            &dfMedian, &dfValue, FALSE, nullptr, nullptr),
+                       CE_None );
+        ensure_distance( dfValue, 49.5, 1e-10 );
+
+        // Invalid percentile
+        const double dfInvalid = 101;
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure_equals( poBand->ComputePercentiles(1, &dfInvalid, &dfValue,
+                                                  TRUE, nullptr, nullptr),
+                       CE_Failure );
+        CPLPopErrorHandler();
+    }
+
+    // Test GDALPerfCounter and GDALGetPerfCounters()
+    template<> template<> void object::test<28>()
+    {
+        GDALPerfCounter* poCounter = GDALPerfCounter::Get("test.counter");
+        ensure( poCounter != nullptr );
+        ensure_equals( GDALPerfCounter::Get("test.counter"), poCounter );
+        poCounter->Reset();
+        poCounter->Increment();
+        poCounter->Add(2);
+        ensure_equals( poCounter->GetValue(), 3 );
+
+        GDALPerfCounter* poTimeCounter =
+            GDALPerfCounter::Get("test.counter_time_ns");
+        {
+            GDALPerfCounterTimer oTimer(poTimeCounter);
+            CPLSleep(0.001);
+        }
+        ensure( poTimeCounter->GetValue() > 0 );
+
+        CPLStringList aosCounters(GDALGetPerfCounters());
+        ensure_equals( std::string(aosCounters.FetchNameValueDef(
+                                            "test.counter", "")),
+                       std::string("3") );
+
+        // Counters with a zero value are not reported
+        GDALResetPerfCounters();
+        ensure_equals( poCounter->GetValue(), 0 );
+        aosCounters.Assign(GDALGetPerfCounters());
+        ensure( aosCounters.FetchNameValue("test.counter") == nullptr );
+    }
+
+    // Test GDALLatencyHistogram and RasterIO latency statistics
+    template<> template<> void object::test<29>()
+    {
+        GDALLatencyHistogram oHistogram;
+        ensure_equals( oHistogram.GetPercentile(50), 0.0 );
+        oHistogram.Add(500);      // 0.5 us: bucket 0
+        oHistogram.Add(3000);     // 3 us: bucket 2
+        oHistogram.Add(3000);
+        oHistogram.Add(100000);   // 100 us: bucket 7
+        ensure_equals( oHistogram.GetCount(), 4 );
+        ensure( oHistogram.GetPercentile(50) >= 2.0 );
+        ensure( oHistogram.GetPercentile(50) <= 4.0 );
+        ensure_equals( oHistogram.GetPercentile(100), 100.0 );
+        CPLStringList aosReport;
+        oHistogram.Report(aosReport, "TEST");
+        ensure_equals( std::string(aosReport.FetchNameValueDef(
+                                            "TEST_HISTOGRAM", "")),
+                       std::string("1,0,2,0,0,0,0,1") );
+        ensure_equals( std::string(aosReport.FetchNameValueDef(
+                                            "TEST_MAX_US", "")),
+                       std::string("100.0") );
+        oHistogram.Reset();
+        ensure_equals( oHistogram.GetCount(), 0 );
+
+        GDALDriver* poDrv = GetGDALDriverManager()->GetDriverByName("GTiff");
+        if( poDrv == nullptr )
+            return;
+        const char* pszFilename = "/vsimem/test_rasterio_latency.tif";
+        const char* const apszOptions[] = { "TILED=YES", "BLOCKXSIZE=16",
+                                            "BLOCKYSIZE=16", nullptr };
+        GDALDataset* poDS = poDrv->Create(pszFilename, 64, 64, 1, GDT_Byte,
+                                          const_cast<char**>(apszOptions));
+        ensure( poDS != nullptr );
+        ensure( poDS->GetRasterIOLatencyStats() == nullptr );
+        poDS->EnableRasterIOLatencyStats();
+        std::vector<GByte> abyBuffer(64 * 64, 1);
+        ensure_equals( poDS->GetRasterBand(1)->RasterIO(
+            GF_Write, 0, 0, 64, 64, abyBuffer.data(), 64, 64, GDT_Byte,
+            0, 0, nullptr), CE_None );
+        CPLStringList aosStats(poDS->GetRasterIOLatencyStats());
+        ensure_equals( std::string(aosStats.FetchNameValueDef(
+                                            "WRITE_COUNT", "")),
+                       std::string("1") );
+        GDALClose(poDS);
+
+        poDS = GDALDataset::Open(pszFilename);
+        ensure( poDS != nullptr );
+        poDS->EnableRasterIOLatencyStats();
+        // Dataset RasterIO() calling band RasterIO() is recorded once, as a
+        // miss as blocks must be read.
+        ensure_equals( poDS->RasterIO(
+            GF_Read, 0, 0, 64, 64, abyBuffer.data(), 64, 64, GDT_Byte,
+            1, nullptr, 0, 0, 0, nullptr), CE_None );
+        // Blocks are now cached
+        ensure_equals( poDS->GetRasterBand(1)->RasterIO(
+            GF_Read, 0, 0, 32, 32, abyBuffer.data(), 32, 32, GDT_Byte,
+            0, 0, nullptr), CE_None );
+        aosStats.Assign(poDS->GetRasterIOLatencyStats());
+        ensure_equals( std::string(aosStats.FetchNameValueDef(
+                                            "MISS_COUNT", "")),
+                       std::string("1") );
+        ensure_equals( std::string(aosStats.FetchNameValueDef(
+                                            "MISS_BLOCKS_READ", "")),
+                       std::string("16") );
+        ensure_equals( std::string(aosStats.FetchNameValueDef(
+                                            "MISS_READ_BLOCK_COUNT", "")),
+                       std::string("1") );
+        ensure_equals( std::string(aosStats.FetchNameValueDef(
+                                            "HIT_COUNT", "")),
+                       std::string("1") );
+        ensure( CPLAtof(aosStats.FetchNameValueDef("MISS_READ_BLOCK_TOTAL_US",
+                                                   "-1")) <=
+                CPLAtof(aosStats.FetchNameValueDef("MISS_TOTAL_US", "0")) );
+
+        GDALDatasetResetRasterIOLatencyStats(GDALDataset::ToHandle(poDS));
+        aosStats.Assign(GDALDatasetGetRasterIOLatencyStats(
+                                                GDALDataset::ToHandle(poDS)));
+        ensure_equals( std::string(aosStats.FetchNameValueDef(
+                                            "HIT_COUNT", "")),
+                       std::string("0") );
+        GDALClose(poDS);
+        VSIUnlink(pszFilename);
+    }
+
+    // Test memory accounting API
+    template<> template<> void object::test<30>()
+    {
+        GDALDriver* poDrv = GetGDALDriverManager()->GetDriverByName("GTiff");
+        if( poDrv == nullptr )
+            return;
+        const char* pszFilename = "/vsimem/test_memory_usage.tif";
+        const char* const apszOptions[] = { "TILED=YES", "BLOCKXSIZE=16",
+                                            "BLOCKYSIZE=16", nullptr };
+        GDALDataset* poDS = poDrv->Create(pszFilename, 64, 64, 1, GDT_Byte,
+                                          const_cast<char**>(apszOptions));
+        ensure( poDS != nullptr );
+        GDALClose(poDS);
+
+        CPLStringList aosSummary(GDALGetMemoryUsageSummary());
+        ensure( CPLAtoGIntBig(aosSummary.FetchNameValueDef("VSIMEM", "0")) >
+                0 );
+
+        poDS = GDALDataset::Open(pszFilename);
+        ensure( poDS != nullptr );
+        ensure_equals( poDS->GetBlockCacheMemoryUsage(), 0 );
+        std::vector<GByte> abyBuffer(64 * 64);
+        ensure_equals( poDS->GetRasterBand(1)->RasterIO(
+            GF_Read, 0, 0, 64, 64, abyBuffer.data(), 64, 64, GDT_Byte,
+            0, 0, nullptr), CE_None );
+        GIntBig nBlockCacheBytes = 0;
+        GIntBig nDriverBytes = 0;
+        const GIntBig nTotal =
+            poDS->GetMemoryUsage(&nBlockCacheBytes, &nDriverBytes);
+        ensure( nBlockCacheBytes >= 64 * 64 );
+        ensure_equals( nTotal, nBlockCacheBytes + nDriverBytes );
+        ensure_equals( GDALDatasetGetMemoryUsage(GDALDataset::ToHandle(poDS),
+                                                 nullptr, nullptr),
+                       nTotal );
+
+        aosSummary.Assign(GDALGetMemoryUsageSummary());
+        ensure( atoi(aosSummary.FetchNameValueDef("DATASET_COUNT", "0")) >=
+                1 );
+        ensure( CPLAtoGIntBig(aosSummary.FetchNameValueDef("DRIVER_GTiff",
+                                                           "0")) >= nTotal );
+        ensure( CPLAtoGIntBig(aosSummary.FetchNameValueDef("TOTAL", "0")) >=
+                CPLAtoGIntBig(aosSummary.FetchNameValueDef("BLOCK_CACHE_USED",
+                                                           "0")) );
+
+        GDALClose(poDS);
+        VSIUnlink(pszFilename);
+    }
+
+    // Test GDALAutotune()
+    template<> template<> void object::test<31>()
+    {
+        const char* pszFilename = "/vsimem/test_gdal_autotune.txt";
+        CPLStringList aosOptions;
+        aosOptions.SetNameValue("SIZE", "64");
+        aosOptions.SetNameValue("MIN_TIME", "0");
+        ensure_equals( GDALAutotune(pszFilename, aosOptions.List(),
+                                    nullptr, nullptr), CE_None );
+
+        CPLStringList aosValues(CSLLoad(pszFilename));
+        ensure( aosValues.FetchNameValue("CPU") != nullptr );
+        ensure_equals( std::string(aosValues.FetchNameValueDef(
+                            "GDAL_VERSION", "")),
+                       std::string(GDALVersionInfo("RELEASE_NAME")) );
+        const int nChunkYSize =
+            atoi(aosValues.FetchNameValueDef("GDAL_OVR_CHUNKYSIZE", "0"));
+        ensure( nChunkYSize >= 32 && nChunkYSize <= 256 );
+        if( CPLGetNumCPUs() > 1 )
+        {
+            ensure( aosValues.FetchNameValue("WARP_THREAD_CHUNK_SIZE") !=
+                    nullptr );
+        }
+        VSIUnlink(pszFilename);
+
+        // No output file
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure_equals( GDALAutotune(nullptr, nullptr, nullptr, nullptr),
+                       CE_Failure );
+        CPLPopErrorHandler();
+    }
 } // namespace tut
@@ -27,7 +27,12 @@
 
 #include "ogr_p.h"
 #include "ogrsf_frmts.h"
+#include "ogr_recordbatch.h"
+#include "ogr_wkb.h"
 #include "../../gdal/ogr/ogrsf_frmts/osm/gpb.h"
+#ifdef GNM_ENABLED
+#include "gnmgraph.h"
+#endif
 
 #include <string>
 
@@ -1877,4 +1882,720 @@ namespace tut
         }
     }
 
+    // Test OGRLayer::GetArrowStream()
+    template<>
+    template<>
+    void object::test<21>()
+    {
+        std::unique_ptr<GDALDataset> poDS(
+            GetGDALDriverManager()->GetDriverByName("Memory")->
+                Create("", 0, 0, 0, GDT_Unknown, nullptr));
+        auto poLayer = poDS->CreateLayer("test", nullptr, wkbPoint);
+        OGRFieldDefn oFieldInt("int", OFTInteger);
+        poLayer->CreateField(&oFieldInt);
+        OGRFieldDefn oFieldStr("str", OFTString);
+        poLayer->CreateField(&oFieldStr);
+        OGRFieldDefn oFieldDate("date", OFTDate);
+        poLayer->CreateField(&oFieldDate);
+        for( int i = 0; i < 3; i++ )
+        {
+            OGRFeature oFeature(poLayer->GetLayerDefn());
+            if( i != 1 )
+            {
+                oFeature.SetField(0, 10 + i);
+                oFeature.SetField(1, CPLSPrintf("foo%d", i));
+                oFeature.SetGeometryDirectly(new OGRPoint(i, 2 * i));
+            }
+            oFeature.SetField(2, 1970, 1, 2 + i);
+            ensure_equals( poLayer->CreateFeature(&oFeature), OGRERR_NONE );
+        }
+
+        struct ArrowArrayStream stream;
+        const char* const apszOptions[] = { "MAX_FEATURES_IN_BATCH=2", nullptr };
+        ensure( poLayer->GetArrowStream(&stream, apszOptions) );
+
+        struct ArrowSchema schema;
+        ensure_equals( stream.get_schema(&stream, &schema), 0 );
+        ensure_equals( std::string(schema.format), "+s" );
+        ensure_equals( schema.n_children, 5 );
+        ensure_equals( std::string(schema.children[0]->format), "l" );
+        ensure_equals( std::string(schema.children[1]->name), "int" );
+        ensure_equals( std::string(schema.children[1]->format), "i" );
+        ensure_equals( std::string(schema.children[2]->format), "u" );
+        ensure_equals( std::string(schema.children[3]->format), "tdD" );
+        ensure_equals( std::string(schema.children[4]->format), "z" );
+        ensure( schema.children[4]->metadata != nullptr );
+        schema.release(&schema);
+
+        struct ArrowArray array;
+        ensure_equals( stream.get_next(&stream, &array), 0 );
+        ensure( array.release != nullptr );
+        ensure_equals( array.length, 2 );
+        ensure_equals( array.n_children, 5 );
+        const int32_t* panInt =
+            static_cast<const int32_t*>(array.children[1]->buffers[1]);
+        ensure_equals( panInt[0], 10 );
+        ensure_equals( array.children[1]->null_count, 1 );
+        const GByte* pabyValidity =
+            static_cast<const GByte*>(array.children[1]->buffers[0]);
+        ensure_equals( pabyValidity[0] & 3, 1 );
+        const int32_t* panOffsets =
+            static_cast<const int32_t*>(array.children[2]->buffers[1]);
+        ensure_equals( panOffsets[1], 4 );
+        ensure_equals( panOffsets[2], 4 );
+        const char* pszStr =
+            static_cast<const char*>(array.children[2]->buffers[2]);
+        ensure_equals( std::string(pszStr, 4), "foo0" );
+        const int32_t* panDays =
+            static_cast<const int32_t*>(array.children[3]->buffers[1]);
+        ensure_equals( panDays[1], 2 );
+        const int32_t* panWKBOffsets =
+            static_cast<const int32_t*>(array.children[4]->buffers[1]);
+        ensure_equals( panWKBOffsets[1], 21 );
+        array.release(&array);
+
+        ensure_equals( stream.get_next(&stream, &array), 0 );
+        ensure( array.release != nullptr );
+        ensure_equals( array.length, 1 );
+        array.release(&array);
+
+        ensure_equals( stream.get_next(&stream, &array), 0 );
+        ensure( array.release == nullptr );
+
+        stream.release(&stream);
+    }
+
+    // Test reuse of OGRSimpleCurve point arrays and OGRFeature string fields
+    template<>
+    template<>
+    void object::test<22>()
+    {
+        {
+            OGRLineString ls;
+            for( int i = 0; i < 1000; i++ )
+                ls.addPoint(i, i + 1);
+            ensure_equals( ls.getNumPoints(), 1000 );
+            ensure_equals( ls.getX(999), 999.0 );
+            ensure_equals( ls.getY(999), 1000.0 );
+
+            // Shrinking then growing again must zeroize the new points
+            ls.setNumPoints(2);
+            ls.setNumPoints(4);
+            ensure_equals( ls.getX(1), 1.0 );
+            ensure_equals( ls.getX(3), 0.0 );
+            ensure_equals( ls.getY(3), 0.0 );
+
+            // Z and M added after shrinking cover the retained capacity
+            ls.set3D(TRUE);
+            ls.setMeasured(TRUE);
+            ls.setNumPoints(1000);
+            ls.setPoint(999, 1, 2, 3, 4);
+            ensure_equals( ls.getZ(999), 3.0 );
+            ensure_equals( ls.getM(999), 4.0 );
+            ensure_equals( ls.getZ(500), 0.0 );
+
+            OGRLineString ls2;
+            ls2 = ls;
+            ensure( ls2.Equals(&ls) );
+
+            ls.empty();
+            ensure_equals( ls.getNumPoints(), 0 );
+            ls.addPoint(5, 6, 7);
+            ensure_equals( ls.getZ(0), 7.0 );
+        }
+
+        {
+            OGRFeatureDefn* poFDefn = new OGRFeatureDefn();
+            poFDefn->Reference();
+            OGRFieldDefn oFieldDefn("str", OFTString);
+            poFDefn->AddFieldDefn(&oFieldDefn);
+            OGRFeature oFeature(poFDefn);
+            oFeature.SetField(0, "abcdef");
+            oFeature.SetField(0, "ghi");
+            ensure_equals( std::string(oFeature.GetFieldAsString(0)), "ghi" );
+            oFeature.SetField(0, "jklmnopqrs");
+            ensure_equals( std::string(oFeature.GetFieldAsString(0)),
+                           "jklmnopqrs" );
+            // Assigning a suffix of the current value
+            oFeature.SetField(0, oFeature.GetFieldAsString(0) + 3);
+            ensure_equals( std::string(oFeature.GetFieldAsString(0)),
+                           "mnopqrs" );
+            oFeature.SetField(0, "");
+            ensure_equals( std::string(oFeature.GetFieldAsString(0)), "" );
+            poFDefn->Release();
+        }
+    }
+
+    // Test WKB envelope computation and ring iteration without
+    // instantiating geometries
+    template<>
+    template<>
+    void object::test<23>()
+    {
+        const char* const apszWKT[] = {
+            "POINT (1 2)",
+            "POINT Z (1 2 3)",
+            "LINESTRING (1 2,3 -4)",
+            "LINESTRING ZM (1 2 3 4,3 -4 5 6)",
+            "POLYGON ((0 0,0 10,10 10,10 0,0 0),(1 1,1 2,2 2,2 1,1 1))",
+            "MULTIPOINT ((1 2),(-3 4))",
+            "MULTIPOLYGON (((0 0,0 1,1 1,0 0)),((5 5,5 6,6 6,5 5)))",
+            "GEOMETRYCOLLECTION (POINT (1 2),LINESTRING M (3 4 0,5 6 0))",
+            "CURVEPOLYGON (CIRCULARSTRING (0 0,1 1,2 0,1 -1,0 0))",
+            "COMPOUNDCURVE ((0 0,1 1),CIRCULARSTRING (1 1,2 2,3 1))",
+        };
+        for( const char* pszWKT : apszWKT )
+        {
+            OGRGeometry* poGeom = nullptr;
+            OGRGeometryFactory::createFromWkt(pszWKT, nullptr, &poGeom);
+            ensure( poGeom != nullptr );
+            for( const auto eByteOrder : { wkbNDR, wkbXDR } )
+            {
+                std::vector<GByte> abyWKB(poGeom->WkbSize());
+                poGeom->exportToWkb(eByteOrder, abyWKB.data(), wkbVariantIso);
+
+                OGRwkbGeometryType eType = wkbUnknown;
+                ensure( OGRWKBGetGeomType(abyWKB.data(), abyWKB.size(),
+                                          eType) );
+                ensure_equals( eType, poGeom->getGeometryType() );
+
+                OGREnvelope sEnvelope;
+                ensure( OGRWKBGetBoundingBox(abyWKB.data(), abyWKB.size(),
+                                             sEnvelope) );
+                OGREnvelope sExpected;
+                poGeom->getEnvelope(&sExpected);
+                ensure_equals( sEnvelope.MinX, sExpected.MinX );
+                ensure_equals( sEnvelope.MinY, sExpected.MinY );
+                ensure_equals( sEnvelope.MaxX, sExpected.MaxX );
+                ensure_equals( sEnvelope.MaxY, sExpected.MaxY );
+
+                // Truncated buffers must be rejected
+                for( size_t i = 0; i < abyWKB.size(); i++ )
+                {
+                    ensure( !OGRWKBGetBoundingBox(abyWKB.data(), i,
+                                                  sEnvelope) );
+                }
+            }
+            delete poGeom;
+        }
+
+        // Empty geometries
+        {
+            OGRPolygon oPoly;
+            std::vector<GByte> abyWKB(oPoly.WkbSize());
+            oPoly.exportToWkb(wkbNDR, abyWKB.data());
+            OGREnvelope sEnvelope;
+            ensure( OGRWKBGetBoundingBox(abyWKB.data(), abyWKB.size(),
+                                         sEnvelope) );
+            ensure( !sEnvelope.IsInit() );
+        }
+
+        // Ring iteration
+        {
+            OGRGeometry* poGeom = nullptr;
+            OGRGeometryFactory::createFromWkt(
+                "POLYGON Z ((0 0 1,0 10 2,10 10 3,0 0 1),(1 1 0,1 2 0,2 2 0,1 1 0))",
+                nullptr, &poGeom);
+            ensure( poGeom != nullptr );
+            std::vector<GByte> abyWKB(poGeom->WkbSize());
+            poGeom->exportToWkb(wkbXDR, abyWKB.data(), wkbVariantIso);
+            delete poGeom;
+
+            OGRWKBGeometryView oView(abyWKB.data(), abyWKB.size());
+            ensure( oView.IsValid() );
+            ensure_equals( oView.GetNumRings(), 2U );
+            OGRWKBPointSequence oRing;
+            ensure( oView.GetNextRing(oRing) );
+            ensure_equals( oRing.nPoints, 4U );
+            ensure_equals( oRing.getX(2), 10.0 );
+            ensure_equals( oRing.getY(1), 10.0 );
+            ensure( oView.GetNextRing(oRing) );
+            ensure_equals( oRing.nPoints, 4U );
+            ensure_equals( oRing.getY(2), 2.0 );
+            ensure( !oView.GetNextRing(oRing) );
+            oView.ResetReading();
+            ensure( oView.GetNextRing(oRing) );
+            ensure_equals( oRing.getX(2), 10.0 );
+        }
+    }
+
+    // Test OGRCoordinateTransformation::TransformGeometries()
+    template<>
+    template<>
+    void object::test<24>()
+    {
+        OGRSpatialReference oSrcSRS;
+        oSrcSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+        oSrcSRS.importFromEPSG(4326);
+        OGRSpatialReference oDstSRS;
+        oDstSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+        oDstSRS.importFromEPSG(32631);
+        std::unique_ptr<OGRCoordinateTransformation> poCT(
+            OGRCreateCoordinateTransformation(&oSrcSRS, &oDstSRS));
+        ensure( poCT != nullptr );
+
+        const char* const apszWKT[] = {
+            "MULTIPOLYGON (((2 49,2 50,3 50,2 49),(2.1 49.1,2.1 49.2,2.2 49.2,2.1 49.1)),((4 49,4 50,5 50,4 49)))",
+            "POINT Z (2 49 10)",
+            "LINESTRING (2 49,3 50)",
+        };
+        constexpr int nGeoms = static_cast<int>(CPL_ARRAYSIZE(apszWKT));
+        OGRGeometry* apoGeoms[nGeoms + 1] = { nullptr };
+        for( int i = 0; i < nGeoms; i++ )
+        {
+            OGRGeometryFactory::createFromWkt(apszWKT[i], nullptr, &apoGeoms[i]);
+            ensure( apoGeoms[i] != nullptr );
+        }
+
+        OGRErr aeErrors[nGeoms + 1];
+        ensure( poCT->TransformGeometries(nGeoms + 1, apoGeoms, aeErrors) );
+        for( int i = 0; i < nGeoms + 1; i++ )
+        {
+            ensure_equals( aeErrors[i], OGRERR_NONE );
+        }
+
+        // Compare with the transformation of each individual point
+        const auto CheckPoint = [&poCT](double dfX, double dfY,
+                                        double dfXOut, double dfYOut)
+        {
+            ensure( poCT->Transform(1, &dfX, &dfY) );
+            ensure_distance( dfXOut, dfX, 1e-6 );
+            ensure_distance( dfYOut, dfY, 1e-6 );
+        };
+
+        auto poMP = apoGeoms[0]->toMultiPolygon();
+        ensure( poMP->getSpatialReference() != nullptr &&
+                poMP->getSpatialReference()->IsSame(&oDstSRS) );
+        auto poRing = poMP->getGeometryRef(0)->getInteriorRing(0);
+        ensure_equals( poRing->getNumPoints(), 4 );
+        ensure( poRing->get_IsClosed() );
+        CheckPoint(2.1, 49.2, poRing->getX(1), poRing->getY(1));
+        poRing = poMP->getGeometryRef(1)->getExteriorRing();
+        ensure( poRing->getSpatialReference() != nullptr );
+        CheckPoint(5, 50, poRing->getX(2), poRing->getY(2));
+
+        auto poPoint = apoGeoms[1]->toPoint();
+        ensure( poPoint->Is3D() );
+        CheckPoint(2, 49, poPoint->getX(), poPoint->getY());
+
+        auto poLS = apoGeoms[2]->toLineString();
+        CheckPoint(3, 50, poLS->getX(1), poLS->getY(1));
+
+        for( int i = 0; i < nGeoms; i++ )
+            delete apoGeoms[i];
+
+        // A point that cannot be transformed in the second part of a
+        // multipolygon: the first part is transformed, not the second one.
+        {
+            OGRGeometry* poGeom = nullptr;
+            OGRGeometryFactory::createFromWkt(
+                "MULTIPOLYGON (((2 49,2 50,3 50,2 49)),((2 49,2 200,3 50,2 49)))",
+                nullptr, &poGeom);
+            ensure( poGeom != nullptr );
+            OGRErr eErr = OGRERR_NONE;
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            ensure( !poCT->TransformGeometries(1, &poGeom, &eErr) );
+            CPLPopErrorHandler();
+            ensure_equals( eErr, OGRERR_FAILURE );
+            poMP = poGeom->toMultiPolygon();
+            ensure( poMP->getGeometryRef(0)->getExteriorRing()->getX(0) > 1000 );
+            ensure_equals( poMP->getGeometryRef(1)->getExteriorRing()->getX(0), 2.0 );
+            delete poGeom;
+        }
+    }
+
+    // Test multi-threaded reading of a GeoPackage through GetArrowStream()
+    template<>
+    template<>
+    void object::test<25>()
+    {
+        auto poDrv = GDALDriver::FromHandle(GDALGetDriverByName("GPKG"));
+        if( poDrv == nullptr )
+        {
+            ensure(true); // Skip
+            return;
+        }
+        const char* pszFilename = "/vsimem/test_ogr_gpkg_arrow_threads.gpkg";
+        {
+            GDALDatasetUniquePtr poDS(poDrv->Create(
+                pszFilename, 0, 0, 0, GDT_Unknown, nullptr));
+            ensure( poDS != nullptr );
+            auto poLayer = poDS->CreateLayer("test", nullptr, wkbPoint);
+            OGRFieldDefn oFieldInt("int", OFTInteger);
+            poLayer->CreateField(&oFieldInt);
+            poLayer->StartTransaction();
+            for( int i = 0; i < 100; i++ )
+            {
+                OGRFeature oFeature(poLayer->GetLayerDefn());
+                oFeature.SetField(0, i);
+                oFeature.SetGeometryDirectly(new OGRPoint(i, -i));
+                ensure_equals( poLayer->CreateFeature(&oFeature), OGRERR_NONE );
+            }
+            poLayer->CommitTransaction();
+            // Holes in the FID sequence, including a whole batch.
+            for( int i = 15; i <= 30; i++ )
+                ensure_equals( poLayer->DeleteFeature(i), OGRERR_NONE );
+        }
+
+        const auto ReadFIDs = [pszFilename](const char* pszNumThreads,
+                                            const char* pszFilter)
+        {
+            CPLSetConfigOption("OGR_GPKG_NUM_THREADS", pszNumThreads);
+            std::vector<int64_t> anFIDs;
+            GDALDatasetUniquePtr poDS(GDALDataset::Open(pszFilename,
+                                                        GDAL_OF_VECTOR));
+            ensure( poDS != nullptr );
+            auto poLayer = poDS->GetLayer(0);
+            poLayer->SetAttributeFilter(pszFilter);
+            struct ArrowArrayStream stream;
+            const char* const apszOptions[] = {
+                "MAX_FEATURES_IN_BATCH=7", nullptr };
+            ensure( poLayer->GetArrowStream(&stream, apszOptions) );
+            while( true )
+            {
+                struct ArrowArray array;
+                ensure_equals( stream.get_next(&stream, &array), 0 );
+                if( array.release == nullptr )
+                    break;
+                ensure( array.length <= 7 );
+                ensure_equals( array.n_children, 3 );
+                const int64_t* panFIDs =
+                    static_cast<const int64_t*>(array.children[0]->buffers[1]);
+                const int32_t* panInt =
+                    static_cast<const int32_t*>(array.children[1]->buffers[1]);
+                for( int64_t i = 0; i < array.length; ++i )
+                {
+                    ensure_equals( panInt[i] + 1, panFIDs[i] );
+                    anFIDs.push_back(panFIDs[i]);
+                }
+                array.release(&array);
+            }
+            stream.release(&stream);
+            CPLSetConfigOption("OGR_GPKG_NUM_THREADS", nullptr);
+            return anFIDs;
+        };
+
+        const auto anExpected = ReadFIDs("1", nullptr);
+        ensure_equals( anExpected.size(), 84U );
+        ensure( ReadFIDs("3", nullptr) == anExpected );
+        ensure( ReadFIDs("3", "int >= 50") ==
+                std::vector<int64_t>(anExpected.begin() + 34,
+                                     anExpected.end()) );
+
+        VSIUnlink(pszFilename);
+    }
+
+
+    // Test OGRLayer::WriteArrowBatch() on a GeoPackage, with its fast path
+    // and the generic implementation
+    template<>
+    template<>
+    void object::test<26>()
+    {
+        auto poGPKGDrv = GDALDriver::FromHandle(GDALGetDriverByName("GPKG"));
+        auto poMemDrv = GDALDriver::FromHandle(GDALGetDriverByName("Memory"));
+        if( poGPKGDrv == nullptr || poMemDrv == nullptr )
+        {
+            ensure(true); // Skip
+            return;
+        }
+
+        GDALDatasetUniquePtr poSrcDS(poMemDrv->Create(
+            "", 0, 0, 0, GDT_Unknown, nullptr));
+        auto poSrcLayer = poSrcDS->CreateLayer("src", nullptr, wkbUnknown);
+        OGRFieldDefn oFieldInt("int", OFTInteger);
+        poSrcLayer->CreateField(&oFieldInt);
+        OGRFieldDefn oFieldReal("real", OFTReal);
+        poSrcLayer->CreateField(&oFieldReal);
+        OGRFieldDefn oFieldStr("str", OFTString);
+        poSrcLayer->CreateField(&oFieldStr);
+        OGRFieldDefn oFieldDate("date", OFTDate);
+        poSrcLayer->CreateField(&oFieldDate);
+        const char* const apszWKT[] = {
+            "POINT (1 2)",
+            "POLYGON ((0 0,0 1,1 1,0 0))",
+            "CURVEPOLYGON ((0 0,0 1,1 1,0 0))",
+            nullptr,
+            "LINESTRING EMPTY" };
+        for( int i = 0; i < 5; i++ )
+        {
+            OGRFeature oFeature(poSrcLayer->GetLayerDefn());
+            oFeature.SetField(0, i);
+            oFeature.SetField(1, i + 0.5);
+            if( i != 1 )
+                oFeature.SetField(2, i == 2 ? "" : CPLSPrintf("str%d", i));
+            oFeature.SetField(3, 2022, 1, i + 1);
+            if( apszWKT[i] )
+            {
+                OGRGeometry* poGeom = nullptr;
+                OGRGeometryFactory::createFromWkt(apszWKT[i], nullptr, &poGeom);
+                oFeature.SetGeometryDirectly(poGeom);
+            }
+            ensure_equals( poSrcLayer->CreateFeature(&oFeature), OGRERR_NONE );
+        }
+
+        const char* pszFilename = "/vsimem/test_ogr_gpkg_write_arrow.gpkg";
+        GDALDatasetUniquePtr poDS(poGPKGDrv->Create(
+            pszFilename, 0, 0, 0, GDT_Unknown, nullptr));
+        ensure( poDS != nullptr );
+
+        const auto Copy = [&poSrcLayer](OGRLayer* poDstLayer)
+        {
+            struct ArrowArrayStream stream;
+            const char* const apszOptions[] = {
+                "INCLUDE_FID=NO", "MAX_FEATURES_IN_BATCH=3", nullptr };
+            poSrcLayer->ResetReading();
+            ensure( poSrcLayer->GetArrowStream(&stream, apszOptions) );
+            struct ArrowSchema schema;
+            ensure_equals( stream.get_schema(&stream, &schema), 0 );
+            while( true )
+            {
+                struct ArrowArray array;
+                ensure_equals( stream.get_next(&stream, &array), 0 );
+                if( array.release == nullptr )
+                    break;
+                ensure( poDstLayer->WriteArrowBatch(&schema, &array) );
+                array.release(&array);
+            }
+            schema.release(&schema);
+            stream.release(&stream);
+        };
+
+        const auto Check = [&apszWKT](OGRLayer* poLayer, bool bHasDate)
+        {
+            ensure_equals( poLayer->GetFeatureCount(), 5 );
+            poLayer->ResetReading();
+            for( int i = 0; i < 5; i++ )
+            {
+                std::unique_ptr<OGRFeature> poFeature(
+                    poLayer->GetNextFeature());
+                ensure( poFeature != nullptr );
+                ensure_equals( poFeature->GetFID(), i + 1 );
+                ensure_equals( poFeature->GetFieldAsInteger("int"), i );
+                ensure_equals( poFeature->GetFieldAsDouble("real"), i + 0.5 );
+                if( i == 1 )
+                    ensure( poFeature->IsFieldNull(
+                        poFeature->GetFieldIndex("str")) );
+                else
+                    ensure_equals(
+                        std::string(poFeature->GetFieldAsString("str")),
+                        std::string(i == 2 ? "" : CPLSPrintf("str%d", i)) );
+                if( bHasDate )
+                    ensure_equals(
+                        std::string(poFeature->GetFieldAsString("date")),
+                        std::string(CPLSPrintf("2022/01/%02d", i + 1)) );
+                const OGRGeometry* poGeom = poFeature->GetGeometryRef();
+                if( apszWKT[i] == nullptr )
+                {
+                    ensure( poGeom == nullptr );
+                    continue;
+                }
+                ensure( poGeom != nullptr );
+                char* pszWKT = nullptr;
+                poGeom->exportToWkt(&pszWKT, wkbVariantIso);
+                ensure_equals( std::string(pszWKT), std::string(apszWKT[i]) );
+                CPLFree(pszWKT);
+            }
+
+            // Check the spatial index
+            poLayer->SetSpatialFilterRect(0.5, 0.5, 0.6, 0.6);
+            ensure_equals( poLayer->GetFeatureCount(), 2 );
+            poLayer->SetSpatialFilter(nullptr);
+        };
+
+        // Fast path: only fields that can be bound directly
+        auto poLayer = poDS->CreateLayer("fast", nullptr, wkbUnknown);
+        poLayer->CreateField(&oFieldInt);
+        poLayer->CreateField(&oFieldReal);
+        poLayer->CreateField(&oFieldStr);
+        const char* apszIgnored[] = { "date", nullptr };
+        poSrcLayer->SetIgnoredFields(apszIgnored);
+        Copy(poLayer);
+        Check(poLayer, false);
+
+        // Generic implementation, because of the date field
+        poLayer = poDS->CreateLayer("generic", nullptr, wkbUnknown);
+        poLayer->CreateField(&oFieldInt);
+        poLayer->CreateField(&oFieldReal);
+        poLayer->CreateField(&oFieldStr);
+        poLayer->CreateField(&oFieldDate);
+        poSrcLayer->SetIgnoredFields(nullptr);
+        Copy(poLayer);
+        Check(poLayer, true);
+
+        // Unknown column
+        struct ArrowArrayStream stream;
+        ensure( poSrcLayer->GetArrowStream(&stream) );
+        struct ArrowSchema schema;
+        ensure_equals( stream.get_schema(&stream, &schema), 0 );
+        struct ArrowArray array;
+        ensure_equals( stream.get_next(&stream, &array), 0 );
+        poLayer = poDS->GetLayerByName("fast");
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure( !poLayer->WriteArrowBatch(&schema, &array) );
+        CPLPopErrorHandler();
+        array.release(&array);
+        schema.release(&schema);
+        stream.release(&stream);
+
+        poDS.reset();
+        VSIUnlink(pszFilename);
+    }
+
+    // Test OGRLayer::GetMemoryUsage() on a memory layer
+    template<>
+    template<>
+    void object::test<27>()
+    {
+        std::unique_ptr<GDALDataset> poDS(
+            GetGDALDriverManager()->GetDriverByName("Memory")->
+                Create("", 0, 0, 0, GDT_Unknown, nullptr));
+        auto poLayer = poDS->CreateLayer("test", nullptr, wkbPoint);
+        OGRFieldDefn oFieldStr("str", OFTString);
+        poLayer->CreateField(&oFieldStr);
+        ensure_equals( poLayer->GetMemoryUsage(), 0 );
+
+        OGRFeature oFeature(poLayer->GetLayerDefn());
+        oFeature.SetGeometryDirectly(new OGRPoint(1, 2));
+        ensure_equals( poLayer->CreateFeature(&oFeature), OGRERR_NONE );
+        const GIntBig nUsageOneFeature = poLayer->GetMemoryUsage();
+        ensure( nUsageOneFeature > 0 );
+
+        oFeature.SetFID(OGRNullFID);
+        oFeature.SetField(0, std::string(1000, 'x').c_str());
+        ensure_equals( poLayer->CreateFeature(&oFeature), OGRERR_NONE );
+        ensure( poLayer->GetMemoryUsage() >= nUsageOneFeature + 1000 );
+
+        ensure_equals( OGR_L_GetMemoryUsage(OGRLayer::ToHandle(poLayer)),
+                       poLayer->GetMemoryUsage() );
+        ensure_equals( poDS->GetDriverMemoryUsage(),
+                       poLayer->GetMemoryUsage() );
+    }
+
+#ifdef GNM_ENABLED
+    // Test GNMGraph shortest paths against a Bellman-Ford reference with the
+    // semantics of the original implementation: edges are always walked
+    // with their direct cost, blocked edges and vertices are barriers.
+    template<>
+    template<>
+    void object::test<28>()
+    {
+        const int nVertices = 200;
+        const int nEdges = 600;
+        GNMGraph oGraph;
+        std::vector<GNMGFID> anSrc, anTgt;
+        std::vector<double> adfCost;
+        std::vector<bool> abBidir, abBlockedEdge;
+        std::vector<bool> abBlockedVertex(nVertices, false);
+        unsigned nSeed = 12345;
+        const auto Rand = [&nSeed](unsigned nMax)
+        {
+            nSeed = nSeed * 1103515245U + 12345U;
+            return (nSeed >> 16) % nMax;
+        };
+        for( int i = 0; i < nEdges; i++ )
+        {
+            anSrc.push_back(Rand(nVertices));
+            anTgt.push_back(Rand(nVertices));
+            adfCost.push_back(1 + Rand(10));
+            abBidir.push_back(Rand(2) == 0);
+            abBlockedEdge.push_back(Rand(20) == 0);
+            // Vertex FIDs are 0..nVertices-1, edge FIDs start at 1000
+            oGraph.AddEdge(1000 + i, anSrc[i], anTgt[i], abBidir[i],
+                           adfCost[i], 2 * adfCost[i]);
+            if( abBlockedEdge[i] )
+                oGraph.ChangeBlockState(1000 + i, true);
+        }
+        for( int i = 10; i < nVertices; i += 17 )
+        {
+            abBlockedVertex[i] = true;
+            oGraph.ChangeBlockState(i, true);
+        }
+
+        const double dfInfinity = std::numeric_limits<double>::infinity();
+        const auto Reference = [&](GNMGFID nStart)
+        {
+            std::vector<double> adfDist(nVertices, dfInfinity);
+            adfDist[static_cast<size_t>(nStart)] = 0;
+            for( int iIter = 0; iIter < nVertices; iIter++ )
+            {
+                for( int i = 0; i < nEdges; i++ )
+                {
+                    if( abBlockedEdge[i] )
+                        continue;
+                    const auto s = static_cast<size_t>(anSrc[i]);
+                    const auto t = static_cast<size_t>(anTgt[i]);
+                    if( !abBlockedVertex[t] &&
+                        adfDist[s] + adfCost[i] < adfDist[t] )
+                        adfDist[t] = adfDist[s] + adfCost[i];
+                    if( abBidir[i] && !abBlockedVertex[s] &&
+                        adfDist[t] + adfCost[i] < adfDist[s] )
+                        adfDist[s] = adfDist[t] + adfCost[i];
+                }
+            }
+            return adfDist;
+        };
+        const auto PathCost = [&](const GNMPATH& aoPath)
+        {
+            double dfCost = 0;
+            for( const auto& oPair: aoPath )
+            {
+                if( oPair.second >= 0 )
+                    dfCost += adfCost[static_cast<size_t>(oPair.second - 1000)];
+            }
+            return dfCost;
+        };
+
+        GNMVECTOR anStarts, anEnds;
+        for( GNMGFID i = 0; i < nVertices; i += 9 )
+        {
+            if( !abBlockedVertex[static_cast<size_t>(i)] )
+                anStarts.push_back(i);
+        }
+        for( GNMGFID i = 1; i < nVertices; i += 7 )
+            anEnds.push_back(i);
+
+        const std::vector<GNMPATH> aoPaths =
+            oGraph.DijkstraShortestPaths(anStarts, anEnds, 4);
+        ensure_equals( aoPaths.size(), anStarts.size() * anEnds.size() );
+        int nReachable = 0;
+        for( size_t i = 0; i < anStarts.size(); i++ )
+        {
+            const std::vector<double> adfDist = Reference(anStarts[i]);
+            for( size_t j = 0; j < anEnds.size(); j++ )
+            {
+                const double dfExpected =
+                    adfDist[static_cast<size_t>(anEnds[j])];
+                const GNMPATH& aoPath = aoPaths[i * anEnds.size() + j];
+                const GNMPATH aoSinglePath =
+                    oGraph.DijkstraShortestPath(anStarts[i], anEnds[j]);
+                if( dfExpected == dfInfinity )
+                {
+                    ensure( aoPath.empty() );
+                    ensure( aoSinglePath.empty() );
+                    continue;
+                }
+                nReachable++;
+                ensure( !aoPath.empty() );
+                ensure_equals( aoPath.front().first, anStarts[i] );
+                ensure_equals( aoPath.back().first, anEnds[j] );
+                ensure_equals( PathCost(aoPath), dfExpected );
+                ensure_equals( PathCost(aoSinglePath), dfExpected );
+
+                if( (i + j) % 16 == 0 )
+                {
+                    const std::vector<GNMPATH> aoKPaths =
+                        oGraph.KShortestPaths(anStarts[i], anEnds[j], 3);
+                    ensure( !aoKPaths.empty() );
+                    ensure_equals( PathCost(aoKPaths[0]), dfExpected );
+                    for( size_t k = 1; k < aoKPaths.size(); k++ )
+                        ensure( PathCost(aoKPaths[k]) >=
+                                PathCost(aoKPaths[k - 1]) );
+                }
+            }
+        }
+        ensure( nReachable > 0 );
+    }
+#endif
+
 } // namespace tut
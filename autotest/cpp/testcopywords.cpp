@@ -569,6 +569,88 @@ template<> void CheckPacked<GUInt16,GInt16>(GDALDataType eIn, GDALDataType eOut)
     }
 }
 
+template<> void CheckPacked<GInt16,GByte>(GDALDataType eIn, GDALDataType eOut)
+{
+    CheckPackedGeneric<GInt16,GByte>(eIn, eOut);
+
+    const int N = 64+7;
+    GInt16 arrayIn[N] = { 0 };
+    GByte arrayOut[N] = { 0 };
+    for(int i=0;i<N;i++)
+    {
+        arrayIn[i] = (i % 4) == 0 ? -32768 : (i % 4) == 1 ? -1 :
+                     (i % 4) == 2 ? 255 : 256;
+    }
+    GDALCopyWords(arrayIn, eIn, GDALGetDataTypeSizeBytes(eIn),
+                  arrayOut, eOut, GDALGetDataTypeSizeBytes(eOut),
+                  N);
+    int numLine = 0;
+    for(int i=0;i<N;i++)
+    {
+        ASSERT(eIn, (int)arrayIn[i], eOut, (i%4) <= 1 ? 0 : 255, arrayOut[i] );
+    }
+}
+template<> void CheckPacked<GInt16,GUInt16>(GDALDataType eIn, GDALDataType eOut)
+{
+    CheckPackedGeneric<GInt16,GUInt16>(eIn, eOut);
+
+    const int N = 64+7;
+    GInt16 arrayIn[N] = { 0 };
+    GUInt16 arrayOut[N] = { 0 };
+    for(int i=0;i<N;i++)
+    {
+        arrayIn[i] = (i % 2) == 0 ? -32768 : 32767;
+    }
+    GDALCopyWords(arrayIn, eIn, GDALGetDataTypeSizeBytes(eIn),
+                  arrayOut, eOut, GDALGetDataTypeSizeBytes(eOut),
+                  N);
+    int numLine = 0;
+    for(int i=0;i<N;i++)
+    {
+        ASSERT(eIn, (int)arrayIn[i], eOut, (i%2) == 0 ? 0 : 32767, arrayOut[i] );
+    }
+}
+template<> void CheckPacked<GInt16,float>(GDALDataType eIn, GDALDataType eOut)
+{
+    CheckPackedGeneric<GInt16,float>(eIn, eOut);
+
+    const int N = 64+7;
+    GInt16 arrayIn[N] = { 0 };
+    float arrayOut[N] = { 0 };
+    for(int i=0;i<N;i++)
+    {
+        arrayIn[i] = static_cast<GInt16>(-32768 + i * 900);
+    }
+    GDALCopyWords(arrayIn, eIn, GDALGetDataTypeSizeBytes(eIn),
+                  arrayOut, eOut, GDALGetDataTypeSizeBytes(eOut),
+                  N);
+    int numLine = 0;
+    for(int i=0;i<N;i++)
+    {
+        ASSERT(eIn, (int)arrayIn[i], eOut, (int)arrayIn[i], arrayOut[i] );
+    }
+}
+template<> void CheckPacked<GUInt32,double>(GDALDataType eIn, GDALDataType eOut)
+{
+    CheckPackedGeneric<GUInt32,double>(eIn, eOut);
+
+    const int N = 64+7;
+    GUInt32 arrayIn[N] = { 0 };
+    double arrayOut[N] = { 0 };
+    for(int i=0;i<N;i++)
+    {
+        arrayIn[i] = 0xFFFFFFFFU - static_cast<GUInt32>(i) * 100000000U;
+    }
+    GDALCopyWords(arrayIn, eIn, GDALGetDataTypeSizeBytes(eIn),
+                  arrayOut, eOut, GDALGetDataTypeSizeBytes(eOut),
+                  N);
+    int numLine = 0;
+    for(int i=0;i<N;i++)
+    {
+        ASSERT(eIn, (GIntBig)arrayIn[i], eOut, (GIntBig)arrayIn[i], arrayOut[i] );
+    }
+}
+
 template<class Tin> 
 void CheckPacked(GDALDataType eIn, GDALDataType eOut)
 {
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Core
+ * Purpose:  Test deferred loading of driver plugins
+ *           (GDAL_DEFERRED_PLUGIN_LOADING=YES).
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "gdal.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+static bool IsPluginLoaded()
+{
+    return CPLTestBool(
+        CPLGetConfigOption("DEFERRED_TEST_PLUGIN_LOADED", "NO"));
+}
+
+static void Check( bool bCond, const char* pszMsg )
+{
+    if( !bCond )
+    {
+        fprintf(stderr, "FAILURE: %s\n", pszMsg);
+        exit(1);
+    }
+}
+
+int main( int argc, char* argv[] )
+{
+    // The directory containing gdal_DEFERREDTEST.so is given as first
+    // argument so that only that plugin is declared. The second argument
+    // selects whether the first access to the plugin driver goes through
+    // GDALOpenEx() ("open", the default) or GDALIdentifyDriverEx()
+    // ("identify"), as the plugin can only be loaded once per process.
+    CPLSetConfigOption("GDAL_DRIVER_PATH",
+                       argc >= 2 ? argv[1] : "deferredplugin");
+    const bool bIdentify = argc >= 3 && EQUAL(argv[2], "identify");
+    CPLSetConfigOption("GDAL_DEFERRED_PLUGIN_LOADING", "YES");
+    GDALAllRegister();
+
+    Check(!IsPluginLoaded(),
+          "plugin loaded by GDALAllRegister()");
+
+    // Looking up or opening with a built-in driver must not load the plugin.
+    Check(GDALGetDriverByName("GTiff") != nullptr, "GTiff driver missing");
+    Check(!IsPluginLoaded(),
+          "plugin loaded by GDALGetDriverByName() of a built-in driver");
+
+    GDALDatasetH hDS = GDALOpenEx("../gcore/data/byte.tif", GDAL_OF_RASTER,
+                                  nullptr, nullptr, nullptr);
+    Check(hDS != nullptr, "cannot open ../gcore/data/byte.tif");
+    GDALClose(hDS);
+    Check(!IsPluginLoaded(),
+          "plugin loaded when opening a file handled by a built-in driver");
+
+    // Only the plugin recognizes this name: it must be loaded on demand.
+    if( bIdentify )
+    {
+        GDALDriverH hDrv = GDALIdentifyDriverEx("DEFERREDTEST:foo",
+                                                GDAL_OF_RASTER,
+                                                nullptr, nullptr);
+        Check(IsPluginLoaded(), "plugin not loaded by GDALIdentifyDriverEx()");
+        Check(hDrv != nullptr &&
+              EQUAL(GDALGetDriverShortName(hDrv), "DEFERREDTEST"),
+              "DEFERREDTEST:foo not identified by the plugin driver");
+    }
+    else
+    {
+        hDS = GDALOpenEx("DEFERREDTEST:foo", GDAL_OF_RASTER,
+                         nullptr, nullptr, nullptr);
+        Check(IsPluginLoaded(), "plugin not loaded by GDALOpenEx()");
+        Check(hDS != nullptr, "cannot open DEFERREDTEST:foo");
+        GDALClose(hDS);
+    }
+
+    Check(GDALGetDriverByName("DEFERREDTEST") != nullptr,
+          "DEFERREDTEST driver not registered");
+
+    GDALDestroyDriverManager();
+    printf("success\n");
+    return 0;
+}
@@ -709,3 +709,75 @@ def test_gdal_EscapeString_errors():
 
     # Allocation will be > 4 GB
     assert gdal.EscapeString( b'"' * (((1 << 32)-1) // 6 + 1), gdal.CPLES_XML ) is None
+
+
+###############################################################################
+# Test GDAL_OPEN_PRIORITIZE_EXTENSION
+
+
+@pytest.mark.parametrize('prioritize', ['NO', 'YES'])
+def test_gdal_open_prioritize_extension(prioritize):
+
+    with gdaltest.config_option('GDAL_OPEN_PRIORITIZE_EXTENSION', prioritize):
+        ds = gdal.Open('data/byte.tif')
+        assert ds.GetDriver().ShortName == 'GTiff'
+
+        # The drivers declaring the extension fail, and the others are probed
+        gdal.FileFromMemBuffer('/vsimem/byte.img', open('data/byte.tif', 'rb').read())
+        ds = gdal.Open('/vsimem/byte.img')
+        assert ds.GetDriver().ShortName == 'GTiff'
+        ds = None
+        gdal.Unlink('/vsimem/byte.img')
+
+        assert gdal.OpenEx('data/byte.tif', gdal.OF_VECTOR) is None
+
+        # The index of drivers follows the driver list
+        drv = gdal.GetDriverByName('GTiff')
+        drv.Deregister()
+        try:
+            with gdaltest.error_handler():
+                assert gdal.Open('data/byte.tif') is None or \
+                    gdal.Open('data/byte.tif').GetDriver().ShortName != 'GTiff'
+        finally:
+            drv.Register()
+        assert gdal.Open('data/byte.tif').GetDriver().ShortName == 'GTiff'
+
+
+###############################################################################
+# Test GDAL_SIBLING_FILES_CACHE_SIZE
+
+
+def test_gdal_sibling_files_cache():
+
+    dirname = '/vsimem/test_gdal_sibling_files_cache'
+    filename = dirname + '/test.tif'
+    gdal.GetDriverByName('GTiff').Create(filename, 1, 1)
+
+    def get_gt():
+        ds = gdal.Open(filename)
+        ds.GetFileList()
+        return ds.GetGeoTransform(can_return_null=True)
+
+    try:
+        with gdaltest.config_option('GDAL_SIBLING_FILES_CACHE_SIZE', '10'):
+            assert get_gt() is None
+
+            # The cached directory listing does not know about the new file
+            gdal.FileFromMemBuffer(dirname + '/test.tfw', '2\n0\n0\n-2\n10\n20\n')
+            assert get_gt() is None
+
+            # Expired cache entry
+            with gdaltest.config_option('GDAL_SIBLING_FILES_CACHE_TTL', '-1'):
+                assert get_gt() == (9, 2, 0, 21, 0, -2)
+
+            # Creating a dataset invalidates the listing of its directory
+            gdal.Unlink(dirname + '/test.tfw')
+            assert get_gt() == (9, 2, 0, 21, 0, -2)
+            gdal.GetDriverByName('GTiff').Create(dirname + '/other.tif', 1, 1)
+            assert get_gt() is None
+
+        # Cache disabled
+        gdal.FileFromMemBuffer(dirname + '/test.tfw', '2\n0\n0\n-2\n10\n20\n')
+        assert get_gt() == (9, 2, 0, 21, 0, -2)
+    finally:
+        gdal.RmdirRecursive(dirname)
@@ -1074,3 +1074,38 @@ def test_cog_copy_xmp():
     _check_cog(filename)
 
     gdal.Unlink(filename)
+
+###############################################################################
+# Test that temporary overviews stored in memory or on disk give the same result
+
+
+@pytest.mark.parametrize('max_mem', ['0', '100'])
+def test_cog_tmp_overview_max_mem(max_mem):
+
+    directory = '/vsimem/test_cog_tmp_overview_max_mem'
+    filename = directory + '/cog.tif'
+    src_ds = gdal.Translate('', 'data/byte.tif',
+                            options='-of MEM -outsize 2048 300 -b 1 -mask 1')
+
+    with gdaltest.config_option('COG_TMP_OVERVIEW_MAX_MEM', max_mem):
+        ds = gdal.GetDriverByName('COG').CreateCopy(filename, src_ds)
+    assert ds
+    assert len(gdal.ReadDir(directory)) == 1 # check that the temp file has gone away
+    ds = None
+
+    with gdaltest.config_option('COG_TMP_OVERVIEW_MAX_MEM', '0'):
+        ref_ds = gdal.GetDriverByName('COG').CreateCopy('/vsimem/ref_cog.tif', src_ds)
+    ds = gdal.Open(filename)
+    assert ds.GetRasterBand(1).GetOverviewCount() == 2
+    for i in range(2):
+        assert ds.GetRasterBand(1).GetOverview(i).Checksum() == \
+            ref_ds.GetRasterBand(1).GetOverview(i).Checksum()
+        assert ds.GetRasterBand(1).GetMaskBand().GetOverview(i).Checksum() == \
+            ref_ds.GetRasterBand(1).GetMaskBand().GetOverview(i).Checksum()
+    ds = None
+    ref_ds = None
+    _check_cog(filename)
+
+    gdal.GetDriverByName('GTiff').Delete('/vsimem/ref_cog.tif')
+    gdal.GetDriverByName('GTiff').Delete(filename)
+    gdal.Unlink(directory)
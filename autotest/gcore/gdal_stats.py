@@ -717,3 +717,33 @@ def test_stats_clear():
     assert ds.GetRasterBand(1).GetStatistics(False, False) == [0,0,0,-1]
 
     gdal.GetDriverByName('GTiff').Delete(filename)
+
+###############################################################################
+# Test multi-threaded computation of statistics
+
+
+@pytest.mark.parametrize('datatype', [gdal.GDT_Int16, gdal.GDT_Int32, gdal.GDT_Float32, gdal.GDT_Float64])
+def test_stats_num_threads(datatype):
+
+    src_ds = gdal.Open('data/utmsmall.tif')
+    filename = '/vsimem/stats_num_threads.tif'
+    gdal.Translate(filename, src_ds, outputType=datatype,
+                   creationOptions=['TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16'])
+
+    ds = gdal.Open(filename)
+    ds.GetRasterBand(1).SetNoDataValue(107)
+    expected_stats = ds.GetRasterBand(1).ComputeStatistics(False)
+    ds = None
+
+    for num_threads in ('2', 'ALL_CPUS'):
+        ds = gdal.Open(filename)
+        ds.GetRasterBand(1).SetNoDataValue(107)
+        with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+            stats = ds.GetRasterBand(1).ComputeStatistics(False)
+        assert stats[0] == expected_stats[0]
+        assert stats[1] == expected_stats[1]
+        assert stats[2] == pytest.approx(expected_stats[2], rel=1e-12)
+        assert stats[3] == pytest.approx(expected_stats[3], rel=1e-12)
+        ds = None
+
+    gdal.GetDriverByName('GTiff').Delete(filename)
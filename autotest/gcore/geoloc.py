@@ -106,3 +106,56 @@ def test_geoloc_fill_line():
     warped_ds = gdal.Warp('', ds, format='MEM')
     assert warped_ds
     assert warped_ds.GetRasterBand(1).Checksum() == 25798
+
+
+###############################################################################
+# Test that the tiled backmap, built lazily and in parallel, gives the same
+# results as the full backmap
+
+
+def test_geoloc_tiled_backmap():
+
+    lon_ds = gdal.GetDriverByName('GTiff').Create('/vsimem/lon.tif', 300, 300, 1, gdal.GDT_Float64)
+    lon_ds.WriteRaster(0, 0, 300, 300, array.array('d', [-10 + 0.01 * x + 0.002 * y for y in range(300) for x in range(300)]))
+    lon_ds = None
+
+    lat_ds = gdal.GetDriverByName('GTiff').Create('/vsimem/lat.tif', 300, 300, 1, gdal.GDT_Float64)
+    lat_ds.WriteRaster(0, 0, 300, 300, array.array('d', [50 - 0.01 * y + 0.001 * x for y in range(300) for x in range(300)]))
+    lat_ds = None
+
+    ds = gdal.GetDriverByName('MEM').Create('', 300, 300)
+    md = {
+        'LINE_OFFSET': '0',
+        'LINE_STEP': '1',
+        'PIXEL_OFFSET': '0',
+        'PIXEL_STEP': '1',
+        'X_DATASET': '/vsimem/lon.tif',
+        'X_BAND' : '1',
+        'Y_DATASET': '/vsimem/lat.tif',
+        'Y_BAND' : '1',
+        'SRS': 'EPSG:4326'
+    }
+    ds.SetMetadata(md, 'GEOLOCATION')
+
+    points = [(x + 0.5, y + 0.5) for y in range(3, 297, 7) for x in range(3, 297, 7)]
+    tr = gdal.Transformer(ds, None, [])
+    geo_points = [tr.TransformPoint(0, x, y)[1] for (x, y) in points]
+
+    def inverse_transform():
+        tr = gdal.Transformer(ds, None, [])
+        return tr.TransformPoints(1, geo_points)
+
+    ref_points, ref_success = inverse_transform()
+    with gdaltest.config_options({'GDAL_GEOLOC_TILED_BACKMAP': 'YES',
+                                  'GDAL_NUM_THREADS': '4'}):
+        got_points, got_success = inverse_transform()
+
+    gdal.Unlink('/vsimem/lon.tif')
+    gdal.Unlink('/vsimem/lat.tif')
+
+    assert got_success == ref_success
+    for (x, y), ref, got in zip(points, ref_points, got_points):
+        assert got[0] == pytest.approx(ref[0], abs=1e-2), (x, y)
+        assert got[1] == pytest.approx(ref[1], abs=1e-2), (x, y)
+        assert got[0] == pytest.approx(x, abs=0.5), (x, y)
+        assert got[1] == pytest.approx(y, abs=0.5), (x, y)
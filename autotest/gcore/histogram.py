@@ -34,6 +34,8 @@ import shutil
 
 
 from osgeo import gdal
+import gdaltest
+import pytest
 
 
 ###############################################################################
@@ -128,3 +130,41 @@ def test_histogram_6():
 
 
 
+###############################################################################
+# Test that GetDefaultHistogram() on a 16 bit band without statistics
+# computes the statistics and the histogram in the same pass.
+
+
+@pytest.mark.parametrize('num_threads', ['1', '2'])
+@pytest.mark.parametrize('datatype', [gdal.GDT_Int16, gdal.GDT_UInt16])
+def test_histogram_default_one_pass(num_threads, datatype):
+
+    src_ds = gdal.Open('data/utmsmall.tif')
+    ds = gdal.Translate('', src_ds, format='MEM', outputType=datatype)
+    ds.GetRasterBand(1).SetNoDataValue(107)
+
+    with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+        hist = ds.GetRasterBand(1).GetDefaultHistogram(force=1)
+    assert hist is not None
+
+    # Statistics are exact and have been set on the band
+    assert ds.GetRasterBand(1).GetMetadataItem('STATISTICS_APPROXIMATE') is None
+    stats = ds.GetRasterBand(1).GetStatistics(False, False)
+
+    ref_ds = gdal.Translate('', src_ds, format='MEM', outputType=datatype)
+    ref_ds.GetRasterBand(1).SetNoDataValue(107)
+    expected_stats = ref_ds.GetRasterBand(1).ComputeStatistics(False)
+    assert stats[0] == expected_stats[0]
+    assert stats[1] == expected_stats[1]
+    assert stats[2] == pytest.approx(expected_stats[2], rel=1e-10)
+    assert stats[3] == pytest.approx(expected_stats[3], rel=1e-10)
+
+    half_bucket = (stats[1] - stats[0]) / (2 * 255)
+    assert hist[0] == stats[0] - half_bucket
+    assert hist[1] == stats[1] + half_bucket
+    assert hist[2] == 256
+    expected_hist = ref_ds.GetRasterBand(1).GetHistogram(hist[0], hist[1], 256,
+                                                         include_out_of_range=1,
+                                                         approx_ok=0)
+    assert hist[3] == expected_hist
+
@@ -370,3 +370,49 @@ def test_multidim_getresampled_bad_input_dim_count():
         resampled_ar = ar.GetResampled([None, None, None], gdal.GRIORA_NearestNeighbour, None)
         assert resampled_ar is None
 
+
+
+@pytest.mark.parametrize("num_threads", ['1', '2'])
+def test_multidim_getreduction(num_threads):
+
+    drv = gdal.GetDriverByName('MEM')
+    mem_ds = drv.CreateMultiDimensional('myds')
+    rg = mem_ds.GetRootGroup()
+    dimT = rg.CreateDimension('time', None, None, 3)
+    dimY = rg.CreateDimension('Y', None, None, 2)
+    dimX = rg.CreateDimension('X', None, None, 2)
+    ar = rg.CreateMDArray("ar", [dimT, dimY, dimX],
+                          gdal.ExtendedDataType.Create(gdal.GDT_Int16))
+    assert ar.SetNoDataValueDouble(-1) == gdal.CE_None
+    assert ar.Write(array.array('h', [1, 2, -1, 4,
+                                      3, 6, -1, 0,
+                                      5, 1, -1, 2])) == gdal.CE_None
+
+    def read(operation, **kwargs):
+        red = ar.GetReduction(operation, 0)
+        assert red
+        assert [dim.GetName() for dim in red.GetDimensions()] == ['Y', 'X']
+        assert red.GetDataType().GetNumericDataType() == gdal.GDT_Float64
+        return list(array.array('d', red.Read(**kwargs)))
+
+    # GDAL_SWATH_SIZE set so that the time dimension is read in several slabs
+    with gdaltest.config_options({'GDAL_NUM_THREADS': num_threads,
+                                  'GDAL_SWATH_SIZE': '64'}):
+        assert read('MEAN')[0:2] == [3.0, 3.0]
+        assert read('MEAN')[3] == 2.0
+        assert read('MIN')[0:2] == [1.0, 1.0]
+        assert read('MAX')[0:2] == [5.0, 6.0]
+        assert read('SUM') == [9.0, 9.0, 0.0, 6.0]
+        assert read('COUNT') == [3.0, 3.0, 0.0, 3.0]
+        # All values invalid: nodata (NaN)
+        assert read('MEAN')[2] != read('MEAN')[2]
+        # Subset and step
+        assert read('SUM', array_start_idx=[0, 1], count=[2, 1],
+                    array_step=[1, -1]) == [9.0, 6.0]
+
+    red = ar.GetReduction('count', 1)
+    assert [dim.GetName() for dim in red.GetDimensions()] == ['time', 'X']
+
+    with gdaltest.error_handler():
+        assert ar.GetReduction('invalid', 0) is None
+        assert ar.GetReduction('MEAN', 3) is None
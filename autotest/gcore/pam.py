@@ -535,6 +535,37 @@ def test_pam_metadata_coordinate_epoch():
 
     gdal.GetDriverByName('PNM').Delete(tmpfilename)
 
+###############################################################################
+# Test GDAL_PAM_LAZY_LOADING
+
+
+def test_pam_lazy_loading():
+
+    tmpfilename = '/vsimem/tmp_lazy.pnm'
+    ds = gdal.GetDriverByName('PNM').Create(tmpfilename, 1, 1)
+    ds.SetMetadataItem('FOO', 'BAR')
+    ds.GetRasterBand(1).SetOffset(1.5)
+    ds = None
+
+    with gdaltest.config_option('GDAL_PAM_LAZY_LOADING', 'YES'):
+        ds = gdal.Open(tmpfilename)
+        assert ds.GetRasterBand(1).GetOffset() == 1.5
+        assert ds.GetMetadataItem('FOO') == 'BAR'
+        ds = None
+
+        # Modify before the .aux.xml is read: existing content must be kept
+        ds = gdal.Open(tmpfilename)
+        ds.SetMetadataItem('BAR', 'BAZ')
+        ds = None
+
+    ds = gdal.Open(tmpfilename)
+    assert ds.GetMetadataItem('FOO') == 'BAR'
+    assert ds.GetMetadataItem('BAR') == 'BAZ'
+    assert ds.GetRasterBand(1).GetOffset() == 1.5
+    ds = None
+
+    gdal.GetDriverByName('PNM').Delete(tmpfilename)
+
 ###############################################################################
 # Cleanup.
 
@@ -721,3 +721,110 @@ def test_pixfun_interpolate_linear():
     assert np.allclose(interpolated, layers[0]*np.exp(np.log(layers[1]/layers[0])/1 * (-22.7 - -10)))
 
 ###############################################################################
+# Verify evaluation of expressions
+
+def expression_vrt(*, fname, bands, nx, ny, expression, datatype='Float32',
+                   extra_args=''):
+    vrtXml = """
+    <VRTDataset rasterXSize="{nx}" rasterYSize="{ny}">
+      <VRTRasterBand dataType="{datatype}" band="1" subClass="VRTDerivedRasterBand">
+        <PixelFunctionType>expression</PixelFunctionType>
+        <PixelFunctionArguments expression="{expression}" {extra_args} />""".format(
+            nx=nx, ny=ny, datatype=datatype, extra_args=extra_args,
+            expression=expression.replace('&', '&amp;').replace('<', '&lt;').replace('>', '&gt;'))
+
+    for b in range(1, bands + 1):
+        vrtXml += """
+         <SimpleSource>
+          <SourceFilename relativeToVRT="0">{fname}</SourceFilename>
+          <SourceBand>{band}</SourceBand>
+          <SrcRect xOff="0" yOff="0" xSize="{nx}" ySize="{ny}"/>
+          <DstRect xOff="0" yOff="0" xSize="{nx}" ySize="{ny}"/>
+        </SimpleSource>
+        """.format(fname=fname, band=b, nx=nx, ny=ny)
+
+    vrtXml += """
+    </VRTRasterBand>
+    </VRTDataset>
+    """
+
+    return vrtXml
+
+
+def test_pixfun_expression():
+
+    # Wider than the evaluation chunk size
+    nx = 300
+    ny = 3
+    b1 = (numpy.arange(nx * ny) % 7).reshape(ny, nx)
+    b2 = (numpy.arange(nx * ny) % 5).reshape(ny, nx)
+
+    fname = '/vsimem/test_pixfun_expression.tif'
+    ds = gdal.GetDriverByName('GTiff').Create(fname, nx, ny, 2, gdal.GDT_Int16)
+    ds.GetRasterBand(1).WriteArray(b1)
+    ds.GetRasterBand(2).WriteArray(b2)
+    ds = None
+
+    def read(expression, **kwargs):
+        ds = gdal.Open(expression_vrt(fname=fname, bands=2, nx=nx, ny=ny,
+                                      expression=expression, **kwargs))
+        assert ds is not None
+        return ds.GetRasterBand(1).ReadAsArray()
+
+    with numpy.errstate(divide='ignore', invalid='ignore'):
+        ndvi = (b2 - b1) / (b2 + b1)
+
+    data = read('(B2 - B1) / (B2 + B1)', datatype='Float64')
+    assert numpy.array_equal(numpy.isnan(data), numpy.isnan(ndvi))
+    assert numpy.allclose(data[~numpy.isnan(data)], ndvi[~numpy.isnan(ndvi)])
+
+    # Pixels where a source is nodata, or the result is NaN, are nodata
+    data = read('(B2 - B1) / (B2 + B1)', datatype='Float64',
+                extra_args='nodata="0"')
+    expected = numpy.where((b1 == 0) | (b2 == 0), 0, ndvi)
+    assert numpy.allclose(data, expected)
+
+    # Conversion to the band data type
+    data = read('B1 * 100 - 50', datatype='Byte')
+    assert numpy.array_equal(data, numpy.clip(b1 * 100 - 50, 0, 255))
+
+    data = read('B1 > 2 && B2 != 0 ? sqrt(B1) : -max(B1, B2) ^ 2')
+    expected = numpy.where((b1 > 2) & (b2 != 0), numpy.sqrt(b1),
+                           -numpy.maximum(b1, b2) ** 2)
+    assert numpy.allclose(data, expected)
+
+    # Invalid expressions
+    for expression in ['B3', 'B1 +', 'foo(B1)', '(B1', 'B1 B2']:
+        with gdaltest.error_handler():
+            assert read(expression) is None
+
+    gdal.Unlink(fname)
+
+###############################################################################
+
+
+def test_pixfun_multithreaded():
+
+    # Large enough for the rows to be split between several threads
+    nx = 1000
+    ny = 400
+    b1 = (numpy.arange(nx * ny) % 7).reshape(ny, nx)
+    b2 = (numpy.arange(nx * ny) % 5).reshape(ny, nx)
+
+    fname = '/vsimem/test_pixfun_multithreaded.tif'
+    ds = gdal.GetDriverByName('GTiff').Create(fname, nx, ny, 2, gdal.GDT_Int16)
+    ds.GetRasterBand(1).WriteArray(b1)
+    ds.GetRasterBand(2).WriteArray(b2)
+    ds = None
+
+    vrt = expression_vrt(fname=fname, bands=2, nx=nx, ny=ny,
+                         expression='B1 * B2 - B1')
+    ds = gdal.OpenEx(vrt, open_options=['NUM_THREADS=4'])
+    data = ds.GetRasterBand(1).ReadAsArray()
+    assert numpy.array_equal(data, b1 * b2 - b1)
+    # Output buffer of another data type
+    data = ds.GetRasterBand(1).ReadAsArray(buf_type=gdal.GDT_Float64)
+    assert numpy.array_equal(data, b1 * b2 - b1)
+    ds = None
+
+    gdal.Unlink(fname)
@@ -1127,6 +1127,82 @@ def test_rasterio_average_halfsize_downsampling_uint16():
     ovr_data = ds.GetRasterBand(1).GetOverview(0).ReadRaster()
     assert ovr_data == data
 
+###############################################################################
+# Test average downsampling by integer factors larger than 2 on exact boundaries
+
+
+@pytest.mark.parametrize("datatype,fmt,maxval", [(gdal.GDT_Byte, 'B', 255),
+                                                 (gdal.GDT_UInt16, 'H', 65535)])
+@pytest.mark.parametrize("xfactor,yfactor", [(4, 4), (3, 5)])
+def test_rasterio_average_integer_factor_downsampling(datatype, fmt, maxval,
+                                                      xfactor, yfactor):
+
+    dst_xsize = 19
+    dst_ysize = 3
+    xsize = dst_xsize * xfactor
+    ysize = dst_ysize * yfactor
+    values = [((x * 7 + y * 13) * 37) % (maxval + 1) for y in range(ysize) for x in range(xsize)]
+
+    ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize, 1, datatype)
+    ds.WriteRaster(0, 0, xsize, ysize, struct.pack(fmt * xsize * ysize, *values))
+
+    weight = xfactor * yfactor
+    expected = []
+    for j in range(dst_ysize):
+        for i in range(dst_xsize):
+            total = 0
+            for y in range(j * yfactor, (j + 1) * yfactor):
+                for x in range(i * xfactor, (i + 1) * xfactor):
+                    total += values[y * xsize + x]
+            expected.append((total + weight // 2) // weight)
+
+    data = ds.GetRasterBand(1).ReadRaster(0, 0, xsize, ysize, dst_xsize, dst_ysize,
+                                          resample_alg=gdal.GRIORA_Average)
+    assert list(struct.unpack(fmt * dst_xsize * dst_ysize, data)) == expected
+
+###############################################################################
+# Test nearest and average (with nodata) overviews by integer factors
+
+
+@pytest.mark.parametrize("datatype,fmt", [(gdal.GDT_Byte, 'B'),
+                                          (gdal.GDT_Int16, 'h'),
+                                          (gdal.GDT_UInt16, 'H'),
+                                          (gdal.GDT_Float32, 'f')])
+@pytest.mark.parametrize("factor", [2, 3, 4])
+def test_rasterio_overview_integer_factor_nearest_and_average_nodata(datatype, fmt, factor):
+
+    nodata = 0
+    dst_xsize = 37
+    dst_ysize = 3
+    xsize = dst_xsize * factor
+    ysize = dst_ysize * factor
+    values = [((x * 7 + y * 13) * 37) % 100 for y in range(ysize) for x in range(xsize)]
+
+    ds = gdal.GetDriverByName('MEM').Create('', xsize, ysize, 1, datatype)
+    ds.WriteRaster(0, 0, xsize, ysize, struct.pack(fmt * xsize * ysize, *values))
+    ds.GetRasterBand(1).SetNoDataValue(nodata)
+
+    ds.BuildOverviews('NEAR', [factor])
+    data = ds.GetRasterBand(1).GetOverview(0).ReadRaster()
+    expected = [values[j * factor * xsize + i * factor] for j in range(dst_ysize) for i in range(dst_xsize)]
+    assert list(struct.unpack(fmt * dst_xsize * dst_ysize, data)) == expected
+
+    ds.BuildOverviews('AVERAGE', [factor])
+    data = ds.GetRasterBand(1).GetOverview(0).ReadRaster()
+    got = struct.unpack(fmt * dst_xsize * dst_ysize, data)
+    for j in range(dst_ysize):
+        for i in range(dst_xsize):
+            valid = [values[y * xsize + x]
+                     for y in range(j * factor, (j + 1) * factor)
+                     for x in range(i * factor, (i + 1) * factor)
+                     if values[y * xsize + x] != nodata]
+            if not valid:
+                assert got[j * dst_xsize + i] == nodata
+            elif datatype == gdal.GDT_Float32:
+                assert got[j * dst_xsize + i] == pytest.approx(sum(valid) / len(valid), rel=1e-6)
+            else:
+                assert got[j * dst_xsize + i] == int(sum(valid) / len(valid) + 0.5)
+
 ###############################################################################
 # Test average downsampling by a factor of 2 on exact boundaries, with float32 data type
 
@@ -1484,3 +1560,34 @@ def test_rasterio_readraster_in_existing_buffer_alignment_issues(datatype):
     with gdaltest.error_handler():
         # buf_obj has not appropriate alignment
         assert band.ReadBlock(0, 0, buf_obj = memoryview(bytearray([0] * (2 * 8 + 1)))[1:]) is None
+
+###############################################################################
+# Test reading whole blocks directly into the user buffer
+
+
+def test_rasterio_direct_read_whole_blocks():
+
+    filename = '/vsimem/test_rasterio_direct_read_whole_blocks.tif'
+    ds = gdal.GetDriverByName('GTiff').Create(filename, 32, 40, 1,
+                                              options=['TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16'])
+    ds.GetRasterBand(1).WriteRaster(0, 0, 32, 40, bytearray([i % 251 for i in range(32 * 40)]))
+    ds = None
+
+    ds = gdal.Open(filename, gdal.GA_Update)
+    band = ds.GetRasterBand(1)
+    ref = [band.ReadRaster(0, 0, 16, 32), band.ReadRaster(16, 0, 16, 32),
+           band.ReadRaster(0, 16, 16, 24)]
+    band.FlushCache()
+
+    with gdaltest.config_option('GDAL_RASTERIO_DIRECT_READ', 'YES'):
+        assert band.ReadRaster(0, 0, 16, 32) == ref[0]
+        assert band.ReadRaster(16, 0, 16, 32) == ref[1]
+        # Partial block at bottom: regular code path
+        assert band.ReadRaster(0, 16, 16, 24) == ref[2]
+
+        # Modified blocks in cache must be honoured
+        band.WriteRaster(0, 0, 1, 1, b'\x00')
+        assert band.ReadRaster(0, 0, 16, 32) == b'\x00' + ref[0][1:]
+    ds = None
+
+    gdal.Unlink(filename)
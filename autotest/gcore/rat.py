@@ -179,4 +179,63 @@ def test_rat_4():
 
     gdal.GetDriverByName('GTiff').Delete('/vsimem/rat_4.tif')
 
-##############################################################################
+###############################################################################
+# Test GetRowOfValue() on the various table layouts, and string columns
+
+
+def test_rat_5():
+
+    # Discrete values, not sorted, with duplicates
+    rat = gdal.RasterAttributeTable()
+    rat.CreateColumn('VALUE', gdal.GFT_Integer, gdal.GFU_MinMax)
+    rat.CreateColumn('CLASS', gdal.GFT_String, gdal.GFU_Name)
+    values = [5, 3, 9, 3, 1]
+    for i, v in enumerate(values):
+        rat.SetValueAsInt(i, 0, v)
+        rat.SetValueAsString(i, 1, 'class%d' % (v % 2))
+    assert rat.GetRowOfValue(5) == 0
+    assert rat.GetRowOfValue(3) == 1
+    assert rat.GetRowOfValue(1.0) == 4
+    assert rat.GetRowOfValue(2) == -1
+    assert rat.GetRowOfValue(10) == -1
+    rat.SetValueAsInt(1, 0, 2)
+    assert rat.GetRowOfValue(3) == 3
+    assert rat.GetRowOfValue(2) == 1
+    assert [rat.GetValueAsString(i, 1) for i in range(5)] == \
+        ['class1', 'class1', 'class1', 'class1', 'class1']
+    rat.SetValueAsString(2, 1, '')
+    rat.SetValueAsString(3, 1, 'other')
+    assert [rat.GetValueAsString(i, 1) for i in range(5)] == \
+        ['class1', 'class1', '', 'other', 'class1']
+
+    # Sorted, non overlapping, ranges
+    rat = gdal.RasterAttributeTable()
+    rat.CreateColumn('MIN', gdal.GFT_Real, gdal.GFU_Min)
+    rat.CreateColumn('MAX', gdal.GFT_Real, gdal.GFU_Max)
+    for i in range(100):
+        rat.SetValueAsDouble(i, 0, i * 10)
+        rat.SetValueAsDouble(i, 1, i * 10 + 5)
+    assert rat.GetRowOfValue(0) == 0
+    assert rat.GetRowOfValue(5) == 0
+    assert rat.GetRowOfValue(7) == -1
+    assert rat.GetRowOfValue(995) == 99
+    assert rat.GetRowOfValue(-1) == -1
+    assert rat.GetRowOfValue(1000) == -1
+
+    # Overlapping ranges: first matching row
+    rat.SetValueAsDouble(50, 0, 0)
+    assert rat.GetRowOfValue(3) == 0
+    assert rat.GetRowOfValue(493) == 49
+    assert rat.GetRowOfValue(502) == 50
+
+    # Many distinct strings
+    rat = gdal.RasterAttributeTable()
+    rat.CreateColumn('NAME', gdal.GFT_String, gdal.GFU_Name)
+    for i in range(10000):
+        rat.SetValueAsString(i, 0, 'name%d' % i)
+    for i in range(10000):
+        rat.SetValueAsString(i, 0, 'other%d' % i)
+    assert rat.GetValueAsString(0, 0) == 'other0'
+    assert rat.GetValueAsString(9999, 0) == 'other9999'
+    rat2 = rat.Clone()
+    assert rat2.GetValueAsString(1234, 0) == 'other1234'
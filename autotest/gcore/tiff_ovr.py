@@ -2011,6 +2011,66 @@ def test_tiff_ovr_nodata_multiband_interleave_band_non_default_color_interp(exte
 
     gdal.GetDriverByName('GTiff').Delete(temp_path)
 
+###############################################################################
+# Test that computing several levels in one pass gives the same result
+
+
+@pytest.mark.parametrize("resampling,datatype",
+                         [('NEAREST', gdal.GDT_Byte),
+                          ('AVERAGE', gdal.GDT_Byte),
+                          ('AVERAGE', gdal.GDT_Int16),
+                          ('RMS', gdal.GDT_UInt16)])
+def test_tiff_ovr_one_pass(resampling, datatype):
+
+    src_ds = gdal.Translate('', 'data/byte.tif',
+                            options='-of MEM -outsize 2048 1024 -r bilinear '
+                                    '-b 1 -b 1 -b 1 -ot ' +
+                                    gdal.GetDataTypeName(datatype))
+    checksums = []
+    for one_pass in ('NO', 'YES'):
+        temp_path = '/vsimem/test_tiff_ovr_one_pass_%s.tif' % one_pass
+        ds = gdal.GetDriverByName('GTiff').CreateCopy(temp_path, src_ds)
+        with gdaltest.config_options({'GDAL_OVR_ONE_PASS': one_pass,
+                                      'GDAL_OVR_ONE_PASS_MAX_MEM': '64'}):
+            assert ds.BuildOverviews(resampling, overviewlist=[2, 4, 8, 32]) == 0
+        ds = None
+        ds = gdal.Open(temp_path)
+        checksums.append([[ds.GetRasterBand(i+1).GetOverview(j).Checksum()
+                           for j in range(4)] for i in range(3)])
+        ds = None
+        gdal.GetDriverByName('GTiff').Delete(temp_path)
+
+    assert checksums[0] == checksums[1]
+
+###############################################################################
+# Test that overview chunks of a sparse file without data are skipped
+
+
+def test_tiff_ovr_skip_empty_chunks():
+
+    temp_path = '/vsimem/test_tiff_ovr_skip_empty_chunks.tif'
+    ds = gdal.GetDriverByName('GTiff').Create(
+        temp_path, 2048, 1024, 1, options=['TILED=YES', 'SPARSE_OK=YES'])
+    ds.GetRasterBand(1).SetNoDataValue(0)
+    ds.GetRasterBand(1).WriteRaster(256, 256, 512, 256, b'\x7f' * (512 * 256))
+    ds = None
+
+    checksums = []
+    for skip in ('NO', 'YES'):
+        ds = gdal.Open(temp_path)
+        with gdaltest.config_option('GDAL_OVR_SKIP_EMPTY_CHUNKS', skip):
+            assert ds.BuildOverviews('AVERAGE', overviewlist=[2, 4]) == 0
+        ds = None
+        ds = gdal.Open(temp_path)
+        checksums.append([ds.GetRasterBand(1).GetOverview(i).Checksum()
+                          for i in range(2)])
+        ds = None
+        gdal.Unlink(temp_path + '.ovr')
+
+    gdal.GetDriverByName('GTiff').Delete(temp_path)
+
+    assert checksums[0] == checksums[1]
+
 ###############################################################################
 # Cleanup
 
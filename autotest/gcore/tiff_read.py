@@ -28,6 +28,7 @@
 ###############################################################################
 
 import os
+import random
 import sys
 import shutil
 import struct
@@ -1115,6 +1116,89 @@ def test_tiff_read_vsicurl_multirange():
 
         gdal.VSICurlClearCache()
 
+###############################################################################
+# Test that Dataset.ReadRasterBatch() on /vsicurl fetches the tiles of all
+# windows with a single multi-range request, which is kept for all windows
+
+
+def test_tiff_read_vsicurl_read_raster_batch():
+
+    if gdal.GetDriverByName('HTTP') is None:
+        pytest.skip()
+
+    src_ds = gdal.GetDriverByName('MEM').Create('', 256, 256)
+    src_ds.GetRasterBand(1).WriteRaster(
+        0, 0, 256, 256, bytes([(i * 7) % 251 for i in range(256 * 256)]))
+    gdal.GetDriverByName('GTiff').CreateCopy(
+        '/vsimem/read_raster_batch.tif', src_ds,
+        options=['TILED=YES', 'BLOCKXSIZE=64', 'BLOCKYSIZE=64'])
+    f = gdal.VSIFOpenL('/vsimem/read_raster_batch.tif', 'rb')
+    filedata = gdal.VSIFReadL(1, 1000000, f)
+    gdal.VSIFCloseL(f)
+
+    # Tiles (0,0), (2,2) and (3,3): none of them is stored right after
+    # another one, so each is fetched with its own range
+    windows = [(0, 0, 64, 64), (130, 140, 50, 40), (200, 192, 56, 64)]
+    local_ds = gdal.Open('/vsimem/read_raster_batch.tif')
+    tile_ranges = []
+    for (x, y) in [(0, 0), (2, 2), (3, 3)]:
+        offset = int(local_ds.GetRasterBand(1).GetMetadataItem(
+            'BLOCK_OFFSET_%d_%d' % (x, y), 'TIFF'))
+        tile_ranges.append('bytes=%d-%d' % (offset, offset + 64 * 64 - 1))
+    expected = [local_ds.ReadRaster(*w) for w in windows]
+    local_ds = None
+    gdal.Unlink('/vsimem/read_raster_batch.tif')
+
+    class RecordingHandler(object):
+        def __init__(self):
+            self.ranges = []
+
+        def final_check(self):
+            pass
+
+        def do_HEAD(self, request):
+            request.send_response(200)
+            request.send_header('Content-Length', len(filedata))
+            request.end_headers()
+
+        def do_GET(self, request):
+            rng = request.headers['Range']
+            self.ranges.append(rng)
+            start = int(rng[len('bytes='):].split('-')[0])
+            end = min(int(rng[len('bytes='):].split('-')[1]), len(filedata) - 1)
+            request.protocol_version = 'HTTP/1.1'
+            request.send_response(206)
+            request.send_header('Content-type', 'application/octet-stream')
+            request.send_header('Content-Range', 'bytes %d-%d/%d' % (start, end, len(filedata)))
+            request.send_header('Content-Length', end - start + 1)
+            request.send_header('Connection', 'close')
+            request.end_headers()
+            request.wfile.write(filedata[start:end + 1])
+
+    (webserver_process, webserver_port) = webserver.launch(handler=webserver.DispatcherHttpHandler)
+    if webserver_port == 0:
+        pytest.skip()
+
+    gdal.VSICurlClearCache()
+
+    try:
+        handler = RecordingHandler()
+        with webserver.install_http_handler(handler):
+            with gdaltest.config_options({ 'CPL_VSIL_CURL_ALLOWED_EXTENSIONS': '.tif',
+                                           'GDAL_DISABLE_READDIR_ON_OPEN': 'EMPTY_DIR' }):
+                ds = gdal.Open('/vsicurl/http://127.0.0.1:%d/read_raster_batch.tif' % webserver_port)
+                assert ds is not None
+                got = ds.ReadRasterBatch(windows)
+                ds = None
+    finally:
+        webserver.server_stop(webserver_process, webserver_port)
+
+        gdal.VSICurlClearCache()
+
+    assert got == expected
+    for tile_range in tile_ranges:
+        assert handler.ranges.count(tile_range) == 1, (tile_range, handler.ranges)
+
 ###############################################################################
 # Test reading a TIFF made of a single-strip that is more than 2GB (#5403)
 
@@ -2444,6 +2528,74 @@ def test_tiff_read_corrupted_jpeg_cloud_optimized():
         pytest.fail(cs1)
 
 
+###############################################################################
+# Test the implicit overviews of JPEG-in-TIFF files with tiles of more than
+# 64 KB, whose JPEG decoder is reused from one tile to the next
+
+
+def test_tiff_read_jpeg_implicit_overviews_large_tiles():
+
+    md = gdal.GetDriverByName('GTiff').GetMetadata()
+    if md['DMD_CREATIONOPTIONLIST'].find('JPEG') == -1:
+        pytest.skip()
+
+    filename = '/vsimem/tiff_read_jpeg_implicit_overviews_large_tiles.tif'
+    tile_filename = '/vsimem/tiff_read_jpeg_implicit_overviews_large_tiles.jpg'
+    # Random values, so that tiles do not compress below 64 KB
+    rnd = random.Random(0)
+    data = rnd.getrandbits(8 * 1024 * 1024).to_bytes(1024 * 1024, 'little')
+    # JPEGTABLESMODE=0 so that each tile is a standalone JPEG file
+    ds = gdal.GetDriverByName('GTiff').Create(
+        filename, 1024, 1024, 1,
+        options=['COMPRESS=JPEG', 'JPEG_QUALITY=95', 'JPEGTABLESMODE=0',
+                 'TILED=YES', 'BLOCKXSIZE=512', 'BLOCKYSIZE=512'])
+    ds.WriteRaster(0, 0, 1024, 1024, data)
+    ds = None
+
+    tiles = [(x, y) for y in range(2) for x in range(2)]
+    try:
+        # Reference for full resolution blocks: without implicit overviews
+        with gdaltest.config_option('GTIFF_IMPLICIT_JPEG_OVR', 'NO'):
+            ds = gdal.Open(filename)
+            band = ds.GetRasterBand(1)
+            assert band.GetOverview(0) is None
+            ref_full = {}
+            for x, y in tiles:
+                ref_full[(x, y)] = band.ReadRaster(x * 512, y * 512, 512, 512)
+            ds = None
+
+        # Reference for decimated blocks: the tile decoded at 1/2 resolution
+        # by the JPEG driver on its own
+        ds = gdal.Open(filename)
+        band = ds.GetRasterBand(1)
+        ref_ovr = {}
+        f = gdal.VSIFOpenL(filename, 'rb')
+        for x, y in tiles:
+            offset = int(band.GetMetadataItem('BLOCK_OFFSET_%d_%d' % (x, y), 'TIFF'))
+            size = int(band.GetMetadataItem('BLOCK_SIZE_%d_%d' % (x, y), 'TIFF'))
+            assert size >= 65536
+            gdal.VSIFSeekL(f, offset, 0)
+            gdal.FileFromMemBuffer(tile_filename, gdal.VSIFReadL(1, size, f))
+            jpeg_ds = gdal.Open(tile_filename)
+            assert jpeg_ds.GetDriver().ShortName == 'JPEG'
+            ref_ovr[(x, y)] = jpeg_ds.GetRasterBand(1).GetOverview(0).ReadRaster()
+            jpeg_ds = None
+        gdal.VSIFCloseL(f)
+
+        # Visit the tiles in reverse order, then again in order, alternating
+        # decimated reads through the implicit overview and full resolution
+        # reads
+        for x, y in tiles[::-1] + tiles:
+            assert band.ReadRaster(x * 512, y * 512, 512, 512, 256, 256) == \
+                ref_ovr[(x, y)], (x, y)
+            assert band.ReadRaster(x * 512, y * 512, 512, 512) == \
+                ref_full[(x, y)], (x, y)
+        ds = None
+    finally:
+        gdal.Unlink(filename)
+        gdal.Unlink(tile_filename)
+
+
 ###############################################################################
 # Test reading YCbCr images with LZW compression
 
@@ -3519,3 +3671,93 @@ def test_tiff_read_overprecision_nodata_float32():
     assert struct.unpack('f', ds.GetRasterBand(1).ReadRaster())[0] == ds.GetRasterBand(1).GetNoDataValue()
     ds = None
     gdal.Unlink(filename)
+
+###############################################################################
+# Test multi-threaded decompression of blocks in RasterIO()
+
+
+@pytest.mark.parametrize('interleave,compress,datatype',
+                         [('BAND', 'DEFLATE', gdal.GDT_Byte),
+                          ('PIXEL', 'DEFLATE', gdal.GDT_Byte),
+                          ('PIXEL', 'LZW', gdal.GDT_UInt16),
+                          ('BAND', 'ZSTD', gdal.GDT_Float32)])
+def test_tiff_read_multithreaded_decompression(interleave, compress, datatype):
+
+    if compress not in gdal.GetDriverByName('GTiff').GetMetadataItem('DMD_CREATIONOPTIONLIST'):
+        pytest.skip()
+
+    filename = '/vsimem/test_tiff_read_multithreaded_decompression.tif'
+    src_ds = gdal.Translate('', 'data/rgbsmall.tif', format='MEM',
+                            outputType=datatype, width=200, height=150)
+    gdal.Translate(filename, src_ds,
+                   creationOptions=['TILED=YES', 'BLOCKXSIZE=32',
+                                    'BLOCKYSIZE=32', 'SPARSE_OK=YES',
+                                    'INTERLEAVE=' + interleave,
+                                    'COMPRESS=' + compress])
+
+    ds = gdal.Open(filename)
+    ref_data = ds.ReadRaster()
+    ref_band_data = ds.GetRasterBand(2).ReadRaster(3, 5, 190, 140)
+    ds = None
+
+    ds = gdal.OpenEx(filename, open_options=['NUM_THREADS=4'])
+    assert ds.ReadRaster() == ref_data
+    assert ds.GetRasterBand(2).ReadRaster(3, 5, 190, 140) == ref_band_data
+    ds = None
+
+    # Small cache size, so that requests are split in several chunks
+    with gdaltest.config_option('GDAL_NUM_THREADS', 'ALL_CPUS'):
+        oldSize = gdal.GetCacheMax()
+        gdal.SetCacheMax(100000)
+        try:
+            ds = gdal.Open(filename)
+            assert ds.ReadRaster() == ref_data
+            assert ds.GetRasterBand(2).ReadRaster(3, 5, 190, 140) == ref_band_data
+            ds = None
+        finally:
+            gdal.SetCacheMax(oldSize)
+
+    gdal.Unlink(filename)
+
+###############################################################################
+# Test GTIFF_STRILE_INDEX_CACHE_DIR
+
+
+def test_tiff_read_strile_index_cache_dir():
+
+    filename = '/vsimem/test_tiff_read_strile_index_cache_dir.tif'
+    cache_dir = '/vsimem/test_tiff_read_strile_index_cache_dir'
+    gdal.Mkdir(cache_dir, 0o755)
+    gdal.Translate(filename, 'data/byte.tif',
+                   creationOptions=['TILED=YES', 'BLOCKXSIZE=16',
+                                    'BLOCKYSIZE=16', 'COMPRESS=DEFLATE'])
+    ref_cs = gdal.Open(filename).GetRasterBand(1).Checksum()
+
+    try:
+        with gdaltest.config_option('GTIFF_STRILE_INDEX_CACHE_DIR', cache_dir):
+            # Cold open: creates the cache file
+            ds = gdal.Open(filename)
+            assert ds.GetRasterBand(1).Checksum() == ref_cs
+            ds = None
+            cache_files = gdal.ReadDir(cache_dir)
+            assert len(cache_files) == 1
+            assert cache_files[0].endswith('.gsi')
+
+            # Warm open
+            ds = gdal.Open(filename)
+            assert ds.GetRasterBand(1).Checksum() == ref_cs
+            ds = None
+
+            # A corrupted cache file is ignored
+            cache_filename = cache_dir + '/' + cache_files[0]
+            f = gdal.VSIFOpenL(cache_filename, 'wb')
+            gdal.VSIFWriteL(b'foo', 1, 3, f)
+            gdal.VSIFCloseL(f)
+            ds = gdal.Open(filename)
+            assert ds.GetRasterBand(1).Checksum() == ref_cs
+            ds = None
+    finally:
+        gdal.Unlink(filename)
+        for f in gdal.ReadDir(cache_dir) or []:
+            gdal.Unlink(cache_dir + '/' + f)
+        gdal.Rmdir(cache_dir)
@@ -7515,5 +7515,128 @@ def test_tiff_write_coordinate_epoch():
     gdal.Unlink('/vsimem/test_tiff_write_coordinate_epoch.tif')
 
 
+###############################################################################
+# Test copying compressed tiles without recompression
+
+
+@pytest.mark.parametrize("options", [['INTERLEAVE=PIXEL'],
+                                     ['INTERLEAVE=BAND'],
+                                     ['INTERLEAVE=PIXEL', 'COPY_SRC_OVERVIEWS=YES']])
+def test_tiff_write_direct_tile_copy(options):
+
+    src_filename = '/vsimem/test_tiff_write_direct_tile_copy_src.tif'
+    src_ds = gdal.Translate(src_filename, 'data/rgbsmall.tif',
+                            options='-co TILED=YES -co BLOCKXSIZE=16 '
+                                    '-co BLOCKYSIZE=16 -co COMPRESS=DEFLATE '
+                                    '-co PREDICTOR=2 -co ZLEVEL=1 ' +
+                                    ' '.join('-co ' + x for x in options
+                                             if x.startswith('INTERLEAVE')))
+    src_ds.BuildOverviews('NEAR', [2])
+    src_ds = None
+    src_ds = gdal.Open(src_filename)
+
+    sizes = []
+    for direct_copy in ('YES', 'NO'):
+        filename = '/vsimem/test_tiff_write_direct_tile_copy_%s.tif' % direct_copy
+        with gdaltest.config_option('GTIFF_DIRECT_TILE_COPY', direct_copy):
+            ds = gdaltest.tiff_drv.CreateCopy(
+                filename, src_ds,
+                options=options + ['TILED=YES', 'BLOCKXSIZE=16',
+                                   'BLOCKYSIZE=16', 'COMPRESS=DEFLATE',
+                                   'PREDICTOR=2', 'ZLEVEL=9'])
+        ds = None
+        ds = gdal.Open(filename)
+        assert [ds.GetRasterBand(i+1).Checksum() for i in range(3)] == \
+            [src_ds.GetRasterBand(i+1).Checksum() for i in range(3)]
+        if 'COPY_SRC_OVERVIEWS=YES' in options:
+            assert [ds.GetRasterBand(i+1).GetOverview(0).Checksum() for i in range(3)] == \
+                [src_ds.GetRasterBand(i+1).GetOverview(0).Checksum() for i in range(3)]
+        ds = None
+        sizes.append(gdal.VSIStatL(filename).size)
+        gdaltest.tiff_drv.Delete(filename)
+
+    src_ds = None
+    gdaltest.tiff_drv.Delete(src_filename)
+
+    # Tiles copied as they are keep the source compression level
+    assert sizes[0] != sizes[1]
+
+
+###############################################################################
+# Test GTIFF_STREAMING_WRITE=YES
+
+
+@pytest.mark.parametrize('interleave', ['PIXEL', 'BAND'])
+def test_tiff_write_streaming_write(interleave):
+
+    src_ds = gdal.Open('data/rgbsmall.tif')
+    filename = '/vsimem/test_tiff_write_streaming_write.tif'
+    with gdaltest.config_option('GTIFF_STREAMING_WRITE', 'YES'):
+        ds = gdaltest.tiff_drv.Create(filename, 50, 50, 3,
+                                      options=['TILED=YES', 'BLOCKXSIZE=16',
+                                               'BLOCKYSIZE=16',
+                                               'COMPRESS=DEFLATE',
+                                               'INTERLEAVE=' + interleave])
+    cache_used_before = gdal.GetCacheUsed()
+    for y in range(0, 50, 8):
+        ysize = min(8, 50 - y)
+        if interleave == 'PIXEL':
+            ds.WriteRaster(0, y, 50, ysize,
+                           src_ds.ReadRaster(0, y, 50, ysize))
+        else:
+            for i in range(3):
+                ds.GetRasterBand(i + 1).WriteRaster(
+                    0, y, 50, ysize,
+                    src_ds.GetRasterBand(i + 1).ReadRaster(0, y, 50, ysize))
+        if (y + ysize) % 16 == 0 or y + ysize == 50:
+            # Completed block rows have been written and evicted
+            assert gdal.GetCacheUsed() == cache_used_before
+        else:
+            assert gdal.GetCacheUsed() > cache_used_before
+    ds = None
+
+    ds = gdal.Open(filename)
+    assert [ds.GetRasterBand(i+1).Checksum() for i in range(3)] == \
+        [src_ds.GetRasterBand(i+1).Checksum() for i in range(3)]
+    ds = None
+    gdaltest.tiff_drv.Delete(filename)
+
+
+###############################################################################
+# Test writing whole blocks of all bands of a pixel-interleaved file at once
+
+
+@pytest.mark.parametrize('tiled', [True, False])
+def test_tiff_write_whole_blocks_all_bands(tiled):
+
+    src_ds = gdal.Open('data/rgbsmall.tif')
+    filename = '/vsimem/test_tiff_write_whole_blocks_all_bands.tif'
+    options = ['COMPRESS=DEFLATE', 'INTERLEAVE=PIXEL']
+    if tiled:
+        options += ['TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16']
+    else:
+        options += ['BLOCKYSIZE=16']
+    ds = gdaltest.tiff_drv.Create(filename, 50, 50, 3, options=options)
+    # Put garbage in the block cache, that must be overwritten
+    ds.GetRasterBand(2).Fill(255)
+    ds.GetRasterBand(1).ReadRaster(0, 0, 50, 50)
+    # Whole blocks, including blocks truncated by the raster edges
+    ds.WriteRaster(0, 0, 32, 32, src_ds.ReadRaster(0, 0, 32, 32))
+    ds.WriteRaster(32, 0, 18, 50, src_ds.ReadRaster(32, 0, 18, 50))
+    # Band order different from the file one
+    ds.WriteRaster(0, 32, 32, 18, src_ds.ReadRaster(0, 32, 32, 18,
+                                                    band_list=[3, 1, 2]),
+                   band_list=[3, 1, 2])
+    # Non aligned window, going through the block cache
+    ds.WriteRaster(5, 5, 10, 10, src_ds.ReadRaster(5, 5, 10, 10))
+    ds = None
+
+    ds = gdal.Open(filename)
+    assert [ds.GetRasterBand(i+1).Checksum() for i in range(3)] == \
+        [src_ds.GetRasterBand(i+1).Checksum() for i in range(3)]
+    ds = None
+    gdaltest.tiff_drv.Delete(filename)
+
+
 def test_tiff_write_cleanup():
     gdaltest.tiff_drv = None
@@ -757,6 +757,90 @@ def test_transformer_tps_precision():
     assert success, 'at least one point could not be transformed'
     assert maxDiffResult < 1e-3, 'at least one transformation exceeds the error bound'
 
+###############################################################################
+# Test multi-threaded TPS solving and the TPS_APPROX_GRID_SIZE option
+
+
+def test_transformer_tps_multithreaded_and_approx_grid():
+
+    ds = gdal.Open('data/gcps_2115.vrt')
+    tr_ref = gdal.Transformer(ds, None, ['METHOD=GCP_TPS'])
+    assert tr_ref
+
+    # Multi-threaded solving must give the same result as single-threaded one
+    tr_mt = gdal.Transformer(ds, None, ['METHOD=GCP_TPS', 'NUM_THREADS=4'])
+    assert tr_mt
+
+    tr_approx = gdal.Transformer(ds, None, ['METHOD=GCP_TPS',
+                                            'TPS_APPROX_GRID_SIZE=256'])
+    assert tr_approx
+
+    xsize = ds.RasterXSize
+    ysize = ds.RasterYSize
+    maxDiffApprox = 0.0
+    for i in range(11):
+        for j in range(11):
+            x = xsize * i / 10.0
+            y = ysize * j / 10.0
+            (_, ref) = tr_ref.TransformPoint(0, x, y)
+            (_, mt) = tr_mt.TransformPoint(0, x, y)
+            assert ref[0] == pytest.approx(mt[0], abs=1e-8)
+            assert ref[1] == pytest.approx(mt[1], abs=1e-8)
+            (_, approx) = tr_approx.TransformPoint(0, x, y)
+            maxDiffApprox = max(maxDiffApprox,
+                                math.sqrt((ref[0] - approx[0])**2 + (ref[1] - approx[1])**2))
+    gt = ds.GetGCPs()
+    assert maxDiffApprox < 1e-2 * max(abs(gt[0].GCPX - gt[-1].GCPX), abs(gt[0].GCPY - gt[-1].GCPY))
+
+
+###############################################################################
+# Test batch evaluation of the polynomial GCP transformer (including invalid
+# points in the middle of the array), and re-creation with the same GCPs
+
+
+def test_transformer_gcp_polynomial_batch():
+
+    ds = gdal.GetDriverByName('MEM').Create('', 100, 100)
+    gcps = []
+    for j in range(4):
+        for i in range(4):
+            px = i * 30.0
+            ln = j * 30.0 + i
+            gcps.append(gdal.GCP(440000 + 60 * px + 2 * ln,
+                                 3751000 - 60 * ln + 3 * px, 0, px, ln))
+    sr = osr.SpatialReference()
+    sr.ImportFromEPSG(26711)
+    ds.SetGCPs(gcps, sr.ExportToWkt())
+    for order in (1, 2, 3):
+        tr = gdal.Transformer(ds, None, ['METHOD=GCP_POLYNOMIAL',
+                                         'MAX_GCP_ORDER=%d' % order])
+        assert tr
+        points = [(20, 10), (0, 0), (float('inf'), 5), (30, 40), (15, 25)]
+        (pnts, success) = tr.TransformPoints(0, points)
+        assert success == [1, 1, 0, 1, 1]
+        for i, pt in enumerate(points):
+            if i == 2:
+                continue
+            (s, ref) = tr.TransformPoint(0, pt[0], pt[1])
+            assert s
+            assert pnts[i][0] == pytest.approx(ref[0], abs=1e-6)
+            assert pnts[i][1] == pytest.approx(ref[1], abs=1e-6)
+
+        # Creating again a transformer from the same GCPs must give the
+        # same results.
+        tr2 = gdal.Transformer(ds, None, ['METHOD=GCP_POLYNOMIAL',
+                                          'MAX_GCP_ORDER=%d' % order])
+        (pnts2, success2) = tr2.TransformPoints(0, points)
+        assert success2 == success
+        for i in (0, 1, 3, 4):
+            assert pnts2[i] == pnts[i]
+
+        (back, success) = tr.TransformPoints(1, [pnts[i] for i in (0, 1, 3, 4)])
+        assert success == [1, 1, 1, 1]
+        for i, pt in zip((0, 1, 3, 4), back):
+            assert pt[0] == pytest.approx(points[i][0], abs=1e-3)
+            assert pt[1] == pytest.approx(points[i][1], abs=1e-3)
+
 
 ###############################################################################
 def test_transformer_image_no_srs():
@@ -792,4 +876,38 @@ def test_transformer_dem_overrride_srs():
     assert success and pnt[0] == pytest.approx(0.5, abs=0.05) and pnt[1] == pytest.approx(0.5, abs=0.05), \
         'got wrong reverse transform result.'
 
-    gdal.Unlink('/vsimem/dem.tif')
\ No newline at end of file
+    gdal.Unlink('/vsimem/dem.tif')
+
+###############################################################################
+# Test that batches of points give the same results as single points, and
+# the RPC_INVERSE_GUESS_GRID option
+
+
+def test_transformer_rpc_batch_and_inverse_guess_grid():
+
+    ds = gdal.Open('data/rpc.vrt')
+    ds_dem = gdal.GetDriverByName('GTiff').Create('/vsimem/dem.tif', 100, 100, 1)
+    sr = osr.SpatialReference()
+    sr.ImportFromEPSG(32652)
+    ds_dem.SetProjection(sr.ExportToWkt())
+    ds_dem.SetGeoTransform([213300, 200, 0, 4418700, 0, -200])
+    ds_dem.GetRasterBand(1).Fill(15)
+    ds_dem = None
+
+    points = [(0.5 + i, 0.5 + 2 * i) for i in range(20)]
+    for options in [[], ['RPC_INVERSE_GUESS_GRID=YES']]:
+        tr = gdal.Transformer(ds, None, ['METHOD=RPC', 'RPC_DEM=/vsimem/dem.tif'] + options)
+
+        (geo_points, success) = tr.TransformPoints(0, points)
+        assert all(success)
+
+        (back_points, success) = tr.TransformPoints(1, geo_points)
+        assert all(success)
+        for i, pnt in enumerate(geo_points):
+            (success, back_pnt) = tr.TransformPoint(1, pnt[0], pnt[1], pnt[2])
+            assert success
+            assert back_pnt == back_points[i]
+            assert back_pnt[0] == pytest.approx(points[i][0], abs=0.1)
+            assert back_pnt[1] == pytest.approx(points[i][1], abs=0.1)
+
+    gdal.Unlink('/vsimem/dem.tif')
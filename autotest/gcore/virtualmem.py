@@ -205,3 +205,95 @@ def test_virtualmem_4():
         ds = None
 
         gdal.GetDriverByName('GTiff').Delete(tmpfile)
+
+###############################################################################
+# Test virtual mem auto with a tiled uncompressed GTiff (served by VirtualMemIO)
+@pytest.mark.skipif(sys.platform != 'linux', reason='Incorrect platform')
+def test_virtualmem_gtiff_tiled():
+    tmpfile = 'tmp/virtualmem_gtiff_tiled.tif'
+    src_ds = gdal.Open('data/byte.tif')
+    gdal.GetDriverByName('GTiff').CreateCopy(tmpfile, src_ds,
+                                             options=['TILED=YES',
+                                                      'BLOCKXSIZE=16',
+                                                      'BLOCKYSIZE=16'])
+    ref = src_ds.GetRasterBand(1).ReadAsArray()
+    ds = gdal.Open(tmpfile)
+    ar = ds.GetRasterBand(1).GetVirtualMemAutoArray(gdal.GF_Read)
+    if ar is None:
+        ds = None
+        gdal.GetDriverByName('GTiff').Delete(tmpfile)
+        pytest.skip()
+    cache_used = gdal.GetCacheUsed()
+    ok = numpy.array_equal(ar, ref)
+    # The pages are filled from a mapping of the file, not the block cache
+    cache_used_vm = gdal.GetCacheUsed()
+    # Other reads of the dataset still go through the block cache
+    ds.GetRasterBand(1).ReadRaster()
+    cache_used_read = gdal.GetCacheUsed()
+    # We need to destroy the array before dataset destruction
+    ar = None
+    ds = None
+    gdal.GetDriverByName('GTiff').Delete(tmpfile)
+    assert ok
+    assert cache_used_vm == cache_used
+    assert cache_used_read > cache_used
+
+###############################################################################
+# Test read-only virtual mem serviced by userfaultfd worker threads (falls
+# back to the regular implementation if userfaultfd is not available)
+@pytest.mark.skipif(sys.platform != 'linux', reason='Incorrect platform')
+def test_virtualmem_userfaultfd():
+    ds = gdal.Open('../gdrivers/data/small_world.tif')
+    ar = ds.ReadAsArray()
+
+    ar_bsq = ds.GetVirtualMemArray(gdal.GF_Read, band_list=[1, 2, 3],
+                                   cache_size=64 * 1024,
+                                   options=['USERFAULTFD=YES', 'NUM_THREADS=4'])
+    assert numpy.array_equal(ar_bsq, ar)
+    # Read backwards to exercise read-ahead in the reverse direction and
+    # eviction of pages
+    assert numpy.array_equal(ar_bsq[:, ::-1, :], ar[:, ::-1, :])
+
+    ar_bip = ds.GetVirtualMemArray(gdal.GF_Read, band_list=[1, 2, 3],
+                                   band_sequential=False,
+                                   options=['USERFAULTFD=YES'])
+    for band in range(3):
+        assert numpy.array_equal(ar_bip[:, :, band], ar[band])
+
+    ar_band = ds.GetRasterBand(2).GetVirtualMemArray(
+        gdal.GF_Read, options=['USERFAULTFD=YES'])
+    assert numpy.array_equal(ar_band, ar[1])
+
+    # We need to destroy the arrays before dataset destruction
+    ar_bsq = None
+    ar_bip = None
+    ar_band = None
+    ds = None
+
+###############################################################################
+# Test that worker threads of a userfaultfd virtual mem reopen the dataset
+# with its open options
+
+
+@pytest.mark.skipif(sys.platform != 'linux', reason='Incorrect platform')
+def test_virtualmem_userfaultfd_open_options():
+
+    tmpfile = '/vsimem/test_virtualmem_userfaultfd_open_options.tif'
+    gdal.Translate(tmpfile, '../gdrivers/data/small_world.tif')
+    ds = gdal.Open(tmpfile, gdal.GA_Update)
+    ds.BuildOverviews('NEAR', [2])
+    ds = None
+
+    ds = gdal.OpenEx(tmpfile, open_options=['OVERVIEW_LEVEL=0'])
+    assert ds.RasterXSize == 200
+    ar = ds.ReadAsArray()
+
+    ar_bsq = ds.GetVirtualMemArray(gdal.GF_Read, band_list=[1, 2, 3],
+                                   cache_size=16 * 1024,
+                                   options=['USERFAULTFD=YES', 'NUM_THREADS=4'])
+    assert numpy.array_equal(ar_bsq, ar)
+
+    # We need to destroy the array before dataset destruction
+    ar_bsq = None
+    ds = None
+    gdal.GetDriverByName('GTiff').Delete(tmpfile)
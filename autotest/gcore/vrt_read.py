@@ -1636,3 +1636,332 @@ def test_vrt_usemaskband_alpha():
 
     gdal.GetDriverByName('GTiff').Delete('/vsimem/src1.tif')
     gdal.GetDriverByName('GTiff').Delete('/vsimem/src2.tif')
+
+
+###############################################################################
+# Test a VRT with enough sources for their spatial index to be used
+
+
+def test_vrt_read_many_sources():
+
+    src_ds = gdal.GetDriverByName('GTiff').Create('/vsimem/src.tif', 30, 20)
+    src_ds.WriteRaster(0, 0, 30, 20,
+                       bytes(bytearray([(i * 7) % 251 for i in range(30 * 20)])))
+    src_ds = None
+    ds = gdal.GetDriverByName('GTiff').Create('/vsimem/overlay.tif', 4, 4)
+    ds.GetRasterBand(1).Fill(255)
+    ds = None
+
+    sources = ''
+    for y in range(10):
+        for x in range(10):
+            sources += """<SimpleSource>
+      <SourceFilename>/vsimem/src.tif</SourceFilename>
+      <SourceBand>1</SourceBand>
+      <SrcRect xOff="%d" yOff="%d" xSize="3" ySize="2" />
+      <DstRect xOff="%d" yOff="%d" xSize="3" ySize="2" />
+    </SimpleSource>""" % (x * 3, y * 2, x * 3, y * 2)
+    # Last source overwrites the previous ones
+    sources += """<SimpleSource>
+      <SourceFilename>/vsimem/overlay.tif</SourceFilename>
+      <SourceBand>1</SourceBand>
+      <SrcRect xOff="0" yOff="0" xSize="4" ySize="4" />
+      <DstRect xOff="10" yOff="5" xSize="4" ySize="4" />
+    </SimpleSource>"""
+    ds = gdal.Open("""<VRTDataset rasterXSize="40" rasterYSize="20">
+  <VRTRasterBand dataType="Byte" band="1">%s</VRTRasterBand>
+</VRTDataset>""" % sources)
+
+    def expected(x, y):
+        if 10 <= x < 14 and 5 <= y < 9:
+            return 255
+        if x >= 30:
+            return 0
+        return ((y * 30 + x) * 7) % 251
+
+    for (xoff, yoff, xsize, ysize) in [(0, 0, 40, 20), (4, 3, 1, 1),
+                                       (8, 4, 9, 7), (29, 17, 11, 3)]:
+        data = struct.unpack('B' * (xsize * ysize),
+                             ds.ReadRaster(xoff, yoff, xsize, ysize))
+        assert data == tuple(expected(xoff + i, yoff + j)
+                             for j in range(ysize) for i in range(xsize))
+
+    import ogrtest
+    if ogrtest.have_geos():
+        (flags, pct) = ds.GetRasterBand(1).GetDataCoverageStatus(3, 3, 6, 6)
+        assert flags == gdal.GDAL_DATA_COVERAGE_STATUS_DATA and pct == 100.0
+        (flags, pct) = ds.GetRasterBand(1).GetDataCoverageStatus(32, 3, 6, 6)
+        assert flags == gdal.GDAL_DATA_COVERAGE_STATUS_EMPTY and pct == 0.0
+
+    ds = None
+    gdal.GetDriverByName('GTiff').Delete('/vsimem/src.tif')
+    gdal.GetDriverByName('GTiff').Delete('/vsimem/overlay.tif')
+
+
+###############################################################################
+# Test reading sources with several threads
+
+
+@pytest.mark.parametrize("num_threads", ['1', '4'])
+def test_vrt_read_many_sources_num_threads(num_threads):
+
+    src_ds = gdal.GetDriverByName('GTiff').Create('/vsimem/src.tif', 30, 20, 2)
+    for i in range(2):
+        src_ds.GetRasterBand(i + 1).WriteRaster(
+            0, 0, 30, 20,
+            bytes(bytearray([(j * (7 + i)) % 251 for j in range(30 * 20)])))
+    src_ds = None
+    ds = gdal.GetDriverByName('GTiff').Create('/vsimem/overlay.tif', 4, 4, 2)
+    ds.GetRasterBand(1).Fill(255)
+    ds.GetRasterBand(2).Fill(254)
+    ds = None
+
+    bands = ''
+    for band in (1, 2):
+        sources = ''
+        for y in range(4):
+            for x in range(3):
+                sources += """<SimpleSource>
+      <SourceFilename>/vsimem/tile_%d_%d.tif</SourceFilename>
+      <SourceBand>%d</SourceBand>
+      <SrcRect xOff="0" yOff="0" xSize="10" ySize="5" />
+      <DstRect xOff="%d" yOff="%d" xSize="10" ySize="5" />
+    </SimpleSource>""" % (x, y, band, x * 10, y * 5)
+        # Overlaps several tiles, and must be applied after them
+        sources += """<SimpleSource>
+      <SourceFilename>/vsimem/overlay.tif</SourceFilename>
+      <SourceBand>%d</SourceBand>
+      <SrcRect xOff="0" yOff="0" xSize="4" ySize="4" />
+      <DstRect xOff="8" yOff="3" xSize="4" ySize="4" />
+    </SimpleSource>""" % band
+        bands += """<VRTRasterBand dataType="Byte" band="%d">%s</VRTRasterBand>
+""" % (band, sources)
+    for y in range(4):
+        for x in range(3):
+            gdal.Translate('/vsimem/tile_%d_%d.tif' % (x, y), '/vsimem/src.tif',
+                           srcWin=[x * 10, y * 5, 10, 5])
+
+    vrt = """<VRTDataset rasterXSize="30" rasterYSize="20">%s</VRTDataset>""" % bands
+    ds = gdal.OpenEx(vrt, open_options=['NUM_THREADS=' + num_threads])
+    for band in (1, 2):
+        expected = [(j * (6 + band)) % 251 for j in range(30 * 20)]
+        for y in range(3, 7):
+            for x in range(8, 12):
+                expected[y * 30 + x] = 256 - band
+        assert struct.unpack('B' * (30 * 20),
+                             ds.GetRasterBand(band).ReadRaster()) == tuple(expected)
+    # Dataset level RasterIO()
+    data = ds.ReadRaster(0, 0, 30, 20, buf_xsize=15, buf_ysize=10)
+    ref_ds = gdal.Open(vrt)
+    assert data == ref_ds.ReadRaster(0, 0, 30, 20, buf_xsize=15, buf_ysize=10)
+    ds = None
+    ref_ds = None
+
+    gdal.GetDriverByName('GTiff').Delete('/vsimem/src.tif')
+    gdal.GetDriverByName('GTiff').Delete('/vsimem/overlay.tif')
+    for y in range(4):
+        for x in range(3):
+            gdal.GetDriverByName('GTiff').Delete('/vsimem/tile_%d_%d.tif' % (x, y))
+
+###############################################################################
+# Test that sources with SourceProperties are only opened when needed
+
+
+def test_vrt_read_sources_with_source_properties_deferred():
+
+    for y in range(2):
+        for x in range(2):
+            ds = gdal.GetDriverByName('GTiff').Create(
+                '/vsimem/tile_%d_%d.tif' % (x, y), 10, 5)
+            ds.GetRasterBand(1).Fill(1 + x + 2 * y)
+            ds = None
+
+    sources = ''
+    for y in range(3):
+        for x in range(2):
+            # Tiles of the last row do not exist
+            sources += """<SimpleSource>
+      <SourceFilename>/vsimem/tile_%d_%d.tif</SourceFilename>
+      <SourceBand>1</SourceBand>
+      <SourceProperties RasterXSize="10" RasterYSize="5" DataType="Byte" BlockXSize="10" BlockYSize="5" />
+      <SrcRect xOff="0" yOff="0" xSize="10" ySize="5" />
+      <DstRect xOff="%d" yOff="%d" xSize="10" ySize="5" />
+    </SimpleSource>""" % (x, y, x * 10, y * 5)
+    vrt = """<VRTDataset rasterXSize="20" rasterYSize="15">
+  <VRTRasterBand dataType="Byte" band="1">%s</VRTRasterBand>
+</VRTDataset>""" % sources
+
+    ds = gdal.Open(vrt)
+    assert ds is not None
+    gdal.ErrorReset()
+    assert struct.unpack('B' * 4, ds.ReadRaster(8, 3, 4, 1)) == (1, 1, 2, 2)
+    assert struct.unpack('B' * 4, ds.ReadRaster(8, 7, 4, 1)) == (3, 3, 4, 4)
+    assert gdal.GetLastErrorMsg() == ''
+
+    assert sorted(ds.GetFileList()) == \
+        sorted(['/vsimem/tile_%d_%d.tif' % (x, y)
+                for y in range(2) for x in range(2)])
+
+    # Serialization of sources that have not been read yet
+    gdal.FileFromMemBuffer('/vsimem/test.vrt', vrt)
+    ds = gdal.Open('/vsimem/test.vrt')
+    ds.GetRasterBand(1).SetDescription('foo')
+    ds = None
+    ds = gdal.Open('/vsimem/test.vrt')
+    assert ds.GetRasterBand(1).GetDescription() == 'foo'
+    assert ds.GetRasterBand(1).Checksum(0, 0, 20, 10) == \
+        gdal.Open(vrt).GetRasterBand(1).Checksum(0, 0, 20, 10)
+    content = gdal.VSIFOpenL('/vsimem/test.vrt', 'rb')
+    xml = gdal.VSIFReadL(1, 10000, content).decode('ascii')
+    gdal.VSIFCloseL(content)
+    assert xml.count('<SourceProperties RasterXSize="10" RasterYSize="5" DataType="Byte" BlockXSize="10" BlockYSize="5"') == 6
+    ds = None
+
+    gdal.Unlink('/vsimem/test.vrt')
+    for y in range(2):
+        for x in range(2):
+            gdal.GetDriverByName('GTiff').Delete('/vsimem/tile_%d_%d.tif' % (x, y))
+
+###############################################################################
+# Test ComplexSource scaling and LUT of Byte and UInt16 sources into Byte
+
+
+def test_vrt_read_complex_source_to_byte():
+
+    values = [0, 1, 7, 100, 255, 256, 1000, 4000, 4095, 65535]
+    src_ds = gdal.GetDriverByName('GTiff').Create('/vsimem/src.tif', 10, 1, 1,
+                                                  gdal.GDT_UInt16)
+    src_ds.WriteRaster(0, 0, 10, 1, struct.pack('H' * 10, *values))
+    src_ds = None
+    gdal.Translate('/vsimem/src_byte.tif', '/vsimem/src.tif',
+                   outputType=gdal.GDT_Byte)
+
+    def read(src, options, buf_type=gdal.GDT_Byte):
+        ds = gdal.Open("""<VRTDataset rasterXSize="10" rasterYSize="1">
+  <VRTRasterBand dataType="Byte" band="1">
+    <ComplexSource>
+      <SourceFilename>%s</SourceFilename>
+      <SourceBand>1</SourceBand>
+      %s
+    </ComplexSource>
+  </VRTRasterBand>
+  <VRTRasterBand dataType="Byte" band="2">
+    <ComplexSource>
+      <SourceFilename>%s</SourceFilename>
+      <SourceBand>1</SourceBand>
+      %s
+    </ComplexSource>
+  </VRTRasterBand>
+</VRTDataset>""" % (src, options, src, options))
+        data = ds.GetRasterBand(1).ReadRaster()
+        # Pixel interleaved buffer
+        data2 = ds.ReadRaster(buf_pixel_space=2, buf_band_space=1)
+        assert data2[0::2] == data
+        assert data2[1::2] == data
+        return list(struct.unpack('B' * 10, data))
+
+    # Linear scaling of UInt16
+    assert read('/vsimem/src.tif',
+                '<ScaleOffset>10</ScaleOffset><ScaleRatio>0.0625</ScaleRatio>') == \
+        [min(255, int(10 + v * 0.0625 + 0.5)) for v in values]
+
+    # Nodata: pixels left to 0
+    assert read('/vsimem/src.tif',
+                '<NODATA>4000</NODATA><ScaleOffset>10</ScaleOffset><ScaleRatio>0.0625</ScaleRatio>') == \
+        [0 if v == 4000 else min(255, int(10 + v * 0.0625 + 0.5)) for v in values]
+
+    # LUT
+    assert read('/vsimem/src.tif', '<LUT>0:0,4095:255</LUT>') == \
+        [min(255, int(v * 255. / 4095 + 0.5)) for v in values]
+    assert read('/vsimem/src_byte.tif', '<LUT>0:255,255:0</LUT>') == \
+        [255 - min(v, 255) for v in values]
+
+    # Exponential scaling
+    assert read('/vsimem/src.tif',
+                '<Exponent>0.5</Exponent><SrcMin>0</SrcMin><SrcMax>4095</SrcMax><DstMin>0</DstMin><DstMax>255</DstMax>') == \
+        [min(255, int(255 * min(1.0, v / 4095.) ** 0.5 + 0.5)) for v in values]
+
+    gdal.GetDriverByName('GTiff').Delete('/vsimem/src.tif')
+    gdal.GetDriverByName('GTiff').Delete('/vsimem/src_byte.tif')
+
+###############################################################################
+# Test concurrent opening of sources when the dataset pool is smaller than
+# the number of sources
+
+
+def test_vrt_read_dataset_pool_concurrent_open():
+
+    sources = ''
+    for y in range(4):
+        for x in range(4):
+            ds = gdal.GetDriverByName('GTiff').Create(
+                '/vsimem/tile_%d_%d.tif' % (x, y), 10, 5)
+            ds.GetRasterBand(1).Fill(1 + x + 4 * y)
+            ds = None
+            sources += """<SimpleSource>
+      <SourceFilename>/vsimem/tile_%d_%d.tif</SourceFilename>
+      <SourceBand>1</SourceBand>
+      <SrcRect xOff="0" yOff="0" xSize="10" ySize="5" />
+      <DstRect xOff="%d" yOff="%d" xSize="10" ySize="5" />
+    </SimpleSource>""" % (x, y, x * 10, y * 5)
+    vrt = """<VRTDataset rasterXSize="40" rasterYSize="20">
+  <VRTRasterBand dataType="Byte" band="1">%s</VRTRasterBand>
+</VRTDataset>""" % sources
+
+    expected = tuple((1 + (i % 40) // 10 + 4 * ((i // 40) // 5))
+                     for i in range(40 * 20))
+
+    with gdaltest.config_options({'VRT_SHARED_SOURCE': '0',
+                                  'GDAL_MAX_DATASET_POOL_SIZE': '6'}):
+        ds = gdal.OpenEx(vrt, open_options=['NUM_THREADS=4'])
+        for _ in range(3):
+            assert struct.unpack('B' * (40 * 20),
+                                 ds.GetRasterBand(1).ReadRaster()) == expected
+        ds = None
+
+    for y in range(4):
+        for x in range(4):
+            gdal.GetDriverByName('GTiff').Delete('/vsimem/tile_%d_%d.tif' % (x, y))
+
+###############################################################################
+# Test that a downsampled read with a non-nearest resampling of a VRT with a
+# nodata value not matching the one of its sources uses the source overviews
+
+
+def test_vrt_read_resampled_nodata_uses_source_overviews():
+
+    for i in range(2):
+        ds = gdal.GetDriverByName('GTiff').Create(
+            '/vsimem/src_%d.tif' % i, 100, 100)
+        ds.GetRasterBand(1).Fill(10)
+        ds.BuildOverviews('NEAR', [2, 4])
+        # Make the overviews distinguishable from the full resolution data
+        ds.GetRasterBand(1).GetOverview(0).Fill(20)
+        ds.GetRasterBand(1).GetOverview(1).Fill(40)
+        ds = None
+
+    sources = ''
+    for i in range(2):
+        sources += """<SimpleSource>
+      <SourceFilename>/vsimem/src_%d.tif</SourceFilename>
+      <SourceBand>1</SourceBand>
+      <SrcRect xOff="0" yOff="0" xSize="100" ySize="100" />
+      <DstRect xOff="%d" yOff="0" xSize="100" ySize="100" />
+    </SimpleSource>""" % (i, i * 200)
+    vrt = """<VRTDataset rasterXSize="300" rasterYSize="100">
+  <VRTRasterBand dataType="Byte" band="1">
+    <NoDataValue>0</NoDataValue>%s
+  </VRTRasterBand>
+</VRTDataset>""" % sources
+
+    ds = gdal.Open(vrt)
+    data = struct.unpack('B' * (75 * 25), ds.GetRasterBand(1).ReadRaster(
+        0, 0, 300, 100, 75, 25, resample_alg=gdal.GRIORA_Average))
+    ds = None
+    # Read from the overview of factor 4, and the uncovered area is nodata
+    assert data[0:25] == tuple([40] * 25)
+    assert data[25:50] == tuple([0] * 25)
+    assert data[50:75] == tuple([40] * 25)
+
+    for i in range(2):
+        gdal.GetDriverByName('GTiff').Delete('/vsimem/src_%d.tif' % i)
@@ -650,6 +650,64 @@ def test_vsiaz_write_appendblob_retry():
                 assert gdal.VSIFWriteL('0123456789abcdef', 1, 16, f) == 16
                 gdal.VSIFCloseL(f)
 
+###############################################################################
+# Test write of a block blob with blocks uploaded in parallel
+
+
+def test_vsiaz_write_parallel_upload():
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    gdal.VSICurlClearCache()
+
+    with gdaltest.config_options({'VSIAZ_CHUNK_SIZE_BYTES': '100',
+                                  'CPL_VSIL_CURL_PARALLEL_UPLOAD': '2'}):
+        f = gdal.VSIFOpenL('/vsiaz/test_copy/file_parallel.bin', 'wb')
+    assert f is not None
+
+    handler = webserver.SequentialHandler()
+    # Blocks may be received in any order
+    for block, content_length in ((1, '100'), (2, '100'), (3, '50')):
+        handler.add_unordered('PUT', '/azure/blob/myaccount/test_copy/file_parallel.bin?blockid=%012d&comp=block' % block,
+                              201,
+                              expected_headers={'Content-Length': content_length})
+
+    def method(request):
+        h = request.headers
+        if 'Content-Length' not in h or h['Content-Length'] != '154':
+            sys.stderr.write('Bad headers: %s\n' % str(h))
+            request.send_response(403)
+            return
+
+        request.protocol_version = 'HTTP/1.1'
+        request.wfile.write('HTTP/1.1 100 Continue\r\n\r\n'.encode('ascii'))
+        content = request.rfile.read(154).decode('ascii')
+        if content != """<?xml version="1.0" encoding="utf-8"?>
+<BlockList>
+<Latest>000000000001</Latest>
+<Latest>000000000002</Latest>
+<Latest>000000000003</Latest>
+</BlockList>
+""":
+            sys.stderr.write('Bad content: %s\n' % str(content))
+            request.send_response(403)
+            request.send_header('Content-Length', 0)
+            request.end_headers()
+            return
+        request.send_response(201)
+        request.send_header('Content-Length', 0)
+        request.end_headers()
+
+    handler.add_unordered('PUT', '/azure/blob/myaccount/test_copy/file_parallel.bin?comp=blocklist',
+                          custom_method=method)
+
+    gdal.ErrorReset()
+    with webserver.install_http_handler(handler):
+        assert gdal.VSIFWriteL('x' * 250, 1, 250, f) == 250
+        gdal.VSIFCloseL(f)
+    assert gdal.GetLastErrorMsg() == ''
+
 ###############################################################################
 # Test Unlink()
 
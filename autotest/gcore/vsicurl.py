@@ -575,6 +575,177 @@ def test_vsicurl_no_size_in_HEAD():
 ###############################################################################
 
 
+def test_vsicurl_parallel_read():
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    gdal.VSICurlClearCache()
+
+    data = b''.join(bytes([i % 251]) for i in range(65536))
+
+    def method(request):
+        # Requests may be received in any order
+        rng = request.headers['Range']
+        assert rng.startswith('bytes=')
+        start, end = [int(x) for x in rng[len('bytes='):].split('-')]
+        request.protocol_version = 'HTTP/1.1'
+        request.send_response(206)
+        request.send_header('Content-Range', 'bytes %d-%d/%d' % (start, end, len(data)))
+        request.send_header('Content-Length', end - start + 1)
+        request.end_headers()
+        request.wfile.write(data[start:end + 1])
+
+    handler = webserver.SequentialHandler()
+    handler.add('GET', '/test_parallel_read/', 404)
+    handler.add('HEAD', '/test_parallel_read/test.bin', 200, {'Content-Length': '%d' % len(data)})
+    handler.add('GET', '/test_parallel_read/test.bin', custom_method=method)
+    handler.add('GET', '/test_parallel_read/test.bin', custom_method=method)
+    with webserver.install_http_handler(handler):
+        with gdaltest.config_option('CPL_VSIL_CURL_PARALLEL_READ', '2'):
+            f = gdal.VSIFOpenL('/vsicurl/http://localhost:%d/test_parallel_read/test.bin' % gdaltest.webserver_port, 'rb')
+            assert f is not None
+            got = gdal.VSIFReadL(1, len(data), f)
+            gdal.VSIFCloseL(f)
+    assert got == data
+
+###############################################################################
+# Test reading several files through the shared connection pool, with the
+# number of connections per host capped
+
+
+def test_vsicurl_share_connections():
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    gdal.VSICurlClearCache()
+
+    data = b''.join(bytes([i % 251]) for i in range(65536))
+
+    def method(request):
+        # Requests may be received in any order
+        rng = request.headers['Range']
+        assert rng.startswith('bytes=')
+        start, end = [int(x) for x in rng[len('bytes='):].split('-')]
+        request.protocol_version = 'HTTP/1.1'
+        request.send_response(206)
+        request.send_header('Content-Range', 'bytes %d-%d/%d' % (start, end, len(data)))
+        request.send_header('Content-Length', end - start + 1)
+        request.end_headers()
+        request.wfile.write(data[start:end + 1])
+
+    handler = webserver.SequentialHandler()
+    handler.add('GET', '/test_share_connections/', 404)
+    for filename in ('test1.bin', 'test2.bin'):
+        handler.add('HEAD', '/test_share_connections/' + filename, 200, {'Content-Length': '%d' % len(data)})
+        handler.add('GET', '/test_share_connections/' + filename, custom_method=method)
+        handler.add('GET', '/test_share_connections/' + filename, custom_method=method)
+    with webserver.install_http_handler(handler):
+        with gdaltest.config_options({'GDAL_HTTP_SHARE_CONNECTIONS': 'YES',
+                                      'GDAL_HTTP_MAX_HOST_CONNECTIONS': '1',
+                                      'CPL_VSIL_CURL_PARALLEL_READ': '2'}):
+            for filename in ('test1.bin', 'test2.bin'):
+                f = gdal.VSIFOpenL('/vsicurl/http://localhost:%d/test_share_connections/%s' % (gdaltest.webserver_port, filename), 'rb')
+                assert f is not None
+                got = gdal.VSIFReadL(1, len(data), f)
+                gdal.VSIFCloseL(f)
+                assert got == data
+
+###############################################################################
+# Test that two interleaved sequential streams each get a growing read-ahead
+
+
+def test_vsicurl_interleaved_streams():
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    gdal.VSICurlClearCache()
+
+    data = b''.join(bytes([i % 251]) for i in range(1024 * 1024))
+    offset_b = 512 * 1024
+
+    def add_range(handler, start, end):
+        handler.add('GET', '/test_interleaved_streams/test.bin', 206,
+                    {'Content-Range': 'bytes %d-%d/%d' % (start, end, len(data))},
+                    data[start:end + 1],
+                    expected_headers={'Range': 'bytes=%d-%d' % (start, end)})
+
+    handler = webserver.SequentialHandler()
+    handler.add('GET', '/test_interleaved_streams/', 404)
+    handler.add('HEAD', '/test_interleaved_streams/test.bin', 200, {'Content-Length': '%d' % len(data)})
+    for (start, end) in ((0, 16383), (16384, 49151), (49152, 114687)):
+        add_range(handler, start, end)
+        add_range(handler, offset_b + start, offset_b + end)
+    with webserver.install_http_handler(handler):
+        f = gdal.VSIFOpenL('/vsicurl/http://localhost:%d/test_interleaved_streams/test.bin' % gdaltest.webserver_port, 'rb')
+        assert f is not None
+        for i in range(6):
+            for start in (0, offset_b):
+                gdal.VSIFSeekL(f, start + i * 16384, 0)
+                got = gdal.VSIFReadL(1, 16384, f)
+                assert got == data[start + i * 16384:start + (i + 1) * 16384]
+        gdal.VSIFCloseL(f)
+
+###############################################################################
+
+
+def test_vsicurl_disk_cache():
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    gdal.VSICurlClearCache()
+
+    cache_dir = 'tmp/test_vsicurl_disk_cache'
+    gdal.RmdirRecursive(cache_dir)
+    gdal.Mkdir(cache_dir, 0o755)
+
+    url = '/vsicurl/http://localhost:%d/test_disk_cache/test.txt' % gdaltest.webserver_port
+    try:
+        with gdaltest.config_option('CPL_VSIL_CURL_DISK_CACHE_DIR', cache_dir):
+            handler = webserver.SequentialHandler()
+            handler.add('GET', '/test_disk_cache/', 404)
+            handler.add('HEAD', '/test_disk_cache/test.txt', 200, {'Content-Length': '3', 'ETag': '"abc"'})
+            handler.add('GET', '/test_disk_cache/test.txt', 200, {'ETag': '"abc"'}, 'foo')
+            with webserver.install_http_handler(handler):
+                f = gdal.VSIFOpenL(url, 'rb')
+                assert f is not None
+                assert gdal.VSIFReadL(1, 3, f) == b'foo'
+                gdal.VSIFCloseL(f)
+
+            # The in-memory cache is cleared, but the region is still on disk
+            gdal.VSICurlClearCache()
+
+            handler = webserver.SequentialHandler()
+            handler.add('GET', '/test_disk_cache/', 404)
+            handler.add('HEAD', '/test_disk_cache/test.txt', 200, {'Content-Length': '3', 'ETag': '"abc"'})
+            with webserver.install_http_handler(handler):
+                f = gdal.VSIFOpenL(url, 'rb')
+                assert f is not None
+                assert gdal.VSIFReadL(1, 3, f) == b'foo'
+                gdal.VSIFCloseL(f)
+
+            gdal.VSICurlClearCache()
+
+            # A different ETag means the file has changed
+            handler = webserver.SequentialHandler()
+            handler.add('GET', '/test_disk_cache/', 404)
+            handler.add('HEAD', '/test_disk_cache/test.txt', 200, {'Content-Length': '3', 'ETag': '"def"'})
+            handler.add('GET', '/test_disk_cache/test.txt', 200, {'ETag': '"def"'}, 'bar')
+            with webserver.install_http_handler(handler):
+                f = gdal.VSIFOpenL(url, 'rb')
+                assert f is not None
+                assert gdal.VSIFReadL(1, 3, f) == b'bar'
+                gdal.VSIFCloseL(f)
+    finally:
+        gdal.VSICurlClearCache()
+        gdal.RmdirRecursive(cache_dir)
+
+###############################################################################
+
+
 def test_vsicurl_stop_webserver():
 
     if gdaltest.webserver_port == 0:
@@ -717,6 +717,97 @@ def test_vsigzip_multi_thread():
         pytest.fail()
 
 
+###############################################################################
+# Test multithreaded decompression of multi-member files
+
+
+def test_vsigzip_multi_thread_read():
+
+    import gzip
+
+    data = b''.join(b'%d,hello world\n' % i for i in range(100000))
+    member_size = 10000
+    # Stored members whose content looks like gzip headers, which must not
+    # be taken as the start of a member.
+    fake_start = 40 * member_size
+    fake_size = 100000
+    fake_header = b'\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\x03'
+    data = data[0:fake_start] + fake_header * (fake_size // 10) + data[fake_start:]
+    gz = b''.join(gzip.compress(data[i:i+member_size],
+                                compresslevel=0 if fake_start <= i < fake_start + fake_size else 6)
+                  for i in range(0, len(data), member_size))
+    gdal.FileFromMemBuffer('/vsimem/vsigzip_multi_thread_read.gz', gz)
+
+    try:
+        with gdaltest.config_options({'GDAL_NUM_THREADS': '4',
+                                      'CPL_VSIL_DEFLATE_CHUNK_SIZE': '32K'}):
+            f = gdal.VSIFOpenL('/vsigzip//vsimem/vsigzip_multi_thread_read.gz', 'rb')
+            assert f
+            got = b''
+            while True:
+                chunk = gdal.VSIFReadL(1, 12345, f)
+                got += chunk
+                if len(chunk) < 12345:
+                    break
+            assert got == data
+
+            for offset in (1000, len(data) - 100, fake_start + 12345, 50):
+                assert gdal.VSIFSeekL(f, offset, 0) == 0
+                assert gdal.VSIFReadL(1, 100, f) == data[offset:offset+100]
+            gdal.VSIFCloseL(f)
+    finally:
+        gdal.Unlink('/vsimem/vsigzip_multi_thread_read.gz')
+        gdal.Unlink('/vsimem/vsigzip_multi_thread_read.gz.properties')
+
+
+###############################################################################
+# Test random access in /vsigzip/ files with a checkpoint index
+
+
+def test_vsigzip_index():
+
+    import gzip
+    import random
+
+    r = random.Random(0)
+    data = ''.join('%d,%s\n' % (i, ''.join(r.choice('abcdefgh') for _ in range(r.randint(1, 30)))) for i in range(50000)).encode('ascii')
+    # Two members, to check that checkpoints survive member boundaries
+    gz = gzip.compress(data[0:len(data) // 2]) + gzip.compress(data[len(data) // 2:])
+    gdal.FileFromMemBuffer('/vsimem/vsigzip_index.gz', gz)
+    gdal.FileFromMemBuffer('/vsimem/vsigzip_index2.gz', gz)
+
+    def check(filename):
+        f = gdal.VSIFOpenL('/vsigzip/' + filename, 'rb')
+        assert f
+        assert gdal.VSIFSeekL(f, 0, 2) == 0
+        assert gdal.VSIFTellL(f) == len(data)
+        for offset in (len(data) - 100, 1000, len(data) // 2 - 50, 300000, 10):
+            assert gdal.VSIFSeekL(f, offset, 0) == 0
+            assert gdal.VSIFReadL(1, 100, f) == data[offset:offset+100]
+        gdal.VSIFCloseL(f)
+
+    try:
+        with gdaltest.config_options({'CPL_VSIL_GZIP_INDEX': 'YES',
+                                      'CPL_VSIL_GZIP_INDEX_INTERVAL': '65536',
+                                      'CPL_VSIL_GZIP_WRITE_PROPERTIES': 'NO'}):
+            check('/vsimem/vsigzip_index.gz')
+            assert gdal.VSIStatL('/vsimem/vsigzip_index.gz.gzidx') is not None
+            # Reuse the existing index
+            check('/vsimem/vsigzip_index.gz')
+
+        with gdaltest.config_options({'CPL_VSIL_GZIP_INDEX_DIR': '/vsimem/vsigzip_index_dir',
+                                      'CPL_VSIL_GZIP_INDEX_INTERVAL': '65536',
+                                      'CPL_VSIL_GZIP_WRITE_PROPERTIES': 'NO'}):
+            check('/vsimem/vsigzip_index2.gz')
+        assert len(gdal.ReadDir('/vsimem/vsigzip_index_dir')) == 1
+        assert gdal.VSIStatL('/vsimem/vsigzip_index2.gz.gzidx') is None
+    finally:
+        gdal.Unlink('/vsimem/vsigzip_index.gz')
+        gdal.Unlink('/vsimem/vsigzip_index.gz.gzidx')
+        gdal.Unlink('/vsimem/vsigzip_index2.gz')
+        gdal.RmdirRecursive('/vsimem/vsigzip_index_dir')
+
+
 ###############################################################################
 # Test vsisync()
 
@@ -1306,6 +1306,20 @@ def test_vsis3_4():
 
     j = json.loads(gdal.NetworkStatsGetAsSerializedJSON())
     #print(j)
+
+    # Durations are not reproducible: check them apart
+    def pop_timings(d):
+        timings = d.pop('timings', None)
+        for v in d.values():
+            if isinstance(v, dict):
+                pop_timings(v)
+        return timings
+
+    timings = pop_timings(j)
+    assert timings['count'] == 1
+    assert timings['total_time_s'] > 0
+    assert sum(timings['time_to_first_byte_histogram'].values()) == 1
+
     assert j == {
         "methods": {
             "PUT": {
@@ -1963,6 +1977,49 @@ def test_vsis3_abort_pending_uploads():
             assert gdal.AbortPendingUploads('/vsis3/my_bucket')
 
 
+###############################################################################
+# Test multipart upload with parts uploaded in parallel
+
+
+def test_vsis3_parallel_upload():
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    with gdaltest.config_options({'VSIS3_CHUNK_SIZE_BYTES': '100',
+                                  'CPL_VSIL_CURL_PARALLEL_UPLOAD': '2'}):
+        with webserver.install_http_handler(webserver.SequentialHandler()):
+            f = gdal.VSIFOpenL('/vsis3/s3_fake_bucket_parallel/file.bin', 'wb')
+    assert f is not None
+
+    handler = webserver.SequentialHandler()
+    handler.add('POST', '/s3_fake_bucket_parallel/file.bin?uploads', 200,
+                {'Content-type': 'application/xml'},
+                """<?xml version="1.0" encoding="UTF-8"?>
+                <InitiateMultipartUploadResult>
+                <UploadId>my_id</UploadId>
+                </InitiateMultipartUploadResult>""")
+    # Parts may be received in any order
+    for part, content_length in ((1, '100'), (2, '100'), (3, '50')):
+        handler.add_unordered('PUT', '/s3_fake_bucket_parallel/file.bin?partNumber=%d&uploadId=my_id' % part, 200,
+                              {'ETag': '"etag%d"' % part},
+                              expected_headers={'Content-Length': content_length})
+    handler.add_unordered('POST', '/s3_fake_bucket_parallel/file.bin?uploadId=my_id', 200,
+                          expected_body=b"""<CompleteMultipartUpload>
+<Part>
+<PartNumber>1</PartNumber><ETag>"etag1"</ETag></Part>
+<Part>
+<PartNumber>2</PartNumber><ETag>"etag2"</ETag></Part>
+<Part>
+<PartNumber>3</PartNumber><ETag>"etag3"</ETag></Part>
+</CompleteMultipartUpload>
+""")
+    gdal.ErrorReset()
+    with webserver.install_http_handler(handler):
+        assert gdal.VSIFWriteL('x' * 250, 1, 250, f) == 250
+        gdal.VSIFCloseL(f)
+    assert gdal.GetLastErrorMsg() == ''
+
 ###############################################################################
 # Test Mkdir() / Rmdir()
 
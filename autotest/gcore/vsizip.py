@@ -29,7 +29,9 @@
 # DEALINGS IN THE SOFTWARE.
 ###############################################################################
 
+import io
 import random
+import zipfile
 
 
 import gdaltest
@@ -660,3 +662,38 @@ def test_vsizip_byte_zip64_local_header_zeroed():
 
 
 
+
+
+###############################################################################
+# Test lookups in an archive with many members, and invalidation of the
+# cached listing when the archive changes.
+
+def test_vsizip_many_members():
+
+    def make_zip(n):
+        f = io.BytesIO()
+        with zipfile.ZipFile(f, 'w') as z:
+            for i in range(n):
+                z.writestr('d%d/sub/f%d.txt' % (i % 10, i), 'content %d' % i)
+            z.writestr('d0/sub/f0.txt', 'duplicate')
+        return f.getvalue()
+
+    zip_name = '/vsimem/test_vsizip_many_members.zip'
+    gdal.FileFromMemBuffer(zip_name, make_zip(5000))
+
+    for i in (0, 1, 2345, 4999):
+        f = gdal.VSIFOpenL('/vsizip/%s/d%d/sub/f%d.txt' % (zip_name, i % 10, i), 'rb')
+        assert f is not None
+        data = gdal.VSIFReadL(1, 100, f).decode('ascii')
+        gdal.VSIFCloseL(f)
+        assert data == 'content %d' % i
+
+    assert gdal.VSIStatL('/vsizip/%s/d3/sub' % zip_name).IsDirectory()
+    assert gdal.VSIStatL('/vsizip/%s/d3/sub/f5000.txt' % zip_name) is None
+    assert len(gdal.ReadDir('/vsizip/%s' % zip_name)) == 10
+    assert len(gdal.ReadDir('/vsizip/%s/d3/sub' % zip_name)) == 500
+
+    gdal.FileFromMemBuffer(zip_name, make_zip(5001))
+    assert gdal.VSIStatL('/vsizip/%s/d0/sub/f5000.txt' % zip_name) is not None
+
+    gdal.Unlink(zip_name)
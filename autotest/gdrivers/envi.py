@@ -485,6 +485,50 @@ def test_envi_writing_interleaving(interleaving):
         gdal.Unlink(dstfilename)
         gdal.Unlink(dstfilename + '.hdr')
 
+###############################################################################
+# Test reading several interleaved bands at once, with byte swapping
+
+
+@pytest.mark.parametrize('interleaving', ['bip', 'bil', 'bsq'])
+@pytest.mark.parametrize('byte_order', [0, 1])
+def test_envi_read_interleaved_bands(interleaving, byte_order):
+
+    dstfilename = '/vsimem/test_envi_read_interleaved_bands.img'
+    try:
+        xsize = 50
+        ysize = 40
+        bands = 4
+        ds = gdal.GetDriverByName('ENVI').Create(dstfilename, xsize, ysize, bands, gdal.GDT_Int16,
+                                                 options=['INTERLEAVE=' + interleaving])
+        for i in range(bands):
+            ds.GetRasterBand(i + 1).WriteRaster(0, 0, xsize, ysize,
+                                                struct.pack('h' * xsize * ysize, *[(1000 * i + j) % 32768 - 100 for j in range(xsize * ysize)]))
+        ds = None
+
+        # Declare the data as big endian to exercise byte swapping
+        hdr = gdal.VSIFOpenL(dstfilename[0:-4] + '.hdr', 'rb')
+        content = gdal.VSIFReadL(1, 10000, hdr).decode('ascii')
+        gdal.VSIFCloseL(hdr)
+        content = content.replace('byte order = 0', 'byte order = %d' % byte_order)
+        gdal.FileFromMemBuffer(dstfilename[0:-4] + '.hdr', content)
+        gdal.Unlink(dstfilename + '.aux.xml')
+
+        for one_big_read in ('YES', None):
+            ds = gdal.Open(dstfilename)
+            expected = b''.join(ds.GetRasterBand(i).ReadRaster(3, 5, 40, 30, buf_type=gdal.GDT_Float32) for i in (4, 2, 3))
+            ds = None
+            ds = gdal.Open(dstfilename)
+            with gdaltest.config_option('GDAL_ONE_BIG_READ', one_big_read):
+                got = ds.ReadRaster(3, 5, 40, 30, buf_type=gdal.GDT_Float32, band_list=[4, 2, 3])
+            assert got == expected
+            with gdaltest.config_option('GDAL_ONE_BIG_READ', one_big_read):
+                got = ds.ReadRaster(3, 5, 40, 30, buf_type=gdal.GDT_Float32, band_list=[4, 2, 3],
+                                    buf_pixel_space=3 * 4, buf_line_space=40 * 3 * 4, buf_band_space=4)
+            assert struct.unpack('f' * 40 * 30 * 3, got)[0::3] == struct.unpack('f' * 40 * 30, expected[0:40 * 30 * 4])
+            ds = None
+    finally:
+        gdal.GetDriverByName('ENVI').Delete(dstfilename)
+
 ###############################################################################
 # Test writing different interleaving (larger file)
 
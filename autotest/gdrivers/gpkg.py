@@ -3389,6 +3389,63 @@ def test_gpkg_coordinate_epoch():
 
     gdal.Unlink('/vsimem/tmp.gpkg')
 
+###############################################################################
+# Test NUM_THREADS option for tile encoding and decoding
+
+
+@pytest.mark.parametrize('options,src_filename,output_type',
+                         [(['TILE_FORMAT=PNG'], 'data/rgbsmall.tif', gdal.GDT_Byte),
+                          (['TILE_FORMAT=PNG8'], 'data/rgbsmall.tif', gdal.GDT_Byte),
+                          ([], 'data/byte.tif', gdal.GDT_Int16)])
+def test_gpkg_num_threads(options, src_filename, output_type):
+
+    if gdaltest.gpkg_dr is None:
+        pytest.skip()
+    if gdaltest.png_dr is None:
+        pytest.skip()
+
+    gdal.Unlink('/vsimem/tmp.gpkg')
+    gdal.Unlink('/vsimem/tmp_st.gpkg')
+
+    src_ds = gdal.Open(src_filename)
+    gdal.Translate('/vsimem/tmp_st.gpkg', src_ds, format='GPKG',
+                   outputType=output_type,
+                   creationOptions=options + ['BLOCKSIZE=8'])
+    gdal.Translate('/vsimem/tmp.gpkg', src_ds, format='GPKG',
+                   outputType=output_type,
+                   creationOptions=options + ['BLOCKSIZE=8', 'NUM_THREADS=4'])
+
+    ds_ref = gdal.Open('/vsimem/tmp_st.gpkg')
+    expected_cs = [ds_ref.GetRasterBand(i+1).Checksum()
+                   for i in range(ds_ref.RasterCount)]
+    ds_ref = None
+
+    ds = gdal.Open('/vsimem/tmp.gpkg')
+    got_cs = [ds.GetRasterBand(i+1).Checksum() for i in range(ds.RasterCount)]
+    assert got_cs == expected_cs
+    ds = None
+
+    ds = gdal.OpenEx('/vsimem/tmp.gpkg', open_options=['NUM_THREADS=4'])
+    got_cs = [ds.GetRasterBand(i+1).Checksum() for i in range(ds.RasterCount)]
+    assert got_cs == expected_cs
+    ds = None
+
+    # Update mode: rewritten tiles must be read back correctly, even if
+    # their encoding is still pending. PNG8 requantization is not exact.
+    if 'TILE_FORMAT=PNG8' not in options:
+        ds = gdal.OpenEx('/vsimem/tmp.gpkg', gdal.OF_RASTER | gdal.OF_UPDATE,
+                         open_options=['NUM_THREADS=4'])
+        data = ds.ReadRaster()
+        ds.WriteRaster(0, 0, ds.RasterXSize, ds.RasterYSize, data)
+        ds.FlushCache()
+        got_cs = [ds.GetRasterBand(i+1).Checksum()
+                  for i in range(ds.RasterCount)]
+        assert got_cs == expected_cs
+        ds = None
+
+    gdal.Unlink('/vsimem/tmp.gpkg')
+    gdal.Unlink('/vsimem/tmp_st.gpkg')
+
 ###############################################################################
 #
 
@@ -181,6 +181,49 @@ def test_grib_grib2_test_grib_pds_all_bands():
 
     assert md is None, 'Got pds numbers, when disabled (#5144)'
 
+###############################################################################
+# Test writing and reading a .gdalidx message index
+
+
+@pytest.mark.parametrize('src_filename', ['data/grib/subgrids.grib2',
+                                          'data/grib/Sample_QuikSCAT.grb'])
+def test_grib_index(src_filename):
+
+    def get_bands_info(ds):
+        return [(ds.GetRasterBand(i + 1).GetMetadata(),
+                 ds.GetRasterBand(i + 1).GetNoDataValue(),
+                 ds.GetRasterBand(i + 1).Checksum())
+                for i in range(ds.RasterCount)]
+
+    filename = '/vsimem/test_grib_index.grb'
+    gdal.FileFromMemBuffer(filename, open(src_filename, 'rb').read())
+
+    ref_info = get_bands_info(gdal.Open(filename))
+    assert gdal.VSIStatL(filename + '.gdalidx') is None
+
+    ds = gdal.OpenEx(filename, open_options=['INDEX=YES'])
+    assert get_bands_info(ds) == ref_info
+    ds = None
+    assert gdal.VSIStatL(filename + '.gdalidx') is not None
+
+    # Check that the index gives the same result
+    ds = gdal.Open(filename)
+    assert get_bands_info(ds) == ref_info
+    ds = None
+
+    # A corrupted index is ignored
+    f = gdal.VSIFOpenL(filename + '.gdalidx', 'rb')
+    header = gdal.VSIFReadL(1, 100, f).decode('ascii').split('\n')[0]
+    gdal.VSIFCloseL(f)
+    gdal.FileFromMemBuffer(filename + '.gdalidx', header + '\nfoo\n')
+    with gdaltest.error_handler():
+        ds = gdal.Open(filename)
+    assert get_bands_info(ds) == ref_info
+    ds = None
+
+    gdal.Unlink(filename)
+    gdal.Unlink(filename + '.gdalidx')
+
 ###############################################################################
 # Test support for template 4.15 (#5768)
 
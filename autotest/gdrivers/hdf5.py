@@ -491,6 +491,27 @@ def test_hdf5_single_dim():
     assert b.Checksum() == 231
 
 
+###############################################################################
+# Test that decoding chunks in worker threads gives the same result
+
+
+@pytest.mark.parametrize('filename', ['data/netcdf/byte_chunked_multiple.nc',
+                                      'data/netcdf/byte_chunked_not_multiple.nc'])
+def test_hdf5_multithreaded_chunk_decoding(filename):
+
+    ds = gdal.Open('HDF5:' + filename + '://Band1')
+    ref_data = ds.ReadRaster()
+    ref_window = ds.GetRasterBand(1).ReadRaster(3, 2, 15, 12)
+    ref_cs = ds.GetRasterBand(1).Checksum()
+    ds = None
+
+    with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+        ds = gdal.Open('HDF5:' + filename + '://Band1')
+        assert ds.ReadRaster() == ref_data
+        assert ds.GetRasterBand(1).ReadRaster(3, 2, 15, 12) == ref_window
+        assert ds.GetRasterBand(1).Checksum() == ref_cs
+
+
 ###############################################################################
 # Test opening a file whose HDF5 signature is not at the beginning
 
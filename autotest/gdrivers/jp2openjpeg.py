@@ -3054,3 +3054,29 @@ def test_jp2openjpeg_generate_TLM():
 
     gdaltest.jp2openjpeg_drv.Delete(filename)
 
+
+
+###############################################################################
+# Test that decoding blocks from the codestream index gives the same result
+# as letting openjpeg locate the tile-parts
+
+
+@pytest.mark.parametrize('filename', ['data/jpeg2000/byte_tlm_plt.jp2',
+                                      'data/jpeg2000/513x513.jp2',
+                                      'data/jpeg2000/tile_size_16.jp2'])
+def test_jp2openjpeg_codestream_index(filename):
+
+    with gdaltest.config_option('USE_OPENJPEG_CODESTREAM_INDEX', 'NO'):
+        ds = gdal.Open(filename)
+        ref_data = ds.ReadRaster()
+        ref_ovr_cs = [ds.GetRasterBand(1).GetOverview(i).Checksum()
+                      for i in range(ds.GetRasterBand(1).GetOverviewCount())]
+        ds = None
+
+    for num_threads in ('1', '4'):
+        with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+            ds = gdal.Open(filename)
+            assert ds.ReadRaster() == ref_data
+            assert [ds.GetRasterBand(1).GetOverview(i).Checksum()
+                    for i in range(ds.GetRasterBand(1).GetOverviewCount())] == ref_ovr_cs
+            ds = None
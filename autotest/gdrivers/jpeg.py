@@ -1211,6 +1211,29 @@ def test_jpeg_write_4band_not_cmyk():
     assert gdal.GetLastErrorMsg() != ''
     gdal.GetDriverByName('JPEG').Delete('/vsimem/out.jpg')
 
+###############################################################################
+# Test reading a JPEG with a restart interval through its restart markers
+
+
+@pytest.mark.parametrize('num_threads', ['1', '4'])
+def test_jpeg_restart_markers(num_threads):
+
+    # Reference: sequential decoding of the whole image
+    ds = gdal.Open('data/jpeg/restart_markers.jpg')
+    ref_data = ds.GetRasterBand(1).ReadRaster()
+    ds = None
+
+    with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+        ds = gdal.Open('data/jpeg/restart_markers.jpg')
+        # Starts in the middle of the image, beyond the first restart segment
+        data = ds.GetRasterBand(1).ReadRaster(10, 100, 70, 25)
+        assert data == b''.join(ref_data[y * 100 + 10:y * 100 + 80]
+                                for y in range(100, 125))
+        data = ds.GetRasterBand(1).ReadRaster(0, 40, 100, 90)
+        assert data == ref_data[40 * 100:]
+        assert gdal.GetLastErrorMsg() == ''
+
+
 ###############################################################################
 # Cleanup
 
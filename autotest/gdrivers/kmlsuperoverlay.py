@@ -405,6 +405,48 @@ def test_kmlsuperoverlay_8():
     shutil.rmtree('tmp/3')
     os.remove('tmp/tmp.kml')
 
+###############################################################################
+# Test that generating the tiles with several threads gives the same result,
+# and that tiles downsampled from the next zoom level match a decimated read
+# of the source
+
+
+def test_kmlsuperoverlay_multithreaded():
+
+    # maximum zoom level is 2, with 375x375 tiles
+    src_ds = gdal.Translate('', 'data/utm.tif', format='MEM',
+                            width=1500, height=1500)
+
+    gdal.GetDriverByName('KMLSUPEROVERLAY').CreateCopy(
+        '/vsimem/kmlsuperoverlay_st.kmz', src_ds, options=['FORMAT=PNG'])
+    with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+        gdal.GetDriverByName('KMLSUPEROVERLAY').CreateCopy(
+            '/vsimem/kmlsuperoverlay_mt.kmz', src_ds, options=['FORMAT=PNG'])
+
+    def read_file(filename):
+        f = gdal.VSIFOpenL(filename, 'rb')
+        assert f, filename
+        data = gdal.VSIFReadL(1, 10000000, f)
+        gdal.VSIFCloseL(f)
+        return data
+
+    filelist = gdal.ReadDirRecursive('/vsizip//vsimem/kmlsuperoverlay_st.kmz')
+    assert '1/0/0.png' in filelist
+    assert (sorted(filelist) ==
+            sorted(gdal.ReadDirRecursive('/vsizip//vsimem/kmlsuperoverlay_mt.kmz')))
+    for filename in filelist:
+        if not filename.endswith('/'):
+            assert (read_file('/vsizip//vsimem/kmlsuperoverlay_st.kmz/' + filename) ==
+                    read_file('/vsizip//vsimem/kmlsuperoverlay_mt.kmz/' + filename)), filename
+
+    tile_ds = gdal.Open('/vsizip//vsimem/kmlsuperoverlay_st.kmz/1/0/0.png')
+    assert (tile_ds.GetRasterBand(1).ReadRaster() ==
+            src_ds.GetRasterBand(1).ReadRaster(0, 750, 750, 750, 375, 375))
+    tile_ds = None
+
+    gdal.Unlink('/vsimem/kmlsuperoverlay_st.kmz')
+    gdal.Unlink('/vsimem/kmlsuperoverlay_mt.kmz')
+
 ###############################################################################
 # Cleanup
 
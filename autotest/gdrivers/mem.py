@@ -622,6 +622,71 @@ def test_mem_dataset_rasterio_non_nearest_resampling_source_with_ovr():
     got_data = struct.unpack('B' * 5 * 5 * 3, got_data)
     assert got_data[0] == 10
 
+###############################################################################
+# Test RasterIO with strided buffers, and reads after block based writing
+
+def test_mem_rasterio_strided():
+
+    ds = gdal.GetDriverByName('MEM').Create('', 5, 4, 3, gdal.GDT_UInt16)
+    for i in range(3):
+        ds.GetRasterBand(i + 1).WriteRaster(0, 0, 5, 4, struct.pack('H' * 20, *[100 * i + j for j in range(20)]))
+
+    # Band contiguous, full lines
+    assert struct.unpack('H' * 20, ds.GetRasterBand(2).ReadRaster()) == tuple(100 + j for j in range(20))
+
+    # Sub-window with line padding in the output buffer
+    data = ds.GetRasterBand(3).ReadRaster(1, 1, 3, 2, buf_line_space=8 * 2)
+    got = struct.unpack('H' * 16, data[0:32])
+    assert got[0:3] == (206, 207, 208)
+    assert got[8:11] == (211, 212, 213)
+
+    # Pixel interleaved output with type conversion
+    data = ds.ReadRaster(0, 0, 5, 4, buf_type=gdal.GDT_Float32, band_list=[3, 1],
+                         buf_pixel_space=2 * 4, buf_line_space=5 * 2 * 4, buf_band_space=4)
+    got = struct.unpack('f' * 40, data)
+    assert got[0:4] == (200, 0, 201, 1)
+    assert got[38:40] == (219, 19)
+
+    # Strided write
+    ds.GetRasterBand(1).WriteRaster(1, 2, 2, 1, struct.pack('H' * 4, 1000, 0, 1001, 0),
+                                    buf_pixel_space=4)
+    assert struct.unpack('H' * 3, ds.GetRasterBand(1).ReadRaster(0, 2, 3, 1)) == (10, 1000, 1001)
+
+    # Data written through the block cache must be visible to RasterIO
+    ds.GetRasterBand(1).WriteRaster(0, 3, 5, 1, struct.pack('H', 7), buf_xsize=1, buf_ysize=1)
+    assert struct.unpack('H' * 5, ds.GetRasterBand(1).ReadRaster(0, 3, 5, 1)) == (7,) * 5
+
+###############################################################################
+# Test concurrent reads of a dataset wrapping an external buffer
+
+def test_mem_concurrent_reads_datapointer():
+
+    import threading
+
+    width, height = 300, 200
+    buf = ctypes.create_string_buffer(bytes(bytearray(i % 251 for i in range(width * height * 3))))
+    ds = gdal.Open('MEM:::DATAPOINTER=0x%X,PIXELS=%d,LINES=%d,BANDS=3,PIXELOFFSET=3,LINEOFFSET=%d,BANDOFFSET=1' %
+                   (ctypes.addressof(buf), width, height, width * 3))
+    expected = [ds.GetRasterBand(i + 1).Checksum() for i in range(3)]
+    expected_interleaved = ds.ReadRaster(buf_pixel_space=3, buf_band_space=1)
+    assert expected_interleaved == buf.raw[0:width * height * 3]
+
+    errors = []
+
+    def reader():
+        for _ in range(20):
+            if [ds.GetRasterBand(i + 1).Checksum() for i in range(3)] != expected or \
+               ds.ReadRaster(buf_pixel_space=3, buf_band_space=1) != expected_interleaved:
+                errors.append(True)
+
+    threads = [threading.Thread(target=reader) for _ in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert not errors
+    ds = None
+
 ###############################################################################
 # cleanup
 
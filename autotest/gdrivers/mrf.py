@@ -467,6 +467,30 @@ def test_mrf_versioned():
     cleanup()
 
 
+def test_mrf_multithreaded():
+
+    src_ds = gdal.Open('data/rgbsmall.tif')
+    expected_cs = [src_ds.GetRasterBand(i + 1).Checksum() for i in range(3)]
+    expected_data = src_ds.ReadRaster()
+
+    for co in (['COMPRESS=PNG'], ['COMPRESS=NONE', 'OPTIONS=DEFLATE:ON']):
+        gdal.Translate('/vsimem/out.mrf', src_ds, format='MRF',
+                       creationOptions=co + ['INTERLEAVE=BAND', 'BLOCKSIZE=8',
+                                             'NUM_THREADS=4'])
+
+        ds = gdal.OpenEx('/vsimem/out.mrf', open_options=['NUM_THREADS=4'])
+        assert ds.ReadRaster() == expected_data, co
+        assert [ds.GetRasterBand(i + 1).Checksum() for i in range(3)] == expected_cs, co
+        ds = None
+
+        with gdaltest.config_option('GDAL_NUM_THREADS', '1'):
+            ds = gdal.Open('/vsimem/out.mrf')
+            assert ds.ReadRaster() == expected_data, co
+            ds = None
+
+        cleanup()
+
+
 def test_mrf_cleanup():
 
     files = [
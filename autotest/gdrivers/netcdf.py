@@ -4563,6 +4563,32 @@ def test_netcdf_chunked_not_multiple():
     assert ds.GetRasterBand(1).Checksum() == 4672
 
 
+###############################################################################
+# Test that the size of the chunk cache set with GDAL_NETCDF_CHUNK_CACHE_SIZE
+# does not change the values read from chunked files
+
+
+@pytest.mark.parametrize('filename', ['data/netcdf/byte_chunked_multiple.nc',
+                                      'data/netcdf/byte_chunked_not_multiple.nc',
+                                      'data/netcdf/bug5291.nc'])
+def test_netcdf_chunk_cache_size(filename):
+
+    if not gdaltest.netcdf_drv_has_nc4:
+        pytest.skip()
+
+    def checksums():
+        ds = gdal.Open(filename)
+        return [ds.GetRasterBand(i + 1).Checksum()
+                for i in range(ds.RasterCount)]
+
+    ref = checksums()
+    # 0 keeps the netCDF library default, and a value smaller than a chunk
+    # must not prevent reading
+    for value in ['0', '100']:
+        with gdaltest.config_option('GDAL_NETCDF_CHUNK_CACHE_SIZE', value):
+            assert checksums() == ref, value
+
+
 def test_netcdf_create():
 
     ds = gdaltest.netcdf_drv.Create('tmp/test_create.nc', 2, 2)
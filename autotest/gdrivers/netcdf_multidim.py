@@ -1732,3 +1732,56 @@ def test_netcdf_multidim_cache(netcdf_setup):  # noqa
 
     gdal.Unlink(tmpfilename)
     gdal.Unlink(tmpfilename + ".gmac")
+
+
+def test_netcdf_multidim_chunk_cache(netcdf_setup):  # noqa
+
+    if not gdaltest.netcdf_drv_has_nc4:
+        pytest.skip()
+
+    drv = gdal.GetDriverByName('netCDF')
+    tmpfilename = 'tmp/test_netcdf_multidim_chunk_cache.nc'
+
+    ds = drv.CreateMultiDimensional(tmpfilename)
+    rg = ds.GetRootGroup()
+    dim_y = rg.CreateDimension('Y', None, None, 7)
+    dim_x = rg.CreateDimension('X', None, None, 5)
+    var = rg.CreateMDArray('var', [dim_y, dim_x],
+                           gdal.ExtendedDataType.Create(gdal.GDT_Int16),
+                           ['BLOCKSIZE=3,2'])
+    assert var.Write(struct.pack('h' * 35, *range(35))) == gdal.CE_None
+    ds = None
+
+    requests = [
+        {},
+        {'array_start_idx': [1, 1], 'count': [4, 3]},
+        {'array_start_idx': [6, 4], 'count': [3, 2], 'array_step': [-2, -3]},
+        {'array_start_idx': [0, 2], 'count': [2, 3], 'array_step': [4, 0]},
+        {'array_start_idx': [2, 3], 'count': [5, 1],
+         'buffer_datatype': gdal.ExtendedDataType.Create(gdal.GDT_Float64)},
+    ]
+
+    def read_all():
+        ds = gdal.OpenEx(tmpfilename, gdal.OF_MULTIDIM_RASTER)
+        var = ds.GetRootGroup().OpenMDArray('var')
+        return [var.Read(**kwargs) for kwargs in requests]
+
+    ref = read_all()
+    try:
+        with gdaltest.config_option('GDAL_MDARRAY_CHUNK_CACHE_SIZE', '1000000'):
+            assert read_all() == ref
+            # Served from the cache
+            assert read_all() == ref
+
+            # Writing invalidates the cached chunks
+            ds = gdal.OpenEx(tmpfilename, gdal.OF_MULTIDIM_RASTER | gdal.OF_UPDATE)
+            var = ds.GetRootGroup().OpenMDArray('var')
+            assert var.Read() == ref[0]
+            assert var.Write(struct.pack('h', 100),
+                             array_start_idx=[0, 0],
+                             count=[1, 1]) == gdal.CE_None
+            assert struct.unpack('h', var.Read(array_start_idx=[0, 0],
+                                               count=[1, 1])) == (100,)
+            ds = None
+    finally:
+        gdal.Unlink(tmpfilename)
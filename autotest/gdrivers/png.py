@@ -301,3 +301,38 @@ def test_png_14():
 
 
 
+
+###############################################################################
+# Test decoding of whole images at once (GDAL_PNG_WHOLE_IMAGE_OPTIM)
+
+
+@pytest.mark.parametrize('filename', ['data/png/test.png',
+                                      'data/png/rgba16.png',
+                                      'data/png/tbbn2c16.png',
+                                      '../gcore/data/stefan_full_rgba.png',
+                                      '../gcore/data/stefan_full_rgba_pct32.png'])
+def test_png_whole_image_optim(filename):
+
+    checksums = []
+    for optim in ('NO', 'YES'):
+        with gdaltest.config_option('GDAL_PNG_WHOLE_IMAGE_OPTIM', optim):
+            ds = gdal.Open(filename)
+            checksums.append([ds.GetRasterBand(i + 1).Checksum()
+                              for i in range(ds.RasterCount)])
+            # Read again lines after the first ones
+            checksums.append(ds.ReadRaster(0, ds.RasterYSize // 2,
+                                           ds.RasterXSize, 1))
+            ds = None
+    assert checksums[0] == checksums[2]
+    assert checksums[1] == checksums[3]
+
+
+def test_png_whole_image_optim_broken():
+
+    with gdaltest.config_option('GDAL_PNG_WHOLE_IMAGE_OPTIM', 'YES'):
+        ds = gdal.Open('data/png/idat_broken.png')
+        gdal.ErrorReset()
+        with gdaltest.error_handler():
+            ds.GetRasterBand(1).Checksum()
+    # Errors are reported by the libpng code path we fall back to
+    assert gdal.GetLastErrorNo() != 0
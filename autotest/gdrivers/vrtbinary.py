@@ -0,0 +1,204 @@
+#!/usr/bin/env pytest
+###############################################################################
+# $Id$
+#
+# Project:  GDAL/OGR Test Suite
+# Purpose:  Test binary VRT (.bvrt) support in VRT driver
+#
+###############################################################################
+# Copyright (c) 2021, GDAL project contributors
+#
+# Permission is hereby granted, free of charge, to any person obtaining a
+# copy of this software and associated documentation files (the "Software"),
+# to deal in the Software without restriction, including without limitation
+# the rights to use, copy, modify, merge, publish, distribute, sublicense,
+# and/or sell copies of the Software, and to permit persons to whom the
+# Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+# FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+# DEALINGS IN THE SOFTWARE.
+###############################################################################
+
+import os
+import shutil
+import struct
+
+from osgeo import gdal
+
+import gdaltest
+import pytest
+
+###############################################################################
+# Split data/byte.tif in tiles of tile_size x tile_size pixels
+
+
+def _create_tiles(dirname, tile_size):
+    src_ds = gdal.Open('data/byte.tif')
+    filenames = []
+    for yoff in range(0, src_ds.RasterYSize, tile_size):
+        for xoff in range(0, src_ds.RasterXSize, tile_size):
+            filename = '%s/tile_%d_%d.tif' % (dirname, xoff, yoff)
+            gdal.Translate(filename, src_ds,
+                           srcWin=[xoff, yoff, tile_size, tile_size])
+            filenames.append(filename)
+    return filenames
+
+###############################################################################
+# Check that a .bvrt written by BuildVRT() reads the same as its XML sibling
+
+
+@pytest.mark.parametrize('tile_size', [10, 2])
+def test_vrtbinary_buildvrt(tile_size):
+
+    # With 2x2 tiles, there are enough sources to use the spatial index
+    filenames = _create_tiles('/vsimem/vrtbinary', tile_size)
+    try:
+        gdal.BuildVRT('/vsimem/vrtbinary/mosaic.vrt', filenames)
+        gdal.BuildVRT('/vsimem/vrtbinary/mosaic.bvrt', filenames)
+
+        f = gdal.VSIFOpenL('/vsimem/vrtbinary/mosaic.bvrt', 'rb')
+        assert gdal.VSIFReadL(1, 8, f) == b'GDALBVRT'
+        gdal.VSIFCloseL(f)
+
+        ref_ds = gdal.Open('/vsimem/vrtbinary/mosaic.vrt')
+        ds = gdal.Open('/vsimem/vrtbinary/mosaic.bvrt')
+        assert ds is not None
+        assert ds.GetDriver().ShortName == 'VRT'
+        assert ds.RasterXSize == ref_ds.RasterXSize
+        assert ds.RasterYSize == ref_ds.RasterYSize
+        assert ds.RasterCount == ref_ds.RasterCount
+        assert ds.GetGeoTransform() == ref_ds.GetGeoTransform()
+        assert ds.GetSpatialRef().IsSame(ref_ds.GetSpatialRef())
+        band = ds.GetRasterBand(1)
+        ref_band = ref_ds.GetRasterBand(1)
+        assert band.DataType == ref_band.DataType
+        assert band.GetBlockSize() == ref_band.GetBlockSize()
+        assert band.Checksum() == 4672
+        assert band.ReadRaster(3, 5, 11, 7) == ref_band.ReadRaster(3, 5, 11, 7)
+        assert band.ReadRaster(buf_xsize=7, buf_ysize=7) == \
+            ref_band.ReadRaster(buf_xsize=7, buf_ysize=7)
+        ds = None
+        ref_ds = None
+    finally:
+        gdal.RmdirRecursive('/vsimem/vrtbinary')
+
+###############################################################################
+# Test sources with a nodata value (ComplexSource) and a band nodata value
+
+
+def test_vrtbinary_complex_source():
+
+    filenames = _create_tiles('/vsimem/vrtbinary', 2)
+    try:
+        gdal.BuildVRT('/vsimem/vrtbinary/mosaic.vrt', filenames,
+                      srcNodata=107, VRTNodata=255)
+        gdal.BuildVRT('/vsimem/vrtbinary/mosaic.bvrt', filenames,
+                      srcNodata=107, VRTNodata=255)
+
+        ref_ds = gdal.Open('/vsimem/vrtbinary/mosaic.vrt')
+        ds = gdal.Open('/vsimem/vrtbinary/mosaic.bvrt')
+        assert ds.GetRasterBand(1).GetNoDataValue() == 255
+        assert ds.ReadRaster() == ref_ds.ReadRaster()
+        assert ds.GetRasterBand(1).Checksum() == \
+            ref_ds.GetRasterBand(1).Checksum()
+        ds = None
+        ref_ds = None
+    finally:
+        gdal.RmdirRecursive('/vsimem/vrtbinary')
+
+###############################################################################
+# Test that a /vsimem/ file can be removed or overwritten while the dataset
+# is open
+
+
+def test_vrtbinary_vsimem_unlinked():
+
+    filenames = _create_tiles('/vsimem/vrtbinary', 2)
+    try:
+        gdal.BuildVRT('/vsimem/vrtbinary/mosaic.bvrt', filenames)
+        ds = gdal.Open('/vsimem/vrtbinary/mosaic.bvrt')
+        gdal.Unlink('/vsimem/vrtbinary/mosaic.bvrt')
+        gdal.FileFromMemBuffer('/vsimem/vrtbinary/mosaic.bvrt', b'\0' * 1000)
+        assert ds.RasterXSize == 20
+        assert ds.GetRasterBand(1).Checksum() == 4672
+        ds = None
+    finally:
+        gdal.RmdirRecursive('/vsimem/vrtbinary')
+
+###############################################################################
+# Test a real file, which is memory mapped when possible, with sources
+# relative to it
+
+
+def test_vrtbinary_real_file():
+
+    dirname = 'tmp/vrtbinary'
+    shutil.rmtree(dirname, ignore_errors=True)
+    os.mkdir(dirname)
+    try:
+        filenames = _create_tiles(dirname, 10)
+        gdal.BuildVRT(dirname + '/mosaic.bvrt', filenames)
+
+        # Move the whole directory to check that sources are relative
+        shutil.move(dirname, dirname + '_moved')
+        ds = gdal.Open(dirname + '_moved/mosaic.bvrt')
+        assert ds.GetRasterBand(1).Checksum() == 4672
+        assert len(ds.GetFileList()) == 1
+        ds = None
+
+        with gdaltest.error_handler():
+            assert gdal.Open(dirname + '_moved/mosaic.bvrt',
+                             gdal.GA_Update) is None
+    finally:
+        shutil.rmtree(dirname, ignore_errors=True)
+        shutil.rmtree(dirname + '_moved', ignore_errors=True)
+
+###############################################################################
+# Test that features not expressible in the binary format are rejected
+
+
+def test_vrtbinary_unsupported_feature():
+
+    src_ds = gdal.Translate('', 'data/byte.tif', format='VRT',
+                            scaleParams=[[0, 255, 0, 127]])
+    with gdaltest.error_handler():
+        ds = gdal.GetDriverByName('VRT').CreateCopy(
+            '/vsimem/vrtbinary_unsupported.bvrt', src_ds)
+    assert ds is None
+    assert 'not supported by the binary VRT format' in gdal.GetLastErrorMsg()
+    gdal.Unlink('/vsimem/vrtbinary_unsupported.bvrt')
+
+###############################################################################
+# Test robustness to corrupted files
+
+
+def test_vrtbinary_corrupted():
+
+    filenames = _create_tiles('/vsimem/vrtbinary', 10)
+    try:
+        gdal.BuildVRT('/vsimem/vrtbinary/mosaic.bvrt', filenames)
+        f = gdal.VSIFOpenL('/vsimem/vrtbinary/mosaic.bvrt', 'rb')
+        data = gdal.VSIFReadL(1, 100000, f)
+        gdal.VSIFCloseL(f)
+
+        # Band table offset beyond the end of file
+        corrupted = data[0:112] + struct.pack('<Q', len(data)) + data[120:]
+        gdal.FileFromMemBuffer('/vsimem/vrtbinary/corrupted.bvrt', corrupted)
+        with gdaltest.error_handler():
+            assert gdal.Open('/vsimem/vrtbinary/corrupted.bvrt') is None
+
+        # Truncated file
+        gdal.FileFromMemBuffer('/vsimem/vrtbinary/corrupted.bvrt',
+                               data[0:200])
+        with gdaltest.error_handler():
+            assert gdal.Open('/vsimem/vrtbinary/corrupted.bvrt') is None
+    finally:
+        gdal.RmdirRecursive('/vsimem/vrtbinary')
@@ -1884,6 +1884,58 @@ def test_vrtpansharpen_out_of_order_input_bands_and_nodata():
 
     assert cs2 == cs[::-1]
 
+###############################################################################
+# Test that multi-threaded upsampling and pansharpening, with clamping of
+# overshooting values, gives the same result as the single-threaded path,
+# including for successive requests of different sizes
+
+
+def test_vrtpansharpen_resampling_num_threads():
+
+    src_ds = gdal.Open('data/small_world.tif')
+    ms_ds = gdal.Translate('/vsimem/ms.tif', src_ds, options='-ot UInt16 -scale 0 255 0 4095')
+    ms_ds = None
+    pan_ds = gdal.Translate('/vsimem/pan.tif', src_ds, options='-b 1 -outsize 1000 500 -ot UInt16 -scale 0 255 0 4095 -r bilinear')
+    pan_ds = None
+
+    def get_data(num_threads):
+        vrt_ds = gdal.Open("""<VRTDataset subClass="VRTPansharpenedDataset">
+        <BlockXSize>256</BlockXSize>
+        <BlockYSize>128</BlockYSize>
+        <PansharpeningOptions>
+            <NumThreads>%s</NumThreads>
+            <Resampling>Cubic</Resampling>
+            <BitDepth>12</BitDepth>
+            <PanchroBand>
+                    <SourceFilename relativeToVRT="1">/vsimem/pan.tif</SourceFilename>
+                    <SourceBand>1</SourceBand>
+            </PanchroBand>
+            <SpectralBand dstBand="1">
+                    <SourceFilename relativeToVRT="1">/vsimem/ms.tif</SourceFilename>
+                    <SourceBand>1</SourceBand>
+            </SpectralBand>
+            <SpectralBand dstBand="2">
+                    <SourceFilename relativeToVRT="1">/vsimem/ms.tif</SourceFilename>
+                    <SourceBand>2</SourceBand>
+            </SpectralBand>
+            <SpectralBand dstBand="3">
+                    <SourceFilename relativeToVRT="1">/vsimem/ms.tif</SourceFilename>
+                    <SourceBand>3</SourceBand>
+            </SpectralBand>
+        </PansharpeningOptions>
+    </VRTDataset>""" % num_threads)
+        return [vrt_ds.ReadRaster(),
+                vrt_ds.ReadRaster(10, 20, 300, 200),
+                vrt_ds.ReadRaster(buf_type=gdal.GDT_Float32),
+                [vrt_ds.GetRasterBand(i + 1).Checksum() for i in range(vrt_ds.RasterCount)]]
+
+    ref = get_data(1)
+    assert get_data('ALL_CPUS') == ref
+    assert get_data(3) == ref
+
+    gdal.Unlink('/vsimem/ms.tif')
+    gdal.Unlink('/vsimem/pan.tif')
+
 ###############################################################################
 # Cleanup
 
@@ -443,3 +443,54 @@ def test_vrtwarp_read_blocks_in_space():
 
     ds = gdal.Open('data/vrt/geos_vrtwarp.vrt')
     assert ds.GetRasterBand(1).ReadRaster(0, 0, 512, 512)
+
+###############################################################################
+# Test reading several blocks at once with a multi-threaded warp kernel
+
+
+def test_vrtwarp_read_several_blocks_multithreaded():
+
+    src_ds = gdal.Open('data/byte.tif')
+    gdal.Warp('/vsimem/test.vrt', src_ds, format='VRT')
+    f = gdal.VSIFOpenL('/vsimem/test.vrt', 'rb')
+    xml = gdal.VSIFReadL(1, 100000, f).decode('ascii')
+    gdal.VSIFCloseL(f)
+    xml = xml.replace('<BlockXSize>20</BlockXSize>', '<BlockXSize>8</BlockXSize>')
+    xml = xml.replace('<BlockYSize>20</BlockYSize>', '<BlockYSize>6</BlockYSize>')
+    xml = xml.replace('<WarpOptions>',
+                      '<WarpOptions><Option name="NUM_THREADS">4</Option>')
+    gdal.Unlink('/vsimem/test.vrt')
+
+    ds = gdal.Open(xml)
+    assert ds.GetRasterBand(1).GetBlockSize() == [8, 6]
+    # Some blocks already in cache
+    assert ds.GetRasterBand(1).ReadRaster(8, 6, 8, 6) == \
+        src_ds.GetRasterBand(1).ReadRaster(8, 6, 8, 6)
+    assert ds.GetRasterBand(1).ReadRaster(1, 2, 18, 17) == \
+        src_ds.GetRasterBand(1).ReadRaster(1, 2, 18, 17)
+
+    ds = gdal.Open(xml)
+    assert ds.GetRasterBand(1).Checksum() == src_ds.GetRasterBand(1).Checksum()
+
+###############################################################################
+# Test opening a warped VRT whose SourceDataset is relative to the VRT, both
+# from a file and from an XML string (parsed in a read-only arena tree)
+
+
+def test_vrtwarp_relative_source_dataset():
+
+    ds = gdal.Open('data/vrt/rgb_warp.vrt')
+    cs = ds.GetRasterBand(2).Checksum()
+    assert cs == 21504
+    ds = None
+
+    with open('data/vrt/rgb_warp.vrt', 'rt') as f:
+        xml = f.read()
+    xml = xml.replace('<SourceDataset relativeToVRT="1">../rgb_gcp.vrt',
+                      '<SourceDataset relativeToVRT="1">data/rgb_gcp.vrt')
+    ds = gdal.Open(xml)
+    assert ds is not None
+    assert ds.GetRasterBand(2).Checksum() == cs
+    # Reopening the same XML must give the same result
+    ds = gdal.Open(xml)
+    assert ds.GetRasterBand(2).Checksum() == cs
@@ -913,6 +913,71 @@ def test_twms_inline_configuration():
     ds = None
 
 
+###############################################################################
+# Test the SQLite cache type, reading tiles from a local TMS
+
+def test_wms_cache_sqlite():
+
+    tile_dir = os.path.join(os.getcwd(), 'tmp', 'wms_sqlite_tiles', '0', '0')
+    os.makedirs(tile_dir, exist_ok=True)
+    src_ds = gdal.Translate('', 'data/rgbsmall.tif', format='MEM',
+                            width=256, height=256)
+    gdal.GetDriverByName('PNG').CreateCopy(os.path.join(tile_dir, '0.png'),
+                                           src_ds)
+    expected_cs = [src_ds.GetRasterBand(i + 1).Checksum() for i in range(3)]
+    src_ds = None
+
+    server_url = 'file://' + os.path.join(os.getcwd(), 'tmp', 'wms_sqlite_tiles').replace('\\', '/')
+    tms = """<GDAL_WMS>
+    <Service name="TMS">
+        <ServerUrl>%s/${z}/${x}/${y}.png</ServerUrl>
+    </Service>
+    <DataWindow>
+        <UpperLeftX>-20037508.34</UpperLeftX>
+        <UpperLeftY>20037508.34</UpperLeftY>
+        <LowerRightX>20037508.34</LowerRightX>
+        <LowerRightY>-20037508.34</LowerRightY>
+        <TileLevel>0</TileLevel>
+        <TileCountX>1</TileCountX>
+        <TileCountY>1</TileCountY>
+        <YOrigin>top</YOrigin>
+    </DataWindow>
+    <Projection>EPSG:3857</Projection>
+    <BlockSizeX>256</BlockSizeX>
+    <BlockSizeY>256</BlockSizeY>
+    <BandsCount>3</BandsCount>
+    <Cache><Path>./tmp/gdalwmscache_sqlite</Path><Type>sqlite</Type></Cache>
+    <OfflineMode>%s</OfflineMode>
+</GDAL_WMS>"""
+
+    gdal.ErrorReset()
+    with gdaltest.error_handler():
+        ds = gdal.Open(tms % (server_url, 'false'))
+    if 'without SQLite support' in gdal.GetLastErrorMsg():
+        pytest.skip('GDAL built without SQLite support')
+    assert ds is not None
+    with gdaltest.error_handler():
+        cs = [ds.GetRasterBand(i + 1).Checksum() for i in range(3)]
+    ds = None
+    if cs != expected_cs and gdal.GetLastErrorMsg() != '':
+        pytest.skip('file:// not supported by libcurl')
+    assert cs == expected_cs
+
+    cache_files = [os.path.join(root, f)
+                   for root, _, files in os.walk('tmp/gdalwmscache_sqlite')
+                   for f in files]
+    assert [os.path.basename(f) for f in cache_files if f.endswith('.sqlite')] == ['cache.sqlite']
+    assert not [f for f in cache_files if f.endswith('.png')]
+
+    # The tile must now be served from the cache
+    shutil.rmtree('tmp/wms_sqlite_tiles')
+    ds = gdal.Open(tms % (server_url, 'true'))
+    assert [ds.GetRasterBand(i + 1).Checksum() for i in range(3)] == expected_cs
+    ds = None
+
+    shutil.rmtree('tmp/gdalwmscache_sqlite')
+
+
 def test_wms_cleanup():
 
     gdaltest.wms_ds = None
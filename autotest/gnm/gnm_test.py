@@ -31,6 +31,7 @@
 # DEALINGS IN THE SOFTWARE.
 ###############################################################################
 
+import heapq
 import os
 import shutil
 
@@ -211,6 +212,169 @@ def test_gnm_graph_connectedcomponents():
     dn.ReleaseResultSet(lyr)
     dn = None
 
+###############################################################################
+# Reference implementation of the Dijkstra shortest path, with the semantics
+# of the original std::map based GNMGraph: bidirectional edges have their
+# direct cost in both directions, and blocked edges and vertices are barriers.
+
+
+def _gnm_read_graph():
+
+    graph_ds = gdal.OpenEx('tmp/test_gnm/_gnm_graph.dbf', gdal.OF_VECTOR)
+    assert graph_ds is not None
+    edges = {}
+    for f in graph_ds.GetLayer(0):
+        edges[f['connector']] = (f['source'], f['target'], f['cost'],
+                                 f['direction'] == 0)
+    return edges
+
+
+def _gnm_reference_dijkstra(edges, start, blocked=()):
+
+    out_edges = {}
+    for edge, (src, tgt, cost, bidir) in edges.items():
+        out_edges.setdefault(src, []).append((edge, tgt, cost))
+        if bidir:
+            out_edges.setdefault(tgt, []).append((edge, src, cost))
+    marks = {start: 0.0}
+    seen = set()
+    to_see = [(0.0, start)]
+    while to_see:
+        mark, vertex = heapq.heappop(to_see)
+        if vertex in seen:
+            continue
+        seen.add(vertex)
+        for edge, target, cost in out_edges.get(vertex, []):
+            if edge in blocked or target in blocked or target in seen:
+                continue
+            if mark + cost < marks.get(target, float('inf')):
+                marks[target] = mark + cost
+                heapq.heappush(to_see, (mark + cost, target))
+    return marks
+
+
+def _gnm_get_paths(dn, start, end, algorithm, options=None):
+
+    lyr = dn.GetPath(start, end, algorithm, options=options)
+    assert lyr is not None, 'failed to get path'
+    paths = {}
+    for f in lyr:
+        paths.setdefault(f['path_num'], []).append((f['ftype'], f['gnm_fid']))
+    dn.ReleaseResultSet(lyr)
+    return [paths[k] for k in sorted(paths)]
+
+
+def _gnm_check_path(edges, path, start, end, blocked=()):
+
+    # Vertices and edges come as V0, V1, E1, V2, E2... where Ei leads from
+    # Vi-1 to Vi.
+    vertices = [fid for (ftype, fid) in path if ftype == 'VERTEX']
+    path_edges = [fid for (ftype, fid) in path if ftype == 'EDGE']
+    assert vertices[0] == start
+    assert vertices[-1] == end
+    assert len(path_edges) == len(vertices) - 1
+    cost = 0.0
+    for i, edge in enumerate(path_edges):
+        assert edge not in blocked
+        assert vertices[i + 1] not in blocked
+        src, tgt, edge_cost, bidir = edges[edge]
+        assert (src, tgt) == (vertices[i], vertices[i + 1]) or \
+            (bidir and (tgt, src) == (vertices[i], vertices[i + 1]))
+        cost += edge_cost
+    return cost
+
+###############################################################################
+# Compare Dijkstra shortest paths with the reference implementation
+
+
+def test_gnm_graph_dijkstra_reference():
+
+    if not ogrtest.have_gnm:
+        pytest.skip()
+
+    edges = _gnm_read_graph()
+    marks = _gnm_reference_dijkstra(edges, 61)
+    assert 50 in marks
+
+    ds = gdal.OpenEx('tmp/test_gnm')
+    dn = gnm.CastToNetwork(ds)
+    assert dn is not None, 'cast to GNMNetwork failed'
+
+    for end in sorted(marks)[:30] + [50]:
+        if end == 61:
+            continue
+        paths = _gnm_get_paths(dn, 61, end, gnm.GATDijkstraShortestPath)
+        assert len(paths) == 1
+        assert _gnm_check_path(edges, paths[0], 61, end) == \
+            pytest.approx(marks[end])
+
+    dn = None
+
+###############################################################################
+# Compare Dijkstra shortest paths with blocked features with the reference
+# implementation
+
+
+def test_gnm_graph_dijkstra_blocked_reference():
+
+    if not ogrtest.have_gnm:
+        pytest.skip()
+
+    edges = _gnm_read_graph()
+
+    ds = gdal.OpenEx('tmp/test_gnm')
+    dgn = gnm.CastToGenericNetwork(ds)
+    assert dgn is not None, 'cast to GNMGenericNetwork failed'
+
+    path = _gnm_get_paths(dgn, 61, 50, gnm.GATDijkstraShortestPath)[0]
+    path_vertices = [fid for (ftype, fid) in path if ftype == 'VERTEX']
+    path_edges = [fid for (ftype, fid) in path if ftype == 'EDGE']
+    assert len(path_edges) >= 2
+
+    # Block an edge, then a vertex of the shortest path
+    for blocked in ((path_edges[len(path_edges) // 2],),
+                    (path_vertices[len(path_vertices) // 2],)):
+        assert dgn.ChangeBlockState(blocked[0], True) == 0
+        marks = _gnm_reference_dijkstra(edges, 61, blocked)
+        paths = _gnm_get_paths(dgn, 61, 50, gnm.GATDijkstraShortestPath)
+        try:
+            if 50 in marks:
+                assert len(paths) == 1
+                assert _gnm_check_path(edges, paths[0], 61, 50, blocked) == \
+                    pytest.approx(marks[50])
+            else:
+                assert not paths
+        finally:
+            assert dgn.ChangeAllBlockState(False) == 0
+
+    dgn = None
+
+###############################################################################
+# Check K shortest paths against the reference implementation
+
+
+def test_gnm_graph_kshortest_reference():
+
+    if not ogrtest.have_gnm:
+        pytest.skip()
+
+    edges = _gnm_read_graph()
+    marks = _gnm_reference_dijkstra(edges, 61)
+
+    ds = gdal.OpenEx('tmp/test_gnm')
+    dn = gnm.CastToNetwork(ds)
+    assert dn is not None, 'cast to GNMNetwork failed'
+
+    paths = _gnm_get_paths(dn, 61, 50, gnm.GATKShortestPath,
+                           options=['num_paths=3'])
+    dn = None
+
+    assert 1 < len(paths) <= 3
+    costs = [_gnm_check_path(edges, path, 61, 50) for path in paths]
+    assert costs[0] == pytest.approx(marks[50])
+    assert costs == sorted(costs)
+    assert len(set(tuple(path) for path in paths)) == len(paths)
+
 ###############################################################################
 # Network deleting
 
@@ -2132,3 +2132,85 @@ def test_ogr_csv_iter_and_set_feature():
     gdal.Unlink('/vsimem/ogr_csv_iter_and_set_feature.csv')
 
     assert count == 2
+
+###############################################################################
+# Test spatial filtering on a WKT column, with records skipped before being
+# translated.
+
+
+def test_ogr_csv_spatial_filter_wkt():
+
+    filename = '/vsimem/test_ogr_csv_spatial_filter_wkt.csv'
+    gdal.FileFromMemBuffer(filename,
+                           """WKT,id
+"POINT (1 1)",1
+"POINT (20 20)",2
+"LINESTRING (-5 -5,5 5)",3
+,4
+"POLYGON ((15 15,15 16,16 16,15 15))",5
+"POINT EMPTY",6
+"CIRCULARSTRING (-1 5,5 11,11 5)",7
+"POINT (2 2)",8
+""")
+
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    lyr.SetSpatialFilterRect(0, 0, 10, 10)
+    assert [(f['id'], f.GetFID()) for f in lyr] == [('1', 1), ('3', 3), ('7', 7), ('8', 8)]
+    lyr.SetSpatialFilter(None)
+    assert lyr.GetFeatureCount() == 8
+    ds = None
+
+    gdal.Unlink(filename)
+
+
+###############################################################################
+# Test reading with several threads
+
+
+def test_ogr_csv_multithreaded_reading():
+
+    filename = '/vsimem/test_ogr_csv_multithreaded_reading.csv'
+    content = 'id,int,int64,real,str,WKT\r\n'
+    for i in range(1000):
+        if i % 3 == 0:
+            content += '%d,%d,%d,%.3f,"multi\r\nline ""%s""",POINT (%d %d)\r\n' % (i, -i, 12345678901 * i, i / 7.0, 'x' * (i % 50), i % 20, i % 30)
+        elif i % 3 == 1:
+            content += '%d,%d,-%d,-0.5e%d,plain,"POINT (%d %d)"\n\n' % (i, i, i, i % 5, i % 20, i % 30)
+        else:
+            content += '%d,,,abc,,\n' % i
+    gdal.FileFromMemBuffer(filename, content)
+    gdal.FileFromMemBuffer(filename + 't', 'Integer,Integer,Integer64,Real,String,String')
+
+    def read(num_threads, spatial_filter=False):
+        with gdaltest.config_options({'GDAL_NUM_THREADS': num_threads,
+                                      'OGR_CSV_CHUNK_SIZE': '1000'}):
+            ds = ogr.Open(filename)
+            lyr = ds.GetLayer(0)
+            if spatial_filter:
+                lyr.SetSpatialFilterRect(0, 0, 5, 5)
+            with gdaltest.error_handler():
+                ret = [(f.GetFID(), f['id'], f['int'], f['int64'], f['real'], f['str'], f.GetGeometryRef().ExportToWkt() if f.GetGeometryRef() else None) for f in lyr]
+            if not spatial_filter:
+                assert gdal.GetLastErrorMsg() == 'Invalid value type found in record 3 for field real. This warning will no longer be emitted.'
+            assert lyr.GetFeatureCount() == (len(ret) if spatial_filter else 1000)
+            # Random access in the middle of the reading
+            lyr.ResetReading()
+            lyr.GetNextFeature()
+            assert lyr.GetFeature(500)['id'] == 499
+            if not spatial_filter:
+                assert lyr.GetNextFeature()['id'] == 500
+            return ret
+
+    expected = read('1')
+    assert len(expected) == 1000
+    assert expected[0][5] == 'multi\nline ""'
+    assert expected[3][5] == 'multi\nline "xxx"'
+    assert read('4') == expected
+
+    expected = read('1', spatial_filter=True)
+    assert len(expected) < 1000
+    assert read('4', spatial_filter=True) == expected
+
+    gdal.Unlink(filename)
+    gdal.Unlink(filename + 't')
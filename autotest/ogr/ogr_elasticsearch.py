@@ -2615,3 +2615,45 @@ def test_ogr_elasticsearch_timeout_terminate_after():
     assert lyr.GetNextFeature() is not None
     time.sleep(0.15)
     assert lyr.GetNextFeature() is None
+
+###############################################################################
+# Test BULK_CONCURRENCY
+
+
+def test_ogr_elasticsearch_bulk_concurrency():
+
+    ogr_elasticsearch_delete_files()
+
+    gdal.FileFromMemBuffer("/vsimem/fakeelasticsearch",
+                           """{"version":{"number":"7.0.0"}}""")
+
+    ds = ogrtest.elasticsearch_drv.CreateDataSource(
+        "/vsimem/fakeelasticsearch")
+    assert ds is not None
+
+    gdal.FileFromMemBuffer(
+        '/vsimem/fakeelasticsearch/bulk_concurrency&CUSTOMREQUEST=PUT', "{}")
+    lyr = ds.CreateLayer('bulk_concurrency', srs=ogrtest.srs_wgs84,
+                         options=['GEO_SHAPE_ENCODING=WKT',
+                                  'BULK_SIZE=1', 'BULK_CONCURRENCY=2'])
+    gdal.FileFromMemBuffer(
+        """/vsimem/fakeelasticsearch/bulk_concurrency/_mapping&POSTFIELDS={ "properties": { "geometry": { "type": "geo_shape" } }, "_meta": { "fid": "ogc_fid" } }""", '{}')
+    for i in range(4):
+        gdal.FileFromMemBuffer("""/vsimem/fakeelasticsearch/_bulk&POSTFIELDS={"index" :{"_index":"bulk_concurrency"}}
+{ "ogc_fid": %d, "geometry": "POINT (%d 49)" }
+
+""" % (i + 1, i), "{}")
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (%d 49)' % i))
+        assert lyr.CreateFeature(f) == 0
+    assert lyr.SyncToDisk() == 0
+
+    # The request for this feature fails: the error is reported at the
+    # latest when the layer is synchronized
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (10 49)'))
+    with gdaltest.error_handler():
+        lyr.CreateFeature(f)
+        ret = lyr.SyncToDisk()
+    assert ret != 0
+    assert gdal.GetLastErrorMsg() != ''
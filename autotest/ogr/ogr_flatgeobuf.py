@@ -869,3 +869,184 @@ def test_ogr_flatgeobuf_coordinate_epoch_custom_wkt():
     ds = None
 
     ogr.GetDriverByName('FlatGeobuf').DeleteDataSource(filename)
+
+
+###############################################################################
+
+
+def test_ogr_flatgeobuf_attribute_index():
+
+    filename = '/vsimem/test_ogr_flatgeobuf_attribute_index.fgb'
+    ds = ogr.GetDriverByName('FlatGeobuf').CreateDataSource(filename)
+    lyr = ds.CreateLayer('test', geom_type=ogr.wkbPoint)
+    lyr.CreateField(ogr.FieldDefn('id', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('str', ogr.OFTString))
+    values = []
+    for i in range(1000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f['id'] = i
+        int_val = None if i % 17 == 0 else i % 100
+        real_val = i * 0.5
+        str_val = None if i % 13 == 0 else ('Val%03d' % i if i % 2 else 'other%d' % i)
+        if int_val is not None:
+            f['int'] = int_val
+        f['real'] = real_val
+        if str_val is not None:
+            f['str'] = str_val
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (%d %d)' % (i, i)))
+        lyr.CreateFeature(f)
+        values.append((int_val, real_val, str_val))
+    ds = None
+
+    filters = [
+        ("int = 5", lambda v: v[0] == 5),
+        ("int IN (5, 7)", lambda v: v[0] in (5, 7)),
+        ("int > 95", lambda v: v[0] is not None and v[0] > 95),
+        ("int >= 95.5", lambda v: v[0] is not None and v[0] >= 95.5),
+        ("3 > int", lambda v: v[0] is not None and v[0] < 3),
+        ("int BETWEEN 10 AND 12", lambda v: v[0] is not None and 10 <= v[0] <= 12),
+        ("int IS NULL", lambda v: v[0] is None),
+        ("real < 10", lambda v: v[1] < 10),
+        ("real >= 10 AND real <= 11", lambda v: 10 <= v[1] <= 11),
+        ("str = 'val101'", lambda v: v[2] == 'Val101'),
+        ("str > 'val990'", lambda v: v[2] is not None and v[2].lower() > 'val990'),
+        ("str ILIKE 'val99%'", lambda v: v[2] is not None and v[2].lower().startswith('val99')),
+        ("str LIKE 'other1%' OR int = 3", lambda v: (v[2] is not None and v[2].startswith('other1')) or v[0] == 3),
+        ("str IS NULL AND int < 20", lambda v: v[2] is None and v[0] is not None and v[0] < 20),
+    ]
+
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    ds.ExecuteSQL('CREATE INDEX ON test USING int')
+    ds.ExecuteSQL('CREATE INDEX ON test USING real')
+    ds.ExecuteSQL('CREATE INDEX ON test USING str')
+    assert gdal.VSIStatL(filename + '.ogridx') is not None
+
+    for (attr_filter, check) in filters:
+        expected = [i for i, v in enumerate(values) if check(v)]
+        lyr.SetAttributeFilter(attr_filter)
+        got = sorted(f['id'] for f in lyr)
+        assert got == expected, attr_filter
+
+    # Combined with a spatial filter
+    lyr.SetAttributeFilter('int < 10')
+    lyr.SetSpatialFilterRect(100.5, 100.5, 500.5, 500.5)
+    got = sorted(f['id'] for f in lyr)
+    assert got == [i for i, v in enumerate(values)
+                   if 100 < i <= 500 and v[0] is not None and v[0] < 10]
+    lyr.SetSpatialFilter(None)
+    ds = None
+
+    # Re-open to check the persisted index, and drop it
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    lyr.SetAttributeFilter("real BETWEEN 100 AND 101")
+    assert sorted(f['id'] for f in lyr) == [200, 201, 202]
+    ds.ExecuteSQL('DROP INDEX ON test')
+    assert gdal.VSIStatL(filename + '.ogridx') is None
+    lyr.SetAttributeFilter("real BETWEEN 100 AND 101")
+    assert sorted(f['id'] for f in lyr) == [200, 201, 202]
+    ds = None
+
+    ogr.GetDriverByName('FlatGeobuf').DeleteDataSource(filename)
+
+
+###############################################################################
+# Check that spatial index searches give the same results on a local file,
+# read feature by feature, and on a /vsimem/ one, where found features are
+# prefetched by batches.
+
+
+def test_ogr_flatgeobuf_spatial_filter_prefetch():
+
+    local_filename = 'tmp/test_ogr_flatgeobuf_spatial_filter_prefetch.fgb'
+    ds = ogr.GetDriverByName('FlatGeobuf').CreateDataSource(local_filename)
+    lyr = ds.CreateLayer('test', geom_type=ogr.wkbUnknown)
+    lyr.CreateField(ogr.FieldDefn('id', ogr.OFTInteger))
+    for i in range(3000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f['id'] = i
+        if i == 1500:
+            # Larger than the maximum size of a prefetched feature
+            g = ogr.Geometry(ogr.wkbLineString)
+            for j in range(100000):
+                g.AddPoint_2D(j * 1e-3, j * 1e-3)
+        else:
+            g = ogr.CreateGeometryFromWkt('POINT (%d %d)' % (i % 100, i // 100))
+        f.SetGeometry(g)
+        lyr.CreateFeature(f)
+    ds = None
+
+    vsimem_filename = '/vsimem/test_ogr_flatgeobuf_spatial_filter_prefetch.fgb'
+    gdal.FileFromMemBuffer(vsimem_filename, open(local_filename, 'rb').read())
+
+    def read(filename, rect):
+        ds = ogr.Open(filename)
+        lyr = ds.GetLayer(0)
+        lyr.SetSpatialFilterRect(*rect)
+        ret = [(f.GetFID(), f['id'], f.GetGeometryRef().ExportToWkt()) for f in lyr]
+        lyr.ResetReading()
+        assert [f.GetFID() for f in lyr] == [x[0] for x in ret]
+        return ret
+
+    try:
+        for rect in [(-0.5, -0.5, 99.5, 29.5),
+                     (10.5, 10.5, 20.5, 20.5),
+                     (49.5, 14.5, 50.5, 15.5),
+                     (1000, 1000, 1001, 1001)]:
+            expected = read(local_filename, rect)
+            assert read(vsimem_filename, rect) == expected
+        assert len(read(local_filename, (-0.5, -0.5, 99.5, 29.5))) == 3000
+    finally:
+        gdal.Unlink(vsimem_filename)
+        ogr.GetDriverByName('FlatGeobuf').DeleteDataSource(local_filename)
+
+
+###############################################################################
+# Check that the external sort used when the feature items do not fit in
+# FLATGEOBUF_SORT_MAX_MEMORY gives the same results as the in-memory one.
+
+
+def test_ogr_flatgeobuf_create_spatial_index_external_sort():
+
+    def create(filename):
+        ds = ogr.GetDriverByName('FlatGeobuf').CreateDataSource(filename)
+        lyr = ds.CreateLayer('test', geom_type=ogr.wkbPoint)
+        lyr.CreateField(ogr.FieldDefn('id', ogr.OFTInteger))
+        for i in range(20000):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            f['id'] = i
+            f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (%d %d)' % ((i * 7919) % 200, i // 100)))
+            lyr.CreateFeature(f)
+        ds = None
+
+    filename_ref = '/vsimem/test_ogr_flatgeobuf_create_spatial_index_external_sort_ref.fgb'
+    filename = '/vsimem/test_ogr_flatgeobuf_create_spatial_index_external_sort.fgb'
+    try:
+        create(filename_ref)
+        with gdaltest.config_option('FLATGEOBUF_SORT_MAX_MEMORY', '1'):
+            create(filename)
+
+        ds_ref = ogr.Open(filename_ref)
+        lyr_ref = ds_ref.GetLayer(0)
+        ds = ogr.Open(filename)
+        lyr = ds.GetLayer(0)
+        assert lyr.GetFeatureCount() == 20000
+        assert lyr.GetExtent() == lyr_ref.GetExtent()
+        assert sorted(f['id'] for f in lyr) == list(range(20000))
+
+        for rect in [(-0.5, -0.5, 199.5, 199.5),
+                     (10.5, 10.5, 20.5, 20.5),
+                     (100, 150, 100, 150),
+                     (1000, 1000, 1001, 1001)]:
+            lyr_ref.SetSpatialFilterRect(*rect)
+            lyr.SetSpatialFilterRect(*rect)
+            expected = sorted((f['id'], f.GetGeometryRef().ExportToWkt()) for f in lyr_ref)
+            assert sorted((f['id'], f.GetGeometryRef().ExportToWkt()) for f in lyr) == expected
+        ds = None
+        ds_ref = None
+    finally:
+        gdal.Unlink(filename_ref)
+        gdal.Unlink(filename)
@@ -1690,6 +1690,27 @@ def test_ogr_geojson_50():
 
     assert '0.00001234' in data and '1.23456789012456' in data
 
+###############################################################################
+# Test that coordinates are written with the shortest representation that
+# round-trips when no precision is specified
+
+
+def test_ogr_geojson_coordinates_shortest_round_trip():
+
+    g = ogr.CreateGeometryFromWkt('POINT (0.1 2)')
+    assert g.ExportToJson() == '{ "type": "Point", "coordinates": [ 0.1, 2.0 ] }'
+
+    x = 0.1 + 0.2
+    y = 1.0 / 3
+    g = ogr.Geometry(ogr.wkbPoint)
+    g.AddPoint_2D(x, y)
+    j = json.loads(g.ExportToJson())
+    assert j['coordinates'][0] == x
+    assert j['coordinates'][1] == y
+
+    # COORDINATE_PRECISION still applies
+    assert '0.333' in g.ExportToJson(['COORDINATE_PRECISION=3'])
+
 ###############################################################################
 # Test writing empty geometries
 
@@ -3163,3 +3184,50 @@ def test_ogr_geojson_export_geometry_axis_order():
     # No CRS
     g = ogr.CreateGeometryFromWkt('POINT (2 49)')
     assert json.loads(g.ExportToJson()) == { "type": "Point", "coordinates": [ 2.0, 49.0 ] }
+
+
+###############################################################################
+# Test that the direct translation of features by the streaming parser gives
+# the same result as the json-c based one
+
+def test_ogr_geojson_direct_read():
+
+    filename = '/vsimem/test_ogr_geojson_direct_read.json'
+    gdal.FileFromMemBuffer(filename, """{"type": "FeatureCollection", "features": [
+{"type": "Feature", "id": 1, "properties": {"int": 1, "real": 1.5, "str": "foo", "bool": true, "int64": 1234567890123, "mixed": 1, "list": [1, 2], "obj": {"a": 1}, "null": null}, "geometry": {"type": "Point", "coordinates": [2, 49]}},
+{"type": "Feature", "properties": {"int": -3, "real": 1e-5, "str": 2, "bool": false, "int64": -1, "mixed": "bar", "list": [3], "obj": null}, "geometry": {"type": "LineString", "coordinates": [[1, 2], [3, 4, 5], [0.12345678901234567, -0.0]]}},
+{"type": "Feature", "properties": {"int": 2147483648, "real": 3, "str": null, "mixed": 1.25}, "geometry": {"type": "Polygon", "coordinates": [[[0, 0], [0, 1], [1, 1], [0, 0]], [[0.1, 0.1], [0.1, 0.2], [0.2, 0.2], [0.1, 0.1]]]}},
+{"type": "Feature", "properties": {"real": 12345678901234567890}, "geometry": {"type": "MultiPoint", "coordinates": [[1, 2], [3, 4, 5]]}},
+{"type": "Feature", "properties": {"real": -1.7976931348623157e308}, "geometry": {"type": "MultiLineString", "coordinates": [[[1, 2], [3, 4]], [[5, 6], [7, 8]]]}},
+{"type": "Feature", "properties": {}, "geometry": {"type": "MultiPolygon", "coordinates": [[[[0, 0], [0, 1], [1, 1], [0, 0]]], [[[2, 2], [2, 3], [3, 3], [2, 2]]]]}},
+{"type": "Feature", "properties": {}, "geometry": {"type": "GeometryCollection", "geometries": [{"type": "Point", "coordinates": [1, 2]}]}},
+{"type": "Feature", "properties": {}, "geometry": {"type": "Point", "coordinates": [1, 2], "crs": {"type": "name", "properties": {"name": "EPSG:32631"}}}},
+{"type": "Feature", "properties": {}, "geometry": {"type": "LineString", "coordinates": [[1, 2], [3, "4"]]}},
+{"type": "Feature", "properties": {}, "geometry": {"type": "LineString", "coordinates": []}},
+{"type": "Feature", "properties": {}, "geometry": {"type": "Polygon", "coordinates": [[]]}},
+{"type": "Feature", "properties": {}, "geometry": {"type": "Point", "coordinates": [1]}},
+{"type": "Feature", "properties": {}, "geometry": null}
+]}""")
+
+    def read_features():
+        ds = ogr.Open(filename)
+        lyr = ds.GetLayer(0)
+        ret = []
+        for f in lyr:
+            g = f.GetGeometryRef()
+            srs = g.GetSpatialReference() if g else None
+            ret.append((f.GetFID(), f.ExportToJson(),
+                        g.ExportToIsoWkt() if g else None,
+                        srs.ExportToWkt() if srs else None))
+        return ret
+
+    with gdaltest.config_option('OGR_GEOJSON_DIRECT_READ', 'NO'):
+        with gdaltest.error_handler():
+            expected = read_features()
+    with gdaltest.error_handler():
+        got = read_features()
+
+    gdal.Unlink(filename)
+
+    assert len(expected) == 13
+    assert got == expected
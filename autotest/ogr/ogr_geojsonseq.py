@@ -195,6 +195,72 @@ def test_ogr_geojsonseq_read_rs_json_pretty():
     assert lyr.GetNextFeature() is None
 
 
+def test_ogr_geojsonseq_spatial_filter():
+
+    filename = '/vsimem/test_ogr_geojsonseq_spatial_filter.geojsonl'
+    gdal.FileFromMemBuffer(filename,
+"""{"type":"Feature","properties":{"n":1},"geometry":{"type":"Point","coordinates":[1,1]}}
+{"type":"Feature","properties":{"n":2},"geometry":{"type":"Point","coordinates":[20,20]}}
+{"type":"Feature","properties":{"n":3},"geometry":{"type":"LineString","coordinates":[[-5,-5],[5,5]]}}
+{"type":"Feature","properties":{"n":4},"geometry":null}
+{"type":"Feature","properties":{"n":5},"geometry":{"type":"GeometryCollection","geometries":[{"type":"Point","coordinates":[30,30]}]}}
+{"type":"Feature","properties":{"n":6},"geometry":{"type":"Polygon","coordinates":[[[20,20],[20,30],[30,30],[20,20]]]}}
+{"type":"Feature","properties":{"n":7},"geometry":{"type":"Point","coordinates":[2,2]}}
+""")
+
+    ds = ogr.Open(filename)
+    lyr = ds.GetLayer(0)
+    lyr.SetSpatialFilterRect(0, 0, 10, 10)
+    # Features skipped before being translated must still consume a FID
+    assert [(f['n'], f.GetFID()) for f in lyr] == [(1, 0), (3, 2), (7, 6)]
+    lyr.SetSpatialFilter(None)
+    assert lyr.GetFeatureCount() == 7
+    ds = None
+
+    gdal.Unlink(filename)
+
+
+def test_ogr_geojsonseq_multithreaded_reading():
+
+    filename = '/vsimem/test_ogr_geojsonseq_multithreaded_reading.geojsonl'
+    content = ''
+    for i in range(1000):
+        if i % 3 == 0:
+            content += '{"type":"Feature","id":%d,"properties":{"n":%d,"s":"%s"},"geometry":{"type":"Point","coordinates":[%d,%d]}}\r\n' % (10000 + i, i, 'x' * (i % 50), i % 20, i % 30)
+        elif i % 3 == 1:
+            content += '{"type":"Feature","properties":{"n":%d},"geometry":{"type":"LineString","coordinates":[[%d,0],[%d,1]]}}\n' % (i, i % 20, i % 20)
+        else:
+            content += '{"type":"Point","coordinates":[%d,%d]}\n\n' % (i % 20, i % 30)
+    gdal.FileFromMemBuffer(filename, content)
+
+    def read(num_threads, preserve_order='YES', spatial_filter=False):
+        with gdaltest.config_options({'GDAL_NUM_THREADS': num_threads,
+                                      'OGR_GEOJSONSEQ_PRESERVE_ORDER': preserve_order,
+                                      'OGR_GEOJSONSEQ_CHUNK_SIZE': '1000'}):
+            ds = ogr.Open(filename)
+            lyr = ds.GetLayer(0)
+            assert lyr.GetFeatureCount() == 1000
+            if spatial_filter:
+                lyr.SetSpatialFilterRect(0, 0, 5, 5)
+            ret = [(f.GetFID(), f['n'], f['s'], f.GetGeometryRef().ExportToWkt()) for f in lyr]
+            lyr.ResetReading()
+            assert lyr.GetNextFeature() is not None
+            return ret
+
+    expected = read('1')
+    assert len(expected) == 1000
+    assert read('4') == expected
+    # Without order preservation, FIDs are assigned in the order of delivery
+    assert sorted(str(x[1:]) for x in read('4', preserve_order='NO')) == \
+        sorted(str(x[1:]) for x in expected)
+
+    expected = read('1', spatial_filter=True)
+    assert len(expected) < 1000
+    assert read('4', spatial_filter=True) == expected
+
+    gdal.Unlink(filename)
+
+
 def test_ogr_geojsonseq_test_ogrsf():
 
     import test_cli_utilities
@@ -3861,3 +3861,48 @@ def test_ogr_gml_srs_name_in_xsd(gml_format):
 
     gdal.Unlink(filename)
     gdal.Unlink(xsdfilename)
+
+###############################################################################
+# Test that decoding geometries in parallel gives the same result
+
+
+def test_ogr_gml_read_multithreaded_geometry_decoding():
+
+    if not gdaltest.have_gml_reader:
+        pytest.skip()
+
+    filename = '/vsimem/test_ogr_gml_read_multithreaded.gml'
+    ds = ogr.GetDriverByName('GML').CreateDataSource(filename,
+                                                       options=['FORMAT=GML3'])
+    lyr = ds.CreateLayer('test', geom_type=ogr.wkbUnknown)
+    lyr.CreateField(ogr.FieldDefn('id', ogr.OFTInteger))
+    for i in range(1000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f['id'] = i
+        if i % 3 == 0:
+            wkt = 'LINESTRING (%d 0,%d 1,%d 2)' % (i, i + 1, i + 2)
+        elif i % 3 == 1:
+            wkt = 'LINESTRING Z (%d 0 1,%d 1 2)' % (i, i + 1)
+        else:
+            wkt = 'POLYGON ((%d 0,%d 1,%d 1,%d 0))' % (i, i, i + 1, i)
+        f.SetGeometry(ogr.CreateGeometryFromWkt(wkt))
+        lyr.CreateFeature(f)
+    ds = None
+
+    def read():
+        ds = ogr.Open(filename)
+        lyr = ds.GetLayer(0)
+        ret = [(f['id'], f.GetGeometryRef().ExportToIsoWkt()) for f in lyr]
+        lyr.SetSpatialFilterRect(100, -1, 200.5, 3)
+        ret += [f['id'] for f in lyr]
+        return ret
+
+    ref = read()
+    assert len(ref) > 1000
+    with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+        got = read()
+    assert got == ref
+
+    gdal.Unlink(filename)
+    gdal.Unlink(filename[0:-3] + 'xsd')
+    gdal.Unlink(filename[0:-3] + 'gfs')
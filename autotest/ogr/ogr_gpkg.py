@@ -5182,3 +5182,62 @@ def test_ogr_gpkg_crs_coordinate_epoch():
     ds = None
 
     gdal.Unlink(filename)
+
+###############################################################################
+# Test bulk loading of the RTree when creating the spatial index
+
+
+@pytest.mark.parametrize("bulk_load", ['YES', 'NO'])
+def test_ogr_gpkg_rtree_bulk_load(bulk_load):
+
+    filename = '/vsimem/test_ogr_gpkg_rtree_bulk_load.gpkg'
+    ds = gdaltest.gpkg_dr.CreateDataSource(filename)
+    lyr = ds.CreateLayer('test', options=['SPATIAL_INDEX=NO'])
+    lyr.StartTransaction()
+    for i in range(5000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i % 100 != 99:
+            x = (i * 37) % 1000
+            y = (i * 91) % 1000
+            f.SetGeometryDirectly(ogr.CreateGeometryFromWkt(
+                'LINESTRING (%d %d,%d %d)' % (x, y, x + 1, y + 2)))
+        lyr.CreateFeature(f)
+    lyr.CommitTransaction()
+
+    with gdaltest.config_option('OGR_GPKG_RTREE_BULK_LOAD', bulk_load):
+        ds.ExecuteSQL("SELECT CreateSpatialIndex('test', 'geom')")
+
+    sql_lyr = ds.ExecuteSQL("SELECT rtreecheck('rtree_test_geom')")
+    f = sql_lyr.GetNextFeature()
+    assert f.GetField(0) == 'ok'
+    ds.ReleaseResultSet(sql_lyr)
+
+    sql_lyr = ds.ExecuteSQL('SELECT COUNT(*) FROM rtree_test_geom')
+    f = sql_lyr.GetNextFeature()
+    assert f.GetField(0) == 4950
+    ds.ReleaseResultSet(sql_lyr)
+
+    lyr.SetSpatialFilterRect(100, 200, 150, 250)
+    got_fids = sorted(f.GetFID() for f in lyr)
+    expected_fids = []
+    for i in range(5000):
+        if i % 100 != 99:
+            x = (i * 37) % 1000
+            y = (i * 91) % 1000
+            if x <= 150 and x + 1 >= 100 and y <= 250 and y + 2 >= 200:
+                expected_fids.append(i + 1)
+    assert got_fids == expected_fids
+
+    # Check that the index is still maintained by the triggers
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetGeometryDirectly(ogr.CreateGeometryFromWkt('POINT (125 225)'))
+    lyr.CreateFeature(f)
+    assert lyr.DeleteFeature(1) == ogr.OGRERR_NONE
+    sql_lyr = ds.ExecuteSQL("SELECT rtreecheck('rtree_test_geom')")
+    f = sql_lyr.GetNextFeature()
+    assert f.GetField(0) == 'ok'
+    ds.ReleaseResultSet(sql_lyr)
+    assert lyr.GetFeatureCount() == len(expected_fids) + 1 - (1 in expected_fids)
+
+    ds = None
+    gdal.Unlink(filename)
@@ -29,6 +29,7 @@
 
 
 
+import gdaltest
 from osgeo import gdal
 from osgeo import ogr
 import ogrtest
@@ -517,3 +518,48 @@ def test_ogr_join_23():
 
     ds = None
 
+
+###############################################################################
+# Test that joins resolved with an in-memory hash table of the secondary layer
+# give the same results as per-feature queries
+
+
+@pytest.mark.parametrize("key_type", [ogr.OFTInteger, ogr.OFTInteger64,
+                                      ogr.OFTString])
+def test_ogr_join_hash_table(key_type):
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('first')
+    lyr.CreateField(ogr.FieldDefn('key', key_type))
+    for key in [1, 2, None, 3, 2, 5]:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if key is not None:
+            f['key'] = key if key_type != ogr.OFTString else 'k%d' % key
+        lyr.CreateFeature(f)
+
+    lyr = ds.CreateLayer('second')
+    lyr.CreateField(ogr.FieldDefn('key', key_type))
+    lyr.CreateField(ogr.FieldDefn('val', ogr.OFTString))
+    for key, val in [(2, 'a'), (1, 'b'), (2, 'c'), (None, 'd'), (3, 'e')]:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if key is not None:
+            if key_type != ogr.OFTString:
+                f['key'] = key
+            else:
+                # Attribute filter comparison of strings is case insensitive
+                f['key'] = 'K%d' % key if key == 3 else 'k%d' % key
+        f['val'] = val
+        lyr.CreateFeature(f)
+
+    def get_result():
+        sql_lyr = ds.ExecuteSQL(
+            "SELECT first.key, second.val FROM first "
+            "LEFT JOIN second ON first.key = second.key")
+        res = [(f.GetField(0), f.GetField(1)) for f in sql_lyr]
+        ds.ReleaseResultSet(sql_lyr)
+        return res
+
+    with gdaltest.config_option('OGR_GENSQL_JOIN_MAX_MEMORY', '0'):
+        expected = get_result()
+    assert [x[1] for x in expected] == ['b', 'a', None, 'e', 'a', None]
+    assert get_result() == expected
@@ -312,6 +312,46 @@ def test_ogr_mvt_tileset_without_readdir():
     assert f is not None
 
 ###############################################################################
+# Test reading a tileset with several decoding threads and the decoded tile
+# cache
+
+
+def test_ogr_mvt_tileset_multithreaded_and_cache():
+
+    def get_features(lyr):
+        ret = []
+        for f in lyr:
+            ret.append((f.GetFID(),
+                        [f.GetField(i) for i in range(f.GetFieldCount())],
+                        f.GetGeometryRef().ExportToWkt()))
+        return ret
+
+    def read(num_threads, cache_size):
+        with gdaltest.config_options({'GDAL_NUM_THREADS': num_threads,
+                                      'MVT_TILE_CACHE_SIZE': cache_size}):
+            ds = gdal.OpenEx('data/mvt/point_polygon/1')
+        lyr = ds.GetLayerByName('polygon2')
+        first_pass = get_features(lyr)
+        assert get_features(lyr) == first_pass
+        assert lyr.GetFeatureCount() == len(first_pass)
+        fid = first_pass[-1][0]
+        f = lyr.GetFeature(fid)
+        assert f is not None and f.GetFID() == fid
+        minx, maxx, miny, maxy = ogr.CreateGeometryFromWkt(
+            first_pass[0][2]).GetEnvelope()
+        lyr.SetSpatialFilterRect(minx, miny, maxx, maxy)
+        filtered = get_features(lyr)
+        assert get_features(lyr) == filtered
+        return first_pass, filtered
+
+    ref, ref_filtered = read('1', '0')
+    assert len(ref) > 1
+    assert ref_filtered
+    assert read('1', '32') == (ref, ref_filtered)
+    assert read('4', '0') == (ref, ref_filtered)
+    assert read('4', '32') == (ref, ref_filtered)
+
+###############################################################################
 
 
 def test_ogr_mvt_tileset_tilegl():
@@ -1331,6 +1371,50 @@ def test_ogr_mvt_write_limitations_max_features():
     gdal.Unlink('/vsimem/out.mbtiles')
 
 ###############################################################################
+# Check that tiles encoded by worker threads are identical to the ones
+# encoded by a single thread
+
+
+def test_ogr_mvt_write_multithreaded_identical():
+
+    if not ogrtest.have_geos() or ogr.GetDriverByName('SQLITE') is None:
+        pytest.skip()
+
+    src_ds = gdal.GetDriverByName('Memory').Create('', 0, 0, 0, gdal.GDT_Unknown)
+    for lyr_name in ('lyr1', 'lyr2'):
+        lyr = src_ds.CreateLayer(lyr_name)
+        lyr.CreateField(ogr.FieldDefn('str'))
+        lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger))
+        for i in range(200):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            f.SetField('str', 'val%d' % (i % 7))
+            f.SetField('int', i)
+            x = -10000000 + i * 100000
+            f.SetGeometry(ogr.CreateGeometryFromWkt(
+                'LINESTRING(%d 0,%d 5000000)' % (x, x + 50000)))
+            lyr.CreateFeature(f)
+
+    def get_output(num_threads):
+        with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+            out_ds = gdal.VectorTranslate('/vsimem/outmvt', src_ds, format='MVT',
+                                          datasetCreationOptions=['MAXZOOM=3'])
+        assert out_ds is not None
+        out_ds = None
+        ret = {}
+        for filename in gdal.ReadDirRecursive('/vsimem/outmvt'):
+            if filename.endswith('/'):
+                continue
+            f = gdal.VSIFOpenL('/vsimem/outmvt/' + filename, 'rb')
+            ret[filename] = gdal.VSIFReadL(1, 1000000, f)
+            gdal.VSIFCloseL(f)
+        gdal.RmdirRecursive('/vsimem/outmvt')
+        return ret
+
+    ref = get_output('1')
+    assert len(ref) > 10
+    assert get_output('4') == ref
+
+###############################################################################
 
 
 def test_ogr_mvt_write_custom_tiling_scheme():
@@ -32,6 +32,7 @@
 
 
 import gdaltest
+from osgeo import gdal
 from osgeo import ogr
 import webserver
 import pytest
@@ -279,6 +280,72 @@ def test_ogr_opaif_fc_links_next_geojson():
 ###############################################################################
 
 
+def test_ogr_opaif_prefetch_pages():
+    if gdaltest.opaif_drv is None:
+        pytest.skip()
+
+    if gdaltest.webserver_port == 0:
+        pytest.skip()
+
+    handler = webserver.SequentialHandler()
+    handler.add('GET', '/oapif/collections', 200, {'Content-Type': 'application/json'},
+                '{ "collections" : [ { "name": "foo" }] }')
+    with webserver.install_http_handler(handler):
+        ds = gdal.OpenEx('OAPIF:http://localhost:%d/oapif' % gdaltest.webserver_port,
+                         open_options=['PREFETCH_PAGES=2'])
+    lyr = ds.GetLayer(0)
+
+    def page(val, next_href):
+        links = ''
+        if next_href:
+            links = """"links" : [
+                        { "rel": "next", "type": "application/geo+json", "href": "http://localhost:%d/oapif/%s" }
+                    ],""" % (gdaltest.webserver_port, next_href)
+        return """{ "type": "FeatureCollection", %s
+                    "features": [
+                    {
+                        "type": "Feature",
+                        "properties": {
+                            "foo": "%s"
+                        }
+                    }
+                ] }""" % (links, val)
+
+    handler = webserver.SequentialHandler()
+    handler.add('GET', '/oapif/collections/foo/items?limit=10', 200,
+                {'Content-Type': 'application/geo+json'}, page('bar', None))
+    with webserver.install_http_handler(handler):
+        assert lyr.GetLayerDefn().GetFieldCount() == 1
+
+    handler = webserver.SequentialHandler()
+    handler.add('GET', '/oapif/collections/foo/items?limit=10', 200,
+                {'Content-Type': 'application/geo+json'}, page('1', 'page2'))
+    handler.add('GET', '/oapif/page2', 200,
+                {'Content-Type': 'application/geo+json'}, page('2', 'page3'))
+    handler.add('GET', '/oapif/page3', 200,
+                {'Content-Type': 'application/geo+json'}, page('3', None))
+    with webserver.install_http_handler(handler):
+        assert [f['foo'] for f in lyr] == ['1', '2', '3']
+        assert lyr.GetNextFeature() is None
+
+    # Error on a prefetched page is reported when it is reached
+    handler = webserver.SequentialHandler()
+    handler.add('GET', '/oapif/collections/foo/items?limit=10', 200,
+                {'Content-Type': 'application/geo+json'}, page('1', 'page2'))
+    handler.add('GET', '/oapif/page2', 500)
+    with webserver.install_http_handler(handler):
+        lyr.ResetReading()
+        f = lyr.GetNextFeature()
+        assert f['foo'] == '1'
+        with gdaltest.error_handler():
+            assert lyr.GetNextFeature() is None
+        assert gdal.GetLastErrorMsg() != ''
+
+    ds = None
+
+###############################################################################
+
+
 def test_ogr_opaif_id_is_integer():
     if gdaltest.opaif_drv is None:
         pytest.skip()
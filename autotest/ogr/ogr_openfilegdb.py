@@ -526,6 +526,10 @@ def test_ogr_openfilegdb_4():
              ("id <= 3 AND id >= 3", [3]),
              ("id = 1 AND float = 1.5", [1]),
              ("id BETWEEN 1 AND 5", [1, 2, 3, 4, 5]),
+             ("id BETWEEN 2 AND 4", [2, 3, 4]),
+             ("id BETWEEN 4 AND 2", []),
+             ("id > 1 AND id < 4", [2, 3]),
+             ("4 > id AND 2 <= id", [2, 3]),
              ("id IN (1)", [1]),
              ("id IN (5,4,3,2,1)", [1, 2, 3, 4, 5]),
              ('fid = 1', [1], 0),  # no index used
@@ -599,6 +603,10 @@ def test_ogr_openfilegdb_4():
              ('real >= 0', 86 + 3 * 85, None),
              ('real < 4', 86 + 3 * 85, None),
              ('real > 1 AND real < 2', 0, None),
+             ('real > 0 AND real < 2', 85, 2),
+             ('real >= 3 AND real <= 3', 85, 4),
+             ('real BETWEEN 1 AND 2', 2 * 85, None),
+             ('real BETWEEN 2 AND 1', 0, None),
              ('real < 0', 0, None),
             ]
     for (where_clause, count, start) in tests:
@@ -696,6 +704,12 @@ def test_ogr_openfilegdb_7():
         ("select * from point where id = 1 order by id", 1, 1, 1),
         ("select * from big_layer order by real", 86 + 3 * 85, 1, 1),
         ("select * from big_layer order by real desc", 86 + 3 * 85, 4 * 85, 1),
+        ("select * from big_layer where real <= 2 order by real desc", 86 + 2 * 85, 4 * 85 - 1, 1),
+        ("select * from big_layer where real < 3 order by real desc", 86 + 2 * 85, 4 * 85 - 1, 1),
+        ("select * from big_layer where real between 1 and 2 order by real", 2 * 85, 2, 1),
+        ("select * from big_layer where real between 1 and 2 order by real desc", 2 * 85, 4 * 85 - 1, 1),
+        ("select * from big_layer where real > 0 and real < 3 order by real desc", 2 * 85, 4 * 85 - 1, 1),
+        ("select * from point where id >= 2 and id < 4 order by id desc", 2, 3, 1),
         # Invalid :
         ("select foo from", None, None, None),
         ("select foo from bar", None, None, None),
@@ -711,6 +725,8 @@ def test_ogr_openfilegdb_7():
         ("select * from point where id = 1 or id = 2 order by id", None, None, 0),
         ("select * from point where id = 1 order by id, float", None, None, 0),
         ("select * from point where float > 0 order by id", None, None, 0),
+        ("select * from point where id > 0 and float > 0 order by id", None, None, 0),
+        ("select * from point where id > 0 and id > 1 order by id", None, None, 0),
     ]
 
     for (sql, feat_count, first_fid, expected_optimized) in tests:
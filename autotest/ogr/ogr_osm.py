@@ -833,3 +833,56 @@ def test_ogr_osm_18():
 
 
 
+
+###############################################################################
+# Test that multi-threaded decoding of primitive blocks and resolution of
+# ways give the same result as single-threaded processing
+
+
+def test_ogr_osm_multithreaded_decoding():
+
+    if ogrtest.osm_drv is None:
+        pytest.skip()
+
+    def get_features(num_threads):
+        ret = {}
+        with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+            ds = ogr.Open('data/osm/multi_blocks.pbf')
+            for lyr_name in ('points', 'lines', 'multipolygons'):
+                lyr = ds.GetLayerByName(lyr_name)
+                ret[lyr_name] = [(f.items(), f.GetGeometryRef().ExportToIsoWkt())
+                                 for f in lyr]
+            ds = None
+        return ret
+
+    ref = get_features('1')
+    assert len(ref['points']) > 0
+    assert len(ref['lines']) > 1000
+    assert len(ref['multipolygons']) > 0
+    assert get_features('4') == ref
+
+###############################################################################
+# Test DENSE_NODES_INDEX open option
+
+
+@pytest.mark.parametrize('filename', ['data/osm/test.pbf',
+                                      'data/osm/multi_blocks.pbf'])
+def test_ogr_osm_dense_nodes_index(filename):
+
+    if ogrtest.osm_drv is None:
+        pytest.skip()
+
+    def get_features(dense):
+        ret = {}
+        ds = gdal.OpenEx(filename, gdal.OF_VECTOR,
+                         open_options=['DENSE_NODES_INDEX=' + dense])
+        for lyr_name in ('points', 'lines', 'multipolygons'):
+            lyr = ds.GetLayerByName(lyr_name)
+            ret[lyr_name] = [(f.items(), f.GetGeometryRef().ExportToIsoWkt())
+                             for f in lyr]
+        ds = None
+        return ret
+
+    ref = get_features('NO')
+    assert len(ref['lines']) > 0
+    assert get_features('YES') == ref
@@ -1448,6 +1448,120 @@ def test_ogr_pg_30():
     gdal.SetConfigOption('PG_USE_COPY', gdaltest.pg_use_copy)
 
 
+###############################################################################
+# Test binary COPY (PG_USE_COPY_BINARY)
+
+
+@pytest.mark.parametrize('use_binary', ['NO', 'YES'])
+def test_ogr_pg_copy_binary(use_binary):
+
+    if gdaltest.pg_ds is None:
+        pytest.skip()
+
+    ds = ogr.Open('PG:' + gdaltest.pg_connection_string, update=1)
+    lyr = ds.CreateLayer('ogr_pg_copy_binary', geom_type=ogr.wkbPoint,
+                         options=['OVERWRITE=YES'])
+    fld_defn = ogr.FieldDefn('bool', ogr.OFTInteger)
+    fld_defn.SetSubType(ogr.OFSTBoolean)
+    lyr.CreateField(fld_defn)
+    lyr.CreateField(ogr.FieldDefn('int', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('int64', ogr.OFTInteger64))
+    lyr.CreateField(ogr.FieldDefn('real', ogr.OFTReal))
+    fld_defn = ogr.FieldDefn('str', ogr.OFTString)
+    fld_defn.SetWidth(3)
+    lyr.CreateField(fld_defn)
+    lyr.CreateField(ogr.FieldDefn('binary', ogr.OFTBinary))
+    lyr.CreateField(ogr.FieldDefn('date', ogr.OFTDate))
+
+    with gdaltest.config_options({'PG_USE_COPY': 'YES',
+                                  'PG_USE_COPY_BINARY': use_binary}):
+        for i in range(3):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            if i < 2:
+                f['bool'] = i
+                f['int'] = -123456 * i
+                f['int64'] = 1234567890123 * i
+                f['real'] = 1.25 * i
+                f['str'] = 'éabcd'
+                f.SetFieldBinaryFromHexString('binary', '0001FF')
+                f['date'] = '1969/12/31' if i == 0 else '2022/01/02'
+                f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (%d 2)' % i))
+            assert lyr.CreateFeature(f) == 0
+        lyr.SyncToDisk()
+    ds = None
+
+    ds = ogr.Open('PG:' + gdaltest.pg_connection_string)
+    lyr = ds.GetLayerByName('ogr_pg_copy_binary')
+    for i in range(3):
+        f = lyr.GetNextFeature()
+        if i < 2:
+            assert f['bool'] == i
+            assert f['int'] == -123456 * i
+            assert f['int64'] == 1234567890123 * i
+            assert f['real'] == 1.25 * i
+            assert f['str'] == 'éab'
+            assert f.GetFieldAsBinary('binary') == b'\x00\x01\xff'
+            assert f['date'] == ('1969/12/31' if i == 0 else '2022/01/02')
+            assert f.GetGeometryRef().ExportToWkt() == 'POINT (%d 2)' % i
+        else:
+            for j in range(f.GetFieldCount()):
+                assert not f.IsFieldSetAndNotNull(j)
+            assert f.GetGeometryRef() is None
+    ds = None
+
+    gdaltest.pg_ds.ExecuteSQL('DELLAYER:ogr_pg_copy_binary')
+
+###############################################################################
+# Test reading with and without asynchronous prefetch of cursor pages
+
+
+@pytest.mark.parametrize("cursor_page", ['3', None])
+@pytest.mark.parametrize("prefetch", ['YES', 'NO'])
+def test_ogr_pg_cursor_prefetch(cursor_page, prefetch):
+
+    if gdaltest.pg_ds is None:
+        pytest.skip()
+
+    with gdaltest.config_options({'OGR_PG_CURSOR_PAGE': cursor_page,
+                                  'OGR_PG_CURSOR_PREFETCH': prefetch}):
+        ds = ogr.Open('PG:' + gdaltest.pg_connection_string, update=1)
+        lyr = ds.CreateLayer('ogr_pg_cursor_prefetch', geom_type=ogr.wkbPoint,
+                             options=['OVERWRITE=YES'])
+        lyr.CreateField(ogr.FieldDefn('val', ogr.OFTInteger))
+        lyr.StartTransaction()
+        for i in range(20):
+            f = ogr.Feature(lyr.GetLayerDefn())
+            f['val'] = i
+            f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (%d 2)' % i))
+            lyr.CreateFeature(f)
+        lyr.CommitTransaction()
+        ds = None
+
+        ds = ogr.Open('PG:' + gdaltest.pg_connection_string)
+        lyr = ds.GetLayerByName('ogr_pg_cursor_prefetch')
+        assert [f['val'] for f in lyr] == list(range(20))
+
+        # Use the connection for other requests while reading
+        lyr.ResetReading()
+        for i in range(20):
+            f = lyr.GetNextFeature()
+            assert f['val'] == i
+            if i % 4 == 0:
+                assert lyr.GetFeatureCount() == 20
+                sql_lyr = ds.ExecuteSQL('SELECT 1')
+                ds.ReleaseResultSet(sql_lyr)
+        assert lyr.GetNextFeature() is None
+
+        lyr.ResetReading()
+        lyr.GetNextFeature()
+        assert lyr.SetNextByIndex(10) == 0
+        for i in range(10, 20):
+            assert lyr.GetNextFeature()['val'] == i
+        assert lyr.GetNextFeature() is None
+        ds = None
+
+    gdaltest.pg_ds.ExecuteSQL('DELLAYER:ogr_pg_cursor_prefetch')
+
 ###############################################################################
 # Test the tables= connection string option
 
@@ -405,6 +405,42 @@ def test_ogr_s57_update_dsid():
     assert f['DSID_ISDT'] == '20190212'
 
 
+###############################################################################
+# Test that assembling area geometries with several threads gives the same
+# result as the sequential code path
+
+
+def test_ogr_s57_multithreaded_area_assembly():
+
+    def get_features(ds):
+        ret = []
+        for lyr in ds:
+            for f in lyr:
+                ret.append(f.ExportToJson())
+        return ret
+
+    ds = ogr.Open('data/s57/1B5X02NE.000')
+    ref = get_features(ds)
+    ds = None
+
+    with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+        ds = ogr.Open('data/s57/1B5X02NE.000')
+    assert get_features(ds) == ref
+
+    # Interleaved reading between layers
+    lyr_depare = ds.GetLayerByName('DEPARE')
+    lyr_lndare = ds.GetLayerByName('LNDARE')
+    lyr_depare.ResetReading()
+    lyr_lndare.ResetReading()
+    f1 = lyr_depare.GetNextFeature()
+    f2 = lyr_lndare.GetNextFeature()
+    f3 = lyr_depare.GetNextFeature()
+    assert f1 is not None and f2 is not None and f3 is not None
+    assert f1.ExportToJson() in ref
+    assert f2.ExportToJson() in ref
+    assert f3.ExportToJson() in ref
+
+
 ###############################################################################
 #  Cleanup
 
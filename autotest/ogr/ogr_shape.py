@@ -38,6 +38,7 @@ import ogrtest
 from osgeo import gdal
 from osgeo import ogr
 from osgeo import osr
+
 import pytest
 
 ###############################################################################
@@ -4894,6 +4895,135 @@ def test_ogr_shape_write_multipolygon_z_non_finite():
     ogr.GetDriverByName('ESRI Shapefile').DeleteDataSource('/vsimem/test.shp')
 
 ###############################################################################
+# Test that reading records through the .shp memory mapping gives the same
+# result as through SHPReadObject()
+
+
+@pytest.mark.parametrize("filename", ['data/poly.shp',
+                                      'data/shp/testpoly.shp',
+                                      'data/shp/gjmultipoint.shp',
+                                      'data/shp/gjmultiline.shp',
+                                      'data/shp/testpointzm.shp',
+                                      'data/shp/testpointm.shp',
+                                      'data/shp/arcm_with_m.shp',
+                                      'data/shp/arcm_without_m.shp',
+                                      'data/shp/polygonm_with_m.shp',
+                                      'data/shp/multipointz_without_m.shp',
+                                      'data/shp/multipatch.shp',
+                                      'data/shp/buggymultipoly.shp'])
+def test_ogr_shape_read_mmap(filename):
+
+    def read_geometries(use_mmap, spatial_filter=None):
+        with gdaltest.config_option('SHAPE_USE_MMAP', use_mmap):
+            ds = ogr.Open(filename)
+        lyr = ds.GetLayer(0)
+        if spatial_filter:
+            lyr.SetSpatialFilterRect(*spatial_filter)
+        ret = []
+        with gdaltest.error_handler():
+            for f in lyr:
+                g = f.GetGeometryRef()
+                ret.append((f.GetFID(), g.ExportToIsoWkt() if g else None))
+            f = lyr.GetFeature(0)
+        g = f.GetGeometryRef() if f else None
+        ret.append(g.ExportToIsoWkt() if g else None)
+        return ret
+
+    assert read_geometries('YES') == read_geometries('NO')
+
+    ds = ogr.Open(filename)
+    minx, maxx, miny, maxy = ds.GetLayer(0).GetExtent()
+    ds = None
+    half = (minx, miny, (minx + maxx) / 2, (miny + maxy) / 2)
+    assert read_geometries('YES', half) == read_geometries('NO', half)
+
+###############################################################################
+# Test attribute filters that are evaluated on .dbf fields before decoding
+# the geometry, and ones that are not
+
+
+def test_ogr_shape_attribute_filter_on_dbf_fields():
+
+    ds = ogr.Open('data/poly.shp')
+    lyr = ds.GetLayer(0)
+
+    lyr.SetAttributeFilter('EAS_ID = 170 OR FID = 0')
+    assert [f.GetFID() for f in lyr] == [0, 9]
+    lyr.ResetReading()
+    f = lyr.GetNextFeature()
+    assert f.GetField('PRFEDEA') == '35043411'
+    assert f.GetGeometryRef() is not None
+
+    lyr.SetAttributeFilter("OGR_GEOMETRY = 'POLYGON' AND EAS_ID = 170")
+    assert [f.GetFID() for f in lyr] == [9]
+
+    lyr.SetIgnoredFields(['PRFEDEA'])
+    lyr.SetAttributeFilter('EAS_ID < 169')
+    fids = []
+    for f in lyr:
+        assert not f.IsFieldSet('PRFEDEA')
+        assert f.GetField('EAS_ID') < 169
+        fids.append(f.GetFID())
+    assert fids == [0, 6, 7, 8]
+
+    lyr.SetAttributeFilter(None)
+    assert lyr.GetFeatureCount() == 10
+
+###############################################################################
+# Test the in-memory spatial index used when there is no .qix or .sbn
+
+
+def test_ogr_shape_in_memory_spatial_index():
+
+    filename = '/vsimem/test_ogr_shape_in_memory_spatial_index.shp'
+    ds = ogr.GetDriverByName('ESRI Shapefile').CreateDataSource(filename)
+    lyr = ds.CreateLayer('test', geom_type=ogr.wkbLineString)
+    for i in range(100):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        # Horizontal lines have degenerate bounding boxes
+        if i % 2 == 0:
+            f.SetGeometry(ogr.CreateGeometryFromWkt(
+                'LINESTRING (%d %d,%d %d)' % (i, i, i + 1, i)))
+        else:
+            f.SetGeometry(ogr.CreateGeometryFromWkt(
+                'LINESTRING (%d %d,%d %d)' % (i, i, i + 1, i + 1)))
+        lyr.CreateFeature(f)
+    f = ogr.Feature(lyr.GetLayerDefn())
+    lyr.CreateFeature(f)
+    ds = None
+
+    def get_fids(use_spi, rect):
+        with gdaltest.config_option('SHAPE_IN_MEMORY_SPATIAL_INDEX', use_spi):
+            ds = ogr.Open(filename)
+            lyr = ds.GetLayer(0)
+            ret = []
+            for r in rect:
+                lyr.SetSpatialFilterRect(*r)
+                ret.append([f.GetFID() for f in lyr])
+        return ret
+
+    rects = [(10.5, 10.5, 20.5, 20.5), (-10, -10, 0.5, 0.5),
+             (50, 50, 50, 50), (200, 200, 300, 300), (0, 30.5, 1000, 40.5)]
+    ref = get_fids('NO', rects)
+    assert ref[0] == list(range(11, 21))
+    assert get_fids('YES', rects) == ref
+
+    # Check that the index is discarded when the layer is modified
+    ds = ogr.Open(filename, update=1)
+    lyr = ds.GetLayer(0)
+    lyr.SetSpatialFilterRect(10.5, 10.5, 20.5, 20.5)
+    assert [f.GetFID() for f in lyr] == list(range(11, 21))
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f.SetGeometry(ogr.CreateGeometryFromWkt('LINESTRING (15 15,16 16)'))
+    lyr.CreateFeature(f)
+    lyr.DeleteFeature(12)
+    lyr.ResetReading()
+    assert [f.GetFID() for f in lyr] == [11] + list(range(13, 21)) + [101]
+    ds = None
+
+    ogr.GetDriverByName('ESRI Shapefile').DeleteDataSource(filename)
+
+###############################################################################
 
 
 def test_ogr_shape_cleanup():
@@ -1530,6 +1530,54 @@ def test_ogr_rfc28_in_date_filter():
     _ogr_in_date_filter_check([])
 
 
+###############################################################################
+# Test that attribute filters evaluated through their compiled form give the
+# same results as the generic expression evaluator
+
+
+@pytest.mark.parametrize("where", [
+    "i = 2", "2 = i", "i <> 2", "i < 2", "2 < i", "i >= 2", "i <= 2",
+    "i > 1.5", "1.5 >= i", "i IN (1, 3)", "i BETWEEN 1 AND 2",
+    "i IS NULL", "i IS NOT NULL", "NOT i = 2",
+    "i64 = 1234567890123", "i64 > 3", "i64 IN (3, 1234567890123)",
+    "r = 1.5", "r > 1", "r IN (1.5, 2.5)", "r BETWEEN 1 AND 2.5",
+    "r < 2 OR s = 'b'", "s = 'B'", "s <> 'a'", "s > 'a'", "'a' < s",
+    "s IN ('a', 'C')", "s BETWEEN 'a' AND 'b'", "s LIKE 'a%'",
+    "s = 'x+00'", "ts = '2021-01-01 00:00:00'",
+    "(i = 1 AND r = 1.5) OR (i = 3 AND NOT s IS NULL)",
+    "FID = 1", "FID IN (0, 2)",
+])
+def test_ogr_rfc28_compiled_filter(where):
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test')
+    lyr.CreateField(ogr.FieldDefn('i', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('i64', ogr.OFTInteger64))
+    lyr.CreateField(ogr.FieldDefn('r', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('s', ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn('ts', ogr.OFTString))
+    for i, i64, r, s, ts in [(1, 3, 1.5, 'a', '2021-01-01 00:00:00+00'),
+                             (2, 1234567890123, 2.5, 'b', '2021-01-01'),
+                             (None, None, None, None, None),
+                             (3, -1, float('nan'), 'x+00', 'x')]:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if i is not None:
+            f['i'] = i
+            f['i64'] = i64
+            f['r'] = r
+            f['s'] = s
+            f['ts'] = ts
+        lyr.CreateFeature(f)
+
+    def get_fids():
+        assert lyr.SetAttributeFilter(where) == 0
+        return [f.GetFID() for f in lyr]
+
+    with gdaltest.config_options({'OGR_SQL_COMPILE_FILTER': 'NO'}):
+        expected = get_fids()
+    assert get_fids() == expected
+
+
 ###############################################################################
 
 
@@ -1911,3 +1911,50 @@ def test_ogr_sql_sqlite_field_names_same_case():
     assert f['id'] == 'foo'
     assert f['ID3'] == 'bar'
     assert f['ID2'] == 'baz'
+
+###############################################################################
+# Test that fields and geometries not used by the query are skipped, and
+# that the source layer is restored afterwards
+
+
+def test_ogr_sql_sqlite_unused_fields_ignored():
+
+    ds = ogr.GetDriverByName('ESRI Shapefile').CreateDataSource('/vsimem/ogr_sql_sqlite_unused_fields_ignored.shp')
+    lyr = ds.CreateLayer('ogr_sql_sqlite_unused_fields_ignored')
+    lyr.CreateField(ogr.FieldDefn('a', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('b'))
+    lyr.CreateField(ogr.FieldDefn('c'))
+    f = ogr.Feature(lyr.GetLayerDefn())
+    f['a'] = 1
+    f['b'] = 'foo'
+    f['c'] = 'bar'
+    f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (1 2)'))
+    lyr.CreateFeature(f)
+    f = None
+
+    sql_lyr = ds.ExecuteSQL("SELECT b FROM ogr_sql_sqlite_unused_fields_ignored WHERE c = 'bar'", dialect='SQLite')
+    f = sql_lyr.GetNextFeature()
+    assert f['b'] == 'foo'
+    ds.ReleaseResultSet(sql_lyr)
+
+    sql_lyr = ds.ExecuteSQL('SELECT a + 1 AS x, GEOMETRY FROM ogr_sql_sqlite_unused_fields_ignored', dialect='SQLite')
+    f = sql_lyr.GetNextFeature()
+    assert f['x'] == 2
+    assert f.GetGeometryRef().ExportToWkt() == 'POINT (1 2)'
+    ds.ReleaseResultSet(sql_lyr)
+
+    sql_lyr = ds.ExecuteSQL('SELECT COUNT(*) FROM ogr_sql_sqlite_unused_fields_ignored', dialect='SQLite')
+    f = sql_lyr.GetNextFeature()
+    assert f.GetField(0) == 1
+    ds.ReleaseResultSet(sql_lyr)
+
+    lyr.ResetReading()
+    f = lyr.GetNextFeature()
+    assert f['a'] == 1
+    assert f['b'] == 'foo'
+    assert f['c'] == 'bar'
+    assert f.GetGeometryRef() is not None
+    f = None
+
+    ds = None
+    ogr.GetDriverByName('ESRI Shapefile').DeleteDataSource('/vsimem/ogr_sql_sqlite_unused_fields_ignored.shp')
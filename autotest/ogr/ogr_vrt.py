@@ -1673,6 +1673,72 @@ def test_ogr_vrt_29():
     os.unlink('tmp/ogr_vrt_29_2.vrt')
 
 
+###############################################################################
+# Test OGRVRTWarpedLayer with a cache of warped geometries
+
+
+def test_ogr_vrt_warped_layer_geometry_cache():
+
+    src_ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    sr = osr.SpatialReference()
+    sr.ImportFromEPSG(4326)
+    src_lyr = src_ds.CreateLayer('ogr_vrt_warped_cache', srs=sr)
+    for i in range(5):
+        for j in range(5):
+            feat = ogr.Feature(src_lyr.GetLayerDefn())
+            feat.SetGeometry(ogr.CreateGeometryFromWkt('POINT(%f %f)' % (2 + i / 5.0, 49 + j / 5.0)))
+            src_lyr.CreateFeature(feat)
+
+    def get_layer(cache_size):
+        vrt = """<OGRVRTDataSource>
+    <OGRVRTWarpedLayer>
+        <OGRVRTLayer name="ogr_vrt_warped_cache">
+            <SrcDataSource>tmp/ogr_vrt_warped_cache.shp</SrcDataSource>
+        </OGRVRTLayer>
+        <TargetSRS>EPSG:32631</TargetSRS>
+        <GeometryCacheSize>%d</GeometryCacheSize>
+    </OGRVRTWarpedLayer>
+</OGRVRTDataSource>""" % cache_size
+        ds = ogr.Open(vrt, update=1)
+        return ds, ds.GetLayer(0)
+
+    ogr.GetDriverByName('ESRI Shapefile').CopyDataSource(src_ds, 'tmp/ogr_vrt_warped_cache.shp')
+    src_ds = None
+
+    def collect(lyr):
+        lyr.ResetReading()
+        return [(f.GetFID(), f.GetGeometryRef().ExportToWkt()) for f in lyr]
+
+    ds_ref, lyr_ref = get_layer(0)
+    ds, lyr = get_layer(100)
+
+    assert collect(lyr) == collect(lyr_ref)
+    for _ in range(2):
+        for rect in [(426857, 5427937, 455000, 5470000),
+                     (440000, 5440000, 470000, 5530000)]:
+            lyr_ref.SetSpatialFilterRect(*rect)
+            lyr.SetSpatialFilterRect(*rect)
+            assert collect(lyr) == collect(lyr_ref)
+            assert collect(lyr)
+
+    # Updating a feature through the warped layer invalidates its cached geometry
+    lyr.SetSpatialFilter(None)
+    lyr_ref.SetSpatialFilter(None)
+    f = lyr.GetFeature(0)
+    f.SetGeometry(ogr.CreateGeometryFromWkt('POINT(500000 5500000)'))
+    assert lyr.SetFeature(f) == 0
+    f = lyr.GetFeature(0)
+    assert f.GetGeometryRef().GetX() == pytest.approx(500000, abs=1e-3)
+    assert f.GetGeometryRef().GetY() == pytest.approx(5500000, abs=1e-3)
+    ds_ref = None
+    ds_ref, lyr_ref = get_layer(0)
+    assert collect(lyr) == collect(lyr_ref)
+
+    ds = None
+    ds_ref = None
+    ogr.GetDriverByName('ESRI Shapefile').DeleteDataSource('tmp/ogr_vrt_warped_cache.shp')
+
+
 ###############################################################################
 # Test OGRVRTUnionLayer
 
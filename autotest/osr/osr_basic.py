@@ -1768,3 +1768,46 @@ def test_osr_basic_set_get_coordinate_epoch():
     clone.SetCoordinateEpoch(0)
     assert not srs.IsSame(clone)
     assert srs.IsSame(clone, ['IGNORE_COORDINATE_EPOCH=YES'])
+
+
+###############################################################################
+# Test that CRS objects imported several times from the same or equivalent
+# definitions compare and export consistently
+
+
+def test_osr_basic_interned_crs():
+
+    srs_epsg = osr.SpatialReference()
+    srs_epsg.ImportFromEPSG(32631)
+    wkt = srs_epsg.ExportToWkt()
+
+    srs_wkt = osr.SpatialReference()
+    srs_wkt.ImportFromWkt(wkt)
+    srs_wkt2 = osr.SpatialReference()
+    srs_wkt2.ImportFromWkt(wkt)
+    assert srs_wkt2.ExportToWkt() == wkt
+    assert srs_wkt.IsSame(srs_wkt2)
+    assert srs_wkt.IsSame(srs_epsg)
+
+    srs_projjson = osr.SpatialReference()
+    srs_projjson.SetFromUserInput(srs_epsg.ExportToPROJJSON())
+    srs_projjson2 = osr.SpatialReference()
+    srs_projjson2.SetFromUserInput(srs_epsg.ExportToPROJJSON())
+    assert srs_projjson.IsSame(srs_projjson2)
+    assert srs_projjson.IsSame(srs_epsg)
+
+    # Modifications of an interned object must not affect comparisons
+    clone = srs_wkt.Clone()
+    assert clone.IsSame(srs_wkt)
+    clone.SetUTM(32)
+    assert not clone.IsSame(srs_wkt)
+    assert srs_wkt2.IsSame(srs_wkt)
+
+    # Data axis mapping is still taken into account
+    srs_geog = osr.SpatialReference()
+    srs_geog.ImportFromEPSG(4326)
+    srs_geog2 = osr.SpatialReference()
+    srs_geog2.ImportFromEPSG(4326)
+    srs_geog2.SetAxisMappingStrategy(osr.OAMS_TRADITIONAL_GIS_ORDER)
+    assert not srs_geog.IsSame(srs_geog2)
+    assert srs_geog.IsSame(srs_geog2, ['IGNORE_DATA_AXIS_TO_SRS_AXIS_MAPPING=YES'])
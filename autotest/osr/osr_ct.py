@@ -629,3 +629,56 @@ def test_osr_ct_wkt_non_consistent_with_epsg_definition():
     x, y, _ = ct.TransformPoint(2, 49, 0)
     assert x == 49
     assert y == 2
+
+###############################################################################
+# Test the OGR_CT_CACHE_DIR on-disk cache of candidate operations
+
+
+def test_osr_ct_cache_dir():
+
+    cache_dir = '/vsimem/osr_ct_cache_dir'
+
+    s = osr.SpatialReference()
+    s.ImportFromEPSG(4326)
+    s.SetAxisMappingStrategy(osr.OAMS_TRADITIONAL_GIS_ORDER)
+    t = osr.SpatialReference()
+    t.ImportFromEPSG(32755)
+
+    with gdaltest.config_option('OGR_CT_CACHE_DIR', cache_dir):
+        ct = osr.CoordinateTransformation(s, t)
+        assert ct
+        x, y, _ = ct.TransformPoint(147, -42, 0)
+    files = gdal.ReadDir(cache_dir)
+    gdal.RmdirRecursive(cache_dir)
+
+    assert files is not None and len(files) == 1
+    assert files[0].endswith('.json')
+    assert x == pytest.approx(500000, abs=1e-3)
+    assert y == pytest.approx(5350223.775, abs=1e-2)
+
+###############################################################################
+# Test splitting the transformation of large arrays across threads
+
+
+def test_osr_ct_num_threads():
+
+    s = osr.SpatialReference()
+    s.ImportFromEPSG(4326)
+    s.SetAxisMappingStrategy(osr.OAMS_TRADITIONAL_GIS_ORDER)
+    t = osr.SpatialReference()
+    t.ImportFromEPSG(32631)
+
+    points = [(2 + 1e-5 * i, 49 - 1e-5 * i) for i in range(50000)]
+    points.append((float('nan'), 49))
+
+    ct = osr.CoordinateTransformation(s, t)
+    expected = ct.TransformPoints(points)
+
+    with gdaltest.config_option('OGR_CT_NUM_THREADS', '4'):
+        got = ct.TransformPoints(points)
+
+    assert len(got) == len(expected)
+    for i in range(len(expected) - 1):
+        assert got[i][0] == expected[i][0]
+        assert got[i][1] == expected[i][1]
+    assert got[-1][0] == float('inf')
@@ -313,7 +313,7 @@ def test_gdal_grid_3():
 
     # Create a GDAL dataset from the values of "grid.csv".
     print('Step 3: Trying AVX optimized version...')
-    (_, err) = gdaltest.runexternal_out_and_err(gdal_grid + ' --debug on -txe 440720.0 441920.0 -tye 3751320.0 3750120.0 -outsize 20 20 -ot Float64 -l grid -a invdist:power=2.0:smoothing=0.0:radius1=0.0:radius2=0.0:angle=0.0:max_points=0:min_points=0:nodata=0.0 data/grid.vrt ' + outfiles[-1])
+    (_, err) = gdaltest.runexternal_out_and_err(gdal_grid + ' --debug on --config GDAL_USE_AVX512 NO -txe 440720.0 441920.0 -tye 3751320.0 3750120.0 -outsize 20 20 -ot Float64 -l grid -a invdist:power=2.0:smoothing=0.0:radius1=0.0:radius2=0.0:angle=0.0:max_points=0:min_points=0:nodata=0.0 data/grid.vrt ' + outfiles[-1])
     if 'AVX' in err:
         print('...AVX optimized version used')
     else:
@@ -329,6 +329,43 @@ def test_gdal_grid_3():
     ds_ref = None
     ds = None
 
+    #################
+    # Potentially test optimized AVX-512 implementation
+
+    outfiles.append('tmp/grid_invdist_avx512.tif')
+    try:
+        os.remove(outfiles[-1])
+    except OSError:
+        pass
+
+    # Create a GDAL dataset from the values of "grid.csv".
+    print('Step 4: Trying AVX-512 optimized version...')
+    (_, err) = gdaltest.runexternal_out_and_err(gdal_grid + ' --debug on -txe 440720.0 441920.0 -tye 3751320.0 3750120.0 -outsize 20 20 -ot Float64 -l grid -a invdist:power=2.0:smoothing=0.0:radius1=0.0:radius2=0.0:angle=0.0:max_points=0:min_points=0:nodata=0.0 data/grid.vrt ' + outfiles[-1])
+    if 'AVX-512' in err:
+        print('...AVX-512 optimized version used')
+    else:
+        print('...AVX-512 optimized version NOT used')
+
+    # We should get the same values as in "ref_data/gdal_invdist.tif"
+    ds = gdal.Open(outfiles[-1])
+    ds_ref = gdal.Open('ref_data/grid_invdist.tif')
+    maxdiff = gdaltest.compare_ds(ds, ds_ref, verbose=0)
+    if maxdiff > 1:
+        gdaltest.compare_ds(ds, ds_ref, verbose=1)
+        pytest.fail('Image too different from the reference')
+    ds_ref = None
+    ds = None
+
+    # And the same values as the generic implementation
+    ds = gdal.Open(outfiles[-1])
+    ds_ref = gdal.Open('tmp/grid_invdist_generic.tif')
+    maxdiff = gdaltest.compare_ds(ds, ds_ref, verbose=0)
+    if maxdiff > 1:
+        gdaltest.compare_ds(ds, ds_ref, verbose=1)
+        pytest.fail('Image too different from the generic implementation')
+    ds_ref = None
+    ds = None
+
     #################
     # Test GDAL_NUM_THREADS config option to 1
 
@@ -34,6 +34,7 @@ import struct
 
 from osgeo import gdal, ogr
 
+import gdaltest
 import ogrtest
 
 ###############################################################################
@@ -96,7 +97,10 @@ def test_gdal_grid_lib_2():
     shape_lyr.CreateFeature(dst_feat)
     shape_ds = None
 
-    for env_list in [[('GDAL_USE_AVX', 'NO'), ('GDAL_USE_SSE', 'NO')], [('GDAL_USE_AVX', 'NO')], []]:
+    for env_list in [[('GDAL_USE_AVX512', 'NO'), ('GDAL_USE_AVX', 'NO'), ('GDAL_USE_SSE', 'NO')],
+                     [('GDAL_USE_AVX512', 'NO'), ('GDAL_USE_AVX', 'NO')],
+                     [('GDAL_USE_AVX512', 'NO')],
+                     []]:
 
         for (key, value) in env_list:
             gdal.SetConfigOption(key, value)
@@ -110,6 +114,7 @@ def test_gdal_grid_lib_2():
                         outputBounds=[-0.4, -0.4, 0.6, 0.6],
                         width=10, height=10, outputType=gdal.GDT_Byte)
 
+        gdal.SetConfigOption('GDAL_USE_AVX512', None)
         gdal.SetConfigOption('GDAL_USE_AVX', None)
         gdal.SetConfigOption('GDAL_USE_SSE', None)
 
@@ -133,6 +138,33 @@ def test_gdal_grid_lib_3():
               width=115, height=93, outputBounds=[37.3495161160827, 55.6901531392856, 37.3497618734837, 55.6902650179072],
               format='MEM', algorithm='linear')
 
+###############################################################################
+# Test that algorithms with a search ellipse give the same result with and
+# without the packed R-tree spatial index
+
+
+def test_gdal_grid_lib_search_ellipse_spatial_index():
+
+    for algorithm in ['invdist:radius1=0.02:radius2=0.03:angle=30:max_points=5',
+                      'average:radius1=0.02:radius2=0.03:angle=30',
+                      'minimum:radius1=0.02:radius2=0.03',
+                      'maximum:radius1=0.02:radius2=0.03',
+                      'range:radius1=0.02:radius2=0.03',
+                      'count:radius1=0.02:radius2=0.03',
+                      'average_distance:radius1=0.02:radius2=0.03',
+                      'average_distance_pts:radius1=0.02:radius2=0.03']:
+
+        def grid():
+            ds = gdal.Grid('', '/vsimem/tmp/n43.shp', format='MEM',
+                           outputBounds=[-80.0041667, 42.9958333, -78.9958333, 44.0041667],
+                           width=30, height=30, outputType=gdal.GDT_Float64,
+                           algorithm=algorithm)
+            return ds.ReadRaster()
+
+        with gdaltest.config_option('GDAL_GRID_USE_SPATIAL_INDEX', 'NO'):
+            ref = grid()
+        assert grid() == ref, algorithm
+
 ###############################################################################
 # Cleanup
 
@@ -616,6 +616,107 @@ def test_gdal_translate_lib_preserve_block_size():
     src_ds = None
     gdal.Unlink('/vsimem/tmp.tif')
 
+###############################################################################
+# Test multi-threaded reading and conversion in GDALDatasetCopyWholeRaster()
+
+
+@pytest.mark.parametrize("interleave", ['PIXEL', 'BAND'])
+def test_gdal_translate_lib_num_threads(interleave):
+
+    src_ds = gdal.GetDriverByName('GTiff').Create(
+        '/vsimem/test_gdal_translate_lib_num_threads.tif', 200, 150, 3,
+        gdal.GDT_UInt16, options=['TILED=YES', 'BLOCKXSIZE=32', 'BLOCKYSIZE=32'])
+    for i in range(3):
+        data = struct.pack('H' * 200, *[(x * 37 + i * 1000) % 4096 for x in range(200)])
+        for y in range(150):
+            src_ds.GetRasterBand(i + 1).WriteRaster(0, y, 200, 1, data[2 * y:] + data[:2 * y])
+    src_ds = None
+    src_ds = gdal.Open('/vsimem/test_gdal_translate_lib_num_threads.tif')
+
+    def translate(num_threads):
+        with gdaltest.config_options({'GDAL_COPY_WHOLE_RASTER_NUM_THREADS': num_threads,
+                                      'GDAL_SWATH_SIZE': '4000'}):
+            ds = gdal.Translate('', src_ds, format='GTiff',
+                                outputType=gdal.GDT_Byte,
+                                scaleParams=[[0, 4095, 0, 255]],
+                                creationOptions=['INTERLEAVE=' + interleave])
+        ret = [ds.GetRasterBand(i + 1).Checksum() for i in range(3)]
+        ds = None
+        return ret
+
+    ref = translate('1')
+    assert translate('4') == ref
+    assert translate('ALL_CPUS') == ref
+
+    # Source in update mode with pending modifications: must not be reopened
+    update_ds = gdal.GetDriverByName('GTiff').CreateCopy(
+        '/vsimem/test_gdal_translate_lib_num_threads_update.tif', src_ds)
+    update_ds.GetRasterBand(1).Fill(4095)
+    with gdaltest.config_options({'GDAL_COPY_WHOLE_RASTER_NUM_THREADS': '4',
+                                  'GDAL_SWATH_SIZE': '4000'}):
+        ds = gdal.Translate('', update_ds, format='MEM',
+                            scaleParams=[[0, 4095, 0, 255]],
+                            outputType=gdal.GDT_Byte)
+    assert ds.GetRasterBand(1).ReadRaster() == b'\xff' * (200 * 150)
+    ds = None
+    update_ds = None
+
+    src_ds = None
+    gdal.GetDriverByName('GTiff').Delete('/vsimem/test_gdal_translate_lib_num_threads.tif')
+    gdal.GetDriverByName('GTiff').Delete('/vsimem/test_gdal_translate_lib_num_threads_update.tif')
+
+###############################################################################
+# Test -tile_index and the assembling of the parts without re-encoding
+
+
+def test_gdal_translate_lib_tile_index():
+
+    src_ds = gdal.Open('../gcore/data/rgbsmall.tif')
+    ref_cs = [src_ds.GetRasterBand(i + 1).Checksum() for i in range(3)]
+
+    part_filenames = []
+    for i in range(4):
+        filename = '/vsimem/test_gdal_translate_lib_tile_index_%d.tif' % i
+        ds = gdal.Translate(filename, src_ds,
+                            options='-tile_index %d/4 -co TILED=YES '
+                                    '-co BLOCKXSIZE=16 -co BLOCKYSIZE=16 '
+                                    '-co COMPRESS=DEFLATE -co ZLEVEL=1' % i)
+        assert ds.RasterXSize == 50
+        assert ds.RasterYSize == (2 if i == 3 else 16)
+        gt = ds.GetGeoTransform()
+        src_gt = src_ds.GetGeoTransform()
+        assert gt[3] == pytest.approx(src_gt[3] + 16 * i * src_gt[5])
+        ds = None
+        part_filenames.append(filename)
+
+    # Part beyond the end of the output
+    with gdaltest.error_handler():
+        assert gdal.Translate('/vsimem/test_gdal_translate_lib_tile_index_5.tif',
+                              src_ds,
+                              options='-tile_index 4/5 -co BLOCKYSIZE=16') is None
+
+    vrt_filename = '/vsimem/test_gdal_translate_lib_tile_index.vrt'
+    gdal.BuildVRT(vrt_filename, part_filenames)
+
+    sizes = []
+    for direct_copy in ('YES', 'NO'):
+        filename = '/vsimem/test_gdal_translate_lib_tile_index_%s.tif' % direct_copy
+        with gdaltest.config_option('GTIFF_DIRECT_TILE_COPY', direct_copy):
+            ds = gdal.Translate(filename, vrt_filename, format='COG',
+                                creationOptions=['COMPRESS=DEFLATE',
+                                                 'LEVEL=9', 'BLOCKSIZE=16'])
+        assert [ds.GetRasterBand(i + 1).Checksum() for i in range(3)] == ref_cs
+        ds = None
+        sizes.append(gdal.VSIStatL(filename).size)
+        gdal.Unlink(filename)
+
+    # Tiles copied as they are keep the compression level of the parts
+    assert sizes[0] != sizes[1]
+
+    gdal.Unlink(vrt_filename)
+    for filename in part_filenames:
+        gdal.Unlink(filename)
+
 ###############################################################################
 # Cleanup
 
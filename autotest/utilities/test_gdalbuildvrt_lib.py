@@ -32,6 +32,7 @@
 import struct
 
 from osgeo import gdal
+import gdaltest
 
 ###############################################################################
 # Simple test
@@ -317,3 +318,93 @@ def test_gdalbuildvrt_lib_usemaskband_on_alpha_band():
     ds = gdal.BuildVRT('', [src1_ds, src2_ds])
     assert struct.unpack('B' * 3, ds.GetRasterBand(1).ReadRaster()) == (255, 127, 0)
     assert struct.unpack('B' * 3, ds.GetRasterBand(2).ReadRaster()) == (255, 255, 0)
+
+
+###############################################################################
+# Test opening sources in parallel, and the -incremental mode
+
+
+def _create_tiles(prefix, count):
+    filenames = []
+    for i in range(count):
+        filename = '%s_%d.tif' % (prefix, i)
+        ds = gdal.GetDriverByName('GTiff').Create(filename, 10, 10)
+        ds.SetGeoTransform([2 + i * 10, 1, 0, 49, 0, -1])
+        ds.GetRasterBand(1).Fill(i + 1)
+        ds = None
+        filenames.append(filename)
+    return filenames
+
+
+def test_gdalbuildvrt_lib_num_threads():
+
+    filenames = _create_tiles('/vsimem/test_gdalbuildvrt_lib_num_threads', 10)
+    filenames.insert(3, '/vsimem/i_do_not_exist.tif')
+
+    with gdaltest.error_handler():
+        ref_ds = gdal.BuildVRT('', filenames)
+    ref_xml = ref_ds.GetMetadata('xml:VRT')[0]
+
+    with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+        with gdaltest.error_handler():
+            ds = gdal.BuildVRT('', filenames)
+        assert 'i_do_not_exist' in gdal.GetLastErrorMsg()
+    assert ds.GetMetadata('xml:VRT')[0] == ref_xml
+    assert ds.GetRasterBand(1).Checksum() == ref_ds.GetRasterBand(1).Checksum()
+
+    for filename in filenames:
+        gdal.Unlink(filename)
+
+
+def test_gdalbuildvrt_lib_incremental():
+
+    prefix = '/vsimem/test_gdalbuildvrt_lib_incremental'
+    filenames = _create_tiles(prefix, 5)
+    vrt_filename = prefix + '.vrt'
+    cache_filename = vrt_filename + '.sources_cache'
+
+    ds = gdal.BuildVRT(vrt_filename, filenames, options=['-incremental'])
+    ref_xml = ds.GetMetadata('xml:VRT')[0]
+    ds = None
+    assert gdal.VSIStatL(cache_filename) is not None
+
+    # Rebuilding from the cache gives the same result
+    ds = gdal.BuildVRT(vrt_filename, filenames, options=['-incremental'])
+    assert ds.GetMetadata('xml:VRT')[0] == ref_xml
+    ds = None
+
+    # Check that unchanged sources are really taken from the cache, by
+    # tampering with the cached geotransform of the last one
+    f = gdal.VSIFOpenL(cache_filename, 'rb')
+    lines = gdal.VSIFReadL(1, 100000, f).decode('ascii').split('\n')
+    gdal.VSIFCloseL(f)
+    for idx, line in enumerate(lines):
+        if line.startswith(filenames[-1] + '\t'):
+            fields = line.split('\t')
+            props = fields[3].split(' ')
+            props[2] = '100'
+            fields[3] = ' '.join(props)
+            lines[idx] = '\t'.join(fields)
+    f = gdal.VSIFOpenL(cache_filename, 'wb')
+    gdal.VSIFWriteL('\n'.join(lines), 1, len('\n'.join(lines)), f)
+    gdal.VSIFCloseL(f)
+
+    ds = gdal.BuildVRT(vrt_filename, filenames, options=['-incremental'])
+    assert ds.RasterXSize == 100 + 10 - 2
+    ds = None
+
+    # New source added
+    filenames += _create_tiles(prefix + '_new', 1)
+    ds = gdal.BuildVRT(vrt_filename, filenames, options=['-incremental'])
+    assert ds.RasterXSize == 100 + 10 - 2
+    ds = None
+
+    # Without -incremental, sources are analysed again
+    ds = gdal.BuildVRT(vrt_filename, filenames)
+    assert ds.RasterXSize == 50
+    ds = None
+
+    gdal.GetDriverByName('VRT').Delete(vrt_filename)
+    gdal.Unlink(cache_filename)
+    for filename in filenames:
+        gdal.Unlink(filename)
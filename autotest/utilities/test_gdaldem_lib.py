@@ -522,3 +522,28 @@ def test_gdaldem_lib_nodata():
 
 
 
+
+###############################################################################
+# Test that multi-threaded processing gives the same result as the
+# single-threaded one
+
+
+@pytest.mark.parametrize('processing', ['hillshade', 'slope', 'aspect', 'TRI', 'TPI', 'Roughness'])
+@pytest.mark.parametrize('computeEdges', [False, True])
+@pytest.mark.parametrize('outputType', [gdal.GDT_Int16, gdal.GDT_Float32])
+def test_gdaldem_lib_num_threads(processing, computeEdges, outputType):
+
+    src_ds = gdal.Translate('', gdal.Open('../gdrivers/data/n43.dt0'), format='MEM', outputType=outputType)
+    src_ds.GetRasterBand(1).SetNoDataValue(0)
+    src_ds.GetRasterBand(1).WriteRaster(10, 20, 2, 2, struct.pack('h' * 4, 0, 0, 0, 0), buf_type=gdal.GDT_Int16)
+
+    ds_ref = gdal.DEMProcessing('', src_ds, processing, format='MEM', computeEdges=computeEdges)
+    ds = gdal.DEMProcessing('', src_ds, processing, format='MEM', computeEdges=computeEdges,
+                            options=['-num_threads', '4'])
+    assert ds is not None
+    assert ds.GetRasterBand(1).ReadRaster() == ds_ref.GetRasterBand(1).ReadRaster()
+
+    with gdaltest.config_option('GDAL_NUM_THREADS', 'ALL_CPUS'):
+        ds = gdal.DEMProcessing('', src_ds, processing, format='MEM', computeEdges=computeEdges)
+    assert ds is not None
+    assert ds.GetRasterBand(1).ReadRaster() == ds_ref.GetRasterBand(1).ReadRaster()
@@ -158,3 +158,18 @@ def test_gdalinfo_lib_coordinate_epoch():
     ret = gdal.Info(ds, format = 'json')
     assert 'coordinateEpoch' in ret
     assert ret['coordinateEpoch'] == 2021.3
+
+###############################################################################
+
+
+def test_gdalinfo_lib_stats_perf():
+
+    ret = gdal.Info('../gcore/data/byte.tif', options='-checksum -stats-perf')
+    assert 'Block Cache: Hits=' in ret
+    assert 'Performance Counters:' in ret
+    assert 'GDAL.blocks_read=' in ret
+
+    ret = gdal.Info('../gcore/data/byte.tif', options='-json -checksum -stats-perf')
+    assert ret['bands'][0]['blockCache']['misses'] > 0
+    assert ret['perfCounters']['GDAL.blocks_read'] > 0
+    assert ret['perfCounters']['GDAL.block_read_time_ns'] > 0
@@ -786,6 +786,35 @@ def test_gdalmdimtranslate_dims_with_same_name_different_size():
     gdal.Unlink(srcfile)
 
 
+###############################################################################
+
+
+def test_gdalmdimtranslate_multithreaded():
+
+    src_ds = gdal.GetDriverByName('MEM').CreateMultiDimensional('')
+    rg = src_ds.GetRootGroup()
+    dim_z = rg.CreateDimension('Z', None, None, 3)
+    dim_y = rg.CreateDimension('Y', None, None, 20)
+    dim_x = rg.CreateDimension('X', None, None, 30)
+    ar = rg.CreateMDArray('ar', [dim_z, dim_y, dim_x],
+                          gdal.ExtendedDataType.Create(gdal.GDT_UInt16))
+    data = struct.pack('H' * (3 * 20 * 30), *range(3 * 20 * 30))
+    assert ar.Write(data) == gdal.CE_None
+    str_ar = rg.CreateMDArray('str', [dim_z],
+                              gdal.ExtendedDataType.CreateString())
+    assert str_ar.Write(['a', 'bc', 'def']) == gdal.CE_None
+
+    for num_threads in ('2', 'ALL_CPUS'):
+        # Small swath size to get many chunks
+        with gdaltest.config_options({'GDAL_NUM_THREADS': num_threads,
+                                      'GDAL_SWATH_SIZE': '1000'}):
+            out_ds = gdal.MultiDimTranslate('', src_ds, format = 'MEM')
+        assert out_ds
+        out_rg = out_ds.GetRootGroup()
+        assert out_rg.OpenMDArray('ar').Read() == data
+        assert out_rg.OpenMDArray('str').Read() == ['a', 'bc', 'def']
+
+
 def XXXX_test_all():
     while True:
         test_gdalmdimtranslate_no_arg()
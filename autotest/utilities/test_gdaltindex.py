@@ -262,6 +262,44 @@ def test_gdaltindex_6():
         ds = None
 
     
+###############################################################################
+# Test parallel scanning, -header_only and GeoPackage output (transaction)
+
+
+def test_gdaltindex_num_threads_header_only():
+    if test_cli_utilities.get_gdaltindex_path() is None:
+        pytest.skip()
+
+    # Georeferencing only available in a world file
+    ds = gdal.GetDriverByName('GTiff').Create('tmp/gdaltindex_wld.tif', 10, 10, 1)
+    ds = None
+    with open('tmp/gdaltindex_wld.tfw', 'wt') as f:
+        f.write('0.1\n0\n0\n-0.1\n49.05\n4.95\n')
+
+    files = 'tmp/gdaltindex1.tif tmp/gdaltindex2.tif tmp/gdaltindex3.tif tmp/gdaltindex4.tif tmp/gdaltindex_wld.tif'
+
+    def get_extents(filename):
+        ds = ogr.Open(filename)
+        lyr = ds.GetLayer(0)
+        ret = sorted([(f.GetField('location'), f.GetGeometryRef().GetEnvelope()) for f in lyr])
+        ds = None
+        return ret
+
+    gdal.Unlink('tmp/test_gdaltindex_ref.gpkg')
+    gdaltest.runexternal_out_and_err(test_cli_utilities.get_gdaltindex_path() + ' tmp/test_gdaltindex_ref.gpkg ' + files)
+    ref = get_extents('tmp/test_gdaltindex_ref.gpkg')
+    assert len(ref) == 5
+
+    gdal.Unlink('tmp/test_gdaltindex_mt.gpkg')
+    gdaltest.runexternal_out_and_err(test_cli_utilities.get_gdaltindex_path() + ' --config GDAL_NUM_THREADS 4 -header_only tmp/test_gdaltindex_mt.gpkg ' + files)
+    assert get_extents('tmp/test_gdaltindex_mt.gpkg') == ref
+
+    gdal.Unlink('tmp/test_gdaltindex_ref.gpkg')
+    gdal.Unlink('tmp/test_gdaltindex_mt.gpkg')
+    gdal.GetDriverByName('GTiff').Delete('tmp/gdaltindex_wld.tif')
+    gdal.Unlink('tmp/gdaltindex_wld.tfw')
+
+
 ###############################################################################
 # Cleanup
 
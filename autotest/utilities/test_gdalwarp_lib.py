@@ -329,6 +329,31 @@ def test_gdalwarp_lib_21():
 
     ds = None
 
+###############################################################################
+# Test a multipolygon cutline with many parts, warped in several chunks
+
+
+def test_gdalwarp_lib_cutline_multipolygon_chunks():
+
+    polys = []
+    for j in range(5):
+        for i in range(5):
+            x = 3 + i * 20
+            y = 3 + j * 20
+            polys.append('((%d %d,%d %d,%d %d,%d %d,%d %d))' %
+                         (x, y, x, y + 12, x + 12, y + 12, x + 12, y, x, y))
+    cutline = 'CUTLINE=MULTIPOLYGON (%s)' % ','.join(polys)
+
+    ref_ds = gdal.Warp('', '../gcore/data/utmsmall.tif', format='MEM',
+                       warpOptions=[cutline])
+    ref_cs = ref_ds.GetRasterBand(1).Checksum()
+    assert ref_cs != gdal.Open('../gcore/data/utmsmall.tif').GetRasterBand(1).Checksum()
+
+    # Small chunks, most of them intersecting only some of the polygons
+    ds = gdal.Warp('', '../gcore/data/utmsmall.tif', format='MEM',
+                   warpOptions=[cutline], warpMemoryLimit=20000)
+    assert ds.GetRasterBand(1).Checksum() == ref_cs
+
 ###############################################################################
 # Test cutline with ALL_TOUCHED enabled.
 
@@ -2127,6 +2152,105 @@ def test_gdalwarp_lib_automatic_grid_sampling():
                    dstSRS='+proj=laea +lat_0=48.514 +lon_0=-145.204 +x_0=0 +y_0=0 +datum=WGS84 +units=m +no_defs')
     assert ds.GetRasterBand(1).Checksum() == 46790
 
+###############################################################################
+# Test -multi with several chunks in flight
+
+
+def test_gdalwarp_lib_multi_chunks_in_flight():
+
+    src_ds = gdal.Translate('', '../gdrivers/data/small_world.tif',
+                            format='MEM', width=1200, height=600)
+    options = dict(format='MEM', dstSRS='EPSG:3857',
+                   outputBounds=[-20037508, -15000000, 20037508, 15000000],
+                   width=1000, height=750, warpMemoryLimit=1,
+                   errorThreshold=0)
+    ref_ds = gdal.Warp('', src_ds, **options)
+    ref_cs = [ref_ds.GetRasterBand(i + 1).Checksum() for i in range(3)]
+
+    for num_threads in ('1', '2'):
+        tab = [0]
+
+        def callback(pct, msg, user_data):
+            assert pct >= tab[0]
+            tab[0] = pct
+            return 1
+
+        ds = gdal.Warp('', src_ds, multithread=True,
+                       warpOptions=['NUM_CHUNKS_IN_FLIGHT=4',
+                                    'NUM_THREADS=' + num_threads],
+                       callback=callback, **options)
+        assert [ds.GetRasterBand(i + 1).Checksum() for i in range(3)] == ref_cs
+        assert tab[0] > 0.9
+
+###############################################################################
+# Test -single_pass mode with several overlapping sources
+
+
+@pytest.mark.parametrize("dstnodata", [None, 0])
+def test_gdalwarp_lib_single_pass(dstnodata):
+
+    src_ds = gdal.Open('../gdrivers/data/small_world.tif')
+    sources = []
+    for (xoff, yoff) in [(0, 0), (150, 0), (0, 80), (150, 80), (60, 40)]:
+        sources.append(gdal.Translate('', src_ds, format='MEM',
+                                      srcWin=[xoff, yoff, 250, 120]))
+
+    options = dict(format='MEM', dstSRS='EPSG:3857',
+                   outputBounds=[-20037508, -15000000, 20037508, 15000000],
+                   width=800, height=600, resampleAlg='bilinear',
+                   errorThreshold=0, dstNodata=dstnodata)
+    ref_ds = gdal.Warp('', sources, **options)
+    ref_cs = [ref_ds.GetRasterBand(i + 1).Checksum() for i in range(3)]
+
+    for num_threads in ('1', '4'):
+        tab = [0]
+
+        def callback(pct, msg, user_data):
+            tab[0] = pct
+            return 1
+
+        with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+            ds = gdal.Warp('', sources, options='-single_pass',
+                           callback=callback, **options)
+        assert [ds.GetRasterBand(i + 1).Checksum() for i in range(3)] == ref_cs
+        assert tab[0] == 1.0
+
+###############################################################################
+# Test -tile_index
+
+
+def test_gdalwarp_lib_tile_index():
+
+    options = '-t_srs EPSG:3857 -te -20037508 -15000000 20037508 15000000 ' \
+              '-ts 100 90 -r bilinear -et 0 -co TILED=YES ' \
+              '-co BLOCKXSIZE=16 -co BLOCKYSIZE=16'
+    ref_ds = gdal.Warp('', '../gdrivers/data/small_world.tif',
+                       options=options + ' -of MEM')
+    ref_cs = [ref_ds.GetRasterBand(i + 1).Checksum() for i in range(3)]
+
+    part_filenames = []
+    for i in range(3):
+        filename = '/vsimem/test_gdalwarp_lib_tile_index_%d.tif' % i
+        ds = gdal.Warp(filename, '../gdrivers/data/small_world.tif',
+                       options=options + ' -tile_index %d/3' % i)
+        assert ds.RasterXSize == 100
+        assert ds.RasterYSize == (26 if i == 2 else 32)
+        ds = None
+        part_filenames.append(filename)
+
+    ds = gdal.BuildVRT('', part_filenames)
+    assert ds.GetGeoTransform() == pytest.approx(ref_ds.GetGeoTransform())
+    assert [ds.GetRasterBand(i + 1).Checksum() for i in range(3)] == ref_cs
+    ds = None
+
+    # Not compatible with VRT output
+    with gdaltest.error_handler():
+        assert gdal.Warp('', '../gdrivers/data/small_world.tif',
+                         options='-of VRT -tile_index 0/3') is None
+
+    for filename in part_filenames:
+        gdal.Unlink(filename)
+
 ###############################################################################
 # Cleanup
 
@@ -32,6 +32,7 @@
 
 
 from osgeo import gdal
+import gdaltest
 import pytest
 
 ###############################################################################
@@ -151,6 +152,38 @@ def test_nearblack_lib_8():
 
     assert ds.GetRasterBand(3).Checksum() == 21309, 'Bad checksum band 3'
 
+###############################################################################
+# Test that the multi-threaded implementation gives the same result as the
+# serial one
+
+
+@pytest.mark.parametrize('options', [
+    {'maxNonBlack': 0, 'nearDist': 15},
+    {'maxNonBlack': 2, 'setAlpha': True},
+    {'maxNonBlack': 1, 'setMask': True},
+    {'colors': ((0, 0, 0), (255, 255, 255)), 'setAlpha': True},
+])
+def test_nearblack_lib_multithreaded(options):
 
+    src_ds = gdal.Open('../gdrivers/data/rgbsmall.tif')
+
+    def run(num_threads):
+        filename = '/vsimem/test_nearblack_lib_multithreaded_%s.tif' % num_threads
+        with gdaltest.config_option('GDAL_NUM_THREADS', num_threads):
+            ds = gdal.Nearblack(filename, src_ds, format='GTiff', **options)
+        assert ds is not None
+        cs = [ds.GetRasterBand(i + 1).Checksum() for i in range(ds.RasterCount)]
+        cs.append(ds.GetRasterBand(1).GetMaskBand().Checksum())
+        ds = None
+        gdal.GetDriverByName('GTiff').Delete(filename)
+        return cs
 
+    assert run('4') == run('1')
 
+    # In-place update
+    ds = gdal.GetDriverByName('MEM').CreateCopy('', src_ds)
+    with gdaltest.config_option('GDAL_NUM_THREADS', '4'):
+        assert gdal.Nearblack(ds, ds, maxNonBlack=0) == 1
+    assert ds.GetRasterBand(1).Checksum() == 21106
+    assert ds.GetRasterBand(2).Checksum() == 20736
+    assert ds.GetRasterBand(3).Checksum() == 21309
@@ -753,3 +753,118 @@ def test_ogr2ogr_t_coord_epoch():
     g = f.GetGeometryRef()
     assert g.GetX(0) != 120 and abs(g.GetX(0) - 120) < 1e-5
     assert g.GetY(0) != -40 and abs(g.GetY(0) - -40) < 1e-5
+
+###############################################################################
+# Test -clipsrc and -clipdst with geometries fully inside, partially inside
+# and outside of the clipping geometry
+
+
+@pytest.mark.parametrize("clip_option", ['-clipsrc', '-clipdst'])
+def test_ogr2ogr_clip_inside_outside(clip_option):
+
+    if not ogrtest.have_geos():
+        pytest.skip()
+
+    src_ds = gdal.GetDriverByName('Memory').Create('', 0, 0, 0, gdal.GDT_Unknown)
+    src_lyr = src_ds.CreateLayer('layer')
+    for wkt in ['LINESTRING (1 1,2 2)',
+                'LINESTRING (5 5,15 5)',
+                'LINESTRING (20 20,30 30)',
+                'POINT (10 10)']:
+        f = ogr.Feature(src_lyr.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt(wkt))
+        src_lyr.CreateFeature(f)
+
+    ds = gdal.VectorTranslate('', src_ds, options='-f Memory ' + clip_option +
+                              ' "POLYGON ((0 0,0 10,10 10,10 0,0 0))"')
+    lyr = ds.GetLayer(0)
+    assert [f.GetGeometryRef().ExportToWkt() for f in lyr] == [
+        'LINESTRING (1 1,2 2)', 'LINESTRING (5 5,10 5)', 'POINT (10 10)']
+
+###############################################################################
+# Test -clipsrc with a clipping layer made of many adjacent polygons
+
+
+@pytest.mark.parametrize("num_threads", [1, 4])
+def test_ogr2ogr_clipsrc_many_polygons(num_threads):
+
+    if not ogrtest.have_geos():
+        pytest.skip()
+
+    clip_filename = '/vsimem/test_ogr2ogr_clipsrc_many_polygons.json'
+    clip_ds = ogr.GetDriverByName('GeoJSON').CreateDataSource(clip_filename)
+    clip_lyr = clip_ds.CreateLayer('clip')
+    for j in range(10):
+        for i in range(10):
+            f = ogr.Feature(clip_lyr.GetLayerDefn())
+            f.SetGeometry(ogr.CreateGeometryFromWkt(
+                'POLYGON ((%d %d,%d %d,%d %d,%d %d,%d %d))' %
+                (i, j, i, j + 1, i + 1, j + 1, i + 1, j, i, j)))
+            clip_lyr.CreateFeature(f)
+    clip_ds = None
+
+    src_ds = gdal.GetDriverByName('Memory').Create('', 0, 0, 0, gdal.GDT_Unknown)
+    src_lyr = src_ds.CreateLayer('layer')
+    for wkt in ['LINESTRING (1.5 1.5,1.7 1.7)',
+                'LINESTRING (5 5.5,15 5.5)',
+                'POINT (20 20)',
+                'POLYGON ((9 9,9 11,11 11,11 9,9 9))',
+                'POLYGON ((4.5 4.5,4.5 5.5,5.5 5.5,5.5 4.5,4.5 4.5))']:
+        f = ogr.Feature(src_lyr.GetLayerDefn())
+        f.SetGeometry(ogr.CreateGeometryFromWkt(wkt))
+        src_lyr.CreateFeature(f)
+
+    ds = gdal.VectorTranslate('', src_ds,
+                              options='-f Memory -clipsrc %s -num_threads %d' %
+                              (clip_filename, num_threads))
+    lyr = ds.GetLayer(0)
+    got = [f.GetGeometryRef().Clone() for f in lyr]
+    expected = ['LINESTRING (1.5 1.5,1.7 1.7)',
+                'LINESTRING (5 5.5,10 5.5)',
+                'POLYGON ((9 9,9 10,10 10,10 9,9 9))',
+                'POLYGON ((4.5 4.5,4.5 5.5,5.5 5.5,5.5 4.5,4.5 4.5))']
+    assert len(got) == len(expected)
+    for g, wkt in zip(got, expected):
+        assert g.Equals(ogr.CreateGeometryFromWkt(wkt)), g.ExportToWkt()
+
+    gdal.Unlink(clip_filename)
+
+###############################################################################
+# Test processing geometries with several threads
+
+
+@pytest.mark.parametrize('extra_options', ['-t_srs EPSG:32631',
+                                           '-t_srs EPSG:32631 -limit 1500',
+                                           '-clipsrc 2 48 3 49',
+                                           '-segmentize 0.01'])
+def test_ogr2ogr_num_threads(extra_options):
+
+    if '-clipsrc' in extra_options and not ogrtest.have_geos():
+        pytest.skip()
+
+    src_ds = gdal.GetDriverByName('Memory').Create('', 0, 0, 0, gdal.GDT_Unknown)
+    srs = osr.SpatialReference()
+    srs.SetFromUserInput('WGS84')
+    srs.SetAxisMappingStrategy(osr.OAMS_TRADITIONAL_GIS_ORDER)
+    src_lyr = src_ds.CreateLayer('layer', srs=srs)
+    src_lyr.CreateField(ogr.FieldDefn('id', ogr.OFTInteger))
+    for i in range(2000):
+        f = ogr.Feature(src_lyr.GetLayerDefn())
+        f['id'] = i
+        if i % 100 != 7:
+            x = 2 + (i % 50) * 0.04
+            y = 48 + (i // 50) * 0.04
+            f.SetGeometry(ogr.CreateGeometryFromWkt(
+                'LINESTRING (%f %f,%f %f)' % (x, y, x + 0.03, y + 0.03)))
+        src_lyr.CreateFeature(f)
+
+    def translate(num_threads):
+        ds = gdal.VectorTranslate('', src_ds, options='-f Memory ' +
+                                  extra_options + ' -num_threads %d' % num_threads)
+        lyr = ds.GetLayer(0)
+        return [(f['id'], f.GetGeometryRef().ExportToWkt() if f.GetGeometryRef() else None)
+                for f in lyr]
+
+    ref = translate(1)
+    assert ref
+    assert translate(4) == ref
@@ -517,6 +517,14 @@ an averaged value from the two nearby points (in this case (12+3+5)/3).
  *
  * If YES, contour polygons will be created, rather than polygon lines.
  *
+ *   NUM_THREADS=d|ALL_CPUS
+ *
+ * (GDAL >= 3.4) Number of worker threads, or ALL_CPUS. Defaults to the value
+ * of the GDAL_NUM_THREADS configuration option, or 1. When greater than 1,
+ * the raster is read by chunks of lines whose marching squares are computed
+ * concurrently, the resulting segments being then merged in line order, so
+ * that the output is identical to the single-threaded one.
+ *
  *
  * @return CE_None on success or CE_Failure if an error occurs.
  */
@@ -600,6 +608,12 @@ CPLErr GDALContourGenerateEx( GDALRasterBandH hBand, void *hLayer,
 
     bool polygonize = CPLFetchBool( options, "POLYGONIZE", false );
 
+    opt = CSLFetchNameValue( options, "NUM_THREADS" );
+    if ( opt == nullptr )
+        opt = CPLGetConfigOption( "GDAL_NUM_THREADS", "1" );
+    int numThreads = EQUAL(opt, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(opt);
+    numThreads = std::max(1, std::min(128, numThreads));
+
     using namespace marching_squares;
 
     OGRContourWriterInfo oCWI;
@@ -632,19 +646,19 @@ CPLErr GDALContourGenerateEx( GDALRasterBandH hBand, void *hLayer,
                 FixedLevelRangeIterator levels( &fixedLevels[0], fixedLevels.size(), GDALGetRasterMaximum( hBand, &bSuccess ) );
                 SegmentMerger<RingAppender, FixedLevelRangeIterator> writer(appender, levels, /* polygonize */ true);
                 ContourGeneratorFromRaster<decltype(writer), FixedLevelRangeIterator> cg( hBand, useNoData, noDataValue, writer, levels );
-                ok = cg.process( pfnProgress, pProgressArg );
+                ok = cg.process( pfnProgress, pProgressArg, numThreads );
             }
             else if ( expBase > 0.0 ) {
                 ExponentialLevelRangeIterator levels( expBase );
                 SegmentMerger<RingAppender, ExponentialLevelRangeIterator> writer(appender, levels, /* polygonize */ true);
                 ContourGeneratorFromRaster<decltype(writer), ExponentialLevelRangeIterator> cg( hBand, useNoData, noDataValue, writer, levels );
-                ok = cg.process( pfnProgress, pProgressArg );
+                ok = cg.process( pfnProgress, pProgressArg, numThreads );
             }
             else {
                 IntervalLevelRangeIterator levels( contourBase, contourInterval );
                 SegmentMerger<RingAppender, IntervalLevelRangeIterator> writer(appender, levels, /* polygonize */ true);
                 ContourGeneratorFromRaster<decltype(writer), IntervalLevelRangeIterator> cg( hBand, useNoData, noDataValue, writer, levels );
-                ok = cg.process( pfnProgress, pProgressArg );
+                ok = cg.process( pfnProgress, pProgressArg, numThreads );
             }
         }
         else
@@ -654,19 +668,19 @@ CPLErr GDALContourGenerateEx( GDALRasterBandH hBand, void *hLayer,
                 FixedLevelRangeIterator levels( &fixedLevels[0], fixedLevels.size() );
                 SegmentMerger<GDALRingAppender, FixedLevelRangeIterator> writer(appender, levels, /* polygonize */ false);
                 ContourGeneratorFromRaster<decltype(writer), FixedLevelRangeIterator> cg( hBand, useNoData, noDataValue, writer, levels );
-                ok = cg.process( pfnProgress, pProgressArg );
+                ok = cg.process( pfnProgress, pProgressArg, numThreads );
             }
             else if ( expBase > 0.0 ) {
                 ExponentialLevelRangeIterator levels( expBase );
                 SegmentMerger<GDALRingAppender, ExponentialLevelRangeIterator> writer(appender, levels, /* polygonize */ false);
                 ContourGeneratorFromRaster<decltype(writer), ExponentialLevelRangeIterator> cg( hBand, useNoData, noDataValue, writer, levels );
-                ok = cg.process( pfnProgress, pProgressArg );
+                ok = cg.process( pfnProgress, pProgressArg, numThreads );
             }
             else {
                 IntervalLevelRangeIterator levels( contourBase, contourInterval );
                 SegmentMerger<GDALRingAppender, IntervalLevelRangeIterator> writer(appender, levels, /* polygonize */ false);
                 ContourGeneratorFromRaster<decltype(writer), IntervalLevelRangeIterator> cg( hBand, useNoData, noDataValue, writer, levels );
-                ok = cg.process( pfnProgress, pProgressArg );
+                ok = cg.process( pfnProgress, pProgressArg, numThreads );
             }
         }
     }
@@ -65,6 +65,10 @@ int CPL_DLL CPL_STDCALL GDALDitherRGB2PCT( GDALRasterBandH hRed,
 int CPL_DLL CPL_STDCALL GDALChecksumImage( GDALRasterBandH hBand,
                                int nXOff, int nYOff, int nXSize, int nYSize );
 
+char CPL_DLL *GDALHashImage( GDALRasterBandH hBand,
+                             int nXOff, int nYOff, int nXSize, int nYSize,
+                             CSLConstList papszOptions );
+
 CPLErr CPL_DLL CPL_STDCALL
 GDALComputeProximity( GDALRasterBandH hSrcBand,
                       GDALRasterBandH hProximityBand,
@@ -268,6 +272,17 @@ int  CPL_DLL GDALApproxTransform(
     void *pTransformArg, int bDstToSrc, int nPointCount,
     double *x, double *y, double *z, int *panSuccess );
 
+/* Precomputed coordinate grid ("warp plan") transformer */
+void CPL_DLL *
+GDALCreateWarpPlanTransformer( GDALTransformerFunc pfnBaseTransformer,
+                               void *pBaseTransformArg,
+                               int nDstXSize, int nDstYSize, int nStep,
+                               CSLConstList papszOptions );
+void CPL_DLL GDALDestroyWarpPlanTransformer( void *pTransformArg );
+int  CPL_DLL GDALWarpPlanTransform(
+    void *pTransformArg, int bDstToSrc, int nPointCount,
+    double *x, double *y, double *z, int *panSuccess );
+
 int CPL_DLL CPL_STDCALL
 GDALSimpleImageWarp( GDALDatasetH hSrcDS,
                      GDALDatasetH hDstDS,
@@ -393,6 +408,62 @@ GDALViewshedGenerate(GDALRasterBandH hBand,
                      GDALProgressFunc pfnProgress, void *pProgressArg,
                      GDALViewshedOutputType heightMode, CSLConstList papszExtraOptions);
 
+GDALDatasetH CPL_DLL
+GDALViewshedGenerateMulti(GDALRasterBandH hBand,
+                          const char* pszDriverName,
+                          const char* pszTargetRasterName,
+                          CSLConstList papszCreationOptions,
+                          int nObserverCount,
+                          const double* padfObserverX,
+                          const double* padfObserverY,
+                          const double* padfObserverHeight,
+                          double dfTargetHeight, double dfCurvCoeff,
+                          GDALViewshedMode eMode, double dfMaxDistance,
+                          GDALProgressFunc pfnProgress, void *pProgressArg,
+                          CSLConstList papszExtraOptions);
+
+/* -------------------------------------------------------------------- */
+/*      Summed area tables                                              */
+/* -------------------------------------------------------------------- */
+
+/** Summed area table of a raster band */
+typedef struct GDALSummedAreaTable GDALSummedAreaTable;
+
+GDALSummedAreaTable CPL_DLL *
+GDALCreateSummedAreaTable( GDALRasterBandH hBand, CSLConstList papszOptions,
+                           GDALProgressFunc pfnProgress, void *pProgressData );
+
+void CPL_DLL GDALDestroySummedAreaTable( GDALSummedAreaTable* psSAT );
+
+int CPL_DLL GDALSummedAreaTableGetSum( const GDALSummedAreaTable* psSAT,
+                                       double dfXOff, double dfYOff,
+                                       double dfXSize, double dfYSize,
+                                       double* pdfSum, double* pdfCount );
+
+CPLErr CPL_DLL GDALSummedAreaTableAverage( const GDALSummedAreaTable* psSAT,
+                                           double dfXOff, double dfYOff,
+                                           double dfXSize, double dfYSize,
+                                           double* padfBuffer,
+                                           int nBufXSize, int nBufYSize,
+                                           double dfNoDataValue );
+
+/* -------------------------------------------------------------------- */
+/*      Zonal statistics                                                */
+/* -------------------------------------------------------------------- */
+
+CPLErr CPL_DLL
+GDALZonalStatistics( GDALRasterBandH hSrcBand, OGRLayerH hZoneLayer,
+                     OGRLayerH hOutLayer, CSLConstList papszOptions,
+                     GDALProgressFunc pfnProgress, void *pProgressArg );
+
+/* -------------------------------------------------------------------- */
+/*      Autotuning                                                      */
+/* -------------------------------------------------------------------- */
+
+CPLErr CPL_DLL
+GDALAutotune( const char* pszFilename, CSLConstList papszOptions,
+              GDALProgressFunc pfnProgress, void *pProgressArg );
+
 /************************************************************************/
 /*      Rasterizer API - geometries burned into GDAL raster.            */
 /************************************************************************/
@@ -177,6 +177,8 @@ int GDALTransformLonLatToDestApproxTransformer(void* hTransformArg,
                                                     double* pdfX,
                                                     double* pdfY);
 
+class GDALGeoLocBackMapTiles;
+
 typedef struct {
     GDALTransformerInfo sTI;
 
@@ -189,6 +191,8 @@ typedef struct {
     double      adfBackMapGeoTransform[6];  // Maps georef to pixel/line.
     float       *pafBackMapX;
     float       *pafBackMapY;
+    // Used instead of pafBackMapX/Y for large backmaps, built lazily by tiles.
+    GDALGeoLocBackMapTiles *poBackMapTiles;
 
     // Geolocation bands.
     GDALDatasetH     hDS_X;
@@ -301,6 +305,8 @@ bool GDALComputeAreaOfInterest(OGRSpatialReference* poSRS,
                                double& dfEastLongitudeDeg,
                                double& dfNorthLatitudeDeg );
 
+CPLString GDALGetTunedConfigOption( const char* pszKey,
+                                    const char* pszDefault );
 
 #endif /* #ifndef DOXYGEN_SKIP */
 
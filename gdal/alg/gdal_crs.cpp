@@ -57,11 +57,16 @@
 #include "cpl_minixml.h"
 #include "cpl_string.h"
 #include "cpl_atomic_ops.h"
+#include "cpl_mem_cache.h"
+#include "gdalsse_priv.h"
 
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <mutex>
+#include <string>
+
 CPL_CVSID("$Id$")
 
 #define MAXORDER 3
@@ -112,10 +117,66 @@ CPL_C_END
 /* crs.c */
 static int CRS_georef(double, double, double *, double *,
                               double [], double [], int);
+static void CRS_georef_batch(int, double *, double *, int *,
+                             double, double,
+                             const double [], const double [], int);
 static int CRS_compute_georef_equations(GCPTransformInfo *psInfo, struct Control_Points *,
     double [], double [], double [], double [], int);
 static int remove_outliers(GCPTransformInfo *);
 
+/************************************************************************/
+/*                       GCP coefficients cache                         */
+/*                                                                      */
+/*      Fitting the polynomials is redone each time a GCP transformer   */
+/*      is created, which happens repeatedly for a same GCP set (e.g.   */
+/*      GDALCreateSimilarTransformer() of the warper, several datasets  */
+/*      sharing their GCPs, or VRTs re-opened). The fitted coefficients */
+/*      are thus kept in a small process-wide cache, keyed by the order */
+/*      and the raw values of the GCPs.                                 */
+/************************************************************************/
+
+namespace {
+struct GCPCoefficients
+{
+    double adfToGeoX[20];
+    double adfToGeoY[20];
+    double adfFromGeoX[20];
+    double adfFromGeoY[20];
+    double x1_mean;
+    double y1_mean;
+    double x2_mean;
+    double y2_mean;
+};
+}
+
+constexpr size_t GCP_COEFFICIENTS_CACHE_SIZE = 32;
+
+static lru11::Cache<std::string, GCPCoefficients, std::mutex>&
+GetGCPCoefficientsCache()
+{
+    static lru11::Cache<std::string, GCPCoefficients, std::mutex> oCache(
+        GCP_COEFFICIENTS_CACHE_SIZE, 0);
+    return oCache;
+}
+
+static std::string GetGCPCoefficientsCacheKey( int nGCPCount,
+                                               const GDAL_GCP *pasGCPList,
+                                               int nOrder )
+{
+    std::string osKey;
+    osKey.reserve(sizeof(int) + nGCPCount * 4 * sizeof(double));
+    osKey.append(reinterpret_cast<const char*>(&nOrder), sizeof(nOrder));
+    for( int i = 0; i < nGCPCount; i++ )
+    {
+        const double adfVals[4] = { pasGCPList[i].dfGCPPixel,
+                                    pasGCPList[i].dfGCPLine,
+                                    pasGCPList[i].dfGCPX,
+                                    pasGCPList[i].dfGCPY };
+        osKey.append(reinterpret_cast<const char*>(adfVals), sizeof(adfVals));
+    }
+    return osKey;
+}
+
 
 #define MSUCCESS     1 /* SUCCESS */
 #define MNPTERR      0 /* NOT ENOUGH POINTS */
@@ -237,6 +298,23 @@ void *GDALCreateGCPTransformerEx( int nGCPCount, const GDAL_GCP *pasGCPList,
     }
     else
     {
+      const std::string osCacheKey(
+          GetGCPCoefficientsCacheKey(nGCPCount, pasGCPList, nReqOrder));
+      GCPCoefficients sCoefs;
+      if( GetGCPCoefficientsCache().tryGet(osCacheKey, sCoefs) )
+      {
+        memcpy(psInfo->adfToGeoX, sCoefs.adfToGeoX, sizeof(sCoefs.adfToGeoX));
+        memcpy(psInfo->adfToGeoY, sCoefs.adfToGeoY, sizeof(sCoefs.adfToGeoY));
+        memcpy(psInfo->adfFromGeoX, sCoefs.adfFromGeoX, sizeof(sCoefs.adfFromGeoX));
+        memcpy(psInfo->adfFromGeoY, sCoefs.adfFromGeoY, sizeof(sCoefs.adfFromGeoY));
+        psInfo->x1_mean = sCoefs.x1_mean;
+        psInfo->y1_mean = sCoefs.y1_mean;
+        psInfo->x2_mean = sCoefs.x2_mean;
+        psInfo->y2_mean = sCoefs.y2_mean;
+        nCRSresult = MSUCCESS;
+      }
+      else
+      {
         /* -------------------------------------------------------------------- */
         /*      Allocate and initialize the working points list.                */
         /* -------------------------------------------------------------------- */
@@ -285,6 +363,20 @@ void *GDALCreateGCPTransformerEx( int nGCPCount, const GDAL_GCP *pasGCPList,
       delete[] padfRasterX;
       delete[] padfRasterY;
       delete[] panStatus;
+
+        if( nCRSresult == MSUCCESS )
+        {
+            memcpy(sCoefs.adfToGeoX, psInfo->adfToGeoX, sizeof(sCoefs.adfToGeoX));
+            memcpy(sCoefs.adfToGeoY, psInfo->adfToGeoY, sizeof(sCoefs.adfToGeoY));
+            memcpy(sCoefs.adfFromGeoX, psInfo->adfFromGeoX, sizeof(sCoefs.adfFromGeoX));
+            memcpy(sCoefs.adfFromGeoY, psInfo->adfFromGeoY, sizeof(sCoefs.adfFromGeoY));
+            sCoefs.x1_mean = psInfo->x1_mean;
+            sCoefs.y1_mean = psInfo->y1_mean;
+            sCoefs.x2_mean = psInfo->x2_mean;
+            sCoefs.y2_mean = psInfo->y2_mean;
+            GetGCPCoefficientsCache().insert(osCacheKey, sCoefs);
+        }
+      }
     }
 
     if (nCRSresult != 1)
@@ -412,33 +504,24 @@ int GDALGCPTransform( void *pTransformArg, int bDstToSrc,
                       int *panSuccess )
 
 {
-    int i = 0;
     GCPTransformInfo *psInfo = static_cast<GCPTransformInfo *>(pTransformArg);
 
     if( psInfo->bReversed )
         bDstToSrc = !bDstToSrc;
 
-    for( i = 0; i < nPointCount; i++ )
+    if( bDstToSrc )
     {
-        if( x[i] == HUGE_VAL || y[i] == HUGE_VAL )
-        {
-            panSuccess[i] = FALSE;
-            continue;
-        }
-
-        if( bDstToSrc )
-        {
-            CRS_georef( x[i] - psInfo->x2_mean, y[i] - psInfo->y2_mean, x + i, y + i,
-                        psInfo->adfFromGeoX, psInfo->adfFromGeoY,
-                        psInfo->nOrder );
-        }
-        else
-        {
-            CRS_georef( x[i] - psInfo->x1_mean, y[i] - psInfo->y1_mean, x + i, y + i,
-                        psInfo->adfToGeoX, psInfo->adfToGeoY,
-                        psInfo->nOrder );
-        }
-        panSuccess[i] = TRUE;
+        CRS_georef_batch( nPointCount, x, y, panSuccess,
+                          psInfo->x2_mean, psInfo->y2_mean,
+                          psInfo->adfFromGeoX, psInfo->adfFromGeoY,
+                          psInfo->nOrder );
+    }
+    else
+    {
+        CRS_georef_batch( nPointCount, x, y, panSuccess,
+                          psInfo->x1_mean, psInfo->y1_mean,
+                          psInfo->adfToGeoX, psInfo->adfToGeoY,
+                          psInfo->nOrder );
     }
 
     return TRUE;
@@ -672,6 +755,99 @@ CRS_georef (
   return(MSUCCESS);
   }
 
+/***************************************************************************/
+/*
+    TRANSFORM AN ARRAY OF COORDINATE PAIRS, IN PLACE.
+
+    The polynomials are evaluated in Horner form, two points at a time with
+    SSE2 when available. Points with a HUGE_VAL coordinate are left
+    untouched and flagged as failed.
+*/
+/***************************************************************************/
+
+template<class T> static inline T CRS_horner( const T* C, const T& e1,
+                                              const T& n1, int order )
+{
+    switch( order )
+    {
+        case 1:
+            return C[0] + C[1] * e1 + C[2] * n1;
+        case 2:
+            return C[0] + e1 * (C[1] + C[3] * e1 + C[4] * n1) +
+                          n1 * (C[2] + C[5] * n1);
+        default:
+            return C[0] + e1 * (C[1] + e1 * (C[3] + C[6] * e1 + C[7] * n1) +
+                                n1 * (C[4] + C[8] * n1)) +
+                          n1 * (C[2] + n1 * (C[5] + C[9] * n1));
+    }
+}
+
+static void
+CRS_georef_batch (
+    int nPointCount,
+    double *x,          /* COORDINATES TO BE TRANSFORMED */
+    double *y,
+    int *panSuccess,
+    double x_mean,      /* CENTER OF THE COORDINATES USED FOR THE FIT */
+    double y_mean,
+    const double E[],   /* EASTING COEFFICIENTS */
+    const double N[],   /* NORTHING COEFFICIENTS */
+    int order
+)
+{
+    if( order < 1 || order > MAXORDER )
+    {
+        for( int i = 0; i < nPointCount; i++ )
+            panSuccess[i] = FALSE;
+        return;
+    }
+    const int nTerms = (order + 1) * (order + 2) / 2;
+
+    XMMReg2Double aoE[10];
+    XMMReg2Double aoN[10];
+    for( int j = 0; j < nTerms; j++ )
+    {
+        aoE[j] = XMMReg2Double::Load1ValHighAndLow(E + j);
+        aoN[j] = XMMReg2Double::Load1ValHighAndLow(N + j);
+    }
+    const XMMReg2Double oXMean = XMMReg2Double::Load1ValHighAndLow(&x_mean);
+    const XMMReg2Double oYMean = XMMReg2Double::Load1ValHighAndLow(&y_mean);
+
+    const auto TransformOne = [&](int k)
+    {
+        if( x[k] == HUGE_VAL || y[k] == HUGE_VAL )
+        {
+            panSuccess[k] = FALSE;
+            return;
+        }
+        const double e1 = x[k] - x_mean;
+        const double n1 = y[k] - y_mean;
+        x[k] = CRS_horner(E, e1, n1, order);
+        y[k] = CRS_horner(N, e1, n1, order);
+        panSuccess[k] = TRUE;
+    };
+
+    int i = 0;
+    for( ; i + 1 < nPointCount; i += 2 )
+    {
+        if( x[i] == HUGE_VAL || y[i] == HUGE_VAL ||
+            x[i+1] == HUGE_VAL || y[i+1] == HUGE_VAL )
+        {
+            TransformOne(i);
+            TransformOne(i + 1);
+            continue;
+        }
+        const XMMReg2Double e1 = XMMReg2Double::Load2Val(x + i) - oXMean;
+        const XMMReg2Double n1 = XMMReg2Double::Load2Val(y + i) - oYMean;
+        CRS_horner(aoE, e1, n1, order).Store2Val(x + i);
+        CRS_horner(aoN, e1, n1, order).Store2Val(y + i);
+        panSuccess[i] = TRUE;
+        panSuccess[i+1] = TRUE;
+    }
+    if( i < nPointCount )
+        TransformOne(i);
+}
+
 /***************************************************************************/
 /*
     COMPUTE THE GEOREFFERENCING COEFFICIENTS BASED ON A SET OF CONTROL POINTS
@@ -36,17 +36,23 @@
 #include <cstring>
 
 #include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_mem_cache.h"
 #include "cpl_minixml.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
 #include "gdal_mdreader.h"
 #include "gdal_priv.h"
-#if defined(__x86_64) || defined(_M_X64)
+#if defined(__x86_64) || defined(_M_X64) || defined(__aarch64__)
 #  define USE_SSE2_OPTIM
 #  include "gdalsse_priv.h"
 #endif
@@ -234,6 +240,8 @@ typedef enum {
   /*! Cubic Convolution Approximation (4x4 kernel) */  DRA_Cubic=2
 } DEMResampleAlg;
 
+class GDALRPCDEMCache;
+
 typedef struct {
 
     GDALTransformerInfo sTI;
@@ -261,21 +269,17 @@ typedef struct {
     int         bApplyDEMVDatumShift;
 
     GDALDataset *poDS;
-    double     *padfDEMBuffer;
-    int         nDEMExtractions;
-    int         nBufferMaxRadius;
-    int         nHitsInBuffer;
-    int         nBufferX;
-    int         nBufferY;
-    int         nBufferWidth;
-    int         nBufferHeight;
-    int         nLastQueriedX;
-    int         nLastQueriedY;
+    GDALRPCDEMCache *poDEMCache;
 
     OGRCoordinateTransformation *poCT;
 
     int         nMaxIterations;
 
+    // Grid of (long, lat) solutions of the inverse transform, used as initial
+    // guesses. Only with RPC_INVERSE_GUESS_GRID=YES.
+    bool        bUseInverseGuessGrid;
+    double     *padfInverseGuessGrid;
+
     double      adfDEMGeoTransform[6];
     double      adfDEMReverseGeoTransform[6];
 
@@ -296,6 +300,215 @@ typedef struct {
 
 static bool GDALRPCOpenDEM( GDALRPCTransformInfo* psTransform );
 
+/************************************************************************/
+/* ==================================================================== */
+/*                            GDALRPCDEMCache                           */
+/* ==================================================================== */
+/************************************************************************/
+
+// Cache of blocks of the first band of a DEM, shared by all the RPC
+// transformers that use the same DEM file at the same time (typically the
+// clones of a transformer used by the threads of a warping operation), so
+// that each block is read only once. Each transformer reads the blocks
+// through its own dataset handle.
+
+constexpr int RPC_DEM_BLOCK_SIZE = 256;
+
+class GDALRPCDEMCache
+{
+        CPLString   m_osDEMPath{};
+        int         m_nRasterXSize = 0;
+        int         m_nRasterYSize = 0;
+        int         m_nRefCount = 1;
+
+        typedef std::shared_ptr<std::vector<double>> BlockData;
+        std::mutex  m_oMutex{};
+        lru11::Cache<GUInt64, BlockData> m_oCache;
+
+        GDALRPCDEMCache(const GDALRPCDEMCache&) = delete;
+        GDALRPCDEMCache& operator=(const GDALRPCDEMCache&) = delete;
+
+        GDALRPCDEMCache( const char* pszDEMPath,
+                         int nRasterXSize, int nRasterYSize,
+                         size_t nMaxBlocks );
+
+        BlockData   GetBlock( GDALDataset* poDS, int nBlockX, int nBlockY );
+
+        static std::mutex& GetRegistryMutex();
+        static std::map<CPLString, GDALRPCDEMCache*>& GetRegistry();
+
+    public:
+        static GDALRPCDEMCache* Acquire( GDALDataset* poDS,
+                                         const char* pszDEMPath );
+        static void Release( GDALRPCDEMCache* poCache );
+
+        bool Extract( GDALDataset* poDS, int nX, int nY,
+                      int nWidth, int nHeight, double* padfOut );
+};
+
+GDALRPCDEMCache::GDALRPCDEMCache( const char* pszDEMPath,
+                                  int nRasterXSize, int nRasterYSize,
+                                  size_t nMaxBlocks ) :
+    m_osDEMPath(pszDEMPath),
+    m_nRasterXSize(nRasterXSize),
+    m_nRasterYSize(nRasterYSize),
+    m_oCache(nMaxBlocks, 0)
+{
+}
+
+std::mutex& GDALRPCDEMCache::GetRegistryMutex()
+{
+    static std::mutex oMutex;
+    return oMutex;
+}
+
+std::map<CPLString, GDALRPCDEMCache*>& GDALRPCDEMCache::GetRegistry()
+{
+    static std::map<CPLString, GDALRPCDEMCache*> oMap;
+    return oMap;
+}
+
+/************************************************************************/
+/*                              Acquire()                               */
+/************************************************************************/
+
+GDALRPCDEMCache* GDALRPCDEMCache::Acquire( GDALDataset* poDS,
+                                           const char* pszDEMPath )
+{
+    std::lock_guard<std::mutex> oLock(GetRegistryMutex());
+    auto& oRegistry = GetRegistry();
+    auto oIter = oRegistry.find(pszDEMPath);
+    if( oIter != oRegistry.end() &&
+        oIter->second->m_nRasterXSize == poDS->GetRasterXSize() &&
+        oIter->second->m_nRasterYSize == poDS->GetRasterYSize() )
+    {
+        oIter->second->m_nRefCount++;
+        return oIter->second;
+    }
+
+    const GIntBig nCacheSize = static_cast<GIntBig>(
+        atoi(CPLGetConfigOption("GDAL_RPC_DEM_CACHE_SIZE", "64"))) *
+                                                                1024 * 1024;
+    const GIntBig nBlockSize = static_cast<GIntBig>(RPC_DEM_BLOCK_SIZE) *
+                                        RPC_DEM_BLOCK_SIZE * sizeof(double);
+    const size_t nMaxBlocks = static_cast<size_t>(
+        std::max(static_cast<GIntBig>(4), nCacheSize / nBlockSize));
+    auto poCache = new GDALRPCDEMCache(pszDEMPath,
+                                       poDS->GetRasterXSize(),
+                                       poDS->GetRasterYSize(),
+                                       nMaxBlocks);
+    // A DEM with different dimensions under the same name keeps its own
+    // cache, not registered.
+    if( oIter == oRegistry.end() )
+        oRegistry[pszDEMPath] = poCache;
+    return poCache;
+}
+
+/************************************************************************/
+/*                              Release()                               */
+/************************************************************************/
+
+void GDALRPCDEMCache::Release( GDALRPCDEMCache* poCache )
+{
+    if( poCache == nullptr )
+        return;
+    std::lock_guard<std::mutex> oLock(GetRegistryMutex());
+    if( --poCache->m_nRefCount > 0 )
+        return;
+    auto& oRegistry = GetRegistry();
+    auto oIter = oRegistry.find(poCache->m_osDEMPath);
+    if( oIter != oRegistry.end() && oIter->second == poCache )
+        oRegistry.erase(oIter);
+    delete poCache;
+}
+
+/************************************************************************/
+/*                              GetBlock()                              */
+/************************************************************************/
+
+GDALRPCDEMCache::BlockData GDALRPCDEMCache::GetBlock( GDALDataset* poDS,
+                                                      int nBlockX,
+                                                      int nBlockY )
+{
+    const GUInt64 nKey = (static_cast<GUInt64>(nBlockY) << 32) |
+                         static_cast<GUInt32>(nBlockX);
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        BlockData poBlock;
+        if( m_oCache.tryGet(nKey, poBlock) )
+            return poBlock;
+    }
+
+    // Read without holding the lock, so that threads with their own
+    // dataset handle can read different blocks at the same time.
+    const int nXOff = nBlockX * RPC_DEM_BLOCK_SIZE;
+    const int nYOff = nBlockY * RPC_DEM_BLOCK_SIZE;
+    const int nXSize = std::min(RPC_DEM_BLOCK_SIZE, m_nRasterXSize - nXOff);
+    const int nYSize = std::min(RPC_DEM_BLOCK_SIZE, m_nRasterYSize - nYOff);
+    BlockData poBlock;
+    try
+    {
+        poBlock = std::make_shared<std::vector<double>>(
+            static_cast<size_t>(nXSize) * nYSize);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory, "Cannot allocate DEM block");
+        return nullptr;
+    }
+    if( poDS->GetRasterBand(1)->RasterIO(GF_Read, nXOff, nYOff, nXSize, nYSize,
+                                         poBlock->data(), nXSize, nYSize,
+                                         GDT_Float64, 0, 0,
+                                         nullptr) != CE_None )
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    m_oCache.insert(nKey, poBlock);
+    return poBlock;
+}
+
+/************************************************************************/
+/*                              Extract()                               */
+/************************************************************************/
+
+bool GDALRPCDEMCache::Extract( GDALDataset* poDS, int nX, int nY,
+                               int nWidth, int nHeight, double* padfOut )
+{
+    // Windows are at most 4x4, so they cover at most 4 blocks.
+    for( int nBlockY = nY / RPC_DEM_BLOCK_SIZE;
+         nBlockY <= (nY + nHeight - 1) / RPC_DEM_BLOCK_SIZE; nBlockY++ )
+    {
+        for( int nBlockX = nX / RPC_DEM_BLOCK_SIZE;
+             nBlockX <= (nX + nWidth - 1) / RPC_DEM_BLOCK_SIZE; nBlockX++ )
+        {
+            const auto poBlock = GetBlock(poDS, nBlockX, nBlockY);
+            if( poBlock == nullptr )
+                return false;
+
+            const int nBlockXOff = nBlockX * RPC_DEM_BLOCK_SIZE;
+            const int nBlockYOff = nBlockY * RPC_DEM_BLOCK_SIZE;
+            const int nBlockXSize =
+                std::min(RPC_DEM_BLOCK_SIZE, m_nRasterXSize - nBlockXOff);
+            const int nXStart = std::max(nX, nBlockXOff);
+            const int nXEnd = std::min(nX + nWidth, nBlockXOff + nBlockXSize);
+            const int nYStart = std::max(nY, nBlockYOff);
+            const int nYEnd = std::min(nY + nHeight,
+                                       nBlockYOff + RPC_DEM_BLOCK_SIZE);
+            for( int iY = nYStart; iY < nYEnd; iY++ )
+            {
+                memcpy( padfOut + (iY - nY) * nWidth + nXStart - nX,
+                        poBlock->data() +
+                            static_cast<size_t>(iY - nBlockYOff) * nBlockXSize +
+                            nXStart - nBlockXOff,
+                        (nXEnd - nXStart) * sizeof(double) );
+            }
+        }
+    }
+    return true;
+}
+
 /************************************************************************/
 /*                            RPCEvaluate()                             */
 /************************************************************************/
@@ -363,19 +576,16 @@ static double RPCEvaluate( const double *padfTerms, const double *padfCoefs )
 #endif
 
 /************************************************************************/
-/*                         RPCTransformPoint()                          */
+/*                         RPCNormalizeInputs()                         */
 /************************************************************************/
 
-static void RPCTransformPoint( const GDALRPCTransformInfo *psRPCTransformInfo,
-                               double dfLong, double dfLat, double dfHeight,
-                               double *pdfPixel, double *pdfLine )
+static void RPCNormalizeInputs( const GDALRPCTransformInfo *psRPCTransformInfo,
+                                double dfLong, double dfLat, double dfHeight,
+                                double& dfNormalizedLong,
+                                double& dfNormalizedLat,
+                                double& dfNormalizedHeight )
 
 {
-    double adfTermsWithMargin[20+1] = {};
-    // Make padfTerms aligned on 16-byte boundary for SSE2 aligned loads.
-    double* padfTerms =
-        adfTermsWithMargin + (reinterpret_cast<GUIntptr_t>(adfTermsWithMargin) % 16) / 8;
-
     // Avoid dateline issues.
     double diffLong = dfLong - psRPCTransformInfo->sRPC.dfLONG_OFF;
     if( diffLong < -270 )
@@ -387,12 +597,12 @@ static void RPCTransformPoint( const GDALRPCTransformInfo *psRPCTransformInfo,
         diffLong -= 360;
     }
 
-    const double dfNormalizedLong =
+    dfNormalizedLong =
       diffLong / psRPCTransformInfo->sRPC.dfLONG_SCALE;
-    const double dfNormalizedLat =
+    dfNormalizedLat =
         (dfLat - psRPCTransformInfo->sRPC.dfLAT_OFF) /
         psRPCTransformInfo->sRPC.dfLAT_SCALE;
-    const double dfNormalizedHeight =
+    dfNormalizedHeight =
         (dfHeight - psRPCTransformInfo->sRPC.dfHEIGHT_OFF) /
         psRPCTransformInfo->sRPC.dfHEIGHT_SCALE;
 
@@ -441,6 +651,27 @@ static void RPCTransformPoint( const GDALRPCTransformInfo *psRPCTransformInfo,
             }
         }
     }
+}
+
+/************************************************************************/
+/*                         RPCTransformPoint()                          */
+/************************************************************************/
+
+static void RPCTransformPoint( const GDALRPCTransformInfo *psRPCTransformInfo,
+                               double dfLong, double dfLat, double dfHeight,
+                               double *pdfPixel, double *pdfLine )
+
+{
+    double adfTermsWithMargin[20+1] = {};
+    // Make padfTerms aligned on 16-byte boundary for SSE2 aligned loads.
+    double* padfTerms =
+        adfTermsWithMargin + (reinterpret_cast<GUIntptr_t>(adfTermsWithMargin) % 16) / 8;
+
+    double dfNormalizedLong = 0.0;
+    double dfNormalizedLat = 0.0;
+    double dfNormalizedHeight = 0.0;
+    RPCNormalizeInputs( psRPCTransformInfo, dfLong, dfLat, dfHeight,
+                        dfNormalizedLong, dfNormalizedLat, dfNormalizedHeight );
 
     RPCComputeTerms( dfNormalizedLong, dfNormalizedLat,
                      dfNormalizedHeight, padfTerms );
@@ -473,6 +704,90 @@ static void RPCTransformPoint( const GDALRPCTransformInfo *psRPCTransformInfo,
         + psRPCTransformInfo->sRPC.dfLINE_OFF + 0.5;
 }
 
+/************************************************************************/
+/*                         RPCTransformPoints()                         */
+/************************************************************************/
+
+// Same as RPCTransformPoint() on an array of points. With SSE2, the
+// polynomials are evaluated on two points at once, summing the terms in the
+// same order as RPCEvaluate4(), so that the results are identical.
+
+static void RPCTransformPoints( const GDALRPCTransformInfo *psRPCTransformInfo,
+                                int nPointCount,
+                                const double *padfLong, const double *padfLat,
+                                const double *padfHeight,
+                                double *padfPixel, double *padfLine )
+
+{
+    int i = 0;
+#ifdef USE_SSE2_OPTIM
+    const double dfOne = 1.0;
+    const XMMReg2Double one = XMMReg2Double::Load1ValHighAndLow(&dfOne);
+    const double* padfCoefs = psRPCTransformInfo->padfCoeffs;
+
+    for( ; i + 1 < nPointCount; i += 2 )
+    {
+        double adfNormalizedLong[2] = { 0.0, 0.0 };
+        double adfNormalizedLat[2] = { 0.0, 0.0 };
+        double adfNormalizedHeight[2] = { 0.0, 0.0 };
+        for( int j = 0; j < 2; j++ )
+        {
+            RPCNormalizeInputs( psRPCTransformInfo,
+                                padfLong[i + j], padfLat[i + j],
+                                padfHeight[i + j],
+                                adfNormalizedLong[j], adfNormalizedLat[j],
+                                adfNormalizedHeight[j] );
+        }
+        const XMMReg2Double x = XMMReg2Double::Load2Val(adfNormalizedLong);
+        const XMMReg2Double y = XMMReg2Double::Load2Val(adfNormalizedLat);
+        const XMMReg2Double z = XMMReg2Double::Load2Val(adfNormalizedHeight);
+
+        // Same terms as RPCComputeTerms(), for both points.
+        const XMMReg2Double aTerms[20] = {
+            one, x, y, z,
+            x * y, x * z, y * z, x * x, y * y, z * z,
+            x * y * z, x * x * x, x * y * y, x * z * z, x * x * y,
+            y * y * y, y * z * z, x * x * z, y * y * z, z * z * z };
+
+        // LINE_NUM_COEFF, LINE_DEN_COEFF, SAMP_NUM_COEFF, SAMP_DEN_COEFF.
+        XMMReg2Double aSums[4];
+        for( int k = 0; k < 4; k++ )
+        {
+            XMMReg2Double sumEven = XMMReg2Double::Zero();
+            XMMReg2Double sumOdd = XMMReg2Double::Zero();
+            for( int iTerm = 0; iTerm < 20; iTerm += 2 )
+            {
+                sumEven += aTerms[iTerm] *
+                    XMMReg2Double::Load1ValHighAndLow(padfCoefs + 20 * k + iTerm);
+                sumOdd += aTerms[iTerm + 1] *
+                    XMMReg2Double::Load1ValHighAndLow(padfCoefs + 20 * k + iTerm + 1);
+            }
+            aSums[k] = sumEven + sumOdd;
+        }
+
+        double adfResultX[2];
+        double adfResultY[2];
+        (aSums[2] / aSums[3]).Store2Val(adfResultX);
+        (aSums[0] / aSums[1]).Store2Val(adfResultY);
+        for( int j = 0; j < 2; j++ )
+        {
+            padfPixel[i + j] =
+                adfResultX[j] * psRPCTransformInfo->sRPC.dfSAMP_SCALE
+                + psRPCTransformInfo->sRPC.dfSAMP_OFF + 0.5;
+            padfLine[i + j] =
+                adfResultY[j] * psRPCTransformInfo->sRPC.dfLINE_SCALE
+                + psRPCTransformInfo->sRPC.dfLINE_OFF + 0.5;
+        }
+    }
+#endif
+    for( ; i < nPointCount; i++ )
+    {
+        RPCTransformPoint( psRPCTransformInfo,
+                           padfLong[i], padfLat[i], padfHeight[i],
+                           padfPixel + i, padfLine + i );
+    }
+}
+
 /************************************************************************/
 /*                     GDALSerializeRPCDEMResample()                    */
 /************************************************************************/
@@ -537,6 +852,9 @@ void* GDALCreateSimilarRPCTransformer( void *hTransformArg,
     }
     papszOptions = CSLSetNameValue(papszOptions, "RPC_MAX_ITERATIONS",
                                    CPLSPrintf("%d", psInfo->nMaxIterations));
+    if( psInfo->bUseInverseGuessGrid )
+        papszOptions = CSLSetNameValue(papszOptions,
+                                       "RPC_INVERSE_GUESS_GRID", "YES");
 
     GDALRPCTransformInfo* psNewInfo =
         static_cast<GDALRPCTransformInfo*>(GDALCreateRPCTransformerV2(
@@ -788,6 +1106,14 @@ void *GDALCreateRPCTransformerV1( GDALRPCInfoV1 *psRPCInfo, int bReversed,
  * iterative solution of pixel/line to lat/long computations. Default value is
  * 10 in the absence of a DEM, or 20 if there is a DEM.  (GDAL >= 2.1.0)</li>
  *
+ * <li> RPC_INVERSE_GUESS_GRID: whether the initial guess of the iterative
+ * solution of pixel/line to lat/long computations should be interpolated from
+ * a grid of solutions over the image, computed once, instead of derived from
+ * an affine approximation around the reference point. This reduces the number
+ * of iterations, in particular with a DEM, when transforming many points.
+ * Results may differ from the default mode within the pixel error threshold.
+ * Defaults to NO.</li>
+ *
  * <li> RPC_FOOTPRINT: WKT or GeoJSON polygon (in long / lat coordinate space)
  * with a validity footprint for the RPC. Any coordinate transformation that
  * goes from or arrive outside this footprint will be considered invalid. This
@@ -946,6 +1272,9 @@ void *GDALCreateRPCTransformerV2( const GDALRPCInfoV2 *psRPCInfo, int bReversed,
     psTransform->nMaxIterations = atoi( CSLFetchNameValueDef(
         papszOptions, "RPC_MAX_ITERATIONS", "0" ) );
 
+    psTransform->bUseInverseGuessGrid =
+        CPLFetchBool( papszOptions, "RPC_INVERSE_GUESS_GRID", false );
+
 /* -------------------------------------------------------------------- */
 /*      Debug                                                           */
 /* -------------------------------------------------------------------- */
@@ -1114,9 +1443,10 @@ void GDALDestroyRPCTransformer( void *pTransformAlg )
     CPLFree( psTransform->pszDEMPath );
     CPLFree( psTransform->pszDEMSRS );
 
+    GDALRPCDEMCache::Release(psTransform->poDEMCache);
     if( psTransform->poDS )
         GDALClose(psTransform->poDS);
-    CPLFree(psTransform->padfDEMBuffer);
+    CPLFree(psTransform->padfInverseGuessGrid);
     if( psTransform->poCT )
         OCTDestroyCoordinateTransformation(
             reinterpret_cast<OGRCoordinateTransformationH>(psTransform->poCT));
@@ -1129,6 +1459,83 @@ void GDALDestroyRPCTransformer( void *pTransformAlg )
     CPLFree( pTransformAlg );
 }
 
+/************************************************************************/
+/*                     RPCGetInverseGuessFromGrid()                     */
+/************************************************************************/
+
+// Number of intervals, along each axis, of the grid of inverse solutions
+// covering the image.
+constexpr int RPC_INVERSE_GUESS_GRID_STEPS = 16;
+
+static void RPCGetInverseGuessGridNode( const GDALRPCTransformInfo *psTransform,
+                                        int iNode, double& dfPixel,
+                                        double& dfLine )
+{
+    const int iX = iNode % (RPC_INVERSE_GUESS_GRID_STEPS + 1);
+    const int iY = iNode / (RPC_INVERSE_GUESS_GRID_STEPS + 1);
+    dfPixel = psTransform->sRPC.dfSAMP_OFF - psTransform->sRPC.dfSAMP_SCALE +
+              0.5 + iX * 2 * psTransform->sRPC.dfSAMP_SCALE /
+                                            RPC_INVERSE_GUESS_GRID_STEPS;
+    dfLine = psTransform->sRPC.dfLINE_OFF - psTransform->sRPC.dfLINE_SCALE +
+             0.5 + iY * 2 * psTransform->sRPC.dfLINE_SCALE /
+                                            RPC_INVERSE_GUESS_GRID_STEPS;
+}
+
+static void RPCGetInverseGuessFromGrid( const GDALRPCTransformInfo *psTransform,
+                                        double dfPixel, double dfLine,
+                                        double& dfLong, double& dfLat )
+{
+    const double* padfGrid = psTransform->padfInverseGuessGrid;
+    if( padfGrid == nullptr )
+        return;
+
+    const double dfGridX =
+        (dfPixel - 0.5 - (psTransform->sRPC.dfSAMP_OFF -
+                          psTransform->sRPC.dfSAMP_SCALE)) *
+        RPC_INVERSE_GUESS_GRID_STEPS / (2 * psTransform->sRPC.dfSAMP_SCALE);
+    const double dfGridY =
+        (dfLine - 0.5 - (psTransform->sRPC.dfLINE_OFF -
+                         psTransform->sRPC.dfLINE_SCALE)) *
+        RPC_INVERSE_GUESS_GRID_STEPS / (2 * psTransform->sRPC.dfLINE_SCALE);
+    if( !(dfGridX >= 0 && dfGridX <= RPC_INVERSE_GUESS_GRID_STEPS &&
+          dfGridY >= 0 && dfGridY <= RPC_INVERSE_GUESS_GRID_STEPS) )
+        return;
+
+    const int iX = std::min(static_cast<int>(dfGridX),
+                            RPC_INVERSE_GUESS_GRID_STEPS - 1);
+    const int iY = std::min(static_cast<int>(dfGridY),
+                            RPC_INVERSE_GUESS_GRID_STEPS - 1);
+    const int nNodesPerLine = RPC_INVERSE_GUESS_GRID_STEPS + 1;
+    const int anNodes[4] = { iY * nNodesPerLine + iX,
+                             iY * nNodesPerLine + iX + 1,
+                             (iY + 1) * nNodesPerLine + iX,
+                             (iY + 1) * nNodesPerLine + iX + 1 };
+    double dfMinLong = std::numeric_limits<double>::max();
+    double dfMaxLong = -std::numeric_limits<double>::max();
+    for( int iNode: anNodes )
+    {
+        // NaN for nodes where the inverse transform failed.
+        if( std::isnan(padfGrid[2 * iNode]) )
+            return;
+        dfMinLong = std::min(dfMinLong, padfGrid[2 * iNode]);
+        dfMaxLong = std::max(dfMaxLong, padfGrid[2 * iNode]);
+    }
+    // Do not interpolate across the antimeridian.
+    if( dfMaxLong - dfMinLong > 180 )
+        return;
+
+    const double dfDX = dfGridX - iX;
+    const double dfDY = dfGridY - iY;
+    for( int k = 0; k < 2; k++ )
+    {
+        const double dfTop = padfGrid[2 * anNodes[0] + k] * (1 - dfDX) +
+                             padfGrid[2 * anNodes[1] + k] * dfDX;
+        const double dfBottom = padfGrid[2 * anNodes[2] + k] * (1 - dfDX) +
+                                padfGrid[2 * anNodes[3] + k] * dfDX;
+        (k == 0 ? dfLong : dfLat) = dfTop * (1 - dfDY) + dfBottom * dfDY;
+    }
+}
+
 /************************************************************************/
 /*                      RPCInverseTransformPoint()                      */
 /************************************************************************/
@@ -1157,6 +1564,10 @@ RPCInverseTransformPoint( GDALRPCTransformInfo *psTransform,
         psTransform->adfPLToLatLongGeoTransform[4] * dfPixel +
         psTransform->adfPLToLatLongGeoTransform[5] * dfLine;
 
+    // Better guess from the grid of solutions, when available.
+    RPCGetInverseGuessFromGrid( psTransform, dfPixel, dfLine,
+                                dfResultX, dfResultY );
+
     if( psTransform->bRPCInverseVerbose )
     {
         CPLDebug("RPC", "Computing inverse transform for (pixel,line)=(%f,%f)",
@@ -1385,6 +1796,34 @@ RPCInverseTransformPoint( GDALRPCTransformInfo *psTransform,
     return true;
 }
 
+/************************************************************************/
+/*                      RPCBuildInverseGuessGrid()                      */
+/************************************************************************/
+
+static void RPCBuildInverseGuessGrid( GDALRPCTransformInfo *psTransform )
+{
+    const int nNodes = (RPC_INVERSE_GUESS_GRID_STEPS + 1) *
+                       (RPC_INVERSE_GUESS_GRID_STEPS + 1);
+    double* padfGrid = static_cast<double*>(
+        VSI_MALLOC2_VERBOSE(2 * nNodes, sizeof(double)));
+    if( padfGrid == nullptr )
+        return;
+    for( int iNode = 0; iNode < nNodes; iNode++ )
+    {
+        double dfPixel = 0.0;
+        double dfLine = 0.0;
+        RPCGetInverseGuessGridNode( psTransform, iNode, dfPixel, dfLine );
+        if( !RPCInverseTransformPoint( psTransform, dfPixel, dfLine, 0.0,
+                                       padfGrid + 2 * iNode,
+                                       padfGrid + 2 * iNode + 1 ) )
+        {
+            padfGrid[2 * iNode] = std::numeric_limits<double>::quiet_NaN();
+            padfGrid[2 * iNode + 1] = std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+    psTransform->padfInverseGuessGrid = padfGrid;
+}
+
 static
 double BiCubicKernel( double dfVal )
 {
@@ -1412,10 +1851,8 @@ static bool GDALRPCExtractDEMWindow( GDALRPCTransformInfo *psTransform,
                                      int nX, int nY, int nWidth, int nHeight,
                                      double* padfOut )
 {
-    psTransform->nDEMExtractions++;
-    if( psTransform->padfDEMBuffer == nullptr )
+    if( psTransform->poDEMCache == nullptr )
     {
-        // Should only happen in case of failed memory allocation.
         return psTransform->poDS->GetRasterBand(1)->
                                   RasterIO(GF_Read, nX, nY, nWidth, nHeight,
                                            padfOut, nWidth, nHeight,
@@ -1423,104 +1860,9 @@ static bool GDALRPCExtractDEMWindow( GDALRPCTransformInfo *psTransform,
                                            nullptr) == CE_None;
     }
 
-    // Instead of reading just nWidth * nHeight pixels (with those being <= 4),
-    // target a larger buffer since small extractions can be costly, particular
-    // with VRT.
-    if( !(nX >= psTransform->nBufferX &&
-          nX + nWidth <= psTransform->nBufferX + psTransform->nBufferWidth &&
-          nY >= psTransform->nBufferY &&
-          nY + nHeight <= psTransform->nBufferY + psTransform->nBufferHeight ) )
-    {
-#ifdef DEBUG_VERBOSE_EXTRACT_DEM
-        CPLDebug("RPC", "Current request: %d,%d-%dx%d",
-                  nX, nY, nWidth, nHeight);
-        CPLDebug("RPC", "Hits in last DEM buffer: %d (%d pixels)",
-                 psTransform->nHitsInBuffer,
-                 psTransform->nBufferWidth * psTransform->nBufferHeight);
-        CPLDebug("RPC", "Last DEM buffer: %d,%d-%dx%d",
-                 psTransform->nBufferX,
-                 psTransform->nBufferY,
-                 psTransform->nBufferWidth,
-                 psTransform->nBufferHeight);
-#endif
-        const int nRasterXSize = psTransform->poDS->GetRasterXSize();
-        const int nRasterYSize = psTransform->poDS->GetRasterYSize();
-        // If we have only queried a few points, no need to extract on a large
-        // window We will progressively extend the window up to its maximum size
-        // if we extract a significant number of points.
-        int nRadius = psTransform->nBufferMaxRadius;
-        if( psTransform->nDEMExtractions <
-            psTransform->nBufferMaxRadius * psTransform->nBufferMaxRadius )
-        {
-            nRadius = static_cast<int> (
-                  sqrt(static_cast<double>(psTransform->nDEMExtractions)) );
-            CPLAssert( nRadius <= psTransform->nBufferMaxRadius );
-        }
-        // Check if there's some overlap between consecutive requests to decide
-        // if we must have a buffer around the interest window.
-        const int nDiffX = nX - psTransform->nLastQueriedX;
-        const int nDiffY = nY - psTransform->nLastQueriedY;
-        if( psTransform->nLastQueriedX >= 0 &&
-            (nDiffX > nRadius || -nDiffX > nRadius ||
-             nDiffY > nRadius || -nDiffY > nRadius) )
-        {
-            nRadius = 0;
-        }
-        psTransform->nBufferX = nX - nRadius;
-        if( psTransform->nBufferX < 0 )
-            psTransform->nBufferX = 0;
-        psTransform->nBufferY = nY - nRadius;
-        if( psTransform->nBufferY < 0 )
-            psTransform->nBufferY = 0;
-        psTransform->nBufferWidth = nWidth + 2 * nRadius;
-        if( psTransform->nBufferX + psTransform->nBufferWidth > nRasterXSize )
-            psTransform->nBufferWidth = nRasterXSize - psTransform->nBufferX;
-        psTransform->nBufferHeight = nHeight + 2 * nRadius;
-        if( psTransform->nBufferY + psTransform->nBufferHeight > nRasterYSize )
-            psTransform->nBufferHeight = nRasterYSize - psTransform->nBufferY;
-#ifdef DEBUG_VERBOSE_EXTRACT_DEM
-        CPLDebug("RPC", "New DEM buffer: %d,%d-%dx%d",
-                 psTransform->nBufferX,
-                 psTransform->nBufferY,
-                 psTransform->nBufferWidth,
-                 psTransform->nBufferHeight);
-#endif
-        CPLErr eErr = psTransform->poDS->GetRasterBand(1)->RasterIO(GF_Read,
-                        psTransform->nBufferX, psTransform->nBufferY,
-                        psTransform->nBufferWidth, psTransform->nBufferHeight,
-                        psTransform->padfDEMBuffer,
-                        psTransform->nBufferWidth, psTransform->nBufferHeight,
-                        GDT_Float64, 0, 0, nullptr);
-        if( eErr != CE_None )
-        {
-            psTransform->nBufferX = -1;
-            psTransform->nBufferY = -1;
-            psTransform->nBufferWidth = -1;
-            psTransform->nBufferHeight = -1;
-            return false;
-        }
-#ifdef DEBUG_VERBOSE_EXTRACT_DEM
-         psTransform->nHitsInBuffer = 1;
-#endif
-    }
-    else
-    {
-#ifdef DEBUG_VERBOSE
-        psTransform->nHitsInBuffer++;
-#endif
-    }
-    psTransform->nLastQueriedX = nX;
-    psTransform->nLastQueriedY = nY;
-
-    for( int i=0; i<nHeight; i++)
-    {
-        memcpy( padfOut + i * nWidth,
-                psTransform->padfDEMBuffer + (nY - psTransform->nBufferY + i) *
-                    psTransform->nBufferWidth + nX - psTransform->nBufferX,
-                nWidth * sizeof(double) );
-    }
-
-    return true;
+    return psTransform->poDEMCache->Extract( psTransform->poDS,
+                                             nX, nY, nWidth, nHeight,
+                                             padfOut );
 }
 
 /************************************************************************/
@@ -1947,20 +2289,8 @@ static bool GDALRPCOpenDEM( GDALRPCTransformInfo* psTransform )
     if( psTransform->poDS != nullptr &&
         psTransform->poDS->GetRasterCount() >= 1 )
     {
-        psTransform->nBufferMaxRadius =
-            atoi(CPLGetConfigOption("GDAL_RPC_DEM_BUFFER_MAX_RADIUS", "2"));
-        psTransform->nHitsInBuffer = 0;
-        const int nMaxWindowSize = 4;
-        psTransform->padfDEMBuffer = static_cast<double*>(VSIMalloc(
-            (nMaxWindowSize + 2 * psTransform->nBufferMaxRadius) *
-            (nMaxWindowSize + 2 * psTransform->nBufferMaxRadius) *
-            sizeof(double) ));
-        psTransform->nBufferX = -1;
-        psTransform->nBufferY = -1;
-        psTransform->nBufferWidth = -1;
-        psTransform->nBufferHeight = -1;
-        psTransform->nLastQueriedX = -1;
-        psTransform->nLastQueriedY = -1;
+        psTransform->poDEMCache =
+            GDALRPCDEMCache::Acquire(psTransform->poDS, psTransform->pszDEMPath);
 
         OGRSpatialReference oDEMSRS;
         if ( psTransform->pszDEMSRS != nullptr )
@@ -2197,6 +2527,28 @@ int GDALRPCTransform( void *pTransformArg, int bDstToSrc,
             }
         }
 
+        // Collect the heights of chunks of valid points, and evaluate the
+        // polynomials on each chunk at once.
+        constexpr int CHUNK_SIZE = 64;
+        int anIndices[CHUNK_SIZE];
+        double adfLong[CHUNK_SIZE];
+        double adfLat[CHUNK_SIZE];
+        double adfHeight[CHUNK_SIZE];
+        double adfPixel[CHUNK_SIZE];
+        double adfLine[CHUNK_SIZE];
+        int nValid = 0;
+        const auto FlushChunk = [&]()
+        {
+            RPCTransformPoints( psTransform, nValid, adfLong, adfLat,
+                                adfHeight, adfPixel, adfLine );
+            for( int j = 0; j < nValid; j++ )
+            {
+                padfX[anIndices[j]] = adfPixel[j];
+                padfY[anIndices[j]] = adfLine[j];
+            }
+            nValid = 0;
+        };
+
         for( int i = 0; i < nPointCount; i++ )
         {
             if( !RPCIsValidLongLat(psTransform, padfX[i], padfY[i]) )
@@ -2216,11 +2568,16 @@ int GDALRPCTransform( void *pTransformArg, int bDstToSrc,
                 continue;
             }
 
-            RPCTransformPoint( psTransform, padfX[i], padfY[i],
-                               (padfZ ? padfZ[i] : 0.0) + dfHeight,
-                                padfX + i, padfY + i );
+            anIndices[nValid] = i;
+            adfLong[nValid] = padfX[i];
+            adfLat[nValid] = padfY[i];
+            adfHeight[nValid] = (padfZ ? padfZ[i] : 0.0) + dfHeight;
+            nValid++;
+            if( nValid == CHUNK_SIZE )
+                FlushChunk();
             panSuccess[i] = TRUE;
         }
+        FlushChunk();
 
         return TRUE;
     }
@@ -2237,6 +2594,13 @@ int GDALRPCTransform( void *pTransformArg, int bDstToSrc,
 /*      function uses an iterative method from an initial linear        */
 /*      approximation.                                                  */
 /* -------------------------------------------------------------------- */
+    if( psTransform->bUseInverseGuessGrid &&
+        psTransform->padfInverseGuessGrid == nullptr &&
+        psTransform->pszRPCInverseLog == nullptr )
+    {
+        RPCBuildInverseGuessGrid( psTransform );
+    }
+
     for( int i = 0; i < nPointCount; i++ )
     {
         double dfResultX = 0.0;
@@ -2349,6 +2713,9 @@ CPLXMLNode *GDALSerializeRPCTransformer( void *pTransformArg )
         psTree, "PixErrThreshold",
         CPLString().Printf( "%.15g", psInfo->dfPixErrThreshold ) );
 
+    if( psInfo->bUseInverseGuessGrid )
+        CPLCreateXMLElementAndValue( psTree, "InverseGuessGrid", "true" );
+
 /* -------------------------------------------------------------------- */
 /*      RPC metadata.                                                   */
 /* -------------------------------------------------------------------- */
@@ -2464,6 +2831,12 @@ void *GDALDeserializeRPCTransformer( CPLXMLNode *psTree )
     if( pszDEMSRS != nullptr )
         papszOptions = CSLSetNameValue(papszOptions, "RPC_DEM_SRS", pszDEMSRS);
 
+    const char* pszInverseGuessGrid =
+        CPLGetXMLValue(psTree, "InverseGuessGrid", nullptr);
+    if( pszInverseGuessGrid != nullptr )
+        papszOptions = CSLSetNameValue(papszOptions, "RPC_INVERSE_GUESS_GRID",
+                                       pszInverseGuessGrid);
+
 /* -------------------------------------------------------------------- */
 /*      Generate transformation.                                        */
 /* -------------------------------------------------------------------- */
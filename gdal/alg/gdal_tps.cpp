@@ -32,6 +32,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
 #include <map>
 #include <utility>
 
@@ -67,6 +68,8 @@ typedef struct
     int       nGCPCount;
     GDAL_GCP *pasGCPList;
 
+    int       nApproxGridSize;
+
     volatile int nRefCount;
 
 } TPSTransformInfo;
@@ -98,9 +101,15 @@ void* GDALCreateSimilarTPSTransformer( void *hTransformArg,
             pasGCPList[i].dfGCPPixel /= dfRatioX;
             pasGCPList[i].dfGCPLine /= dfRatioY;
         }
+        char** papszOptions = nullptr;
+        if( psInfo->nApproxGridSize > 0 )
+            papszOptions = CSLSetNameValue(
+                papszOptions, "TPS_APPROX_GRID_SIZE",
+                CPLSPrintf("%d", psInfo->nApproxGridSize));
         psInfo = static_cast<TPSTransformInfo *>(
-            GDALCreateTPSTransformer( psInfo->nGCPCount, pasGCPList,
-                                      psInfo->bReversed ));
+            GDALCreateTPSTransformerInt( psInfo->nGCPCount, pasGCPList,
+                                         psInfo->bReversed, papszOptions ));
+        CSLDestroy(papszOptions);
         GDALDeinitGCPs( psInfo->nGCPCount, pasGCPList );
         CPLFree( pasGCPList );
     }
@@ -127,6 +136,19 @@ void* GDALCreateSimilarTPSTransformer( void *hTransformArg,
  * for large numbers of GCPs.  For instance, for reference, it takes on the
  * order of 10s for 400 GCPs on a 2GHz Athlon processor.
  *
+ * When GDAL_NUM_THREADS is set and there are more than 100 GCPs, the forward
+ * and reverse systems are solved in parallel, and the assembly and
+ * factorization of each system is itself spread over the available threads.
+ *
+ * Evaluating the transformation costs one term per GCP, which becomes the
+ * bottleneck when warping with thousands of GCPs. The GDAL_TPS_APPROX_GRID_SIZE
+ * configuration option (or the TPS_APPROX_GRID_SIZE transformer option of
+ * GDALCreateGenImgProjTransformer2()) can be set to a number of cells N (for
+ * example 256) so that the non-affine part of the spline is tabulated on a
+ * N x N grid covering the GCPs and bilinearly interpolated for points inside
+ * it. Points outside of the GCP extent are still evaluated exactly. The
+ * approximation no longer honours GCPs exactly, so it is disabled by default.
+ *
  * TPS Transformers are serializable.
  *
  * The GDAL Thin Plate Spline transformer is based on code provided by
@@ -257,6 +279,15 @@ void *GDALCreateTPSTransformerInt( int nGCPCount, const GDAL_GCP *pasGCPList,
 
     psInfo->nRefCount = 1;
 
+    psInfo->nApproxGridSize = std::max(0, atoi(CSLFetchNameValueDef(
+        papszOptions, "TPS_APPROX_GRID_SIZE",
+        CPLGetConfigOption("GDAL_TPS_APPROX_GRID_SIZE", "0"))));
+    if( psInfo->nApproxGridSize > 0 )
+    {
+        psInfo->poForward->set_approx_grid_size(psInfo->nApproxGridSize);
+        psInfo->poReverse->set_approx_grid_size(psInfo->nApproxGridSize);
+    }
+
     int nThreads = 1;
     if( nGCPCount > 100 )
     {
@@ -272,7 +303,11 @@ void *GDALCreateTPSTransformerInt( int nGCPCount, const GDAL_GCP *pasGCPList,
 
     if( nThreads > 1 )
     {
-        // Compute direct and reverse transforms in parallel.
+        // Compute direct and reverse transforms in parallel, each of them
+        // using half of the threads.
+        const int nThreadsPerSolve = std::max(1, nThreads / 2);
+        psInfo->poForward->set_num_threads(nThreadsPerSolve);
+        psInfo->poReverse->set_num_threads(nThreadsPerSolve);
         CPLJoinableThread* hThread =
             CPLCreateJoinableThread(GDALTPSComputeForwardInThread, psInfo);
         psInfo->bReverseSolved = psInfo->poReverse->solve() != 0;
@@ -418,6 +453,16 @@ CPLXMLNode *GDALSerializeTPSTransformer( void *pTransformArg )
                                    nullptr );
     }
 
+/* -------------------------------------------------------------------- */
+/*      Serialize approximation grid size.                              */
+/* -------------------------------------------------------------------- */
+    if( psInfo->nApproxGridSize > 0 )
+    {
+        CPLCreateXMLElementAndValue(
+            psTree, "ApproxGridSize",
+            CPLString().Printf( "%d", psInfo->nApproxGridSize ) );
+    }
+
     return psTree;
 }
 
@@ -448,11 +493,20 @@ void *GDALDeserializeTPSTransformer( CPLXMLNode *psTree )
 /* -------------------------------------------------------------------- */
     const int bReversed = atoi(CPLGetXMLValue(psTree, "Reversed", "0"));
 
+    char** papszOptions = nullptr;
+    const char* pszApproxGridSize =
+        CPLGetXMLValue(psTree, "ApproxGridSize", nullptr);
+    if( pszApproxGridSize )
+        papszOptions = CSLSetNameValue(papszOptions, "TPS_APPROX_GRID_SIZE",
+                                       pszApproxGridSize);
+
 /* -------------------------------------------------------------------- */
 /*      Generate transformation.                                        */
 /* -------------------------------------------------------------------- */
     void *pResult =
-        GDALCreateTPSTransformer( nGCPCount, pasGCPList, bReversed );
+        GDALCreateTPSTransformerInt( nGCPCount, pasGCPList, bReversed,
+                                     papszOptions );
+    CSLDestroy(papszOptions);
 
 /* -------------------------------------------------------------------- */
 /*      Cleanup GCP copy.                                               */
@@ -27,18 +27,21 @@
  ****************************************************************************/
 
 #include "cpl_string.h"
+#include "cpl_mem_cache.h"
 #include "gdal.h"
 #include "gdal_alg.h"
 #include "gdal_alg_priv.h"
 #include "gdal_priv.h"
 #include "gdal_utils.h"
 #include "gdalwarper.h"
-#include "vrtdataset.h"
 #include "ogr_spatialref.h"
 
 #include "proj.h"
 
+#include <algorithm>
 #include <limits>
+#include <memory>
+#include <vector>
 
 CPL_CVSID("$Id$")
 
@@ -51,21 +54,35 @@ class GDALApplyVSGDataset final: public GDALDataset
         friend class GDALApplyVSGRasterBand;
 
         GDALDataset* m_poSrcDataset = nullptr;
-        GDALDataset* m_poReprojectedGrid = nullptr;
+        GDALDataset* m_poGridDataset = nullptr;
+        GDALWarpOperation* m_poGridWarper = nullptr;
         bool         m_bInverse = false;
         double       m_dfSrcUnitToMeter = 0.0;
         double       m_dfDstUnitToMeter = 0.0;
 
+        // Blocks of the grid warped to the source dataset, indexed by
+        // nBlockYOff * nBlocksPerRow + nBlockXOff. They are kept separately
+        // from the GDAL block cache, so that reading a large source
+        // dataset doesn't evict them and cause the grid to be warped again.
+        typedef std::shared_ptr<std::vector<float>> GridBlock;
+        lru11::Cache<GIntBig, GridBlock> m_oGridBlockCache;
+
         CPL_DISALLOW_COPY_ASSIGN(GDALApplyVSGDataset)
 
+        GridBlock    GetGridBlock( int nBlockXOff, int nBlockYOff,
+                                   int nBlockSize,
+                                   int nReqXSize, int nReqYSize );
+
     public:
         GDALApplyVSGDataset( GDALDataset* poSrcDataset,
-                             GDALDataset* poReprojectedGrid,
+                             GDALDataset* poGridDataset,
+                             GDALWarpOperation* poGridWarper,
                              GDALDataType eDT,
                              bool bInverse,
                              double dfSrcUnitToMeter,
                              double dfDstUnitToMeter,
-                             int nBlockSize );
+                             int nBlockSize,
+                             size_t nGridBlockCacheSize );
         virtual ~GDALApplyVSGDataset();
 
         virtual int        CloseDependentDatasets() override;
@@ -85,7 +102,6 @@ class GDALApplyVSGRasterBand final: public GDALRasterBand
         friend class GDALApplyVSGDataset;
 
         float       *m_pafSrcData = nullptr;
-        float       *m_pafGridData = nullptr;
 
         CPL_DISALLOW_COPY_ASSIGN(GDALApplyVSGRasterBand)
 
@@ -104,20 +120,24 @@ class GDALApplyVSGRasterBand final: public GDALRasterBand
 /************************************************************************/
 
 GDALApplyVSGDataset::GDALApplyVSGDataset( GDALDataset* poSrcDataset,
-                                          GDALDataset* poReprojectedGrid,
+                                          GDALDataset* poGridDataset,
+                                          GDALWarpOperation* poGridWarper,
                                           GDALDataType eDT,
                                           bool bInverse,
                                           double dfSrcUnitToMeter,
                                           double dfDstUnitToMeter,
-                                          int nBlockSize ) :
+                                          int nBlockSize,
+                                          size_t nGridBlockCacheSize ) :
     m_poSrcDataset(poSrcDataset),
-    m_poReprojectedGrid(poReprojectedGrid),
+    m_poGridDataset(poGridDataset),
+    m_poGridWarper(poGridWarper),
     m_bInverse(bInverse),
     m_dfSrcUnitToMeter(dfSrcUnitToMeter),
-    m_dfDstUnitToMeter(dfDstUnitToMeter)
+    m_dfDstUnitToMeter(dfDstUnitToMeter),
+    m_oGridBlockCache(nGridBlockCacheSize, 0)
 {
     m_poSrcDataset->Reference();
-    m_poReprojectedGrid->Reference();
+    m_poGridDataset->Reference();
 
     nRasterXSize = poSrcDataset->GetRasterXSize();
     nRasterYSize = poSrcDataset->GetRasterYSize();
@@ -133,6 +153,53 @@ GDALApplyVSGDataset::~GDALApplyVSGDataset()
     GDALApplyVSGDataset::CloseDependentDatasets();
 }
 
+/************************************************************************/
+/*                            GetGridBlock()                            */
+/************************************************************************/
+
+GDALApplyVSGDataset::GridBlock
+GDALApplyVSGDataset::GetGridBlock( int nBlockXOff, int nBlockYOff,
+                                   int nBlockSize,
+                                   int nReqXSize, int nReqYSize )
+{
+    const int nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, nBlockSize);
+    const GIntBig nKey =
+        static_cast<GIntBig>(nBlockYOff) * nBlocksPerRow + nBlockXOff;
+    GridBlock poBlock;
+    if( m_oGridBlockCache.tryGet(nKey, poBlock) )
+        return poBlock;
+
+    if( m_poGridWarper == nullptr )
+        return nullptr;
+
+    float* pafWarped = static_cast<float*>(
+        m_poGridWarper->CreateDestinationBuffer(nReqXSize, nReqYSize));
+    if( pafWarped == nullptr )
+        return nullptr;
+    // The warp kernel itself is multi-threaded when NUM_THREADS was set
+    // in the warping options.
+    const CPLErr eErr = m_poGridWarper->WarpRegionToBuffer(
+        nBlockXOff * nBlockSize, nBlockYOff * nBlockSize,
+        nReqXSize, nReqYSize, pafWarped, GDT_Float32);
+    if( eErr == CE_None )
+    {
+        try
+        {
+            poBlock = std::make_shared<std::vector<float>>(
+                pafWarped, pafWarped + static_cast<size_t>(nReqXSize) * nReqYSize);
+            m_oGridBlockCache.insert(nKey, poBlock);
+        }
+        catch( const std::bad_alloc& )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate vertical shift grid block");
+            poBlock.reset();
+        }
+    }
+    m_poGridWarper->DestroyDestinationBuffer(pafWarped);
+    return poBlock;
+}
+
 /************************************************************************/
 /*                     CloseDependentDatasets()                         */
 /************************************************************************/
@@ -148,13 +215,20 @@ int GDALApplyVSGDataset::CloseDependentDatasets()
         }
         m_poSrcDataset = nullptr;
     }
-    if( m_poReprojectedGrid != nullptr )
+    m_oGridBlockCache.clear();
+    if( m_poGridWarper != nullptr )
     {
-        if( m_poReprojectedGrid->ReleaseRef() )
+        GDALDestroyTransformer(m_poGridWarper->GetOptions()->pTransformerArg);
+        delete m_poGridWarper;
+        m_poGridWarper = nullptr;
+    }
+    if( m_poGridDataset != nullptr )
+    {
+        if( m_poGridDataset->ReleaseRef() )
         {
             bRet = true;
         }
-        m_poReprojectedGrid = nullptr;
+        m_poGridDataset = nullptr;
     }
     return bRet;
 }
@@ -185,7 +259,7 @@ bool GDALApplyVSGDataset::IsInitOK()
 {
     GDALApplyVSGRasterBand* poBand =
         reinterpret_cast<GDALApplyVSGRasterBand*>(GetRasterBand(1));
-    return poBand->m_pafSrcData != nullptr && poBand->m_pafGridData != nullptr;
+    return poBand->m_pafSrcData != nullptr && m_poGridWarper != nullptr;
 }
 
 /************************************************************************/
@@ -200,8 +274,6 @@ GDALApplyVSGRasterBand::GDALApplyVSGRasterBand( GDALDataType eDT,
     nBlockYSize = nBlockSize;
     m_pafSrcData = static_cast<float*>(
         VSI_MALLOC3_VERBOSE(nBlockXSize, nBlockYSize, sizeof(float)));
-    m_pafGridData = static_cast<float*>(
-        VSI_MALLOC3_VERBOSE(nBlockXSize, nBlockYSize, sizeof(float)));
 }
 
 /************************************************************************/
@@ -211,7 +283,6 @@ GDALApplyVSGRasterBand::GDALApplyVSGRasterBand( GDALDataType eDT,
 GDALApplyVSGRasterBand::~GDALApplyVSGRasterBand()
 {
     VSIFree(m_pafSrcData);
-    VSIFree(m_pafGridData);
 }
 
 /************************************************************************/
@@ -250,18 +321,17 @@ CPLErr GDALApplyVSGRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
                                                     sizeof(float),
                                                     nBlockXSize * sizeof(float),
                                                     nullptr);
+    GDALApplyVSGDataset::GridBlock poGridBlock;
     if( eErr == CE_None )
-        eErr =  poGDS->m_poReprojectedGrid->GetRasterBand(1)->RasterIO(GF_Read,
-                                                    nXOff, nYOff,
-                                                    nReqXSize, nReqYSize,
-                                                    m_pafGridData,
-                                                    nReqXSize, nReqYSize,
-                                                    GDT_Float32,
-                                                    sizeof(float),
-                                                    nBlockXSize * sizeof(float),
-                                                    nullptr);
+    {
+        poGridBlock = poGDS->GetGridBlock(nBlockXOff, nBlockYOff, nBlockXSize,
+                                          nReqXSize, nReqYSize);
+        if( poGridBlock == nullptr )
+            eErr = CE_Failure;
+    }
     if( eErr == CE_None )
     {
+        const float* pafGridData = poGridBlock->data();
         const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
         int bHasNoData = FALSE;
         float fNoDataValue = static_cast<float>(GetNoDataValue(&bHasNoData));
@@ -270,7 +340,7 @@ CPLErr GDALApplyVSGRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
             for( int iX = 0; iX < nReqXSize; iX ++ )
             {
                 const float fSrcVal = m_pafSrcData[iY * nBlockXSize + iX];
-                const float fGridVal = m_pafGridData[iY * nBlockXSize + iX];
+                const float fGridVal = pafGridData[iY * nReqXSize + iX];
                 if( bHasNoData && fSrcVal == fNoDataValue )
                 {
                 }
@@ -364,6 +434,13 @@ CPLErr GDALApplyVSGRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
  * hGridDataset should cause I/O requests to fail. Default is NO (in which case
  * 0 will be used)
  * <li>SRC_SRS=srs_def. Override projection on hSrcDataset;
+ * <li>NUM_THREADS=val/ALL_CPUS. (GDAL &gt;= 3.4) Number of threads used to
+ * warp the grid to the source dataset. Defaults to the value of the
+ * GDAL_NUM_THREADS configuration option, or 1.
+ * <li>GRID_CACHE_SIZE=val. (GDAL &gt;= 3.4) Size in megabytes of the cache of
+ * blocks of the warped grid. This cache is independent from the GDAL block
+ * cache, so that the grid is not warped again when the blocks of a large
+ * source dataset are read several times. Defaults to 64.
  * </ul>
  *
  * @return a new dataset corresponding to hSrcDataset adjusted with
@@ -543,27 +620,48 @@ GDALDatasetH GDALApplyVerticalShiftGrid( GDALDatasetH hSrcDataset,
     psWO->panDstBands = static_cast<int *>(CPLMalloc(sizeof(int)));
     psWO->panDstBands[0] = 1;
 
-    VRTWarpedDataset* poReprojectedGrid =
-                new VRTWarpedDataset(nSrcXSize, nSrcYSize);
-    // This takes a reference on hGridDataset
-    CPLErr eErr = poReprojectedGrid->Initialize(psWO);
-    CPLAssert(eErr == CE_None);
-    CPL_IGNORE_RET_VAL(eErr);
+    const char* pszNumThreads = CSLFetchNameValueDef(
+        papszOptions, "NUM_THREADS",
+        CPLGetConfigOption("GDAL_NUM_THREADS", nullptr));
+    if( pszNumThreads )
+    {
+        psWO->papszWarpOptions = CSLSetNameValue(psWO->papszWarpOptions,
+                                                 "NUM_THREADS",
+                                                 pszNumThreads);
+    }
+
+    GDALWarpOperation* poGridWarper = new GDALWarpOperation();
+    if( poGridWarper->Initialize(psWO) != CE_None )
+    {
+        GDALDestroyTransformer(psWO->pTransformerArg);
+        GDALDestroyWarpOptions(psWO);
+        delete poGridWarper;
+        return nullptr;
+    }
     GDALDestroyWarpOptions(psWO);
-    poReprojectedGrid->SetGeoTransform(adfSrcGT);
-    poReprojectedGrid->AddBand(GDT_Float32, nullptr);
 
+    // Undocumented option. For testing only
+    const int nBlockSize = std::max(1,
+        atoi(CSLFetchNameValueDef(papszOptions, "BLOCKSIZE", "256")));
+    const GIntBig nGridCacheSize = static_cast<GIntBig>(
+        CPLAtof(CSLFetchNameValueDef(papszOptions, "GRID_CACHE_SIZE", "64")) *
+        1024 * 1024);
+    const size_t nGridCacheBlocks = static_cast<size_t>(std::max(
+        static_cast<GIntBig>(1),
+        nGridCacheSize / (static_cast<GIntBig>(nBlockSize) * nBlockSize *
+                          static_cast<int>(sizeof(float)))));
+
+    // This takes a reference on hGridDataset, and ownership of poGridWarper
     GDALApplyVSGDataset* poOutDS = new GDALApplyVSGDataset(
         reinterpret_cast<GDALDataset*>(hSrcDataset),
-        poReprojectedGrid,
+        reinterpret_cast<GDALDataset*>(hGridDataset),
+        poGridWarper,
         eDT,
         CPL_TO_BOOL(bInverse),
         dfSrcUnitToMeter,
         dfDstUnitToMeter,
-        // Undocumented option. For testing only
-        atoi(CSLFetchNameValueDef(papszOptions, "BLOCKSIZE", "256")) );
-
-    poReprojectedGrid->ReleaseRef();
+        nBlockSize,
+        nGridCacheBlocks );
 
     if( !poOutDS->IsInitOK() )
     {
@@ -0,0 +1,541 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Benchmark-based selection of resampling kernel variants and
+ *           chunk sizes, persisted in a per-machine cache file.
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gdal_alg.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_cpu_features.h"
+#include "cpl_error.h"
+#include "cpl_multiproc.h"
+#include "cpl_progress.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+#include "gdal_alg_priv.h"
+#include "gdal_priv.h"
+#include "gdalwarper.h"
+
+CPL_CVSID("$Id$")
+
+// Values read from the file pointed by GDAL_AUTOTUNE_FILE.
+static std::mutex goTunedValuesMutex;
+static bool gbTunedValuesLoaded = false;
+static CPLString gosTunedValuesFilename;
+static CPLStringList gaosTunedValues;
+
+/************************************************************************/
+/*                      GDALAutotuneGetCPUSignature()                   */
+/************************************************************************/
+
+// Identifies the processor model, so that a cache file shared between
+// heterogeneous machines (e.g. through a network home directory) is not
+// applied to a machine where it was not generated.
+static CPLString GDALAutotuneGetCPUSignature()
+{
+    CPLString osModel;
+#ifdef __linux
+    VSILFILE* fp = VSIFOpenL("/proc/cpuinfo", "rb");
+    if( fp )
+    {
+        CPLString osImplementer;
+        CPLString osPart;
+        const char* pszLine = nullptr;
+        while( (pszLine = CPLReadLineL(fp)) != nullptr )
+        {
+            const char* pszColon = strchr(pszLine, ':');
+            if( pszColon == nullptr )
+                continue;
+            CPLString osKey(pszLine, pszColon - pszLine);
+            osKey.Trim();
+            CPLString osValue(pszColon + 1);
+            osValue.Trim();
+            // x86
+            if( osModel.empty() && osKey == "model name" )
+                osModel = osValue;
+            // ARM
+            else if( osImplementer.empty() && osKey == "CPU implementer" )
+                osImplementer = osValue;
+            else if( osPart.empty() && osKey == "CPU part" )
+                osPart = osValue;
+        }
+        VSIFCloseL(fp);
+        if( osModel.empty() && !osImplementer.empty() )
+            osModel = "ARM implementer " + osImplementer + " part " + osPart;
+    }
+#endif
+    if( osModel.empty() )
+        osModel = "unknown";
+    osModel.Printf("%s, %d CPUs", osModel.c_str(), CPLGetNumCPUs());
+    return osModel;
+}
+
+/************************************************************************/
+/*                        GDALLoadTunedValues()                         */
+/************************************************************************/
+
+// Must be called with goTunedValuesMutex held.
+static void GDALLoadTunedValues( const char* pszFilename )
+{
+    gbTunedValuesLoaded = true;
+    gosTunedValuesFilename = pszFilename;
+    gaosTunedValues.Clear();
+
+    VSIStatBufL sStat;
+    if( VSIStatL(pszFilename, &sStat) != 0 )
+    {
+        CPLDebug("AUTOTUNE", "%s does not exist. Using default settings",
+                 pszFilename);
+        return;
+    }
+
+    CPLStringList aosValues(CSLLoad2(pszFilename, 1000, 1000, nullptr));
+    const char* pszCPU = aosValues.FetchNameValue("CPU");
+    const char* pszVersion = aosValues.FetchNameValue("GDAL_VERSION");
+    if( pszCPU == nullptr || GDALAutotuneGetCPUSignature() != pszCPU ||
+        pszVersion == nullptr ||
+        strcmp(pszVersion, GDALVersionInfo("RELEASE_NAME")) != 0 )
+    {
+        CPLDebug("AUTOTUNE",
+                 "%s was generated on another machine or GDAL version. "
+                 "Using default settings", pszFilename);
+        return;
+    }
+    gaosTunedValues = std::move(aosValues);
+}
+
+/************************************************************************/
+/*                      GDALGetTunedConfigOption()                      */
+/************************************************************************/
+
+// Returns the value of a configuration option if it is set, otherwise the
+// value selected by GDALAutotune() in the file pointed by GDAL_AUTOTUNE_FILE,
+// otherwise pszDefault (which may be an empty string).
+CPLString GDALGetTunedConfigOption( const char* pszKey,
+                                    const char* pszDefault )
+{
+    const char* pszValue = CPLGetConfigOption(pszKey, nullptr);
+    if( pszValue )
+        return pszValue;
+
+    const char* pszFilename = CPLGetConfigOption("GDAL_AUTOTUNE_FILE", nullptr);
+    if( pszFilename != nullptr && pszFilename[0] != '\0' )
+    {
+        std::lock_guard<std::mutex> oLock(goTunedValuesMutex);
+        if( !gbTunedValuesLoaded || gosTunedValuesFilename != pszFilename )
+            GDALLoadTunedValues(pszFilename);
+        pszValue = gaosTunedValues.FetchNameValue(pszKey);
+        if( pszValue )
+            return pszValue;
+    }
+    return pszDefault;
+}
+
+namespace
+{
+
+/************************************************************************/
+/*                         GlobalConfigOption                           */
+/************************************************************************/
+
+// Sets a configuration option globally (so that it is seen by worker
+// threads), and restores its previous value on destruction.
+class GlobalConfigOption
+{
+    CPLString m_osKey;
+    CPLString m_osOldValue{};
+    bool m_bHadOldValue = false;
+
+    CPL_DISALLOW_COPY_ASSIGN(GlobalConfigOption)
+
+  public:
+    GlobalConfigOption( const char* pszKey, const char* pszValue ):
+        m_osKey(pszKey)
+    {
+        const char* pszOldValue = CPLGetConfigOption(pszKey, nullptr);
+        if( pszOldValue )
+        {
+            m_bHadOldValue = true;
+            m_osOldValue = pszOldValue;
+        }
+        CPLSetConfigOption(pszKey, pszValue);
+    }
+
+    ~GlobalConfigOption()
+    {
+        CPLSetConfigOption(m_osKey,
+                           m_bHadOldValue ? m_osOldValue.c_str() : nullptr);
+    }
+};
+
+/************************************************************************/
+/*                           CreateMemRaster()                          */
+/************************************************************************/
+
+std::unique_ptr<GDALDataset> CreateMemRaster( int nXSize, int nYSize,
+                                              GDALDataType eDT,
+                                              bool bFill )
+{
+    GDALDriver* poMEMDriver =
+        GetGDALDriverManager()->GetDriverByName("MEM");
+    if( poMEMDriver == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "MEM driver not available");
+        return nullptr;
+    }
+    std::unique_ptr<GDALDataset> poDS(
+        poMEMDriver->Create("", nXSize, nYSize, 1, eDT, nullptr));
+    if( poDS && bFill )
+    {
+        // Smooth gradient with some high frequency content, so that no
+        // shortcut on constant areas kicks in.
+        std::vector<float> afLine(nXSize);
+        for( int iY = 0; iY < nYSize; ++iY )
+        {
+            for( int iX = 0; iX < nXSize; ++iX )
+            {
+                afLine[iX] = static_cast<float>(
+                    ((iX + iY) % 200) + ((iX * 7 + iY * 13) % 17));
+            }
+            if( poDS->GetRasterBand(1)->RasterIO(
+                    GF_Write, 0, iY, nXSize, 1, afLine.data(), nXSize, 1,
+                    GDT_Float32, 0, 0, nullptr) != CE_None )
+            {
+                return nullptr;
+            }
+        }
+    }
+    return poDS;
+}
+
+/************************************************************************/
+/*                             TimeCandidate()                          */
+/************************************************************************/
+
+// Runs pfnRun until dfMinTime seconds have elapsed (and at least twice),
+// and returns the duration of the fastest run, or -1 in case of error.
+template<class RunFunc> double TimeCandidate( RunFunc pfnRun,
+                                              double dfMinTime )
+{
+    double dfBest = std::numeric_limits<double>::max();
+    double dfTotal = 0;
+    int nRuns = 0;
+    while( nRuns < 2 || dfTotal < dfMinTime )
+    {
+        const auto start = std::chrono::steady_clock::now();
+        if( !pfnRun() )
+            return -1;
+        const double dfElapsed = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        dfBest = std::min(dfBest, dfElapsed);
+        dfTotal += dfElapsed;
+        ++nRuns;
+    }
+    return dfBest;
+}
+
+/************************************************************************/
+/*                              WarpOnce()                              */
+/************************************************************************/
+
+bool WarpOnce( GDALDataset* poSrcDS, GDALDataset* poDstDS,
+               GDALResampleAlg eResampleAlg, int nThreads )
+{
+    void* hTransformArg = GDALCreateGenImgProjTransformer2(
+        GDALDataset::ToHandle(poSrcDS), GDALDataset::ToHandle(poDstDS),
+        nullptr);
+    if( hTransformArg == nullptr )
+        return false;
+
+    GDALWarpOptions* psWO = GDALCreateWarpOptions();
+    psWO->hSrcDS = GDALDataset::ToHandle(poSrcDS);
+    psWO->hDstDS = GDALDataset::ToHandle(poDstDS);
+    psWO->nBandCount = 1;
+    psWO->panSrcBands = static_cast<int*>(CPLMalloc(sizeof(int)));
+    psWO->panSrcBands[0] = 1;
+    psWO->panDstBands = static_cast<int*>(CPLMalloc(sizeof(int)));
+    psWO->panDstBands[0] = 1;
+    psWO->eResampleAlg = eResampleAlg;
+    psWO->pfnTransformer = GDALGenImgProjTransform;
+    psWO->pTransformerArg = hTransformArg;
+    psWO->papszWarpOptions = CSLSetNameValue(psWO->papszWarpOptions,
+                                             "NUM_THREADS",
+                                             CPLSPrintf("%d", nThreads));
+
+    GDALWarpOperation oWO;
+    bool bRet = oWO.Initialize(psWO) == CE_None &&
+                oWO.ChunkAndWarpImage(0, 0, poDstDS->GetRasterXSize(),
+                                      poDstDS->GetRasterYSize()) == CE_None;
+
+    GDALDestroyGenImgProjTransformer(hTransformArg);
+    GDALDestroyWarpOptions(psWO);
+    return bRet;
+}
+
+/************************************************************************/
+/*                           SelectFastest()                            */
+/************************************************************************/
+
+// Times each candidate value of a configuration option, and returns the
+// fastest one, or an empty string in case of error.
+template<class RunFunc> CPLString SelectFastest(
+                    const char* pszKey,
+                    const std::vector<CPLString>& aosCandidates,
+                    RunFunc pfnRun, double dfMinTime,
+                    GDALProgressFunc pfnProgress, void* pProgressData )
+{
+    CPLString osBest;
+    double dfBestTime = std::numeric_limits<double>::max();
+    for( size_t i = 0; i < aosCandidates.size(); ++i )
+    {
+        double dfTime;
+        {
+            GlobalConfigOption oSetter(pszKey, aosCandidates[i]);
+            dfTime = TimeCandidate(pfnRun, dfMinTime);
+        }
+        if( dfTime < 0 )
+            return CPLString();
+        CPLDebug("AUTOTUNE", "%s=%s: %.4f s", pszKey,
+                 aosCandidates[i].c_str(), dfTime);
+        if( dfTime < dfBestTime )
+        {
+            dfBestTime = dfTime;
+            osBest = aosCandidates[i];
+        }
+        if( !pfnProgress(static_cast<double>(i + 1) / aosCandidates.size(),
+                         "", pProgressData) )
+        {
+            CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+            return CPLString();
+        }
+    }
+    return osBest;
+}
+
+} // namespace
+
+/************************************************************************/
+/*                            GDALAutotune()                            */
+/************************************************************************/
+
+/**
+ * \brief Benchmark resampling kernel variants and chunk sizes, and save the
+ * fastest choices for this machine.
+ *
+ * This function runs a set of short warping and overview computation
+ * benchmarks on in-memory rasters, and writes the settings that performed
+ * best in a text file. When the GDAL_AUTOTUNE_FILE configuration option
+ * points to that file, those settings are used at runtime instead of the
+ * built-in defaults. The file records the processor model and the GDAL
+ * version, and is ignored if any of them differs.
+ *
+ * The following settings are currently tuned:
+ * <ul>
+ * <li>GDAL_WARP_CUBIC_AVX2: whether the AVX2 implementation of cubic
+ * resampling is used by the warping kernel (only on CPUs with AVX2)</li>
+ * <li>WARP_THREAD_CHUNK_SIZE: number of target pixels per job of the
+ * multi-threaded warping kernel</li>
+ * <li>GDAL_OVR_CHUNKYSIZE: number of source lines processed at once when
+ * computing overviews</li>
+ * </ul>
+ * Explicitly set configuration options of the same name take precedence
+ * over the values of the file.
+ *
+ * Benchmarking takes from a few seconds to a minute depending on the
+ * machine and on MIN_TIME. It should be run once per machine (type), on an
+ * otherwise idle system.
+ *
+ * @param pszFilename Output file, or NULL to use the value of
+ * GDAL_AUTOTUNE_FILE.
+ * @param papszOptions NULL terminated list of options, or NULL. Supported
+ * options are SIZE=n, the width and height of the test rasters (1024 by
+ * default), and MIN_TIME=s, the minimum duration in seconds of the
+ * benchmark of each candidate (0.5 by default).
+ * @param pfnProgress Progress function, or NULL.
+ * @param pProgressData Argument of the progress function.
+ * @return CE_None in case of success.
+ * @since GDAL 3.4
+ */
+
+CPLErr GDALAutotune( const char* pszFilename, CSLConstList papszOptions,
+                     GDALProgressFunc pfnProgress, void* pProgressData )
+{
+    if( pszFilename == nullptr )
+        pszFilename = CPLGetConfigOption("GDAL_AUTOTUNE_FILE", nullptr);
+    if( pszFilename == nullptr || pszFilename[0] == '\0' )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "No output filename, and GDAL_AUTOTUNE_FILE is not set");
+        return CE_Failure;
+    }
+    if( pfnProgress == nullptr )
+        pfnProgress = GDALDummyProgress;
+
+    const int nSize = std::max(64, atoi(
+        CSLFetchNameValueDef(papszOptions, "SIZE", "1024")));
+    const double dfMinTime = CPLAtof(
+        CSLFetchNameValueDef(papszOptions, "MIN_TIME", "0.5"));
+
+    auto poSrcDS = CreateMemRaster(nSize, nSize, GDT_Byte, true);
+    auto poDstDS = CreateMemRaster(nSize, nSize, GDT_Byte, false);
+    auto poOvrDS = CreateMemRaster(nSize / 2, nSize / 2, GDT_Byte, false);
+    if( !poSrcDS || !poDstDS || !poOvrDS )
+        return CE_Failure;
+    // Source covers [0,nSize]x[-nSize,0]. The target is slightly scaled,
+    // rotated and shifted so that resampling is not a trivial copy.
+    double adfSrcGT[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, -1.0 };
+    poSrcDS->SetGeoTransform(adfSrcGT);
+    double adfDstGT[6] = { 3.3, 0.97, 0.02, -2.7, 0.01, -0.98 };
+    poDstDS->SetGeoTransform(adfDstGT);
+
+    const int nThreads = CPLGetNumCPUs();
+    CPLStringList aosResults;
+
+    // Do not let previous results interfere with the benchmarks
+    GlobalConfigOption oDisableCache("GDAL_AUTOTUNE_FILE", "");
+
+    bool bHasAVX2Choice = false;
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+    bHasAVX2Choice = CPLHaveRuntimeAVX2();
+#endif
+    const double dfAVX2Weight = bHasAVX2Choice ? 0.3 : 0.0;
+    const double dfChunkWeight = nThreads > 1 ? 0.4 : 0.0;
+    const double dfTotalWeight = dfAVX2Weight + dfChunkWeight + 0.3;
+    double dfProgressStart = 0;
+
+/* -------------------------------------------------------------------- */
+/*      Cubic warping kernel implementation.                            */
+/* -------------------------------------------------------------------- */
+    if( bHasAVX2Choice )
+    {
+        const double dfEnd = dfProgressStart + dfAVX2Weight / dfTotalWeight;
+        void* pScaledProgress = GDALCreateScaledProgress(
+            dfProgressStart, dfEnd, pfnProgress, pProgressData);
+        const CPLString osBest = SelectFastest(
+            "GDAL_WARP_CUBIC_AVX2", { "YES", "NO" },
+            [&poSrcDS, &poDstDS]()
+            { return WarpOnce(poSrcDS.get(), poDstDS.get(), GRA_Cubic, 1); },
+            dfMinTime, GDALScaledProgress, pScaledProgress);
+        GDALDestroyScaledProgress(pScaledProgress);
+        if( osBest.empty() )
+            return CE_Failure;
+        aosResults.SetNameValue("GDAL_WARP_CUBIC_AVX2", osBest);
+        dfProgressStart = dfEnd;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Job size of the multi-threaded warping kernel.                  */
+/* -------------------------------------------------------------------- */
+    if( nThreads > 1 )
+    {
+        const double dfEnd = dfProgressStart + dfChunkWeight / dfTotalWeight;
+        void* pScaledProgress = GDALCreateScaledProgress(
+            dfProgressStart, dfEnd, pfnProgress, pProgressData);
+        CPLString osBest;
+        {
+            // Apply the kernel selected above
+            GlobalConfigOption oSetter(
+                "GDAL_WARP_CUBIC_AVX2",
+                aosResults.FetchNameValueDef("GDAL_WARP_CUBIC_AVX2", "YES"));
+            osBest = SelectFastest(
+                "WARP_THREAD_CHUNK_SIZE",
+                { "16384", "65536", "262144", "1048576" },
+                [&poSrcDS, &poDstDS, nThreads]()
+                { return WarpOnce(poSrcDS.get(), poDstDS.get(), GRA_Cubic,
+                                  nThreads); },
+                dfMinTime, GDALScaledProgress, pScaledProgress);
+        }
+        GDALDestroyScaledProgress(pScaledProgress);
+        if( osBest.empty() )
+            return CE_Failure;
+        aosResults.SetNameValue("WARP_THREAD_CHUNK_SIZE", osBest);
+        dfProgressStart = dfEnd;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Number of source lines processed at once by overviews.          */
+/* -------------------------------------------------------------------- */
+    {
+        void* pScaledProgress = GDALCreateScaledProgress(
+            dfProgressStart, 1.0, pfnProgress, pProgressData);
+        GDALRasterBandH hSrcBand =
+            GDALRasterBand::ToHandle(poSrcDS->GetRasterBand(1));
+        GDALRasterBandH hOvrBand =
+            GDALRasterBand::ToHandle(poOvrDS->GetRasterBand(1));
+        const CPLString osBest = SelectFastest(
+            "GDAL_OVR_CHUNKYSIZE", { "32", "64", "128", "256" },
+            [hSrcBand, hOvrBand]() mutable
+            { return GDALRegenerateOverviews(hSrcBand, 1, &hOvrBand,
+                                             "CUBIC", nullptr,
+                                             nullptr) == CE_None; },
+            dfMinTime, GDALScaledProgress, pScaledProgress);
+        GDALDestroyScaledProgress(pScaledProgress);
+        if( osBest.empty() )
+            return CE_Failure;
+        aosResults.SetNameValue("GDAL_OVR_CHUNKYSIZE", osBest);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Write the results.                                              */
+/* -------------------------------------------------------------------- */
+    VSILFILE* fp = VSIFOpenL(pszFilename, "wb");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s", pszFilename);
+        return CE_Failure;
+    }
+    bool bOK = VSIFPrintfL(fp,
+        "# Generated by GDALAutotune(). Used when the GDAL_AUTOTUNE_FILE "
+        "configuration option\n"
+        "# points to this file. Delete it to restore default settings.\n") > 0;
+    bOK &= VSIFPrintfL(fp, "CPU=%s\n",
+                       GDALAutotuneGetCPUSignature().c_str()) > 0;
+    bOK &= VSIFPrintfL(fp, "GDAL_VERSION=%s\n",
+                       GDALVersionInfo("RELEASE_NAME")) > 0;
+    for( int i = 0; i < aosResults.size(); ++i )
+        bOK &= VSIFPrintfL(fp, "%s\n", aosResults[i]) > 0;
+    bOK &= VSIFCloseL(fp) == 0;
+    if( !bOK )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Error while writing %s",
+                 pszFilename);
+        return CE_Failure;
+    }
+
+    {
+        // Force reloading
+        std::lock_guard<std::mutex> oLock(goTunedValuesMutex);
+        gbTunedValuesLoaded = false;
+    }
+    return CE_None;
+}
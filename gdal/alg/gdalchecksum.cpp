@@ -30,79 +30,213 @@
 #include "cpl_port.h"
 #include "gdal_alg.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_sha256.h"
+#include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
+#include "gdal_thread_pool.h"
 
 
 CPL_CVSID("$Id$")
 
-/************************************************************************/
-/*                         GDALChecksumImage()                          */
-/************************************************************************/
+namespace {
 
-/**
- * Compute checksum for image region.
- *
- * Computes a 16bit (0-65535) checksum from a region of raster data on a GDAL
- * supported band.   Floating point data is converted to 32bit integer
- * so decimal portions of such raster data will not affect the checksum.
- * Real and Imaginary components of complex bands influence the result.
- *
- * @param hBand the raster band to read from.
- * @param nXOff pixel offset of window to read.
- * @param nYOff line offset of window to read.
- * @param nXSize pixel size of window to read.
- * @param nYSize line size of window to read.
- *
- * @return Checksum value.
- */
+// Windows are processed in tiles of fixed dimensions, relative to the
+// top-left corner of the window, so that the result does not depend on the
+// block organization of the band nor on the number of threads.
+constexpr int TILE_XSIZE = 1024;
+constexpr int TILE_YSIZE = 256;
 
-int CPL_STDCALL
-GDALChecksumImage( GDALRasterBandH hBand,
-                   int nXOff, int nYOff, int nXSize, int nYSize )
+// Maximum size of the buffer in which a row of tiles is read at once.
+constexpr size_t MAX_CHUNK_SIZE = 64 * 1024 * 1024;
 
+struct GDALImageTileJob
 {
-    VALIDATE_POINTER1( hBand, "GDALChecksumImage", 0 );
+    const GByte *pabyData = nullptr;   // Top-left pixel of the tile.
+    size_t       nLineStride = 0;      // In bytes.
+    int          nTileXOff = 0;        // Relative to the window.
+    int          nTileYOff = 0;
+    int          nTileXSize = 0;
+    int          nTileYSize = 0;
+    int          nWindowXSize = 0;
+    GDALDataType eDataType = GDT_Unknown;
 
-    const static int anPrimes[11] =
-        { 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43 };
+    int          nChecksum = 0;
+    GByte        abyHash[CPL_SHA256_HASH_SIZE] = {};
+};
 
-    int nChecksum = 0;
-    int iPrime = 0;
-    const GDALDataType eDataType = GDALGetRasterDataType(hBand);
-    const bool bComplex = CPL_TO_BOOL(GDALDataTypeIsComplex(eDataType));
+/************************************************************************/
+/*                          GetNumThreads()                             */
+/************************************************************************/
 
-    if( eDataType == GDT_Float32 || eDataType == GDT_Float64 ||
-        eDataType == GDT_CFloat32 || eDataType == GDT_CFloat64 )
-    {
-        const GDALDataType eDstDataType = bComplex ? GDT_CFloat64 : GDT_Float64;
+static int GetNumThreads( const char *pszNumThreads )
+{
+    if( pszNumThreads == nullptr )
+        pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                       atoi(pszNumThreads);
+    if( nThreads > 128 )
+        nThreads = 128;
+    return nThreads;
+}
 
-        double* padfLineData = static_cast<double *>(
-            VSI_MALLOC2_VERBOSE(nXSize,
-                                GDALGetDataTypeSizeBytes(eDstDataType)));
-        if( padfLineData == nullptr )
+/************************************************************************/
+/*                         ProcessImageTiles()                          */
+/*                                                                      */
+/*      Read the window by rows of tiles, in chunks of at most          */
+/*      MAX_CHUNK_SIZE bytes, and run pfnJobFunc on each tile. When     */
+/*      several threads are used, the tiles of a chunk are processed    */
+/*      by the worker threads while the next chunk is read in a         */
+/*      second buffer.                                                  */
+/************************************************************************/
+
+static bool ProcessImageTiles( GDALRasterBandH hBand,
+                               int nXOff, int nYOff, int nXSize, int nYSize,
+                               GDALDataType eBufType, int nThreads,
+                               CPLThreadFunc pfnJobFunc,
+                               std::vector<GDALImageTileJob>& asJobs )
+{
+    const int nTilesX = (nXSize + TILE_XSIZE - 1) / TILE_XSIZE;
+    const int nTilesY = (nYSize + TILE_YSIZE - 1) / TILE_YSIZE;
+    const int nDTSize = GDALGetDataTypeSizeBytes(eBufType);
+    const int nChunkYSize = std::min(nYSize, TILE_YSIZE);
+    const int nTilesPerChunk = std::max(1, std::min(nTilesX,
+        static_cast<int>(MAX_CHUNK_SIZE /
+            (static_cast<size_t>(TILE_XSIZE) * nChunkYSize * nDTSize))));
+    const size_t nBufferSize = static_cast<size_t>(
+        std::min(nXSize, nTilesPerChunk * TILE_XSIZE)) * nChunkYSize * nDTSize;
+
+    std::unique_ptr<CPLJobQueue> apoJobQueues[2];
+    if( nThreads > 1 && nTilesX * nTilesY > 1 )
+    {
+        CPLWorkerThreadPool *poThreadPool = GDALGetGlobalThreadPool(nThreads);
+        if( poThreadPool )
         {
-            return 0;
+            apoJobQueues[0] = poThreadPool->CreateJobQueue();
+            apoJobQueues[1] = poThreadPool->CreateJobQueue();
         }
+    }
+    const int nBuffers = apoJobQueues[0] ? 2 : 1;
 
-        for( int iLine = nYOff; iLine < nYOff + nYSize; iLine++ )
+    std::vector<GByte> aabyBuffers[2];
+    try
+    {
+        for( int i = 0; i < nBuffers; i++ )
+            aabyBuffers[i].resize(nBufferSize);
+        asJobs.resize(static_cast<size_t>(nTilesX) * nTilesY);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate working buffers");
+        return false;
+    }
+
+    bool bOK = true;
+    int iChunk = 0;
+    for( int iTileY = 0; bOK && iTileY < nTilesY; iTileY++ )
+    {
+        const int nTileYOff = iTileY * TILE_YSIZE;
+        const int nTileYSize = std::min(TILE_YSIZE, nYSize - nTileYOff);
+        for( int iTileX = 0; iTileX < nTilesX;
+             iTileX += nTilesPerChunk, iChunk++ )
         {
-            if( GDALRasterIO( hBand, GF_Read, nXOff, iLine, nXSize, 1,
-                              padfLineData, nXSize, 1,
-                              eDstDataType, 0, 0 ) != CE_None )
+            const int iBuffer = iChunk % nBuffers;
+            // Make sure the jobs still using this buffer are done.
+            if( apoJobQueues[iBuffer] )
+                apoJobQueues[iBuffer]->WaitCompletion();
+
+            const int nChunkXOff = iTileX * TILE_XSIZE;
+            const int nChunkXSize = std::min(nTilesPerChunk * TILE_XSIZE,
+                                             nXSize - nChunkXOff);
+            GByte *pabyBuffer = aabyBuffers[iBuffer].data();
+            if( GDALRasterIO(hBand, GF_Read,
+                             nXOff + nChunkXOff, nYOff + nTileYOff,
+                             nChunkXSize, nTileYSize,
+                             pabyBuffer, nChunkXSize, nTileYSize,
+                             eBufType, 0, 0) != CE_None )
             {
-                CPLError(CE_Failure, CPLE_FileIO,
-                         "Checksum value couldn't be computed due to "
-                         "I/O read error.");
+                bOK = false;
                 break;
             }
-            const int nCount = bComplex ? nXSize * 2 : nXSize;
 
+            const size_t nLineStride =
+                static_cast<size_t>(nChunkXSize) * nDTSize;
+            const int nLastTileX =
+                std::min(nTilesX, iTileX + nTilesPerChunk);
+            for( int i = iTileX; i < nLastTileX; i++ )
+            {
+                GDALImageTileJob& sJob =
+                    asJobs[static_cast<size_t>(iTileY) * nTilesX + i];
+                sJob.nTileXOff = i * TILE_XSIZE;
+                sJob.nTileYOff = nTileYOff;
+                sJob.nTileXSize = std::min(TILE_XSIZE,
+                                           nXSize - sJob.nTileXOff);
+                sJob.nTileYSize = nTileYSize;
+                sJob.nWindowXSize = nXSize;
+                sJob.eDataType = eBufType;
+                sJob.nLineStride = nLineStride;
+                sJob.pabyData = pabyBuffer +
+                    static_cast<size_t>(sJob.nTileXOff - nChunkXOff) * nDTSize;
+                if( apoJobQueues[iBuffer] )
+                    apoJobQueues[iBuffer]->SubmitJob(pfnJobFunc, &sJob);
+                else
+                    pfnJobFunc(&sJob);
+            }
+        }
+    }
+
+    for( int i = 0; i < nBuffers; i++ )
+    {
+        if( apoJobQueues[i] )
+            apoJobQueues[i]->WaitCompletion();
+    }
+
+    return bOK;
+}
+
+/************************************************************************/
+/*                          ChecksumJobFunc()                           */
+/************************************************************************/
+
+constexpr int anPrimes[11] = { 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43 };
+
+static void ChecksumJobFunc( void *pData )
+{
+    GDALImageTileJob *psJob = static_cast<GDALImageTileJob *>(pData);
+    const bool bComplex = CPL_TO_BOOL(GDALDataTypeIsComplex(psJob->eDataType));
+    const int nComponents = bComplex ? 2 : 1;
+    const int nCount = psJob->nTileXSize * nComponents;
+    const bool bFloat = psJob->eDataType == GDT_Float64 ||
+                        psJob->eDataType == GDT_CFloat64;
+
+    int nChecksum = 0;
+    for( int iLine = 0; iLine < psJob->nTileYSize; iLine++ )
+    {
+        // Index of the first value of the line within the window, as the
+        // prime used for each value cycles along the whole window.
+        const GUIntBig nFirstIdx =
+            (static_cast<GUIntBig>(psJob->nTileYOff + iLine) *
+                 psJob->nWindowXSize + psJob->nTileXOff) * nComponents;
+        int iPrime = static_cast<int>(nFirstIdx % 11);
+        const GByte *pabyLine = psJob->pabyData + iLine * psJob->nLineStride;
+
+        if( bFloat )
+        {
+            const double *padfLineData =
+                reinterpret_cast<const double *>(pabyLine);
             for( int i = 0; i < nCount; i++ )
             {
                 double dfVal = padfLineData[i];
@@ -135,46 +269,230 @@ GDALChecksumImage( GDALRasterBandH hBand,
                 nChecksum &= 0xffff;
             }
         }
+        else
+        {
+            const GInt32 *panLineData =
+                reinterpret_cast<const GInt32 *>(pabyLine);
+            for( int i = 0; i < nCount; i++ )
+            {
+                nChecksum += panLineData[i] % anPrimes[iPrime++];
+                if( iPrime > 10 )
+                    iPrime = 0;
 
-        CPLFree(padfLineData);
+                nChecksum &= 0xffff;
+            }
+        }
     }
-    else
-    {
-        const GDALDataType eDstDataType = bComplex ? GDT_CInt32 : GDT_Int32;
+    psJob->nChecksum = nChecksum;
+}
+
+/************************************************************************/
+/*                            HashJobFunc()                             */
+/************************************************************************/
+
+static void HashJobFunc( void *pData )
+{
+    GDALImageTileJob *psJob = static_cast<GDALImageTileJob *>(pData);
+    const GDALDataType eDataType = psJob->eDataType;
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
+    const bool bComplex = CPL_TO_BOOL(GDALDataTypeIsComplex(eDataType));
+    const int nWordSize = bComplex ? nDTSize / 2 : nDTSize;
+    const int nWords = psJob->nTileXSize * (bComplex ? 2 : 1);
+    const size_t nLineSize = static_cast<size_t>(psJob->nTileXSize) * nDTSize;
+    const bool bFloat = eDataType == GDT_Float32 || eDataType == GDT_Float64 ||
+                        eDataType == GDT_CFloat32 || eDataType == GDT_CFloat64;
+#ifdef CPL_MSB
+    const bool bCanonicalize = nWordSize > 1 || bFloat;
+#else
+    const bool bCanonicalize = bFloat;
+#endif
 
-        int *panLineData = static_cast<GInt32 *>(
-            VSI_MALLOC2_VERBOSE(nXSize,
-                                GDALGetDataTypeSizeBytes(eDstDataType)));
-        if( panLineData == nullptr )
+    std::vector<GByte> abyLine;
+    if( bCanonicalize )
+        abyLine.resize(nLineSize);
+
+    CPL_SHA256Context sContext;
+    CPL_SHA256Init(&sContext);
+    for( int iLine = 0; iLine < psJob->nTileYSize; iLine++ )
+    {
+        const GByte *pabyLine = psJob->pabyData + iLine * psJob->nLineStride;
+        if( !bCanonicalize )
         {
-            return 0;
+            CPL_SHA256Update(&sContext, pabyLine, nLineSize);
+            continue;
         }
 
-        for( int iLine = nYOff; iLine < nYOff + nYSize; iLine++ )
+        // Hash little-endian values, with a single NaN representation.
+        memcpy(abyLine.data(), pabyLine, nLineSize);
+        if( nWordSize == 4 && bFloat )
         {
-            if( GDALRasterIO( hBand, GF_Read, nXOff, iLine, nXSize, 1,
-                              panLineData, nXSize, 1, eDstDataType,
-                              0, 0 ) != CE_None )
+            float *pafLine = reinterpret_cast<float *>(abyLine.data());
+            for( int i = 0; i < nWords; i++ )
             {
-                CPLError(CE_Failure, CPLE_FileIO,
-                         "Checksum value could not be computed due to I/O "
-                         "read error.");
-                break;
+                if( CPLIsNan(pafLine[i]) )
+                    pafLine[i] = std::numeric_limits<float>::quiet_NaN();
             }
-            const int nCount = bComplex ? nXSize * 2 : nXSize;
-
-            for( int i = 0; i < nCount; i++ )
+        }
+        else if( bFloat )
+        {
+            double *padfLine = reinterpret_cast<double *>(abyLine.data());
+            for( int i = 0; i < nWords; i++ )
             {
-                nChecksum += panLineData[i] % anPrimes[iPrime++];
-                if( iPrime > 10 )
-                    iPrime = 0;
-
-                nChecksum &= 0xffff;
+                if( CPLIsNan(padfLine[i]) )
+                    padfLine[i] = std::numeric_limits<double>::quiet_NaN();
             }
         }
+#ifdef CPL_MSB
+        if( nWordSize > 1 )
+            GDALSwapWords(abyLine.data(), nWordSize, nWords, nWordSize);
+#endif
+        CPL_SHA256Update(&sContext, abyLine.data(), nLineSize);
+    }
+    CPL_SHA256Final(&sContext, psJob->abyHash);
+}
+
+} // namespace
+
+/************************************************************************/
+/*                         GDALChecksumImage()                          */
+/************************************************************************/
+
+/**
+ * Compute checksum for image region.
+ *
+ * Computes a 16bit (0-65535) checksum from a region of raster data on a GDAL
+ * supported band.   Floating point data is converted to 32bit integer
+ * so decimal portions of such raster data will not affect the checksum.
+ * Real and Imaginary components of complex bands influence the result.
+ *
+ * Starting with GDAL 3.4, the region is read by tiles, and the checksum of
+ * the tiles is computed by the number of threads specified by the
+ * GDAL_NUM_THREADS configuration option (1 by default). The result does not
+ * depend on the number of threads.
+ *
+ * @param hBand the raster band to read from.
+ * @param nXOff pixel offset of window to read.
+ * @param nYOff line offset of window to read.
+ * @param nXSize pixel size of window to read.
+ * @param nYSize line size of window to read.
+ *
+ * @return Checksum value.
+ */
 
-        CPLFree( panLineData );
+int CPL_STDCALL
+GDALChecksumImage( GDALRasterBandH hBand,
+                   int nXOff, int nYOff, int nXSize, int nYSize )
+
+{
+    VALIDATE_POINTER1( hBand, "GDALChecksumImage", 0 );
+
+    if( nXSize <= 0 || nYSize <= 0 )
+        return 0;
+
+    const GDALDataType eDataType = GDALGetRasterDataType(hBand);
+    const bool bComplex = CPL_TO_BOOL(GDALDataTypeIsComplex(eDataType));
+    GDALDataType eBufType;
+    if( eDataType == GDT_Float32 || eDataType == GDT_Float64 ||
+        eDataType == GDT_CFloat32 || eDataType == GDT_CFloat64 )
+        eBufType = bComplex ? GDT_CFloat64 : GDT_Float64;
+    else
+        eBufType = bComplex ? GDT_CInt32 : GDT_Int32;
+
+    std::vector<GDALImageTileJob> asJobs;
+    if( !ProcessImageTiles(hBand, nXOff, nYOff, nXSize, nYSize, eBufType,
+                           GetNumThreads(nullptr), ChecksumJobFunc, asJobs) )
+    {
+        if( asJobs.empty() )
+            return 0;
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "Checksum value could not be computed due to I/O "
+                 "read error.");
     }
 
+    // Tiles that could not be read have a zero checksum.
+    int nChecksum = 0;
+    for( const auto& sJob : asJobs )
+        nChecksum = (nChecksum + sJob.nChecksum) & 0xffff;
+
     return nChecksum;
 }
+
+/************************************************************************/
+/*                           GDALHashImage()                            */
+/************************************************************************/
+
+/**
+ * Compute a SHA-256 hash of an image region.
+ *
+ * Unlike GDALChecksumImage(), all the bits of the values are taken into
+ * account. The hash is computed on the values in their native data type,
+ * in little-endian order, with all NaN values considered identical. It does
+ * not depend on the block organization of the band, so identical content
+ * stored in different formats or layouts gives the same hash.
+ *
+ * The region is split in tiles of fixed dimensions, whose SHA-256 digests
+ * are computed concurrently, and the returned hash is the SHA-256 digest of
+ * the data type, the window dimensions and of the tile digests in row-major
+ * order. It is thus not the SHA-256 digest of the raw image content.
+ *
+ * Options are:
+ * <ul>
+ * <li>NUM_THREADS=number_of_threads/ALL_CPUS: Number of threads used to
+ * hash the tiles. The region is still read by the calling thread.
+ * Defaults to the value of the GDAL_NUM_THREADS configuration option,
+ * or 1.</li>
+ * </ul>
+ *
+ * @param hBand the raster band to read from.
+ * @param nXOff pixel offset of window to read.
+ * @param nYOff line offset of window to read.
+ * @param nXSize pixel size of window to read.
+ * @param nYSize line size of window to read.
+ * @param papszOptions NULL terminated list of options, or NULL.
+ *
+ * @return hexadecimal hash to free with CPLFree(), or NULL in case of error.
+ * @since GDAL 3.4
+ */
+
+char *GDALHashImage( GDALRasterBandH hBand,
+                     int nXOff, int nYOff, int nXSize, int nYSize,
+                     CSLConstList papszOptions )
+
+{
+    VALIDATE_POINTER1( hBand, "GDALHashImage", nullptr );
+
+    if( nXSize <= 0 || nYSize <= 0 )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg, "Invalid window size");
+        return nullptr;
+    }
+
+    const GDALDataType eDataType = GDALGetRasterDataType(hBand);
+    std::vector<GDALImageTileJob> asJobs;
+    if( !ProcessImageTiles(hBand, nXOff, nYOff, nXSize, nYSize, eDataType,
+                           GetNumThreads(CSLFetchNameValue(papszOptions,
+                                                           "NUM_THREADS")),
+                           HashJobFunc, asJobs) )
+    {
+        return nullptr;
+    }
+
+    CPL_SHA256Context sContext;
+    CPL_SHA256Init(&sContext);
+    const char *pszDataType = GDALGetDataTypeName(eDataType);
+    CPL_SHA256Update(&sContext, pszDataType, strlen(pszDataType) + 1);
+    for( GUInt32 nVal : { static_cast<GUInt32>(nXSize),
+                          static_cast<GUInt32>(nYSize),
+                          static_cast<GUInt32>(TILE_XSIZE),
+                          static_cast<GUInt32>(TILE_YSIZE) } )
+    {
+        CPL_LSBPTR32(&nVal);
+        CPL_SHA256Update(&sContext, &nVal, sizeof(nVal));
+    }
+    for( const auto& sJob : asJobs )
+        CPL_SHA256Update(&sContext, sJob.abyHash, sizeof(sJob.abyHash));
+    GByte abyHash[CPL_SHA256_HASH_SIZE];
+    CPL_SHA256Final(&sContext, abyHash);
+
+    return CPLBinaryToHex(CPL_SHA256_HASH_SIZE, abyHash);
+}
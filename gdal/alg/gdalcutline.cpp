@@ -34,6 +34,7 @@
 #include <cstdio>
 #include <cstring>
 #include <algorithm>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -354,11 +355,40 @@ GDALWarpCutlineMasker( void *pMaskFuncArg,
     double adfGeoTransform[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
     GDALSetGeoTransform( hMemDS, adfGeoTransform );
 
+/* -------------------------------------------------------------------- */
+/*      Only burn the polygons of a multipolygon cutline that           */
+/*      intersect the chunk, since the rasterization cost grows with    */
+/*      the number of edges, wherever they are.                         */
+/* -------------------------------------------------------------------- */
+    std::vector<OGRGeometryH> ahPolygonsToBurn;
+    if( wkbFlatten(OGR_G_GetGeometryType(hPolygon)) == wkbMultiPolygon )
+    {
+        const OGRMultiPolygon* poMP =
+            OGRGeometry::FromHandle(hPolygon)->toMultiPolygon();
+        for( const auto* poPart: *poMP )
+        {
+            OGREnvelope sPartEnvelope;
+            poPart->getEnvelope(&sPartEnvelope);
+            if( sPartEnvelope.MaxX >= nXOff &&
+                sPartEnvelope.MinX <= nXOff + nXSize &&
+                sPartEnvelope.MaxY >= nYOff &&
+                sPartEnvelope.MinY <= nYOff + nYSize )
+            {
+                ahPolygonsToBurn.push_back(OGRGeometry::ToHandle(
+                    const_cast<OGRPolygon*>(poPart)));
+            }
+        }
+    }
+    else
+    {
+        ahPolygonsToBurn.push_back(hPolygon);
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Burn the polygon into the mask with 1.0 values.                 */
 /* -------------------------------------------------------------------- */
     int nTargetBand = 1;
-    double dfBurnValue = 255.0;
+    std::vector<double> adfBurnValues(ahPolygonsToBurn.size(), 255.0);
     char **papszRasterizeOptions = nullptr;
 
     if( CPLFetchBool( psWO->papszWarpOptions, "CUTLINE_ALL_TOUCHED", false ))
@@ -367,12 +397,18 @@ GDALWarpCutlineMasker( void *pMaskFuncArg,
 
     int anXYOff[2] = { nXOff, nYOff };
 
-    CPLErr eErr =
-        GDALRasterizeGeometries( hMemDS, 1, &nTargetBand,
-                                 1, &hPolygon,
-                                 CutlineTransformer, anXYOff,
-                                 &dfBurnValue, papszRasterizeOptions,
-                                 nullptr, nullptr );
+    CPLErr eErr = CE_None;
+    if( !ahPolygonsToBurn.empty() )
+    {
+        eErr =
+            GDALRasterizeGeometries( hMemDS, 1, &nTargetBand,
+                                     static_cast<int>(ahPolygonsToBurn.size()),
+                                     ahPolygonsToBurn.data(),
+                                     CutlineTransformer, anXYOff,
+                                     adfBurnValues.data(),
+                                     papszRasterizeOptions,
+                                     nullptr, nullptr );
+    }
 
     CSLDestroy( papszRasterizeOptions );
 
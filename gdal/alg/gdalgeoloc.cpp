@@ -40,10 +40,19 @@
 
 #include <algorithm>
 #include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_minixml.h"
+#include "cpl_multiproc.h"
+#include "cpl_quad_tree.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
@@ -222,110 +231,187 @@ static bool GeoLocLoadFullData( GDALGeoLocTransformInfo *psTransform )
 }
 
 /************************************************************************/
-/*                       GeoLocGenerateBackMap()                        */
+/*                        GeoLocGetNumThreads()                         */
 /************************************************************************/
 
-static bool GeoLocGenerateBackMap( GDALGeoLocTransformInfo *psTransform )
+static int GeoLocGetNumThreads()
+{
+    const char* pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    const int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                            CPLGetNumCPUs() : atoi(pszNumThreads);
+    return std::max(1, std::min(128, nThreads));
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                         GDALGeoLocBlockIndex                         */
+/* ==================================================================== */
+/************************************************************************/
+
+// Spatial index of the extents, in georeferenced coordinates, of blocks of
+// the geolocation arrays. It is used to find the source pixels that may
+// project into a region of the backmap without scanning the whole arrays.
+
+constexpr size_t GEOLOC_BLOCK_SIZE = 64;
+
+class GDALGeoLocBlockIndex
+{
+        size_t                  m_nBlocksX = 0;
+        size_t                  m_nBlocksY = 0;
+        std::vector<CPLRectObj> m_asExtents{};
+        CPLQuadTree            *m_hQuadTree = nullptr;
+
+        GDALGeoLocBlockIndex(const GDALGeoLocBlockIndex&) = delete;
+        GDALGeoLocBlockIndex& operator=(const GDALGeoLocBlockIndex&) = delete;
+
+    public:
+        GDALGeoLocBlockIndex() = default;
+        ~GDALGeoLocBlockIndex();
+
+        void Build( const GDALGeoLocTransformInfo *psTransform );
+
+        size_t GetBlocksX() const { return m_nBlocksX; }
+
+        std::vector<bool> Select( double dfMinX, double dfMinY,
+                                  double dfMaxX, double dfMaxY ) const;
+};
+
+GDALGeoLocBlockIndex::~GDALGeoLocBlockIndex()
+{
+    if( m_hQuadTree )
+        CPLQuadTreeDestroy(m_hQuadTree);
+}
 
+void GDALGeoLocBlockIndex::Build( const GDALGeoLocTransformInfo *psTransform )
 {
     const size_t nXSize = psTransform->nGeoLocXSize;
     const size_t nYSize = psTransform->nGeoLocYSize;
+    m_nBlocksX = (nXSize + GEOLOC_BLOCK_SIZE - 1) / GEOLOC_BLOCK_SIZE;
+    m_nBlocksY = (nYSize + GEOLOC_BLOCK_SIZE - 1) / GEOLOC_BLOCK_SIZE;
 
-/* -------------------------------------------------------------------- */
-/*      Decide on resolution for backmap.  We aim for slightly          */
-/*      higher resolution than the source but we can't easily           */
-/*      establish how much dead space there is in the backmap, so it    */
-/*      is approximate.                                                 */
-/* -------------------------------------------------------------------- */
-    const double dfTargetPixels = (static_cast<double>(nXSize) * nYSize * OVERSAMPLE_FACTOR);
-    const double dfPixelSize = sqrt(
-        (psTransform->dfMaxX - psTransform->dfMinX) *
-        (psTransform->dfMaxY - psTransform->dfMinY) / dfTargetPixels);
-    if( dfPixelSize == 0.0 )
+    CPLRectObj sEmpty;
+    sEmpty.minx = std::numeric_limits<double>::max();
+    sEmpty.miny = std::numeric_limits<double>::max();
+    sEmpty.maxx = -std::numeric_limits<double>::max();
+    sEmpty.maxy = -std::numeric_limits<double>::max();
+    m_asExtents.assign(m_nBlocksX * m_nBlocksY, sEmpty);
+
+    for( size_t iY = 0; iY < nYSize; iY++ )
     {
-        CPLError(CE_Failure, CPLE_AppDefined, "Invalid pixel size for backmap");
-        return false;
+        CPLRectObj* const psBlockRow =
+            &m_asExtents[(iY / GEOLOC_BLOCK_SIZE) * m_nBlocksX];
+        for( size_t iX = 0; iX < nXSize; iX++ )
+        {
+            const double dfX = psTransform->padfGeoLocX[iX + iY * nXSize];
+            if( psTransform->bHasNoData && dfX == psTransform->dfNoDataX )
+                continue;
+            const double dfY = psTransform->padfGeoLocY[iX + iY * nXSize];
+            CPLRectObj& sExtent = psBlockRow[iX / GEOLOC_BLOCK_SIZE];
+            sExtent.minx = std::min(sExtent.minx, dfX);
+            sExtent.miny = std::min(sExtent.miny, dfY);
+            sExtent.maxx = std::max(sExtent.maxx, dfX);
+            sExtent.maxy = std::max(sExtent.maxy, dfY);
+        }
     }
 
-    const double dfBMXSize = (psTransform->dfMaxX - psTransform->dfMinX) / dfPixelSize + 1;
-    const double dfBMYSize = (psTransform->dfMaxY - psTransform->dfMinY) / dfPixelSize + 1;
-
-    if( !(dfBMXSize > 0 && dfBMXSize < INT_MAX) ||
-        !(dfBMYSize > 0 && dfBMYSize < INT_MAX) )
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = psTransform->dfMinX;
+    sGlobalBounds.miny = psTransform->dfMinY;
+    sGlobalBounds.maxx = psTransform->dfMaxX;
+    sGlobalBounds.maxy = psTransform->dfMaxY;
+    m_hQuadTree = CPLQuadTreeCreate(&sGlobalBounds, nullptr);
+    for( size_t i = 0; i < m_asExtents.size(); i++ )
     {
-        CPLError(CE_Failure, CPLE_AppDefined, "Int overflow : %f x %f",
-                 dfBMXSize, dfBMYSize);
-        return false;
+        if( m_asExtents[i].minx <= m_asExtents[i].maxx )
+        {
+            // Store i + 1 so that no feature is a null pointer
+            CPLQuadTreeInsertWithBounds(
+                m_hQuadTree, reinterpret_cast<void*>(i + 1), &m_asExtents[i]);
+        }
     }
+}
 
-    const size_t nBMXSize = static_cast<size_t>(dfBMXSize);
-    const size_t nBMYSize = static_cast<size_t>(dfBMYSize);
-
-    if( nBMYSize > std::numeric_limits<size_t>::max() / nBMXSize )
+std::vector<bool> GDALGeoLocBlockIndex::Select( double dfMinX, double dfMinY,
+                                                double dfMaxX,
+                                                double dfMaxY ) const
+{
+    std::vector<bool> abSelected(m_asExtents.size());
+    CPLRectObj sAoi;
+    sAoi.minx = dfMinX;
+    sAoi.miny = dfMinY;
+    sAoi.maxx = dfMaxX;
+    sAoi.maxy = dfMaxY;
+    int nFeatureCount = 0;
+    void** pahFeatures = CPLQuadTreeSearch(m_hQuadTree, &sAoi, &nFeatureCount);
+    for( int i = 0; i < nFeatureCount; i++ )
     {
-        CPLError(CE_Failure, CPLE_AppDefined, "Int overflow : %f x %f",
-                 dfBMXSize, dfBMYSize);
-        return false;
+        abSelected[reinterpret_cast<size_t>(pahFeatures[i]) - 1] = true;
     }
+    CPLFree(pahFeatures);
+    return abSelected;
+}
 
-    psTransform->nBackMapWidth = nBMXSize;
-    psTransform->nBackMapHeight = nBMYSize;
+/************************************************************************/
+/*                      GeoLocBuildBackMapRegion()                      */
+/************************************************************************/
 
-    const double dfMinX = psTransform->dfMinX - dfPixelSize / 2.0;
-    const double dfMaxY = psTransform->dfMaxY + dfPixelSize / 2.0;
+// Compute the backmap values of a rectangular region of the backmap, whose
+// dimensions and georeferencing have been set in psTransform.
+// If poIndex is not null, only the source pixels of the blocks that may
+// project into the region are considered. With several threads, each one
+// processes a range of rows of the region, in the same order as a single
+// thread would, so the result does not depend on the number of threads.
 
-    psTransform->adfBackMapGeoTransform[0] = dfMinX;
-    psTransform->adfBackMapGeoTransform[1] = dfPixelSize;
-    psTransform->adfBackMapGeoTransform[2] = 0.0;
-    psTransform->adfBackMapGeoTransform[3] = dfMaxY;
-    psTransform->adfBackMapGeoTransform[4] = 0.0;
-    psTransform->adfBackMapGeoTransform[5] = -dfPixelSize;
+static bool GeoLocBuildBackMapRegion( const GDALGeoLocTransformInfo *psTransform,
+                                      const GDALGeoLocBlockIndex *poIndex,
+                                      size_t nRegionX, size_t nRegionY,
+                                      size_t nRegionWidth, size_t nRegionHeight,
+                                      int nThreads,
+                                      float *pafBackMapX, float *pafBackMapY )
+
+{
+    const size_t nXSize = psTransform->nGeoLocXSize;
+    const size_t nYSize = psTransform->nGeoLocYSize;
+    const double dfMinX = psTransform->adfBackMapGeoTransform[0];
+    const double dfMaxY = psTransform->adfBackMapGeoTransform[3];
+    const double dfPixelSize = psTransform->adfBackMapGeoTransform[1];
 
 /* -------------------------------------------------------------------- */
-/*      Allocate backmap, and initialize to nodata value (-1.0).        */
+/*      Initialize backmap to zero, with zero weights.                  */
 /* -------------------------------------------------------------------- */
-    psTransform->pafBackMapX = static_cast<float *>(
-        VSI_MALLOC3_VERBOSE(nBMXSize, nBMYSize, sizeof(float)));
-    psTransform->pafBackMapY = static_cast<float *>(
-        VSI_MALLOC3_VERBOSE(nBMXSize, nBMYSize, sizeof(float)));
-
     float *wgtsBackMap = static_cast<float *>(
-        VSI_MALLOC3_VERBOSE(nBMXSize, nBMYSize, sizeof(float)));
-
-    if( psTransform->pafBackMapX == nullptr ||
-        psTransform->pafBackMapY == nullptr ||
-        wgtsBackMap == nullptr)
-    {
-        CPLFree( wgtsBackMap );
+        VSI_MALLOC3_VERBOSE(nRegionWidth, nRegionHeight, sizeof(float)));
+    if( wgtsBackMap == nullptr )
         return false;
-    }
 
-    const size_t nBMXYCount = nBMXSize * nBMYSize;
+    const size_t nBMXYCount = nRegionWidth * nRegionHeight;
     for( size_t i = 0; i < nBMXYCount; i++ )
     {
-        psTransform->pafBackMapX[i] = 0;
-        psTransform->pafBackMapY[i] = 0;
+        pafBackMapX[i] = 0;
+        pafBackMapY[i] = 0;
         wgtsBackMap[i] = 0.0;
     }
 
 /* -------------------------------------------------------------------- */
-/*      Run through the whole geoloc array forward projecting and       */
-/*      pushing into the backmap.                                       */
+/*      Run through the geoloc array forward projecting and             */
+/*      pushing into the rows [nRowStart, nRowEnd[ of the region.       */
 /* -------------------------------------------------------------------- */
+    const std::ptrdiff_t nBMXSize = static_cast<std::ptrdiff_t>(nRegionWidth);
 
     const auto UpdateBackmap = [&](std::ptrdiff_t iBMX, std::ptrdiff_t iBMY,
                                    size_t iX, size_t iY,
                                    double tempwt)
     {
-        const float fUpdatedBMX = psTransform->pafBackMapX[iBMX + iBMY * nBMXSize] +
+        const size_t iBM = iBMX + iBMY * nBMXSize;
+        const float fUpdatedBMX = pafBackMapX[iBM] +
             static_cast<float>( tempwt * (
                 (iX + FSHIFT) * psTransform->dfPIXEL_STEP +
                 psTransform->dfPIXEL_OFFSET));
-        const float fUpdatedBMY = psTransform->pafBackMapY[iBMX + iBMY * nBMXSize] +
+        const float fUpdatedBMY = pafBackMapY[iBM] +
             static_cast<float>( tempwt * (
                 (iY + FSHIFT) * psTransform->dfLINE_STEP +
                 psTransform->dfLINE_OFFSET));
-        const float fUpdatedWeight = wgtsBackMap[iBMX + iBMY * nBMXSize] +
+        const float fUpdatedWeight = wgtsBackMap[iBM] +
                                static_cast<float>(tempwt);
 
         // Only update the backmap if the updated averaged value results in a
@@ -350,82 +436,135 @@ static bool GeoLocGenerateBackMap( GDALGeoLocTransformInfo *psTransform )
                 fabs(dfGLX - psTransform->padfGeoLocX[iX + iY * nXSize]) <= 2 * dfPixelSize &&
                 fabs(dfGLY - psTransform->padfGeoLocY[iX + iY * nXSize]) <= 2 * dfPixelSize )
             {
-                psTransform->pafBackMapX[iBMX + iBMY * nBMXSize] = fUpdatedBMX;
-                psTransform->pafBackMapY[iBMX + iBMY * nBMXSize] = fUpdatedBMY;
-                wgtsBackMap[iBMX + iBMY * nBMXSize] = fUpdatedWeight;
+                pafBackMapX[iBM] = fUpdatedBMX;
+                pafBackMapY[iBM] = fUpdatedBMY;
+                wgtsBackMap[iBM] = fUpdatedWeight;
             }
         }
     };
 
-    for( size_t iY = 0; iY < nYSize; iY++ )
+    const auto Scatter = [&](std::ptrdiff_t nRowStart, std::ptrdiff_t nRowEnd)
     {
-        for( size_t iX = 0; iX < nXSize; iX++ )
+        std::vector<bool> abSelectedBlocks;
+        size_t nBlocksX = 0;
+        if( poIndex )
         {
-            if( psTransform->bHasNoData &&
-                psTransform->padfGeoLocX[iX + iY * nXSize]
-                == psTransform->dfNoDataX )
-                continue;
+            // Source pixels contribute to the 4 backmap pixels around them
+            abSelectedBlocks = poIndex->Select(
+                dfMinX + (static_cast<double>(nRegionX) - 2) * dfPixelSize,
+                dfMaxY - (static_cast<double>(nRegionY + nRowEnd) + 2) * dfPixelSize,
+                dfMinX + (static_cast<double>(nRegionX + nRegionWidth) + 2) * dfPixelSize,
+                dfMaxY - (static_cast<double>(nRegionY + nRowStart) - 2) * dfPixelSize);
+            nBlocksX = poIndex->GetBlocksX();
+        }
 
-            const size_t i = iX + iY * nXSize;
+        for( size_t iY = 0; iY < nYSize; iY++ )
+        {
+            for( size_t iX = 0; iX < nXSize; iX++ )
+            {
+                if( poIndex &&
+                    !abSelectedBlocks[(iY / GEOLOC_BLOCK_SIZE) * nBlocksX +
+                                      iX / GEOLOC_BLOCK_SIZE] )
+                {
+                    // Skip to the next block
+                    iX = (iX / GEOLOC_BLOCK_SIZE + 1) * GEOLOC_BLOCK_SIZE - 1;
+                    continue;
+                }
 
-            const double dBMX = static_cast<double>(
-                    (psTransform->padfGeoLocX[i] - dfMinX) / dfPixelSize) - FSHIFT;
+                if( psTransform->bHasNoData &&
+                    psTransform->padfGeoLocX[iX + iY * nXSize]
+                    == psTransform->dfNoDataX )
+                    continue;
 
-            const double dBMY = static_cast<double>(
-                (dfMaxY - psTransform->padfGeoLocY[i]) / dfPixelSize) - FSHIFT;
+                const size_t i = iX + iY * nXSize;
 
+                const double dBMX = static_cast<double>(
+                        (psTransform->padfGeoLocX[i] - dfMinX) / dfPixelSize) - FSHIFT;
 
-            //Get top left index by truncation
-            const std::ptrdiff_t iBMX = static_cast<std::ptrdiff_t>(dBMX);
-            const std::ptrdiff_t iBMY = static_cast<std::ptrdiff_t>(dBMY);
-            const double fracBMX = dBMX - iBMX;
-            const double fracBMY = dBMY - iBMY;
+                const double dBMY = static_cast<double>(
+                    (dfMaxY - psTransform->padfGeoLocY[i]) / dfPixelSize) - FSHIFT;
 
-            //Check if the center is in range
-            if( iBMX < -1 || iBMY < -1 ||
-                (iBMX > 0 && static_cast<size_t>(iBMX) > nBMXSize) ||
-                (iBMY > 0 && static_cast<size_t>(iBMY) > nBMYSize) )
-                continue;
 
-            //Check logic for top left pixel
-            if ((iBMX >= 0) && (iBMY >= 0) &&
-                (static_cast<size_t>(iBMX) < nBMXSize) &&
-                (static_cast<size_t>(iBMY) < nBMYSize))
-            {
-                const double tempwt = (1.0 - fracBMX) * (1.0 - fracBMY);
-                UpdateBackmap(iBMX, iBMY, iX, iY, tempwt);
-            }
+                //Get top left index by truncation
+                const std::ptrdiff_t iBMXGlobal = static_cast<std::ptrdiff_t>(dBMX);
+                const std::ptrdiff_t iBMYGlobal = static_cast<std::ptrdiff_t>(dBMY);
+                const double fracBMX = dBMX - iBMXGlobal;
+                const double fracBMY = dBMY - iBMYGlobal;
 
-            //Check logic for top right pixel
-            if ((iBMY >= 0) &&
-                (static_cast<size_t>(iBMX+1) < nBMXSize) &&
-                (static_cast<size_t>(iBMY) < nBMYSize))
-            {
-                const double tempwt = fracBMX * (1.0 - fracBMY);
-                UpdateBackmap(iBMX + 1, iBMY, iX, iY, tempwt);
-            }
+                // Indices in the region
+                const std::ptrdiff_t iBMX =
+                    iBMXGlobal - static_cast<std::ptrdiff_t>(nRegionX);
+                const std::ptrdiff_t iBMY =
+                    iBMYGlobal - static_cast<std::ptrdiff_t>(nRegionY);
 
-            //Check logic for bottom right pixel
-            if ((static_cast<size_t>(iBMX+1) < nBMXSize) &&
-                (static_cast<size_t>(iBMY+1) < nBMYSize))
-            {
-                const double tempwt = fracBMX * fracBMY;
-                UpdateBackmap(iBMX + 1, iBMY + 1, iX, iY, tempwt);
-            }
+                //Check if the center is in range
+                if( iBMX < -1 || iBMY < nRowStart - 1 ||
+                    iBMX > nBMXSize || iBMY > nRowEnd )
+                    continue;
 
-            //Check logic for bottom left pixel
-            if ((iBMX >= 0) &&
-                (static_cast<size_t>(iBMX) < nBMXSize) &&
-                (static_cast<size_t>(iBMY+1) < nBMYSize))
-            {
-                const double tempwt = (1.0 - fracBMX) * fracBMY;
-                UpdateBackmap(iBMX, iBMY + 1, iX, iY, tempwt);
+                const bool bTopRowInRange = iBMY >= nRowStart && iBMY < nRowEnd;
+                const bool bBottomRowInRange =
+                    iBMY + 1 >= nRowStart && iBMY + 1 < nRowEnd;
+
+                //Check logic for top left pixel
+                if( iBMX >= 0 && iBMX < nBMXSize && bTopRowInRange )
+                {
+                    const double tempwt = (1.0 - fracBMX) * (1.0 - fracBMY);
+                    UpdateBackmap(iBMX, iBMY, iX, iY, tempwt);
+                }
+
+                //Check logic for top right pixel
+                if( iBMX + 1 < nBMXSize && bTopRowInRange )
+                {
+                    const double tempwt = fracBMX * (1.0 - fracBMY);
+                    UpdateBackmap(iBMX + 1, iBMY, iX, iY, tempwt);
+                }
+
+                //Check logic for bottom right pixel
+                if( iBMX + 1 < nBMXSize && bBottomRowInRange )
+                {
+                    const double tempwt = fracBMX * fracBMY;
+                    UpdateBackmap(iBMX + 1, iBMY + 1, iX, iY, tempwt);
+                }
+
+                //Check logic for bottom left pixel
+                if( iBMX >= 0 && iBMX < nBMXSize && bBottomRowInRange )
+                {
+                    const double tempwt = (1.0 - fracBMX) * fracBMY;
+                    UpdateBackmap(iBMX, iBMY + 1, iX, iY, tempwt);
+                }
             }
+        }
+    };
 
+    constexpr size_t MIN_ROWS_PER_THREAD = 64;
+    const size_t nBands = std::max(static_cast<size_t>(1),
+        std::min(static_cast<size_t>(nThreads),
+                 nRegionHeight / MIN_ROWS_PER_THREAD));
+    if( nBands == 1 )
+    {
+        Scatter(0, static_cast<std::ptrdiff_t>(nRegionHeight));
+    }
+    else
+    {
+        const size_t nRowsPerBand = (nRegionHeight + nBands - 1) / nBands;
+        std::vector<std::thread> aoThreads;
+        for( size_t iBand = 1; iBand < nBands; iBand++ )
+        {
+            const size_t nRowStart = iBand * nRowsPerBand;
+            const size_t nRowEnd =
+                std::min(nRegionHeight, nRowStart + nRowsPerBand);
+            aoThreads.emplace_back([&Scatter, nRowStart, nRowEnd]()
+            {
+                Scatter(static_cast<std::ptrdiff_t>(nRowStart),
+                        static_cast<std::ptrdiff_t>(nRowEnd));
+            });
         }
+        Scatter(0, static_cast<std::ptrdiff_t>(nRowsPerBand));
+        for( auto& oThread: aoThreads )
+            oThread.join();
     }
 
-
     //Each pixel in the backmap may have multiple entries.
     //We now go in average it out using the weights
     for( size_t i = 0; i < nBMXYCount; i++ )
@@ -435,22 +574,26 @@ static bool GeoLocGenerateBackMap( GDALGeoLocTransformInfo *psTransform )
         //backmap grid node
         if (wgtsBackMap[i] > 0)
         {
-            psTransform->pafBackMapX[i] /= wgtsBackMap[i];
-            psTransform->pafBackMapY[i] /= wgtsBackMap[i];
+            pafBackMapX[i] /= wgtsBackMap[i];
+            pafBackMapY[i] /= wgtsBackMap[i];
         }
         else
         {
-            psTransform->pafBackMapX[i] = -1.0f;
-            psTransform->pafBackMapY[i] = -1.0f;
+            pafBackMapX[i] = -1.0f;
+            pafBackMapY[i] = -1.0f;
         }
     }
 
+    CPLFree( wgtsBackMap );
+
     // Fill holes in backmap
     auto poMEMDS = std::unique_ptr<GDALDataset>(
           MEMDataset::Create( "",
-                              static_cast<int>(nBMXSize),
-                              static_cast<int>(nBMYSize),
+                              static_cast<int>(nRegionWidth),
+                              static_cast<int>(nRegionHeight),
                               0, GDT_Float32, nullptr ));
+    if( poMEMDS == nullptr )
+        return false;
 
     for( int i = 1; i <= 2; i++ )
     {
@@ -458,7 +601,7 @@ static bool GeoLocGenerateBackMap( GDALGeoLocTransformInfo *psTransform )
         char szBuffer0[64] = { '\0' };
         char* apszOptions[] = { szBuffer0, nullptr };
 
-        void* ptr = (i == 1) ? psTransform->pafBackMapX : psTransform->pafBackMapY;
+        void* ptr = (i == 1) ? pafBackMapX : pafBackMapY;
         szBuffer[CPLPrintPointer(szBuffer, ptr, sizeof(szBuffer))] = '\0';
         snprintf(szBuffer0, sizeof(szBuffer0), "DATAPOINTER=%s", szBuffer);
         poMEMDS->AddBand(GDT_Float32, apszOptions);
@@ -501,30 +644,30 @@ static bool GeoLocGenerateBackMap( GDALGeoLocTransformInfo *psTransform )
 
     // A final hole filling logic, proceeding line by line, and feeling
     // holes when the backmap values surrounding the hole are close enough.
-    for( size_t iBMY = 0; iBMY < nBMYSize; iBMY++ )
+    for( size_t iBMY = 0; iBMY < nRegionHeight; iBMY++ )
     {
         size_t iLastValidIX = static_cast<size_t>(-1);
-        for( size_t iBMX = 0; iBMX < nBMXSize; iBMX++ )
+        for( size_t iBMX = 0; iBMX < nRegionWidth; iBMX++ )
         {
-            const size_t iBM = iBMX + iBMY * nBMXSize;
-            if( psTransform->pafBackMapX[iBM] < 0 )
+            const size_t iBM = iBMX + iBMY * nRegionWidth;
+            if( pafBackMapX[iBM] < 0 )
                 continue;
             if( iBMX > iLastValidIX + 1 &&
                 iLastValidIX != static_cast<size_t>(-1) &&
-                fabs( psTransform->pafBackMapX[iBM] -
-                    psTransform->pafBackMapX[iLastValidIX + iBMY * nBMXSize]) <= 2 &&
-                fabs( psTransform->pafBackMapY[iBM] -
-                    psTransform->pafBackMapY[iLastValidIX + iBMY * nBMXSize]) <= 2 )
+                fabs( pafBackMapX[iBM] -
+                    pafBackMapX[iLastValidIX + iBMY * nRegionWidth]) <= 2 &&
+                fabs( pafBackMapY[iBM] -
+                    pafBackMapY[iLastValidIX + iBMY * nRegionWidth]) <= 2 )
             {
                 for( size_t iBMXInner = iLastValidIX + 1; iBMXInner < iBMX; ++iBMXInner )
                 {
                     const float alpha = static_cast<float>(iBMXInner - iLastValidIX) / (iBMX - iLastValidIX);
-                    psTransform->pafBackMapX[iBMXInner + iBMY * nBMXSize] =
-                        (1.0f - alpha) * psTransform->pafBackMapX[iLastValidIX + iBMY * nBMXSize] +
-                        alpha * psTransform->pafBackMapX[iBM];
-                    psTransform->pafBackMapY[iBMXInner + iBMY * nBMXSize] =
-                        (1.0f - alpha) * psTransform->pafBackMapY[iLastValidIX + iBMY * nBMXSize] +
-                        alpha * psTransform->pafBackMapY[iBM];
+                    pafBackMapX[iBMXInner + iBMY * nRegionWidth] =
+                        (1.0f - alpha) * pafBackMapX[iLastValidIX + iBMY * nRegionWidth] +
+                        alpha * pafBackMapX[iBM];
+                    pafBackMapY[iBMXInner + iBMY * nRegionWidth] =
+                        (1.0f - alpha) * pafBackMapY[iLastValidIX + iBMY * nRegionWidth] +
+                        alpha * pafBackMapY[iBM];
                 }
             }
             iLastValidIX = iBMX;
@@ -541,11 +684,386 @@ static bool GeoLocGenerateBackMap( GDALGeoLocTransformInfo *psTransform )
     }
 #endif
 
-    CPLFree( wgtsBackMap );
-
     return true;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*                        GDALGeoLocBackMapTiles                        */
+/* ==================================================================== */
+/************************************************************************/
+
+// Backmap split into tiles that are computed on first access, for
+// geolocation arrays whose full backmap would not fit in memory. Each tile is
+// computed from the source pixels found with a GDALGeoLocBlockIndex, over
+// its extent enlarged by a margin so that hole filling sees the neighbouring
+// values. The most recently used tiles are kept in memory, and the others in
+// a temporary file.
+
+constexpr size_t BACKMAP_TILE_SIZE = 256;
+constexpr size_t BACKMAP_TILE_MARGIN = 16;
+
+class GDALGeoLocBackMapTiles
+{
+    public:
+        // X values, then Y values, of the tile
+        typedef std::shared_ptr<std::vector<float>> TileData;
+
+    private:
+        const GDALGeoLocTransformInfo *m_psTransform;
+        GDALGeoLocBlockIndex    m_oIndex{};
+        size_t                  m_nTilesX = 0;
+        size_t                  m_nTilesY = 0;
+        size_t                  m_nMaxCachedTiles = 0;
+
+        std::mutex              m_oMutex{};
+        // Most recently used first
+        std::list<size_t>       m_anLRU{};
+        std::map<size_t, std::pair<TileData, std::list<size_t>::iterator>>
+                                m_oMapCachedTiles{};
+
+        CPLString               m_osSpillFilename{};
+        VSILFILE               *m_fpSpill = nullptr;
+        std::vector<bool>       m_abSpilled{};
+
+        GDALGeoLocBackMapTiles(const GDALGeoLocBackMapTiles&) = delete;
+        GDALGeoLocBackMapTiles& operator=(const GDALGeoLocBackMapTiles&) = delete;
+
+        TileData    ComputeTile( size_t nTile ) const;
+        TileData    FindTileLocked( size_t nTile );
+        void        CacheTileLocked( size_t nTile, const TileData& poData );
+
+    public:
+        explicit GDALGeoLocBackMapTiles(
+            const GDALGeoLocTransformInfo *psTransform );
+        ~GDALGeoLocBackMapTiles();
+
+        size_t      GetTilesX() const { return m_nTilesX; }
+        size_t      GetTileCount() const { return m_nTilesX * m_nTilesY; }
+
+        TileData    GetTile( size_t nTile );
+        void        PrepareTiles( const std::vector<size_t>& anTiles,
+                                  int nThreads );
+};
+
+GDALGeoLocBackMapTiles::GDALGeoLocBackMapTiles(
+                            const GDALGeoLocTransformInfo *psTransform ) :
+    m_psTransform(psTransform)
+{
+    m_oIndex.Build(psTransform);
+    m_nTilesX = (psTransform->nBackMapWidth + BACKMAP_TILE_SIZE - 1) /
+                                                        BACKMAP_TILE_SIZE;
+    m_nTilesY = (psTransform->nBackMapHeight + BACKMAP_TILE_SIZE - 1) /
+                                                        BACKMAP_TILE_SIZE;
+    m_abSpilled.resize(m_nTilesX * m_nTilesY);
+
+    const size_t nTileBytes =
+        2 * BACKMAP_TILE_SIZE * BACKMAP_TILE_SIZE * sizeof(float);
+    const GIntBig nCacheSize = static_cast<GIntBig>(
+        atoi(CPLGetConfigOption("GDAL_GEOLOC_BACKMAP_CACHE_SIZE", "256"))) *
+                                                                1024 * 1024;
+    m_nMaxCachedTiles = std::max(static_cast<size_t>(4),
+        static_cast<size_t>(std::max(static_cast<GIntBig>(0), nCacheSize)) /
+                                                                nTileBytes);
+}
+
+GDALGeoLocBackMapTiles::~GDALGeoLocBackMapTiles()
+{
+    if( m_fpSpill )
+    {
+        VSIFCloseL(m_fpSpill);
+        VSIUnlink(m_osSpillFilename);
+    }
+}
+
+GDALGeoLocBackMapTiles::TileData
+GDALGeoLocBackMapTiles::ComputeTile( size_t nTile ) const
+{
+    const size_t nBMWidth = m_psTransform->nBackMapWidth;
+    const size_t nBMHeight = m_psTransform->nBackMapHeight;
+    const size_t nTileX0 = (nTile % m_nTilesX) * BACKMAP_TILE_SIZE;
+    const size_t nTileY0 = (nTile / m_nTilesX) * BACKMAP_TILE_SIZE;
+
+    const size_t nRegionX = nTileX0 - std::min(nTileX0, BACKMAP_TILE_MARGIN);
+    const size_t nRegionY = nTileY0 - std::min(nTileY0, BACKMAP_TILE_MARGIN);
+    const size_t nRegionWidth = std::min(nBMWidth,
+        nTileX0 + BACKMAP_TILE_SIZE + BACKMAP_TILE_MARGIN) - nRegionX;
+    const size_t nRegionHeight = std::min(nBMHeight,
+        nTileY0 + BACKMAP_TILE_SIZE + BACKMAP_TILE_MARGIN) - nRegionY;
+
+    std::vector<float> afRegionX;
+    std::vector<float> afRegionY;
+    try
+    {
+        afRegionX.resize(nRegionWidth * nRegionHeight);
+        afRegionY.resize(nRegionWidth * nRegionHeight);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate backmap tile");
+        return nullptr;
+    }
+    if( !GeoLocBuildBackMapRegion( m_psTransform, &m_oIndex,
+                                   nRegionX, nRegionY,
+                                   nRegionWidth, nRegionHeight, 1,
+                                   afRegionX.data(), afRegionY.data() ) )
+    {
+        return nullptr;
+    }
+
+    constexpr size_t nTilePixels = BACKMAP_TILE_SIZE * BACKMAP_TILE_SIZE;
+    auto poData = std::make_shared<std::vector<float>>(2 * nTilePixels, -1.0f);
+    const size_t nCopyWidth =
+        std::min(BACKMAP_TILE_SIZE, nBMWidth - nTileX0);
+    const size_t nCopyHeight =
+        std::min(BACKMAP_TILE_SIZE, nBMHeight - nTileY0);
+    for( size_t iY = 0; iY < nCopyHeight; iY++ )
+    {
+        const size_t iSrc =
+            (nTileY0 - nRegionY + iY) * nRegionWidth + nTileX0 - nRegionX;
+        memcpy( poData->data() + iY * BACKMAP_TILE_SIZE,
+                afRegionX.data() + iSrc, nCopyWidth * sizeof(float) );
+        memcpy( poData->data() + nTilePixels + iY * BACKMAP_TILE_SIZE,
+                afRegionY.data() + iSrc, nCopyWidth * sizeof(float) );
+    }
+    return poData;
+}
+
+GDALGeoLocBackMapTiles::TileData
+GDALGeoLocBackMapTiles::FindTileLocked( size_t nTile )
+{
+    auto oIter = m_oMapCachedTiles.find(nTile);
+    if( oIter != m_oMapCachedTiles.end() )
+    {
+        m_anLRU.splice(m_anLRU.begin(), m_anLRU, oIter->second.second);
+        return oIter->second.first;
+    }
+
+    if( !m_abSpilled[nTile] )
+        return nullptr;
+
+    constexpr size_t nTileValues = 2 * BACKMAP_TILE_SIZE * BACKMAP_TILE_SIZE;
+    auto poData = std::make_shared<std::vector<float>>(nTileValues);
+    if( VSIFSeekL(m_fpSpill, static_cast<vsi_l_offset>(nTile) *
+                                nTileValues * sizeof(float), SEEK_SET) != 0 ||
+        VSIFReadL(poData->data(), sizeof(float), nTileValues,
+                  m_fpSpill) != nTileValues )
+    {
+        // Will be recomputed
+        m_abSpilled[nTile] = false;
+        return nullptr;
+    }
+    CacheTileLocked(nTile, poData);
+    return poData;
+}
+
+void GDALGeoLocBackMapTiles::CacheTileLocked( size_t nTile,
+                                              const TileData& poData )
+{
+    m_anLRU.push_front(nTile);
+    m_oMapCachedTiles[nTile] = std::make_pair(poData, m_anLRU.begin());
+    if( m_anLRU.size() <= m_nMaxCachedTiles )
+        return;
+
+    // Evict the least recently used tile, and save it if not already done
+    const size_t nEvicted = m_anLRU.back();
+    m_anLRU.pop_back();
+    auto oIter = m_oMapCachedTiles.find(nEvicted);
+    const TileData poEvicted = oIter->second.first;
+    m_oMapCachedTiles.erase(oIter);
+    if( m_abSpilled[nEvicted] )
+        return;
+
+    if( m_fpSpill == nullptr )
+    {
+        m_osSpillFilename = CPLGenerateTempFilename("geoloc_backmap");
+        m_fpSpill = VSIFOpenL(m_osSpillFilename, "wb+");
+        if( m_fpSpill == nullptr )
+        {
+            CPLError(CE_Warning, CPLE_FileIO,
+                     "Cannot create %s. Evicted backmap tiles will have "
+                     "to be computed again", m_osSpillFilename.c_str());
+            // Do not retry
+            m_abSpilled.assign(m_abSpilled.size(), false);
+            m_osSpillFilename.clear();
+            return;
+        }
+    }
+    const size_t nTileValues = poEvicted->size();
+    if( VSIFSeekL(m_fpSpill, static_cast<vsi_l_offset>(nEvicted) *
+                                nTileValues * sizeof(float), SEEK_SET) == 0 &&
+        VSIFWriteL(poEvicted->data(), sizeof(float), nTileValues,
+                   m_fpSpill) == nTileValues )
+    {
+        m_abSpilled[nEvicted] = true;
+    }
+}
+
+GDALGeoLocBackMapTiles::TileData
+GDALGeoLocBackMapTiles::GetTile( size_t nTile )
+{
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        auto poData = FindTileLocked(nTile);
+        if( poData )
+            return poData;
+    }
+
+    // Computed without holding the lock, so that several threads can
+    // compute different tiles.
+    auto poData = ComputeTile(nTile);
+    if( poData == nullptr )
+        return nullptr;
+
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if( m_oMapCachedTiles.find(nTile) == m_oMapCachedTiles.end() )
+        CacheTileLocked(nTile, poData);
+    return poData;
+}
+
+void GDALGeoLocBackMapTiles::PrepareTiles( const std::vector<size_t>& anTiles,
+                                           int nThreads )
+{
+    std::vector<size_t> anMissingTiles;
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        for( const size_t nTile: anTiles )
+        {
+            if( m_oMapCachedTiles.find(nTile) == m_oMapCachedTiles.end() &&
+                !m_abSpilled[nTile] )
+            {
+                anMissingTiles.push_back(nTile);
+            }
+        }
+    }
+    // No point in computing more tiles than can be kept in memory
+    if( anMissingTiles.size() < 2 || nThreads < 2 ||
+        anMissingTiles.size() > m_nMaxCachedTiles )
+        return;
+
+    nThreads = static_cast<int>(
+        std::min(anMissingTiles.size(), static_cast<size_t>(nThreads)));
+    std::vector<std::thread> aoThreads;
+    for( int iThread = 0; iThread < nThreads; iThread++ )
+    {
+        aoThreads.emplace_back([this, &anMissingTiles, iThread, nThreads]()
+        {
+            for( size_t i = iThread; i < anMissingTiles.size(); i += nThreads )
+                GetTile(anMissingTiles[i]);
+        });
+    }
+    for( auto& oThread: aoThreads )
+        oThread.join();
+}
+
+/************************************************************************/
+/*                       GeoLocGenerateBackMap()                        */
+/************************************************************************/
+
+// Above this number of pixels, the backmap is built lazily by tiles
+constexpr size_t GEOLOC_TILED_BACKMAP_MIN_PIXELS = 100 * 1000 * 1000;
+
+static bool GeoLocGenerateBackMap( GDALGeoLocTransformInfo *psTransform )
+
+{
+    const size_t nXSize = psTransform->nGeoLocXSize;
+    const size_t nYSize = psTransform->nGeoLocYSize;
+
+/* -------------------------------------------------------------------- */
+/*      Decide on resolution for backmap.  We aim for slightly          */
+/*      higher resolution than the source but we can't easily           */
+/*      establish how much dead space there is in the backmap, so it    */
+/*      is approximate.                                                 */
+/* -------------------------------------------------------------------- */
+    const double dfTargetPixels = (static_cast<double>(nXSize) * nYSize * OVERSAMPLE_FACTOR);
+    const double dfPixelSize = sqrt(
+        (psTransform->dfMaxX - psTransform->dfMinX) *
+        (psTransform->dfMaxY - psTransform->dfMinY) / dfTargetPixels);
+    if( dfPixelSize == 0.0 )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Invalid pixel size for backmap");
+        return false;
+    }
+
+    const double dfBMXSize = (psTransform->dfMaxX - psTransform->dfMinX) / dfPixelSize + 1;
+    const double dfBMYSize = (psTransform->dfMaxY - psTransform->dfMinY) / dfPixelSize + 1;
+
+    if( !(dfBMXSize > 0 && dfBMXSize < INT_MAX) ||
+        !(dfBMYSize > 0 && dfBMYSize < INT_MAX) )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Int overflow : %f x %f",
+                 dfBMXSize, dfBMYSize);
+        return false;
+    }
+
+    const size_t nBMXSize = static_cast<size_t>(dfBMXSize);
+    const size_t nBMYSize = static_cast<size_t>(dfBMYSize);
+
+    if( nBMYSize > std::numeric_limits<size_t>::max() / nBMXSize )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Int overflow : %f x %f",
+                 dfBMXSize, dfBMYSize);
+        return false;
+    }
+
+    psTransform->nBackMapWidth = nBMXSize;
+    psTransform->nBackMapHeight = nBMYSize;
+
+    const double dfMinX = psTransform->dfMinX - dfPixelSize / 2.0;
+    const double dfMaxY = psTransform->dfMaxY + dfPixelSize / 2.0;
+
+    psTransform->adfBackMapGeoTransform[0] = dfMinX;
+    psTransform->adfBackMapGeoTransform[1] = dfPixelSize;
+    psTransform->adfBackMapGeoTransform[2] = 0.0;
+    psTransform->adfBackMapGeoTransform[3] = dfMaxY;
+    psTransform->adfBackMapGeoTransform[4] = 0.0;
+    psTransform->adfBackMapGeoTransform[5] = -dfPixelSize;
+
+/* -------------------------------------------------------------------- */
+/*      Large backmaps are built lazily, by tiles, when the transformer */
+/*      is used.                                                        */
+/* -------------------------------------------------------------------- */
+    const char* pszTiled =
+        CPLGetConfigOption("GDAL_GEOLOC_TILED_BACKMAP", "AUTO");
+    const bool bTiled = EQUAL(pszTiled, "AUTO") ?
+        nBMXSize * nBMYSize >= GEOLOC_TILED_BACKMAP_MIN_PIXELS :
+        CPLTestBool(pszTiled);
+    if( bTiled )
+    {
+        CPLDebug("GEOLOC", "Using a tiled backmap of %u x %u pixels",
+                 static_cast<unsigned>(nBMXSize),
+                 static_cast<unsigned>(nBMYSize));
+        psTransform->poBackMapTiles = new GDALGeoLocBackMapTiles(psTransform);
+        return true;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Allocate and compute the full backmap.                          */
+/* -------------------------------------------------------------------- */
+    psTransform->pafBackMapX = static_cast<float *>(
+        VSI_MALLOC3_VERBOSE(nBMXSize, nBMYSize, sizeof(float)));
+    psTransform->pafBackMapY = static_cast<float *>(
+        VSI_MALLOC3_VERBOSE(nBMXSize, nBMYSize, sizeof(float)));
+
+    if( psTransform->pafBackMapX == nullptr ||
+        psTransform->pafBackMapY == nullptr )
+    {
+        return false;
+    }
+
+    const int nThreads = GeoLocGetNumThreads();
+    GDALGeoLocBlockIndex oIndex;
+    if( nThreads > 1 )
+        oIndex.Build(psTransform);
+
+    return GeoLocBuildBackMapRegion( psTransform,
+                                     nThreads > 1 ? &oIndex : nullptr,
+                                     0, 0, nBMXSize, nBMYSize, nThreads,
+                                     psTransform->pafBackMapX,
+                                     psTransform->pafBackMapY );
+}
+
 /************************************************************************/
 /*                       GDALGeoLocRescale()                            */
 /************************************************************************/
@@ -601,7 +1119,20 @@ void* GDALCreateSimilarGeoLocTransformer( void *hTransformArg,
 /*                    GDALCreateGeoLocTransformer()                     */
 /************************************************************************/
 
-/** Create GeoLocation transformer */
+/** Create GeoLocation transformer.
+ *
+ * The inverse transformation (georeferenced to pixel/line coordinates) uses
+ * a backmap computed from the geolocation arrays. Its computation is split
+ * across the number of threads specified by the GDAL_NUM_THREADS
+ * configuration option (number or ALL_CPUS, default 1).
+ *
+ * Large backmaps (more than 100 million pixels) are not allocated as a whole,
+ * but split into tiles computed when first needed by a transformation. At most
+ * GDAL_GEOLOC_BACKMAP_CACHE_SIZE MB (default 256) of tiles are kept in memory,
+ * the others being saved in a temporary file. The
+ * GDAL_GEOLOC_TILED_BACKMAP=YES/NO configuration option can be used to force
+ * or disable that mode.
+ */
 void *GDALCreateGeoLocTransformer( GDALDatasetH hBaseDS,
                                    char **papszGeolocationInfo,
                                    int bReversed )
@@ -787,6 +1318,7 @@ void GDALDestroyGeoLocTransformer( void *pTransformAlg )
 
     CPLFree( psTransform->pafBackMapX );
     CPLFree( psTransform->pafBackMapY );
+    delete psTransform->poBackMapTiles;
     CSLDestroy( psTransform->papszGeolocationInfo );
     CPLFree( psTransform->padfGeoLocX );
     CPLFree( psTransform->padfGeoLocY );
@@ -922,44 +1454,114 @@ int GDALGeoLocTransform( void *pTransformArg,
 /* -------------------------------------------------------------------- */
     else
     {
-        for( int i = 0; i < nPointCount; i++ )
+        const size_t nBMWidth = psTransform->nBackMapWidth;
+        const size_t nBMHeight = psTransform->nBackMapHeight;
+        GDALGeoLocBackMapTiles* poTiles = psTransform->poBackMapTiles;
+
+        const auto GetBackMapCoords = [psTransform](double dfX, double dfY,
+                                                    double& dfBMX,
+                                                    double& dfBMY)
         {
-            if( padfX[i] == HUGE_VAL || padfY[i] == HUGE_VAL )
+            if( psTransform->bSwapXY )
+                std::swap(dfX, dfY);
+            dfBMX = ((dfX - psTransform->adfBackMapGeoTransform[0])
+                     / psTransform->adfBackMapGeoTransform[1]) - ISHIFT;
+            dfBMY = ((dfY - psTransform->adfBackMapGeoTransform[3])
+                     / psTransform->adfBackMapGeoTransform[5]) - ISHIFT;
+        };
+
+        // With a tiled backmap, compute first the missing tiles needed by
+        // the points, possibly in parallel.
+        if( poTiles && nPointCount > 1 )
+        {
+            std::vector<bool> abNeededTiles(poTiles->GetTileCount());
+            for( int i = 0; i < nPointCount; i++ )
             {
-                panSuccess[i] = FALSE;
-                continue;
+                if( padfX[i] == HUGE_VAL || padfY[i] == HUGE_VAL )
+                    continue;
+                double dfBMX = 0;
+                double dfBMY = 0;
+                GetBackMapCoords(padfX[i], padfY[i], dfBMX, dfBMY);
+                if( !(dfBMX > -1 && dfBMY > -1 &&
+                      dfBMX < nBMWidth && dfBMY < nBMHeight) )
+                    continue;
+                const size_t iBMX = static_cast<size_t>(dfBMX);
+                const size_t iBMY = static_cast<size_t>(dfBMY);
+                const size_t iTileX0 = iBMX / BACKMAP_TILE_SIZE;
+                const size_t iTileY0 = iBMY / BACKMAP_TILE_SIZE;
+                const size_t iTileX1 = std::min(iBMX + 1, nBMWidth - 1) /
+                                                        BACKMAP_TILE_SIZE;
+                const size_t iTileY1 = std::min(iBMY + 1, nBMHeight - 1) /
+                                                        BACKMAP_TILE_SIZE;
+                for( size_t iTileY = iTileY0; iTileY <= iTileY1; iTileY++ )
+                {
+                    for( size_t iTileX = iTileX0; iTileX <= iTileX1; iTileX++ )
+                        abNeededTiles[iTileY * poTiles->GetTilesX() + iTileX] = true;
+                }
             }
-
-            if( psTransform->bSwapXY )
+            std::vector<size_t> anNeededTiles;
+            for( size_t i = 0; i < abNeededTiles.size(); i++ )
             {
-                std::swap(padfX[i], padfY[i]);
+                if( abNeededTiles[i] )
+                    anNeededTiles.push_back(i);
             }
+            poTiles->PrepareTiles(anNeededTiles, GeoLocGetNumThreads());
+        }
 
-            const double dfBMX =
-                ((padfX[i] - psTransform->adfBackMapGeoTransform[0])
-                 / psTransform->adfBackMapGeoTransform[1]) - ISHIFT;
-            const double dfBMY =
-                ((padfY[i] - psTransform->adfBackMapGeoTransform[3])
-                 / psTransform->adfBackMapGeoTransform[5]) - ISHIFT;
+        // Fetch the backmap value at (iBMX, iBMY), from the full backmap or
+        // from its tile.
+        GDALGeoLocBackMapTiles::TileData poCurTile;
+        size_t nCurTile = std::numeric_limits<size_t>::max();
+        const auto GetBackMap = [psTransform, poTiles, nBMWidth, &poCurTile,
+                                 &nCurTile](size_t iBMX, size_t iBMY,
+                                            float& fBMX, float& fBMY)
+        {
+            if( poTiles == nullptr )
+            {
+                const size_t iBM = iBMX + iBMY * nBMWidth;
+                fBMX = psTransform->pafBackMapX[iBM];
+                fBMY = psTransform->pafBackMapY[iBM];
+                return true;
+            }
+            const size_t nTile = (iBMY / BACKMAP_TILE_SIZE) *
+                poTiles->GetTilesX() + iBMX / BACKMAP_TILE_SIZE;
+            if( nTile != nCurTile )
+            {
+                poCurTile = poTiles->GetTile(nTile);
+                nCurTile = nTile;
+            }
+            if( poCurTile == nullptr )
+                return false;
+            const size_t iInTile =
+                (iBMY % BACKMAP_TILE_SIZE) * BACKMAP_TILE_SIZE +
+                iBMX % BACKMAP_TILE_SIZE;
+            fBMX = (*poCurTile)[iInTile];
+            fBMY = (*poCurTile)[BACKMAP_TILE_SIZE * BACKMAP_TILE_SIZE + iInTile];
+            return true;
+        };
 
-            // FIXME: in the case of ]-1,0[, dfBMX-iBMX will be wrong
-            // We should likely error out if values are < 0 ==> affects a few
-            // autotest results
-            if( !(dfBMX > -1 && dfBMY > -1 &&
-                  dfBMX < psTransform->nBackMapWidth &&
-                  dfBMY < psTransform->nBackMapHeight) )
+        for( int i = 0; i < nPointCount; i++ )
+        {
+            if( padfX[i] == HUGE_VAL || padfY[i] == HUGE_VAL )
             {
                 panSuccess[i] = FALSE;
-                padfX[i] = HUGE_VAL;
-                padfY[i] = HUGE_VAL;
                 continue;
             }
 
-            const std::ptrdiff_t iBMX = static_cast<std::ptrdiff_t>(dfBMX);
-            const std::ptrdiff_t iBMY = static_cast<std::ptrdiff_t>(dfBMY);
+            double dfBMX = 0;
+            double dfBMY = 0;
+            GetBackMapCoords(padfX[i], padfY[i], dfBMX, dfBMY);
 
-            const size_t iBM = iBMX + iBMY * psTransform->nBackMapWidth;
-            if( psTransform->pafBackMapX[iBM] < 0 )
+            // FIXME: in the case of ]-1,0[, dfBMX-iBMX will be wrong
+            // We should likely error out if values are < 0 ==> affects a few
+            // autotest results
+            float fBMX0 = -1.0f;
+            float fBMY0 = -1.0f;
+            if( !(dfBMX > -1 && dfBMY > -1 &&
+                  dfBMX < nBMWidth && dfBMY < nBMHeight) ||
+                !GetBackMap(static_cast<size_t>(dfBMX),
+                            static_cast<size_t>(dfBMY), fBMX0, fBMY0) ||
+                fBMX0 < 0 )
             {
                 panSuccess[i] = FALSE;
                 padfX[i] = HUGE_VAL;
@@ -967,53 +1569,49 @@ int GDALGeoLocTransform( void *pTransformArg,
                 continue;
             }
 
-            const float* pafBMX = psTransform->pafBackMapX + iBM;
-            const float* pafBMY = psTransform->pafBackMapY + iBM;
-
-            if( static_cast<size_t>(iBMX + 1) < psTransform->nBackMapWidth &&
-                static_cast<size_t>(iBMY + 1) < psTransform->nBackMapHeight &&
-                pafBMX[1] >=0 && pafBMX[psTransform->nBackMapWidth] >= 0 &&
-                pafBMX[psTransform->nBackMapWidth+1] >= 0)
+            const size_t iBMX = static_cast<size_t>(dfBMX);
+            const size_t iBMY = static_cast<size_t>(dfBMY);
+
+            // Right, bottom and bottom right neighbours
+            float fBMX1 = -1.0f;
+            float fBMY1 = -1.0f;
+            float fBMX2 = -1.0f;
+            float fBMY2 = -1.0f;
+            float fBMX3 = -1.0f;
+            float fBMY3 = -1.0f;
+            const bool bHasRight = iBMX + 1 < nBMWidth &&
+                GetBackMap(iBMX + 1, iBMY, fBMX1, fBMY1) && fBMX1 >= 0;
+            const bool bHasBottom = iBMY + 1 < nBMHeight &&
+                GetBackMap(iBMX, iBMY + 1, fBMX2, fBMY2) && fBMX2 >= 0;
+
+            if( bHasRight && bHasBottom &&
+                GetBackMap(iBMX + 1, iBMY + 1, fBMX3, fBMY3) && fBMX3 >= 0 )
             {
                 padfX[i] =
                     (1-(dfBMY - iBMY))
-                    * (pafBMX[0] + (dfBMX - iBMX) * (pafBMX[1] - pafBMX[0]))
+                    * (fBMX0 + (dfBMX - iBMX) * (fBMX1 - fBMX0))
                     + (dfBMY - iBMY)
-                    * (pafBMX[psTransform->nBackMapWidth] +
-                       (dfBMX - iBMX) * (pafBMX[psTransform->nBackMapWidth+1] -
-                                         pafBMX[psTransform->nBackMapWidth]));
+                    * (fBMX2 + (dfBMX - iBMX) * (fBMX3 - fBMX2));
                 padfY[i] =
                     (1-(dfBMY - iBMY))
-                    * (pafBMY[0] + (dfBMX - iBMX) * (pafBMY[1] - pafBMY[0]))
+                    * (fBMY0 + (dfBMX - iBMX) * (fBMY1 - fBMY0))
                     + (dfBMY - iBMY)
-                    * (pafBMY[psTransform->nBackMapWidth] +
-                       (dfBMX - iBMX) * (pafBMY[psTransform->nBackMapWidth+1] -
-                                         pafBMY[psTransform->nBackMapWidth]));
+                    * (fBMY2 + (dfBMX - iBMX) * (fBMY3 - fBMY2));
             }
-            else if( static_cast<size_t>(iBMX + 1) < psTransform->nBackMapWidth &&
-                     pafBMX[1] >=0)
+            else if( bHasRight )
             {
-                padfX[i] = pafBMX[0] +
-                            (dfBMX - iBMX) * (pafBMX[1] - pafBMX[0]);
-                padfY[i] = pafBMY[0] +
-                            (dfBMX - iBMX) * (pafBMY[1] - pafBMY[0]);
+                padfX[i] = fBMX0 + (dfBMX - iBMX) * (fBMX1 - fBMX0);
+                padfY[i] = fBMY0 + (dfBMX - iBMX) * (fBMY1 - fBMY0);
             }
-            else if( static_cast<size_t>(iBMY + 1) < psTransform->nBackMapHeight &&
-                     pafBMX[psTransform->nBackMapWidth] >= 0 )
+            else if( bHasBottom )
             {
-                padfX[i] =
-                    pafBMX[0] +
-                    (dfBMY - iBMY) * (pafBMX[psTransform->nBackMapWidth] -
-                                      pafBMX[0]);
-                padfY[i] =
-                    pafBMY[0] +
-                    (dfBMY - iBMY) * (pafBMY[psTransform->nBackMapWidth] -
-                                      pafBMY[0]);
+                padfX[i] = fBMX0 + (dfBMY - iBMY) * (fBMX2 - fBMX0);
+                padfY[i] = fBMY0 + (dfBMY - iBMY) * (fBMY2 - fBMY0);
             }
             else
             {
-                padfX[i] = pafBMX[0];
-                padfY[i] = pafBMY[0];
+                padfX[i] = fBMX0;
+                padfY[i] = fBMY0;
             }
             panSuccess[i] = TRUE;
         }
@@ -37,16 +37,19 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <algorithm>
 #include <limits>
 #include <map>
+#include <new>
 #include <utility>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_cpu_features.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
 #include "cpl_progress.h"
-#include "cpl_quad_tree.h"
+#include "cpl_packed_rtree.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "cpl_worker_thread_pool.h"
@@ -57,20 +60,66 @@ CPL_CVSID("$Id$")
 constexpr double TO_RADIANS = M_PI / 180.0;
 
 /************************************************************************/
-/*                        GDALGridGetPointBounds()                      */
+/*                         GDALGridSearchPoints()                       */
 /************************************************************************/
 
-static void GDALGridGetPointBounds( const void* hFeature, CPLRectObj* pBounds )
+// Returns the indices of the points that are in sAoi, in unspecified order.
+// The returned array must be freed with CPLFree().
+static GUInt32* GDALGridSearchPoints( const GDALGridExtraParameters* psExtraParams,
+                                      const CPLRectObj& sAoi, int* pnCount )
 {
-    const GDALGridPoint* psPoint = static_cast<const GDALGridPoint*>(hFeature);
-    GDALGridXYArrays* psXYArrays = psPoint->psXYArrays;
-    const int i = psPoint->i;
-    const double dfX = psXYArrays->padfX[i];
-    const double dfY = psXYArrays->padfY[i];
-    pBounds->minx = dfX;
-    pBounds->miny = dfY;
-    pBounds->maxx = dfX;
-    pBounds->maxy = dfY;
+    // Reused between calls of the same thread to avoid reallocations.
+    static thread_local std::vector<size_t> anItems;
+    psExtraParams->poRTree->Search(sAoi, anItems);
+    *pnCount = static_cast<int>(anItems.size());
+    if( anItems.empty() )
+        return nullptr;
+    GUInt32* panPoints = static_cast<GUInt32*>(
+        CPLMalloc(anItems.size() * sizeof(GUInt32)));
+    for( size_t k = 0; k < anItems.size(); k++ )
+        panPoints[k] = static_cast<GUInt32>(anItems[k]);
+    return panPoints;
+}
+
+/************************************************************************/
+/*                   GDALGridGetPointsInSearchEllipse()                 */
+/************************************************************************/
+
+// Returns the indices of the points of the spatial index of hExtraParamsIn
+// that are in the bounding box of the search ellipse, sorted by increasing
+// index so that the caller iterates over them in the same order as over the
+// whole arrays.
+// Returns nullptr and leaves *pnCount unchanged if there is no spatial index
+// or the search ellipse is unbounded, in which case all points must be
+// visited.
+// The returned array must be freed with CPLFree().
+static GUInt32* GDALGridGetPointsInSearchEllipse(
+    void* hExtraParamsIn, double dfRadius1, double dfRadius2,
+    double dfXPoint, double dfYPoint, GUInt32* pnCount )
+{
+    const GDALGridExtraParameters* psExtraParams =
+        static_cast<const GDALGridExtraParameters *>(hExtraParamsIn);
+    if( psExtraParams == nullptr || psExtraParams->poRTree == nullptr ||
+        !(dfRadius1 > 0.0) || !(dfRadius2 > 0.0) )
+    {
+        return nullptr;
+    }
+
+    // Whatever the rotation angle, the ellipse fits in that square.
+    // Slightly enlarged to be robust to rounding errors.
+    const double dfSearchRadius = std::max(dfRadius1, dfRadius2) * (1 + 1e-10);
+    CPLRectObj sAoi;
+    sAoi.minx = dfXPoint - dfSearchRadius;
+    sAoi.miny = dfYPoint - dfSearchRadius;
+    sAoi.maxx = dfXPoint + dfSearchRadius;
+    sAoi.maxy = dfYPoint + dfSearchRadius;
+    int nFeatureCount = 0;
+    GUInt32* panPoints =
+        GDALGridSearchPoints(psExtraParams, sAoi, &nFeatureCount);
+    if( panPoints != nullptr )
+        std::sort(panPoints, panPoints + nFeatureCount);
+    *pnCount = static_cast<GUInt32>(nFeatureCount);
+    return panPoints;
 }
 
 /************************************************************************/
@@ -118,7 +167,7 @@ static void GDALGridGetPointBounds( const void* hFeature, CPLRectObj* pBounds )
  * @param dfYPoint Y coordinate of the point to compute.
  * @param pdfValue Pointer to variable where the computed grid node value
  * will be returned.
- * @param hExtraParamsIn extra parameters (unused)
+ * @param hExtraParamsIn extra parameters, or NULL.
  *
  * @return CE_None on success or CE_Failure if something goes wrong.
  */
@@ -129,7 +178,7 @@ GDALGridInverseDistanceToAPower( const void *poOptionsIn, GUInt32 nPoints,
                                  const double *padfZ,
                                  double dfXPoint, double dfYPoint,
                                  double *pdfValue,
-                                 CPL_UNUSED void* hExtraParamsIn)
+                                 void* hExtraParamsIn)
 {
     // TODO: For optimization purposes pre-computed parameters should be moved
     // out of this routine to the calling function.
@@ -156,8 +205,13 @@ GDALGridInverseDistanceToAPower( const void *poOptionsIn, GUInt32 nPoints,
     double dfDenominator = 0.0;
     GUInt32 n = 0;
 
-    for( GUInt32 i = 0; i < nPoints; i++ )
+    GUInt32 nCandidates = nPoints;
+    GUInt32* panPoints = GDALGridGetPointsInSearchEllipse(
+        hExtraParamsIn, poOptions->dfRadius1, poOptions->dfRadius2,
+        dfXPoint, dfYPoint, &nCandidates );
+    for( GUInt32 k = 0; k < nCandidates; k++ )
     {
+        const GUInt32 i = panPoints ? panPoints[k] : k;
         double dfRX = padfX[i] - dfXPoint;
         double dfRY = padfY[i] - dfYPoint;
         const double dfR2 =
@@ -180,6 +234,7 @@ GDALGridInverseDistanceToAPower( const void *poOptionsIn, GUInt32 nPoints,
             if( dfR2 < 0.0000000000001 )
             {
                 *pdfValue = padfZ[i];
+                CPLFree(panPoints);
                 return CE_None;
             }
 
@@ -192,6 +247,7 @@ GDALGridInverseDistanceToAPower( const void *poOptionsIn, GUInt32 nPoints,
                 break;
         }
     }
+    CPLFree(panPoints);
 
     if( n < poOptions->nMinPoints || dfDenominator == 0.0 )
     {
@@ -278,7 +334,7 @@ GDALGridInverseDistanceToAPowerNearestNeighbor(
 
     GDALGridExtraParameters* psExtraParams =
         static_cast<GDALGridExtraParameters *>(hExtraParamsIn);
-    CPLQuadTree* phQuadTree = psExtraParams->hQuadTree;
+    const CPLPackedRTree* poRTree = psExtraParams->poRTree;
 
     const double dfRPower2 = psExtraParams->dfRadiusPower2PreComp;
     const double dfRPower4 = psExtraParams->dfRadiusPower4PreComp;
@@ -286,7 +342,7 @@ GDALGridInverseDistanceToAPowerNearestNeighbor(
     const double dfPowerDiv2 = psExtraParams->dfPowerDiv2PreComp;
 
     std::multimap<double, double> oMapDistanceToZValues;
-    if( phQuadTree != nullptr )
+    if( poRTree != nullptr )
     {
         const double dfSearchRadius = dfRadius;
         CPLRectObj sAoi;
@@ -295,13 +351,13 @@ GDALGridInverseDistanceToAPowerNearestNeighbor(
         sAoi.maxx = dfXPoint + dfSearchRadius;
         sAoi.maxy = dfYPoint + dfSearchRadius;
         int nFeatureCount = 0;
-        GDALGridPoint** papsPoints = reinterpret_cast<GDALGridPoint **>(
-                CPLQuadTreeSearch(phQuadTree, &sAoi, &nFeatureCount) );
+        GUInt32* panPoints =
+            GDALGridSearchPoints(psExtraParams, sAoi, &nFeatureCount);
         if( nFeatureCount != 0 )
         {
             for( int k = 0; k < nFeatureCount; k++ )
             {
-                const int i = papsPoints[k]->i;
+                const GUInt32 i = panPoints[k];
                 const double dfRX = padfX[i] - dfXPoint;
                 const double dfRY = padfY[i] - dfYPoint;
 
@@ -311,7 +367,7 @@ GDALGridInverseDistanceToAPowerNearestNeighbor(
                 if( dfRsmoothed2 < 0.0000000000001 )
                 {
                     *pdfValue = padfZ[i];
-                    CPLFree(papsPoints);
+                    CPLFree(panPoints);
                     return CE_None;
                 }
                 // is point within real distance?
@@ -322,7 +378,7 @@ GDALGridInverseDistanceToAPowerNearestNeighbor(
                 }
             }
         }
-        CPLFree(papsPoints);
+        CPLFree(panPoints);
     }
     else
     {
@@ -533,7 +589,7 @@ GDALGridInverseDistanceToAPowerNoSearch(
  * @param dfYPoint Y coordinate of the point to compute.
  * @param pdfValue Pointer to variable where the computed grid node value
  * will be returned.
- * @param hExtraParamsIn extra parameters (unused)
+ * @param hExtraParamsIn extra parameters, or NULL.
  *
  * @return CE_None on success or CE_Failure if something goes wrong.
  */
@@ -543,7 +599,7 @@ GDALGridMovingAverage( const void *poOptionsIn, GUInt32 nPoints,
                        const double *padfX, const double *padfY,
                        const double *padfZ,
                        double dfXPoint, double dfYPoint, double *pdfValue,
-                       CPL_UNUSED void * hExtraParamsIn )
+                       void * hExtraParamsIn )
 {
     // TODO: For optimization purposes pre-computed parameters should be moved
     // out of this routine to the calling function.
@@ -566,8 +622,13 @@ GDALGridMovingAverage( const void *poOptionsIn, GUInt32 nPoints,
 
     GUInt32 n = 0;  // Used after for.
 
-    for( GUInt32 i = 0; i < nPoints; i++ )
+    GUInt32 nCandidates = nPoints;
+    GUInt32* panPoints = GDALGridGetPointsInSearchEllipse(
+        hExtraParamsIn, poOptions->dfRadius1, poOptions->dfRadius2,
+        dfXPoint, dfYPoint, &nCandidates );
+    for( GUInt32 k = 0; k < nCandidates; k++ )
     {
+        const GUInt32 i = panPoints ? panPoints[k] : k;
         double dfRX = padfX[i] - dfXPoint;
         double dfRY = padfY[i] - dfYPoint;
 
@@ -587,6 +648,7 @@ GDALGridMovingAverage( const void *poOptionsIn, GUInt32 nPoints,
             n++;
         }
     }
+    CPLFree(panPoints);
 
     if( n < poOptions->nMinPoints || n == 0 )
     {
@@ -645,7 +707,7 @@ GDALGridNearestNeighbor( const void *poOptionsIn, GUInt32 nPoints,
     double dfR12 = dfRadius1 * dfRadius2;
     GDALGridExtraParameters* psExtraParams =
         static_cast<GDALGridExtraParameters *>(hExtraParamsIn);
-    CPLQuadTree* hQuadTree = psExtraParams->hQuadTree;
+    const CPLPackedRTree* poRTree = psExtraParams->poRTree;
 
     // Compute coefficients for coordinate system rotation.
     const double dfAngle = TO_RADIANS * poOptions->dfAngle;
@@ -661,7 +723,7 @@ GDALGridNearestNeighbor( const void *poOptionsIn, GUInt32 nPoints,
     GUInt32 i = 0;
 
     double dfSearchRadius = psExtraParams->dfInitialSearchRadius;
-    if( hQuadTree != nullptr && dfRadius1 == dfRadius2 && dfSearchRadius > 0 )
+    if( poRTree != nullptr && dfRadius1 == dfRadius2 && dfSearchRadius > 0 )
     {
         if( dfRadius1 > 0 )
             dfSearchRadius = poOptions->dfRadius1;
@@ -673,15 +735,15 @@ GDALGridNearestNeighbor( const void *poOptionsIn, GUInt32 nPoints,
             sAoi.maxx = dfXPoint + dfSearchRadius;
             sAoi.maxy = dfYPoint + dfSearchRadius;
             int nFeatureCount = 0;
-            GDALGridPoint** papsPoints = reinterpret_cast<GDALGridPoint **>(
-                    CPLQuadTreeSearch(hQuadTree, &sAoi, &nFeatureCount) );
+            GUInt32* panPoints =
+                GDALGridSearchPoints(psExtraParams, sAoi, &nFeatureCount);
             if( nFeatureCount != 0 )
             {
                 if( dfRadius1 > 0 )
                     dfNearestR = dfRadius1;
                 for( int k = 0; k < nFeatureCount; k++)
                 {
-                    const int idx = papsPoints[k]->i;
+                    const GUInt32 idx = panPoints[k];
                     const double dfRX = padfX[idx] - dfXPoint;
                     const double dfRY = padfY[idx] - dfYPoint;
 
@@ -693,11 +755,11 @@ GDALGridNearestNeighbor( const void *poOptionsIn, GUInt32 nPoints,
                     }
                 }
 
-                CPLFree(papsPoints);
+                CPLFree(panPoints);
                 break;
             }
 
-            CPLFree(papsPoints);
+            CPLFree(panPoints);
             if( dfRadius1 > 0 )
                 break;
             dfSearchRadius *= 2;
@@ -775,7 +837,7 @@ GDALGridNearestNeighbor( const void *poOptionsIn, GUInt32 nPoints,
  * @param dfYPoint Y coordinate of the point to compute.
  * @param pdfValue Pointer to variable where the computed grid node value
  * will be returned.
- * @param hExtraParamsIn unused.
+ * @param hExtraParamsIn extra parameters, or NULL.
  *
  * @return CE_None on success or CE_Failure if something goes wrong.
  */
@@ -785,7 +847,7 @@ GDALGridDataMetricMinimum( const void *poOptionsIn, GUInt32 nPoints,
                            const double *padfX, const double *padfY,
                            const double *padfZ,
                            double dfXPoint, double dfYPoint, double *pdfValue,
-                           CPL_UNUSED void * hExtraParamsIn )
+                           void * hExtraParamsIn )
 {
     // TODO: For optimization purposes pre-computed parameters should be moved
     // out of this routine to the calling function.
@@ -805,11 +867,15 @@ GDALGridDataMetricMinimum( const void *poOptionsIn, GUInt32 nPoints,
     const double dfCoeff2 = bRotated ? sin(dfAngle) : 0.0;
 
     double dfMinimumValue=0.0;
-    GUInt32 i = 0;
     GUInt32 n = 0;
 
-    while( i < nPoints )
+    GUInt32 nCandidates = nPoints;
+    GUInt32* panPoints = GDALGridGetPointsInSearchEllipse(
+        hExtraParamsIn, poOptions->dfRadius1, poOptions->dfRadius2,
+        dfXPoint, dfYPoint, &nCandidates );
+    for( GUInt32 k = 0; k < nCandidates; k++ )
     {
+        const GUInt32 i = panPoints ? panPoints[k] : k;
         double dfRX = padfX[i] - dfXPoint;
         double dfRY = padfY[i] - dfYPoint;
 
@@ -836,9 +902,8 @@ GDALGridDataMetricMinimum( const void *poOptionsIn, GUInt32 nPoints,
             }
             n++;
         }
-
-        i++;
     }
+    CPLFree(panPoints);
 
     if( n < poOptions->nMinPoints || n == 0 )
     {
@@ -883,7 +948,7 @@ GDALGridDataMetricMinimum( const void *poOptionsIn, GUInt32 nPoints,
  * @param dfYPoint Y coordinate of the point to compute.
  * @param pdfValue Pointer to variable where the computed grid node value
  * will be returned.
- * @param hExtraParamsIn extra parameters (unused)
+ * @param hExtraParamsIn extra parameters, or NULL.
  *
  * @return CE_None on success or CE_Failure if something goes wrong.
  */
@@ -893,7 +958,7 @@ GDALGridDataMetricMaximum( const void *poOptionsIn, GUInt32 nPoints,
                            const double *padfX, const double *padfY,
                            const double *padfZ,
                            double dfXPoint, double dfYPoint, double *pdfValue,
-                           CPL_UNUSED void* hExtraParamsIn )
+                           void * hExtraParamsIn )
 {
     // TODO: For optimization purposes pre-computed parameters should be moved
     // out of this routine to the calling function.
@@ -913,11 +978,15 @@ GDALGridDataMetricMaximum( const void *poOptionsIn, GUInt32 nPoints,
     const double dfCoeff2 = bRotated ? sin(dfAngle) : 0.0;
 
     double dfMaximumValue=0.0;
-    GUInt32 i = 0;
     GUInt32 n = 0;
 
-    while( i < nPoints )
+    GUInt32 nCandidates = nPoints;
+    GUInt32* panPoints = GDALGridGetPointsInSearchEllipse(
+        hExtraParamsIn, poOptions->dfRadius1, poOptions->dfRadius2,
+        dfXPoint, dfYPoint, &nCandidates );
+    for( GUInt32 k = 0; k < nCandidates; k++ )
     {
+        const GUInt32 i = panPoints ? panPoints[k] : k;
         double dfRX = padfX[i] - dfXPoint;
         double dfRY = padfY[i] - dfYPoint;
 
@@ -944,9 +1013,8 @@ GDALGridDataMetricMaximum( const void *poOptionsIn, GUInt32 nPoints,
             }
             n++;
         }
-
-        i++;
     }
+    CPLFree(panPoints);
 
     if( n < poOptions->nMinPoints
          || n == 0 )
@@ -993,7 +1061,7 @@ GDALGridDataMetricMaximum( const void *poOptionsIn, GUInt32 nPoints,
  * @param dfYPoint Y coordinate of the point to compute.
  * @param pdfValue Pointer to variable where the computed grid node value
  * will be returned.
- * @param hExtraParamsIn extra parameters (unused)
+ * @param hExtraParamsIn extra parameters, or NULL.
  *
  * @return CE_None on success or CE_Failure if something goes wrong.
  */
@@ -1003,7 +1071,7 @@ GDALGridDataMetricRange( const void *poOptionsIn, GUInt32 nPoints,
                          const double *padfX, const double *padfY,
                          const double *padfZ,
                          double dfXPoint, double dfYPoint, double *pdfValue,
-                         CPL_UNUSED void * hExtraParamsIn )
+                         void * hExtraParamsIn )
 {
     // TODO: For optimization purposes pre-computed parameters should be moved
     // out of this routine to the calling function.
@@ -1023,11 +1091,15 @@ GDALGridDataMetricRange( const void *poOptionsIn, GUInt32 nPoints,
 
     double dfMaximumValue = 0.0;
     double dfMinimumValue = 0.0;
-    GUInt32 i = 0;
     GUInt32 n = 0;
 
-    while( i < nPoints )
+    GUInt32 nCandidates = nPoints;
+    GUInt32* panPoints = GDALGridGetPointsInSearchEllipse(
+        hExtraParamsIn, poOptions->dfRadius1, poOptions->dfRadius2,
+        dfXPoint, dfYPoint, &nCandidates );
+    for( GUInt32 k = 0; k < nCandidates; k++ )
     {
+        const GUInt32 i = panPoints ? panPoints[k] : k;
         double dfRX = padfX[i] - dfXPoint;
         double dfRY = padfY[i] - dfYPoint;
 
@@ -1057,9 +1129,8 @@ GDALGridDataMetricRange( const void *poOptionsIn, GUInt32 nPoints,
             }
             n++;
         }
-
-        i++;
     }
+    CPLFree(panPoints);
 
     if( n < poOptions->nMinPoints || n == 0 )
     {
@@ -1102,7 +1173,7 @@ GDALGridDataMetricRange( const void *poOptionsIn, GUInt32 nPoints,
  * @param dfYPoint Y coordinate of the point to compute.
  * @param pdfValue Pointer to variable where the computed grid node value
  * will be returned.
- * @param hExtraParamsIn extra parameters (unused)
+ * @param hExtraParamsIn extra parameters, or NULL.
  *
  * @return CE_None on success or CE_Failure if something goes wrong.
  */
@@ -1112,7 +1183,7 @@ GDALGridDataMetricCount( const void *poOptionsIn, GUInt32 nPoints,
                          const double *padfX, const double *padfY,
                          CPL_UNUSED const double * padfZ,
                          double dfXPoint, double dfYPoint, double *pdfValue,
-                         CPL_UNUSED void * hExtraParamsIn )
+                         void * hExtraParamsIn )
 {
     // TODO: For optimization purposes pre-computed parameters should be moved
     // out of this routine to the calling function.
@@ -1131,11 +1202,15 @@ GDALGridDataMetricCount( const void *poOptionsIn, GUInt32 nPoints,
     const double dfCoeff1 = bRotated ? cos(dfAngle) : 0.0;
     const double dfCoeff2 = bRotated ? sin(dfAngle) : 0.0;
 
-    GUInt32 i = 0;
     GUInt32 n = 0;
 
-    while( i < nPoints )
+    GUInt32 nCandidates = nPoints;
+    GUInt32* panPoints = GDALGridGetPointsInSearchEllipse(
+        hExtraParamsIn, poOptions->dfRadius1, poOptions->dfRadius2,
+        dfXPoint, dfYPoint, &nCandidates );
+    for( GUInt32 k = 0; k < nCandidates; k++ )
     {
+        const GUInt32 i = panPoints ? panPoints[k] : k;
         double dfRX = padfX[i] - dfXPoint;
         double dfRY = padfY[i] - dfYPoint;
 
@@ -1153,9 +1228,8 @@ GDALGridDataMetricCount( const void *poOptionsIn, GUInt32 nPoints,
         {
             n++;
         }
-
-        i++;
     }
+    CPLFree(panPoints);
 
     if( n < poOptions->nMinPoints )
     {
@@ -1202,7 +1276,7 @@ GDALGridDataMetricCount( const void *poOptionsIn, GUInt32 nPoints,
  * @param dfYPoint Y coordinate of the point to compute.
  * @param pdfValue Pointer to variable where the computed grid node value
  * will be returned.
- * @param hExtraParamsIn extra parameters (unused)
+ * @param hExtraParamsIn extra parameters, or NULL.
  *
  * @return CE_None on success or CE_Failure if something goes wrong.
  */
@@ -1213,7 +1287,7 @@ GDALGridDataMetricAverageDistance( const void *poOptionsIn, GUInt32 nPoints,
                                    CPL_UNUSED const double * padfZ,
                                    double dfXPoint, double dfYPoint,
                                    double *pdfValue,
-                                   CPL_UNUSED void * hExtraParamsIn )
+                                   void * hExtraParamsIn )
 {
     // TODO: For optimization purposes pre-computed parameters should be moved
     // out of this routine to the calling function.
@@ -1233,11 +1307,15 @@ GDALGridDataMetricAverageDistance( const void *poOptionsIn, GUInt32 nPoints,
     const double dfCoeff2 = bRotated ? sin(dfAngle) : 0.0;
 
     double dfAccumulator = 0.0;
-    GUInt32 i = 0;
     GUInt32 n = 0;
 
-    while( i < nPoints )
+    GUInt32 nCandidates = nPoints;
+    GUInt32* panPoints = GDALGridGetPointsInSearchEllipse(
+        hExtraParamsIn, poOptions->dfRadius1, poOptions->dfRadius2,
+        dfXPoint, dfYPoint, &nCandidates );
+    for( GUInt32 k = 0; k < nCandidates; k++ )
     {
+        const GUInt32 i = panPoints ? panPoints[k] : k;
         double dfRX = padfX[i] - dfXPoint;
         double dfRY = padfY[i] - dfYPoint;
 
@@ -1256,9 +1334,8 @@ GDALGridDataMetricAverageDistance( const void *poOptionsIn, GUInt32 nPoints,
             dfAccumulator += sqrt( dfRX * dfRX + dfRY * dfRY );
             n++;
         }
-
-        i++;
     }
+    CPLFree(panPoints);
 
     if( n < poOptions->nMinPoints || n == 0 )
     {
@@ -1307,7 +1384,7 @@ GDALGridDataMetricAverageDistance( const void *poOptionsIn, GUInt32 nPoints,
  * @param dfYPoint Y coordinate of the point to compute.
  * @param pdfValue Pointer to variable where the computed grid node value
  * will be returned.
- * @param hExtraParamsIn extra parameters (unused)
+ * @param hExtraParamsIn extra parameters, or NULL.
  *
  * @return CE_None on success or CE_Failure if something goes wrong.
  */
@@ -1318,7 +1395,7 @@ GDALGridDataMetricAverageDistancePts( const void *poOptionsIn, GUInt32 nPoints,
                                       CPL_UNUSED const double * padfZ,
                                       double dfXPoint, double dfYPoint,
                                       double *pdfValue,
-                                      CPL_UNUSED void * hExtraParamsIn )
+                                      void * hExtraParamsIn )
 {
     // TODO: For optimization purposes pre-computed parameters should be moved
     // out of this routine to the calling function.
@@ -1337,12 +1414,16 @@ GDALGridDataMetricAverageDistancePts( const void *poOptionsIn, GUInt32 nPoints,
     const double dfCoeff2 = bRotated ? sin(dfAngle) : 0.0;
 
     double dfAccumulator = 0.0;
-    GUInt32 i = 0;
     GUInt32 n = 0;
 
+    GUInt32 nCandidates = nPoints;
+    GUInt32* panPoints = GDALGridGetPointsInSearchEllipse(
+        hExtraParamsIn, poOptions->dfRadius1, poOptions->dfRadius2,
+        dfXPoint, dfYPoint, &nCandidates );
     // Search for the first point within the search ellipse.
-    while( i < nPoints - 1 )
+    for( GUInt32 k = 0; k + 1 < nCandidates; k++ )
     {
+        const GUInt32 i = panPoints ? panPoints[k] : k;
         double dfRX1 = padfX[i] - dfXPoint;
         double dfRY1 = padfY[i] - dfYPoint;
 
@@ -1360,8 +1441,9 @@ GDALGridDataMetricAverageDistancePts( const void *poOptionsIn, GUInt32 nPoints,
         {
             // Search all the remaining points within the ellipse and compute
             // distances between them and the first point.
-            for( GUInt32 j = i + 1; j < nPoints; j++ )
+            for( GUInt32 l = k + 1; l < nCandidates; l++ )
             {
+                const GUInt32 j = panPoints ? panPoints[l] : l;
                 double dfRX2 = padfX[j] - dfXPoint;
                 double dfRY2 = padfY[j] - dfYPoint;
 
@@ -1387,9 +1469,8 @@ GDALGridDataMetricAverageDistancePts( const void *poOptionsIn, GUInt32 nPoints,
                 }
             }
         }
-
-        i++;
     }
+    CPLFree(panPoints);
 
     if( n < poOptions->nMinPoints || n == 0 )
     {
@@ -1674,8 +1755,6 @@ struct GDALGridContext
     GDALGridFunction    pfnGDALGridMethod;
 
     GUInt32             nPoints;
-    GDALGridPoint      *pasGridPoints;
-    GDALGridXYArrays    sXYArrays;
 
     GDALGridExtraParameters sExtraParameters;
     double*             padfX;
@@ -1686,7 +1765,26 @@ struct GDALGridContext
     CPLWorkerThreadPool *poWorkerThreadPool;
 };
 
-static void GDALGridContextCreateQuadTree( GDALGridContext* psContext );
+static void GDALGridContextCreateSpatialIndex( GDALGridContext* psContext );
+
+// Whether algorithms that only consider the points of a search ellipse
+// should look for them with a packed R-tree rather than scanning all points.
+static bool GDALGridUseSpatialIndexForSearchEllipse( GUInt32 nPoints,
+                                                     double dfRadius1,
+                                                     double dfRadius2 )
+{
+    if( nPoints <= 100 || !(dfRadius1 > 0.0) || !(dfRadius2 > 0.0) )
+        return false;
+    const char* pszUseSpatialIndex =
+        CPLGetConfigOption("GDAL_GRID_USE_SPATIAL_INDEX", nullptr);
+    if( pszUseSpatialIndex == nullptr )
+    {
+        // Deprecated name of the option in GDAL 3.4 development versions.
+        pszUseSpatialIndex =
+            CPLGetConfigOption("GDAL_GRID_USE_QUADTREE", "YES");
+    }
+    return CPLTestBool(pszUseSpatialIndex);
+}
 
 /**
  * Creates a context to do regular gridding from the scattered data.
@@ -1705,7 +1803,15 @@ static void GDALGridContextCreateQuadTree( GDALGridContext* psContext );
  * GDAL_USE_SSE configuration option to NO.
  * A further optimized version can use the AVX
  * instruction set. This can be disabled by setting the GDAL_USE_AVX
- * configuration option to NO.
+ * configuration option to NO. Starting with GDAL 3.4, a version using the
+ * AVX-512 instruction set is used when available. This can be disabled by
+ * setting the GDAL_USE_AVX512 configuration option to NO.
+ *
+ * Algorithms that only consider the points inside a search ellipse
+ * ('invdist' with a radius, 'average' and the data metrics) use a packed
+ * R-tree to find them when both radii are set, instead of scanning all the
+ * points for each grid node (GDAL >= 3.4). This can be disabled by setting the
+ * GDAL_GRID_USE_SPATIAL_INDEX configuration option to NO.
  *
  * It is possible to set the GDAL_NUM_THREADS
  * configuration option to parallelize the processing. The value to set is
@@ -1771,9 +1877,51 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
                 pfnGDALGridMethod = GDALGridInverseDistanceToAPowerNoSearch;
                 if( dfPower == 2.0 && dfSmoothing == 0.0 )
                 {
-#ifdef HAVE_AVX_AT_COMPILE_TIME
+#ifdef HAVE_AVX512_AT_COMPILE_TIME
 
                     if( CPLTestBool(
+                            CPLGetConfigOption("GDAL_USE_AVX512", "YES")) &&
+                        CPLHaveRuntimeAVX512() )
+                    {
+                        pafXAligned = static_cast<float *>(
+                            VSI_MALLOC_ALIGNED_AUTO_VERBOSE(
+                                sizeof(float) * nPoints) );
+                        pafYAligned = static_cast<float *>(
+                            VSI_MALLOC_ALIGNED_AUTO_VERBOSE(
+                                sizeof(float) * nPoints) );
+                        pafZAligned = static_cast<float *>(
+                            VSI_MALLOC_ALIGNED_AUTO_VERBOSE(
+                                sizeof(float) * nPoints) );
+                        if( pafXAligned != nullptr && pafYAligned != nullptr &&
+                            pafZAligned != nullptr )
+                        {
+                            CPLDebug("GDAL_GRID",
+                                     "Using AVX-512 optimized version");
+                            pfnGDALGridMethod =
+                                GDALGridInverseDistanceToAPower2NoSmoothingNoSearchAVX512;
+                            for( GUInt32 i = 0; i < nPoints; i++ )
+                            {
+                                pafXAligned[i] = static_cast<float>(padfX[i]);
+                                pafYAligned[i] = static_cast<float>(padfY[i]);
+                                pafZAligned[i] = static_cast<float>(padfZ[i]);
+                            }
+                        }
+                        else
+                        {
+                            VSIFree(pafXAligned);
+                            VSIFree(pafYAligned);
+                            VSIFree(pafZAligned);
+                            pafXAligned = nullptr;
+                            pafYAligned = nullptr;
+                            pafZAligned = nullptr;
+                        }
+                    }
+#endif
+
+#ifdef HAVE_AVX_AT_COMPILE_TIME
+
+                    if( pafXAligned == nullptr &&
+                        CPLTestBool(
                             CPLGetConfigOption("GDAL_USE_AVX", "YES")) &&
                         CPLHaveRuntimeAVX() )
                     {
@@ -1858,6 +2006,8 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
             else
             {
                 pfnGDALGridMethod = GDALGridInverseDistanceToAPower;
+                bCreateQuadTree = GDALGridUseSpatialIndexForSearchEllipse(
+                    nPoints, poPower->dfRadius1, poPower->dfRadius2);
             }
             break;
         }
@@ -1881,6 +2031,10 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
                    sizeof(GDALGridMovingAverageOptions));
 
             pfnGDALGridMethod = GDALGridMovingAverage;
+            bCreateQuadTree = GDALGridUseSpatialIndexForSearchEllipse(
+                nPoints,
+                static_cast<const GDALGridMovingAverageOptions *>(poOptions)->dfRadius1,
+                static_cast<const GDALGridMovingAverageOptions *>(poOptions)->dfRadius2);
             break;
         }
         case GGA_NearestNeighbor:
@@ -1901,6 +2055,10 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
             memcpy(poOptionsNew, poOptions, sizeof(GDALGridDataMetricsOptions));
 
             pfnGDALGridMethod = GDALGridDataMetricMinimum;
+            bCreateQuadTree = GDALGridUseSpatialIndexForSearchEllipse(
+                nPoints,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius1,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius2);
             break;
         }
         case GGA_MetricMaximum:
@@ -1909,6 +2067,10 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
             memcpy(poOptionsNew, poOptions, sizeof(GDALGridDataMetricsOptions));
 
             pfnGDALGridMethod = GDALGridDataMetricMaximum;
+            bCreateQuadTree = GDALGridUseSpatialIndexForSearchEllipse(
+                nPoints,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius1,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius2);
             break;
         }
         case GGA_MetricRange:
@@ -1917,6 +2079,10 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
             memcpy(poOptionsNew, poOptions, sizeof(GDALGridDataMetricsOptions));
 
             pfnGDALGridMethod = GDALGridDataMetricRange;
+            bCreateQuadTree = GDALGridUseSpatialIndexForSearchEllipse(
+                nPoints,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius1,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius2);
             break;
         }
         case GGA_MetricCount:
@@ -1925,6 +2091,10 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
             memcpy(poOptionsNew, poOptions, sizeof(GDALGridDataMetricsOptions));
 
             pfnGDALGridMethod = GDALGridDataMetricCount;
+            bCreateQuadTree = GDALGridUseSpatialIndexForSearchEllipse(
+                nPoints,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius1,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius2);
             break;
         }
         case GGA_MetricAverageDistance:
@@ -1933,6 +2103,10 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
             memcpy(poOptionsNew, poOptions, sizeof(GDALGridDataMetricsOptions));
 
             pfnGDALGridMethod = GDALGridDataMetricAverageDistance;
+            bCreateQuadTree = GDALGridUseSpatialIndexForSearchEllipse(
+                nPoints,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius1,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius2);
             break;
         }
         case GGA_MetricAverageDistancePts:
@@ -1941,6 +2115,10 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
             memcpy(poOptionsNew, poOptions, sizeof(GDALGridDataMetricsOptions));
 
             pfnGDALGridMethod = GDALGridDataMetricAverageDistancePts;
+            bCreateQuadTree = GDALGridUseSpatialIndexForSearchEllipse(
+                nPoints,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius1,
+                static_cast<const GDALGridDataMetricsOptions *>(poOptions)->dfRadius2);
             break;
         }
         case GGA_Linear:
@@ -1986,10 +2164,7 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
     psContext->poOptions = poOptionsNew;
     psContext->pfnGDALGridMethod = pfnGDALGridMethod;
     psContext->nPoints = nPoints;
-    psContext->pasGridPoints = nullptr;
-    psContext->sXYArrays.padfX = padfX;
-    psContext->sXYArrays.padfY = padfY;
-    psContext->sExtraParameters.hQuadTree = nullptr;
+    psContext->sExtraParameters.poRTree = nullptr;
     psContext->sExtraParameters.dfInitialSearchRadius = 0.0;
     psContext->sExtraParameters.pafX = pafXAligned;
     psContext->sExtraParameters.pafY = pafYAligned;
@@ -2003,11 +2178,11 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
         pafXAligned ? false : !bCallerWillKeepPointArraysAlive;
 
 /* -------------------------------------------------------------------- */
-/*  Create quadtree if requested and possible.                          */
+/*  Create spatial index if requested and possible.                     */
 /* -------------------------------------------------------------------- */
     if( bCreateQuadTree )
     {
-        GDALGridContextCreateQuadTree(psContext);
+        GDALGridContextCreateSpatialIndex(psContext);
     }
 
     /* -------------------------------------------------------------------- */
@@ -2069,50 +2244,56 @@ GDALGridContextCreate( GDALGridAlgorithm eAlgorithm, const void *poOptions,
 }
 
 /************************************************************************/
-/*                      GDALGridContextCreateQuadTree()                 */
+/*                    GDALGridContextCreateSpatialIndex()               */
 /************************************************************************/
 
-void GDALGridContextCreateQuadTree( GDALGridContext* psContext )
+void GDALGridContextCreateSpatialIndex( GDALGridContext* psContext )
 {
     const GUInt32 nPoints = psContext->nPoints;
-    psContext->pasGridPoints = static_cast<GDALGridPoint *>(
-            VSI_MALLOC2_VERBOSE(nPoints, sizeof(GDALGridPoint)) );
-    if( psContext->pasGridPoints != nullptr )
-    {
-        const double * const padfX = psContext->padfX;
-        const double * const padfY = psContext->padfY;
-
-        // Determine point extents.
-        CPLRectObj sRect;
-        sRect.minx = padfX[0];
-        sRect.miny = padfY[0];
-        sRect.maxx = padfX[0];
-        sRect.maxy = padfY[0];
-        for( GUInt32 i = 1; i < nPoints; i++ )
-        {
-            if( padfX[i] < sRect.minx ) sRect.minx = padfX[i];
-            if( padfY[i] < sRect.miny ) sRect.miny = padfY[i];
-            if( padfX[i] > sRect.maxx ) sRect.maxx = padfX[i];
-            if( padfY[i] > sRect.maxy ) sRect.maxy = padfY[i];
-        }
-
-        // Initial value for search radius is the typical dimension of a
-        // "pixel" of the point array (assuming rather uniform distribution).
-        psContext->sExtraParameters.dfInitialSearchRadius =
-            sqrt((sRect.maxx - sRect.minx) *
-                 (sRect.maxy - sRect.miny) / nPoints);
-
-        psContext->sExtraParameters.hQuadTree =
-            CPLQuadTreeCreate(&sRect, GDALGridGetPointBounds );
+    const double * const padfX = psContext->padfX;
+    const double * const padfY = psContext->padfY;
 
+    // Points are all known beforehand and the index is queried for each
+    // grid node, so a bulk loaded packed R-tree is used.
+    try
+    {
+        std::vector<CPLRectObj> asBounds(nPoints);
         for( GUInt32 i = 0; i < nPoints; i++ )
         {
-            psContext->pasGridPoints[i].psXYArrays = &(psContext->sXYArrays);
-            psContext->pasGridPoints[i].i = i;
-            CPLQuadTreeInsert(psContext->sExtraParameters.hQuadTree,
-                                psContext->pasGridPoints + i);
+            asBounds[i].minx = padfX[i];
+            asBounds[i].miny = padfY[i];
+            asBounds[i].maxx = padfX[i];
+            asBounds[i].maxy = padfY[i];
         }
+        psContext->sExtraParameters.poRTree =
+            new CPLPackedRTree(asBounds.data(), asBounds.size());
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate spatial index of gridding points");
+        return;
     }
+
+    // Determine point extents.
+    CPLRectObj sRect;
+    sRect.minx = padfX[0];
+    sRect.miny = padfY[0];
+    sRect.maxx = padfX[0];
+    sRect.maxy = padfY[0];
+    for( GUInt32 i = 1; i < nPoints; i++ )
+    {
+        if( padfX[i] < sRect.minx ) sRect.minx = padfX[i];
+        if( padfY[i] < sRect.miny ) sRect.miny = padfY[i];
+        if( padfX[i] > sRect.maxx ) sRect.maxx = padfX[i];
+        if( padfY[i] > sRect.maxy ) sRect.maxy = padfY[i];
+    }
+
+    // Initial value for search radius is the typical dimension of a
+    // "pixel" of the point array (assuming rather uniform distribution).
+    psContext->sExtraParameters.dfInitialSearchRadius =
+        sqrt((sRect.maxx - sRect.minx) *
+             (sRect.maxy - sRect.miny) / nPoints);
 }
 
 /************************************************************************/
@@ -2131,9 +2312,7 @@ void GDALGridContextFree( GDALGridContext* psContext )
     if( psContext )
     {
         CPLFree( psContext->poOptions );
-        CPLFree( psContext->pasGridPoints );
-        if( psContext->sExtraParameters.hQuadTree != nullptr )
-            CPLQuadTreeDestroy( psContext->sExtraParameters.hQuadTree );
+        delete psContext->sExtraParameters.poRTree;
         if( psContext->bFreePadfXYZArrays )
         {
             CPLFree(psContext->padfX);
@@ -2203,7 +2382,7 @@ CPLErr GDALGridContextProcess(
     // by sampling along the edges.  If all points on edges are within
     // triangles, then interior points will also be.
     if( psContext->eAlgorithm == GGA_Linear &&
-        psContext->sExtraParameters.hQuadTree == nullptr )
+        psContext->sExtraParameters.poRTree == nullptr )
     {
         bool bNeedNearest = false;
         int nStartLeft = 0;
@@ -2261,7 +2440,7 @@ CPLErr GDALGridContextProcess(
         if( bNeedNearest )
         {
             CPLDebug("GDAL_GRID", "Will need nearest neighbour");
-            GDALGridContextCreateQuadTree(psContext);
+            GDALGridContextCreateSpatialIndex(psContext);
         }
     }
 
@@ -2390,7 +2569,9 @@ CPLErr GDALGridContextProcess(
  * GDAL_USE_SSE configuration option to NO.
  * Starting with GDAL 1.11, a further optimized version can use the AVX
  * instruction set. This can be disabled by setting the GDAL_USE_AVX
- * configuration option to NO.
+ * configuration option to NO. Starting with GDAL 3.4, a version using the
+ * AVX-512 instruction set is used when available. This can be disabled by
+ * setting the GDAL_USE_AVX512 configuration option to NO.
  *
  * Note: it will be more efficient to use GDALGridContextCreate(),
  * GDALGridContextProcess() and GDALGridContextFree() when doing repeated
@@ -31,25 +31,13 @@
 #define GDALGRID_PRIV_H
 
 #include "cpl_error.h"
-#include "cpl_quad_tree.h"
+#include "cpl_packed_rtree.h"
 
 //! @cond Doxygen_Suppress
 
 typedef struct
 {
-    const double* padfX;
-    const double* padfY;
-} GDALGridXYArrays;
-
-typedef struct
-{
-    GDALGridXYArrays* psXYArrays;
-    int               i;
-} GDALGridPoint;
-
-typedef struct
-{
-    CPLQuadTree* hQuadTree;
+    CPLPackedRTree* poRTree;
     double       dfInitialSearchRadius;
     float *pafX; // Aligned to be usable with AVX
     float *pafY;
@@ -89,6 +77,18 @@ CPLErr GDALGridInverseDistanceToAPower2NoSmoothingNoSearchAVX(
                                         void* hExtraParamsIn );
 #endif
 
+#ifdef HAVE_AVX512_AT_COMPILE_TIME
+CPLErr GDALGridInverseDistanceToAPower2NoSmoothingNoSearchAVX512(
+                                        const void *poOptions,
+                                        GUInt32 nPoints,
+                                        const double *unused_padfX,
+                                        const double *unused_padfY,
+                                        const double *unused_padfZ,
+                                        double dfXPoint, double dfYPoint,
+                                        double *pdfValue,
+                                        void* hExtraParamsIn );
+#endif
+
 //! @endcond
 
 #endif // GDALGRID_PRIV_H
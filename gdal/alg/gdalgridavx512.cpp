@@ -0,0 +1,154 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Gridding API.
+ * Purpose:  Implementation of GDAL scattered data gridder.
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdalgrid.h"
+#include "gdalgrid_priv.h"
+
+#ifdef HAVE_AVX512_AT_COMPILE_TIME
+#include <immintrin.h>
+
+CPL_CVSID("$Id$")
+
+/************************************************************************/
+/*       GDALGridInverseDistanceToAPower2NoSmoothingNoSearchAVX512()    */
+/************************************************************************/
+
+CPLErr
+GDALGridInverseDistanceToAPower2NoSmoothingNoSearchAVX512(
+    const void *poOptions,
+    GUInt32 nPoints,
+    CPL_UNUSED const double *unused_padfX,
+    CPL_UNUSED const double *unused_padfY,
+    CPL_UNUSED const double *unused_padfZ,
+    double dfXPoint, double dfYPoint,
+    double *pdfValue,
+    void* hExtraParamsIn )
+{
+    size_t i = 0;
+    GDALGridExtraParameters* psExtraParams = static_cast<GDALGridExtraParameters*>(hExtraParamsIn);
+    const float* pafX = psExtraParams->pafX;
+    const float* pafY = psExtraParams->pafY;
+    const float* pafZ = psExtraParams->pafZ;
+
+    const float fEpsilon = 0.0000000000001f;
+    const float fXPoint = static_cast<float>(dfXPoint);
+    const float fYPoint = static_cast<float>(dfYPoint);
+    const __m512 zmm_small = _mm512_set1_ps(fEpsilon);
+    const __m512 zmm_x = _mm512_set1_ps(fXPoint);
+    const __m512 zmm_y = _mm512_set1_ps(fYPoint);
+    __m512 zmm_nominator = _mm512_setzero_ps();
+    __m512 zmm_denominator = _mm512_setzero_ps();
+    unsigned int mask = 0;
+
+    // pafX, pafY and pafZ are aligned on 64 bytes by VSIMallocAlignedAuto().
+#define LOOP_SIZE   32
+    size_t nPointsRound = (nPoints / LOOP_SIZE) * LOOP_SIZE;
+    for( i = 0; i < nPointsRound; i += LOOP_SIZE )
+    {
+        __m512 zmm_rx = _mm512_sub_ps(_mm512_load_ps(pafX + i), zmm_x);            /* rx = pafX[i] - fXPoint */
+        __m512 zmm_rx_16 = _mm512_sub_ps(_mm512_load_ps(pafX + i + 16), zmm_x);
+        __m512 zmm_ry = _mm512_sub_ps(_mm512_load_ps(pafY + i), zmm_y);            /* ry = pafY[i] - fYPoint */
+        __m512 zmm_ry_16 = _mm512_sub_ps(_mm512_load_ps(pafY + i + 16), zmm_y);
+        __m512 zmm_r2 = _mm512_add_ps(_mm512_mul_ps(zmm_rx, zmm_rx),               /* r2 = rx * rx + ry * ry */
+                                      _mm512_mul_ps(zmm_ry, zmm_ry));
+        __m512 zmm_r2_16 = _mm512_add_ps(_mm512_mul_ps(zmm_rx_16, zmm_rx_16),
+                                         _mm512_mul_ps(zmm_ry_16, zmm_ry_16));
+        __m512 zmm_invr2 = _mm512_rcp14_ps(zmm_r2);                               /* invr2 = 1.0f / r2 */
+        __m512 zmm_invr2_16 = _mm512_rcp14_ps(zmm_r2_16);
+        zmm_nominator = _mm512_add_ps(zmm_nominator,                            /* nominator += invr2 * pafZ[i] */
+                            _mm512_mul_ps(zmm_invr2, _mm512_load_ps(pafZ + i)));
+        zmm_nominator = _mm512_add_ps(zmm_nominator,
+                            _mm512_mul_ps(zmm_invr2_16, _mm512_load_ps(pafZ + i + 16)));
+        zmm_denominator = _mm512_add_ps(zmm_denominator, zmm_invr2);           /* denominator += invr2 */
+        zmm_denominator = _mm512_add_ps(zmm_denominator, zmm_invr2_16);
+        mask = static_cast<unsigned int>(_mm512_cmp_ps_mask(zmm_r2, zmm_small, _CMP_LT_OS)) |           /* if( r2 < fEpsilon) */
+              (static_cast<unsigned int>(_mm512_cmp_ps_mask(zmm_r2_16, zmm_small, _CMP_LT_OS)) << 16);
+        if( mask )
+            break;
+    }
+
+    // Find which i triggered r2 < fEpsilon.
+    if( mask )
+    {
+        for( int j = 0; j < LOOP_SIZE; j++ )
+        {
+            if( mask & (1U << j) )
+            {
+                (*pdfValue) = (pafZ)[i + j];
+
+                _mm256_zeroupper();
+                return CE_None;
+            }
+        }
+    }
+#undef LOOP_SIZE
+
+    float fNominator = _mm512_reduce_add_ps(zmm_nominator);
+    float fDenominator = _mm512_reduce_add_ps(zmm_denominator);
+
+    // Clear upper bits before the compiler possibly emits SSE code.
+    _mm256_zeroupper();
+
+    // Do the few remaining loop iterations.
+    for( ; i < nPoints; i++ )
+    {
+        const float fRX = pafX[i] - fXPoint;
+        const float fRY = pafY[i] - fYPoint;
+        const float fR2 =
+            fRX * fRX + fRY * fRY;
+
+        // If the test point is close to the grid node, use the point
+        // value directly as a node value to avoid singularity.
+        if( fR2 < 0.0000000000001 )
+        {
+            break;
+        }
+        else
+        {
+            const float fInvR2 = 1.0f / fR2;
+            fNominator += fInvR2 * pafZ[i];
+            fDenominator += fInvR2;
+        }
+    }
+
+    if( i != nPoints )
+    {
+        (*pdfValue) = pafZ[i];
+    }
+    else
+    if( fDenominator == 0.0 )
+    {
+        (*pdfValue) =
+            static_cast<const GDALGridInverseDistanceToAPowerOptions*>(poOptions)->dfNoDataValue;
+    }
+    else
+        (*pdfValue) = fNominator / fDenominator;
+
+    return CE_None;
+}
+
+#endif /* HAVE_AVX512_AT_COMPILE_TIME */
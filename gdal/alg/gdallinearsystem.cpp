@@ -39,6 +39,7 @@
 
 #include "cpl_port.h"
 #include "cpl_conv.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdallinearsystem.h"
 
 #ifdef HAVE_ARMADILLO
@@ -49,15 +50,49 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <memory>
 
 CPL_CVSID("$Id$")
 
 #ifndef HAVE_ARMADILLO
 namespace
 {
+    // Below that number of remaining rows, the update of the trailing
+    // sub-matrix is too cheap to be worth dispatching to worker threads.
+    constexpr int MIN_ROWS_FOR_PARALLEL_UPDATE = 128;
+
+    struct LUUpdateJob
+    {
+        GDALMatrix *pA = nullptr;
+        int step = 0;
+        int iColStart = 0;
+        int iColEnd = 0;
+    };
+
+    // Update of the columns [iColStart, iColEnd[ of the trailing sub-matrix.
+    // Each column is only written by one job, and the order of the
+    // operations on a given element is the same as in the serial code,
+    // so the result does not depend on the number of threads.
+    void LUUpdateColumns( void* pData )
+    {
+        const LUUpdateJob* psJob = static_cast<const LUUpdateJob*>(pData);
+        GDALMatrix& A = *(psJob->pA);
+        const int m = A.getNumRows();
+        const int step = psJob->step;
+        for(int iCol = psJob->iColStart; iCol < psJob->iColEnd; ++iCol)
+        {
+            const double dfPivotRowVal = A(step, iCol);
+            for(int iRow = step + 1; iRow < m; ++iRow)
+            {
+                A(iRow, iCol) -= A(iRow, step) * dfPivotRowVal;
+            }
+        }
+    }
+
     // LU decomposition of the quadratic matrix A
     // see https://en.wikipedia.org/wiki/LU_decomposition#C_code_examples
-    bool solve( GDALMatrix & A, GDALMatrix & RHS, GDALMatrix & X, double eps )
+    bool solve( GDALMatrix & A, GDALMatrix & RHS, GDALMatrix & X, double eps,
+                int nThreads )
     {
         assert(A.getNumRows() == A.getNumCols());
         if(eps < 0) return false;
@@ -68,6 +103,21 @@ namespace
         for(int iRow = 0; iRow < m; ++iRow)
             perm[iRow] = iRow;
 
+        std::unique_ptr<CPLWorkerThreadPool> poPool;
+        if( nThreads > 1 && m >= 2 * MIN_ROWS_FOR_PARALLEL_UPDATE )
+        {
+            poPool.reset(new CPLWorkerThreadPool());
+            if( !poPool->Setup(nThreads, nullptr, nullptr) )
+                poPool.reset();
+        }
+        std::vector<LUUpdateJob> asJobs(poPool ? nThreads : 0);
+        std::vector<void*> apJobs(asJobs.size());
+        for( size_t i = 0; i < asJobs.size(); ++i )
+        {
+            asJobs[i].pA = &A;
+            apJobs[i] = &asJobs[i];
+        }
+
         for(int step = 0; step < m - 1; ++step)
         {
             // determine pivot element
@@ -99,12 +149,28 @@ namespace
             {
                 A(iRow, step) /= A(step, step);
             }
-            for(int iCol = step + 1; iCol < m; ++iCol)
+            if( poPool && m - step >= MIN_ROWS_FOR_PARALLEL_UPDATE )
             {
-                for(int iRow = step + 1; iRow < m; ++iRow)
+                const int nCols = m - (step + 1);
+                for( int i = 0; i < nThreads; ++i )
                 {
-                    A(iRow, iCol) -= A(iRow, step) * A(step, iCol);
+                    asJobs[i].step = step;
+                    asJobs[i].iColStart = step + 1 +
+                        static_cast<int>(static_cast<GIntBig>(nCols) * i / nThreads);
+                    asJobs[i].iColEnd = step + 1 +
+                        static_cast<int>(static_cast<GIntBig>(nCols) * (i + 1) / nThreads);
                 }
+                poPool->SubmitJobs(LUUpdateColumns, apJobs);
+                poPool->WaitCompletion();
+            }
+            else
+            {
+                LUUpdateJob sJob;
+                sJob.pA = &A;
+                sJob.step = step;
+                sJob.iColStart = step + 1;
+                sJob.iColEnd = m;
+                LUUpdateColumns(&sJob);
             }
         }
 
@@ -137,12 +203,20 @@ namespace
 /*                                                                      */
 /*   Solves the linear system A*X_i = RHS_i for each column i           */
 /*   where A is a square matrix.                                        */
+/*                                                                      */
+/*   nThreads is the number of threads that may be used for the LU      */
+/*   decomposition when GDAL is not built against Armadillo (which      */
+/*   relies on its own BLAS/LAPACK threading).                          */
 /************************************************************************/
-bool GDALLinearSystemSolve( GDALMatrix  & A, GDALMatrix  & RHS, GDALMatrix & X )
+bool GDALLinearSystemSolve( GDALMatrix  & A, GDALMatrix  & RHS, GDALMatrix & X,
+                            int nThreads )
 {
     assert(A.getNumRows() == RHS.getNumRows());
     assert(A.getNumCols() == X.getNumRows());
     assert(RHS.getNumCols() == X.getNumCols());
+#ifdef HAVE_ARMADILLO
+    CPL_IGNORE_RET_VAL(nThreads);
+#endif
     try
     {
 #ifdef HAVE_ARMADILLO
@@ -158,7 +232,7 @@ bool GDALLinearSystemSolve( GDALMatrix  & A, GDALMatrix  & RHS, GDALMatrix & X )
 #endif
 
 #else //HAVE_ARMADILLO
-        return solve(A, RHS, X, 0);
+        return solve(A, RHS, X, 0, nThreads);
 #endif
     }
     catch(std::exception const & e) {
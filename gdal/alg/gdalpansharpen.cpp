@@ -46,6 +46,7 @@
 #include "../frmts/vrt/vrtdataset.h"
 #include "gdal_priv.h"
 #include "gdal_priv_templates.hpp"
+#include "gdal_thread_pool.h"
 // #include "gdalsse_priv.h"
 
 // Limit types to practical use cases.
@@ -177,7 +178,6 @@ GDALPansharpenOperation::~GDALPansharpenOperation()
     GDALDestroyPansharpenOptions(psOptions);
     for( size_t i = 0; i < aVDS.size(); i++ )
         delete aVDS[i];
-    delete poThreadPool;
 }
 
 /************************************************************************/
@@ -385,14 +385,10 @@ GDALPansharpenOperation::Initialize( const GDALPansharpenOptions* psOptionsIn )
     if( nThreads > 1 )
     {
         CPLDebug("PANSHARPEN", "Using %d threads", nThreads);
-        poThreadPool = new (std::nothrow) CPLWorkerThreadPool();
         // coverity[tainted_data]
-        if( poThreadPool == nullptr ||
-            !poThreadPool->Setup( nThreads, nullptr, nullptr ) )
-        {
-            delete poThreadPool;
-            poThreadPool = nullptr;
-        }
+        poThreadPool = GDALGetGlobalThreadPool(nThreads);
+        if( poThreadPool )
+            nPoolThreads = nThreads;
     }
 
     GDALRIOResampleAlg eResampleAlg = psOptions->eResampleAlg;
@@ -554,8 +550,9 @@ void GDALPansharpenOperation::WeightedBrovey3(
 }
 
 /* We restrict to 64bit processors because they are guaranteed to have SSE2 */
-/* Could possibly be used too on 32bit, but we would need to check at runtime */
-#if defined(__x86_64) || defined(_M_X64)
+/* (or NEON on AArch64). Could possibly be used too on 32bit, but we would */
+/* need to check at runtime */
+#if defined(__x86_64) || defined(_M_X64) || defined(__aarch64__)
 
 #include "gdalsse_priv.h"
 
@@ -1020,6 +1017,73 @@ static void ClampValues( T* panBuffer, size_t nValues, T nMaxVal )
     }
 }
 
+/************************************************************************/
+/*                        ClampSpectralValues()                         */
+/************************************************************************/
+
+static void ClampSpectralValues( GDALDataType eWorkDataType,
+                                 const std::vector<int>& anBandsToClamp,
+                                 void* pUpsampledSpectralBuffer,
+                                 size_t nValues, size_t nBandValues,
+                                 GUInt32 nMaxValue )
+{
+    for( const int iBand : anBandsToClamp )
+    {
+        const size_t nOffset = static_cast<size_t>(iBand) * nBandValues;
+        if( eWorkDataType == GDT_Byte )
+        {
+            ClampValues(static_cast<GByte*>(pUpsampledSpectralBuffer) + nOffset,
+                        nValues, static_cast<GByte>(nMaxValue));
+        }
+        else if( eWorkDataType == GDT_UInt16 )
+        {
+            ClampValues(static_cast<GUInt16*>(pUpsampledSpectralBuffer) + nOffset,
+                        nValues, static_cast<GUInt16>(nMaxValue));
+        }
+#ifndef LIMIT_TYPES
+        else if( eWorkDataType == GDT_UInt32 )
+        {
+            ClampValues(static_cast<GUInt32*>(pUpsampledSpectralBuffer) + nOffset,
+                        nValues, nMaxValue);
+        }
+#endif
+    }
+}
+
+/************************************************************************/
+/*                           GetWorkBuffer()                            */
+/************************************************************************/
+
+constexpr size_t MAX_KEPT_WORK_BUFFER_SIZE = 64 * 1024 * 1024;
+
+// Grow (if needed) a working buffer of nXSize * nYSize * nBytesPerPixel bytes.
+static GByte* GetWorkBuffer( std::vector<GByte>& abyBuffer,
+                             int nXSize, int nYSize, size_t nBytesPerPixel )
+{
+    const GUIntBig nPixels = static_cast<GUIntBig>(nXSize) * nYSize;
+    const GUIntBig nSize = nPixels * nBytesPerPixel;
+    if( nBytesPerPixel != 0 &&
+        (nSize / nBytesPerPixel != nPixels ||
+         static_cast<GUIntBig>(static_cast<size_t>(nSize)) != nSize) )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Out of memory error while allocating working buffers");
+        return nullptr;
+    }
+    try
+    {
+        if( abyBuffer.size() < static_cast<size_t>(nSize) )
+            abyBuffer.resize(static_cast<size_t>(nSize));
+    }
+    catch( const std::exception& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Out of memory error while allocating working buffers");
+        return nullptr;
+    }
+    return abyBuffer.data();
+}
+
 /************************************************************************/
 /*                         ProcessRegion()                              */
 /************************************************************************/
@@ -1056,7 +1120,6 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
     if( psOptions == nullptr )
         return CE_Failure;
 
-    // TODO: Avoid allocating buffers each time.
     GDALRasterBand* poPanchroBand = GDALRasterBand::FromHandle(
                                                     psOptions->hPanchroBand);
     GDALDataType eWorkDataType = poPanchroBand->GetRasterDataType();
@@ -1065,33 +1128,25 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
         eWorkDataType = GDT_Float64;
 #endif
     const int nDataTypeSize = GDALGetDataTypeSizeBytes(eWorkDataType);
-    GByte* pUpsampledSpectralBuffer = static_cast<GByte *>(
-        VSI_MALLOC3_VERBOSE(nXSize, nYSize,
-                            psOptions->nInputSpectralBands * nDataTypeSize));
-    GByte* pPanBuffer = static_cast<GByte *>(
-        VSI_MALLOC3_VERBOSE(nXSize, nYSize, nDataTypeSize));
+    GByte* pUpsampledSpectralBuffer = GetWorkBuffer(
+        abyUpsampledSpectralBuffer, nXSize, nYSize,
+        static_cast<size_t>(psOptions->nInputSpectralBands) * nDataTypeSize);
+    GByte* pPanBuffer = GetWorkBuffer(abyPanBuffer, nXSize, nYSize,
+                                      nDataTypeSize);
     if( pUpsampledSpectralBuffer == nullptr || pPanBuffer == nullptr )
-    {
-        VSIFree(pUpsampledSpectralBuffer);
-        VSIFree(pPanBuffer);
         return CE_Failure;
-    }
 
     CPLErr eErr =
         poPanchroBand->RasterIO(GF_Read,
                 nXOff, nYOff, nXSize, nYSize, pPanBuffer, nXSize, nYSize,
                 eWorkDataType, 0, 0, nullptr);
     if( eErr != CE_None )
-    {
-        VSIFree(pUpsampledSpectralBuffer);
-        VSIFree(pPanBuffer);
         return CE_Failure;
-    }
 
     int nTasks = 0;
     if( poThreadPool )
     {
-        nTasks = poThreadPool->GetThreadCount();
+        nTasks = nPoolThreads;
         if( nTasks > nYSize )
             nTasks = nYSize;
     }
@@ -1125,6 +1180,85 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
     if( nSpectralYSize == 0 )
         nSpectralYSize = 1;
 
+    // In case NBITS was not set on the spectral bands, clamp the values
+    // if overshoot might have occurred.
+    const int nBitDepth = psOptions->nBitDepth;
+    std::vector<int> anBandsToClamp;
+    if( nBitDepth && (eResampleAlg == GRIORA_Cubic ||
+                      eResampleAlg == GRIORA_CubicSpline ||
+                      eResampleAlg == GRIORA_Lanczos) )
+    {
+        for( int i = 0; i < psOptions->nInputSpectralBands; i++ )
+        {
+            GDALRasterBand* poBand = aMSBands[i];
+            int nBandBitDepth = 0;
+            const char* pszNBITS =
+                poBand->GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
+            if( pszNBITS )
+                nBandBitDepth = atoi(pszNBITS);
+            if( nBandBitDepth < nBitDepth )
+                anBandsToClamp.push_back(i);
+        }
+    }
+
+    const GUInt32 nMaxValue = (1 << nBitDepth) - 1;
+
+    GDALDataType eBufDataTypeOri = eBufDataType;
+    void* pDataBufOri = pDataBuf;
+    // CFloat64 is the query type used by gdallocationinfo...
+#ifdef LIMIT_TYPES
+    if( eBufDataType != GDT_Byte && eBufDataType != GDT_UInt16 )
+#else
+    if( eBufDataType == GDT_CFloat64 )
+#endif
+    {
+        pDataBuf = GetWorkBuffer(
+            abyTempBuffer, nXSize, nYSize,
+            static_cast<size_t>(psOptions->nOutPansharpenedBands) *
+                sizeof(double));
+        if( pDataBuf == nullptr )
+            return CE_Failure;
+        eBufDataType = GDT_Float64;
+    }
+
+#ifdef DEBUG_TIMING
+    struct timeval tv;
+#endif
+    std::vector<GDALPansharpenJob> asJobs;
+    if( nTasks > 1 )
+    {
+        asJobs.resize( nTasks );
+        for( int i=0;i<nTasks;i++)
+        {
+            const size_t iStartLine =
+                (static_cast<size_t>(i) * nYSize) / nTasks;
+            const size_t iNextStartLine =
+                (static_cast<size_t>(i + 1) * nYSize) / nTasks;
+            asJobs[i].poPansharpenOperation = this;
+            asJobs[i].eWorkDataType = eWorkDataType;
+            asJobs[i].eBufDataType = eBufDataType;
+            asJobs[i].pPanBuffer =
+                pPanBuffer + iStartLine *  nXSize * nDataTypeSize;
+            asJobs[i].pUpsampledSpectralBuffer =
+                pUpsampledSpectralBuffer +
+                iStartLine * nXSize * nDataTypeSize;
+            asJobs[i].pDataBuf =
+                static_cast<GByte*>(pDataBuf) +
+                iStartLine * nXSize *
+                GDALGetDataTypeSizeBytes(eBufDataType);
+            asJobs[i].nValues =
+                (iNextStartLine - iStartLine) * nXSize;
+            asJobs[i].nBandValues = static_cast<size_t>(nXSize) * nYSize;
+            asJobs[i].nMaxValue = nMaxValue;
+            asJobs[i].eErr = CE_Failure;
+#ifdef DEBUG_TIMING
+            asJobs[i].ptv = &tv;
+#endif
+        }
+    }
+    // Set when the pansharpening has been done by the resampling jobs.
+    bool bPansharpenDone = false;
+
     // When upsampling, extract the multispectral data at
     // full resolution in a temp buffer, and then do the upsampling.
     if( nSpectralXSize < nXSize && nSpectralYSize < nYSize &&
@@ -1151,16 +1285,12 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
         if( nYOffExtract + nYSizeExtract > aMSBands[0]->GetYSize() )
             nYSizeExtract = aMSBands[0]->GetYSize() - nYOffExtract;
 
-        GByte* pSpectralBuffer = static_cast<GByte *>(
-            VSI_MALLOC3_VERBOSE(
-                nXSizeExtract, nYSizeExtract,
-                psOptions->nInputSpectralBands * nDataTypeSize));
+        GByte* pSpectralBuffer = GetWorkBuffer(
+            abySpectralBuffer, nXSizeExtract, nYSizeExtract,
+            static_cast<size_t>(psOptions->nInputSpectralBands) *
+                nDataTypeSize);
         if( pSpectralBuffer == nullptr )
-        {
-            VSIFree(pUpsampledSpectralBuffer);
-            VSIFree(pPanBuffer);
             return CE_Failure;
-        }
 
         if( !anInputBands.empty() )
         {
@@ -1193,12 +1323,7 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
             }
         }
         if( eErr != CE_None )
-        {
-            VSIFree(pSpectralBuffer);
-            VSIFree(pUpsampledSpectralBuffer);
-            VSIFree(pPanBuffer);
             return CE_Failure;
-        }
 
         // Create a MEM dataset that wraps the input buffer.
         GDALDataset* poMEMDS = MEMDataset::Create("", nXSizeExtract, nYSizeExtract, 0,
@@ -1273,16 +1398,15 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
                 poMEMDS->GetRasterBand(i+1)->GetMaskFlags();
             }
 
-            std::vector<GDALPansharpenResampleJob> asJobs;
-            asJobs.resize( nTasks );
-            GDALPansharpenResampleJob* pasJobs = &(asJobs[0]);
+            // Each job pansharpens the lines it has just resampled, while
+            // they are still hot in cache.
+            std::vector<GDALPansharpenResampleJob> asResampleJobs;
+            asResampleJobs.resize( nTasks );
+            GDALPansharpenResampleJob* pasJobs = &(asResampleJobs[0]);
             {
                 std::vector<void*> ahJobData;
                 ahJobData.resize( nTasks );
 
-#ifdef DEBUG_TIMING
-                struct timeval tv;
-#endif
                 for( int i=0;i<nTasks;i++)
                 {
                     const size_t iStartLine =
@@ -1331,6 +1455,8 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
                     pasJobs[i].nBandCount = psOptions->nInputSpectralBands;
                     pasJobs[i].nBandSpace =
                         static_cast<GSpacing>(nXSize) * nYSize * nDataTypeSize;
+                    pasJobs[i].psPansharpenJob = &(asJobs[i]);
+                    pasJobs[i].panBandsToClamp = &anBandsToClamp;
 #ifdef DEBUG_TIMING
                     pasJobs[i].ptv = &tv;
 #endif
@@ -1339,15 +1465,16 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
 #ifdef DEBUG_TIMING
                 gettimeofday(&tv, nullptr);
 #endif
-                poThreadPool->SubmitJobs(PansharpenResampleJobThreadFunc,
-                                         ahJobData);
-                poThreadPool->WaitCompletion();
+                auto poJobQueue = poThreadPool->CreateJobQueue();
+                for( void* pJobData: ahJobData )
+                    poJobQueue->SubmitJob(PansharpenResampleJobThreadFunc,
+                                          pJobData);
+                poJobQueue->WaitCompletion();
             }
+            bPansharpenDone = true;
         }
 
         GDALClose(poMEMDS);
-
-        VSIFree(pSpectralBuffer);
     }
     else
     {
@@ -1381,155 +1508,70 @@ CPLErr GDALPansharpenOperation::ProcessRegion( int nXOff, int nYOff,
             }
         }
         if( eErr != CE_None )
-        {
-            VSIFree(pUpsampledSpectralBuffer);
-            VSIFree(pPanBuffer);
             return CE_Failure;
-        }
-    }
-
-    // In case NBITS was not set on the spectral bands, clamp the values
-    // if overshoot might have occurred.
-    int nBitDepth = psOptions->nBitDepth;
-    if( nBitDepth && (eResampleAlg == GRIORA_Cubic ||
-                      eResampleAlg == GRIORA_CubicSpline ||
-                      eResampleAlg == GRIORA_Lanczos) )
-    {
-        for( int i = 0; i < psOptions->nInputSpectralBands; i++ )
-        {
-            GDALRasterBand* poBand = aMSBands[i];
-            int nBandBitDepth = 0;
-            const char* pszNBITS =
-                poBand->GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
-            if( pszNBITS )
-                nBandBitDepth = atoi(pszNBITS);
-            if( nBandBitDepth < nBitDepth )
-            {
-                if( eWorkDataType == GDT_Byte )
-                {
-                    ClampValues(reinterpret_cast<GByte*>(pUpsampledSpectralBuffer) + static_cast<size_t>(i) * nXSize * nYSize,
-                               static_cast<size_t>(nXSize)*nYSize,
-                               static_cast<GByte>((1 << nBitDepth)-1));
-                }
-                else if( eWorkDataType == GDT_UInt16 )
-                {
-                    ClampValues(reinterpret_cast<GUInt16*>(pUpsampledSpectralBuffer) + static_cast<size_t>(i) * nXSize * nYSize,
-                               static_cast<size_t>(nXSize)*nYSize,
-                               static_cast<GUInt16>((1 << nBitDepth)-1));
-                }
-#ifndef LIMIT_TYPES
-                else if( eWorkDataType == GDT_UInt32 )
-                {
-                    ClampValues(reinterpret_cast<GUInt32*>(pUpsampledSpectralBuffer) +
-                                static_cast<size_t>(i) * nXSize * nYSize,
-                                static_cast<size_t>(nXSize)*nYSize,
-                                (static_cast<GUInt32>((1 << nBitDepth)-1));
-                }
-#endif
-            }
-        }
     }
 
-    GUInt32 nMaxValue = (1 << nBitDepth) - 1;
-
-    double* padfTempBuffer = nullptr;
-    GDALDataType eBufDataTypeOri = eBufDataType;
-    void* pDataBufOri = pDataBuf;
-    // CFloat64 is the query type used by gdallocationinfo...
-#ifdef LIMIT_TYPES
-    if( eBufDataType != GDT_Byte && eBufDataType != GDT_UInt16 )
-#else
-    if( eBufDataType == GDT_CFloat64 )
-#endif
+    if( !bPansharpenDone )
     {
-        padfTempBuffer = static_cast<double * >(
-            VSI_MALLOC3_VERBOSE(
-                nXSize, nYSize,
-                psOptions->nOutPansharpenedBands * sizeof(double)));
-        if( padfTempBuffer == nullptr )
-        {
-            VSIFree(pUpsampledSpectralBuffer);
-            VSIFree(pPanBuffer);
-            return CE_Failure;
-        }
-        pDataBuf = padfTempBuffer;
-        eBufDataType = GDT_Float64;
-    }
+        ClampSpectralValues(eWorkDataType, anBandsToClamp,
+                            pUpsampledSpectralBuffer,
+                            static_cast<size_t>(nXSize) * nYSize,
+                            static_cast<size_t>(nXSize) * nYSize,
+                            nMaxValue);
 
-    if( nTasks > 1 )
-    {
-        std::vector<GDALPansharpenJob> asJobs;
-        asJobs.resize( nTasks );
-        GDALPansharpenJob* pasJobs = &(asJobs[0]);
+        if( nTasks > 1 )
         {
             std::vector<void*> ahJobData;
             ahJobData.resize( nTasks );
-#ifdef DEBUG_TIMING
-            struct timeval tv;
-#endif
             for( int i=0;i<nTasks;i++)
-            {
-                const size_t iStartLine =
-                    (static_cast<size_t>(i) * nYSize) / nTasks;
-                const size_t iNextStartLine =
-                    (static_cast<size_t>(i + 1) * nYSize) / nTasks;
-                pasJobs[i].poPansharpenOperation = this;
-                pasJobs[i].eWorkDataType = eWorkDataType;
-                pasJobs[i].eBufDataType = eBufDataType;
-                pasJobs[i].pPanBuffer =
-                    pPanBuffer + iStartLine *  nXSize * nDataTypeSize;
-                pasJobs[i].pUpsampledSpectralBuffer =
-                    pUpsampledSpectralBuffer +
-                    iStartLine * nXSize * nDataTypeSize;
-                pasJobs[i].pDataBuf =
-                    static_cast<GByte*>(pDataBuf) +
-                    iStartLine * nXSize *
-                    GDALGetDataTypeSizeBytes(eBufDataType);
-                pasJobs[i].nValues =
-                    (iNextStartLine - iStartLine) * nXSize;
-                pasJobs[i].nBandValues = static_cast<size_t>(nXSize) * nYSize;
-                pasJobs[i].nMaxValue = nMaxValue;
-#ifdef DEBUG_TIMING
-                pasJobs[i].ptv = &tv;
-#endif
-                ahJobData[i] = &(pasJobs[i]);
-            }
+                ahJobData[i] = &(asJobs[i]);
 #ifdef DEBUG_TIMING
             gettimeofday(&tv, nullptr);
 #endif
-            poThreadPool->SubmitJobs(PansharpenJobThreadFunc, ahJobData);
-            poThreadPool->WaitCompletion();
+            auto poJobQueue = poThreadPool->CreateJobQueue();
+            for( void* pJobData: ahJobData )
+                poJobQueue->SubmitJob(PansharpenJobThreadFunc, pJobData);
+            poJobQueue->WaitCompletion();
         }
+        else
+        {
+            eErr = PansharpenChunk( eWorkDataType, eBufDataType,
+                                    pPanBuffer,
+                                    pUpsampledSpectralBuffer,
+                                    pDataBuf,
+                                    static_cast<size_t>(nXSize) * nYSize,
+                                    static_cast<size_t>(nXSize) * nYSize,
+                                    nMaxValue);
+        }
+    }
 
+    if( nTasks > 1 )
+    {
         eErr = CE_None;
         for( int i=0;i<nTasks;i++)
         {
-            if( pasJobs[i].eErr != CE_None )
+            if( asJobs[i].eErr != CE_None )
                 eErr = CE_Failure;
         }
     }
-    else
-    {
-        eErr = PansharpenChunk( eWorkDataType, eBufDataType,
-                                pPanBuffer,
-                                pUpsampledSpectralBuffer,
-                                pDataBuf,
-                                static_cast<size_t>(nXSize) * nYSize,
-                                static_cast<size_t>(nXSize) * nYSize,
-                                nMaxValue);
-    }
 
-    if( padfTempBuffer )
+    if( pDataBuf != pDataBufOri )
     {
-        GDALCopyWords64(padfTempBuffer, GDT_Float64, sizeof(double),
+        GDALCopyWords64(pDataBuf, GDT_Float64, sizeof(double),
                       pDataBufOri, eBufDataTypeOri,
                       GDALGetDataTypeSizeBytes(eBufDataTypeOri),
                       static_cast<size_t>(nXSize)*nYSize*psOptions->nOutPansharpenedBands);
-        VSIFree(padfTempBuffer);
     }
 
-    VSIFree(pUpsampledSpectralBuffer);
-    VSIFree(pPanBuffer);
+    // Only keep working buffers of the size of typical block requests.
+    for( std::vector<GByte>* pabyBuffer : { &abyPanBuffer,
+                                            &abyUpsampledSpectralBuffer,
+                                            &abySpectralBuffer,
+                                            &abyTempBuffer } )
+    {
+        if( pabyBuffer->size() > MAX_KEPT_WORK_BUFFER_SIZE )
+            std::vector<GByte>().swap(*pabyBuffer);
+    }
 
     return eErr;
 }
@@ -1582,6 +1624,26 @@ void GDALPansharpenOperation::PansharpenResampleJobThreadFunc(void* pUserData)
                              nullptr,
                              0, 0, psJob->nBandSpace,
                              &sExtraArg));
+
+    GDALPansharpenJob* psPansharpenJob = psJob->psPansharpenJob;
+    if( psPansharpenJob )
+    {
+        ClampSpectralValues(psJob->eDT, *(psJob->panBandsToClamp),
+                            psJob->pBuffer,
+                            psPansharpenJob->nValues,
+                            psPansharpenJob->nBandValues,
+                            psPansharpenJob->nMaxValue);
+        psPansharpenJob->eErr =
+            psPansharpenJob->poPansharpenOperation->PansharpenChunk(
+                psPansharpenJob->eWorkDataType,
+                psPansharpenJob->eBufDataType,
+                psPansharpenJob->pPanBuffer,
+                psPansharpenJob->pUpsampledSpectralBuffer,
+                psPansharpenJob->pDataBuf,
+                psPansharpenJob->nValues,
+                psPansharpenJob->nBandValues,
+                psPansharpenJob->nMaxValue);
+    }
 #endif
 
 #ifdef DEBUG_TIMING
@@ -177,6 +177,10 @@ typedef struct
     GDALRIOResampleAlg eResampleAlg;
     GSpacing     nBandSpace;
 
+    // When not NULL, the resampled lines are pansharpened by the same job.
+    GDALPansharpenJob* psPansharpenJob;
+    const std::vector<int>* panBandsToClamp;
+
 #ifdef DEBUG_TIMING
     struct timeval* ptv;
 #endif
@@ -194,9 +198,16 @@ class GDALPansharpenOperation
         std::vector<GDALDataset*> aVDS{}; // to destroy
         std::vector<GDALRasterBand*> aMSBands{}; // original multispectral bands potentially warped into a VRT
         int bPositiveWeights = TRUE;
-        CPLWorkerThreadPool* poThreadPool = nullptr;
+        CPLWorkerThreadPool* poThreadPool = nullptr; // global pool, not owned
+        int nPoolThreads = 0;
         int nKernelRadius = 0;
 
+        // Working buffers, kept between ProcessRegion() calls.
+        std::vector<GByte> abyPanBuffer{};
+        std::vector<GByte> abyUpsampledSpectralBuffer{};
+        std::vector<GByte> abySpectralBuffer{};
+        std::vector<GByte> abyTempBuffer{};
+
         static void PansharpenJobThreadFunc(void* pUserData);
         static void PansharpenResampleJobThreadFunc(void* pUserData);
 
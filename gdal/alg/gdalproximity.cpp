@@ -34,13 +34,17 @@
 #include <cstdlib>
 
 #include <algorithm>
+#include <memory>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
+#include "gdal_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -50,6 +54,15 @@ ProcessProximityLine( GInt32 *panSrcScanline, int *panNearX, int *panNearY,
                       float *pafProximity, double *pdfSrcNoDataValue,
                       int nTargetValues, int *panTargetValues );
 
+static CPLErr
+ComputeProximityEDT( GDALRasterBandH hSrcBand, GDALRasterBandH hProximityBand,
+                     double dfMaxDist, double dfMinDist, double dfDistMult,
+                     const double *pdfSrcNoDataValue, float fNoDataValue,
+                     bool bFixedBufVal, double dfFixedBufVal,
+                     int nTargetValues, const int *panTargetValues,
+                     int nThreads,
+                     GDALProgressFunc pfnProgress, void *pProgressArg );
+
 /************************************************************************/
 /*                        GDALComputeProximity()                        */
 /************************************************************************/
@@ -90,6 +103,14 @@ The maximum distance to search.  Proximity distances greater than
 this value will not be computed.  Instead output pixels will be
 set to a nodata value.
 
+  MINDIST=n
+
+(GDAL >= 3.4) The minimum distance to output.  Pixels closer than this
+value to a target pixel, including the target pixels themselves when
+it is strictly positive, are set to the nodata value.  Combined with
+MAXDIST, this restricts the output to a distance band.  Expressed in
+the same unit as MAXDIST.
+
   NODATA=n
 
 The NODATA value to use on the output band for pixels that are
@@ -106,6 +127,16 @@ the proximity output.
 
 If this option is set, all pixels within the MAXDIST threadhold are
 set to this fixed value instead of to a proximity distance.
+
+  NUM_THREADS=n/ALL_CPUS
+
+(GDAL >= 3.4) Number of worker threads.  Defaults to 1.  When greater
+than 1 and MAXDIST is set, an exact Euclidean distance transform is
+computed, by strips of lines read with a halo of MAXDIST lines, so memory
+use is bounded by MAXDIST rather than by the raster height.  Distances
+may then slightly differ from the single-threaded ones, which are
+computed by a two-pass propagation that can overestimate them.  Without
+MAXDIST, the single-threaded algorithm is used.
 */
 
 CPLErr CPL_STDCALL
@@ -159,12 +190,34 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
 /*      What is our maxdist value?                                      */
 /* -------------------------------------------------------------------- */
     pszOpt = CSLFetchNameValue( papszOptions, "MAXDIST" );
+    const bool bHasMaxDist = pszOpt != nullptr;
     const double dfMaxDist = pszOpt ?
         CPLAtof(pszOpt) / dfDistMult :
         GDALGetRasterBandXSize(hSrcBand) + GDALGetRasterBandYSize(hSrcBand);
 
     CPLDebug( "GDAL", "MAXDIST=%g, DISTMULT=%g", dfMaxDist, dfDistMult );
 
+    pszOpt = CSLFetchNameValue( papszOptions, "MINDIST" );
+    const double dfMinDist = pszOpt ? CPLAtof(pszOpt) / dfDistMult : 0.0;
+
+/* -------------------------------------------------------------------- */
+/*      How many threads?  The multi-threaded distance transform is     */
+/*      only selected explicitly, as its results differ slightly from   */
+/*      the single-threaded ones, and it needs MAXDIST to bound the     */
+/*      strips it reads.                                                */
+/* -------------------------------------------------------------------- */
+    pszOpt = CSLFetchNameValueDef( papszOptions, "NUM_THREADS", "1" );
+    int nThreads = EQUAL(pszOpt, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszOpt);
+    if( nThreads > 128 )
+        nThreads = 128;
+    if( nThreads > 1 && !bHasMaxDist )
+    {
+        CPLDebug( "GDAL",
+                  "NUM_THREADS ignored as MAXDIST is not set: "
+                  "using the single-threaded algorithm" );
+        nThreads = 1;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Verify the source and destination are compatible.               */
 /* -------------------------------------------------------------------- */
@@ -253,6 +306,19 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
         return CE_Failure;
     }
 
+    if( nThreads > 1 )
+    {
+        const CPLErr eErrEDT =
+            ComputeProximityEDT( hSrcBand, hProximityBand,
+                                 dfMaxDist, dfMinDist, dfDistMult,
+                                 pdfSrcNoData, fNoDataValue,
+                                 bFixedBufVal, dfFixedBufVal,
+                                 nTargetValues, panTargetValues, nThreads,
+                                 pfnProgress, pProgressArg );
+        CPLFree(panTargetValues);
+        return eErrEDT;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      We need a signed type for the working proximity values kept     */
 /*      on disk.  If our proximity band is not signed, then create a    */
@@ -406,7 +472,7 @@ GDALComputeProximity( GDALRasterBandH hSrcBand,
         // Final post processing of distances.
         for( int i = 0; i < nXSize; i++ )
         {
-            if( pafProximity[i] < 0.0 )
+            if( pafProximity[i] < 0.0 || pafProximity[i] < dfMinDist )
                 pafProximity[i] = fNoDataValue;
             else if( pafProximity[i] > 0.0 )
             {
@@ -592,3 +658,360 @@ ProcessProximityLine( GInt32 *panSrcScanline, int *panNearX, int *panNearY,
 
     return CE_None;
 }
+
+/************************************************************************/
+/* ==================================================================== */
+/*      Multi-threaded exact Euclidean distance transform, after        */
+/*      Felzenszwalb & Huttenlocher, "Distance Transforms of Sampled    */
+/*      Functions", 2012.                                               */
+/* ==================================================================== */
+/************************************************************************/
+
+namespace {
+struct ProximityEDTStrip
+{
+    int nXSize = 0;
+    // Lines of the window, halo included.
+    int nWinYSize = 0;
+    // First line of the strip to output, relative to the window.
+    int nCoreYOff = 0;
+    int nCoreYSize = 0;
+    // Source values of the window on input. Replaced by the vertical
+    // distance, in pixels, to the nearest target pixel of the column.
+    GInt32 *panColDist = nullptr;
+    // Whether the source pixels of the output lines are nodata.
+    GByte *pabySrcNoData = nullptr;
+    float *pafProximity = nullptr;
+
+    const double *pdfSrcNoDataValue = nullptr;
+    int nTargetValues = 0;
+    const int *panTargetValues = nullptr;
+    double dfMaxDist = 0.0;
+    double dfMinDist = 0.0;
+    double dfDistMult = 1.0;
+    bool bFixedBufVal = false;
+    double dfFixedBufVal = 0.0;
+    float fNoDataValue = 0.0f;
+};
+
+struct ProximityEDTJob
+{
+    const ProximityEDTStrip *psStrip = nullptr;
+    // Range of columns for the column pass, of output lines for the row pass.
+    int nStart = 0;
+    int nEnd = 0;
+};
+}  // namespace
+
+/************************************************************************/
+/*                          IsTargetValue()                             */
+/************************************************************************/
+
+static bool IsTargetValue( GInt32 nValue, int nTargetValues,
+                           const int *panTargetValues )
+{
+    if( nTargetValues == 0 )
+        return nValue != 0;
+    for( int i = 0; i < nTargetValues; i++ )
+    {
+        if( nValue == panTargetValues[i] )
+            return true;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                       ProximityEDTColumnPass()                       */
+/*                                                                      */
+/*      Vertical distance to the nearest target pixel of each column    */
+/*      of the window. The window is swept by lines over a range of     */
+/*      columns to stay cache friendly.                                 */
+/************************************************************************/
+
+static void ProximityEDTColumnPass( void *pData )
+{
+    const ProximityEDTJob *psJob = static_cast<ProximityEDTJob *>(pData);
+    const ProximityEDTStrip *psStrip = psJob->psStrip;
+    const int nXSize = psStrip->nXSize;
+    // Larger than any vertical distance within the window.
+    const GInt32 nInfinity = psStrip->nWinYSize;
+
+    for( int iLine = 0; iLine < psStrip->nWinYSize; iLine++ )
+    {
+        GInt32 *panLine = psStrip->panColDist +
+                          static_cast<size_t>(iLine) * nXSize;
+        const int iCoreLine = iLine - psStrip->nCoreYOff;
+        GByte *pabyNoData =
+            iCoreLine >= 0 && iCoreLine < psStrip->nCoreYSize ?
+                psStrip->pabySrcNoData +
+                    static_cast<size_t>(iCoreLine) * nXSize : nullptr;
+
+        for( int iPixel = psJob->nStart; iPixel < psJob->nEnd; iPixel++ )
+        {
+            const GInt32 nValue = panLine[iPixel];
+            if( pabyNoData )
+            {
+                pabyNoData[iPixel] =
+                    psStrip->pdfSrcNoDataValue != nullptr &&
+                    nValue == *(psStrip->pdfSrcNoDataValue);
+            }
+            if( IsTargetValue( nValue, psStrip->nTargetValues,
+                               psStrip->panTargetValues ) )
+                panLine[iPixel] = 0;
+            else if( iLine == 0 )
+                panLine[iPixel] = nInfinity;
+            else
+                panLine[iPixel] =
+                    std::min(panLine[iPixel - nXSize] + 1, nInfinity);
+        }
+    }
+
+    // Only the output lines need the distance to targets below them.
+    for( int iLine = psStrip->nWinYSize - 2;
+         iLine >= psStrip->nCoreYOff; iLine-- )
+    {
+        GInt32 *panLine = psStrip->panColDist +
+                          static_cast<size_t>(iLine) * nXSize;
+        for( int iPixel = psJob->nStart; iPixel < psJob->nEnd; iPixel++ )
+        {
+            panLine[iPixel] =
+                std::min(panLine[iPixel], panLine[iPixel + nXSize] + 1);
+        }
+    }
+}
+
+/************************************************************************/
+/*                        ProximityEDTRowPass()                         */
+/*                                                                      */
+/*      Squared distance of each pixel of the output lines to the      */
+/*      lower envelope of the parabolas rooted at the columns having   */
+/*      a target pixel within MAXDIST vertically.                      */
+/************************************************************************/
+
+static void ProximityEDTRowPass( void *pData )
+{
+    const ProximityEDTJob *psJob = static_cast<ProximityEDTJob *>(pData);
+    const ProximityEDTStrip *psStrip = psJob->psStrip;
+    const int nXSize = psStrip->nXSize;
+    const double dfMaxDistSq = psStrip->dfMaxDist * psStrip->dfMaxDist;
+
+    std::vector<double> adfF(nXSize);
+    std::vector<int> anV(nXSize);
+    std::vector<double> adfZ(nXSize + 1);
+
+    for( int iCoreLine = psJob->nStart; iCoreLine < psJob->nEnd; iCoreLine++ )
+    {
+        const size_t nCoreOffset = static_cast<size_t>(iCoreLine) * nXSize;
+        const GInt32 *panColDist = psStrip->panColDist +
+            static_cast<size_t>(psStrip->nCoreYOff) * nXSize + nCoreOffset;
+        const GByte *pabyNoData = psStrip->pabySrcNoData + nCoreOffset;
+        float *pafProximity = psStrip->pafProximity + nCoreOffset;
+
+        int k = -1;
+        for( int q = 0; q < nXSize; q++ )
+        {
+            if( panColDist[q] >= psStrip->nWinYSize ||
+                panColDist[q] > psStrip->dfMaxDist )
+                continue;
+            const double dfFq = static_cast<double>(panColDist[q]) *
+                                panColDist[q];
+            adfF[q] = dfFq;
+            if( k < 0 )
+            {
+                k = 0;
+                anV[0] = q;
+                adfZ[0] = -HUGE_VAL;
+                adfZ[1] = HUGE_VAL;
+                continue;
+            }
+            double dfS = 0.0;
+            while( true )
+            {
+                const int v = anV[k];
+                dfS = ((dfFq + static_cast<double>(q) * q) -
+                       (adfF[v] + static_cast<double>(v) * v)) /
+                      (2.0 * (q - v));
+                if( dfS > adfZ[k] )
+                    break;
+                k--;
+            }
+            k++;
+            anV[k] = q;
+            adfZ[k] = dfS;
+            adfZ[k + 1] = HUGE_VAL;
+        }
+
+        if( k < 0 )
+        {
+            // No target within MAXDIST of this line.
+            for( int p = 0; p < nXSize; p++ )
+                pafProximity[p] = psStrip->fNoDataValue;
+            continue;
+        }
+
+        int j = 0;
+        for( int p = 0; p < nXSize; p++ )
+        {
+            while( adfZ[j + 1] < p )
+                j++;
+            const double dfDX = static_cast<double>(p - anV[j]);
+            const double dfDistSq = dfDX * dfDX + adfF[anV[j]];
+
+            if( dfDistSq > dfMaxDistSq ||
+                (dfDistSq > 0.0 && pabyNoData[p]) )
+            {
+                pafProximity[p] = psStrip->fNoDataValue;
+                continue;
+            }
+            const double dfDist = sqrt(dfDistSq);
+            if( dfDist < psStrip->dfMinDist )
+                pafProximity[p] = psStrip->fNoDataValue;
+            else if( dfDist == 0.0 )
+                pafProximity[p] = 0.0f;
+            else if( psStrip->bFixedBufVal )
+                pafProximity[p] = static_cast<float>(psStrip->dfFixedBufVal);
+            else
+                pafProximity[p] =
+                    static_cast<float>(dfDist * psStrip->dfDistMult);
+        }
+    }
+}
+
+/************************************************************************/
+/*                        ComputeProximityEDT()                         */
+/************************************************************************/
+
+static void RunProximityEDTJobs( CPLJobQueue *poJobQueue,
+                                 const ProximityEDTStrip& sStrip,
+                                 CPLThreadFunc pfnFunc, int nSize,
+                                 int nThreads )
+{
+    const int nJobs = std::max(1, std::min(nThreads, nSize));
+    std::vector<ProximityEDTJob> asJobs(nJobs);
+    for( int iJob = 0; iJob < nJobs; iJob++ )
+    {
+        asJobs[iJob].psStrip = &sStrip;
+        asJobs[iJob].nStart = static_cast<int>(
+            static_cast<GIntBig>(nSize) * iJob / nJobs);
+        asJobs[iJob].nEnd = static_cast<int>(
+            static_cast<GIntBig>(nSize) * (iJob + 1) / nJobs);
+    }
+    if( poJobQueue == nullptr || nJobs == 1 )
+    {
+        for( auto& sJob: asJobs )
+            pfnFunc(&sJob);
+        return;
+    }
+    for( auto& sJob: asJobs )
+        poJobQueue->SubmitJob(pfnFunc, &sJob);
+    poJobQueue->WaitCompletion();
+}
+
+static CPLErr
+ComputeProximityEDT( GDALRasterBandH hSrcBand, GDALRasterBandH hProximityBand,
+                     double dfMaxDist, double dfMinDist, double dfDistMult,
+                     const double *pdfSrcNoDataValue, float fNoDataValue,
+                     bool bFixedBufVal, double dfFixedBufVal,
+                     int nTargetValues, const int *panTargetValues,
+                     int nThreads,
+                     GDALProgressFunc pfnProgress, void *pProgressArg )
+
+{
+    const int nXSize = GDALGetRasterBandXSize( hSrcBand );
+    const int nYSize = GDALGetRasterBandYSize( hSrcBand );
+
+/* -------------------------------------------------------------------- */
+/*      Target pixels farther than MAXDIST lines cannot contribute, so  */
+/*      each strip is read with a halo of MAXDIST lines.  Strips are    */
+/*      made at least twice as high as the halo to limit the overhead   */
+/*      of reading the halo lines twice.                                */
+/* -------------------------------------------------------------------- */
+    const int nHalo = dfMaxDist >= nYSize ? nYSize :
+                      static_cast<int>(std::ceil(dfMaxDist));
+    const int nCoreLines = std::min(nYSize, std::max(256, 2 * nHalo));
+    const int nMaxWinLines = static_cast<int>(std::min(
+        static_cast<GIntBig>(nYSize),
+        static_cast<GIntBig>(nCoreLines) + 2 * static_cast<GIntBig>(nHalo)));
+
+    GInt32 *panColDist = static_cast<GInt32 *>(
+        VSI_MALLOC3_VERBOSE(sizeof(GInt32), nXSize, nMaxWinLines));
+    GByte *pabySrcNoData = static_cast<GByte *>(
+        VSI_MALLOC2_VERBOSE(nXSize, nCoreLines));
+    float *pafProximity = static_cast<float *>(
+        VSI_MALLOC3_VERBOSE(sizeof(float), nXSize, nCoreLines));
+    if( panColDist == nullptr || pabySrcNoData == nullptr ||
+        pafProximity == nullptr )
+    {
+        CPLFree( panColDist );
+        CPLFree( pabySrcNoData );
+        CPLFree( pafProximity );
+        return CE_Failure;
+    }
+
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    CPLWorkerThreadPool *poThreadPool = GDALGetGlobalThreadPool(nThreads);
+    if( poThreadPool )
+        poJobQueue = poThreadPool->CreateJobQueue();
+
+    ProximityEDTStrip sStrip;
+    sStrip.nXSize = nXSize;
+    sStrip.panColDist = panColDist;
+    sStrip.pabySrcNoData = pabySrcNoData;
+    sStrip.pafProximity = pafProximity;
+    sStrip.pdfSrcNoDataValue = pdfSrcNoDataValue;
+    sStrip.nTargetValues = nTargetValues;
+    sStrip.panTargetValues = panTargetValues;
+    sStrip.dfMaxDist = dfMaxDist;
+    sStrip.dfMinDist = dfMinDist;
+    sStrip.dfDistMult = dfDistMult;
+    sStrip.bFixedBufVal = bFixedBufVal;
+    sStrip.dfFixedBufVal = dfFixedBufVal;
+    sStrip.fNoDataValue = fNoDataValue;
+
+    CPLErr eErr = CE_None;
+    for( int nCoreYOff = 0; eErr == CE_None && nCoreYOff < nYSize;
+         nCoreYOff += nCoreLines )
+    {
+        const int nCoreYSize = std::min(nCoreLines, nYSize - nCoreYOff);
+        const int nWinYOff = std::max(0, nCoreYOff - nHalo);
+        const int nWinYEnd = static_cast<int>(std::min(
+            static_cast<GIntBig>(nYSize),
+            static_cast<GIntBig>(nCoreYOff) + nCoreYSize + nHalo));
+
+        eErr = GDALRasterIO( hSrcBand, GF_Read,
+                             0, nWinYOff, nXSize, nWinYEnd - nWinYOff,
+                             panColDist, nXSize, nWinYEnd - nWinYOff,
+                             GDT_Int32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        sStrip.nWinYSize = nWinYEnd - nWinYOff;
+        sStrip.nCoreYOff = nCoreYOff - nWinYOff;
+        sStrip.nCoreYSize = nCoreYSize;
+
+        RunProximityEDTJobs( poJobQueue.get(), sStrip,
+                             ProximityEDTColumnPass, nXSize, nThreads );
+        RunProximityEDTJobs( poJobQueue.get(), sStrip,
+                             ProximityEDTRowPass, nCoreYSize, nThreads );
+
+        eErr = GDALRasterIO( hProximityBand, GF_Write,
+                             0, nCoreYOff, nXSize, nCoreYSize,
+                             pafProximity, nXSize, nCoreYSize,
+                             GDT_Float32, 0, 0 );
+        if( eErr != CE_None )
+            break;
+
+        if( !pfnProgress( static_cast<double>(nCoreYOff + nCoreYSize) / nYSize,
+                          "", pProgressArg ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+    CPLFree( panColDist );
+    CPLFree( pabySrcNoData );
+    CPLFree( pafProximity );
+
+    return eErr;
+}
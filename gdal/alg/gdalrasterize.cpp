@@ -38,14 +38,19 @@
 #include <cfloat>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_priv.h"
+#include "gdal_thread_pool.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
 #include "ogr_feature.h"
@@ -646,6 +651,317 @@ static CPLErr GDALRasterizeOptions( char **papszOptions,
     return CE_None;
 }
 
+/************************************************************************/
+/*                 Multi-threaded GDALRasterizeGeometries()             */
+/*                                                                      */
+/*      Each chunk is split into strips of full lines, which are        */
+/*      rasterized concurrently. A strip only receives the geometries   */
+/*      whose pixel envelope intersects it, in their original order,    */
+/*      so the result is the same as the one of the single-threaded     */
+/*      mode, whatever the merge algorithm.                             */
+/************************************************************************/
+
+namespace {
+
+// Pixel envelope of a geometry in the raster, bounds included.
+struct GDALRasterizeGeomEnvelope
+{
+    int nMinX = 0;
+    int nMinY = 0;
+    int nMaxX = -1;
+    int nMaxY = -1;
+};
+
+struct GDALRasterizeJobContext
+{
+    int nGeomCount = 0;
+    OGRGeometryH *pahGeometries = nullptr;
+    const double *padfGeomBurnValue = nullptr;
+    int nBandCount = 0;
+    GDALDataType eType = GDT_Byte;
+    int bAllTouched = FALSE;
+    GDALBurnValueSrc eBurnValueSource = GBV_UserBurnValue;
+    GDALRasterMergeAlg eMergeAlg = GRMA_Replace;
+    int nRasterXSize = 0;
+    int nRasterYSize = 0;
+
+    std::vector<GDALRasterizeGeomEnvelope> asEnvelopes{};
+
+    // Chunk being rasterized.
+    unsigned char *pabyChunkBuf = nullptr;
+    int nChunkYOff = 0;
+    int nChunkYSize = 0;
+    int nStripYSize = 0;
+    std::vector<std::vector<int>> aanStripGeoms{};
+
+    // Next geometry or strip to process.
+    std::atomic<int> nNextItem{0};
+};
+
+struct GDALRasterizeWorker
+{
+    GDALRasterizeJobContext *psContext = nullptr;
+    GDALTransformerFunc pfnTransformer = nullptr;
+    void *pTransformArg = nullptr;
+};
+
+} // namespace
+
+/************************************************************************/
+/*                   GDALRasterizeGetNumThreads()                       */
+/************************************************************************/
+
+static int GDALRasterizeGetNumThreads( CSLConstList papszOptions )
+{
+    const char *pszNumThreads = CSLFetchNameValue(papszOptions, "NUM_THREADS");
+    if( pszNumThreads == nullptr )
+        pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                       atoi(pszNumThreads);
+    if( nThreads > 128 )
+        nThreads = 128;
+    return std::max(1, nThreads);
+}
+
+/************************************************************************/
+/*                  GDALRasterizeComputeEnvelopesJob()                  */
+/************************************************************************/
+
+// Computes the pixel envelope of the geometries from their transformed
+// vertices, as the scan conversion does not go beyond them.
+static void GDALRasterizeComputeEnvelopesJob( void *pData )
+{
+    GDALRasterizeWorker *psWorker = static_cast<GDALRasterizeWorker *>(pData);
+    GDALRasterizeJobContext *psContext = psWorker->psContext;
+    constexpr int knBatchSize = 256;
+    std::vector<double> aPointX;
+    std::vector<double> aPointY;
+    std::vector<double> aPointVariant;
+    std::vector<int> aPartSize;
+    std::vector<int> anSuccess;
+
+    while( true )
+    {
+        const int iStart = psContext->nNextItem.fetch_add(knBatchSize);
+        if( iStart >= psContext->nGeomCount )
+            break;
+        const int iEnd = std::min(iStart + knBatchSize, psContext->nGeomCount);
+        for( int iShape = iStart; iShape < iEnd; iShape++ )
+        {
+            GDALRasterizeGeomEnvelope &sEnv = psContext->asEnvelopes[iShape];
+            const OGRGeometry *poShape =
+                OGRGeometry::FromHandle(psContext->pahGeometries[iShape]);
+            if( poShape == nullptr || poShape->IsEmpty() )
+                continue;
+
+            aPointX.clear();
+            aPointY.clear();
+            aPointVariant.clear();
+            aPartSize.clear();
+            GDALCollectRingsFromGeometry( poShape, aPointX, aPointY,
+                                          aPointVariant, aPartSize,
+                                          psContext->eBurnValueSource );
+            if( aPointX.empty() )
+                continue;
+            if( psWorker->pfnTransformer != nullptr )
+            {
+                anSuccess.resize(aPointX.size());
+                psWorker->pfnTransformer( psWorker->pTransformArg, FALSE,
+                                          static_cast<int>(aPointX.size()),
+                                          aPointX.data(), aPointY.data(),
+                                          nullptr, anSuccess.data() );
+            }
+
+            double dfMinX = aPointX[0];
+            double dfMaxX = aPointX[0];
+            double dfMinY = aPointY[0];
+            double dfMaxY = aPointY[0];
+            bool bFinite = true;
+            for( size_t i = 0; i < aPointX.size(); i++ )
+            {
+                if( !std::isfinite(aPointX[i]) || !std::isfinite(aPointY[i]) )
+                {
+                    bFinite = false;
+                    break;
+                }
+                dfMinX = std::min(dfMinX, aPointX[i]);
+                dfMaxX = std::max(dfMaxX, aPointX[i]);
+                dfMinY = std::min(dfMinY, aPointY[i]);
+                dfMaxY = std::max(dfMaxY, aPointY[i]);
+            }
+
+            // Keep a margin of one pixel for the boundary cases of the
+            // line and ALL_TOUCHED rasterizers.
+            if( !bFinite )
+            {
+                sEnv.nMinX = 0;
+                sEnv.nMinY = 0;
+                sEnv.nMaxX = psContext->nRasterXSize - 1;
+                sEnv.nMaxY = psContext->nRasterYSize - 1;
+            }
+            else if( dfMaxX >= -1 && dfMinX <= psContext->nRasterXSize + 1 &&
+                     dfMaxY >= -1 && dfMinY <= psContext->nRasterYSize + 1 )
+            {
+                sEnv.nMinX = std::max(0, static_cast<int>(floor(dfMinX)) - 1);
+                sEnv.nMinY = std::max(0, static_cast<int>(floor(dfMinY)) - 1);
+                sEnv.nMaxX = static_cast<int>(std::min(
+                    floor(dfMaxX) + 1.0,
+                    static_cast<double>(psContext->nRasterXSize - 1)));
+                sEnv.nMaxY = static_cast<int>(std::min(
+                    floor(dfMaxY) + 1.0,
+                    static_cast<double>(psContext->nRasterYSize - 1)));
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                      GDALRasterizeStripJob()                         */
+/************************************************************************/
+
+static void GDALRasterizeStripJob( void *pData )
+{
+    GDALRasterizeWorker *psWorker = static_cast<GDALRasterizeWorker *>(pData);
+    GDALRasterizeJobContext *psContext = psWorker->psContext;
+    const int nPixelSpace = GDALGetDataTypeSizeBytes(psContext->eType);
+    const GSpacing nLineSpace =
+        static_cast<GSpacing>(psContext->nRasterXSize) * nPixelSpace;
+    const GSpacing nBandSpace = nLineSpace * psContext->nChunkYSize;
+    const int nStrips = static_cast<int>(psContext->aanStripGeoms.size());
+
+    while( true )
+    {
+        const int iStrip = psContext->nNextItem.fetch_add(1);
+        if( iStrip >= nStrips )
+            break;
+        const int nStripYOff = iStrip * psContext->nStripYSize;
+        const int nStripYSize = std::min(psContext->nStripYSize,
+                                         psContext->nChunkYSize - nStripYOff);
+        for( const int iShape: psContext->aanStripGeoms[iStrip] )
+        {
+            gv_rasterize_one_shape( psContext->pabyChunkBuf +
+                                        nStripYOff * nLineSpace,
+                                    0, psContext->nChunkYOff + nStripYOff,
+                                    psContext->nRasterXSize, nStripYSize,
+                                    psContext->nBandCount, psContext->eType,
+                                    nPixelSpace, nLineSpace, nBandSpace,
+                                    psContext->bAllTouched,
+                                    OGRGeometry::FromHandle(
+                                        psContext->pahGeometries[iShape]),
+                                    psContext->padfGeomBurnValue +
+                                        iShape * psContext->nBandCount,
+                                    psContext->eBurnValueSource,
+                                    psContext->eMergeAlg,
+                                    psWorker->pfnTransformer,
+                                    psWorker->pTransformArg );
+        }
+    }
+}
+
+/************************************************************************/
+/*                  GDALRasterizeChunkMultiThreaded()                   */
+/************************************************************************/
+
+static void GDALRasterizeChunkMultiThreaded(
+    GDALRasterizeJobContext *psContext,
+    std::vector<GDALRasterizeWorker> &asWorkers,
+    CPLJobQueue *poJobQueue,
+    unsigned char *pabyChunkBuf, int nChunkYOff, int nChunkYSize )
+{
+    const int nStrips =
+        std::min(nChunkYSize, static_cast<int>(asWorkers.size()) * 4);
+    const int nStripYSize = (nChunkYSize + nStrips - 1) / nStrips;
+
+    psContext->pabyChunkBuf = pabyChunkBuf;
+    psContext->nChunkYOff = nChunkYOff;
+    psContext->nChunkYSize = nChunkYSize;
+    psContext->nStripYSize = nStripYSize;
+    psContext->aanStripGeoms.clear();
+    psContext->aanStripGeoms.resize(nStrips);
+
+    // Bin the geometries to the strips, in their original order.
+    for( int iShape = 0; iShape < psContext->nGeomCount; iShape++ )
+    {
+        const GDALRasterizeGeomEnvelope &sEnv =
+            psContext->asEnvelopes[iShape];
+        if( sEnv.nMaxX < sEnv.nMinX ||
+            sEnv.nMaxY < nChunkYOff ||
+            sEnv.nMinY >= nChunkYOff + nChunkYSize )
+            continue;
+        const int iFirstStrip =
+            (std::max(sEnv.nMinY, nChunkYOff) - nChunkYOff) / nStripYSize;
+        const int iLastStrip =
+            (std::min(sEnv.nMaxY, nChunkYOff + nChunkYSize - 1) - nChunkYOff) /
+            nStripYSize;
+        for( int iStrip = iFirstStrip; iStrip <= iLastStrip; iStrip++ )
+            psContext->aanStripGeoms[iStrip].push_back(iShape);
+    }
+
+    psContext->nNextItem = 0;
+    for( auto &sWorker: asWorkers )
+        poJobQueue->SubmitJob(GDALRasterizeStripJob, &sWorker);
+    poJobQueue->WaitCompletion();
+}
+
+/************************************************************************/
+/*                     GDALRasterizeSetupWorkers()                      */
+/************************************************************************/
+
+// Creates the workers, each with its own copy of the transformer, and
+// computes the pixel envelopes of the geometries.
+// Returns nullptr if the multi-threaded mode cannot be used.
+static std::unique_ptr<CPLJobQueue> GDALRasterizeSetupWorkers(
+    int nThreads,
+    GDALRasterizeJobContext *psContext,
+    std::vector<GDALRasterizeWorker> &asWorkers,
+    GDALTransformerFunc pfnTransformer, void *pTransformArg )
+{
+    if( pfnTransformer != nullptr &&
+        (pTransformArg == nullptr ||
+         memcmp(static_cast<GDALTransformerInfo *>(pTransformArg)->abySignature,
+                GDAL_GTI2_SIGNATURE, strlen(GDAL_GTI2_SIGNATURE)) != 0) )
+    {
+        CPLDebug("GDAL", "Rasterizer: the transformer cannot be cloned. "
+                 "Using a single thread");
+        return nullptr;
+    }
+
+    CPLWorkerThreadPool *poThreadPool = GDALGetGlobalThreadPool(nThreads);
+    if( poThreadPool == nullptr )
+        return nullptr;
+
+    asWorkers.resize(nThreads);
+    for( auto &sWorker: asWorkers )
+    {
+        sWorker.psContext = psContext;
+        if( pfnTransformer != nullptr )
+        {
+            sWorker.pfnTransformer = pfnTransformer;
+            sWorker.pTransformArg = GDALCloneTransformer(pTransformArg);
+            if( sWorker.pTransformArg == nullptr )
+            {
+                for( auto &sOtherWorker: asWorkers )
+                {
+                    if( sOtherWorker.pTransformArg )
+                        GDALDestroyTransformer(sOtherWorker.pTransformArg);
+                }
+                asWorkers.clear();
+                return nullptr;
+            }
+        }
+    }
+
+    auto poJobQueue = poThreadPool->CreateJobQueue();
+    psContext->asEnvelopes.resize(psContext->nGeomCount);
+    psContext->nNextItem = 0;
+    for( auto &sWorker: asWorkers )
+        poJobQueue->SubmitJob(GDALRasterizeComputeEnvelopesJob, &sWorker);
+    poJobQueue->WaitCompletion();
+
+    CPLDebug("GDAL", "Rasterizer using %d threads", nThreads);
+    return poJobQueue;
+}
+
 /************************************************************************/
 /*                      GDALRasterizeGeometries()                       */
 /************************************************************************/
@@ -698,6 +1014,13 @@ static CPLErr GDALRasterizeOptions( char **papszOptions,
  * used. Default size will be estimated based on the GDAL cache buffer size
  * using formula: cache_size_bytes/scanline_size_bytes, so the chunk will
  * not exceed the cache. Not used in OPTIM=RASTER mode.</li>
+ * <li>"NUM_THREADS": (GDAL >= 3.4) Number of worker threads, or ALL_CPUS.
+ * Defaults to the value of the GDAL_NUM_THREADS configuration option, or 1.
+ * When greater than 1, each chunk of lines is split into strips rasterized
+ * concurrently, each strip receiving the geometries intersecting it in their
+ * original order, so that the result is identical to the single-threaded
+ * one. This requires a transformer that can be cloned. This mode is not used
+ * with OPTIM=VECTOR, and OPTIM=AUTO then selects the raster mode.</li>
  * </ul>
  * @param pfnProgress the progress function to report completion.
  * @param pProgressArg callback data for progress function.
@@ -841,11 +1164,12 @@ CPLErr GDALRasterizeGeometries( GDALDatasetH hDS,
     int nXBlockSize, nYBlockSize;
     poBand->GetBlockSize(&nXBlockSize, &nYBlockSize);
 
+    const int nThreads = GDALRasterizeGetNumThreads(papszOptions);
     if( eOptim == GRO_Auto )
     {
         eOptim = GRO_Raster;
         // TODO make more tests with various inputs/outputs to adjust the parameters
-        if( nYBlockSize > 1 && nGeomCount > 10000 && (poBand->GetXSize() * static_cast<long long>(poBand->GetYSize()) / nGeomCount > 50) )
+        if( nThreads == 1 && nYBlockSize > 1 && nGeomCount > 10000 && (poBand->GetXSize() * static_cast<long long>(poBand->GetYSize()) / nGeomCount > 50) )
         {
             eOptim = GRO_Vector;
             CPLDebug("GDAL", "The vector optim has been chosen automatically");
@@ -900,6 +1224,29 @@ CPLErr GDALRasterizeGeometries( GDALDatasetH hDS,
             return CE_Failure;
         }
 
+/* -------------------------------------------------------------------- */
+/*      Setup the worker threads if requested.                          */
+/* -------------------------------------------------------------------- */
+        GDALRasterizeJobContext sJobContext;
+        std::vector<GDALRasterizeWorker> asWorkers;
+        std::unique_ptr<CPLJobQueue> poJobQueue;
+        if( nThreads > 1 && nYChunkSize > 1 )
+        {
+            sJobContext.nGeomCount = nGeomCount;
+            sJobContext.pahGeometries = pahGeometries;
+            sJobContext.padfGeomBurnValue = padfGeomBurnValue;
+            sJobContext.nBandCount = nBandCount;
+            sJobContext.eType = eType;
+            sJobContext.bAllTouched = bAllTouched;
+            sJobContext.eBurnValueSource = eBurnValueSource;
+            sJobContext.eMergeAlg = eMergeAlg;
+            sJobContext.nRasterXSize = poDS->GetRasterXSize();
+            sJobContext.nRasterYSize = poDS->GetRasterYSize();
+            poJobQueue = GDALRasterizeSetupWorkers(nThreads, &sJobContext,
+                                                   asWorkers, pfnTransformer,
+                                                   pTransformArg);
+        }
+
 /* ==================================================================== */
 /*      Loop over image in designated chunks.                           */
 /* ==================================================================== */
@@ -923,7 +1270,14 @@ CPLErr GDALRasterizeGeometries( GDALDatasetH hDS,
             if( eErr != CE_None )
                 break;
 
-            for( int iShape = 0; iShape < nGeomCount; iShape++ )
+            if( poJobQueue )
+            {
+                GDALRasterizeChunkMultiThreaded( &sJobContext, asWorkers,
+                                                 poJobQueue.get(),
+                                                 pabyChunkBuf, iY,
+                                                 nThisYChunkSize );
+            }
+            for( int iShape = 0; !poJobQueue && iShape < nGeomCount; iShape++ )
             {
                 gv_rasterize_one_shape( pabyChunkBuf, 0, iY,
                                         poDS->GetRasterXSize(), nThisYChunkSize,
@@ -952,6 +1306,12 @@ CPLErr GDALRasterizeGeometries( GDALDatasetH hDS,
                 eErr = CE_Failure;
             }
         }
+
+        for( auto &sWorker: asWorkers )
+        {
+            if( sWorker.pTransformArg )
+                GDALDestroyTransformer( sWorker.pTransformArg );
+        }
     }
 /* -------------------------------------------------------------------- */
 /*      The new algorithm                                               */
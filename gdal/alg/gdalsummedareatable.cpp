@@ -0,0 +1,480 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Summed area tables (integral images) for fast window averages.
+ * Author:   GDAL contributors
+ *
+ ******************************************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gdal_alg.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_progress.h"
+#include "cpl_vsi.h"
+#include "gdal.h"
+#include "gdal_priv.h"
+
+CPL_CVSID("$Id$")
+
+/*! @cond Doxygen_Suppress */
+struct GDALSummedAreaTable
+{
+    int      nXSize = 0;
+    int      nYSize = 0;
+
+    // (nXSize + 1) * (nYSize + 1) cumulated sums of the valid pixel values,
+    // with a first row and column of zeroes.
+    double  *padfSum = nullptr;
+
+    // Same layout for the count of valid pixels. Only allocated once an
+    // invalid pixel has been met: otherwise counts are the window area.
+    double  *padfCount = nullptr;
+
+    ~GDALSummedAreaTable()
+    {
+        VSIFree(padfSum);
+        VSIFree(padfCount);
+    }
+
+    inline size_t Idx( int iX, int iY ) const
+    {
+        return static_cast<size_t>(iY) * (nXSize + 1) + iX;
+    }
+
+    // Sum over the pixels [nX0, nX1[ x [nY0, nY1[
+    inline double RectSum( const double* padfTable,
+                           int nX0, int nY0, int nX1, int nY1 ) const
+    {
+        return padfTable[Idx(nX1, nY1)] - padfTable[Idx(nX0, nY1)] -
+               padfTable[Idx(nX1, nY0)] + padfTable[Idx(nX0, nY0)];
+    }
+
+    void GetWeightedSum( double dfXOff, double dfYOff,
+                         double dfXSize, double dfYSize,
+                         double* pdfSum, double* pdfCount ) const;
+};
+
+/************************************************************************/
+/*                          GetEdgeRanges()                             */
+/************************************************************************/
+
+// Split [dfOff, dfOff + dfSize[ into at most 3 ranges of pixels, each with a
+// constant coverage weight: a partially covered first pixel, fully covered
+// middle pixels and a partially covered last pixel.
+static int GetEdgeRanges( double dfOff, double dfSize, int nMax,
+                          int anStart[3], int anEnd[3], double adfWeight[3] )
+{
+    const double dfEnd = std::min(dfOff + dfSize, static_cast<double>(nMax));
+    dfOff = std::max(dfOff, 0.0);
+    if( !(dfEnd > dfOff) )
+        return 0;
+
+    const int nFirst = static_cast<int>(std::floor(dfOff));
+    const int nLast = std::min(nMax - 1,
+                               static_cast<int>(std::ceil(dfEnd)) - 1);
+    if( nFirst == nLast )
+    {
+        anStart[0] = nFirst;
+        anEnd[0] = nFirst + 1;
+        adfWeight[0] = dfEnd - dfOff;
+        return 1;
+    }
+
+    int nRanges = 0;
+    anStart[nRanges] = nFirst;
+    anEnd[nRanges] = nFirst + 1;
+    adfWeight[nRanges] = (nFirst + 1) - dfOff;
+    nRanges++;
+    if( nLast > nFirst + 1 )
+    {
+        anStart[nRanges] = nFirst + 1;
+        anEnd[nRanges] = nLast;
+        adfWeight[nRanges] = 1.0;
+        nRanges++;
+    }
+    anStart[nRanges] = nLast;
+    anEnd[nRanges] = nLast + 1;
+    adfWeight[nRanges] = dfEnd - nLast;
+    nRanges++;
+    return nRanges;
+}
+
+/************************************************************************/
+/*                          GetWeightedSum()                            */
+/************************************************************************/
+
+void GDALSummedAreaTable::GetWeightedSum( double dfXOff, double dfYOff,
+                                          double dfXSize, double dfYSize,
+                                          double* pdfSum,
+                                          double* pdfCount ) const
+{
+    int anXStart[3], anXEnd[3], anYStart[3], anYEnd[3];
+    double adfXWeight[3], adfYWeight[3];
+    const int nXRanges = GetEdgeRanges(dfXOff, dfXSize, nXSize,
+                                       anXStart, anXEnd, adfXWeight);
+    const int nYRanges = GetEdgeRanges(dfYOff, dfYSize, nYSize,
+                                       anYStart, anYEnd, adfYWeight);
+    double dfSum = 0.0;
+    double dfCount = 0.0;
+    for( int iY = 0; iY < nYRanges; iY++ )
+    {
+        for( int iX = 0; iX < nXRanges; iX++ )
+        {
+            const double dfWeight = adfXWeight[iX] * adfYWeight[iY];
+            dfSum += dfWeight * RectSum(padfSum, anXStart[iX], anYStart[iY],
+                                        anXEnd[iX], anYEnd[iY]);
+            if( padfCount )
+            {
+                dfCount += dfWeight * RectSum(padfCount,
+                                              anXStart[iX], anYStart[iY],
+                                              anXEnd[iX], anYEnd[iY]);
+            }
+            else
+            {
+                dfCount += dfWeight *
+                    (anXEnd[iX] - anXStart[iX]) * (anYEnd[iY] - anYStart[iY]);
+            }
+        }
+    }
+    *pdfSum = dfSum;
+    *pdfCount = dfCount;
+}
+/*! @endcond */
+
+/************************************************************************/
+/*                     GDALCreateSummedAreaTable()                      */
+/************************************************************************/
+
+/**
+ * Compute the summed area table of a raster band.
+ *
+ * A summed area table (also known as integral image) stores, for each pixel,
+ * the sum of the values of all the pixels above and on the left of it. Once
+ * computed, the sum, count of valid pixels and mean value of any rectangular
+ * window of the band can be obtained in constant time with
+ * GDALSummedAreaTableGetSum(), which is much faster than reading the window
+ * when many windows, or large ones, are queried on the same band.
+ *
+ * Pixels masked by the mask band of hBand (nodata, alpha, ...), as well as
+ * NaN values, are ignored. The real part of complex values is used.
+ *
+ * The table is held in memory and takes 8 bytes per pixel, and another
+ * 8 bytes per pixel if the band has invalid pixels. Sums are accumulated in
+ * double precision, so they are exact for integer bands as long as the sum of
+ * the whole band absolute values is lower than 2^53.
+ *
+ * @param hBand the band to process.
+ * @param papszOptions options. None currently, should be NULL.
+ * @param pfnProgress progress function, or NULL.
+ * @param pProgressData progress function callback data.
+ *
+ * @return a summed area table to free with GDALDestroySummedAreaTable(), or
+ * NULL in case of error.
+ *
+ * @since GDAL 3.4
+ */
+GDALSummedAreaTable *
+GDALCreateSummedAreaTable( GDALRasterBandH hBand,
+                           CSLConstList papszOptions,
+                           GDALProgressFunc pfnProgress,
+                           void *pProgressData )
+{
+    VALIDATE_POINTER1(hBand, "GDALCreateSummedAreaTable", nullptr);
+    (void)papszOptions;
+
+    if( pfnProgress == nullptr )
+        pfnProgress = GDALDummyProgress;
+
+    GDALRasterBand* poBand = GDALRasterBand::FromHandle(hBand);
+    const int nXSize = poBand->GetXSize();
+    const int nYSize = poBand->GetYSize();
+
+    auto poSAT = new GDALSummedAreaTable();
+    poSAT->nXSize = nXSize;
+    poSAT->nYSize = nYSize;
+    poSAT->padfSum = static_cast<double*>(
+        VSI_MALLOC3_VERBOSE(nXSize + 1, nYSize + 1, sizeof(double)));
+    if( poSAT->padfSum == nullptr )
+    {
+        delete poSAT;
+        return nullptr;
+    }
+    memset(poSAT->padfSum, 0, (nXSize + 1) * sizeof(double));
+
+    GDALRasterBand* poMaskBand = nullptr;
+    if( poBand->GetMaskFlags() != GMF_ALL_VALID )
+        poMaskBand = poBand->GetMaskBand();
+    const bool bCheckNaN =
+        CPL_TO_BOOL(GDALDataTypeIsFloating(poBand->GetRasterDataType()));
+
+    // Read by chunks of whole blocks rows, of about 1 million pixels.
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    int nChunkYSize = std::max(1, 1024 * 1024 / std::max(1, nXSize));
+    if( nChunkYSize > nBlockYSize )
+        nChunkYSize = (nChunkYSize / nBlockYSize) * nBlockYSize;
+    else
+        nChunkYSize = nBlockYSize;
+    nChunkYSize = std::min(nChunkYSize, nYSize);
+
+    double* padfLines = static_cast<double*>(
+        VSI_MALLOC3_VERBOSE(nXSize, nChunkYSize, sizeof(double)));
+    GByte* pabyMask = poMaskBand ? static_cast<GByte*>(
+        VSI_MALLOC2_VERBOSE(nXSize, nChunkYSize)) : nullptr;
+    if( padfLines == nullptr || (poMaskBand && pabyMask == nullptr) )
+    {
+        VSIFree(padfLines);
+        VSIFree(pabyMask);
+        delete poSAT;
+        return nullptr;
+    }
+
+    CPLErr eErr = CE_None;
+    for( int iYChunk = 0; eErr == CE_None && iYChunk < nYSize;
+         iYChunk += nChunkYSize )
+    {
+        const int nLines = std::min(nChunkYSize, nYSize - iYChunk);
+        eErr = poBand->RasterIO(GF_Read, 0, iYChunk, nXSize, nLines,
+                                padfLines, nXSize, nLines, GDT_Float64,
+                                0, 0, nullptr);
+        if( eErr == CE_None && poMaskBand )
+        {
+            eErr = poMaskBand->RasterIO(GF_Read, 0, iYChunk, nXSize, nLines,
+                                        pabyMask, nXSize, nLines, GDT_Byte,
+                                        0, 0, nullptr);
+        }
+        if( eErr != CE_None )
+            break;
+
+        for( int iLine = 0; iLine < nLines; iLine++ )
+        {
+            const int iY = iYChunk + iLine + 1;
+            const double* padfLine =
+                padfLines + static_cast<size_t>(iLine) * nXSize;
+            const GByte* pabyMaskLine = pabyMask ?
+                pabyMask + static_cast<size_t>(iLine) * nXSize : nullptr;
+            double* padfSumLine = poSAT->padfSum + poSAT->Idx(0, iY);
+            const double* padfSumPrevLine =
+                poSAT->padfSum + poSAT->Idx(0, iY - 1);
+
+            double dfLineSum = 0.0;
+            int nLineCount = 0;
+            padfSumLine[0] = 0.0;
+            for( int iX = 0; iX < nXSize; iX++ )
+            {
+                const double dfVal = padfLine[iX];
+                if( (pabyMaskLine && pabyMaskLine[iX] == 0) ||
+                    (bCheckNaN && std::isnan(dfVal)) )
+                {
+                    if( poSAT->padfCount == nullptr )
+                    {
+                        // First invalid pixel: materialize the counts of
+                        // the previous (all valid) pixels.
+                        poSAT->padfCount = static_cast<double*>(
+                            VSI_MALLOC3_VERBOSE(nXSize + 1, nYSize + 1,
+                                                sizeof(double)));
+                        if( poSAT->padfCount == nullptr )
+                        {
+                            eErr = CE_Failure;
+                            break;
+                        }
+                        for( int iPrevY = 0; iPrevY < iY; iPrevY++ )
+                        {
+                            for( int iPrevX = 0; iPrevX <= nXSize; iPrevX++ )
+                            {
+                                poSAT->padfCount[poSAT->Idx(iPrevX, iPrevY)] =
+                                    static_cast<double>(iPrevX) * iPrevY;
+                            }
+                        }
+                        double* padfCountLine =
+                            poSAT->padfCount + poSAT->Idx(0, iY);
+                        for( int iPrevX = 0; iPrevX <= iX; iPrevX++ )
+                        {
+                            padfCountLine[iPrevX] =
+                                static_cast<double>(iPrevX) * iY;
+                        }
+                    }
+                }
+                else
+                {
+                    dfLineSum += dfVal;
+                    nLineCount++;
+                }
+                padfSumLine[iX + 1] = padfSumPrevLine[iX + 1] + dfLineSum;
+                if( poSAT->padfCount )
+                {
+                    poSAT->padfCount[poSAT->Idx(iX + 1, iY)] =
+                        poSAT->padfCount[poSAT->Idx(iX + 1, iY - 1)] +
+                        nLineCount;
+                }
+            }
+            if( eErr != CE_None )
+                break;
+            if( poSAT->padfCount )
+                poSAT->padfCount[poSAT->Idx(0, iY)] = 0.0;
+        }
+
+        if( eErr == CE_None &&
+            !pfnProgress(static_cast<double>(iYChunk + nLines) / nYSize,
+                         "", pProgressData) )
+        {
+            CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+            eErr = CE_Failure;
+        }
+    }
+
+    VSIFree(padfLines);
+    VSIFree(pabyMask);
+
+    if( eErr != CE_None )
+    {
+        delete poSAT;
+        return nullptr;
+    }
+    return poSAT;
+}
+
+/************************************************************************/
+/*                     GDALDestroySummedAreaTable()                     */
+/************************************************************************/
+
+/**
+ * Free a summed area table.
+ *
+ * @param psSAT table returned by GDALCreateSummedAreaTable(), or NULL.
+ *
+ * @since GDAL 3.4
+ */
+void GDALDestroySummedAreaTable( GDALSummedAreaTable* psSAT )
+{
+    delete psSAT;
+}
+
+/************************************************************************/
+/*                     GDALSummedAreaTableGetSum()                      */
+/************************************************************************/
+
+/**
+ * Compute the sum and count of the valid pixels of a window.
+ *
+ * The window may be expressed with non-integer coordinates. Pixels partially
+ * covered by the window are weighted by their covered fraction, as done by
+ * average resampling. The part of the window outside of the raster is
+ * ignored.
+ *
+ * The mean value of the window is *pdfSum / *pdfCount, when *pdfCount is not
+ * zero.
+ *
+ * @param psSAT table returned by GDALCreateSummedAreaTable().
+ * @param dfXOff pixel offset of the window.
+ * @param dfYOff line offset of the window.
+ * @param dfXSize width of the window in pixels.
+ * @param dfYSize height of the window in lines.
+ * @param pdfSum pointer to the (weighted) sum of the valid pixel values.
+ * @param pdfCount pointer to the (weighted) count of valid pixels, or NULL.
+ *
+ * @return TRUE if the window contains at least one valid pixel.
+ *
+ * @since GDAL 3.4
+ */
+int GDALSummedAreaTableGetSum( const GDALSummedAreaTable* psSAT,
+                               double dfXOff, double dfYOff,
+                               double dfXSize, double dfYSize,
+                               double* pdfSum, double* pdfCount )
+{
+    VALIDATE_POINTER1(psSAT, "GDALSummedAreaTableGetSum", FALSE);
+    VALIDATE_POINTER1(pdfSum, "GDALSummedAreaTableGetSum", FALSE);
+
+    double dfCount = 0.0;
+    psSAT->GetWeightedSum(dfXOff, dfYOff, dfXSize, dfYSize, pdfSum, &dfCount);
+    if( pdfCount )
+        *pdfCount = dfCount;
+    return dfCount > 0.0;
+}
+
+/************************************************************************/
+/*                     GDALSummedAreaTableAverage()                     */
+/************************************************************************/
+
+/**
+ * Resample a window of the band with average resampling.
+ *
+ * Each of the nBufXSize * nBufYSize output values is the average of the
+ * valid pixels of the corresponding part of the window, computed from the
+ * summed area table in constant time whatever the downsampling factor.
+ *
+ * @param psSAT table returned by GDALCreateSummedAreaTable().
+ * @param dfXOff pixel offset of the window.
+ * @param dfYOff line offset of the window.
+ * @param dfXSize width of the window in pixels.
+ * @param dfYSize height of the window in lines.
+ * @param padfBuffer output buffer of nBufXSize * nBufYSize values, in
+ *                   row-major order.
+ * @param nBufXSize width of the output buffer.
+ * @param nBufYSize height of the output buffer.
+ * @param dfNoDataValue value written for output pixels without any valid
+ *                      source pixel.
+ *
+ * @return CE_None in case of success, CE_Failure in case of failure.
+ *
+ * @since GDAL 3.4
+ */
+CPLErr GDALSummedAreaTableAverage( const GDALSummedAreaTable* psSAT,
+                                   double dfXOff, double dfYOff,
+                                   double dfXSize, double dfYSize,
+                                   double* padfBuffer,
+                                   int nBufXSize, int nBufYSize,
+                                   double dfNoDataValue )
+{
+    VALIDATE_POINTER1(psSAT, "GDALSummedAreaTableAverage", CE_Failure);
+    VALIDATE_POINTER1(padfBuffer, "GDALSummedAreaTableAverage", CE_Failure);
+
+    if( nBufXSize <= 0 || nBufYSize <= 0 || !(dfXSize > 0) || !(dfYSize > 0) )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg, "Invalid window or buffer size");
+        return CE_Failure;
+    }
+
+    const double dfXRatio = dfXSize / nBufXSize;
+    const double dfYRatio = dfYSize / nBufYSize;
+    for( int iBufY = 0; iBufY < nBufYSize; iBufY++ )
+    {
+        const double dfSrcYOff = dfYOff + iBufY * dfYRatio;
+        for( int iBufX = 0; iBufX < nBufXSize; iBufX++ )
+        {
+            double dfSum = 0.0;
+            double dfCount = 0.0;
+            psSAT->GetWeightedSum(dfXOff + iBufX * dfXRatio, dfSrcYOff,
+                                  dfXRatio, dfYRatio, &dfSum, &dfCount);
+            padfBuffer[static_cast<size_t>(iBufY) * nBufXSize + iBufX] =
+                dfCount > 0.0 ? dfSum / dfCount : dfNoDataValue;
+        }
+    }
+    return CE_None;
+}
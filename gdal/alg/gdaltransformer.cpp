@@ -44,6 +44,7 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -54,6 +55,7 @@
 #include "cpl_vsi.h"
 #include "gdal.h"
 #include "gdal_priv.h"
+#include "gdalsse_priv.h"
 #include "ogr_core.h"
 #include "ogr_spatialref.h"
 #include "ogr_srs_api.h"
@@ -66,6 +68,7 @@ void *GDALDeserializeGCPTransformer( CPLXMLNode *psTree );
 void *GDALDeserializeTPSTransformer( CPLXMLNode *psTree );
 void *GDALDeserializeGeoLocTransformer( CPLXMLNode *psTree );
 void *GDALDeserializeRPCTransformer( CPLXMLNode *psTree );
+void *GDALDeserializeWarpPlanTransformer( CPLXMLNode *psTree );
 CPL_C_END
 
 static CPLXMLNode *GDALSerializeReprojectionTransformer( void *pTransformArg );
@@ -1544,6 +1547,11 @@ bool GDALComputeAreaOfInterest(OGRSpatialReference* poSRS,
  * <li> MAX_GCP_ORDER: the maximum order to use for GCP derived polynomials if
  * possible.  The default is to autoselect based on the number of GCPs.
  * A value of -1 triggers use of Thin Plate Spline instead of polynomials.
+ * <li> TPS_APPROX_GRID_SIZE: (GDAL &gt;= 3.4) When using a Thin Plate Spline,
+ * number of cells N of a N x N grid over the GCP extent on which the spline
+ * is tabulated and then bilinearly interpolated, instead of being evaluated
+ * exactly at each point. Speeds up transformations with thousands of GCPs,
+ * at the expense of not exactly honouring GCPs. Defaults to 0 (disabled).
  * <li> SRC_METHOD: may have a value which is one of GEOTRANSFORM,
  * GCP_POLYNOMIAL, GCP_TPS, GEOLOC_ARRAY, RPC to force only one geolocation
  * method to be considered on the source dataset. Will be used for pixel/line
@@ -3305,6 +3313,52 @@ GDALDeserializeReprojectionTransformer( CPLXMLNode *psTree )
 /* ==================================================================== */
 /************************************************************************/
 
+/************************************************************************/
+/*                       GDALApproxTransformGrid                        */
+/************************************************************************/
+
+// State of the 2D grid mode of the approximate transformer, enabled with
+// the GDAL_APPROX_TRANSFORMER_GRID_STEP configuration option.
+// It only applies to rows of regularly spaced points (x[i] = x[0] + i, with
+// constant y and z), as the warp kernels use. The base transformer is
+// evaluated on a coarse grid of node rows every nGridStep lines, with a node
+// every nGridStep points, and the result is bilinearly interpolated inside
+// the cells where the interpolation is accurate enough. Accuracy is checked
+// at the middle of the edges and at the center of each cell. Rows of the
+// cells that fail the check are transformed with the 1D approximation.
+struct GDALApproxTransformGrid
+{
+    struct Row
+    {
+        bool                bValid = false;
+        GIntBig             nIndex = 0;
+        GUIntBig            nLastUse = 0;
+        // 2 * nCols - 1 points: the nodes are at even indices, and the
+        // middle of the segments between nodes at odd indices.
+        std::vector<double> adfX{};
+        std::vector<double> adfY{};
+        std::vector<double> adfZ{};
+        std::vector<int>    abSuccess{};
+    };
+
+    // Rows the grid has been computed for.
+    int                 bDstToSrc = FALSE;
+    int                 nPoints = 0;
+    double              dfX0 = 0;
+    double              dfZ0 = 0;
+
+    // Offset in the rows of each node column.
+    std::vector<int>    anColOffset{};
+
+    GUIntBig            nUseCounter = 0;
+    Row                 aoNodeRows[3]{};
+
+    // Points at mid-height of the cells between node rows nIndex and
+    // nIndex + 1, and whether the interpolation is accurate in those cells.
+    Row                 oMidRow{};
+    std::vector<bool>   abCellOK{};
+};
+
 typedef struct
 {
     GDALTransformerInfo sTI;
@@ -3315,6 +3369,10 @@ typedef struct
     double dfMaxErrorReverse;
 
     int bOwnSubtransformer;
+
+    // Step of the 2D grid mode (GDAL_APPROX_TRANSFORMER_GRID_STEP), or 0.
+    int nGridStep;
+    GDALApproxTransformGrid *poGrid;
 } ApproxTransformInfo;
 
 /************************************************************************/
@@ -3335,6 +3393,7 @@ GDALCreateSimilarApproxTransformer( void *hTransformArg,
         CPLMalloc(sizeof(ApproxTransformInfo)));
 
     memcpy(psClonedInfo, psInfo, sizeof(ApproxTransformInfo));
+    psClonedInfo->poGrid = nullptr;
     if( psClonedInfo->pBaseCBData )
     {
         psClonedInfo->pBaseCBData =
@@ -3464,6 +3523,9 @@ void *GDALCreateApproxTransformer2( GDALTransformerFunc pfnBaseTransformer,
     psATInfo->dfMaxErrorForward = dfMaxErrorForward;
     psATInfo->dfMaxErrorReverse = dfMaxErrorReverse;
     psATInfo->bOwnSubtransformer = FALSE;
+    psATInfo->nGridStep = std::max(0, atoi(
+        CPLGetConfigOption("GDAL_APPROX_TRANSFORMER_GRID_STEP", "0")));
+    psATInfo->poGrid = nullptr;
 
     memcpy(psATInfo->sTI.abySignature,
            GDAL_GTI2_SIGNATURE,
@@ -3514,9 +3576,20 @@ void GDALDestroyApproxTransformer( void * pCBData )
     if( psATInfo->bOwnSubtransformer )
         GDALDestroyTransformer( psATInfo->pBaseCBData );
 
+    delete psATInfo->poGrid;
     CPLFree( pCBData );
 }
 
+/************************************************************************/
+/*                   GDALApproxTransformerResetGrid()                   */
+/************************************************************************/
+
+static void GDALApproxTransformerResetGrid( ApproxTransformInfo *psATInfo )
+{
+    delete psATInfo->poGrid;
+    psATInfo->poGrid = nullptr;
+}
+
 /************************************************************************/
 /*                  GDALRefreshApproxTransformer()                      */
 /************************************************************************/
@@ -3530,6 +3603,7 @@ void GDALRefreshApproxTransformer( void* hTransformArg )
     {
         GDALRefreshGenImgProjTransformer( psInfo->pBaseCBData );
     }
+    GDALApproxTransformerResetGrid( psInfo );
 }
 
 /************************************************************************/
@@ -3818,6 +3892,283 @@ static int GDALApproxTransformInternal( void *pCBData, int bDstToSrc,
     return TRUE;
 }
 
+static int GDALApproxTransform1D( ApproxTransformInfo *psATInfo,
+                                  int bDstToSrc, int nPoints,
+                                  double *x, double *y, double *z,
+                                  int *panSuccess );
+
+/************************************************************************/
+/*                    GDALApproxTransformGridGetRow()                   */
+/************************************************************************/
+
+// Returns the node row of index nIndex (bMidRow = false), or the row at
+// mid-height between node rows nIndex and nIndex + 1 (bMidRow = true),
+// transforming it if needed.
+static const GDALApproxTransformGrid::Row *
+GDALApproxTransformGridGetRow( ApproxTransformInfo *psATInfo,
+                               GIntBig nIndex, bool bMidRow )
+{
+    GDALApproxTransformGrid *poGrid = psATInfo->poGrid;
+    GDALApproxTransformGrid::Row *poRow = nullptr;
+    if( bMidRow )
+    {
+        poRow = &poGrid->oMidRow;
+        if( poRow->bValid && poRow->nIndex == nIndex )
+            return poRow;
+    }
+    else
+    {
+        for( auto& oRow: poGrid->aoNodeRows )
+        {
+            if( oRow.bValid && oRow.nIndex == nIndex )
+            {
+                oRow.nLastUse = ++poGrid->nUseCounter;
+                return &oRow;
+            }
+        }
+        // Evict the least recently used row.
+        poRow = &poGrid->aoNodeRows[0];
+        for( auto& oRow: poGrid->aoNodeRows )
+        {
+            if( !oRow.bValid )
+            {
+                poRow = &oRow;
+                break;
+            }
+            if( oRow.nLastUse < poRow->nLastUse )
+                poRow = &oRow;
+        }
+    }
+
+    const int nCols = static_cast<int>(poGrid->anColOffset.size());
+    const int nRowPoints = 2 * nCols - 1;
+    const double dfY = (static_cast<double>(nIndex) + (bMidRow ? 0.5 : 0.0)) *
+                       psATInfo->nGridStep;
+    poRow->adfX.resize(nRowPoints);
+    poRow->adfY.resize(nRowPoints);
+    poRow->adfZ.resize(nRowPoints);
+    poRow->abSuccess.resize(nRowPoints);
+    for( int i = 0; i < nRowPoints; i++ )
+    {
+        const double dfOffset = (i % 2) == 0 ?
+            poGrid->anColOffset[i / 2] :
+            0.5 * (poGrid->anColOffset[i / 2] + poGrid->anColOffset[i / 2 + 1]);
+        poRow->adfX[i] = poGrid->dfX0 + dfOffset;
+        poRow->adfY[i] = dfY;
+        poRow->adfZ[i] = poGrid->dfZ0;
+        poRow->abSuccess[i] = FALSE;
+    }
+    psATInfo->pfnBaseTransformer( psATInfo->pBaseCBData, poGrid->bDstToSrc,
+                                  nRowPoints,
+                                  poRow->adfX.data(), poRow->adfY.data(),
+                                  poRow->adfZ.data(),
+                                  poRow->abSuccess.data() );
+    poRow->bValid = true;
+    poRow->nIndex = nIndex;
+    poRow->nLastUse = ++poGrid->nUseCounter;
+    return poRow;
+}
+
+/************************************************************************/
+/*                    GDALApproxTransformInterpolate()                  */
+/************************************************************************/
+
+// padfOut[i] = dfStart + dfSlope * i, for i in [0, nCount[
+static void GDALApproxTransformInterpolate( double *padfOut, int nCount,
+                                            double dfStart, double dfSlope )
+{
+    int i = 0;
+    const XMMReg2Double oStart = XMMReg2Double::Load1ValHighAndLow(&dfStart);
+    const XMMReg2Double oSlope = XMMReg2Double::Load1ValHighAndLow(&dfSlope);
+    const double dfTwo = 2.0;
+    const XMMReg2Double oTwo = XMMReg2Double::Load1ValHighAndLow(&dfTwo);
+    const double adfIndex[2] = { 0.0, 1.0 };
+    XMMReg2Double oIndex = XMMReg2Double::Load2Val(adfIndex);
+    for( ; i + 1 < nCount; i += 2 )
+    {
+        const XMMReg2Double oVal = oStart + oSlope * oIndex;
+        oVal.Store2Val(padfOut + i);
+        oIndex += oTwo;
+    }
+    for( ; i < nCount; i++ )
+    {
+        padfOut[i] = dfStart + dfSlope * i;
+    }
+}
+
+/************************************************************************/
+/*                     GDALApproxTransformGridMode()                    */
+/************************************************************************/
+
+// Returns -1 if the points are not a regular row that can be handled by the
+// 2D grid mode.
+static int GDALApproxTransformGridMode( ApproxTransformInfo *psATInfo,
+                                        int bDstToSrc, int nPoints,
+                                        double *x, double *y, double *z,
+                                        int *panSuccess )
+{
+    const double dfX0 = x[0];
+    const double dfY0 = y[0];
+    const double dfZ0 = z[0];
+    const int nStep = psATInfo->nGridStep;
+    if( !(std::isfinite(dfX0) && std::isfinite(dfZ0) &&
+          fabs(dfY0 / nStep) < 1e15) )
+        return -1;
+    for( int i = 0; i < nPoints; i++ )
+    {
+        if( x[i] != dfX0 + i || y[i] != dfY0 || z[i] != dfZ0 )
+            return -1;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      (Re)initialize the grid if the rows are not the same as the     */
+/*      previous ones.                                                  */
+/* -------------------------------------------------------------------- */
+    GDALApproxTransformGrid *poGrid = psATInfo->poGrid;
+    if( poGrid == nullptr || poGrid->bDstToSrc != bDstToSrc ||
+        poGrid->nPoints != nPoints || poGrid->dfX0 != dfX0 ||
+        poGrid->dfZ0 != dfZ0 )
+    {
+        delete poGrid;
+        poGrid = new GDALApproxTransformGrid();
+        psATInfo->poGrid = poGrid;
+        poGrid->bDstToSrc = bDstToSrc;
+        poGrid->nPoints = nPoints;
+        poGrid->dfX0 = dfX0;
+        poGrid->dfZ0 = dfZ0;
+        for( int i = 0; i < nPoints - 1; i += nStep )
+            poGrid->anColOffset.push_back(i);
+        poGrid->anColOffset.push_back(nPoints - 1);
+    }
+
+    const GIntBig nRow =
+        static_cast<GIntBig>(floor(dfY0 / nStep));
+    const GDALApproxTransformGrid::Row *poTop =
+        GDALApproxTransformGridGetRow( psATInfo, nRow, false );
+    const GDALApproxTransformGrid::Row *poBottom =
+        GDALApproxTransformGridGetRow( psATInfo, nRow + 1, false );
+    const int nCols = static_cast<int>(poGrid->anColOffset.size());
+
+/* -------------------------------------------------------------------- */
+/*      Check the accuracy of the interpolation in the cells.           */
+/* -------------------------------------------------------------------- */
+    if( !(poGrid->oMidRow.bValid && poGrid->oMidRow.nIndex == nRow) )
+    {
+        const GDALApproxTransformGrid::Row *poMid =
+            GDALApproxTransformGridGetRow( psATInfo, nRow, true );
+        const double dfMaxError = bDstToSrc ? psATInfo->dfMaxErrorReverse :
+                                              psATInfo->dfMaxErrorForward;
+        const auto GetError = [](
+            const GDALApproxTransformGrid::Row *poRow, int iPoint,
+            double dfX, double dfY)
+        {
+            return fabs(dfX - poRow->adfX[iPoint]) +
+                   fabs(dfY - poRow->adfY[iPoint]);
+        };
+        poGrid->abCellOK.resize(nCols - 1);
+        for( int k = 0; k < nCols - 1; k++ )
+        {
+            const int iA = 2 * k;
+            const int iB = 2 * k + 2;
+            bool bOK = true;
+            for( int i = iA; bOK && i <= iB; i++ )
+            {
+                bOK = poTop->abSuccess[i] && poBottom->abSuccess[i] &&
+                      poMid->abSuccess[i];
+            }
+            if( bOK )
+            {
+                const double adfAX[2] = { poTop->adfX[iA], poTop->adfY[iA] };
+                const double adfBX[2] = { poTop->adfX[iB], poTop->adfY[iB] };
+                const double adfCX[2] = { poBottom->adfX[iA],
+                                          poBottom->adfY[iA] };
+                const double adfDX[2] = { poBottom->adfX[iB],
+                                          poBottom->adfY[iB] };
+                // Middle of the top, bottom, left and right edges, and
+                // center of the cell.
+                bOK =
+                    GetError(poTop, iA + 1, 0.5 * (adfAX[0] + adfBX[0]),
+                             0.5 * (adfAX[1] + adfBX[1])) <= dfMaxError &&
+                    GetError(poBottom, iA + 1, 0.5 * (adfCX[0] + adfDX[0]),
+                             0.5 * (adfCX[1] + adfDX[1])) <= dfMaxError &&
+                    GetError(poMid, iA, 0.5 * (adfAX[0] + adfCX[0]),
+                             0.5 * (adfAX[1] + adfCX[1])) <= dfMaxError &&
+                    GetError(poMid, iB, 0.5 * (adfBX[0] + adfDX[0]),
+                             0.5 * (adfBX[1] + adfDX[1])) <= dfMaxError &&
+                    GetError(poMid, iA + 1,
+                             0.25 * (adfAX[0] + adfBX[0] + adfCX[0] + adfDX[0]),
+                             0.25 * (adfAX[1] + adfBX[1] + adfCX[1] + adfDX[1]))
+                        <= dfMaxError;
+            }
+            poGrid->abCellOK[k] = bOK;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Interpolate the accurate cells, and use the 1D approximation    */
+/*      for runs of other cells.                                        */
+/* -------------------------------------------------------------------- */
+    const double dfT = dfY0 / nStep - static_cast<double>(nRow);
+    int bRet = TRUE;
+    int iRunStart = -1;
+    for( int k = 0; k < nCols - 1; k++ )
+    {
+        const int iStart = poGrid->anColOffset[k];
+        // The last cell also includes its right edge.
+        const int iEnd = (k == nCols - 2) ? nPoints :
+                                            poGrid->anColOffset[k + 1];
+        if( !poGrid->abCellOK[k] )
+        {
+            if( iRunStart < 0 )
+                iRunStart = iStart;
+            if( k < nCols - 2 )
+                continue;
+        }
+        if( iRunStart >= 0 )
+        {
+            const int iRunEnd = poGrid->abCellOK[k] ? iStart : iEnd;
+            if( !GDALApproxTransform1D( psATInfo, bDstToSrc,
+                                        iRunEnd - iRunStart,
+                                        x + iRunStart, y + iRunStart,
+                                        z + iRunStart,
+                                        panSuccess + iRunStart ) )
+            {
+                bRet = FALSE;
+            }
+            iRunStart = -1;
+            if( !poGrid->abCellOK[k] )
+                continue;
+        }
+
+        const int iA = 2 * k;
+        const int iB = 2 * k + 2;
+        const double dfInvWidth =
+            1.0 / (poGrid->anColOffset[k + 1] - poGrid->anColOffset[k]);
+        const double dfLeftX = poTop->adfX[iA] +
+            dfT * (poBottom->adfX[iA] - poTop->adfX[iA]);
+        const double dfRightX = poTop->adfX[iB] +
+            dfT * (poBottom->adfX[iB] - poTop->adfX[iB]);
+        const double dfLeftY = poTop->adfY[iA] +
+            dfT * (poBottom->adfY[iA] - poTop->adfY[iA]);
+        const double dfRightY = poTop->adfY[iB] +
+            dfT * (poBottom->adfY[iB] - poTop->adfY[iB]);
+        const double dfLeftZ = poTop->adfZ[iA] +
+            dfT * (poBottom->adfZ[iA] - poTop->adfZ[iA]);
+        const double dfRightZ = poTop->adfZ[iB] +
+            dfT * (poBottom->adfZ[iB] - poTop->adfZ[iB]);
+        GDALApproxTransformInterpolate( x + iStart, iEnd - iStart, dfLeftX,
+                                        (dfRightX - dfLeftX) * dfInvWidth );
+        GDALApproxTransformInterpolate( y + iStart, iEnd - iStart, dfLeftY,
+                                        (dfRightY - dfLeftY) * dfInvWidth );
+        GDALApproxTransformInterpolate( z + iStart, iEnd - iStart, dfLeftZ,
+                                        (dfRightZ - dfLeftZ) * dfInvWidth );
+        for( int i = iStart; i < iEnd; i++ )
+            panSuccess[i] = TRUE;
+    }
+
+    return bRet;
+}
+
 /************************************************************************/
 /*                        GDALApproxTransform()                         */
 /************************************************************************/
@@ -3836,6 +4187,30 @@ int GDALApproxTransform( void *pCBData, int bDstToSrc, int nPoints,
 
 {
     ApproxTransformInfo *psATInfo = static_cast<ApproxTransformInfo *>(pCBData);
+    if( psATInfo->nGridStep > 0 && nPoints > psATInfo->nGridStep &&
+        (psATInfo->dfMaxErrorForward != 0.0 ||
+         psATInfo->dfMaxErrorReverse != 0.0) )
+    {
+        const int bRet = GDALApproxTransformGridMode( psATInfo, bDstToSrc,
+                                                      nPoints, x, y, z,
+                                                      panSuccess );
+        if( bRet >= 0 )
+            return bRet;
+    }
+    return GDALApproxTransform1D( psATInfo, bDstToSrc, nPoints,
+                                  x, y, z, panSuccess );
+}
+
+/************************************************************************/
+/*                       GDALApproxTransform1D()                        */
+/************************************************************************/
+
+static int GDALApproxTransform1D( ApproxTransformInfo *psATInfo,
+                                  int bDstToSrc, int nPoints,
+                                  double *x, double *y, double *z,
+                                  int *panSuccess )
+
+{
     double x2[3] = {};
     double y2[3] = {};
     double z2[3] = {};
@@ -3882,7 +4257,7 @@ int GDALApproxTransform( void *pCBData, int bDstToSrc, int nPoints,
         goto end;
     }
 
-    bRet = GDALApproxTransformInternal( pCBData, bDstToSrc, nPoints,
+    bRet = GDALApproxTransformInternal( psATInfo, bDstToSrc, nPoints,
                                         x, y, z, panSuccess,
                                         x2,
                                         y2,
@@ -4233,6 +4608,11 @@ CPLErr GDALDeserializeTransformer( CPLXMLNode *psTree,
         *ppfnFunc = GDALApproxTransform;
         *ppTransformArg = GDALDeserializeApproxTransformer( psTree );
     }
+    else if( EQUAL(psTree->pszValue, "WarpPlanTransformer") )
+    {
+        *ppfnFunc = GDALWarpPlanTransform;
+        *ppTransformArg = GDALDeserializeWarpPlanTransformer( psTree );
+    }
     else
     {
         GDALTransformDeserializeFunc pfnDeserializeFunc = nullptr;
@@ -4481,6 +4861,12 @@ void GDALSetTransformerDstGeoTransform( void *pTransformArg,
         "GDALSetTransformerDstGeoTransform", pTransformArg );
     if( psInfo )
     {
+        if( psInfo != pTransformArg )
+        {
+            // Cached results of the approximate transformer are invalidated.
+            GDALApproxTransformerResetGrid(
+                static_cast<ApproxTransformInfo *>(pTransformArg));
+        }
         GDALSetGenImgProjTransformerDstGeoTransform(psInfo, padfGeoTransform);
     }
 }
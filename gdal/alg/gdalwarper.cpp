@@ -1110,7 +1110,13 @@ GDALWarpDstAlphaMasker( void *pMaskFuncArg, int nBandCount,
  * destination (INIT_DEST) and all other processing, and so should be used
  * carefully.  Mostly useful to short circuit a lot of extra work in mosaicing
  * situations. Starting with GDAL 2.4, gdalwarp will automatically enable this
- * option when it is assumed to be safe to do so.</li>
+ * option when it is assumed to be safe to do so. Starting with GDAL 3.4, chunks
+ * whose source window is reported by GDALGetDataCoverageStatus() to only
+ * contain holes (for example missing tiles of a sparse GeoTIFF file) are also
+ * skipped, provided those holes are invalid source pixels, that is the source
+ * alpha band is used, or all bands have a nodata value equal to the source
+ * nodata value. This can be disabled by setting the
+ * GDALWARP_SKIP_EMPTY_SOURCE configuration option to NO.</li>
  *
  * <li>UNIFIED_SRC_NODATA=YES/NO: By default nodata masking values considered
  * independently for each band.  However, sometimes it is desired to treat all
@@ -1147,6 +1153,14 @@ GDALWarpDstAlphaMasker( void *pMaskFuncArg, int nBandCount,
  * set the number of threads to use to parallelize the computation part of the
  * warping. If not set, computation will be done in a single thread.</li>
  *
+ * <li>NUM_CHUNKS_IN_FLIGHT: (GDAL >= 3.4) Can be set to a numeric value
+ * (between 2 and 64) or ALL_CPUS to set the number of chunks processed at
+ * the same time by GDALWarpOperation::ChunkAndWarpMulti(). Input/output of
+ * the chunks is serialized, but their warping is done concurrently, unless
+ * STREAMABLE_OUTPUT is set or chunk processors are installed. The chunks are
+ * made smaller so that the memory used by all chunks in flight stays bounded
+ * by twice dfWarpMemoryLimit. Defaults to 2.</li>
+ *
  * <li>STREAMABLE_OUTPUT: (GDAL >= 2.0) This defaults to FALSE, but may
  * be set to TRUE typically when writing to a streamed file. The
  * gdalwarp utility automatically sets this option when writing to
@@ -46,10 +46,12 @@
 
 #include "cpl_atomic_ops.h"
 #include "cpl_conv.h"
+#include "cpl_cpu_features.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 #include "cpl_worker_thread_pool.h"
 #include "gdal.h"
@@ -57,10 +59,12 @@
 #include "gdal_alg_priv.h"
 #include "gdal_thread_pool.h"
 #include "gdalwarpkernel_opencl.h"
+#include "gdalwarpkernel_avx2.h"
 
-// We restrict to 64bit processors because they are guaranteed to have SSE2.
-// Could possibly be used too on 32bit, but we would need to check at runtime.
-#if defined(__x86_64) || defined(_M_X64)
+// We restrict to 64bit processors because they are guaranteed to have SSE2
+// (or NEON on AArch64). Could possibly be used too on 32bit, but we would
+// need to check at runtime.
+#if defined(__x86_64) || defined(_M_X64) || defined(__aarch64__)
 #include "gdalsse_priv.h"
 
 #if __SSE4_1__
@@ -406,6 +410,7 @@ static void ThreadFuncAdapter(void* pData)
     }
 
     psJob->pTransformerArg = pTransformerArg;
+    CPL_TRACE_SPAN("warp", "GWK job");
     psJob->pfnFunc(pData);
 }
 
@@ -444,9 +449,9 @@ static CPLErr GWKRun( GDALWarpKernel *poWK,
 
     int nThreads = std::min(psThreadData->nThreads, nDstYSize / 2);
     // Config option mostly useful for tests to be able to test multithreading
-    // with small rasters
+    // with small rasters. May also be selected by GDALAutotune()
     const int nWarpChunkSize = atoi(
-        CPLGetConfigOption("WARP_THREAD_CHUNK_SIZE", "65536"));
+        GDALGetTunedConfigOption("WARP_THREAD_CHUNK_SIZE", "65536"));
     if( nWarpChunkSize > 0 )
     {
         GIntBig nChunks =
@@ -995,6 +1000,14 @@ GDALWarpKernel::~GDALWarpKernel() {}
 CPLErr GDALWarpKernel::PerformWarp()
 
 {
+    CPLTraceSpan oSpan("warp", "GDALWarpKernel::PerformWarp");
+    if( oSpan.IsActive() )
+    {
+        oSpan.AddArg("resampling", static_cast<GIntBig>(eResample));
+        oSpan.AddArg("dst_x_size", nDstXSize);
+        oSpan.AddArg("dst_y_size", nDstYSize);
+    }
+
     const CPLErr eErr = Validate();
 
     if( eErr != CE_None )
@@ -2718,6 +2731,58 @@ static bool GWKCubicResample4Sample( const GDALWarpKernel *poWK, int iBand,
     return true;
 }
 
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+
+/************************************************************************/
+/*                     GWKCubicResample4SampleAVX2()                    */
+/************************************************************************/
+
+// Same as GWKCubicResample4Sample() for non-complex data types, with the
+// 4x4 kernel convolved with AVX2.
+static bool GWKCubicResample4SampleAVX2( const GDALWarpKernel *poWK, int iBand,
+                                         double dfSrcX, double dfSrcY,
+                                         double *pdfDensity,
+                                         double *pdfReal )
+
+{
+    const int iSrcX = static_cast<int>(dfSrcX - 0.5);
+    const int iSrcY = static_cast<int>(dfSrcY - 0.5);
+    double dfValueImagIgnored = 0.0;
+
+    // Get the bilinear interpolation at the image borders.
+    if( iSrcX - 1 < 0 || iSrcX + 2 >= poWK->nSrcXSize
+        || iSrcY - 1 < 0 || iSrcY + 2 >= poWK->nSrcYSize )
+        return GWKBilinearResample4Sample( poWK, iBand, dfSrcX, dfSrcY,
+                                           pdfDensity, pdfReal,
+                                           &dfValueImagIgnored );
+
+    const GPtrDiff_t iSrcOffset =
+        iSrcX - 1 + static_cast<GPtrDiff_t>(iSrcY - 1) * poWK->nSrcXSize;
+    const double dfDeltaX = dfSrcX - 0.5 - iSrcX;
+    const double dfDeltaY = dfSrcY - 0.5 - iSrcY;
+
+    double adfCoeffsX[4] = {};
+    GWKCubicComputeWeights(dfDeltaX, adfCoeffsX);
+    double adfCoeffsY[4] = {};
+    GWKCubicComputeWeights(dfDeltaY, adfCoeffsY);
+
+    if( !GWKCubicResample4SampleRealAVX2(
+            poWK->papabySrcImage[iBand], poWK->eWorkingDataType,
+            iSrcOffset, poWK->nSrcXSize,
+            poWK->panUnifiedSrcValid,
+            poWK->papanBandSrcValid ? poWK->papanBandSrcValid[iBand] : nullptr,
+            poWK->pafUnifiedSrcDensity,
+            adfCoeffsX, adfCoeffsY, pdfDensity, pdfReal) )
+    {
+        return GWKBilinearResample4Sample( poWK, iBand, dfSrcX, dfSrcY,
+                                           pdfDensity, pdfReal,
+                                           &dfValueImagIgnored );
+    }
+    return true;
+}
+
+#endif  // HAVE_AVX2_AT_COMPILE_TIME
+
 // We do not define USE_SSE_CUBIC_IMPL since in practice, it gives zero
 // perf benefit.
 
@@ -3981,8 +4046,9 @@ static bool GWKResampleNoMasksT( const GDALWarpKernel *poWK, int iBand,
 }
 
 /* We restrict to 64bit processors because they are guaranteed to have SSE2 */
-/* Could possibly be used too on 32bit, but we would need to check at runtime */
-#if defined(__x86_64) || defined(_M_X64)
+/* (or NEON on AArch64). Could possibly be used too on 32bit, but we would */
+/* need to check at runtime */
+#if defined(__x86_64) || defined(_M_X64) || defined(__aarch64__)
 
 /************************************************************************/
 /*                    GWKResampleNoMasks_SSE2_T()                       */
@@ -4262,7 +4328,7 @@ bool GWKResampleNoMasksT<double>( const GDALWarpKernel *poWK, int iBand,
 
 #endif /* INSTANTIATE_FLOAT64_SSE2_IMPL */
 
-#endif /* defined(__x86_64) || defined(_M_X64) */
+#endif /* defined(__x86_64) || defined(_M_X64) || defined(__aarch64__) */
 
 /************************************************************************/
 /*                     GWKRoundSourceCoordinates()                      */
@@ -5042,6 +5108,22 @@ static void GWKRealCaseThread( void* pData)
         poWK->papanBandSrcValid == nullptr &&
         poWK->pafUnifiedSrcDensity != nullptr;
 
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+    // Only cubic resampling has an AVX2 implementation. The other kernels
+    // (cubic spline, Lanczos, average...) remain scalar.
+    const bool bUseAVX2Cubic =
+        poWK->eResample == GRA_Cubic && bUse4SamplesFormula &&
+        !bSrcMaskIsDensity && CPLHaveRuntimeAVX2() &&
+        CPLTestBool(GDALGetTunedConfigOption("GDAL_WARP_CUBIC_AVX2", "YES")) &&
+        (poWK->eWorkingDataType == GDT_Byte ||
+         poWK->eWorkingDataType == GDT_Int16 ||
+         poWK->eWorkingDataType == GDT_UInt16 ||
+         poWK->eWorkingDataType == GDT_Int32 ||
+         poWK->eWorkingDataType == GDT_UInt32 ||
+         poWK->eWorkingDataType == GDT_Float32 ||
+         poWK->eWorkingDataType == GDT_Float64);
+#endif
+
     // Precompute values.
     for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
         padfX[nDstXSize + iDstX] = iDstX + 0.5 + poWK->nDstXOff;
@@ -5173,6 +5255,17 @@ static void GWKRealCaseThread( void* pData)
                         }
                     }
                     else
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+                    if( bUseAVX2Cubic )
+                    {
+                        GWKCubicResample4SampleAVX2( poWK, iBand,
+                                            padfX[iDstX]-poWK->nSrcXOff,
+                                            padfY[iDstX]-poWK->nSrcYOff,
+                                            &dfBandDensity,
+                                            &dfValueReal );
+                    }
+                    else
+#endif
                     {
                         double dfValueImagIgnored = 0.0;
                         GWKCubicResample4Sample( poWK, iBand,
@@ -0,0 +1,241 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Warp API
+ * Purpose:  AVX2 implementation of some warp kernel primitives
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdalwarpkernel_avx2.h"
+
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+
+#include <cstring>
+
+#include <immintrin.h>
+
+CPL_CVSID("$Id$")
+
+//! @cond Doxygen_Suppress
+
+// Must be kept in sync with the value of gdalwarpkernel.cpp
+constexpr float SRC_DENSITY_THRESHOLD = 0.000000001f;
+
+/************************************************************************/
+/*                         GWKAVX2Get4Valid()                           */
+/************************************************************************/
+
+// Returns true if the 4 consecutive bits starting at iOffset are all set.
+static inline bool GWKAVX2Get4Valid( const GUInt32* panValid,
+                                     GPtrDiff_t iOffset )
+{
+    const GPtrDiff_t iWord = iOffset >> 5;
+    const int nShift = static_cast<int>(iOffset & 0x1f);
+    GUInt32 nBits = panValid[iWord] >> nShift;
+    if( nShift > 28 )
+        nBits |= panValid[iWord + 1] << (32 - nShift);
+    return (nBits & 0xF) == 0xF;
+}
+
+/************************************************************************/
+/*                         GWKAVX2Load4Values()                         */
+/************************************************************************/
+
+// Loads 4 consecutive samples of type eType as doubles.
+static inline __m256d GWKAVX2Load4Values( const GByte* pabySrc,
+                                          GDALDataType eType,
+                                          GPtrDiff_t iOffset )
+{
+    switch( eType )
+    {
+        case GDT_Byte:
+        {
+            GInt32 nVal;
+            memcpy(&nVal, pabySrc + iOffset, sizeof(nVal));
+            return _mm256_cvtepi32_pd(
+                _mm_cvtepu8_epi32(_mm_cvtsi32_si128(nVal)));
+        }
+
+        case GDT_Int16:
+        case GDT_UInt16:
+        {
+            const __m128i xmm = _mm_loadl_epi64(
+                reinterpret_cast<const __m128i*>(pabySrc + iOffset * 2));
+            return _mm256_cvtepi32_pd(eType == GDT_Int16 ?
+                                      _mm_cvtepi16_epi32(xmm) :
+                                      _mm_cvtepu16_epi32(xmm));
+        }
+
+        case GDT_Int32:
+            return _mm256_cvtepi32_pd(_mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(pabySrc + iOffset * 4)));
+
+        case GDT_UInt32:
+        {
+            // Convert as signed, and add 2^32 to values whose most
+            // significant bit is set.
+            const __m128i xmm = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(pabySrc + iOffset * 4));
+            const __m256d ymmSigned = _mm256_cvtepi32_pd(xmm);
+            const __m256d ymmNeg = _mm256_castsi256_pd(
+                _mm256_cvtepi32_epi64(_mm_srai_epi32(xmm, 31)));
+            return _mm256_add_pd(ymmSigned,
+                _mm256_and_pd(ymmNeg, _mm256_set1_pd(4294967296.0)));
+        }
+
+        case GDT_Float32:
+            return _mm256_cvtps_pd(_mm_loadu_ps(
+                reinterpret_cast<const float*>(pabySrc + iOffset * 4)));
+
+        case GDT_Float64:
+            return _mm256_loadu_pd(
+                reinterpret_cast<const double*>(pabySrc + iOffset * 8));
+
+        default:
+            break;
+    }
+    return _mm256_setzero_pd();
+}
+
+/************************************************************************/
+/*                       GWKAVX2ConvolveRows()                          */
+/************************************************************************/
+
+// Given 4 rows of 4 samples, returns the horizontal convolution of each row
+// with padfCoeffsX. The additions are done in the same order as the CONVOL4()
+// macro of gdalwarpkernel.cpp, so that results are bit identical.
+static inline __m256d GWKAVX2ConvolveRows( __m256d ymmRow0, __m256d ymmRow1,
+                                           __m256d ymmRow2, __m256d ymmRow3,
+                                           const double* padfCoeffsX )
+{
+    // Transpose the 4x4 matrix so that ymmColN contains the Nth sample of
+    // each row.
+    const __m256d ymmT0 = _mm256_unpacklo_pd(ymmRow0, ymmRow1);
+    const __m256d ymmT1 = _mm256_unpackhi_pd(ymmRow0, ymmRow1);
+    const __m256d ymmT2 = _mm256_unpacklo_pd(ymmRow2, ymmRow3);
+    const __m256d ymmT3 = _mm256_unpackhi_pd(ymmRow2, ymmRow3);
+    const __m256d ymmCol0 = _mm256_permute2f128_pd(ymmT0, ymmT2, 0x20);
+    const __m256d ymmCol1 = _mm256_permute2f128_pd(ymmT1, ymmT3, 0x20);
+    const __m256d ymmCol2 = _mm256_permute2f128_pd(ymmT0, ymmT2, 0x31);
+    const __m256d ymmCol3 = _mm256_permute2f128_pd(ymmT1, ymmT3, 0x31);
+
+    __m256d ymmSum =
+        _mm256_add_pd(_mm256_mul_pd(ymmCol0, _mm256_set1_pd(padfCoeffsX[0])),
+                      _mm256_mul_pd(ymmCol1, _mm256_set1_pd(padfCoeffsX[1])));
+    ymmSum = _mm256_add_pd(ymmSum,
+                _mm256_mul_pd(ymmCol2, _mm256_set1_pd(padfCoeffsX[2])));
+    ymmSum = _mm256_add_pd(ymmSum,
+                _mm256_mul_pd(ymmCol3, _mm256_set1_pd(padfCoeffsX[3])));
+    return ymmSum;
+}
+
+/************************************************************************/
+/*                  GWKCubicResample4SampleRealAVX2()                   */
+/************************************************************************/
+
+// AVX2 version of GWKCubicResample4Sample() for non-complex data types,
+// when the 4x4 kernel is fully inside the source window.
+// iSrcOffset is the offset of the top-left sample of the kernel.
+// Returns false if a sample of the kernel is invalid, in which case the
+// caller must fallback to bilinear resampling, as GWKCubicResample4Sample()
+// does.
+bool GWKCubicResample4SampleRealAVX2( const GByte* pabySrc,
+                                      GDALDataType eType,
+                                      GPtrDiff_t iSrcOffset,
+                                      int nSrcXSize,
+                                      const GUInt32* panUnifiedSrcValid,
+                                      const GUInt32* panBandSrcValid,
+                                      const float* pafUnifiedSrcDensity,
+                                      const double* padfCoeffsX,
+                                      const double* padfCoeffsY,
+                                      double* pdfDensity,
+                                      double* pdfReal )
+{
+    const GPtrDiff_t aiOffsets[4] = {
+        iSrcOffset,
+        iSrcOffset + nSrcXSize,
+        iSrcOffset + 2 * static_cast<GPtrDiff_t>(nSrcXSize),
+        iSrcOffset + 3 * static_cast<GPtrDiff_t>(nSrcXSize) };
+
+    for( int i = 0; i < 4; i++ )
+    {
+        if( (panUnifiedSrcValid != nullptr &&
+             !GWKAVX2Get4Valid(panUnifiedSrcValid, aiOffsets[i])) ||
+            (panBandSrcValid != nullptr &&
+             !GWKAVX2Get4Valid(panBandSrcValid, aiOffsets[i])) )
+        {
+            return false;
+        }
+    }
+
+    double adfValueDens[4];
+    if( pafUnifiedSrcDensity != nullptr )
+    {
+        // As in GWKGetPixelRow() + GWKCubicResample4Sample(), all samples
+        // of a row must have a density at least equal to the threshold, and
+        // one of them must be strictly above it.
+        const __m128 xmmThreshold = _mm_set1_ps(SRC_DENSITY_THRESHOLD);
+        __m128 axmmDens[4];
+        for( int i = 0; i < 4; i++ )
+        {
+            axmmDens[i] = _mm_loadu_ps(pafUnifiedSrcDensity + aiOffsets[i]);
+            if( _mm_movemask_ps(_mm_cmplt_ps(axmmDens[i], xmmThreshold)) != 0 ||
+                _mm_movemask_ps(_mm_cmpgt_ps(axmmDens[i], xmmThreshold)) == 0 )
+            {
+                return false;
+            }
+        }
+        _mm256_storeu_pd(adfValueDens, GWKAVX2ConvolveRows(
+            _mm256_cvtps_pd(axmmDens[0]), _mm256_cvtps_pd(axmmDens[1]),
+            _mm256_cvtps_pd(axmmDens[2]), _mm256_cvtps_pd(axmmDens[3]),
+            padfCoeffsX));
+    }
+    else
+    {
+        const double dfRowDens = padfCoeffsX[0] + padfCoeffsX[1] +
+                                 padfCoeffsX[2] + padfCoeffsX[3];
+        for( int i = 0; i < 4; i++ )
+            adfValueDens[i] = dfRowDens;
+    }
+
+    double adfValueReal[4];
+    _mm256_storeu_pd(adfValueReal, GWKAVX2ConvolveRows(
+        GWKAVX2Load4Values(pabySrc, eType, aiOffsets[0]),
+        GWKAVX2Load4Values(pabySrc, eType, aiOffsets[1]),
+        GWKAVX2Load4Values(pabySrc, eType, aiOffsets[2]),
+        GWKAVX2Load4Values(pabySrc, eType, aiOffsets[3]),
+        padfCoeffsX));
+
+    *pdfDensity = padfCoeffsY[0] * adfValueDens[0] +
+                  padfCoeffsY[1] * adfValueDens[1] +
+                  padfCoeffsY[2] * adfValueDens[2] +
+                  padfCoeffsY[3] * adfValueDens[3];
+    *pdfReal = padfCoeffsY[0] * adfValueReal[0] +
+               padfCoeffsY[1] * adfValueReal[1] +
+               padfCoeffsY[2] * adfValueReal[2] +
+               padfCoeffsY[3] * adfValueReal[3];
+    return true;
+}
+
+//! @endcond
+
+#endif /* HAVE_AVX2_AT_COMPILE_TIME */
@@ -0,0 +1,54 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Warp API
+ * Purpose:  AVX2 implementation of some warp kernel primitives
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef GDALWARPKERNEL_AVX2_H_INCLUDED
+#define GDALWARPKERNEL_AVX2_H_INCLUDED
+
+#ifndef DOXYGEN_SKIP
+
+#include "cpl_port.h"
+#include "gdal.h"
+
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+
+bool GWKCubicResample4SampleRealAVX2( const GByte* pabySrc,
+                                      GDALDataType eType,
+                                      GPtrDiff_t iSrcOffset,
+                                      int nSrcXSize,
+                                      const GUInt32* panUnifiedSrcValid,
+                                      const GUInt32* panBandSrcValid,
+                                      const float* pafUnifiedSrcDensity,
+                                      const double* padfCoeffsX,
+                                      const double* padfCoeffsY,
+                                      double* pdfDensity,
+                                      double* pdfReal );
+
+#endif /* HAVE_AVX2_AT_COMPILE_TIME */
+
+#endif /* #ifndef DOXYGEN_SKIP */
+
+#endif /* GDALWARPKERNEL_AVX2_H_INCLUDED */
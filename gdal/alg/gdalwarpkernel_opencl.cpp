@@ -39,6 +39,9 @@
 #include <limits.h>
 #include <float.h>
 #include <limits>
+#include <map>
+#include <mutex>
+#include <string>
 #include <vector>
 #include "cpl_string.h"
 #include "gdalwarpkernel_opencl.h"
@@ -383,6 +386,191 @@ static cl_device_id get_device(OCLVendor *peVendor)
     return preferred_device_id;
 }
 
+/*
+ Choosing the device, creating a context and compiling the programs are
+ expensive compared to the warping of a chunk, and an environment is created
+ for each chunk. The device, its context and the compiled programs are thus
+ shared by the environments of the process, as long as the configuration
+ options used to choose the device are unchanged. At most
+ OCL_MAX_CACHED_PROGRAMS programs are kept, as their compilation options
+ depend on the chunk dimensions.
+ */
+#define OCL_MAX_CACHED_PROGRAMS 32
+#define PROGBUF_SIZE 128000
+
+namespace {
+struct OCLSharedEnv
+{
+    std::mutex oMutex{};
+    bool bInitialized = false;
+    std::string osDeviceSelection{};
+    cl_device_id dev = nullptr;
+    OCLVendor eCLVendor = VENDOR_OTHER;
+    cl_context context = nullptr;
+    std::map<std::string, cl_program> oMapPrograms{};
+};
+}
+
+// Never destroyed, as the OpenCL library might be unloaded first.
+static OCLSharedEnv& get_shared_env()
+{
+    static OCLSharedEnv* poEnv = new OCLSharedEnv();
+    return *poEnv;
+}
+
+static void release_shared_programs(OCLSharedEnv& oEnv)
+{
+    for( auto& oIter: oEnv.oMapPrograms )
+        clReleaseProgram(oIter.second);
+    oEnv.oMapPrograms.clear();
+}
+
+/*
+ Gets the shared device & context, creating them if needed. The returned
+ context is retained for the caller.
+
+ Returns CL_SUCCESS on success, CL_DEVICE_NOT_FOUND if there is no suitable
+ device and other CL_* errors when something goes wrong.
+ */
+static cl_int get_shared_context(cl_device_id *pDev, OCLVendor *peVendor,
+                                 cl_context *pContext)
+{
+    OCLSharedEnv& oEnv = get_shared_env();
+    std::lock_guard<std::mutex> oLock(oEnv.oMutex);
+
+    std::string osDeviceSelection(
+        CPLGetConfigOption("OPENCL_USE_CPU", "FALSE"));
+    osDeviceSelection += '\n';
+    osDeviceSelection +=
+        CPLGetConfigOption("BLACKLISTED_OPENCL_VENDOR", "");
+    osDeviceSelection += '\n';
+    osDeviceSelection += CPLGetConfigOption("PREFERRED_OPENCL_VENDOR", "");
+
+    if( !oEnv.bInitialized || osDeviceSelection != oEnv.osDeviceSelection )
+    {
+        // Environments using the previous context keep it retained.
+        release_shared_programs(oEnv);
+        if( oEnv.context != nullptr )
+            clReleaseContext(oEnv.context);
+        oEnv.context = nullptr;
+        oEnv.bInitialized = true;
+        oEnv.osDeviceSelection = osDeviceSelection;
+
+        // Do we have a suitable OpenCL device?
+        oEnv.dev = get_device(&oEnv.eCLVendor);
+        if( oEnv.dev != nullptr )
+        {
+            cl_bool bool_flag = CL_FALSE;
+            size_t sz = 0;
+            cl_int err = clGetDeviceInfo(oEnv.dev, CL_DEVICE_IMAGE_SUPPORT,
+                                         sizeof(cl_bool), &bool_flag, &sz);
+            if( err != CL_SUCCESS || !bool_flag )
+            {
+                CPLDebug( "OpenCL", "No image support on selected device." );
+                oEnv.dev = nullptr;
+            }
+            else
+            {
+                oEnv.context = clCreateContext(nullptr, 1, &(oEnv.dev),
+                                               nullptr, nullptr, &err);
+                if( err != CL_SUCCESS )
+                {
+                    oEnv.context = nullptr;
+                    oEnv.bInitialized = false;
+                    handleErr(err);
+                }
+            }
+        }
+    }
+
+    if( oEnv.context == nullptr )
+        return CL_DEVICE_NOT_FOUND;
+
+    clRetainContext(oEnv.context);
+    *pDev = oEnv.dev;
+    *peVendor = oEnv.eCLVendor;
+    *pContext = oEnv.context;
+    return CL_SUCCESS;
+}
+
+/*
+ Gets the program built from the source with the options, from the shared
+ cache when available. The returned program is retained for the caller.
+
+ Returns nullptr and sets the error when something goes wrong.
+ */
+static cl_program get_program(struct oclWarper *warper,
+                              const char *pszProgBuf, const char *pszOptions,
+                              cl_int *clErr)
+{
+    OCLSharedEnv& oEnv = get_shared_env();
+    std::lock_guard<std::mutex> oLock(oEnv.oMutex);
+
+    // The source only depends on the resampling algorithm.
+    const bool bShared = (warper->context == oEnv.context);
+    const std::string osKey(
+        std::string(CPLSPrintf("%d ", static_cast<int>(warper->resampAlg))) +
+        pszOptions);
+    if( bShared )
+    {
+        auto oIter = oEnv.oMapPrograms.find(osKey);
+        if( oIter != oEnv.oMapPrograms.end() )
+        {
+            clRetainProgram(oIter->second);
+            return oIter->second;
+        }
+    }
+
+    cl_int err = CL_SUCCESS;
+    cl_program program = clCreateProgramWithSource(warper->context, 1,
+                                                   &pszProgBuf,
+                                                   nullptr, &err);
+    handleErrRetNULL(err);
+
+    (*clErr) = err = clBuildProgram(program, 1, &(warper->dev), pszOptions,
+                                    nullptr, nullptr);
+
+    //Detailed debugging info
+    if (err != CL_SUCCESS)
+    {
+        const char* pszStatus = "unknown_status";
+        std::vector<char> buffer(PROGBUF_SIZE);
+        err = clGetProgramBuildInfo(program, warper->dev, CL_PROGRAM_BUILD_LOG,
+                                    buffer.size(), &buffer[0], nullptr);
+        if( err == CL_SUCCESS )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "Error: Failed to build program executable!\nBuild Log:\n%s", &buffer[0]);
+
+            err = clGetProgramBuildInfo(program, warper->dev, CL_PROGRAM_BUILD_STATUS,
+                                        buffer.size(), &buffer[0], nullptr);
+        }
+        if( err == CL_SUCCESS )
+        {
+            if(buffer[0] == CL_BUILD_NONE)
+                pszStatus = "CL_BUILD_NONE";
+            else if(buffer[0] == CL_BUILD_ERROR)
+                pszStatus = "CL_BUILD_ERROR";
+            else if(buffer[0] == CL_BUILD_SUCCESS)
+                pszStatus = "CL_BUILD_SUCCESS";
+            else if(buffer[0] == CL_BUILD_IN_PROGRESS)
+                pszStatus = "CL_BUILD_IN_PROGRESS";
+
+            CPLDebug("OpenCL", "Build Status: %s\nProgram Source:\n%s", pszStatus, pszProgBuf);
+        }
+        clReleaseProgram(program);
+        return nullptr;
+    }
+
+    if( bShared )
+    {
+        if( oEnv.oMapPrograms.size() >= OCL_MAX_CACHED_PROGRAMS )
+            release_shared_programs(oEnv);
+        clRetainProgram(program);
+        oEnv.oMapPrograms[osKey] = program;
+    }
+    return program;
+}
+
 /*
  Given that not all OpenCL devices support the same image formats, we need to
  make do with what we have. This leads to wasted space, but as OpenCL matures
@@ -618,7 +806,6 @@ cl_kernel get_kernel(struct oclWarper *warper, char useVec,
     cl_program program;
     cl_kernel kernel;
     cl_int err = CL_SUCCESS;
-#define PROGBUF_SIZE 128000
     char *buffer = static_cast<char *>(CPLCalloc(PROGBUF_SIZE, sizeof(char)));
     char *progBuf = static_cast<char *>(CPLCalloc(PROGBUF_SIZE, sizeof(char)));
     float dstMinVal = 0.f, dstMaxVal = 0.0;
@@ -1329,13 +1516,6 @@ __kernel void resamp(__read_only image2d_t srcCoords,
     else
         snprintf(progBuf, PROGBUF_SIZE, "%s\n%s", kernGenFuncs, kernResampler);
 
-    //Actually make the program from assembled source
-    const char* pszProgBuf = progBuf;
-    program = clCreateProgramWithSource(warper->context, 1,
-                                        &pszProgBuf,
-                                        nullptr, &err);
-    handleErrGoto(err, error_final);
-
     //Assemble the compiler arg string for speed. All invariants should be defined here.
     snprintf(buffer, PROGBUF_SIZE,
              "-cl-fast-relaxed-math -Werror -D FALSE=0 -D TRUE=1 "
@@ -1358,34 +1538,10 @@ __kernel void resamp(__read_only image2d_t srcCoords,
             dVecf, dUseVec, warper->resampAlg == OCL_CubicSpline,
             warper->nBandSrcValidCL != nullptr, warper->coordMult);
 
-    (*clErr) = err = clBuildProgram(program, 1, &(warper->dev), buffer, nullptr, nullptr);
-
-    //Detailed debugging info
-    if (err != CL_SUCCESS)
-    {
-        const char* pszStatus = "unknown_status";
-        err = clGetProgramBuildInfo(program, warper->dev, CL_PROGRAM_BUILD_LOG,
-                                    128000*sizeof(char), buffer, nullptr);
-        handleErrGoto(err, error_free_program);
-
-        CPLError(CE_Failure, CPLE_AppDefined, "Error: Failed to build program executable!\nBuild Log:\n%s", buffer);
-
-        err = clGetProgramBuildInfo(program, warper->dev, CL_PROGRAM_BUILD_STATUS,
-                                    128000*sizeof(char), buffer, nullptr);
-        handleErrGoto(err, error_free_program);
-
-        if(buffer[0] == CL_BUILD_NONE)
-            pszStatus = "CL_BUILD_NONE";
-        else if(buffer[0] == CL_BUILD_ERROR)
-            pszStatus = "CL_BUILD_ERROR";
-        else if(buffer[0] == CL_BUILD_SUCCESS)
-            pszStatus = "CL_BUILD_SUCCESS";
-        else if(buffer[0] == CL_BUILD_IN_PROGRESS)
-            pszStatus = "CL_BUILD_IN_PROGRESS";
-
-        CPLDebug("OpenCL", "Build Status: %s\nProgram Source:\n%s", pszStatus, progBuf);
-        goto error_free_program;
-    }
+    //Actually make the program from assembled source
+    program = get_program(warper, progBuf, buffer, clErr);
+    if( program == nullptr )
+        goto error_final;
 
     kernel = clCreateKernel(program, "resamp", &err);
     handleErrGoto(err, error_free_program);
@@ -2062,22 +2218,13 @@ struct oclWarper* GDALWarpKernelOpenCL_createEnv(int srcWidth, int srcHeight,
     size_t maxWidth = 0, maxHeight = 0;
     cl_int err = CL_SUCCESS;
     size_t fmtSize, sz;
-    cl_device_id device;
-    cl_bool bool_flag;
+    cl_device_id device = nullptr;
+    cl_context context = nullptr;
     OCLVendor eCLVendor = VENDOR_OTHER;
 
     // Do we have a suitable OpenCL device?
-    device = get_device(&eCLVendor);
-    if( device == nullptr )
-        return nullptr;
-
-    err = clGetDeviceInfo(device, CL_DEVICE_IMAGE_SUPPORT,
-                          sizeof(cl_bool), &bool_flag, &sz);
-    if( err != CL_SUCCESS || !bool_flag )
-    {
-        CPLDebug( "OpenCL", "No image support on selected device." );
+    if( get_shared_context(&device, &eCLVendor, &context) != CL_SUCCESS )
         return nullptr;
-    }
 
     // Set up warper environment.
     warper = static_cast<struct oclWarper *>(CPLCalloc(1, sizeof(struct oclWarper)));
@@ -2112,9 +2259,7 @@ struct oclWarper* GDALWarpKernelOpenCL_createEnv(int srcWidth, int srcHeight,
     warper->kern4 = nullptr;
 
     warper->dev = device;
-
-    warper->context = clCreateContext(nullptr, 1, &(warper->dev), nullptr, nullptr, &err);
-    handleErrGoto(err, error_label);
+    warper->context = context;
 #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6) || defined(__clang__)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
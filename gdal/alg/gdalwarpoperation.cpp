@@ -37,16 +37,19 @@
 #include <cstring>
 
 #include <algorithm>
+#include <condition_variable>
 #include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "cpl_config.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
 #include "gdal_priv.h"
@@ -60,14 +63,21 @@ struct _GDALWarpChunk {
     int dx, dy, dsx, dsy;
     int sx, sy, ssx, ssy;
     double sExtraSx, sExtraSy;
+    double dfMemoryUse;
 };
 
+struct GDALWarpChunkThreadContext;
+
 struct GDALWarpPrivateData
 {
     int nStepCount = 0;
     std::vector<int> abSuccess{};
     std::vector<double> adfDstX{};
     std::vector<double> adfDstY{};
+
+    // Worker threads of ChunkAndWarpMulti().
+    std::mutex oThreadContextMutex{};
+    std::map<GIntBig, GDALWarpChunkThreadContext*> oMapThreadToContext{};
 };
 
 static std::mutex gMutex{};
@@ -1012,62 +1022,199 @@ CPLErr GDALChunkAndWarpImage( GDALWarpOperationH hOperation,
 /*                          ChunkThreadMain()                           */
 /************************************************************************/
 
-typedef struct
+struct GDALWarpChunkPipeline;
+
+// State of one of the worker threads of ChunkAndWarpMulti().
+struct GDALWarpChunkThreadContext
 {
-    GDALWarpOperation *poOperation;
-    GDALWarpChunk     *pasChunkInfo;
-    CPLJoinableThread *hThreadHandle;
-    CPLErr             eErr;
-    double             dfProgressBase;
-    double             dfProgressScale;
-    CPLMutex          *hIOMutex;
-
-    CPLMutex          *hCondMutex;
-    volatile int       bIOMutexTaken;
-    CPLCond           *hCond;
-} ChunkThreadData;
+    GDALWarpChunkPipeline *poPipeline = nullptr;
+    CPLJoinableThread     *hThreadHandle = nullptr;
+
+    // Own transformer and kernel thread data, so that the chunk can be
+    // warped while other chunks are. nullptr if warps are serialized.
+    void                  *pTransformerArg = nullptr;
+    void                  *psThreadData = nullptr;
+
+    double                 dfProgressBase = 0.0;
+    double                 dfProgressScale = 0.0;
+    double                 dfChunkProgress = 0.0;
+};
+
+struct GDALWarpChunkPipeline
+{
+    GDALWarpOperation     *poOperation = nullptr;
+    GDALWarpChunk         *pasChunkList = nullptr;
+    int                    nChunkListCount = 0;
+    CPLMutex              *hIOMutex = nullptr;
+    double                 dfMemoryBudget = 0.0;
+    double                 dfTotalPixels = 0.0;
+    GDALProgressFunc       pfnProgress = nullptr;
+    void                  *pProgressArg = nullptr;
+
+    std::mutex             oMutex{};
+    std::condition_variable oCV{};
+    int                    nNextChunk = 0;
+    int                    nNextChunkToRead = 0;
+    int                    nChunksInFlight = 0;
+    double                 dfMemoryInFlight = 0.0;
+    double                 dfProgressDone = 0.0;
+    double                 dfLastProgress = 0.0;
+    CPLErr                 eErr = CE_None;
+    std::vector<GDALWarpChunkThreadContext> asContexts{};
+};
+
+// Progress callback installed in the kernel of the chunks processed by
+// ChunkAndWarpMulti(), so that the progress of concurrent chunks is summed
+// and reported in a monotonic way, from one thread at a time.
+static int CPL_STDCALL ChunkThreadProgress( double dfComplete,
+                                            const char* pszMessage,
+                                            void* pProgressArg )
+{
+    GDALWarpChunkThreadContext* psContext =
+        static_cast<GDALWarpChunkThreadContext*>(pProgressArg);
+    GDALWarpChunkPipeline* poPipeline = psContext->poPipeline;
+
+    std::lock_guard<std::mutex> oLock(poPipeline->oMutex);
+    psContext->dfChunkProgress =
+        std::max(0.0, std::min(psContext->dfProgressScale,
+                               dfComplete - psContext->dfProgressBase));
+    double dfProgress = poPipeline->dfProgressDone;
+    for( const auto& sContext: poPipeline->asContexts )
+        dfProgress += sContext.dfChunkProgress;
+    dfProgress = std::max(poPipeline->dfLastProgress, std::min(1.0, dfProgress));
+    poPipeline->dfLastProgress = dfProgress;
+    return poPipeline->pfnProgress( dfProgress, pszMessage,
+                                    poPipeline->pProgressArg );
+}
+
+static GDALWarpChunkThreadContext* GetChunkThreadContext(
+    GDALWarpOperation* poWarpOperation )
+{
+    GDALWarpPrivateData* privateData = GetWarpPrivateData(poWarpOperation);
+    std::lock_guard<std::mutex> oLock(privateData->oThreadContextMutex);
+    auto oIter = privateData->oMapThreadToContext.find(CPLGetPID());
+    return oIter != privateData->oMapThreadToContext.end() ?
+        oIter->second : nullptr;
+}
 
 static void ChunkThreadMain( void *pThreadData )
 
 {
-    volatile ChunkThreadData* psData =
-        static_cast<volatile ChunkThreadData*>(pThreadData);
+    GDALWarpChunkThreadContext* psContext =
+        static_cast<GDALWarpChunkThreadContext*>(pThreadData);
+    GDALWarpChunkPipeline* poPipeline = psContext->poPipeline;
 
-    GDALWarpChunk *pasChunkInfo = psData->pasChunkInfo;
+    GDALWarpPrivateData* privateData =
+        GetWarpPrivateData(poPipeline->poOperation);
+    {
+        std::lock_guard<std::mutex> oLock(privateData->oThreadContextMutex);
+        privateData->oMapThreadToContext[CPLGetPID()] = psContext;
+    }
+
+    while( true )
+    {
+/* -------------------------------------------------------------------- */
+/*      Take the next chunk, once the memory budget allows it.  A       */
+/*      chunk is always allowed if no other one is being processed.     */
+/* -------------------------------------------------------------------- */
+        GDALWarpChunk *pasChunkInfo = nullptr;
+        int iChunk = 0;
+        {
+            std::unique_lock<std::mutex> oLock(poPipeline->oMutex);
+            while( poPipeline->eErr == CE_None &&
+                   poPipeline->nNextChunk < poPipeline->nChunkListCount &&
+                   poPipeline->nChunksInFlight > 0 &&
+                   poPipeline->dfMemoryInFlight +
+                        poPipeline->pasChunkList[
+                            poPipeline->nNextChunk].dfMemoryUse >
+                        poPipeline->dfMemoryBudget )
+            {
+                poPipeline->oCV.wait(oLock);
+            }
+            if( poPipeline->eErr != CE_None ||
+                poPipeline->nNextChunk >= poPipeline->nChunkListCount )
+                break;
+
+            iChunk = poPipeline->nNextChunk++;
+            pasChunkInfo = poPipeline->pasChunkList + iChunk;
+            poPipeline->nChunksInFlight++;
+            poPipeline->dfMemoryInFlight += pasChunkInfo->dfMemoryUse;
+
+            psContext->dfProgressBase = poPipeline->dfProgressDone;
+            psContext->dfProgressScale =
+                pasChunkInfo->dsx * static_cast<double>(pasChunkInfo->dsy) /
+                    poPipeline->dfTotalPixels;
+            psContext->dfChunkProgress = 0.0;
+
+/* -------------------------------------------------------------------- */
+/*      Chunks are read in order, so that the output of a streamed      */
+/*      dataset is written in order.                                    */
+/* -------------------------------------------------------------------- */
+            while( poPipeline->eErr == CE_None &&
+                   poPipeline->nNextChunkToRead != iChunk )
+            {
+                poPipeline->oCV.wait(oLock);
+            }
+        }
+
+        CPLErr eErr = CE_None;
+        CPLDebug( "GDAL", "Start chunk %d.", iChunk );
 
 /* -------------------------------------------------------------------- */
 /*      Acquire IO mutex.                                               */
 /* -------------------------------------------------------------------- */
-    if( !CPLAcquireMutex( psData->hIOMutex, 600.0 ) )
-    {
-        CPLError( CE_Failure, CPLE_AppDefined,
-                    "Failed to acquire IOMutex in WarpRegion()." );
-        psData->eErr = CE_Failure;
-    }
-    else
-    {
-        if( psData->hCond != nullptr )
+        if( !CPLAcquireMutex( poPipeline->hIOMutex, 600.0 ) )
         {
-            CPLAcquireMutex( psData->hCondMutex, 1.0 );
-            psData->bIOMutexTaken = TRUE;
-            CPLCondSignal(psData->hCond);
-            CPLReleaseMutex( psData->hCondMutex );
+            CPLError( CE_Failure, CPLE_AppDefined,
+                        "Failed to acquire IOMutex in WarpRegion()." );
+            eErr = CE_Failure;
         }
+        else
+        {
+            bool bAbort = false;
+            {
+                std::lock_guard<std::mutex> oLock(poPipeline->oMutex);
+                poPipeline->nNextChunkToRead++;
+                bAbort = poPipeline->eErr != CE_None;
+            }
+            poPipeline->oCV.notify_all();
 
-        psData->eErr = psData->poOperation->WarpRegion(
+            if( !bAbort )
+            {
+                eErr = poPipeline->poOperation->WarpRegion(
                                     pasChunkInfo->dx, pasChunkInfo->dy,
                                     pasChunkInfo->dsx, pasChunkInfo->dsy,
                                     pasChunkInfo->sx, pasChunkInfo->sy,
                                     pasChunkInfo->ssx, pasChunkInfo->ssy,
                                     pasChunkInfo->sExtraSx,
                                     pasChunkInfo->sExtraSy,
-                                    psData->dfProgressBase,
-                                    psData->dfProgressScale);
+                                    psContext->dfProgressBase,
+                                    psContext->dfProgressScale);
+            }
+
+/* -------------------------------------------------------------------- */
+/*      Release the IO mutex.                                           */
+/* -------------------------------------------------------------------- */
+            CPLReleaseMutex( poPipeline->hIOMutex );
+        }
+
+        CPLDebug( "GDAL", "Finished chunk %d.", iChunk );
+
+        {
+            std::lock_guard<std::mutex> oLock(poPipeline->oMutex);
+            poPipeline->nChunksInFlight--;
+            poPipeline->dfMemoryInFlight -= pasChunkInfo->dfMemoryUse;
+            poPipeline->dfProgressDone += psContext->dfProgressScale;
+            psContext->dfChunkProgress = 0.0;
+            if( eErr != CE_None && poPipeline->eErr == CE_None )
+                poPipeline->eErr = eErr;
+        }
+        poPipeline->oCV.notify_all();
+    }
 
-    /* -------------------------------------------------------------------- */
-    /*      Release the IO mutex.                                           */
-    /* -------------------------------------------------------------------- */
-        CPLReleaseMutex( psData->hIOMutex );
+    {
+        std::lock_guard<std::mutex> oLock(privateData->oThreadContextMutex);
+        privateData->oMapThreadToContext.erase(CPLGetPID());
     }
 }
 
@@ -1085,7 +1232,14 @@ static void ChunkThreadMain( void *pThreadData )
  *
  * Externally this method operates the same as ChunkAndWarpImage(), but
  * internally this method uses multiple threads to interleave input/output
- * for one region while the processing is being done for another.
+ * for one region while the processing is being done for others.
+ *
+ * The number of chunks processed at the same time is set with the
+ * NUM_CHUNKS_IN_FLIGHT warping option (2 by default). Their
+ * input/output is serialized, whereas their warping is done concurrently
+ * when the transformer can be cloned, no chunk processor is installed and
+ * the output is not streamable. The memory used by the chunks in flight is
+ * bounded to twice GDALWarpOptions::dfWarpMemoryLimit (GDAL >= 3.4).
  *
  * @param nDstXOff X offset to window of destination data to be produced.
  * @param nDstYOff Y offset to window of destination data to be produced.
@@ -1105,121 +1259,124 @@ CPLErr GDALWarpOperation::ChunkAndWarpMulti(
     CPLReleaseMutex( hIOMutex );
     CPLReleaseMutex( hWarpMutex );
 
-    CPLCond* hCond = CPLCreateCond();
-    CPLMutex* hCondMutex = CPLCreateMutex();
-    CPLReleaseMutex(hCondMutex);
-
 /* -------------------------------------------------------------------- */
-/*      Collect the list of chunks to operate on.                       */
+/*      How many chunks can be processed at the same time?              */
 /* -------------------------------------------------------------------- */
-    CollectChunkList( nDstXOff, nDstYOff, nDstXSize, nDstYSize );
+    const bool bStreamableOutput =
+        CPLFetchBool( psOptions->papszWarpOptions, "STREAMABLE_OUTPUT", false );
+    const char* pszChunksInFlight =
+        CSLFetchNameValueDef( psOptions->papszWarpOptions,
+                              "NUM_CHUNKS_IN_FLIGHT", "2" );
+    int nChunksInFlight = EQUAL(pszChunksInFlight, "ALL_CPUS") ?
+        CPLGetNumCPUs() : atoi(pszChunksInFlight);
+    nChunksInFlight = std::max(2, std::min(64, nChunksInFlight));
+    if( bStreamableOutput )
+        nChunksInFlight = 2;
 
 /* -------------------------------------------------------------------- */
-/*      Process them one at a time, updating the progress               */
-/*      information for each region.                                    */
+/*      Collect the list of chunks to operate on.  Chunks are made      */
+/*      smaller when more than two of them are in flight, to keep       */
+/*      the same memory budget.                                         */
 /* -------------------------------------------------------------------- */
-    ChunkThreadData volatile asThreadData[2] = {};
-    memset(reinterpret_cast<void*>(
-        const_cast<ChunkThreadData(*)[2]>(&asThreadData)), 0, sizeof(asThreadData));
-    asThreadData[0].poOperation = this;
-    asThreadData[0].hIOMutex = hIOMutex;
-    asThreadData[1].poOperation = this;
-    asThreadData[1].hIOMutex = hIOMutex;
-
-    double dfPixelsProcessed = 0.0;
-    double dfTotalPixels = static_cast<double>(nDstXSize)*nDstYSize;
-
-    CPLErr eErr = CE_None;
-    for( int iChunk = 0; iChunk < nChunkListCount+1; iChunk++ )
+    const double dfWarpMemoryLimit = psOptions->dfWarpMemoryLimit;
+    psOptions->dfWarpMemoryLimit = 2 * dfWarpMemoryLimit / nChunksInFlight;
+    CollectChunkList( nDstXOff, nDstYOff, nDstXSize, nDstYSize );
+    psOptions->dfWarpMemoryLimit = dfWarpMemoryLimit;
+
+    GDALWarpChunkPipeline oPipeline;
+    oPipeline.poOperation = this;
+    oPipeline.pasChunkList = pasChunkList;
+    oPipeline.nChunkListCount = pasChunkList ? nChunkListCount : 0;
+    oPipeline.hIOMutex = hIOMutex;
+    oPipeline.dfMemoryBudget = 2 * dfWarpMemoryLimit;
+    oPipeline.dfTotalPixels = static_cast<double>(nDstXSize) * nDstYSize;
+    oPipeline.pfnProgress = psOptions->pfnProgress;
+    oPipeline.pProgressArg = psOptions->pProgressArg;
+
+    const int nThreads = std::min(nChunksInFlight, oPipeline.nChunkListCount);
+    oPipeline.asContexts.resize(nThreads);
+
+/* -------------------------------------------------------------------- */
+/*      Give each thread its own transformer and kernel thread data,    */
+/*      so that chunks can be warped concurrently.                      */
+/* -------------------------------------------------------------------- */
+    bool bConcurrentWarp =
+        !bStreamableOutput &&
+        psOptions->pTransformerArg != nullptr &&
+        psOptions->pfnPreWarpChunkProcessor == nullptr &&
+        psOptions->pfnPostWarpChunkProcessor == nullptr;
+    for( auto& sContext: oPipeline.asContexts )
+    {
+        sContext.poPipeline = &oPipeline;
+        if( !bConcurrentWarp )
+            continue;
+        {
+            CPLErrorHandlerPusher oQuietError(CPLQuietErrorHandler);
+            sContext.pTransformerArg =
+                GDALCloneTransformer(psOptions->pTransformerArg);
+        }
+        if( sContext.pTransformerArg == nullptr )
+        {
+            CPLDebug( "WARP", "Transformer cannot be cloned: "
+                      "chunks will be warped one at a time." );
+            bConcurrentWarp = false;
+            break;
+        }
+        sContext.psThreadData = GWKThreadsCreate(psOptions->papszWarpOptions,
+                                                 psOptions->pfnTransformer,
+                                                 sContext.pTransformerArg);
+    }
+    if( !bConcurrentWarp )
     {
-        int iThread = iChunk % 2;
+        for( auto& sContext: oPipeline.asContexts )
+        {
+            if( sContext.psThreadData )
+                GWKThreadsEnd(sContext.psThreadData);
+            if( sContext.pTransformerArg )
+                GDALDestroyTransformer(sContext.pTransformerArg);
+            sContext.pTransformerArg = nullptr;
+            sContext.psThreadData = nullptr;
+        }
+    }
 
 /* -------------------------------------------------------------------- */
-/*      Launch thread for this chunk.                                   */
+/*      Launch the threads, which take the chunks in order.             */
 /* -------------------------------------------------------------------- */
-        if( pasChunkList != nullptr && iChunk < nChunkListCount )
+    CPLErr eErr = CE_None;
+    for( auto& sContext: oPipeline.asContexts )
+    {
+        sContext.hThreadHandle =
+            CPLCreateJoinableThread(ChunkThreadMain, &sContext);
+        if( sContext.hThreadHandle == nullptr )
         {
-            GDALWarpChunk *pasThisChunk = pasChunkList + iChunk;
-            const double dfChunkPixels =
-                pasThisChunk->dsx * static_cast<double>(pasThisChunk->dsy);
-
-            asThreadData[iThread].dfProgressBase =
-                dfPixelsProcessed / dfTotalPixels;
-            asThreadData[iThread].dfProgressScale =
-                dfChunkPixels / dfTotalPixels;
-
-            dfPixelsProcessed += dfChunkPixels;
-
-            asThreadData[iThread].pasChunkInfo = pasThisChunk;
-
-            if( iChunk == 0 )
-            {
-                asThreadData[iThread].hCond = hCond;
-                asThreadData[iThread].hCondMutex = hCondMutex;
-            }
-            else
-            {
-                asThreadData[iThread].hCond = nullptr;
-                asThreadData[iThread].hCondMutex = nullptr;
-            }
-            asThreadData[iThread].bIOMutexTaken = FALSE;
-
-            CPLDebug( "GDAL", "Start chunk %d.", iChunk );
-            asThreadData[iThread].hThreadHandle = CPLCreateJoinableThread(
-                ChunkThreadMain,
-                const_cast<ChunkThreadData *>(&asThreadData[iThread]));
-            if( asThreadData[iThread].hThreadHandle == nullptr )
-            {
-                CPLError(
-                    CE_Failure, CPLE_AppDefined,
-                    "CPLCreateJoinableThread() failed in ChunkAndWarpMulti()");
-                eErr = CE_Failure;
-                break;
-            }
-
-            // Wait that the first thread has acquired the IO mutex before
-            // proceeding.  This will ensure that the first thread will run
-            // before the second one.
-            if( iChunk == 0 )
+            CPLError(
+                CE_Failure, CPLE_AppDefined,
+                "CPLCreateJoinableThread() failed in ChunkAndWarpMulti()");
+            eErr = CE_Failure;
             {
-                CPLAcquireMutex(hCondMutex, 1.0);
-                while( asThreadData[iThread].bIOMutexTaken == FALSE )
-                    CPLCondWait(hCond, hCondMutex);
-                CPLReleaseMutex(hCondMutex);
+                std::lock_guard<std::mutex> oLock(oPipeline.oMutex);
+                oPipeline.eErr = CE_Failure;
             }
+            oPipeline.oCV.notify_all();
+            break;
         }
+    }
 
 /* -------------------------------------------------------------------- */
-/*      Wait for previous chunks thread to complete.                    */
+/*      Wait for all threads to complete.                               */
 /* -------------------------------------------------------------------- */
-        if( iChunk > 0 )
-        {
-            iThread = (iChunk-1) % 2;
-
-            // Wait for thread to finish.
-            CPLJoinThread(asThreadData[iThread].hThreadHandle);
-            asThreadData[iThread].hThreadHandle = nullptr;
-
-            CPLDebug( "GDAL", "Finished chunk %d.", iChunk-1 );
-
-            eErr = asThreadData[iThread].eErr;
-
-            if( eErr != CE_None )
-                break;
-        }
-    }
-
-    /* -------------------------------------------------------------------- */
-    /*      Wait for all threads to complete.                               */
-    /* -------------------------------------------------------------------- */
-    for( int iThread = 0; iThread < 2; iThread++ )
+    for( auto& sContext: oPipeline.asContexts )
     {
-        if( asThreadData[iThread].hThreadHandle )
-            CPLJoinThread(asThreadData[iThread].hThreadHandle);
+        if( sContext.hThreadHandle )
+            CPLJoinThread(sContext.hThreadHandle);
+        if( sContext.psThreadData )
+            GWKThreadsEnd(sContext.psThreadData);
+        if( sContext.pTransformerArg )
+            GDALDestroyTransformer(sContext.pTransformerArg);
     }
 
-    CPLDestroyCond(hCond);
-    CPLDestroyMutex(hCondMutex);
+    if( eErr == CE_None )
+        eErr = oPipeline.eErr;
 
     WipeChunkList();
 
@@ -1256,6 +1413,70 @@ void GDALWarpOperation::WipeChunkList()
     nChunkListMax = 0;
 }
 
+/************************************************************************/
+/*                    GDALWarpIsSourceWindowEmpty()                     */
+/************************************************************************/
+
+// Returns true if the driver reports that the source window only contains
+// holes (e.g. missing tiles of a sparse GeoTIFF file) that are invalid for
+// the warping, that is they are either transparent in the source alpha band
+// or equal to the source nodata value of all bands.
+static bool GDALWarpIsSourceWindowEmpty( const GDALWarpOptions* psOptions,
+                                         int nSrcXOff, int nSrcYOff,
+                                         int nSrcXSize, int nSrcYSize )
+{
+    if( psOptions->hSrcDS == nullptr ||
+        !CPLTestBool(CPLGetConfigOption("GDALWARP_SKIP_EMPTY_SOURCE", "YES")) )
+    {
+        return false;
+    }
+    GDALDataset* poSrcDS = GDALDataset::FromHandle(psOptions->hSrcDS);
+
+    const auto IsEmpty = [nSrcXOff, nSrcYOff, nSrcXSize, nSrcYSize](
+                                                    GDALRasterBand* poBand)
+    {
+        return poBand->GetDataCoverageStatus(
+                    nSrcXOff, nSrcYOff, nSrcXSize, nSrcYSize,
+                    GDAL_DATA_COVERAGE_STATUS_DATA, nullptr) ==
+                        GDAL_DATA_COVERAGE_STATUS_EMPTY;
+    };
+
+    if( psOptions->nSrcAlphaBand > 0 )
+    {
+        GDALRasterBand* poAlphaBand =
+            poSrcDS->GetRasterBand(psOptions->nSrcAlphaBand);
+        if( poAlphaBand == nullptr )
+            return false;
+        // Holes are read with the nodata value, if any, or 0.
+        int bHasNoData = FALSE;
+        const double dfNoData = poAlphaBand->GetNoDataValue(&bHasNoData);
+        return (!bHasNoData || dfNoData == 0.0) && IsEmpty(poAlphaBand);
+    }
+
+    if( psOptions->padfSrcNoDataReal == nullptr || psOptions->nBandCount == 0 )
+        return false;
+    for( int i = 0; i < psOptions->nBandCount; ++i )
+    {
+        GDALRasterBand* poBand =
+            poSrcDS->GetRasterBand(psOptions->panSrcBands[i]);
+        if( poBand == nullptr )
+            return false;
+        int bHasNoData = FALSE;
+        const double dfNoData = poBand->GetNoDataValue(&bHasNoData);
+        const double dfWarpNoData = psOptions->padfSrcNoDataReal[i];
+        if( !bHasNoData ||
+            !(ARE_REAL_EQUAL(dfNoData, dfWarpNoData) ||
+              (std::isnan(dfNoData) && std::isnan(dfWarpNoData))) ||
+            (psOptions->padfSrcNoDataImag != nullptr &&
+             psOptions->padfSrcNoDataImag[i] != 0.0) ||
+            !IsEmpty(poBand) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 /************************************************************************/
 /*                       CollectChunkListInternal()                     */
 /************************************************************************/
@@ -1293,9 +1514,13 @@ CPLErr GDALWarpOperation::CollectChunkListInternal(
 /*      If we are allowed to drop no-source regions, do so now if       */
 /*      appropriate.                                                    */
 /* -------------------------------------------------------------------- */
-    if( (nSrcXSize == 0 || nSrcYSize == 0)
-        && CPLFetchBool( psOptions->papszWarpOptions, "SKIP_NOSOURCE", false ))
+    if( CPLFetchBool( psOptions->papszWarpOptions, "SKIP_NOSOURCE", false ) &&
+        (nSrcXSize == 0 || nSrcYSize == 0 ||
+         GDALWarpIsSourceWindowEmpty(psOptions, nSrcXOff, nSrcYOff,
+                                     nSrcXSize, nSrcYSize)) )
+    {
         return CE_None;
+    }
 
 /* -------------------------------------------------------------------- */
 /*      Based on the types of masks in use, how many bits will each     */
@@ -1465,6 +1690,7 @@ CPLErr GDALWarpOperation::CollectChunkListInternal(
     pasChunkList[nChunkListCount].ssy = nSrcYSize;
     pasChunkList[nChunkListCount].sExtraSx = dfSrcXExtraSize;
     pasChunkList[nChunkListCount].sExtraSy = dfSrcYExtraSize;
+    pasChunkList[nChunkListCount].dfMemoryUse = dfTotalMemoryUse;
 
     nChunkListCount++;
 
@@ -1561,6 +1787,15 @@ CPLErr GDALWarpOperation::WarpRegion( int nDstXOff, int nDstYOff,
                                       double dfProgressScale)
 
 {
+    CPLTraceSpan oSpan("warp", "GDALWarpOperation::WarpRegion");
+    if( oSpan.IsActive() )
+    {
+        oSpan.AddArg("dst_x_off", nDstXOff);
+        oSpan.AddArg("dst_y_off", nDstYOff);
+        oSpan.AddArg("dst_x_size", nDstXSize);
+        oSpan.AddArg("dst_y_size", nDstYSize);
+    }
+
     ReportTiming( nullptr );
 
 /* -------------------------------------------------------------------- */
@@ -1580,6 +1815,7 @@ CPLErr GDALWarpOperation::WarpRegion( int nDstXOff, int nDstYOff,
     GDALDataset* poDstDS = reinterpret_cast<GDALDataset*>(psOptions->hDstDS);
     if( !bDstBufferInitialized )
     {
+        CPL_TRACE_SPAN("warp", "Output buffer read");
         CPLErr eErr = CE_None;
         if( psOptions->nBandCount == 1 )
         {
@@ -1628,6 +1864,7 @@ CPLErr GDALWarpOperation::WarpRegion( int nDstXOff, int nDstYOff,
 /* -------------------------------------------------------------------- */
     if( eErr == CE_None )
     {
+        CPL_TRACE_SPAN("warp", "Output buffer write");
         if( psOptions->nBandCount == 1 )
         {
             // Particular case to simplify the stack a bit.
@@ -1835,6 +2072,24 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
     oWK.papszWarpOptions = psOptions->papszWarpOptions;
     oWK.psThreadData = psThreadData;
 
+    // In a worker thread of ChunkAndWarpMulti(), use its own transformer
+    // and kernel thread data, so that the warp can run concurrently with
+    // the one of other chunks.
+    GDALWarpChunkThreadContext* psChunkContext =
+        hIOMutex != nullptr ? GetChunkThreadContext(this) : nullptr;
+    const bool bConcurrentWarp =
+        psChunkContext != nullptr && psChunkContext->pTransformerArg != nullptr;
+    if( psChunkContext != nullptr && oWK.pfnProgress != GDALDummyProgress )
+    {
+        oWK.pfnProgress = ChunkThreadProgress;
+        oWK.pProgress = psChunkContext;
+    }
+    if( bConcurrentWarp )
+    {
+        oWK.pTransformerArg = psChunkContext->pTransformerArg;
+        oWK.psThreadData = psChunkContext->psThreadData;
+    }
+
     oWK.padfDstNoDataReal = psOptions->padfDstNoDataReal;
 
 /* -------------------------------------------------------------------- */
@@ -1879,6 +2134,12 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
 
     if( eErr == CE_None && nSrcXSize > 0 && nSrcYSize > 0 )
     {
+        CPLTraceSpan oSpan("warp", "Input buffer read");
+        if( oSpan.IsActive() )
+        {
+            oSpan.AddArg("src_x_size", nSrcXSize);
+            oSpan.AddArg("src_y_size", nSrcYSize);
+        }
         GDALDataset* poSrcDS =
             reinterpret_cast<GDALDataset*>(psOptions->hSrcDS);
         if( psOptions->nBandCount == 1 )
@@ -2208,12 +2469,13 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
     }
 
 /* -------------------------------------------------------------------- */
-/*      Release IO Mutex, and acquire warper mutex.                     */
+/*      Release IO Mutex, and acquire warper mutex, unless chunks       */
+/*      are warped concurrently.                                        */
 /* -------------------------------------------------------------------- */
     if( hIOMutex != nullptr )
     {
         CPLReleaseMutex( hIOMutex );
-        if( !CPLAcquireMutex( hWarpMutex, 600.0 ) )
+        if( !bConcurrentWarp && !CPLAcquireMutex( hWarpMutex, 600.0 ) )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
                       "Failed to acquire WarpMutex in WarpRegion()." );
@@ -2234,7 +2496,8 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
     if( eErr == CE_None )
     {
         eErr = oWK.PerformWarp();
-        ReportTiming( "In memory warp operation" );
+        if( !bConcurrentWarp )
+            ReportTiming( "In memory warp operation" );
     }
 
 /* -------------------------------------------------------------------- */
@@ -2249,7 +2512,8 @@ CPLErr GDALWarpOperation::WarpRegionToBuffer(
 /* -------------------------------------------------------------------- */
     if( hIOMutex != nullptr )
     {
-        CPLReleaseMutex( hWarpMutex );
+        if( !bConcurrentWarp )
+            CPLReleaseMutex( hWarpMutex );
         if( !CPLAcquireMutex( hIOMutex, 600.0 ) )
         {
             CPLError( CE_Failure, CPLE_AppDefined,
@@ -2571,6 +2835,8 @@ CPLErr GDALWarpOperation::ComputeSourceWindow(
     double *pdfSrcFillRatio )
 
 {
+    CPL_TRACE_SPAN("warp", "GDALWarpOperation::ComputeSourceWindow");
+
 /* -------------------------------------------------------------------- */
 /*      Figure out whether we just want to do the usual "along the      */
 /*      edge" sampling, or using a grid.  The grid usage is             */
@@ -0,0 +1,791 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Warp API
+ * Purpose:  Precomputed coordinate grid ("warp plan") transformer
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gdal_alg.h"
+#include "gdal_alg_priv.h"
+
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "cpl_atomic_ops.h"
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_minixml.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+
+CPL_CVSID("$Id$")
+
+CPL_C_START
+void *GDALDeserializeWarpPlanTransformer( CPLXMLNode *psTree );
+CPL_C_END
+
+/************************************************************************/
+/*                           GDALWarpPlanGrid                           */
+/************************************************************************/
+
+// Immutable part of a warp plan, shared by the transformers created with
+// GDALCreateSimilarTransformer() / GDALCloneTransformer().
+typedef struct
+{
+    int         nDstXSize;
+    int         nDstYSize;
+    int         nStep;
+
+    // Number of grid nodes. Node (i, j) is at destination pixel/line
+    // (i * nStep, j * nStep).
+    int         nGridXSize;
+    int         nGridYSize;
+
+    // Source pixel/line of each node, or NaN where the base transformer
+    // failed.
+    double     *padfSrcX;
+    double     *padfSrcY;
+
+    // For each of the (nGridXSize - 1) * (nGridYSize - 1) cells, non-zero
+    // if the bilinear interpolation is not accurate enough and points must
+    // be transformed with the base transformer. May be NULL.
+    GByte      *pabyExactCells;
+
+    double      dfMaxError;
+
+    // Serialized base transformer. May be NULL.
+    CPLXMLNode *psBaseTransformerTree;
+
+    volatile int nRefCount;
+} GDALWarpPlanGrid;
+
+typedef struct
+{
+    GDALTransformerInfo sTI;
+
+    GDALWarpPlanGrid   *psGrid;
+
+    // Ratio between the resolution of the source dataset the plan has been
+    // computed for, and the one of the dataset it is used with (overviews).
+    double              dfSrcRatioX;
+    double              dfSrcRatioY;
+
+    // Lazily instantiated from psGrid->psBaseTransformerTree.
+    bool                bBaseTransformerTried;
+    GDALTransformerFunc pfnBaseTransformer;
+    void               *pBaseTransformArg;
+} GDALWarpPlanTransformInfo;
+
+/************************************************************************/
+/*                       GDALWarpPlanGridRelease()                      */
+/************************************************************************/
+
+static void GDALWarpPlanGridRelease( GDALWarpPlanGrid *psGrid )
+{
+    if( psGrid != nullptr && CPLAtomicDec(&(psGrid->nRefCount)) == 0 )
+    {
+        VSIFree(psGrid->padfSrcX);
+        VSIFree(psGrid->padfSrcY);
+        VSIFree(psGrid->pabyExactCells);
+        if( psGrid->psBaseTransformerTree )
+            CPLDestroyXMLNode(psGrid->psBaseTransformerTree);
+        CPLFree(psGrid);
+    }
+}
+
+/************************************************************************/
+/*                       GDALWarpPlanGridAlloc()                        */
+/************************************************************************/
+
+static GDALWarpPlanGrid *GDALWarpPlanGridAlloc( int nDstXSize, int nDstYSize,
+                                                int nStep )
+{
+    if( nDstXSize <= 0 || nDstYSize <= 0 || nStep <= 0 )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid dimensions for warp plan");
+        return nullptr;
+    }
+
+    GDALWarpPlanGrid *psGrid = static_cast<GDALWarpPlanGrid *>(
+        CPLCalloc(1, sizeof(GDALWarpPlanGrid)));
+    psGrid->nDstXSize = nDstXSize;
+    psGrid->nDstYSize = nDstYSize;
+    psGrid->nStep = nStep;
+    psGrid->nGridXSize = (nDstXSize - 1) / nStep + 2;
+    psGrid->nGridYSize = (nDstYSize - 1) / nStep + 2;
+    psGrid->nRefCount = 1;
+
+    const size_t nNodes = static_cast<size_t>(psGrid->nGridXSize) *
+                          psGrid->nGridYSize;
+    psGrid->padfSrcX = static_cast<double *>(
+        VSI_MALLOC2_VERBOSE(nNodes, sizeof(double)));
+    psGrid->padfSrcY = static_cast<double *>(
+        VSI_MALLOC2_VERBOSE(nNodes, sizeof(double)));
+    if( psGrid->padfSrcX == nullptr || psGrid->padfSrcY == nullptr )
+    {
+        GDALWarpPlanGridRelease(psGrid);
+        return nullptr;
+    }
+    return psGrid;
+}
+
+/************************************************************************/
+/*                     GDALWarpPlanTransformerNew()                     */
+/************************************************************************/
+
+// Takes ownership of a reference on psGrid.
+static GDALWarpPlanTransformInfo *GDALWarpPlanTransformerNew(
+    GDALWarpPlanGrid *psGrid, double dfSrcRatioX, double dfSrcRatioY );
+
+/************************************************************************/
+/*                  GDALCreateSimilarWarpPlanTransformer()              */
+/************************************************************************/
+
+static void *GDALCreateSimilarWarpPlanTransformer( void *hTransformArg,
+                                                   double dfRatioX,
+                                                   double dfRatioY )
+{
+    VALIDATE_POINTER1( hTransformArg, "GDALCreateSimilarWarpPlanTransformer",
+                       nullptr );
+
+    GDALWarpPlanTransformInfo *psInfo =
+        static_cast<GDALWarpPlanTransformInfo *>(hTransformArg);
+
+    // The grid is immutable and can be shared. Each instance has its own
+    // base transformer though, so that instances can be used from
+    // different threads.
+    CPLAtomicInc(&(psInfo->psGrid->nRefCount));
+    return GDALWarpPlanTransformerNew(psInfo->psGrid,
+                                      psInfo->dfSrcRatioX * dfRatioX,
+                                      psInfo->dfSrcRatioY * dfRatioY);
+}
+
+/************************************************************************/
+/*                   GDALSerializeWarpPlanTransformer()                 */
+/************************************************************************/
+
+static CPLXMLNode *GDALSerializeWarpPlanTransformer( void *pTransformArg );
+
+/************************************************************************/
+/*                      GDALWarpPlanTransformerNew()                    */
+/************************************************************************/
+
+static GDALWarpPlanTransformInfo *GDALWarpPlanTransformerNew(
+    GDALWarpPlanGrid *psGrid, double dfSrcRatioX, double dfSrcRatioY )
+{
+    GDALWarpPlanTransformInfo *psInfo = static_cast<GDALWarpPlanTransformInfo *>(
+        CPLCalloc(1, sizeof(GDALWarpPlanTransformInfo)));
+
+    memcpy(psInfo->sTI.abySignature,
+           GDAL_GTI2_SIGNATURE,
+           strlen(GDAL_GTI2_SIGNATURE));
+    psInfo->sTI.pszClassName = "GDALWarpPlanTransformer";
+    psInfo->sTI.pfnTransform = GDALWarpPlanTransform;
+    psInfo->sTI.pfnCleanup = GDALDestroyWarpPlanTransformer;
+    psInfo->sTI.pfnSerialize = GDALSerializeWarpPlanTransformer;
+    psInfo->sTI.pfnCreateSimilar = GDALCreateSimilarWarpPlanTransformer;
+
+    psInfo->psGrid = psGrid;
+    psInfo->dfSrcRatioX = dfSrcRatioX;
+    psInfo->dfSrcRatioY = dfSrcRatioY;
+
+    return psInfo;
+}
+
+/************************************************************************/
+/*                   GDALWarpPlanGetBaseTransformer()                   */
+/************************************************************************/
+
+static bool GDALWarpPlanGetBaseTransformer( GDALWarpPlanTransformInfo *psInfo )
+{
+    if( !psInfo->bBaseTransformerTried )
+    {
+        psInfo->bBaseTransformerTried = true;
+        if( psInfo->psGrid->psBaseTransformerTree != nullptr )
+        {
+            GDALDeserializeTransformer( psInfo->psGrid->psBaseTransformerTree,
+                                        &psInfo->pfnBaseTransformer,
+                                        &psInfo->pBaseTransformArg );
+            if( psInfo->pBaseTransformArg == nullptr )
+                psInfo->pfnBaseTransformer = nullptr;
+        }
+    }
+    return psInfo->pfnBaseTransformer != nullptr;
+}
+
+/************************************************************************/
+/*                    GDALCreateWarpPlanTransformer()                   */
+/************************************************************************/
+
+/**
+ * Create a warp plan transformer.
+ *
+ * A warp plan is a precomputed map of the source pixel/line coordinates
+ * of a destination grid, stored at the nodes of a sparse grid. It can be
+ * used to warp many datasets that share the same source and destination
+ * grids without having to run the (possibly expensive) base transformer
+ * again. Destination to source transformations are computed by bilinear
+ * interpolation between the nodes of the plan.
+ *
+ * The base transformer is used to compute the plan. If it is serializable,
+ * its serialization is kept with the plan, and it is instantiated again when
+ * needed, that is for source to destination transformations, and for
+ * points that cannot be interpolated: those outside of the destination grid,
+ * or in cells where the interpolation is not accurate enough, or where the
+ * base transformer failed for one of the nodes.
+ *
+ * Warp plan transformers are serializable, so a plan can be computed once,
+ * saved with CPLSerializeXMLTreeToFile(GDALSerializeTransformer()), and
+ * reloaded in other processes with CPLParseXMLFile() and
+ * GDALDeserializeTransformer().
+ *
+ * The transformer is used with destination pixel/line coordinates, as
+ * GDALWarpOperation does. So the base transformer is typically a
+ * GDALGenImgProjTransformer (not approximated) between the source dataset
+ * and the destination grid.
+ *
+ * Supported options are:
+ * <ul>
+ * <li>MAX_ERROR=val: maximum error, in source pixels, accepted for the
+ * bilinear interpolation. The interpolation is checked at the center of each
+ * cell of the plan, and points of the cells where it is above the threshold
+ * are transformed with the base transformer. Defaults to 0.125. 0 disables
+ * the check.</li>
+ * </ul>
+ *
+ * @param pfnBaseTransformer the transformer from which the plan is computed.
+ * @param pBaseTransformArg the callback argument for the base transformer.
+ * It is only used during this call.
+ * @param nDstXSize width of the destination grid, in pixels.
+ * @param nDstYSize height of the destination grid, in pixels.
+ * @param nStep spacing of the nodes of the plan, in destination pixels.
+ * @param papszOptions NULL terminated list of options, or NULL.
+ *
+ * @return the transform argument, to be destroyed with
+ * GDALDestroyWarpPlanTransformer(), or NULL in case of error.
+ *
+ * @since GDAL 3.4
+ */
+
+void *GDALCreateWarpPlanTransformer( GDALTransformerFunc pfnBaseTransformer,
+                                     void *pBaseTransformArg,
+                                     int nDstXSize, int nDstYSize,
+                                     int nStep,
+                                     CSLConstList papszOptions )
+{
+    VALIDATE_POINTER1( pfnBaseTransformer, "GDALCreateWarpPlanTransformer",
+                       nullptr );
+
+    GDALWarpPlanGrid *psGrid =
+        GDALWarpPlanGridAlloc(nDstXSize, nDstYSize, nStep);
+    if( psGrid == nullptr )
+        return nullptr;
+    psGrid->dfMaxError = CPLAtof(
+        CSLFetchNameValueDef(papszOptions, "MAX_ERROR", "0.125"));
+
+/* -------------------------------------------------------------------- */
+/*      Compute the source coordinates of the nodes, one row at a time.  */
+/* -------------------------------------------------------------------- */
+    const int nGridXSize = psGrid->nGridXSize;
+    const int nGridYSize = psGrid->nGridYSize;
+    std::vector<double> adfX(nGridXSize);
+    std::vector<double> adfY(nGridXSize);
+    std::vector<double> adfZ(nGridXSize);
+    std::vector<int> abSuccess(nGridXSize);
+    for( int j = 0; j < nGridYSize; j++ )
+    {
+        for( int i = 0; i < nGridXSize; i++ )
+        {
+            adfX[i] = static_cast<double>(i) * nStep;
+            adfY[i] = static_cast<double>(j) * nStep;
+            adfZ[i] = 0.0;
+            abSuccess[i] = FALSE;
+        }
+        pfnBaseTransformer( pBaseTransformArg, TRUE, nGridXSize,
+                            adfX.data(), adfY.data(), adfZ.data(),
+                            abSuccess.data() );
+        const size_t nOffset = static_cast<size_t>(j) * nGridXSize;
+        for( int i = 0; i < nGridXSize; i++ )
+        {
+            if( abSuccess[i] && std::isfinite(adfX[i]) &&
+                std::isfinite(adfY[i]) )
+            {
+                psGrid->padfSrcX[nOffset + i] = adfX[i];
+                psGrid->padfSrcY[nOffset + i] = adfY[i];
+            }
+            else
+            {
+                psGrid->padfSrcX[nOffset + i] =
+                    std::numeric_limits<double>::quiet_NaN();
+                psGrid->padfSrcY[nOffset + i] =
+                    std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Check the interpolation at the center of each cell.             */
+/* -------------------------------------------------------------------- */
+    if( psGrid->dfMaxError > 0 && nStep > 1 )
+    {
+        const int nCellsX = nGridXSize - 1;
+        int nExactCells = 0;
+        std::vector<GByte> abyExactCells(
+            static_cast<size_t>(nCellsX) * (nGridYSize - 1));
+        for( int j = 0; j < nGridYSize - 1; j++ )
+        {
+            for( int i = 0; i < nCellsX; i++ )
+            {
+                adfX[i] = (i + 0.5) * nStep;
+                adfY[i] = (j + 0.5) * nStep;
+                adfZ[i] = 0.0;
+                abSuccess[i] = FALSE;
+            }
+            pfnBaseTransformer( pBaseTransformArg, TRUE, nCellsX,
+                                adfX.data(), adfY.data(), adfZ.data(),
+                                abSuccess.data() );
+            for( int i = 0; i < nCellsX; i++ )
+            {
+                const size_t nOffset = static_cast<size_t>(j) * nGridXSize + i;
+                const double dfInterpX = 0.25 * (
+                    psGrid->padfSrcX[nOffset] +
+                    psGrid->padfSrcX[nOffset + 1] +
+                    psGrid->padfSrcX[nOffset + nGridXSize] +
+                    psGrid->padfSrcX[nOffset + nGridXSize + 1]);
+                const double dfInterpY = 0.25 * (
+                    psGrid->padfSrcY[nOffset] +
+                    psGrid->padfSrcY[nOffset + 1] +
+                    psGrid->padfSrcY[nOffset + nGridXSize] +
+                    psGrid->padfSrcY[nOffset + nGridXSize + 1]);
+                // Cells with an invalid node are already transformed with
+                // the base transformer (NaN comparisons are false).
+                if( abSuccess[i] &&
+                    (fabs(dfInterpX - adfX[i]) > psGrid->dfMaxError ||
+                     fabs(dfInterpY - adfY[i]) > psGrid->dfMaxError) )
+                {
+                    abyExactCells[static_cast<size_t>(j) * nCellsX + i] = 1;
+                    nExactCells++;
+                }
+            }
+        }
+        if( nExactCells > 0 )
+        {
+            CPLDebug("WARP", "Warp plan: %d cells out of %d need exact "
+                     "transformation", nExactCells,
+                     nCellsX * (nGridYSize - 1));
+            psGrid->pabyExactCells = static_cast<GByte *>(
+                VSI_MALLOC_VERBOSE(abyExactCells.size()));
+            if( psGrid->pabyExactCells == nullptr )
+            {
+                GDALWarpPlanGridRelease(psGrid);
+                return nullptr;
+            }
+            memcpy(psGrid->pabyExactCells, abyExactCells.data(),
+                   abyExactCells.size());
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Keep a serialized version of the base transformer.              */
+/* -------------------------------------------------------------------- */
+    {
+        CPLErrorStateBackuper oErrorStateBackuper;
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        psGrid->psBaseTransformerTree =
+            GDALSerializeTransformer(pfnBaseTransformer, pBaseTransformArg);
+        CPLPopErrorHandler();
+    }
+    if( psGrid->psBaseTransformerTree == nullptr )
+    {
+        CPLDebug("WARP", "Warp plan: base transformer is not serializable. "
+                 "Only interpolated destination to source transformations "
+                 "will be available");
+    }
+
+    return GDALWarpPlanTransformerNew(psGrid, 1.0, 1.0);
+}
+
+/************************************************************************/
+/*                   GDALDestroyWarpPlanTransformer()                   */
+/************************************************************************/
+
+/**
+ * Destroy warp plan transformer.
+ *
+ * @param pTransformArg the transform arg previously returned by
+ * GDALCreateWarpPlanTransformer().
+ *
+ * @since GDAL 3.4
+ */
+
+void GDALDestroyWarpPlanTransformer( void *pTransformArg )
+
+{
+    if( pTransformArg == nullptr )
+        return;
+
+    GDALWarpPlanTransformInfo *psInfo =
+        static_cast<GDALWarpPlanTransformInfo *>(pTransformArg);
+
+    if( psInfo->pBaseTransformArg != nullptr )
+        GDALDestroyTransformer(psInfo->pBaseTransformArg);
+    GDALWarpPlanGridRelease(psInfo->psGrid);
+    CPLFree(psInfo);
+}
+
+/************************************************************************/
+/*                        GDALWarpPlanTransform()                       */
+/************************************************************************/
+
+/**
+ * Transforms points with a warp plan.
+ *
+ * This function matches the GDALTransformerFunc signature.
+ * Destination to source transformations are interpolated from the plan
+ * when possible. Other transformations are delegated to the base
+ * transformer, if it is available.
+ *
+ * @param pTransformArg return value from GDALCreateWarpPlanTransformer().
+ * @param bDstToSrc TRUE if transformation is from the destination
+ * pixel/line coordinates to source pixel/line coordinates.
+ * @param nPointCount the number of values in the x, y and z arrays.
+ * @param x array containing the X values to be transformed.
+ * @param y array containing the Y values to be transformed.
+ * @param z array containing the Z values to be transformed.
+ * @param panSuccess array in which a flag indicating success (TRUE) or
+ * failure (FALSE) of the transformation are placed.
+ *
+ * @return TRUE if all points have been successfully transformed.
+ *
+ * @since GDAL 3.4
+ */
+
+int GDALWarpPlanTransform( void *pTransformArg, int bDstToSrc,
+                           int nPointCount,
+                           double *x, double *y, double *z,
+                           int *panSuccess )
+{
+    VALIDATE_POINTER1( pTransformArg, "GDALWarpPlanTransform", 0 );
+
+    GDALWarpPlanTransformInfo *psInfo =
+        static_cast<GDALWarpPlanTransformInfo *>(pTransformArg);
+    const GDALWarpPlanGrid *psGrid = psInfo->psGrid;
+
+    if( !bDstToSrc )
+    {
+        if( !GDALWarpPlanGetBaseTransformer(psInfo) )
+        {
+            for( int i = 0; i < nPointCount; i++ )
+                panSuccess[i] = FALSE;
+            return FALSE;
+        }
+        for( int i = 0; i < nPointCount; i++ )
+        {
+            x[i] *= psInfo->dfSrcRatioX;
+            y[i] *= psInfo->dfSrcRatioY;
+        }
+        return psInfo->pfnBaseTransformer( psInfo->pBaseTransformArg, FALSE,
+                                           nPointCount, x, y, z,
+                                           panSuccess );
+    }
+
+    const int nGridXSize = psGrid->nGridXSize;
+    const double dfMaxGridX = nGridXSize - 1;
+    const double dfMaxGridY = psGrid->nGridYSize - 1;
+    const double dfInvStep = 1.0 / psGrid->nStep;
+    std::vector<int> anExact;
+
+    for( int i = 0; i < nPointCount; i++ )
+    {
+        const double dfGridX = x[i] * dfInvStep;
+        const double dfGridY = y[i] * dfInvStep;
+        // Written that way to also catch NaN.
+        if( !(dfGridX >= 0 && dfGridX <= dfMaxGridX &&
+              dfGridY >= 0 && dfGridY <= dfMaxGridY) )
+        {
+            anExact.push_back(i);
+            continue;
+        }
+        const int iX = std::min(static_cast<int>(dfGridX), nGridXSize - 2);
+        const int iY = std::min(static_cast<int>(dfGridY),
+                                psGrid->nGridYSize - 2);
+        if( psGrid->pabyExactCells != nullptr &&
+            psGrid->pabyExactCells[static_cast<size_t>(iY) *
+                                   (nGridXSize - 1) + iX] )
+        {
+            anExact.push_back(i);
+            continue;
+        }
+
+        const size_t nOffset = static_cast<size_t>(iY) * nGridXSize + iX;
+        const double dfDX = dfGridX - iX;
+        const double dfDY = dfGridY - iY;
+        const double* padfSrcX = psGrid->padfSrcX + nOffset;
+        const double* padfSrcY = psGrid->padfSrcY + nOffset;
+        const double dfSrcX =
+            (1 - dfDY) * ((1 - dfDX) * padfSrcX[0] + dfDX * padfSrcX[1]) +
+            dfDY * ((1 - dfDX) * padfSrcX[nGridXSize] +
+                    dfDX * padfSrcX[nGridXSize + 1]);
+        const double dfSrcY =
+            (1 - dfDY) * ((1 - dfDX) * padfSrcY[0] + dfDX * padfSrcY[1]) +
+            dfDY * ((1 - dfDX) * padfSrcY[nGridXSize] +
+                    dfDX * padfSrcY[nGridXSize + 1]);
+        if( std::isnan(dfSrcX) || std::isnan(dfSrcY) )
+        {
+            anExact.push_back(i);
+            continue;
+        }
+        x[i] = dfSrcX / psInfo->dfSrcRatioX;
+        y[i] = dfSrcY / psInfo->dfSrcRatioY;
+        panSuccess[i] = TRUE;
+    }
+
+    if( anExact.empty() )
+        return TRUE;
+
+/* -------------------------------------------------------------------- */
+/*      Transform the remaining points with the base transformer.       */
+/* -------------------------------------------------------------------- */
+    if( !GDALWarpPlanGetBaseTransformer(psInfo) )
+    {
+        for( const int i: anExact )
+            panSuccess[i] = FALSE;
+        return FALSE;
+    }
+
+    const int nExact = static_cast<int>(anExact.size());
+    std::vector<double> adfX(nExact);
+    std::vector<double> adfY(nExact);
+    std::vector<double> adfZ(nExact);
+    std::vector<int> abSuccess(nExact);
+    for( int k = 0; k < nExact; k++ )
+    {
+        adfX[k] = x[anExact[k]];
+        adfY[k] = y[anExact[k]];
+        adfZ[k] = z ? z[anExact[k]] : 0.0;
+    }
+    psInfo->pfnBaseTransformer( psInfo->pBaseTransformArg, TRUE, nExact,
+                                adfX.data(), adfY.data(), adfZ.data(),
+                                abSuccess.data() );
+    bool bRet = true;
+    for( int k = 0; k < nExact; k++ )
+    {
+        const int i = anExact[k];
+        x[i] = adfX[k] / psInfo->dfSrcRatioX;
+        y[i] = adfY[k] / psInfo->dfSrcRatioY;
+        if( z )
+            z[i] = adfZ[k];
+        panSuccess[i] = abSuccess[k];
+        if( !abSuccess[k] )
+            bRet = false;
+    }
+    return bRet;
+}
+
+/************************************************************************/
+/*                     GDALWarpPlanEncodeDoubles()                      */
+/************************************************************************/
+
+static char *GDALWarpPlanEncodeDoubles( const double *padfValues,
+                                        size_t nCount )
+{
+    if( nCount > static_cast<size_t>(INT_MAX) / sizeof(double) )
+        return nullptr;
+#if CPL_IS_LSB
+    return CPLBase64Encode( static_cast<int>(nCount * sizeof(double)),
+                            reinterpret_cast<const GByte *>(padfValues) );
+#else
+    std::vector<double> adfValues(padfValues, padfValues + nCount);
+    for( auto& dfVal: adfValues )
+        CPL_LSBPTR64(&dfVal);
+    return CPLBase64Encode( static_cast<int>(nCount * sizeof(double)),
+                            reinterpret_cast<const GByte *>(adfValues.data()) );
+#endif
+}
+
+/************************************************************************/
+/*                     GDALWarpPlanDecodeBuffer()                       */
+/************************************************************************/
+
+static bool GDALWarpPlanDecodeBuffer( CPLXMLNode *psTree,
+                                      const char *pszElement,
+                                      void *pBuffer, size_t nBytes )
+{
+    const char *pszValue = CPLGetXMLValue(psTree, pszElement, nullptr);
+    if( pszValue == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Missing %s element in WarpPlanTransformer", pszElement);
+        return false;
+    }
+    GByte *pabyDecoded = reinterpret_cast<GByte *>(CPLStrdup(pszValue));
+    const int nDecoded = CPLBase64DecodeInPlace(pabyDecoded);
+    const bool bOK = nDecoded >= 0 && static_cast<size_t>(nDecoded) == nBytes;
+    if( bOK )
+        memcpy(pBuffer, pabyDecoded, nBytes);
+    else
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Invalid size for %s element in WarpPlanTransformer",
+                 pszElement);
+    CPLFree(pabyDecoded);
+    return bOK;
+}
+
+/************************************************************************/
+/*                  GDALSerializeWarpPlanTransformer()                  */
+/************************************************************************/
+
+static CPLXMLNode *GDALSerializeWarpPlanTransformer( void *pTransformArg )
+
+{
+    VALIDATE_POINTER1( pTransformArg, "GDALSerializeWarpPlanTransformer",
+                       nullptr );
+
+    const GDALWarpPlanTransformInfo *psInfo =
+        static_cast<const GDALWarpPlanTransformInfo *>(pTransformArg);
+    const GDALWarpPlanGrid *psGrid = psInfo->psGrid;
+    const size_t nNodes = static_cast<size_t>(psGrid->nGridXSize) *
+                          psGrid->nGridYSize;
+
+    char *pszSrcX = GDALWarpPlanEncodeDoubles(psGrid->padfSrcX, nNodes);
+    char *pszSrcY = GDALWarpPlanEncodeDoubles(psGrid->padfSrcY, nNodes);
+    if( pszSrcX == nullptr || pszSrcY == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Warp plan too large to be serialized");
+        CPLFree(pszSrcX);
+        CPLFree(pszSrcY);
+        return nullptr;
+    }
+
+    CPLXMLNode *psTree =
+        CPLCreateXMLNode( nullptr, CXT_Element, "WarpPlanTransformer" );
+
+    CPLCreateXMLElementAndValue( psTree, "DstXSize",
+        CPLSPrintf("%d", psGrid->nDstXSize) );
+    CPLCreateXMLElementAndValue( psTree, "DstYSize",
+        CPLSPrintf("%d", psGrid->nDstYSize) );
+    CPLCreateXMLElementAndValue( psTree, "Step",
+        CPLSPrintf("%d", psGrid->nStep) );
+    CPLCreateXMLElementAndValue( psTree, "MaxError",
+        CPLSPrintf("%.18g", psGrid->dfMaxError) );
+    if( psInfo->dfSrcRatioX != 1.0 || psInfo->dfSrcRatioY != 1.0 )
+    {
+        CPLCreateXMLElementAndValue( psTree, "SrcRatioX",
+            CPLSPrintf("%.18g", psInfo->dfSrcRatioX) );
+        CPLCreateXMLElementAndValue( psTree, "SrcRatioY",
+            CPLSPrintf("%.18g", psInfo->dfSrcRatioY) );
+    }
+
+    CPLCreateXMLElementAndValue( psTree, "SrcX", pszSrcX );
+    CPLCreateXMLElementAndValue( psTree, "SrcY", pszSrcY );
+    CPLFree(pszSrcX);
+    CPLFree(pszSrcY);
+
+    if( psGrid->pabyExactCells != nullptr )
+    {
+        char *pszExactCells = CPLBase64Encode(
+            (psGrid->nGridXSize - 1) * (psGrid->nGridYSize - 1),
+            psGrid->pabyExactCells);
+        CPLCreateXMLElementAndValue( psTree, "ExactCells", pszExactCells );
+        CPLFree(pszExactCells);
+    }
+
+    if( psGrid->psBaseTransformerTree != nullptr )
+    {
+        CPLXMLNode *psTransformerContainer =
+            CPLCreateXMLNode( psTree, CXT_Element, "BaseTransformer" );
+        CPLAddXMLChild( psTransformerContainer,
+                        CPLCloneXMLTree(psGrid->psBaseTransformerTree) );
+    }
+
+    return psTree;
+}
+
+/************************************************************************/
+/*                 GDALDeserializeWarpPlanTransformer()                 */
+/************************************************************************/
+
+void *GDALDeserializeWarpPlanTransformer( CPLXMLNode *psTree )
+
+{
+    GDALWarpPlanGrid *psGrid = GDALWarpPlanGridAlloc(
+        atoi(CPLGetXMLValue(psTree, "DstXSize", "0")),
+        atoi(CPLGetXMLValue(psTree, "DstYSize", "0")),
+        atoi(CPLGetXMLValue(psTree, "Step", "0")));
+    if( psGrid == nullptr )
+        return nullptr;
+    psGrid->dfMaxError = CPLAtof(CPLGetXMLValue(psTree, "MaxError", "0"));
+
+    const size_t nNodes = static_cast<size_t>(psGrid->nGridXSize) *
+                          psGrid->nGridYSize;
+    if( !GDALWarpPlanDecodeBuffer(psTree, "SrcX", psGrid->padfSrcX,
+                                  nNodes * sizeof(double)) ||
+        !GDALWarpPlanDecodeBuffer(psTree, "SrcY", psGrid->padfSrcY,
+                                  nNodes * sizeof(double)) )
+    {
+        GDALWarpPlanGridRelease(psGrid);
+        return nullptr;
+    }
+#if !CPL_IS_LSB
+    for( size_t i = 0; i < nNodes; i++ )
+    {
+        CPL_LSBPTR64(&psGrid->padfSrcX[i]);
+        CPL_LSBPTR64(&psGrid->padfSrcY[i]);
+    }
+#endif
+
+    if( CPLGetXMLNode(psTree, "ExactCells") != nullptr )
+    {
+        const size_t nCells = static_cast<size_t>(psGrid->nGridXSize - 1) *
+                              (psGrid->nGridYSize - 1);
+        psGrid->pabyExactCells =
+            static_cast<GByte *>(VSI_MALLOC_VERBOSE(nCells));
+        if( psGrid->pabyExactCells == nullptr ||
+            !GDALWarpPlanDecodeBuffer(psTree, "ExactCells",
+                                      psGrid->pabyExactCells, nCells) )
+        {
+            GDALWarpPlanGridRelease(psGrid);
+            return nullptr;
+        }
+    }
+
+    CPLXMLNode *psContainer = CPLGetXMLNode( psTree, "BaseTransformer" );
+    if( psContainer != nullptr && psContainer->psChild != nullptr )
+    {
+        // The base transformer is only instantiated when needed.
+        psGrid->psBaseTransformerTree = CPLCloneXMLTree(psContainer->psChild);
+    }
+
+    return GDALWarpPlanTransformerNew(
+        psGrid,
+        CPLAtof(CPLGetXMLValue(psTree, "SrcRatioX", "1")),
+        CPLAtof(CPLGetXMLValue(psTree, "SrcRatioY", "1")));
+}
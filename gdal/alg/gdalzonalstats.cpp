@@ -0,0 +1,685 @@
+/******************************************************************************
+ *
+ * Project:  GDAL
+ * Purpose:  Zonal statistics of a raster band over the polygons of a layer.
+ * Author:   GDAL contributors
+ *
+ ******************************************************************************
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gdal_alg.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "gdal_alg_priv.h"
+#include "gdal_priv.h"
+#include "ogr_api.h"
+#include "ogr_core.h"
+#include "ogr_geometry.h"
+#include "ogr_spatialref.h"
+#include "ogrsf_frmts.h"
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_progress.h"
+#include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
+#include "gdal_thread_pool.h"
+
+CPL_CVSID("$Id$")
+
+namespace
+{
+
+// Size of the raster data read for a single job.
+constexpr size_t knMaxBytesPerJob = 16 * 1024 * 1024;
+// Size of the raster data read before running the pending jobs.
+constexpr size_t knMaxBytesPerBatch = 256 * 1024 * 1024;
+
+typedef struct
+{
+    double dfCount;
+    double dfSum;
+    double dfSumSquares;
+    double dfMin;
+    double dfMax;
+} ZonalStats;
+
+void InitStats( ZonalStats& sStats )
+{
+    sStats.dfCount = 0.0;
+    sStats.dfSum = 0.0;
+    sStats.dfSumSquares = 0.0;
+    sStats.dfMin = std::numeric_limits<double>::infinity();
+    sStats.dfMax = -std::numeric_limits<double>::infinity();
+}
+
+void MergeStats( ZonalStats& sStats, const ZonalStats& sOther )
+{
+    sStats.dfCount += sOther.dfCount;
+    sStats.dfSum += sOther.dfSum;
+    sStats.dfSumSquares += sOther.dfSumSquares;
+    sStats.dfMin = std::min(sStats.dfMin, sOther.dfMin);
+    sStats.dfMax = std::max(sStats.dfMax, sOther.dfMax);
+}
+
+// Polygon rings of a zone, in pixel/line coordinates of the source band.
+typedef struct
+{
+    std::vector<double> adfX{};
+    std::vector<double> adfY{};
+    std::vector<int> anPartSize{};
+} ZoneRings;
+
+typedef struct
+{
+    OGRFeature* poFeature = nullptr;
+    std::unique_ptr<ZoneRings> poRings{};
+    ZonalStats sStats{};
+} ZoneFeature;
+
+typedef struct
+{
+    const ZoneRings* psRings = nullptr;
+    int nXOff = 0;
+    int nYOff = 0;
+    int nXSize = 0;
+    int nYSize = 0;
+    int nSubPixels = 1;
+    bool bAllTouched = false;
+    std::vector<double> adfData{};
+    std::vector<GByte> abyMask{};  // empty if all valid
+    ZonalStats sStats{};
+    size_t iZone = 0;
+} ZonalStatsJob;
+
+typedef struct
+{
+    GByte* pabyCoverage;
+    int nXSize;
+    int nYSize;
+} CoverageInfo;
+
+/************************************************************************/
+/*                        SetCoverageScanline()                         */
+/************************************************************************/
+
+void SetCoverageScanline( void *pCBData, int nY, int nXStart, int nXEnd,
+                          double /* dfVariant */ )
+{
+    CoverageInfo* psInfo = static_cast<CoverageInfo*>(pCBData);
+    nXStart = std::max(nXStart, 0);
+    nXEnd = std::min(nXEnd, psInfo->nXSize - 1);
+    if( nXStart > nXEnd )
+        return;
+    memset(psInfo->pabyCoverage + static_cast<size_t>(nY) * psInfo->nXSize +
+           nXStart, 1, nXEnd - nXStart + 1);
+}
+
+/************************************************************************/
+/*                          SetCoveragePoint()                          */
+/************************************************************************/
+
+void SetCoveragePoint( void *pCBData, int nY, int nX,
+                       double /* dfVariant */ )
+{
+    CoverageInfo* psInfo = static_cast<CoverageInfo*>(pCBData);
+    if( nX >= 0 && nX < psInfo->nXSize && nY >= 0 && nY < psInfo->nYSize )
+        psInfo->pabyCoverage[static_cast<size_t>(nY) * psInfo->nXSize + nX] = 1;
+}
+
+/************************************************************************/
+/*                          ZonalStatsJobFunc()                         */
+/************************************************************************/
+
+void ZonalStatsJobFunc( void* pData )
+{
+    ZonalStatsJob* psJob = static_cast<ZonalStatsJob*>(pData);
+    InitStats(psJob->sStats);
+
+    // Rasterize the zone on a grid of nSubPixels x nSubPixels sub-pixels
+    // per pixel, relative to the job window.
+    const int nSub = psJob->nSubPixels;
+    const int nCovXSize = psJob->nXSize * nSub;
+    const int nCovYSize = psJob->nYSize * nSub;
+    std::vector<GByte> abyCoverage;
+    try
+    {
+        abyCoverage.resize(static_cast<size_t>(nCovXSize) * nCovYSize);
+    }
+    catch( const std::exception& )
+    {
+        psJob->sStats.dfCount = -1;  // signals the failure
+        return;
+    }
+
+    const ZoneRings* psRings = psJob->psRings;
+    const size_t nPoints = psRings->adfX.size();
+    std::vector<double> adfX(nPoints);
+    std::vector<double> adfY(nPoints);
+    for( size_t i = 0; i < nPoints; i++ )
+    {
+        adfX[i] = (psRings->adfX[i] - psJob->nXOff) * nSub;
+        adfY[i] = (psRings->adfY[i] - psJob->nYOff) * nSub;
+    }
+
+    CoverageInfo sInfo;
+    sInfo.pabyCoverage = abyCoverage.data();
+    sInfo.nXSize = nCovXSize;
+    sInfo.nYSize = nCovYSize;
+    const int nParts = static_cast<int>(psRings->anPartSize.size());
+    GDALdllImageFilledPolygon(nCovXSize, nCovYSize, nParts,
+                              psRings->anPartSize.data(),
+                              adfX.data(), adfY.data(), nullptr,
+                              SetCoverageScanline, &sInfo);
+    if( psJob->bAllTouched )
+    {
+        GDALdllImageLineAllTouched(nCovXSize, nCovYSize, nParts,
+                                   psRings->anPartSize.data(),
+                                   adfX.data(), adfY.data(), nullptr,
+                                   SetCoveragePoint, &sInfo, FALSE);
+    }
+
+    const double dfSubPixelWeight = 1.0 / (nSub * nSub);
+    for( int iY = 0; iY < psJob->nYSize; iY++ )
+    {
+        for( int iX = 0; iX < psJob->nXSize; iX++ )
+        {
+            const size_t iPixel =
+                static_cast<size_t>(iY) * psJob->nXSize + iX;
+            if( !psJob->abyMask.empty() && psJob->abyMask[iPixel] == 0 )
+                continue;
+            const double dfVal = psJob->adfData[iPixel];
+            if( std::isnan(dfVal) )
+                continue;
+
+            int nCovered = 0;
+            for( int iSubY = 0; iSubY < nSub; iSubY++ )
+            {
+                const GByte* pabyCovLine = abyCoverage.data() +
+                    static_cast<size_t>(iY * nSub + iSubY) * nCovXSize +
+                    static_cast<size_t>(iX) * nSub;
+                for( int iSubX = 0; iSubX < nSub; iSubX++ )
+                    nCovered += pabyCovLine[iSubX];
+            }
+            if( nCovered == 0 )
+                continue;
+
+            const double dfWeight = nCovered * dfSubPixelWeight;
+            ZonalStats& sStats = psJob->sStats;
+            sStats.dfCount += dfWeight;
+            sStats.dfSum += dfWeight * dfVal;
+            sStats.dfSumSquares += dfWeight * dfVal * dfVal;
+            sStats.dfMin = std::min(sStats.dfMin, dfVal);
+            sStats.dfMax = std::max(sStats.dfMax, dfVal);
+        }
+    }
+}
+
+/************************************************************************/
+/*                          CollectZoneRings()                          */
+/************************************************************************/
+
+// Collect the rings of the polygonal parts of poGeom, converted to
+// pixel/line coordinates.
+void CollectZoneRings( const OGRGeometry* poGeom,
+                       const double adfInvGeoTransform[6],
+                       ZoneRings& sRings )
+{
+    if( poGeom == nullptr || poGeom->IsEmpty() )
+        return;
+    const OGRwkbGeometryType eFlatType =
+        wkbFlatten(poGeom->getGeometryType());
+    if( eFlatType == wkbPolygon )
+    {
+        for( const auto poRing: *(poGeom->toPolygon()) )
+        {
+            const int nCount = poRing->getNumPoints();
+            if( nCount == 0 )
+                continue;
+            for( int i = 0; i < nCount; i++ )
+            {
+                const double dfX = poRing->getX(i);
+                const double dfY = poRing->getY(i);
+                sRings.adfX.push_back(adfInvGeoTransform[0] +
+                                      dfX * adfInvGeoTransform[1] +
+                                      dfY * adfInvGeoTransform[2]);
+                sRings.adfY.push_back(adfInvGeoTransform[3] +
+                                      dfX * adfInvGeoTransform[4] +
+                                      dfY * adfInvGeoTransform[5]);
+            }
+            sRings.anPartSize.push_back(nCount);
+        }
+    }
+    else if( eFlatType == wkbMultiPolygon ||
+             eFlatType == wkbGeometryCollection )
+    {
+        for( const auto poSubGeom: *(poGeom->toGeometryCollection()) )
+            CollectZoneRings(poSubGeom, adfInvGeoTransform, sRings);
+    }
+    else if( eFlatType == wkbCurvePolygon || eFlatType == wkbMultiSurface )
+    {
+        std::unique_ptr<OGRGeometry> poLinear(poGeom->getLinearGeometry());
+        CollectZoneRings(poLinear.get(), adfInvGeoTransform, sRings);
+    }
+    else
+    {
+        CPLDebug("GDAL", "Zonal statistics ignoring non-polygonal geometry.");
+    }
+}
+
+/************************************************************************/
+/*                             SetStatField()                           */
+/************************************************************************/
+
+void SetStatField( OGRFeature* poFeature, int iField, double dfValue )
+{
+    if( iField >= 0 )
+        poFeature->SetField(iField, dfValue);
+}
+
+} // namespace
+
+/************************************************************************/
+/*                         GDALZonalStatistics()                        */
+/************************************************************************/
+
+/**
+ * Compute statistics of a raster band over the polygons of a layer.
+ *
+ * For each feature of hZoneLayer, a feature is created in hOutLayer with
+ * the statistics of the valid pixels of hSrcBand covered by its polygonal
+ * geometry. The zones are rasterized on the fly with the same scanline code
+ * as GDALRasterizeGeometries(), one window at a time, so no intermediate
+ * raster is created and the source band is only read over the extent of the
+ * zones.
+ *
+ * By default, a pixel belongs to a zone when its center is inside the zone,
+ * as done by GDALRasterizeGeometries(). With COVERAGE=FRACTIONAL, each pixel
+ * is weighted by the fraction of its area covered by the zone, estimated on
+ * a grid of sub-pixels.
+ *
+ * Pixels masked by the mask band of hSrcBand, and NaN values, are ignored.
+ * Zones are expected to be in the coordinate reference system of the raster,
+ * or to have a coordinate reference system set on their layer, in which case
+ * they are reprojected.
+ *
+ * The following fields are written in hOutLayer, and created if they do not
+ * exist yet:
+ * <ul>
+ * <li>zone_fid (Integer64): FID of the zone feature.</li>
+ * <li>count (Real): (weighted) count of valid pixels.</li>
+ * <li>sum, mean, min, max, stddev (Real): statistics of the valid pixel
+ * values. They are left unset when the zone has no valid pixel.</li>
+ * </ul>
+ * When hOutLayer has a geometry field, the zone geometry is copied to it.
+ *
+ * @param hSrcBand the source raster band.
+ * @param hZoneLayer the layer with the zone polygons.
+ * @param hOutLayer the layer where the statistics are written.
+ * @param papszOptions a name/value list of additional options
+ * <ul>
+ * <li>COVERAGE=CENTER/ALL_TOUCHED/FRACTIONAL: how pixels are assigned to
+ * zones. CENTER (default) selects the pixels whose center is in the zone,
+ * ALL_TOUCHED all the pixels touched by the zone, and FRACTIONAL weights
+ * the pixels by their covered fraction.</li>
+ * <li>SUBPIXELS=n: number of sub-pixels per pixel in each direction used
+ * with COVERAGE=FRACTIONAL. Defaults to 8.</li>
+ * <li>NUM_THREADS=number_of_threads/ALL_CPUS: Number of threads used to
+ * rasterize the zones and accumulate the statistics. The source band is
+ * read, and the features are written, by the calling thread, in the order of
+ * the zone layer. Defaults to the value of the GDAL_NUM_THREADS
+ * configuration option, or 1.</li>
+ * </ul>
+ * @param pfnProgress callback for reporting algorithm progress matching the
+ * GDALProgressFunc() semantics.  May be NULL.
+ * @param pProgressArg callback argument passed to pfnProgress.
+ *
+ * @return CE_None on success or CE_Failure on a failure.
+ *
+ * @since GDAL 3.4
+ */
+
+CPLErr GDALZonalStatistics( GDALRasterBandH hSrcBand,
+                            OGRLayerH hZoneLayer,
+                            OGRLayerH hOutLayer,
+                            CSLConstList papszOptions,
+                            GDALProgressFunc pfnProgress,
+                            void *pProgressArg )
+{
+    VALIDATE_POINTER1( hSrcBand, "GDALZonalStatistics", CE_Failure );
+    VALIDATE_POINTER1( hZoneLayer, "GDALZonalStatistics", CE_Failure );
+    VALIDATE_POINTER1( hOutLayer, "GDALZonalStatistics", CE_Failure );
+
+    if( pfnProgress == nullptr )
+        pfnProgress = GDALDummyProgress;
+
+    GDALRasterBand* poBand = GDALRasterBand::FromHandle(hSrcBand);
+    OGRLayer* poZoneLayer = OGRLayer::FromHandle(hZoneLayer);
+    OGRLayer* poOutLayer = OGRLayer::FromHandle(hOutLayer);
+
+/* -------------------------------------------------------------------- */
+/*      Options.                                                        */
+/* -------------------------------------------------------------------- */
+    const char* pszCoverage =
+        CSLFetchNameValueDef(papszOptions, "COVERAGE", "CENTER");
+    bool bAllTouched = false;
+    int nSubPixels = 1;
+    if( EQUAL(pszCoverage, "ALL_TOUCHED") )
+    {
+        bAllTouched = true;
+    }
+    else if( EQUAL(pszCoverage, "FRACTIONAL") )
+    {
+        nSubPixels =
+            atoi(CSLFetchNameValueDef(papszOptions, "SUBPIXELS", "8"));
+        if( nSubPixels < 1 || nSubPixels > 64 )
+        {
+            CPLError(CE_Failure, CPLE_IllegalArg,
+                     "SUBPIXELS should be between 1 and 64");
+            return CE_Failure;
+        }
+    }
+    else if( !EQUAL(pszCoverage, "CENTER") )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Unsupported value for COVERAGE: %s", pszCoverage);
+        return CE_Failure;
+    }
+
+    const char *pszNumThreads = CSLFetchNameValue(papszOptions, "NUM_THREADS");
+    if( pszNumThreads == nullptr )
+        pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                       atoi(pszNumThreads);
+    if( nThreads > 128 )
+        nThreads = 128;
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    if( nThreads > 1 )
+    {
+        CPLWorkerThreadPool *poThreadPool = GDALGetGlobalThreadPool(nThreads);
+        if( poThreadPool )
+            poJobQueue = poThreadPool->CreateJobQueue();
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Georeferencing.                                                 */
+/* -------------------------------------------------------------------- */
+    GDALDataset* poDS = poBand->GetDataset();
+    double adfGeoTransform[6] = { 0.0, 1.0, 0.0, 0.0, 0.0, 1.0 };
+    if( poDS )
+        poDS->GetGeoTransform(adfGeoTransform);
+    double adfInvGeoTransform[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    if( !GDALInvGeoTransform(adfGeoTransform, adfInvGeoTransform) )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Cannot invert the geotransform of the source band");
+        return CE_Failure;
+    }
+
+    std::unique_ptr<OGRCoordinateTransformation> poCT;
+    const OGRSpatialReference* poRasterSRS =
+        poDS ? poDS->GetSpatialRef() : nullptr;
+    const OGRSpatialReference* poZoneSRS = poZoneLayer->GetSpatialRef();
+    if( poRasterSRS && poZoneSRS && !poRasterSRS->IsSame(poZoneSRS) )
+    {
+        poCT.reset(OGRCreateCoordinateTransformation(poZoneSRS, poRasterSRS));
+        if( poCT == nullptr )
+            return CE_Failure;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Output fields.                                                  */
+/* -------------------------------------------------------------------- */
+    const char* const apszFieldNames[] = {
+        "zone_fid", "count", "sum", "mean", "min", "max", "stddev" };
+    int anFieldIdx[7] = {};
+    for( int i = 0; i < 7; i++ )
+    {
+        anFieldIdx[i] =
+            poOutLayer->GetLayerDefn()->GetFieldIndex(apszFieldNames[i]);
+        if( anFieldIdx[i] < 0 )
+        {
+            OGRFieldDefn oField(apszFieldNames[i],
+                                i == 0 ? OFTInteger64 : OFTReal);
+            if( poOutLayer->CreateField(&oField) != OGRERR_NONE )
+                return CE_Failure;
+            anFieldIdx[i] =
+                poOutLayer->GetLayerDefn()->GetFieldIndex(apszFieldNames[i]);
+        }
+    }
+    const bool bCopyGeometry =
+        poOutLayer->GetLayerDefn()->GetGeomFieldCount() > 0;
+
+/* -------------------------------------------------------------------- */
+/*      Process the zones by batches: the raster windows are read by    */
+/*      the calling thread, then the jobs rasterize the zones and       */
+/*      accumulate the statistics, and the results are written in       */
+/*      the zone layer order.                                           */
+/* -------------------------------------------------------------------- */
+    const int nRasterXSize = poBand->GetXSize();
+    const int nRasterYSize = poBand->GetYSize();
+    GDALRasterBand* poMaskBand = nullptr;
+    if( poBand->GetMaskFlags() != GMF_ALL_VALID )
+        poMaskBand = poBand->GetMaskBand();
+    const size_t nBytesPerPixel =
+        sizeof(double) + (poMaskBand ? 1 : 0) +
+        static_cast<size_t>(nSubPixels) * nSubPixels;
+
+    const GIntBig nTotalFeatures =
+        pfnProgress == GDALDummyProgress ? 0 :
+        poZoneLayer->GetFeatureCount(TRUE);
+    GIntBig nProcessedFeatures = 0;
+
+    std::vector<ZoneFeature> asZones;
+    std::vector<ZonalStatsJob> asJobs;
+    size_t nBatchBytes = 0;
+    CPLErr eErr = CE_None;
+
+    const auto FlushBatch = [&]()
+    {
+        if( poJobQueue && asJobs.size() > 1 )
+        {
+            for( auto& sJob: asJobs )
+                poJobQueue->SubmitJob(ZonalStatsJobFunc, &sJob);
+            poJobQueue->WaitCompletion();
+        }
+        else
+        {
+            for( auto& sJob: asJobs )
+                ZonalStatsJobFunc(&sJob);
+        }
+
+        for( const auto& sJob: asJobs )
+        {
+            if( sJob.sStats.dfCount < 0 )
+            {
+                CPLError(CE_Failure, CPLE_OutOfMemory,
+                         "Out of memory in zonal statistics");
+                eErr = CE_Failure;
+            }
+            else
+            {
+                MergeStats(asZones[sJob.iZone].sStats, sJob.sStats);
+            }
+        }
+        asJobs.clear();
+        nBatchBytes = 0;
+
+        for( auto& sZone: asZones )
+        {
+            if( eErr == CE_None )
+            {
+                OGRFeature oOutFeature(poOutLayer->GetLayerDefn());
+                const ZonalStats& sStats = sZone.sStats;
+                oOutFeature.SetField(anFieldIdx[0],
+                                     sZone.poFeature->GetFID());
+                oOutFeature.SetField(anFieldIdx[1], sStats.dfCount);
+                if( sStats.dfCount > 0 )
+                {
+                    const double dfMean = sStats.dfSum / sStats.dfCount;
+                    SetStatField(&oOutFeature, anFieldIdx[2], sStats.dfSum);
+                    SetStatField(&oOutFeature, anFieldIdx[3], dfMean);
+                    SetStatField(&oOutFeature, anFieldIdx[4], sStats.dfMin);
+                    SetStatField(&oOutFeature, anFieldIdx[5], sStats.dfMax);
+                    SetStatField(&oOutFeature, anFieldIdx[6],
+                        sqrt(std::max(0.0, sStats.dfSumSquares /
+                                           sStats.dfCount - dfMean * dfMean)));
+                }
+                if( bCopyGeometry )
+                    oOutFeature.SetGeometryDirectly(
+                        sZone.poFeature->StealGeometry());
+                if( poOutLayer->CreateFeature(&oOutFeature) != OGRERR_NONE )
+                    eErr = CE_Failure;
+            }
+            delete sZone.poFeature;
+            nProcessedFeatures++;
+        }
+        asZones.clear();
+
+        if( eErr == CE_None && nTotalFeatures > 0 &&
+            !pfnProgress(std::min(1.0, static_cast<double>(nProcessedFeatures) /
+                                       nTotalFeatures), "", pProgressArg) )
+        {
+            CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+            eErr = CE_Failure;
+        }
+    };
+
+    poZoneLayer->ResetReading();
+    OGRFeature* poFeature = nullptr;
+    while( eErr == CE_None &&
+           (poFeature = poZoneLayer->GetNextFeature()) != nullptr )
+    {
+        asZones.emplace_back();
+        ZoneFeature& sZone = asZones.back();
+        sZone.poFeature = poFeature;
+        sZone.poRings.reset(new ZoneRings());
+        InitStats(sZone.sStats);
+
+        const OGRGeometry* poGeom = poFeature->GetGeometryRef();
+        std::unique_ptr<OGRGeometry> poTransformedGeom;
+        if( poGeom && poCT )
+        {
+            poTransformedGeom.reset(poGeom->clone());
+            if( poTransformedGeom->transform(poCT.get()) != OGRERR_NONE )
+            {
+                CPLError(CE_Warning, CPLE_AppDefined,
+                         "Cannot reproject zone " CPL_FRMT_GIB,
+                         poFeature->GetFID());
+                poTransformedGeom.reset();
+            }
+            poGeom = poTransformedGeom.get();
+        }
+        ZoneRings& sRings = *(sZone.poRings);
+        CollectZoneRings(poGeom, adfInvGeoTransform, sRings);
+
+        if( !sRings.adfX.empty() )
+        {
+            // Pixel window of the zone.
+            const auto oMinMaxX =
+                std::minmax_element(sRings.adfX.begin(), sRings.adfX.end());
+            const auto oMinMaxY =
+                std::minmax_element(sRings.adfY.begin(), sRings.adfY.end());
+            const int nXOff = static_cast<int>(std::max(
+                0.0, std::floor(*oMinMaxX.first)));
+            const int nYOff = static_cast<int>(std::max(
+                0.0, std::floor(*oMinMaxY.first)));
+            const int nXEnd = static_cast<int>(std::min(
+                static_cast<double>(nRasterXSize), std::ceil(*oMinMaxX.second)));
+            const int nYEnd = static_cast<int>(std::min(
+                static_cast<double>(nRasterYSize), std::ceil(*oMinMaxY.second)));
+            const int nXSize = nXEnd - nXOff;
+            const int nLinesPerJob = nXSize <= 0 ? 0 : static_cast<int>(
+                std::max(static_cast<size_t>(1),
+                         knMaxBytesPerJob /
+                            (static_cast<size_t>(nXSize) * nBytesPerPixel)));
+
+            for( int iYOff = nYOff; nXSize > 0 && iYOff < nYEnd;
+                 iYOff += nLinesPerJob )
+            {
+                asJobs.emplace_back();
+                ZonalStatsJob& sJob = asJobs.back();
+                sJob.psRings = &sRings;
+                sJob.nXOff = nXOff;
+                sJob.nYOff = iYOff;
+                sJob.nXSize = nXSize;
+                sJob.nYSize = std::min(nLinesPerJob, nYEnd - iYOff);
+                sJob.nSubPixels = nSubPixels;
+                sJob.bAllTouched = bAllTouched;
+                sJob.iZone = asZones.size() - 1;
+                const size_t nPixels =
+                    static_cast<size_t>(sJob.nXSize) * sJob.nYSize;
+                try
+                {
+                    sJob.adfData.resize(nPixels);
+                    if( poMaskBand )
+                        sJob.abyMask.resize(nPixels);
+                }
+                catch( const std::exception& )
+                {
+                    CPLError(CE_Failure, CPLE_OutOfMemory,
+                             "Out of memory in zonal statistics");
+                    eErr = CE_Failure;
+                    break;
+                }
+                eErr = poBand->RasterIO(GF_Read, sJob.nXOff, sJob.nYOff,
+                                        sJob.nXSize, sJob.nYSize,
+                                        sJob.adfData.data(),
+                                        sJob.nXSize, sJob.nYSize,
+                                        GDT_Float64, 0, 0, nullptr);
+                if( eErr == CE_None && poMaskBand )
+                {
+                    eErr = poMaskBand->RasterIO(GF_Read, sJob.nXOff,
+                                                sJob.nYOff,
+                                                sJob.nXSize, sJob.nYSize,
+                                                sJob.abyMask.data(),
+                                                sJob.nXSize, sJob.nYSize,
+                                                GDT_Byte, 0, 0, nullptr);
+                }
+                if( eErr != CE_None )
+                    break;
+                nBatchBytes += nPixels * nBytesPerPixel;
+            }
+        }
+
+        if( eErr == CE_None && nBatchBytes >= knMaxBytesPerBatch )
+            FlushBatch();
+    }
+    if( eErr == CE_None )
+        FlushBatch();
+
+    for( auto& sZone: asZones )
+        delete sZone.poFeature;
+
+    if( eErr == CE_None && !pfnProgress(1.0, "", pProgressArg) )
+    {
+        CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+        eErr = CE_Failure;
+    }
+
+    return eErr;
+}
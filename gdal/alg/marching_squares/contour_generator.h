@@ -31,8 +31,13 @@
 
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
 
 #include "gdal.h"
+#include "cpl_worker_thread_pool.h"
+#include "gdal_thread_pool.h"
 
 #include "utility.h"
 #include "point.h"
@@ -71,6 +76,63 @@ public:
         }
         return CE_None;
     }
+
+    // Feeds nLines consecutive lines stored in lines. The squares of the
+    // lines are computed in parallel by jobQueue and their segments are then
+    // given to the writer in line order, so that the result is the same as
+    // with successive calls to feedLine().
+    CPLErr feedLines( const double* lines, size_t nLines, CPLJobQueue* jobQueue )
+    {
+        if ( jobQueue == nullptr || nLines < 2 )
+        {
+            for ( size_t i = 0; i < nLines; i++ )
+                feedLine( lines + i * width_ );
+            return CE_None;
+        }
+        if ( lineIdx_ + nLines > height_ )
+            return CE_Failure;
+
+        std::vector<SegmentRecorder> recorders( nLines, SegmentRecorder( writer_.polygonize ) );
+        const size_t nJobs = std::min( nLines,
+            size_t(4 * std::max( 1, jobQueue->GetPool()->GetThreadCount() )) );
+        std::vector<LinesJob> jobs( nJobs );
+        for ( size_t i = 0; i < nJobs; i++ )
+        {
+            jobs[i].generator = this;
+            jobs[i].lines = lines;
+            jobs[i].first = i * nLines / nJobs;
+            jobs[i].last = (i + 1) * nLines / nJobs;
+            jobs[i].recorders = &recorders[0];
+            jobQueue->SubmitJob( LinesJob::Run, &jobs[i] );
+        }
+        jobQueue->WaitCompletion();
+        for ( const auto& job : jobs )
+        {
+            if ( !job.error.empty() )
+                throw std::runtime_error( job.error );
+        }
+
+        for ( const auto& recorder : recorders )
+        {
+            writer_.beginningOfLine();
+            for ( const auto& s : recorder.segments )
+            {
+                if ( s.border )
+                    writer_.addBorderSegment( s.levelIdx, s.start, s.end );
+                else
+                    writer_.addSegment( s.levelIdx, s.start, s.end );
+            }
+            writer_.endOfLine();
+        }
+        std::copy( lines + (nLines - 1) * width_, lines + nLines * width_, previousLine_.begin() );
+        lineIdx_ += nLines;
+
+        if ( lineIdx_ == height_ ) {
+            // last line
+            feedLine_( nullptr );
+        }
+        return CE_None;
+    }
 private:
     size_t width_;
     size_t height_;
@@ -111,21 +173,87 @@ private:
         bool hasNoData_;
         double noDataValue_;
     };
-    void feedLine_( const double* line )
+    // Stores the segments of a line, to be given later to the real writer
+    struct RecordedSegment
     {
-        writer_.beginningOfLine();
+        int levelIdx;
+        bool border;
+        Point start;
+        Point end;
+    };
+
+    struct SegmentRecorder
+    {
+        explicit SegmentRecorder( bool polygonize_ ) : polygonize( polygonize_ ) {}
+
+        void addSegment( int levelIdx, const Point& start, const Point& end )
+        {
+            segments.push_back( RecordedSegment{ levelIdx, false, start, end } );
+        }
+
+        void addBorderSegment( int levelIdx, const Point& start, const Point& end )
+        {
+            segments.push_back( RecordedSegment{ levelIdx, true, start, end } );
+        }
 
-        ExtendedLine previous( &previousLine_[0], width_, hasNoData_, noDataValue_ );
+        bool polygonize;
+        std::vector<RecordedSegment> segments{};
+    };
+
+    struct LinesJob
+    {
+        const ContourGenerator* generator = nullptr;
+        const double* lines = nullptr;
+        size_t first = 0;
+        size_t last = 0;
+        SegmentRecorder* recorders = nullptr;
+        std::string error{};
+
+        static void Run( void* pData )
+        {
+            LinesJob* job = static_cast<LinesJob*>( pData );
+            const ContourGenerator* generator = job->generator;
+            const size_t width = generator->width_;
+            try
+            {
+                for ( size_t i = job->first; i < job->last; i++ )
+                {
+                    const double* previous = i == 0 ? &generator->previousLine_[0]
+                                                    : job->lines + (i - 1) * width;
+                    generator->processSquares_( previous, job->lines + i * width,
+                                                generator->lineIdx_ + i,
+                                                job->recorders[i] );
+                }
+            }
+            catch ( const std::exception& e )
+            {
+                job->error = e.what();
+            }
+        }
+    };
+
+    template <typename Writer>
+    void processSquares_( const double* previousLine, const double* line,
+                          size_t lineIdx, Writer& writer ) const
+    {
+        ExtendedLine previous( previousLine, width_, hasNoData_, noDataValue_ );
         ExtendedLine current( line, width_, hasNoData_, noDataValue_ );
         for ( int colIdx = -1; colIdx < int(width_); colIdx++ )
         {
-            const ValuedPoint upperLeft(colIdx + 1 - .5, lineIdx_ - .5, previous.value( colIdx ));
-            const ValuedPoint upperRight(colIdx + 1 + .5, lineIdx_ - .5, previous.value( colIdx+1 ));
-            const ValuedPoint lowerLeft(colIdx + 1 - .5, lineIdx_ + .5, current.value( colIdx ));
-            const ValuedPoint lowerRight(colIdx + 1 + .5, lineIdx_ + .5, current.value( colIdx+1 ));
+            const ValuedPoint upperLeft(colIdx + 1 - .5, lineIdx - .5, previous.value( colIdx ));
+            const ValuedPoint upperRight(colIdx + 1 + .5, lineIdx - .5, previous.value( colIdx+1 ));
+            const ValuedPoint lowerLeft(colIdx + 1 - .5, lineIdx + .5, current.value( colIdx ));
+            const ValuedPoint lowerRight(colIdx + 1 + .5, lineIdx + .5, current.value( colIdx+1 ));
 
-            Square(upperLeft, upperRight, lowerLeft, lowerRight).process(levelGenerator_, writer_);
+            Square(upperLeft, upperRight, lowerLeft, lowerRight).process(levelGenerator_, writer);
         }
+    }
+
+    void feedLine_( const double* line )
+    {
+        writer_.beginningOfLine();
+
+        processSquares_( &previousLine_[0], line, lineIdx_, writer_ );
         if ( line != nullptr )
             std::copy( line, line + width_, previousLine_.begin() );
         lineIdx_++;
@@ -158,10 +286,22 @@ public:
     {
     }
 
-    bool process( GDALProgressFunc progressFunc = nullptr, void* progressData = nullptr )
+    bool process( GDALProgressFunc progressFunc = nullptr, void* progressData = nullptr,
+                  int numThreads = 1 )
     {
         size_t width = GDALGetRasterBandXSize( band_ );
         size_t height = GDALGetRasterBandYSize( band_ );
+
+        std::unique_ptr<CPLJobQueue> jobQueue;
+        if ( numThreads > 1 && height > 1 )
+        {
+            CPLWorkerThreadPool* threadPool = GDALGetGlobalThreadPool( numThreads );
+            if ( threadPool )
+                jobQueue = threadPool->CreateJobQueue();
+        }
+        if ( jobQueue )
+            return processChunks_( width, height, jobQueue.get(), progressFunc, progressData );
+
         std::vector<double> line;
         line.resize( width );
 
@@ -186,6 +326,38 @@ public:
 private:
     const GDALRasterBandH band_;
 
+    // Reads the band by chunks of lines whose squares are processed in parallel
+    bool processChunks_( size_t width, size_t height, CPLJobQueue* jobQueue,
+                         GDALProgressFunc progressFunc, void* progressData )
+    {
+        // about 16 MB of input values per chunk
+        const size_t chunkHeight = std::max( size_t(2),
+            std::min( height, size_t(16 * 1024 * 1024) / (width * sizeof(double)) ) );
+        std::vector<double> lines;
+        lines.resize( width * chunkHeight );
+
+        for ( size_t lineIdx = 0; lineIdx < height; lineIdx += chunkHeight )
+        {
+            if ( progressFunc && progressFunc( double(lineIdx) / height, "Processing line", progressData ) == FALSE )
+                return false;
+
+            const size_t nLines = std::min( chunkHeight, height - lineIdx );
+            CPLErr error = GDALRasterIO(band_, GF_Read, 0, int(lineIdx), int(width),
+                                        int(nLines), &lines[0], int(width), int(nLines),
+                                        GDT_Float64, 0, 0);
+            if (error != CE_None)
+            {
+                CPLDebug("CONTOUR", "failed fetch %d %d", int(lineIdx), int(width));
+                return false;
+            }
+            if ( this->feedLines( &lines[0], nLines, jobQueue ) != CE_None )
+                return false;
+        }
+        if ( progressFunc)
+            progressFunc( 1.0, "", progressData );
+        return true;
+    }
+
     ContourGeneratorFromRaster( const ContourGeneratorFromRaster& ) = delete;
     ContourGeneratorFromRaster& operator=( const ContourGeneratorFromRaster& ) = delete;
 };
@@ -32,6 +32,7 @@
 
 #include <list>
 #include <map>
+#include <unordered_map>
 
 #include <iostream>
 
@@ -45,14 +46,30 @@ struct SegmentMerger
     {
         LineString ls = LineString();
         bool isMerged = false;
+        // creation order, which is also the order in the list of lines
+        size_t id = 0;
     };
     // a collection of unmerged linestrings
     typedef std::list<LineStringEx> Lines;
+
+    struct PointHash
+    {
+        size_t operator()( const Point& p ) const
+        {
+            // + 0.0 so that -0.0 and 0.0 have the same hash
+            return std::hash<double>()( p.x + 0.0 ) * 31 +
+                   std::hash<double>()( p.y + 0.0 );
+        }
+    };
+    // end points of the unmerged linestrings, to find the lines a segment
+    // can be merged with without scanning all of them
+    typedef std::unordered_multimap<Point, typename Lines::iterator, PointHash> EndPoints;
     
     SegmentMerger( LineWriter& lineWriter, const LevelGenerator& levelGenerator, bool polygonize_ )
         : polygonize( polygonize_ )
         , lineWriter_( lineWriter )
         , lines_()
+        , endPoints_()
         , levelGenerator_(levelGenerator)
     {}
 
@@ -132,11 +149,60 @@ private:
     LineWriter &lineWriter_;
     // lines of each level
     std::map< int, Lines > lines_;
+    // end points of the lines of each level
+    std::map< int, EndPoints > endPoints_;
+    size_t nextId_ = 0;
     const LevelGenerator &levelGenerator_;
 
+    static void indexLine_( EndPoints& endPoints, typename Lines::iterator it )
+    {
+        endPoints.emplace( it->ls.front(), it );
+        if ( ! (it->ls.back() == it->ls.front()) )
+            endPoints.emplace( it->ls.back(), it );
+    }
+
+    static void removeEndPoint_( EndPoints& endPoints, const Point& p, typename Lines::iterator it )
+    {
+        auto range = endPoints.equal_range( p );
+        for ( auto e = range.first; e != range.second; ++e ) {
+            if ( e->second == it ) {
+                endPoints.erase( e );
+                return;
+            }
+        }
+    }
+
+    static void unindexLine_( EndPoints& endPoints, typename Lines::iterator it )
+    {
+        removeEndPoint_( endPoints, it->ls.front(), it );
+        if ( ! (it->ls.back() == it->ls.front()) )
+            removeEndPoint_( endPoints, it->ls.back(), it );
+    }
+
+    // Returns the first line, in list order, that has p1 or p2 as end point
+    // and that comes after `after` (if not null)
+    static typename Lines::iterator findLine_( const EndPoints& endPoints,
+                                               const Point& p1, const Point& p2,
+                                               Lines& lines, const LineStringEx* after )
+    {
+        auto best = lines.end();
+        for ( const Point* p : { &p1, &p2 } ) {
+            auto range = endPoints.equal_range( *p );
+            for ( auto e = range.first; e != range.second; ++e ) {
+                auto candidate = e->second;
+                if ( after && candidate->id <= after->id )
+                    continue;
+                if ( best == lines.end() || candidate->id < best->id )
+                    best = candidate;
+            }
+        }
+        return best;
+    }
+
     void addSegment_(int levelIdx, const Point &start, const Point &end)
     {
         Lines& lines = lines_[levelIdx];
+        EndPoints& endPoints = endPoints_[levelIdx];
 
         if (start == end)
         {
@@ -144,29 +210,24 @@ private:
             return;
         }
         // attempt to merge segment with existing line
-        auto it = lines.begin();
-        for(; it != lines.end(); ++it)
+        auto it = findLine_( endPoints, end, start, lines, nullptr );
+        if ( it != lines.end() )
         {
+            unindexLine_( endPoints, it );
             if ( it->ls.back() == end ) {
                 it->ls.push_back( start );
-                it->isMerged = true;
-                break;
             }
-            if ( it->ls.front() == end ) {
+            else if ( it->ls.front() == end ) {
                 it->ls.push_front( start );
-                it->isMerged = true;
-                break;
             }
-            if ( it->ls.back() == start ) {
+            else if ( it->ls.back() == start ) {
                 it->ls.push_back( end );
-                it->isMerged = true;
-                break;
             }
-            if ( it->ls.front() == start ) {
+            else {
                 it->ls.push_front( end );
-                it->isMerged = true;
-                break;
             }
+            it->isMerged = true;
+            indexLine_( endPoints, it );
         }
 
         if (it == lines.end())
@@ -176,6 +237,8 @@ private:
             lines.back().ls.push_back(start);
             lines.back().ls.push_back(end);
             lines.back().isMerged = true;
+            lines.back().id = nextId_++;
+            indexLine_( endPoints, std::prev(lines.end()) );
         }
         else if ( polygonize && (it->ls.front() == it->ls.back()) ) {
             // ring closed
@@ -185,63 +248,53 @@ private:
         else
         {
             // try to perform linemerge with another line
-            // since we got out of the previous loop on the first match
-            // there is no need to test previous elements
+            // since the segment was merged to the first matching line
+            // only following lines need to be tested
             // also: a segment merges at most two lines, no need to stall here ;)
-            auto other = it;
-            ++other;
-            for(; other != lines.end(); ++other)
+            auto other = findLine_( endPoints, it->ls.back(), it->ls.front(), lines, &*it );
+            if ( other == lines.end() )
+                return;
+
+            unindexLine_( endPoints, it );
+            unindexLine_( endPoints, other );
+            if (it->ls.back() == other->ls.front())
             {
-                if (it->ls.back() == other->ls.front())
-                {
-                    it->ls.pop_back();
-                    it->ls.splice(it->ls.end(), other->ls);
-                    it->isMerged = true;
-                    lines.erase(other);
-                    // if that makes a closed ring, returns it
-                    if ( it->ls.front() == it->ls.back() )
-                        emitLine_( levelIdx, it, /* closed */ true );
-                    break;
-                }
-                else if (other->ls.back() == it->ls.front())
-                {
-                    it->ls.pop_front();
-                    other->ls.splice(other->ls.end(), it->ls);
-                    other->isMerged = true;
-                    lines.erase(it);
-                    // if that makes a closed ring, returns it
-                    if ( other->ls.front() == other->ls.back() )
-                        emitLine_( levelIdx, other, /* closed */ true );
-                    break;
-                }
-                // two lists must be merged but one is in the opposite direction
-                else if (it->ls.back() == other->ls.back())
-                {
-                    it->ls.pop_back();
-                    for ( auto rit = other->ls.rbegin(); rit != other->ls.rend(); ++rit ) {
-                        it->ls.push_back( *rit );
-                    }
-                    it->isMerged = true;
-                    lines.erase(other);
-                    // if that makes a closed ring, returns it
-                    if ( it->ls.front() == it->ls.back() )
-                        emitLine_( levelIdx, it, /* closed */ true );
-                    break;
+                it->ls.pop_back();
+                it->ls.splice(it->ls.end(), other->ls);
+                it->isMerged = true;
+                lines.erase(other);
+            }
+            else if (other->ls.back() == it->ls.front())
+            {
+                it->ls.pop_front();
+                other->ls.splice(other->ls.end(), it->ls);
+                other->isMerged = true;
+                lines.erase(it);
+                it = other;
+            }
+            // two lists must be merged but one is in the opposite direction
+            else if (it->ls.back() == other->ls.back())
+            {
+                it->ls.pop_back();
+                for ( auto rit = other->ls.rbegin(); rit != other->ls.rend(); ++rit ) {
+                    it->ls.push_back( *rit );
                 }
-                else if (it->ls.front() == other->ls.front())
-                {
-                    it->ls.pop_front();
-                    for ( auto rit = other->ls.begin(); rit != other->ls.end(); ++rit ) {
-                        it->ls.push_front( *rit );
-                    }
-                    it->isMerged = true;
-                    lines.erase(other);
-                    // if that makes a closed ring, returns it
-                    if ( it->ls.front() == it->ls.back() )
-                        emitLine_( levelIdx, it, /* closed */ true );
-                    break;
+                it->isMerged = true;
+                lines.erase(other);
+            }
+            else
+            {
+                it->ls.pop_front();
+                for ( auto rit = other->ls.begin(); rit != other->ls.end(); ++rit ) {
+                    it->ls.push_front( *rit );
                 }
+                it->isMerged = true;
+                lines.erase(other);
             }
+            indexLine_( endPoints, it );
+            // if that makes a closed ring, returns it
+            if ( it->ls.front() == it->ls.back() )
+                emitLine_( levelIdx, it, /* closed */ true );
         }
     }
 
@@ -251,6 +304,8 @@ private:
         if ( lines.empty() )
             lines_.erase( levelIdx );
 
+        unindexLine_( endPoints_[levelIdx], it );
+
         // consume "it" and remove it from the list
         lineWriter_.addLine( levelGenerator_.level( levelIdx ), it->ls, closed );
         return lines.erase( it );
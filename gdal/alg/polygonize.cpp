@@ -49,6 +49,8 @@
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
+#include "gdal_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -382,10 +384,23 @@ void RPolygon::AddSegment( int x1, int y1, int x2, int y2, int direction )
 /*      other side of the edge.                                         */
 /************************************************************************/
 
+template<class DataType>
+static RPolygon* GetPolygon( DataType *panPolyValue, RPolygon **papoPoly,
+                             std::vector<int>& anLivePolyIds, int nId )
+{
+    if( papoPoly[nId] == nullptr )
+    {
+        papoPoly[nId] = new RPolygon( panPolyValue[nId] );
+        anLivePolyIds.push_back(nId);
+    }
+    return papoPoly[nId];
+}
+
 template<class DataType>
 static void AddEdges( GInt32 *panThisLineId, GInt32 *panLastLineId,
                       GInt32 *panPolyIdMap, DataType *panPolyValue,
-                      RPolygon **papoPoly, int iX, int iY )
+                      RPolygon **papoPoly, std::vector<int>& anLivePolyIds,
+                      int iX, int iY )
 
 {
     // TODO(schwehr): Simplify these three vars.
@@ -405,17 +420,13 @@ static void AddEdges( GInt32 *panThisLineId, GInt32 *panLastLineId,
     {
         if( nThisId != -1 )
         {
-            if( papoPoly[nThisId] == nullptr )
-                papoPoly[nThisId] = new RPolygon( panPolyValue[nThisId] );
-
-            papoPoly[nThisId]->AddSegment( iXReal, iY, iXReal+1, iY, 1 );
+            GetPolygon(panPolyValue, papoPoly, anLivePolyIds, nThisId)->
+                AddSegment( iXReal, iY, iXReal+1, iY, 1 );
         }
         if( nPreviousId != -1 )
         {
-            if( papoPoly[nPreviousId] == nullptr )
-                papoPoly[nPreviousId] = new RPolygon(panPolyValue[nPreviousId]);
-
-            papoPoly[nPreviousId]->AddSegment( iXReal, iY, iXReal+1, iY, 0 );
+            GetPolygon(panPolyValue, papoPoly, anLivePolyIds, nPreviousId)->
+                AddSegment( iXReal, iY, iXReal+1, iY, 0 );
         }
     }
 
@@ -423,18 +434,14 @@ static void AddEdges( GInt32 *panThisLineId, GInt32 *panLastLineId,
     {
         if( nThisId != -1 )
         {
-            if( papoPoly[nThisId] == nullptr )
-                papoPoly[nThisId] = new RPolygon(panPolyValue[nThisId]);
-
-            papoPoly[nThisId]->AddSegment( iXReal+1, iY, iXReal+1, iY+1, 1 );
+            GetPolygon(panPolyValue, papoPoly, anLivePolyIds, nThisId)->
+                AddSegment( iXReal+1, iY, iXReal+1, iY+1, 1 );
         }
 
         if( nRightId != -1 )
         {
-            if( papoPoly[nRightId] == nullptr )
-                papoPoly[nRightId] = new RPolygon(panPolyValue[nRightId]);
-
-            papoPoly[nRightId]->AddSegment( iXReal+1, iY, iXReal+1, iY+1, 0 );
+            GetPolygon(panPolyValue, papoPoly, anLivePolyIds, nRightId)->
+                AddSegment( iXReal+1, iY, iXReal+1, iY+1, 0 );
         }
     }
 }
@@ -443,9 +450,8 @@ static void AddEdges( GInt32 *panThisLineId, GInt32 *panLastLineId,
 /*                         EmitPolygonToLayer()                         */
 /************************************************************************/
 
-static CPLErr
-EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
-                    RPolygon *poRPoly, double *padfGeoTransform )
+static OGRGeometryH
+BuildPolygonGeometry( RPolygon *poRPoly, const double *padfGeoTransform )
 
 {
 /* -------------------------------------------------------------------- */
@@ -487,6 +493,18 @@ EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
         OGR_G_AddGeometryDirectly( hPolygon, hRing );
     }
 
+    return hPolygon;
+}
+
+/************************************************************************/
+/*                         EmitPolygonToLayer()                         */
+/************************************************************************/
+
+static CPLErr
+EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
+                    RPolygon *poRPoly, OGRGeometryH hPolygon )
+
+{
 /* -------------------------------------------------------------------- */
 /*      Create the feature object.                                      */
 /* -------------------------------------------------------------------- */
@@ -510,6 +528,89 @@ EmitPolygonToLayer( OGRLayerH hOutLayer, int iPixValField,
     return eErr;
 }
 
+/************************************************************************/
+/*                        EmitPolygonsToLayer()                         */
+/*                                                                      */
+/*      Emit and free the polygons of the given ids. Their geometries   */
+/*      are built concurrently when a job queue is provided, but the    */
+/*      features are written in the order of the ids.                   */
+/************************************************************************/
+
+namespace {
+struct PolygonizeBuildJob
+{
+    RPolygon **papoPoly = nullptr;
+    const int *panIds = nullptr;
+    OGRGeometryH *pahGeoms = nullptr;
+    int nCount = 0;
+    const double *padfGeoTransform = nullptr;
+};
+}
+
+static void BuildPolygonGeometriesJob( void *pData )
+{
+    PolygonizeBuildJob *psJob = static_cast<PolygonizeBuildJob *>(pData);
+    for( int i = 0; i < psJob->nCount; i++ )
+    {
+        psJob->pahGeoms[i] = BuildPolygonGeometry(
+            psJob->papoPoly[psJob->panIds[i]], psJob->padfGeoTransform );
+    }
+}
+
+static CPLErr
+EmitPolygonsToLayer( OGRLayerH hOutLayer, int iPixValField,
+                     RPolygon **papoPoly, const std::vector<int>& anIds,
+                     const double *padfGeoTransform,
+                     CPLJobQueue *poJobQueue, int nThreads )
+
+{
+    const int nCount = static_cast<int>(anIds.size());
+    std::vector<OGRGeometryH> ahGeoms(nCount);
+
+    // Not worth the synchronization for a few polygons.
+    constexpr int knMinPolygonsPerJob = 16;
+    const int nJobs = poJobQueue == nullptr ? 1 :
+        std::max(1, std::min(nThreads, nCount / knMinPolygonsPerJob));
+    std::vector<PolygonizeBuildJob> asJobs(nJobs);
+    for( int iJob = 0; iJob < nJobs; iJob++ )
+    {
+        const int iStart = static_cast<int>(
+            static_cast<GIntBig>(nCount) * iJob / nJobs);
+        const int iEnd = static_cast<int>(
+            static_cast<GIntBig>(nCount) * (iJob + 1) / nJobs);
+        asJobs[iJob].papoPoly = papoPoly;
+        asJobs[iJob].panIds = anIds.data() + iStart;
+        asJobs[iJob].pahGeoms = ahGeoms.data() + iStart;
+        asJobs[iJob].nCount = iEnd - iStart;
+        asJobs[iJob].padfGeoTransform = padfGeoTransform;
+    }
+    if( nJobs == 1 )
+    {
+        BuildPolygonGeometriesJob(&asJobs[0]);
+    }
+    else
+    {
+        for( auto& sJob: asJobs )
+            poJobQueue->SubmitJob(BuildPolygonGeometriesJob, &sJob);
+        poJobQueue->WaitCompletion();
+    }
+
+    CPLErr eErr = CE_None;
+    for( int i = 0; i < nCount; i++ )
+    {
+        const int nId = anIds[i];
+        if( eErr == CE_None )
+            eErr = EmitPolygonToLayer( hOutLayer, iPixValField,
+                                       papoPoly[nId], ahGeoms[i] );
+        else
+            OGR_G_DestroyGeometry( ahGeoms[i] );
+
+        delete papoPoly[nId];
+        papoPoly[nId] = nullptr;
+    }
+    return eErr;
+}
+
 /************************************************************************/
 /*                          GPMaskImageData()                           */
 /*                                                                      */
@@ -563,6 +664,21 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
     const int nConnectedness =
         CSLFetchNameValue( papszOptions, "8CONNECTED" ) ? 8 : 4;
 
+    const char *pszNumThreads = CSLFetchNameValue(papszOptions, "NUM_THREADS");
+    if( pszNumThreads == nullptr )
+        pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                       atoi(pszNumThreads);
+    if( nThreads > 128 )
+        nThreads = 128;
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    if( nThreads > 1 )
+    {
+        CPLWorkerThreadPool *poThreadPool = GDALGetGlobalThreadPool(nThreads);
+        if( poThreadPool )
+            poJobQueue = poThreadPool->CreateJobQueue();
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Confirm our output layer will support feature creation.         */
 /* -------------------------------------------------------------------- */
@@ -711,6 +827,10 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
                                  EqualityTest> oSecondEnum(nConnectedness);
     RPolygon **papoPoly = static_cast<RPolygon **>(
         CPLCalloc(sizeof(RPolygon*), oFirstEnum.nNextPolygonId));
+    // Ids of the polygons being collected, so that looking for completed
+    // polygons does not require to scan all the polygon ids of the raster.
+    std::vector<int> anLivePolyIds;
+    std::vector<int> anCompletedPolyIds;
 
 /* ==================================================================== */
 /*      Second pass during which we will actually collect polygon       */
@@ -764,7 +884,7 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
         {
             AddEdges( panThisLineId, panLastLineId,
                       oFirstEnum.panPolyIdMap, oFirstEnum.panPolyValue,
-                      papoPoly, iX, iY );
+                      papoPoly, anLivePolyIds, iX, iY );
         }
 
 /* -------------------------------------------------------------------- */
@@ -774,20 +894,22 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
 /* -------------------------------------------------------------------- */
         if( iY % 8 == 7 )
         {
-            for( int iX = 0;
-                 eErr == CE_None && iX < oSecondEnum.nNextPolygonId;
-                 iX++ )
+            anCompletedPolyIds.clear();
+            size_t nLive = 0;
+            for( const int nId: anLivePolyIds )
             {
-                if( papoPoly[iX] && papoPoly[iX]->nLastLineUpdated < iY-1 )
-                {
-                    eErr =
-                        EmitPolygonToLayer( hOutLayer, iPixValField,
-                                            papoPoly[iX], adfGeoTransform );
-
-                    delete papoPoly[iX];
-                    papoPoly[iX] = nullptr;
-                }
+                if( papoPoly[nId]->nLastLineUpdated < iY-1 )
+                    anCompletedPolyIds.push_back(nId);
+                else
+                    anLivePolyIds[nLive++] = nId;
             }
+            anLivePolyIds.resize(nLive);
+
+            // Emit in increasing id order.
+            std::sort(anCompletedPolyIds.begin(), anCompletedPolyIds.end());
+            eErr = EmitPolygonsToLayer( hOutLayer, iPixValField, papoPoly,
+                                        anCompletedPolyIds, adfGeoTransform,
+                                        poJobQueue.get(), nThreads );
         }
 
 /* -------------------------------------------------------------------- */
@@ -813,16 +935,17 @@ GDALPolygonizeT( GDALRasterBandH hSrcBand,
 /* -------------------------------------------------------------------- */
 /*      Make a cleanup pass for all unflushed polygons.                 */
 /* -------------------------------------------------------------------- */
-    for( int iX = 0; eErr == CE_None && iX < oSecondEnum.nNextPolygonId; iX++ )
+    std::sort(anLivePolyIds.begin(), anLivePolyIds.end());
+    if( eErr == CE_None )
     {
-        if( papoPoly[iX] )
-        {
-            eErr = EmitPolygonToLayer( hOutLayer, iPixValField,
-                                       papoPoly[iX], adfGeoTransform );
-
-            delete papoPoly[iX];
-            papoPoly[iX] = nullptr;
-        }
+        eErr = EmitPolygonsToLayer( hOutLayer, iPixValField, papoPoly,
+                                    anLivePolyIds, adfGeoTransform,
+                                    poJobQueue.get(), nThreads );
+    }
+    else
+    {
+        for( const int nId: anLivePolyIds )
+            delete papoPoly[nId];
     }
 
 /* -------------------------------------------------------------------- */
@@ -937,6 +1060,10 @@ GBool GDALFloatEquals( float A, float B )
  * <ul>
  * <li>8CONNECTED=8: May be set to "8" to use 8 connectedness.
  * Otherwise 4 connectedness will be applied to the algorithm</li>
+ * <li>NUM_THREADS=number_of_threads/ALL_CPUS: (GDAL >= 3.4) Number of
+ * threads used to build the polygon geometries. The features are still
+ * written by the calling thread, in the same order. Defaults to the value
+ * of the GDAL_NUM_THREADS configuration option, or 1.</li>
  * </ul>
  * @param pfnProgress callback for reporting algorithm progress matching the
  * GDALProgressFunc() semantics.  May be NULL.
@@ -1014,6 +1141,10 @@ GDALPolygonize( GDALRasterBandH hSrcBand,
  * <ul>
  * <li>8CONNECTED=8: May be set to "8" to use 8 connectedness.
  * Otherwise 4 connectedness will be applied to the algorithm</li>
+ * <li>NUM_THREADS=number_of_threads/ALL_CPUS: (GDAL >= 3.4) Number of
+ * threads used to build the polygon geometries. The features are still
+ * written by the calling thread, in the same order. Defaults to the value
+ * of the GDAL_NUM_THREADS configuration option, or 1.</li>
  * </ul>
  * @param pfnProgress callback for reporting algorithm progress matching the
  * GDALProgressFunc() semantics.  May be NULL.
@@ -35,15 +35,19 @@
 #include <cstring>
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
+#include "gdal_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -365,6 +369,160 @@ inline void QUAD_CHECK(double& dfQuadDist, float& fQuadValue,
     }
 }
 
+/************************************************************************/
+/*                        FillNodataInterpolate()                       */
+/*                                                                      */
+/*      Interpolate the nodata pixels of a range of lines of a chunk,   */
+/*      from the nearest valid pixel found in each quadrant. Each line  */
+/*      only depends on its own top down "last known value" and on the  */
+/*      bottom up one of the line below it, so lines are independent.   */
+/************************************************************************/
+
+namespace {
+struct FillNodataChunk
+{
+    int nXSize = 0;
+    double dfMaxSearchDist = 0.0;
+    int nMaxSearchDist = 0;
+    GUInt32 nNoDataVal = 0;
+    bool bHasNoData = false;
+    float fNoData = 0.0f;
+
+    // Line i of the chunk is at offset i * nXSize, the first line being
+    // the bottom one.
+    int iBottomY = 0;
+    GByte *pabyMask = nullptr;
+    GByte *pabyFiltMask = nullptr;
+    float *pafScanline = nullptr;
+    GUInt32 *panTopDownY = nullptr;
+    float *pafTopDownValue = nullptr;
+    // Bottom up "last known value", with one more leading line for the
+    // line below the chunk.
+    GUInt32 *panBottomUpY = nullptr;
+    float *pafBottomUpValue = nullptr;
+};
+
+struct FillNodataJob
+{
+    const FillNodataChunk *psChunk = nullptr;
+    int iStartLine = 0;
+    int iEndLine = 0;
+};
+}  // namespace
+
+static void FillNodataInterpolate( void *pData )
+{
+    const FillNodataJob *psJob = static_cast<FillNodataJob *>(pData);
+    const FillNodataChunk *psChunk = psJob->psChunk;
+    const int nXSize = psChunk->nXSize;
+    const double dfMaxSearchDist = psChunk->dfMaxSearchDist;
+    const int nMaxSearchDist = psChunk->nMaxSearchDist;
+    const GUInt32 nNoDataVal = psChunk->nNoDataVal;
+    const bool bHasNoData = psChunk->bHasNoData;
+    const float fNoData = psChunk->fNoData;
+
+    for( int iLine = psJob->iStartLine; iLine < psJob->iEndLine; iLine++ )
+    {
+        const int iY = psChunk->iBottomY - iLine;
+        const size_t nOffset = static_cast<size_t>(iLine) * nXSize;
+        GByte *pabyMask = psChunk->pabyMask + nOffset;
+        GByte *pabyFiltMask = psChunk->pabyFiltMask + nOffset;
+        float *pafScanline = psChunk->pafScanline + nOffset;
+        const GUInt32 *panTopDownY = psChunk->panTopDownY + nOffset;
+        const float *pafTopDownValue = psChunk->pafTopDownValue + nOffset;
+        // Bottom up values of the line below.
+        const GUInt32 *panLastY = psChunk->panBottomUpY + nOffset;
+        const float *pafLastValue = psChunk->pafBottomUpValue + nOffset;
+
+        memset( pabyFiltMask, 0, nXSize );
+        for( int iX = 0; iX < nXSize; iX++ )
+        {
+            int nThisMaxSearchDist = nMaxSearchDist;
+
+            // If this was a valid target - no change.
+            if( pabyMask[iX] )
+                continue;
+
+            // Quadrants 0:topleft, 1:bottomleft, 2:topright, 3:bottomright
+            double adfQuadDist[4] = {};
+            float fQuadValue[4] = {};
+
+            for( int iQuad = 0; iQuad < 4; iQuad++ )
+            {
+                adfQuadDist[iQuad] = dfMaxSearchDist + 1.0;
+                fQuadValue[iQuad] = 0.0;
+            }
+
+            // Step left and right by one pixel searching for the closest
+            // target value for each quadrant.
+            for( int iStep = 0; iStep <= nThisMaxSearchDist; iStep++ )
+            {
+                const int iLeftX = std::max(0, iX - iStep);
+                const int iRightX = std::min(nXSize - 1, iX + iStep);
+
+                // Top left includes current line.
+                QUAD_CHECK(adfQuadDist[0], fQuadValue[0],
+                           iLeftX, panTopDownY[iLeftX], iX, iY,
+                           pafTopDownValue[iLeftX], nNoDataVal );
+
+                // Bottom left.
+                QUAD_CHECK(adfQuadDist[1], fQuadValue[1],
+                           iLeftX, panLastY[iLeftX], iX, iY,
+                           pafLastValue[iLeftX], nNoDataVal );
+
+                // Top right and bottom right do no include center pixel.
+                if( iStep == 0 )
+                     continue;
+
+                // Top right includes current line.
+                QUAD_CHECK(adfQuadDist[2], fQuadValue[2],
+                           iRightX, panTopDownY[iRightX], iX, iY,
+                           pafTopDownValue[iRightX], nNoDataVal );
+
+                // Bottom right.
+                QUAD_CHECK(adfQuadDist[3], fQuadValue[3],
+                           iRightX, panLastY[iRightX], iX, iY,
+                           pafLastValue[iRightX], nNoDataVal );
+
+                // Every four steps, recompute maximum distance.
+                if( (iStep & 0x3) == 0 )
+                    nThisMaxSearchDist = static_cast<int>(floor(
+                        std::max(std::max(adfQuadDist[0], adfQuadDist[1]),
+                                 std::max(adfQuadDist[2], adfQuadDist[3]))));
+            }
+
+            double dfWeightSum = 0.0;
+            double dfValueSum = 0.0;
+            bool bHasSrcValues = false;
+
+            for( int iQuad = 0; iQuad < 4; iQuad++ )
+            {
+                if( adfQuadDist[iQuad] <= dfMaxSearchDist )
+                {
+                    const double dfWeight = 1.0 / adfQuadDist[iQuad];
+
+                    bHasSrcValues = dfWeight != 0;
+                    if( !bHasNoData || fQuadValue[iQuad] != fNoData )
+                    {
+                        dfWeightSum += dfWeight;
+                        dfValueSum += fQuadValue[iQuad] * dfWeight;
+                    }
+                }
+            }
+
+            if( bHasSrcValues )
+            {
+                pabyMask[iX] = 255;
+                pabyFiltMask[iX] = 255;
+                if( dfWeightSum > 0.0 )
+                    pafScanline[iX] = static_cast<float>(dfValueSum / dfWeightSum);
+                else
+                    pafScanline[iX] = fNoData;
+            }
+        }
+    }
+}
+
 /************************************************************************/
 /*                           GDALFillNodata()                           */
 /************************************************************************/
@@ -401,6 +559,10 @@ inline void QUAD_CHECK(double& dfQuadDist, float& fQuadValue,
  * <li>NODATA=value (starting with GDAL 2.4).
  * Source pixels at that value will be ignored by the interpolator. Warning:
  * currently this will not be honored by smoothing passes.</li>
+ * <li>NUM_THREADS=number_of_threads/ALL_CPUS (starting with GDAL 3.4).
+ * Number of threads used to interpolate chunks of lines. Defaults to the
+ * value of the GDAL_NUM_THREADS configuration option, or 1. The result does
+ * not depend on it.</li>
  * </ul>
  * @param pfnProgress the progress function to report completion.
  * @param pProgressArg callback data for progress function.
@@ -556,31 +718,76 @@ GDALFillNodata( GDALRasterBandH hTargetBand,
     GDALRasterBandH hFiltMaskBand = GDALGetRasterBand( hFiltMaskDS, 1 );
 
 /* -------------------------------------------------------------------- */
-/*      Allocate buffers for last scanline and this scanline.           */
+/*      How many lines are interpolated at once?  Lines are independent  */
+/*      once the "last known values" are collected, so chunks of lines  */
+/*      are interpolated concurrently when several threads are used.    */
+/* -------------------------------------------------------------------- */
+    const char *pszNumThreads = CSLFetchNameValue(papszOptions, "NUM_THREADS");
+    if( pszNumThreads == nullptr )
+        pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                       atoi(pszNumThreads);
+    if( nThreads > 128 )
+        nThreads = 128;
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    if( nThreads > 1 )
+    {
+        CPLWorkerThreadPool *poThreadPool = GDALGetGlobalThreadPool(nThreads);
+        if( poThreadPool )
+            poJobQueue = poThreadPool->CreateJobQueue();
+    }
+
+    int nChunkLines = 1;
+    if( poJobQueue )
+    {
+        // Bytes of the chunk buffers per pixel.
+        constexpr int knBytesPerPixel = 2 * sizeof(GByte) +
+            3 * sizeof(float) + 2 * sizeof(GUInt32);
+        constexpr GIntBig knMaxChunkBytes = 64 * 1024 * 1024;
+        const GIntBig nMaxLines =
+            knMaxChunkBytes / (static_cast<GIntBig>(nXSize) * knBytesPerPixel);
+        nChunkLines = static_cast<int>(std::max(
+            static_cast<GIntBig>(nThreads),
+            std::min(static_cast<GIntBig>(16 * nThreads), nMaxLines)));
+        nChunkLines = std::min(nChunkLines, nYSize);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Allocate buffers for last scanline and this scanline, and for   */
+/*      the chunk of lines being interpolated.                          */
 /* -------------------------------------------------------------------- */
 
     GUInt32 *panLastY =
         static_cast<GUInt32 *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(GUInt32)));
     GUInt32 *panThisY =
         static_cast<GUInt32 *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(GUInt32)));
-    GUInt32 *panTopDownY =
-        static_cast<GUInt32 *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(GUInt32)));
     float *pafLastValue =
         static_cast<float *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(float)));
     float *pafThisValue =
         static_cast<float *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(float)));
-    float *pafTopDownValue =
-        static_cast<float *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(float)));
-    float *pafScanline =
-        static_cast<float *>(VSI_CALLOC_VERBOSE(nXSize, sizeof(float)));
-    GByte *pabyMask = static_cast<GByte *>(VSI_CALLOC_VERBOSE(nXSize, 1));
-    GByte *pabyFiltMask = static_cast<GByte *>(VSI_CALLOC_VERBOSE(nXSize, 1));
+    GUInt32 *panTopDownY = static_cast<GUInt32 *>(
+        VSI_MALLOC3_VERBOSE(nXSize, nChunkLines, sizeof(GUInt32)));
+    float *pafTopDownValue = static_cast<float *>(
+        VSI_MALLOC3_VERBOSE(nXSize, nChunkLines, sizeof(float)));
+    GUInt32 *panBottomUpY = static_cast<GUInt32 *>(
+        VSI_MALLOC3_VERBOSE(nXSize, nChunkLines + 1, sizeof(GUInt32)));
+    float *pafBottomUpValue = static_cast<float *>(
+        VSI_MALLOC3_VERBOSE(nXSize, nChunkLines + 1, sizeof(float)));
+    float *pafScanline = static_cast<float *>(
+        VSI_MALLOC3_VERBOSE(nXSize, nChunkLines, sizeof(float)));
+    GByte *pabyMask = static_cast<GByte *>(
+        VSI_MALLOC2_VERBOSE(nXSize, nChunkLines));
+    GByte *pabyFiltMask = static_cast<GByte *>(
+        VSI_MALLOC2_VERBOSE(nXSize, nChunkLines));
 
     CPLErr eErr = CE_None;
+    FillNodataChunk sChunk;
+    std::vector<FillNodataJob> asJobs;
 
     if( panLastY == nullptr || panThisY == nullptr || panTopDownY == nullptr ||
         pafLastValue == nullptr || pafThisValue == nullptr ||
         pafTopDownValue == nullptr ||
+        panBottomUpY == nullptr || pafBottomUpValue == nullptr ||
         pafScanline == nullptr || pabyMask == nullptr || pabyFiltMask == nullptr )
     {
         eErr = CE_Failure;
@@ -671,67 +878,99 @@ GDALFillNodata( GDALRasterBandH hTargetBand,
         }
     }
 
+    // The line below the bottom line has no known value.
     for( int iX = 0; iX < nXSize; iX++ )
     {
-        panLastY[iX] = nNoDataVal;
+        panBottomUpY[iX] = nNoDataVal;
     }
 
+    sChunk.nXSize = nXSize;
+    sChunk.dfMaxSearchDist = dfMaxSearchDist;
+    sChunk.nMaxSearchDist = nMaxSearchDist;
+    sChunk.nNoDataVal = nNoDataVal;
+    sChunk.bHasNoData = bHasNoData;
+    sChunk.fNoData = fNoData;
+    sChunk.pabyMask = pabyMask;
+    sChunk.pabyFiltMask = pabyFiltMask;
+    sChunk.pafScanline = pafScanline;
+    sChunk.panTopDownY = panTopDownY;
+    sChunk.pafTopDownValue = pafTopDownValue;
+    sChunk.panBottomUpY = panBottomUpY;
+    sChunk.pafBottomUpValue = pafBottomUpValue;
+
 /* ==================================================================== */
 /*      Now we will do collect similar this/last information from       */
 /*      bottom to top and use it in combination with the top to         */
 /*      bottom search info to interpolate.                              */
 /* ==================================================================== */
-    for( int iY = nYSize-1; iY >= 0 && eErr == CE_None; iY-- )
+    for( int iBottomY = nYSize-1; iBottomY >= 0 && eErr == CE_None;
+         iBottomY -= nChunkLines )
     {
-        eErr =
-            GDALRasterIO( hMaskBand, GF_Read, 0, iY, nXSize, 1,
-                          pabyMask, nXSize, 1, GDT_Byte, 0, 0 );
+        const int nLines = std::min(nChunkLines, iBottomY + 1);
 
-        if( eErr != CE_None )
-            break;
+        for( int iLine = 0; iLine < nLines && eErr == CE_None; iLine++ )
+        {
+            const int iY = iBottomY - iLine;
+            const size_t nOffset = static_cast<size_t>(iLine) * nXSize;
+            GByte *pabyMaskLine = pabyMask + nOffset;
+            float *pafScanlineLine = pafScanline + nOffset;
 
-        eErr =
-            GDALRasterIO( hTargetBand, GF_Read, 0, iY, nXSize, 1,
-                          pafScanline, nXSize, 1, GDT_Float32, 0, 0 );
+            eErr =
+                GDALRasterIO( hMaskBand, GF_Read, 0, iY, nXSize, 1,
+                              pabyMaskLine, nXSize, 1, GDT_Byte, 0, 0 );
 
-        if( eErr != CE_None )
-            break;
+            if( eErr != CE_None )
+                break;
+
+            eErr =
+                GDALRasterIO( hTargetBand, GF_Read, 0, iY, nXSize, 1,
+                              pafScanlineLine, nXSize, 1, GDT_Float32, 0, 0 );
+
+            if( eErr != CE_None )
+                break;
 
 /* -------------------------------------------------------------------- */
 /*      Figure out the most recent pixel for each column.               */
 /* -------------------------------------------------------------------- */
+            const GUInt32 *panBelowY = panBottomUpY + nOffset;
+            const float *pafBelowValue = pafBottomUpValue + nOffset;
+            GUInt32 *panLineY = panBottomUpY + nOffset + nXSize;
+            float *pafLineValue = pafBottomUpValue + nOffset + nXSize;
 
-        for( int iX = 0; iX < nXSize; iX++ )
-        {
-            if( pabyMask[iX] )
-            {
-                pafThisValue[iX] = pafScanline[iX];
-                panThisY[iX] = iY;
-            }
-            else if( panLastY[iX] - iY <= dfMaxSearchDist )
+            for( int iX = 0; iX < nXSize; iX++ )
             {
-                pafThisValue[iX] = pafLastValue[iX];
-                panThisY[iX] = panLastY[iX];
-            }
-            else
-            {
-                panThisY[iX] = nNoDataVal;
+                if( pabyMaskLine[iX] )
+                {
+                    pafLineValue[iX] = pafScanlineLine[iX];
+                    panLineY[iX] = iY;
+                }
+                else if( panBelowY[iX] - iY <= dfMaxSearchDist )
+                {
+                    pafLineValue[iX] = pafBelowValue[iX];
+                    panLineY[iX] = panBelowY[iX];
+                }
+                else
+                {
+                    panLineY[iX] = nNoDataVal;
+                }
             }
-        }
 
 /* -------------------------------------------------------------------- */
 /*      Load the last y and corresponding value from the top down pass. */
 /* -------------------------------------------------------------------- */
-        eErr =
-            GDALRasterIO( hYBand, GF_Read, 0, iY, nXSize, 1,
-                          panTopDownY, nXSize, 1, GDT_UInt32, 0, 0 );
+            eErr =
+                GDALRasterIO( hYBand, GF_Read, 0, iY, nXSize, 1,
+                              panTopDownY + nOffset, nXSize, 1,
+                              GDT_UInt32, 0, 0 );
 
-        if( eErr != CE_None )
-            break;
+            if( eErr != CE_None )
+                break;
 
-        eErr =
-            GDALRasterIO( hValBand, GF_Read, 0, iY, nXSize, 1,
-                          pafTopDownValue, nXSize, 1, GDT_Float32, 0, 0 );
+            eErr =
+                GDALRasterIO( hValBand, GF_Read, 0, iY, nXSize, 1,
+                              pafTopDownValue + nOffset, nXSize, 1,
+                              GDT_Float32, 0, 0 );
+        }
 
         if( eErr != CE_None )
             break;
@@ -739,127 +978,72 @@ GDALFillNodata( GDALRasterBandH hTargetBand,
 /* -------------------------------------------------------------------- */
 /*      Attempt to interpolate any pixels that are nodata.              */
 /* -------------------------------------------------------------------- */
-        memset( pabyFiltMask, 0, nXSize );
-        for( int iX = 0; iX < nXSize; iX++ )
+        sChunk.iBottomY = iBottomY;
+        const int nJobs = poJobQueue ? std::min(nThreads, nLines) : 1;
+        asJobs.resize(nJobs);
+        for( int iJob = 0; iJob < nJobs; iJob++ )
         {
-            int nThisMaxSearchDist = nMaxSearchDist;
-
-            // If this was a valid target - no change.
-            if( pabyMask[iX] )
-                continue;
-
-            // Quadrants 0:topleft, 1:bottomleft, 2:topright, 3:bottomright
-            double adfQuadDist[4] = {};
-            float fQuadValue[4] = {};
-
-            for( int iQuad = 0; iQuad < 4; iQuad++ )
-            {
-                adfQuadDist[iQuad] = dfMaxSearchDist + 1.0;
-                fQuadValue[iQuad] = 0.0;
-            }
-
-            // Step left and right by one pixel searching for the closest
-            // target value for each quadrant.
-            for( int iStep = 0; iStep <= nThisMaxSearchDist; iStep++ )
-            {
-                const int iLeftX = std::max(0, iX - iStep);
-                const int iRightX = std::min(nXSize - 1, iX + iStep);
-
-                // Top left includes current line.
-                QUAD_CHECK(adfQuadDist[0], fQuadValue[0],
-                           iLeftX, panTopDownY[iLeftX], iX, iY,
-                           pafTopDownValue[iLeftX], nNoDataVal );
-
-                // Bottom left.
-                QUAD_CHECK(adfQuadDist[1], fQuadValue[1],
-                           iLeftX, panLastY[iLeftX], iX, iY,
-                           pafLastValue[iLeftX], nNoDataVal );
-
-                // Top right and bottom right do no include center pixel.
-                if( iStep == 0 )
-                     continue;
-
-                // Top right includes current line.
-                QUAD_CHECK(adfQuadDist[2], fQuadValue[2],
-                           iRightX, panTopDownY[iRightX], iX, iY,
-                           pafTopDownValue[iRightX], nNoDataVal );
-
-                // Bottom right.
-                QUAD_CHECK(adfQuadDist[3], fQuadValue[3],
-                           iRightX, panLastY[iRightX], iX, iY,
-                           pafLastValue[iRightX], nNoDataVal );
-
-                // Every four steps, recompute maximum distance.
-                if( (iStep & 0x3) == 0 )
-                    nThisMaxSearchDist = static_cast<int>(floor(
-                        std::max(std::max(adfQuadDist[0], adfQuadDist[1]),
-                                 std::max(adfQuadDist[2], adfQuadDist[3]))));
-            }
-
-            double dfWeightSum = 0.0;
-            double dfValueSum = 0.0;
-            bool bHasSrcValues = false;
-
-            for( int iQuad = 0; iQuad < 4; iQuad++ )
-            {
-                if( adfQuadDist[iQuad] <= dfMaxSearchDist )
-                {
-                    const double dfWeight = 1.0 / adfQuadDist[iQuad];
-
-                    bHasSrcValues = dfWeight != 0;
-                    if( !bHasNoData || fQuadValue[iQuad] != fNoData )
-                    {
-                        dfWeightSum += dfWeight;
-                        dfValueSum += fQuadValue[iQuad] * dfWeight;
-                    }
-                }
-            }
-
-            if( bHasSrcValues )
-            {
-                pabyMask[iX] = 255;
-                pabyFiltMask[iX] = 255;
-                if( dfWeightSum > 0.0 )
-                    pafScanline[iX] = static_cast<float>(dfValueSum / dfWeightSum);
-                else
-                    pafScanline[iX] = fNoData;
-            }
+            asJobs[iJob].psChunk = &sChunk;
+            asJobs[iJob].iStartLine = nLines * iJob / nJobs;
+            asJobs[iJob].iEndLine = nLines * (iJob + 1) / nJobs;
+        }
+        if( nJobs == 1 )
+        {
+            FillNodataInterpolate(&asJobs[0]);
+        }
+        else
+        {
+            for( auto& sJob: asJobs )
+                poJobQueue->SubmitJob(FillNodataInterpolate, &sJob);
+            poJobQueue->WaitCompletion();
         }
 
+        for( int iLine = 0; iLine < nLines && eErr == CE_None; iLine++ )
+        {
+            const int iY = iBottomY - iLine;
+            const size_t nOffset = static_cast<size_t>(iLine) * nXSize;
+
 /* -------------------------------------------------------------------- */
 /*      Write out the updated data and mask information.                */
 /* -------------------------------------------------------------------- */
-        eErr =
-            GDALRasterIO( hTargetBand, GF_Write, 0, iY, nXSize, 1,
-                          pafScanline, nXSize, 1, GDT_Float32, 0, 0 );
+            eErr =
+                GDALRasterIO( hTargetBand, GF_Write, 0, iY, nXSize, 1,
+                              pafScanline + nOffset, nXSize, 1,
+                              GDT_Float32, 0, 0 );
 
-        if( eErr != CE_None )
-            break;
+            if( eErr != CE_None )
+                break;
 
-        eErr =
-            GDALRasterIO( hFiltMaskBand, GF_Write, 0, iY, nXSize, 1,
-                          pabyFiltMask, nXSize, 1, GDT_Byte, 0, 0 );
+            eErr =
+                GDALRasterIO( hFiltMaskBand, GF_Write, 0, iY, nXSize, 1,
+                              pabyFiltMask + nOffset, nXSize, 1,
+                              GDT_Byte, 0, 0 );
 
-        if( eErr != CE_None )
-            break;
+            if( eErr != CE_None )
+                break;
 
 /* -------------------------------------------------------------------- */
-/*      Flip this/last buffers.                                         */
+/*      report progress.                                                */
 /* -------------------------------------------------------------------- */
-        std::swap(pafThisValue, pafLastValue);
-        std::swap(panThisY, panLastY);
+            if( !pfnProgress(
+                    dfProgressRatio*(0.5+0.5*(nYSize-iY) /
+                                     static_cast<double>(nYSize)),
+                    "Filling...", pProgressArg) )
+            {
+                CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+                eErr = CE_Failure;
+            }
+        }
 
 /* -------------------------------------------------------------------- */
-/*      report progress.                                                */
+/*      The top line of this chunk is the line below the next one.      */
 /* -------------------------------------------------------------------- */
-        if( !pfnProgress(
-                dfProgressRatio*(0.5+0.5*(nYSize-iY) /
-                                 static_cast<double>(nYSize)),
-                "Filling...", pProgressArg) )
-        {
-            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-            eErr = CE_Failure;
-        }
+        memcpy( panBottomUpY,
+                panBottomUpY + static_cast<size_t>(nLines) * nXSize,
+                sizeof(GUInt32) * nXSize );
+        memcpy( pafBottomUpValue,
+                pafBottomUpValue + static_cast<size_t>(nLines) * nXSize,
+                sizeof(float) * nXSize );
     }
 
 /* ==================================================================== */
@@ -889,9 +1073,11 @@ end:
     CPLFree(panLastY);
     CPLFree(panThisY);
     CPLFree(panTopDownY);
+    CPLFree(panBottomUpY);
     CPLFree(pafLastValue);
     CPLFree(pafThisValue);
     CPLFree(pafTopDownValue);
+    CPLFree(pafBottomUpValue);
     CPLFree(pafScanline);
     CPLFree(pabyMask);
     CPLFree(pabyFiltMask);
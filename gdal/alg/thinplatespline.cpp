@@ -43,9 +43,11 @@
 #include <algorithm>
 #include <limits>
 #include <utility>
+#include <vector>
 
 #include "cpl_error.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -430,8 +432,49 @@ static void VizGeorefSpline2DBase_func4( double* res,
 }
 #endif // defined(USE_OPTIMIZED_VizGeorefSpline2DBase_func4)
 
+/************************************************************************/
+/*                           TPSRunParallel()                           */
+/*                                                                      */
+/*      Runs pfnFunc(i) for i in [0, nThreads[, on a temporary worker   */
+/*      thread pool when nThreads > 1.                                  */
+/************************************************************************/
+
+template<class F> static void TPSRunParallel( int nThreads, const F& pfnFunc )
+{
+    CPLWorkerThreadPool oPool;
+    if( nThreads <= 1 || !oPool.Setup(nThreads, nullptr, nullptr) )
+    {
+        for( int i = 0; i < std::max(1, nThreads); i++ )
+            pfnFunc(i);
+        return;
+    }
+
+    struct Job
+    {
+        const F* pfnFunc;
+        int i;
+    };
+    std::vector<Job> asJobs(nThreads);
+    std::vector<void*> apJobs(nThreads);
+    for( int i = 0; i < nThreads; i++ )
+    {
+        asJobs[i].pfnFunc = &pfnFunc;
+        asJobs[i].i = i;
+        apJobs[i] = &asJobs[i];
+    }
+    oPool.SubmitJobs([](void* pData)
+        {
+            const Job* psJob = static_cast<const Job*>(pData);
+            (*psJob->pfnFunc)(psJob->i);
+        }, apJobs);
+    oPool.WaitCompletion();
+}
+
 int VizGeorefSpline2D::solve()
 {
+    CPLFree(_grid);
+    _grid = nullptr;
+
     // No points at all.
     if( _nof_points < 1 )
     {
@@ -580,13 +623,21 @@ int VizGeorefSpline2D::solve()
         A(c+3, 2) = y[c];
     }
 
-    for( int r = 0; r < _nof_points; r++ )
-        for( int c = r; c < _nof_points; c++ )
-        {
-            A(r+3, c+3) = VizGeorefSpline2DBase_func( x[r], y[r], x[c], y[c] );
-            if( r != c )
-                A(c+3, r+3) = A(r+3, c+3);
-        }
+    // Each row r only writes the elements (r, c>=r) and their symmetric,
+    // so rows can be dispatched to different threads. Rows are interleaved
+    // to balance the triangular workload.
+    const int nThreads = _nof_points >= 1000 ? _nof_threads : 1;
+    const auto FillRows = [this, &A, nThreads](int iFirstRow)
+    {
+        for( int r = iFirstRow; r < _nof_points; r += nThreads )
+            for( int c = r; c < _nof_points; c++ )
+            {
+                A(r+3, c+3) = VizGeorefSpline2DBase_func( x[r], y[r], x[c], y[c] );
+                if( r != c )
+                    A(c+3, r+3) = A(r+3, c+3);
+            }
+    };
+    TPSRunParallel(nThreads, FillRows);
 
 #if VIZ_GEOREF_SPLINE_DEBUG
 
@@ -606,7 +657,7 @@ int VizGeorefSpline2D::solve()
 
     GDALMatrix Coef(_nof_eqs, _nof_vars);
 
-    if( !GDALLinearSystemSolve(A, RHS, Coef ) )
+    if( !GDALLinearSystemSolve(A, RHS, Coef, nThreads ) )
     {
         return 0;
     }
@@ -615,9 +666,89 @@ int VizGeorefSpline2D::solve()
         for( int iRow = 0; iRow < _nof_eqs; iRow++ )
             coef[iRHS][iRow] = Coef(iRow, iRHS);
 
+    if( _approx_grid_size > 0 &&
+        !build_approx_grid(xmin - x_mean, ymin - y_mean,
+                           xmax - x_mean, ymax - y_mean) )
+    {
+        return 0;
+    }
+
     return 4;
 }
 
+/************************************************************************/
+/*                          add_radial_terms()                          */
+/*                                                                      */
+/*      Adds the contribution of all control points to vars[], for a    */
+/*      location already expressed relative to (x_mean, y_mean).        */
+/************************************************************************/
+
+void VizGeorefSpline2D::add_radial_terms( const double Pxy[2],
+                                          double *vars ) const
+{
+    int r = 0;  // Used after for.
+    for( ; r < (_nof_points & (~3)); r+=4 )
+    {
+        double dfTmp[4] = {};
+        VizGeorefSpline2DBase_func4( dfTmp, Pxy, &x[r], &y[r] );
+        for( int v = 0; v < _nof_vars; v++ )
+            vars[v] += coef[v][r+3] * dfTmp[0] +
+                    coef[v][r+3+1] * dfTmp[1] +
+                    coef[v][r+3+2] * dfTmp[2] +
+                    coef[v][r+3+3] * dfTmp[3];
+    }
+    for( ; r < _nof_points; r++ )
+    {
+        const double tmp = VizGeorefSpline2DBase_func( Pxy[0], Pxy[1], x[r], y[r] );
+        for( int v= 0; v < _nof_vars; v++ )
+            vars[v] += coef[v][r+3] * tmp;
+    }
+}
+
+/************************************************************************/
+/*                         build_approx_grid()                          */
+/*                                                                      */
+/*      Tabulates the radial (non-affine) part of the spline at the     */
+/*      nodes of a regular grid covering the control points. That part  */
+/*      is smooth, so bilinear interpolation of it, added to the exact   */
+/*      affine part, gives a close approximation of the spline at a     */
+/*      cost independent of the number of control points.              */
+/************************************************************************/
+
+bool VizGeorefSpline2D::build_approx_grid( double xmin, double ymin,
+                                           double xmax, double ymax )
+{
+    const int nNodes = _approx_grid_size + 1;
+    _grid = static_cast<double *>(
+        VSI_MALLOC3_VERBOSE(nNodes, nNodes, sizeof(double) * _nof_vars));
+    if( _grid == nullptr )
+        return false;
+    _grid_x0 = xmin;
+    _grid_y0 = ymin;
+    _grid_dx = (xmax - xmin) / _approx_grid_size;
+    _grid_dy = (ymax - ymin) / _approx_grid_size;
+
+    const int nThreads = std::min(_nof_threads, nNodes);
+    const auto FillGridRows = [this, nNodes, nThreads](int iFirstRow)
+    {
+        for( int iY = iFirstRow; iY < nNodes; iY += nThreads )
+        {
+            for( int iX = 0; iX < nNodes; iX++ )
+            {
+                const double Pxy[2] = { _grid_x0 + iX * _grid_dx,
+                                        _grid_y0 + iY * _grid_dy };
+                double *vars =
+                    _grid + (static_cast<size_t>(iY) * nNodes + iX) * _nof_vars;
+                for( int v = 0; v < _nof_vars; v++ )
+                    vars[v] = 0.0;
+                add_radial_terms(Pxy, vars);
+            }
+        }
+    };
+    TPSRunParallel(nThreads, FillGridRows);
+    return true;
+}
+
 int VizGeorefSpline2D::get_point( const double Px, const double Py,
                                   double *vars )
 {
@@ -680,23 +811,35 @@ int VizGeorefSpline2D::get_point( const double Px, const double Py,
         for( int v = 0; v < _nof_vars; v++ )
             vars[v] = coef[v][0] + coef[v][1] * Pxy[0] + coef[v][2] * Pxy[1];
 
-        int r = 0;  // Used after for.
-        for( ; r < (_nof_points & (~3)); r+=4 )
-        {
-            double dfTmp[4] = {};
-            VizGeorefSpline2DBase_func4( dfTmp, Pxy, &x[r], &y[r] );
-            for( int v = 0; v < _nof_vars; v++ )
-                vars[v] += coef[v][r+3] * dfTmp[0] +
-                        coef[v][r+3+1] * dfTmp[1] +
-                        coef[v][r+3+2] * dfTmp[2] +
-                        coef[v][r+3+3] * dfTmp[3];
-        }
-        for( ; r < _nof_points; r++ )
+        if( _grid )
         {
-            const double tmp = VizGeorefSpline2DBase_func( Pxy[0], Pxy[1], x[r], y[r] );
-            for( int v= 0; v < _nof_vars; v++ )
-                vars[v] += coef[v][r+3] * tmp;
+            const double dfGX = (Pxy[0] - _grid_x0) / _grid_dx;
+            const double dfGY = (Pxy[1] - _grid_y0) / _grid_dy;
+            if( dfGX >= 0 && dfGX <= _approx_grid_size &&
+                dfGY >= 0 && dfGY <= _approx_grid_size )
+            {
+                const int iX = std::min(static_cast<int>(dfGX),
+                                        _approx_grid_size - 1);
+                const int iY = std::min(static_cast<int>(dfGY),
+                                        _approx_grid_size - 1);
+                const double dfFX = dfGX - iX;
+                const double dfFY = dfGY - iY;
+                const size_t nNodes = _approx_grid_size + 1;
+                const double *p00 =
+                    _grid + (iY * nNodes + iX) * _nof_vars;
+                const double *p10 = p00 + _nof_vars;
+                const double *p01 = p00 + nNodes * _nof_vars;
+                const double *p11 = p01 + _nof_vars;
+                for( int v = 0; v < _nof_vars; v++ )
+                {
+                    vars[v] += (1 - dfFY) * ((1 - dfFX) * p00[v] + dfFX * p10[v]) +
+                               dfFY * ((1 - dfFX) * p01[v] + dfFX * p11[v]);
+                }
+                break;
+            }
         }
+
+        add_radial_terms(Pxy, vars);
         break;
     }
     case VIZ_GEOREF_SPLINE_POINT_WAS_ADDED:
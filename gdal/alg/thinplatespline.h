@@ -78,7 +78,14 @@ class VizGeorefSpline2D
         unused(nullptr),
         index(nullptr),
         x_mean(0),
-        y_mean(0)
+        y_mean(0),
+        _nof_threads(1),
+        _approx_grid_size(0),
+        _grid_x0(0.0),
+        _grid_y0(0.0),
+        _grid_dx(0.0),
+        _grid_dy(0.0),
+        _grid(nullptr)
     {
         for( int i = 0; i < VIZGEOREF_MAX_VARS; i++ )
         {
@@ -95,6 +102,7 @@ class VizGeorefSpline2D
         CPLFree( u );
         CPLFree( unused );
         CPLFree( index );
+        CPLFree( _grid );
         for( int i = 0; i < _nof_vars; i++ )
         {
             CPLFree( rhs[i] );
@@ -160,8 +168,24 @@ class VizGeorefSpline2D
 #endif
     int solve(void);
 
+    // Number of threads that solve() may use to build and factorize the
+    // system, and to compute the approximation grid.
+    void set_num_threads( int nThreads )
+        { _nof_threads = nThreads > 1 ? nThreads : 1; }
+
+    // When > 0, solve() tabulates the non-affine part of the spline on a
+    // regular grid of nSize x nSize cells covering the control points, and
+    // get_point() interpolates bilinearly in that grid instead of summing
+    // the contribution of every control point.
+    void set_approx_grid_size( int nSize )
+        { _approx_grid_size = nSize > 0 ? nSize : 0; }
+
   private:
 
+    void add_radial_terms( const double Pxy[2], double *vars ) const;
+    bool build_approx_grid( double xmin, double ymin,
+                            double xmax, double ymax );
+
     vizGeorefInterType type;
 
     const int _nof_vars;
@@ -191,6 +215,12 @@ class VizGeorefSpline2D
 
     double x_mean;
     double y_mean;
+
+    int _nof_threads;
+    int _approx_grid_size;
+    double _grid_x0, _grid_y0;
+    double _grid_dx, _grid_dy;
+    double *_grid; // [(_approx_grid_size+1)^2 * _nof_vars]
   private:
     CPL_DISALLOW_COPY_ASSIGN(VizGeorefSpline2D)
 };
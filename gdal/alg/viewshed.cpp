@@ -38,9 +38,11 @@
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_priv.h"
 #include "gdal_priv_templates.hpp"
+#include "gdal_thread_pool.h"
 #include "ogr_api.h"
 #include "ogr_spatialref.h"
 #include "ogr_core.h"
@@ -114,6 +116,358 @@ inline static double CalcHeight(double dfZ, double dfZ2, GDALViewshedMode eMode)
 }
 
 
+/************************************************************************/
+/*                         ViewshedLineContext                          */
+/************************************************************************/
+
+namespace {
+// Parameters of the scan of the lines of the processed window around one
+// observer.
+struct ViewshedLineContext
+{
+    const double *padfGeoTransform = nullptr;
+    // Observer column, relative to the window.
+    int nX = 0;
+    int nXSize = 0;
+    double dfZObserver = 0.0;
+    double dfTargetHeight = 0.0;
+    double dfDistance2 = 0.0;
+    double dfCurvCoeff = 0.0;
+    double dfSphereDiameter = 0.0;
+    GDALViewshedMode eMode = GVM_Edge;
+    GDALViewshedOutputType heightMode = GVOT_NORMAL;
+    GByte byVisibleVal = 255;
+    GByte byInvisibleVal = 0;
+    GByte byOutOfRangeVal = 0;
+    double dfOutOfRangeVal = 0.0;
+};
+}  // namespace
+
+/************************************************************************/
+/*                      ViewshedProcessFirstLine()                      */
+/*                                                                      */
+/*      Process the line of the observer. The DEM values of the line    */
+/*      are updated to be used as the last line of the next ones.       */
+/************************************************************************/
+
+static void ViewshedProcessFirstLine(const ViewshedLineContext& sCtx,
+                                     double *padfFirstLineVal,
+                                     std::vector<GByte>& vResult,
+                                     double *dfHeightResult)
+{
+    const double *padfGeoTransform = sCtx.padfGeoTransform;
+    const int nX = sCtx.nX;
+    const int nXSize = sCtx.nXSize;
+    const double dfZObserver = sCtx.dfZObserver;
+    const double dfTargetHeight = sCtx.dfTargetHeight;
+    const double dfDistance2 = sCtx.dfDistance2;
+    const double dfCurvCoeff = sCtx.dfCurvCoeff;
+    const double dfSphereDiameter = sCtx.dfSphereDiameter;
+    const GDALViewshedOutputType heightMode = sCtx.heightMode;
+    const GByte byVisibleVal = sCtx.byVisibleVal;
+    const GByte byInvisibleVal = sCtx.byInvisibleVal;
+    const GByte byOutOfRangeVal = sCtx.byOutOfRangeVal;
+    const double dfOutOfRangeVal = sCtx.dfOutOfRangeVal;
+    GByte *pabyResult = vResult.data();
+    double dfZ = 0.0;
+
+    /* mark the observer point as visible */
+    double dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfFirstLineVal[nX] : 0.0;
+    pabyResult[nX] = byVisibleVal;
+    if(heightMode != GVOT_NORMAL)
+        dfHeightResult[nX] = dfGroundLevel;
+
+    if (nX > 0)
+    {
+        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfFirstLineVal[nX - 1] : 0.0;
+        CPL_IGNORE_RET_VAL(
+            AdjustHeightInRange(padfGeoTransform,
+                            1,
+                            0,
+                            padfFirstLineVal[nX - 1],
+                            dfDistance2,
+                            dfCurvCoeff,
+                            dfSphereDiameter));
+        pabyResult[nX - 1] = byVisibleVal;
+        if(heightMode != GVOT_NORMAL)
+            dfHeightResult[nX - 1] = dfGroundLevel;
+    }
+    if (nX < nXSize - 1)
+    {
+        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfFirstLineVal[nX + 1] : 0.0;
+        CPL_IGNORE_RET_VAL(
+            AdjustHeightInRange(padfGeoTransform,
+                            1,
+                            0,
+                            padfFirstLineVal[nX + 1],
+                            dfDistance2,
+                            dfCurvCoeff,
+                            dfSphereDiameter));
+        pabyResult[nX + 1] = byVisibleVal;
+        if(heightMode != GVOT_NORMAL)
+            dfHeightResult[nX + 1] = dfGroundLevel;
+    }
+
+    /* process left direction */
+    for (int iPixel = nX - 2; iPixel >= 0; iPixel--)
+    {
+        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfFirstLineVal[iPixel] : 0.0;
+        bool adjusted = AdjustHeightInRange(padfGeoTransform,
+                                            nX - iPixel,
+                                            0,
+                                            padfFirstLineVal[iPixel],
+                                            dfDistance2,
+                                            dfCurvCoeff,
+                                            dfSphereDiameter);
+        if (adjusted)
+        {
+            dfZ = CalcHeightLine(nX - iPixel,
+                                 padfFirstLineVal[iPixel + 1],
+                                 dfZObserver);
+
+            if(heightMode != GVOT_NORMAL)
+                dfHeightResult[iPixel] = std::max(0.0, (dfZ - padfFirstLineVal[iPixel] + dfGroundLevel));
+
+            SetVisibility(  iPixel,
+                            dfZ,
+                            dfTargetHeight,
+                            padfFirstLineVal,
+                            vResult,
+                            byVisibleVal,
+                            byInvisibleVal);
+        }
+        else
+        {
+            for (; iPixel >= 0; iPixel--)
+            {
+                pabyResult[iPixel] = byOutOfRangeVal;
+                if(heightMode != GVOT_NORMAL)
+                    dfHeightResult[iPixel] = dfOutOfRangeVal;
+            }
+        }
+    }
+    /* process right direction */
+    for (int iPixel = nX + 2; iPixel < nXSize; iPixel++)
+    {
+        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfFirstLineVal[iPixel] : 0.0;
+        bool adjusted = AdjustHeightInRange(padfGeoTransform,
+                                            iPixel - nX,
+                                            0,
+                                            padfFirstLineVal[iPixel],
+                                            dfDistance2,
+                                            dfCurvCoeff,
+                                            dfSphereDiameter);
+        if (adjusted)
+        {
+            dfZ = CalcHeightLine(iPixel - nX,
+                                 padfFirstLineVal[iPixel - 1],
+                                 dfZObserver);
+
+            if(heightMode != GVOT_NORMAL)
+                dfHeightResult[iPixel] = std::max(0.0, (dfZ - padfFirstLineVal[iPixel] + dfGroundLevel));
+
+            SetVisibility(iPixel,
+                          dfZ,
+                          dfTargetHeight,
+                          padfFirstLineVal,
+                          vResult,
+                          byVisibleVal,
+                          byInvisibleVal);
+        }
+        else
+        {
+            for (; iPixel < nXSize; iPixel++)
+            {
+                pabyResult[iPixel] = byOutOfRangeVal;
+                if(heightMode != GVOT_NORMAL)
+                    dfHeightResult[iPixel] = dfOutOfRangeVal;
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                        ViewshedProcessLine()                         */
+/*                                                                      */
+/*      Process a line at nDY lines from the observer, given the        */
+/*      updated DEM values of the previous processed line, closer to    */
+/*      the observer.                                                   */
+/************************************************************************/
+
+static void ViewshedProcessLine(const ViewshedLineContext& sCtx, int nDY,
+                                const double *padfLastLineVal,
+                                double *padfThisLineVal,
+                                std::vector<GByte>& vResult,
+                                double *dfHeightResult)
+{
+    const double *padfGeoTransform = sCtx.padfGeoTransform;
+    const int nX = sCtx.nX;
+    const int nXSize = sCtx.nXSize;
+    const double dfZObserver = sCtx.dfZObserver;
+    const double dfTargetHeight = sCtx.dfTargetHeight;
+    const double dfDistance2 = sCtx.dfDistance2;
+    const double dfCurvCoeff = sCtx.dfCurvCoeff;
+    const double dfSphereDiameter = sCtx.dfSphereDiameter;
+    const GDALViewshedMode eMode = sCtx.eMode;
+    const GDALViewshedOutputType heightMode = sCtx.heightMode;
+    const GByte byVisibleVal = sCtx.byVisibleVal;
+    const GByte byInvisibleVal = sCtx.byInvisibleVal;
+    const GByte byOutOfRangeVal = sCtx.byOutOfRangeVal;
+    const double dfOutOfRangeVal = sCtx.dfOutOfRangeVal;
+    GByte *pabyResult = vResult.data();
+    double dfZ = 0.0;
+    double dfGroundLevel = 0.0;
+
+    /* set up initial point on the scanline */
+    dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfThisLineVal[nX] : 0.0;
+    bool adjusted = AdjustHeightInRange(padfGeoTransform,
+                                        0,
+                                        nDY,
+                                        padfThisLineVal[nX],
+                                        dfDistance2,
+                                        dfCurvCoeff,
+                                        dfSphereDiameter);
+    if (adjusted)
+    {
+        dfZ = CalcHeightLine(nDY,
+                             padfLastLineVal[nX],
+                             dfZObserver);
+
+        if(heightMode != GVOT_NORMAL)
+            dfHeightResult[nX] = std::max(0.0, (dfZ - padfThisLineVal[nX] + dfGroundLevel));
+
+        SetVisibility(nX,
+                      dfZ,
+                      dfTargetHeight,
+                      padfThisLineVal,
+                      vResult,
+                      byVisibleVal,
+                      byInvisibleVal);
+    }
+    else
+    {
+        pabyResult[nX] = byOutOfRangeVal;
+        if(heightMode != GVOT_NORMAL)
+            dfHeightResult[nX] = dfOutOfRangeVal;
+    }
+
+    /* process left direction */
+    for (int iPixel = nX - 1; iPixel >= 0; iPixel--)
+    {
+        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfThisLineVal[iPixel] : 0.0;
+        bool left_adjusted = AdjustHeightInRange(padfGeoTransform,
+                                                 nX - iPixel,
+                                                 nDY,
+                                                 padfThisLineVal[iPixel],
+                                                 dfDistance2,
+                                                 dfCurvCoeff,
+                                                 dfSphereDiameter);
+        if (left_adjusted)
+        {
+            if (eMode != GVM_Edge)
+                dfZ = CalcHeightDiagonal(nX - iPixel,
+                                         nDY,
+                                         padfThisLineVal[iPixel + 1],
+                                         padfLastLineVal[iPixel],
+                                         dfZObserver);
+
+            if (eMode != GVM_Diagonal)
+            {
+                double dfZ2 = nX - iPixel >= nDY ?
+                    CalcHeightEdge(nDY,
+                                   nX - iPixel,
+                                   padfLastLineVal[iPixel + 1],
+                                   padfThisLineVal[iPixel + 1],
+                                   dfZObserver) :
+                    CalcHeightEdge(nX - iPixel,
+                                   nDY,
+                                   padfLastLineVal[iPixel + 1],
+                                   padfLastLineVal[iPixel],
+                                   dfZObserver);
+                dfZ = CalcHeight(dfZ, dfZ2, eMode);
+            }
+
+            if(heightMode != GVOT_NORMAL)
+                dfHeightResult[iPixel] = std::max(0.0, (dfZ - padfThisLineVal[iPixel] + dfGroundLevel));
+
+            SetVisibility(iPixel,
+                          dfZ,
+                          dfTargetHeight,
+                          padfThisLineVal,
+                          vResult,
+                          byVisibleVal,
+                          byInvisibleVal);
+        }
+        else
+        {
+            for (; iPixel >= 0; iPixel--)
+            {
+                pabyResult[iPixel] = byOutOfRangeVal;
+                if(heightMode != GVOT_NORMAL)
+                    dfHeightResult[iPixel] = dfOutOfRangeVal;
+            }
+        }
+    }
+    /* process right direction */
+    for (int iPixel = nX + 1; iPixel < nXSize; iPixel++)
+    {
+        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfThisLineVal[iPixel] : 0.0;
+        bool right_adjusted = AdjustHeightInRange(padfGeoTransform,
+                                                  iPixel - nX,
+                                                  nDY,
+                                                  padfThisLineVal[iPixel],
+                                                  dfDistance2,
+                                                  dfCurvCoeff,
+                                                  dfSphereDiameter);
+        if (right_adjusted)
+        {
+            if (eMode != GVM_Edge)
+                dfZ = CalcHeightDiagonal(iPixel - nX,
+                                         nDY,
+                                         padfThisLineVal[iPixel - 1],
+                                         padfLastLineVal[iPixel],
+                                         dfZObserver);
+
+            if (eMode != GVM_Diagonal)
+            {
+                double dfZ2 = iPixel - nX >= nDY ?
+                    CalcHeightEdge(nDY,
+                                   iPixel - nX,
+                                   padfLastLineVal[iPixel - 1],
+                                   padfThisLineVal[iPixel - 1],
+                                   dfZObserver) :
+                    CalcHeightEdge(iPixel - nX,
+                                   nDY,
+                                   padfLastLineVal[iPixel - 1],
+                                   padfLastLineVal[iPixel],
+                                   dfZObserver);
+                dfZ = CalcHeight(dfZ, dfZ2, eMode);
+            }
+
+            if(heightMode != GVOT_NORMAL)
+                dfHeightResult[iPixel] = std::max(0.0, (dfZ - padfThisLineVal[iPixel] + dfGroundLevel));
+
+            SetVisibility(iPixel,
+                          dfZ,
+                          dfTargetHeight,
+                          padfThisLineVal,
+                          vResult,
+                          byVisibleVal,
+                          byInvisibleVal);
+        }
+        else
+        {
+            for (; iPixel < nXSize; iPixel++)
+            {
+                pabyResult[iPixel] = byOutOfRangeVal;
+                if(heightMode != GVOT_NORMAL)
+                    dfHeightResult[iPixel] = dfOutOfRangeVal;
+            }
+        }
+    }
+
+}
+
 /************************************************************************/
 /*                        GDALViewshedGenerate()                         */
 /************************************************************************/
@@ -353,7 +707,6 @@ GDALDatasetH GDALViewshedGenerate(GDALRasterBandH hBand,
     }
 
     const double dfZObserver = dfObserverHeight + padfFirstLineVal[nX];
-    double dfZ = 0.0;
     const double dfDistance2 = dfMaxDistance * dfMaxDistance;
 
     /* If we can't get a SemiMajor axis from the SRS, it will be
@@ -374,290 +727,83 @@ GDALDatasetH GDALViewshedGenerate(GDALRasterBandH hBand,
 
     }
 
-    /* mark the observer point as visible */
-    double dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfFirstLineVal[nX] : 0.0;
-    pabyResult[nX] = byVisibleVal;
-    if(heightMode != GVOT_NORMAL)
-        dfHeightResult[nX] = dfGroundLevel;
+    ViewshedLineContext sCtx;
+    sCtx.padfGeoTransform = adfGeoTransform.data();
+    sCtx.nX = nX;
+    sCtx.nXSize = nXSize;
+    sCtx.dfZObserver = dfZObserver;
+    sCtx.dfTargetHeight = dfTargetHeight;
+    sCtx.dfDistance2 = dfDistance2;
+    sCtx.dfCurvCoeff = dfCurvCoeff;
+    sCtx.dfSphereDiameter = dfSphereDiameter;
+    sCtx.eMode = eMode;
+    sCtx.heightMode = heightMode;
+    sCtx.byVisibleVal = byVisibleVal;
+    sCtx.byInvisibleVal = byInvisibleVal;
+    sCtx.byOutOfRangeVal = byOutOfRangeVal;
+    sCtx.dfOutOfRangeVal = dfOutOfRangeVal;
+
+    ViewshedProcessFirstLine(sCtx, padfFirstLineVal, vResult, dfHeightResult);
 
-    if (nX > 0)
-    {
-        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfFirstLineVal[nX - 1] : 0.0;
-        CPL_IGNORE_RET_VAL(
-            AdjustHeightInRange(adfGeoTransform.data(),
-                            1,
-                            0,
-                            padfFirstLineVal[nX - 1],
-                            dfDistance2,
-                            dfCurvCoeff,
-                            dfSphereDiameter));
-        pabyResult[nX - 1] = byVisibleVal;
-        if(heightMode != GVOT_NORMAL)
-            dfHeightResult[nX - 1] = dfGroundLevel;
-    }
-    if (nX < nXSize - 1)
+    /* write result line */
+
+    if (GDALRasterIO(hTargetBand, GF_Write, 0, nY - nYStart, nXSize, 1,
+        heightMode != GVOT_NORMAL ? static_cast<void*>(dfHeightResult) : static_cast<void*>(pabyResult), nXSize, 1, heightMode != GVOT_NORMAL ? GDT_Float64 : GDT_Byte, 0, 0))
     {
-        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfFirstLineVal[nX + 1] : 0.0;
-        CPL_IGNORE_RET_VAL(
-            AdjustHeightInRange(adfGeoTransform.data(),
-                            1,
-                            0,
-                            padfFirstLineVal[nX + 1],
-                            dfDistance2,
-                            dfCurvCoeff,
-                            dfSphereDiameter));
-        pabyResult[nX + 1] = byVisibleVal;
-        if(heightMode != GVOT_NORMAL)
-            dfHeightResult[nX + 1] = dfGroundLevel;
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "RasterIO error when writing target raster at position (%d,%d), size (%d,%d)", 0, nY - nYStart, nXSize, 1);
+        return nullptr;
     }
 
-    /* process left direction */
-    for (int iPixel = nX - 2; iPixel >= 0; iPixel--)
+    /* scan upwards */
+    std::copy(vFirstLineVal.begin(),
+              vFirstLineVal.end(),
+              vLastLineVal.begin());
+    for (int iLine = nY - 1; iLine >= nYStart; iLine--)
     {
-        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfFirstLineVal[iPixel] : 0.0;
-        bool adjusted = AdjustHeightInRange(adfGeoTransform.data(),
-                                            nX - iPixel,
-                                            0,
-                                            padfFirstLineVal[iPixel],
-                                            dfDistance2,
-                                            dfCurvCoeff,
-                                            dfSphereDiameter);
-        if (adjusted)
+        if (GDALRasterIO(hBand, GF_Read, nXStart, iLine, nXSize, 1,
+            padfThisLineVal, nXSize, 1, GDT_Float64, 0, 0))
         {
-            dfZ = CalcHeightLine(nX - iPixel,
-                                 padfFirstLineVal[iPixel + 1],
-                                 dfZObserver);
+            CPLError(CE_Failure, CPLE_AppDefined,
+                "RasterIO error when reading DEM at position (%d,%d), size (%d,%d)", nXStart, iLine, nXSize, 1);
+            return nullptr;
+        }
 
-            if(heightMode != GVOT_NORMAL)
-                dfHeightResult[iPixel] = std::max(0.0, (dfZ - padfFirstLineVal[iPixel] + dfGroundLevel));
+        ViewshedProcessLine(sCtx, nY - iLine, padfLastLineVal, padfThisLineVal,
+                            vResult, dfHeightResult);
 
-            SetVisibility(  iPixel,
-                            dfZ,
-                            dfTargetHeight,
-                            padfFirstLineVal,
-                            vResult,
-                            byVisibleVal,
-                            byInvisibleVal);
-        }
-        else
+        /* write result line */
+        if (GDALRasterIO(hTargetBand, GF_Write, 0, iLine - nYStart, nXSize, 1,
+            heightMode != GVOT_NORMAL ? static_cast<void*>(dfHeightResult) : static_cast<void*>(pabyResult), nXSize, 1, heightMode != GVOT_NORMAL ? GDT_Float64 : GDT_Byte, 0, 0))
         {
-            for (; iPixel >= 0; iPixel--)
-            {
-                pabyResult[iPixel] = byOutOfRangeVal;
-                if(heightMode != GVOT_NORMAL)
-                    dfHeightResult[iPixel] = dfOutOfRangeVal;
-            }
+            CPLError(CE_Failure, CPLE_AppDefined,
+                "RasterIO error when writing target raster at position (%d,%d), size (%d,%d)", 0, iLine - nYStart, nXSize, 1);
+            return nullptr;
         }
-    }
-    /* process right direction */
-    for (int iPixel = nX + 2; iPixel < nXSize; iPixel++)
-    {
-        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfFirstLineVal[iPixel] : 0.0;
-        bool adjusted = AdjustHeightInRange(adfGeoTransform.data(),
-                                            iPixel - nX,
-                                            0,
-                                            padfFirstLineVal[iPixel],
-                                            dfDistance2,
-                                            dfCurvCoeff,
-                                            dfSphereDiameter);
-        if (adjusted)
-        {
-            dfZ = CalcHeightLine(iPixel - nX,
-                                 padfFirstLineVal[iPixel - 1],
-                                 dfZObserver);
 
-            if(heightMode != GVOT_NORMAL)
-                dfHeightResult[iPixel] = std::max(0.0, (dfZ - padfFirstLineVal[iPixel] + dfGroundLevel));
+        std::swap(padfLastLineVal, padfThisLineVal);
 
-            SetVisibility(iPixel,
-                          dfZ,
-                          dfTargetHeight,
-                          padfFirstLineVal,
-                          vResult,
-                          byVisibleVal,
-                          byInvisibleVal);
-        }
-        else
+        if (!pfnProgress((nYStart - iLine + 1) / static_cast<double>(nYStop),
+                "", pProgressArg))
         {
-            for (; iPixel < nXSize; iPixel++)
-            {
-                pabyResult[iPixel] = byOutOfRangeVal;
-                if(heightMode != GVOT_NORMAL)
-                    dfHeightResult[iPixel] = dfOutOfRangeVal;
-            }
+            CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+            return nullptr;
         }
     }
-    /* write result line */
-
-    if (GDALRasterIO(hTargetBand, GF_Write, 0, nY - nYStart, nXSize, 1,
-        heightMode != GVOT_NORMAL ? static_cast<void*>(dfHeightResult) : static_cast<void*>(pabyResult), nXSize, 1, heightMode != GVOT_NORMAL ? GDT_Float64 : GDT_Byte, 0, 0))
-    {
-        CPLError(CE_Failure, CPLE_AppDefined,
-            "RasterIO error when writing target raster at position (%d,%d), size (%d,%d)", 0, nY - nYStart, nXSize, 1);
-        return nullptr;
-    }
-
-    /* scan upwards */
-    std::copy(vFirstLineVal.begin(),
-              vFirstLineVal.end(),
-              vLastLineVal.begin());
-    for (int iLine = nY - 1; iLine >= nYStart; iLine--)
+    /* scan downwards */
+    memcpy(padfLastLineVal, padfFirstLineVal, nXSize * sizeof(double));
+    for(int iLine = nY + 1; iLine < nYStop; iLine++ )
     {
-        if (GDALRasterIO(hBand, GF_Read, nXStart, iLine, nXSize, 1,
-            padfThisLineVal, nXSize, 1, GDT_Float64, 0, 0))
+        if (GDALRasterIO( hBand, GF_Read, nXStart, iLine, nXStop - nXStart, 1,
+            padfThisLineVal, nXStop - nXStart, 1, GDT_Float64, 0, 0 ))
         {
             CPLError(CE_Failure, CPLE_AppDefined,
-                "RasterIO error when reading DEM at position (%d,%d), size (%d,%d)", nXStart, iLine, nXSize, 1);
+                "RasterIO error when reading DEM at position (%d,%d), size (%d,%d)", nXStart, iLine, nXStop - nXStart, 1);
             return nullptr;
         }
 
-        /* set up initial point on the scanline */
-        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfThisLineVal[nX] : 0.0;
-        bool adjusted = AdjustHeightInRange(adfGeoTransform.data(),
-                                            0,
-                                            nY - iLine,
-                                            padfThisLineVal[nX],
-                                            dfDistance2,
-                                            dfCurvCoeff,
-                                            dfSphereDiameter);
-        if (adjusted)
-        {
-            dfZ = CalcHeightLine(nY - iLine,
-                                 padfLastLineVal[nX],
-                                 dfZObserver);
-
-            if(heightMode != GVOT_NORMAL)
-                dfHeightResult[nX] = std::max(0.0, (dfZ - padfThisLineVal[nX] + dfGroundLevel));
-
-            SetVisibility(nX,
-                          dfZ,
-                          dfTargetHeight,
-                          padfThisLineVal,
-                          vResult,
-                          byVisibleVal,
-                          byInvisibleVal);
-        }
-        else
-        {
-            pabyResult[nX] = byOutOfRangeVal;
-            if(heightMode != GVOT_NORMAL)
-                dfHeightResult[nX] = dfOutOfRangeVal;
-        }
-
-        /* process left direction */
-        for (int iPixel = nX - 1; iPixel >= 0; iPixel--)
-        {
-            dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfThisLineVal[iPixel] : 0.0;
-            bool left_adjusted = AdjustHeightInRange(adfGeoTransform.data(),
-                                                     nX - iPixel,
-                                                     nY - iLine,
-                                                     padfThisLineVal[iPixel],
-                                                     dfDistance2,
-                                                     dfCurvCoeff,
-                                                     dfSphereDiameter);
-            if (left_adjusted)
-            {
-                if (eMode != GVM_Edge)
-                    dfZ = CalcHeightDiagonal(nX - iPixel,
-                                             nY - iLine,
-                                             padfThisLineVal[iPixel + 1],
-                                             padfLastLineVal[iPixel],
-                                             dfZObserver);
-
-                if (eMode != GVM_Diagonal)
-                {
-                    double dfZ2 = nX - iPixel >= nY - iLine ?
-                        CalcHeightEdge(nY - iLine,
-                                       nX - iPixel,
-                                       padfLastLineVal[iPixel + 1],
-                                       padfThisLineVal[iPixel + 1],
-                                       dfZObserver) :
-                        CalcHeightEdge(nX - iPixel,
-                                       nY - iLine,
-                                       padfLastLineVal[iPixel + 1],
-                                       padfLastLineVal[iPixel],
-                                       dfZObserver);
-                    dfZ = CalcHeight(dfZ, dfZ2, eMode);
-                }
-
-                if(heightMode != GVOT_NORMAL)
-                    dfHeightResult[iPixel] = std::max(0.0, (dfZ - padfThisLineVal[iPixel] + dfGroundLevel));
-
-                SetVisibility(iPixel,
-                              dfZ,
-                              dfTargetHeight,
-                              padfThisLineVal,
-                              vResult,
-                              byVisibleVal,
-                              byInvisibleVal);
-            }
-            else
-            {
-                for (; iPixel >= 0; iPixel--)
-                {
-                    pabyResult[iPixel] = byOutOfRangeVal;
-                    if(heightMode != GVOT_NORMAL)
-                        dfHeightResult[iPixel] = dfOutOfRangeVal;
-                }
-            }
-        }
-        /* process right direction */
-        for (int iPixel = nX + 1; iPixel < nXSize; iPixel++)
-        {
-            dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfThisLineVal[iPixel] : 0.0;
-            bool right_adjusted = AdjustHeightInRange(adfGeoTransform.data(),
-                                                      iPixel - nX,
-                                                      nY - iLine,
-                                                      padfThisLineVal[iPixel],
-                                                      dfDistance2,
-                                                      dfCurvCoeff,
-                                                      dfSphereDiameter);
-            if (right_adjusted)
-            {
-                if (eMode != GVM_Edge)
-                    dfZ = CalcHeightDiagonal(iPixel - nX,
-                                             nY - iLine,
-                                             padfThisLineVal[iPixel - 1],
-                                             padfLastLineVal[iPixel],
-                                             dfZObserver);
-
-                if (eMode != GVM_Diagonal)
-                {
-                    double dfZ2 = iPixel - nX >= nY - iLine ?
-                        CalcHeightEdge(nY - iLine,
-                                       iPixel - nX,
-                                       padfLastLineVal[iPixel - 1],
-                                       padfThisLineVal[iPixel - 1],
-                                       dfZObserver) :
-                        CalcHeightEdge(iPixel - nX,
-                                       nY - iLine,
-                                       padfLastLineVal[iPixel - 1],
-                                       padfLastLineVal[iPixel],
-                                       dfZObserver);
-                    dfZ = CalcHeight(dfZ, dfZ2, eMode);
-                }
-
-                if(heightMode != GVOT_NORMAL)
-                    dfHeightResult[iPixel] = std::max(0.0, (dfZ - padfThisLineVal[iPixel] + dfGroundLevel));
-
-                SetVisibility(iPixel,
-                              dfZ,
-                              dfTargetHeight,
-                              padfThisLineVal,
-                              vResult,
-                              byVisibleVal,
-                              byInvisibleVal);
-            }
-            else
-            {
-                for (; iPixel < nXSize; iPixel++)
-                {
-                    pabyResult[iPixel] = byOutOfRangeVal;
-                    if(heightMode != GVOT_NORMAL)
-                        dfHeightResult[iPixel] = dfOutOfRangeVal;
-                }
-            }
-        }
+        ViewshedProcessLine(sCtx, iLine - nY, padfLastLineVal, padfThisLineVal,
+                            vResult, dfHeightResult);
 
         /* write result line */
         if (GDALRasterIO(hTargetBand, GF_Write, 0, iLine - nYStart, nXSize, 1,
@@ -670,187 +816,471 @@ GDALDatasetH GDALViewshedGenerate(GDALRasterBandH hBand,
 
         std::swap(padfLastLineVal, padfThisLineVal);
 
-        if (!pfnProgress((nYStart - iLine + 1) / static_cast<double>(nYStop),
-                "", pProgressArg))
+        if(!pfnProgress((iLine + 1) / static_cast<double>(nYStop),
+                         "", pProgressArg) )
         {
-            CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
             return nullptr;
         }
     }
+
+    return GDALDataset::FromHandle(poDstDS.release());
+}
+
+/************************************************************************/
+/*                    ViewshedAccumulateObserver()                      */
+/************************************************************************/
+
+namespace {
+struct ViewshedObserver
+{
+    // Observer position and processed window, in DEM pixels.
+    int nX = 0;
+    int nY = 0;
+    int nXStart = 0;
+    int nXStop = 0;
+    int nYStart = 0;
+    int nYStop = 0;
+    double dfHeight = 0.0;
+};
+
+struct ViewshedMultiContext
+{
+    // DEM values of the union of the windows of all observers.
+    const double *padfDEM = nullptr;
+    int nWinXOff = 0;
+    int nWinYOff = 0;
+    int nWinXSize = 0;
+    int nWinYSize = 0;
+
+    const double *padfGeoTransform = nullptr;
+    double dfTargetHeight = 0.0;
+    double dfDistance2 = 0.0;
+    double dfCurvCoeff = 0.0;
+    double dfSphereDiameter = 0.0;
+    GDALViewshedMode eMode = GVM_Edge;
+    const std::vector<ViewshedObserver> *paoObservers = nullptr;
+};
+
+struct ViewshedMultiJob
+{
+    const ViewshedMultiContext *psCtx = nullptr;
+    // Observers iStart, iStart + nStep, ... before iEnd.
+    int iStart = 0;
+    int iEnd = 0;
+    int nStep = 1;
+
+    // Visibility counts over the DEM window, and working lines.
+    std::vector<GUInt32> anCounts{};
+    std::vector<double> adfFirstLineVal{};
+    std::vector<double> adfLastLineVal{};
+    std::vector<double> adfThisLineVal{};
+    std::vector<GByte> abyResult{};
+};
+}  // namespace
+
+static void ViewshedAccumulateObserver(const ViewshedMultiContext& sMulti,
+                                       const ViewshedObserver& sObs,
+                                       ViewshedMultiJob& sJob)
+{
+    const int nXSize = sObs.nXStop - sObs.nXStart;
+    const int nX = sObs.nX - sObs.nXStart;
+
+    const auto GetDEMLine = [&sMulti, &sObs](int iLine)
+    {
+        return sMulti.padfDEM +
+               static_cast<size_t>(iLine - sMulti.nWinYOff) * sMulti.nWinXSize +
+               (sObs.nXStart - sMulti.nWinXOff);
+    };
+    const auto Accumulate = [&sMulti, &sObs, &sJob, nXSize](int iLine)
+    {
+        GUInt32 *panCounts = sJob.anCounts.data() +
+            static_cast<size_t>(iLine - sMulti.nWinYOff) * sMulti.nWinXSize +
+            (sObs.nXStart - sMulti.nWinXOff);
+        const GByte *pabyResult = sJob.abyResult.data();
+        for( int i = 0; i < nXSize; i++ )
+            panCounts[i] += pabyResult[i];
+    };
+
+    double *padfFirstLineVal = sJob.adfFirstLineVal.data();
+    double *padfLastLineVal = sJob.adfLastLineVal.data();
+    double *padfThisLineVal = sJob.adfThisLineVal.data();
+    const size_t nLineBytes = nXSize * sizeof(double);
+
+    // The DEM lines are copied, as processing a line updates its values.
+    memcpy(padfFirstLineVal, GetDEMLine(sObs.nY), nLineBytes);
+
+    ViewshedLineContext sCtx;
+    sCtx.padfGeoTransform = sMulti.padfGeoTransform;
+    sCtx.nX = nX;
+    sCtx.nXSize = nXSize;
+    sCtx.dfZObserver = sObs.dfHeight + padfFirstLineVal[nX];
+    sCtx.dfTargetHeight = sMulti.dfTargetHeight;
+    sCtx.dfDistance2 = sMulti.dfDistance2;
+    sCtx.dfCurvCoeff = sMulti.dfCurvCoeff;
+    sCtx.dfSphereDiameter = sMulti.dfSphereDiameter;
+    sCtx.eMode = sMulti.eMode;
+    sCtx.heightMode = GVOT_NORMAL;
+    sCtx.byVisibleVal = 1;
+    sCtx.byInvisibleVal = 0;
+    sCtx.byOutOfRangeVal = 0;
+
+    ViewshedProcessFirstLine(sCtx, padfFirstLineVal, sJob.abyResult, nullptr);
+    Accumulate(sObs.nY);
+
+    /* scan upwards */
+    memcpy(padfLastLineVal, padfFirstLineVal, nLineBytes);
+    for (int iLine = sObs.nY - 1; iLine >= sObs.nYStart; iLine--)
+    {
+        memcpy(padfThisLineVal, GetDEMLine(iLine), nLineBytes);
+        ViewshedProcessLine(sCtx, sObs.nY - iLine, padfLastLineVal,
+                            padfThisLineVal, sJob.abyResult, nullptr);
+        Accumulate(iLine);
+        std::swap(padfLastLineVal, padfThisLineVal);
+    }
+
     /* scan downwards */
-    memcpy(padfLastLineVal, padfFirstLineVal, nXSize * sizeof(double));
-    for(int iLine = nY + 1; iLine < nYStop; iLine++ )
+    memcpy(padfLastLineVal, padfFirstLineVal, nLineBytes);
+    for (int iLine = sObs.nY + 1; iLine < sObs.nYStop; iLine++)
     {
-        if (GDALRasterIO( hBand, GF_Read, nXStart, iLine, nXStop - nXStart, 1,
-            padfThisLineVal, nXStop - nXStart, 1, GDT_Float64, 0, 0 ))
+        memcpy(padfThisLineVal, GetDEMLine(iLine), nLineBytes);
+        ViewshedProcessLine(sCtx, iLine - sObs.nY, padfLastLineVal,
+                            padfThisLineVal, sJob.abyResult, nullptr);
+        Accumulate(iLine);
+        std::swap(padfLastLineVal, padfThisLineVal);
+    }
+}
+
+static void ViewshedMultiJobFunc(void *pData)
+{
+    ViewshedMultiJob *psJob = static_cast<ViewshedMultiJob *>(pData);
+    const ViewshedMultiContext *psCtx = psJob->psCtx;
+    for (int i = psJob->iStart; i < psJob->iEnd; i += psJob->nStep)
+        ViewshedAccumulateObserver(*psCtx, (*psCtx->paoObservers)[i], *psJob);
+}
+
+/************************************************************************/
+/*                     GDALViewshedGenerateMulti()                      */
+/************************************************************************/
+
+/**
+ * Create a cumulative viewshed from a raster DEM and many observers.
+ *
+ * For each output pixel, count the number of observers from which it is
+ * visible, each observer being processed as by GDALViewshedGenerate() with
+ * the GVOT_NORMAL output type. The DEM window covering all the observers is
+ * read once in memory, and observers are processed concurrently.
+ *
+ * The output raster covers the union of the processed windows of the
+ * observers. It is of type UInt16, or UInt32 if there are more than 65535
+ * observers.
+ *
+ * @param hBand The band to read the DEM data from.
+ *
+ * @param pszDriverName Driver name (GTiff if set to NULL)
+ *
+ * @param pszTargetRasterName The name of the target raster to be generated. Must not be NULL
+ *
+ * @param papszCreationOptions creation options.
+ *
+ * @param nObserverCount number of observers.
+ *
+ * @param padfObserverX observer X values (in SRS units)
+ *
+ * @param padfObserverY observer Y values (in SRS units)
+ *
+ * @param padfObserverHeight heights of the observers above the DEM surface.
+ *
+ * @param dfTargetHeight The height of the target above the DEM surface.
+ *
+ * @param dfCurvCoeff Coefficient to consider the effect of the curvature and
+ * refraction. See GDALViewshedGenerate().
+ *
+ * @param eMode The mode of the viewshed calculation.
+ *
+ * @param dfMaxDistance maximum distance range to compute viewshed around each
+ * observer. If set to 0, the whole raster is processed for each observer.
+ *
+ * @param pfnProgress A GDALProgressFunc that may be used to report progress
+ * to the user, or to interrupt the algorithm.  May be NULL if not required.
+ *
+ * @param pProgressArg The callback data for the pfnProgress function.
+ *
+ * @param papszExtraOptions Extra options, or NULL:
+ * <ul>
+ * <li>NUM_THREADS=number_of_threads/ALL_CPUS: number of threads processing
+ * observers. Defaults to the value of the GDAL_NUM_THREADS configuration
+ * option, or 1. Each thread keeps its own counts for the whole output
+ * window.</li>
+ * </ul>
+ *
+ * @return not NULL output dataset on success (to be closed with GDALClose()) or NULL if an error occurs.
+ *
+ * @since GDAL 3.4
+ */
+
+GDALDatasetH GDALViewshedGenerateMulti(GDALRasterBandH hBand,
+                                       const char* pszDriverName,
+                                       const char* pszTargetRasterName,
+                                       CSLConstList papszCreationOptions,
+                                       int nObserverCount,
+                                       const double* padfObserverX,
+                                       const double* padfObserverY,
+                                       const double* padfObserverHeight,
+                                       double dfTargetHeight, double dfCurvCoeff,
+                                       GDALViewshedMode eMode, double dfMaxDistance,
+                                       GDALProgressFunc pfnProgress, void *pProgressArg,
+                                       CSLConstList papszExtraOptions)
+
+{
+    VALIDATE_POINTER1( hBand, "GDALViewshedGenerateMulti", nullptr );
+    VALIDATE_POINTER1( pszTargetRasterName, "GDALViewshedGenerateMulti", nullptr );
+    VALIDATE_POINTER1( padfObserverX, "GDALViewshedGenerateMulti", nullptr );
+    VALIDATE_POINTER1( padfObserverY, "GDALViewshedGenerateMulti", nullptr );
+    VALIDATE_POINTER1( padfObserverHeight, "GDALViewshedGenerateMulti", nullptr );
+
+    if (nObserverCount <= 0)
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg, "No observer");
+        return nullptr;
+    }
+
+    if( pfnProgress == nullptr )
+        pfnProgress = GDALDummyProgress;
+
+    if( !pfnProgress( 0.0, "", pProgressArg ) )
+    {
+        CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+        return nullptr;
+    }
+
+    const char *pszNumThreads =
+        CSLFetchNameValue(papszExtraOptions, "NUM_THREADS");
+    if( pszNumThreads == nullptr )
+        pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                       atoi(pszNumThreads);
+    nThreads = std::max(1, std::min(std::min(nThreads, 128), nObserverCount));
+
+    /* set up geotransformation */
+    std::array<double, 6> adfGeoTransform {{0.0, 1.0, 0.0, 0.0, 0.0, 1.0}};
+    GDALDatasetH hSrcDS = GDALGetBandDataset( hBand );
+    if( hSrcDS != nullptr )
+        GDALGetGeoTransform( hSrcDS, adfGeoTransform.data());
+
+    double adfInvGeoTransform[6];
+    if (!GDALInvGeoTransform(adfGeoTransform.data(), adfInvGeoTransform))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Cannot invert geotransform");
+        return nullptr;
+    }
+
+    const int nRasterXSize = GDALGetRasterBandXSize( hBand );
+    const int nRasterYSize = GDALGetRasterBandYSize( hBand );
+
+    /* calculate observer positions and the window covering them all */
+    std::vector<ViewshedObserver> aoObservers;
+    int nWinXStart = nRasterXSize;
+    int nWinXStop = 0;
+    int nWinYStart = nRasterYSize;
+    int nWinYStop = 0;
+    try
+    {
+        aoObservers.resize(nObserverCount);
+    }
+    catch (...)
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate observers for viewshed");
+        return nullptr;
+    }
+    for (int i = 0; i < nObserverCount; i++)
+    {
+        double dfX, dfY;
+        GDALApplyGeoTransform(adfInvGeoTransform, padfObserverX[i],
+                              padfObserverY[i], &dfX, &dfY);
+        if (!(dfX >= 0 && dfX < nRasterXSize && dfY >= 0 && dfY < nRasterYSize))
         {
             CPLError(CE_Failure, CPLE_AppDefined,
-                "RasterIO error when reading DEM at position (%d,%d), size (%d,%d)", nXStart, iLine, nXStop - nXStart, 1);
+                     "Observer %d falls outside of the DEM area", i);
             return nullptr;
         }
+        ViewshedObserver& sObs = aoObservers[i];
+        sObs.nX = static_cast<int>(dfX);
+        sObs.nY = static_cast<int>(dfY);
+        sObs.dfHeight = padfObserverHeight[i];
+        sObs.nXStart = dfMaxDistance > 0? (std::max)(0, static_cast<int>(std::floor(sObs.nX - adfInvGeoTransform[1] * dfMaxDistance))) : 0;
+        sObs.nXStop = dfMaxDistance > 0? (std::min)(nRasterXSize, static_cast<int>(std::ceil(sObs.nX + adfInvGeoTransform[1] * dfMaxDistance) + 1)) : nRasterXSize;
+        sObs.nYStart = dfMaxDistance > 0? (std::max)(0, static_cast<int>(std::floor(sObs.nY + adfInvGeoTransform[5] * dfMaxDistance))) : 0;
+        sObs.nYStop = dfMaxDistance > 0? (std::min)(nRasterYSize, static_cast<int>(std::ceil(sObs.nY - adfInvGeoTransform[5] * dfMaxDistance) + 1)) : nRasterYSize;
+
+        nWinXStart = std::min(nWinXStart, sObs.nXStart);
+        nWinXStop = std::max(nWinXStop, sObs.nXStop);
+        nWinYStart = std::min(nWinYStart, sObs.nYStart);
+        nWinYStop = std::max(nWinYStop, sObs.nYStop);
+    }
+    const int nWinXSize = nWinXStop - nWinXStart;
+    const int nWinYSize = nWinYStop - nWinYStart;
+    const size_t nWinPixels = static_cast<size_t>(nWinXSize) * nWinYSize;
 
-        /* set up initial point on the scanline */
-        dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfThisLineVal[nX] : 0.0;
-        bool adjusted = AdjustHeightInRange(adfGeoTransform.data(),
-                                            0,
-                                            iLine - nY,
-                                            padfThisLineVal[nX],
-                                            dfDistance2,
-                                            dfCurvCoeff,
-                                            dfSphereDiameter);
-        if (adjusted)
+    /* read the DEM window shared by all observers */
+    std::vector<double> adfDEM;
+    std::vector<ViewshedMultiJob> asJobs;
+    try
+    {
+        adfDEM.resize(nWinPixels);
+        asJobs.resize(nThreads);
+        for (auto& sJob: asJobs)
         {
-            dfZ = CalcHeightLine(iLine - nY,
-                                 padfLastLineVal[nX],
-                                 dfZObserver);
+            sJob.anCounts.resize(nWinPixels);
+            sJob.adfFirstLineVal.resize(nWinXSize);
+            sJob.adfLastLineVal.resize(nWinXSize);
+            sJob.adfThisLineVal.resize(nWinXSize);
+            sJob.abyResult.resize(nWinXSize);
+        }
+    }
+    catch (...)
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate buffers for viewshed");
+        return nullptr;
+    }
 
-            if(heightMode != GVOT_NORMAL)
-                dfHeightResult[nX] = std::max(0.0, (dfZ - padfThisLineVal[nX] + dfGroundLevel));
+    if (GDALRasterIO(hBand, GF_Read, nWinXStart, nWinYStart,
+                     nWinXSize, nWinYSize, adfDEM.data(),
+                     nWinXSize, nWinYSize, GDT_Float64, 0, 0))
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "RasterIO error when reading DEM at position (%d,%d), size (%d,%d)",
+            nWinXStart, nWinYStart, nWinXSize, nWinYSize);
+        return nullptr;
+    }
 
-            SetVisibility(nX,
-                          dfZ,
-                          dfTargetHeight,
-                          padfThisLineVal,
-                          vResult,
-                          byVisibleVal,
-                          byInvisibleVal);
-        }
+    GDALDriverManager *hMgr = GetGDALDriverManager();
+    GDALDriver *hDriver = hMgr->GetDriverByName(pszDriverName ? pszDriverName : "GTiff");
+    if (!hDriver)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Cannot get driver");
+        return nullptr;
+    }
+
+    /* create output raster */
+    auto poDstDS = std::unique_ptr<GDALDataset>(hDriver->Create(
+        pszTargetRasterName, nWinXSize, nWinYSize, 1,
+        nObserverCount > 65535 ? GDT_UInt32 : GDT_UInt16,
+        const_cast<char**>(papszCreationOptions)));
+    if (!poDstDS)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "Cannot create dataset for %s", pszTargetRasterName);
+        return nullptr;
+    }
+    /* copy srs */
+    if (hSrcDS)
+        poDstDS->SetSpatialRef(GDALDataset::FromHandle(hSrcDS)->GetSpatialRef());
+
+    std::array<double, 6> adfDstGeoTransform;
+    adfDstGeoTransform[0] = adfGeoTransform[0] + adfGeoTransform[1] * nWinXStart + adfGeoTransform[2] * nWinYStart;
+    adfDstGeoTransform[1] = adfGeoTransform[1];
+    adfDstGeoTransform[2] = adfGeoTransform[2];
+    adfDstGeoTransform[3] = adfGeoTransform[3] + adfGeoTransform[4] * nWinXStart + adfGeoTransform[5] * nWinYStart;
+    adfDstGeoTransform[4] = adfGeoTransform[4];
+    adfDstGeoTransform[5] = adfGeoTransform[5];
+    poDstDS->SetGeoTransform(adfDstGeoTransform.data());
+
+    /* If we can't get a SemiMajor axis from the SRS, it will be
+     * SRS_WGS84_SEMIMAJOR
+    */
+    double dfSphereDiameter(std::numeric_limits<double>::infinity());
+    const OGRSpatialReference* poDstSRS = poDstDS->GetSpatialRef();
+    if (poDstSRS)
+    {
+        OGRErr eSRSerr;
+        double dfSemiMajor = poDstSRS->GetSemiMajor(&eSRSerr);
+
+        /* If we fetched the axis from the SRS, use it */
+        if (eSRSerr != OGRERR_FAILURE)
+            dfSphereDiameter = dfSemiMajor * 2.0;
         else
+            CPLDebug( "GDALViewshedGenerateMulti", "Unable to fetch SemiMajor axis from spatial reference");
+    }
+
+    ViewshedMultiContext sMulti;
+    sMulti.padfDEM = adfDEM.data();
+    sMulti.nWinXOff = nWinXStart;
+    sMulti.nWinYOff = nWinYStart;
+    sMulti.nWinXSize = nWinXSize;
+    sMulti.nWinYSize = nWinYSize;
+    sMulti.padfGeoTransform = adfGeoTransform.data();
+    sMulti.dfTargetHeight = dfTargetHeight;
+    sMulti.dfDistance2 = dfMaxDistance * dfMaxDistance;
+    sMulti.dfCurvCoeff = dfCurvCoeff;
+    sMulti.dfSphereDiameter = dfSphereDiameter;
+    sMulti.eMode = eMode;
+    sMulti.paoObservers = &aoObservers;
+
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    if (nThreads > 1)
+    {
+        CPLWorkerThreadPool *poThreadPool = GDALGetGlobalThreadPool(nThreads);
+        if (poThreadPool)
+            poJobQueue = poThreadPool->CreateJobQueue();
+    }
+
+    /* process observers by batches, to report progress in between */
+    const int nBatchSize = nThreads * 4;
+    for (int iBatch = 0; iBatch < nObserverCount; iBatch += nBatchSize)
+    {
+        const int iBatchEnd = std::min(nObserverCount, iBatch + nBatchSize);
+        for (int iJob = 0; iJob < nThreads; iJob++)
         {
-            pabyResult[nX] = byOutOfRangeVal;
-            if(heightMode != GVOT_NORMAL)
-                dfHeightResult[nX] = dfOutOfRangeVal;
+            asJobs[iJob].psCtx = &sMulti;
+            asJobs[iJob].iStart = iBatch + iJob;
+            asJobs[iJob].iEnd = iBatchEnd;
+            asJobs[iJob].nStep = nThreads;
         }
-
-        /* process left direction */
-        for (int iPixel = nX - 1; iPixel >= 0; iPixel--)
+        if (poJobQueue)
         {
-            dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfThisLineVal[iPixel] : 0.0;
-            bool left_adjusted = AdjustHeightInRange(adfGeoTransform.data(),
-                                                     nX - iPixel,
-                                                     iLine - nY,
-                                                     padfThisLineVal[iPixel],
-                                                     dfDistance2,
-                                                     dfCurvCoeff,
-                                                     dfSphereDiameter);
-            if (left_adjusted)
-            {
-                if (eMode != GVM_Edge)
-                    dfZ = CalcHeightDiagonal(nX - iPixel, iLine - nY,
-                        padfThisLineVal[iPixel + 1], padfLastLineVal[iPixel], dfZObserver);
-
-                if (eMode != GVM_Diagonal)
-                {
-                    double dfZ2 = nX - iPixel >= iLine - nY ?
-                        CalcHeightEdge(iLine - nY,
-                                       nX - iPixel,
-                                       padfLastLineVal[iPixel + 1],
-                                       padfThisLineVal[iPixel + 1],
-                                       dfZObserver) :
-                        CalcHeightEdge(nX - iPixel,
-                                       iLine - nY,
-                                       padfLastLineVal[iPixel + 1],
-                                       padfLastLineVal[iPixel],
-                                       dfZObserver);
-                    dfZ = CalcHeight(dfZ, dfZ2, eMode);
-                }
-
-                if(heightMode != GVOT_NORMAL)
-                    dfHeightResult[iPixel] = std::max(0.0, (dfZ - padfThisLineVal[iPixel] + dfGroundLevel));
-
-                SetVisibility(iPixel,
-                              dfZ,
-                              dfTargetHeight,
-                              padfThisLineVal,
-                              vResult,
-                              byVisibleVal,
-                              byInvisibleVal);
-            }
-            else
-            {
-                for (; iPixel >= 0; iPixel--)
-                {
-                    pabyResult[iPixel] = byOutOfRangeVal;
-                    if(heightMode != GVOT_NORMAL)
-                        dfHeightResult[iPixel] = dfOutOfRangeVal;
-                }
-            }
+            for (auto& sJob: asJobs)
+                poJobQueue->SubmitJob(ViewshedMultiJobFunc, &sJob);
+            poJobQueue->WaitCompletion();
         }
-        /* process right direction */
-        for (int iPixel = nX + 1; iPixel < nXSize; iPixel++)
+        else
         {
-            dfGroundLevel = heightMode == GVOT_MIN_TARGET_HEIGHT_FROM_DEM ? padfThisLineVal[iPixel] : 0.0;
-            bool right_adjusted = AdjustHeightInRange(adfGeoTransform.data(),
-                                                      iPixel - nX,
-                                                      iLine - nY,
-                                                      padfThisLineVal[iPixel],
-                                                      dfDistance2,
-                                                      dfCurvCoeff,
-                                                      dfSphereDiameter);
-            if (right_adjusted)
-            {
-                if (eMode != GVM_Edge)
-                    dfZ = CalcHeightDiagonal(iPixel - nX,
-                                             iLine - nY,
-                                             padfThisLineVal[iPixel - 1],
-                                             padfLastLineVal[iPixel],
-                                             dfZObserver);
-
-                if (eMode != GVM_Diagonal)
-                {
-                    double dfZ2 = iPixel - nX >= iLine - nY ?
-                        CalcHeightEdge(iLine - nY,
-                                       iPixel - nX,
-                                       padfLastLineVal[iPixel - 1],
-                                       padfThisLineVal[iPixel - 1],
-                                       dfZObserver) :
-                        CalcHeightEdge(iPixel - nX,
-                                       iLine - nY,
-                                       padfLastLineVal[iPixel - 1],
-                                       padfLastLineVal[iPixel],
-                                       dfZObserver);
-                    dfZ = CalcHeight(dfZ, dfZ2, eMode);
-                }
-
-                if(heightMode != GVOT_NORMAL)
-                    dfHeightResult[iPixel] = std::max(0.0, (dfZ - padfThisLineVal[iPixel] + dfGroundLevel));
-
-                SetVisibility(iPixel,
-                              dfZ,
-                              dfTargetHeight,
-                              padfThisLineVal,
-                              vResult,
-                              byVisibleVal,
-                              byInvisibleVal);
-            }
-            else
-            {
-                for (; iPixel < nXSize; iPixel++)
-                {
-                    pabyResult[iPixel] = byOutOfRangeVal;
-                    if(heightMode != GVOT_NORMAL)
-                        dfHeightResult[iPixel] = dfOutOfRangeVal;
-                }
-            }
+            for (auto& sJob: asJobs)
+                ViewshedMultiJobFunc(&sJob);
         }
 
-        /* write result line */
-        if (GDALRasterIO(hTargetBand, GF_Write, 0, iLine - nYStart, nXSize, 1,
-            heightMode != GVOT_NORMAL ? static_cast<void*>(dfHeightResult) : static_cast<void*>(pabyResult), nXSize, 1, heightMode != GVOT_NORMAL ? GDT_Float64 : GDT_Byte, 0, 0))
+        if (!pfnProgress(0.95 * iBatchEnd / nObserverCount, "", pProgressArg))
         {
-            CPLError(CE_Failure, CPLE_AppDefined,
-                "RasterIO error when writing target raster at position (%d,%d), size (%d,%d)", 0, iLine - nYStart, nXSize, 1);
+            CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
             return nullptr;
         }
+    }
 
-        std::swap(padfLastLineVal, padfThisLineVal);
+    /* merge the counts of the threads */
+    GUInt32 *panCounts = asJobs[0].anCounts.data();
+    for (int iJob = 1; iJob < nThreads; iJob++)
+    {
+        const GUInt32 *panJobCounts = asJobs[iJob].anCounts.data();
+        for (size_t i = 0; i < nWinPixels; i++)
+            panCounts[i] += panJobCounts[i];
+    }
 
-        if(!pfnProgress((iLine + 1) / static_cast<double>(nYStop),
-                         "", pProgressArg) )
-        {
-            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-            return nullptr;
-        }
+    if (poDstDS->GetRasterBand(1)->RasterIO(GF_Write, 0, 0, nWinXSize, nWinYSize,
+                                            panCounts, nWinXSize, nWinYSize,
+                                            GDT_UInt32, 0, 0, nullptr) != CE_None)
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+            "RasterIO error when writing target raster of size (%d,%d)",
+            nWinXSize, nWinYSize);
+        return nullptr;
+    }
+
+    if (!pfnProgress(1.0, "", pProgressArg))
+    {
+        CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+        return nullptr;
     }
 
     return GDALDataset::FromHandle(poDstDS.release());
@@ -29,8 +29,10 @@
 #include "commonutils.h"
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
+#include <algorithm>
 #include <string>
 
 #include "cpl_conv.h"
@@ -158,6 +160,76 @@ CPLString GetOutputDriverForRaster(const char* pszDestFilename)
     return osFormat;
 }
 
+/* -------------------------------------------------------------------- */
+/*                          ParseTileIndex()                            */
+/* -------------------------------------------------------------------- */
+
+// Parses the "i/N" value of the -tile_index option, where i is the 0-based
+// index of the part to produce among N.
+bool ParseTileIndex(const char* pszValue, int& nTileIndex, int& nTileCount)
+{
+    const char* pszSlash = strchr(pszValue, '/');
+    if( pszSlash == nullptr ||
+        CPLGetValueType(std::string(pszValue, pszSlash).c_str()) !=
+            CPL_VALUE_INTEGER ||
+        CPLGetValueType(pszSlash + 1) != CPL_VALUE_INTEGER )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid value for -tile_index: %s. Expected i/N", pszValue);
+        return false;
+    }
+    nTileIndex = atoi(pszValue);
+    nTileCount = atoi(pszSlash + 1);
+    if( nTileCount <= 0 || nTileIndex < 0 || nTileIndex >= nTileCount )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid value for -tile_index: %s. "
+                 "Expected i/N with 0 <= i < N", pszValue);
+        return false;
+    }
+    return true;
+}
+
+/* -------------------------------------------------------------------- */
+/*                       GetTileIndexPartWindow()                       */
+/* -------------------------------------------------------------------- */
+
+// Returns the window of lines of an output of nRasterYSize lines that
+// belongs to part nTileIndex among nTileCount. Parts are full width strips
+// whose height is a multiple of the block height of the output (BLOCKYSIZE
+// or BLOCKSIZE creation option, 512 by default), so that they can be
+// assembled afterwards without re-encoding.
+bool GetTileIndexPartWindow(int nRasterYSize, int nTileIndex, int nTileCount,
+                            CSLConstList papszCreateOptions,
+                            int& nPartYOff, int& nPartYSize)
+{
+    const char* pszBlockYSize =
+        CSLFetchNameValue(papszCreateOptions, "BLOCKYSIZE");
+    if( pszBlockYSize == nullptr )
+        pszBlockYSize = CSLFetchNameValue(papszCreateOptions, "BLOCKSIZE");
+    const int nAlign =
+        std::max(1, pszBlockYSize ? atoi(pszBlockYSize) : 512);
+
+    const GIntBig nMinPartHeight =
+        (static_cast<GIntBig>(nRasterYSize) + nTileCount - 1) / nTileCount;
+    const GIntBig nPartHeight =
+        (nMinPartHeight + nAlign - 1) / nAlign * nAlign;
+    const GIntBig nYOff = nPartHeight * nTileIndex;
+    if( nYOff >= nRasterYSize )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Part %d/%d is empty: the output has %d lines, and parts "
+                 "have " CPL_FRMT_GIB " lines. Use a smaller number of parts "
+                 "or a smaller block height.",
+                 nTileIndex, nTileCount, nRasterYSize, nPartHeight);
+        return false;
+    }
+    nPartYOff = static_cast<int>(nYOff);
+    nPartYSize = static_cast<int>(
+        std::min(nPartHeight, static_cast<GIntBig>(nRasterYSize) - nYOff));
+    return true;
+}
+
 /* -------------------------------------------------------------------- */
 /*                        EarlySetConfigOptions()                       */
 /* -------------------------------------------------------------------- */
@@ -93,6 +93,13 @@ std::vector<CPLString> CPL_DLL GetOutputDriversFor(const char* pszDestFilename,
                                                    int nFlagRasterVector);
 CPLString CPL_DLL GetOutputDriverForRaster(const char* pszDestFilename);
 
+bool CPL_DLL ParseTileIndex(const char* pszValue,
+                            int& nTileIndex, int& nTileCount);
+bool CPL_DLL GetTileIndexPartWindow(int nRasterYSize,
+                                    int nTileIndex, int nTileCount,
+                                    CSLConstList papszCreateOptions,
+                                    int& nPartYOff, int& nPartYSize);
+
 #endif /* __cplusplus */
 
 #endif /* COMMONUTILS_H_INCLUDED */
@@ -0,0 +1,118 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Utilities
+ * Purpose:  Selection of the fastest resampling settings for this machine
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "gdal.h"
+#include "gdal_alg.h"
+
+CPL_CVSID("$Id$")
+
+/************************************************************************/
+/*                               Usage()                                */
+/************************************************************************/
+
+static void Usage()
+{
+    printf("gdal_autotune [-q] [-size <pixels>] [-min_time <seconds>]\n"
+           "              [output_file]\n"
+           "\n"
+           "Benchmarks warping and overview settings, and writes the fastest\n"
+           "ones in output_file (or the file pointed by GDAL_AUTOTUNE_FILE).\n"
+           "Set the GDAL_AUTOTUNE_FILE configuration option to that file to\n"
+           "use them.\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main( int argc, char ** argv )
+
+{
+    GDALAllRegister();
+
+    argc = GDALGeneralCmdLineProcessor(argc, &argv, 0);
+    if( argc < 1 )
+        exit(-argc);
+
+    const char* pszFilename = nullptr;
+    bool bQuiet = false;
+    CPLStringList aosOptions;
+    for( int iArg = 1; iArg < argc; iArg++ )
+    {
+        if( EQUAL(argv[iArg], "-q") || EQUAL(argv[iArg], "-quiet") )
+        {
+            bQuiet = true;
+        }
+        else if( iArg < argc-1 && EQUAL(argv[iArg], "-size") )
+        {
+            aosOptions.SetNameValue("SIZE", argv[++iArg]);
+        }
+        else if( iArg < argc-1 && EQUAL(argv[iArg], "-min_time") )
+        {
+            aosOptions.SetNameValue("MIN_TIME", argv[++iArg]);
+        }
+        else if( argv[iArg][0] == '-' || pszFilename != nullptr )
+        {
+            Usage();
+        }
+        else
+        {
+            pszFilename = argv[iArg];
+        }
+    }
+    if( pszFilename == nullptr &&
+        CPLGetConfigOption("GDAL_AUTOTUNE_FILE", nullptr) == nullptr )
+    {
+        Usage();
+    }
+
+    const CPLErr eErr = GDALAutotune(pszFilename, aosOptions.List(),
+                                     bQuiet ? GDALDummyProgress :
+                                              GDALTermProgress,
+                                     nullptr);
+    if( eErr == CE_None && !bQuiet )
+    {
+        const char* pszOut = pszFilename ? pszFilename :
+                        CPLGetConfigOption("GDAL_AUTOTUNE_FILE", "");
+        char** papszLines = CSLLoad(pszOut);
+        for( int i = 0; papszLines && papszLines[i]; ++i )
+        {
+            if( papszLines[i][0] != '#' )
+                printf("%s\n", papszLines[i]);
+        }
+        CSLDestroy(papszLines);
+    }
+
+    CSLDestroy(argv);
+
+    GDALDestroyDriverManager();
+
+    return eErr == CE_None ? 0 : 1;
+}
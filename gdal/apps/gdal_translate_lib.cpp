@@ -287,6 +287,11 @@ struct GDALTranslateOptions
 
     /*! does not copy source XMP into destination dataset (when TRUE) */
     bool bNoXMP;
+
+    /*! 0-based index of the part to produce among nTileCount full width
+        strips of the output (-tile_index i/N), when nTileCount > 0 */
+    int nTileIndex;
+    int nTileCount;
 };
 
 /************************************************************************/
@@ -1111,7 +1116,7 @@ GDALDatasetH GDALTranslate( const char *pszDest, GDALDatasetH hSrcDataset,
         psOptions->adfSrcWin[3] == GDALGetRasterYSize(hSrcDataset) &&
         psOptions->nOXSizePixel == 0 && psOptions->dfOXSizePct == 0.0 &&
         psOptions->nOYSizePixel == 0 && psOptions->dfOYSizePct == 0.0 &&
-        psOptions->dfXRes == 0.0;
+        psOptions->dfXRes == 0.0 && psOptions->nTileCount == 0;
 
     if( psOptions->eOutputType == GDT_Unknown
         && psOptions->nScaleRepeat == 0 && psOptions->nExponentRepeat == 0 && !psOptions->bUnscale
@@ -1323,6 +1328,39 @@ GDALDatasetH GDALTranslate( const char *pszDest, GDALDatasetH hSrcDataset,
         return nullptr;
     }
 
+/* -------------------------------------------------------------------- */
+/*      With -tile_index, only produce a strip of the output, by        */
+/*      restricting the source window (and the user provided bounds     */
+/*      and GCPs) to the lines of the part.                             */
+/* -------------------------------------------------------------------- */
+    if( psOptions->nTileCount > 0 )
+    {
+        int nPartYOff = 0;
+        int nPartYSize = 0;
+        if( !GetTileIndexPartWindow(nOYSize, psOptions->nTileIndex,
+                                    psOptions->nTileCount,
+                                    psOptions->papszCreateOptions,
+                                    nPartYOff, nPartYSize) )
+        {
+            GDALTranslateOptionsFree(psOptions);
+            return nullptr;
+        }
+        const double dfSrcLinesPerLine = psOptions->adfSrcWin[3] / nOYSize;
+        psOptions->adfSrcWin[1] += nPartYOff * dfSrcLinesPerLine;
+        psOptions->adfSrcWin[3] = nPartYSize * dfSrcLinesPerLine;
+        if( bGotBounds )
+        {
+            const double dfYPerLine =
+                (psOptions->adfULLR[3] - psOptions->adfULLR[1]) / nOYSize;
+            psOptions->adfULLR[1] += nPartYOff * dfYPerLine;
+            psOptions->adfULLR[3] =
+                psOptions->adfULLR[1] + nPartYSize * dfYPerLine;
+        }
+        for( int i = 0; i < psOptions->nGCPCount; i++ )
+            psOptions->pasGCPs[i].dfGCPLine -= nPartYOff;
+        nOYSize = nPartYSize;
+    }
+
     // For gdal_translate_fuzzer
     if( psOptions->nLimitOutSize > 0 )
     {
@@ -2391,6 +2429,8 @@ GDALTranslateOptions *GDALTranslateOptionsNew(char** papszArgv, GDALTranslateOpt
     psOptions->pszProjSRS = nullptr;
     psOptions->nLimitOutSize = 0;
     psOptions->bNoXMP = false;
+    psOptions->nTileIndex = 0;
+    psOptions->nTileCount = 0;
 
     bool bParsedMaskArgument = false;
     bool bOutsideExplicitlySet = false;
@@ -2827,6 +2867,15 @@ GDALTranslateOptions *GDALTranslateOptionsNew(char** papszArgv, GDALTranslateOpt
         {
             psOptions->bNoRAT = true;
         }
+        else if( i+1 < argc && EQUAL(papszArgv[i], "-tile_index") )
+        {
+            if( !ParseTileIndex(papszArgv[++i], psOptions->nTileIndex,
+                                psOptions->nTileCount) )
+            {
+                GDALTranslateOptionsFree(psOptions);
+                return nullptr;
+            }
+        }
         else if( i+1 < argc && EQUAL(papszArgv[i], "-oo") )
         {
             i++;
@@ -41,15 +41,20 @@
 #include <cstring>
 
 #include <algorithm>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 #include <set>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_error_internal.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_vrt.h"
 #include "gdal_priv.h"
@@ -99,6 +104,11 @@ struct DatasetProperty
     int    nMaskBlockYSize = 0;
     std::vector<int> anOverviewFactors{};
 
+    /* Signature of the file, for the -incremental mode */
+    bool   bHasFileSignature = false;
+    GIntBig nFileSize = 0;
+    GIntBig nFileMTime = 0;
+
     DatasetProperty()
     {
         adfGeoTransform[0] = 0;
@@ -122,6 +132,281 @@ struct BandProperty
     bool                   bHasScale = false;
     double                 dfScale = 0;
 };
+
+/************************************************************************/
+/*                            SourceOpenJob                             */
+/************************************************************************/
+
+struct SourceOpenJob
+{
+    std::string            osFilename{};
+    CSLConstList           papszOpenOptions = nullptr;
+    bool                   bStat = false;
+    const DatasetProperty *psCachedProperties = nullptr;
+
+    GDALDatasetH           hDS = nullptr;
+    bool                   bHasFileSignature = false;
+    GIntBig                nFileSize = 0;
+    GIntBig                nFileMTime = 0;
+    bool                   bSignatureMatchesCache = false;
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+    std::atomic<bool>      bDone{false};
+};
+
+/************************************************************************/
+/*                        SourceDatasetOpener                           */
+/*                                                                      */
+/*      Opens the source datasets, in order. When several threads are  */
+/*      available, the next sources are opened ahead in a thread pool,  */
+/*      keeping at most 2 * nThreads of them opened at a time. Errors   */
+/*      emitted while opening are replayed in the calling thread, in    */
+/*      the order of the sources.                                       */
+/************************************************************************/
+
+class SourceDatasetOpener
+{
+    CPL_DISALLOW_COPY_ASSIGN(SourceDatasetOpener)
+
+    CSLConstList        m_papszOpenOptions = nullptr;
+    bool                m_bStat = false;
+    const std::map<std::string, DatasetProperty>& m_oCache;
+    std::unique_ptr<CPLWorkerThreadPool> m_poPool{};
+    int                 m_nMaxPrefetched = 0;
+    int                 m_nNextToSubmit = 0;
+    std::map<int, std::unique_ptr<SourceOpenJob>> m_oPendingJobs{};
+
+    std::unique_ptr<SourceOpenJob> CreateJob(const char* pszFilename) const;
+    static void RunJob(SourceOpenJob* psJob, bool bAccumulateErrors);
+    static void JobFunc(void* pData);
+
+  public:
+    SourceDatasetOpener(int nThreads, CSLConstList papszOpenOptions,
+                        bool bStat,
+                        const std::map<std::string, DatasetProperty>& oCache);
+    ~SourceDatasetOpener();
+
+    std::unique_ptr<SourceOpenJob> Open(int iFile, int nInputFiles,
+                                        const char* const* ppszInputFilenames);
+    static GDALDatasetH OpenDataset(const char* pszFilename,
+                                    CSLConstList papszOpenOptions);
+};
+
+SourceDatasetOpener::SourceDatasetOpener(
+                    int nThreads, CSLConstList papszOpenOptions, bool bStat,
+                    const std::map<std::string, DatasetProperty>& oCache) :
+    m_papszOpenOptions(papszOpenOptions),
+    m_bStat(bStat),
+    m_oCache(oCache)
+{
+    if( nThreads > 1 )
+    {
+        m_poPool.reset(new CPLWorkerThreadPool());
+        if( !m_poPool->Setup(nThreads, nullptr, nullptr) )
+            m_poPool.reset();
+        else
+            m_nMaxPrefetched = 2 * nThreads;
+    }
+}
+
+SourceDatasetOpener::~SourceDatasetOpener()
+{
+    if( m_poPool )
+        m_poPool->WaitCompletion();
+    for( auto& oIter: m_oPendingJobs )
+    {
+        if( oIter.second->hDS )
+            GDALClose(oIter.second->hDS);
+    }
+}
+
+GDALDatasetH SourceDatasetOpener::OpenDataset(const char* pszFilename,
+                                              CSLConstList papszOpenOptions)
+{
+    return GDALOpenEx( pszFilename,
+                       GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR, nullptr,
+                       papszOpenOptions, nullptr );
+}
+
+std::unique_ptr<SourceOpenJob> SourceDatasetOpener::CreateJob(
+                                            const char* pszFilename) const
+{
+    std::unique_ptr<SourceOpenJob> poJob(new SourceOpenJob());
+    poJob->osFilename = pszFilename;
+    poJob->papszOpenOptions = m_papszOpenOptions;
+    poJob->bStat = m_bStat;
+    const auto oIter = m_oCache.find(poJob->osFilename);
+    if( oIter != m_oCache.end() )
+        poJob->psCachedProperties = &(oIter->second);
+    return poJob;
+}
+
+void SourceDatasetOpener::RunJob(SourceOpenJob* psJob, bool bAccumulateErrors)
+{
+    if( bAccumulateErrors )
+        CPLInstallErrorHandlerAccumulator(psJob->aoErrors);
+
+    if( psJob->bStat )
+    {
+        VSIStatBufL sStat;
+        if( VSIStatExL(psJob->osFilename.c_str(), &sStat,
+                       VSI_STAT_EXISTS_FLAG | VSI_STAT_NATURE_FLAG |
+                       VSI_STAT_SIZE_FLAG) == 0 &&
+            VSI_ISREG(sStat.st_mode) )
+        {
+            psJob->bHasFileSignature = true;
+            psJob->nFileSize = static_cast<GIntBig>(sStat.st_size);
+            psJob->nFileMTime = static_cast<GIntBig>(sStat.st_mtime);
+            psJob->bSignatureMatchesCache =
+                psJob->psCachedProperties != nullptr &&
+                psJob->psCachedProperties->nFileSize == psJob->nFileSize &&
+                psJob->psCachedProperties->nFileMTime == psJob->nFileMTime;
+        }
+    }
+
+    // No need to open a source whose analysis can be reused
+    if( !psJob->bSignatureMatchesCache )
+        psJob->hDS = OpenDataset(psJob->osFilename.c_str(),
+                                 psJob->papszOpenOptions);
+
+    if( bAccumulateErrors )
+        CPLUninstallErrorHandlerAccumulator();
+    psJob->bDone = true;
+}
+
+void SourceDatasetOpener::JobFunc(void* pData)
+{
+    RunJob(static_cast<SourceOpenJob*>(pData), true);
+}
+
+std::unique_ptr<SourceOpenJob> SourceDatasetOpener::Open(
+                                    int iFile, int nInputFiles,
+                                    const char* const* ppszInputFilenames)
+{
+    if( !m_poPool )
+    {
+        auto poJob = CreateJob(ppszInputFilenames[iFile]);
+        RunJob(poJob.get(), false);
+        return poJob;
+    }
+
+    // nInputFiles may grow while iterating (subdatasets), hence the lazy
+    // submission of jobs.
+    m_nNextToSubmit = std::max(m_nNextToSubmit, iFile);
+    while( m_nNextToSubmit < nInputFiles &&
+           m_nNextToSubmit < iFile + m_nMaxPrefetched )
+    {
+        auto poJob = CreateJob(ppszInputFilenames[m_nNextToSubmit]);
+        SourceOpenJob* psJob = poJob.get();
+        m_oPendingJobs[m_nNextToSubmit] = std::move(poJob);
+        m_poPool->SubmitJob(JobFunc, psJob);
+        m_nNextToSubmit++;
+    }
+
+    auto oIter = m_oPendingJobs.find(iFile);
+    CPLAssert( oIter != m_oPendingJobs.end() );
+    std::unique_ptr<SourceOpenJob> poJob(std::move(oIter->second));
+    m_oPendingJobs.erase(oIter);
+    while( !poJob->bDone )
+        m_poPool->WaitEvent();
+
+    for( const auto& oError: poJob->aoErrors )
+        CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+    poJob->aoErrors.clear();
+
+    return poJob;
+}
+
+/************************************************************************/
+/*                     Incremental mode cache                           */
+/*                                                                      */
+/*      With -incremental, the analysed properties of the sources are   */
+/*      saved in a <output>.sources_cache side-car file, with the size  */
+/*      and modification time of each source. On a later run with the   */
+/*      same analysis options, unchanged sources are not reopened.      */
+/************************************************************************/
+
+constexpr const char* SOURCES_CACHE_SIGNATURE = "GDALBUILDVRT_SOURCES_CACHE_1";
+
+static CPLString SerializeDatasetProperty(const DatasetProperty& sProp)
+{
+    CPLString osRet;
+    osRet.Printf(CPL_FRMT_GIB "\t" CPL_FRMT_GIB "\t%d %d",
+                 sProp.nFileSize, sProp.nFileMTime,
+                 sProp.nRasterXSize, sProp.nRasterYSize);
+    for( int i = 0; i < 6; i++ )
+        osRet += CPLSPrintf(" %.17g", sProp.adfGeoTransform[i]);
+    osRet += CPLSPrintf(" %d %d %d %d",
+                        sProp.nBlockXSize, sProp.nBlockYSize,
+                        static_cast<int>(sProp.firstBandType),
+                        static_cast<int>(sProp.adfNoDataValues.size()));
+    for( size_t i = 0; i < sProp.adfNoDataValues.size(); i++ )
+    {
+        osRet += CPLSPrintf(" %d %.17g %d %.17g %d %.17g %d",
+                            sProp.abHasNoData[i] ? 1 : 0,
+                            sProp.adfNoDataValues[i],
+                            sProp.abHasOffset[i] ? 1 : 0,
+                            sProp.adfOffset[i],
+                            sProp.abHasScale[i] ? 1 : 0,
+                            sProp.adfScale[i],
+                            sProp.abHasMaskBand[i] ? 1 : 0);
+    }
+    osRet += CPLSPrintf(" %d %d %d %d",
+                        sProp.bHasDatasetMask,
+                        sProp.nMaskBlockXSize, sProp.nMaskBlockYSize,
+                        static_cast<int>(sProp.anOverviewFactors.size()));
+    for( int nFactor: sProp.anOverviewFactors )
+        osRet += CPLSPrintf(" %d", nFactor);
+    return osRet;
+}
+
+static bool DeserializeDatasetProperty(const char* pszSize,
+                                       const char* pszMTime,
+                                       const char* pszProps,
+                                       DatasetProperty& sProp)
+{
+    const CPLStringList aosTokens(CSLTokenizeString2(pszProps, " ", 0));
+    const int nTokens = aosTokens.size();
+    constexpr int BANDS_IDX = 2 + 6 + 3;
+    if( nTokens < BANDS_IDX + 1 )
+        return false;
+    sProp.nFileSize = CPLAtoGIntBig(pszSize);
+    sProp.nFileMTime = CPLAtoGIntBig(pszMTime);
+    sProp.bHasFileSignature = true;
+    sProp.nRasterXSize = atoi(aosTokens[0]);
+    sProp.nRasterYSize = atoi(aosTokens[1]);
+    for( int i = 0; i < 6; i++ )
+        sProp.adfGeoTransform[i] = CPLAtofM(aosTokens[2 + i]);
+    sProp.nBlockXSize = atoi(aosTokens[8]);
+    sProp.nBlockYSize = atoi(aosTokens[9]);
+    sProp.firstBandType = static_cast<GDALDataType>(atoi(aosTokens[10]));
+    const int nBands = atoi(aosTokens[BANDS_IDX]);
+    int iTok = BANDS_IDX + 1;
+    if( nBands <= 0 || nBands > (nTokens - iTok) / 7 )
+        return false;
+    for( int i = 0; i < nBands; i++, iTok += 7 )
+    {
+        sProp.abHasNoData.push_back(atoi(aosTokens[iTok]) != 0);
+        sProp.adfNoDataValues.push_back(CPLAtofM(aosTokens[iTok + 1]));
+        sProp.abHasOffset.push_back(atoi(aosTokens[iTok + 2]) != 0);
+        sProp.adfOffset.push_back(CPLAtofM(aosTokens[iTok + 3]));
+        sProp.abHasScale.push_back(atoi(aosTokens[iTok + 4]) != 0);
+        sProp.adfScale.push_back(CPLAtofM(aosTokens[iTok + 5]));
+        sProp.abHasMaskBand.push_back(atoi(aosTokens[iTok + 6]) != 0);
+    }
+    if( iTok + 4 > nTokens )
+        return false;
+    sProp.bHasDatasetMask = atoi(aosTokens[iTok]);
+    sProp.nMaskBlockXSize = atoi(aosTokens[iTok + 1]);
+    sProp.nMaskBlockYSize = atoi(aosTokens[iTok + 2]);
+    const int nOvrCount = atoi(aosTokens[iTok + 3]);
+    iTok += 4;
+    if( nOvrCount < 0 || nOvrCount != nTokens - iTok )
+        return false;
+    for( int i = 0; i < nOvrCount; i++ )
+        sProp.anOverviewFactors.push_back(atoi(aosTokens[iTok + i]));
+    sProp.isFileOK = TRUE;
+    return true;
+}
 } // namespace
 
 /************************************************************************/
@@ -245,6 +530,7 @@ class VRTBuilder
     char               *pszResampling = nullptr;
     char              **papszOpenOptions = nullptr;
     bool                bUseSrcMaskBand = true;
+    bool                bIncremental = false;
 
     /* Internal variables */
     char               *pszProjectionRef = nullptr;
@@ -266,6 +552,14 @@ class VRTBuilder
 
     int         AnalyseRaster(GDALDatasetH hDS,
                               DatasetProperty* psDatasetProperties);
+    void        AccumulateExtentAndResolution(
+                              const DatasetProperty* psDatasetProperties);
+
+    CPLString   GetSourcesCacheFilename() const;
+    CPLString   GetSourcesCacheKey() const;
+    void        ReadSourcesCache(std::map<std::string, DatasetProperty>& oCache,
+                                 CPLString& osReferenceFile) const;
+    void        WriteSourcesCache(const char* pszReferenceFile) const;
 
     void        CreateVRTSeparate(VRTDatasetH hVRTDS);
     void        CreateVRTNonSeparate(VRTDatasetH hVRTDS);
@@ -286,7 +580,8 @@ class VRTBuilder
                            bool bUseSrcMaskBand,
                            const char* pszOutputSRS,
                            const char* pszResampling,
-                           const char* const* papszOpenOptionsIn );
+                           const char* const* papszOpenOptionsIn,
+                           bool bIncrementalIn );
 
                ~VRTBuilder();
 
@@ -312,7 +607,8 @@ VRTBuilder::VRTBuilder(const char* pszOutputFilenameIn,
                        bool bUseSrcMaskBandIn,
                        const char* pszOutputSRSIn,
                        const char* pszResamplingIn,
-                       const char* const * papszOpenOptionsIn )
+                       const char* const * papszOpenOptionsIn,
+                       bool bIncrementalIn )
 {
     pszOutputFilename = CPLStrdup(pszOutputFilenameIn);
     nInputFiles = nInputFilesIn;
@@ -367,6 +663,7 @@ VRTBuilder::VRTBuilder(const char* pszOutputFilenameIn,
     pszOutputSRS = (pszOutputSRSIn) ? CPLStrdup(pszOutputSRSIn) : nullptr;
     pszResampling = (pszResamplingIn) ? CPLStrdup(pszResamplingIn) : nullptr;
     bUseSrcMaskBand = bUseSrcMaskBandIn;
+    bIncremental = bIncrementalIn;
 }
 
 /************************************************************************/
@@ -565,15 +862,6 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
         nRasterYSize = poDS->GetRasterYSize();
     }
 
-    double ds_minX = padfGeoTransform[GEOTRSFRM_TOPLEFT_X];
-    double ds_maxY = padfGeoTransform[GEOTRSFRM_TOPLEFT_Y];
-    double ds_maxX = ds_minX +
-                GDALGetRasterXSize(hDS) *
-                padfGeoTransform[GEOTRSFRM_WE_RES];
-    double ds_minY = ds_maxY +
-                GDALGetRasterYSize(hDS) *
-                padfGeoTransform[GEOTRSFRM_NS_RES];
-
     int _nBands = GDALGetRasterCount(hDS);
 
     //if provided band list
@@ -689,13 +977,6 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
     {
         if (proj)
             pszProjectionRef = CPLStrdup(proj);
-        if (!bUserExtent)
-        {
-            minX = ds_minX;
-            minY = ds_minY;
-            maxX = ds_maxX;
-            maxY = ds_maxY;
-        }
 
         //if not provided an explicit band list, take the one of the first dataset
         if(nBands == 0)
@@ -892,7 +1173,40 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
 
             }
         }
-        if (!bUserExtent)
+    }
+
+    AccumulateExtentAndResolution(psDatasetProperties);
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                   AccumulateExtentAndResolution()                    */
+/************************************************************************/
+
+void VRTBuilder::AccumulateExtentAndResolution(
+                                const DatasetProperty* psDatasetProperties)
+{
+    const double* padfGeoTransform = psDatasetProperties->adfGeoTransform;
+    const double ds_minX = padfGeoTransform[GEOTRSFRM_TOPLEFT_X];
+    const double ds_maxY = padfGeoTransform[GEOTRSFRM_TOPLEFT_Y];
+    const double ds_maxX = ds_minX +
+                psDatasetProperties->nRasterXSize *
+                padfGeoTransform[GEOTRSFRM_WE_RES];
+    const double ds_minY = ds_maxY +
+                psDatasetProperties->nRasterYSize *
+                padfGeoTransform[GEOTRSFRM_NS_RES];
+
+    if (!bUserExtent)
+    {
+        if (bFirst)
+        {
+            minX = ds_minX;
+            minY = ds_minY;
+            maxX = ds_maxX;
+            maxY = ds_maxY;
+        }
+        else
         {
             if (ds_minX < minX) minX = ds_minX;
             if (ds_minY < minY) minY = ds_minY;
@@ -926,8 +1240,114 @@ int VRTBuilder::AnalyseRaster( GDALDatasetH hDS, DatasetProperty* psDatasetPrope
             ns_res = std::min(ns_res, padfGeoTransform[GEOTRSFRM_NS_RES]);
         }
     }
+}
 
-    return TRUE;
+/************************************************************************/
+/*                       GetSourcesCacheFilename()                      */
+/************************************************************************/
+
+CPLString VRTBuilder::GetSourcesCacheFilename() const
+{
+    return CPLString(pszOutputFilename) + ".sources_cache";
+}
+
+/************************************************************************/
+/*                         GetSourcesCacheKey()                         */
+/*                                                                      */
+/*      Options that influence the analysis of sources: a cache built   */
+/*      with different ones cannot be reused.                           */
+/************************************************************************/
+
+CPLString VRTBuilder::GetSourcesCacheKey() const
+{
+    CPLString osKey;
+    osKey.Printf("%d %d %d %s %d",
+                 bSeparate, bAllowProjectionDifference, nSubdataset,
+                 pszSrcNoData ? pszSrcNoData : "", nMaxBandNo);
+    for( int i = 0; i < nBands; i++ )
+        osKey += CPLSPrintf(" b%d", panBandList[i]);
+    for( CSLConstList papszIter = papszOpenOptions;
+         papszIter && *papszIter; ++papszIter )
+    {
+        osKey += " ";
+        osKey += *papszIter;
+    }
+    osKey.replaceAll('\t', ' ');
+    return osKey;
+}
+
+/************************************************************************/
+/*                          ReadSourcesCache()                          */
+/************************************************************************/
+
+void VRTBuilder::ReadSourcesCache(std::map<std::string, DatasetProperty>& oCache,
+                                  CPLString& osReferenceFile) const
+{
+    VSILFILE* fp = VSIFOpenL(GetSourcesCacheFilename(), "rb");
+    if( fp == nullptr )
+        return;
+
+    const char* pszLine = CPLReadLine2L(fp, -1, nullptr);
+    if( pszLine != nullptr )
+    {
+        const CPLStringList aosHeader(CSLTokenizeString2(pszLine, "\t",
+                                            CSLT_ALLOWEMPTYTOKENS));
+        if( aosHeader.size() == 3 &&
+            strcmp(aosHeader[0], SOURCES_CACHE_SIGNATURE) == 0 &&
+            GetSourcesCacheKey() == aosHeader[1] )
+        {
+            osReferenceFile = aosHeader[2];
+            while( (pszLine = CPLReadLine2L(fp, -1, nullptr)) != nullptr )
+            {
+                const CPLStringList aosTokens(CSLTokenizeString2(pszLine, "\t",
+                                                CSLT_ALLOWEMPTYTOKENS));
+                DatasetProperty sProp;
+                if( aosTokens.size() == 4 &&
+                    DeserializeDatasetProperty(aosTokens[1], aosTokens[2],
+                                               aosTokens[3], sProp) )
+                {
+                    oCache[aosTokens[0]] = std::move(sProp);
+                }
+            }
+        }
+        else
+        {
+            CPLDebug("GDALBuildVRT", "Ignoring %s: built with other options",
+                     GetSourcesCacheFilename().c_str());
+        }
+    }
+    VSIFCloseL(fp);
+}
+
+/************************************************************************/
+/*                         WriteSourcesCache()                          */
+/************************************************************************/
+
+void VRTBuilder::WriteSourcesCache(const char* pszReferenceFile) const
+{
+    VSILFILE* fp = VSIFOpenL(GetSourcesCacheFilename(), "wb");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Warning, CPLE_FileIO, "Cannot create %s",
+                 GetSourcesCacheFilename().c_str());
+        return;
+    }
+    bool bOK = VSIFPrintfL(fp, "%s\t%s\t%s\n", SOURCES_CACHE_SIGNATURE,
+                           GetSourcesCacheKey().c_str(), pszReferenceFile) > 0;
+    for( int i = 0; bOK && i < nInputFiles; i++ )
+    {
+        const DatasetProperty& sProp = asDatasetProperties[i];
+        if( !sProp.isFileOK || !sProp.bHasFileSignature ||
+            strchr(ppszInputFilenames[i], '\t') != nullptr )
+            continue;
+        bOK = VSIFPrintfL(fp, "%s\t%s\n", ppszInputFilenames[i],
+                          SerializeDatasetProperty(sProp).c_str()) > 0;
+    }
+    if( VSIFCloseL(fp) != 0 || !bOK )
+    {
+        CPLError(CE_Warning, CPLE_FileIO, "Error while writing %s",
+                 GetSourcesCacheFilename().c_str());
+    }
 }
 
 /************************************************************************/
@@ -1399,7 +1819,41 @@ GDALDataset* VRTBuilder::Build(GDALProgressFunc pfnProgress, void * pProgressDat
         }
     }
 
+    if( bIncremental && (pahSrcDS != nullptr || bSeparate ||
+                         pszOutputFilename[0] == '\0') )
+    {
+        CPLError(CE_Warning, CPLE_NotSupported,
+                 "-incremental is only supported when building a VRT file "
+                 "from dataset names, without -separate. Ignored");
+        bIncremental = false;
+    }
+
+    // Analysis of the sources of a previous run
+    std::map<std::string, DatasetProperty> oSourcesCache;
+    CPLString osCacheReferenceFile;
+    if( bIncremental )
+        ReadSourcesCache(oSourcesCache, osCacheReferenceFile);
+    bool bUseSourcesCache = false;
+    CPLString osReferenceFile;
+
+    int nThreads = 1;
+    if( pahSrcDS == nullptr )
+    {
+        const char* pszNumThreads =
+            CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+        nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs()
+                                                    : atoi(pszNumThreads);
+        nThreads = std::max(1, std::min(nThreads, nInputFiles));
+    }
+    std::unique_ptr<SourceDatasetOpener> poOpener;
+    if( pahSrcDS == nullptr )
+    {
+        poOpener.reset(new SourceDatasetOpener(nThreads, papszOpenOptions,
+                                               bIncremental, oSourcesCache));
+    }
+
     int nCountValid = 0;
+    int nReusedCount = 0;
     for(int i=0; ppszInputFilenames != nullptr && i<nInputFiles;i++)
     {
         const char* dsFileName = ppszInputFilenames[i];
@@ -1409,21 +1863,59 @@ GDALDataset* VRTBuilder::Build(GDALProgressFunc pfnProgress, void * pProgressDat
             return nullptr;
         }
 
-        GDALDatasetH hDS =
-            (pahSrcDS) ? pahSrcDS[i] :
-                GDALOpenEx( ppszInputFilenames[i],
-                            GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR, nullptr,
-                            papszOpenOptions, nullptr );
         asDatasetProperties[i].isFileOK = FALSE;
 
+        std::unique_ptr<SourceOpenJob> poJob;
+        GDALDatasetH hDS = nullptr;
+        if( pahSrcDS )
+        {
+            hDS = pahSrcDS[i];
+        }
+        else
+        {
+            poJob = poOpener->Open(i, nInputFiles, ppszInputFilenames);
+            hDS = poJob->hDS;
+            poJob->hDS = nullptr;
+
+            if( poJob->bSignatureMatchesCache && bUseSourcesCache )
+            {
+                // Unchanged source, already validated against the same
+                // reference source as in this run.
+                asDatasetProperties[i] = *(poJob->psCachedProperties);
+                if (asDatasetProperties[i].bHasDatasetMask)
+                    bHasDatasetMask = TRUE;
+                AccumulateExtentAndResolution(&asDatasetProperties[i]);
+                nCountValid ++;
+                nReusedCount ++;
+                continue;
+            }
+            if( hDS == nullptr && poJob->bSignatureMatchesCache )
+                hDS = SourceDatasetOpener::OpenDataset(dsFileName,
+                                                       papszOpenOptions);
+        }
+
         if (hDS)
         {
             if (AnalyseRaster( hDS, &asDatasetProperties[i] ))
             {
                 asDatasetProperties[i].isFileOK = TRUE;
                 nCountValid ++;
+                if( bFirst )
+                {
+                    osReferenceFile = dsFileName;
+                    bUseSourcesCache = poJob != nullptr &&
+                        poJob->bSignatureMatchesCache &&
+                        osReferenceFile == osCacheReferenceFile;
+                }
                 bFirst = FALSE;
             }
+            if( poJob )
+            {
+                asDatasetProperties[i].bHasFileSignature =
+                                                poJob->bHasFileSignature;
+                asDatasetProperties[i].nFileSize = poJob->nFileSize;
+                asDatasetProperties[i].nFileMTime = poJob->nFileMTime;
+            }
             if( pahSrcDS == nullptr )
                 GDALClose(hDS);
         }
@@ -1433,6 +1925,13 @@ GDALDataset* VRTBuilder::Build(GDALProgressFunc pfnProgress, void * pProgressDat
                      "Can't open %s. Skipping it", dsFileName);
         }
     }
+    poOpener.reset();
+
+    if( bIncremental )
+    {
+        CPLDebug("GDALBuildVRT", "%d source(s) reused from %s",
+                 nReusedCount, GetSourcesCacheFilename().c_str());
+    }
 
     if (nCountValid == 0)
         return nullptr;
@@ -1498,6 +1997,9 @@ GDALDataset* VRTBuilder::Build(GDALProgressFunc pfnProgress, void * pProgressDat
         CreateVRTNonSeparate(hVRTDS);
     }
 
+    if( bIncremental )
+        WriteSourcesCache(osReferenceFile);
+
     return static_cast<GDALDataset*>(hVRTDS);
 }
 
@@ -1622,6 +2124,7 @@ struct GDALBuildVRTOptions
     char* pszResampling;
     char** papszOpenOptions;
     bool bUseSrcMaskBand;
+    bool bIncremental;
 
     /*! allow or suppress progress monitor and other non-error output */
     int bQuiet;
@@ -1768,7 +2271,8 @@ GDALDatasetH GDALBuildVRT( const char *pszDest,
                         psOptions->pszSrcNoData, psOptions->pszVRTNoData,
                         psOptions->bUseSrcMaskBand,
                         psOptions->pszOutputSRS, psOptions->pszResampling,
-                        psOptions->papszOpenOptions);
+                        psOptions->papszOpenOptions,
+                        psOptions->bIncremental);
 
     GDALDatasetH hDstDS =
         static_cast<GDALDatasetH>(oBuilder.Build(psOptions->pfnProgress, psOptions->pProgressData));
@@ -2016,6 +2520,10 @@ GDALBuildVRTOptions *GDALBuildVRTOptionsNew(char** papszArgv,
         {
             psOptions->bUseSrcMaskBand = false;
         }
+        else if( EQUAL(papszArgv[iArg],"-incremental") )
+        {
+            psOptions->bIncremental = true;
+        }
         else if( papszArgv[iArg][0] == '-' )
         {
             CPLError(CE_Failure, CPLE_NotSupported,
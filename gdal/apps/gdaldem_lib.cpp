@@ -108,14 +108,19 @@
 #endif
 
 #include <algorithm>
+#include <climits>
 #include <limits>
+#include <memory>
+#include <vector>
 
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_priv.h"
+#include "gdal_thread_pool.h"
 
 #if defined(__SSE2__) || defined(_M_X64)
 #define HAVE_16_SSE_REG
@@ -179,6 +184,8 @@ struct GDALDEMProcessingOptions
     bool bMultiDirectional = false;
     char** papszCreateOptions = nullptr;
     int nBand = 1;
+    /*! number of threads (0 = value of GDAL_NUM_THREADS) */
+    int nNumThreads = 0;
 };
 
 /************************************************************************/
@@ -298,6 +305,361 @@ GInt32 INTERPOL(GInt32 a, GInt32 b, int bSrcHasNoData, GInt32 fSrcNoDataValue)
     return nVal;
 }
 
+/************************************************************************/
+/*                      GDALGeneric3x3Params                            */
+/************************************************************************/
+
+// Parameters shared by all the lines processed by GDALGeneric3x3Processing().
+template<class T>
+struct GDALGeneric3x3Params
+{
+    typename GDALGeneric3x3ProcessingAlg<T>::type pfnAlg = nullptr;
+    typename GDALGeneric3x3ProcessingAlg_multisample<T>::type
+                                            pfnAlg_multisample = nullptr;
+    void *pData = nullptr;
+    bool bComputeAtEdges = false;
+    bool bSrcHasNoData = false;
+    bool bIsSrcNoDataNan = false;
+    T fSrcNoDataValue = 0;
+    float fDstNoDataValue = 0.0f;
+};
+
+/************************************************************************/
+/*                   GDALGeneric3x3LineHasNoData()                      */
+/************************************************************************/
+
+template<class T>
+static bool GDALGeneric3x3LineHasNoData( const T* pafLine, int nXSize,
+                                         T fSrcNoDataValue )
+{
+    int iX = 0;
+    for( ; iX + 3 < nXSize; iX +=4 )
+    {
+        if( pafLine[iX] == fSrcNoDataValue ||
+            pafLine[iX + 1] == fSrcNoDataValue ||
+            pafLine[iX + 2] == fSrcNoDataValue ||
+            pafLine[iX + 3] == fSrcNoDataValue )
+        {
+            return true;
+        }
+    }
+    for( ; iX < nXSize; iX++ )
+    {
+        if( pafLine[iX] == fSrcNoDataValue )
+            return true;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                    GDALGeneric3x3ProcessLine()                       */
+/************************************************************************/
+
+// Computes one output line that is neither the first nor the last line of
+// the raster, from the source lines located at nLine1Off, nLine2Off and
+// nLine3Off in pafWin.
+template<class T>
+static void GDALGeneric3x3ProcessLine( const T* pafWin,
+                                       int nLine1Off,
+                                       int nLine2Off,
+                                       int nLine3Off,
+                                       int nXSize,
+                                       const GDALGeneric3x3Params<T>& sParams,
+                                       bool bOneOfThreeLinesHasNoData,
+                                       float* pafOutputBuf )
+{
+    const bool bSrcHasNoData = sParams.bSrcHasNoData;
+    const T fSrcNoDataValue = sParams.fSrcNoDataValue;
+    const float fDstNoDataValue = sParams.fDstNoDataValue;
+    const bool bComputeAtEdges = sParams.bComputeAtEdges;
+
+    if( bComputeAtEdges && nXSize >= 2 )
+    {
+        int j = 0;
+        T afWin[9] = {
+            INTERPOL(pafWin[nLine1Off + j],
+                     pafWin[nLine1Off + j+1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafWin[nLine1Off + j],
+            pafWin[nLine1Off + j+1],
+            INTERPOL(pafWin[nLine2Off + j],
+                     pafWin[nLine2Off + j+1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafWin[nLine2Off + j],
+            pafWin[nLine2Off + j+1],
+            INTERPOL(pafWin[nLine3Off + j],
+                     pafWin[nLine3Off + j+1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafWin[nLine3Off + j],
+            pafWin[nLine3Off + j+1]
+        };
+
+        pafOutputBuf[j] =
+            ComputeVal(
+                bOneOfThreeLinesHasNoData,
+                fSrcNoDataValue,
+                sParams.bIsSrcNoDataNan,
+                afWin, fDstNoDataValue,
+                sParams.pfnAlg, sParams.pData, bComputeAtEdges);
+    }
+    else
+    {
+        // Exclude the edges
+        pafOutputBuf[0] = fDstNoDataValue;
+    }
+
+    int j = 1;
+    if( sParams.pfnAlg_multisample && !bOneOfThreeLinesHasNoData )
+    {
+        j = sParams.pfnAlg_multisample(pafWin,
+                                       nLine1Off,
+                                       nLine2Off,
+                                       nLine3Off,
+                                       nXSize,
+                                       sParams.pData,
+                                       pafOutputBuf);
+    }
+
+    for( ; j < nXSize - 1; j++ )
+    {
+        T afWin[9] = {
+            pafWin[nLine1Off + j-1],
+            pafWin[nLine1Off + j],
+            pafWin[nLine1Off + j+1],
+            pafWin[nLine2Off + j-1],
+            pafWin[nLine2Off + j],
+            pafWin[nLine2Off + j+1],
+            pafWin[nLine3Off + j-1],
+            pafWin[nLine3Off + j],
+            pafWin[nLine3Off + j+1]
+        };
+
+        pafOutputBuf[j] =
+            ComputeVal(
+                bOneOfThreeLinesHasNoData,
+                fSrcNoDataValue,
+                sParams.bIsSrcNoDataNan,
+                afWin, fDstNoDataValue,
+                sParams.pfnAlg, sParams.pData, bComputeAtEdges);
+    }
+
+    if( bComputeAtEdges && nXSize >= 2 )
+    {
+        j = nXSize - 1;
+
+        T afWin[9] = {
+            pafWin[nLine1Off + j-1],
+            pafWin[nLine1Off + j],
+            INTERPOL(pafWin[nLine1Off + j],
+                     pafWin[nLine1Off + j-1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafWin[nLine2Off + j-1],
+            pafWin[nLine2Off + j],
+            INTERPOL(pafWin[nLine2Off + j],
+                     pafWin[nLine2Off + j-1],
+                     bSrcHasNoData, fSrcNoDataValue),
+            pafWin[nLine3Off + j-1],
+            pafWin[nLine3Off + j],
+            INTERPOL(pafWin[nLine3Off + j],
+                     pafWin[nLine3Off + j-1],
+                     bSrcHasNoData, fSrcNoDataValue)
+        };
+
+        pafOutputBuf[j] =
+            ComputeVal(
+                bOneOfThreeLinesHasNoData,
+                fSrcNoDataValue,
+                sParams.bIsSrcNoDataNan,
+                afWin, fDstNoDataValue,
+                sParams.pfnAlg, sParams.pData, bComputeAtEdges);
+    }
+    else
+    {
+        // Exclude the edges
+        if( nXSize > 1 )
+            pafOutputBuf[nXSize - 1] = fDstNoDataValue;
+    }
+}
+
+/************************************************************************/
+/*                 GDALGeneric3x3ProcessInteriorLines()                 */
+/************************************************************************/
+
+namespace {
+template<class T>
+struct GDALGeneric3x3LinesJob
+{
+    const GDALGeneric3x3Params<T>* psParams = nullptr;
+    // Chunk source buffer, starting with the line above the first output
+    // line of the chunk.
+    const T* pafSrcChunk = nullptr;
+    // Whether each line of pafSrcChunk has a nodata value.
+    const bool* pabLineHasNoData = nullptr;
+    float* pafDstChunk = nullptr;
+    int nXSize = 0;
+    // Range of output lines of the chunk processed by this job.
+    int iStartLine = 0;
+    int iEndLine = 0;
+
+    static void Run(void* pData);
+};
+
+template<class T>
+void GDALGeneric3x3LinesJob<T>::Run(void* pData)
+{
+    const auto psJob = static_cast<const GDALGeneric3x3LinesJob<T>*>(pData);
+    const int nXSize = psJob->nXSize;
+    for( int iLine = psJob->iStartLine; iLine < psJob->iEndLine; iLine++ )
+    {
+        // Output line iLine of the chunk is at source line iLine + 1.
+        bool bOneOfThreeLinesHasNoData = psJob->psParams->bSrcHasNoData;
+        if( psJob->pabLineHasNoData )
+        {
+            bOneOfThreeLinesHasNoData =
+                psJob->pabLineHasNoData[iLine] ||
+                psJob->pabLineHasNoData[iLine + 1] ||
+                psJob->pabLineHasNoData[iLine + 2];
+        }
+        GDALGeneric3x3ProcessLine(psJob->pafSrcChunk,
+                                  iLine * nXSize,
+                                  (iLine + 1) * nXSize,
+                                  (iLine + 2) * nXSize,
+                                  nXSize, *(psJob->psParams),
+                                  bOneOfThreeLinesHasNoData,
+                                  psJob->pafDstChunk +
+                                    static_cast<size_t>(iLine) * nXSize);
+    }
+}
+} // namespace
+
+// Multi-threaded computation of the lines 1 to nYSize - 2, by chunks of
+// lines. Each chunk is read with a halo of one line above and below, its
+// lines are computed concurrently, and it is written at once.
+template<class T>
+static CPLErr GDALGeneric3x3ProcessInteriorLines(
+    GDALRasterBandH hSrcBand,
+    GDALRasterBandH hDstBand,
+    GDALDataType eReadDT,
+    const GDALGeneric3x3Params<T>& sParams,
+    CPLJobQueue* poJobQueue,
+    int nThreads,
+    GDALProgressFunc pfnProgress,
+    void *pProgressData )
+{
+    const int nXSize = GDALGetRasterBandXSize(hSrcBand);
+    const int nYSize = GDALGetRasterBandYSize(hSrcBand);
+    const int nInteriorLines = nYSize - 2;
+
+    // Bound the source and destination chunk buffers to 64 MB, and keep
+    // offsets within the chunk source buffer in the int range.
+    constexpr GIntBig knMaxChunkBytes = 64 * 1024 * 1024;
+    const GIntBig nMaxLines = std::min(
+        knMaxChunkBytes / (static_cast<GIntBig>(nXSize) *
+                           static_cast<GIntBig>(sizeof(T) + sizeof(float))),
+        static_cast<GIntBig>(INT_MAX / nXSize)) - 2;
+    const int nChunkLines = static_cast<int>(std::max(
+        static_cast<GIntBig>(1),
+        std::min(static_cast<GIntBig>(nInteriorLines), nMaxLines)));
+
+    T *pafSrcChunk = static_cast<T *>(
+        VSI_MALLOC3_VERBOSE(sizeof(T), nChunkLines + 2, nXSize));
+    float *pafDstChunk = static_cast<float *>(
+        VSI_MALLOC3_VERBOSE(sizeof(float), nChunkLines, nXSize));
+    if( pafSrcChunk == nullptr || pafDstChunk == nullptr )
+    {
+        VSIFree(pafSrcChunk);
+        VSIFree(pafDstChunk);
+        return CE_Failure;
+    }
+
+    const bool bCheckLineNoData =
+        std::numeric_limits<T>::is_integer && sParams.bSrcHasNoData;
+    std::unique_ptr<bool[]> pabLineHasNoData;
+    if( bCheckLineNoData )
+        pabLineHasNoData.reset(new bool[nChunkLines + 2]);
+
+    std::vector<GDALGeneric3x3LinesJob<T>> asJobs(nThreads);
+
+    CPLErr eErr = CE_None;
+    for( int iChunkStart = 1; iChunkStart <= nInteriorLines;
+         iChunkStart += nChunkLines )
+    {
+        const int nLines = std::min(nChunkLines,
+                                    nInteriorLines + 1 - iChunkStart);
+
+        // Lines iChunkStart - 1 and iChunkStart were the last two source
+        // lines of the previous chunk.
+        int nLinesToRead = nLines + 2;
+        int iFirstLineToRead = iChunkStart - 1;
+        if( iChunkStart > 1 )
+        {
+            memmove(pafSrcChunk,
+                    pafSrcChunk + static_cast<size_t>(nChunkLines) * nXSize,
+                    2 * sizeof(T) * nXSize);
+            if( bCheckLineNoData )
+            {
+                pabLineHasNoData[0] = pabLineHasNoData[nChunkLines];
+                pabLineHasNoData[1] = pabLineHasNoData[nChunkLines + 1];
+            }
+            nLinesToRead -= 2;
+            iFirstLineToRead += 2;
+        }
+        const int iFirstLineInChunk = iFirstLineToRead - (iChunkStart - 1);
+        eErr = GDALRasterIO(hSrcBand, GF_Read,
+                            0, iFirstLineToRead, nXSize, nLinesToRead,
+                            pafSrcChunk +
+                                static_cast<size_t>(iFirstLineInChunk) * nXSize,
+                            nXSize, nLinesToRead, eReadDT, 0, 0);
+        if( eErr != CE_None )
+            break;
+
+        if( bCheckLineNoData )
+        {
+            for( int iLine = iFirstLineInChunk; iLine < nLines + 2; iLine++ )
+            {
+                pabLineHasNoData[iLine] = GDALGeneric3x3LineHasNoData(
+                    pafSrcChunk + static_cast<size_t>(iLine) * nXSize,
+                    nXSize, sParams.fSrcNoDataValue);
+            }
+        }
+
+        const int nJobs = std::min(nThreads, nLines);
+        for( int iJob = 0; iJob < nJobs; iJob++ )
+        {
+            GDALGeneric3x3LinesJob<T>& sJob = asJobs[iJob];
+            sJob.psParams = &sParams;
+            sJob.pafSrcChunk = pafSrcChunk;
+            sJob.pabLineHasNoData = pabLineHasNoData.get();
+            sJob.pafDstChunk = pafDstChunk;
+            sJob.nXSize = nXSize;
+            sJob.iStartLine = static_cast<int>(
+                static_cast<GIntBig>(iJob) * nLines / nJobs);
+            sJob.iEndLine = static_cast<int>(
+                static_cast<GIntBig>(iJob + 1) * nLines / nJobs);
+            poJobQueue->SubmitJob(GDALGeneric3x3LinesJob<T>::Run, &sJob);
+        }
+        poJobQueue->WaitCompletion();
+
+        eErr = GDALRasterIO(hDstBand, GF_Write,
+                            0, iChunkStart, nXSize, nLines,
+                            pafDstChunk, nXSize, nLines, GDT_Float32, 0, 0);
+        if( eErr != CE_None )
+            break;
+
+        if( !pfnProgress( 1.0 * (iChunkStart + nLines) / nYSize, nullptr,
+                          pProgressData ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+            break;
+        }
+    }
+
+    VSIFree(pafSrcChunk);
+    VSIFree(pafDstChunk);
+    return eErr;
+}
+
 /************************************************************************/
 /*                  GDALGeneric3x3Processing()                          */
 /************************************************************************/
@@ -311,6 +673,7 @@ CPLErr GDALGeneric3x3Processing(
     typename GDALGeneric3x3ProcessingAlg_multisample<T>::type pfnAlg_multisample,
     void *pData,
     bool bComputeAtEdges,
+    int nThreads,
     GDALProgressFunc pfnProgress,
     void *pProgressData )
 {
@@ -389,6 +752,24 @@ CPLErr GDALGeneric3x3Processing(
     if( !bDstHasNoData )
         fDstNoDataValue = 0.0;
 
+    GDALGeneric3x3Params<T> sParams;
+    sParams.pfnAlg = pfnAlg;
+    sParams.pfnAlg_multisample = pfnAlg_multisample;
+    sParams.pData = pData;
+    sParams.bComputeAtEdges = bComputeAtEdges;
+    sParams.bSrcHasNoData = CPL_TO_BOOL(bSrcHasNoData);
+    sParams.bIsSrcNoDataNan = CPL_TO_BOOL(bIsSrcNoDataNan);
+    sParams.fSrcNoDataValue = fSrcNoDataValue;
+    sParams.fDstNoDataValue = fDstNoDataValue;
+
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    if( nThreads > 1 && nYSize > 3 )
+    {
+        CPLWorkerThreadPool *poThreadPool = GDALGetGlobalThreadPool(nThreads);
+        if( poThreadPool )
+            poJobQueue = poThreadPool->CreateJobQueue();
+    }
+
     int nLine1Off = 0;
     int nLine2Off = nXSize;
     int nLine3Off = 2*nXSize;
@@ -501,6 +882,30 @@ CPLErr GDALGeneric3x3Processing(
     }
 
     int i = 1;  // Used after for.
+    if( poJobQueue )
+    {
+        eErr = GDALGeneric3x3ProcessInteriorLines(hSrcBand, hDstBand, eReadDT,
+                                                  sParams, poJobQueue.get(),
+                                                  nThreads,
+                                                  pfnProgress, pProgressData);
+        if( eErr == CE_None && bComputeAtEdges && nXSize >= 2 )
+        {
+            // Reload the last two lines for the computation of the last one.
+            nLine1Off = 0;
+            nLine2Off = nXSize;
+            eErr = GDALRasterIO(hSrcBand, GF_Read,
+                                0, nYSize - 2, nXSize, 2,
+                                pafThreeLineWin, nXSize, 2, eReadDT, 0, 0);
+        }
+        if( eErr != CE_None )
+        {
+            CPLFree(pafOutputBuf);
+            CPLFree(pafThreeLineWin);
+
+            return eErr;
+        }
+        i = nYSize - 1;
+    }
     for( ; i < nYSize-1; i++ )
     {
         /* Read third line of the line buffer */
@@ -525,142 +930,20 @@ CPLErr GDALGeneric3x3Processing(
         bool bOneOfThreeLinesHasNoData = CPL_TO_BOOL(bSrcHasNoData);
         if( std::numeric_limits<T>::is_integer && bSrcHasNoData )
         {
-            bool bLastLineHasNoDataValue = false;
-            int iX = 0;
-            for( ; iX + 3 < nXSize; iX +=4 )
-            {
-                if( pafThreeLineWin[nLine3Off + iX] == fSrcNoDataValue ||
-                    pafThreeLineWin[nLine3Off + iX + 1] == fSrcNoDataValue ||
-                    pafThreeLineWin[nLine3Off + iX + 2] == fSrcNoDataValue ||
-                    pafThreeLineWin[nLine3Off + iX + 3] == fSrcNoDataValue )
-                {
-                    bLastLineHasNoDataValue = true;
-                    break;
-                }
-            }
-            if( !bLastLineHasNoDataValue )
-            {
-                for( ; iX < nXSize; iX++ )
-                {
-                    if( pafThreeLineWin[nLine3Off + iX] == fSrcNoDataValue )
-                    {
-                        bLastLineHasNoDataValue = true;
-                    }
-                }
-            }
-            abLineHasNoDataValue[nLine3Off / nXSize] = bLastLineHasNoDataValue;
+            abLineHasNoDataValue[nLine3Off / nXSize] =
+                GDALGeneric3x3LineHasNoData(pafThreeLineWin + nLine3Off,
+                                            nXSize, fSrcNoDataValue);
 
             bOneOfThreeLinesHasNoData = abLineHasNoDataValue[0] ||
                                 abLineHasNoDataValue[1] ||
                                 abLineHasNoDataValue[2];
         }
 
-        if( bComputeAtEdges && nXSize >= 2 )
-        {
-            int j = 0;
-            T afWin[9] = {
-                INTERPOL(pafThreeLineWin[nLine1Off + j],
-                         pafThreeLineWin[nLine1Off + j+1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine1Off + j],
-                pafThreeLineWin[nLine1Off + j+1],
-                INTERPOL(pafThreeLineWin[nLine2Off + j],
-                         pafThreeLineWin[nLine2Off + j+1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine2Off + j],
-                pafThreeLineWin[nLine2Off + j+1],
-                INTERPOL(pafThreeLineWin[nLine3Off + j],
-                         pafThreeLineWin[nLine3Off + j+1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine3Off + j],
-                pafThreeLineWin[nLine3Off + j+1]
-            };
-
-            pafOutputBuf[j] =
-                ComputeVal(
-                    CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
-                    fSrcNoDataValue,
-                    CPL_TO_BOOL(bIsSrcNoDataNan),
-                    afWin, fDstNoDataValue,
-                    pfnAlg, pData, bComputeAtEdges);
-        }
-        else
-        {
-            // Exclude the edges
-            pafOutputBuf[0] = fDstNoDataValue;
-        }
-
-        int j = 1;
-        if( pfnAlg_multisample && !bOneOfThreeLinesHasNoData )
-        {
-            j = pfnAlg_multisample(pafThreeLineWin,
-                                   nLine1Off,
-                                   nLine2Off,
-                                   nLine3Off,
-                                   nXSize,
-                                   pData,
-                                   pafOutputBuf);
-        }
-
-        for( ; j < nXSize - 1; j++ )
-        {
-            T afWin[9] = {
-                pafThreeLineWin[nLine1Off + j-1],
-                pafThreeLineWin[nLine1Off + j],
-                pafThreeLineWin[nLine1Off + j+1],
-                pafThreeLineWin[nLine2Off + j-1],
-                pafThreeLineWin[nLine2Off + j],
-                pafThreeLineWin[nLine2Off + j+1],
-                pafThreeLineWin[nLine3Off + j-1],
-                pafThreeLineWin[nLine3Off + j],
-                pafThreeLineWin[nLine3Off + j+1]
-            };
-
-            pafOutputBuf[j] =
-                ComputeVal(
-                    CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
-                    fSrcNoDataValue,
-                    CPL_TO_BOOL(bIsSrcNoDataNan),
-                    afWin, fDstNoDataValue,
-                    pfnAlg, pData, bComputeAtEdges);
-        }
-
-        if( bComputeAtEdges && nXSize >= 2 )
-        {
-            j = nXSize - 1;
-
-            T afWin[9] = {
-                pafThreeLineWin[nLine1Off + j-1],
-                pafThreeLineWin[nLine1Off + j],
-                INTERPOL(pafThreeLineWin[nLine1Off + j],
-                         pafThreeLineWin[nLine1Off + j-1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine2Off + j-1],
-                pafThreeLineWin[nLine2Off + j],
-                INTERPOL(pafThreeLineWin[nLine2Off + j],
-                         pafThreeLineWin[nLine2Off + j-1],
-                         bSrcHasNoData, fSrcNoDataValue),
-                pafThreeLineWin[nLine3Off + j-1],
-                pafThreeLineWin[nLine3Off + j],
-                INTERPOL(pafThreeLineWin[nLine3Off + j],
-                         pafThreeLineWin[nLine3Off + j-1],
-                         bSrcHasNoData, fSrcNoDataValue)
-            };
-
-            pafOutputBuf[j] =
-                ComputeVal(
-                    CPL_TO_BOOL(bOneOfThreeLinesHasNoData),
-                    fSrcNoDataValue,
-                    CPL_TO_BOOL(bIsSrcNoDataNan),
-                    afWin, fDstNoDataValue,
-                    pfnAlg, pData, bComputeAtEdges);
-        }
-        else
-        {
-            // Exclude the edges
-            if( nXSize > 1 )
-                pafOutputBuf[nXSize - 1] = fDstNoDataValue;
-        }
+        GDALGeneric3x3ProcessLine(pafThreeLineWin,
+                                  nLine1Off, nLine2Off, nLine3Off,
+                                  nXSize, sParams,
+                                  bOneOfThreeLinesHasNoData,
+                                  pafOutputBuf);
 
         /* -----------------------------------------
          * Write Line to Raster
@@ -3900,6 +4183,16 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
         if( bDstHasNoData )
             GDALSetRasterNoDataValue(hDstBand, dfDstNoDataValue);
 
+        int nNumThreads = psOptions->nNumThreads;
+        if( nNumThreads == 0 )
+        {
+            const char* pszNumThreads =
+                CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+            nNumThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                CPLGetNumCPUs() : atoi(pszNumThreads);
+        }
+        nNumThreads = std::max(1, std::min(128, nNumThreads));
+
         if( eSrcDT == GDT_Byte || eSrcDT == GDT_Int16 || eSrcDT == GDT_UInt16 )
         {
             GDALGeneric3x3Processing<GInt32>(hSrcBand, hDstBand,
@@ -3907,6 +4200,7 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
                                              pfnAlgInt32_multisample,
                                              pData,
                                              psOptions->bComputeAtEdges,
+                                             nNumThreads,
                                              pfnProgress, pProgressData);
         }
         else
@@ -3916,6 +4210,7 @@ GDALDatasetH GDALDEMProcessing( const char *pszDest,
                                             nullptr,
                                             pData,
                                             psOptions->bComputeAtEdges,
+                                            nNumThreads,
                                             pfnProgress, pProgressData);
         }
     }
@@ -4131,6 +4426,26 @@ GDALDEMProcessingOptions *GDALDEMProcessingOptionsNew(
         {
             psOptions->bComputeAtEdges = true;
         }
+        else if( EQUAL(papszArgv[i], "-num_threads") && i + 1 < argc )
+        {
+            ++i;
+            if( EQUAL(papszArgv[i], "ALL_CPUS") )
+            {
+                psOptions->nNumThreads = CPLGetNumCPUs();
+            }
+            else
+            {
+                psOptions->nNumThreads = atoi(papszArgv[i]);
+                if( psOptions->nNumThreads <= 0 )
+                {
+                    CPLError(CE_Failure, CPLE_IllegalArg,
+                             "Invalid value for -num_threads: %s",
+                             papszArgv[i]);
+                    GDALDEMProcessingOptionsFree(psOptions);
+                    return nullptr;
+                }
+            }
+        }
         else if( i + 1 < argc &&
             (EQUAL(papszArgv[i], "--b") ||
              EQUAL(papszArgv[i], "-b"))
@@ -125,6 +125,10 @@ struct GDALInfoOptions
     /*! display the file list or the first file of the file list */
     int bShowFileList;
 
+    /*! report the block cache statistics of each band and the performance
+        counters */
+    int bReportPerfCounters;
+
     /*! report metadata for the specified domains. "all" can be used to report
         metadata in all domains.
         */
@@ -241,6 +245,9 @@ char *GDALInfo( GDALDatasetH hDataset, const GDALInfoOptions *psOptions )
 
     const bool bJson = psOptions->eFormat == GDALINFO_FORMAT_JSON;
 
+    if( psOptions->bReportPerfCounters )
+        GDALDatasetEnableRasterIOLatencyStats(hDataset);
+
 /* -------------------------------------------------------------------- */
 /*      Report general info.                                            */
 /* -------------------------------------------------------------------- */
@@ -888,6 +895,34 @@ char *GDALInfo( GDALDatasetH hDataset, const GDALInfoOptions *psOptions )
         double dfMaxStat = 0.0;
         double dfMean = 0.0;
         double dfStdDev = 0.0;
+
+        // When both statistics and histogram are requested on a 8 or 16 bit
+        // integer band that has no statistics yet, fetch the histogram first:
+        // the default histogram then computes exact statistics in the same
+        // pass over the data.
+        bool bHistogramFetched = false;
+        CPLErr eHistErr = CE_None;
+        double dfHistMin = 0.0;
+        double dfHistMax = 0.0;
+        int nBucketCount = 0;
+        GUIntBig *panHistogram = nullptr;
+        const GDALDataType eBandDT = GDALGetRasterDataType(hBand);
+        if( psOptions->bReportHistograms && psOptions->bStats &&
+            (eBandDT == GDT_Byte || eBandDT == GDT_Int16 ||
+             eBandDT == GDT_UInt16) &&
+            GDALGetRasterStatistics( hBand, psOptions->bApproxStats, FALSE,
+                                     &dfMinStat, &dfMaxStat,
+                                     &dfMean, &dfStdDev ) != CE_None )
+        {
+            bHistogramFetched = true;
+            eHistErr = GDALGetDefaultHistogramEx( hBand, &dfHistMin, &dfHistMax,
+                                                  &nBucketCount, &panHistogram,
+                                                  TRUE,
+                                                  bJson ? GDALDummyProgress :
+                                                          GDALTermProgress,
+                                                  nullptr );
+        }
+
         CPLErr eErr = GDALGetRasterStatistics( hBand, psOptions->bApproxStats,
                                                psOptions->bStats,
                                                &dfMinStat, &dfMaxStat,
@@ -922,10 +957,13 @@ char *GDALInfo( GDALDatasetH hDataset, const GDALInfoOptions *psOptions )
 
         if( psOptions->bReportHistograms )
         {
-            int nBucketCount = 0;
-            GUIntBig *panHistogram = nullptr;
-
-            if( bJson )
+            if( bHistogramFetched )
+            {
+                eErr = eHistErr;
+                dfMinStat = dfHistMin;
+                dfMaxStat = dfHistMax;
+            }
+            else if( bJson )
                 eErr = GDALGetDefaultHistogramEx( hBand, &dfMinStat, &dfMaxStat,
                                                   &nBucketCount, &panHistogram,
                                                   TRUE, GDALDummyProgress,
@@ -1418,10 +1456,122 @@ char *GDALInfo( GDALDatasetH hDataset, const GDALInfoOptions *psOptions )
                 CPLFree( pszXMLText );
             }
         }
+        if( psOptions->bReportPerfCounters )
+        {
+            GDALCacheStatistics sStats;
+            if( GDALGetRasterBandCacheStatistics(hBand, &sStats) == CE_None )
+            {
+                if( bJson )
+                {
+                    json_object *poBlockCache = json_object_new_object();
+                    json_object_object_add(poBlockCache, "hits",
+                                    json_object_new_int64(sStats.nHits));
+                    json_object_object_add(poBlockCache, "misses",
+                                    json_object_new_int64(sStats.nMisses));
+                    json_object_object_add(poBlockCache, "evictions",
+                                    json_object_new_int64(sStats.nEvictions));
+                    json_object_object_add(poBlockCache, "dirtyFlushes",
+                                    json_object_new_int64(sStats.nDirtyFlushes));
+                    json_object_object_add(poBand, "blockCache", poBlockCache);
+                }
+                else
+                {
+                    Concat(osStr, psOptions->bStdoutOutput,
+                           "  Block Cache: Hits=" CPL_FRMT_GIB
+                           ", Misses=" CPL_FRMT_GIB
+                           ", Evictions=" CPL_FRMT_GIB
+                           ", Dirty Flushes=" CPL_FRMT_GIB "\n",
+                           sStats.nHits, sStats.nMisses,
+                           sStats.nEvictions, sStats.nDirtyFlushes);
+                }
+            }
+        }
+
         if(bJson)
             json_object_array_add(poBands, poBand);
     }
 
+/* -------------------------------------------------------------------- */
+/*      Report performance counters, once everything has been read.     */
+/* -------------------------------------------------------------------- */
+    if( psOptions->bReportPerfCounters )
+    {
+        char** papszCounters = GDALGetPerfCounters();
+        json_object *poCounters = bJson ? json_object_new_object() : nullptr;
+        if( !bJson )
+            Concat(osStr, psOptions->bStdoutOutput, "Performance Counters:\n");
+        for( char** papszIter = papszCounters;
+             papszIter && *papszIter; ++papszIter )
+        {
+            if( bJson )
+            {
+                char* pszKey = nullptr;
+                const char* pszValue = CPLParseNameValue(*papszIter, &pszKey);
+                if( pszKey && pszValue )
+                {
+                    json_object_object_add(poCounters, pszKey,
+                        json_object_new_int64(CPLAtoGIntBig(pszValue)));
+                }
+                CPLFree(pszKey);
+            }
+            else
+            {
+                Concat(osStr, psOptions->bStdoutOutput, "  %s\n", *papszIter);
+            }
+        }
+        CSLDestroy(papszCounters);
+        if( bJson )
+            json_object_object_add(poJsonObject, "perfCounters", poCounters);
+
+        // Only the categories with calls are reported.
+        const CPLStringList aosLatency(
+            GDALDatasetGetRasterIOLatencyStats(hDataset));
+        json_object *poLatency = bJson ? json_object_new_object() : nullptr;
+        if( !bJson )
+            Concat(osStr, psOptions->bStdoutOutput, "RasterIO Latency:\n");
+        for( const char* pszCategory: { "HIT", "MISS", "MISS_READ_BLOCK",
+                                        "WRITE" } )
+        {
+            const GIntBig nCount = CPLAtoGIntBig(aosLatency.FetchNameValueDef(
+                CPLSPrintf("%s_COUNT", pszCategory), "0"));
+            if( nCount == 0 )
+                continue;
+            const char* pszP50 = aosLatency.FetchNameValueDef(
+                CPLSPrintf("%s_P50_US", pszCategory), "0");
+            const char* pszP90 = aosLatency.FetchNameValueDef(
+                CPLSPrintf("%s_P90_US", pszCategory), "0");
+            const char* pszP99 = aosLatency.FetchNameValueDef(
+                CPLSPrintf("%s_P99_US", pszCategory), "0");
+            const char* pszMax = aosLatency.FetchNameValueDef(
+                CPLSPrintf("%s_MAX_US", pszCategory), "0");
+            if( bJson )
+            {
+                json_object *poCategory = json_object_new_object();
+                json_object_object_add(poCategory, "count",
+                                       json_object_new_int64(nCount));
+                json_object_object_add(poCategory, "p50_us",
+                    json_object_new_double_with_precision(CPLAtof(pszP50), 1));
+                json_object_object_add(poCategory, "p90_us",
+                    json_object_new_double_with_precision(CPLAtof(pszP90), 1));
+                json_object_object_add(poCategory, "p99_us",
+                    json_object_new_double_with_precision(CPLAtof(pszP99), 1));
+                json_object_object_add(poCategory, "max_us",
+                    json_object_new_double_with_precision(CPLAtof(pszMax), 1));
+                json_object_object_add(poLatency,
+                    CPLString(pszCategory).tolower().c_str(), poCategory);
+            }
+            else
+            {
+                Concat(osStr, psOptions->bStdoutOutput,
+                       "  %s: Count=" CPL_FRMT_GIB ", P50=%s us, P90=%s us, "
+                       "P99=%s us, Max=%s us\n",
+                       pszCategory, nCount, pszP50, pszP90, pszP99, pszMax);
+            }
+        }
+        if( bJson )
+            json_object_object_add(poJsonObject, "rasterIOLatency", poLatency);
+    }
+
     if(bJson)
     {
         json_object_object_add(poJsonObject, "bands", poBands);
@@ -1848,6 +1998,7 @@ GDALInfoOptions *GDALInfoOptionsNew(
     psOptions->bShowColorTable = TRUE;
     psOptions->bListMDD = FALSE;
     psOptions->bShowFileList = TRUE;
+    psOptions->bReportPerfCounters = FALSE;
     psOptions->pszWKTFormat = CPLStrdup("WKT2");
 
 /* -------------------------------------------------------------------- */
@@ -1906,6 +2057,9 @@ GDALInfoOptions *GDALInfoOptionsNew(
         }
         else if( EQUAL(papszArgv[i], "-nofl") )
             psOptions->bShowFileList = FALSE;
+        else if( EQUAL(papszArgv[i], "-stats-perf") ||
+                 EQUAL(papszArgv[i], "--stats-perf") )
+            psOptions->bReportPerfCounters = TRUE;
         else if( EQUAL(papszArgv[i], "-sd") && papszArgv[i+1] != nullptr )
         {
             i++;
@@ -29,14 +29,20 @@
 
 #include "cpl_port.h"
 #include "cpl_conv.h"
+#include "cpl_error_internal.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal_version.h"
 #include "gdal.h"
 #include "ogr_api.h"
 #include "ogr_srs_api.h"
 #include "commonutils.h"
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
 
 CPL_CVSID("$Id$")
 
@@ -52,7 +58,7 @@ static void Usage(const char* pszErrorMsg)
             "Usage: gdaltindex [-f format] [-tileindex field_name] [-write_absolute_path] \n"
             "                  [-skip_different_projection] [-t_srs target_srs]\n"
             "                  [-src_srs_name field_name] [-src_srs_format [AUTO|WKT|EPSG|PROJ]\n"
-            "                  [-lyr_name name] index_file [gdal_file]*\n"
+            "                  [-lyr_name name] [-header_only] index_file [gdal_file]*\n"
             "\n"
             "e.g.\n"
             "  % gdaltindex doq_index.shp doq/*.tif\n"
@@ -68,7 +74,10 @@ static void Usage(const char* pszErrorMsg)
             "    target coordinate reference system.\n"
             "    Note that using this option generates files that are NOT compatible with MapServer < 6.4.\n"
             "  o Simple rectangular polygons are generated in the same coordinate reference system\n"
-            "    as the rasters, or in target reference system if the -t_srs option is used.\n");
+            "    as the rasters, or in target reference system if the -t_srs option is used.\n"
+            "  o If -header_only is specified, side-car files (.aux.xml, world files, ...) are not\n"
+            "    looked for, unless the file header has no georeferencing.\n"
+            "  o Rasters are opened in parallel if the GDAL_NUM_THREADS configuration option is set.\n");
 
     if( pszErrorMsg != nullptr )
         fprintf(stderr, "\nFAILURE: %s\n", pszErrorMsg);
@@ -93,6 +102,78 @@ typedef enum
     FORMAT_PROJ
 } SrcSRSFormat;
 
+/************************************************************************/
+/*                            RasterTileInfo                            */
+/************************************************************************/
+
+struct RasterTileInfo
+{
+    std::string osFilename{};
+    CPLString   osFileNameToWrite{};
+    bool        bHeaderOnly = false;
+
+    bool        bOpened = false;
+    double      adfGeoTransform[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    int         nXSize = 0;
+    int         nYSize = 0;
+    std::string osProjectionRef{};
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+};
+
+/************************************************************************/
+/*                           ScanRasterTile()                           */
+/*                                                                      */
+/*      Collect the extent and SRS of a raster. In header-only mode,    */
+/*      the directory is not listed, so that side-car files (PAM        */
+/*      .aux.xml, world files, external overviews...) are not probed.   */
+/*      If no georeferencing is found that way, a regular open is done. */
+/************************************************************************/
+
+static void ScanRasterTile( RasterTileInfo* psTile )
+{
+    GDALDatasetH hDS = nullptr;
+    if( psTile->bHeaderOnly )
+    {
+        const CPLString osOldVal(
+            CPLGetThreadLocalConfigOption("GDAL_DISABLE_READDIR_ON_OPEN", ""));
+        CPLSetThreadLocalConfigOption("GDAL_DISABLE_READDIR_ON_OPEN",
+                                      "EMPTY_DIR");
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        hDS = GDALOpen( psTile->osFilename.c_str(), GA_ReadOnly );
+        CPLPopErrorHandler();
+        CPLSetThreadLocalConfigOption("GDAL_DISABLE_READDIR_ON_OPEN",
+                                      osOldVal.empty() ? nullptr :
+                                                         osOldVal.c_str());
+        if( hDS &&
+            GDALGetGeoTransform( hDS, psTile->adfGeoTransform ) != CE_None )
+        {
+            GDALClose( hDS );
+            hDS = nullptr;
+        }
+    }
+    if( hDS == nullptr )
+    {
+        hDS = GDALOpen( psTile->osFilename.c_str(), GA_ReadOnly );
+        if( hDS == nullptr )
+            return;
+        GDALGetGeoTransform( hDS, psTile->adfGeoTransform );
+    }
+
+    psTile->bOpened = true;
+    psTile->nXSize = GDALGetRasterXSize( hDS );
+    psTile->nYSize = GDALGetRasterYSize( hDS );
+    psTile->osProjectionRef = GDALGetProjectionRef( hDS );
+    GDALClose( hDS );
+}
+
+static void ScanRasterTileJob( void* pData )
+{
+    RasterTileInfo* psTile = static_cast<RasterTileInfo*>(pData);
+    CPLInstallErrorHandlerAccumulator(psTile->aoErrors);
+    ScanRasterTile(psTile);
+    CPLUninstallErrorHandlerAccumulator();
+}
+
 MAIN_START(argc, argv)
 {
     // Check that we are running against at least GDAL 1.4.
@@ -124,6 +205,7 @@ MAIN_START(argc, argv)
     bool write_absolute_path = false;
     char* current_path = nullptr;
     bool skip_different_projection = false;
+    bool bHeaderOnly = false;
     const char *pszTargetSRS = "";
     bool bSetTargetSRS = false;
     const char* pszSrcSRSName = nullptr;
@@ -173,6 +255,10 @@ MAIN_START(argc, argv)
         {
             skip_different_projection = true;
         }
+        else if ( strcmp(argv[iArg],"-header_only") == 0 )
+        {
+            bHeaderOnly = true;
+        }
         else if( strcmp(argv[iArg], "-src_srs_name") == 0 )
         {
             CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
@@ -443,279 +529,327 @@ MAIN_START(argc, argv)
     }
 
 /* -------------------------------------------------------------------- */
-/*      loop over GDAL files, processing.                               */
+/*      Loop over GDAL files, processing. Rasters are scanned by        */
+/*      batches, in parallel when GDAL_NUM_THREADS is set, and features */
+/*      are written within a single transaction when the output        */
+/*      format supports it.                                             */
 /* -------------------------------------------------------------------- */
-    for( ; iArg < argc; iArg++ )
+    const char* pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs()
+                                                    : atoi(pszNumThreads);
+    nThreads = std::max(1, std::min(nThreads, argc - iArg));
+    std::unique_ptr<CPLWorkerThreadPool> poPool;
+    if( nThreads > 1 )
     {
-        char *fileNameToWrite = nullptr;
-        VSIStatBuf sStatBuf;
+        poPool.reset(new CPLWorkerThreadPool());
+        if( !poPool->Setup(nThreads, nullptr, nullptr) )
+            poPool.reset();
+    }
+    const int nBatchSize = poPool ? 16 * nThreads : 1;
 
-        // Make sure it is a file before building absolute path name.
-        if( write_absolute_path && CPLIsFilenameRelative( argv[iArg] ) &&
-            VSIStat( argv[iArg], &sStatBuf ) == 0 )
-        {
-            fileNameToWrite =
-                CPLStrdup(CPLProjectRelativeFilename(current_path, argv[iArg]));
-        }
-        else
-        {
-            fileNameToWrite = CPLStrdup(argv[iArg]);
-        }
+    const bool bInTransaction =
+        GDALDatasetStartTransaction(hTileIndexDS, FALSE) == OGRERR_NONE;
 
-        // Checks that file is not already in tileindex.
+    bool bStop = false;
+    while( iArg < argc && !bStop )
+    {
+        std::vector<std::unique_ptr<RasterTileInfo>> apoTiles;
+        for( ; iArg < argc &&
+               static_cast<int>(apoTiles.size()) < nBatchSize; iArg++ )
         {
-            int i = 0;  // Used after for.
-            for( ; i < nExistingFiles; i++ )
+            std::unique_ptr<RasterTileInfo> poTile(new RasterTileInfo());
+            poTile->osFilename = argv[iArg];
+            poTile->bHeaderOnly = bHeaderOnly;
+
+            VSIStatBuf sStatBuf;
+
+            // Make sure it is a file before building absolute path name.
+            if( write_absolute_path && CPLIsFilenameRelative( argv[iArg] ) &&
+                VSIStat( argv[iArg], &sStatBuf ) == 0 )
             {
-                if (EQUAL(fileNameToWrite, existingFilesTab[i]))
-                {
-                    fprintf(stderr,
-                            "File %s is already in tileindex. Skipping it.\n",
-                            fileNameToWrite);
-                    break;
-                }
+                poTile->osFileNameToWrite =
+                    CPLProjectRelativeFilename(current_path, argv[iArg]);
             }
-            if (i != nExistingFiles)
+            else
             {
-                CPLFree(fileNameToWrite);
-                continue;
+                poTile->osFileNameToWrite = argv[iArg];
             }
+
+            // Checks that file is not already in tileindex.
+            {
+                int i = 0;  // Used after for.
+                for( ; i < nExistingFiles; i++ )
+                {
+                    if (EQUAL(poTile->osFileNameToWrite, existingFilesTab[i]))
+                    {
+                        fprintf(stderr,
+                                "File %s is already in tileindex. Skipping it.\n",
+                                poTile->osFileNameToWrite.c_str());
+                        break;
+                    }
+                }
+                if (i != nExistingFiles)
+                {
+                    continue;
+                }
+            }
+
+            apoTiles.push_back(std::move(poTile));
         }
 
-        GDALDatasetH hDS = GDALOpen( argv[iArg], GA_ReadOnly );
-        if( hDS == nullptr )
+        if( poPool )
         {
-            fprintf( stderr, "Unable to open %s, skipping.\n",
-                     argv[iArg] );
-            CPLFree(fileNameToWrite);
-            continue;
+            std::vector<void*> apJobData;
+            for( auto& poTile: apoTiles )
+                apJobData.push_back(poTile.get());
+            poPool->SubmitJobs(ScanRasterTileJob, apJobData);
+            poPool->WaitCompletion();
         }
-
-        double adfGeoTransform[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
-        GDALGetGeoTransform( hDS, adfGeoTransform );
-        if( adfGeoTransform[0] == 0.0
-            && adfGeoTransform[1] == 1.0
-            && adfGeoTransform[3] == 0.0
-            && std::abs(adfGeoTransform[5]) == 1.0 )
+        else
         {
-            fprintf( stderr,
-                     "It appears no georeferencing is available for\n"
-                     "`%s', skipping.\n",
-                     argv[iArg] );
-            GDALClose( hDS );
-            CPLFree(fileNameToWrite);
-            continue;
+            for( auto& poTile: apoTiles )
+                ScanRasterTile(poTile.get());
         }
 
-        const char *projectionRef = GDALGetProjectionRef(hDS);
-
-        // If not set target srs, test that the current file uses same
-        // projection as others.
-        if( !bSetTargetSRS )
+        for( auto& poTile: apoTiles )
         {
-            if( alreadyExistingProjectionRefValid )
+            for( const auto& oError: poTile->aoErrors )
+                CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+
+            if( !poTile->bOpened )
             {
-                int projectionRefNotNull, alreadyExistingProjectionRefNotNull;
-                projectionRefNotNull = projectionRef && projectionRef[0];
-                alreadyExistingProjectionRefNotNull =
-                    alreadyExistingProjectionRef &&
-                    alreadyExistingProjectionRef[0];
-                if ((projectionRefNotNull &&
-                     alreadyExistingProjectionRefNotNull &&
-                     EQUAL(projectionRef, alreadyExistingProjectionRef) == 0) ||
-                    (projectionRefNotNull != alreadyExistingProjectionRefNotNull))
+                fprintf( stderr, "Unable to open %s, skipping.\n",
+                         poTile->osFilename.c_str() );
+                continue;
+            }
+
+            const char* fileNameToWrite = poTile->osFileNameToWrite.c_str();
+            const double* adfGeoTransform = poTile->adfGeoTransform;
+            if( adfGeoTransform[0] == 0.0
+                && adfGeoTransform[1] == 1.0
+                && adfGeoTransform[3] == 0.0
+                && std::abs(adfGeoTransform[5]) == 1.0 )
+            {
+                fprintf( stderr,
+                         "It appears no georeferencing is available for\n"
+                         "`%s', skipping.\n",
+                         poTile->osFilename.c_str() );
+                continue;
+            }
+
+            const char *projectionRef = poTile->osProjectionRef.c_str();
+
+            // If not set target srs, test that the current file uses same
+            // projection as others.
+            if( !bSetTargetSRS )
+            {
+                if( alreadyExistingProjectionRefValid )
                 {
-                    fprintf(
-                        stderr,
-                        "Warning : %s is not using the same projection system "
-                        "as other files in the tileindex.\n"
-                        "This may cause problems when using it in MapServer "
-                        "for example.\n"
-                        "Use -t_srs option to set target projection system "
-                        "(not supported by MapServer).\n"
-                        "%s\n", argv[iArg],
-                        skip_different_projection ? "Skipping this file." : "");
-                    if( skip_different_projection )
+                    int projectionRefNotNull, alreadyExistingProjectionRefNotNull;
+                    projectionRefNotNull = projectionRef && projectionRef[0];
+                    alreadyExistingProjectionRefNotNull =
+                        alreadyExistingProjectionRef &&
+                        alreadyExistingProjectionRef[0];
+                    if ((projectionRefNotNull &&
+                         alreadyExistingProjectionRefNotNull &&
+                         EQUAL(projectionRef, alreadyExistingProjectionRef) == 0) ||
+                        (projectionRefNotNull != alreadyExistingProjectionRefNotNull))
                     {
-                        CPLFree(fileNameToWrite);
-                        GDALClose( hDS );
-                        continue;
+                        fprintf(
+                            stderr,
+                            "Warning : %s is not using the same projection system "
+                            "as other files in the tileindex.\n"
+                            "This may cause problems when using it in MapServer "
+                            "for example.\n"
+                            "Use -t_srs option to set target projection system "
+                            "(not supported by MapServer).\n"
+                            "%s\n", poTile->osFilename.c_str(),
+                            skip_different_projection ? "Skipping this file." : "");
+                        if( skip_different_projection )
+                        {
+                            continue;
+                        }
                     }
                 }
+                else
+                {
+                    alreadyExistingProjectionRefValid = true;
+                    alreadyExistingProjectionRef = CPLStrdup(projectionRef);
+                }
             }
-            else
+
+            const int nXSize = poTile->nXSize;
+            const int nYSize = poTile->nYSize;
+
+            double adfX[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+            double adfY[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
+            adfX[0] = adfGeoTransform[0]
+                + 0 * adfGeoTransform[1]
+                + 0 * adfGeoTransform[2];
+            adfY[0] = adfGeoTransform[3]
+                + 0 * adfGeoTransform[4]
+                + 0 * adfGeoTransform[5];
+
+            adfX[1] = adfGeoTransform[0]
+                + nXSize * adfGeoTransform[1]
+                + 0 * adfGeoTransform[2];
+            adfY[1] = adfGeoTransform[3]
+                + nXSize * adfGeoTransform[4]
+                + 0 * adfGeoTransform[5];
+
+            adfX[2] = adfGeoTransform[0]
+                + nXSize * adfGeoTransform[1]
+                + nYSize * adfGeoTransform[2];
+            adfY[2] = adfGeoTransform[3]
+                + nXSize * adfGeoTransform[4]
+                + nYSize * adfGeoTransform[5];
+
+            adfX[3] = adfGeoTransform[0]
+                + 0 * adfGeoTransform[1]
+                + nYSize * adfGeoTransform[2];
+            adfY[3] = adfGeoTransform[3]
+                + 0 * adfGeoTransform[4]
+                + nYSize * adfGeoTransform[5];
+
+            adfX[4] = adfGeoTransform[0]
+                + 0 * adfGeoTransform[1]
+                + 0 * adfGeoTransform[2];
+            adfY[4] = adfGeoTransform[3]
+                + 0 * adfGeoTransform[4]
+                + 0 * adfGeoTransform[5];
+
+            OGRSpatialReferenceH hSourceSRS = nullptr;
+            if( (bSetTargetSRS || i_SrcSRSName >= 0) &&
+                projectionRef != nullptr &&
+                projectionRef[0] != '\0' )
             {
-                alreadyExistingProjectionRefValid = true;
-                alreadyExistingProjectionRef = CPLStrdup(projectionRef);
+                hSourceSRS = OSRNewSpatialReference( projectionRef );
+                OSRSetAxisMappingStrategy(hSourceSRS, OAMS_TRADITIONAL_GIS_ORDER);
             }
-        }
 
-        const int nXSize = GDALGetRasterXSize( hDS );
-        const int nYSize = GDALGetRasterYSize( hDS );
-
-        double adfX[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
-        double adfY[5] = { 0.0, 0.0, 0.0, 0.0, 0.0 };
-        adfX[0] = adfGeoTransform[0]
-            + 0 * adfGeoTransform[1]
-            + 0 * adfGeoTransform[2];
-        adfY[0] = adfGeoTransform[3]
-            + 0 * adfGeoTransform[4]
-            + 0 * adfGeoTransform[5];
-
-        adfX[1] = adfGeoTransform[0]
-            + nXSize * adfGeoTransform[1]
-            + 0 * adfGeoTransform[2];
-        adfY[1] = adfGeoTransform[3]
-            + nXSize * adfGeoTransform[4]
-            + 0 * adfGeoTransform[5];
-
-        adfX[2] = adfGeoTransform[0]
-            + nXSize * adfGeoTransform[1]
-            + nYSize * adfGeoTransform[2];
-        adfY[2] = adfGeoTransform[3]
-            + nXSize * adfGeoTransform[4]
-            + nYSize * adfGeoTransform[5];
-
-        adfX[3] = adfGeoTransform[0]
-            + 0 * adfGeoTransform[1]
-            + nYSize * adfGeoTransform[2];
-        adfY[3] = adfGeoTransform[3]
-            + 0 * adfGeoTransform[4]
-            + nYSize * adfGeoTransform[5];
-
-        adfX[4] = adfGeoTransform[0]
-            + 0 * adfGeoTransform[1]
-            + 0 * adfGeoTransform[2];
-        adfY[4] = adfGeoTransform[3]
-            + 0 * adfGeoTransform[4]
-            + 0 * adfGeoTransform[5];
-
-        OGRSpatialReferenceH hSourceSRS = nullptr;
-        if( (bSetTargetSRS || i_SrcSRSName >= 0) &&
-            projectionRef != nullptr &&
-            projectionRef[0] != '\0' )
-        {
-            hSourceSRS = OSRNewSpatialReference( projectionRef );
-            OSRSetAxisMappingStrategy(hSourceSRS, OAMS_TRADITIONAL_GIS_ORDER);
-        }
-
-        // If set target srs, do the forward transformation of all points.
-        if( bSetTargetSRS && projectionRef != nullptr && projectionRef[0] != '\0' )
-        {
-            OGRCoordinateTransformationH hCT = nullptr;
-            if( hSourceSRS && !OSRIsSame( hSourceSRS, hTargetSRS ) )
+            // If set target srs, do the forward transformation of all points.
+            if( bSetTargetSRS && projectionRef != nullptr && projectionRef[0] != '\0' )
             {
-                hCT = OCTNewCoordinateTransformation( hSourceSRS, hTargetSRS );
-                if( hCT == nullptr || !OCTTransform( hCT, 5, adfX, adfY, nullptr ) )
+                OGRCoordinateTransformationH hCT = nullptr;
+                if( hSourceSRS && !OSRIsSame( hSourceSRS, hTargetSRS ) )
                 {
-                    fprintf(
-                        stderr,
-                        "Warning : unable to transform points from source "
-                        "SRS `%s' to target SRS `%s'\n"
-                        "for file `%s' - file skipped\n",
-                        projectionRef, pszTargetSRS, fileNameToWrite );
-                    if( hCT )
-                        OCTDestroyCoordinateTransformation( hCT );
-                    OSRDestroySpatialReference( hSourceSRS );
-                    continue;
+                    hCT = OCTNewCoordinateTransformation( hSourceSRS, hTargetSRS );
+                    if( hCT == nullptr || !OCTTransform( hCT, 5, adfX, adfY, nullptr ) )
+                    {
+                        fprintf(
+                            stderr,
+                            "Warning : unable to transform points from source "
+                            "SRS `%s' to target SRS `%s'\n"
+                            "for file `%s' - file skipped\n",
+                            projectionRef, pszTargetSRS, fileNameToWrite );
+                        if( hCT )
+                            OCTDestroyCoordinateTransformation( hCT );
+                        OSRDestroySpatialReference( hSourceSRS );
+                        continue;
+                    }
+                    OCTDestroyCoordinateTransformation( hCT );
                 }
-                OCTDestroyCoordinateTransformation( hCT );
             }
-        }
 
-        OGRFeatureH hFeature = OGR_F_Create( OGR_L_GetLayerDefn( hLayer ) );
-        OGR_F_SetFieldString( hFeature, ti_field, fileNameToWrite );
+            OGRFeatureH hFeature = OGR_F_Create( OGR_L_GetLayerDefn( hLayer ) );
+            OGR_F_SetFieldString( hFeature, ti_field, fileNameToWrite );
 
-        if( i_SrcSRSName >= 0 && hSourceSRS != nullptr )
-        {
-            const char* pszAuthorityCode =
-                OSRGetAuthorityCode(hSourceSRS, nullptr);
-            const char* pszAuthorityName =
-                OSRGetAuthorityName(hSourceSRS, nullptr);
-            if( eSrcSRSFormat == FORMAT_AUTO )
+            if( i_SrcSRSName >= 0 && hSourceSRS != nullptr )
             {
-                if( pszAuthorityName != nullptr && pszAuthorityCode != nullptr )
+                const char* pszAuthorityCode =
+                    OSRGetAuthorityCode(hSourceSRS, nullptr);
+                const char* pszAuthorityName =
+                    OSRGetAuthorityName(hSourceSRS, nullptr);
+                if( eSrcSRSFormat == FORMAT_AUTO )
                 {
-                    OGR_F_SetFieldString(
-                        hFeature, i_SrcSRSName,
-                        CPLSPrintf("%s:%s",
-                                   pszAuthorityName, pszAuthorityCode) );
+                    if( pszAuthorityName != nullptr && pszAuthorityCode != nullptr )
+                    {
+                        OGR_F_SetFieldString(
+                            hFeature, i_SrcSRSName,
+                            CPLSPrintf("%s:%s",
+                                       pszAuthorityName, pszAuthorityCode) );
+                    }
+                    else if( nMaxFieldSize == 0 ||
+                             strlen(projectionRef) <= nMaxFieldSize )
+                    {
+                        OGR_F_SetFieldString(hFeature, i_SrcSRSName, projectionRef);
+                    }
+                    else
+                    {
+                        char* pszProj4 = nullptr;
+                        if( OSRExportToProj4(hSourceSRS, &pszProj4) == OGRERR_NONE )
+                        {
+                            OGR_F_SetFieldString( hFeature, i_SrcSRSName,
+                                                  pszProj4 );
+                            CPLFree(pszProj4);
+                        }
+                        else
+                        {
+                            OGR_F_SetFieldString( hFeature, i_SrcSRSName,
+                                                  projectionRef );
+                        }
+                    }
                 }
-                else if( nMaxFieldSize == 0 ||
-                         strlen(projectionRef) <= nMaxFieldSize )
+                else if( eSrcSRSFormat == FORMAT_WKT )
                 {
-                    OGR_F_SetFieldString(hFeature, i_SrcSRSName, projectionRef);
-                }
-                else
-                {
-                    char* pszProj4 = nullptr;
-                    if( OSRExportToProj4(hSourceSRS, &pszProj4) == OGRERR_NONE )
+                    if( nMaxFieldSize == 0 ||
+                        strlen(projectionRef) <= nMaxFieldSize )
                     {
                         OGR_F_SetFieldString( hFeature, i_SrcSRSName,
-                                              pszProj4 );
-                        CPLFree(pszProj4);
+                                              projectionRef );
                     }
                     else
                     {
-                        OGR_F_SetFieldString( hFeature, i_SrcSRSName,
-                                              projectionRef );
+                        fprintf(stderr,
+                                "Cannot write WKT for file %s as it is too long!\n",
+                                fileNameToWrite);
                     }
                 }
-            }
-            else if( eSrcSRSFormat == FORMAT_WKT )
-            {
-                if( nMaxFieldSize == 0 ||
-                    strlen(projectionRef) <= nMaxFieldSize )
-                {
-                    OGR_F_SetFieldString( hFeature, i_SrcSRSName,
-                                          projectionRef );
-                }
-                else
+                else if( eSrcSRSFormat == FORMAT_PROJ )
                 {
-                    fprintf(stderr,
-                            "Cannot write WKT for file %s as it is too long!\n",
-                            fileNameToWrite);
+                    char* pszProj4 = nullptr;
+                    if( OSRExportToProj4(hSourceSRS, &pszProj4) == OGRERR_NONE )
+                    {
+                        OGR_F_SetFieldString( hFeature, i_SrcSRSName, pszProj4 );
+                        CPLFree(pszProj4);
+                    }
                 }
-            }
-            else if( eSrcSRSFormat == FORMAT_PROJ )
-            {
-                char* pszProj4 = nullptr;
-                if( OSRExportToProj4(hSourceSRS, &pszProj4) == OGRERR_NONE )
+                else if( eSrcSRSFormat == FORMAT_EPSG )
                 {
-                    OGR_F_SetFieldString( hFeature, i_SrcSRSName, pszProj4 );
-                    CPLFree(pszProj4);
+                    if( pszAuthorityName != nullptr && pszAuthorityCode != nullptr )
+                        OGR_F_SetFieldString(
+                            hFeature, i_SrcSRSName,
+                            CPLSPrintf("%s:%s",
+                                       pszAuthorityName, pszAuthorityCode) );
                 }
             }
-            else if( eSrcSRSFormat == FORMAT_EPSG )
+            if( hSourceSRS )
+                OSRDestroySpatialReference( hSourceSRS );
+
+            OGRGeometryH hPoly = OGR_G_CreateGeometry(wkbPolygon);
+            OGRGeometryH hRing = OGR_G_CreateGeometry(wkbLinearRing);
+            for( int k = 0; k < 5; k++ )
+                OGR_G_SetPoint_2D(hRing, k, adfX[k], adfY[k]);
+            OGR_G_AddGeometryDirectly( hPoly, hRing );
+            OGR_F_SetGeometryDirectly( hFeature, hPoly );
+
+            if( OGR_L_CreateFeature( hLayer, hFeature ) != OGRERR_NONE )
             {
-                if( pszAuthorityName != nullptr && pszAuthorityCode != nullptr )
-                    OGR_F_SetFieldString(
-                        hFeature, i_SrcSRSName,
-                        CPLSPrintf("%s:%s",
-                                   pszAuthorityName, pszAuthorityCode) );
+               printf( "Failed to create feature in shapefile.\n" );
+               OGR_F_Destroy( hFeature );
+               bStop = true;
+               break;
             }
-        }
-        if( hSourceSRS )
-            OSRDestroySpatialReference( hSourceSRS );
-
-        OGRGeometryH hPoly = OGR_G_CreateGeometry(wkbPolygon);
-        OGRGeometryH hRing = OGR_G_CreateGeometry(wkbLinearRing);
-        for( int k = 0; k < 5; k++ )
-            OGR_G_SetPoint_2D(hRing, k, adfX[k], adfY[k]);
-        OGR_G_AddGeometryDirectly( hPoly, hRing );
-        OGR_F_SetGeometryDirectly( hFeature, hPoly );
 
-        if( OGR_L_CreateFeature( hLayer, hFeature ) != OGRERR_NONE )
-        {
-           printf( "Failed to create feature in shapefile.\n" );
-           break;
+            OGR_F_Destroy( hFeature );
         }
+    }
 
-        OGR_F_Destroy( hFeature );
-
-        CPLFree(fileNameToWrite);
-
-        GDALClose( hDS );
+    if( bInTransaction &&
+        GDALDatasetCommitTransaction(hTileIndexDS) != OGRERR_NONE )
+    {
+        fprintf( stderr, "Failed to commit features in `%s'.\n",
+                 index_filename );
     }
 
     CPLFree(current_path);
@@ -41,18 +41,25 @@
 
 #include <algorithm>
 #include <array>
+#include <condition_variable>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <vector>
 
 #include "commonutils.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_error_internal.h"
 #include "cpl_progress.h"
+#include "cpl_quad_tree.h"
 #include "cpl_string.h"
 #include "gdal.h"
 #include "gdal_alg.h"
 #include "gdal_alg_priv.h"
 #include "gdal_priv.h"
+#include "gdal_thread_pool.h"
 #include "gdalwarper.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
@@ -213,6 +220,17 @@ struct GDALWarpAppOptions
 
     /*! Whether to disable vertical grid shift adjustment */
     bool bNoVShiftGrid;
+
+    /*! warp all source datasets in a single pass over the output: each
+        output chunk receives the contribution of all the sources that
+        intersect it before being written, and chunks are processed in
+        parallel when GDAL_NUM_THREADS is set. */
+    bool bSinglePass;
+
+    /*! 0-based index of the part to produce among nTileCount full width
+        strips of the output (-tile_index i/N), when nTileCount > 0 */
+    int nTileIndex;
+    int nTileCount;
 };
 
 static CPLErr
@@ -890,6 +908,7 @@ bool DealWithCOGOptions(CPLStringList& aosCreateOptions,
 {
     auto psOptionsTemp = GDALWarpAppOptionsClone(psOptions);
     psOptionsTemp->bQuiet = true;
+    psOptionsTemp->nTileCount = 0;
     CPLString osTmpFilename;
     osTmpFilename.Printf("/vsimem/gdalwarp/%p.tif", psOptionsTemp);
     CPLStringList aosTmpGTiffCreateOptions;
@@ -1221,6 +1240,16 @@ static bool CheckOptions(const char *pszDest,
 /*      Check that incompatible options are not used                    */
 /* -------------------------------------------------------------------- */
 
+    if( psOptions->nTileCount > 0 && (hDstDS != nullptr || bVRT) )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "-tile_index can only be used when creating a new output "
+                 "dataset, that is not a VRT.");
+        if(pbUsageError)
+            *pbUsageError = TRUE;
+        return false;
+    }
+
     if ((psOptions->nForcePixels != 0 || psOptions->nForceLines != 0) &&
         (psOptions->dfXRes != 0 && psOptions->dfYRes != 0))
     {
@@ -2057,6 +2086,491 @@ static void AdjustOutputExtentForRPC( GDALDatasetH hSrcDS,
     }
 }
 
+/************************************************************************/
+/*                          SinglePassSource                            */
+/************************************************************************/
+
+namespace {
+
+// A source dataset whose warping is deferred until all sources have been
+// set up, in -single_pass mode.
+struct SinglePassSource
+{
+    CPL_DISALLOW_COPY_ASSIGN(SinglePassSource)
+
+    GDALWarpOptions*  psWO = nullptr;
+    void*             hTransformArg = nullptr;
+    GDALDatasetH      hWrkSrcDS = nullptr;
+    GDALWarpOperation oWO{};
+    // Source datasets and transformers are not thread-safe, so a given
+    // source is only warped by one chunk at a time.
+    std::mutex        oMutex{};
+    // Footprint of the source in destination pixel space.
+    CPLRectObj        sFootprint{};
+
+    SinglePassSource() = default;
+    ~SinglePassSource();
+};
+
+SinglePassSource::~SinglePassSource()
+{
+    if( hTransformArg )
+        GDALDestroyTransformer(hTransformArg);
+    if( psWO )
+        GDALDestroyWarpOptions(psWO);
+    if( hWrkSrcDS )
+        GDALReleaseDataset(hWrkSrcDS);
+}
+
+struct SinglePassState;
+
+// A window of the destination dataset, into which all intersecting sources
+// are warped before it is written.
+struct SinglePassChunk
+{
+    SinglePassState* psState = nullptr;
+    int nXOff = 0;
+    int nYOff = 0;
+    int nXSize = 0;
+    int nYSize = 0;
+    std::vector<int> anSources{};
+    CPLErr eErr = CE_None;
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+
+    void Process();
+    static void ProcessJob(void* pData);
+};
+
+struct SinglePassState
+{
+    GDALDataset* poDstDS = nullptr;
+    GDALDataType eDT = GDT_Byte;
+    bool bInitDest = false;
+    std::vector<std::unique_ptr<SinglePassSource>>* paoSources = nullptr;
+
+    std::mutex oDstMutex{};
+    std::mutex oMutex{};
+    std::condition_variable oCV{};
+    int nChunksDone = 0;
+    bool bStop = false;
+};
+
+/************************************************************************/
+/*                      SinglePassChunk::Process()                      */
+/************************************************************************/
+
+void SinglePassChunk::Process()
+{
+    const int nDstBands = psState->poDstDS->GetRasterCount();
+    const int nWordSize = GDALGetDataTypeSizeBytes(psState->eDT);
+    const size_t nBandPixels = static_cast<size_t>(nXSize) * nYSize;
+    std::vector<GByte> abyBuffer;
+    try
+    {
+        abyBuffer.resize(nBandPixels * nDstBands * nWordSize);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate chunk buffer");
+        eErr = CE_Failure;
+        return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Initialize the chunk, either from INIT_DEST or from the         */
+/*      current content of the destination dataset.                     */
+/* -------------------------------------------------------------------- */
+    int nFirstBandToRead = 0;
+    if( psState->bInitDest )
+    {
+        GDALWarpOperation* poWO = &((*psState->paoSources)[0]->oWO);
+        const GDALWarpOptions* psWO = poWO->GetOptions();
+        int bInitialized = FALSE;
+        void* pInitBuffer =
+            poWO->CreateDestinationBuffer(nXSize, nYSize, &bInitialized);
+        if( pInitBuffer == nullptr )
+        {
+            eErr = CE_Failure;
+            return;
+        }
+        if( bInitialized )
+        {
+            GDALCopyWords64(pInitBuffer, psWO->eWorkingDataType,
+                            GDALGetDataTypeSizeBytes(psWO->eWorkingDataType),
+                            abyBuffer.data(), psState->eDT, nWordSize,
+                            static_cast<GPtrDiff_t>(nBandPixels) *
+                                psWO->nBandCount);
+            nFirstBandToRead = psWO->nBandCount;
+        }
+        GDALWarpOperation::DestroyDestinationBuffer(pInitBuffer);
+    }
+    if( nFirstBandToRead < nDstBands )
+    {
+        std::vector<int> anBands;
+        for( int i = nFirstBandToRead; i < nDstBands; i++ )
+            anBands.push_back(i + 1);
+        std::lock_guard<std::mutex> oLock(psState->oDstMutex);
+        eErr = psState->poDstDS->RasterIO(
+            GF_Read, nXOff, nYOff, nXSize, nYSize,
+            abyBuffer.data() + nFirstBandToRead * nBandPixels * nWordSize,
+            nXSize, nYSize, psState->eDT,
+            static_cast<int>(anBands.size()), anBands.data(),
+            0, 0, 0, nullptr);
+        if( eErr != CE_None )
+            return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Warp all intersecting sources, in their order on the command    */
+/*      line, into the chunk.                                           */
+/* -------------------------------------------------------------------- */
+    std::vector<GByte> abyWorkingBuffer;
+    for( const int iSrc: anSources )
+    {
+        {
+            std::lock_guard<std::mutex> oLock(psState->oMutex);
+            if( psState->bStop )
+            {
+                eErr = CE_Failure;
+                return;
+            }
+        }
+
+        SinglePassSource& oSource = *((*psState->paoSources)[iSrc]);
+        const GDALWarpOptions* psWO = oSource.oWO.GetOptions();
+        const GDALDataType eWorkingDT = psWO->eWorkingDataType;
+        // Source bands are mapped to the first destination bands, so they
+        // are at the beginning of the (band sequential) chunk buffer.
+        const size_t nValues = nBandPixels * psWO->nBandCount;
+
+        std::lock_guard<std::mutex> oLock(oSource.oMutex);
+        if( eWorkingDT == psState->eDT )
+        {
+            eErr = oSource.oWO.WarpRegionToBuffer(
+                nXOff, nYOff, nXSize, nYSize, abyBuffer.data(), eWorkingDT);
+        }
+        else
+        {
+            const int nWorkingWordSize = GDALGetDataTypeSizeBytes(eWorkingDT);
+            try
+            {
+                abyWorkingBuffer.resize(nValues * nWorkingWordSize);
+            }
+            catch( const std::bad_alloc& )
+            {
+                CPLError(CE_Failure, CPLE_OutOfMemory,
+                         "Cannot allocate chunk buffer");
+                eErr = CE_Failure;
+                return;
+            }
+            GDALCopyWords64(abyBuffer.data(), psState->eDT, nWordSize,
+                            abyWorkingBuffer.data(), eWorkingDT,
+                            nWorkingWordSize,
+                            static_cast<GPtrDiff_t>(nValues));
+            eErr = oSource.oWO.WarpRegionToBuffer(
+                nXOff, nYOff, nXSize, nYSize, abyWorkingBuffer.data(),
+                eWorkingDT);
+            GDALCopyWords64(abyWorkingBuffer.data(), eWorkingDT,
+                            nWorkingWordSize,
+                            abyBuffer.data(), psState->eDT, nWordSize,
+                            static_cast<GPtrDiff_t>(nValues));
+        }
+        if( eErr != CE_None )
+            return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Write the chunk, once.                                          */
+/* -------------------------------------------------------------------- */
+    std::lock_guard<std::mutex> oLock(psState->oDstMutex);
+    eErr = psState->poDstDS->RasterIO(
+        GF_Write, nXOff, nYOff, nXSize, nYSize,
+        abyBuffer.data(), nXSize, nYSize, psState->eDT,
+        nDstBands, nullptr, 0, 0, 0, nullptr);
+}
+
+/************************************************************************/
+/*                    SinglePassChunk::ProcessJob()                     */
+/************************************************************************/
+
+void SinglePassChunk::ProcessJob(void* pData)
+{
+    SinglePassChunk* psChunk = static_cast<SinglePassChunk*>(pData);
+    SinglePassState* psState = psChunk->psState;
+
+    CPLInstallErrorHandlerAccumulator(psChunk->aoErrors);
+    psChunk->Process();
+    CPLUninstallErrorHandlerAccumulator();
+
+    {
+        std::lock_guard<std::mutex> oLock(psState->oMutex);
+        psState->nChunksDone++;
+        if( psChunk->eErr != CE_None )
+            psState->bStop = true;
+    }
+    psState->oCV.notify_one();
+}
+
+} // namespace
+
+/************************************************************************/
+/*                   ComputeSourceFootprintInDstSpace()                 */
+/************************************************************************/
+
+// Compute the bounding box, in destination pixel space, of the area that
+// a source may contribute to, by forward transforming a grid of points of
+// the source raster, plus a margin for the resampling kernel. Falls back to
+// the whole warped window if some points cannot be transformed.
+static CPLRectObj ComputeSourceFootprintInDstSpace(
+    GDALDatasetH hWrkSrcDS,
+    GDALTransformerFunc pfnTransformer, void* hTransformArg,
+    int nWarpDstXOff, int nWarpDstYOff,
+    int nWarpDstXSize, int nWarpDstYSize )
+{
+    CPLRectObj sWindow;
+    sWindow.minx = nWarpDstXOff;
+    sWindow.miny = nWarpDstYOff;
+    sWindow.maxx = nWarpDstXOff + nWarpDstXSize;
+    sWindow.maxy = nWarpDstYOff + nWarpDstYSize;
+
+    const int nSrcXSize = GDALGetRasterXSize(hWrkSrcDS);
+    const int nSrcYSize = GDALGetRasterYSize(hWrkSrcDS);
+    constexpr int nStepCount = 20;
+    std::vector<double> adfX;
+    std::vector<double> adfY;
+    for( int iY = 0; iY <= nStepCount; iY++ )
+    {
+        for( int iX = 0; iX <= nStepCount; iX++ )
+        {
+            adfX.push_back(static_cast<double>(iX) * nSrcXSize / nStepCount);
+            adfY.push_back(static_cast<double>(iY) * nSrcYSize / nStepCount);
+        }
+    }
+    const int nPoints = static_cast<int>(adfX.size());
+    std::vector<double> adfZ(nPoints);
+    std::vector<int> abSuccess(nPoints);
+    if( !pfnTransformer(hTransformArg, FALSE, nPoints,
+                        adfX.data(), adfY.data(), adfZ.data(),
+                        abSuccess.data()) )
+    {
+        return sWindow;
+    }
+
+    double dfMinX = std::numeric_limits<double>::infinity();
+    double dfMinY = std::numeric_limits<double>::infinity();
+    double dfMaxX = -std::numeric_limits<double>::infinity();
+    double dfMaxY = -std::numeric_limits<double>::infinity();
+    for( int i = 0; i < nPoints; i++ )
+    {
+        if( !abSuccess[i] || !std::isfinite(adfX[i]) ||
+            !std::isfinite(adfY[i]) )
+        {
+            return sWindow;
+        }
+        dfMinX = std::min(dfMinX, adfX[i]);
+        dfMinY = std::min(dfMinY, adfY[i]);
+        dfMaxX = std::max(dfMaxX, adfX[i]);
+        dfMaxY = std::max(dfMaxY, adfY[i]);
+    }
+
+    // Margin for the resampling kernel (a few source pixels, or a few
+    // destination pixels when downsampling), and to compensate for the
+    // sparse sampling of the source.
+    const double dfDstPixelsPerSrcPixel = std::max(
+        (dfMaxX - dfMinX) / std::max(1, nSrcXSize),
+        (dfMaxY - dfMinY) / std::max(1, nSrcYSize));
+    const double dfMargin = 4 + 4 * dfDstPixelsPerSrcPixel +
+        std::max(dfMaxX - dfMinX, dfMaxY - dfMinY) / nStepCount;
+
+    CPLRectObj sFootprint;
+    sFootprint.minx = std::max(sWindow.minx, dfMinX - dfMargin);
+    sFootprint.miny = std::max(sWindow.miny, dfMinY - dfMargin);
+    sFootprint.maxx = std::min(sWindow.maxx, dfMaxX + dfMargin);
+    sFootprint.maxy = std::min(sWindow.maxy, dfMaxY + dfMargin);
+    return sFootprint;
+}
+
+/************************************************************************/
+/*                          WarpSinglePass()                            */
+/************************************************************************/
+
+// Destination-driven warping of several sources: the destination is split
+// into block-aligned chunks, the sources intersecting each chunk are found
+// with a spatial index, and warped in turn into the chunk buffer, which is
+// then written once. Chunks are processed in parallel when
+// GDAL_NUM_THREADS (or the NUM_THREADS warping option) is set.
+static CPLErr WarpSinglePass( GDALDatasetH hDstDS,
+                              std::vector<std::unique_ptr<SinglePassSource>>& aoSources,
+                              bool bInitDest, bool bSkipNoSource,
+                              int nThreads,
+                              GDALProgressFunc pfnProgress,
+                              void* pProgressData )
+{
+    GDALDataset* poDstDS = GDALDataset::FromHandle(hDstDS);
+    const int nDstXSize = poDstDS->GetRasterXSize();
+    const int nDstYSize = poDstDS->GetRasterYSize();
+    GDALRasterBand* poDstBand = poDstDS->GetRasterBand(1);
+
+    SinglePassState sState;
+    sState.poDstDS = poDstDS;
+    sState.eDT = poDstBand->GetRasterDataType();
+    sState.bInitDest = bInitDest;
+    sState.paoSources = &aoSources;
+
+/* -------------------------------------------------------------------- */
+/*      Index the source footprints.                                    */
+/* -------------------------------------------------------------------- */
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = 0;
+    sGlobalBounds.miny = 0;
+    sGlobalBounds.maxx = nDstXSize;
+    sGlobalBounds.maxy = nDstYSize;
+    CPLQuadTree* hTree = CPLQuadTreeCreate(&sGlobalBounds, nullptr);
+    CPLQuadTreeSetMaxDepth(hTree, CPLQuadTreeGetAdvisedMaxDepth(
+        static_cast<int>(aoSources.size())));
+    // Indices are stored shifted by one, since nullptr is not a valid
+    // feature.
+    for( size_t i = 0; i < aoSources.size(); i++ )
+    {
+        CPLQuadTreeInsertWithBounds(
+            hTree, reinterpret_cast<void*>(static_cast<GUIntptr_t>(i + 1)),
+            &aoSources[i]->sFootprint);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Split the destination in chunks aligned on its blocks.          */
+/* -------------------------------------------------------------------- */
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    poDstBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    constexpr int nTargetChunkSize = 1024;
+    const int nChunkXSize = std::min(nDstXSize,
+        std::max(1, nTargetChunkSize / nBlockXSize) * nBlockXSize);
+    const int nChunkYSize = std::min(nDstYSize,
+        std::max(1, nTargetChunkSize / nBlockYSize) * nBlockYSize);
+
+    std::vector<SinglePassChunk> asChunks;
+    for( int nYOff = 0; nYOff < nDstYSize; nYOff += nChunkYSize )
+    {
+        for( int nXOff = 0; nXOff < nDstXSize; nXOff += nChunkXSize )
+        {
+            SinglePassChunk sChunk;
+            sChunk.psState = &sState;
+            sChunk.nXOff = nXOff;
+            sChunk.nYOff = nYOff;
+            sChunk.nXSize = std::min(nChunkXSize, nDstXSize - nXOff);
+            sChunk.nYSize = std::min(nChunkYSize, nDstYSize - nYOff);
+
+            CPLRectObj sRect;
+            sRect.minx = nXOff;
+            sRect.miny = nYOff;
+            sRect.maxx = nXOff + sChunk.nXSize;
+            sRect.maxy = nYOff + sChunk.nYSize;
+            int nFeatureCount = 0;
+            void** pahFeatures = CPLQuadTreeSearch(hTree, &sRect,
+                                                   &nFeatureCount);
+            for( int i = 0; i < nFeatureCount; i++ )
+            {
+                const int iSrc = static_cast<int>(
+                    reinterpret_cast<GUIntptr_t>(pahFeatures[i]) - 1);
+                const CPLRectObj& sFootprint = aoSources[iSrc]->sFootprint;
+                if( sFootprint.minx < sRect.maxx &&
+                    sFootprint.maxx > sRect.minx &&
+                    sFootprint.miny < sRect.maxy &&
+                    sFootprint.maxy > sRect.miny )
+                {
+                    sChunk.anSources.push_back(iSrc);
+                }
+            }
+            CPLFree(pahFeatures);
+            std::sort(sChunk.anSources.begin(), sChunk.anSources.end());
+
+            if( !sChunk.anSources.empty() || (bInitDest && !bSkipNoSource) )
+                asChunks.emplace_back(std::move(sChunk));
+        }
+    }
+    CPLQuadTreeDestroy(hTree);
+
+    CPLDebug("GDALWARP",
+             "Single pass warping of %d sources: %d chunks of %dx%d pixels, "
+             "%d thread(s)",
+             static_cast<int>(aoSources.size()),
+             static_cast<int>(asChunks.size()),
+             nChunkXSize, nChunkYSize, nThreads);
+
+/* -------------------------------------------------------------------- */
+/*      Process the chunks.                                             */
+/* -------------------------------------------------------------------- */
+    const int nChunks = static_cast<int>(asChunks.size());
+    CPLWorkerThreadPool* poThreadPool =
+        nThreads > 1 && nChunks > 1 ? GDALGetGlobalThreadPool(nThreads) :
+                                      nullptr;
+    CPLErr eErr = CE_None;
+    if( poThreadPool == nullptr )
+    {
+        for( int i = 0; i < nChunks && eErr == CE_None; i++ )
+        {
+            asChunks[i].Process();
+            eErr = asChunks[i].eErr;
+            if( eErr == CE_None &&
+                !pfnProgress( static_cast<double>(i + 1) / nChunks,
+                              "", pProgressData ) )
+            {
+                CPLError( CE_Failure, CPLE_UserInterrupt,
+                          "User terminated" );
+                eErr = CE_Failure;
+            }
+        }
+        return eErr;
+    }
+
+    auto poJobQueue = poThreadPool->CreateJobQueue();
+    for( auto& sChunk: asChunks )
+    {
+        if( !poJobQueue->SubmitJob(SinglePassChunk::ProcessJob, &sChunk) )
+        {
+            std::lock_guard<std::mutex> oLock(sState.oMutex);
+            sState.bStop = true;
+            eErr = CE_Failure;
+            break;
+        }
+    }
+
+    // Only the calling thread reports progress.
+    int nLastChunksDone = 0;
+    while( eErr == CE_None && nLastChunksDone < nChunks )
+    {
+        {
+            std::unique_lock<std::mutex> oLock(sState.oMutex);
+            sState.oCV.wait(oLock, [&sState, nLastChunksDone]
+                { return sState.nChunksDone != nLastChunksDone; });
+            nLastChunksDone = sState.nChunksDone;
+            if( sState.bStop )
+                break;
+        }
+        if( !pfnProgress( static_cast<double>(nLastChunksDone) / nChunks,
+                          "", pProgressData ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            std::lock_guard<std::mutex> oLock(sState.oMutex);
+            sState.bStop = true;
+            eErr = CE_Failure;
+        }
+    }
+    poJobQueue->WaitCompletion();
+
+    // Report errors of worker threads in the order of chunks.
+    for( const auto& sChunk: asChunks )
+    {
+        for( const auto& oError: sChunk.aoErrors )
+            CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+        if( sChunk.eErr != CE_None )
+            eErr = CE_Failure;
+    }
+    return eErr;
+}
+
 /************************************************************************/
 /*                           GDALWarpDirect()                           */
 /************************************************************************/
@@ -2205,6 +2719,45 @@ GDALDatasetH GDALWarpDirect( const char *pszDest, GDALDatasetH hDstDS,
     oProgress.nSrcCount = nSrcCount;
     oProgress.pahSrcDS = pahSrcDS;
 
+/* -------------------------------------------------------------------- */
+/*      Check if all sources can be warped in a single pass over the    */
+/*      output.                                                         */
+/* -------------------------------------------------------------------- */
+    bool bSinglePass = psOptions->bSinglePass && !bVRT;
+    if( bSinglePass )
+    {
+        const char* pszReason = nullptr;
+        if( bEnableDstAlpha )
+            pszReason = "a destination alpha band is used";
+        for( int i = 2; pszReason == nullptr &&
+                        i <= GDALGetRasterCount(hDstDS); i++ )
+        {
+            if( GDALGetRasterDataType(GDALGetRasterBand(hDstDS, i)) !=
+                GDALGetRasterDataType(GDALGetRasterBand(hDstDS, 1)) )
+            {
+                pszReason = "output bands have different data types";
+            }
+        }
+        if( pszReason )
+        {
+            if( !psOptions->bQuiet )
+                CPLError(CE_Warning, CPLE_AppDefined,
+                         "-single_pass ignored since %s", pszReason);
+            bSinglePass = false;
+        }
+    }
+    int nSinglePassThreads = 1;
+    if( bSinglePass )
+    {
+        const char* pszNumThreads = CSLFetchNameValueDef(
+            psOptions->papszWarpOptions, "NUM_THREADS",
+            CPLGetConfigOption("GDAL_NUM_THREADS", "1"));
+        nSinglePassThreads = std::max(1, std::min(128,
+            EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                               atoi(pszNumThreads)));
+    }
+    std::vector<std::unique_ptr<SinglePassSource>> aoSinglePassSources;
+
 /* -------------------------------------------------------------------- */
 /*      Loop over all source files, processing each in turn.            */
 /* -------------------------------------------------------------------- */
@@ -2217,7 +2770,8 @@ GDALDatasetH GDALWarpDirect( const char *pszDest, GDALDatasetH hDstDS,
 /* -------------------------------------------------------------------- */
         hSrcDS = pahSrcDS[iSrc];
         oProgress.iSrc = iSrc;
-        oProgress.Do(0);
+        if( !bSinglePass )
+            oProgress.Do(0);
 
 /* -------------------------------------------------------------------- */
 /*      Check that there's at least one raster band                     */
@@ -2478,7 +3032,7 @@ GDALDatasetH GDALWarpDirect( const char *pszDest, GDALDatasetH hDstDS,
         psWO->hSrcDS = hWrkSrcDS;
         psWO->hDstDS = hDstDS;
 
-        if( !bVRT )
+        if( !bVRT && !bSinglePass )
         {
             psWO->pfnProgress = Progress::ProgressFunc;
             psWO->pProgressArg = &oProgress;
@@ -2648,6 +3202,37 @@ GDALDatasetH GDALWarpDirect( const char *pszDest, GDALDatasetH hDstDS,
             return hDstDS;
         }
 
+/* -------------------------------------------------------------------- */
+/*      In single pass mode, only prepare the warp operation, and       */
+/*      defer its execution until all sources have been set up.         */
+/* -------------------------------------------------------------------- */
+        if( bSinglePass )
+        {
+            // Chunks that do not intersect the source are skipped
+            // beforehand, and parallelism is done at the chunk level.
+            psWO->papszWarpOptions = CSLSetNameValue(psWO->papszWarpOptions,
+                "ERROR_OUT_IF_EMPTY_SOURCE_WINDOW", "NO");
+            if( nSinglePassThreads > 1 )
+                psWO->papszWarpOptions = CSLSetNameValue(
+                    psWO->papszWarpOptions, "NUM_THREADS", nullptr);
+
+            std::unique_ptr<SinglePassSource> poSource(new SinglePassSource());
+            poSource->psWO = psWO;
+            poSource->hTransformArg = hTransformArg;
+            poSource->hWrkSrcDS = hWrkSrcDS;
+            poSource->sFootprint = ComputeSourceFootprintInDstSpace(
+                hWrkSrcDS, pfnTransformer, hTransformArg,
+                nWarpDstXOff, nWarpDstYOff, nWarpDstXSize, nWarpDstYSize);
+            const bool bInitOK = poSource->oWO.Initialize(psWO) == CE_None;
+            aoSinglePassSources.emplace_back(std::move(poSource));
+            if( !bInitOK )
+            {
+                bHasGotErr = true;
+                break;
+            }
+            continue;
+        }
+
 /* -------------------------------------------------------------------- */
 /*      Initialize and execute the warp.                                */
 /* -------------------------------------------------------------------- */
@@ -2684,6 +3269,32 @@ GDALDatasetH GDALWarpDirect( const char *pszDest, GDALDatasetH hDstDS,
         GDALReleaseDataset(hWrkSrcDS);
     }
 
+/* -------------------------------------------------------------------- */
+/*      Warp all sources in a single pass over the output.              */
+/* -------------------------------------------------------------------- */
+    if( !aoSinglePassSources.empty() )
+    {
+        if( !bHasGotErr )
+        {
+            const GDALWarpOptions* psFirstWO = aoSinglePassSources[0]->psWO;
+            const bool bInitDest =
+                CSLFetchNameValue(psFirstWO->papszWarpOptions,
+                                  "INIT_DEST") != nullptr;
+            const bool bSkipNoSource =
+                CPLFetchBool(psFirstWO->papszWarpOptions,
+                             "SKIP_NOSOURCE", false);
+            if( WarpSinglePass( hDstDS, aoSinglePassSources,
+                                bInitDest, bSkipNoSource,
+                                nSinglePassThreads,
+                                psOptions->pfnProgress,
+                                psOptions->pProgressData ) != CE_None )
+            {
+                bHasGotErr = true;
+            }
+        }
+        aoSinglePassSources.clear();
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Final Cleanup.                                                  */
 /* -------------------------------------------------------------------- */
@@ -3501,6 +4112,28 @@ GDALWarpCreateOutput( int nSrcCount, GDALDatasetH *pahSrcDS, const char *pszFile
         bSetColorInterpretation = true;
     }
 
+/* -------------------------------------------------------------------- */
+/*      With -tile_index, only create the strip of the output that      */
+/*      corresponds to the requested part.                              */
+/* -------------------------------------------------------------------- */
+    if( psOptions->nTileCount > 0 )
+    {
+        int nPartYOff = 0;
+        int nPartYSize = 0;
+        if( !GetTileIndexPartWindow(nLines, psOptions->nTileIndex,
+                                    psOptions->nTileCount,
+                                    psOptions->papszCreateOptions,
+                                    nPartYOff, nPartYSize) )
+        {
+            if( hCT != nullptr )
+                GDALDestroyColorTable( hCT );
+            return nullptr;
+        }
+        adfDstGeoTransform[0] += nPartYOff * adfDstGeoTransform[2];
+        adfDstGeoTransform[3] += nPartYOff * adfDstGeoTransform[5];
+        nLines = nPartYSize;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Create the output file.                                         */
 /* -------------------------------------------------------------------- */
@@ -4159,6 +4792,9 @@ GDALWarpAppOptions *GDALWarpAppOptionsNew(char** papszArgv,
     psOptions->pszSrcNodata = nullptr;
     psOptions->pszDstNodata = nullptr;
     psOptions->bMulti = false;
+    psOptions->bSinglePass = false;
+    psOptions->nTileIndex = 0;
+    psOptions->nTileCount = 0;
     psOptions->papszTO = nullptr;
     psOptions->pszCutlineDSName = nullptr;
     psOptions->pszCLayer = nullptr;
@@ -4211,6 +4847,19 @@ GDALWarpAppOptions *GDALWarpAppOptionsNew(char** papszArgv,
         {
             psOptions->bMulti = true;
         }
+        else if( EQUAL(papszArgv[i],"-single_pass") )
+        {
+            psOptions->bSinglePass = true;
+        }
+        else if( i+1 < argc && EQUAL(papszArgv[i],"-tile_index") )
+        {
+            if( !ParseTileIndex(papszArgv[++i], psOptions->nTileIndex,
+                                psOptions->nTileCount) )
+            {
+                GDALWarpAppOptionsFree(psOptions);
+                return nullptr;
+            }
+        }
         else if( EQUAL(papszArgv[i],"-q") || EQUAL(papszArgv[i],"-quiet"))
         {
             if( psOptionsForBinary )
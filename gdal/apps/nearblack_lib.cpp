@@ -37,14 +37,20 @@
 #include <cstring>
 
 #include <algorithm>
+#include <climits>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_error_internal.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
+#include "gdal_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -75,10 +81,21 @@ struct GDALNearblackOptions
 
 static void ProcessLine( GByte *pabyLine, GByte *pabyMask, int iStart,
                          int iEnd, int nSrcBands, int nDstBands, int nNearDist,
-                         int nMaxNonBlack, bool bNearWhite, Colors *poColors,
+                         int nMaxNonBlack, bool bNearWhite,
+                         const Colors *poColors,
                          int *panLastLineCounts, bool bDoHorizontalCheck,
                          bool bDoVerticalCheck, bool bBottomUp );
 
+static bool NearblackMultiThreaded( GDALDatasetH hSrcDataset,
+                                    GDALDatasetH hDstDS,
+                                    GDALRasterBandH hMaskBand,
+                                    int nSrcBands, int nDstBands,
+                                    int nNearDist, int nMaxNonBlack,
+                                    bool bNearWhite, bool bSetAlpha,
+                                    const Colors& oColors, int nThreads,
+                                    GDALProgressFunc pfnProgress,
+                                    void *pProgressData, bool& bOK );
+
 /************************************************************************/
 /*                            GDALNearblack()                           */
 /************************************************************************/
@@ -336,6 +353,31 @@ GDALDatasetH CPL_DLL GDALNearblack( const char *pszDest, GDALDatasetH hDstDS,
         }
     }
 
+/* -------------------------------------------------------------------- */
+/*      Process strips of lines in parallel if asked to.                */
+/* -------------------------------------------------------------------- */
+    const char* pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    const int nThreads = std::max(1, std::min(128,
+        EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                           atoi(pszNumThreads)));
+    bool bOK = true;
+    if( nThreads > 1 &&
+        NearblackMultiThreaded(hSrcDataset, hDstDS, hMaskBand,
+                               nBands, nDstBands, nNearDist, nMaxNonBlack,
+                               bNearWhite, bSetAlpha, oColors, nThreads,
+                               psOptions->pfnProgress,
+                               psOptions->pProgressData, bOK) )
+    {
+        if( !bOK )
+        {
+            if( bCloseOutDSOnError )
+                GDALClose(hDstDS);
+            hDstDS = nullptr;
+        }
+        GDALNearblackOptionsFree(psOptionsToFree);
+        return hDstDS;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Allocate a line buffer.                                         */
 /* -------------------------------------------------------------------- */
@@ -540,6 +582,42 @@ GDALDatasetH CPL_DLL GDALNearblack( const char *pszDest, GDALDatasetH hDstDS,
     return hDstDS;
 }
 
+/************************************************************************/
+/*                             IsNonBlack()                             */
+/*                                                                      */
+/*      Whether a pixel is not near any of the colors.                  */
+/************************************************************************/
+
+static bool IsNonBlack( const GByte *pabyPixel, int nSrcBands, int nNearDist,
+                        const Colors *poColors )
+{
+    /***** loop over the colors *****/
+
+    for( const Color& oColor: *poColors )
+    {
+        bool bIsNonBlack = false;
+
+        /***** loop over the bands *****/
+
+        for( int iBand = 0; iBand < nSrcBands; iBand++ )
+        {
+            const int nPix = pabyPixel[iBand];
+
+            if( oColor[iBand] - nPix > nNearDist ||
+                nPix > nNearDist + oColor[iBand] )
+            {
+                bIsNonBlack = true;
+                break;
+            }
+        }
+
+        if( !bIsNonBlack )
+            return false;
+    }
+
+    return !poColors->empty();
+}
+
 /************************************************************************/
 /*                            ProcessLine()                             */
 /*                                                                      */
@@ -548,7 +626,8 @@ GDALDatasetH CPL_DLL GDALNearblack( const char *pszDest, GDALDatasetH hDstDS,
 
 static void ProcessLine( GByte *pabyLine, GByte *pabyMask, int iStart,
                          int iEnd, int nSrcBands, int nDstBands, int nNearDist,
-                         int nMaxNonBlack, bool bNearWhite, Colors *poColors,
+                         int nMaxNonBlack, bool bNearWhite,
+                         const Colors *poColors,
                          int *panLastLineCounts, bool bDoHorizontalCheck,
                          bool bDoVerticalCheck, bool bBottomUp )
 {
@@ -570,34 +649,9 @@ static void ProcessLine( GByte *pabyLine, GByte *pabyMask, int iStart,
 
             /***** is the pixel valid data? ****/
 
-            bool bIsNonBlack = false;
-
-            /***** loop over the colors *****/
-
-            for( int iColor = 0; iColor < static_cast<int>(poColors->size() );
-                 iColor++) {
-
-                Color oColor = (*poColors)[iColor];
-
-                bIsNonBlack = false;
-
-                /***** loop over the bands *****/
-
-                for( int iBand = 0; iBand < nSrcBands; iBand++ )
-                {
-                    const int nPix = pabyLine[i * nDstBands + iBand];
-
-                    if( oColor[iBand] - nPix > nNearDist ||
-                        nPix > nNearDist + oColor[iBand] )
-                    {
-                        bIsNonBlack = true;
-                        break;
-                    }
-                }
-
-                if( !bIsNonBlack )
-                    break;
-            }
+            const bool bIsNonBlack =
+                IsNonBlack(pabyLine + i * nDstBands, nSrcBands, nNearDist,
+                           poColors);
 
             if( bIsNonBlack )
             {
@@ -648,34 +702,9 @@ static void ProcessLine( GByte *pabyLine, GByte *pabyMask, int iStart,
             {
                 /***** is the pixel valid data? ****/
 
-                bool bIsNonBlack = false;
-
-                /***** loop over the colors *****/
-
-                for( int iColor = 0;
-                     iColor < static_cast<int>(poColors->size()); iColor++ ) {
-
-                    Color oColor = (*poColors)[iColor];
-
-                    bIsNonBlack = false;
-
-                    /***** loop over the bands *****/
-
-                    for( int iBand = 0; iBand < nSrcBands; iBand++ )
-                    {
-                        const int nPix = pabyLine[i * nDstBands + iBand];
-
-                        if( oColor[iBand] - nPix > nNearDist ||
-                            nPix > nNearDist + oColor[iBand] )
-                        {
-                            bIsNonBlack = true;
-                            break;
-                        }
-                    }
-
-                    if( bIsNonBlack == false )
-                        break;
-                }
+                const bool bIsNonBlack =
+                    IsNonBlack(pabyLine + i * nDstBands, nSrcBands,
+                               nNearDist, poColors);
 
                 if( bIsNonBlack )
                 {
@@ -721,6 +750,448 @@ static void ProcessLine( GByte *pabyLine, GByte *pabyMask, int iStart,
     }
 }
 
+/************************************************************************/
+/*                     Multi-threaded implementation                    */
+/*                                                                      */
+/*      Lines are processed by horizontal strips. The only state that   */
+/*      the serial algorithm carries from one line to the next is, for  */
+/*      each column, the count of non-black pixels of the vertical      */
+/*      check. It only depends on the number of non-black pixels met    */
+/*      in the column, saturated at nMaxNonBlack + 1. So a first stage  */
+/*      counts them per strip in the source, which gives the state at   */
+/*      the start of each strip of the top-down pass. The strips are    */
+/*      then processed top-down in parallel, counting the non-black     */
+/*      pixels of the result, which gives in the same way the state at  */
+/*      the start of each strip of the bottom-up pass. The result is    */
+/*      identical to the one of the serial algorithm. Dataset accesses  */
+/*      are serialized.                                                 */
+/************************************************************************/
+
+namespace {
+
+enum class NearblackStage
+{
+    COUNT_SOURCE,
+    TOP_DOWN,
+    BOTTOM_UP
+};
+
+struct NearblackContext
+{
+    GDALDatasetH     hSrcDS = nullptr;
+    GDALDatasetH     hDstDS = nullptr;
+    GDALRasterBandH  hMaskBand = nullptr;
+    int              nXSize = 0;
+    int              nSrcBands = 0;
+    int              nDstBands = 0;
+    int              nNearDist = 0;
+    int              nMaxNonBlack = 0;
+    bool             bNearWhite = false;
+    bool             bSetAlpha = false;
+    const Colors    *poColors = nullptr;
+    int              nLinesPerIO = 1;
+
+    // Datasets are not thread-safe.
+    std::mutex       oIOMutex{};
+
+    std::mutex              oMutex{};
+    std::condition_variable oCV{};
+    GIntBig                 nLinesDone = 0;
+    bool                    bStop = false;
+};
+
+struct NearblackStrip
+{
+    NearblackContext *psContext = nullptr;
+    NearblackStage    eStage = NearblackStage::COUNT_SOURCE;
+    int               nYOff = 0;
+    int               nYSize = 0;
+
+    // Saturated counts of non-black pixels per column, in the source and
+    // in the result of the top-down pass.
+    std::vector<int>  anSrcNonBlackCounts{};
+    std::vector<int>  anDstNonBlackCounts{};
+
+    // State of the vertical check at the start of the strip.
+    std::vector<int>  anTopDownCounts{};
+    std::vector<int>  anBottomUpCounts{};
+
+    CPLErr            eErr = CE_None;
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+    bool              bDone = false;
+
+    CPLErr Run();
+    void   AddNonBlackCounts(const GByte* pabyLines, int nLines,
+                             int nPixelSpace, std::vector<int>& anCounts) const;
+
+    static void Process(void* pData);
+};
+
+/************************************************************************/
+/*                 NearblackStrip::AddNonBlackCounts()                  */
+/************************************************************************/
+
+void NearblackStrip::AddNonBlackCounts(const GByte* pabyLines, int nLines,
+                                       int nPixelSpace,
+                                       std::vector<int>& anCounts) const
+{
+    const NearblackContext* psCtx = psContext;
+    const int nXSize = psCtx->nXSize;
+    for( int iLine = 0; iLine < nLines; iLine++ )
+    {
+        const GByte* pabyLine =
+            pabyLines + static_cast<size_t>(iLine) * nXSize * nPixelSpace;
+        for( int i = 0; i < nXSize; i++ )
+        {
+            if( anCounts[i] <= psCtx->nMaxNonBlack &&
+                IsNonBlack(pabyLine + i * nPixelSpace, psCtx->nSrcBands,
+                           psCtx->nNearDist, psCtx->poColors) )
+            {
+                anCounts[i]++;
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                        NearblackStrip::Run()                         */
+/************************************************************************/
+
+CPLErr NearblackStrip::Run()
+{
+    NearblackContext* psCtx = psContext;
+    const int nXSize = psCtx->nXSize;
+    const int nSrcBands = psCtx->nSrcBands;
+    const int nDstBands = psCtx->nDstBands;
+    const int nPixelSpace =
+        eStage == NearblackStage::COUNT_SOURCE ? nSrcBands : nDstBands;
+    const int nLinesPerIO = std::min(nYSize, psCtx->nLinesPerIO);
+
+    std::vector<GByte> abyLines;
+    std::vector<GByte> abyMask;
+    std::vector<int> anLastLineCounts;
+    try
+    {
+        abyLines.resize(
+            static_cast<size_t>(nLinesPerIO) * nXSize * nPixelSpace);
+        if( psCtx->hMaskBand && eStage != NearblackStage::COUNT_SOURCE )
+            abyMask.resize(static_cast<size_t>(nLinesPerIO) * nXSize);
+        if( eStage == NearblackStage::COUNT_SOURCE )
+            anSrcNonBlackCounts.assign(nXSize, 0);
+        else if( eStage == NearblackStage::TOP_DOWN )
+        {
+            anDstNonBlackCounts.assign(nXSize, 0);
+            anLastLineCounts = anTopDownCounts;
+        }
+        else
+        {
+            anLastLineCounts = anBottomUpCounts;
+        }
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate buffers for nearblack processing");
+        return CE_Failure;
+    }
+    GByte* pabyMask = abyMask.empty() ? nullptr : abyMask.data();
+    const bool bBottomUp = eStage == NearblackStage::BOTTOM_UP;
+
+    for( int iChunk = 0; iChunk < nYSize; iChunk += nLinesPerIO )
+    {
+        {
+            std::lock_guard<std::mutex> oLock(psCtx->oMutex);
+            if( psCtx->bStop )
+                return CE_Failure;
+        }
+
+        const int nLines = std::min(nLinesPerIO, nYSize - iChunk);
+        const int nChunkYOff =
+            bBottomUp ? nYOff + nYSize - iChunk - nLines : nYOff + iChunk;
+        const GSpacing nLineSpace =
+            static_cast<GSpacing>(nXSize) * nPixelSpace;
+
+        CPLErr eIOErr = CE_None;
+        {
+            std::lock_guard<std::mutex> oLock(psCtx->oIOMutex);
+            if( bBottomUp )
+            {
+                eIOErr = GDALDatasetRasterIO(psCtx->hDstDS, GF_Read,
+                                           0, nChunkYOff, nXSize, nLines,
+                                           abyLines.data(), nXSize, nLines,
+                                           GDT_Byte, nDstBands, nullptr,
+                                           nDstBands, nLineSpace, 1);
+                if( eIOErr == CE_None && pabyMask )
+                    eIOErr = GDALRasterIO(psCtx->hMaskBand, GF_Read,
+                                        0, nChunkYOff, nXSize, nLines,
+                                        pabyMask, nXSize, nLines,
+                                        GDT_Byte, 0, 0);
+            }
+            else
+            {
+                eIOErr = GDALDatasetRasterIO(psCtx->hSrcDS, GF_Read,
+                                           0, nChunkYOff, nXSize, nLines,
+                                           abyLines.data(), nXSize, nLines,
+                                           GDT_Byte, nSrcBands, nullptr,
+                                           nPixelSpace, nLineSpace, 1);
+            }
+        }
+        if( eIOErr != CE_None )
+            return eIOErr;
+
+        if( eStage == NearblackStage::COUNT_SOURCE )
+        {
+            AddNonBlackCounts(abyLines.data(), nLines, nPixelSpace,
+                              anSrcNonBlackCounts);
+        }
+        else
+        {
+            for( int iLine = 0; iLine < nLines; iLine++ )
+            {
+                const int iLineInChunk = bBottomUp ? nLines - 1 - iLine : iLine;
+                GByte* pabyLine = abyLines.data() +
+                    static_cast<size_t>(iLineInChunk) * nXSize * nDstBands;
+                GByte* pabyLineMask = pabyMask ?
+                    pabyMask + static_cast<size_t>(iLineInChunk) * nXSize :
+                    nullptr;
+
+                if( !bBottomUp )
+                {
+                    if( psCtx->bSetAlpha )
+                    {
+                        for( int iCol = 0; iCol < nXSize; iCol++ )
+                            pabyLine[iCol * nDstBands + nDstBands - 1] = 255;
+                    }
+                    if( pabyLineMask )
+                        memset(pabyLineMask, 255, nXSize);
+                }
+
+                ProcessLine(pabyLine, pabyLineMask, 0, nXSize-1,
+                            nSrcBands, nDstBands, psCtx->nNearDist,
+                            psCtx->nMaxNonBlack, psCtx->bNearWhite,
+                            psCtx->poColors, anLastLineCounts.data(),
+                            true, // bDoHorizontalCheck
+                            true, // bDoVerticalCheck
+                            bBottomUp);
+                ProcessLine(pabyLine, pabyLineMask, nXSize-1, 0,
+                            nSrcBands, nDstBands, psCtx->nNearDist,
+                            psCtx->nMaxNonBlack, psCtx->bNearWhite,
+                            psCtx->poColors, anLastLineCounts.data(),
+                            true,  // bDoHorizontalCheck
+                            false, // bDoVerticalCheck
+                            bBottomUp);
+            }
+
+            if( !bBottomUp )
+            {
+                AddNonBlackCounts(abyLines.data(), nLines, nDstBands,
+                                  anDstNonBlackCounts);
+            }
+
+            std::lock_guard<std::mutex> oLock(psCtx->oIOMutex);
+            eIOErr = GDALDatasetRasterIO(psCtx->hDstDS, GF_Write,
+                                       0, nChunkYOff, nXSize, nLines,
+                                       abyLines.data(), nXSize, nLines,
+                                       GDT_Byte, nDstBands, nullptr,
+                                       nDstBands, nLineSpace, 1);
+            if( eIOErr == CE_None && pabyMask )
+                eIOErr = GDALRasterIO(psCtx->hMaskBand, GF_Write,
+                                    0, nChunkYOff, nXSize, nLines,
+                                    pabyMask, nXSize, nLines,
+                                    GDT_Byte, 0, 0);
+            if( eIOErr != CE_None )
+                return eIOErr;
+        }
+
+        {
+            std::lock_guard<std::mutex> oLock(psCtx->oMutex);
+            psCtx->nLinesDone += nLines;
+        }
+        psCtx->oCV.notify_one();
+    }
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                      NearblackStrip::Process()                       */
+/************************************************************************/
+
+void NearblackStrip::Process(void* pData)
+{
+    NearblackStrip* psStrip = static_cast<NearblackStrip*>(pData);
+    NearblackContext* psCtx = psStrip->psContext;
+
+    CPLInstallErrorHandlerAccumulator(psStrip->aoErrors);
+    psStrip->eErr = psStrip->Run();
+    CPLUninstallErrorHandlerAccumulator();
+
+    {
+        std::lock_guard<std::mutex> oLock(psCtx->oMutex);
+        psStrip->bDone = true;
+    }
+    psCtx->oCV.notify_one();
+}
+
+} // namespace
+
+/************************************************************************/
+/*                       NearblackMultiThreaded()                       */
+/*                                                                      */
+/*      Returns false if the multi-threaded implementation cannot be    */
+/*      used, in which case nothing has been done. Otherwise bOK is set */
+/*      to whether processing succeeded.                                */
+/************************************************************************/
+
+static bool NearblackMultiThreaded( GDALDatasetH hSrcDataset,
+                                    GDALDatasetH hDstDS,
+                                    GDALRasterBandH hMaskBand,
+                                    int nSrcBands, int nDstBands,
+                                    int nNearDist, int nMaxNonBlack,
+                                    bool bNearWhite, bool bSetAlpha,
+                                    const Colors& oColors, int nThreads,
+                                    GDALProgressFunc pfnProgress,
+                                    void *pProgressData, bool& bOK )
+{
+    const int nXSize = GDALGetRasterXSize(hSrcDataset);
+    const int nYSize = GDALGetRasterYSize(hSrcDataset);
+
+    // Several strips per thread for load balancing, but not too thin ones.
+    constexpr int MIN_LINES_PER_STRIP = 16;
+    const int nStrips =
+        std::min(4 * nThreads, nYSize / MIN_LINES_PER_STRIP);
+    if( nStrips < 2 || nXSize == 0 )
+        return false;
+
+    CPLWorkerThreadPool* poThreadPool = GDALGetGlobalThreadPool(nThreads);
+    if( poThreadPool == nullptr )
+        return false;
+
+    NearblackContext sCtx;
+    sCtx.hSrcDS = hSrcDataset;
+    sCtx.hDstDS = hDstDS;
+    sCtx.hMaskBand = hMaskBand;
+    sCtx.nXSize = nXSize;
+    sCtx.nSrcBands = nSrcBands;
+    sCtx.nDstBands = nDstBands;
+    sCtx.nNearDist = nNearDist;
+    sCtx.nMaxNonBlack = nMaxNonBlack;
+    sCtx.bNearWhite = bNearWhite;
+    sCtx.bSetAlpha = bSetAlpha;
+    sCtx.poColors = &oColors;
+    // About 1 MB per dataset access.
+    sCtx.nLinesPerIO = std::max(1, static_cast<int>(
+        1024 * 1024 / (static_cast<GIntBig>(nXSize) * nDstBands)));
+
+    std::vector<NearblackStrip> asStrips(nStrips);
+    for( int i = 0; i < nStrips; i++ )
+    {
+        NearblackStrip& sStrip = asStrips[i];
+        sStrip.psContext = &sCtx;
+        sStrip.nYOff = static_cast<int>(
+            static_cast<GIntBig>(i) * nYSize / nStrips);
+        sStrip.nYSize = static_cast<int>(
+            static_cast<GIntBig>(i + 1) * nYSize / nStrips) - sStrip.nYOff;
+    }
+
+    CPLDebug("NEARBLACK", "Processing %d strips of lines with %d threads",
+             nStrips, nThreads);
+
+    // The three stages are given an equal share of the progress.
+    const auto RunStage = [&](NearblackStage eStage, int iStage)
+    {
+        auto poJobQueue = poThreadPool->CreateJobQueue();
+        sCtx.nLinesDone = 0;
+        for( auto& sStrip: asStrips )
+        {
+            sStrip.eStage = eStage;
+            sStrip.bDone = false;
+            sStrip.aoErrors.clear();
+            if( !poJobQueue->SubmitJob(NearblackStrip::Process, &sStrip) )
+                NearblackStrip::Process(&sStrip);
+        }
+
+        {
+            std::unique_lock<std::mutex> oLock(sCtx.oMutex);
+            while( true )
+            {
+                bool bAllDone = true;
+                for( const auto& sStrip: asStrips )
+                    bAllDone &= sStrip.bDone;
+                if( bAllDone )
+                    break;
+                sCtx.oCV.wait(oLock);
+                if( !sCtx.bStop )
+                {
+                    const double dfProgress =
+                        (iStage + static_cast<double>(sCtx.nLinesDone) /
+                                      nYSize) / 3;
+                    oLock.unlock();
+                    const bool bContinue =
+                        pfnProgress(dfProgress, nullptr, pProgressData) != 0;
+                    oLock.lock();
+                    if( !bContinue )
+                        sCtx.bStop = true;
+                }
+            }
+        }
+        poJobQueue->WaitCompletion();
+
+        bool bStageOK = !sCtx.bStop;
+        for( const auto& sStrip: asStrips )
+        {
+            for( const auto& oError: sStrip.aoErrors )
+                CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+            if( sStrip.eErr != CE_None )
+                bStageOK = false;
+        }
+        return bStageOK;
+    };
+
+    // Propagates the saturated counts of the strips, in the direction of
+    // the pass, to get the state at the start of each strip.
+    const int nSaturatedCount =
+        nMaxNonBlack < INT_MAX ? nMaxNonBlack + 1 : INT_MAX;
+    const auto AccumulateCounts = [nSaturatedCount](
+        std::vector<int>& anCounts, const std::vector<int>& anStripCounts)
+    {
+        for( size_t i = 0; i < anCounts.size(); i++ )
+        {
+            anCounts[i] = static_cast<int>(std::min(
+                static_cast<GIntBig>(anCounts[i]) + anStripCounts[i],
+                static_cast<GIntBig>(nSaturatedCount)));
+        }
+    };
+
+    bOK = RunStage(NearblackStage::COUNT_SOURCE, 0);
+    if( bOK )
+    {
+        std::vector<int> anCounts(nXSize, 0);
+        for( auto& sStrip: asStrips )
+        {
+            sStrip.anTopDownCounts = anCounts;
+            AccumulateCounts(anCounts, sStrip.anSrcNonBlackCounts);
+            std::vector<int>().swap(sStrip.anSrcNonBlackCounts);
+        }
+        bOK = RunStage(NearblackStage::TOP_DOWN, 1);
+    }
+    if( bOK )
+    {
+        std::vector<int> anCounts(nXSize, 0);
+        for( auto oIter = asStrips.rbegin(); oIter != asStrips.rend(); ++oIter )
+        {
+            oIter->anBottomUpCounts = anCounts;
+            AccumulateCounts(anCounts, oIter->anDstNonBlackCounts);
+            std::vector<int>().swap(oIter->anDstNonBlackCounts);
+        }
+        bOK = RunStage(NearblackStage::BOTTOM_UP, 2);
+    }
+    if( bOK && !pfnProgress(1.0, nullptr, pProgressData) )
+        bOK = false;
+
+    return true;
+}
+
 /************************************************************************/
 /*                            IsInt()                                   */
 /************************************************************************/
@@ -90,7 +90,7 @@ static void Usage( const char* pszAdditionalMsg = nullptr, bool bShort = true )
         "               [-clipdstwhere expression]\n"
         "               [-wrapdateline][-datelineoffset val]\n"
         "               [[-simplify tolerance] | [-segmentize max_dist]]\n"
-        "               [-makevalid]\n"
+        "               [-makevalid] [-num_threads N|ALL_CPUS]\n"
         "               [-addfields] [-unsetFid] [-emptyStrAsNull]\n"
         "               [-relaxedFieldNameMatch] [-forceNullable] [-unsetDefault]\n"
         "               [-fieldTypeToString All|(type1[,type2]*)] [-unsetFieldWidth]\n"
@@ -152,6 +152,7 @@ static void Usage( const char* pszAdditionalMsg = nullptr, bool bShort = true )
         " -simplify tolerance: distance tolerance for simplification.\n"
         " -segmentize max_dist: maximum distance between 2 nodes.\n"
         "                       Used to create intermediate points\n"
+        " -num_threads N|ALL_CPUS: number of threads used to process geometries\n"
         " -dsco NAME=VALUE: Dataset creation option (format specific)\n"
         " -lco  NAME=VALUE: Layer creation option (format specific)\n"
         " -oo   NAME=VALUE: Input dataset open option (format specific)\n"
@@ -51,12 +51,15 @@
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_progress.h"
+#include "cpl_quad_tree.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_alg.h"
 #include "gdal_alg_priv.h"
 #include "gdal_priv.h"
+#include "gdal_thread_pool.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
 #include "ogr_feature.h"
@@ -365,6 +368,10 @@ struct GDALVectorTranslateOptions
 
     /*! Maximum number of features, or -1 if no limit. */
     GIntBig nLimit;
+
+    /*! Number of threads used to process geometries (0 = value of
+        GDAL_NUM_THREADS) */
+    int nNumThreads;
 };
 
 struct TargetLayerInfo
@@ -436,6 +443,50 @@ public:
                                       GIntBig& nTotalEventsDone);
 };
 
+/************************************************************************/
+/*                           GeometryClipper                            */
+/*                                                                      */
+/*      Clips geometries with a clipping geometry that may be made of   */
+/*      many polygons, like the ones collected by LoadGeometry(). The   */
+/*      polygons are kept separate and indexed with a quadtree, so that */
+/*      a geometry is only tested against, and intersected with, the    */
+/*      polygons whose envelope intersects its own.                     */
+/************************************************************************/
+
+class GeometryClipper
+{
+    CPL_DISALLOW_COPY_ASSIGN(GeometryClipper)
+
+    // Immutable once built, and shared by the clippers of the threads.
+    struct Index
+    {
+        CPL_DISALLOW_COPY_ASSIGN(Index)
+
+        std::vector<const OGRGeometry*> apoParts{};
+        std::vector<OGREnvelope>        aoEnvelopes{};
+        CPLQuadTree                    *hQuadTree = nullptr;
+
+        Index() = default;
+        ~Index();
+    };
+
+    std::shared_ptr<const Index> m_poIndex{};
+    // Prepared geometries of the parts, created on first use. They cannot
+    // be shared between threads, hence are owned by each clipper.
+    std::vector<OGRPreparedGeometryUniquePtr> m_apoPrepared{};
+
+    GeometryClipper() = default;
+
+    OGRPreparedGeometry* GetPrepared(int iPart);
+
+  public:
+    explicit GeometryClipper(const OGRGeometry* poClip);
+
+    std::unique_ptr<GeometryClipper> Clone() const;
+
+    OGRGeometry* Clip(OGRGeometry* poGeom);
+};
+
 class LayerTranslator
 {
 public:
@@ -456,11 +507,34 @@ public:
     double                        m_dfGeomOpParam;
     OGRGeometry                  *m_poClipSrc;
     OGRGeometry                  *m_poClipDst;
+    std::unique_ptr<GeometryClipper> m_poClipSrcClipper{};
+    std::unique_ptr<GeometryClipper> m_poClipDstClipper{};
     bool                          m_bExplodeCollections;
     bool                          m_bNativeData;
     GIntBig                       m_nLimit;
+    int                           m_nNumThreads = 1;
     OGRGeometryFactory::TransformWithOptionsCache m_transformWithOptionsCache;
 
+    enum class GeomProcessingStatus
+    {
+        OK,
+        SKIP_FEATURE,
+        REPROJECTION_FAILED
+    };
+
+    GeomProcessingStatus ProcessGeometry(
+                        OGRGeometry*& poDstGeometry,
+                        const OGRFeature* poFeature,
+                        int iSrcZField,
+                        OGRwkbGeometryType eDstLayerGeomType,
+                        OGRCoordinateTransformation* poCT,
+                        char** papszTransformOptions,
+                        OGRSpatialReference* poOutputSRS,
+                        GeometryClipper* poClipSrcClipper,
+                        GeometryClipper* poClipDstClipper,
+                        const OGRGeometryFactory::TransformWithOptionsCache&
+                                                    oTransformCache) const;
+
     int                 Translate(OGRFeature* poFeatureIn,
                                   TargetLayerInfo* psInfo,
                                   GIntBig nCountLayerFeatures,
@@ -2613,9 +2687,24 @@ GDALDatasetH GDALVectorTranslate( const char *pszDest, GDALDatasetH hDstDS, int
     oTranslator.m_dfGeomOpParam = psOptions->dfGeomOpParam;
     oTranslator.m_poClipSrc = reinterpret_cast<OGRGeometry*>(psOptions->hClipSrc);
     oTranslator.m_poClipDst = reinterpret_cast<OGRGeometry*>(psOptions->hClipDst);
+    if( oTranslator.m_poClipSrc )
+        oTranslator.m_poClipSrcClipper.reset(
+            new GeometryClipper(oTranslator.m_poClipSrc));
+    if( oTranslator.m_poClipDst )
+        oTranslator.m_poClipDstClipper.reset(
+            new GeometryClipper(oTranslator.m_poClipDst));
     oTranslator.m_bExplodeCollections = psOptions->bExplodeCollections;
     oTranslator.m_bNativeData = psOptions->bNativeData;
     oTranslator.m_nLimit = psOptions->nLimit;
+    int nNumThreads = psOptions->nNumThreads;
+    if( nNumThreads == 0 )
+    {
+        const char* pszNumThreads =
+            CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+        nNumThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+            CPLGetNumCPUs() : atoi(pszNumThreads);
+    }
+    oTranslator.m_nNumThreads = std::max(1, std::min(128, nNumThreads));
 
     if( psOptions->nGroupTransactions )
     {
@@ -4579,6 +4668,572 @@ static bool SetupCT( TargetLayerInfo* psInfo,
     return true;
 }
 
+/************************************************************************/
+/*                   GeometryClipper::Index::~Index()                   */
+/************************************************************************/
+
+GeometryClipper::Index::~Index()
+{
+    if( hQuadTree )
+        CPLQuadTreeDestroy(hQuadTree);
+}
+
+/************************************************************************/
+/*                   GeometryClipper::GeometryClipper()                 */
+/************************************************************************/
+
+GeometryClipper::GeometryClipper(const OGRGeometry* poClip)
+{
+    std::shared_ptr<Index> poIndex = std::make_shared<Index>();
+    if( OGR_GT_IsSubClassOf(wkbFlatten(poClip->getGeometryType()),
+                            wkbGeometryCollection) )
+    {
+        for( const auto* poPart: *(poClip->toGeometryCollection()) )
+        {
+            if( !poPart->IsEmpty() )
+                poIndex->apoParts.push_back(poPart);
+        }
+    }
+    else
+    {
+        poIndex->apoParts.push_back(poClip);
+    }
+
+    OGREnvelope sGlobalEnvelope;
+    for( const auto* poPart: poIndex->apoParts )
+    {
+        OGREnvelope sEnvelope;
+        poPart->getEnvelope(&sEnvelope);
+        poIndex->aoEnvelopes.push_back(sEnvelope);
+        sGlobalEnvelope.Merge(sEnvelope);
+    }
+
+    if( poIndex->apoParts.size() > 1 )
+    {
+        CPLRectObj sGlobalBounds;
+        sGlobalBounds.minx = sGlobalEnvelope.MinX;
+        sGlobalBounds.miny = sGlobalEnvelope.MinY;
+        sGlobalBounds.maxx = sGlobalEnvelope.MaxX;
+        sGlobalBounds.maxy = sGlobalEnvelope.MaxY;
+        poIndex->hQuadTree = CPLQuadTreeCreate(&sGlobalBounds, nullptr);
+        CPLQuadTreeSetMaxDepth(poIndex->hQuadTree,
+            CPLQuadTreeGetAdvisedMaxDepth(
+                static_cast<int>(poIndex->apoParts.size())));
+        // Indices are stored shifted by one, since nullptr is not a valid
+        // feature.
+        for( size_t i = 0; i < poIndex->apoParts.size(); i++ )
+        {
+            const OGREnvelope& sEnvelope = poIndex->aoEnvelopes[i];
+            CPLRectObj sRect;
+            sRect.minx = sEnvelope.MinX;
+            sRect.miny = sEnvelope.MinY;
+            sRect.maxx = sEnvelope.MaxX;
+            sRect.maxy = sEnvelope.MaxY;
+            CPLQuadTreeInsertWithBounds(
+                poIndex->hQuadTree,
+                reinterpret_cast<void*>(static_cast<GUIntptr_t>(i + 1)),
+                &sRect);
+        }
+    }
+
+    m_apoPrepared.resize(poIndex->apoParts.size());
+    m_poIndex = std::move(poIndex);
+}
+
+/************************************************************************/
+/*                       GeometryClipper::Clone()                       */
+/*                                                                      */
+/*      Returns a clipper sharing the index of this one, to be used     */
+/*      by another thread.                                              */
+/************************************************************************/
+
+std::unique_ptr<GeometryClipper> GeometryClipper::Clone() const
+{
+    std::unique_ptr<GeometryClipper> poClone(new GeometryClipper());
+    poClone->m_poIndex = m_poIndex;
+    poClone->m_apoPrepared.resize(m_apoPrepared.size());
+    return poClone;
+}
+
+/************************************************************************/
+/*                    GeometryClipper::GetPrepared()                    */
+/************************************************************************/
+
+OGRPreparedGeometry* GeometryClipper::GetPrepared(int iPart)
+{
+    if( !OGRHasPreparedGeometrySupport() )
+        return nullptr;
+    if( !m_apoPrepared[iPart] )
+    {
+        m_apoPrepared[iPart].reset(OGRCreatePreparedGeometry(
+            OGRGeometry::ToHandle(
+                const_cast<OGRGeometry*>(m_poIndex->apoParts[iPart]))));
+    }
+    return m_apoPrepared[iPart].get();
+}
+
+/************************************************************************/
+/*                       GeometryClipper::Clip()                        */
+/*                                                                      */
+/*      Clip poGeom, which is consumed. Returns nullptr if the result   */
+/*      is empty. Prepared geometries, if available, are used to avoid  */
+/*      computing the intersection with the polygons that fully         */
+/*      contain, or do not intersect, the geometry.                     */
+/************************************************************************/
+
+OGRGeometry* GeometryClipper::Clip( OGRGeometry* poGeom )
+{
+    const Index& oIndex = *m_poIndex;
+    OGREnvelope sEnvelope;
+    poGeom->getEnvelope(&sEnvelope);
+
+    std::vector<int> anCandidates;
+    if( oIndex.hQuadTree )
+    {
+        CPLRectObj sRect;
+        sRect.minx = sEnvelope.MinX;
+        sRect.miny = sEnvelope.MinY;
+        sRect.maxx = sEnvelope.MaxX;
+        sRect.maxy = sEnvelope.MaxY;
+        int nFeatureCount = 0;
+        void** pahFeatures = CPLQuadTreeSearch(oIndex.hQuadTree, &sRect,
+                                               &nFeatureCount);
+        for( int i = 0; i < nFeatureCount; i++ )
+        {
+            anCandidates.push_back(static_cast<int>(
+                reinterpret_cast<GUIntptr_t>(pahFeatures[i]) - 1));
+        }
+        CPLFree(pahFeatures);
+        std::sort(anCandidates.begin(), anCandidates.end());
+    }
+    else if( !oIndex.apoParts.empty() )
+    {
+        anCandidates.push_back(0);
+    }
+
+    std::vector<std::unique_ptr<OGRGeometry>> apoPieces;
+    for( const int iPart: anCandidates )
+    {
+        if( !oIndex.aoEnvelopes[iPart].Intersects(sEnvelope) )
+            continue;
+        OGRPreparedGeometry* poPrepared = GetPrepared(iPart);
+        if( poPrepared )
+        {
+            if( !OGRPreparedGeometryIntersects(poPrepared,
+                                               OGRGeometry::ToHandle(poGeom)) )
+            {
+                continue;
+            }
+            // Fully inside one of the polygons, hence inside their union.
+            if( OGRPreparedGeometryContains(poPrepared,
+                                            OGRGeometry::ToHandle(poGeom)) )
+            {
+                return poGeom;
+            }
+        }
+        std::unique_ptr<OGRGeometry> poPiece(
+            poGeom->Intersection(oIndex.apoParts[iPart]));
+        if( poPiece && !poPiece->IsEmpty() )
+            apoPieces.emplace_back(std::move(poPiece));
+    }
+    delete poGeom;
+
+    if( apoPieces.empty() )
+        return nullptr;
+
+    // Merge the pieces clipped by adjacent or overlapping polygons.
+    std::unique_ptr<OGRGeometry> poClipped(std::move(apoPieces[0]));
+    for( size_t i = 1; poClipped && i < apoPieces.size(); ++i )
+        poClipped.reset(poClipped->Union(apoPieces[i].get()));
+    if( poClipped == nullptr || poClipped->IsEmpty() )
+        return nullptr;
+    return poClipped.release();
+}
+
+/************************************************************************/
+/*                      GeometryProcessingPipeline                      */
+/*                                                                      */
+/*      Reads source features by batches in the calling thread, and     */
+/*      processes the geometries of a batch with worker threads while   */
+/*      the features of the previous batch are written. Drivers are     */
+/*      only accessed from the calling thread, and features are         */
+/*      returned in their reading order.                                */
+/************************************************************************/
+
+class GeometryProcessingPipeline
+{
+    CPL_DISALLOW_COPY_ASSIGN(GeometryProcessingPipeline)
+
+    // Per-thread state, as coordinate transformations, prepared geometries
+    // and the dateline wrapping cache cannot be shared between threads.
+    struct Context
+    {
+        std::unique_ptr<OGRCoordinateTransformation> poCT{};
+        std::unique_ptr<GeometryClipper> poClipSrcClipper{};
+        std::unique_ptr<GeometryClipper> poClipDstClipper{};
+        OGRGeometryFactory::TransformWithOptionsCache oTransformCache{};
+    };
+
+    struct Item
+    {
+        OGRFeatureUniquePtr poFeature{};
+        std::unique_ptr<OGRGeometry> poGeometry{};
+        LayerTranslator::GeomProcessingStatus eStatus =
+            LayerTranslator::GeomProcessingStatus::OK;
+    };
+
+    struct Job
+    {
+        GeometryProcessingPipeline* poPipeline = nullptr;
+        Context* psContext = nullptr;
+        size_t nStart = 0;
+        size_t nEnd = 0;
+    };
+
+    const LayerTranslator* m_poTranslator;
+    TargetLayerInfo* m_psInfo;
+    OGRSpatialReference* m_poOutputSRS;
+    const int m_nThreads;
+    OGRwkbGeometryType m_eDstLayerGeomType = wkbUnknown;
+    GIntBig m_nRemaining = -1;
+    bool m_bEOF = false;
+    bool m_bReadError = false;
+    bool m_bStarted = false;
+
+    std::vector<std::unique_ptr<Context>> m_apoContexts{};
+    std::unique_ptr<CPLJobQueue> m_poJobQueue{};
+    std::vector<Job> m_asJobs{};
+    std::vector<Item> m_aoCurrent{};
+    size_t m_iCurrent = 0;
+    std::vector<Item> m_aoNext{};
+
+    static constexpr size_t FEATURES_PER_JOB = 256;
+
+    static void ProcessJob(void* pData);
+    void ReadAndSubmitNextBatch();
+
+  public:
+    GeometryProcessingPipeline(const LayerTranslator* poTranslator,
+                               TargetLayerInfo* psInfo,
+                               OGRSpatialReference* poOutputSRS,
+                               int nThreads):
+        m_poTranslator(poTranslator),
+        m_psInfo(psInfo),
+        m_poOutputSRS(poOutputSRS),
+        m_nThreads(nThreads)
+    {}
+
+    ~GeometryProcessingPipeline()
+    {
+        if( m_poJobQueue )
+            m_poJobQueue->WaitCompletion();
+    }
+
+    bool Init();
+    OGRFeature* GetNextFeature(std::unique_ptr<OGRGeometry>& poGeometry,
+                               LayerTranslator::GeomProcessingStatus& eStatus);
+
+    /** Whether reading the source layer ended with an error */
+    bool HasReadError() const { return m_bReadError; }
+};
+
+constexpr size_t GeometryProcessingPipeline::FEATURES_PER_JOB;
+
+/************************************************************************/
+/*                 GeometryProcessingPipeline::Init()                   */
+/************************************************************************/
+
+bool GeometryProcessingPipeline::Init()
+{
+    const LayerTranslator* poTr = m_poTranslator;
+    OGRCoordinateTransformation* poCT = m_psInfo->m_apoCT[0].get();
+
+    // Not worth the overhead if there is nothing expensive to do
+    if( poCT == nullptr &&
+        m_psInfo->m_aosTransformOptions[0].List() == nullptr &&
+        poTr->m_poClipSrc == nullptr && poTr->m_poClipDst == nullptr &&
+        !poTr->m_bMakeValid && poTr->m_eGeomOp == GEOMOP_NONE )
+    {
+        return false;
+    }
+
+    CPLWorkerThreadPool* poPool = GDALGetGlobalThreadPool(m_nThreads);
+    if( poPool == nullptr )
+        return false;
+
+    for( int i = 0; i < m_nThreads; ++i )
+    {
+        std::unique_ptr<Context> psContext(new Context());
+        if( poCT )
+        {
+            psContext->poCT.reset(poCT->Clone());
+            if( !psContext->poCT )
+            {
+                CPLDebug("GDALVectorTranslate",
+                         "Coordinate transformation cannot be cloned. "
+                         "Processing geometries in a single thread");
+                return false;
+            }
+        }
+        if( poTr->m_poClipSrcClipper )
+            psContext->poClipSrcClipper = poTr->m_poClipSrcClipper->Clone();
+        if( poTr->m_poClipDstClipper )
+            psContext->poClipDstClipper = poTr->m_poClipDstClipper->Clone();
+        m_apoContexts.push_back(std::move(psContext));
+    }
+    m_asJobs.resize(m_nThreads);
+    m_poJobQueue = poPool->CreateJobQueue();
+
+    m_eDstLayerGeomType = m_psInfo->m_poDstLayer->GetLayerDefn()->
+                                            GetGeomFieldDefn(0)->GetType();
+    if( poTr->m_nLimit >= 0 )
+        m_nRemaining = std::max(static_cast<GIntBig>(0),
+                                poTr->m_nLimit - m_psInfo->m_nFeaturesRead);
+
+    CPLDebug("GDALVectorTranslate",
+             "Processing geometries of layer %s with %d threads",
+             m_psInfo->m_poSrcLayer->GetName(), m_nThreads);
+    return true;
+}
+
+/************************************************************************/
+/*              GeometryProcessingPipeline::ProcessJob()                */
+/************************************************************************/
+
+void GeometryProcessingPipeline::ProcessJob(void* pData)
+{
+    Job* psJob = static_cast<Job*>(pData);
+    GeometryProcessingPipeline* poThis = psJob->poPipeline;
+    Context* psContext = psJob->psContext;
+    TargetLayerInfo* psInfo = poThis->m_psInfo;
+    for( size_t i = psJob->nStart; i < psJob->nEnd; ++i )
+    {
+        Item& oItem = poThis->m_aoNext[i];
+        if( !oItem.poGeometry )
+            continue;
+        OGRGeometry* poGeometry = oItem.poGeometry.release();
+        oItem.eStatus = poThis->m_poTranslator->ProcessGeometry(
+            poGeometry, oItem.poFeature.get(), psInfo->m_iSrcZField,
+            poThis->m_eDstLayerGeomType,
+            psContext->poCT.get(),
+            psInfo->m_aosTransformOptions[0].List(),
+            poThis->m_poOutputSRS,
+            psContext->poClipSrcClipper.get(),
+            psContext->poClipDstClipper.get(),
+            psContext->oTransformCache);
+        oItem.poGeometry.reset(poGeometry);
+    }
+}
+
+/************************************************************************/
+/*        GeometryProcessingPipeline::ReadAndSubmitNextBatch()          */
+/************************************************************************/
+
+void GeometryProcessingPipeline::ReadAndSubmitNextBatch()
+{
+    m_aoNext.clear();
+    OGRLayer* poSrcLayer = m_psInfo->m_poSrcLayer;
+    const bool bStealDefaultGeometry =
+        poSrcLayer->GetLayerDefn()->GetGeomFieldCount() == 1;
+    const size_t nBatchSize = FEATURES_PER_JOB * m_apoContexts.size();
+    while( !m_bEOF && m_aoNext.size() < nBatchSize && m_nRemaining != 0 )
+    {
+        OGRFeature* poFeature = poSrcLayer->GetNextFeature();
+        if( poFeature == nullptr )
+        {
+            m_bEOF = true;
+            m_bReadError = CPLGetLastErrorType() == CE_Failure;
+            break;
+        }
+        if( m_nRemaining > 0 )
+            m_nRemaining --;
+        Item oItem;
+        oItem.poFeature.reset(poFeature);
+        oItem.poGeometry.reset(bStealDefaultGeometry ?
+            poFeature->StealGeometry() :
+            poFeature->StealGeometry(m_psInfo->m_iRequestedSrcGeomField));
+        m_aoNext.push_back(std::move(oItem));
+    }
+    if( m_aoNext.empty() )
+        return;
+
+    const size_t nJobs = std::min(m_apoContexts.size(),
+        (m_aoNext.size() + FEATURES_PER_JOB - 1) / FEATURES_PER_JOB);
+    const size_t nPerJob = (m_aoNext.size() + nJobs - 1) / nJobs;
+    for( size_t i = 0; i < nJobs; ++i )
+    {
+        Job& sJob = m_asJobs[i];
+        sJob.poPipeline = this;
+        sJob.psContext = m_apoContexts[i].get();
+        sJob.nStart = i * nPerJob;
+        sJob.nEnd = std::min(m_aoNext.size(), (i + 1) * nPerJob);
+        if( sJob.nStart < sJob.nEnd )
+            m_poJobQueue->SubmitJob(ProcessJob, &sJob);
+    }
+}
+
+/************************************************************************/
+/*            GeometryProcessingPipeline::GetNextFeature()              */
+/************************************************************************/
+
+OGRFeature* GeometryProcessingPipeline::GetNextFeature(
+                        std::unique_ptr<OGRGeometry>& poGeometry,
+                        LayerTranslator::GeomProcessingStatus& eStatus)
+{
+    if( m_iCurrent == m_aoCurrent.size() )
+    {
+        if( !m_bStarted )
+        {
+            m_bStarted = true;
+            ReadAndSubmitNextBatch();
+        }
+        m_poJobQueue->WaitCompletion();
+        std::swap(m_aoCurrent, m_aoNext);
+        m_iCurrent = 0;
+        if( m_aoCurrent.empty() )
+            return nullptr;
+        // Process the next batch while the current one is written
+        ReadAndSubmitNextBatch();
+    }
+
+    Item& oItem = m_aoCurrent[m_iCurrent++];
+    poGeometry = std::move(oItem.poGeometry);
+    eStatus = oItem.eStatus;
+    return oItem.poFeature.release();
+}
+
+/************************************************************************/
+/*                  LayerTranslator::ProcessGeometry()                  */
+/*                                                                      */
+/*      Apply the geometry operations requested by the user (Z field,   */
+/*      coordinate dimension, simplification, clipping, reprojection,  */
+/*      validity fixing and type conversion) to poDstGeometry, which    */
+/*      is owned and may be replaced. This only reads the state of the  */
+/*      translator and of poFeature, so it can be called concurrently   */
+/*      with different coordinate transformations, prepared geometries  */
+/*      and caches.                                                     */
+/************************************************************************/
+
+LayerTranslator::GeomProcessingStatus LayerTranslator::ProcessGeometry(
+                        OGRGeometry*& poDstGeometry,
+                        const OGRFeature* poFeature,
+                        int iSrcZField,
+                        OGRwkbGeometryType eDstLayerGeomType,
+                        OGRCoordinateTransformation* poCT,
+                        char** papszTransformOptions,
+                        OGRSpatialReference* poOutputSRS,
+                        GeometryClipper* poClipSrcClipper,
+                        GeometryClipper* poClipDstClipper,
+                        const OGRGeometryFactory::TransformWithOptionsCache&
+                                                    oTransformCache) const
+{
+    if (iSrcZField != -1)
+    {
+        SetZ(poDstGeometry, poFeature->GetFieldAsDouble(iSrcZField));
+        /* This will correct the coordinate dimension to 3 */
+        OGRGeometry* poDupGeometry = poDstGeometry->clone();
+        delete poDstGeometry;
+        poDstGeometry = poDupGeometry;
+    }
+
+    if (m_nCoordDim == 2 || m_nCoordDim == 3)
+    {
+        poDstGeometry->setCoordinateDimension( m_nCoordDim );
+    }
+    else if (m_nCoordDim == 4)
+    {
+        poDstGeometry->set3D( TRUE );
+        poDstGeometry->setMeasured( TRUE );
+    }
+    else if (m_nCoordDim == COORD_DIM_XYM)
+    {
+        poDstGeometry->set3D( FALSE );
+        poDstGeometry->setMeasured( TRUE );
+    }
+    else if ( m_nCoordDim == COORD_DIM_LAYER_DIM )
+    {
+        poDstGeometry->set3D( wkbHasZ(eDstLayerGeomType) );
+        poDstGeometry->setMeasured( wkbHasM(eDstLayerGeomType) );
+    }
+
+    if (m_eGeomOp == GEOMOP_SEGMENTIZE)
+    {
+        if (m_dfGeomOpParam > 0)
+            poDstGeometry->segmentize(m_dfGeomOpParam);
+    }
+    else if (m_eGeomOp == GEOMOP_SIMPLIFY_PRESERVE_TOPOLOGY)
+    {
+        if (m_dfGeomOpParam > 0)
+        {
+            OGRGeometry* poNewGeom = poDstGeometry->SimplifyPreserveTopology(m_dfGeomOpParam);
+            if (poNewGeom)
+            {
+                delete poDstGeometry;
+                poDstGeometry = poNewGeom;
+            }
+        }
+    }
+
+    if (m_poClipSrc)
+    {
+        poDstGeometry = poClipSrcClipper->Clip(poDstGeometry);
+        if (poDstGeometry == nullptr)
+            return GeomProcessingStatus::SKIP_FEATURE;
+    }
+
+    if( poCT != nullptr || papszTransformOptions != nullptr)
+    {
+        OGRGeometry* poReprojectedGeom =
+            OGRGeometryFactory::transformWithOptions(
+                poDstGeometry, poCT, papszTransformOptions, oTransformCache);
+        delete poDstGeometry;
+        poDstGeometry = poReprojectedGeom;
+        if( poDstGeometry == nullptr )
+            return GeomProcessingStatus::REPROJECTION_FAILED;
+    }
+    else if (poOutputSRS != nullptr)
+    {
+        poDstGeometry->assignSpatialReference(poOutputSRS);
+    }
+
+    if (m_poClipDst)
+    {
+        poDstGeometry = poClipDstClipper->Clip(poDstGeometry);
+        if (poDstGeometry == nullptr)
+            return GeomProcessingStatus::SKIP_FEATURE;
+    }
+
+    if( m_bMakeValid )
+    {
+        OGRGeometry* poValidGeom = poDstGeometry->MakeValid();
+        delete poDstGeometry;
+        poDstGeometry = poValidGeom;
+        if( poDstGeometry == nullptr )
+            return GeomProcessingStatus::SKIP_FEATURE;
+        OGRGeometry* poCleanedGeom =
+            OGRGeometryFactory::removeLowerDimensionSubGeoms(poDstGeometry);
+        delete poDstGeometry;
+        poDstGeometry = poCleanedGeom;
+    }
+
+    if( m_eGType != GEOMTYPE_UNCHANGED )
+    {
+        poDstGeometry = OGRGeometryFactory::forceTo(
+                poDstGeometry, static_cast<OGRwkbGeometryType>(m_eGType));
+    }
+    else if( m_eGeomTypeConversion == GTC_PROMOTE_TO_MULTI ||
+            m_eGeomTypeConversion == GTC_CONVERT_TO_LINEAR ||
+            m_eGeomTypeConversion == GTC_PROMOTE_TO_MULTI_AND_CONVERT_TO_LINEAR ||
+            m_eGeomTypeConversion == GTC_CONVERT_TO_CURVE )
+    {
+        OGRwkbGeometryType eTargetType = poDstGeometry->getGeometryType();
+        eTargetType = ConvertType(m_eGeomTypeConversion, eTargetType);
+        poDstGeometry = OGRGeometryFactory::forceTo(poDstGeometry, eTargetType);
+    }
+
+    return GeomProcessingStatus::OK;
+}
+
 /************************************************************************/
 /*                     LayerTranslator::Translate()                     */
 /************************************************************************/
@@ -4592,7 +5247,6 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
                                 void *pProgressArg,
                                 GDALVectorTranslateOptions *psOptions )
 {
-    const int eGType = m_eGType;
     OGRSpatialReference* poOutputSRS = m_poOutputSRS;
 
     OGRLayer *poSrcLayer = psInfo->m_poSrcLayer;
@@ -4635,6 +5289,16 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
     GIntBig      nCount = 0; /* written + failed */
     GIntBig      nFeaturesWritten = 0;
 
+    // Geometries can be processed by worker threads when features are read
+    // sequentially and have a single target geometry field.
+    bool bCanUseThreads = m_nNumThreads > 1 && poFeatureIn == nullptr &&
+                          psOptions->nFIDToFetch == OGRNullFID &&
+                          !m_bExplodeCollections &&
+                          nDstGeomFieldCount == 1 &&
+                          (nSrcGeomFieldCount == 1 ||
+                           iRequestedSrcGeomField >= 0);
+    std::unique_ptr<GeometryProcessingPipeline> poPipeline;
+
     bool bRet = true;
     CPLErrorReset();
     while( true )
@@ -4644,16 +5308,35 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
             break;
         }
 
+        // Once the coordinate transformation has been set up from the
+        // first feature, geometries can be processed by worker threads.
+        if( bCanUseThreads && !poPipeline &&
+            psInfo->m_nFeaturesRead > 0 && !psInfo->m_bPerFeatureCT )
+        {
+            poPipeline.reset(new GeometryProcessingPipeline(
+                this, psInfo, poOutputSRS, m_nNumThreads));
+            if( !poPipeline->Init() )
+                poPipeline.reset();
+            bCanUseThreads = false;
+        }
+
+        std::unique_ptr<OGRGeometry> poProcessedGeometry;
+        GeomProcessingStatus eProcessedGeometryStatus =
+            GeomProcessingStatus::OK;
         if( poFeatureIn != nullptr )
             poFeature = poFeatureIn;
         else if( psOptions->nFIDToFetch != OGRNullFID )
             poFeature = poSrcLayer->GetFeature(psOptions->nFIDToFetch);
+        else if( poPipeline )
+            poFeature = poPipeline->GetNextFeature(poProcessedGeometry,
+                                                   eProcessedGeometryStatus);
         else
             poFeature = poSrcLayer->GetNextFeature();
 
         if( poFeature == nullptr )
         {
-            if( CPLGetLastErrorType() == CE_Failure )
+            if( CPLGetLastErrorType() == CE_Failure ||
+                (poPipeline && poPipeline->HasReadError()) )
             {
                 bRet = false;
             }
@@ -4747,12 +5430,11 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
 
             if( nDstGeomFieldCount == 0 && poStolenGeometry && m_poClipSrc )
             {
-                OGRGeometry* poClipped = poStolenGeometry->Intersection(m_poClipSrc);
-                delete poStolenGeometry;
+                OGRGeometry* poClipped =
+                    m_poClipSrcClipper->Clip(poStolenGeometry);
                 poStolenGeometry = nullptr;
-                if (poClipped == nullptr || poClipped->IsEmpty())
+                if (poClipped == nullptr)
                 {
-                    delete poClipped;
                     goto end_loop;
                 }
                 delete poClipped;
@@ -4820,167 +5502,71 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
             for( int iGeom = 0; iGeom < nDstGeomFieldCount; iGeom ++ )
             {
                 OGRGeometry* poDstGeometry;
+                GeomProcessingStatus eStatus;
 
-                if( poCollToExplode && iGeom == iGeomCollToExplode )
-                {
-                    OGRGeometry* poPart = poCollToExplode->getGeometryRef(0);
-                    poCollToExplode->removeGeometry(0, FALSE);
-                    poDstGeometry = poPart;
-                    assert(poDstGeometry);
-                }
-                else
+                if( poPipeline )
                 {
-                    poDstGeometry = poDstFeature->StealGeometry(iGeom);
-                    if (poDstGeometry == nullptr)
+                    // Already processed by a worker thread
+                    poDstGeometry = poProcessedGeometry.release();
+                    eStatus = eProcessedGeometryStatus;
+                    if( poDstGeometry == nullptr &&
+                        eStatus == GeomProcessingStatus::OK )
                         continue;
                 }
-
-                if (iSrcZField != -1)
-                {
-                    SetZ(poDstGeometry, poFeature->GetFieldAsDouble(iSrcZField));
-                    /* This will correct the coordinate dimension to 3 */
-                    OGRGeometry* poDupGeometry = poDstGeometry->clone();
-                    delete poDstGeometry;
-                    poDstGeometry = poDupGeometry;
-                }
-
-                if (m_nCoordDim == 2 || m_nCoordDim == 3)
-                {
-                    poDstGeometry->setCoordinateDimension( m_nCoordDim );
-                }
-                else if (m_nCoordDim == 4)
-                {
-                    poDstGeometry->set3D( TRUE );
-                    poDstGeometry->setMeasured( TRUE );
-                }
-                else if (m_nCoordDim == COORD_DIM_XYM)
-                {
-                    poDstGeometry->set3D( FALSE );
-                    poDstGeometry->setMeasured( TRUE );
-                }
-                else if ( m_nCoordDim == COORD_DIM_LAYER_DIM )
-                {
-                    const OGRwkbGeometryType eDstLayerGeomType =
-                      poDstLayer->GetLayerDefn()->GetGeomFieldDefn(iGeom)->GetType();
-                    poDstGeometry->set3D( wkbHasZ(eDstLayerGeomType) );
-                    poDstGeometry->setMeasured( wkbHasM(eDstLayerGeomType) );
-                }
-
-                if (m_eGeomOp == GEOMOP_SEGMENTIZE)
-                {
-                    if (m_dfGeomOpParam > 0)
-                        poDstGeometry->segmentize(m_dfGeomOpParam);
-                }
-                else if (m_eGeomOp == GEOMOP_SIMPLIFY_PRESERVE_TOPOLOGY)
-                {
-                    if (m_dfGeomOpParam > 0)
-                    {
-                        OGRGeometry* poNewGeom = poDstGeometry->SimplifyPreserveTopology(m_dfGeomOpParam);
-                        if (poNewGeom)
-                        {
-                            delete poDstGeometry;
-                            poDstGeometry = poNewGeom;
-                        }
-                    }
-                }
-
-                if (m_poClipSrc)
+                else
                 {
-                    OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipSrc);
-                    delete poDstGeometry;
-                    if (poClipped == nullptr || poClipped->IsEmpty())
+                    if( poCollToExplode && iGeom == iGeomCollToExplode )
                     {
-                        delete poClipped;
-                        goto end_loop;
+                        OGRGeometry* poPart = poCollToExplode->getGeometryRef(0);
+                        poCollToExplode->removeGeometry(0, FALSE);
+                        poDstGeometry = poPart;
+                        assert(poDstGeometry);
                     }
-                    poDstGeometry = poClipped;
-                }
-
-                OGRCoordinateTransformation* const poCT = psInfo->m_apoCT[iGeom].get();
-                char** const papszTransformOptions = psInfo->m_aosTransformOptions[iGeom].List();
-
-                if( poCT != nullptr || papszTransformOptions != nullptr)
-                {
-                    OGRGeometry* poReprojectedGeom =
-                        OGRGeometryFactory::transformWithOptions(
-                            poDstGeometry, poCT, papszTransformOptions, m_transformWithOptionsCache);
-                    if( poReprojectedGeom == nullptr )
+                    else
                     {
-                        if( psOptions->nGroupTransactions )
-                        {
-                            if( psOptions->nLayerTransaction )
-                            {
-                                if( poDstLayer->CommitTransaction() != OGRERR_NONE &&
-                                    !psOptions->bSkipFailures )
-                                {
-                                    OGRFeature::DestroyFeature( poFeature );
-                                    OGRFeature::DestroyFeature( poDstFeature );
-                                    delete poDstGeometry;
-                                    return false;
-                                }
-                            }
-                        }
-
-                        CPLError( CE_Failure, CPLE_AppDefined, "Failed to reproject feature " CPL_FRMT_GIB " (geometry probably out of source or destination SRS).",
-                                  poFeature->GetFID() );
-                        if( !psOptions->bSkipFailures )
-                        {
-                            OGRFeature::DestroyFeature( poFeature );
-                            OGRFeature::DestroyFeature( poDstFeature );
-                            delete poDstGeometry;
-                            return false;
-                        }
+                        poDstGeometry = poDstFeature->StealGeometry(iGeom);
+                        if (poDstGeometry == nullptr)
+                            continue;
                     }
 
-                    delete poDstGeometry;
-                    poDstGeometry = poReprojectedGeom;
+                    eStatus = ProcessGeometry(
+                        poDstGeometry, poFeature, iSrcZField,
+                        poDstLayer->GetLayerDefn()->GetGeomFieldDefn(iGeom)->GetType(),
+                        psInfo->m_apoCT[iGeom].get(),
+                        psInfo->m_aosTransformOptions[iGeom].List(),
+                        poOutputSRS,
+                        m_poClipSrcClipper.get(),
+                        m_poClipDstClipper.get(),
+                        m_transformWithOptionsCache);
                 }
-                else if (poOutputSRS != nullptr)
+
+                if( eStatus == GeomProcessingStatus::SKIP_FEATURE )
                 {
-                    poDstGeometry->assignSpatialReference(poOutputSRS);
+                    goto end_loop;
                 }
-
-                if( poDstGeometry != nullptr )
+                else if( eStatus == GeomProcessingStatus::REPROJECTION_FAILED )
                 {
-                    if (m_poClipDst)
+                    if( psOptions->nGroupTransactions )
                     {
-                        OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipDst);
-                        delete poDstGeometry;
-                        if (poClipped == nullptr || poClipped->IsEmpty())
+                        if( psOptions->nLayerTransaction )
                         {
-                            delete poClipped;
-                            goto end_loop;
+                            if( poDstLayer->CommitTransaction() != OGRERR_NONE &&
+                                !psOptions->bSkipFailures )
+                            {
+                                OGRFeature::DestroyFeature( poFeature );
+                                OGRFeature::DestroyFeature( poDstFeature );
+                                return false;
+                            }
                         }
-
-                        poDstGeometry = poClipped;
                     }
 
-                    if( m_bMakeValid )
-                    {
-                        OGRGeometry* poValidGeom = poDstGeometry->MakeValid();
-                        delete poDstGeometry;
-                        poDstGeometry = poValidGeom;
-                        if( poDstGeometry == nullptr )
-                            goto end_loop;
-                        OGRGeometry* poCleanedGeom =
-                            OGRGeometryFactory::removeLowerDimensionSubGeoms(poDstGeometry);
-                        delete poDstGeometry;
-                        poDstGeometry = poCleanedGeom;
-                    }
-
-                    if( eGType != GEOMTYPE_UNCHANGED )
-                    {
-                        poDstGeometry = OGRGeometryFactory::forceTo(
-                                poDstGeometry, static_cast<OGRwkbGeometryType>(eGType));
-                    }
-                    else if( m_eGeomTypeConversion == GTC_PROMOTE_TO_MULTI ||
-                            m_eGeomTypeConversion == GTC_CONVERT_TO_LINEAR ||
-                            m_eGeomTypeConversion == GTC_PROMOTE_TO_MULTI_AND_CONVERT_TO_LINEAR ||
-                            m_eGeomTypeConversion == GTC_CONVERT_TO_CURVE )
+                    CPLError( CE_Failure, CPLE_AppDefined, "Failed to reproject feature " CPL_FRMT_GIB " (geometry probably out of source or destination SRS).",
+                              poFeature->GetFID() );
+                    if( !psOptions->bSkipFailures )
                     {
-                        OGRwkbGeometryType eTargetType = poDstGeometry->getGeometryType();
-                        eTargetType = ConvertType(m_eGeomTypeConversion, eTargetType);
-                        poDstGeometry = OGRGeometryFactory::forceTo(poDstGeometry, eTargetType);
+                        OGRFeature::DestroyFeature( poFeature );
+                        OGRFeature::DestroyFeature( poDstFeature );
+                        return false;
                     }
                 }
 
@@ -5249,6 +5835,7 @@ GDALVectorTranslateOptions *GDALVectorTranslateOptionsNew(char** papszArgv,
     psOptions->hSpatialFilter = nullptr;
     psOptions->bNativeData = true;
     psOptions->nLimit = -1;
+    psOptions->nNumThreads = 0;
 
     int nArgc = CSLCount(papszArgv);
     for( int i = 0; papszArgv != nullptr && i < nArgc; i++ )
@@ -5887,6 +6474,26 @@ GDALVectorTranslateOptions *GDALVectorTranslateOptionsNew(char** papszArgv,
         {
             psOptions->nLimit = CPLAtoGIntBig( papszArgv[++i] );
         }
+        else if( i+1 < nArgc && EQUAL(papszArgv[i],"-num_threads") )
+        {
+            ++i;
+            if( EQUAL(papszArgv[i], "ALL_CPUS") )
+            {
+                psOptions->nNumThreads = CPLGetNumCPUs();
+            }
+            else
+            {
+                psOptions->nNumThreads = atoi(papszArgv[i]);
+                if( psOptions->nNumThreads <= 0 )
+                {
+                    CPLError(CE_Failure, CPLE_IllegalArg,
+                             "Invalid value for -num_threads: %s",
+                             papszArgv[i]);
+                    GDALVectorTranslateOptionsFree(psOptions);
+                    return nullptr;
+                }
+            }
+        }
         else if( papszArgv[i][0] == '-' )
         {
             CPLError(CE_Failure, CPLE_NotSupported,
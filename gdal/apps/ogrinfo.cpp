@@ -73,7 +73,7 @@ static void Usage( const char* pszErrorMsg = nullptr )
            "               [-geom={YES/NO/SUMMARY}] [[-oo NAME=VALUE] ...]\n"
            "               [-nomd] [-listmdd] [-mdd domain|`all`]*\n"
            "               [-nocount] [-noextent] [-nogeomtype] [-wkt_format WKT1|WKT2|...]\n"
-           "               [-fielddomain name]\n"
+           "               [-fielddomain name] [-stats-perf]\n"
            "               datasource_name [layer [layer ...]]\n");
 
     if( pszErrorMsg != nullptr )
@@ -767,6 +767,7 @@ MAIN_START(nArgc, papszArgv)
     bool bGeomType = true;
     bool bDatasetGetNextFeature = false;
     bool bReadOnly = false;
+    bool bReportPerfCounters = false;
     bool bUpdate = false;
     const char* pszWKTFormat = "WKT2";
     std::string osFieldDomain;
@@ -952,6 +953,11 @@ MAIN_START(nArgc, papszArgv)
             CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
             pszWKTFormat = papszArgv[++iArg];
         }
+        else if( EQUAL(papszArgv[iArg], "-stats-perf") ||
+                 EQUAL(papszArgv[iArg], "--stats-perf") )
+        {
+            bReportPerfCounters = true;
+        }
         else if( EQUAL(papszArgv[iArg], "-fielddomain") )
         {
             CHECK_HAS_ENOUGH_ADDITIONAL_ARGS(1);
@@ -1299,6 +1305,18 @@ MAIN_START(nArgc, papszArgv)
 /* -------------------------------------------------------------------- */
     GDALClose(poDS);
 
+    if( bReportPerfCounters )
+    {
+        char** papszCounters = GDALGetPerfCounters();
+        printf("Performance Counters:\n");
+        for( char** papszIter = papszCounters;
+             papszIter && *papszIter; ++papszIter )
+        {
+            printf("  %s\n", *papszIter);
+        }
+        CSLDestroy(papszCounters);
+    }
+
 #ifdef __AFL_HAVE_MANUAL_CONTROL
     }
 #else
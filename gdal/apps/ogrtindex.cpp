@@ -484,7 +484,12 @@ MAIN_START(nArgc, papszArgv)
     }
 /* ==================================================================== */
 /*      Process each input datasource in turn.                          */
+/*      Features are written within a single transaction when the       */
+/*      output format supports it.                                      */
 /* ==================================================================== */
+    const bool bInTransaction =
+        poDstDS->StartTransaction(FALSE) == OGRERR_NONE;
+
     for( ; nFirstSourceDataset < nArgc; nFirstSourceDataset++ )
     {
         if( papszArgv[nFirstSourceDataset][0] == '-' )
@@ -812,6 +817,8 @@ MAIN_START(nArgc, papszArgv)
                 fprintf(stderr,
                         "Failed to create feature on tile index. "
                         "Terminating.");
+                if( bInTransaction )
+                    poDstDS->CommitTransaction();
                 GDALClose(poDstDS);
                 exit(1);
             }
@@ -824,6 +831,11 @@ MAIN_START(nArgc, papszArgv)
         GDALClose(poDS);
     }
 
+    if( bInTransaction && poDstDS->CommitTransaction() != OGRERR_NONE )
+    {
+        fprintf(stderr, "Failed to commit features in tile index.\n");
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Close tile index and clear buffers.                             */
 /* -------------------------------------------------------------------- */
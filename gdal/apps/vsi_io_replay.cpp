@@ -0,0 +1,128 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Utilities
+ * Purpose:  Replay of a VSI I/O trace recorded with CPL_VSIL_IO_TRACE_FILE
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+#include "gdal.h"
+
+CPL_CVSID("$Id$")
+
+/************************************************************************/
+/*                               Usage()                                */
+/************************************************************************/
+
+static void Usage()
+{
+    printf("vsi_io_replay [-source_prefix <prefix> -target_prefix <prefix>]\n"
+           "              [-timing fast|original] trace_file\n"
+           "\n"
+           "Replays the file accesses of a trace recorded with\n"
+           "--config CPL_VSIL_IO_TRACE_FILE trace_file, and compares their\n"
+           "durations with the recorded ones.\n");
+    exit(1);
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main( int argc, char ** argv )
+
+{
+    GDALAllRegister();
+
+    argc = GDALGeneralCmdLineProcessor(argc, &argv, 0);
+    if( argc < 1 )
+        exit(-argc);
+
+    const char* pszTraceFilename = nullptr;
+    CPLStringList aosOptions;
+    for( int iArg = 1; iArg < argc; iArg++ )
+    {
+        if( iArg < argc-1 && EQUAL(argv[iArg], "-source_prefix") )
+        {
+            aosOptions.SetNameValue("SOURCE_PREFIX", argv[++iArg]);
+        }
+        else if( iArg < argc-1 && EQUAL(argv[iArg], "-target_prefix") )
+        {
+            aosOptions.SetNameValue("TARGET_PREFIX", argv[++iArg]);
+        }
+        else if( iArg < argc-1 && EQUAL(argv[iArg], "-timing") )
+        {
+            aosOptions.SetNameValue("TIMING", argv[++iArg]);
+        }
+        else if( argv[iArg][0] == '-' || pszTraceFilename != nullptr )
+        {
+            Usage();
+        }
+        else
+        {
+            pszTraceFilename = argv[iArg];
+        }
+    }
+    if( pszTraceFilename == nullptr )
+        Usage();
+
+    const CPLStringList aosStats(
+        VSIIOTraceReplay(pszTraceFilename, aosOptions.List()));
+    int nRet = 0;
+    if( aosStats.empty() )
+    {
+        nRet = 1;
+    }
+    else
+    {
+        printf("%-12s %10s %14s %14s %8s\n",
+               "Operation", "Count", "Recorded (s)", "Replayed (s)", "Ratio");
+        for( const char* pszOp: { "OPEN", "READ", "MULTIRANGE", "STAT",
+                                  "CLOSE" } )
+        {
+            const double dfRecorded = CPLAtof(aosStats.FetchNameValueDef(
+                CPLSPrintf("%s_RECORDED_TIME", pszOp), "0"));
+            const double dfReplayed = CPLAtof(aosStats.FetchNameValueDef(
+                CPLSPrintf("%s_REPLAYED_TIME", pszOp), "0"));
+            printf("%-12s %10s %14.3f %14.3f %8.2f\n",
+                   pszOp,
+                   aosStats.FetchNameValueDef(
+                       CPLSPrintf("%s_COUNT", pszOp), "0"),
+                   dfRecorded, dfReplayed,
+                   dfRecorded > 0 ? dfReplayed / dfRecorded : 0.0);
+        }
+        printf("\n");
+        printf("Bytes read:  %s\n", aosStats.FetchNameValue("READ_BYTES"));
+        printf("Errors:      %s\n", aosStats.FetchNameValue("ERROR_COUNT"));
+        printf("Mismatches:  %s\n", aosStats.FetchNameValue("MISMATCH_COUNT"));
+        printf("Wall time:   %s s\n", aosStats.FetchNameValue("WALL_TIME"));
+    }
+
+    CSLDestroy(argv);
+
+    GDALDestroyDriverManager();
+
+    return nRet;
+}
@@ -57,13 +57,24 @@ static char *szConfiguredFormats = "GDAL_FORMATS";
  *
  * This function should generally be called once at the beginning of the
  * application.
+ *
+ * Drivers built as plugins are loaded from the driver search paths. Starting
+ * with GDAL 3.4, if the GDAL_DEFERRED_PLUGIN_LOADING configuration option is
+ * set to YES, their loading is deferred until they are actually needed (see
+ * GDALDriverManager::DeclareDeferredPlugins()).
  */
 
 void CPL_STDCALL GDALAllRegister()
 
 {
+    // Plugins can also be loaded on demand, once built-in drivers are
+    // registered, to avoid loading their libraries at startup.
+    const bool bDeferredPluginLoading =
+        CPLTestBool(CPLGetConfigOption("GDAL_DEFERRED_PLUGIN_LOADING", "NO"));
+
     // AutoLoadDrivers is a no-op if compiled with GDAL_NO_AUTOLOAD defined.
-    GetGDALDriverManager()->AutoLoadDrivers();
+    if( !bDeferredPluginLoading )
+        GetGDALDriverManager()->AutoLoadDrivers();
 
 #ifdef FRMT_vrt
     GDALRegister_VRT();
@@ -621,6 +632,9 @@ void CPL_STDCALL GDALAllRegister()
 
     GetGDALDriverManager()->AutoLoadPythonDrivers();
 
+    if( bDeferredPluginLoading )
+        GetGDALDriverManager()->DeclareDeferredPlugins();
+
 /* -------------------------------------------------------------------- */
 /*      Deregister any drivers explicitly marked as suppressed by the   */
 /*      GDAL_SKIP environment variable.                                 */
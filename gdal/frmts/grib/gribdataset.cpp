@@ -180,7 +180,7 @@ void GRIBRasterBand::FindPDSTemplate()
             CPLString(table00[nDiscipline]).replaceAll(' ','_') + ")";
     }
 
-    SetMetadataItem("GRIB_DISCIPLINE", osDiscipline.c_str());
+    GDALRasterBand::SetMetadataItem("GRIB_DISCIPLINE", osDiscipline.c_str());
 
     GByte abyHead[5] = { 0 };
 
@@ -309,7 +309,7 @@ void GRIBRasterBand::FindPDSTemplate()
                     CPLString(table14[nType]).replaceAll(' ','_') + ")";
             }
 
-            SetMetadataItem("GRIB_IDS", osIDS);
+            GDALRasterBand::SetMetadataItem("GRIB_IDS", osIDS);
 
             CPLFree(pabyBody);
         }
@@ -412,7 +412,7 @@ void GRIBRasterBand::FindPDSTemplate()
             memcpy(&nPDTN, pabyBody + 8-1, 2);
             CPL_MSBPTR16(&nPDTN);
 
-            SetMetadataItem("GRIB_PDS_PDTN", CPLString().Printf("%d", nPDTN));
+            GDALRasterBand::SetMetadataItem("GRIB_PDS_PDTN", CPLString().Printf("%d", nPDTN));
             m_nPDTN = nPDTN;
 
             CPLString osOctet;
@@ -430,7 +430,7 @@ void GRIBRasterBand::FindPDSTemplate()
                 osOctet += szByte;
             }
 
-            SetMetadataItem("GRIB_PDS_TEMPLATE_NUMBERS", osOctet);
+            GDALRasterBand::SetMetadataItem("GRIB_PDS_TEMPLATE_NUMBERS", osOctet);
 
             g2int iofst = 0;
             g2int pdsnum = 0;
@@ -480,7 +480,7 @@ void GRIBRasterBand::FindPDSTemplate()
                                 osValues += CPLSPrintf("%d", pdstempl[i]);
                             }
                         }
-                        SetMetadataItem("GRIB_PDS_TEMPLATE_ASSEMBLED_VALUES", osValues);
+                        GDALRasterBand::SetMetadataItem("GRIB_PDS_TEMPLATE_ASSEMBLED_VALUES", osValues);
                     }
                     else
                     {
@@ -833,12 +833,47 @@ CPLErr GRIBRasterBand::IReadBlock( int /* nBlockXOff */,
     return CE_None;
 }
 
+/************************************************************************/
+/*                            GetMetadata()                             */
+/************************************************************************/
+
+char **GRIBRasterBand::GetMetadata( const char *pszDomain )
+{
+    if( m_bPDSTemplatePending )
+    {
+        m_bPDSTemplatePending = false;
+        FindPDSTemplate();
+    }
+    return GDALPamRasterBand::GetMetadata(pszDomain);
+}
+
+/************************************************************************/
+/*                          GetMetadataItem()                           */
+/************************************************************************/
+
+const char *GRIBRasterBand::GetMetadataItem( const char *pszName,
+                                             const char *pszDomain )
+{
+    if( m_bPDSTemplatePending )
+    {
+        m_bPDSTemplatePending = false;
+        FindPDSTemplate();
+    }
+    return GDALPamRasterBand::GetMetadataItem(pszName, pszDomain);
+}
+
 /************************************************************************/
 /*                           GetNoDataValue()                           */
 /************************************************************************/
 
 double GRIBRasterBand::GetNoDataValue( int *pbSuccess )
 {
+    if( m_bPDSTemplatePending )
+    {
+        m_bPDSTemplatePending = false;
+        FindPDSTemplate();
+    }
+
     if( m_bHasLookedForNoData )
     {
         if( pbSuccess )
@@ -1037,6 +1072,158 @@ int GRIBDataset::Identify( GDALOpenInfo *poOpenInfo )
     return FALSE;
 }
 
+/************************************************************************/
+/*                             LoadIndex()                              */
+/*                                                                      */
+/*      The index is a text file with a header line                     */
+/*      "GDAL_GRIB_INDEX 1 <file size> <file mtime>" followed by one    */
+/*      tab-separated line per inventory entry.                         */
+/************************************************************************/
+
+namespace gdal {
+namespace grib {
+
+constexpr int GRIB_INDEX_FIELD_COUNT = 12;
+static const char* const GRIB_INDEX_NULL = "\\N";
+
+bool InventoryWrapper::LoadIndex(const char *pszIndexFilename,
+                                 const VSIStatBufL &sStat)
+{
+    Clear();
+
+    VSILFILE *fpIdx = VSIFOpenL(pszIndexFilename, "rb");
+    if( fpIdx == nullptr )
+        return false;
+
+    const char *pszLine = CPLReadLine2L(fpIdx, 1024, nullptr);
+    const CPLString osExpectedHeader(CPLSPrintf(
+        "GDAL_GRIB_INDEX 1 " CPL_FRMT_GUIB " " CPL_FRMT_GIB,
+        static_cast<GUIntBig>(sStat.st_size),
+        static_cast<GIntBig>(sStat.st_mtime)));
+    if( pszLine == nullptr || osExpectedHeader != pszLine )
+    {
+        CPLDebug("GRIB", "Ignoring missing or outdated %s", pszIndexFilename);
+        VSIFCloseL(fpIdx);
+        return false;
+    }
+
+    std::vector<inventoryType> aoInv;
+    bool bOK = true;
+    while( bOK &&
+           (pszLine = CPLReadLine2L(fpIdx, 100 * 1024, nullptr)) != nullptr )
+    {
+        const CPLStringList aosTokens(
+            CSLTokenizeString2(pszLine, "\t", CSLT_ALLOWEMPTYTOKENS));
+        if( aosTokens.size() != GRIB_INDEX_FIELD_COUNT )
+        {
+            bOK = false;
+            break;
+        }
+        inventoryType sInv;
+        memset(&sInv, 0, sizeof(sInv));
+        sInv.start = CPLScanUIntBig(aosTokens[0],
+                                    static_cast<int>(strlen(aosTokens[0])));
+        sInv.msgNum = static_cast<unsigned short>(atoi(aosTokens[1]));
+        sInv.subgNum = static_cast<unsigned short>(atoi(aosTokens[2]));
+        sInv.GribVersion = static_cast<sChar>(atoi(aosTokens[3]));
+        sInv.refTime = CPLAtof(aosTokens[4]);
+        sInv.validTime = CPLAtof(aosTokens[5]);
+        sInv.foreSec = CPLAtof(aosTokens[6]);
+        char **apszStrings[] = { &sInv.element, &sInv.comment,
+                                 &sInv.unitName, &sInv.shortFstLevel,
+                                 &sInv.longFstLevel };
+        for( int i = 0; i < static_cast<int>(CPL_ARRAYSIZE(apszStrings)); i++ )
+        {
+            const char *pszVal = aosTokens[7 + i];
+            // Allocated with strdup() to be released by GRIB2InventoryFree()
+            *(apszStrings[i]) =
+                strcmp(pszVal, GRIB_INDEX_NULL) == 0 ? nullptr : strdup(pszVal);
+        }
+        aoInv.push_back(sInv);
+        if( sInv.GribVersion != 1 && sInv.GribVersion != 2 &&
+            sInv.GribVersion != -1 )
+            bOK = false;
+    }
+    VSIFCloseL(fpIdx);
+
+    if( bOK && !aoInv.empty() )
+    {
+        inv_ = static_cast<inventoryType *>(
+            malloc(aoInv.size() * sizeof(inventoryType)));
+        bOK = inv_ != nullptr;
+    }
+    if( !bOK || aoInv.empty() )
+    {
+        CPLDebug("GRIB", "Ignoring invalid %s", pszIndexFilename);
+        for( auto &sInv : aoInv )
+            GRIB2InventoryFree(&sInv);
+        return false;
+    }
+
+    memcpy(inv_, aoInv.data(), aoInv.size() * sizeof(inventoryType));
+    inv_len_ = static_cast<uInt4>(aoInv.size());
+    num_messages_ = 0;
+    for( const auto &sInv : aoInv )
+        num_messages_ = std::max(num_messages_, static_cast<int>(sInv.msgNum));
+    result_ = num_messages_;
+    return true;
+}
+
+/************************************************************************/
+/*                             SaveIndex()                              */
+/************************************************************************/
+
+bool InventoryWrapper::SaveIndex(const char *pszIndexFilename,
+                                 const VSIStatBufL &sStat) const
+{
+    if( inv_len_ == 0 )
+        return false;
+
+    CPLString osContent;
+    osContent.Printf("GDAL_GRIB_INDEX 1 " CPL_FRMT_GUIB " " CPL_FRMT_GIB "\n",
+                     static_cast<GUIntBig>(sStat.st_size),
+                     static_cast<GIntBig>(sStat.st_mtime));
+    for( uInt4 i = 0; i < inv_len_; i++ )
+    {
+        const inventoryType &sInv = inv_[i];
+        osContent += CPLSPrintf(CPL_FRMT_GUIB "\t%d\t%d\t%d\t%.17g\t%.17g\t%.17g",
+                                static_cast<GUIntBig>(sInv.start),
+                                sInv.msgNum, sInv.subgNum, sInv.GribVersion,
+                                sInv.refTime, sInv.validTime, sInv.foreSec);
+        const char *const apszStrings[] = { sInv.element, sInv.comment,
+                                            sInv.unitName, sInv.shortFstLevel,
+                                            sInv.longFstLevel };
+        for( const char *pszVal : apszStrings )
+        {
+            if( pszVal != nullptr && strpbrk(pszVal, "\t\r\n") != nullptr )
+            {
+                CPLDebug("GRIB", "Cannot write index: unexpected character "
+                         "in '%s'", pszVal);
+                return false;
+            }
+            osContent += '\t';
+            osContent += pszVal ? pszVal : GRIB_INDEX_NULL;
+        }
+        osContent += '\n';
+    }
+
+    VSILFILE *fpIdx = VSIFOpenL(pszIndexFilename, "wb");
+    if( fpIdx == nullptr )
+    {
+        CPLDebug("GRIB", "Cannot create %s", pszIndexFilename);
+        return false;
+    }
+    bool bOK =
+        VSIFWriteL(osContent.data(), osContent.size(), 1, fpIdx) == 1;
+    bOK &= VSIFCloseL(fpIdx) == 0;
+    if( !bOK )
+        VSIUnlink(pszIndexFilename);
+    return bOK;
+}
+
+}  // namespace grib
+}  // namespace gdal
+
 /************************************************************************/
 /*                                Open()                                */
 /************************************************************************/
@@ -1114,8 +1301,25 @@ GDALDataset *GRIBDataset::Open( GDALOpenInfo *poOpenInfo )
 
     VSIFSeekL(poDS->fp, 0, SEEK_SET);
 
-    // Contains an GRIB2 message inventory of the file.
-    gdal::grib::InventoryWrapper oInventories(poDS->fp);
+    // Contains an GRIB2 message inventory of the file, either read from a
+    // <filename>.gdalidx index file or built by scanning all messages.
+    // INDEX=READ uses an existing index, INDEX=YES also writes it.
+    const char *pszIndex = CSLFetchNameValueDef(
+        poOpenInfo->papszOpenOptions, "INDEX",
+        CPLGetConfigOption("GRIB_INDEX", "READ"));
+    const bool bUseIndex = CPLTestBool(pszIndex);
+    const bool bWriteIndex = bUseIndex && !EQUAL(pszIndex, "READ");
+    const CPLString osIndexFilename(
+        CPLString(poOpenInfo->pszFilename) + ".gdalidx");
+    VSIStatBufL sStat;
+    const bool bHasStat =
+        bUseIndex && VSIStatL(poOpenInfo->pszFilename, &sStat) == 0;
+
+    gdal::grib::InventoryWrapper oInventories;
+    const bool bFromIndex =
+        bHasStat && oInventories.LoadIndex(osIndexFilename, sStat);
+    if( !bFromIndex )
+        oInventories.Scan(poDS->fp);
 
     if( oInventories.result() <= 0 )
     {
@@ -1145,26 +1349,30 @@ GDALDataset *GRIBDataset::Open( GDALOpenInfo *poOpenInfo )
 
         // GRIB messages can be preceded by "garbage". GRIB2Inventory()
         // does not return the offset to the real start of the message
-        GByte abyHeader[1024 + 1];
-        VSIFSeekL( poDS->fp, psInv->start, SEEK_SET );
-        size_t nRead = VSIFReadL( abyHeader, 1, sizeof(abyHeader)-1, poDS->fp );
-        abyHeader[nRead] = 0;
-        // Find the real offset of the fist message
-        const char *pasHeader = reinterpret_cast<char *>(abyHeader);
-        int nOffsetFirstMessage = 0;
-        for(int j = 0; j < poOpenInfo->nHeaderBytes - 3; j++)
+        // (the index stores the corrected offsets)
+        if( !bFromIndex )
         {
-            if(STARTS_WITH_CI(pasHeader + j, "GRIB")
+            GByte abyHeader[1024 + 1];
+            VSIFSeekL( poDS->fp, psInv->start, SEEK_SET );
+            size_t nRead = VSIFReadL( abyHeader, 1, sizeof(abyHeader)-1, poDS->fp );
+            abyHeader[nRead] = 0;
+            // Find the real offset of the fist message
+            const char *pasHeader = reinterpret_cast<char *>(abyHeader);
+            int nOffsetFirstMessage = 0;
+            for(int j = 0; j < poOpenInfo->nHeaderBytes - 3; j++)
+            {
+                if(STARTS_WITH_CI(pasHeader + j, "GRIB")
 #ifdef ENABLE_TDLP
-               || STARTS_WITH_CI(pasHeader + j, "TDLP")
+                   || STARTS_WITH_CI(pasHeader + j, "TDLP")
 #endif
-            )
-            {
-                nOffsetFirstMessage = j;
-                break;
+                )
+                {
+                    nOffsetFirstMessage = j;
+                    break;
+                }
             }
+            psInv->start += nOffsetFirstMessage;
         }
-        psInv->start += nOffsetFirstMessage;
 
         if (bandNr == 1)
         {
@@ -1207,15 +1415,22 @@ GDALDataset *GRIBDataset::Open( GDALOpenInfo *poOpenInfo )
         else
         {
             gribBand = new GRIBRasterBand(poDS, bandNr, psInv);
+            // Parsing the sections of each message is deferred until the
+            // band metadata or nodata value is requested.
             if( CPLTestBool(CPLGetConfigOption("GRIB_PDS_ALL_BANDS", "ON")) )
             {
                 if( psInv->GribVersion == 2 )
-                    gribBand->FindPDSTemplate();
+                    gribBand->m_bPDSTemplatePending = true;
             }
         }
         poDS->SetBand(bandNr, gribBand);
     }
 
+    if( bHasStat && !bFromIndex && bWriteIndex )
+    {
+        oInventories.SaveIndex(osIndexFilename, sStat);
+    }
+
     // Initialize any PAM information.
     poDS->SetDescription(poOpenInfo->pszFilename);
 
@@ -2353,6 +2568,15 @@ GDALGRIBDriver::GDALGRIBDriver() : bHasFullInitMetadata(false)
     aosMetadata.SetNameValue( GDAL_DMD_CREATIONDATATYPES,
                             "Byte UInt16 Int16 UInt32 Int32 Float32 "
                             "Float64" );
+    aosMetadata.SetNameValue( GDAL_DMD_OPENOPTIONLIST,
+"<OpenOptionList>"
+"   <Option name='INDEX' type='string-select' default='READ' "
+    "description='Whether to use, or also create, a .gdalidx message index'>"
+"       <Value>NO</Value>"
+"       <Value>READ</Value>"
+"       <Value>YES</Value>"
+"   </Option>"
+"</OpenOptionList>" );
 }
 
 /************************************************************************/
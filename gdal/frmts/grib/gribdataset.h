@@ -135,6 +135,10 @@ public:
 
     virtual double GetNoDataValue( int *pbSuccess = nullptr ) override;
 
+    virtual char **GetMetadata( const char *pszDomain = "" ) override;
+    virtual const char *GetMetadataItem( const char *pszName,
+                                         const char *pszDomain = "" ) override;
+
     void    FindPDSTemplate();
 
     void    UncacheData();
@@ -156,6 +160,9 @@ private:
     int nGribDataYSize;
     int     m_nGribVersion;
 
+    // FindPDSTemplate() deferred until metadata is requested
+    bool    m_bPDSTemplatePending = false;
+
     bool    m_bHasLookedForNoData;
     double  m_dfNoData;
     bool    m_bHasNoData;
@@ -181,19 +188,27 @@ namespace grib {
 class InventoryWrapper {
   public:
 
+    InventoryWrapper()
+        : inv_(nullptr), inv_len_(0), num_messages_(0), result_(0) {}
+
     explicit InventoryWrapper(VSILFILE * fp)
         : inv_(nullptr), inv_len_(0), num_messages_(0), result_(0) {
+      Scan(fp);
+    }
+
+    ~InventoryWrapper() { Clear(); }
+
+    void Scan(VSILFILE * fp) {
+      Clear();
       result_ = GRIB2Inventory(fp, &inv_, &inv_len_,
                                0 /* all messages */, &num_messages_);
     }
 
-    ~InventoryWrapper() {
-        if (inv_ == nullptr) return;
-        for (uInt4 i = 0; i < inv_len_; i++) {
-            GRIB2InventoryFree(inv_ + i);
-        }
-        free(inv_);
-    }
+    // Message index persisted next to the GRIB file, only valid for the
+    // file size and modification time it was written for.
+    bool LoadIndex(const char *pszIndexFilename, const VSIStatBufL &sStat);
+    bool SaveIndex(const char *pszIndexFilename,
+                   const VSIStatBufL &sStat) const;
 
     // Modifying the contents pointed to by the return is allowed.
     inventoryType * get(int i) const {
@@ -206,6 +221,18 @@ class InventoryWrapper {
     int result() const { return result_; }
 
   private:
+    void Clear() {
+        if (inv_ == nullptr) return;
+        for (uInt4 i = 0; i < inv_len_; i++) {
+            GRIB2InventoryFree(inv_ + i);
+        }
+        free(inv_);
+        inv_ = nullptr;
+        inv_len_ = 0;
+        num_messages_ = 0;
+        result_ = 0;
+    }
+
     inventoryType *inv_;
     uInt4 inv_len_;
     int num_messages_;
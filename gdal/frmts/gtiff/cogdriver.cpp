@@ -67,10 +67,21 @@ static bool HasZSTDCompression()
 /************************************************************************/
 
 static CPLString GetTmpFilename(const char* pszFilename,
-                                const char* pszExt)
+                                const char* pszExt,
+                                bool bInMemory = false)
 {
     CPLString osTmpFilename;
-    osTmpFilename.Printf("%s.%s", pszFilename, pszExt);
+    if( bInMemory )
+    {
+        // Use a process-unique directory, as the address of pszFilename
+        // may be reused by concurrent or successive conversions.
+        const CPLString osTmpDir(
+            CPLGetFilename(CPLGenerateTempFilename("cog")));
+        osTmpFilename.Printf("/vsimem/%s/%s.%s", osTmpDir.c_str(),
+                             CPLGetFilename(pszFilename), pszExt);
+    }
+    else
+        osTmpFilename.Printf("%s.%s", pszFilename, pszExt);
     VSIUnlink(osTmpFilename);
     return osTmpFilename;
 }
@@ -300,43 +311,19 @@ bool COGGetWarpingCharacteristics(GDALDataset* poSrcDS,
             papszOptions, "BLOCKSIZE", CPLSPrintf("%d", tmList[0].mTileWidth)));
         const double dfOriX = bInvertAxis ? tmList[0].mTopLeftY : tmList[0].mTopLeftX;
         const double dfOriY = bInvertAxis ? tmList[0].mTopLeftX : tmList[0].mTopLeftY;
-        double dfComputedRes = adfGeoTransform[1];
-        double dfPrevRes = 0.0;
-        dfRes = 0.0;
-        for( ; nZoomLevel < static_cast<int>(tmList.size()); nZoomLevel++ )
-        {
-            dfRes = tmList[nZoomLevel].mResX * tmList[0].mTileWidth / nBlockSize;
-            if( dfComputedRes > dfRes || fabs( dfComputedRes - dfRes ) / dfRes <= 1e-8 )
-                break;
-            dfPrevRes = dfRes;
-        }
-        if( nZoomLevel == static_cast<int>(tmList.size()) )
+        std::vector<double> adfResolutions;
+        for( const auto& tm: tmList )
+            adfResolutions.push_back(tm.mResX * tmList[0].mTileWidth / nBlockSize);
+        nZoomLevel = gdal::TileMatrixSet::selectZoomLevel(
+            adfResolutions, adfGeoTransform[1],
+            CSLFetchNameValue(papszOptions, "ZOOM_LEVEL_STRATEGY"));
+        if( nZoomLevel < 0 )
         {
             CPLError(CE_Failure, CPLE_AppDefined,
                     "Could not find an appropriate zoom level");
             return false;
         }
-
-        if( nZoomLevel > 0 && fabs( dfComputedRes - dfRes ) / dfRes > 1e-8 )
-        {
-            const char* pszZoomLevelStrategy = CSLFetchNameValueDef(papszOptions,
-                                                                    "ZOOM_LEVEL_STRATEGY",
-                                                                    "AUTO");
-            if( EQUAL(pszZoomLevelStrategy, "LOWER") )
-            {
-                nZoomLevel --;
-            }
-            else if( EQUAL(pszZoomLevelStrategy, "UPPER") )
-            {
-                /* do nothing */
-            }
-            else
-            {
-                if( dfPrevRes / dfComputedRes < dfComputedRes / dfRes )
-                    nZoomLevel --;
-            }
-            dfRes = tmList[nZoomLevel].mResX * tmList[0].mTileWidth / nBlockSize;
-        }
+        dfRes = adfResolutions[nZoomLevel];
 
         CPLDebug("COG", "Using ZOOM_LEVEL %d", nZoomLevel);
 
@@ -863,9 +850,37 @@ GDALDataset* GDALCOGCreator::Create(const char * pszFilename,
             double(nXSize) * nYSize * (nBands + (bHasMask ? 1 : 0)) * 4. / 3;
     }
 
+    // If the temporary overviews are small enough, keep them uncompressed in
+    // /vsimem/, so that they are neither written to the target file system
+    // nor compressed only to be decompressed again by the final copy.
+    bool bInMemoryOvr = false;
+    if( bGenerateOvr || bGenerateMskOvr )
+    {
+        const int nDTSize = GDALGetDataTypeSizeBytes(
+                                        poFirstBand->GetRasterDataType());
+        double dfOvrBytes = 0;
+        for( const auto& oDims: asOverviewDims )
+        {
+            const double dfPixels = double(oDims.first) * oDims.second;
+            if( bGenerateOvr )
+                dfOvrBytes += dfPixels * nBands * nDTSize;
+            if( bGenerateMskOvr )
+                dfOvrBytes += dfPixels;
+        }
+        const char* pszMaxMem =
+            CPLGetConfigOption("COG_TMP_OVERVIEW_MAX_MEM", nullptr);
+        const double dfMaxMem = pszMaxMem ?
+            CPLAtof(pszMaxMem) * 1024 * 1024 :
+            static_cast<double>(GDALGetCacheMax64() / 4);
+        bInMemoryOvr = dfOvrBytes <= dfMaxMem;
+        CPLDebug("COG", "Temporary overviews (%.0f bytes) stored %s",
+                 dfOvrBytes, bInMemoryOvr ? "in memory" : "on disk");
+    }
+
     CPLStringList aosOverviewOptions;
     aosOverviewOptions.SetNameValue("COMPRESS",
         CPLGetConfigOption("COG_TMP_COMPRESSION", // only for debug purposes
+                        bInMemoryOvr ? "NONE" :
                         HasZSTDCompression() ? "ZSTD" : "LZW"));
     aosOverviewOptions.SetNameValue("NUM_THREADS",
                         CSLFetchNameValue(papszOptions, "NUM_THREADS"));
@@ -875,7 +890,7 @@ GDALDataset* GDALCOGCreator::Create(const char * pszFilename,
     if( bGenerateMskOvr )
     {
         CPLDebug("COG", "Generating overviews of the mask: start");
-        m_osTmpMskOverviewFilename = GetTmpFilename(pszFilename, "msk.ovr.tmp");
+        m_osTmpMskOverviewFilename = GetTmpFilename(pszFilename, "msk.ovr.tmp", bInMemoryOvr);
         GDALRasterBand* poSrcMask = poFirstBand->GetMaskBand();
         const char* pszResampling = CSLFetchNameValueDef(papszOptions,
             "OVERVIEW_RESAMPLING",
@@ -913,7 +928,7 @@ GDALDataset* GDALCOGCreator::Create(const char * pszFilename,
     if( bGenerateOvr )
     {
         CPLDebug("COG", "Generating overviews of the imagery: start");
-        m_osTmpOverviewFilename = GetTmpFilename(pszFilename, "ovr.tmp");
+        m_osTmpOverviewFilename = GetTmpFilename(pszFilename, "ovr.tmp", bInMemoryOvr);
         std::vector<GDALRasterBand*> apoSrcBands;
         for( int i = 0; i < nBands; i++ )
             apoSrcBands.push_back( poCurDS->GetRasterBand(i+1) );
@@ -55,6 +55,8 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -75,6 +77,7 @@
 #include "cpl_port.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_virtualmem.h"
 #include "cpl_vsi.h"
 #include "cpl_vsi_virtual.h"
@@ -84,6 +87,7 @@
 #include "gdal_frmts.h"
 #include "gdal_mdreader.h"
 #include "gdal_pam.h"
+#include "gdal_perf_counters.h"
 #include "gdal_priv.h"
 #include "gdal_priv_templates.hpp"
 #include "gdal_thread_pool.h"
@@ -92,6 +96,7 @@
 #include "geovalues.h"
 #include "gt_jpeg_copy.h"
 #include "gt_overview.h"
+#include "gt_strile_index_cache.h"
 #include "gt_wkt_srs.h"
 #include "gt_wkt_srs_priv.h"
 #include "ogr_spatialref.h"
@@ -108,6 +113,30 @@ CPL_CVSID("$Id$")
 
 static bool bGlobalInExternalOvr = false;
 
+namespace {
+struct GTiffPerfCounters
+{
+    GDALPerfCounter* poBlocksDecoded =
+                        GDALPerfCounter::Get("GTiff.blocks_decoded");
+    GDALPerfCounter* poBytesDecompressed =
+                        GDALPerfCounter::Get("GTiff.bytes_decompressed");
+    GDALPerfCounter* poDecodeTime =
+                        GDALPerfCounter::Get("GTiff.decode_time_ns");
+    GDALPerfCounter* poBlocksEncoded =
+                        GDALPerfCounter::Get("GTiff.blocks_encoded");
+    GDALPerfCounter* poBytesCompressed =
+                        GDALPerfCounter::Get("GTiff.bytes_compressed");
+    GDALPerfCounter* poEncodeTime =
+                        GDALPerfCounter::Get("GTiff.encode_time_ns");
+};
+} // namespace
+
+static const GTiffPerfCounters& GetPerfCounters()
+{
+    static const GTiffPerfCounters oCounters;
+    return oCounters;
+}
+
 // Only libtiff 4.0.4 can handle between 32768 and 65535 directories.
 #if TIFFLIB_VERSION >= 20120922
 #define SUPPORTS_MORE_THAN_32768_DIRECTORIES
@@ -303,6 +332,7 @@ private:
     GDALDataset          *m_poExternalMaskDS = nullptr; // Points to a dataset within m_poMaskExtOvrDS
     GTiffDataset         *m_poImageryDS = nullptr; // For a mask dataset, points to the corresponding imagery dataset
     GTiffDataset         *m_poBaseDS = nullptr; // For an overview or mask dataset, points to the root dataset
+    bool                  m_bBatchCachedRanges = false; // Whether RasterIOBatch() has installed cached ranges on the TIFF handle
     std::unique_ptr<GDALDataset> m_poMaskExtOvrDS{}; // Used with MASK_OVERVIEW_DATASET open option
     GTiffJPEGOverviewDS **m_papoJPEGOverviewDS = nullptr;
     GDAL_GCP             *m_pasGCPList = nullptr;
@@ -316,9 +346,15 @@ private:
     CPLVirtualMem        *m_psVirtualMemIOMapping = nullptr;
     std::unique_ptr<CPLJobQueue> m_poCompressQueue{};
     CPLMutex             *m_hCompressThreadPoolMutex = nullptr;
+    // Child TIFF handles on the current directory, one per worker thread
+    // used to decompress blocks in IRasterIO().
+    std::vector<TIFF*>    m_ahDecompressionTIFF{};
 
 #ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
     lru11::Cache<int, std::pair<vsi_l_offset, vsi_l_offset>> m_oCacheStrileToOffsetByteCount{1024};
+    // Set when the TileOffsets/TileByteCounts arrays have been found in
+    // the cache of GTIFFGetCachedStrileIndex().
+    std::shared_ptr<const GTiffStrileIndex> m_poStrileIndex{};
 #endif
 
     MaskOffset* m_panMaskOffsetLsb = nullptr;
@@ -343,6 +379,7 @@ private:
     int         m_nLastWrittenBlockId = -1; // used for m_bStreamingOut
     int         m_nRefBaseMapping = 0;
     int         m_nGCPCount = 0;
+    int         m_nReadThreadCount = 0; // Set on the base dataset only
 
     GTIFFKeysFlavorEnum m_eGeoTIFFKeysFlavor = GEOTIFF_KEYS_STANDARD;
     GeoTIFFVersionEnum m_eGeoTIFFVersion = GEOTIFF_VERSION_AUTO;
@@ -395,10 +432,17 @@ private:
     std::vector<GTiffCompressionJob> m_asCompressionJobs{};
     std::queue<int> m_asQueueJobIdx{}; // queue of index of m_asCompressionJobs being compressed in worker threads
 
+    // Used for GTIFF_STREAMING_WRITE
+    std::vector<int> m_anStreamingWriteNextLine{}; // per band, -1 if not sequential
+    std::vector<int> m_anStreamingWriteFlushedBlockRows{};
+
     bool        m_bStreamingIn:1;
     bool        m_bStreamingOut:1;
     bool        m_bScanDeferred:1;
     bool        m_bSingleIFDOpened = false;
+    bool        m_bStrileIndexLookedUp = false;
+    // Whether all bands are GTiffRasterBand, and not one of its subclasses.
+    bool        m_bRegularBands = false;
     bool        m_bLoadedBlockDirty:1;
     bool        m_bWriteError:1;
     bool        m_bLookedForProjection:1;
@@ -432,6 +476,7 @@ private:
     bool        m_bIsFinalized:1;
     bool        m_bIgnoreReadErrors:1;
     bool        m_bDirectIO:1;
+    bool        m_bStreamingWrite:1;
     bool        m_bReadGeoTransform:1;
     bool        m_bLoadPam:1;
     bool        m_bHasGotSiblingFiles:1;
@@ -471,6 +516,12 @@ private:
                                   vsi_l_offset* pnOffset = nullptr,
                                   vsi_l_offset* pnSize = nullptr,
                                   bool *pbErrOccurred = nullptr );
+#ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
+    void         LoadStrileIndex();
+    vsi_l_offset GetStrileOffset( int nBlockId, int* pnErrOccurred = nullptr );
+    vsi_l_offset GetStrileByteCount( int nBlockId,
+                                     int* pnErrOccurred = nullptr );
+#endif
 
     void        ApplyPamInfo();
     void        PushMetadataToPam();
@@ -506,6 +557,13 @@ private:
     void           InitCompressionThreads( char** papszOptions );
     void           InitCreationOrOpenOptions( char** papszOptions );
     static void    ThreadCompressionFunc( void* pData );
+    void           InitReadThreads( char** papszOptions );
+    int            GetThreadedReadChunkYSize( int nXOff, int nXSize,
+                                              int nBandCount );
+    void           DecompressBlocksInThreads(
+                        const std::vector<std::pair<int, int>>& aoBlocks,
+                        int nBandCount, const int* panBandMap );
+    static void    ThreadDecompressionFunc( void* pData );
     void           WaitCompletionForJobIdx( int i );
     void           WaitCompletionForBlock( int nBlockId );
     void           WriteRawStripOrTile( int nStripOrTile,
@@ -513,6 +571,10 @@ private:
                                         GPtrDiff_t nCompressedBufferSize );
     bool           SubmitCompressionJob( int nStripOrTile, GByte* pabyData,
                                          GPtrDiff_t cc, int nHeight) ;
+    void           FlushCompletedBlockRows( int nXOff, int nYOff,
+                                            int nXSize, int nYSize,
+                                            int nBandCount,
+                                            const int* panBandMap );
 
     int            GuessJPEGQuality( bool& bOutHasQuantizationTable,
                                      bool& bOutHasHuffmanTable );
@@ -539,6 +601,18 @@ private:
                                  GSpacing nBandSpace,
                                  GDALRasterIOExtraArg* psExtraArg );
 
+    int            WriteWholeBlocksDirectly( int nXOff, int nYOff,
+                                             int nXSize, int nYSize,
+                                             const void * pData,
+                                             int nBufXSize, int nBufYSize,
+                                             GDALDataType eBufType,
+                                             int nBandCount,
+                                             const int *panBandMap,
+                                             GSpacing nPixelSpace,
+                                             GSpacing nLineSpace,
+                                             GSpacing nBandSpace,
+                                             GDALRasterIOExtraArg* psExtraArg );
+
     void            SetStructuralMDFromParent(GTiffDataset* poParentDS);
 
     template<class FetchBuffer> CPLErr CommonDirectIO(
@@ -558,6 +632,7 @@ private:
 
     void        FlushCacheInternal( bool bFlushDirectory );
     bool        HasOptimizedReadMultiRange();
+    bool        HasBatchCachedRanges() const;
 
     bool        AssociateExternalMask();
 
@@ -568,6 +643,15 @@ private:
                                      GDALRasterBand* poSrcMaskBand,
                                      GDALProgressFunc pfnProgress,
                                      void * pProgressData);
+    static bool IsDirectTileCopyCompatible(GTiffDataset* poDstDS,
+                                           GTiffDataset* poSrcGDS,
+                                           CSLConstList papszOptions);
+    static CPLErr DirectCopyTiles(GTiffDataset* poDstDS,
+                                  GDALDataset* poSrcDS,
+                                  CSLConstList papszOptions,
+                                  GDALProgressFunc pfnProgress,
+                                  void * pProgressData,
+                                  bool& bDone);
 
   protected:
     virtual int         CloseDependentDatasets() override;
@@ -596,7 +680,13 @@ private:
                               GSpacing nPixelSpace, GSpacing nLineSpace,
                               GSpacing nBandSpace,
                               GDALRasterIOExtraArg* psExtraArg ) override;
+    CPLErr RasterIOBatch( int nWindowCount,
+                          const GDALRasterIOWindow* pasWindows,
+                          GDALDataType eBufType,
+                          int nBandCount, const int *panBandMap,
+                          CSLConstList papszOptions ) override;
     virtual char **GetFileList() override;
+    virtual GIntBig GetDriverMemoryUsage() override;
 
     virtual CPLErr IBuildOverviews( const char *, int, int *, int, int *,
                                     GDALProgressFunc, void * ) override;
@@ -893,8 +983,10 @@ CPLErr GTiffJPEGOverviewBand::IReadBlock( int nBlockXOff, int nBlockYOff,
 
         // If the size of the JPEG strip/tile is small enough, we will
         // read it from the TIFF file and forge a in-memory JPEG file with
-        // the JPEG table followed by the JPEG data.
-        const bool bInMemoryJPEGFile = nByteCount < 256 * 256;
+        // the JPEG table followed by the JPEG data. This also enables the
+        // JPEG dataset to be reused for the next blocks instead of being
+        // re-opened, so this is done for any reasonably sized tile.
+        const bool bInMemoryJPEGFile = nByteCount < 10 * 1024 * 1024;
         if( bInMemoryJPEGFile )
         {
             // If the previous file was opened as a /vsisparse/, must re-open.
@@ -1189,15 +1281,27 @@ class GTiffRasterBand CPL_NON_FINAL: public GDALPamRasterBand
                                  GDALRasterIOExtraArg* psExtraArg );
 
     static void     DropReferenceVirtualMem( void* pUserData );
+    static void     FillCacheVirtualMemIO( CPLVirtualMem* ctxt,
+                                           size_t nOffset,
+                                           void* pPageToFill,
+                                           size_t nToFill,
+                                           void* pUserData );
     CPLVirtualMem * GetVirtualMemAutoInternal( GDALRWFlag eRWFlag,
                                                int *pnPixelSpace,
                                                GIntBig *pnLineSpace,
                                                char **papszOptions );
 
+    std::vector<std::pair<int, int>> GetBlocksInWindow(
+                                     int nXOff, int nYOff,
+                                     int nXSize, int nYSize,
+                                     int nBufXSize, int nBufYSize,
+                                     GDALRasterIOExtraArg* psExtraArg );
     void*           CacheMultiRange( int nXOff, int nYOff,
                                      int nXSize, int nYSize,
                                      int nBufXSize, int nBufYSize,
                                      GDALRasterIOExtraArg* psExtraArg );
+    void*           CacheMultiRange(
+                        const std::vector<std::pair<int, int>>& aoBlocks );
 
 protected:
     GTiffDataset       *m_poGDS = nullptr;
@@ -1826,6 +1930,48 @@ CPLVirtualMem* GTiffRasterBand::GetVirtualMemAuto( GDALRWFlag eRWFlag,
         return nullptr;
     }
 
+    // The default implementation fills pages of the virtual memory with
+    // RasterIO() requests. For uncompressed files that cannot be mapped
+    // directly (tiled files for example), fill them from a memory mapping
+    // of the file with VirtualMemIO(), rather than through the block cache,
+    // unless GTIFF_VIRTUAL_MEM_IO has been explicitly set. Other RasterIO()
+    // requests on the dataset are not affected.
+    if( eRWFlag == GF_Read && m_poGDS->eAccess == GA_ReadOnly &&
+        m_poGDS->m_nCompression == COMPRESSION_NONE &&
+        m_poGDS->m_eVirtualMemIOUsage == GTiffDataset::VirtualMemIOEnum::NO &&
+        CPLGetConfigOption("GTIFF_VIRTUAL_MEM_IO", nullptr) == nullptr &&
+        !CPLTestBool(CSLFetchNameValueDef(papszOptions, "USERFAULTFD",
+            CPLGetConfigOption("GDAL_VIRTUALMEM_USERFAULTFD", "NO"))) )
+    {
+        const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
+        const GIntBig nLineSpace = static_cast<GIntBig>(nRasterXSize) * nDTSize;
+        const GUIntBig nReqMem = static_cast<GUIntBig>(nLineSpace) *
+                                 nRasterYSize;
+        if( nReqMem == static_cast<GUIntBig>(static_cast<size_t>(nReqMem)) )
+        {
+            const size_t nCacheSize = atoi(
+                CSLFetchNameValueDef(papszOptions, "CACHE_SIZE", "40000000"));
+            const size_t nPageSizeHint = atoi(
+                CSLFetchNameValueDef(papszOptions, "PAGE_SIZE_HINT", "0") );
+            const bool bSingleThreadUsage =
+                CPLTestBool( CSLFetchNameValueDef( papszOptions,
+                                                   "SINGLE_THREAD", "FALSE" ) );
+            CPLVirtualMem* psRetVMIO = CPLVirtualMemNew(
+                static_cast<size_t>(nReqMem), nCacheSize, nPageSizeHint,
+                bSingleThreadUsage, VIRTUALMEM_READONLY_ENFORCED,
+                FillCacheVirtualMemIO, nullptr, nullptr, this );
+            if( psRetVMIO != nullptr )
+            {
+                CPLDebug("GTiff", "GetVirtualMemAuto(): Using VirtualMemIO");
+                if( pnPixelSpace )
+                    *pnPixelSpace = nDTSize;
+                if( pnLineSpace )
+                    *pnLineSpace = nLineSpace;
+                return psRetVMIO;
+            }
+        }
+    }
+
     CPLDebug("GTiff", "GetVirtualMemAuto(): Defaulting to base implementation");
     return GDALRasterBand::GetVirtualMemAuto( eRWFlag, pnPixelSpace,
                                               pnLineSpace, papszOptions );
@@ -1909,6 +2055,76 @@ void GTiffRasterBand::DropReferenceVirtualMem( void* pUserData )
     CPLFree(pUserData);
 }
 
+/************************************************************************/
+/*                       FillCacheVirtualMemIO()                        */
+/*                                                                      */
+/*      Fill a page of the mapping returned by GetVirtualMemAuto() for  */
+/*      files that cannot be mapped directly, using VirtualMemIO().     */
+/************************************************************************/
+
+void GTiffRasterBand::FillCacheVirtualMemIO( CPLVirtualMem* /* ctxt */,
+                                             size_t nOffset,
+                                             void* pPageToFill,
+                                             size_t nToFill,
+                                             void* pUserData )
+{
+    GTiffRasterBand* poSelf = static_cast<GTiffRasterBand *>( pUserData );
+    GTiffDataset* poGDS = poSelf->m_poGDS;
+    const int nDTSize = GDALGetDataTypeSizeBytes(poSelf->eDataType);
+    const size_t nLineSize =
+        static_cast<size_t>(poSelf->nRasterXSize) * nDTSize;
+
+    // The page is a range of the raster in pixel-interleaved order: read it
+    // as a partial first line, full lines and a partial last line.
+    GByte* pabyDst = static_cast<GByte *>(pPageToFill);
+    size_t nRemaining = nToFill / nDTSize * nDTSize;
+    size_t nPos = nOffset / nDTSize;
+    while( nRemaining > 0 )
+    {
+        const int nYOff = static_cast<int>(nPos / poSelf->nRasterXSize);
+        const int nXOff = static_cast<int>(nPos % poSelf->nRasterXSize);
+        int nXSize = 0;
+        int nYSize = 1;
+        if( nXOff == 0 && nRemaining >= nLineSize )
+        {
+            nXSize = poSelf->nRasterXSize;
+            nYSize = static_cast<int>(nRemaining / nLineSize);
+        }
+        else
+        {
+            nXSize = static_cast<int>(std::min(
+                static_cast<size_t>(poSelf->nRasterXSize - nXOff),
+                nRemaining / nDTSize));
+        }
+
+        GDALRasterIOExtraArg sExtraArg;
+        INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+        int nBand = poSelf->nBand;
+        // VirtualMemIO() enables itself on the dataset on success: keep
+        // the setting of the dataset for its other RasterIO() requests.
+        const auto eOldUsage = poGDS->m_eVirtualMemIOUsage;
+        const int nErr = poGDS->VirtualMemIO(
+            GF_Read, nXOff, nYOff, nXSize, nYSize,
+            pabyDst, nXSize, nYSize, poSelf->eDataType,
+            1, &nBand, nDTSize, static_cast<GSpacing>(nLineSize), 0,
+            &sExtraArg );
+        poGDS->m_eVirtualMemIOUsage = eOldUsage;
+        if( nErr < 0 )
+        {
+            CPL_IGNORE_RET_VAL(poSelf->RasterIO(
+                GF_Read, nXOff, nYOff, nXSize, nYSize,
+                pabyDst, nXSize, nYSize, poSelf->eDataType,
+                nDTSize, static_cast<GSpacing>(nLineSize), &sExtraArg ));
+        }
+
+        const size_t nRead =
+            static_cast<size_t>(nXSize) * nYSize * nDTSize;
+        pabyDst += nRead;
+        nRemaining -= nRead;
+        nPos += static_cast<size_t>(nXSize) * nYSize;
+    }
+}
+
 /************************************************************************/
 /*                     GetVirtualMemAutoInternal()                      */
 /************************************************************************/
@@ -2169,6 +2385,19 @@ bool GTiffDataset::HasOptimizedReadMultiRange()
     return m_nHasOptimizedReadMultiRange != 0;
 }
 
+/************************************************************************/
+/*                        HasBatchCachedRanges()                        */
+/************************************************************************/
+
+// Whether the ranges cached on the TIFF handle, which is shared with the
+// overview and mask datasets, have been installed by RasterIOBatch() and
+// must be kept until all its windows have been read.
+bool GTiffDataset::HasBatchCachedRanges() const
+{
+    return m_bBatchCachedRanges ||
+           (m_poBaseDS != nullptr && m_poBaseDS->m_bBatchCachedRanges);
+}
+
 /************************************************************************/
 /*                            IRasterIO()                               */
 /************************************************************************/
@@ -2224,11 +2453,67 @@ CPLErr GTiffDataset::IRasterIO( GDALRWFlag eRWFlag,
             return static_cast<CPLErr>(nErr);
     }
 
+    const int nThreadedReadChunkYSize =
+        eRWFlag == GF_Read ?
+            GetThreadedReadChunkYSize(nXOff, nXSize, nBandCount) : 0;
+    if( nThreadedReadChunkYSize > 0 &&
+        nXSize == nBufXSize && nYSize == nBufYSize &&
+        nYOff / nThreadedReadChunkYSize !=
+            (nYOff + nYSize - 1) / nThreadedReadChunkYSize )
+    {
+        // Split the request in chunks whose blocks fit in the block cache,
+        // so that decompressed blocks are not evicted before being used.
+        CPLErr eErr = CE_None;
+        for( int nChunkYOff = nYOff;
+             eErr == CE_None && nChunkYOff < nYOff + nYSize; )
+        {
+            const int nChunkYEnd = std::min(nYOff + nYSize,
+                (nChunkYOff / nThreadedReadChunkYSize + 1) *
+                    nThreadedReadChunkYSize);
+            GDALRasterIOExtraArg sExtraArg;
+            INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+            sExtraArg.eResampleAlg = psExtraArg->eResampleAlg;
+            sExtraArg.pfnProgress = GDALScaledProgress;
+            sExtraArg.pProgressData = GDALCreateScaledProgress(
+                static_cast<double>(nChunkYOff - nYOff) / nYSize,
+                static_cast<double>(nChunkYEnd - nYOff) / nYSize,
+                psExtraArg->pfnProgress, psExtraArg->pProgressData );
+            eErr = IRasterIO( eRWFlag, nXOff, nChunkYOff,
+                              nXSize, nChunkYEnd - nChunkYOff,
+                              static_cast<GByte*>(pData) +
+                                  (nChunkYOff - nYOff) * nLineSpace,
+                              nXSize, nChunkYEnd - nChunkYOff, eBufType,
+                              nBandCount, panBandMap,
+                              nPixelSpace, nLineSpace, nBandSpace,
+                              &sExtraArg );
+            GDALDestroyScaledProgress( sExtraArg.pProgressData );
+            nChunkYOff = nChunkYEnd;
+        }
+        return eErr;
+    }
+
+    if( eRWFlag == GF_Write )
+    {
+        const int nErr = WriteWholeBlocksDirectly(
+            nXOff, nYOff, nXSize, nYSize,
+            pData, nBufXSize, nBufYSize, eBufType,
+            nBandCount, panBandMap, nPixelSpace, nLineSpace,
+            nBandSpace, psExtraArg );
+        if( nErr >= 0 )
+        {
+            if( nErr == CE_None && m_bStreamingWrite )
+                FlushCompletedBlockRows(nXOff, nYOff, nXSize, nYSize,
+                                        nBandCount, panBandMap);
+            return static_cast<CPLErr>(nErr);
+        }
+    }
+
     void* pBufferedData = nullptr;
     if( eAccess == GA_ReadOnly &&
         eRWFlag == GF_Read &&
         m_nPlanarConfig == PLANARCONFIG_CONTIG &&
-        HasOptimizedReadMultiRange() )
+        HasOptimizedReadMultiRange() &&
+        !HasBatchCachedRanges() )
     {
         pBufferedData = cpl::down_cast<GTiffRasterBand *>(
             GetRasterBand(1))->CacheMultiRange(nXOff, nYOff,
@@ -2237,6 +2522,15 @@ CPLErr GTiffDataset::IRasterIO( GDALRWFlag eRWFlag,
                                                psExtraArg);
     }
 
+    if( nThreadedReadChunkYSize > 0 )
+    {
+        DecompressBlocksInThreads(
+            cpl::down_cast<GTiffRasterBand *>(GetRasterBand(1))->
+                GetBlocksInWindow(nXOff, nYOff, nXSize, nYSize,
+                                  nBufXSize, nBufYSize, psExtraArg),
+            nBandCount, panBandMap);
+    }
+
     ++m_nJPEGOverviewVisibilityCounter;
     const CPLErr eErr =
         GDALPamDataset::IRasterIO(
@@ -2246,6 +2540,10 @@ CPLErr GTiffDataset::IRasterIO( GDALRWFlag eRWFlag,
             nBandSpace, psExtraArg);
     m_nJPEGOverviewVisibilityCounter--;
 
+    if( eErr == CE_None && eRWFlag == GF_Write && m_bStreamingWrite )
+        FlushCompletedBlockRows(nXOff, nYOff, nXSize, nYSize,
+                                nBandCount, panBandMap);
+
     if( pBufferedData )
     {
         VSIFree( pBufferedData );
@@ -2256,6 +2554,445 @@ CPLErr GTiffDataset::IRasterIO( GDALRWFlag eRWFlag,
     return eErr;
 }
 
+/************************************************************************/
+/*                           RasterIOBatch()                            */
+/************************************************************************/
+
+CPLErr GTiffDataset::RasterIOBatch( int nWindowCount,
+                                    const GDALRasterIOWindow* pasWindows,
+                                    GDALDataType eBufType,
+                                    int nBandCount, const int *panBandMap,
+                                    CSLConstList papszOptions )
+{
+    // Collect the blocks needed by all the full resolution windows, so that
+    // they can be fetched with a single multi-range request instead of
+    // one per window.
+    void* pBufferedData = nullptr;
+    if( eAccess == GA_ReadOnly &&
+        nWindowCount > 1 && pasWindows != nullptr && nBands > 0 &&
+        (m_nPlanarConfig == PLANARCONFIG_CONTIG || nBands == 1) &&
+        HasOptimizedReadMultiRange() )
+    {
+        // Row-major ordered set of (y, x) block coordinates
+        std::set<std::pair<int, int>> oSetBlocks;
+        for( int i = 0; i < nWindowCount; ++i )
+        {
+            const GDALRasterIOWindow& sWindow = pasWindows[i];
+            if( sWindow.nXSize <= 0 || sWindow.nYSize <= 0 ||
+                sWindow.nXOff < 0 || sWindow.nYOff < 0 ||
+                sWindow.nXOff > nRasterXSize - sWindow.nXSize ||
+                sWindow.nYOff > nRasterYSize - sWindow.nYSize ||
+                sWindow.nBufXSize != sWindow.nXSize ||
+                sWindow.nBufYSize != sWindow.nYSize )
+            {
+                continue;
+            }
+            const int nBlockX1 = sWindow.nXOff / m_nBlockXSize;
+            const int nBlockY1 = sWindow.nYOff / m_nBlockYSize;
+            const int nBlockX2 =
+                (sWindow.nXOff + sWindow.nXSize - 1) / m_nBlockXSize;
+            const int nBlockY2 =
+                (sWindow.nYOff + sWindow.nYSize - 1) / m_nBlockYSize;
+            for( int iY = nBlockY1; iY <= nBlockY2; ++iY )
+            {
+                for( int iX = nBlockX1; iX <= nBlockX2; ++iX )
+                {
+                    oSetBlocks.insert(std::pair<int, int>(iY, iX));
+                }
+            }
+        }
+
+        if( !oSetBlocks.empty() )
+        {
+            std::vector<std::pair<int, int>> aoBlocks;
+            aoBlocks.reserve(oSetBlocks.size());
+            for( const auto& oBlock: oSetBlocks )
+                aoBlocks.emplace_back(oBlock.second, oBlock.first);
+            pBufferedData = cpl::down_cast<GTiffRasterBand *>(
+                GetRasterBand(1))->CacheMultiRange(aoBlocks);
+        }
+    }
+
+    // Prevent the per-window IRasterIO() calls from replacing or clearing
+    // the ranges fetched above.
+    m_bBatchCachedRanges = pBufferedData != nullptr;
+    const CPLErr eErr = GDALPamDataset::RasterIOBatch(
+        nWindowCount, pasWindows, eBufType, nBandCount, panBandMap,
+        papszOptions);
+    m_bBatchCachedRanges = false;
+
+    if( pBufferedData )
+    {
+        VSIFree( pBufferedData );
+        VSI_TIFFSetCachedRanges( TIFFClientdata( m_hTIFF ),
+                                 0, nullptr, nullptr, nullptr );
+    }
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                     GetThreadedReadChunkYSize()                      */
+/************************************************************************/
+
+// Returns 0 if blocks intersecting the specified columns cannot be
+// decompressed by worker threads. Otherwise returns the height, multiple of
+// the block height, of the horizontal chunks in which requests must be split
+// so that the decompressed blocks of a chunk fit in the block cache.
+int GTiffDataset::GetThreadedReadChunkYSize( int nXOff, int nXSize,
+                                             int nBandCount )
+{
+    const int nThreads =
+        m_poBaseDS ? m_poBaseDS->m_nReadThreadCount : m_nReadThreadCount;
+    if( nThreads <= 1 || eAccess != GA_ReadOnly || !m_bRegularBands ||
+        m_bStreamingIn || nBands == 0 || nXSize <= 0 ||
+        m_nCompression == COMPRESSION_NONE ||
+        m_nCompression == COMPRESSION_OJPEG ||
+        (m_nCompression == COMPRESSION_JPEG &&
+         m_nPhotometric == PHOTOMETRIC_YCBCR) ||
+        m_nBitsPerSample != GDALGetDataTypeSizeBits(
+                                GetRasterBand(1)->GetRasterDataType()) ||
+        (m_nPlanarConfig == PLANARCONFIG_CONTIG &&
+         nBands != m_nSamplesPerPixel) )
+    {
+        return 0;
+    }
+
+    const int nBlockX1 = nXOff / m_nBlockXSize;
+    const int nBlockX2 = (nXOff + nXSize - 1) / m_nBlockXSize;
+    const GIntBig nBlockRowBytes =
+        static_cast<GIntBig>(nBlockX2 - nBlockX1 + 1) *
+        m_nBlockXSize * m_nBlockYSize * (m_nBitsPerSample / 8) *
+        (m_nPlanarConfig == PLANARCONFIG_CONTIG ? nBands : nBandCount);
+    const GIntBig nMaxBlockRows = GDALGetCacheMax64() / 4 / nBlockRowBytes;
+    if( nMaxBlockRows == 0 )
+        return 0;
+    return static_cast<int>(std::min(
+        static_cast<GIntBig>(INT_MAX / m_nBlockYSize), nMaxBlockRows)) *
+        m_nBlockYSize;
+}
+
+/************************************************************************/
+/*                      ThreadDecompressionFunc()                       */
+/************************************************************************/
+
+namespace {
+struct GTiffDecompressionJob
+{
+    int              nBlockId = 0;
+    int              nXBlock = 0;
+    int              nYBlock = 0;
+    int              nBand = 0; // 0 for a pixel-interleaved block
+    GByte           *pabyRaw = nullptr;
+    size_t           nRawSize = 0;
+    GByte           *pabyDecoded = nullptr;
+    GPtrDiff_t       nBlockReqSize = 0;
+    GDALRasterBlock *poBlock = nullptr;
+    bool             bOK = false;
+};
+
+struct GTiffDecompressionContext
+{
+    TIFF                               *hTIFF = nullptr;
+    std::vector<GTiffDecompressionJob> *paoJobs = nullptr;
+    std::atomic<int>                   *pnNextJob = nullptr;
+};
+} // namespace
+
+void GTiffDataset::ThreadDecompressionFunc( void* pData )
+{
+    CPL_TRACE_SPAN("decode", "GTiffDataset::ThreadDecompressionFunc");
+    GTiffDecompressionContext* psContext =
+        static_cast<GTiffDecompressionContext*>(pData);
+    // Errors are not reported from here: blocks that fail to decompress
+    // are read again by IReadBlock(), which reports them.
+    CPLErrorHandlerPusher oQuietError(CPLQuietErrorHandler);
+    auto& aoJobs = *(psContext->paoJobs);
+    while( true )
+    {
+        const int i = psContext->pnNextJob->fetch_add(1);
+        if( i >= static_cast<int>(aoJobs.size()) )
+            break;
+        GTiffDecompressionJob& sJob = aoJobs[i];
+        const auto& oCounters = GetPerfCounters();
+        oCounters.poBlocksDecoded->Increment();
+        oCounters.poBytesDecompressed->Add(sJob.nBlockReqSize);
+        GDALPerfCounterTimer oTimer(oCounters.poDecodeTime);
+        sJob.bOK = TIFFReadFromUserBuffer( psContext->hTIFF, sJob.nBlockId,
+                                           sJob.pabyRaw,
+                                           static_cast<tmsize_t>(sJob.nRawSize),
+                                           sJob.pabyDecoded,
+                                           sJob.nBlockReqSize ) != 0;
+    }
+}
+
+/************************************************************************/
+/*                     DecompressBlocksInThreads()                      */
+/************************************************************************/
+
+// Decompresses, with several worker threads, the blocks that are not
+// already in the block cache, and puts them into it, so that the caller
+// then finds them there. Blocks that cannot be processed that way are left
+// to IReadBlock().
+void GTiffDataset::DecompressBlocksInThreads(
+                        const std::vector<std::pair<int, int>>& aoBlocks,
+                        int nBandCount, const int* panBandMap )
+{
+    const int nThreads =
+        m_poBaseDS ? m_poBaseDS->m_nReadThreadCount : m_nReadThreadCount;
+    const bool bPixelInterleaved =
+        nBands > 1 && m_nPlanarConfig == PLANARCONFIG_CONTIG;
+    const GPtrDiff_t nBlockBufSize = static_cast<GPtrDiff_t>(
+        TIFFIsTiled(m_hTIFF) ? TIFFTileSize(m_hTIFF) : TIFFStripSize(m_hTIFF));
+    const int nWordBytes = m_nBitsPerSample / 8;
+    if( nBlockBufSize != static_cast<GPtrDiff_t>(m_nBlockXSize) *
+            m_nBlockYSize * nWordBytes * (bPixelInterleaved ? nBands : 1) )
+    {
+        return;
+    }
+    const int nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, m_nBlockXSize);
+
+    // For the mask, use the parent TIFF handle to get cached ranges
+    thandle_t th = TIFFClientdata(
+        m_poImageryDS && m_bMaskInterleavedWithImagery ?
+            m_poImageryDS->m_hTIFF : m_hTIFF);
+
+    std::vector<GTiffDecompressionJob> aoJobs;
+    std::vector<vsi_l_offset> anOffsets;
+    std::vector<size_t> anSizes;
+    size_t nRawBytesToRead = 0;
+    for( const auto& oBlock: aoBlocks )
+    {
+        const int nXBlock = oBlock.first;
+        const int nYBlock = oBlock.second;
+        for( int i = 0; i < (bPixelInterleaved ? 1 : nBandCount); ++i )
+        {
+            const int nBand = bPixelInterleaved ? 0 : panBandMap[i];
+
+            // Skip blocks that are already cached for all bands.
+            bool bMissing = false;
+            for( int iBand = 1; iBand <= nBands && !bMissing; ++iBand )
+            {
+                if( nBand != 0 && iBand != nBand )
+                    continue;
+                auto poBand = cpl::down_cast<GTiffRasterBand*>(
+                    GetRasterBand(iBand));
+                GDALRasterBlock* poBlock =
+                    poBand->TryGetLockedBlockRef(nXBlock, nYBlock);
+                if( poBlock )
+                    poBlock->DropLock();
+                else
+                    bMissing = true;
+            }
+            if( !bMissing )
+                continue;
+
+            GTiffDecompressionJob sJob;
+            sJob.nXBlock = nXBlock;
+            sJob.nYBlock = nYBlock;
+            sJob.nBand = nBand;
+            sJob.nBlockId = nXBlock + nYBlock * nBlocksPerRow;
+            if( m_nPlanarConfig == PLANARCONFIG_SEPARATE )
+                sJob.nBlockId += (nBand - 1) * m_nBlocksPerBand;
+
+            // Same as in IReadBlock() for the partially encoded last
+            // strips or tiles.
+            sJob.nBlockReqSize = nBlockBufSize;
+            if( nYBlock * m_nBlockYSize > nRasterYSize - m_nBlockYSize )
+            {
+                sJob.nBlockReqSize = (nBlockBufSize / m_nBlockYSize)
+                    * (m_nBlockYSize - static_cast<int>(
+                        (static_cast<GIntBig>(nYBlock + 1) * m_nBlockYSize)
+                            % nRasterYSize));
+            }
+
+#ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
+            std::pair<vsi_l_offset, vsi_l_offset> oPair;
+            if( m_oCacheStrileToOffsetByteCount.tryGet(sJob.nBlockId, oPair) )
+            {
+                // Already fetched by CacheMultiRange()
+                sJob.nRawSize = static_cast<size_t>(oPair.second);
+                sJob.pabyRaw = static_cast<GByte*>(
+                    VSI_TIFFGetCachedRange(th, oPair.first, sJob.nRawSize));
+            }
+#endif
+            if( sJob.pabyRaw == nullptr )
+            {
+                vsi_l_offset nOffset = 0;
+                vsi_l_offset nSize = 0;
+                if( !IsBlockAvailable(sJob.nBlockId, &nOffset, &nSize) ||
+                    nSize == 0 )
+                {
+                    // Sparse block: IReadBlock() knows how to fill it.
+                    continue;
+                }
+                // Do not trust unreasonably large byte counts.
+                if( nSize > static_cast<vsi_l_offset>(nBlockBufSize) * 2 +
+                                1024 * 1024 )
+                {
+                    continue;
+                }
+                sJob.nRawSize = static_cast<size_t>(nSize);
+                anOffsets.push_back(nOffset);
+                anSizes.push_back(sJob.nRawSize);
+                nRawBytesToRead += sJob.nRawSize;
+            }
+            aoJobs.push_back(sJob);
+        }
+    }
+
+    if( aoJobs.size() < 2 ||
+        static_cast<GIntBig>(aoJobs.size()) * nBlockBufSize >
+            GDALGetCacheMax64() / 4 )
+    {
+        return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Fetch the compressed data that has not been cached yet.         */
+/* -------------------------------------------------------------------- */
+    std::vector<GByte> abyRaw;
+    std::vector<GByte> abyDecoded;
+    try
+    {
+        abyRaw.resize(nRawBytesToRead);
+        if( bPixelInterleaved )
+            abyDecoded.resize(aoJobs.size() * nBlockBufSize);
+    }
+    catch( const std::exception& )
+    {
+        return;
+    }
+    if( !anOffsets.empty() )
+    {
+        std::vector<void*> apData;
+        size_t nPos = 0;
+        for( auto& sJob: aoJobs )
+        {
+            if( sJob.pabyRaw == nullptr )
+            {
+                sJob.pabyRaw = abyRaw.data() + nPos;
+                apData.push_back(sJob.pabyRaw);
+                nPos += sJob.nRawSize;
+            }
+        }
+        VSILFILE* fp = VSI_TIFFGetVSILFile(TIFFClientdata( m_hTIFF ));
+        if( VSIFReadMultiRangeL( static_cast<int>(apData.size()),
+                                 apData.data(), anOffsets.data(),
+                                 anSizes.data(), fp ) != 0 )
+        {
+            return;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Each worker needs its own TIFF handle, as codecs have a state.  */
+/* -------------------------------------------------------------------- */
+    const int nWorkers =
+        std::min(nThreads, static_cast<int>(aoJobs.size()));
+    while( static_cast<int>(m_ahDecompressionTIFF.size()) < nWorkers )
+    {
+        TIFF* hTIFF = VSI_TIFFOpenChild(m_hTIFF);
+        if( hTIFF == nullptr )
+            break;
+        if( !TIFFSetSubDirectory(hTIFF, m_nDirOffset) )
+        {
+            XTIFFClose(hTIFF);
+            break;
+        }
+        m_ahDecompressionTIFF.push_back(hTIFF);
+    }
+    if( m_ahDecompressionTIFF.empty() )
+        return;
+
+    auto poThreadPool = GDALGetGlobalThreadPool(nWorkers);
+    auto poQueue = poThreadPool ? poThreadPool->CreateJobQueue() : nullptr;
+    if( poQueue == nullptr )
+        return;
+
+/* -------------------------------------------------------------------- */
+/*      Decompress single band blocks directly in the block cache.      */
+/* -------------------------------------------------------------------- */
+    for( size_t i = 0; i < aoJobs.size(); ++i )
+    {
+        GTiffDecompressionJob& sJob = aoJobs[i];
+        if( bPixelInterleaved )
+        {
+            sJob.pabyDecoded = abyDecoded.data() + i * nBlockBufSize;
+        }
+        else
+        {
+            sJob.poBlock = GetRasterBand(sJob.nBand)->GetLockedBlockRef(
+                sJob.nXBlock, sJob.nYBlock, TRUE);
+            if( sJob.poBlock == nullptr )
+                break;
+            sJob.pabyDecoded = static_cast<GByte*>(sJob.poBlock->GetDataRef());
+        }
+        if( sJob.nBlockReqSize < nBlockBufSize )
+            memset( sJob.pabyDecoded, 0, nBlockBufSize );
+    }
+
+    std::atomic<int> nNextJob{0};
+    std::vector<GTiffDecompressionContext> asContexts(
+        std::min(nWorkers, static_cast<int>(m_ahDecompressionTIFF.size())));
+    for( size_t i = 0; i < asContexts.size(); ++i )
+    {
+        asContexts[i].hTIFF = m_ahDecompressionTIFF[i];
+        asContexts[i].paoJobs = &aoJobs;
+        asContexts[i].pnNextJob = &nNextJob;
+    }
+    // A job without pabyDecoded is the sign of an allocation failure
+    // above: stop before it.
+    aoJobs.erase(std::find_if(aoJobs.begin(), aoJobs.end(),
+                              [](const GTiffDecompressionJob& sJob)
+                              { return sJob.pabyDecoded == nullptr; }),
+                 aoJobs.end());
+    for( auto& sContext: asContexts )
+        poQueue->SubmitJob(ThreadDecompressionFunc, &sContext);
+    poQueue->WaitCompletion();
+
+/* -------------------------------------------------------------------- */
+/*      Publish the decompressed blocks.                                */
+/* -------------------------------------------------------------------- */
+    for( const auto& sJob: aoJobs )
+    {
+        if( !bPixelInterleaved )
+        {
+            sJob.poBlock->DropLock();
+            if( !sJob.bOK )
+            {
+                GetRasterBand(sJob.nBand)->FlushBlock(sJob.nXBlock,
+                                                      sJob.nYBlock, FALSE);
+            }
+            continue;
+        }
+        if( !sJob.bOK )
+            continue;
+        for( int iBand = 1; iBand <= nBands; ++iBand )
+        {
+            auto poBand = cpl::down_cast<GTiffRasterBand*>(
+                GetRasterBand(iBand));
+            GDALRasterBlock* poBlock =
+                poBand->TryGetLockedBlockRef(sJob.nXBlock, sJob.nYBlock);
+            if( poBlock == nullptr )
+            {
+                poBlock = poBand->GetLockedBlockRef(sJob.nXBlock,
+                                                    sJob.nYBlock, TRUE);
+                if( poBlock == nullptr )
+                    continue;
+                GDALCopyWords64(sJob.pabyDecoded + (iBand - 1) * nWordBytes,
+                                poBand->GetRasterDataType(),
+                                nBands * nWordBytes,
+                                poBlock->GetDataRef(),
+                                poBand->GetRasterDataType(), nWordBytes,
+                                static_cast<GPtrDiff_t>(m_nBlockXSize) *
+                                    m_nBlockYSize);
+            }
+            poBlock->DropLock();
+        }
+    }
+}
+
 /************************************************************************/
 /*                        FetchBufferVirtualMemIO                       */
 /************************************************************************/
@@ -3755,6 +4492,144 @@ template<class FetchBuffer> CPLErr GTiffDataset::CommonDirectIO(
     return CE_None;
 }
 
+/************************************************************************/
+/*                      WriteWholeBlocksDirectly()                      */
+/************************************************************************/
+
+// Writes a window made only of whole blocks of a pixel-interleaved file,
+// when all bands are provided at once. Each block is interleaved from the
+// user buffer and encoded once, instead of going through the block cache of
+// each band and being merged band after band in m_pabyBlockBuf, which may
+// require reading it back from disk.
+// Returns -1 if the request cannot be handled that way.
+
+int GTiffDataset::WriteWholeBlocksDirectly( int nXOff, int nYOff,
+                                            int nXSize, int nYSize,
+                                            const void * pData,
+                                            int nBufXSize, int nBufYSize,
+                                            GDALDataType eBufType,
+                                            int nBandCount,
+                                            const int *panBandMap,
+                                            GSpacing nPixelSpace,
+                                            GSpacing nLineSpace,
+                                            GSpacing nBandSpace,
+                                            GDALRasterIOExtraArg* psExtraArg )
+{
+    if( eAccess != GA_Update || nBands == 1 || nBandCount != nBands ||
+        m_nPlanarConfig != PLANARCONFIG_CONTIG ||
+        nXSize != nBufXSize || nYSize != nBufYSize ||
+        m_bDebugDontWriteBlocks || m_bWriteError )
+    {
+        return -1;
+    }
+
+    const GDALDataType eDataType = GetRasterBand(1)->GetRasterDataType();
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
+    if( m_nBitsPerSample != GDALGetDataTypeSizeBits(eDataType) )
+        return -1;
+
+    // Each band must be provided exactly once.
+    std::vector<bool> abBandSeen(nBands);
+    for( int i = 0; i < nBandCount; ++i )
+    {
+        if( panBandMap[i] < 1 || panBandMap[i] > nBands ||
+            abBandSeen[panBandMap[i] - 1] )
+            return -1;
+        abBandSeen[panBandMap[i] - 1] = true;
+    }
+
+    // The window must be made of whole blocks, the last row and column of
+    // blocks possibly being truncated by the raster edges.
+    if( (nXOff % m_nBlockXSize) != 0 || (nYOff % m_nBlockYSize) != 0 ||
+        ((nXOff + nXSize) % m_nBlockXSize != 0 &&
+         nXOff + nXSize != nRasterXSize) ||
+        ((nYOff + nYSize) % m_nBlockYSize != 0 &&
+         nYOff + nYSize != nRasterYSize) )
+    {
+        return -1;
+    }
+
+    Crystalize();
+
+    const int nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, m_nBlockXSize);
+    const int nXBlockStart = nXOff / m_nBlockXSize;
+    const int nXBlockEnd = DIV_ROUND_UP(nXOff + nXSize, m_nBlockXSize);
+    const int nYBlockStart = nYOff / m_nBlockYSize;
+    const int nYBlockEnd = DIV_ROUND_UP(nYOff + nYSize, m_nBlockYSize);
+    const GPtrDiff_t nBlockPixels =
+        static_cast<GPtrDiff_t>(m_nBlockXSize) * m_nBlockYSize;
+    const size_t nBlockBytes =
+        static_cast<size_t>(nBlockPixels) * nBands * nDTSize;
+
+    GByte* pabyBlock = static_cast<GByte*>(VSI_MALLOC_VERBOSE(nBlockBytes));
+    if( pabyBlock == nullptr )
+        return CE_Failure;
+
+    CPLErr eErr = CE_None;
+    for( int iYBlock = nYBlockStart;
+         eErr == CE_None && iYBlock < nYBlockEnd; ++iYBlock )
+    {
+        const int nLineStart = iYBlock * m_nBlockYSize;
+        const int nLines =
+            std::min(m_nBlockYSize, nRasterYSize - nLineStart);
+        for( int iXBlock = nXBlockStart;
+             eErr == CE_None && iXBlock < nXBlockEnd; ++iXBlock )
+        {
+            const int nColStart = iXBlock * m_nBlockXSize;
+            const int nCols =
+                std::min(m_nBlockXSize, nRasterXSize - nColStart);
+            const int nBlockId = iXBlock + iYBlock * nBlocksPerRow;
+
+            // The block is entirely overwritten, so discard any cached
+            // version of it, dirty or not.
+            for( int iBand = 1; iBand <= nBands; ++iBand )
+                GetRasterBand(iBand)->FlushBlock(iXBlock, iYBlock, FALSE);
+            if( m_nLoadedBlock == nBlockId )
+            {
+                m_nLoadedBlock = -1;
+                m_bLoadedBlockDirty = false;
+            }
+
+            if( nCols < m_nBlockXSize || nLines < m_nBlockYSize )
+                memset(pabyBlock, 0, nBlockBytes);
+
+            for( int i = 0; i < nBandCount; ++i )
+            {
+                for( int iLine = 0; iLine < nLines; ++iLine )
+                {
+                    const GByte* pabySrc =
+                        static_cast<const GByte*>(pData) +
+                        i * nBandSpace +
+                        (nLineStart - nYOff + iLine) * nLineSpace +
+                        (nColStart - nXOff) * nPixelSpace;
+                    GByte* pabyDst = pabyBlock +
+                        (static_cast<GPtrDiff_t>(iLine) * m_nBlockXSize *
+                            nBands + (panBandMap[i] - 1)) * nDTSize;
+                    GDALCopyWords64(pabySrc, eBufType,
+                                    static_cast<int>(nPixelSpace),
+                                    pabyDst, eDataType, nBands * nDTSize,
+                                    nCols);
+                }
+            }
+
+            eErr = WriteEncodedTileOrStrip(nBlockId, pabyBlock, false);
+        }
+
+        if( eErr == CE_None && psExtraArg->pfnProgress &&
+            !psExtraArg->pfnProgress(
+                static_cast<double>(iYBlock - nYBlockStart + 1) /
+                    (nYBlockEnd - nYBlockStart),
+                "", psExtraArg->pProgressData) )
+        {
+            ReportError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+            eErr = CE_Failure;
+        }
+    }
+
+    VSIFree(pabyBlock);
+    return eErr;
+}
+
 /************************************************************************/
 /*                           DirectIO()                                 */
 /************************************************************************/
@@ -4097,7 +4972,23 @@ void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
                                         int nBufXSize, int nBufYSize,
                                         GDALRasterIOExtraArg* psExtraArg )
 {
-    void* pBufferedData = nullptr;
+    return CacheMultiRange(GetBlocksInWindow(nXOff, nYOff, nXSize, nYSize,
+                                             nBufXSize, nBufYSize,
+                                             psExtraArg));
+}
+
+/************************************************************************/
+/*                         GetBlocksInWindow()                          */
+/************************************************************************/
+
+// Returns the (x, y) coordinates, in row-major order, of the blocks that
+// are read by a request on the specified window.
+std::vector<std::pair<int, int>> GTiffRasterBand::GetBlocksInWindow(
+                                        int nXOff, int nYOff,
+                                        int nXSize, int nYSize,
+                                        int nBufXSize, int nBufYSize,
+                                        GDALRasterIOExtraArg* psExtraArg )
+{
     // Same logic as in GDALRasterBand::IRasterIO()
     double dfXOff = nXOff;
     double dfYOff = nYOff;
@@ -4117,6 +5008,28 @@ void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
     const int nBlockY1 = static_cast<int>(std::max(0.0, (0+0.5) * dfSrcYInc + dfYOff + EPS)) / nBlockYSize;
     const int nBlockX2 = static_cast<int>(std::min(static_cast<double>(nRasterXSize - 1), (nBufXSize-1+0.5) * dfSrcXInc + dfXOff + EPS)) / nBlockXSize;
     const int nBlockY2 = static_cast<int>(std::min(static_cast<double>(nRasterYSize - 1), (nBufYSize-1+0.5) * dfSrcYInc + dfYOff + EPS)) / nBlockYSize;
+
+    std::vector<std::pair<int, int>> aoBlocks;
+    for( int iY = nBlockY1; iY <= nBlockY2; iY ++)
+    {
+        for( int iX = nBlockX1; iX <= nBlockX2; iX ++)
+        {
+            aoBlocks.emplace_back(iX, iY);
+        }
+    }
+    return aoBlocks;
+}
+
+/************************************************************************/
+/*                         CacheMultiRange()                            */
+/************************************************************************/
+
+// Same as above, but from an explicit list of (x, y) block coordinates,
+// which should be sorted in row-major order for best efficiency.
+void* GTiffRasterBand::CacheMultiRange(
+                        const std::vector<std::pair<int, int>>& aoBlocks )
+{
+    void* pBufferedData = nullptr;
 #ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
     const int nBlockXCount = DIV_ROUND_UP(nRasterXSize, nBlockXSize);
     const int nBlockYCount = DIV_ROUND_UP(nRasterYSize, nBlockYSize);
@@ -4142,7 +5055,7 @@ void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
                                                size_t nMaxRawBlockCacheSize)
     {
         bool bTryMask = m_poGDS->m_bMaskInterleavedWithImagery;
-        nOffset = TIFFGetStrileOffset(m_poGDS->m_hTIFF, nBlockId);
+        nOffset = m_poGDS->GetStrileOffset(nBlockId);
         if( nOffset >= 4 )
         {
             if( nBlockId == nBlockCount - 1 )
@@ -4154,10 +5067,10 @@ void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
                     m_poGDS->GetRasterBand(1)->GetMaskBand() &&
                     m_poGDS->m_poMaskDS )
                 {
-                    auto nMaskOffset = TIFFGetStrileOffset(m_poGDS->m_poMaskDS->m_hTIFF, nBlockId);
+                    auto nMaskOffset = m_poGDS->m_poMaskDS->GetStrileOffset(nBlockId);
                     if( nMaskOffset )
                     {
-                        nSize = nMaskOffset + TIFFGetStrileByteCount(m_poGDS->m_poMaskDS->m_hTIFF, nBlockId) - nOffset;
+                        nSize = nMaskOffset + m_poGDS->m_poMaskDS->GetStrileByteCount(nBlockId) - nOffset;
                     }
                     else
                     {
@@ -4166,7 +5079,7 @@ void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
                 }
                 if( nSize == 0 )
                 {
-                    nSize = TIFFGetStrileByteCount(m_poGDS->m_hTIFF, nBlockId);
+                    nSize = m_poGDS->GetStrileByteCount(nBlockId);
                 }
                 if( nSize && m_poGDS->m_bTrailerRepeatedLast4BytesRepeated )
                 {
@@ -4175,7 +5088,7 @@ void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
             }
             else
             {
-                auto nOffsetNext = TIFFGetStrileOffset(m_poGDS->m_hTIFF, nBlockId + 1);
+                auto nOffsetNext = m_poGDS->GetStrileOffset(nBlockId + 1);
                 if( nOffsetNext > nOffset )
                 {
                     nSize = nOffsetNext - nOffset;
@@ -4189,7 +5102,7 @@ void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
                                     "Tile %d is not located after %d", nBlockId + 1, nBlockId);
                     }
                     bTryMask = false;
-                    nSize = TIFFGetStrileByteCount(m_poGDS->m_hTIFF, nBlockId);
+                    nSize = m_poGDS->GetStrileByteCount(nBlockId);
                     if( m_poGDS->m_bTrailerRepeatedLast4BytesRepeated )
                         nSize += 4;
                 }
@@ -4374,56 +5287,54 @@ void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
         const unsigned int nMaxRawBlockCacheSize =
             atoi(CPLGetConfigOption("GDAL_MAX_RAW_BLOCK_CACHE_SIZE",
                                     "10485760"));
-        bool bGoOn = true;
-        for( int iY = nBlockY1; bGoOn && iY <= nBlockY2; iY ++)
+        for( const auto& oBlock: aoBlocks )
         {
-            for( int iX = nBlockX1; bGoOn && iX <= nBlockX2; iX ++)
+            const int iX = oBlock.first;
+            const int iY = oBlock.second;
+            GDALRasterBlock* poBlock = TryGetLockedBlockRef(iX, iY);
+            if( poBlock != nullptr )
             {
-                GDALRasterBlock* poBlock = TryGetLockedBlockRef(iX, iY);
-                if( poBlock != nullptr )
-                {
-                    poBlock->DropLock();
-                    continue;
-                }
-                int nBlockId = iX + iY * nBlocksPerRow;
-                if( m_poGDS->m_nPlanarConfig == PLANARCONFIG_SEPARATE )
-                    nBlockId += (nBand - 1) * m_poGDS->m_nBlocksPerBand;
-                vsi_l_offset nOffset = 0;
-                vsi_l_offset nSize = 0;
+                poBlock->DropLock();
+                continue;
+            }
+            int nBlockId = iX + iY * nBlocksPerRow;
+            if( m_poGDS->m_nPlanarConfig == PLANARCONFIG_SEPARATE )
+                nBlockId += (nBand - 1) * m_poGDS->m_nBlocksPerBand;
+            vsi_l_offset nOffset = 0;
+            vsi_l_offset nSize = 0;
 
 #ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
-                if( (m_poGDS->m_nPlanarConfig == PLANARCONFIG_CONTIG || m_poGDS->nBands == 1) &&
-                    !m_poGDS->m_bStreamingIn &&
-                    m_poGDS->m_bBlockOrderRowMajor && m_poGDS->m_bLeaderSizeAsUInt4 )
-                {
-                    OptimizedRetrievalOfOffsetSize(nBlockId, nOffset, nSize, nTotalSize, nMaxRawBlockCacheSize);
-                }
-                else
+            if( (m_poGDS->m_nPlanarConfig == PLANARCONFIG_CONTIG || m_poGDS->nBands == 1) &&
+                !m_poGDS->m_bStreamingIn &&
+                m_poGDS->m_bBlockOrderRowMajor && m_poGDS->m_bLeaderSizeAsUInt4 )
+            {
+                OptimizedRetrievalOfOffsetSize(nBlockId, nOffset, nSize, nTotalSize, nMaxRawBlockCacheSize);
+            }
+            else
 #endif
+            {
+                CPL_IGNORE_RET_VAL(m_poGDS->IsBlockAvailable(nBlockId, &nOffset, &nSize));
+            }
+            if( nSize )
+            {
+                if( nTotalSize + nSize < nMaxRawBlockCacheSize )
                 {
-                    CPL_IGNORE_RET_VAL(m_poGDS->IsBlockAvailable(nBlockId, &nOffset, &nSize));
-                }
-                if( nSize )
-                {
-                    if( nTotalSize + nSize < nMaxRawBlockCacheSize )
-                    {
 #ifdef DEBUG_VERBOSE
-                        CPLDebug("GTiff",
-                                 "Precaching for block (%d, %d), "
-                                 CPL_FRMT_GUIB "-" CPL_FRMT_GUIB,
-                                 iX, iY,
-                                 nOffset,
-                                 nOffset + static_cast<size_t>(nSize) - 1);
+                    CPLDebug("GTiff",
+                             "Precaching for block (%d, %d), "
+                             CPL_FRMT_GUIB "-" CPL_FRMT_GUIB,
+                             iX, iY,
+                             nOffset,
+                             nOffset + static_cast<size_t>(nSize) - 1);
 #endif
-                        aOffsetSize.push_back(
-                            std::pair<vsi_l_offset, size_t>
-                                (nOffset, static_cast<size_t>(nSize)) );
-                        nTotalSize += static_cast<size_t>(nSize);
-                    }
-                    else
-                    {
-                        bGoOn = false;
-                    }
+                    aOffsetSize.push_back(
+                        std::pair<vsi_l_offset, size_t>
+                            (nOffset, static_cast<size_t>(nSize)) );
+                    nTotalSize += static_cast<size_t>(nSize);
+                }
+                else
+                {
+                    break;
                 }
             }
         }
@@ -4497,9 +5408,7 @@ void* GTiffRasterBand::CacheMultiRange( int nXOff, int nYOff,
                         // Retry without optimization
                         CPLFree(pBufferedData);
                         m_poGDS->m_bLeaderSizeAsUInt4 = false;
-                        void* pRet = CacheMultiRange(
-                            nXOff, nYOff, nXSize, nYSize,
-                            nBufXSize, nBufYSize, psExtraArg );
+                        void* pRet = CacheMultiRange(aoBlocks);
                         m_poGDS->m_bLeaderSizeAsUInt4 = true;
                         return pRet;
                     }
@@ -4569,10 +5478,48 @@ CPLErr GTiffRasterBand::IRasterIO( GDALRWFlag eRWFlag,
             return static_cast<CPLErr>(nErr);
     }
 
+    const int nThreadedReadChunkYSize =
+        eRWFlag == GF_Read ?
+            m_poGDS->GetThreadedReadChunkYSize(nXOff, nXSize, 1) : 0;
+    if( nThreadedReadChunkYSize > 0 &&
+        nXSize == nBufXSize && nYSize == nBufYSize &&
+        nYOff / nThreadedReadChunkYSize !=
+            (nYOff + nYSize - 1) / nThreadedReadChunkYSize )
+    {
+        // Split the request in chunks whose blocks fit in the block cache,
+        // so that decompressed blocks are not evicted before being used.
+        CPLErr eErr = CE_None;
+        for( int nChunkYOff = nYOff;
+             eErr == CE_None && nChunkYOff < nYOff + nYSize; )
+        {
+            const int nChunkYEnd = std::min(nYOff + nYSize,
+                (nChunkYOff / nThreadedReadChunkYSize + 1) *
+                    nThreadedReadChunkYSize);
+            GDALRasterIOExtraArg sExtraArg;
+            INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+            sExtraArg.eResampleAlg = psExtraArg->eResampleAlg;
+            sExtraArg.pfnProgress = GDALScaledProgress;
+            sExtraArg.pProgressData = GDALCreateScaledProgress(
+                static_cast<double>(nChunkYOff - nYOff) / nYSize,
+                static_cast<double>(nChunkYEnd - nYOff) / nYSize,
+                psExtraArg->pfnProgress, psExtraArg->pProgressData );
+            eErr = IRasterIO( eRWFlag, nXOff, nChunkYOff,
+                              nXSize, nChunkYEnd - nChunkYOff,
+                              static_cast<GByte*>(pData) +
+                                  (nChunkYOff - nYOff) * nLineSpace,
+                              nXSize, nChunkYEnd - nChunkYOff, eBufType,
+                              nPixelSpace, nLineSpace, &sExtraArg );
+            GDALDestroyScaledProgress( sExtraArg.pProgressData );
+            nChunkYOff = nChunkYEnd;
+        }
+        return eErr;
+    }
+
     void* pBufferedData = nullptr;
     if( m_poGDS->eAccess == GA_ReadOnly &&
         eRWFlag == GF_Read &&
-        m_poGDS->HasOptimizedReadMultiRange() )
+        m_poGDS->HasOptimizedReadMultiRange() &&
+        !m_poGDS->HasBatchCachedRanges() )
     {
         GTiffRasterBand* poBandForCache = this;
 
@@ -4593,6 +5540,14 @@ CPLErr GTiffRasterBand::IRasterIO( GDALRWFlag eRWFlag,
                                         psExtraArg);
     }
 
+    if( nThreadedReadChunkYSize > 0 )
+    {
+        m_poGDS->DecompressBlocksInThreads(
+            GetBlocksInWindow(nXOff, nYOff, nXSize, nYSize,
+                              nBufXSize, nBufYSize, psExtraArg),
+            1, &nBand);
+    }
+
     if( m_poGDS->nBands != 1 &&
         m_poGDS->m_nPlanarConfig == PLANARCONFIG_CONTIG &&
         eRWFlag == GF_Read &&
@@ -4632,6 +5587,10 @@ CPLErr GTiffRasterBand::IRasterIO( GDALRWFlag eRWFlag,
 
     m_poGDS->m_bLoadingOtherBands = false;
 
+    if( eErr == CE_None && eRWFlag == GF_Write && m_poGDS->m_bStreamingWrite )
+        m_poGDS->FlushCompletedBlockRows(nXOff, nYOff, nXSize, nYSize,
+                                         1, &nBand);
+
     if( pBufferedData )
     {
         VSIFree( pBufferedData );
@@ -4741,6 +5700,18 @@ bool GTiffDataset::ReadStrile(int nBlockId,
                               void* pOutputBuffer,
                               GPtrDiff_t nBlockReqSize)
 {
+    CPLTraceSpan oSpan("decode", "GTiffDataset::ReadStrile");
+    if( oSpan.IsActive() )
+    {
+        oSpan.AddArg("block_id", static_cast<GIntBig>(nBlockId));
+        oSpan.AddArg("compression", static_cast<GIntBig>(m_nCompression));
+    }
+
+    const auto& oCounters = GetPerfCounters();
+    oCounters.poBlocksDecoded->Increment();
+    oCounters.poBytesDecompressed->Add(nBlockReqSize);
+    GDALPerfCounterTimer oTimer(oCounters.poDecodeTime);
+
 #ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
     std::pair<vsi_l_offset, vsi_l_offset> oPair;
     if( m_oCacheStrileToOffsetByteCount.tryGet(nBlockId, oPair) )
@@ -4759,6 +5730,43 @@ bool GTiffDataset::ReadStrile(int nBlockId,
             return true;
         }
     }
+
+    // If the strile location comes from the strile index cache, read it
+    // ourselves, as libtiff would otherwise load the arrays we wanted to
+    // avoid fetching.
+    if( m_poStrileIndex &&
+        nBlockId >= 0 &&
+        static_cast<size_t>(nBlockId) < m_poStrileIndex->anOffsets.size() )
+    {
+        const vsi_l_offset nOffset = m_poStrileIndex->anOffsets[nBlockId];
+        const vsi_l_offset nSize = m_poStrileIndex->anByteCounts[nBlockId];
+        // Do not trust unreasonably large byte counts.
+        if( nOffset != 0 && nSize != 0 &&
+            nSize <= static_cast<vsi_l_offset>(nBlockReqSize) * 2 +
+                         1024 * 1024 )
+        {
+            std::vector<GByte> abyRaw;
+            try
+            {
+                abyRaw.resize(static_cast<size_t>(nSize));
+            }
+            catch( const std::exception& )
+            {
+                abyRaw.clear();
+            }
+            VSILFILE* fp = VSI_TIFFGetVSILFile(TIFFClientdata( m_hTIFF ));
+            if( !abyRaw.empty() &&
+                VSIFSeekL( fp, nOffset, SEEK_SET ) == 0 &&
+                VSIFReadL( abyRaw.data(), 1, abyRaw.size(), fp ) ==
+                    abyRaw.size() &&
+                TIFFReadFromUserBuffer( m_hTIFF, nBlockId,
+                                        abyRaw.data(), abyRaw.size(),
+                                        pOutputBuffer, nBlockReqSize ) )
+            {
+                return true;
+            }
+        }
+    }
 #endif
 
     // For debugging
@@ -7731,6 +8739,7 @@ GTiffDataset::GTiffDataset():
     m_bIsFinalized(false),
     m_bIgnoreReadErrors(CPLTestBool(CPLGetConfigOption("GTIFF_IGNORE_READ_ERRORS", "NO"))),
     m_bDirectIO(CPLTestBool(CPLGetConfigOption("GTIFF_DIRECT_IO", "NO"))),
+    m_bStreamingWrite(CPLTestBool(CPLGetConfigOption("GTIFF_STREAMING_WRITE", "NO"))),
     m_bReadGeoTransform(false),
     m_bLoadPam(false),
     m_bHasGotSiblingFiles(false),
@@ -7846,6 +8855,11 @@ int GTiffDataset::Finalize()
         m_poCompressQueue.reset();
     }
 
+    // Child handles must be closed before their parent
+    for( TIFF* hTIFF: m_ahDecompressionTIFF )
+        XTIFFClose( hTIFF );
+    m_ahDecompressionTIFF.clear();
+
 /* -------------------------------------------------------------------- */
 /*      If there is still changed metadata, then presumably we want     */
 /*      to push it into PAM.                                            */
@@ -8587,6 +9601,15 @@ bool GTiffDataset::WriteEncodedTile( uint32_t tile, GByte *pabyData,
     if( SubmitCompressionJob(tile, pabyData, cc, m_nBlockYSize) )
         return true;
 
+    CPLTraceSpan oSpan("encode", "TIFFWriteEncodedTile");
+    if( oSpan.IsActive() )
+        oSpan.AddArg("compression", static_cast<GIntBig>(m_nCompression));
+
+    const auto& oCounters = GetPerfCounters();
+    oCounters.poBlocksEncoded->Increment();
+    oCounters.poBytesCompressed->Add(cc);
+    GDALPerfCounterTimer oTimer(oCounters.poEncodeTime);
+
     // libtiff 4.0.6 or older do not always properly report write errors.
 #if TIFFLIB_VERSION <= 20150912
     const CPLErr eBefore = CPLGetLastErrorType();
@@ -8694,6 +9717,15 @@ bool GTiffDataset::WriteEncodedStrip( uint32_t strip, GByte* pabyData,
     if( SubmitCompressionJob(strip, pabyData, cc, nStripHeight) )
         return true;
 
+    CPLTraceSpan oSpan("encode", "TIFFWriteEncodedStrip");
+    if( oSpan.IsActive() )
+        oSpan.AddArg("compression", static_cast<GIntBig>(m_nCompression));
+
+    const auto& oCounters = GetPerfCounters();
+    oCounters.poBlocksEncoded->Increment();
+    oCounters.poBytesCompressed->Add(cc);
+    GDALPerfCounterTimer oTimer(oCounters.poEncodeTime);
+
     // libtiff 4.0.6 or older do not always properly report write errors.
 #if TIFFLIB_VERSION <= 20150912
     CPLErr eBefore = CPLGetLastErrorType();
@@ -8784,6 +9816,42 @@ void GTiffDataset::InitCompressionThreads( char** papszOptions )
     }
 }
 
+/************************************************************************/
+/*                          InitReadThreads()                           */
+/************************************************************************/
+
+void GTiffDataset::InitReadThreads( char** papszOptions )
+{
+    // Raster == tile, or uncompressed, then no need for threads
+    if( (m_nBlockXSize == nRasterXSize && m_nBlockYSize == nRasterYSize) ||
+        m_nCompression == COMPRESSION_NONE )
+        return;
+
+    const char* pszValue = CSLFetchNameValue( papszOptions, "NUM_THREADS" );
+    if( pszValue == nullptr )
+        pszValue = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszValue )
+    {
+        int nThreads =
+            EQUAL(pszValue, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszValue);
+        if( nThreads > 1024 )
+            nThreads = 1024; // to please Coverity
+        if( nThreads > 1 )
+        {
+            CPLDebug("GTiff", "Using %d threads for decompression", nThreads);
+            m_nReadThreadCount = nThreads;
+        }
+        else if( nThreads < 0 ||
+                 (!EQUAL(pszValue, "0") &&
+                  !EQUAL(pszValue, "1") &&
+                  !EQUAL(pszValue, "ALL_CPUS")) )
+        {
+            ReportError(CE_Warning, CPLE_AppDefined,
+                     "Invalid value for NUM_THREADS: %s", pszValue);
+        }
+    }
+}
+
 /************************************************************************/
 /*                       GetGTIFFKeysFlavor()                           */
 /************************************************************************/
@@ -8833,6 +9901,8 @@ void GTiffDataset::ThreadCompressionFunc( void* pData )
     GTiffCompressionJob* psJob = static_cast<GTiffCompressionJob *>(pData);
     GTiffDataset* poDS = psJob->poDS;
 
+    CPL_TRACE_SPAN("encode", "GTiffDataset::ThreadCompressionFunc");
+
     VSILFILE* fpTmp = VSIFOpenL(psJob->pszTmpFilename, "wb+");
     TIFF* hTIFFTmp = VSI_TIFFOpen(psJob->pszTmpFilename,
         psJob->bTIFFIsBigEndian ? "wb+" : "wl+", fpTmp);
@@ -8862,9 +9932,15 @@ void GTiffDataset::ThreadCompressionFunc( void* pData )
 
     poDS->RestoreVolatileParameters(hTIFFTmp);
 
-    bool bOK =
-        TIFFWriteEncodedStrip(hTIFFTmp, 0, psJob->pabyBuffer,
-                              psJob->nBufferSize) == psJob->nBufferSize;
+    bool bOK;
+    {
+        const auto& oCounters = GetPerfCounters();
+        oCounters.poBlocksEncoded->Increment();
+        oCounters.poBytesCompressed->Add(psJob->nBufferSize);
+        GDALPerfCounterTimer oTimer(oCounters.poEncodeTime);
+        bOK = TIFFWriteEncodedStrip(hTIFFTmp, 0, psJob->pabyBuffer,
+                                    psJob->nBufferSize) == psJob->nBufferSize;
+    }
 
     toff_t nOffset = 0;
     if( bOK )
@@ -9698,12 +10774,12 @@ bool GTiffDataset::IsBlockAvailable( int nBlockId,
     if( eAccess == GA_ReadOnly && !m_bStreamingIn )
     {
         int nErrOccurred = 0;
-        auto bytecount = TIFFGetStrileByteCountWithErr(m_hTIFF, nBlockId, &nErrOccurred);
+        auto bytecount = GetStrileByteCount(nBlockId, &nErrOccurred);
         if( nErrOccurred && pbErrOccurred )
             *pbErrOccurred = true;
         if( pnOffset )
         {
-            *pnOffset = TIFFGetStrileOffsetWithErr(m_hTIFF, nBlockId, &nErrOccurred);
+            *pnOffset = GetStrileOffset(nBlockId, &nErrOccurred);
             if( nErrOccurred && pbErrOccurred )
                 *pbErrOccurred = true;
         }
@@ -9726,34 +10802,242 @@ bool GTiffDataset::IsBlockAvailable( int nBlockId,
           && (pnOffset == nullptr ||
               TIFFGetField( m_hTIFF, TIFFTAG_STRIPOFFSETS, &panOffsets )) ) )
     {
-        if( panByteCounts == nullptr || (pnOffset != nullptr && panOffsets == nullptr) )
+        if( panByteCounts == nullptr || (pnOffset != nullptr && panOffsets == nullptr) )
+        {
+            if( pbErrOccurred )
+                *pbErrOccurred = true;
+            return false;
+        }
+        const int nBlockCount =
+            bIsTiled ? TIFFNumberOfTiles(m_hTIFF) : TIFFNumberOfStrips(m_hTIFF);
+        if( nBlockId >= nBlockCount )
+        {
+            if( pbErrOccurred )
+                *pbErrOccurred = true;
+            return false;
+        }
+
+        if( pnOffset )
+            *pnOffset = panOffsets[nBlockId];
+        if( pnSize )
+            *pnSize = panByteCounts[nBlockId];
+        return panByteCounts[nBlockId] != 0;
+    }
+    else
+    {
+        if( pbErrOccurred )
+            *pbErrOccurred = true;
+    }
+
+    return false;
+}
+
+/************************************************************************/
+/*                          LoadStrileIndex()                           */
+/************************************************************************/
+
+#ifdef SUPPORTS_GET_OFFSET_BYTECOUNT
+void GTiffDataset::LoadStrileIndex()
+{
+    if( m_bStrileIndexLookedUp )
+        return;
+    m_bStrileIndexLookedUp = true;
+    if( eAccess != GA_ReadOnly || m_bStreamingIn || m_pszFilename == nullptr )
+        return;
+
+    const std::string osKey =
+        GTIFFGetStrileIndexCacheKey(m_pszFilename, m_nDirOffset);
+    if( osKey.empty() )
+        return;
+
+    const bool bIsTiled = CPL_TO_BOOL( TIFFIsTiled(m_hTIFF) );
+    const size_t nStrileCount = static_cast<size_t>(
+        bIsTiled ? TIFFNumberOfTiles(m_hTIFF) : TIFFNumberOfStrips(m_hTIFF));
+    m_poStrileIndex = GTIFFGetCachedStrileIndex(osKey, nStrileCount);
+    if( m_poStrileIndex )
+        return;
+
+    // Not cached yet: read the whole arrays at once, instead of the slices
+    // that would otherwise be lazily loaded, and publish them. Lookups
+    // then go through libtiff that has loaded them.
+    toff_t *panByteCounts = nullptr;
+    toff_t *panOffsets = nullptr;
+    if( !TIFFGetField( m_hTIFF,
+             bIsTiled ? TIFFTAG_TILEOFFSETS : TIFFTAG_STRIPOFFSETS,
+             &panOffsets ) ||
+        !TIFFGetField( m_hTIFF,
+             bIsTiled ? TIFFTAG_TILEBYTECOUNTS : TIFFTAG_STRIPBYTECOUNTS,
+             &panByteCounts ) ||
+        panOffsets == nullptr || panByteCounts == nullptr )
+    {
+        return;
+    }
+    auto poIndex = std::make_shared<GTiffStrileIndex>();
+    try
+    {
+        poIndex->anOffsets.assign(panOffsets, panOffsets + nStrileCount);
+        poIndex->anByteCounts.assign(panByteCounts,
+                                     panByteCounts + nStrileCount);
+    }
+    catch( const std::exception& )
+    {
+        return;
+    }
+    GTIFFPutCachedStrileIndex(osKey, poIndex);
+}
+
+/************************************************************************/
+/*                          GetStrileOffset()                           */
+/************************************************************************/
+
+vsi_l_offset GTiffDataset::GetStrileOffset( int nBlockId, int* pnErrOccurred )
+{
+    LoadStrileIndex();
+    if( m_poStrileIndex )
+    {
+        const bool bValid = nBlockId >= 0 &&
+            static_cast<size_t>(nBlockId) < m_poStrileIndex->anOffsets.size();
+        if( pnErrOccurred )
+            *pnErrOccurred = !bValid;
+        return bValid ? m_poStrileIndex->anOffsets[nBlockId] : 0;
+    }
+    int nErrOccurred = 0;
+    const auto nOffset =
+        TIFFGetStrileOffsetWithErr(m_hTIFF, nBlockId, &nErrOccurred);
+    if( pnErrOccurred )
+        *pnErrOccurred = nErrOccurred;
+    return nOffset;
+}
+
+/************************************************************************/
+/*                         GetStrileByteCount()                         */
+/************************************************************************/
+
+vsi_l_offset GTiffDataset::GetStrileByteCount( int nBlockId,
+                                               int* pnErrOccurred )
+{
+    LoadStrileIndex();
+    if( m_poStrileIndex )
+    {
+        const bool bValid = nBlockId >= 0 &&
+            static_cast<size_t>(nBlockId) <
+                m_poStrileIndex->anByteCounts.size();
+        if( pnErrOccurred )
+            *pnErrOccurred = !bValid;
+        return bValid ? m_poStrileIndex->anByteCounts[nBlockId] : 0;
+    }
+    int nErrOccurred = 0;
+    const auto nByteCount =
+        TIFFGetStrileByteCountWithErr(m_hTIFF, nBlockId, &nErrOccurred);
+    if( pnErrOccurred )
+        *pnErrOccurred = nErrOccurred;
+    return nByteCount;
+}
+#endif
+
+/************************************************************************/
+/*                      FlushCompletedBlockRows()                       */
+/************************************************************************/
+
+// Used when GTIFF_STREAMING_WRITE=YES. Keeps track of the lines written by
+// full width RasterIO() requests issued from top to bottom, and writes the
+// blocks of each block row as soon as it has been completely written, in
+// file order, instead of letting dirty blocks accumulate in the block cache
+// until they are evicted or the dataset is flushed. When NUM_THREADS is set,
+// the blocks of the row are compressed in parallel.
+void GTiffDataset::FlushCompletedBlockRows( int nXOff, int nYOff,
+                                            int nXSize, int nYSize,
+                                            int nBandCount,
+                                            const int* panBandMap )
+{
+    if( nXOff != 0 || nXSize != nRasterXSize || m_bWriteError ||
+        m_bDebugDontWriteBlocks )
+        return;
+
+    if( m_anStreamingWriteNextLine.empty() )
+    {
+        m_anStreamingWriteNextLine.resize(nBands, 0);
+        m_anStreamingWriteFlushedBlockRows.resize(nBands, 0);
+    }
+
+    for( int i = 0; i < nBandCount; ++i )
+    {
+        int& nNextLine = m_anStreamingWriteNextLine[panBandMap[i] - 1];
+        if( nNextLine < 0 )
+            continue;
+        if( nYOff > nNextLine )
+        {
+            // Lines have been skipped: we cannot know when block rows
+            // will be complete.
+            CPLDebug("GTiff", "GTIFF_STREAMING_WRITE: non sequential write. "
+                     "Flushing of completed block rows disabled for band %d",
+                     panBandMap[i]);
+            nNextLine = -1;
+            continue;
+        }
+        nNextLine = std::max(nNextLine, nYOff + nYSize);
+    }
+
+    const int nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, m_nBlockXSize);
+    const int nBlocksPerColumn = DIV_ROUND_UP(nRasterYSize, m_nBlockYSize);
+    const auto GetCompletedBlockRows = [this, nBlocksPerColumn](int nNextLine)
+    {
+        return nNextLine >= nRasterYSize ? nBlocksPerColumn :
+                                           nNextLine / m_nBlockYSize;
+    };
+
+    if( m_nPlanarConfig == PLANARCONFIG_CONTIG && nBands > 1 )
+    {
+        // The blocks of all bands are interleaved in the same strile, so
+        // a block row is complete once all bands have been written.
+        int nMinNextLine = nRasterYSize;
+        for( const int nNextLine: m_anStreamingWriteNextLine )
         {
-            if( pbErrOccurred )
-                *pbErrOccurred = true;
-            return false;
+            if( nNextLine < 0 )
+                return;
+            nMinNextLine = std::min(nMinNextLine, nNextLine);
         }
-        const int nBlockCount =
-            bIsTiled ? TIFFNumberOfTiles(m_hTIFF) : TIFFNumberOfStrips(m_hTIFF);
-        if( nBlockId >= nBlockCount )
+        const int nCompletedBlockRows = GetCompletedBlockRows(nMinNextLine);
+        int& nFlushedBlockRows = m_anStreamingWriteFlushedBlockRows[0];
+        for( ; nFlushedBlockRows < nCompletedBlockRows; ++nFlushedBlockRows )
         {
-            if( pbErrOccurred )
-                *pbErrOccurred = true;
-            return false;
+            for( int iXBlock = 0; iXBlock < nBlocksPerRow; ++iXBlock )
+            {
+                // Writing the block of the first band collects the dirty
+                // blocks of the other bands, which are then just discarded.
+                for( int iBand = 1; iBand <= nBands; ++iBand )
+                {
+                    GetRasterBand(iBand)->FlushBlock(iXBlock,
+                                                     nFlushedBlockRows);
+                }
+            }
         }
-
-        if( pnOffset )
-            *pnOffset = panOffsets[nBlockId];
-        if( pnSize )
-            *pnSize = panByteCounts[nBlockId];
-        return panByteCounts[nBlockId] != 0;
     }
     else
     {
-        if( pbErrOccurred )
-            *pbErrOccurred = true;
+        for( int i = 0; i < nBandCount; ++i )
+        {
+            const int iBand = panBandMap[i];
+            const int nNextLine = m_anStreamingWriteNextLine[iBand - 1];
+            if( nNextLine < 0 )
+                continue;
+            const int nCompletedBlockRows = GetCompletedBlockRows(nNextLine);
+            int& nFlushedBlockRows =
+                m_anStreamingWriteFlushedBlockRows[iBand - 1];
+            for( ; nFlushedBlockRows < nCompletedBlockRows;
+                 ++nFlushedBlockRows )
+            {
+                for( int iXBlock = 0; iXBlock < nBlocksPerRow; ++iXBlock )
+                {
+                    GetRasterBand(iBand)->FlushBlock(iXBlock,
+                                                     nFlushedBlockRows);
+                }
+            }
+        }
     }
 
-    return false;
+    if( m_bLoadedBlockDirty && m_nLoadedBlock != -1 )
+        FlushBlockBuf();
 }
 
 /************************************************************************/
@@ -12648,6 +13932,10 @@ GDALDataset *GTiffDataset::Open( GDALOpenInfo * poOpenInfo )
     {
         poDS->InitCreationOrOpenOptions(poOpenInfo->papszOpenOptions);
     }
+    else
+    {
+        poDS->InitReadThreads(poOpenInfo->papszOpenOptions);
+    }
 
     poDS->m_bLoadPam = true;
     poDS->m_bColorProfileMetadataChanged = false;
@@ -14129,6 +15417,8 @@ CPLErr GTiffDataset::OpenOffset( TIFF *hTIFFIn,
         else
             SetBand( iBand + 1, new GTiffRasterBand( this, iBand + 1 ) );
     }
+    m_bRegularBands = !bTreatAsRGBA && !m_bTreatAsSplitBitmap &&
+                      !m_bTreatAsSplit && !bTreatAsBitmap && !bTreatAsOdd;
 
     if( GetRasterBand(1)->GetRasterDataType() == GDT_Unknown )
     {
@@ -17119,6 +18409,464 @@ CPLErr GTiffDataset::CopyImageryAndMask(GTiffDataset* poDstDS,
     return eErr;
 }
 
+/************************************************************************/
+/*                     IsDirectTileCopyCompatible()                     */
+/************************************************************************/
+
+// Returns whether the tiles of poSrcGDS are laid out and encoded as the
+// tiles of poDstDS, apart from the raster height which is checked by the
+// caller.
+bool GTiffDataset::IsDirectTileCopyCompatible(GTiffDataset* poDstDS,
+                                              GTiffDataset* poSrcGDS,
+                                              CSLConstList papszOptions)
+{
+    if( poSrcGDS->GetAccess() != GA_ReadOnly ||
+        poSrcGDS->m_bStreamingIn ||
+        poSrcGDS->nRasterXSize != poDstDS->nRasterXSize ||
+        poSrcGDS->nBands != poDstDS->nBands ||
+        poSrcGDS->m_nBlockXSize != poDstDS->m_nBlockXSize ||
+        poSrcGDS->m_nBlockYSize != poDstDS->m_nBlockYSize ||
+        poSrcGDS->m_nPlanarConfig != poDstDS->m_nPlanarConfig ||
+        poSrcGDS->m_nSamplesPerPixel != poDstDS->m_nSamplesPerPixel ||
+        poSrcGDS->m_nBitsPerSample != poDstDS->m_nBitsPerSample ||
+        poSrcGDS->m_nSampleFormat != poDstDS->m_nSampleFormat ||
+        poSrcGDS->m_nPhotometric != poDstDS->m_nPhotometric ||
+        poSrcGDS->m_nCompression != poDstDS->m_nCompression )
+    {
+        return false;
+    }
+
+    if( poDstDS->m_nCompression == COMPRESSION_LERC &&
+        (memcmp(poSrcGDS->m_anLercAddCompressionAndVersion,
+                poDstDS->m_anLercAddCompressionAndVersion,
+                sizeof(poDstDS->m_anLercAddCompressionAndVersion)) != 0 ||
+         CSLFetchNameValue(papszOptions, "MAX_Z_ERROR") != nullptr) )
+    {
+        return false;
+    }
+
+    if( !poSrcGDS->SetDirectory() || !poDstDS->SetDirectory() ||
+        !TIFFIsTiled(poSrcGDS->m_hTIFF) || !TIFFIsTiled(poDstDS->m_hTIFF) )
+    {
+        return false;
+    }
+
+    uint16_t nSrcPredictor = PREDICTOR_NONE;
+    uint16_t nDstPredictor = PREDICTOR_NONE;
+    TIFFGetField( poSrcGDS->m_hTIFF, TIFFTAG_PREDICTOR, &nSrcPredictor );
+    TIFFGetField( poDstDS->m_hTIFF, TIFFTAG_PREDICTOR, &nDstPredictor );
+    return nSrcPredictor == nDstPredictor &&
+           TIFFIsByteSwapped(poSrcGDS->m_hTIFF) ==
+                TIFFIsByteSwapped(poDstDS->m_hTIFF);
+}
+
+/************************************************************************/
+/*                      GTiffGetVRTMosaicParts()                        */
+/************************************************************************/
+
+namespace {
+struct GTiffMosaicPart
+{
+    CPLString osFilename{};
+    int       nYOff = 0;
+    int       nYSize = 0;
+};
+} // namespace
+
+// Recognizes a VRT that is a plain vertical stack of full width parts, such
+// as the ones created by gdalbuildvrt on the outputs of
+// gdal_translate / gdalwarp -tile_index, and returns its parts ordered from
+// top to bottom. Each part must start on a block boundary of the target
+// dataset, and all parts but the last one must have a height multiple of
+// the block height, so that blocks map one to one.
+static bool GTiffGetVRTMosaicParts( GDALDataset* poSrcDS,
+                                    int nXSize, int nYSize, int nBands,
+                                    int nBlockYSize,
+                                    std::vector<GTiffMosaicPart>& aoParts )
+{
+    aoParts.clear();
+    if( poSrcDS->GetDriver() == nullptr ||
+        !EQUAL(poSrcDS->GetDriver()->GetDescription(), "VRT") ||
+        poSrcDS->GetRasterXSize() != nXSize ||
+        poSrcDS->GetRasterYSize() != nYSize ||
+        poSrcDS->GetRasterCount() != nBands )
+    {
+        return false;
+    }
+    char** papszXML = poSrcDS->GetMetadata("xml:VRT");
+    if( papszXML == nullptr || papszXML[0] == nullptr )
+        return false;
+    CPLXMLTreeCloser oTree(CPLParseXMLString(papszXML[0]));
+    const CPLXMLNode* psRoot =
+        oTree.get() ? CPLGetXMLNode(oTree.get(), "=VRTDataset") : nullptr;
+    if( psRoot == nullptr ||
+        CPLGetXMLValue(psRoot, "subClass", nullptr) != nullptr )
+    {
+        return false;
+    }
+
+    const char* pszDescription = poSrcDS->GetDescription();
+    const CPLString osVRTPath(
+        pszDescription[0] && !STARTS_WITH(pszDescription, "<VRTDataset") ?
+            CPLGetPath(pszDescription) : "");
+
+    int iBand = 0;
+    for( const CPLXMLNode* psBand = psRoot->psChild; psBand;
+         psBand = psBand->psNext )
+    {
+        if( psBand->eType != CXT_Element ||
+            !EQUAL(psBand->pszValue, "VRTRasterBand") )
+        {
+            continue;
+        }
+        ++iBand;
+        if( CPLGetXMLValue(psBand, "subClass", nullptr) != nullptr ||
+            atoi(CPLGetXMLValue(psBand, "band", "0")) != iBand )
+        {
+            return false;
+        }
+
+        std::vector<GTiffMosaicPart> aoBandParts;
+        for( const CPLXMLNode* psSrc = psBand->psChild; psSrc;
+             psSrc = psSrc->psNext )
+        {
+            if( psSrc->eType != CXT_Element )
+                continue;
+            const CPLString osName(psSrc->pszValue);
+            if( osName.size() < strlen("Source") ||
+                !EQUAL(osName.c_str() + osName.size() - strlen("Source"),
+                       "Source") )
+            {
+                continue;
+            }
+            if( !EQUAL(psSrc->pszValue, "SimpleSource") &&
+                !EQUAL(psSrc->pszValue, "ComplexSource") )
+            {
+                return false;
+            }
+            // Anything that could alter the values (scaling, LUT, color
+            // table expansion, resampling...) disables the direct copy.
+            // The nodata value of a ComplexSource does not matter since the
+            // parts do not overlap.
+            for( const CPLXMLNode* psIter = psSrc->psChild; psIter;
+                 psIter = psIter->psNext )
+            {
+                if( psIter->eType == CXT_Attribute &&
+                    EQUAL(psIter->pszValue, "resampling") )
+                {
+                    return false;
+                }
+                if( psIter->eType == CXT_Element &&
+                    !EQUAL(psIter->pszValue, "SourceFilename") &&
+                    !EQUAL(psIter->pszValue, "SourceBand") &&
+                    !EQUAL(psIter->pszValue, "SourceProperties") &&
+                    !EQUAL(psIter->pszValue, "SrcRect") &&
+                    !EQUAL(psIter->pszValue, "DstRect") &&
+                    !EQUAL(psIter->pszValue, "NODATA") )
+                {
+                    return false;
+                }
+            }
+
+            const CPLXMLNode* psFilename =
+                CPLGetXMLNode(psSrc, "SourceFilename");
+            const char* pszFilename =
+                psFilename ? CPLGetXMLValue(psFilename, nullptr, "") : "";
+            const CPLXMLNode* psSrcRect = CPLGetXMLNode(psSrc, "SrcRect");
+            const CPLXMLNode* psDstRect = CPLGetXMLNode(psSrc, "DstRect");
+            if( pszFilename[0] == '\0' || psSrcRect == nullptr ||
+                psDstRect == nullptr ||
+                atoi(CPLGetXMLValue(psSrc, "SourceBand", "0")) != iBand )
+            {
+                return false;
+            }
+
+            const auto GetInt = [](const CPLXMLNode* psRect,
+                                   const char* pszKey, int& nVal)
+            {
+                const double dfVal =
+                    CPLAtof(CPLGetXMLValue(psRect, pszKey, "-1"));
+                if( !(dfVal >= 0 && dfVal <= INT_MAX) ||
+                    dfVal != static_cast<int>(dfVal) )
+                {
+                    return false;
+                }
+                nVal = static_cast<int>(dfVal);
+                return true;
+            };
+            int nSrcXOff = 0, nSrcYOff = 0, nSrcXSize = 0, nSrcYSize = 0;
+            int nDstXOff = 0, nDstYOff = 0, nDstXSize = 0, nDstYSize = 0;
+            if( !GetInt(psSrcRect, "xOff", nSrcXOff) ||
+                !GetInt(psSrcRect, "yOff", nSrcYOff) ||
+                !GetInt(psSrcRect, "xSize", nSrcXSize) ||
+                !GetInt(psSrcRect, "ySize", nSrcYSize) ||
+                !GetInt(psDstRect, "xOff", nDstXOff) ||
+                !GetInt(psDstRect, "yOff", nDstYOff) ||
+                !GetInt(psDstRect, "xSize", nDstXSize) ||
+                !GetInt(psDstRect, "ySize", nDstYSize) ||
+                nSrcXOff != 0 || nSrcYOff != 0 || nDstXOff != 0 ||
+                nSrcXSize != nXSize || nDstXSize != nXSize ||
+                nSrcYSize != nDstYSize || nDstYSize == 0 )
+            {
+                return false;
+            }
+
+            GTiffMosaicPart oPart;
+            oPart.osFilename = pszFilename;
+            if( atoi(CPLGetXMLValue(psFilename, "relativeToVRT", "0")) &&
+                !osVRTPath.empty() )
+            {
+                oPart.osFilename =
+                    CPLProjectRelativeFilename(osVRTPath, pszFilename);
+            }
+            oPart.nYOff = nDstYOff;
+            oPart.nYSize = nDstYSize;
+            aoBandParts.push_back(oPart);
+        }
+
+        std::sort(aoBandParts.begin(), aoBandParts.end(),
+                  [](const GTiffMosaicPart& a, const GTiffMosaicPart& b)
+                  { return a.nYOff < b.nYOff; });
+        if( iBand == 1 )
+        {
+            int nExpectedYOff = 0;
+            for( const auto& oPart : aoBandParts )
+            {
+                if( oPart.nYOff != nExpectedYOff ||
+                    (oPart.nYOff % nBlockYSize) != 0 ||
+                    oPart.nYSize > nYSize - oPart.nYOff )
+                {
+                    return false;
+                }
+                nExpectedYOff = oPart.nYOff + oPart.nYSize;
+            }
+            if( nExpectedYOff != nYSize )
+                return false;
+            aoParts = std::move(aoBandParts);
+        }
+        else
+        {
+            if( aoBandParts.size() != aoParts.size() )
+                return false;
+            for( size_t i = 0; i < aoParts.size(); ++i )
+            {
+                if( aoBandParts[i].osFilename != aoParts[i].osFilename ||
+                    aoBandParts[i].nYOff != aoParts[i].nYOff ||
+                    aoBandParts[i].nYSize != aoParts[i].nYSize )
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return iBand == nBands && !aoParts.empty();
+}
+
+/************************************************************************/
+/*                          DirectCopyTiles()                           */
+/************************************************************************/
+
+// Copies the compressed tiles of a GTiff source dataset without decoding
+// and re-encoding them, when they are laid out and encoded as the tiles of
+// the target dataset. The source may also be a VRT stacking vertically
+// GTiff parts of the target (see GTiffGetVRTMosaicParts()), as produced by
+// the -tile_index option of gdal_translate and gdalwarp. bDone is set to
+// false (and nothing is written) when this is not possible, in which case
+// a regular copy must be done.
+CPLErr GTiffDataset::DirectCopyTiles(GTiffDataset* poDstDS,
+                                     GDALDataset* poSrcDS,
+                                     CSLConstList papszOptions,
+                                     GDALProgressFunc pfnProgress,
+                                     void * pProgressData,
+                                     bool& bDone)
+{
+    bDone = false;
+    if( !CPLTestBool(CPLGetConfigOption("GTIFF_DIRECT_TILE_COPY", "YES")) )
+        return CE_None;
+
+    // Only codecs whose strile content only depends on the pixel layout
+    // and on the tags checked here. JPEG has its own code path.
+    const auto nCompression = poDstDS->m_nCompression;
+    if( nCompression != COMPRESSION_ADOBE_DEFLATE &&
+        nCompression != COMPRESSION_LZW &&
+        nCompression != COMPRESSION_ZSTD &&
+        nCompression != COMPRESSION_LZMA &&
+        nCompression != COMPRESSION_LERC &&
+        nCompression != COMPRESSION_WEBP )
+    {
+        return CE_None;
+    }
+    // Do not ignore an explicitly requested quality for lossy codecs.
+    if( nCompression == COMPRESSION_WEBP &&
+        (CSLFetchNameValue(papszOptions, "WEBP_LEVEL") != nullptr ||
+         CSLFetchNameValue(papszOptions, "WEBP_LOSSLESS") != nullptr) )
+    {
+        return CE_None;
+    }
+
+    // The mask is interleaved with the imagery in the COG layout.
+    if( poDstDS->m_poMaskDS && poDstDS->m_bBlockOrderRowMajor )
+        return CE_None;
+
+    // Source datasets and the index of the first block row of the target
+    // they cover.
+    std::vector<std::unique_ptr<GDALDataset>> apoOwnedParts;
+    std::vector<std::pair<GTiffDataset*, int>> aoParts;
+    GTiffDataset* poSrcGDS = dynamic_cast<GTiffDataset*>(poSrcDS);
+    if( poSrcGDS != nullptr )
+    {
+        if( poSrcGDS->nRasterYSize != poDstDS->nRasterYSize )
+            return CE_None;
+        aoParts.emplace_back(poSrcGDS, 0);
+    }
+    else
+    {
+        std::vector<GTiffMosaicPart> aoMosaicParts;
+        if( !GTiffGetVRTMosaicParts(poSrcDS, poDstDS->nRasterXSize,
+                                    poDstDS->nRasterYSize, poDstDS->nBands,
+                                    poDstDS->m_nBlockYSize, aoMosaicParts) )
+        {
+            return CE_None;
+        }
+        const char* const apszAllowedDrivers[] = { "GTiff", nullptr };
+        for( const auto& oMosaicPart : aoMosaicParts )
+        {
+            std::unique_ptr<GDALDataset> poPartDS(GDALDataset::FromHandle(
+                GDALOpenEx(oMosaicPart.osFilename,
+                           GDAL_OF_RASTER | GDAL_OF_READONLY |
+                           GDAL_OF_INTERNAL,
+                           apszAllowedDrivers, nullptr, nullptr)));
+            GTiffDataset* poPartGDS =
+                dynamic_cast<GTiffDataset*>(poPartDS.get());
+            if( poPartGDS == nullptr ||
+                poPartGDS->nRasterYSize != oMosaicPart.nYSize )
+            {
+                return CE_None;
+            }
+            aoParts.emplace_back(poPartGDS,
+                                 oMosaicPart.nYOff / poDstDS->m_nBlockYSize);
+            apoOwnedParts.emplace_back(std::move(poPartDS));
+        }
+    }
+
+    for( const auto& oPart : aoParts )
+    {
+        if( !IsDirectTileCopyCompatible(poDstDS, oPart.first, papszOptions) )
+            return CE_None;
+    }
+
+    if( aoParts.size() == 1 )
+    {
+        CPLDebug("GTiff",
+                 "Copying compressed tiles of %s without recompression",
+                 aoParts[0].first->GetDescription());
+    }
+    else
+    {
+        CPLDebug("GTiff",
+                 "Copying compressed tiles of the %d parts of %s without "
+                 "recompression",
+                 static_cast<int>(aoParts.size()), poSrcDS->GetDescription());
+    }
+    bDone = true;
+
+    const int nBlocksPerRow =
+        DIV_ROUND_UP(poDstDS->nRasterXSize, poDstDS->m_nBlockXSize);
+    const int nBlocks = poDstDS->m_nBlocksPerBand *
+        (poDstDS->m_nPlanarConfig == PLANARCONFIG_SEPARATE ?
+            poDstDS->nBands : 1);
+    std::vector<GByte> abyBuffer;
+    CPLErr eErr = CE_None;
+    size_t iPart = 0;
+    for( int iBlock = 0; iBlock < nBlocks && eErr == CE_None; ++iBlock )
+    {
+        // Locate the part holding the block, and its index in that part.
+        const int iBandBlock = iBlock / poDstDS->m_nBlocksPerBand;
+        const int iBlockInBand = iBlock % poDstDS->m_nBlocksPerBand;
+        const int iBlockRow = iBlockInBand / nBlocksPerRow;
+        if( iBlockInBand == 0 )
+            iPart = 0;
+        while( iPart + 1 < aoParts.size() &&
+               iBlockRow >= aoParts[iPart + 1].second )
+        {
+            ++iPart;
+        }
+        GTiffDataset* poPartGDS = aoParts[iPart].first;
+        const int iSrcBlock =
+            iBandBlock * poPartGDS->m_nBlocksPerBand +
+            iBlockInBand - aoParts[iPart].second * nBlocksPerRow;
+
+        int nErrOccurred = 0;
+        const vsi_l_offset nOffset =
+            poPartGDS->GetStrileOffset(iSrcBlock, &nErrOccurred);
+        const vsi_l_offset nSize = nErrOccurred ? 0 :
+            poPartGDS->GetStrileByteCount(iSrcBlock, &nErrOccurred);
+        if( nErrOccurred )
+        {
+            eErr = CE_Failure;
+            break;
+        }
+
+        // Missing blocks are left missing, as with SKIP_HOLES=YES.
+        if( nOffset != 0 && nSize != 0 )
+        {
+            if( nSize > static_cast<vsi_l_offset>(
+                            std::numeric_limits<GPtrDiff_t>::max() / 2) )
+            {
+                ReportError(poDstDS->GetDescription(), CE_Failure,
+                            CPLE_AppDefined,
+                            "Invalid byte count for block %d of %s",
+                            iSrcBlock, poPartGDS->GetDescription());
+                eErr = CE_Failure;
+                break;
+            }
+            try
+            {
+                abyBuffer.resize(static_cast<size_t>(nSize));
+            }
+            catch( const std::exception& )
+            {
+                ReportError(poDstDS->GetDescription(), CE_Failure,
+                            CPLE_OutOfMemory,
+                            "Cannot allocate " CPL_FRMT_GUIB " bytes",
+                            static_cast<GUIntBig>(nSize));
+                eErr = CE_Failure;
+                break;
+            }
+            VSILFILE* fpSrc =
+                VSI_TIFFGetVSILFile(TIFFClientdata(poPartGDS->m_hTIFF));
+            if( VSIFSeekL(fpSrc, nOffset, SEEK_SET) != 0 ||
+                VSIFReadL(abyBuffer.data(), 1, abyBuffer.size(), fpSrc) !=
+                    abyBuffer.size() )
+            {
+                ReportError(poDstDS->GetDescription(), CE_Failure,
+                            CPLE_FileIO,
+                            "Cannot read block %d of %s", iSrcBlock,
+                            poPartGDS->GetDescription());
+                eErr = CE_Failure;
+                break;
+            }
+            poDstDS->WriteRawStripOrTile(iBlock, abyBuffer.data(),
+                                         static_cast<GPtrDiff_t>(nSize));
+            if( poDstDS->m_bWriteError )
+            {
+                eErr = CE_Failure;
+                break;
+            }
+        }
+
+        if( !pfnProgress( static_cast<double>(iBlock + 1) / nBlocks,
+                          nullptr, pProgressData ) )
+        {
+            ReportError(poDstDS->GetDescription(), CE_Failure,
+                        CPLE_UserInterrupt, "User terminated");
+            eErr = CE_Failure;
+        }
+    }
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                             CreateCopy()                             */
 /************************************************************************/
@@ -18388,7 +20136,27 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
                         poSrcOvrBand->GetMaskBand();
                 }
 
-                if( l_nBands == 1 || poDstDS->m_nPlanarConfig == PLANARCONFIG_CONTIG)
+                bool bDirectCopyDone = false;
+                if( poDstDS->m_poMaskDS == nullptr )
+                {
+                    void* pScaledData =
+                        GDALCreateScaledProgress( dfCurPixels / dfTotalPixels,
+                                                  dfNextCurPixels / dfTotalPixels,
+                                                  pfnProgress, pProgressData );
+                    eErr = DirectCopyTiles(poDstDS, poSrcOvrBand->GetDataset(),
+                                           papszOptions,
+                                           GDALScaledProgress, pScaledData,
+                                           bDirectCopyDone);
+                    GDALDestroyScaledProgress(pScaledData);
+                    if( bDirectCopyDone )
+                        dfCurPixels = dfNextCurPixels;
+                }
+
+                if( bDirectCopyDone )
+                {
+                    poDstDS->FlushCache();
+                }
+                else if( l_nBands == 1 || poDstDS->m_nPlanarConfig == PLANARCONFIG_CONTIG)
                 {
                     if( poDstDS->m_poMaskDS )
                     {
@@ -18637,30 +20405,44 @@ GTiffDataset::CreateCopy( const char * pszFilename, GDALDataset *poSrcDS,
                 poDS->m_poMaskDS->m_bTrailerRepeatedLast4BytesRepeated = true;
             }
 
-            if( poDS->m_poMaskDS )
+            bool bDirectCopyDone = false;
+            eErr = DirectCopyTiles(poDS, poSrcDS, papszOptions,
+                                   GDALScaledProgress, pScaledData,
+                                   bDirectCopyDone);
+            if( !bDirectCopyDone )
             {
-                GDALDestroyScaledProgress(pScaledData);
-                pScaledData = GDALCreateScaledProgress(
-                                dfCurPixels / dfTotalPixels,
-                                1.0,
-                                pfnProgress, pProgressData);
-            }
+                if( poDS->m_poMaskDS )
+                {
+                    GDALDestroyScaledProgress(pScaledData);
+                    pScaledData = GDALCreateScaledProgress(
+                                    dfCurPixels / dfTotalPixels,
+                                    1.0,
+                                    pfnProgress, pProgressData);
+                }
 
-            eErr = CopyImageryAndMask(poDS, poSrcDS,
-                              poSrcDS->GetRasterBand(1)->GetMaskBand(),
-                              GDALScaledProgress, pScaledData);
-            if( poDS->m_poMaskDS )
-            {
-                bWriteMask = false;
+                eErr = CopyImageryAndMask(poDS, poSrcDS,
+                                  poSrcDS->GetRasterBand(1)->GetMaskBand(),
+                                  GDALScaledProgress, pScaledData);
+                if( poDS->m_poMaskDS )
+                {
+                    bWriteMask = false;
+                }
             }
         }
         else
         {
-            eErr = GDALDatasetCopyWholeRaster(
-                /* (GDALDatasetH) */ poSrcDS,
-                /* (GDALDatasetH) */ poDS,
-                papszCopyWholeRasterOptions,
-                GDALScaledProgress, pScaledData );
+            bool bDirectCopyDone = false;
+            eErr = DirectCopyTiles(poDS, poSrcDS, papszOptions,
+                                   GDALScaledProgress, pScaledData,
+                                   bDirectCopyDone);
+            if( !bDirectCopyDone )
+            {
+                eErr = GDALDatasetCopyWholeRaster(
+                    /* (GDALDatasetH) */ poSrcDS,
+                    /* (GDALDatasetH) */ poDS,
+                    papszCopyWholeRasterOptions,
+                    GDALScaledProgress, pScaledData );
+            }
         }
     }
 
@@ -19389,6 +21171,43 @@ void GTiffDataset::LoadMetadata()
     }
 }
 
+/************************************************************************/
+/*                        GetDriverMemoryUsage()                        */
+/************************************************************************/
+
+GIntBig GTiffDataset::GetDriverMemoryUsage()
+{
+    // Working buffers are sized after a block (or a scanline for
+    // single-strip files read line by line, in which case this is an upper
+    // bound).
+    const GIntBig nBlockBytes =
+        static_cast<GIntBig>(m_nBlockXSize) * m_nBlockYSize *
+        ((m_nBitsPerSample + 7) / 8) *
+        (m_nPlanarConfig == PLANARCONFIG_CONTIG ? nBands : 1);
+    GIntBig nTotal = 0;
+    if( m_pabyBlockBuf )
+        nTotal += nBlockBytes;
+    if( m_pabyTempWriteBuffer )
+        nTotal += nBlockBytes;
+    if( m_pTempBufferForCommonDirectIO )
+        nTotal += nBlockBytes;
+
+    // Strip/tile offset and bytecount arrays loaded by libtiff.
+    if( m_hTIFF )
+        nTotal += static_cast<GIntBig>(TIFFNumberOfStrips(m_hTIFF)) *
+                  2 * sizeof(uint64_t);
+
+    for( int i = 0; i < m_nOverviewCount; ++i )
+        nTotal += m_papoOverviewDS[i]->GetMemoryUsage();
+    for( int i = 0; i < m_nJPEGOverviewCount; ++i )
+        nTotal += m_papoJPEGOverviewDS[i]->GetMemoryUsage();
+    // m_poMaskDS is owned by this dataset (see Finalize())
+    if( m_poMaskDS )
+        nTotal += m_poMaskDS->GetMemoryUsage();
+
+    return nTotal;
+}
+
 /************************************************************************/
 /*                            GetFileList()                             */
 /************************************************************************/
@@ -20208,7 +22027,7 @@ void GDALRegister_GTiff()
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST, osOptions );
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
 "<OpenOptionList>"
-"   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression. Can be set to ALL_CPUS' default='1'/>"
+"   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression or decompression. Can be set to ALL_CPUS' default='1'/>"
 "   <Option name='GEOTIFF_KEYS_FLAVOR' type='string-select' default='STANDARD' description='Which flavor of GeoTIFF keys must be used (for writing)'>"
 "       <Value>STANDARD</Value>"
 "       <Value>ESRI_PE</Value>"
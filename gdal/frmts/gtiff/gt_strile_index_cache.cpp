@@ -0,0 +1,278 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GeoTIFF Driver
+ * Purpose:  Cache of TileOffsets/TileByteCounts arrays shared by datasets
+ *           and processes opening the same file.
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gt_strile_index_cache.h"
+
+#include <cstring>
+#include <mutex>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_md5.h"
+#include "cpl_mem_cache.h"
+#include "cpl_multiproc.h"
+#include "cpl_string.h"
+
+CPL_CVSID("$Id$")
+
+/* -------------------------------------------------------------------- */
+/*      Reading the TileOffsets/TileByteCounts arrays of a large remote */
+/*      file costs one request for each new area accessed. When         */
+/*      GTIFF_STRILE_INDEX_CACHE=YES, the arrays are entirely read once */
+/*      and kept in memory for the next datasets opened on the same     */
+/*      file in the process. When GTIFF_STRILE_INDEX_CACHE_DIR is set   */
+/*      to a directory, they are also saved there, for other processes. */
+/* -------------------------------------------------------------------- */
+
+constexpr char STRILE_INDEX_MAGIC[] = "GDAL_GTIFF_STRILE_INDEX_1";
+constexpr size_t STRILE_INDEX_CACHE_SIZE = 16;
+// Do not cache indices of more than 128 MB.
+constexpr size_t STRILE_INDEX_MAX_STRILES = 8 * 1024 * 1024;
+
+typedef lru11::Cache<std::string, std::shared_ptr<const GTiffStrileIndex>>
+    GTiffStrileIndexLRU;
+
+static std::mutex goStrileIndexMutex;
+static GTiffStrileIndexLRU goStrileIndexCache(STRILE_INDEX_CACHE_SIZE);
+
+/************************************************************************/
+/*                          GetCacheDirectory()                         */
+/************************************************************************/
+
+static const char* GetCacheDirectory()
+{
+    return CPLGetConfigOption("GTIFF_STRILE_INDEX_CACHE_DIR", nullptr);
+}
+
+/************************************************************************/
+/*                         GetCacheFilename()                           */
+/************************************************************************/
+
+static std::string GetCacheFilename( const char* pszDir,
+                                     const std::string& osKey )
+{
+    return CPLFormFilename(pszDir, CPLMD5String(osKey.c_str()), "gsi");
+}
+
+/************************************************************************/
+/*                    GTIFFGetStrileIndexCacheKey()                     */
+/************************************************************************/
+
+// Returns an empty string if the cache is disabled.
+std::string GTIFFGetStrileIndexCacheKey( const char* pszFilename,
+                                         vsi_l_offset nDirOffset )
+{
+    if( GetCacheDirectory() == nullptr &&
+        !CPLTestBool(CPLGetConfigOption("GTIFF_STRILE_INDEX_CACHE", "NO")) )
+    {
+        return std::string();
+    }
+
+    // The size and modification time identify the version of the file.
+    // For network files, they come from the headers of the response that
+    // is received before opening, so there is no need for an additional
+    // request as with the ETag.
+    VSIStatBufL sStat;
+    if( VSIStatL(pszFilename, &sStat) != 0 )
+        return std::string();
+
+    std::string osKey(pszFilename);
+    osKey += CPLSPrintf("|" CPL_FRMT_GUIB "|" CPL_FRMT_GIB "|" CPL_FRMT_GUIB,
+                        static_cast<GUIntBig>(sStat.st_size),
+                        static_cast<GIntBig>(sStat.st_mtime),
+                        static_cast<GUIntBig>(nDirOffset));
+    return osKey;
+}
+
+/************************************************************************/
+/*                             ReadArray()                              */
+/************************************************************************/
+
+static bool ReadArray( VSILFILE* fp, std::vector<GUInt64>& anValues,
+                       size_t nCount )
+{
+    try
+    {
+        anValues.resize(nCount);
+    }
+    catch( const std::exception& )
+    {
+        return false;
+    }
+    if( VSIFReadL(anValues.data(), sizeof(GUInt64), nCount, fp) != nCount )
+        return false;
+#ifdef CPL_MSB
+    for( auto& nVal: anValues )
+        CPL_LSBPTR64(&nVal);
+#endif
+    return true;
+}
+
+/************************************************************************/
+/*                             WriteArray()                             */
+/************************************************************************/
+
+static bool WriteArray( VSILFILE* fp, const std::vector<GUInt64>& anValues )
+{
+#ifdef CPL_MSB
+    for( GUInt64 nVal: anValues )
+    {
+        CPL_LSBPTR64(&nVal);
+        if( VSIFWriteL(&nVal, sizeof(nVal), 1, fp) != 1 )
+            return false;
+    }
+    return true;
+#else
+    return VSIFWriteL(anValues.data(), sizeof(GUInt64), anValues.size(),
+                      fp) == anValues.size();
+#endif
+}
+
+/************************************************************************/
+/*                     GTIFFGetCachedStrileIndex()                      */
+/************************************************************************/
+
+std::shared_ptr<const GTiffStrileIndex> GTIFFGetCachedStrileIndex(
+                                            const std::string& osKey,
+                                            size_t nStrileCount )
+{
+    std::shared_ptr<const GTiffStrileIndex> poIndex;
+    {
+        std::lock_guard<std::mutex> oLock(goStrileIndexMutex);
+        if( goStrileIndexCache.tryGet(osKey, poIndex) )
+        {
+            if( poIndex->anOffsets.size() == nStrileCount )
+                return poIndex;
+            poIndex.reset();
+        }
+    }
+
+    const char* pszDir = GetCacheDirectory();
+    if( pszDir == nullptr || nStrileCount > STRILE_INDEX_MAX_STRILES )
+        return poIndex;
+
+    const std::string osFilename(GetCacheFilename(pszDir, osKey));
+    VSILFILE* fp = VSIFOpenL(osFilename.c_str(), "rb");
+    if( fp == nullptr )
+        return poIndex;
+
+    // The key is stored to detect (unlikely) MD5 collisions.
+    bool bOK = false;
+    char szMagic[sizeof(STRILE_INDEX_MAGIC)] = {};
+    GUInt64 nKeySize = 0;
+    GUInt64 nCount = 0;
+    if( VSIFReadL(szMagic, sizeof(szMagic), 1, fp) == 1 &&
+        memcmp(szMagic, STRILE_INDEX_MAGIC, sizeof(szMagic)) == 0 &&
+        VSIFReadL(&nKeySize, sizeof(nKeySize), 1, fp) == 1 )
+    {
+        CPL_LSBPTR64(&nKeySize);
+        if( nKeySize == osKey.size() )
+        {
+            std::string osStoredKey;
+            osStoredKey.resize(static_cast<size_t>(nKeySize));
+            if( VSIFReadL(&osStoredKey[0], 1, osStoredKey.size(), fp) ==
+                    osStoredKey.size() &&
+                osStoredKey == osKey &&
+                VSIFReadL(&nCount, sizeof(nCount), 1, fp) == 1 )
+            {
+                CPL_LSBPTR64(&nCount);
+                if( nCount == nStrileCount )
+                {
+                    auto poNewIndex = std::make_shared<GTiffStrileIndex>();
+                    bOK = ReadArray(fp, poNewIndex->anOffsets, nStrileCount) &&
+                          ReadArray(fp, poNewIndex->anByteCounts,
+                                    nStrileCount);
+                    if( bOK )
+                        poIndex = poNewIndex;
+                }
+            }
+        }
+    }
+    VSIFCloseL(fp);
+
+    if( !bOK )
+    {
+        CPLDebug("GTiff", "Ignoring invalid strile index cache file %s",
+                 osFilename.c_str());
+        return poIndex;
+    }
+
+    std::lock_guard<std::mutex> oLock(goStrileIndexMutex);
+    goStrileIndexCache.insert(osKey, poIndex);
+    return poIndex;
+}
+
+/************************************************************************/
+/*                     GTIFFPutCachedStrileIndex()                      */
+/************************************************************************/
+
+void GTIFFPutCachedStrileIndex(
+                        const std::string& osKey,
+                        const std::shared_ptr<const GTiffStrileIndex>& poIndex )
+{
+    {
+        std::lock_guard<std::mutex> oLock(goStrileIndexMutex);
+        goStrileIndexCache.insert(osKey, poIndex);
+    }
+
+    const char* pszDir = GetCacheDirectory();
+    if( pszDir == nullptr ||
+        poIndex->anOffsets.size() > STRILE_INDEX_MAX_STRILES )
+        return;
+
+    // Write to a temporary file and rename it, so that concurrent
+    // processes never see a partially written file.
+    const std::string osFilename(GetCacheFilename(pszDir, osKey));
+    const std::string osTmpFilename(
+        osFilename + CPLSPrintf(".%d.tmp", CPLGetCurrentProcessID()));
+    VSILFILE* fp = VSIFOpenL(osTmpFilename.c_str(), "wb");
+    if( fp == nullptr )
+    {
+        CPLDebug("GTiff", "Cannot create %s", osTmpFilename.c_str());
+        return;
+    }
+    GUInt64 nKeySize = osKey.size();
+    CPL_LSBPTR64(&nKeySize);
+    GUInt64 nCount = poIndex->anOffsets.size();
+    CPL_LSBPTR64(&nCount);
+    bool bOK =
+        VSIFWriteL(STRILE_INDEX_MAGIC, sizeof(STRILE_INDEX_MAGIC), 1, fp) == 1 &&
+        VSIFWriteL(&nKeySize, sizeof(nKeySize), 1, fp) == 1 &&
+        VSIFWriteL(osKey.data(), 1, osKey.size(), fp) == osKey.size() &&
+        VSIFWriteL(&nCount, sizeof(nCount), 1, fp) == 1 &&
+        WriteArray(fp, poIndex->anOffsets) &&
+        WriteArray(fp, poIndex->anByteCounts);
+    if( VSIFCloseL(fp) != 0 )
+        bOK = false;
+    if( !bOK || VSIRename(osTmpFilename.c_str(), osFilename.c_str()) != 0 )
+    {
+        CPLDebug("GTiff", "Cannot write %s", osFilename.c_str());
+        VSIUnlink(osTmpFilename.c_str());
+    }
+}
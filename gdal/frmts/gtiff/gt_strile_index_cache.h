@@ -0,0 +1,62 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GeoTIFF Driver
+ * Purpose:  Cache of TileOffsets/TileByteCounts arrays shared by datasets
+ *           and processes opening the same file.
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef GT_STRILE_INDEX_CACHE_H_INCLUDED
+#define GT_STRILE_INDEX_CACHE_H_INCLUDED
+
+#include "cpl_port.h"
+#include "cpl_vsi.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/************************************************************************/
+/*                          GTiffStrileIndex                            */
+/************************************************************************/
+
+// Offsets and byte counts of all the strips or tiles of a TIFF directory.
+struct GTiffStrileIndex
+{
+    std::vector<GUInt64> anOffsets{};
+    std::vector<GUInt64> anByteCounts{};
+};
+
+std::string GTIFFGetStrileIndexCacheKey( const char* pszFilename,
+                                         vsi_l_offset nDirOffset );
+
+std::shared_ptr<const GTiffStrileIndex> GTIFFGetCachedStrileIndex(
+                                         const std::string& osKey,
+                                         size_t nStrileCount );
+
+void GTIFFPutCachedStrileIndex(
+                        const std::string& osKey,
+                        const std::shared_ptr<const GTiffStrileIndex>& poIndex );
+
+#endif // GT_STRILE_INDEX_CACHE_H_INCLUDED
@@ -33,14 +33,27 @@
 #include "gdal_frmts.h"
 #include "gdal_pam.h"
 #include "gdal_priv.h"
+#include "gdal_thread_pool.h"
 #include "gh5_convenience.h"
 #include "hdf5dataset.h"
 #include "ogr_spatialref.h"
 
 #include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+// H5Dread_chunk() appeared in 1.10.3
+#if defined(H5_VERSION_GE)
+#if H5_VERSION_GE(1,10,3)
+#define HDF5_HAS_DIRECT_CHUNK_READ
+#endif
+#endif
 
 CPL_CVSID("$Id$")
 
+class HDF5ImageRasterBand;
+
 class HDF5ImageDataset final: public HDF5Dataset
 {
     typedef enum { UNKNOWN_PRODUCT = 0, CSK_PRODUCT } Hdf5ProductType;
@@ -57,6 +70,8 @@ class HDF5ImageDataset final: public HDF5Dataset
 
     friend class HDF5ImageRasterBand;
 
+    struct ChunkDecodeJob;
+
     char        *pszProjection;
     char        *pszGCPProjection;
     GDAL_GCP    *pasGCPList;
@@ -78,8 +93,24 @@ class HDF5ImageDataset final: public HDF5Dataset
     double       adfGeoTransform[6];
     bool         bHasGeoTransform;
 
+    // Direct chunk reads, enabled by InitDirectChunkRead()
+    int          nDecodeThreads;
+    std::vector<hsize_t> anChunkDims{};
+    std::vector<H5Z_filter_t> anFilters{};  // In pipeline order
+
     CPLErr CreateODIMH5Projection();
 
+    void InitDirectChunkRead();
+    void PrefetchBlocks( const std::vector<HDF5ImageRasterBand *> &apoBands,
+                         int nXOff, int nYOff, int nXSize, int nYSize );
+    static void DecodeChunkFunc( void *pData );
+
+  protected:
+    virtual CPLErr IRasterIO( GDALRWFlag, int, int, int, int,
+                              void *, int, int, GDALDataType,
+                              int, int *, GSpacing, GSpacing, GSpacing,
+                              GDALRasterIOExtraArg* ) override;
+
 public:
     HDF5ImageDataset();
     virtual ~HDF5ImageDataset();
@@ -171,7 +202,8 @@ HDF5ImageDataset::HDF5ImageDataset() :
     native(-1),
     iSubdatasetType(UNKNOWN_PRODUCT),
     iCSKProductType(PROD_UNKNOWN),
-    bHasGeoTransform(false)
+    bHasGeoTransform(false),
+    nDecodeThreads(1)
 {
     adfGeoTransform[0] = 0.0;
     adfGeoTransform[1] = 1.0;
@@ -233,6 +265,12 @@ class HDF5ImageRasterBand final: public GDALPamRasterBand
     virtual CPLErr      IReadBlock( int, int, void * ) override;
     virtual double      GetNoDataValue( int * ) override;
     // virtual CPLErr IWriteBlock( int, int, void * );
+
+  protected:
+    virtual CPLErr IRasterIO( GDALRWFlag, int, int, int, int,
+                              void *, int, int, GDALDataType,
+                              GSpacing, GSpacing,
+                              GDALRasterIOExtraArg* ) override;
 };
 
 /************************************************************************/
@@ -411,6 +449,368 @@ CPLErr HDF5ImageRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
     return CE_None;
 }
 
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr HDF5ImageRasterBand::IRasterIO( GDALRWFlag eRWFlag,
+                                       int nXOff, int nYOff,
+                                       int nXSize, int nYSize,
+                                       void *pData,
+                                       int nBufXSize, int nBufYSize,
+                                       GDALDataType eBufType,
+                                       GSpacing nPixelSpace,
+                                       GSpacing nLineSpace,
+                                       GDALRasterIOExtraArg* psExtraArg )
+{
+    HDF5ImageDataset *poGDS = static_cast<HDF5ImageDataset *>(poDS);
+    if( eRWFlag == GF_Read && poGDS->nDecodeThreads > 1 &&
+        nXSize == nBufXSize && nYSize == nBufYSize )
+    {
+        poGDS->PrefetchBlocks(std::vector<HDF5ImageRasterBand *>(1, this),
+                              nXOff, nYOff, nXSize, nYSize);
+    }
+    return GDALPamRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                        pData, nBufXSize, nBufYSize, eBufType,
+                                        nPixelSpace, nLineSpace, psExtraArg);
+}
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr HDF5ImageDataset::IRasterIO( GDALRWFlag eRWFlag,
+                                    int nXOff, int nYOff,
+                                    int nXSize, int nYSize,
+                                    void *pData,
+                                    int nBufXSize, int nBufYSize,
+                                    GDALDataType eBufType,
+                                    int nBandCount, int *panBandMap,
+                                    GSpacing nPixelSpace, GSpacing nLineSpace,
+                                    GSpacing nBandSpace,
+                                    GDALRasterIOExtraArg* psExtraArg )
+{
+    if( eRWFlag == GF_Read && nDecodeThreads > 1 &&
+        nXSize == nBufXSize && nYSize == nBufYSize )
+    {
+        std::vector<HDF5ImageRasterBand *> apoBands;
+        for( int i = 0; i < nBandCount; i++ )
+        {
+            apoBands.push_back(static_cast<HDF5ImageRasterBand *>(
+                GetRasterBand(panBandMap[i])));
+        }
+        PrefetchBlocks(apoBands, nXOff, nYOff, nXSize, nYSize);
+    }
+    return GDALPamDataset::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                     pData, nBufXSize, nBufYSize, eBufType,
+                                     nBandCount, panBandMap,
+                                     nPixelSpace, nLineSpace, nBandSpace,
+                                     psExtraArg);
+}
+
+/************************************************************************/
+/*                        InitDirectChunkRead()                         */
+/*                                                                      */
+/*      With GDAL_NUM_THREADS > 1, chunks of chunked datasets whose     */
+/*      filters are only deflate and shuffle are read raw with          */
+/*      H5Dread_chunk() and decoded by worker threads. Other filters    */
+/*      (szip, fletcher32, third party ones) are left to H5Dread().     */
+/************************************************************************/
+
+void HDF5ImageDataset::InitDirectChunkRead()
+{
+#ifdef HDF5_HAS_DIRECT_CHUNK_READ
+    const char *pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    const int nThreads = std::min(128,
+        EQUAL(pszThreads, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszThreads));
+    if( nThreads <= 1 || eAccess != GA_ReadOnly || IsComplexCSKL1A() ||
+        ndims < 1 || ndims > 3 )
+        return;
+
+    // Raw chunks are in the file type, which must not need a conversion
+    const H5T_class_t eClass = H5Tget_class(datatype);
+    if( (eClass != H5T_INTEGER && eClass != H5T_FLOAT) ||
+        H5Tget_size(datatype) != H5Tget_size(native) ||
+        H5Tget_order(datatype) != H5Tget_order(native) ||
+        static_cast<size_t>(GDALGetDataTypeSizeBytes(GetDataType(native))) !=
+            H5Tget_size(native) )
+        return;
+
+    const hid_t listid = H5Dget_create_plist(dataset_id);
+    if( listid < 0 )
+        return;
+    bool bOK = H5Pget_layout(listid) == H5D_CHUNKED;
+    if( bOK )
+    {
+        anChunkDims.resize(ndims);
+        bOK = H5Pget_chunk(listid, ndims, anChunkDims.data()) == ndims;
+    }
+    const int nFilters = bOK ? H5Pget_nfilters(listid) : 0;
+    for( int i = 0; bOK && i < nFilters; i++ )
+    {
+        unsigned int nFlags = 0;
+        size_t nValues = 0;
+        const H5Z_filter_t nFilter = H5Pget_filter2(
+            listid, i, &nFlags, &nValues, nullptr, 0, nullptr, nullptr);
+        if( nFilter == H5Z_FILTER_DEFLATE || nFilter == H5Z_FILTER_SHUFFLE )
+            anFilters.push_back(nFilter);
+        else
+            bOK = false;
+    }
+    H5Pclose(listid);
+
+    if( !bOK )
+    {
+        anChunkDims.clear();
+        anFilters.clear();
+        return;
+    }
+    nDecodeThreads = nThreads;
+#endif
+}
+
+/************************************************************************/
+/*                           ChunkDecodeJob                             */
+/************************************************************************/
+
+struct HDF5ImageDataset::ChunkDecodeJob
+{
+    const std::vector<H5Z_filter_t>* panFilters = nullptr;
+    std::vector<GByte> abyRaw{};
+    uint32_t nFilterMask = 0;
+    size_t nElementSize = 0;
+    size_t nChunkBytes = 0;
+    size_t nSliceBytes = 0;
+    // Blocks to fill, with the index of their band in the chunk
+    std::vector<std::pair<GDALRasterBlock *, int>> aoTargets{};
+    bool bOK = false;
+};
+
+/************************************************************************/
+/*                          DecodeChunkFunc()                           */
+/************************************************************************/
+
+void HDF5ImageDataset::DecodeChunkFunc( void *pData )
+{
+    ChunkDecodeJob *psJob = static_cast<ChunkDecodeJob *>(pData);
+    std::vector<GByte> abyIn(std::move(psJob->abyRaw));
+    std::vector<GByte> abyOut;
+
+    // Undo the filters in reverse pipeline order
+    const int nFilters = static_cast<int>(psJob->panFilters->size());
+    for( int i = nFilters - 1; i >= 0; i-- )
+    {
+        if( (psJob->nFilterMask >> i) & 1 )
+            continue;  // Skipped when the chunk was written
+
+        abyOut.resize(psJob->nChunkBytes);
+        if( (*psJob->panFilters)[i] == H5Z_FILTER_DEFLATE )
+        {
+            size_t nOutBytes = 0;
+            if( CPLZLibInflate(abyIn.data(), abyIn.size(), abyOut.data(),
+                               abyOut.size(), &nOutBytes) == nullptr )
+                return;
+            abyOut.resize(nOutBytes);
+        }
+        else  // H5Z_FILTER_SHUFFLE
+        {
+            const size_t nElts = abyIn.size() / psJob->nElementSize;
+            abyOut.resize(abyIn.size());
+            for( size_t j = 0; j < psJob->nElementSize; j++ )
+            {
+                const GByte *pabySrc = abyIn.data() + j * nElts;
+                GByte *pabyDst = abyOut.data() + j;
+                for( size_t k = 0; k < nElts; k++ )
+                    pabyDst[k * psJob->nElementSize] = pabySrc[k];
+            }
+            // Trailing bytes are not shuffled
+            const size_t nDone = nElts * psJob->nElementSize;
+            memcpy(abyOut.data() + nDone, abyIn.data() + nDone,
+                   abyIn.size() - nDone);
+        }
+        std::swap(abyIn, abyOut);
+    }
+
+    if( abyIn.size() != psJob->nChunkBytes )
+        return;
+    for( const auto &oTarget : psJob->aoTargets )
+    {
+        memcpy(oTarget.first->GetDataRef(),
+               abyIn.data() + oTarget.second * psJob->nSliceBytes,
+               psJob->nSliceBytes);
+    }
+    psJob->bOK = true;
+}
+
+/************************************************************************/
+/*                           PrefetchBlocks()                           */
+/*                                                                      */
+/*      Read the raw chunks of the blocks of a window that are not in   */
+/*      the block cache yet, and decode them in parallel directly in    */
+/*      the block cache. The HDF5 library is only called from this      */
+/*      thread. Chunks that are not allocated, can't be read or fail    */
+/*      to decode are left to IReadBlock().                             */
+/************************************************************************/
+
+void HDF5ImageDataset::PrefetchBlocks(
+    const std::vector<HDF5ImageRasterBand *> &apoBands,
+    int nXOff, int nYOff, int nXSize, int nYSize )
+{
+#ifdef HDF5_HAS_DIRECT_CHUNK_READ
+    if( apoBands.empty() || anChunkDims.empty() || nXSize < 1 || nYSize < 1 )
+        return;
+
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    apoBands[0]->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    const int nXIndex = GetXIndex();
+    const int nYIndex = GetYIndex();
+    // Blocks are chunks, but check it in case of unusual chunk dimensions
+    if( static_cast<hsize_t>(nBlockXSize) != anChunkDims[nXIndex] ||
+        (nYIndex >= 0 &&
+         static_cast<hsize_t>(nBlockYSize) != anChunkDims[nYIndex]) )
+        return;
+
+    const int nX0 = nXOff / nBlockXSize;
+    const int nX1 = (nXOff + nXSize - 1) / nBlockXSize;
+    const int nY0 = nYOff / nBlockYSize;
+    const int nY1 = (nYOff + nYSize - 1) / nBlockYSize;
+
+    const size_t nElementSize = H5Tget_size(datatype);
+    const size_t nSliceBytes =
+        nElementSize * nBlockXSize * nBlockYSize;
+    // The decoded blocks have to stay in the block cache until they get used
+    const GIntBig nBlocks = static_cast<GIntBig>(nX1 - nX0 + 1) *
+                            (nY1 - nY0 + 1) * apoBands.size();
+    if( nBlocks < 2 ||
+        nBlocks * static_cast<GIntBig>(nSliceBytes) > GDALGetCacheMax64() / 4 )
+        return;
+
+    CPLWorkerThreadPool *poPool = GDALGetGlobalThreadPool(nDecodeThreads);
+    if( poPool == nullptr )
+        return;
+    auto poQueue = poPool->CreateJobQueue();
+
+    // Bands in a chunk, along the first dimension of 3D datasets
+    const int nChunkBands =
+        ndims == 3 ? static_cast<int>(anChunkDims[0]) : 1;
+    size_t nChunkBytes = nElementSize;
+    for( const auto nDim : anChunkDims )
+        nChunkBytes *= static_cast<size_t>(nDim);
+
+    std::vector<std::unique_ptr<ChunkDecodeJob>> apoJobs;
+    const size_t nBatchSize = 4 * static_cast<size_t>(nDecodeThreads);
+
+    const auto DecodeBatch = [&]()
+    {
+        for( auto &poJob : apoJobs )
+        {
+            if( !poQueue->SubmitJob(DecodeChunkFunc, poJob.get()) )
+                DecodeChunkFunc(poJob.get());
+        }
+        poQueue->WaitCompletion();
+        for( auto &poJob : apoJobs )
+        {
+            for( const auto &oTarget : poJob->aoTargets )
+            {
+                GDALRasterBlock *poBlock = oTarget.first;
+                const int nXBlock = poBlock->GetXOff();
+                const int nYBlock = poBlock->GetYOff();
+                GDALRasterBand *poBand = poBlock->GetBand();
+                poBlock->DropLock();
+                // Drop the block, IReadBlock() will read it again
+                if( !poJob->bOK )
+                    poBand->FlushBlock(nXBlock, nYBlock, FALSE);
+            }
+        }
+        apoJobs.clear();
+    };
+
+    for( int iY = nY0; iY <= nY1; iY++ )
+    {
+        for( int iX = nX0; iX <= nX1; iX++ )
+        {
+            // Jobs of this block position, by chunk along the band dimension
+            std::map<int, ChunkDecodeJob *> oMapJobs;
+            for( auto poBand : apoBands )
+            {
+                GDALRasterBlock *poBlock = poBand->TryGetLockedBlockRef(iX, iY);
+                if( poBlock != nullptr )
+                {
+                    poBlock->DropLock();
+                    continue;
+                }
+
+                const int iBand = poBand->GetBand() - 1;
+                const int iChunk = iBand / nChunkBands;
+                auto oIter = oMapJobs.find(iChunk);
+                if( oIter == oMapJobs.end() )
+                {
+                    ChunkDecodeJob *psJob = nullptr;
+                    hsize_t anOffset[3] = {0, 0, 0};
+                    if( ndims == 3 )
+                        anOffset[0] = static_cast<hsize_t>(iChunk) * nChunkBands;
+                    if( nYIndex >= 0 )
+                        anOffset[nYIndex] = static_cast<hsize_t>(iY) * nBlockYSize;
+                    anOffset[nXIndex] = static_cast<hsize_t>(iX) * nBlockXSize;
+
+                    // Unallocated chunks hold the fill value, left to H5Dread()
+                    hsize_t nStorageSize = 0;
+                    H5E_BEGIN_TRY {
+                        if( H5Dget_chunk_storage_size(dataset_id, anOffset,
+                                                      &nStorageSize) < 0 )
+                            nStorageSize = 0;
+                    } H5E_END_TRY;
+                    if( nStorageSize > 0 && nStorageSize <= 2 * nChunkBytes + 1024 )
+                    {
+                        std::unique_ptr<ChunkDecodeJob> poJob(new ChunkDecodeJob());
+                        poJob->panFilters = &anFilters;
+                        poJob->nElementSize = nElementSize;
+                        poJob->nChunkBytes = nChunkBytes;
+                        poJob->nSliceBytes = nSliceBytes;
+                        poJob->abyRaw.resize(static_cast<size_t>(nStorageSize));
+                        herr_t status = -1;
+                        H5E_BEGIN_TRY {
+                            status = H5Dread_chunk(dataset_id, H5P_DEFAULT,
+                                                   anOffset,
+                                                   &poJob->nFilterMask,
+                                                   poJob->abyRaw.data());
+                        } H5E_END_TRY;
+                        if( status >= 0 )
+                        {
+                            psJob = poJob.get();
+                            apoJobs.push_back(std::move(poJob));
+                        }
+                    }
+                    oIter = oMapJobs.insert(
+                        std::pair<int, ChunkDecodeJob *>(iChunk, psJob)).first;
+                }
+                if( oIter->second == nullptr )
+                    continue;
+
+                poBlock = poBand->GetLockedBlockRef(iX, iY, TRUE);
+                if( poBlock != nullptr )
+                {
+                    oIter->second->aoTargets.push_back(
+                        std::pair<GDALRasterBlock *, int>(
+                            poBlock, iBand % nChunkBands));
+                }
+            }
+
+            if( apoJobs.size() >= nBatchSize )
+                DecodeBatch();
+        }
+    }
+    DecodeBatch();
+#else
+    CPL_IGNORE_RET_VAL(apoBands);
+    CPL_IGNORE_RET_VAL(nXOff);
+    CPL_IGNORE_RET_VAL(nYOff);
+    CPL_IGNORE_RET_VAL(nXSize);
+    CPL_IGNORE_RET_VAL(nYSize);
+#endif
+}
+
 /************************************************************************/
 /*                              Identify()                              */
 /************************************************************************/
@@ -563,6 +963,8 @@ GDALDataset *HDF5ImageDataset::Open( GDALOpenInfo *poOpenInfo )
         poDS->SetBand(i, poBand);
     }
 
+    poDS->InitDirectChunkRead();
+
     poDS->CreateProjections();
 
     // Setup/check for pam .aux.xml.
@@ -48,7 +48,10 @@
 #include <setjmp.h>
 
 #include <algorithm>
+#include <chrono>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -59,8 +62,10 @@
 #include "gdal.h"
 #include "gdal_frmts.h"
 #include "gdal_pam.h"
+#include "gdal_perf_counters.h"
 #include "gdal_priv.h"
 #include "gdalexif.h"
+#include "gdal_thread_pool.h"
 CPL_C_START
 #ifdef LIBJPEG_12_PATH
 #  include LIBJPEG_12_PATH
@@ -1312,6 +1317,33 @@ CPLErr JPGRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
     return CE_None;
 }
 
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr JPGRasterBand::IRasterIO( GDALRWFlag eRWFlag,
+                                 int nXOff, int nYOff, int nXSize, int nYSize,
+                                 void *pData, int nBufXSize, int nBufYSize,
+                                 GDALDataType eBufType,
+                                 GSpacing nPixelSpace, GSpacing nLineSpace,
+                                 GDALRasterIOExtraArg *psExtraArg )
+{
+    if( eRWFlag == GF_Read && nXSize == nBufXSize && nYSize == nBufYSize &&
+        pData != nullptr )
+    {
+        bool bHandled = false;
+        const CPLErr eErr = poGDS->ReadWithRestartMarkers(
+            nXOff, nYOff, nXSize, nYSize, pData, eBufType, 1, &nBand,
+            nPixelSpace, nLineSpace, 0, bHandled);
+        if( bHandled )
+            return eErr;
+    }
+
+    return GDALPamRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                        pData, nBufXSize, nBufYSize, eBufType,
+                                        nPixelSpace, nLineSpace, psExtraArg);
+}
+
 /************************************************************************/
 /*                       GetColorInterpretation()                       */
 /************************************************************************/
@@ -2014,6 +2046,13 @@ CPLErr JPGDataset::LoadScanline( int iLine, GByte* outBuffer )
             return CE_Failure;
     }
 
+    // No RAII timer here: objects with destructors must not be skipped by
+    // the longjmp() of the error handler.
+    GDAL_PERF_COUNTER(poScanlinesCounter, "JPEG.scanlines_decoded");
+    GDAL_PERF_COUNTER(poBytesCounter, "JPEG.bytes_decompressed");
+    GDAL_PERF_COUNTER(poTimeCounter, "JPEG.decode_time_ns");
+    const auto nStartTime = std::chrono::steady_clock::now();
+    const int nFirstScanline = nLoadedScanline;
     while( nLoadedScanline < iLine )
     {
         JSAMPLE *ppSamples = reinterpret_cast<JSAMPLE *>(
@@ -2023,6 +2062,13 @@ CPLErr JPGDataset::LoadScanline( int iLine, GByte* outBuffer )
             return CE_Failure;
         nLoadedScanline++;
     }
+    poScanlinesCounter->Add(nLoadedScanline - nFirstScanline);
+    poBytesCounter->Add(static_cast<GIntBig>(nLoadedScanline - nFirstScanline) *
+                        sDInfo.output_width * sDInfo.output_components *
+                        sizeof(JSAMPLE));
+    poTimeCounter->Add(static_cast<GIntBig>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - nStartTime).count()));
 
     return CE_None;
 }
@@ -2300,6 +2346,66 @@ CPLErr JPGDataset::Restart()
     return CE_None;
 }
 
+/************************************************************************/
+/*                        DecodeRestartStream()                         */
+/************************************************************************/
+
+bool JPGDataset::DecodeRestartStream( const GByte *pabyStream, size_t nSize,
+                                      int nLines, GByte *pabyDst )
+{
+    const CPLString osTmpFilename(
+        CPLSPrintf("/vsimem/jpg_restart_%p", pabyStream));
+    VSILFILE *fpStream = VSIFileFromMemBuffer(
+        osTmpFilename, const_cast<GByte *>(pabyStream), nSize, FALSE);
+    if( fpStream == nullptr )
+        return false;
+
+    GDALJPEGUserData sLocalUserData;
+    struct jpeg_decompress_struct sLocalDInfo;
+    struct jpeg_error_mgr sLocalJErr;
+    memset(&sLocalDInfo, 0, sizeof(sLocalDInfo));
+    memset(&sLocalJErr, 0, sizeof(sLocalJErr));
+    sLocalDInfo.err = jpeg_std_error(&sLocalJErr);
+    sLocalJErr.error_exit = JPGDataset::ErrorExit;
+    sLocalUserData.p_previous_emit_message = sLocalJErr.emit_message;
+    sLocalJErr.emit_message = JPGDataset::EmitMessage;
+    sLocalDInfo.client_data = &sLocalUserData;
+
+    // Setup to trap a fatal error.
+    if( setjmp(sLocalUserData.setjmp_buffer) )
+    {
+        jpeg_destroy_decompress(&sLocalDInfo);
+        VSIFCloseL(fpStream);
+        VSIUnlink(osTmpFilename);
+        return false;
+    }
+
+    jpeg_create_decompress(&sLocalDInfo);
+    jpeg_vsiio_src(&sLocalDInfo, fpStream);
+    jpeg_read_header(&sLocalDInfo, TRUE);
+    sLocalDInfo.out_color_space = sDInfo.out_color_space;
+    jpeg_start_decompress(&sLocalDInfo);
+
+    bool bOK = static_cast<int>(sLocalDInfo.output_width) == nRasterXSize &&
+               static_cast<int>(sLocalDInfo.output_height) == nLines &&
+               sLocalDInfo.output_components == nBands;
+    const size_t nLineBytes = static_cast<size_t>(nRasterXSize) * nBands *
+                              sizeof(JSAMPLE);
+    while( bOK && static_cast<int>(sLocalDInfo.output_scanline) < nLines )
+    {
+        JSAMPLE *ppSamples = reinterpret_cast<JSAMPLE *>(
+            pabyDst + sLocalDInfo.output_scanline * nLineBytes);
+        jpeg_read_scanlines(&sLocalDInfo, &ppSamples, 1);
+        if( sLocalUserData.bNonFatalErrorEncountered )
+            bOK = false;
+    }
+
+    jpeg_destroy_decompress(&sLocalDInfo);
+    VSIFCloseL(fpStream);
+    VSIUnlink(osTmpFilename);
+    return bOK;
+}
+
 #if !defined(JPGDataset)
 
 /************************************************************************/
@@ -2401,6 +2507,18 @@ CPLErr JPGDatasetCommon::IRasterIO( GDALRWFlag eRWFlag,
       return CE_Failure;
     }
 
+    if( eRWFlag == GF_Read && nXSize == nBufXSize && nYSize == nBufYSize &&
+        pData != nullptr )
+    {
+        bool bHandled = false;
+        const CPLErr eErr = ReadWithRestartMarkers(
+            nXOff, nYOff, nXSize, nYSize, pData, eBufType,
+            nBandCount, panBandMap, nPixelSpace, nLineSpace, nBandSpace,
+            bHandled);
+        if( bHandled )
+            return eErr;
+    }
+
 #ifndef JPEG_LIB_MK1
     if((eRWFlag == GF_Read) &&
        (nBandCount == 3) &&
@@ -2475,6 +2593,580 @@ CPLErr JPGDatasetCommon::IRasterIO( GDALRWFlag eRWFlag,
                                      psExtraArg);
 }
 
+/************************************************************************/
+/*                         ParseRestartHeader()                         */
+/*                                                                      */
+/*      Parse the markers up to the start of scan of a baseline or      */
+/*      extended sequential Huffman JPEG with a single interleaved      */
+/*      scan and a restart interval, and keep the ones needed to        */
+/*      decode a horizontal strip of the image as a standalone JPEG.    */
+/************************************************************************/
+
+bool JPGDatasetCommon::ParseRestartHeader()
+{
+    m_nRestartIndexStatus = -1;
+
+    const vsi_l_offset nSavedPos = VSIFTellL(fpImage);
+    vsi_l_offset nPos = nSubfileOffset;
+    GByte abyBuf[4] = { 0 };
+    if( VSIFSeekL(fpImage, nPos, SEEK_SET) != 0 ||
+        VSIFReadL(abyBuf, 2, 1, fpImage) != 1 ||
+        abyBuf[0] != 0xFF || abyBuf[1] != 0xD8 )
+    {
+        VSIFSeekL(fpImage, nSavedPos, SEEK_SET);
+        return false;
+    }
+    m_abyRestartHeader.assign(abyBuf, abyBuf + 2);
+    nPos += 2;
+
+    bool bOK = true;
+    bool bHasSOF = false;
+    bool bHasDHT = false;
+    bool bHasDQT = false;
+    int nWidth = 0;
+    int nHeight = 0;
+    int nComponents = 0;
+    int nScanComponents = 0;
+    int nHMax = 1;
+    int nVMax = 1;
+    std::vector<GByte> abySegment;
+    for( int iSegment = 0; bOK; iSegment++ )
+    {
+        if( iSegment == 10000 ||
+            VSIFSeekL(fpImage, nPos, SEEK_SET) != 0 ||
+            VSIFReadL(abyBuf, 4, 1, fpImage) != 1 || abyBuf[0] != 0xFF )
+        {
+            bOK = false;
+            break;
+        }
+        if( abyBuf[1] == 0xFF )  // Fill byte
+        {
+            nPos++;
+            continue;
+        }
+        const GByte nMarker = abyBuf[1];
+        const int nSegmentSize = abyBuf[2] * 256 + abyBuf[3];
+        if( nSegmentSize < 2 )
+        {
+            bOK = false;
+            break;
+        }
+        abySegment.resize(2 + nSegmentSize);
+        memcpy(abySegment.data(), abyBuf, 4);
+        if( nSegmentSize > 2 &&
+            VSIFReadL(abySegment.data() + 4, nSegmentSize - 2, 1,
+                      fpImage) != 1 )
+        {
+            bOK = false;
+            break;
+        }
+
+        bool bKeep = true;
+        if( nMarker == 0xC4 )  // DHT
+        {
+            bHasDHT = true;
+        }
+        else if( nMarker == 0xDB )  // DQT
+        {
+            bHasDQT = true;
+        }
+        else if( nMarker == 0xDD )  // DRI
+        {
+            if( nSegmentSize != 4 )
+                bOK = false;
+            else
+                m_nRestartInterval = abySegment[4] * 256 + abySegment[5];
+        }
+        else if( nMarker == 0xC0 || nMarker == 0xC1 )  // SOF0, SOF1
+        {
+            nComponents = nSegmentSize >= 8 ? abySegment[9] : 0;
+            if( bHasSOF || nComponents == 0 ||
+                nSegmentSize != 8 + 3 * nComponents ||
+                abySegment[4] != GetDataPrecision() )
+            {
+                bOK = false;
+                break;
+            }
+            bHasSOF = true;
+            m_nRestartHeaderHeightOffset = m_abyRestartHeader.size() + 5;
+            nHeight = abySegment[5] * 256 + abySegment[6];
+            nWidth = abySegment[7] * 256 + abySegment[8];
+            for( int i = 0; i < nComponents; i++ )
+            {
+                const int nH = abySegment[11 + 3 * i] >> 4;
+                const int nV = abySegment[11 + 3 * i] & 0xF;
+                if( nH < 1 || nH > 4 || nV < 1 || nV > 4 )
+                    bOK = false;
+                nHMax = std::max(nHMax, nH);
+                nVMax = std::max(nVMax, nV);
+            }
+        }
+        else if( nMarker >= 0xC2 && nMarker <= 0xCF )
+        {
+            // Progressive, lossless, arithmetic coding, ...
+            bOK = false;
+        }
+        else if( nMarker == 0xDA )  // SOS
+        {
+            nScanComponents = nSegmentSize >= 3 ? abySegment[4] : 0;
+            m_abyRestartHeader.insert(m_abyRestartHeader.end(),
+                                      abySegment.begin(), abySegment.end());
+            m_nEntropyDataOffset = nPos + 2 + nSegmentSize;
+            break;
+        }
+        else if( (nMarker >= 0xE1 && nMarker <= 0xED) || nMarker == 0xEF ||
+                 nMarker == 0xFE )
+        {
+            // EXIF, XMP, ICC, comments, ... are not needed to decode.
+            // JFIF APP0 and Adobe APP14 determine the color transform.
+            bKeep = false;
+        }
+        else if( (nMarker >= 0xD0 && nMarker <= 0xD9) || nMarker == 0x01 )
+        {
+            bOK = false;
+        }
+
+        if( bKeep )
+            m_abyRestartHeader.insert(m_abyRestartHeader.end(),
+                                      abySegment.begin(), abySegment.end());
+        nPos += 2 + nSegmentSize;
+    }
+    VSIFSeekL(fpImage, nSavedPos, SEEK_SET);
+
+    if( !bOK || !bHasSOF || !bHasDHT || !bHasDQT ||
+        m_nRestartInterval == 0 || nScanComponents != nComponents ||
+        nWidth != nRasterXSize || nHeight != nRasterYSize )
+    {
+        m_abyRestartHeader.clear();
+        return false;
+    }
+
+    // Geometry of MCUs, as in per_scan_setup() of libjpeg
+    if( nComponents == 1 )
+    {
+        m_nMCULines = DCTSIZE;
+        m_nMCUsPerRow = DIV_ROUND_UP(nWidth, DCTSIZE);
+    }
+    else
+    {
+        m_nMCULines = nVMax * DCTSIZE;
+        m_nMCUsPerRow = DIV_ROUND_UP(nWidth, nHMax * DCTSIZE);
+    }
+    m_nMCURows = DIV_ROUND_UP(nHeight, m_nMCULines);
+    // Fancy upsampling of vertically subsampled components uses the
+    // neighbouring MCU rows, so strips must be decoded with some margin.
+    m_bRestartContextRows = nComponents > 1 && nVMax > 1;
+    const GIntBig nMCUs = static_cast<GIntBig>(m_nMCUsPerRow) * m_nMCURows;
+    m_nRestartSegments = DIV_ROUND_UP(nMCUs, m_nRestartInterval);
+
+    // MCU rows where a restart segment starts
+    for( int iRow = 0; iRow < m_nMCURows; iRow++ )
+    {
+        if( (static_cast<GIntBig>(iRow) * m_nMCUsPerRow) %
+                m_nRestartInterval == 0 )
+            m_anRestartRows.push_back(iRow);
+    }
+    if( m_anRestartRows.size() < 2 )
+    {
+        m_abyRestartHeader.clear();
+        m_anRestartRows.clear();
+        return false;
+    }
+
+    m_nRestartIndexStatus = 1;
+    return true;
+}
+
+/************************************************************************/
+/*                        IndexRestartMarkers()                         */
+/*                                                                      */
+/*      Scan the entropy coded data for the offsets of the RSTn         */
+/*      markers. This requires reading the whole scan once.             */
+/************************************************************************/
+
+bool JPGDatasetCommon::IndexRestartMarkers()
+{
+    CPLAssert(m_nRestartIndexStatus == 1);
+    m_nRestartIndexStatus = -1;
+
+    const vsi_l_offset nSavedPos = VSIFTellL(fpImage);
+    if( VSIFSeekL(fpImage, m_nEntropyDataOffset, SEEK_SET) != 0 )
+        return false;
+
+    const size_t nExpectedMarkers =
+        static_cast<size_t>(m_nRestartSegments - 1);
+    std::vector<vsi_l_offset> anOffsets;
+    std::vector<GByte> abyBuf(1024 * 1024);
+    vsi_l_offset nBufOffset = m_nEntropyDataOffset;
+    bool bPrevFF = false;
+    bool bOK = false;
+    bool bDone = false;
+    while( !bDone )
+    {
+        const size_t nRead = VSIFReadL(abyBuf.data(), 1, abyBuf.size(),
+                                       fpImage);
+        if( nRead == 0 )
+            break;
+        for( size_t i = 0; i < nRead; i++ )
+        {
+            const GByte nByte = abyBuf[i];
+            if( !bPrevFF )
+            {
+                bPrevFF = nByte == 0xFF;
+                continue;
+            }
+            if( nByte == 0xFF )  // Fill byte
+                continue;
+            bPrevFF = false;
+            if( nByte == 0x00 )  // Stuffed zero
+                continue;
+
+            const vsi_l_offset nMarkerOffset = nBufOffset + i - 1;
+            if( nByte >= 0xD0 && nByte <= 0xD7 &&
+                anOffsets.size() < nExpectedMarkers &&
+                (nByte & 7) == static_cast<int>(anOffsets.size() % 8) )
+            {
+                anOffsets.push_back(nMarkerOffset);
+                continue;
+            }
+            // EOI after the expected number of restart markers. Anything
+            // else (DNL, other scans, corrupted data) is left to libjpeg.
+            bOK = nByte == 0xD9 && anOffsets.size() == nExpectedMarkers;
+            m_nEndOfScanOffset = nMarkerOffset;
+            bDone = true;
+            break;
+        }
+        nBufOffset += nRead;
+    }
+    VSIFSeekL(fpImage, nSavedPos, SEEK_SET);
+
+    if( !bOK )
+    {
+        CPLDebug("JPEG", "Cannot index restart markers");
+        return false;
+    }
+    m_anRestartMarkerOffsets = std::move(anOffsets);
+    m_nRestartIndexStatus = 2;
+    return true;
+}
+
+/************************************************************************/
+/*                         ReadRestartStream()                          */
+/*                                                                      */
+/*      Build a standalone JPEG stream for the MCU rows [nFirstRow,     */
+/*      nEndRow[, which must start restart segments (or be the end of   */
+/*      the image for nEndRow).                                         */
+/************************************************************************/
+
+bool JPGDatasetCommon::ReadRestartStream( int nFirstRow, int nEndRow,
+                                          std::vector<GByte> &abyStream )
+{
+    const GIntBig nFirstSegment =
+        static_cast<GIntBig>(nFirstRow) * m_nMCUsPerRow / m_nRestartInterval;
+    const GIntBig nEndSegment = nEndRow == m_nMCURows ? m_nRestartSegments :
+        static_cast<GIntBig>(nEndRow) * m_nMCUsPerRow / m_nRestartInterval;
+    const vsi_l_offset nStart = nFirstSegment == 0 ? m_nEntropyDataOffset :
+        m_anRestartMarkerOffsets[static_cast<size_t>(nFirstSegment - 1)] + 2;
+    const vsi_l_offset nEnd = nEndSegment == m_nRestartSegments ?
+        m_nEndOfScanOffset :
+        m_anRestartMarkerOffsets[static_cast<size_t>(nEndSegment - 1)];
+    if( nEnd < nStart ||
+        nEnd - nStart > static_cast<vsi_l_offset>(INT_MAX) )
+        return false;
+
+    const size_t nHeaderSize = m_abyRestartHeader.size();
+    const size_t nDataSize = static_cast<size_t>(nEnd - nStart);
+    try
+    {
+        abyStream.resize(nHeaderSize + nDataSize + 2);
+    }
+    catch( const std::bad_alloc& )
+    {
+        return false;
+    }
+    memcpy(abyStream.data(), m_abyRestartHeader.data(), nHeaderSize);
+    const int nLines = std::min(nRasterYSize - nFirstRow * m_nMCULines,
+                                (nEndRow - nFirstRow) * m_nMCULines);
+    abyStream[m_nRestartHeaderHeightOffset] =
+        static_cast<GByte>(nLines >> 8);
+    abyStream[m_nRestartHeaderHeightOffset + 1] =
+        static_cast<GByte>(nLines & 0xFF);
+
+    if( VSIFSeekL(fpImage, nStart, SEEK_SET) != 0 ||
+        VSIFReadL(abyStream.data() + nHeaderSize, 1, nDataSize,
+                  fpImage) != nDataSize )
+        return false;
+
+    // Renumber the restart markers, which must start at RST0.
+    for( GIntBig i = nFirstSegment; i + 1 < nEndSegment; i++ )
+    {
+        const size_t nOffset = nHeaderSize + static_cast<size_t>(
+            m_anRestartMarkerOffsets[static_cast<size_t>(i)] - nStart);
+        abyStream[nOffset + 1] =
+            static_cast<GByte>(0xD0 + ((i - nFirstSegment) & 7));
+    }
+
+    abyStream[nHeaderSize + nDataSize] = 0xFF;
+    abyStream[nHeaderSize + nDataSize + 1] = 0xD9;  // EOI
+    return true;
+}
+
+/************************************************************************/
+/*                       DecodeRestartStreamFunc()                      */
+/************************************************************************/
+
+namespace {
+struct JPGRestartJob
+{
+    JPGDatasetCommon *poDS = nullptr;
+    std::vector<GByte> abyStream{};
+    int nLineOff = 0;
+    int nLines = 0;
+    int nFirstUsedLine = 0;
+    int nEndUsedLine = 0;
+    std::vector<GByte> abyLines{};
+    bool bOK = false;
+    CPLErr eErrClass = CE_None;
+    CPLString osErrorMsg{};
+};
+}  // namespace
+
+void JPGDatasetCommon::DecodeRestartStreamFunc( void *pData )
+{
+    JPGRestartJob *psJob = static_cast<JPGRestartJob *>(pData);
+
+    // Errors and warnings are reported by the calling thread.
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    CPLErrorReset();
+    psJob->bOK = psJob->poDS->DecodeRestartStream(
+        psJob->abyStream.data(), psJob->abyStream.size(),
+        psJob->nLines, psJob->abyLines.data());
+    psJob->eErrClass = CPLGetLastErrorType();
+    psJob->osErrorMsg = CPLGetLastErrorMsg();
+    CPLPopErrorHandler();
+
+    psJob->abyStream.clear();
+    psJob->abyStream.shrink_to_fit();
+}
+
+/************************************************************************/
+/*                       ReadWithRestartMarkers()                       */
+/*                                                                      */
+/*      Read a window by decoding, possibly in parallel, only the       */
+/*      restart segments that cover it. bHandled is set to false if     */
+/*      the regular sequential decoding should be used instead: no      */
+/*      usable restart interval, or nothing to gain compared to it.     */
+/************************************************************************/
+
+CPLErr JPGDatasetCommon::ReadWithRestartMarkers(
+    int nXOff, int nYOff, int nXSize, int nYSize,
+    void *pData, GDALDataType eBufType,
+    int nBandCount, const int *panBandMap,
+    GSpacing nPixelSpace, GSpacing nLineSpace, GSpacing nBandSpace,
+    bool &bHandled )
+{
+    bHandled = false;
+#ifdef JPEG_LIB_MK1
+    CPL_IGNORE_RET_VAL(nXOff);
+    CPL_IGNORE_RET_VAL(nYOff);
+    CPL_IGNORE_RET_VAL(nXSize);
+    CPL_IGNORE_RET_VAL(nYSize);
+    CPL_IGNORE_RET_VAL(pData);
+    CPL_IGNORE_RET_VAL(eBufType);
+    CPL_IGNORE_RET_VAL(nBandCount);
+    CPL_IGNORE_RET_VAL(panBandMap);
+    CPL_IGNORE_RET_VAL(nPixelSpace);
+    CPL_IGNORE_RET_VAL(nLineSpace);
+    CPL_IGNORE_RET_VAL(nBandSpace);
+    return CE_None;
+#else
+    // CMYK to RGB is done by IReadBlock()
+    if( nScaleFactor != 1 || fpImage == nullptr || nYSize <= 0 ||
+        m_nRestartIndexStatus < 0 || eGDALColorSpace != GetOutColorSpace() )
+        return CE_None;
+    if( m_nRestartIndexStatus == 0 && !ParseRestartHeader() )
+        return CE_None;
+
+    const char *pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    const int nThreads = std::max(1, std::min(128,
+        EQUAL(pszThreads, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszThreads)));
+
+    // Average number of lines between two restart points. Use restart
+    // markers if the window spans several of them and threads are
+    // available, or if sequential decoding would have to decode more
+    // lines than that before reaching the window.
+    const int nRestartLines = static_cast<int>(
+        static_cast<GIntBig>(m_nMCURows) * m_nMCULines /
+            static_cast<int>(m_anRestartRows.size()));
+    const int nSkippedLines =
+        nYOff > nLoadedScanline ? nYOff - nLoadedScanline - 1 : nYOff;
+    if( !(nThreads > 1 && nYSize > nRestartLines) &&
+        nSkippedLines <= nRestartLines )
+        return CE_None;
+
+    if( m_nRestartIndexStatus == 1 && !IndexRestartMarkers() )
+        return CE_None;
+
+    bHandled = true;
+
+    const GDALDataType eDT =
+        GetDataPrecision() == 12 ? GDT_UInt16 : GDT_Byte;
+    const int nWordSize = GDALGetDataTypeSizeBytes(eDT);
+    const size_t nLineBytes =
+        static_cast<size_t>(nRasterXSize) * nBands * nWordSize;
+
+    // MCU rows to decode, starting at a restart point
+    const int nFirstRow = *(std::upper_bound(m_anRestartRows.begin(),
+                                             m_anRestartRows.end(),
+                                             nYOff / m_nMCULines) - 1);
+    const int nLastRowExcluded =
+        DIV_ROUND_UP(nYOff + nYSize, m_nMCULines);
+
+    // Split in jobs of restart segments, capping their memory use
+    const int nTotalLines = (nLastRowExcluded - nFirstRow) * m_nMCULines;
+    const int nTargetLines = std::max(1, std::min(
+        DIV_ROUND_UP(nTotalLines, nThreads),
+        static_cast<int>(16 * 1024 * 1024 / nLineBytes)));
+    std::vector<std::pair<int, int>> aoJobRows;
+    auto oIter = std::lower_bound(m_anRestartRows.begin(),
+                                  m_anRestartRows.end(), nFirstRow);
+    while( oIter != m_anRestartRows.end() && *oIter < nLastRowExcluded )
+    {
+        const int nJobFirstRow = *oIter;
+        ++oIter;
+        while( oIter != m_anRestartRows.end() &&
+               (*oIter - nJobFirstRow) * m_nMCULines < nTargetLines )
+            ++oIter;
+        aoJobRows.emplace_back(nJobFirstRow,
+            oIter == m_anRestartRows.end() ? m_nMCURows : *oIter);
+    }
+
+    // Rows actually decoded by each job: extend them to the previous and
+    // next restart points so that the upsampled lines at the boundaries of
+    // the job match the ones of a sequential decoding.
+    std::vector<std::pair<int, int>> aoDecodedRows(aoJobRows);
+    if( m_bRestartContextRows )
+    {
+        for( auto &oRows : aoDecodedRows )
+        {
+            if( oRows.first > 0 )
+            {
+                oRows.first = *(std::lower_bound(m_anRestartRows.begin(),
+                                                 m_anRestartRows.end(),
+                                                 oRows.first) - 1);
+            }
+            if( oRows.second < m_nMCURows )
+            {
+                auto oNext = std::upper_bound(m_anRestartRows.begin(),
+                                              m_anRestartRows.end(),
+                                              oRows.second);
+                oRows.second =
+                    oNext == m_anRestartRows.end() ? m_nMCURows : *oNext;
+            }
+        }
+    }
+
+    std::unique_ptr<CPLJobQueue> poQueue;
+    if( nThreads > 1 && aoJobRows.size() > 1 )
+    {
+        CPLWorkerThreadPool *poPool = GDALGetGlobalThreadPool(nThreads);
+        if( poPool )
+            poQueue = poPool->CreateJobQueue();
+    }
+
+    // The sequential decoder reads fpImage from its current position.
+    const vsi_l_offset nSavedPos = VSIFTellL(fpImage);
+    CPLErr eErr = CE_None;
+    for( size_t iBatch = 0; eErr == CE_None && iBatch < aoJobRows.size();
+         iBatch += nThreads )
+    {
+        const size_t nBatchEnd =
+            std::min(aoJobRows.size(), iBatch + nThreads);
+        std::vector<std::unique_ptr<JPGRestartJob>> apoJobs;
+        for( size_t i = iBatch; i < nBatchEnd; i++ )
+        {
+            std::unique_ptr<JPGRestartJob> poJob(new JPGRestartJob());
+            poJob->poDS = this;
+            poJob->nLineOff = aoDecodedRows[i].first * m_nMCULines;
+            poJob->nLines = std::min(nRasterYSize,
+                aoDecodedRows[i].second * m_nMCULines) - poJob->nLineOff;
+            poJob->nFirstUsedLine = aoJobRows[i].first * m_nMCULines;
+            poJob->nEndUsedLine = std::min(nRasterYSize,
+                aoJobRows[i].second * m_nMCULines);
+            if( !ReadRestartStream(aoDecodedRows[i].first,
+                                   aoDecodedRows[i].second,
+                                   poJob->abyStream) )
+            {
+                CPLError(CE_Failure, CPLE_FileIO,
+                         "Cannot read restart segments");
+                eErr = CE_Failure;
+                break;
+            }
+            try
+            {
+                poJob->abyLines.resize(nLineBytes * poJob->nLines);
+            }
+            catch( const std::bad_alloc& )
+            {
+                CPLError(CE_Failure, CPLE_OutOfMemory, "Out of memory");
+                eErr = CE_Failure;
+                break;
+            }
+            if( !poQueue ||
+                !poQueue->SubmitJob(DecodeRestartStreamFunc, poJob.get()) )
+            {
+                DecodeRestartStreamFunc(poJob.get());
+            }
+            apoJobs.push_back(std::move(poJob));
+        }
+        if( poQueue )
+            poQueue->WaitCompletion();
+
+        for( const auto &poJob : apoJobs )
+        {
+            if( eErr != CE_None )
+                break;
+            if( poJob->eErrClass != CE_None )
+            {
+                CPLError(poJob->bOK ? poJob->eErrClass : CE_Failure,
+                         CPLE_AppDefined, "%s", poJob->osErrorMsg.c_str());
+            }
+            if( !poJob->bOK )
+            {
+                if( poJob->eErrClass == CE_None )
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "Cannot decode restart segments");
+                eErr = CE_Failure;
+                break;
+            }
+
+            const int nLineStart = std::max(nYOff, poJob->nFirstUsedLine);
+            const int nLineEnd = std::min(nYOff + nYSize,
+                                          poJob->nEndUsedLine);
+            for( int iLine = nLineStart; iLine < nLineEnd; iLine++ )
+            {
+                const GByte *pabySrc = poJob->abyLines.data() +
+                    (iLine - poJob->nLineOff) * nLineBytes +
+                    static_cast<size_t>(nXOff) * nBands * nWordSize;
+                GByte *pabyDst = static_cast<GByte *>(pData) +
+                    (iLine - nYOff) * nLineSpace;
+                for( int iBand = 0; iBand < nBandCount; iBand++ )
+                {
+                    GDALCopyWords64(
+                        pabySrc + (panBandMap[iBand] - 1) * nWordSize, eDT,
+                        nBands * nWordSize,
+                        pabyDst + iBand * nBandSpace, eBufType,
+                        static_cast<int>(nPixelSpace), nXSize);
+                }
+            }
+        }
+    }
+    VSIFSeekL(fpImage, nSavedPos, SEEK_SET);
+
+    return eErr;
+#endif
+}
+
 #if JPEG_LIB_VERSION_MAJOR < 9
 /************************************************************************/
 /*                    JPEGDatasetIsJPEGLS()                             */
@@ -49,6 +49,7 @@
 
 #include <algorithm>
 #include <string>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -217,6 +218,40 @@ class JPGDatasetCommon CPL_NON_FINAL: public GDALPamDataset
     virtual int GetDataPrecision() = 0;
     virtual int GetOutColorSpace() = 0;
 
+    // Restart marker index, used to decode independent parts of baseline
+    // JPEGs with a restart interval.
+    int    m_nRestartIndexStatus = 0;  // 0: unknown, 1: header parsed,
+                                       // 2: markers indexed, -1: unusable
+    std::vector<GByte> m_abyRestartHeader{};  // Markers from SOI to SOS
+    size_t m_nRestartHeaderHeightOffset = 0;  // Image height in SOF
+    vsi_l_offset m_nEntropyDataOffset = 0;
+    vsi_l_offset m_nEndOfScanOffset = 0;
+    int    m_nMCULines = 0;
+    int    m_nMCURows = 0;
+    int    m_nMCUsPerRow = 0;
+    int    m_nRestartInterval = 0;
+    GIntBig m_nRestartSegments = 0;
+    bool   m_bRestartContextRows = false;  // Vertical chroma upsampling
+    std::vector<int> m_anRestartRows{};  // MCU rows starting a segment
+    std::vector<vsi_l_offset> m_anRestartMarkerOffsets{};
+
+    bool   ParseRestartHeader();
+    bool   IndexRestartMarkers();
+    bool   ReadRestartStream( int nFirstRow, int nEndRow,
+                              std::vector<GByte> &abyStream );
+    CPLErr ReadWithRestartMarkers( int nXOff, int nYOff,
+                                   int nXSize, int nYSize,
+                                   void *pData, GDALDataType eBufType,
+                                   int nBandCount, const int *panBandMap,
+                                   GSpacing nPixelSpace, GSpacing nLineSpace,
+                                   GSpacing nBandSpace, bool &bHandled );
+    static void DecodeRestartStreamFunc( void *pData );
+
+    // Decode a standalone JPEG stream built by ReadRestartStream() into
+    // nLines full width lines. Called from worker threads.
+    virtual bool DecodeRestartStream( const GByte *pabyStream, size_t nSize,
+                                      int nLines, GByte *pabyDst ) = 0;
+
     bool   EXIFInit(VSILFILE *);
     void   ReadICCProfile();
 
@@ -309,6 +344,8 @@ class JPGDataset final: public JPGDatasetCommon
     virtual CPLErr Restart() override;
     virtual int GetDataPrecision() override { return sDInfo.data_precision; }
     virtual int GetOutColorSpace() override { return sDInfo.out_color_space; }
+    virtual bool DecodeRestartStream( const GByte *pabyStream, size_t nSize,
+                                      int nLines, GByte *pabyDst ) override;
 
     int    nQLevel;
 #if !defined(JPGDataset)
@@ -360,6 +397,10 @@ class JPGRasterBand final: public GDALPamRasterBand
     virtual ~JPGRasterBand() {}
 
     virtual CPLErr IReadBlock( int, int, void * ) override;
+    virtual CPLErr IRasterIO( GDALRWFlag, int, int, int, int,
+                              void *, int, int, GDALDataType,
+                              GSpacing nPixelSpace, GSpacing nLineSpace,
+                              GDALRasterIOExtraArg* psExtraArg ) override;
     virtual GDALColorInterp GetColorInterpretation() override;
 
     virtual GDALRasterBand *GetMaskBand() override;
@@ -30,18 +30,24 @@
 #include "cpl_port.h"
 #include "kmlsuperoverlaydataset.h"
 
+#include <atomic>
+#include <climits>
 #include <cmath>
 #include <cstring>
 #include <algorithm>
+#include <deque>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <sstream>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "gdal_frmts.h"
+#include "gdal_thread_pool.h"
 #include "ogr_spatialref.h"
 #include "../vrt/gdal_vrt.h"
 #include "../vrt/vrtdataset.h"
@@ -51,52 +57,61 @@ CPL_CVSID("$Id$")
 using namespace std;
 
 /************************************************************************/
-/*                           GenerateTiles()                            */
+/*                         KmlSuperOverlayTile                          */
 /************************************************************************/
-static void GenerateTiles(std::string filename,
-                   CPL_UNUSED int zoom,
-                   int rxsize,
-                   int rysize,
-                   CPL_UNUSED int ix,
-                   CPL_UNUSED int iy,
-                   int rx, int ry, int dxsize,
-                   int dysize, int bands,
-                   GDALDataset* poSrcDs,
-                   GDALDriver* poOutputTileDriver,
-                   GDALDriver* poMemDriver,
-                   bool isJpegDriver)
-{
-    GDALDataset* poTmpDataset = nullptr;
-    GDALRasterBand* alphaBand = nullptr;
 
-    GByte* pabyScanline = new GByte[dxsize];
-    bool* hadnoData = new bool[dxsize];
+namespace {
 
-    if (isJpegDriver && bands == 4)
-        bands = 3;
+// Pixels of a tile, at the resolution of its zoom level.
+struct KmlSuperOverlayTile
+{
+    int nXSize = 0;
+    int nYSize = 0;
+    int nBands = 0;
+    // Band sequential values.
+    std::vector<GByte> abyData{};
+    // Set to 1 for pixels that have the nodata value in one of their bands,
+    // or that could not be read.
+    std::vector<GByte> abyNoData{};
 
-    poTmpDataset = poMemDriver->Create("", dxsize, dysize, bands, GDT_Byte, nullptr);
+    KmlSuperOverlayTile(int nXSizeIn, int nYSizeIn, int nBandsIn):
+        nXSize(nXSizeIn), nYSize(nYSizeIn), nBands(nBandsIn),
+        abyData(static_cast<size_t>(nBandsIn) * nXSizeIn * nYSizeIn),
+        abyNoData(static_cast<size_t>(nXSizeIn) * nYSizeIn)
+    {}
 
-    if (!isJpegDriver)//Jpeg dataset only has one or three bands
+    GByte* GetBand(int iBand)
     {
-        if (bands < 4)//add transparency to files with one band or three bands
-        {
-            poTmpDataset->AddBand(GDT_Byte);
-            alphaBand = poTmpDataset->GetRasterBand(poTmpDataset->GetRasterCount());
-        }
+        return &abyData[static_cast<size_t>(iBand) * nXSize * nYSize];
+    }
+    const GByte* GetBand(int iBand) const
+    {
+        return &abyData[static_cast<size_t>(iBand) * nXSize * nYSize];
     }
+};
+
+} // namespace
+
+/************************************************************************/
+/*                              ReadTile()                              */
+/************************************************************************/
+
+// Reads the rxsize x rysize source window at (rx, ry) into a dxsize x dysize
+// tile, using nearest neighbour decimation.
+static std::shared_ptr<KmlSuperOverlayTile> ReadTile(
+                   int rxsize,
+                   int rysize,
+                   int rx, int ry, int dxsize,
+                   int dysize, int bands,
+                   GDALDataset* poSrcDs)
+{
+    auto poTile = std::make_shared<KmlSuperOverlayTile>(dxsize, dysize, bands);
 
     const int rowOffset = rysize/dysize;
-    const int loopCount = rysize/rowOffset;
+    const int loopCount = std::min(dysize, rysize/rowOffset);
     for (int row = 0; row < loopCount; row++)
     {
-        if (!isJpegDriver)
-        {
-            for (int i = 0; i < dxsize; i++)
-            {
-                hadnoData[i] = false;
-            }
-        }
+        GByte* pabyNoData = &poTile->abyNoData[static_cast<size_t>(row) * dxsize];
 
         for (int band = 1; band <= bands; band++)
         {
@@ -106,76 +121,156 @@ static void GenerateTiles(std::string filename,
             const char* pixelType = poBand->GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
             const bool isSigned = ( pixelType && (strcmp(pixelType, "SIGNEDBYTE") == 0) );
 
+            GByte* pabyScanline = poTile->GetBand(band - 1) +
+                                  static_cast<size_t>(row) * dxsize;
             int yOffset = ry + row * rowOffset;
             CPLErr errTest =
                 poBand->RasterIO( GF_Read, rx, yOffset, rxsize, rowOffset, pabyScanline, dxsize, 1, GDT_Byte, 0, 0, nullptr);
 
-            const bool bReadFailed = ( errTest == CE_Failure );
-            if ( bReadFailed )
+            if ( errTest == CE_Failure )
             {
-                hasNoData = 1;
+                memset(pabyScanline, 0, dxsize);
+                memset(pabyNoData, 1, dxsize);
             }
-
-            //fill the true or false for hadnoData array if the source data has nodata value
-            if (!isJpegDriver)
+            else if (hasNoData)
             {
-                if (hasNoData == 1)
+                //fill the nodata mask if the source data has nodata value
+                for (int j = 0; j < dxsize; j++)
                 {
-                    for (int j = 0; j < dxsize; j++)
+                    double tmpv = pabyScanline[j];
+                    if (isSigned)
                     {
-                        double v = pabyScanline[j];
-                        double tmpv = v;
-                        if (isSigned)
-                        {
-                            tmpv -= 128;
-                        }
-                        if (tmpv == noDataValue || bReadFailed)
-                        {
-                            hadnoData[j] = true;
-                        }
+                        tmpv -= 128;
+                    }
+                    if (tmpv == noDataValue)
+                    {
+                        pabyNoData[j] = 1;
                     }
                 }
             }
+        }
+    }
+
+    return poTile;
+}
 
-            if (!bReadFailed)
+/************************************************************************/
+/*                           DownsampleTile()                           */
+/************************************************************************/
+
+// Builds a tile from the 4 tiles of the next zoom level it covers, indexed
+// as [left-bottom, right-bottom, left-top, right-top]. Missing children are
+// considered as not readable.
+// A pixel of the result takes the value of the child pixel at 2*i+1, which is
+// what a nearest neighbour decimating RasterIO() of the source would pick.
+static std::shared_ptr<KmlSuperOverlayTile> DownsampleTile(
+                const std::shared_ptr<const KmlSuperOverlayTile> apoChildren[4],
+                int dxsize, int dysize, int bands)
+{
+    auto poTile = std::make_shared<KmlSuperOverlayTile>(dxsize, dysize, bands);
+
+    for (int row = 0; row < dysize; row++)
+    {
+        // Rows of the tile go from top to bottom, and the top children
+        // come after the bottom ones.
+        int srcRow = 2 * row + 1;
+        int iChildY = 1;
+        if (srcRow >= dysize)
+        {
+            srcRow -= dysize;
+            iChildY = 0;
+        }
+        GByte* pabyNoData = &poTile->abyNoData[static_cast<size_t>(row) * dxsize];
+        for (int col = 0; col < dxsize; col++)
+        {
+            int srcCol = 2 * col + 1;
+            int iChildX = 0;
+            if (srcCol >= dxsize)
+            {
+                srcCol -= dxsize;
+                iChildX = 1;
+            }
+            const KmlSuperOverlayTile* poChild =
+                apoChildren[iChildX + 2 * iChildY].get();
+            const size_t nDstOffset = static_cast<size_t>(row) * dxsize + col;
+            if (poChild == nullptr)
+            {
+                pabyNoData[col] = 1;
+                continue;
+            }
+            const size_t nSrcOffset =
+                static_cast<size_t>(srcRow) * dxsize + srcCol;
+            for (int band = 0; band < bands; band++)
             {
-                GDALRasterBand* poBandtmp = poTmpDataset->GetRasterBand(band);
-                CPL_IGNORE_RET_VAL( poBandtmp->RasterIO(GF_Write, 0, row, dxsize, 1, pabyScanline, dxsize, 1, GDT_Byte,
-                                    0, 0, nullptr) );
+                poTile->GetBand(band)[nDstOffset] =
+                    poChild->GetBand(band)[nSrcOffset];
             }
+            pabyNoData[col] = poChild->abyNoData[nSrcOffset];
         }
+    }
 
-        //fill the values for alpha band
-        if (!isJpegDriver)
-        {
-            if (alphaBand)
-            {
-                for (int i = 0; i < dxsize; i++)
-                {
-                    if (hadnoData[i])
-                    {
-                        pabyScanline[i] = 0;
-                    }
-                    else
-                    {
-                        pabyScanline[i] = 255;
-                    }
-                }
+    return poTile;
+}
 
-                CPL_IGNORE_RET_VAL( alphaBand->RasterIO(GF_Write, 0, row, dxsize, 1, pabyScanline, dxsize, 1, GDT_Byte,
-                                    0, 0, nullptr) );
-            }
+/************************************************************************/
+/*                           GenerateTiles()                            */
+/************************************************************************/
+
+// Encodes a tile with the JPEG or PNG driver. May be called concurrently
+// from several threads.
+static void GenerateTiles(const char* filename,
+                   const KmlSuperOverlayTile& oTile,
+                   GDALDriver* poOutputTileDriver,
+                   GDALDriver* poMemDriver,
+                   bool isJpegDriver)
+{
+    const int dxsize = oTile.nXSize;
+    const int dysize = oTile.nYSize;
+    int bands = oTile.nBands;
+    GDALRasterBand* alphaBand = nullptr;
+
+    if (isJpegDriver && bands == 4)
+        bands = 3;
+
+    GDALDataset* poTmpDataset = poMemDriver->Create("", dxsize, dysize, bands, GDT_Byte, nullptr);
+    if (poTmpDataset == nullptr)
+        return;
+
+    if (!isJpegDriver)//Jpeg dataset only has one or three bands
+    {
+        if (bands < 4)//add transparency to files with one band or three bands
+        {
+            poTmpDataset->AddBand(GDT_Byte);
+            alphaBand = poTmpDataset->GetRasterBand(poTmpDataset->GetRasterCount());
         }
     }
 
-    delete [] pabyScanline;
-    delete [] hadnoData;
+    for (int band = 1; band <= bands; band++)
+    {
+        GDALRasterBand* poBandtmp = poTmpDataset->GetRasterBand(band);
+        CPL_IGNORE_RET_VAL( poBandtmp->RasterIO(GF_Write, 0, 0, dxsize, dysize,
+                                const_cast<GByte*>(oTile.GetBand(band - 1)),
+                                dxsize, dysize, GDT_Byte, 0, 0, nullptr) );
+    }
+
+    //fill the values for alpha band
+    if (alphaBand)
+    {
+        std::vector<GByte> abyAlpha(oTile.abyNoData.size());
+        for (size_t i = 0; i < abyAlpha.size(); i++)
+        {
+            abyAlpha[i] = oTile.abyNoData[i] ? 0 : 255;
+        }
+
+        CPL_IGNORE_RET_VAL( alphaBand->RasterIO(GF_Write, 0, 0, dxsize, dysize, &abyAlpha[0],
+                            dxsize, dysize, GDT_Byte, 0, 0, nullptr) );
+    }
 
     CPLString osOpenAfterCopy = CPLGetConfigOption("GDAL_OPEN_AFTER_COPY", "");
     CPLSetThreadLocalConfigOption("GDAL_OPEN_AFTER_COPY", "NO");
     /* to prevent CreateCopy() from calling QuietDelete() */
     char** papszOptions = CSLAddNameValue(nullptr, "QUIET_DELETE_ON_CREATE_COPY", "NO");
-    GDALDataset* outDs = poOutputTileDriver->CreateCopy(filename.c_str(), poTmpDataset, FALSE, papszOptions, nullptr, nullptr);
+    GDALDataset* outDs = poOutputTileDriver->CreateCopy(filename, poTmpDataset, FALSE, papszOptions, nullptr, nullptr);
     CSLDestroy(papszOptions);
     CPLSetThreadLocalConfigOption("GDAL_OPEN_AFTER_COPY", !osOpenAfterCopy.empty() ? osOpenAfterCopy.c_str() : nullptr);
 
@@ -499,73 +594,375 @@ int  GenerateChildKml(std::string filename,
 /************************************************************************/
 /*                         DetectTransparency()                         */
 /************************************************************************/
-int KmlSuperOverlayReadDataset::DetectTransparency( int rxsize, int rysize,
-                                                    int rx, int ry,
-                                                    int dxsize, int dysize,
-                                                    GDALDataset* poSrcDs )
+
+// Returns a combination of the KMLSO_xxx flags for the tile.
+// anNoData[i] is the nodata value of the (i+1)th source band, or INT_MIN
+// if it has none.
+static int DetectTransparency( const KmlSuperOverlayTile& oTile,
+                               const std::vector<int>& anNoData )
 {
-    int bands = poSrcDs->GetRasterCount();
-    int rowOffset = rysize/dysize;
-    int loopCount = rysize/rowOffset;
-    int hasNoData = 0;
-    GByte* pabyScanline = new GByte[dxsize];
+    const size_t nPixels = static_cast<size_t>(oTile.nXSize) * oTile.nYSize;
 
     int flags = 0;
-    for (int band = 1; band <= bands; band++)
+    for (int band = 1; band <= oTile.nBands; band++)
     {
-        GDALRasterBand* poBand = poSrcDs->GetRasterBand(band);
-        int noDataValue = static_cast<int>(poBand->GetNoDataValue(&hasNoData));
+        const GByte* pabyData = oTile.GetBand(band - 1);
+        const int noDataValue = anNoData[band - 1];
 
-        if (band < 4 && hasNoData) {
-            for (int row = 0; row < loopCount; row++)
+        if (band < 4 && noDataValue != INT_MIN) {
+            for (size_t i = 0; i < nPixels; i++)
             {
-                int yOffset = ry + row * rowOffset;
-                CPL_IGNORE_RET_VAL(
-                    poBand->RasterIO( GF_Read,
-                                      rx, yOffset, rxsize, rowOffset,
-                                      pabyScanline, dxsize, 1,
-                                      GDT_Byte, 0, 0, nullptr) );
-                for (int i = 0; i < dxsize; i++)
+                if (pabyData[i] == noDataValue)
                 {
-                    if (pabyScanline[i] == noDataValue)
-                    {
-                        flags |= KMLSO_ContainsTransparentPixels;
-                    } else {
-                        flags |= KMLSO_ContainsOpaquePixels;
-                    }
+                    flags |= KmlSuperOverlayReadDataset::KMLSO_ContainsTransparentPixels;
+                } else {
+                    flags |= KmlSuperOverlayReadDataset::KMLSO_ContainsOpaquePixels;
                 }
                 // shortcut - if there are both types of pixels, flags is as
                 // full as it is going to get.
                 // so no point continuing, skip to the next band
-                if ((flags & KMLSO_ContainsTransparentPixels) &&
-                    (flags & KMLSO_ContainsOpaquePixels)) {
+                if ((flags & KmlSuperOverlayReadDataset::KMLSO_ContainsTransparentPixels) &&
+                    (flags & KmlSuperOverlayReadDataset::KMLSO_ContainsOpaquePixels)) {
                     break;
                 }
             }
         } else if (band == 4) {
-            for (int row = 0; row < loopCount; row++)
+            for (size_t i = 0; i < nPixels; i++)
+            {
+                if (pabyData[i] == 255)
+                {
+                    flags |= KmlSuperOverlayReadDataset::KMLSO_ContainsOpaquePixels;
+                } else if (pabyData[i] == 0) {
+                    flags |= KmlSuperOverlayReadDataset::KMLSO_ContainsTransparentPixels;
+                } else {
+                    flags |= KmlSuperOverlayReadDataset::KMLSO_ContainsPartiallyTransparentPixels;
+                }
+            }
+        }
+    }
+    return flags;
+}
+
+/************************************************************************/
+/*                        KmlSuperOverlayWriter                         */
+/************************************************************************/
+
+namespace {
+
+// Generates the tiles and child KML files of a super overlay.
+//
+// Tiles are processed depth first, so that a tile can be downsampled from
+// the 4 tiles of the next zoom level it covers instead of being read again
+// from the source. The JPEG/PNG encoding of the tiles is done by a thread
+// pool when GDAL_NUM_THREADS is set.
+struct KmlSuperOverlayWriter
+{
+    CPL_DISALLOW_COPY_ASSIGN(KmlSuperOverlayWriter)
+
+    KmlSuperOverlayWriter() = default;
+
+    struct EncodeJob
+    {
+        std::shared_ptr<const KmlSuperOverlayTile> poTile{};
+        std::string osFilename{};
+        // /vsimem/ file into which the tile is encoded before being copied
+        // into the KMZ, since only one file of a zip can be written at a time.
+        std::string osTmpFilename{};
+        GDALDriver* poOutputTileDriver = nullptr;
+        GDALDriver* poMemDriver = nullptr;
+        bool isJpegDriver = false;
+        std::atomic<bool> bDone{false};
+    };
+
+    GDALDataset* poSrcDS = nullptr;
+    // Number of source bands read for each tile.
+    int bands = 0;
+    // Nodata value of each source band, or INT_MIN.
+    std::vector<int> anNoData{};
+    // Whether tiles below the maximum zoom level are downsampled from the
+    // tiles of the next zoom level.
+    bool bBottomUp = false;
+
+    int xsize = 0;
+    int ysize = 0;
+    int tilexsize = 0;
+    int tileysize = 0;
+    int maxzoom = 0;
+    // Number of tiles in each dimension per zoom level.
+    std::vector<int> anXLoop{};
+    std::vector<int> anYLoop{};
+
+    CPLString outDir{};
+    bool isKmz = false;
+    bool isAutoDriver = false;
+    bool isJpegDriver = false;
+    GDALDriver* poOutputTileDriver = nullptr;
+    GDALDriver* poJpegOutputTileDriver = nullptr;
+    GDALDriver* poPngOutputTileDriver = nullptr;
+    GDALDriver* poMemDriver = nullptr;
+
+    double adfGeoTransform[6] = {0, 1, 0, 0, 0, 1};
+    std::vector<double> zoomxpixels{};
+    std::vector<double> zoomypixels{};
+    OGRCoordinateTransformation* poTransform = nullptr;
+    bool fixAntiMeridian = false;
+    const char* pszAltitude = nullptr;
+    const char* pszAltitudeMode = nullptr;
+
+    int nTotalTiles = 0;
+    int nTileCount = 0;
+    GDALProgressFunc pfnProgress = GDALDummyProgress;
+    void* pProgressData = nullptr;
+
+    std::unique_ptr<CPLJobQueue> poJobQueue{};
+    size_t nMaxPendingJobs = 0;
+    std::deque<std::unique_ptr<EncodeJob>> apoPendingJobs{};
+    int nTmpFileCounter = 0;
+
+    static void EncodeTileFunc(void* pData);
+
+    void SetNumThreads(int nThreads);
+    std::shared_ptr<const KmlSuperOverlayTile> ProcessTile(int zoom, int ix,
+                                                           int iy,
+                                                           bool& bGenerated,
+                                                           bool& bHasChildKML);
+    void SubmitEncodeJob(std::shared_ptr<const KmlSuperOverlayTile> poTile,
+                         const std::string& osFilename,
+                         GDALDriver* poTileDriver, bool bJpeg);
+    void WaitForJobs(size_t nMaxRemainingJobs);
+};
+
+} // namespace
+
+/************************************************************************/
+/*                           EncodeTileFunc()                           */
+/************************************************************************/
+
+void KmlSuperOverlayWriter::EncodeTileFunc(void* pData)
+{
+    EncodeJob* psJob = static_cast<EncodeJob*>(pData);
+    GenerateTiles(psJob->osTmpFilename.empty() ? psJob->osFilename.c_str() :
+                                                 psJob->osTmpFilename.c_str(),
+                  *(psJob->poTile), psJob->poOutputTileDriver,
+                  psJob->poMemDriver, psJob->isJpegDriver);
+    psJob->poTile.reset();
+    psJob->bDone = true;
+}
+
+/************************************************************************/
+/*                            SetNumThreads()                           */
+/************************************************************************/
+
+void KmlSuperOverlayWriter::SetNumThreads(int nThreads)
+{
+    if( nThreads <= 1 )
+        return;
+    CPLWorkerThreadPool* poThreadPool = GDALGetGlobalThreadPool(nThreads);
+    if( poThreadPool == nullptr )
+        return;
+    poJobQueue = poThreadPool->CreateJobQueue();
+    // Bounds the number of encoded tiles kept in memory.
+    nMaxPendingJobs = 2 * static_cast<size_t>(nThreads);
+}
+
+/************************************************************************/
+/*                           SubmitEncodeJob()                          */
+/************************************************************************/
+
+void KmlSuperOverlayWriter::SubmitEncodeJob(
+                        std::shared_ptr<const KmlSuperOverlayTile> poTile,
+                        const std::string& osFilename,
+                        GDALDriver* poTileDriver, bool bJpeg)
+{
+    std::unique_ptr<EncodeJob> poJob(new EncodeJob());
+    poJob->poTile = std::move(poTile);
+    poJob->osFilename = osFilename;
+    poJob->poOutputTileDriver = poTileDriver;
+    poJob->poMemDriver = poMemDriver;
+    poJob->isJpegDriver = bJpeg;
+
+    if( poJobQueue == nullptr )
+    {
+        EncodeTileFunc(poJob.get());
+        return;
+    }
+
+    if( isKmz )
+    {
+        poJob->osTmpFilename = CPLSPrintf("/vsimem/kmlsuperoverlay_%p_%d.%s",
+                                          this, nTmpFileCounter++,
+                                          CPLGetExtension(osFilename.c_str()));
+    }
+    EncodeJob* psJob = poJob.get();
+    apoPendingJobs.push_back(std::move(poJob));
+    if( !poJobQueue->SubmitJob(EncodeTileFunc, psJob) )
+        EncodeTileFunc(psJob);
+
+    WaitForJobs(nMaxPendingJobs);
+}
+
+/************************************************************************/
+/*                             WaitForJobs()                            */
+/************************************************************************/
+
+// Waits until at most nMaxRemainingJobs encoding jobs are pending, and
+// copies the tiles encoded for a KMZ into it, in submission order.
+void KmlSuperOverlayWriter::WaitForJobs(size_t nMaxRemainingJobs)
+{
+    while( apoPendingJobs.size() > nMaxRemainingJobs )
+    {
+        EncodeJob* psJob = apoPendingJobs.front().get();
+        while( !psJob->bDone )
+        {
+            int nRunningJobs = 0;
+            for( const auto& poJob: apoPendingJobs )
             {
-                int yOffset = ry + row * rowOffset;
-                CPL_IGNORE_RET_VAL(
-                    poBand->RasterIO( GF_Read, rx, yOffset, rxsize, rowOffset,
-                                      pabyScanline, dxsize, 1,
-                                      GDT_Byte, 0, 0, nullptr) );
-                for (int i = 0; i < dxsize; i++)
+                if( !poJob->bDone )
+                    nRunningJobs ++;
+            }
+            poJobQueue->WaitCompletion(std::max(0, nRunningJobs - 1));
+        }
+
+        if( !psJob->osTmpFilename.empty() )
+        {
+            vsi_l_offset nSize = 0;
+            GByte* pabyData = VSIGetMemFileBuffer(psJob->osTmpFilename.c_str(),
+                                                  &nSize, TRUE);
+            if( pabyData != nullptr )
+            {
+                VSILFILE* fp = VSIFOpenL(psJob->osFilename.c_str(), "wb");
+                if( fp != nullptr )
                 {
-                    if (pabyScanline[i] == 255)
+                    if( VSIFWriteL(pabyData, 1, static_cast<size_t>(nSize),
+                                   fp) != nSize )
                     {
-                        flags |= KMLSO_ContainsOpaquePixels;
-                    } else if (pabyScanline[i] == 0) {
-                        flags |= KMLSO_ContainsTransparentPixels;
-                    } else {
-                        flags |= KMLSO_ContainsPartiallyTransparentPixels;
+                        CPLError(CE_Failure, CPLE_FileIO, "Cannot write %s",
+                                 psJob->osFilename.c_str());
                     }
+                    VSIFCloseL(fp);
                 }
+                CPLFree(pabyData);
             }
         }
+        apoPendingJobs.pop_front();
     }
-    delete[] pabyScanline;
-    return flags;
+    if( nMaxRemainingJobs == 0 && poJobQueue )
+        poJobQueue->WaitCompletion();
+}
+
+/************************************************************************/
+/*                             ProcessTile()                            */
+/************************************************************************/
+
+// Generates the tile (ix, iy) of the zoom level and the tiles of the next
+// zoom levels it covers. Returns the pixels of the tile, and sets bGenerated
+// if a file has been written for it (empty tiles are skipped with
+// FORMAT=AUTO), and bHasChildKML if it has child tiles.
+std::shared_ptr<const KmlSuperOverlayTile>
+KmlSuperOverlayWriter::ProcessTile(int zoom, int ix, int iy,
+                                   bool& bGenerated, bool& bHasChildKML)
+{
+    bGenerated = false;
+    bHasChildKML = false;
+
+    // {((childx, childy), hasChildKML), ...}, in the order in which the tiles
+    // of a zoom level are listed
+    std::vector<std::pair<std::pair<int,int>,bool> > childTiles;
+    // Indexed as [left-bottom, right-bottom, left-top, right-top]
+    std::shared_ptr<const KmlSuperOverlayTile> apoChildren[4];
+    if (zoom < maxzoom)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            const int childx = 2 * ix + i;
+            if (childx >= anXLoop[zoom + 1])
+                continue;
+            for (int j = 0; j < 2; j++)
+            {
+                const int childy = 2 * iy + j;
+                if (childy >= anYLoop[zoom + 1])
+                    continue;
+                bool bChildGenerated = false;
+                bool bChildHasChildKML = false;
+                auto poChild = ProcessTile(zoom + 1, childx, childy,
+                                           bChildGenerated, bChildHasChildKML);
+                if (bBottomUp)
+                    apoChildren[i + 2 * j] = std::move(poChild);
+                if (bChildGenerated)
+                {
+                    childTiles.push_back(std::make_pair(
+                        std::make_pair(childx, childy), bChildHasChildKML));
+                }
+            }
+        }
+    }
+
+    const int rxsize = tilexsize * (1 << (maxzoom-zoom));
+    const int rysize = tileysize * (1 << (maxzoom-zoom));
+    const int rx = ix * rxsize;
+    const int ry = ysize - (iy * rysize) - rysize;
+    const int dxsize = tilexsize;
+    const int dysize = tileysize;
+
+    std::shared_ptr<const KmlSuperOverlayTile> poTile;
+    if (bBottomUp && zoom < maxzoom)
+        poTile = DownsampleTile(apoChildren, dxsize, dysize, bands);
+    else
+        poTile = ReadTile(rxsize, rysize, rx, ry, dxsize, dysize, bands, poSrcDS);
+    for (auto& poChild: apoChildren)
+        poChild.reset();
+
+    nTileCount ++;
+    pfnProgress(1.0 * nTileCount / nTotalTiles, "", pProgressData);
+
+    GDALDriver* poTileDriver = poOutputTileDriver;
+    bool bJpeg = isJpegDriver;
+    if (isAutoDriver)
+    {
+        int flags = DetectTransparency(*poTile, anNoData);
+        if ( flags & (KmlSuperOverlayReadDataset::KMLSO_ContainsPartiallyTransparentPixels | KmlSuperOverlayReadDataset::KMLSO_ContainsTransparentPixels) )
+        {
+            if (!(flags & (KmlSuperOverlayReadDataset::KMLSO_ContainsPartiallyTransparentPixels | KmlSuperOverlayReadDataset::KMLSO_ContainsOpaquePixels))) {
+                // don't bother creating empty tiles
+                return poTile;
+            }
+            poTileDriver = poPngOutputTileDriver;
+            bJpeg = false;
+        }
+        else
+        {
+            poTileDriver = poJpegOutputTileDriver;
+            bJpeg = true;
+        }
+    }
+
+    const std::string fileExt = bJpeg ? ".jpg" : ".png";
+    const std::string osBasename(
+        CPLSPrintf("%s/%d/%d/%d", outDir.c_str(), zoom, ix, iy));
+    SubmitEncodeJob(poTile, osBasename + fileExt, poTileDriver, bJpeg);
+
+    double tmpSouth = adfGeoTransform[3] + adfGeoTransform[5]*ysize;
+    double zoomxpix = zoomxpixels[zoom];
+    double zoomypix = zoomypixels[zoom];
+    if (zoomxpix == 0)
+    {
+        zoomxpix = 1;
+    }
+
+    if (zoomypix == 0)
+    {
+        zoomypix = 1;
+    }
+
+    // only create child KML if there are child tiles
+    bHasChildKML = !childTiles.empty();
+    GenerateChildKml(osBasename + ".kml", zoom, ix, iy, zoomxpix, zoomypix,
+                     dxsize, dysize, tmpSouth, adfGeoTransform[0],
+                     xsize, ysize, maxzoom, poTransform, fileExt, fixAntiMeridian,
+                     pszAltitude, pszAltitudeMode, childTiles);
+    bGenerated = true;
+
+    return poTile;
 }
 
 /************************************************************************/
@@ -758,7 +1155,6 @@ GDALDataset *KmlSuperOverlayCreateCopy( const char * pszFilename,
     }
 
     std::string tmpFileName;
-    std::vector<std::string> fileVector;
     int nRet;
 
     const char* pszOverlayName = CSLFetchNameValue(papszOptions, "NAME");
@@ -770,7 +1166,6 @@ GDALDataset *KmlSuperOverlayCreateCopy( const char * pszFilename,
         nRet = GenerateRootKml(tmpFileName.c_str(), pszFilename,
                                north, south, east, west, (int)tilexsize,
                                pszOverlayName, pszOverlayDescription);
-        fileVector.push_back(tmpFileName);
     }
     else
     {
@@ -823,26 +1218,54 @@ GDALDataset *KmlSuperOverlayCreateCopy( const char * pszFilename,
         }
     }
 
-    int zoom;
-    int nTotalTiles = 0;
-    int nTileCount = 0;
-
-    for (zoom = maxzoom; zoom >= 0; --zoom)
-    {
-        int rmaxxsize = tilexsize * (1 << (maxzoom-zoom));
-        int rmaxysize = tileysize * (1 << (maxzoom-zoom));
-
-        int xloop = (int)xsize/rmaxxsize;
-        int yloop = (int)ysize/rmaxysize;
-        nTotalTiles += xloop * yloop;
-    }
-
-    // {(x, y): [((childx, childy), hasChildKML), ...], ...}
-    std::map<std::pair<int,int>,std::vector<std::pair<std::pair<int,int>,bool> > > childTiles;
-    std::map<std::pair<int,int>,std::vector<std::pair<std::pair<int,int>,bool> > > currentTiles;
-    std::pair<int,int> childXYKey;
-    std::pair<int,int> parentXYKey;
-    for (zoom = maxzoom; zoom >= 0; --zoom)
+    KmlSuperOverlayWriter oWriter;
+    oWriter.poSrcDS = poSrcDS;
+    // JPEG tiles only use the 3 first bands
+    oWriter.bands = (isJpegDriver && bands == 4) ? 3 : bands;
+    for (int band = 1; band <= oWriter.bands; band++)
+    {
+        int hasNoData = 0;
+        const double noDataValue =
+            poSrcDS->GetRasterBand(band)->GetNoDataValue(&hasNoData);
+        oWriter.anNoData.push_back(hasNoData && !CPLIsNan(noDataValue) ?
+                                   static_cast<int>(noDataValue) : INT_MIN);
+    }
+    // When the source has overviews, reading it at each zoom level is cheap
+    // and takes advantage of their resampling.
+    oWriter.bBottomUp =
+        poSrcDS->GetRasterBand(1)->GetOverviewCount() == 0;
+    oWriter.xsize = xsize;
+    oWriter.ysize = ysize;
+    oWriter.tilexsize = tilexsize;
+    oWriter.tileysize = tileysize;
+    oWriter.maxzoom = maxzoom;
+    oWriter.outDir = outDir;
+    oWriter.isKmz = isKmz;
+    oWriter.isAutoDriver = isAutoDriver;
+    oWriter.isJpegDriver = isJpegDriver;
+    oWriter.poOutputTileDriver = poOutputTileDriver;
+    oWriter.poJpegOutputTileDriver = poJpegOutputTileDriver;
+    oWriter.poPngOutputTileDriver = poPngOutputTileDriver;
+    oWriter.poMemDriver = poMemDriver;
+    memcpy(oWriter.adfGeoTransform, adfGeoTransform, sizeof(adfGeoTransform));
+    oWriter.zoomxpixels = zoomxpixels;
+    oWriter.zoomypixels = zoomypixels;
+    oWriter.poTransform = poTransform;
+    oWriter.fixAntiMeridian = fixAntiMeridian;
+    oWriter.pszAltitude = pszAltitude;
+    oWriter.pszAltitudeMode = pszAltitudeMode;
+    oWriter.pfnProgress = pfnProgress;
+    oWriter.pProgressData = pProgressData;
+
+    const char* pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszNumThreads != nullptr )
+    {
+        int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+            CPLGetNumCPUs() : atoi(pszNumThreads);
+        oWriter.SetNumThreads(std::max(1, std::min(128, nThreads)));
+    }
+
+    for (int zoom = 0; zoom <= maxzoom; zoom++)
     {
         int rmaxxsize = tilexsize * (1 << (maxzoom-zoom));
         int rmaxysize = tileysize * (1 << (maxzoom-zoom));
@@ -853,108 +1276,38 @@ GDALDataset *KmlSuperOverlayCreateCopy( const char * pszFilename,
         xloop = xloop>0 ? xloop : 1;
         yloop = yloop>0 ? yloop : 1;
 
-        std::stringstream zoomStr;
-        zoomStr << zoom;
+        oWriter.anXLoop.push_back(xloop);
+        oWriter.anYLoop.push_back(yloop);
+        oWriter.nTotalTiles += xloop * yloop;
 
-        std::string zoomDir = outDir;
-        zoomDir+= "/" + zoomStr.str();
+        std::string zoomDir = CPLSPrintf("%s/%d", outDir.c_str(), zoom);
         VSIMkdir(zoomDir.c_str(), 0775);
-
         for (int ix = 0; ix < xloop; ix++)
         {
-            int rxsize = (int)(rmaxxsize);
-            int rx = (int)(ix * rmaxxsize);
-            int dxsize = (int)(rxsize/rmaxxsize * tilexsize);
-
-            std::stringstream ixStr;
-            ixStr << ix;
-
-            zoomDir = outDir;
-            zoomDir+= "/" + zoomStr.str();
-            zoomDir+= "/" + ixStr.str();
-            VSIMkdir(zoomDir.c_str(), 0775);
+            VSIMkdir(CPLSPrintf("%s/%d", zoomDir.c_str(), ix), 0775);
+        }
+    }
 
-            for (int iy = 0; iy < yloop; iy++)
+    // Start from the tiles that are not covered by a tile of the previous
+    // zoom level. The tiles they cover are generated first.
+    for (int zoom = 0; zoom <= maxzoom; zoom++)
+    {
+        for (int ix = 0; ix < oWriter.anXLoop[zoom]; ix++)
+        {
+            for (int iy = 0; iy < oWriter.anYLoop[zoom]; iy++)
             {
-                int rysize = (int)(rmaxysize);
-                int ry = (int)(ysize - (iy * rmaxysize)) - rysize;
-                int dysize = (int)(rysize/rmaxysize * tileysize);
-
-                std::stringstream iyStr;
-                iyStr << iy;
-
-                if (isAutoDriver)
-                {
-                    int flags = KmlSuperOverlayReadDataset::DetectTransparency(rxsize, rysize, rx, ry, dxsize, dysize, poSrcDS);
-                    if ( flags & (KmlSuperOverlayReadDataset::KMLSO_ContainsPartiallyTransparentPixels | KmlSuperOverlayReadDataset::KMLSO_ContainsTransparentPixels) )
-                    {
-                        if (!(flags & (KmlSuperOverlayReadDataset::KMLSO_ContainsPartiallyTransparentPixels | KmlSuperOverlayReadDataset::KMLSO_ContainsOpaquePixels))) {
-                            // don't bother creating empty tiles
-                            continue;
-                        }
-                        poOutputTileDriver = poPngOutputTileDriver;
-                        isJpegDriver = false;
-                    }
-                    else
-                    {
-                        poOutputTileDriver = poJpegOutputTileDriver;
-                        isJpegDriver = true;
-                    }
-                }
-
-                std::string fileExt = ".jpg";
-                if (isJpegDriver == false)
-                {
-                    fileExt = ".png";
-                }
-                std::string filename = zoomDir + "/" + iyStr.str() + fileExt;
-                if (isKmz)
-                {
-                    fileVector.push_back(filename);
-                }
-
-                GenerateTiles(filename, zoom, rxsize, rysize, ix, iy, rx, ry, dxsize,
-                              dysize, bands, poSrcDS, poOutputTileDriver, poMemDriver, isJpegDriver);
-                std::string childKmlfile = zoomDir + "/" + iyStr.str() + ".kml";
-                if (isKmz)
-                {
-                    fileVector.push_back(childKmlfile);
-                }
-
-                double tmpSouth = adfGeoTransform[3] + adfGeoTransform[5]*ysize;
-                double zoomxpix = zoomxpixels[zoom];
-                double zoomypix = zoomypixels[zoom];
-                if (zoomxpix == 0)
-                {
-                    zoomxpix = 1;
-                }
-
-                if (zoomypix == 0)
+                if (zoom > 0 && ix / 2 < oWriter.anXLoop[zoom - 1] &&
+                    iy / 2 < oWriter.anYLoop[zoom - 1])
                 {
-                    zoomypix = 1;
-                }
-
-                childXYKey = std::make_pair(ix, iy);
-                parentXYKey = std::make_pair(ix / 2, iy / 2);
-
-                // only create child KML if there are child tiles
-                bool hasChildKML = !childTiles[childXYKey].empty();
-                if (!currentTiles.count(parentXYKey)) {
-                    currentTiles[parentXYKey] = std::vector<std::pair<std::pair<int,int>,bool> >();
+                    continue;
                 }
-                currentTiles[parentXYKey].push_back(std::make_pair(std::make_pair(ix, iy), hasChildKML));
-                GenerateChildKml(childKmlfile, zoom, ix, iy, zoomxpix, zoomypix,
-                                 dxsize, dysize, tmpSouth, adfGeoTransform[0],
-                                 xsize, ysize, maxzoom, poTransform, fileExt, fixAntiMeridian,
-                                 pszAltitude, pszAltitudeMode, childTiles[childXYKey]);
-
-                nTileCount ++;
-                pfnProgress(1.0 * nTileCount / nTotalTiles, "", pProgressData);
+                bool bGenerated = false;
+                bool bHasChildKML = false;
+                oWriter.ProcessTile(zoom, ix, iy, bGenerated, bHasChildKML);
             }
         }
-        childTiles = currentTiles;
-        currentTiles.clear();
     }
+    oWriter.WaitForJobs(0);
 
     OGRCoordinateTransformation::DestroyCT( poTransform );
     poTransform = nullptr;
@@ -89,8 +89,6 @@ class KmlSuperOverlayReadDataset final: public GDALDataset
     static const int KMLSO_ContainsTransparentPixels = 0x2;
     static const int KMLSO_ContainsPartiallyTransparentPixels = 0x4;
 
-    static int DetectTransparency( int rxsize, int rysize, int rx, int ry, int dxsize, int dysize, GDALDataset* poSrcDs );
-
     virtual CPLErr GetGeoTransform( double * ) override;
     virtual const char *_GetProjectionRef() override;
     const OGRSpatialReference* GetSpatialRef() const override {
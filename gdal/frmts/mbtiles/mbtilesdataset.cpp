@@ -40,6 +40,7 @@
 #include "gdal_utils.h"
 #include "gdalwarper.h"
 #include "mvtutils.h"
+#include "tilematrixset.hpp"
 
 #include "zlib.h"
 #include "ogrgeojsonreader.h"
@@ -2833,6 +2834,8 @@ GDALDataset* MBTilesDataset::Open(GDALOpenInfo* poOpenInfo)
 
             poDS->ParseCompressionOptions(poOpenInfo->papszOpenOptions);
         }
+        if( pszFormat == nullptr || !EQUAL(pszFormat, "pbf") )
+            poDS->InitializeWorkerThreads(poOpenInfo->papszOpenOptions);
 
 /* -------------------------------------------------------------------- */
 /*      Add overview levels as internal datasets                        */
@@ -3038,6 +3041,7 @@ bool MBTilesDataset::CreateInternal( const char * pszFilename,
         SetBand( i, new MBTilesBand(this, nBlockSize) );
 
     ParseCompressionOptions(papszOptions);
+    InitializeWorkerThreads(papszOptions);
 
     return true;
 }
@@ -3191,22 +3195,17 @@ GDALDataset* MBTilesDataset::CreateCopy( const char *pszFilename,
         }
     }
 
-    int nZoomLevel;
-    double dfComputedRes = adfGeoTransform[1];
-    double dfPrevRes = 0.0;
-    double dfRes = 0.0;
     int nBlockSize = std::max(64,
         std::min(8192,atoi(CSLFetchNameValueDef(papszOptions,
                     "BLOCKSIZE", CPLSPrintf("%d", knDEFAULT_BLOCK_SIZE)))));
     const double dfPixelXSizeZoomLevel0 = 2 * MAX_GM / nBlockSize;
-    for(nZoomLevel = 0; nZoomLevel < 25; nZoomLevel++)
-    {
-        dfRes = dfPixelXSizeZoomLevel0 / (1 << nZoomLevel);
-        if( dfComputedRes > dfRes )
-            break;
-        dfPrevRes = dfRes;
-    }
-    if( nZoomLevel == 25 )
+    std::vector<double> adfResolutions;
+    for( int i = 0; i < 25; i++ )
+        adfResolutions.push_back(dfPixelXSizeZoomLevel0 / (1 << i));
+    const int nZoomLevel = gdal::TileMatrixSet::selectZoomLevel(
+        adfResolutions, adfGeoTransform[1],
+        CSLFetchNameValue(papszOptions, "ZOOM_LEVEL_STRATEGY"));
+    if( nZoomLevel < 0 )
     {
         CPLError(CE_Failure, CPLE_AppDefined,
                  "Could not find an appropriate zoom level");
@@ -3214,28 +3213,7 @@ GDALDataset* MBTilesDataset::CreateCopy( const char *pszFilename,
         return nullptr;
     }
 
-    const char* pszZoomLevelStrategy = CSLFetchNameValueDef(papszOptions,
-                                                            "ZOOM_LEVEL_STRATEGY",
-                                                            "AUTO");
-    if( fabs( dfComputedRes - dfRes ) / dfRes > 1e-8 )
-    {
-        if( EQUAL(pszZoomLevelStrategy, "LOWER") )
-        {
-            if( nZoomLevel > 0 )
-                nZoomLevel --;
-        }
-        else if( EQUAL(pszZoomLevelStrategy, "UPPER") )
-        {
-            /* do nothing */
-        }
-        else if( nZoomLevel > 0 )
-        {
-            if( dfPrevRes / dfComputedRes < dfComputedRes / dfRes )
-                nZoomLevel --;
-        }
-    }
-
-    dfRes = dfPixelXSizeZoomLevel0 / (1 << nZoomLevel);
+    const double dfRes = adfResolutions[nZoomLevel];
 
     double dfMinX = adfExtent[0];
     double dfMinY = adfExtent[1];
@@ -3300,92 +3278,16 @@ GDALDataset* MBTilesDataset::CreateCopy( const char *pszFilename,
         poDS->GetRasterBand(1)->SetColorTable( poSrcDS->GetRasterBand(1)->GetColorTable() );
     }
 
-    hTransformArg =
-        GDALCreateGenImgProjTransformer2( poSrcDS, poDS, papszTO );
+    const CPLErr eErr = GDALGPKGMBTilesWarpToTiles(
+        poSrcDS, poDS, papszTO, eResampleAlg, GDT_Byte,
+        false, nullptr, papszOptions, pfnProgress, pProgressData );
     CSLDestroy(papszTO);
-    if( hTransformArg == nullptr )
-    {
-        CPLError(CE_Failure, CPLE_AppDefined, "GDALCreateGenImgProjTransformer2 failed");
-        delete poDS;
-        return nullptr;
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Warp the transformer with a linear approximator                 */
-/* -------------------------------------------------------------------- */
-    hTransformArg =
-        GDALCreateApproxTransformer( GDALGenImgProjTransform,
-                                     hTransformArg, 0.125 );
-    GDALApproxTransformerOwnsSubtransformer(hTransformArg, TRUE);
-
-/* -------------------------------------------------------------------- */
-/*      Setup warp options.                                             */
-/* -------------------------------------------------------------------- */
-    GDALWarpOptions *psWO = GDALCreateWarpOptions();
-
-    psWO->papszWarpOptions = CSLSetNameValue(nullptr, "OPTIMIZE_SIZE", "YES");
-    psWO->eWorkingDataType = GDT_Byte;
-
-    psWO->eResampleAlg = eResampleAlg;
-
-    psWO->hSrcDS = poSrcDS;
-    psWO->hDstDS = poDS;
-
-    psWO->pfnTransformer = GDALApproxTransform;
-    psWO->pTransformerArg = hTransformArg;
-
-    psWO->pfnProgress = pfnProgress;
-    psWO->pProgressArg = pProgressData;
-
-/* -------------------------------------------------------------------- */
-/*      Setup band mapping.                                             */
-/* -------------------------------------------------------------------- */
-
-    if( nBands == 2 || nBands == 4 )
-        psWO->nBandCount = nBands - 1;
-    else
-        psWO->nBandCount = nBands;
-
-    psWO->panSrcBands = (int *) CPLMalloc(psWO->nBandCount*sizeof(int));
-    psWO->panDstBands = (int *) CPLMalloc(psWO->nBandCount*sizeof(int));
-
-    for( int i = 0; i < psWO->nBandCount; i++ )
-    {
-        psWO->panSrcBands[i] = i+1;
-        psWO->panDstBands[i] = i+1;
-    }
-
-    if( nBands == 2 || nBands == 4 )
-    {
-        psWO->nSrcAlphaBand = nBands;
-    }
-    if( nTargetBands == 2 || nTargetBands == 4 )
-    {
-        psWO->nDstAlphaBand = nTargetBands;
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Initialize and execute the warp.                                */
-/* -------------------------------------------------------------------- */
-    GDALWarpOperation oWO;
-
-    CPLErr eErr = oWO.Initialize( psWO );
-    if( eErr == CE_None )
-    {
-        /*if( bMulti )
-            eErr = oWO.ChunkAndWarpMulti( 0, 0, nXSize, nYSize );
-        else*/
-        eErr = oWO.ChunkAndWarpImage( 0, 0, nXSize, nYSize );
-    }
     if (eErr != CE_None)
     {
         delete poDS;
         poDS = nullptr;
     }
 
-    GDALDestroyTransformer( hTransformArg );
-    GDALDestroyWarpOptions( psWO );
-
     return poDS;
 }
 
@@ -3601,6 +3503,7 @@ void GDALRegister_MBTiles()
 "  <Option name='QUALITY' scope='raster' type='int' min='1' max='100' description='Quality for JPEG tiles' default='75'/>" \
 "  <Option name='ZLEVEL' scope='raster' type='int' min='1' max='9' description='DEFLATE compression level for PNG tiles' default='6'/>" \
 "  <Option name='DITHER' scope='raster' type='boolean' description='Whether to apply Floyd-Steinberg dithering (for TILE_FORMAT=PNG8)' default='NO'/>" \
+"  <Option name='NUM_THREADS' scope='raster' type='string' description='Number of worker threads for tile encoding/decoding. Can be set to ALL_CPUS' default='1'/>" \
 
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST, "<OpenOptionList>"
 "  <Option name='ZOOM_LEVEL' scope='raster,vector' type='integer' description='Zoom level of full resolution. If not specified, maximum non-empty zoom level'/>"
@@ -236,6 +236,52 @@ CPLErr MEMRasterBand::IWriteBlock( CPL_UNUSED int nBlockXOff,
     return CE_None;
 }
 
+/************************************************************************/
+/*                            MEMCopyLines()                            */
+/*                                                                      */
+/*      Copy a window between the band memory and a user buffer.        */
+/*      Contiguous lines of the same data type are copied with a        */
+/*      single memcpy(), other layouts line by line with                */
+/*      GDALCopyWords(), which handles strides and type conversions.    */
+/************************************************************************/
+
+static void MEMCopyLines( const GByte *pabySrc, GDALDataType eSrcType,
+                          GSpacing nSrcPixelSpace, GSpacing nSrcLineSpace,
+                          GByte *pabyDst, GDALDataType eDstType,
+                          GSpacing nDstPixelSpace, GSpacing nDstLineSpace,
+                          int nWordCount, int nLineCount )
+{
+    const int nWordSize = GDALGetDataTypeSizeBytes(eSrcType);
+    const GSpacing nLineBytes = static_cast<GSpacing>(nWordCount) * nWordSize;
+    if( eSrcType == eDstType &&
+        nSrcPixelSpace == nWordSize && nDstPixelSpace == nWordSize )
+    {
+        if( nSrcLineSpace == nLineBytes && nDstLineSpace == nLineBytes )
+        {
+            memcpy( pabyDst, pabySrc,
+                    static_cast<size_t>(nLineBytes) * nLineCount );
+            return;
+        }
+        for( int iLine = 0; iLine < nLineCount; iLine++ )
+        {
+            memcpy( pabyDst + nDstLineSpace * static_cast<GPtrDiff_t>(iLine),
+                    pabySrc + nSrcLineSpace * static_cast<GPtrDiff_t>(iLine),
+                    static_cast<size_t>(nLineBytes) );
+        }
+        return;
+    }
+
+    for( int iLine = 0; iLine < nLineCount; iLine++ )
+    {
+        GDALCopyWords(
+            pabySrc + nSrcLineSpace * static_cast<GPtrDiff_t>(iLine),
+            eSrcType, static_cast<int>(nSrcPixelSpace),
+            pabyDst + nDstLineSpace * static_cast<GPtrDiff_t>(iLine),
+            eDstType, static_cast<int>(nDstPixelSpace),
+            nWordCount );
+    }
+}
+
 /************************************************************************/
 /*                             IRasterIO()                              */
 /************************************************************************/
@@ -258,40 +304,31 @@ CPLErr MEMRasterBand::IRasterIO( GDALRWFlag eRWFlag,
                                          psExtraArg);
     }
 
-    // In case block based I/O has been done before.
-    FlushCache();
-
+    GByte* pabyWindow = pabyData +
+        nLineOffset * static_cast<GPtrDiff_t>(nYOff) +
+        nXOff * nPixelOffset;
     if( eRWFlag == GF_Read )
     {
-        for( int iLine=0; iLine < nYSize; iLine++ )
-        {
-            GDALCopyWords(
-                pabyData + nLineOffset*static_cast<GPtrDiff_t>(iLine + nYOff) +
-                nXOff*nPixelOffset,
-                eDataType,
-                static_cast<int>(nPixelOffset),
-                reinterpret_cast<GByte*>( pData ) +
-                nLineSpaceBuf * static_cast<GPtrDiff_t>(iLine),
-                eBufType,
-                static_cast<int>(nPixelSpaceBuf),
-                nXSize );
-        }
+        // In case block based writing has been done before. Reads do not
+        // touch the block cache otherwise, so that several threads can
+        // read the band concurrently.
+        if( HasDirtyBlocks() )
+            FlushCache();
+
+        MEMCopyLines( pabyWindow, eDataType, nPixelOffset, nLineOffset,
+                      static_cast<GByte *>(pData), eBufType,
+                      nPixelSpaceBuf, nLineSpaceBuf,
+                      nXSize, nYSize );
     }
     else
     {
-        for( int iLine = 0; iLine < nYSize; iLine++ )
-        {
-            GDALCopyWords(
-                reinterpret_cast<GByte *>( pData ) +
-                nLineSpaceBuf*static_cast<GPtrDiff_t>(iLine),
-                eBufType,
-                static_cast<int>(nPixelSpaceBuf),
-                pabyData + nLineOffset*static_cast<GPtrDiff_t>(iLine + nYOff) +
-                nXOff*nPixelOffset,
-                eDataType,
-                static_cast<int>(nPixelOffset),
-                nXSize );
-        }
+        // In case block based I/O has been done before.
+        FlushCache();
+
+        MEMCopyLines( static_cast<const GByte *>(pData), eBufType,
+                      nPixelSpaceBuf, nLineSpaceBuf,
+                      pabyWindow, eDataType, nPixelOffset, nLineOffset,
+                      nXSize, nYSize );
     }
     return CE_None;
 }
@@ -352,40 +389,30 @@ CPLErr MEMDataset::IRasterIO( GDALRWFlag eRWFlag,
         }
         if( iBandIndex == nBandCount )
         {
-            FlushCache();
+            GByte* pabyWindow = pabyData +
+                nLineOffset * static_cast<GPtrDiff_t>(nYOff) +
+                nXOff * nPixelOffset;
             if( eRWFlag == GF_Read )
             {
-                for(int iLine=0;iLine<nYSize;iLine++)
+                for( int i = 0; i < nBands; i++ )
                 {
-                    GDALCopyWords(
-                        pabyData +
-                        nLineOffset*static_cast<size_t>(iLine + nYOff) +
-                        nXOff*nPixelOffset,
-                        eDT,
-                        eDTSize,
-                        reinterpret_cast<GByte *>( pData ) +
-                        nLineSpaceBuf * static_cast<size_t>(iLine),
-                        eBufType,
-                        eBufTypeSize,
-                        nXSize * nBands );
+                    MEMRasterBand *poBand = reinterpret_cast<MEMRasterBand *>(
+                        GetRasterBand(i + 1) );
+                    if( poBand->HasDirtyBlocks() )
+                        poBand->FlushCache();
                 }
+                MEMCopyLines( pabyWindow, eDT, eDTSize, nLineOffset,
+                              static_cast<GByte *>(pData), eBufType,
+                              eBufTypeSize, nLineSpaceBuf,
+                              nXSize * nBands, nYSize );
             }
             else
             {
-                for(int iLine=0;iLine<nYSize;iLine++)
-                {
-                    GDALCopyWords(
-                        reinterpret_cast<GByte *>( pData ) +
-                        nLineSpaceBuf*(size_t)iLine,
-                        eBufType,
-                        eBufTypeSize,
-                        pabyData +
-                        nLineOffset * static_cast<size_t>(iLine + nYOff) +
-                        nXOff*nPixelOffset,
-                        eDT,
-                        eDTSize,
-                        nXSize * nBands);
-                }
+                FlushCache();
+                MEMCopyLines( static_cast<const GByte *>(pData), eBufType,
+                              eBufTypeSize, nLineSpaceBuf,
+                              pabyWindow, eDT, eDTSize, nLineOffset,
+                              nXSize * nBands, nYSize );
             }
             return CE_None;
         }
@@ -332,7 +332,6 @@ CPLErr PNG_Band::Compress(buf_mgr &dst, buf_mgr &src)
         ResetPalette(poCT, codec);
     }
 
-    codec.deflate_flags = deflate_flags;
     return codec.CompressPNG(dst, src);
 }
 
@@ -345,7 +344,11 @@ PNG_Band::PNG_Band( MRFDataset *pDS, const ILImage &image,
                     int b, int level ) :
     MRFRasterBand(pDS, image, b, level),
     codec(image)
-{   // Check error conditions
+{
+    // Set once, pages can be compressed by multiple threads
+    codec.deflate_flags = deflate_flags;
+
+    // Check error conditions
     if (image.dt != GDT_Byte && image.dt != GDT_Int16 && image.dt != GDT_UInt16)
     {
         CPLError(CE_Failure, CPLE_NotSupported,
@@ -51,8 +51,12 @@
 #include "gdal_pam.h"
 #include "ogr_srs_api.h"
 #include "ogr_spatialref.h"
+#include "cpl_worker_thread_pool.h"
 
+#include <atomic>
+#include <deque>
 #include <limits>
+#include <memory>
 // For printing values
 #include <ostream>
 #include <iostream>
@@ -300,6 +304,35 @@ enum { SAMPLING_ERR, SAMPLING_Avg, SAMPLING_Near };
 
 MRFRasterBand *newMRFRasterBand(MRFDataset *, const ILImage &, int, int level = 0);
 
+// A page encoded or decoded by a worker thread
+struct MRFPageJob {
+    MRFPageJob() = default;
+    ~MRFPageJob() {
+        CPLFree(src.buffer);
+        CPLFree(outbuff);
+    }
+
+    // Null for an empty page write
+    MRFRasterBand *band = nullptr;
+    int xblk = 0, yblk = 0;
+    // Index record of a page to write
+    GUIntBig infooffset = 0;
+    // Block receiving a decoded page, locked while the job runs
+    GDALRasterBlock *block = nullptr;
+    // Input page, owned
+    buf_mgr src = { nullptr, 0 };
+    // Output buffer for encoding, owned
+    void *outbuff = nullptr;
+    // Output page
+    buf_mgr dst = { nullptr, 0 };
+    CPLErr ret = CE_None;
+    CPLString errmsg;
+    std::atomic<bool> done{false};
+
+private:
+    CPL_DISALLOW_COPY_ASSIGN(MRFPageJob)
+};
+
 class MRFDataset final: public GDALPamDataset {
     friend class MRFRasterBand;
     friend MRFRasterBand *newMRFRasterBand(MRFDataset *, const ILImage &, int, int level);
@@ -363,6 +396,8 @@ public:
     void SetPBufferSize(unsigned int sz) { pbsize = sz; }
     unsigned int GetPBufferSize() { return pbsize; }
 
+    virtual void FlushCache() override;
+
 protected:
     // False if it failed
     int Crystalize();
@@ -378,6 +413,9 @@ protected:
     // Called once before the parsing of the XML, should just capture the options in dataset variables
     void ProcessOpenOptions(char **papszOptions);
 
+    // Parse a NUM_THREADS value, ignored if null
+    void SetNumThreads(const char *val);
+
     // Writes the XML tree as MRF.  It does not check the content
     int WriteConfig(CPLXMLNode *);
 
@@ -413,6 +451,19 @@ protected:
     // Write a tile, the infooffset is the relative position in the index file
     virtual CPLErr WriteTile(void *buff, GUIntBig infooffset, GUIntBig size = 0);
 
+    // Worker threads, created on first use, null if not available
+    CPLJobQueue *GetJobQueue();
+
+    // Queue a page write, the page is encoded by a worker thread if it has a band
+    CPLErr SubmitTile(std::unique_ptr<MRFPageJob> job);
+
+    // Write the encoded pages in submission order, until at most maxPending are left
+    CPLErr WritePendingTiles(size_t maxPending = 0);
+
+    // Decode in parallel the pages of a read window that are not in the block cache
+    void PrefetchBlocks(const std::vector<MRFRasterBand *> &bands,
+        int nXOff, int nYOff, int nXSize, int nYSize);
+
     // Custom CopyWholeRaster for Zen JPEG
     CPLErr ZenCopy(GDALDataset *poSrc, GDALProgressFunc pfnProgress, void * pProgressData);
 
@@ -466,6 +517,11 @@ protected:
     int spacing;      // How many spare bytes before each tile data
     int no_errors;    // Ignore read errors
     int missing;      // set if no_errors is set and data is missing
+    int num_threads;  // Threads used to encode and decode pages
+
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    // Pages being encoded, written in order
+    std::deque<std::unique_ptr<MRFPageJob>> pendingTiles;
 
     // Freeform sticky dataset options, as a list of key-value pairs
     CPLStringList optlist;
@@ -549,6 +605,10 @@ public:
     void SetAccess(GDALAccess eA) { eAccess = eA; }
     void SetDeflate(int v) { dodeflate = (v != 0); }
 
+    virtual CPLErr IRasterIO(GDALRWFlag, int, int, int, int,
+        void *, int, int, GDALDataType,
+        GSpacing, GSpacing, GDALRasterIOExtraArg*) override;
+
 protected:
     // Pointer to the GDALMRFDataset
     MRFDataset *poDS;
@@ -578,6 +638,16 @@ protected:
     virtual CPLErr Compress(buf_mgr &dst, buf_mgr &src) = 0;
     virtual CPLErr Decompress(buf_mgr &dst, buf_mgr &src) = 0;
 
+    // Inflate if needed, decompress and swap a stored page, src is not modified
+    CPLErr DecodePage(buf_mgr &dst, buf_mgr &src);
+
+    // Can pages be encoded and decoded by worker threads
+    bool CanUseThreads() const;
+
+    // Worker thread functions, the argument is a MRFPageJob
+    static void EncodePageFunc(void *pData);
+    static void DecodePageFunc(void *pData);
+
     // Read the index record itself, can be overwritten
     //    virtual CPLErr ReadTileIdx(const ILSize &, ILIdx &, GIntBig bias = 0);
 
@@ -51,6 +51,7 @@
 #include "marfa.h"
 #include "cpl_multiproc.h" /* for CPLSleep() */
 #include "gdal_priv.h"
+#include "gdal_thread_pool.h"
 #include <assert.h>
 
 #include <algorithm>
@@ -75,6 +76,7 @@ MRFDataset::MRFDataset() :
     spacing(0),
     no_errors(0),
     missing(0),
+    num_threads(1),
     poSrcDS(nullptr),
     level(-1),
     cds(nullptr),
@@ -94,6 +96,16 @@ MRFDataset::MRFDataset() :
     ifp.FP = dfp.FP = nullptr;
     dfp.acc = GF_Read;
     ifp.acc = GF_Read;
+    SetNumThreads(CPLGetConfigOption("GDAL_NUM_THREADS", nullptr));
+}
+
+// Number of threads from a NUM_THREADS value, a number or ALL_CPUS
+void MRFDataset::SetNumThreads(const char *val)
+{
+    if (val == nullptr)
+        return;
+    int n = EQUAL(val, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(val);
+    num_threads = std::max(1, std::min(n, 128));
 }
 
 bool MRFDataset::SetPBuffer(unsigned int sz) {
@@ -176,6 +188,16 @@ CPLErr MRFDataset::IRasterIO(GDALRWFlag eRWFlag, int nXOff, int nYOff, int nXSiz
         return CE_Failure;
     }
 
+    // Decode the pages of all the bands in parallel, unless this is a single level view
+    if (eRWFlag == GF_Read && nBufXSize == nXSize && nBufYSize == nYSize
+        && num_threads > 1 && cds == nullptr) {
+        std::vector<MRFRasterBand *> bands;
+        for (int i = 0; i < nBandCount; i++)
+            bands.push_back(static_cast<MRFRasterBand *>(GetRasterBand(panBandMap[i])));
+        if (!bands.empty() && bands[0]->CanUseThreads())
+            PrefetchBlocks(bands, nXOff, nYOff, nXSize, nYSize);
+    }
+
     //
     // Call the parent implementation, which splits it into bands and calls their IRasterIO
     //
@@ -183,6 +205,172 @@ CPLErr MRFDataset::IRasterIO(GDALRWFlag eRWFlag, int nXOff, int nYOff, int nXSiz
         eBufType, nBandCount, panBandMap, nPixelSpace, nLineSpace, nBandSpace, psExtraArgs);
 }
 
+// Commits the block cache, then the pages still being encoded
+void MRFDataset::FlushCache()
+{
+    GDALPamDataset::FlushCache();
+    WritePendingTiles();
+}
+
+CPLJobQueue *MRFDataset::GetJobQueue()
+{
+    if (!poJobQueue) {
+        CPLWorkerThreadPool *pool = GDALGetGlobalThreadPool(num_threads);
+        if (pool)
+            poJobQueue = pool->CreateJobQueue();
+    }
+    return poJobQueue.get();
+}
+
+// The job is encoded by a worker thread, or by this one if there is no thread pool
+CPLErr MRFDataset::SubmitTile(std::unique_ptr<MRFPageJob> job)
+{
+    MRFPageJob *pjob = job.get();
+    pendingTiles.push_back(std::move(job));
+    if (nullptr == pjob->band)
+        pjob->done = true;
+    else {
+        CPLJobQueue *queue = GetJobQueue();
+        if (!queue || !queue->SubmitJob(MRFRasterBand::EncodePageFunc, pjob))
+            MRFRasterBand::EncodePageFunc(pjob);
+    }
+
+    // Bound the memory held by the pages in flight
+    return WritePendingTiles(2 * static_cast<size_t>(num_threads));
+}
+
+// Pages are written in the order they were submitted, so a page written
+// twice ends up with the last content
+CPLErr MRFDataset::WritePendingTiles(size_t maxPending)
+{
+    CPLErr ret = CE_None;
+    while (!pendingTiles.empty()) {
+        MRFPageJob *job = pendingTiles.front().get();
+        if (!job->done) {
+            if (pendingTiles.size() <= maxPending)
+                break;
+            // Wait for at least one more page, it might not be the first one
+            int running = 0;
+            for (const auto &pending : pendingTiles)
+                if (!pending->done)
+                    running++;
+            poJobQueue->WaitCompletion(running - 1);
+            continue;
+        }
+
+        if (CE_None == job->ret) {
+            if (CE_None != WriteTile(job->dst.buffer, job->infooffset, job->dst.size))
+                ret = CE_Failure;
+        }
+        else {
+            CPLError(CE_Failure, CPLE_AppDefined, "%s", job->errmsg.c_str());
+            ret = CE_Failure;
+        }
+        pendingTiles.pop_front();
+    }
+    return ret;
+}
+
+/**
+*\brief Decode in parallel the pages of a read window
+*
+* Only used for separate bands, all bands have the same level. The stored pages
+* are read by this thread and decoded by worker threads, directly in the block cache.
+* Pages that are missing, can't be read or fail to decode are left to IReadBlock,
+* which reports the errors or fills the block.
+*/
+
+void MRFDataset::PrefetchBlocks(const std::vector<MRFRasterBand *> &bands,
+    int nXOff, int nYOff, int nXSize, int nYSize)
+{
+    if (bands.empty() || nXSize < 1 || nYSize < 1)
+        return;
+
+    // Pages still being encoded have to reach the disk first
+    if (CE_None != WritePendingTiles())
+        return;
+
+    const ILImage &img = bands[0]->img;
+    const int bx = img.pagesize.x;
+    const int by = img.pagesize.y;
+    const int x0 = nXOff / bx;
+    const int x1 = (nXOff + nXSize - 1) / bx;
+    const int y0 = nYOff / by;
+    const int y1 = (nYOff + nYSize - 1) / by;
+
+    // The decoded blocks have to stay in the block cache until they get used
+    const GIntBig blocks = static_cast<GIntBig>(x1 - x0 + 1) * (y1 - y0 + 1) * bands.size();
+    if (blocks < 2 || blocks * img.pageSizeBytes > GDALGetCacheMax64() / 4)
+        return;
+
+    VSILFILE *l_dfp = DataFP();
+    CPLJobQueue *queue = GetJobQueue();
+    if (nullptr == l_dfp || nullptr == queue)
+        return;
+
+    std::vector<std::unique_ptr<MRFPageJob>> jobs;
+    const size_t batch = 4 * static_cast<size_t>(num_threads);
+
+    auto decodeBatch = [&]() {
+        for (auto &job : jobs)
+            if (!queue->SubmitJob(MRFRasterBand::DecodePageFunc, job.get()))
+                MRFRasterBand::DecodePageFunc(job.get());
+        queue->WaitCompletion();
+        for (auto &job : jobs) {
+            job->block->DropLock();
+            // Drop the block, IReadBlock will try again
+            if (CE_None != job->ret)
+                job->band->FlushBlock(job->xblk, job->yblk, FALSE);
+        }
+        jobs.clear();
+    };
+
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    for (auto band : bands) {
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                GDALRasterBlock *poBlock = band->TryGetLockedBlockRef(x, y);
+                if (poBlock) { // Already cached
+                    poBlock->DropLock();
+                    continue;
+                }
+
+                ILIdx tinfo;
+                tinfo.size = 0;
+                ILSize req(x, y, 0, band->nBand - 1, band->m_l);
+                if (CE_None != ReadTileIdx(tinfo, req, band->img)
+                    || tinfo.size <= 0 || tinfo.size > pbsize * 2)
+                    continue;
+
+                std::unique_ptr<MRFPageJob> job(new MRFPageJob());
+                job->band = band;
+                job->xblk = x;
+                job->yblk = y;
+                job->src.size = static_cast<size_t>(tinfo.size);
+                job->src.buffer = static_cast<char *>(VSIMalloc(job->src.size + PADDING_BYTES));
+                if (nullptr == job->src.buffer)
+                    continue;
+                VSIFSeekL(l_dfp, tinfo.offset, SEEK_SET);
+                if (1 != VSIFReadL(job->src.buffer, job->src.size, 1, l_dfp))
+                    continue;
+                memset(job->src.buffer + job->src.size, 0, PADDING_BYTES);
+
+                job->block = band->GetLockedBlockRef(x, y, TRUE);
+                if (nullptr == job->block)
+                    continue;
+                job->dst.buffer = static_cast<char *>(job->block->GetDataRef());
+                job->dst.size = static_cast<size_t>(img.pageSizeBytes);
+
+                jobs.push_back(std::move(job));
+                if (jobs.size() >= batch)
+                    decodeBatch();
+            }
+        }
+    }
+    decodeBatch();
+    CPLPopErrorHandler();
+}
+
 /**
 *\brief Build some overviews
 *
@@ -1778,6 +1966,7 @@ CPLErr MRFDataset::ZenCopy(GDALDataset* poSrc, GDALProgressFunc pfnProgress, voi
 void MRFDataset::ProcessOpenOptions(char** papszOptions) {
     CPLStringList opt(papszOptions, FALSE);
     no_errors = opt.FetchBoolean("NOERRORS", FALSE);
+    SetNumThreads(opt.FetchNameValue("NUM_THREADS"));
     const char* val = opt.FetchNameValue("ZSLICE");
     if (val)
         zslice = atoi(val);
@@ -1824,6 +2013,8 @@ void MRFDataset::ProcessCreateOptions(char** papszOptions)
     val = opt.FetchNameValue("UNIFORM_SCALE");
     if (val) scale = atoi(val);
 
+    SetNumThreads(opt.FetchNameValue("NUM_THREADS"));
+
     val = opt.FetchNameValue("PHOTOMETRIC");
     if (val) photometric = val;
 
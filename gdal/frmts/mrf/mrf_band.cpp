@@ -632,6 +632,133 @@ CPLErr MRFRasterBand::FetchClonedBlock(int xblk, int yblk, void *buffer)
     return IReadBlock(xblk, yblk, buffer);
 }
 
+/**
+*\brief Decode a stored page
+*
+* Inflates the page if needed, decompresses it in dst and swaps the result.
+* Does not modify the band or the dataset, so it can be called by a worker thread
+*
+* @param dst Page sized output buffer
+* @param src Stored page, followed by PADDING_BYTES
+*
+*/
+
+CPLErr MRFRasterBand::DecodePage(buf_mgr &dst, buf_mgr &src)
+{
+    buf_mgr page = src;
+    // The inflated page, if any
+    void *unpacked = nullptr;
+
+    // Do we need to decompress it before decoding?
+    if (dodeflate) {
+        if (img.pageSizeBytes > INT_MAX - 1440) {
+            CPLError(CE_Failure, CPLE_AppDefined, "Page size is too big at %d", img.pageSizeBytes);
+            return CE_Failure;
+        }
+        buf_mgr zdst;
+        zdst.size = img.pageSizeBytes + 1440; // in case the packed page is a bit larger than the raw one
+        zdst.buffer = (char *)VSIMalloc(zdst.size);
+        if (nullptr == zdst.buffer) {
+            CPLError(CE_Failure, CPLE_OutOfMemory, "Cannot allocate %d bytes", static_cast<int>(zdst.size));
+            return CE_Failure;
+        }
+
+        if (ZUnPack(src, zdst, deflate_flags)) { // Got it unpacked, update the pointers
+            unpacked = zdst.buffer;
+            page = zdst;
+        } else { // assume the page was not gzipped, warn only
+            CPLFree(zdst.buffer);
+            if (!poDS->no_errors)
+                CPLError(CE_Warning, CPLE_AppDefined, "Can't inflate page!");
+        }
+    }
+
+    const size_t pagesize = dst.size;
+    CPLErr ret = Decompress(dst, page);
+    dst.size = pagesize; // In case the decompress failed, force it back
+
+    // Swap whatever we decompressed if we need to
+    if (is_Endianess_Dependent(img.dt, img.comp) && (img.nbo != NET_ORDER))
+        swab_buff(dst, img);
+
+    CPLFree(unpacked);
+    return ret;
+}
+
+//
+// Pages can be encoded and decoded by worker threads only for separate bands.
+// TIF pages use temporary files with non unique names and PPNG
+// initializes the palette on first write
+//
+bool MRFRasterBand::CanUseThreads() const
+{
+    return poDS->num_threads > 1 && 1 == img.pagesize.c
+        && IL_TIF != img.comp && IL_PPNG != img.comp
+        && poDS->source.empty();
+}
+
+// Decoding errors are not reported, IReadBlock will try again
+void MRFRasterBand::DecodePageFunc(void *pData)
+{
+    MRFPageJob *job = static_cast<MRFPageJob *>(pData);
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    job->ret = job->band->DecodePage(job->dst, job->src);
+    CPLPopErrorHandler();
+    job->done = true;
+}
+
+// Encoding errors are reported by the main thread, when writing the page
+void MRFRasterBand::EncodePageFunc(void *pData)
+{
+    MRFPageJob *job = static_cast<MRFPageJob *>(pData);
+    MRFRasterBand *band = job->band;
+    const ILImage &img = band->img;
+    const size_t pbsize = band->poDS->pbsize;
+
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    CPLErrorReset();
+
+    // Swab the source before encoding if we need to
+    if (is_Endianess_Dependent(img.dt, img.comp) && (img.nbo != NET_ORDER))
+        swab_buff(job->src, img);
+
+    job->dst.buffer = static_cast<char *>(job->outbuff);
+    job->dst.size = pbsize;
+    job->ret = band->Compress(job->dst, job->src);
+    if (CE_None == job->ret && band->dodeflate) {
+        void *usebuff = DeflateBlock(job->dst, pbsize - job->dst.size, band->deflate_flags);
+        if (usebuff)
+            job->dst.buffer = static_cast<char *>(usebuff);
+        else {
+            CPLError(CE_Failure, CPLE_AppDefined, "MRF: Deflate error");
+            job->ret = CE_Failure;
+        }
+    }
+
+    if (CE_None != job->ret) {
+        job->errmsg = CPLGetLastErrorMsg();
+        if (job->errmsg.empty())
+            job->errmsg = "MRF: Page encoding error";
+    }
+    CPLPopErrorHandler();
+    job->done = true;
+}
+
+/**
+*\brief Band RasterIO, decodes the pages of the window in parallel before reading
+*/
+
+CPLErr MRFRasterBand::IRasterIO(GDALRWFlag eRWFlag, int nXOff, int nYOff, int nXSize, int nYSize,
+    void *pData, int nBufXSize, int nBufYSize, GDALDataType eBufType,
+    GSpacing nPixelSpace, GSpacing nLineSpace, GDALRasterIOExtraArg *psExtraArgs)
+{
+    if (eRWFlag == GF_Read && nBufXSize == nXSize && nBufYSize == nYSize && CanUseThreads())
+        poDS->PrefetchBlocks(std::vector<MRFRasterBand *>(1, this), nXOff, nYOff, nXSize, nYSize);
+
+    return GDALPamRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize, pData,
+        nBufXSize, nBufYSize, eBufType, nPixelSpace, nLineSpace, psExtraArgs);
+}
+
 /**
 *\brief read a block in the provided buffer
 *
@@ -652,6 +779,10 @@ CPLErr MRFRasterBand::IReadBlock(int xblk, int yblk, void *buffer) {
     if (poDS->bypass_cache && !poDS->source.empty())
         return FetchBlock(xblk, yblk, buffer);
 
+    // Pages still being encoded have to reach the disk first
+    if (!poDS->pendingTiles.empty() && CE_None != poDS->WritePendingTiles())
+        return CE_Failure;
+
     tinfo.size = 0; // Just in case it is missing
     if (CE_None != poDS->ReadTileIdx(tinfo, req, img)) {
         if (!poDS->no_errors) {
@@ -724,51 +855,16 @@ CPLErr MRFRasterBand::IReadBlock(int xblk, int yblk, void *buffer) {
     /* initialize padding bytes */
     memset(((char*)data) + static_cast<size_t>(tinfo.size), 0, PADDING_BYTES);
     buf_mgr src = {(char *)data, static_cast<size_t>(tinfo.size)};
-    buf_mgr dst;
-
-    // We got the data, do we need to decompress it before decoding?
-    if (dodeflate) {
-        if (img.pageSizeBytes > INT_MAX - 1440) {
-            CPLFree(data);
-            CPLError(CE_Failure, CPLE_AppDefined, "Page size is too big at %d", img.pageSizeBytes);
-            return CE_Failure;
-        }
-        dst.size = img.pageSizeBytes + 1440; // in case the packed page is a bit larger than the raw one
-        dst.buffer = (char *)VSIMalloc(dst.size);
-        if (nullptr == dst.buffer) {
-            CPLFree(data);
-            CPLError(CE_Failure, CPLE_OutOfMemory, "Cannot allocate %d bytes", static_cast<int>(dst.size));
-            return CE_Failure;
-        }
-
-        if (ZUnPack(src, dst, deflate_flags)) { // Got it unpacked, update the pointers
-            CPLFree(data);
-            data = dst.buffer;
-            tinfo.size = dst.size;
-        } else { // assume the page was not gzipped, warn only
-            CPLFree(dst.buffer);
-            if (!poDS->no_errors)
-                CPLError(CE_Warning, CPLE_AppDefined, "Can't inflate page!");
-        }
-    }
-
-    src.buffer = (char *)data;
-    src.size = static_cast<size_t>(tinfo.size);
 
     // After unpacking, the size has to be pageSizeBytes
     // If pages are interleaved, use the dataset page buffer instead
+    buf_mgr dst;
     dst.buffer = reinterpret_cast<char *>((1 == cstride) ? buffer : poDS->GetPBuffer());
     dst.size = img.pageSizeBytes;
 
     if (poDS->no_errors)
         CPLPushErrorHandler(CPLQuietErrorHandler);
-    CPLErr ret = Decompress(dst, src);
-
-    dst.size = img.pageSizeBytes; // In case the decompress failed, force it back
-
-    // Swap whatever we decompressed if we need to
-    if (is_Endianess_Dependent(img.dt, img.comp) && (img.nbo != NET_ORDER))
-        swab_buff(dst, img);
+    CPLErr ret = DecodePage(dst, src);
 
     CPLFree(data);
     if (poDS->no_errors) {
@@ -815,8 +911,30 @@ CPLErr MRFRasterBand::IWriteBlock(int xblk, int yblk, void *buffer)
         int success;
         double val = GetNoDataValue(&success);
         if (!success) val = 0.0;
-        if (isAllVal(eDataType, buffer, img.pageSizeBytes, val))
-            return poDS->WriteTile(nullptr, infooffset, 0);
+        if (isAllVal(eDataType, buffer, img.pageSizeBytes, val)) {
+            if (poDS->pendingTiles.empty())
+                return poDS->WriteTile(nullptr, infooffset, 0);
+            // Queue it, to keep the writes in order
+            std::unique_ptr<MRFPageJob> job(new MRFPageJob());
+            job->infooffset = infooffset;
+            return poDS->SubmitTile(std::move(job));
+        }
+
+        // Encode the page in a worker thread, on a copy of the buffer
+        if (CanUseThreads()) {
+            std::unique_ptr<MRFPageJob> job(new MRFPageJob());
+            job->band = this;
+            job->xblk = xblk;
+            job->yblk = yblk;
+            job->infooffset = infooffset;
+            job->src.buffer = static_cast<char *>(VSI_MALLOC_VERBOSE(img.pageSizeBytes));
+            job->outbuff = VSI_MALLOC_VERBOSE(poDS->pbsize);
+            if (nullptr == job->src.buffer || nullptr == job->outbuff)
+                return CE_Failure;
+            job->src.size = static_cast<size_t>(img.pageSizeBytes);
+            memcpy(job->src.buffer, buffer, job->src.size);
+            return poDS->SubmitTile(std::move(job));
+        }
 
         // Use the pbuffer to hold the compressed page before writing it
         poDS->tile = ILSize(); // Mark it corrupt
@@ -987,6 +1105,10 @@ bool MRFRasterBand::TestBlock(int xblk, int yblk)
     if (xblk < 0 || yblk < 0 || xblk >= img.pagecount.x || yblk >= img.pagecount.y)
         return false;
 
+    // Pages still being encoded have to reach the disk first
+    if (!poDS->pendingTiles.empty())
+        poDS->WritePendingTiles();
+
     ILIdx tinfo;
     GInt32 cstride = img.pagesize.c;
     ILSize req(xblk, yblk, 0, (nBand - 1) / cstride, m_l);
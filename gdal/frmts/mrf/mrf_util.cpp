@@ -584,6 +584,8 @@ void GDALRegister_mrf() {
                     "description='The source raster, if this is a cache'/>\n"
         "   <Option name='UNIFORM_SCALE' type='int' description='Scale of overlays in MRF, usually 2'/>\n"
         "   <Option name='NOCOPY' type='boolean' description='Leave created MRF empty, default=no'/>\n"
+        "   <Option name='NUM_THREADS' type='string' "
+                    "description='Number of worker threads for page encoding. Can be set to ALL_CPUS'/>\n"
         "   <Option name='DATANAME' type='string' description='Data file name'/>\n"
         "   <Option name='INDEXNAME' type='string' description='Index file name'/>\n"
         "   <Option name='SPACING' type='int' "
@@ -616,6 +618,7 @@ void GDALRegister_mrf() {
       "<OpenOptionList>"
       "    <Option name='NOERRORS' type='boolean' description='Ignore decompression errors' default='FALSE'/>"
       "    <Option name='ZSLICE' type='int' description='For a third dimension MRF, pick a slice' default='0'/>"
+      "    <Option name='NUM_THREADS' type='string' description='Number of worker threads for page decoding and encoding. Can be set to ALL_CPUS'/>"
       "</OpenOptionList>"
       );
 
@@ -186,6 +186,9 @@ class netCDFRasterBand final: public GDALPamRasterBand
                                         size_t nTmpBlockYSize,
                                         bool bCheckIsNan=false );
     void            SetBlockSize();
+#ifdef NETCDF_HAS_NC4
+    void            SetChunkCacheSize( const size_t *panChunkSize );
+#endif
 
     bool            FetchNetcdfChunk( size_t xstart,
                                       size_t ystart,
@@ -634,6 +637,8 @@ void netCDFRasterBand::SetBlockSize()
                 nBlockYSize = (int)chunksize[nZDim - 2];
             else
                 nBlockYSize = 1;
+
+            SetChunkCacheSize(chunksize);
         }
     }
 #endif
@@ -665,6 +670,59 @@ void netCDFRasterBand::SetBlockSize()
     }
 }
 
+#ifdef NETCDF_HAS_NC4
+// Size the chunk cache of the variable so that it can hold a row of chunks
+// along the whole width of the raster. When chunks span several bands
+// (typically along a time dimension), each chunk is then decompressed once
+// when reading the bands in turn, instead of once per band.
+void netCDFRasterBand::SetChunkCacheSize(const size_t *panChunkSize)
+{
+    if( poDS->GetAccess() != GA_ReadOnly )
+        return;
+
+    const GIntBig nMaxCacheSize = CPLAtoGIntBig(
+        CPLGetConfigOption("GDAL_NETCDF_CHUNK_CACHE_SIZE", "268435456"));
+    size_t nTypeSize = 0;
+    if( nMaxCacheSize <= 0 ||
+        nc_inq_type(cdfid, nc_datatype, nullptr, &nTypeSize) != NC_NOERR )
+        return;
+
+    double dfChunkBytes = static_cast<double>(nTypeSize);
+    for( int i = 0; i < nZDim; i++ )
+        dfChunkBytes *= static_cast<double>(panChunkSize[i]);
+    // A row of blocks is on two rows of chunks for bottom-up rasters whose
+    // height is not a multiple of the chunk height
+    double dfChunks = static_cast<double>(DIV_ROUND_UP(nRasterXSize, nBlockXSize));
+    if( static_cast<netCDFDataset*>(poDS)->bBottomUp &&
+        (nRasterYSize % nBlockYSize) != 0 )
+        dfChunks *= 2;
+    const double dfCacheSize = std::min(dfChunkBytes * dfChunks,
+                                        static_cast<double>(nMaxCacheSize));
+
+    size_t nCurSize = 0;
+    size_t nElems = 0;
+    float fPreemption = 0.0f;
+    if( nc_get_var_chunk_cache(cdfid, nZId, &nCurSize, &nElems,
+                               &fPreemption) != NC_NOERR ||
+        dfCacheSize <= static_cast<double>(nCurSize) )
+        return;
+
+    // HDF5 advises many more hash slots than chunks in the cache
+    const size_t nCacheSize = static_cast<size_t>(dfCacheSize);
+    const size_t nCachedChunks =
+        static_cast<size_t>(std::max(1.0, dfCacheSize / dfChunkBytes));
+    nElems = std::max(nElems, 10 * nCachedChunks + 1);
+    if( nc_set_var_chunk_cache(cdfid, nZId, nCacheSize, nElems,
+                               fPreemption) == NC_NOERR )
+    {
+        CPLDebug("GDAL_netCDF",
+                 "Chunk cache of variable %d set to %u bytes, %u slots",
+                 nZId, static_cast<unsigned>(nCacheSize),
+                 static_cast<unsigned>(nElems));
+    }
+}
+#endif
+
 // Constructor in create mode.
 // If nZId and following variables are not passed, the band will have 2
 // dimensions.
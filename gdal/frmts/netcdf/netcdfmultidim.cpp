@@ -410,6 +410,8 @@ protected:
     bool IAdviseRead(const GUInt64* arrayStartIdx,
                      const size_t* count) const override;
 
+    bool IsChunkCacheable() const override { return true; }
+
 public:
     static std::shared_ptr<netCDFVariable> Create(
                    const std::shared_ptr<netCDFSharedResources>& poShared,
@@ -46,6 +46,9 @@
         ((major)*10000+(minor)*100+(patch)))
 
 #include <cassert>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "cpl_atomic_ops.h"
@@ -194,6 +197,429 @@ static OPJ_OFF_T JP2OpenJPEGDataset_Skip(OPJ_OFF_T nBytes, void * pUserData)
     return nBytes;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*                      JP2OpenJPEGCodeStreamIndex                      */
+/* ==================================================================== */
+/************************************************************************/
+
+// Location of the main header and of the tile-parts of each tile of a
+// tiled codestream, shared by a dataset and its overviews. This enables a
+// block to be decoded from an in-memory codestream made of the main header
+// and of the tile-parts of its tile only, instead of having openjpeg
+// re-read the main header and skip tile-parts from the file for each block.
+class JP2OpenJPEGCodeStreamIndex
+{
+    CPL_DISALLOW_COPY_ASSIGN(JP2OpenJPEGCodeStreamIndex)
+
+    std::mutex   m_oMutex{};
+    int          m_nStatus = 0; // 0: not built, 1: usable, -1: unusable
+    std::vector<GByte> m_abyMainHeader{}; // SOC to first SOT, without TLM/PLM
+    // Offsets, relative to the codestream start, and sizes of the
+    // tile-parts of each tile.
+    std::vector<std::vector<std::pair<vsi_l_offset, size_t>>> m_aaoTileParts{};
+    // Tile-parts prefetched by PreloadBlocks()
+    std::map<int, std::vector<GByte>> m_oMapPrefetched{};
+
+    bool Build( VSILFILE* fp, vsi_l_offset nStart, vsi_l_offset nLength,
+                bool bAllowWalk );
+
+  public:
+    JP2OpenJPEGCodeStreamIndex() = default;
+
+    bool IsUsable( VSILFILE* fp, vsi_l_offset nStart, vsi_l_offset nLength,
+                   bool bAllowWalk );
+    void Disable();
+
+    void Prefetch( VSILFILE* fp, vsi_l_offset nStart,
+                   const std::vector<int>& anTiles );
+    void ClearPrefetched();
+
+    bool GetTileCodeStream( VSILFILE* fp, vsi_l_offset nStart, int nTile,
+                            std::vector<GByte>& abyCodeStream );
+};
+
+/************************************************************************/
+/*                              IsUsable()                              */
+/************************************************************************/
+
+bool JP2OpenJPEGCodeStreamIndex::IsUsable( VSILFILE* fp, vsi_l_offset nStart,
+                                           vsi_l_offset nLength,
+                                           bool bAllowWalk )
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if( m_nStatus == 0 )
+    {
+        const vsi_l_offset nCurOffset = VSIFTellL(fp);
+        m_nStatus = Build(fp, nStart, nLength, bAllowWalk) ? 1 : -1;
+        VSIFSeekL(fp, nCurOffset, SEEK_SET);
+        if( m_nStatus < 0 )
+        {
+            m_abyMainHeader.clear();
+            m_aaoTileParts.clear();
+        }
+    }
+    return m_nStatus > 0;
+}
+
+/************************************************************************/
+/*                              Disable()                               */
+/************************************************************************/
+
+void JP2OpenJPEGCodeStreamIndex::Disable()
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    m_nStatus = -1;
+    m_oMapPrefetched.clear();
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/*                                                                      */
+/*      Parse the main header. The tile-parts are located from the      */
+/*      TLM marker segments if they are present, or by walking the      */
+/*      SOT markers if bAllowWalk.                                      */
+/************************************************************************/
+
+bool JP2OpenJPEGCodeStreamIndex::Build( VSILFILE* fp, vsi_l_offset nStart,
+                                        vsi_l_offset nLength,
+                                        bool bAllowWalk )
+{
+    GByte abyBuffer[12] = { 0 };
+    if( nLength < 2 || VSIFSeekL(fp, nStart, SEEK_SET) != 0 ||
+        VSIFReadL(abyBuffer, 2, 1, fp) != 1 ||
+        abyBuffer[0] != 0xFF || abyBuffer[1] != 0x4F ) // SOC
+    {
+        return false;
+    }
+    m_abyMainHeader.assign(abyBuffer, abyBuffer + 2);
+
+    // Tile index (or -1 if implicit) and size of the tile-parts from TLM.
+    std::vector<std::pair<int, GUInt32>> aoTLM;
+    bool bHasSIZ = false;
+    int nTiles = 0;
+    vsi_l_offset nPos = 2;
+    std::vector<GByte> abySegment;
+    while( true )
+    {
+        if( nPos + 4 > nLength ||
+            VSIFSeekL(fp, nStart + nPos, SEEK_SET) != 0 ||
+            VSIFReadL(abyBuffer, 4, 1, fp) != 1 ||
+            abyBuffer[0] != 0xFF )
+        {
+            return false;
+        }
+        const GByte nMarker = abyBuffer[1];
+        if( nMarker == 0x90 ) // SOT
+            break;
+        const int nSegmentSize = (abyBuffer[2] << 8) | abyBuffer[3];
+        if( nSegmentSize < 2 || nPos + 2 + nSegmentSize > nLength )
+            return false;
+        abySegment.resize(2 + nSegmentSize);
+        memcpy(abySegment.data(), abyBuffer, 4);
+        if( nSegmentSize > 2 &&
+            VSIFReadL(abySegment.data() + 4, nSegmentSize - 2, 1, fp) != 1 )
+        {
+            return false;
+        }
+        nPos += 2 + nSegmentSize;
+
+        if( nMarker == 0x51 ) // SIZ
+        {
+            if( nSegmentSize < 38 )
+                return false;
+            const auto ReadUInt32 = [&abySegment](int nOffset)
+            {
+                return (static_cast<GUInt32>(abySegment[nOffset]) << 24) |
+                       (abySegment[nOffset + 1] << 16) |
+                       (abySegment[nOffset + 2] << 8) |
+                       abySegment[nOffset + 3];
+            };
+            const GUInt32 nXsiz = ReadUInt32(6);
+            const GUInt32 nYsiz = ReadUInt32(10);
+            const GUInt32 nXTsiz = ReadUInt32(22);
+            const GUInt32 nYTsiz = ReadUInt32(26);
+            const GUInt32 nXTOsiz = ReadUInt32(30);
+            const GUInt32 nYTOsiz = ReadUInt32(34);
+            if( nXTsiz == 0 || nYTsiz == 0 ||
+                nXTOsiz >= nXsiz || nYTOsiz >= nYsiz )
+            {
+                return false;
+            }
+            const GUIntBig nTilesBig =
+                static_cast<GUIntBig>(DIV_ROUND_UP(nXsiz - nXTOsiz, nXTsiz)) *
+                DIV_ROUND_UP(nYsiz - nYTOsiz, nYTsiz);
+            if( nTilesBig > 65535 )
+                return false;
+            nTiles = static_cast<int>(nTilesBig);
+            bHasSIZ = true;
+        }
+        else if( nMarker == 0x55 ) // TLM
+        {
+            if( nSegmentSize < 4 )
+                return false;
+            const int nST = (abySegment[5] >> 4) & 3;
+            const int nSP = (abySegment[5] >> 6) & 1;
+            if( nST == 3 )
+                return false;
+            const int nEntrySize = nST + (nSP ? 4 : 2);
+            if( (nSegmentSize - 4) % nEntrySize != 0 )
+                return false;
+            for( int iOffset = 6; iOffset < 2 + nSegmentSize;
+                 iOffset += nEntrySize )
+            {
+                int nTile = -1;
+                if( nST == 1 )
+                    nTile = abySegment[iOffset];
+                else if( nST == 2 )
+                    nTile = (abySegment[iOffset] << 8) |
+                            abySegment[iOffset + 1];
+                GUInt32 nSize = 0;
+                for( int i = nST; i < nEntrySize; i++ )
+                    nSize = (nSize << 8) | abySegment[iOffset + i];
+                aoTLM.emplace_back(nTile, nSize);
+            }
+            // Refers to the whole codestream.
+            continue;
+        }
+        else if( nMarker == 0x57 ) // PLM
+        {
+            continue;
+        }
+        else if( nMarker == 0x60 ) // PPM
+        {
+            // Packet headers of all tiles are in the main header.
+            return false;
+        }
+        m_abyMainHeader.insert(m_abyMainHeader.end(),
+                               abySegment.begin(), abySegment.end());
+    }
+    if( !bHasSIZ )
+        return false;
+
+    m_aaoTileParts.resize(nTiles);
+    if( !aoTLM.empty() )
+    {
+        for( size_t i = 0; i < aoTLM.size(); i++ )
+        {
+            const int nTile =
+                aoTLM[i].first >= 0 ? aoTLM[i].first : static_cast<int>(i);
+            if( nTile >= nTiles || aoTLM[i].second < 14 ||
+                nPos + aoTLM[i].second > nLength )
+            {
+                return false;
+            }
+            m_aaoTileParts[nTile].emplace_back(nPos, aoTLM[i].second);
+            nPos += aoTLM[i].second;
+        }
+    }
+    else
+    {
+        if( !bAllowWalk )
+            return false;
+        while( nPos + 2 <= nLength )
+        {
+            if( VSIFSeekL(fp, nStart + nPos, SEEK_SET) != 0 ||
+                VSIFReadL(abyBuffer, 2, 1, fp) != 1 ||
+                abyBuffer[0] != 0xFF )
+            {
+                return false;
+            }
+            if( abyBuffer[1] == 0xD9 ) // EOC
+                break;
+            if( abyBuffer[1] != 0x90 ||
+                VSIFReadL(abyBuffer + 2, 10, 1, fp) != 1 )
+            {
+                return false;
+            }
+            const int nTile = (abyBuffer[4] << 8) | abyBuffer[5];
+            vsi_l_offset nSize =
+                (static_cast<GUInt32>(abyBuffer[6]) << 24) |
+                (abyBuffer[7] << 16) | (abyBuffer[8] << 8) | abyBuffer[9];
+            if( nSize == 0 )
+            {
+                // Last tile-part, up to the EOC marker.
+                if( nLength < nPos + 2 )
+                    return false;
+                nSize = nLength - 2 - nPos;
+            }
+            if( nTile >= nTiles || nSize < 14 || nPos + nSize > nLength )
+                return false;
+            m_aaoTileParts[nTile].emplace_back(nPos,
+                                               static_cast<size_t>(nSize));
+            nPos += nSize;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                              Prefetch()                              */
+/*                                                                      */
+/*      Fetch the tile-parts of several tiles with a single multi-range */
+/*      request.                                                        */
+/************************************************************************/
+
+void JP2OpenJPEGCodeStreamIndex::Prefetch( VSILFILE* fp, vsi_l_offset nStart,
+                                           const std::vector<int>& anTiles )
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if( m_nStatus <= 0 )
+        return;
+
+    std::vector<int> anTilesToFetch;
+    std::vector<void*> apData;
+    std::vector<vsi_l_offset> anOffsets;
+    std::vector<size_t> anSizes;
+    size_t nTotalSize = 0;
+    for( const int nTile : anTiles )
+    {
+        if( nTile < 0 || nTile >= static_cast<int>(m_aaoTileParts.size()) ||
+            m_aaoTileParts[nTile].empty() ||
+            m_oMapPrefetched.find(nTile) != m_oMapPrefetched.end() )
+        {
+            continue;
+        }
+        size_t nTileSize = 0;
+        for( const auto& oPart : m_aaoTileParts[nTile] )
+            nTileSize += oPart.second;
+        auto& abyData = m_oMapPrefetched[nTile];
+        try
+        {
+            abyData.resize(nTileSize);
+        }
+        catch( const std::bad_alloc& )
+        {
+            m_oMapPrefetched.erase(nTile);
+            break;
+        }
+        size_t nOffsetInTile = 0;
+        for( const auto& oPart : m_aaoTileParts[nTile] )
+        {
+            apData.push_back(abyData.data() + nOffsetInTile);
+            anOffsets.push_back(nStart + oPart.first);
+            anSizes.push_back(oPart.second);
+            nOffsetInTile += oPart.second;
+        }
+        anTilesToFetch.push_back(nTile);
+        nTotalSize += nTileSize;
+    }
+    if( apData.size() <= 1 )
+    {
+        // Nothing to gain compared to reading from the worker threads.
+        for( const int nTile : anTilesToFetch )
+            m_oMapPrefetched.erase(nTile);
+        return;
+    }
+
+    CPLDebug("OPENJPEG", "Prefetching %d tiles (%d ranges, " CPL_FRMT_GUIB
+             " bytes)", static_cast<int>(anTilesToFetch.size()),
+             static_cast<int>(apData.size()),
+             static_cast<GUIntBig>(nTotalSize));
+    const vsi_l_offset nCurOffset = VSIFTellL(fp);
+    if( VSIFReadMultiRangeL(static_cast<int>(apData.size()), apData.data(),
+                            anOffsets.data(), anSizes.data(), fp) != 0 )
+    {
+        for( const int nTile : anTilesToFetch )
+            m_oMapPrefetched.erase(nTile);
+    }
+    VSIFSeekL(fp, nCurOffset, SEEK_SET);
+}
+
+/************************************************************************/
+/*                          ClearPrefetched()                           */
+/************************************************************************/
+
+void JP2OpenJPEGCodeStreamIndex::ClearPrefetched()
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    m_oMapPrefetched.clear();
+}
+
+/************************************************************************/
+/*                         GetTileCodeStream()                          */
+/*                                                                      */
+/*      Build a codestream made of the main header, the tile-parts of   */
+/*      nTile and the EOC marker.                                       */
+/************************************************************************/
+
+bool JP2OpenJPEGCodeStreamIndex::GetTileCodeStream(
+    VSILFILE* fp, vsi_l_offset nStart, int nTile,
+    std::vector<GByte>& abyCodeStream )
+{
+    std::vector<GByte> abyTileParts;
+    std::vector<std::pair<vsi_l_offset, size_t>> aoTileParts;
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        if( m_nStatus <= 0 || nTile < 0 ||
+            nTile >= static_cast<int>(m_aaoTileParts.size()) ||
+            m_aaoTileParts[nTile].empty() )
+        {
+            return false;
+        }
+        aoTileParts = m_aaoTileParts[nTile];
+        abyCodeStream = m_abyMainHeader;
+        auto oIter = m_oMapPrefetched.find(nTile);
+        if( oIter != m_oMapPrefetched.end() )
+        {
+            abyTileParts = std::move(oIter->second);
+            m_oMapPrefetched.erase(oIter);
+        }
+    }
+
+    const size_t nHeaderSize = abyCodeStream.size();
+    size_t nTileSize = 0;
+    for( const auto& oPart : aoTileParts )
+        nTileSize += oPart.second;
+    try
+    {
+        abyCodeStream.resize(nHeaderSize + nTileSize + 2);
+    }
+    catch( const std::bad_alloc& )
+    {
+        return false;
+    }
+    if( abyTileParts.size() == nTileSize )
+    {
+        memcpy(abyCodeStream.data() + nHeaderSize, abyTileParts.data(),
+               nTileSize);
+    }
+    else
+    {
+        size_t nOffsetInTile = 0;
+        for( const auto& oPart : aoTileParts )
+        {
+            if( VSIFSeekL(fp, nStart + oPart.first, SEEK_SET) != 0 ||
+                VSIFReadL(abyCodeStream.data() + nHeaderSize + nOffsetInTile,
+                          oPart.second, 1, fp) != 1 )
+            {
+                return false;
+            }
+            nOffsetInTile += oPart.second;
+        }
+    }
+
+    // Check that each tile-part starts with the SOT of the expected tile
+    size_t nOffsetInTile = 0;
+    for( const auto& oPart : aoTileParts )
+    {
+        const GByte* pabySOT =
+            abyCodeStream.data() + nHeaderSize + nOffsetInTile;
+        if( pabySOT[0] != 0xFF || pabySOT[1] != 0x90 ||
+            ((pabySOT[4] << 8) | pabySOT[5]) != nTile )
+        {
+            CPLDebug("OPENJPEG", "Inconsistent codestream index");
+            Disable();
+            return false;
+        }
+        nOffsetInTile += oPart.second;
+    }
+
+    abyCodeStream[nHeaderSize + nTileSize] = 0xFF;
+    abyCodeStream[nHeaderSize + nTileSize + 1] = 0xD9; // EOC
+    return true;
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                           JP2OpenJPEGDataset                         */
@@ -236,6 +662,9 @@ class JP2OpenJPEGDataset final: public GDALJP2AbstractDataset
     int         m_nX0 = 0;
     int         m_nY0 = 0;
 
+    std::shared_ptr<JP2OpenJPEGCodeStreamIndex> m_poCodeStreamIndex{};
+    bool        UseCodeStreamIndex( VSILFILE* fpIn );
+
     int         nThreads = -1;
     int         m_nBlocksToLoad = 0;
     int         GetNumThreads();
@@ -499,6 +928,21 @@ int JP2OpenJPEGDataset::GetNumThreads()
     return nThreads;
 }
 
+/************************************************************************/
+/*                         UseCodeStreamIndex()                         */
+/************************************************************************/
+
+bool JP2OpenJPEGDataset::UseCodeStreamIndex( VSILFILE* fpIn )
+{
+    if( bUseSetDecodeArea || m_poCodeStreamIndex == nullptr )
+        return false;
+    // Walking the tile-parts of a remote file without TLM marker would
+    // cost a request per tile-part.
+    return m_poCodeStreamIndex->IsUsable(
+        fpIn, nCodeStreamStart, nCodeStreamLength,
+        !VSIHasOptimizedReadMultiRange(m_osFilename.c_str()));
+}
+
 /************************************************************************/
 /*                   JP2OpenJPEGReadBlockInThread()                     */
 /************************************************************************/
@@ -649,6 +1093,20 @@ int JP2OpenJPEGDataset::PreloadBlocks(JP2OpenJPEGRasterBand* poBand,
             }
             oJob.bSuccess = true;
 
+            // Fetch the tile-parts of all the blocks at once from remote
+            // files.
+            if( VSIHasOptimizedReadMultiRange(m_osFilename.c_str()) &&
+                UseCodeStreamIndex(fp) )
+            {
+                std::vector<int> anTiles;
+                for( const auto& oPair: oJob.oPairs )
+                {
+                    anTiles.push_back(oPair.first +
+                                      oPair.second * poBand->nBlocksPerRow);
+                }
+                m_poCodeStreamIndex->Prefetch(fp, nCodeStreamStart, anTiles);
+            }
+
             /* Flushes all dirty blocks from cache to disk to avoid them */
             /* to be flushed randomly, and simultaneously, from our worker threads, */
             /* which might cause races in the output driver. */
@@ -666,6 +1124,8 @@ int JP2OpenJPEGDataset::PreloadBlocks(JP2OpenJPEGRasterBand* poBand,
                 CPLJoinThread( pahThreads[i] );
             ReacquireReadWriteLock();
             CPLFree(pahThreads);
+            if( m_poCodeStreamIndex )
+                m_poCodeStreamIndex->ClearPrefetched();
             if( !oJob.bSuccess )
             {
                 m_nBlocksToLoad = 0;
@@ -800,6 +1260,9 @@ CPLErr JP2OpenJPEGDataset::ReadBlock( int nBand, VSILFILE* fpIn,
     opj_stream_t *  pStream = nullptr;
     opj_image_t *   psImage = nullptr;
     JP2OpenJPEGFile sJP2OpenJPEGFile; // keep it in this scope
+    std::vector<GByte> abyTileCodeStream;
+    CPLString       osTileCodeStreamFilename;
+    VSILFILE*       fpTileCodeStream = nullptr;
 
     JP2OpenJPEGRasterBand* poBand = (JP2OpenJPEGRasterBand*) GetRasterBand(nBand);
     int nBlockXSize = poBand->nBlockXSize;
@@ -874,6 +1337,21 @@ CPLErr JP2OpenJPEGDataset::ReadBlock( int nBand, VSILFILE* fpIn,
         }
         else
 #endif
+        if( UseCodeStreamIndex(fpIn) &&
+            m_poCodeStreamIndex->GetTileCodeStream(
+                fpIn, nCodeStreamStart, nTileNumber, abyTileCodeStream) )
+        {
+            osTileCodeStreamFilename.Printf("/vsimem/jp2openjpeg_tile_%p",
+                                            abyTileCodeStream.data());
+            fpTileCodeStream = VSIFileFromMemBuffer(
+                osTileCodeStreamFilename, abyTileCodeStream.data(),
+                abyTileCodeStream.size(), FALSE);
+            sJP2OpenJPEGFile.fp = fpTileCodeStream;
+            sJP2OpenJPEGFile.nBaseOffset = 0;
+            pStream = JP2OpenJPEGCreateReadStream(&sJP2OpenJPEGFile,
+                                                  abyTileCodeStream.size());
+        }
+        else
         {
             sJP2OpenJPEGFile.fp = fpIn;
             sJP2OpenJPEGFile.nBaseOffset = nCodeStreamStart;
@@ -1134,6 +1612,11 @@ end:
         if( psImage )
             opj_image_destroy(psImage);
     }
+    if( fpTileCodeStream )
+    {
+        VSIFCloseL(fpTileCodeStream);
+        VSIUnlink(osTileCodeStreamFilename);
+    }
 
     return eErr;
 }
@@ -2178,6 +2661,13 @@ GDALDataset *JP2OpenJPEGDataset::Open( GDALOpenInfo * poOpenInfo )
     poDS->m_pnLastLevel = new int(-1);
 #endif
 
+    if( !poDS->bUseSetDecodeArea &&
+        CPLTestBool(CPLGetConfigOption("USE_OPENJPEG_CODESTREAM_INDEX", "YES")) )
+    {
+        poDS->m_poCodeStreamIndex =
+            std::make_shared<JP2OpenJPEGCodeStreamIndex>();
+    }
+
     while (poDS->nOverviewCount+1 < numResolutions &&
            (nW > 128 || nH > 128) &&
            (poDS->bUseSetDecodeArea || ((nTileW % 2) == 0 && (nTileH % 2) == 0)))
@@ -2235,6 +2725,7 @@ GDALDataset *JP2OpenJPEGDataset::Open( GDALOpenInfo * poOpenInfo )
 #endif
         poODS->m_nX0 = poDS->m_nX0;
         poODS->m_nY0 = poDS->m_nY0;
+        poODS->m_poCodeStreamIndex = poDS->m_poCodeStreamIndex;
 
         for( iBand = 1; iBand <= poDS->nBands; iBand++ )
         {
@@ -44,11 +44,14 @@
 #include "cpl_string.h"
 #include "gdal_frmts.h"
 #include "gdal_pam.h"
+#include "gdal_perf_counters.h"
 #include "png.h"
 
 #include <csetjmp>
 
 #include <algorithm>
+#include <cstdlib>
+#include <vector>
 
 CPL_CVSID("$Id$")
 
@@ -276,6 +279,7 @@ PNGDataset::PNGDataset() :
     bGeoTransformValid(FALSE),
     bHasReadXMPMetadata(FALSE),
     bHasTriedLoadWorldFile(FALSE),
+    bWholeImageLoadingFailed(FALSE),
     bHasReadICCMetadata(FALSE)
 {
     adfGeoTransform[0] = 0.0;
@@ -600,11 +604,228 @@ CPLErr PNGDataset::LoadInterlacedChunk( int iLine )
     if( !bRet )
         return CE_Failure;
 
+    // The whole image is decoded, even if only a chunk is kept.
+    GDAL_PERF_COUNTER(poRowsCounter, "PNG.rows_decoded");
+    poRowsCounter->Add(GetRasterYSize());
+
     nLastLineRead = nBufferStartLine + nBufferLines - 1;
 
     return CE_None;
 }
 
+/************************************************************************/
+/*                          PNGUnfilterRow()                            */
+/************************************************************************/
+
+// Reverse the filter of a row, as described in
+// https://www.w3.org/TR/PNG/#9Filters
+static bool PNGUnfilterRow( int nFilterType, const GByte* pabyIn,
+                            const GByte* pabyPrevRow, GByte* pabyOut,
+                            int nRowBytes, int nBPP )
+{
+    switch( nFilterType )
+    {
+        case 0: // None
+            memcpy(pabyOut, pabyIn, nRowBytes);
+            break;
+
+        case 1: // Sub
+            for( int i = 0; i < nBPP; ++i )
+                pabyOut[i] = pabyIn[i];
+            for( int i = nBPP; i < nRowBytes; ++i )
+                pabyOut[i] = static_cast<GByte>(pabyIn[i] + pabyOut[i - nBPP]);
+            break;
+
+        case 2: // Up
+            for( int i = 0; i < nRowBytes; ++i )
+                pabyOut[i] = static_cast<GByte>(pabyIn[i] + pabyPrevRow[i]);
+            break;
+
+        case 3: // Average
+            for( int i = 0; i < nBPP; ++i )
+                pabyOut[i] = static_cast<GByte>(pabyIn[i] + pabyPrevRow[i] / 2);
+            for( int i = nBPP; i < nRowBytes; ++i )
+                pabyOut[i] = static_cast<GByte>(pabyIn[i] +
+                    (pabyOut[i - nBPP] + pabyPrevRow[i]) / 2);
+            break;
+
+        case 4: // Paeth
+            for( int i = 0; i < nBPP; ++i )
+                pabyOut[i] = static_cast<GByte>(pabyIn[i] + pabyPrevRow[i]);
+            for( int i = nBPP; i < nRowBytes; ++i )
+            {
+                const int a = pabyOut[i - nBPP];
+                const int b = pabyPrevRow[i];
+                const int c = pabyPrevRow[i - nBPP];
+                const int pa = std::abs(b - c);
+                const int pb = std::abs(a - c);
+                const int pc = std::abs(a + b - 2 * c);
+                const int nPred = (pa <= pb && pa <= pc) ? a :
+                                  (pb <= pc) ? b : c;
+                pabyOut[i] = static_cast<GByte>(pabyIn[i] + nPred);
+            }
+            break;
+
+        default:
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                          LoadWholeImage()                            */
+/************************************************************************/
+
+// Decode a whole non-interlaced image in one go, by decompressing the
+// concatenated IDAT chunks with a single CPLZLibInflate() call, which uses
+// libdeflate when available, and unfiltering the rows ourselves. This is
+// much faster than the streaming zlib decoding done by libpng for the
+// small images typically found in tile caches.
+// Returns false if the image is not a candidate or on error, in which case
+// the caller should fall back to libpng.
+bool PNGDataset::LoadWholeImage()
+
+{
+    if( bInterlaced || bWholeImageLoadingFailed ||
+        (nBitDepth != 8 && nBitDepth != 16) )
+        return false;
+
+    const int nPixelOffset =
+        ( nBitDepth == 16 ) ? 2 * GetRasterCount() : GetRasterCount();
+    const size_t nRowBytes =
+        static_cast<size_t>(nPixelOffset) * GetRasterXSize();
+    // Only worth it (and reasonable memory-wise) for tile-sized images.
+    constexpr size_t MAX_WHOLE_IMAGE_BYTES = 10 * 1024 * 1024;
+    if( nRowBytes >
+            MAX_WHOLE_IMAGE_BYTES / (GetRasterYSize() + 1) )
+        return false;
+    const size_t nFilteredBytes = (nRowBytes + 1) * GetRasterYSize();
+
+#ifdef HAVE_LIBDEFLATE
+    const char* pszDefault = "YES";
+#else
+    const char* pszDefault = "NO";
+#endif
+    if( !CPLTestBool(CPLGetConfigOption("GDAL_PNG_WHOLE_IMAGE_OPTIM",
+                                        pszDefault)) )
+        return false;
+
+    // From now on, libpng lost track of the file position, so force it
+    // to restart on next use.
+    nLastLineRead = GetRasterYSize() - 1;
+    bWholeImageLoadingFailed = TRUE;
+
+    // Collect the content of the IDAT chunks.
+    std::vector<GByte> abyCompressed;
+    if( VSIFSeekL(fpImage, 8, SEEK_SET) != 0 )
+        return false;
+    while( true )
+    {
+        GByte abyChunkHeader[8];
+        if( VSIFReadL(abyChunkHeader, 8, 1, fpImage) != 1 )
+            return false;
+        const GUInt32 nChunkSize =
+            (static_cast<GUInt32>(abyChunkHeader[0]) << 24) |
+            (abyChunkHeader[1] << 16) | (abyChunkHeader[2] << 8) |
+            abyChunkHeader[3];
+        if( memcmp(abyChunkHeader + 4, "IEND", 4) == 0 )
+            break;
+        if( memcmp(abyChunkHeader + 4, "IDAT", 4) == 0 )
+        {
+            // Compressed data larger than the raw data + some margin is
+            // likely a corrupted file.
+            if( nChunkSize > nFilteredBytes + 65536 - abyCompressed.size() )
+                return false;
+            const size_t nOldSize = abyCompressed.size();
+            try
+            {
+                abyCompressed.resize(nOldSize + nChunkSize);
+            }
+            catch( const std::exception& )
+            {
+                return false;
+            }
+            if( VSIFReadL(abyCompressed.data() + nOldSize, 1, nChunkSize,
+                          fpImage) != nChunkSize )
+                return false;
+            // Skip CRC: the integrity of the data is checked by the
+            // Adler-32 checksum of the zlib stream.
+            if( VSIFSeekL(fpImage, VSIFTellL(fpImage) + 4, SEEK_SET) != 0 )
+                return false;
+        }
+        else
+        {
+            // IDAT chunks must be consecutive.
+            if( !abyCompressed.empty() )
+                break;
+            if( VSIFSeekL(fpImage,
+                          VSIFTellL(fpImage) + nChunkSize + 4, SEEK_SET) != 0 )
+                return false;
+        }
+    }
+    if( abyCompressed.empty() )
+        return false;
+
+    std::vector<GByte> abyFiltered;
+    try
+    {
+        abyFiltered.resize(nFilteredBytes);
+    }
+    catch( const std::exception& )
+    {
+        return false;
+    }
+    size_t nOutBytes = 0;
+    if( CPLZLibInflate(abyCompressed.data(), abyCompressed.size(),
+                       abyFiltered.data(), abyFiltered.size(),
+                       &nOutBytes) == nullptr ||
+        nOutBytes != nFilteredBytes )
+    {
+        CPLDebug("PNG", "Whole image decompression failed. "
+                 "Falling back to libpng");
+        return false;
+    }
+    abyCompressed.clear();
+
+    GByte* pabyImage = static_cast<GByte*>(
+        VSI_MALLOC_VERBOSE(nRowBytes * GetRasterYSize()));
+    if( pabyImage == nullptr )
+        return false;
+    const std::vector<GByte> abyZeroRow(nRowBytes);
+    const int nBPP = std::max(1, nPixelOffset);
+    for( int iLine = 0; iLine < GetRasterYSize(); ++iLine )
+    {
+        const GByte* pabyIn = abyFiltered.data() + iLine * (nRowBytes + 1);
+        GByte* pabyOut = pabyImage + iLine * nRowBytes;
+        const GByte* pabyPrevRow =
+            iLine == 0 ? abyZeroRow.data() : pabyOut - nRowBytes;
+        if( !PNGUnfilterRow(pabyIn[0], pabyIn + 1, pabyPrevRow, pabyOut,
+                            static_cast<int>(nRowBytes), nBPP) )
+        {
+            CPLDebug("PNG", "Invalid filter type %d at line %d. "
+                     "Falling back to libpng", pabyIn[0], iLine);
+            VSIFree(pabyImage);
+            return false;
+        }
+    }
+
+    // Do swap on LSB machines. 16-bit PNG data is stored in MSB format.
+#ifdef CPL_LSB
+    if( nBitDepth == 16 )
+        GDALSwapWords( pabyImage, 2,
+                       static_cast<size_t>(GetRasterXSize()) *
+                           GetRasterYSize() * GetRasterCount(), 2 );
+#endif
+
+    CPLFree(pabyBuffer);
+    pabyBuffer = pabyImage;
+    nBufferStartLine = 0;
+    nBufferLines = GetRasterYSize();
+    bWholeImageLoadingFailed = FALSE;
+
+    return true;
+}
+
 /************************************************************************/
 /*                        safe_png_read_rows()                          */
 /************************************************************************/
@@ -631,9 +852,20 @@ CPLErr PNGDataset::LoadScanline( int nLine )
     if( nLine >= nBufferStartLine && nLine < nBufferStartLine + nBufferLines)
         return CE_None;
 
+    GDAL_PERF_COUNTER(poRowsCounter, "PNG.rows_decoded");
+    GDAL_PERF_COUNTER(poTimeCounter, "PNG.decode_time_ns");
+    GDALPerfCounterTimer oTimer(poTimeCounter);
+
     const int nPixelOffset =
         ( nBitDepth == 16 ) ? 2 * GetRasterCount() : GetRasterCount();
 
+    // Small non-interlaced images are decoded at once.
+    if( LoadWholeImage() )
+    {
+        poRowsCounter->Add(GetRasterYSize());
+        return CE_None;
+    }
+
     // If the file is interlaced, we load the entire image into memory using the
     // high-level API.
     if( bInterlaced )
@@ -665,6 +897,7 @@ CPLErr PNGDataset::LoadScanline( int nLine )
             return CE_Failure;
         }
         nLastLineRead++;
+        poRowsCounter->Increment();
     }
 
     nBufferStartLine = nLine;
@@ -108,9 +108,11 @@ class PNGDataset final: public GDALPamDataset
 
     CPLErr      LoadScanline( int );
     CPLErr      LoadInterlacedChunk( int );
+    bool        LoadWholeImage();
     void        Restart();
 
     int         bHasTriedLoadWorldFile;
+    int         bWholeImageLoadingFailed;
     void        LoadWorldFile();
     CPLString   osWldFilename;
 
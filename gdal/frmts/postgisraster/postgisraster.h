@@ -178,6 +178,10 @@ private:
     CPLMutex* hMutex;
     std::map<CPLString, PGconn*> oMapConnection{};
 
+    // Results of metadata queries, with the time they were executed
+    std::map<std::pair<PGconn*, CPLString>,
+             std::pair<PGresult*, double>> oMapMetadataQueryResults{};
+
     CPL_DISALLOW_COPY_ASSIGN(PostGISRasterDriver)
 public:
     PostGISRasterDriver();
@@ -186,6 +190,8 @@ public:
                         const char *pszServiceIn, const char *pszDbnameIn,
                         const char *pszHostIn, const char *pszPortIn,
                         const char *pszUserIn);
+  PGresult *ExecMetadataQuery(PGconn *poConn, const char *pszQuery);
+  void InvalidateMetadataCache(PGconn *poConn);
 };
 
 /***********************************************************************
@@ -345,7 +351,7 @@ public:
     GBool LoadSources(int nXOff, int nYOff, int nXSize, int nYSize, int nBand);
     GBool PolygonFromCoords(int nXOff, int nYOff, int nXEndOff,
         int nYEndOff,double adfProjWin[8]);
-    void CacheTile(const char* pszMetadata, const char* pszRaster, const char *pszPKID, int nBand, bool bAllBandCaching);
+    void CacheTile(const char* pszMetadata, const GByte* pabyRaster, int nRasterLength, const char *pszPKID, int nBand, bool bAllBandCaching);
 };
 
 /***********************************************************************
@@ -47,6 +47,30 @@ CPL_CVSID("$Id$")
 #define rint(x) floor((x) + 0.5)
 #endif
 
+/************************************************************************/
+/*                        ExecMetadataQuery()                           */
+/************************************************************************/
+
+// Run a query on the raster table properties, going through the metadata
+// cache of the driver.
+static PGresult* ExecMetadataQuery(PGconn* poConn, const char* pszQuery)
+{
+    PostGISRasterDriver * poDriver =
+        static_cast<PostGISRasterDriver *>(GDALGetDriverByName("PostGISRaster"));
+    return poDriver->ExecMetadataQuery(poConn, pszQuery);
+}
+
+/************************************************************************/
+/*                      InvalidateMetadataCache()                       */
+/************************************************************************/
+
+static void InvalidateMetadataCache(PGconn* poConn)
+{
+    PostGISRasterDriver * poDriver =
+        static_cast<PostGISRasterDriver *>(GDALGetDriverByName("PostGISRaster"));
+    poDriver->InvalidateMetadataCache(poConn);
+}
+
 /* PostgreSQL defaults */
 #define DEFAULT_SCHEMA          "public"
 #define DEFAULT_COLUMN          "rast"
@@ -354,7 +378,7 @@ GBool PostGISRasterDataset::HasSpatialIndex()
         osCommand.c_str());
 #endif
 
-    poResult = PQexec(poConn, osCommand.c_str());
+    poResult = ExecMetadataQuery(poConn, osCommand.c_str());
 
     if (poResult == nullptr ||
         PQresultStatus(poResult) != PGRES_TUPLES_OK ||
@@ -411,7 +435,7 @@ const char * PostGISRasterDataset::GetPrimaryKeyRef()
         osCommand.c_str());
 #endif
 
-    poResult = PQexec(poConn, osCommand.c_str());
+    poResult = ExecMetadataQuery(poConn, osCommand.c_str());
 
     if (poResult == nullptr ||
         PQresultStatus(poResult) != PGRES_TUPLES_OK ||
@@ -437,7 +461,7 @@ const char * PostGISRasterDataset::GetPrimaryKeyRef()
             osCommand.c_str());
 #endif
 
-        poResult = PQexec(poConn, osCommand.c_str());
+        poResult = ExecMetadataQuery(poConn, osCommand.c_str());
 
         if (poResult == nullptr ||
             PQresultStatus(poResult) != PGRES_TUPLES_OK ||
@@ -613,7 +637,7 @@ PROverview * PostGISRasterDataset::GetOverviewTables(int * pnOverviews)
         osCommand.c_str());
 #endif
 
-    PGresult* poResult = PQexec(poConn, osCommand.c_str());
+    PGresult* poResult = ExecMetadataQuery(poConn, osCommand.c_str());
 
     if (poResult == nullptr ||
         PQresultStatus(poResult) != PGRES_TUPLES_OK ||
@@ -868,7 +892,8 @@ PostGISRasterTileDataset *
 /*                           CacheTile()                                */
 /************************************************************************/
 void PostGISRasterDataset::CacheTile(const char* pszMetadata,
-                                     const char* pszRaster,
+                                     const GByte* pabyRaster,
+                                     int nRasterLength,
                                      const char *pszPKID,
                                      int nBand,
                                      bool bAllBandCaching)
@@ -911,10 +936,9 @@ void PostGISRasterDataset::CacheTile(const char* pszMetadata,
         nTileXSize * nTileYSize * nBandDataTypeSize;
     const int nExpectedBands = bAllBandCaching ? GetRasterCount() : 1;
 
-    int nWKBLength = 0;
-    struct CPLFreer { void operator() (GByte* x) const { CPLFree(x); } };
-    std::unique_ptr<GByte, CPLFreer> pbyDataAutoFreed(CPLHexToBinary(pszRaster, &nWKBLength));
-    GByte* pbyData = pbyDataAutoFreed.get();
+    // Serialized raster, as returned in binary form by ST_AsBinary()
+    const int nWKBLength = nRasterLength;
+    const GByte* pbyData = pabyRaster;
     const int nMinimumWKBLength = RASTER_HEADER_SIZE +
         BAND_SIZE(1, nBandDataTypeSize) * nExpectedBands;
     if( nWKBLength < nMinimumWKBLength )
@@ -979,16 +1003,9 @@ void PostGISRasterDataset::CacheTile(const char* pszMetadata,
                 return;
             }
 
-            GByte* pbyDataToRead = pbyData + nCurOffset;
+            const GByte* pbyDataToRead = pbyData + nCurOffset;
             nCurOffset += nExpectedBandDataSize;
 
-            if( bSwap && nBandDataTypeSize > 1 )
-            {
-                GDALSwapWords( pbyDataToRead, nBandDataTypeSize,
-                            nTileXSize * nTileYSize,
-                            nBandDataTypeSize );
-            }
-
             /**
             * Manually add each tile data to the cache of the
             * matching PostGISRasterTileRasterBand.
@@ -1000,6 +1017,13 @@ void PostGISRasterDataset::CacheTile(const char* pszMetadata,
                 memcpy(poBlock->GetDataRef(), pbyDataToRead,
                     nExpectedBandDataSize);
 
+                if( bSwap && nBandDataTypeSize > 1 )
+                {
+                    GDALSwapWords( poBlock->GetDataRef(), nBandDataTypeSize,
+                                nTileXSize * nTileYSize,
+                                nBandDataTypeSize );
+                }
+
                 poBlock->DropLock();
             }
         }
@@ -1314,8 +1338,11 @@ GBool PostGISRasterDataset::LoadSources(int nXOff, int nYOff, int nXSize, int nY
                                                       osWHERE);
         }
 
+        // Results are requested in binary format, so that rasters are
+        // transferred as raw bytes instead of hexadecimal text. The other
+        // columns are cast to text so that they can be read as before.
         CPLString osCommand;
-        osCommand.Printf("SELECT %s, ST_Metadata(%s)",
+        osCommand.Printf("SELECT %s::text, ST_Metadata(%s)::text",
                          osPrimaryKeyNameI.c_str(), osColumnI.c_str());
         if( bLoadRasters )
         {
@@ -1331,7 +1358,11 @@ GBool PostGISRasterDataset::LoadSources(int nXOff, int nYOff, int nXSize, int nY
             if( eOutDBResolution == OutDBResolution::SERVER_SIDE ||
                 !bCanUseClientSide )
             {
-                orRasterToFetch = "encode(ST_AsBinary(" + orRasterToFetch + ",TRUE),'hex')";
+                orRasterToFetch = "ST_AsBinary(" + orRasterToFetch + ",TRUE)";
+            }
+            else
+            {
+                orRasterToFetch = "ST_AsBinary(" + orRasterToFetch + ")";
             }
             osCommand += ", " + orRasterToFetch;
         }
@@ -1343,7 +1374,8 @@ GBool PostGISRasterDataset::LoadSources(int nXOff, int nYOff, int nXSize, int nY
             osCommand += osWHERE;
         }
 
-        poResult = PQexec(poConn, osCommand.c_str());
+        poResult = PQexecParams(poConn, osCommand.c_str(), 0, nullptr,
+                                nullptr, nullptr, nullptr, 1);
 
 #ifdef DEBUG_QUERY
         CPLDebug("PostGIS_Raster",
@@ -1394,8 +1426,11 @@ GBool PostGISRasterDataset::LoadSources(int nXOff, int nYOff, int nXSize, int nY
 
             if( bLoadRasters && poRTDS != nullptr )
             {
-                const char* pszRaster = PQgetvalue(poResult, i, 2);
-                CacheTile(pszMetadata, pszRaster, pszPKID, nBand, bAllBandCaching);
+                CacheTile(pszMetadata,
+                          reinterpret_cast<const GByte*>(
+                              PQgetvalue(poResult, i, 2)),
+                          PQgetlength(poResult, i, 2),
+                          pszPKID, nBand, bAllBandCaching);
             }
         }
 
@@ -1568,7 +1603,7 @@ BandMetadata * PostGISRasterDataset::GetBandsMetadata(int * pnBands)
         osCommand.c_str());
 #endif
 
-    poResult = PQexec(poConn, osCommand.c_str());
+    poResult = ExecMetadataQuery(poConn, osCommand.c_str());
     /* Error getting info from database */
     if (poResult == nullptr ||
         PQresultStatus(poResult) != PGRES_TUPLES_OK ||
@@ -2246,7 +2281,7 @@ GBool PostGISRasterDataset::SetRasterProperties
         osCommand.c_str());
 #endif
 
-        poResult = PQexec(poConn, osCommand.c_str());
+        poResult = ExecMetadataQuery(poConn, osCommand.c_str());
     }
     else
     {
@@ -2275,7 +2310,7 @@ GBool PostGISRasterDataset::SetRasterProperties
         osCommand.c_str());
 #endif
 
-        poResult = PQexec(poConn, osCommand.c_str());
+        poResult = ExecMetadataQuery(poConn, osCommand.c_str());
 
         // Query execution error
         if(poResult == nullptr ||
@@ -2361,7 +2396,7 @@ GBool PostGISRasterDataset::SetRasterProperties
                 "First query: %s", osCommand.c_str());
 #endif
 
-            poResult = PQexec(poConn, osCommand.c_str());
+            poResult = ExecMetadataQuery(poConn, osCommand.c_str());
         }
 
         // We already found the data in raster_columns
@@ -2510,7 +2545,7 @@ GBool PostGISRasterDataset::SetRasterProperties
                         osCommand.c_str());
                 #endif
 
-                poResult = PQexec(poConn, osCommand.c_str());
+                poResult = ExecMetadataQuery(poConn, osCommand.c_str());
                 if (poResult == nullptr ||
                     PQresultStatus(poResult) != PGRES_TUPLES_OK ||
                     PQntuples(poResult) <= 0) {
@@ -3318,6 +3353,8 @@ CPLErr PostGISRasterDataset::_SetProjection(const char * pszProjectionRef) {
         return CE_Failure;
     }
 
+    InvalidateMetadataCache(poConn);
+
     /*****************************************************************
      * Look for projection with this text
      *****************************************************************/
@@ -3696,6 +3733,8 @@ PostGISRasterDataset::CreateCopy( CPL_UNUSED const char * pszFilename,
         }
     }
 
+    InvalidateMetadataCache(poConn);
+
     // commit transaction
     poResult = PQexec(poConn, "commit");
     if (poResult == nullptr ||
@@ -3900,6 +3939,9 @@ PostGISRasterDataset::Delete(const char* pszFilename)
             PQclear(poResult);
     }
 
+    if( poConn != nullptr )
+        InvalidateMetadataCache(poConn);
+
     // if mode == NO_MODE, the begin transaction above did not complete,
     // so no commit is necessary
     if (nMode != NO_MODE) {
@@ -31,6 +31,8 @@
 #include "postgisraster.h"
 #include "cpl_multiproc.h"
 
+#include <ctime>
+
 CPL_CVSID("$Id$")
 
 /************************
@@ -47,6 +49,8 @@ PostGISRasterDriver::~PostGISRasterDriver() {
 
     if( hMutex != nullptr )
         CPLDestroyMutex(hMutex);
+    for( auto& oIterResult: oMapMetadataQueryResults )
+        PQclear(oIterResult.second.first);
     std::map<CPLString, PGconn*>::iterator oIter = oMapConnection.begin();
     for(; oIter != oMapConnection.end(); ++oIter )
         PQfinish(oIter->second);
@@ -116,3 +120,75 @@ PGconn *PostGISRasterDriver::GetConnection(const char *pszConnectionString,
     oMapConnection[osKey] = poConn;
     return poConn;
 }
+
+/***************************************************************************
+ * \brief Execute a query returning metadata about a raster table
+ *
+ * Opening a dataset runs several queries to discover the properties of the
+ * raster table (extent, tile size, bands, overviews, primary key...). When
+ * the PR_METADATA_CACHE_TTL configuration option is set to a positive
+ * number of seconds, successful results of those queries are kept by the
+ * driver and reused by later opens on the same connection, until they are
+ * older than that delay. By default, nothing is cached.
+ *
+ * The returned result must be freed with PQclear() by the caller.
+ ***************************************************************************/
+PGresult *PostGISRasterDriver::ExecMetadataQuery(PGconn *poConn,
+                                                 const char *pszQuery)
+{
+    const double dfTTL =
+        CPLAtof(CPLGetConfigOption("PR_METADATA_CACHE_TTL", "0"));
+    if( dfTTL <= 0 )
+        return PQexec(poConn, pszQuery);
+
+    const auto oKey = std::make_pair(poConn, CPLString(pszQuery));
+    const double dfNow = static_cast<double>(time(nullptr));
+
+    CPLMutexHolderD(&hMutex);
+    auto oIter = oMapMetadataQueryResults.find(oKey);
+    if( oIter != oMapMetadataQueryResults.end() )
+    {
+        if( dfNow - oIter->second.second <= dfTTL )
+        {
+            return PQcopyResult(oIter->second.first,
+                                PG_COPYRES_ATTRS | PG_COPYRES_TUPLES);
+        }
+        PQclear(oIter->second.first);
+        oMapMetadataQueryResults.erase(oIter);
+    }
+
+    PGresult* poResult = PQexec(poConn, pszQuery);
+    if( poResult != nullptr &&
+        PQresultStatus(poResult) == PGRES_TUPLES_OK )
+    {
+        PGresult* poCopy = PQcopyResult(poResult,
+                                        PG_COPYRES_ATTRS | PG_COPYRES_TUPLES);
+        if( poCopy != nullptr )
+            oMapMetadataQueryResults[oKey] = std::make_pair(poCopy, dfNow);
+    }
+    return poResult;
+}
+
+/***************************************************************************
+ * \brief Forget the cached metadata query results of a connection
+ *
+ * Must be called when raster tables are created, modified or deleted
+ * through this connection.
+ ***************************************************************************/
+void PostGISRasterDriver::InvalidateMetadataCache(PGconn *poConn)
+{
+    CPLMutexHolderD(&hMutex);
+    auto oIter = oMapMetadataQueryResults.begin();
+    while( oIter != oMapMetadataQueryResults.end() )
+    {
+        if( oIter->first.first == poConn )
+        {
+            PQclear(oIter->second.first);
+            oIter = oMapMetadataQueryResults.erase(oIter);
+        }
+        else
+        {
+            ++oIter;
+        }
+    }
+}
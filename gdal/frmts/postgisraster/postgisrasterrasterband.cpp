@@ -510,14 +510,20 @@ CPLErr PostGISRasterRasterBand::IRasterIO(GDALRWFlag eRWFlag, int nXOff,
             osRasterToFetch = osColumnI;
         else
             osRasterToFetch.Printf("ST_Band(%s, %d)", osColumnI.c_str(), nBand);
+        // Results are requested in binary format, so that rasters are
+        // transferred as raw bytes instead of hexadecimal text.
         if( poRDS->eOutDBResolution == OutDBResolution::SERVER_SIDE ||
             !bCanUseClientSide )
         {
-            osRasterToFetch = "encode(ST_AsBinary(" + osRasterToFetch + ",TRUE),'hex')";
+            osRasterToFetch = "ST_AsBinary(" + osRasterToFetch + ",TRUE)";
+        }
+        else
+        {
+            osRasterToFetch = "ST_AsBinary(" + osRasterToFetch + ")";
         }
 
         CPLString osCommand;
-        osCommand.Printf("SELECT %s, ST_Metadata(%s), %s FROM %s.%s",
+        osCommand.Printf("SELECT %s::text, ST_Metadata(%s)::text, %s FROM %s.%s",
                          (poRDS->GetPrimaryKeyRef()) ? poRDS->GetPrimaryKeyRef() : "NULL",
                          osColumnI.c_str(),
                          osRasterToFetch.c_str(),
@@ -527,7 +533,9 @@ CPLErr PostGISRasterRasterBand::IRasterIO(GDALRWFlag eRWFlag, int nXOff,
             osCommand += " WHERE " + osWHERE;
         }
 
-        PGresult * poResult = PQexec(poRDS->poConn, osCommand.c_str());
+        PGresult * poResult = PQexecParams(poRDS->poConn, osCommand.c_str(),
+                                           0, nullptr, nullptr, nullptr,
+                                           nullptr, 1);
 
 #ifdef DEBUG_QUERY
         CPLDebug("PostGIS_Raster",
@@ -570,8 +578,11 @@ CPLErr PostGISRasterRasterBand::IRasterIO(GDALRWFlag eRWFlag, int nXOff,
         {
             const char *pszPKID = PQgetvalue(poResult, i, 0);
             const char* pszMetadata = PQgetvalue(poResult, i, 1);
-            const char* pszRaster = PQgetvalue(poResult, i, 2);
-            poRDS->CacheTile(pszMetadata, pszRaster, pszPKID, nBand, bAllBandCaching);
+            const GByte* pabyRaster =
+                reinterpret_cast<const GByte*>(PQgetvalue(poResult, i, 2));
+            const int nRasterLength = PQgetlength(poResult, i, 2);
+            poRDS->CacheTile(pszMetadata, pabyRaster, nRasterLength, pszPKID,
+                             nBand, bAllBandCaching);
         } // All tiles have been added to cache
 
         PQclear(poResult);
@@ -117,9 +117,15 @@ CPLErr PostGISRasterTileRasterBand::IReadBlock(int /*nBlockXOff*/,
                            osColumnI.c_str(), nBand);
     // We don't honour CLIENT_SIDE_IF_POSSIBLE since it would be likely too
     // costly in that context.
+    // The result is requested in binary format, so that the raster is
+    // transferred as raw bytes instead of hexadecimal text.
     if( poRTDS->poRDS->eOutDBResolution != OutDBResolution::CLIENT_SIDE )
     {
-        osRasterToFetch = "encode(ST_AsBinary(" + osRasterToFetch + ",TRUE),'hex')";
+        osRasterToFetch = "ST_AsBinary(" + osRasterToFetch + ",TRUE)";
+    }
+    else
+    {
+        osRasterToFetch = "ST_AsBinary(" + osRasterToFetch + ")";
     }
 
     osCommand.Printf("SELECT %s FROM %s.%s WHERE ",
@@ -143,7 +149,8 @@ CPLErr PostGISRasterTileRasterBand::IReadBlock(int /*nBlockXOff*/,
             dfTileUpperLeftY);
     }
 
-    poResult = PQexec(poRTDS->poRDS->poConn, osCommand.c_str());
+    poResult = PQexecParams(poRTDS->poRDS->poConn, osCommand.c_str(),
+                            0, nullptr, nullptr, nullptr, nullptr, 1);
 
 #ifdef DEBUG_QUERY
     CPLDebug("PostGIS_Raster", "PostGISRasterTileRasterBand::IReadBlock(): "
@@ -178,11 +185,11 @@ CPLErr PostGISRasterTileRasterBand::IReadBlock(int /*nBlockXOff*/,
     int nExpectedDataSize =
         nBlockXSize * nBlockYSize * nPixelSize;
 
-    struct CPLFreer { void operator() (GByte* x) const { CPLFree(x); } };
-    std::unique_ptr<GByte, CPLFreer> pbyDataAutoFreed(
-        CPLHexToBinary(PQgetvalue(poResult, 0, 0), &nWKBLength));
-    GByte* pbyData = pbyDataAutoFreed.get();
-    PQclear(poResult);
+    struct PGresultFreer { void operator() (PGresult* x) const { PQclear(x); } };
+    std::unique_ptr<PGresult, PGresultFreer> poResultAutoFreed(poResult);
+    const GByte* pbyData =
+        reinterpret_cast<const GByte*>(PQgetvalue(poResult, 0, 0));
+    nWKBLength = PQgetlength(poResult, 0, 0);
 
     const int nMinimumWKBLength = RASTER_HEADER_SIZE + BAND_SIZE(1, nPixelSize);
     if( nWKBLength < nMinimumWKBLength )
@@ -205,7 +212,7 @@ CPLErr PostGISRasterTileRasterBand::IReadBlock(int /*nBlockXOff*/,
             return CE_Failure;
         }
 
-        GByte * pbyDataToRead = GET_BAND_DATA(pbyData,1,
+        const GByte * pbyDataToRead = GET_BAND_DATA(pbyData,1,
                                               nPixelSize,nExpectedDataSize);
 
         // Do byte-swapping if necessary */
@@ -216,14 +223,14 @@ CPLErr PostGISRasterTileRasterBand::IReadBlock(int /*nBlockXOff*/,
         const bool bSwap = bIsLittleEndian;
 #endif
 
+        memcpy(pImage, pbyDataToRead, nExpectedDataSize);
+
         if( bSwap && nPixelSize > 1 )
         {
-            GDALSwapWords( pbyDataToRead, nPixelSize,
+            GDALSwapWords( pImage, nPixelSize,
                            nBlockXSize * nBlockYSize,
                            nPixelSize );
         }
-
-        memcpy(pImage, pbyDataToRead, nExpectedDataSize);
     }
     else
     {
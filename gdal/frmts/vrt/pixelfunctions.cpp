@@ -27,7 +27,12 @@
  * DEALINGS IN THE SOFTWARE.
  *****************************************************************************/
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "cpl_string.h"
 #include "gdal.h"
 #include "vrtdataset.h"
 
@@ -1002,6 +1007,549 @@ CPLErr InterpolatePixelFunc( void **papoSources, int nSources, void *pData,
     return CE_None;
 }
 
+/************************************************************************/
+/*                        ExpressionPixelFunc()                         */
+/************************************************************************/
+
+// Expressions are compiled once per call into a small postfix program, which
+// is then evaluated over runs of up to EXPR_CHUNK_SIZE pixels. Each
+// instruction is a simple loop over the run, that the compiler can
+// vectorize, so the cost of interpreting the program is amortized over
+// the pixels of the run.
+
+namespace {
+
+constexpr int EXPR_CHUNK_SIZE = 256;
+
+enum class ExprOp
+{
+    CONST, SRC,
+    NEG, NOT,
+    ADD, SUB, MUL, DIV, POW,
+    LT, LE, GT, GE, EQ, NE, AND, OR,
+    MIN, MAX, ATAN2, FMOD,
+    SELECT,
+    SQRT, ABS, LOG, LOG10, EXP, SIN, COS, TAN, ASIN, ACOS, ATAN,
+    FLOOR, CEIL, ROUND, ISNAN
+};
+
+struct ExprInstr
+{
+    ExprOp eOp;
+    double dfValue;
+    int    nSlot;
+};
+
+class ExpressionProgram
+{
+    const char*             m_pszExpr = nullptr;
+    const char*             m_pszCur = nullptr;
+    int                     m_nSources = 0;
+    int                     m_nDepth = 0;
+    int                     m_nMaxDepth = 0;
+    std::vector<ExprInstr>  m_aoInstr{};
+    std::vector<int>        m_anSources{};
+
+    void SkipBlanks()
+        { while( *m_pszCur == ' ' || *m_pszCur == '\t' ||
+                 *m_pszCur == '\n' || *m_pszCur == '\r' ) ++m_pszCur; }
+    bool Accept( const char* pszToken );
+    bool Error( const char* pszMsg );
+    void Emit( ExprOp eOp, int nArgs, double dfValue = 0, int nSlot = 0 );
+
+    bool ParseTernary();
+    bool ParseOr();
+    bool ParseAnd();
+    bool ParseComparison();
+    bool ParseAdditive();
+    bool ParseMultiplicative();
+    bool ParseUnary();
+    bool ParsePower();
+    bool ParsePrimary();
+
+  public:
+    bool Compile( const char* pszExpr, int nSources );
+
+    int GetStackDepth() const { return m_nMaxDepth; }
+    const std::vector<int>& GetSources() const { return m_anSources; }
+
+    void Evaluate( const double* padfSrc, double* padfStack, int nCount ) const;
+};
+
+bool ExpressionProgram::Accept( const char* pszToken )
+{
+    SkipBlanks();
+    const size_t nLen = strlen(pszToken);
+    if( strncmp(m_pszCur, pszToken, nLen) != 0 )
+        return false;
+    m_pszCur += nLen;
+    return true;
+}
+
+bool ExpressionProgram::Error( const char* pszMsg )
+{
+    CPLError(CE_Failure, CPLE_AppDefined,
+             "Invalid expression '%s' at offset %d: %s",
+             m_pszExpr, static_cast<int>(m_pszCur - m_pszExpr), pszMsg);
+    return false;
+}
+
+void ExpressionProgram::Emit( ExprOp eOp, int nArgs, double dfValue, int nSlot )
+{
+    ExprInstr sInstr;
+    sInstr.eOp = eOp;
+    sInstr.dfValue = dfValue;
+    sInstr.nSlot = nSlot;
+    m_aoInstr.push_back(sInstr);
+    // Each instruction pops its arguments and pushes its result.
+    m_nDepth += 1 - nArgs;
+    m_nMaxDepth = std::max(m_nMaxDepth, m_nDepth);
+}
+
+bool ExpressionProgram::Compile( const char* pszExpr, int nSources )
+{
+    m_pszExpr = pszExpr;
+    m_pszCur = pszExpr;
+    m_nSources = nSources;
+    if( !ParseTernary() )
+        return false;
+    SkipBlanks();
+    if( *m_pszCur != '\0' )
+        return Error("unexpected character");
+    return true;
+}
+
+bool ExpressionProgram::ParseTernary()
+{
+    if( !ParseOr() )
+        return false;
+    if( Accept("?") )
+    {
+        if( !ParseTernary() )
+            return false;
+        if( !Accept(":") )
+            return Error("':' expected");
+        if( !ParseTernary() )
+            return false;
+        Emit(ExprOp::SELECT, 3);
+    }
+    return true;
+}
+
+bool ExpressionProgram::ParseOr()
+{
+    if( !ParseAnd() )
+        return false;
+    while( Accept("||") )
+    {
+        if( !ParseAnd() )
+            return false;
+        Emit(ExprOp::OR, 2);
+    }
+    return true;
+}
+
+bool ExpressionProgram::ParseAnd()
+{
+    if( !ParseComparison() )
+        return false;
+    while( Accept("&&") )
+    {
+        if( !ParseComparison() )
+            return false;
+        Emit(ExprOp::AND, 2);
+    }
+    return true;
+}
+
+bool ExpressionProgram::ParseComparison()
+{
+    if( !ParseAdditive() )
+        return false;
+    while( true )
+    {
+        ExprOp eOp;
+        // Two character operators must be tested first.
+        if( Accept("<=") ) eOp = ExprOp::LE;
+        else if( Accept(">=") ) eOp = ExprOp::GE;
+        else if( Accept("==") ) eOp = ExprOp::EQ;
+        else if( Accept("!=") ) eOp = ExprOp::NE;
+        else if( Accept("<") ) eOp = ExprOp::LT;
+        else if( Accept(">") ) eOp = ExprOp::GT;
+        else return true;
+        if( !ParseAdditive() )
+            return false;
+        Emit(eOp, 2);
+    }
+}
+
+bool ExpressionProgram::ParseAdditive()
+{
+    if( !ParseMultiplicative() )
+        return false;
+    while( true )
+    {
+        ExprOp eOp;
+        if( Accept("+") ) eOp = ExprOp::ADD;
+        else if( Accept("-") ) eOp = ExprOp::SUB;
+        else return true;
+        if( !ParseMultiplicative() )
+            return false;
+        Emit(eOp, 2);
+    }
+}
+
+bool ExpressionProgram::ParseMultiplicative()
+{
+    if( !ParseUnary() )
+        return false;
+    while( true )
+    {
+        ExprOp eOp;
+        if( Accept("*") ) eOp = ExprOp::MUL;
+        else if( Accept("/") ) eOp = ExprOp::DIV;
+        else if( Accept("%") ) eOp = ExprOp::FMOD;
+        else return true;
+        if( !ParseUnary() )
+            return false;
+        Emit(eOp, 2);
+    }
+}
+
+bool ExpressionProgram::ParseUnary()
+{
+    if( Accept("-") )
+    {
+        if( !ParseUnary() )
+            return false;
+        Emit(ExprOp::NEG, 1);
+        return true;
+    }
+    if( Accept("+") )
+        return ParseUnary();
+    SkipBlanks();
+    if( m_pszCur[0] == '!' && m_pszCur[1] != '=' )
+    {
+        ++m_pszCur;
+        if( !ParseUnary() )
+            return false;
+        Emit(ExprOp::NOT, 1);
+        return true;
+    }
+    return ParsePower();
+}
+
+bool ExpressionProgram::ParsePower()
+{
+    if( !ParsePrimary() )
+        return false;
+    if( Accept("^") )
+    {
+        // Right associative, and binds tighter than unary minus on its
+        // left: -2^2 is -4, 2^-1 is 0.5
+        if( !ParseUnary() )
+            return false;
+        Emit(ExprOp::POW, 2);
+    }
+    return true;
+}
+
+bool ExpressionProgram::ParsePrimary()
+{
+    SkipBlanks();
+    const char ch = *m_pszCur;
+
+    if( (ch >= '0' && ch <= '9') || ch == '.' )
+    {
+        char* pszEnd = nullptr;
+        const double dfVal = CPLStrtod(m_pszCur, &pszEnd);
+        if( pszEnd == m_pszCur )
+            return Error("invalid number");
+        m_pszCur = pszEnd;
+        Emit(ExprOp::CONST, 0, dfVal);
+        return true;
+    }
+
+    if( ch == '(' )
+    {
+        ++m_pszCur;
+        if( !ParseTernary() )
+            return false;
+        if( !Accept(")") )
+            return Error("')' expected");
+        return true;
+    }
+
+    if( !isalpha(static_cast<unsigned char>(ch)) )
+        return Error(ch == '\0' ? "unexpected end of expression" :
+                                  "operand expected");
+
+    const char* pszStart = m_pszCur;
+    while( isalnum(static_cast<unsigned char>(*m_pszCur)) || *m_pszCur == '_' )
+        ++m_pszCur;
+    const std::string osName(pszStart, m_pszCur - pszStart);
+
+/* -------------------------------------------------------------------- */
+/*      Source band reference: B1, B2, ...                              */
+/* -------------------------------------------------------------------- */
+    if( (osName[0] == 'B' || osName[0] == 'b') && osName.size() > 1 &&
+        osName.find_first_not_of("0123456789", 1) == std::string::npos )
+    {
+        const int nSrc = atoi(osName.c_str() + 1);
+        if( nSrc < 1 || nSrc > m_nSources )
+        {
+            m_pszCur = pszStart;
+            return Error(CPLSPrintf("%s does not refer to a source "
+                                    "(%d sources available)",
+                                    osName.c_str(), m_nSources));
+        }
+        auto oIter = std::find(m_anSources.begin(), m_anSources.end(), nSrc - 1);
+        const int nSlot = static_cast<int>(oIter - m_anSources.begin());
+        if( oIter == m_anSources.end() )
+            m_anSources.push_back(nSrc - 1);
+        Emit(ExprOp::SRC, 0, 0, nSlot);
+        return true;
+    }
+
+    if( EQUAL(osName.c_str(), "pi") )
+    {
+        Emit(ExprOp::CONST, 0, M_PI);
+        return true;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Functions.                                                      */
+/* -------------------------------------------------------------------- */
+    static const struct
+    {
+        const char* pszName;
+        ExprOp      eOp;
+        int         nArgs;
+    } asFunctions[] = {
+        { "sqrt", ExprOp::SQRT, 1 },
+        { "abs", ExprOp::ABS, 1 },
+        { "log", ExprOp::LOG, 1 },
+        { "log10", ExprOp::LOG10, 1 },
+        { "exp", ExprOp::EXP, 1 },
+        { "sin", ExprOp::SIN, 1 },
+        { "cos", ExprOp::COS, 1 },
+        { "tan", ExprOp::TAN, 1 },
+        { "asin", ExprOp::ASIN, 1 },
+        { "acos", ExprOp::ACOS, 1 },
+        { "atan", ExprOp::ATAN, 1 },
+        { "floor", ExprOp::FLOOR, 1 },
+        { "ceil", ExprOp::CEIL, 1 },
+        { "round", ExprOp::ROUND, 1 },
+        { "isnan", ExprOp::ISNAN, 1 },
+        { "min", ExprOp::MIN, 2 },
+        { "max", ExprOp::MAX, 2 },
+        { "pow", ExprOp::POW, 2 },
+        { "atan2", ExprOp::ATAN2, 2 },
+        { "fmod", ExprOp::FMOD, 2 },
+    };
+    for( const auto& sFunc : asFunctions )
+    {
+        if( !EQUAL(osName.c_str(), sFunc.pszName) )
+            continue;
+        if( !Accept("(") )
+            return Error("'(' expected");
+        for( int i = 0; i < sFunc.nArgs; ++i )
+        {
+            if( i > 0 && !Accept(",") )
+                return Error("',' expected");
+            if( !ParseTernary() )
+                return false;
+        }
+        if( !Accept(")") )
+            return Error("')' expected");
+        Emit(sFunc.eOp, sFunc.nArgs);
+        return true;
+    }
+
+    m_pszCur = pszStart;
+    return Error(CPLSPrintf("unknown identifier '%s'", osName.c_str()));
+}
+
+// padfSrc contains the values of the sources returned by GetSources(), each
+// one in a run of EXPR_CHUNK_SIZE values. The result is left in the first
+// run of padfStack.
+void ExpressionProgram::Evaluate( const double* padfSrc, double* padfStack,
+                                  int nCount ) const
+{
+    double* padfTop = padfStack - EXPR_CHUNK_SIZE;
+
+#define EXPR_UNARY(expr) \
+    for( int i = 0; i < nCount; ++i ) { const double x = padfTop[i]; \
+                                        padfTop[i] = (expr); } \
+    break
+
+#define EXPR_BINARY(expr) \
+    { const double* padfB = padfTop; padfTop -= EXPR_CHUNK_SIZE; \
+      for( int i = 0; i < nCount; ++i ) { const double a = padfTop[i]; \
+                                          const double b = padfB[i]; \
+                                          padfTop[i] = (expr); } } \
+    break
+
+    for( const auto& sInstr : m_aoInstr )
+    {
+        switch( sInstr.eOp )
+        {
+            case ExprOp::CONST:
+                padfTop += EXPR_CHUNK_SIZE;
+                std::fill(padfTop, padfTop + nCount, sInstr.dfValue);
+                break;
+            case ExprOp::SRC:
+                padfTop += EXPR_CHUNK_SIZE;
+                memcpy(padfTop, padfSrc + sInstr.nSlot * EXPR_CHUNK_SIZE,
+                       nCount * sizeof(double));
+                break;
+            case ExprOp::NEG: EXPR_UNARY(-x);
+            case ExprOp::NOT: EXPR_UNARY(x == 0 ? 1.0 : 0.0);
+            case ExprOp::SQRT: EXPR_UNARY(std::sqrt(x));
+            case ExprOp::ABS: EXPR_UNARY(std::fabs(x));
+            case ExprOp::LOG: EXPR_UNARY(std::log(x));
+            case ExprOp::LOG10: EXPR_UNARY(std::log10(x));
+            case ExprOp::EXP: EXPR_UNARY(std::exp(x));
+            case ExprOp::SIN: EXPR_UNARY(std::sin(x));
+            case ExprOp::COS: EXPR_UNARY(std::cos(x));
+            case ExprOp::TAN: EXPR_UNARY(std::tan(x));
+            case ExprOp::ASIN: EXPR_UNARY(std::asin(x));
+            case ExprOp::ACOS: EXPR_UNARY(std::acos(x));
+            case ExprOp::ATAN: EXPR_UNARY(std::atan(x));
+            case ExprOp::FLOOR: EXPR_UNARY(std::floor(x));
+            case ExprOp::CEIL: EXPR_UNARY(std::ceil(x));
+            case ExprOp::ROUND: EXPR_UNARY(std::round(x));
+            case ExprOp::ISNAN: EXPR_UNARY(std::isnan(x) ? 1.0 : 0.0);
+            case ExprOp::ADD: EXPR_BINARY(a + b);
+            case ExprOp::SUB: EXPR_BINARY(a - b);
+            case ExprOp::MUL: EXPR_BINARY(a * b);
+            case ExprOp::DIV: EXPR_BINARY(a / b);
+            case ExprOp::POW: EXPR_BINARY(std::pow(a, b));
+            case ExprOp::LT: EXPR_BINARY(a < b ? 1.0 : 0.0);
+            case ExprOp::LE: EXPR_BINARY(a <= b ? 1.0 : 0.0);
+            case ExprOp::GT: EXPR_BINARY(a > b ? 1.0 : 0.0);
+            case ExprOp::GE: EXPR_BINARY(a >= b ? 1.0 : 0.0);
+            case ExprOp::EQ: EXPR_BINARY(a == b ? 1.0 : 0.0);
+            case ExprOp::NE: EXPR_BINARY(a != b ? 1.0 : 0.0);
+            case ExprOp::AND: EXPR_BINARY(a != 0 && b != 0 ? 1.0 : 0.0);
+            case ExprOp::OR: EXPR_BINARY(a != 0 || b != 0 ? 1.0 : 0.0);
+            case ExprOp::MIN: EXPR_BINARY(b < a ? b : a);
+            case ExprOp::MAX: EXPR_BINARY(b > a ? b : a);
+            case ExprOp::ATAN2: EXPR_BINARY(std::atan2(a, b));
+            case ExprOp::FMOD: EXPR_BINARY(std::fmod(a, b));
+            case ExprOp::SELECT:
+            {
+                const double* padfFalse = padfTop;
+                const double* padfTrue = padfTop - EXPR_CHUNK_SIZE;
+                padfTop -= 2 * EXPR_CHUNK_SIZE;
+                for( int i = 0; i < nCount; ++i )
+                    padfTop[i] = padfTop[i] != 0 ? padfTrue[i] : padfFalse[i];
+                break;
+            }
+        }
+    }
+
+#undef EXPR_UNARY
+#undef EXPR_BINARY
+}
+
+} // namespace
+
+static CPLErr ExpressionPixelFunc( void **papoSources, int nSources, void *pData,
+                                   int nXSize, int nYSize,
+                                   GDALDataType eSrcType, GDALDataType eBufType,
+                                   int nPixelSpace, int nLineSpace,
+                                   CSLConstList papszArgs )
+{
+    /* ---- Init ---- */
+    const char* pszExpression = CSLFetchNameValue(papszArgs, "expression");
+    if( pszExpression == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Missing pixel function argument: expression");
+        return CE_Failure;
+    }
+    if( GDALDataTypeIsComplex( eSrcType ) )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "expression pixel function does not support complex "
+                 "source data types");
+        return CE_Failure;
+    }
+
+    bool bHasNoData = false;
+    double dfNoData = 0;
+    if( CSLFetchNameValue(papszArgs, "nodata") != nullptr )
+    {
+        if( FetchDoubleArg(papszArgs, "nodata", &dfNoData) != CE_None )
+            return CE_Failure;
+        bHasNoData = true;
+    }
+    const bool bNoDataIsNan = bHasNoData && std::isnan(dfNoData);
+
+    ExpressionProgram oProgram;
+    if( !oProgram.Compile(pszExpression, nSources) )
+        return CE_Failure;
+
+    const std::vector<int>& anSources = oProgram.GetSources();
+    const int nUsedSources = static_cast<int>(anSources.size());
+    std::vector<double> adfSrc(
+        std::max(1, nUsedSources) * EXPR_CHUNK_SIZE);
+    std::vector<double> adfStack(
+        std::max(1, oProgram.GetStackDepth()) * EXPR_CHUNK_SIZE);
+    const int nSrcTypeSize = GDALGetDataTypeSizeBytes(eSrcType);
+
+    /* ---- Set pixels ---- */
+    for( int iLine = 0; iLine < nYSize; ++iLine )
+    {
+        for( int iCol = 0; iCol < nXSize; iCol += EXPR_CHUNK_SIZE )
+        {
+            const int nCount = std::min(EXPR_CHUNK_SIZE, nXSize - iCol);
+            const size_t nSrcOffset =
+                (static_cast<size_t>(iLine) * nXSize + iCol) * nSrcTypeSize;
+            for( int k = 0; k < nUsedSources; ++k )
+            {
+                GDALCopyWords(
+                    static_cast<const GByte *>(papoSources[anSources[k]]) +
+                        nSrcOffset, eSrcType, nSrcTypeSize,
+                    &adfSrc[k * EXPR_CHUNK_SIZE], GDT_Float64,
+                    static_cast<int>(sizeof(double)), nCount);
+            }
+
+            oProgram.Evaluate(adfSrc.data(), adfStack.data(), nCount);
+            double* padfResult = adfStack.data();
+
+            if( bHasNoData )
+            {
+                // Pixels where a source is nodata, or where the result is
+                // not a number, are set to nodata.
+                for( int i = 0; i < nCount; ++i )
+                {
+                    bool bIsNoData = std::isnan(padfResult[i]);
+                    for( int k = 0; !bIsNoData && k < nUsedSources; ++k )
+                    {
+                        const double dfVal = adfSrc[k * EXPR_CHUNK_SIZE + i];
+                        bIsNoData = bNoDataIsNan ? std::isnan(dfVal) :
+                                                   dfVal == dfNoData;
+                    }
+                    if( bIsNoData )
+                        padfResult[i] = dfNoData;
+                }
+            }
+
+            GDALCopyWords(
+                padfResult, GDT_Float64, static_cast<int>(sizeof(double)),
+                static_cast<GByte *>(pData) +
+                    static_cast<GPtrDiff_t>(nLineSpace) * iLine +
+                    static_cast<GPtrDiff_t>(iCol) * nPixelSpace,
+                eBufType, nPixelSpace, nCount);
+        }
+    }
+
+    /* ---- Return success ---- */
+    return CE_None;
+}  // ExpressionPixelFunc
+
 /************************************************************************/
 /*                     GDALRegisterDefaultPixelFunc()                   */
 /************************************************************************/
@@ -1044,6 +1592,9 @@ CPLErr InterpolatePixelFunc( void **papoSources, int nSources, void *pData,
  *                         using linear interpolation
  * - "interpolate_exp": interpolate values between two raster bands using
  *                      exponential interpolation
+ * - "expression": evaluate the arithmetic expression given in the
+ *                 "expression" argument, where B1, B2, ... refer to the
+ *                 sources
  *
  * @see GDALAddDerivedBandPixelFunc
  *
@@ -1071,6 +1622,20 @@ CPLErr GDALRegisterDefaultPixelFunc()
     GDALAddDerivedBandPixelFuncWithArgs("pow", PowPixelFunc, nullptr);
     GDALAddDerivedBandPixelFuncWithArgs("interpolate_linear", InterpolatePixelFunc<InterpolateLinear>, nullptr);
     GDALAddDerivedBandPixelFuncWithArgs("interpolate_exp", InterpolatePixelFunc<InterpolateExponential>, nullptr);
+    GDALAddDerivedBandPixelFuncWithArgs("expression", ExpressionPixelFunc, nullptr);
+
+    // All above functions compute each pixel from the same pixel of the
+    // sources, and have no state, so they can be applied concurrently on
+    // ranges of rows.
+    for( const char* pszFuncName : { "real", "imag", "complex", "mod",
+                                     "phase", "conj", "sum", "diff", "mul",
+                                     "cmul", "inv", "intensity", "sqrt",
+                                     "log10", "dB", "dB2amp", "dB2pow", "pow",
+                                     "interpolate_linear", "interpolate_exp",
+                                     "expression" } )
+    {
+        VRTDerivedRasterBand::SetPixelFunctionReentrant(pszFuncName, true);
+    }
 
     return CE_None;
 }
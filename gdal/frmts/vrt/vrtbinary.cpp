@@ -0,0 +1,1541 @@
+/******************************************************************************
+ *
+ * Project:  Virtual GDAL Datasets
+ * Purpose:  Binary, memory-mappable representation of VRT datasets (.bvrt)
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+/*! @cond Doxygen_Suppress */
+
+/*
+ * A binary VRT (.bvrt) file expresses the same VRTDataset /
+ * VRTSourcedRasterBand / VRTSimpleSource model as a XML VRT, but with
+ * fixed-size little-endian records, so that it can be memory mapped and
+ * opened without visiting its sources. All offsets are absolute file
+ * offsets. String references are 1-based offsets in the string pool (0
+ * meaning no string). A string list is a sequence of nul-terminated strings
+ * ended by an empty string.
+ *
+ * Header (BVRT_HEADER_SIZE bytes):
+ *   0  char[8]  "GDALBVRT"
+ *   8  uint32   format version (BVRT_VERSION)
+ *  12  uint32   header size
+ *  16  int32    raster width
+ *  20  int32    raster height
+ *  24  uint32   number of bands
+ *  28  uint32   flags (BVRT_DS_FLAG_xxx)
+ *  32  double[6] geotransform
+ *  80  uint64   string ref: SRS
+ *  88  uint64   string ref: data axis to SRS axis mapping
+ *  96  double   coordinate epoch (0 if unset)
+ * 104  uint64   string list ref: metadata of the default domain
+ * 112  uint64   offset of the band table
+ * 120  uint64   offset of the string pool
+ * 128  uint64   size of the string pool
+ *
+ * Band record (BVRT_BAND_SIZE bytes):
+ *   0  int32    data type
+ *   4  int32    color interpretation
+ *   8  int32    block width (0 = default)
+ *  12  int32    block height (0 = default)
+ *  16  uint32   flags (BVRT_BAND_FLAG_xxx)
+ *  20  uint32   reserved
+ *  24  double   nodata value
+ *  32  double   offset
+ *  40  double   scale
+ *  48  uint64   string ref: description
+ *  56  uint64   string ref: unit type
+ *  64  uint64   string list ref: metadata of the default domain
+ *  72  uint64   offset of the color table (4 x int16 per entry)
+ *  80  uint32   number of color table entries
+ *  84  uint32   reserved
+ *  88  uint64   number of sources
+ *  96  uint64   offset of the source table
+ *
+ * Source record (BVRT_SOURCE_SIZE bytes):
+ *   0  uint32   source type (BVRT_SOURCE_xxx)
+ *   4  uint32   flags (BVRT_SOURCE_FLAG_xxx)
+ *   8  int32    source band
+ *  12  int32    source data type
+ *  16  int32    source raster width
+ *  20  int32    source raster height
+ *  24  int32    source block width
+ *  28  int32    source block height
+ *  32  uint64   string ref: source filename
+ *  40  uint64   string ref: resampling
+ *  48  double[4] source window
+ *  80  double[4] destination window
+ * 112  double   nodata value
+ */
+
+#include "cpl_port.h"
+#include "vrtdataset.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_mem_cache.h"
+#include "cpl_minixml.h"
+#include "cpl_packed_rtree.h"
+#include "cpl_string.h"
+#include "cpl_virtualmem.h"
+#include "cpl_vsi.h"
+#include "gdal_pam.h"
+#include "gdal_priv.h"
+#include "ogr_spatialref.h"
+
+CPL_CVSID("$Id$")
+
+constexpr char BVRT_MAGIC[] = "GDALBVRT";
+constexpr size_t BVRT_MAGIC_SIZE = 8;
+constexpr GUInt32 BVRT_VERSION = 1;
+
+constexpr size_t BVRT_HEADER_SIZE = 136;
+constexpr size_t BVRT_BAND_SIZE = 104;
+constexpr size_t BVRT_SOURCE_SIZE = 120;
+constexpr size_t BVRT_COLOR_ENTRY_SIZE = 8;
+
+constexpr GUInt32 BVRT_DS_FLAG_GEOTRANSFORM = 0x1;
+
+constexpr GUInt32 BVRT_BAND_FLAG_NODATA = 0x1;
+
+constexpr GUInt32 BVRT_SOURCE_SIMPLE = 0;
+constexpr GUInt32 BVRT_SOURCE_COMPLEX = 1;
+constexpr GUInt32 BVRT_SOURCE_AVERAGED = 2;
+
+constexpr GUInt32 BVRT_SOURCE_FLAG_RELATIVE_TO_VRT = 0x1;
+constexpr GUInt32 BVRT_SOURCE_FLAG_NOT_SHARED = 0x2;
+constexpr GUInt32 BVRT_SOURCE_FLAG_MASK = 0x4;
+constexpr GUInt32 BVRT_SOURCE_FLAG_SRC_RECT = 0x8;
+constexpr GUInt32 BVRT_SOURCE_FLAG_DST_RECT = 0x10;
+constexpr GUInt32 BVRT_SOURCE_FLAG_NODATA = 0x20;
+constexpr GUInt32 BVRT_SOURCE_FLAG_USE_MASK_BAND = 0x40;
+
+/************************************************************************/
+/*                          Decoding helpers                            */
+/************************************************************************/
+
+static GUInt32 BVRTReadUInt32( const GByte* pabyData )
+{
+    GUInt32 nVal = 0;
+    memcpy(&nVal, pabyData, sizeof(nVal));
+    CPL_LSBPTR32(&nVal);
+    return nVal;
+}
+
+static GInt32 BVRTReadInt32( const GByte* pabyData )
+{
+    GInt32 nVal = 0;
+    memcpy(&nVal, pabyData, sizeof(nVal));
+    CPL_LSBPTR32(&nVal);
+    return nVal;
+}
+
+static GUInt64 BVRTReadUInt64( const GByte* pabyData )
+{
+    GUInt64 nVal = 0;
+    memcpy(&nVal, pabyData, sizeof(nVal));
+    CPL_LSBPTR64(&nVal);
+    return nVal;
+}
+
+static double BVRTReadDouble( const GByte* pabyData )
+{
+    double dfVal = 0;
+    memcpy(&dfVal, pabyData, sizeof(dfVal));
+    CPL_LSBPTR64(&dfVal);
+    return dfVal;
+}
+
+/************************************************************************/
+/*                          Encoding helpers                            */
+/************************************************************************/
+
+namespace {
+
+class BVRTWriter
+{
+    std::vector<GByte>& m_abyData;
+
+  public:
+    explicit BVRTWriter( std::vector<GByte>& abyData ): m_abyData(abyData) {}
+
+    size_t GetOffset() const { return m_abyData.size(); }
+
+    void AddBytes( const void* pData, size_t nSize )
+    {
+        const GByte* pabyData = static_cast<const GByte*>(pData);
+        m_abyData.insert(m_abyData.end(), pabyData, pabyData + nSize);
+    }
+
+    void AddUInt32( GUInt32 nVal )
+    {
+        CPL_LSBPTR32(&nVal);
+        AddBytes(&nVal, sizeof(nVal));
+    }
+
+    void AddInt32( GInt32 nVal )
+    {
+        CPL_LSBPTR32(&nVal);
+        AddBytes(&nVal, sizeof(nVal));
+    }
+
+    void AddInt16( GInt16 nVal )
+    {
+        CPL_LSBPTR16(&nVal);
+        AddBytes(&nVal, sizeof(nVal));
+    }
+
+    void AddUInt64( GUInt64 nVal )
+    {
+        CPL_LSBPTR64(&nVal);
+        AddBytes(&nVal, sizeof(nVal));
+    }
+
+    void AddDouble( double dfVal )
+    {
+        CPL_LSBPTR64(&dfVal);
+        AddBytes(&dfVal, sizeof(dfVal));
+    }
+
+    void PatchUInt64( size_t nOffset, GUInt64 nVal )
+    {
+        CPL_LSBPTR64(&nVal);
+        memcpy(&m_abyData[nOffset], &nVal, sizeof(nVal));
+    }
+};
+
+class BVRTStringPool
+{
+    std::string m_osPool{};
+
+  public:
+    GUInt64 AddString( const char* pszStr )
+    {
+        if( pszStr == nullptr )
+            return 0;
+        const GUInt64 nRef = m_osPool.size() + 1;
+        m_osPool.append(pszStr);
+        m_osPool.push_back('\0');
+        return nRef;
+    }
+
+    GUInt64 AddStringList( CSLConstList papszList )
+    {
+        if( papszList == nullptr || papszList[0] == nullptr )
+            return 0;
+        const GUInt64 nRef = m_osPool.size() + 1;
+        for( CSLConstList papszIter = papszList; *papszIter; ++papszIter )
+        {
+            m_osPool.append(*papszIter);
+            m_osPool.push_back('\0');
+        }
+        m_osPool.push_back('\0');
+        return nRef;
+    }
+
+    const std::string& GetPool() const { return m_osPool; }
+};
+
+struct BVRTSourceDef
+{
+    GUInt32     nType = BVRT_SOURCE_SIMPLE;
+    GUInt32     nFlags = 0;
+    int         nSrcBand = 1;
+    GDALDataType eSrcDataType = GDT_Unknown;
+    int         nSrcXSize = 0;
+    int         nSrcYSize = 0;
+    int         nSrcBlockXSize = 0;
+    int         nSrcBlockYSize = 0;
+    GUInt64     nFilenameRef = 0;
+    GUInt64     nResamplingRef = 0;
+    double      adfSrcRect[4] = { -1, -1, -1, -1 };
+    double      adfDstRect[4] = { -1, -1, -1, -1 };
+    double      dfNoData = 0;
+};
+
+struct BVRTBandDef
+{
+    GDALDataType eDataType = GDT_Byte;
+    GDALColorInterp eColorInterp = GCI_Undefined;
+    int         nBlockXSize = 0;
+    int         nBlockYSize = 0;
+    GUInt32     nFlags = 0;
+    double      dfNoData = 0;
+    double      dfOffset = 0;
+    double      dfScale = 1;
+    GUInt64     nDescriptionRef = 0;
+    GUInt64     nUnitTypeRef = 0;
+    GUInt64     nMetadataRef = 0;
+    std::vector<GDALColorEntry> asColorEntries{};
+    std::vector<BVRTSourceDef> asSources{};
+};
+
+} // namespace
+
+/************************************************************************/
+/*                      BVRTCheckAllowedChildren()                      */
+/************************************************************************/
+
+static bool BVRTCheckAllowedChildren( const CPLXMLNode* psNode,
+                                      const char* const* papszAllowed )
+{
+    for( const CPLXMLNode* psIter = psNode->psChild; psIter;
+         psIter = psIter->psNext )
+    {
+        if( psIter->eType != CXT_Element && psIter->eType != CXT_Attribute )
+            continue;
+        if( CSLFindString(papszAllowed, psIter->pszValue) < 0 )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "%s%s of %s is not supported by the binary VRT format",
+                     psIter->eType == CXT_Attribute ? "Attribute " :
+                                                      "Element ",
+                     psIter->pszValue, psNode->pszValue);
+            return false;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                         BVRTParseMetadata()                          */
+/************************************************************************/
+
+static bool BVRTParseMetadata( const CPLXMLNode* psParent,
+                               BVRTStringPool& oPool, GUInt64& nRef )
+{
+    nRef = 0;
+    CPLStringList aosMD;
+    for( const CPLXMLNode* psMD = psParent->psChild; psMD;
+         psMD = psMD->psNext )
+    {
+        if( psMD->eType != CXT_Element || !EQUAL(psMD->pszValue, "Metadata") )
+            continue;
+        const char* pszDomain = CPLGetXMLValue(psMD, "domain", "");
+        if( pszDomain[0] != '\0' ||
+            CPLGetXMLValue(psMD, "format", nullptr) != nullptr )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "Only metadata of the default domain is supported by "
+                     "the binary VRT format");
+            return false;
+        }
+        for( const CPLXMLNode* psMDI = psMD->psChild; psMDI;
+             psMDI = psMDI->psNext )
+        {
+            if( psMDI->eType != CXT_Element ||
+                !EQUAL(psMDI->pszValue, "MDI") )
+                continue;
+            const char* pszKey = CPLGetXMLValue(psMDI, "key", nullptr);
+            if( pszKey == nullptr )
+                continue;
+            aosMD.SetNameValue(pszKey, CPLGetXMLValue(psMDI, nullptr, ""));
+        }
+    }
+    nRef = oPool.AddStringList(aosMD.List());
+    return true;
+}
+
+/************************************************************************/
+/*                          BVRTParseSource()                           */
+/************************************************************************/
+
+static bool BVRTParseSource( const CPLXMLNode* psSrc,
+                             BVRTStringPool& oPool,
+                             BVRTSourceDef& sSource )
+{
+    static const char* const apszSimpleAllowed[] = {
+        "resampling", "SourceFilename", "SourceBand", "SourceProperties",
+        "SrcRect", "DstRect", nullptr };
+    static const char* const apszComplexAllowed[] = {
+        "resampling", "SourceFilename", "SourceBand", "SourceProperties",
+        "SrcRect", "DstRect", "NODATA", "UseMaskBand", nullptr };
+
+    if( EQUAL(psSrc->pszValue, "SimpleSource") )
+        sSource.nType = BVRT_SOURCE_SIMPLE;
+    else if( EQUAL(psSrc->pszValue, "ComplexSource") )
+        sSource.nType = BVRT_SOURCE_COMPLEX;
+    else
+        sSource.nType = BVRT_SOURCE_AVERAGED;
+
+    if( !BVRTCheckAllowedChildren(psSrc,
+            sSource.nType == BVRT_SOURCE_COMPLEX ? apszComplexAllowed :
+                                                   apszSimpleAllowed) )
+        return false;
+
+    const CPLXMLNode* psFilename = CPLGetXMLNode(psSrc, "SourceFilename");
+    static const char* const apszFilenameAllowed[] = {
+        "relativeToVRT", "shared", nullptr };
+    if( psFilename == nullptr ||
+        !BVRTCheckAllowedChildren(psFilename, apszFilenameAllowed) )
+    {
+        if( psFilename == nullptr )
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Missing <SourceFilename> element in %s",
+                     psSrc->pszValue);
+        return false;
+    }
+    sSource.nFilenameRef =
+        oPool.AddString(CPLGetXMLValue(psFilename, nullptr, ""));
+    if( atoi(CPLGetXMLValue(psFilename, "relativeToVRT", "0")) )
+        sSource.nFlags |= BVRT_SOURCE_FLAG_RELATIVE_TO_VRT;
+    const char* pszShared = CPLGetXMLValue(psFilename, "shared", nullptr);
+    if( pszShared != nullptr && !CPLTestBool(pszShared) )
+        sSource.nFlags |= BVRT_SOURCE_FLAG_NOT_SHARED;
+
+    sSource.nResamplingRef =
+        oPool.AddString(CPLGetXMLValue(psSrc, "resampling", nullptr));
+
+    const char* pszSourceBand = CPLGetXMLValue(psSrc, "SourceBand", "1");
+    if( STARTS_WITH_CI(pszSourceBand, "mask") )
+    {
+        sSource.nFlags |= BVRT_SOURCE_FLAG_MASK;
+        sSource.nSrcBand =
+            pszSourceBand[4] == ',' ? atoi(pszSourceBand + 5) : 1;
+    }
+    else
+    {
+        sSource.nSrcBand = atoi(pszSourceBand);
+    }
+
+    // Without SourceProperties, sources would have to be opened at read
+    // time to find their characteristics, which defeats the purpose of the
+    // format.
+    const CPLXMLNode* psProps = CPLGetXMLNode(psSrc, "SourceProperties");
+    if( psProps == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "<SourceProperties> is required in %s by the binary VRT "
+                 "format", psSrc->pszValue);
+        return false;
+    }
+    sSource.nSrcXSize = atoi(CPLGetXMLValue(psProps, "RasterXSize", "0"));
+    sSource.nSrcYSize = atoi(CPLGetXMLValue(psProps, "RasterYSize", "0"));
+    sSource.eSrcDataType =
+        GDALGetDataTypeByName(CPLGetXMLValue(psProps, "DataType", ""));
+    sSource.nSrcBlockXSize = atoi(CPLGetXMLValue(psProps, "BlockXSize", "0"));
+    sSource.nSrcBlockYSize = atoi(CPLGetXMLValue(psProps, "BlockYSize", "0"));
+
+    const CPLXMLNode* psSrcRect = CPLGetXMLNode(psSrc, "SrcRect");
+    if( psSrcRect )
+    {
+        sSource.nFlags |= BVRT_SOURCE_FLAG_SRC_RECT;
+        sSource.adfSrcRect[0] = CPLAtof(CPLGetXMLValue(psSrcRect, "xOff", "-1"));
+        sSource.adfSrcRect[1] = CPLAtof(CPLGetXMLValue(psSrcRect, "yOff", "-1"));
+        sSource.adfSrcRect[2] = CPLAtof(CPLGetXMLValue(psSrcRect, "xSize", "-1"));
+        sSource.adfSrcRect[3] = CPLAtof(CPLGetXMLValue(psSrcRect, "ySize", "-1"));
+    }
+    const CPLXMLNode* psDstRect = CPLGetXMLNode(psSrc, "DstRect");
+    if( psDstRect )
+    {
+        sSource.nFlags |= BVRT_SOURCE_FLAG_DST_RECT;
+        sSource.adfDstRect[0] = CPLAtof(CPLGetXMLValue(psDstRect, "xOff", "-1"));
+        sSource.adfDstRect[1] = CPLAtof(CPLGetXMLValue(psDstRect, "yOff", "-1"));
+        sSource.adfDstRect[2] = CPLAtof(CPLGetXMLValue(psDstRect, "xSize", "-1"));
+        sSource.adfDstRect[3] = CPLAtof(CPLGetXMLValue(psDstRect, "ySize", "-1"));
+    }
+
+    const char* pszNoData = CPLGetXMLValue(psSrc, "NODATA", nullptr);
+    if( pszNoData )
+    {
+        sSource.nFlags |= BVRT_SOURCE_FLAG_NODATA;
+        sSource.dfNoData = CPLAtofM(pszNoData);
+    }
+    if( CPLTestBool(CPLGetXMLValue(psSrc, "UseMaskBand", "false")) )
+        sSource.nFlags |= BVRT_SOURCE_FLAG_USE_MASK_BAND;
+
+    return true;
+}
+
+/************************************************************************/
+/*                           BVRTParseBand()                            */
+/************************************************************************/
+
+static bool BVRTParseBand( const CPLXMLNode* psBand,
+                           BVRTStringPool& oPool,
+                           BVRTBandDef& sBand )
+{
+    static const char* const apszAllowed[] = {
+        "dataType", "band", "blockXSize", "blockYSize", "Metadata",
+        "Description", "NoDataValue", "UnitType", "Offset", "Scale",
+        "ColorInterp", "ColorTable", "SimpleSource", "ComplexSource",
+        "AveragedSource", nullptr };
+
+    const char* pszSubClass = CPLGetXMLValue(psBand, "subClass", nullptr);
+    if( pszSubClass != nullptr && !EQUAL(pszSubClass, "VRTSourcedRasterBand") )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Bands of type %s are not supported by the binary VRT format",
+                 pszSubClass);
+        return false;
+    }
+    // subClass is the only attribute not listed above.
+    for( const CPLXMLNode* psIter = psBand->psChild; psIter;
+         psIter = psIter->psNext )
+    {
+        if( psIter->eType == CXT_Attribute &&
+            EQUAL(psIter->pszValue, "subClass") )
+            continue;
+        if( (psIter->eType == CXT_Element ||
+             psIter->eType == CXT_Attribute) &&
+            CSLFindString(apszAllowed, psIter->pszValue) < 0 )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "%s %s of VRTRasterBand is not supported by the binary "
+                     "VRT format",
+                     psIter->eType == CXT_Attribute ? "Attribute" : "Element",
+                     psIter->pszValue);
+            return false;
+        }
+    }
+
+    sBand.eDataType =
+        GDALGetDataTypeByName(CPLGetXMLValue(psBand, "dataType", "Byte"));
+    if( sBand.eDataType == GDT_Unknown )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Invalid dataType");
+        return false;
+    }
+    sBand.nBlockXSize = atoi(CPLGetXMLValue(psBand, "blockXSize", "0"));
+    sBand.nBlockYSize = atoi(CPLGetXMLValue(psBand, "blockYSize", "0"));
+
+    const char* pszNoData = CPLGetXMLValue(psBand, "NoDataValue", nullptr);
+    if( pszNoData )
+    {
+        sBand.nFlags |= BVRT_BAND_FLAG_NODATA;
+        sBand.dfNoData = CPLAtofM(pszNoData);
+    }
+    sBand.dfOffset = CPLAtof(CPLGetXMLValue(psBand, "Offset", "0.0"));
+    sBand.dfScale = CPLAtof(CPLGetXMLValue(psBand, "Scale", "1.0"));
+
+    const char* pszColorInterp =
+        CPLGetXMLValue(psBand, "ColorInterp", nullptr);
+    if( pszColorInterp )
+        sBand.eColorInterp = GDALGetColorInterpretationByName(pszColorInterp);
+
+    sBand.nDescriptionRef =
+        oPool.AddString(CPLGetXMLValue(psBand, "Description", nullptr));
+    sBand.nUnitTypeRef =
+        oPool.AddString(CPLGetXMLValue(psBand, "UnitType", nullptr));
+    if( !BVRTParseMetadata(psBand, oPool, sBand.nMetadataRef) )
+        return false;
+
+    const CPLXMLNode* psCT = CPLGetXMLNode(psBand, "ColorTable");
+    if( psCT )
+    {
+        for( const CPLXMLNode* psEntry = psCT->psChild; psEntry;
+             psEntry = psEntry->psNext )
+        {
+            if( psEntry->eType != CXT_Element ||
+                !EQUAL(psEntry->pszValue, "Entry") )
+                continue;
+            GDALColorEntry sEntry;
+            sEntry.c1 = static_cast<short>(
+                atoi(CPLGetXMLValue(psEntry, "c1", "0")));
+            sEntry.c2 = static_cast<short>(
+                atoi(CPLGetXMLValue(psEntry, "c2", "0")));
+            sEntry.c3 = static_cast<short>(
+                atoi(CPLGetXMLValue(psEntry, "c3", "0")));
+            sEntry.c4 = static_cast<short>(
+                atoi(CPLGetXMLValue(psEntry, "c4", "255")));
+            sBand.asColorEntries.push_back(sEntry);
+        }
+    }
+
+    for( const CPLXMLNode* psSrc = psBand->psChild; psSrc;
+         psSrc = psSrc->psNext )
+    {
+        if( psSrc->eType != CXT_Element ||
+            !(EQUAL(psSrc->pszValue, "SimpleSource") ||
+              EQUAL(psSrc->pszValue, "ComplexSource") ||
+              EQUAL(psSrc->pszValue, "AveragedSource")) )
+            continue;
+        BVRTSourceDef sSource;
+        if( !BVRTParseSource(psSrc, oPool, sSource) )
+            return false;
+        sBand.asSources.push_back(sSource);
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                        VRTSerializeToBinary()                        */
+/*                                                                      */
+/*      Convert the XML serialization of a VRTDataset into its binary   */
+/*      representation.                                                 */
+/************************************************************************/
+
+bool VRTSerializeToBinary( const CPLXMLNode* psDSTree,
+                           std::vector<GByte>& abyData )
+{
+    abyData.clear();
+    if( psDSTree == nullptr || psDSTree->eType != CXT_Element ||
+        !EQUAL(psDSTree->pszValue, "VRTDataset") )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Only raster VRTDataset can be written in the binary VRT "
+                 "format");
+        return false;
+    }
+
+    static const char* const apszAllowed[] = {
+        "rasterXSize", "rasterYSize", "SRS", "GeoTransform", "Metadata",
+        "VRTRasterBand", nullptr };
+    if( !BVRTCheckAllowedChildren(psDSTree, apszAllowed) )
+        return false;
+
+    BVRTStringPool oPool;
+
+    const int nXSize = atoi(CPLGetXMLValue(psDSTree, "rasterXSize", "0"));
+    const int nYSize = atoi(CPLGetXMLValue(psDSTree, "rasterYSize", "0"));
+
+    GUInt32 nDSFlags = 0;
+    double adfGeoTransform[6] = { 0, 1, 0, 0, 0, 1 };
+    const char* pszGT = CPLGetXMLValue(psDSTree, "GeoTransform", nullptr);
+    if( pszGT )
+    {
+        const CPLStringList aosTokens(CSLTokenizeStringComplex(pszGT, ",",
+                                                               FALSE, FALSE));
+        if( aosTokens.size() != 6 )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined, "Invalid GeoTransform");
+            return false;
+        }
+        for( int i = 0; i < 6; i++ )
+            adfGeoTransform[i] = CPLAtof(aosTokens[i]);
+        nDSFlags |= BVRT_DS_FLAG_GEOTRANSFORM;
+    }
+
+    GUInt64 nSRSRef = 0;
+    GUInt64 nMappingRef = 0;
+    double dfCoordinateEpoch = 0;
+    const CPLXMLNode* psSRS = CPLGetXMLNode(psDSTree, "SRS");
+    if( psSRS )
+    {
+        nSRSRef = oPool.AddString(CPLGetXMLValue(psSRS, nullptr, ""));
+        nMappingRef = oPool.AddString(
+            CPLGetXMLValue(psSRS, "dataAxisToSRSAxisMapping", nullptr));
+        dfCoordinateEpoch =
+            CPLAtof(CPLGetXMLValue(psSRS, "coordinateEpoch", "0"));
+    }
+
+    GUInt64 nMetadataRef = 0;
+    if( !BVRTParseMetadata(psDSTree, oPool, nMetadataRef) )
+        return false;
+
+    std::vector<BVRTBandDef> asBands;
+    for( const CPLXMLNode* psBand = psDSTree->psChild; psBand;
+         psBand = psBand->psNext )
+    {
+        if( psBand->eType != CXT_Element ||
+            !EQUAL(psBand->pszValue, "VRTRasterBand") )
+            continue;
+        asBands.emplace_back();
+        if( !BVRTParseBand(psBand, oPool, asBands.back()) )
+            return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Header.                                                         */
+/* -------------------------------------------------------------------- */
+    BVRTWriter oWriter(abyData);
+    oWriter.AddBytes(BVRT_MAGIC, BVRT_MAGIC_SIZE);
+    oWriter.AddUInt32(BVRT_VERSION);
+    oWriter.AddUInt32(static_cast<GUInt32>(BVRT_HEADER_SIZE));
+    oWriter.AddInt32(nXSize);
+    oWriter.AddInt32(nYSize);
+    oWriter.AddUInt32(static_cast<GUInt32>(asBands.size()));
+    oWriter.AddUInt32(nDSFlags);
+    for( int i = 0; i < 6; i++ )
+        oWriter.AddDouble(adfGeoTransform[i]);
+    oWriter.AddUInt64(nSRSRef);
+    oWriter.AddUInt64(nMappingRef);
+    oWriter.AddDouble(dfCoordinateEpoch);
+    oWriter.AddUInt64(nMetadataRef);
+    oWriter.AddUInt64(BVRT_HEADER_SIZE);
+    const size_t nStringPoolOffsetPos = oWriter.GetOffset();
+    oWriter.AddUInt64(0);
+    oWriter.AddUInt64(oPool.GetPool().size());
+    CPLAssert(oWriter.GetOffset() == BVRT_HEADER_SIZE);
+
+/* -------------------------------------------------------------------- */
+/*      Band table, followed by the color tables and source tables.     */
+/* -------------------------------------------------------------------- */
+    GUInt64 nNextOffset = BVRT_HEADER_SIZE + asBands.size() * BVRT_BAND_SIZE;
+    for( const auto& sBand: asBands )
+    {
+        oWriter.AddInt32(sBand.eDataType);
+        oWriter.AddInt32(sBand.eColorInterp);
+        oWriter.AddInt32(sBand.nBlockXSize);
+        oWriter.AddInt32(sBand.nBlockYSize);
+        oWriter.AddUInt32(sBand.nFlags);
+        oWriter.AddUInt32(0);
+        oWriter.AddDouble(sBand.dfNoData);
+        oWriter.AddDouble(sBand.dfOffset);
+        oWriter.AddDouble(sBand.dfScale);
+        oWriter.AddUInt64(sBand.nDescriptionRef);
+        oWriter.AddUInt64(sBand.nUnitTypeRef);
+        oWriter.AddUInt64(sBand.nMetadataRef);
+        oWriter.AddUInt64(sBand.asColorEntries.empty() ? 0 : nNextOffset);
+        oWriter.AddUInt32(static_cast<GUInt32>(sBand.asColorEntries.size()));
+        oWriter.AddUInt32(0);
+        nNextOffset += sBand.asColorEntries.size() * BVRT_COLOR_ENTRY_SIZE;
+        oWriter.AddUInt64(sBand.asSources.size());
+        oWriter.AddUInt64(nNextOffset);
+        nNextOffset += sBand.asSources.size() * BVRT_SOURCE_SIZE;
+    }
+
+    for( const auto& sBand: asBands )
+    {
+        for( const auto& sEntry: sBand.asColorEntries )
+        {
+            oWriter.AddInt16(sEntry.c1);
+            oWriter.AddInt16(sEntry.c2);
+            oWriter.AddInt16(sEntry.c3);
+            oWriter.AddInt16(sEntry.c4);
+        }
+        for( const auto& sSource: sBand.asSources )
+        {
+            oWriter.AddUInt32(sSource.nType);
+            oWriter.AddUInt32(sSource.nFlags);
+            oWriter.AddInt32(sSource.nSrcBand);
+            oWriter.AddInt32(sSource.eSrcDataType);
+            oWriter.AddInt32(sSource.nSrcXSize);
+            oWriter.AddInt32(sSource.nSrcYSize);
+            oWriter.AddInt32(sSource.nSrcBlockXSize);
+            oWriter.AddInt32(sSource.nSrcBlockYSize);
+            oWriter.AddUInt64(sSource.nFilenameRef);
+            oWriter.AddUInt64(sSource.nResamplingRef);
+            for( int i = 0; i < 4; i++ )
+                oWriter.AddDouble(sSource.adfSrcRect[i]);
+            for( int i = 0; i < 4; i++ )
+                oWriter.AddDouble(sSource.adfDstRect[i]);
+            oWriter.AddDouble(sSource.dfNoData);
+        }
+    }
+    CPLAssert(oWriter.GetOffset() == nNextOffset);
+
+/* -------------------------------------------------------------------- */
+/*      String pool.                                                    */
+/* -------------------------------------------------------------------- */
+    oWriter.PatchUInt64(nStringPoolOffsetPos, nNextOffset);
+    oWriter.AddBytes(oPool.GetPool().data(), oPool.GetPool().size());
+
+    return true;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                           VRTBinaryDataset                           */
+/* ==================================================================== */
+/************************************************************************/
+
+class VRTBinaryRasterBand;
+
+class VRTBinaryDataset final: public GDALPamDataset
+{
+    friend class VRTBinaryRasterBand;
+
+    VSILFILE           *m_fp = nullptr;
+    CPLVirtualMem      *m_psVirtualMem = nullptr;
+    GByte              *m_pabyOwnedData = nullptr;
+    const GByte        *m_pabyData = nullptr;
+    size_t              m_nDataSize = 0;
+
+    const char         *m_pszStringPool = nullptr;
+    size_t              m_nStringPoolSize = 0;
+
+    CPLString           m_osVRTPath{};
+    OGRSpatialReference m_oSRS{};
+    bool                m_bGeoTransformValid = false;
+    double              m_adfGeoTransform[6];
+
+    const char         *GetString( GUInt64 nRef ) const;
+    CPLStringList       GetStringList( GUInt64 nRef ) const;
+
+    CPL_DISALLOW_COPY_ASSIGN(VRTBinaryDataset)
+
+  public:
+                        VRTBinaryDataset();
+                       ~VRTBinaryDataset() override;
+
+    CPLErr              GetGeoTransform( double * ) override;
+    const OGRSpatialReference* GetSpatialRef() const override;
+
+    static GDALDataset *Open( GDALOpenInfo* );
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                         VRTBinaryRasterBand                          */
+/* ==================================================================== */
+/************************************************************************/
+
+class VRTBinaryRasterBand final: public GDALPamRasterBand
+{
+    friend class VRTBinaryDataset;
+
+    const GByte        *m_pabySources = nullptr;
+    size_t              m_nSources = 0;
+
+    bool                m_bNoDataValueSet = false;
+    double              m_dfNoDataValue = 0;
+    double              m_dfOffset = 0;
+    double              m_dfScale = 1;
+    CPLString           m_osUnitType{};
+    GDALColorInterp     m_eColorInterp = GCI_Undefined;
+    std::unique_ptr<GDALColorTable> m_poColorTable{};
+
+    int                 m_nRecursionCounter = 0;
+
+    // Index of source destination windows, built on the first read.
+    std::unique_ptr<CPLPackedRTree> m_poSourcesIndex{};
+    std::vector<size_t> m_anSourcesIndexed{};
+    std::vector<size_t> m_anSourcesNotIndexed{};
+
+    // Sources are only instantiated when they are read, and the number of
+    // them kept alive is bounded.
+    lru11::Cache<size_t, std::shared_ptr<VRTSource>> m_oSourceCache{1024};
+
+    void                GetSourcesIntersectingWindow(
+                                    int nXOff, int nYOff,
+                                    int nXSize, int nYSize,
+                                    std::vector<size_t>& anSources );
+    std::shared_ptr<VRTSource> GetSource( size_t iSource );
+
+    CPL_DISALLOW_COPY_ASSIGN(VRTBinaryRasterBand)
+
+  protected:
+    CPLErr              IReadBlock( int, int, void * ) override;
+    CPLErr              IRasterIO( GDALRWFlag, int, int, int, int,
+                                   void *, int, int, GDALDataType,
+                                   GSpacing nPixelSpace, GSpacing nLineSpace,
+                                   GDALRasterIOExtraArg* psExtraArg ) override;
+
+  public:
+                        VRTBinaryRasterBand( VRTBinaryDataset* poDS,
+                                             int nBand,
+                                             const GByte* pabyRecord );
+
+    double              GetNoDataValue( int *pbSuccess = nullptr ) override;
+    double              GetOffset( int *pbSuccess = nullptr ) override;
+    double              GetScale( int *pbSuccess = nullptr ) override;
+    const char         *GetUnitType() override;
+    GDALColorInterp     GetColorInterpretation() override;
+    GDALColorTable     *GetColorTable() override;
+};
+
+/************************************************************************/
+/*                          VRTBinaryDataset()                          */
+/************************************************************************/
+
+VRTBinaryDataset::VRTBinaryDataset()
+{
+    m_adfGeoTransform[0] = 0.0;
+    m_adfGeoTransform[1] = 1.0;
+    m_adfGeoTransform[2] = 0.0;
+    m_adfGeoTransform[3] = 0.0;
+    m_adfGeoTransform[4] = 0.0;
+    m_adfGeoTransform[5] = 1.0;
+    m_oSRS.SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
+}
+
+/************************************************************************/
+/*                         ~VRTBinaryDataset()                          */
+/************************************************************************/
+
+VRTBinaryDataset::~VRTBinaryDataset()
+{
+    FlushCache();
+
+    // Release the sources, and thus the proxy pool references taken with
+    // this dataset as unique handle, before the mapping goes away.
+    for( int i = 0; i < nBands; i++ )
+    {
+        cpl::down_cast<VRTBinaryRasterBand*>(papoBands[i])->
+            m_oSourceCache.clear();
+    }
+
+    if( m_psVirtualMem )
+        CPLVirtualMemFree(m_psVirtualMem);
+    if( m_fp )
+        CPL_IGNORE_RET_VAL(VSIFCloseL(m_fp));
+    VSIFree(m_pabyOwnedData);
+}
+
+/************************************************************************/
+/*                             GetString()                              */
+/************************************************************************/
+
+const char* VRTBinaryDataset::GetString( GUInt64 nRef ) const
+{
+    if( nRef == 0 || nRef > m_nStringPoolSize )
+        return nullptr;
+    return m_pszStringPool + static_cast<size_t>(nRef - 1);
+}
+
+/************************************************************************/
+/*                           GetStringList()                            */
+/************************************************************************/
+
+CPLStringList VRTBinaryDataset::GetStringList( GUInt64 nRef ) const
+{
+    CPLStringList aosList;
+    const char* pszIter = GetString(nRef);
+    if( pszIter == nullptr )
+        return aosList;
+    // The pool is nul-terminated, so this cannot go past its end.
+    const char* const pszEnd = m_pszStringPool + m_nStringPoolSize;
+    while( pszIter < pszEnd && *pszIter != '\0' )
+    {
+        aosList.AddString(pszIter);
+        pszIter += strlen(pszIter) + 1;
+    }
+    return aosList;
+}
+
+/************************************************************************/
+/*                          GetGeoTransform()                           */
+/************************************************************************/
+
+CPLErr VRTBinaryDataset::GetGeoTransform( double* padfGeoTransform )
+{
+    memcpy(padfGeoTransform, m_adfGeoTransform, sizeof(m_adfGeoTransform));
+    return m_bGeoTransformValid ? CE_None : CE_Failure;
+}
+
+/************************************************************************/
+/*                           GetSpatialRef()                            */
+/************************************************************************/
+
+const OGRSpatialReference* VRTBinaryDataset::GetSpatialRef() const
+{
+    return m_oSRS.IsEmpty() ? nullptr : &m_oSRS;
+}
+
+/************************************************************************/
+/*                         VRTBinaryIdentify()                          */
+/************************************************************************/
+
+bool VRTBinaryIdentify( GDALOpenInfo* poOpenInfo )
+{
+    return poOpenInfo->fpL != nullptr &&
+           poOpenInfo->nHeaderBytes >= static_cast<int>(BVRT_HEADER_SIZE) &&
+           memcmp(poOpenInfo->pabyHeader, BVRT_MAGIC, BVRT_MAGIC_SIZE) == 0;
+}
+
+/************************************************************************/
+/*                                Open()                                */
+/************************************************************************/
+
+GDALDataset* VRTBinaryDataset::Open( GDALOpenInfo* poOpenInfo )
+{
+    if( !VRTBinaryIdentify(poOpenInfo) )
+        return nullptr;
+
+    if( poOpenInfo->eAccess == GA_Update )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Binary VRT files can only be opened in read-only mode");
+        return nullptr;
+    }
+
+    std::unique_ptr<VRTBinaryDataset> poDS(new VRTBinaryDataset());
+
+/* -------------------------------------------------------------------- */
+/*      Map the file, or as a last resort ingest it. The buffer of      */
+/*      /vsimem/ files is not used in place, as it could be freed or    */
+/*      reallocated by an unlink or a write while the dataset is open.  */
+/* -------------------------------------------------------------------- */
+    if( poOpenInfo->fpL == nullptr )
+        return nullptr;
+    CPL_IGNORE_RET_VAL(VSIFSeekL(poOpenInfo->fpL, 0, SEEK_END));
+    const vsi_l_offset nLength = VSIFTellL(poOpenInfo->fpL);
+    CPL_IGNORE_RET_VAL(VSIFSeekL(poOpenInfo->fpL, 0, SEEK_SET));
+    if( nLength > std::numeric_limits<size_t>::max() )
+        return nullptr;
+    poDS->m_nDataSize = static_cast<size_t>(nLength);
+
+    if( CPLIsVirtualMemFileMapAvailable() &&
+        VSIFGetNativeFileDescriptorL(poOpenInfo->fpL) != nullptr )
+    {
+        poDS->m_psVirtualMem = CPLVirtualMemFileMapNew(
+            poOpenInfo->fpL, 0, nLength, VIRTUALMEM_READONLY,
+            nullptr, nullptr);
+    }
+    if( poDS->m_psVirtualMem )
+    {
+        poDS->m_pabyData = static_cast<const GByte*>(
+            CPLVirtualMemGetAddr(poDS->m_psVirtualMem));
+        poDS->m_fp = poOpenInfo->fpL;
+        poOpenInfo->fpL = nullptr;
+    }
+    else
+    {
+        if( !VSIIngestFile(poOpenInfo->fpL, poOpenInfo->pszFilename,
+                           &poDS->m_pabyOwnedData, nullptr, -1) )
+            return nullptr;
+        poDS->m_pabyData = poDS->m_pabyOwnedData;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Validate the header.                                            */
+/* -------------------------------------------------------------------- */
+    const GByte* pabyData = poDS->m_pabyData;
+    const size_t nDataSize = poDS->m_nDataSize;
+    if( nDataSize < BVRT_HEADER_SIZE ||
+        memcmp(pabyData, BVRT_MAGIC, BVRT_MAGIC_SIZE) != 0 )
+        return nullptr;
+    const GUInt32 nVersion = BVRTReadUInt32(pabyData + 8);
+    const GUInt32 nHeaderSize = BVRTReadUInt32(pabyData + 12);
+    if( nVersion != BVRT_VERSION || nHeaderSize < BVRT_HEADER_SIZE )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Unsupported binary VRT version: %u", nVersion);
+        return nullptr;
+    }
+
+    poDS->nRasterXSize = BVRTReadInt32(pabyData + 16);
+    poDS->nRasterYSize = BVRTReadInt32(pabyData + 20);
+    const GUInt32 nBandCount = BVRTReadUInt32(pabyData + 24);
+    if( !GDALCheckDatasetDimensions(poDS->nRasterXSize, poDS->nRasterYSize) ||
+        nBandCount > static_cast<GUInt32>(std::numeric_limits<int>::max()) ||
+        !GDALCheckBandCount(static_cast<int>(nBandCount), TRUE) )
+        return nullptr;
+
+    const GUInt64 nBandTableOffset = BVRTReadUInt64(pabyData + 112);
+    const GUInt64 nStringPoolOffset = BVRTReadUInt64(pabyData + 120);
+    const GUInt64 nStringPoolSize = BVRTReadUInt64(pabyData + 128);
+    if( nBandTableOffset > nDataSize ||
+        nBandCount > (nDataSize - nBandTableOffset) / BVRT_BAND_SIZE ||
+        nStringPoolOffset > nDataSize ||
+        nStringPoolSize > nDataSize - nStringPoolOffset ||
+        (nStringPoolSize > 0 &&
+         pabyData[static_cast<size_t>(nStringPoolOffset + nStringPoolSize - 1)]
+            != '\0') )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Corrupted binary VRT file");
+        return nullptr;
+    }
+    poDS->m_pszStringPool = reinterpret_cast<const char*>(
+        pabyData + static_cast<size_t>(nStringPoolOffset));
+    poDS->m_nStringPoolSize = static_cast<size_t>(nStringPoolSize);
+
+    const GUInt32 nDSFlags = BVRTReadUInt32(pabyData + 28);
+    if( nDSFlags & BVRT_DS_FLAG_GEOTRANSFORM )
+    {
+        poDS->m_bGeoTransformValid = true;
+        for( int i = 0; i < 6; i++ )
+            poDS->m_adfGeoTransform[i] = BVRTReadDouble(pabyData + 32 + 8 * i);
+    }
+
+    const char* pszSRS = poDS->GetString(BVRTReadUInt64(pabyData + 80));
+    if( pszSRS && pszSRS[0] != '\0' )
+    {
+        poDS->m_oSRS.SetFromUserInput(pszSRS);
+        const char* pszMapping =
+            poDS->GetString(BVRTReadUInt64(pabyData + 88));
+        if( pszMapping )
+        {
+            const CPLStringList aosTokens(
+                CSLTokenizeStringComplex(pszMapping, ",", FALSE, FALSE));
+            std::vector<int> anMapping;
+            for( int i = 0; i < aosTokens.size(); i++ )
+                anMapping.push_back(atoi(aosTokens[i]));
+            poDS->m_oSRS.SetDataAxisToSRSAxisMapping(anMapping);
+        }
+        const double dfCoordinateEpoch = BVRTReadDouble(pabyData + 96);
+        if( dfCoordinateEpoch > 0 )
+            poDS->m_oSRS.SetCoordinateEpoch(dfCoordinateEpoch);
+    }
+
+    poDS->GDALDataset::SetMetadata(
+        poDS->GetStringList(BVRTReadUInt64(pabyData + 104)).List());
+
+/* -------------------------------------------------------------------- */
+/*      Bands. Only the location of the source tables is checked, so    */
+/*      that opening does not depend on the number of sources.         */
+/* -------------------------------------------------------------------- */
+    for( int iBand = 0; iBand < static_cast<int>(nBandCount); iBand++ )
+    {
+        const GByte* pabyBand = pabyData +
+            static_cast<size_t>(nBandTableOffset) + iBand * BVRT_BAND_SIZE;
+        const int nDataType = BVRTReadInt32(pabyBand);
+        const GUInt64 nCTOffset = BVRTReadUInt64(pabyBand + 72);
+        const GUInt32 nCTCount = BVRTReadUInt32(pabyBand + 80);
+        const GUInt64 nSourceCount = BVRTReadUInt64(pabyBand + 88);
+        const GUInt64 nSourceOffset = BVRTReadUInt64(pabyBand + 96);
+        if( nDataType <= GDT_Unknown || nDataType >= GDT_TypeCount ||
+            nSourceOffset > nDataSize ||
+            nSourceCount > (nDataSize - nSourceOffset) / BVRT_SOURCE_SIZE ||
+            (nCTCount > 0 &&
+             (nCTOffset > nDataSize ||
+              nCTCount > (nDataSize - nCTOffset) / BVRT_COLOR_ENTRY_SIZE)) )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Corrupted binary VRT file");
+            return nullptr;
+        }
+        poDS->SetBand(iBand + 1,
+                      new VRTBinaryRasterBand(poDS.get(), iBand + 1,
+                                              pabyBand));
+    }
+
+    poDS->m_osVRTPath = CPLGetPath(poOpenInfo->pszFilename);
+
+    poDS->SetDescription(poOpenInfo->pszFilename);
+    poDS->TryLoadXML();
+
+    return poDS.release();
+}
+
+/************************************************************************/
+/*                        VRTBinaryRasterBand()                         */
+/************************************************************************/
+
+VRTBinaryRasterBand::VRTBinaryRasterBand( VRTBinaryDataset* poDSIn,
+                                          int nBandIn,
+                                          const GByte* pabyRecord )
+{
+    poDS = poDSIn;
+    nBand = nBandIn;
+    nRasterXSize = poDSIn->GetRasterXSize();
+    nRasterYSize = poDSIn->GetRasterYSize();
+
+    eDataType = static_cast<GDALDataType>(BVRTReadInt32(pabyRecord));
+    const int nColorInterp = BVRTReadInt32(pabyRecord + 4);
+    if( nColorInterp > GCI_Undefined && nColorInterp <= GCI_Max )
+        m_eColorInterp = static_cast<GDALColorInterp>(nColorInterp);
+
+    // Same defaults as VRTRasterBand.
+    nBlockXSize = BVRTReadInt32(pabyRecord + 8);
+    nBlockYSize = BVRTReadInt32(pabyRecord + 12);
+    if( nBlockXSize <= 0 )
+        nBlockXSize = std::min(128, nRasterXSize);
+    if( nBlockYSize <= 0 )
+        nBlockYSize = std::min(128, nRasterYSize);
+
+    const GUInt32 nBandFlags = BVRTReadUInt32(pabyRecord + 16);
+    m_bNoDataValueSet = (nBandFlags & BVRT_BAND_FLAG_NODATA) != 0;
+    m_dfNoDataValue = BVRTReadDouble(pabyRecord + 24);
+    m_dfOffset = BVRTReadDouble(pabyRecord + 32);
+    m_dfScale = BVRTReadDouble(pabyRecord + 40);
+
+    const char* pszDescription =
+        poDSIn->GetString(BVRTReadUInt64(pabyRecord + 48));
+    if( pszDescription )
+        GDALRasterBand::SetDescription(pszDescription);
+    const char* pszUnitType =
+        poDSIn->GetString(BVRTReadUInt64(pabyRecord + 56));
+    if( pszUnitType )
+        m_osUnitType = pszUnitType;
+    GDALRasterBand::SetMetadata(
+        poDSIn->GetStringList(BVRTReadUInt64(pabyRecord + 64)).List());
+
+    const GUInt32 nCTCount = BVRTReadUInt32(pabyRecord + 80);
+    if( nCTCount > 0 )
+    {
+        const GByte* pabyCT = poDSIn->m_pabyData +
+            static_cast<size_t>(BVRTReadUInt64(pabyRecord + 72));
+        m_poColorTable.reset(new GDALColorTable());
+        for( GUInt32 i = 0; i < nCTCount; i++ )
+        {
+            GInt16 anVals[4];
+            memcpy(anVals, pabyCT + i * BVRT_COLOR_ENTRY_SIZE, sizeof(anVals));
+            for( int j = 0; j < 4; j++ )
+                CPL_LSBPTR16(&anVals[j]);
+            GDALColorEntry sEntry;
+            sEntry.c1 = anVals[0];
+            sEntry.c2 = anVals[1];
+            sEntry.c3 = anVals[2];
+            sEntry.c4 = anVals[3];
+            m_poColorTable->SetColorEntry(static_cast<int>(i), &sEntry);
+        }
+    }
+
+    m_nSources = static_cast<size_t>(BVRTReadUInt64(pabyRecord + 88));
+    m_pabySources = poDSIn->m_pabyData +
+        static_cast<size_t>(BVRTReadUInt64(pabyRecord + 96));
+}
+
+/************************************************************************/
+/*                     Simple band property getters                     */
+/************************************************************************/
+
+double VRTBinaryRasterBand::GetNoDataValue( int *pbSuccess )
+{
+    if( pbSuccess )
+        *pbSuccess = m_bNoDataValueSet;
+    return m_dfNoDataValue;
+}
+
+double VRTBinaryRasterBand::GetOffset( int *pbSuccess )
+{
+    if( pbSuccess )
+        *pbSuccess = TRUE;
+    return m_dfOffset;
+}
+
+double VRTBinaryRasterBand::GetScale( int *pbSuccess )
+{
+    if( pbSuccess )
+        *pbSuccess = TRUE;
+    return m_dfScale;
+}
+
+const char* VRTBinaryRasterBand::GetUnitType()
+{
+    return m_osUnitType.c_str();
+}
+
+GDALColorInterp VRTBinaryRasterBand::GetColorInterpretation()
+{
+    return m_eColorInterp;
+}
+
+GDALColorTable* VRTBinaryRasterBand::GetColorTable()
+{
+    return m_poColorTable.get();
+}
+
+/************************************************************************/
+/*                    GetSourcesIntersectingWindow()                    */
+/************************************************************************/
+
+void VRTBinaryRasterBand::GetSourcesIntersectingWindow(
+                                        int nXOff, int nYOff,
+                                        int nXSize, int nYSize,
+                                        std::vector<size_t>& anSources )
+{
+    anSources.clear();
+
+    // Below that number of sources, a linear scan is cheap enough.
+    constexpr size_t MIN_SOURCES_FOR_INDEX = 64;
+    if( m_nSources < MIN_SOURCES_FOR_INDEX )
+    {
+        for( size_t iSource = 0; iSource < m_nSources; iSource++ )
+            anSources.push_back(iSource);
+        return;
+    }
+
+    if( m_poSourcesIndex == nullptr )
+    {
+        // The index is built directly from the source records, without
+        // instantiating the sources.
+        std::vector<CPLRectObj> asBounds;
+        for( size_t iSource = 0; iSource < m_nSources; iSource++ )
+        {
+            const GByte* pabyRecord =
+                m_pabySources + iSource * BVRT_SOURCE_SIZE;
+            const GUInt32 nSourceFlags = BVRTReadUInt32(pabyRecord + 4);
+            const double dfDstXOff = BVRTReadDouble(pabyRecord + 80);
+            const double dfDstYOff = BVRTReadDouble(pabyRecord + 88);
+            const double dfDstXSize = BVRTReadDouble(pabyRecord + 96);
+            const double dfDstYSize = BVRTReadDouble(pabyRecord + 104);
+            if( !(nSourceFlags & BVRT_SOURCE_FLAG_DST_RECT) ||
+                dfDstXOff == -1 || dfDstYOff == -1 ||
+                dfDstXSize == -1 || dfDstYSize == -1 )
+            {
+                m_anSourcesNotIndexed.push_back(iSource);
+                continue;
+            }
+            CPLRectObj sBounds;
+            sBounds.minx = dfDstXOff;
+            sBounds.miny = dfDstYOff;
+            sBounds.maxx = dfDstXOff + dfDstXSize;
+            sBounds.maxy = dfDstYOff + dfDstYSize;
+            asBounds.push_back(sBounds);
+            m_anSourcesIndexed.push_back(iSource);
+        }
+        m_poSourcesIndex.reset(
+            new CPLPackedRTree(asBounds.data(), asBounds.size()));
+    }
+
+    // Enlarge the window by one pixel to be tolerant to the rounding
+    // done by the sources when computing their source window.
+    CPLRectObj sAoi;
+    sAoi.minx = nXOff - 1.0;
+    sAoi.miny = nYOff - 1.0;
+    sAoi.maxx = nXOff + static_cast<double>(nXSize) + 1;
+    sAoi.maxy = nYOff + static_cast<double>(nYSize) + 1;
+    std::vector<size_t> anItems;
+    m_poSourcesIndex->Search(sAoi, anItems);
+    anSources.reserve(anItems.size() + m_anSourcesNotIndexed.size());
+    for( const size_t nItem: anItems )
+        anSources.push_back(m_anSourcesIndexed[nItem]);
+    anSources.insert(anSources.end(), m_anSourcesNotIndexed.begin(),
+                     m_anSourcesNotIndexed.end());
+
+    // Sources must be composited in their order of declaration.
+    std::sort(anSources.begin(), anSources.end());
+}
+
+/************************************************************************/
+/*                             GetSource()                              */
+/*                                                                      */
+/*      Instantiate a source from its record, through the regular       */
+/*      XML source parsers so that it behaves exactly as in a XML VRT.  */
+/************************************************************************/
+
+std::shared_ptr<VRTSource> VRTBinaryRasterBand::GetSource( size_t iSource )
+{
+    std::shared_ptr<VRTSource> poSource;
+    if( m_oSourceCache.tryGet(iSource, poSource) )
+        return poSource;
+
+    auto l_poDS = cpl::down_cast<VRTBinaryDataset*>(poDS);
+    const GByte* pabyRecord = m_pabySources + iSource * BVRT_SOURCE_SIZE;
+    const GUInt32 nType = BVRTReadUInt32(pabyRecord);
+    const GUInt32 nSourceFlags = BVRTReadUInt32(pabyRecord + 4);
+    const int nSrcBand = BVRTReadInt32(pabyRecord + 8);
+    const int nSrcDataType = BVRTReadInt32(pabyRecord + 12);
+    const char* pszFilename =
+        l_poDS->GetString(BVRTReadUInt64(pabyRecord + 32));
+    const char* pszResampling =
+        l_poDS->GetString(BVRTReadUInt64(pabyRecord + 40));
+    if( nType > BVRT_SOURCE_AVERAGED || pszFilename == nullptr ||
+        nSrcDataType <= GDT_Unknown || nSrcDataType >= GDT_TypeCount )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Corrupted source record %d in band %d",
+                 static_cast<int>(iSource), nBand);
+        return nullptr;
+    }
+
+    CPLXMLTreeCloser oTree(CPLCreateXMLNode(
+        nullptr, CXT_Element,
+        nType == BVRT_SOURCE_COMPLEX ? "ComplexSource" :
+        nType == BVRT_SOURCE_AVERAGED ? "AveragedSource" : "SimpleSource"));
+    CPLXMLNode* psSrc = oTree.get();
+    if( pszResampling )
+        CPLAddXMLAttributeAndValue(psSrc, "resampling", pszResampling);
+
+    CPLXMLNode* psFilename =
+        CPLCreateXMLElementAndValue(psSrc, "SourceFilename", pszFilename);
+    CPLAddXMLAttributeAndValue(
+        psFilename, "relativeToVRT",
+        (nSourceFlags & BVRT_SOURCE_FLAG_RELATIVE_TO_VRT) ? "1" : "0");
+    if( nSourceFlags & BVRT_SOURCE_FLAG_NOT_SHARED )
+        CPLAddXMLAttributeAndValue(psFilename, "shared", "0");
+
+    CPLCreateXMLElementAndValue(
+        psSrc, "SourceBand",
+        (nSourceFlags & BVRT_SOURCE_FLAG_MASK) ? CPLSPrintf("mask,%d", nSrcBand) :
+                                           CPLSPrintf("%d", nSrcBand));
+
+    CPLXMLNode* psProps =
+        CPLCreateXMLNode(psSrc, CXT_Element, "SourceProperties");
+    CPLAddXMLAttributeAndValue(psProps, "RasterXSize",
+                        CPLSPrintf("%d", BVRTReadInt32(pabyRecord + 16)));
+    CPLAddXMLAttributeAndValue(psProps, "RasterYSize",
+                        CPLSPrintf("%d", BVRTReadInt32(pabyRecord + 20)));
+    CPLAddXMLAttributeAndValue(psProps, "DataType",
+        GDALGetDataTypeName(static_cast<GDALDataType>(nSrcDataType)));
+    CPLAddXMLAttributeAndValue(psProps, "BlockXSize",
+                        CPLSPrintf("%d", BVRTReadInt32(pabyRecord + 24)));
+    CPLAddXMLAttributeAndValue(psProps, "BlockYSize",
+                        CPLSPrintf("%d", BVRTReadInt32(pabyRecord + 28)));
+
+    const auto AddRect = [psSrc](const char* pszName, const GByte* pabyRect)
+    {
+        CPLXMLNode* psRect = CPLCreateXMLNode(psSrc, CXT_Element, pszName);
+        CPLAddXMLAttributeAndValue(psRect, "xOff",
+            CPLSPrintf("%.15g", BVRTReadDouble(pabyRect)));
+        CPLAddXMLAttributeAndValue(psRect, "yOff",
+            CPLSPrintf("%.15g", BVRTReadDouble(pabyRect + 8)));
+        CPLAddXMLAttributeAndValue(psRect, "xSize",
+            CPLSPrintf("%.15g", BVRTReadDouble(pabyRect + 16)));
+        CPLAddXMLAttributeAndValue(psRect, "ySize",
+            CPLSPrintf("%.15g", BVRTReadDouble(pabyRect + 24)));
+    };
+    if( nSourceFlags & BVRT_SOURCE_FLAG_SRC_RECT )
+        AddRect("SrcRect", pabyRecord + 48);
+    if( nSourceFlags & BVRT_SOURCE_FLAG_DST_RECT )
+        AddRect("DstRect", pabyRecord + 80);
+
+    if( nType == BVRT_SOURCE_COMPLEX )
+    {
+        if( nSourceFlags & BVRT_SOURCE_FLAG_USE_MASK_BAND )
+            CPLCreateXMLElementAndValue(psSrc, "UseMaskBand", "true");
+        if( nSourceFlags & BVRT_SOURCE_FLAG_NODATA )
+        {
+            CPLCreateXMLElementAndValue(psSrc, "NODATA",
+                VRTSerializeNoData(BVRTReadDouble(pabyRecord + 112),
+                                   static_cast<GDALDataType>(nSrcDataType),
+                                   16).c_str());
+        }
+    }
+
+    // As SourceProperties are always present, sources go through
+    // GDALProxyPoolDataset and do not use the shared dataset map.
+    std::map<CPLString, GDALDataset*> oMapSharedSources;
+    VRTDriver * const poDriver =
+        static_cast<VRTDriver *>(GDALGetDriverByName("VRT"));
+    poSource.reset(poDriver->ParseSource(psSrc, l_poDS->m_osVRTPath,
+                                         l_poDS, oMapSharedSources));
+    if( poSource )
+        m_oSourceCache.insert(iSource, poSource);
+    return poSource;
+}
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr VRTBinaryRasterBand::IRasterIO( GDALRWFlag eRWFlag,
+                                       int nXOff, int nYOff,
+                                       int nXSize, int nYSize,
+                                       void *pData,
+                                       int nBufXSize, int nBufYSize,
+                                       GDALDataType eBufType,
+                                       GSpacing nPixelSpace,
+                                       GSpacing nLineSpace,
+                                       GDALRasterIOExtraArg *psExtraArg )
+
+{
+    if( eRWFlag == GF_Write )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Writing through a binary VRT is not supported.");
+        return CE_Failure;
+    }
+
+    if( m_nRecursionCounter > 1 )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "VRTBinaryRasterBand::IRasterIO() called recursively on "
+                 "the same band. It looks like the VRT is referencing "
+                 "itself.");
+        return CE_Failure;
+    }
+
+    // As in VRTSourcedRasterBand, resampling with a nodata value requires
+    // the generic implementation, which works on full resolution blocks.
+    if( (nXSize != nBufXSize || nYSize != nBufYSize) &&
+        psExtraArg->eResampleAlg != GRIORA_NearestNeighbour &&
+        m_bNoDataValueSet )
+    {
+        return GDALPamRasterBand::IRasterIO(eRWFlag,
+                                            nXOff, nYOff, nXSize, nYSize,
+                                            pData, nBufXSize, nBufYSize,
+                                            eBufType,
+                                            nPixelSpace, nLineSpace,
+                                            psExtraArg);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Initialize the buffer to the nodata value, or zero.             */
+/* -------------------------------------------------------------------- */
+    const double dfWriteValue = m_bNoDataValueSet ? m_dfNoDataValue : 0.0;
+    for( int iLine = 0; iLine < nBufYSize; iLine++ )
+    {
+        GDALCopyWords( &dfWriteValue, GDT_Float64, 0,
+                       static_cast<GByte *>( pData )
+                       + static_cast<GIntBig>( nLineSpace ) * iLine,
+                       eBufType, static_cast<int>(nPixelSpace), nBufXSize );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Overlay each source in turn over top this.                      */
+/* -------------------------------------------------------------------- */
+    std::vector<size_t> anSources;
+    GetSourcesIntersectingWindow(nXOff, nYOff, nXSize, nYSize, anSources);
+
+    m_nRecursionCounter++;
+
+    CPLErr eErr = CE_None;
+    for( size_t i = 0; eErr == CE_None && i < anSources.size(); i++ )
+    {
+        // Keep a reference, in case the source gets evicted from the cache
+        // while it is being read.
+        std::shared_ptr<VRTSource> poSource = GetSource(anSources[i]);
+        if( poSource == nullptr )
+        {
+            eErr = CE_Failure;
+            break;
+        }
+        eErr = poSource->RasterIO( eDataType,
+                                   nXOff, nYOff, nXSize, nYSize,
+                                   pData, nBufXSize, nBufYSize,
+                                   eBufType, nPixelSpace, nLineSpace,
+                                   psExtraArg );
+    }
+
+    m_nRecursionCounter--;
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                             IReadBlock()                             */
+/************************************************************************/
+
+CPLErr VRTBinaryRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
+                                        void * pImage )
+
+{
+    const int nPixelSize = GDALGetDataTypeSizeBytes(eDataType);
+
+    int nReadXSize = 0;
+    if( (nBlockXOff+1) * nBlockXSize > GetXSize() )
+        nReadXSize = GetXSize() - nBlockXOff * nBlockXSize;
+    else
+        nReadXSize = nBlockXSize;
+
+    int nReadYSize = 0;
+    if( (nBlockYOff+1) * nBlockYSize > GetYSize() )
+        nReadYSize = GetYSize() - nBlockYOff * nBlockYSize;
+    else
+        nReadYSize = nBlockYSize;
+
+    GDALRasterIOExtraArg sExtraArg;
+    INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+
+    return IRasterIO( GF_Read,
+                      nBlockXOff * nBlockXSize, nBlockYOff * nBlockYSize,
+                      nReadXSize, nReadYSize,
+                      pImage, nReadXSize, nReadYSize, eDataType,
+                      nPixelSize,
+                      static_cast<GSpacing>(nPixelSize) * nBlockXSize,
+                      &sExtraArg );
+}
+
+/************************************************************************/
+/*                           VRTBinaryOpen()                            */
+/************************************************************************/
+
+GDALDataset* VRTBinaryOpen( GDALOpenInfo* poOpenInfo )
+{
+    return VRTBinaryDataset::Open(poOpenInfo);
+}
+
+/*! @endcond */
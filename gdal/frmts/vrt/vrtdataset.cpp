@@ -167,42 +167,18 @@ template<class T> void VRTFlushCacheStruct<T>::FlushCache(T& obj)
         return;
 
     /* -------------------------------------------------------------------- */
-    /*      Create the output file.                                         */
-    /* -------------------------------------------------------------------- */
-    VSILFILE *fpVRT = VSIFOpenL( obj.GetDescription(), "w" );
-    if( fpVRT == nullptr )
-    {
-        CPLError( CE_Failure, CPLE_AppDefined,
-                "Failed to write .vrt file in FlushCache()." );
-        return;
-    }
-
-    /* -------------------------------------------------------------------- */
-    /*      Convert tree to a single block of XML text.                     */
+    /*      Convert tree to a single block of XML text, or to its binary    */
+    /*      representation, and write it to disk.                           */
     /* -------------------------------------------------------------------- */
     const char* pszDescription = obj.GetDescription();
     char *l_pszVRTPath = CPLStrdup(
         pszDescription[0] && !STARTS_WITH(pszDescription, "<VRTDataset") ?
             CPLGetPath(pszDescription): "" );
     CPLXMLNode *psDSTree = obj.T::SerializeToXML( l_pszVRTPath );
-    char *pszXML = CPLSerializeXMLTree( psDSTree );
+    CPLFree( l_pszVRTPath );
 
+    const bool bOK = VRTWriteDatasetTree( psDSTree, pszDescription );
     CPLDestroyXMLNode( psDSTree );
-
-    CPLFree( l_pszVRTPath );
-    bool bOK = true;
-    if( pszXML )
-    {
-        /* ------------------------------------------------------------------ */
-        /*      Write to disk.                                                */
-        /* ------------------------------------------------------------------ */
-        bOK &=
-            VSIFWriteL( pszXML, 1, strlen(pszXML), fpVRT )
-            == strlen(pszXML);
-        CPLFree(pszXML);
-    }
-    if( VSIFCloseL( fpVRT ) != 0 )
-        bOK = false;
     if( !bOK )
     {
         CPLError( CE_Failure, CPLE_AppDefined,
@@ -211,6 +187,49 @@ template<class T> void VRTFlushCacheStruct<T>::FlushCache(T& obj)
     }
 }
 
+/************************************************************************/
+/*                        VRTWriteDatasetTree()                         */
+/*                                                                      */
+/*      Write the serialized tree of a dataset, as XML or in the        */
+/*      binary representation if the filename has a .bvrt extension.   */
+/************************************************************************/
+
+bool VRTWriteDatasetTree( const CPLXMLNode* psDSTree,
+                          const char* pszFilename )
+{
+    if( psDSTree == nullptr )
+        return false;
+
+    const bool bBinary = EQUAL(CPLGetExtension(pszFilename), "bvrt");
+    std::vector<GByte> abyData;
+    if( bBinary )
+    {
+        if( !VRTSerializeToBinary( psDSTree, abyData ) )
+            return false;
+    }
+    else
+    {
+        char *pszXML = CPLSerializeXMLTree( psDSTree );
+        if( pszXML == nullptr )
+            return false;
+        abyData.assign( pszXML, pszXML + strlen(pszXML) );
+        CPLFree( pszXML );
+    }
+
+    VSILFILE *fpVRT = VSIFOpenL( pszFilename, bBinary ? "wb" : "w" );
+    if( fpVRT == nullptr )
+    {
+        CPLError( CE_Failure, CPLE_FileIO, "Cannot create %s", pszFilename );
+        return false;
+    }
+    bool bOK =
+        VSIFWriteL( abyData.data(), 1, abyData.size(), fpVRT ) ==
+        abyData.size();
+    if( VSIFCloseL( fpVRT ) != 0 )
+        bOK = false;
+    return bOK;
+}
+
 /************************************************************************/
 /*                            GetMetadata()                             */
 /************************************************************************/
@@ -799,6 +818,9 @@ int VRTDataset::Identify( GDALOpenInfo * poOpenInfo )
     if( STARTS_WITH_CI(poOpenInfo->pszFilename, VRT_PROTOCOL_PREFIX) )
         return TRUE;
 
+    if( VRTBinaryIdentify(poOpenInfo) )
+        return TRUE;
+
     return FALSE;
 }
 
@@ -819,6 +841,9 @@ GDALDataset *VRTDataset::Open( GDALOpenInfo * poOpenInfo )
     if( STARTS_WITH_CI(poOpenInfo->pszFilename, VRT_PROTOCOL_PREFIX) )
         return OpenVRTProtocol(poOpenInfo->pszFilename);
 
+    if( VRTBinaryIdentify(poOpenInfo) )
+        return VRTBinaryOpen(poOpenInfo);
+
 /* -------------------------------------------------------------------- */
 /*      Try to read the whole file into memory.                         */
 /* -------------------------------------------------------------------- */
@@ -928,8 +953,19 @@ GDALDataset *VRTDataset::Open( GDALOpenInfo * poOpenInfo )
         OpenXML( pszXML, pszVRTPath, poOpenInfo->eAccess ) );
 
     if( poDS != nullptr )
+    {
         poDS->m_bNeedsFlush =false;
 
+        const char* pszNumThreads =
+            CSLFetchNameValue(poOpenInfo->papszOpenOptions, "NUM_THREADS");
+        if( pszNumThreads != nullptr )
+        {
+            poDS->m_nNumThreads = std::min(128,
+                EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                   atoi(pszNumThreads));
+        }
+    }
+
     if( poDS != nullptr )
     {
         if( poDS->GetRasterCount() == 0 &&
@@ -1088,7 +1124,9 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
  /* -------------------------------------------------------------------- */
  /*      Parse the XML.                                                  */
  /* -------------------------------------------------------------------- */
-    CPLXMLTreeCloser psTree(CPLParseXMLString( pszXML ));
+    // Use the faster arena parser: XMLInit() implementations must not
+    // modify the tree, but work on a copy of the parts they rewrite.
+    CPLXMLArenaTreeCloser psTree(CPLParseXMLStringArena( pszXML ));
     if( psTree == nullptr )
         return nullptr;
 
@@ -1523,6 +1561,20 @@ void VRTDataset::SetMaskBand(VRTRasterBand* poMaskBandIn)
     m_poMaskBand->SetIsMaskBand();
 }
 
+/************************************************************************/
+/*                           GetNumThreads()                            */
+/************************************************************************/
+
+int VRTDataset::GetNumThreads() const
+{
+    if( m_nNumThreads >= 0 )
+        return m_nNumThreads;
+    const char* pszNumThreads = CPLGetConfigOption("VRT_NUM_THREADS", "1");
+    const int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                            CPLGetNumCPUs() : atoi(pszNumThreads);
+    return std::min(nThreads, 128);
+}
+
 /************************************************************************/
 /*                        CloseDependentDatasets()                      */
 /************************************************************************/
@@ -1954,20 +2006,41 @@ CPLErr VRTDataset::IRasterIO( GDALRWFlag eRWFlag,
         // they don't necessary instantiate all underlying rasterbands.
         VRTSourcedRasterBand* poBand = static_cast<VRTSourcedRasterBand *>(
             papoBands[nBands - 1] );
-        for( int iSource = 0;
-             eErr == CE_None && iSource < poBand->nSources;
-             iSource++ )
+        std::vector<int> anSources;
+        poBand->GetSourcesIntersectingWindow(nXOff, nYOff, nXSize, nYSize,
+                                             anSources);
+
+        if( poBand->ReadSourcesMultiThreaded(
+                nXOff, nYOff, nXSize, nYSize, nBufXSize, nBufYSize,
+                psExtraArg, anSources,
+                [=](VRTSimpleSource* poSource,
+                    GDALRasterIOExtraArg* psSourceExtraArg)
+                {
+                    return poSource->DatasetRasterIO(
+                        poBand->GetRasterDataType(),
+                        nXOff, nYOff, nXSize, nYSize,
+                        pData, nBufXSize, nBufYSize, eBufType,
+                        nBandCount, panBandMap,
+                        nPixelSpace, nLineSpace, nBandSpace,
+                        psSourceExtraArg );
+                }, eErr) )
+        {
+            m_nRecursionCounter --;
+            return eErr;
+        }
+        const int nCandidateSources = static_cast<int>(anSources.size());
+        for( int i = 0; eErr == CE_None && i < nCandidateSources; i++ )
         {
             psExtraArg->pfnProgress = GDALScaledProgress;
             psExtraArg->pProgressData =
                 GDALCreateScaledProgress(
-                    1.0 * iSource / poBand->nSources,
-                    1.0 * (iSource + 1) / poBand->nSources,
+                    1.0 * i / nCandidateSources,
+                    1.0 * (i + 1) / nCandidateSources,
                     pfnProgressGlobal,
                     pProgressDataGlobal );
 
             VRTSimpleSource* poSource = static_cast<VRTSimpleSource *>(
-                poBand->papoSources[iSource] );
+                poBand->papoSources[anSources[i]] );
 
             eErr = poSource->DatasetRasterIO( poBand->GetRasterDataType(),
                                               nXOff, nYOff, nXSize, nYSize,
@@ -35,6 +35,7 @@
 
 #include "cpl_hash_set.h"
 #include "cpl_minixml.h"
+#include "cpl_quad_tree.h"
 #include "gdal_pam.h"
 #include "gdal_priv.h"
 #include "gdal_rat.h"
@@ -49,6 +50,7 @@
 int VRTApplyMetadata( CPLXMLNode *, GDALMajorObject * );
 CPLXMLNode *VRTSerializeMetadata( GDALMajorObject * );
 CPLErr GDALRegisterDefaultPixelFunc();
+bool VRTIsInThreadPoolJob();
 CPLString VRTSerializeNoData(double dfVal, GDALDataType eDataType, int nPrecision);
 #if 0
 int VRTWarpedOverviewTransform( void *pTransformArg, int bDstToSrc,
@@ -154,6 +156,14 @@ VRTSource *VRTParseCoreSources( CPLXMLNode *psTree, const char *, void* pUniqueH
 VRTSource *VRTParseFilterSources( CPLXMLNode *psTree, const char *, void* pUniqueHandle,
                                   std::map<CPLString, GDALDataset*>& oMapSharedSources );
 
+/* Binary VRT (.bvrt) representation. See vrtbinary.cpp */
+bool VRTSerializeToBinary( const CPLXMLNode* psDSTree,
+                           std::vector<GByte>& abyData );
+bool VRTBinaryIdentify( GDALOpenInfo* poOpenInfo );
+GDALDataset* VRTBinaryOpen( GDALOpenInfo* poOpenInfo );
+bool VRTWriteDatasetTree( const CPLXMLNode* psDSTree,
+                          const char* pszFilename );
+
 /************************************************************************/
 /*                              VRTDataset                              */
 /************************************************************************/
@@ -213,6 +223,10 @@ class CPL_DLL VRTDataset CPL_NON_FINAL: public GDALDataset
 
     int            m_nRecursionCounter = 0;
 
+    // Number of threads used to read sources, or -1 to use the
+    // VRT_NUM_THREADS configuration option.
+    int            m_nNumThreads = -1;
+
     VRTRasterBand*      InitBand(const char* pszSubclass, int nBand,
                                  bool bAllowPansharpened);
     static GDALDataset *OpenVRTProtocol( const char* pszSpec );
@@ -233,6 +247,8 @@ class CPL_DLL VRTDataset CPL_NON_FINAL: public GDALDataset
 
     void SetWritable(int bWritableIn) { m_bWritable = CPL_TO_BOOL(bWritableIn); }
 
+    int           GetNumThreads() const;
+
     virtual CPLErr          CreateMaskBand( int nFlags ) override;
     void SetMaskBand(VRTRasterBand* poMaskBand);
 
@@ -362,6 +378,11 @@ public:
     virtual char      **GetFileList() override;
 
     CPLErr            ProcessBlock( int iBlockX, int iBlockY );
+    CPLErr            ProcessBlocks( int iBlockX, int iBlockY,
+                                     int nBlocksX, int nBlocksY );
+    CPLErr            PrefetchBlocks( VRTWarpedRasterBand* poBand,
+                                      int nXOff, int nYOff,
+                                      int nXSize, int nYSize );
 
     void              GetBlockSize( int *, int * ) const;
 
@@ -574,6 +595,8 @@ class CPL_DLL VRTRasterBand CPL_NON_FINAL: public GDALRasterBand
 
 class VRTSimpleSource;
 
+class CPLPackedRTree;
+
 class CPL_DLL VRTSourcedRasterBand CPL_NON_FINAL: public VRTRasterBand
 {
   private:
@@ -584,6 +607,31 @@ class CPL_DLL VRTSourcedRasterBand CPL_NON_FINAL: public VRTRasterBand
     bool           CanUseSourcesMinMaxImplementations();
     void           CheckSource( VRTSimpleSource *poSS );
 
+    // Spatial index of the destination windows of the sources, lazily
+    // built for bands with many sources.
+    CPLPackedRTree *m_poSourcesIndex = nullptr;
+    VRTSource    **m_papoSourcesIndexed = nullptr;
+    int            m_nSourcesIndexed = 0;
+    std::vector<int> m_anSourcesIndexed{};
+    std::vector<int> m_anSourcesNotIndexed{};
+
+    void           BuildSourcesIndex();
+    void           InvalidateSourcesIndex();
+
+    CPLErr         ResampledRasterIOFromSourceOverviews(
+                                int nXOff, int nYOff, int nXSize, int nYSize,
+                                void *pData, int nBufXSize, int nBufYSize,
+                                GDALDataType eBufType,
+                                GSpacing nPixelSpace, GSpacing nLineSpace,
+                                GDALRasterIOExtraArg* psExtraArg,
+                                const std::vector<int>& anSources,
+                                int* pbTried );
+
+    // Capacity of papoSources, valid as long as papoSources is equal to
+    // m_papoSourcesAllocated.
+    VRTSource    **m_papoSourcesAllocated = nullptr;
+    int            m_nSourcesAllocated = 0;
+
     CPL_DISALLOW_COPY_ASSIGN(VRTSourcedRasterBand)
 
   public:
@@ -641,6 +689,20 @@ class CPL_DLL VRTSourcedRasterBand CPL_NON_FINAL: public VRTRasterBand
                                   GDALProgressFunc pfnProgress,
                                   void *pProgressData ) override;
 
+    void           GetSourcesIntersectingWindow( double dfXOff, double dfYOff,
+                                                 double dfXSize,
+                                                 double dfYSize,
+                                                 std::vector<int>& anSources );
+    bool           ReadSourcesMultiThreaded(
+                        int nXOff, int nYOff, int nXSize, int nYSize,
+                        int nBufXSize, int nBufYSize,
+                        const GDALRasterIOExtraArg* psExtraArg,
+                        const std::vector<int>& anSources,
+                        const std::function<CPLErr(VRTSimpleSource*,
+                                                   GDALRasterIOExtraArg*)>&
+                            fnReadSource,
+                        CPLErr& eErr );
+
     CPLErr         AddSource( VRTSource * );
     CPLErr         AddSimpleSource( GDALRasterBand *poSrcBand,
                                     double dfSrcXOff=-1, double dfSrcYOff=-1,
@@ -696,6 +758,8 @@ class CPL_DLL VRTSourcedRasterBand CPL_NON_FINAL: public VRTRasterBand
 
 class CPL_DLL VRTWarpedRasterBand final: public VRTRasterBand
 {
+    friend class VRTWarpedDataset;
+
   public:
                    VRTWarpedRasterBand( GDALDataset *poDS, int nBand,
                                         GDALDataType eType = GDT_Unknown );
@@ -705,6 +769,10 @@ class CPL_DLL VRTWarpedRasterBand final: public VRTRasterBand
 
     virtual CPLErr IReadBlock( int, int, void * ) override;
     virtual CPLErr IWriteBlock( int, int, void * ) override;
+    virtual CPLErr IRasterIO( GDALRWFlag, int, int, int, int,
+                              void *, int, int, GDALDataType,
+                              GSpacing nPixelSpace, GSpacing nLineSpace,
+                              GDALRasterIOExtraArg* psExtraArg ) override;
 
     virtual int GetOverviewCount() override;
     virtual GDALRasterBand *GetOverview(int) override;
@@ -764,6 +832,20 @@ class CPL_DLL VRTDerivedRasterBand CPL_NON_FINAL: public VRTSourcedRasterBand
 
     using PixelFunc = std::function<CPLErr(void**, int, void*, int, int, GDALDataType, GDALDataType, int, int, CSLConstList)>;
 
+ private:
+    bool ApplyPixelFunctionMultiThreaded( const PixelFunc& oPixelFunc,
+                                          void** pBuffers, int nSrcTypeSize,
+                                          void* pData,
+                                          int nBufXSize, int nBufYSize,
+                                          GDALDataType eSrcType,
+                                          GDALDataType eBufType,
+                                          GSpacing nPixelSpace,
+                                          GSpacing nLineSpace,
+                                          CSLConstList papszArgs,
+                                          CPLErr& eErr );
+
+ public:
+
     VRTDerivedRasterBand( GDALDataset *poDS, int nBand );
     VRTDerivedRasterBand( GDALDataset *poDS, int nBand,
                           GDALDataType eType, int nXSize, int nYSize );
@@ -786,6 +868,9 @@ class CPL_DLL VRTDerivedRasterBand CPL_NON_FINAL: public VRTSourcedRasterBand
                                     const char *pszMetadata);
 
     static PixelFunc* GetPixelFunction( const char *pszFuncName );
+    static bool IsPixelFunctionReentrant( const char *pszFuncName );
+    static void SetPixelFunctionReentrant( const char *pszFuncName,
+                                           bool bReentrant );
 
     void SetPixelFunctionName( const char *pszFuncName );
     void SetSourceTransferType( GDALDataType eDataType );
@@ -900,7 +985,36 @@ protected:
     friend class VRTSourcedRasterBand;
     friend class VRTDataset;
 
-    GDALRasterBand      *m_poRasterBand;
+    // Source band. For sources initialized from XML with complete
+    // SourceProperties, the proxy dataset is only created when the band is
+    // first accessed, so that VRTs with many sources open faster and use
+    // less memory.
+    class LazyRasterBand
+    {
+        VRTSimpleSource          *m_poOwner;
+        mutable GDALRasterBand   *m_poBand;
+
+        CPL_DISALLOW_COPY_ASSIGN(LazyRasterBand)
+
+      public:
+        LazyRasterBand( VRTSimpleSource* poOwner, GDALRasterBand* poBand ) :
+            m_poOwner(poOwner), m_poBand(poBand) {}
+
+        inline GDALRasterBand* get() const;
+        operator GDALRasterBand*() const { return get(); }
+        GDALRasterBand* operator->() const { return get(); }
+        LazyRasterBand& operator=( GDALRasterBand* poBand )
+            { m_poBand = poBand; return *this; }
+    };
+
+    // Information needed to create the proxy dataset of a source whose
+    // band has not been accessed yet. Null otherwise.
+    struct DeferredProxyInfo;
+    std::unique_ptr<DeferredProxyInfo> m_poDeferredProxyInfo;
+
+    void                InstantiateDeferredBand();
+
+    LazyRasterBand      m_poRasterBand;
 
     // When poRasterBand is a mask band, poMaskBandMainBand is the band
     // from which the mask band is taken.
@@ -1009,6 +1123,13 @@ public:
     void             SetMaxValue( int nVal ) { m_nMaxValue = nVal; }
 };
 
+inline GDALRasterBand* VRTSimpleSource::LazyRasterBand::get() const
+{
+    if( m_poBand == nullptr && m_poOwner->m_poDeferredProxyInfo )
+        m_poOwner->InstantiateDeferredBand();
+    return m_poBand;
+}
+
 /************************************************************************/
 /*                          VRTAveragedSource                           */
 /************************************************************************/
@@ -1080,6 +1201,27 @@ protected:
 
     bool           m_bUseMaskBand = false;
 
+    // Byte output value, or -1 for nodata, of each possible value of a Byte
+    // or UInt16 source, and the parameters it has been computed with.
+    std::vector<GInt16> m_anByteTable{};
+    std::vector<double> m_adfByteTableKey{};
+
+    bool            ComputeSrcMinMaxIfNeeded();
+    bool            ReadMaskIfNeeded( int bNoDataSet,
+                                      int nReqXOff, int nReqYOff,
+                                      int nReqXSize, int nReqYSize,
+                                      int nOutXSize, int nOutYSize,
+                                      GDALRasterIOExtraArg* psExtraArg,
+                                      std::vector<GByte>& abyMask );
+
+    template <class SrcDT>
+    CPLErr          RasterIOByteTable( int nReqXOff, int nReqYOff,
+                                       int nReqXSize, int nReqYSize,
+                                       void *pData,
+                                       int nOutXSize, int nOutYSize,
+                                       GSpacing nPixelSpace, GSpacing nLineSpace,
+                                       GDALRasterIOExtraArg* psExtraArg );
+
     template <class WorkingDT>
     CPLErr          RasterIOInternal( int nReqXOff, int nReqYOff,
                                       int nReqXSize, int nReqYSize,
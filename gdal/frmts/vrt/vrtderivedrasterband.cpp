@@ -32,10 +32,14 @@
 #include "cpl_string.h"
 #include "vrtdataset.h"
 #include "cpl_multiproc.h"
+#include "cpl_worker_thread_pool.h"
+#include "gdal_thread_pool.h"
 #include "gdalpython.h"
 
 #include <algorithm>
 #include <map>
+#include <mutex>
+#include <set>
 #include <vector>
 #include <utility>
 
@@ -53,6 +57,10 @@ using namespace GDALPy;
 #endif
 
 static std::map<CPLString, VRTDerivedRasterBand::PixelFunc> osMapPixelFunction;
+// Pixel functions that can be called concurrently on disjoint row ranges
+// of a buffer.
+static std::set<CPLString> oSetReentrantPixelFunction;
+static std::mutex oPixelFunctionMutex;
 
 /* Flags for getting buffers */
 #define PyBUF_WRITABLE 0x0001
@@ -245,6 +253,8 @@ GDALAddDerivedBandPixelFunc( const char *pszFuncName,
       return CE_None;
     }
 
+    std::lock_guard<std::mutex> oLock(oPixelFunctionMutex);
+    oSetReentrantPixelFunction.erase(pszFuncName);
     osMapPixelFunction[pszFuncName] = [pfnNewFunction](void **papoSources, int nSources, void *pData,
                                          int nBufXSize, int nBufYSize,
                                          GDALDataType eSrcType, GDALDataType eBufType,
@@ -270,7 +280,13 @@ GDALAddDerivedBandPixelFunc( const char *pszFuncName,
  * @param pfnNewFunction Pixel function associated with name.  An
  *  existing pixel function registered with the same name will be
  *  replaced with the new one.
- * @param pszMetadata Pixel function metadata (not currently implemented)
+ * @param pszMetadata Pixel function metadata, or NULL. This is a XML string
+ *  whose root element may have a reentrant="true" attribute, for example
+ *  &lt;PixelFunction reentrant="true"/&gt;, to indicate that the function may
+ *  be called concurrently from several threads on disjoint ranges of rows of
+ *  a request, that is that each output row only depends on the same row of
+ *  the sources. This enables multi-threaded evaluation with the NUM_THREADS
+ *  open option or the VRT_NUM_THREADS configuration option.
  *
  * @return CE_None, invalid (NULL) parameters are currently ignored.
  * @since GDAL 3.4
@@ -286,9 +302,23 @@ GDALAddDerivedBandPixelFuncWithArgs(const char *pszFuncName,
         return CE_None;
     }
 
-    (void) pszMetadata;
+    bool bReentrant = false;
+    if( pszMetadata != nullptr && pszMetadata[0] != '\0' )
+    {
+        CPLXMLTreeCloser oTree(CPLParseXMLString(pszMetadata));
+        const CPLXMLNode* psRoot = oTree.get();
+        while( psRoot != nullptr && psRoot->eType != CXT_Element )
+            psRoot = psRoot->psNext;
+        if( psRoot != nullptr )
+            bReentrant = CPLTestBool(CPLGetXMLValue(psRoot, "reentrant", "NO"));
+    }
 
+    std::lock_guard<std::mutex> oLock(oPixelFunctionMutex);
     osMapPixelFunction[pszFuncName] = pfnNewFunction;
+    if( bReentrant )
+        oSetReentrantPixelFunction.insert(pszFuncName);
+    else
+        oSetReentrantPixelFunction.erase(pszFuncName);
 
     return CE_None;
 }
@@ -345,6 +375,7 @@ VRTDerivedRasterBand::GetPixelFunction( const char *pszFuncName )
         return nullptr;
     }
 
+    std::lock_guard<std::mutex> oLock(oPixelFunctionMutex);
     auto oIter = osMapPixelFunction.find(pszFuncName);
 
     if( oIter == osMapPixelFunction.end())
@@ -353,6 +384,46 @@ VRTDerivedRasterBand::GetPixelFunction( const char *pszFuncName )
     return &(oIter->second);
 }
 
+/************************************************************************/
+/*                        IsPixelFunctionReentrant()                    */
+/************************************************************************/
+
+/**
+ * Return whether a pixel function has been registered as reentrant, that is
+ * that it can be called concurrently on disjoint ranges of rows.
+ *
+ * @param pszFuncName The name associated with the pixel function.
+ */
+bool VRTDerivedRasterBand::IsPixelFunctionReentrant( const char *pszFuncName )
+{
+    if( pszFuncName == nullptr )
+        return false;
+    std::lock_guard<std::mutex> oLock(oPixelFunctionMutex);
+    return oSetReentrantPixelFunction.find(pszFuncName) !=
+                                        oSetReentrantPixelFunction.end();
+}
+
+/************************************************************************/
+/*                        SetPixelFunctionReentrant()                   */
+/************************************************************************/
+
+/**
+ * Mark a registered pixel function as reentrant or not.
+ *
+ * @see IsPixelFunctionReentrant()
+ */
+void VRTDerivedRasterBand::SetPixelFunctionReentrant( const char *pszFuncName,
+                                                      bool bReentrant )
+{
+    std::lock_guard<std::mutex> oLock(oPixelFunctionMutex);
+    if( osMapPixelFunction.find(pszFuncName) == osMapPixelFunction.end() )
+        return;
+    if( bReentrant )
+        oSetReentrantPixelFunction.insert(pszFuncName);
+    else
+        oSetReentrantPixelFunction.erase(pszFuncName);
+}
+
 /************************************************************************/
 /*                         SetPixelFunctionName()                       */
 /************************************************************************/
@@ -743,6 +814,122 @@ bool VRTDerivedRasterBand::InitializePython()
     return true;
 }
 
+/************************************************************************/
+/*                   ApplyPixelFunctionMultiThreaded()                  */
+/************************************************************************/
+
+namespace {
+
+struct VRTPixelFunctionJob
+{
+    const VRTDerivedRasterBand::PixelFunc* pfnPixelFunc = nullptr;
+    std::vector<void*> apSources{};
+    void* pData = nullptr;
+    int nBufXSize = 0;
+    int nBufYSize = 0;
+    GDALDataType eSrcType = GDT_Unknown;
+    GDALDataType eBufType = GDT_Unknown;
+    int nPixelSpace = 0;
+    int nLineSpace = 0;
+    CSLConstList papszArgs = nullptr;
+    CPLErr eErr = CE_None;
+    std::string osErrorMsg{};
+};
+
+static void VRTPixelFunctionJobFunc( void* pData )
+{
+    VRTPixelFunctionJob* psJob = static_cast<VRTPixelFunctionJob*>(pData);
+    // Errors are emitted again by the calling thread.
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    CPLErrorReset();
+    psJob->eErr = (*psJob->pfnPixelFunc)(
+        psJob->apSources.data(), static_cast<int>(psJob->apSources.size()),
+        psJob->pData, psJob->nBufXSize, psJob->nBufYSize,
+        psJob->eSrcType, psJob->eBufType,
+        psJob->nPixelSpace, psJob->nLineSpace, psJob->papszArgs);
+    if( psJob->eErr != CE_None )
+        psJob->osErrorMsg = CPLGetLastErrorMsg();
+    CPLPopErrorHandler();
+}
+
+} // namespace
+
+/** Apply a reentrant pixel function on ranges of rows of the request with
+ * several threads, as set by the NUM_THREADS open option or the
+ * VRT_NUM_THREADS configuration option.
+ *
+ * @return false if the pixel function must be applied sequentially, in which
+ * case nothing has been done.
+ */
+bool VRTDerivedRasterBand::ApplyPixelFunctionMultiThreaded(
+        const PixelFunc& oPixelFunc, void** pBuffers, int nSrcTypeSize,
+        void* pData, int nBufXSize, int nBufYSize,
+        GDALDataType eSrcType, GDALDataType eBufType,
+        GSpacing nPixelSpace, GSpacing nLineSpace,
+        CSLConstList papszArgs, CPLErr& eErr )
+{
+    // Pixel functions do not read datasets, but the band may be read from
+    // a job of the thread pool, which must not wait for other jobs.
+    if( VRTIsInThreadPoolJob() || !IsPixelFunctionReentrant(pszFuncName) )
+        return false;
+    VRTDataset* poVRTDS = dynamic_cast<VRTDataset*>(poDS);
+    const int nThreads = poVRTDS ? poVRTDS->GetNumThreads() : 1;
+    if( nThreads <= 1 )
+        return false;
+
+    // Do not bother for small requests.
+    constexpr int MIN_PIXELS_PER_JOB = 65536;
+    const int nRowsPerJobMin =
+        std::max(1, MIN_PIXELS_PER_JOB / std::max(1, nBufXSize));
+    const int nJobs = std::min(nThreads, nBufYSize / nRowsPerJobMin);
+    if( nJobs <= 1 )
+        return false;
+
+    CPLWorkerThreadPool* poThreadPool = GDALGetGlobalThreadPool(nThreads);
+    if( poThreadPool == nullptr )
+        return false;
+    auto poJobQueue = poThreadPool->CreateJobQueue();
+
+    std::vector<VRTPixelFunctionJob> asJobs(nJobs);
+    for( int iJob = 0; iJob < nJobs; iJob++ )
+    {
+        const int nYStart = static_cast<int>(
+            static_cast<GIntBig>(iJob) * nBufYSize / nJobs);
+        const int nYEnd = static_cast<int>(
+            static_cast<GIntBig>(iJob + 1) * nBufYSize / nJobs);
+        auto& sJob = asJobs[iJob];
+        sJob.pfnPixelFunc = &oPixelFunc;
+        for( int iSource = 0; iSource < nSources; iSource++ )
+        {
+            sJob.apSources.push_back(static_cast<GByte*>(pBuffers[iSource]) +
+                static_cast<size_t>(nYStart) * nBufXSize * nSrcTypeSize);
+        }
+        sJob.pData = static_cast<GByte*>(pData) + nYStart * nLineSpace;
+        sJob.nBufXSize = nBufXSize;
+        sJob.nBufYSize = nYEnd - nYStart;
+        sJob.eSrcType = eSrcType;
+        sJob.eBufType = eBufType;
+        sJob.nPixelSpace = static_cast<int>(nPixelSpace);
+        sJob.nLineSpace = static_cast<int>(nLineSpace);
+        sJob.papszArgs = papszArgs;
+        poJobQueue->SubmitJob(VRTPixelFunctionJobFunc, &sJob);
+    }
+    poJobQueue->WaitCompletion();
+
+    eErr = CE_None;
+    for( const auto& sJob : asJobs )
+    {
+        if( sJob.eErr != CE_None )
+        {
+            CPLError(sJob.eErr, CPLE_AppDefined, "%s",
+                     sJob.osErrorMsg.c_str());
+            eErr = sJob.eErr;
+            break;
+        }
+    }
+    return true;
+}
+
 /************************************************************************/
 /*                             IRasterIO()                              */
 /************************************************************************/
@@ -1214,11 +1401,18 @@ CPLErr VRTDerivedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
             papszArgs = CSLSetNameValue(papszArgs, pszKey, pszValue);
         }
 
-        eErr = (*poPixelFunc)(static_cast<void **>( pBuffers ), nSources,
-                              pData, nBufXSize, nBufYSize,
-                              eSrcType, eBufType, static_cast<int>(nPixelSpace),
-                              static_cast<int>(nLineSpace),
-                              papszArgs);
+        if( !ApplyPixelFunctionMultiThreaded(
+                *poPixelFunc, pBuffers, nSrcTypeSize, pData,
+                nBufXSize, nBufYSize, eSrcType, eBufType,
+                nPixelSpace, nLineSpace, papszArgs, eErr) )
+        {
+            eErr = (*poPixelFunc)(static_cast<void **>( pBuffers ), nSources,
+                                  pData, nBufXSize, nBufYSize,
+                                  eSrcType, eBufType,
+                                  static_cast<int>(nPixelSpace),
+                                  static_cast<int>(nLineSpace),
+                                  papszArgs);
+        }
 
         CSLDestroy(papszArgs);
     }
@@ -198,10 +198,6 @@ VRTCreateCopy( const char * pszFilename,
         CPLXMLNode *psDSTree = static_cast<VRTDataset *>(
             poSrcDS )->SerializeToXML( pszVRTPath );
 
-        char *pszXML = CPLSerializeXMLTree( psDSTree );
-
-        CPLDestroyXMLNode( psDSTree );
-
         CPLFree( pszVRTPath );
 
     /* -------------------------------------------------------------------- */
@@ -211,32 +207,26 @@ VRTCreateCopy( const char * pszFilename,
 
         if( 0 != strlen( pszFilename ) )
         {
-            VSILFILE *fpVRT = VSIFOpenL( pszFilename, "wb" );
-            if( fpVRT == nullptr )
-            {
-                CPLError(CE_Failure, CPLE_AppDefined,
-                         "Cannot create %s", pszFilename);
-                CPLFree( pszXML );
-                return nullptr;
-            }
-
-            bool bRet = VSIFWriteL( pszXML, strlen(pszXML), 1, fpVRT ) > 0;
-            if( VSIFCloseL( fpVRT ) != 0 )
-                bRet = false;
+            const bool bRet = VRTWriteDatasetTree( psDSTree, pszFilename );
+            CPLDestroyXMLNode( psDSTree );
 
+            // Binary VRT files can only be opened in read-only mode.
             if( bRet )
                 pCopyDS = GDALDataset::Open( pszFilename,
-                    GDAL_OF_RASTER | GDAL_OF_MULTIDIM_RASTER | GDAL_OF_UPDATE);
+                    GDAL_OF_RASTER | GDAL_OF_MULTIDIM_RASTER |
+                    (EQUAL(CPLGetExtension(pszFilename), "bvrt") ?
+                                                    0 : GDAL_OF_UPDATE));
         }
         else
         {
             /* No destination file is given, so pass serialized XML directly. */
+            char *pszXML = CPLSerializeXMLTree( psDSTree );
+            CPLDestroyXMLNode( psDSTree );
             pCopyDS = GDALDataset::Open( pszXML,
                 GDAL_OF_RASTER | GDAL_OF_MULTIDIM_RASTER | GDAL_OF_UPDATE);
+            CPLFree( pszXML );
         }
 
-        CPLFree( pszXML );
-
         return pCopyDS;
     }
 
@@ -435,6 +425,7 @@ void GDALRegister_VRT()
     poDriver->SetMetadataItem( GDAL_DCAP_MULTIDIM_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Virtual Raster" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "vrt" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "vrt bvrt" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "drivers/raster/vrt.html" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
                                "Byte Int16 UInt16 Int32 UInt32 Float32 Float64 "
@@ -452,6 +443,8 @@ void GDALRegister_VRT()
 "  <Option name='ROOT_PATH' type='string' description='Root path to evaluate "
 "relative paths inside the VRT. Mainly useful for inlined VRT, or in-memory "
 "VRT, where their own directory does not make sense'/>"
+"  <Option name='NUM_THREADS' type='string' description='Number of threads "
+"used to read sources. Integer or ALL_CPUS' default='1'/>"
 "</OpenOptionList>" );
 
     poDriver->SetMetadataItem( GDAL_DCAP_VIRTUALIO, "YES" );
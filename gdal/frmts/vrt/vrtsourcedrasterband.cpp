@@ -37,17 +37,24 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_hash_set.h"
 #include "cpl_minixml.h"
 #include "cpl_progress.h"
+#include "cpl_packed_rtree.h"
+#include "cpl_quad_tree.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_priv.h"
+#include "gdal_thread_pool.h"
 #include "ogr_geometry.h"
 
 CPL_CVSID("$Id$")
@@ -202,7 +209,9 @@ CPLErr VRTSourcedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
         psExtraArg->eResampleAlg != GRIORA_NearestNeighbour &&
         m_bNoDataValueSet )
     {
-        for( int i = 0; i < nSources; i++ )
+        std::vector<int> anSources;
+        GetSourcesIntersectingWindow(nXOff, nYOff, nXSize, nYSize, anSources);
+        for( const int i : anSources )
         {
             bool bFallbackToBase = false;
             if( !papoSources[i]->IsSimpleSource() )
@@ -258,6 +267,15 @@ CPLErr VRTSourcedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
             }
             if( bFallbackToBase )
             {
+                int bTried = FALSE;
+                const CPLErr eErr = ResampledRasterIOFromSourceOverviews(
+                    nXOff, nYOff, nXSize, nYSize,
+                    pData, nBufXSize, nBufYSize,
+                    eBufType, nPixelSpace, nLineSpace, psExtraArg,
+                    anSources, &bTried );
+                if( bTried )
+                    return eErr;
+
                 return GDALRasterBand::IRasterIO( eRWFlag,
                                                   nXOff, nYOff, nXSize, nYSize,
                                                   pData, nBufXSize, nBufYSize,
@@ -318,20 +336,41 @@ CPLErr VRTSourcedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
 /* -------------------------------------------------------------------- */
 /*      Overlay each source in turn over top this.                      */
 /* -------------------------------------------------------------------- */
+    std::vector<int> anSources;
+    GetSourcesIntersectingWindow(nXOff, nYOff, nXSize, nYSize, anSources);
+    const int nCandidateSources = static_cast<int>(anSources.size());
+
     CPLErr eErr = CE_None;
-    for( int iSource = 0; eErr == CE_None && iSource < nSources; iSource++ )
+    if( ReadSourcesMultiThreaded(
+            nXOff, nYOff, nXSize, nYSize, nBufXSize, nBufYSize,
+            psExtraArg, anSources,
+            [=](VRTSimpleSource* poSource,
+                GDALRasterIOExtraArg* psSourceExtraArg)
+            {
+                return poSource->RasterIO( eDataType,
+                                           nXOff, nYOff, nXSize, nYSize,
+                                           pData, nBufXSize, nBufYSize,
+                                           eBufType, nPixelSpace, nLineSpace,
+                                           psSourceExtraArg );
+            }, eErr) )
+    {
+        m_nRecursionCounter--;
+        return eErr;
+    }
+
+    for( int i = 0; eErr == CE_None && i < nCandidateSources; i++ )
     {
         psExtraArg->pfnProgress = GDALScaledProgress;
         psExtraArg->pProgressData =
-            GDALCreateScaledProgress( 1.0 * iSource / nSources,
-                                      1.0 * (iSource + 1) / nSources,
+            GDALCreateScaledProgress( 1.0 * i / nCandidateSources,
+                                      1.0 * (i + 1) / nCandidateSources,
                                       pfnProgressGlobal,
                                       pProgressDataGlobal );
         if( psExtraArg->pProgressData == nullptr )
             psExtraArg->pfnProgress = nullptr;
 
         eErr =
-            papoSources[iSource]->RasterIO( eDataType,
+            papoSources[anSources[i]]->RasterIO( eDataType,
                                             nXOff, nYOff, nXSize, nYSize,
                                             pData, nBufXSize, nBufYSize,
                                             eBufType, nPixelSpace, nLineSpace,
@@ -348,6 +387,164 @@ CPLErr VRTSourcedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
     return eErr;
 }
 
+/************************************************************************/
+/*                ResampledRasterIOFromSourceOverviews()                */
+/************************************************************************/
+
+/* When a downsampled read with a non-nearest resampling cannot be */
+/* delegated to the sources (because of nodata), the generic implementation */
+/* would read the window at full resolution. Instead, read it at the */
+/* coarsest resolution that all sources can provide from their overviews, */
+/* and resample that intermediate buffer taking into account the nodata */
+/* value of the VRT band. */
+
+CPLErr VRTSourcedRasterBand::ResampledRasterIOFromSourceOverviews(
+                                int nXOff, int nYOff, int nXSize, int nYSize,
+                                void *pData, int nBufXSize, int nBufYSize,
+                                GDALDataType eBufType,
+                                GSpacing nPixelSpace, GSpacing nLineSpace,
+                                GDALRasterIOExtraArg* psExtraArg,
+                                const std::vector<int>& anSources,
+                                int* pbTried )
+{
+    *pbTried = FALSE;
+
+    // Number of VRT pixels per pixel of the coarsest common resolution.
+    double dfXFactor = static_cast<double>(nXSize) / nBufXSize;
+    double dfYFactor = static_cast<double>(nYSize) / nBufYSize;
+    for( const int i : anSources )
+    {
+        if( !papoSources[i]->IsSimpleSource() )
+            return CE_None;
+        VRTSimpleSource* const poSource
+            = static_cast<VRTSimpleSource *>( papoSources[i] );
+        GDALRasterBand* poSrcBand = poSource->GetBand();
+        if( poSrcBand == nullptr || poSrcBand->GetOverviewCount() == 0 )
+            return CE_None;
+
+        double dfReqXOff = 0.0;
+        double dfReqYOff = 0.0;
+        double dfReqXSize = 0.0;
+        double dfReqYSize = 0.0;
+        int nReqXOff = 0;
+        int nReqYOff = 0;
+        int nReqXSize = 0;
+        int nReqYSize = 0;
+        int nOutXOff = 0;
+        int nOutYOff = 0;
+        int nOutXSize = 0;
+        int nOutYSize = 0;
+
+        // Source window at the full resolution of the VRT.
+        if( !poSource->GetSrcDstWindow( nXOff, nYOff, nXSize, nYSize,
+                              nXSize, nYSize,
+                              &dfReqXOff, &dfReqYOff, &dfReqXSize, &dfReqYSize,
+                              &nReqXOff, &nReqYOff, &nReqXSize, &nReqYSize,
+                              &nOutXOff, &nOutYOff, &nOutXSize, &nOutYSize ) )
+        {
+            continue;
+        }
+        if( dfReqXSize <= 0 || dfReqYSize <= 0 )
+            return CE_None;
+        const double dfVRTToSrcXRatio = nOutXSize / dfReqXSize;
+        const double dfVRTToSrcYRatio = nOutYSize / dfReqYSize;
+
+        // Overview the source would use for the requested buffer size.
+        const int nOutBufXSize = std::max(1, static_cast<int>(
+            0.5 + static_cast<double>(nOutXSize) * nBufXSize / nXSize));
+        const int nOutBufYSize = std::max(1, static_cast<int>(
+            0.5 + static_cast<double>(nOutYSize) * nBufYSize / nYSize));
+        const int nOverview = GDALBandGetBestOverviewLevel2(
+            poSrcBand, nReqXOff, nReqYOff, nReqXSize, nReqYSize,
+            nOutBufXSize, nOutBufYSize, nullptr );
+        if( nOverview < 0 )
+            return CE_None;
+        GDALRasterBand* poOvrBand = poSrcBand->GetOverview(nOverview);
+        if( poOvrBand == nullptr )
+            return CE_None;
+
+        dfXFactor = std::min(dfXFactor, dfVRTToSrcXRatio *
+            poSrcBand->GetXSize() / poOvrBand->GetXSize());
+        dfYFactor = std::min(dfYFactor, dfVRTToSrcYRatio *
+            poSrcBand->GetYSize() / poOvrBand->GetYSize());
+    }
+
+    const int nInterXSize = std::max(nBufXSize, std::min(nXSize,
+        static_cast<int>(std::ceil(nXSize / dfXFactor))));
+    const int nInterYSize = std::max(nBufYSize, std::min(nYSize,
+        static_cast<int>(std::ceil(nYSize / dfYFactor))));
+    if( nInterXSize == nXSize && nInterYSize == nYSize )
+        return CE_None;
+
+    GDALDriver* poMEMDrv = GetGDALDriverManager()->GetDriverByName("MEM");
+    if( poMEMDrv == nullptr )
+        return CE_None;
+
+    const GDALDataType eInterDT = GetRasterDataType();
+    const int nInterDTSize = GDALGetDataTypeSizeBytes(eInterDT);
+    GByte* pabyInter = static_cast<GByte*>(
+        VSI_MALLOC3_VERBOSE(nInterXSize, nInterYSize, nInterDTSize));
+    if( pabyInter == nullptr )
+        return CE_None;
+
+    *pbTried = TRUE;
+
+    // Read sources at the intermediate resolution, which lets them pick
+    // their overviews.
+    GDALRasterIOExtraArg sExtraArg;
+    INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+    sExtraArg.pfnProgress = psExtraArg->pfnProgress;
+    sExtraArg.pProgressData = psExtraArg->pProgressData;
+    CPLErr eErr = IRasterIO( GF_Read, nXOff, nYOff, nXSize, nYSize,
+                             pabyInter, nInterXSize, nInterYSize,
+                             eInterDT, nInterDTSize,
+                             static_cast<GSpacing>(nInterDTSize) * nInterXSize,
+                             &sExtraArg );
+
+    if( eErr == CE_None )
+    {
+        // Wrap the intermediate buffer as a MEM dataset and resample it.
+        auto poMEMDS = std::unique_ptr<GDALDataset>(
+            poMEMDrv->Create("", nInterXSize, nInterYSize, 0, eInterDT,
+                             nullptr));
+        if( poMEMDS == nullptr )
+        {
+            eErr = CE_Failure;
+        }
+        else
+        {
+            char szBuffer[32] = { '\0' };
+            const int nRet = CPLPrintPointer(szBuffer, pabyInter,
+                                             sizeof(szBuffer));
+            szBuffer[nRet] = 0;
+            char szBuffer0[64] = { '\0' };
+            snprintf( szBuffer0, sizeof(szBuffer0),
+                      "DATAPOINTER=%s", szBuffer );
+            char* apszOptions[2] = { szBuffer0, nullptr };
+            poMEMDS->AddBand(eInterDT, apszOptions);
+            GDALRasterBand* poMEMBand = poMEMDS->GetRasterBand(1);
+            poMEMBand->SetNoDataValue(m_dfNoDataValue);
+
+            GDALCopyRasterIOExtraArg(&sExtraArg, psExtraArg);
+            const double dfXRatio = static_cast<double>(nInterXSize) / nXSize;
+            const double dfYRatio = static_cast<double>(nInterYSize) / nYSize;
+            if( psExtraArg->bFloatingPointWindowValidity )
+            {
+                sExtraArg.dfXOff = (psExtraArg->dfXOff - nXOff) * dfXRatio;
+                sExtraArg.dfYOff = (psExtraArg->dfYOff - nYOff) * dfYRatio;
+                sExtraArg.dfXSize = psExtraArg->dfXSize * dfXRatio;
+                sExtraArg.dfYSize = psExtraArg->dfYSize * dfYRatio;
+            }
+            eErr = poMEMBand->RasterIO( GF_Read, 0, 0, nInterXSize, nInterYSize,
+                                        pData, nBufXSize, nBufYSize, eBufType,
+                                        nPixelSpace, nLineSpace, &sExtraArg );
+        }
+    }
+
+    VSIFree(pabyInter);
+    return eErr;
+}
+
 /************************************************************************/
 /*                         IGetDataCoverageStatus()                     */
 /************************************************************************/
@@ -386,7 +583,9 @@ int  VRTSourcedRasterBand::IGetDataCoverageStatus( int nXOff,
     poLR->addPoint( nXOff, nYOff );
     poPolyNonCoveredBySources->addRingDirectly(poLR);
 
-    for( int iSource = 0; iSource < nSources; iSource++ )
+    std::vector<int> anSources;
+    GetSourcesIntersectingWindow(nXOff, nYOff, nXSize, nYSize, anSources);
+    for( const int iSource : anSources )
     {
         if( !papoSources[iSource]->IsSimpleSource() )
         {
@@ -936,6 +1135,376 @@ CPLErr VRTSourcedRasterBand::GetHistogram( double dfMin, double dfMax,
     return CE_None;
 }
 
+/************************************************************************/
+/*                         BuildSourcesIndex()                          */
+/************************************************************************/
+
+void VRTSourcedRasterBand::BuildSourcesIndex()
+
+{
+    m_papoSourcesIndexed = papoSources;
+    m_nSourcesIndexed = nSources;
+
+    // The index is built once and queried for each RasterIO() request, so
+    // use a bulk loaded packed R-tree. Indices of the tree items are indices
+    // in m_anSourcesIndexed.
+    std::vector<CPLRectObj> asBounds;
+    for( int iSource = 0; iSource < nSources; iSource++ )
+    {
+        // Sources without an explicit destination window may cover the
+        // whole band, and are always returned.
+        if( !papoSources[iSource]->IsSimpleSource() )
+        {
+            m_anSourcesNotIndexed.push_back(iSource);
+            continue;
+        }
+        VRTSimpleSource* poSS =
+            static_cast<VRTSimpleSource*>(papoSources[iSource]);
+        if( poSS->m_dfDstXOff == -1 || poSS->m_dfDstYOff == -1 ||
+            poSS->m_dfDstXSize == -1 || poSS->m_dfDstYSize == -1 )
+        {
+            m_anSourcesNotIndexed.push_back(iSource);
+            continue;
+        }
+
+        CPLRectObj sBounds;
+        sBounds.minx = poSS->m_dfDstXOff;
+        sBounds.miny = poSS->m_dfDstYOff;
+        sBounds.maxx = poSS->m_dfDstXOff + poSS->m_dfDstXSize;
+        sBounds.maxy = poSS->m_dfDstYOff + poSS->m_dfDstYSize;
+        asBounds.push_back(sBounds);
+        m_anSourcesIndexed.push_back(iSource);
+    }
+    m_poSourcesIndex = new CPLPackedRTree(asBounds.data(), asBounds.size());
+}
+
+/************************************************************************/
+/*                       InvalidateSourcesIndex()                       */
+/************************************************************************/
+
+void VRTSourcedRasterBand::InvalidateSourcesIndex()
+
+{
+    delete m_poSourcesIndex;
+    m_poSourcesIndex = nullptr;
+    m_papoSourcesIndexed = nullptr;
+    m_nSourcesIndexed = 0;
+    m_anSourcesIndexed.clear();
+    m_anSourcesNotIndexed.clear();
+}
+
+/************************************************************************/
+/*                    GetSourcesIntersectingWindow()                    */
+/************************************************************************/
+
+/** Return the indices, in increasing order, of the sources whose
+ * destination window may intersect the specified window. Sources that are
+ * returned still need to check the window by themselves.
+ */
+void VRTSourcedRasterBand::GetSourcesIntersectingWindow(
+                                        double dfXOff, double dfYOff,
+                                        double dfXSize, double dfYSize,
+                                        std::vector<int>& anSources )
+
+{
+    anSources.clear();
+
+    // Below that number of sources, a linear scan is cheap enough.
+    constexpr int MIN_SOURCES_FOR_INDEX = 64;
+    if( nSources < MIN_SOURCES_FOR_INDEX )
+    {
+        for( int iSource = 0; iSource < nSources; iSource++ )
+            anSources.push_back(iSource);
+        return;
+    }
+
+    // Sources may have been modified without going through AddSource().
+    if( m_poSourcesIndex == nullptr ||
+        m_papoSourcesIndexed != papoSources ||
+        m_nSourcesIndexed != nSources )
+    {
+        InvalidateSourcesIndex();
+        BuildSourcesIndex();
+    }
+
+    // Enlarge the window by one pixel to be tolerant to the rounding
+    // done by the sources when computing their source window.
+    CPLRectObj sAoi;
+    sAoi.minx = dfXOff - 1;
+    sAoi.miny = dfYOff - 1;
+    sAoi.maxx = dfXOff + dfXSize + 1;
+    sAoi.maxy = dfYOff + dfYSize + 1;
+    std::vector<size_t> anItems;
+    m_poSourcesIndex->Search(sAoi, anItems);
+    anSources.reserve(anItems.size() + m_anSourcesNotIndexed.size());
+    for( const size_t nItem: anItems )
+        anSources.push_back(m_anSourcesIndexed[nItem]);
+    anSources.insert(anSources.end(), m_anSourcesNotIndexed.begin(),
+                     m_anSourcesNotIndexed.end());
+
+    // Sources must be composited in their order of declaration.
+    std::sort(anSources.begin(), anSources.end());
+}
+
+/************************************************************************/
+/*                      ReadSourcesMultiThreaded()                      */
+/************************************************************************/
+
+namespace {
+
+struct VRTSourceGroupJob
+{
+    std::vector<VRTSimpleSource*> apoSources{};
+    const std::function<CPLErr(VRTSimpleSource*,
+                               GDALRasterIOExtraArg*)>* pfnReadSource = nullptr;
+    GDALRasterIOExtraArg sExtraArg{};
+    CPLErr eErr = CE_None;
+    std::string osErrorMsg{};
+};
+
+// Set in worker threads, so that sources that are themselves VRTs do not
+// wait for jobs of the thread pool from one of its threads.
+static thread_local bool gbInVRTSourceGroupJob = false;
+
+static void VRTSourceGroupJobFunc( void* pData )
+{
+    VRTSourceGroupJob* psJob = static_cast<VRTSourceGroupJob*>(pData);
+    gbInVRTSourceGroupJob = true;
+    // Errors are emitted again by the calling thread.
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    CPLErrorReset();
+    for( VRTSimpleSource* poSource : psJob->apoSources )
+    {
+        psJob->eErr = (*psJob->pfnReadSource)(poSource, &psJob->sExtraArg);
+        if( psJob->eErr != CE_None )
+        {
+            psJob->osErrorMsg = CPLGetLastErrorMsg();
+            break;
+        }
+    }
+    CPLPopErrorHandler();
+    gbInVRTSourceGroupJob = false;
+}
+
+static int FindRoot( std::vector<int>& anParent, int i )
+{
+    while( anParent[i] != i )
+    {
+        anParent[i] = anParent[anParent[i]];
+        i = anParent[i];
+    }
+    return i;
+}
+
+} // namespace
+
+/** Whether the current thread is running a job of the global thread pool
+ * submitted by the VRT driver. Such a job must not wait for other jobs. */
+bool VRTIsInThreadPoolJob()
+{
+    return gbInVRTSourceGroupJob;
+}
+
+/** Read the sources of a request with several threads, as set by the
+ * NUM_THREADS open option or the VRT_NUM_THREADS configuration option.
+ *
+ * Sources whose output windows in the buffer overlap, or that read from the
+ * same dataset, are put in the same group and read sequentially in their
+ * declaration order, so that the result is the same as a sequential read.
+ * Different groups are read concurrently.
+ *
+ * @return false if the request must be done sequentially, in which case
+ * nothing has been read.
+ */
+bool VRTSourcedRasterBand::ReadSourcesMultiThreaded(
+        int nXOff, int nYOff, int nXSize, int nYSize,
+        int nBufXSize, int nBufYSize,
+        const GDALRasterIOExtraArg* psExtraArg,
+        const std::vector<int>& anSources,
+        const std::function<CPLErr(VRTSimpleSource*,
+                                   GDALRasterIOExtraArg*)>& fnReadSource,
+        CPLErr& eErr )
+{
+    if( anSources.size() < 2 || gbInVRTSourceGroupJob )
+        return false;
+    VRTDataset* poVRTDS = dynamic_cast<VRTDataset*>(poDS);
+    const int nThreads = poVRTDS ? poVRTDS->GetNumThreads() : 1;
+    if( nThreads <= 1 )
+        return false;
+
+    double dfXOff = nXOff;
+    double dfYOff = nYOff;
+    double dfXSize = nXSize;
+    double dfYSize = nYSize;
+    if( psExtraArg->bFloatingPointWindowValidity )
+    {
+        dfXOff = psExtraArg->dfXOff;
+        dfYOff = psExtraArg->dfYOff;
+        dfXSize = psExtraArg->dfXSize;
+        dfYSize = psExtraArg->dfYSize;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Collect the sources that contribute to the buffer, with their   */
+/*      output window.                                                  */
+/* -------------------------------------------------------------------- */
+    std::vector<VRTSimpleSource*> apoSources;
+    std::vector<CPLRectObj> asOutWindows;
+    std::vector<int> anParent;
+    std::map<CPLString, int> oMapDatasetToSource;
+    for( const int iSource : anSources )
+    {
+        // Other kinds of sources may write outside of their output window,
+        // or not be safe to use from another thread.
+        if( !papoSources[iSource]->IsSimpleSource() )
+            return false;
+        VRTSimpleSource* poSS =
+            static_cast<VRTSimpleSource*>(papoSources[iSource]);
+        const char* pszType = poSS->GetType();
+        if( !EQUAL(pszType, "SimpleSource") &&
+            !EQUAL(pszType, "ComplexSource") &&
+            !EQUAL(pszType, "AveragedSource") )
+        {
+            return false;
+        }
+
+        double dfReqXOff = 0.0;
+        double dfReqYOff = 0.0;
+        double dfReqXSize = 0.0;
+        double dfReqYSize = 0.0;
+        int nReqXOff = 0;
+        int nReqYOff = 0;
+        int nReqXSize = 0;
+        int nReqYSize = 0;
+        int nOutXOff = 0;
+        int nOutYOff = 0;
+        int nOutXSize = 0;
+        int nOutYSize = 0;
+        if( !poSS->GetSrcDstWindow( dfXOff, dfYOff, dfXSize, dfYSize,
+                                    nBufXSize, nBufYSize,
+                                    &dfReqXOff, &dfReqYOff,
+                                    &dfReqXSize, &dfReqYSize,
+                                    &nReqXOff, &nReqYOff,
+                                    &nReqXSize, &nReqYSize,
+                                    &nOutXOff, &nOutYOff,
+                                    &nOutXSize, &nOutYSize ) )
+        {
+            continue;
+        }
+
+        GDALRasterBand* poSrcBand = poSS->m_poMaskBandMainBand ?
+            poSS->m_poMaskBandMainBand : poSS->m_poRasterBand;
+        GDALDataset* poSrcDS = poSrcBand ? poSrcBand->GetDataset() : nullptr;
+        if( poSrcDS == nullptr )
+            return false;
+
+        const int iIdx = static_cast<int>(apoSources.size());
+        apoSources.push_back(poSS);
+        anParent.push_back(iIdx);
+        CPLRectObj sRect;
+        sRect.minx = nOutXOff;
+        sRect.miny = nOutYOff;
+        sRect.maxx = nOutXOff + nOutXSize - 1;
+        sRect.maxy = nOutYOff + nOutYSize - 1;
+        asOutWindows.push_back(sRect);
+
+        // Sources sharing the same underlying dataset, either directly or
+        // through the proxy pool, cannot be read concurrently.
+        CPLString osKey(poSrcDS->GetDescription());
+        if( osKey.empty() )
+            osKey.Printf("%p", poSrcDS);
+        const auto oIter = oMapDatasetToSource.find(osKey);
+        if( oIter == oMapDatasetToSource.end() )
+            oMapDatasetToSource[osKey] = iIdx;
+        else
+            anParent[iIdx] = FindRoot(anParent, oIter->second);
+    }
+    if( apoSources.size() < 2 )
+        return false;
+
+/* -------------------------------------------------------------------- */
+/*      Group sources whose output windows overlap.                     */
+/* -------------------------------------------------------------------- */
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = 0;
+    sGlobalBounds.miny = 0;
+    sGlobalBounds.maxx = nBufXSize;
+    sGlobalBounds.maxy = nBufYSize;
+    CPLQuadTree* hTree = CPLQuadTreeCreate(&sGlobalBounds, nullptr);
+    for( size_t i = 0; i < apoSources.size(); i++ )
+    {
+        int nFeatureCount = 0;
+        void** pahFeatures =
+            CPLQuadTreeSearch(hTree, &asOutWindows[i], &nFeatureCount);
+        for( int j = 0; j < nFeatureCount; j++ )
+        {
+            const int iOther = static_cast<int>(
+                static_cast<CPLRectObj*>(pahFeatures[j]) - asOutWindows.data());
+            const int iRoot = FindRoot(anParent, static_cast<int>(i));
+            const int iOtherRoot = FindRoot(anParent, iOther);
+            anParent[std::max(iRoot, iOtherRoot)] = std::min(iRoot, iOtherRoot);
+        }
+        CPLFree(pahFeatures);
+        CPLQuadTreeInsertWithBounds(hTree, &asOutWindows[i],
+                                    &asOutWindows[i]);
+    }
+    CPLQuadTreeDestroy(hTree);
+
+    std::map<int, size_t> oMapRootToJob;
+    std::vector<VRTSourceGroupJob> asJobs;
+    for( size_t i = 0; i < apoSources.size(); i++ )
+    {
+        const int iRoot = FindRoot(anParent, static_cast<int>(i));
+        const auto oIter = oMapRootToJob.find(iRoot);
+        if( oIter == oMapRootToJob.end() )
+        {
+            oMapRootToJob[iRoot] = asJobs.size();
+            asJobs.emplace_back();
+            asJobs.back().apoSources.push_back(apoSources[i]);
+        }
+        else
+        {
+            asJobs[oIter->second].apoSources.push_back(apoSources[i]);
+        }
+    }
+    if( asJobs.size() < 2 )
+        return false;
+
+    CPLWorkerThreadPool* poThreadPool = GDALGetGlobalThreadPool(nThreads);
+    if( poThreadPool == nullptr )
+        return false;
+    auto poJobQueue = poThreadPool->CreateJobQueue();
+
+/* -------------------------------------------------------------------- */
+/*      Read the groups concurrently.                                   */
+/* -------------------------------------------------------------------- */
+    for( auto& sJob : asJobs )
+    {
+        sJob.pfnReadSource = &fnReadSource;
+        sJob.sExtraArg = *psExtraArg;
+        sJob.sExtraArg.pfnProgress = nullptr;
+        sJob.sExtraArg.pProgressData = nullptr;
+        poJobQueue->SubmitJob(VRTSourceGroupJobFunc, &sJob);
+    }
+    poJobQueue->WaitCompletion();
+
+    eErr = CE_None;
+    for( const auto& sJob : asJobs )
+    {
+        if( sJob.eErr != CE_None )
+        {
+            CPLError(sJob.eErr, CPLE_AppDefined, "%s",
+                     sJob.osErrorMsg.c_str());
+            eErr = sJob.eErr;
+            break;
+        }
+    }
+    if( eErr == CE_None && psExtraArg->pfnProgress )
+        psExtraArg->pfnProgress(1.0, "", psExtraArg->pProgressData);
+
+    return true;
+}
+
 /************************************************************************/
 /*                             AddSource()                              */
 /************************************************************************/
@@ -943,10 +1512,22 @@ CPLErr VRTSourcedRasterBand::GetHistogram( double dfMin, double dfMax,
 CPLErr VRTSourcedRasterBand::AddSource( VRTSource *poNewSource )
 
 {
-    nSources++;
+    InvalidateSourcesIndex();
 
-    papoSources = static_cast<VRTSource **>(
-        CPLRealloc( papoSources, sizeof(void*) * nSources ) );
+    // Grow the array geometrically, so that adding many sources (typically
+    // when opening a VRT with thousands of them) is not quadratic.
+    if( papoSources != m_papoSourcesAllocated )
+        m_nSourcesAllocated = nSources;
+    if( nSources == m_nSourcesAllocated )
+    {
+        m_nSourcesAllocated = std::max(4, m_nSourcesAllocated +
+                                          m_nSourcesAllocated / 2);
+        papoSources = static_cast<VRTSource **>(
+            CPLRealloc( papoSources, sizeof(void*) * m_nSourcesAllocated ) );
+        m_papoSourcesAllocated = papoSources;
+    }
+
+    nSources++;
     papoSources[nSources-1] = poNewSource;
 
     static_cast<VRTDataset *>( poDS )->SetNeedsFlush();
@@ -1090,12 +1671,14 @@ void VRTSourcedRasterBand::CheckSource( VRTSimpleSource *poSS )
     if( strcmp(poSS->GetType(), "SimpleSource") == 0 &&
         poSS->m_dfSrcXOff >= 0.0 &&
         poSS->m_dfSrcYOff >= 0.0 &&
-        poSS->m_dfSrcXOff + poSS->m_dfSrcXSize <= poSS->m_poRasterBand->GetXSize() &&
-        poSS->m_dfSrcYOff + poSS->m_dfSrcYSize <= poSS->m_poRasterBand->GetYSize() &&
+        // Test the destination window first, so that sources covering
+        // only part of the band do not need their band to be instantiated.
         poSS->m_dfDstXOff <= 0.0 &&
         poSS->m_dfDstYOff <= 0.0 &&
         poSS->m_dfDstXOff + poSS->m_dfDstXSize >= nRasterXSize &&
-        poSS->m_dfDstYOff + poSS->m_dfDstYSize >= nRasterYSize )
+        poSS->m_dfDstYOff + poSS->m_dfDstYSize >= nRasterYSize &&
+        poSS->m_dfSrcXOff + poSS->m_dfSrcXSize <= poSS->m_poRasterBand->GetXSize() &&
+        poSS->m_dfSrcYOff + poSS->m_dfSrcYSize <= poSS->m_poRasterBand->GetYSize() )
     {
         bSkipBufferInitialization = TRUE;
     }
@@ -1666,6 +2249,7 @@ CPLErr VRTSourcedRasterBand::SetMetadataItem( const char *pszName,
 
         if( poSource != nullptr )
         {
+            InvalidateSourcesIndex();
             delete papoSources[iSource];
             papoSources[iSource] = poSource;
             static_cast<VRTDataset *>( poDS )->SetNeedsFlush();
@@ -1694,6 +2278,7 @@ CPLErr VRTSourcedRasterBand::SetMetadata( char **papszNewMD, const char *pszDoma
 
         if( EQUAL(pszDomain,"vrt_sources") )
         {
+            InvalidateSourcesIndex();
             for( int i = 0; i < nSources; i++ )
                 delete papoSources[i];
             CPLFree( papoSources );
@@ -1755,6 +2340,8 @@ int VRTSourcedRasterBand::CloseDependentDatasets()
 {
     int ret = VRTRasterBand::CloseDependentDatasets();
 
+    InvalidateSourcesIndex();
+
     if( nSources == 0 )
         return ret;
 
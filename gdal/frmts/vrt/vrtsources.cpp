@@ -40,6 +40,7 @@
 #include <algorithm>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -92,12 +93,30 @@ void VRTSource::GetFileList(char*** /* ppapszFileList */,
 /* ==================================================================== */
 /************************************************************************/
 
+/************************************************************************/
+/*                          DeferredProxyInfo                           */
+/************************************************************************/
+
+struct VRTSimpleSource::DeferredProxyInfo
+{
+    CPLString      osSrcDSName{};
+    int            nSrcBand = 0;
+    GDALDataType   eDataType = GDT_Unknown;
+    int            nRasterXSize = 0;
+    int            nRasterYSize = 0;
+    int            nBlockXSize = 0;
+    int            nBlockYSize = 0;
+    bool           bShared = false;
+    CPLStringList  aosOpenOptions{};
+    CPLString      osUniqueHandle{};
+};
+
 /************************************************************************/
 /*                          VRTSimpleSource()                           */
 /************************************************************************/
 
 VRTSimpleSource::VRTSimpleSource() :
-    m_poRasterBand(nullptr),
+    m_poRasterBand(this, nullptr),
     m_poMaskBandMainBand(nullptr),
     m_dfSrcXOff(0.0),
     m_dfSrcYOff(0.0),
@@ -121,7 +140,7 @@ VRTSimpleSource::VRTSimpleSource() :
 
 VRTSimpleSource::VRTSimpleSource( const VRTSimpleSource* poSrcSource,
                                   double dfXDstRatio, double dfYDstRatio ) :
-    m_poRasterBand(poSrcSource->m_poRasterBand),
+    m_poRasterBand(this, poSrcSource->m_poRasterBand.get()),
     m_poMaskBandMainBand(poSrcSource->m_poMaskBandMainBand),
     m_dfSrcXOff(poSrcSource->m_dfSrcXOff),
     m_dfSrcYOff(poSrcSource->m_dfSrcYOff),
@@ -146,7 +165,7 @@ VRTSimpleSource::VRTSimpleSource( const VRTSimpleSource* poSrcSource,
 VRTSimpleSource::~VRTSimpleSource()
 
 {
-    if( !m_bDropRefOnSrcBand )
+    if( !m_bDropRefOnSrcBand || m_poDeferredProxyInfo )
         return;
 
     if( m_poMaskBandMainBand != nullptr )
@@ -169,6 +188,8 @@ VRTSimpleSource::~VRTSimpleSource()
 CPLErr VRTSimpleSource::FlushCache()
 
 {
+    if( m_poDeferredProxyInfo )
+        return CE_None;
     if( m_poMaskBandMainBand != nullptr )
     {
         return m_poMaskBandMainBand->FlushCache();
@@ -706,6 +727,25 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath,
                         papszOpenOptions, nullptr ) );
         }
     }
+    else if( !bGetMaskBand )
+    {
+        /* ----------------------------------------------------------------- */
+        /*      Defer the creation of the proxy dataset until the band is    */
+        /*      actually needed. See InstantiateDeferredBand()               */
+        /* ----------------------------------------------------------------- */
+        m_poDeferredProxyInfo.reset(new DeferredProxyInfo());
+        m_poDeferredProxyInfo->osSrcDSName = osSrcDSName;
+        m_poDeferredProxyInfo->nSrcBand = nSrcBand;
+        m_poDeferredProxyInfo->eDataType = eDataType;
+        m_poDeferredProxyInfo->nRasterXSize = nRasterXSize;
+        m_poDeferredProxyInfo->nRasterYSize = nRasterYSize;
+        m_poDeferredProxyInfo->nBlockXSize = nBlockXSize;
+        m_poDeferredProxyInfo->nBlockYSize = nBlockYSize;
+        m_poDeferredProxyInfo->bShared = bShared;
+        m_poDeferredProxyInfo->aosOpenOptions = CSLDuplicate(papszOpenOptions);
+        m_poDeferredProxyInfo->osUniqueHandle =
+            CPLSPrintf("%p", pUniqueHandle);
+    }
     else
     {
         /* ----------------------------------------------------------------- */
@@ -742,30 +782,33 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath,
 
     CSLDestroy(papszOpenOptions);
 
-    if( poSrcDS == nullptr )
-        return CE_Failure;
+    if( !m_poDeferredProxyInfo )
+    {
+        if( poSrcDS == nullptr )
+            return CE_Failure;
 
 /* -------------------------------------------------------------------- */
 /*      Get the raster band.                                            */
 /* -------------------------------------------------------------------- */
 
-    m_poRasterBand = poSrcDS->GetRasterBand(nSrcBand);
-    if( m_poRasterBand == nullptr )
-    {
-        poSrcDS->ReleaseRef();
-        return CE_Failure;
-    }
-    else if( bAddToMapIfOk )
-    {
-        oMapSharedSources[osSrcDSName] = poSrcDS;
-    }
-
-    if( bGetMaskBand )
-    {
-        m_poMaskBandMainBand = m_poRasterBand;
-        m_poRasterBand = m_poRasterBand->GetMaskBand();
+        m_poRasterBand = poSrcDS->GetRasterBand(nSrcBand);
         if( m_poRasterBand == nullptr )
+        {
+            poSrcDS->ReleaseRef();
             return CE_Failure;
+        }
+        else if( bAddToMapIfOk )
+        {
+            oMapSharedSources[osSrcDSName] = poSrcDS;
+        }
+
+        if( bGetMaskBand )
+        {
+            m_poMaskBandMainBand = m_poRasterBand;
+            m_poRasterBand = m_poRasterBand->GetMaskBand();
+            if( m_poRasterBand == nullptr )
+                return CE_Failure;
+        }
     }
 
 /* -------------------------------------------------------------------- */
@@ -826,6 +869,33 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath,
     return CE_None;
 }
 
+/************************************************************************/
+/*                      InstantiateDeferredBand()                       */
+/************************************************************************/
+
+void VRTSimpleSource::InstantiateDeferredBand()
+{
+    std::unique_ptr<DeferredProxyInfo> poInfo(
+        std::move(m_poDeferredProxyInfo));
+    if( !poInfo )
+        return;
+
+    GDALProxyPoolDataset * const proxyDS =
+        new GDALProxyPoolDataset( poInfo->osSrcDSName,
+                                  poInfo->nRasterXSize, poInfo->nRasterYSize,
+                                  GA_ReadOnly, poInfo->bShared,
+                                  nullptr, nullptr,
+                                  poInfo->osUniqueHandle.c_str() );
+    proxyDS->SetOpenOptions(poInfo->aosOpenOptions.List());
+    // See comment in XMLInit() about adding only the band of interest.
+    proxyDS->AddSrcBand(poInfo->nSrcBand, poInfo->eDataType,
+                        poInfo->nBlockXSize, poInfo->nBlockYSize);
+
+    m_poRasterBand = proxyDS->GetRasterBand(poInfo->nSrcBand);
+    if( m_poRasterBand == nullptr )
+        proxyDS->ReleaseRef();
+}
+
 /************************************************************************/
 /*                             GetFileList()                            */
 /************************************************************************/
@@ -834,8 +904,12 @@ void VRTSimpleSource::GetFileList( char*** ppapszFileList, int *pnSize,
                                    int *pnMaxSize, CPLHashSet* hSetFiles )
 {
     const char* pszFilename = nullptr;
-    if( m_poRasterBand != nullptr && m_poRasterBand->GetDataset() != nullptr &&
-        (pszFilename = m_poRasterBand->GetDataset()->GetDescription()) != nullptr )
+    if( m_poDeferredProxyInfo )
+        pszFilename = m_poDeferredProxyInfo->osSrcDSName.c_str();
+    else if( m_poRasterBand != nullptr &&
+             m_poRasterBand->GetDataset() != nullptr )
+        pszFilename = m_poRasterBand->GetDataset()->GetDescription();
+    if( pszFilename != nullptr )
     {
 /* -------------------------------------------------------------------- */
 /*      Is the filename even a real filesystem object?                  */
@@ -886,7 +960,7 @@ void VRTSimpleSource::GetFileList( char*** ppapszFileList, int *pnSize,
 
 GDALRasterBand* VRTSimpleSource::GetBand()
 {
-    return m_poMaskBandMainBand ? nullptr : m_poRasterBand;
+    return m_poMaskBandMainBand ? nullptr : m_poRasterBand.get();
 }
 
 /************************************************************************/
@@ -2591,6 +2665,36 @@ VRTComplexSource::RasterIO( GDALDataType /*eBandDataType*/,
     psExtraArg->dfXSize = dfReqXSize;
     psExtraArg->dfYSize = dfReqYSize;
 
+/* -------------------------------------------------------------------- */
+/*      Use a table of the output value of each possible source value   */
+/*      for Byte and UInt16 sources read as Byte, unless resampling     */
+/*      could create values in between the source ones.                 */
+/* -------------------------------------------------------------------- */
+    if( eBufType == GDT_Byte && m_nColorTableComponent == 0 &&
+        !(m_eScalingType == VRT_SCALING_LINEAR && m_dfScaleRatio == 0 &&
+          !m_bNoDataSet && !m_bUseMaskBand) &&
+        ((nReqXSize == nOutXSize && nReqYSize == nOutYSize) ||
+         psExtraArg->eResampleAlg == GRIORA_NearestNeighbour) )
+    {
+        GByte* pabyOut = static_cast<GByte *>(pData) +
+            nPixelSpace * nOutXOff + static_cast<GPtrDiff_t>(nLineSpace) * nOutYOff;
+        const GDALDataType eSrcType = m_poRasterBand->GetRasterDataType();
+        if( eSrcType == GDT_Byte )
+        {
+            return RasterIOByteTable<GByte>(
+                nReqXOff, nReqYOff, nReqXSize, nReqYSize,
+                pabyOut, nOutXSize, nOutYSize,
+                nPixelSpace, nLineSpace, psExtraArg );
+        }
+        if( eSrcType == GDT_UInt16 )
+        {
+            return RasterIOByteTable<GUInt16>(
+                nReqXOff, nReqYOff, nReqXSize, nReqYSize,
+                pabyOut, nOutXSize, nOutYSize,
+                nPixelSpace, nLineSpace, psExtraArg );
+        }
+    }
+
     const bool bIsComplex = CPL_TO_BOOL( GDALDataTypeIsComplex(eBufType) );
     CPLErr eErr;
     // For Int32, float32 isn't sufficiently precise as working data type
@@ -2622,6 +2726,258 @@ VRTComplexSource::RasterIO( GDALDataType /*eBandDataType*/,
     return eErr;
 }
 
+/************************************************************************/
+/*                      ComputeSrcMinMaxIfNeeded()                      */
+/************************************************************************/
+
+// Determine the source min/max for exponential scaling, when they have not
+// been provided.
+bool VRTComplexSource::ComputeSrcMinMaxIfNeeded()
+{
+    if( m_bSrcMinMaxDefined )
+        return true;
+
+    int bSuccessMin = FALSE;
+    int bSuccessMax = FALSE;
+    double adfMinMax[2] = {
+        m_poRasterBand->GetMinimum(&bSuccessMin),
+        m_poRasterBand->GetMaximum(&bSuccessMax) };
+    if( (bSuccessMin && bSuccessMax) ||
+        m_poRasterBand->ComputeRasterMinMax( TRUE, adfMinMax ) == CE_None )
+    {
+        m_dfSrcMin = adfMinMax[0];
+        m_dfSrcMax = adfMinMax[1];
+        m_bSrcMinMaxDefined = TRUE;
+        return true;
+    }
+
+    CPLError( CE_Failure, CPLE_AppDefined,
+              "Cannot determine source min/max value" );
+    return false;
+}
+
+/************************************************************************/
+/*                          ReadMaskIfNeeded()                          */
+/************************************************************************/
+
+// Allocate and read the mask band if it is used to determine the valid
+// pixels. abyMask is left empty otherwise.
+bool VRTComplexSource::ReadMaskIfNeeded( int bNoDataSet,
+                                         int nReqXOff, int nReqYOff,
+                                         int nReqXSize, int nReqYSize,
+                                         int nOutXSize, int nOutYSize,
+                                         GDALRasterIOExtraArg* psExtraArg,
+                                         std::vector<GByte>& abyMask )
+{
+    if( bNoDataSet || !m_bUseMaskBand ||
+        (m_poRasterBand->GetMaskFlags() == GMF_ALL_VALID &&
+         m_poRasterBand->GetColorInterpretation() != GCI_AlphaBand &&
+         m_poMaskBandMainBand == nullptr) )
+    {
+        return true;
+    }
+
+    try
+    {
+        abyMask.resize(static_cast<size_t>(nOutXSize) * nOutYSize);
+    }
+    catch( const std::exception& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Out of memory when allocating mask buffer");
+        return false;
+    }
+    auto poMaskBand = (m_poRasterBand->GetColorInterpretation() == GCI_AlphaBand ||
+                       m_poMaskBandMainBand != nullptr) ?
+        m_poRasterBand.get() : m_poRasterBand->GetMaskBand();
+    return poMaskBand->RasterIO( GF_Read,
+                                 nReqXOff, nReqYOff,
+                                 nReqXSize, nReqYSize,
+                                 &abyMask[0],
+                                 nOutXSize, nOutYSize,
+                                 GDT_Byte,
+                                 1,
+                                 static_cast<GSpacing>(nOutXSize),
+                                 psExtraArg ) == CE_None;
+}
+
+/************************************************************************/
+/*                         RasterIOByteTable()                          */
+/************************************************************************/
+
+// Specialized version of RasterIOInternal<float>() for Byte and UInt16
+// sources read into a Byte buffer. As there are at most 65536 different
+// source values, the output value of each of them is computed once, with
+// the same operations as RasterIOInternal(), and the pixels are then
+// processed with a table lookup.
+template <class SrcDT>
+CPLErr VRTComplexSource::RasterIOByteTable( int nReqXOff, int nReqYOff,
+                                            int nReqXSize, int nReqYSize,
+                                            void *pData,
+                                            int nOutXSize, int nOutYSize,
+                                            GSpacing nPixelSpace,
+                                            GSpacing nLineSpace,
+                                            GDALRasterIOExtraArg* psExtraArg )
+{
+    constexpr int nValues = 1 << (8 * sizeof(SrcDT));
+    const GDALDataType eSrcType = sizeof(SrcDT) == 1 ? GDT_Byte : GDT_UInt16;
+
+    // Same as in RasterIOInternal()
+    int bNoDataSet = m_bNoDataSet;
+    double dfNoDataValue = m_dfNoDataValue;
+    if( !m_bNoDataSet && m_bUseMaskBand &&
+        m_poRasterBand->GetMaskFlags() == GMF_NODATA )
+    {
+        dfNoDataValue = m_poRasterBand->GetNoDataValue(&bNoDataSet);
+    }
+    const bool bNoDataSetAndNotNan = bNoDataSet && !CPLIsNan(dfNoDataValue) &&
+                                GDALIsValueInRange<float>(dfNoDataValue);
+    const float fWorkingDataTypeNoData = static_cast<float>(dfNoDataValue);
+
+    if( m_eScalingType == VRT_SCALING_EXPONENTIAL &&
+        !ComputeSrcMinMaxIfNeeded() )
+    {
+        return CE_Failure;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      (Re)compute the table if the parameters have changed.           */
+/* -------------------------------------------------------------------- */
+    std::vector<double> adfKey {
+        static_cast<double>(eSrcType),
+        bNoDataSetAndNotNan ? fWorkingDataTypeNoData : 0.0,
+        static_cast<double>(bNoDataSetAndNotNan),
+        static_cast<double>(m_eScalingType),
+        m_dfScaleOff, m_dfScaleRatio,
+        m_dfSrcMin, m_dfSrcMax, m_dfDstMin, m_dfDstMax, m_dfExponent,
+        static_cast<double>(m_nMaxValue),
+        static_cast<double>(m_nLUTItemCount) };
+    for( int i = 0; i < m_nLUTItemCount; i++ )
+    {
+        adfKey.push_back(m_padfLUTInputs[i]);
+        adfKey.push_back(m_padfLUTOutputs[i]);
+    }
+    if( adfKey.size() != m_adfByteTableKey.size() ||
+        memcmp(adfKey.data(), m_adfByteTableKey.data(),
+               adfKey.size() * sizeof(double)) != 0 )
+    {
+        m_adfByteTableKey.clear();
+        m_anByteTable.resize(nValues);
+        for( int iValue = 0; iValue < nValues; iValue++ )
+        {
+            float fResult = static_cast<float>(iValue);
+            if( bNoDataSetAndNotNan &&
+                ARE_REAL_EQUAL(fResult, fWorkingDataTypeNoData) )
+            {
+                m_anByteTable[iValue] = -1;
+                continue;
+            }
+
+            if( m_eScalingType == VRT_SCALING_LINEAR )
+            {
+                fResult = static_cast<float>(
+                    fResult * m_dfScaleRatio + m_dfScaleOff );
+            }
+            else if( m_eScalingType == VRT_SCALING_EXPONENTIAL )
+            {
+                double dfPowVal =
+                    (fResult - m_dfSrcMin) / (m_dfSrcMax - m_dfSrcMin);
+                if( dfPowVal < 0.0 )
+                    dfPowVal = 0.0;
+                else if( dfPowVal > 1.0 )
+                    dfPowVal = 1.0;
+                fResult = static_cast<float>(
+                    (m_dfDstMax - m_dfDstMin) *
+                    pow( dfPowVal, m_dfExponent ) +
+                    m_dfDstMin);
+            }
+
+            if( m_nLUTItemCount )
+                fResult = static_cast<float>(LookupValue( fResult ));
+
+            if( m_nMaxValue != 0 && fResult > m_nMaxValue )
+                fResult = static_cast<float>(m_nMaxValue);
+
+            m_anByteTable[iValue] = static_cast<GByte>(
+                std::min(255.0f, std::max(0.0f, fResult + 0.5f)));
+        }
+        m_adfByteTableKey = std::move(adfKey);
+    }
+    const GInt16* panTable = m_anByteTable.data();
+
+/* -------------------------------------------------------------------- */
+/*      Read the source values and the mask.                            */
+/* -------------------------------------------------------------------- */
+    std::vector<SrcDT> aSrcData;
+    std::vector<GByte> abyMask;
+    try
+    {
+        aSrcData.resize(static_cast<size_t>(nOutXSize) * nOutYSize);
+    }
+    catch( const std::exception& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Out of memory when allocating buffer");
+        return CE_Failure;
+    }
+
+    const GDALRIOResampleAlg eResampleAlgBack = psExtraArg->eResampleAlg;
+    if( !m_osResampling.empty() )
+    {
+        psExtraArg->eResampleAlg = GDALRasterIOGetResampleAlg(m_osResampling);
+    }
+    const CPLErr eErr =
+        m_poRasterBand->RasterIO( GF_Read,
+                                  nReqXOff, nReqYOff, nReqXSize, nReqYSize,
+                                  aSrcData.data(), nOutXSize, nOutYSize,
+                                  eSrcType, sizeof(SrcDT),
+                                  static_cast<GSpacing>(sizeof(SrcDT)) * nOutXSize,
+                                  psExtraArg );
+    if( !m_osResampling.empty() )
+        psExtraArg->eResampleAlg = eResampleAlgBack;
+    if( eErr != CE_None )
+        return eErr;
+
+    if( !ReadMaskIfNeeded( bNoDataSet, nReqXOff, nReqYOff,
+                           nReqXSize, nReqYSize, nOutXSize, nOutYSize,
+                           psExtraArg, abyMask ) )
+    {
+        return CE_Failure;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Apply the table.                                                */
+/* -------------------------------------------------------------------- */
+    const bool bHasSkippedValues = bNoDataSetAndNotNan || !abyMask.empty();
+    for( int iY = 0; iY < nOutYSize; iY++ )
+    {
+        GByte *pabyDst = static_cast<GByte *>(pData)
+            + static_cast<GPtrDiff_t>(nLineSpace) * iY;
+        const size_t nSrcIdx = static_cast<size_t>(iY) * nOutXSize;
+        const SrcDT* pSrc = aSrcData.data() + nSrcIdx;
+
+        if( !bHasSkippedValues && nPixelSpace == 1 )
+        {
+            for( int iX = 0; iX < nOutXSize; iX++ )
+                pabyDst[iX] = static_cast<GByte>(panTable[pSrc[iX]]);
+        }
+        else
+        {
+            const GByte* pabyMask =
+                abyMask.empty() ? nullptr : abyMask.data() + nSrcIdx;
+            for( int iX = 0; iX < nOutXSize; iX++, pabyDst += nPixelSpace )
+            {
+                const GInt16 nVal = panTable[pSrc[iX]];
+                if( nVal < 0 || (pabyMask && pabyMask[iX] == 0) )
+                    continue;
+                *pabyDst = static_cast<GByte>(nVal);
+            }
+        }
+    }
+
+    return CE_None;
+}
+
 /************************************************************************/
 /*                          RasterIOInternal()                          */
 /************************************************************************/
@@ -2711,39 +3067,12 @@ CPLErr VRTComplexSource::RasterIOInternal( int nReqXOff, int nReqYOff,
             return eErr;
         }
 
-        // Allocate and read mask band if needed
-        if( !bNoDataSet && m_bUseMaskBand &&
-            (m_poRasterBand->GetMaskFlags() != GMF_ALL_VALID ||
-             m_poRasterBand->GetColorInterpretation() == GCI_AlphaBand ||
-             m_poMaskBandMainBand != nullptr) )
+        if( !ReadMaskIfNeeded( bNoDataSet, nReqXOff, nReqYOff,
+                               nReqXSize, nReqYSize, nOutXSize, nOutYSize,
+                               psExtraArg, abyMask ) )
         {
-            try
-            {
-                abyMask.resize(nOutXSize * nOutYSize);
-            }
-            catch( const std::exception& )
-            {
-                CPLError(CE_Failure, CPLE_OutOfMemory,
-                         "Out of memory when allocating mask buffer");
-                CPLFree( pafData );
-                return CE_Failure;
-            }
-            auto poMaskBand = (m_poRasterBand->GetColorInterpretation() == GCI_AlphaBand ||
-                               m_poMaskBandMainBand != nullptr) ?
-                m_poRasterBand : m_poRasterBand->GetMaskBand();
-            if( poMaskBand->RasterIO( GF_Read,
-                                      nReqXOff, nReqYOff,
-                                      nReqXSize, nReqYSize,
-                                      &abyMask[0],
-                                      nOutXSize, nOutYSize,
-                                      GDT_Byte,
-                                      1,
-                                      static_cast<GSpacing>(nOutXSize),
-                                      psExtraArg ) != CE_None )
-            {
-                CPLFree( pafData );
-                return CE_Failure;
-            }
+            CPLFree( pafData );
+            return CE_Failure;
         }
 
         if( m_nColorTableComponent != 0 )
@@ -2819,29 +3148,10 @@ CPLErr VRTComplexSource::RasterIOInternal( int nReqXOff, int nReqYOff,
                 }
                 else if( m_eScalingType == VRT_SCALING_EXPONENTIAL )
                 {
-                    if( !m_bSrcMinMaxDefined )
+                    if( !ComputeSrcMinMaxIfNeeded() )
                     {
-                        int bSuccessMin = FALSE;
-                        int bSuccessMax = FALSE;
-                        double adfMinMax[2] = {
-                            m_poRasterBand->GetMinimum(&bSuccessMin),
-                            m_poRasterBand->GetMaximum(&bSuccessMax) };
-                        if( (bSuccessMin && bSuccessMax) ||
-                            m_poRasterBand->ComputeRasterMinMax( TRUE,
-                                                                 adfMinMax )
-                            == CE_None )
-                        {
-                            m_dfSrcMin = adfMinMax[0];
-                            m_dfSrcMax = adfMinMax[1];
-                            m_bSrcMinMaxDefined = TRUE;
-                        }
-                        else
-                        {
-                            CPLError(
-                                CE_Failure, CPLE_AppDefined,
-                                "Cannot determine source min/max value" );
-                            return CE_Failure;
-                        }
+                        CPLFree( pafData );
+                        return CE_Failure;
                     }
 
                     double dfPowVal =
@@ -35,6 +35,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <algorithm>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -1250,15 +1251,23 @@ CPLErr VRTWarpedDataset::XMLInit( CPLXMLNode *psTree, const char *pszVRTPathIn )
 /* -------------------------------------------------------------------- */
 /*      Find the GDALWarpOptions XML tree.                              */
 /* -------------------------------------------------------------------- */
-    CPLXMLNode * const psOptionsTree =
+    CPLXMLNode * const psOptionsTreeIn =
         CPLGetXMLNode( psTree, "GDALWarpOptions" );
-    if( psOptionsTree == nullptr )
+    if( psOptionsTreeIn == nullptr )
     {
         CPLError( CE_Failure, CPLE_AppDefined,
                   "Count not find required GDALWarpOptions in XML." );
         return CE_Failure;
     }
 
+    // psTree may be a read-only arena tree (see OpenXML()), so SourceDataset
+    // is rewritten in a regular copy of the GDALWarpOptions element.
+    CPLXMLNode* const psOptionsTreeNext = psOptionsTreeIn->psNext;
+    psOptionsTreeIn->psNext = nullptr;
+    CPLXMLTreeCloser oOptionsTree(CPLCloneXMLTree(psOptionsTreeIn));
+    psOptionsTreeIn->psNext = psOptionsTreeNext;
+    CPLXMLNode * const psOptionsTree = oOptionsTree.get();
+
 /* -------------------------------------------------------------------- */
 /*      Adjust the SourceDataset in the warp options to take into       */
 /*      account that it is relative to the VRT if appropriate.          */
@@ -1637,16 +1646,36 @@ void VRTWarpedDataset::GetBlockSize( int *pnBlockXSize, int *pnBlockYSize ) cons
 
 CPLErr VRTWarpedDataset::ProcessBlock( int iBlockX, int iBlockY )
 
+{
+    return ProcessBlocks( iBlockX, iBlockY, 1, 1 );
+}
+
+/************************************************************************/
+/*                           ProcessBlocks()                            */
+/*                                                                      */
+/*      Warp a rectangle of nBlocksX x nBlocksY blocks at once, and     */
+/*      then push each block of each band of the result into the       */
+/*      block cache. Warping neighbouring blocks together avoids        */
+/*      computing the source window and transforming the edges of      */
+/*      each block separately, and gives the warp kernel enough work    */
+/*      to be worth running on several threads.                         */
+/************************************************************************/
+
+CPLErr VRTWarpedDataset::ProcessBlocks( int iBlockX, int iBlockY,
+                                        int nBlocksX, int nBlocksY )
+
 {
     if( m_poWarper == nullptr )
         return CE_Failure;
 
-    int nReqXSize = m_nBlockXSize;
-    if( iBlockX * m_nBlockXSize + nReqXSize > nRasterXSize )
-        nReqXSize = nRasterXSize - iBlockX * m_nBlockXSize;
-    int nReqYSize = m_nBlockYSize;
-    if( iBlockY * m_nBlockYSize + nReqYSize > nRasterYSize )
-        nReqYSize = nRasterYSize - iBlockY * m_nBlockYSize;
+    const int nXOff = iBlockX * m_nBlockXSize;
+    const int nYOff = iBlockY * m_nBlockYSize;
+    const int nReqXSize = static_cast<int>(std::min(
+        static_cast<GIntBig>(nBlocksX) * m_nBlockXSize,
+        static_cast<GIntBig>(nRasterXSize - nXOff)));
+    const int nReqYSize = static_cast<int>(std::min(
+        static_cast<GIntBig>(nBlocksY) * m_nBlockYSize,
+        static_cast<GIntBig>(nRasterYSize - nYOff)));
 
     GByte *pabyDstBuffer = static_cast<GByte *>(
         m_poWarper->CreateDestinationBuffer(nReqXSize, nReqYSize));
@@ -1663,8 +1692,7 @@ CPLErr VRTWarpedDataset::ProcessBlock( int iBlockX, int iBlockY )
     const GDALWarpOptions *psWO = m_poWarper->GetOptions();
     const CPLErr eErr =
         m_poWarper->WarpRegionToBuffer(
-            iBlockX * m_nBlockXSize, iBlockY * m_nBlockYSize,
-            nReqXSize, nReqYSize,
+            nXOff, nYOff, nReqXSize, nReqYSize,
             pabyDstBuffer, psWO->eWorkingDataType );
 
     if( eErr != CE_None )
@@ -1683,20 +1711,38 @@ CPLErr VRTWarpedDataset::ProcessBlock( int iBlockX, int iBlockY )
         if( GetRasterCount() < nDstBand ) { continue; }
 
         GDALRasterBand *poBand = GetRasterBand(nDstBand);
-        GDALRasterBlock *poBlock
-            = poBand->GetLockedBlockRef( iBlockX, iBlockY, TRUE );
-
         const GByte* pabyDstBandBuffer =
             pabyDstBuffer + static_cast<GPtrDiff_t>(i)*nReqXSize*nReqYSize*nWordSize;
 
-        if( poBlock != nullptr )
+        for( int iY = 0; iY < nBlocksY; iY++ )
         {
-            if ( poBlock->GetDataRef() != nullptr )
+            for( int iX = 0; iX < nBlocksX; iX++ )
             {
-                if( nReqXSize == m_nBlockXSize && nReqYSize == m_nBlockYSize )
+                GDALRasterBlock *poBlock = poBand->GetLockedBlockRef(
+                    iBlockX + iX, iBlockY + iY, TRUE );
+                if( poBlock == nullptr )
+                    continue;
+                if( poBlock->GetDataRef() == nullptr )
+                {
+                    poBlock->DropLock();
+                    continue;
+                }
+
+                const int nBlockXOff = iX * m_nBlockXSize;
+                const int nBlockYOff = iY * m_nBlockYSize;
+                const int nCopyXSize =
+                    std::min(m_nBlockXSize, nReqXSize - nBlockXOff);
+                const int nCopyYSize =
+                    std::min(m_nBlockYSize, nReqYSize - nBlockYOff);
+                const GByte* pabySrc = pabyDstBandBuffer +
+                    (static_cast<GPtrDiff_t>(nBlockYOff) * nReqXSize +
+                     nBlockXOff) * nWordSize;
+
+                if( nCopyXSize == m_nBlockXSize &&
+                    nCopyYSize == m_nBlockYSize && nReqXSize == m_nBlockXSize )
                 {
                     GDALCopyWords64(
-                        pabyDstBandBuffer,
+                        pabySrc,
                         psWO->eWorkingDataType, nWordSize,
                         poBlock->GetDataRef(),
                         poBlock->GetDataType(),
@@ -1705,24 +1751,26 @@ CPLErr VRTWarpedDataset::ProcessBlock( int iBlockX, int iBlockY )
                 }
                 else
                 {
-                     GByte* pabyBlock = static_cast<GByte *>(
+                    GByte* pabyBlock = static_cast<GByte *>(
                         poBlock->GetDataRef() );
                     const int nDTSize =
                         GDALGetDataTypeSizeBytes(poBlock->GetDataType());
-                    for(int iY=0;iY<nReqYSize;iY++)
+                    for( int iLine = 0; iLine < nCopyYSize; iLine++ )
                     {
                         GDALCopyWords(
-                            pabyDstBandBuffer + iY * nReqXSize*nWordSize,
+                            pabySrc + static_cast<GPtrDiff_t>(iLine) *
+                                                    nReqXSize * nWordSize,
                             psWO->eWorkingDataType, nWordSize,
-                            pabyBlock + iY * m_nBlockXSize * nDTSize,
+                            pabyBlock + static_cast<GPtrDiff_t>(iLine) *
+                                                    m_nBlockXSize * nDTSize,
                             poBlock->GetDataType(),
                             nDTSize,
-                            nReqXSize );
+                            nCopyXSize );
                     }
                 }
-            }
 
-            poBlock->DropLock();
+                poBlock->DropLock();
+            }
         }
     }
 
@@ -1731,6 +1779,128 @@ CPLErr VRTWarpedDataset::ProcessBlock( int iBlockX, int iBlockY )
     return CE_None;
 }
 
+/************************************************************************/
+/*                           PrefetchBlocks()                           */
+/*                                                                      */
+/*      Warp the blocks of poBand intersecting a window that are not    */
+/*      in the block cache yet, grouping neighbouring blocks into       */
+/*      larger warps.                                                   */
+/*                                                                      */
+/*      This is only done when the warp kernel runs on several          */
+/*      threads, as single block warps are too small to be split        */
+/*      efficiently between them. Note that, because of the            */
+/*      approximate transformer, the values of a pixel may then         */
+/*      slightly differ depending on the warp that produced it.         */
+/************************************************************************/
+
+CPLErr VRTWarpedDataset::PrefetchBlocks( VRTWarpedRasterBand* poBand,
+                                         int nXOff, int nYOff,
+                                         int nXSize, int nYSize )
+{
+    if( m_poWarper == nullptr )
+        return CE_Failure;
+
+    const GDALWarpOptions *psWO = m_poWarper->GetOptions();
+    // Same logic as GWKThreadsCreate()
+    const char* pszWarpThreads =
+        CSLFetchNameValue(psWO->papszWarpOptions, "NUM_THREADS");
+    if( pszWarpThreads == nullptr )
+        pszWarpThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    if( !EQUAL(pszWarpThreads, "ALL_CPUS") && atoi(pszWarpThreads) <= 1 )
+        return CE_None;
+
+    const int nBlockX0 = nXOff / m_nBlockXSize;
+    const int nBlockY0 = nYOff / m_nBlockYSize;
+    const int nBlockX1 = (nXOff + nXSize - 1) / m_nBlockXSize;
+    const int nBlockY1 = (nYOff + nYSize - 1) / m_nBlockYSize;
+    if( nBlockX0 == nBlockX1 && nBlockY0 == nBlockY1 )
+        return CE_None;
+
+/* -------------------------------------------------------------------- */
+/*      Bound the number of blocks warped at once, so that the          */
+/*      destination buffer does not exceed the warp memory limit.       */
+/* -------------------------------------------------------------------- */
+    const double dfBlockBytes =
+        static_cast<double>(m_nBlockXSize) * m_nBlockYSize *
+        std::max(1, psWO->nBandCount) *
+        GDALGetDataTypeSizeBytes(psWO->eWorkingDataType);
+    const int nMaxBlocks = static_cast<int>(std::max(1.0, std::min(
+        1e6, psWO->dfWarpMemoryLimit / 2 / dfBlockBytes)));
+
+    const auto WarpRun = [this, nMaxBlocks](int iX, int iY,
+                                            int nBlocksX, int nBlocksY)
+    {
+        const int nRowsPerWarp =
+            std::max(1, std::min(nBlocksY, nMaxBlocks / nBlocksX));
+        const int nColsPerWarp = std::min(nBlocksX, nMaxBlocks);
+        for( int iRow = 0; iRow < nBlocksY; iRow += nRowsPerWarp )
+        {
+            for( int iCol = 0; iCol < nBlocksX; iCol += nColsPerWarp )
+            {
+                const CPLErr eErr = ProcessBlocks(
+                    iX + iCol, iY + iRow,
+                    std::min(nColsPerWarp, nBlocksX - iCol),
+                    std::min(nRowsPerWarp, nBlocksY - iRow));
+                if( eErr != CE_None )
+                    return eErr;
+            }
+        }
+        return CE_None;
+    };
+
+/* -------------------------------------------------------------------- */
+/*      Find the runs of consecutive blocks that are not cached.        */
+/* -------------------------------------------------------------------- */
+    const int nBlocksX = nBlockX1 - nBlockX0 + 1;
+    std::vector<bool> abCached;
+    bool bAnyCached = false;
+    for( int iY = nBlockY0; iY <= nBlockY1; iY++ )
+    {
+        for( int iX = nBlockX0; iX <= nBlockX1; iX++ )
+        {
+            GDALRasterBlock* poBlock = poBand->TryGetLockedBlockRef(iX, iY);
+            abCached.push_back(poBlock != nullptr);
+            if( poBlock )
+            {
+                poBlock->DropLock();
+                bAnyCached = true;
+            }
+        }
+    }
+
+    if( !bAnyCached )
+    {
+        return WarpRun(nBlockX0, nBlockY0,
+                       nBlocksX, nBlockY1 - nBlockY0 + 1);
+    }
+
+    for( int iY = nBlockY0; iY <= nBlockY1; iY++ )
+    {
+        const size_t nRowIdx = static_cast<size_t>(iY - nBlockY0) * nBlocksX;
+        int iX = 0;
+        while( iX < nBlocksX )
+        {
+            if( abCached[nRowIdx + iX] )
+            {
+                iX++;
+                continue;
+            }
+            int iXEnd = iX + 1;
+            while( iXEnd < nBlocksX && !abCached[nRowIdx + iXEnd] )
+                iXEnd++;
+            if( iXEnd - iX > 1 )
+            {
+                const CPLErr eErr = WarpRun(nBlockX0 + iX, iY, iXEnd - iX, 1);
+                if( eErr != CE_None )
+                    return eErr;
+            }
+            iX = iXEnd;
+        }
+    }
+
+    return CE_None;
+}
+
 /************************************************************************/
 /*                              AddBand()                               */
 /************************************************************************/
@@ -1809,6 +1979,38 @@ CPLErr VRTWarpedRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
     return eErr;
 }
 
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr VRTWarpedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
+                                       int nXOff, int nYOff,
+                                       int nXSize, int nYSize,
+                                       void * pData,
+                                       int nBufXSize, int nBufYSize,
+                                       GDALDataType eBufType,
+                                       GSpacing nPixelSpace,
+                                       GSpacing nLineSpace,
+                                       GDALRasterIOExtraArg* psExtraArg )
+{
+    // Warp the blocks intersecting the request in as few warps as possible,
+    // before the generic implementation reads them from the block cache.
+    // Subsampled requests may be served from overviews, so are left alone.
+    if( eRWFlag == GF_Read && nBufXSize == nXSize && nBufYSize == nYSize )
+    {
+        VRTWarpedDataset *poWDS = static_cast<VRTWarpedDataset *>( poDS );
+        if( poWDS->PrefetchBlocks( this, nXOff, nYOff,
+                                   nXSize, nYSize ) != CE_None )
+        {
+            return CE_Failure;
+        }
+    }
+
+    return VRTRasterBand::IRasterIO( eRWFlag, nXOff, nYOff, nXSize, nYSize,
+                                     pData, nBufXSize, nBufYSize, eBufType,
+                                     nPixelSpace, nLineSpace, psExtraArg );
+}
+
 /************************************************************************/
 /*                            IWriteBlock()                             */
 /************************************************************************/
@@ -31,6 +31,9 @@
 
 #include "wmsdriver.h"
 #include <algorithm>
+#include <list>
+#include <map>
+#include <mutex>
 
 #if !CURL_AT_LEAST_VERSION(7,28,0)
 // Needed for curl_multi_wait()
@@ -141,15 +144,57 @@ WMSHTTPRequest::~WMSHTTPRequest() {
         CPLFree(pabyData);
 }
 
+// Number of simultaneous connections allowed to each host, adapted to the
+// responses of the servers: halved when a server answers with 429 (Too Many
+// Requests) or 503 (Service Unavailable) or a request times out, and
+// increased by one, up to MAXCONN, after each successful request.
+static std::mutex goMutexHostConnections;
+static std::map<CPLString, int> goMapHostConnections;
+
+static CPLString GetURLHost(const CPLString &osURL) {
+    const size_t nSchemeEnd = osURL.find("://");
+    if (nSchemeEnd == std::string::npos)
+        return CPLString();
+    const size_t nHostStart = nSchemeEnd + 3;
+    const size_t nHostEnd = osURL.find_first_of("/?#", nHostStart);
+    return osURL.substr(nHostStart, nHostEnd == std::string::npos ?
+                            std::string::npos : nHostEnd - nHostStart);
+}
+
+static int GetHostMaxConnections(const CPLString &osHost, int max_conn) {
+    std::lock_guard<std::mutex> oLock(goMutexHostConnections);
+    const auto oIter = goMapHostConnections.find(osHost);
+    if (oIter == goMapHostConnections.end())
+        return max_conn;
+    return std::min(oIter->second, max_conn);
+}
+
+static void UpdateHostMaxConnections(const CPLString &osHost, int max_conn,
+                                     bool bThrottled) {
+    std::lock_guard<std::mutex> oLock(goMutexHostConnections);
+    auto oIter = goMapHostConnections.find(osHost);
+    int nConnections = oIter == goMapHostConnections.end() ?
+                           max_conn : std::min(oIter->second, max_conn);
+    if (bThrottled) {
+        nConnections = std::max(1, nConnections / 2);
+        CPLDebug("HTTP", "Reducing to %d connections to %s",
+                 nConnections, osHost.c_str());
+    }
+    else if (nConnections < max_conn) {
+        nConnections++;
+    }
+    goMapHostConnections[osHost] = nConnections;
+}
+
 //
 // Like CPLHTTPFetch, but multiple requests in parallel
-// By default it uses 5 connections
+// By default it uses 5 connections to each host
 //
 CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
     CPLErr ret = CE_None;
     CURLM *curl_multi = nullptr;
     int max_conn;
-    int i, conn_i;
+    int i;
 
     CPLAssert(nRequestCount >= 0);
     if (nRequestCount == 0)
@@ -190,14 +235,32 @@ CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
         CPLError(CE_Fatal, CPLE_AppDefined, "CPLHTTPFetchMulti(): Unable to create CURL multi-handle.");
     }
 
-    // add at most max_conn requests
-    int torun = std::min(nRequestCount, max_conn);
-    for (conn_i = 0; conn_i < torun; ++conn_i) {
-        WMSHTTPRequest *const psRequest = &pasRequest[conn_i];
-        CPLDebug("HTTP", "Requesting [%d/%d] %s", conn_i + 1, nRequestCount,
-            pasRequest[conn_i].URL.c_str());
-        curl_multi_add_handle(curl_multi, psRequest->m_curl_handle);
+    // Requests not started yet, in order, and running requests per host
+    std::vector<CPLString> aosHosts(nRequestCount);
+    std::list<int> anPending;
+    for (i = 0; i < nRequestCount; ++i) {
+        aosHosts[i] = GetURLHost(pasRequest[i].URL);
+        anPending.push_back(i);
     }
+    std::map<CPLString, int> oMapRunning;
+
+    // add at most max_conn requests for each host
+    const auto StartRequests = [&]() {
+        for (auto oIter = anPending.begin(); oIter != anPending.end(); ) {
+            const int iReq = *oIter;
+            int &nRunning = oMapRunning[aosHosts[iReq]];
+            if (nRunning >= GetHostMaxConnections(aosHosts[iReq], max_conn)) {
+                ++oIter;
+                continue;
+            }
+            nRunning++;
+            CPLDebug("HTTP", "Requesting [%d/%d] %s", iReq + 1, nRequestCount,
+                pasRequest[iReq].URL.c_str());
+            curl_multi_add_handle(curl_multi, pasRequest[iReq].m_curl_handle);
+            oIter = anPending.erase(oIter);
+        }
+    };
+    StartRequests();
 
     void* old_handler = CPLHTTPIgnoreSigPipe();
     int still_running;
@@ -214,13 +277,29 @@ CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
             if (m && (m->msg == CURLMSG_DONE)) {
                 ProcessCurlErrors(m, pasRequest, nRequestCount);
 
+                for (i = 0; i < nRequestCount; ++i) {
+                    if (pasRequest[i].m_curl_handle != m->easy_handle)
+                        continue;
+                    long response_code = 0;
+                    curl_easy_getinfo(m->easy_handle, CURLINFO_RESPONSE_CODE,
+                                      &response_code);
+                    const bool bThrottled =
+                        response_code == 429 || response_code == 503 ||
+                        m->data.result == CURLE_OPERATION_TIMEDOUT;
+                    if (!aosHosts[i].empty() &&
+                        (bThrottled || response_code == 200 ||
+                         response_code == 206))
+                    {
+                        UpdateHostMaxConnections(aosHosts[i], max_conn,
+                                                 bThrottled);
+                    }
+                    oMapRunning[aosHosts[i]]--;
+                    break;
+                }
+
                 curl_multi_remove_handle(curl_multi, m->easy_handle);
-                if (conn_i < nRequestCount) {
-                    auto psRequest = &pasRequest[conn_i];
-                    CPLDebug("HTTP", "Requesting [%d/%d] %s", conn_i + 1,
-                        nRequestCount, pasRequest[conn_i].URL.c_str());
-                    curl_multi_add_handle(curl_multi, psRequest->m_curl_handle);
-                    ++conn_i;
+                if (!anPending.empty()) {
+                    StartRequests();
                     still_running = 1; // Still have request pending
                 }
             }
@@ -230,7 +309,7 @@ CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
             int numfds;
             curl_multi_wait(curl_multi, nullptr, 0, 100, &numfds);
         }
-    } while (still_running || conn_i != nRequestCount);
+    } while (still_running || !anPending.empty());
 
     // process any message still in queue
     CURLMsg* msg;
@@ -246,11 +325,10 @@ CPLErr WMSHTTPFetchMulti(WMSHTTPRequest *pasRequest, int nRequestCount) {
 
     CPLHTTPRestoreSigPipeHandler(old_handler);
 
-    if (conn_i != nRequestCount) { // something gone really really wrong
+    if (!anPending.empty()) { // something gone really really wrong
         // oddly built libcurl or perhaps absence of network interface
         CPLError(CE_Failure, CPLE_AppDefined,
-                 "WMSHTTPFetchMulti(): conn_i != nRequestCount, this should never happen ...");
-        nRequestCount = conn_i;
+                 "WMSHTTPFetchMulti(): some requests were not started, this should never happen ...");
         ret = CE_Failure;
     }
 
@@ -32,6 +32,10 @@
 #include "cpl_md5.h"
 #include "wmsdriver.h"
 
+#ifdef HAVE_SQLITE
+#include "sqlite3.h"
+#endif
+
 CPL_CVSID("$Id$")
 
 
@@ -215,6 +219,311 @@ private:
     int m_nCleanThreadRunTimeout;
 };
 
+#ifdef HAVE_SQLITE
+//------------------------------------------------------------------------------
+// GDALWMSSQLiteCache
+//
+// Stores all the tiles of a cache in a single SQLite database, which avoids
+// creating one file per tile. Tiles are evicted in least recently used order
+// when the cache exceeds its maximum size, and the freed pages are returned
+// to the file system with an incremental vacuum.
+//------------------------------------------------------------------------------
+class GDALWMSSQLiteCache : public GDALWMSCacheImpl
+{
+public:
+    GDALWMSSQLiteCache(const CPLString& soPath, CPLXMLNode *pConfig) :
+        GDALWMSCacheImpl(soPath, pConfig),
+        m_hDB(nullptr),
+        m_nExpires(604800),   // 7 days
+        m_nMaxSize(67108864),  // 64 Mb
+        m_nCleanThreadRunTimeout(120)  // 3 min
+    {
+        const char *pszCacheExpires = CPLGetXMLValue( pConfig, "Expires", nullptr );
+        if( pszCacheExpires != nullptr )
+        {
+            m_nExpires = atoi( pszCacheExpires );
+            CPLDebug("WMS", "Cache expires in %d sec", m_nExpires);
+        }
+
+        const char *pszCacheMaxSize = CPLGetXMLValue( pConfig, "MaxSize", nullptr );
+        if( pszCacheMaxSize != nullptr )
+            m_nMaxSize = CPLAtoGIntBig( pszCacheMaxSize );
+
+        const char *pszCleanThreadRunTimeout = CPLGetXMLValue( pConfig, "CleanTimeout", nullptr );
+        if( pszCleanThreadRunTimeout != nullptr )
+        {
+            m_nCleanThreadRunTimeout = atoi( pszCleanThreadRunTimeout );
+            CPLDebug("WMS", "Clean Thread Run Timeout is %d sec", m_nCleanThreadRunTimeout);
+        }
+
+        VSIMkdirRecursive( m_soPath, 0744 );
+        const CPLString osDBPath( CPLFormFilename( m_soPath, "cache.sqlite",
+                                                   nullptr ) );
+        // The connection is shared by the reading threads and the clean
+        // thread, so let SQLite serialize the accesses.
+        if( sqlite3_open_v2( osDBPath, &m_hDB,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE |
+                             SQLITE_OPEN_FULLMUTEX, nullptr ) != SQLITE_OK )
+        {
+            CPLError( CE_Warning, CPLE_OpenFailed,
+                      "Cannot open WMS cache database %s: %s",
+                      osDBPath.c_str(),
+                      m_hDB ? sqlite3_errmsg(m_hDB) : "out of memory" );
+            sqlite3_close( m_hDB );
+            m_hDB = nullptr;
+            return;
+        }
+        // Several datasets, possibly in different processes, can share
+        // the same cache.
+        sqlite3_busy_timeout( m_hDB, 5000 );
+        // auto_vacuum must be set before the first table is created
+        Exec( "PRAGMA auto_vacuum = INCREMENTAL" );
+        Exec( "PRAGMA journal_mode = WAL" );
+        Exec( "PRAGMA synchronous = NORMAL" );
+        if( !Exec( "CREATE TABLE IF NOT EXISTS tiles ("
+                   "key TEXT PRIMARY KEY, data BLOB NOT NULL, "
+                   "size INTEGER NOT NULL, mtime INTEGER NOT NULL, "
+                   "atime INTEGER NOT NULL)" ) ||
+            !Exec( "CREATE INDEX IF NOT EXISTS tiles_atime ON tiles(atime)" ) )
+        {
+            sqlite3_close( m_hDB );
+            m_hDB = nullptr;
+        }
+    }
+
+    virtual ~GDALWMSSQLiteCache()
+    {
+        if( m_hDB != nullptr )
+            sqlite3_close( m_hDB );
+    }
+
+    virtual int GetCleanThreadRunTimeout() override
+    {
+        return m_nCleanThreadRunTimeout;
+    }
+
+    virtual CPLErr Insert(const char *pszKey, const CPLString &osFileName) override
+    {
+        // Warns if it fails to write, but returns success
+        if( m_hDB == nullptr )
+            return CE_None;
+        GByte *pabyData = nullptr;
+        vsi_l_offset nSize = 0;
+        if( !VSIIngestFile( nullptr, osFileName, &pabyData, &nSize,
+                            INT_MAX - 1 ) )
+        {
+            CPLError( CE_Warning, CPLE_FileIO, "Error writing to WMS cache %s",
+                      m_soPath.c_str() );
+            return CE_None;
+        }
+
+        const GIntBig nNow = static_cast<GIntBig>( time( nullptr ) );
+        sqlite3_stmt *hStmt = nullptr;
+        bool bOK = sqlite3_prepare_v2( m_hDB,
+            "INSERT OR REPLACE INTO tiles(key, data, size, mtime, atime) "
+            "VALUES (?, ?, ?, ?, ?)", -1, &hStmt, nullptr ) == SQLITE_OK;
+        if( bOK )
+        {
+            const CPLString osHash( CPLMD5String( pszKey ) );
+            sqlite3_bind_text( hStmt, 1, osHash.c_str(), -1, SQLITE_TRANSIENT );
+            sqlite3_bind_blob( hStmt, 2, pabyData, static_cast<int>(nSize),
+                               SQLITE_STATIC );
+            sqlite3_bind_int64( hStmt, 3, static_cast<sqlite3_int64>(nSize) );
+            sqlite3_bind_int64( hStmt, 4, nNow );
+            sqlite3_bind_int64( hStmt, 5, nNow );
+            bOK = sqlite3_step( hStmt ) == SQLITE_DONE;
+        }
+        sqlite3_finalize( hStmt );
+        VSIFree( pabyData );
+        if( !bOK )
+        {
+            CPLError( CE_Warning, CPLE_FileIO,
+                      "Error writing to WMS cache %s: %s",
+                      m_soPath.c_str(), sqlite3_errmsg( m_hDB ) );
+        }
+        return CE_None;
+    }
+
+    virtual enum GDALWMSCacheItemStatus GetItemStatus(const char *pszKey) const override
+    {
+        if( m_hDB == nullptr )
+            return CACHE_ITEM_NOT_FOUND;
+        sqlite3_stmt *hStmt = nullptr;
+        if( sqlite3_prepare_v2( m_hDB,
+                "SELECT mtime FROM tiles WHERE key = ?", -1, &hStmt,
+                nullptr ) != SQLITE_OK )
+        {
+            sqlite3_finalize( hStmt );
+            return CACHE_ITEM_NOT_FOUND;
+        }
+        const CPLString osHash( CPLMD5String( pszKey ) );
+        sqlite3_bind_text( hStmt, 1, osHash.c_str(), -1, SQLITE_TRANSIENT );
+        enum GDALWMSCacheItemStatus eStatus = CACHE_ITEM_NOT_FOUND;
+        if( sqlite3_step( hStmt ) == SQLITE_ROW )
+        {
+            const GIntBig nSeconds = static_cast<GIntBig>( time( nullptr ) ) -
+                                     sqlite3_column_int64( hStmt, 0 );
+            eStatus = nSeconds < m_nExpires ? CACHE_ITEM_OK : CACHE_ITEM_EXPIRED;
+        }
+        sqlite3_finalize( hStmt );
+        return eStatus;
+    }
+
+    virtual GDALDataset* GetDataset(const char *pszKey, char **papszOpenOptions) const override
+    {
+        if( m_hDB == nullptr )
+            return nullptr;
+        sqlite3_stmt *hStmt = nullptr;
+        if( sqlite3_prepare_v2( m_hDB,
+                "SELECT data, atime FROM tiles WHERE key = ?", -1, &hStmt,
+                nullptr ) != SQLITE_OK )
+        {
+            sqlite3_finalize( hStmt );
+            return nullptr;
+        }
+        const CPLString osHash( CPLMD5String( pszKey ) );
+        sqlite3_bind_text( hStmt, 1, osHash.c_str(), -1, SQLITE_TRANSIENT );
+        GByte *pabyData = nullptr;
+        int nSize = 0;
+        GIntBig nAccessTime = 0;
+        if( sqlite3_step( hStmt ) == SQLITE_ROW )
+        {
+            nSize = sqlite3_column_bytes( hStmt, 0 );
+            pabyData = static_cast<GByte *>( VSI_MALLOC_VERBOSE( nSize + 1 ) );
+            if( pabyData != nullptr && nSize > 0 )
+                memcpy( pabyData, sqlite3_column_blob( hStmt, 0 ), nSize );
+            nAccessTime = sqlite3_column_int64( hStmt, 1 );
+        }
+        sqlite3_finalize( hStmt );
+        if( pabyData == nullptr )
+            return nullptr;
+
+        // Record the access for the LRU eviction, but only once a minute
+        // so that reading a tile does not always cost a write.
+        const GIntBig nNow = static_cast<GIntBig>( time( nullptr ) );
+        if( nNow - nAccessTime > 60 )
+        {
+            if( sqlite3_prepare_v2( m_hDB,
+                    "UPDATE tiles SET atime = ? WHERE key = ?", -1, &hStmt,
+                    nullptr ) == SQLITE_OK )
+            {
+                sqlite3_bind_int64( hStmt, 1, nNow );
+                sqlite3_bind_text( hStmt, 2, osHash.c_str(), -1,
+                                   SQLITE_TRANSIENT );
+                sqlite3_step( hStmt );
+            }
+            sqlite3_finalize( hStmt );
+        }
+
+        // The memory file is kept alive by the opened dataset, so it can be
+        // unlinked right away.
+        const CPLString osMemFile( CPLSPrintf( "/vsimem/wms_sqlite_cache/%p/%s",
+                                               this, osHash.c_str() ) );
+        VSILFILE *fp = VSIFileFromMemBuffer( osMemFile, pabyData, nSize, TRUE );
+        if( fp == nullptr )
+        {
+            VSIFree( pabyData );
+            return nullptr;
+        }
+        VSIFCloseL( fp );
+        GDALDataset *poDS = reinterpret_cast<GDALDataset*>(
+                    GDALOpenEx( osMemFile, GDAL_OF_RASTER |
+                               GDAL_OF_READONLY | GDAL_OF_VERBOSE_ERROR, nullptr,
+                               papszOpenOptions, nullptr ) );
+        VSIUnlink( osMemFile );
+        return poDS;
+    }
+
+    virtual void Clean() override
+    {
+        if( m_hDB == nullptr )
+            return;
+
+        const GIntBig nNow = static_cast<GIntBig>( time( nullptr ) );
+        sqlite3_stmt *hStmt = nullptr;
+        if( sqlite3_prepare_v2( m_hDB, "DELETE FROM tiles WHERE mtime < ?",
+                                -1, &hStmt, nullptr ) == SQLITE_OK )
+        {
+            sqlite3_bind_int64( hStmt, 1, nNow - m_nExpires );
+            sqlite3_step( hStmt );
+            CPLDebug( "WMS", "Delete %d expired items from cache",
+                      sqlite3_changes( m_hDB ) );
+        }
+        sqlite3_finalize( hStmt );
+
+        // Evict the least recently used tiles until the cache fits in its
+        // maximum size.
+        GIntBig nSize = 0;
+        if( sqlite3_prepare_v2( m_hDB, "SELECT SUM(size) FROM tiles",
+                                -1, &hStmt, nullptr ) == SQLITE_OK &&
+            sqlite3_step( hStmt ) == SQLITE_ROW )
+        {
+            nSize = sqlite3_column_int64( hStmt, 0 );
+        }
+        sqlite3_finalize( hStmt );
+        hStmt = nullptr;
+
+        if( nSize > m_nMaxSize &&
+            sqlite3_prepare_v2( m_hDB,
+                "SELECT key, size FROM tiles ORDER BY atime", -1, &hStmt,
+                nullptr ) == SQLITE_OK )
+        {
+            std::vector<CPLString> aosKeys;
+            while( nSize > m_nMaxSize && sqlite3_step( hStmt ) == SQLITE_ROW )
+            {
+                aosKeys.push_back( reinterpret_cast<const char *>(
+                                        sqlite3_column_text( hStmt, 0 ) ) );
+                nSize -= sqlite3_column_int64( hStmt, 1 );
+            }
+            sqlite3_finalize( hStmt );
+            hStmt = nullptr;
+
+            CPLDebug( "WMS", "Delete %u least recently used items from cache",
+                      static_cast<unsigned int>(aosKeys.size()) );
+            Exec( "BEGIN" );
+            if( sqlite3_prepare_v2( m_hDB, "DELETE FROM tiles WHERE key = ?",
+                                    -1, &hStmt, nullptr ) == SQLITE_OK )
+            {
+                for( const auto &osKey : aosKeys )
+                {
+                    sqlite3_bind_text( hStmt, 1, osKey.c_str(), -1,
+                                       SQLITE_TRANSIENT );
+                    sqlite3_step( hStmt );
+                    sqlite3_reset( hStmt );
+                }
+            }
+            Exec( "COMMIT" );
+        }
+        sqlite3_finalize( hStmt );
+
+        // Give the pages of the deleted tiles back to the file system
+        Exec( "PRAGMA incremental_vacuum" );
+    }
+
+private:
+    bool Exec(const char *pszSQL) const
+    {
+        char *pszErrMsg = nullptr;
+        if( sqlite3_exec( m_hDB, pszSQL, nullptr, nullptr,
+                          &pszErrMsg ) != SQLITE_OK )
+        {
+            CPLError( CE_Warning, CPLE_AppDefined,
+                      "WMS cache %s: %s failed: %s", m_soPath.c_str(), pszSQL,
+                      pszErrMsg ? pszErrMsg : "" );
+            sqlite3_free( pszErrMsg );
+            return false;
+        }
+        return true;
+    }
+
+private:
+    sqlite3 *m_hDB;
+    int m_nExpires;
+    GIntBig m_nMaxSize;
+    int m_nCleanThreadRunTimeout;
+};
+#endif // HAVE_SQLITE
+
 //------------------------------------------------------------------------------
 // GDALWMSCache
 //------------------------------------------------------------------------------
@@ -255,12 +564,26 @@ CPLErr GDALWMSCache::Initialize(const char *pszUrl, CPLXMLNode *pConfig) {
         m_osCachePath = CPLFormFilename( m_osCachePath, CPLMD5String( pszUrl ), nullptr );
     }
 
-    // TODO: Add sqlite db cache type
     const char *pszType = CPLGetXMLValue( pConfig, "Type", "file" );
     if( EQUAL(pszType, "file") )
     {
         m_poCache = new GDALWMSFileCache(m_osCachePath, pConfig);
     }
+    else if( EQUAL(pszType, "sqlite") )
+    {
+#ifdef HAVE_SQLITE
+        m_poCache = new GDALWMSSQLiteCache(m_osCachePath, pConfig);
+#else
+        CPLError( CE_Warning, CPLE_NotSupported,
+                  "WMS cache of type sqlite is not available: "
+                  "GDAL was built without SQLite support" );
+#endif
+    }
+    else
+    {
+        CPLError( CE_Warning, CPLE_NotSupported,
+                  "Unsupported WMS cache type: %s", pszType );
+    }
 
     return CE_None;
 }
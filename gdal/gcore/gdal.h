@@ -659,6 +659,8 @@ GDALDatasetH CPL_DLL CPL_STDCALL GDALOpenEx( const char* pszFilename,
 
 int          CPL_DLL CPL_STDCALL GDALDumpOpenDatasets( FILE * );
 
+void CPL_DLL GDALClearSiblingFilesCache( const char* pszDirname );
+
 GDALDriverH CPL_DLL CPL_STDCALL GDALGetDriverByName( const char * );
 int CPL_DLL         CPL_STDCALL GDALGetDriverCount( void );
 GDALDriverH CPL_DLL CPL_STDCALL GDALGetDriver( int );
@@ -795,6 +797,44 @@ CPLErr CPL_DLL CPL_STDCALL GDALDatasetAdviseRead( GDALDatasetH hDS,
     int nBXSize, int nBYSize, GDALDataType eBDataType,
     int nBandCount, int *panBandCount, CSLConstList papszOptions );
 
+/** One window of a GDALDatasetRasterIOBatch() request.
+ *
+ * @see GDALDataset::RasterIOBatch()
+ * @since GDAL 3.4
+ */
+typedef struct
+{
+    /*! Pixel offset of the top left corner of the window. */
+    int nXOff;
+    /*! Line offset of the top left corner of the window. */
+    int nYOff;
+    /*! Width of the window, in pixels. */
+    int nXSize;
+    /*! Height of the window, in lines. */
+    int nYSize;
+    /*! Buffer into which the window is read. */
+    void *pData;
+    /*! Width of the buffer, in pixels. */
+    int nBufXSize;
+    /*! Height of the buffer, in lines. */
+    int nBufYSize;
+    /*! Byte offset between pixels in pData, or 0 for the default. */
+    GSpacing nPixelSpace;
+    /*! Byte offset between lines in pData, or 0 for the default. */
+    GSpacing nLineSpace;
+    /*! Byte offset between bands in pData, or 0 for the default. */
+    GSpacing nBandSpace;
+} GDALRasterIOWindow;
+
+CPLErr CPL_DLL GDALDatasetRasterIOBatch( GDALDatasetH hDS,
+                                         int nWindowCount,
+                                         const GDALRasterIOWindow* pasWindows,
+                                         GDALDataType eBufType,
+                                         int nBandCount,
+                                         const int *panBandMap,
+                                         CSLConstList papszOptions )
+                                            CPL_WARN_UNUSED_RESULT;
+
 const char CPL_DLL * CPL_STDCALL GDALGetProjectionRef( GDALDatasetH );
 OGRSpatialReferenceH CPL_DLL GDALGetSpatialRef( GDALDatasetH );
 CPLErr CPL_DLL CPL_STDCALL GDALSetProjection( GDALDatasetH, const char * );
@@ -1036,6 +1076,13 @@ CPLErr CPL_DLL CPL_STDCALL GDALSetDefaultHistogram( GDALRasterBandH hBand,
 CPLErr CPL_DLL CPL_STDCALL GDALSetDefaultHistogramEx( GDALRasterBandH hBand,
                                        double dfMin, double dfMax,
                                        int nBuckets, GUIntBig *panHistogram );
+CPLErr CPL_DLL GDALComputeRasterPercentiles( GDALRasterBandH hBand,
+                                             int nPercentiles,
+                                             const double *padfPercentiles,
+                                             double *padfValues,
+                                             int bForce,
+                                             GDALProgressFunc pfnProgress,
+                                             void *pProgressData );
 int CPL_DLL CPL_STDCALL
 GDALGetRandomRasterSample( GDALRasterBandH, int, float * );
 GDALRasterBandH CPL_DLL CPL_STDCALL
@@ -1415,6 +1462,66 @@ GIntBig CPL_DLL CPL_STDCALL GDALGetCacheUsed64(void);
 
 int CPL_DLL CPL_STDCALL GDALFlushCacheBlock(void);
 
+int CPL_DLL CPL_STDCALL GDALSetCachePartitionMax( const char* pszName,
+                                                  GIntBig nMaxBytes );
+GIntBig CPL_DLL CPL_STDCALL GDALGetCachePartitionMax( const char* pszName );
+int CPL_DLL CPL_STDCALL GDALGetCachePartitionStatistics( const char* pszName,
+                                                         GIntBig* pnUsed,
+                                                         GIntBig* pnHits,
+                                                         GIntBig* pnMisses,
+                                                         GIntBig* pnEvictions );
+CPLErr CPL_DLL CPL_STDCALL GDALDatasetSetCachePartition( GDALDatasetH hDS,
+                                                         const char* pszName );
+
+/** Cumulative statistics of the GDALRasterBlock cache.
+ *
+ * @see GDALGetCacheStatistics(), GDALGetRasterBandCacheStatistics()
+ * @since GDAL 3.4
+ */
+typedef struct
+{
+    /*! Number of times a requested block was found in the cache. */
+    GIntBig nHits;
+    /*! Number of times a requested block had to be loaded in the cache. */
+    GIntBig nMisses;
+    /*! Number of blocks removed from the cache to make room for others. */
+    GIntBig nEvictions;
+    /*! Number of dirty blocks written back to their band. */
+    GIntBig nDirtyFlushes;
+    /*! Number of bytes currently used by cached blocks. */
+    GIntBig nBytesResident;
+    /*! Time, in seconds, spent waiting for the locks of the LRU lists.
+     * Only collected when the GDAL_RB_LOCK_WAIT_STATS configuration option
+     * is set to YES, and only available globally. */
+    double  dfLockWaitTime;
+} GDALCacheStatistics;
+
+void CPL_DLL CPL_STDCALL GDALGetCacheStatistics( GDALCacheStatistics* psStats );
+CPLErr CPL_DLL CPL_STDCALL GDALGetRasterBandCacheStatistics(
+                                                GDALRasterBandH hBand,
+                                                GDALCacheStatistics* psStats );
+
+/* ==================================================================== */
+/*      Performance counters                                            */
+/* ==================================================================== */
+
+char CPL_DLL **GDALGetPerfCounters( void ) CPL_WARN_UNUSED_RESULT;
+void CPL_DLL GDALResetPerfCounters( void );
+
+void CPL_DLL GDALDatasetEnableRasterIOLatencyStats( GDALDatasetH hDS );
+char CPL_DLL **GDALDatasetGetRasterIOLatencyStats( GDALDatasetH hDS )
+                                                    CPL_WARN_UNUSED_RESULT;
+void CPL_DLL GDALDatasetResetRasterIOLatencyStats( GDALDatasetH hDS );
+
+/* ==================================================================== */
+/*      Memory accounting                                               */
+/* ==================================================================== */
+
+GIntBig CPL_DLL GDALDatasetGetMemoryUsage( GDALDatasetH hDS,
+                                           GIntBig* pnBlockCacheBytes,
+                                           GIntBig* pnDriverBytes );
+char CPL_DLL **GDALGetMemoryUsageSummary( void ) CPL_WARN_UNUSED_RESULT;
+
 /* ==================================================================== */
 /*      GDAL virtual memory                                             */
 /* ==================================================================== */
@@ -1642,6 +1749,10 @@ GDALMDArrayH CPL_DLL GDALMDArrayTranspose(GDALMDArrayH hArray,
                                             const int *panMapNewAxisToOldAxis);
 GDALMDArrayH CPL_DLL GDALMDArrayGetUnscaled(GDALMDArrayH hArray);
 GDALMDArrayH CPL_DLL GDALMDArrayGetMask(GDALMDArrayH hArray, CSLConstList papszOptions);
+GDALMDArrayH CPL_DLL GDALMDArrayGetReduction(GDALMDArrayH hArray,
+                                             const char* pszOperation,
+                                             size_t iDim,
+                                             CSLConstList papszOptions);
 GDALDatasetH CPL_DLL GDALMDArrayAsClassicDataset(GDALMDArrayH hArray,
                                                  size_t iXDim, size_t iYDim);
 CPLErr CPL_DLL GDALMDArrayGetStatistics(
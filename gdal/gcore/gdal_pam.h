@@ -76,6 +76,7 @@ class GDALPamRasterBand;
 #define GPF_DISABLED            0x04  // do not try any PAM stuff.
 #define GPF_AUXMODE             0x08  // store info in .aux (HFA) file.
 #define GPF_NOSAVE              0x10  // do not try to save pam info.
+#define GPF_LOAD_DEFERRED       0x20  // pam info will be read when needed.
 
 /* ==================================================================== */
 /*      GDALDatasetPamInfo                                              */
@@ -105,6 +106,8 @@ public:
 
     int         bHasMetadata = false;
 
+    bool        bInDeferredLoad = false;
+
     struct Statistics
     {
         bool bApproxStats;
@@ -158,6 +161,7 @@ class CPL_DLL GDALPamDataset : public GDALDataset
 
     void   PamInitialize();
     void   PamClear();
+    void   LoadDeferredPam();
 
     void   SetPhysicalFilename( const char * );
     const char *GetPhysicalFilename();
@@ -191,6 +195,7 @@ class CPL_DLL GDALPamDataset : public GDALDataset
     char **GetMetadata( const char * pszDomain = "" ) override;
     const char *GetMetadataItem( const char * pszName,
                                  const char * pszDomain = "" ) override;
+    char **GetMetadataDomainList() override;
 
     char **GetFileList(void) override;
 
@@ -219,7 +224,7 @@ class CPL_DLL GDALPamDataset : public GDALDataset
 
     // "semi private" methods.
     void   MarkPamDirty() { nPamFlags |= GPF_DIRTY; }
-    GDALDatasetPamInfo *GetPamInfo() { return psPam; }
+    GDALDatasetPamInfo *GetPamInfo() { LoadDeferredPam(); return psPam; }
     int    GetPamFlags() { return nPamFlags; }
     void   SetPamFlags(int nValue ) { nPamFlags = nValue; }
 //! @endcond
@@ -285,6 +290,7 @@ class CPL_DLL GDALPamRasterBand : public GDALRasterBand
 
     void   PamInitialize();
     void   PamClear();
+    void   LoadDeferredPam();
 
     GDALRasterBandPamInfo *psPam = nullptr;
 //! @endcond
@@ -337,6 +343,10 @@ class CPL_DLL GDALPamRasterBand : public GDALRasterBand
     CPLErr SetMetadataItem( const char * pszName,
                             const char * pszValue,
                             const char * pszDomain = "" ) override;
+    char **GetMetadata( const char * pszDomain = "" ) override;
+    const char *GetMetadataItem( const char * pszName,
+                                 const char * pszDomain = "" ) override;
+    char **GetMetadataDomainList() override;
 
     GDALRasterAttributeTable *GetDefaultRAT() override;
     CPLErr SetDefaultRAT( const GDALRasterAttributeTable * ) override;
@@ -346,7 +356,7 @@ class CPL_DLL GDALPamRasterBand : public GDALRasterBand
     virtual CPLErr CloneInfo( GDALRasterBand *poSrcBand, int nCloneInfoFlags );
 
     // "semi private" methods.
-    GDALRasterBandPamInfo *GetPamInfo() { return psPam; }
+    GDALRasterBandPamInfo *GetPamInfo() { LoadDeferredPam(); return psPam; }
 //! @endcond
   private:
     CPL_DISALLOW_COPY_ASSIGN(GDALPamRasterBand)
@@ -0,0 +1,354 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  Registry of always-on performance counters
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdal_perf_counters.h"
+
+#include "cpl_string.h"
+#include "gdal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+CPL_CVSID("$Id$")
+
+namespace
+{
+struct PerfCounterRegistry
+{
+    std::mutex oMutex{};
+    std::map<std::string, std::unique_ptr<GDALPerfCounter>> oMap{};
+};
+} // namespace
+
+static PerfCounterRegistry& GetRegistry()
+{
+    static PerfCounterRegistry oRegistry;
+    return oRegistry;
+}
+
+/************************************************************************/
+/*                       GDALPerfCounter::Get()                         */
+/************************************************************************/
+
+/** Returns the counter of the specified name, creating it if needed.
+ *
+ * This takes a lock, so the result should be cached by the caller, for
+ * example with the GDAL_PERF_COUNTER() macro.
+ *
+ * @param pszName Counter name, e.g. "GTiff.blocks_decoded".
+ * @return a non-NULL pointer, valid until the end of the process.
+ */
+GDALPerfCounter* GDALPerfCounter::Get( const char* pszName )
+{
+    auto& oRegistry = GetRegistry();
+    std::lock_guard<std::mutex> oLock(oRegistry.oMutex);
+    auto& poCounter = oRegistry.oMap[pszName];
+    if( !poCounter )
+        poCounter.reset(new GDALPerfCounter());
+    return poCounter.get();
+}
+
+/************************************************************************/
+/*                         GDALGetPerfCounters()                        */
+/************************************************************************/
+
+/** Returns the value of the performance counters.
+ *
+ * Only counters that have been incremented since the start of the process
+ * or the last call to GDALResetPerfCounters() are returned.
+ *
+ * @return a list of "name=value" strings, sorted by name, to free with
+ * CSLDestroy().
+ * @since GDAL 3.4
+ */
+char** GDALGetPerfCounters()
+{
+    auto& oRegistry = GetRegistry();
+    std::lock_guard<std::mutex> oLock(oRegistry.oMutex);
+    CPLStringList aosList;
+    for( const auto& oIter: oRegistry.oMap )
+    {
+        const GIntBig nValue = oIter.second->GetValue();
+        if( nValue != 0 )
+        {
+            aosList.AddNameValue(oIter.first.c_str(),
+                                 CPLSPrintf(CPL_FRMT_GIB, nValue));
+        }
+    }
+    return aosList.StealList();
+}
+
+/************************************************************************/
+/*                        GDALResetPerfCounters()                       */
+/************************************************************************/
+
+/** Resets all performance counters to zero.
+ *
+ * @since GDAL 3.4
+ */
+void GDALResetPerfCounters()
+{
+    auto& oRegistry = GetRegistry();
+    std::lock_guard<std::mutex> oLock(oRegistry.oMutex);
+    for( auto& oIter: oRegistry.oMap )
+        oIter.second->Reset();
+}
+
+/************************************************************************/
+/*                        GDALLatencyHistogram()                        */
+/************************************************************************/
+
+/** Constructor. */
+GDALLatencyHistogram::GDALLatencyHistogram()
+{
+    Reset();
+}
+
+/************************************************************************/
+/*                                Add()                                 */
+/************************************************************************/
+
+/** Adds a duration, in nanoseconds. */
+void GDALLatencyHistogram::Add( GIntBig nNanoSec )
+{
+    const GIntBig nMicroSec = nNanoSec / 1000;
+    int iBucket = 0;
+    while( iBucket < BUCKET_COUNT - 1 &&
+           nMicroSec >= (static_cast<GIntBig>(1) << iBucket) )
+    {
+        ++iBucket;
+    }
+    m_anBuckets[iBucket].fetch_add(1, std::memory_order_relaxed);
+    m_nCount.fetch_add(1, std::memory_order_relaxed);
+    m_nTotalNanoSec.fetch_add(nNanoSec, std::memory_order_relaxed);
+    GIntBig nMax = m_nMaxNanoSec.load(std::memory_order_relaxed);
+    while( nNanoSec > nMax &&
+           !m_nMaxNanoSec.compare_exchange_weak(nMax, nNanoSec,
+                                                std::memory_order_relaxed) )
+    {
+    }
+}
+
+/************************************************************************/
+/*                               Reset()                                */
+/************************************************************************/
+
+/** Removes all durations. */
+void GDALLatencyHistogram::Reset()
+{
+    for( auto& nBucket: m_anBuckets )
+        nBucket.store(0, std::memory_order_relaxed);
+    m_nCount.store(0, std::memory_order_relaxed);
+    m_nTotalNanoSec.store(0, std::memory_order_relaxed);
+    m_nMaxNanoSec.store(0, std::memory_order_relaxed);
+}
+
+/************************************************************************/
+/*                           GetPercentile()                            */
+/************************************************************************/
+
+/** Returns an estimate of a percentile of the durations, in microseconds.
+ *
+ * The value is interpolated within the bucket containing the percentile,
+ * and is at most the maximum duration.
+ *
+ * @param dfPercent percentage in [0,100] range, e.g. 99 for the 99th
+ * percentile.
+ * @return the estimate, or 0 if no duration has been added.
+ */
+double GDALLatencyHistogram::GetPercentile( double dfPercent ) const
+{
+    GIntBig anBuckets[BUCKET_COUNT];
+    GIntBig nCount = 0;
+    for( int i = 0; i < BUCKET_COUNT; ++i )
+    {
+        anBuckets[i] = m_anBuckets[i].load(std::memory_order_relaxed);
+        nCount += anBuckets[i];
+    }
+    if( nCount == 0 )
+        return 0;
+    const double dfMax =
+        m_nMaxNanoSec.load(std::memory_order_relaxed) / 1000.0;
+    const double dfRank =
+        std::max(0.0, std::min(100.0, dfPercent)) / 100.0 * nCount;
+    GIntBig nCumulated = 0;
+    for( int i = 0; i < BUCKET_COUNT; ++i )
+    {
+        if( anBuckets[i] == 0 )
+            continue;
+        if( nCumulated + anBuckets[i] >= dfRank )
+        {
+            const double dfLow = i == 0 ? 0.0 : std::ldexp(1.0, i - 1);
+            const double dfHigh = std::ldexp(1.0, i);
+            const double dfRatio = (dfRank - nCumulated) / anBuckets[i];
+            return std::min(dfMax, dfLow + dfRatio * (dfHigh - dfLow));
+        }
+        nCumulated += anBuckets[i];
+    }
+    return dfMax;
+}
+
+/************************************************************************/
+/*                               Report()                               */
+/************************************************************************/
+
+/** Appends the statistics of the histogram to a list of NAME=VALUE strings.
+ *
+ * The keys are the prefix followed by _COUNT, _TOTAL_US, _MEAN_US, _P50_US,
+ * _P90_US, _P99_US, _MAX_US (durations in microseconds), and _HISTOGRAM,
+ * the comma-separated counts of the buckets, up to the last non-empty one.
+ *
+ * @param aosList list to complete.
+ * @param pszPrefix prefix of the keys.
+ */
+void GDALLatencyHistogram::Report( CPLStringList& aosList,
+                                   const char* pszPrefix ) const
+{
+    const GIntBig nCount = GetCount();
+    const double dfTotal =
+        m_nTotalNanoSec.load(std::memory_order_relaxed) / 1000.0;
+    aosList.SetNameValue(CPLSPrintf("%s_COUNT", pszPrefix),
+                         CPLSPrintf(CPL_FRMT_GIB, nCount));
+    aosList.SetNameValue(CPLSPrintf("%s_TOTAL_US", pszPrefix),
+                         CPLSPrintf("%.0f", dfTotal));
+    aosList.SetNameValue(CPLSPrintf("%s_MEAN_US", pszPrefix),
+                         CPLSPrintf("%.1f", nCount ? dfTotal / nCount : 0.0));
+    aosList.SetNameValue(CPLSPrintf("%s_P50_US", pszPrefix),
+                         CPLSPrintf("%.1f", GetPercentile(50)));
+    aosList.SetNameValue(CPLSPrintf("%s_P90_US", pszPrefix),
+                         CPLSPrintf("%.1f", GetPercentile(90)));
+    aosList.SetNameValue(CPLSPrintf("%s_P99_US", pszPrefix),
+                         CPLSPrintf("%.1f", GetPercentile(99)));
+    aosList.SetNameValue(CPLSPrintf("%s_MAX_US", pszPrefix),
+                         CPLSPrintf("%.1f",
+                             m_nMaxNanoSec.load(std::memory_order_relaxed) /
+                                 1000.0));
+    int nLast = -1;
+    for( int i = 0; i < BUCKET_COUNT; ++i )
+    {
+        if( m_anBuckets[i].load(std::memory_order_relaxed) != 0 )
+            nLast = i;
+    }
+    std::string osHistogram;
+    for( int i = 0; i <= nLast; ++i )
+    {
+        if( i > 0 )
+            osHistogram += ',';
+        osHistogram += CPLSPrintf(CPL_FRMT_GIB,
+            m_anBuckets[i].load(std::memory_order_relaxed));
+    }
+    aosList.SetNameValue(CPLSPrintf("%s_HISTOGRAM", pszPrefix),
+                         osHistogram.c_str());
+}
+
+//! @cond Doxygen_Suppress
+
+/************************************************************************/
+/*                    GDALGetThreadBlockReadStats()                     */
+/************************************************************************/
+
+GDALThreadBlockReadStats& GDALGetThreadBlockReadStats()
+{
+    static thread_local GDALThreadBlockReadStats tlsStats;
+    return tlsStats;
+}
+
+/************************************************************************/
+/*                  GDALRasterIOLatencyStats::Reset()                   */
+/************************************************************************/
+
+void GDALRasterIOLatencyStats::Reset()
+{
+    oHit.Reset();
+    oMiss.Reset();
+    oMissReadBlock.Reset();
+    oWrite.Reset();
+    nBlocksRead.store(0, std::memory_order_relaxed);
+}
+
+/************************************************************************/
+/*                  GDALRasterIOLatencyTimer::Start()                   */
+/************************************************************************/
+
+// Innermost timer of the current thread that is recording.
+static thread_local GDALRasterIOLatencyTimer* tlpoCurrentLatencyTimer = nullptr;
+
+void GDALRasterIOLatencyTimer::Start( GDALRasterIOLatencyStats* poStats,
+                                      bool bWrite )
+{
+    for( auto poIter = tlpoCurrentLatencyTimer; poIter;
+         poIter = poIter->m_poPrevious )
+    {
+        if( poIter->m_poStats == poStats )
+            return;
+    }
+    m_poStats = poStats;
+    m_bWrite = bWrite;
+    m_poPrevious = tlpoCurrentLatencyTimer;
+    tlpoCurrentLatencyTimer = this;
+    const auto& sBlockStats = GDALGetThreadBlockReadStats();
+    m_nBlockReadCountBefore = sBlockStats.nCount;
+    m_nBlockReadTimeBefore = sBlockStats.nTimeNanoSec;
+    m_oStart = std::chrono::steady_clock::now();
+}
+
+/************************************************************************/
+/*                   GDALRasterIOLatencyTimer::Stop()                   */
+/************************************************************************/
+
+void GDALRasterIOLatencyTimer::Stop()
+{
+    const GIntBig nElapsed = static_cast<GIntBig>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_oStart).count());
+    tlpoCurrentLatencyTimer = m_poPrevious;
+    if( m_bWrite )
+    {
+        m_poStats->oWrite.Add(nElapsed);
+        return;
+    }
+    const auto& sBlockStats = GDALGetThreadBlockReadStats();
+    const GIntBig nBlocksRead = sBlockStats.nCount - m_nBlockReadCountBefore;
+    if( nBlocksRead == 0 )
+    {
+        m_poStats->oHit.Add(nElapsed);
+    }
+    else
+    {
+        m_poStats->oMiss.Add(nElapsed);
+        m_poStats->oMissReadBlock.Add(
+            sBlockStats.nTimeNanoSec - m_nBlockReadTimeBefore);
+        m_poStats->nBlocksRead.fetch_add(nBlocksRead,
+                                         std::memory_order_relaxed);
+    }
+}
+
+//! @endcond
@@ -0,0 +1,246 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  Registry of always-on performance counters
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef GDAL_PERF_COUNTERS_H_INCLUDED
+#define GDAL_PERF_COUNTERS_H_INCLUDED
+
+#include "cpl_port.h"
+#include "cpl_string.h"
+
+#include <atomic>
+#include <chrono>
+
+/**
+ * \file gdal_perf_counters.h
+ *
+ * Always-on performance counters incremented by GDAL core and drivers.
+ *
+ * Counters are named "Domain.counter_name", typically with the driver short
+ * name as domain, e.g. "GTiff.blocks_decoded". By convention, the name of
+ * counters of elapsed time ends with "_time_ns" and their value is in
+ * nanoseconds.
+ *
+ * Counters are dumped with GDALGetPerfCounters(), or the -stats-perf switch
+ * of gdalinfo and ogrinfo.
+ *
+ * @since GDAL 3.4
+ */
+
+/** Performance counter.
+ *
+ * Instances are owned by the registry and are never destroyed before the
+ * end of the process, so pointers returned by Get() can be cached in
+ * static variables, which the GDAL_PERF_COUNTER() macro does.
+ *
+ * @since GDAL 3.4
+ */
+class CPL_DLL GDALPerfCounter
+{
+    CPL_DISALLOW_COPY_ASSIGN(GDALPerfCounter)
+
+    std::atomic<GIntBig> m_nValue{0};
+
+  public:
+//! @cond Doxygen_Suppress
+    GDALPerfCounter() = default;
+//! @endcond
+
+    static GDALPerfCounter* Get( const char* pszName );
+
+    /** Adds nIncrement to the counter. */
+    void Add( GIntBig nIncrement )
+    {
+        m_nValue.fetch_add(nIncrement, std::memory_order_relaxed);
+    }
+
+    /** Adds one to the counter. */
+    void Increment() { Add(1); }
+
+    /** Returns the value of the counter. */
+    GIntBig GetValue() const
+    {
+        return m_nValue.load(std::memory_order_relaxed);
+    }
+
+    /** Resets the counter to zero. */
+    void Reset() { m_nValue.store(0, std::memory_order_relaxed); }
+};
+
+/** Adds the time elapsed between its construction and destruction, in
+ * nanoseconds, to a counter.
+ *
+ * @since GDAL 3.4
+ */
+class GDALPerfCounterTimer
+{
+    CPL_DISALLOW_COPY_ASSIGN(GDALPerfCounterTimer)
+
+    GDALPerfCounter* m_poCounter;
+    std::chrono::steady_clock::time_point m_oStart;
+
+  public:
+    /** Starts the timer. */
+    explicit GDALPerfCounterTimer( GDALPerfCounter* poCounter ):
+        m_poCounter(poCounter), m_oStart(std::chrono::steady_clock::now())
+    {}
+
+    /** Stops the timer. */
+    ~GDALPerfCounterTimer()
+    {
+        m_poCounter->Add(static_cast<GIntBig>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_oStart).count()));
+    }
+};
+
+/** Declares a static pointer to the counter of the specified name. */
+#define GDAL_PERF_COUNTER(varname, pszName) \
+    static GDALPerfCounter* const varname = GDALPerfCounter::Get(pszName)
+
+/** Histogram of durations, with power-of-two buckets.
+ *
+ * Bucket 0 counts the durations below 1 microsecond, and bucket i > 0 the
+ * durations in [2^(i-1), 2^i[ microseconds. Updates are lock-free.
+ *
+ * @since GDAL 3.4
+ */
+class CPL_DLL GDALLatencyHistogram
+{
+  public:
+    /** Number of buckets. */
+    static constexpr int BUCKET_COUNT = 32;
+
+  private:
+    CPL_DISALLOW_COPY_ASSIGN(GDALLatencyHistogram)
+
+    std::atomic<GIntBig> m_anBuckets[BUCKET_COUNT];
+    std::atomic<GIntBig> m_nCount{0};
+    std::atomic<GIntBig> m_nTotalNanoSec{0};
+    std::atomic<GIntBig> m_nMaxNanoSec{0};
+
+  public:
+    GDALLatencyHistogram();
+
+    void    Add( GIntBig nNanoSec );
+    void    Reset();
+
+    /** Returns the number of durations added. */
+    GIntBig GetCount() const
+    {
+        return m_nCount.load(std::memory_order_relaxed);
+    }
+
+    double  GetPercentile( double dfPercent ) const;
+    void    Report( CPLStringList& aosList, const char* pszPrefix ) const;
+};
+
+//! @cond Doxygen_Suppress
+
+// Number and duration of the IReadBlock() calls issued by the block cache
+// in the current thread, so that callers can attribute them.
+struct GDALThreadBlockReadStats
+{
+    GIntBig nCount = 0;
+    GIntBig nTimeNanoSec = 0;
+};
+
+CPL_DLL GDALThreadBlockReadStats& GDALGetThreadBlockReadStats();
+
+// Like GDALPerfCounterTimer, but also updates GDALThreadBlockReadStats.
+class GDALBlockReadTimer
+{
+    CPL_DISALLOW_COPY_ASSIGN(GDALBlockReadTimer)
+
+    GDALPerfCounter* m_poCounter;
+    std::chrono::steady_clock::time_point m_oStart;
+
+  public:
+    explicit GDALBlockReadTimer( GDALPerfCounter* poCounter ):
+        m_poCounter(poCounter), m_oStart(std::chrono::steady_clock::now())
+    {}
+
+    ~GDALBlockReadTimer()
+    {
+        const GIntBig nElapsed = static_cast<GIntBig>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_oStart).count());
+        m_poCounter->Add(nElapsed);
+        auto& sStats = GDALGetThreadBlockReadStats();
+        sStats.nCount++;
+        sStats.nTimeNanoSec += nElapsed;
+    }
+};
+
+// RasterIO() latencies of a dataset. See GDALDataset::EnableRasterIOLatencyStats()
+struct GDALRasterIOLatencyStats
+{
+    // Reads that did not need any IReadBlock() call
+    GDALLatencyHistogram oHit{};
+    // Reads that needed at least one IReadBlock() call
+    GDALLatencyHistogram oMiss{};
+    // Time spent in IReadBlock() by each read of oMiss
+    GDALLatencyHistogram oMissReadBlock{};
+    GDALLatencyHistogram oWrite{};
+    std::atomic<GIntBig> nBlocksRead{0};
+
+    void Reset();
+};
+
+// Records the duration of a RasterIO() call in a GDALRasterIOLatencyStats.
+// Nested calls on the same statistics, such as GDALDataset::RasterIO()
+// calling GDALRasterBand::RasterIO(), are only recorded once.
+class CPL_DLL GDALRasterIOLatencyTimer
+{
+    CPL_DISALLOW_COPY_ASSIGN(GDALRasterIOLatencyTimer)
+
+    GDALRasterIOLatencyStats* m_poStats = nullptr;
+    GDALRasterIOLatencyTimer* m_poPrevious = nullptr;
+    bool m_bWrite = false;
+    GIntBig m_nBlockReadCountBefore = 0;
+    GIntBig m_nBlockReadTimeBefore = 0;
+    std::chrono::steady_clock::time_point m_oStart{};
+
+    void Start( GDALRasterIOLatencyStats* poStats, bool bWrite );
+    void Stop();
+
+  public:
+    GDALRasterIOLatencyTimer( GDALRasterIOLatencyStats* poStats, bool bWrite )
+    {
+        if( poStats )
+            Start(poStats, bWrite);
+    }
+
+    ~GDALRasterIOLatencyTimer()
+    {
+        if( m_poStats )
+            Stop();
+    }
+};
+
+//! @endcond
+
+#endif // GDAL_PERF_COUNTERS_H_INCLUDED
@@ -68,6 +68,7 @@ class GDALAsyncReader;
 
 #include <stdarg.h>
 
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <iterator>
@@ -325,6 +326,7 @@ class GDALGroup;
 
 //! @cond Doxygen_Suppress
 typedef struct GDALSQLParseInfo GDALSQLParseInfo;
+struct GDALRasterIOLatencyStats;
 //! @endcond
 
 //! @cond Doxygen_Suppress
@@ -458,6 +460,16 @@ class CPL_DLL GDALDataset : public GDALMajorObject
 
     int          AcquireMutex();
     void         ReleaseMutex();
+
+    // Background prefetching of the blocks announced by AdviseRead()
+    void                SchedulePrefetch( int nXOff, int nYOff,
+                                          int nXSize, int nYSize,
+                                          int nBandCount,
+                                          const int* panBandMap );
+    bool                TakePrefetchedBlock( int nBand,
+                                             int nXBlockOff, int nYBlockOff,
+                                             void* pData,
+                                             size_t nBlockBytes );
 //! @endcond
 
   public:
@@ -543,6 +555,13 @@ class CPL_DLL GDALDataset : public GDALMajorObject
                                int nBandCount, int *panBandList,
                                char **papszOptions );
 
+    virtual CPLErr RasterIOBatch( int nWindowCount,
+                                  const GDALRasterIOWindow* pasWindows,
+                                  GDALDataType eBufType,
+                                  int nBandCount, const int *panBandMap,
+                                  CSLConstList papszOptions )
+                                    CPL_WARN_UNUSED_RESULT;
+
     virtual CPLErr          CreateMaskBand( int nFlagsIn );
 
     virtual GDALAsyncReader*
@@ -672,7 +691,25 @@ class CPL_DLL GDALDataset : public GDALMajorObject
         OGRLayer* layer = nullptr;
     };
 
+    CPLErr SetCachePartition( const char* pszName );
+    const char* GetCachePartition() const;
+
+    void EnableRasterIOLatencyStats();
+    char** GetRasterIOLatencyStats() const CPL_WARN_UNUSED_RESULT;
+    void ResetRasterIOLatencyStats();
+
+    GIntBig GetMemoryUsage( GIntBig* pnBlockCacheBytes = nullptr,
+                            GIntBig* pnDriverBytes = nullptr );
+    GIntBig GetBlockCacheMemoryUsage();
+    virtual GIntBig GetDriverMemoryUsage();
+
 //! @cond Doxygen_Suppress
+    // Only to be used by GDALRasterBlock
+    int GetCachePartitionIndex() const;
+
+    // Only to be used by RasterIO() methods
+    GDALRasterIOLatencyStats* GetRasterIOLatencyStatsInternal() const;
+
     // SetEnableOverviews() only to be used by GDALOverviewDataset
     void SetEnableOverviews(bool bEnable);
 
@@ -926,6 +963,11 @@ class CPL_DLL GDALRasterBlock
 
     bool                 bMustDetach;
 
+    int                  nShard;  // index of the LRU shard of the block
+    // Value of the shard touch counter when last moved to the LRU head.
+    // Written under the shard lock, but read without it by lazy touches.
+    std::atomic<unsigned> nTouchEpoch;
+
     CPL_INTERNAL void        Detach_unlocked( void );
     CPL_INTERNAL void        Touch_unlocked( void );
 
@@ -991,6 +1033,12 @@ class CPL_DLL GDALRasterBlock
 
     static void FlushDirtyBlocks();
     static int  FlushCacheBlock(int bDirtyBlocksOnly = FALSE);
+    static void GetCacheStatistics(GDALCacheStatistics* psStats);
+//! @cond Doxygen_Suppress
+    CPL_INTERNAL static int FlushCacheBlockFromShards(int iFirstShardOfPool,
+                                                      int nShardsOfPool,
+                                                      int bDirtyBlocksOnly);
+//! @endcond
     static void Verify();
 
     static void EnterDisableDirtyBlockFlush();
@@ -1077,6 +1125,16 @@ class GDALAbstractBandBlockCache
 
         CPL_DISALLOW_COPY_ASSIGN(GDALAbstractBandBlockCache)
 
+        friend class GDALRasterBlock;
+        friend class GDALRasterBand;
+
+        // Cumulative statistics. See GDALGetRasterBandCacheStatistics()
+        std::atomic<GIntBig> m_nHits{0};
+        std::atomic<GIntBig> m_nMisses{0};
+        std::atomic<GIntBig> m_nEvictions{0};
+        std::atomic<GIntBig> m_nDirtyFlushes{0};
+        std::atomic<GIntBig> m_nBytesResident{0};
+
     protected:
         GDALRasterBand   *poBand;
 
@@ -1113,6 +1171,9 @@ class GDALAbstractBandBlockCache
 GDALAbstractBandBlockCache* GDALArrayBandBlockCacheCreate(GDALRasterBand* poBand);
 GDALAbstractBandBlockCache* GDALHashSetBandBlockCacheCreate(GDALRasterBand* poBand);
 
+int GDALGetCachePartitionIndex( const char* pszName );
+const char* GDALGetCachePartitionName( int iPartition );
+
 //! @endcond
 
 /* ******************************************************************** */
@@ -1137,6 +1198,11 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
     CPL_INTERNAL void           SetFlushBlockErr( CPLErr eErr );
     CPL_INTERNAL CPLErr         UnreferenceBlock( GDALRasterBlock* poBlock );
     CPL_INTERNAL void           SetValidPercent( GUIntBig nSampleCount, GUIntBig nValidCount );
+    CPL_INTERNAL CPLErr         ComputeStatisticsAndDefaultHistogram(
+                                    double *pdfMin, double *pdfMax,
+                                    int nBuckets, GUIntBig *panHistogram,
+                                    GDALProgressFunc pfnProgress,
+                                    void *pProgressData );
     CPL_INTERNAL void           IncDirtyBlocks(int nInc);
 
   protected:
@@ -1203,6 +1269,7 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
                                 int* pbTried );
 
     int            InitBlockInfo();
+    bool           HasDirtyBlocks() const;
 
     void           AddBlockToFreeList( GDALRasterBlock * );
 //! @endcond
@@ -1240,6 +1307,8 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
                                         int bJustInitialize = FALSE ) CPL_WARN_UNUSED_RESULT;
     CPLErr      FlushBlock( int, int, int bWriteDirtyBlock = TRUE );
 
+    void        GetCacheStatistics( GDALCacheStatistics* psStats );
+
     unsigned char*  GetIndexColorTranslationTo(/* const */ GDALRasterBand* poReferenceBand,
                                                unsigned char* pTranslationTable = nullptr,
                                                int* pApproximateMatching = nullptr);
@@ -1312,6 +1381,12 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
                                         GDALProgressFunc, void *pProgressData);
     virtual CPLErr SetDefaultHistogram( double dfMin, double dfMax,
                                         int nBuckets, GUIntBig *panHistogram );
+    CPLErr ComputePercentiles( int nPercentiles,
+                               const double *padfPercentiles,
+                               double *padfValues,
+                               int bForce,
+                               GDALProgressFunc pfnProgress,
+                               void *pProgressData );
 
     virtual GDALRasterAttributeTable *GetDefaultRAT();
     virtual CPLErr SetDefaultRAT( const GDALRasterAttributeTable * poRAT );
@@ -1647,6 +1722,35 @@ class CPL_DLL GDALDriverManager : public GDALMajorObject
     GDALDriver  *GetDriverByName_unlocked( const char * pszName )
             { return oMapNameToDrivers[CPLString(pszName).toupper()]; }
 
+    // Index of the drivers that can open datasets, used to narrow the list
+    // of drivers probed by GDALOpenEx(). Rebuilt when the driver list or
+    // the capabilities of a driver change.
+    struct OpenIndexEntry
+    {
+        GDALDriver *poDriver;
+        bool        bRaster;
+        bool        bVector;
+        bool        bMultiDimRaster;
+    };
+    std::vector<OpenIndexEntry> m_aoOpenIndex{};
+    std::map<CPLString, std::vector<size_t>> m_oMapExtensionToOpenIndex{};
+    int         m_nOpenIndexGeneration = -1;
+
+    void        BuildOpenIndex_unlocked();
+
+    // Plugins found by AutoLoadDrivers(), or whose loading is deferred
+    // until a driver that is not registered yet is needed.
+    struct PluginEntry
+    {
+        CPLString   osFilename;
+        CPLString   osFuncName;
+    };
+    std::vector<PluginEntry> m_aoDeferredPlugins{};
+    std::atomic<bool> m_bHasDeferredPlugins{false};
+
+    static std::vector<PluginEntry> ListPlugins();
+    static void LoadPlugin( const PluginEntry& oPlugin );
+
     static char** GetSearchPaths(const char* pszGDAL_DRIVER_PATH);
 
     static void   CleanupPythonDrivers();
@@ -1669,6 +1773,15 @@ class CPL_DLL GDALDriverManager : public GDALMajorObject
     void        AutoSkipDrivers();
 
     static void        AutoLoadPythonDrivers();
+
+    void        DeclareDeferredPlugins();
+    bool        LoadDeferredPlugins();
+
+    //! @cond Doxygen_Suppress
+    std::vector<GDALDriver*> GetOpenCandidates( int nOpenFlags,
+                                                const char* pszExtension );
+    static void InvalidateOpenIndex();
+    //! @endcond
 };
 
 CPL_C_START
@@ -2392,6 +2505,19 @@ class CPL_DLL GDALMDArray: virtual public GDALAbstractMDArray, public GDALIHasAt
     mutable bool m_bHasTriedCachedArray = false;
     mutable std::shared_ptr<GDALMDArray> m_poCachedArray{};
 
+    // Identifier of the array in the chunk cache. 0 if not assigned yet.
+    mutable GUInt64 m_nChunkCacheId = 0;
+
+    friend class GDALAbstractMDArray;
+    void InvalidateChunkCache() const;
+    bool ReadThroughChunkCache(const GUInt64* arrayStartIdx,
+                               const size_t* count,
+                               const GInt64* arrayStep,
+                               const GPtrDiff_t* bufferStride,
+                               const GDALExtendedDataType& bufferDataType,
+                               void* pDstBuffer,
+                               bool& bHandled) const;
+
 protected:
 //! @cond Doxygen_Suppress
     GDALMDArray(const std::string& osParentName, const std::string& osName);
@@ -2400,6 +2526,15 @@ protected:
                              const size_t* count) const;
 
     virtual bool IsCacheable() const { return true; }
+
+    /** Whether Read() may serve requests from the chunk cache enabled by
+     * GDAL_MDARRAY_CHUNK_CACHE_SIZE. GetBlockSize() must then return the
+     * size of the chunks of the storage. */
+    virtual bool IsChunkCacheable() const { return false; }
+
+    /** Whether IRead() can be called concurrently from several threads,
+     * so that chunks missing from the chunk cache are read in parallel. */
+    virtual bool IsIReadThreadSafe() const { return false; }
 //! @endcond
 
 public:
@@ -2484,6 +2619,10 @@ public:
 
     virtual std::shared_ptr<GDALMDArray> GetMask(CSLConstList papszOptions) const;
 
+    std::shared_ptr<GDALMDArray> GetReduction(const std::string& osOperation,
+                                              size_t iDim,
+                                              CSLConstList papszOptions = nullptr) const;
+
     std::shared_ptr<GDALMDArray>
         GetResampled( const std::vector<std::shared_ptr<GDALDimension>>& apoNewDims,
                       GDALRIOResampleAlg resampleAlg,
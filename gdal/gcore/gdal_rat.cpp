@@ -37,6 +37,7 @@
 #include <cstdlib>
 
 #include <algorithm>
+#include <functional>
 #include <vector>
 
 #include "cpl_conv.h"
@@ -135,14 +136,14 @@ CPLErr GDALRasterAttributeTable::ValuesIO(
     {
         for( int iIndex = iStartRow; iIndex < (iStartRow + iLength); iIndex++ )
         {
-            pdfData[iIndex] = GetValueAsDouble(iIndex, iField);
+            pdfData[iIndex - iStartRow] = GetValueAsDouble(iIndex, iField);
         }
     }
     else
     {
         for( int iIndex = iStartRow; iIndex < (iStartRow + iLength); iIndex++ )
         {
-            SetValue(iIndex, iField, pdfData[iIndex]);
+            SetValue(iIndex, iField, pdfData[iIndex - iStartRow]);
         }
     }
     return CE_None;
@@ -197,14 +198,14 @@ CPLErr GDALRasterAttributeTable::ValuesIO(
     {
         for( int iIndex = iStartRow; iIndex < (iStartRow + iLength); iIndex++ )
         {
-            pnData[iIndex] = GetValueAsInt(iIndex, iField);
+            pnData[iIndex - iStartRow] = GetValueAsInt(iIndex, iField);
         }
     }
     else
     {
         for( int iIndex = iStartRow; iIndex < (iStartRow + iLength); iIndex++ )
         {
-            SetValue(iIndex, iField, pnData[iIndex]);
+            SetValue(iIndex, iField, pnData[iIndex - iStartRow]);
         }
     }
     return CE_None;
@@ -262,14 +263,15 @@ CPLErr GDALRasterAttributeTable::ValuesIO(
     {
         for( int iIndex = iStartRow; iIndex < (iStartRow + iLength); iIndex++ )
         {
-            papszStrList[iIndex] = VSIStrdup(GetValueAsString(iIndex, iField));
+            papszStrList[iIndex - iStartRow] =
+                VSIStrdup(GetValueAsString(iIndex, iField));
         }
     }
     else
     {
         for( int iIndex = iStartRow; iIndex < (iStartRow + iLength); iIndex++ )
         {
-            SetValue(iIndex, iField, papszStrList[iIndex]);
+            SetValue(iIndex, iField, papszStrList[iIndex - iStartRow]);
         }
     }
     return CE_None;
@@ -1232,6 +1234,106 @@ GDALDestroyRasterAttributeTable( GDALRasterAttributeTableH hRAT )
         delete GDALRasterAttributeTable::FromHandle(hRAT);
 }
 
+//! @cond Doxygen_Suppress
+
+/************************************************************************/
+/*                            InitStrings()                             */
+/************************************************************************/
+
+void GDALRasterAttributeField::InitStrings()
+
+{
+    aosValues.clear();
+    oMapHashToIdx.clear();
+    bDeduplicateStrings = true;
+    aosValues.emplace_back("");
+    oMapHashToIdx.emplace(std::hash<std::string>()(std::string()), 0);
+}
+
+/************************************************************************/
+/*                            GetStringIdx()                            */
+/*                                                                      */
+/*      Return the index of a value in the dictionary, adding it if     */
+/*      needed.                                                         */
+/************************************************************************/
+
+GInt32 GDALRasterAttributeField::GetStringIdx( const std::string& osValue )
+
+{
+    if( osValue.empty() )
+        return 0;
+
+    if( bDeduplicateStrings )
+    {
+        const size_t nHash = std::hash<std::string>()(osValue);
+        const auto oRange = oMapHashToIdx.equal_range(nHash);
+        for( auto oIter = oRange.first; oIter != oRange.second; ++oIter )
+        {
+            if( aosValues[oIter->second] == osValue )
+                return oIter->second;
+        }
+
+        const GInt32 nIdx = static_cast<GInt32>(aosValues.size());
+        aosValues.emplace_back(osValue);
+        oMapHashToIdx.emplace(nHash, nIdx);
+
+        // Columns with mostly distinct values (identifiers, ...) would not
+        // benefit from the dictionary, so stop paying for its lookup map.
+        if( aosValues.size() > 4096 &&
+            aosValues.size() > anStringIdx.size() / 2 )
+        {
+            bDeduplicateStrings = false;
+            std::unordered_multimap<size_t, GInt32>().swap(oMapHashToIdx);
+        }
+        return nIdx;
+    }
+
+    const GInt32 nIdx = static_cast<GInt32>(aosValues.size());
+    aosValues.emplace_back(osValue);
+    return nIdx;
+}
+
+/************************************************************************/
+/*                       CompactStringsIfNeeded()                       */
+/*                                                                      */
+/*      Drop dictionary entries that are no longer referenced by any    */
+/*      row after values have been overwritten.                         */
+/************************************************************************/
+
+void GDALRasterAttributeField::CompactStringsIfNeeded()
+
+{
+    if( aosValues.size() <= 2 * anStringIdx.size() + 1024 )
+        return;
+
+    std::vector<GInt32> anRemap(aosValues.size(), -1);
+    std::vector<CPLString> aosNewValues;
+    anRemap[0] = 0;
+    aosNewValues.emplace_back("");
+    for( auto& nIdx: anStringIdx )
+    {
+        if( anRemap[nIdx] < 0 )
+        {
+            anRemap[nIdx] = static_cast<GInt32>(aosNewValues.size());
+            aosNewValues.emplace_back(std::move(aosValues[nIdx]));
+        }
+        nIdx = anRemap[nIdx];
+    }
+    aosValues = std::move(aosNewValues);
+
+    oMapHashToIdx.clear();
+    if( bDeduplicateStrings )
+    {
+        for( size_t i = 0; i < aosValues.size(); i++ )
+        {
+            oMapHashToIdx.emplace(std::hash<std::string>()(aosValues[i]),
+                                  static_cast<GInt32>(i));
+        }
+    }
+}
+
+//! @endcond
+
 /************************************************************************/
 /*                           AnalyseColumns()                           */
 /*                                                                      */
@@ -1514,7 +1616,8 @@ GDALDefaultRasterAttributeTable::GetValueAsString( int iRow, int iField ) const
 
       case GFT_String:
       {
-          return aoFields[iField].aosValues[iRow];
+          const auto& oField = aoFields[iField];
+          return oField.aosValues[oField.anStringIdx[iRow]];
       }
     }
 
@@ -1573,7 +1676,8 @@ GDALDefaultRasterAttributeTable::GetValueAsInt( int iRow, int iField ) const
         return static_cast<int>( aoFields[iField].adfValues[iRow] );
 
       case GFT_String:
-        return atoi( aoFields[iField].aosValues[iRow].c_str() );
+        return atoi( aoFields[iField].aosValues[
+                         aoFields[iField].anStringIdx[iRow]].c_str() );
     }
 
     return 0;
@@ -1632,7 +1736,8 @@ GDALDefaultRasterAttributeTable::GetValueAsDouble( int iRow, int iField ) const
         return aoFields[iField].adfValues[iRow];
 
       case GFT_String:
-        return CPLAtof( aoFields[iField].aosValues[iRow].c_str() );
+        return CPLAtof( aoFields[iField].aosValues[
+                            aoFields[iField].anStringIdx[iRow]].c_str() );
     }
 
     return 0;
@@ -1684,12 +1789,14 @@ void GDALDefaultRasterAttributeTable::SetRowCount( int nNewCount )
             break;
 
           case GFT_String:
-            oField.aosValues.resize( nNewCount );
+            oField.anStringIdx.resize( nNewCount );
+            oField.CompactStringsIfNeeded();
             break;
         }
     }
 
     nRowCount = nNewCount;
+    InvalidateRowOfValueIndex();
 }
 
 /************************************************************************/
@@ -1735,9 +1842,16 @@ void GDALDefaultRasterAttributeTable::SetValue( int iRow, int iField,
         break;
 
       case GFT_String:
-        aoFields[iField].aosValues[iRow] = pszValue;
-        break;
+      {
+          auto& oField = aoFields[iField];
+          oField.anStringIdx[iRow] = oField.GetStringIdx(pszValue);
+          oField.CompactStringsIfNeeded();
+          return;
+      }
     }
+
+    if( iField == nMinCol || iField == nMaxCol )
+        InvalidateRowOfValueIndex();
 }
 
 /************************************************************************/
@@ -1807,10 +1921,15 @@ void GDALDefaultRasterAttributeTable::SetValue( int iRow, int iField,
           char szValue[100];
 
           snprintf( szValue, sizeof(szValue), "%d", nValue );
-          aoFields[iField].aosValues[iRow] = szValue;
+          auto& oField = aoFields[iField];
+          oField.anStringIdx[iRow] = oField.GetStringIdx(szValue);
+          oField.CompactStringsIfNeeded();
+          return;
       }
-      break;
     }
+
+    if( iField == nMinCol || iField == nMaxCol )
+        InvalidateRowOfValueIndex();
 }
 
 /************************************************************************/
@@ -1876,10 +1995,15 @@ void GDALDefaultRasterAttributeTable::SetValue( int iRow, int iField,
           char szValue[100] = { '\0' };
 
           CPLsnprintf( szValue, sizeof(szValue), "%.15g", dfValue );
-          aoFields[iField].aosValues[iRow] = szValue;
+          auto& oField = aoFields[iField];
+          oField.anStringIdx[iRow] = oField.GetStringIdx(szValue);
+          oField.CompactStringsIfNeeded();
+          return;
       }
-      break;
     }
+
+    if( iField == nMinCol || iField == nMaxCol )
+        InvalidateRowOfValueIndex();
 }
 
 /************************************************************************/
@@ -1963,6 +2087,44 @@ int GDALDefaultRasterAttributeTable::GetRowOfValue( double dfValue ) const
     if( nMinCol == -1 && nMaxCol == -1 )
         return -1;
 
+/* -------------------------------------------------------------------- */
+/*      Use the index when the layout of the table allows it.           */
+/* -------------------------------------------------------------------- */
+    if( eRowOfValueIndex == ROV_INDEX_NOT_BUILT )
+        const_cast<GDALDefaultRasterAttributeTable *>(this)->
+            BuildRowOfValueIndex();
+
+    if( eRowOfValueIndex == ROV_INDEX_SORTED_RANGES && !std::isnan(dfValue) )
+    {
+        // Find the last row whose minimum is <= dfValue.
+        int nLow = 0;
+        int nHigh = nRowCount;
+        while( nLow < nHigh )
+        {
+            const int nMid = nLow + (nHigh - nLow) / 2;
+            if( GetNumericValue(nMid, nMinCol) <= dfValue )
+                nLow = nMid + 1;
+            else
+                nHigh = nMid;
+        }
+        const int iRow = nLow - 1;
+        if( iRow >= 0 && dfValue <= GetNumericValue(iRow, nMaxCol) )
+            return iRow;
+        return -1;
+    }
+
+    if( eRowOfValueIndex == ROV_INDEX_SORTED_ROWS && !std::isnan(dfValue) )
+    {
+        const auto oIter = std::lower_bound(
+            anSortedRows.begin(), anSortedRows.end(), dfValue,
+            [this](int iRow, double dfVal)
+            { return GetNumericValue(iRow, nMinCol) < dfVal; });
+        if( oIter != anSortedRows.end() &&
+            GetNumericValue(*oIter, nMinCol) == dfValue )
+            return *oIter;
+        return -1;
+    }
+
     const GDALRasterAttributeField *poMin = nullptr;
     if( nMinCol != -1 )
         poMin = &(aoFields[nMinCol]);
@@ -2012,6 +2174,261 @@ int GDALDefaultRasterAttributeTable::GetRowOfValue( double dfValue ) const
     return -1;
 }
 
+/************************************************************************/
+/*                          GetNumericValue()                           */
+/************************************************************************/
+
+double GDALDefaultRasterAttributeTable::GetNumericValue( int iRow,
+                                                         int iField ) const
+
+{
+    const auto& oField = aoFields[iField];
+    if( oField.eType == GFT_Integer )
+        return oField.anValues[iRow];
+    return oField.adfValues[iRow];
+}
+
+/************************************************************************/
+/*                      InvalidateRowOfValueIndex()                     */
+/************************************************************************/
+
+void GDALDefaultRasterAttributeTable::InvalidateRowOfValueIndex()
+
+{
+    eRowOfValueIndex = ROV_INDEX_NOT_BUILT;
+    anSortedRows.clear();
+}
+
+/************************************************************************/
+/*                        BuildRowOfValueIndex()                        */
+/*                                                                      */
+/*      Determine if GetRowOfValue() can use a binary search instead    */
+/*      of the linear scan, while returning the same row, which is      */
+/*      the first one such that Min <= value <= Max.                    */
+/************************************************************************/
+
+void GDALDefaultRasterAttributeTable::BuildRowOfValueIndex()
+
+{
+    eRowOfValueIndex = ROV_INDEX_NONE;
+    std::vector<int>().swap(anSortedRows);
+
+    // A single Min or Max column, or string columns, are left to the
+    // linear scan.
+    if( nMinCol < 0 || nMaxCol < 0 ||
+        aoFields[nMinCol].eType == GFT_String ||
+        aoFields[nMaxCol].eType == GFT_String )
+        return;
+
+    // NaN values match any value in the linear scan.
+    for( int iRow = 0; iRow < nRowCount; iRow++ )
+    {
+        if( std::isnan(GetNumericValue(iRow, nMinCol)) ||
+            std::isnan(GetNumericValue(iRow, nMaxCol)) )
+            return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Ranges sorted in increasing order and not overlapping: no       */
+/*      extra memory needed.                                            */
+/* -------------------------------------------------------------------- */
+    bool bSortedRanges = true;
+    for( int iRow = 0; iRow < nRowCount; iRow++ )
+    {
+        if( GetNumericValue(iRow, nMinCol) > GetNumericValue(iRow, nMaxCol) ||
+            (iRow > 0 && GetNumericValue(iRow - 1, nMaxCol) >=
+                                        GetNumericValue(iRow, nMinCol)) )
+        {
+            bSortedRanges = false;
+            break;
+        }
+    }
+    if( bSortedRanges )
+    {
+        eRowOfValueIndex = ROV_INDEX_SORTED_RANGES;
+        return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Discrete values in any order: sort row numbers by value, and    */
+/*      by row number for identical values so that the first row is     */
+/*      returned.                                                       */
+/* -------------------------------------------------------------------- */
+    if( nMinCol != nMaxCol )
+        return;
+
+    try
+    {
+        anSortedRows.resize(nRowCount);
+    }
+    catch( const std::bad_alloc& )
+    {
+        return;
+    }
+    for( int iRow = 0; iRow < nRowCount; iRow++ )
+        anSortedRows[iRow] = iRow;
+    std::sort(anSortedRows.begin(), anSortedRows.end(),
+              [this](int iRow1, int iRow2)
+              {
+                  const double dfVal1 = GetNumericValue(iRow1, nMinCol);
+                  const double dfVal2 = GetNumericValue(iRow2, nMinCol);
+                  return dfVal1 < dfVal2 ||
+                         (dfVal1 == dfVal2 && iRow1 < iRow2);
+              });
+    eRowOfValueIndex = ROV_INDEX_SORTED_ROWS;
+}
+
+/************************************************************************/
+/*                              ValuesIO()                              */
+/************************************************************************/
+
+CPLErr GDALDefaultRasterAttributeTable::ValuesIO( GDALRWFlag eRWFlag,
+                                                  int iField,
+                                                  int iStartRow, int iLength,
+                                                  double *pdfData )
+
+{
+    if( iField < 0 || iField >= static_cast<int>(aoFields.size()) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "iField (%d) out of range.", iField );
+
+        return CE_Failure;
+    }
+
+    if( iStartRow < 0 || iLength < 0 || iStartRow > nRowCount - iLength )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Rows %d to %d out of range.", iStartRow,
+                  iStartRow + iLength - 1 );
+
+        return CE_Failure;
+    }
+
+    auto& oField = aoFields[iField];
+    if( oField.eType != GFT_Real )
+        return GDALRasterAttributeTable::ValuesIO(eRWFlag, iField,
+                                                  iStartRow, iLength,
+                                                  pdfData);
+
+    if( eRWFlag == GF_Read )
+    {
+        std::copy(oField.adfValues.begin() + iStartRow,
+                  oField.adfValues.begin() + iStartRow + iLength,
+                  pdfData);
+    }
+    else
+    {
+        std::copy(pdfData, pdfData + iLength,
+                  oField.adfValues.begin() + iStartRow);
+        if( iField == nMinCol || iField == nMaxCol )
+            InvalidateRowOfValueIndex();
+    }
+    return CE_None;
+}
+
+/************************************************************************/
+/*                              ValuesIO()                              */
+/************************************************************************/
+
+CPLErr GDALDefaultRasterAttributeTable::ValuesIO( GDALRWFlag eRWFlag,
+                                                  int iField,
+                                                  int iStartRow, int iLength,
+                                                  int *pnData )
+
+{
+    if( iField < 0 || iField >= static_cast<int>(aoFields.size()) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "iField (%d) out of range.", iField );
+
+        return CE_Failure;
+    }
+
+    if( iStartRow < 0 || iLength < 0 || iStartRow > nRowCount - iLength )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Rows %d to %d out of range.", iStartRow,
+                  iStartRow + iLength - 1 );
+
+        return CE_Failure;
+    }
+
+    auto& oField = aoFields[iField];
+    if( oField.eType != GFT_Integer )
+        return GDALRasterAttributeTable::ValuesIO(eRWFlag, iField,
+                                                  iStartRow, iLength,
+                                                  pnData);
+
+    if( eRWFlag == GF_Read )
+    {
+        std::copy(oField.anValues.begin() + iStartRow,
+                  oField.anValues.begin() + iStartRow + iLength,
+                  pnData);
+    }
+    else
+    {
+        std::copy(pnData, pnData + iLength,
+                  oField.anValues.begin() + iStartRow);
+        if( iField == nMinCol || iField == nMaxCol )
+            InvalidateRowOfValueIndex();
+    }
+    return CE_None;
+}
+
+/************************************************************************/
+/*                              ValuesIO()                              */
+/************************************************************************/
+
+CPLErr GDALDefaultRasterAttributeTable::ValuesIO( GDALRWFlag eRWFlag,
+                                                  int iField,
+                                                  int iStartRow, int iLength,
+                                                  char **papszStrList )
+
+{
+    if( iField < 0 || iField >= static_cast<int>(aoFields.size()) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "iField (%d) out of range.", iField );
+
+        return CE_Failure;
+    }
+
+    if( iStartRow < 0 || iLength < 0 || iStartRow > nRowCount - iLength )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Rows %d to %d out of range.", iStartRow,
+                  iStartRow + iLength - 1 );
+
+        return CE_Failure;
+    }
+
+    auto& oField = aoFields[iField];
+    if( oField.eType != GFT_String )
+        return GDALRasterAttributeTable::ValuesIO(eRWFlag, iField,
+                                                  iStartRow, iLength,
+                                                  papszStrList);
+
+    if( eRWFlag == GF_Read )
+    {
+        for( int i = 0; i < iLength; i++ )
+        {
+            papszStrList[i] = VSIStrdup(
+                oField.aosValues[oField.anStringIdx[iStartRow + i]].c_str());
+        }
+    }
+    else
+    {
+        for( int i = 0; i < iLength; i++ )
+        {
+            oField.anStringIdx[iStartRow + i] = oField.GetStringIdx(
+                papszStrList[i] ? papszStrList[i] : "");
+        }
+        oField.CompactStringsIfNeeded();
+    }
+    return CE_None;
+}
+
 /************************************************************************/
 /*                           GetRowOfValue()                            */
 /*                                                                      */
@@ -2133,7 +2550,14 @@ CPLErr GDALDefaultRasterAttributeTable::CreateColumn(
     else if( eFieldType == GFT_Real )
         aoFields[iNewField].adfValues.resize( nRowCount );
     else if( eFieldType == GFT_String )
-        aoFields[iNewField].aosValues.resize( nRowCount );
+    {
+        aoFields[iNewField].InitStrings();
+        aoFields[iNewField].anStringIdx.resize( nRowCount );
+    }
+
+    // The new column might be a Min/Max one.
+    bColumnsAnalysed = false;
+    InvalidateRowOfValueIndex();
 
     return CE_None;
 }
@@ -2186,7 +2610,10 @@ void GDALDefaultRasterAttributeTable::RemoveStatistics()
                 }
         }
     }
-    aoFields = aoNewFields;
+    aoFields = std::move(aoNewFields);
+
+    bColumnsAnalysed = false;
+    InvalidateRowOfValueIndex();
 }
 
 /************************************************************************/
@@ -33,6 +33,8 @@
 #include "cpl_minixml.h"
 #include "gdal_priv.h"
 
+#include <unordered_map>
+
 // Clone and Serialize are allowed to fail if GetRowCount()*GetColCount()
 // greater than this number
 #define RAT_MAX_ELEM_FOR_CLONE  1000000
@@ -330,7 +332,18 @@ class GDALRasterAttributeField
 
     std::vector<GInt32> anValues{};
     std::vector<double> adfValues{};
+
+    // String values are dictionary encoded: anStringIdx holds for each row
+    // the index of its value in aosValues, whose first entry is always the
+    // empty string. oMapHashToIdx is used to find already stored values.
+    std::vector<GInt32> anStringIdx{};
     std::vector<CPLString> aosValues{};
+    std::unordered_multimap<size_t, GInt32> oMapHashToIdx{};
+    bool bDeduplicateStrings = true;
+
+    void   InitStrings();
+    GInt32 GetStringIdx( const std::string& osValue );
+    void   CompactStringsIfNeeded();
 };
 //! @endcond
 
@@ -360,6 +373,22 @@ class CPL_DLL GDALDefaultRasterAttributeTable : public GDALRasterAttributeTable
 
     CPLString osWorkingResult{};
 
+    // Acceleration structure for GetRowOfValue() when there is no
+    // linear binning.
+    enum RowOfValueIndexType
+    {
+        ROV_INDEX_NOT_BUILT,
+        ROV_INDEX_NONE,          // linear scan
+        ROV_INDEX_SORTED_RANGES, // rows sorted by disjoint min/max ranges
+        ROV_INDEX_SORTED_ROWS    // anSortedRows sorted by MinMax value
+    };
+    RowOfValueIndexType eRowOfValueIndex = ROV_INDEX_NOT_BUILT;
+    std::vector<int> anSortedRows{};
+
+    void  BuildRowOfValueIndex();
+    void  InvalidateRowOfValueIndex();
+    double GetNumericValue( int iRow, int iField ) const;
+
  public:
     GDALDefaultRasterAttributeTable();
     ~GDALDefaultRasterAttributeTable() override;
@@ -385,6 +414,15 @@ class CPL_DLL GDALDefaultRasterAttributeTable : public GDALRasterAttributeTable
     void SetValue( int iRow, int iField, double dfValue) override;
     void SetValue( int iRow, int iField, int nValue ) override;
 
+    CPLErr ValuesIO( GDALRWFlag eRWFlag, int iField,
+                     int iStartRow, int iLength,
+                     double *pdfData ) override;
+    CPLErr ValuesIO( GDALRWFlag eRWFlag, int iField,
+                     int iStartRow, int iLength, int *pnData ) override;
+    CPLErr ValuesIO( GDALRWFlag eRWFlag, int iField,
+                     int iStartRow, int iLength,
+                     char **papszStrList ) override;
+
     int ChangesAreWrittenToFile() override;
     void SetRowCount( int iCount ) override;
 
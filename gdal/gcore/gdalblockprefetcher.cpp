@@ -0,0 +1,306 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  Background block prefetcher used by the default AdviseRead()
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdalblockprefetcher.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_string.h"
+#include "gdal_priv.h"
+#include "gdal_thread_pool.h"
+
+CPL_CVSID("$Id$")
+
+//! @cond Doxygen_Suppress
+
+/************************************************************************/
+/*                        GDALBlockPrefetcher()                         */
+/************************************************************************/
+
+GDALBlockPrefetcher::GDALBlockPrefetcher( const char* pszFilename,
+                                          const char* pszDriverName,
+                                          CSLConstList papszOpenOptions ) :
+    m_osFilename(pszFilename),
+    m_osDriverName(pszDriverName ? pszDriverName : ""),
+    m_papszOpenOptions(CSLDuplicate(papszOpenOptions))
+{
+    // Do not let prefetched blocks use more than a quarter of the block
+    // cache size, unless specified otherwise.
+    const char* pszMaxMem =
+        CPLGetConfigOption("GDAL_ADVISE_READ_PREFETCH_MAX_MEM", nullptr);
+    if( pszMaxMem )
+        m_nMaxReadyBytes = static_cast<size_t>(
+            std::max(1.0, CPLAtof(pszMaxMem)) * 1024 * 1024);
+    else
+        m_nMaxReadyBytes = static_cast<size_t>(GDALGetCacheMax64() / 4);
+}
+
+/************************************************************************/
+/*                       ~GDALBlockPrefetcher()                         */
+/************************************************************************/
+
+GDALBlockPrefetcher::~GDALBlockPrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        m_bStop = true;
+        m_aoQueue.clear();
+        m_oSetQueued.clear();
+    }
+    m_oCV.notify_all();
+    if( m_poJobQueue )
+        m_poJobQueue->WaitCompletion();
+    if( m_poShadowDS )
+        GDALClose(GDALDataset::ToHandle(m_poShadowDS));
+    CSLDestroy(m_papszOpenOptions);
+}
+
+/************************************************************************/
+/*                             IsEnabled()                              */
+/************************************************************************/
+
+bool GDALBlockPrefetcher::IsEnabled()
+{
+    return CPLTestBool(
+        CPLGetConfigOption("GDAL_ADVISE_READ_PREFETCH", "NO"));
+}
+
+/************************************************************************/
+/*                              Schedule()                              */
+/************************************************************************/
+
+void GDALBlockPrefetcher::Schedule( const std::vector<int>& anBands,
+                                    int nXBlockStart, int nYBlockStart,
+                                    int nXBlockEnd, int nYBlockEnd )
+{
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if( m_bStop || m_bFailed )
+        return;
+
+    // Enqueue in the order a scanline oriented consumer will request
+    // blocks, interleaving bands so that pixel interleaved files are
+    // read sequentially.
+    for( int iYBlock = nYBlockStart; iYBlock <= nYBlockEnd; ++iYBlock )
+    {
+        for( int iXBlock = nXBlockStart; iXBlock <= nXBlockEnd; ++iXBlock )
+        {
+            for( const int nBand: anBands )
+            {
+                const BlockKey oKey(nBand, iYBlock, iXBlock);
+                if( m_oMapReady.find(oKey) != m_oMapReady.end() ||
+                    (m_bInFlight && m_oInFlight == oKey) ||
+                    !m_oSetQueued.insert(oKey).second )
+                {
+                    continue;
+                }
+                m_aoQueue.push_back(oKey);
+            }
+        }
+    }
+
+    StartJobIfNeeded();
+}
+
+/************************************************************************/
+/*                          StartJobIfNeeded()                          */
+/************************************************************************/
+
+// Must be called with m_oMutex held.
+void GDALBlockPrefetcher::StartJobIfNeeded()
+{
+    if( m_bJobRunning || m_bStop || m_bFailed || m_aoQueue.empty() ||
+        m_nReadyBytes >= m_nMaxReadyBytes )
+    {
+        return;
+    }
+
+    if( !m_poJobQueue )
+    {
+        auto poPool = GDALGetGlobalThreadPool(1);
+        if( poPool == nullptr )
+        {
+            m_bFailed = true;
+            return;
+        }
+        m_poJobQueue = poPool->CreateJobQueue();
+    }
+    m_bJobRunning = true;
+    if( !m_poJobQueue->SubmitJob(JobFunc, this) )
+    {
+        m_bJobRunning = false;
+        m_bFailed = true;
+    }
+}
+
+/************************************************************************/
+/*                              JobFunc()                               */
+/************************************************************************/
+
+void GDALBlockPrefetcher::JobFunc(void* pData)
+{
+    static_cast<GDALBlockPrefetcher*>(pData)->Run();
+}
+
+/************************************************************************/
+/*                                Run()                                 */
+/************************************************************************/
+
+void GDALBlockPrefetcher::Run()
+{
+    if( m_poShadowDS == nullptr )
+    {
+        const char* const apszAllowedDrivers[] = {
+            m_osDriverName.c_str(), nullptr };
+        CPLErrorHandlerPusher oQuietError(CPLQuietErrorHandler);
+        m_poShadowDS = GDALDataset::FromHandle(GDALOpenEx(
+            m_osFilename.c_str(),
+            GDAL_OF_RASTER | GDAL_OF_READONLY | GDAL_OF_INTERNAL,
+            m_osDriverName.empty() ? nullptr : apszAllowedDrivers,
+            m_papszOpenOptions, nullptr));
+        if( m_poShadowDS == nullptr )
+        {
+            CPLDebug("GDAL", "AdviseRead() prefetching disabled for %s: "
+                     "cannot open a second handle", m_osFilename.c_str());
+            std::lock_guard<std::mutex> oLock(m_oMutex);
+            m_bFailed = true;
+            m_bJobRunning = false;
+            m_aoQueue.clear();
+            m_oSetQueued.clear();
+            m_oCV.notify_all();
+            return;
+        }
+    }
+
+    std::vector<GByte> abyBuffer;
+    while( true )
+    {
+        BlockKey oKey;
+        {
+            std::lock_guard<std::mutex> oLock(m_oMutex);
+            if( m_bStop || m_aoQueue.empty() ||
+                m_nReadyBytes >= m_nMaxReadyBytes )
+            {
+                // The job is restarted by TakeBlock() or Schedule() once
+                // there is room or work again.
+                m_bJobRunning = false;
+                m_oCV.notify_all();
+                return;
+            }
+            oKey = m_aoQueue.front();
+            m_aoQueue.pop_front();
+            m_oSetQueued.erase(oKey);
+            m_oInFlight = oKey;
+            m_bInFlight = true;
+        }
+
+        bool bOK = false;
+        GDALRasterBand* poBand =
+            m_poShadowDS->GetRasterBand(std::get<0>(oKey));
+        if( poBand )
+        {
+            int nBlockXSize = 0;
+            int nBlockYSize = 0;
+            poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+            const size_t nBlockBytes = static_cast<size_t>(nBlockXSize) *
+                nBlockYSize *
+                GDALGetDataTypeSizeBytes(poBand->GetRasterDataType());
+            try
+            {
+                abyBuffer.resize(nBlockBytes);
+                CPLErrorHandlerPusher oQuietError(CPLQuietErrorHandler);
+                bOK = poBand->ReadBlock(std::get<2>(oKey), std::get<1>(oKey),
+                                        abyBuffer.data()) == CE_None;
+            }
+            catch( const std::exception& )
+            {
+                bOK = false;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> oLock(m_oMutex);
+            m_bInFlight = false;
+            // On failure, the block is not stored and the consumer will
+            // read it itself, and report the error if there is one.
+            if( bOK && !m_bStop )
+            {
+                m_nReadyBytes += abyBuffer.size();
+                m_oMapReady[oKey] = std::move(abyBuffer);
+                abyBuffer = std::vector<GByte>();
+            }
+        }
+        m_oCV.notify_all();
+    }
+}
+
+/************************************************************************/
+/*                             TakeBlock()                              */
+/************************************************************************/
+
+// Called by the consumer before reading a block itself. Returns true if
+// the block has been prefetched and copied into pData.
+bool GDALBlockPrefetcher::TakeBlock( int nBand, int nXBlockOff, int nYBlockOff,
+                                     void* pData, size_t nBlockBytes )
+{
+    const BlockKey oKey(nBand, nYBlockOff, nXBlockOff);
+    std::unique_lock<std::mutex> oLock(m_oMutex);
+    while( true )
+    {
+        auto oIter = m_oMapReady.find(oKey);
+        if( oIter != m_oMapReady.end() )
+        {
+            const bool bOK = oIter->second.size() == nBlockBytes;
+            if( bOK )
+                memcpy(pData, oIter->second.data(), nBlockBytes);
+            m_nReadyBytes -= oIter->second.size();
+            m_oMapReady.erase(oIter);
+            StartJobIfNeeded();
+            return bOK;
+        }
+
+        // The worker is reading it: wait rather than reading it twice.
+        if( m_bInFlight && m_oInFlight == oKey )
+        {
+            m_oCV.wait(oLock);
+            continue;
+        }
+        break;
+    }
+
+    // Not yet read: the consumer is ahead of the prefetcher, so read it
+    // directly and do not prefetch it.
+    if( m_oSetQueued.erase(oKey) )
+    {
+        m_aoQueue.erase(std::find(m_aoQueue.begin(), m_aoQueue.end(), oKey));
+    }
+    return false;
+}
+
+//! @endcond
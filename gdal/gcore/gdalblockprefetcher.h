@@ -0,0 +1,106 @@
+/******************************************************************************
+ *
+ * Project:  GDAL Core
+ * Purpose:  Background block prefetcher used by the default AdviseRead()
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef GDALBLOCKPREFETCHER_H_INCLUDED
+#define GDALBLOCKPREFETCHER_H_INCLUDED
+
+//! @cond Doxygen_Suppress
+
+#include "cpl_port.h"
+#include "cpl_worker_thread_pool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+class GDALDataset;
+
+/************************************************************************/
+/*                         GDALBlockPrefetcher                          */
+/************************************************************************/
+
+// Reads blocks announced by AdviseRead() in a worker thread of the global
+// thread pool, through a separate read-only handle on the same dataset, so
+// that I/O and decompression overlap with the processing done by the
+// consumer. Prefetched blocks are kept aside until GetLockedBlockRef()
+// claims them, so the block cache of the consumer dataset is only ever
+// manipulated from the consumer thread.
+class GDALBlockPrefetcher
+{
+    CPL_DISALLOW_COPY_ASSIGN(GDALBlockPrefetcher)
+
+    typedef std::tuple<int, int, int> BlockKey; // band, y block, x block
+
+    std::string             m_osFilename;
+    std::string             m_osDriverName;
+    char                  **m_papszOpenOptions = nullptr;
+
+    std::mutex              m_oMutex{};
+    std::condition_variable m_oCV{};
+    std::deque<BlockKey>    m_aoQueue{};
+    std::set<BlockKey>      m_oSetQueued{};
+    std::map<BlockKey, std::vector<GByte>> m_oMapReady{};
+    BlockKey                m_oInFlight{0, 0, 0};
+    bool                    m_bInFlight = false;
+    bool                    m_bJobRunning = false;
+    bool                    m_bStop = false;
+    bool                    m_bFailed = false;
+    size_t                  m_nReadyBytes = 0;
+    size_t                  m_nMaxReadyBytes = 0;
+
+    std::unique_ptr<CPLJobQueue> m_poJobQueue{};
+    GDALDataset            *m_poShadowDS = nullptr;
+
+    static void JobFunc(void* pData);
+    void Run();
+    void StartJobIfNeeded();
+
+  public:
+    GDALBlockPrefetcher(const char* pszFilename,
+                        const char* pszDriverName,
+                        CSLConstList papszOpenOptions);
+    ~GDALBlockPrefetcher();
+
+    static bool IsEnabled();
+
+    void Schedule(const std::vector<int>& anBands,
+                  int nXBlockStart, int nYBlockStart,
+                  int nXBlockEnd, int nYBlockEnd);
+
+    bool TakeBlock(int nBand, int nXBlockOff, int nYBlockOff,
+                   void* pData, size_t nBlockBytes);
+};
+
+//! @endcond
+
+#endif // GDALBLOCKPREFETCHER_H_INCLUDED
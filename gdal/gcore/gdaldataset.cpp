@@ -37,7 +37,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <new>
 #include <set>
 #include <string>
@@ -49,8 +51,12 @@
 #include "cpl_multiproc.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 #include "cpl_vsi_error.h"
+#include "cpl_vsi_virtual.h"
+#include "gdal_perf_counters.h"
+#include "gdalblockprefetcher.h"
 #include "ogr_api.h"
 #include "ogr_attrind.h"
 #include "ogr_core.h"
@@ -125,7 +131,19 @@ class GDALDataset::Private
 
     bool m_bOverviewsEnabled = true;
 
+    // Index of the block cache partition, or -1 for the default pool.
+    int m_nCachePartitionIndex = -1;
+
+    // Background reader of the blocks announced by AdviseRead(), if
+    // GDAL_ADVISE_READ_PREFETCH is enabled.
+    std::unique_ptr<GDALBlockPrefetcher> m_poPrefetcher{};
+
+    // RasterIO() latencies, if enabled. Never freed before the dataset, as
+    // it may be used concurrently.
+    std::atomic<GDALRasterIOLatencyStats*> m_poLatencyStats{nullptr};
+
     Private() = default;
+    ~Private() { delete m_poLatencyStats.load(); }
 };
 
 struct SharedDatasetCtxt
@@ -247,6 +265,8 @@ GDALDataset::GDALDataset(int bForceCachedIOIn):
     bForceCachedIO(CPL_TO_BOOL(bForceCachedIOIn)),
     m_poPrivate(new(std::nothrow) GDALDataset::Private)
 {
+    if( CPLTestBool(CPLGetConfigOption("GDAL_RASTERIO_LATENCY_STATS", "NO")) )
+        EnableRasterIOLatencyStats();
 }
 //! @endcond
 
@@ -337,6 +357,10 @@ GDALDataset::~GDALDataset()
         }
     }
 
+    // Stop background prefetching before the bands go away.
+    if( m_poPrivate )
+        m_poPrivate->m_poPrefetcher.reset();
+
 /* -------------------------------------------------------------------- */
 /*      Destroy the raster bands if they exist.                         */
 /* -------------------------------------------------------------------- */
@@ -2552,6 +2576,9 @@ CPLErr GDALDataset::RasterIO( GDALRWFlag eRWFlag,
 
     int bCallLeaveReadWrite = EnterReadWrite(eRWFlag);
 
+    GDALRasterIOLatencyTimer oLatencyTimer(GetRasterIOLatencyStatsInternal(),
+                                           eRWFlag == GF_Write);
+
 /* -------------------------------------------------------------------- */
 /*      We are being forced to use cached IO instead of a driver        */
 /*      specific implementation.                                        */
@@ -2750,6 +2777,15 @@ int CPL_STDCALL GDALGetAccess( GDALDatasetH hDS )
  * Many drivers just ignore the AdviseRead() call, but it can dramatically
  * accelerate access via some drivers.
  *
+ * For drivers that do not implement it, if the GDAL_ADVISE_READ_PREFETCH
+ * configuration option is set to YES (since GDAL 3.4), the blocks
+ * intersecting a full resolution region are read in a background thread,
+ * through a separate read-only handle on the dataset, and handed over to
+ * the block cache when they are requested. The memory used by blocks
+ * prefetched but not yet requested is limited to a quarter of the block
+ * cache size, or to the value in megabytes of the
+ * GDAL_ADVISE_READ_PREFETCH_MAX_MEM configuration option.
+ *
  * Depending on call paths, drivers might receive several calls to
  * AdviseRead() with the same parameters.
  *
@@ -2803,6 +2839,9 @@ CPLErr GDALDataset::AdviseRead( int nXOff, int nYOff, int nXSize, int nYSize,
     if( eErr != CE_None || bStopProcessing )
         return eErr;
 
+    if( nBufXSize == nXSize && nBufYSize == nYSize )
+        SchedulePrefetch(nXOff, nYOff, nXSize, nYSize, nBandCount, panBandMap);
+
     for( int iBand = 0; iBand < nBandCount; ++iBand )
     {
         GDALRasterBand *poBand = nullptr;
@@ -2825,6 +2864,80 @@ CPLErr GDALDataset::AdviseRead( int nXOff, int nYOff, int nXSize, int nYSize,
     return CE_None;
 }
 
+//! @cond Doxygen_Suppress
+/************************************************************************/
+/*                          SchedulePrefetch()                          */
+/************************************************************************/
+
+// Queue the blocks intersecting the window for background reading, when
+// GDAL_ADVISE_READ_PREFETCH=YES. This is a no-op for datasets that cannot be
+// reopened by name, or that are opened in update mode since a second handle
+// would not see pending modifications.
+void GDALDataset::SchedulePrefetch( int nXOff, int nYOff,
+                                    int nXSize, int nYSize,
+                                    int nBandCount, const int* panBandMap )
+{
+    if( m_poPrivate == nullptr || eAccess != GA_ReadOnly ||
+        GetDescription()[0] == '\0' || poDriver == nullptr ||
+        EQUAL(poDriver->GetDescription(), "MEM") ||
+        !GDALBlockPrefetcher::IsEnabled() )
+    {
+        return;
+    }
+
+    // Group bands that share the same block size, so that they are
+    // prefetched in an interleaved way.
+    std::map<std::pair<int,int>, std::vector<int>> oMapBlockSizeToBands;
+    for( int iBand = 0; iBand < nBandCount; ++iBand )
+    {
+        const int nBand = panBandMap ? panBandMap[iBand] : iBand + 1;
+        GDALRasterBand* poBand = GetRasterBand(nBand);
+        if( poBand == nullptr )
+            return;
+        int nBlockXSize = 0;
+        int nBlockYSize = 0;
+        poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+        if( nBlockXSize <= 0 || nBlockYSize <= 0 )
+            return;
+        oMapBlockSizeToBands[std::pair<int,int>(nBlockXSize, nBlockYSize)].
+            push_back(nBand);
+    }
+
+    if( m_poPrivate->m_poPrefetcher == nullptr )
+    {
+        m_poPrivate->m_poPrefetcher.reset(new GDALBlockPrefetcher(
+            GetDescription(), poDriver->GetDescription(), papszOpenOptions));
+    }
+
+    for( const auto& oIter: oMapBlockSizeToBands )
+    {
+        const int nBlockXSize = oIter.first.first;
+        const int nBlockYSize = oIter.first.second;
+        m_poPrivate->m_poPrefetcher->Schedule(
+            oIter.second,
+            nXOff / nBlockXSize, nYOff / nBlockYSize,
+            (nXOff + nXSize - 1) / nBlockXSize,
+            (nYOff + nYSize - 1) / nBlockYSize);
+    }
+}
+
+/************************************************************************/
+/*                        TakePrefetchedBlock()                         */
+/************************************************************************/
+
+// Called by GDALRasterBand::GetLockedBlockRef() before IReadBlock().
+bool GDALDataset::TakePrefetchedBlock( int nBand,
+                                       int nXBlockOff, int nYBlockOff,
+                                       void* pData, size_t nBlockBytes )
+{
+    if( m_poPrivate == nullptr || m_poPrivate->m_poPrefetcher == nullptr )
+        return false;
+    return m_poPrivate->m_poPrefetcher->TakeBlock(nBand, nXBlockOff,
+                                                  nYBlockOff, pData,
+                                                  nBlockBytes);
+}
+//! @endcond
+
 /************************************************************************/
 /*                       GDALDatasetAdviseRead()                        */
 /************************************************************************/
@@ -2849,6 +2962,99 @@ GDALDatasetAdviseRead( GDALDatasetH hDS,
                      nBandCount, panBandMap, const_cast<char**>(papszOptions));
 }
 
+/************************************************************************/
+/*                           RasterIOBatch()                            */
+/************************************************************************/
+
+/**
+ * \brief Read several windows of the dataset in a single call.
+ *
+ * This is equivalent to calling RasterIO() in read mode for each window,
+ * but gives the driver the opportunity to collect the blocks needed by all
+ * windows first, for example to fetch them from a remote file system with a
+ * single multi-range request.
+ *
+ * The default implementation just calls RasterIO() for each window. The
+ * GTiff driver overrides it to prefetch all the needed strips or tiles when
+ * the file is accessed through /vsicurl/ or similar network file systems.
+ *
+ * @param nWindowCount number of windows in pasWindows.
+ *
+ * @param pasWindows array of nWindowCount windows, each with its own buffer,
+ * buffer size and spacings. See RasterIO() for the meaning of the members.
+ *
+ * @param eBufType the type of the pixel values in the buffers.
+ *
+ * @param nBandCount the number of bands being read.
+ *
+ * @param panBandMap the list of nBandCount band numbers being read.
+ * Note band numbers are 1 based. This may be NULL to select the first
+ * nBandCount bands.
+ *
+ * @param papszOptions a list of name=value strings with special control
+ * options. Normally this is NULL.
+ *
+ * @return CE_Failure if the access fails for one of the windows, otherwise
+ * CE_None.
+ *
+ * @since GDAL 3.4
+ */
+
+CPLErr GDALDataset::RasterIOBatch( int nWindowCount,
+                                   const GDALRasterIOWindow* pasWindows,
+                                   GDALDataType eBufType,
+                                   int nBandCount, const int *panBandMap,
+                                   CSLConstList /* papszOptions */ )
+{
+    if( nWindowCount < 0 || (nWindowCount > 0 && pasWindows == nullptr) )
+    {
+        ReportError( CE_Failure, CPLE_IllegalArg,
+                     "Invalid window list in RasterIOBatch()" );
+        return CE_Failure;
+    }
+
+    for( int i = 0; i < nWindowCount; ++i )
+    {
+        const GDALRasterIOWindow& sWindow = pasWindows[i];
+        const CPLErr eErr = RasterIO(
+            GF_Read, sWindow.nXOff, sWindow.nYOff,
+            sWindow.nXSize, sWindow.nYSize,
+            sWindow.pData, sWindow.nBufXSize, sWindow.nBufYSize,
+            eBufType, nBandCount, const_cast<int*>(panBandMap),
+            sWindow.nPixelSpace, sWindow.nLineSpace, sWindow.nBandSpace,
+            nullptr );
+        if( eErr != CE_None )
+            return eErr;
+    }
+
+    return CE_None;
+}
+
+/************************************************************************/
+/*                      GDALDatasetRasterIOBatch()                      */
+/************************************************************************/
+
+/**
+ * \brief Read several windows of the dataset in a single call.
+ *
+ * @see GDALDataset::RasterIOBatch()
+ * @since GDAL 3.4
+ */
+CPLErr GDALDatasetRasterIOBatch( GDALDatasetH hDS,
+                                 int nWindowCount,
+                                 const GDALRasterIOWindow* pasWindows,
+                                 GDALDataType eBufType,
+                                 int nBandCount, const int *panBandMap,
+                                 CSLConstList papszOptions )
+
+{
+    VALIDATE_POINTER1(hDS, "GDALDatasetRasterIOBatch", CE_Failure);
+
+    return GDALDataset::FromHandle(hDS)->RasterIOBatch(
+        nWindowCount, pasWindows, eBufType, nBandCount, panBandMap,
+        papszOptions);
+}
+
 /************************************************************************/
 /*                         AntiRecursionStruct                          */
 /************************************************************************/
@@ -3193,6 +3399,13 @@ GDALOpen( const char * pszFilename, GDALAccess eAccess )
  * parent directory. If the target object does not have filesystem semantics
  * then the file list should be NULL.
  *
+ * Drivers are normally probed in their registration order. Starting with
+ * GDAL 3.4, when the GDAL_OPEN_PRIORITIZE_EXTENSION configuration option is
+ * set to YES, the drivers that declare the extension of pszFilename in their
+ * GDAL_DMD_EXTENSIONS metadata item are probed first, and the other ones
+ * afterwards. This speeds up opening when many drivers are registered, but
+ * may change the driver selected for files that several drivers can open.
+ *
  * @param pszFilename the name of the file to access.  In the case of
  * exotic drivers this may not refer to a physical file, but instead contain
  * information for the driver on how to access a dataset.  It should be in UTF-8
@@ -3238,6 +3451,9 @@ GDALOpen( const char * pszFilename, GDALAccess eAccess )
  * that it may not cause a warning if the driver doesn't declare this option.
  * Starting with GDAL 3.3, OVERVIEW_LEVEL=NONE is supported to indicate that
  * no overviews should be exposed.
+ * Starting with GDAL 3.4, the CACHE_PARTITION=name open option, also available
+ * for all drivers, can be used to assign the dataset to a block cache
+ * partition (see GDALDataset::SetCachePartition()).
  *
  * @param papszSiblingFiles NULL, or a NULL terminated list of strings that are
  * filenames that are auxiliary to the main filename. If NULL is passed, a
@@ -3351,10 +3567,42 @@ GDALDatasetH CPL_STDCALL GDALOpenEx( const char *pszFilename,
         OGRAPISpyOpenTakeSnapshot(pszFilename, bUpdate) : INT_MIN;
 #endif
 
-    const int nDriverCount = poDM->GetDriverCount();
-    for( int iDriver = 0; iDriver < nDriverCount; ++iDriver )
-    {
-        GDALDriver *poDriver = poDM->GetDriver(iDriver);
+    // Only drivers that can open a dataset of the requested kind are probed.
+    // Optionally, the ones declaring the extension of the file come first.
+    const bool bPrioritizeExtension = CPLTestBool(
+        CPLGetConfigOption("GDAL_OPEN_PRIORITIZE_EXTENSION", "NO"));
+    const CPLString osExtension(
+        bPrioritizeExtension ? CPLGetExtension(pszFilename) : "");
+    const char* pszExtensionToPrioritize =
+        bPrioritizeExtension ? osExtension.c_str() : nullptr;
+    std::vector<GDALDriver*> apoCandidateDrivers =
+        poDM->GetOpenCandidates(nOpenFlags, pszExtensionToPrioritize);
+    bool bDeferredPluginsLoaded = false;
+    for( size_t iCandidate = 0; ; ++iCandidate )
+    {
+        if( iCandidate == apoCandidateDrivers.size() )
+        {
+            // Drivers of plugins whose loading has been deferred are probed
+            // when no registered driver could open the dataset.
+            if( bDeferredPluginsLoaded || !poDM->LoadDeferredPlugins() )
+                break;
+            bDeferredPluginsLoaded = true;
+            for( GDALDriver* poNewDriver:
+                    poDM->GetOpenCandidates(nOpenFlags,
+                                            pszExtensionToPrioritize) )
+            {
+                if( std::find(apoCandidateDrivers.begin(),
+                              apoCandidateDrivers.end(), poNewDriver) ==
+                        apoCandidateDrivers.end() )
+                {
+                    apoCandidateDrivers.push_back(poNewDriver);
+                }
+            }
+            if( iCandidate == apoCandidateDrivers.size() )
+                break;
+        }
+
+        GDALDriver *poDriver = apoCandidateDrivers[iCandidate];
         if (papszAllowedDrivers != nullptr &&
             CSLFindString(papszAllowedDrivers,
                             GDALGetDriverShortName(poDriver)) == -1)
@@ -3362,44 +3610,44 @@ GDALDatasetH CPL_STDCALL GDALOpenEx( const char *pszFilename,
             continue;
         }
 
-        if( (nOpenFlags & GDAL_OF_RASTER) != 0 &&
-            (nOpenFlags & GDAL_OF_VECTOR) == 0 &&
-            poDriver->GetMetadataItem(GDAL_DCAP_RASTER) == nullptr )
-            continue;
-        if( (nOpenFlags & GDAL_OF_VECTOR) != 0 &&
-            (nOpenFlags & GDAL_OF_RASTER) == 0 &&
-            poDriver->GetMetadataItem(GDAL_DCAP_VECTOR) == nullptr )
-            continue;
-        if( (nOpenFlags & GDAL_OF_MULTIDIM_RASTER) != 0 &&
-            (nOpenFlags & GDAL_OF_RASTER) == 0 &&
-            poDriver->GetMetadataItem(GDAL_DCAP_MULTIDIM_RASTER) == nullptr )
-            continue;
         if( poDriver->pfnOpen == nullptr &&
             poDriver->pfnOpenWithDriverArg == nullptr )
         {
             continue;
         }
 
-        // Remove general OVERVIEW_LEVEL open options from list before passing
-        // it to the driver, if it isn't a driver specific option already.
+        // Remove general OVERVIEW_LEVEL and CACHE_PARTITION open options from
+        // list before passing it to the driver, if it isn't a driver specific
+        // option already.
         char **papszTmpOpenOptions = nullptr;
         char **papszTmpOpenOptionsToValidate = nullptr;
         char **papszOptionsToValidate = const_cast<char **>(papszOpenOptions);
-        if( CSLFetchNameValue(papszOpenOptionsCleaned, "OVERVIEW_LEVEL") !=
-               nullptr &&
-            (poDriver->GetMetadataItem(GDAL_DMD_OPENOPTIONLIST) == nullptr ||
-             CPLString(poDriver->GetMetadataItem(GDAL_DMD_OPENOPTIONLIST))
-                    .ifind("OVERVIEW_LEVEL") == std::string::npos) )
+        for( const char* pszGenericOption: { "OVERVIEW_LEVEL",
+                                             "CACHE_PARTITION" } )
         {
-            papszTmpOpenOptions = CSLDuplicate(papszOpenOptionsCleaned);
-            papszTmpOpenOptions =
-                CSLSetNameValue(papszTmpOpenOptions, "OVERVIEW_LEVEL", nullptr);
-            oOpenInfo.papszOpenOptions = papszTmpOpenOptions;
-
-            papszOptionsToValidate = CSLDuplicate(papszOptionsToValidate);
-            papszOptionsToValidate =
-                CSLSetNameValue(papszOptionsToValidate, "OVERVIEW_LEVEL", nullptr);
-            papszTmpOpenOptionsToValidate = papszOptionsToValidate;
+            if( CSLFetchNameValue(papszOpenOptionsCleaned, pszGenericOption) !=
+                   nullptr &&
+                (poDriver->GetMetadataItem(GDAL_DMD_OPENOPTIONLIST) == nullptr ||
+                 CPLString(poDriver->GetMetadataItem(GDAL_DMD_OPENOPTIONLIST))
+                        .ifind(pszGenericOption) == std::string::npos) )
+            {
+                if( papszTmpOpenOptions == nullptr )
+                {
+                    papszTmpOpenOptions = CSLDuplicate(papszOpenOptionsCleaned);
+                    papszOptionsToValidate =
+                        CSLDuplicate(papszOptionsToValidate);
+                    papszTmpOpenOptionsToValidate = papszOptionsToValidate;
+                }
+                papszTmpOpenOptions =
+                    CSLSetNameValue(papszTmpOpenOptions, pszGenericOption,
+                                    nullptr);
+                oOpenInfo.papszOpenOptions = papszTmpOpenOptions;
+
+                papszOptionsToValidate =
+                    CSLSetNameValue(papszOptionsToValidate, pszGenericOption,
+                                    nullptr);
+                papszTmpOpenOptionsToValidate = papszOptionsToValidate;
+            }
         }
 
         const bool bIdentifyRes =
@@ -3492,6 +3740,17 @@ GDALDatasetH CPL_STDCALL GDALOpenEx( const char *pszFilename,
                 }
             }
 
+            // Deal with generic CACHE_PARTITION open option, unless it is
+            // driver specific.
+            if( CSLFetchNameValue(papszOpenOptions, "CACHE_PARTITION") != nullptr &&
+                (poDriver->GetMetadataItem(GDAL_DMD_OPENOPTIONLIST) == nullptr ||
+                CPLString(poDriver->GetMetadataItem(GDAL_DMD_OPENOPTIONLIST))
+                        .ifind("CACHE_PARTITION") == std::string::npos) )
+            {
+                poDS->SetCachePartition(
+                    CSLFetchNameValue(papszOpenOptions, "CACHE_PARTITION"));
+            }
+
             // Deal with generic OVERVIEW_LEVEL open option, unless it is
             // driver specific.
             if( CSLFetchNameValue(papszOpenOptions, "OVERVIEW_LEVEL") != nullptr &&
@@ -3576,7 +3835,7 @@ GDALDatasetH CPL_STDCALL GDALOpenEx( const char *pszFilename,
         // If not, return a more generic error.
         if(!VSIToCPLError(CE_Failure, CPLE_OpenFailed))
         {
-            if( nDriverCount == 0 )
+            if( poDM->GetDriverCount() == 0 )
             {
                 CPLError(CE_Failure, CPLE_OpenFailed,
                          "No driver registered.");
@@ -3794,6 +4053,98 @@ int CPL_STDCALL GDALDumpOpenDatasets( FILE *fp )
     return static_cast<int>(poAllDatasetMap->size());
 }
 
+/************************************************************************/
+/*                     GDALGetMemoryUsageSummary()                      */
+/************************************************************************/
+
+/**
+ * \brief Return a process-wide summary of the memory used by GDAL.
+ *
+ * The following keys are returned, values being in bytes unless stated
+ * otherwise:
+ * <ul>
+ * <li>BLOCK_CACHE_USED and BLOCK_CACHE_MAX: current and maximum size of the
+ * block cache (see GDALGetCacheUsed64() and GDALGetCacheMax64())</li>
+ * <li>DATASET_COUNT: number of open datasets</li>
+ * <li>DATASETS_BLOCK_CACHE and DATASETS_DRIVER: sum of the block cache and
+ * driver shares of the open datasets
+ * (see GDALDataset::GetMemoryUsage())</li>
+ * <li>DRIVER_xxx: sum of the memory used by the open datasets of driver
+ * xxx</li>
+ * <li>VSICURL_REGION_CACHE: in-memory region caches of /vsicurl/ and related
+ * network file systems</li>
+ * <li>VSIMEM: content of /vsimem/ files</li>
+ * <li>TOTAL: sum of BLOCK_CACHE_USED, DATASETS_DRIVER, VSICURL_REGION_CACHE
+ * and VSIMEM</li>
+ * </ul>
+ *
+ * Values are approximate. Memory allocated by third-party libraries for
+ * their own purposes, or by the application, is not included.
+ *
+ * This function may be called from any thread, but datasets must not be
+ * closed while it runs.
+ *
+ * @return a list of NAME=VALUE strings to free with CSLDestroy().
+ * @since GDAL 3.4
+ */
+
+char** GDALGetMemoryUsageSummary()
+{
+    CPLStringList aosList;
+    const GIntBig nBlockCacheUsed = GDALGetCacheUsed64();
+    aosList.SetNameValue("BLOCK_CACHE_USED",
+                         CPLSPrintf(CPL_FRMT_GIB, nBlockCacheUsed));
+    aosList.SetNameValue("BLOCK_CACHE_MAX",
+                         CPLSPrintf(CPL_FRMT_GIB, GDALGetCacheMax64()));
+
+    int nDatasets = 0;
+    GIntBig nDatasetsBlockCache = 0;
+    GIntBig nDatasetsDriver = 0;
+    std::map<CPLString, GIntBig> oMapDriverUsage;
+    {
+        CPLMutexHolderD(&hDLMutex);
+        if( poAllDatasetMap )
+        {
+            for( const auto& oIter: *poAllDatasetMap )
+            {
+                GDALDataset* poDS = oIter.first;
+                GIntBig nBlockCacheBytes = 0;
+                GIntBig nDriverBytes = 0;
+                const GIntBig nBytes =
+                    poDS->GetMemoryUsage(&nBlockCacheBytes, &nDriverBytes);
+                ++nDatasets;
+                nDatasetsBlockCache += nBlockCacheBytes;
+                nDatasetsDriver += nDriverBytes;
+                const char* pszDriverName =
+                    poDS->GetDriver() ? poDS->GetDriver()->GetDescription() :
+                                        "UNKNOWN";
+                oMapDriverUsage[pszDriverName] += nBytes;
+            }
+        }
+    }
+    aosList.SetNameValue("DATASET_COUNT", CPLSPrintf("%d", nDatasets));
+    aosList.SetNameValue("DATASETS_BLOCK_CACHE",
+                         CPLSPrintf(CPL_FRMT_GIB, nDatasetsBlockCache));
+    aosList.SetNameValue("DATASETS_DRIVER",
+                         CPLSPrintf(CPL_FRMT_GIB, nDatasetsDriver));
+    for( const auto& oIter: oMapDriverUsage )
+    {
+        aosList.SetNameValue(("DRIVER_" + oIter.first).c_str(),
+                             CPLSPrintf(CPL_FRMT_GIB, oIter.second));
+    }
+
+    const GIntBig nRegionCache = VSICurlGetRegionCacheMemoryUsage();
+    aosList.SetNameValue("VSICURL_REGION_CACHE",
+                         CPLSPrintf(CPL_FRMT_GIB, nRegionCache));
+    const GIntBig nVSIMem = VSIMemGetMemoryUsage();
+    aosList.SetNameValue("VSIMEM", CPLSPrintf(CPL_FRMT_GIB, nVSIMem));
+
+    aosList.SetNameValue("TOTAL",
+        CPLSPrintf(CPL_FRMT_GIB,
+                   nBlockCacheUsed + nDatasetsDriver + nRegionCache + nVSIMem));
+    return aosList.StealList();
+}
+
 /************************************************************************/
 /*                        BeginAsyncReader()                            */
 /************************************************************************/
@@ -6179,6 +6530,21 @@ GDALDataset::ExecuteSQL( const char *pszStatement,
                          swq_select_parse_options *poSelectParseOptions )
 
 {
+    CPLTraceSpan oSpan("ogr", "GDALDataset::ExecuteSQL");
+    if( oSpan.IsActive() )
+    {
+        oSpan.AddArg("statement", pszStatement);
+        if( pszDialect )
+            oSpan.AddArg("dialect", pszDialect);
+    }
+
+    // Time to prepare the statement: for most dialects, the evaluation
+    // happens afterwards, when iterating over the result layer.
+    GDAL_PERF_COUNTER(poStatementsCounter, "GDAL.sql_statements");
+    GDAL_PERF_COUNTER(poTimeCounter, "GDAL.sql_prepare_time_ns");
+    poStatementsCounter->Increment();
+    GDALPerfCounterTimer oTimer(poTimeCounter);
+
     if( pszDialect != nullptr && EQUAL(pszDialect, "SQLite") )
     {
 #ifdef SQLITE_ENABLED
@@ -8438,3 +8804,406 @@ bool GDALDataset::AreOverviewsEnabled() const
 }
 
 //! @endcond
+
+/************************************************************************/
+/*                         SetCachePartition()                          */
+/************************************************************************/
+
+/**
+ * \brief Assign the dataset to a named block cache partition.
+ *
+ * Blocks of the raster bands of this dataset will be cached in the
+ * specified partition, which must have been created beforehand with
+ * GDALSetCachePartitionMax(), instead of in the default pool controlled by
+ * GDAL_CACHEMAX. This allows to prevent a dataset from evicting the cached
+ * blocks of other datasets.
+ *
+ * The cache of the dataset is flushed before changing its partition.
+ *
+ * Note that overview datasets are independent datasets, and thus are not
+ * affected by this call.
+ *
+ * The partition may also be specified with the CACHE_PARTITION open option,
+ * which is recognized by all raster drivers.
+ *
+ * This method is the same as the C function GDALDatasetSetCachePartition().
+ *
+ * @param pszName Partition name, or NULL (or empty string) to assign the
+ *                dataset to the default pool.
+ * @return CE_None in case of success.
+ * @since GDAL 3.4
+ */
+
+CPLErr GDALDataset::SetCachePartition( const char* pszName )
+{
+    int nIndex = -1;
+    if( pszName != nullptr && pszName[0] != '\0' )
+    {
+        nIndex = GDALGetCachePartitionIndex(pszName);
+        if( nIndex < 0 )
+        {
+            ReportError(CE_Failure, CPLE_AppDefined,
+                        "Cache partition %s does not exist. It must be "
+                        "created with GDALSetCachePartitionMax()", pszName);
+            return CE_Failure;
+        }
+    }
+    if( m_poPrivate == nullptr )
+        return CE_Failure;
+    if( nIndex == m_poPrivate->m_nCachePartitionIndex )
+        return CE_None;
+
+    // Blocks already cached are attached to the LRU list of the previous
+    // partition, so evict them.
+    FlushCache();
+    for( int i = 0; i < nBands; ++i )
+    {
+        GDALRasterBand* poBand = papoBands[i];
+        if( poBand->poBandBlockCache &&
+            poBand->poBandBlockCache->IsInitOK() )
+        {
+            poBand->poBandBlockCache->FlushCache();
+        }
+    }
+
+    m_poPrivate->m_nCachePartitionIndex = nIndex;
+    return CE_None;
+}
+
+/************************************************************************/
+/*                         GetCachePartition()                          */
+/************************************************************************/
+
+/**
+ * \brief Return the name of the block cache partition of the dataset.
+ *
+ * @return the partition name, or NULL if the dataset uses the default pool.
+ * @since GDAL 3.4
+ */
+
+const char* GDALDataset::GetCachePartition() const
+{
+    return GDALGetCachePartitionName(GetCachePartitionIndex());
+}
+
+//! @cond Doxygen_Suppress
+/************************************************************************/
+/*                        GetCachePartitionIndex()                      */
+/************************************************************************/
+
+int GDALDataset::GetCachePartitionIndex() const
+{
+    return m_poPrivate ? m_poPrivate->m_nCachePartitionIndex : -1;
+}
+//! @endcond
+
+/************************************************************************/
+/*                     GDALDatasetSetCachePartition()                   */
+/************************************************************************/
+
+/**
+ * \brief Assign the dataset to a named block cache partition.
+ *
+ * @see GDALDataset::SetCachePartition()
+ * @since GDAL 3.4
+ */
+
+CPLErr CPL_STDCALL GDALDatasetSetCachePartition( GDALDatasetH hDS,
+                                                 const char* pszName )
+{
+    VALIDATE_POINTER1( hDS, "GDALDatasetSetCachePartition", CE_Failure );
+
+    return GDALDataset::FromHandle(hDS)->SetCachePartition(pszName);
+}
+
+/************************************************************************/
+/*                     EnableRasterIOLatencyStats()                     */
+/************************************************************************/
+
+/**
+ * \brief Start collecting RasterIO() latency statistics on this dataset.
+ *
+ * Once enabled, the duration of each GDALDataset::RasterIO() and
+ * GDALRasterBand::RasterIO() call on the dataset is added to a histogram.
+ * Reads that needed at least one call to the driver's IReadBlock() (block
+ * cache misses) are separated from the other reads (block cache hits, or
+ * drivers that do not go through the block cache), and for the former, the
+ * time spent in IReadBlock() is also recorded, so that the driver time can
+ * be told apart from the overhead of the block cache and of the data type
+ * conversions. Writes are recorded in a separate histogram.
+ *
+ * Statistics are enabled for all datasets when the
+ * GDAL_RASTERIO_LATENCY_STATS configuration option is set to YES.
+ * Once enabled, they cannot be disabled.
+ *
+ * This method is the same as the C function
+ * GDALDatasetEnableRasterIOLatencyStats().
+ *
+ * @see GetRasterIOLatencyStats()
+ * @since GDAL 3.4
+ */
+
+void GDALDataset::EnableRasterIOLatencyStats()
+{
+    if( m_poPrivate == nullptr ||
+        m_poPrivate->m_poLatencyStats.load() != nullptr )
+        return;
+    auto poStats = new GDALRasterIOLatencyStats();
+    GDALRasterIOLatencyStats* poExpected = nullptr;
+    if( !m_poPrivate->m_poLatencyStats.compare_exchange_strong(poExpected,
+                                                               poStats) )
+    {
+        delete poStats;
+    }
+}
+
+/************************************************************************/
+/*                      GetRasterIOLatencyStats()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the RasterIO() latency statistics of this dataset.
+ *
+ * For each of the HIT (reads without IReadBlock() call), MISS (reads with
+ * IReadBlock() calls), MISS_READ_BLOCK (time spent in IReadBlock() by each
+ * MISS read) and WRITE categories, the following keys are returned,
+ * durations being in microseconds:
+ * <ul>
+ * <li>X_COUNT: number of calls</li>
+ * <li>X_TOTAL_US, X_MEAN_US and X_MAX_US: total, mean and maximum
+ * durations</li>
+ * <li>X_P50_US, X_P90_US and X_P99_US: estimated 50th, 90th and 99th
+ * percentiles</li>
+ * <li>X_HISTOGRAM: comma-separated number of calls whose duration is in
+ * [0,1[, [1,2[, [2,4[, [4,8[ ... microseconds</li>
+ * </ul>
+ * MISS_BLOCKS_READ is the number of blocks read by MISS reads.
+ *
+ * This method is the same as the C function
+ * GDALDatasetGetRasterIOLatencyStats().
+ *
+ * @return a list of NAME=VALUE strings to free with CSLDestroy(), or NULL if
+ * statistics are not enabled.
+ * @see EnableRasterIOLatencyStats()
+ * @since GDAL 3.4
+ */
+
+char** GDALDataset::GetRasterIOLatencyStats() const
+{
+    const GDALRasterIOLatencyStats* poStats =
+        GetRasterIOLatencyStatsInternal();
+    if( poStats == nullptr )
+        return nullptr;
+    CPLStringList aosList;
+    poStats->oHit.Report(aosList, "HIT");
+    poStats->oMiss.Report(aosList, "MISS");
+    poStats->oMissReadBlock.Report(aosList, "MISS_READ_BLOCK");
+    aosList.SetNameValue("MISS_BLOCKS_READ",
+                         CPLSPrintf(CPL_FRMT_GIB, poStats->nBlocksRead.load()));
+    poStats->oWrite.Report(aosList, "WRITE");
+    return aosList.StealList();
+}
+
+/************************************************************************/
+/*                     ResetRasterIOLatencyStats()                      */
+/************************************************************************/
+
+/**
+ * \brief Reset the RasterIO() latency statistics of this dataset.
+ *
+ * This method is the same as the C function
+ * GDALDatasetResetRasterIOLatencyStats().
+ *
+ * @since GDAL 3.4
+ */
+
+void GDALDataset::ResetRasterIOLatencyStats()
+{
+    GDALRasterIOLatencyStats* poStats = GetRasterIOLatencyStatsInternal();
+    if( poStats )
+        poStats->Reset();
+}
+
+//! @cond Doxygen_Suppress
+/************************************************************************/
+/*                  GetRasterIOLatencyStatsInternal()                   */
+/************************************************************************/
+
+GDALRasterIOLatencyStats* GDALDataset::GetRasterIOLatencyStatsInternal() const
+{
+    return m_poPrivate ?
+        m_poPrivate->m_poLatencyStats.load(std::memory_order_acquire) :
+        nullptr;
+}
+//! @endcond
+
+/************************************************************************/
+/*                GDALDatasetEnableRasterIOLatencyStats()               */
+/************************************************************************/
+
+/**
+ * \brief Start collecting RasterIO() latency statistics on a dataset.
+ *
+ * @see GDALDataset::EnableRasterIOLatencyStats()
+ * @since GDAL 3.4
+ */
+
+void GDALDatasetEnableRasterIOLatencyStats( GDALDatasetH hDS )
+{
+    VALIDATE_POINTER0( hDS, "GDALDatasetEnableRasterIOLatencyStats" );
+
+    GDALDataset::FromHandle(hDS)->EnableRasterIOLatencyStats();
+}
+
+/************************************************************************/
+/*                 GDALDatasetGetRasterIOLatencyStats()                 */
+/************************************************************************/
+
+/**
+ * \brief Return the RasterIO() latency statistics of a dataset.
+ *
+ * @see GDALDataset::GetRasterIOLatencyStats()
+ * @since GDAL 3.4
+ */
+
+char** GDALDatasetGetRasterIOLatencyStats( GDALDatasetH hDS )
+{
+    VALIDATE_POINTER1( hDS, "GDALDatasetGetRasterIOLatencyStats", nullptr );
+
+    return GDALDataset::FromHandle(hDS)->GetRasterIOLatencyStats();
+}
+
+/************************************************************************/
+/*                GDALDatasetResetRasterIOLatencyStats()                */
+/************************************************************************/
+
+/**
+ * \brief Reset the RasterIO() latency statistics of a dataset.
+ *
+ * @see GDALDataset::ResetRasterIOLatencyStats()
+ * @since GDAL 3.4
+ */
+
+void GDALDatasetResetRasterIOLatencyStats( GDALDatasetH hDS )
+{
+    VALIDATE_POINTER0( hDS, "GDALDatasetResetRasterIOLatencyStats" );
+
+    GDALDataset::FromHandle(hDS)->ResetRasterIOLatencyStats();
+}
+
+/************************************************************************/
+/*                           GetMemoryUsage()                           */
+/************************************************************************/
+
+/**
+ * \brief Return an estimate of the memory owned by this dataset.
+ *
+ * The returned value is the sum of the share of the global block cache
+ * used by the bands of the dataset (see GetBlockCacheMemoryUsage()) and of
+ * the buffers and caches owned by the driver and the layers (see
+ * GetDriverMemoryUsage()). It is approximate and meant for capacity planning
+ * and diagnostics.
+ *
+ * This method is the same as the C function GDALDatasetGetMemoryUsage().
+ *
+ * @param pnBlockCacheBytes Pointer to a variable receiving the block cache
+ * share, or NULL.
+ * @param pnDriverBytes Pointer to a variable receiving the driver share, or
+ * NULL.
+ * @return number of bytes.
+ * @since GDAL 3.4
+ */
+
+GIntBig GDALDataset::GetMemoryUsage( GIntBig* pnBlockCacheBytes,
+                                     GIntBig* pnDriverBytes )
+{
+    const GIntBig nBlockCacheBytes = GetBlockCacheMemoryUsage();
+    const GIntBig nDriverBytes = GetDriverMemoryUsage();
+    if( pnBlockCacheBytes )
+        *pnBlockCacheBytes = nBlockCacheBytes;
+    if( pnDriverBytes )
+        *pnDriverBytes = nDriverBytes;
+    return nBlockCacheBytes + nDriverBytes;
+}
+
+/************************************************************************/
+/*                      GetBlockCacheMemoryUsage()                      */
+/************************************************************************/
+
+/**
+ * \brief Return the number of bytes of the block cache used by the bands of
+ * this dataset.
+ *
+ * Overview and mask bands are only taken into account when the driver
+ * reports them in GetDriverMemoryUsage().
+ *
+ * @return number of bytes.
+ * @since GDAL 3.4
+ */
+
+GIntBig GDALDataset::GetBlockCacheMemoryUsage()
+{
+    GIntBig nTotal = 0;
+    for( int i = 0; i < nBands; ++i )
+    {
+        GDALCacheStatistics sStats;
+        papoBands[i]->GetCacheStatistics(&sStats);
+        nTotal += sStats.nBytesResident;
+    }
+    return nTotal;
+}
+
+/************************************************************************/
+/*                        GetDriverMemoryUsage()                        */
+/************************************************************************/
+
+/**
+ * \brief Return an estimate of the memory owned by the driver for this
+ * dataset, outside of the block cache.
+ *
+ * Drivers may override this method to report their buffers and caches
+ * (decompression buffers, node indexes, database page caches...) as well
+ * as the memory of the overview and mask datasets they own. Files created
+ * in /vsimem/ are not included, as they are reported process-wide by
+ * GDALGetMemoryUsageSummary().
+ *
+ * The default implementation returns the sum of OGRLayer::GetMemoryUsage()
+ * over the layers of the dataset.
+ *
+ * @return number of bytes.
+ * @since GDAL 3.4
+ */
+
+GIntBig GDALDataset::GetDriverMemoryUsage()
+{
+    GIntBig nTotal = 0;
+    const int nLayers = GetLayerCount();
+    for( int i = 0; i < nLayers; ++i )
+    {
+        OGRLayer* poLayer = GetLayer(i);
+        if( poLayer )
+            nTotal += poLayer->GetMemoryUsage();
+    }
+    return nTotal;
+}
+
+/************************************************************************/
+/*                     GDALDatasetGetMemoryUsage()                      */
+/************************************************************************/
+
+/**
+ * \brief Return an estimate of the memory owned by a dataset.
+ *
+ * @see GDALDataset::GetMemoryUsage()
+ * @since GDAL 3.4
+ */
+
+GIntBig GDALDatasetGetMemoryUsage( GDALDatasetH hDS,
+                                   GIntBig* pnBlockCacheBytes,
+                                   GIntBig* pnDriverBytes )
+{
+    VALIDATE_POINTER1( hDS, "GDALDatasetGetMemoryUsage", 0 );
+
+    return GDALDataset::FromHandle(hDS)->GetMemoryUsage(pnBlockCacheBytes,
+                                                        pnDriverBytes);
+}
@@ -623,6 +623,9 @@ GDALDefaultOverviews::BuildOverviews(
     if( pfnProgress == nullptr )
         pfnProgress = GDALDummyProgress;
 
+    // An overview file is going to be created or removed.
+    GDALClearSiblingFilesCache(CPLGetDirname(poDS->GetDescription()));
+
     if( nOverviews == 0 )
         return CleanOverviews();
 
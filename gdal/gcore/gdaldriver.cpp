@@ -159,6 +159,8 @@ GDALDataset * GDALDriver::Create( const char * pszFilename,
                                   GDALDataType eType, char ** papszOptions )
 
 {
+    GDALClearSiblingFilesCache(CPLGetDirname(pszFilename));
+
 /* -------------------------------------------------------------------- */
 /*      Does this format support creation.                              */
 /* -------------------------------------------------------------------- */
@@ -949,6 +951,8 @@ GDALDataset *GDALDriver::CreateCopy( const char * pszFilename,
     if( pfnProgress == nullptr )
         pfnProgress = GDALDummyProgress;
 
+    GDALClearSiblingFilesCache(CPLGetDirname(pszFilename));
+
 /* -------------------------------------------------------------------- */
 /*      Make sure we cleanup if there is an existing dataset of this    */
 /*      name.  But even if that seems to fail we will continue since    */
@@ -1207,6 +1211,8 @@ CPLErr GDALDriver::QuietDelete( const char *pszName,
 CPLErr GDALDriver::Delete( const char * pszFilename )
 
 {
+    GDALClearSiblingFilesCache(CPLGetDirname(pszFilename));
+
     if( pfnDelete != nullptr )
         return pfnDelete( pszFilename );
     else if( pfnDeleteDataSource != nullptr )
@@ -1382,6 +1388,9 @@ CPLErr GDALDriver::DefaultRename( const char * pszNewName,
 CPLErr GDALDriver::Rename( const char * pszNewName, const char *pszOldName )
 
 {
+    GDALClearSiblingFilesCache(CPLGetDirname(pszNewName));
+    GDALClearSiblingFilesCache(CPLGetDirname(pszOldName));
+
     if( pfnRename != nullptr )
         return pfnRename( pszNewName, pszOldName );
 
@@ -1507,6 +1516,8 @@ CPLErr GDALDriver::DefaultCopyFiles( const char *pszNewName,
 CPLErr GDALDriver::CopyFiles( const char *pszNewName, const char *pszOldName )
 
 {
+    GDALClearSiblingFilesCache(CPLGetDirname(pszNewName));
+
     if( pfnCopyFiles != nullptr )
         return pfnCopyFiles( pszNewName, pszOldName );
 
@@ -2285,6 +2296,16 @@ CPLErr GDALDriver::SetMetadataItem( const char *pszName,
         {
             GDALMajorObject::SetMetadataItem(GDAL_DMD_EXTENSIONS, pszValue);
         }
+
+        /* Those items are used by the index of drivers probed on opening */
+        if( EQUAL(pszName, GDAL_DCAP_RASTER) ||
+            EQUAL(pszName, GDAL_DCAP_VECTOR) ||
+            EQUAL(pszName, GDAL_DCAP_MULTIDIM_RASTER) ||
+            EQUAL(pszName, GDAL_DMD_EXTENSION) ||
+            EQUAL(pszName, GDAL_DMD_EXTENSIONS) )
+        {
+            GDALDriverManager::InvalidateOpenIndex();
+        }
     }
     return GDALMajorObject::SetMetadataItem(pszName, pszValue, pszDomain);
 }
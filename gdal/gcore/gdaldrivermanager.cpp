@@ -30,6 +30,7 @@
 #include "cpl_port.h"
 #include "gdal_priv.h"
 
+#include <atomic>
 #include <cstring>
 #include <map>
 
@@ -39,6 +40,7 @@
 #include "cpl_multiproc.h"
 #include "cpl_port.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 #include "gdal_alg.h"
 #include "gdal_alg_priv.h"
@@ -72,6 +74,7 @@ CPL_CVSID("$Id$")
 
 static volatile GDALDriverManager *poDM = nullptr;
 static CPLMutex *hDMMutex = nullptr;
+static std::atomic<int> gnOpenIndexGeneration{0};
 
 // FIXME: Disabled following code as it crashed on OSX CI test.
 // static std::mutex oDeleteMutex;
@@ -215,6 +218,9 @@ GDALDriverManager::~GDALDriverManager()
 /* -------------------------------------------------------------------- */
 /*      Destroy the existing drivers.                                   */
 /* -------------------------------------------------------------------- */
+    m_aoDeferredPlugins.clear();
+    m_bHasDeferredPlugins = false;
+
     while( GetDriverCount() > 0 )
     {
         GDALDriver *poDriver = GetDriver(0);
@@ -227,6 +233,13 @@ GDALDriverManager::~GDALDriverManager()
 
     GDALDestroyGlobalThreadPool();
 
+/* -------------------------------------------------------------------- */
+/*      Write the trace files, if CPL_TRACE_FILE or                     */
+/*      CPL_VSIL_IO_TRACE_FILE were set.                                */
+/* -------------------------------------------------------------------- */
+    CPLTraceStop();
+    VSIIOTraceStop();
+
 /* -------------------------------------------------------------------- */
 /*      Cleanup local memory.                                           */
 /* -------------------------------------------------------------------- */
@@ -347,6 +360,10 @@ GDALDriverManager::~GDALDriverManager()
 int GDALDriverManager::GetDriverCount() const
 
 {
+    // Enumerating drivers requires all of them to be registered.
+    if( m_bHasDeferredPlugins )
+        const_cast<GDALDriverManager*>(this)->LoadDeferredPlugins();
+
     return nDrivers;
 }
 
@@ -383,6 +400,9 @@ int CPL_STDCALL GDALGetDriverCount()
 GDALDriver * GDALDriverManager::GetDriver( int iDriver )
 
 {
+    if( m_bHasDeferredPlugins )
+        LoadDeferredPlugins();
+
     CPLMutexHolderD( &hDMMutex );
 
     return GetDriver_unlocked(iDriver);
@@ -502,6 +522,8 @@ int GDALDriverManager::RegisterDriver( GDALDriver * poDriver )
     oMapNameToDrivers[CPLString(poDriver->GetDescription()).toupper()] =
         poDriver;
 
+    InvalidateOpenIndex();
+
     int iResult = nDrivers - 1;
 
     return iResult;
@@ -556,6 +578,7 @@ void GDALDriverManager::DeregisterDriver( GDALDriver * poDriver )
         return;
 
     oMapNameToDrivers.erase(CPLString(poDriver->GetDescription()).toupper());
+    InvalidateOpenIndex();
     --nDrivers;
     // Move all following drivers down by one to pack the list.
     while( i < nDrivers )
@@ -565,6 +588,127 @@ void GDALDriverManager::DeregisterDriver( GDALDriver * poDriver )
     }
 }
 
+/************************************************************************/
+/*                        InvalidateOpenIndex()                         */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+void GDALDriverManager::InvalidateOpenIndex()
+{
+    ++gnOpenIndexGeneration;
+}
+
+/************************************************************************/
+/*                      BuildOpenIndex_unlocked()                       */
+/************************************************************************/
+
+void GDALDriverManager::BuildOpenIndex_unlocked()
+{
+    m_nOpenIndexGeneration = gnOpenIndexGeneration;
+    m_aoOpenIndex.clear();
+    m_oMapExtensionToOpenIndex.clear();
+
+    for( int i = 0; i < nDrivers; ++i )
+    {
+        GDALDriver* poDriver = papoDrivers[i];
+        if( poDriver->pfnOpen == nullptr &&
+            poDriver->pfnOpenWithDriverArg == nullptr )
+        {
+            continue;
+        }
+
+        OpenIndexEntry sEntry;
+        sEntry.poDriver = poDriver;
+        sEntry.bRaster =
+            poDriver->GetMetadataItem(GDAL_DCAP_RASTER) != nullptr;
+        sEntry.bVector =
+            poDriver->GetMetadataItem(GDAL_DCAP_VECTOR) != nullptr;
+        sEntry.bMultiDimRaster =
+            poDriver->GetMetadataItem(GDAL_DCAP_MULTIDIM_RASTER) != nullptr;
+
+        const CPLStringList aosExtensions(CSLTokenizeString(
+            poDriver->GetMetadataItem(GDAL_DMD_EXTENSIONS)));
+        for( int j = 0; j < aosExtensions.size(); ++j )
+        {
+            auto& anIndices = m_oMapExtensionToOpenIndex[
+                CPLString(aosExtensions[j]).tolower()];
+            if( anIndices.empty() || anIndices.back() != m_aoOpenIndex.size() )
+                anIndices.push_back(m_aoOpenIndex.size());
+        }
+
+        m_aoOpenIndex.push_back(sEntry);
+    }
+}
+
+/************************************************************************/
+/*                         GetOpenCandidates()                          */
+/************************************************************************/
+
+/* Returns the drivers that may open a dataset with the passed GDAL_OF_ flags,
+ * in the order in which they must be probed. If pszExtension is not NULL,
+ * the drivers that declare that extension come first, followed by the other
+ * drivers.
+ */
+std::vector<GDALDriver*> GDALDriverManager::GetOpenCandidates(
+                                int nOpenFlags, const char* pszExtension )
+{
+    CPLMutexHolderD( &hDMMutex );
+
+    if( m_nOpenIndexGeneration != gnOpenIndexGeneration )
+        BuildOpenIndex_unlocked();
+
+    const auto IsCandidate = [nOpenFlags](const OpenIndexEntry& sEntry)
+    {
+        if( (nOpenFlags & GDAL_OF_RASTER) != 0 &&
+            (nOpenFlags & GDAL_OF_VECTOR) == 0 &&
+            !sEntry.bRaster )
+            return false;
+        if( (nOpenFlags & GDAL_OF_VECTOR) != 0 &&
+            (nOpenFlags & GDAL_OF_RASTER) == 0 &&
+            !sEntry.bVector )
+            return false;
+        if( (nOpenFlags & GDAL_OF_MULTIDIM_RASTER) != 0 &&
+            (nOpenFlags & GDAL_OF_RASTER) == 0 &&
+            !sEntry.bMultiDimRaster )
+            return false;
+        return true;
+    };
+
+    std::vector<GDALDriver*> apoDrivers;
+    apoDrivers.reserve(m_aoOpenIndex.size());
+
+    std::vector<bool> abAlreadyAdded;
+    if( pszExtension != nullptr && pszExtension[0] != '\0' )
+    {
+        const auto oIter = m_oMapExtensionToOpenIndex.find(
+            CPLString(pszExtension).tolower());
+        if( oIter != m_oMapExtensionToOpenIndex.end() )
+        {
+            abAlreadyAdded.resize(m_aoOpenIndex.size());
+            for( const size_t nIdx: oIter->second )
+            {
+                if( IsCandidate(m_aoOpenIndex[nIdx]) )
+                {
+                    apoDrivers.push_back(m_aoOpenIndex[nIdx].poDriver);
+                    abAlreadyAdded[nIdx] = true;
+                }
+            }
+        }
+    }
+
+    for( size_t i = 0; i < m_aoOpenIndex.size(); ++i )
+    {
+        if( (abAlreadyAdded.empty() || !abAlreadyAdded[i]) &&
+            IsCandidate(m_aoOpenIndex[i]) )
+        {
+            apoDrivers.push_back(m_aoOpenIndex[i].poDriver);
+        }
+    }
+
+    return apoDrivers;
+}
+//! @endcond
+
 /************************************************************************/
 /*                        GDALDeregisterDriver()                        */
 /************************************************************************/
@@ -606,7 +750,10 @@ GDALDriver * GDALDriverManager::GetDriverByName( const char * pszName )
     if( EQUAL(pszName, "CartoDB") )
         pszName = "Carto";
 
-    return oMapNameToDrivers[CPLString(pszName).toupper()];
+    GDALDriver* poDriver = oMapNameToDrivers[CPLString(pszName).toupper()];
+    if( poDriver == nullptr && m_bHasDeferredPlugins && LoadDeferredPlugins() )
+        poDriver = oMapNameToDrivers[CPLString(pszName).toupper()];
+    return poDriver;
 }
 
 /************************************************************************/
@@ -778,6 +925,22 @@ char** GDALDriverManager::GetSearchPaths(const char* pszGDAL_DRIVER_PATH)
 void GDALDriverManager::AutoLoadDrivers()
 
 {
+    for( const auto& oPlugin: ListPlugins() )
+        LoadPlugin(oPlugin);
+}
+
+/************************************************************************/
+/*                            ListPlugins()                             */
+/*                                                                      */
+/*      Returns the plugins found in the driver search paths, with      */
+/*      the name of their registration function.                        */
+/************************************************************************/
+
+std::vector<GDALDriverManager::PluginEntry> GDALDriverManager::ListPlugins()
+
+{
+    std::vector<PluginEntry> aoPlugins;
+
 #ifdef GDAL_NO_AUTOLOAD
     CPLDebug( "GDAL", "GDALDriverManager::AutoLoadDrivers() not compiled in." );
 #else
@@ -793,7 +956,7 @@ void GDALDriverManager::AutoLoadDrivers()
     if( pszGDAL_DRIVER_PATH != nullptr && EQUAL(pszGDAL_DRIVER_PATH,"disable"))
     {
         CPLDebug( "GDAL", "GDALDriverManager::AutoLoadDrivers() disabled." );
-        return;
+        return aoPlugins;
     }
 
 /* -------------------------------------------------------------------- */
@@ -833,48 +996,24 @@ void GDALDriverManager::AutoLoadDrivers()
                 && !EQUAL(pszExtension,"dylib") )
                 continue;
 
-            CPLString osFuncName;
+            PluginEntry oPlugin;
             if( STARTS_WITH_CI(papszFiles[iFile], "gdal_") )
             {
-                osFuncName.Printf("GDALRegister_%s",
+                oPlugin.osFuncName.Printf("GDALRegister_%s",
                         CPLGetBasename(papszFiles[iFile]) + strlen("gdal_") );
             }
             else if( STARTS_WITH_CI(papszFiles[iFile], "ogr_") )
             {
-                osFuncName.Printf(
+                oPlugin.osFuncName.Printf(
                          "RegisterOGR%s",
                          CPLGetBasename(papszFiles[iFile]) + strlen("ogr_") );
             }
             else
                 continue;
 
-            const char *pszFilename
-                = CPLFormFilename( osABISpecificDir,
-                                   papszFiles[iFile], nullptr );
-
-            CPLErrorReset();
-            CPLPushErrorHandler(CPLQuietErrorHandler);
-            void *pRegister = CPLGetSymbol( pszFilename, osFuncName );
-            CPLPopErrorHandler();
-            if( pRegister == nullptr )
-            {
-                CPLString osLastErrorMsg(CPLGetLastErrorMsg());
-                osFuncName = "GDALRegisterMe";
-                pRegister = CPLGetSymbol( pszFilename, osFuncName );
-                if( pRegister == nullptr )
-                {
-                    CPLError( CE_Failure, CPLE_AppDefined,
-                              "%s", osLastErrorMsg.c_str() );
-                }
-            }
-
-            if( pRegister != nullptr )
-            {
-                CPLDebug( "GDAL", "Auto register %s using %s.",
-                          pszFilename, osFuncName.c_str() );
-
-                reinterpret_cast<void (*)()>(pRegister)();
-            }
+            oPlugin.osFilename = CPLFormFilename( osABISpecificDir,
+                                                  papszFiles[iFile], nullptr );
+            aoPlugins.push_back(oPlugin);
         }
 
         CSLDestroy( papszFiles );
@@ -883,6 +1022,109 @@ void GDALDriverManager::AutoLoadDrivers()
     CSLDestroy( papszSearchPaths );
 
 #endif  // GDAL_NO_AUTOLOAD
+
+    return aoPlugins;
+}
+
+/************************************************************************/
+/*                             LoadPlugin()                             */
+/************************************************************************/
+
+void GDALDriverManager::LoadPlugin( const PluginEntry& oPlugin )
+
+{
+    const char *pszFilename = oPlugin.osFilename.c_str();
+    CPLString osFuncName(oPlugin.osFuncName);
+
+    CPLErrorReset();
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    void *pRegister = CPLGetSymbol( pszFilename, osFuncName );
+    CPLPopErrorHandler();
+    if( pRegister == nullptr )
+    {
+        CPLString osLastErrorMsg(CPLGetLastErrorMsg());
+        osFuncName = "GDALRegisterMe";
+        pRegister = CPLGetSymbol( pszFilename, osFuncName );
+        if( pRegister == nullptr )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "%s", osLastErrorMsg.c_str() );
+        }
+    }
+
+    if( pRegister != nullptr )
+    {
+        CPLDebug( "GDAL", "Auto register %s using %s.",
+                  pszFilename, osFuncName.c_str() );
+
+        reinterpret_cast<void (*)()>(pRegister)();
+    }
+}
+
+/************************************************************************/
+/*                       DeclareDeferredPlugins()                       */
+/************************************************************************/
+
+/**
+ * \brief Declare the plugins to be loaded on demand.
+ *
+ * Instead of loading the plugins found in the driver search paths like
+ * AutoLoadDrivers() does, this only records them. They are loaded the first
+ * time a driver that is not registered is requested by name, when the list
+ * of drivers is enumerated, or when no registered driver can open a dataset.
+ *
+ * GDALAllRegister() calls this method, once built-in drivers are registered,
+ * when the GDAL_DEFERRED_PLUGIN_LOADING configuration option is set to YES.
+ * Note that plugins then cannot override built-in drivers, and their drivers
+ * are probed after built-in drivers when opening a dataset.
+ *
+ * @since GDAL 3.4
+ */
+
+void GDALDriverManager::DeclareDeferredPlugins()
+
+{
+    std::vector<PluginEntry> aoPlugins(ListPlugins());
+
+    CPLMutexHolderD( &hDMMutex );
+    for( auto& oPlugin: aoPlugins )
+    {
+        CPLDebug( "GDAL", "Defer loading of %s.", oPlugin.osFilename.c_str() );
+        m_aoDeferredPlugins.push_back(std::move(oPlugin));
+    }
+    m_bHasDeferredPlugins = !m_aoDeferredPlugins.empty();
+}
+
+/************************************************************************/
+/*                        LoadDeferredPlugins()                         */
+/************************************************************************/
+
+/**
+ * \brief Load the plugins declared with DeclareDeferredPlugins().
+ *
+ * @return true if plugins had to be loaded.
+ *
+ * @since GDAL 3.4
+ */
+
+bool GDALDriverManager::LoadDeferredPlugins()
+
+{
+    CPLMutexHolderD( &hDMMutex );
+
+    if( m_aoDeferredPlugins.empty() )
+        return false;
+
+    // Registration functions look up drivers by name, so the list must be
+    // emptied before loading to avoid recursion.
+    std::vector<PluginEntry> aoPlugins;
+    std::swap(aoPlugins, m_aoDeferredPlugins);
+    m_bHasDeferredPlugins = false;
+
+    for( const auto& oPlugin: aoPlugins )
+        LoadPlugin(oPlugin);
+
+    return true;
 }
 
 /************************************************************************/
@@ -32,12 +32,12 @@
 
 #include <cstddef>
 #include <algorithm>
-#include <set>
 #include <vector>
 
 #include "cpl_config.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
+#include "cpl_open_hash_map.h"
 
 CPL_CVSID("$Id$")
 
@@ -65,8 +65,49 @@ class GDALHashSetBandBlockCache final : public GDALAbstractBandBlockCache
         }
     };
 
-    std::set<GDALRasterBlock*, BlockComparator> m_oSet{};
-    CPLLock        *hLock = nullptr;
+    struct BlockKeyHasher
+    {
+        size_t operator() (GUInt64 nKey) const
+        {
+            return static_cast<size_t>(nKey ^ (nKey >> 32));
+        }
+    };
+
+    // Blocks are indexed by their (x,y) offsets packed in a 64 bit key, so
+    // that lookups neither allocate nor need a GDALRasterBlock to compare to.
+    typedef CPLOpenHashMap<GUInt64, GDALRasterBlock*,
+                           BlockKeyHasher> BlockMap;
+
+    static GUInt64 GetKey( int nXBlockOff, int nYBlockOff )
+    {
+        return (static_cast<GUInt64>(static_cast<GUInt32>(nYBlockOff)) << 32) |
+               static_cast<GUInt32>(nXBlockOff);
+    }
+
+    // Blocks are spread over several partitions, each one with its own
+    // lock, so that concurrent accesses to different blocks of the band
+    // do not contend on the same lock.
+    static constexpr int N_PARTITIONS = 8;
+
+    struct Partition
+    {
+        BlockMap        oMap{};
+        CPLLock        *hLock = nullptr;
+    };
+
+    Partition m_asPartitions[N_PARTITIONS];
+
+    static int GetPartitionIdx( int nXBlockOff, int nYBlockOff )
+    {
+        return static_cast<int>(
+            (static_cast<unsigned>(nXBlockOff) +
+             static_cast<unsigned>(nYBlockOff) * 3U) % N_PARTITIONS);
+    }
+
+    Partition& GetPartition( int nXBlockOff, int nYBlockOff )
+    {
+        return m_asPartitions[GetPartitionIdx(nXBlockOff, nYBlockOff)];
+    }
 
     CPL_DISALLOW_COPY_ASSIGN(GDALHashSetBandBlockCache)
 
@@ -101,10 +142,11 @@ GDALAbstractBandBlockCache* GDALHashSetBandBlockCacheCreate(
 
 GDALHashSetBandBlockCache::GDALHashSetBandBlockCache(
     GDALRasterBand* poBandIn ) :
-    GDALAbstractBandBlockCache(poBandIn),
-
-    hLock(CPLCreateLock(LOCK_ADAPTIVE_MUTEX))
-{}
+    GDALAbstractBandBlockCache(poBandIn)
+{
+    for( auto& oPartition: m_asPartitions )
+        oPartition.hLock = CPLCreateLock(LOCK_ADAPTIVE_MUTEX);
+}
 
 /************************************************************************/
 /*                      ~GDALHashSetBandBlockCache()                    */
@@ -113,7 +155,8 @@ GDALHashSetBandBlockCache::GDALHashSetBandBlockCache(
 GDALHashSetBandBlockCache::~GDALHashSetBandBlockCache()
 {
     GDALHashSetBandBlockCache::FlushCache();
-    CPLDestroyLock(hLock);
+    for( auto& oPartition: m_asPartitions )
+        CPLDestroyLock(oPartition.hLock);
 }
 
 /************************************************************************/
@@ -143,8 +186,11 @@ CPLErr GDALHashSetBandBlockCache::AdoptBlock( GDALRasterBlock * poBlock )
 {
     FreeDanglingBlocks();
 
-    CPLLockHolderOptionalLockD( hLock );
-    m_oSet.insert(poBlock);
+    Partition& oPartition =
+        GetPartition(poBlock->GetXOff(), poBlock->GetYOff());
+    CPLLockHolderOptionalLockD( oPartition.hLock );
+    oPartition.oMap.Insert(GetKey(poBlock->GetXOff(), poBlock->GetYOff()),
+                           poBlock);
 
     return CE_None;
 }
@@ -159,14 +205,27 @@ CPLErr GDALHashSetBandBlockCache::FlushCache()
 
     CPLErr eGlobalErr = poBand->eFlushBlockErr;
 
-    std::set<GDALRasterBlock*, BlockComparator> oOldSet;
+    // Merge all partitions, and sort blocks in the order expected by
+    // BlockComparator.
+    std::vector<GDALRasterBlock*> apoOldBlocks;
+    for( auto& oPartition: m_asPartitions )
     {
-        CPLLockHolderOptionalLockD( hLock );
-        oOldSet = std::move(m_oSet);
+        BlockMap oPartitionMap;
+        {
+            CPLLockHolderOptionalLockD( oPartition.hLock );
+            std::swap(oPartitionMap, oPartition.oMap);
+        }
+        oPartitionMap.ForEach(
+            [&apoOldBlocks](const GUInt64&, GDALRasterBlock*& poBlock)
+            {
+                apoOldBlocks.push_back(poBlock);
+                return true;
+            });
     }
+    std::sort(apoOldBlocks.begin(), apoOldBlocks.end(), BlockComparator());
 
     StartDirtyBlockFlushingLog();
-    for( auto& poBlock: oOldSet )
+    for( auto& poBlock: apoOldBlocks )
     {
         if( poBlock->DropLockForRemovalFromStorage() )
         {
@@ -199,8 +258,10 @@ CPLErr GDALHashSetBandBlockCache::UnreferenceBlock( GDALRasterBlock* poBlock )
 {
     UnreferenceBlockBase();
 
-    CPLLockHolderOptionalLockD( hLock );
-    m_oSet.erase(poBlock);
+    Partition& oPartition =
+        GetPartition(poBlock->GetXOff(), poBlock->GetYOff());
+    CPLLockHolderOptionalLockD( oPartition.hLock );
+    oPartition.oMap.Erase(GetKey(poBlock->GetXOff(), poBlock->GetYOff()));
     return CE_None;
 }
 
@@ -212,15 +273,16 @@ CPLErr GDALHashSetBandBlockCache::FlushBlock( int nXBlockOff, int nYBlockOff,
                                               int bWriteDirtyBlock )
 
 {
-    GDALRasterBlock oBlockForLookup(nXBlockOff, nYBlockOff);
+    const GUInt64 nKey = GetKey(nXBlockOff, nYBlockOff);
     GDALRasterBlock* poBlock = nullptr;
     {
-        CPLLockHolderOptionalLockD( hLock );
-        auto oIter = m_oSet.find(&oBlockForLookup);
-        if( oIter == m_oSet.end() )
+        Partition& oPartition = GetPartition(nXBlockOff, nYBlockOff);
+        CPLLockHolderOptionalLockD( oPartition.hLock );
+        GDALRasterBlock** ppoBlock = oPartition.oMap.Find(nKey);
+        if( ppoBlock == nullptr )
             return CE_None;
-        poBlock = *oIter;
-        m_oSet.erase(oIter);
+        poBlock = *ppoBlock;
+        oPartition.oMap.Erase(nKey);
     }
 
     if( !poBlock->DropLockForRemovalFromStorage() )
@@ -244,14 +306,15 @@ GDALRasterBlock *GDALHashSetBandBlockCache::TryGetLockedBlockRef(
     int nXBlockOff, int nYBlockOff )
 
 {
-    GDALRasterBlock oBlockForLookup(nXBlockOff, nYBlockOff);
     GDALRasterBlock* poBlock;
     {
-        CPLLockHolderOptionalLockD( hLock );
-        auto oIter = m_oSet.find(&oBlockForLookup);
-        if( oIter == m_oSet.end() )
+        Partition& oPartition = GetPartition(nXBlockOff, nYBlockOff);
+        CPLLockHolderOptionalLockD( oPartition.hLock );
+        GDALRasterBlock** ppoBlock =
+            oPartition.oMap.Find(GetKey(nXBlockOff, nYBlockOff));
+        if( ppoBlock == nullptr )
             return nullptr;
-        poBlock = *oIter;
+        poBlock = *ppoBlock;
     }
     if( !poBlock->TakeLock()  )
         return nullptr;
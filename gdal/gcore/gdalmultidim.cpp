@@ -30,15 +30,22 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <condition_variable>
+#include <list>
+#include <mutex>
 #include <queue>
 #include <set>
+#include <unordered_map>
 
 #include <ctype.h> // isalnum
 
 #include "gdal_priv.h"
 #include "gdal_pam.h"
+#include "gdal_thread_pool.h"
 #include "gdal_utils.h"
+#include "cpl_error_internal.h"
 #include "cpl_safemaths.hpp"
+#include "cpl_worker_thread_pool.h"
 #include "ogrsf_frmts.h"
 
 #if defined(__clang__) || defined(_MSC_VER)
@@ -1824,6 +1831,10 @@ bool GDALAbstractMDArray::Write(const GUInt64* arrayStartIdx,
         return false;
     }
 
+    // Chunks of the array that may be in the chunk cache become stale.
+    if( auto poArray = dynamic_cast<const GDALMDArray*>(this) )
+        poArray->InvalidateChunkCache();
+
     return IWrite(arrayStartIdx, count, arrayStep,
                  bufferStride, bufferDataType, pSrcBuffer);
 }
@@ -1890,29 +1901,16 @@ std::vector<GUInt64> GDALAbstractMDArray::GetBlockSize() const
 }
 
 /************************************************************************/
-/*                       GetProcessingChunkSize()                       */
+/*                     ComputeProcessingChunkSize()                     */
 /************************************************************************/
 
-/** \brief Return an optimal chunk size for read/write operations, given the natural
- * block size and memory constraints specified.
- *
- * This method will use GetBlockSize() to define a chunk whose dimensions are
- * multiple of those returned by GetBlockSize() (unless the block define by
- * GetBlockSize() is larger than nMaxChunkMemory, in which case it will be
- * returned by this method).
- *
- * This is the same as the C function GDALMDArrayGetProcessingChunkSize().
- *
- * @param nMaxChunkMemory Maximum amount of memory, in bytes, to use for the chunk.
- *
- * @return the chunk size, in number of elements along each dimension.
- */
-std::vector<size_t> GDALAbstractMDArray::GetProcessingChunkSize(size_t nMaxChunkMemory) const
+static std::vector<size_t> ComputeProcessingChunkSize(
+                        const std::vector<std::shared_ptr<GDALDimension>>& dims,
+                        size_t nDTSize,
+                        const std::vector<GUInt64>& blockSize,
+                        size_t nMaxChunkMemory)
 {
-    const auto& dims = GetDimensions();
-    const auto& nDTSize = GetDataType().GetSize();
     std::vector<size_t> anChunkSize;
-    auto blockSize = GetBlockSize();
     CPLAssert( blockSize.size() == dims.size() );
     size_t nChunkSize = nDTSize;
     bool bOverflow = false;
@@ -1994,6 +1992,30 @@ std::vector<size_t> GDALAbstractMDArray::GetProcessingChunkSize(size_t nMaxChunk
     return anChunkSize;
 }
 
+/************************************************************************/
+/*                       GetProcessingChunkSize()                       */
+/************************************************************************/
+
+/** \brief Return an optimal chunk size for read/write operations, given the natural
+ * block size and memory constraints specified.
+ *
+ * This method will use GetBlockSize() to define a chunk whose dimensions are
+ * multiple of those returned by GetBlockSize() (unless the block define by
+ * GetBlockSize() is larger than nMaxChunkMemory, in which case it will be
+ * returned by this method).
+ *
+ * This is the same as the C function GDALMDArrayGetProcessingChunkSize().
+ *
+ * @param nMaxChunkMemory Maximum amount of memory, in bytes, to use for the chunk.
+ *
+ * @return the chunk size, in number of elements along each dimension.
+ */
+std::vector<size_t> GDALAbstractMDArray::GetProcessingChunkSize(size_t nMaxChunkMemory) const
+{
+    return ComputeProcessingChunkSize(GetDimensions(), GetDataType().GetSize(),
+                                      GetBlockSize(), nMaxChunkMemory);
+}
+
 /************************************************************************/
 /*                             SetUnit()                                */
 /************************************************************************/
@@ -3112,6 +3134,244 @@ bool GDALMDArray::CopyFromAllExceptValues(const GDALMDArray* poSrcArray,
 
 //! @endcond
 
+/************************************************************************/
+/*                        CopyValuesPipelined()                         */
+/************************************************************************/
+
+namespace {
+
+struct CopyChunk
+{
+    std::vector<GUInt64> anStartIdx{};
+    std::vector<size_t>  anCount{};
+    std::vector<GByte>*  pabyBuffer = nullptr;
+    bool                 bDone = false;
+    bool                 bOK = false;
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+};
+
+struct CopyPipeline
+{
+    const GDALMDArray* poSrcArray = nullptr;
+    std::vector<CopyChunk> aoChunks{};
+    std::vector<std::vector<GByte>> aabyBuffers{};
+    std::vector<std::vector<GByte>*> apabyFreeBuffers{};
+    size_t nNextChunkToRead = 0;
+    bool bStop = false;
+    std::mutex oMutex{};
+    std::condition_variable oCV{};
+
+    // Reads the next chunk into a free buffer. Returns false when there is
+    // nothing left to read.
+    bool ReadNextChunk()
+    {
+        CopyChunk* psChunk = nullptr;
+        {
+            std::unique_lock<std::mutex> oLock(oMutex);
+            oCV.wait(oLock, [this]{
+                return bStop || nNextChunkToRead == aoChunks.size() ||
+                       !apabyFreeBuffers.empty(); });
+            if( bStop || nNextChunkToRead == aoChunks.size() )
+                return false;
+            psChunk = &aoChunks[nNextChunkToRead++];
+            psChunk->pabyBuffer = apabyFreeBuffers.back();
+            apabyFreeBuffers.pop_back();
+        }
+        CPLInstallErrorHandlerAccumulator(psChunk->aoErrors);
+        const bool bOK = poSrcArray->Read(psChunk->anStartIdx.data(),
+                                          psChunk->anCount.data(),
+                                          nullptr, nullptr,
+                                          poSrcArray->GetDataType(),
+                                          psChunk->pabyBuffer->data());
+        CPLUninstallErrorHandlerAccumulator();
+        {
+            std::lock_guard<std::mutex> oLock(oMutex);
+            psChunk->bOK = bOK;
+            psChunk->bDone = true;
+        }
+        oCV.notify_all();
+        return true;
+    }
+
+    static void ReaderJob(void* pData)
+    {
+        auto poPipeline = static_cast<CopyPipeline*>(pData);
+        while( poPipeline->ReadNextChunk() )
+        {
+            // do nothing
+        }
+    }
+};
+
+} // namespace
+
+/* Copies the values of poSrcArray into poDstArray by chunks of anChunkSizes.
+ * Chunks are read by nReaders jobs of poThreadPool (nReaders > 1 only makes
+ * sense if reading the source array is thread-safe), while the calling
+ * thread writes them in order. Returns false in case of error or
+ * interruption, in which case bStop is set if the interruption comes from
+ * the progress callback.
+ */
+static bool CopyValuesPipelined(const GDALMDArray* poSrcArray,
+                                GDALMDArray* poDstArray,
+                                const std::vector<size_t>& anChunkSizes,
+                                CPLWorkerThreadPool* poThreadPool,
+                                int nReaders,
+                                GUInt64 nCurCost,
+                                GUInt64 nTotalCost,
+                                GUInt64 nTotalBytesThisArray,
+                                GDALProgressFunc pfnProgress,
+                                void* pProgressData,
+                                bool& bStop)
+{
+    const auto& dt = poSrcArray->GetDataType();
+    const auto nDTSize = dt.GetSize();
+    const size_t nDims = poSrcArray->GetDimensionCount();
+
+    CopyPipeline oPipeline;
+    oPipeline.poSrcArray = poSrcArray;
+
+    // Enumerate the chunks.
+    {
+        std::vector<GUInt64> arrayStartIdx(nDims);
+        std::vector<GUInt64> count(nDims);
+        const auto& dims = poSrcArray->GetDimensions();
+        for( size_t i = 0; i < nDims; i++ )
+        {
+            count[i] = dims[i]->GetSize();
+        }
+        const auto CollectChunk = [](GDALAbstractMDArray* l_poSrcArray,
+                                     const GUInt64* chunkArrayStartIdx,
+                                     const size_t* chunkCount,
+                                     GUInt64, GUInt64,
+                                     void* pUserData)
+        {
+            const size_t l_nDims = l_poSrcArray->GetDimensionCount();
+            CopyChunk oChunk;
+            oChunk.anStartIdx.assign(chunkArrayStartIdx,
+                                     chunkArrayStartIdx + l_nDims);
+            oChunk.anCount.assign(chunkCount, chunkCount + l_nDims);
+            static_cast<std::vector<CopyChunk>*>(pUserData)->
+                emplace_back(std::move(oChunk));
+            return true;
+        };
+        if( !const_cast<GDALMDArray*>(poSrcArray)->
+                ProcessPerChunk(arrayStartIdx.data(), count.data(),
+                                anChunkSizes.data(),
+                                CollectChunk, &oPipeline.aoChunks) )
+        {
+            return false;
+        }
+    }
+
+    size_t nRealChunkSize = nDTSize;
+    for( const auto& nChunkSize: anChunkSizes )
+    {
+        nRealChunkSize *= nChunkSize;
+    }
+    // One buffer being written while the others are being read.
+    const size_t nBuffers = static_cast<size_t>(nReaders) + 1;
+    try
+    {
+        oPipeline.aabyBuffers.resize(nBuffers);
+        for( auto& abyBuffer: oPipeline.aabyBuffers )
+        {
+            abyBuffer.resize(nRealChunkSize);
+            oPipeline.apabyFreeBuffers.push_back(&abyBuffer);
+        }
+    }
+    catch( const std::exception& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate temporary buffer");
+        return false;
+    }
+
+    // Multiple readers: do a first read in this thread, so that the lazy
+    // initialization of the source array is not done concurrently.
+    if( nReaders > 1 )
+        oPipeline.ReadNextChunk();
+
+    auto poJobQueue = poThreadPool->CreateJobQueue();
+    int nSubmittedJobs = 0;
+    for( int i = 0; i < nReaders; ++i )
+    {
+        if( poJobQueue->SubmitJob(CopyPipeline::ReaderJob, &oPipeline) )
+            nSubmittedJobs ++;
+    }
+
+    const auto FreeDynamicMemory = [&dt, nDTSize](const CopyChunk& oChunk)
+    {
+        if( !oChunk.bOK || !dt.NeedsFreeDynamicMemory() )
+            return;
+        size_t nEltCount = 1;
+        for( const auto nCount: oChunk.anCount )
+            nEltCount *= nCount;
+        GByte* ptr = oChunk.pabyBuffer->data();
+        for( size_t i = 0; i < nEltCount; i++ )
+        {
+            dt.FreeDynamicMemory(ptr);
+            ptr += nDTSize;
+        }
+    };
+
+    const size_t nChunkCount = oPipeline.aoChunks.size();
+    size_t iChunk = 0;
+    bool bRet = true;
+    for( ; iChunk < nChunkCount; ++iChunk )
+    {
+        auto& oChunk = oPipeline.aoChunks[iChunk];
+        if( nSubmittedJobs == 0 )
+            oPipeline.ReadNextChunk();
+        {
+            std::unique_lock<std::mutex> oLock(oPipeline.oMutex);
+            oPipeline.oCV.wait(oLock, [&oChunk]{ return oChunk.bDone; });
+        }
+        for( const auto& oError: oChunk.aoErrors )
+            CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+
+        bRet = oChunk.bOK &&
+               poDstArray->Write(oChunk.anStartIdx.data(),
+                                 oChunk.anCount.data(),
+                                 nullptr, nullptr,
+                                 dt,
+                                 oChunk.pabyBuffer->data());
+        FreeDynamicMemory(oChunk);
+
+        if( bRet )
+        {
+            const double dfCurCost = double(nCurCost) +
+                double(iChunk + 1) / nChunkCount * nTotalBytesThisArray;
+            if( !pfnProgress(dfCurCost / nTotalCost, "", pProgressData) )
+            {
+                bStop = true;
+                bRet = false;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> oLock(oPipeline.oMutex);
+            oPipeline.apabyFreeBuffers.push_back(oChunk.pabyBuffer);
+            if( !bRet )
+                oPipeline.bStop = true;
+        }
+        oPipeline.oCV.notify_all();
+        if( !bRet )
+            break;
+    }
+
+    poJobQueue->WaitCompletion();
+
+    // Release chunks read ahead but not written.
+    for( ++iChunk; iChunk < nChunkCount; ++iChunk )
+    {
+        if( oPipeline.aoChunks[iChunk].bDone )
+            FreeDynamicMemory(oPipeline.aoChunks[iChunk]);
+    }
+
+    return bRet;
+}
+
 /************************************************************************/
 /*                               CopyFrom()                             */
 /************************************************************************/
@@ -3261,7 +3521,74 @@ bool GDALMDArray::CopyFrom(CPL_UNUSED GDALDataset* poSrcDS,
             static_cast<size_t>(
                 std::min(GIntBig(std::numeric_limits<size_t>::max() / 2),
                          GDALGetCacheMax64() / 4));
-        const auto anChunkSizes(GetProcessingChunkSize(nMaxChunkSize));
+
+        const char* pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+        const int nThreads = std::max(1, std::min(128,
+            EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                               atoi(pszNumThreads)));
+        CPLWorkerThreadPool* poThreadPool =
+            nThreads > 1 ? GDALGetGlobalThreadPool(nThreads) : nullptr;
+        // Chunks are read concurrently only if the source array allows it,
+        // otherwise reading of the next chunk overlaps with writing of the
+        // current one. One thread is left for the writer.
+        const int nReaders = poSrcArray->IsIReadThreadSafe() ?
+                                std::max(1, nThreads - 1) : 1;
+
+        // Align processing chunks on the blocks of both the source and
+        // destination arrays when practical, so that source blocks are
+        // decoded once and destination blocks written in full.
+        auto anBlockSize = GetBlockSize();
+        const auto anSrcBlockSize = poSrcArray->GetBlockSize();
+        {
+            auto anAlignedBlockSize = anBlockSize;
+            double dfAlignedBlockBytes = static_cast<double>(nDTSize);
+            for( size_t i = 0; i < dims.size(); i++ )
+            {
+                const GUInt64 nDimSize = dims[i]->GetSize();
+                GUInt64 nDst = anBlockSize[i];
+                const GUInt64 nSrc = anSrcBlockSize[i];
+                if( nDst == 0 )
+                {
+                    anAlignedBlockSize[i] = nSrc;
+                }
+                else if( nSrc != 0 && nSrc != nDst )
+                {
+                    GUInt64 nGCD = nSrc;
+                    while( nDst != 0 )
+                    {
+                        const GUInt64 nTmp = nGCD % nDst;
+                        nGCD = nDst;
+                        nDst = nTmp;
+                    }
+                    const GUInt64 nFactor = anBlockSize[i] / nGCD;
+                    anAlignedBlockSize[i] = nSrc > nDimSize / nFactor ?
+                        nDimSize : std::min(nDimSize, nFactor * nSrc);
+                }
+                dfAlignedBlockBytes *= static_cast<double>(std::max<GUInt64>(1,
+                    std::min(anAlignedBlockSize[i], nDimSize)));
+            }
+            if( dfAlignedBlockBytes <= static_cast<double>(nMaxChunkSize) )
+                anBlockSize = std::move(anAlignedBlockSize);
+        }
+
+        if( poThreadPool )
+        {
+            // The swath memory is shared by the chunks being read and written.
+            const auto anChunkSizes(ComputeProcessingChunkSize(
+                dims, nDTSize, anBlockSize, nMaxChunkSize / (nReaders + 1)));
+            bool bStop = false;
+            const bool bRet = copyFunc.nTotalBytesThisArray == 0 ||
+                CopyValuesPipelined(poSrcArray, this, anChunkSizes,
+                                    poThreadPool, nReaders,
+                                    nCurCost, nTotalCost,
+                                    copyFunc.nTotalBytesThisArray,
+                                    pfnProgress, pProgressData, bStop);
+            nCurCost += copyFunc.nTotalBytesThisArray;
+            return bRet || (!bStrict && !bStop);
+        }
+
+        const auto anChunkSizes(ComputeProcessingChunkSize(
+            dims, nDTSize, anBlockSize, nMaxChunkSize));
         size_t nRealChunkSize = nDTSize;
         for( const auto& nChunkSize: anChunkSizes )
         {
@@ -3637,10 +3964,455 @@ bool GDALMDArray::Read(const GUInt64* arrayStartIdx,
         return false;
     }
 
+    bool bHandled = false;
+    const bool bRet = array->ReadThroughChunkCache(arrayStartIdx, count,
+                                                   arrayStep, bufferStride,
+                                                   bufferDataType, pDstBuffer,
+                                                   bHandled);
+    if( bHandled )
+        return bRet;
+
     return array->IRead(arrayStartIdx, count, arrayStep,
                         bufferStride, bufferDataType, pDstBuffer);
 }
 
+/************************************************************************/
+/*                        GDALMDArrayChunkCache                         */
+/*                                                                      */
+/*      Process-wide LRU cache of chunks of multidimensional arrays, in */
+/*      the data type of the array, shared by all arrays and limited to */
+/*      GDAL_MDARRAY_CHUNK_CACHE_SIZE bytes (0, the default, disables   */
+/*      it). It is independent of the raster block cache.               */
+/************************************************************************/
+
+namespace {
+class GDALMDArrayChunkCache
+{
+  public:
+    typedef std::shared_ptr<const std::vector<GByte>> Chunk;
+
+  private:
+    struct Entry
+    {
+        std::string osKey;
+        Chunk       poChunk;
+    };
+
+    std::mutex m_oMutex{};
+    std::list<Entry> m_oLRU{}; // Most recently used first.
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_oMap{};
+    size_t  m_nSize = 0;
+    GUInt64 m_nLastArrayId = 0;
+
+  public:
+    static size_t GetMaxSize()
+    {
+        return static_cast<size_t>(std::min<GUIntBig>(
+            std::numeric_limits<size_t>::max(),
+            CPLScanUIntBig(
+                CPLGetConfigOption("GDAL_MDARRAY_CHUNK_CACHE_SIZE", "0"),
+                32)));
+    }
+
+    GUInt64 GetArrayId(GUInt64& nId)
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        if( nId == 0 )
+            nId = ++m_nLastArrayId;
+        return nId;
+    }
+
+    // Entries of the previous identifier are no longer reachable, and will
+    // be evicted in due course.
+    void ResetArrayId(GUInt64& nId)
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        nId = 0;
+    }
+
+    Chunk Get(const std::string& osKey)
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        const auto oIter = m_oMap.find(osKey);
+        if( oIter == m_oMap.end() )
+            return nullptr;
+        m_oLRU.splice(m_oLRU.begin(), m_oLRU, oIter->second);
+        return oIter->second->poChunk;
+    }
+
+    void Put(const std::string& osKey, const Chunk& poChunk, size_t nMaxSize)
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        const auto oIter = m_oMap.find(osKey);
+        if( oIter != m_oMap.end() )
+        {
+            m_nSize -= oIter->second->poChunk->size();
+            m_oLRU.erase(oIter->second);
+            m_oMap.erase(oIter);
+        }
+        m_oLRU.push_front(Entry{osKey, poChunk});
+        m_oMap[osKey] = m_oLRU.begin();
+        m_nSize += poChunk->size();
+        while( m_nSize > nMaxSize && !m_oLRU.empty() )
+        {
+            m_nSize -= m_oLRU.back().poChunk->size();
+            m_oMap.erase(m_oLRU.back().osKey);
+            m_oLRU.pop_back();
+        }
+    }
+};
+
+GDALMDArrayChunkCache& GetMDArrayChunkCache()
+{
+    static GDALMDArrayChunkCache oCache;
+    return oCache;
+}
+} // namespace
+
+/************************************************************************/
+/*                        InvalidateChunkCache()                        */
+/************************************************************************/
+
+void GDALMDArray::InvalidateChunkCache() const
+{
+    if( m_nChunkCacheId != 0 )
+        GetMDArrayChunkCache().ResetArrayId(m_nChunkCacheId);
+}
+
+/************************************************************************/
+/*                       ReadThroughChunkCache()                        */
+/************************************************************************/
+
+/* Serves Read() from the chunk cache, reading the missing chunks.
+ * bHandled is set to false when the request is not eligible, in which case
+ * the caller must use IRead().
+ */
+bool GDALMDArray::ReadThroughChunkCache(const GUInt64* arrayStartIdx,
+                                        const size_t* count,
+                                        const GInt64* arrayStep,
+                                        const GPtrDiff_t* bufferStride,
+                                        const GDALExtendedDataType& bufferDataType,
+                                        void* pDstBuffer,
+                                        bool& bHandled) const
+{
+    bHandled = false;
+    const size_t nMaxCacheSize = GDALMDArrayChunkCache::GetMaxSize();
+    const size_t nDims = GetDimensionCount();
+    const auto& oDT = GetDataType();
+    if( nMaxCacheSize == 0 || nDims == 0 ||
+        oDT.GetClass() != GEDTC_NUMERIC ||
+        bufferDataType.GetClass() != GEDTC_NUMERIC ||
+        !IsChunkCacheable() )
+    {
+        return false;
+    }
+
+    const auto anBlockSize = GetBlockSize();
+    const auto& apoDims = GetDimensions();
+    const size_t nDTSize = oDT.GetSize();
+
+    // Chunk indices touched by the request, for each dimension.
+    std::vector<std::vector<GUInt64>> aanChunkIndices(nDims);
+    double dfChunkBytes = static_cast<double>(nDTSize);
+    double dfChunkCount = 1;
+    for( size_t i = 0; i < nDims; ++i )
+    {
+        const GUInt64 nBlockSize = anBlockSize[i];
+        if( nBlockSize == 0 )
+            return false;
+        const GUInt64 nDimSize = apoDims[i]->GetSize();
+        const GUInt64 nAbsStep = static_cast<GUInt64>(
+            arrayStep[i] < 0 ? -arrayStep[i] : arrayStep[i]);
+        if( nAbsStep <= nBlockSize )
+        {
+            const GUInt64 nLast = static_cast<GUInt64>(
+                static_cast<GInt64>(arrayStartIdx[i]) +
+                static_cast<GInt64>(count[i] - 1) * arrayStep[i]);
+            const GUInt64 nFirstChunk =
+                std::min(arrayStartIdx[i], nLast) / nBlockSize;
+            const GUInt64 nLastChunk =
+                std::max(arrayStartIdx[i], nLast) / nBlockSize;
+            if( nLastChunk - nFirstChunk >= nMaxCacheSize )
+                return false;
+            for( GUInt64 j = nFirstChunk; j <= nLastChunk; ++j )
+                aanChunkIndices[i].push_back(j);
+        }
+        else
+        {
+            // Each requested index is in a different chunk.
+            if( count[i] > nMaxCacheSize )
+                return false;
+            for( size_t k = 0; k < count[i]; ++k )
+            {
+                aanChunkIndices[i].push_back(static_cast<GUInt64>(
+                    static_cast<GInt64>(arrayStartIdx[i]) +
+                    static_cast<GInt64>(k) * arrayStep[i]) / nBlockSize);
+            }
+            std::sort(aanChunkIndices[i].begin(), aanChunkIndices[i].end());
+        }
+        dfChunkBytes *= static_cast<double>(std::min(nBlockSize, nDimSize));
+        dfChunkCount *= static_cast<double>(aanChunkIndices[i].size());
+    }
+
+    // Caching is pointless if the chunks of a single request do not fit in
+    // the cache.
+    if( dfChunkBytes * dfChunkCount > static_cast<double>(nMaxCacheSize) )
+        return false;
+    bHandled = true;
+
+    auto& oCache = GetMDArrayChunkCache();
+    const GUInt64 nArrayId = oCache.GetArrayId(m_nChunkCacheId);
+
+    struct ChunkDesc
+    {
+        std::vector<GUInt64> anStartIdx{};
+        std::vector<size_t>  anCount{};
+        std::string          osKey{};
+        GDALMDArrayChunkCache::Chunk poChunk{};
+        bool                 bOK = true;
+        std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+    };
+    std::vector<ChunkDesc> aoChunks(static_cast<size_t>(dfChunkCount));
+    std::vector<ChunkDesc*> apoMissingChunks;
+    {
+        std::vector<size_t> anIter(nDims);
+        std::vector<GUInt64> anKey(nDims + 1);
+        anKey[0] = nArrayId;
+        for( auto& oChunk: aoChunks )
+        {
+            oChunk.anStartIdx.resize(nDims);
+            oChunk.anCount.resize(nDims);
+            for( size_t i = 0; i < nDims; ++i )
+            {
+                const GUInt64 nChunkIdx = aanChunkIndices[i][anIter[i]];
+                anKey[i + 1] = nChunkIdx;
+                oChunk.anStartIdx[i] = nChunkIdx * anBlockSize[i];
+                oChunk.anCount[i] = static_cast<size_t>(std::min(
+                    anBlockSize[i],
+                    apoDims[i]->GetSize() - oChunk.anStartIdx[i]));
+            }
+            oChunk.osKey.assign(reinterpret_cast<const char*>(anKey.data()),
+                                anKey.size() * sizeof(GUInt64));
+            oChunk.poChunk = oCache.Get(oChunk.osKey);
+            if( oChunk.poChunk == nullptr )
+                apoMissingChunks.push_back(&oChunk);
+
+            for( size_t i = nDims; i-- > 0; )
+            {
+                if( ++anIter[i] < aanChunkIndices[i].size() )
+                    break;
+                anIter[i] = 0;
+            }
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Read missing chunks, in parallel if the array allows it.        */
+/* -------------------------------------------------------------------- */
+    const auto ReadChunk = [this, nDims, nDTSize, &oDT](ChunkDesc* psChunk)
+    {
+        size_t nElts = 1;
+        std::vector<GInt64> anStep(nDims, 1);
+        std::vector<GPtrDiff_t> anStride(nDims);
+        for( size_t i = nDims; i-- > 0; )
+        {
+            anStride[i] = static_cast<GPtrDiff_t>(nElts);
+            nElts *= psChunk->anCount[i];
+        }
+        auto poData = std::make_shared<std::vector<GByte>>();
+        try
+        {
+            poData->resize(nElts * nDTSize);
+        }
+        catch( const std::bad_alloc& )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate chunk of %s", GetFullName().c_str());
+            psChunk->bOK = false;
+            return;
+        }
+        psChunk->bOK = IRead(psChunk->anStartIdx.data(),
+                             psChunk->anCount.data(), anStep.data(),
+                             anStride.data(), oDT, poData->data());
+        psChunk->poChunk = poData;
+    };
+
+    const char* pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    const int nThreads = std::max(1, std::min(128,
+        EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                           atoi(pszNumThreads)));
+    CPLWorkerThreadPool* poThreadPool =
+        nThreads > 1 && apoMissingChunks.size() > 1 && IsIReadThreadSafe() ?
+            GDALGetGlobalThreadPool(nThreads) : nullptr;
+    if( poThreadPool )
+    {
+        struct JobStruct
+        {
+            decltype(ReadChunk)* pReadChunk;
+            ChunkDesc* psChunk;
+        };
+        std::vector<JobStruct> asJobs;
+        for( auto* psChunk: apoMissingChunks )
+            asJobs.push_back(JobStruct{&ReadChunk, psChunk});
+        const auto JobFunc = [](void* pData)
+        {
+            auto psJob = static_cast<JobStruct*>(pData);
+            CPLInstallErrorHandlerAccumulator(psJob->psChunk->aoErrors);
+            (*psJob->pReadChunk)(psJob->psChunk);
+            CPLUninstallErrorHandlerAccumulator();
+        };
+        auto poJobQueue = poThreadPool->CreateJobQueue();
+        for( auto& sJob: asJobs )
+        {
+            if( !poJobQueue->SubmitJob(JobFunc, &sJob) )
+                ReadChunk(sJob.psChunk);
+        }
+        poJobQueue->WaitCompletion();
+        for( const auto* psChunk: apoMissingChunks )
+        {
+            for( const auto& oError: psChunk->aoErrors )
+                CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+        }
+    }
+    else
+    {
+        for( auto* psChunk: apoMissingChunks )
+        {
+            ReadChunk(psChunk);
+            if( !psChunk->bOK )
+                break;
+        }
+    }
+
+    for( const auto* psChunk: apoMissingChunks )
+    {
+        if( !psChunk->bOK || psChunk->poChunk == nullptr )
+            return false;
+        oCache.Put(psChunk->osKey, psChunk->poChunk, nMaxCacheSize);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Copy the requested values of each chunk to the buffer.          */
+/* -------------------------------------------------------------------- */
+    const GDALDataType eSrcDT = oDT.GetNumericDataType();
+    const GDALDataType eDstDT = bufferDataType.GetNumericDataType();
+    const size_t nBufferDTSize = bufferDataType.GetSize();
+    std::vector<size_t> anKMin(nDims);
+    std::vector<size_t> anKMax(nDims);
+    std::vector<size_t> anK(nDims);
+    std::vector<size_t> anChunkStride(nDims);
+    for( const auto& oChunk: aoChunks )
+    {
+        // Range of the indices k of the request, such that
+        // arrayStartIdx + k * arrayStep is in the chunk.
+        bool bEmpty = false;
+        size_t nStride = 1;
+        for( size_t i = nDims; i-- > 0; )
+        {
+            anChunkStride[i] = nStride;
+            nStride *= oChunk.anCount[i];
+
+            const GInt64 nStart = static_cast<GInt64>(arrayStartIdx[i]);
+            const GInt64 nStep = arrayStep[i];
+            const GInt64 nChunkFirst = static_cast<GInt64>(oChunk.anStartIdx[i]);
+            const GInt64 nChunkLast =
+                nChunkFirst + static_cast<GInt64>(oChunk.anCount[i]) - 1;
+            const GInt64 nKLast = static_cast<GInt64>(count[i]) - 1;
+            GInt64 nKMin = 0;
+            GInt64 nKMax = nKLast;
+            if( nStep > 0 )
+            {
+                if( nChunkFirst > nStart )
+                    nKMin = (nChunkFirst - nStart + nStep - 1) / nStep;
+                nKMax = std::min(nKLast,
+                    nChunkLast >= nStart ? (nChunkLast - nStart) / nStep : -1);
+            }
+            else if( nStep < 0 )
+            {
+                if( nStart > nChunkLast )
+                    nKMin = (nStart - nChunkLast - nStep - 1) / -nStep;
+                nKMax = std::min(nKLast,
+                    nStart >= nChunkFirst ? (nStart - nChunkFirst) / -nStep : -1);
+            }
+            else if( nStart < nChunkFirst || nStart > nChunkLast )
+            {
+                nKMax = -1;
+            }
+            if( nKMin > nKMax )
+            {
+                bEmpty = true;
+                break;
+            }
+            anKMin[i] = static_cast<size_t>(nKMin);
+            anKMax[i] = static_cast<size_t>(nKMax);
+        }
+        if( bEmpty )
+            continue;
+
+        const GByte* pabyChunk = oChunk.poChunk->data();
+        const size_t iLast = nDims - 1;
+        const size_t nInnerCount = anKMax[iLast] - anKMin[iLast] + 1;
+        const GIntBig nSrcInnerStride =
+            arrayStep[iLast] * static_cast<GIntBig>(nDTSize);
+        const GIntBig nDstInnerStride =
+            bufferStride[iLast] * static_cast<GIntBig>(nBufferDTSize);
+        const bool bCanCopyInnerAtOnce =
+            nInnerCount == 1 ||
+            (std::abs(nSrcInnerStride) <= INT_MAX &&
+             std::abs(nDstInnerStride) <= INT_MAX);
+
+        anK = anKMin;
+        while( true )
+        {
+            GPtrDiff_t nSrcOffset = 0;
+            GPtrDiff_t nDstOffset = 0;
+            for( size_t i = 0; i < nDims; ++i )
+            {
+                const GUInt64 nIdx = static_cast<GUInt64>(
+                    static_cast<GInt64>(arrayStartIdx[i]) +
+                    static_cast<GInt64>(anK[i]) * arrayStep[i]);
+                nSrcOffset += static_cast<GPtrDiff_t>(
+                    (nIdx - oChunk.anStartIdx[i]) * anChunkStride[i]);
+                nDstOffset +=
+                    static_cast<GPtrDiff_t>(anK[i]) * bufferStride[i];
+            }
+            const GByte* pabySrc = pabyChunk + nSrcOffset * nDTSize;
+            GByte* pabyDst = static_cast<GByte*>(pDstBuffer) +
+                             nDstOffset * static_cast<GPtrDiff_t>(nBufferDTSize);
+            if( bCanCopyInnerAtOnce )
+            {
+                GDALCopyWords64(pabySrc, eSrcDT,
+                                static_cast<int>(nSrcInnerStride),
+                                pabyDst, eDstDT,
+                                static_cast<int>(nDstInnerStride),
+                                static_cast<GPtrDiff_t>(nInnerCount));
+            }
+            else
+            {
+                for( size_t k = 0; k < nInnerCount; ++k )
+                {
+                    GDALCopyWords64(pabySrc + k * nSrcInnerStride, eSrcDT, 0,
+                                    pabyDst + k * nDstInnerStride, eDstDT, 0,
+                                    1);
+                }
+            }
+
+            // Next combination of the outer dimensions.
+            size_t i = iLast;
+            while( i-- > 0 )
+            {
+                if( ++anK[i] <= anKMax[i] )
+                    break;
+                anK[i] = anKMin[i];
+            }
+            if( i == static_cast<size_t>(-1) )
+                break;
+        }
+    }
+
+    return true;
+}
+
 /************************************************************************/
 /*                       GDALSlicedMDArray                              */
 /************************************************************************/
@@ -5755,6 +6527,483 @@ std::shared_ptr<GDALMDArray> GDALMDArray::GetMask(CPL_UNUSED
     return GDALMDArrayMask::Create(self);
 }
 
+/************************************************************************/
+/*                        GDALMDArrayReduction                          */
+/************************************************************************/
+
+class GDALMDArrayReduction final: public GDALMDArray
+{
+public:
+    enum class Operation
+    {
+        MEAN,
+        MIN,
+        MAX,
+        SUM,
+        COUNT
+    };
+
+private:
+    std::shared_ptr<GDALMDArray> m_poParent{};
+    size_t m_iDim = 0;
+    Operation m_eOperation = Operation::MEAN;
+    std::vector<std::shared_ptr<GDALDimension>> m_dims{};
+    GDALExtendedDataType m_dt{GDALExtendedDataType::Create(GDT_Float64)};
+    double m_dfNoData = std::numeric_limits<double>::quiet_NaN();
+    std::string m_osEmptyUnit{};
+
+    bool ReadSlab(GUInt64 nStart, size_t nCount,
+                  const std::vector<GUInt64>& anParentStart,
+                  std::vector<size_t>& anParentCount,
+                  const std::vector<GInt64>& anParentStep,
+                  const std::vector<GPtrDiff_t>& anParentStride,
+                  std::vector<double>& adfValues) const;
+
+protected:
+    GDALMDArrayReduction(const std::shared_ptr<GDALMDArray>& poParent,
+                         size_t iDim,
+                         Operation eOperation,
+                         const std::string& osOperation):
+        GDALAbstractMDArray(std::string(), "Reduction " + osOperation + " of " +
+            poParent->GetFullName() + " along " +
+            poParent->GetDimensions()[iDim]->GetName()),
+        GDALMDArray(std::string(), "Reduction " + osOperation + " of " +
+            poParent->GetFullName() + " along " +
+            poParent->GetDimensions()[iDim]->GetName()),
+        m_poParent(poParent),
+        m_iDim(iDim),
+        m_eOperation(eOperation)
+    {
+        const auto& parentDims = m_poParent->GetDimensions();
+        for( size_t i = 0; i < parentDims.size(); ++i )
+        {
+            if( i != iDim )
+                m_dims.push_back(parentDims[i]);
+        }
+    }
+
+    bool IRead(const GUInt64* arrayStartIdx,
+                      const size_t* count,
+                      const GInt64* arrayStep,
+                      const GPtrDiff_t* bufferStride,
+                      const GDALExtendedDataType& bufferDataType,
+                      void* pDstBuffer) const override;
+
+public:
+    static std::shared_ptr<GDALMDArrayReduction> Create(
+                                const std::shared_ptr<GDALMDArray>& poParent,
+                                size_t iDim,
+                                Operation eOperation,
+                                const std::string& osOperation)
+    {
+        auto newAr(std::shared_ptr<GDALMDArrayReduction>(
+            new GDALMDArrayReduction(poParent, iDim, eOperation, osOperation)));
+        newAr->SetSelf(newAr);
+        return newAr;
+    }
+
+    bool IsWritable() const override { return false; }
+
+    const std::string& GetFilename() const override { return m_poParent->GetFilename(); }
+
+    const std::vector<std::shared_ptr<GDALDimension>>& GetDimensions() const override { return m_dims; }
+
+    const GDALExtendedDataType &GetDataType() const override { return m_dt; }
+
+    const std::string& GetUnit() const override
+    {
+        return m_eOperation == Operation::COUNT ? m_osEmptyUnit :
+                                                  m_poParent->GetUnit();
+    }
+
+    std::shared_ptr<OGRSpatialReference> GetSpatialRef() const override
+    {
+        auto poSrcSRS = m_poParent->GetSpatialRef();
+        if( !poSrcSRS )
+            return nullptr;
+        std::vector<int> dstMapping;
+        for( int srcAxis: poSrcSRS->GetDataAxisToSRSAxisMapping() )
+        {
+            if( srcAxis == static_cast<int>(m_iDim) + 1 )
+                return nullptr;
+            dstMapping.push_back(srcAxis > static_cast<int>(m_iDim) + 1 ?
+                                    srcAxis - 1 : srcAxis);
+        }
+        auto poClone(std::shared_ptr<OGRSpatialReference>(poSrcSRS->Clone()));
+        poClone->SetDataAxisToSRSAxisMapping(dstMapping);
+        return poClone;
+    }
+
+    // Output elements without any valid input value are set to NaN for
+    // MEAN, MIN and MAX.
+    const void* GetRawNoDataValue() const override
+    {
+        return m_eOperation == Operation::MEAN ||
+               m_eOperation == Operation::MIN ||
+               m_eOperation == Operation::MAX ? &m_dfNoData : nullptr;
+    }
+
+    std::vector<GUInt64> GetBlockSize() const override
+    {
+        std::vector<GUInt64> ret;
+        const auto parentBlockSize(m_poParent->GetBlockSize());
+        for( size_t i = 0; i < parentBlockSize.size(); ++i )
+        {
+            if( i != m_iDim )
+                ret.push_back(parentBlockSize[i]);
+        }
+        return ret;
+    }
+};
+
+/************************************************************************/
+/*                      GDALMDArrayReduction::ReadSlab()                */
+/************************************************************************/
+
+/* Reads nCount values along the reduced dimension, starting at nStart, for
+ * all the output values, converted to double. */
+bool GDALMDArrayReduction::ReadSlab(GUInt64 nStart, size_t nCount,
+                                    const std::vector<GUInt64>& anParentStart,
+                                    std::vector<size_t>& anParentCount,
+                                    const std::vector<GInt64>& anParentStep,
+                                    const std::vector<GPtrDiff_t>& anParentStride,
+                                    std::vector<double>& adfValues) const
+{
+    auto anStart(anParentStart);
+    anStart[m_iDim] = nStart;
+    anParentCount[m_iDim] = nCount;
+    return m_poParent->Read(anStart.data(), anParentCount.data(),
+                            anParentStep.data(), anParentStride.data(),
+                            m_dt, adfValues.data());
+}
+
+/************************************************************************/
+/*                      GDALMDArrayReduction::IRead()                   */
+/************************************************************************/
+
+bool GDALMDArrayReduction::IRead(const GUInt64* arrayStartIdx,
+                                 const size_t* count,
+                                 const GInt64* arrayStep,
+                                 const GPtrDiff_t* bufferStride,
+                                 const GDALExtendedDataType& bufferDataType,
+                                 void* pDstBuffer) const
+{
+    const size_t nDims = m_dims.size();
+    const size_t nParentDims = nDims + 1;
+    size_t nOutElts = 1;
+    for( size_t i = 0; i < nDims; ++i )
+        nOutElts *= count[i];
+
+    // The parent is read by slabs along the reduced dimension, with the
+    // reduced dimension as the slowest varying one in the temporary buffer,
+    // so that each slab line is a contiguous copy of the output layout.
+    std::vector<GUInt64> anParentStart(nParentDims);
+    std::vector<size_t> anParentCount(nParentDims);
+    std::vector<GInt64> anParentStep(nParentDims);
+    std::vector<GPtrDiff_t> anParentStride(nParentDims);
+    {
+        GPtrDiff_t nStride = 1;
+        for( size_t i = nDims; i-- > 0; )
+        {
+            const size_t iParent = i < m_iDim ? i : i + 1;
+            anParentStart[iParent] = arrayStartIdx[i];
+            anParentCount[iParent] = count[i];
+            anParentStep[iParent] = arrayStep[i];
+            anParentStride[iParent] = nStride;
+            nStride *= static_cast<GPtrDiff_t>(count[i]);
+        }
+        anParentStep[m_iDim] = 1;
+        anParentStride[m_iDim] = static_cast<GPtrDiff_t>(nOutElts);
+    }
+
+    const GUInt64 nReducedSize = m_poParent->GetDimensions()[m_iDim]->GetSize();
+    const char* pszSwathSize = CPLGetConfigOption("GDAL_SWATH_SIZE", nullptr);
+    const GIntBig nMaxMem = pszSwathSize ? CPLAtoGIntBig(pszSwathSize) :
+                                           GDALGetCacheMax64() / 4;
+    // Two slab buffers are used: one being read while the other one is
+    // accumulated.
+    const size_t nSlabLines = static_cast<size_t>(std::max<GUInt64>(1,
+        std::min<GUInt64>(nReducedSize,
+            static_cast<GUInt64>(std::max<GIntBig>(0, nMaxMem)) /
+                (2 * sizeof(double) * nOutElts))));
+
+    std::vector<double> adfSum;
+    std::vector<double> adfMinMax;
+    std::vector<GUInt64> anCount;
+    std::vector<double> adfSlab;
+    std::vector<double> adfNextSlab;
+    try
+    {
+        if( m_eOperation == Operation::MIN || m_eOperation == Operation::MAX )
+            adfMinMax.resize(nOutElts);
+        else if( m_eOperation != Operation::COUNT )
+            adfSum.resize(nOutElts);
+        anCount.resize(nOutElts);
+        adfSlab.resize(nSlabLines * nOutElts);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate temporary buffers for %s",
+                 GetFullName().c_str());
+        return false;
+    }
+
+    bool bHasNoData = false;
+    const double dfNoData = m_poParent->GetNoDataValueAsDouble(&bHasNoData);
+
+    // Reading of the next slab is done by a worker thread, while the
+    // current one is accumulated.
+    const char* pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    const int nThreads = std::max(1, std::min(128,
+        EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                           atoi(pszNumThreads)));
+    CPLWorkerThreadPool* poThreadPool =
+        nThreads > 1 && nSlabLines < nReducedSize ?
+            GDALGetGlobalThreadPool(nThreads) : nullptr;
+    if( poThreadPool )
+    {
+        try
+        {
+            adfNextSlab.resize(adfSlab.size());
+        }
+        catch( const std::bad_alloc& )
+        {
+            poThreadPool = nullptr;
+        }
+    }
+
+    struct ReadJob
+    {
+        const GDALMDArrayReduction* poThis = nullptr;
+        GUInt64 nStart = 0;
+        size_t nCount = 0;
+        const std::vector<GUInt64>* panParentStart = nullptr;
+        std::vector<size_t> anParentCount{};
+        const std::vector<GInt64>* panParentStep = nullptr;
+        const std::vector<GPtrDiff_t>* panParentStride = nullptr;
+        std::vector<double>* padfValues = nullptr;
+        bool bOK = false;
+        std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+
+        static void Run(void* pData)
+        {
+            auto psJob = static_cast<ReadJob*>(pData);
+            CPLInstallErrorHandlerAccumulator(psJob->aoErrors);
+            psJob->bOK = psJob->poThis->ReadSlab(
+                psJob->nStart, psJob->nCount, *psJob->panParentStart,
+                psJob->anParentCount, *psJob->panParentStep,
+                *psJob->panParentStride, *psJob->padfValues);
+            CPLUninstallErrorHandlerAccumulator();
+        }
+    };
+    std::unique_ptr<CPLJobQueue> poJobQueue(
+        poThreadPool ? poThreadPool->CreateJobQueue() : nullptr);
+    ReadJob sNextJob;
+    bool bNextJobSubmitted = false;
+
+    GUInt64 nStart = 0;
+    size_t nCount = static_cast<size_t>(
+        std::min<GUInt64>(nSlabLines, nReducedSize));
+    if( !ReadSlab(nStart, nCount, anParentStart, anParentCount, anParentStep,
+                  anParentStride, adfSlab) )
+    {
+        return false;
+    }
+    while( true )
+    {
+        const GUInt64 nNextStart = nStart + nCount;
+        const size_t nNextCount = static_cast<size_t>(
+            std::min<GUInt64>(nSlabLines, nReducedSize - nNextStart));
+        if( poJobQueue && nNextCount > 0 )
+        {
+            sNextJob.poThis = this;
+            sNextJob.nStart = nNextStart;
+            sNextJob.nCount = nNextCount;
+            sNextJob.panParentStart = &anParentStart;
+            sNextJob.anParentCount = anParentCount;
+            sNextJob.panParentStep = &anParentStep;
+            sNextJob.panParentStride = &anParentStride;
+            sNextJob.padfValues = &adfNextSlab;
+            sNextJob.aoErrors.clear();
+            bNextJobSubmitted =
+                poJobQueue->SubmitJob(ReadJob::Run, &sNextJob);
+        }
+
+        // Accumulate the current slab.
+        for( size_t j = 0; j < nCount; ++j )
+        {
+            const double* padfLine = adfSlab.data() + j * nOutElts;
+            for( size_t k = 0; k < nOutElts; ++k )
+            {
+                const double dfVal = padfLine[k];
+                if( std::isnan(dfVal) || (bHasNoData && dfVal == dfNoData) )
+                    continue;
+                switch( m_eOperation )
+                {
+                    case Operation::MEAN:
+                    case Operation::SUM:
+                        adfSum[k] += dfVal;
+                        break;
+                    case Operation::MIN:
+                        if( anCount[k] == 0 || dfVal < adfMinMax[k] )
+                            adfMinMax[k] = dfVal;
+                        break;
+                    case Operation::MAX:
+                        if( anCount[k] == 0 || dfVal > adfMinMax[k] )
+                            adfMinMax[k] = dfVal;
+                        break;
+                    case Operation::COUNT:
+                        break;
+                }
+                anCount[k]++;
+            }
+        }
+
+        if( nNextCount == 0 )
+            break;
+        nStart = nNextStart;
+        nCount = nNextCount;
+        if( bNextJobSubmitted )
+        {
+            poJobQueue->WaitCompletion();
+            bNextJobSubmitted = false;
+            for( const auto& oError: sNextJob.aoErrors )
+                CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+            if( !sNextJob.bOK )
+                return false;
+            std::swap(adfSlab, adfNextSlab);
+        }
+        else if( !ReadSlab(nStart, nCount, anParentStart, anParentCount,
+                           anParentStep, anParentStride, adfSlab) )
+        {
+            return false;
+        }
+    }
+
+    // Write the results, in C order of the request, to the output buffer.
+    std::vector<size_t> anIdx(nDims);
+    for( size_t k = 0; k < nOutElts; ++k )
+    {
+        double dfRes = 0;
+        switch( m_eOperation )
+        {
+            case Operation::MEAN:
+                dfRes = anCount[k] ? adfSum[k] / anCount[k] : m_dfNoData;
+                break;
+            case Operation::SUM:
+                dfRes = adfSum[k];
+                break;
+            case Operation::MIN:
+            case Operation::MAX:
+                dfRes = anCount[k] ? adfMinMax[k] : m_dfNoData;
+                break;
+            case Operation::COUNT:
+                dfRes = static_cast<double>(anCount[k]);
+                break;
+        }
+
+        GPtrDiff_t nDstOffset = 0;
+        for( size_t i = 0; i < nDims; ++i )
+            nDstOffset += static_cast<GPtrDiff_t>(anIdx[i]) * bufferStride[i];
+        GDALExtendedDataType::CopyValue(
+            &dfRes, m_dt,
+            static_cast<GByte*>(pDstBuffer) +
+                nDstOffset * static_cast<GPtrDiff_t>(bufferDataType.GetSize()),
+            bufferDataType);
+
+        for( size_t i = nDims; i-- > 0; )
+        {
+            if( ++anIdx[i] < count[i] )
+                break;
+            anIdx[i] = 0;
+        }
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                           GetReduction()                             */
+/************************************************************************/
+
+/** Return a view of the current array reduced along one dimension.
+ *
+ * The returned array has the dimensions of the current array, except
+ * the reduced one. Each of its values is the result of the operation on the
+ * values of the current array along the reduced dimension, ignoring values
+ * equal to the nodata value and NaN. Its data type is Float64.
+ *
+ * Supported operations are MEAN, MIN, MAX, SUM and COUNT (number of valid
+ * values). For MEAN, MIN and MAX, elements without any valid value are set to
+ * NaN, which is the nodata value of the returned array.
+ *
+ * Values are computed lazily when reading the returned array, by reading the
+ * current array in slabs along the reduced dimension whose size is limited
+ * by the GDAL_SWATH_SIZE configuration option (defaults to a quarter of the
+ * block cache). When GDAL_NUM_THREADS is greater than 1, the next slab is
+ * read in a worker thread while the current one is accumulated.
+ *
+ * Scale and offset are not applied: use GetUnscaled() first if needed.
+ *
+ * This is the same as the C function GDALMDArrayGetReduction().
+ *
+ * @param osOperation MEAN, MIN, MAX, SUM or COUNT.
+ * @param iDim Index of the dimension to reduce, in [0, GetDimensionCount()-1].
+ * @param papszOptions NULL-terminated list of options, or NULL. Unused for now.
+ *
+ * @return a new array, that holds a reference to the original one, and thus is
+ * a view of it (not a copy), or nullptr in case of error.
+ * @since GDAL 3.4
+ */
+std::shared_ptr<GDALMDArray> GDALMDArray::GetReduction(
+                                        const std::string& osOperation,
+                                        size_t iDim,
+                                        CPL_UNUSED CSLConstList papszOptions) const
+{
+    auto self = std::dynamic_pointer_cast<GDALMDArray>(m_pSelf.lock());
+    if( !self )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                "Driver implementation issue: m_pSelf not set !");
+        return nullptr;
+    }
+    if( GetDataType().GetClass() != GEDTC_NUMERIC )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "GetReduction() only supports numeric data type");
+        return nullptr;
+    }
+    if( iDim >= GetDimensionCount() )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "GetReduction(): invalid dimension index");
+        return nullptr;
+    }
+
+    GDALMDArrayReduction::Operation eOperation;
+    if( EQUAL(osOperation.c_str(), "MEAN") )
+        eOperation = GDALMDArrayReduction::Operation::MEAN;
+    else if( EQUAL(osOperation.c_str(), "MIN") )
+        eOperation = GDALMDArrayReduction::Operation::MIN;
+    else if( EQUAL(osOperation.c_str(), "MAX") )
+        eOperation = GDALMDArrayReduction::Operation::MAX;
+    else if( EQUAL(osOperation.c_str(), "SUM") )
+        eOperation = GDALMDArrayReduction::Operation::SUM;
+    else if( EQUAL(osOperation.c_str(), "COUNT") )
+        eOperation = GDALMDArrayReduction::Operation::COUNT;
+    else
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "GetReduction(): unsupported operation %s",
+                 osOperation.c_str());
+        return nullptr;
+    }
+
+    return GDALMDArrayReduction::Create(self, iDim, eOperation,
+                                        CPLString(osOperation).toupper());
+}
+
 /************************************************************************/
 /*                         IsRegularlySpaced()                          */
 /************************************************************************/
@@ -9586,6 +10835,34 @@ GDALMDArrayH GDALMDArrayGetMask(GDALMDArrayH hArray, CSLConstList papszOptions)
     return new GDALMDArrayHS(unscaled);
 }
 
+/************************************************************************/
+/*                      GDALMDArrayGetReduction()                       */
+/************************************************************************/
+
+/** Return a view of the current array reduced along one dimension.
+ *
+ * Supported operations are MEAN, MIN, MAX, SUM and COUNT.
+ *
+ * The returned object should be released with GDALMDArrayRelease().
+ *
+ * This is the same as the C++ method GDALMDArray::GetReduction().
+ *
+ * @since GDAL 3.4
+ */
+GDALMDArrayH GDALMDArrayGetReduction(GDALMDArrayH hArray,
+                                     const char* pszOperation,
+                                     size_t iDim,
+                                     CSLConstList papszOptions)
+{
+    VALIDATE_POINTER1( hArray, __func__, nullptr );
+    VALIDATE_POINTER1( pszOperation, __func__, nullptr );
+    auto reduction = hArray->m_poImpl->GetReduction(pszOperation, iDim,
+                                                    papszOptions);
+    if( !reduction )
+        return nullptr;
+    return new GDALMDArrayHS(reduction);
+}
+
 /************************************************************************/
 /*                   GDALMDArrayGetResampled()                          */
 /************************************************************************/
@@ -37,13 +37,17 @@
 #endif
 
 #include <algorithm>
+#include <ctime>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include "cpl_config.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_mem_cache.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
@@ -396,6 +400,118 @@ GDALOpenInfo::~GDALOpenInfo()
     CSLDestroy( papszSiblingFiles );
 }
 
+/************************************************************************/
+/*                         Sibling files cache                          */
+/*                                                                      */
+/*      Process-wide cache of the directory listings done to get        */
+/*      sibling files, so that opening many files of a same directory   */
+/*      on a slow file system does not list it again and again. It is   */
+/*      enabled by setting GDAL_SIBLING_FILES_CACHE_SIZE to the maximum */
+/*      number of directories to cache. Entries expire after            */
+/*      GDAL_SIBLING_FILES_CACHE_TTL seconds (60 by default).           */
+/************************************************************************/
+
+namespace {
+struct SiblingFilesCacheEntry
+{
+    CPLStringList aosFiles{};
+    bool          bValid = false;  // false if the listing failed
+    int           nMaxFiles = 0;
+    time_t        nTimestamp = 0;
+};
+
+typedef lru11::Cache<std::string,
+                     std::shared_ptr<const SiblingFilesCacheEntry>>
+                                                    SiblingFilesCache;
+}
+
+static std::mutex sSiblingFilesCacheMutex;
+static std::unique_ptr<SiblingFilesCache> poSiblingFilesCache;
+
+static int GetSiblingFilesCacheSize()
+{
+    return std::max(0, atoi(CPLGetConfigOption(
+                                "GDAL_SIBLING_FILES_CACHE_SIZE", "0")));
+}
+
+/* Returns a copy of the cached listing of osDir, or false if not cached. */
+static bool GetCachedSiblingFiles( const std::string& osDir, int nMaxFiles,
+                                   char**& papszFiles )
+{
+    const int nCacheSize = GetSiblingFilesCacheSize();
+    std::lock_guard<std::mutex> oLock(sSiblingFilesCacheMutex);
+    if( nCacheSize == 0 || poSiblingFilesCache == nullptr )
+        return false;
+
+    std::shared_ptr<const SiblingFilesCacheEntry> poEntry;
+    if( !poSiblingFilesCache->tryGet(osDir, poEntry) )
+        return false;
+
+    const time_t nTTL = static_cast<time_t>(atoi(CPLGetConfigOption(
+                                "GDAL_SIBLING_FILES_CACHE_TTL", "60")));
+    if( poEntry->nMaxFiles != nMaxFiles ||
+        time(nullptr) - poEntry->nTimestamp > nTTL )
+    {
+        poSiblingFilesCache->remove(osDir);
+        return false;
+    }
+
+    papszFiles =
+        poEntry->bValid ? CSLDuplicate(poEntry->aosFiles.List()) : nullptr;
+    return true;
+}
+
+static void CacheSiblingFiles( const std::string& osDir, int nMaxFiles,
+                               char** papszFiles )
+{
+    const int nCacheSize = GetSiblingFilesCacheSize();
+    if( nCacheSize == 0 )
+        return;
+
+    auto poEntry = std::make_shared<SiblingFilesCacheEntry>();
+    poEntry->aosFiles = CSLDuplicate(papszFiles);
+    poEntry->bValid = papszFiles != nullptr;
+    poEntry->nMaxFiles = nMaxFiles;
+    poEntry->nTimestamp = time(nullptr);
+
+    std::lock_guard<std::mutex> oLock(sSiblingFilesCacheMutex);
+    if( poSiblingFilesCache == nullptr ||
+        poSiblingFilesCache->getMaxSize() != static_cast<size_t>(nCacheSize) )
+    {
+        poSiblingFilesCache.reset(new SiblingFilesCache(nCacheSize, 0));
+    }
+    poSiblingFilesCache->insert(osDir, poEntry);
+}
+
+/************************************************************************/
+/*                     GDALClearSiblingFilesCache()                     */
+/************************************************************************/
+
+/**
+ * \brief Invalidate cached directory listings used for sibling files.
+ *
+ * When the GDAL_SIBLING_FILES_CACHE_SIZE configuration option is set,
+ * GDALOpen() caches the listings of the directories it scans to find the
+ * sibling files of a dataset. This function must be called after files have
+ * been added to or removed from a directory by other means than GDAL drivers,
+ * for the change to be taken into account before the cached listing expires.
+ *
+ * @param pszDirname directory whose listing must be invalidated, or NULL to
+ * invalidate all of them.
+ *
+ * @since GDAL 3.4
+ */
+void GDALClearSiblingFilesCache( const char* pszDirname )
+{
+    std::lock_guard<std::mutex> oLock(sSiblingFilesCacheMutex);
+    if( poSiblingFilesCache == nullptr )
+        return;
+    if( pszDirname == nullptr )
+        poSiblingFilesCache->clear();
+    else
+        poSiblingFilesCache->remove(pszDirname);
+}
+
 /************************************************************************/
 /*                         GetSiblingFiles()                            */
 /************************************************************************/
@@ -417,6 +533,9 @@ char** GDALOpenInfo::GetSiblingFiles()
     CPLString osDir = CPLGetDirname( pszFilename );
     const int nMaxFiles =
         atoi(CPLGetConfigOption("GDAL_READDIR_LIMIT_ON_OPEN", "1000"));
+    if( GetCachedSiblingFiles(osDir, nMaxFiles, papszSiblingFiles) )
+        return papszSiblingFiles;
+
     papszSiblingFiles = VSIReadDirEx( osDir, nMaxFiles );
     if( nMaxFiles > 0 && CSLCount(papszSiblingFiles) > nMaxFiles )
     {
@@ -425,7 +544,7 @@ char** GDALOpenInfo::GetSiblingFiles()
         CSLDestroy(papszSiblingFiles);
         papszSiblingFiles = nullptr;
     }
-
+    CacheSiblingFiles(osDir, nMaxFiles, papszSiblingFiles);
 
     return papszSiblingFiles;
 }
@@ -427,6 +427,31 @@ void GDALPamDataset::PamClear()
     }
 }
 
+/************************************************************************/
+/*                          LoadDeferredPam()                           */
+/*                                                                      */
+/*      Read the .aux.xml whose loading was postponed by TryLoadXML()   */
+/*      when GDAL_PAM_LAZY_LOADING is enabled.                          */
+/************************************************************************/
+
+void GDALPamDataset::LoadDeferredPam()
+
+{
+    if( !(nPamFlags & GPF_LOAD_DEFERRED) || psPam == nullptr )
+        return;
+
+    nPamFlags &= ~GPF_LOAD_DEFERRED;
+
+    // Modifications done since the dataset was opened must not be lost
+    // because TryLoadXML() clears the dirty flag.
+    const int nDirtyFlag = nPamFlags & GPF_DIRTY;
+    psPam->bInDeferredLoad = true;
+    TryLoadXML(nullptr);
+    if( psPam )
+        psPam->bInDeferredLoad = false;
+    nPamFlags |= nDirtyFlag;
+}
+
 /************************************************************************/
 /*                              XMLInit()                               */
 /************************************************************************/
@@ -845,13 +870,36 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
     if( !BuildPamFilename() )
         return CE_None;
 
+/* -------------------------------------------------------------------- */
+/*      If lazy loading is enabled, postpone reading the .aux.xml       */
+/*      until PAM information is actually requested, unless a           */
+/*      reliable sibling list already tells us that it does not         */
+/*      exist.                                                          */
+/* -------------------------------------------------------------------- */
+    if( !psPam->bInDeferredLoad &&
+        CPLTestBool(CPLGetConfigOption("GDAL_PAM_LAZY_LOADING", "NO")) )
+    {
+        const bool bKnownAbsent =
+            papszSiblingFiles != nullptr &&
+            IsPamFilenameAPotentialSiblingFile() &&
+            GDALCanReliablyUseSiblingFileList(psPam->pszPamFilename) &&
+            CSLFindString( papszSiblingFiles,
+                           CPLGetFilename(psPam->pszPamFilename) ) < 0;
+        if( !bKnownAbsent )
+        {
+            nPamFlags |= GPF_LOAD_DEFERRED;
+            return CE_None;
+        }
+    }
+
 /* -------------------------------------------------------------------- */
 /*      In case the PAM filename is a .aux.xml file next to the         */
 /*      physical file and we have a siblings list, then we can skip     */
 /*      stat'ing the filesystem.                                        */
 /* -------------------------------------------------------------------- */
     VSIStatBufL sStatBuf;
-    CPLXMLNode *psTree = nullptr;
+    // The tree is only read by XMLInit(), so use the faster arena parser.
+    CPLXMLArenaTreeCloser oTreeCloser(nullptr);
 
     CPLErr eLastErr = CPLGetLastErrorType();
     int nLastErrNo = CPLGetLastErrorNo();
@@ -867,7 +915,7 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
         {
             CPLErrorReset();
             CPLPushErrorHandler( CPLQuietErrorHandler );
-            psTree = CPLParseXMLFile( psPam->pszPamFilename );
+            oTreeCloser.reset( CPLParseXMLFileArena( psPam->pszPamFilename ) );
             CPLPopErrorHandler();
             CPLErrorReset();
         }
@@ -879,10 +927,11 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
     {
         CPLErrorReset();
         CPLPushErrorHandler( CPLQuietErrorHandler );
-        psTree = CPLParseXMLFile( psPam->pszPamFilename );
+        oTreeCloser.reset( CPLParseXMLFileArena( psPam->pszPamFilename ) );
         CPLPopErrorHandler();
         CPLErrorReset();
     }
+    CPLXMLNode *psTree = oTreeCloser.get();
 
     if( eLastErr != CE_None )
         CPLErrorSetState( eLastErr, nLastErrNo, osLastErrorMsg.c_str() );
@@ -910,10 +959,7 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
             break;
         }
 
-        if( psSubTree != nullptr )
-            psSubTree = CPLCloneXMLTree( psSubTree );
-
-        CPLDestroyXMLNode( psTree );
+        // The subtree remains owned by oTreeCloser.
         psTree = psSubTree;
     }
 
@@ -930,7 +976,7 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
     CPLString osVRTPath(CPLGetPath(psPam->pszPamFilename));
     const CPLErr eErr = XMLInit( psTree, osVRTPath );
 
-    CPLDestroyXMLNode( psTree );
+    oTreeCloser.reset();
 
     if( eErr != CE_None )
         PamClear();
@@ -945,6 +991,9 @@ CPLErr GDALPamDataset::TryLoadXML(char **papszSiblingFiles)
 CPLErr GDALPamDataset::TrySaveXML()
 
 {
+    // Make sure not to overwrite a .aux.xml we have not read yet.
+    LoadDeferredPam();
+
     nPamFlags &= ~GPF_DIRTY;
 
     if( psPam == nullptr || (nPamFlags & GPF_NOSAVE) )
@@ -1030,6 +1079,7 @@ CPLErr GDALPamDataset::TrySaveXML()
     const int bSaved =
         CPLSerializeXMLTreeToFile( psTree, psPam->pszPamFilename );
     CPLPopErrorHandler();
+    GDALClearSiblingFilesCache(CPLGetDirname(psPam->pszPamFilename));
 
 /* -------------------------------------------------------------------- */
 /*      If it fails, check if we have a proxy directory for auxiliary    */
@@ -1080,6 +1130,8 @@ CPLErr GDALPamDataset::TrySaveXML()
 CPLErr GDALPamDataset::CloneInfo( GDALDataset *poSrcDS, int nCloneFlags )
 
 {
+    LoadDeferredPam();
+
     const int bOnlyIfMissing = nCloneFlags & GCIF_ONLY_IF_MISSING;
     const int nSavedMOFlags = GetMOFlags();
 
@@ -1211,6 +1263,8 @@ CPLErr GDALPamDataset::CloneInfo( GDALDataset *poSrcDS, int nCloneFlags )
 char **GDALPamDataset::GetFileList()
 
 {
+    LoadDeferredPam();
+
     char **papszFileList = GDALDataset::GetFileList();
 
     if( psPam && !psPam->osPhysicalFilename.empty()
@@ -1305,6 +1359,8 @@ CPLErr GDALPamDataset::IBuildOverviews( const char *pszResampling,
 const OGRSpatialReference *GDALPamDataset::GetSpatialRef() const
 
 {
+    const_cast<GDALPamDataset*>(this)->LoadDeferredPam();
+
     if( psPam && psPam->poSRS )
         return psPam->poSRS;
 
@@ -1318,6 +1374,8 @@ const OGRSpatialReference *GDALPamDataset::GetSpatialRef() const
 CPLErr GDALPamDataset::SetSpatialRef( const OGRSpatialReference* poSRS )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam == nullptr )
@@ -1338,6 +1396,8 @@ CPLErr GDALPamDataset::SetSpatialRef( const OGRSpatialReference* poSRS )
 CPLErr GDALPamDataset::GetGeoTransform( double * padfTransform )
 
 {
+    LoadDeferredPam();
+
     if( psPam && psPam->bHaveGeoTransform )
     {
         memcpy( padfTransform, psPam->adfGeoTransform, sizeof(double) * 6 );
@@ -1354,6 +1414,8 @@ CPLErr GDALPamDataset::GetGeoTransform( double * padfTransform )
 CPLErr GDALPamDataset::SetGeoTransform( double * padfTransform )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam )
@@ -1374,6 +1436,8 @@ CPLErr GDALPamDataset::SetGeoTransform( double * padfTransform )
 int GDALPamDataset::GetGCPCount()
 
 {
+    LoadDeferredPam();
+
     if( psPam && psPam->nGCPCount > 0 )
         return psPam->nGCPCount;
 
@@ -1387,6 +1451,8 @@ int GDALPamDataset::GetGCPCount()
 const OGRSpatialReference *GDALPamDataset::GetGCPSpatialRef() const
 
 {
+    const_cast<GDALPamDataset*>(this)->LoadDeferredPam();
+
     if( psPam && psPam->poGCP_SRS != nullptr )
         return psPam->poGCP_SRS;
 
@@ -1400,6 +1466,8 @@ const OGRSpatialReference *GDALPamDataset::GetGCPSpatialRef() const
 const GDAL_GCP *GDALPamDataset::GetGCPs()
 
 {
+    LoadDeferredPam();
+
     if( psPam && psPam->nGCPCount > 0 )
         return psPam->pasGCPList;
 
@@ -1414,6 +1482,8 @@ CPLErr GDALPamDataset::SetGCPs( int nGCPCount, const GDAL_GCP *pasGCPList,
                                 const OGRSpatialReference* poGCP_SRS )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam )
@@ -1446,6 +1516,8 @@ CPLErr GDALPamDataset::SetMetadata( char **papszMetadata,
                                     const char *pszDomain )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam )
@@ -1466,6 +1538,8 @@ CPLErr GDALPamDataset::SetMetadataItem( const char *pszName,
                                         const char *pszDomain )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam )
@@ -1485,6 +1559,8 @@ const char *GDALPamDataset::GetMetadataItem( const char *pszName,
                                              const char *pszDomain )
 
 {
+    LoadDeferredPam();
+
 /* -------------------------------------------------------------------- */
 /*      A request against the ProxyOverviewRequest is a special         */
 /*      mechanism to request an overview filename be allocated in       */
@@ -1548,10 +1624,24 @@ const char *GDALPamDataset::GetMetadataItem( const char *pszName,
 char **GDALPamDataset::GetMetadata( const char *pszDomain )
 
 {
+    LoadDeferredPam();
+
     // if( pszDomain == nullptr || !EQUAL(pszDomain,"ProxyOverviewRequest") )
     return GDALDataset::GetMetadata( pszDomain );
 }
 
+/************************************************************************/
+/*                       GetMetadataDomainList()                        */
+/************************************************************************/
+
+char **GDALPamDataset::GetMetadataDomainList()
+
+{
+    LoadDeferredPam();
+
+    return GDALDataset::GetMetadataDomainList();
+}
+
 /************************************************************************/
 /*                             TryLoadAux()                             */
 /************************************************************************/
@@ -1791,6 +1881,8 @@ CPLErr GDALPamDataset::_SetGCPs( int nGCPCount,
 
 void GDALPamDataset::ClearStatistics()
 {
+    LoadDeferredPam();
+
     PamInitialize();
     if( !psPam )
         return;
@@ -1837,6 +1929,8 @@ bool GDALPamDataset::GetMDArrayStatistics( const char* pszMDArrayId,
                                            double *pdfMean, double *pdfStdDev,
                                            GUInt64 *pnValidCount )
 {
+    LoadDeferredPam();
+
     PamInitialize();
     if( !psPam )
     {
@@ -1873,6 +1967,8 @@ void GDALPamDataset::StoreMDArrayStatistics( const char* pszMDArrayId,
                                  double dfMean, double dfStdDev,
                                  GUInt64 nValidCount )
 {
+    LoadDeferredPam();
+
     PamInitialize();
     if( !psPam )
         return;
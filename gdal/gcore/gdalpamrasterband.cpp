@@ -336,6 +336,17 @@ void GDALPamRasterBand::PamClear()
     psPam = nullptr;
 }
 
+/************************************************************************/
+/*                          LoadDeferredPam()                           */
+/************************************************************************/
+
+void GDALPamRasterBand::LoadDeferredPam()
+
+{
+    if( psPam && psPam->poParentDS )
+        psPam->poParentDS->LoadDeferredPam();
+}
+
 /************************************************************************/
 /*                              XMLInit()                               */
 /************************************************************************/
@@ -520,6 +531,8 @@ CPLErr GDALPamRasterBand::CloneInfo( GDALRasterBand *poSrcBand,
                                      int nCloneFlags )
 
 {
+    LoadDeferredPam();
+
     const bool bOnlyIfMissing = (nCloneFlags & GCIF_ONLY_IF_MISSING) != 0;
     const int nSavedMOFlags = GetMOFlags();
 
@@ -691,6 +704,8 @@ CPLErr GDALPamRasterBand::SetMetadata( char **papszMetadata,
                                        const char *pszDomain )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam )
@@ -708,6 +723,8 @@ CPLErr GDALPamRasterBand::SetMetadataItem( const char *pszName,
                                            const char *pszDomain )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam )
@@ -716,6 +733,43 @@ CPLErr GDALPamRasterBand::SetMetadataItem( const char *pszName,
     return GDALRasterBand::SetMetadataItem( pszName, pszValue, pszDomain );
 }
 
+/************************************************************************/
+/*                            GetMetadata()                             */
+/************************************************************************/
+
+char **GDALPamRasterBand::GetMetadata( const char *pszDomain )
+
+{
+    LoadDeferredPam();
+
+    return GDALRasterBand::GetMetadata( pszDomain );
+}
+
+/************************************************************************/
+/*                          GetMetadataItem()                           */
+/************************************************************************/
+
+const char *GDALPamRasterBand::GetMetadataItem( const char *pszName,
+                                                const char *pszDomain )
+
+{
+    LoadDeferredPam();
+
+    return GDALRasterBand::GetMetadataItem( pszName, pszDomain );
+}
+
+/************************************************************************/
+/*                       GetMetadataDomainList()                        */
+/************************************************************************/
+
+char **GDALPamRasterBand::GetMetadataDomainList()
+
+{
+    LoadDeferredPam();
+
+    return GDALRasterBand::GetMetadataDomainList();
+}
+
 /************************************************************************/
 /*                           SetNoDataValue()                           */
 /************************************************************************/
@@ -723,6 +777,8 @@ CPLErr GDALPamRasterBand::SetMetadataItem( const char *pszName,
 CPLErr GDALPamRasterBand::SetNoDataValue( double dfNewValue )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( !psPam )
@@ -741,6 +797,8 @@ CPLErr GDALPamRasterBand::SetNoDataValue( double dfNewValue )
 CPLErr GDALPamRasterBand::DeleteNoDataValue()
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( !psPam )
@@ -759,6 +817,8 @@ CPLErr GDALPamRasterBand::DeleteNoDataValue()
 double GDALPamRasterBand::GetNoDataValue( int *pbSuccess )
 
 {
+    LoadDeferredPam();
+
     if( psPam == nullptr )
         return GDALRasterBand::GetNoDataValue( pbSuccess );
 
@@ -775,6 +835,8 @@ double GDALPamRasterBand::GetNoDataValue( int *pbSuccess )
 double GDALPamRasterBand::GetOffset( int *pbSuccess )
 
 {
+    LoadDeferredPam();
+
     if( !psPam )
         return GDALRasterBand::GetOffset( pbSuccess );
 
@@ -791,6 +853,8 @@ double GDALPamRasterBand::GetOffset( int *pbSuccess )
 CPLErr GDALPamRasterBand::SetOffset( double dfNewOffset )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam == nullptr )
@@ -813,6 +877,8 @@ CPLErr GDALPamRasterBand::SetOffset( double dfNewOffset )
 double GDALPamRasterBand::GetScale( int *pbSuccess )
 
 {
+    LoadDeferredPam();
+
     if( !psPam )
         return GDALRasterBand::GetScale( pbSuccess );
 
@@ -829,6 +895,8 @@ double GDALPamRasterBand::GetScale( int *pbSuccess )
 CPLErr GDALPamRasterBand::SetScale( double dfNewScale )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam == nullptr )
@@ -850,6 +918,8 @@ CPLErr GDALPamRasterBand::SetScale( double dfNewScale )
 const char *GDALPamRasterBand::GetUnitType()
 
 {
+    LoadDeferredPam();
+
     if( psPam == nullptr )
         return GDALRasterBand::GetUnitType();
 
@@ -866,6 +936,8 @@ const char *GDALPamRasterBand::GetUnitType()
 CPLErr GDALPamRasterBand::SetUnitType( const char *pszNewValue )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( !psPam )
@@ -897,6 +969,8 @@ CPLErr GDALPamRasterBand::SetUnitType( const char *pszNewValue )
 char **GDALPamRasterBand::GetCategoryNames()
 
 {
+    LoadDeferredPam();
+
     if( psPam )
         return psPam->papszCategoryNames;
 
@@ -910,6 +984,8 @@ char **GDALPamRasterBand::GetCategoryNames()
 CPLErr GDALPamRasterBand::SetCategoryNames( char ** papszNewNames )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( !psPam )
@@ -928,6 +1004,8 @@ CPLErr GDALPamRasterBand::SetCategoryNames( char ** papszNewNames )
 GDALColorTable *GDALPamRasterBand::GetColorTable()
 
 {
+    LoadDeferredPam();
+
     if( psPam )
         return psPam->poColorTable;
 
@@ -941,6 +1019,8 @@ GDALColorTable *GDALPamRasterBand::GetColorTable()
 CPLErr GDALPamRasterBand::SetColorTable( GDALColorTable *poTableIn )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( !psPam )
@@ -970,6 +1050,8 @@ CPLErr GDALPamRasterBand::SetColorTable( GDALColorTable *poTableIn )
 CPLErr GDALPamRasterBand::SetColorInterpretation( GDALColorInterp eInterpIn )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam )
@@ -991,6 +1073,8 @@ CPLErr GDALPamRasterBand::SetColorInterpretation( GDALColorInterp eInterpIn )
 GDALColorInterp GDALPamRasterBand::GetColorInterpretation()
 
 {
+    LoadDeferredPam();
+
     if( psPam )
         return psPam->eColorInterp;
 
@@ -1007,6 +1091,8 @@ GDALColorInterp GDALPamRasterBand::GetColorInterpretation()
 void GDALPamRasterBand::SetDescription( const char *pszDescription )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam && strcmp(pszDescription,GetDescription()) != 0 )
@@ -1181,6 +1267,8 @@ CPLErr GDALPamRasterBand::GetHistogram( double dfMin, double dfMax,
                                         void *pProgressData )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam == nullptr )
@@ -1254,6 +1342,8 @@ CPLErr GDALPamRasterBand::SetDefaultHistogram( double dfMin, double dfMax,
                                                GUIntBig *panHistogram )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam == nullptr )
@@ -1310,6 +1400,8 @@ GDALPamRasterBand::GetDefaultHistogram( double *pdfMin, double *pdfMax,
                                         void *pProgressData )
 
 {
+    LoadDeferredPam();
+
     if( psPam && psPam->psSavedHistograms != nullptr )
     {
         CPLXMLNode *psXMLHist = psPam->psSavedHistograms->psChild;
@@ -1344,6 +1436,8 @@ GDALPamRasterBand::GetDefaultHistogram( double *pdfMin, double *pdfMax,
 GDALRasterAttributeTable *GDALPamRasterBand::GetDefaultRAT()
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam == nullptr )
@@ -1359,6 +1453,8 @@ GDALRasterAttributeTable *GDALPamRasterBand::GetDefaultRAT()
 CPLErr GDALPamRasterBand::SetDefaultRAT( const GDALRasterAttributeTable *poRAT )
 
 {
+    LoadDeferredPam();
+
     PamInitialize();
 
     if( psPam == nullptr )
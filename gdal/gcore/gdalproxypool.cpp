@@ -63,6 +63,17 @@ static GDALDatasetPool* singleton = nullptr;
 
 void GDALNullifyProxyPoolSingleton() { singleton = nullptr; }
 
+/* This variable prevents a dataset that is going to be opened in GDALDatasetPool::_RefDataset */
+/* from increasing refCount if, during its opening, it creates a GDALProxyPoolDataset */
+/* We increment it before opening or closing a cached dataset and decrement it afterwards */
+/* The typical use case is a VRT made of simple sources that are VRT */
+/* We don't want the "inner" VRT to take a reference on the pool, otherwise there is */
+/* a high chance that this reference will not be dropped and the pool remain ghost */
+/* Opening and closing are done without holding the pool mutex, so that */
+/* several threads can open different datasets concurrently, hence this is */
+/* a per-thread counter */
+static thread_local int gnThreadRefCountOfDisableRefCount = 0;
+
 struct _GDALProxyPoolCacheEntry
 {
     GIntBig       responsiblePID;
@@ -73,6 +84,10 @@ struct _GDALProxyPoolCacheEntry
     /* Ref count of the cached dataset */
     int           refCount;
 
+    /* Set while the dataset is being opened by a thread that has released */
+    /* the pool mutex. Other threads that want that entry must wait */
+    bool          bOpening;
+
     GDALProxyPoolCacheEntry* prev;
     GDALProxyPoolCacheEntry* next;
 };
@@ -93,14 +108,14 @@ class GDALDatasetPool
         GDALProxyPoolCacheEntry* firstEntry = nullptr;
         GDALProxyPoolCacheEntry* lastEntry = nullptr;
 
-        /* This variable prevents a dataset that is going to be opened in GDALDatasetPool::_RefDataset */
-        /* from increasing refCount if, during its opening, it creates a GDALProxyPoolDataset */
-        /* We increment it before opening or closing a cached dataset and decrement it afterwards */
-        /* The typical use case is a VRT made of simple sources that are VRT */
-        /* We don't want the "inner" VRT to take a reference on the pool, otherwise there is */
-        /* a high chance that this reference will not be dropped and the pool remain ghost */
+        /* This variable prevents GDALProxyPoolDataset objects from taking a */
+        /* reference on the pool while the driver manager is being destroyed. */
+        /* See also gnThreadRefCountOfDisableRefCount */
         int refCountOfDisableRefCount= 0;
 
+        /* Signaled each time the opening of an entry is completed */
+        CPLCond* hCondOpening = nullptr;
+
         /* Caution : to be sure that we don't run out of entries, size must be at */
         /* least greater or equal than the maximum number of threads */
         explicit GDALDatasetPool(int maxSize);
@@ -145,7 +160,8 @@ class GDALDatasetPool
 /*                         GDALDatasetPool()                            */
 /************************************************************************/
 
-GDALDatasetPool::GDALDatasetPool(int maxSizeIn): maxSize(maxSizeIn)
+GDALDatasetPool::GDALDatasetPool(int maxSizeIn): maxSize(maxSizeIn),
+    hCondOpening(CPLCreateCond())
 {
 }
 
@@ -173,6 +189,8 @@ GDALDatasetPool::~GDALDatasetPool()
         cur = next;
     }
     GDALSetResponsiblePIDForCurrentThread(responsiblePID);
+    if( hCondOpening )
+        CPLDestroyCond(hCondOpening);
 }
 
 #ifdef DEBUG_PROXY_POOL
@@ -227,55 +245,82 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
                                                       bool bForceOpen,
                                                       const char* pszOwner)
 {
-    if( bInDestruction )
-        return nullptr;
-
-    GDALProxyPoolCacheEntry* cur = firstEntry;
+    CPLMutex* hMutex = *GDALGetphDLMutex();
     GIntBig responsiblePID = GDALGetResponsiblePIDForCurrentThread();
+    GDALProxyPoolCacheEntry* cur = nullptr;
     GDALProxyPoolCacheEntry* lastEntryWithZeroRefCount = nullptr;
 
-    while(cur)
+    while( true )
     {
-        GDALProxyPoolCacheEntry* next = cur->next;
+        if( bInDestruction )
+            return nullptr;
 
-        if (strcmp(cur->pszFileName, pszFileName) == 0 &&
-            ((bShared && cur->responsiblePID == responsiblePID &&
-              ((cur->pszOwner == nullptr && pszOwner == nullptr) ||
-                (cur->pszOwner != nullptr && pszOwner != nullptr &&
-                 strcmp(cur->pszOwner, pszOwner) == 0))) ||
-             (!bShared && cur->refCount == 0)) )
+        cur = firstEntry;
+        lastEntryWithZeroRefCount = nullptr;
+        bool bWaitForOpening = false;
+
+        while(cur)
         {
-            if (cur != firstEntry)
+            GDALProxyPoolCacheEntry* next = cur->next;
+
+            if (strcmp(cur->pszFileName, pszFileName) == 0 &&
+                ((bShared && cur->responsiblePID == responsiblePID &&
+                  ((cur->pszOwner == nullptr && pszOwner == nullptr) ||
+                    (cur->pszOwner != nullptr && pszOwner != nullptr &&
+                     strcmp(cur->pszOwner, pszOwner) == 0))) ||
+                 (!bShared && cur->refCount == 0)) )
             {
-                /* Move to begin */
-                if (cur->next)
-                    cur->next->prev = cur->prev;
-                else
-                    lastEntry = cur->prev;
-                cur->prev->next = cur->next;
-                cur->prev = nullptr;
-                firstEntry->prev = cur;
-                cur->next = firstEntry;
-                firstEntry = cur;
+                if( cur->bOpening )
+                {
+                    /* Another thread is opening that very dataset */
+                    bWaitForOpening = true;
+                    break;
+                }
+
+                if (cur != firstEntry)
+                {
+                    /* Move to begin */
+                    if (cur->next)
+                        cur->next->prev = cur->prev;
+                    else
+                        lastEntry = cur->prev;
+                    cur->prev->next = cur->next;
+                    cur->prev = nullptr;
+                    firstEntry->prev = cur;
+                    cur->next = firstEntry;
+                    firstEntry = cur;
 
 #ifdef DEBUG_PROXY_POOL
-                CheckLinks();
+                    CheckLinks();
 #endif
+                }
+
+                cur->refCount ++;
+                return cur;
             }
 
-            cur->refCount ++;
-            return cur;
+            if (cur->refCount == 0)
+                lastEntryWithZeroRefCount = cur;
+
+            cur = next;
         }
 
-        if (cur->refCount == 0)
-            lastEntryWithZeroRefCount = cur;
+        if( !bWaitForOpening )
+            break;
+        if( !bForceOpen )
+            return nullptr;
 
-        cur = next;
+        /* Wait for the opening to complete and rescan, as the list may */
+        /* have been modified in the meantime */
+        CPLCondWait(hCondOpening, hMutex);
     }
 
     if( !bForceOpen )
         return nullptr;
 
+    GDALDataset* poDSToClose = nullptr;
+    GIntBig responsiblePIDOfDSToClose = 0;
+
     if (currentSize == maxSize)
     {
         if (lastEntryWithZeroRefCount == nullptr)
@@ -287,20 +332,10 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
             return nullptr;
         }
 
-        lastEntryWithZeroRefCount->pszFileName[0] = '\0';
-        if (lastEntryWithZeroRefCount->poDS)
-        {
-            /* Close by pretending we are the thread that GDALOpen'ed this */
-            /* dataset */
-            GDALSetResponsiblePIDForCurrentThread(lastEntryWithZeroRefCount->responsiblePID);
-
-            refCountOfDisableRefCount ++;
-            GDALClose(lastEntryWithZeroRefCount->poDS);
-            refCountOfDisableRefCount --;
-
-            lastEntryWithZeroRefCount->poDS = nullptr;
-            GDALSetResponsiblePIDForCurrentThread(responsiblePID);
-        }
+        /* The evicted dataset is closed below, after the mutex is released */
+        poDSToClose = lastEntryWithZeroRefCount->poDS;
+        responsiblePIDOfDSToClose = lastEntryWithZeroRefCount->responsiblePID;
+        lastEntryWithZeroRefCount->poDS = nullptr;
         CPLFree(lastEntryWithZeroRefCount->pszFileName);
         CPLFree(lastEntryWithZeroRefCount->pszOwner);
 
@@ -348,13 +383,39 @@ GDALProxyPoolCacheEntry* GDALDatasetPool::_RefDataset(const char* pszFileName,
     cur->pszOwner = (pszOwner) ? CPLStrdup(pszOwner) : nullptr;
     cur->responsiblePID = responsiblePID;
     cur->refCount = 1;
+    cur->poDS = nullptr;
+    cur->bOpening = true;
+
+    /* Closing the evicted dataset and opening the new one can be slow */
+    /* (network file systems, VRT sources, etc.), so do it without holding */
+    /* the mutex, so that other threads can use or open other datasets */
+    /* of the pool in the meantime. The entry is protected from eviction by */
+    /* its reference count, and from being shared by its bOpening flag. */
+    CPLReleaseMutex(hMutex);
+
+    gnThreadRefCountOfDisableRefCount ++;
+    if( poDSToClose )
+    {
+        /* Close by pretending we are the thread that GDALOpen'ed this */
+        /* dataset */
+        GDALSetResponsiblePIDForCurrentThread(responsiblePIDOfDSToClose);
+        GDALClose(poDSToClose);
+        GDALSetResponsiblePIDForCurrentThread(responsiblePID);
+    }
 
-    refCountOfDisableRefCount ++;
     int nFlag = ((eAccess == GA_Update) ? GDAL_OF_UPDATE : GDAL_OF_READONLY) | GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR;
-    CPLConfigOptionSetter oSetter("CPL_ALLOW_VSISTDIN", "NO", true);
-    cur->poDS = GDALDataset::Open( pszFileName, nFlag, nullptr,
-                                            papszOpenOptions, nullptr );
-    refCountOfDisableRefCount --;
+    GDALDataset* poDS;
+    {
+        CPLConfigOptionSetter oSetter("CPL_ALLOW_VSISTDIN", "NO", true);
+        poDS = GDALDataset::Open( pszFileName, nFlag, nullptr,
+                                  papszOpenOptions, nullptr );
+    }
+    gnThreadRefCountOfDisableRefCount --;
+
+    CPLAcquireMutex(hMutex, 1000.0);
+    cur->poDS = poDS;
+    cur->bOpening = false;
+    CPLCondBroadcast(hCondOpening);
 
     return cur;
 }
@@ -382,20 +443,30 @@ void GDALDatasetPool::_CloseDatasetIfZeroRefCount( const char* pszFileName,
               strcmp(cur->pszOwner, pszOwner) == 0)) &&
             cur->poDS != nullptr )
         {
+            GDALDataset* poDSToClose = cur->poDS;
+            GIntBig responsiblePIDOfDSToClose = cur->responsiblePID;
+
+            cur->poDS = nullptr;
+            cur->pszFileName[0] = '\0';
+            CPLFree(cur->pszOwner);
+            cur->pszOwner = nullptr;
+
+            /* The entry is now free, so the dataset can be closed without */
+            /* holding the mutex */
+            CPLMutex* hMutex = *GDALGetphDLMutex();
+            CPLReleaseMutex(hMutex);
+
             /* Close by pretending we are the thread that GDALOpen'ed this */
             /* dataset */
-            GDALSetResponsiblePIDForCurrentThread(cur->responsiblePID);
+            GDALSetResponsiblePIDForCurrentThread(responsiblePIDOfDSToClose);
 
-            refCountOfDisableRefCount ++;
-            GDALClose(cur->poDS);
-            refCountOfDisableRefCount --;
+            gnThreadRefCountOfDisableRefCount ++;
+            GDALClose(poDSToClose);
+            gnThreadRefCountOfDisableRefCount --;
 
             GDALSetResponsiblePIDForCurrentThread(responsiblePID);
 
-            cur->poDS = nullptr;
-            cur->pszFileName[0] = '\0';
-            CPLFree(cur->pszOwner);
-            cur->pszOwner = nullptr;
+            CPLAcquireMutex(hMutex, 1000.0);
             break;
         }
 
@@ -417,7 +488,8 @@ void GDALDatasetPool::Ref()
             l_maxSize = 100;
         singleton = new GDALDatasetPool(l_maxSize);
     }
-    if (singleton->refCountOfDisableRefCount == 0)
+    if (singleton->refCountOfDisableRefCount == 0 &&
+        gnThreadRefCountOfDisableRefCount == 0)
       singleton->refCount++;
 }
 
@@ -450,7 +522,8 @@ void GDALDatasetPool::Unref()
         CPLAssert(false);
         return;
     }
-    if (singleton->refCountOfDisableRefCount == 0)
+    if (singleton->refCountOfDisableRefCount == 0 &&
+        gnThreadRefCountOfDisableRefCount == 0)
     {
       singleton->refCount--;
       if (singleton->refCount == 0)
@@ -43,16 +43,21 @@
 #include <memory>
 #include <new>
 #include <type_traits>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_virtualmem.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
+#include "gdal_perf_counters.h"
 #include "gdal_rat.h"
 #include "gdal_priv_templates.hpp"
+#include "gdal_thread_pool.h"
+#include "cpl_worker_thread_pool.h"
 
 CPL_CVSID("$Id$")
 
@@ -364,6 +369,10 @@ CPLErr GDALRasterBand::RasterIO( GDALRWFlag eRWFlag,
 
     const bool bCallLeaveReadWrite = CPL_TO_BOOL(EnterReadWrite(eRWFlag));
 
+    GDALRasterIOLatencyTimer oLatencyTimer(
+        poDS ? poDS->GetRasterIOLatencyStatsInternal() : nullptr,
+        eRWFlag == GF_Write);
+
     CPLErr eErr;
     if( bForceCachedIO )
         eErr = GDALRasterBand::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
@@ -437,6 +446,22 @@ GDALRasterIOEx( GDALRasterBandH hBand, GDALRWFlag eRWFlag,
                               pData, nBufXSize, nBufYSize, eBufType,
                               nPixelSpace, nLineSpace, psExtraArg) );
 }
+
+/************************************************************************/
+/*                         AddBlockTraceArgs()                          */
+/************************************************************************/
+
+static void AddBlockTraceArgs( CPLTraceSpan& oSpan, GDALRasterBand* poBand,
+                               int nXBlockOff, int nYBlockOff )
+{
+    GDALDataset* poDS = poBand->GetDataset();
+    if( poDS && poDS->GetDriver() )
+        oSpan.AddArg("driver", poDS->GetDriver()->GetDescription());
+    oSpan.AddArg("band", static_cast<GIntBig>(poBand->GetBand()));
+    oSpan.AddArg("x_block", static_cast<GIntBig>(nXBlockOff));
+    oSpan.AddArg("y_block", static_cast<GIntBig>(nYBlockOff));
+}
+
 /************************************************************************/
 /*                             ReadBlock()                              */
 /************************************************************************/
@@ -548,6 +573,15 @@ CPLErr GDALRasterBand::ReadBlock( int nXBlockOff, int nYBlockOff,
 /*      Invoke underlying implementation method.                        */
 /* -------------------------------------------------------------------- */
 
+    CPLTraceSpan oSpan("gdal", "IReadBlock");
+    if( oSpan.IsActive() )
+        AddBlockTraceArgs(oSpan, this, nXBlockOff, nYBlockOff);
+
+    GDAL_PERF_COUNTER(poBlocksReadCounter, "GDAL.blocks_read");
+    GDAL_PERF_COUNTER(poReadTimeCounter, "GDAL.block_read_time_ns");
+    poBlocksReadCounter->Increment();
+    GDALBlockReadTimer oTimer(poReadTimeCounter);
+
     int bCallLeaveReadWrite = EnterReadWrite(GF_Read);
     CPLErr eErr = IReadBlock( nXBlockOff, nYBlockOff, pImage );
     if( bCallLeaveReadWrite) LeaveReadWrite();
@@ -1145,6 +1179,60 @@ CPLErr GDALRasterBand::FlushBlock( int nXBlockOff, int nYBlockOff,
     return poBandBlockCache->FlushBlock( nXBlockOff, nYBlockOff, bWriteDirtyBlock );
 }
 
+/************************************************************************/
+/*                         GetCacheStatistics()                         */
+/************************************************************************/
+
+/**
+ * \brief Return cumulative block cache statistics of this band.
+ *
+ * Counters are reset when the block cache of the band is released, for
+ * example when the band is destroyed. The dfLockWaitTime member is always
+ * set to 0, as lock wait time is only available globally through
+ * GDALGetCacheStatistics().
+ *
+ * This method is the same as the C function
+ * GDALGetRasterBandCacheStatistics().
+ *
+ * @param psStats Pointer to the structure to fill. Must not be NULL.
+ * @since GDAL 3.4
+ */
+
+void GDALRasterBand::GetCacheStatistics( GDALCacheStatistics* psStats )
+{
+    memset(psStats, 0, sizeof(*psStats));
+    if( poBandBlockCache == nullptr )
+        return;
+    psStats->nHits = poBandBlockCache->m_nHits.load();
+    psStats->nMisses = poBandBlockCache->m_nMisses.load();
+    psStats->nEvictions = poBandBlockCache->m_nEvictions.load();
+    psStats->nDirtyFlushes = poBandBlockCache->m_nDirtyFlushes.load();
+    psStats->nBytesResident = poBandBlockCache->m_nBytesResident.load();
+}
+
+/************************************************************************/
+/*                  GDALGetRasterBandCacheStatistics()                  */
+/************************************************************************/
+
+/**
+ * \brief Return cumulative block cache statistics of a band.
+ *
+ * @see GDALRasterBand::GetCacheStatistics()
+ * @since GDAL 3.4
+ */
+
+CPLErr CPL_STDCALL GDALGetRasterBandCacheStatistics(
+                                            GDALRasterBandH hBand,
+                                            GDALCacheStatistics* psStats )
+{
+    VALIDATE_POINTER1( hBand, "GDALGetRasterBandCacheStatistics", CE_Failure );
+    VALIDATE_POINTER1( psStats, "GDALGetRasterBandCacheStatistics",
+                       CE_Failure );
+
+    GDALRasterBand::FromHandle(hBand)->GetCacheStatistics(psStats);
+    return CE_None;
+}
+
 /************************************************************************/
 /*                        TryGetLockedBlockRef()                        */
 /************************************************************************/
@@ -1313,12 +1401,28 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
             return nullptr;
         }
 
-        if( !bJustInitialize )
+        if( !bJustInitialize &&
+            !(poDS && poDS->TakePrefetchedBlock(
+                nBand, nXBlockOff, nYBlockOff, poBlock->GetDataRef(),
+                static_cast<size_t>(nBlockXSize) * nBlockYSize *
+                    GDALGetDataTypeSizeBytes(eDataType))) )
         {
             const GUInt32 nErrorCounter = CPLGetErrorCounter();
-            int bCallLeaveReadWrite = EnterReadWrite(GF_Read);
-            eErr = IReadBlock(nXBlockOff,nYBlockOff,poBlock->GetDataRef());
-            if( bCallLeaveReadWrite) LeaveReadWrite();
+            {
+                CPLTraceSpan oSpan("gdal", "IReadBlock");
+                if( oSpan.IsActive() )
+                    AddBlockTraceArgs(oSpan, this, nXBlockOff, nYBlockOff);
+
+                GDAL_PERF_COUNTER(poBlocksReadCounter, "GDAL.blocks_read");
+                GDAL_PERF_COUNTER(poReadTimeCounter,
+                                  "GDAL.block_read_time_ns");
+                poBlocksReadCounter->Increment();
+                GDALBlockReadTimer oTimer(poReadTimeCounter);
+
+                int bCallLeaveReadWrite = EnterReadWrite(GF_Read);
+                eErr = IReadBlock(nXBlockOff,nYBlockOff,poBlock->GetDataRef());
+                if( bCallLeaveReadWrite) LeaveReadWrite();
+            }
             if( eErr != CE_None )
             {
                 poBlock->DropLock();
@@ -3434,6 +3538,261 @@ GDALGetRasterHistogramEx( GDALRasterBandH hBand,
                                  pfnProgress, pProgressData );
 }
 
+/************************************************************************/
+/*                      GetStatisticsNumThreads()                       */
+/************************************************************************/
+
+// Number of threads used to process blocks in parallel when computing
+// statistics or histograms, from the GDAL_NUM_THREADS configuration option.
+static int GetStatisticsNumThreads()
+{
+    const char* pszNumThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                       atoi(pszNumThreads);
+    return std::max(1, std::min(128, nThreads));
+}
+
+/************************************************************************/
+/*                          CountValuesJob                              */
+/************************************************************************/
+
+namespace {
+struct CountValuesJob
+{
+    GDALDataType eDataType = GDT_Byte;
+    bool bSignedByte = false;
+    const void* pData = nullptr;
+    int nXCheck = 0;
+    int nYCheck = 0;
+    int nBlockXSize = 0;
+    // Per-value counts, indexed by value + offset of the data type.
+    GUIntBig* panCounts = nullptr;
+
+    static void Run(void* pJob);
+};
+
+template<class T, int OFFSET>
+static void CountValues( const CountValuesJob* psJob )
+{
+    const T* pData = static_cast<const T*>(psJob->pData);
+    GUIntBig* panCounts = psJob->panCounts + OFFSET;
+    for( int iY = 0; iY < psJob->nYCheck; iY++ )
+    {
+        const T* pLine =
+            pData + static_cast<GPtrDiff_t>(iY) * psJob->nBlockXSize;
+        for( int iX = 0; iX < psJob->nXCheck; iX++ )
+            panCounts[pLine[iX]]++;
+    }
+}
+
+void CountValuesJob::Run(void* pJob)
+{
+    const CountValuesJob* psJob = static_cast<const CountValuesJob*>(pJob);
+    if( psJob->eDataType == GDT_Byte && psJob->bSignedByte )
+        CountValues<signed char, 128>(psJob);
+    else if( psJob->eDataType == GDT_Byte )
+        CountValues<GByte, 0>(psJob);
+    else if( psJob->eDataType == GDT_Int16 )
+        CountValues<GInt16, 32768>(psJob);
+    else
+        CountValues<GUInt16, 0>(psJob);
+}
+} // namespace
+
+/************************************************************************/
+/*               ComputeStatisticsAndDefaultHistogram()                 */
+/************************************************************************/
+
+// Computes in a single pass over all the blocks of a 8 or 16 bit integer
+// band its exact statistics, which are set on the band, and its default
+// histogram, whose bounds derive from the minimum and maximum. This is done
+// from a table of the count of each value, so that the histogram does not
+// need the bounds while reading the data.
+//! @cond Doxygen_Suppress
+CPLErr GDALRasterBand::ComputeStatisticsAndDefaultHistogram(
+    double *pdfMin, double *pdfMax, int nBuckets, GUIntBig *panHistogram,
+    GDALProgressFunc pfnProgress, void *pProgressData )
+{
+    CPLAssert( eDataType == GDT_Byte || eDataType == GDT_Int16 ||
+               eDataType == GDT_UInt16 );
+
+    if( pfnProgress == nullptr )
+        pfnProgress = GDALDummyProgress;
+
+    if( !InitBlockInfo() )
+        return CE_Failure;
+
+    const char* pszPixelType = GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
+    const bool bSignedByte =
+        pszPixelType != nullptr && EQUAL(pszPixelType, "SIGNEDBYTE");
+    const int nOffset = (eDataType == GDT_Int16) ? 32768 :
+                        (eDataType == GDT_Byte && bSignedByte) ? 128 : 0;
+    const int nValues = (eDataType == GDT_Byte) ? 256 : 65536;
+
+    int nThreads = GetStatisticsNumThreads();
+    std::unique_ptr<CPLJobQueue> poJobQueue;
+    if( nThreads > 1 )
+    {
+        CPLWorkerThreadPool* poThreadPool = GDALGetGlobalThreadPool(nThreads);
+        if( poThreadPool )
+            poJobQueue = poThreadPool->CreateJobQueue();
+    }
+    if( !poJobQueue )
+        nThreads = 1;
+
+    // One table of counts per concurrent job, summed at the end.
+    std::vector<GUIntBig> anCounts;
+    try
+    {
+        anCounts.resize(static_cast<size_t>(nThreads) * nValues);
+    }
+    catch( const std::bad_alloc& )
+    {
+        ReportError( CE_Failure, CPLE_OutOfMemory,
+                     "Out of memory in ComputeStatisticsAndDefaultHistogram()" );
+        return CE_Failure;
+    }
+
+    const int nTotalBlocks = nBlocksPerRow * nBlocksPerColumn;
+    std::vector<CountValuesJob> asJobs(nThreads);
+    std::vector<GDALRasterBlock*> apoBlocks(nThreads);
+    for( int iBlock = 0; iBlock < nTotalBlocks; iBlock += nThreads )
+    {
+        if( !pfnProgress( iBlock / static_cast<double>(nTotalBlocks),
+                          "Compute Histogram", pProgressData ) )
+        {
+            ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            return CE_Failure;
+        }
+
+        const int nBatchBlocks = std::min(nThreads, nTotalBlocks - iBlock);
+        CPLErr eErr = CE_None;
+        int iJob = 0;
+        for( ; iJob < nBatchBlocks; iJob++ )
+        {
+            const int iYBlock = (iBlock + iJob) / nBlocksPerRow;
+            const int iXBlock = (iBlock + iJob) - nBlocksPerRow * iYBlock;
+
+            apoBlocks[iJob] = GetLockedBlockRef( iXBlock, iYBlock );
+            if( apoBlocks[iJob] == nullptr )
+            {
+                eErr = CE_Failure;
+                break;
+            }
+
+            CountValuesJob& sJob = asJobs[iJob];
+            sJob.eDataType = eDataType;
+            sJob.bSignedByte = bSignedByte;
+            sJob.pData = apoBlocks[iJob]->GetDataRef();
+            GetActualBlockSize(iXBlock, iYBlock, &sJob.nXCheck, &sJob.nYCheck);
+            sJob.nBlockXSize = nBlockXSize;
+            sJob.panCounts = &anCounts[static_cast<size_t>(iJob) * nValues];
+            if( poJobQueue )
+                poJobQueue->SubmitJob(CountValuesJob::Run, &sJob);
+            else
+                CountValuesJob::Run(&sJob);
+        }
+        if( poJobQueue )
+            poJobQueue->WaitCompletion();
+        for( int i = 0; i < iJob; i++ )
+            apoBlocks[i]->DropLock();
+        if( eErr != CE_None )
+            return eErr;
+    }
+
+    for( int iJob = 1; iJob < nThreads; iJob++ )
+    {
+        for( int i = 0; i < nValues; i++ )
+            anCounts[i] += anCounts[static_cast<size_t>(iJob) * nValues + i];
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Derive the statistics from the counts.                          */
+/* -------------------------------------------------------------------- */
+    int bGotNoDataValue = FALSE;
+    const double dfNoDataValue = GetNoDataValue( &bGotNoDataValue );
+    bGotNoDataValue = bGotNoDataValue && !CPLIsNan(dfNoDataValue);
+
+    GUIntBig nSampleCount = 0;
+    GUIntBig nValidCount = 0;
+    double dfSum = 0.0;
+    int nMinValue = INT_MAX;
+    int nMaxValue = INT_MIN;
+    for( int i = 0; i < nValues; i++ )
+    {
+        if( anCounts[i] == 0 )
+            continue;
+        nSampleCount += anCounts[i];
+        const int nValue = i - nOffset;
+        if( bGotNoDataValue && ARE_REAL_EQUAL(static_cast<double>(nValue),
+                                              dfNoDataValue) )
+            continue;
+        nValidCount += anCounts[i];
+        dfSum += static_cast<double>(nValue) * anCounts[i];
+        nMinValue = std::min(nMinValue, nValue);
+        nMaxValue = std::max(nMaxValue, nValue);
+    }
+
+    SetValidPercent( nSampleCount, nValidCount );
+    if( nValidCount == 0 )
+    {
+        ReportError(
+            CE_Failure, CPLE_AppDefined,
+            "Failed to compute statistics, no valid pixels found in sampling." );
+        return CE_Failure;
+    }
+
+    const double dfMean = dfSum / nValidCount;
+    double dfM2 = 0.0;
+    for( int i = nMinValue + nOffset; i <= nMaxValue + nOffset; i++ )
+    {
+        const int nValue = i - nOffset;
+        if( anCounts[i] == 0 ||
+            (bGotNoDataValue && ARE_REAL_EQUAL(static_cast<double>(nValue),
+                                               dfNoDataValue)) )
+            continue;
+        const double dfDelta = nValue - dfMean;
+        dfM2 += dfDelta * dfDelta * anCounts[i];
+    }
+    const double dfStdDev = sqrt(dfM2 / nValidCount);
+
+    if( GetMetadataItem( "STATISTICS_APPROXIMATE" ) )
+        SetMetadataItem( "STATISTICS_APPROXIMATE", nullptr );
+    SetStatistics( nMinValue, nMaxValue, dfMean, dfStdDev );
+
+/* -------------------------------------------------------------------- */
+/*      Bucket the counts in the same way as GetDefaultHistogram() and  */
+/*      GetHistogram() do.                                              */
+/* -------------------------------------------------------------------- */
+    const double dfHalfBucket =
+        static_cast<double>(nMaxValue - nMinValue) / (2 * (nBuckets - 1));
+    *pdfMin = nMinValue - dfHalfBucket;
+    *pdfMax = nMaxValue + dfHalfBucket;
+
+    const bool bHistogramNoData = bGotNoDataValue &&
+        !CPLTestBool(CPLGetConfigOption("GDAL_NODATA_IN_HISTOGRAM", "NO"));
+    const double dfScale =
+        (*pdfMax > *pdfMin) ? nBuckets / (*pdfMax - *pdfMin) : 0.0;
+    memset( panHistogram, 0, sizeof(GUIntBig) * nBuckets );
+    for( int i = 0; i < nValues; i++ )
+    {
+        if( anCounts[i] == 0 )
+            continue;
+        const double dfValue = i - nOffset;
+        if( bHistogramNoData && ARE_REAL_EQUAL(dfValue, dfNoDataValue) )
+            continue;
+        const int nIndex =
+            static_cast<int>(floor((dfValue - *pdfMin) * dfScale));
+        panHistogram[std::max(0, std::min(nBuckets - 1, nIndex))] +=
+                                                                anCounts[i];
+    }
+
+    pfnProgress( 1.0, "Compute Histogram", pProgressData );
+
+    return CE_None;
+}
+//! @endcond
+
 /************************************************************************/
 /*                        GetDefaultHistogram()                         */
 /************************************************************************/
@@ -3446,6 +3805,12 @@ GDALGetRasterHistogramEx( GDALRasterBandH hBand,
  * VRTDataset, HFADataset...) that may be able to fetch efficiently an already
  * stored histogram.
  *
+ * Starting with GDAL 3.4, for Byte, Int16 and UInt16 bands whose bounds
+ * depend on statistics that are not available yet, exact statistics are
+ * computed in the same pass over the data as the histogram, and set on the
+ * band. The GDAL_NUM_THREADS configuration option can be set to a number of
+ * threads or ALL_CPUS to process blocks concurrently.
+ *
  * This method is the same as the C functions GDALGetDefaultHistogram() and
  * GDALGetDefaultHistogramEx().
  *
@@ -3499,6 +3864,34 @@ CPLErr
     }
     else
     {
+        // For 8 and 16 bit integer bands without statistics yet, the
+        // statistics and the histogram are computed in a single pass.
+        if( (GetRasterDataType() == GDT_Byte ||
+             GetRasterDataType() == GDT_Int16 ||
+             GetRasterDataType() == GDT_UInt16) &&
+            GetStatistics( TRUE, FALSE, pdfMin, pdfMax,
+                           nullptr, nullptr ) != CE_None )
+        {
+            *ppanHistogram = static_cast<GUIntBig *>(
+                VSI_CALLOC_VERBOSE(sizeof(GUIntBig), nBuckets) );
+            if( *ppanHistogram == nullptr )
+                return CE_Failure;
+
+            const CPLErr eErr =
+                ComputeStatisticsAndDefaultHistogram(
+                    pdfMin, pdfMax, nBuckets, *ppanHistogram,
+                    pfnProgress, pProgressData );
+            if( eErr == CE_None )
+            {
+                *pnBuckets = nBuckets;
+            }
+            else
+            {
+                VSIFree(*ppanHistogram);
+                *ppanHistogram = nullptr;
+            }
+            return eErr;
+        }
 
         const CPLErr eErr =
             GetStatistics( TRUE, TRUE, pdfMin, pdfMax, nullptr, nullptr );
@@ -3649,6 +4042,15 @@ CPLErr CPL_STDCALL GDALGetDefaultHistogramEx(
  * Many drivers just ignore the AdviseRead() call, but it can dramatically
  * accelerate access via some drivers.
  *
+ * For drivers that do not implement it, if the GDAL_ADVISE_READ_PREFETCH
+ * configuration option is set to YES (since GDAL 3.4), the blocks
+ * intersecting a full resolution region are read in a background thread,
+ * through a separate read-only handle on the dataset, and handed over to
+ * the block cache when they are requested. The memory used by blocks
+ * prefetched but not yet requested is limited to a quarter of the block
+ * cache size, or to the value in megabytes of the
+ * GDAL_ADVISE_READ_PREFETCH_MAX_MEM configuration option.
+ *
  * Depending on call paths, drivers might receive several calls to
  * AdviseRead() with the same parameters.
  *
@@ -3683,15 +4085,24 @@ CPLErr CPL_STDCALL GDALGetDefaultHistogramEx(
 /**/
 
 CPLErr GDALRasterBand::AdviseRead(
-    int /*nXOff*/,
-    int /*nYOff*/,
-    int /*nXSize*/,
-    int /*nYSize*/,
-    int /*nBufXSize*/,
-    int /*nBufYSize*/,
+    int nXOff,
+    int nYOff,
+    int nXSize,
+    int nYSize,
+    int nBufXSize,
+    int nBufYSize,
     GDALDataType /*eBufType*/,
     char ** /*papszOptions*/ )
 {
+    // Background prefetching (GDAL_ADVISE_READ_PREFETCH=YES) only applies
+    // to full resolution reads of bands directly owned by their dataset.
+    if( poDS != nullptr && nBand > 0 && poDS->GetRasterBand(nBand) == this &&
+        nBufXSize == nXSize && nBufYSize == nYSize &&
+        nXOff >= 0 && nYOff >= 0 && nXSize > 0 && nYSize > 0 &&
+        nXOff <= nRasterXSize - nXSize && nYOff <= nRasterYSize - nYSize )
+    {
+        poDS->SchedulePrefetch(nXOff, nYOff, nXSize, nYSize, 1, &nBand);
+    }
     return CE_None;
 }
 
@@ -4883,6 +5294,75 @@ void GDALRasterBand::SetValidPercent(GUIntBig nSampleCount, GUIntBig nValidCount
     }
 }
 
+/************************************************************************/
+/*                         StatisticsBlockJob                           */
+/************************************************************************/
+
+namespace {
+// Computes the statistics of one block, for the multi-threaded code path of
+// ComputeStatistics(). Blocks are then merged with the pairwise update of
+// Chan et al.
+struct StatisticsBlockJob
+{
+    GDALDataType eDataType = GDT_Byte;
+    bool bSignedByte = false;
+    const void* pData = nullptr;
+    int nXCheck = 0;
+    int nYCheck = 0;
+    int nBlockXSize = 0;
+    bool bGotNoDataValue = false;
+    double dfNoDataValue = 0.0;
+    bool bGotFloatNoDataValue = false;
+    float fNoDataValue = 0.0f;
+
+    double dfMin = std::numeric_limits<double>::max();
+    double dfMax = -std::numeric_limits<double>::max();
+    double dfMean = 0.0;
+    double dfM2 = 0.0;
+    GUIntBig nValidCount = 0;
+
+    static void Run(void* pJob);
+};
+
+void StatisticsBlockJob::Run(void* pJob)
+{
+    StatisticsBlockJob* psJob = static_cast<StatisticsBlockJob*>(pJob);
+    psJob->dfMin = std::numeric_limits<double>::max();
+    psJob->dfMax = -std::numeric_limits<double>::max();
+    psJob->dfMean = 0.0;
+    psJob->dfM2 = 0.0;
+    psJob->nValidCount = 0;
+    for( int iY = 0; iY < psJob->nYCheck; iY++ )
+    {
+        for( int iX = 0; iX < psJob->nXCheck; iX++ )
+        {
+            const GPtrDiff_t iOffset =
+                iX + static_cast<GPtrDiff_t>(iY) * psJob->nBlockXSize;
+            bool bValid = true;
+            const double dfValue = GetPixelValue( psJob->eDataType,
+                                                  psJob->bSignedByte,
+                                                  psJob->pData,
+                                                  iOffset,
+                                                  psJob->bGotNoDataValue,
+                                                  psJob->dfNoDataValue,
+                                                  psJob->bGotFloatNoDataValue,
+                                                  psJob->fNoDataValue,
+                                                  bValid );
+            if( !bValid )
+                continue;
+
+            psJob->dfMin = std::min(psJob->dfMin, dfValue);
+            psJob->dfMax = std::max(psJob->dfMax, dfValue);
+
+            psJob->nValidCount++;
+            const double dfDelta = dfValue - psJob->dfMean;
+            psJob->dfMean += dfDelta / psJob->nValidCount;
+            psJob->dfM2 += dfDelta * (dfValue - psJob->dfMean);
+        }
+    }
+}
+} // namespace
+
 /************************************************************************/
 /*                         ComputeStatistics()                          */
 /************************************************************************/
@@ -4900,6 +5380,10 @@ void GDALRasterBand::SetValidPercent(GUIntBig nSampleCount, GUIntBig nValidCount
  *
  * Cached statistics can be cleared with GDALDataset::ClearStatistics().
  *
+ * Starting with GDAL 3.4, the GDAL_NUM_THREADS configuration option can be set
+ * to a number of threads or ALL_CPUS to process blocks of data types other
+ * than Byte and UInt16 concurrently.
+ *
  * This method is the same as the C function GDALComputeRasterStatistics().
  *
  * @param bApproxOK If TRUE statistics may be computed based on overviews
@@ -5250,63 +5734,156 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
         }
 #endif
 
-        for( int iSampleBlock = 0;
-             iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
-             iSampleBlock += nSampleRate )
+        int nThreads = GetStatisticsNumThreads();
+        std::unique_ptr<CPLJobQueue> poJobQueue;
+        if( nThreads > 1 )
         {
-            const int iYBlock = iSampleBlock / nBlocksPerRow;
-            const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
+            CPLWorkerThreadPool* poThreadPool =
+                GDALGetGlobalThreadPool(nThreads);
+            if( poThreadPool )
+                poJobQueue = poThreadPool->CreateJobQueue();
+        }
 
-            GDALRasterBlock * const poBlock = GetLockedBlockRef( iXBlock, iYBlock );
-            if( poBlock == nullptr )
-                return CE_Failure;
+        if( poJobQueue )
+        {
+            // Process batches of blocks concurrently, and merge their
+            // statistics in block order.
+            const int nTotalBlocks = nBlocksPerRow * nBlocksPerColumn;
+            std::vector<StatisticsBlockJob> asJobs(nThreads);
+            std::vector<GDALRasterBlock*> apoBlocks(nThreads);
+            for( int iSampleBlock = 0;
+                 iSampleBlock < nTotalBlocks;
+                 iSampleBlock += nThreads * nSampleRate )
+            {
+                CPLErr eErr = CE_None;
+                int nJobs = 0;
+                for( ; nJobs < nThreads; nJobs++ )
+                {
+                    const int iBlock = iSampleBlock + nJobs * nSampleRate;
+                    if( iBlock >= nTotalBlocks )
+                        break;
+                    const int iYBlock = iBlock / nBlocksPerRow;
+                    const int iXBlock = iBlock - nBlocksPerRow * iYBlock;
 
-            void* const pData = poBlock->GetDataRef();
+                    apoBlocks[nJobs] = GetLockedBlockRef( iXBlock, iYBlock );
+                    if( apoBlocks[nJobs] == nullptr )
+                    {
+                        eErr = CE_Failure;
+                        break;
+                    }
 
-            int nXCheck = 0, nYCheck = 0;
-            GetActualBlockSize(iXBlock, iYBlock, &nXCheck, &nYCheck);
+                    StatisticsBlockJob& sJob = asJobs[nJobs];
+                    sJob.eDataType = eDataType;
+                    sJob.bSignedByte = bSignedByte;
+                    sJob.pData = apoBlocks[nJobs]->GetDataRef();
+                    GetActualBlockSize(iXBlock, iYBlock,
+                                       &sJob.nXCheck, &sJob.nYCheck);
+                    sJob.nBlockXSize = nBlockXSize;
+                    sJob.bGotNoDataValue = CPL_TO_BOOL(bGotNoDataValue);
+                    sJob.dfNoDataValue = dfNoDataValue;
+                    sJob.bGotFloatNoDataValue = bGotFloatNoDataValue;
+                    sJob.fNoDataValue = fNoDataValue;
+                    poJobQueue->SubmitJob(StatisticsBlockJob::Run, &sJob);
+                }
+                poJobQueue->WaitCompletion();
+                for( int iJob = 0; iJob < nJobs; iJob++ )
+                    apoBlocks[iJob]->DropLock();
+                if( eErr != CE_None )
+                    return eErr;
 
-            // This isn't the fastest way to do this, but is easier for now.
-            for( int iY = 0; iY < nYCheck; iY++ )
-            {
-                for( int iX = 0; iX < nXCheck; iX++ )
+                for( int iJob = 0; iJob < nJobs; iJob++ )
                 {
-                    const GPtrDiff_t iOffset = iX + static_cast<GPtrDiff_t>(iY) * nBlockXSize;
-                    bool bValid = true;
-                    double dfValue = GetPixelValue( eDataType,
-                                                    bSignedByte,
-                                                    pData,
-                                                    iOffset,
-                                                    CPL_TO_BOOL(bGotNoDataValue),
-                                                    dfNoDataValue,
-                                                    bGotFloatNoDataValue,
-                                                    fNoDataValue,
-                                                    bValid );
-
-                    if( !bValid )
+                    const StatisticsBlockJob& sJob = asJobs[iJob];
+                    nSampleCount +=
+                        static_cast<GUIntBig>(sJob.nXCheck) * sJob.nYCheck;
+                    if( sJob.nValidCount == 0 )
                         continue;
 
-                    dfMin = std::min(dfMin, dfValue);
-                    dfMax = std::max(dfMax, dfValue);
+                    dfMin = std::min(dfMin, sJob.dfMin);
+                    dfMax = std::max(dfMax, sJob.dfMax);
+
+                    const double dfCountA = static_cast<double>(nValidCount);
+                    const double dfCountB =
+                        static_cast<double>(sJob.nValidCount);
+                    nValidCount += sJob.nValidCount;
+                    const double dfCount = static_cast<double>(nValidCount);
+                    const double dfDelta = sJob.dfMean - dfMean;
+                    dfMean += dfDelta * dfCountB / dfCount;
+                    dfM2 += sJob.dfM2 +
+                            dfDelta * dfDelta * dfCountA * dfCountB / dfCount;
+                }
 
-                    nValidCount++;
-                    const double dfDelta = dfValue - dfMean;
-                    dfMean += dfDelta / nValidCount;
-                    dfM2 += dfDelta * (dfValue - dfMean);
+                if ( !pfnProgress(
+                         std::min(1.0, (iSampleBlock + nThreads * nSampleRate)
+                             / static_cast<double>(nTotalBlocks)),
+                         "Compute Statistics", pProgressData) )
+                {
+                    ReportError( CE_Failure, CPLE_UserInterrupt,
+                                 "User terminated" );
+                    return CE_Failure;
                 }
             }
+        }
+        else
+        {
+            for( int iSampleBlock = 0;
+                 iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
+                 iSampleBlock += nSampleRate )
+            {
+                const int iYBlock = iSampleBlock / nBlocksPerRow;
+                const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
 
-            nSampleCount += static_cast<GUIntBig>(nXCheck) * nYCheck;
+                GDALRasterBlock * const poBlock = GetLockedBlockRef( iXBlock, iYBlock );
+                if( poBlock == nullptr )
+                    return CE_Failure;
 
-            poBlock->DropLock();
+                void* const pData = poBlock->GetDataRef();
 
-            if ( !pfnProgress(
-                     iSampleBlock
-                         / static_cast<double>(nBlocksPerRow*nBlocksPerColumn),
-                     "Compute Statistics", pProgressData) )
-            {
-                ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-                return CE_Failure;
+                int nXCheck = 0, nYCheck = 0;
+                GetActualBlockSize(iXBlock, iYBlock, &nXCheck, &nYCheck);
+
+                // This isn't the fastest way to do this, but is easier for now.
+                for( int iY = 0; iY < nYCheck; iY++ )
+                {
+                    for( int iX = 0; iX < nXCheck; iX++ )
+                    {
+                        const GPtrDiff_t iOffset = iX + static_cast<GPtrDiff_t>(iY) * nBlockXSize;
+                        bool bValid = true;
+                        double dfValue = GetPixelValue( eDataType,
+                                                        bSignedByte,
+                                                        pData,
+                                                        iOffset,
+                                                        CPL_TO_BOOL(bGotNoDataValue),
+                                                        dfNoDataValue,
+                                                        bGotFloatNoDataValue,
+                                                        fNoDataValue,
+                                                        bValid );
+
+                        if( !bValid )
+                            continue;
+
+                        dfMin = std::min(dfMin, dfValue);
+                        dfMax = std::max(dfMax, dfValue);
+
+                        nValidCount++;
+                        const double dfDelta = dfValue - dfMean;
+                        dfMean += dfDelta / nValidCount;
+                        dfM2 += dfDelta * (dfValue - dfMean);
+                    }
+                }
+
+                nSampleCount += static_cast<GUIntBig>(nXCheck) * nYCheck;
+
+                poBlock->DropLock();
+
+                if ( !pfnProgress(
+                         iSampleBlock
+                             / static_cast<double>(nBlocksPerRow*nBlocksPerColumn),
+                         "Compute Statistics", pProgressData) )
+                {
+                    ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+                    return CE_Failure;
+                }
             }
         }
     }
@@ -5804,6 +6381,163 @@ CPLErr CPL_STDCALL GDALSetDefaultHistogramEx( GDALRasterBandH hBand,
     return poBand->SetDefaultHistogram( dfMin, dfMax, nBuckets, panHistogram );
 }
 
+/************************************************************************/
+/*                         ComputePercentiles()                         */
+/************************************************************************/
+
+/**
+ * \brief Compute percentiles of the pixel values.
+ *
+ * Percentiles are derived from the default histogram of the band, as returned
+ * by GetDefaultHistogram(). When it has to be computed, it is stored back
+ * with SetDefaultHistogram(), so that for drivers supporting PAM it is saved
+ * in the .aux.xml file and later requests, for any set of percentiles, are
+ * answered without reading pixels again.
+ *
+ * Pixel values are taken at the center of their histogram bucket, and the
+ * percentile is linearly interpolated between the two closest ranks. With the
+ * default histogram, this is exact for Byte bands and for integer bands whose
+ * value range spans at most 256 values. Otherwise the precision is the width
+ * of a bucket, that is to say (max - min) / 255.
+ *
+ * This method is the same as the C function GDALComputeRasterPercentiles().
+ *
+ * @param nPercentiles Number of percentiles to compute.
+ * @param padfPercentiles Array of nPercentiles percentiles, between 0 and 100.
+ * @param padfValues Array of nPercentiles values, into which the value of
+ * each percentile is written.
+ * @param bForce TRUE to force the computation of the histogram. If FALSE and
+ * no default histogram is available, the method will return CE_Warning.
+ * @param pfnProgress function to report progress to completion, or NULL.
+ * @param pProgressData application data to pass to pfnProgress.
+ *
+ * @return CE_None on success, CE_Failure if something goes wrong, or
+ * CE_Warning if no default histogram is available.
+ *
+ * @since GDAL 3.4
+ */
+
+CPLErr GDALRasterBand::ComputePercentiles( int nPercentiles,
+                                           const double *padfPercentiles,
+                                           double *padfValues,
+                                           int bForce,
+                                           GDALProgressFunc pfnProgress,
+                                           void *pProgressData )
+{
+    for( int i = 0; i < nPercentiles; i++ )
+    {
+        if( !(padfPercentiles[i] >= 0.0 && padfPercentiles[i] <= 100.0) )
+        {
+            ReportError( CE_Failure, CPLE_IllegalArg,
+                         "Percentile %g not in [0, 100] range",
+                         padfPercentiles[i] );
+            return CE_Failure;
+        }
+    }
+
+    double dfMin = 0.0;
+    double dfMax = 0.0;
+    int nBuckets = 0;
+    GUIntBig *panHistogram = nullptr;
+    CPLErr eErr = GetDefaultHistogram( &dfMin, &dfMax, &nBuckets,
+                                       &panHistogram, FALSE,
+                                       nullptr, nullptr );
+    if( eErr != CE_None )
+    {
+        CPLFree(panHistogram);
+        panHistogram = nullptr;
+        if( !bForce )
+            return CE_Warning;
+
+        eErr = GetDefaultHistogram( &dfMin, &dfMax, &nBuckets,
+                                    &panHistogram, TRUE,
+                                    pfnProgress, pProgressData );
+        if( eErr != CE_None )
+        {
+            CPLFree(panHistogram);
+            return eErr;
+        }
+
+        // Suppress NotImplemented error messages for drivers without PAM.
+        const int nSavedMOFlags = GetMOFlags();
+        SetMOFlags( nSavedMOFlags | GMO_IGNORE_UNIMPLEMENTED );
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        SetDefaultHistogram( dfMin, dfMax, nBuckets, panHistogram );
+        CPLPopErrorHandler();
+        SetMOFlags( nSavedMOFlags );
+    }
+
+    GUIntBig nTotal = 0;
+    for( int i = 0; i < nBuckets; i++ )
+        nTotal += panHistogram[i];
+    if( nTotal == 0 )
+    {
+        CPLFree(panHistogram);
+        ReportError( CE_Failure, CPLE_AppDefined,
+                     "Failed to compute percentiles, histogram is empty" );
+        return CE_Failure;
+    }
+
+    const double dfBucketSize = (dfMax - dfMin) / nBuckets;
+    // Value at the 0-based rank nRank of the sorted bucketed values.
+    const auto GetValueAtRank = [panHistogram, nBuckets, dfMin, dfBucketSize]
+                                                            (GUIntBig nRank)
+    {
+        GUIntBig nCumulated = 0;
+        int i = 0;
+        for( ; i < nBuckets - 1; i++ )
+        {
+            nCumulated += panHistogram[i];
+            if( nCumulated > nRank )
+                break;
+        }
+        return dfMin + (i + 0.5) * dfBucketSize;
+    };
+
+    for( int i = 0; i < nPercentiles; i++ )
+    {
+        const double dfRank =
+            padfPercentiles[i] / 100.0 * static_cast<double>(nTotal - 1);
+        const GUIntBig nLowRank = static_cast<GUIntBig>(floor(dfRank));
+        const GUIntBig nHighRank = std::min(nLowRank + 1, nTotal - 1);
+        const double dfLowValue = GetValueAtRank(nLowRank);
+        const double dfHighValue = GetValueAtRank(nHighRank);
+        padfValues[i] = dfLowValue +
+            (dfRank - static_cast<double>(nLowRank)) *
+                (dfHighValue - dfLowValue);
+    }
+
+    CPLFree(panHistogram);
+    return CE_None;
+}
+
+/************************************************************************/
+/*                    GDALComputeRasterPercentiles()                    */
+/************************************************************************/
+
+/**
+ * \brief Compute percentiles of the pixel values.
+ *
+ * @see GDALRasterBand::ComputePercentiles()
+ * @since GDAL 3.4
+ */
+
+CPLErr GDALComputeRasterPercentiles( GDALRasterBandH hBand,
+                                     int nPercentiles,
+                                     const double *padfPercentiles,
+                                     double *padfValues,
+                                     int bForce,
+                                     GDALProgressFunc pfnProgress,
+                                     void *pProgressData )
+{
+    VALIDATE_POINTER1( hBand, "GDALComputeRasterPercentiles", CE_Failure );
+
+    GDALRasterBand *poBand = GDALRasterBand::FromHandle(hBand);
+    return poBand->ComputePercentiles( nPercentiles, padfPercentiles,
+                                       padfValues, bForce,
+                                       pfnProgress, pProgressData );
+}
+
 /************************************************************************/
 /*                           GetDefaultRAT()                            */
 /************************************************************************/
@@ -6529,6 +7263,24 @@ void GDALRasterBand::IncDirtyBlocks( int nInc )
         poBandBlockCache->IncDirtyBlocks(nInc);
 }
 
+/************************************************************************/
+/*                           HasDirtyBlocks()                           */
+/************************************************************************/
+
+/**
+ * \brief Return whether blocks of the band cache are waiting to be written.
+ *
+ * Drivers that serve RasterIO() requests without the block cache can use
+ * this to skip FlushCache(), which is not safe to call from several threads,
+ * when no block was modified through the cache.
+ */
+
+bool GDALRasterBand::HasDirtyBlocks() const
+{
+    return poBandBlockCache != nullptr &&
+           poBandBlockCache->m_nDirtyBlocks > 0;
+}
+
 /************************************************************************/
 /*                            ReportError()                             */
 /************************************************************************/
@@ -6604,6 +7356,12 @@ void GDALRasterBand::ReportError( CPLErr eErrClass, CPLErrorNum err_no,
  *     bit depths are supported (8 for GDT_Bye, 16 for GDT_Int16/GDT_UInt16,
  *     32 for GDT_Float32 and 64 for GDT_Float64)
  *
+ * Starting with GDAL 3.4, for other uncompressed GeoTIFF files opened in
+ * read-only mode (tiled files for example), the GeoTIFF driver uses the default
+ * implementation, but the pages of the virtual memory are filled from a memory
+ * mapping of the file, without going through the block cache (see the
+ * GTIFF_VIRTUAL_MEM_IO configuration option of the driver).
+ *
  * The pointer returned remains valid until CPLVirtualMemFree() is called.
  * CPLVirtualMemFree() must be called before the raster band object is destroyed.
  *
@@ -31,38 +31,414 @@
 #include "cpl_port.h"
 #include "gdal.h"
 #include "gdal_priv.h"
+#include "gdal_perf_counters.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <climits>
 #include <cstring>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
 
 #include "cpl_atomic_ops.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 
+#if defined(__linux) && defined(HAVE_MMAP)
+#include <sys/mman.h>
+#endif
+
 CPL_CVSID("$Id$")
 
 static bool bCacheMaxInitialized = false;
 // Will later be overridden by the default 5% if GDAL_CACHEMAX not defined.
 static GIntBig nCacheMax = 40 * 1024 * 1024;
-static volatile GIntBig nCacheUsed = 0;
-
-static GDALRasterBlock *poOldest = nullptr;  // Tail.
-static GDALRasterBlock *poNewest = nullptr;  // Head.
+// Updated with atomic operations, as it is shared by all LRU shards.
+static std::atomic<GIntBig> nCacheUsed{0};
 
 static int nDisableDirtyBlockFlushCounter = 0;
 
+/* -------------------------------------------------------------------- */
+/*      The LRU list of cached blocks can be split in several shards,   */
+/*      each one with its own lock, to decrease contention when many    */
+/*      threads use the block cache. A block is attached to a shard     */
+/*      determined by its band and block coordinates. The GDAL_CACHEMAX */
+/*      budget remains global to all shards.                            */
+/* -------------------------------------------------------------------- */
+
+/* -------------------------------------------------------------------- */
+/*      Datasets may also be assigned to a named cache partition (see   */
+/*      GDALSetCachePartitionMax()), which has its own LRU list and its */
+/*      own budget, independent from GDAL_CACHEMAX. Partitions are      */
+/*      stored after the shards of the default pool.                    */
+/* -------------------------------------------------------------------- */
+
+constexpr int MAX_RB_SHARDS = 64;
+constexpr int MAX_CACHE_PARTITIONS = 32;
+
+namespace {
+struct GDALRBShard
+{
+    CPLLock*         hLock = nullptr;
+    GDALRasterBlock *poOldest = nullptr;  // Tail.
+    GDALRasterBlock *poNewest = nullptr;  // Head.
+
+    // Number of blocks in the LRU list, and number of times a block has
+    // been moved to its head. Modified under the lock, but may be read
+    // without it.
+    std::atomic<int>      nBlockCount{0};
+    std::atomic<unsigned> nTouchCounter{0};
+
+    // Only used by cache partitions. Shards of the default pool use
+    // nCacheMax and nCacheUsed.
+    std::atomic<GIntBig>  nMaxBytes{0};
+    std::atomic<GIntBig>  nUsedBytes{0};
+
+    std::atomic<GIntBig>  nHits{0};
+    std::atomic<GIntBig>  nMisses{0};
+    std::atomic<GIntBig>  nEvictions{0};
+    std::atomic<GIntBig>  nDirtyFlushes{0};
+    std::atomic<GIntBig>  nLockWaitNanoSec{0};
+};
+} // namespace
+
+static GDALRBShard asShards[MAX_RB_SHARDS + MAX_CACHE_PARTITIONS];
+
+static std::mutex oPartitionMutex;
+static std::atomic<int> nCachePartitions{0};
+static std::string aosCachePartitionNames[MAX_CACHE_PARTITIONS];
+
+static inline bool IsCachePartition( int iShard )
+{
+    return iShard >= MAX_RB_SHARDS;
+}
+
+static inline std::atomic<GIntBig>& GetUsedBytesCounter( int iShard )
+{
+    return IsCachePartition(iShard) ? asShards[iShard].nUsedBytes : nCacheUsed;
+}
+
+/************************************************************************/
+/*                            GetShardCount()                           */
+/************************************************************************/
+
+// Number of LRU shards, controlled by the GDAL_RB_CACHE_SHARDS
+// configuration option, evaluated only once in the process life.
+static int GetShardCount()
+{
+    static const int nShards = []()
+    {
+        const char* pszShards =
+            CPLGetConfigOption("GDAL_RB_CACHE_SHARDS", "1");
+        int nVal;
+        if( EQUAL(pszShards, "ALL_CPUS") )
+            nVal = CPLGetNumCPUs();
+        else
+            nVal = atoi(pszShards);
+        if( nVal <= 0 )
+        {
+            CPLError(CE_Warning, CPLE_IllegalArg,
+                     "Invalid value for GDAL_RB_CACHE_SHARDS: %s. Using 1",
+                     pszShards);
+            nVal = 1;
+        }
+        else if( nVal > MAX_RB_SHARDS )
+        {
+            CPLDebug("GDAL", "GDAL_RB_CACHE_SHARDS limited to %d",
+                     MAX_RB_SHARDS);
+            nVal = MAX_RB_SHARDS;
+        }
+        if( nVal > 1 )
+            CPLDebug("GDAL", "Using %d shards for the block cache LRU", nVal);
+        return nVal;
+    }();
+    return nShards;
+}
+
+/************************************************************************/
+/*                            IsLazyTouch()                             */
+/************************************************************************/
+
+// Whether TakeLock() may skip moving a block to the head of the LRU list
+// when it has been recently moved there. This saves taking the lock for
+// most cache hits in read-mostly workloads, at the expense of an
+// approximate LRU ordering.
+static bool IsLazyTouch()
+{
+    static const bool bLazyTouch =
+        CPLTestBool(CPLGetConfigOption("GDAL_RB_LAZY_TOUCH", "NO"));
+    return bLazyTouch;
+}
+
+/************************************************************************/
+/*                            GetShardIndex()                           */
+/************************************************************************/
+
+static int GetShardIndex( GDALRasterBand* poBand, int nXOff, int nYOff )
+{
+    GDALDataset* poDS = poBand->GetDataset();
+    if( poDS )
+    {
+        const int iPartition = poDS->GetCachePartitionIndex();
+        if( iPartition >= 0 )
+            return MAX_RB_SHARDS + iPartition;
+    }
+
+    const int nShards = GetShardCount();
+    if( nShards == 1 )
+        return 0;
+    // Spread neighbouring blocks of a same band over different shards, so
+    // that threads processing different regions of a raster do not
+    // contend on the same lock.
+    const GUIntBig nHash =
+        (static_cast<GUIntBig>(reinterpret_cast<GUIntptr_t>(poBand)) >> 4) *
+            UINT64_C(0x9E3779B97F4A7C15) ^
+        static_cast<GUIntBig>(static_cast<unsigned>(nXOff)) *
+            UINT64_C(0xC2B2AE3D27D4EB4F) ^
+        static_cast<GUIntBig>(static_cast<unsigned>(nYOff)) *
+            UINT64_C(0x165667B19E3779F9);
+    return static_cast<int>((nHash >> 32) % static_cast<unsigned>(nShards));
+}
+
+/* -------------------------------------------------------------------- */
+/*      Block buffers may optionally be served by a pool allocator,     */
+/*      selected with the GDAL_RB_ALLOCATOR configuration option:       */
+/*        - DEFAULT: VSIMallocAligned() / VSIFreeAligned().             */
+/*        - POOL: buffers are carved out of large slabs, and freed      */
+/*          buffers are kept in a free list per size class, so that    */
+/*          the next allocation of a block of the same size does not    */
+/*          go through malloc() nor fault in fresh pages.               */
+/*        - HUGEPAGES: same as POOL, but slabs are backed by huge       */
+/*          pages when possible (Linux only).                           */
+/*      On Linux, slabs are obtained with mmap(), so their pages are    */
+/*      placed on the NUMA node of the thread that first fills them.   */
+/*      The total size of slabs is bounded by                          */
+/*      GDAL_RB_ALLOCATOR_MAX_MEM (in MB, twice GDAL_CACHEMAX by       */
+/*      default). Beyond it, blocks are allocated with the default     */
+/*      allocator.                                                      */
+/* -------------------------------------------------------------------- */
+
+namespace {
+enum class GDALRBAllocator
+{
+    DEFAULT,
+    POOL,
+    HUGEPAGES
+};
+
+struct GDALRBBufferPool
+{
+    std::mutex                                 oMutex{};
+    // Free buffers, by size class.
+    std::map<size_t, std::vector<void*>>       oMapFreeLists{};
+    // Start, end of the unused part of the current slab, by size class.
+    std::map<size_t, std::pair<GByte*, GByte*>> oMapSlabTail{};
+    // Start to size of the slabs.
+    std::map<GByte*, size_t>                   oMapSlabs{};
+    bool                                       bInitialized = false;
+    size_t                                     nSlabBytes = 0;
+    size_t                                     nMaxSlabBytes = 0;
+    int                                        nBuffersInUse = 0;
+    GIntBig                                    nReused = 0;
+};
+} // namespace
+
+static GDALRBBufferPool oBufferPool;
+
+constexpr size_t RB_POOL_SLAB_SIZE = 2 * 1024 * 1024;
+constexpr size_t RB_POOL_ALIGNMENT = 64;
+
+/************************************************************************/
+/*                           GetAllocator()                             */
+/************************************************************************/
+
+// Evaluated only once in the process life.
+static GDALRBAllocator GetAllocator()
+{
+    static const GDALRBAllocator eAllocator = []()
+    {
+        const char* pszAllocator =
+            CPLGetConfigOption("GDAL_RB_ALLOCATOR", "DEFAULT");
+        if( EQUAL(pszAllocator, "POOL") )
+            return GDALRBAllocator::POOL;
+        if( EQUAL(pszAllocator, "HUGEPAGES") )
+            return GDALRBAllocator::HUGEPAGES;
+        if( !EQUAL(pszAllocator, "DEFAULT") )
+        {
+            CPLError(CE_Warning, CPLE_NotSupported,
+                     "GDAL_RB_ALLOCATOR=%s not supported. "
+                     "Falling back to DEFAULT", pszAllocator);
+        }
+        return GDALRBAllocator::DEFAULT;
+    }();
+    return eAllocator;
+}
+
+/************************************************************************/
+/*                            AllocSlab()                               */
+/************************************************************************/
+
+static GByte* AllocSlab( size_t nSize )
+{
+#if defined(__linux) && defined(HAVE_MMAP)
+    void* pSlab = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if( GetAllocator() == GDALRBAllocator::HUGEPAGES )
+    {
+        // Only succeeds if huge pages have been reserved by the
+        // administrator (/proc/sys/vm/nr_hugepages).
+        pSlab = mmap(nullptr, nSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif
+    if( pSlab == MAP_FAILED )
+    {
+        pSlab = mmap(nullptr, nSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if( pSlab == MAP_FAILED )
+            return nullptr;
+#ifdef MADV_HUGEPAGE
+        // Otherwise ask for transparent huge pages.
+        if( GetAllocator() == GDALRBAllocator::HUGEPAGES )
+            madvise(pSlab, nSize, MADV_HUGEPAGE);
+#endif
+    }
+    return static_cast<GByte*>(pSlab);
+#else
+    return static_cast<GByte*>(VSIMallocAligned(RB_POOL_ALIGNMENT, nSize));
+#endif
+}
+
+/************************************************************************/
+/*                             FreeSlab()                               */
+/************************************************************************/
+
+static void FreeSlab( GByte* pSlab, size_t nSize )
+{
+#if defined(__linux) && defined(HAVE_MMAP)
+    munmap(pSlab, nSize);
+#else
+    CPL_IGNORE_RET_VAL(nSize);
+    VSIFreeAligned(pSlab);
+#endif
+}
+
+/************************************************************************/
+/*                          AllocBlockData()                            */
+/************************************************************************/
+
+static void* AllocBlockData( GPtrDiff_t nSizeInBytes )
+{
+    if( GetAllocator() != GDALRBAllocator::DEFAULT )
+    {
+        const size_t nClassSize = static_cast<size_t>(
+            DIV_ROUND_UP(nSizeInBytes, RB_POOL_ALIGNMENT)) * RB_POOL_ALIGNMENT;
+
+        std::lock_guard<std::mutex> oLock(oBufferPool.oMutex);
+        if( !oBufferPool.bInitialized )
+        {
+            oBufferPool.bInitialized = true;
+            const char* pszMaxMem =
+                CPLGetConfigOption("GDAL_RB_ALLOCATOR_MAX_MEM", nullptr);
+            const GIntBig nMaxMem = pszMaxMem ?
+                static_cast<GIntBig>(CPLAtof(pszMaxMem) * 1024 * 1024) :
+                2 * nCacheMax;
+            oBufferPool.nMaxSlabBytes = static_cast<size_t>(
+                std::min(static_cast<GUIntBig>(
+                            std::numeric_limits<size_t>::max()),
+                         static_cast<GUIntBig>(std::max(nMaxMem,
+                                                        GIntBig(0)))));
+        }
+
+        auto& aFreeList = oBufferPool.oMapFreeLists[nClassSize];
+        if( !aFreeList.empty() )
+        {
+            void* pRet = aFreeList.back();
+            aFreeList.pop_back();
+            oBufferPool.nBuffersInUse++;
+            oBufferPool.nReused++;
+            return pRet;
+        }
+
+        auto& oTail = oBufferPool.oMapSlabTail[nClassSize];
+        if( oTail.first == nullptr ||
+            static_cast<size_t>(oTail.second - oTail.first) < nClassSize )
+        {
+            // Slabs hold several buffers of the same size class, and are
+            // a multiple of the usual huge page size.
+            const size_t nSlabSize =
+                DIV_ROUND_UP(std::max(nClassSize, RB_POOL_SLAB_SIZE),
+                             RB_POOL_SLAB_SIZE) * RB_POOL_SLAB_SIZE;
+            GByte* pSlab = nullptr;
+            if( oBufferPool.nSlabBytes + nSlabSize <=
+                    oBufferPool.nMaxSlabBytes )
+            {
+                pSlab = AllocSlab(nSlabSize);
+            }
+            if( pSlab != nullptr )
+            {
+                oBufferPool.oMapSlabs[pSlab] = nSlabSize;
+                oBufferPool.nSlabBytes += nSlabSize;
+                oTail.first = pSlab;
+                oTail.second = pSlab + nSlabSize;
+            }
+        }
+        if( oTail.first != nullptr &&
+            static_cast<size_t>(oTail.second - oTail.first) >= nClassSize )
+        {
+            void* pRet = oTail.first;
+            oTail.first += nClassSize;
+            oBufferPool.nBuffersInUse++;
+            return pRet;
+        }
+        // Pool exhausted: fall back to the default allocator.
+    }
+    return VSI_MALLOC_ALIGNED_AUTO_VERBOSE( nSizeInBytes );
+}
+
+/************************************************************************/
+/*                           FreeBlockData()                            */
+/************************************************************************/
+
+static void FreeBlockData( void* pData, GPtrDiff_t nSizeInBytes )
+{
+    if( pData == nullptr )
+        return;
+    if( GetAllocator() != GDALRBAllocator::DEFAULT )
+    {
+        std::lock_guard<std::mutex> oLock(oBufferPool.oMutex);
+        GByte* pabyData = static_cast<GByte*>(pData);
+        auto oIter = oBufferPool.oMapSlabs.upper_bound(pabyData);
+        if( oIter != oBufferPool.oMapSlabs.begin() )
+        {
+            --oIter;
+            if( pabyData < oIter->first + oIter->second )
+            {
+                const size_t nClassSize = static_cast<size_t>(
+                    DIV_ROUND_UP(nSizeInBytes, RB_POOL_ALIGNMENT)) *
+                        RB_POOL_ALIGNMENT;
+                oBufferPool.oMapFreeLists[nClassSize].push_back(pData);
+                oBufferPool.nBuffersInUse--;
+                return;
+            }
+        }
+    }
+    VSIFreeAligned(pData);
+}
+
 #if 0
-static CPLMutex *hRBLock = nullptr;
-#define INITIALIZE_LOCK CPLMutexHolderD( &hRBLock )
-#define TAKE_LOCK       CPLMutexHolderOptionalLockD( hRBLock )
-#define DESTROY_LOCK    CPLDestroyMutex( hRBLock )
+#define INITIALIZE_LOCK(psShard) CPLMutexHolderD( &((psShard)->hLock) )
+#define TAKE_LOCK(psShard)       CPLMutexHolderOptionalLockD( (psShard)->hLock )
+#define DESTROY_LOCK(psShard)    CPLDestroyMutex( (psShard)->hLock )
 #else
 
-static CPLLock* hRBLock = nullptr;
 static bool bDebugContention = false;
 static bool bSleepsForBockCacheDebug = false;
 static CPLLockType GetLockType()
@@ -92,13 +468,80 @@ static CPLLockType GetLockType()
     return static_cast<CPLLockType>(nLockType);
 }
 
-#define INITIALIZE_LOCK         CPLLockHolderD( &hRBLock, GetLockType() ); \
-                                CPLLockSetDebugPerf(hRBLock, bDebugContention)
-#define TAKE_LOCK               CPLLockHolderOptionalLockD( hRBLock )
-#define DESTROY_LOCK            CPLDestroyLock( hRBLock )
+/************************************************************************/
+/*                          IsLockWaitStats()                           */
+/************************************************************************/
+
+static bool IsLockWaitStats()
+{
+    static const bool bLockWaitStats =
+        CPLTestBool(CPLGetConfigOption("GDAL_RB_LOCK_WAIT_STATS", "NO"));
+    return bLockWaitStats;
+}
+
+namespace {
+/************************************************************************/
+/*                          GDALRBLockHolder                            */
+/************************************************************************/
+
+// Same as CPLLockHolder for an already created lock, but measuring the
+// time spent to acquire the lock if GDAL_RB_LOCK_WAIT_STATS=YES.
+class GDALRBLockHolder
+{
+    CPLLock* m_hLock;
+
+    CPL_DISALLOW_COPY_ASSIGN(GDALRBLockHolder)
+
+  public:
+    explicit GDALRBLockHolder( GDALRBShard* psShard ) :
+        m_hLock(psShard->hLock)
+    {
+        if( m_hLock == nullptr )
+            return;
+        if( IsLockWaitStats() )
+        {
+            const auto nStart = std::chrono::steady_clock::now();
+            CPLAcquireLock(m_hLock);
+            psShard->nLockWaitNanoSec.fetch_add(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - nStart).count(),
+                std::memory_order_relaxed);
+        }
+        else
+        {
+            CPLAcquireLock(m_hLock);
+        }
+    }
+
+    ~GDALRBLockHolder()
+    {
+        if( m_hLock )
+            CPLReleaseLock(m_hLock);
+    }
+};
+} // namespace
+
+#define INITIALIZE_LOCK(psShard) \
+            CPLLockHolderD( &((psShard)->hLock), GetLockType() ); \
+            CPLLockSetDebugPerf((psShard)->hLock, bDebugContention)
+#define TAKE_LOCK(psShard)     GDALRBLockHolder oHolder( psShard )
+#define DESTROY_LOCK(psShard)  CPLDestroyLock( (psShard)->hLock )
 
 #endif
 
+/************************************************************************/
+/*                          InitializeLocks()                           */
+/************************************************************************/
+
+static void InitializeLocks()
+{
+    const int nShards = GetShardCount();
+    for( int i = 0; i < nShards; ++i )
+    {
+        INITIALIZE_LOCK(&asShards[i]);
+    }
+}
+
 //#define ENABLE_DEBUG
 
 /************************************************************************/
@@ -154,9 +597,7 @@ void CPL_STDCALL GDALSetCacheMax64( GIntBig nNewSizeInBytes )
     }
 #endif
 
-    {
-        INITIALIZE_LOCK;
-    }
+    InitializeLocks();
     bCacheMaxInitialized = true;
     nCacheMax = nNewSizeInBytes;
 
@@ -168,7 +609,7 @@ void CPL_STDCALL GDALSetCacheMax64( GIntBig nNewSizeInBytes )
     {
         const GIntBig nOldCacheUsed = nCacheUsed;
 
-        GDALFlushCacheBlock();
+        GDALRasterBlock::FlushCacheBlockFromShards(0, GetShardCount(), FALSE);
 
         if( nCacheUsed == nOldCacheUsed )
             break;
@@ -240,9 +681,7 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
 {
     if( !bCacheMaxInitialized )
     {
-        {
-            INITIALIZE_LOCK;
-        }
+        InitializeLocks();
         bSleepsForBockCacheDebug = CPLTestBool(
             CPLGetConfigOption("GDAL_DEBUG_BLOCK_CACHE", "NO"));
 
@@ -324,7 +763,8 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
 
 int CPL_STDCALL GDALGetCacheUsed()
 {
-    if (nCacheUsed > INT_MAX)
+    const GIntBig nCurCacheUsed = nCacheUsed.load();
+    if (nCurCacheUsed > INT_MAX)
     {
         static bool bHasWarned = false;
         if (!bHasWarned)
@@ -336,7 +776,7 @@ int CPL_STDCALL GDALGetCacheUsed()
         }
         return INT_MAX;
     }
-    return static_cast<int>(nCacheUsed);
+    return static_cast<int>(nCurCacheUsed);
 }
 
 /************************************************************************/
@@ -352,7 +792,194 @@ int CPL_STDCALL GDALGetCacheUsed()
  * @since GDAL 1.8.0
  */
 
-GIntBig CPL_STDCALL GDALGetCacheUsed64() { return nCacheUsed; }
+GIntBig CPL_STDCALL GDALGetCacheUsed64() { return nCacheUsed.load(); }
+
+/************************************************************************/
+/*                     GDALGetCachePartitionIndex()                     */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+int GDALGetCachePartitionIndex( const char* pszName )
+{
+    std::lock_guard<std::mutex> oLock(oPartitionMutex);
+    const int nPartitions = nCachePartitions.load();
+    for( int i = 0; i < nPartitions; ++i )
+    {
+        if( aosCachePartitionNames[i] == pszName )
+            return i;
+    }
+    return -1;
+}
+
+/************************************************************************/
+/*                      GDALGetCachePartitionName()                     */
+/************************************************************************/
+
+const char* GDALGetCachePartitionName( int iPartition )
+{
+    if( iPartition < 0 || iPartition >= nCachePartitions.load() )
+        return nullptr;
+    return aosCachePartitionNames[iPartition].c_str();
+}
+//! @endcond
+
+/************************************************************************/
+/*                      GDALSetCachePartitionMax()                      */
+/************************************************************************/
+
+/**
+ * \brief Create or resize a named block cache partition.
+ *
+ * A cache partition is a part of the GDALRasterBlock cache that has its
+ * own least recently used list and its own maximum size. Blocks of datasets
+ * assigned to a partition (see GDALDatasetSetCachePartition()) are only
+ * evicted to make room for other blocks of the same partition, and they are
+ * not accounted in the limit set by GDALSetCacheMax64() / GDAL_CACHEMAX.
+ *
+ * If the partition does not exist yet, it is created. Otherwise its cache
+ * limit is updated, and blocks are flushed until the partition is under
+ * this new limit.
+ *
+ * At most 32 partitions can be created in the life of the process.
+ *
+ * @param pszName Partition name. Must not be NULL or empty.
+ * @param nMaxBytes the maximum number of bytes for caching in the partition.
+ *
+ * @return TRUE in case of success.
+ *
+ * @since GDAL 3.4
+ */
+
+int CPL_STDCALL GDALSetCachePartitionMax( const char* pszName,
+                                          GIntBig nMaxBytes )
+{
+    VALIDATE_POINTER1( pszName, "GDALSetCachePartitionMax", FALSE );
+    if( pszName[0] == '\0' )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg, "Empty partition name");
+        return FALSE;
+    }
+
+    // Initialize the locks of the default pool.
+    GDALGetCacheMax64();
+
+    int iPartition = GDALGetCachePartitionIndex(pszName);
+    if( iPartition < 0 )
+    {
+        std::lock_guard<std::mutex> oLock(oPartitionMutex);
+        iPartition = nCachePartitions.load();
+        if( iPartition == MAX_CACHE_PARTITIONS )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "Too many cache partitions. Limited to %d",
+                     MAX_CACHE_PARTITIONS);
+            return FALSE;
+        }
+        GDALRBShard* psShard = &asShards[MAX_RB_SHARDS + iPartition];
+        {
+            INITIALIZE_LOCK(psShard);
+        }
+        psShard->nMaxBytes = nMaxBytes;
+        aosCachePartitionNames[iPartition] = pszName;
+        nCachePartitions = iPartition + 1;
+        return TRUE;
+    }
+
+    const int iShard = MAX_RB_SHARDS + iPartition;
+    GDALRBShard* psShard = &asShards[iShard];
+    psShard->nMaxBytes = nMaxBytes;
+    while( psShard->nUsedBytes > nMaxBytes )
+    {
+        if( !GDALRasterBlock::FlushCacheBlockFromShards(iShard, 1, FALSE) )
+            break;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                      GDALGetCachePartitionMax()                      */
+/************************************************************************/
+
+/**
+ * \brief Get the maximum size of a named block cache partition.
+ *
+ * @param pszName Partition name.
+ * @return maximum in bytes, or -1 if the partition does not exist.
+ *
+ * @since GDAL 3.4
+ */
+
+GIntBig CPL_STDCALL GDALGetCachePartitionMax( const char* pszName )
+{
+    VALIDATE_POINTER1( pszName, "GDALGetCachePartitionMax", -1 );
+    const int iPartition = GDALGetCachePartitionIndex(pszName);
+    if( iPartition < 0 )
+        return -1;
+    return asShards[MAX_RB_SHARDS + iPartition].nMaxBytes.load();
+}
+
+/************************************************************************/
+/*                   GDALGetCachePartitionStatistics()                  */
+/************************************************************************/
+
+/**
+ * \brief Get usage statistics of a block cache partition.
+ *
+ * Hits are the number of times a block was found in the cache, misses the
+ * number of times a block had to be loaded in the cache, and evictions the
+ * number of blocks that were removed from the cache to make room for
+ * other blocks.
+ *
+ * @param pszName Partition name, or NULL for the default cache pool (the one
+ *                controlled by GDAL_CACHEMAX).
+ * @param pnUsed Pointer to the number of bytes used by the partition, or NULL.
+ * @param pnHits Pointer to the number of cache hits, or NULL.
+ * @param pnMisses Pointer to the number of cache misses, or NULL.
+ * @param pnEvictions Pointer to the number of evicted blocks, or NULL.
+ *
+ * @return TRUE in case of success, FALSE if the partition does not exist.
+ *
+ * @since GDAL 3.4
+ */
+
+int CPL_STDCALL GDALGetCachePartitionStatistics( const char* pszName,
+                                                 GIntBig* pnUsed,
+                                                 GIntBig* pnHits,
+                                                 GIntBig* pnMisses,
+                                                 GIntBig* pnEvictions )
+{
+    int iFirstShard = 0;
+    int nShardCount = GetShardCount();
+    GIntBig nUsed = nCacheUsed.load();
+    if( pszName != nullptr )
+    {
+        const int iPartition = GDALGetCachePartitionIndex(pszName);
+        if( iPartition < 0 )
+            return FALSE;
+        iFirstShard = MAX_RB_SHARDS + iPartition;
+        nShardCount = 1;
+        nUsed = asShards[iFirstShard].nUsedBytes.load();
+    }
+
+    GIntBig nHits = 0;
+    GIntBig nMisses = 0;
+    GIntBig nEvictions = 0;
+    for( int i = iFirstShard; i < iFirstShard + nShardCount; ++i )
+    {
+        nHits += asShards[i].nHits.load(std::memory_order_relaxed);
+        nMisses += asShards[i].nMisses.load(std::memory_order_relaxed);
+        nEvictions += asShards[i].nEvictions.load(std::memory_order_relaxed);
+    }
+    if( pnUsed )
+        *pnUsed = nUsed;
+    if( pnHits )
+        *pnHits = nHits;
+    if( pnMisses )
+        *pnMisses = nMisses;
+    if( pnEvictions )
+        *pnEvictions = nEvictions;
+    return TRUE;
+}
 
 /************************************************************************/
 /*                        GDALFlushCacheBlock()                         */
@@ -391,6 +1018,15 @@ int CPL_STDCALL GDALFlushCacheBlock()
  * a least recently used (LRU) list and an upper cache limit (see
  * GDALSetCacheMax()) under which the cache size is normally kept.
  *
+ * Starting with GDAL 3.4, the LRU list can be split into several shards,
+ * each protected by its own lock, by setting the GDAL_RB_CACHE_SHARDS
+ * configuration option to a number of shards (up to 64) or to ALL_CPUS.
+ * This decreases lock contention in heavily multi-threaded workloads, at the
+ * expense of an approximate LRU ordering. The cache limit remains global.
+ * Similarly, setting GDAL_RB_LAZY_TOUCH=YES avoids reordering the LRU list
+ * (and thus taking its lock) when accessing a block that is already among
+ * the most recently used ones, which benefits read-mostly workloads.
+ *
  * Some blocks in the cache may be modified relative to the state on disk
  * (they are marked "Dirty") and must be flushed to disk before they can
  * be discarded.  Other (Clean) blocks may just be discarded if their memory
@@ -431,11 +1067,46 @@ int CPL_STDCALL GDALFlushCacheBlock()
 int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
 
 {
-    GDALRasterBlock *poTarget;
+    if( FlushCacheBlockFromShards(0, GetShardCount(), bDirtyBlocksOnly) )
+        return TRUE;
 
+    const int nPartitions = nCachePartitions.load();
+    for( int i = 0; i < nPartitions; ++i )
     {
-        INITIALIZE_LOCK;
-        poTarget = poOldest;
+        if( FlushCacheBlockFromShards(MAX_RB_SHARDS + i, 1, bDirtyBlocksOnly) )
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/************************************************************************/
+/*                      FlushCacheBlockFromShards()                     */
+/************************************************************************/
+
+/*! @cond Doxygen_Suppress */
+int GDALRasterBlock::FlushCacheBlockFromShards( int iFirstShardOfPool,
+                                                int nShardsOfPool,
+                                                int bDirtyBlocksOnly )
+
+{
+    // Make sure the locks of the default pool are initialized.
+    GDALGetCacheMax64();
+
+    GDALRasterBlock *poTarget = nullptr;
+
+    // Start from a different shard at each call, so that the eviction
+    // pressure is evenly spread when several shards are used.
+    static std::atomic<unsigned> nNextShard{0};
+    const int iFirstShard = nShardsOfPool == 1 ? 0 :
+        static_cast<int>(nNextShard.fetch_add(1) %
+                                    static_cast<unsigned>(nShardsOfPool));
+
+    for( int iIter = 0; iIter < nShardsOfPool; ++iIter )
+    {
+        GDALRBShard* psShard = &asShards[iFirstShardOfPool +
+                                    (iFirstShard + iIter) % nShardsOfPool];
+        TAKE_LOCK(psShard);
+        poTarget = psShard->poOldest;
 
         while( poTarget != nullptr )
         {
@@ -450,7 +1121,7 @@ int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
         }
 
         if( poTarget == nullptr )
-            return FALSE;
+            continue;
         if( bSleepsForBockCacheDebug )
         {
             // coverity[tainted_data]
@@ -462,9 +1133,16 @@ int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
         }
 
         poTarget->Detach_unlocked();
+        psShard->nEvictions.fetch_add(1, std::memory_order_relaxed);
+        poTarget->poBand->poBandBlockCache->m_nEvictions.fetch_add(
+            1, std::memory_order_relaxed);
         poTarget->GetBand()->UnreferenceBlock(poTarget);
+        break;
     }
 
+    if( poTarget == nullptr )
+        return FALSE;
+
     if( bSleepsForBockCacheDebug )
     {
         // coverity[tainted_data]
@@ -484,12 +1162,76 @@ int GDALRasterBlock::FlushCacheBlock( int bDirtyBlocksOnly )
         }
     }
 
-    VSIFreeAligned(poTarget->pData);
+    FreeBlockData(poTarget->pData, poTarget->GetBlockSize());
     poTarget->pData = nullptr;
     poTarget->GetBand()->AddBlockToFreeList(poTarget);
 
     return TRUE;
 }
+/*! @endcond */
+
+/************************************************************************/
+/*                         GetCacheStatistics()                         */
+/************************************************************************/
+
+/**
+ * \brief Return cumulative statistics on the whole block cache.
+ *
+ * Statistics cover the default pool and all cache partitions.
+ *
+ * C++ analog to the C function GDALGetCacheStatistics().
+ *
+ * @param psStats Pointer to the structure to fill. Must not be NULL.
+ * @since GDAL 3.4
+ */
+
+void GDALRasterBlock::GetCacheStatistics( GDALCacheStatistics* psStats )
+{
+    memset(psStats, 0, sizeof(*psStats));
+    psStats->nBytesResident = nCacheUsed.load();
+    GIntBig nLockWaitNanoSec = 0;
+    const int nShards = GetShardCount();
+    const int nPartitions = nCachePartitions.load();
+    for( int i = 0; i < MAX_RB_SHARDS + nPartitions; ++i )
+    {
+        if( i >= nShards && i < MAX_RB_SHARDS )
+            continue;
+        const GDALRBShard& sShard = asShards[i];
+        psStats->nHits += sShard.nHits.load(std::memory_order_relaxed);
+        psStats->nMisses += sShard.nMisses.load(std::memory_order_relaxed);
+        psStats->nEvictions +=
+            sShard.nEvictions.load(std::memory_order_relaxed);
+        psStats->nDirtyFlushes +=
+            sShard.nDirtyFlushes.load(std::memory_order_relaxed);
+        nLockWaitNanoSec +=
+            sShard.nLockWaitNanoSec.load(std::memory_order_relaxed);
+        if( IsCachePartition(i) )
+            psStats->nBytesResident += sShard.nUsedBytes.load();
+    }
+    psStats->dfLockWaitTime = static_cast<double>(nLockWaitNanoSec) * 1e-9;
+}
+
+/************************************************************************/
+/*                         GDALGetCacheStatistics()                     */
+/************************************************************************/
+
+/**
+ * \brief Return cumulative statistics on the whole block cache.
+ *
+ * Statistics cover the default pool and all cache partitions. Use
+ * GDALGetCachePartitionStatistics() for the statistics of a given partition.
+ *
+ * @param psStats Pointer to the structure to fill. Must not be NULL.
+ * @see GDALRasterBlock::GetCacheStatistics()
+ * @since GDAL 3.4
+ */
+
+void CPL_STDCALL GDALGetCacheStatistics( GDALCacheStatistics* psStats )
+{
+    VALIDATE_POINTER0( psStats, "GDALGetCacheStatistics" );
+
+    GDALRasterBlock::GetCacheStatistics(psStats);
+}
 
 /************************************************************************/
 /*                          FlushDirtyBlocks()                          */
@@ -593,7 +1335,9 @@ GDALRasterBlock::GDALRasterBlock( GDALRasterBand *poBandIn,
     poBand(poBandIn),
     poNext(nullptr),
     poPrevious(nullptr),
-    bMustDetach(true)
+    bMustDetach(true),
+    nShard(GetShardIndex(poBandIn, nXOffIn, nYOffIn)),
+    nTouchEpoch(0)
 {
     CPLAssert( poBandIn != nullptr );
     poBand->GetBlockSize( &nXSize, &nYSize );
@@ -629,7 +1373,9 @@ GDALRasterBlock::GDALRasterBlock( int nXOffIn, int nYOffIn ) :
     poBand(nullptr),
     poNext(nullptr),
     poPrevious(nullptr),
-    bMustDetach(false)
+    bMustDetach(false),
+    nShard(0),
+    nTouchEpoch(0)
 {}
 
 /************************************************************************/
@@ -655,6 +1401,7 @@ void GDALRasterBlock::RecycleFor( int nXOffIn, int nYOffIn )
     nXOff = nXOffIn;
     nYOff = nYOffIn;
     bMustDetach = true;
+    nShard = GetShardIndex(poBand, nXOff, nYOff);
 }
 
 /************************************************************************/
@@ -674,7 +1421,7 @@ GDALRasterBlock::~GDALRasterBlock()
 
     if( pData != nullptr )
     {
-        VSIFreeAligned( pData );
+        FreeBlockData( pData, GetBlockSize() );
     }
 
     CPLAssert( nLockCount <= 0 );
@@ -717,19 +1464,26 @@ void GDALRasterBlock::Detach()
 {
     if( bMustDetach )
     {
-        TAKE_LOCK;
+        TAKE_LOCK(&asShards[nShard]);
         Detach_unlocked();
     }
 }
 
 void GDALRasterBlock::Detach_unlocked()
 {
-    if( poOldest == this )
-        poOldest = poPrevious;
+    GDALRBShard* psShard = &asShards[nShard];
+    if( poPrevious != nullptr || poNext != nullptr ||
+        psShard->poOldest == this )
+    {
+        psShard->nBlockCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    if( psShard->poOldest == this )
+        psShard->poOldest = poPrevious;
 
-    if( poNewest == this )
+    if( psShard->poNewest == this )
     {
-        poNewest = poNext;
+        psShard->poNewest = poNext;
     }
 
     if( poPrevious != nullptr )
@@ -743,7 +1497,12 @@ void GDALRasterBlock::Detach_unlocked()
     bMustDetach = false;
 
     if( pData )
-        nCacheUsed -= GetEffectiveBlockSize(GetBlockSize());
+    {
+        const auto nEffectiveSize = GetEffectiveBlockSize(GetBlockSize());
+        GetUsedBytesCounter(nShard) -= nEffectiveSize;
+        if( poBand && poBand->poBandBlockCache )
+            poBand->poBandBlockCache->m_nBytesResident -= nEffectiveSize;
+    }
 
 #ifdef ENABLE_DEBUG
     Verify();
@@ -763,27 +1522,38 @@ void GDALRasterBlock::Detach_unlocked()
 void GDALRasterBlock::Verify()
 
 {
-    TAKE_LOCK;
-
-    CPLAssert( (poNewest == nullptr && poOldest == nullptr)
-               || (poNewest != nullptr && poOldest != nullptr) );
-
-    if( poNewest != nullptr )
+    const int nShards = GetShardCount();
+    const int nPartitions = nCachePartitions.load();
+    for( int i = 0; i < MAX_RB_SHARDS + nPartitions; ++i )
     {
-        CPLAssert( poNewest->poPrevious == nullptr );
-        CPLAssert( poOldest->poNext == nullptr );
+        if( i >= nShards && i < MAX_RB_SHARDS )
+            continue;
+        GDALRBShard* psShard = &asShards[i];
+        TAKE_LOCK(psShard);
 
-        GDALRasterBlock* poLast = nullptr;
-        for( GDALRasterBlock *poBlock = poNewest;
-             poBlock != nullptr;
-             poBlock = poBlock->poNext )
+        GDALRasterBlock* poNewest = psShard->poNewest;
+        GDALRasterBlock* poOldest = psShard->poOldest;
+        CPLAssert( (poNewest == nullptr && poOldest == nullptr)
+                   || (poNewest != nullptr && poOldest != nullptr) );
+
+        if( poNewest != nullptr )
         {
-            CPLAssert( poBlock->poPrevious == poLast );
+            CPLAssert( poNewest->poPrevious == nullptr );
+            CPLAssert( poOldest->poNext == nullptr );
 
-            poLast = poBlock;
-        }
+            GDALRasterBlock* poLast = nullptr;
+            for( GDALRasterBlock *poBlock = poNewest;
+                 poBlock != nullptr;
+                 poBlock = poBlock->poNext )
+            {
+                CPLAssert( poBlock->poPrevious == poLast );
+                CPLAssert( poBlock->nShard == i );
+
+                poLast = poBlock;
+            }
 
-        CPLAssert( poOldest == poLast );
+            CPLAssert( poOldest == poLast );
+        }
     }
 }
 
@@ -794,25 +1564,33 @@ void GDALRasterBlock::Verify() {}
 #ifdef notdef
 void GDALRasterBlock::CheckNonOrphanedBlocks( GDALRasterBand* poBand )
 {
-    TAKE_LOCK;
-    for( GDALRasterBlock *poBlock = poNewest;
-                          poBlock != nullptr;
-                          poBlock = poBlock->poNext )
+    const int nShards = GetShardCount();
+    const int nPartitions = nCachePartitions.load();
+    for( int i = 0; i < MAX_RB_SHARDS + nPartitions; ++i )
     {
-        if ( poBlock->GetBand() == poBand )
+        if( i >= nShards && i < MAX_RB_SHARDS )
+            continue;
+        GDALRBShard* psShard = &asShards[i];
+        TAKE_LOCK(psShard);
+        for( GDALRasterBlock *poBlock = psShard->poNewest;
+                              poBlock != nullptr;
+                              poBlock = poBlock->poNext )
         {
-            printf("Cache has still blocks of band %p\n", poBand);/*ok*/
-            printf("Band : %d\n", poBand->GetBand());/*ok*/
-            printf("nRasterXSize = %d\n", poBand->GetXSize());/*ok*/
-            printf("nRasterYSize = %d\n", poBand->GetYSize());/*ok*/
-            int nBlockXSize, nBlockYSize;
-            poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
-            printf("nBlockXSize = %d\n", nBlockXSize);/*ok*/
-            printf("nBlockYSize = %d\n", nBlockYSize);/*ok*/
-            printf("Dataset : %p\n", poBand->GetDataset());/*ok*/
-            if( poBand->GetDataset() )
-                printf("Dataset : %s\n",/*ok*/
-                       poBand->GetDataset()->GetDescription());
+            if ( poBlock->GetBand() == poBand )
+            {
+                printf("Cache has still blocks of band %p\n", poBand);/*ok*/
+                printf("Band : %d\n", poBand->GetBand());/*ok*/
+                printf("nRasterXSize = %d\n", poBand->GetXSize());/*ok*/
+                printf("nRasterYSize = %d\n", poBand->GetYSize());/*ok*/
+                int nBlockXSize, nBlockYSize;
+                poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+                printf("nBlockXSize = %d\n", nBlockXSize);/*ok*/
+                printf("nBlockYSize = %d\n", nBlockYSize);/*ok*/
+                printf("Dataset : %p\n", poBand->GetDataset());/*ok*/
+                if( poBand->GetDataset() )
+                    printf("Dataset : %s\n",/*ok*/
+                           poBand->GetDataset()->GetDescription());
+            }
         }
     }
 }
@@ -843,8 +1621,26 @@ CPLErr GDALRasterBlock::Write()
 
     MarkClean();
 
+    asShards[nShard].nDirtyFlushes.fetch_add(1, std::memory_order_relaxed);
+    if( poBand->poBandBlockCache )
+        poBand->poBandBlockCache->m_nDirtyFlushes.fetch_add(
+            1, std::memory_order_relaxed);
+
     if (poBand->eFlushBlockErr == CE_None)
     {
+        CPLTraceSpan oSpan("gdal", "IWriteBlock");
+        if( oSpan.IsActive() )
+        {
+            oSpan.AddArg("band", static_cast<GIntBig>(poBand->GetBand()));
+            oSpan.AddArg("x_block", static_cast<GIntBig>(nXOff));
+            oSpan.AddArg("y_block", static_cast<GIntBig>(nYOff));
+        }
+
+        GDAL_PERF_COUNTER(poBlocksWrittenCounter, "GDAL.blocks_written");
+        GDAL_PERF_COUNTER(poWriteTimeCounter, "GDAL.block_write_time_ns");
+        poBlocksWrittenCounter->Increment();
+        GDALPerfCounterTimer oTimer(poWriteTimeCounter);
+
         int bCallLeaveReadWrite = poBand->EnterReadWrite(GF_Write);
         CPLErr eErr = poBand->IWriteBlock( nXOff, nYOff, pData );
         if( bCallLeaveReadWrite ) poBand->LeaveReadWrite();
@@ -868,11 +1664,13 @@ CPLErr GDALRasterBlock::Write()
 void GDALRasterBlock::Touch()
 
 {
+    GDALRBShard* psShard = &asShards[nShard];
+
     // Can be safely tested outside the lock
-    if( poNewest == this )
+    if( psShard->poNewest == this )
         return;
 
-    TAKE_LOCK;
+    TAKE_LOCK(psShard);
     Touch_unlocked();
 }
 
@@ -885,15 +1683,25 @@ void GDALRasterBlock::Touch_unlocked()
     // 1. Thread 1 calls Touch() and poNewest != this at that point
     // 2. Thread 2 detaches poNewest
     // 3. Thread 1 arrives here
-    if( poNewest == this )
+    GDALRBShard* psShard = &asShards[nShard];
+    if( psShard->poNewest == this )
         return;
 
     // We should not try to touch a block that has been detached.
     // If that happen, corruption has already occurred.
     CPLAssert(bMustDetach);
 
-    if( poOldest == this )
-        poOldest = this->poPrevious;
+    if( poPrevious == nullptr && poNext == nullptr &&
+        psShard->poOldest != this )
+    {
+        psShard->nBlockCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    nTouchEpoch.store(
+        psShard->nTouchCounter.fetch_add(1, std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+
+    if( psShard->poOldest == this )
+        psShard->poOldest = this->poPrevious;
 
     if( poPrevious != nullptr )
         poPrevious->poNext = poNext;
@@ -902,19 +1710,19 @@ void GDALRasterBlock::Touch_unlocked()
         poNext->poPrevious = poPrevious;
 
     poPrevious = nullptr;
-    poNext = poNewest;
+    poNext = psShard->poNewest;
 
-    if( poNewest != nullptr )
+    if( psShard->poNewest != nullptr )
     {
-        CPLAssert( poNewest->poPrevious == nullptr );
-        poNewest->poPrevious = this;
+        CPLAssert( psShard->poNewest->poPrevious == nullptr );
+        psShard->poNewest->poPrevious = this;
     }
-    poNewest = this;
+    psShard->poNewest = this;
 
-    if( poOldest == nullptr )
+    if( psShard->poOldest == nullptr )
     {
         CPLAssert( poPrevious == nullptr && poNext == nullptr );
-        poOldest = this;
+        psShard->poOldest = this;
     }
 #ifdef ENABLE_DEBUG
     Verify();
@@ -943,9 +1751,20 @@ CPLErr GDALRasterBlock::Internalize()
 
     void        *pNewData = nullptr;
 
-    // This call will initialize the hRBLock mutex. Other call places can
+    // This call will initialize the LRU shard locks. Other call places can
     // only be called if we have go through there.
-    const GIntBig nCurCacheMax = GDALGetCacheMax64();
+    GIntBig nCurCacheMax = GDALGetCacheMax64();
+
+    // Blocks of a dataset assigned to a cache partition are only accounted
+    // and evicted within that partition.
+    const bool bInPartition = IsCachePartition(nShard);
+    if( bInPartition )
+        nCurCacheMax = asShards[nShard].nMaxBytes.load();
+    std::atomic<GIntBig>& nPoolUsed = GetUsedBytesCounter(nShard);
+    asShards[nShard].nMisses.fetch_add(1, std::memory_order_relaxed);
+    GDALAbstractBandBlockCache* poBandBlockCache = poBand->poBandBlockCache;
+    if( poBandBlockCache )
+        poBandBlockCache->m_nMisses.fetch_add(1, std::memory_order_relaxed);
 
     // No risk of overflow as it is checked in GDALRasterBand::InitBlockInfo().
     const auto nSizeInBytes = GetBlockSize();
@@ -956,18 +1775,24 @@ CPLErr GDALRasterBlock::Internalize()
     bool bFirstIter = true;
     bool bLoopAgain = false;
     GDALDataset* poThisDS = poBand->GetDataset();
+    // Blocks are evicted preferably from the shard of this block, and then
+    // from the other ones if it has no candidate.
+    const int nShards = bInPartition ? 1 : GetShardCount();
+    int iTargetShard = nShard;
+    int nShardsVisited = 1;
     do
     {
         bLoopAgain = false;
         GDALRasterBlock* apoBlocksToFree[64] = { nullptr };
         int nBlocksToFree = 0;
         {
-            TAKE_LOCK;
+            GDALRBShard* psShard = &asShards[iTargetShard];
+            TAKE_LOCK(psShard);
 
             if( bFirstIter )
-                nCacheUsed += GetEffectiveBlockSize(nSizeInBytes);
-            GDALRasterBlock *poTarget = poOldest;
-            while( nCacheUsed > nCurCacheMax )
+                nPoolUsed += GetEffectiveBlockSize(nSizeInBytes);
+            GDALRasterBlock *poTarget = psShard->poOldest;
+            while( nPoolUsed > nCurCacheMax )
             {
                 GDALRasterBlock* poDirtyBlockOtherDataset = nullptr;
                 // In this first pass, only discard dirty blocks of this
@@ -1012,7 +1837,7 @@ CPLErr GDALRasterBlock::Internalize()
                     }
                     else
                     {
-                        poTarget = poOldest;
+                        poTarget = psShard->poOldest;
                         while( poTarget != nullptr )
                         {
                             if( CPLAtomicCompareAndExchange(
@@ -1021,6 +1846,7 @@ CPLErr GDALRasterBlock::Internalize()
                                 CPLDebug("GDAL", "Evicting dirty block of another dataset");
                                 break;
                             }
+                            poTarget = poTarget->poPrevious;
                         }
                     }
                 }
@@ -1041,6 +1867,9 @@ CPLErr GDALRasterBlock::Internalize()
                     GDALRasterBlock* _poPrevious = poTarget->poPrevious;
 
                     poTarget->Detach_unlocked();
+                    psShard->nEvictions.fetch_add(1, std::memory_order_relaxed);
+                    poTarget->poBand->poBandBlockCache->m_nEvictions.fetch_add(
+                        1, std::memory_order_relaxed);
                     poTarget->GetBand()->UnreferenceBlock(poTarget);
 
                     apoBlocksToFree[nBlocksToFree++] = poTarget;
@@ -1049,12 +1878,12 @@ CPLErr GDALRasterBlock::Internalize()
                         // Only free one dirty block at a time so that
                         // other dirty blocks of other bands with the same
                         // coordinates can be found with TryGetLockedBlock()
-                        bLoopAgain = nCacheUsed > nCurCacheMax;
+                        bLoopAgain = nPoolUsed > nCurCacheMax;
                         break;
                     }
                     if( nBlocksToFree == 64 )
                     {
-                        bLoopAgain = ( nCacheUsed > nCurCacheMax );
+                        bLoopAgain = ( nPoolUsed > nCurCacheMax );
                         break;
                     }
 
@@ -1062,6 +1891,13 @@ CPLErr GDALRasterBlock::Internalize()
                 }
                 else
                 {
+                    // No candidate in this shard: try with the next one.
+                    if( nShardsVisited < nShards )
+                    {
+                        nShardsVisited++;
+                        iTargetShard = (iTargetShard + 1) % nShards;
+                        bLoopAgain = true;
+                    }
                     break;
                 }
             }
@@ -1069,10 +1905,16 @@ CPLErr GDALRasterBlock::Internalize()
         /* ------------------------------------------------------------------ */
         /*      Add this block to the list.                                   */
         /* ------------------------------------------------------------------ */
-            if( !bLoopAgain )
+            if( !bLoopAgain && iTargetShard == nShard )
                 Touch_unlocked();
         }
 
+        if( !bLoopAgain && iTargetShard != nShard )
+        {
+            TAKE_LOCK(&asShards[nShard]);
+            Touch_unlocked();
+        }
+
         bFirstIter = false;
 
         // Now free blocks we have detached and removed from their band.
@@ -1110,7 +1952,7 @@ CPLErr GDALRasterBlock::Internalize()
             }
             else
             {
-                VSIFreeAligned(poBlock->pData);
+                FreeBlockData(poBlock->pData, poBlock->GetBlockSize());
             }
             poBlock->pData = nullptr;
 
@@ -1121,7 +1963,7 @@ CPLErr GDALRasterBlock::Internalize()
 
     if( pNewData == nullptr )
     {
-        pNewData = VSI_MALLOC_ALIGNED_AUTO_VERBOSE( nSizeInBytes );
+        pNewData = AllocBlockData( nSizeInBytes );
         if( pNewData == nullptr )
         {
             return( CE_Failure );
@@ -1129,6 +1971,9 @@ CPLErr GDALRasterBlock::Internalize()
     }
 
     pData = pNewData;
+    if( poBandBlockCache )
+        poBandBlockCache->m_nBytesResident +=
+            GetEffectiveBlockSize(nSizeInBytes);
 
     return CE_None;
 }
@@ -1180,9 +2025,32 @@ void GDALRasterBlock::MarkClean()
 /*! @cond Doxygen_Suppress */
 void GDALRasterBlock::DestroyRBMutex()
 {
-    if( hRBLock != nullptr )
-        DESTROY_LOCK;
-    hRBLock = nullptr;
+    for( auto& sShard: asShards )
+    {
+        if( sShard.hLock != nullptr )
+            DESTROY_LOCK(&sShard);
+        sShard.hLock = nullptr;
+    }
+
+    std::lock_guard<std::mutex> oLock(oBufferPool.oMutex);
+    if( !oBufferPool.oMapSlabs.empty() )
+    {
+        CPLDebug("GDAL", "Block buffer pool: " CPL_FRMT_GUIB " bytes in %d "
+                 "slabs, " CPL_FRMT_GIB " buffers reused",
+                 static_cast<GUIntBig>(oBufferPool.nSlabBytes),
+                 static_cast<int>(oBufferPool.oMapSlabs.size()),
+                 oBufferPool.nReused);
+    }
+    // Slabs can only be released once no block references them anymore.
+    if( oBufferPool.nBuffersInUse == 0 )
+    {
+        for( const auto& oSlab: oBufferPool.oMapSlabs )
+            FreeSlab(oSlab.first, oSlab.second);
+        oBufferPool.oMapSlabs.clear();
+        oBufferPool.oMapSlabTail.clear();
+        oBufferPool.oMapFreeLists.clear();
+        oBufferPool.nSlabBytes = 0;
+    }
 }
 /*! @endcond */
 
@@ -1229,6 +2097,25 @@ int GDALRasterBlock::TakeLock()
 
         return FALSE;
     }
+    asShards[nShard].nHits.fetch_add(1, std::memory_order_relaxed);
+    if( poBand && poBand->poBandBlockCache )
+        poBand->poBandBlockCache->m_nHits.fetch_add(
+            1, std::memory_order_relaxed);
+    if( IsLazyTouch() )
+    {
+        // Do not move the block to the head of the LRU list if it is
+        // already among the most recently used ones (roughly the first
+        // quarter of the list).
+        const GDALRBShard* psShard = &asShards[nShard];
+        const unsigned nAge =
+            psShard->nTouchCounter.load(std::memory_order_relaxed) -
+            nTouchEpoch.load(std::memory_order_relaxed);
+        if( nAge < static_cast<unsigned>(
+                psShard->nBlockCount.load(std::memory_order_relaxed)) / 4 )
+        {
+            return TRUE;
+        }
+    }
     Touch();
     return TRUE;
 }
@@ -1261,7 +2148,7 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 #endif
 
     // Wait for the block for having been unreferenced.
-    TAKE_LOCK;
+    TAKE_LOCK(&asShards[nShard]);
 
     return FALSE;
 }
@@ -1270,14 +2157,23 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 void GDALRasterBlock::DumpAll()
 {
     int iBlock = 0;
-    for( GDALRasterBlock *poBlock = poNewest;
-         poBlock != nullptr;
-         poBlock = poBlock->poNext )
+    const int nShards = GetShardCount();
+    const int nPartitions = nCachePartitions.load();
+    for( int i = 0; i < MAX_RB_SHARDS + nPartitions; ++i )
     {
-        printf("Block %d\n", iBlock);/*ok*/
-        poBlock->DumpBlock();
-        printf("\n");/*ok*/
-        iBlock++;
+        if( i >= nShards && i < MAX_RB_SHARDS )
+            continue;
+        GDALRBShard* psShard = &asShards[i];
+        TAKE_LOCK(psShard);
+        for( GDALRasterBlock *poBlock = psShard->poNewest;
+             poBlock != nullptr;
+             poBlock = poBlock->poNext )
+        {
+            printf("Block %d (shard %d)\n", iBlock, i);/*ok*/
+            poBlock->DumpBlock();
+            printf("\n");/*ok*/
+            iBlock++;
+        }
     }
 }
 
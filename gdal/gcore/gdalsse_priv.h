@@ -402,6 +402,306 @@ class XMMReg2Double
     }
 };
 
+#elif defined(__aarch64__) && !defined(USE_SSE2_EMULATION)
+
+/* Advanced SIMD (NEON) is mandatory on AArch64 */
+#include <arm_neon.h>
+#include <string.h>
+
+#define USE_NEON_OPTIMIZATIONS
+
+class XMMReg2Double
+{
+  public:
+    float64x2_t xmm;
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Weffc++"
+#endif
+    /* coverity[uninit_member] */
+    XMMReg2Double() = default;
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+    XMMReg2Double(double  val): xmm(vsetq_lane_f64(val, vdupq_n_f64(0.0), 0)) {}
+    XMMReg2Double(const XMMReg2Double& other) : xmm(other.xmm) {}
+
+    static inline XMMReg2Double Zero()
+    {
+        XMMReg2Double reg;
+        reg.Zeroize();
+        return reg;
+    }
+
+    static inline XMMReg2Double Load1ValHighAndLow(const double* ptr)
+    {
+        XMMReg2Double reg;
+        reg.nsLoad1ValHighAndLow(ptr);
+        return reg;
+    }
+
+    static inline XMMReg2Double Load2Val(const double* ptr)
+    {
+        XMMReg2Double reg;
+        reg.nsLoad2Val(ptr);
+        return reg;
+    }
+
+    static inline XMMReg2Double Load2Val(const float* ptr)
+    {
+        XMMReg2Double reg;
+        reg.nsLoad2Val(ptr);
+        return reg;
+    }
+
+    static inline XMMReg2Double Load2ValAligned(const double* ptr)
+    {
+        XMMReg2Double reg;
+        reg.nsLoad2ValAligned(ptr);
+        return reg;
+    }
+
+    static inline XMMReg2Double Load2Val(const unsigned char* ptr)
+    {
+        XMMReg2Double reg;
+        reg.nsLoad2Val(ptr);
+        return reg;
+    }
+
+    static inline XMMReg2Double Load2Val(const short* ptr)
+    {
+        XMMReg2Double reg;
+        reg.nsLoad2Val(ptr);
+        return reg;
+    }
+
+    static inline XMMReg2Double Load2Val(const unsigned short* ptr)
+    {
+        XMMReg2Double reg;
+        reg.nsLoad2Val(ptr);
+        return reg;
+    }
+
+    static inline XMMReg2Double Equals(const XMMReg2Double& expr1, const XMMReg2Double& expr2)
+    {
+        XMMReg2Double reg;
+        reg.xmm = vreinterpretq_f64_u64(vceqq_f64(expr1.xmm, expr2.xmm));
+        return reg;
+    }
+
+    static inline XMMReg2Double NotEquals(const XMMReg2Double& expr1, const XMMReg2Double& expr2)
+    {
+        XMMReg2Double reg;
+        reg.xmm = vreinterpretq_f64_u32(vmvnq_u32(
+            vreinterpretq_u32_u64(vceqq_f64(expr1.xmm, expr2.xmm))));
+        return reg;
+    }
+
+    static inline XMMReg2Double Greater(const XMMReg2Double& expr1, const XMMReg2Double& expr2)
+    {
+        XMMReg2Double reg;
+        reg.xmm = vreinterpretq_f64_u64(vcgtq_f64(expr1.xmm, expr2.xmm));
+        return reg;
+    }
+
+    static inline XMMReg2Double And(const XMMReg2Double& expr1, const XMMReg2Double& expr2)
+    {
+        XMMReg2Double reg;
+        reg.xmm = vreinterpretq_f64_u64(vandq_u64(
+            vreinterpretq_u64_f64(expr1.xmm), vreinterpretq_u64_f64(expr2.xmm)));
+        return reg;
+    }
+
+    static inline XMMReg2Double Ternary(const XMMReg2Double& cond, const XMMReg2Double& true_expr, const XMMReg2Double& false_expr)
+    {
+        XMMReg2Double reg;
+        reg.xmm = vbslq_f64(vreinterpretq_u64_f64(cond.xmm), true_expr.xmm, false_expr.xmm);
+        return reg;
+    }
+
+    static inline XMMReg2Double Min(const XMMReg2Double& expr1, const XMMReg2Double& expr2)
+    {
+        XMMReg2Double reg;
+        // Not vminq_f64(), so that NaN are handled like with _mm_min_pd():
+        // the second operand is returned if any of them is NaN.
+        reg.xmm = vbslq_f64(vcltq_f64(expr1.xmm, expr2.xmm), expr1.xmm, expr2.xmm);
+        return reg;
+    }
+
+    inline void nsLoad1ValHighAndLow(const double* ptr)
+    {
+        xmm = vld1q_dup_f64(ptr);
+    }
+
+    inline void nsLoad2Val(const double* ptr)
+    {
+        xmm = vld1q_f64(ptr);
+    }
+
+    inline void nsLoad2ValAligned(const double* ptr)
+    {
+        xmm = vld1q_f64(ptr);
+    }
+
+    inline void nsLoad2Val(const float* ptr)
+    {
+        xmm = vcvt_f64_f32(vld1_f32(ptr));
+    }
+
+    inline void nsLoad2Val(const unsigned char* ptr)
+    {
+        xmm = vsetq_lane_f64(ptr[1], vdupq_n_f64(ptr[0]), 1);
+    }
+
+    inline void nsLoad2Val(const short* ptr)
+    {
+        xmm = vsetq_lane_f64(ptr[1], vdupq_n_f64(ptr[0]), 1);
+    }
+
+    inline void nsLoad2Val(const unsigned short* ptr)
+    {
+        xmm = vsetq_lane_f64(ptr[1], vdupq_n_f64(ptr[0]), 1);
+    }
+
+    static inline void Load4Val(const unsigned char* ptr, XMMReg2Double& low, XMMReg2Double& high)
+    {
+        GUInt32 nVal;
+        memcpy(&nVal, ptr, sizeof(nVal));
+        const uint16x8_t v16 = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(nVal)));
+        const uint32x4_t v32 = vmovl_u16(vget_low_u16(v16));
+        low.xmm = vcvtq_f64_u64(vmovl_u32(vget_low_u32(v32)));
+        high.xmm = vcvtq_f64_u64(vmovl_u32(vget_high_u32(v32)));
+    }
+
+    static inline void Load4Val(const short* ptr, XMMReg2Double& low, XMMReg2Double& high)
+    {
+        const int32x4_t v32 = vmovl_s16(vld1_s16(ptr));
+        low.xmm = vcvtq_f64_s64(vmovl_s32(vget_low_s32(v32)));
+        high.xmm = vcvtq_f64_s64(vmovl_s32(vget_high_s32(v32)));
+    }
+
+    static inline void Load4Val(const unsigned short* ptr, XMMReg2Double& low, XMMReg2Double& high)
+    {
+        const uint32x4_t v32 = vmovl_u16(vld1_u16(ptr));
+        low.xmm = vcvtq_f64_u64(vmovl_u32(vget_low_u32(v32)));
+        high.xmm = vcvtq_f64_u64(vmovl_u32(vget_high_u32(v32)));
+    }
+
+    static inline void Load4Val(const double* ptr, XMMReg2Double& low, XMMReg2Double& high)
+    {
+        low.nsLoad2Val(ptr);
+        high.nsLoad2Val(ptr+2);
+    }
+
+    static inline void Load4Val(const float* ptr, XMMReg2Double& low, XMMReg2Double& high)
+    {
+        const float32x4_t v = vld1q_f32(ptr);
+        low.xmm = vcvt_f64_f32(vget_low_f32(v));
+        high.xmm = vcvt_high_f64_f32(v);
+    }
+
+    inline void Zeroize()
+    {
+        xmm = vdupq_n_f64(0.0);
+    }
+
+    inline XMMReg2Double& operator= (const XMMReg2Double& other)
+    {
+        xmm = other.xmm;
+        return *this;
+    }
+
+    inline XMMReg2Double& operator+= (const XMMReg2Double& other)
+    {
+        xmm = vaddq_f64(xmm, other.xmm);
+        return *this;
+    }
+
+    inline XMMReg2Double& operator*= (const XMMReg2Double& other)
+    {
+        xmm = vmulq_f64(xmm, other.xmm);
+        return *this;
+    }
+
+    inline XMMReg2Double operator+ (const XMMReg2Double& other) const
+    {
+        XMMReg2Double ret;
+        ret.xmm = vaddq_f64(xmm, other.xmm);
+        return ret;
+    }
+
+    inline XMMReg2Double operator- (const XMMReg2Double& other) const
+    {
+        XMMReg2Double ret;
+        ret.xmm = vsubq_f64(xmm, other.xmm);
+        return ret;
+    }
+
+    inline XMMReg2Double operator* (const XMMReg2Double& other) const
+    {
+        XMMReg2Double ret;
+        ret.xmm = vmulq_f64(xmm, other.xmm);
+        return ret;
+    }
+
+    inline XMMReg2Double operator/ (const XMMReg2Double& other) const
+    {
+        XMMReg2Double ret;
+        ret.xmm = vdivq_f64(xmm, other.xmm);
+        return ret;
+    }
+
+    inline double GetHorizSum() const
+    {
+        return vaddvq_f64(xmm);
+    }
+
+    inline void Store2Val(double* ptr) const
+    {
+        vst1q_f64(ptr, xmm);
+    }
+
+    inline void Store2ValAligned(double* ptr) const
+    {
+        vst1q_f64(ptr, xmm);
+    }
+
+    inline void Store2Val(float* ptr) const
+    {
+        vst1_f32(ptr, vcvt_f32_f64(xmm));
+    }
+
+    inline void Store2Val(unsigned char* ptr) const
+    {
+        /* Round, and saturate to [0,255] as _mm_packs_epi32() + _mm_packus_epi16() do */
+        const int32x2_t i32 = vqmovn_s64(vcvtq_s64_f64(vaddq_f64(xmm, vdupq_n_f64(0.5))));
+        const uint16x4_t u16 = vqmovun_s32(vcombine_s32(i32, i32));
+        const uint8x8_t u8 = vqmovn_u16(vcombine_u16(u16, u16));
+        ptr[0] = vget_lane_u8(u8, 0);
+        ptr[1] = vget_lane_u8(u8, 1);
+    }
+
+    inline void Store2Val(unsigned short* ptr) const
+    {
+        /* Round, and keep the 16 low bits as the SSE2 implementation does */
+        const int32x2_t i32 = vmovn_s64(vcvtq_s64_f64(vaddq_f64(xmm, vdupq_n_f64(0.5))));
+        ptr[0] = static_cast<unsigned short>(vget_lane_s32(i32, 0));
+        ptr[1] = static_cast<unsigned short>(vget_lane_s32(i32, 1));
+    }
+
+    inline void StoreMask(unsigned char* ptr) const
+    {
+        vst1q_u8(ptr, vreinterpretq_u8_f64(xmm));
+    }
+
+    inline operator double () const
+    {
+        return vgetq_lane_f64(xmm, 0);
+    }
+};
+
 #else
 
 #ifndef NO_WARN_USE_SSE2_EMULATION
@@ -745,7 +1045,7 @@ class XMMReg2Double
     }
 };
 
-#endif /*  defined(__x86_64) || defined(_M_X64) */
+#endif /*  defined(__x86_64) || defined(_M_X64) || defined(__aarch64__) */
 
 #ifdef __AVX__
 
@@ -1191,7 +1491,7 @@ class XMMReg4Double
 
     inline void Store4Val(unsigned char* ptr) const
     {
-#ifdef USE_SSE2_EMULATION
+#if defined(USE_SSE2_EMULATION) || defined(USE_NEON_OPTIMIZATIONS)
         low.Store2Val(ptr);
         high.Store2Val(ptr+2);
 #else
@@ -35,6 +35,9 @@
 #include <cstring>
 
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -76,11 +79,33 @@ class GDALVirtualMem
     size_t GetOffset( const coord_type& x, const coord_type& y, int band ) const;
     bool GotoNextPixel( coord_type& x, coord_type& y, int& band ) const;
 
-    void DoIOBandSequential( GDALRWFlag eRWFlag, size_t nOffset,
+    void DoIOBandSequential( GDALRWFlag eRWFlag,
+                             GDALDatasetH hDSIO, GDALRasterBandH hBandIO,
+                             size_t nOffset,
                              void* pPage, size_t nBytes ) const;
-    void DoIOPixelInterleaved( GDALRWFlag eRWFlag, size_t nOffset,
+    void DoIOPixelInterleaved( GDALRWFlag eRWFlag, GDALDatasetH hDSIO,
+                               size_t nOffset,
                                void* pPage, size_t nBytes ) const;
 
+    // Pool of dataset handles, used when pages may be filled concurrently
+    // by several threads (userfaultfd backend). The source dataset is always
+    // part of the pool, and additional read-only handles are opened on
+    // demand, up to nMaxHandles.
+    bool bMultiThreaded = false;
+    GDALDatasetH hSrcDS = nullptr;
+    int nSrcBand = 0;
+    std::mutex oPoolMutex{};
+    std::condition_variable oPoolCV{};
+    std::vector<GDALDatasetH> ahFreeDS{};
+    std::vector<GDALDatasetH> ahOwnedDS{};
+    int nHandles = 1;
+    int nMaxHandles = 1;
+
+    GDALDatasetH AcquireDataset();
+    void ReleaseDataset( GDALDatasetH hDSIO );
+    GDALRasterBandH GetBandIO( GDALDatasetH hDSIO ) const;
+    GDALDatasetH ReopenDataset() const;
+
     CPL_DISALLOW_COPY_ASSIGN(GDALVirtualMem)
 
 public:
@@ -99,6 +124,8 @@ public:
                              GIntBig nBandSpace );
             ~GDALVirtualMem();
 
+    void EnableMultiThreading( int nThreads );
+
     static void FillCacheBandSequential( CPLVirtualMem* ctxt,  size_t nOffset,
                                          void* pPageToFill,
                                          size_t nToFill, void* pUserData );
@@ -184,6 +211,16 @@ GDALVirtualMem::GDALVirtualMem( GDALDatasetH hDSIn,
         bIsCompact = false;
 
     bIsBandSequential = nBandSpace >= nBufYSize * nLineSpace;
+
+    if( hDS != nullptr )
+    {
+        hSrcDS = hDS;
+    }
+    else
+    {
+        hSrcDS = GDALGetBandDataset(hBand);
+        nSrcBand = GDALGetBandNumber(hBand);
+    }
 }
 
 /************************************************************************/
@@ -193,6 +230,133 @@ GDALVirtualMem::GDALVirtualMem( GDALDatasetH hDSIn,
 GDALVirtualMem::~GDALVirtualMem()
 {
     CPLFree(panBandMap);
+    for( GDALDatasetH hOwnedDS: ahOwnedDS )
+        GDALClose(hOwnedDS);
+}
+
+/************************************************************************/
+/*                        EnableMultiThreading()                        */
+/************************************************************************/
+
+void GDALVirtualMem::EnableMultiThreading( int nThreads )
+{
+    bMultiThreaded = true;
+    // A null entry stands for the handles provided by the caller.
+    ahFreeDS.push_back(hDS);
+    nHandles = 1;
+    nMaxHandles = 1;
+
+    // Additional handles can only be obtained by reopening the dataset in
+    // read-only mode, and, in the band case, if it is a real band of it.
+    if( nThreads > 1 && hSrcDS != nullptr &&
+        (hDS != nullptr || nSrcBand > 0) &&
+        GDALGetAccess(hSrcDS) == GA_ReadOnly &&
+        GDALGetDatasetDriver(hSrcDS) != nullptr &&
+        !EQUAL(GDALGetDriverShortName(GDALGetDatasetDriver(hSrcDS)), "MEM") &&
+        GDALGetDescription(hSrcDS)[0] != '\0' )
+    {
+        nMaxHandles = nThreads;
+    }
+}
+
+/************************************************************************/
+/*                           ReopenDataset()                            */
+/************************************************************************/
+
+GDALDatasetH GDALVirtualMem::ReopenDataset() const
+{
+    // Use the same driver and open options as the source dataset, so that
+    // the new handle exposes the same bands (subdatasets, overview levels,
+    // etc.)
+    const char* const apszAllowedDrivers[] = {
+        GDALGetDriverShortName(GDALGetDatasetDriver(hSrcDS)), nullptr };
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    GDALDatasetH hNewDS = GDALOpenEx(
+        GDALGetDescription(hSrcDS), GDAL_OF_RASTER | GDAL_OF_READONLY,
+        apszAllowedDrivers,
+        GDALDataset::FromHandle(hSrcDS)->GetOpenOptions(), nullptr);
+    CPLPopErrorHandler();
+    if( hNewDS == nullptr )
+        return nullptr;
+
+    // Make sure we get the same thing as the source dataset.
+    if( GDALGetDatasetDriver(hNewDS) != GDALGetDatasetDriver(hSrcDS) ||
+        GDALGetRasterXSize(hNewDS) != GDALGetRasterXSize(hSrcDS) ||
+        GDALGetRasterYSize(hNewDS) != GDALGetRasterYSize(hSrcDS) ||
+        GDALGetRasterCount(hNewDS) != GDALGetRasterCount(hSrcDS) )
+    {
+        GDALClose(hNewDS);
+        return nullptr;
+    }
+    return hNewDS;
+}
+
+/************************************************************************/
+/*                           AcquireDataset()                           */
+/************************************************************************/
+
+GDALDatasetH GDALVirtualMem::AcquireDataset()
+{
+    if( !bMultiThreaded )
+        return hDS;
+
+    std::unique_lock<std::mutex> oLock(oPoolMutex);
+    while( true )
+    {
+        if( !ahFreeDS.empty() )
+        {
+            GDALDatasetH hDSIO = ahFreeDS.back();
+            ahFreeDS.pop_back();
+            return hDSIO;
+        }
+        if( nHandles < nMaxHandles )
+        {
+            nHandles++;
+            oLock.unlock();
+            GDALDatasetH hNewDS = ReopenDataset();
+            oLock.lock();
+            if( hNewDS != nullptr )
+            {
+                ahOwnedDS.push_back(hNewDS);
+                return hNewDS;
+            }
+            // Reopening failed: do not try again, and share the existing
+            // handles.
+            nHandles--;
+            nMaxHandles = nHandles;
+            continue;
+        }
+        oPoolCV.wait(oLock);
+    }
+}
+
+/************************************************************************/
+/*                           ReleaseDataset()                           */
+/************************************************************************/
+
+void GDALVirtualMem::ReleaseDataset( GDALDatasetH hDSIO )
+{
+    if( !bMultiThreaded )
+        return;
+
+    {
+        std::lock_guard<std::mutex> oLock(oPoolMutex);
+        ahFreeDS.push_back(hDSIO);
+    }
+    oPoolCV.notify_one();
+}
+
+/************************************************************************/
+/*                              GetBandIO()                             */
+/************************************************************************/
+
+GDALRasterBandH GDALVirtualMem::GetBandIO( GDALDatasetH hDSIO ) const
+{
+    if( hBand == nullptr )
+        return nullptr;
+    if( hDSIO == nullptr )
+        return hBand;
+    return GDALGetRasterBand(hDSIO, nSrcBand);
 }
 
 /************************************************************************/
@@ -282,7 +446,8 @@ size_t GDALVirtualMem::GetOffset(const coord_type& x,
 /************************************************************************/
 
 void GDALVirtualMem::DoIOPixelInterleaved(
-    GDALRWFlag eRWFlag, const size_t nOffset, void* pPage, size_t nBytes ) const
+    GDALRWFlag eRWFlag, GDALDatasetH hDSIO,
+    const size_t nOffset, void* pPage, size_t nBytes ) const
 {
     coord_type x = 0;
     coord_type y = 0;
@@ -336,7 +501,7 @@ void GDALVirtualMem::DoIOPixelInterleaved(
 
         // Finish reading/writing the remaining bands for that pixel
         CPL_IGNORE_RET_VAL(GDALDatasetRasterIO(
-            hDS, eRWFlag,
+            hDSIO, eRWFlag,
             nXOff + x, nYOff + y, 1, 1,
             static_cast<char *>(pPage) + nOffsetShift,
             1, 1, eBufType,
@@ -370,7 +535,7 @@ void GDALVirtualMem::DoIOPixelInterleaved(
         if( x < xEnd )
         {
             CPL_IGNORE_RET_VAL(GDALDatasetRasterIO(
-                hDS, eRWFlag,
+                hDSIO, eRWFlag,
                 nXOff + x, nYOff + y, xEnd - x, 1,
                 static_cast<char *>(pPage) + nOffsetShift,
                 xEnd - x, 1, eBufType,
@@ -393,7 +558,7 @@ void GDALVirtualMem::DoIOPixelInterleaved(
                 bandEnd = nBandCount;
 
             CPL_IGNORE_RET_VAL(GDALDatasetRasterIO(
-                hDS, eRWFlag,
+                hDSIO, eRWFlag,
                 nXOff + x, nYOff + y, 1, 1,
                 static_cast<char *>(pPage) + nOffsetShift,
                 1, 1, eBufType,
@@ -410,7 +575,7 @@ void GDALVirtualMem::DoIOPixelInterleaved(
     if( x > 0 || nBytes - nOffsetShift < static_cast<size_t>(nLineSpace) )
     {
         CPL_IGNORE_RET_VAL(GDALDatasetRasterIO(
-            hDS, eRWFlag,
+            hDSIO, eRWFlag,
             nXOff + x, nYOff + y, nBufXSize - x, 1,
             static_cast<char *>(pPage) + nOffsetShift,
             nBufXSize - x, 1, eBufType,
@@ -437,7 +602,7 @@ void GDALVirtualMem::DoIOPixelInterleaved(
     if( nLineCount > 0 )
     {
         CPL_IGNORE_RET_VAL(GDALDatasetRasterIO(
-            hDS, eRWFlag,
+            hDSIO, eRWFlag,
             nXOff + 0, nYOff + y, nBufXSize, nLineCount,
             static_cast<GByte *>(pPage) + nOffsetShift,
             nBufXSize, nLineCount, eBufType,
@@ -456,18 +621,19 @@ void GDALVirtualMem::DoIOPixelInterleaved(
     if( nOffsetShift < nBytes )
     {
         DoIOPixelInterleaved(
-            eRWFlag, nOffsetRecompute,
+            eRWFlag, hDSIO, nOffsetRecompute,
             static_cast<char*>(pPage) + nOffsetShift,
             nBytes - nOffsetShift );
     }
 }
 
 /************************************************************************/
-/*                          DoIOPixelInterleaved()                      */
+/*                          DoIOBandSequential()                        */
 /************************************************************************/
 
 void GDALVirtualMem::DoIOBandSequential(
-    GDALRWFlag eRWFlag, const size_t nOffset, void* pPage, size_t nBytes ) const
+    GDALRWFlag eRWFlag, GDALDatasetH hDSIO, GDALRasterBandH hBandIO,
+    const size_t nOffset, void* pPage, size_t nBytes ) const
 {
     coord_type x = 0;
     coord_type y = 0;
@@ -513,7 +679,7 @@ void GDALVirtualMem::DoIOBandSequential(
         CPLAssert(y == yEnd);
         CPLAssert(band == bandEnd);
         CPL_IGNORE_RET_VAL(GDALRasterIO(
-            hBand ? hBand : GDALGetRasterBand(hDS, panBandMap[band]),
+            hBandIO ? hBandIO : GDALGetRasterBand(hDSIO, panBandMap[band]),
             eRWFlag,
             nXOff + x, nYOff + y, xEnd - x, 1,
             static_cast<char *>(pPage) + nOffsetShift,
@@ -527,7 +693,7 @@ void GDALVirtualMem::DoIOBandSequential(
     if( x > 0 || nBytes - nOffsetShift < static_cast<size_t>(nLineSpace) )
     {
         CPL_IGNORE_RET_VAL(GDALRasterIO(
-            hBand ? hBand : GDALGetRasterBand(hDS, panBandMap[band]),
+            hBandIO ? hBandIO : GDALGetRasterBand(hDSIO, panBandMap[band]),
             eRWFlag,
                     nXOff + x, nYOff + y, nBufXSize - x, 1,
                     static_cast<char *>(pPage) + nOffsetShift,
@@ -551,7 +717,7 @@ void GDALVirtualMem::DoIOBandSequential(
     if( nLineCount > 0 )
     {
         CPL_IGNORE_RET_VAL(GDALRasterIO(
-            hBand ? hBand : GDALGetRasterBand(hDS, panBandMap[band]),
+            hBandIO ? hBandIO : GDALGetRasterBand(hDSIO, panBandMap[band]),
             eRWFlag,
             nXOff + 0, nYOff + y, nBufXSize, nLineCount,
             static_cast<GByte *>(pPage) + nOffsetShift,
@@ -573,7 +739,7 @@ void GDALVirtualMem::DoIOBandSequential(
 
     if( nOffsetShift < nBytes )
     {
-        DoIOBandSequential( eRWFlag, nOffsetRecompute,
+        DoIOBandSequential( eRWFlag, hDSIO, hBandIO, nOffsetRecompute,
                static_cast<char*>(pPage) + nOffsetShift, nBytes - nOffsetShift );
     }
 }
@@ -589,8 +755,11 @@ void GDALVirtualMem::FillCacheBandSequential(
     size_t nToFill,
     void* pUserData )
 {
-    const GDALVirtualMem* psParams = static_cast<GDALVirtualMem *>(pUserData);
-    psParams->DoIOBandSequential(GF_Read, nOffset, pPageToFill, nToFill);
+    GDALVirtualMem* psParams = static_cast<GDALVirtualMem *>(pUserData);
+    GDALDatasetH hDSIO = psParams->AcquireDataset();
+    psParams->DoIOBandSequential(GF_Read, hDSIO, psParams->GetBandIO(hDSIO),
+                                 nOffset, pPageToFill, nToFill);
+    psParams->ReleaseDataset(hDSIO);
 }
 
 /************************************************************************/
@@ -606,7 +775,8 @@ void GDALVirtualMem::SaveFromCacheBandSequential(
 {
     const GDALVirtualMem* psParams = static_cast<GDALVirtualMem *>(pUserData);
     psParams->DoIOBandSequential(
-        GF_Write, nOffset, const_cast<void *>(pPageToBeEvicted), nToEvicted);
+        GF_Write, psParams->hDS, psParams->hBand,
+        nOffset, const_cast<void *>(pPageToBeEvicted), nToEvicted);
 }
 
 /************************************************************************/
@@ -620,8 +790,11 @@ void GDALVirtualMem::FillCachePixelInterleaved(
     size_t nToFill,
     void* pUserData )
 {
-    const GDALVirtualMem* psParams = static_cast<GDALVirtualMem *>(pUserData);
-    psParams->DoIOPixelInterleaved(GF_Read, nOffset, pPageToFill, nToFill);
+    GDALVirtualMem* psParams = static_cast<GDALVirtualMem *>(pUserData);
+    GDALDatasetH hDSIO = psParams->AcquireDataset();
+    psParams->DoIOPixelInterleaved(GF_Read, hDSIO,
+                                   nOffset, pPageToFill, nToFill);
+    psParams->ReleaseDataset(hDSIO);
 }
 
 /************************************************************************/
@@ -637,7 +810,8 @@ void GDALVirtualMem::SaveFromCachePixelInterleaved(
 {
     const GDALVirtualMem* psParams = static_cast<GDALVirtualMem *>(pUserData);
     psParams->DoIOPixelInterleaved(
-        GF_Write, nOffset, const_cast<void *>(pPageToBeEvicted), nToEvicted);
+        GF_Write, psParams->hDS,
+        nOffset, const_cast<void *>(pPageToBeEvicted), nToEvicted);
 }
 
 /************************************************************************/
@@ -703,7 +877,7 @@ static CPLVirtualMem* GDALGetVirtualMem( GDALDatasetH hDS,
                                          size_t nCacheSize,
                                          size_t nPageSizeHint,
                                          int bSingleThreadUsage,
-                                         CSLConstList /*papszOptions*/ )
+                                         CSLConstList papszOptions )
 {
     CPLVirtualMem* view = nullptr;
     GDALVirtualMem* psParams = nullptr;
@@ -815,6 +989,43 @@ static CPLVirtualMem* GDALGetVirtualMem( GDALDatasetH hDS,
                                    nLineSpace,
                                    nBandSpace );
 
+    if( eRWFlag == GF_Read &&
+        CPLTestBool(CSLFetchNameValueDef(papszOptions, "USERFAULTFD",
+            CPLGetConfigOption("GDAL_VIRTUALMEM_USERFAULTFD", "NO"))) &&
+        CPLIsVirtualMemUserFaultAvailable() )
+    {
+        const char* pszThreads =
+            CSLFetchNameValueDef(papszOptions, "NUM_THREADS", "ALL_CPUS");
+        int nThreads = EQUAL(pszThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                        atoi(pszThreads);
+        nThreads = std::max(1, std::min(128, nThreads));
+        psParams->EnableMultiThreading(nThreads);
+
+        view = CPLVirtualMemUserFaultNew(
+            static_cast<size_t>(nReqMem),
+            nCacheSize,
+            nPageSizeHint,
+            nThreads,
+            bIsBandSequential ? GDALVirtualMem::FillCacheBandSequential :
+                                GDALVirtualMem::FillCachePixelInterleaved,
+            GDALVirtualMem::Destroy,
+            psParams );
+        if( view != nullptr )
+            return view;
+
+        CPLDebug("GDAL", "CPLVirtualMemUserFaultNew() failed. "
+                 "Falling back to CPLVirtualMemNew()");
+        delete psParams;
+        psParams = new GDALVirtualMem( hDS, hBand, nXOff, nYOff,
+                                       nXSize, nYSize,
+                                       nBufXSize, nBufYSize,
+                                       eBufType,
+                                       nBandCount, panBandMap,
+                                       nPixelSpace,
+                                       nLineSpace,
+                                       nBandSpace );
+    }
+
     view = CPLVirtualMemNew(
         static_cast<size_t>(nReqMem),
         nCacheSize,
@@ -948,7 +1159,21 @@ static CPLVirtualMem* GDALGetVirtualMem( GDALDatasetH hDS,
  *                           can optimize performance a bit. If set to FALSE,
  *                           CPLVirtualMemDeclareThread() must be called.
  *
- * @param papszOptions NULL terminated list of options. Unused for now.
+ * @param papszOptions NULL terminated list of options, or NULL.
+ * Starting with GDAL 3.4, the following options are supported when eRWFlag is
+ * GF_Read:
+ * <ul>
+ * <li>USERFAULTFD=YES/NO: whether to service page faults with userfaultfd
+ * (Linux only, see CPLIsVirtualMemUserFaultAvailable()), with several worker
+ * threads and read-ahead of the pages that follow the access direction.
+ * Defaults to the value of the GDAL_VIRTUALMEM_USERFAULTFD configuration
+ * option, or NO. When enabled, bSingleThreadUsage is ignored and
+ * CPLVirtualMemDeclareThread() does not need to be called. When possible, each
+ * worker thread uses its own handle, obtained by reopening the dataset in
+ * read-only mode. Otherwise accesses to the dataset are serialized.</li>
+ * <li>NUM_THREADS=number or ALL_CPUS: number of worker threads used with
+ * USERFAULTFD=YES. Defaults to ALL_CPUS.</li>
+ * </ul>
  *
  * @return a virtual memory object that must be freed by CPLVirtualMemFree(),
  *         or NULL in case of failure.
@@ -1075,7 +1300,9 @@ CPLVirtualMem* GDALDatasetGetVirtualMem( GDALDatasetH hDS,
  *                           can optimize performance a bit. If set to FALSE,
  *                           CPLVirtualMemDeclareThread() must be called.
  *
- * @param papszOptions NULL terminated list of options. Unused for now.
+ * @param papszOptions NULL terminated list of options, or NULL.
+ * Starting with GDAL 3.4, the USERFAULTFD and NUM_THREADS options documented
+ * in GDALDatasetGetVirtualMem() are supported.
  *
  * @return a virtual memory object that must be freed by CPLVirtualMemFree(),
  *         or NULL in case of failure.
@@ -48,6 +48,7 @@
 #include "cpl_progress.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
+#include "gdal_alg_priv.h"
 #include "gdal_thread_pool.h"
 #include "gdalwarper.h"
 
@@ -61,6 +62,83 @@
 
 CPL_CVSID("$Id$")
 
+/************************************************************************/
+/*                         NearCopyRegularStep()                        */
+/************************************************************************/
+
+// Copy nWidth source pixels spaced by nStep.
+// Used by the nearest resampling when the source pixels of a destination
+// line are regularly spaced.
+
+#ifdef USE_SSE2
+static inline int NearCopyStep2SSE2( const GByte* CPL_RESTRICT pSrc,
+                                     int nWidth,
+                                     GByte* CPL_RESTRICT pDst )
+{
+    const auto lowByteMask = _mm_set1_epi16(0xFF);
+    int iX = 0;
+    // Reads up to pSrc[2 * iX + 31], which must not go past the last
+    // source pixel pSrc[2 * (nWidth - 1)]
+    for( ; iX < nWidth - 16; iX += 16 )
+    {
+        const auto v0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pSrc + 2 * iX));
+        const auto v1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pSrc + 2 * iX + 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + iX),
+                         _mm_packus_epi16(_mm_and_si128(v0, lowByteMask),
+                                          _mm_and_si128(v1, lowByteMask)));
+    }
+    return iX;
+}
+
+static inline int NearCopyStep2SSE2( const GInt16* CPL_RESTRICT pSrc,
+                                     int nWidth,
+                                     GInt16* CPL_RESTRICT pDst )
+{
+    int iX = 0;
+    for( ; iX < nWidth - 8; iX += 8 )
+    {
+        const auto v0 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pSrc + 2 * iX));
+        const auto v1 = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pSrc + 2 * iX + 8));
+        // Sign extend the even 16 bit words to 32 bit so that the
+        // saturating pack keeps them unchanged.
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + iX),
+                         _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(v0, 16), 16),
+                                         _mm_srai_epi32(_mm_slli_epi32(v1, 16), 16)));
+    }
+    return iX;
+}
+
+static inline int NearCopyStep2SSE2( const float* CPL_RESTRICT pSrc,
+                                     int nWidth,
+                                     float* CPL_RESTRICT pDst )
+{
+    int iX = 0;
+    for( ; iX < nWidth - 4; iX += 4 )
+    {
+        const auto v0 = _mm_loadu_ps(pSrc + 2 * iX);
+        const auto v1 = _mm_loadu_ps(pSrc + 2 * iX + 4);
+        _mm_storeu_ps(pDst + iX,
+                      _mm_shuffle_ps(v0, v1, 0 | (2 << 2) | (0 << 4) | (2 << 6)));
+    }
+    return iX;
+}
+#endif
+
+template<class T> static inline void NearCopyRegularStep(
+                                    const T* CPL_RESTRICT pSrc,
+                                    int nStep,
+                                    int nWidth,
+                                    T* CPL_RESTRICT pDst )
+{
+    int iX = 0;
+#ifdef USE_SSE2
+    if( nStep == 2 )
+        iX = NearCopyStep2SSE2(pSrc, nWidth, pDst);
+#endif
+    for( ; iX < nWidth; ++iX )
+        pDst[iX] = pSrc[static_cast<GPtrDiff_t>(iX) * nStep];
+}
+
 /************************************************************************/
 /*                     GDALResampleChunk32R_Near()                      */
 /************************************************************************/
@@ -113,6 +191,18 @@ GDALResampleChunk32R_NearT( double dfXRatioDstToSrc,
         panSrcXOff[iDstPixel - nDstXOff] = nSrcXOff;
     }
 
+    // Whether the source pixels are spaced by a constant step, typically
+    // the case of integer decimation factors.
+    const int nSrcXStep =
+        nDstXWidth > 1 ? panSrcXOff[1] - panSrcXOff[0] : 1;
+    bool bRegularSrcXStep = nSrcXStep >= 1;
+    for( int iDstPixel = 2; bRegularSrcXStep && iDstPixel < nDstXWidth;
+         ++iDstPixel )
+    {
+        bRegularSrcXStep =
+            panSrcXOff[iDstPixel] - panSrcXOff[iDstPixel - 1] == nSrcXStep;
+    }
+
 /* ==================================================================== */
 /*      Loop over destination scanlines.                                */
 /* ==================================================================== */
@@ -129,6 +219,12 @@ GDALResampleChunk32R_NearT( double dfXRatioDstToSrc,
 /*      Loop over destination pixels                                    */
 /* -------------------------------------------------------------------- */
         T* pDstScanline = pDstBuffer + (iDstLine - nDstYOff) * nDstXWidth;
+        if( bRegularSrcXStep && nDstXWidth > 0 )
+        {
+            NearCopyRegularStep(pSrcScanline + panSrcXOff[0], nSrcXStep,
+                                nDstXWidth, pDstScanline);
+            continue;
+        }
         for( int iDstPixel = 0; iDstPixel < nDstXWidth; ++iDstPixel )
         {
             pDstScanline[iDstPixel] = pSrcScanline[panSrcXOff[iDstPixel]];
@@ -1120,6 +1216,70 @@ template<class T> static int AverageFloatSSE2(int nDstXWidth,
 
 #endif
 
+/************************************************************************/
+/*                        AccumulateColumns()                           */
+/************************************************************************/
+
+// Add nWidth values of a source line to the per-column sums.
+// Used by the integer decimation factor case of the average resampling.
+
+template<class T> static inline void AccumulateColumns(
+                                    int nWidth,
+                                    const T* CPL_RESTRICT pSrc,
+                                    GUInt32* CPL_RESTRICT panColSum )
+{
+    for( int iX = 0; iX < nWidth; ++iX )
+        panColSum[iX] += static_cast<GUInt32>(pSrc[iX]);
+}
+
+#ifdef USE_SSE2
+template<> inline void AccumulateColumns<GByte>(
+                                    int nWidth,
+                                    const GByte* CPL_RESTRICT pSrc,
+                                    GUInt32* CPL_RESTRICT panColSum )
+{
+    const auto zero = _mm_setzero_si128();
+    int iX = 0;
+    for( ; iX < nWidth - 15; iX += 16 )
+    {
+        const auto v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pSrc + iX));
+        const auto vLo = _mm_unpacklo_epi8(v, zero);
+        const auto vHi = _mm_unpackhi_epi8(v, zero);
+        __m128i* pSum = reinterpret_cast<__m128i*>(panColSum + iX);
+        _mm_storeu_si128(pSum, _mm_add_epi32(_mm_loadu_si128(pSum),
+                                             _mm_unpacklo_epi16(vLo, zero)));
+        _mm_storeu_si128(pSum + 1, _mm_add_epi32(_mm_loadu_si128(pSum + 1),
+                                                 _mm_unpackhi_epi16(vLo, zero)));
+        _mm_storeu_si128(pSum + 2, _mm_add_epi32(_mm_loadu_si128(pSum + 2),
+                                                 _mm_unpacklo_epi16(vHi, zero)));
+        _mm_storeu_si128(pSum + 3, _mm_add_epi32(_mm_loadu_si128(pSum + 3),
+                                                 _mm_unpackhi_epi16(vHi, zero)));
+    }
+    for( ; iX < nWidth; ++iX )
+        panColSum[iX] += pSrc[iX];
+}
+
+template<> inline void AccumulateColumns<GUInt16>(
+                                    int nWidth,
+                                    const GUInt16* CPL_RESTRICT pSrc,
+                                    GUInt32* CPL_RESTRICT panColSum )
+{
+    const auto zero = _mm_setzero_si128();
+    int iX = 0;
+    for( ; iX < nWidth - 7; iX += 8 )
+    {
+        const auto v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pSrc + iX));
+        __m128i* pSum = reinterpret_cast<__m128i*>(panColSum + iX);
+        _mm_storeu_si128(pSum, _mm_add_epi32(_mm_loadu_si128(pSum),
+                                             _mm_unpacklo_epi16(v, zero)));
+        _mm_storeu_si128(pSum + 1, _mm_add_epi32(_mm_loadu_si128(pSum + 1),
+                                                 _mm_unpackhi_epi16(v, zero)));
+    }
+    for( ; iX < nWidth; ++iX )
+        panColSum[iX] += pSrc[iX];
+}
+#endif
+
 /************************************************************************/
 /*                    GDALResampleChunk32R_Average()                    */
 /************************************************************************/
@@ -1215,6 +1375,13 @@ GDALResampleChunk32R_AverageT( double dfXRatioDstToSrc,
 /*      Precompute inner loop constants.                                */
 /* ==================================================================== */
     bool bSrcXSpacingIsTwo = true;
+    // Whether all destination pixels cover the same integer number of
+    // full source pixels, without overlap.
+    bool bSrcXSpacingIsInteger = true;
+    // Whether all source pixels have a unit weight horizontally.
+    bool bSrcXWeightsAreOne = true;
+    const int nSrcXSpacing = nDstXWidth > 0 ?
+        static_cast<int>(dfXRatioDstToSrc + 0.5) : 0;
     int nLastSrcXOff2 = -1;
     for( int iDstPixel = nDstXOff; iDstPixel < nDstXOff2; ++iDstPixel )
     {
@@ -1247,9 +1414,47 @@ GDALResampleChunk32R_AverageT( double dfXRatioDstToSrc,
         {
             bSrcXSpacingIsTwo = false;
         }
+        if( nSrcXOff2 - nSrcXOff != nSrcXSpacing ||
+            (nLastSrcXOff2 >= 0 && nLastSrcXOff2 != nSrcXOff) ||
+            fabs(pasSrcX[iDstPixel - nDstXOff].dfLeftWeight - 1.0) > 1e-8 ||
+            fabs(pasSrcX[iDstPixel - nDstXOff].dfRightWeight - 1.0) > 1e-8 )
+        {
+            bSrcXSpacingIsInteger = false;
+        }
+        if( pasSrcX[iDstPixel - nDstXOff].dfLeftWeight != 1.0 ||
+            (nSrcXOff + 1 < nSrcXOff2 &&
+             pasSrcX[iDstPixel - nDstXOff].dfRightWeight != 1.0) )
+        {
+            bSrcXWeightsAreOne = false;
+        }
         nLastSrcXOff2 = nSrcXOff2;
     }
 
+    // Column sums for the integer decimation factor case on integer data
+    // types. The sums are accumulated on 32 bit, so limit the number of
+    // source pixels per destination pixel to avoid overflows.
+    const int nSrcYSpacing = static_cast<int>(dfYRatioDstToSrc + 0.5);
+    const bool bIntegerFactors =
+        bSrcXSpacingIsInteger && !bQuadraticMean &&
+        (eWrkDataType == GDT_Byte || eWrkDataType == GDT_UInt16) &&
+        nSrcXSpacing >= 1 && nSrcYSpacing >= 1 &&
+        static_cast<GIntBig>(nSrcXSpacing) * nSrcYSpacing <= 65536;
+    std::vector<GUInt32> anColSum;
+    if( bIntegerFactors )
+    {
+        try
+        {
+            anColSum.resize(static_cast<size_t>(nDstXWidth) * nSrcXSpacing);
+        }
+        catch( const std::exception& )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate column sum buffer");
+            VSIFree(pasSrcX);
+            return CE_Failure;
+        }
+    }
+
 /* ==================================================================== */
 /*      Loop over destination scanlines.                                */
 /* ==================================================================== */
@@ -1399,6 +1604,45 @@ GDALResampleChunk32R_AverageT( double dfXRatioDstToSrc,
                 }
               }
             }
+            else if( bIntegerFactors &&
+                     nSrcYOff2 == nSrcYOff + nSrcYSpacing &&
+                     fabs(dfSrcYOff - nSrcYOff) < 1e-8 &&
+                     fabs(nSrcYOff2 - dfSrcYOff2) < 1e-8 &&
+                     pabyChunkNodataMask == nullptr )
+            {
+                // Optimized case: no nodata, integer decimation factors and
+                // regular x and y src spacing. Sum vertically the source
+                // lines into per column totals, and then sum horizontally.
+                const int nSrcWidth = nDstXWidth * nSrcXSpacing;
+                const T* pSrcScanlineShifted =
+                    pChunk + pasSrcX[0].nLeftXOffShifted +
+                    static_cast<GPtrDiff_t>(nSrcYOff - nChunkYOff) * nChunkXSize;
+                GUInt32* const panColSumData = anColSum.data();
+                std::fill(anColSum.begin(), anColSum.end(), 0);
+                for( int iY = 0; iY < nSrcYSpacing; ++iY )
+                {
+                    AccumulateColumns(nSrcWidth, pSrcScanlineShifted,
+                                      panColSumData);
+                    pSrcScanlineShifted += nChunkXSize;
+                }
+
+                const GUInt32 nTotalWeight =
+                    static_cast<GUInt32>(nSrcXSpacing) * nSrcYSpacing;
+                const GUInt32* panColSumIter = panColSumData;
+                for( int iDstPixel = 0; iDstPixel < nDstXWidth; ++iDstPixel )
+                {
+                    GUInt32 nTotal = 0;
+                    for( int iX = 0; iX < nSrcXSpacing; ++iX )
+                        nTotal += panColSumIter[iX];
+                    panColSumIter += nSrcXSpacing;
+                    T nVal = static_cast<T>(
+                        (static_cast<GUIntBig>(nTotal) + nTotalWeight / 2) /
+                            nTotalWeight);
+                    if( bHasNoData && nVal == tNoDataValue )
+                        nVal = tReplacementVal;
+                    pDstScanline[iDstPixel] = nVal;
+                }
+            }
             else
             {
                 const double dfBottomWeight =
@@ -1414,6 +1658,13 @@ GDALResampleChunk32R_AverageT( double dfXRatioDstToSrc,
                     dfTotalWeightFullColumn += dfTopWeight;
                 }
 
+                // All source pixels have a unit weight, typically the case
+                // of integer decimation factors. The masked case can then
+                // skip the weighting, with the same result.
+                const bool bWeightsAreOne =
+                    bSrcXWeightsAreOne && dfBottomWeight == 1.0 &&
+                    (nSrcYOff + 1 == nSrcYOff2 || dfTopWeight == 1.0);
+
                 for( int iDstPixel = 0; iDstPixel < nDstXWidth; ++iDstPixel )
                 {
                     const int nSrcXOff = pasSrcX[iDstPixel].nLeftXOffShifted;
@@ -1489,6 +1740,44 @@ GDALResampleChunk32R_AverageT( double dfXRatioDstToSrc,
 
                         dfTotalWeight = pasSrcX[iDstPixel].dfTotalWeightFullLine * dfTotalWeightFullColumn;
                     }
+                    else if( bWeightsAreOne )
+                    {
+                        GPtrDiff_t nCount = 0;
+                        for( int iY = nSrcYOff; iY < nSrcYOff2; ++iY )
+                        {
+                            const GPtrDiff_t nLineOff =
+                                static_cast<GPtrDiff_t>(iY) * nChunkXSize;
+                            const T* const pChunkShifted = pChunk + nLineOff;
+                            const GByte* const pabyMaskShifted =
+                                pabyChunkNodataMask + nLineOff;
+
+                            double dfTotalLine = 0;
+                            int nCountLine = 0;
+                            for( int iX = nSrcXOff; iX < nSrcXOff2; ++iX )
+                            {
+                                if( pabyMaskShifted[iX] )
+                                {
+                                    const T val = pChunkShifted[iX];
+                                    ++nCountLine;
+                                    if( bQuadraticMean )
+                                        dfTotalLine += SQUARE<double>(val);
+                                    else
+                                        dfTotalLine += val;
+                                }
+                            }
+                            nCount += nCountLine;
+                            dfTotal += dfTotalLine;
+                            dfTotalWeight += nCountLine;
+                        }
+
+                        if( nCount == 0 ||
+                            (bPropagateNoData && nCount <
+                                static_cast<GPtrDiff_t>(nSrcYOff2 - nSrcYOff) * (nSrcXOff2 - nSrcXOff)))
+                        {
+                            pDstScanline[iDstPixel] = tNoDataValue;
+                            continue;
+                        }
+                    }
                     else
                     {
                         GPtrDiff_t nCount = 0;
@@ -4201,12 +4490,13 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
     else
         nFullResYChunk = nFRYBlockSize;
 
-    // Only configurable for debug / testing
-    const char* pszChunkYSize = CPLGetConfigOption("GDAL_OVR_CHUNKYSIZE", nullptr);
-    if( pszChunkYSize )
+    // Configurable for debug / testing, or selected by GDALAutotune()
+    const CPLString osChunkYSize =
+        GDALGetTunedConfigOption("GDAL_OVR_CHUNKYSIZE", "");
+    if( !osChunkYSize.empty() )
     {
         // coverity[tainted_data]
-        nFullResYChunk = atoi(pszChunkYSize);
+        nFullResYChunk = atoi(osChunkYSize);
     }
 
     const GDALDataType eSrcDataType = poSrcBand->GetRasterDataType();
@@ -4676,6 +4966,305 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
     return eErr;
 }
 
+/************************************************************************/
+/*              GDALRegenerateOverviewsMultiBandOnePass()               */
+/************************************************************************/
+
+namespace {
+// Structure describing the resampling of a source chunk of one band to
+// all the overview levels computed in one pass.
+struct OnePassJob
+{
+    // Input parameters
+    GDALResampleFunction pfnResampleFn = nullptr;
+    const char * pszResampling = nullptr;
+    GDALDataType eSrcDataType = GDT_Unknown;
+    GDALDataType eWrkDataType = GDT_Unknown;
+    int bHasNoData = 0;
+    float fNoDataValue = 0.0f;
+    bool bPropagateNoData = false;
+    int nOverviews = 0;
+    GDALRasterBand** papoOverviewBands = nullptr;
+    const int* panFactors = nullptr;
+    int nChunkXOff = 0;
+    int nChunkXSize = 0;
+    int nChunkYOff = 0;
+    int nChunkYSize = 0;
+    std::unique_ptr<PointerHolder> oSrcBufferHolder{};
+
+    // Output values: one buffer per overview level
+    CPLErr eErr = CE_None;
+    std::vector<std::unique_ptr<PointerHolder>> aoDstBufferHolders{};
+    std::vector<GDALDataType> aeDstBufferDataTypes{};
+};
+}
+
+static void GDALOnePassResampleFunc(void* pData)
+{
+    OnePassJob* poJob = static_cast<OnePassJob*>(pData);
+
+    std::unique_ptr<PointerHolder> oTmpSrcBufferHolder;
+    const void* pSrcBuffer = poJob->oSrcBufferHolder->ptr;
+    int nChunkXOff = poJob->nChunkXOff;
+    int nChunkXSize = poJob->nChunkXSize;
+    int nChunkYOff = poJob->nChunkYOff;
+    int nChunkYSize = poJob->nChunkYSize;
+    for( int iOverview = 0; iOverview < poJob->nOverviews; ++iOverview )
+    {
+        // Chunks are aligned on the factor of all levels, so the boundaries
+        // of the destination window are exact.
+        const int nFactor = poJob->panFactors[iOverview];
+        const int nDstXOff = nChunkXOff / nFactor;
+        const int nDstXSize = nChunkXSize / nFactor;
+        const int nDstYOff = nChunkYOff / nFactor;
+        const int nDstYSize = nChunkYSize / nFactor;
+
+        void* pDstBuffer = nullptr;
+        GDALDataType eDstBufferDataType = GDT_Unknown;
+        poJob->eErr = poJob->pfnResampleFn(
+            nFactor, nFactor,
+            0.0, 0.0,
+            poJob->eWrkDataType,
+            pSrcBuffer,
+            nullptr,
+            nChunkXOff, nChunkXSize,
+            nChunkYOff, nChunkYSize,
+            nDstXOff, nDstXOff + nDstXSize,
+            nDstYOff, nDstYOff + nDstYSize,
+            poJob->papoOverviewBands[iOverview],
+            &pDstBuffer,
+            &eDstBufferDataType,
+            poJob->pszResampling,
+            poJob->bHasNoData,
+            poJob->fNoDataValue,
+            nullptr,
+            poJob->eSrcDataType,
+            poJob->bPropagateNoData);
+        poJob->aoDstBufferHolders.emplace_back(new PointerHolder(pDstBuffer));
+        poJob->aeDstBufferDataTypes.push_back(eDstBufferDataType);
+        if( poJob->eErr != CE_None )
+            return;
+
+        if( iOverview + 1 < poJob->nOverviews )
+        {
+            // The next level is computed from this one as if it had been
+            // read back from the overview band, so values must go through
+            // the data type of the band.
+            if( eDstBufferDataType == poJob->eWrkDataType &&
+                poJob->eWrkDataType == poJob->eSrcDataType )
+            {
+                pSrcBuffer = pDstBuffer;
+            }
+            else
+            {
+                const size_t nPixels =
+                    static_cast<size_t>(nDstXSize) * nDstYSize;
+                void* pNewSrcBuffer = VSI_MALLOC2_VERBOSE(
+                    nPixels, GDALGetDataTypeSizeBytes(poJob->eWrkDataType));
+                if( pNewSrcBuffer == nullptr )
+                {
+                    poJob->eErr = CE_Failure;
+                    return;
+                }
+                if( eDstBufferDataType == poJob->eSrcDataType ||
+                    poJob->eWrkDataType == poJob->eSrcDataType )
+                {
+                    GDALCopyWords64(pDstBuffer, eDstBufferDataType,
+                        GDALGetDataTypeSizeBytes(eDstBufferDataType),
+                        pNewSrcBuffer, poJob->eWrkDataType,
+                        GDALGetDataTypeSizeBytes(poJob->eWrkDataType),
+                        nPixels);
+                }
+                else
+                {
+                    std::vector<GByte> abyTmp;
+                    try
+                    {
+                        abyTmp.resize(nPixels *
+                            GDALGetDataTypeSizeBytes(poJob->eSrcDataType));
+                    }
+                    catch( const std::exception& )
+                    {
+                        CPLError(CE_Failure, CPLE_OutOfMemory,
+                                 "Out of memory in one pass overview "
+                                 "computation");
+                        CPLFree(pNewSrcBuffer);
+                        poJob->eErr = CE_Failure;
+                        return;
+                    }
+                    GDALCopyWords64(pDstBuffer, eDstBufferDataType,
+                        GDALGetDataTypeSizeBytes(eDstBufferDataType),
+                        abyTmp.data(), poJob->eSrcDataType,
+                        GDALGetDataTypeSizeBytes(poJob->eSrcDataType),
+                        nPixels);
+                    GDALCopyWords64(abyTmp.data(), poJob->eSrcDataType,
+                        GDALGetDataTypeSizeBytes(poJob->eSrcDataType),
+                        pNewSrcBuffer, poJob->eWrkDataType,
+                        GDALGetDataTypeSizeBytes(poJob->eWrkDataType),
+                        nPixels);
+                }
+                oTmpSrcBufferHolder.reset(new PointerHolder(pNewSrcBuffer));
+                pSrcBuffer = pNewSrcBuffer;
+            }
+        }
+
+        nChunkXOff = nDstXOff;
+        nChunkXSize = nDstXSize;
+        nChunkYOff = nDstYOff;
+        nChunkYSize = nDstYSize;
+    }
+}
+
+// Computes the first nOverviews levels in a single pass over the source
+// bands: each source chunk is read once and downsampled in memory to all
+// those levels, each level being computed from the previous one, as the
+// level by level algorithm of GDALRegenerateOverviewsMultiBand() does from
+// the written overviews. This is only used for resampling methods without
+// kernel nor mask, when each level is an exact integral reduction of the
+// previous one, so that the chunks of all levels are aligned and the result
+// is identical.
+static CPLErr
+GDALRegenerateOverviewsMultiBandOnePass( int nBands,
+                                         GDALRasterBand** papoSrcBands,
+                                         int nOverviews,
+                                         GDALRasterBand*** papapoOverviewBands,
+                                         const int* panFactors,
+                                         int nSrcChunkXSize,
+                                         int nSrcChunkYSize,
+                                         const char * pszResampling,
+                                         GDALResampleFunction pfnResampleFn,
+                                         GDALDataType eDataType,
+                                         GDALDataType eWrkDataType,
+                                         const int* pabHasNoData,
+                                         const float* pafNoDataValue,
+                                         bool bPropagateNoData,
+                                         CPLJobQueue* poJobQueue,
+                                         GDALProgressFunc pfnProgress,
+                                         void * pProgressData,
+                                         double dfTotalPixelCount,
+                                         double& dfCurPixelCount )
+{
+    const int nSrcWidth = papoSrcBands[0]->GetXSize();
+    const int nSrcHeight = papoSrcBands[0]->GetYSize();
+
+    // Number of pixels processed at all levels per source pixel, for the
+    // progress report.
+    double dfPixelsPerSrcPixel = 0;
+    double dfCurFactor = 1;
+    for( int iOverview = 0; iOverview < nOverviews; ++iOverview )
+    {
+        dfPixelsPerSrcPixel += 1.0 / (dfCurFactor * dfCurFactor);
+        dfCurFactor *= panFactors[iOverview];
+    }
+
+    CPLErr eErr = CE_None;
+    for( int nChunkYOff = 0;
+         nChunkYOff < nSrcHeight && eErr == CE_None;
+         nChunkYOff += nSrcChunkYSize )
+    {
+        const int nChunkYSize =
+            std::min(nSrcChunkYSize, nSrcHeight - nChunkYOff);
+
+        if( !pfnProgress( dfCurPixelCount / dfTotalPixelCount,
+                          nullptr, pProgressData ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+
+        for( int nChunkXOff = 0;
+             nChunkXOff < nSrcWidth && eErr == CE_None;
+             nChunkXOff += nSrcChunkXSize )
+        {
+            const int nChunkXSize =
+                std::min(nSrcChunkXSize, nSrcWidth - nChunkXOff);
+
+            // Read the source chunk of all bands, and resample them
+            // concurrently if possible.
+            std::vector<std::unique_ptr<OnePassJob>> apoJobs;
+            for( int iBand = 0; iBand < nBands && eErr == CE_None; ++iBand )
+            {
+                void* pChunk = VSI_MALLOC3_VERBOSE(
+                    nChunkXSize, nChunkYSize,
+                    GDALGetDataTypeSizeBytes(eWrkDataType) );
+                if( pChunk == nullptr )
+                {
+                    eErr = CE_Failure;
+                    break;
+                }
+                std::unique_ptr<OnePassJob> poJob(new OnePassJob());
+                poJob->oSrcBufferHolder.reset(new PointerHolder(pChunk));
+                eErr = papoSrcBands[iBand]->RasterIO(
+                    GF_Read,
+                    nChunkXOff, nChunkYOff, nChunkXSize, nChunkYSize,
+                    pChunk, nChunkXSize, nChunkYSize,
+                    eWrkDataType, 0, 0, nullptr );
+                if( eErr != CE_None )
+                    break;
+
+                poJob->pfnResampleFn = pfnResampleFn;
+                poJob->pszResampling = pszResampling;
+                poJob->eSrcDataType = eDataType;
+                poJob->eWrkDataType = eWrkDataType;
+                poJob->bHasNoData = pabHasNoData[iBand];
+                poJob->fNoDataValue = pafNoDataValue[iBand];
+                poJob->bPropagateNoData = bPropagateNoData;
+                poJob->nOverviews = nOverviews;
+                poJob->papoOverviewBands = papapoOverviewBands[iBand];
+                poJob->panFactors = panFactors;
+                poJob->nChunkXOff = nChunkXOff;
+                poJob->nChunkXSize = nChunkXSize;
+                poJob->nChunkYOff = nChunkYOff;
+                poJob->nChunkYSize = nChunkYSize;
+
+                if( poJobQueue )
+                    poJobQueue->SubmitJob(GDALOnePassResampleFunc, poJob.get());
+                else
+                    GDALOnePassResampleFunc(poJob.get());
+                apoJobs.emplace_back(std::move(poJob));
+            }
+            if( poJobQueue )
+                poJobQueue->WaitCompletion();
+
+            // Write the result to the overview bands.
+            for( size_t iJob = 0; iJob < apoJobs.size() && eErr == CE_None;
+                 ++iJob )
+            {
+                const OnePassJob* poJob = apoJobs[iJob].get();
+                eErr = poJob->eErr;
+                int nFactor = 1;
+                for( int iOverview = 0;
+                     iOverview < nOverviews && eErr == CE_None;
+                     ++iOverview )
+                {
+                    nFactor *= panFactors[iOverview];
+                    const int nDstXSize = nChunkXSize / nFactor;
+                    const int nDstYSize = nChunkYSize / nFactor;
+                    eErr = poJob->papoOverviewBands[iOverview]->RasterIO(
+                        GF_Write,
+                        nChunkXOff / nFactor, nChunkYOff / nFactor,
+                        nDstXSize, nDstYSize,
+                        poJob->aoDstBufferHolders[iOverview]->ptr,
+                        nDstXSize, nDstYSize,
+                        poJob->aeDstBufferDataTypes[iOverview],
+                        0, 0, nullptr );
+                }
+            }
+        }
+
+        dfCurPixelCount +=
+            static_cast<double>(nChunkYSize) * nSrcWidth * dfPixelsPerSrcPixel;
+    }
+
+    for( int iBand = 0; iBand < nBands; ++iBand )
+    {
+        for( int iOverview = 0; iOverview < nOverviews; ++iOverview )
+            papapoOverviewBands[iBand][iOverview]->FlushCache();
+    }
+
+    return eErr;
+}
+
 /************************************************************************/
 /*            GDALRegenerateOverviewsMultiBand()                        */
 /************************************************************************/
@@ -4714,6 +5303,22 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
  * to "ALL_CPUS" or a integer value to specify the number of threads to use for
  * overview computation.
  *
+ * Starting with GDAL 3.4, when the GDAL_OVR_ONE_PASS configuration option is
+ * set to YES, with the NEAREST, AVERAGE and RMS methods and bands without
+ * mask, the successive levels that are exact integral reductions of the
+ * previous one (e.g. 2, 4, 8, 16 on a raster whose dimensions are multiple of
+ * 16) are computed together: each chunk of the source bands is read once
+ * and downsampled in memory to all those levels. The memory used for a chunk
+ * is bounded by the GDAL_OVR_ONE_PASS_MAX_MEM configuration option (in MB),
+ * which defaults to a quarter of the block cache size.
+ *
+ * Starting with GDAL 3.4, chunks of read-only source bands for which
+ * GDALGetDataCoverageStatus() reports only holes (for example missing tiles
+ * of a sparse GeoTIFF file) are not processed, when the overview bands are
+ * empty and have the same nodata value as the source bands. This can be
+ * disabled by setting the GDAL_OVR_SKIP_EMPTY_CHUNKS configuration option to
+ * NO.
+ *
  * @param nBands the number of bands, size of papoSrcBands and size of
  *               first dimension of papapoOverviewBands
  * @param papoSrcBands the list of source bands to downsample
@@ -4881,10 +5486,93 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
     const int nChunkMaxSize =
         atoi(CPLGetConfigOption("GDAL_OVR_CHUNK_MAX_SIZE", "10485760"));
 
+    // In one pass mode, the first levels that are exact integral reductions
+    // of the previous one are computed together from chunks of the source
+    // bands, so that the source bands are read only once.
+    std::vector<int> anOnePassFactors;
+    int nOnePassChunkXSize = 0;
+    int nOnePassChunkYSize = 0;
+    if( CPLTestBool(CPLGetConfigOption("GDAL_OVR_ONE_PASS", "NO")) &&
+        nKernelRadius == 0 && !bUseNoDataMask &&
+        (STARTS_WITH_CI(pszResampling, "NEAR") ||
+         EQUAL(pszResampling, "AVERAGE") ||
+         EQUAL(pszResampling, "RMS")) &&
+        !GDALDataTypeIsComplex(eDataType) )
+    {
+        const char* pszMaxMem =
+            CPLGetConfigOption("GDAL_OVR_ONE_PASS_MAX_MEM", nullptr);
+        const double dfMaxMem = pszMaxMem ?
+            CPLAtof(pszMaxMem) * 1024 * 1024 :
+            static_cast<double>(GDALGetCacheMax64() / 4);
+        int nPrevWidth = nToplevelSrcWidth;
+        int nPrevHeight = nToplevelSrcHeight;
+        int nFullFactor = 1;
+        for( int iOverview = 0; iOverview < nOverviews; ++iOverview )
+        {
+            const int nDstWidth = papapoOverviewBands[0][iOverview]->GetXSize();
+            const int nDstHeight =
+                papapoOverviewBands[0][iOverview]->GetYSize();
+            if( nDstWidth == 0 || nDstHeight == 0 ||
+                (nPrevWidth % nDstWidth) != 0 ||
+                (nPrevHeight % nDstHeight) != 0 ||
+                nPrevWidth / nDstWidth != nPrevHeight / nDstHeight ||
+                nPrevWidth / nDstWidth < 2 )
+            {
+                break;
+            }
+            const int nFactor = nPrevWidth / nDstWidth;
+
+            // The chunk size is chosen so that it matches a block of the
+            // smallest level, and blocks of the larger levels.
+            int nBlockXSize = 0;
+            int nBlockYSize = 0;
+            papapoOverviewBands[0][iOverview]->GetBlockSize(&nBlockXSize,
+                                                            &nBlockYSize);
+            const double dfChunkXSize = std::min(
+                static_cast<double>(nBlockXSize) * nFullFactor * nFactor,
+                static_cast<double>(nToplevelSrcWidth));
+            const double dfChunkYSize = std::min(
+                static_cast<double>(nBlockYSize) * nFullFactor * nFactor,
+                static_cast<double>(nToplevelSrcHeight));
+            if( dfChunkXSize * dfChunkYSize * nBands *
+                    GDALGetDataTypeSizeBytes(eWrkDataType) > dfMaxMem )
+            {
+                break;
+            }
+
+            nFullFactor *= nFactor;
+            anOnePassFactors.push_back(nFactor);
+            nOnePassChunkXSize = static_cast<int>(dfChunkXSize);
+            nOnePassChunkYSize = static_cast<int>(dfChunkYSize);
+            nPrevWidth = nDstWidth;
+            nPrevHeight = nDstHeight;
+        }
+        if( anOnePassFactors.size() < 2 )
+            anOnePassFactors.clear();
+    }
+
     // Second pass to do the real job.
     double dfCurPixelCount = 0;
     CPLErr eErr = CE_None;
-    for( int iOverview = 0;
+    if( !anOnePassFactors.empty() )
+    {
+        CPLDebug("GDAL", "Computing %d overview levels in one pass "
+                 "with %dx%d chunks",
+                 static_cast<int>(anOnePassFactors.size()),
+                 nOnePassChunkXSize, nOnePassChunkYSize);
+        eErr = GDALRegenerateOverviewsMultiBandOnePass(
+            nBands, papoSrcBands,
+            static_cast<int>(anOnePassFactors.size()), papapoOverviewBands,
+            anOnePassFactors.data(),
+            nOnePassChunkXSize, nOnePassChunkYSize,
+            pszResampling, pfnResampleFn,
+            eDataType, eWrkDataType,
+            pabHasNoData, pafNoDataValue, bPropagateNoData,
+            poJobQueue.get(),
+            pfnProgress, pProgressData,
+            dfTotalPixelCount, dfCurPixelCount);
+    }
+    for( int iOverview = static_cast<int>(anOnePassFactors.size());
          iOverview < nOverviews && eErr == CE_None;
          ++iOverview )
     {
@@ -5074,6 +5762,33 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
         std::vector<void*> apaChunk(nBands);
         std::vector<GByte*> apabyChunkNoDataMask(nBands);
 
+        // Chunks whose source is only made of holes (e.g. missing tiles of a
+        // sparse GeoTIFF file) can be skipped if the overview is still empty
+        // and reads holes with the same value as the source.
+        // Querying a band opened in update mode might flush it, so this is
+        // only done for read-only sources.
+        bool bSkipEmptyChunks = !bIsMask && CPLTestBool(
+            CPLGetConfigOption("GDAL_OVR_SKIP_EMPTY_CHUNKS", "YES"));
+        for( int iBand = 0; iBand < nBands && bSkipEmptyChunks; ++iBand )
+        {
+            GDALRasterBand* poSrcBand = iSrcOverview == -1 ?
+                papoSrcBands[iBand] : papapoOverviewBands[iBand][iSrcOverview];
+            GDALRasterBand* poDstBand = papapoOverviewBands[iBand][iOverview];
+            int bSrcHasNoData = FALSE;
+            const double dfSrcNoData = poSrcBand->GetNoDataValue(&bSrcHasNoData);
+            int bDstHasNoData = FALSE;
+            const double dfDstNoData = poDstBand->GetNoDataValue(&bDstHasNoData);
+            bSkipEmptyChunks =
+                poSrcBand->GetAccess() == GA_ReadOnly &&
+                bSrcHasNoData == bDstHasNoData &&
+                (!bSrcHasNoData || dfSrcNoData == dfDstNoData ||
+                 (std::isnan(dfSrcNoData) && std::isnan(dfDstNoData))) &&
+                poDstBand->GetDataCoverageStatus(
+                    0, 0, nDstWidth, nDstHeight,
+                    GDAL_DATA_COVERAGE_STATUS_DATA, nullptr) ==
+                        GDAL_DATA_COVERAGE_STATUS_EMPTY;
+        }
+
         int nDstYOff = 0;
         // Iterate on destination overview, block by block.
         for( nDstYOff = 0;
@@ -5156,6 +5871,24 @@ GDALRegenerateOverviewsMultiBand( int nBands, GDALRasterBand** papoSrcBands,
                     nDstXOff, nDstYOff, nDstXCount, nDstYCount );
 #endif
 
+                if( bSkipEmptyChunks )
+                {
+                    bool bEmpty = true;
+                    for( int iBand = 0; iBand < nBands && bEmpty; ++iBand )
+                    {
+                        GDALRasterBand* poSrcBand = iSrcOverview == -1 ?
+                            papoSrcBands[iBand] :
+                            papapoOverviewBands[iBand][iSrcOverview];
+                        bEmpty = poSrcBand->GetDataCoverageStatus(
+                            nChunkXOffQueried, nChunkYOffQueried,
+                            nChunkXSizeQueried, nChunkYSizeQueried,
+                            GDAL_DATA_COVERAGE_STATUS_DATA, nullptr) ==
+                                GDAL_DATA_COVERAGE_STATUS_EMPTY;
+                    }
+                    if( bEmpty )
+                        continue;
+                }
+
                 // Avoid accumulating too many tasks and exhaust RAM
 
                 // Try to complete already finished jobs
@@ -40,17 +40,23 @@
 #include <cstring>
 
 #include <algorithm>
+#include <condition_variable>
 #include <limits>
+#include <mutex>
+#include <new>
 #include <stdexcept>
 #include <type_traits>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_cpu_features.h"
 #include "cpl_error.h"
+#include "cpl_error_internal.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 #include "gdal_priv_templates.hpp"
+#include "gdal_thread_pool.h"
 #include "gdal_vrt.h"
 #include "gdalwarper.h"
 #include "memdataset.h"
@@ -240,6 +246,64 @@ CPLErr GDALRasterBand::IRasterIO( GDALRWFlag eRWFlag,
              nXSize == psExtraArg->dfXSize &&
              nYSize == psExtraArg->dfYSize));
 
+/* ==================================================================== */
+/*      If the request covers whole blocks of one block column, with    */
+/*      the band data type and a packed buffer whose line stride is     */
+/*      the block width, and GDAL_RASTERIO_DIRECT_READ=YES, read the    */
+/*      blocks directly into the user buffer without going through      */
+/*      the block cache. Blocks already in cache are copied from there  */
+/*      since they may hold modified data.                              */
+/* ==================================================================== */
+    if( eRWFlag == GF_Read
+        && eBufType == eDataType
+        && nPixelSpace == nBandDataSize
+        && nLineSpace == nPixelSpace * nBlockXSize
+        && nXSize == nBlockXSize
+        && nBufXSize == nXSize
+        && nBufYSize == nYSize
+        && bUseIntegerRequestCoords
+        && (nXOff % nBlockXSize) == 0
+        && (nYOff % nBlockYSize) == 0
+        && (nYSize % nBlockYSize) == 0
+        && nXOff + nXSize <= nRasterXSize
+        && nYOff + nYSize <= nRasterYSize
+        && CPLTestBool(CPLGetConfigOption("GDAL_RASTERIO_DIRECT_READ", "NO")) )
+    {
+        if( !InitBlockInfo() )
+            return CE_Failure;
+
+        const int nXBlockOff = nXOff / nBlockXSize;
+        const size_t nBlockBytes = static_cast<size_t>(nBandDataSize) *
+                                   nBlockXSize * nBlockYSize;
+        for( int iBufYOff = 0; iBufYOff < nBufYSize; iBufYOff += nBlockYSize )
+        {
+            const int nYBlockOff = (nYOff + iBufYOff) / nBlockYSize;
+            GByte* pabyDstBlock = static_cast<GByte *>(pData) +
+                static_cast<GPtrDiff_t>(iBufYOff) * nLineSpace;
+
+            poBlock = TryGetLockedBlockRef( nXBlockOff, nYBlockOff );
+            if( poBlock != nullptr )
+            {
+                memcpy( pabyDstBlock, poBlock->GetDataRef(), nBlockBytes );
+                poBlock->DropLock();
+                poBlock = nullptr;
+                continue;
+            }
+
+            if( IReadBlock( nXBlockOff, nYBlockOff, pabyDstBlock ) != CE_None )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "IReadBlock failed at X offset %d, Y offset %d%s",
+                          nXBlockOff, nYBlockOff,
+                          CPLGetLastErrorMsg()[0] ?
+                              CPLSPrintf(": %s", CPLGetLastErrorMsg()) : "" );
+                return CE_Failure;
+            }
+        }
+
+        return CE_None;
+    }
+
 /* ==================================================================== */
 /*      A common case is the data requested with the destination        */
 /*      is packed, and the block width is the raster width.             */
@@ -2035,6 +2099,52 @@ CPLErr GDALDataset::RasterIOResampled(
 }
 //! @endcond
 
+/************************************************************************/
+/*                        GDALSwapPackedWords()                         */
+/************************************************************************/
+
+#if defined(__x86_64) || defined(_M_X64)
+
+#include <emmintrin.h>
+
+// Byte swap the first words of a packed array with SSE2, 16 bytes at a time.
+// Returns the number of words swapped, the caller handles the remaining ones.
+template<int WORD_SIZE> static int GDALSwapPackedWords( GByte* pabyData,
+                                                        int nWordCount )
+{
+    constexpr int WORDS_PER_VECTOR = 16 / WORD_SIZE;
+    int i = 0;
+    for( ; i + WORDS_PER_VECTOR <= nWordCount; i += WORDS_PER_VECTOR )
+    {
+        __m128i* pVector = reinterpret_cast<__m128i*>(pabyData + i * WORD_SIZE);
+        __m128i v = _mm_loadu_si128(pVector);
+        // Reorder the 16-bit halves of the words, then swap the bytes of
+        // each 16-bit half.
+        if( WORD_SIZE == 4 )
+        {
+            v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+            v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        }
+        else if( WORD_SIZE == 8 )
+        {
+            v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+            v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        }
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128(pVector, v);
+    }
+    return i;
+}
+
+#else
+
+template<int WORD_SIZE> static int GDALSwapPackedWords( GByte*, int )
+{
+    return 0;
+}
+
+#endif
+
 /************************************************************************/
 /*                           GDALSwapWords()                            */
 /************************************************************************/
@@ -2072,6 +2182,12 @@ void CPL_STDCALL GDALSwapWords( void *pData, int nWordSize, int nWordCount,
 
       case 2:
         CPLAssert( nWordSkip >= 2 || nWordCount == 1 );
+        if( nWordSkip == 2 )
+        {
+            const int nSwapped = GDALSwapPackedWords<2>(pabyData, nWordCount);
+            pabyData += 2 * nSwapped;
+            nWordCount -= nSwapped;
+        }
         for( int i = 0; i < nWordCount; i++ )
         {
             CPL_SWAP16PTR(pabyData);
@@ -2081,6 +2197,12 @@ void CPL_STDCALL GDALSwapWords( void *pData, int nWordSize, int nWordCount,
 
       case 4:
         CPLAssert( nWordSkip >= 4 || nWordCount == 1 );
+        if( nWordSkip == 4 )
+        {
+            const int nSwapped = GDALSwapPackedWords<4>(pabyData, nWordCount);
+            pabyData += 4 * nSwapped;
+            nWordCount -= nSwapped;
+        }
         if( CPL_IS_ALIGNED(pabyData, 4) && (nWordSkip % 4) == 0 )
         {
             for( int i = 0; i < nWordCount; i++ )
@@ -2101,6 +2223,12 @@ void CPL_STDCALL GDALSwapWords( void *pData, int nWordSize, int nWordCount,
 
       case 8:
         CPLAssert( nWordSkip >= 8 || nWordCount == 1 );
+        if( nWordSkip == 8 )
+        {
+            const int nSwapped = GDALSwapPackedWords<8>(pabyData, nWordCount);
+            pabyData += 8 * nSwapped;
+            nWordCount -= nSwapped;
+        }
 #ifdef CPL_HAS_GINT64
         if( CPL_IS_ALIGNED(pabyData, 8) && (nWordSkip % 8) == 0 )
         {
@@ -2684,6 +2812,247 @@ template<> void GDALCopyWordsT( const double* const CPL_RESTRICT pSrcData,
     GDALCopyWordsT_8atatime( pSrcData, nSrcPixelStride,
                              pDstData, nDstPixelStride, nWordCount );
 }
+template<> void GDALCopyWordsT( const GInt16* const CPL_RESTRICT pSrcData,
+                                int nSrcPixelStride,
+                                GByte* const CPL_RESTRICT pDstData,
+                                int nDstPixelStride,
+                                GPtrDiff_t nWordCount )
+{
+    if( nSrcPixelStride == static_cast<int>(sizeof(*pSrcData)) &&
+        nDstPixelStride == static_cast<int>(sizeof(*pDstData)) )
+    {
+        decltype(nWordCount) n = 0;
+        // packus_epi16 saturates signed 16 bit values to [0,255], which is
+        // the clamping done by GDALCopyWord()
+        for (; n < nWordCount-15; n+=16)
+        {
+            __m128i xmm0 = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*> (pSrcData + n) );
+            __m128i xmm1 = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*> (pSrcData + n + 8) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>(pDstData + n),
+                              _mm_packus_epi16(xmm0, xmm1) );
+        }
+        for( ; n < nWordCount; n++  )
+        {
+            GDALCopyWord(pSrcData[n], pDstData[n]);
+        }
+    }
+    else
+    {
+        GDALCopyWordsGenericT(pSrcData, nSrcPixelStride,
+                              pDstData, nDstPixelStride,
+                              nWordCount);
+    }
+}
+
+template<> void GDALCopyWordsT( const GInt16* const CPL_RESTRICT pSrcData,
+                                int nSrcPixelStride,
+                                GUInt16* const CPL_RESTRICT pDstData,
+                                int nDstPixelStride,
+                                GPtrDiff_t nWordCount )
+{
+    if( nSrcPixelStride == static_cast<int>(sizeof(*pSrcData)) &&
+        nDstPixelStride == static_cast<int>(sizeof(*pDstData)) )
+    {
+        decltype(nWordCount) n = 0;
+        const __m128i xmm_zero = _mm_setzero_si128 ();
+        for (; n < nWordCount-7; n+=8)
+        {
+            __m128i xmm = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*> (pSrcData + n) );
+            // Clamp negative values to 0
+            xmm = _mm_max_epi16(xmm, xmm_zero);
+            _mm_storeu_si128( reinterpret_cast<__m128i*>(pDstData + n), xmm );
+        }
+        for( ; n < nWordCount; n++  )
+        {
+            GDALCopyWord(pSrcData[n], pDstData[n]);
+        }
+    }
+    else
+    {
+        GDALCopyWordsGenericT(pSrcData, nSrcPixelStride,
+                              pDstData, nDstPixelStride,
+                              nWordCount);
+    }
+}
+
+template<> void GDALCopyWordsT( const GInt16* const CPL_RESTRICT pSrcData,
+                                int nSrcPixelStride,
+                                GInt32* const CPL_RESTRICT pDstData,
+                                int nDstPixelStride,
+                                GPtrDiff_t nWordCount )
+{
+    if( nSrcPixelStride == static_cast<int>(sizeof(*pSrcData)) &&
+        nDstPixelStride == static_cast<int>(sizeof(*pDstData)) )
+    {
+        decltype(nWordCount) n = 0;
+        for (; n < nWordCount-7; n+=8)
+        {
+            __m128i xmm = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*> (pSrcData + n) );
+            // Sign extension: put each value in the high 16 bits of a
+            // 32 bit word, and do an arithmetic shift right.
+            __m128i xmm0 = _mm_srai_epi32(_mm_unpacklo_epi16(xmm, xmm), 16);
+            __m128i xmm1 = _mm_srai_epi32(_mm_unpackhi_epi16(xmm, xmm), 16);
+            _mm_storeu_si128( reinterpret_cast<__m128i*>(pDstData + n),
+                              xmm0 );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>(pDstData + n + 4),
+                              xmm1 );
+        }
+        for( ; n < nWordCount; n++  )
+        {
+            pDstData[n] = pSrcData[n];
+        }
+    }
+    else
+    {
+        GDALCopyWordsGenericT(pSrcData, nSrcPixelStride,
+                              pDstData, nDstPixelStride,
+                              nWordCount);
+    }
+}
+
+template<> void GDALCopyWordsT( const GInt16* const CPL_RESTRICT pSrcData,
+                                int nSrcPixelStride,
+                                float* const CPL_RESTRICT pDstData,
+                                int nDstPixelStride,
+                                GPtrDiff_t nWordCount )
+{
+    if( nSrcPixelStride == static_cast<int>(sizeof(*pSrcData)) &&
+        nDstPixelStride == static_cast<int>(sizeof(*pDstData)) )
+    {
+        decltype(nWordCount) n = 0;
+        for (; n < nWordCount-7; n+=8)
+        {
+            __m128i xmm = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*> (pSrcData + n) );
+            __m128i xmm0 = _mm_srai_epi32(_mm_unpacklo_epi16(xmm, xmm), 16);
+            __m128i xmm1 = _mm_srai_epi32(_mm_unpackhi_epi16(xmm, xmm), 16);
+            _mm_storeu_ps( pDstData + n, _mm_cvtepi32_ps(xmm0) );
+            _mm_storeu_ps( pDstData + n + 4, _mm_cvtepi32_ps(xmm1) );
+        }
+        for( ; n < nWordCount; n++  )
+        {
+            pDstData[n] = pSrcData[n];
+        }
+    }
+    else
+    {
+        GDALCopyWordsGenericT(pSrcData, nSrcPixelStride,
+                              pDstData, nDstPixelStride,
+                              nWordCount);
+    }
+}
+
+template<> void GDALCopyWordsT( const GInt16* const CPL_RESTRICT pSrcData,
+                                int nSrcPixelStride,
+                                double* const CPL_RESTRICT pDstData,
+                                int nDstPixelStride,
+                                GPtrDiff_t nWordCount )
+{
+    if( nSrcPixelStride == static_cast<int>(sizeof(*pSrcData)) &&
+        nDstPixelStride == static_cast<int>(sizeof(*pDstData)) )
+    {
+        decltype(nWordCount) n = 0;
+        for (; n < nWordCount-7; n+=8)
+        {
+            __m128i xmm = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*> (pSrcData + n) );
+            __m128i xmm0 = _mm_srai_epi32(_mm_unpacklo_epi16(xmm, xmm), 16);
+            __m128i xmm1 = _mm_srai_epi32(_mm_unpackhi_epi16(xmm, xmm), 16);
+
+            _mm_storeu_pd( pDstData + n, _mm_cvtepi32_pd(xmm0) );
+            _mm_storeu_pd( pDstData + n + 2,
+                           _mm_cvtepi32_pd(_mm_srli_si128(xmm0, 8)) );
+            _mm_storeu_pd( pDstData + n + 4, _mm_cvtepi32_pd(xmm1) );
+            _mm_storeu_pd( pDstData + n + 6,
+                           _mm_cvtepi32_pd(_mm_srli_si128(xmm1, 8)) );
+        }
+        for( ; n < nWordCount; n++  )
+        {
+            pDstData[n] = pSrcData[n];
+        }
+    }
+    else
+    {
+        GDALCopyWordsGenericT(pSrcData, nSrcPixelStride,
+                              pDstData, nDstPixelStride,
+                              nWordCount);
+    }
+}
+
+template<> void GDALCopyWordsT( const GInt32* const CPL_RESTRICT pSrcData,
+                                int nSrcPixelStride,
+                                double* const CPL_RESTRICT pDstData,
+                                int nDstPixelStride,
+                                GPtrDiff_t nWordCount )
+{
+    if( nSrcPixelStride == static_cast<int>(sizeof(*pSrcData)) &&
+        nDstPixelStride == static_cast<int>(sizeof(*pDstData)) )
+    {
+        decltype(nWordCount) n = 0;
+        for (; n < nWordCount-3; n+=4)
+        {
+            __m128i xmm = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*> (pSrcData + n) );
+            _mm_storeu_pd( pDstData + n, _mm_cvtepi32_pd(xmm) );
+            _mm_storeu_pd( pDstData + n + 2,
+                           _mm_cvtepi32_pd(_mm_srli_si128(xmm, 8)) );
+        }
+        for( ; n < nWordCount; n++  )
+        {
+            pDstData[n] = pSrcData[n];
+        }
+    }
+    else
+    {
+        GDALCopyWordsGenericT(pSrcData, nSrcPixelStride,
+                              pDstData, nDstPixelStride,
+                              nWordCount);
+    }
+}
+
+template<> void GDALCopyWordsT( const GUInt32* const CPL_RESTRICT pSrcData,
+                                int nSrcPixelStride,
+                                double* const CPL_RESTRICT pDstData,
+                                int nDstPixelStride,
+                                GPtrDiff_t nWordCount )
+{
+    if( nSrcPixelStride == static_cast<int>(sizeof(*pSrcData)) &&
+        nDstPixelStride == static_cast<int>(sizeof(*pDstData)) )
+    {
+        decltype(nWordCount) n = 0;
+        // There is no unsigned 32 bit to double conversion in SSE2, so
+        // flip the sign bit to get value - 2^31 as a signed integer, convert
+        // it (exactly) and add back 2^31.
+        const __m128i xmm_sign = _mm_set1_epi32(
+            static_cast<int>(0x80000000U));
+        const __m128d xmm_2pow31 = _mm_set1_pd(2147483648.0);
+        for (; n < nWordCount-3; n+=4)
+        {
+            __m128i xmm = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*> (pSrcData + n) );
+            xmm = _mm_xor_si128(xmm, xmm_sign);
+            _mm_storeu_pd( pDstData + n,
+                           _mm_add_pd(_mm_cvtepi32_pd(xmm), xmm_2pow31) );
+            _mm_storeu_pd( pDstData + n + 2,
+                           _mm_add_pd(_mm_cvtepi32_pd(_mm_srli_si128(xmm, 8)),
+                                      xmm_2pow31) );
+        }
+        for( ; n < nWordCount; n++  )
+        {
+            pDstData[n] = pSrcData[n];
+        }
+    }
+    else
+    {
+        GDALCopyWordsGenericT(pSrcData, nSrcPixelStride,
+                              pDstData, nDstPixelStride,
+                              nWordCount);
+    }
+}
 
 #endif // defined(__x86_64) || defined(_M_X64)
 
@@ -4607,6 +4976,425 @@ static void GDALCopyWholeRasterGetSwathSize(
     *pnSwathLines = nSwathLines;
 }
 
+/************************************************************************/
+/*              GDALCopyWholeRasterCollectVRTSourceNames()              */
+/************************************************************************/
+
+// Collect the names of the datasets referenced by a serialized VRT. Returns
+// false if a source has no name, typically a MEM or another anonymous
+// dataset, that a reopened VRT would not be able to access.
+static bool GDALCopyWholeRasterCollectVRTSourceNames(
+    const CPLXMLNode* psNode, const char* pszVRTPath,
+    std::vector<std::string>& aosNames )
+{
+    for( ; psNode != nullptr; psNode = psNode->psNext )
+    {
+        if( psNode->eType != CXT_Element )
+            continue;
+        if( EQUAL(psNode->pszValue, "SourceFilename") ||
+            EQUAL(psNode->pszValue, "SourceDataset") )
+        {
+            const char* pszName = CPLGetXMLValue(psNode, nullptr, "");
+            if( pszName[0] == '\0' )
+                return false;
+            if( CPLTestBool(CPLGetXMLValue(psNode, "relativeToVRT", "0")) )
+                aosNames.push_back(CPLProjectRelativeFilename(pszVRTPath,
+                                                              pszName));
+            else
+                aosNames.push_back(pszName);
+        }
+        else if( !GDALCopyWholeRasterCollectVRTSourceNames(
+                        psNode->psChild, pszVRTPath, aosNames) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                 GDALCopyWholeRasterOpenSourceClone()                 */
+/************************************************************************/
+
+// Open another handle on the source dataset of GDALDatasetCopyWholeRaster(),
+// to be used from a worker thread. VRT datasets, including the anonymous
+// ones built by gdal_translate for scaling, LUTs or band selection, are
+// reopened from their XML serialization, so that the pixel conversions they
+// perform also run in the worker thread. Other datasets are reopened by name
+// with the same driver and open options, provided they are read-only.
+// Returns nullptr if no equivalent handle can be opened.
+static GDALDataset* GDALCopyWholeRasterOpenSourceClone( GDALDataset* poSrcDS )
+{
+    GDALDriver* poDriver = poSrcDS->GetDriver();
+    if( poDriver == nullptr )
+        return nullptr;
+
+    CPLErrorHandlerPusher oQuietError(CPLQuietErrorHandler);
+    GDALDataset* poClone = nullptr;
+    VRTDataset* poVRTDS = dynamic_cast<VRTDataset*>(poSrcDS);
+    if( poVRTDS != nullptr )
+    {
+        const std::string osVRTPath(
+            STARTS_WITH_CI(poVRTDS->GetDescription(), "<VRTDataset") ?
+                "" : CPLGetPath(poVRTDS->GetDescription()));
+        CPLXMLNode* psTree = poVRTDS->SerializeToXML(osVRTPath.c_str());
+        if( psTree == nullptr )
+            return nullptr;
+
+        // Sources opened in update mode might have pending modifications
+        // that a new handle would not see.
+        std::vector<std::string> aosSourceNames;
+        bool bCanReopen = GDALCopyWholeRasterCollectVRTSourceNames(
+            psTree, osVRTPath.c_str(), aosSourceNames);
+        int nOpenDatasets = 0;
+        GDALDataset** papoOpenDatasets =
+            GDALDataset::GetOpenDatasets(&nOpenDatasets);
+        for( int i = 0; bCanReopen && i < nOpenDatasets; ++i )
+        {
+            if( papoOpenDatasets[i]->GetAccess() == GA_Update &&
+                papoOpenDatasets[i] != poSrcDS &&
+                std::find(aosSourceNames.begin(), aosSourceNames.end(),
+                          papoOpenDatasets[i]->GetDescription()) !=
+                    aosSourceNames.end() )
+            {
+                bCanReopen = false;
+            }
+        }
+        if( !bCanReopen )
+        {
+            CPLDestroyXMLNode(psTree);
+            return nullptr;
+        }
+
+        char* pszXML = CPLSerializeXMLTree(psTree);
+        CPLDestroyXMLNode(psTree);
+        if( pszXML == nullptr )
+            return nullptr;
+        poClone = VRTDataset::OpenXML(pszXML, osVRTPath.c_str(),
+                                      GA_ReadOnly);
+        CPLFree(pszXML);
+    }
+    else
+    {
+        if( poSrcDS->GetAccess() != GA_ReadOnly ||
+            poSrcDS->GetDescription()[0] == '\0' ||
+            EQUAL(poDriver->GetDescription(), "MEM") )
+        {
+            return nullptr;
+        }
+        const char* const apszAllowedDrivers[] = {
+            poDriver->GetDescription(), nullptr };
+        poClone = GDALDataset::FromHandle(GDALOpenEx(
+            poSrcDS->GetDescription(),
+            GDAL_OF_RASTER | GDAL_OF_READONLY | GDAL_OF_INTERNAL,
+            apszAllowedDrivers, poSrcDS->GetOpenOptions(), nullptr));
+    }
+    if( poClone == nullptr )
+        return nullptr;
+
+    bool bCompatible =
+        poClone->GetRasterXSize() == poSrcDS->GetRasterXSize() &&
+        poClone->GetRasterYSize() == poSrcDS->GetRasterYSize() &&
+        poClone->GetRasterCount() == poSrcDS->GetRasterCount();
+    for( int i = 1; bCompatible && i <= poSrcDS->GetRasterCount(); ++i )
+    {
+        bCompatible =
+            poClone->GetRasterBand(i)->GetRasterDataType() ==
+                poSrcDS->GetRasterBand(i)->GetRasterDataType();
+    }
+    if( !bCompatible )
+    {
+        GDALClose(GDALDataset::ToHandle(poClone));
+        return nullptr;
+    }
+    return poClone;
+}
+
+/************************************************************************/
+/*                      GDALCopyWholeRasterChunk                        */
+/************************************************************************/
+
+namespace {
+struct GDALCopyWholeRasterState;
+
+// A swath to transfer. Swaths are read and converted by worker threads, in
+// any order, and written by the calling thread in their natural order.
+struct GDALCopyWholeRasterChunk
+{
+    GDALCopyWholeRasterState* psState = nullptr;
+    GDALDataset* poSrcDS = nullptr; // source handle owned by the worker
+    int nBand = 0;                  // 0 means all bands
+    int nXOff = 0;
+    int nYOff = 0;
+    int nXSize = 0;
+    int nYSize = 0;
+
+    bool bDone = false;
+    bool bHasData = false;
+    CPLErr eErr = CE_None;
+    std::vector<GByte> abyData{};
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+
+    static void Read(void* pData);
+};
+
+struct GDALCopyWholeRasterState
+{
+    GDALDataType eDT = GDT_Byte;
+    int nBandCount = 0;
+    bool bCheckHoles = false;
+
+    std::mutex oMutex{};
+    std::condition_variable oCV{};
+    std::vector<GDALDataset*> apoIdleSrcDS{};
+    bool bStop = false;
+};
+
+/************************************************************************/
+/*                  GDALCopyWholeRasterChunk::Read()                    */
+/************************************************************************/
+
+void GDALCopyWholeRasterChunk::Read(void* pData)
+{
+    GDALCopyWholeRasterChunk* psChunk =
+        static_cast<GDALCopyWholeRasterChunk*>(pData);
+    GDALCopyWholeRasterState* psState = psChunk->psState;
+    GDALDataset* poDS = psChunk->poSrcDS;
+
+    bool bStop;
+    {
+        std::lock_guard<std::mutex> oLock(psState->oMutex);
+        bStop = psState->bStop;
+    }
+
+    if( !bStop )
+    {
+        CPLInstallErrorHandlerAccumulator(psChunk->aoErrors);
+
+        const int nBands = psChunk->nBand > 0 ? 1 : psState->nBandCount;
+        int nStatus = GDAL_DATA_COVERAGE_STATUS_DATA;
+        if( psState->bCheckHoles )
+        {
+            nStatus = 0;
+            for( int iBand = 0; iBand < nBands; iBand++ )
+            {
+                const int nBand =
+                    psChunk->nBand > 0 ? psChunk->nBand : iBand + 1;
+                nStatus |= poDS->GetRasterBand(nBand)->GetDataCoverageStatus(
+                    psChunk->nXOff, psChunk->nYOff,
+                    psChunk->nXSize, psChunk->nYSize,
+                    GDAL_DATA_COVERAGE_STATUS_DATA);
+                if( nStatus & GDAL_DATA_COVERAGE_STATUS_DATA )
+                    break;
+            }
+        }
+        if( nStatus & GDAL_DATA_COVERAGE_STATUS_DATA )
+        {
+            try
+            {
+                psChunk->abyData.resize(
+                    static_cast<size_t>(psChunk->nXSize) * psChunk->nYSize *
+                    nBands * GDALGetDataTypeSizeBytes(psState->eDT));
+                psChunk->bHasData = true;
+            }
+            catch( const std::bad_alloc& )
+            {
+                CPLError(CE_Failure, CPLE_OutOfMemory,
+                         "Cannot allocate swath buffer");
+                psChunk->eErr = CE_Failure;
+            }
+            if( psChunk->bHasData )
+            {
+                psChunk->eErr = poDS->RasterIO(
+                    GF_Read, psChunk->nXOff, psChunk->nYOff,
+                    psChunk->nXSize, psChunk->nYSize,
+                    psChunk->abyData.data(), psChunk->nXSize, psChunk->nYSize,
+                    psState->eDT, nBands,
+                    psChunk->nBand > 0 ? &psChunk->nBand : nullptr,
+                    0, 0, 0, nullptr);
+            }
+        }
+
+        CPLUninstallErrorHandlerAccumulator();
+    }
+
+    {
+        std::lock_guard<std::mutex> oLock(psState->oMutex);
+        psState->apoIdleSrcDS.push_back(poDS);
+        psChunk->poSrcDS = nullptr;
+        psChunk->bDone = true;
+    }
+    psState->oCV.notify_all();
+}
+} // namespace
+
+/************************************************************************/
+/*                  GDALCopyWholeRasterMultiThreaded()                  */
+/************************************************************************/
+
+// Pipelined version of GDALDatasetCopyWholeRaster(): source swaths are read,
+// decoded and converted to the destination data type by worker threads,
+// each one using its own handle on the source dataset, while the calling
+// thread writes them to the destination in the same order as the
+// sequential code path, so that drivers that expect blocks to be written
+// in order keep working as before.
+// Returns false, without having done anything, if the source dataset cannot
+// be read from several threads, in which case the caller must do the copy
+// itself.
+static bool GDALCopyWholeRasterMultiThreaded(
+    GDALDataset* poSrcDS, GDALDataset* poDstDS, GDALDataType eDT,
+    bool bInterleave, bool bCheckHoles, int nSwathCols, int nSwathLines,
+    int nThreads, GDALProgressFunc pfnProgress, void *pProgressData,
+    CPLErr& eErr )
+{
+    const int nXSize = poDstDS->GetRasterXSize();
+    const int nYSize = poDstDS->GetRasterYSize();
+    const int nBandCount = poDstDS->GetRasterCount();
+
+    GDALCopyWholeRasterState sState;
+    sState.eDT = eDT;
+    sState.nBandCount = nBandCount;
+    sState.bCheckHoles = bCheckHoles;
+
+    std::vector<GDALCopyWholeRasterChunk> asChunks;
+    for( int iBand = 0; iBand < (bInterleave ? 1 : nBandCount); iBand++ )
+    {
+        for( int iY = 0; iY < nYSize; iY += nSwathLines )
+        {
+            for( int iX = 0; iX < nXSize; iX += nSwathCols )
+            {
+                GDALCopyWholeRasterChunk sChunk;
+                sChunk.psState = &sState;
+                sChunk.nBand = bInterleave ? 0 : iBand + 1;
+                sChunk.nXOff = iX;
+                sChunk.nYOff = iY;
+                sChunk.nXSize = std::min(nSwathCols, nXSize - iX);
+                sChunk.nYSize = std::min(nSwathLines, nYSize - iY);
+                asChunks.emplace_back(std::move(sChunk));
+            }
+        }
+    }
+    if( asChunks.size() < 2 )
+        return false;
+
+    // Bound the number of swaths being read or waiting to be written, so
+    // that they fit in the block cache size, but let at least one swath be
+    // read while the previous one is written.
+    const GIntBig nSwathBytes =
+        static_cast<GIntBig>(nSwathCols) * nSwathLines *
+        GDALGetDataTypeSizeBytes(eDT) * (bInterleave ? nBandCount : 1);
+    const size_t nMaxInFlight = static_cast<size_t>(std::max(GIntBig(2),
+        std::min(static_cast<GIntBig>(2 * nThreads),
+                 GDALGetCacheMax64() / std::max(GIntBig(1), nSwathBytes))));
+    nThreads = static_cast<int>(std::min(static_cast<size_t>(nThreads),
+                                         nMaxInFlight));
+
+    auto poThreadPool = GDALGetGlobalThreadPool(nThreads);
+    if( poThreadPool == nullptr )
+        return false;
+
+    for( int i = 0; i < nThreads; i++ )
+    {
+        GDALDataset* poClone = GDALCopyWholeRasterOpenSourceClone(poSrcDS);
+        if( poClone == nullptr )
+            break;
+        sState.apoIdleSrcDS.push_back(poClone);
+    }
+    if( sState.apoIdleSrcDS.empty() )
+    {
+        CPLDebug("GDAL",
+                 "GDALDatasetCopyWholeRaster(): cannot reopen source dataset. "
+                 "Using single-threaded copy");
+        return false;
+    }
+    const size_t nSrcDSCount = sState.apoIdleSrcDS.size();
+
+    CPLDebug("GDAL",
+             "GDALDatasetCopyWholeRaster(): %d*%d swaths, bInterleave=%d, "
+             "%d reading threads",
+             nSwathCols, nSwathLines, static_cast<int>(bInterleave),
+             static_cast<int>(nSrcDSCount));
+
+    auto poJobQueue = poThreadPool->CreateJobQueue();
+    eErr = CE_None;
+    size_t iNextToSubmit = 0;
+    for( size_t iNextToWrite = 0;
+         iNextToWrite < asChunks.size() && eErr == CE_None;
+         iNextToWrite++ )
+    {
+        GDALCopyWholeRasterChunk& sChunk = asChunks[iNextToWrite];
+        {
+            std::unique_lock<std::mutex> oLock(sState.oMutex);
+            while( true )
+            {
+                while( iNextToSubmit < asChunks.size() &&
+                       iNextToSubmit - iNextToWrite < nMaxInFlight &&
+                       !sState.apoIdleSrcDS.empty() )
+                {
+                    GDALCopyWholeRasterChunk& sNext = asChunks[iNextToSubmit];
+                    sNext.poSrcDS = sState.apoIdleSrcDS.back();
+                    sState.apoIdleSrcDS.pop_back();
+                    if( !poJobQueue->SubmitJob(GDALCopyWholeRasterChunk::Read,
+                                               &sNext) )
+                    {
+                        // Should not happen. Read the swath inline.
+                        oLock.unlock();
+                        GDALCopyWholeRasterChunk::Read(&sNext);
+                        oLock.lock();
+                    }
+                    iNextToSubmit++;
+                }
+                if( sChunk.bDone )
+                    break;
+                sState.oCV.wait(oLock);
+            }
+        }
+
+        for( const auto& oError: sChunk.aoErrors )
+        {
+            CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+        }
+        eErr = sChunk.eErr;
+
+        if( eErr == CE_None && sChunk.bHasData )
+        {
+            int nBand = sChunk.nBand;
+            eErr = poDstDS->RasterIO( GF_Write,
+                                      sChunk.nXOff, sChunk.nYOff,
+                                      sChunk.nXSize, sChunk.nYSize,
+                                      sChunk.abyData.data(),
+                                      sChunk.nXSize, sChunk.nYSize,
+                                      eDT, bInterleave ? nBandCount : 1,
+                                      bInterleave ? nullptr : &nBand,
+                                      0, 0, 0, nullptr );
+        }
+        std::vector<GByte>().swap(sChunk.abyData);
+
+        if( eErr == CE_None &&
+            !pfnProgress(
+                static_cast<double>(iNextToWrite + 1) / asChunks.size(),
+                nullptr, pProgressData ) )
+        {
+            eErr = CE_Failure;
+            CPLError( CE_Failure, CPLE_UserInterrupt,
+                      "User terminated CreateCopy()" );
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> oLock(sState.oMutex);
+        sState.bStop = true;
+    }
+    poJobQueue->WaitCompletion();
+
+    CPLAssert(sState.apoIdleSrcDS.size() == nSrcDSCount);
+    CPL_IGNORE_RET_VAL(nSrcDSCount);
+    for( GDALDataset* poClone: sState.apoIdleSrcDS )
+        GDALClose(GDALDataset::ToHandle(poClone));
+
+    return true;
+}
+
 /************************************************************************/
 /*                     GDALDatasetCopyWholeRaster()                     */
 /************************************************************************/
@@ -4631,6 +5419,15 @@ static void GDALCopyWholeRasterGetSwathSize(
  * achieve best compression.</li>
  * <li>"SKIP_HOLES=YES" to skip chunks for which GDALGetDataCoverageStatus()
  * returns GDAL_DATA_COVERAGE_STATUS_EMPTY (GDAL &gt;= 2.2)</li>
+ * <li>"NUM_THREADS=val" where val is a number of threads or ALL_CPUS, to read
+ * and convert source chunks in worker threads while the calling thread writes
+ * them, in order, to the destination dataset. Defaults to the value of the
+ * GDAL_COPY_WHOLE_RASTER_NUM_THREADS configuration option, or 1. This
+ * requires the source dataset to be a VRT dataset, or a read-only dataset
+ * that can be reopened by name. Each worker thread reopens the source
+ * dataset, which has a cost (header parsing, network requests, memory of
+ * per-dataset caches) that may outweigh the benefit for small or cheap to
+ * decode sources. (GDAL &gt;= 3.4)</li>
  * </ul>
  * More options may be supported in the future.
  *
@@ -4739,6 +5536,28 @@ CPLErr CPL_STDCALL GDALDatasetCopyWholeRaster(
                                      bDstIsCompressed, bInterleave,
                                      &nSwathCols, &nSwathLines );
 
+    const bool bCheckHoles = CPLTestBool( CSLFetchNameValueDef(
+                                        papszOptions, "SKIP_HOLES", "NO" ) );
+
+/* -------------------------------------------------------------------- */
+/*      Multi-threaded reading and conversion, if requested.            */
+/* -------------------------------------------------------------------- */
+    const char* pszNumThreads = CSLFetchNameValueDef(
+        papszOptions, "NUM_THREADS",
+        CPLGetConfigOption("GDAL_COPY_WHOLE_RASTER_NUM_THREADS", "1"));
+    const int nThreads = std::max(1, std::min(128,
+        EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                           atoi(pszNumThreads)));
+    CPLErr eErr = CE_None;
+    if( nThreads > 1 &&
+        GDALCopyWholeRasterMultiThreaded( poSrcDS, poDstDS, eDT,
+                                          bInterleave, bCheckHoles,
+                                          nSwathCols, nSwathLines, nThreads,
+                                          pfnProgress, pProgressData, eErr ) )
+    {
+        return eErr;
+    }
+
     int nPixelSize = GDALGetDataTypeSizeBytes(eDT);
     if( bInterleave)
         nPixelSize *= nBandCount;
@@ -4762,10 +5581,6 @@ CPLErr CPL_STDCALL GDALDatasetCopyWholeRaster(
 /* ==================================================================== */
 /*      Band oriented (uninterleaved) case.                             */
 /* ==================================================================== */
-    CPLErr eErr = CE_None;
-    const bool bCheckHoles = CPLTestBool( CSLFetchNameValueDef(
-                                        papszOptions, "SKIP_HOLES", "NO" ) );
-
     if( !bInterleave )
     {
         GDALRasterIOExtraArg sExtraArg;
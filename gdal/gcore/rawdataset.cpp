@@ -1526,6 +1526,18 @@ CPLErr RawDataset::IRasterIO( GDALRWFlag eRWFlag,
                               GDALRasterIOExtraArg* psExtraArg )
 
 {
+    if( eRWFlag == GF_Read && nXSize == nBufXSize && nYSize == nBufYSize &&
+        nBandCount > 1 )
+    {
+        bool bTried = false;
+        const CPLErr eErr = TryReadInterleavedBands(
+            nXOff, nYOff, nXSize, nYSize, pData, eBufType,
+            nBandCount, panBandMap, nPixelSpace, nLineSpace, nBandSpace,
+            psExtraArg, &bTried);
+        if( bTried )
+            return eErr;
+    }
+
     const char* pszInterleave = nullptr;
 
     // The default GDALDataset::IRasterIO() implementation would go to
@@ -1599,6 +1611,186 @@ CPLErr RawDataset::IRasterIO( GDALRWFlag eRWFlag,
 }
 
 
+/************************************************************************/
+/*                      TryReadInterleavedBands()                       */
+/*                                                                      */
+/*      Read several bands interleaved by pixel or by line in a         */
+/*      single pass: each file line is read once, with several lines    */
+/*      per read when they are contiguous enough, byte swapped once,    */
+/*      and deinterleaved into the buffer of each band.                 */
+/************************************************************************/
+
+CPLErr RawDataset::TryReadInterleavedBands( int nXOff, int nYOff,
+                                            int nXSize, int nYSize,
+                                            void *pData, GDALDataType eBufType,
+                                            int nBandCount, int *panBandMap,
+                                            GSpacing nPixelSpace,
+                                            GSpacing nLineSpace,
+                                            GSpacing nBandSpace,
+                                            GDALRasterIOExtraArg* psExtraArg,
+                                            bool* pbTried )
+{
+    *pbTried = false;
+
+    const char *pszGDAL_ONE_BIG_READ =
+        CPLGetConfigOption("GDAL_ONE_BIG_READ", nullptr);
+    if( pszGDAL_ONE_BIG_READ != nullptr && !CPLTestBool(pszGDAL_ONE_BIG_READ) )
+        return CE_None;
+
+    // All requested bands must share the file, data type, byte order,
+    // pixel and line offsets, and be stored within the same file lines.
+    RawRasterBand *poFirstBand = nullptr;
+    vsi_l_offset nMinImgOffset = 0;
+    vsi_l_offset nMaxImgOffset = 0;
+    for( int iBandIndex = 0; iBandIndex < nBandCount; iBandIndex++ )
+    {
+        RawRasterBand *poBand = dynamic_cast<RawRasterBand *>(
+            GetRasterBand(panBandMap[iBandIndex]));
+        if( poBand == nullptr ||
+            poBand->nPixelOffset <= 0 || poBand->nLineOffset <= 0 ||
+            poBand->bNeedFileFlush || poBand->bLoadedScanlineDirty ||
+            poBand->HasDirtyBlocks() )
+        {
+            return CE_None;
+        }
+        if( poFirstBand == nullptr )
+        {
+            poFirstBand = poBand;
+            nMinImgOffset = poBand->nImgOffset;
+            nMaxImgOffset = poBand->nImgOffset;
+        }
+        else if( poBand->fpRawL != poFirstBand->fpRawL ||
+                 poBand->eDataType != poFirstBand->eDataType ||
+                 poBand->eByteOrder != poFirstBand->eByteOrder ||
+                 poBand->nPixelOffset != poFirstBand->nPixelOffset ||
+                 poBand->nLineOffset != poFirstBand->nLineOffset )
+        {
+            return CE_None;
+        }
+        nMinImgOffset = std::min(nMinImgOffset, poBand->nImgOffset);
+        nMaxImgOffset = std::max(nMaxImgOffset, poBand->nImgOffset);
+    }
+
+    const GDALDataType eDT = poFirstBand->eDataType;
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDT);
+    const int nPixelOffset = poFirstBand->nPixelOffset;
+    const int nLineOffset = poFirstBand->nLineOffset;
+    if( nMaxImgOffset - nMinImgOffset >=
+            static_cast<vsi_l_offset>(nLineOffset) )
+    {
+        // Band sequential: bands are not in the same file lines
+        return CE_None;
+    }
+
+    // Bytes to read for one line, and bytes of it that are requested.
+    const size_t nSpan = static_cast<size_t>(nMaxImgOffset - nMinImgOffset) +
+        static_cast<size_t>(nXSize - 1) * nPixelOffset + nDTSize;
+    const size_t nUsefulBytes =
+        static_cast<size_t>(nBandCount) * nXSize * nDTSize;
+    if( nUsefulBytes < nSpan / 2 )
+        return CE_None;
+
+    // Do not bypass the block cache if it already holds the request.
+    if( !(pszGDAL_ONE_BIG_READ != nullptr &&
+          CPLTestBool(pszGDAL_ONE_BIG_READ)) &&
+        poFirstBand->IsSignificantNumberOfLinesLoaded(nYOff, nYSize) )
+    {
+        return CE_None;
+    }
+
+    *pbTried = true;
+
+    // Read several lines at once when the gaps between them are small,
+    // up to a few megabytes per read.
+    constexpr size_t MAX_CHUNK_SIZE = 8 * 1024 * 1024;
+    int nLinesPerChunk = 1;
+    if( static_cast<size_t>(nLineOffset) <= 2 * nSpan &&
+        nSpan < MAX_CHUNK_SIZE )
+    {
+        nLinesPerChunk = static_cast<int>(std::min(
+            static_cast<size_t>(nYSize),
+            (MAX_CHUNK_SIZE - nSpan) / nLineOffset + 1));
+    }
+    const size_t nChunkSize =
+        static_cast<size_t>(nLinesPerChunk - 1) * nLineOffset + nSpan;
+    GByte *pabyChunk = static_cast<GByte *>(VSI_MALLOC_VERBOSE(nChunkSize));
+    if( pabyChunk == nullptr )
+        return CE_Failure;
+
+    // If all the words of a line have the data type of the bands, swap them
+    // in a single pass.
+    const bool bNeedsByteSwap = poFirstBand->NeedsByteOrderChange();
+    const bool bPackedSwap =
+        (nPixelOffset % nDTSize) == 0 && (nSpan % nDTSize) == 0;
+    bool bSameWordAlignment = true;
+    for( int iBandIndex = 0; iBandIndex < nBandCount; iBandIndex++ )
+    {
+        RawRasterBand *poBand = cpl::down_cast<RawRasterBand *>(
+            GetRasterBand(panBandMap[iBandIndex]));
+        if( ((poBand->nImgOffset - nMinImgOffset) % nDTSize) != 0 )
+            bSameWordAlignment = false;
+    }
+
+    CPLDebug("RAW", "Reading %d interleaved bands, %d lines per read",
+             nBandCount, nLinesPerChunk);
+
+    CPLErr eErr = CE_None;
+    for( int iLine = 0; iLine < nYSize && eErr == CE_None;
+         iLine += nLinesPerChunk )
+    {
+        const int nLines = std::min(nLinesPerChunk, nYSize - iLine);
+        const vsi_l_offset nOffset = nMinImgOffset +
+            static_cast<vsi_l_offset>(nYOff + iLine) * nLineOffset +
+            static_cast<vsi_l_offset>(nXOff) * nPixelOffset;
+        const size_t nBytesToRead =
+            static_cast<size_t>(nLines - 1) * nLineOffset + nSpan;
+        // Like direct I/O, zero-fill what is beyond the end of the file.
+        size_t nBytesRead = 0;
+        if( poFirstBand->Seek(nOffset, SEEK_SET) == 0 )
+            nBytesRead = poFirstBand->Read(pabyChunk, 1, nBytesToRead);
+        if( nBytesRead < nBytesToRead )
+            memset(pabyChunk + nBytesRead, 0, nBytesToRead - nBytesRead);
+
+        for( int j = 0; j < nLines; j++ )
+        {
+            GByte *pabyLine =
+                pabyChunk + static_cast<size_t>(j) * nLineOffset;
+            if( bNeedsByteSwap && bPackedSwap && bSameWordAlignment )
+            {
+                poFirstBand->DoByteSwap(pabyLine, nSpan / nDTSize, nDTSize,
+                                        true);
+            }
+            for( int iBandIndex = 0; iBandIndex < nBandCount; iBandIndex++ )
+            {
+                RawRasterBand *poBand = cpl::down_cast<RawRasterBand *>(
+                    GetRasterBand(panBandMap[iBandIndex]));
+                GByte *pabyBandLine = pabyLine +
+                    static_cast<size_t>(poBand->nImgOffset - nMinImgOffset);
+                if( bNeedsByteSwap && !(bPackedSwap && bSameWordAlignment) )
+                {
+                    poBand->DoByteSwap(pabyBandLine, nXSize, nPixelOffset,
+                                       true);
+                }
+                GDALCopyWords(
+                    pabyBandLine, eDT, nPixelOffset,
+                    static_cast<GByte *>(pData) + iBandIndex * nBandSpace +
+                        static_cast<GPtrDiff_t>(iLine + j) * nLineSpace,
+                    eBufType, static_cast<int>(nPixelSpace), nXSize);
+            }
+        }
+
+        if( psExtraArg->pfnProgress != nullptr &&
+            !psExtraArg->pfnProgress(1.0 * (iLine + nLines) / nYSize, "",
+                                     psExtraArg->pProgressData) )
+        {
+            eErr = CE_Failure;
+        }
+    }
+
+    CPLFree(pabyChunk);
+    return eErr;
+}
+
 /************************************************************************/
 /*                  RAWDatasetCheckMemoryUsage()                        */
 /************************************************************************/
@@ -56,6 +56,14 @@ class CPL_DLL RawDataset : public GDALPamDataset
                       GSpacing nPixelSpace, GSpacing nLineSpace,
                       GSpacing nBandSpace,
                       GDALRasterIOExtraArg* psExtraArg ) override;
+    CPLErr TryReadInterleavedBands( int nXOff, int nYOff,
+                                    int nXSize, int nYSize,
+                                    void *pData, GDALDataType eBufType,
+                                    int nBandCount, int *panBandMap,
+                                    GSpacing nPixelSpace, GSpacing nLineSpace,
+                                    GSpacing nBandSpace,
+                                    GDALRasterIOExtraArg* psExtraArg,
+                                    bool* pbTried );
   public:
                  RawDataset();
          virtual ~RawDataset() = 0;
@@ -362,6 +362,49 @@ bool TileMatrixSet::hasVariableMatrixWidth() const
     return false;
 }
 
+/************************************************************************/
+/*                          selectZoomLevel()                           */
+/************************************************************************/
+
+int TileMatrixSet::selectZoomLevel(const std::vector<double>& adfResolutions,
+                                   double dfComputedRes,
+                                   const char* pszStrategy)
+{
+    const int nLevels = static_cast<int>(adfResolutions.size());
+    double dfPrevRes = 0.0;
+    double dfRes = 0.0;
+    int nZoomLevel = 0;  // Used after for.
+    for( ; nZoomLevel < nLevels; nZoomLevel++ )
+    {
+        dfRes = adfResolutions[nZoomLevel];
+        if( dfComputedRes > dfRes || fabs( dfComputedRes - dfRes ) / dfRes <= 1e-8 )
+            break;
+        dfPrevRes = dfRes;
+    }
+    if( nZoomLevel == nLevels )
+        return -1;
+
+    if( nZoomLevel > 0 && fabs( dfComputedRes - dfRes ) / dfRes > 1e-8 )
+    {
+        if( pszStrategy == nullptr )
+            pszStrategy = "AUTO";
+        if( EQUAL(pszStrategy, "LOWER") )
+        {
+            nZoomLevel --;
+        }
+        else if( EQUAL(pszStrategy, "UPPER") )
+        {
+            /* do nothing */
+        }
+        else
+        {
+            if( dfPrevRes / dfComputedRes < dfComputedRes / dfRes )
+                nZoomLevel --;
+        }
+    }
+    return nZoomLevel;
+}
+
 } // namespace gdal
 
 //! @endcond
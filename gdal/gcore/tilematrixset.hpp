@@ -103,6 +103,16 @@ class CPL_DLL TileMatrixSet
 
         bool hasVariableMatrixWidth() const;
 
+        /** Return the index, in adfResolutions (resolutions of zoom levels
+         * sorted from the coarsest to the finest one), of the zoom level to
+         * use for a raster whose native resolution is dfComputedRes, or -1 if
+         * none is fine enough. pszStrategy is the value of the
+         * ZOOM_LEVEL_STRATEGY creation option of tiled drivers: AUTO (closest
+         * resolution), LOWER or UPPER. */
+        static int selectZoomLevel(const std::vector<double>& adfResolutions,
+                                   double dfComputedRes,
+                                   const char* pszStrategy);
+
     private:
         TileMatrixSet() = default;
 
@@ -30,13 +30,28 @@
 
 #include "gnmgraph.h"
 #include "gnm_priv.h"
+#include "cpl_worker_thread_pool.h"
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <set>
 
 CPL_CVSID("$Id$")
 
 //! @cond Doxygen_Suppress
+
+// Parameters of one worker of GNMGraph::DijkstraShortestPaths(), which
+// processes the start vertices nFirstStart, nFirstStart + nStartStep, ...
+struct GNMShortestPathsJob
+{
+    const GNMGraph* poGraph = nullptr;
+    const GNMVECTOR* panStartFIDs = nullptr;
+    const GNMVECTOR* panEndFIDs = nullptr;
+    std::vector<GNMPATH>* paoPaths = nullptr;
+    size_t nFirstStart = 0;
+    size_t nStartStep = 1;
+};
+
 GNMGraph::GNMGraph() {}
 
 GNMGraph::~GNMGraph() {}
@@ -49,6 +64,7 @@ void GNMGraph::AddVertex(GNMGFID nFID)
     GNMStdVertex stVertex;
     stVertex.bIsBlocked = false;
     m_mstVertices[nFID] = stVertex;
+    m_bCSRDirty = true;
 }
 
 void GNMGraph::DeleteVertex(GNMGFID nFID)
@@ -65,6 +81,7 @@ void GNMGraph::DeleteVertex(GNMGFID nFID)
     }
     for(size_t i=0;i<aoIdsToErase.size();i++)
         m_mstEdges.erase(aoIdsToErase[i]);
+    m_bCSRDirty = true;
 }
 
 void GNMGraph::AddEdge(GNMGFID nConFID, GNMGFID nSrcFID, GNMGFID nTgtFID,
@@ -105,6 +122,7 @@ void GNMGraph::AddEdge(GNMGFID nConFID, GNMGFID nSrcFID, GNMGFID nTgtFID,
     {
         itSrs->second.anOutEdgeFIDs.push_back(nConFID);
     }
+    m_bCSRDirty = true;
 }
 
 void GNMGraph::DeleteEdge(GNMGFID nConFID)
@@ -120,6 +138,7 @@ void GNMGraph::DeleteEdge(GNMGFID nConFID)
                                  it->second.anOutEdgeFIDs.end(), nConFID),
                     it->second.anOutEdgeFIDs.end());
     }
+    m_bCSRDirty = true;
 }
 
 void GNMGraph::ChangeEdge(GNMGFID nFID, double dfCost, double dfInvCost)
@@ -129,6 +148,7 @@ void GNMGraph::ChangeEdge(GNMGFID nFID, double dfCost, double dfInvCost)
     {
         it->second.dfDirCost = dfCost;
         it->second.dfInvCost = dfInvCost;
+        m_bCSRDirty = true;
     }
 }
 
@@ -139,6 +159,7 @@ void GNMGraph::ChangeBlockState(GNMGFID nFID, bool bBlock)
     if(itv != m_mstVertices.end())
     {
         itv->second.bIsBlocked = bBlock;
+        m_bCSRDirty = true;
         return;
     }
 
@@ -147,6 +168,7 @@ void GNMGraph::ChangeBlockState(GNMGFID nFID, bool bBlock)
     if (ite != m_mstEdges.end())
     {
         ite->second.bIsBlocked = bBlock;
+        m_bCSRDirty = true;
     }
 }
 
@@ -171,68 +193,22 @@ void GNMGraph::ChangeAllBlockState(bool bBlock)
     {
         ite->second.bIsBlocked = bBlock;
     }
+    m_bCSRDirty = true;
 }
 
 GNMPATH GNMGraph::DijkstraShortestPath( GNMGFID nStartFID, GNMGFID nEndFID,
                                  const std::map<GNMGFID, GNMStdEdge> &mstEdges)
 {
-    std::map<GNMGFID, GNMGFID> mnShortestTree;
-    DijkstraShortestPathTree(nStartFID, mstEdges, mnShortestTree);
-
-    // We search for a path in the resulting tree, starting from end point to
-    // start point.
-
-    GNMPATH aoShortestPath;
-    GNMGFID nNextVertexId = nEndFID;
-    std::map<GNMGFID, GNMGFID>::iterator it;
-    EDGEVERTEXPAIR buf;
-
-    while (true)
-    {
-        it = mnShortestTree.find(nNextVertexId);
-
-        if (it == mnShortestTree.end())
-        {
-            // We haven't found the start vertex - there is no path between
-            // to given vertices in a shortest-path tree.
-            break;
-        }
-        else if (it->first == nStartFID)
-        {
-            // We've reached the start vertex and return an array.
-            aoShortestPath.push_back( std::make_pair(nNextVertexId, -1) );
-
-            // Revert array because the first vertex is now the last in path.
-            int size = static_cast<int>(aoShortestPath.size());
-            for (int i = 0; i < size / 2; ++i)
-            {
-                buf = aoShortestPath[i];
-                aoShortestPath[i] = aoShortestPath[size - i - 1];
-                aoShortestPath[size - i - 1] = buf;
-            }
-            return aoShortestPath;
-        }
-        else
-        {
-            // There is only one edge which leads to this vertex, because we
-            // analyse a tree. We add this edge with its target vertex into
-            // final array.
-            aoShortestPath.push_back(std::make_pair(nNextVertexId, it->second));
-
-            // An edge has only two vertices, so we get the opposite one to the
-            // current vertex in order to continue search backwards.
-            nNextVertexId = GetOppositVertex(it->second, it->first);
-        }
-    }
-
-    // return empty array
-    GNMPATH oRet;
-    return oRet;
+    BuildCSR();
+    std::vector<double> adfEdgeCosts;
+    GetCSREdgeCosts(mstEdges, adfEdgeCosts);
+    return DijkstraShortestPathCSR(nStartFID, nEndFID, adfEdgeCosts);
 }
 
 GNMPATH GNMGraph::DijkstraShortestPath( GNMGFID nStartFID, GNMGFID nEndFID)
 {
-    return DijkstraShortestPath(nStartFID, nEndFID, m_mstEdges);
+    BuildCSR();
+    return DijkstraShortestPathCSR(nStartFID, nEndFID, m_adfCSREdgeCosts);
 }
 
 std::vector<GNMPATH> GNMGraph::KShortestPaths(GNMGFID nStartFID, GNMGFID nEndFID,
@@ -261,19 +237,21 @@ std::vector<GNMPATH> GNMGraph::KShortestPaths(GNMGFID nStartFID, GNMGFID nEndFID
 
     A.push_back(aoFirstPath);
 
-    size_t i, k, l;
+    size_t i, k;
     GNMPATH::iterator itAk, tempIt, itR;
     std::vector<GNMPATH>::iterator itA;
-    std::map<GNMGFID, double>::iterator itDel;
     GNMPATH aoRootPath, aoRootPathOther, aoSpurPath;
-    GNMGFID nSpurNode, nVertexToDel, nEdgeToDel;
+    GNMGFID nSpurNode;
     double dfSumCost;
 
-    std::map<GNMGFID, GNMStdEdge> mstEdges = m_mstEdges;
+    // Edge costs indexed like m_anCSREdgeFIDs.
+    BuildCSR();
+    std::vector<double> adfEdgeCosts = m_adfCSREdgeCosts;
 
     for (k = 0; k < nK - 1; ++k) // -1 because we have already found one
     {
-        std::map<GNMGFID, double> mDeletedEdges; // for infinity costs assignment
+        // Edge index and cost before the infinity cost assignment
+        std::vector<std::pair<int, double> > aoDeletedEdges;
         itAk = A[k].begin();
 
         for (i = 0; i < A[k].size() - 1; ++i) // avoid end node
@@ -321,10 +299,14 @@ std::vector<GNMPATH> GNMGraph::KShortestPaths(GNMGFID nStartFID, GNMGFID nEndFID
                         (i < aoRootPathOther.size()))
                 {
                     tempIt = itA->begin() + i + 1;
-                    mDeletedEdges.insert(std::make_pair(tempIt->second,
-                                           mstEdges[tempIt->second].dfDirCost));
-                    mstEdges[tempIt->second].dfDirCost
-                                      = std::numeric_limits<double>::infinity();
+                    const int iEdge = GetCSREdgeIndex(tempIt->second);
+                    if (iEdge >= 0)
+                    {
+                        aoDeletedEdges.push_back(
+                            std::make_pair(iEdge, adfEdgeCosts[iEdge]));
+                        adfEdgeCosts[iEdge] =
+                                      std::numeric_limits<double>::infinity();
+                    }
                 }
             }
 
@@ -337,33 +319,38 @@ std::vector<GNMPATH> GNMGraph::KShortestPaths(GNMGFID nStartFID, GNMGFID nEndFID
             // end()-1, because we should not remove the spur node
             for (itR = aoRootPath.begin(); itR != aoRootPath.end() - 1; ++itR)
             {
-                nVertexToDel = itR->first;
-                for (l = 0; l < m_mstVertices[nVertexToDel].anOutEdgeFIDs.size();
-                     ++l)
+                const int iVertexToDel = GetCSRVertexIndex(itR->first);
+                if (iVertexToDel < 0)
+                    continue;
+                for (int l = m_anCSROffsets[iVertexToDel];
+                     l < m_anCSROffsets[iVertexToDel + 1]; ++l)
                 {
-                    nEdgeToDel = m_mstVertices[nVertexToDel].anOutEdgeFIDs[l];
-                    mDeletedEdges.insert(std::make_pair(nEdgeToDel,
-                                               mstEdges[nEdgeToDel].dfDirCost));
-                    mstEdges[nEdgeToDel].dfDirCost
+                    const int iEdgeToDel = m_anCSREdges[l];
+                    aoDeletedEdges.push_back(
+                        std::make_pair(iEdgeToDel, adfEdgeCosts[iEdgeToDel]));
+                    adfEdgeCosts[iEdgeToDel]
                                       = std::numeric_limits<double>::infinity();
                 }
             }
 
             // Find the new best path in the modified graph.
-            aoSpurPath = DijkstraShortestPath(nSpurNode, nEndFID, mstEdges);
+            aoSpurPath = DijkstraShortestPathCSR(nSpurNode, nEndFID,
+                                                 adfEdgeCosts);
 
             // Firstly, restore deleted edges in order to calculate the summary
             // cost of the path correctly later, because the costs will be
             // gathered from the initial graph.
             // We must do it here, after each edge removing, because the later
             // Dijkstra searches must consider these edges.
-            for (itDel = mDeletedEdges.begin(); itDel != mDeletedEdges.end();
-                 ++itDel)
+            // Restore in reverse order, so that an edge "deleted" twice gets
+            // its original cost back.
+            for (size_t iDel = aoDeletedEdges.size(); iDel > 0; --iDel)
             {
-                mstEdges[itDel->first].dfDirCost = itDel->second;
+                adfEdgeCosts[aoDeletedEdges[iDel - 1].first] =
+                                            aoDeletedEdges[iDel - 1].second;
             }
 
-            mDeletedEdges.clear();
+            aoDeletedEdges.clear();
 
             // If the part of a new best path has been found we form a full one
             // and add it to the candidates array.
@@ -382,7 +369,9 @@ std::vector<GNMPATH> GNMGraph::KShortestPaths(GNMGFID nStartFID, GNMGFID nEndFID
                     // infinity, because every time we assign infinity costs for
                     // edges of old paths, we anyway have the alternative edges
                     // with non-infinity costs.
-                    dfSumCost += mstEdges[itR->second].dfDirCost;
+                    const int iEdge = GetCSREdgeIndex(itR->second);
+                    if (iEdge >= 0)
+                        dfSumCost += adfEdgeCosts[iEdge];
                 }
 
                 B.insert(std::make_pair(dfSumCost, aoRootPath));
@@ -442,94 +431,339 @@ void GNMGraph::Clear()
 {
     m_mstVertices.clear();
     m_mstEdges.clear();
+    m_bCSRDirty = true;
 }
 
 void GNMGraph::DijkstraShortestPathTree(GNMGFID nFID,
                                    const std::map<GNMGFID, GNMStdEdge> &mstEdges,
                                          std::map<GNMGFID, GNMGFID> &mnPathTree)
 {
-    // Initialize all vertices in graph with infinity mark.
-    double dfInfinity = std::numeric_limits<double>::infinity();
+    mnPathTree[nFID] = -1;
+
+    BuildCSR();
+    const int iStart = GetCSRVertexIndex(nFID);
+    if (iStart < 0)
+        return;
+
+    std::vector<double> adfEdgeCosts;
+    GetCSREdgeCosts(mstEdges, adfEdgeCosts);
 
-    std::map<GNMGFID, double> mMarks;
-    std::map<GNMGFID, GNMStdVertex>::iterator itv;
-    for (itv = m_mstVertices.begin(); itv != m_mstVertices.end(); ++itv)
+    std::vector<double> adfMarks;
+    std::vector<int> anPredEdge;
+    std::vector<int> anPredVertex;
+    DijkstraCSR(iStart, -1, adfEdgeCosts, adfMarks, anPredEdge, anPredVertex);
+
+    for (size_t i = 0; i < anPredEdge.size(); ++i)
     {
-        mMarks[itv->first] = dfInfinity;
+        if (anPredEdge[i] >= 0)
+            mnPathTree[m_anCSRVertexFIDs[i]] = m_anCSREdgeFIDs[anPredEdge[i]];
     }
+}
 
-    mMarks[nFID] = 0.0;
-    mnPathTree[nFID] = -1;
+std::vector<GNMPATH> GNMGraph::DijkstraShortestPaths(
+                                                const GNMVECTOR &anStartFIDs,
+                                                const GNMVECTOR &anEndFIDs,
+                                                int nThreads)
+{
+    std::vector<GNMPATH> aoPaths(anStartFIDs.size() * anEndFIDs.size());
+    if (aoPaths.empty())
+        return aoPaths;
+
+    BuildCSR();
 
-    // Initialize all vertices as unseen (there are no seen vertices).
-    std::set<GNMGFID> snSeen;
+    if (nThreads <= 0)
+    {
+        const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+        nThreads = EQUAL(pszThreads, "ALL_CPUS") ? CPLGetNumCPUs()
+                                                 : atoi(pszThreads);
+    }
+    nThreads = std::max(1, std::min(128, nThreads));
+    nThreads = static_cast<int>(
+        std::min(static_cast<size_t>(nThreads), anStartFIDs.size()));
+
+    std::vector<GNMShortestPathsJob> asJobs(nThreads);
+    for (int i = 0; i < nThreads; ++i)
+    {
+        asJobs[i].poGraph = this;
+        asJobs[i].panStartFIDs = &anStartFIDs;
+        asJobs[i].panEndFIDs = &anEndFIDs;
+        asJobs[i].paoPaths = &aoPaths;
+        asJobs[i].nFirstStart = i;
+        asJobs[i].nStartStep = nThreads;
+    }
 
-    // We use multimap to maintain the ascending order of costs and because
-    // there can be different vertices with the equal cost.
-    std::multimap<double,GNMGFID> to_see;
-    std::multimap<double,GNMGFID>::iterator it;
-    to_see.insert(std::pair<double,GNMGFID>(0.0, nFID));
-    LPGNMCONSTVECTOR panOutcomeEdgeId;
+    CPLWorkerThreadPool oPool;
+    if (nThreads == 1 || !oPool.Setup(nThreads, nullptr, nullptr))
+    {
+        for (int i = 0; i < nThreads; ++i)
+            ShortestPathsJob(&asJobs[i]);
+    }
+    else
+    {
+        for (int i = 0; i < nThreads; ++i)
+            oPool.SubmitJob(ShortestPathsJob, &asJobs[i]);
+        oPool.WaitCompletion();
+    }
 
-    size_t i;
-    GNMGFID nCurrentVertId, nCurrentEdgeId, nTargetVertId;
-    double dfCurrentEdgeCost, dfCurrentVertMark, dfNewVertexMark;
-    std::map<GNMGFID, GNMStdEdge>::const_iterator ite;
+    return aoPaths;
+}
 
-    // Continue iterations while there are some vertices to see.
-    while (!to_see.empty())
+void GNMGraph::ShortestPathsJob(void* pData)
+{
+    GNMShortestPathsJob* psJob = static_cast<GNMShortestPathsJob*>(pData);
+    const GNMGraph* poGraph = psJob->poGraph;
+    const GNMVECTOR &anStartFIDs = *(psJob->panStartFIDs);
+    const GNMVECTOR &anEndFIDs = *(psJob->panEndFIDs);
+    std::vector<GNMPATH> &aoPaths = *(psJob->paoPaths);
+
+    std::vector<double> adfMarks;
+    std::vector<int> anPredEdge;
+    std::vector<int> anPredVertex;
+    for (size_t i = psJob->nFirstStart; i < anStartFIDs.size();
+         i += psJob->nStartStep)
     {
-        // We must see vertices with minimal costs at first.
-        // In multimap the first cost is the minimal.
-        it = to_see.begin();
-
-        nCurrentVertId = it->second;
-        dfCurrentVertMark = it->first;
-        snSeen.insert(it->second);
-        to_see.erase(it);
-
-        // For all neighbours for the current vertex.
-        panOutcomeEdgeId = GetOutEdges(nCurrentVertId);
-        if(nullptr == panOutcomeEdgeId)
+        const int iStart = poGraph->GetCSRVertexIndex(anStartFIDs[i]);
+        if (iStart < 0)
+        {
+            for (size_t j = 0; j < anEndFIDs.size(); ++j)
+            {
+                if (anEndFIDs[j] == anStartFIDs[i])
+                    aoPaths[i * anEndFIDs.size() + j].push_back(
+                                            std::make_pair(anStartFIDs[i], -1));
+            }
             continue;
+        }
 
-        for (i = 0; i < panOutcomeEdgeId->size(); ++i)
+        poGraph->DijkstraCSR(iStart, -1, poGraph->m_adfCSREdgeCosts,
+                             adfMarks, anPredEdge, anPredVertex);
+        for (size_t j = 0; j < anEndFIDs.size(); ++j)
         {
-            nCurrentEdgeId = panOutcomeEdgeId->operator[](i);
+            const int iEnd = poGraph->GetCSRVertexIndex(anEndFIDs[j]);
+            if (iEnd >= 0)
+                aoPaths[i * anEndFIDs.size() + j] =
+                    poGraph->GetCSRPath(iStart, iEnd, anPredEdge, anPredVertex);
+        }
+    }
+}
 
-            ite = mstEdges.find(nCurrentEdgeId);
-            if(ite == mstEdges.end() || ite->second.bIsBlocked)
+void GNMGraph::BuildCSR()
+{
+    if (!m_bCSRDirty)
+        return;
+
+    const double dfInfinity = std::numeric_limits<double>::infinity();
+
+    // Vertices and edges are numbered in the order of the maps, so that
+    // the FID arrays are sorted and can be searched by dichotomy.
+    m_anCSRVertexFIDs.clear();
+    m_anCSRVertexFIDs.reserve(m_mstVertices.size());
+    m_abCSRVertexBlocked.clear();
+    m_abCSRVertexBlocked.reserve(m_mstVertices.size());
+    for (std::map<GNMGFID, GNMStdVertex>::const_iterator itv =
+            m_mstVertices.begin(); itv != m_mstVertices.end(); ++itv)
+    {
+        m_anCSRVertexFIDs.push_back(itv->first);
+        m_abCSRVertexBlocked.push_back(itv->second.bIsBlocked);
+    }
+
+    std::vector<GNMGFID> anEdgeSrcFIDs;
+    std::vector<GNMGFID> anEdgeTgtFIDs;
+    anEdgeSrcFIDs.reserve(m_mstEdges.size());
+    anEdgeTgtFIDs.reserve(m_mstEdges.size());
+    m_anCSREdgeFIDs.clear();
+    m_anCSREdgeFIDs.reserve(m_mstEdges.size());
+    m_adfCSREdgeCosts.clear();
+    m_adfCSREdgeCosts.reserve(m_mstEdges.size());
+    for (std::map<GNMGFID, GNMStdEdge>::const_iterator ite =
+            m_mstEdges.begin(); ite != m_mstEdges.end(); ++ite)
+    {
+        m_anCSREdgeFIDs.push_back(ite->first);
+        m_adfCSREdgeCosts.push_back(ite->second.bIsBlocked ?
+                                        dfInfinity : ite->second.dfDirCost);
+        anEdgeSrcFIDs.push_back(ite->second.nSrcVertexFID);
+        anEdgeTgtFIDs.push_back(ite->second.nTgtVertexFID);
+    }
+
+    // Out edges keep the order of GNMStdVertex::anOutEdgeFIDs. Edges which
+    // no longer exist are skipped.
+    m_anCSROffsets.clear();
+    m_anCSROffsets.reserve(m_mstVertices.size() + 1);
+    m_anCSRTargets.clear();
+    m_anCSREdges.clear();
+    int iVertex = 0;
+    for (std::map<GNMGFID, GNMStdVertex>::const_iterator itv =
+            m_mstVertices.begin(); itv != m_mstVertices.end();
+            ++itv, ++iVertex)
+    {
+        m_anCSROffsets.push_back(static_cast<int>(m_anCSREdges.size()));
+        for (size_t i = 0; i < itv->second.anOutEdgeFIDs.size(); ++i)
+        {
+            const int iEdge = GetCSREdgeIndex(itv->second.anOutEdgeFIDs[i]);
+            if (iEdge < 0)
                 continue;
+            GNMGFID nTargetFID;
+            if (anEdgeSrcFIDs[iEdge] == itv->first)
+                nTargetFID = anEdgeTgtFIDs[iEdge];
+            else if (anEdgeTgtFIDs[iEdge] == itv->first)
+                nTargetFID = anEdgeSrcFIDs[iEdge];
+            else
+                continue;
+            const int iTarget = GetCSRVertexIndex(nTargetFID);
+            if (iTarget < 0)
+                continue;
+            m_anCSRTargets.push_back(iTarget);
+            m_anCSREdges.push_back(iEdge);
+        }
+    }
+    m_anCSROffsets.push_back(static_cast<int>(m_anCSREdges.size()));
 
-            // We go in any edge from source to target so we take only
-            // direct cost (even if an edge is bi-directed).
-            dfCurrentEdgeCost = ite->second.dfDirCost;
+    m_bCSRDirty = false;
+}
+
+int GNMGraph::GetCSRVertexIndex(GNMGFID nFID) const
+{
+    std::vector<GNMGFID>::const_iterator it =
+        std::lower_bound(m_anCSRVertexFIDs.begin(), m_anCSRVertexFIDs.end(),
+                         nFID);
+    if (it == m_anCSRVertexFIDs.end() || *it != nFID)
+        return -1;
+    return static_cast<int>(it - m_anCSRVertexFIDs.begin());
+}
 
-            // While we see outcome edges of current vertex id we definitely
-            // know that target vertex id will be target for current edge id.
-            nTargetVertId = GetOppositVertex(nCurrentEdgeId, nCurrentVertId);
+int GNMGraph::GetCSREdgeIndex(GNMGFID nFID) const
+{
+    std::vector<GNMGFID>::const_iterator it =
+        std::lower_bound(m_anCSREdgeFIDs.begin(), m_anCSREdgeFIDs.end(), nFID);
+    if (it == m_anCSREdgeFIDs.end() || *it != nFID)
+        return -1;
+    return static_cast<int>(it - m_anCSREdgeFIDs.begin());
+}
 
-            // Calculate a new mark assuming the full path cost (mark of the
-            // current vertex) to this vertex.
-            dfNewVertexMark = dfCurrentVertMark + dfCurrentEdgeCost;
+void GNMGraph::GetCSREdgeCosts(const std::map<GNMGFID, GNMStdEdge> &mstEdges,
+                               std::vector<double> &adfEdgeCosts) const
+{
+    // Edges missing from mstEdges or blocked get an infinity cost, which
+    // prevents DijkstraCSR() from going through them.
+    const double dfInfinity = std::numeric_limits<double>::infinity();
+    adfEdgeCosts.resize(m_anCSREdgeFIDs.size());
+    for (size_t i = 0; i < m_anCSREdgeFIDs.size(); ++i)
+    {
+        std::map<GNMGFID, GNMStdEdge>::const_iterator ite =
+            mstEdges.find(m_anCSREdgeFIDs[i]);
+        if (ite == mstEdges.end() || ite->second.bIsBlocked)
+            adfEdgeCosts[i] = dfInfinity;
+        else
+            adfEdgeCosts[i] = ite->second.dfDirCost;
+    }
+}
+
+void GNMGraph::DijkstraCSR(int iStart, int iEnd,
+                           const std::vector<double> &adfEdgeCosts,
+                           std::vector<double> &adfMarks,
+                           std::vector<int> &anPredEdge,
+                           std::vector<int> &anPredVertex) const
+{
+    // Initialize all vertices in graph with infinity mark.
+    const size_t nVertices = m_anCSRVertexFIDs.size();
+    adfMarks.assign(nVertices, std::numeric_limits<double>::infinity());
+    anPredEdge.assign(nVertices, -1);
+    anPredVertex.assign(nVertices, -1);
+    std::vector<bool> abSeen(nVertices, false);
+
+    // Binary heap of (mark, vertex index), with the minimal mark on top.
+    // Outdated items are skipped when they are popped.
+    typedef std::pair<double, int> MarkAndVertex;
+    std::priority_queue<MarkAndVertex, std::vector<MarkAndVertex>,
+                        std::greater<MarkAndVertex> > oToSee;
+    adfMarks[iStart] = 0.0;
+    oToSee.push(MarkAndVertex(0.0, iStart));
+
+    while (!oToSee.empty())
+    {
+        const double dfCurrentVertMark = oToSee.top().first;
+        const int iCurrentVert = oToSee.top().second;
+        oToSee.pop();
+        if (abSeen[iCurrentVert])
+            continue;
+        abSeen[iCurrentVert] = true;
+
+        // The mark of the end vertex will no longer change.
+        if (iCurrentVert == iEnd)
+            break;
+
+        for (int i = m_anCSROffsets[iCurrentVert];
+             i < m_anCSROffsets[iCurrentVert + 1]; ++i)
+        {
+            // We go in any edge from source to target so we take only
+            // direct cost (even if an edge is bi-directed).
+            const int iEdge = m_anCSREdges[i];
+            const int iTargetVert = m_anCSRTargets[i];
+            const double dfNewVertexMark =
+                dfCurrentVertMark + adfEdgeCosts[iEdge];
 
             // Update mark of the vertex if needed.
-            if (snSeen.find(nTargetVertId) == snSeen.end() &&
-                    dfNewVertexMark < mMarks[nTargetVertId] &&
-                    !CheckVertexBlocked(nTargetVertId))
+            if (!abSeen[iTargetVert] &&
+                dfNewVertexMark < adfMarks[iTargetVert] &&
+                !m_abCSRVertexBlocked[iTargetVert])
             {
-                mMarks[nTargetVertId] = dfNewVertexMark;
-                mnPathTree[nTargetVertId] = nCurrentEdgeId;
-
-                // The vertex with minimal cost will be inserted to the
-                // beginning.
-                to_see.insert(std::pair<double,GNMGFID>(dfNewVertexMark,
-                                                        nTargetVertId));
+                adfMarks[iTargetVert] = dfNewVertexMark;
+                anPredEdge[iTargetVert] = iEdge;
+                anPredVertex[iTargetVert] = iCurrentVert;
+                oToSee.push(MarkAndVertex(dfNewVertexMark, iTargetVert));
             }
         }
     }
 }
 
+GNMPATH GNMGraph::GetCSRPath(int iStart, int iEnd,
+                             const std::vector<int> &anPredEdge,
+                             const std::vector<int> &anPredVertex) const
+{
+    // We search for a path in the resulting tree, starting from end point to
+    // start point.
+    GNMPATH aoShortestPath;
+    int iVert = iEnd;
+    while (iVert != iStart)
+    {
+        if (anPredEdge[iVert] < 0)
+        {
+            // There is no path between the two given vertices.
+            return GNMPATH();
+        }
+        aoShortestPath.push_back(std::make_pair(
+            m_anCSRVertexFIDs[iVert], m_anCSREdgeFIDs[anPredEdge[iVert]]));
+        iVert = anPredVertex[iVert];
+    }
+    aoShortestPath.push_back(std::make_pair(m_anCSRVertexFIDs[iStart], -1));
+
+    // Revert array because the first vertex is now the last in path.
+    std::reverse(aoShortestPath.begin(), aoShortestPath.end());
+    return aoShortestPath;
+}
+
+GNMPATH GNMGraph::DijkstraShortestPathCSR(GNMGFID nStartFID, GNMGFID nEndFID,
+                                const std::vector<double> &adfEdgeCosts) const
+{
+    const int iStart = GetCSRVertexIndex(nStartFID);
+    if (iStart < 0)
+    {
+        GNMPATH aoShortestPath;
+        if (nStartFID == nEndFID)
+            aoShortestPath.push_back(std::make_pair(nStartFID, -1));
+        return aoShortestPath;
+    }
+    const int iEnd = GetCSRVertexIndex(nEndFID);
+    if (iEnd < 0)
+        return GNMPATH();
+
+    std::vector<double> adfMarks;
+    std::vector<int> anPredEdge;
+    std::vector<int> anPredVertex;
+    DijkstraCSR(iStart, iEnd, adfEdgeCosts, adfMarks, anPredEdge,
+                anPredVertex);
+    return GetCSRPath(iStart, iEnd, anPredEdge, anPredVertex);
+}
+
 LPGNMCONSTVECTOR GNMGraph::GetOutEdges(GNMGFID nFID) const
 {
     std::map<GNMGFID,GNMStdVertex>::const_iterator it = m_mstVertices.find(nFID);
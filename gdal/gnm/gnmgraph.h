@@ -83,6 +83,10 @@ struct GNMStdVertex
  * NOTE: GNMGraph holds the whole graph in memory, so it can consume
  * a lot of memory if operating huge networks.
  *
+ * Since GDAL 3.4, the routing methods run on a compact, index based
+ * (compressed sparse row) copy of the graph, which is rebuilt lazily after
+ * the graph has been modified.
+ *
  * @since GDAL 2.1
  */
 
@@ -195,6 +199,28 @@ public:
     virtual std::vector<GNMPATH> KShortestPaths(GNMGFID nStartFID,
                                                 GNMGFID nEndFID, size_t nK);
 
+    /**
+     * @brief Many-to-many shortest paths.
+     *
+     * Computes the Dijkstra shortest path between each vertex of
+     * anStartFIDs and each vertex of anEndFIDs. One shortest path tree is
+     * built per start vertex, and the trees are computed in parallel.
+     *
+     * @param anStartFIDs Start vertex identificators.
+     * @param anEndFIDs End vertex identificators.
+     * @param nThreads Number of worker threads. If 0, the value of the
+     * GDAL_NUM_THREADS configuration option is used (or 1 if it is not set).
+     * @return an array of anStartFIDs.size() * anEndFIDs.size() paths, where
+     * the path from anStartFIDs[i] to anEndFIDs[j] is at index
+     * i * anEndFIDs.size() + j, with the same layout as the result of
+     * DijkstraShortestPath(). Paths between unconnected vertices are empty.
+     * @since GDAL 3.4
+     */
+    virtual std::vector<GNMPATH> DijkstraShortestPaths(
+                                            const GNMVECTOR &anStartFIDs,
+                                            const GNMVECTOR &anEndFIDs,
+                                            int nThreads = 0);
+
     /**
      * @brief Search connected components of the network
      *
@@ -244,6 +270,35 @@ protected:
 protected:
     std::map<GNMGFID, GNMStdVertex> m_mstVertices;
     std::map<GNMGFID, GNMStdEdge>   m_mstEdges;
+
+private:
+    void BuildCSR();
+    int GetCSRVertexIndex(GNMGFID nFID) const;
+    int GetCSREdgeIndex(GNMGFID nFID) const;
+    void GetCSREdgeCosts(const std::map<GNMGFID, GNMStdEdge> &mstEdges,
+                         std::vector<double> &adfEdgeCosts) const;
+    void DijkstraCSR(int iStart, int iEnd,
+                     const std::vector<double> &adfEdgeCosts,
+                     std::vector<double> &adfMarks,
+                     std::vector<int> &anPredEdge,
+                     std::vector<int> &anPredVertex) const;
+    GNMPATH GetCSRPath(int iStart, int iEnd,
+                       const std::vector<int> &anPredEdge,
+                       const std::vector<int> &anPredVertex) const;
+    GNMPATH DijkstraShortestPathCSR(GNMGFID nStartFID, GNMGFID nEndFID,
+                               const std::vector<double> &adfEdgeCosts) const;
+    static void ShortestPathsJob(void* pData);
+
+    // Compressed sparse row copy of m_mstVertices / m_mstEdges, where
+    // vertices and edges are referenced by their rank in the maps.
+    bool m_bCSRDirty = true;
+    std::vector<GNMGFID> m_anCSRVertexFIDs{};
+    std::vector<bool>    m_abCSRVertexBlocked{};
+    std::vector<int>     m_anCSROffsets{};      // nVertices + 1 items
+    std::vector<int>     m_anCSRTargets{};      // target vertex of out edge
+    std::vector<int>     m_anCSREdges{};        // edge index of out edge
+    std::vector<GNMGFID> m_anCSREdgeFIDs{};
+    std::vector<double>  m_adfCSREdgeCosts{};   // infinity if blocked
 //! @endcond
 };
 
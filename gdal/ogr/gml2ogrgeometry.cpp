@@ -257,6 +257,66 @@ static bool AddPoint( OGRGeometry *poGeometry,
     return false;
 }
 
+/************************************************************************/
+/*                       ParsePosListIntoCurve()                        */
+/*                                                                      */
+/*      Count the values of a <posList> first, so that the points are   */
+/*      allocated once and directly written in the curve.               */
+/************************************************************************/
+
+static bool ParsePosListIntoCurve( OGRSimpleCurve* poCurve,
+                                   const char* pszPosList, int nDimension )
+{
+    int nValues = 0;
+    const char* pszCur = pszPosList;
+    while( pszCur != nullptr &&
+           GMLGetCoordTokenPos(pszCur, &pszCur) != nullptr )
+    {
+        if( nValues == INT_MAX )
+            break;
+        nValues++;
+    }
+
+    if( nValues == 0 || (nValues % nDimension) != 0 )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Did not get at least %d values or invalid number of "
+                  "set of coordinates <gml:posList>%s</gml:posList>",
+                  nDimension, pszPosList);
+        return false;
+    }
+
+    const int nOldPoints = poCurve->getNumPoints();
+    const int nNewPoints = nValues / nDimension;
+    if( nNewPoints > INT_MAX - nOldPoints )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Too many points");
+        return false;
+    }
+    poCurve->setNumPoints(nOldPoints + nNewPoints, FALSE);
+    if( poCurve->getNumPoints() != nOldPoints + nNewPoints )
+        return false;
+
+    pszCur = pszPosList;
+    for( int i = 0; i < nNewPoints; i++ )
+    {
+        const double dfX = OGRFastAtof(GMLGetCoordTokenPos(pszCur, &pszCur));
+        const double dfY = OGRFastAtof(GMLGetCoordTokenPos(pszCur, &pszCur));
+        if( nDimension == 3 )
+        {
+            const double dfZ =
+                OGRFastAtof(GMLGetCoordTokenPos(pszCur, &pszCur));
+            poCurve->setPoint(nOldPoints + i, dfX, dfY, dfZ);
+        }
+        else
+        {
+            poCurve->setPoint(nOldPoints + i, dfX, dfY);
+        }
+    }
+
+    return true;
+}
+
 /************************************************************************/
 /*                        ParseGMLCoordinates()                         */
 /************************************************************************/
@@ -582,6 +642,14 @@ static bool ParseGMLCoordinates( const CPLXMLNode *psGeomNode,
             return true;
         }
 
+        const OGRwkbGeometryType eType =
+            wkbFlatten(poGeometry->getGeometryType());
+        if( eType == wkbLineString || eType == wkbCircularString )
+        {
+            return ParsePosListIntoCurve(poGeometry->toSimpleCurve(),
+                                         pszPosList, nDimension);
+        }
+
         bool bSuccess = false;
         const char* pszCur = pszPosList;
         while( true )
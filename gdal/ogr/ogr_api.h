@@ -609,6 +609,18 @@ void     CPL_DLL OGR_L_SetSpatialFilterRectEx( OGRLayerH, int iGeomField,
 OGRErr CPL_DLL OGR_L_SetAttributeFilter( OGRLayerH, const char * );
 void   CPL_DLL OGR_L_ResetReading( OGRLayerH );
 OGRFeatureH CPL_DLL OGR_L_GetNextFeature( OGRLayerH ) CPL_WARN_UNUSED_RESULT;
+/*! @cond Doxygen_Suppress */
+struct ArrowArrayStream;
+struct ArrowSchema;
+struct ArrowArray;
+/*! @endcond */
+bool CPL_DLL OGR_L_GetArrowStream( OGRLayerH hLayer,
+                                   struct ArrowArrayStream* out_stream,
+                                   char** papszOptions );
+bool CPL_DLL OGR_L_WriteArrowBatch( OGRLayerH hLayer,
+                                    const struct ArrowSchema* schema,
+                                    const struct ArrowArray* array,
+                                    char** papszOptions );
 
 /*! @endcond */
 
@@ -690,6 +702,7 @@ GIntBig CPL_DLL OGR_L_GetFeaturesRead( OGRLayerH );
 /*! @endcond */
 const char CPL_DLL *OGR_L_GetFIDColumn( OGRLayerH );
 const char CPL_DLL *OGR_L_GetGeometryColumn( OGRLayerH );
+GIntBig CPL_DLL OGR_L_GetMemoryUsage( OGRLayerH );
 /** Get style table */
 OGRStyleTableH CPL_DLL OGR_L_GetStyleTable( OGRLayerH );
 /** Set style table (and take ownership) */
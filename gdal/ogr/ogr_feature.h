@@ -1122,6 +1122,10 @@ class CPL_DLL OGRFeatureQuery
     OGRFeatureDefn *poTargetDefn;
     void           *pSWQExpr;
 
+    struct Program;
+    std::unique_ptr<Program> poProgram;
+    void        CompileProgram();
+
     char      **FieldCollector( void *, char ** );
 
     GIntBig    *EvaluateAgainstIndices( swq_expr_node*, OGRLayer *,
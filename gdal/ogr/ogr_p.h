@@ -86,6 +86,9 @@ const char CPL_DLL * OGRWktReadPointsM( const char * pszInput,
                                         int * pnMaxPoints,
                                         int * pnReadPoints );
 
+bool CPL_DLL OGRWKTGetBoundingBox( const char* pszWKT,
+                                   OGREnvelope& sEnvelope );
+
 void CPL_DLL OGRMakeWktCoordinate( char *, double, double, double, int );
 std::string CPL_DLL OGRMakeWktCoordinate(double, double, double, int, OGRWktOptions opts );
 void CPL_DLL OGRMakeWktCoordinateM( char *, double, double, double, double, OGRBoolean, OGRBoolean );
@@ -170,6 +173,17 @@ OGRGeometry CPL_DLL *OGRGeometryFromHexEWKB( const char *pszBytea, int* pnSRID,
 char CPL_DLL * OGRGeometryToHexEWKB( OGRGeometry * poGeometry, int nSRSId,
                                      int nPostGISMajor, int nPostGISMinor );
 
+/************************************************************************/
+/*                      Coordinate transformation                       */
+/************************************************************************/
+
+OGRErr OGRSimpleCurveSetTransformedPoints( OGRSimpleCurve* poCurve,
+                                           int nPointCount,
+                                           double* padfX, double* padfY,
+                                           double* padfZ,
+                                           const int* pabSuccess );
+void OGRLinearRingRestoreClosure( OGRLinearRing* poRing );
+
 /************************************************************************/
 /*                        WKB Type Handling encoding                    */
 /************************************************************************/
@@ -40,6 +40,8 @@
 #include <unistd.h>
 #endif
 
+#include <limits>
+#include <map>
 #include <mutex>
 #include <vector>
 
@@ -246,50 +248,271 @@ struct OSRPJDeleter
     void operator()(PJ* pj) const { proj_destroy(pj); }
 };
 
+/************************************************************************/
+/*                        Interned CRS objects                          */
+/************************************************************************/
+
+// Process-wide cache of CRS objects, shared by all threads, behind the
+// per-thread OSRProjTLSCache. As PJ objects are bound to a PROJ context, the
+// cached objects are attached to a context owned by this cache, and cloned
+// into the context of the calling thread. proj_clone() only does a shallow
+// copy of the underlying immutable object.
+//
+// Each cached object is also given the identifier of its canonical
+// definition, that is its WKT2:2019 export, so that objects imported from
+// equivalent definitions (e.g. "EPSG:4326" and its WKT) can be compared
+// without calling proj_is_equivalent_to(). Identifiers are never reused, so
+// the table of definitions can be flushed at any time.
+
+namespace {
+struct OSRInternedCRS
+{
+    std::shared_ptr<PJ> pj{};
+    int nCanonicalId = 0;
+};
+} // namespace
+
+static std::mutex g_oInternedCRSMutex;
+static PJ_CONTEXT* g_pInternedCRSContext = nullptr;
+static lru11::Cache<std::string, OSRInternedCRS>* g_poInternedCRSCache = nullptr;
+static std::map<std::string, int>* g_poCanonicalCRSIds = nullptr;
+static std::map<int, std::pair<std::string, bool>>* g_poCanonicalCRSWKT1 = nullptr;
+static int g_nLastCanonicalCRSId = 0;
+constexpr size_t MAX_CANONICAL_CRS_IDS = 1000;
+
+static std::string OSRGetInternedCRSKeyForEPSGCode(int nCode,
+                                                   bool bUseNonDeprecated,
+                                                   bool bAddTOWGS84)
+{
+    return CPLSPrintf("EPSG:%d:%d:%d", nCode, bUseNonDeprecated ? 1 : 0,
+                      bAddTOWGS84 ? 1 : 0);
+}
+
+static PJ* OSRGetInternedCRS(PJ_CONTEXT* ctx, const std::string& osKey,
+                             int* pnCanonicalId)
+{
+    std::lock_guard<std::mutex> oLock(g_oInternedCRSMutex);
+    if( g_poInternedCRSCache == nullptr )
+        return nullptr;
+    try
+    {
+        const auto& cached = g_poInternedCRSCache->get(osKey);
+        if( pnCanonicalId )
+            *pnCanonicalId = cached.nCanonicalId;
+        return proj_clone(ctx, cached.pj.get());
+    }
+    catch( const lru11::KeyNotFound& )
+    {
+        return nullptr;
+    }
+}
+
+static void OSRInternCRS(const std::string& osKey, const PJ* pj,
+                         int nCanonicalId)
+{
+    std::lock_guard<std::mutex> oLock(g_oInternedCRSMutex);
+    if( g_poInternedCRSCache == nullptr )
+    {
+        g_pInternedCRSContext = proj_context_create();
+        g_poInternedCRSCache =
+            new lru11::Cache<std::string, OSRInternedCRS>(1000);
+    }
+    OSRInternedCRS oEntry;
+    oEntry.pj.reset(proj_clone(g_pInternedCRSContext, pj), OSRPJDeleter());
+    oEntry.nCanonicalId = nCanonicalId;
+    if( oEntry.pj )
+        g_poInternedCRSCache->insert(osKey, oEntry);
+}
+
+/************************************************************************/
+/*                        OSRGetCanonicalCRSId()                        */
+/************************************************************************/
+
+/** Return a strictly positive identifier shared by all CRS objects with
+ * the same WKT2:2019 definition, or 0 if it cannot be computed. */
+int OSRGetCanonicalCRSId(PJ_CONTEXT* ctx, const PJ* pj)
+{
+    const char* pszWKT;
+    {
+        CPLErrorStateBackuper oErrorStateBackuper;
+        CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
+        pszWKT = proj_as_wkt(ctx, pj, PJ_WKT2_2019, nullptr);
+    }
+    if( pszWKT == nullptr )
+        return 0;
+
+    std::lock_guard<std::mutex> oLock(g_oInternedCRSMutex);
+    if( g_poCanonicalCRSIds == nullptr )
+    {
+        g_poCanonicalCRSIds = new std::map<std::string, int>();
+        g_poCanonicalCRSWKT1 = new std::map<int, std::pair<std::string, bool>>();
+    }
+    const auto oIter = g_poCanonicalCRSIds->find(pszWKT);
+    if( oIter != g_poCanonicalCRSIds->end() )
+        return oIter->second;
+    if( g_poCanonicalCRSIds->size() == MAX_CANONICAL_CRS_IDS )
+    {
+        g_poCanonicalCRSIds->clear();
+        g_poCanonicalCRSWKT1->clear();
+    }
+    if( g_nLastCanonicalCRSId == std::numeric_limits<int>::max() / 2 )
+        return 0;
+    ++g_nLastCanonicalCRSId;
+    (*g_poCanonicalCRSIds)[pszWKT] = g_nLastCanonicalCRSId;
+    return g_nLastCanonicalCRSId;
+}
+
+/************************************************************************/
+/*                       OSRGetCanonicalCRSWKT1()                       */
+/************************************************************************/
+
+/** Return the WKT1 (GDAL or ESRI flavor) export of a canonical CRS, as
+ * previously stored with OSRSetCanonicalCRSWKT1(). bWKT2 is set when WKT1
+ * export was not possible and WKT2 was used instead. */
+bool OSRGetCanonicalCRSWKT1(int nCanonicalId, bool bESRI,
+                            std::string& osWKT, bool& bWKT2)
+{
+    std::lock_guard<std::mutex> oLock(g_oInternedCRSMutex);
+    if( g_poCanonicalCRSWKT1 == nullptr )
+        return false;
+    const auto oIter =
+        g_poCanonicalCRSWKT1->find(nCanonicalId * 2 + (bESRI ? 1 : 0));
+    if( oIter == g_poCanonicalCRSWKT1->end() )
+        return false;
+    osWKT = oIter->second.first;
+    bWKT2 = oIter->second.second;
+    return true;
+}
+
+/************************************************************************/
+/*                       OSRSetCanonicalCRSWKT1()                       */
+/************************************************************************/
+
+void OSRSetCanonicalCRSWKT1(int nCanonicalId, bool bESRI,
+                            const std::string& osWKT, bool bWKT2)
+{
+    std::lock_guard<std::mutex> oLock(g_oInternedCRSMutex);
+    // Bound memory usage. The table is flushed with the identifiers.
+    if( g_poCanonicalCRSWKT1 == nullptr ||
+        g_poCanonicalCRSWKT1->size() >= 2 * MAX_CANONICAL_CRS_IDS )
+        return;
+    (*g_poCanonicalCRSWKT1)[nCanonicalId * 2 + (bESRI ? 1 : 0)] =
+        std::pair<std::string, bool>(osWKT, bWKT2);
+}
+
+/************************************************************************/
+/*                        OSRCleanupInternedCRS()                       */
+/************************************************************************/
+
+void OSRCleanupInternedCRS()
+{
+    std::lock_guard<std::mutex> oLock(g_oInternedCRSMutex);
+    // Objects must be destroyed before their context
+    delete g_poInternedCRSCache;
+    g_poInternedCRSCache = nullptr;
+    if( g_pInternedCRSContext )
+        proj_context_destroy(g_pInternedCRSContext);
+    g_pInternedCRSContext = nullptr;
+    delete g_poCanonicalCRSIds;
+    g_poCanonicalCRSIds = nullptr;
+    delete g_poCanonicalCRSWKT1;
+    g_poCanonicalCRSWKT1 = nullptr;
+}
+
+/************************************************************************/
+/*                          OSRProjTLSCache                             */
+/************************************************************************/
+
 void OSRProjTLSCache::clear()
 {
     m_oCacheEPSG.clear();
     m_oCacheWKT.clear();
 }
 
-PJ* OSRProjTLSCache::GetPJForEPSGCode(int nCode, bool bUseNonDeprecated, bool bAddTOWGS84)
+PJ* OSRProjTLSCache::GetPJForEPSGCode(int nCode, bool bUseNonDeprecated, bool bAddTOWGS84,
+                                      int* pnCanonicalId)
 {
+    const EPSGCacheKey key(nCode, bUseNonDeprecated, bAddTOWGS84);
     try
     {
-        const EPSGCacheKey key(nCode, bUseNonDeprecated, bAddTOWGS84);
         const auto& cached = m_oCacheEPSG.get(key);
-        return proj_clone(OSRGetProjTLSContext(), cached.get());
+        if( pnCanonicalId )
+            *pnCanonicalId = cached.second;
+        return proj_clone(OSRGetProjTLSContext(), cached.first.get());
     }
     catch( const lru11::KeyNotFound& )
     {
-        return nullptr;
     }
+
+    // Object created by another thread ?
+    int nCanonicalId = 0;
+    auto pj = OSRGetInternedCRS(OSRGetProjTLSContext(),
+        OSRGetInternedCRSKeyForEPSGCode(nCode, bUseNonDeprecated, bAddTOWGS84),
+        &nCanonicalId);
+    if( pj )
+    {
+        m_oCacheEPSG.insert(key, CachedPJ(std::shared_ptr<PJ>(
+            proj_clone(OSRGetProjTLSContext(), pj), OSRPJDeleter()),
+            nCanonicalId));
+        if( pnCanonicalId )
+            *pnCanonicalId = nCanonicalId;
+    }
+    return pj;
 }
 
-void OSRProjTLSCache::CachePJForEPSGCode(int nCode, bool bUseNonDeprecated, bool bAddTOWGS84, PJ* pj)
+void OSRProjTLSCache::CachePJForEPSGCode(int nCode, bool bUseNonDeprecated, bool bAddTOWGS84, PJ* pj,
+                                         int* pnCanonicalId)
 {
     const EPSGCacheKey key(nCode, bUseNonDeprecated, bAddTOWGS84);
-    m_oCacheEPSG.insert(key, std::shared_ptr<PJ>(
-                    proj_clone(OSRGetProjTLSContext(), pj), OSRPJDeleter()));
+    const int nCanonicalId = OSRGetCanonicalCRSId(OSRGetProjTLSContext(), pj);
+    m_oCacheEPSG.insert(key, CachedPJ(std::shared_ptr<PJ>(
+                    proj_clone(OSRGetProjTLSContext(), pj), OSRPJDeleter()),
+                    nCanonicalId));
+    OSRInternCRS(
+        OSRGetInternedCRSKeyForEPSGCode(nCode, bUseNonDeprecated, bAddTOWGS84),
+        pj, nCanonicalId);
+    if( pnCanonicalId )
+        *pnCanonicalId = nCanonicalId;
 }
 
-PJ* OSRProjTLSCache::GetPJForWKT(const std::string& wkt)
+PJ* OSRProjTLSCache::GetPJForWKT(const std::string& wkt, int* pnCanonicalId)
 {
     try
     {
         const auto& cached = m_oCacheWKT.get(wkt);
-        return proj_clone(OSRGetProjTLSContext(), cached.get());
+        if( pnCanonicalId )
+            *pnCanonicalId = cached.second;
+        return proj_clone(OSRGetProjTLSContext(), cached.first.get());
     }
     catch( const lru11::KeyNotFound& )
     {
-        return nullptr;
     }
+
+    // Object created by another thread ?
+    int nCanonicalId = 0;
+    auto pj = OSRGetInternedCRS(OSRGetProjTLSContext(), "WKT:" + wkt,
+                                &nCanonicalId);
+    if( pj )
+    {
+        m_oCacheWKT.insert(wkt, CachedPJ(std::shared_ptr<PJ>(
+            proj_clone(OSRGetProjTLSContext(), pj), OSRPJDeleter()),
+            nCanonicalId));
+        if( pnCanonicalId )
+            *pnCanonicalId = nCanonicalId;
+    }
+    return pj;
 }
 
-void OSRProjTLSCache::CachePJForWKT(const std::string& wkt, PJ* pj)
+void OSRProjTLSCache::CachePJForWKT(const std::string& wkt, PJ* pj,
+                                    int* pnCanonicalId)
 {
-    m_oCacheWKT.insert(wkt, std::shared_ptr<PJ>(
-                    proj_clone(OSRGetProjTLSContext(), pj), OSRPJDeleter()));
+    const int nCanonicalId = OSRGetCanonicalCRSId(OSRGetProjTLSContext(), pj);
+    m_oCacheWKT.insert(wkt, CachedPJ(std::shared_ptr<PJ>(
+                    proj_clone(OSRGetProjTLSContext(), pj), OSRPJDeleter()),
+                    nCanonicalId));
+    OSRInternCRS("WKT:" + wkt, pj, nCanonicalId);
+    if( pnCanonicalId )
+        *pnCanonicalId = nCanonicalId;
 }
 
 /************************************************************************/
@@ -314,6 +537,8 @@ void OSRCleanupTLSContext()
  */
 void OSRSetPROJSearchPaths( const char* const * papszPaths )
 {
+    // Interned CRS objects might no longer match the database
+    OSRCleanupInternedCRS();
     std::lock_guard<std::mutex> oLock(g_oSearchPathMutex);
     g_searchPathGenerationCounter ++;
     g_aosSearchpaths.Assign(CSLDuplicate(papszPaths), true);
@@ -359,6 +584,8 @@ char** OSRGetPROJSearchPaths()
  */
 void OSRSetPROJAuxDbPaths( const char* const * papszAux )
 {
+    // Interned CRS objects might no longer match the database
+    OSRCleanupInternedCRS();
     std::lock_guard<std::mutex> oLock(g_oSearchPathMutex);
     g_auxDbPathsGenerationCounter ++;
     g_aosAuxDbPaths.Assign(CSLDuplicate(papszAux), true);
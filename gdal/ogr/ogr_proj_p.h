@@ -35,6 +35,7 @@
 
 #include <unordered_map>
 #include <memory>
+#include <string>
 #include <utility>
 
 /*! @cond Doxygen_Suppress */
@@ -70,29 +71,43 @@ class OSRProjTLSCache
             }
         };
 
-        lru11::Cache<EPSGCacheKey, std::shared_ptr<PJ>,
+        // Cached object, and identifier of its canonical definition (0 if
+        // unknown). See OSRGetCanonicalCRSId()
+        typedef std::pair<std::shared_ptr<PJ>, int> CachedPJ;
+
+        lru11::Cache<EPSGCacheKey, CachedPJ,
                      lru11::NullLock,
                       std::unordered_map<
                         EPSGCacheKey,
                         typename std::list<lru11::KeyValuePair<EPSGCacheKey,
-                            std::shared_ptr<PJ>>>::iterator,
+                            CachedPJ>>::iterator,
                             EPSGCacheKeyHasher>> m_oCacheEPSG{};
-        lru11::Cache<std::string, std::shared_ptr<PJ>> m_oCacheWKT{};
+        lru11::Cache<std::string, CachedPJ> m_oCacheWKT{};
 
     public:
         OSRProjTLSCache() = default;
 
         void clear();
 
-        PJ* GetPJForEPSGCode(int nCode, bool bUseNonDeprecated, bool bAddTOWGS84);
-        void CachePJForEPSGCode(int nCode, bool bUseNonDeprecated, bool bAddTOWGS84, PJ* pj);
+        PJ* GetPJForEPSGCode(int nCode, bool bUseNonDeprecated, bool bAddTOWGS84,
+                             int* pnCanonicalId = nullptr);
+        void CachePJForEPSGCode(int nCode, bool bUseNonDeprecated, bool bAddTOWGS84, PJ* pj,
+                                int* pnCanonicalId = nullptr);
 
-        PJ* GetPJForWKT(const std::string& wkt);
-        void CachePJForWKT(const std::string& wkt, PJ* pj);
+        PJ* GetPJForWKT(const std::string& wkt, int* pnCanonicalId = nullptr);
+        void CachePJForWKT(const std::string& wkt, PJ* pj,
+                           int* pnCanonicalId = nullptr);
 };
 
 OSRProjTLSCache* OSRGetProjTLSCache();
 
+int OSRGetCanonicalCRSId(PJ_CONTEXT* ctx, const PJ* pj);
+bool OSRGetCanonicalCRSWKT1(int nCanonicalId, bool bESRI,
+                            std::string& osWKT, bool& bWKT2);
+void OSRSetCanonicalCRSWKT1(int nCanonicalId, bool bESRI,
+                            const std::string& osWKT, bool bWKT2);
+void OSRCleanupInternedCRS();
+
 void OGRCTDumpStatistics();
 
 void OSRCTCleanCache();
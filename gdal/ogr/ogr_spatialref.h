@@ -725,6 +725,8 @@ class CPL_DLL OGRSpatialReference
 /*      implementation.                                                 */
 /************************************************************************/
 
+class OGRGeometry;
+
 /**
  * Interface for transforming between coordinate systems.
  *
@@ -819,6 +821,9 @@ public:
                                          double *z, double *t,
                                          int *panErrorCodes );
 
+    int TransformGeometries( int nCount, OGRGeometry* const* papoGeoms,
+                             OGRErr* paeErrors = nullptr );
+
     /** Convert a OGRCoordinateTransformation* to a OGRCoordinateTransformationH.
      * @since GDAL 2.3
      */
@@ -0,0 +1,414 @@
+/******************************************************************************
+ *
+ * Project:  OGR
+ * Purpose:  WKB geometry related methods, working directly on WKB buffers
+ *           without instantiating OGRGeometry objects.
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_wkb.h"
+#include "ogr_geometry.h"
+#include "ogr_p.h"
+
+#include <cmath>
+#include <cstring>
+
+CPL_CVSID("$Id$")
+
+// Maximum nesting level of collections
+constexpr int MAX_WKB_RECURSION_LEVEL = 32;
+
+/************************************************************************/
+/*                          OGRWKBReadHeader()                          */
+/************************************************************************/
+
+static bool OGRWKBReadHeader(const GByte* pabyWkb, size_t nWKBSize,
+                             OGRwkbGeometryType& eGeometryType,
+                             bool& bNeedSwap, int& nCoordDimension)
+{
+    if( nWKBSize < 5 )
+        return false;
+    if( OGRReadWKBGeometryType(pabyWkb, wkbVariantIso,
+                               &eGeometryType) != OGRERR_NONE )
+        return false;
+    const int nByteOrder = DB2_V72_FIX_BYTE_ORDER(pabyWkb[0]);
+    bNeedSwap = OGR_SWAP(static_cast<OGRwkbByteOrder>(nByteOrder));
+    nCoordDimension = 2 + (wkbHasZ(eGeometryType) ? 1 : 0) +
+                          (wkbHasM(eGeometryType) ? 1 : 0);
+    return true;
+}
+
+/************************************************************************/
+/*                             ReadUInt32()                             */
+/************************************************************************/
+
+static inline GUInt32 ReadUInt32(const GByte* pabyData, bool bNeedSwap)
+{
+    GUInt32 nVal;
+    memcpy(&nVal, pabyData, sizeof(nVal));
+    if( bNeedSwap )
+        CPL_SWAP32PTR(&nVal);
+    return nVal;
+}
+
+/************************************************************************/
+/*                             ReadDouble()                             */
+/************************************************************************/
+
+static inline double ReadDouble(const GByte* pabyData, bool bNeedSwap)
+{
+    double dfVal;
+    memcpy(&dfVal, pabyData, sizeof(dfVal));
+    if( bNeedSwap )
+        CPL_SWAP64PTR(&dfVal);
+    return dfVal;
+}
+
+/************************************************************************/
+/*                         OGRWKBGetGeomType()                          */
+/************************************************************************/
+
+/** Return the geometry type (with its Z/M flags) of a WKB geometry.
+ *
+ * @return true in case of success.
+ */
+bool OGRWKBGetGeomType(const GByte* pabyWkb, size_t nWKBSize,
+                       OGRwkbGeometryType& eGeometryType)
+{
+    bool bNeedSwap = false;
+    int nCoordDimension = 0;
+    return OGRWKBReadHeader(pabyWkb, nWKBSize, eGeometryType,
+                            bNeedSwap, nCoordDimension);
+}
+
+/************************************************************************/
+/*                     OGRWKBMergePointSequence()                       */
+/************************************************************************/
+
+// pabyWkb + nOffset points to the number of points of the sequence. On
+// success, nOffset is advanced after the last point. If psEnvelope is null,
+// the sequence is just skipped. For circular strings, the envelope of the
+// full circle of each arc is merged, which is a conservative approximation.
+static bool OGRWKBMergePointSequence(const GByte* pabyWkb, size_t nWKBSize,
+                                     size_t& nOffset, bool bNeedSwap,
+                                     int nCoordDimension, bool bIsCircular,
+                                     OGREnvelope* psEnvelope)
+{
+    if( nWKBSize - nOffset < 4 )
+        return false;
+    const GUInt32 nPoints = ReadUInt32(pabyWkb + nOffset, bNeedSwap);
+    nOffset += 4;
+    const size_t nPointSize = 8 * static_cast<size_t>(nCoordDimension);
+    if( nPoints > (nWKBSize - nOffset) / nPointSize )
+        return false;
+    if( psEnvelope == nullptr )
+    {
+        nOffset += nPoints * nPointSize;
+        return true;
+    }
+    const GByte* pabyPoints = pabyWkb + nOffset;
+    for( GUInt32 i = 0; i < nPoints; ++i )
+    {
+        const double dfX = ReadDouble(pabyWkb + nOffset, bNeedSwap);
+        const double dfY = ReadDouble(pabyWkb + nOffset + 8, bNeedSwap);
+        psEnvelope->Merge(dfX, dfY);
+        nOffset += nPointSize;
+    }
+    if( bIsCircular )
+    {
+        for( GUInt32 i = 0; i + 2 < nPoints; i += 2 )
+        {
+            const GByte* pabyArc = pabyPoints + i * nPointSize;
+            double R = 0.0;
+            double cx = 0.0;
+            double cy = 0.0;
+            double alpha0 = 0.0;
+            double alpha1 = 0.0;
+            double alpha2 = 0.0;
+            if( OGRGeometryFactory::GetCurveParameters(
+                    ReadDouble(pabyArc, bNeedSwap),
+                    ReadDouble(pabyArc + 8, bNeedSwap),
+                    ReadDouble(pabyArc + nPointSize, bNeedSwap),
+                    ReadDouble(pabyArc + nPointSize + 8, bNeedSwap),
+                    ReadDouble(pabyArc + 2 * nPointSize, bNeedSwap),
+                    ReadDouble(pabyArc + 2 * nPointSize + 8, bNeedSwap),
+                    R, cx, cy, alpha0, alpha1, alpha2) )
+            {
+                psEnvelope->Merge(cx - R, cy - R);
+                psEnvelope->Merge(cx + R, cy + R);
+            }
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                   OGRWKBGetBoundingBoxInternal()                     */
+/************************************************************************/
+
+// On success, nOffset is advanced after the geometry.
+static bool OGRWKBGetBoundingBoxInternal(const GByte* pabyWkb,
+                                         size_t nWKBSize, size_t& nOffset,
+                                         int nRecLevel,
+                                         OGREnvelope& sEnvelope)
+{
+    if( nRecLevel == MAX_WKB_RECURSION_LEVEL )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Too many recursion levels (%d) while parsing WKB geometry.",
+                 MAX_WKB_RECURSION_LEVEL);
+        return false;
+    }
+
+    OGRwkbGeometryType eGeometryType = wkbUnknown;
+    bool bNeedSwap = false;
+    int nCoordDimension = 2;
+    if( !OGRWKBReadHeader(pabyWkb + nOffset, nWKBSize - nOffset,
+                          eGeometryType, bNeedSwap, nCoordDimension) )
+    {
+        return false;
+    }
+    nOffset += 5;
+
+    const auto eFlatType = wkbFlatten(eGeometryType);
+    switch( eFlatType )
+    {
+        case wkbPoint:
+        {
+            const size_t nPointSize = 8 * static_cast<size_t>(nCoordDimension);
+            if( nWKBSize - nOffset < nPointSize )
+                return false;
+            const double dfX = ReadDouble(pabyWkb + nOffset, bNeedSwap);
+            const double dfY = ReadDouble(pabyWkb + nOffset + 8, bNeedSwap);
+            nOffset += nPointSize;
+            // POINT EMPTY is encoded with NaN coordinates
+            if( !(std::isnan(dfX) && std::isnan(dfY)) )
+                sEnvelope.Merge(dfX, dfY);
+            return true;
+        }
+
+        case wkbLineString:
+        case wkbCircularString:
+            return OGRWKBMergePointSequence(pabyWkb, nWKBSize, nOffset,
+                                            bNeedSwap, nCoordDimension,
+                                            eFlatType == wkbCircularString,
+                                            &sEnvelope);
+
+        case wkbPolygon:
+        case wkbTriangle:
+        {
+            if( nWKBSize - nOffset < 4 )
+                return false;
+            const GUInt32 nRings = ReadUInt32(pabyWkb + nOffset, bNeedSwap);
+            nOffset += 4;
+            // Each ring takes at least 4 bytes
+            if( nRings > (nWKBSize - nOffset) / 4 )
+                return false;
+            for( GUInt32 i = 0; i < nRings; ++i )
+            {
+                // Only the exterior ring matters for the envelope
+                if( !OGRWKBMergePointSequence(pabyWkb, nWKBSize, nOffset,
+                                              bNeedSwap, nCoordDimension,
+                                              false,
+                                              i == 0 ? &sEnvelope : nullptr) )
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        case wkbMultiPoint:
+        case wkbMultiLineString:
+        case wkbMultiPolygon:
+        case wkbGeometryCollection:
+        case wkbCompoundCurve:
+        case wkbCurvePolygon:
+        case wkbMultiCurve:
+        case wkbMultiSurface:
+        case wkbPolyhedralSurface:
+        case wkbTIN:
+        {
+            if( nWKBSize - nOffset < 4 )
+                return false;
+            const GUInt32 nParts = ReadUInt32(pabyWkb + nOffset, bNeedSwap);
+            nOffset += 4;
+            // Each part takes at least 9 bytes
+            if( nParts > (nWKBSize - nOffset) / 9 )
+                return false;
+            for( GUInt32 i = 0; i < nParts; ++i )
+            {
+                if( !OGRWKBGetBoundingBoxInternal(pabyWkb, nWKBSize, nOffset,
+                                                  nRecLevel + 1, sEnvelope) )
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        default:
+            break;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                        OGRWKBGetBoundingBox()                        */
+/************************************************************************/
+
+/** Compute the 2D envelope of a WKB geometry, without instantiating a
+ * OGRGeometry object.
+ *
+ * ISO, PostGIS 2 extended and old-style OGC 99-402 WKB are supported.
+ * For circular arcs, the envelope of their full circle is used, so the
+ * result may be larger than the one of OGRGeometry::getEnvelope().
+ * For an empty geometry, true is returned and sEnvelope is left
+ * uninitialized (sEnvelope.IsInit() returns false).
+ *
+ * @return true in case of success, false if the WKB is invalid or truncated.
+ */
+bool OGRWKBGetBoundingBox(const GByte* pabyWkb, size_t nWKBSize,
+                          OGREnvelope& sEnvelope)
+{
+    sEnvelope = OGREnvelope();
+    size_t nOffset = 0;
+    return OGRWKBGetBoundingBoxInternal(pabyWkb, nWKBSize, nOffset, 0,
+                                        sEnvelope);
+}
+
+/************************************************************************/
+/*                    OGRWKBPointSequence::getCoord()                   */
+/************************************************************************/
+
+double OGRWKBPointSequence::getCoord(GUInt32 i, int iCoord) const
+{
+    return ReadDouble(pabyPoints +
+                      (static_cast<size_t>(i) * nCoordDimension + iCoord) * 8,
+                      bNeedSwap);
+}
+
+/************************************************************************/
+/*                         OGRWKBGeometryView()                         */
+/************************************************************************/
+
+OGRWKBGeometryView::OGRWKBGeometryView(const GByte* pabyWkb,
+                                       size_t nWKBSize) :
+    m_pabyWkb(pabyWkb),
+    m_nWKBSize(nWKBSize)
+{
+    m_bValid = OGRWKBReadHeader(pabyWkb, nWKBSize, m_eGeometryType,
+                                m_bNeedSwap, m_nCoordDimension);
+    if( !m_bValid )
+        return;
+
+    switch( wkbFlatten(m_eGeometryType) )
+    {
+        case wkbLineString:
+        case wkbCircularString:
+            m_nRings = 1;
+            break;
+
+        case wkbPolygon:
+        case wkbTriangle:
+            if( nWKBSize < 9 )
+                m_bValid = false;
+            else
+                m_nRings = ReadUInt32(pabyWkb + 5, m_bNeedSwap);
+            break;
+
+        default:
+            break;
+    }
+    ResetReading();
+}
+
+/************************************************************************/
+/*                            GetEnvelope()                             */
+/************************************************************************/
+
+/** Compute the 2D envelope of the geometry.
+ *
+ * @see OGRWKBGetBoundingBox()
+ */
+bool OGRWKBGeometryView::GetEnvelope(OGREnvelope& sEnvelope) const
+{
+    return m_bValid &&
+           OGRWKBGetBoundingBox(m_pabyWkb, m_nWKBSize, sEnvelope);
+}
+
+/************************************************************************/
+/*                            GetNumRings()                             */
+/************************************************************************/
+
+/** Return the number of rings of a polygon/triangle, 1 for a line string,
+ * and 0 for other geometry types.
+ */
+GUInt32 OGRWKBGeometryView::GetNumRings() const
+{
+    return m_nRings;
+}
+
+/************************************************************************/
+/*                            ResetReading()                            */
+/************************************************************************/
+
+/** Restart the ring iteration of GetNextRing() */
+void OGRWKBGeometryView::ResetReading()
+{
+    m_iNextRing = 0;
+    m_nNextRingOffset =
+        wkbFlatten(m_eGeometryType) == wkbPolygon ||
+        wkbFlatten(m_eGeometryType) == wkbTriangle ? 9 : 5;
+}
+
+/************************************************************************/
+/*                            GetNextRing()                             */
+/************************************************************************/
+
+/** Fetch the next ring of a polygon/triangle, or the point sequence of a
+ * line string.
+ *
+ * @return false when there are no more rings or when the WKB is truncated.
+ */
+bool OGRWKBGeometryView::GetNextRing(OGRWKBPointSequence& oRing)
+{
+    if( !m_bValid || m_iNextRing >= m_nRings )
+        return false;
+    if( m_nWKBSize - m_nNextRingOffset < 4 )
+        return false;
+    const GUInt32 nPoints =
+        ReadUInt32(m_pabyWkb + m_nNextRingOffset, m_bNeedSwap);
+    const size_t nPointSize = 8 * static_cast<size_t>(m_nCoordDimension);
+    if( nPoints > (m_nWKBSize - m_nNextRingOffset - 4) / nPointSize )
+        return false;
+
+    oRing.pabyPoints = m_pabyWkb + m_nNextRingOffset + 4;
+    oRing.nPoints = nPoints;
+    oRing.nCoordDimension = m_nCoordDimension;
+    oRing.bNeedSwap = m_bNeedSwap;
+
+    m_nNextRingOffset += 4 + nPoints * nPointSize;
+    m_iNextRing++;
+    return true;
+}
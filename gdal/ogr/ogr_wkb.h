@@ -0,0 +1,106 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OGR
+ * Purpose:  WKB geometry related methods, working directly on WKB buffers
+ *           without instantiating OGRGeometry objects.
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef OGR_WKB_H_INCLUDED
+#define OGR_WKB_H_INCLUDED
+
+#include <cstddef>
+
+#include "cpl_port.h"
+#include "ogr_core.h"
+
+/*! @cond Doxygen_Suppress */
+
+bool CPL_DLL OGRWKBGetGeomType(const GByte* pabyWkb, size_t nWKBSize,
+                               OGRwkbGeometryType& eGeometryType);
+
+bool CPL_DLL OGRWKBGetBoundingBox(const GByte* pabyWkb, size_t nWKBSize,
+                                  OGREnvelope& sEnvelope);
+
+/************************************************************************/
+/*                         OGRWKBPointSequence                          */
+/************************************************************************/
+
+/** Read-only view on a sequence of points (line string or ring) of a
+ * WKB buffer. The buffer must remain valid during the lifetime of the view.
+ */
+struct CPL_DLL OGRWKBPointSequence
+{
+    const GByte* pabyPoints = nullptr;
+    GUInt32      nPoints = 0;
+    int          nCoordDimension = 2;
+    bool         bNeedSwap = false;
+
+    double       getX(GUInt32 i) const { return getCoord(i, 0); }
+    double       getY(GUInt32 i) const { return getCoord(i, 1); }
+
+  private:
+    double       getCoord(GUInt32 i, int iCoord) const;
+};
+
+/************************************************************************/
+/*                         OGRWKBGeometryView                           */
+/************************************************************************/
+
+/** Read-only view on a WKB geometry, that does not copy nor decode the
+ * buffer it wraps. The buffer must remain valid during the lifetime of the
+ * view.
+ */
+class CPL_DLL OGRWKBGeometryView
+{
+    const GByte*       m_pabyWkb = nullptr;
+    size_t             m_nWKBSize = 0;
+    OGRwkbGeometryType m_eGeometryType = wkbUnknown;
+    bool               m_bValid = false;
+    bool               m_bNeedSwap = false;
+    int                m_nCoordDimension = 2;
+
+    GUInt32            m_nRings = 0;
+    GUInt32            m_iNextRing = 0;
+    size_t             m_nNextRingOffset = 0;
+
+  public:
+    OGRWKBGeometryView(const GByte* pabyWkb, size_t nWKBSize);
+
+    /** Whether the header of the WKB geometry could be decoded */
+    bool               IsValid() const { return m_bValid; }
+
+    /** Geometry type, including its Z/M flags */
+    OGRwkbGeometryType GetGeometryType() const { return m_eGeometryType; }
+
+    bool               GetEnvelope(OGREnvelope& sEnvelope) const;
+
+    GUInt32            GetNumRings() const;
+    void               ResetReading();
+    bool               GetNextRing(OGRWKBPointSequence& oRing);
+};
+
+/*! @endcond */
+
+#endif /* OGR_WKB_H_INCLUDED */
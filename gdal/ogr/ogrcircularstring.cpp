@@ -556,6 +556,7 @@ void OGRCircularString::segmentize( double dfMaxLength )
     if( nPointCount < static_cast<int>(aoRawPoint.size()) )
     {
         nPointCount = static_cast<int>(aoRawPoint.size());
+        m_nPointCapacity = nPointCount;
         paoPoints = static_cast<OGRRawPoint *>(
                 CPLRealloc(paoPoints, sizeof(OGRRawPoint) * nPointCount));
         memcpy(paoPoints, &aoRawPoint[0], sizeof(OGRRawPoint) * nPointCount);
@@ -37,12 +37,19 @@
 #include <limits>
 #include <list>
 #include <mutex>
+#include <new>
+#include <thread>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_json.h"
+#include "cpl_md5.h"
 #include "cpl_mem_cache.h"
+#include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "ogr_core.h"
+#include "ogr_geometry.h"
+#include "ogr_p.h"
 #include "ogr_srs_api.h"
 #include "ogr_proj_p.h"
 
@@ -603,6 +610,14 @@ class OGRProjCT : public OGRCoordinateTransformation
 
     bool        bNoTransform = false;
 
+    // Orientation of the first axis of the source and target CRS, lazily
+    // computed to avoid querying it at each TransformWithErrorCodes() call.
+    bool        m_bAxisOrientationsComputed = false;
+    bool        m_bSourceFirstAxisIsEast = true;
+    bool        m_bTargetFirstAxisIsEast = true;
+
+    void        ComputeAxisOrientations();
+
     enum class Strategy
     {
         PROJ,
@@ -651,6 +666,12 @@ class OGRProjCT : public OGRCoordinateTransformation
                            const OGRSpatialReference* poSRS2,
                            const OGRCoordinateTransformationOptions& options);
 
+    std::string MakeDiskCacheKey() const;
+    bool        LoadFromDiskCache(const std::string& osFilename,
+                                  const std::string& osKey);
+    void        SaveToDiskCache(const std::string& osFilename,
+                                const std::string& osKey) const;
+
 public:
     OGRProjCT();
     ~OGRProjCT() override;
@@ -816,6 +837,19 @@ OGRCreateCoordinateTransformation( const OGRSpatialReference *poSource,
  *     3.0.2</li>
  * </ul>
  *
+ * Starting with GDAL 3.4, the OGR_CT_CACHE_DIR configuration option can be
+ * set to a directory where the candidate operations found for a pair of
+ * source and target CRS are saved, as PROJ strings with the extent of their
+ * area of use in the source CRS. Later processes read them from there instead
+ * of searching the PROJ database again. When it is set, the FIRST_MATCHING
+ * strategy is used in place of PROJ. The content of the directory must be
+ * deleted when the PROJ database or the available grids change.
+ *
+ * Starting with GDAL 3.4, the OGR_CT_NUM_THREADS configuration option can be
+ * set to a number of threads, or ALL_CPUS, to split the transformation of
+ * large arrays of points (at least 20000) across several threads. It
+ * defaults to 1.
+ *
  * If options contains a user defined coordinate transformation pipeline, it
  * will be unconditionally used.
  * If options has an area of interest defined, it will be used to research the
@@ -1093,6 +1127,27 @@ OGRProjCT::~OGRProjCT()
     }
 }
 
+/************************************************************************/
+/*                      ComputeAxisOrientations()                       */
+/************************************************************************/
+
+void OGRProjCT::ComputeAxisOrientations()
+{
+    OGRAxisOrientation orientation = OAO_East;
+    if( poSRSSource )
+    {
+        poSRSSource->GetAxis(nullptr, 0, &orientation);
+        m_bSourceFirstAxisIsEast = orientation == OAO_East;
+    }
+    if( poSRSTarget )
+    {
+        orientation = OAO_East;
+        poSRSTarget->GetAxis(nullptr, 0, &orientation);
+        m_bTargetFirstAxisIsEast = orientation == OAO_East;
+    }
+    m_bAxisOrientationsComputed = true;
+}
+
 /************************************************************************/
 /*                          ComputeThreshold()                          */
 /************************************************************************/
@@ -1346,6 +1401,26 @@ int OGRProjCT::Initialize( const OGRSpatialReference * poSourceIn,
         }
     }
 
+    // Candidate operations resolved by a previous process
+    bool bFromDiskCache = false;
+    std::string osDiskCacheKey;
+    std::string osDiskCacheFilename;
+    const char* pszCacheDir = CPLGetConfigOption("OGR_CT_CACHE_DIR", nullptr);
+    if( pszCacheDir != nullptr && pszCacheDir[0] != '\0' &&
+        options.d->osCoordOperation.empty() &&
+        !bWebMercatorToWGS84LongLat && poSRSSource && poSRSTarget )
+    {
+        // The operations chosen by proj_create_crs_to_crs() cannot be
+        // serialized, but the candidates listed by ListCoordinateOperations()
+        // can, and FIRST_MATCHING selects among them like PROJ does.
+        if( m_eStrategy == Strategy::PROJ )
+            m_eStrategy = Strategy::FIRST_MATCHING;
+        osDiskCacheKey = MakeDiskCacheKey();
+        osDiskCacheFilename = CPLFormFilename(
+            pszCacheDir, CPLMD5String(osDiskCacheKey.c_str()), "json");
+        bFromDiskCache = LoadFromDiskCache(osDiskCacheFilename, osDiskCacheKey);
+    }
+
     if( !options.d->osCoordOperation.empty() )
     {
         auto ctx = OSRGetProjTLSContext();
@@ -1364,7 +1439,8 @@ int OGRProjCT::Initialize( const OGRSpatialReference * poSourceIn,
                  m_bReversePj ? "(reversed) " : "");
 #endif
     }
-    else if( !bWebMercatorToWGS84LongLat && poSRSSource && poSRSTarget )
+    else if( !bFromDiskCache &&
+             !bWebMercatorToWGS84LongLat && poSRSSource && poSRSTarget )
     {
         const auto CanUseAuthorityDef = [](const OGRSpatialReference* poSRS1,
                                            OGRSpatialReference* poSRSFromAuth,
@@ -1509,6 +1585,9 @@ int OGRProjCT::Initialize( const OGRSpatialReference * poSourceIn,
 
         CPLFree(pszSrcSRS);
         CPLFree(pszTargetSRS);
+
+        if( !osDiskCacheFilename.empty() )
+            SaveToDiskCache(osDiskCacheFilename, osDiskCacheKey);
     }
 
     if( options.d->osCoordOperation.empty() && poSRSSource && poSRSTarget )
@@ -1977,6 +2056,291 @@ int OGRCoordinateTransformation::TransformWithErrorCodes(
     return bOverallSuccess;
 }
 
+/************************************************************************/
+/*                        TransformGeometries()                         */
+/************************************************************************/
+
+namespace {
+// Point or simple curve of a geometry, whose coordinates are gathered in
+// the arrays passed to Transform().
+struct OGRCTGeometryPart
+{
+    OGRGeometry* poGeom = nullptr;
+    size_t       nOffset = 0;
+    int          nPoints = 0;
+    bool         bIsClosedRing = false;
+};
+} // namespace
+
+static void OGRCTCollectParts( OGRGeometry* poGeom,
+                               std::vector<OGRCTGeometryPart>& aoParts,
+                               size_t& nTotalPoints )
+{
+    const OGRwkbGeometryType eType = wkbFlatten(poGeom->getGeometryType());
+    if( eType == wkbPoint )
+    {
+        OGRCTGeometryPart oPart;
+        oPart.poGeom = poGeom;
+        oPart.nOffset = nTotalPoints;
+        oPart.nPoints = poGeom->IsEmpty() ? 0 : 1;
+        nTotalPoints += oPart.nPoints;
+        aoParts.push_back(oPart);
+    }
+    else if( eType == wkbCompoundCurve )
+    {
+        for( auto&& poSubGeom: *(poGeom->toCompoundCurve()) )
+            OGRCTCollectParts(poSubGeom, aoParts, nTotalPoints);
+    }
+    else if( OGR_GT_IsCurve(eType) )
+    {
+        OGRSimpleCurve* poCurve = poGeom->toSimpleCurve();
+        OGRCTGeometryPart oPart;
+        oPart.poGeom = poGeom;
+        oPart.nOffset = nTotalPoints;
+        oPart.nPoints = poCurve->getNumPoints();
+        oPart.bIsClosedRing = EQUAL(poGeom->getGeometryName(), "LINEARRING") &&
+                              oPart.nPoints > 2 &&
+                              CPL_TO_BOOL(poCurve->get_IsClosed());
+        nTotalPoints += oPart.nPoints;
+        aoParts.push_back(oPart);
+    }
+    else if( OGR_GT_IsSubClassOf(eType, wkbCurvePolygon) )
+    {
+        for( auto&& poSubGeom: *(poGeom->toCurvePolygon()) )
+            OGRCTCollectParts(poSubGeom, aoParts, nTotalPoints);
+    }
+    else if( OGR_GT_IsSubClassOf(eType, wkbPolyhedralSurface) )
+    {
+        for( auto&& poSubGeom: *(poGeom->toPolyhedralSurface()) )
+            OGRCTCollectParts(poSubGeom, aoParts, nTotalPoints);
+    }
+    else if( OGR_GT_IsSubClassOf(eType, wkbGeometryCollection) )
+    {
+        for( auto&& poSubGeom: *(poGeom->toGeometryCollection()) )
+            OGRCTCollectParts(poSubGeom, aoParts, nTotalPoints);
+    }
+}
+
+// Apply the transformed coordinates to the geometry, with the same semantics
+// as OGRGeometry::transform() when some points failed to transform.
+static OGRErr OGRCTApplyTransformedParts( OGRGeometry* poGeom,
+                                          const std::vector<OGRCTGeometryPart>& aoParts,
+                                          size_t& iPart,
+                                          double* padfX, double* padfY,
+                                          double* padfZ,
+                                          const int* pabSuccess,
+                                          OGRSpatialReference* poTargetSRS )
+{
+    const OGRwkbGeometryType eType = wkbFlatten(poGeom->getGeometryType());
+    if( eType == wkbPoint || (OGR_GT_IsCurve(eType) &&
+                              eType != wkbCompoundCurve) )
+    {
+        const OGRCTGeometryPart& oPart = aoParts[iPart];
+        CPLAssert( oPart.poGeom == poGeom );
+        ++iPart;
+        const size_t i = oPart.nOffset;
+        if( eType == wkbPoint )
+        {
+            if( oPart.nPoints != 0 )
+            {
+                if( !pabSuccess[i] )
+                    return OGRERR_FAILURE;
+                OGRPoint* poPoint = poGeom->toPoint();
+                poPoint->setX(padfX[i]);
+                poPoint->setY(padfY[i]);
+                if( poPoint->Is3D() )
+                    poPoint->setZ(padfZ[i]);
+            }
+        }
+        else
+        {
+            const OGRErr eErr = OGRSimpleCurveSetTransformedPoints(
+                poGeom->toSimpleCurve(), oPart.nPoints,
+                padfX + i, padfY + i, padfZ + i, pabSuccess + i);
+            if( eErr != OGRERR_NONE )
+                return eErr;
+            if( oPart.bIsClosedRing )
+                OGRLinearRingRestoreClosure(poGeom->toLinearRing());
+        }
+        poGeom->assignSpatialReference( poTargetSRS );
+        return OGRERR_NONE;
+    }
+
+    std::vector<OGRGeometry*> apoSubGeoms;
+    if( eType == wkbCompoundCurve )
+    {
+        for( auto&& poSubGeom: *(poGeom->toCompoundCurve()) )
+            apoSubGeoms.push_back(poSubGeom);
+    }
+    else if( OGR_GT_IsSubClassOf(eType, wkbCurvePolygon) )
+    {
+        for( auto&& poSubGeom: *(poGeom->toCurvePolygon()) )
+            apoSubGeoms.push_back(poSubGeom);
+    }
+    else if( OGR_GT_IsSubClassOf(eType, wkbPolyhedralSurface) )
+    {
+        for( auto&& poSubGeom: *(poGeom->toPolyhedralSurface()) )
+            apoSubGeoms.push_back(poSubGeom);
+    }
+    else if( OGR_GT_IsSubClassOf(eType, wkbGeometryCollection) )
+    {
+        for( auto&& poSubGeom: *(poGeom->toGeometryCollection()) )
+            apoSubGeoms.push_back(poSubGeom);
+    }
+
+    for( size_t iGeom = 0; iGeom < apoSubGeoms.size(); iGeom++ )
+    {
+        const OGRErr eErr = OGRCTApplyTransformedParts(
+            apoSubGeoms[iGeom], aoParts, iPart,
+            padfX, padfY, padfZ, pabSuccess, poTargetSRS);
+        if( eErr != OGRERR_NONE )
+        {
+            if( iGeom != 0 )
+            {
+                CPLDebug("OGR",
+                         "OGRCoordinateTransformation::TransformGeometries() "
+                         "failed for a geometry other than the first, meaning "
+                         "some geometries are transformed and some are not." );
+
+                return OGRERR_FAILURE;
+            }
+
+            return eErr;
+        }
+    }
+
+    poGeom->assignSpatialReference( poTargetSRS );
+
+    return OGRERR_NONE;
+}
+
+/**
+ * Transform a batch of geometries from source to destination space.
+ *
+ * The coordinates of all the points of the geometries are gathered into
+ * contiguous arrays, and transformed with as few calls as possible to
+ * Transform(), which is much more efficient than calling
+ * OGRGeometry::transform() on each geometry when the geometries have many
+ * parts (e.g. multipolygons with many rings).
+ *
+ * For each geometry, the result is the same as calling
+ * OGRGeometry::transform() on it: if some points cannot be transformed, the
+ * geometry is left unmodified (unless OGR_ENABLE_PARTIAL_REPROJECTION is
+ * enabled), or partially modified for a collection whose first part
+ * could be transformed.
+ *
+ * @param nCount number of geometries to transform.
+ * @param papoGeoms array of nCount geometries, modified in place. Null
+ * geometries are ignored.
+ * @param paeErrors Output array of nCount error codes, set to OGRERR_NONE for
+ * geometries that have been successfully transformed. Might be NULL.
+ *
+ * @return TRUE if all geometries were successfully transformed.
+ * @since GDAL 3.4
+ */
+
+int OGRCoordinateTransformation::TransformGeometries(
+    int nCount, OGRGeometry* const* papoGeoms, OGRErr* paeErrors )
+{
+    std::vector<OGRCTGeometryPart> aoParts;
+    std::vector<size_t> anFirstPart;
+    std::vector<double> adfX;
+    std::vector<double> adfY;
+    std::vector<double> adfZ;
+    std::vector<int> abSuccess;
+    try
+    {
+        size_t nTotalPoints = 0;
+        anFirstPart.resize(nCount);
+        for( int i = 0; i < nCount; i++ )
+        {
+            anFirstPart[i] = aoParts.size();
+            if( papoGeoms[i] )
+                OGRCTCollectParts(papoGeoms[i], aoParts, nTotalPoints);
+        }
+
+        adfX.resize(nTotalPoints);
+        adfY.resize(nTotalPoints);
+        adfZ.resize(nTotalPoints);
+        abSuccess.resize(nTotalPoints);
+    }
+    catch( const std::bad_alloc& e )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory, "%s", e.what());
+        if( paeErrors )
+        {
+            for( int i = 0; i < nCount; i++ )
+                paeErrors[i] = OGRERR_NOT_ENOUGH_MEMORY;
+        }
+        return FALSE;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Gather the coordinates of all the points.                       */
+/* -------------------------------------------------------------------- */
+    for( const auto& oPart: aoParts )
+    {
+        if( wkbFlatten(oPart.poGeom->getGeometryType()) == wkbPoint )
+        {
+            if( oPart.nPoints != 0 )
+            {
+                const OGRPoint* poPoint = oPart.poGeom->toPoint();
+                adfX[oPart.nOffset] = poPoint->getX();
+                adfY[oPart.nOffset] = poPoint->getY();
+                adfZ[oPart.nOffset] = poPoint->getZ();
+            }
+        }
+        else
+        {
+            const OGRSimpleCurve* poCurve = oPart.poGeom->toSimpleCurve();
+            for( int i = 0; i < oPart.nPoints; i++ )
+            {
+                adfX[oPart.nOffset + i] = poCurve->getX(i);
+                adfY[oPart.nOffset + i] = poCurve->getY(i);
+                adfZ[oPart.nOffset + i] = poCurve->getZ(i);
+            }
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Transform them, in as few calls as possible.                    */
+/* -------------------------------------------------------------------- */
+    const size_t nTotalPoints = adfX.size();
+    for( size_t i = 0; i < nTotalPoints; )
+    {
+        const int nChunk = static_cast<int>(
+            std::min(nTotalPoints - i,
+                     static_cast<size_t>(std::numeric_limits<int>::max())));
+        Transform( nChunk, &adfX[i], &adfY[i], &adfZ[i], nullptr,
+                   &abSuccess[i] );
+        i += nChunk;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Reapply them on the geometries.                                 */
+/* -------------------------------------------------------------------- */
+    bool bAllSuccess = true;
+    OGRSpatialReference* poTargetSRS = GetTargetCS();
+    for( int i = 0; i < nCount; i++ )
+    {
+        OGRErr eErr = OGRERR_NONE;
+        if( papoGeoms[i] )
+        {
+            size_t iPart = anFirstPart[i];
+            eErr = OGRCTApplyTransformedParts(papoGeoms[i], aoParts, iPart,
+                                              adfX.data(), adfY.data(),
+                                              adfZ.data(), abSuccess.data(),
+                                              poTargetSRS);
+        }
+        if( eErr != OGRERR_NONE )
+            bAllSuccess = false;
+        if( paeErrors )
+            paeErrors[i] = eErr;
+    }
+
+    return bAllSuccess;
+}
+
 /************************************************************************/
 /*                             Transform()                             */
 /************************************************************************/
@@ -1985,17 +2349,19 @@ int OGRProjCT::Transform( int nCount, double *x, double *y, double *z,
                           double *t, int *pabSuccess )
 
 {
+    // No need to allocate a temporary array of error codes if the caller
+    // is not interested in the per-point status.
+    if( pabSuccess == nullptr )
+        return TransformWithErrorCodes( nCount, x, y, z, t, nullptr );
+
     std::vector<int> anErrorCodes(nCount+1);
 
     bool bOverallSuccess =
         CPL_TO_BOOL(TransformWithErrorCodes( nCount, x, y, z, t, &anErrorCodes[0] ));
 
-    if( pabSuccess )
+    for( int i = 0; i < nCount; i++ )
     {
-        for( int i = 0; i < nCount; i++ )
-        {
-            pabSuccess[i] = ( anErrorCodes[i] == 0 );
-        }
+        pabSuccess[i] = ( anErrorCodes[i] == 0 );
     }
 
     return bOverallSuccess;
@@ -2056,7 +2422,16 @@ int OGRProjCT::TransformWithErrorCodes(
     if( poSRSSource )
     {
         const auto& mapping = poSRSSource->GetDataAxisToSRSAxisMapping();
-        if( mapping.size() >= 2 && (mapping[0] != 1 || mapping[1] != 2) )
+        if( mapping.size() >= 2 && mapping[0] == 2 && mapping[1] == 1 &&
+            !(z && mapping.size() >= 3 && mapping[2] == -3) )
+        {
+            // Common case of a mere axis swap: no per-point dispatch
+            for( int i = 0; i < nCount; i++ )
+            {
+                std::swap(x[i], y[i]);
+            }
+        }
+        else if( mapping.size() >= 2 && (mapping[0] != 1 || mapping[1] != 2) )
         {
             for( int i = 0; i < nCount; i++ )
             {
@@ -2075,12 +2450,13 @@ int OGRProjCT::TransformWithErrorCodes(
 /* -------------------------------------------------------------------- */
 /*      Potentially do longitude wrapping.                              */
 /* -------------------------------------------------------------------- */
+    if( !m_bAxisOrientationsComputed )
+        ComputeAxisOrientations();
+
     if( bSourceLatLong && bSourceWrap )
     {
-        OGRAxisOrientation orientation;
         assert( poSRSSource );
-        poSRSSource->GetAxis(nullptr, 0, &orientation);
-        if( orientation == OAO_East )
+        if( m_bSourceFirstAxisIsEast )
         {
             for( int i = 0; i < nCount; i++ )
             {
@@ -2118,9 +2494,7 @@ int OGRProjCT::TransformWithErrorCodes(
 
         if( poSRSSource )
         {
-            OGRAxisOrientation orientation;
-            poSRSSource->GetAxis(nullptr, 0, &orientation);
-            if( orientation != OAO_East )
+            if( !m_bSourceFirstAxisIsEast )
             {
                 for( int i = 0; i < nCount; i++ )
                 {
@@ -2205,9 +2579,7 @@ int OGRProjCT::TransformWithErrorCodes(
 
         if( poSRSTarget )
         {
-            OGRAxisOrientation orientation;
-            poSRSTarget->GetAxis(nullptr, 0, &orientation);
-            if( orientation != OAO_East )
+            if( !m_bTargetFirstAxisIsEast )
             {
                 for( int i = 0; i < nCount; i++ )
                 {
@@ -2397,107 +2769,236 @@ int OGRProjCT::TransformWithErrorCodes(
 
     if( !bTransformDone )
     {
-        for( int i = 0; i < nCount; i++ )
-        {
-            PJ_COORD coord;
-            const double xIn = x[i];
-            const double yIn = y[i];
-            if( !std::isfinite(xIn) )
-            {
-                x[i] = HUGE_VAL;
-                y[i] = HUGE_VAL;
-                if( panErrorCodes )
-                    panErrorCodes[i] = PROJ_ERR_COORD_TRANSFM_INVALID_COORD;
-                continue;
-            }
-            coord.xyzt.x = x[i];
-            coord.xyzt.y = y[i];
-            coord.xyzt.z = z ? z[i] : 0;
-            coord.xyzt.t = t ? t[i] : dfDefaultTime;
-            proj_errno_reset(pj);
-            coord = proj_trans(pj, m_bReversePj ? PJ_INV : PJ_FWD, coord);
-            x[i] = coord.xyzt.x;
-            y[i] = coord.xyzt.y;
-            if( z )
-                z[i] = coord.xyzt.z;
-            if( t )
-                t[i] = coord.xyzt.t;
-            int err = 0;
-            if( coord.xyzt.x == HUGE_VAL )
-            {
-                err = proj_errno(pj);
-                // PROJ should normally emit an error, but in case it does not
-                // (e.g PROJ 6.3 with the +ortho projection), synthetize one
-                if( err == 0 )
-                    err = PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN;
-            }
-            else if( m_options.d->bCheckWithInvertProj )
-            {
-                // For some projections, we cannot detect if we are trying to reproject
-                // coordinates outside the validity area of the projection. So let's do
-                // the reverse reprojection and compare with the source coordinates.
-                coord = proj_trans(pj, m_bReversePj ? PJ_FWD : PJ_INV, coord);
-                if (fabs(coord.xyzt.x - xIn) > dfThreshold ||
-                    fabs(coord.xyzt.y - yIn) > dfThreshold)
-                {
-                    err  = PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN;
-                    x[i] = HUGE_VAL;
-                    y[i] = HUGE_VAL;
-                }
-            }
-
-            if( panErrorCodes )
-                panErrorCodes[i] = err;
-
 /* -------------------------------------------------------------------- */
 /*      Try to report an error through CPL.  Get proj error string      */
 /*      if possible.  Try to avoid reporting thousands of errors.       */
 /*      Suppress further error reporting on this OGRProjCT if we        */
 /*      have already reported 20 errors.                                */
 /* -------------------------------------------------------------------- */
-            if( err != 0 )
+        const auto ReportError = [&](int err)
+        {
+            if( ++nErrorCount < 20 )
             {
-                if( ++nErrorCount < 20 )
-                {
 #if PROJ_VERSION_MAJOR >= 8
-                    const char *pszError = proj_context_errno_string(ctx, err);
+                const char *pszError = proj_context_errno_string(ctx, err);
 #else
-                    const char *pszError = proj_errno_string(err);
+                const char *pszError = proj_errno_string(err);
 #endif
-                    if( m_bEmitErrors )
-                    {
-                        if( pszError == nullptr )
-                            CPLError( CE_Failure, CPLE_AppDefined,
-                                      "Reprojection failed, err = %d", err );
-                        else
-                            CPLError( CE_Failure, CPLE_AppDefined, "%s", pszError );
-                    }
+                if( m_bEmitErrors )
+                {
+                    if( pszError == nullptr )
+                        CPLError( CE_Failure, CPLE_AppDefined,
+                                  "Reprojection failed, err = %d", err );
                     else
-                    {
-                        if( pszError == nullptr )
-                            CPLDebug("OGRCT",
-                                     "Reprojection failed, err = %d", err );
-                        else
-                            CPLDebug("OGRCT", "%s", pszError );
-                    }
+                        CPLError( CE_Failure, CPLE_AppDefined, "%s", pszError );
+                }
+                else
+                {
+                    if( pszError == nullptr )
+                        CPLDebug("OGRCT",
+                                 "Reprojection failed, err = %d", err );
+                    else
+                        CPLDebug("OGRCT", "%s", pszError );
+                }
+            }
+            else if( nErrorCount == 20 )
+            {
+                if( m_bEmitErrors )
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "Reprojection failed, err = %d, further errors will be "
+                             "suppressed on the transform object.",
+                             err );
+                }
+                else
+                {
+                    CPLDebug("OGRCT",
+                             "Reprojection failed, err = %d, further errors will be "
+                             "suppressed on the transform object.",
+                             err );
                 }
-                else if( nErrorCount == 20 )
+            }
+        };
+
+        const bool bCheckWithInvertProj = m_options.d->bCheckWithInvertProj;
+        const PJ_DIRECTION eDirection = m_bReversePj ? PJ_INV : PJ_FWD;
+
+        // Transform the points in [iStart, iStart + nRange[ with pjIn, and
+        // store their error codes in panRangeErrorCodes, if not null. Errors
+        // to report are appended to panErrorsToReport if not null, since
+        // reporting them directly is not thread-safe.
+        const auto TransformRange = [&](PJ* pjIn, int iStart, int nRange,
+                                        int* panRangeErrorCodes,
+                                        std::vector<int>* panErrorsToReport)
+        {
+            const auto Report = [&ReportError, panErrorsToReport](int err)
+            {
+                if( panErrorsToReport )
+                    panErrorsToReport->push_back(err);
+                else
+                    ReportError(err);
+            };
+
+            double* const xr = x + iStart;
+            double* const yr = y + iStart;
+            double* const zr = z ? z + iStart : nullptr;
+            double* const tr = t ? t + iStart : nullptr;
+
+            // When there is no need for a round-trip check, and all input
+            // coordinates are valid, let PROJ transform the whole array at
+            // once, which avoids the per-point overhead of proj_trans().
+            bool bTransformAsArray = !bCheckWithInvertProj;
+            for( int i = 0; bTransformAsArray && i < nRange; i++ )
+            {
+                if( !std::isfinite(xr[i]) )
+                    bTransformAsArray = false;
+            }
+
+            if( bTransformAsArray )
+            {
+                // A single value is broadcast by proj_trans_generic() to all
+                // points.
+                double dfTime = dfDefaultTime;
+                proj_errno_reset(pjIn);
+                proj_trans_generic(pjIn, eDirection,
+                                   xr, sizeof(double), nRange,
+                                   yr, sizeof(double), nRange,
+                                   zr, zr ? sizeof(double) : 0, zr ? nRange : 0,
+                                   tr ? tr : &dfTime, tr ? sizeof(double) : 0,
+                                   tr ? nRange : 1);
+                for( int i = 0; i < nRange; i++ )
                 {
-                    if( m_bEmitErrors )
+                    int err = 0;
+                    if( xr[i] == HUGE_VAL )
                     {
-                        CPLError(CE_Failure, CPLE_AppDefined,
-                                 "Reprojection failed, err = %d, further errors will be "
-                                 "suppressed on the transform object.",
-                                 err );
+                        err = proj_errno(pjIn);
+                        if( err == 0 )
+                            err = PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN;
+                        yr[i] = HUGE_VAL;
                     }
-                    else
+                    if( panRangeErrorCodes )
+                        panRangeErrorCodes[i] = err;
+                    if( err != 0 )
+                        Report(err);
+                }
+                return;
+            }
+
+            for( int i = 0; i < nRange; i++ )
+            {
+                PJ_COORD coord;
+                const double xIn = xr[i];
+                const double yIn = yr[i];
+                if( !std::isfinite(xIn) )
+                {
+                    xr[i] = HUGE_VAL;
+                    yr[i] = HUGE_VAL;
+                    if( panRangeErrorCodes )
+                        panRangeErrorCodes[i] = PROJ_ERR_COORD_TRANSFM_INVALID_COORD;
+                    continue;
+                }
+                coord.xyzt.x = xr[i];
+                coord.xyzt.y = yr[i];
+                coord.xyzt.z = zr ? zr[i] : 0;
+                coord.xyzt.t = tr ? tr[i] : dfDefaultTime;
+                proj_errno_reset(pjIn);
+                coord = proj_trans(pjIn, eDirection, coord);
+                xr[i] = coord.xyzt.x;
+                yr[i] = coord.xyzt.y;
+                if( zr )
+                    zr[i] = coord.xyzt.z;
+                if( tr )
+                    tr[i] = coord.xyzt.t;
+                int err = 0;
+                if( coord.xyzt.x == HUGE_VAL )
+                {
+                    err = proj_errno(pjIn);
+                    // PROJ should normally emit an error, but in case it does not
+                    // (e.g PROJ 6.3 with the +ortho projection), synthetize one
+                    if( err == 0 )
+                        err = PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN;
+                }
+                else if( bCheckWithInvertProj )
+                {
+                    // For some projections, we cannot detect if we are trying to reproject
+                    // coordinates outside the validity area of the projection. So let's do
+                    // the reverse reprojection and compare with the source coordinates.
+                    coord = proj_trans(pjIn, m_bReversePj ? PJ_FWD : PJ_INV, coord);
+                    if (fabs(coord.xyzt.x - xIn) > dfThreshold ||
+                        fabs(coord.xyzt.y - yIn) > dfThreshold)
                     {
-                        CPLDebug("OGRCT",
-                                 "Reprojection failed, err = %d, further errors will be "
-                                 "suppressed on the transform object.",
-                                 err );
+                        err  = PROJ_ERR_COORD_TRANSFM_OUTSIDE_PROJECTION_DOMAIN;
+                        xr[i] = HUGE_VAL;
+                        yr[i] = HUGE_VAL;
                     }
                 }
+
+                if( panRangeErrorCodes )
+                    panRangeErrorCodes[i] = err;
+
+                if( err != 0 )
+                    Report(err);
+            }
+        };
+
+        // Large arrays can be split across threads. Each thread needs its
+        // own copy of the operation, attached to its own PROJ context.
+        constexpr int MIN_POINTS_PER_THREAD = 10000;
+        std::vector<PJ*> apjThreads;
+        if( nCount >= 2 * MIN_POINTS_PER_THREAD )
+        {
+            const char* pszNumThreads =
+                CPLGetConfigOption("OGR_CT_NUM_THREADS", "1");
+            int nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                            CPLGetNumCPUs() : atoi(pszNumThreads);
+            nThreads = std::min(nThreads, nCount / MIN_POINTS_PER_THREAD);
+            for( int i = 1; i < nThreads; i++ )
+            {
+                PJ* pjClone = proj_clone(ctx, pj);
+                if( pjClone == nullptr )
+                    break;
+                apjThreads.push_back(pjClone);
+            }
+        }
+
+        if( apjThreads.empty() )
+        {
+            TransformRange(pj, 0, nCount, panErrorCodes, nullptr);
+        }
+        else
+        {
+            const int nThreads = 1 + static_cast<int>(apjThreads.size());
+            const int nChunkSize = (nCount + nThreads - 1) / nThreads;
+            std::vector<std::vector<int>> aanErrorsToReport(nThreads);
+            std::vector<std::thread> aoThreads;
+            for( int iThread = 1; iThread < nThreads; iThread++ )
+            {
+                PJ* pjThread = apjThreads[iThread - 1];
+                const int iStart = iThread * nChunkSize;
+                const int nRange = std::min(nChunkSize, nCount - iStart);
+                int* panRangeErrorCodes =
+                    panErrorCodes ? panErrorCodes + iStart : nullptr;
+                std::vector<int>* panErrorsToReport =
+                    &aanErrorsToReport[iThread];
+                aoThreads.emplace_back(
+                    [&TransformRange, pjThread, iStart, nRange,
+                     panRangeErrorCodes, panErrorsToReport]()
+                {
+                    proj_assign_context(pjThread, OSRGetProjTLSContext());
+                    TransformRange(pjThread, iStart, nRange,
+                                   panRangeErrorCodes, panErrorsToReport);
+                    proj_destroy(pjThread);
+                });
+            }
+            TransformRange(pj, 0, nChunkSize, panErrorCodes,
+                           &aanErrorsToReport[0]);
+            for( auto& oThread: aoThreads )
+                oThread.join();
+
+            for( const auto& anErrors: aanErrorsToReport )
+            {
+                for( int err: anErrors )
+                    ReportError(err);
             }
         }
     }
@@ -2507,10 +3008,8 @@ int OGRProjCT::TransformWithErrorCodes(
 /* -------------------------------------------------------------------- */
     if( bTargetLatLong && bTargetWrap )
     {
-        OGRAxisOrientation orientation;
         assert( poSRSTarget );
-        poSRSTarget->GetAxis(nullptr, 0, &orientation);
-        if( orientation == OAO_East )
+        if( m_bTargetFirstAxisIsEast )
         {
             for( int i = 0; i < nCount; i++ )
             {
@@ -2544,7 +3043,16 @@ int OGRProjCT::TransformWithErrorCodes(
     if( poSRSTarget )
     {
         const auto& mapping = poSRSTarget->GetDataAxisToSRSAxisMapping();
-        if( mapping.size() >= 2 && (mapping[0] != 1 || mapping[1] != 2) )
+        if( mapping.size() >= 2 && mapping[0] == 2 && mapping[1] == 1 &&
+            !(z && mapping.size() >= 3 && mapping[2] == -3) )
+        {
+            // Common case of a mere axis swap: no per-point dispatch
+            for( int i = 0; i < nCount; i++ )
+            {
+                std::swap(x[i], y[i]);
+            }
+        }
+        else if( mapping.size() >= 2 && (mapping[0] != 1 || mapping[1] != 2) )
         {
             for( int i = 0; i < nCount; i++ )
             {
@@ -2709,6 +3217,144 @@ CTCacheKey OGRProjCT::MakeCacheKey(const OGRSpatialReference* poSRS1,
     return ret;
 }
 
+/************************************************************************/
+/*                          MakeDiskCacheKey()                          */
+/************************************************************************/
+
+std::string OGRProjCT::MakeDiskCacheKey() const
+{
+    // Besides the CRS and options, the candidate operations depend on the
+    // PROJ version and on the settings that affect their selection.
+    std::string osKey(MakeCacheKey(poSRSSource, poSRSTarget, m_options));
+    osKey += CPLSPrintf("|PROJ=%d.%d.%d", PROJ_VERSION_MAJOR,
+                        PROJ_VERSION_MINOR, PROJ_VERSION_PATCH);
+#if PROJ_VERSION_MAJOR >= 7
+    osKey += CPLSPrintf("|NETWORK=%d",
+        proj_context_is_network_enabled(OSRGetProjTLSContext()));
+#endif
+    for( const char* pszOption : { "OSR_USE_APPROX_TMERC",
+                                   "OSR_USE_ETMERC",
+                                   "OSR_CT_USE_DEFAULT_EPSG_TOWGS84" } )
+    {
+        osKey += '|';
+        osKey += pszOption;
+        osKey += '=';
+        osKey += CPLGetConfigOption(pszOption, "");
+    }
+    osKey += m_eStrategy == Strategy::BEST_ACCURACY ? "|BEST_ACCURACY" :
+                                                      "|FIRST_MATCHING";
+    return osKey;
+}
+
+/************************************************************************/
+/*                         LoadFromDiskCache()                          */
+/************************************************************************/
+
+bool OGRProjCT::LoadFromDiskCache(const std::string& osFilename,
+                                  const std::string& osKey)
+{
+    VSIStatBufL sStat;
+    if( VSIStatL(osFilename.c_str(), &sStat) != 0 )
+        return false;
+
+    CPLJSONDocument oDoc;
+    {
+        CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
+        if( !oDoc.Load(osFilename) )
+            return false;
+    }
+    const auto oRoot = oDoc.GetRoot();
+    // Guard against MD5 collisions
+    if( oRoot.GetString("key") != osKey )
+        return false;
+
+    auto ctx = OSRGetProjTLSContext();
+    const std::string osPipeline = oRoot.GetString("pipeline");
+    if( !osPipeline.empty() )
+    {
+        m_pj = proj_create(ctx, osPipeline.c_str());
+    }
+    else
+    {
+        for( const auto& oOp : oRoot.GetArray("operations") )
+        {
+            const std::string osProjString = oOp.GetString("proj_string");
+            auto pj = proj_create(ctx, osProjString.empty() ?
+                                        "proj=affine" : osProjString.c_str());
+            if( pj == nullptr )
+            {
+                m_oTransformations.clear();
+                break;
+            }
+            m_oTransformations.emplace_back(
+                oOp.GetDouble("minx"), oOp.GetDouble("miny"),
+                oOp.GetDouble("maxx"), oOp.GetDouble("maxy"),
+                pj, oOp.GetString("name"), osProjString,
+                oOp.GetDouble("accuracy", -1.0));
+        }
+    }
+    if( m_pj == nullptr && m_oTransformations.empty() )
+        return false;
+
+    CPLDebug("OGRCT", "Using candidate operations from %s",
+             osFilename.c_str());
+    return true;
+}
+
+/************************************************************************/
+/*                          SaveToDiskCache()                           */
+/************************************************************************/
+
+void OGRProjCT::SaveToDiskCache(const std::string& osFilename,
+                                const std::string& osKey) const
+{
+    CPLJSONDocument oDoc;
+    auto oRoot = oDoc.GetRoot();
+    oRoot.Add("key", osKey);
+    if( m_oTransformations.empty() )
+    {
+        const PJ* pj = m_pj;
+        if( pj == nullptr )
+            return;
+        auto ctx = OSRGetProjTLSContext();
+        const char* pszProjString =
+            proj_as_proj_string(ctx, pj, PJ_PROJ_5, nullptr);
+        if( pszProjString == nullptr )
+            return;
+        oRoot.Add("pipeline", pszProjString[0] ? pszProjString : "proj=affine");
+    }
+    else
+    {
+        CPLJSONArray oOps;
+        for( const auto& transf : m_oTransformations )
+        {
+            CPLJSONObject oOp;
+            oOp.Add("minx", transf.minx);
+            oOp.Add("miny", transf.miny);
+            oOp.Add("maxx", transf.maxx);
+            oOp.Add("maxy", transf.maxy);
+            oOp.Add("name", transf.osName);
+            oOp.Add("proj_string", transf.osProjString);
+            oOp.Add("accuracy", transf.accuracy);
+            oOps.Add(oOp);
+        }
+        oRoot.Add("operations", oOps);
+    }
+
+    // Write to a temporary file first, so that concurrent processes never
+    // read a partial file.
+    VSIMkdirRecursive(CPLGetPath(osFilename.c_str()), 0755);
+    const std::string osTmpFilename(
+        osFilename + CPLSPrintf(".%d.%p.tmp", CPLGetCurrentProcessID(), this));
+    CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
+    if( !oDoc.Save(osTmpFilename) ||
+        VSIRename(osTmpFilename.c_str(), osFilename.c_str()) != 0 )
+    {
+        VSIUnlink(osTmpFilename.c_str());
+        CPLDebug("OGRCT", "Cannot write %s", osFilename.c_str());
+    }
+}
+
 /************************************************************************/
 /*                           InsertIntoCache()                          */
 /************************************************************************/
@@ -633,28 +633,10 @@ OGRCurve* OGRCurveCollection::stealCurve( int i )
 OGRErr OGRCurveCollection::transform( OGRGeometry* poGeom,
                                       OGRCoordinateTransformation *poCT )
 {
-    for( int iGeom = 0; iGeom < nCurveCount; iGeom++ )
-    {
-        const OGRErr eErr = papoCurves[iGeom]->transform( poCT );
-        if( eErr != OGRERR_NONE )
-        {
-            if( iGeom != 0 )
-            {
-                CPLDebug("OGR",
-                         "OGRCurveCollection::transform() failed for a "
-                         "geometry other than the first, meaning some "
-                         "geometries are transformed and some are not!" );
-
-                return OGRERR_FAILURE;
-            }
-
-            return eErr;
-        }
-    }
-
-    poGeom->assignSpatialReference( poCT->GetTargetCS() );
-
-    return OGRERR_NONE;
+    // Transform the points of all the curves at once.
+    OGRErr eErr = OGRERR_NONE;
+    poCT->TransformGeometries( 1, &poGeom, &eErr );
+    return eErr;
 }
 
 /************************************************************************/
@@ -3856,14 +3856,33 @@ void OGRFeature::SetField( int iField, const char * pszValue )
     OGRFieldType eType = poFDefn->GetType();
     if( eType == OFTString )
     {
+        if( pszValue == nullptr )
+            pszValue = "";
+        const size_t nNewLen = strlen(pszValue);
         if( IsFieldSetAndNotNull(iField) )
-            CPLFree( pauFields[iField].String );
+        {
+            // Reuse the existing buffer when it is large enough, which
+            // avoids a free()/malloc() pair per field when a feature object
+            // is recycled while reading.
+            char* pszOld = pauFields[iField].String;
+            if( nNewLen <= strlen(pszOld) )
+            {
+                memmove( pszOld, pszValue, nNewLen + 1 );
+                return;
+            }
+            CPLFree( pszOld );
+        }
 
-        pauFields[iField].String = VSI_STRDUP_VERBOSE(pszValue ? pszValue : "");
+        pauFields[iField].String =
+            static_cast<char*>(VSI_MALLOC_VERBOSE(nNewLen + 1));
         if( pauFields[iField].String == nullptr )
         {
             OGR_RawField_SetUnset(&pauFields[iField]);
         }
+        else
+        {
+            memcpy( pauFields[iField].String, pszValue, nNewLen + 1 );
+        }
     }
     else if( eType == OFTInteger )
     {
@@ -34,7 +34,11 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <climits>
+#include <cmath>
 #include <algorithm>
+#include <string>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -66,6 +70,58 @@ OGRFeatureQuery::OGRFeatureQuery() :
     pSWQExpr(nullptr)
 {}
 
+/************************************************************************/
+/*                       OGRFeatureQuery::Program                       */
+/*                                                                      */
+/*      Flat, postfix form of the simple expressions that make up       */
+/*      most attribute filters: comparisons, IN, BETWEEN and IS NULL    */
+/*      between a field and constants, combined with AND, OR and NOT.   */
+/*      Evaluating it requires no allocation, unlike the generic        */
+/*      swq_expr_node::Evaluate() that is used for other expressions.   */
+/*      Results must be identical to the ones of SWQGeneralEvaluator(). */
+/************************************************************************/
+
+struct OGRFeatureQuery::Program
+{
+    enum class Opcode
+    {
+        INT_CMP,     // compare integer field to anIntConstants
+        DOUBLE_CMP,  // compare field as double to adfDoubleConstants
+        STRING_CMP,  // compare string field to aosStringConstants
+        IS_NULL,
+        AND,
+        OR,
+        NOT
+    };
+
+    struct Instruction
+    {
+        Opcode         eOpcode = Opcode::IS_NULL;
+        swq_op         eCmpOp = SWQ_EQ;
+        swq_field_type eFieldType = SWQ_INTEGER;
+        int            iField = 0;
+        // Index of first operand constant and number of constants.
+        int            nFirstConstant = 0;
+        int            nConstantCount = 0;
+    };
+
+    // Same limit as recursion depth of swq_expr_node::Evaluate().
+    static constexpr int MAX_STACK_DEPTH = 32;
+
+    std::vector<Instruction> aoInstructions{};
+    std::vector<GIntBig>     anIntConstants{};
+    std::vector<double>      adfDoubleConstants{};
+    std::vector<std::string> aosStringConstants{};
+    // Pointers to aosStringConstants, set once compilation is finished.
+    std::vector<const char*> apszStringConstants{};
+
+    bool Compile( const swq_expr_node* poNode, OGRFeatureDefn* poDefn,
+                  int nDepth );
+    bool CompileComparison( const swq_expr_node* poNode,
+                            OGRFeatureDefn* poDefn );
+    bool Evaluate( OGRFeature* poFeature ) const;
+};
+
 /************************************************************************/
 /*                          ~OGRFeatureQuery()                          */
 /************************************************************************/
@@ -122,6 +178,7 @@ OGRFeatureQuery::Compile( OGRLayer *poLayer,
         delete static_cast<swq_expr_node *>(pSWQExpr);
         pSWQExpr = nullptr;
     }
+    poProgram.reset();
 
     const char* pszFIDColumn = nullptr;
     bool bMustAddFID = false;
@@ -242,6 +299,10 @@ OGRFeatureQuery::Compile( OGRLayer *poLayer,
         eErr = OGRERR_CORRUPT_DATA;
         pSWQExpr = nullptr;
     }
+    else
+    {
+        CompileProgram();
+    }
 
     CPLFree(papszFieldNames);
     CPLFree(paeFieldTypes);
@@ -323,6 +384,408 @@ static swq_expr_node *OGRFeatureFetcher( swq_expr_node *op, void *pFeatureIn )
     return poRetNode;
 }
 
+/************************************************************************/
+/*                           CompileProgram()                           */
+/************************************************************************/
+
+void OGRFeatureQuery::CompileProgram()
+
+{
+    poProgram.reset();
+    if( pSWQExpr == nullptr ||
+        !CPLTestBool(CPLGetConfigOption("OGR_SQL_COMPILE_FILTER", "YES")) )
+        return;
+
+    std::unique_ptr<Program> poNewProgram(new Program());
+    if( poNewProgram->Compile(static_cast<swq_expr_node *>(pSWQExpr),
+                              poTargetDefn, 0) )
+    {
+        for( const auto& osConstant: poNewProgram->aosStringConstants )
+            poNewProgram->apszStringConstants.push_back(osConstant.c_str());
+        poProgram = std::move(poNewProgram);
+    }
+}
+
+/************************************************************************/
+/*                     OGRFeatureQueryIsCompilable()                    */
+/************************************************************************/
+
+static bool OGRFeatureQueryIsCompilableColumn( const swq_expr_node* poNode,
+                                               OGRFeatureDefn* poDefn )
+{
+    if( poNode->eNodeType != SNT_COLUMN || poNode->table_index != 0 )
+        return false;
+    const int idx = OGRFeatureFetcherFixFieldIndex(poDefn,
+                                                   poNode->field_index);
+    switch( poNode->field_type )
+    {
+        case SWQ_INTEGER:
+        case SWQ_INTEGER64:
+        case SWQ_BOOLEAN:
+        case SWQ_FLOAT:
+            return idx >= 0 && idx < poDefn->GetFieldCount() + SPECIAL_FIELD_COUNT;
+
+        case SWQ_STRING:
+            // Special string fields, like OGR_GEOM_WKT, are built on the fly.
+            return idx >= 0 && idx < poDefn->GetFieldCount();
+
+        default:
+            return false;
+    }
+}
+
+/************************************************************************/
+/*                   Program::CompileComparison()                       */
+/************************************************************************/
+
+bool OGRFeatureQuery::Program::CompileComparison( const swq_expr_node* poNode,
+                                                  OGRFeatureDefn* poDefn )
+{
+    const int nSubExprCount = poNode->nSubExprCount;
+    if( nSubExprCount < 2 )
+        return false;
+
+    swq_op eOp = poNode->nOperation;
+    const swq_expr_node* poColumn = poNode->papoSubExpr[0];
+    int iFirstConstant = 1;
+    if( poColumn->eNodeType == SNT_CONSTANT && nSubExprCount == 2 &&
+        eOp != SWQ_IN )
+    {
+        // constant op column: evaluate as column reverse_op constant
+        poColumn = poNode->papoSubExpr[1];
+        iFirstConstant = 0;
+        switch( eOp )
+        {
+            case SWQ_LT: eOp = SWQ_GT; break;
+            case SWQ_GT: eOp = SWQ_LT; break;
+            case SWQ_LE: eOp = SWQ_GE; break;
+            case SWQ_GE: eOp = SWQ_LE; break;
+            default: break;
+        }
+    }
+    if( !OGRFeatureQueryIsCompilableColumn(poColumn, poDefn) )
+        return false;
+
+    const int nConstantCount = nSubExprCount - 1;
+    std::vector<const swq_expr_node*> apoConstants;
+    for( int i = 0; i < nConstantCount; i++ )
+    {
+        const swq_expr_node* poConstant =
+            poNode->papoSubExpr[iFirstConstant == 0 ? 0 : i + 1];
+        if( poConstant->eNodeType != SNT_CONSTANT || poConstant->is_null )
+            return false;
+        apoConstants.push_back(poConstant);
+    }
+
+    Instruction oInstr;
+    oInstr.eCmpOp = eOp;
+    oInstr.eFieldType = poColumn->field_type;
+    oInstr.iField = OGRFeatureFetcherFixFieldIndex(poDefn,
+                                                   poColumn->field_index);
+    oInstr.nConstantCount = nConstantCount;
+
+    // Mimic the type dispatching of SWQGeneralEvaluator(), which only
+    // looks at the first two operands.
+    const auto IsIntegerType = [](swq_field_type eType)
+        { return SWQ_IS_INTEGER(eType) || eType == SWQ_BOOLEAN; };
+    const swq_field_type eLeftType = iFirstConstant == 0 ?
+        apoConstants[0]->field_type : poColumn->field_type;
+    const swq_field_type eRightType = iFirstConstant == 0 ?
+        poColumn->field_type : apoConstants[0]->field_type;
+    if( eLeftType == SWQ_FLOAT || eRightType == SWQ_FLOAT )
+    {
+        if( !IsIntegerType(poColumn->field_type) &&
+            poColumn->field_type != SWQ_FLOAT )
+            return false;
+        oInstr.eOpcode = Opcode::DOUBLE_CMP;
+        oInstr.nFirstConstant = static_cast<int>(adfDoubleConstants.size());
+        for( int i = 0; i < nConstantCount; i++ )
+        {
+            const swq_expr_node* poConstant = apoConstants[i];
+            if( poConstant->field_type == SWQ_FLOAT )
+                adfDoubleConstants.push_back(poConstant->float_value);
+            else if( i == 0 && IsIntegerType(poConstant->field_type) )
+                adfDoubleConstants.push_back(
+                    static_cast<double>(poConstant->int_value));
+            else
+                return false;
+        }
+    }
+    else if( IsIntegerType(eLeftType) )
+    {
+        if( !IsIntegerType(poColumn->field_type) )
+            return false;
+        oInstr.eOpcode = Opcode::INT_CMP;
+        oInstr.nFirstConstant = static_cast<int>(anIntConstants.size());
+        for( const auto poConstant: apoConstants )
+        {
+            if( !IsIntegerType(poConstant->field_type) )
+                return false;
+            anIntConstants.push_back(poConstant->int_value);
+        }
+    }
+    else if( poColumn->field_type == SWQ_STRING &&
+             eOp != SWQ_LIKE && eOp != SWQ_ILIKE )
+    {
+        oInstr.eOpcode = Opcode::STRING_CMP;
+        oInstr.nFirstConstant = static_cast<int>(aosStringConstants.size());
+        for( const auto poConstant: apoConstants )
+        {
+            if( poConstant->field_type != SWQ_STRING )
+                return false;
+            aosStringConstants.push_back(poConstant->string_value);
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    if( (eOp == SWQ_BETWEEN && nConstantCount != 2) ||
+        (eOp != SWQ_BETWEEN && eOp != SWQ_IN && nConstantCount != 1) )
+        return false;
+
+    // For string equality, SWQGeneralEvaluator() special cases operands
+    // with a timezone, and compares the column second when it is on the
+    // right hand side.
+    if( oInstr.eOpcode == Opcode::STRING_CMP && eOp == SWQ_EQ &&
+        iFirstConstant == 0 )
+        return false;
+
+    aoInstructions.push_back(oInstr);
+    return true;
+}
+
+/************************************************************************/
+/*                          Program::Compile()                          */
+/************************************************************************/
+
+bool OGRFeatureQuery::Program::Compile( const swq_expr_node* poNode,
+                                        OGRFeatureDefn* poDefn,
+                                        int nDepth )
+{
+    if( nDepth >= MAX_STACK_DEPTH || poNode->eNodeType != SNT_OPERATION ||
+        poNode->field_type != SWQ_BOOLEAN )
+        return false;
+
+    switch( poNode->nOperation )
+    {
+        case SWQ_AND:
+        case SWQ_OR:
+        {
+            if( poNode->nSubExprCount != 2 ||
+                !Compile(poNode->papoSubExpr[0], poDefn, nDepth + 1) ||
+                !Compile(poNode->papoSubExpr[1], poDefn, nDepth + 1) )
+                return false;
+            Instruction oInstr;
+            oInstr.eOpcode = poNode->nOperation == SWQ_AND ?
+                                            Opcode::AND : Opcode::OR;
+            aoInstructions.push_back(oInstr);
+            return true;
+        }
+
+        case SWQ_NOT:
+        {
+            if( poNode->nSubExprCount != 1 ||
+                !Compile(poNode->papoSubExpr[0], poDefn, nDepth + 1) )
+                return false;
+            Instruction oInstr;
+            oInstr.eOpcode = Opcode::NOT;
+            aoInstructions.push_back(oInstr);
+            return true;
+        }
+
+        case SWQ_ISNULL:
+        {
+            if( poNode->nSubExprCount != 1 ||
+                !OGRFeatureQueryIsCompilableColumn(poNode->papoSubExpr[0],
+                                                   poDefn) )
+                return false;
+            Instruction oInstr;
+            oInstr.eOpcode = Opcode::IS_NULL;
+            oInstr.iField = OGRFeatureFetcherFixFieldIndex(
+                poDefn, poNode->papoSubExpr[0]->field_index);
+            aoInstructions.push_back(oInstr);
+            return true;
+        }
+
+        case SWQ_EQ:
+        case SWQ_NE:
+        case SWQ_GE:
+        case SWQ_LE:
+        case SWQ_LT:
+        case SWQ_GT:
+        case SWQ_IN:
+        case SWQ_BETWEEN:
+            return CompileComparison(poNode, poDefn);
+
+        default:
+            return false;
+    }
+}
+
+/************************************************************************/
+/*                       OGRFeatureQueryCompare()                       */
+/************************************************************************/
+
+// Use the operators directly, so that NaN behaves as in
+// SWQGeneralEvaluator().
+template<class T> static bool OGRFeatureQueryCompare( swq_op eOp,
+                                                      T a, T b )
+{
+    switch( eOp )
+    {
+        case SWQ_EQ: return a == b;
+        case SWQ_NE: return a != b;
+        case SWQ_GE: return a >= b;
+        case SWQ_LE: return a <= b;
+        case SWQ_LT: return a < b;
+        case SWQ_GT: return a > b;
+        default:
+            CPLAssert(false);
+            return false;
+    }
+}
+
+static bool OGRFeatureQueryCompare( swq_op eOp,
+                                    const char* pszA, const char* pszB )
+{
+    return OGRFeatureQueryCompare(eOp, STRCASECMP(pszA, pszB), 0);
+}
+
+template<class T> static bool OGRFeatureQueryCompareValues(
+                                        swq_op eOp, T val,
+                                        const T* pConstants, int nCount )
+{
+    switch( eOp )
+    {
+        case SWQ_BETWEEN:
+            return OGRFeatureQueryCompare(SWQ_GE, val, pConstants[0]) &&
+                   OGRFeatureQueryCompare(SWQ_LE, val, pConstants[1]);
+        case SWQ_IN:
+            for( int i = 0; i < nCount; i++ )
+            {
+                if( OGRFeatureQueryCompare(SWQ_EQ, val, pConstants[i]) )
+                    return true;
+            }
+            return false;
+        default:
+            return OGRFeatureQueryCompare(eOp, val, pConstants[0]);
+    }
+}
+
+/************************************************************************/
+/*                         Program::Evaluate()                          */
+/************************************************************************/
+
+bool OGRFeatureQuery::Program::Evaluate( OGRFeature* poFeature ) const
+{
+    bool abStack[MAX_STACK_DEPTH + 1];
+    int nStackSize = 0;
+
+    for( const auto& oInstr: aoInstructions )
+    {
+        bool bRes = false;
+        switch( oInstr.eOpcode )
+        {
+            case Opcode::AND:
+                --nStackSize;
+                bRes = abStack[nStackSize - 1] && abStack[nStackSize];
+                --nStackSize;
+                break;
+
+            case Opcode::OR:
+                --nStackSize;
+                bRes = abStack[nStackSize - 1] || abStack[nStackSize];
+                --nStackSize;
+                break;
+
+            case Opcode::NOT:
+                --nStackSize;
+                bRes = !abStack[nStackSize];
+                break;
+
+            case Opcode::IS_NULL:
+                bRes = !poFeature->IsFieldSetAndNotNull(oInstr.iField);
+                break;
+
+            case Opcode::INT_CMP:
+            {
+                if( !poFeature->IsFieldSetAndNotNull(oInstr.iField) )
+                    break;
+                const GIntBig nVal = oInstr.eFieldType == SWQ_INTEGER64 ?
+                    poFeature->GetFieldAsInteger64(oInstr.iField) :
+                    static_cast<GIntBig>(
+                        poFeature->GetFieldAsInteger(oInstr.iField));
+                bRes = OGRFeatureQueryCompareValues(
+                    oInstr.eCmpOp, nVal,
+                    anIntConstants.data() + oInstr.nFirstConstant,
+                    oInstr.nConstantCount);
+                break;
+            }
+
+            case Opcode::DOUBLE_CMP:
+            {
+                if( !poFeature->IsFieldSetAndNotNull(oInstr.iField) )
+                    break;
+                double dfVal = 0;
+                if( oInstr.eFieldType == SWQ_FLOAT )
+                    dfVal = poFeature->GetFieldAsDouble(oInstr.iField);
+                else if( oInstr.eFieldType == SWQ_INTEGER64 )
+                    dfVal = static_cast<double>(
+                        poFeature->GetFieldAsInteger64(oInstr.iField));
+                else
+                    dfVal = poFeature->GetFieldAsInteger(oInstr.iField);
+                bRes = OGRFeatureQueryCompareValues(
+                    oInstr.eCmpOp, dfVal,
+                    adfDoubleConstants.data() + oInstr.nFirstConstant,
+                    oInstr.nConstantCount);
+                break;
+            }
+
+            case Opcode::STRING_CMP:
+            {
+                if( !poFeature->IsFieldSetAndNotNull(oInstr.iField) )
+                    break;
+                const char* pszVal =
+                    poFeature->GetFieldAsString(oInstr.iField);
+                const std::string& osConstant =
+                    aosStringConstants[oInstr.nFirstConstant];
+                const size_t nValLen = strlen(pszVal);
+                if( oInstr.eCmpOp == SWQ_EQ && nValLen > 3 &&
+                    osConstant.size() > 3 )
+                {
+                    // Same timezone tolerant comparison as
+                    // SWQGeneralEvaluator().
+                    if( strcmp(pszVal + nValLen - 3, "+00") == 0 &&
+                        osConstant[osConstant.size() - 3] == ':' )
+                    {
+                        bRes = EQUALN(pszVal, osConstant.c_str(),
+                                      osConstant.size());
+                        break;
+                    }
+                    if( pszVal[nValLen - 3] == ':' &&
+                        strcmp(osConstant.c_str() + osConstant.size() - 3,
+                               "+00") == 0 )
+                    {
+                        bRes = EQUALN(pszVal, osConstant.c_str(), nValLen);
+                        break;
+                    }
+                }
+                bRes = OGRFeatureQueryCompareValues(
+                    oInstr.eCmpOp, pszVal,
+                    apszStringConstants.data() + oInstr.nFirstConstant,
+                    oInstr.nConstantCount);
+                break;
+            }
+        }
+        abStack[nStackSize++] = bRes;
+    }
+
+    CPLAssert( nStackSize == 1 );
+    return abStack[0];
+}
+
 /************************************************************************/
 /*                              Evaluate()                              */
 /************************************************************************/
@@ -333,6 +796,9 @@ int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
     if( pSWQExpr == nullptr )
         return FALSE;
 
+    if( poProgram )
+        return poProgram->Evaluate(poFeature);
+
     swq_expr_node *poResult =
         static_cast<swq_expr_node *>(pSWQExpr)->
             Evaluate(OGRFeatureFetcher, poFeature);
@@ -351,6 +817,224 @@ int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
     return bLogicalResult;
 }
 
+/************************************************************************/
+/*                    OGRFeatureQueryGetIndexBound()                    */
+/*                                                                      */
+/*      Convert a constant used as a range bound to the type of the     */
+/*      indexed field. For integer fields, non integral bounds are      */
+/*      rounded towards the inside of the range.                        */
+/************************************************************************/
+
+static bool OGRFeatureQueryGetIndexBound( OGRFieldType eType,
+                                          const swq_expr_node *poValue,
+                                          bool bLowerBound,
+                                          OGRField &sBound,
+                                          bool &bIncluded )
+{
+    if( poValue->eNodeType != SNT_CONSTANT || poValue->is_null )
+        return false;
+
+    switch( eType )
+    {
+      case OFTInteger:
+      case OFTInteger64:
+      {
+        GIntBig nVal = 0;
+        if( poValue->field_type == SWQ_INTEGER ||
+            poValue->field_type == SWQ_INTEGER64 )
+        {
+            nVal = poValue->int_value;
+        }
+        else if( poValue->field_type == SWQ_FLOAT )
+        {
+            const double dfVal = poValue->float_value;
+            const double dfRounded =
+                bLowerBound ? std::ceil(dfVal) : std::floor(dfVal);
+            // Also rejects NaN.
+            if( !(dfRounded >= -9.2e18 && dfRounded <= 9.2e18) )
+                return false;
+            if( dfRounded != dfVal )
+                bIncluded = true;
+            nVal = static_cast<GIntBig>(dfRounded);
+        }
+        else
+        {
+            return false;
+        }
+
+        if( eType == OFTInteger )
+        {
+            if( nVal < INT_MIN || nVal > INT_MAX )
+                return false;
+            sBound.Integer = static_cast<int>(nVal);
+        }
+        else
+        {
+            sBound.Integer64 = nVal;
+        }
+        return true;
+      }
+
+      case OFTReal:
+        if( poValue->field_type == SWQ_FLOAT )
+            sBound.Real = poValue->float_value;
+        else if( poValue->field_type == SWQ_INTEGER ||
+                 poValue->field_type == SWQ_INTEGER64 )
+            sBound.Real = static_cast<double>(poValue->int_value);
+        else
+            return false;
+        return true;
+
+      case OFTString:
+        if( poValue->field_type != SWQ_STRING ||
+            poValue->string_value == nullptr )
+            return false;
+        sBound.String = poValue->string_value;
+        return true;
+
+      default:
+        break;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                      OGRFeatureQueryRangeRequest                     */
+/*                                                                      */
+/*      Comparison, BETWEEN, IS NULL or LIKE 'prefix%' test on a        */
+/*      single column, that can be answered by an index supporting      */
+/*      range queries.                                                  */
+/************************************************************************/
+
+namespace {
+struct OGRFeatureQueryRangeRequest
+{
+    enum class Type { RANGE, PREFIX, IS_NULL };
+
+    OGRAttrIndex *poIndex = nullptr;
+    Type          eType = Type::RANGE;
+    bool          bHasMin = false;
+    OGRField      sMin{};
+    bool          bMinIncluded = true;
+    bool          bHasMax = false;
+    OGRField      sMax{};
+    bool          bMaxIncluded = true;
+    CPLString     osPrefix{};
+};
+} // namespace
+
+static bool OGRFeatureQueryGetRangeRequest( swq_expr_node *psExpr,
+                                            OGRLayer *poLayer,
+                                            OGRFeatureQueryRangeRequest &sReq )
+{
+    int nOperation = psExpr->nOperation;
+    swq_expr_node *poColumn = nullptr;
+    swq_expr_node *poValue = nullptr;
+
+    if( (nOperation == SWQ_LT || nOperation == SWQ_LE ||
+         nOperation == SWQ_GT || nOperation == SWQ_GE) &&
+        psExpr->nSubExprCount == 2 )
+    {
+        poColumn = psExpr->papoSubExpr[0];
+        poValue = psExpr->papoSubExpr[1];
+        if( poColumn->eNodeType != SNT_COLUMN )
+        {
+            // "constant < column" is "column > constant"
+            std::swap(poColumn, poValue);
+            nOperation = nOperation == SWQ_LT ? SWQ_GT :
+                         nOperation == SWQ_LE ? SWQ_GE :
+                         nOperation == SWQ_GT ? SWQ_LT : SWQ_LE;
+        }
+    }
+    else if( (nOperation == SWQ_BETWEEN && psExpr->nSubExprCount == 3) ||
+             (nOperation == SWQ_ISNULL && psExpr->nSubExprCount == 1) ||
+             ((nOperation == SWQ_LIKE || nOperation == SWQ_ILIKE) &&
+              psExpr->nSubExprCount == 2) )
+    {
+        poColumn = psExpr->papoSubExpr[0];
+        if( psExpr->nSubExprCount >= 2 )
+            poValue = psExpr->papoSubExpr[1];
+    }
+    else
+    {
+        return false;
+    }
+
+    if( poColumn->eNodeType != SNT_COLUMN ||
+        (poValue != nullptr && poValue->eNodeType != SNT_CONSTANT) )
+        return false;
+
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    const int nIdx =
+        OGRFeatureFetcherFixFieldIndex(poDefn, poColumn->field_index);
+    if( nIdx < 0 || nIdx >= poDefn->GetFieldCount() )
+        return false;
+
+    sReq.poIndex = poLayer->GetIndex()->GetFieldIndex(nIdx);
+    if( sReq.poIndex == nullptr || !sReq.poIndex->SupportsRangeQueries() )
+        return false;
+
+    const OGRFieldType eFieldType = poDefn->GetFieldDefn(nIdx)->GetType();
+
+    switch( nOperation )
+    {
+      case SWQ_GT:
+      case SWQ_GE:
+        sReq.bHasMin = true;
+        sReq.bMinIncluded = nOperation == SWQ_GE;
+        return OGRFeatureQueryGetIndexBound(eFieldType, poValue, true,
+                                            sReq.sMin, sReq.bMinIncluded);
+
+      case SWQ_LT:
+      case SWQ_LE:
+        sReq.bHasMax = true;
+        sReq.bMaxIncluded = nOperation == SWQ_LE;
+        return OGRFeatureQueryGetIndexBound(eFieldType, poValue, false,
+                                            sReq.sMax, sReq.bMaxIncluded);
+
+      case SWQ_BETWEEN:
+        sReq.bHasMin = true;
+        sReq.bHasMax = true;
+        return OGRFeatureQueryGetIndexBound(eFieldType, poValue, true,
+                                            sReq.sMin, sReq.bMinIncluded) &&
+               OGRFeatureQueryGetIndexBound(eFieldType,
+                                            psExpr->papoSubExpr[2], false,
+                                            sReq.sMax, sReq.bMaxIncluded);
+
+      case SWQ_ISNULL:
+        sReq.eType = OGRFeatureQueryRangeRequest::Type::IS_NULL;
+        return true;
+
+      default:
+      {
+        // Only LIKE 'prefix%' patterns, without other wildcards.
+        if( eFieldType != OFTString || poValue->field_type != SWQ_STRING ||
+            poValue->is_null || poValue->string_value == nullptr )
+            return false;
+        const char *pszPattern = poValue->string_value;
+        const size_t nPrefixLen = strcspn(pszPattern, "%_");
+        if( strcmp(pszPattern + nPrefixLen, "%") != 0 )
+            return false;
+        sReq.osPrefix.assign(pszPattern, nPrefixLen);
+
+        // Indexes of strings are case-insensitive, so a case-sensitive
+        // LIKE can only use them if the prefix has no cased character.
+        if( nOperation == SWQ_LIKE &&
+            !CPLTestBool(CPLGetConfigOption("OGR_SQL_LIKE_AS_ILIKE",
+                                            "FALSE")) )
+        {
+            for( const char ch: sReq.osPrefix )
+            {
+                if( (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') )
+                    return false;
+            }
+        }
+        sReq.eType = OGRFeatureQueryRangeRequest::Type::PREFIX;
+        return true;
+      }
+    }
+}
+
 /************************************************************************/
 /*                            CanUseIndex()                             */
 /************************************************************************/
@@ -380,6 +1064,10 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
                CanUseIndex(psExpr->papoSubExpr[1], poLayer);
     }
 
+    OGRFeatureQueryRangeRequest sReq;
+    if( OGRFeatureQueryGetRangeRequest(psExpr, poLayer, sReq) )
+        return TRUE;
+
     if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN)
         || psExpr->nSubExprCount < 2 )
         return FALSE;
@@ -411,9 +1099,10 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
 /*      available indices, or an "OGRNullFID" terminated list of        */
 /*      FIDs if it can.                                                 */
 /*                                                                      */
-/*      For now we only support equality tests on a single indexed      */
-/*      attribute field.  Eventually we should make this support        */
-/*      multi-part queries with ranges.                                 */
+/*      Equality and IN tests are supported by all indexes, and         */
+/*      comparisons, BETWEEN, IS NULL and LIKE 'prefix%' tests by       */
+/*      indexes supporting range queries. They can be combined with     */
+/*      AND and OR.                                                     */
 /************************************************************************/
 
 static int CompareGIntBig( const void *pa, const void *pb )
@@ -604,6 +1293,33 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
         return panFIDList;
     }
 
+    OGRFeatureQueryRangeRequest sReq;
+    if( OGRFeatureQueryGetRangeRequest(psExpr, poLayer, sReq) )
+    {
+        int nFIDCount32 = 0;
+        GIntBig *panFIDs = nullptr;
+        switch( sReq.eType )
+        {
+          case OGRFeatureQueryRangeRequest::Type::RANGE:
+            panFIDs = sReq.poIndex->GetRangeMatches(
+                sReq.bHasMin ? &sReq.sMin : nullptr, sReq.bMinIncluded,
+                sReq.bHasMax ? &sReq.sMax : nullptr, sReq.bMaxIncluded,
+                &nFIDCount32);
+            break;
+
+          case OGRFeatureQueryRangeRequest::Type::PREFIX:
+            panFIDs = sReq.poIndex->GetPrefixMatches(sReq.osPrefix,
+                                                     &nFIDCount32);
+            break;
+
+          case OGRFeatureQueryRangeRequest::Type::IS_NULL:
+            panFIDs = sReq.poIndex->GetNullMatches(&nFIDCount32);
+            break;
+        }
+        nFIDCount = nFIDCount32;
+        return panFIDs;
+    }
+
     if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN)
         || psExpr->nSubExprCount < 2 )
         return nullptr;
@@ -955,30 +955,11 @@ OGRBoolean OGRGeometryCollection::Equals( const OGRGeometry * poOther ) const
 OGRErr OGRGeometryCollection::transform( OGRCoordinateTransformation *poCT )
 
 {
-    int iGeom  = 0;
-    for( auto&& poSubGeom: *this )
-    {
-        const OGRErr eErr = poSubGeom->transform( poCT );
-        if( eErr != OGRERR_NONE )
-        {
-            if( iGeom != 0 )
-            {
-                CPLDebug("OGR",
-                         "OGRGeometryCollection::transform() failed for a "
-                         "geometry other than the first, meaning some "
-                         "geometries are transformed and some are not." );
-
-                return OGRERR_FAILURE;
-            }
-
-            return eErr;
-        }
-        iGeom ++;
-    }
-
-    assignSpatialReference( poCT->GetTargetCS() );
-
-    return OGRERR_NONE;
+    // Transform the points of all the sub-geometries at once.
+    OGRGeometry* poThis = this;
+    OGRErr eErr = OGRERR_NONE;
+    poCT->TransformGeometries( 1, &poThis, &eErr );
+    return eErr;
 }
 
 /************************************************************************/
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Internal helpers to access the values of Arrow C data interface
+ *           arrays, used by OGRLayer::WriteArrowBatch() implementations.
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef OGRLAYERARROW_H_INCLUDED
+#define OGRLAYERARROW_H_INCLUDED
+
+#include "cpl_port.h"
+#include "ogr_recordbatch.h"
+
+#include <cstring>
+#include <vector>
+
+class OGRLayer;
+
+/*! @cond Doxygen_Suppress */
+
+/** Role of a child of the struct array passed to WriteArrowBatch() */
+typedef enum
+{
+    OAC_FID,
+    OAC_FIELD,
+    OAC_GEOM_FIELD
+} OGRArrowColumnKind;
+
+/** Layer field that receives the values of a child of the struct array */
+struct OGRArrowColumnMapping
+{
+    OGRArrowColumnKind eKind = OAC_FIELD;
+    int                iField = -1;
+};
+
+bool CPL_DLL OGRArrowGetColumnMapping(
+                            OGRLayer* poLayer,
+                            const struct ArrowSchema* schema,
+                            const struct ArrowArray* array,
+                            std::vector<OGRArrowColumnMapping>& aoMapping);
+
+// In the below helpers, iRow is the index of the value in psArray, not
+// including psArray->offset.
+
+inline bool OGRArrowIsNull(const struct ArrowArray* psArray, int64_t iRow)
+{
+    if( psArray->n_buffers == 0 || psArray->buffers[0] == nullptr )
+        return false;
+    const int64_t i = iRow + psArray->offset;
+    return (static_cast<const GByte*>(psArray->buffers[0])[i / 8] &
+            (1 << (i % 8))) == 0;
+}
+
+inline GIntBig OGRArrowGetInteger(const struct ArrowArray* psArray,
+                                  const char* pszFormat, int64_t iRow)
+{
+    const int64_t i = iRow + psArray->offset;
+    switch( pszFormat[0] )
+    {
+        case 'b':
+            return (static_cast<const GByte*>(psArray->buffers[1])[i / 8] >>
+                    (i % 8)) & 1;
+        case 's':
+            return static_cast<const int16_t*>(psArray->buffers[1])[i];
+        case 'i':
+            return static_cast<const int32_t*>(psArray->buffers[1])[i];
+        case 'f':
+            return static_cast<GIntBig>(
+                static_cast<const float*>(psArray->buffers[1])[i]);
+        case 'g':
+            return static_cast<GIntBig>(
+                static_cast<const double*>(psArray->buffers[1])[i]);
+        default:
+            return static_cast<const int64_t*>(psArray->buffers[1])[i];
+    }
+}
+
+inline double OGRArrowGetReal(const struct ArrowArray* psArray,
+                              const char* pszFormat, int64_t iRow)
+{
+    const int64_t i = iRow + psArray->offset;
+    if( pszFormat[0] == 'f' )
+        return static_cast<const float*>(psArray->buffers[1])[i];
+    if( pszFormat[0] == 'g' )
+        return static_cast<const double*>(psArray->buffers[1])[i];
+    return static_cast<double>(OGRArrowGetInteger(psArray, pszFormat, iRow));
+}
+
+// For string ("u") and binary ("z") arrays, with 32 bit offsets.
+inline const GByte* OGRArrowGetBinary(const struct ArrowArray* psArray,
+                                      int64_t iRow, size_t& nSize)
+{
+    const int32_t* panOffsets =
+        static_cast<const int32_t*>(psArray->buffers[1]) + psArray->offset;
+    nSize = static_cast<size_t>(panOffsets[iRow + 1] - panOffsets[iRow]);
+    return static_cast<const GByte*>(psArray->buffers[2]) + panOffsets[iRow];
+}
+
+/*! @endcond */
+
+#endif  /* OGRLAYERARROW_H_INCLUDED */
@@ -759,7 +759,20 @@ OGRErr OGRLinearRing::transform( OGRCoordinateTransformation *poCT )
 {
     const bool bIsClosed = getNumPoints() > 2 && CPL_TO_BOOL(get_IsClosed());
     OGRErr eErr = OGRLineString::transform(poCT);
-    if( bIsClosed && eErr == OGRERR_NONE && !get_IsClosed() )
+    if( bIsClosed && eErr == OGRERR_NONE )
+        OGRLinearRingRestoreClosure(this);
+    return eErr;
+}
+
+/************************************************************************/
+/*                    OGRLinearRingRestoreClosure()                     */
+/************************************************************************/
+
+/* Called after the coordinate transformation of a ring that was closed */
+
+void OGRLinearRingRestoreClosure( OGRLinearRing* poRing )
+{
+    if( !poRing->get_IsClosed() )
     {
         CPLDebug("OGR", "Linearring is not closed after coordinate "
                   "transformation. Forcing last point to be identical to "
@@ -770,11 +783,10 @@ OGRErr OGRLinearRing::transform( OGRCoordinateTransformation *poCT )
         // when reprojecting a cutline with a RPC transform with a DEM that
         // is a VRT whose sources are resampled...
         OGRPoint oStartPoint;
-        StartPoint( &oStartPoint );
+        poRing->StartPoint( &oStartPoint );
 
-        setPoint( getNumPoints()-1, &oStartPoint);
+        poRing->setPoint( poRing->getNumPoints()-1, &oStartPoint);
     }
-    return eErr;
 }
 
 /************************************************************************/
@@ -59,6 +59,7 @@ int DoubleToIntClamp(double dfValue) {
 /** Constructor */
 OGRSimpleCurve::OGRSimpleCurve() :
     nPointCount(0),
+    m_nPointCapacity(0),
     paoPoints(nullptr),
     padfZ(nullptr),
     padfM(nullptr)
@@ -80,6 +81,7 @@ OGRSimpleCurve::OGRSimpleCurve() :
 OGRSimpleCurve::OGRSimpleCurve( const OGRSimpleCurve& other ) :
     OGRCurve(other),
     nPointCount(0),
+    m_nPointCapacity(0),
     paoPoints(nullptr),
     padfZ(nullptr),
     padfM(nullptr)
@@ -218,12 +220,10 @@ void OGRSimpleCurve::Make3D()
 {
     if( padfZ == nullptr )
     {
-        if( nPointCount == 0 )
-            padfZ =
-                static_cast<double *>(VSI_CALLOC_VERBOSE(sizeof(double), 1));
-        else
-            padfZ = static_cast<double *>(VSI_CALLOC_VERBOSE(
-                sizeof(double), nPointCount));
+        // Size to the capacity, so that the array does not need to be
+        // reallocated when points are added within it.
+        padfZ = static_cast<double *>(VSI_CALLOC_VERBOSE(
+            sizeof(double), std::max(1, m_nPointCapacity)));
         if( padfZ == nullptr )
         {
             flags &= ~OGR_G_3D;
@@ -259,12 +259,10 @@ void OGRSimpleCurve::AddM()
 {
     if( padfM == nullptr )
     {
-        if( nPointCount == 0 )
-            padfM =
-                static_cast<double *>(VSI_CALLOC_VERBOSE(sizeof(double), 1));
-        else
-            padfM = static_cast<double *>(
-                VSI_CALLOC_VERBOSE(sizeof(double), nPointCount));
+        // Size to the capacity, so that the array does not need to be
+        // reallocated when points are added within it.
+        padfM = static_cast<double *>(VSI_CALLOC_VERBOSE(
+            sizeof(double), std::max(1, m_nPointCapacity)));
         if( padfM == nullptr )
         {
             flags &= ~OGR_G_MEASURED;
@@ -405,6 +403,11 @@ double OGRSimpleCurve::getM( int iVertex ) const
  * geometry before setPoint() is used to assign them to avoid reallocating
  * the array larger with each call to addPoint().
  *
+ * Reducing the number of points (to a non-zero value) keeps the allocated
+ * arrays, so that a geometry object that is reused, for example when reading
+ * features sequentially, does not need to reallocate them. Setting it to 0
+ * releases them.
+ *
  * This method has no SFCOM analog.
  *
  * @param nNewPointCount the new number of points for geometry.
@@ -429,70 +432,103 @@ void OGRSimpleCurve::setNumPoints( int nNewPointCount, int bZeroizeNewContent )
         padfM = nullptr;
 
         nPointCount = 0;
+        m_nPointCapacity = 0;
         return;
     }
 
-    if( nNewPointCount > nPointCount )
+    if( nNewPointCount > m_nPointCapacity )
     {
         // Overflow of sizeof(OGRRawPoint) * nNewPointCount can only occur on
         // 32 bit, but we don't really want to allocate 2 billion points even on
         // 64 bit...
-        if( nNewPointCount > std::numeric_limits<int>::max() /
-                                    static_cast<int>(sizeof(OGRRawPoint)) )
+        constexpr int nMaxCapacity = std::numeric_limits<int>::max() /
+                                    static_cast<int>(sizeof(OGRRawPoint));
+        if( nNewPointCount > nMaxCapacity )
         {
             CPLError(CE_Failure, CPLE_IllegalArg, "Too big point count.");
             return;
         }
+
+        // When growing an existing array (typically through addPoint()),
+        // reserve some extra room so that repeated additions do not
+        // reallocate each time. The first allocation is exact.
+        int nNewCapacity = nNewPointCount;
+        if( m_nPointCapacity > 0 &&
+            m_nPointCapacity <= nMaxCapacity - m_nPointCapacity / 3 )
+        {
+            nNewCapacity = std::max(nNewPointCount,
+                                    m_nPointCapacity + m_nPointCapacity / 3);
+        }
+
         OGRRawPoint* paoNewPoints = static_cast<OGRRawPoint *>(
             VSI_REALLOC_VERBOSE(paoPoints,
-                                sizeof(OGRRawPoint) * nNewPointCount));
+                                sizeof(OGRRawPoint) * nNewCapacity));
         if( paoNewPoints == nullptr )
         {
             return;
         }
         paoPoints = paoNewPoints;
 
-        if( bZeroizeNewContent )
-        {
-            // gcc 8.0 (dev) complains about -Wclass-memaccess since
-            // OGRRawPoint() has a constructor. So use a void* pointer.  Doing
-            // the memset() here is correct since the constructor sets to 0.  We
-            // could instead use a std::fill(), but at every other place, we
-            // treat this class as a regular POD (see above use of realloc())
-            void* dest = static_cast<void*>(paoPoints + nPointCount);
-            memset( dest,
-                    0, sizeof(OGRRawPoint) * (nNewPointCount - nPointCount) );
-        }
-
-        if( flags & OGR_G_3D )
+        if( (flags & OGR_G_3D) || padfZ != nullptr )
         {
             double* padfNewZ = static_cast<double *>(
-                VSI_REALLOC_VERBOSE(padfZ, sizeof(double) * nNewPointCount));
+                VSI_REALLOC_VERBOSE(padfZ, sizeof(double) * nNewCapacity));
             if( padfNewZ == nullptr )
             {
                 return;
             }
             padfZ = padfNewZ;
-            if( bZeroizeNewContent )
-                memset( padfZ + nPointCount, 0,
-                    sizeof(double) * (nNewPointCount - nPointCount) );
         }
 
-        if( flags & OGR_G_MEASURED )
+        if( (flags & OGR_G_MEASURED) || padfM != nullptr )
         {
             double* padfNewM = static_cast<double *>(
-                VSI_REALLOC_VERBOSE(padfM, sizeof(double) * nNewPointCount));
+                VSI_REALLOC_VERBOSE(padfM, sizeof(double) * nNewCapacity));
             if( padfNewM == nullptr )
             {
                 return;
             }
             padfM = padfNewM;
-            if( bZeroizeNewContent )
-                memset( padfM + nPointCount, 0,
-                    sizeof(double) * (nNewPointCount - nPointCount) );
+        }
+
+        m_nPointCapacity = nNewCapacity;
+    }
+    else
+    {
+        if( (flags & OGR_G_3D) && padfZ == nullptr )
+        {
+            padfZ = static_cast<double *>(
+                VSI_CALLOC_VERBOSE(sizeof(double), m_nPointCapacity));
+            if( padfZ == nullptr )
+                return;
+        }
+        if( (flags & OGR_G_MEASURED) && padfM == nullptr )
+        {
+            padfM = static_cast<double *>(
+                VSI_CALLOC_VERBOSE(sizeof(double), m_nPointCapacity));
+            if( padfM == nullptr )
+                return;
         }
     }
 
+    if( nNewPointCount > nPointCount && bZeroizeNewContent )
+    {
+        // gcc 8.0 (dev) complains about -Wclass-memaccess since
+        // OGRRawPoint() has a constructor. So use a void* pointer.  Doing
+        // the memset() here is correct since the constructor sets to 0.  We
+        // could instead use a std::fill(), but at every other place, we
+        // treat this class as a regular POD (see above use of realloc())
+        void* dest = static_cast<void*>(paoPoints + nPointCount);
+        memset( dest,
+                0, sizeof(OGRRawPoint) * (nNewPointCount - nPointCount) );
+        if( padfZ )
+            memset( padfZ + nPointCount, 0,
+                sizeof(double) * (nNewPointCount - nPointCount) );
+        if( padfM )
+            memset( padfM + nPointCount, 0,
+                sizeof(double) * (nNewPointCount - nPointCount) );
+    }
+
     nPointCount = nNewPointCount;
 }
 
@@ -1759,6 +1795,7 @@ OGRErr OGRSimpleCurve::importFromWkt( const char ** ppszInput )
     pszInput = OGRWktReadPointsM( pszInput, &paoPoints, &padfZ, &padfM,
                                   &flagsFromInput,
                                   &nMaxPoints, &nPointCount );
+    m_nPointCapacity = nPointCount;
     if( pszInput == nullptr )
         return OGRERR_CORRUPT_DATA;
 
@@ -2386,6 +2423,35 @@ OGRErr OGRSimpleCurve::transform( OGRCoordinateTransformation *poCT )
     poCT->Transform( nPointCount, xyz, xyz + nPointCount,
                      xyz+nPointCount*2, nullptr, pabSuccess );
 
+    const OGRErr eErr =
+        OGRSimpleCurveSetTransformedPoints(this, nPointCount,
+                                           xyz, xyz + nPointCount,
+                                           xyz + nPointCount * 2,
+                                           pabSuccess);
+    CPLFree( xyz );
+    CPLFree( pabSuccess );
+
+    if( eErr == OGRERR_NONE )
+        assignSpatialReference( poCT->GetTargetCS() );
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                 OGRSimpleCurveSetTransformedPoints()                 */
+/************************************************************************/
+
+/* Set the points of a curve from the result of a coordinate transformation
+ * of its nPointCount points. Points that failed to transform are dropped if
+ * OGR_ENABLE_PARTIAL_REPROJECTION is enabled, otherwise the curve is left
+ * unmodified and OGRERR_FAILURE is returned. The input arrays are modified. */
+
+OGRErr OGRSimpleCurveSetTransformedPoints( OGRSimpleCurve* poCurve,
+                                           int nPointCount,
+                                           double* padfX, double* padfY,
+                                           double* padfZ,
+                                           const int* pabSuccess )
+{
     const char* pszEnablePartialReprojection = nullptr;
 
     int j = 0;  // Used after for.
@@ -2393,9 +2459,9 @@ OGRErr OGRSimpleCurve::transform( OGRCoordinateTransformation *poCT )
     {
         if( pabSuccess[i] )
         {
-            xyz[j] = xyz[i];
-            xyz[j+nPointCount] = xyz[i+nPointCount];
-            xyz[j+2*nPointCount] = xyz[i+2*nPointCount];
+            padfX[j] = padfX[i];
+            padfY[j] = padfY[i];
+            padfZ[j] = padfZ[i];
             j++;
         }
         else
@@ -2428,14 +2494,10 @@ OGRErr OGRSimpleCurve::transform( OGRCoordinateTransformation *poCT )
                     }
                 }
 
-                CPLFree( xyz );
-                CPLFree( pabSuccess );
                 return OGRERR_FAILURE;
             }
             else if( !CPLTestBool(pszEnablePartialReprojection) )
             {
-                CPLFree( xyz );
-                CPLFree( pabSuccess );
                 return OGRERR_FAILURE;
             }
         }
@@ -2443,17 +2505,11 @@ OGRErr OGRSimpleCurve::transform( OGRCoordinateTransformation *poCT )
 
     if( j == 0 && nPointCount != 0 )
     {
-        CPLFree( xyz );
-        CPLFree( pabSuccess );
         return OGRERR_FAILURE;
     }
 
-    setPoints( j, xyz, xyz+nPointCount,
-            ( padfZ ) ? xyz+nPointCount*2 : nullptr);
-    CPLFree( xyz );
-    CPLFree( pabSuccess );
-
-    assignSpatialReference( poCT->GetTargetCS() );
+    poCurve->setPoints( j, padfX, padfY,
+                        poCurve->Is3D() ? padfZ : nullptr );
 
     return OGRERR_NONE;
 }
@@ -2596,6 +2652,7 @@ void OGRSimpleCurve::segmentize( double dfMaxLength )
     CPLFree(paoPoints);
     paoPoints = paoNewPoints;
     nPointCount = nNewPointCount;
+    m_nPointCapacity = nNewPointCount;
 
     if( padfZ != nullptr )
     {
@@ -2817,10 +2874,12 @@ OGRLineString* OGRLineString::TransferMembersAndDestroy(
         poDst->flags |= OGR_G_MEASURED;
     poDst->assignSpatialReference(poSrc->getSpatialReference());
     poDst->nPointCount = poSrc->nPointCount;
+    poDst->m_nPointCapacity = poSrc->m_nPointCapacity;
     poDst->paoPoints = poSrc->paoPoints;
     poDst->padfZ = poSrc->padfZ;
     poDst->padfM = poSrc->padfM;
     poSrc->nPointCount = 0;
+    poSrc->m_nPointCapacity = 0;
     poSrc->paoPoints = nullptr;
     poSrc->padfZ = nullptr;
     poSrc->padfM = nullptr;
@@ -32,8 +32,15 @@
 #define OGR_CSV_H_INCLUDED
 
 #include "ogrsf_frmts.h"
+#include "cpl_worker_thread_pool.h"
 
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <string>
+#include <vector>
 
 #if defined(_MSC_VER) && _MSC_VER <= 1600 // MSVC <= 2010
 # define GDAL_OVERRIDE
@@ -53,6 +60,7 @@ typedef enum
 } OGRCSVGeometryFormat;
 
 class OGRCSVDataSource;
+struct OGRCSVChunk;
 
 char **OGRCSVReadParseLineL( VSILFILE *fp, char chDelimiter,
                              bool bDontHonourStrings = false,
@@ -94,6 +102,13 @@ class OGRCSVLayer final: public OGRLayer
     bool                bHasFieldNames;
 
     OGRFeature         *GetNextUnfilteredFeature();
+    OGRFeature         *BuildFeature( char **papszTokens, int nFID,
+                                      CPLString *posWarning = nullptr );
+    bool                MustWarnBadTypeOrWidth(
+                            const CPLString *posWarning ) const;
+    void                WarnBadTypeOrWidth( CPLString *posWarning,
+                                            const char *pszMsg );
+    int                 GetFilterWKTColumn() const;
 
     bool                bNew;
     bool                bInWriteMode;
@@ -142,8 +157,44 @@ class OGRCSVLayer final: public OGRLayer
 
     StringQuoting       m_eStringQuoting = StringQuoting::IF_AMBIGUOUS;
 
+    // Buffered reading of the records of fpCSV, with the same semantics as
+    // OGRCSVReadParseLineL().
+    std::string         m_osReadBuffer{};
+    size_t              m_nReadBufferPos = 0;
+    size_t              m_nReadBufferSize = 0;
+    size_t              m_nNextLFPos = 0;
+    size_t              m_nNextCRPos = 0;
+    bool                m_bReadBufferEOF = false;
+    std::string         m_osRecord{};
+    std::vector<char *> m_apszTokens{};
+    CPLStringList       m_aosLegacyTokens{};
+
+    void                ResetReadBuffer();
+    bool                FillReadBuffer();
+    bool                ReadLine( std::string &osLine );
+    bool                ReadRecord( std::string &osRecord );
     char              **GetNextLineTokens();
 
+    // Multi-threaded reading: records are grouped into chunks whose
+    // features are built by a pool of worker threads.
+    int                 m_nThreads = 1;
+    size_t              m_nChunkSize = 0;
+    std::mutex          m_oChunkMutex{};
+    std::condition_variable m_oChunkCV{};
+    std::deque<std::unique_ptr<OGRCSVChunk>> m_apoChunks{};
+    std::unique_ptr<OGRCSVChunk> m_poCurChunk{};
+    size_t              m_iInCurChunk = 0;
+    int                 m_nNextChunkFID = 1;
+    bool                m_bNoMoreChunks = false;
+
+    bool                CanUseThreads() const;
+    bool                ReadChunkRecords( OGRCSVChunk *psChunk );
+    void                SubmitChunks();
+    OGRCSVChunk        *GetNextChunk();
+    void                DiscardChunks();
+    static void         ProcessChunkFunc( void *pData );
+    OGRFeature         *GetNextChunkFeature();
+
     static bool         Matches( const char *pszFieldName,
                                  char **papszPossibleNames );
 
@@ -205,6 +256,10 @@ class OGRCSVLayer final: public OGRLayer
     virtual OGRErr      SyncToDisk() override;
 
     OGRErr              WriteHeader();
+
+  private:
+    // Declared last so that pending jobs are waited for first.
+    std::unique_ptr<CPLJobQueue> m_poJobQueue{};
 };
 
 /************************************************************************/
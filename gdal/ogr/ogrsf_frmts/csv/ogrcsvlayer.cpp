@@ -49,6 +49,7 @@
 #include "cpl_error.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "gdal_thread_pool.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
 #include "ogr_feature.h"
@@ -225,6 +226,201 @@ char **OGRCSVReadParseLineL( VSILFILE *fp, char chDelimiter,
     return papszReturn;
 }
 
+/************************************************************************/
+/*                     OGRCSVSplitRecordInPlace()                       */
+/*                                                                      */
+/*      Same tokenization as CSVSplitLine() without keeping the         */
+/*      leading and closing quotes, but the tokens are written in       */
+/*      place in the record, which must be nul terminated at            */
+/*      pszRecord[nLen]. apszTokens receives pointers to the tokens,    */
+/*      followed by a nullptr.                                          */
+/************************************************************************/
+
+static void OGRCSVSplitRecordInPlace( char *pszRecord, size_t nLen,
+                                      char chDelimiter, bool bMergeDelimiter,
+                                      std::vector<char *> &apszTokens )
+
+{
+    apszTokens.clear();
+
+    char *const pszEnd = pszRecord + nLen;
+    // Tested on the original content, before tokens overwrite it.
+    const bool bEndsWithDelimiter = nLen > 0 && pszEnd[-1] == chDelimiter;
+
+    char *pszIn = pszRecord;
+    // Tokens are never longer than their source, so that the output can
+    // be written behind the input.
+    char *pszOut = pszRecord;
+    char *pszNextQuote =
+        static_cast<char *>(memchr(pszRecord, '"', nLen));
+
+    while( pszIn < pszEnd )
+    {
+        apszTokens.push_back(pszOut);
+        while( true )
+        {
+            if( pszNextQuote != nullptr && pszNextQuote < pszIn )
+            {
+                pszNextQuote = static_cast<char *>(
+                    memchr(pszIn, '"', pszEnd - pszIn));
+            }
+
+            // Unquoted characters, up to the next quote or delimiter.
+            char *const pszLimit = pszNextQuote ? pszNextQuote : pszEnd;
+            char *const pszDelimiter = static_cast<char *>(
+                memchr(pszIn, chDelimiter, pszLimit - pszIn));
+            char *const pszStop = pszDelimiter ? pszDelimiter : pszLimit;
+            memmove(pszOut, pszIn, pszStop - pszIn);
+            pszOut += pszStop - pszIn;
+            pszIn = pszStop;
+            if( pszDelimiter )
+            {
+                pszIn++;
+                if( bMergeDelimiter )
+                {
+                    while( pszIn < pszEnd && *pszIn == chDelimiter )
+                        pszIn++;
+                }
+                break;
+            }
+            if( pszIn == pszEnd )
+                break;
+
+            // Quoted characters. Doubled quotes resolve to one quote.
+            pszIn++;
+            while( true )
+            {
+                char *const pszQuote = static_cast<char *>(
+                    memchr(pszIn, '"', pszEnd - pszIn));
+                char *const pszQuotedEnd = pszQuote ? pszQuote : pszEnd;
+                memmove(pszOut, pszIn, pszQuotedEnd - pszIn);
+                pszOut += pszQuotedEnd - pszIn;
+                pszIn = pszQuotedEnd;
+                if( pszQuote == nullptr )
+                    break;
+                if( pszQuote + 1 < pszEnd && pszQuote[1] == '"' )
+                {
+                    *pszOut = '"';
+                    pszOut++;
+                    pszIn += 2;
+                    continue;
+                }
+                pszIn++;
+                break;
+            }
+        }
+        *pszOut = '\0';
+        pszOut++;
+    }
+
+    // If the last token is an empty token, it must be added now.
+    if( bEndsWithDelimiter )
+        apszTokens.push_back(pszEnd);
+
+    apszTokens.push_back(nullptr);
+}
+
+/************************************************************************/
+/*                         OGRCSVParseNumber()                          */
+/*                                                                      */
+/*      Fast path for the most common numeric values, [-]digits and     */
+/*      [-]digits.digits, with a significand that fits on 53 bits.      */
+/*      Returns CPL_VALUE_INTEGER or CPL_VALUE_REAL, with the values    */
+/*      OGRFeature::SetField() would parse from the string, or          */
+/*      CPL_VALUE_STRING if the generic path must be used.              */
+/************************************************************************/
+
+static CPLValueType OGRCSVParseNumber( const char *pszValue, GIntBig &nValue,
+                                       double &dfValue )
+
+{
+    // A significand on 53 bits divided by a power of ten that is exactly
+    // representable is correctly rounded, hence identical to CPLStrtod().
+    static const double adfPow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18 };
+
+    const char *pszIter = pszValue;
+    const bool bNegative = *pszIter == '-';
+    if( bNegative )
+        pszIter++;
+    if( !(*pszIter >= '0' && *pszIter <= '9') )
+        return CPL_VALUE_STRING;
+
+    GUInt64 nSignificand = 0;
+    int nDigits = 0;
+    int nFracDigits = 0;
+    for( ; *pszIter >= '0' && *pszIter <= '9'; pszIter++ )
+    {
+        if( ++nDigits > 18 )
+            return CPL_VALUE_STRING;
+        nSignificand = nSignificand * 10 + (*pszIter - '0');
+    }
+    if( *pszIter == '.' )
+    {
+        pszIter++;
+        if( !(*pszIter >= '0' && *pszIter <= '9') )
+            return CPL_VALUE_STRING;
+        for( ; *pszIter >= '0' && *pszIter <= '9'; pszIter++ )
+        {
+            if( ++nDigits > 18 )
+                return CPL_VALUE_STRING;
+            nSignificand = nSignificand * 10 + (*pszIter - '0');
+            nFracDigits++;
+        }
+    }
+    if( *pszIter != '\0' ||
+        nSignificand > (static_cast<GUInt64>(1) << 53) )
+        return CPL_VALUE_STRING;
+
+    nValue = bNegative ? -static_cast<GIntBig>(nSignificand)
+                       : static_cast<GIntBig>(nSignificand);
+    dfValue = static_cast<double>(nSignificand) / adfPow10[nFracDigits];
+    // Like strtod(), "-0" is -0.0
+    if( bNegative )
+        dfValue = -dfValue;
+    return nFracDigits == 0 ? CPL_VALUE_INTEGER : CPL_VALUE_REAL;
+}
+
+
+/************************************************************************/
+/*                            OGRCSVChunk                               */
+/************************************************************************/
+
+// Set of records whose features are built by a worker thread.
+struct OGRCSVChunk
+{
+    OGRCSVLayer *poLayer = nullptr;
+    // Records, each one terminated by a nul character.
+    std::string osData{};
+    std::vector<size_t> anRecordOffsets{};
+    int nFirstFID = 0;
+    // Spatial filter at the time the chunk was submitted: records whose
+    // WKT column has an envelope that does not intersect it get no feature.
+    int iFilterWKTColumn = -1;
+    OGREnvelope sFilterEnvelope{};
+
+    // Features of the records, or nullptr for records skipped by the filter.
+    std::vector<OGRFeature *> apoFeatures{};
+    // First warning about a bad value, to be emitted by the calling thread
+    // when the feature of record iWarningRecord is returned.
+    CPLString osWarning{};
+    size_t iWarningRecord = 0;
+
+    bool bDone = false;
+
+    OGRCSVChunk() = default;
+    ~OGRCSVChunk();
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRCSVChunk)
+};
+
+OGRCSVChunk::~OGRCSVChunk()
+{
+    for( auto poFeature : apoFeatures )
+        delete poFeature;
+}
+
 /************************************************************************/
 /*                            OGRCSVLayer()                             */
 /*                                                                      */
@@ -272,6 +468,20 @@ OGRCSVLayer::OGRCSVLayer( const char *pszLayerNameIn,
     SetDescription(poFeatureDefn->GetName());
     poFeatureDefn->Reference();
     poFeatureDefn->SetGeomType(wkbNone);
+
+    ResetReadBuffer();
+
+    const char *pszNumThreads =
+        CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszNumThreads )
+    {
+        m_nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                        atoi(pszNumThreads);
+        m_nThreads = std::max(1, std::min(128, m_nThreads));
+    }
+    // Undocumented: for testing purposes only
+    m_nChunkSize = static_cast<size_t>(std::max(1, std::min(100 * 1000 * 1000,
+        atoi(CPLGetConfigOption("OGR_CSV_CHUNK_SIZE", "1048576")))));
 }
 
 /************************************************************************/
@@ -1361,6 +1571,8 @@ char **OGRCSVLayer::AutodetectFieldTypes(char **papszOpenOptions,
 OGRCSVLayer::~OGRCSVLayer()
 
 {
+    DiscardChunks();
+
     if( m_nFeaturesRead > 0 )
     {
         CPLDebug("CSV", "%d features read on layer '%s'.",
@@ -1388,6 +1600,8 @@ OGRCSVLayer::~OGRCSVLayer()
 void OGRCSVLayer::ResetReading()
 
 {
+    DiscardChunks();
+
     if( fpCSV )
         VSIRewindL(fpCSV);
 
@@ -1395,31 +1609,448 @@ void OGRCSVLayer::ResetReading()
         CSLDestroy(
             OGRCSVReadParseLineL(fpCSV, chDelimiter, bDontHonourStrings));
 
+    ResetReadBuffer();
+
     bNeedRewindBeforeRead = false;
 
     nNextFID = 1;
 }
 
+/************************************************************************/
+/*                          ResetReadBuffer()                           */
+/*                                                                      */
+/*      Must be called whenever fpCSV is repositioned.                  */
+/************************************************************************/
+
+void OGRCSVLayer::ResetReadBuffer()
+
+{
+    m_nReadBufferPos = 0;
+    m_nReadBufferSize = 0;
+    m_nNextLFPos = std::string::npos;
+    m_nNextCRPos = std::string::npos;
+    m_bReadBufferEOF = false;
+}
+
+/************************************************************************/
+/*                           FillReadBuffer()                           */
+/************************************************************************/
+
+bool OGRCSVLayer::FillReadBuffer()
+
+{
+    const size_t nBufferSize = 65536;
+    if( m_bReadBufferEOF )
+        return false;
+    m_osReadBuffer.resize(nBufferSize);
+    m_nReadBufferSize = VSIFReadL(&m_osReadBuffer[0], 1, nBufferSize, fpCSV);
+    m_nReadBufferPos = 0;
+    m_bReadBufferEOF = m_nReadBufferSize < nBufferSize;
+
+    // Positions of the next line ending characters, so that files with
+    // only one kind of line ending are scanned once for the other one.
+    const char *pszBuffer = m_osReadBuffer.data();
+    const void *pLF = memchr(pszBuffer, '\n', m_nReadBufferSize);
+    const void *pCR = memchr(pszBuffer, '\r', m_nReadBufferSize);
+    m_nNextLFPos = pLF ? static_cast<const char *>(pLF) - pszBuffer
+                       : std::string::npos;
+    m_nNextCRPos = pCR ? static_cast<const char *>(pCR) - pszBuffer
+                       : std::string::npos;
+
+    return m_nReadBufferSize > 0;
+}
+
+/************************************************************************/
+/*                              ReadLine()                              */
+/*                                                                      */
+/*      Append the next line of the file, without its line ending,      */
+/*      to osLine. Like CPLReadLineL(), "\n", "\r", "\r\n" and "\n\r"   */
+/*      are line endings. Returns false at the end of the file.         */
+/************************************************************************/
+
+bool OGRCSVLayer::ReadLine( std::string &osLine )
+
+{
+    const size_t nLineStart = osLine.size();
+    bool bGotLine = false;
+    while( m_nReadBufferPos < m_nReadBufferSize || FillReadBuffer() )
+    {
+        bGotLine = true;
+        const char *pszBuffer = m_osReadBuffer.data();
+        const auto UpdateNextPos = [this, pszBuffer](size_t &nNextPos,
+                                                     char chEOL)
+        {
+            if( nNextPos < m_nReadBufferPos )
+            {
+                const void *pEOL = memchr(pszBuffer + m_nReadBufferPos, chEOL,
+                                          m_nReadBufferSize - m_nReadBufferPos);
+                nNextPos = pEOL ? static_cast<const char *>(pEOL) - pszBuffer
+                                : std::string::npos;
+            }
+        };
+        UpdateNextPos(m_nNextLFPos, '\n');
+        UpdateNextPos(m_nNextCRPos, '\r');
+
+        const size_t nEOLPos = std::min(m_nNextLFPos, m_nNextCRPos);
+        if( nEOLPos == std::string::npos )
+        {
+            osLine.append(pszBuffer + m_nReadBufferPos,
+                          m_nReadBufferSize - m_nReadBufferPos);
+            m_nReadBufferPos = m_nReadBufferSize;
+            continue;
+        }
+
+        osLine.append(pszBuffer + m_nReadBufferPos, nEOLPos - m_nReadBufferPos);
+        const char chOtherEOL = pszBuffer[nEOLPos] == '\n' ? '\r' : '\n';
+        m_nReadBufferPos = nEOLPos + 1;
+        if( m_nReadBufferPos == m_nReadBufferSize )
+            FillReadBuffer();
+        if( m_nReadBufferPos < m_nReadBufferSize &&
+            m_osReadBuffer[m_nReadBufferPos] == chOtherEOL )
+        {
+            m_nReadBufferPos++;
+        }
+        break;
+    }
+
+    // Like the users of CPLReadLineL(), ignore what follows a nul character.
+    const void *pNul = memchr(osLine.data() + nLineStart, '\0',
+                              osLine.size() - nLineStart);
+    if( pNul )
+        osLine.resize(static_cast<const char *>(pNul) - osLine.data());
+
+    return bGotLine;
+}
+
+/************************************************************************/
+/*                             ReadRecord()                             */
+/*                                                                      */
+/*      Append the next record to osRecord. Like                        */
+/*      OGRCSVReadParseLineL(), lines are joined with "\n" as long as   */
+/*      the record has an odd number of quotes. Returns false at the    */
+/*      end of the file.                                                */
+/************************************************************************/
+
+bool OGRCSVLayer::ReadRecord( std::string &osRecord )
+
+{
+    const size_t nRecordStart = osRecord.size();
+    if( !ReadLine(osRecord) )
+        return false;
+
+    // Skip BOM.
+    if( osRecord.size() >= nRecordStart + 3 &&
+        memcmp(osRecord.data() + nRecordStart, "\xEF\xBB\xBF", 3) == 0 )
+    {
+        osRecord.erase(nRecordStart, 3);
+    }
+
+    size_t nQuotes = 0;
+    size_t nPos = nRecordStart;
+    while( true )
+    {
+        const char *pszData = osRecord.data();
+        const void *pQuote = nullptr;
+        while( (pQuote = memchr(pszData + nPos, '"',
+                                osRecord.size() - nPos)) != nullptr )
+        {
+            nQuotes++;
+            nPos = static_cast<const char *>(pQuote) - pszData + 1;
+        }
+
+        if( nQuotes % 2 == 0 )
+            break;
+
+        // The line ending is replaced by "\n".
+        const size_t nSize = osRecord.size();
+        osRecord += '\n';
+        if( !ReadLine(osRecord) )
+        {
+            osRecord.resize(nSize);
+            break;
+        }
+        nPos = nSize + 1;
+    }
+
+    return true;
+}
+
 /************************************************************************/
 /*                        GetNextLineTokens()                           */
+/*                                                                      */
+/*      The tokens are owned by the layer, and valid until the next     */
+/*      call.                                                           */
 /************************************************************************/
 
 char **OGRCSVLayer::GetNextLineTokens()
 {
+    // Special fix to read NdfcFacilities.xls with un-balanced double quotes.
+    if( chDelimiter == '\t' && bDontHonourStrings )
+    {
+        while( true )
+        {
+            char **papszTokens = OGRCSVReadParseLineL(
+                fpCSV, chDelimiter, bDontHonourStrings, false, bMergeDelimiter);
+            m_aosLegacyTokens.Assign(papszTokens, TRUE);
+
+            if( papszTokens == nullptr )
+                return nullptr;
+
+            if( papszTokens[0] != nullptr )
+                return papszTokens;
+        }
+    }
+
     while( true )
     {
         // Read the CSV record.
-        char **papszTokens = OGRCSVReadParseLineL(
-            fpCSV, chDelimiter, bDontHonourStrings, false, bMergeDelimiter);
-
-        if( papszTokens == nullptr )
+        m_osRecord.clear();
+        if( !ReadRecord(m_osRecord) )
             return nullptr;
 
-        if( papszTokens[0] != nullptr )
-            return papszTokens;
+        OGRCSVSplitRecordInPlace(&m_osRecord[0], m_osRecord.size(),
+                                 chDelimiter, bMergeDelimiter, m_apszTokens);
 
-        CSLDestroy(papszTokens);
+        if( m_apszTokens[0] != nullptr )
+            return m_apszTokens.data();
+    }
+}
+
+/************************************************************************/
+/*                           CanUseThreads()                            */
+/************************************************************************/
+
+bool OGRCSVLayer::CanUseThreads() const
+
+{
+    return m_nThreads > 1 && !(chDelimiter == '\t' && bDontHonourStrings);
+}
+
+/************************************************************************/
+/*                          ReadChunkRecords()                          */
+/*                                                                      */
+/*      Read the next records of the file, up to about m_nChunkSize     */
+/*      bytes. Returns false if there are no more records.              */
+/************************************************************************/
+
+bool OGRCSVLayer::ReadChunkRecords( OGRCSVChunk *psChunk )
+
+{
+    psChunk->nFirstFID = m_nNextChunkFID;
+    std::string &osData = psChunk->osData;
+    while( osData.size() < m_nChunkSize )
+    {
+        const size_t nRecordStart = osData.size();
+        if( !ReadRecord(osData) )
+        {
+            m_bNoMoreChunks = true;
+            break;
+        }
+        // Empty lines are skipped, as in GetNextLineTokens().
+        if( osData.size() == nRecordStart )
+            continue;
+        psChunk->anRecordOffsets.push_back(nRecordStart);
+        osData += '\0';
     }
+    m_nNextChunkFID += static_cast<int>(psChunk->anRecordOffsets.size());
+    return !psChunk->anRecordOffsets.empty();
+}
+
+/************************************************************************/
+/*                          ProcessChunkFunc()                          */
+/************************************************************************/
+
+void OGRCSVLayer::ProcessChunkFunc( void *pData )
+
+{
+    OGRCSVChunk *psChunk = static_cast<OGRCSVChunk *>(pData);
+    OGRCSVLayer *poLayer = psChunk->poLayer;
+    std::vector<char *> apszTokens;
+    const size_t nRecords = psChunk->anRecordOffsets.size();
+    psChunk->apoFeatures.reserve(nRecords);
+    for( size_t i = 0; i < nRecords; i++ )
+    {
+        const size_t nStart = psChunk->anRecordOffsets[i];
+        const size_t nEnd = (i + 1 < nRecords
+                                 ? psChunk->anRecordOffsets[i + 1]
+                                 : psChunk->osData.size()) - 1;
+        OGRCSVSplitRecordInPlace(&psChunk->osData[nStart], nEnd - nStart,
+                                 poLayer->chDelimiter,
+                                 poLayer->bMergeDelimiter, apszTokens);
+
+        const int iFilterWKTColumn = psChunk->iFilterWKTColumn;
+        if( iFilterWKTColumn >= 0 )
+        {
+            bool bSkip = true;
+            if( static_cast<size_t>(iFilterWKTColumn) + 1 < apszTokens.size() )
+            {
+                const char *pszStr = apszTokens[iFilterWKTColumn];
+                while( *pszStr == ' ' )
+                    pszStr++;
+                OGREnvelope sEnvelope;
+                bSkip = *pszStr == '\0' ||
+                        (OGRWKTGetBoundingBox(pszStr, sEnvelope) &&
+                         !sEnvelope.Intersects(psChunk->sFilterEnvelope));
+            }
+            if( bSkip )
+            {
+                psChunk->apoFeatures.push_back(nullptr);
+                continue;
+            }
+        }
+
+        const bool bHadWarning = !psChunk->osWarning.empty();
+        psChunk->apoFeatures.push_back(poLayer->BuildFeature(
+            apszTokens.data(), psChunk->nFirstFID + static_cast<int>(i),
+            &psChunk->osWarning));
+        if( !bHadWarning && !psChunk->osWarning.empty() )
+            psChunk->iWarningRecord = i;
+    }
+
+    std::lock_guard<std::mutex> oLock(poLayer->m_oChunkMutex);
+    psChunk->bDone = true;
+    poLayer->m_oChunkCV.notify_all();
+}
+
+/************************************************************************/
+/*                            SubmitChunks()                            */
+/************************************************************************/
+
+void OGRCSVLayer::SubmitChunks()
+
+{
+    const int iFilterWKTColumn = GetFilterWKTColumn();
+
+    // Keep each worker busy with one chunk, plus one waiting chunk.
+    while( !m_bNoMoreChunks &&
+           m_apoChunks.size() < 2 * static_cast<size_t>(m_nThreads) )
+    {
+        std::unique_ptr<OGRCSVChunk> poChunk(new OGRCSVChunk());
+        if( !ReadChunkRecords(poChunk.get()) )
+            break;
+        poChunk->poLayer = this;
+        poChunk->iFilterWKTColumn = iFilterWKTColumn;
+        poChunk->sFilterEnvelope = m_sFilterEnvelope;
+        OGRCSVChunk *psChunk = poChunk.get();
+        m_apoChunks.push_back(std::move(poChunk));
+
+        // A file that fits in a single chunk is processed by the calling
+        // thread, without using the worker threads.
+        if( m_poJobQueue == nullptr &&
+            m_apoChunks.size() == 1 && m_bNoMoreChunks )
+        {
+            ProcessChunkFunc(psChunk);
+            continue;
+        }
+        if( m_poJobQueue == nullptr )
+        {
+            CPLWorkerThreadPool *poThreadPool =
+                GDALGetGlobalThreadPool(m_nThreads);
+            if( poThreadPool )
+                m_poJobQueue = poThreadPool->CreateJobQueue();
+        }
+        if( m_poJobQueue == nullptr ||
+            !m_poJobQueue->SubmitJob(ProcessChunkFunc, psChunk) )
+        {
+            ProcessChunkFunc(psChunk);
+        }
+    }
+}
+
+/************************************************************************/
+/*                            GetNextChunk()                            */
+/*                                                                      */
+/*      Make the next chunk, in the order of the file, the current      */
+/*      one, once its features are built.                               */
+/************************************************************************/
+
+OGRCSVChunk *OGRCSVLayer::GetNextChunk()
+
+{
+    m_poCurChunk.reset();
+    m_iInCurChunk = 0;
+    SubmitChunks();
+    if( m_apoChunks.empty() )
+        return nullptr;
+
+    {
+        std::unique_lock<std::mutex> oLock(m_oChunkMutex);
+        m_oChunkCV.wait(oLock,
+                        [this]() { return m_apoChunks.front()->bDone; });
+        m_poCurChunk = std::move(m_apoChunks.front());
+        m_apoChunks.pop_front();
+    }
+
+    SubmitChunks();
+    return m_poCurChunk.get();
+}
+
+/************************************************************************/
+/*                           DiscardChunks()                            */
+/************************************************************************/
+
+void OGRCSVLayer::DiscardChunks()
+
+{
+    {
+        std::unique_lock<std::mutex> oLock(m_oChunkMutex);
+        m_oChunkCV.wait(oLock, [this]()
+        {
+            for( const auto &poChunk : m_apoChunks )
+            {
+                if( !poChunk->bDone )
+                    return false;
+            }
+            return true;
+        });
+    }
+    m_apoChunks.clear();
+    m_poCurChunk.reset();
+    m_iInCurChunk = 0;
+    m_bNoMoreChunks = false;
+}
+
+/************************************************************************/
+/*                        GetNextChunkFeature()                         */
+/*                                                                      */
+/*      Return the next feature built by the worker threads.            */
+/************************************************************************/
+
+OGRFeature *OGRCSVLayer::GetNextChunkFeature()
+
+{
+    // Start the chunks from the current record.
+    if( m_poCurChunk == nullptr && m_apoChunks.empty() && !m_bNoMoreChunks )
+        m_nNextChunkFID = nNextFID;
+
+    OGRFeature *poFeature = nullptr;
+    size_t iRecord = 0;
+    while( poFeature == nullptr )
+    {
+        while( m_poCurChunk == nullptr ||
+               m_iInCurChunk == m_poCurChunk->apoFeatures.size() )
+        {
+            if( GetNextChunk() == nullptr )
+                return nullptr;
+        }
+
+        iRecord = m_iInCurChunk;
+        m_iInCurChunk++;
+        std::swap(poFeature, m_poCurChunk->apoFeatures[iRecord]);
+    }
+
+    if( !m_poCurChunk->osWarning.empty() &&
+        m_poCurChunk->iWarningRecord == iRecord && !bWarningBadTypeOrWidth )
+    {
+        bWarningBadTypeOrWidth = true;
+        CPLError(CE_Warning, CPLE_AppDefined, "%s",
+                 m_poCurChunk->osWarning.c_str());
+    }
+
+    nNextFID = static_cast<int>(poFeature->GetFID()) + 1;
+    m_nFeaturesRead++;
+
+    return poFeature;
 }
 
 /************************************************************************/
@@ -1430,14 +2061,14 @@ OGRFeature *OGRCSVLayer::GetFeature(GIntBig nFID)
 {
     if( nFID < 1 || fpCSV == nullptr )
         return nullptr;
-    if( nFID < nNextFID || bNeedRewindBeforeRead )
+    // Records read ahead by the worker threads are behind the file position.
+    if( nFID < nNextFID || bNeedRewindBeforeRead ||
+        m_poCurChunk != nullptr || !m_apoChunks.empty() )
         ResetReading();
     while( nNextFID < nFID )
     {
-        char **papszTokens = GetNextLineTokens();
-        if( papszTokens == nullptr )
+        if( GetNextLineTokens() == nullptr )
             return nullptr;
-        CSLDestroy(papszTokens);
         nNextFID++;
     }
     return GetNextUnfilteredFeature();
@@ -1458,6 +2089,55 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
     if( papszTokens == nullptr )
         return nullptr;
 
+    OGRFeature *poFeature = BuildFeature(papszTokens, nNextFID);
+    nNextFID++;
+    m_nFeaturesRead++;
+
+    return poFeature;
+}
+
+/************************************************************************/
+/*                       MustWarnBadTypeOrWidth()                       */
+/************************************************************************/
+
+bool OGRCSVLayer::MustWarnBadTypeOrWidth( const CPLString *posWarning ) const
+
+{
+    return posWarning ? posWarning->empty() : !bWarningBadTypeOrWidth;
+}
+
+/************************************************************************/
+/*                         WarnBadTypeOrWidth()                         */
+/************************************************************************/
+
+void OGRCSVLayer::WarnBadTypeOrWidth( CPLString *posWarning,
+                                      const char *pszMsg )
+
+{
+    if( posWarning )
+    {
+        *posWarning = pszMsg;
+    }
+    else
+    {
+        bWarningBadTypeOrWidth = true;
+        CPLError(CE_Warning, CPLE_AppDefined, "%s", pszMsg);
+    }
+}
+
+/************************************************************************/
+/*                            BuildFeature()                            */
+/*                                                                      */
+/*      Translate the tokens of a CSV record into a feature. The       */
+/*      tokens may be modified. When posWarning is not null, as in      */
+/*      worker threads, the layer state is not modified and the first   */
+/*      warning is stored in it instead of being emitted.               */
+/************************************************************************/
+
+OGRFeature *OGRCSVLayer::BuildFeature( char **papszTokens, int nFID,
+                                       CPLString *posWarning )
+
+{
     // Create the OGR feature.
     OGRFeature *poFeature = new OGRFeature(poFeatureDefn);
 
@@ -1541,14 +2221,12 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
                 {
                     poFeature->SetField(iOGRField, 0);
                 }
-                else if( !bWarningBadTypeOrWidth )
+                else if( MustWarnBadTypeOrWidth(posWarning) )
                 {
-                    bWarningBadTypeOrWidth = true;
-                    CPLError(
-                        CE_Warning, CPLE_AppDefined,
+                    WarnBadTypeOrWidth(posWarning, CPLSPrintf(
                         "Invalid value type found in record %d for field %s. "
                         "This warning will no longer be emitted",
-                        nNextFID, poFieldDefn->GetNameRef());
+                        nFID, poFieldDefn->GetNameRef()));
                 }
             }
         }
@@ -1563,35 +2241,54 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
                     if( chComma )
                         *chComma = '.';
                 }
-                eType = CPLGetValueType(papszTokens[iAttr]);
+
+                // Set the most common values without parsing them twice.
+                GIntBig nValue = 0;
+                double dfValue = 0.0;
+                eType = OGRCSVParseNumber(papszTokens[iAttr], nValue, dfValue);
+                const bool bParsed =
+                    eFieldType == OFTReal ? eType != CPL_VALUE_STRING :
+                    eFieldType == OFTInteger64 ? eType == CPL_VALUE_INTEGER :
+                    eType == CPL_VALUE_INTEGER && nValue >= INT_MIN &&
+                        nValue <= INT_MAX;
+                if( !bParsed )
+                    eType = CPLGetValueType(papszTokens[iAttr]);
+
                 if( eType == CPL_VALUE_INTEGER || eType == CPL_VALUE_REAL )
                 {
-                    poFeature->SetField(iOGRField, papszTokens[iAttr]);
-                    if( !bWarningBadTypeOrWidth &&
+                    if( !bParsed )
+                        poFeature->SetField(iOGRField, papszTokens[iAttr]);
+                    else if( eFieldType == OFTReal )
+                        poFeature->SetField(iOGRField, dfValue);
+                    else if( eFieldType == OFTInteger64 )
+                        poFeature->SetField(iOGRField, nValue);
+                    else
+                        poFeature->SetField(iOGRField,
+                                            static_cast<int>(nValue));
+
+                    if( MustWarnBadTypeOrWidth(posWarning) &&
                         (eFieldType == OFTInteger ||
                          eFieldType == OFTInteger64) &&
                         eType == CPL_VALUE_REAL )
                     {
-                        bWarningBadTypeOrWidth = true;
-                        CPLError(CE_Warning, CPLE_AppDefined,
-                                 "Invalid value type found in record %d for "
-                                 "field %s. "
-                                 "This warning will no longer be emitted",
-                                 nNextFID, poFieldDefn->GetNameRef());
+                        WarnBadTypeOrWidth(posWarning, CPLSPrintf(
+                            "Invalid value type found in record %d for "
+                            "field %s. "
+                            "This warning will no longer be emitted",
+                            nFID, poFieldDefn->GetNameRef()));
                     }
-                    else if( !bWarningBadTypeOrWidth &&
+                    else if( MustWarnBadTypeOrWidth(posWarning) &&
                              poFieldDefn->GetWidth() > 0 &&
                              static_cast<int>(strlen(papszTokens[iAttr])) >
                                  poFieldDefn->GetWidth() )
                     {
-                        bWarningBadTypeOrWidth = true;
-                        CPLError(CE_Warning, CPLE_AppDefined,
-                                 "Value with a width greater than field width "
-                                 "found in record %d for field %s. "
-                                 "This warning will no longer be emitted",
-                                 nNextFID, poFieldDefn->GetNameRef());
+                        WarnBadTypeOrWidth(posWarning, CPLSPrintf(
+                            "Value with a width greater than field width "
+                            "found in record %d for field %s. "
+                            "This warning will no longer be emitted",
+                            nFID, poFieldDefn->GetNameRef()));
                     }
-                    else if( !bWarningBadTypeOrWidth &&
+                    else if( MustWarnBadTypeOrWidth(posWarning) &&
                              eType == CPL_VALUE_REAL &&
                              poFieldDefn->GetWidth() > 0)
                     {
@@ -1602,26 +2299,23 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
                                 : 0;
                         if( nPrecision > poFieldDefn->GetPrecision() )
                         {
-                            bWarningBadTypeOrWidth = true;
-                            CPLError(CE_Warning, CPLE_AppDefined,
-                                     "Value with a precision greater than "
-                                     "field precision found in record %d for "
-                                     "field %s. "
-                                     "This warning will no longer be emitted",
-                                     nNextFID, poFieldDefn->GetNameRef());
+                            WarnBadTypeOrWidth(posWarning, CPLSPrintf(
+                                "Value with a precision greater than "
+                                "field precision found in record %d for "
+                                "field %s. "
+                                "This warning will no longer be emitted",
+                                nFID, poFieldDefn->GetNameRef()));
                         }
                     }
                 }
                 else
                 {
-                    if( !bWarningBadTypeOrWidth )
+                    if( MustWarnBadTypeOrWidth(posWarning) )
                     {
-                        bWarningBadTypeOrWidth = true;
-                        CPLError(
-                            CE_Warning, CPLE_AppDefined,
+                        WarnBadTypeOrWidth(posWarning, CPLSPrintf(
                             "Invalid value type found in record %d for field "
                             "%s. This warning will no longer be emitted.",
-                            nNextFID, poFieldDefn->GetNameRef());
+                            nFID, poFieldDefn->GetNameRef()));
                     }
                 }
             }
@@ -1631,15 +2325,13 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
             if( papszTokens[iAttr][0] != '\0' && !poFieldDefn->IsIgnored() )
             {
                 poFeature->SetField(iOGRField, papszTokens[iAttr]);
-                if( !bWarningBadTypeOrWidth &&
+                if( MustWarnBadTypeOrWidth(posWarning) &&
                     !poFeature->IsFieldSetAndNotNull(iOGRField) )
                 {
-                    bWarningBadTypeOrWidth = true;
-                    CPLError(
-                        CE_Warning, CPLE_AppDefined,
+                    WarnBadTypeOrWidth(posWarning, CPLSPrintf(
                         "Invalid value type found in record %d for field %s. "
                         "This warning will no longer be emitted",
-                        nNextFID, poFieldDefn->GetNameRef());
+                        nFID, poFieldDefn->GetNameRef()));
                 }
             }
         }
@@ -1652,16 +2344,16 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
             else
             {
                 poFeature->SetField(iOGRField, papszTokens[iAttr]);
-                if( !bWarningBadTypeOrWidth && poFieldDefn->GetWidth() > 0 &&
+                if( MustWarnBadTypeOrWidth(posWarning) &&
+                    poFieldDefn->GetWidth() > 0 &&
                     static_cast<int>(strlen(papszTokens[iAttr])) >
                         poFieldDefn->GetWidth() )
                 {
-                    bWarningBadTypeOrWidth = true;
-                    CPLError(CE_Warning, CPLE_AppDefined,
-                             "Value with a width greater than field width "
-                             "found in record %d for field %s. "
-                             "This warning will no longer be emitted",
-                             nNextFID, poFieldDefn->GetNameRef());
+                    WarnBadTypeOrWidth(posWarning, CPLSPrintf(
+                        "Value with a width greater than field width "
+                        "found in record %d for field %s. "
+                        "This warning will no longer be emitted",
+                        nFID, poFieldDefn->GetNameRef()));
                 }
             }
         }
@@ -1770,16 +2462,45 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
         }
     }
 
-    CSLDestroy(papszTokens);
-
     // Translate the record id.
-    poFeature->SetFID(nNextFID++);
-
-    m_nFeaturesRead++;
+    poFeature->SetFID(nFID);
 
     return poFeature;
 }
 
+/************************************************************************/
+/*                         GetFilterWKTColumn()                         */
+/*                                                                      */
+/*      Return the index of the CSV column holding the WKT geometry on  */
+/*      which the spatial filter is set, or -1.                         */
+/************************************************************************/
+
+int OGRCSVLayer::GetFilterWKTColumn() const
+
+{
+    if( m_poFilterGeom == nullptr || bIsEurostatTSV ||
+        poFeatureDefn->GetGeomFieldDefn(m_iGeomFieldFilter)->IsIgnored() )
+        return -1;
+
+    const int nColumns = nCSVFieldCount + (bHiddenWKTColumn ? 1 : 0);
+    for( int iAttr = 0; iAttr < nColumns; iAttr++ )
+    {
+        int iGeom = 0;
+        if( bHiddenWKTColumn )
+        {
+            if( iAttr != 0 )
+                iGeom = panGeomFieldIndex[iAttr - 1];
+        }
+        else
+        {
+            iGeom = panGeomFieldIndex[iAttr];
+        }
+        if( iGeom == m_iGeomFieldFilter )
+            return iAttr;
+    }
+    return -1;
+}
+
 /************************************************************************/
 /*                           GetNextFeature()                           */
 /************************************************************************/
@@ -1790,13 +2511,54 @@ OGRFeature *OGRCSVLayer::GetNextFeature()
     if( bNeedRewindBeforeRead )
         ResetReading();
 
+    // If the spatial filter is set on a WKT column, records whose geometry
+    // envelope does not intersect it are skipped before being translated.
+    // Worker threads do the same in ProcessChunkFunc().
+    const bool bUseThreads = CanUseThreads();
+    const int iFilterWKTColumn = bUseThreads ? -1 : GetFilterWKTColumn();
+
     // Read features till we find one that satisfies our current
     // spatial criteria.
     while( true )
     {
-        OGRFeature *poFeature = GetNextUnfilteredFeature();
-        if( poFeature == nullptr )
-            return nullptr;
+        OGRFeature *poFeature = nullptr;
+        if( iFilterWKTColumn >= 0 )
+        {
+            if( fpCSV == nullptr )
+                return nullptr;
+            char **papszTokens = GetNextLineTokens();
+            if( papszTokens == nullptr )
+                return nullptr;
+
+            bool bSkip = true;
+            if( iFilterWKTColumn < CSLCount(papszTokens) )
+            {
+                const char *pszStr = papszTokens[iFilterWKTColumn];
+                while( *pszStr == ' ' )
+                    pszStr++;
+                OGREnvelope sEnvelope;
+                // The value might also be GeoJSON or HEXEWKB: only skip
+                // when we are sure the geometry does not pass the filter.
+                bSkip = *pszStr == '\0' ||
+                        (OGRWKTGetBoundingBox(pszStr, sEnvelope) &&
+                         !FilterGeometryEnvelope(sEnvelope));
+            }
+            if( bSkip )
+            {
+                nNextFID++;
+                continue;
+            }
+            poFeature = BuildFeature(papszTokens, nNextFID);
+            nNextFID++;
+            m_nFeaturesRead++;
+        }
+        else
+        {
+            poFeature = bUseThreads ? GetNextChunkFeature()
+                                    : GetNextUnfilteredFeature();
+            if( poFeature == nullptr )
+                return nullptr;
+        }
 
         if( (m_poFilterGeom == nullptr ||
              FilterGeometry(poFeature->GetGeomFieldRef(m_iGeomFieldFilter))) &&
@@ -2592,13 +3354,10 @@ GIntBig OGRCSVLayer::GetFeatureCount( int bForce )
         nTotalFeatures = 0;
         while( true )
         {
-            char **papszTokens = GetNextLineTokens();
-            if( papszTokens == nullptr )
+            if( GetNextLineTokens() == nullptr )
                 break;
 
             nTotalFeatures++;
-
-            CSLDestroy(papszTokens);
         }
     }
 
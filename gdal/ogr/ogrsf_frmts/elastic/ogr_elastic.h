@@ -36,7 +36,10 @@
 #include "cpl_hash_set.h"
 #include "ogr_p.h"
 #include "cpl_http.h"
+#include "cpl_worker_thread_pool.h"
 
+#include <atomic>
+#include <list>
 #include <map>
 #include <memory>
 #include <set>
@@ -50,6 +53,7 @@ typedef enum
 } ESGeometryTypeMapping;
 
 class OGRElasticDataSource;
+class OGRElasticLayer;
 
 class OGRESSortDesc
 {
@@ -62,6 +66,36 @@ class OGRESSortDesc
             bAsc(bAscIn) {}
 };
 
+/************************************************************************/
+/*                         OGRESBulkUploadJob                           */
+/************************************************************************/
+
+struct OGRESBulkUploadJob
+{
+    OGRElasticDataSource *poDS = nullptr;
+    CPLString             osURL{};
+    CPLString             osContent{};
+    bool                  bRet = true;
+    CPLString             osErrorMsg{};
+    std::atomic<bool>     bDone{false};
+};
+
+/************************************************************************/
+/*                         OGRESScrollSlice                             */
+/************************************************************************/
+
+struct OGRESScrollSlice
+{
+    OGRElasticLayer      *poLayer = nullptr;
+    // Request of the next page of the slice
+    CPLString             osRequest{};
+    CPLString             osPostData{};
+    CPLString             osScrollID{};
+    bool                  bEOF = false;
+    std::vector<OGRFeature*> apoFeatures{};
+    CPLString             osErrorMsg{};
+};
+
 /************************************************************************/
 /*                          OGRElasticLayer                             */
 /************************************************************************/
@@ -89,6 +123,10 @@ class OGRElasticLayer final: public OGRLayer {
 
     CPLString                            m_osBulkContent;
     int                                  m_nBulkUpload;
+    // Maximum number of _bulk requests in flight
+    int                                  m_nBulkConcurrency = 1;
+    std::unique_ptr<CPLJobQueue>         m_poBulkJobQueue{};
+    std::list<std::unique_ptr<OGRESBulkUploadJob>> m_apoBulkJobs{};
 
     CPLString                            m_osFID;
 
@@ -108,6 +146,8 @@ class OGRElasticLayer final: public OGRLayer {
     int                                   m_iCurFeatureInPage;
     std::vector<OGRFeature*>              m_apoCachedFeatures;
     bool                                  m_bEOF;
+    // Sliced scrolls, read in parallel, when SCROLL_SLICES > 1
+    std::vector<OGRESScrollSlice>         m_aoScrollSlices{};
 
     json_object*                          m_poSpatialFilter;
     CPLString                             m_osJSONFilter;
@@ -133,11 +173,24 @@ class OGRElasticLayer final: public OGRLayer {
 
     bool                                  m_bUseSingleQueryParams = false;
 
-    bool                                  PushIndex();
+    bool                                  PushIndex(bool bWaitCompletion = true);
+    bool                                  SubmitBulkUpload();
+    bool                                  CollectBulkUploads(int nMaxRemaining);
+    static void                           BulkUploadFunc(void* pData);
+
+    bool                                  CanUseScrollSlices() const;
+    void                                  InitScrollSlices(const CPLString& osRequest,
+                                                           const CPLString& osPostData);
+    void                                  FetchScrollSlices();
+    static void                           FetchScrollSliceFunc(void* pData);
+    bool                                  BuildFeaturesFromResponse(json_object* poResponse,
+                                                                    CPLString& osScrollID,
+                                                                    std::vector<OGRFeature*>& apoFeatures);
     CPLString                             BuildMap();
 
     OGRErr                                WriteMapIfNecessary();
     OGRFeature                           *GetNextRawFeature();
+    OGRFeature                           *GetNextRawFeatureFromCache();
     void                                  BuildFeature(OGRFeature* poFeature,
                                                        json_object* poSource,
                                                        CPLString osPath);
@@ -256,6 +309,7 @@ public:
     char               *m_pszWriteMap;
     char               *m_pszMapping;
     int                 m_nBatchSize;
+    int                 m_nScrollSlices = 1;
     int                 m_nFeatureCountToEstablishFeatureDefn;
     bool                m_bJSonField;
     bool                m_bFlattenNestedAttributes;
@@ -292,7 +346,8 @@ public:
 
     bool                UploadFile(const CPLString &url,
                                    const CPLString &data,
-                                   const CPLString &osVerb = CPLString());
+                                   const CPLString &osVerb = CPLString(),
+                                   CPLString* posErrorMsg = nullptr);
     void                Delete(const CPLString &url);
 
     json_object*        RunRequest(const char* pszURL,
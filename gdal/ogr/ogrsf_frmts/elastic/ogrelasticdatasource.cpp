@@ -35,6 +35,8 @@
 #include "ogrgeojsonreader.h"
 #include "ogr_swq.h"
 
+#include <algorithm>
+
 CPL_CVSID("$Id$")
 
 /************************************************************************/
@@ -733,6 +735,8 @@ int OGRElasticDataSource::Open(GDALOpenInfo* poOpenInfo)
     }
     m_osUserPwd = CSLFetchNameValueDef(poOpenInfo->papszOpenOptions, "USERPWD", "");
     m_nBatchSize = atoi(CSLFetchNameValueDef(poOpenInfo->papszOpenOptions, "BATCH_SIZE", "100"));
+    m_nScrollSlices = std::max(1, std::min(128, atoi(CSLFetchNameValueDef(
+        poOpenInfo->papszOpenOptions, "SCROLL_SLICES", "1"))));
     m_nFeatureCountToEstablishFeatureDefn = atoi(CSLFetchNameValueDef(
         poOpenInfo->papszOpenOptions, "FEATURE_COUNT_TO_ESTABLISH_FEATURE_DEFN", "100"));
     m_bJSonField =
@@ -793,7 +797,8 @@ void OGRElasticDataSource::Delete(const CPLString &url) {
 
 bool OGRElasticDataSource::UploadFile( const CPLString &url,
                                        const CPLString &data,
-                                       const CPLString &osVerb )
+                                       const CPLString &osVerb,
+                                       CPLString* posErrorMsg )
 {
     bool bRet = true;
     char** papszOptions = nullptr;
@@ -816,7 +821,13 @@ bool OGRElasticDataSource::UploadFile( const CPLString &url,
                 "Content-Type: application/json; charset=UTF-8");
     }
 
+    // When the error message is returned to the caller, typically
+    // because we run in a worker thread, do not emit errors.
+    if( posErrorMsg )
+        CPLPushErrorHandler(CPLQuietErrorHandler);
     CPLHTTPResult* psResult = HTTPFetch(url, papszOptions);
+    if( posErrorMsg )
+        CPLPopErrorHandler();
     CSLDestroy(papszOptions);
     if( psResult )
     {
@@ -825,9 +836,13 @@ bool OGRElasticDataSource::UploadFile( const CPLString &url,
             (psResult->pabyData && strstr((const char*) psResult->pabyData, "\"errors\":true,") != nullptr) )
         {
             bRet = false;
-            CPLError(CE_Failure, CPLE_AppDefined, "%s",
-                     psResult->pabyData ? (const char*) psResult->pabyData :
-                     psResult->pszErrBuf);
+            const char* pszErrorMsg =
+                psResult->pabyData ? (const char*) psResult->pabyData :
+                psResult->pszErrBuf ? psResult->pszErrBuf : "HTTP error";
+            if( posErrorMsg )
+                *posErrorMsg = pszErrorMsg;
+            else
+                CPLError(CE_Failure, CPLE_AppDefined, "%s", pszErrorMsg);
         }
         CPLHTTPDestroyResult(psResult);
     }
@@ -128,6 +128,7 @@ void RegisterOGRElastic() {
     "  <Option name='FIELDS_WITH_RAW_VALUE' type='string' description='List of comma separated field names (of type string) that should have an additional raw/not_analyzed field, or {ALL}'/>"
     "  <Option name='BULK_INSERT' type='boolean' description='Whether to use bulk insert for feature creation' default='YES'/>"
     "  <Option name='BULK_SIZE' type='integer' description='Size in bytes of the buffer for bulk upload' default='1000000'/>"
+    "  <Option name='BULK_CONCURRENCY' type='integer' description='Maximum number of bulk upload requests in flight' default='1'/>"
     "  <Option name='DOT_AS_NESTED_FIELD' type='boolean' description='Whether to consider dot character in field name as sub-document' default='YES'/>"
     "  <Option name='IGNORE_SOURCE_ID' type='boolean' description='Whether to ignore _id field in features passed to CreateFeature()' default='NO'/>"
     "  <Option name='FID' type='string' description='Field name, with integer values, to use as FID' default='ogc_fid'/>"
@@ -141,6 +142,7 @@ void RegisterOGRElastic() {
         "description='Basic authentication as username:password'/>"
 "  <Option name='LAYER' type='string' description='Index name or index_mapping to use for restricting layer listing'/>"
 "  <Option name='BATCH_SIZE' type='integer' description='Number of features to retrieve per batch' default='100'/>"
+"  <Option name='SCROLL_SLICES' type='integer' description='Number of slices of the scroll request to retrieve in parallel' default='1'/>"
 "  <Option name='FEATURE_COUNT_TO_ESTABLISH_FEATURE_DEFN' type='integer' description='Number of features to retrieve to establish feature definition. -1 = unlimited' default='100'/>"
 "  <Option name='SINGLE_QUERY_TIMEOUT' type='float' description='Timeout in second for request such as GetFeatureCount() or GetExtent()'/>"
 "  <Option name='SINGLE_QUERY_TERMINATE_AFTER' type='integer' description='Maximum number of documents to collect for request such as GetFeatureCount() or GetExtent()'/>"
@@ -150,6 +152,7 @@ void RegisterOGRElastic() {
 "  <Option name='FLATTEN_NESTED_ATTRIBUTES' type='boolean' description='Whether to recursively explore nested objects and produce flatten OGR attributes' default='YES'/>"
 "  <Option name='BULK_INSERT' type='boolean' description='Whether to use bulk insert for feature creation' default='YES'/>"
 "  <Option name='BULK_SIZE' type='integer' description='Size in bytes of the buffer for bulk upload' default='1000000'/>"
+"  <Option name='BULK_CONCURRENCY' type='integer' description='Maximum number of bulk upload requests in flight' default='1'/>"
 "  <Option name='FID' type='string' description='Field name, with integer values, to use as FID' default='ogc_fid'/>"
 "  <Option name='FORWARD_HTTP_HEADERS_FROM_ENV' type='string' description='Comma separated list of http_header_name=env_variable_name'/>"
 "</OpenOptionList>");
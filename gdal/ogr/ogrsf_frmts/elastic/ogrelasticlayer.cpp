@@ -38,7 +38,10 @@
 #include "../geojson/ogrgeojsonreader.h"
 #include "../geojson/ogrgeojsonutils.h"
 #include "ogr_geo_utils.h"
+#include "gdal_thread_pool.h"
 
+#include <algorithm>
+#include <climits>
 #include <cstdlib>
 #include <set>
 
@@ -138,6 +141,9 @@ OGRElasticLayer::OGRElasticLayer( const char* pszLayerName,
     {
         m_nBulkUpload = atoi(CSLFetchNameValueDef(papszOptions, "BULK_SIZE", "1000000"));
     }
+    m_nBulkConcurrency = std::max(1, std::min(64, atoi(CSLFetchNameValueDef(
+        papszOptions, "BULK_CONCURRENCY",
+        CPLGetConfigOption("ES_BULK_CONCURRENCY", "1")))));
 
     const char* pszStoredFields = CSLFetchNameValue(papszOptions, "STORED_FIELDS");
     if( pszStoredFields )
@@ -212,6 +218,7 @@ OGRElasticLayer* OGRElasticLayer::Clone() const
     poNew->m_bFeatureDefnFinalized = true;
     poNew->m_osBulkContent = m_osBulkContent;
     poNew->m_nBulkUpload = m_nBulkUpload;
+    poNew->m_nBulkConcurrency = m_nBulkConcurrency;
     poNew->m_osFID = m_osFID;
     poNew->m_aaosFieldPaths = m_aaosFieldPaths;
     poNew->m_aosMapToFieldIndex = m_aosMapToFieldIndex;
@@ -966,6 +973,19 @@ void OGRElasticLayer::ResetReading()
 
         m_osScrollID = "";
     }
+    for( auto& oSlice: m_aoScrollSlices )
+    {
+        if( !oSlice.osScrollID.empty() )
+        {
+            char** papszOptions = CSLAddNameValue(nullptr, "CUSTOMREQUEST", "DELETE");
+            CPLHTTPResult* psResult = m_poDS->HTTPFetch((m_poDS->GetURL() + CPLString("/_search/scroll?scroll_id=") + oSlice.osScrollID).c_str(), papszOptions);
+            CSLDestroy(papszOptions);
+            CPLHTTPDestroyResult(psResult);
+        }
+        for( auto poFeature: oSlice.apoFeatures )
+            delete poFeature;
+    }
+    m_aoScrollSlices.clear();
     for(int i=0;i<(int)m_apoCachedFeatures.size();i++)
         delete m_apoCachedFeatures[i];
     m_apoCachedFeatures.resize(0);
@@ -1110,6 +1130,12 @@ OGRFeature *OGRElasticLayer::GetNextRawFeature()
     m_apoCachedFeatures.resize(0);
     m_iCurFeatureInPage = 0;
 
+    if( !m_aoScrollSlices.empty() )
+    {
+        FetchScrollSlices();
+        return GetNextRawFeatureFromCache();
+    }
+
     CPLString osRequest, osPostData;
     if( m_nReadFeaturesSinceResetReading == 0 )
     {
@@ -1141,6 +1167,15 @@ OGRFeature *OGRElasticLayer::GetNextRawFeature()
             osRequest += CPLSPrintf("/_search?scroll=1m&size=%d", m_poDS->m_nBatchSize);
             osPostData = m_osJSONFilter;
         }
+
+        if( CanUseScrollSlices() )
+        {
+            if( m_bAddPretty )
+                osRequest += "&pretty";
+            InitScrollSlices(osRequest, osPostData);
+            FetchScrollSlices();
+            return GetNextRawFeatureFromCache();
+        }
     }
     else
     {
@@ -1162,36 +1197,78 @@ OGRFeature *OGRElasticLayer::GetNextRawFeature()
         m_bEOF = true;
         return nullptr;
     }
-    m_osScrollID.clear();
+    if( !BuildFeaturesFromResponse(poResponse, m_osScrollID,
+                                   m_apoCachedFeatures) )
+    {
+        m_bEOF = true;
+        return nullptr;
+    }
+    for( auto poFeature: m_apoCachedFeatures )
+    {
+        if( poFeature->GetFID() < 0 )
+            poFeature->SetFID( ++m_iCurID );
+    }
+
+    return GetNextRawFeatureFromCache();
+}
+
+/************************************************************************/
+/*                     GetNextRawFeatureFromCache()                     */
+/************************************************************************/
+
+OGRFeature *OGRElasticLayer::GetNextRawFeatureFromCache()
+{
+    if( m_iCurFeatureInPage < (int)m_apoCachedFeatures.size() )
+    {
+        OGRFeature* poRet = m_apoCachedFeatures[m_iCurFeatureInPage];
+        m_apoCachedFeatures[m_iCurFeatureInPage] = nullptr;
+        m_iCurFeatureInPage ++;
+        m_nReadFeaturesSinceResetReading ++;
+        return poRet;
+    }
+    return nullptr;
+}
+
+/************************************************************************/
+/*                     BuildFeaturesFromResponse()                      */
+/*                                                                      */
+/*      Turn the hits of a _search response into features, and take    */
+/*      ownership of poResponse. Returns false when there are no more   */
+/*      hits. May be called from a worker thread.                       */
+/************************************************************************/
+
+bool OGRElasticLayer::BuildFeaturesFromResponse(
+                                    json_object* poResponse,
+                                    CPLString& osScrollID,
+                                    std::vector<OGRFeature*>& apoFeatures)
+{
+    osScrollID.clear();
     json_object* poScrollID = CPL_json_object_object_get(poResponse, "_scroll_id");
     if( poScrollID )
     {
         const char* pszScrollID = json_object_get_string(poScrollID);
         if( pszScrollID )
-            m_osScrollID = pszScrollID;
+            osScrollID = pszScrollID;
     }
 
     json_object* poHits = CPL_json_object_object_get(poResponse, "hits");
     if( poHits == nullptr || json_object_get_type(poHits) != json_type_object )
     {
-        m_bEOF = true;
         json_object_put(poResponse);
-        return nullptr;
+        return false;
     }
     poHits = CPL_json_object_object_get(poHits, "hits");
     if( poHits == nullptr || json_object_get_type(poHits) != json_type_array )
     {
-        m_bEOF = true;
         json_object_put(poResponse);
-        return nullptr;
+        return false;
     }
     const auto nHits = json_object_array_length(poHits);
     if( nHits == 0 )
     {
-        m_osScrollID = "";
-        m_bEOF = true;
+        osScrollID = "";
         json_object_put(poResponse);
-        return nullptr;
+        return false;
     }
     for(auto i=decltype(nHits){0};i<nHits;i++)
     {
@@ -1230,21 +1307,160 @@ OGRFeature *OGRElasticLayer::GetNextRawFeature()
             poFeature->SetField("_json", json_object_to_json_string(poSource));
 
         BuildFeature(poFeature, poSource, CPLString());
-        if( poFeature->GetFID() < 0 )
-            poFeature->SetFID( ++m_iCurID );
-        m_apoCachedFeatures.push_back(poFeature);
+        apoFeatures.push_back(poFeature);
     }
 
     json_object_put(poResponse);
-    if( !m_apoCachedFeatures.empty() )
+    return true;
+}
+
+/************************************************************************/
+/*                        CanUseScrollSlices()                          */
+/************************************************************************/
+
+bool OGRElasticLayer::CanUseScrollSlices() const
+{
+    // Sliced scrolls are available since ES 5. They do not preserve any
+    // order, so they are not used when sorting is requested.
+    return m_poDS->m_nScrollSlices > 1 &&
+           m_poDS->m_nMajorVersion >= 5 &&
+           m_osESSearch.empty() &&
+           m_aoSortColumns.empty();
+}
+
+/************************************************************************/
+/*                         InitScrollSlices()                           */
+/************************************************************************/
+
+void OGRElasticLayer::InitScrollSlices(const CPLString& osRequest,
+                                       const CPLString& osPostData)
+{
+    json_object* poQuery = nullptr;
+    if( osPostData.empty() ||
+        !OGRJSonParse(osPostData, &poQuery, false) ||
+        json_object_get_type(poQuery) != json_type_object )
     {
-        OGRFeature* poRet = m_apoCachedFeatures[ 0 ];
-        m_apoCachedFeatures[ 0 ] = nullptr;
-        m_iCurFeatureInPage ++;
-        m_nReadFeaturesSinceResetReading ++;
-        return poRet;
+        json_object_put(poQuery);
+        poQuery = json_object_new_object();
+    }
+
+    const int nSlices = m_poDS->m_nScrollSlices;
+    m_aoScrollSlices.resize(nSlices);
+    for( int i = 0; i < nSlices; i++ )
+    {
+        json_object* poSlice = json_object_new_object();
+        json_object_object_add(poSlice, "id", json_object_new_int(i));
+        json_object_object_add(poSlice, "max", json_object_new_int(nSlices));
+        json_object_object_add(poQuery, "slice", poSlice);
+
+        m_aoScrollSlices[i].poLayer = this;
+        m_aoScrollSlices[i].osRequest = osRequest;
+        m_aoScrollSlices[i].osPostData = json_object_to_json_string(poQuery);
+    }
+    json_object_put(poQuery);
+}
+
+/************************************************************************/
+/*                      FetchScrollSliceFunc()                          */
+/************************************************************************/
+
+static void CPL_STDCALL OGRESCollectErrorHandler(CPLErr eErr, CPLErrorNum,
+                                                 const char* pszMsg)
+{
+    if( eErr == CE_Failure )
+    {
+        OGRESScrollSlice* psSlice =
+            static_cast<OGRESScrollSlice*>(CPLGetErrorHandlerUserData());
+        psSlice->osErrorMsg = pszMsg;
+    }
+}
+
+void OGRElasticLayer::FetchScrollSliceFunc(void* pData)
+{
+    OGRESScrollSlice* psSlice = static_cast<OGRESScrollSlice*>(pData);
+    OGRElasticLayer* poLayer = psSlice->poLayer;
+
+    CPLPushErrorHandlerEx(OGRESCollectErrorHandler, psSlice);
+    json_object* poResponse =
+        poLayer->m_poDS->RunRequest(psSlice->osRequest, psSlice->osPostData);
+    CPLPopErrorHandler();
+
+    if( poResponse == nullptr ||
+        !poLayer->BuildFeaturesFromResponse(poResponse, psSlice->osScrollID,
+                                            psSlice->apoFeatures) )
+    {
+        psSlice->bEOF = true;
+        return;
+    }
+    if( psSlice->osScrollID.empty() )
+    {
+        psSlice->bEOF = true;
+        return;
+    }
+    psSlice->osRequest = CPLSPrintf("%s/_search/scroll?scroll=1m&scroll_id=%s",
+                                    poLayer->m_poDS->GetURL(),
+                                    psSlice->osScrollID.c_str());
+    if( poLayer->m_bAddPretty )
+        psSlice->osRequest += "&pretty";
+    psSlice->osPostData.clear();
+}
+
+/************************************************************************/
+/*                         FetchScrollSlices()                          */
+/*                                                                      */
+/*      Fetch the next page of each slice not yet exhausted, each one   */
+/*      in a worker thread, and append their features to the cache.    */
+/************************************************************************/
+
+void OGRElasticLayer::FetchScrollSlices()
+{
+    while( m_apoCachedFeatures.empty() )
+    {
+        std::vector<OGRESScrollSlice*> apsSlices;
+        for( auto& oSlice: m_aoScrollSlices )
+        {
+            if( !oSlice.bEOF )
+                apsSlices.push_back(&oSlice);
+        }
+        if( apsSlices.empty() )
+        {
+            m_bEOF = true;
+            return;
+        }
+
+        CPLWorkerThreadPool* poPool =
+            GDALGetGlobalThreadPool(static_cast<int>(apsSlices.size()));
+        auto poJobQueue = poPool ? poPool->CreateJobQueue() : nullptr;
+        for( auto psSlice: apsSlices )
+        {
+            if( poJobQueue == nullptr ||
+                !poJobQueue->SubmitJob(FetchScrollSliceFunc, psSlice) )
+            {
+                FetchScrollSliceFunc(psSlice);
+            }
+        }
+        if( poJobQueue )
+            poJobQueue->WaitCompletion();
+
+        // Features are returned slice after slice, in the order of the
+        // slices.
+        for( auto psSlice: apsSlices )
+        {
+            if( !psSlice->osErrorMsg.empty() )
+            {
+                CPLError(CE_Failure, CPLE_AppDefined, "%s",
+                         psSlice->osErrorMsg.c_str());
+                psSlice->osErrorMsg.clear();
+            }
+            for( auto poFeature: psSlice->apoFeatures )
+            {
+                if( poFeature->GetFID() < 0 )
+                    poFeature->SetFID( ++m_iCurID );
+                m_apoCachedFeatures.push_back(poFeature);
+            }
+            psSlice->apoFeatures.clear();
+        }
     }
-    return nullptr;
 }
 
 /************************************************************************/
@@ -2424,7 +2640,7 @@ OGRErr OGRElasticLayer::ICreateFeature(OGRFeature *poFeature)
 
         // Only push the data if we are over our bulk upload limit
         if ((int) m_osBulkContent.length() > m_nBulkUpload) {
-            if( !PushIndex() )
+            if( !PushIndex(false) )
             {
                 return OGRERR_FAILURE;
             }
@@ -2508,18 +2724,112 @@ OGRErr OGRElasticLayer::ISetFeature(OGRFeature *poFeature)
 /*                             PushIndex()                              */
 /************************************************************************/
 
-bool OGRElasticLayer::PushIndex()
+bool OGRElasticLayer::PushIndex(bool bWaitCompletion)
+{
+    bool bRet = true;
+    if( !m_osBulkContent.empty() )
+    {
+        if( m_nBulkConcurrency > 1 )
+        {
+            bRet = SubmitBulkUpload();
+        }
+        else
+        {
+            bRet = m_poDS->UploadFile(CPLSPrintf("%s/_bulk", m_poDS->GetURL()),
+                                      m_osBulkContent);
+            m_osBulkContent.clear();
+        }
+    }
+
+    // Wait for the requests in flight to be done, so that the caller
+    // sees all the features sent so far.
+    if( bWaitCompletion && !CollectBulkUploads(0) )
+        bRet = false;
+
+    return bRet;
+}
+
+/************************************************************************/
+/*                           BulkUploadFunc()                           */
+/************************************************************************/
+
+void OGRElasticLayer::BulkUploadFunc(void* pData)
+{
+    OGRESBulkUploadJob* psJob = static_cast<OGRESBulkUploadJob*>(pData);
+    psJob->bRet = psJob->poDS->UploadFile(psJob->osURL, psJob->osContent,
+                                          CPLString(), &psJob->osErrorMsg);
+    psJob->osContent.clear();
+    psJob->bDone = true;
+}
+
+/************************************************************************/
+/*                          SubmitBulkUpload()                          */
+/*                                                                      */
+/*      Send the current bulk content in a worker thread. At most       */
+/*      m_nBulkConcurrency requests are in flight: when that limit is   */
+/*      reached, wait for one of them to complete.                      */
+/************************************************************************/
+
+bool OGRElasticLayer::SubmitBulkUpload()
 {
-    if( m_osBulkContent.empty() )
+    if( m_poBulkJobQueue == nullptr )
+    {
+        CPLWorkerThreadPool* poPool = GDALGetGlobalThreadPool(m_nBulkConcurrency);
+        if( poPool )
+            m_poBulkJobQueue = poPool->CreateJobQueue();
+    }
+
+    bool bRet = CollectBulkUploads(m_nBulkConcurrency - 1);
+
+    std::unique_ptr<OGRESBulkUploadJob> poJob(new OGRESBulkUploadJob());
+    poJob->poDS = m_poDS;
+    poJob->osURL = CPLSPrintf("%s/_bulk", m_poDS->GetURL());
+    std::swap(poJob->osContent, m_osBulkContent);
+    if( m_poBulkJobQueue == nullptr ||
+        !m_poBulkJobQueue->SubmitJob(BulkUploadFunc, poJob.get()) )
     {
-        return true;
+        BulkUploadFunc(poJob.get());
     }
+    m_apoBulkJobs.push_back(std::move(poJob));
+
+    if( !CollectBulkUploads(INT_MAX) )
+        bRet = false;
+    return bRet;
+}
 
-    const bool bRet =
-      m_poDS->UploadFile(CPLSPrintf("%s/_bulk", m_poDS->GetURL()),
-                         m_osBulkContent);
-    m_osBulkContent.clear();
+/************************************************************************/
+/*                         CollectBulkUploads()                         */
+/*                                                                      */
+/*      Wait until at most nMaxRemaining bulk requests are in flight,   */
+/*      and report the errors of the completed ones.                    */
+/************************************************************************/
+
+bool OGRElasticLayer::CollectBulkUploads(int nMaxRemaining)
+{
+    if( m_poBulkJobQueue != nullptr &&
+        static_cast<int>(m_apoBulkJobs.size()) > nMaxRemaining )
+    {
+        m_poBulkJobQueue->WaitCompletion(nMaxRemaining);
+    }
 
+    bool bRet = true;
+    for( auto oIter = m_apoBulkJobs.begin(); oIter != m_apoBulkJobs.end(); )
+    {
+        if( (*oIter)->bDone )
+        {
+            if( !(*oIter)->bRet )
+            {
+                bRet = false;
+                CPLError(CE_Failure, CPLE_AppDefined, "%s",
+                         (*oIter)->osErrorMsg.c_str());
+            }
+            oIter = m_apoBulkJobs.erase(oIter);
+        }
+        else
+        {
+            ++oIter;
+        }
+    }
     return bRet;
 }
 
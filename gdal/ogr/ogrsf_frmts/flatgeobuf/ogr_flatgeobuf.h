@@ -48,6 +48,11 @@ static constexpr uint32_t header_max_buffer_size = 1048576 * 10;
 // Cannot be larger than that, due to a x2 logic done in ensureFeatureBuf()
 static constexpr uint32_t feature_max_buffer_size = static_cast<uint32_t>(std::numeric_limits<int32_t>::max());
 
+// Limits of the prefetching of features found by an index search
+static constexpr size_t prefetch_max_features = 1000;
+static constexpr uint32_t prefetch_max_feature_size = 1024 * 1024;
+static constexpr size_t prefetch_max_buffer_size = 1048576 * 10;
+
 // holds feature meta needed to build spatial index
 struct FeatureItem : FlatGeobuf::Item {
     uint32_t size;
@@ -89,11 +94,19 @@ class OGRFlatGeobufLayer final : public OGRLayer, public OGRFlatGeobufBaseLayerI
         size_t m_featuresPos = 0; // current iteration position
         uint64_t m_offset = 0; // current read offset
         uint64_t m_offsetFeatures = 0; // offset of feature data
-        std::vector<FlatGeobuf::SearchResultItem> m_foundItems; // found node items in spatial index search
+        std::vector<FlatGeobuf::SearchResultItem> m_foundItems; // found node items in spatial and/or attribute index search
         bool m_queriedSpatialIndex = false;
+        bool m_queriedAttributeIndex = false;
+        bool m_attributeIndexChecked = false;
         bool m_ignoreSpatialFilter = false;
         bool m_ignoreAttributeFilter = false;
 
+        // prefetching of the data of found features, for remote files
+        bool m_bPrefetchFeatures = false;
+        size_t m_prefetchStart = 0; // index in m_foundItems of the first prefetched feature
+        std::vector<size_t> m_prefetchOffsets; // offsets of prefetched features in m_prefetchBuffer, plus end offset
+        std::vector<GByte> m_prefetchBuffer;
+
         // creation
         bool m_create = false;
         bool m_update = false;
@@ -106,6 +119,9 @@ class OGRFlatGeobufLayer final : public OGRLayer, public OGRFlatGeobufBaseLayerI
         uint16_t m_indexNodeSize = 0;
         std::string m_osTempFile; // holds generated temp file name for two pass writing
         uint32_t m_maxFeatureSize  = 0;
+        size_t m_nSortMaxMemory = 0; // memory allowed for sorting feature items
+        VSILFILE *m_poFpItems = nullptr; // feature items spilled to disk when exceeding m_nSortMaxMemory
+        std::string m_osTempItemsFile;
 
         // shared
         GByte *m_featureBuf = nullptr; // reusable/resizable feature data buffer
@@ -115,14 +131,22 @@ class OGRFlatGeobufLayer final : public OGRLayer, public OGRFlatGeobufBaseLayerI
         void ensurePadfBuffers(size_t count);
         OGRErr ensureFeatureBuf(uint32_t featureSize);
         OGRErr parseFeature(OGRFeature *poFeature);
+        void prefetchFeatures();
+        bool readPrefetchedFeature(uint32_t &featureSize);
+        void clearPrefetchedFeatures();
         const std::vector<flatbuffers::Offset<FlatGeobuf::Column>> writeColumns(flatbuffers::FlatBufferBuilder &fbb);
         void readColumns();
         OGRErr readIndex();
+        OGRErr readSpatialIndex();
+        OGRErr readAttributeIndex();
         OGRErr readFeatureOffset(uint64_t index, uint64_t &featureOffset);
 
         // serialize
         void Create();
         void writeHeader(VSILFILE *poFp, uint64_t featuresCount, std::vector<double> *extentVector);
+        bool writeFeatureItem(const FeatureItem &item);
+        bool spillFeatureItems();
+        void writeExternalSortedFeatures();
 
         // construction
         OGRFlatGeobufLayer(const FlatGeobuf::Header *, GByte *headerBuf, const char *pszFilename, VSILFILE *poFp, uint64_t offset, bool update);
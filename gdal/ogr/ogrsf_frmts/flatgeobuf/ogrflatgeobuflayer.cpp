@@ -32,6 +32,7 @@
 #include "cpl_json.h"
 #include "cpl_http.h"
 #include "ogr_p.h"
+#include "gdal_perf_counters.h"
 
 #include "ogr_flatgeobuf.h"
 #include "cplerrors.h"
@@ -39,7 +40,9 @@
 #include "geometrywriter.h"
 
 #include <algorithm>
+#include <functional>
 #include <new>
+#include <queue>
 #include <stdexcept>
 
 using namespace flatbuffers;
@@ -75,6 +78,10 @@ OGRFlatGeobufLayer::OGRFlatGeobufLayer(
     m_offset = offset;
     m_create = false;
     m_update = update;
+    // Reading local files feature by feature is cheap. Only prefetch the
+    // features found by index searches on other (typically remote) files.
+    m_bPrefetchFeatures = m_poFp != nullptr &&
+        VSIFGetNativeFileDescriptorL(m_poFp) == nullptr;
 
     m_featuresCount = m_poHeader->features_count();
     m_geometryType = m_poHeader->geometry_type();
@@ -151,6 +158,11 @@ OGRFlatGeobufLayer::OGRFlatGeobufLayer(
     m_poFeatureDefn->AddGeomFieldDefn(poGeomFieldDefn, false);
     readColumns();
     m_poFeatureDefn->Reference();
+
+    // Attribute indexes need random access to features, hence the
+    // spatial index that holds feature offsets.
+    if (!m_update && m_indexNodeSize > 0)
+        InitializeBTreeIndexSupport(m_osFilename.c_str());
 }
 
 OGRFlatGeobufLayer::OGRFlatGeobufLayer(
@@ -184,6 +196,18 @@ OGRFlatGeobufLayer::OGRFlatGeobufLayer(
 
     SetMetadataItem(OLMD_FID64, "YES");
 
+    // Beyond that amount of memory, feature items to sort for the spatial
+    // index are spilled to disk and sorted with an external merge sort.
+    const char *pszSortMaxMemory = CPLGetConfigOption("FLATGEOBUF_SORT_MAX_MEMORY", nullptr);
+    GIntBig nSortMaxMemory = 1024 * 1024 * 1024;
+    if (pszSortMaxMemory)
+        nSortMaxMemory = CPLAtoGIntBig(pszSortMaxMemory) * 1024 * 1024;
+    else if (CPLGetUsablePhysicalRAM() > 0)
+        nSortMaxMemory = std::min(nSortMaxMemory, CPLGetUsablePhysicalRAM() / 4);
+    m_nSortMaxMemory = static_cast<size_t>(std::min(
+        std::max(nSortMaxMemory, static_cast<GIntBig>(1024 * 1024)),
+        static_cast<GIntBig>(std::numeric_limits<size_t>::max() / 4)));
+
     m_poFeatureDefn = new OGRFeatureDefn(pszLayerName);
     SetDescription(m_poFeatureDefn->GetName());
     m_poFeatureDefn->SetGeomType(eGType);
@@ -386,6 +410,448 @@ void OGRFlatGeobufLayer::writeHeader(VSILFILE *poFp, uint64_t featuresCount, std
     m_writeOffset += c;
 }
 
+// Approximate memory used per feature by the in-memory sort done by Create():
+// the FeatureItem allocated by std::make_shared(), the pointer to it, and its
+// node in the PackedRTree.
+static constexpr size_t in_memory_feature_item_size =
+    sizeof(FeatureItem) + 16 + sizeof(std::shared_ptr<Item>) + sizeof(NodeItem);
+
+namespace {
+
+// Feature item, as stored in the temporary files of the external sort
+struct ExternalSortItem
+{
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+    uint64_t offset; // offset of the feature data in the temporary file
+    uint32_t size;
+    uint32_t hilbertValue;
+};
+
+// Sorted run of the external sort: items, followed by the feature data in
+// the same order.
+struct ExternalSortRun
+{
+    vsi_l_offset itemsOffset;
+    vsi_l_offset featuresOffset;
+    vsi_l_offset featuresEnd;
+    uint64_t count;
+};
+
+// Same order as hilbertSort(): decreasing Hilbert value. Ties are kept in
+// the order of insertion.
+bool ExternalSortItemLess(const ExternalSortItem &a, const ExternalSortItem &b)
+{
+    if (a.hilbertValue != b.hilbertValue)
+        return a.hilbertValue > b.hilbertValue;
+    return a.offset < b.offset;
+}
+
+// Temporary file, removed when going out of scope
+class ExternalSortTempFile
+{
+    std::string m_osFilename;
+    VSILFILE *m_fp = nullptr;
+
+    CPL_DISALLOW_COPY_ASSIGN(ExternalSortTempFile)
+
+  public:
+    explicit ExternalSortTempFile(const std::string &osFilename):
+        m_osFilename(osFilename)
+    {
+        m_fp = VSIFOpenL(m_osFilename.c_str(), "w+b");
+        if (m_fp == nullptr)
+            CPLError(CE_Failure, CPLE_OpenFailed, "Failed to create %s", m_osFilename.c_str());
+        else
+            // Unlink it now to avoid stale temporary file if killing the process
+            // (only works on Unix)
+            VSIUnlink(m_osFilename.c_str());
+    }
+
+    ~ExternalSortTempFile()
+    {
+        if (m_fp) {
+            VSIFCloseL(m_fp);
+            VSIUnlink(m_osFilename.c_str());
+        }
+    }
+
+    VSILFILE *get() const { return m_fp; }
+};
+
+// Buffered sequential reader of a region of a file, that can share the
+// file handle with readers of other regions.
+class ExternalSortReader
+{
+    VSILFILE *m_fp;
+    vsi_l_offset m_offset;
+    vsi_l_offset m_end;
+    size_t m_chunkSize;
+    std::vector<GByte> m_buffer{};
+    size_t m_pos = 0;
+    size_t m_size = 0;
+
+  public:
+    ExternalSortReader(VSILFILE *fp, vsi_l_offset offset, vsi_l_offset end, size_t chunkSize):
+        m_fp(fp), m_offset(offset), m_end(end), m_chunkSize(chunkSize) {}
+
+    // Returns a pointer to the next size bytes, valid until the next call,
+    // or nullptr in case of error.
+    const GByte *read(size_t size)
+    {
+        if (m_size - m_pos < size) {
+            const size_t remaining = m_size - m_pos;
+            if (remaining > 0)
+                memmove(m_buffer.data(), m_buffer.data() + m_pos, remaining);
+            m_pos = 0;
+            m_size = remaining;
+            const size_t bufferSize = std::max(m_chunkSize, size);
+            if (m_buffer.size() < bufferSize)
+                m_buffer.resize(bufferSize);
+            const size_t toRead = static_cast<size_t>(
+                std::min(static_cast<vsi_l_offset>(m_buffer.size() - m_size), m_end - m_offset));
+            if (toRead > 0 &&
+                (VSIFSeekL(m_fp, m_offset, SEEK_SET) != 0 ||
+                 VSIFReadL(m_buffer.data() + m_size, 1, toRead, m_fp) != toRead))
+                return nullptr;
+            m_offset += toRead;
+            m_size += toRead;
+            if (m_size < size)
+                return nullptr;
+        }
+        const GByte *data = m_buffer.data() + m_pos;
+        m_pos += size;
+        return data;
+    }
+};
+
+// K-way merge of the sorted runs, calling onItem() for each item, and its
+// feature data if withFeatures is set, in the final order.
+bool ExternalSortMerge(VSILFILE *fp, const std::vector<ExternalSortRun> &runs,
+                       size_t maxMemory, bool withFeatures,
+                       const std::function<bool(const ExternalSortItem &, const GByte *)> &onItem)
+{
+    const size_t readerCount = runs.size() * (withFeatures ? 2 : 1);
+    const size_t chunkSize = std::max(static_cast<size_t>(64 * 1024), maxMemory / readerCount);
+    std::vector<ExternalSortReader> itemReaders;
+    std::vector<ExternalSortReader> featureReaders;
+    std::vector<ExternalSortItem> heads(runs.size());
+    std::vector<uint64_t> remaining(runs.size());
+    const auto greater = [&heads](size_t a, size_t b) {
+        return ExternalSortItemLess(heads[b], heads[a]);
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> queue(greater);
+    for (size_t i = 0; i < runs.size(); i++) {
+        itemReaders.emplace_back(fp, runs[i].itemsOffset, runs[i].featuresOffset, chunkSize);
+        if (withFeatures)
+            featureReaders.emplace_back(fp, runs[i].featuresOffset, runs[i].featuresEnd, chunkSize);
+        const GByte *data = itemReaders[i].read(sizeof(ExternalSortItem));
+        if (data == nullptr)
+            return false;
+        memcpy(&heads[i], data, sizeof(ExternalSortItem));
+        remaining[i] = runs[i].count - 1;
+        queue.push(i);
+    }
+    while (!queue.empty()) {
+        const size_t i = queue.top();
+        queue.pop();
+        const GByte *featureData = nullptr;
+        if (withFeatures) {
+            featureData = featureReaders[i].read(heads[i].size);
+            if (featureData == nullptr)
+                return false;
+        }
+        if (!onItem(heads[i], featureData))
+            return false;
+        if (remaining[i] > 0) {
+            const GByte *data = itemReaders[i].read(sizeof(ExternalSortItem));
+            if (data == nullptr)
+                return false;
+            memcpy(&heads[i], data, sizeof(ExternalSortItem));
+            remaining[i]--;
+            queue.push(i);
+        }
+    }
+    return true;
+}
+
+// Writes a PackedRTree to a file from its leaf nodes given in order, with the
+// same layout as PackedRTree::generateNodes(), but without holding the tree
+// in memory. The nodes of each level are written sequentially in their own
+// region of the file.
+class PackedRTreeStreamWriter
+{
+    static constexpr size_t bufferNodes = 4096;
+
+    VSILFILE *m_fp;
+    uint16_t m_nodeSize;
+    std::vector<std::pair<uint64_t, uint64_t>> m_levelBounds;
+    std::vector<uint64_t> m_levelCount; // nodes added to each level
+    std::vector<NodeItem> m_parentNode; // parent node being computed, per level
+    std::vector<uint16_t> m_parentChildren; // number of children of m_parentNode
+    std::vector<std::vector<NodeItem>> m_buffers; // nodes not yet written, per level
+
+    bool flush(size_t level)
+    {
+        auto &buffer = m_buffers[level];
+        if (buffer.empty())
+            return true;
+        const vsi_l_offset offset = (m_levelBounds[level].first + m_levelCount[level] - buffer.size()) * sizeof(NodeItem);
+        const size_t size = buffer.size() * sizeof(NodeItem);
+        if (VSIFSeekL(m_fp, offset, SEEK_SET) != 0 ||
+            VSIFWriteL(buffer.data(), 1, size, m_fp) != size)
+            return false;
+        buffer.clear();
+        return true;
+    }
+
+    bool add(size_t level, const NodeItem &node)
+    {
+        if (level + 1 < m_levelBounds.size()) {
+            if (m_parentChildren[level + 1] == 0)
+                m_parentNode[level + 1] = NodeItem::create(m_levelBounds[level].first + m_levelCount[level]);
+            m_parentNode[level + 1].expand(node);
+            m_parentChildren[level + 1]++;
+        }
+        NodeItem lsbNode = node;
+        CPL_LSBPTR64(&lsbNode.minX);
+        CPL_LSBPTR64(&lsbNode.minY);
+        CPL_LSBPTR64(&lsbNode.maxX);
+        CPL_LSBPTR64(&lsbNode.maxY);
+        CPL_LSBPTR64(&lsbNode.offset);
+        m_buffers[level].push_back(lsbNode);
+        m_levelCount[level]++;
+        if (m_levelCount[level] > m_levelBounds[level].second - m_levelBounds[level].first)
+            return false;
+        if (m_buffers[level].size() == bufferNodes && !flush(level))
+            return false;
+        if (level + 1 < m_levelBounds.size() && m_parentChildren[level + 1] == m_nodeSize) {
+            m_parentChildren[level + 1] = 0;
+            return add(level + 1, m_parentNode[level + 1]);
+        }
+        return true;
+    }
+
+  public:
+    PackedRTreeStreamWriter(VSILFILE *fp, uint64_t numItems, uint16_t nodeSize):
+        m_fp(fp), m_nodeSize(nodeSize),
+        m_levelBounds(PackedRTree::generateLevelBounds(numItems, nodeSize)),
+        m_levelCount(m_levelBounds.size()),
+        m_parentNode(m_levelBounds.size()),
+        m_parentChildren(m_levelBounds.size()),
+        m_buffers(m_levelBounds.size())
+    {
+    }
+
+    bool addLeaf(const NodeItem &node) { return add(0, node); }
+
+    bool finish()
+    {
+        for (size_t level = 1; level < m_levelBounds.size(); level++) {
+            if (m_parentChildren[level] > 0) {
+                m_parentChildren[level] = 0;
+                if (!add(level, m_parentNode[level]))
+                    return false;
+            }
+        }
+        for (size_t level = 0; level < m_levelBounds.size(); level++) {
+            if (!flush(level) ||
+                m_levelCount[level] != m_levelBounds[level].second - m_levelBounds[level].first)
+                return false;
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+bool OGRFlatGeobufLayer::writeFeatureItem(const FeatureItem &item)
+{
+    const ExternalSortItem sItem {
+        item.nodeItem.minX,
+        item.nodeItem.minY,
+        item.nodeItem.maxX,
+        item.nodeItem.maxY,
+        item.offset,
+        item.size,
+        0
+    };
+    return VSIFWriteL(&sItem, sizeof(sItem), 1, m_poFpItems) == 1;
+}
+
+// Move the feature items collected so far to a temporary file, when they
+// use more than m_nSortMaxMemory. Next ones are directly written to it.
+bool OGRFlatGeobufLayer::spillFeatureItems()
+{
+    CPLDebug("FlatGeobuf", "More than %lu bytes of feature items: using an external sort",
+             static_cast<long unsigned int>(m_nSortMaxMemory));
+    m_osTempItemsFile = m_osTempFile + "_items.tmp";
+    m_poFpItems = VSIFOpenL(m_osTempItemsFile.c_str(), "w+b");
+    if (m_poFpItems == nullptr) {
+        CPLError(CE_Failure, CPLE_OpenFailed,
+                    "Failed to create %s:\n%s",
+                    m_osTempItemsFile.c_str(), VSIStrerror(errno));
+        return false;
+    }
+    // Unlink it now to avoid stale temporary file if killing the process
+    // (only works on Unix)
+    VSIUnlink(m_osTempItemsFile.c_str());
+
+    for (const auto &item: m_featureItems) {
+        if (!writeFeatureItem(*std::static_pointer_cast<FeatureItem>(item))) {
+            CPLErrorIO("writing feature item");
+            return false;
+        }
+    }
+    std::vector<std::shared_ptr<FlatGeobuf::Item>>().swap(m_featureItems);
+    return true;
+}
+
+// Second pass of Create() when feature items have been spilled to disk.
+// Feature items and data are sorted with an external merge sort using at
+// most about m_nSortMaxMemory bytes:
+// - runs of items and data, sorted in memory, are written to a temporary file
+// - a first merge of the runs computes the spatial index, which is written to
+//   another temporary file, level by level
+// - a second merge writes the feature data to the output file.
+void OGRFlatGeobufLayer::writeExternalSortedFeatures()
+{
+    NodeItem extent { m_sExtent.MinX, m_sExtent.MinY, m_sExtent.MaxX, m_sExtent.MaxY, 0 };
+    auto extentVector = extent.toVector();
+
+    writeHeader(m_poFp, m_featuresCount, &extentVector);
+
+    try {
+        ExternalSortTempFile oRunsFile(m_osTempFile + "_runs.tmp");
+        if (oRunsFile.get() == nullptr)
+            return;
+
+        CPLDebugOnly("FlatGeobuf", "Writing sorted runs");
+        if (VSIFSeekL(m_poFpItems, 0, SEEK_SET) != 0) {
+            CPLErrorIO("seeking to first feature item");
+            return;
+        }
+        std::vector<ExternalSortRun> runs;
+        std::vector<ExternalSortItem> items;
+        std::vector<GByte> featuresBuf;
+        vsi_l_offset runsOffset = 0;
+        uint64_t itemsRead = 0;
+        while (itemsRead < m_featuresCount) {
+            items.clear();
+            size_t runSize = 0;
+            while (itemsRead < m_featuresCount && runSize < m_nSortMaxMemory) {
+                items.emplace_back();
+                if (VSIFReadL(&items.back(), sizeof(ExternalSortItem), 1, m_poFpItems) != 1) {
+                    CPLErrorIO("reading feature item");
+                    return;
+                }
+                itemsRead++;
+                runSize += sizeof(ExternalSortItem) + items.back().size;
+            }
+
+            // Feature data of consecutive items is contiguous in the temporary file
+            const vsi_l_offset featuresStart = items.front().offset;
+            featuresBuf.resize(static_cast<size_t>(items.back().offset + items.back().size - featuresStart));
+            if (VSIFSeekL(m_poFpWrite, featuresStart, SEEK_SET) == -1) {
+                CPLErrorIO("seeking to temp feature location");
+                return;
+            }
+            if (VSIFReadL(featuresBuf.data(), 1, featuresBuf.size(), m_poFpWrite) != featuresBuf.size()) {
+                CPLErrorIO("reading temp feature");
+                return;
+            }
+
+            for (auto &item: items) {
+                const NodeItem n { item.minX, item.minY, item.maxX, item.maxY, 0 };
+                item.hilbertValue = hilbert(n, extent);
+            }
+            std::sort(items.begin(), items.end(), ExternalSortItemLess);
+
+            ExternalSortRun run;
+            run.itemsOffset = runsOffset;
+            run.count = items.size();
+            const size_t itemsSize = items.size() * sizeof(ExternalSortItem);
+            if (VSIFWriteL(items.data(), 1, itemsSize, oRunsFile.get()) != itemsSize) {
+                CPLErrorIO("writing sorted feature items");
+                return;
+            }
+            runsOffset += itemsSize;
+            run.featuresOffset = runsOffset;
+            for (const auto &item: items) {
+                if (VSIFWriteL(featuresBuf.data() + (item.offset - featuresStart), 1, item.size, oRunsFile.get()) != item.size) {
+                    CPLErrorIO("writing sorted features");
+                    return;
+                }
+                runsOffset += item.size;
+            }
+            run.featuresEnd = runsOffset;
+            runs.push_back(run);
+        }
+        items = std::vector<ExternalSortItem>();
+        featuresBuf = std::vector<GByte>();
+        CPLDebugOnly("FlatGeobuf", "Wrote %lu sorted runs", static_cast<long unsigned int>(runs.size()));
+
+        CPLDebugOnly("FlatGeobuf", "Creating Packed R-tree");
+        {
+            ExternalSortTempFile oTreeFile(m_osTempFile + "_tree.tmp");
+            if (oTreeFile.get() == nullptr)
+                return;
+            PackedRTreeStreamWriter treeWriter(oTreeFile.get(), m_featuresCount, m_indexNodeSize);
+            uint64_t featureOffset = 0;
+            const auto addLeaf = [&treeWriter, &featureOffset] (const ExternalSortItem &item, const GByte *) {
+                const NodeItem n { item.minX, item.minY, item.maxX, item.maxY, featureOffset };
+                featureOffset += item.size;
+                return treeWriter.addLeaf(n);
+            };
+            if (!ExternalSortMerge(oRunsFile.get(), runs, m_nSortMaxMemory, false, addLeaf) ||
+                !treeWriter.finish()) {
+                CPLErrorIO("writing Packed R-tree");
+                return;
+            }
+
+            const uint64_t treeSize = PackedRTree::size(m_featuresCount, m_indexNodeSize);
+            std::vector<GByte> copyBuf(static_cast<size_t>(std::min(treeSize, static_cast<uint64_t>(1024 * 1024))));
+            if (VSIFSeekL(oTreeFile.get(), 0, SEEK_SET) != 0) {
+                CPLErrorIO("seeking to Packed R-tree");
+                return;
+            }
+            for (uint64_t copied = 0; copied < treeSize; ) {
+                const size_t size = static_cast<size_t>(std::min(treeSize - copied, static_cast<uint64_t>(copyBuf.size())));
+                if (VSIFReadL(copyBuf.data(), 1, size, oTreeFile.get()) != size ||
+                    VSIFWriteL(copyBuf.data(), 1, size, m_poFp) != size) {
+                    CPLErrorIO("writing Packed R-tree");
+                    return;
+                }
+                copied += size;
+            }
+            CPLDebugOnly("FlatGeobuf", "Wrote tree (%lu bytes)", static_cast<long unsigned int>(treeSize));
+            m_writeOffset += treeSize;
+        }
+
+        CPLDebugOnly("FlatGeobuf", "Writing feature buffers at offset %lu", static_cast<long unsigned int>(m_writeOffset));
+        uint64_t c = 0;
+        const auto writeFeature = [this, &c] (const ExternalSortItem &item, const GByte *data) {
+            if (VSIFWriteL(data, 1, item.size, m_poFp) != item.size)
+                return false;
+            c += item.size;
+            return true;
+        };
+        if (!ExternalSortMerge(oRunsFile.get(), runs, m_nSortMaxMemory, true, writeFeature)) {
+            CPLErrorIO("writing feature");
+            return;
+        }
+        CPLDebugOnly("FlatGeobuf", "Wrote feature buffers (%lu bytes)", static_cast<long unsigned int>(c));
+        m_writeOffset += c;
+    } catch (const std::exception& e) {
+        CPLError(CE_Failure, CPLE_AppDefined, "Create: %s", e.what());
+        return;
+    }
+
+    CPLDebugOnly("FlatGeobuf", "Now at offset %lu", static_cast<long unsigned int>(m_writeOffset));
+}
+
 void OGRFlatGeobufLayer::Create() {
     // no spatial index requested, we are done
     if (!m_bCreateSpatialIndexAtClose)
@@ -412,6 +878,11 @@ void OGRFlatGeobufLayer::Create() {
     m_writeOffset = 0;
     m_indexNodeSize = 16;
 
+    if (m_poFpItems != nullptr) {
+        writeExternalSortedFeatures();
+        return;
+    }
+
     size_t c;
 
     if (m_featuresCount >= std::numeric_limits<size_t>::max() / 8) {
@@ -584,9 +1055,15 @@ OGRFlatGeobufLayer::~OGRFlatGeobufLayer()
     if (m_poFpWrite)
         VSIFCloseL(m_poFpWrite);
 
+    if (m_poFpItems)
+        VSIFCloseL(m_poFpItems);
+
     if (!m_osTempFile.empty())
         VSIUnlink(m_osTempFile.c_str());
 
+    if (!m_osTempItemsFile.empty())
+        VSIUnlink(m_osTempItemsFile.c_str());
+
     if (m_poFeatureDefn)
         m_poFeatureDefn->Release();
 
@@ -644,6 +1121,58 @@ OGRFeature *OGRFlatGeobufLayer::GetFeature(GIntBig nFeatureId)
 }
 
 OGRErr OGRFlatGeobufLayer::readIndex()
+{
+    const auto err = readSpatialIndex();
+    if (err != OGRERR_NONE)
+        return err;
+    return readAttributeIndex();
+}
+
+OGRErr OGRFlatGeobufLayer::readAttributeIndex()
+{
+    if (m_queriedAttributeIndex || m_attributeIndexChecked ||
+        m_poAttrQuery == nullptr || m_ignoreAttributeFilter ||
+        m_poAttrIndex == nullptr)
+        return OGRERR_NONE;
+    m_attributeIndexChecked = true;
+
+    GIntBig *panFIDs = m_poAttrQuery->EvaluateAgainstIndices(this, nullptr);
+    if (panFIDs == nullptr)
+        return OGRERR_NONE;
+    std::unique_ptr<GIntBig, CPLFreeReleaser> fids(panFIDs);
+
+    size_t fidsCount = 0;
+    while (panFIDs[fidsCount] != OGRNullFID)
+        fidsCount++;
+    CPLDebugOnly("FlatGeobuf", "%lu features found in attribute index search", static_cast<long unsigned int>(fidsCount));
+
+    std::vector<SearchResultItem> foundItems;
+    if (m_queriedSpatialIndex) {
+        // Keep the spatial search results that are also attribute matches
+        for (const auto &item : m_foundItems) {
+            if (std::binary_search(panFIDs, panFIDs + fidsCount, static_cast<GIntBig>(item.index)))
+                foundItems.push_back(item);
+        }
+    } else {
+        const auto featuresCount = m_poHeader->features_count();
+        for (size_t i = 0; i < fidsCount; i++) {
+            if (panFIDs[i] < 0 || static_cast<uint64_t>(panFIDs[i]) >= featuresCount)
+                continue;
+            uint64_t featureOffset;
+            const auto err = readFeatureOffset(panFIDs[i], featureOffset);
+            if (err != OGRERR_NONE)
+                return err;
+            foundItems.push_back({ featureOffset, static_cast<uint64_t>(panFIDs[i]) });
+        }
+    }
+
+    m_foundItems = std::move(foundItems);
+    m_featuresCount = m_foundItems.size();
+    m_queriedAttributeIndex = true;
+    return OGRERR_NONE;
+}
+
+OGRErr OGRFlatGeobufLayer::readSpatialIndex()
 {
     if (m_queriedSpatialIndex || !m_poFilterGeom)
         return OGRERR_NONE;
@@ -677,13 +1206,30 @@ OGRErr OGRFlatGeobufLayer::readIndex()
             NodeItem n { env.MinX, env.MinY, env.MaxX, env.MaxY, 0 };
             CPLDebugOnly("FlatGeobuf", "Spatial index search on %f,%f,%f,%f", env.MinX, env.MinY, env.MaxX, env.MaxY);
             const auto treeOffset = sizeof(magicbytes) + sizeof(uoffset_t) + headerSize;
-            const auto readNode = [this, treeOffset] (uint8_t *buf, size_t i, size_t s) {
-                if (VSIFSeekL(m_poFp, treeOffset + i, SEEK_SET) == -1)
-                    throw std::runtime_error("I/O seek failure");
-                if (VSIFReadL(buf, 1, s, m_poFp) != s)
+            // Read all the nodes to visit in a tree level at once, so that
+            // reads of remote files can be merged and issued in parallel.
+            const auto readNodes = [this, treeOffset] (uint8_t *buf, const std::vector<std::pair<size_t, size_t>> &ranges) {
+                if (ranges.size() == 1) {
+                    if (VSIFSeekL(m_poFp, treeOffset + ranges[0].first, SEEK_SET) == -1)
+                        throw std::runtime_error("I/O seek failure");
+                    if (VSIFReadL(buf, 1, ranges[0].second, m_poFp) != ranges[0].second)
+                        throw std::runtime_error("I/O read file");
+                    return;
+                }
+                std::vector<void*> apData;
+                std::vector<vsi_l_offset> anOffsets;
+                std::vector<size_t> anSizes;
+                for (const auto &range: ranges) {
+                    apData.push_back(buf);
+                    anOffsets.push_back(treeOffset + range.first);
+                    anSizes.push_back(range.second);
+                    buf += range.second;
+                }
+                if (VSIFReadMultiRangeL(static_cast<int>(ranges.size()), apData.data(),
+                                        anOffsets.data(), anSizes.data(), m_poFp) != 0)
                     throw std::runtime_error("I/O read file");
             };
-            m_foundItems = PackedRTree::streamSearch(featuresCount, indexNodeSize, n, readNode);
+            m_foundItems = PackedRTree::streamSearchByLevel(featuresCount, indexNodeSize, n, readNodes);
             m_featuresCount = m_foundItems.size();
             CPLDebugOnly("FlatGeobuf", "%lu features found in spatial index search", static_cast<long unsigned int>(m_featuresCount));
 
@@ -720,7 +1266,7 @@ OGRFeature *OGRFlatGeobufLayer::GetNextFeature()
             return nullptr;
         }
 
-        if (m_queriedSpatialIndex && m_featuresCount == 0) {
+        if ((m_queriedSpatialIndex || m_queriedAttributeIndex) && m_featuresCount == 0) {
             CPLDebugOnly("FlatGeobuf", "GetNextFeature: no features found");
             return nullptr;
         }
@@ -765,10 +1311,101 @@ OGRErr OGRFlatGeobufLayer::ensureFeatureBuf(uint32_t featureSize) {
     return OGRERR_NONE;
 }
 
+void OGRFlatGeobufLayer::clearPrefetchedFeatures()
+{
+    m_prefetchStart = 0;
+    m_prefetchOffsets.clear();
+    m_prefetchBuffer.clear();
+}
+
+// Read in a batch the data of the next found features, with two
+// VSIFReadMultiRangeL() calls: one for their sizes, one for their content.
+void OGRFlatGeobufLayer::prefetchFeatures()
+{
+    clearPrefetchedFeatures();
+    m_prefetchStart = m_featuresPos;
+    const auto count = std::min(m_foundItems.size() - m_featuresPos, prefetch_max_features);
+    if (count <= 1)
+        return;
+
+    // A failure is not fatal, as features are then read one by one.
+    CPLErrorStateBackuper oErrorStateBackuper;
+    CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
+
+    std::vector<uint32_t> featureSizes(count);
+    std::vector<void*> apData(count);
+    std::vector<vsi_l_offset> anOffsets(count);
+    std::vector<size_t> anSizes(count, sizeof(uint32_t));
+    for (size_t i = 0; i < count; i++) {
+        apData[i] = &featureSizes[i];
+        anOffsets[i] = m_offsetFeatures + m_foundItems[m_featuresPos + i].offset;
+    }
+    if (VSIFReadMultiRangeL(static_cast<int>(count), apData.data(),
+                            anOffsets.data(), anSizes.data(), m_poFp) != 0)
+        return;
+
+    // Stop at the first feature that is too large, and leave it to parseFeature()
+    size_t prefetchCount = 0;
+    size_t totalSize = 0;
+    for (; prefetchCount < count; prefetchCount++) {
+        auto &featureSize = featureSizes[prefetchCount];
+        CPL_LSBPTR32(&featureSize);
+        if (featureSize > prefetch_max_feature_size ||
+            totalSize + featureSize > prefetch_max_buffer_size)
+            break;
+        totalSize += featureSize;
+    }
+    if (prefetchCount <= 1 || totalSize == 0)
+        return;
+
+    try {
+        m_prefetchBuffer.resize(totalSize);
+        m_prefetchOffsets.resize(prefetchCount + 1);
+    } catch (const std::exception &) {
+        clearPrefetchedFeatures();
+        return;
+    }
+    m_prefetchOffsets[0] = 0;
+    for (size_t i = 0; i < prefetchCount; i++) {
+        apData[i] = m_prefetchBuffer.data() + m_prefetchOffsets[i];
+        anOffsets[i] += sizeof(uint32_t);
+        anSizes[i] = featureSizes[i];
+        m_prefetchOffsets[i + 1] = m_prefetchOffsets[i] + featureSizes[i];
+    }
+    if (VSIFReadMultiRangeL(static_cast<int>(prefetchCount), apData.data(),
+                            anOffsets.data(), anSizes.data(), m_poFp) != 0) {
+        clearPrefetchedFeatures();
+        return;
+    }
+    CPLDebugOnly("FlatGeobuf", "Prefetched %lu features", static_cast<long unsigned int>(prefetchCount));
+}
+
+// Copy the data of the current found feature to m_featureBuf, from the
+// prefetched features if possible.
+bool OGRFlatGeobufLayer::readPrefetchedFeature(uint32_t &featureSize)
+{
+    if (!((m_queriedSpatialIndex && !m_ignoreSpatialFilter) || m_queriedAttributeIndex) ||
+        m_featuresPos >= m_foundItems.size())
+        return false;
+    if (m_featuresPos < m_prefetchStart ||
+        m_featuresPos + 1 >= m_prefetchStart + m_prefetchOffsets.size())
+        prefetchFeatures();
+    if (m_featuresPos < m_prefetchStart ||
+        m_featuresPos + 1 >= m_prefetchStart + m_prefetchOffsets.size())
+        return false;
+
+    const auto idx = m_featuresPos - m_prefetchStart;
+    featureSize = static_cast<uint32_t>(m_prefetchOffsets[idx + 1] - m_prefetchOffsets[idx]);
+    if (ensureFeatureBuf(featureSize) != OGRERR_NONE)
+        return false;
+    memcpy(m_featureBuf, m_prefetchBuffer.data() + m_prefetchOffsets[idx], featureSize);
+    return true;
+}
+
 OGRErr OGRFlatGeobufLayer::parseFeature(OGRFeature *poFeature) {
     GIntBig fid;
     auto seek = false;
-    if (m_queriedSpatialIndex && !m_ignoreSpatialFilter) {
+    if ((m_queriedSpatialIndex && !m_ignoreSpatialFilter) || m_queriedAttributeIndex) {
         const auto item = m_foundItems[m_featuresPos];
         m_offset = m_offsetFeatures + item.offset;
         fid = item.index;
@@ -778,51 +1415,58 @@ OGRErr OGRFlatGeobufLayer::parseFeature(OGRFeature *poFeature) {
     }
     poFeature->SetFID(fid);
 
+    GDAL_PERF_COUNTER(poFeaturesCounter, "FlatGeobuf.features_read");
+    poFeaturesCounter->Increment();
+
 
     //CPLDebugOnly("FlatGeobuf", "m_featuresPos: %lu", static_cast<long unsigned int>(m_featuresPos));
 
     if (m_featuresPos == 0)
         seek = true;
 
-    if (seek && VSIFSeekL(m_poFp, m_offset, SEEK_SET) == -1) {
-        if (VSIFEofL(m_poFp))
-            return OGRERR_NONE;
-        return CPLErrorIO("seeking to feature location");
-    }
     uint32_t featureSize;
-    if (VSIFReadL(&featureSize, sizeof(featureSize), 1, m_poFp) != 1) {
-        if (VSIFEofL(m_poFp))
-            return OGRERR_NONE;
-        return CPLErrorIO("reading feature size");
-    }
-    CPL_LSBPTR32(&featureSize);
-
-    // Sanity check to avoid allocated huge amount of memory on corrupted
-    // feature
-    if (featureSize > 100 * 1024 * 1024 )
-    {
-        if (featureSize > feature_max_buffer_size)
-            return CPLErrorInvalidSize("feature");
+    if (seek && m_bPrefetchFeatures && readPrefetchedFeature(featureSize)) {
+        // feature data has been copied to m_featureBuf
+    } else {
+        if (seek && VSIFSeekL(m_poFp, m_offset, SEEK_SET) == -1) {
+            if (VSIFEofL(m_poFp))
+                return OGRERR_NONE;
+            return CPLErrorIO("seeking to feature location");
+        }
+        if (VSIFReadL(&featureSize, sizeof(featureSize), 1, m_poFp) != 1) {
+            if (VSIFEofL(m_poFp))
+                return OGRERR_NONE;
+            return CPLErrorIO("reading feature size");
+        }
+        CPL_LSBPTR32(&featureSize);
 
-        if( m_nFileSize == 0 )
+        // Sanity check to avoid allocated huge amount of memory on corrupted
+        // feature
+        if (featureSize > 100 * 1024 * 1024 )
         {
-            VSIStatBufL sStatBuf;
-            if( VSIStatL(m_osFilename.c_str(), &sStatBuf) == 0 )
+            if (featureSize > feature_max_buffer_size)
+                return CPLErrorInvalidSize("feature");
+
+            if( m_nFileSize == 0 )
             {
-                m_nFileSize = sStatBuf.st_size;
+                VSIStatBufL sStatBuf;
+                if( VSIStatL(m_osFilename.c_str(), &sStatBuf) == 0 )
+                {
+                    m_nFileSize = sStatBuf.st_size;
+                }
+            }
+            if( m_offset + featureSize > m_nFileSize )
+            {
+                return CPLErrorIO("reading feature size");
             }
         }
-        if( m_offset + featureSize > m_nFileSize )
-        {
-            return CPLErrorIO("reading feature size");
-        }
-    }
 
-    const auto err = ensureFeatureBuf(featureSize);
-    if (err != OGRERR_NONE)
-        return err;
-    if (VSIFReadL(m_featureBuf, 1, featureSize, m_poFp) != featureSize)
-        return CPLErrorIO("reading feature");
+        const auto err = ensureFeatureBuf(featureSize);
+        if (err != OGRERR_NONE)
+            return err;
+        if (VSIFReadL(m_featureBuf, 1, featureSize, m_poFp) != featureSize)
+            return CPLErrorIO("reading feature");
+    }
     m_offset += featureSize + sizeof(featureSize);
 
     if (m_bVerifyBuffers) {
@@ -844,8 +1488,13 @@ OGRErr OGRFlatGeobufLayer::parseFeature(OGRFeature *poFeature) {
         auto geometryType = m_geometryType;
         if (geometryType == GeometryType::Unknown)
             geometryType = geometry->type();
-        GeometryReader reader { geometry, geometryType, m_hasZ, m_hasM };
-        OGRGeometry *poOGRGeometry = reader.read();
+        OGRGeometry *poOGRGeometry;
+        {
+            GDAL_PERF_COUNTER(poGeomTimeCounter, "FlatGeobuf.geometry_parse_time_ns");
+            GDALPerfCounterTimer oTimer(poGeomTimeCounter);
+            GeometryReader reader { geometry, geometryType, m_hasZ, m_hasM };
+            poOGRGeometry = reader.read();
+        }
         if (poOGRGeometry == nullptr) {
             CPLError(CE_Failure, CPLE_AppDefined, "Failed to read geometry");
             return OGRERR_CORRUPT_DATA;
@@ -1333,7 +1982,15 @@ OGRErr OGRFlatGeobufLayer::ICreateFeature(OGRFeature *poNewFeature)
 #if defined(__MINGW32__) && __GNUC__ >= 7
 #pragma GCC diagnostic pop
 #endif
-            m_featureItems.push_back(item);
+            if (m_poFpItems != nullptr) {
+                if (!writeFeatureItem(*item))
+                    return CPLErrorIO("writing feature item");
+            } else {
+                m_featureItems.push_back(item);
+                if (m_featureItems.size() * in_memory_feature_item_size > m_nSortMaxMemory &&
+                    !spillFeatureItems())
+                    return OGRERR_FAILURE;
+            }
         }
         m_writeOffset += c;
 
@@ -1390,8 +2047,11 @@ void OGRFlatGeobufLayer::ResetReading()
     m_offset = m_offsetFeatures;
     m_featuresPos = 0;
     m_foundItems.clear();
+    clearPrefetchedFeatures();
     m_featuresCount = m_poHeader ? m_poHeader->features_count() : 0;
     m_queriedSpatialIndex = false;
+    m_queriedAttributeIndex = false;
+    m_attributeIndexChecked = false;
     m_ignoreSpatialFilter = false;
     m_ignoreAttributeFilter = false;
     return;
@@ -142,6 +142,12 @@ uint32_t hilbert(const NodeItem &r, uint32_t hilbertMax, const double minX, cons
 
 const uint32_t hilbertMax = (1 << 16) - 1;
 
+// Hilbert value used to sort items, as done by hilbertSort()
+uint32_t hilbert(const NodeItem &n, const NodeItem &extent)
+{
+    return hilbert(n, hilbertMax, extent.minX, extent.minY, extent.width(), extent.height());
+}
+
 void hilbertSort(std::vector<std::shared_ptr<Item>> &items)
 {
     NodeItem extent = calcExtent(items);
@@ -360,6 +366,62 @@ std::vector<SearchResultItem> PackedRTree::streamSearch(
     return results;
 }
 
+std::vector<SearchResultItem> PackedRTree::streamSearchByLevel(
+    const uint64_t numItems, const uint16_t nodeSize, const NodeItem &item,
+    const std::function<void(uint8_t *, const std::vector<std::pair<size_t, size_t>> &)> &readNodes)
+{
+    auto levelBounds = generateLevelBounds(numItems, nodeSize);
+    uint64_t leafNodesOffset = levelBounds.front().first;
+    uint64_t numNodes = levelBounds.front().second;
+    std::vector<SearchResultItem> results;
+    // nodes to visit in the current level, in increasing order
+    std::vector<uint64_t> nodeIndices { 0 };
+    std::vector<std::pair<size_t, size_t>> ranges;
+    std::vector<NodeItem> nodeItems;
+    for (size_t level = levelBounds.size(); level > 0 && !nodeIndices.empty(); ) {
+        level--;
+        ranges.clear();
+        size_t itemCount = 0;
+        for (const auto nodeIndex : nodeIndices) {
+            const uint64_t end = std::min(static_cast<uint64_t>(nodeIndex + nodeSize), levelBounds[level].second);
+            const auto length = static_cast<size_t>(end - nodeIndex);
+            ranges.push_back({ static_cast<size_t>(nodeIndex * sizeof(NodeItem)), length * sizeof(NodeItem) });
+            itemCount += length;
+        }
+        nodeItems.resize(itemCount);
+        readNodes(reinterpret_cast<uint8_t *>(nodeItems.data()), ranges);
+#if !CPL_IS_LSB
+        for( size_t i = 0; i < itemCount; i++ )
+        {
+            CPL_LSBPTR64(&nodeItems[i].minX);
+            CPL_LSBPTR64(&nodeItems[i].minY);
+            CPL_LSBPTR64(&nodeItems[i].maxX);
+            CPL_LSBPTR64(&nodeItems[i].maxY);
+            CPL_LSBPTR64(&nodeItems[i].offset);
+        }
+#endif
+        std::vector<uint64_t> childIndices;
+        size_t itemIdx = 0;
+        for (size_t i = 0; i < nodeIndices.size(); i++) {
+            const uint64_t nodeIndex = nodeIndices[i];
+            const bool isLeafNode = nodeIndex >= numNodes - numItems;
+            const size_t length = ranges[i].second / sizeof(NodeItem);
+            for (size_t nodePos = 0; nodePos < length; nodePos++) {
+                const auto &nodeItem = nodeItems[itemIdx + nodePos];
+                if (!item.intersects(nodeItem))
+                    continue;
+                if (isLeafNode)
+                    results.push_back({ nodeItem.offset, nodeIndex + nodePos - leafNodesOffset });
+                else
+                    childIndices.push_back(nodeItem.offset);
+            }
+            itemIdx += length;
+        }
+        nodeIndices = std::move(childIndices);
+    }
+    return results;
+}
+
 uint64_t PackedRTree::size() const { return _numNodes * sizeof(NodeItem); }
 
 uint64_t PackedRTree::size(const uint64_t numItems, const uint16_t nodeSize)
@@ -69,6 +69,7 @@ std::ostream& operator << (std::ostream& os, NodeItem const& value);
 
 uint32_t hilbert(uint32_t x, uint32_t y);
 uint32_t hilbert(const NodeItem &n, uint32_t hilbertMax, const double minX, const double minY, const double width, const double height);
+uint32_t hilbert(const NodeItem &n, const NodeItem &extent);
 void hilbertSort(std::vector<std::shared_ptr<Item>> &items);
 void hilbertSort(std::vector<NodeItem> &items);
 NodeItem calcExtent(const std::vector<std::shared_ptr<Item>> &items);
@@ -100,6 +101,13 @@ public:
     static std::vector<SearchResultItem> streamSearch(
         const uint64_t numItems, const uint16_t nodeSize, const NodeItem &item,
         const std::function<void(uint8_t *, size_t, size_t)> &readNode);
+    // Same as streamSearch(), but reading all the nodes to visit in a level
+    // of the tree with a single call, so that remote reads can be coalesced.
+    // readNodes() receives (offset, size) byte ranges in the tree, and must
+    // store them contiguously in the passed buffer.
+    static std::vector<SearchResultItem> streamSearchByLevel(
+        const uint64_t numItems, const uint16_t nodeSize, const NodeItem &item,
+        const std::function<void(uint8_t *, const std::vector<std::pair<size_t, size_t>> &)> &readNodes);
     static std::vector<std::pair<uint64_t, uint64_t>> generateLevelBounds(const uint64_t numItems, const uint16_t nodeSize);
     uint64_t size() const;
     static uint64_t size(const uint64_t numItems, const uint16_t nodeSize = 16);
@@ -77,4 +77,49 @@ OGRAttrIndex::OGRAttrIndex() {}
 
 OGRAttrIndex::~OGRAttrIndex() {}
 
+/************************************************************************/
+/*                        SupportsRangeQueries()                        */
+/************************************************************************/
+
+bool OGRAttrIndex::SupportsRangeQueries() const
+
+{
+    return false;
+}
+
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/************************************************************************/
+
+GIntBig *OGRAttrIndex::GetRangeMatches( const OGRField * /* psMin */,
+                                        bool /* bMinIncluded */,
+                                        const OGRField * /* psMax */,
+                                        bool /* bMaxIncluded */,
+                                        int * /* pnFIDCount */ )
+
+{
+    return nullptr;
+}
+
+/************************************************************************/
+/*                          GetPrefixMatches()                          */
+/************************************************************************/
+
+GIntBig *OGRAttrIndex::GetPrefixMatches( const char * /* pszPrefix */,
+                                         int * /* pnFIDCount */ )
+
+{
+    return nullptr;
+}
+
+/************************************************************************/
+/*                           GetNullMatches()                           */
+/************************************************************************/
+
+GIntBig *OGRAttrIndex::GetNullMatches( int * /* pnFIDCount */ )
+
+{
+    return nullptr;
+}
+
 //! @endcond
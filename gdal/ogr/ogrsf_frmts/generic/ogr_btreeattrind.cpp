@@ -0,0 +1,1378 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Implements a persistent B+tree attribute index stored in a
+ *           .ogridx sidecar file, usable by any driver offering random
+ *           access to its features.
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_attrind.h"
+#include "cpl_conv.h"
+#include "cpl_vsi.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+CPL_CVSID("$Id$")
+
+//! @cond Doxygen_Suppress
+
+/*
+ * Layout of a .ogridx file (all integers are little-endian):
+ *
+ * Header (48 bytes):
+ *   - magic "OGRBTIDX"
+ *   - uint32 version (1)
+ *   - uint32 page size
+ *   - uint64 size of the indexed data file when the index was written
+ *   - uint64 offset of the directory
+ *   - uint64 size of the directory
+ *   - uint64 reserved
+ *
+ * Then, for each indexed field, a bulk loaded B+tree whose leaf pages are
+ * contiguous, followed by the sorted list of the FIDs of null/unset values.
+ * A leaf page is a uint32 entry count followed by (key, int64 FID) entries
+ * sorted by key then FID. An internal page is a uint32 entry count followed
+ * by (key, int64 FID, uint64 child page offset) entries, where the key and
+ * FID are the ones of the first entry of the child subtree.
+ *
+ * Keys are fixed-width and compared with memcmp():
+ *   - integer fields: 8 byte big-endian two's complement with the sign bit
+ *     flipped.
+ *   - real fields: 8 byte big-endian IEEE754 value, with the sign bit
+ *     flipped for positive values and all bits flipped for negative ones.
+ *     NaN values are not indexed.
+ *   - string fields: ASCII lower-cased value (to match the case-insensitive
+ *     comparisons of the OGR SQL engine), zero-padded to the longest value.
+ *
+ * The directory, at the end of the file, lists for each field: name length
+ * (uint32), name, field type (uint32), key size (uint32), tree height
+ * (uint32), entry count, root page offset, first leaf page offset, leaf page
+ * count, null count and null list offset (all uint64).
+ */
+
+constexpr int OGR_BTREE_PAGE_SIZE = 4096;
+constexpr int OGR_BTREE_HEADER_SIZE = 48;
+constexpr int OGR_BTREE_MAX_STRING_KEY_SIZE = 256;
+constexpr int OGR_BTREE_MAX_HEIGHT = 32;
+constexpr GUInt32 OGR_BTREE_VERSION = 1;
+static const char OGR_BTREE_MAGIC[8] = { 'O','G','R','B','T','I','D','X' };
+
+/************************************************************************/
+/*                          Encoding helpers                            */
+/************************************************************************/
+
+static void OGRBTreeWriteUInt32( GByte *pabyDst, GUInt32 nVal )
+{
+    CPL_LSBPTR32(&nVal);
+    memcpy(pabyDst, &nVal, sizeof(nVal));
+}
+
+static void OGRBTreeWriteUInt64( GByte *pabyDst, GUInt64 nVal )
+{
+    CPL_LSBPTR64(&nVal);
+    memcpy(pabyDst, &nVal, sizeof(nVal));
+}
+
+static GUInt32 OGRBTreeReadUInt32( const GByte *pabySrc )
+{
+    GUInt32 nVal;
+    memcpy(&nVal, pabySrc, sizeof(nVal));
+    CPL_LSBPTR32(&nVal);
+    return nVal;
+}
+
+static GUInt64 OGRBTreeReadUInt64( const GByte *pabySrc )
+{
+    GUInt64 nVal;
+    memcpy(&nVal, pabySrc, sizeof(nVal));
+    CPL_LSBPTR64(&nVal);
+    return nVal;
+}
+
+static void OGRBTreeEncodeUInt64BE( GByte *pabyDst, GUInt64 nVal )
+{
+    for( int i = 7; i >= 0; i-- )
+    {
+        pabyDst[i] = static_cast<GByte>(nVal & 0xff);
+        nVal >>= 8;
+    }
+}
+
+static void OGRBTreeEncodeInteger( GByte *pabyDst, GIntBig nVal )
+{
+    OGRBTreeEncodeUInt64BE(pabyDst, static_cast<GUInt64>(nVal) ^
+                                    (static_cast<GUInt64>(1) << 63));
+}
+
+static bool OGRBTreeEncodeReal( GByte *pabyDst, double dfVal )
+{
+    if( std::isnan(dfVal) )
+        return false;
+    if( dfVal == 0.0 )
+        dfVal = 0.0;  // so that -0.0 == 0.0
+    GUInt64 nBits;
+    memcpy(&nBits, &dfVal, sizeof(nBits));
+    if( nBits & (static_cast<GUInt64>(1) << 63) )
+        nBits = ~nBits;
+    else
+        nBits |= (static_cast<GUInt64>(1) << 63);
+    OGRBTreeEncodeUInt64BE(pabyDst, nBits);
+    return true;
+}
+
+static std::string OGRBTreeFoldString( const char *pszVal )
+{
+    std::string osRet(pszVal);
+    for( auto& ch : osRet )
+    {
+        if( ch >= 'A' && ch <= 'Z' )
+            ch = static_cast<char>(ch - 'A' + 'a');
+    }
+    return osRet;
+}
+
+static bool OGRBTreeIsIndexableType( OGRFieldType eType )
+{
+    return eType == OFTInteger || eType == OFTInteger64 ||
+           eType == OFTReal || eType == OFTString;
+}
+
+static GIntBig *OGRBTreeToFIDList( std::vector<GIntBig>& anFIDs,
+                                   int *pnFIDCount )
+{
+    std::sort(anFIDs.begin(), anFIDs.end());
+    GIntBig *panFIDList = static_cast<GIntBig *>(
+        VSI_MALLOC2_VERBOSE(anFIDs.size() + 1, sizeof(GIntBig)));
+    if( panFIDList == nullptr )
+        return nullptr;
+    if( !anFIDs.empty() )
+        memcpy(panFIDList, anFIDs.data(), anFIDs.size() * sizeof(GIntBig));
+    panFIDList[anFIDs.size()] = OGRNullFID;
+    if( pnFIDCount )
+        *pnFIDCount = static_cast<int>(anFIDs.size());
+    return panFIDList;
+}
+
+class OGRBTreeLayerAttrIndex;
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          OGRBTreeAttrIndex                           */
+/*                                                                      */
+/*      Read access to the B+tree of one field.                         */
+/* ==================================================================== */
+/************************************************************************/
+
+class OGRBTreeAttrIndex final: public OGRAttrIndex
+{
+    friend class OGRBTreeLayerAttrIndex;
+
+    OGRBTreeLayerAttrIndex *poParent = nullptr;
+    int           iField = -1;
+    CPLString     osFieldName{};
+    OGRFieldType  eFieldType = OFTString;
+    int           nKeySize = 8;
+    int           nHeight = 0;
+    GUInt64       nEntryCount = 0;
+    GUInt64       nRootOffset = 0;
+    GUInt64       nFirstLeafOffset = 0;
+    GUInt64       nLeafPageCount = 0;
+    GUInt64       nNullCount = 0;
+    GUInt64       nNullOffset = 0;
+
+    std::vector<GByte> abyPage{};
+
+    int           GetLeafCapacity() const
+        { return (OGR_BTREE_PAGE_SIZE - 4) / (nKeySize + 8); }
+    int           GetInternalCapacity() const
+        { return (OGR_BTREE_PAGE_SIZE - 4) / (nKeySize + 16); }
+
+    bool          BuildKey( const OGRField *psKey, GByte *pabyKey ) const;
+    bool          ReadPage( GUInt64 nOffset, int nEntrySize,
+                            int nCapacity, int& nCount );
+    bool          FindFirstLeaf( const GByte *pabyKey, GUInt64& nLeafIdx );
+    bool          Scan( const GByte *pabyMin, bool bMinIncluded,
+                        const GByte *pabyMax, bool bMaxIncluded,
+                        size_t nPrefixLen, std::vector<GIntBig>& anFIDs );
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRBTreeAttrIndex)
+
+public:
+                OGRBTreeAttrIndex() = default;
+
+    GIntBig     GetFirstMatch( OGRField *psKey ) override;
+    GIntBig    *GetAllMatches( OGRField *psKey ) override;
+    GIntBig    *GetAllMatches( OGRField *psKey, GIntBig* panFIDList,
+                               int* nFIDCount, int* nLength ) override;
+
+    OGRErr      AddEntry( OGRField *psKey, GIntBig nFID ) override;
+    OGRErr      RemoveEntry( OGRField *psKey, GIntBig nFID ) override;
+
+    OGRErr      Clear() override;
+
+    bool        SupportsRangeQueries() const override { return true; }
+    GIntBig    *GetRangeMatches( const OGRField *psMin, bool bMinIncluded,
+                                 const OGRField *psMax, bool bMaxIncluded,
+                                 int *pnFIDCount ) override;
+    GIntBig    *GetPrefixMatches( const char *pszPrefix,
+                                  int *pnFIDCount ) override;
+    GIntBig    *GetNullMatches( int *pnFIDCount ) override;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                        OGRBTreeLayerAttrIndex                        */
+/*                                                                      */
+/*      Set of B+tree indexes of a layer, stored in a .ogridx file.     */
+/* ==================================================================== */
+/************************************************************************/
+
+class OGRBTreeLayerAttrIndex final: public OGRLayerAttrIndex
+{
+    friend class OGRBTreeAttrIndex;
+
+    CPLString   osIdxFilename{};
+    VSILFILE   *fpIdx = nullptr;
+    bool        bLoaded = false;
+
+    std::vector<std::unique_ptr<OGRBTreeAttrIndex>> apoIndexList{};
+    std::vector<int> anPendingFields{};
+
+    void        LoadIfNeeded();
+    bool        ReadDirectory();
+    OGRErr      BuildFieldIndex( int iField );
+    OGRErr      WriteDirectory( VSILFILE *fp );
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRBTreeLayerAttrIndex)
+
+public:
+                OGRBTreeLayerAttrIndex() = default;
+    virtual     ~OGRBTreeLayerAttrIndex();
+
+    OGRErr      Initialize( const char *pszIndexPath, OGRLayer * ) override;
+    OGRErr      CreateIndex( int iField ) override;
+    OGRErr      DropIndex( int iField ) override;
+    OGRErr      IndexAllFeatures( int iField = -1 ) override;
+
+    OGRErr      AddToIndex( OGRFeature *poFeature, int iField = -1 ) override;
+    OGRErr      RemoveFromIndex( OGRFeature *poFeature ) override;
+
+    OGRAttrIndex *GetFieldIndex( int iField ) override;
+};
+
+/************************************************************************/
+/*                      ~OGRBTreeLayerAttrIndex()                       */
+/************************************************************************/
+
+OGRBTreeLayerAttrIndex::~OGRBTreeLayerAttrIndex()
+
+{
+    if( fpIdx != nullptr )
+        VSIFCloseL(fpIdx);
+}
+
+/************************************************************************/
+/*                             Initialize()                             */
+/*                                                                      */
+/*      The index file itself is only opened when an index is first     */
+/*      looked up, so that opening a dataset does not cost an extra     */
+/*      file system access.                                             */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::Initialize( const char *pszIndexPathIn,
+                                           OGRLayer *poLayerIn )
+
+{
+    if( poLayerIn == poLayer )
+        return OGRERR_NONE;
+
+    poLayer = poLayerIn;
+    CPLFree(pszIndexPath);
+    pszIndexPath = CPLStrdup(pszIndexPathIn);
+    osIdxFilename = CPLSPrintf("%s.ogridx", pszIndexPathIn);
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                            LoadIfNeeded()                            */
+/************************************************************************/
+
+void OGRBTreeLayerAttrIndex::LoadIfNeeded()
+
+{
+    if( bLoaded )
+        return;
+    bLoaded = true;
+
+    VSIStatBufL sStat;
+    if( VSIStatL(osIdxFilename, &sStat) != 0 )
+        return;
+
+    fpIdx = VSIFOpenL(osIdxFilename, "rb");
+    if( fpIdx == nullptr )
+        return;
+
+    if( !ReadDirectory() )
+    {
+        apoIndexList.clear();
+        VSIFCloseL(fpIdx);
+        fpIdx = nullptr;
+    }
+}
+
+/************************************************************************/
+/*                           ReadDirectory()                            */
+/************************************************************************/
+
+bool OGRBTreeLayerAttrIndex::ReadDirectory()
+
+{
+    GByte abyHeader[OGR_BTREE_HEADER_SIZE];
+    if( VSIFReadL(abyHeader, sizeof(abyHeader), 1, fpIdx) != 1 ||
+        memcmp(abyHeader, OGR_BTREE_MAGIC, sizeof(OGR_BTREE_MAGIC)) != 0 )
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "%s is not a valid attribute index file, ignoring it.",
+                 osIdxFilename.c_str());
+        return false;
+    }
+    if( OGRBTreeReadUInt32(abyHeader + 8) != OGR_BTREE_VERSION ||
+        OGRBTreeReadUInt32(abyHeader + 12) != OGR_BTREE_PAGE_SIZE )
+    {
+        CPLError(CE_Warning, CPLE_NotSupported,
+                 "Unsupported version of attribute index file %s, "
+                 "ignoring it.", osIdxFilename.c_str());
+        return false;
+    }
+
+    // Detect indexes that no longer match the data file.
+    VSIStatBufL sStat;
+    if( VSIStatL(pszIndexPath, &sStat) == 0 &&
+        static_cast<GUInt64>(sStat.st_size) !=
+                                    OGRBTreeReadUInt64(abyHeader + 16) )
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "%s is out of date with respect to %s, ignoring it. "
+                 "Use CREATE INDEX to rebuild it.",
+                 osIdxFilename.c_str(), pszIndexPath);
+        return false;
+    }
+
+    const GUInt64 nDirOffset = OGRBTreeReadUInt64(abyHeader + 24);
+    const GUInt64 nDirSize = OGRBTreeReadUInt64(abyHeader + 32);
+    if( nDirSize > 10 * 1024 * 1024 )
+        return false;
+    std::vector<GByte> abyDir(static_cast<size_t>(nDirSize));
+    if( nDirSize > 0 &&
+        (VSIFSeekL(fpIdx, nDirOffset, SEEK_SET) != 0 ||
+         VSIFReadL(abyDir.data(), abyDir.size(), 1, fpIdx) != 1) )
+    {
+        CPLError(CE_Warning, CPLE_FileIO,
+                 "Cannot read directory of %s, ignoring it.",
+                 osIdxFilename.c_str());
+        return false;
+    }
+
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    size_t nPos = 0;
+    constexpr size_t FIXED_PART_SIZE = 3 * 4 + 7 * 8;
+    while( nPos < abyDir.size() )
+    {
+        if( abyDir.size() - nPos < 4 )
+            return false;
+        const GUInt32 nNameLen = OGRBTreeReadUInt32(&abyDir[nPos]);
+        nPos += 4;
+        if( nNameLen > abyDir.size() - nPos ||
+            abyDir.size() - nPos - nNameLen < FIXED_PART_SIZE )
+            return false;
+
+        std::unique_ptr<OGRBTreeAttrIndex> poIndex(new OGRBTreeAttrIndex());
+        poIndex->poParent = this;
+        poIndex->osFieldName.assign(
+            reinterpret_cast<const char*>(&abyDir[nPos]), nNameLen);
+        nPos += nNameLen;
+        const GByte *pabyFixed = &abyDir[nPos];
+        nPos += FIXED_PART_SIZE;
+
+        const GUInt32 nFieldType = OGRBTreeReadUInt32(pabyFixed);
+        poIndex->nKeySize = static_cast<int>(
+            OGRBTreeReadUInt32(pabyFixed + 4));
+        poIndex->nHeight = static_cast<int>(
+            OGRBTreeReadUInt32(pabyFixed + 8));
+        poIndex->nEntryCount = OGRBTreeReadUInt64(pabyFixed + 12);
+        poIndex->nRootOffset = OGRBTreeReadUInt64(pabyFixed + 20);
+        poIndex->nFirstLeafOffset = OGRBTreeReadUInt64(pabyFixed + 28);
+        poIndex->nLeafPageCount = OGRBTreeReadUInt64(pabyFixed + 36);
+        poIndex->nNullCount = OGRBTreeReadUInt64(pabyFixed + 44);
+        poIndex->nNullOffset = OGRBTreeReadUInt64(pabyFixed + 52);
+
+        if( nFieldType > OFTMaxType ||
+            !OGRBTreeIsIndexableType(static_cast<OGRFieldType>(nFieldType)) ||
+            poIndex->nKeySize <= 0 ||
+            poIndex->nKeySize > OGR_BTREE_MAX_STRING_KEY_SIZE ||
+            poIndex->nHeight < 0 || poIndex->nHeight > OGR_BTREE_MAX_HEIGHT ||
+            poIndex->nNullCount > static_cast<GUInt64>(INT_MAX) ||
+            poIndex->nEntryCount > static_cast<GUInt64>(INT_MAX) )
+        {
+            CPLError(CE_Warning, CPLE_AppDefined,
+                     "Corrupted directory in %s, ignoring it.",
+                     osIdxFilename.c_str());
+            return false;
+        }
+        poIndex->eFieldType = static_cast<OGRFieldType>(nFieldType);
+
+        // An index on a field that has been removed or whose type has
+        // changed is just ignored.
+        poIndex->iField = poDefn->GetFieldIndex(poIndex->osFieldName);
+        if( poIndex->iField < 0 ||
+            poDefn->GetFieldDefn(poIndex->iField)->GetType() !=
+                                                    poIndex->eFieldType )
+        {
+            CPLDebug("OGR", "Ignoring index on field %s of %s",
+                     poIndex->osFieldName.c_str(), osIdxFilename.c_str());
+            continue;
+        }
+        apoIndexList.push_back(std::move(poIndex));
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                           GetFieldIndex()                            */
+/************************************************************************/
+
+OGRAttrIndex *OGRBTreeLayerAttrIndex::GetFieldIndex( int iField )
+
+{
+    LoadIfNeeded();
+
+    for( const auto& poIndex: apoIndexList )
+    {
+        if( poIndex->iField == iField )
+            return poIndex.get();
+    }
+
+    return nullptr;
+}
+
+/************************************************************************/
+/*                            CreateIndex()                             */
+/*                                                                      */
+/*      Check that the field can be indexed. The index is actually      */
+/*      written by IndexAllFeatures().                                  */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::CreateIndex( int iField )
+
+{
+    LoadIfNeeded();
+
+    OGRFeatureDefn *poDefn = poLayer->GetLayerDefn();
+    if( iField < 0 || iField >= poDefn->GetFieldCount() )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Invalid field index: %d",
+                 iField);
+        return OGRERR_FAILURE;
+    }
+
+    OGRFieldDefn *poFldDefn = poDefn->GetFieldDefn(iField);
+    if( GetFieldIndex(iField) != nullptr ||
+        std::find(anPendingFields.begin(), anPendingFields.end(), iField) !=
+                                                    anPendingFields.end() )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "It seems we already have an index for field %d/%s\n"
+                 "of layer %s.",
+                 iField, poFldDefn->GetNameRef(),
+                 poDefn->GetName());
+        return OGRERR_FAILURE;
+    }
+
+    if( !OGRBTreeIsIndexableType(poFldDefn->GetType()) )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Indexing not support for the field type of field %s.",
+                 poFldDefn->GetNameRef());
+        return OGRERR_FAILURE;
+    }
+
+    anPendingFields.push_back(iField);
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          IndexAllFeatures()                          */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::IndexAllFeatures( int iField )
+
+{
+    LoadIfNeeded();
+
+    std::vector<int> anFields;
+    if( iField < 0 )
+    {
+        for( const auto& poIndex: apoIndexList )
+            anFields.push_back(poIndex->iField);
+        anFields.insert(anFields.end(),
+                        anPendingFields.begin(), anPendingFields.end());
+    }
+    else
+    {
+        if( GetFieldIndex(iField) == nullptr &&
+            std::find(anPendingFields.begin(), anPendingFields.end(),
+                      iField) == anPendingFields.end() )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "No index created on field %d", iField);
+            return OGRERR_FAILURE;
+        }
+        anFields.push_back(iField);
+    }
+
+    for( const int i: anFields )
+    {
+        const OGRErr eErr = BuildFieldIndex(i);
+        anPendingFields.erase(
+            std::remove(anPendingFields.begin(), anPendingFields.end(), i),
+            anPendingFields.end());
+        if( eErr != OGRERR_NONE )
+            return eErr;
+    }
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          BuildFieldIndex()                           */
+/*                                                                      */
+/*      Read all features of the layer, and append a bulk loaded        */
+/*      B+tree for the field to the index file, followed by an          */
+/*      updated directory.                                              */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::BuildFieldIndex( int iField )
+
+{
+    OGRFieldDefn *poFldDefn = poLayer->GetLayerDefn()->GetFieldDefn(iField);
+    const OGRFieldType eType = poFldDefn->GetType();
+
+/* -------------------------------------------------------------------- */
+/*      Collect (key, FID) pairs, with filters temporarily unset so     */
+/*      that all features are indexed.                                  */
+/* -------------------------------------------------------------------- */
+    const CPLString osAttrFilter(poLayer->GetAttrQueryString() ?
+                                    poLayer->GetAttrQueryString() : "");
+    std::unique_ptr<OGRGeometry> poSpatialFilter(
+        poLayer->GetSpatialFilter() ? poLayer->GetSpatialFilter()->clone() :
+                                      nullptr);
+    const int iGeomFieldFilter = poLayer->GetGeomFieldFilter();
+    if( !osAttrFilter.empty() )
+        poLayer->SetAttributeFilter(nullptr);
+    if( poSpatialFilter )
+        poLayer->SetSpatialFilter(nullptr);
+
+    std::vector<std::pair<std::string, GIntBig>> aoEntries;
+    std::vector<GIntBig> anNullFIDs;
+    size_t nMaxStringLen = 1;
+    bool bError = false;
+
+    poLayer->ResetReading();
+    OGRFeature *poFeature = nullptr;
+    while( !bError && (poFeature = poLayer->GetNextFeature()) != nullptr )
+    {
+        const GIntBig nFID = poFeature->GetFID();
+        if( !poFeature->IsFieldSetAndNotNull(iField) )
+        {
+            anNullFIDs.push_back(nFID);
+        }
+        else if( eType == OFTString )
+        {
+            std::string osKey(
+                OGRBTreeFoldString(poFeature->GetFieldAsString(iField)));
+            if( osKey.size() > OGR_BTREE_MAX_STRING_KEY_SIZE )
+            {
+                CPLError(CE_Failure, CPLE_NotSupported,
+                         "Value of field %s for feature " CPL_FRMT_GIB
+                         " is longer than %d bytes, which is not supported "
+                         "by attribute indexes.",
+                         poFldDefn->GetNameRef(), nFID,
+                         OGR_BTREE_MAX_STRING_KEY_SIZE);
+                bError = true;
+            }
+            else
+            {
+                nMaxStringLen = std::max(nMaxStringLen, osKey.size());
+                aoEntries.emplace_back(std::move(osKey), nFID);
+            }
+        }
+        else
+        {
+            GByte abyKey[8];
+            bool bIndexable = true;
+            if( eType == OFTReal )
+                bIndexable = OGRBTreeEncodeReal(
+                    abyKey, poFeature->GetFieldAsDouble(iField));
+            else
+                OGRBTreeEncodeInteger(
+                    abyKey, poFeature->GetFieldAsInteger64(iField));
+            if( bIndexable )
+                aoEntries.emplace_back(
+                    std::string(reinterpret_cast<char*>(abyKey), 8), nFID);
+        }
+        delete poFeature;
+    }
+    poLayer->ResetReading();
+
+    if( !osAttrFilter.empty() )
+        poLayer->SetAttributeFilter(osAttrFilter);
+    if( poSpatialFilter )
+        poLayer->SetSpatialFilter(iGeomFieldFilter, poSpatialFilter.get());
+
+    if( bError )
+        return OGRERR_FAILURE;
+    if( aoEntries.size() > static_cast<size_t>(INT_MAX) ||
+        anNullFIDs.size() > static_cast<size_t>(INT_MAX) )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Too many features to index");
+        return OGRERR_FAILURE;
+    }
+
+    // Strings are zero-padded, so that ordering them as std::string
+    // (which compares as unsigned char) is the same as comparing the
+    // padded keys with memcmp().
+    std::sort(aoEntries.begin(), aoEntries.end());
+    std::sort(anNullFIDs.begin(), anNullFIDs.end());
+
+    std::unique_ptr<OGRBTreeAttrIndex> poIndex(new OGRBTreeAttrIndex());
+    poIndex->poParent = this;
+    poIndex->iField = iField;
+    poIndex->osFieldName = poFldDefn->GetNameRef();
+    poIndex->eFieldType = eType;
+    poIndex->nKeySize =
+        eType == OFTString ? static_cast<int>(nMaxStringLen) : 8;
+    poIndex->nEntryCount = aoEntries.size();
+    poIndex->nNullCount = anNullFIDs.size();
+    const int nKeySize = poIndex->nKeySize;
+
+/* -------------------------------------------------------------------- */
+/*      Open the index file for appending, or create it.                */
+/* -------------------------------------------------------------------- */
+    if( fpIdx != nullptr )
+    {
+        VSIFCloseL(fpIdx);
+        fpIdx = nullptr;
+    }
+
+    VSILFILE *fp = nullptr;
+    if( !apoIndexList.empty() )
+        fp = VSIFOpenL(osIdxFilename, "rb+");
+    if( fp == nullptr )
+    {
+        apoIndexList.clear();
+        fp = VSIFOpenL(osIdxFilename, "wb+");
+        if( fp == nullptr )
+        {
+            CPLError(CE_Failure, CPLE_OpenFailed,
+                     "Failed to create %s.", osIdxFilename.c_str());
+            return OGRERR_FAILURE;
+        }
+        GByte abyHeader[OGR_BTREE_HEADER_SIZE] = {};
+        memcpy(abyHeader, OGR_BTREE_MAGIC, sizeof(OGR_BTREE_MAGIC));
+        OGRBTreeWriteUInt32(abyHeader + 8, OGR_BTREE_VERSION);
+        OGRBTreeWriteUInt32(abyHeader + 12, OGR_BTREE_PAGE_SIZE);
+        if( VSIFWriteL(abyHeader, sizeof(abyHeader), 1, fp) != 1 )
+        {
+            VSIFCloseL(fp);
+            return OGRERR_FAILURE;
+        }
+    }
+
+    VSIFSeekL(fp, 0, SEEK_END);
+    bool bOK = true;
+    std::vector<GByte> abyPage(OGR_BTREE_PAGE_SIZE);
+
+/* -------------------------------------------------------------------- */
+/*      Write leaf pages, and remember the first entry of each of       */
+/*      them to build the upper levels.                                 */
+/* -------------------------------------------------------------------- */
+    struct NodeRef
+    {
+        const std::string *posKey;
+        GIntBig            nFID;
+        GUInt64            nOffset;
+    };
+    std::vector<NodeRef> aoLevel;
+
+    poIndex->nFirstLeafOffset = VSIFTellL(fp);
+    const size_t nLeafCapacity = poIndex->GetLeafCapacity();
+    for( size_t iStart = 0; bOK && iStart < aoEntries.size();
+         iStart += nLeafCapacity )
+    {
+        const size_t nCount =
+            std::min(nLeafCapacity, aoEntries.size() - iStart);
+        std::fill(abyPage.begin(), abyPage.end(), static_cast<GByte>(0));
+        OGRBTreeWriteUInt32(&abyPage[0], static_cast<GUInt32>(nCount));
+        GByte *pabyEntry = &abyPage[4];
+        for( size_t i = iStart; i < iStart + nCount; i++ )
+        {
+            memcpy(pabyEntry, aoEntries[i].first.data(),
+                   aoEntries[i].first.size());
+            OGRBTreeWriteUInt64(pabyEntry + nKeySize,
+                                static_cast<GUInt64>(aoEntries[i].second));
+            pabyEntry += nKeySize + 8;
+        }
+        NodeRef oRef;
+        oRef.posKey = &aoEntries[iStart].first;
+        oRef.nFID = aoEntries[iStart].second;
+        oRef.nOffset = VSIFTellL(fp);
+        aoLevel.push_back(oRef);
+        bOK = VSIFWriteL(abyPage.data(), abyPage.size(), 1, fp) == 1;
+    }
+    poIndex->nLeafPageCount = aoLevel.size();
+
+/* -------------------------------------------------------------------- */
+/*      Write internal levels until there is a single root.             */
+/* -------------------------------------------------------------------- */
+    const size_t nInternalCapacity = poIndex->GetInternalCapacity();
+    while( bOK && aoLevel.size() > 1 )
+    {
+        std::vector<NodeRef> aoUpperLevel;
+        for( size_t iStart = 0; bOK && iStart < aoLevel.size();
+             iStart += nInternalCapacity )
+        {
+            const size_t nCount =
+                std::min(nInternalCapacity, aoLevel.size() - iStart);
+            std::fill(abyPage.begin(), abyPage.end(), static_cast<GByte>(0));
+            OGRBTreeWriteUInt32(&abyPage[0], static_cast<GUInt32>(nCount));
+            GByte *pabyEntry = &abyPage[4];
+            for( size_t i = iStart; i < iStart + nCount; i++ )
+            {
+                memcpy(pabyEntry, aoLevel[i].posKey->data(),
+                       aoLevel[i].posKey->size());
+                OGRBTreeWriteUInt64(pabyEntry + nKeySize,
+                                    static_cast<GUInt64>(aoLevel[i].nFID));
+                OGRBTreeWriteUInt64(pabyEntry + nKeySize + 8,
+                                    aoLevel[i].nOffset);
+                pabyEntry += nKeySize + 16;
+            }
+            NodeRef oRef = aoLevel[iStart];
+            oRef.nOffset = VSIFTellL(fp);
+            aoUpperLevel.push_back(oRef);
+            bOK = VSIFWriteL(abyPage.data(), abyPage.size(), 1, fp) == 1;
+        }
+        aoLevel = std::move(aoUpperLevel);
+        poIndex->nHeight++;
+    }
+    poIndex->nRootOffset = aoLevel.empty() ? 0 : aoLevel[0].nOffset;
+
+/* -------------------------------------------------------------------- */
+/*      Write the FIDs of null values.                                  */
+/* -------------------------------------------------------------------- */
+    poIndex->nNullOffset = VSIFTellL(fp);
+    for( size_t i = 0; bOK && i < anNullFIDs.size(); i++ )
+    {
+        GByte abyFID[8];
+        OGRBTreeWriteUInt64(abyFID, static_cast<GUInt64>(anNullFIDs[i]));
+        bOK = VSIFWriteL(abyFID, sizeof(abyFID), 1, fp) == 1;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Replace any previous index of this field in the directory.      */
+/* -------------------------------------------------------------------- */
+    if( bOK )
+    {
+        apoIndexList.erase(
+            std::remove_if(apoIndexList.begin(), apoIndexList.end(),
+                [iField](const std::unique_ptr<OGRBTreeAttrIndex>& poOther)
+                { return poOther->iField == iField; }),
+            apoIndexList.end());
+        apoIndexList.push_back(std::move(poIndex));
+        bOK = WriteDirectory(fp) == OGRERR_NONE;
+    }
+
+    if( VSIFCloseL(fp) != 0 )
+        bOK = false;
+    if( !bOK )
+    {
+        CPLError(CE_Failure, CPLE_FileIO,
+                 "Failure while writing %s.", osIdxFilename.c_str());
+        apoIndexList.clear();
+        VSIUnlink(osIdxFilename);
+        return OGRERR_FAILURE;
+    }
+
+    fpIdx = VSIFOpenL(osIdxFilename, "rb");
+    return fpIdx != nullptr ? OGRERR_NONE : OGRERR_FAILURE;
+}
+
+/************************************************************************/
+/*                           WriteDirectory()                           */
+/*                                                                      */
+/*      Append the directory at the end of the file and update the      */
+/*      header to point to it.                                          */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::WriteDirectory( VSILFILE *fp )
+
+{
+    std::vector<GByte> abyDir;
+    for( const auto& poIndex: apoIndexList )
+    {
+        const size_t nPos = abyDir.size();
+        const size_t nNameLen = poIndex->osFieldName.size();
+        abyDir.resize(nPos + 4 + nNameLen + 3 * 4 + 7 * 8);
+        GByte *pabyEntry = &abyDir[nPos];
+        OGRBTreeWriteUInt32(pabyEntry, static_cast<GUInt32>(nNameLen));
+        memcpy(pabyEntry + 4, poIndex->osFieldName.data(), nNameLen);
+        pabyEntry += 4 + nNameLen;
+        OGRBTreeWriteUInt32(pabyEntry, poIndex->eFieldType);
+        OGRBTreeWriteUInt32(pabyEntry + 4, poIndex->nKeySize);
+        OGRBTreeWriteUInt32(pabyEntry + 8, poIndex->nHeight);
+        OGRBTreeWriteUInt64(pabyEntry + 12, poIndex->nEntryCount);
+        OGRBTreeWriteUInt64(pabyEntry + 20, poIndex->nRootOffset);
+        OGRBTreeWriteUInt64(pabyEntry + 28, poIndex->nFirstLeafOffset);
+        OGRBTreeWriteUInt64(pabyEntry + 36, poIndex->nLeafPageCount);
+        OGRBTreeWriteUInt64(pabyEntry + 44, poIndex->nNullCount);
+        OGRBTreeWriteUInt64(pabyEntry + 52, poIndex->nNullOffset);
+    }
+
+    VSIFSeekL(fp, 0, SEEK_END);
+    const GUInt64 nDirOffset = VSIFTellL(fp);
+    if( !abyDir.empty() &&
+        VSIFWriteL(abyDir.data(), abyDir.size(), 1, fp) != 1 )
+        return OGRERR_FAILURE;
+
+    VSIStatBufL sStat;
+    const GUInt64 nSourceSize = VSIStatL(pszIndexPath, &sStat) == 0 ?
+                                static_cast<GUInt64>(sStat.st_size) : 0;
+    GByte abyHeaderEnd[24];
+    OGRBTreeWriteUInt64(abyHeaderEnd, nSourceSize);
+    OGRBTreeWriteUInt64(abyHeaderEnd + 8, nDirOffset);
+    OGRBTreeWriteUInt64(abyHeaderEnd + 16, abyDir.size());
+    if( VSIFSeekL(fp, 16, SEEK_SET) != 0 ||
+        VSIFWriteL(abyHeaderEnd, sizeof(abyHeaderEnd), 1, fp) != 1 )
+        return OGRERR_FAILURE;
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             DropIndex()                              */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::DropIndex( int iField )
+
+{
+    LoadIfNeeded();
+
+    anPendingFields.erase(
+        std::remove(anPendingFields.begin(), anPendingFields.end(), iField),
+        anPendingFields.end());
+
+    const auto oIter = std::find_if(apoIndexList.begin(), apoIndexList.end(),
+        [iField](const std::unique_ptr<OGRBTreeAttrIndex>& poIndex)
+        { return poIndex->iField == iField; });
+    if( oIter == apoIndexList.end() )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "DROP INDEX on field (%d) that doesn't have an index.",
+                 iField);
+        return OGRERR_FAILURE;
+    }
+    apoIndexList.erase(oIter);
+
+    if( fpIdx != nullptr )
+    {
+        VSIFCloseL(fpIdx);
+        fpIdx = nullptr;
+    }
+
+    // Space used by the dropped tree is only reclaimed when the last
+    // index is dropped.
+    if( apoIndexList.empty() )
+    {
+        VSIUnlink(osIdxFilename);
+        return OGRERR_NONE;
+    }
+
+    VSILFILE *fp = VSIFOpenL(osIdxFilename, "rb+");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_OpenFailed,
+                 "Failed to open %s for update.", osIdxFilename.c_str());
+        apoIndexList.clear();
+        return OGRERR_FAILURE;
+    }
+    OGRErr eErr = WriteDirectory(fp);
+    if( VSIFCloseL(fp) != 0 )
+        eErr = OGRERR_FAILURE;
+
+    fpIdx = VSIFOpenL(osIdxFilename, "rb");
+    if( fpIdx == nullptr )
+        apoIndexList.clear();
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                             AddToIndex()                             */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::AddToIndex( OGRFeature * /* poFeature */,
+                                           int /* iField */ )
+
+{
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "B-tree attribute indexes cannot be updated incrementally. "
+             "Use CREATE INDEX to rebuild them.");
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                          RemoveFromIndex()                           */
+/************************************************************************/
+
+OGRErr OGRBTreeLayerAttrIndex::RemoveFromIndex( OGRFeature * /* poFeature */ )
+
+{
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "B-tree attribute indexes cannot be updated incrementally. "
+             "Use CREATE INDEX to rebuild them.");
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          OGRBTreeAttrIndex                           */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                              BuildKey()                              */
+/*                                                                      */
+/*      Returns false if the value cannot be represented in this        */
+/*      index, in which case no indexed value can match it.             */
+/************************************************************************/
+
+bool OGRBTreeAttrIndex::BuildKey( const OGRField *psKey,
+                                  GByte *pabyKey ) const
+
+{
+    switch( eFieldType )
+    {
+      case OFTInteger:
+        OGRBTreeEncodeInteger(pabyKey, psKey->Integer);
+        return true;
+
+      case OFTInteger64:
+        OGRBTreeEncodeInteger(pabyKey, psKey->Integer64);
+        return true;
+
+      case OFTReal:
+        return OGRBTreeEncodeReal(pabyKey, psKey->Real);
+
+      case OFTString:
+      {
+        if( psKey->String == nullptr )
+            return false;
+        const std::string osKey(OGRBTreeFoldString(psKey->String));
+        if( osKey.size() > static_cast<size_t>(nKeySize) )
+            return false;
+        memset(pabyKey, 0, nKeySize);
+        memcpy(pabyKey, osKey.data(), osKey.size());
+        return true;
+      }
+
+      default:
+        break;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                              ReadPage()                              */
+/************************************************************************/
+
+bool OGRBTreeAttrIndex::ReadPage( GUInt64 nOffset, int nEntrySize,
+                                  int nCapacity, int& nCount )
+
+{
+    VSILFILE *fp = poParent->fpIdx;
+    abyPage.resize(OGR_BTREE_PAGE_SIZE);
+    if( fp == nullptr ||
+        VSIFSeekL(fp, nOffset, SEEK_SET) != 0 ||
+        VSIFReadL(abyPage.data(), abyPage.size(), 1, fp) != 1 )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot read page of %s",
+                 poParent->osIdxFilename.c_str());
+        return false;
+    }
+    const GUInt32 nPageCount = OGRBTreeReadUInt32(&abyPage[0]);
+    if( nPageCount == 0 || nPageCount > static_cast<GUInt32>(nCapacity) ||
+        4 + static_cast<size_t>(nPageCount) * nEntrySize > abyPage.size() )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Corrupted page in %s",
+                 poParent->osIdxFilename.c_str());
+        return false;
+    }
+    nCount = static_cast<int>(nPageCount);
+    return true;
+}
+
+/************************************************************************/
+/*                           FindFirstLeaf()                            */
+/*                                                                      */
+/*      Descend the tree to the leftmost leaf that may contain          */
+/*      entries greater or equal to the key.                            */
+/************************************************************************/
+
+bool OGRBTreeAttrIndex::FindFirstLeaf( const GByte *pabyKey,
+                                       GUInt64& nLeafIdx )
+
+{
+    GUInt64 nOffset = nRootOffset;
+    for( int iLevel = nHeight; iLevel > 0; iLevel-- )
+    {
+        const int nEntrySize = nKeySize + 16;
+        int nCount = 0;
+        if( !ReadPage(nOffset, nEntrySize, GetInternalCapacity(), nCount) )
+            return false;
+
+        // Last child whose first key is strictly lower than the searched
+        // key, as entries equal to the key may span several children.
+        int iChild = 0;
+        for( int i = 1; i < nCount; i++ )
+        {
+            if( memcmp(&abyPage[4 + i * nEntrySize], pabyKey, nKeySize) < 0 )
+                iChild = i;
+            else
+                break;
+        }
+        nOffset = OGRBTreeReadUInt64(
+                    &abyPage[4 + iChild * nEntrySize + nKeySize + 8]);
+    }
+
+    if( nOffset < nFirstLeafOffset ||
+        (nOffset - nFirstLeafOffset) % OGR_BTREE_PAGE_SIZE != 0 )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "Corrupted tree in %s",
+                 poParent->osIdxFilename.c_str());
+        return false;
+    }
+    nLeafIdx = (nOffset - nFirstLeafOffset) / OGR_BTREE_PAGE_SIZE;
+    return true;
+}
+
+/************************************************************************/
+/*                                Scan()                                */
+/*                                                                      */
+/*      Collect FIDs of entries between pabyMin and pabyMax (either     */
+/*      can be nullptr for an open bound). If nPrefixLen is not zero,   */
+/*      stop at the first entry not starting with the nPrefixLen        */
+/*      first bytes of pabyMin.                                         */
+/************************************************************************/
+
+bool OGRBTreeAttrIndex::Scan( const GByte *pabyMin, bool bMinIncluded,
+                              const GByte *pabyMax, bool bMaxIncluded,
+                              size_t nPrefixLen,
+                              std::vector<GIntBig>& anFIDs )
+
+{
+    if( nLeafPageCount == 0 )
+        return true;
+
+    GUInt64 nLeafIdx = 0;
+    if( pabyMin != nullptr && !FindFirstLeaf(pabyMin, nLeafIdx) )
+        return false;
+
+    const int nEntrySize = nKeySize + 8;
+    for( ; nLeafIdx < nLeafPageCount; nLeafIdx++ )
+    {
+        int nCount = 0;
+        if( !ReadPage(nFirstLeafOffset + nLeafIdx * OGR_BTREE_PAGE_SIZE,
+                      nEntrySize, GetLeafCapacity(), nCount) )
+            return false;
+
+        for( int i = 0; i < nCount; i++ )
+        {
+            const GByte *pabyEntry = &abyPage[4 + i * nEntrySize];
+            if( pabyMin != nullptr )
+            {
+                const int nCmp = memcmp(pabyEntry, pabyMin, nKeySize);
+                if( nCmp < 0 || (nCmp == 0 && !bMinIncluded) )
+                    continue;
+            }
+            if( nPrefixLen > 0 &&
+                memcmp(pabyEntry, pabyMin, nPrefixLen) != 0 )
+                return true;
+            if( pabyMax != nullptr )
+            {
+                const int nCmp = memcmp(pabyEntry, pabyMax, nKeySize);
+                if( nCmp > 0 || (nCmp == 0 && !bMaxIncluded) )
+                    return true;
+            }
+            anFIDs.push_back(static_cast<GIntBig>(
+                OGRBTreeReadUInt64(pabyEntry + nKeySize)));
+        }
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                           GetFirstMatch()                            */
+/************************************************************************/
+
+GIntBig OGRBTreeAttrIndex::GetFirstMatch( OGRField *psKey )
+
+{
+    int nFIDCount = 0;
+    GIntBig *panFIDs = GetRangeMatches(psKey, true, psKey, true, &nFIDCount);
+    const GIntBig nFID = panFIDs ? panFIDs[0] : OGRNullFID;
+    CPLFree(panFIDs);
+    return nFID;
+}
+
+/************************************************************************/
+/*                           GetAllMatches()                            */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetAllMatches( OGRField *psKey,
+                                           GIntBig* panFIDList,
+                                           int* nFIDCount, int* nLength )
+
+{
+    if( panFIDList == nullptr )
+    {
+        panFIDList = static_cast<GIntBig *>(CPLMalloc(sizeof(GIntBig) * 2));
+        *nFIDCount = 0;
+        *nLength = 2;
+    }
+
+    std::vector<GByte> abyKey(nKeySize);
+    std::vector<GIntBig> anFIDs;
+    if( BuildKey(psKey, abyKey.data()) )
+        Scan(abyKey.data(), true, abyKey.data(), true, 0, anFIDs);
+
+    for( const GIntBig nFID: anFIDs )
+    {
+        if( *nFIDCount >= *nLength-1 )
+        {
+            *nLength = (*nLength) * 2 + 10;
+            panFIDList = static_cast<GIntBig *>(
+                CPLRealloc(panFIDList, sizeof(GIntBig)* (*nLength)));
+        }
+        panFIDList[(*nFIDCount)++] = nFID;
+    }
+
+    panFIDList[*nFIDCount] = OGRNullFID;
+
+    return panFIDList;
+}
+
+GIntBig *OGRBTreeAttrIndex::GetAllMatches( OGRField *psKey )
+
+{
+    int nFIDCount, nLength;
+    return GetAllMatches( psKey, nullptr, &nFIDCount, &nLength );
+}
+
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetRangeMatches( const OGRField *psMin,
+                                             bool bMinIncluded,
+                                             const OGRField *psMax,
+                                             bool bMaxIncluded,
+                                             int *pnFIDCount )
+
+{
+    std::vector<GByte> abyMin(nKeySize);
+    std::vector<GByte> abyMax(nKeySize);
+    std::vector<GIntBig> anFIDs;
+
+    const GByte *pabyMin = nullptr;
+    const GByte *pabyMax = nullptr;
+    if( psMin != nullptr )
+    {
+        if( !BuildKey(psMin, abyMin.data()) )
+        {
+            // A string bound longer than any indexed value can still be
+            // used as a lower bound by truncating it, provided it is
+            // excluded.
+            if( eFieldType != OFTString )
+                return nullptr;
+            const std::string osKey(OGRBTreeFoldString(psMin->String));
+            memcpy(abyMin.data(), osKey.data(), nKeySize);
+            bMinIncluded = false;
+        }
+        pabyMin = abyMin.data();
+    }
+    if( psMax != nullptr )
+    {
+        if( !BuildKey(psMax, abyMax.data()) )
+        {
+            if( eFieldType != OFTString )
+                return nullptr;
+            const std::string osKey(OGRBTreeFoldString(psMax->String));
+            memcpy(abyMax.data(), osKey.data(), nKeySize);
+            bMaxIncluded = true;
+        }
+        pabyMax = abyMax.data();
+    }
+
+    if( !Scan(pabyMin, bMinIncluded, pabyMax, bMaxIncluded, 0, anFIDs) )
+        return nullptr;
+
+    return OGRBTreeToFIDList(anFIDs, pnFIDCount);
+}
+
+/************************************************************************/
+/*                          GetPrefixMatches()                          */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetPrefixMatches( const char *pszPrefix,
+                                              int *pnFIDCount )
+
+{
+    if( eFieldType != OFTString )
+        return nullptr;
+
+    std::vector<GIntBig> anFIDs;
+    const std::string osPrefix(OGRBTreeFoldString(pszPrefix));
+    if( osPrefix.size() <= static_cast<size_t>(nKeySize) )
+    {
+        std::vector<GByte> abyMin(nKeySize);
+        memcpy(abyMin.data(), osPrefix.data(), osPrefix.size());
+        if( osPrefix.empty() )
+        {
+            if( !Scan(nullptr, true, nullptr, true, 0, anFIDs) )
+                return nullptr;
+        }
+        else if( !Scan(abyMin.data(), true, nullptr, true,
+                       osPrefix.size(), anFIDs) )
+        {
+            return nullptr;
+        }
+    }
+
+    return OGRBTreeToFIDList(anFIDs, pnFIDCount);
+}
+
+/************************************************************************/
+/*                           GetNullMatches()                           */
+/************************************************************************/
+
+GIntBig *OGRBTreeAttrIndex::GetNullMatches( int *pnFIDCount )
+
+{
+    std::vector<GIntBig> anFIDs;
+    if( nNullCount > 0 )
+    {
+        std::vector<GByte> abyFIDs;
+        try
+        {
+            abyFIDs.resize(static_cast<size_t>(nNullCount) * 8);
+        }
+        catch( const std::bad_alloc& )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate list of null FIDs");
+            return nullptr;
+        }
+        VSILFILE *fp = poParent->fpIdx;
+        if( fp == nullptr ||
+            VSIFSeekL(fp, nNullOffset, SEEK_SET) != 0 ||
+            VSIFReadL(abyFIDs.data(), abyFIDs.size(), 1, fp) != 1 )
+        {
+            CPLError(CE_Failure, CPLE_FileIO, "Cannot read null FIDs of %s",
+                     poParent->osIdxFilename.c_str());
+            return nullptr;
+        }
+        anFIDs.resize(static_cast<size_t>(nNullCount));
+        for( size_t i = 0; i < anFIDs.size(); i++ )
+            anFIDs[i] = static_cast<GIntBig>(
+                OGRBTreeReadUInt64(&abyFIDs[i * 8]));
+    }
+
+    return OGRBTreeToFIDList(anFIDs, pnFIDCount);
+}
+
+/************************************************************************/
+/*                              AddEntry()                              */
+/************************************************************************/
+
+OGRErr OGRBTreeAttrIndex::AddEntry( OGRField * /* psKey */,
+                                    GIntBig /* nFID */ )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                            RemoveEntry()                             */
+/************************************************************************/
+
+OGRErr OGRBTreeAttrIndex::RemoveEntry( OGRField * /* psKey */,
+                                       GIntBig /* nFID */ )
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                               Clear()                                */
+/************************************************************************/
+
+OGRErr OGRBTreeAttrIndex::Clear()
+
+{
+    return OGRERR_UNSUPPORTED_OPERATION;
+}
+
+/************************************************************************/
+/*                      OGRCreateBTreeLayerIndex()                      */
+/************************************************************************/
+
+OGRLayerAttrIndex *OGRCreateBTreeLayerIndex()
+
+{
+    return new OGRBTreeLayerAttrIndex();
+}
+
+//! @endcond
@@ -33,6 +33,7 @@
 #include "cpl_string.h"
 #include "ogr_api.h"
 #include "cpl_time.h"
+#include "gdal_perf_counters.h"
 #include <algorithm>
 #include <vector>
 
@@ -1269,6 +1270,211 @@ static CPLString GetFilterForJoin(swq_expr_node* poExpr, OGRFeature* poSrcFeat,
     return "";
 }
 
+/************************************************************************/
+/*                        PrepareJoinHashTables()                       */
+/*                                                                      */
+/*      For joins on a simple equality between a field of the primary   */
+/*      table and a field of the secondary table, load the secondary    */
+/*      table in memory, indexed by its key value, instead of querying  */
+/*      it with an attribute filter for each primary feature. This is   */
+/*      only done when the secondary tables fit in the memory budget    */
+/*      set by OGR_GENSQL_JOIN_MAX_MEMORY (in MB, defaults to 10% of    */
+/*      the usable RAM). Otherwise the per-feature queries are used.    */
+/************************************************************************/
+
+void OGRGenSQLResultsLayer::PrepareJoinHashTables()
+
+{
+    if( m_bJoinHashTablesPrepared )
+        return;
+    m_bJoinHashTablesPrepared = true;
+
+    swq_select *psSelectInfo = static_cast<swq_select*>(pSelectInfo);
+    m_aoJoinHashTables.resize(psSelectInfo->join_count);
+
+    const char* pszMaxMemory =
+        CPLGetConfigOption("OGR_GENSQL_JOIN_MAX_MEMORY", nullptr);
+    GIntBig nRemainingMemory = pszMaxMemory ?
+        CPLAtoGIntBig(pszMaxMemory) * 1024 * 1024 :
+        CPLGetUsablePhysicalRAM() / 10;
+
+    for( int iJoin = 0; iJoin < psSelectInfo->join_count; iJoin++ )
+    {
+        if( nRemainingMemory <= 0 )
+            break;
+        if( !BuildJoinHashTable(iJoin, nRemainingMemory) )
+        {
+            JoinHashTable& oTable = m_aoJoinHashTables[iJoin];
+            oTable.bUsable = false;
+            oTable.apoFeatures.clear();
+            oTable.oMapInt.clear();
+            oTable.oMapString.clear();
+        }
+    }
+}
+
+/************************************************************************/
+/*                         BuildJoinHashTable()                         */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::BuildJoinHashTable( int iJoin,
+                                                GIntBig& nRemainingMemory )
+
+{
+    swq_select *psSelectInfo = static_cast<swq_select*>(pSelectInfo);
+    swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
+    OGRLayer *poJoinLayer = papoTableLayers[psJoinInfo->secondary_table];
+
+    // Reading the whole secondary layer would disturb the reading of the
+    // primary one if they are the same object.
+    if( poJoinLayer == poSrcLayer )
+        return false;
+
+    const swq_expr_node* poExpr = psJoinInfo->poExpr;
+    if( poExpr->eNodeType != SNT_OPERATION ||
+        poExpr->nOperation != SWQ_EQ ||
+        poExpr->nSubExprCount != 2 ||
+        poExpr->papoSubExpr[0]->eNodeType != SNT_COLUMN ||
+        poExpr->papoSubExpr[1]->eNodeType != SNT_COLUMN )
+        return false;
+
+    const swq_expr_node* poPrimaryColumn = poExpr->papoSubExpr[0];
+    const swq_expr_node* poSecondaryColumn = poExpr->papoSubExpr[1];
+    if( poPrimaryColumn->table_index != 0 )
+        std::swap(poPrimaryColumn, poSecondaryColumn);
+    if( poPrimaryColumn->table_index != 0 ||
+        poSecondaryColumn->table_index != psJoinInfo->secondary_table )
+        return false;
+
+    OGRFeatureDefn* poPrimaryDefn = poSrcLayer->GetLayerDefn();
+    OGRFeatureDefn* poJoinDefn = poJoinLayer->GetLayerDefn();
+    const int iPrimaryField = poPrimaryColumn->field_index;
+    const int iSecondaryField = poSecondaryColumn->field_index;
+    if( iPrimaryField < 0 || iPrimaryField >= poPrimaryDefn->GetFieldCount() ||
+        iSecondaryField < 0 || iSecondaryField >= poJoinDefn->GetFieldCount() )
+        return false;
+
+    // Only use key types for which the equality tested by the attribute
+    // filter of GetFilterForJoin() can be reproduced exactly. Reals are
+    // excluded, since they are formatted with a limited precision there.
+    const OGRFieldType ePrimaryType =
+        poPrimaryDefn->GetFieldDefn(iPrimaryField)->GetType();
+    const OGRFieldType eSecondaryType =
+        poJoinDefn->GetFieldDefn(iSecondaryField)->GetType();
+    const auto IsIntegerType = [](OGRFieldType eType)
+        { return eType == OFTInteger || eType == OFTInteger64; };
+    JoinHashTable& oTable = m_aoJoinHashTables[iJoin];
+    if( IsIntegerType(ePrimaryType) && IsIntegerType(eSecondaryType) )
+        oTable.bStringKey = false;
+    else if( ePrimaryType == OFTString && eSecondaryType == OFTString )
+        oTable.bStringKey = true;
+    else
+        return false;
+    oTable.iPrimaryField = iPrimaryField;
+
+    poJoinLayer->SetAttributeFilter( "" );
+    poJoinLayer->ResetReading();
+
+    const int nFieldCount = poJoinDefn->GetFieldCount();
+    // Rough estimate of the memory used per feature, without the strings
+    // and geometries.
+    const GIntBig nFeatureOverhead =
+        static_cast<GIntBig>(sizeof(OGRFeature)) +
+        static_cast<GIntBig>(sizeof(OGRField)) * nFieldCount +
+        static_cast<GIntBig>(sizeof(void*)) * 8;
+    CPLString osKey;
+    while( true )
+    {
+        std::unique_ptr<OGRFeature> poFeature(poJoinLayer->GetNextFeature());
+        if( poFeature == nullptr )
+            break;
+
+        GIntBig nFeatureMemory = nFeatureOverhead;
+        for( int i = 0; i < nFieldCount; i++ )
+        {
+            if( !poFeature->IsFieldSetAndNotNull(i) )
+                continue;
+            const OGRField* psField = poFeature->GetRawFieldRef(i);
+            switch( poJoinDefn->GetFieldDefn(i)->GetType() )
+            {
+                case OFTString:
+                    nFeatureMemory += strlen(psField->String) + 1;
+                    break;
+                case OFTBinary:
+                    nFeatureMemory += psField->Binary.nCount;
+                    break;
+                case OFTIntegerList:
+                case OFTRealList:
+                case OFTInteger64List:
+                case OFTStringList:
+                    // Upper bound for the list, not counting the strings.
+                    nFeatureMemory +=
+                        static_cast<GIntBig>(psField->IntegerList.nCount) * 8;
+                    break;
+                default:
+                    break;
+            }
+        }
+        for( int i = 0; i < poFeature->GetGeomFieldCount(); i++ )
+        {
+            const OGRGeometry* poGeom = poFeature->GetGeomFieldRef(i);
+            if( poGeom )
+                nFeatureMemory += poGeom->WkbSize();
+        }
+        nRemainingMemory -= nFeatureMemory;
+        if( nRemainingMemory < 0 )
+        {
+            CPLDebug("OGR",
+                     "Secondary layer %s does not fit in the memory allowed "
+                     "for joins (OGR_GENSQL_JOIN_MAX_MEMORY). "
+                     "Using per-feature queries",
+                     poJoinLayer->GetName());
+            poJoinLayer->ResetReading();
+            return false;
+        }
+
+        if( poFeature->IsFieldSetAndNotNull(iSecondaryField) )
+        {
+            const OGRField* psField =
+                poFeature->GetRawFieldRef(iSecondaryField);
+            if( oTable.bStringKey )
+            {
+                const char* pszVal = psField->String;
+                const size_t nLen = strlen(pszVal);
+                // The attribute filter evaluator has a special equality
+                // rule for values that look like timezones. Do not try to
+                // reproduce it.
+                if( nLen > 3 && (strcmp(pszVal + nLen - 3, "+00") == 0 ||
+                                 pszVal[nLen - 3] == ':') )
+                {
+                    poJoinLayer->ResetReading();
+                    return false;
+                }
+                // The comparison of the attribute filter is case insensitive
+                osKey.assign(pszVal, nLen);
+                osKey.tolower();
+                // Keep the first feature for each key, like GetNextFeature()
+                // on the filtered layer does.
+                oTable.oMapString.emplace(osKey, poFeature.get());
+            }
+            else
+            {
+                const GIntBig nKey = eSecondaryType == OFTInteger ?
+                    psField->Integer : psField->Integer64;
+                oTable.oMapInt.emplace(nKey, poFeature.get());
+            }
+        }
+        oTable.apoFeatures.emplace_back(std::move(poFeature));
+    }
+    poJoinLayer->ResetReading();
+
+    CPLDebug("OGR", "Loaded " CPL_FRMT_GUIB " features of %s for hash join",
+             static_cast<GUIntBig>(oTable.apoFeatures.size()),
+             poJoinLayer->GetName());
+    oTable.bUsable = true;
+    return true;
+}
+
 /************************************************************************/
 /*                          TranslateFeature()                          */
 /************************************************************************/
@@ -1286,6 +1492,20 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
 
     apoFeatures.push_back( poSrcFeat );
 
+    if( psSelectInfo->join_count > 0 )
+        PrepareJoinHashTables();
+
+    // Features coming from join hash tables must not be deleted.
+    std::vector<bool> abJoinFeatureOwned;
+    const auto DeleteJoinFeatures = [&apoFeatures, &abJoinFeatureOwned]()
+    {
+        for( size_t i = 0; i < abJoinFeatureOwned.size(); i++ )
+        {
+            if( abJoinFeatureOwned[i] )
+                delete apoFeatures[i + 1];
+        }
+    };
+
 /* -------------------------------------------------------------------- */
 /*      Fetch the corresponding features from any jointed tables.       */
 /* -------------------------------------------------------------------- */
@@ -1300,6 +1520,39 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
         /* we have taken care of this */
         CPLAssert(psJoinInfo->secondary_table == iJoin + 1);
 
+        const JoinHashTable& oTable = m_aoJoinHashTables[iJoin];
+        if( oTable.bUsable )
+        {
+            const OGRFeature* poJoinFeature = nullptr;
+            if( poSrcFeat->IsFieldSetAndNotNull(oTable.iPrimaryField) )
+            {
+                const OGRField* psSrcField =
+                    poSrcFeat->GetRawFieldRef(oTable.iPrimaryField);
+                if( oTable.bStringKey )
+                {
+                    CPLString osKey(psSrcField->String);
+                    osKey.tolower();
+                    const auto oIter = oTable.oMapString.find(osKey);
+                    if( oIter != oTable.oMapString.end() )
+                        poJoinFeature = oIter->second;
+                }
+                else
+                {
+                    const GIntBig nKey =
+                        poSrcFeat->GetFieldDefnRef(oTable.iPrimaryField)->
+                            GetType() == OFTInteger ?
+                        psSrcField->Integer : psSrcField->Integer64;
+                    const auto oIter = oTable.oMapInt.find(nKey);
+                    if( oIter != oTable.oMapInt.end() )
+                        poJoinFeature = oIter->second;
+                }
+            }
+            apoFeatures.push_back( const_cast<OGRFeature*>(poJoinFeature) );
+            abJoinFeatureOwned.push_back( false );
+            continue;
+        }
+        abJoinFeatureOwned.push_back( true );
+
         OGRLayer *poJoinLayer = papoTableLayers[psJoinInfo->secondary_table];
 
         osFilter = GetFilterForJoin(psJoinInfo->poExpr, poSrcFeat, poJoinLayer,
@@ -1358,6 +1611,7 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
         if( poResult == nullptr )
         {
             delete poDstFeat;
+            DeleteJoinFeatures();
             return nullptr;
         }
 
@@ -1538,10 +1792,10 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
 
             iRegularField ++;
         }
-
-        delete poJoinFeature;
     }
 
+    DeleteJoinFeatures();
+
     return poDstFeat;
 }
 
@@ -1552,6 +1806,10 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
 OGRFeature *OGRGenSQLResultsLayer::GetNextFeature()
 
 {
+    // Includes the time spent reading the source layers.
+    GDAL_PERF_COUNTER(poTimeCounter, "OGRSQL.evaluation_time_ns");
+    GDALPerfCounterTimer oTimer(poTimeCounter);
+
     swq_select *psSelectInfo = static_cast<swq_select*>(pSelectInfo);
 
     if( psSelectInfo->limit >= 0 &&
@@ -36,6 +36,9 @@
 #include "cpl_hash_set.h"
 #include "cpl_string.h"
 
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 /*! @cond Doxygen_Suppress */
@@ -84,6 +87,23 @@ class OGRGenSQLResultsLayer final: public OGRLayer
     GIntBig     nIteratedFeatures;
     std::vector<CPLString> m_oDistinctList;
 
+    // In-memory index of the features of a secondary layer, by the value
+    // of the key field of a simple equality join.
+    struct JoinHashTable
+    {
+        bool        bUsable = false;
+        bool        bStringKey = false;
+        int         iPrimaryField = -1;
+        std::vector<std::unique_ptr<OGRFeature>> apoFeatures{};
+        std::unordered_map<GIntBig, const OGRFeature*> oMapInt{};
+        std::unordered_map<std::string, const OGRFeature*> oMapString{};
+    };
+    bool        m_bJoinHashTablesPrepared = false;
+    std::vector<JoinHashTable> m_aoJoinHashTables{};
+
+    void        PrepareJoinHashTables();
+    bool        BuildJoinHashTable( int iJoin, GIntBig& nRemainingMemory );
+
     int         PrepareSummary();
 
     OGRFeature *TranslateFeature( OGRFeature * );
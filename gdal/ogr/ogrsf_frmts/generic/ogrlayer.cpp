@@ -33,6 +33,18 @@
 #include "ogr_attrind.h"
 #include "ogr_swq.h"
 #include "ograpispy.h"
+#include "ogr_recordbatch.h"
+#include "ogrlayerarrow.h"
+#include "ogr_wkb.h"
+#include "cpl_time.h"
+#include "cpl_trace.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <string>
+#include <utility>
+#include <vector>
 
 CPL_CVSID("$Id$")
 
@@ -548,6 +560,7 @@ OGRFeatureH OGR_L_GetNextFeature( OGRLayerH hLayer )
         OGRAPISpy_L_GetNextFeature(hLayer);
 #endif
 
+    CPL_TRACE_SPAN("ogr", "OGR_L_GetNextFeature");
     return OGRFeature::ToHandle(
                 OGRLayer::FromHandle(hLayer)->GetNextFeature());
 }
@@ -1464,6 +1477,128 @@ int OGRLayer::FilterGeometry( OGRGeometry *poGeometry )
             return TRUE;
     }
 }
+
+/************************************************************************/
+/*                       FilterGeometryEnvelope()                       */
+/*                                                                      */
+/*      Cheap pre-filter for drivers that can compute the envelope of  */
+/*      a geometry (e.g. from its WKT or GeoJSON coordinates) before    */
+/*      building it. Returns FALSE if a geometry with this envelope     */
+/*      cannot pass FilterGeometry(), so that the feature can be        */
+/*      skipped without being translated. A TRUE return does not mean  */
+/*      that the geometry intersects the spatial filter.                */
+/************************************************************************/
+
+int OGRLayer::FilterGeometryEnvelope( const OGREnvelope& sGeomEnv )
+
+{
+    if( m_poFilterGeom == nullptr )
+        return TRUE;
+
+    // Empty geometry
+    if( !sGeomEnv.IsInit() )
+        return FALSE;
+
+    return !(sGeomEnv.MaxX < m_sFilterEnvelope.MinX
+             || sGeomEnv.MaxY < m_sFilterEnvelope.MinY
+             || m_sFilterEnvelope.MaxX < sGeomEnv.MinX
+             || m_sFilterEnvelope.MaxY < sGeomEnv.MinY);
+}
+
+/************************************************************************/
+/*                         FilterWKBGeometry()                          */
+/*                                                                      */
+/*      Same as FilterGeometry(), but working on a WKB geometry, for    */
+/*      drivers that natively store geometries as WKB. A OGRGeometry    */
+/*      object is only instantiated when the envelope tests are not     */
+/*      sufficient to conclude.                                         */
+/************************************************************************/
+
+int OGRLayer::FilterWKBGeometry( const GByte* pabyWKB, size_t nWKBSize )
+
+{
+    if( m_poFilterGeom == nullptr )
+        return TRUE;
+
+    if( pabyWKB == nullptr )
+        return FALSE;
+
+    OGRWKBGeometryView oView(pabyWKB, nWKBSize);
+    OGREnvelope sGeomEnv;
+    if( !oView.GetEnvelope(sGeomEnv) )
+    {
+        // Unhandled or corrupted WKB: let the full geometry parser decide.
+        OGRGeometry* poGeom = nullptr;
+        if( OGRGeometryFactory::createFromWkb( pabyWKB, nullptr, &poGeom,
+                                               nWKBSize ) != OGRERR_NONE )
+        {
+            return FALSE;
+        }
+        const int bRet = FilterGeometry(poGeom);
+        delete poGeom;
+        return bRet;
+    }
+
+    if( !sGeomEnv.IsInit() )
+        return FALSE;
+
+    if( sGeomEnv.MaxX < m_sFilterEnvelope.MinX
+        || sGeomEnv.MaxY < m_sFilterEnvelope.MinY
+        || m_sFilterEnvelope.MaxX < sGeomEnv.MinX
+        || m_sFilterEnvelope.MaxY < sGeomEnv.MinY )
+        return FALSE;
+
+    if( m_bFilterIsEnvelope )
+    {
+        if( sGeomEnv.MinX >= m_sFilterEnvelope.MinX &&
+            sGeomEnv.MinY >= m_sFilterEnvelope.MinY &&
+            sGeomEnv.MaxX <= m_sFilterEnvelope.MaxX &&
+            sGeomEnv.MaxY <= m_sFilterEnvelope.MaxY )
+        {
+            return TRUE;
+        }
+
+        // A line, or a polygon without holes, with at least one point
+        // inside the filter envelope intersects it.
+        const auto eFlatType = wkbFlatten(oView.GetGeometryType());
+        OGRWKBPointSequence oRing;
+        if( (eFlatType == wkbLineString ||
+             (eFlatType == wkbPolygon && oView.GetNumRings() == 1)) &&
+            oView.GetNextRing(oRing) )
+        {
+            for( GUInt32 i = 0; i < oRing.nPoints; i++ )
+            {
+                const double x = oRing.getX(i);
+                const double y = oRing.getY(i);
+                if( x >= m_sFilterEnvelope.MinX &&
+                    y >= m_sFilterEnvelope.MinY &&
+                    x <= m_sFilterEnvelope.MaxX &&
+                    y <= m_sFilterEnvelope.MaxY )
+                {
+                    return TRUE;
+                }
+            }
+        }
+    }
+
+    if( !OGRGeometryFactory::haveGEOS() )
+        return TRUE;
+
+    OGRGeometry* poGeom = nullptr;
+    if( OGRGeometryFactory::createFromWkb( pabyWKB, nullptr, &poGeom,
+                                           nWKBSize ) != OGRERR_NONE )
+    {
+        return FALSE;
+    }
+    int bRet;
+    if( m_pPreparedFilterGeom != nullptr )
+        bRet = OGRPreparedGeometryIntersects(m_pPreparedFilterGeom,
+                                             OGRGeometry::ToHandle(poGeom));
+    else
+        bRet = m_poFilterGeom->Intersects( poGeom );
+    delete poGeom;
+    return bRet;
+}
 //! @endcond
 
 /************************************************************************/
@@ -1511,6 +1646,33 @@ OGRErr OGRLayer::InitializeIndexSupport( const char *pszFilename )
 
     return eErr;
 }
+
+/************************************************************************/
+/*                    InitializeBTreeIndexSupport()                     */
+/*                                                                      */
+/*      Same as InitializeIndexSupport(), but using B-tree indexes      */
+/*      stored in a <pszFilename>.ogridx file, that support range       */
+/*      queries. Intended for drivers that do not have an attribute     */
+/*      index of their own but can fetch features by FID efficiently.   */
+/************************************************************************/
+
+OGRErr OGRLayer::InitializeBTreeIndexSupport( const char *pszFilename )
+
+{
+    if (m_poAttrIndex != nullptr)
+        return OGRERR_NONE;
+
+    m_poAttrIndex = OGRCreateBTreeLayerIndex();
+
+    const OGRErr eErr = m_poAttrIndex->Initialize( pszFilename, this );
+    if( eErr != OGRERR_NONE )
+    {
+        delete m_poAttrIndex;
+        m_poAttrIndex = nullptr;
+    }
+
+    return eErr;
+}
 //! @endcond
 
 /************************************************************************/
@@ -4365,3 +4527,1368 @@ OGRLayer::FeatureIterator OGRLayer::end()
 {
     return {this, false};
 }
+
+/************************************************************************/
+/*                     Arrow C stream interface                         */
+/************************************************************************/
+
+namespace {
+
+struct OGRArrowArrayStreamPrivateData
+{
+    OGRLayer*   m_poLayer = nullptr;
+    std::string m_osLastError{};
+};
+
+} // namespace
+
+//! @cond Doxygen_Suppress
+int OGRLayer::StaticGetArrowSchema(struct ArrowArrayStream* stream,
+                                   struct ArrowSchema* out_schema)
+{
+    auto psPrivate =
+        static_cast<OGRArrowArrayStreamPrivateData*>(stream->private_data);
+    CPLErrorReset();
+    const int nRet = psPrivate->m_poLayer->GetArrowSchema(stream, out_schema);
+    psPrivate->m_osLastError = nRet == 0 ? "" : CPLGetLastErrorMsg();
+    return nRet;
+}
+
+int OGRLayer::StaticGetNextArrowArray(struct ArrowArrayStream* stream,
+                                      struct ArrowArray* out_array)
+{
+    auto psPrivate =
+        static_cast<OGRArrowArrayStreamPrivateData*>(stream->private_data);
+    CPLErrorReset();
+    const int nRet = psPrivate->m_poLayer->GetNextArrowArray(stream, out_array);
+    psPrivate->m_osLastError = nRet == 0 ? "" : CPLGetLastErrorMsg();
+    return nRet;
+}
+
+static const char* OGRLayerStaticGetLastErrorArrowArrayStream(
+                                            struct ArrowArrayStream* stream)
+{
+    auto psPrivate =
+        static_cast<OGRArrowArrayStreamPrivateData*>(stream->private_data);
+    return psPrivate->m_osLastError.empty() ?
+                            nullptr : psPrivate->m_osLastError.c_str();
+}
+//! @endcond
+
+static void OGRLayerStaticReleaseArrowArrayStream(
+                                            struct ArrowArrayStream* stream)
+{
+    delete static_cast<OGRArrowArrayStreamPrivateData*>(stream->private_data);
+    stream->private_data = nullptr;
+    stream->release = nullptr;
+}
+
+/************************************************************************/
+/*                         GetArrowStream()                             */
+/************************************************************************/
+
+/** Get a Arrow C stream.
+ *
+ * On successful return, and when the stream interfaces is no longer needed,
+ * it must must be freed with out_stream->release(out_stream).
+ *
+ * The stream is a way of reading the features of the layer in batches, in
+ * a columnar layout that follows the
+ * <a href="https://arrow.apache.org/docs/format/CDataInterface.html">Apache
+ * Arrow C data interface</a> and the
+ * <a href="https://arrow.apache.org/docs/format/CStreamInterface.html">Apache
+ * Arrow C stream interface</a>. The structures are defined in
+ * ogr_recordbatch.h.
+ *
+ * The schema, returned by out_stream->get_schema(), is a struct whose
+ * children are, in this order:
+ * <ul>
+ * <li>the FID, as a int64 column, unless the INCLUDE_FID option is set to
+ *     NO,</li>
+ * <li>the attribute fields that are not ignored, mapped to the Arrow type
+ *     closest to their OGR type and subtype,</li>
+ * <li>the geometry fields that are not ignored, as binary columns holding ISO
+ *     WKB, with the "ogc.wkb" ARROW:extension:name metadata.</li>
+ * </ul>
+ * DateTime fields are returned as timestamps with milliseconds, without
+ * timezone, and with the time of the field as stored, that is without
+ * conversion to UTC.
+ *
+ * Each call to out_stream->get_next() returns a batch of at most
+ * MAX_FEATURES_IN_BATCH features. An array whose release member is NULL
+ * indicates the end of the stream.
+ *
+ * The default implementation uses GetNextFeature() internally, and so
+ * honours the spatial and attribute filters. It calls ResetReading() when
+ * the stream is created. Drivers may provide a more efficient
+ * implementation by overriding GetArrowSchema() and GetNextArrowArray(),
+ * which can use the options that are stored in
+ * m_aosArrowArrayStreamOptions.
+ *
+ * The layer must be kept alive while the stream is used, and the layer
+ * must not be read by other means at the same time.
+ *
+ * Options may be:
+ * <ul>
+ * <li>INCLUDE_FID=YES/NO. Whether to include the FID column. Defaults to
+ *     YES.</li>
+ * <li>MAX_FEATURES_IN_BATCH=integer. Maximum number of features to retrieve
+ *     in a ArrowArray batch. Defaults to 65536.</li>
+ * </ul>
+ *
+ * This method is the same as the C function OGR_L_GetArrowStream().
+ *
+ * @param out_stream Pointer to an ArrowArrayStream structure, that will be
+ * initialized on success.
+ * @param papszOptions NULL terminated list of key=value options.
+ * @return true in case of success.
+ * @since GDAL 3.4
+ */
+bool OGRLayer::GetArrowStream(struct ArrowArrayStream* out_stream,
+                              CSLConstList papszOptions)
+{
+    if( out_stream == nullptr )
+        return false;
+    memset(out_stream, 0, sizeof(*out_stream));
+
+    const int nMaxBatchSize = atoi(CSLFetchNameValueDef(
+        papszOptions, "MAX_FEATURES_IN_BATCH", "65536"));
+    if( nMaxBatchSize <= 0 )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid value for MAX_FEATURES_IN_BATCH");
+        return false;
+    }
+    m_aosArrowArrayStreamOptions.Assign(CSLDuplicate(papszOptions), true);
+
+    ResetReading();
+
+    auto psPrivate = new OGRArrowArrayStreamPrivateData();
+    psPrivate->m_poLayer = this;
+    out_stream->private_data = psPrivate;
+    out_stream->get_schema = StaticGetArrowSchema;
+    out_stream->get_next = StaticGetNextArrowArray;
+    out_stream->get_last_error = OGRLayerStaticGetLastErrorArrowArrayStream;
+    out_stream->release = OGRLayerStaticReleaseArrowArrayStream;
+    return true;
+}
+
+/************************************************************************/
+/*                       OGR_L_GetArrowStream()                         */
+/************************************************************************/
+
+/** Get a Arrow C stream.
+ *
+ * On successful return, and when the stream interfaces is no longer needed,
+ * it must must be freed with out_stream->release(out_stream).
+ *
+ * This function is the same as the C++ method OGRLayer::GetArrowStream(),
+ * which documents the layout of the stream and the available options.
+ *
+ * @param hLayer Layer
+ * @param out_stream Pointer to an ArrowArrayStream structure, that will be
+ * initialized on success.
+ * @param papszOptions NULL terminated list of key=value options.
+ * @return true in case of success.
+ * @since GDAL 3.4
+ */
+bool OGR_L_GetArrowStream(OGRLayerH hLayer,
+                          struct ArrowArrayStream* out_stream,
+                          char** papszOptions)
+{
+    VALIDATE_POINTER1( hLayer, "OGR_L_GetArrowStream", false );
+    VALIDATE_POINTER1( out_stream, "OGR_L_GetArrowStream", false );
+
+    return OGRLayer::FromHandle(hLayer)->GetArrowStream(out_stream,
+                                                        papszOptions);
+}
+
+/************************************************************************/
+/*                          GetArrowSchema()                            */
+/************************************************************************/
+
+static void OGRLayerReleaseSchema(struct ArrowSchema* schema)
+{
+    CPLAssert(schema->release != nullptr);
+    for( int64_t i = 0; i < schema->n_children; ++i )
+    {
+        if( schema->children[i]->release )
+            schema->children[i]->release(schema->children[i]);
+        CPLFree(schema->children[i]);
+    }
+    CPLFree(schema->children);
+    CPLFree(const_cast<char*>(schema->name));
+    CPLFree(const_cast<char*>(schema->metadata));
+    schema->release = nullptr;
+}
+
+static struct ArrowSchema* OGRLayerNewSchema(const char* pszFormat,
+                                             const char* pszName,
+                                             bool bNullable)
+{
+    auto psSchema = static_cast<struct ArrowSchema*>(
+        CPLCalloc(1, sizeof(struct ArrowSchema)));
+    psSchema->release = OGRLayerReleaseSchema;
+    // Formats are all static strings.
+    psSchema->format = pszFormat;
+    psSchema->name = CPLStrdup(pszName);
+    if( bNullable )
+        psSchema->flags = ARROW_FLAG_NULLABLE;
+    return psSchema;
+}
+
+static const char* OGRLayerGetArrowFormat(const OGRFieldDefn* poFieldDefn,
+                                          const char** ppszItemFormat)
+{
+    *ppszItemFormat = nullptr;
+    const OGRFieldSubType eSubType = poFieldDefn->GetSubType();
+    switch( poFieldDefn->GetType() )
+    {
+        case OFTInteger:
+            return eSubType == OFSTBoolean ? "b" :
+                   eSubType == OFSTInt16 ? "s" : "i";
+        case OFTInteger64:
+            return "l";
+        case OFTReal:
+            return eSubType == OFSTFloat32 ? "f" : "g";
+        case OFTString:
+        case OFTWideString:
+            return "u";
+        case OFTBinary:
+            return "z";
+        case OFTDate:
+            return "tdD";
+        case OFTTime:
+            return "ttm";
+        case OFTDateTime:
+            return "tsm:";
+        case OFTIntegerList:
+            *ppszItemFormat = eSubType == OFSTBoolean ? "b" :
+                              eSubType == OFSTInt16 ? "s" : "i";
+            return "+l";
+        case OFTInteger64List:
+            *ppszItemFormat = "l";
+            return "+l";
+        case OFTRealList:
+            *ppszItemFormat = eSubType == OFSTFloat32 ? "f" : "g";
+            return "+l";
+        case OFTStringList:
+        case OFTWideStringList:
+            *ppszItemFormat = "u";
+            return "+l";
+    }
+    return nullptr;
+}
+
+/** Default implementation of the ArrowArrayStream::get_schema() callback.
+ *
+ * To be used by driver implementations that have a custom GetArrowStream()
+ * implementation.
+ *
+ * @since GDAL 3.4
+ */
+int OGRLayer::GetArrowSchema(struct ArrowArrayStream*,
+                             struct ArrowSchema* out_schema)
+{
+    const bool bIncludeFID = CPLTestBool(
+        m_aosArrowArrayStreamOptions.FetchNameValueDef("INCLUDE_FID", "YES"));
+    const OGRFeatureDefn* poLayerDefn = GetLayerDefn();
+
+    std::vector<struct ArrowSchema*> apoChildren;
+    if( bIncludeFID )
+    {
+        const char* pszFIDName = GetFIDColumn();
+        apoChildren.push_back(OGRLayerNewSchema(
+            "l", pszFIDName[0] ? pszFIDName : "OGC_FID", false));
+    }
+
+    for( int i = 0; i < poLayerDefn->GetFieldCount(); ++i )
+    {
+        const OGRFieldDefn* poFieldDefn = poLayerDefn->GetFieldDefn(i);
+        if( poFieldDefn->IsIgnored() )
+            continue;
+        const char* pszItemFormat = nullptr;
+        const char* pszFormat =
+            OGRLayerGetArrowFormat(poFieldDefn, &pszItemFormat);
+        auto psChild = OGRLayerNewSchema(pszFormat, poFieldDefn->GetNameRef(),
+                                         CPL_TO_BOOL(poFieldDefn->IsNullable()));
+        if( pszItemFormat )
+        {
+            psChild->n_children = 1;
+            psChild->children = static_cast<struct ArrowSchema**>(
+                CPLCalloc(1, sizeof(struct ArrowSchema*)));
+            psChild->children[0] =
+                OGRLayerNewSchema(pszItemFormat, "item", false);
+        }
+        apoChildren.push_back(psChild);
+    }
+
+    for( int i = 0; i < poLayerDefn->GetGeomFieldCount(); ++i )
+    {
+        const OGRGeomFieldDefn* poFieldDefn = poLayerDefn->GetGeomFieldDefn(i);
+        if( poFieldDefn->IsIgnored() )
+            continue;
+        const char* pszName = poFieldDefn->GetNameRef();
+        auto psChild = OGRLayerNewSchema("z",
+                                         pszName[0] ? pszName : "wkb_geometry",
+                                         true);
+
+        // Metadata is a int32 count of key/value pairs, followed by
+        // int32-length prefixed keys and values.
+        const char* const pszKey = "ARROW:extension:name";
+        const char* const pszValue = "ogc.wkb";
+        const int32_t nCount = 1;
+        const int32_t nKeyLen = static_cast<int32_t>(strlen(pszKey));
+        const int32_t nValueLen = static_cast<int32_t>(strlen(pszValue));
+        std::string osMetadata;
+        osMetadata.append(reinterpret_cast<const char*>(&nCount),
+                          sizeof(nCount));
+        osMetadata.append(reinterpret_cast<const char*>(&nKeyLen),
+                          sizeof(nKeyLen));
+        osMetadata.append(pszKey);
+        osMetadata.append(reinterpret_cast<const char*>(&nValueLen),
+                          sizeof(nValueLen));
+        osMetadata.append(pszValue);
+        char* pszMetadata = static_cast<char*>(CPLMalloc(osMetadata.size()));
+        memcpy(pszMetadata, osMetadata.data(), osMetadata.size());
+        psChild->metadata = pszMetadata;
+
+        apoChildren.push_back(psChild);
+    }
+
+    memset(out_schema, 0, sizeof(*out_schema));
+    out_schema->format = "+s";
+    out_schema->name = CPLStrdup("");
+    out_schema->n_children = static_cast<int64_t>(apoChildren.size());
+    out_schema->children = static_cast<struct ArrowSchema**>(
+        CPLCalloc(apoChildren.size() + 1, sizeof(struct ArrowSchema*)));
+    for( size_t i = 0; i < apoChildren.size(); ++i )
+        out_schema->children[i] = apoChildren[i];
+    out_schema->release = OGRLayerReleaseSchema;
+    return 0;
+}
+
+/************************************************************************/
+/*                        GetNextArrowArray()                           */
+/************************************************************************/
+
+static void OGRLayerReleaseArray(struct ArrowArray* array)
+{
+    CPLAssert(array->release != nullptr);
+    for( int64_t i = 0; i < array->n_buffers; ++i )
+        VSIFreeAligned(const_cast<void*>(array->buffers[i]));
+    CPLFree(array->buffers);
+    for( int64_t i = 0; i < array->n_children; ++i )
+    {
+        if( array->children[i]->release )
+            array->children[i]->release(array->children[i]);
+        CPLFree(array->children[i]);
+    }
+    CPLFree(array->children);
+    array->release = nullptr;
+}
+
+static struct ArrowArray* OGRLayerNewArray(int nBuffers, size_t nLength)
+{
+    auto psArray = static_cast<struct ArrowArray*>(
+        CPLCalloc(1, sizeof(struct ArrowArray)));
+    psArray->release = OGRLayerReleaseArray;
+    psArray->length = static_cast<int64_t>(nLength);
+    psArray->n_buffers = nBuffers;
+    psArray->buffers = static_cast<const void**>(
+        CPLCalloc(nBuffers, sizeof(void*)));
+    return psArray;
+}
+
+// Buffers are 64-byte aligned and zero-initialized, as recommended by the
+// Arrow specification.
+static void* OGRLayerAllocBuffer(size_t nSize)
+{
+    constexpr size_t ALIGNMENT = 64;
+    void* pBuffer = VSIMallocAligned(ALIGNMENT, std::max<size_t>(1, nSize));
+    if( pBuffer )
+        memset(pBuffer, 0, std::max<size_t>(1, nSize));
+    else
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate " CPL_FRMT_GUIB " bytes",
+                 static_cast<GUIntBig>(nSize));
+    return pBuffer;
+}
+
+// Fill the validity bitmap (buffer 0) of psArray, which is only allocated
+// if there are null values.
+static bool OGRLayerFillValidity(struct ArrowArray* psArray,
+                                 const std::vector<bool>& abValid)
+{
+    size_t nNullCount = 0;
+    for( const bool bValid : abValid )
+    {
+        if( !bValid )
+            ++nNullCount;
+    }
+    psArray->null_count = static_cast<int64_t>(nNullCount);
+    if( nNullCount == 0 )
+        return true;
+    GByte* pabyValidity = static_cast<GByte*>(
+        OGRLayerAllocBuffer((abValid.size() + 7) / 8));
+    if( pabyValidity == nullptr )
+        return false;
+    psArray->buffers[0] = pabyValidity;
+    for( size_t i = 0; i < abValid.size(); ++i )
+    {
+        if( abValid[i] )
+            pabyValidity[i / 8] |= static_cast<GByte>(1 << (i % 8));
+    }
+    return true;
+}
+
+// Fill buffers 1 (int32 offsets) and 2 (bytes) of a string or binary array.
+static bool OGRLayerFillBinaryBuffers(
+                    struct ArrowArray* psArray,
+                    const std::vector<std::pair<const GByte*, size_t>>& aoValues)
+{
+    size_t nTotalSize = 0;
+    for( const auto& oValue : aoValues )
+    {
+        nTotalSize += oValue.second;
+        if( nTotalSize > static_cast<size_t>(INT_MAX) )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Too large string or binary content in batch. "
+                     "Try lowering MAX_FEATURES_IN_BATCH");
+            return false;
+        }
+    }
+    int32_t* panOffsets = static_cast<int32_t*>(
+        OGRLayerAllocBuffer(sizeof(int32_t) * (aoValues.size() + 1)));
+    if( panOffsets == nullptr )
+        return false;
+    psArray->buffers[1] = panOffsets;
+    GByte* pabyData = static_cast<GByte*>(OGRLayerAllocBuffer(nTotalSize));
+    if( pabyData == nullptr )
+        return false;
+    psArray->buffers[2] = pabyData;
+    size_t nOffset = 0;
+    for( size_t i = 0; i < aoValues.size(); ++i )
+    {
+        panOffsets[i] = static_cast<int32_t>(nOffset);
+        if( aoValues[i].second )
+            memcpy(pabyData + nOffset, aoValues[i].first, aoValues[i].second);
+        nOffset += aoValues[i].second;
+    }
+    panOffsets[aoValues.size()] = static_cast<int32_t>(nOffset);
+    return true;
+}
+
+// Fill buffer 1 of a fixed size primitive array (or buffer 1 of a boolean
+// array when T is bool).
+template<class T> static bool OGRLayerFillValues(struct ArrowArray* psArray,
+                                                 const std::vector<T>& aValues)
+{
+    T* paValues = static_cast<T*>(
+        OGRLayerAllocBuffer(sizeof(T) * aValues.size()));
+    if( paValues == nullptr )
+        return false;
+    psArray->buffers[1] = paValues;
+    if( !aValues.empty() )
+        memcpy(paValues, aValues.data(), sizeof(T) * aValues.size());
+    return true;
+}
+
+static bool OGRLayerFillBooleanValues(struct ArrowArray* psArray,
+                                      const std::vector<int>& anValues)
+{
+    GByte* pabyValues = static_cast<GByte*>(
+        OGRLayerAllocBuffer((anValues.size() + 7) / 8));
+    if( pabyValues == nullptr )
+        return false;
+    psArray->buffers[1] = pabyValues;
+    for( size_t i = 0; i < anValues.size(); ++i )
+    {
+        if( anValues[i] )
+            pabyValues[i / 8] |= static_cast<GByte>(1 << (i % 8));
+    }
+    return true;
+}
+
+// Build the array of the values of an integer or real field (or list item)
+// given the Arrow format.
+static struct ArrowArray* OGRLayerBuildNumericArray(
+                                        const char* pszFormat,
+                                        const std::vector<double>& adfValues,
+                                        const std::vector<GIntBig>& anValues,
+                                        size_t nLength)
+{
+    struct ArrowArray* psArray = OGRLayerNewArray(2, nLength);
+    bool bOK = true;
+    if( strcmp(pszFormat, "b") == 0 )
+    {
+        std::vector<int> anTmp(anValues.begin(), anValues.end());
+        bOK = OGRLayerFillBooleanValues(psArray, anTmp);
+    }
+    else if( strcmp(pszFormat, "s") == 0 )
+    {
+        std::vector<int16_t> anTmp;
+        anTmp.reserve(anValues.size());
+        for( const GIntBig nVal : anValues )
+            anTmp.push_back(static_cast<int16_t>(nVal));
+        bOK = OGRLayerFillValues(psArray, anTmp);
+    }
+    else if( strcmp(pszFormat, "i") == 0 )
+    {
+        std::vector<int32_t> anTmp;
+        anTmp.reserve(anValues.size());
+        for( const GIntBig nVal : anValues )
+            anTmp.push_back(static_cast<int32_t>(nVal));
+        bOK = OGRLayerFillValues(psArray, anTmp);
+    }
+    else if( strcmp(pszFormat, "l") == 0 )
+    {
+        std::vector<int64_t> anTmp(anValues.begin(), anValues.end());
+        bOK = OGRLayerFillValues(psArray, anTmp);
+    }
+    else if( strcmp(pszFormat, "f") == 0 )
+    {
+        std::vector<float> afTmp;
+        afTmp.reserve(adfValues.size());
+        for( const double dfVal : adfValues )
+            afTmp.push_back(static_cast<float>(dfVal));
+        bOK = OGRLayerFillValues(psArray, afTmp);
+    }
+    else
+    {
+        CPLAssert(strcmp(pszFormat, "g") == 0);
+        bOK = OGRLayerFillValues(psArray, adfValues);
+    }
+    if( !bOK )
+    {
+        psArray->release(psArray);
+        CPLFree(psArray);
+        return nullptr;
+    }
+    return psArray;
+}
+
+/** Default implementation of the ArrowArrayStream::get_next() callback.
+ *
+ * To be used by driver implementations that have a custom GetArrowStream()
+ * implementation.
+ *
+ * @since GDAL 3.4
+ */
+int OGRLayer::GetNextArrowArray(struct ArrowArrayStream*,
+                                struct ArrowArray* out_array)
+{
+    memset(out_array, 0, sizeof(*out_array));
+
+    const bool bIncludeFID = CPLTestBool(
+        m_aosArrowArrayStreamOptions.FetchNameValueDef("INCLUDE_FID", "YES"));
+    const int nMaxBatchSize = std::max(1, atoi(
+        m_aosArrowArrayStreamOptions.FetchNameValueDef(
+            "MAX_FEATURES_IN_BATCH", "65536")));
+
+    std::vector<std::unique_ptr<OGRFeature>> apoFeatures;
+    while( static_cast<int>(apoFeatures.size()) < nMaxBatchSize )
+    {
+        OGRFeature* poFeature = GetNextFeature();
+        if( poFeature == nullptr )
+            break;
+        apoFeatures.emplace_back(poFeature);
+    }
+    if( apoFeatures.empty() )
+    {
+        // End of stream.
+        return 0;
+    }
+    const size_t nFeatures = apoFeatures.size();
+
+    const OGRFeatureDefn* poLayerDefn = GetLayerDefn();
+    std::vector<struct ArrowArray*> apoChildren;
+    const auto ReleaseChildren = [&apoChildren]()
+    {
+        for( auto psChild : apoChildren )
+        {
+            if( psChild )
+            {
+                if( psChild->release )
+                    psChild->release(psChild);
+                CPLFree(psChild);
+            }
+        }
+    };
+    const auto Fail = [&ReleaseChildren](int nErrno)
+    {
+        ReleaseChildren();
+        return nErrno;
+    };
+
+    if( bIncludeFID )
+    {
+        std::vector<int64_t> anFIDs;
+        anFIDs.reserve(nFeatures);
+        for( const auto& poFeature : apoFeatures )
+            anFIDs.push_back(poFeature->GetFID());
+        struct ArrowArray* psArray = OGRLayerNewArray(2, nFeatures);
+        apoChildren.push_back(psArray);
+        if( !OGRLayerFillValues(psArray, anFIDs) )
+            return Fail(ENOMEM);
+    }
+
+    std::vector<bool> abValid(nFeatures);
+    for( int iField = 0; iField < poLayerDefn->GetFieldCount(); ++iField )
+    {
+        const OGRFieldDefn* poFieldDefn = poLayerDefn->GetFieldDefn(iField);
+        if( poFieldDefn->IsIgnored() )
+            continue;
+        const char* pszItemFormat = nullptr;
+        const char* pszFormat =
+            OGRLayerGetArrowFormat(poFieldDefn, &pszItemFormat);
+        for( size_t i = 0; i < nFeatures; ++i )
+            abValid[i] = CPL_TO_BOOL(
+                apoFeatures[i]->IsFieldSetAndNotNull(iField));
+
+        struct ArrowArray* psArray = nullptr;
+        const OGRFieldType eType = poFieldDefn->GetType();
+        switch( eType )
+        {
+            case OFTInteger:
+            case OFTInteger64:
+            case OFTReal:
+            {
+                std::vector<double> adfValues;
+                std::vector<GIntBig> anValues;
+                if( eType == OFTReal )
+                    adfValues.resize(nFeatures);
+                else
+                    anValues.resize(nFeatures);
+                for( size_t i = 0; i < nFeatures; ++i )
+                {
+                    if( !abValid[i] )
+                        continue;
+                    const OGRField* psField =
+                        apoFeatures[i]->GetRawFieldRef(iField);
+                    if( eType == OFTInteger )
+                        anValues[i] = psField->Integer;
+                    else if( eType == OFTInteger64 )
+                        anValues[i] = psField->Integer64;
+                    else
+                        adfValues[i] = psField->Real;
+                }
+                psArray = OGRLayerBuildNumericArray(pszFormat, adfValues,
+                                                    anValues, nFeatures);
+                if( psArray == nullptr )
+                    return Fail(ENOMEM);
+                apoChildren.push_back(psArray);
+                break;
+            }
+
+            case OFTString:
+            case OFTWideString:
+            case OFTBinary:
+            {
+                std::vector<std::pair<const GByte*, size_t>> aoValues(
+                    nFeatures, std::pair<const GByte*, size_t>(nullptr, 0));
+                for( size_t i = 0; i < nFeatures; ++i )
+                {
+                    if( !abValid[i] )
+                        continue;
+                    const OGRField* psField =
+                        apoFeatures[i]->GetRawFieldRef(iField);
+                    if( eType == OFTBinary )
+                    {
+                        aoValues[i].first = psField->Binary.paData;
+                        aoValues[i].second =
+                            static_cast<size_t>(psField->Binary.nCount);
+                    }
+                    else
+                    {
+                        aoValues[i].first =
+                            reinterpret_cast<const GByte*>(psField->String);
+                        aoValues[i].second = strlen(psField->String);
+                    }
+                }
+                psArray = OGRLayerNewArray(3, nFeatures);
+                apoChildren.push_back(psArray);
+                if( !OGRLayerFillBinaryBuffers(psArray, aoValues) )
+                    return Fail(ENOMEM);
+                break;
+            }
+
+            case OFTDate:
+            case OFTTime:
+            case OFTDateTime:
+            {
+                std::vector<int32_t> anValues32;
+                std::vector<int64_t> anValues64;
+                if( eType == OFTDateTime )
+                    anValues64.resize(nFeatures);
+                else
+                    anValues32.resize(nFeatures);
+                for( size_t i = 0; i < nFeatures; ++i )
+                {
+                    if( !abValid[i] )
+                        continue;
+                    const OGRField* psField =
+                        apoFeatures[i]->GetRawFieldRef(iField);
+                    struct tm brokenDown;
+                    memset(&brokenDown, 0, sizeof(brokenDown));
+                    brokenDown.tm_year = psField->Date.Year - 1900;
+                    brokenDown.tm_mon = psField->Date.Month - 1;
+                    brokenDown.tm_mday = psField->Date.Day;
+                    const int nMilliSecInDay =
+                        (psField->Date.Hour * 3600 +
+                         psField->Date.Minute * 60) * 1000 +
+                        static_cast<int>(psField->Date.Second * 1000 + 0.5);
+                    if( eType == OFTTime )
+                    {
+                        anValues32[i] = nMilliSecInDay;
+                        continue;
+                    }
+                    const GIntBig nDays =
+                        CPLYMDHMSToUnixTime(&brokenDown) / 86400;
+                    if( eType == OFTDate )
+                        anValues32[i] = static_cast<int32_t>(nDays);
+                    else
+                        anValues64[i] = nDays * 86400 * 1000 + nMilliSecInDay;
+                }
+                psArray = OGRLayerNewArray(2, nFeatures);
+                apoChildren.push_back(psArray);
+                const bool bOK = eType == OFTDateTime ?
+                    OGRLayerFillValues(psArray, anValues64) :
+                    OGRLayerFillValues(psArray, anValues32);
+                if( !bOK )
+                    return Fail(ENOMEM);
+                break;
+            }
+
+            case OFTIntegerList:
+            case OFTInteger64List:
+            case OFTRealList:
+            case OFTStringList:
+            case OFTWideStringList:
+            {
+                std::vector<int32_t> anOffsets(nFeatures + 1);
+                std::vector<double> adfItems;
+                std::vector<GIntBig> anItems;
+                std::vector<std::pair<const GByte*, size_t>> aoItems;
+                size_t nItems = 0;
+                for( size_t i = 0; i < nFeatures; ++i )
+                {
+                    if( nItems > static_cast<size_t>(INT_MAX) )
+                    {
+                        CPLError(CE_Failure, CPLE_AppDefined,
+                                 "Too many list items in batch. "
+                                 "Try lowering MAX_FEATURES_IN_BATCH");
+                        return Fail(EOVERFLOW);
+                    }
+                    anOffsets[i] = static_cast<int32_t>(nItems);
+                    if( !abValid[i] )
+                        continue;
+                    const OGRField* psField =
+                        apoFeatures[i]->GetRawFieldRef(iField);
+                    if( eType == OFTIntegerList )
+                    {
+                        for( int j = 0; j < psField->IntegerList.nCount; ++j )
+                            anItems.push_back(psField->IntegerList.paList[j]);
+                        nItems += psField->IntegerList.nCount;
+                    }
+                    else if( eType == OFTInteger64List )
+                    {
+                        anItems.insert(anItems.end(),
+                            psField->Integer64List.paList,
+                            psField->Integer64List.paList +
+                                psField->Integer64List.nCount);
+                        nItems += psField->Integer64List.nCount;
+                    }
+                    else if( eType == OFTRealList )
+                    {
+                        adfItems.insert(adfItems.end(),
+                            psField->RealList.paList,
+                            psField->RealList.paList +
+                                psField->RealList.nCount);
+                        nItems += psField->RealList.nCount;
+                    }
+                    else
+                    {
+                        for( int j = 0; j < psField->StringList.nCount; ++j )
+                        {
+                            const char* pszStr = psField->StringList.paList[j];
+                            aoItems.emplace_back(
+                                reinterpret_cast<const GByte*>(pszStr),
+                                strlen(pszStr));
+                        }
+                        nItems += psField->StringList.nCount;
+                    }
+                }
+                if( nItems > static_cast<size_t>(INT_MAX) )
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "Too many list items in batch. "
+                             "Try lowering MAX_FEATURES_IN_BATCH");
+                    return Fail(EOVERFLOW);
+                }
+                anOffsets[nFeatures] = static_cast<int32_t>(nItems);
+
+                psArray = OGRLayerNewArray(2, nFeatures);
+                apoChildren.push_back(psArray);
+                psArray->n_children = 1;
+                psArray->children = static_cast<struct ArrowArray**>(
+                    CPLCalloc(1, sizeof(struct ArrowArray*)));
+                if( !OGRLayerFillValues(psArray, anOffsets) )
+                    return Fail(ENOMEM);
+
+                struct ArrowArray* psItems = nullptr;
+                if( eType == OFTStringList || eType == OFTWideStringList )
+                {
+                    psItems = OGRLayerNewArray(3, nItems);
+                    psArray->children[0] = psItems;
+                    if( !OGRLayerFillBinaryBuffers(psItems, aoItems) )
+                        return Fail(ENOMEM);
+                }
+                else
+                {
+                    psItems = OGRLayerBuildNumericArray(
+                        pszItemFormat, adfItems, anItems, nItems);
+                    if( psItems == nullptr )
+                    {
+                        // Make the parent array consistent for its release.
+                        psArray->n_children = 0;
+                        return Fail(ENOMEM);
+                    }
+                    psArray->children[0] = psItems;
+                }
+                break;
+            }
+        }
+
+        if( psArray == nullptr || !OGRLayerFillValidity(psArray, abValid) )
+            return Fail(ENOMEM);
+    }
+
+    for( int iField = 0; iField < poLayerDefn->GetGeomFieldCount(); ++iField )
+    {
+        const OGRGeomFieldDefn* poFieldDefn =
+            poLayerDefn->GetGeomFieldDefn(iField);
+        if( poFieldDefn->IsIgnored() )
+            continue;
+
+        std::vector<size_t> anWKBSizes(nFeatures);
+        size_t nTotalSize = 0;
+        for( size_t i = 0; i < nFeatures; ++i )
+        {
+            const OGRGeometry* poGeom = apoFeatures[i]->GetGeomFieldRef(iField);
+            abValid[i] = poGeom != nullptr;
+            if( poGeom )
+            {
+                anWKBSizes[i] = static_cast<size_t>(poGeom->WkbSize());
+                nTotalSize += anWKBSizes[i];
+            }
+        }
+        if( nTotalSize > static_cast<size_t>(INT_MAX) )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Too large geometry content in batch. "
+                     "Try lowering MAX_FEATURES_IN_BATCH");
+            return Fail(EOVERFLOW);
+        }
+
+        struct ArrowArray* psArray = OGRLayerNewArray(3, nFeatures);
+        apoChildren.push_back(psArray);
+        int32_t* panOffsets = static_cast<int32_t*>(
+            OGRLayerAllocBuffer(sizeof(int32_t) * (nFeatures + 1)));
+        if( panOffsets == nullptr )
+            return Fail(ENOMEM);
+        psArray->buffers[1] = panOffsets;
+        GByte* pabyData = static_cast<GByte*>(OGRLayerAllocBuffer(nTotalSize));
+        if( pabyData == nullptr )
+            return Fail(ENOMEM);
+        psArray->buffers[2] = pabyData;
+        size_t nOffset = 0;
+        for( size_t i = 0; i < nFeatures; ++i )
+        {
+            panOffsets[i] = static_cast<int32_t>(nOffset);
+            const OGRGeometry* poGeom = apoFeatures[i]->GetGeomFieldRef(iField);
+            if( poGeom )
+            {
+                poGeom->exportToWkb(wkbNDR, pabyData + nOffset,
+                                    wkbVariantIso);
+                nOffset += anWKBSizes[i];
+            }
+        }
+        panOffsets[nFeatures] = static_cast<int32_t>(nOffset);
+
+        if( !OGRLayerFillValidity(psArray, abValid) )
+            return Fail(ENOMEM);
+    }
+
+    out_array->length = static_cast<int64_t>(nFeatures);
+    out_array->null_count = 0;
+    out_array->n_buffers = 1;
+    out_array->buffers = static_cast<const void**>(
+        CPLCalloc(1, sizeof(void*)));
+    out_array->n_children = static_cast<int64_t>(apoChildren.size());
+    out_array->children = static_cast<struct ArrowArray**>(
+        CPLCalloc(apoChildren.size() + 1, sizeof(struct ArrowArray*)));
+    for( size_t i = 0; i < apoChildren.size(); ++i )
+        out_array->children[i] = apoChildren[i];
+    out_array->release = OGRLayerReleaseArray;
+    return 0;
+}
+
+/************************************************************************/
+/*                      OGRArrowGetColumnMapping()                      */
+/************************************************************************/
+
+// Whether an Arrow format can be converted to the type of a OGR field.
+static bool OGRArrowIsFormatCompatible(const OGRFieldDefn* poFieldDefn,
+                                       const struct ArrowSchema* psSchema)
+{
+    const char* pszFormat = psSchema->format;
+    const auto IsNumeric = [](const char* pszFmt)
+    {
+        return (pszFmt[0] == 'b' || pszFmt[0] == 's' || pszFmt[0] == 'i' ||
+                pszFmt[0] == 'l' || pszFmt[0] == 'f' || pszFmt[0] == 'g') &&
+               pszFmt[1] == 0;
+    };
+    switch( poFieldDefn->GetType() )
+    {
+        case OFTInteger:
+        case OFTInteger64:
+        case OFTReal:
+            return IsNumeric(pszFormat);
+        case OFTString:
+        case OFTWideString:
+            return strcmp(pszFormat, "u") == 0;
+        case OFTBinary:
+            return strcmp(pszFormat, "z") == 0;
+        case OFTDate:
+            return strcmp(pszFormat, "tdD") == 0;
+        case OFTTime:
+            return strcmp(pszFormat, "ttm") == 0;
+        case OFTDateTime:
+            return STARTS_WITH(pszFormat, "tsm:");
+        case OFTIntegerList:
+        case OFTInteger64List:
+        case OFTRealList:
+        case OFTStringList:
+        case OFTWideStringList:
+        {
+            if( strcmp(pszFormat, "+l") != 0 || psSchema->n_children != 1 )
+                return false;
+            const char* pszItemFormat = psSchema->children[0]->format;
+            const OGRFieldType eType = poFieldDefn->GetType();
+            if( eType == OFTStringList || eType == OFTWideStringList )
+                return strcmp(pszItemFormat, "u") == 0;
+            return IsNumeric(pszItemFormat);
+        }
+    }
+    return false;
+}
+
+// Whether the metadata of psSchema has ARROW:extension:name=ogc.wkb
+static bool OGRArrowIsWKBExtension(const struct ArrowSchema* psSchema)
+{
+    const char* pabyMetadata = psSchema->metadata;
+    if( pabyMetadata == nullptr )
+        return false;
+    int32_t nCount = 0;
+    memcpy(&nCount, pabyMetadata, sizeof(int32_t));
+    size_t nOffset = sizeof(int32_t);
+    for( int32_t i = 0; i < nCount; ++i )
+    {
+        int32_t nKeyLen = 0;
+        memcpy(&nKeyLen, pabyMetadata + nOffset, sizeof(int32_t));
+        const char* pszKey = pabyMetadata + nOffset + sizeof(int32_t);
+        nOffset += sizeof(int32_t) + nKeyLen;
+        int32_t nValueLen = 0;
+        memcpy(&nValueLen, pabyMetadata + nOffset, sizeof(int32_t));
+        const char* pszValue = pabyMetadata + nOffset + sizeof(int32_t);
+        nOffset += sizeof(int32_t) + nValueLen;
+        if( std::string(pszKey, nKeyLen) == "ARROW:extension:name" &&
+            std::string(pszValue, nValueLen) == "ogc.wkb" )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Associate each child of a struct array passed to WriteArrowBatch()
+ * with the FID, a field or a geometry field of the layer.
+ *
+ * Children are matched by name, with the conventions of GetArrowStream().
+ * A WKB column that matches no field name is associated with the geometry
+ * field of layers that have a single one.
+ * Emits a CPLError() and returns false if a child cannot be matched.
+ */
+bool OGRArrowGetColumnMapping(OGRLayer* poLayer,
+                              const struct ArrowSchema* schema,
+                              const struct ArrowArray* array,
+                              std::vector<OGRArrowColumnMapping>& aoMapping)
+{
+    aoMapping.clear();
+    if( schema == nullptr || array == nullptr ||
+        strcmp(schema->format, "+s") != 0 ||
+        schema->n_children != array->n_children )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "WriteArrowBatch(): a struct array whose schema matches "
+                 "it is expected");
+        return false;
+    }
+
+    OGRFeatureDefn* poLayerDefn = poLayer->GetLayerDefn();
+    const char* pszFIDName = poLayer->GetFIDColumn();
+    for( int64_t i = 0; i < schema->n_children; ++i )
+    {
+        const struct ArrowSchema* psChild = schema->children[i];
+        const char* pszName = psChild->name ? psChild->name : "";
+        OGRArrowColumnMapping oMapping;
+        if( (strcmp(psChild->format, "l") == 0 ||
+             strcmp(psChild->format, "i") == 0) &&
+            EQUAL(pszName, pszFIDName[0] ? pszFIDName : "OGC_FID") )
+        {
+            oMapping.eKind = OAC_FID;
+        }
+        else if( (oMapping.iField =
+                    poLayerDefn->GetFieldIndex(pszName)) >= 0 )
+        {
+            oMapping.eKind = OAC_FIELD;
+            if( !OGRArrowIsFormatCompatible(
+                    poLayerDefn->GetFieldDefn(oMapping.iField), psChild) )
+            {
+                CPLError(CE_Failure, CPLE_NotSupported,
+                         "WriteArrowBatch(): format '%s' of column '%s' is "
+                         "not compatible with the type of the field",
+                         psChild->format, pszName);
+                return false;
+            }
+        }
+        else
+        {
+            oMapping.eKind = OAC_GEOM_FIELD;
+            oMapping.iField = poLayerDefn->GetGeomFieldIndex(pszName);
+            if( oMapping.iField < 0 && poLayerDefn->GetGeomFieldCount() == 1 &&
+                (OGRArrowIsWKBExtension(psChild) ||
+                 (EQUAL(pszName, "wkb_geometry") &&
+                  poLayerDefn->GetGeomFieldDefn(0)->GetNameRef()[0] == 0)) )
+            {
+                oMapping.iField = 0;
+            }
+            if( oMapping.iField < 0 )
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "WriteArrowBatch(): column '%s' does not match a "
+                         "field of the layer", pszName);
+                return false;
+            }
+            if( strcmp(psChild->format, "z") != 0 )
+            {
+                CPLError(CE_Failure, CPLE_NotSupported,
+                         "WriteArrowBatch(): geometry column '%s' should be "
+                         "a WKB binary column", pszName);
+                return false;
+            }
+        }
+        aoMapping.push_back(oMapping);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                          WriteArrowBatch()                           */
+/************************************************************************/
+
+/** Write a batch of features, provided as an Arrow C data interface struct
+ * array, to the layer.
+ *
+ * The children of the struct array are matched by name with the FID column
+ * (GetFIDColumn(), or "OGC_FID" if empty), the attribute fields and the
+ * geometry fields of the layer. This is the layout returned by
+ * GetArrowStream(), so the arrays of a stream opened on a layer with the
+ * same fields can be directly written. Geometries must be encoded as
+ * WKB binary columns. For layers with a single geometry field, a geometry
+ * column with the "ogc.wkb" extension name, or named "wkb_geometry" when the
+ * geometry field has no name, is also accepted whatever its name. Fields of
+ * the layer absent from the batch are left unset.
+ *
+ * The default implementation creates a OGRFeature for each row and
+ * calls CreateFeature(). Drivers can override it with a faster
+ * implementation that bypasses OGRFeature objects.
+ *
+ * The ownership of schema and array remains with the caller, and they are
+ * not released by this method.
+ *
+ * This method is the same as the C function OGR_L_WriteArrowBatch().
+ *
+ * @param schema Schema of the struct array.
+ * @param array Struct array whose rows are written as new features.
+ * @param papszOptions NULL terminated list of key=value options. None
+ *                     currently.
+ * @return true in case of success.
+ * @since GDAL 3.4
+ */
+bool OGRLayer::WriteArrowBatch(const struct ArrowSchema* schema,
+                               const struct ArrowArray* array,
+                               CSLConstList /* papszOptions */)
+{
+    std::vector<OGRArrowColumnMapping> aoMapping;
+    if( !OGRArrowGetColumnMapping(this, schema, array, aoMapping) )
+        return false;
+
+    OGRFeatureDefn* poLayerDefn = GetLayerDefn();
+    const int64_t nRows = array->length;
+    for( int64_t iRow = 0; iRow < nRows; ++iRow )
+    {
+        OGRFeature oFeature(poLayerDefn);
+        for( size_t iCol = 0; iCol < aoMapping.size(); ++iCol )
+        {
+            const struct ArrowSchema* psSchema = schema->children[iCol];
+            const struct ArrowArray* psArray = array->children[iCol];
+            const int64_t iSubRow = iRow + array->offset;
+            if( OGRArrowIsNull(psArray, iSubRow) )
+            {
+                if( aoMapping[iCol].eKind == OAC_FIELD )
+                    oFeature.SetFieldNull(aoMapping[iCol].iField);
+                continue;
+            }
+            const int iField = aoMapping[iCol].iField;
+            const char* pszFormat = psSchema->format;
+            if( aoMapping[iCol].eKind == OAC_FID )
+            {
+                oFeature.SetFID(
+                    OGRArrowGetInteger(psArray, pszFormat, iSubRow));
+                continue;
+            }
+            if( aoMapping[iCol].eKind == OAC_GEOM_FIELD )
+            {
+                size_t nSize = 0;
+                const GByte* pabyWkb =
+                    OGRArrowGetBinary(psArray, iSubRow, nSize);
+                OGRGeometry* poGeom = nullptr;
+                if( OGRGeometryFactory::createFromWkb(
+                        pabyWkb, nullptr, &poGeom, nSize) != OGRERR_NONE )
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "WriteArrowBatch(): invalid WKB geometry at "
+                             "row " CPL_FRMT_GIB, static_cast<GIntBig>(iRow));
+                    return false;
+                }
+                poGeom->assignSpatialReference(
+                    poLayerDefn->GetGeomFieldDefn(iField)->GetSpatialRef());
+                oFeature.SetGeomFieldDirectly(iField, poGeom);
+                continue;
+            }
+
+            switch( poLayerDefn->GetFieldDefn(iField)->GetType() )
+            {
+                case OFTInteger:
+                case OFTInteger64:
+                    oFeature.SetField(iField,
+                        OGRArrowGetInteger(psArray, pszFormat, iSubRow));
+                    break;
+
+                case OFTReal:
+                    oFeature.SetField(iField,
+                        OGRArrowGetReal(psArray, pszFormat, iSubRow));
+                    break;
+
+                case OFTString:
+                case OFTWideString:
+                {
+                    size_t nSize = 0;
+                    const GByte* pabyData =
+                        OGRArrowGetBinary(psArray, iSubRow, nSize);
+                    oFeature.SetField(iField, std::string(
+                        reinterpret_cast<const char*>(pabyData),
+                        nSize).c_str());
+                    break;
+                }
+
+                case OFTBinary:
+                {
+                    size_t nSize = 0;
+                    const GByte* pabyData =
+                        OGRArrowGetBinary(psArray, iSubRow, nSize);
+                    oFeature.SetField(iField, static_cast<int>(nSize),
+                                      pabyData);
+                    break;
+                }
+
+                case OFTDate:
+                case OFTTime:
+                case OFTDateTime:
+                {
+                    const int64_t i = iSubRow + psArray->offset;
+                    GIntBig nMilliSec;
+                    if( pszFormat[1] == 'd' )
+                        nMilliSec = static_cast<GIntBig>(
+                            static_cast<const int32_t*>(
+                                psArray->buffers[1])[i]) * 86400 * 1000;
+                    else if( pszFormat[1] == 't' )
+                        nMilliSec = static_cast<const int32_t*>(
+                            psArray->buffers[1])[i];
+                    else
+                        nMilliSec = static_cast<const int64_t*>(
+                            psArray->buffers[1])[i];
+                    // Floor division, for dates before 1970.
+                    GIntBig nSec = nMilliSec / 1000;
+                    int nMilli = static_cast<int>(nMilliSec % 1000);
+                    if( nMilli < 0 )
+                    {
+                        nSec--;
+                        nMilli += 1000;
+                    }
+                    struct tm brokenDown;
+                    CPLUnixTimeToYMDHMS(nSec, &brokenDown);
+                    oFeature.SetField(iField,
+                        brokenDown.tm_year + 1900, brokenDown.tm_mon + 1,
+                        brokenDown.tm_mday, brokenDown.tm_hour,
+                        brokenDown.tm_min,
+                        static_cast<float>(brokenDown.tm_sec + nMilli / 1000.0),
+                        0);
+                    break;
+                }
+
+                case OFTIntegerList:
+                case OFTInteger64List:
+                case OFTRealList:
+                case OFTStringList:
+                case OFTWideStringList:
+                {
+                    const int32_t* panOffsets =
+                        static_cast<const int32_t*>(psArray->buffers[1]) +
+                        psArray->offset;
+                    const struct ArrowArray* psItems = psArray->children[0];
+                    const char* pszItemFormat =
+                        psSchema->children[0]->format;
+                    const int32_t nStart = panOffsets[iSubRow];
+                    const int nCount = panOffsets[iSubRow + 1] - nStart;
+                    const OGRFieldType eType =
+                        poLayerDefn->GetFieldDefn(iField)->GetType();
+                    if( eType == OFTIntegerList )
+                    {
+                        std::vector<int> anValues;
+                        for( int j = 0; j < nCount; ++j )
+                            anValues.push_back(static_cast<int>(
+                                OGRArrowGetInteger(psItems, pszItemFormat,
+                                                   nStart + j)));
+                        oFeature.SetField(iField, nCount, anValues.data());
+                    }
+                    else if( eType == OFTInteger64List )
+                    {
+                        std::vector<GIntBig> anValues;
+                        for( int j = 0; j < nCount; ++j )
+                            anValues.push_back(OGRArrowGetInteger(
+                                psItems, pszItemFormat, nStart + j));
+                        oFeature.SetField(iField, nCount, anValues.data());
+                    }
+                    else if( eType == OFTRealList )
+                    {
+                        std::vector<double> adfValues;
+                        for( int j = 0; j < nCount; ++j )
+                            adfValues.push_back(OGRArrowGetReal(
+                                psItems, pszItemFormat, nStart + j));
+                        oFeature.SetField(iField, nCount, adfValues.data());
+                    }
+                    else
+                    {
+                        CPLStringList aosValues;
+                        for( int j = 0; j < nCount; ++j )
+                        {
+                            size_t nSize = 0;
+                            const GByte* pabyData =
+                                OGRArrowGetBinary(psItems, nStart + j, nSize);
+                            aosValues.AddString(std::string(
+                                reinterpret_cast<const char*>(pabyData),
+                                nSize).c_str());
+                        }
+                        oFeature.SetField(iField, aosValues.List());
+                    }
+                    break;
+                }
+            }
+        }
+        if( CreateFeature(&oFeature) != OGRERR_NONE )
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                       OGR_L_WriteArrowBatch()                        */
+/************************************************************************/
+
+/** Write a batch of features, provided as an Arrow C data interface struct
+ * array, to the layer.
+ *
+ * This function is the same as the C++ method OGRLayer::WriteArrowBatch(),
+ * to which its documentation refers.
+ *
+ * @param hLayer Layer.
+ * @param schema Schema of the struct array.
+ * @param array Struct array whose rows are written as new features.
+ * @param papszOptions NULL terminated list of key=value options. None
+ *                     currently.
+ * @return true in case of success.
+ * @since GDAL 3.4
+ */
+bool OGR_L_WriteArrowBatch(OGRLayerH hLayer,
+                           const struct ArrowSchema* schema,
+                           const struct ArrowArray* array,
+                           char** papszOptions)
+{
+    VALIDATE_POINTER1( hLayer, "OGR_L_WriteArrowBatch", false );
+    VALIDATE_POINTER1( schema, "OGR_L_WriteArrowBatch", false );
+    VALIDATE_POINTER1( array, "OGR_L_WriteArrowBatch", false );
+
+    return OGRLayer::FromHandle(hLayer)->WriteArrowBatch(schema, array,
+                                                         papszOptions);
+}
+
+/************************************************************************/
+/*                           GetMemoryUsage()                           */
+/************************************************************************/
+
+/**
+ * \brief Return an estimate of the memory owned by the layer.
+ *
+ * This is the number of bytes of the buffers, caches and in-memory features
+ * held by the layer. Memory shared by all layers of a dataset, such as a
+ * database page cache, is reported by GDALDataset::GetDriverMemoryUsage()
+ * instead. The value is approximate and meant for capacity planning and
+ * diagnostics.
+ *
+ * The default implementation returns 0.
+ *
+ * This method is the same as the C function OGR_L_GetMemoryUsage().
+ *
+ * @return number of bytes.
+ * @since GDAL 3.4
+ */
+
+GIntBig OGRLayer::GetMemoryUsage()
+{
+    return 0;
+}
+
+/************************************************************************/
+/*                        OGR_L_GetMemoryUsage()                        */
+/************************************************************************/
+
+/**
+ * \brief Return an estimate of the memory owned by the layer.
+ *
+ * This function is the same as the C++ method OGRLayer::GetMemoryUsage().
+ *
+ * @param hLayer Layer.
+ * @return number of bytes.
+ * @since GDAL 3.4
+ */
+
+GIntBig OGR_L_GetMemoryUsage( OGRLayerH hLayer )
+{
+    VALIDATE_POINTER1( hLayer, "OGR_L_GetMemoryUsage", 0 );
+
+    return OGRLayer::FromHandle(hLayer)->GetMemoryUsage();
+}
@@ -55,6 +55,56 @@ OGRWarpedLayer::OGRWarpedLayer( OGRLayer* poDecoratedLayer,
     {
         m_poSRS->Reference();
     }
+
+    SetGeometryCacheSize(
+        atoi(CPLGetConfigOption("OGR_WARPED_LAYER_GEOM_CACHE_SIZE", "0")));
+}
+
+/************************************************************************/
+/*                        SetGeometryCacheSize()                        */
+/*                                                                      */
+/*      Enable (nMaxFeatures > 0) or disable the cache of warped        */
+/*      geometries. When enabled, the warped envelopes of up to 16      */
+/*      times more features are also remembered, so that features       */
+/*      known to be outside of the spatial filter are discarded without */
+/*      being reprojected again.                                        */
+/************************************************************************/
+
+void OGRWarpedLayer::SetGeometryCacheSize(int nMaxFeatures)
+{
+    m_oMapWarpedEnvelopes.clear();
+    if( nMaxFeatures <= 0 )
+    {
+        m_poGeomCache.reset();
+        m_nMaxWarpedEnvelopes = 0;
+        return;
+    }
+    m_poGeomCache.reset(new lru11::Cache<GIntBig, CachedGeometry>(
+        static_cast<size_t>(nMaxFeatures), 0));
+    m_nMaxWarpedEnvelopes = static_cast<size_t>(nMaxFeatures) * 16;
+}
+
+/************************************************************************/
+/*                      InvalidateCachedGeometry()                      */
+/************************************************************************/
+
+void OGRWarpedLayer::InvalidateCachedGeometry(GIntBig nFID)
+{
+    if( m_poGeomCache )
+    {
+        m_poGeomCache->remove(nFID);
+        m_oMapWarpedEnvelopes.erase(nFID);
+    }
+}
+
+/************************************************************************/
+/*                          IsSameEnvelope()                            */
+/************************************************************************/
+
+static bool IsSameEnvelope(const OGREnvelope& sA, const OGREnvelope& sB)
+{
+    return sA.MinX == sB.MinX && sA.MinY == sB.MinY &&
+           sA.MaxX == sB.MaxX && sA.MaxY == sB.MaxY;
 }
 
 /************************************************************************/
@@ -127,18 +177,32 @@ void OGRWarpedLayer::SetSpatialFilter( int iGeomField, OGRGeometry *poGeom )
                                                         sEnvelope.MaxX,
                                                         sEnvelope.MaxY);
             }
-            else if( ReprojectEnvelope(&sEnvelope, m_poReversedCT) )
-            {
-                m_poDecoratedLayer->SetSpatialFilterRect(m_iGeomFieldFilter,
-                                                        sEnvelope.MinX,
-                                                        sEnvelope.MinY,
-                                                        sEnvelope.MaxX,
-                                                        sEnvelope.MaxY);
-            }
             else
             {
-                m_poDecoratedLayer->SetSpatialFilter(m_iGeomFieldFilter,
-                                                    nullptr);
+                // Repeated queries with the same filter are common: avoid
+                // reprojecting the envelope again.
+                if( !m_sLastFilterEnvelope.IsInit() ||
+                    !IsSameEnvelope(sEnvelope, m_sLastFilterEnvelope) )
+                {
+                    m_sLastFilterEnvelope = sEnvelope;
+                    m_bLastFilterReprojectionOK =
+                        CPL_TO_BOOL(ReprojectEnvelope(&sEnvelope, m_poReversedCT));
+                    m_sLastReprojectedFilterEnvelope = sEnvelope;
+                }
+
+                if( m_bLastFilterReprojectionOK )
+                {
+                    m_poDecoratedLayer->SetSpatialFilterRect(m_iGeomFieldFilter,
+                                        m_sLastReprojectedFilterEnvelope.MinX,
+                                        m_sLastReprojectedFilterEnvelope.MinY,
+                                        m_sLastReprojectedFilterEnvelope.MaxX,
+                                        m_sLastReprojectedFilterEnvelope.MaxY);
+                }
+                else
+                {
+                    m_poDecoratedLayer->SetSpatialFilter(m_iGeomFieldFilter,
+                                                        nullptr);
+                }
             }
         }
     }
@@ -173,14 +237,83 @@ OGRFeature *OGRWarpedLayer::SrcFeatureToWarpedFeature(OGRFeature* poSrcFeature)
     if( poGeom == nullptr )
         return poFeature;
 
+    const GIntBig nFID = poFeature->GetFID();
+    if( !m_poGeomCache || nFID == OGRNullFID )
+    {
+        if( poGeom->transform(m_poCT) != OGRERR_NONE )
+        {
+            delete poFeature->StealGeometry(m_iGeomField);
+        }
+        return poFeature;
+    }
+
+    CachedGeometry sEntry;
+    OGREnvelope sSrcEnvelope;
+    poGeom->getEnvelope(&sSrcEnvelope);
+    if( m_poGeomCache->tryGet(nFID, sEntry) &&
+        IsSameEnvelope(sEntry.sSrcEnvelope, sSrcEnvelope) )
+    {
+        if( sEntry.poWarpedGeom )
+            poFeature->SetGeomField(m_iGeomField, sEntry.poWarpedGeom.get());
+        else
+            delete poFeature->StealGeometry(m_iGeomField);
+        return poFeature;
+    }
+
+    sEntry.sSrcEnvelope = sSrcEnvelope;
     if( poGeom->transform(m_poCT) != OGRERR_NONE )
     {
         delete poFeature->StealGeometry(m_iGeomField);
+        sEntry.poWarpedGeom.reset();
     }
+    else
+    {
+        sEntry.poWarpedGeom.reset(poGeom->clone());
+
+        IndexedEnvelope sIndexed;
+        sIndexed.sSrcEnvelope = sSrcEnvelope;
+        poGeom->getEnvelope(&sIndexed.sWarpedEnvelope);
+        if( m_oMapWarpedEnvelopes.size() < m_nMaxWarpedEnvelopes ||
+            m_oMapWarpedEnvelopes.find(nFID) != m_oMapWarpedEnvelopes.end() )
+        {
+            m_oMapWarpedEnvelopes[nFID] = sIndexed;
+        }
+    }
+    m_poGeomCache->insert(nFID, sEntry);
 
     return poFeature;
 }
 
+/************************************************************************/
+/*                      IsKnownToBeFilteredOut()                        */
+/*                                                                      */
+/*      Use the index of warped envelopes to discard, without           */
+/*      reprojecting it, a source feature that has already been seen    */
+/*      and whose warped envelope does not intersect the filter.        */
+/************************************************************************/
+
+bool OGRWarpedLayer::IsKnownToBeFilteredOut(OGRFeature* poSrcFeature)
+{
+    if( m_oMapWarpedEnvelopes.empty() || m_poFilterGeom == nullptr ||
+        m_iGeomFieldFilter != m_iGeomField )
+        return false;
+
+    const OGRGeometry* poSrcGeom = poSrcFeature->GetGeomFieldRef(m_iGeomField);
+    if( poSrcGeom == nullptr )
+        return false;
+
+    const auto oIter = m_oMapWarpedEnvelopes.find(poSrcFeature->GetFID());
+    if( oIter == m_oMapWarpedEnvelopes.end() )
+        return false;
+
+    OGREnvelope sSrcEnvelope;
+    poSrcGeom->getEnvelope(&sSrcEnvelope);
+    if( !IsSameEnvelope(oIter->second.sSrcEnvelope, sSrcEnvelope) )
+        return false;
+
+    return !oIter->second.sWarpedEnvelope.Intersects(m_sFilterEnvelope);
+}
+
 /************************************************************************/
 /*                     WarpedFeatureToSrcFeature()                      */
 /************************************************************************/
@@ -222,6 +355,12 @@ OGRFeature *OGRWarpedLayer::GetNextFeature()
         if( poFeature == nullptr )
             return nullptr;
 
+        if( IsKnownToBeFilteredOut(poFeature) )
+        {
+            delete poFeature;
+            continue;
+        }
+
         OGRFeature* poFeatureNew = SrcFeatureToWarpedFeature(poFeature);
         delete poFeature;
 
@@ -264,6 +403,8 @@ OGRErr      OGRWarpedLayer::ISetFeature( OGRFeature *poFeature )
     if( poFeatureNew == nullptr )
         return OGRERR_FAILURE;
 
+    InvalidateCachedGeometry(poFeature->GetFID());
+
     eErr = m_poDecoratedLayer->SetFeature(poFeatureNew);
 
     delete poFeatureNew;
@@ -284,12 +425,24 @@ OGRErr      OGRWarpedLayer::ICreateFeature( OGRFeature *poFeature )
         return OGRERR_FAILURE;
 
     eErr = m_poDecoratedLayer->CreateFeature(poFeatureNew);
+    if( eErr == OGRERR_NONE )
+        InvalidateCachedGeometry(poFeatureNew->GetFID());
 
     delete poFeatureNew;
 
     return eErr;
 }
 
+/************************************************************************/
+/*                            DeleteFeature()                           */
+/************************************************************************/
+
+OGRErr      OGRWarpedLayer::DeleteFeature( GIntBig nFID )
+{
+    InvalidateCachedGeometry(nFID);
+    return m_poDecoratedLayer->DeleteFeature(nFID);
+}
+
 /************************************************************************/
 /*                            GetLayerDefn()                           */
 /************************************************************************/
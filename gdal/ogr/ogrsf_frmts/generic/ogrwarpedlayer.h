@@ -33,6 +33,10 @@
 #ifndef DOXYGEN_SKIP
 
 #include "ogrlayerdecorator.h"
+#include "cpl_mem_cache.h"
+
+#include <memory>
+#include <unordered_map>
 
 /************************************************************************/
 /*                           OGRWarpedLayer                             */
@@ -52,9 +56,33 @@ class OGRWarpedLayer : public OGRLayerDecorator
 
       OGREnvelope                  sStaticEnvelope{};
 
+      // Optional cache of warped geometries, indexed by FID. The source
+      // envelope is kept to detect features modified behind our back.
+      struct CachedGeometry
+      {
+          OGREnvelope                   sSrcEnvelope{};
+          std::shared_ptr<OGRGeometry>  poWarpedGeom{}; /* null if failed */
+      };
+      struct IndexedEnvelope
+      {
+          OGREnvelope                   sSrcEnvelope{};
+          OGREnvelope                   sWarpedEnvelope{};
+      };
+      std::unique_ptr<lru11::Cache<GIntBig, CachedGeometry>> m_poGeomCache{};
+      std::unordered_map<GIntBig, IndexedEnvelope> m_oMapWarpedEnvelopes{};
+      size_t                       m_nMaxWarpedEnvelopes = 0;
+
+      // Last spatial filter envelope and its reprojection in the source SRS.
+      OGREnvelope                  m_sLastFilterEnvelope{};
+      OGREnvelope                  m_sLastReprojectedFilterEnvelope{};
+      bool                         m_bLastFilterReprojectionOK = false;
+
       static int ReprojectEnvelope( OGREnvelope* psEnvelope,
                                     OGRCoordinateTransformation* poCT );
 
+      bool                         IsKnownToBeFilteredOut(OGRFeature* poSrcFeature);
+      void                         InvalidateCachedGeometry(GIntBig nFID);
+
       OGRFeature *                 SrcFeatureToWarpedFeature(OGRFeature* poFeature);
       OGRFeature *                 WarpedFeatureToSrcFeature(OGRFeature* poFeature);
 
@@ -68,6 +96,7 @@ class OGRWarpedLayer : public OGRLayerDecorator
     virtual           ~OGRWarpedLayer();
 
     void                SetExtent(double dfXMin, double dfYMin, double dfXMax, double dfYMax);
+    void                SetGeometryCacheSize(int nMaxFeatures);
 
     virtual void        SetSpatialFilter( OGRGeometry * ) override;
     virtual void        SetSpatialFilterRect( double dfMinX, double dfMinY,
@@ -80,6 +109,7 @@ class OGRWarpedLayer : public OGRLayerDecorator
     virtual OGRFeature *GetFeature( GIntBig nFID ) override;
     virtual OGRErr      ISetFeature( OGRFeature *poFeature ) override;
     virtual OGRErr      ICreateFeature( OGRFeature *poFeature ) override;
+    virtual OGRErr      DeleteFeature( GIntBig nFID ) override;
 
     virtual OGRFeatureDefn *GetLayerDefn() override;
 
@@ -41,6 +41,11 @@
 #include "cpl_json_streaming_parser.h"
 #include "ogr_api.h"
 
+#include <climits>
+#include <limits>
+#include <memory>
+#include <vector>
+
 CPL_CVSID("$Id$")
 
 static
@@ -67,6 +72,355 @@ const size_t ESTIMATE_OBJECT_SIZE = ESTIMATE_BASE_OBJECT_SIZE +
                     sizeof(struct lh_table) +
                     JSON_OBJECT_DEF_HASH_ENTRIES * ESTIMATE_OBJECT_ELT_SIZE;
 
+// Tokens used to store the structure of the "coordinates" member of
+// geometries when reading them without json-c objects.
+constexpr GByte COORD_TOKEN_START_ARRAY = 0;
+constexpr GByte COORD_TOKEN_END_ARRAY = 1;
+constexpr GByte COORD_TOKEN_NUMBER = 2;
+
+/************************************************************************/
+/*                      OGRGeoJSONNewNumberObject()                     */
+/************************************************************************/
+
+static json_object* OGRGeoJSONNewNumberObject(const char* pszValue,
+                                              size_t nLen)
+{
+    if( CPLGetValueType(pszValue) == CPL_VALUE_REAL )
+    {
+        return json_object_new_double(CPLAtof(pszValue));
+    }
+    else if( nLen == strlen("Infinity") && EQUAL(pszValue, "Infinity") )
+    {
+        return json_object_new_double(
+            std::numeric_limits<double>::infinity());
+    }
+    else if( nLen == strlen("-Infinity") && EQUAL(pszValue, "-Infinity") )
+    {
+        return json_object_new_double(
+            -std::numeric_limits<double>::infinity());
+    }
+    else if( nLen == strlen("NaN") && EQUAL(pszValue, "NaN") )
+    {
+        return json_object_new_double(
+            std::numeric_limits<double>::quiet_NaN());
+    }
+    else
+    {
+        return json_object_new_int64(CPLAtoGIntBig(pszValue));
+    }
+}
+
+/************************************************************************/
+/*                        OGRGeoJSONParseNumber()                       */
+/************************************************************************/
+
+/* Returns the same value as json_object_get_double() on the object that */
+/* OGRGeoJSONNewNumberObject() would create. */
+static double OGRGeoJSONParseNumber(const char* pszValue, size_t nLen)
+{
+    // Fast path for decimal numbers whose significand fits on 53 bits and
+    // with a small power of ten, for which the result of a single
+    // multiplication or division is correctly rounded, hence identical to
+    // what CPLAtof() returns.
+    static const double adfPow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    const char* pszIter = pszValue;
+    const char* const pszEnd = pszValue + nLen;
+    const bool bNegative = pszIter < pszEnd && *pszIter == '-';
+    if( bNegative )
+        pszIter ++;
+    GUInt64 nSignificand = 0;
+    int nDigits = 0;
+    int nExp10 = 0;
+    bool bIsInteger = true;
+    bool bValid = pszIter < pszEnd && *pszIter >= '0' && *pszIter <= '9';
+    for( ; pszIter < pszEnd && *pszIter >= '0' && *pszIter <= '9'; pszIter++ )
+    {
+        nSignificand = nSignificand * 10 + (*pszIter - '0');
+        if( nSignificand != 0 )
+            nDigits ++;
+    }
+    if( pszIter < pszEnd && *pszIter == '.' )
+    {
+        pszIter ++;
+        bIsInteger = false;
+        bValid &= pszIter < pszEnd && *pszIter >= '0' && *pszIter <= '9';
+        for( ; pszIter < pszEnd && *pszIter >= '0' && *pszIter <= '9';
+               pszIter++ )
+        {
+            nSignificand = nSignificand * 10 + (*pszIter - '0');
+            if( nSignificand != 0 )
+                nDigits ++;
+            nExp10 --;
+        }
+    }
+    if( pszIter < pszEnd && (*pszIter == 'e' || *pszIter == 'E') )
+    {
+        pszIter ++;
+        bIsInteger = false;
+        const bool bNegativeExp = pszIter < pszEnd && *pszIter == '-';
+        if( pszIter < pszEnd && (*pszIter == '-' || *pszIter == '+') )
+            pszIter ++;
+        bValid &= pszIter < pszEnd && *pszIter >= '0' && *pszIter <= '9';
+        int nExp = 0;
+        for( ; pszIter < pszEnd && *pszIter >= '0' && *pszIter <= '9' &&
+               nExp < 1000; pszIter++ )
+        {
+            nExp = nExp * 10 + (*pszIter - '0');
+        }
+        nExp10 += bNegativeExp ? -nExp : nExp;
+    }
+    if( bValid && pszIter == pszEnd && nDigits <= 15 &&
+        nExp10 >= -22 && nExp10 <= 22 )
+    {
+        double dfVal = static_cast<double>(nSignificand);
+        if( nExp10 < 0 )
+            dfVal /= adfPow10[-nExp10];
+        else
+            dfVal *= adfPow10[nExp10];
+        // Integers are converted from a 64 bit integer, hence no -0
+        return (bNegative && !(bIsInteger && nSignificand == 0)) ?
+                                                            -dfVal : dfVal;
+    }
+
+    if( CPLGetValueType(pszValue) == CPL_VALUE_REAL )
+        return CPLAtof(pszValue);
+    else if( nLen == strlen("Infinity") && EQUAL(pszValue, "Infinity") )
+        return std::numeric_limits<double>::infinity();
+    else if( nLen == strlen("-Infinity") && EQUAL(pszValue, "-Infinity") )
+        return -std::numeric_limits<double>::infinity();
+    else if( nLen == strlen("NaN") && EQUAL(pszValue, "NaN") )
+        return std::numeric_limits<double>::quiet_NaN();
+    else
+        return static_cast<double>(CPLAtoGIntBig(pszValue));
+}
+
+/************************************************************************/
+/*                      OGRGeoJSONBuildPosition()                       */
+/************************************************************************/
+
+/* Reads a position from the coordinate tokens at iToken. Only the first */
+/* 3 ordinates are used, as in OGRGeoJSONReadRawPoint(). */
+static bool OGRGeoJSONBuildPosition( const std::vector<GByte>& abyTokens,
+                                     const std::vector<double>& adfValues,
+                                     size_t& iToken, size_t& iValue,
+                                     double adfXYZ[3], bool& b3D )
+{
+    if( iToken >= abyTokens.size() ||
+        abyTokens[iToken] != COORD_TOKEN_START_ARRAY )
+        return false;
+    iToken ++;
+    int nDim = 0;
+    while( iToken < abyTokens.size() &&
+           abyTokens[iToken] == COORD_TOKEN_NUMBER )
+    {
+        if( nDim < GeoJSONObject::eMaxCoordinateDimension )
+            adfXYZ[nDim] = adfValues[iValue];
+        nDim ++;
+        iToken ++;
+        iValue ++;
+    }
+    if( iToken >= abyTokens.size() ||
+        abyTokens[iToken] != COORD_TOKEN_END_ARRAY ||
+        nDim < GeoJSONObject::eMinCoordinateDimension )
+        return false;
+    iToken ++;
+    b3D = nDim >= GeoJSONObject::eMaxCoordinateDimension;
+    return true;
+}
+
+/************************************************************************/
+/*                       OGRGeoJSONBuildCurve()                         */
+/************************************************************************/
+
+/* Reads a non-empty array of positions from the coordinate tokens at */
+/* iToken. */
+static bool OGRGeoJSONBuildCurve( const std::vector<GByte>& abyTokens,
+                                  const std::vector<double>& adfValues,
+                                  size_t& iToken, size_t& iValue,
+                                  OGRSimpleCurve* poCurve )
+{
+    if( iToken >= abyTokens.size() ||
+        abyTokens[iToken] != COORD_TOKEN_START_ARRAY )
+        return false;
+    iToken ++;
+    std::vector<OGRRawPoint> asPoints;
+    std::vector<double> adfZ;
+    bool bCurve3D = false;
+    while( iToken < abyTokens.size() &&
+           abyTokens[iToken] == COORD_TOKEN_START_ARRAY )
+    {
+        double adfXYZ[3] = { 0.0, 0.0, 0.0 };
+        bool b3D = false;
+        if( !OGRGeoJSONBuildPosition(abyTokens, adfValues, iToken, iValue,
+                                     adfXYZ, b3D) )
+            return false;
+        asPoints.push_back(OGRRawPoint(adfXYZ[0], adfXYZ[1]));
+        adfZ.push_back(adfXYZ[2]);
+        bCurve3D |= b3D;
+    }
+    if( iToken >= abyTokens.size() ||
+        abyTokens[iToken] != COORD_TOKEN_END_ARRAY || asPoints.empty() )
+        return false;
+    iToken ++;
+    // Like OGRGeoJSONReadLineString(), 2D positions get a zero Z when
+    // mixed with 3D ones.
+    poCurve->setPoints(static_cast<int>(asPoints.size()), asPoints.data(),
+                       bCurve3D ? adfZ.data() : nullptr);
+    return true;
+}
+
+/************************************************************************/
+/*                      OGRGeoJSONBuildPolygon()                        */
+/************************************************************************/
+
+static bool OGRGeoJSONBuildPolygon( const std::vector<GByte>& abyTokens,
+                                    const std::vector<double>& adfValues,
+                                    size_t& iToken, size_t& iValue,
+                                    OGRPolygon* poPolygon )
+{
+    if( iToken >= abyTokens.size() ||
+        abyTokens[iToken] != COORD_TOKEN_START_ARRAY )
+        return false;
+    iToken ++;
+    while( iToken < abyTokens.size() &&
+           abyTokens[iToken] == COORD_TOKEN_START_ARRAY )
+    {
+        OGRLinearRing* poRing = new OGRLinearRing();
+        poPolygon->addRingDirectly(poRing);
+        if( !OGRGeoJSONBuildCurve(abyTokens, adfValues, iToken, iValue,
+                                  poRing) )
+            return false;
+    }
+    if( iToken >= abyTokens.size() ||
+        abyTokens[iToken] != COORD_TOKEN_END_ARRAY ||
+        poPolygon->IsEmpty() )
+        return false;
+    iToken ++;
+    return true;
+}
+
+/************************************************************************/
+/*                      OGRGeoJSONBuildGeometry()                       */
+/************************************************************************/
+
+/* Builds the geometry from the tokens of the "coordinates" member. */
+/* Returns nullptr on anything unusual (empty arrays, wrong nesting, ...) */
+/* in which case the caller must go through OGRGeoJSONReadGeometry() to */
+/* get its exact behavior. */
+static OGRGeometry* OGRGeoJSONBuildGeometry(
+                                        GeoJSONObject::Type eType,
+                                        const std::vector<GByte>& abyTokens,
+                                        const std::vector<double>& adfValues )
+{
+    size_t iToken = 0;
+    size_t iValue = 0;
+    std::unique_ptr<OGRGeometry> poGeom;
+    bool bOK = false;
+    switch( eType )
+    {
+        case GeoJSONObject::ePoint:
+        {
+            double adfXYZ[3] = { 0.0, 0.0, 0.0 };
+            bool b3D = false;
+            bOK = OGRGeoJSONBuildPosition(abyTokens, adfValues,
+                                          iToken, iValue, adfXYZ, b3D);
+            if( bOK )
+            {
+                poGeom.reset(b3D ?
+                        new OGRPoint(adfXYZ[0], adfXYZ[1], adfXYZ[2]) :
+                        new OGRPoint(adfXYZ[0], adfXYZ[1]));
+            }
+            break;
+        }
+
+        case GeoJSONObject::eLineString:
+        {
+            OGRLineString* poLS = new OGRLineString();
+            poGeom.reset(poLS);
+            bOK = OGRGeoJSONBuildCurve(abyTokens, adfValues,
+                                       iToken, iValue, poLS);
+            break;
+        }
+
+        case GeoJSONObject::ePolygon:
+        {
+            OGRPolygon* poPoly = new OGRPolygon();
+            poGeom.reset(poPoly);
+            bOK = OGRGeoJSONBuildPolygon(abyTokens, adfValues,
+                                         iToken, iValue, poPoly);
+            break;
+        }
+
+        case GeoJSONObject::eMultiPoint:
+        case GeoJSONObject::eMultiLineString:
+        case GeoJSONObject::eMultiPolygon:
+        {
+            OGRGeometryCollection* poColl =
+                eType == GeoJSONObject::eMultiPoint ?
+                    static_cast<OGRGeometryCollection*>(new OGRMultiPoint()) :
+                eType == GeoJSONObject::eMultiLineString ?
+                    static_cast<OGRGeometryCollection*>(
+                                                new OGRMultiLineString()) :
+                    static_cast<OGRGeometryCollection*>(new OGRMultiPolygon());
+            poGeom.reset(poColl);
+            if( iToken >= abyTokens.size() ||
+                abyTokens[iToken] != COORD_TOKEN_START_ARRAY )
+                break;
+            iToken ++;
+            bOK = true;
+            while( bOK && iToken < abyTokens.size() &&
+                   abyTokens[iToken] == COORD_TOKEN_START_ARRAY )
+            {
+                if( eType == GeoJSONObject::eMultiPoint )
+                {
+                    double adfXYZ[3] = { 0.0, 0.0, 0.0 };
+                    bool b3D = false;
+                    bOK = OGRGeoJSONBuildPosition(abyTokens, adfValues,
+                                                  iToken, iValue, adfXYZ, b3D);
+                    if( bOK )
+                    {
+                        poColl->addGeometryDirectly(b3D ?
+                            new OGRPoint(adfXYZ[0], adfXYZ[1], adfXYZ[2]) :
+                            new OGRPoint(adfXYZ[0], adfXYZ[1]));
+                    }
+                }
+                else if( eType == GeoJSONObject::eMultiLineString )
+                {
+                    OGRLineString* poLS = new OGRLineString();
+                    bOK = OGRGeoJSONBuildCurve(abyTokens, adfValues,
+                                               iToken, iValue, poLS);
+                    poColl->addGeometryDirectly(poLS);
+                }
+                else
+                {
+                    OGRPolygon* poPoly = new OGRPolygon();
+                    bOK = OGRGeoJSONBuildPolygon(abyTokens, adfValues,
+                                                 iToken, iValue, poPoly);
+                    poColl->addGeometryDirectly(poPoly);
+                }
+            }
+            if( !bOK || iToken >= abyTokens.size() ||
+                abyTokens[iToken] != COORD_TOKEN_END_ARRAY ||
+                poColl->getNumGeometries() == 0 )
+            {
+                bOK = false;
+                break;
+            }
+            iToken ++;
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    if( !bOK || iToken != abyTokens.size() )
+        return nullptr;
+    return poGeom.release();
+}
+
 /************************************************************************/
 /*                      OGRGeoJSONReaderStreamingParser                 */
 /************************************************************************/
@@ -104,10 +458,31 @@ class OGRGeoJSONReaderStreamingParser: public CPLJSonStreamingParser
         bool m_bStartFeature = false;
         bool m_bEndFeature = false;
 
+        // Direct translation of features to OGRFeature, without building
+        // the json-c objects for the geometry coordinates and for the
+        // scalar properties. Only used when reading features.
+        bool m_bDirectRead = false;
+        bool m_bDirectProperties = false;
+        OGRFeature* m_poCurFeature = nullptr;
+        bool m_bInProperties = false;
+        json_object* m_poCurGeomObj = nullptr;
+        bool m_bGeometryRead = false;
+        bool m_bInDirectCoordinates = false;
+        bool m_bCoordinatesInJSon = false;
+        CPLString m_osCoordinatesKey;
+        std::vector<GByte> m_abyCoordTokens;
+        std::vector<double> m_adfCoordValues;
+
         void AppendObject(json_object* poNewObj);
         void AnalyzeFeature();
         void TooComplex();
 
+        void SetDirectProperty(json_type eType, const char* pszValue,
+                               size_t nLen, bool bVal);
+        void CoordinatesToJSon();
+        void FinishDirectGeometry();
+        void ResetDirectFeature();
+
         CPL_DISALLOW_COPY_ASSIGN(OGRGeoJSONReaderStreamingParser)
 
     public:
@@ -324,6 +699,13 @@ OGRGeoJSONReaderStreamingParser::OGRGeoJSONReaderStreamingParser(
 {
     m_nMaxObjectSize = atoi(CPLGetConfigOption("OGR_GEOJSON_MAX_OBJ_SIZE", "200"))
                 * 1024 * 1024;
+
+    // The GeoCouch spatiallist format has its own way of storing
+    // properties, so go through the json-c objects for it.
+    m_bDirectRead = !bFirstPass &&
+                    !m_oReader.IsGeocouchSpatiallistFormat() &&
+                    CPLTestBool(CPLGetConfigOption("OGR_GEOJSON_DIRECT_READ",
+                                                   "YES"));
 }
 
 /************************************************************************/
@@ -338,6 +720,7 @@ OGRGeoJSONReaderStreamingParser::~OGRGeoJSONReaderStreamingParser()
         json_object_put(m_poCurObj);
     for(size_t i = 0; i < m_apoFeatures.size(); i++ )
         delete m_apoFeatures[i];
+    ResetDirectFeature();
 }
 
 /************************************************************************/
@@ -405,6 +788,217 @@ void OGRGeoJSONReaderStreamingParser::AnalyzeFeature()
     m_poLayer->IncFeatureCount();
 }
 
+/************************************************************************/
+/*                          ResetDirectFeature()                        */
+/************************************************************************/
+
+void OGRGeoJSONReaderStreamingParser::ResetDirectFeature()
+{
+    delete m_poCurFeature;
+    m_poCurFeature = nullptr;
+    m_bDirectProperties = false;
+    m_bInProperties = false;
+    if( m_poCurGeomObj )
+        json_object_put(m_poCurGeomObj);
+    m_poCurGeomObj = nullptr;
+    m_bGeometryRead = false;
+    m_bInDirectCoordinates = false;
+    m_bCoordinatesInJSon = false;
+    m_abyCoordTokens.clear();
+    m_adfCoordValues.clear();
+}
+
+/************************************************************************/
+/*                         SetDirectProperty()                          */
+/************************************************************************/
+
+/* Sets the field corresponding to the current key of the "properties" */
+/* object from a scalar value, with the same result as */
+/* OGRGeoJSONReaderSetField(), but without creating a json-c object for the */
+/* most common combinations of JSON and OGR types. */
+void OGRGeoJSONReaderStreamingParser::SetDirectProperty(json_type eType,
+                                                        const char* pszValue,
+                                                        size_t nLen,
+                                                        bool bVal)
+{
+    const char* pszKey = m_osCurKey.c_str();
+    OGRFeatureDefn* poFDefn = m_poCurFeature->GetDefnRef();
+    const int nField = poFDefn->GetFieldIndexCaseSensitive(pszKey);
+    if( nField < 0 )
+    {
+        CPLDebug("GeoJSON", "Cannot find field %s", pszKey);
+        return;
+    }
+
+    OGRFieldDefn* poFieldDefn = poFDefn->GetFieldDefn(nField);
+    const OGRFieldType eFieldType = poFieldDefn->GetType();
+    const bool bIsList = eFieldType == OFTIntegerList ||
+                         eFieldType == OFTInteger64List ||
+                         eFieldType == OFTRealList ||
+                         eFieldType == OFTStringList;
+    const bool bIsStringLike = !bIsList &&
+                               eFieldType != OFTInteger &&
+                               eFieldType != OFTInteger64 &&
+                               eFieldType != OFTReal;
+    switch( eType )
+    {
+        case json_type_null:
+            m_poCurFeature->SetFieldNull(nField);
+            return;
+
+        case json_type_string:
+            if( bIsStringLike )
+            {
+                m_poCurFeature->SetField(nField, pszValue);
+                return;
+            }
+            break;
+
+        case json_type_int:
+        {
+            const GIntBig nVal = CPLAtoGIntBig(pszValue);
+            if( eFieldType == OFTInteger || eFieldType == OFTInteger64 )
+            {
+                // Same clamping as json_object_get_int()
+                const GIntBig nFieldVal =
+                    eFieldType == OFTInteger64 ? nVal :
+                    nVal <= INT_MIN ? INT_MIN :
+                    nVal >= INT_MAX ? INT_MAX : nVal;
+                m_poCurFeature->SetField(nField, nFieldVal);
+                if( EQUAL(poFieldDefn->GetNameRef(), m_poLayer->GetFIDColumn()) )
+                    m_poCurFeature->SetFID(nFieldVal);
+                return;
+            }
+            if( eFieldType == OFTReal )
+            {
+                m_poCurFeature->SetField(nField, static_cast<double>(nVal));
+                return;
+            }
+            if( bIsStringLike )
+            {
+                m_poCurFeature->SetField(nField,
+                                         CPLSPrintf(CPL_FRMT_GIB, nVal));
+                return;
+            }
+            break;
+        }
+
+        case json_type_double:
+            if( eFieldType == OFTReal )
+            {
+                m_poCurFeature->SetField(nField,
+                                         OGRGeoJSONParseNumber(pszValue, nLen));
+                return;
+            }
+            break;
+
+        case json_type_boolean:
+            if( eFieldType == OFTInteger )
+            {
+                m_poCurFeature->SetField(nField, bVal ? 1 : 0);
+                if( EQUAL(poFieldDefn->GetNameRef(), m_poLayer->GetFIDColumn()) )
+                    m_poCurFeature->SetFID(bVal ? 1 : 0);
+                return;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    // Less common combinations: go through a temporary json-c object
+    json_object* poVal =
+        eType == json_type_string ? json_object_new_string(pszValue) :
+        eType == json_type_boolean ? json_object_new_boolean(bVal) :
+                                    OGRGeoJSONNewNumberObject(pszValue, nLen);
+    OGRGeoJSONReaderSetField(m_poLayer, m_poCurFeature, nField, pszKey,
+                             poVal, false, 0);
+    json_object_put(poVal);
+}
+
+/************************************************************************/
+/*                         CoordinatesToJSon()                          */
+/************************************************************************/
+
+/* Converts the coordinates collected so far to json-c objects attached to */
+/* the geometry object, so that the rest of the geometry goes through the */
+/* regular path. Used for content that the direct path does not handle. */
+void OGRGeoJSONReaderStreamingParser::CoordinatesToJSon()
+{
+    size_t iValue = 0;
+    const size_t nStackSize = m_apoCurObj.size();
+    for( const GByte byToken: m_abyCoordTokens )
+    {
+        if( byToken == COORD_TOKEN_START_ARRAY )
+        {
+            json_object* poNewObj = json_object_new_array();
+            if( m_apoCurObj.size() == nStackSize )
+            {
+                m_osCurKey = m_osCoordinatesKey;
+                m_bKeySet = true;
+            }
+            AppendObject(poNewObj);
+            m_apoCurObj.push_back(poNewObj);
+        }
+        else if( byToken == COORD_TOKEN_END_ARRAY )
+        {
+            m_apoCurObj.pop_back();
+        }
+        else
+        {
+            AppendObject(json_object_new_double(m_adfCoordValues[iValue]));
+            iValue ++;
+        }
+    }
+    m_abyCoordTokens.clear();
+    m_adfCoordValues.clear();
+    m_bInDirectCoordinates = false;
+    m_bCoordinatesInJSon = true;
+}
+
+/************************************************************************/
+/*                        FinishDirectGeometry()                        */
+/************************************************************************/
+
+/* Called at the end of the "geometry" object of a feature, while */
+/* m_poCurGeomObj is still at the top of m_apoCurObj. */
+void OGRGeoJSONReaderStreamingParser::FinishDirectGeometry()
+{
+    OGRGeometry* poGeometry = nullptr;
+    bool bDone = false;
+    if( !m_bCoordinatesInJSon && !m_abyCoordTokens.empty() &&
+        OGRGeoJSONFindMemberEntryByName(m_poCurGeomObj, "crs") == nullptr )
+    {
+        poGeometry = OGRGeoJSONBuildGeometry(
+            OGRGeoJSONGetType(m_poCurGeomObj),
+            m_abyCoordTokens, m_adfCoordValues);
+        if( poGeometry )
+        {
+            // Same logic as OGRGeoJSONReadGeometry()
+            OGRSpatialReference* poSRS = m_poLayer->GetSpatialRef();
+            poGeometry->assignSpatialReference(
+                poSRS ? poSRS : OGRSpatialReference::GetWGS84SRS());
+            poGeometry = m_oReader.WrapGeometryIfNeeded(poGeometry);
+            bDone = true;
+        }
+    }
+    if( !bDone )
+    {
+        if( !m_abyCoordTokens.empty() )
+            CoordinatesToJSon();
+        poGeometry = m_oReader.ReadGeometry(m_poCurGeomObj,
+                                            m_poLayer->GetSpatialRef());
+    }
+    m_poCurFeature->SetGeometryDirectly(poGeometry);
+    m_bGeometryRead = true;
+
+    json_object_put(m_poCurGeomObj);
+    m_poCurGeomObj = nullptr;
+    m_bCoordinatesInJSon = false;
+    m_abyCoordTokens.clear();
+    m_adfCoordValues.clear();
+}
+
 /************************************************************************/
 /*                            StartObject()                             */
 /************************************************************************/
@@ -427,6 +1021,11 @@ void OGRGeoJSONReaderStreamingParser::StartObject()
             m_abFirstMember.push_back(true);
         }
         m_bStartFeature = true;
+        if( m_bDirectRead )
+        {
+            ResetDirectFeature();
+            m_poCurFeature = new OGRFeature(m_poLayer->GetLayerDefn());
+        }
     }
     else if( m_poCurObj )
     {
@@ -438,8 +1037,35 @@ void OGRGeoJSONReaderStreamingParser::StartObject()
 
         m_nCurObjMemEstimate += ESTIMATE_OBJECT_SIZE;
 
+        if( m_bInDirectCoordinates )
+            CoordinatesToJSon();
+
         json_object* poNewObj = json_object_new_object();
-        AppendObject( poNewObj );
+        if( m_poCurFeature && m_nDepth == 3 && m_bKeySet &&
+            EQUAL(m_osCurKey, "geometry") )
+        {
+            // Kept out of the feature object, and translated at its end.
+            if( m_poCurGeomObj )
+                json_object_put(m_poCurGeomObj);
+            m_poCurGeomObj = poNewObj;
+            m_bCoordinatesInJSon = false;
+            m_abyCoordTokens.clear();
+            m_adfCoordValues.clear();
+            m_osCurKey.clear();
+            m_bKeySet = false;
+        }
+        else
+        {
+            if( m_poCurFeature && m_nDepth == 3 && m_bKeySet &&
+                !m_bDirectProperties && EQUAL(m_osCurKey, "properties") )
+            {
+                // Scalar properties are directly set on the feature, and
+                // only the other ones are stored in the json-c object.
+                m_bDirectProperties = true;
+                m_bInProperties = true;
+            }
+            AppendObject( poNewObj );
+        }
         m_apoCurObj.push_back( poNewObj );
     }
     else if( m_bFirstPass && m_nDepth == 0 )
@@ -493,7 +1119,11 @@ void OGRGeoJSONReaderStreamingParser::EndObject()
         else
         {
             OGRFeature* poFeat = m_oReader.ReadFeature(m_poLayer, m_poCurObj,
-                                                       m_osJson.c_str());
+                                                       m_osJson.c_str(),
+                                                       m_poCurFeature,
+                                                       m_bGeometryRead);
+            m_poCurFeature = nullptr;
+            ResetDirectFeature();
             if( poFeat )
             {
                 m_apoFeatures.push_back( poFeat );
@@ -518,6 +1148,16 @@ void OGRGeoJSONReaderStreamingParser::EndObject()
             m_osJson += "}";
         }
 
+        if( m_nDepth == 3 && m_poCurGeomObj &&
+            m_apoCurObj.back() == m_poCurGeomObj )
+        {
+            FinishDirectGeometry();
+        }
+        else if( m_nDepth == 3 && m_bInProperties )
+        {
+            m_bInProperties = false;
+        }
+
         m_apoCurObj.pop_back();
     }
     else if( m_nDepth == 1 )
@@ -606,6 +1246,31 @@ void OGRGeoJSONReaderStreamingParser::StartArray()
 
         m_nCurObjMemEstimate += ESTIMATE_ARRAY_SIZE;
 
+        if( m_bInDirectCoordinates )
+        {
+            m_abyCoordTokens.push_back(COORD_TOKEN_START_ARRAY);
+            m_nDepth ++;
+            return;
+        }
+        if( m_poCurGeomObj && m_nDepth == 4 && m_bKeySet &&
+            m_apoCurObj.back() == m_poCurGeomObj &&
+            EQUAL(m_osCurKey, "coordinates") )
+        {
+            if( m_abyCoordTokens.empty() && !m_bCoordinatesInJSon )
+            {
+                m_bInDirectCoordinates = true;
+                m_osCoordinatesKey = m_osCurKey;
+                m_osCurKey.clear();
+                m_bKeySet = false;
+                m_abyCoordTokens.push_back(COORD_TOKEN_START_ARRAY);
+                m_nDepth ++;
+                return;
+            }
+            // Several coordinates members: let OGRGeoJSONReadGeometry()
+            // decide.
+            CoordinatesToJSon();
+        }
+
         json_object* poNewObj = json_object_new_array();
         AppendObject(poNewObj);
         m_apoCurObj.push_back( poNewObj );
@@ -657,6 +1322,14 @@ void OGRGeoJSONReaderStreamingParser::EndArray()
             m_osJson += "]";
         }
 
+        if( m_bInDirectCoordinates )
+        {
+            m_abyCoordTokens.push_back(COORD_TOKEN_END_ARRAY);
+            if( m_nDepth == 4 )
+                m_bInDirectCoordinates = false;
+            return;
+        }
+
         m_apoCurObj.pop_back();
     }
 }
@@ -692,6 +1365,16 @@ void OGRGeoJSONReaderStreamingParser::String(const char* pszValue, size_t nLen)
         {
             m_osJson += CPLJSonStreamingParser::GetSerializedString(pszValue);
         }
+        if( m_bInDirectCoordinates )
+            CoordinatesToJSon();
+        else if( m_bInProperties && m_nDepth == 4 )
+        {
+            if( !m_oReader.IsAttributesSkip() )
+                SetDirectProperty(json_type_string, pszValue, nLen, false);
+            m_osCurKey.clear();
+            m_bKeySet = false;
+            return;
+        }
         AppendObject(json_object_new_string(pszValue));
     }
 }
@@ -727,29 +1410,33 @@ void OGRGeoJSONReaderStreamingParser::Number(const char* pszValue, size_t nLen)
             m_osJson.append(pszValue, nLen);
         }
 
-        if( CPLGetValueType(pszValue) == CPL_VALUE_REAL )
+        if( m_bInDirectCoordinates )
         {
-            AppendObject(json_object_new_double(CPLAtof(pszValue)));
-        }
-        else if( nLen == strlen("Infinity") && EQUAL(pszValue, "Infinity") )
-        {
-            AppendObject(json_object_new_double(
-                std::numeric_limits<double>::infinity()));
-        }
-        else if( nLen == strlen("-Infinity") && EQUAL(pszValue, "-Infinity") )
-        {
-            AppendObject(json_object_new_double(
-                -std::numeric_limits<double>::infinity()));
-        }
-        else if( nLen == strlen("NaN") && EQUAL(pszValue, "NaN") )
-        {
-            AppendObject(json_object_new_double(
-                std::numeric_limits<double>::quiet_NaN()));
+            m_abyCoordTokens.push_back(COORD_TOKEN_NUMBER);
+            m_adfCoordValues.push_back(OGRGeoJSONParseNumber(pszValue, nLen));
+            return;
         }
-        else
+        if( m_bInProperties && m_nDepth == 4 )
         {
-            AppendObject(json_object_new_int64(CPLAtoGIntBig(pszValue)));
+            if( !m_oReader.IsAttributesSkip() )
+            {
+                const bool bIsInteger =
+                    CPLGetValueType(pszValue) != CPL_VALUE_REAL &&
+                    !(nLen == strlen("Infinity") &&
+                      EQUAL(pszValue, "Infinity")) &&
+                    !(nLen == strlen("-Infinity") &&
+                      EQUAL(pszValue, "-Infinity")) &&
+                    !(nLen == strlen("NaN") && EQUAL(pszValue, "NaN"));
+                SetDirectProperty(bIsInteger ? json_type_int :
+                                               json_type_double,
+                                  pszValue, nLen, false);
+            }
+            m_osCurKey.clear();
+            m_bKeySet = false;
+            return;
         }
+
+        AppendObject(OGRGeoJSONNewNumberObject(pszValue, nLen));
     }
 }
 
@@ -779,6 +1466,16 @@ void OGRGeoJSONReaderStreamingParser::Boolean(bool bVal)
             m_osJson += bVal ? "true": "false";
         }
 
+        if( m_bInDirectCoordinates )
+            CoordinatesToJSon();
+        else if( m_bInProperties && m_nDepth == 4 )
+        {
+            if( !m_oReader.IsAttributesSkip() )
+                SetDirectProperty(json_type_boolean, nullptr, 0, bVal);
+            m_osCurKey.clear();
+            m_bKeySet = false;
+            return;
+        }
         AppendObject( json_object_new_boolean(bVal) );
     }
 }
@@ -803,6 +1500,16 @@ void OGRGeoJSONReaderStreamingParser::Null()
         }
 
         m_nCurObjMemEstimate += ESTIMATE_BASE_OBJECT_SIZE;
+        if( m_bInDirectCoordinates )
+            CoordinatesToJSon();
+        else if( m_bInProperties && m_nDepth == 4 )
+        {
+            if( !m_oReader.IsAttributesSkip() )
+                SetDirectProperty(json_type_null, nullptr, 0, false);
+            m_osCurKey.clear();
+            m_bKeySet = false;
+            return;
+        }
         AppendObject( nullptr );
     }
 }
@@ -2250,8 +2957,17 @@ bool OGRGeoJSONReader::AddFeature( OGRGeoJSONLayer* poLayer,
 OGRGeometry* OGRGeoJSONBaseReader::ReadGeometry( json_object* poObj,
                                              OGRSpatialReference* poLayerSRS )
 {
-    OGRGeometry* poGeometry = OGRGeoJSONReadGeometry( poObj, poLayerSRS );
+    return WrapGeometryIfNeeded(
+                            OGRGeoJSONReadGeometry( poObj, poLayerSRS ) );
+}
+
+/************************************************************************/
+/*                         WrapGeometryIfNeeded                         */
+/************************************************************************/
 
+OGRGeometry* OGRGeoJSONBaseReader::WrapGeometryIfNeeded(
+                                            OGRGeometry* poGeometry ) const
+{
 /* -------------------------------------------------------------------- */
 /*      Wrap geometry with GeometryCollection as a common denominator.  */
 /*      Sometimes a GeoJSON text may consist of objects of different    */
@@ -2465,12 +3181,15 @@ void OGRGeoJSONReaderSetField( OGRLayer* poLayer,
 
 OGRFeature* OGRGeoJSONBaseReader::ReadFeature( OGRLayer* poLayer,
                                            json_object* poObj,
-                                           const char* pszSerializedObj )
+                                           const char* pszSerializedObj,
+                                           OGRFeature* poFeature,
+                                           bool bGeometryRead )
 {
     CPLAssert( nullptr != poObj );
 
     OGRFeatureDefn* poFDefn = poLayer->GetLayerDefn();
-    OGRFeature* poFeature = new OGRFeature( poFDefn );
+    if( poFeature == nullptr )
+        poFeature = new OGRFeature( poFDefn );
 
     if( bStoreNativeData_ )
     {
@@ -2578,6 +3297,9 @@ OGRFeature* OGRGeoJSONBaseReader::ReadFeature( OGRLayer* poLayer,
 /* -------------------------------------------------------------------- */
 /*      Translate geometry sub-object of GeoJSON Feature.               */
 /* -------------------------------------------------------------------- */
+    if( bGeometryRead )
+        return poFeature;
+
     json_object* poObjGeom = nullptr;
     json_object* poTmp = poObj;
     json_object_iter it;
@@ -2836,6 +3558,138 @@ OGRGeometry* OGRGeoJSONReadGeometry( json_object* poObj,
     return poGeometry;
 }
 
+/************************************************************************/
+/*                  OGRGeoJSONGetCoordinatesEnvelope()                  */
+/************************************************************************/
+
+static bool OGRGeoJSONGetCoordinatesEnvelope( json_object* poObj,
+                                              OGREnvelope& sEnvelope,
+                                              int nRecLevel )
+{
+    // Arbitrary value, but certainly large enough for reasonable usages.
+    if( nRecLevel == 32 ||
+        json_object_get_type(poObj) != json_type_array )
+    {
+        return false;
+    }
+
+    const auto nLength = json_object_array_length(poObj);
+    if( nLength == 0 )
+        return true;
+
+    json_object* poFirst = json_object_array_get_idx(poObj, 0);
+    const auto eFirstType = json_object_get_type(poFirst);
+    if( eFirstType == json_type_double || eFirstType == json_type_int )
+    {
+        // Position
+        json_object* poY = json_object_array_get_idx(poObj, 1);
+        const auto eYType = json_object_get_type(poY);
+        if( nLength < 2 ||
+            (eYType != json_type_double && eYType != json_type_int) )
+        {
+            return false;
+        }
+        sEnvelope.Merge(json_object_get_double(poFirst),
+                        json_object_get_double(poY));
+        return true;
+    }
+
+    for( auto i = decltype(nLength){0}; i < nLength; i++ )
+    {
+        if( !OGRGeoJSONGetCoordinatesEnvelope(
+                json_object_array_get_idx(poObj, i), sEnvelope, nRecLevel + 1) )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                   OGRGeoJSONGetGeometryEnvelope()                    */
+/************************************************************************/
+
+/* Compute the envelope of a GeoJSON geometry object from its coordinates,
+ * without building a OGRGeometry. Returns false if the object is not a
+ * geometry whose envelope can be computed. The envelope is left
+ * uninitialized for an empty geometry. */
+
+bool OGRGeoJSONGetGeometryEnvelope( json_object* poObj, OGREnvelope& sEnvelope )
+{
+    sEnvelope = OGREnvelope();
+    if( json_object_get_type(poObj) != json_type_object )
+        return false;
+
+    const GeoJSONObject::Type objType = OGRGeoJSONGetType( poObj );
+    if( objType == GeoJSONObject::eGeometryCollection )
+    {
+        json_object* poGeoms = OGRGeoJSONFindMemberByName(poObj, "geometries");
+        if( json_object_get_type(poGeoms) != json_type_array )
+            return false;
+        const auto nLength = json_object_array_length(poGeoms);
+        for( auto i = decltype(nLength){0}; i < nLength; i++ )
+        {
+            // Nested collections are not handled
+            json_object* poGeom = json_object_array_get_idx(poGeoms, i);
+            if( OGRGeoJSONGetType(poGeom) == GeoJSONObject::eGeometryCollection )
+                return false;
+            OGREnvelope sSubEnvelope;
+            if( !OGRGeoJSONGetGeometryEnvelope(poGeom, sSubEnvelope) )
+                return false;
+            if( sSubEnvelope.IsInit() )
+                sEnvelope.Merge(sSubEnvelope);
+        }
+        return true;
+    }
+
+    if( objType != GeoJSONObject::ePoint &&
+        objType != GeoJSONObject::eMultiPoint &&
+        objType != GeoJSONObject::eLineString &&
+        objType != GeoJSONObject::eMultiLineString &&
+        objType != GeoJSONObject::ePolygon &&
+        objType != GeoJSONObject::eMultiPolygon )
+    {
+        return false;
+    }
+
+    json_object* poCoords = OGRGeoJSONFindMemberByName(poObj, "coordinates");
+    if( poCoords == nullptr )
+        return false;
+    return OGRGeoJSONGetCoordinatesEnvelope(poCoords, sEnvelope, 0);
+}
+
+/************************************************************************/
+/*                            FeatureHasFID()                           */
+/************************************************************************/
+
+/* Whether ReadFeature() would set the FID of the feature from its content,
+ * so that callers that skip the feature know whether they must consume a
+ * sequential FID. */
+
+bool OGRGeoJSONBaseReader::FeatureHasFID( OGRLayer* poLayer,
+                                          json_object* poObj ) const
+{
+    if( bFeatureLevelIdAsFID_ &&
+        OGRGeoJSONFindMemberByName( poObj, "id" ) != nullptr )
+    {
+        return true;
+    }
+
+    const char* pszFIDColumn = poLayer->GetFIDColumn();
+    if( pszFIDColumn[0] != '\0' )
+    {
+        json_object* poObjProps =
+            OGRGeoJSONFindMemberByName( poObj, "properties" );
+        if( poObjProps != nullptr &&
+            json_object_get_type(poObjProps) == json_type_object &&
+            OGRGeoJSONFindMemberByName( poObjProps, pszFIDColumn ) != nullptr )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 /************************************************************************/
 /*                        OGRGeoJSONGetCoordinate()                     */
 /************************************************************************/
@@ -105,8 +105,19 @@ class OGRGeoJSONBaseReader
     void FinalizeLayerDefn( OGRLayer* poLayer, CPLString& osFIDColumn );
 
     OGRGeometry* ReadGeometry( json_object* poObj, OGRSpatialReference* poLayerSRS );
+    OGRGeometry* WrapGeometryIfNeeded( OGRGeometry* poGeometry ) const;
+    // poFeature may be a feature whose attributes have already been
+    // partially set, and bGeometryRead indicates that the geometry has
+    // been set by the caller and that poObj has no "geometry" member.
     OGRFeature* ReadFeature( OGRLayer* poLayer, json_object* poObj,
-                             const char* pszSerializedObj );
+                             const char* pszSerializedObj,
+                             OGRFeature* poFeature = nullptr,
+                             bool bGeometryRead = false );
+    bool FeatureHasFID( OGRLayer* poLayer, json_object* poObj ) const;
+
+    bool IsAttributesSkip() const { return bAttributesSkip_; }
+    bool IsGeocouchSpatiallistFormat() const
+                                    { return bIsGeocouchSpatiallistFormat; }
   protected:
     bool bGeometryPreserve_ = true;
     bool bAttributesSkip_ = false;
@@ -252,6 +263,7 @@ bool OGRGeoJSONUpdateLayerGeomType( OGRLayer* poLayer,
 
 bool OGRGeoJSONReadRawPoint( json_object* poObj, OGRPoint& point );
 OGRGeometry* OGRGeoJSONReadGeometry( json_object* poObj );
+bool OGRGeoJSONGetGeometryEnvelope( json_object* poObj, OGREnvelope& sEnvelope );
 OGRPoint* OGRGeoJSONReadPoint( json_object* poObj );
 OGRMultiPoint* OGRGeoJSONReadMultiPoint( json_object* poObj );
 OGRLineString* OGRGeoJSONReadLineString( json_object* poObj, bool bRaw=false );
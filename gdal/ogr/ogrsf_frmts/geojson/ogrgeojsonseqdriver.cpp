@@ -29,13 +29,18 @@
 #include "cpl_port.h"
 #include "cpl_http.h"
 #include "cpl_vsi_error.h"
+#include "cpl_worker_thread_pool.h"
+#include "gdal_thread_pool.h"
 
 #include "ogr_geojson.h"
 #include "ogrgeojsonreader.h"
 #include "ogrgeojsonwriter.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 
 CPL_CVSID("$Id$")
 
@@ -69,6 +74,43 @@ class OGRGeoJSONSeqDataSource final: public GDALDataset
         VSILFILE* GetOutputFile() const { return m_fpOut; }
 };
 
+class OGRGeoJSONSeqLayer;
+
+/************************************************************************/
+/*                           OGRGeoJSONSeqChunk                         */
+/************************************************************************/
+
+// Set of complete records processed by a worker thread.
+struct OGRGeoJSONSeqChunk
+{
+    OGRGeoJSONSeqLayer* poLayer = nullptr;
+    std::string osData{};
+    bool bTranslate = false;
+    bool bHasFilter = false;
+    OGREnvelope sFilterEnvelope{};
+
+    // When !bTranslate, the JSON objects of the records.
+    std::vector<json_object*> apoObjects{};
+    // When bTranslate, the features of the records. nullptr entries are
+    // features skipped by the spatial filter that must consume a FID.
+    std::vector<OGRFeature*> apoFeatures{};
+
+    bool bDone = false;
+
+    OGRGeoJSONSeqChunk() = default;
+    ~OGRGeoJSONSeqChunk();
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRGeoJSONSeqChunk)
+};
+
+OGRGeoJSONSeqChunk::~OGRGeoJSONSeqChunk()
+{
+    for( auto poObject: apoObjects )
+        json_object_put(poObject);
+    for( auto poFeature: apoFeatures )
+        delete poFeature;
+}
+
 /************************************************************************/
 /*                           OGRGeoJSONSeqLayer                         */
 /************************************************************************/
@@ -95,7 +137,32 @@ class OGRGeoJSONSeqLayer final: public OGRLayer
         GIntBig m_nTotalFeatures = 0;
         GIntBig m_nNextFID = 0;
 
+        // Multi-threaded reading: the file is split at record boundaries
+        // into chunks that are parsed by the global pool of worker threads.
+        int m_nThreads = 1;
+        bool m_bPreserveOrder = true;
+        size_t m_nChunkSize = 0;
+        std::mutex m_oChunkMutex{};
+        std::condition_variable m_oChunkCV{};
+        std::deque<std::unique_ptr<OGRGeoJSONSeqChunk>> m_apoChunks{};
+        std::unique_ptr<OGRGeoJSONSeqChunk> m_poCurChunk{};
+        size_t m_iInCurChunk = 0;
+        std::string m_osRemainingData{};
+        bool m_bNoMoreChunks = false;
+        // Declared last so that pending jobs are waited for first.
+        std::unique_ptr<CPLJobQueue> m_poJobQueue{};
+
         json_object* GetNextObject(bool bLooseIdentification);
+        OGRFeature* TranslateObject(json_object* poObject,
+                                    const char* pszSerializedObj,
+                                    const OGREnvelope* psFilterEnvelope,
+                                    bool& bSkippedWithoutFID);
+
+        bool ReadChunkData(std::string& osData);
+        void SubmitChunks(bool bTranslate);
+        OGRGeoJSONSeqChunk* GetNextChunk(bool bTranslate);
+        void DiscardChunks();
+        static void ProcessChunkFunc(void* pData);
 
     public:
         OGRGeoJSONSeqLayer(OGRGeoJSONSeqDataSource* poDS,
@@ -272,6 +339,7 @@ OGRGeoJSONSeqLayer::OGRGeoJSONSeqLayer(OGRGeoJSONSeqDataSource* poDS,
 
 OGRGeoJSONSeqLayer::~OGRGeoJSONSeqLayer()
 {
+    DiscardChunks();
     VSIFCloseL(m_fp);
     m_poFeatureDefn->Release();
 }
@@ -289,19 +357,49 @@ bool OGRGeoJSONSeqLayer::Init(bool bLooseIdentification)
         m_nFileSize = VSIFTellL(m_fp);
     }
 
+    const char* pszNumThreads =
+        CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszNumThreads )
+    {
+        m_nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                        atoi(pszNumThreads);
+        m_nThreads = std::max(1, std::min(128, m_nThreads));
+    }
+    m_bPreserveOrder = CPLTestBool(
+        CPLGetConfigOption("OGR_GEOJSONSEQ_PRESERVE_ORDER", "YES"));
+
     ResetReading();
 
-    while( true )
+    // Loose identification stops at the first record that is not a JSON
+    // object, so do not parse ahead of it.
+    if( m_nThreads > 1 && !bLooseIdentification )
     {
-        auto poObject = GetNextObject(bLooseIdentification);
-        if( !poObject )
-            break;
-        if( OGRGeoJSONGetType(poObject) == GeoJSONObject::eFeature )
+        while( GetNextChunk(false) )
         {
-            m_oReader.GenerateFeatureDefn(this, poObject);
+            for( auto poObject: m_poCurChunk->apoObjects )
+            {
+                if( OGRGeoJSONGetType(poObject) == GeoJSONObject::eFeature )
+                {
+                    m_oReader.GenerateFeatureDefn(this, poObject);
+                }
+                m_nTotalFeatures ++;
+            }
+        }
+    }
+    else
+    {
+        while( true )
+        {
+            auto poObject = GetNextObject(bLooseIdentification);
+            if( !poObject )
+                break;
+            if( OGRGeoJSONGetType(poObject) == GeoJSONObject::eFeature )
+            {
+                m_oReader.GenerateFeatureDefn(this, poObject);
+            }
+            json_object_put(poObject);
+            m_nTotalFeatures ++;
         }
-        json_object_put(poObject);
-        m_nTotalFeatures ++;
     }
 
     ResetReading();
@@ -319,6 +417,7 @@ bool OGRGeoJSONSeqLayer::Init(bool bLooseIdentification)
 
 void OGRGeoJSONSeqLayer::ResetReading()
 {
+    DiscardChunks();
     VSIFSeekL(m_fp, 0, SEEK_SET);
     // Undocumented: for testing purposes only
     const size_t nBufferSize = static_cast<size_t>(std::max(1,
@@ -331,6 +430,11 @@ void OGRGeoJSONSeqLayer::ResetReading()
     m_nPosInBuffer = nBufferSizeValidated;
     m_nBufferValidSize = nBufferSizeValidated;
     m_nNextFID = 0;
+
+    m_nChunkSize = CPLGetConfigOption("OGR_GEOJSONSEQ_CHUNK_SIZE", nullptr) ?
+                        nBufferSizeValidated : 1024 * 1024;
+    m_osRemainingData.clear();
+    m_bNoMoreChunks = false;
 }
 
 /************************************************************************/
@@ -428,41 +532,306 @@ json_object* OGRGeoJSONSeqLayer::GetNextObject(bool bLooseIdentification)
 }
 
 /************************************************************************/
-/*                           GetNextFeature()                           */
+/*                            ReadChunkData()                           */
 /************************************************************************/
 
-OGRFeature* OGRGeoJSONSeqLayer::GetNextFeature()
+// Reads the next set of complete records of the file. Returns false at
+// the end of the file.
+bool OGRGeoJSONSeqLayer::ReadChunkData(std::string& osData)
 {
+    osData = std::move(m_osRemainingData);
+    m_osRemainingData.clear();
+    const char chSep = m_bIsRSSeparated ? RS : '\n';
     while( true )
     {
-        auto poObject = GetNextObject(false);
-        if( !poObject )
-            return nullptr;
-        OGRFeature* poFeature;
-        auto type = OGRGeoJSONGetType(poObject);
-        if( type == GeoJSONObject::eFeature )
+        const size_t nOldSize = osData.size();
+        osData.resize(nOldSize + m_nChunkSize);
+        const size_t nRead = VSIFReadL(&osData[nOldSize], 1, m_nChunkSize,
+                                       m_fp);
+        osData.resize(nOldSize + nRead);
+        if( nRead < m_nChunkSize )
         {
-            poFeature = m_oReader.ReadFeature(
-                this, poObject, m_osFeatureBuffer.c_str() );
-            json_object_put(poObject);
+            return !osData.empty();
+        }
+
+        // The remaining data of the previous read has no separator, so
+        // only look for one in what has just been read.
+        const size_t nSepPos = osData.rfind(chSep);
+        if( nSepPos != std::string::npos && nSepPos >= nOldSize )
+        {
+            m_osRemainingData.assign(osData, nSepPos + 1, std::string::npos);
+            osData.resize(nSepPos + 1);
+            return true;
         }
-        else if( type == GeoJSONObject::eFeatureCollection ||
-                 type == GeoJSONObject::eUnknown )
+        if( osData.size() > 100 * 1024 * 1024 )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported, "Too large feature");
+            osData.clear();
+            return false;
+        }
+    }
+}
+
+/************************************************************************/
+/*                          ProcessChunkFunc()                          */
+/************************************************************************/
+
+void OGRGeoJSONSeqLayer::ProcessChunkFunc(void* pData)
+{
+    OGRGeoJSONSeqChunk* psChunk = static_cast<OGRGeoJSONSeqChunk*>(pData);
+    OGRGeoJSONSeqLayer* poLayer = psChunk->poLayer;
+    const char chSep = poLayer->m_bIsRSSeparated ? RS : '\n';
+    std::string& osData = psChunk->osData;
+    size_t nStart = 0;
+    while( nStart < osData.size() )
+    {
+        const size_t nRecordStart = nStart;
+        size_t nEnd = osData.find(chSep, nStart);
+        if( nEnd == std::string::npos )
+            nEnd = osData.size();
+        nStart = nEnd + 1;
+        size_t nRecordEnd = nEnd;
+        while( nRecordEnd > nRecordStart &&
+               (osData[nRecordEnd-1] == '\r' || osData[nRecordEnd-1] == '\n') )
+        {
+            nRecordEnd --;
+        }
+        if( nRecordEnd == nRecordStart )
+            continue;
+        // Terminate the record in place of its separator.
+        osData[nRecordEnd] = '\0';
+        const char* pszRecord = osData.c_str() + nRecordStart;
+
+        json_object* poObject = nullptr;
+        CPL_IGNORE_RET_VAL(OGRJSonParse(pszRecord, &poObject));
+        if( json_object_get_type(poObject) != json_type_object )
         {
             json_object_put(poObject);
             continue;
         }
-        else
+        if( !psChunk->bTranslate )
         {
-            OGRGeometry* poGeom = m_oReader.ReadGeometry(poObject,
-                                                         GetSpatialRef());
-            json_object_put(poObject);
-            if( !poGeom )
+            psChunk->apoObjects.push_back(poObject);
+            continue;
+        }
+
+        bool bSkippedWithoutFID = false;
+        OGRFeature* poFeature = poLayer->TranslateObject(
+            poObject, pszRecord,
+            psChunk->bHasFilter ? &psChunk->sFilterEnvelope : nullptr,
+            bSkippedWithoutFID);
+        json_object_put(poObject);
+        if( poFeature || bSkippedWithoutFID )
+            psChunk->apoFeatures.push_back(poFeature);
+    }
+
+    std::lock_guard<std::mutex> oLock(poLayer->m_oChunkMutex);
+    psChunk->bDone = true;
+    poLayer->m_oChunkCV.notify_all();
+}
+
+/************************************************************************/
+/*                            SubmitChunks()                            */
+/************************************************************************/
+
+void OGRGeoJSONSeqLayer::SubmitChunks(bool bTranslate)
+{
+    // Keep each worker busy with one chunk, plus one waiting chunk.
+    while( !m_bNoMoreChunks &&
+           m_apoChunks.size() < 2 * static_cast<size_t>(m_nThreads) )
+    {
+        std::unique_ptr<OGRGeoJSONSeqChunk> poChunk(new OGRGeoJSONSeqChunk());
+        if( !ReadChunkData(poChunk->osData) )
+        {
+            m_bNoMoreChunks = true;
+            break;
+        }
+        poChunk->poLayer = this;
+        poChunk->bTranslate = bTranslate;
+        if( m_poFilterGeom != nullptr && m_iGeomFieldFilter == 0 )
+        {
+            poChunk->bHasFilter = true;
+            poChunk->sFilterEnvelope = m_sFilterEnvelope;
+        }
+        OGRGeoJSONSeqChunk* psChunk = poChunk.get();
+        m_apoChunks.push_back(std::move(poChunk));
+
+        // A file that fits in a single chunk is processed by the calling
+        // thread, without using the worker threads.
+        if( m_poJobQueue == nullptr &&
+            m_apoChunks.size() == 1 && m_osRemainingData.empty() &&
+            VSIFEofL(m_fp) )
+        {
+            ProcessChunkFunc(psChunk);
+            continue;
+        }
+        if( m_poJobQueue == nullptr )
+        {
+            CPLWorkerThreadPool* poThreadPool =
+                GDALGetGlobalThreadPool(m_nThreads);
+            if( poThreadPool )
+                m_poJobQueue = poThreadPool->CreateJobQueue();
+        }
+        if( m_poJobQueue == nullptr ||
+            !m_poJobQueue->SubmitJob(ProcessChunkFunc, psChunk) )
+        {
+            ProcessChunkFunc(psChunk);
+        }
+    }
+}
+
+/************************************************************************/
+/*                            GetNextChunk()                            */
+/************************************************************************/
+
+// Makes the next processed chunk the current one.
+OGRGeoJSONSeqChunk* OGRGeoJSONSeqLayer::GetNextChunk(bool bTranslate)
+{
+    m_poCurChunk.reset();
+    m_iInCurChunk = 0;
+    SubmitChunks(bTranslate);
+    if( m_apoChunks.empty() )
+        return nullptr;
+
+    // The layer definition is built from the records in the order of the
+    // file, so only features may be returned out of order.
+    const bool bPreserveOrder = m_bPreserveOrder || !bTranslate;
+    {
+        std::unique_lock<std::mutex> oLock(m_oChunkMutex);
+        auto oIter = m_apoChunks.begin();
+        m_oChunkCV.wait(oLock, [this, bPreserveOrder, &oIter]()
+        {
+            if( bPreserveOrder )
+                return m_apoChunks.front()->bDone;
+            oIter = std::find_if(m_apoChunks.begin(), m_apoChunks.end(),
+                [](const std::unique_ptr<OGRGeoJSONSeqChunk>& poChunk)
+                { return poChunk->bDone; });
+            return oIter != m_apoChunks.end();
+        });
+        m_poCurChunk = std::move(*oIter);
+        m_apoChunks.erase(oIter);
+    }
+
+    SubmitChunks(bTranslate);
+    return m_poCurChunk.get();
+}
+
+/************************************************************************/
+/*                           DiscardChunks()                            */
+/************************************************************************/
+
+void OGRGeoJSONSeqLayer::DiscardChunks()
+{
+    {
+        std::unique_lock<std::mutex> oLock(m_oChunkMutex);
+        m_oChunkCV.wait(oLock, [this]()
+        {
+            for( const auto& poChunk: m_apoChunks )
+            {
+                if( !poChunk->bDone )
+                    return false;
+            }
+            return true;
+        });
+    }
+    m_apoChunks.clear();
+    m_poCurChunk.reset();
+    m_iInCurChunk = 0;
+}
+
+/************************************************************************/
+/*                          TranslateObject()                           */
+/************************************************************************/
+
+// Returns the feature of a record, or nullptr if it must be skipped. May be
+// called from worker threads, hence the spatial filter envelope passed as
+// an argument.
+OGRFeature* OGRGeoJSONSeqLayer::TranslateObject(
+                                        json_object* poObject,
+                                        const char* pszSerializedObj,
+                                        const OGREnvelope* psFilterEnvelope,
+                                        bool& bSkippedWithoutFID)
+{
+    bSkippedWithoutFID = false;
+    auto type = OGRGeoJSONGetType(poObject);
+    if( type == GeoJSONObject::eFeature )
+    {
+        // Skip features whose geometry envelope does not intersect the
+        // spatial filter, before translating them. Same test as
+        // FilterGeometryEnvelope().
+        if( psFilterEnvelope != nullptr )
+        {
+            json_object* poObjGeom =
+                OGRGeoJSONFindMemberByName(poObject, "geometry");
+            OGREnvelope sEnvelope;
+            if( poObjGeom != nullptr &&
+                OGRGeoJSONGetGeometryEnvelope(poObjGeom, sEnvelope) &&
+                (!sEnvelope.IsInit() ||
+                 !sEnvelope.Intersects(*psFilterEnvelope)) )
             {
+                bSkippedWithoutFID = !m_oReader.FeatureHasFID(this, poObject);
+                return nullptr;
+            }
+        }
+
+        return m_oReader.ReadFeature(this, poObject, pszSerializedObj);
+    }
+    else if( type == GeoJSONObject::eFeatureCollection ||
+             type == GeoJSONObject::eUnknown )
+    {
+        return nullptr;
+    }
+
+    OGRGeometry* poGeom = m_oReader.ReadGeometry(poObject, GetSpatialRef());
+    if( !poGeom )
+    {
+        return nullptr;
+    }
+    OGRFeature* poFeature = new OGRFeature(m_poFeatureDefn);
+    poFeature->SetGeometryDirectly(poGeom);
+    return poFeature;
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONSeqLayer::GetNextFeature()
+{
+    while( true )
+    {
+        OGRFeature* poFeature = nullptr;
+        bool bSkippedWithoutFID = false;
+        if( m_nThreads > 1 )
+        {
+            if( m_poCurChunk == nullptr ||
+                m_iInCurChunk == m_poCurChunk->apoFeatures.size() )
+            {
+                if( !GetNextChunk(true) )
+                    return nullptr;
                 continue;
             }
-            poFeature = new OGRFeature(m_poFeatureDefn);
-            poFeature->SetGeometryDirectly(poGeom);
+            std::swap(poFeature, m_poCurChunk->apoFeatures[m_iInCurChunk]);
+            m_iInCurChunk ++;
+            bSkippedWithoutFID = poFeature == nullptr;
+        }
+        else
+        {
+            auto poObject = GetNextObject(false);
+            if( !poObject )
+                return nullptr;
+            poFeature = TranslateObject(
+                poObject, m_osFeatureBuffer.c_str(),
+                (m_poFilterGeom != nullptr && m_iGeomFieldFilter == 0) ?
+                    &m_sFilterEnvelope : nullptr,
+                bSkippedWithoutFID);
+            json_object_put(poObject);
+        }
+        if( poFeature == nullptr )
+        {
+            if( bSkippedWithoutFID )
+                m_nNextFID ++;
+            continue;
         }
 
         if( poFeature->GetFID() == OGRNullFID )
@@ -1556,16 +1556,30 @@ static int OGR_json_double_with_precision_to_string( struct json_object *jso,
     const uintptr_t nPrecision = reinterpret_cast<uintptr_t>(userData);
     char szBuffer[75] = {};
     const double dfVal =  json_object_get_double(jso);
+    const bool bPrecisionIsNegative =
+        (nPrecision >> (8 * sizeof(nPrecision)-1)) != 0;
+    if( bPrecisionIsNegative )
+    {
+        // No explicit precision: use the shortest representation that
+        // round-trips, keeping a decimal point for integral values.
+        int nLen = CPLFormatDoubleShortest(szBuffer, sizeof(szBuffer) - 2,
+                                           dfVal);
+        if( strpbrk(szBuffer, ".eni") == nullptr )
+        {
+            szBuffer[nLen++] = '.';
+            szBuffer[nLen++] = '0';
+            szBuffer[nLen] = '\0';
+        }
+        return printbuf_memappend(pb, szBuffer, nLen);
+    }
     if( fabs(dfVal) > 1e50 && !CPLIsInf(dfVal) )
     {
         CPLsnprintf(szBuffer, sizeof(szBuffer), "%.18g", dfVal);
     }
     else
     {
-        const bool bPrecisionIsNegative =
-            (nPrecision >> (8 * sizeof(nPrecision)-1)) != 0;
         OGRFormatDouble( szBuffer, sizeof(szBuffer), dfVal, '.',
-             bPrecisionIsNegative ? 15 : static_cast<int>(nPrecision) );
+                         static_cast<int>(nPrecision) );
     }
     return printbuf_memappend(pb, szBuffer, static_cast<int>(strlen(szBuffer)));
 }
@@ -37,6 +37,7 @@
 #include "gmlutils.h"
 
 #include <memory>
+#include <vector>
 
 class OGRGMLDataSource;
 
@@ -72,6 +73,31 @@ class OGRGMLLayer final: public OGRLayer
 
     bool                bFaceHoleNegative;
 
+    // Parallel decoding of geometries (GDAL_NUM_THREADS > 1)
+    struct PrefetchedFeature
+    {
+        GMLFeature     *poGMLFeature = nullptr;
+        OGRGeometry    *poGeom = nullptr;
+        CPLString       osErrorMsg{};
+    };
+    struct DecodeGeometriesJob
+    {
+        OGRGMLLayer    *poLayer = nullptr;
+        size_t          nStart = 0;
+        size_t          nEnd = 0;
+        void           *hCacheSRS = nullptr;
+    };
+
+    int                 m_nDecodeThreads = 1;
+    std::vector<PrefetchedFeature> m_aoPrefetchedFeatures{};
+    size_t              m_nPrefetchedFeatureIdx = 0;
+    std::vector<void*>  m_ahDecodeCacheSRS{};
+
+    bool                CanDecodeInParallel() const;
+    bool                PrefetchFeatures();
+    void                ClearPrefetchedFeatures();
+    static void         DecodeGeometriesFunc(void* pData);
+
   public:
                         OGRGMLLayer( const char * pszName,
                                      bool bWriter,
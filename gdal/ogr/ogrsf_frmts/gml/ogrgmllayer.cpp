@@ -34,6 +34,9 @@
 #include "cpl_string.h"
 #include "ogr_p.h"
 #include "ogr_api.h"
+#include "gdal_thread_pool.h"
+
+#include <algorithm>
 
 CPL_CVSID("$Id$")
 
@@ -67,6 +70,18 @@ OGRGMLLayer::OGRGMLLayer( const char * pszName,
     SetDescription(poFeatureDefn->GetName());
     poFeatureDefn->Reference();
     poFeatureDefn->SetGeomType(wkbNone);
+
+    if( !bWriter )
+    {
+        const char* pszNumThreads =
+            CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+        if( pszNumThreads != nullptr )
+        {
+            m_nDecodeThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+                CPLGetNumCPUs() : atoi(pszNumThreads);
+            m_nDecodeThreads = std::max(1, std::min(128, m_nDecodeThreads));
+        }
+    }
 }
 
 /************************************************************************/
@@ -78,10 +93,14 @@ OGRGMLLayer::~OGRGMLLayer()
 {
     CPLFree(pszFIDPrefix);
 
+    ClearPrefetchedFeatures();
+
     if( poFeatureDefn )
         poFeatureDefn->Release();
 
     GML_BuildOGRGeometryFromList_DestroyCache(hCacheSRS);
+    for( void* hDecodeCacheSRS: m_ahDecodeCacheSRS )
+        GML_BuildOGRGeometryFromList_DestroyCache(hDecodeCacheSRS);
 }
 
 /************************************************************************/
@@ -94,6 +113,8 @@ void OGRGMLLayer::ResetReading()
     if (bWriter)
         return;
 
+    ClearPrefetchedFeatures();
+
     if (poDS->GetReadMode() == INTERLEAVED_LAYERS ||
         poDS->GetReadMode() == SEQUENTIAL_LAYERS)
     {
@@ -131,6 +152,136 @@ static GIntBig Increment(GIntBig nVal)
     return nVal;
 }
 
+/************************************************************************/
+/*                        CanDecodeInParallel()                         */
+/************************************************************************/
+
+bool OGRGMLLayer::CanDecodeInParallel() const
+{
+    // In the interleaved and sequential modes, features of other layers
+    // must be handed over to them, so read them one at a time.
+    return m_nDecodeThreads > 1 &&
+           poDS->GetReadMode() == STANDARD &&
+           poFeatureDefn->GetGeomFieldCount() <= 1;
+}
+
+/************************************************************************/
+/*                      ClearPrefetchedFeatures()                       */
+/************************************************************************/
+
+void OGRGMLLayer::ClearPrefetchedFeatures()
+{
+    for( auto& oFeature: m_aoPrefetchedFeatures )
+    {
+        delete oFeature.poGMLFeature;
+        delete oFeature.poGeom;
+    }
+    m_aoPrefetchedFeatures.clear();
+    m_nPrefetchedFeatureIdx = 0;
+}
+
+/************************************************************************/
+/*                        DecodeGeometriesFunc()                        */
+/************************************************************************/
+
+void OGRGMLLayer::DecodeGeometriesFunc(void* pData)
+{
+    const DecodeGeometriesJob* psJob =
+        static_cast<const DecodeGeometriesJob*>(pData);
+    OGRGMLLayer* poLayer = psJob->poLayer;
+    OGRGMLDataSource* poDS = poLayer->poDS;
+    const char *pszSRSName = poDS->GetGlobalSRSName();
+
+    for( size_t i = psJob->nStart; i < psJob->nEnd; i++ )
+    {
+        PrefetchedFeature& oFeature = poLayer->m_aoPrefetchedFeatures[i];
+        const CPLXMLNode *const *papsGeometry =
+            oFeature.poGMLFeature->GetGeometryList();
+        if( papsGeometry[0] == nullptr )
+            continue;
+
+        CPLErrorReset();
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        OGRGeometry* poGeom = GML_BuildOGRGeometryFromList(
+            papsGeometry, true,
+            poDS->GetInvertAxisOrderIfLatLong(),
+            pszSRSName,
+            poDS->GetConsiderEPSGAsURN(),
+            poDS->GetSwapCoordinates(),
+            poDS->GetSecondaryGeometryOption(),
+            psJob->hCacheSRS,
+            poLayer->bFaceHoleNegative);
+        CPLPopErrorHandler();
+
+        if( poGeom != nullptr )
+            oFeature.poGeom = OGRGeometryFactory::forceTo(
+                poGeom, poLayer->poFeatureDefn->GetGeomType());
+        else
+            oFeature.osErrorMsg = CPLGetLastErrorMsg();
+    }
+}
+
+/************************************************************************/
+/*                          PrefetchFeatures()                          */
+/*                                                                      */
+/*      Read the next batch of features of the layer and build their    */
+/*      geometries in parallel. Returns false at end of file.           */
+/************************************************************************/
+
+bool OGRGMLLayer::PrefetchFeatures()
+{
+    ClearPrefetchedFeatures();
+
+    const size_t nBatchSize = static_cast<size_t>(m_nDecodeThreads) * 64;
+    while( m_aoPrefetchedFeatures.size() < nBatchSize )
+    {
+        GMLFeature *poGMLFeature = poDS->GetReader()->NextFeature();
+        if( poGMLFeature == nullptr )
+            break;
+        m_nFeaturesRead++;
+        if( poGMLFeature->GetClass() != poFClass )
+        {
+            delete poGMLFeature;
+            continue;
+        }
+        PrefetchedFeature oFeature;
+        oFeature.poGMLFeature = poGMLFeature;
+        m_aoPrefetchedFeatures.push_back(oFeature);
+    }
+    if( m_aoPrefetchedFeatures.empty() )
+        return false;
+
+    CPLWorkerThreadPool* poThreadPool = GDALGetGlobalThreadPool(m_nDecodeThreads);
+    const int nJobs = static_cast<int>(std::min<size_t>(
+        m_nDecodeThreads, m_aoPrefetchedFeatures.size()));
+    m_ahDecodeCacheSRS.resize(std::max<size_t>(m_ahDecodeCacheSRS.size(),
+                                               nJobs), nullptr);
+    std::vector<DecodeGeometriesJob> asJobs(nJobs);
+    const size_t nChunkSize =
+        (m_aoPrefetchedFeatures.size() + nJobs - 1) / nJobs;
+    for( int i = 0; i < nJobs; i++ )
+    {
+        if( m_ahDecodeCacheSRS[i] == nullptr )
+            m_ahDecodeCacheSRS[i] = GML_BuildOGRGeometryFromList_CreateCache();
+        asJobs[i].poLayer = this;
+        asJobs[i].nStart = i * nChunkSize;
+        asJobs[i].nEnd = std::min(m_aoPrefetchedFeatures.size(),
+                                  (i + 1) * nChunkSize);
+        asJobs[i].hCacheSRS = m_ahDecodeCacheSRS[i];
+    }
+
+    auto poJobQueue = poThreadPool ? poThreadPool->CreateJobQueue() : nullptr;
+    for( auto& sJob: asJobs )
+    {
+        if( poJobQueue == nullptr || !poJobQueue->SubmitJob(DecodeGeometriesFunc, &sJob) )
+            DecodeGeometriesFunc(&sJob);
+    }
+    if( poJobQueue )
+        poJobQueue->WaitCompletion();
+
+    return true;
+}
+
 /************************************************************************/
 /*                           GetNextFeature()                           */
 /************************************************************************/
@@ -159,10 +310,30 @@ OGRFeature *OGRGMLLayer::GetNextFeature()
     while( true )
     {
         GMLFeature *poGMLFeature = poDS->PeekStoredGMLFeature();
+        // Geometry already built by PrefetchFeatures()
+        bool bGeomPrefetched = false;
+        OGRGeometry *poPrefetchedGeom = nullptr;
+        CPLString osPrefetchErrorMsg;
         if (poGMLFeature != nullptr)
         {
             poDS->SetStoredGMLFeature(nullptr);
         }
+        else if( CanDecodeInParallel() )
+        {
+            if( m_nPrefetchedFeatureIdx == m_aoPrefetchedFeatures.size() &&
+                !PrefetchFeatures() )
+            {
+                return nullptr;
+            }
+            PrefetchedFeature& oFeature =
+                m_aoPrefetchedFeatures[m_nPrefetchedFeatureIdx++];
+            poGMLFeature = oFeature.poGMLFeature;
+            oFeature.poGMLFeature = nullptr;
+            poPrefetchedGeom = oFeature.poGeom;
+            oFeature.poGeom = nullptr;
+            osPrefetchErrorMsg = oFeature.osErrorMsg;
+            bGeomPrefetched = true;
+        }
         else
         {
             poGMLFeature = poDS->GetReader()->NextFeature();
@@ -341,27 +512,36 @@ OGRFeature *OGRGMLLayer::GetNextFeature()
         }
         else if (papsGeometry[0] != nullptr)
         {
-            const char *pszSRSName = poDS->GetGlobalSRSName();
-            CPLPushErrorHandler(CPLQuietErrorHandler);
-            poGeom = GML_BuildOGRGeometryFromList(
-                papsGeometry, true,
-                poDS->GetInvertAxisOrderIfLatLong(),
-                pszSRSName,
-                poDS->GetConsiderEPSGAsURN(),
-                poDS->GetSwapCoordinates(),
-                poDS->GetSecondaryGeometryOption(),
-                hCacheSRS,
-                bFaceHoleNegative);
-            CPLPopErrorHandler();
-
-            // Do geometry type changes if needed to match layer geometry type.
-            if (poGeom != nullptr)
+            if( bGeomPrefetched )
             {
-                poGeom = OGRGeometryFactory::forceTo(poGeom, GetGeomType());
+                poGeom = poPrefetchedGeom;
             }
             else
             {
-                const CPLString osLastErrorMsg(CPLGetLastErrorMsg());
+                const char *pszSRSName = poDS->GetGlobalSRSName();
+                CPLPushErrorHandler(CPLQuietErrorHandler);
+                poGeom = GML_BuildOGRGeometryFromList(
+                    papsGeometry, true,
+                    poDS->GetInvertAxisOrderIfLatLong(),
+                    pszSRSName,
+                    poDS->GetConsiderEPSGAsURN(),
+                    poDS->GetSwapCoordinates(),
+                    poDS->GetSecondaryGeometryOption(),
+                    hCacheSRS,
+                    bFaceHoleNegative);
+                CPLPopErrorHandler();
+
+                // Do geometry type changes if needed to match layer geometry
+                // type.
+                if (poGeom != nullptr)
+                    poGeom = OGRGeometryFactory::forceTo(poGeom, GetGeomType());
+            }
+
+            if (poGeom == nullptr)
+            {
+                const CPLString osLastErrorMsg(
+                    bGeomPrefetched ? osPrefetchErrorMsg.c_str() :
+                                      CPLGetLastErrorMsg());
 
                 const bool bGoOn = CPLTestBool(
                     CPLGetConfigOption("GML_SKIP_CORRUPTED_FEATURES", "NO"));
@@ -29,6 +29,7 @@
 #include "ogr_geopackage.h"
 #include "memdataset.h"
 #include "gdal_alg_priv.h"
+#include "gdal_thread_pool.h"
 
 #include <algorithm>
 #include <cassert>
@@ -98,6 +99,19 @@ GDALGPKGMBTilesLikePseudoDataset::GDALGPKGMBTilesLikePseudoDataset() :
 
 GDALGPKGMBTilesLikePseudoDataset::~GDALGPKGMBTilesLikePseudoDataset()
 {
+    if( m_poTileJobQueue )
+    {
+        // Pending tiles should have been inserted by FlushTiles(). Anything
+        // left there can no longer be written.
+        m_poTileJobQueue->WaitCompletion();
+        for( auto& sJob: m_asTileEncodeJobs )
+        {
+            if( sJob.poDS != nullptr )
+                VSIUnlink(sJob.osMemFileName);
+        }
+        m_poTileJobQueue.reset();
+        CPLDestroyMutex(m_hTileJobMutex);
+    }
     if( m_poParentDS == nullptr && m_hTempDB != nullptr )
     {
         sqlite3_close(m_hTempDB);
@@ -138,6 +152,50 @@ void GDALGPKGMBTilesLikePseudoDataset::SetGlobalOffsetScale(double dfOffset,
     m_dfScale = dfScale;
 }
 
+/************************************************************************/
+/*                      InitializeWorkerThreads()                       */
+/************************************************************************/
+
+void GDALGPKGMBTilesLikePseudoDataset::InitializeWorkerThreads(
+                                                        char** papszOptions)
+{
+    CPLAssert( m_poParentDS == nullptr );
+    if( m_poTileJobQueue )
+        return;
+
+    const char* pszValue = CSLFetchNameValue( papszOptions, "NUM_THREADS" );
+    if( pszValue == nullptr )
+        pszValue = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszValue == nullptr )
+        return;
+
+    int nThreads =
+        EQUAL(pszValue, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszValue);
+    if( nThreads > 1024 )
+        nThreads = 1024; // to please Coverity
+    if( nThreads <= 1 )
+        return;
+
+    auto poThreadPool = GDALGetGlobalThreadPool(nThreads);
+    if( poThreadPool )
+        m_poTileJobQueue = poThreadPool->CreateJobQueue();
+    if( m_poTileJobQueue == nullptr )
+        return;
+
+    CPLDebug("GPKG", "Using %d threads for tile encoding/decoding", nThreads);
+    m_nTileJobThreads = nThreads;
+
+    // Add a margin of an extra job w.r.t thread number so that the main
+    // thread can insert tiles in the database while all CPUs are working.
+    m_asTileEncodeJobs.resize(nThreads + 1);
+    for( auto& sJob: m_asTileEncodeJobs )
+    {
+        sJob.osMemFileName.Printf("/vsimem/gpkg_write_tile_job_%p", &sJob);
+    }
+    m_hTileJobMutex = CPLCreateMutex();
+    CPLReleaseMutex(m_hTileJobMutex);
+}
+
 /************************************************************************/
 /*                      GDALGPKGMBTilesLikeRasterBand()                 */
 /************************************************************************/
@@ -190,6 +248,10 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::FlushTiles()
         {
             eErr = WriteTile();
         }
+
+        const CPLErr eErrJobs = WaitCompletionForAllTileJobs();
+        if( eErr == CE_None )
+            eErr = eErrJobs;
     }
 
     if( poMainDS->m_nTileInsertionCount > 0 )
@@ -892,6 +954,32 @@ GByte* GDALGPKGMBTilesLikePseudoDataset::ReadTile( int nRow, int nCol, GByte *pa
         return pabyData;
     }
 
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+    if( poMainDS->m_poTileJobQueue )
+    {
+        if( IGetUpdate() )
+        {
+            // Make sure a pending encoding of that tile is in the database
+            WaitCompletionForTile(nRow, nCol);
+        }
+        else if( m_nShiftXPixelsMod == 0 && m_nShiftYPixelsMod == 0 )
+        {
+            const auto oKey = std::make_pair(nRow, nCol);
+            auto oIter = m_oMapPrefetchedTiles.find(oKey);
+            if( oIter == m_oMapPrefetchedTiles.end() )
+            {
+                PrefetchTiles(nRow, nCol);
+                oIter = m_oMapPrefetchedTiles.find(oKey);
+            }
+            if( oIter != m_oMapPrefetchedTiles.end() )
+            {
+                memcpy(pabyData, oIter->second.data(), oIter->second.size());
+                m_oMapPrefetchedTiles.erase(oIter);
+                return pabyData;
+            }
+        }
+    }
+
 #ifdef DEBUG_VERBOSE
     CPLDebug( "GPKG", "ReadTile(row=%d, col=%d)", nRow, nCol );
 #endif
@@ -1011,6 +1099,139 @@ GByte* GDALGPKGMBTilesLikePseudoDataset::ReadTile( int nRow, int nCol, GByte *pa
     return pabyData;
 }
 
+/************************************************************************/
+/*                           PrefetchTiles()                            */
+/************************************************************************/
+
+namespace {
+struct GPKGTileDecodeJob
+{
+    GDALGPKGMBTilesLikePseudoDataset* poDS = nullptr;
+    CPLString           osMemFileName{};
+    std::vector<GByte>  abyBlob{};
+    std::vector<GByte>* pabyTileData = nullptr;
+    double              dfTileOffset = 0.0;
+    double              dfTileScale = 1.0;
+};
+} // namespace
+
+static void DecodeTileJobFunc(void* pData)
+{
+    GPKGTileDecodeJob* psJob = static_cast<GPKGTileDecodeJob*>(pData);
+    psJob->poDS->ReadTile(psJob->osMemFileName,
+                          psJob->pabyTileData->data(),
+                          psJob->dfTileOffset, psJob->dfTileScale);
+}
+
+/* Decodes in worker threads the tiles of row nRow, starting at nCol, that
+ * a left to right scan of the raster is going to request next. Only used
+ * in read-only mode, without pixel shift. */
+void GDALGPKGMBTilesLikePseudoDataset::PrefetchTiles(int nRow, int nCol)
+{
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+    m_oMapPrefetchedTiles.clear();
+
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    IGetRasterBand(1)->GetBlockSize(&nBlockXSize, &nBlockYSize);
+    const int nRasterXSize = IGetRasterBand(1)->GetXSize();
+    const int nLastCol = std::min(m_nTileMatrixWidth - 1,
+                    (nRasterXSize - 1) / nBlockXSize + m_nShiftXTiles);
+    const int nMaxCol = static_cast<int>(std::min(
+        static_cast<GIntBig>(nLastCol),
+        static_cast<GIntBig>(nCol) + 2 * poMainDS->m_nTileJobThreads - 1));
+    if( nMaxCol <= nCol )
+        return;
+
+    // Establish m_poCT from this thread, as ReadTile() needs it
+    IGetRasterBand(1)->GetColorTable();
+
+    char *pszSQL = sqlite3_mprintf( "SELECT tile_column, tile_data%s FROM \"%w\" "
+        "WHERE zoom_level = %d AND tile_row = %d AND "
+        "tile_column BETWEEN %d AND %d%s",
+        m_eDT != GDT_Byte ? ", id" : "", // MBTiles do not have an id
+        m_osRasterTable.c_str(), m_nZoomLevel, GetRowFromIntoTopConvention(nRow),
+        nCol, nMaxCol,
+        !m_osWHERE.empty() ? CPLSPrintf(" AND (%s)", m_osWHERE.c_str()): "");
+#ifdef DEBUG_VERBOSE
+    CPLDebug("GPKG", "%s", pszSQL);
+#endif
+    sqlite3_stmt *hStmt = nullptr;
+    int rc = sqlite3_prepare_v2( IGetDB(), pszSQL, -1, &hStmt, nullptr );
+    sqlite3_free(pszSQL);
+    if ( rc != SQLITE_OK )
+        return;
+
+    const int nTileBands = m_eDT == GDT_Byte ? 4 : 1;
+    const size_t nTileSize = nTileBands *
+        static_cast<size_t>(nBlockXSize) * nBlockYSize * m_nDTSize;
+    std::vector<GPKGTileDecodeJob> asJobs;
+    asJobs.reserve(nMaxCol - nCol + 1);
+    while( (rc = sqlite3_step(hStmt)) == SQLITE_ROW )
+    {
+        const int nTileCol = sqlite3_column_int(hStmt, 0);
+        const auto oKey = std::make_pair(nRow, nTileCol);
+        if( sqlite3_column_type(hStmt, 1) != SQLITE_BLOB ||
+            nTileCol < nCol || nTileCol > nMaxCol ||
+            m_oMapPrefetchedTiles.find(oKey) != m_oMapPrefetchedTiles.end() )
+        {
+            continue;
+        }
+        auto& abyTileData = m_oMapPrefetchedTiles[oKey];
+        abyTileData.resize(nTileSize);
+
+        GPKGTileDecodeJob sJob;
+        sJob.poDS = this;
+        sJob.pabyTileData = &abyTileData;
+        const GByte* pabyRawData =
+            static_cast<const GByte*>(sqlite3_column_blob(hStmt, 1));
+        sJob.abyBlob.assign(pabyRawData,
+                            pabyRawData + sqlite3_column_bytes(hStmt, 1));
+        if( m_eDT != GDT_Byte )
+        {
+            GetTileOffsetAndScale(sqlite3_column_int64(hStmt, 2),
+                                  sJob.dfTileOffset, sJob.dfTileScale);
+        }
+        asJobs.push_back(std::move(sJob));
+    }
+    sqlite3_finalize(hStmt);
+    if( rc != SQLITE_DONE )
+    {
+        // Let ReadTile() go through its usual error reporting
+        m_oMapPrefetchedTiles.clear();
+        return;
+    }
+
+    for( int iCol = nCol; iCol <= nMaxCol; ++iCol )
+    {
+        const auto oKey = std::make_pair(nRow, iCol);
+        if( m_oMapPrefetchedTiles.find(oKey) == m_oMapPrefetchedTiles.end() )
+        {
+            auto& abyTileData = m_oMapPrefetchedTiles[oKey];
+            abyTileData.resize(nTileSize);
+            FillEmptyTile(abyTileData.data());
+        }
+    }
+
+    // Decoding goes through the block cache: prevent worker threads from
+    // flushing dirty blocks of other datasets while we wait for them.
+    GDALRasterBlock::EnterDisableDirtyBlockFlush();
+    for( auto& sJob: asJobs )
+    {
+        sJob.osMemFileName.Printf("/vsimem/gpkg_read_tile_job_%p", &sJob);
+        VSIFCloseL(VSIFileFromMemBuffer(sJob.osMemFileName.c_str(),
+                                        sJob.abyBlob.data(),
+                                        sJob.abyBlob.size(), FALSE));
+        if( !poMainDS->m_poTileJobQueue->SubmitJob(DecodeTileJobFunc, &sJob) )
+            DecodeTileJobFunc(&sJob);
+    }
+    poMainDS->m_poTileJobQueue->WaitCompletion();
+    GDALRasterBlock::LeaveDisableDirtyBlockFlush();
+
+    for( const auto& sJob: asJobs )
+        VSIUnlink(sJob.osMemFileName);
+}
+
 /************************************************************************/
 /*                         IReadBlock()                                 */
 /************************************************************************/
@@ -1275,6 +1496,9 @@ GIntBig GDALGPKGMBTilesLikePseudoDataset::GetTileId(int nRow, int nCol)
 
 bool GDALGPKGMBTilesLikePseudoDataset::DeleteTile(int nRow, int nCol)
 {
+    // Do not let a pending encoding of that tile re-create it afterwards
+    WaitCompletionForTile(nRow, nCol);
+
     char* pszSQL = sqlite3_mprintf("DELETE FROM \"%w\" "
         "WHERE zoom_level = %d AND tile_row = %d AND "
         "tile_column = %d",
@@ -1733,6 +1957,32 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
     GDALDriver* l_poDriver = (GDALDriver*) GDALGetDriverByName(pszDriverName);
     if( l_poDriver != nullptr)
     {
+        // Encoding of tiles through the GTiff driver goes through the block
+        // cache, so do not run it in worker threads.
+        GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+        const bool bAsync = poMainDS->m_poTileJobQueue != nullptr &&
+                            m_eTF != GPKG_TF_TIFF_32BIT_FLOAT;
+        CPLErr eErrPreviousJob = CE_None;
+        GPKGTileEncodeJob sSyncJob;
+        GPKGTileEncodeJob* psJob = &sSyncJob;
+        GByte* pabyTileData = m_pabyCachedTiles;
+        if( bAsync )
+        {
+            // Work on a copy of the cached tile, so that it can be reused
+            // while this one is being encoded.
+            const int iJob = GetFreeTileEncodeJob(eErrPreviousJob);
+            psJob = &poMainDS->m_asTileEncodeJobs[iJob];
+            const int nCachedTileBands = m_eDT == GDT_Byte ? 4 : 1;
+            psJob->abyTileData.resize(nCachedTileBands * nBandBlockSize);
+            memcpy(psJob->abyTileData.data(), m_pabyCachedTiles,
+                   psJob->abyTileData.size());
+            pabyTileData = psJob->abyTileData.data();
+        }
+        else
+        {
+            sSyncJob.osMemFileName = osMemFileName;
+        }
+
         GDALDataset* poMEMDS = MEMDataset::Create("", nBlockXSize, nBlockYSize,
                                                   0, eTileDT, nullptr);
         int nTileBands = nBands;
@@ -1783,11 +2033,11 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
         if( bPartialTile && (nTileBands == 2 || nTileBands == 4) )
         {
             int nTargetAlphaBand = nTileBands;
-            memset(m_pabyCachedTiles + (nTargetAlphaBand-1) * nBandBlockSize, 0,
+            memset(pabyTileData + (nTargetAlphaBand-1) * nBandBlockSize, 0,
                    nBandBlockSize);
             for(GPtrDiff_t iY = iYOff; iY < iYOff + iYCount; iY ++)
             {
-                memset(m_pabyCachedTiles + (static_cast<size_t>(nTargetAlphaBand-1) * nBlockYSize + iY) * nBlockXSize + iXOff,
+                memset(pabyTileData + (static_cast<size_t>(nTargetAlphaBand-1) * nBlockYSize + iY) * nBlockXSize + iXOff,
                        255, iXCount);
             }
         }
@@ -1807,7 +2057,7 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
 
             if( m_eDT == GDT_Int16 )
             {
-                ProcessInt16UInt16Tile<GInt16>( m_pabyCachedTiles,
+                ProcessInt16UInt16Tile<GInt16>( pabyTileData,
                                                 static_cast<GPtrDiff_t>(nBlockXSize) * nBlockYSize,
                                                 true,
                                                 CPL_TO_BOOL(bHasNoData),
@@ -1826,7 +2076,7 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
             }
             else if( m_eDT == GDT_UInt16 )
             {
-                ProcessInt16UInt16Tile<GUInt16>( m_pabyCachedTiles,
+                ProcessInt16UInt16Tile<GUInt16>( pabyTileData,
                                                 static_cast<GPtrDiff_t>(nBlockXSize) * nBlockYSize,
                                                 false,
                                                 CPL_TO_BOOL(bHasNoData),
@@ -1846,7 +2096,7 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
             else if( m_eDT == GDT_Float32 )
             {
                 const float* pSrc = reinterpret_cast<float*>(
-                                                        m_pabyCachedTiles);
+                                                        pabyTileData);
                 float fMin = 0.0f;
                 float fMax = 0.0f;
                 double dfM2 = 0.0;
@@ -1960,7 +2210,7 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
         }
         else if( m_eTF == GPKG_TF_TIFF_32BIT_FLOAT )
         {
-            const float* pSrc = reinterpret_cast<float*>(m_pabyCachedTiles);
+            const float* pSrc = reinterpret_cast<float*>(pabyTileData);
             float fMin = 0.0f;
             float fMax = 0.0f;
             double dfM2 = 0.0;
@@ -2001,7 +2251,7 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
             char** papszOptions = nullptr;
             char szDataPointer[32];
             int nRet = CPLPrintPointer(szDataPointer,
-                        m_pabyCachedTiles,
+                        pabyTileData,
                         sizeof(szDataPointer));
             szDataPointer[nRet] = '\0';
             papszOptions = CSLSetNameValue(papszOptions,
@@ -2025,7 +2275,7 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
                 else if( nBands == 2 && nTileBands >= 3 )
                     iSrc = (i < 3) ? 0 : 1;
                 int nRet = CPLPrintPointer(szDataPointer,
-                        m_pabyCachedTiles + iSrc * nBlockXSize * nBlockYSize,
+                        pabyTileData + iSrc * nBlockXSize * nBlockYSize,
                         sizeof(szDataPointer));
                 szDataPointer[nRet] = '\0';
                 papszOptions = CSLSetNameValue(papszOptions,
@@ -2043,6 +2293,8 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
         {
             // If tile is fully transparent, don't serialize it and remove
             // it if it exists.
+            if( bAsync )
+                WaitCompletionForTile(nRow, nCol);
             GIntBig nId = GetTileId(nRow, nCol);
             if( nId > 0 )
             {
@@ -2053,7 +2305,7 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
 
             CPLFree(pTempTileBuffer);
             delete poMEMDS;
-            return CE_None;
+            return eErrPreviousJob;
         }
 
         if( m_eTF == GPKG_TF_PNG8 && nTileBands == 1 && nBands >= 3 )
@@ -2065,7 +2317,7 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
                 char** papszOptions = nullptr;
                 char szDataPointer[32];
                 int nRet = CPLPrintPointer(szDataPointer,
-                                        m_pabyCachedTiles + i * nBandBlockSize,
+                                        pabyTileData + i * nBandBlockSize,
                                         sizeof(szDataPointer));
                 szDataPointer[nRet] = '\0';
                 papszOptions = CSLSetNameValue(papszOptions, "DATAPOINTER", szDataPointer);
@@ -2086,9 +2338,9 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
                                        poMEM_RGB_DS->GetRasterBand(2),
                                        poMEM_RGB_DS->GetRasterBand(3),
                                        /*NULL, NULL, NULL,*/
-                                       m_pabyCachedTiles,
-                                       m_pabyCachedTiles + nBandBlockSize,
-                                       m_pabyCachedTiles + 2 * nBandBlockSize,
+                                       pabyTileData,
+                                       pabyTileData + nBandBlockSize,
+                                       pabyTileData + 2 * nBandBlockSize,
                                        nullptr,
                                        256, /* max colors */
                                        8, /* bit depth */
@@ -2130,46 +2382,46 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
             }
             if( iYOff > 0 )
             {
-                memset(m_pabyCachedTiles + 0 * nBandBlockSize, 0, nBlockXSize * iYOff);
-                memset(m_pabyCachedTiles + 1 * nBandBlockSize, 0, nBlockXSize * iYOff);
-                memset(m_pabyCachedTiles + 2 * nBandBlockSize, 0, nBlockXSize * iYOff);
-                memset(m_pabyCachedTiles + 3 * nBandBlockSize, 0, nBlockXSize * iYOff);
+                memset(pabyTileData + 0 * nBandBlockSize, 0, nBlockXSize * iYOff);
+                memset(pabyTileData + 1 * nBandBlockSize, 0, nBlockXSize * iYOff);
+                memset(pabyTileData + 2 * nBandBlockSize, 0, nBlockXSize * iYOff);
+                memset(pabyTileData + 3 * nBandBlockSize, 0, nBlockXSize * iYOff);
             }
             for(GPtrDiff_t iY = iYOff; iY < iYOff + iYCount; iY ++)
             {
                 if( iXOff > 0 )
                 {
                     const GPtrDiff_t i = iY * nBlockXSize;
-                    memset(m_pabyCachedTiles + 0 * nBandBlockSize + i, 0, iXOff);
-                    memset(m_pabyCachedTiles + 1 * nBandBlockSize + i, 0, iXOff);
-                    memset(m_pabyCachedTiles + 2 * nBandBlockSize + i, 0, iXOff);
-                    memset(m_pabyCachedTiles + 3 * nBandBlockSize + i, 0, iXOff);
+                    memset(pabyTileData + 0 * nBandBlockSize + i, 0, iXOff);
+                    memset(pabyTileData + 1 * nBandBlockSize + i, 0, iXOff);
+                    memset(pabyTileData + 2 * nBandBlockSize + i, 0, iXOff);
+                    memset(pabyTileData + 3 * nBandBlockSize + i, 0, iXOff);
                 }
                 for(int iX = iXOff; iX < iXOff + iXCount; iX ++)
                 {
                     const GPtrDiff_t i = iY * nBlockXSize + iX;
-                    GByte byVal = m_pabyCachedTiles[i];
-                    m_pabyCachedTiles[i] = abyCT[4*byVal];
-                    m_pabyCachedTiles[i + 1 * nBandBlockSize] = abyCT[4*byVal+1];
-                    m_pabyCachedTiles[i + 2 * nBandBlockSize] = abyCT[4*byVal+2];
-                    m_pabyCachedTiles[i + 3 * nBandBlockSize] = abyCT[4*byVal+3];
+                    GByte byVal = pabyTileData[i];
+                    pabyTileData[i] = abyCT[4*byVal];
+                    pabyTileData[i + 1 * nBandBlockSize] = abyCT[4*byVal+1];
+                    pabyTileData[i + 2 * nBandBlockSize] = abyCT[4*byVal+2];
+                    pabyTileData[i + 3 * nBandBlockSize] = abyCT[4*byVal+3];
                 }
                 if( iXOff + iXCount < nBlockXSize )
                 {
                     const GPtrDiff_t i = iY * nBlockXSize + iXOff + iXCount;
-                    memset(m_pabyCachedTiles + 0 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
-                    memset(m_pabyCachedTiles + 1 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
-                    memset(m_pabyCachedTiles + 2 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
-                    memset(m_pabyCachedTiles + 3 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
+                    memset(pabyTileData + 0 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
+                    memset(pabyTileData + 1 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
+                    memset(pabyTileData + 2 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
+                    memset(pabyTileData + 3 * nBandBlockSize + i, 0, nBlockXSize - (iXOff + iXCount));
                 }
             }
             if( iYOff + iYCount < nBlockYSize )
             {
                 const GPtrDiff_t i = (iYOff + iYCount) * nBlockXSize;
-                memset(m_pabyCachedTiles + 0 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
-                memset(m_pabyCachedTiles + 1 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
-                memset(m_pabyCachedTiles + 2 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
-                memset(m_pabyCachedTiles + 3 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
+                memset(pabyTileData + 0 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
+                memset(pabyTileData + 1 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
+                memset(pabyTileData + 2 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
+                memset(pabyTileData + 3 * nBandBlockSize + i, 0, nBlockXSize * (nBlockYSize - (iYOff + iYCount)));
             }
         }
 
@@ -2198,135 +2450,341 @@ CPLErr GDALGPKGMBTilesLikePseudoDataset::WriteTileInternal()
         }
 #ifdef DEBUG
         VSIStatBufL sStat;
-        CPLAssert(VSIStatL(osMemFileName, &sStat) != 0);
+        CPLAssert(VSIStatL(psJob->osMemFileName, &sStat) != 0);
 #endif
-        GDALDataset* poOutDS = l_poDriver->CreateCopy(osMemFileName, poMEMDS,
-                                                    FALSE, papszDriverOptions, nullptr, nullptr);
-        CSLDestroy( papszDriverOptions );
-        CPLFree(pTempTileBuffer);
+        psJob->poDS = this;
+        psJob->nRow = nRow;
+        psJob->nCol = nCol;
+        psJob->bReady = false;
+        psJob->bSuccess = false;
+        psJob->poDriver = l_poDriver;
+        psJob->poMEMDS = poMEMDS;
+        psJob->papszDriverOptions = papszDriverOptions;
+        psJob->pTempTileBuffer = pTempTileBuffer;
+        psJob->dfTileOffset = dfTileOffset;
+        psJob->dfTileScale = dfTileScale;
+        psJob->dfTileMin = dfTileMin;
+        psJob->dfTileMax = dfTileMax;
+        psJob->dfTileMean = dfTileMean;
+        psJob->dfTileStdDev = dfTileStdDev;
+
+        if( bAsync )
+        {
+            // The tile will be inserted in the database by
+            // WaitCompletionForTileJobIdx()
+            poMainDS->m_anTileEncodeJobQueue.push(
+                static_cast<int>(psJob - &poMainDS->m_asTileEncodeJobs[0]));
+            poMainDS->m_poTileJobQueue->SubmitJob(EncodeTileJobFunc, psJob);
+            return eErrPreviousJob;
+        }
+
+        EncodeTileJobFunc(psJob);
+        eErr = InsertEncodedTile(*psJob);
+    }
+    else
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Cannot find driver %s", pszDriverName);
+    }
 
-        if( poOutDS )
-        {
-            GDALClose( poOutDS );
-            vsi_l_offset nBlobSize = 0;
-            GByte* pabyBlob =
-                VSIGetMemFileBuffer(osMemFileName, &nBlobSize, TRUE);
+    return eErr;
+}
 
-            /* Create or commit and recreate transaction */
-            GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
-            if( poMainDS->m_nTileInsertionCount == 0 )
-            {
-                poMainDS->IStartTransaction();
-            }
-            else if( poMainDS->m_nTileInsertionCount == 1000 )
+/************************************************************************/
+/*                         EncodeTileJobFunc()                          */
+/************************************************************************/
+
+void GDALGPKGMBTilesLikePseudoDataset::EncodeTileJobFunc(void* pData)
+{
+    GPKGTileEncodeJob* psJob = static_cast<GPKGTileEncodeJob*>(pData);
+
+    GDALDataset* poOutDS = psJob->poDriver->CreateCopy(
+        psJob->osMemFileName, psJob->poMEMDS,
+        FALSE, psJob->papszDriverOptions, nullptr, nullptr);
+    psJob->bSuccess = poOutDS != nullptr;
+    if( poOutDS )
+        GDALClose( poOutDS );
+
+    delete psJob->poMEMDS;
+    psJob->poMEMDS = nullptr;
+    CSLDestroy( psJob->papszDriverOptions );
+    psJob->papszDriverOptions = nullptr;
+    CPLFree( psJob->pTempTileBuffer );
+    psJob->pTempTileBuffer = nullptr;
+
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS =
+        psJob->poDS->m_poParentDS ? psJob->poDS->m_poParentDS : psJob->poDS;
+    if( poMainDS->m_hTileJobMutex )
+    {
+        CPLAcquireMutex(poMainDS->m_hTileJobMutex, 1000.0);
+        psJob->bReady = true;
+        CPLReleaseMutex(poMainDS->m_hTileJobMutex);
+    }
+    else
+    {
+        psJob->bReady = true;
+    }
+}
+
+/************************************************************************/
+/*                         InsertEncodedTile()                          */
+/************************************************************************/
+
+/* Inserts the result of EncodeTileJobFunc() into the tile table. Must be
+ * called from the thread that owns the dataset. */
+CPLErr GDALGPKGMBTilesLikePseudoDataset::InsertEncodedTile(
+                                                    GPKGTileEncodeJob& sJob)
+{
+    CPLErr eErr = CE_Failure;
+    const int nRow = sJob.nRow;
+    const int nCol = sJob.nCol;
+    const CPLString& osMemFileName = sJob.osMemFileName;
+
+    if( sJob.bSuccess )
+    {
+        vsi_l_offset nBlobSize = 0;
+        GByte* pabyBlob =
+            VSIGetMemFileBuffer(osMemFileName, &nBlobSize, TRUE);
+
+        /* Create or commit and recreate transaction */
+        GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+        if( poMainDS->m_nTileInsertionCount < 0 )
+        {
+            CPLFree(pabyBlob);
+            VSIUnlink(osMemFileName);
+            return CE_Failure;
+        }
+        if( poMainDS->m_nTileInsertionCount == 0 )
+        {
+            poMainDS->IStartTransaction();
+        }
+        else if( poMainDS->m_nTileInsertionCount == 1000 )
+        {
+            if( poMainDS->ICommitTransaction() != OGRERR_NONE )
             {
-                if( poMainDS->ICommitTransaction() != OGRERR_NONE )
-                {
-                    poMainDS->m_nTileInsertionCount = -1;
-                    CPLFree(pabyBlob);
-                    VSIUnlink(osMemFileName);
-                    delete poMEMDS;
-                    return CE_Failure;
-                }
-                poMainDS->IStartTransaction();
-                poMainDS->m_nTileInsertionCount = 0;
+                poMainDS->m_nTileInsertionCount = -1;
+                CPLFree(pabyBlob);
+                VSIUnlink(osMemFileName);
+                return CE_Failure;
             }
-            poMainDS->m_nTileInsertionCount ++;
+            poMainDS->IStartTransaction();
+            poMainDS->m_nTileInsertionCount = 0;
+        }
+        poMainDS->m_nTileInsertionCount ++;
 
-            char* pszSQL = sqlite3_mprintf("INSERT OR REPLACE INTO \"%w\" "
-                "(zoom_level, tile_row, tile_column, tile_data) VALUES (%d, %d, %d, ?)",
-                m_osRasterTable.c_str(), m_nZoomLevel, GetRowFromIntoTopConvention(nRow), nCol);
+        char* pszSQL = sqlite3_mprintf("INSERT OR REPLACE INTO \"%w\" "
+            "(zoom_level, tile_row, tile_column, tile_data) VALUES (%d, %d, %d, ?)",
+            m_osRasterTable.c_str(), m_nZoomLevel, GetRowFromIntoTopConvention(nRow), nCol);
 #ifdef DEBUG_VERBOSE
-            CPLDebug("GPKG", "%s", pszSQL);
+        CPLDebug("GPKG", "%s", pszSQL);
 #endif
-            sqlite3_stmt* hStmt = nullptr;
-            int rc = sqlite3_prepare_v2(IGetDB(), pszSQL, -1, &hStmt, nullptr);
-            if ( rc != SQLITE_OK )
-            {
-                CPLError( CE_Failure, CPLE_AppDefined,
-                          "failed to prepare SQL %s: %s",
-                          pszSQL, sqlite3_errmsg(IGetDB()) );
-                CPLFree(pabyBlob);
-            }
+        sqlite3_stmt* hStmt = nullptr;
+        int rc = sqlite3_prepare_v2(IGetDB(), pszSQL, -1, &hStmt, nullptr);
+        if ( rc != SQLITE_OK )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "failed to prepare SQL %s: %s",
+                      pszSQL, sqlite3_errmsg(IGetDB()) );
+            CPLFree(pabyBlob);
+        }
+        else
+        {
+            sqlite3_bind_blob( hStmt, 1, pabyBlob, (int)nBlobSize, CPLFree);
+            rc = sqlite3_step( hStmt );
+            if( rc == SQLITE_DONE )
+                eErr = CE_None;
             else
             {
-                sqlite3_bind_blob( hStmt, 1, pabyBlob, (int)nBlobSize, CPLFree);
-                rc = sqlite3_step( hStmt );
-                if( rc == SQLITE_DONE )
-                    eErr = CE_None;
-                else
-                {
-                    CPLError(CE_Failure, CPLE_AppDefined,
-                             "Failure when inserting tile (row=%d,col=%d) at zoom_level=%d : %s",
-                             GetRowFromIntoTopConvention(nRow), nCol, m_nZoomLevel, sqlite3_errmsg(IGetDB()));
-                }
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "Failure when inserting tile (row=%d,col=%d) at zoom_level=%d : %s",
+                         GetRowFromIntoTopConvention(nRow), nCol, m_nZoomLevel, sqlite3_errmsg(IGetDB()));
             }
-            sqlite3_finalize(hStmt);
-            sqlite3_free(pszSQL);
+        }
+        sqlite3_finalize(hStmt);
+        sqlite3_free(pszSQL);
 
-            if( m_eTF == GPKG_TF_PNG_16BIT ||
-                m_eTF == GPKG_TF_TIFF_32BIT_FLOAT )
+        if( m_eTF == GPKG_TF_PNG_16BIT ||
+            m_eTF == GPKG_TF_TIFF_32BIT_FLOAT )
+        {
+            GIntBig nTileId = GetTileId(nRow, nCol);
+            if( nTileId == 0 )
+                eErr = CE_Failure;
+            else
             {
-                GIntBig nTileId = GetTileId(nRow, nCol);
-                if( nTileId == 0 )
+                DeleteFromGriddedTileAncillary(nTileId);
+
+                pszSQL = sqlite3_mprintf(
+                    "INSERT INTO gpkg_2d_gridded_tile_ancillary "
+                    "(tpudt_name, tpudt_id, scale, offset, min, max, "
+                    "mean, std_dev) VALUES "
+                    "('%q', ?, %.18g, %.18g, ?, ?, ?, ?)",
+                    m_osRasterTable.c_str(), sJob.dfTileScale,
+                    sJob.dfTileOffset);
+#ifdef DEBUG_VERBOSE
+                CPLDebug("GPKG", "%s", pszSQL);
+#endif
+                hStmt = nullptr;
+                rc = sqlite3_prepare_v2(IGetDB(), pszSQL, -1, &hStmt, nullptr);
+                if ( rc != SQLITE_OK )
+                {
                     eErr = CE_Failure;
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                              "failed to prepare SQL %s: %s",
+                              pszSQL, sqlite3_errmsg(IGetDB()) );
+                }
                 else
                 {
-                    DeleteFromGriddedTileAncillary(nTileId);
-
-                    pszSQL = sqlite3_mprintf(
-                        "INSERT INTO gpkg_2d_gridded_tile_ancillary "
-                        "(tpudt_name, tpudt_id, scale, offset, min, max, "
-                        "mean, std_dev) VALUES "
-                        "('%q', ?, %.18g, %.18g, ?, ?, ?, ?)",
-                        m_osRasterTable.c_str(), dfTileScale, dfTileOffset);
-#ifdef DEBUG_VERBOSE
-                    CPLDebug("GPKG", "%s", pszSQL);
-#endif
-                    hStmt = nullptr;
-                    rc = sqlite3_prepare_v2(IGetDB(), pszSQL, -1, &hStmt, nullptr);
-                    if ( rc != SQLITE_OK )
+                    sqlite3_bind_int64( hStmt, 1, nTileId );
+                    sqlite3_bind_double( hStmt, 2, sJob.dfTileMin );
+                    sqlite3_bind_double( hStmt, 3, sJob.dfTileMax );
+                    sqlite3_bind_double( hStmt, 4, sJob.dfTileMean );
+                    sqlite3_bind_double( hStmt, 5, sJob.dfTileStdDev );
+                    rc = sqlite3_step( hStmt );
+                    if( rc == SQLITE_DONE )
                     {
-                        eErr = CE_Failure;
-                        CPLError( CE_Failure, CPLE_AppDefined,
-                                  "failed to prepare SQL %s: %s",
-                                  pszSQL, sqlite3_errmsg(IGetDB()) );
+                        eErr = CE_None;
                     }
                     else
                     {
-                        sqlite3_bind_int64( hStmt, 1, nTileId );
-                        sqlite3_bind_double( hStmt, 2, dfTileMin );
-                        sqlite3_bind_double( hStmt, 3, dfTileMax );
-                        sqlite3_bind_double( hStmt, 4, dfTileMean );
-                        sqlite3_bind_double( hStmt, 5, dfTileStdDev );
-                        rc = sqlite3_step( hStmt );
-                        if( rc == SQLITE_DONE )
-                        {
-                            eErr = CE_None;
-                        }
-                        else
-                        {
-                            CPLError(CE_Failure, CPLE_AppDefined,
-                                "Cannot insert into "
-                                "gpkg_2d_gridded_tile_ancillary");
-                            eErr = CE_Failure;
-                        }
+                        CPLError(CE_Failure, CPLE_AppDefined,
+                            "Cannot insert into "
+                            "gpkg_2d_gridded_tile_ancillary");
+                        eErr = CE_Failure;
                     }
-                    sqlite3_finalize(hStmt);
-                    sqlite3_free(pszSQL);
                 }
+                sqlite3_finalize(hStmt);
+                sqlite3_free(pszSQL);
             }
         }
+    }
 
-        VSIUnlink(osMemFileName);
-        delete poMEMDS;
+    VSIUnlink(osMemFileName);
+    return eErr;
+}
+
+/************************************************************************/
+/*                       GetFreeTileEncodeJob()                         */
+/************************************************************************/
+
+/* Returns the index of an unused slot of m_asTileEncodeJobs, waiting for
+ * the oldest pending job if all are in use. eErr is set to the status of
+ * the insertion of that job. */
+int GDALGPKGMBTilesLikePseudoDataset::GetFreeTileEncodeJob(CPLErr& eErr)
+{
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+    auto& oQueue = poMainDS->m_anTileEncodeJobQueue;
+    auto& asJobs = poMainDS->m_asTileEncodeJobs;
+
+    eErr = CE_None;
+    if( oQueue.size() == asJobs.size() )
+    {
+        CPLAssert( !oQueue.empty() );
+        const int i = oQueue.front();
+        eErr = WaitCompletionForTileJobIdx(i);
+        return i;
     }
-    else
+
+    const int nJobs = static_cast<int>(asJobs.size());
+    for( int i = 0; i < nJobs; ++i )
     {
-        CPLError(CE_Failure, CPLE_NotSupported,
-                 "Cannot find driver %s", pszDriverName);
+        if( asJobs[i].poDS == nullptr )
+            return i;
     }
+    CPLAssert(false);
+    return 0;
+}
+
+/************************************************************************/
+/*                     WaitCompletionForTileJobIdx()                    */
+/************************************************************************/
+
+/* Waits for the job at the front of the queue and inserts its tile. */
+CPLErr GDALGPKGMBTilesLikePseudoDataset::WaitCompletionForTileJobIdx(int i)
+{
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+    auto& oQueue = poMainDS->m_anTileEncodeJobQueue;
+    GPKGTileEncodeJob& sJob = poMainDS->m_asTileEncodeJobs[i];
+
+    CPLAssert( !oQueue.empty() && oQueue.front() == i );
+    CPLAssert( sJob.poDS != nullptr );
+
+    bool bHasWarned = false;
+    while( true )
+    {
+        CPLAcquireMutex(poMainDS->m_hTileJobMutex, 1000.0);
+        const bool bReady = sJob.bReady;
+        CPLReleaseMutex(poMainDS->m_hTileJobMutex);
+        if( bReady )
+            break;
+        if( !bHasWarned )
+        {
+            CPLDebug("GPKG",
+                     "Waiting for worker job to finish encoding tile "
+                     "(row=%d, col=%d)", sJob.nRow, sJob.nCol);
+            bHasWarned = true;
+        }
+        poMainDS->m_poTileJobQueue->GetPool()->WaitEvent();
+    }
+
+    oQueue.pop();
+    const CPLErr eErr = sJob.poDS->InsertEncodedTile(sJob);
+    sJob.poDS = nullptr;
+    sJob.bReady = false;
+    return eErr;
+}
 
+/************************************************************************/
+/*                       WaitCompletionForTile()                        */
+/************************************************************************/
+
+/* Makes sure that pending encodings of the tile have been inserted. */
+CPLErr GDALGPKGMBTilesLikePseudoDataset::WaitCompletionForTile(int nRow,
+                                                               int nCol)
+{
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+    if( poMainDS->m_poTileJobQueue == nullptr )
+        return CE_None;
+    auto& oQueue = poMainDS->m_anTileEncodeJobQueue;
+    const auto& asJobs = poMainDS->m_asTileEncodeJobs;
+
+    // Find the most recently submitted job for that tile
+    int nJobsToWait = 0;
+    {
+        std::queue<int> oQueueCopy(oQueue);
+        int nIdx = 0;
+        while( !oQueueCopy.empty() )
+        {
+            const auto& sJob = asJobs[oQueueCopy.front()];
+            oQueueCopy.pop();
+            ++nIdx;
+            if( sJob.poDS == this && sJob.nRow == nRow && sJob.nCol == nCol )
+                nJobsToWait = nIdx;
+        }
+    }
+
+    CPLErr eErr = CE_None;
+    for( int i = 0; i < nJobsToWait; ++i )
+    {
+        if( WaitCompletionForTileJobIdx(oQueue.front()) != CE_None )
+            eErr = CE_Failure;
+    }
+    return eErr;
+}
+
+/************************************************************************/
+/*                     WaitCompletionForAllTileJobs()                   */
+/************************************************************************/
+
+CPLErr GDALGPKGMBTilesLikePseudoDataset::WaitCompletionForAllTileJobs()
+{
+    GDALGPKGMBTilesLikePseudoDataset* poMainDS = m_poParentDS ? m_poParentDS : this;
+    CPLErr eErr = CE_None;
+    while( !poMainDS->m_anTileEncodeJobQueue.empty() )
+    {
+        if( WaitCompletionForTileJobIdx(
+                poMainDS->m_anTileEncodeJobQueue.front()) != CE_None )
+            eErr = CE_Failure;
+    }
     return eErr;
 }
 
@@ -31,9 +31,17 @@
 #define GPKGMBTILESCOMMON_H_INCLUDED
 
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal_pam.h"
+#include "gdalwarper.h"
 #include "ogr_sqlite.h" // for sqlite3*
 
+#include <map>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
 typedef struct
 {
     int     nRow;
@@ -55,6 +63,42 @@ typedef enum
 
 GPKGTileFormat GDALGPKGMBTilesGetTileFormat(const char* pszTF );
 
+CPLErr GDALGPKGMBTilesWarpToTiles( GDALDataset* poSrcDS,
+                                   GDALDataset* poDstDS,
+                                   char** papszTO,
+                                   GDALResampleAlg eResampleAlg,
+                                   GDALDataType eWorkingDataType,
+                                   bool bSampleGrid,
+                                   const double* pdfNoDataValue,
+                                   CSLConstList papszOptions,
+                                   GDALProgressFunc pfnProgress,
+                                   void* pProgressData );
+
+class GDALGPKGMBTilesLikePseudoDataset;
+
+// Encoding of a tile, possibly run in a worker thread. The resulting blob
+// is inserted in the database by the thread that owns the dataset.
+struct GPKGTileEncodeJob
+{
+    GDALGPKGMBTilesLikePseudoDataset* poDS = nullptr; // nullptr if slot free
+    int                 nRow = -1;
+    int                 nCol = -1;
+    bool                bReady = false;
+    bool                bSuccess = false;
+    std::vector<GByte>  abyTileData{}; // copy of the cached tile
+    GDALDriver*         poDriver = nullptr;
+    GDALDataset*        poMEMDS = nullptr;
+    char**              papszDriverOptions = nullptr;
+    GUInt16*            pTempTileBuffer = nullptr;
+    CPLString           osMemFileName{};
+    double              dfTileOffset = 0.0;
+    double              dfTileScale = 1.0;
+    double              dfTileMin = 0.0;
+    double              dfTileMax = 0.0;
+    double              dfTileMean = 0.0;
+    double              dfTileStdDev = 0.0;
+};
+
 class GDALGPKGMBTilesLikePseudoDataset
 {
     friend class GDALGPKGMBTilesLikeRasterBand;
@@ -104,9 +148,26 @@ class GDALGPKGMBTilesLikePseudoDataset
 
     GDALGPKGMBTilesLikePseudoDataset* m_poParentDS;
 
+    // Only set on the full resolution dataset, and shared with overviews.
+    std::unique_ptr<CPLJobQueue>    m_poTileJobQueue{};
+    CPLMutex                       *m_hTileJobMutex = nullptr;
+    int                             m_nTileJobThreads = 0;
+    std::vector<GPKGTileEncodeJob>  m_asTileEncodeJobs{};
+    std::queue<int>                 m_anTileEncodeJobQueue{}; // indices in m_asTileEncodeJobs
+
+    // Tiles decoded ahead of time by PrefetchTiles(), keyed by (row, col)
+    std::map<std::pair<int, int>, std::vector<GByte>> m_oMapPrefetchedTiles{};
+
   private:
         bool                    m_bInWriteTile;
         CPLErr                  WriteTileInternal(); /* should only be called by WriteTile() */
+        CPLErr                  InsertEncodedTile(GPKGTileEncodeJob& sJob);
+        static void             EncodeTileJobFunc(void* pData);
+        int                     GetFreeTileEncodeJob(CPLErr& eErr);
+        CPLErr                  WaitCompletionForTileJobIdx(int i);
+        CPLErr                  WaitCompletionForTile(int nRow, int nCol);
+        CPLErr                  WaitCompletionForAllTileJobs();
+        void                    PrefetchTiles(int nRow, int nCol);
         GIntBig                 GetTileId(int nRow, int nCol);
         bool                    DeleteTile(int nRow, int nCol);
         bool                    DeleteFromGriddedTileAncillary(GIntBig nTileId);
@@ -124,6 +185,7 @@ class GDALGPKGMBTilesLikePseudoDataset
         void                    SetDataType(GDALDataType eDT);
         void                    SetGlobalOffsetScale(double dfOffset,
                                                      double dfScale);
+        void                    InitializeWorkerThreads(char** papszOptions);
 
         CPLErr                  ReadTile(const CPLString& osMemFileName,
                                          GByte* pabyTileData,
@@ -88,6 +88,7 @@ typedef struct
 /************************************************************************/
 
 class OGRGeoPackageTableLayer;
+struct OGRGeoPackageArrowPrefetcher;
 
 class GDALGeoPackageDataset final : public OGRSQLiteBaseDataSource, public GDALGPKGMBTilesLikePseudoDataset
 {
@@ -249,6 +250,7 @@ class GDALGeoPackageDataset final : public OGRSQLiteBaseDataSource, public GDALG
         virtual CPLErr      SetGeoTransform( double* padfGeoTransform ) override;
 
         virtual void        FlushCache() override;
+        virtual GIntBig     GetDriverMemoryUsage() override;
         virtual CPLErr      IBuildOverviews( const char *, int, int *,
                                              int, int *, GDALProgressFunc, void * ) override;
 
@@ -465,6 +467,11 @@ class OGRGeoPackageTableLayer final : public OGRGeoPackageLayer
     } GPKGRTreeEntry;
     std::vector<GPKGRTreeEntry>  m_aoRTreeEntries{};
 
+    // Multi-threaded reading of the Arrow array stream
+    bool                        m_bIsArrowPrefetchWorker = false;
+    bool                        m_bArrowPrefetchAttempted = false;
+    std::unique_ptr<OGRGeoPackageArrowPrefetcher> m_poArrowPrefetcher{};
+    std::unique_ptr<OGRGeoPackageArrowPrefetcher> CreateArrowPrefetcher();
 
     virtual OGRErr      ResetStatement() override;
 
@@ -481,6 +488,7 @@ class OGRGeoPackageTableLayer final : public OGRGeoPackageLayer
 #endif
 
     void                CheckGeometryType( OGRFeature *poFeature );
+    void                CheckGeometryType( OGRwkbGeometryType eGeomType );
 
     OGRErr              ReadTableDefinition();
     void                InitView();
@@ -489,6 +497,14 @@ class OGRGeoPackageTableLayer final : public OGRGeoPackageLayer
 
     bool                StartDeferredSpatialIndexUpdate();
     bool                FlushPendingSpatialIndexUpdate();
+    bool                BulkLoadRTree(std::vector<GPKGRTreeEntry>& aoEntries,
+                                      bool& bTryRegularInsertion);
+    bool                UpdateExtentAndSpatialIndex(GIntBig nFID,
+                                                    const OGREnvelope& oEnv);
+
+  protected:
+    virtual int         GetNextArrowArray(struct ArrowArrayStream*,
+                                          struct ArrowArray* out_array) override;
 
     public:
                         OGRGeoPackageTableLayer( GDALGeoPackageDataset *poDS,
@@ -512,6 +528,9 @@ class OGRGeoPackageTableLayer final : public OGRGeoPackageLayer
     virtual OGRErr      ReorderFields( int* panMap ) override;
     void                ResetReading() override;
     OGRErr              ICreateFeature( OGRFeature *poFeater ) override;
+    bool                WriteArrowBatch( const struct ArrowSchema* schema,
+                                         const struct ArrowArray* array,
+                                         CSLConstList papszOptions = nullptr ) override;
     OGRErr              ISetFeature( OGRFeature *poFeature ) override;
     OGRErr              DeleteFeature(GIntBig nFID) override;
     virtual void        SetSpatialFilter( OGRGeometry * ) override;
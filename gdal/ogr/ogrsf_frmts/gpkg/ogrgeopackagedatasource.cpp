@@ -2475,6 +2475,7 @@ bool GDALGeoPackageDataset::OpenRaster( const char* pszTableName,
     }
 
     ParseCompressionOptions(papszOpenOptionsIn);
+    InitializeWorkerThreads(papszOpenOptionsIn);
 
     m_osWHERE = CSLFetchNameValueDef(papszOpenOptionsIn, "WHERE", "");
 
@@ -2825,6 +2826,34 @@ void GDALGeoPackageDataset::FlushCache()
     IFlushCacheWithErrCode();
 }
 
+/************************************************************************/
+/*                        GetDriverMemoryUsage()                        */
+/************************************************************************/
+
+GIntBig GDALGeoPackageDataset::GetDriverMemoryUsage()
+{
+    // Overview datasets share the database connection of their parent, so
+    // only count its page cache once.
+    GIntBig nTotal = m_poParentDS ?
+        GDALPamDataset::GetDriverMemoryUsage() :
+        OGRSQLiteBaseDataSource::GetDriverMemoryUsage();
+
+    if( m_pabyCachedTiles && nBands > 0 )
+    {
+        int nTileWidth = 0;
+        int nTileHeight = 0;
+        papoBands[0]->GetBlockSize(&nTileWidth, &nTileHeight);
+        // Same size as the allocation in InitRaster()
+        nTotal += static_cast<GIntBig>(4) * (m_eDT == GDT_Byte ? 4 : 1) *
+                  m_nDTSize * nTileWidth * nTileHeight;
+    }
+
+    for( int i = 0; i < m_nOverviewCount; ++i )
+        nTotal += m_papoOverviewDS[i]->GetMemoryUsage();
+
+    return nTotal;
+}
+
 CPLErr GDALGeoPackageDataset::IFlushCacheWithErrCode()
 
 {
@@ -4558,6 +4587,7 @@ int GDALGeoPackageDataset::Create( const char * pszFilename,
             GDALPamDataset::SetMetadataItem("DESCRIPTION", m_osDescription);
 
         ParseCompressionOptions(papszOptions);
+        InitializeWorkerThreads(papszOptions);
 
         if( m_eTF == GPKG_TF_WEBP )
         {
@@ -4842,6 +4872,143 @@ static const WarpResamplingAlg asResamplingAlg[] =
     { "RMS", GRA_RMS },
 };
 
+/************************************************************************/
+/*                     GDALGPKGMBTilesWarpToTiles()                     */
+/************************************************************************/
+
+// Warps poSrcDS into poDstDS, which must already be created with the
+// geotransform of the selected zoom level of its tiling scheme. This is
+// the single reprojection pass shared by the CreateCopy() implementations
+// of the GPKG and MBTiles drivers. The warp kernel uses the number of
+// threads of the NUM_THREADS creation option (or GDAL_NUM_THREADS).
+
+CPLErr GDALGPKGMBTilesWarpToTiles( GDALDataset* poSrcDS,
+                                   GDALDataset* poDstDS,
+                                   char** papszTO,
+                                   GDALResampleAlg eResampleAlg,
+                                   GDALDataType eWorkingDataType,
+                                   bool bSampleGrid,
+                                   const double* pdfNoDataValue,
+                                   CSLConstList papszOptions,
+                                   GDALProgressFunc pfnProgress,
+                                   void* pProgressData )
+{
+    void* hTransformArg =
+        GDALCreateGenImgProjTransformer2( poSrcDS, poDstDS, papszTO );
+    if( hTransformArg == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "GDALCreateGenImgProjTransformer2 failed");
+        return CE_Failure;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Warp the transformer with a linear approximator                 */
+/* -------------------------------------------------------------------- */
+    hTransformArg =
+        GDALCreateApproxTransformer( GDALGenImgProjTransform,
+                                     hTransformArg, 0.125 );
+    GDALApproxTransformerOwnsSubtransformer(hTransformArg, TRUE);
+
+/* -------------------------------------------------------------------- */
+/*      Setup warp options.                                             */
+/* -------------------------------------------------------------------- */
+    GDALWarpOptions *psWO = GDALCreateWarpOptions();
+
+    psWO->papszWarpOptions = CSLSetNameValue(nullptr, "OPTIMIZE_SIZE", "YES");
+    if( bSampleGrid )
+    {
+        psWO->papszWarpOptions = CSLSetNameValue(
+                            psWO->papszWarpOptions, "SAMPLE_GRID", "YES");
+    }
+    const char* pszNumThreads = CSLFetchNameValueDef(
+        papszOptions, "NUM_THREADS",
+        CPLGetConfigOption("GDAL_NUM_THREADS", nullptr));
+    if( pszNumThreads )
+    {
+        psWO->papszWarpOptions = CSLSetNameValue(
+                            psWO->papszWarpOptions, "NUM_THREADS",
+                            pszNumThreads);
+    }
+    if( pdfNoDataValue )
+    {
+        if( *pdfNoDataValue == 0.0 )
+        {
+            // Do not initialize in the case where nodata != 0, since we
+            // want the GeoPackage driver to return empty tiles at the nodata
+            // value instead of 0 as GDAL core would
+            psWO->papszWarpOptions = CSLSetNameValue(psWO->papszWarpOptions,
+                                                 "INIT_DEST", "0");
+        }
+
+        psWO->padfSrcNoDataReal =
+            static_cast<double*>(CPLMalloc(sizeof(double)));
+        psWO->padfSrcNoDataReal[0] = *pdfNoDataValue;
+
+        psWO->padfDstNoDataReal =
+            static_cast<double*>(CPLMalloc(sizeof(double)));
+        psWO->padfDstNoDataReal[0] = *pdfNoDataValue;
+    }
+    psWO->eWorkingDataType = eWorkingDataType;
+    psWO->eResampleAlg = eResampleAlg;
+
+    psWO->hSrcDS = poSrcDS;
+    psWO->hDstDS = poDstDS;
+
+    psWO->pfnTransformer = GDALApproxTransform;
+    psWO->pTransformerArg = hTransformArg;
+
+    psWO->pfnProgress = pfnProgress;
+    psWO->pProgressArg = pProgressData;
+
+/* -------------------------------------------------------------------- */
+/*      Setup band mapping.                                             */
+/* -------------------------------------------------------------------- */
+    const int nBands = poSrcDS->GetRasterCount();
+    const int nTargetBands = poDstDS->GetRasterCount();
+    if( nBands == 2 || nBands == 4 )
+        psWO->nBandCount = nBands - 1;
+    else
+        psWO->nBandCount = nBands;
+
+    psWO->panSrcBands = static_cast<int *>(
+        CPLMalloc(psWO->nBandCount*sizeof(int)));
+    psWO->panDstBands = static_cast<int *>(
+        CPLMalloc(psWO->nBandCount*sizeof(int)));
+
+    for( int i = 0; i < psWO->nBandCount; i++ )
+    {
+        psWO->panSrcBands[i] = i+1;
+        psWO->panDstBands[i] = i+1;
+    }
+
+    if( nBands == 2 || nBands == 4 )
+    {
+        psWO->nSrcAlphaBand = nBands;
+    }
+    if( nTargetBands == 2 || nTargetBands == 4 )
+    {
+        psWO->nDstAlphaBand = nTargetBands;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Initialize and execute the warp.                                */
+/* -------------------------------------------------------------------- */
+    GDALWarpOperation oWO;
+
+    CPLErr eErr = oWO.Initialize( psWO );
+    if( eErr == CE_None )
+    {
+        eErr = oWO.ChunkAndWarpImage( 0, 0, poDstDS->GetRasterXSize(),
+                                      poDstDS->GetRasterYSize() );
+    }
+
+    GDALDestroyTransformer( hTransformArg );
+    GDALDestroyWarpOptions( psWO );
+
+    return eErr;
+}
+
 GDALDataset* GDALGeoPackageDataset::CreateCopy( const char *pszFilename,
                                                    GDALDataset *poSrcDS,
                                                    int bStrict,
@@ -5025,18 +5192,13 @@ GDALDataset* GDALGeoPackageDataset::CreateCopy( const char *pszFilename,
         }
     }
 
-    double dfComputedRes = adfGeoTransform[1];
-    double dfPrevRes = 0.0;
-    double dfRes = 0.0;
-    int nZoomLevel = 0;  // Used after for.
-    for( ; nZoomLevel < 25; nZoomLevel++ )
-    {
-        dfRes = poTS->dfPixelXSizeZoomLevel0 / (1 << nZoomLevel);
-        if( dfComputedRes > dfRes || fabs( dfComputedRes - dfRes ) / dfRes <= 1e-8 )
-            break;
-        dfPrevRes = dfRes;
-    }
-    if( nZoomLevel == 25 )
+    std::vector<double> adfResolutions;
+    for( int i = 0; i < 25; i++ )
+        adfResolutions.push_back(poTS->dfPixelXSizeZoomLevel0 / (1 << i));
+    const int nZoomLevel = gdal::TileMatrixSet::selectZoomLevel(
+        adfResolutions, adfGeoTransform[1],
+        CSLFetchNameValue(papszOptions, "ZOOM_LEVEL_STRATEGY"));
+    if( nZoomLevel < 0 )
     {
         CPLError(CE_Failure, CPLE_AppDefined,
                  "Could not find an appropriate zoom level");
@@ -5045,27 +5207,7 @@ GDALDataset* GDALGeoPackageDataset::CreateCopy( const char *pszFilename,
         return nullptr;
     }
 
-    if( nZoomLevel > 0 && fabs( dfComputedRes - dfRes ) / dfRes > 1e-8 )
-    {
-        const char* pszZoomLevelStrategy = CSLFetchNameValueDef(papszOptions,
-                                                                "ZOOM_LEVEL_STRATEGY",
-                                                                "AUTO");
-        if( EQUAL(pszZoomLevelStrategy, "LOWER") )
-        {
-            nZoomLevel --;
-        }
-        else if( EQUAL(pszZoomLevelStrategy, "UPPER") )
-        {
-            /* do nothing */
-        }
-        else
-        {
-            if( dfPrevRes / dfComputedRes < dfComputedRes / dfRes )
-                nZoomLevel --;
-        }
-    }
-
-    dfRes = poTS->dfPixelXSizeZoomLevel0 / (1 << nZoomLevel);
+    const double dfRes = adfResolutions[nZoomLevel];
 
     double dfMinX = adfExtent[0];
     double dfMinY = adfExtent[1];
@@ -5146,113 +5288,19 @@ GDALDataset* GDALGeoPackageDataset::CreateCopy( const char *pszFilename,
         poDS->GetRasterBand(1)->SetNoDataValue(dfNoDataValue);
     }
 
-    hTransformArg =
-        GDALCreateGenImgProjTransformer2( poSrcDS, poDS, papszTO );
-    CSLDestroy(papszTO);
-    if( hTransformArg == nullptr )
-    {
-        delete poDS;
-        return nullptr;
-    }
-
     poDS->SetMetadata( poSrcDS->GetMetadata() );
 
-/* -------------------------------------------------------------------- */
-/*      Warp the transformer with a linear approximator                 */
-/* -------------------------------------------------------------------- */
-    hTransformArg =
-        GDALCreateApproxTransformer( GDALGenImgProjTransform,
-                                     hTransformArg, 0.125 );
-    GDALApproxTransformerOwnsSubtransformer(hTransformArg, TRUE);
-
-/* -------------------------------------------------------------------- */
-/*      Setup warp options.                                             */
-/* -------------------------------------------------------------------- */
-    GDALWarpOptions *psWO = GDALCreateWarpOptions();
-
-    psWO->papszWarpOptions = CSLSetNameValue(nullptr, "OPTIMIZE_SIZE", "YES");
-    psWO->papszWarpOptions = CSLSetNameValue(
-                            psWO->papszWarpOptions, "SAMPLE_GRID", "YES");
-    if( bHasNoData )
-    {
-        if( dfNoDataValue == 0.0 )
-        {
-            // Do not initialize in the case where nodata != 0, since we
-            // want the GeoPackage driver to return empty tiles at the nodata
-            // value instead of 0 as GDAL core would
-            psWO->papszWarpOptions = CSLSetNameValue(psWO->papszWarpOptions,
-                                                 "INIT_DEST", "0");
-        }
-
-        psWO->padfSrcNoDataReal =
-            static_cast<double*>(CPLMalloc(sizeof(double)));
-        psWO->padfSrcNoDataReal[0] = dfNoDataValue;
-
-        psWO->padfDstNoDataReal =
-            static_cast<double*>(CPLMalloc(sizeof(double)));
-        psWO->padfDstNoDataReal[0] = dfNoDataValue;
-    }
-    psWO->eWorkingDataType = eDT;
-    psWO->eResampleAlg = eResampleAlg;
-
-    psWO->hSrcDS = poSrcDS;
-    psWO->hDstDS = poDS;
-
-    psWO->pfnTransformer = GDALApproxTransform;
-    psWO->pTransformerArg = hTransformArg;
-
-    psWO->pfnProgress = pfnProgress;
-    psWO->pProgressArg = pProgressData;
-
-/* -------------------------------------------------------------------- */
-/*      Setup band mapping.                                             */
-/* -------------------------------------------------------------------- */
-
-    if( nBands == 2 || nBands == 4 )
-        psWO->nBandCount = nBands - 1;
-    else
-        psWO->nBandCount = nBands;
-
-    psWO->panSrcBands = (int *) CPLMalloc(psWO->nBandCount*sizeof(int));
-    psWO->panDstBands = (int *) CPLMalloc(psWO->nBandCount*sizeof(int));
-
-    for( int i = 0; i < psWO->nBandCount; i++ )
-    {
-        psWO->panSrcBands[i] = i+1;
-        psWO->panDstBands[i] = i+1;
-    }
-
-    if( nBands == 2 || nBands == 4 )
-    {
-        psWO->nSrcAlphaBand = nBands;
-    }
-    if( nTargetBands == 2 || nTargetBands == 4 )
-    {
-        psWO->nDstAlphaBand = nTargetBands;
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Initialize and execute the warp.                                */
-/* -------------------------------------------------------------------- */
-    GDALWarpOperation oWO;
-
-    CPLErr eErr = oWO.Initialize( psWO );
-    if( eErr == CE_None )
-    {
-        /*if( bMulti )
-            eErr = oWO.ChunkAndWarpMulti( 0, 0, nXSize, nYSize );
-        else*/
-        eErr = oWO.ChunkAndWarpImage( 0, 0, nXSize, nYSize );
-    }
+    const CPLErr eErr = GDALGPKGMBTilesWarpToTiles(
+        poSrcDS, poDS, papszTO, eResampleAlg, eDT,
+        true, bHasNoData ? &dfNoDataValue : nullptr,
+        papszOptions, pfnProgress, pProgressData );
+    CSLDestroy(papszTO);
     if (eErr != CE_None)
     {
         delete poDS;
         poDS = nullptr;
     }
 
-    GDALDestroyTransformer( hTransformArg );
-    GDALDestroyWarpOptions( psWO );
-
     return poDS;
 }
 
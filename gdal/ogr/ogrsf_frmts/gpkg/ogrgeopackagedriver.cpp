@@ -329,7 +329,8 @@ class GDALGPKGDriver final: public GDALDriver
 "  </Option>" \
 "  <Option name='QUALITY' type='int' min='1' max='100' scope='raster' description='Quality for JPEG and WEBP tiles' default='75'/>" \
 "  <Option name='ZLEVEL' type='int' min='1' max='9' scope='raster' description='DEFLATE compression level for PNG tiles' default='6'/>" \
-"  <Option name='DITHER' type='boolean' scope='raster' description='Whether to apply Floyd-Steinberg dithering (for TILE_FORMAT=PNG8)' default='NO'/>"
+"  <Option name='DITHER' type='boolean' scope='raster' description='Whether to apply Floyd-Steinberg dithering (for TILE_FORMAT=PNG8)' default='NO'/>" \
+"  <Option name='NUM_THREADS' type='string' scope='raster' description='Number of worker threads for tile encoding/decoding. Can be set to ALL_CPUS' default='1'/>"
 
 void GDALGPKGDriver::InitializeCreationOptionList()
 {
@@ -31,6 +31,7 @@
 #include "ogrgeopackageutility.h"
 #include "ogrsqliteutility.h"
 #include "ogr_p.h"
+#include "gdal_perf_counters.h"
 
 CPL_CVSID("$Id$")
 
@@ -183,6 +184,8 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
     iNextShapeId++;
 
     m_nFeaturesRead++;
+    GDAL_PERF_COUNTER(poFeaturesCounter, "GPKG.features_read");
+    poFeaturesCounter->Increment();
 
 /* -------------------------------------------------------------------- */
 /*      Process Geometry if we have a column.                           */
@@ -197,6 +200,8 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
             int iGpkgSize = sqlite3_column_bytes(hStmt, iGeomCol);
             // coverity[tainted_data_return]
             GByte *pabyGpkg = (GByte *)sqlite3_column_blob(hStmt, iGeomCol);
+            GDAL_PERF_COUNTER(poGeomTimeCounter, "GPKG.geometry_parse_time_ns");
+            GDALPerfCounterTimer oTimer(poGeomTimeCounter);
             OGRGeometry *poGeom = GPkgGeometryToOGR(pabyGpkg, iGpkgSize, nullptr);
             if ( poGeom == nullptr )
             {
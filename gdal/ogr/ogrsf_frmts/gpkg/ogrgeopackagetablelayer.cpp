@@ -32,12 +32,72 @@
 #include "ogrsqliteutility.h"
 #include "cpl_time.h"
 #include "ogr_p.h"
+#include "ogr_recordbatch.h"
+#include "ogrlayerarrow.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <thread>
 
 CPL_CVSID("$Id$")
 
+/************************************************************************/
+/*                    OGRGeoPackageArrowPrefetcher                      */
+/************************************************************************/
+
+// Builds the batches of an Arrow array stream on a GeoPackage table with
+// several worker threads, so that SQLite stepping, geometry parsing and
+// field conversion run concurrently. Each worker owns a read-only connection
+// to the database, and builds the batches of the FID ranges
+// [nMinFID + k * nMaxBatchSize, nMinFID + (k + 1) * nMaxBatchSize[ for the
+// values of k equal to its index modulo the number of workers. Each range
+// holds at most nMaxBatchSize features, and the main thread returns them
+// in FID order.
+
+struct OGRGeoPackageArrowPrefetcher
+{
+    struct Worker
+    {
+        std::thread                 m_oThread{};
+        std::mutex                  m_oMutex{};
+        std::condition_variable     m_oCV{};
+        GDALDatasetUniquePtr        m_poDS{};
+        OGRLayer*                   m_poLayer = nullptr;
+        GIntBig                     m_nNextRange = 0;
+        bool                        m_bHasResult = false;
+        struct ArrowArray           m_sResult{};
+        int                         m_nErrno = 0;
+        std::string                 m_osErrorMsg{};
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_apoWorkers{};
+    std::atomic<bool>           m_bStop{false};
+    CPLString                   m_osFIDColumn{};
+    CPLString                   m_osAttrQuery{};
+    CPLStringList               m_aosOptions{};
+    GIntBig                     m_nMinFID = 0;
+    GIntBig                     m_nMaxBatchSize = 0;
+    GIntBig                     m_nRanges = 0;
+    GIntBig                     m_nNextRangeToReturn = 0;
+
+    OGRGeoPackageArrowPrefetcher() = default;
+    ~OGRGeoPackageArrowPrefetcher();
+
+    void                        Start();
+    int                         GetNext(struct ArrowArray* out_array);
+
+  private:
+    CPL_DISALLOW_COPY_ASSIGN(OGRGeoPackageArrowPrefetcher)
+
+    void                        WorkerLoop(Worker* psWorker);
+};
+
 static const char UNSUPPORTED_OP_READ_ONLY[] =
   "%s : unsupported operation on a read-only datasource.";
 
@@ -1632,35 +1692,36 @@ void OGRGeoPackageTableLayer::DisableTriggers(bool bNullifyFeatureCount)
 /************************************************************************/
 
 void OGRGeoPackageTableLayer::CheckGeometryType( OGRFeature *poFeature )
+{
+    OGRGeometry* poGeom = poFeature->GetGeometryRef();
+    if( poGeom != nullptr )
+        CheckGeometryType(poGeom->getGeometryType());
+}
+
+// eGeomTypeIn is the type of a geometry to be inserted, with its Z/M flags
+void OGRGeoPackageTableLayer::CheckGeometryType( OGRwkbGeometryType eGeomTypeIn )
 {
     OGRwkbGeometryType eLayerGeomType = wkbFlatten(GetGeomType());
-    if( eLayerGeomType != wkbNone && eLayerGeomType != wkbUnknown )
-    {
-        OGRGeometry* poGeom = poFeature->GetGeometryRef();
-        if( poGeom != nullptr )
-        {
-            OGRwkbGeometryType eGeomType =
-                wkbFlatten(poGeom->getGeometryType());
-            if( !OGR_GT_IsSubClassOf(eGeomType, eLayerGeomType) &&
-                m_eSetBadGeomTypeWarned.find(eGeomType) ==
-                                        m_eSetBadGeomTypeWarned.end() )
-            {
-                CPLError(CE_Warning, CPLE_AppDefined,
-                         "A geometry of type %s is inserted into layer %s "
-                         "of geometry type %s, which is not normally allowed "
-                         "by the GeoPackage specification, but the driver will "
-                         "however do it. "
-                         "To create a conformant GeoPackage, if using ogr2ogr, "
-                         "the -nlt option can be used to override the layer "
-                         "geometry type. "
-                         "This warning will no longer be emitted for this "
-                         "combination of layer and feature geometry type.",
-                         OGRToOGCGeomType(eGeomType),
-                         GetName(),
-                         OGRToOGCGeomType(eLayerGeomType));
-                m_eSetBadGeomTypeWarned.insert(eGeomType);
-            }
-        }
+    OGRwkbGeometryType eGeomType = wkbFlatten(eGeomTypeIn);
+    if( eLayerGeomType != wkbNone && eLayerGeomType != wkbUnknown &&
+        !OGR_GT_IsSubClassOf(eGeomType, eLayerGeomType) &&
+        m_eSetBadGeomTypeWarned.find(eGeomType) ==
+                                m_eSetBadGeomTypeWarned.end() )
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "A geometry of type %s is inserted into layer %s "
+                 "of geometry type %s, which is not normally allowed "
+                 "by the GeoPackage specification, but the driver will "
+                 "however do it. "
+                 "To create a conformant GeoPackage, if using ogr2ogr, "
+                 "the -nlt option can be used to override the layer "
+                 "geometry type. "
+                 "This warning will no longer be emitted for this "
+                 "combination of layer and feature geometry type.",
+                 OGRToOGCGeomType(eGeomType),
+                 GetName(),
+                 OGRToOGCGeomType(eLayerGeomType));
+        m_eSetBadGeomTypeWarned.insert(eGeomType);
     }
 
     // wkbUnknown is a rather loose type in OGR. Make sure to update
@@ -1668,31 +1729,26 @@ void OGRGeoPackageTableLayer::CheckGeometryType( OGRFeature *poFeature )
     // with Z and M components
     if( GetGeomType() == wkbUnknown && (m_nZFlag == 0 || m_nMFlag == 0) )
     {
-        OGRGeometry* poGeom = poFeature->GetGeometryRef();
-        if( poGeom != nullptr )
+        bool bUpdateGpkgGeometryColumnsTable = false;
+        if( m_nZFlag == 0 && wkbHasZ(eGeomTypeIn) )
         {
-            bool bUpdateGpkgGeometryColumnsTable = false;
-            OGRwkbGeometryType eGeomType = poGeom->getGeometryType();
-            if( m_nZFlag == 0 && wkbHasZ(eGeomType) )
-            {
-                m_nZFlag = 2;
-                bUpdateGpkgGeometryColumnsTable = true;
-            }
-            if( m_nMFlag == 0 && wkbHasM(eGeomType) )
-            {
-                m_nMFlag = 2;
-                bUpdateGpkgGeometryColumnsTable = true;
-            }
-            if( bUpdateGpkgGeometryColumnsTable )
-            {
-                /* Update gpkg_geometry_columns */
-                char* pszSQL = sqlite3_mprintf(
-                    "UPDATE gpkg_geometry_columns SET z = %d, m = %d WHERE "
-                    "table_name = '%q' AND column_name = '%q'",
-                    m_nZFlag, m_nMFlag, GetName(),GetGeometryColumn());
-                CPL_IGNORE_RET_VAL(SQLCommand(m_poDS->GetDB(), pszSQL));
-                sqlite3_free(pszSQL);
-            }
+            m_nZFlag = 2;
+            bUpdateGpkgGeometryColumnsTable = true;
+        }
+        if( m_nMFlag == 0 && wkbHasM(eGeomTypeIn) )
+        {
+            m_nMFlag = 2;
+            bUpdateGpkgGeometryColumnsTable = true;
+        }
+        if( bUpdateGpkgGeometryColumnsTable )
+        {
+            /* Update gpkg_geometry_columns */
+            char* pszSQL = sqlite3_mprintf(
+                "UPDATE gpkg_geometry_columns SET z = %d, m = %d WHERE "
+                "table_name = '%q' AND column_name = '%q'",
+                m_nZFlag, m_nMFlag, GetName(),GetGeometryColumn());
+            CPL_IGNORE_RET_VAL(SQLCommand(m_poDS->GetDB(), pszSQL));
+            sqlite3_free(pszSQL);
         }
     }
 }
@@ -1735,7 +1791,7 @@ static bool CheckFIDAndFIDColumnConsistency( const OGRFeature* poFeature,
 }
 
 /************************************************************************/
-/*                      ICreateFeature()                                 */
+/*                   rtreeValueDown(), rtreeValueUp()                   */
 /************************************************************************/
 
 // rtreeValueDown() / rtreeValueUp() come from SQLite3 source code
@@ -1768,6 +1824,53 @@ static float rtreeValueUp(double d){
   return f;
 }
 
+/************************************************************************/
+/*                    UpdateExtentAndSpatialIndex()                     */
+/************************************************************************/
+
+// To be called after the insertion of a row with a non-empty geometry,
+// whose envelope is oEnv.
+bool OGRGeoPackageTableLayer::UpdateExtentAndSpatialIndex(
+                                            GIntBig nFID,
+                                            const OGREnvelope& oEnv )
+{
+    UpdateExtent(&oEnv);
+
+    if( !m_bDeferredSpatialIndexCreation && m_poDS->IsInTransaction() )
+    {
+        m_nCountInsertInTransaction ++;
+        if( m_nCountInsertInTransactionThreshold < 0 )
+        {
+            m_nCountInsertInTransactionThreshold = atoi(
+                CPLGetConfigOption("OGR_GPKG_DEFERRED_SPI_UPDATE_THRESHOLD", "100"));
+        }
+        if( m_nCountInsertInTransaction == m_nCountInsertInTransactionThreshold )
+        {
+            StartDeferredSpatialIndexUpdate();
+        }
+        else if( !m_aoRTreeTriggersSQL.empty() )
+        {
+            if( m_aoRTreeEntries.size() == 1000 * 1000 )
+            {
+                if( !FlushPendingSpatialIndexUpdate() )
+                    return false;
+            }
+            GPKGRTreeEntry sEntry;
+            sEntry.nId = nFID;
+            sEntry.fMinX = rtreeValueDown(oEnv.MinX);
+            sEntry.fMaxX = rtreeValueUp(oEnv.MaxX);
+            sEntry.fMinY = rtreeValueDown(oEnv.MinY);
+            sEntry.fMaxY = rtreeValueUp(oEnv.MaxY);
+            m_aoRTreeEntries.push_back(sEntry);
+        }
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                      ICreateFeature()                                 */
+/************************************************************************/
+
 OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
 {
     if( !m_bFeatureDefnCompleted )
@@ -1935,48 +2038,287 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
         {
             OGREnvelope oEnv;
             poGeom->getEnvelope(&oEnv);
-            UpdateExtent(&oEnv);
+            if( !UpdateExtentAndSpatialIndex(nFID, oEnv) )
+                return OGRERR_FAILURE;
+        }
+    }
+
+#ifdef ENABLE_GPKG_OGR_CONTENTS
+    if( m_nTotalFeatureCount >= 0 )
+        m_nTotalFeatureCount++;
+#endif
+
+    m_bContentChanged = true;
+
+    /* All done! */
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          WriteArrowBatch()                           */
+/************************************************************************/
+
+// Fast path that binds the Arrow buffers directly to a single prepared
+// INSERT statement, and builds the GeoPackage geometry blobs from the WKB
+// without instantiating OGRFeature or OGRGeometry objects. It is only used
+// for the field types whose values can be bound without conversion; other
+// layouts go through the generic implementation.
+bool OGRGeoPackageTableLayer::WriteArrowBatch( const struct ArrowSchema* schema,
+                                               const struct ArrowArray* array,
+                                               CSLConstList papszOptions )
+{
+    if( !m_bFeatureDefnCompleted )
+        GetLayerDefn();
+    if( !CheckUpdatableTable("WriteArrowBatch") )
+        return false;
+
+    if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
+        return false;
+
+    std::vector<OGRArrowColumnMapping> aoMapping;
+    if( !OGRArrowGetColumnMapping(this, schema, array, aoMapping) )
+        return false;
+
+    bool bFastPath = m_iFIDAsRegularColumnIndex < 0;
+    std::vector<bool> abFieldInBatch(m_poFeatureDefn->GetFieldCount());
+    for( size_t iCol = 0; bFastPath && iCol < aoMapping.size(); ++iCol )
+    {
+        if( aoMapping[iCol].eKind == OAC_FID )
+        {
+            bFastPath = m_pszFidColumn != nullptr;
+        }
+        else if( aoMapping[iCol].eKind == OAC_FIELD )
+        {
+            const OGRFieldDefn* poFieldDefn =
+                m_poFeatureDefn->GetFieldDefn(aoMapping[iCol].iField);
+            abFieldInBatch[aoMapping[iCol].iField] = true;
+            const OGRFieldType eType = poFieldDefn->GetType();
+            bFastPath = eType == OFTInteger || eType == OFTInteger64 ||
+                        eType == OFTReal || eType == OFTBinary ||
+                        (eType == OFTString && poFieldDefn->GetWidth() == 0);
+        }
+    }
+    // Unset fields with a default value require the processing of
+    // ICreateFeature()
+    for( int i = 0; bFastPath && i < m_poFeatureDefn->GetFieldCount(); ++i )
+    {
+        if( !abFieldInBatch[i] &&
+            m_poFeatureDefn->GetFieldDefn(i)->GetDefault() != nullptr )
+        {
+            bFastPath = false;
+        }
+    }
+    if( !bFastPath )
+        return OGRLayer::WriteArrowBatch(schema, array, papszOptions);
+
+#ifdef ENABLE_GPKG_OGR_CONTENTS
+    if( m_bOGRFeatureCountTriggersEnabled )
+    {
+        DisableTriggers();
+    }
+#endif
 
-            if( !m_bDeferredSpatialIndexCreation && m_poDS->IsInTransaction() )
+    CPLString osCommand;
+    osCommand.Printf("INSERT INTO \"%s\" ( ",
+                     SQLEscapeName(m_pszTableName).c_str());
+    CPLString osValues;
+    for( size_t iCol = 0; iCol < aoMapping.size(); ++iCol )
+    {
+        const char* pszColName =
+            aoMapping[iCol].eKind == OAC_FID ? m_pszFidColumn :
+            aoMapping[iCol].eKind == OAC_FIELD ?
+                m_poFeatureDefn->GetFieldDefn(
+                    aoMapping[iCol].iField)->GetNameRef() :
+                m_poFeatureDefn->GetGeomFieldDefn(
+                    aoMapping[iCol].iField)->GetNameRef();
+        if( iCol > 0 )
+        {
+            osCommand += ", ";
+            osValues += ", ";
+        }
+        osCommand += "\"";
+        osCommand += SQLEscapeName(pszColName);
+        osCommand += "\"";
+        osValues += "?";
+    }
+    if( aoMapping.empty() )
+        osCommand = CPLSPrintf("INSERT INTO \"%s\" DEFAULT VALUES",
+                               SQLEscapeName(m_pszTableName).c_str());
+    else
+        osCommand += " ) VALUES ( " + osValues + " )";
+
+    sqlite3 *poDb = m_poDS->GetDB();
+    sqlite3_stmt* hInsertStmt = nullptr;
+    if( sqlite3_prepare_v2(poDb, osCommand, -1, &hInsertStmt,
+                           nullptr) != SQLITE_OK )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "failed to prepare SQL: %s - %s",
+                  osCommand.c_str(), sqlite3_errmsg(poDb) );
+        return false;
+    }
+
+    // Run in a transaction, unless the user already started one, so that
+    // the spatial index updates are also batched.
+    const bool bOwnTransaction = !m_poDS->IsInTransaction();
+    if( bOwnTransaction && m_poDS->StartTransaction() != OGRERR_NONE )
+    {
+        sqlite3_finalize(hInsertStmt);
+        return false;
+    }
+
+    std::vector<GByte> abyGeom;
+    bool bRet = true;
+    const int64_t nRows = array->length;
+    for( int64_t iRow = 0; bRet && iRow < nRows; ++iRow )
+    {
+        const int64_t iSubRow = iRow + array->offset;
+        bool bHasEnvelope = false;
+        OGREnvelope sEnvelope;
+        int err = SQLITE_OK;
+        for( size_t iCol = 0; err == SQLITE_OK && iCol < aoMapping.size();
+             ++iCol )
+        {
+            const int iParam = static_cast<int>(iCol) + 1;
+            const struct ArrowArray* psArray = array->children[iCol];
+            const char* pszFormat = schema->children[iCol]->format;
+            if( OGRArrowIsNull(psArray, iSubRow) )
+            {
+                err = sqlite3_bind_null(hInsertStmt, iParam);
+            }
+            else if( aoMapping[iCol].eKind == OAC_FID )
+            {
+                err = sqlite3_bind_int64(hInsertStmt, iParam,
+                    OGRArrowGetInteger(psArray, pszFormat, iSubRow));
+            }
+            else if( aoMapping[iCol].eKind == OAC_GEOM_FIELD )
             {
-                m_nCountInsertInTransaction ++;
-                if( m_nCountInsertInTransactionThreshold < 0 )
+                size_t nWkbSize = 0;
+                const GByte* pabyWkb =
+                    OGRArrowGetBinary(psArray, iSubRow, nWkbSize);
+                OGRwkbGeometryType eGeomType = wkbUnknown;
+                if( GPkgGeometryFromWKB(pabyWkb, nWkbSize, m_iSrs, abyGeom,
+                                        eGeomType, sEnvelope) )
                 {
-                    m_nCountInsertInTransactionThreshold = atoi(
-                        CPLGetConfigOption("OGR_GPKG_DEFERRED_SPI_UPDATE_THRESHOLD", "100"));
+                    CheckGeometryType(eGeomType);
+                    err = sqlite3_bind_blob(hInsertStmt, iParam,
+                                            abyGeom.data(),
+                                            static_cast<int>(abyGeom.size()),
+                                            SQLITE_STATIC);
                 }
-                if( m_nCountInsertInTransaction == m_nCountInsertInTransactionThreshold )
+                else
                 {
-                    StartDeferredSpatialIndexUpdate();
+                    // Curve, collection or non-ISO WKB geometries
+                    OGRGeometry* poGeom = nullptr;
+                    if( OGRGeometryFactory::createFromWkb(
+                            pabyWkb, nullptr, &poGeom, nWkbSize) !=
+                                                            OGRERR_NONE )
+                    {
+                        CPLError(CE_Failure, CPLE_AppDefined,
+                                 "WriteArrowBatch(): invalid WKB geometry "
+                                 "at row " CPL_FRMT_GIB,
+                                 static_cast<GIntBig>(iRow));
+                        bRet = false;
+                        break;
+                    }
+                    std::unique_ptr<OGRGeometry> poGeomHolder(poGeom);
+                    CheckGeometryType(poGeom->getGeometryType());
+                    size_t nGpkgSize = 0;
+                    GByte* pabyGpkg =
+                        GPkgGeometryFromOGR(poGeom, m_iSrs, &nGpkgSize);
+                    err = sqlite3_bind_blob(hInsertStmt, iParam, pabyGpkg,
+                                            static_cast<int>(nGpkgSize),
+                                            CPLFree);
+                    CreateGeometryExtensionIfNecessary(poGeom);
+                    if( !poGeom->IsEmpty() )
+                        poGeom->getEnvelope(&sEnvelope);
                 }
-                else if( !m_aoRTreeTriggersSQL.empty() )
+                bHasEnvelope = sEnvelope.IsInit();
+            }
+            else
+            {
+                switch( m_poFeatureDefn->GetFieldDefn(
+                            aoMapping[iCol].iField)->GetType() )
                 {
-                    if( m_aoRTreeEntries.size() == 1000 * 1000 )
+                    case OFTInteger:
+                    case OFTInteger64:
+                        err = sqlite3_bind_int64(hInsertStmt, iParam,
+                            OGRArrowGetInteger(psArray, pszFormat, iSubRow));
+                        break;
+
+                    case OFTReal:
+                        err = sqlite3_bind_double(hInsertStmt, iParam,
+                            OGRArrowGetReal(psArray, pszFormat, iSubRow));
+                        break;
+
+                    case OFTString:
+                    {
+                        size_t nSize = 0;
+                        const GByte* pabyData =
+                            OGRArrowGetBinary(psArray, iSubRow, nSize);
+                        // A NULL pointer would be bound as a NULL value
+                        err = sqlite3_bind_text(hInsertStmt, iParam,
+                            nSize ? reinterpret_cast<const char*>(pabyData) : "",
+                            static_cast<int>(nSize), SQLITE_STATIC);
+                        break;
+                    }
+
+                    default:
                     {
-                        if( !FlushPendingSpatialIndexUpdate() )
-                            return OGRERR_FAILURE;
+                        CPLAssert( m_poFeatureDefn->GetFieldDefn(
+                            aoMapping[iCol].iField)->GetType() == OFTBinary );
+                        size_t nSize = 0;
+                        const GByte* pabyData =
+                            OGRArrowGetBinary(psArray, iSubRow, nSize);
+                        err = nSize ?
+                            sqlite3_bind_blob(hInsertStmt, iParam, pabyData,
+                                              static_cast<int>(nSize),
+                                              SQLITE_STATIC) :
+                            sqlite3_bind_zeroblob(hInsertStmt, iParam, 0);
+                        break;
                     }
-                    GPKGRTreeEntry sEntry;
-                    sEntry.nId = nFID;
-                    sEntry.fMinX = rtreeValueDown(oEnv.MinX);
-                    sEntry.fMaxX = rtreeValueUp(oEnv.MaxX);
-                    sEntry.fMinY = rtreeValueDown(oEnv.MinY);
-                    sEntry.fMaxY = rtreeValueUp(oEnv.MaxY);
-                    m_aoRTreeEntries.push_back(sEntry);
                 }
             }
         }
-    }
+        if( !bRet )
+            break;
+
+        if( err == SQLITE_OK )
+            err = sqlite3_step(hInsertStmt);
+        if( err != SQLITE_OK && err != SQLITE_DONE )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "failed to execute insert : %s",
+                      sqlite3_errmsg(poDb) ? sqlite3_errmsg(poDb) : "");
+            bRet = false;
+            break;
+        }
+        sqlite3_reset(hInsertStmt);
+
+        if( bHasEnvelope &&
+            !UpdateExtentAndSpatialIndex(sqlite3_last_insert_rowid(poDb),
+                                         sEnvelope) )
+        {
+            bRet = false;
+            break;
+        }
 
 #ifdef ENABLE_GPKG_OGR_CONTENTS
-    if( m_nTotalFeatureCount >= 0 )
-        m_nTotalFeatureCount++;
+        if( m_nTotalFeatureCount >= 0 )
+            m_nTotalFeatureCount++;
 #endif
+        m_bContentChanged = true;
+    }
+    sqlite3_finalize(hInsertStmt);
 
-    m_bContentChanged = true;
-
-    /* All done! */
-    return OGRERR_NONE;
+    if( bOwnTransaction )
+    {
+        if( bRet )
+            bRet = m_poDS->CommitTransaction() == OGRERR_NONE;
+        else
+            m_poDS->RollbackTransaction();
+    }
+    return bRet;
 }
 
 /************************************************************************/
@@ -2160,6 +2502,9 @@ OGRErr OGRGeoPackageTableLayer::SetAttributeFilter( const char *pszQuery )
 
 void OGRGeoPackageTableLayer::ResetReading()
 {
+    m_poArrowPrefetcher.reset();
+    m_bArrowPrefetchAttempted = false;
+
     if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
         return;
 
@@ -2286,6 +2631,313 @@ OGRFeature* OGRGeoPackageTableLayer::GetNextFeature()
     return poFeature;
 }
 
+/************************************************************************/
+/*                 ~OGRGeoPackageArrowPrefetcher()                      */
+/************************************************************************/
+
+OGRGeoPackageArrowPrefetcher::~OGRGeoPackageArrowPrefetcher()
+{
+    m_bStop = true;
+    for( auto& poWorker: m_apoWorkers )
+    {
+        {
+            std::lock_guard<std::mutex> oLock(poWorker->m_oMutex);
+        }
+        poWorker->m_oCV.notify_all();
+    }
+    for( auto& poWorker: m_apoWorkers )
+    {
+        if( poWorker->m_oThread.joinable() )
+            poWorker->m_oThread.join();
+        if( poWorker->m_bHasResult && poWorker->m_sResult.release )
+            poWorker->m_sResult.release(&poWorker->m_sResult);
+    }
+}
+
+/************************************************************************/
+/*                               Start()                                */
+/************************************************************************/
+
+void OGRGeoPackageArrowPrefetcher::Start()
+{
+    for( size_t i = 0; i < m_apoWorkers.size(); ++i )
+    {
+        Worker* psWorker = m_apoWorkers[i].get();
+        psWorker->m_nNextRange = static_cast<GIntBig>(i);
+        psWorker->m_oThread = std::thread([this, psWorker]()
+                                          { WorkerLoop(psWorker); });
+    }
+}
+
+/************************************************************************/
+/*                             WorkerLoop()                             */
+/************************************************************************/
+
+void OGRGeoPackageArrowPrefetcher::WorkerLoop(Worker* psWorker)
+{
+    const GIntBig nWorkers = static_cast<GIntBig>(m_apoWorkers.size());
+    while( true )
+    {
+        GIntBig nRange;
+        {
+            std::unique_lock<std::mutex> oLock(psWorker->m_oMutex);
+            psWorker->m_oCV.wait(oLock, [this, psWorker]()
+                { return m_bStop || !psWorker->m_bHasResult; });
+            if( m_bStop || psWorker->m_nNextRange >= m_nRanges )
+                return;
+            nRange = psWorker->m_nNextRange;
+        }
+
+        // The range restriction uses the primary key, and the user
+        // attribute filter, if any, is ANDed with it.
+        const GIntBig nStartFID = m_nMinFID + nRange * m_nMaxBatchSize;
+        CPLString osFilter;
+        osFilter.Printf("\"%s\" >= " CPL_FRMT_GIB " AND \"%s\" < " CPL_FRMT_GIB,
+                        SQLEscapeName(m_osFIDColumn).c_str(), nStartFID,
+                        SQLEscapeName(m_osFIDColumn).c_str(),
+                        nStartFID + m_nMaxBatchSize);
+        if( !m_osAttrQuery.empty() )
+            osFilter = "(" + m_osAttrQuery + ") AND " + osFilter;
+
+        struct ArrowArray sArray;
+        memset(&sArray, 0, sizeof(sArray));
+        int nErrno = 0;
+        std::string osErrorMsg;
+        CPLErrorReset();
+        struct ArrowArrayStream sStream;
+        if( psWorker->m_poLayer->SetAttributeFilter(osFilter) != OGRERR_NONE ||
+            !psWorker->m_poLayer->GetArrowStream(&sStream, m_aosOptions.List()) )
+        {
+            nErrno = EIO;
+            osErrorMsg = CPLGetLastErrorMsg();
+        }
+        else
+        {
+            nErrno = sStream.get_next(&sStream, &sArray);
+            if( nErrno != 0 )
+                osErrorMsg = CPLGetLastErrorMsg();
+            sStream.release(&sStream);
+        }
+
+        {
+            std::lock_guard<std::mutex> oLock(psWorker->m_oMutex);
+            psWorker->m_sResult = sArray;
+            psWorker->m_nErrno = nErrno;
+            psWorker->m_osErrorMsg = osErrorMsg;
+            psWorker->m_bHasResult = true;
+            // Stop at the first error
+            psWorker->m_nNextRange =
+                nErrno != 0 ? m_nRanges : nRange + nWorkers;
+        }
+        psWorker->m_oCV.notify_all();
+    }
+}
+
+/************************************************************************/
+/*                               GetNext()                              */
+/************************************************************************/
+
+int OGRGeoPackageArrowPrefetcher::GetNext(struct ArrowArray* out_array)
+{
+    memset(out_array, 0, sizeof(*out_array));
+    const GIntBig nWorkers = static_cast<GIntBig>(m_apoWorkers.size());
+    while( m_nNextRangeToReturn < m_nRanges )
+    {
+        Worker* psWorker =
+            m_apoWorkers[static_cast<size_t>(m_nNextRangeToReturn % nWorkers)].get();
+        struct ArrowArray sArray;
+        int nErrno;
+        std::string osErrorMsg;
+        {
+            std::unique_lock<std::mutex> oLock(psWorker->m_oMutex);
+            psWorker->m_oCV.wait(oLock, [psWorker]()
+                                 { return psWorker->m_bHasResult; });
+            sArray = psWorker->m_sResult;
+            nErrno = psWorker->m_nErrno;
+            osErrorMsg = psWorker->m_osErrorMsg;
+            memset(&psWorker->m_sResult, 0, sizeof(psWorker->m_sResult));
+            psWorker->m_bHasResult = false;
+        }
+        psWorker->m_oCV.notify_all();
+        ++m_nNextRangeToReturn;
+
+        if( nErrno != 0 )
+        {
+            m_nNextRangeToReturn = m_nRanges;
+            CPLError(CE_Failure, CPLE_AppDefined, "%s", osErrorMsg.c_str());
+            return nErrno;
+        }
+        // Ranges without features (holes in the FID sequence, or filtered
+        // out) result in an end-of-stream array, and are skipped.
+        if( sArray.release != nullptr )
+        {
+            *out_array = sArray;
+            return 0;
+        }
+    }
+    return 0;
+}
+
+/************************************************************************/
+/*                        CreateArrowPrefetcher()                       */
+/************************************************************************/
+
+std::unique_ptr<OGRGeoPackageArrowPrefetcher>
+                        OGRGeoPackageTableLayer::CreateArrowPrefetcher()
+{
+    const char* pszNumThreads = CPLGetConfigOption("OGR_GPKG_NUM_THREADS",
+                                                   nullptr);
+    int nThreads = std::min(4, CPLGetNumCPUs());
+    if( pszNumThreads )
+    {
+        nThreads = EQUAL(pszNumThreads, "ALL_CPUS") ? CPLGetNumCPUs() :
+                                                      atoi(pszNumThreads);
+    }
+    // Worker connections would not see uncommitted changes of the main
+    // connection, and could conflict with its locks.
+    if( nThreads <= 1 || !m_bIsTable || m_pszFidColumn == nullptr ||
+        m_poDS->GetUpdate() || !sqlite3_threadsafe() )
+    {
+        return nullptr;
+    }
+
+    const GIntBig nMaxBatchSize = std::max(1, atoi(
+        m_aosArrowArrayStreamOptions.FetchNameValueDef(
+            "MAX_FEATURES_IN_BATCH", "65536")));
+
+    char* pszSQL = sqlite3_mprintf("SELECT MIN(\"%w\"), MAX(\"%w\") FROM \"%w\"",
+                                   m_pszFidColumn, m_pszFidColumn,
+                                   m_pszTableName);
+    auto oResult = SQLQuery(m_poDS->GetDB(), pszSQL);
+    sqlite3_free(pszSQL);
+    if( !oResult || oResult->RowCount() != 1 ||
+        oResult->GetValue(0, 0) == nullptr ||
+        oResult->GetValue(1, 0) == nullptr )
+    {
+        return nullptr;
+    }
+    const GIntBig nMinFID = CPLAtoGIntBig(oResult->GetValue(0, 0));
+    const GIntBig nMaxFID = CPLAtoGIntBig(oResult->GetValue(1, 0));
+    if( nMaxFID < nMinFID ||
+        static_cast<GUIntBig>(nMaxFID - nMinFID) >=
+            static_cast<GUIntBig>(std::numeric_limits<GIntBig>::max()) )
+    {
+        return nullptr;
+    }
+    const GIntBig nRanges = (nMaxFID - nMinFID) / nMaxBatchSize + 1;
+    if( nRanges < 2 )
+        return nullptr;
+
+    // Do not bother with sparse FID sequences, which would result in
+    // mostly empty ranges.
+    GIntBig nFeatureCount = -1;
+#ifdef ENABLE_GPKG_OGR_CONTENTS
+    nFeatureCount = m_nTotalFeatureCount;
+#endif
+    if( nFeatureCount < 0 )
+    {
+        pszSQL = sqlite3_mprintf("SELECT COUNT(*) FROM \"%w\"",
+                                 m_pszTableName);
+        OGRErr err = OGRERR_NONE;
+        nFeatureCount = SQLGetInteger64(m_poDS->GetDB(), pszSQL, &err);
+        sqlite3_free(pszSQL);
+        if( err != OGRERR_NONE )
+            return nullptr;
+    }
+    if( nRanges > 2 * (nFeatureCount / nMaxBatchSize + 1) )
+        return nullptr;
+
+    // Replicate the ignored fields and the spatial filter on the worker
+    // layers. Workers use the generic implementation of GetNextArrowArray()
+    CPLStringList aosIgnoredFields;
+    for( int i = 0; i < m_poFeatureDefn->GetFieldCount(); ++i )
+    {
+        const OGRFieldDefn* poFieldDefn = m_poFeatureDefn->GetFieldDefn(i);
+        if( poFieldDefn->IsIgnored() )
+            aosIgnoredFields.AddString(poFieldDefn->GetNameRef());
+    }
+    for( int i = 0; i < m_poFeatureDefn->GetGeomFieldCount(); ++i )
+    {
+        const OGRGeomFieldDefn* poFieldDefn =
+            m_poFeatureDefn->GetGeomFieldDefn(i);
+        if( poFieldDefn->IsIgnored() )
+            aosIgnoredFields.AddString(poFieldDefn->GetNameRef());
+    }
+
+    std::unique_ptr<OGRGeoPackageArrowPrefetcher> poPrefetcher(
+                                        new OGRGeoPackageArrowPrefetcher());
+    poPrefetcher->m_osFIDColumn = m_pszFidColumn;
+    if( m_pszAttrQueryString )
+        poPrefetcher->m_osAttrQuery = m_pszAttrQueryString;
+    poPrefetcher->m_aosOptions = m_aosArrowArrayStreamOptions;
+    poPrefetcher->m_nMinFID = nMinFID;
+    poPrefetcher->m_nMaxBatchSize = nMaxBatchSize;
+    poPrefetcher->m_nRanges = nRanges;
+
+    const char* const apszAllowedDrivers[] = { "GPKG", nullptr };
+    const int nWorkers = static_cast<int>(
+        std::min(static_cast<GIntBig>(nThreads), nRanges));
+    for( int i = 0; i < nWorkers; ++i )
+    {
+        std::unique_ptr<OGRGeoPackageArrowPrefetcher::Worker> poWorker(
+                                new OGRGeoPackageArrowPrefetcher::Worker());
+        poWorker->m_poDS.reset(GDALDataset::Open(
+            m_poDS->GetDescription(), GDAL_OF_VECTOR | GDAL_OF_READONLY,
+            apszAllowedDrivers, m_poDS->GetOpenOptions(), nullptr));
+        auto poLayer = poWorker->m_poDS ?
+            dynamic_cast<OGRGeoPackageTableLayer*>(
+                poWorker->m_poDS->GetLayerByName(GetName())) : nullptr;
+        if( poLayer == nullptr )
+        {
+            CPLDebug("GPKG", "Cannot open worker connection on %s",
+                     m_poDS->GetDescription());
+            return nullptr;
+        }
+        poLayer->m_bIsArrowPrefetchWorker = true;
+        poLayer->SetIgnoredFields(
+            const_cast<const char**>(aosIgnoredFields.List()));
+        if( m_poFilterGeom )
+            poLayer->SetSpatialFilter(m_iGeomFieldFilter, m_poFilterGeom);
+        poWorker->m_poLayer = poLayer;
+        poPrefetcher->m_apoWorkers.push_back(std::move(poWorker));
+    }
+
+    CPLDebug("GPKG", "Reading %s with %d threads through the Arrow stream "
+             "interface", GetName(), nWorkers);
+    poPrefetcher->Start();
+    return poPrefetcher;
+}
+
+/************************************************************************/
+/*                          GetNextArrowArray()                         */
+/************************************************************************/
+
+int OGRGeoPackageTableLayer::GetNextArrowArray(struct ArrowArrayStream* stream,
+                                               struct ArrowArray* out_array)
+{
+    if( !m_bFeatureDefnCompleted )
+        GetLayerDefn();
+    if( m_bIsArrowPrefetchWorker )
+        return OGRLayer::GetNextArrowArray(stream, out_array);
+
+    // The prefetcher is reset by ResetReading(), which is called when the
+    // stream is created.
+    if( !m_bArrowPrefetchAttempted )
+    {
+        m_bArrowPrefetchAttempted = true;
+        if( m_bDeferredCreation &&
+            RunDeferredCreationIfNecessary() != OGRERR_NONE )
+        {
+            memset(out_array, 0, sizeof(*out_array));
+            return EIO;
+        }
+        m_poArrowPrefetcher = CreateArrowPrefetcher();
+    }
+    if( m_poArrowPrefetcher )
+        return m_poArrowPrefetcher->GetNext(out_array);
+    return OGRLayer::GetNextArrowArray(stream, out_array);
+}
+
 /************************************************************************/
 /*                        GetFeature()                                  */
 /************************************************************************/
@@ -2946,6 +3598,264 @@ int OGRGeoPackageTableLayer::TestCapability ( const char * pszCap )
     }
 }
 
+/************************************************************************/
+/*                       GPKGRTreeWrite*()                              */
+/************************************************************************/
+
+// Helpers to serialize the content of a SQLite RTree node, which uses
+// big-endian ordering whatever the host endianness.
+
+static GByte* GPKGRTreeWriteUInt16(GByte* pabyIter, GUInt16 nVal)
+{
+    pabyIter[0] = static_cast<GByte>(nVal >> 8);
+    pabyIter[1] = static_cast<GByte>(nVal & 0xff);
+    return pabyIter + 2;
+}
+
+static GByte* GPKGRTreeWriteUInt32(GByte* pabyIter, GUInt32 nVal)
+{
+    for( int i = 0; i < 4; ++i )
+        pabyIter[i] = static_cast<GByte>((nVal >> (24 - 8 * i)) & 0xff);
+    return pabyIter + 4;
+}
+
+static GByte* GPKGRTreeWriteInt64(GByte* pabyIter, GIntBig nVal)
+{
+    const GUInt64 nUVal = static_cast<GUInt64>(nVal);
+    for( int i = 0; i < 8; ++i )
+        pabyIter[i] = static_cast<GByte>((nUVal >> (56 - 8 * i)) & 0xff);
+    return pabyIter + 8;
+}
+
+static GByte* GPKGRTreeWriteFloat(GByte* pabyIter, float fVal)
+{
+    GUInt32 nVal;
+    memcpy(&nVal, &fVal, sizeof(nVal));
+    return GPKGRTreeWriteUInt32(pabyIter, nVal);
+}
+
+/************************************************************************/
+/*                           BulkLoadRTree()                            */
+/************************************************************************/
+
+// Builds the content of the freshly created, and still empty, RTree
+// m_osRTreeName with the Sort-Tile-Recursive packing algorithm, and writes its
+// nodes directly into the shadow tables of the SQLite RTree module
+// (%_node, %_rowid and %_parent). This avoids the cost of inserting entries
+// one at a time through the virtual table, with the repeated R*-tree node
+// splits it involves, and results in full nodes with little overlap.
+//
+// A node is made of a 16 bit tree depth (only significant for the root node,
+// which is always node 1), a 16 bit number of cells, and then cells made of a
+// 64 bit id (feature id for leaves, child node number otherwise) followed by
+// minx, maxx, miny, maxy as 32 bit floats, everything in big-endian order.
+//
+// The order of aoEntries is modified. If an unexpected situation is detected
+// before anything has been written, false is returned with
+// bTryRegularInsertion set to true, so that the caller can fall back to
+// regular insertion.
+
+bool OGRGeoPackageTableLayer::BulkLoadRTree(
+                                    std::vector<GPKGRTreeEntry>& aoEntries,
+                                    bool& bTryRegularInsertion)
+{
+    bTryRegularInsertion = true;
+    if( aoEntries.empty() )
+    {
+        bTryRegularInsertion = false;
+        return true;
+    }
+
+    sqlite3* hDB = m_poDS->GetDB();
+
+    // The node size is set by the RTree module at creation time, depending
+    // on the page size.
+    char* pszSQL = sqlite3_mprintf(
+        "SELECT length(data) FROM \"%w_node\" WHERE nodeno = 1",
+        m_osRTreeName.c_str());
+    OGRErr err = OGRERR_NONE;
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    const int nNodeSize = SQLGetInteger(hDB, pszSQL, &err);
+    CPLPopErrorHandler();
+    sqlite3_free(pszSQL);
+    constexpr int nCellSize = 8 + 4 * 4;
+    if( err != OGRERR_NONE || nNodeSize < 4 + 2 * nCellSize ||
+        nNodeSize > 65536 )
+    {
+        CPLDebug("GPKG", "Cannot bulk load %s: unexpected node size",
+                 m_osRTreeName.c_str());
+        return false;
+    }
+    const size_t nMaxCells = static_cast<size_t>((nNodeSize - 4) / nCellSize);
+
+    const char* const apszSQL[] = {
+        "INSERT OR REPLACE INTO \"%w_node\" VALUES (?, ?)",
+        "INSERT INTO \"%w_rowid\" VALUES (?, ?)",
+        "INSERT INTO \"%w_parent\" VALUES (?, ?)" };
+    sqlite3_stmt* ahStmt[3] = { nullptr, nullptr, nullptr };
+    const auto FinalizeStatements = [&ahStmt]()
+    {
+        for( auto& hStmt: ahStmt )
+        {
+            sqlite3_finalize(hStmt);
+            hStmt = nullptr;
+        }
+    };
+    for( int i = 0; i < 3; ++i )
+    {
+        pszSQL = sqlite3_mprintf(apszSQL[i], m_osRTreeName.c_str());
+        if( sqlite3_prepare_v2(hDB, pszSQL, -1, &ahStmt[i], nullptr)
+                                                            != SQLITE_OK )
+        {
+            CPLDebug("GPKG", "Cannot bulk load %s: failed to prepare %s",
+                     m_osRTreeName.c_str(), pszSQL);
+            sqlite3_free(pszSQL);
+            FinalizeStatements();
+            return false;
+        }
+        sqlite3_free(pszSQL);
+    }
+    sqlite3_stmt* hNodeStmt = ahStmt[0];
+    sqlite3_stmt* hRowIdStmt = ahStmt[1];
+    sqlite3_stmt* hParentStmt = ahStmt[2];
+
+    // From now, a failure leaves the RTree in an inconsistent state.
+    bTryRegularInsertion = false;
+
+    const auto Step = [hDB](sqlite3_stmt* hStmt)
+    {
+        const int sqlite_err = sqlite3_step(hStmt);
+        sqlite3_reset(hStmt);
+        if( sqlite_err != SQLITE_OK && sqlite_err != SQLITE_DONE )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "failed to execute insertion in RTree : %s",
+                      sqlite3_errmsg( hDB ) );
+            return false;
+        }
+        return true;
+    };
+
+    std::vector<GByte> abyNode(nNodeSize);
+    const auto WriteNode = [&](GIntBig nNodeNo, int nDepth,
+                               const GPKGRTreeEntry* pasCells, size_t nCells)
+    {
+        std::fill(abyNode.begin(), abyNode.end(), static_cast<GByte>(0));
+        GByte* pabyIter = abyNode.data();
+        pabyIter = GPKGRTreeWriteUInt16(pabyIter, static_cast<GUInt16>(nDepth));
+        pabyIter = GPKGRTreeWriteUInt16(pabyIter, static_cast<GUInt16>(nCells));
+        for( size_t i = 0; i < nCells; ++i )
+        {
+            pabyIter = GPKGRTreeWriteInt64(pabyIter, pasCells[i].nId);
+            pabyIter = GPKGRTreeWriteFloat(pabyIter, pasCells[i].fMinX);
+            pabyIter = GPKGRTreeWriteFloat(pabyIter, pasCells[i].fMaxX);
+            pabyIter = GPKGRTreeWriteFloat(pabyIter, pasCells[i].fMinY);
+            pabyIter = GPKGRTreeWriteFloat(pabyIter, pasCells[i].fMaxY);
+        }
+        sqlite3_bind_int64(hNodeStmt, 1, nNodeNo);
+        sqlite3_bind_blob(hNodeStmt, 2, abyNode.data(), nNodeSize,
+                          SQLITE_STATIC);
+        if( !Step(hNodeStmt) )
+            return false;
+
+        // Register the node of each feature id for leaves, or the parent
+        // of each child node otherwise.
+        sqlite3_stmt* hMapStmt = nDepth == 0 ? hRowIdStmt : hParentStmt;
+        for( size_t i = 0; i < nCells; ++i )
+        {
+            sqlite3_bind_int64(hMapStmt, 1, pasCells[i].nId);
+            sqlite3_bind_int64(hMapStmt, 2, nNodeNo);
+            if( !Step(hMapStmt) )
+                return false;
+        }
+        return true;
+    };
+
+    // Compare on the sum of the bounds, that is twice the center
+    const auto CenterXLess = [](const GPKGRTreeEntry& a,
+                                const GPKGRTreeEntry& b)
+    {
+        return static_cast<double>(a.fMinX) + a.fMaxX <
+               static_cast<double>(b.fMinX) + b.fMaxX;
+    };
+    const auto CenterYLess = [](const GPKGRTreeEntry& a,
+                                const GPKGRTreeEntry& b)
+    {
+        return static_cast<double>(a.fMinY) + a.fMaxY <
+               static_cast<double>(b.fMinY) + b.fMaxY;
+    };
+
+    // Build the tree level by level, from the leaves to the root. Each
+    // level is sorted on X, split into vertical slices of about
+    // sqrt(number of nodes) nodes, and each slice is sorted on Y before
+    // being cut into nodes.
+    std::vector<GPKGRTreeEntry> aoUpperLevel;
+    std::vector<GPKGRTreeEntry>* paoLevel = &aoEntries;
+    GIntBig nNextNodeNo = 2; // node 1 is the root
+    int nDepth = 0;
+    while( true )
+    {
+        auto& aoLevel = *paoLevel;
+        const size_t nCount = aoLevel.size();
+        if( nCount <= nMaxCells )
+        {
+            if( !WriteNode(1, nDepth, aoLevel.data(), nCount) )
+            {
+                FinalizeStatements();
+                return false;
+            }
+            break;
+        }
+
+        const size_t nNodes = (nCount + nMaxCells - 1) / nMaxCells;
+        const size_t nSlices = static_cast<size_t>(
+            std::ceil(std::sqrt(static_cast<double>(nNodes))));
+        const size_t nSliceSize = nSlices * nMaxCells;
+        std::sort(aoLevel.begin(), aoLevel.end(), CenterXLess);
+        for( size_t i = 0; i < nCount; i += nSliceSize )
+        {
+            std::sort(aoLevel.begin() + i,
+                      aoLevel.begin() + std::min(nCount, i + nSliceSize),
+                      CenterYLess);
+        }
+
+        std::vector<GPKGRTreeEntry> aoNextLevel;
+        aoNextLevel.reserve(nNodes);
+        for( size_t i = 0; i < nCount; i += nMaxCells )
+        {
+            const size_t nCells = std::min(nCount - i, nMaxCells);
+            const GPKGRTreeEntry* pasCells = aoLevel.data() + i;
+            GPKGRTreeEntry sNodeEntry;
+            sNodeEntry.nId = nNextNodeNo++;
+            if( !WriteNode(sNodeEntry.nId, nDepth, pasCells, nCells) )
+            {
+                FinalizeStatements();
+                return false;
+            }
+            sNodeEntry.fMinX = pasCells[0].fMinX;
+            sNodeEntry.fMinY = pasCells[0].fMinY;
+            sNodeEntry.fMaxX = pasCells[0].fMaxX;
+            sNodeEntry.fMaxY = pasCells[0].fMaxY;
+            for( size_t j = 1; j < nCells; ++j )
+            {
+                sNodeEntry.fMinX = std::min(sNodeEntry.fMinX, pasCells[j].fMinX);
+                sNodeEntry.fMinY = std::min(sNodeEntry.fMinY, pasCells[j].fMinY);
+                sNodeEntry.fMaxX = std::max(sNodeEntry.fMaxX, pasCells[j].fMaxX);
+                sNodeEntry.fMaxY = std::max(sNodeEntry.fMaxY, pasCells[j].fMaxY);
+            }
+            aoNextLevel.push_back(sNodeEntry);
+        }
+        aoUpperLevel = std::move(aoNextLevel);
+        paoLevel = &aoUpperLevel;
+        nDepth++;
+    }
+
+    FinalizeStatements();
+    CPLDebug("GPKG", "%s bulk loaded with %d levels",
+             m_osRTreeName.c_str(), nDepth + 1);
+    return true;
+}
+
 /************************************************************************/
 /*                     CreateSpatialIndexIfNecessary()                  */
 /************************************************************************/
@@ -3074,21 +3984,63 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
     }
     sqlite3_free(pszSQL);
 
-    // Insert entries in RTree by chunks of 500K features
+    // By default, collect all entries to bulk load the RTree. Otherwise,
+    // or if running out of memory, insert them by chunks of 500K features.
+    bool bBulkLoad = CPLTestBool(
+        CPLGetConfigOption("OGR_GPKG_RTREE_BULK_LOAD", "YES"));
     std::vector<GPKGRTreeEntry> aoEntries;
     GUIntBig nEntryCount = 0;
     constexpr size_t nChunkSize = 500 * 1000;
 #ifdef ENABLE_GPKG_OGR_CONTENTS
     if( m_nTotalFeatureCount > 0 )
     {
-        aoEntries.reserve(static_cast<size_t>(
-            std::min(m_nTotalFeatureCount, static_cast<GIntBig>(nChunkSize))));
+        try
+        {
+            aoEntries.reserve(static_cast<size_t>(bBulkLoad ?
+                std::min(m_nTotalFeatureCount,
+                         static_cast<GIntBig>(std::numeric_limits<int>::max())) :
+                std::min(m_nTotalFeatureCount,
+                         static_cast<GIntBig>(nChunkSize))));
+        }
+        catch( const std::bad_alloc& )
+        {
+            bBulkLoad = false;
+        }
     }
 #endif
+
+    const auto InsertEntries = [&]()
+    {
+        for( size_t i = 0; i < aoEntries.size(); ++i )
+        {
+            sqlite3_reset(hInsertStmt);
+
+            sqlite3_bind_int64(hInsertStmt,1,aoEntries[i].nId);
+            sqlite3_bind_double(hInsertStmt,2,aoEntries[i].fMinX);
+            sqlite3_bind_double(hInsertStmt,3,aoEntries[i].fMaxX);
+            sqlite3_bind_double(hInsertStmt,4,aoEntries[i].fMinY);
+            sqlite3_bind_double(hInsertStmt,5,aoEntries[i].fMaxY);
+            const int sqlite_err = sqlite3_step(hInsertStmt);
+            if ( sqlite_err != SQLITE_OK && sqlite_err != SQLITE_DONE )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "failed to execute insertion in RTree : %s",
+                          sqlite3_errmsg( m_poDS->GetDB() ) );
+                return false;
+            }
+        }
+
+        nEntryCount += aoEntries.size();
+        CPLDebug("GPKG", CPL_FRMT_GUIB " rows inserted into %s",
+                 nEntryCount, m_osRTreeName.c_str());
+
+        aoEntries.clear();
+        return true;
+    };
+
     while( true )
     {
         int sqlite_err = sqlite3_step(hIterStmt);
-        bool bFinished = false;
         if( sqlite_err == SQLITE_ROW )
         {
             GPKGRTreeEntry sEntry;
@@ -3097,11 +4049,29 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
             sEntry.fMaxX = rtreeValueUp(sqlite3_column_double(hIterStmt, 2));
             sEntry.fMinY = rtreeValueDown(sqlite3_column_double(hIterStmt, 3));
             sEntry.fMaxY = rtreeValueUp(sqlite3_column_double(hIterStmt, 4));
-            aoEntries.push_back(sEntry);
+            try
+            {
+                aoEntries.push_back(sEntry);
+            }
+            catch( const std::bad_alloc& )
+            {
+                CPLDebug("GPKG", "Not enough memory to bulk load %s. "
+                         "Inserting entries progressively",
+                         m_osRTreeName.c_str());
+                bBulkLoad = false;
+                if( !InsertEntries() )
+                {
+                    sqlite3_finalize(hIterStmt);
+                    sqlite3_finalize(hInsertStmt);
+                    m_poDS->SoftRollbackTransaction();
+                    return false;
+                }
+                aoEntries.push_back(sEntry);
+            }
         }
         else if( sqlite_err == SQLITE_DONE )
         {
-            bFinished = true;
+            break;
         }
         else
         {
@@ -3115,40 +4085,35 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
             return false;
         }
 
-        if( aoEntries.size() == nChunkSize || bFinished )
+        if( !bBulkLoad && aoEntries.size() == nChunkSize && !InsertEntries() )
         {
-            for( size_t i = 0; i < aoEntries.size(); ++i )
-            {
-                sqlite3_reset(hInsertStmt);
-
-                sqlite3_bind_int64(hInsertStmt,1,aoEntries[i].nId);
-                sqlite3_bind_double(hInsertStmt,2,aoEntries[i].fMinX);
-                sqlite3_bind_double(hInsertStmt,3,aoEntries[i].fMaxX);
-                sqlite3_bind_double(hInsertStmt,4,aoEntries[i].fMinY);
-                sqlite3_bind_double(hInsertStmt,5,aoEntries[i].fMaxY);
-                sqlite_err = sqlite3_step(hInsertStmt);
-                if ( sqlite_err != SQLITE_OK && sqlite_err != SQLITE_DONE )
-                {
-                    CPLError( CE_Failure, CPLE_AppDefined,
-                              "failed to execute insertion in RTree : %s",
-                              sqlite3_errmsg( m_poDS->GetDB() ) );
-                    sqlite3_finalize(hIterStmt);
-                    sqlite3_finalize(hInsertStmt);
-                    m_poDS->SoftRollbackTransaction();
-                    return false;
-                }
-            }
-
-            nEntryCount += aoEntries.size();
-            CPLDebug("GPKG", CPL_FRMT_GUIB " rows inserted into %s",
-                     nEntryCount, m_osRTreeName.c_str());
-
-            aoEntries.clear();
-            if( bFinished )
-                break;
+            sqlite3_finalize(hIterStmt);
+            sqlite3_finalize(hInsertStmt);
+            m_poDS->SoftRollbackTransaction();
+            return false;
         }
     }
 
+    bool bOK;
+    if( bBulkLoad )
+    {
+        bool bTryRegularInsertion = false;
+        bOK = BulkLoadRTree(aoEntries, bTryRegularInsertion);
+        if( !bOK && bTryRegularInsertion )
+            bOK = InsertEntries();
+    }
+    else
+    {
+        bOK = InsertEntries();
+    }
+    if( !bOK )
+    {
+        sqlite3_finalize(hIterStmt);
+        sqlite3_finalize(hInsertStmt);
+        m_poDS->SoftRollbackTransaction();
+        return false;
+    }
+
     sqlite3_finalize(hIterStmt);
     sqlite3_finalize(hInsertStmt);
 #endif
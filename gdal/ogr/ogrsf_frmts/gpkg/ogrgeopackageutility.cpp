@@ -28,6 +28,7 @@
 
 #include "ogrgeopackageutility.h"
 #include "ogr_p.h"
+#include "ogr_wkb.h"
 
 CPL_CVSID("$Id$")
 
@@ -345,6 +346,69 @@ GByte* GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId,
     return pabyWkb;
 }
 
+/* -------------------------------------------------------------------- */
+/*      GPkgGeometryFromWKB()                                           */
+/*                                                                      */
+/*      Same as GPkgGeometryFromOGR(), but working directly on an ISO   */
+/*      WKB geometry, which is copied as it is after the header, into  */
+/*      a caller provided buffer that can be reused between calls.     */
+/*      Only (multi)point, (multi)linestring and (multi)polygon        */
+/*      geometries are handled, so that the caller does not need to    */
+/*      register extensions. Returns false for other geometries, that  */
+/*      must go through GPkgGeometryFromOGR(). The envelope written is */
+/*      the 2D one, which is also returned in sEnvelope.               */
+/* -------------------------------------------------------------------- */
+
+bool GPkgGeometryFromWKB(const GByte *pabyWkb, size_t nWkbLen, int iSrsId,
+                         std::vector<GByte>& abyGpkg,
+                         OGRwkbGeometryType& eGeometryType,
+                         OGREnvelope& sEnvelope)
+{
+    if( nWkbLen < 5 || (pabyWkb[0] != wkbNDR && pabyWkb[0] != wkbXDR) )
+        return false;
+
+    /* Only accept ISO WKB type codes at the top level */
+    GUInt32 nRawType;
+    memcpy(&nRawType, pabyWkb + 1, 4);
+    if( (pabyWkb[0] == wkbNDR) != CPL_TO_BOOL(CPL_IS_LSB) )
+        CPL_SWAP32PTR(&nRawType);
+    if( nRawType >= 4000 || (nRawType % 1000) < wkbPoint ||
+        (nRawType % 1000) > wkbMultiPolygon )
+    {
+        return false;
+    }
+    if( !OGRWKBGetGeomType(pabyWkb, nWkbLen, eGeometryType) ||
+        !OGRWKBGetBoundingBox(pabyWkb, nWkbLen, sEnvelope) )
+    {
+        return false;
+    }
+
+    const bool bPoint = wkbFlatten(eGeometryType) == wkbPoint;
+    const bool bEmpty = !sEnvelope.IsInit();
+    const size_t nHeaderLen = 2+1+1+4 + ((bPoint || bEmpty) ? 0 : 8*4);
+    abyGpkg.resize(nHeaderLen + nWkbLen);
+    GByte* pabyPtr = abyGpkg.data();
+
+    pabyPtr[0] = 0x47;
+    pabyPtr[1] = 0x50;
+    pabyPtr[2] = 0;
+    GByte byFlags = static_cast<GByte>(CPL_IS_LSB);
+    if( bEmpty )
+        byFlags |= (1 << 4);
+    else if( !bPoint )
+        byFlags |= (1 << 1);
+    pabyPtr[3] = byFlags;
+    memcpy(pabyPtr+4, &iSrsId, 4);
+    if( !bPoint && !bEmpty )
+    {
+        const double adfEnv[4] = { sEnvelope.MinX, sEnvelope.MaxX,
+                                   sEnvelope.MinY, sEnvelope.MaxY };
+        memcpy(pabyPtr+8, adfEnv, sizeof(adfEnv));
+    }
+    memcpy(pabyPtr + nHeaderLen, pabyWkb, nWkbLen);
+    return true;
+}
+
 OGRErr GPkgHeaderFromWKB(const GByte *pabyGpkg, size_t nGpkgLen, GPkgHeader *poHeader)
 {
     CPLAssert( pabyGpkg != nullptr );
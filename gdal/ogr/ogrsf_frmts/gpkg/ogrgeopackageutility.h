@@ -29,6 +29,8 @@
 
 #include "ogrsf_frmts.h"
 
+#include <vector>
+
 #ifndef OGR_GEOPACKAGEUTILITY_H_INCLUDED
 #define OGR_GEOPACKAGEUTILITY_H_INCLUDED
 
@@ -55,6 +57,10 @@ const char*         GPkgFieldFromOGR(OGRFieldType eType, OGRFieldSubType eSubTyp
 OGRwkbGeometryType  GPkgGeometryTypeToWKB(const char *pszGpkgType, bool bHasZ, bool bHasM);
 
 GByte*              GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId, size_t *pnWkbLen);
+bool                GPkgGeometryFromWKB(const GByte *pabyWkb, size_t nWkbLen, int iSrsId,
+                                        std::vector<GByte>& abyGpkg,
+                                        OGRwkbGeometryType& eGeometryType,
+                                        OGREnvelope& sEnvelope);
 OGRGeometry*        GPkgGeometryToOGR(const GByte *pabyGpkg, size_t nGpkgLen, OGRSpatialReference *poSrs);
 
 OGRErr              GPkgHeaderFromWKB(const GByte *pabyGpkg, size_t nGpkgLen, GPkgHeader *poHeader);
@@ -103,6 +103,8 @@ class OGRMemLayer CPL_NON_FINAL: public OGRLayer
 
     int                 TestCapability( const char * ) override;
 
+    GIntBig             GetMemoryUsage() override;
+
     bool                IsUpdatable() const { return m_bUpdatable; }
     void                SetUpdatable( bool bUpdatableIn )
         { m_bUpdatable = bUpdatableIn; }
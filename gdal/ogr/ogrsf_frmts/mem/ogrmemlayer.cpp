@@ -516,6 +516,76 @@ GIntBig OGRMemLayer::GetFeatureCount( int bForce )
     return m_nFeatureCount;
 }
 
+/************************************************************************/
+/*                           GetMemoryUsage()                           */
+/************************************************************************/
+
+GIntBig OGRMemLayer::GetMemoryUsage()
+{
+    GIntBig nTotal = 0;
+    if( m_papoFeatures )
+        nTotal += m_nMaxFeatureCount * sizeof(OGRFeature*);
+    // Rough estimate of the size of a std::map node
+    nTotal += static_cast<GIntBig>(m_oMapFeatures.size()) *
+              (sizeof(FeatureMap::value_type) + 4 * sizeof(void*));
+
+    const int nFieldCount = m_poFeatureDefn->GetFieldCount();
+    const int nGeomFieldCount = m_poFeatureDefn->GetGeomFieldCount();
+    IOGRMemLayerFeatureIterator *poIter = GetIterator();
+    OGRFeature *poFeature = nullptr;
+    while( (poFeature = poIter->Next()) != nullptr )
+    {
+        nTotal += sizeof(OGRFeature) + nFieldCount * sizeof(OGRField) +
+                  nGeomFieldCount * sizeof(OGRGeometry*);
+        for( int iField = 0; iField < nFieldCount; ++iField )
+        {
+            if( !poFeature->IsFieldSetAndNotNull(iField) )
+                continue;
+            const OGRField* psField = poFeature->GetRawFieldRef(iField);
+            switch( m_poFeatureDefn->GetFieldDefn(iField)->GetType() )
+            {
+                case OFTString:
+                    nTotal += strlen(psField->String) + 1;
+                    break;
+                case OFTIntegerList:
+                    nTotal += psField->IntegerList.nCount * sizeof(int);
+                    break;
+                case OFTInteger64List:
+                    nTotal += psField->Integer64List.nCount * sizeof(GIntBig);
+                    break;
+                case OFTRealList:
+                    nTotal += psField->RealList.nCount * sizeof(double);
+                    break;
+                case OFTStringList:
+                    for( int i = 0; i < psField->StringList.nCount; ++i )
+                        nTotal += sizeof(char*) +
+                                  strlen(psField->StringList.paList[i]) + 1;
+                    nTotal += sizeof(char*);
+                    break;
+                case OFTBinary:
+                    nTotal += psField->Binary.nCount;
+                    break;
+                default:
+                    break;
+            }
+        }
+        // The WKB size is a lower bound of the size of the geometry objects
+        for( int iGeomField = 0; iGeomField < nGeomFieldCount; ++iGeomField )
+        {
+            const OGRGeometry* poGeom = poFeature->GetGeomFieldRef(iGeomField);
+            if( poGeom )
+                nTotal += poGeom->WkbSize();
+        }
+        if( poFeature->GetStyleString() )
+            nTotal += strlen(poFeature->GetStyleString()) + 1;
+        if( poFeature->GetNativeData() )
+            nTotal += strlen(poFeature->GetNativeData()) + 1;
+    }
+    delete poIter;
+
+    return nTotal;
+}
+
 /************************************************************************/
 /*                           TestCapability()                           */
 /************************************************************************/
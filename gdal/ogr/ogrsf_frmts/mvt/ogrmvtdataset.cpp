@@ -35,6 +35,8 @@
 #include "cpl_conv.h"
 #include "cpl_json.h"
 #include "cpl_http.h"
+#include "cpl_mem_cache.h"
+#include "gdal_thread_pool.h"
 #include "ogr_p.h"
 
 #include "mvt_tile.h"
@@ -43,6 +45,7 @@
 #include "gpb.h"
 
 #include <algorithm>
+#include <deque>
 #include <memory>
 #include <vector>
 #include <set>
@@ -66,6 +69,7 @@ constexpr int knMAX_FILES_PER_DIR = 10000;
 
 #include "cpl_worker_thread_pool.h"
 
+#include <deque>
 #include <mutex>
 
 // Limitations from https://github.com/mapbox/mapbox-geostats
@@ -220,19 +224,53 @@ class OGRMVTDirectoryLayer final: public OGRMVTLayerBase
     bool                        m_bEOF = false;
     int                         m_nXIndex = 0;
     int                         m_nYIndex = 0;
-    GDALDataset                *m_poCurrentTile = nullptr;
     bool                        m_bJsonField = false;
-    GIntBig                     m_nFIDBase = 0;
     OGREnvelope                 m_sExtent;
     int                         m_nFilterMinX = 0;
     int                         m_nFilterMinY = 0;
     int                         m_nFilterMaxX = 0;
     int                         m_nFilterMaxY = 0;
 
+    // Features of a tile, already converted to the definition of this layer
+    struct DecodedTile
+    {
+        std::vector<std::unique_ptr<OGRFeature>> apoFeatures{};
+    };
+
+    struct TileToDecode
+    {
+        OGRMVTDirectoryLayer*        poLayer = nullptr;
+        int                          nX = 0;
+        int                          nY = 0;
+        CPLString                    osFilename{};
+        bool                         bCached = false;
+        // nullptr if the tile does not exist or has not this layer
+        std::shared_ptr<DecodedTile> poDecodedTile{};
+    };
+
+    int                         m_nDecodeThreads = 1;
+    size_t                      m_nTileCacheSize = 0;
+    // Decoded tiles, indexed by (x << z) | y. Tiles that do not exist or
+    // have not this layer are cached as nullptr.
+    lru11::Cache<GIntBig, std::shared_ptr<DecodedTile>> m_oTileCache;
+    // Decoded tiles waiting to be iterated over
+    std::deque<std::shared_ptr<DecodedTile>> m_apoPendingTiles{};
+    std::shared_ptr<DecodedTile> m_poCurrentTile{};
+    size_t                      m_nCurrentFeature = 0;
+
     virtual OGRFeature         *GetNextRawFeature() override;
     OGRFeature*                 CreateFeatureFrom(OGRFeature* poSrcFeature);
     void                        ReadNewSubDir();
-    void                        OpenTile();
+    bool                        GetNextTileCoords(int& nX, int& nY,
+                                                  CPLString& osFilename);
+    GIntBig                     GetTileKey(int nX, int nY) const
+                        { return (static_cast<GIntBig>(nX) << m_nZ) | nY; }
+    GDALDataset*                OpenTileDataset(const char* pszFilename,
+                                                bool bJsonField) const;
+    std::shared_ptr<DecodedTile> DecodeTile(int nX, int nY,
+                                            const char* pszFilename);
+    static void                 DecodeTileFunc(void* pData);
+    void                        DecodeNextTiles();
     void                        OpenTileIfNeeded();
 
   public:
@@ -1405,7 +1443,10 @@ OGRMVTDirectoryLayer::OGRMVTDirectoryLayer(
                                     const OGREnvelope* psExtent):
     m_poDS(poDS),
     m_osDirName(pszDirectoryName),
-    m_bJsonField(bJsonField)
+    m_bJsonField(bJsonField),
+    m_nTileCacheSize(static_cast<size_t>(std::max(0, atoi(
+        CPLGetConfigOption("MVT_TILE_CACHE_SIZE", "32"))))),
+    m_oTileCache(m_nTileCacheSize, 0)
 {
     m_poFeatureDefn = new OGRFeatureDefn(pszLayerName);
     SetDescription(m_poFeatureDefn->GetName());
@@ -1426,6 +1467,14 @@ OGRMVTDirectoryLayer::OGRMVTDirectoryLayer(
 
     m_nZ = atoi(CPLGetFilename(m_osDirName));
     SetMetadataItem("ZOOM_LEVEL", CPLSPrintf("%d", m_nZ));
+    const char* pszNumThreads =
+        CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszNumThreads != nullptr )
+    {
+        m_nDecodeThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+            CPLGetNumCPUs() : atoi(pszNumThreads);
+        m_nDecodeThreads = std::max(1, std::min(128, m_nDecodeThreads));
+    }
     m_bUseReadDir = CPLTestBool(
         CPLGetConfigOption("MVT_USE_READDIR",
                     (!STARTS_WITH(m_osDirName, "/vsicurl") &&
@@ -1456,18 +1505,23 @@ OGRMVTDirectoryLayer::OGRMVTDirectoryLayer(
     // attributes, and in that case create a json field.
     if( !m_bJsonField && oFields.IsValid() && oFields.GetChildren().empty() )
     {
-        m_bJsonField = true;
-        OpenTileIfNeeded();
-        m_bJsonField = false;
-
-        if( m_poCurrentTile )
+        int nX = 0;
+        int nY = 0;
+        CPLString osFilename;
+        while( GetNextTileCoords(nX, nY, osFilename) )
         {
+            std::unique_ptr<GDALDataset> poTile(
+                OpenTileDataset(osFilename, true));
             OGRLayer* poUnderlyingLayer =
-                m_poCurrentTile->GetLayerByName(GetName());
-            // There is at least the mvt_id field
-            if( poUnderlyingLayer->GetLayerDefn()->GetFieldCount() > 1 )
+                poTile ? poTile->GetLayerByName(GetName()) : nullptr;
+            if( poUnderlyingLayer )
             {
-                m_bJsonField = true;
+                // There is at least the mvt_id field
+                if( poUnderlyingLayer->GetLayerDefn()->GetFieldCount() > 1 )
+                {
+                    m_bJsonField = true;
+                }
+                break;
             }
         }
         OGRMVTDirectoryLayer::ResetReading();
@@ -1484,10 +1538,7 @@ OGRMVTDirectoryLayer::OGRMVTDirectoryLayer(
 /*                      ~OGRMVTDirectoryLayer()                         */
 /************************************************************************/
 
-OGRMVTDirectoryLayer::~OGRMVTDirectoryLayer()
-{
-    delete m_poCurrentTile;
-}
+OGRMVTDirectoryLayer::~OGRMVTDirectoryLayer() = default;
 
 /************************************************************************/
 /*                          ResetReading()                              */
@@ -1498,8 +1549,9 @@ void OGRMVTDirectoryLayer::ResetReading()
     m_bEOF = false;
     m_nXIndex = -1;
     m_nYIndex = -1;
-    delete m_poCurrentTile;
-    m_poCurrentTile = nullptr;
+    m_apoPendingTiles.clear();
+    m_poCurrentTile.reset();
+    m_nCurrentFeature = 0;
 }
 
 /************************************************************************/
@@ -1517,8 +1569,6 @@ static bool IsBetween(int nVal, int nMin, int nMax)
 
 void OGRMVTDirectoryLayer::ReadNewSubDir()
 {
-    delete m_poCurrentTile;
-    m_poCurrentTile = nullptr;
     if( m_bUseReadDir || !m_aosDirContent.empty() )
     {
         while( m_nXIndex < m_aosDirContent.Count() &&
@@ -1559,7 +1609,6 @@ void OGRMVTDirectoryLayer::ReadNewSubDir()
             m_aosSubDirContent = StripDummyEntries(m_aosSubDirContent);
         }
         m_nYIndex = -1;
-        OpenTileIfNeeded();
     }
     else
     {
@@ -1568,54 +1617,20 @@ void OGRMVTDirectoryLayer::ReadNewSubDir()
 }
 
 /************************************************************************/
-/*                            OpenTile()                                */
-/************************************************************************/
-
-void OGRMVTDirectoryLayer::OpenTile()
-{
-    delete m_poCurrentTile;
-    m_poCurrentTile = nullptr;
-    if( m_nYIndex <
-            (m_bUseReadDir ? m_aosSubDirContent.Count() : (1 << m_nZ)) )
-    {
-        CPLString osFilename = CPLFormFilename(
-            m_aosSubDirName,
-            m_bUseReadDir ? m_aosSubDirContent[m_nYIndex] :
-                CPLSPrintf("%d.%s",
-                           m_nYIndex, m_poDS->m_osTileExtension.c_str()),
-            nullptr);
-        GDALOpenInfo oOpenInfo(("MVT:" + osFilename).c_str(),
-                               GA_ReadOnly);
-        oOpenInfo.papszOpenOptions = CSLSetNameValue(nullptr,
-                "METADATA_FILE",
-                m_bJsonField ? "" : m_poDS->m_osMetadataMemFilename.c_str());
-        oOpenInfo.papszOpenOptions = CSLSetNameValue(
-            oOpenInfo.papszOpenOptions,
-            "DO_NOT_ERROR_ON_MISSING_TILE", "YES");
-        m_poCurrentTile = OGRMVTDataset::Open(&oOpenInfo);
-        CSLDestroy(oOpenInfo.papszOpenOptions);
-
-        int nX = (m_bUseReadDir || !m_aosDirContent.empty()) ?
-                        atoi(m_aosDirContent[m_nXIndex]) : m_nXIndex;
-        int nY = m_bUseReadDir ? atoi(m_aosSubDirContent[m_nYIndex]) : m_nYIndex;
-        m_nFIDBase = (static_cast<GIntBig>(nX) << m_nZ) | nY;
-    }
-}
-
-/************************************************************************/
-/*                         OpenTileIfNeeded()                           */
+/*                         GetNextTileCoords()                          */
 /************************************************************************/
 
-void OGRMVTDirectoryLayer::OpenTileIfNeeded()
+// Advances to the next tile of the zoom level that may intersect the
+// spatial filter, and returns its coordinates and filename.
+bool OGRMVTDirectoryLayer::GetNextTileCoords(int& nX, int& nY,
+                                             CPLString& osFilename)
 {
     if( m_nXIndex < 0 )
     {
         m_nXIndex = 0;
         ReadNewSubDir();
     }
-    while( (m_poCurrentTile == nullptr && !m_bEOF) ||
-            (m_poCurrentTile != nullptr &&
-                m_poCurrentTile->GetLayerByName(GetName()) == nullptr) )
+    while( !m_bEOF )
     {
         m_nYIndex ++;
         if( m_bUseReadDir )
@@ -1641,12 +1656,156 @@ void OGRMVTDirectoryLayer::OpenTileIfNeeded()
         {
             m_nXIndex ++;
             ReadNewSubDir();
+            continue;
         }
-        else
+
+        osFilename = CPLFormFilename(
+            m_aosSubDirName,
+            m_bUseReadDir ? m_aosSubDirContent[m_nYIndex] :
+                CPLSPrintf("%d.%s",
+                           m_nYIndex, m_poDS->m_osTileExtension.c_str()),
+            nullptr);
+        nX = (m_bUseReadDir || !m_aosDirContent.empty()) ?
+                        atoi(m_aosDirContent[m_nXIndex]) : m_nXIndex;
+        nY = m_bUseReadDir ? atoi(m_aosSubDirContent[m_nYIndex]) : m_nYIndex;
+        return true;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                          OpenTileDataset()                           */
+/************************************************************************/
+
+GDALDataset* OGRMVTDirectoryLayer::OpenTileDataset(const char* pszFilename,
+                                                   bool bJsonField) const
+{
+    GDALOpenInfo oOpenInfo(CPLSPrintf("MVT:%s", pszFilename), GA_ReadOnly);
+    oOpenInfo.papszOpenOptions = CSLSetNameValue(nullptr,
+            "METADATA_FILE",
+            bJsonField ? "" : m_poDS->m_osMetadataMemFilename.c_str());
+    oOpenInfo.papszOpenOptions = CSLSetNameValue(oOpenInfo.papszOpenOptions,
+            "DO_NOT_ERROR_ON_MISSING_TILE", "YES");
+    GDALDataset* poTile = OGRMVTDataset::Open(&oOpenInfo);
+    CSLDestroy(oOpenInfo.papszOpenOptions);
+    return poTile;
+}
+
+/************************************************************************/
+/*                             DecodeTile()                             */
+/************************************************************************/
+
+// May be called concurrently from several threads.
+std::shared_ptr<OGRMVTDirectoryLayer::DecodedTile>
+OGRMVTDirectoryLayer::DecodeTile(int nX, int nY, const char* pszFilename)
+{
+    std::unique_ptr<GDALDataset> poTile(
+        OpenTileDataset(pszFilename, m_bJsonField));
+    if( poTile == nullptr )
+        return nullptr;
+    OGRLayer* poUnderlyingLayer = poTile->GetLayerByName(GetName());
+    if( poUnderlyingLayer == nullptr )
+        return nullptr;
+
+    const GIntBig nFIDBase = GetTileKey(nX, nY);
+    auto poDecodedTile = std::make_shared<DecodedTile>();
+    OGRFeature* poUnderlyingFeature;
+    while( (poUnderlyingFeature = poUnderlyingLayer->GetNextFeature()) !=
+                                                                    nullptr )
+    {
+        OGRFeature* poFeature = CreateFeatureFrom(poUnderlyingFeature);
+        poFeature->SetFID(nFIDBase +
+            (poUnderlyingFeature->GetFID() << (2 * m_nZ)));
+        delete poUnderlyingFeature;
+        poDecodedTile->apoFeatures.emplace_back(poFeature);
+    }
+    return poDecodedTile;
+}
+
+/************************************************************************/
+/*                           DecodeTileFunc()                           */
+/************************************************************************/
+
+void OGRMVTDirectoryLayer::DecodeTileFunc(void* pData)
+{
+    TileToDecode* psTile = static_cast<TileToDecode*>(pData);
+    psTile->poDecodedTile = psTile->poLayer->DecodeTile(
+        psTile->nX, psTile->nY, psTile->osFilename);
+}
+
+/************************************************************************/
+/*                           DecodeNextTiles()                          */
+/************************************************************************/
+
+// Enumerates the next tiles (as many as there are decoding threads), and
+// decodes those that are not in the cache, in parallel when GDAL_NUM_THREADS
+// is set.
+void OGRMVTDirectoryLayer::DecodeNextTiles()
+{
+    std::vector<TileToDecode> asTiles;
+    while( asTiles.size() < static_cast<size_t>(m_nDecodeThreads) )
+    {
+        TileToDecode sTile;
+        if( !GetNextTileCoords(sTile.nX, sTile.nY, sTile.osFilename) )
+            break;
+        sTile.poLayer = this;
+        sTile.bCached = m_nTileCacheSize > 0 &&
+            m_oTileCache.tryGet(GetTileKey(sTile.nX, sTile.nY),
+                                sTile.poDecodedTile);
+        asTiles.push_back(sTile);
+    }
+
+    CPLWorkerThreadPool* poThreadPool = m_nDecodeThreads > 1 ?
+        GDALGetGlobalThreadPool(m_nDecodeThreads) : nullptr;
+    auto poJobQueue = poThreadPool ? poThreadPool->CreateJobQueue() : nullptr;
+    for( auto& sTile: asTiles )
+    {
+        if( sTile.bCached )
+            continue;
+        if( poJobQueue == nullptr ||
+            !poJobQueue->SubmitJob(DecodeTileFunc, &sTile) )
         {
-            OpenTile();
+            DecodeTileFunc(&sTile);
         }
     }
+    if( poJobQueue )
+        poJobQueue->WaitCompletion();
+
+    for( auto& sTile: asTiles )
+    {
+        if( !sTile.bCached && m_nTileCacheSize > 0 )
+        {
+            m_oTileCache.insert(GetTileKey(sTile.nX, sTile.nY),
+                                sTile.poDecodedTile);
+        }
+        if( sTile.poDecodedTile && !sTile.poDecodedTile->apoFeatures.empty() )
+            m_apoPendingTiles.push_back(std::move(sTile.poDecodedTile));
+    }
+}
+
+/************************************************************************/
+/*                         OpenTileIfNeeded()                           */
+/************************************************************************/
+
+// Makes m_poCurrentTile point to a tile with remaining features, or nullptr
+// at the end of the layer.
+void OGRMVTDirectoryLayer::OpenTileIfNeeded()
+{
+    while( m_poCurrentTile == nullptr ||
+           m_nCurrentFeature == m_poCurrentTile->apoFeatures.size() )
+    {
+        m_poCurrentTile.reset();
+        m_nCurrentFeature = 0;
+        if( m_apoPendingTiles.empty() )
+        {
+            if( m_bEOF )
+                return;
+            DecodeNextTiles();
+            continue;
+        }
+        m_poCurrentTile = std::move(m_apoPendingTiles.front());
+        m_apoPendingTiles.pop_front();
+    }
 }
 
 /************************************************************************/
@@ -1659,16 +1818,24 @@ GIntBig OGRMVTDirectoryLayer::GetFeatureCount( int bForce )
     {
         GIntBig nFeatureCount = 0;
         ResetReading();
-        while( true )
+        int nX = 0;
+        int nY = 0;
+        CPLString osFilename;
+        while( GetNextTileCoords(nX, nY, osFilename) )
         {
-            OpenTileIfNeeded();
-            if( m_poCurrentTile == nullptr )
-                break;
+            std::shared_ptr<DecodedTile> poDecodedTile;
+            if( m_oTileCache.tryGet(GetTileKey(nX, nY), poDecodedTile) )
+            {
+                if( poDecodedTile )
+                    nFeatureCount += poDecodedTile->apoFeatures.size();
+                continue;
+            }
+            std::unique_ptr<GDALDataset> poTile(
+                OpenTileDataset(osFilename, m_bJsonField));
             OGRLayer* poUnderlyingLayer =
-                m_poCurrentTile->GetLayerByName(GetName());
-            nFeatureCount += poUnderlyingLayer->GetFeatureCount(bForce);
-            delete m_poCurrentTile;
-            m_poCurrentTile = nullptr;
+                poTile ? poTile->GetLayerByName(GetName()) : nullptr;
+            if( poUnderlyingLayer )
+                nFeatureCount += poUnderlyingLayer->GetFeatureCount(bForce);
         }
         ResetReading();
         return nFeatureCount;
@@ -1706,11 +1873,12 @@ void OGRMVTDirectoryLayer::SetSpatialFilter( OGRGeometry * poGeomIn )
             floor((sEnvelope.MinX - m_poDS->GetTopXOrigin()) / dfTileDim)));
         m_nFilterMinY = std::max(0, static_cast<int>(
             floor((m_poDS->GetTopYOrigin() - sEnvelope.MaxY) / dfTileDim)));
+        // Only the tiles intersecting the envelope
         m_nFilterMaxX = std::min(static_cast<int>(
-            ceil((sEnvelope.MaxX - m_poDS->GetTopXOrigin()) / dfTileDim)),
+            floor((sEnvelope.MaxX - m_poDS->GetTopXOrigin()) / dfTileDim)),
             (1 << m_nZ)-1);
         m_nFilterMaxY = std::min(static_cast<int>(
-            ceil((m_poDS->GetTopYOrigin() - sEnvelope.MinY) / dfTileDim)),
+            floor((m_poDS->GetTopYOrigin() - sEnvelope.MinY) / dfTileDim)),
             (1 << m_nZ)-1);
     }
     else
@@ -1766,28 +1934,14 @@ OGRFeature* OGRMVTDirectoryLayer::CreateFeatureFrom(OGRFeature* poSrcFeature)
 
 OGRFeature* OGRMVTDirectoryLayer::GetNextRawFeature()
 {
-    while( true )
-    {
-        OpenTileIfNeeded();
-        if( m_poCurrentTile == nullptr )
-            return nullptr;
-        OGRLayer* poUnderlyingLayer =
-            m_poCurrentTile->GetLayerByName(GetName());
-        OGRFeature* poUnderlyingFeature = poUnderlyingLayer->GetNextFeature();
-        if( poUnderlyingFeature != nullptr )
-        {
-            OGRFeature* poFeature = CreateFeatureFrom(poUnderlyingFeature);
-            poFeature->SetFID(m_nFIDBase +
-                (poUnderlyingFeature->GetFID() << (2 * m_nZ)));
-            delete poUnderlyingFeature;
-            return poFeature;
-        }
-        else
-        {
-            delete m_poCurrentTile;
-            m_poCurrentTile = nullptr;
-        }
-    }
+    OpenTileIfNeeded();
+    if( m_poCurrentTile == nullptr )
+        return nullptr;
+    auto& poFeature = m_poCurrentTile->apoFeatures[m_nCurrentFeature++];
+    // Take the feature if the tile is not (or no longer) in the cache
+    if( m_poCurrentTile.use_count() == 1 )
+        return poFeature.release();
+    return poFeature->Clone();
 }
 
 /************************************************************************/
@@ -1796,20 +1950,33 @@ OGRFeature* OGRMVTDirectoryLayer::GetNextRawFeature()
 
 OGRFeature* OGRMVTDirectoryLayer::GetFeature(GIntBig nFID)
 {
-    const int nX = static_cast<int>(nFID & ((1 << m_nZ)-1));
-    const int nY = static_cast<int>((nFID >> m_nZ) & ((1 << m_nZ)-1));
+    // The lower bits are those of the y coordinate, as in GetTileKey()
+    const int nY = static_cast<int>(nFID & ((1 << m_nZ)-1));
+    const int nX = static_cast<int>((nFID >> m_nZ) & ((1 << m_nZ)-1));
     const GIntBig nTileFID = nFID >> (2 * m_nZ);
+
+    std::shared_ptr<DecodedTile> poDecodedTile;
+    if( m_oTileCache.tryGet(GetTileKey(nX, nY), poDecodedTile) )
+    {
+        if( poDecodedTile )
+        {
+            for( const auto& poCachedFeature: poDecodedTile->apoFeatures )
+            {
+                if( (poCachedFeature->GetFID() >> (2 * m_nZ)) == nTileFID )
+                {
+                    OGRFeature* poFeature = poCachedFeature->Clone();
+                    poFeature->SetFID(nFID);
+                    return poFeature;
+                }
+            }
+        }
+        return nullptr;
+    }
+
     const CPLString osFilename = CPLFormFilename(
         CPLFormFilename( m_osDirName, CPLSPrintf("%d", nX), nullptr),
         CPLSPrintf("%d.%s", nY, m_poDS->m_osTileExtension.c_str()), nullptr);
-    GDALOpenInfo oOpenInfo(("MVT:" + osFilename).c_str(), GA_ReadOnly);
-    oOpenInfo.papszOpenOptions = CSLSetNameValue(nullptr,
-            "METADATA_FILE",
-            m_bJsonField ? "" : m_poDS->m_osMetadataMemFilename.c_str());
-    oOpenInfo.papszOpenOptions = CSLSetNameValue(oOpenInfo.papszOpenOptions,
-            "DO_NOT_ERROR_ON_MISSING_TILE", "YES");
-    GDALDataset* poTile = OGRMVTDataset::Open(&oOpenInfo);
-    CSLDestroy(oOpenInfo.papszOpenOptions);
+    GDALDataset* poTile = OpenTileDataset(osFilename, m_bJsonField);
     OGRFeature* poFeature = nullptr;
     if( poTile )
     {
@@ -3216,6 +3383,40 @@ class OGRMVTWriterDataset final: public GDALDataset
                 std::set<CPLString> m_oSetFields;
         };
 
+        // Geometry type and attributes of a feature encoded at full
+        // resolution, used to update the MVTLayerProperties in tile order.
+        class MVTFeatureProperties
+        {
+            public:
+                size_t m_iLayer = 0;
+                MVTTileLayerFeature::GeomType m_eGeomType =
+                    MVTTileLayerFeature::GeomType::UNKNOWN;
+                std::vector<std::pair<std::string, MVTTileLayerValue>>
+                                                        m_aoTags;
+        };
+
+        // Features of a tile read from the temporary database by the main
+        // thread, and result of their encoding by a worker thread.
+        class MVTTileEncodingJob
+        {
+            public:
+                OGRMVTWriterDataset* m_poDS = nullptr;
+                int m_nZ = 0;
+                int m_nX = 0;
+                int m_nY = 0;
+                std::vector<CPLString> m_aosLayerNames;
+                // Sorted by layer, then idx
+                std::vector<size_t> m_anFeatureLayer;
+                std::vector<std::string> m_aosFeatures;
+                std::vector<double> m_adfAreaOrLength;
+
+                std::string m_osTileBuffer{};
+                // Number of layers of m_aosLayerNames used in the tile
+                size_t m_nLayersEncoded = 0;
+                std::vector<MVTFeatureProperties> m_aoFeatureProps{};
+                bool m_bDone = false; // protected by m_oDBMutex
+        };
+
         std::vector<std::unique_ptr<OGRMVTWriterLayer>> m_apoLayers;
         CPLString                              m_osTempDB;
         mutable std::mutex                     m_oDBMutex;
@@ -3312,29 +3513,31 @@ class OGRMVTWriterDataset final: public GDALDataset
                                     const std::string& osKey,
                                     const MVTTileLayerValue& oValue);
 
-        void EncodeFeature(
-                        const void* pabyBlob,
-                        int nBlobSize,
+        bool EncodeFeature(
+                        const std::string& osBlob,
                         std::shared_ptr<MVTTileLayer> poTargetLayer,
                         std::map<CPLString, GUInt32>& oMapKeyToIdx,
                         std::map<MVTTileLayerValue, GUInt32>& oMapValueToIdx,
-                        MVTLayerProperties* poLayerProperties,
+                        MVTFeatureProperties* poFeatureProps,
                         GUInt32 nExtent,
-                        unsigned& nFeaturesInTile);
+                        unsigned& nFeaturesInTile) const;
 
-        std::string EncodeTile(
-                        int nZ, int nX, int nY,
-                        sqlite3_stmt* hStmtLayer,
-                        sqlite3_stmt* hStmtRows,
-                        std::map<CPLString, MVTLayerProperties>& oMapLayerProps,
-                        std::set<CPLString>& oSetLayers,
-                        GIntBig& nTempTilesRead);
+        bool ReadTileFeatures(sqlite3_stmt* hStmtTile,
+                              MVTTileEncodingJob& oJob,
+                              GIntBig& nTempTilesRead) const;
+
+        static void EncodeTileFunc(void* pParam);
+
+        void EncodeTile(MVTTileEncodingJob& oJob) const;
 
         std::string RecodeTileLowerResolution(
-                                int nZ, int nX, int nY,
-                                int nExtent,
-                                sqlite3_stmt* hStmtLayer,
-                                sqlite3_stmt* hStmtRows);
+                                const MVTTileEncodingJob& oJob,
+                                GUInt32 nExtent) const;
+
+        void MergeTileLayerProperties(
+                        const MVTTileEncodingJob& oJob,
+                        std::map<CPLString, MVTLayerProperties>& oMapLayerProps,
+                        std::set<CPLString>& oSetLayers);
 
         bool                CreateOutput();
 
@@ -4727,18 +4930,20 @@ static std::vector<GUInt32> GetReducedPrecisionGeometry(
 /*                          EncodeFeature()                             */
 /************************************************************************/
 
-void OGRMVTWriterDataset::EncodeFeature(
-                        const void* pabyBlob,
-                        int nBlobSize,
+// Returns true if the source feature could be decoded, in which case
+// poFeatureProps (if not null) is filled.
+bool OGRMVTWriterDataset::EncodeFeature(
+                        const std::string& osBlob,
                         std::shared_ptr<MVTTileLayer> poTargetLayer,
                         std::map<CPLString, GUInt32>& oMapKeyToIdx,
                         std::map<MVTTileLayerValue, GUInt32>& oMapValueToIdx,
-                        MVTLayerProperties* poLayerProperties,
+                        MVTFeatureProperties* poFeatureProps,
                         GUInt32 nExtent,
-                        unsigned& nFeaturesInTile)
+                        unsigned& nFeaturesInTile) const
 {
+    bool bRet = false;
     size_t nUncompressedSize = 0;
-    void* pCompressed = CPLZLibInflate( pabyBlob, nBlobSize,
+    void* pCompressed = CPLZLibInflate( osBlob.data(), osBlob.size(),
                                         nullptr, 0,
                                         &nUncompressedSize);
     GByte* pabyUncompressed = static_cast<GByte*>(pCompressed);
@@ -4758,11 +4963,11 @@ void OGRMVTWriterDataset::EncodeFeature(
             if( poSrcFeature->hasId() )
                 poFeature->setId(poSrcFeature->getId());
             poFeature->setType(poSrcFeature->getType());
-            if( poLayerProperties )
+            if( poFeatureProps )
             {
-                poLayerProperties->
-                    m_oCountGeomType[poSrcFeature->getType()] ++;
+                poFeatureProps->m_eGeomType = poSrcFeature->getType();
             }
+            bRet = true;
             bool bOK = true;
             if( nExtent < m_nExtent )
             {
@@ -4836,11 +5041,10 @@ void OGRMVTWriterDataset::EncodeFeature(
                         auto& osKey = srcKeys[nSrcIdxKey];
                         auto& oValue = srcValues[nSrcIdxValue];
 
-                        if( poLayerProperties )
+                        if( poFeatureProps )
                         {
-                            UpdateLayerProperties(poLayerProperties,
-                                                    osKey,
-                                                    oValue);
+                            poFeatureProps->m_aoTags.emplace_back(osKey,
+                                                                  oValue);
                         }
 
                         poFeature->addTag(oMapKeyToIdx[osKey]);
@@ -4861,102 +5065,127 @@ void OGRMVTWriterDataset::EncodeFeature(
     }
 
     CPLFree(pabyUncompressed);
+    return bRet;
 }
 
 /************************************************************************/
-/*                            EncodeTile()                              */
+/*                          ReadTileFeatures()                          */
 /************************************************************************/
 
-std::string OGRMVTWriterDataset::EncodeTile(
-                        int nZ, int nX, int nY,
-                        sqlite3_stmt* hStmtLayer,
-                        sqlite3_stmt* hStmtRows,
-                        std::map<CPLString, MVTLayerProperties>& oMapLayerProps,
-                        std::set<CPLString>& oSetLayers,
-                        GIntBig& nTempTilesRead)
+// Read from the temporary database the features of the tile of oJob,
+// ordered by layer and idx.
+bool OGRMVTWriterDataset::ReadTileFeatures(sqlite3_stmt* hStmtTile,
+                                           MVTTileEncodingJob& oJob,
+                                           GIntBig& nTempTilesRead) const
 {
-    MVTTile oTargetTile;
-
-    sqlite3_bind_int(hStmtLayer, 1, nZ);
-    sqlite3_bind_int(hStmtLayer, 2, nX);
-    sqlite3_bind_int(hStmtLayer, 3, nY);
+    sqlite3_bind_int(hStmtTile, 1, oJob.m_nZ);
+    sqlite3_bind_int(hStmtTile, 2, oJob.m_nX);
+    sqlite3_bind_int(hStmtTile, 3, oJob.m_nY);
 
-    unsigned nFeaturesInTile = 0;
     const GIntBig nProgressStep = std::max( static_cast<GIntBig>(1),
                                             m_nTempTiles / 10 );
 
-    while( nFeaturesInTile < m_nMaxFeatures &&
-           sqlite3_step(hStmtLayer) == SQLITE_ROW )
+    int rc;
+    while( (rc = sqlite3_step(hStmtTile)) == SQLITE_ROW )
     {
         const char* pszLayerName = reinterpret_cast<const char*>(
-            sqlite3_column_text(hStmtLayer, 0));
-        sqlite3_bind_int(hStmtRows, 1, nZ);
-        sqlite3_bind_int(hStmtRows, 2, nX);
-        sqlite3_bind_int(hStmtRows, 3, nY); 
-        sqlite3_bind_text(hStmtRows, 4, pszLayerName, -1, SQLITE_STATIC);
-
-        auto oIterMapLayerProps = oMapLayerProps.find(pszLayerName);
-        MVTLayerProperties* poLayerProperties = nullptr;
-        if( oIterMapLayerProps == oMapLayerProps.end() )
-        {
-            if( oSetLayers.size() < knMAX_COUNT_LAYERS )
-            {
-                oSetLayers.insert(pszLayerName);
-                if( oMapLayerProps.size() < knMAX_REPORT_LAYERS )
-                {
-                    MVTLayerProperties props;
-                    props.m_nMinZoom = nZ;
-                    props.m_nMaxZoom = nZ;
-                    oMapLayerProps[pszLayerName] = props;
-                    poLayerProperties = &(oMapLayerProps[pszLayerName]);
-                }
-            }
-        }
-        else
+            sqlite3_column_text(hStmtTile, 0));
+        if( pszLayerName == nullptr )
+            pszLayerName = "";
+        if( oJob.m_aosLayerNames.empty() ||
+            oJob.m_aosLayerNames.back() != pszLayerName )
         {
-            poLayerProperties = &(oIterMapLayerProps->second);
+            oJob.m_aosLayerNames.push_back(pszLayerName);
         }
-        if( poLayerProperties )
+        oJob.m_anFeatureLayer.push_back(oJob.m_aosLayerNames.size() - 1);
+
+        const int nBlobSize = sqlite3_column_bytes(hStmtTile, 1);
+        const char* pabyBlob = static_cast<const char*>(
+            sqlite3_column_blob(hStmtTile, 1));
+        oJob.m_aosFeatures.emplace_back(
+            pabyBlob ? std::string(pabyBlob, nBlobSize) : std::string());
+        oJob.m_adfAreaOrLength.push_back(sqlite3_column_double(hStmtTile, 2));
+
+        nTempTilesRead ++;
+        if( nTempTilesRead == m_nTempTiles||
+            (nTempTilesRead % nProgressStep) == 0 )
         {
-            poLayerProperties->m_nMinZoom =
-                std::min(nZ, poLayerProperties->m_nMinZoom);
-            poLayerProperties->m_nMaxZoom =
-                std::max(nZ, poLayerProperties->m_nMaxZoom);
+            const int nPct = static_cast<int>(
+                                (100 * nTempTilesRead) / m_nTempTiles);
+            CPLDebug("MVT", "%d%%...", nPct);
         }
+    }
+    sqlite3_reset(hStmtTile);
+
+    return rc == SQLITE_DONE;
+}
+
+/************************************************************************/
+/*                           EncodeTileFunc()                           */
+/************************************************************************/
+
+void OGRMVTWriterDataset::EncodeTileFunc(void* pParam)
+{
+    MVTTileEncodingJob* poJob = static_cast<MVTTileEncodingJob*>(pParam);
+    poJob->m_poDS->EncodeTile(*poJob);
+    std::lock_guard<std::mutex> oLock(poJob->m_poDS->m_oDBMutex);
+    poJob->m_bDone = true;
+}
+
+/************************************************************************/
+/*                            EncodeTile()                              */
+/************************************************************************/
+
+// Build the tile from the features of oJob. This does not access the
+// temporary database, nor modify the dataset, so that it can be run from a
+// worker thread.
+void OGRMVTWriterDataset::EncodeTile(MVTTileEncodingJob& oJob) const
+{
+    const int nZ = oJob.m_nZ;
+    const int nX = oJob.m_nX;
+    const int nY = oJob.m_nY;
+    const size_t nFeatures = oJob.m_aosFeatures.size();
+
+    MVTTile oTargetTile;
+
+    unsigned nFeaturesInTile = 0;
+    size_t iFeature = 0;
+
+    for( size_t iLayer = 0;
+         nFeaturesInTile < m_nMaxFeatures &&
+         iLayer < oJob.m_aosLayerNames.size(); ++iLayer )
+    {
+        oJob.m_nLayersEncoded ++;
 
         std::shared_ptr<MVTTileLayer> poTargetLayer(new MVTTileLayer());
         oTargetTile.addLayer(poTargetLayer);
-        poTargetLayer->setName(pszLayerName);
+        poTargetLayer->setName(oJob.m_aosLayerNames[iLayer]);
         poTargetLayer->setVersion(m_nMVTVersion);
         poTargetLayer->setExtent(m_nExtent);
 
         std::map<CPLString, GUInt32> oMapKeyToIdx;
         std::map<MVTTileLayerValue, GUInt32> oMapValueToIdx;
 
-        while( nFeaturesInTile < m_nMaxFeatures &&
-               sqlite3_step(hStmtRows) == SQLITE_ROW )
+        for( ; nFeaturesInTile < m_nMaxFeatures &&
+               iFeature < nFeatures &&
+               oJob.m_anFeatureLayer[iFeature] == iLayer; ++iFeature )
         {
-            int nBlobSize = sqlite3_column_bytes(hStmtRows, 0);
-            const void* pabyBlob = sqlite3_column_blob(hStmtRows, 0);
-
-            EncodeFeature(pabyBlob, nBlobSize, poTargetLayer,
-                          oMapKeyToIdx, oMapValueToIdx,
-                          poLayerProperties, m_nExtent, nFeaturesInTile);
-
-            nTempTilesRead ++;
-            if( nTempTilesRead == m_nTempTiles||
-                (nTempTilesRead % nProgressStep) == 0 )
+            MVTFeatureProperties oFeatureProps;
+            oFeatureProps.m_iLayer = iLayer;
+            if( EncodeFeature(oJob.m_aosFeatures[iFeature], poTargetLayer,
+                              oMapKeyToIdx, oMapValueToIdx,
+                              &oFeatureProps, m_nExtent, nFeaturesInTile) )
             {
-                const int nPct = static_cast<int>(
-                                    (100 * nTempTilesRead) / m_nTempTiles);
-                CPLDebug("MVT", "%d%%...", nPct);
+                oJob.m_aoFeatureProps.push_back(std::move(oFeatureProps));
             }
         }
-        sqlite3_reset(hStmtRows);
+        while( iFeature < nFeatures &&
+               oJob.m_anFeatureLayer[iFeature] == iLayer )
+        {
+            ++iFeature;
+        }
     }
 
-    sqlite3_reset(hStmtLayer);
-
     std::string oTileBuffer(oTargetTile.write());
     size_t nSizeBefore = oTileBuffer.size();
     if( m_bGZip) 
@@ -4976,8 +5205,7 @@ std::string OGRMVTWriterDataset::EncodeTile(
     {
         nExtent /= 2;
         nSizeBefore = oTileBuffer.size();
-        oTileBuffer = RecodeTileLowerResolution(nZ, nX, nY, nExtent,
-                                                hStmtLayer, hStmtRows);
+        oTileBuffer = RecodeTileLowerResolution(oJob, nExtent);
         bTooBigTile = oTileBuffer.size() > m_nMaxTileSize;
         CPLDebug("MVT", "Recoding tile %d/%d/%d with extent = %u. "
                  "From %u to %u bytes",
@@ -5007,17 +5235,18 @@ std::string OGRMVTWriterDataset::EncodeTile(
 
         const unsigned nTotalFeaturesInTile =
                                 std::min(m_nMaxFeatures, nFeaturesInTile);
-        char* pszSQL = sqlite3_mprintf(
-            "SELECT layer, feature FROM temp "
-            "WHERE z = %d AND x = %d AND y = %d ORDER BY "
-            "area_or_length DESC LIMIT %d",
-            nZ, nX, nY, nTotalFeaturesInTile);
-        sqlite3_stmt* hTmpStmt = nullptr;
-        CPL_IGNORE_RET_VAL(
-            sqlite3_prepare_v2( m_hDB, pszSQL, -1, &hTmpStmt, nullptr) );
-        sqlite3_free(pszSQL);
-        if( !hTmpStmt )
-            return std::string();
+
+        // Features by descending area / length
+        std::vector<size_t> anSortedFeatures(nFeatures);
+        for( size_t i = 0; i < nFeatures; ++i )
+            anSortedFeatures[i] = i;
+        std::stable_sort(anSortedFeatures.begin(), anSortedFeatures.end(),
+            [&oJob](size_t a, size_t b)
+            {
+                return oJob.m_adfAreaOrLength[a] > oJob.m_adfAreaOrLength[b];
+            });
+        if( anSortedFeatures.size() > nTotalFeaturesInTile )
+            anSortedFeatures.resize(nTotalFeaturesInTile);
 
         class TargetTileLayerProps
         {
@@ -5032,12 +5261,10 @@ std::string OGRMVTWriterDataset::EncodeTile(
 
         nFeaturesInTile = 0;
         const unsigned nCheckStep = std::max(1U, nTotalFeaturesInTile / 100);
-        while( sqlite3_step(hTmpStmt) == SQLITE_ROW )
+        for( const size_t iSortedFeature: anSortedFeatures )
         {
-            const char* pszLayerName = reinterpret_cast<const char*>(
-                sqlite3_column_text(hTmpStmt, 0));
-            int nBlobSize = sqlite3_column_bytes(hTmpStmt, 1);
-            const void* pabyBlob = sqlite3_column_blob(hTmpStmt, 1);
+            const char* pszLayerName = oJob.m_aosLayerNames[
+                oJob.m_anFeatureLayer[iSortedFeature]].c_str();
 
             std::shared_ptr<MVTTileLayer> poTargetLayer;
             std::map<CPLString, GUInt32>* poMapKeyToIdx;
@@ -5066,7 +5293,7 @@ std::string OGRMVTWriterDataset::EncodeTile(
                 poMapValueToIdx = &oIter->second.m_oMapValueToIdx;
             }
 
-            EncodeFeature(pabyBlob, nBlobSize, poTargetLayer,
+            EncodeFeature(oJob.m_aosFeatures[iSortedFeature], poTargetLayer,
                           *poMapKeyToIdx, *poMapValueToIdx,
                           nullptr, nExtent, nFeaturesInTile);
 
@@ -5091,11 +5318,9 @@ std::string OGRMVTWriterDataset::EncodeTile(
                      nZ, nX, nY,
                      static_cast<unsigned>(oTileBuffer.size()));
         }
-
-        sqlite3_finalize(hTmpStmt);
     }
 
-    return oTileBuffer;
+    oJob.m_osTileBuffer = std::move(oTileBuffer);
 }
 
 /************************************************************************/
@@ -5103,53 +5328,43 @@ std::string OGRMVTWriterDataset::EncodeTile(
 /************************************************************************/
 
 std::string OGRMVTWriterDataset::RecodeTileLowerResolution(
-                                            int nZ, int nX, int nY,
-                                            int nExtent,
-                                            sqlite3_stmt* hStmtLayer,
-                                            sqlite3_stmt* hStmtRows)
+                                            const MVTTileEncodingJob& oJob,
+                                            GUInt32 nExtent) const
 {
-    MVTTile oTargetTile;
+    const size_t nFeatures = oJob.m_aosFeatures.size();
 
-    sqlite3_bind_int(hStmtLayer, 1, nZ);
-    sqlite3_bind_int(hStmtLayer, 2, nX);
-    sqlite3_bind_int(hStmtLayer, 3, nY);
+    MVTTile oTargetTile;
 
     unsigned nFeaturesInTile = 0;
-    while( nFeaturesInTile < m_nMaxFeatures &&
-           sqlite3_step(hStmtLayer) == SQLITE_ROW )
+    size_t iFeature = 0;
+    for( size_t iLayer = 0;
+         nFeaturesInTile < m_nMaxFeatures &&
+         iLayer < oJob.m_aosLayerNames.size(); ++iLayer )
     {
-        const char* pszLayerName = reinterpret_cast<const char*>(
-            sqlite3_column_text(hStmtLayer, 0));
-        sqlite3_bind_int(hStmtRows, 1, nZ);
-        sqlite3_bind_int(hStmtRows, 2, nX);
-        sqlite3_bind_int(hStmtRows, 3, nY); 
-        sqlite3_bind_text(hStmtRows, 4, pszLayerName, -1, SQLITE_STATIC);
-
         std::shared_ptr<MVTTileLayer> poTargetLayer(new MVTTileLayer());
         oTargetTile.addLayer(poTargetLayer);
-        poTargetLayer->setName(pszLayerName);
+        poTargetLayer->setName(oJob.m_aosLayerNames[iLayer]);
         poTargetLayer->setVersion(m_nMVTVersion);
         poTargetLayer->setExtent(nExtent);
 
         std::map<CPLString, GUInt32> oMapKeyToIdx;
         std::map<MVTTileLayerValue, GUInt32> oMapValueToIdx;
 
-        while( nFeaturesInTile < m_nMaxFeatures &&
-               sqlite3_step(hStmtRows) == SQLITE_ROW )
+        for( ; nFeaturesInTile < m_nMaxFeatures &&
+               iFeature < nFeatures &&
+               oJob.m_anFeatureLayer[iFeature] == iLayer; ++iFeature )
         {
-            int nBlobSize = sqlite3_column_bytes(hStmtRows, 0);
-            const void* pabyBlob = sqlite3_column_blob(hStmtRows, 0);
-
-            EncodeFeature(pabyBlob, nBlobSize, poTargetLayer,
+            EncodeFeature(oJob.m_aosFeatures[iFeature], poTargetLayer,
                           oMapKeyToIdx, oMapValueToIdx,
                           nullptr, nExtent, nFeaturesInTile);
-
         }
-        sqlite3_reset(hStmtRows);
+        while( iFeature < nFeatures &&
+               oJob.m_anFeatureLayer[iFeature] == iLayer )
+        {
+            ++iFeature;
+        }
     }
 
-    sqlite3_reset(hStmtLayer);
-
     std::string oTileBuffer(oTargetTile.write());
     if( m_bGZip) 
         GZIPCompress(oTileBuffer);
@@ -5157,6 +5372,70 @@ std::string OGRMVTWriterDataset::RecodeTileLowerResolution(
     return oTileBuffer;
 }
 
+/************************************************************************/
+/*                     MergeTileLayerProperties()                       */
+/************************************************************************/
+
+// Update the layer properties from the features encoded in a tile. Must be
+// called in tile order, as the number of layers, fields and values reported
+// is limited.
+void OGRMVTWriterDataset::MergeTileLayerProperties(
+                        const MVTTileEncodingJob& oJob,
+                        std::map<CPLString, MVTLayerProperties>& oMapLayerProps,
+                        std::set<CPLString>& oSetLayers)
+{
+    const int nZ = oJob.m_nZ;
+    std::vector<MVTLayerProperties*> apoLayerProperties;
+    for( size_t iLayer = 0; iLayer < oJob.m_nLayersEncoded; ++iLayer )
+    {
+        const CPLString& osLayerName = oJob.m_aosLayerNames[iLayer];
+        auto oIterMapLayerProps = oMapLayerProps.find(osLayerName);
+        MVTLayerProperties* poLayerProperties = nullptr;
+        if( oIterMapLayerProps == oMapLayerProps.end() )
+        {
+            if( oSetLayers.size() < knMAX_COUNT_LAYERS )
+            {
+                oSetLayers.insert(osLayerName);
+                if( oMapLayerProps.size() < knMAX_REPORT_LAYERS )
+                {
+                    MVTLayerProperties props;
+                    props.m_nMinZoom = nZ;
+                    props.m_nMaxZoom = nZ;
+                    oMapLayerProps[osLayerName] = props;
+                    poLayerProperties = &(oMapLayerProps[osLayerName]);
+                }
+            }
+        }
+        else
+        {
+            poLayerProperties = &(oIterMapLayerProps->second);
+        }
+        if( poLayerProperties )
+        {
+            poLayerProperties->m_nMinZoom =
+                std::min(nZ, poLayerProperties->m_nMinZoom);
+            poLayerProperties->m_nMaxZoom =
+                std::max(nZ, poLayerProperties->m_nMaxZoom);
+        }
+        apoLayerProperties.push_back(poLayerProperties);
+    }
+
+    for( const auto& oFeatureProps: oJob.m_aoFeatureProps )
+    {
+        MVTLayerProperties* poLayerProperties =
+            apoLayerProperties[oFeatureProps.m_iLayer];
+        if( poLayerProperties )
+        {
+            poLayerProperties->m_oCountGeomType[oFeatureProps.m_eGeomType] ++;
+            for( const auto& oTag: oFeatureProps.m_aoTags )
+            {
+                UpdateLayerProperties(poLayerProperties,
+                                      oTag.first, oTag.second);
+            }
+        }
+    }
+}
+
 /************************************************************************/
 /*                            CreateOutput()                            */
 /************************************************************************/
@@ -5187,29 +5466,16 @@ bool OGRMVTWriterDataset::CreateOutput()
         return false;
     }
 
-    sqlite3_stmt* hStmtLayer = nullptr;
-    CPL_IGNORE_RET_VAL(
-        sqlite3_prepare_v2( m_hDB,
-            "SELECT DISTINCT layer FROM temp "
-            "WHERE z = ? AND x = ? AND y = ? ORDER BY layer",
-            -1, &hStmtLayer, nullptr) );
-    if( hStmtLayer == nullptr )
-    {
-        CPLError(CE_Failure, CPLE_AppDefined, "Prepared statement failed");
-        sqlite3_finalize(hStmtZXY);
-        return false;
-    }
-    sqlite3_stmt* hStmtRows = nullptr;
+    sqlite3_stmt* hStmtTile = nullptr;
     CPL_IGNORE_RET_VAL(
         sqlite3_prepare_v2( m_hDB,
-            "SELECT feature FROM temp "
-            "WHERE z = ? AND x = ? AND y = ? AND layer = ? ORDER BY idx",
-            -1, &hStmtRows, nullptr) );
-    if( hStmtRows == nullptr )
+            "SELECT layer, feature, area_or_length FROM temp "
+            "WHERE z = ? AND x = ? AND y = ? ORDER BY layer, idx",
+            -1, &hStmtTile, nullptr) );
+    if( hStmtTile == nullptr )
     {
         CPLError(CE_Failure, CPLE_AppDefined, "Prepared statement failed");
         sqlite3_finalize(hStmtZXY);
-        sqlite3_finalize(hStmtLayer);
         return false;
     }
 
@@ -5225,8 +5491,7 @@ bool OGRMVTWriterDataset::CreateOutput()
         {
             CPLError(CE_Failure, CPLE_AppDefined, "Prepared statement failed");
             sqlite3_finalize(hStmtZXY);
-            sqlite3_finalize(hStmtLayer);
-            sqlite3_finalize(hStmtRows);
+            sqlite3_finalize(hStmtTile);
             return false;
         }
     }
@@ -5236,19 +5501,71 @@ bool OGRMVTWriterDataset::CreateOutput()
     bool bRet = true;
     GIntBig nTempTilesRead = 0;
 
-    while( sqlite3_step(hStmtZXY) == SQLITE_ROW )
+    // Tiles are read from the temporary database by this thread, encoded
+    // by the worker threads, and written in order. The number of tiles in
+    // flight is bounded to limit memory usage.
+    const size_t nMaxJobsInFlight = m_bThreadPoolOK ?
+        static_cast<size_t>(2 * m_oThreadPool.GetThreadCount()) : 1;
+    std::deque<std::unique_ptr<MVTTileEncodingJob>> apoJobs;
+    bool bEOF = false;
+
+    while( true )
     {
-        int nZ = sqlite3_column_int(hStmtZXY, 0);
-        int nX = sqlite3_column_int(hStmtZXY, 1);
-        int nY = sqlite3_column_int(hStmtZXY, 2);
+        if( !bEOF && apoJobs.size() < nMaxJobsInFlight )
+        {
+            if( sqlite3_step(hStmtZXY) != SQLITE_ROW )
+            {
+                bEOF = true;
+                continue;
+            }
 
-        std::string oTileBuffer(
-            EncodeTile(nZ, nX, nY,
-                       hStmtLayer,
-                       hStmtRows,
-                       oMapLayerProps,
-                       oSetLayers,
-                       nTempTilesRead));
+            std::unique_ptr<MVTTileEncodingJob> poJob(
+                new MVTTileEncodingJob());
+            poJob->m_poDS = this;
+            poJob->m_nZ = sqlite3_column_int(hStmtZXY, 0);
+            poJob->m_nX = sqlite3_column_int(hStmtZXY, 1);
+            poJob->m_nY = sqlite3_column_int(hStmtZXY, 2);
+            if( !ReadTileFeatures(hStmtTile, *poJob, nTempTilesRead) )
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "Error while reading tile %d/%d/%d",
+                         poJob->m_nZ, poJob->m_nX, poJob->m_nY);
+                bRet = false;
+                break;
+            }
+            if( m_bThreadPoolOK )
+            {
+                m_oThreadPool.SubmitJob(EncodeTileFunc, poJob.get());
+            }
+            else
+            {
+                EncodeTile(*poJob);
+                poJob->m_bDone = true;
+            }
+            apoJobs.push_back(std::move(poJob));
+            continue;
+        }
+
+        if( apoJobs.empty() )
+            break;
+
+        MVTTileEncodingJob* poJob = apoJobs.front().get();
+        while( true )
+        {
+            {
+                std::lock_guard<std::mutex> oLock(m_oDBMutex);
+                if( poJob->m_bDone )
+                    break;
+            }
+            m_oThreadPool.WaitEvent();
+        }
+
+        MergeTileLayerProperties(*poJob, oMapLayerProps, oSetLayers);
+
+        const int nZ = poJob->m_nZ;
+        const int nX = poJob->m_nX;
+        const int nY = poJob->m_nY;
+        const std::string& oTileBuffer = poJob->m_osTileBuffer;
 
         if( oTileBuffer.empty() )
         {
@@ -5307,10 +5624,16 @@ bool OGRMVTWriterDataset::CreateOutput()
                      "Error while writing tile %d/%d/%d", nZ, nX, nY);
             break;
         }
+
+        apoJobs.pop_front();
     }
+    // In case of error, wait for the jobs still referencing apoJobs
+    if( m_bThreadPoolOK )
+        m_oThreadPool.WaitCompletion();
+    apoJobs.clear();
+
     sqlite3_finalize(hStmtZXY);
-    sqlite3_finalize(hStmtLayer);
-    sqlite3_finalize(hStmtRows);
+    sqlite3_finalize(hStmtTile);
     if( hInsertStmt )
         sqlite3_finalize(hInsertStmt);
 
@@ -56,6 +56,18 @@ public:
     virtual OGRErr RemoveEntry( OGRField *psKey, GIntBig nFID ) = 0;
 
     virtual OGRErr Clear() = 0;
+
+    // Optional range-oriented queries. The default implementations return
+    // nullptr, meaning that the index cannot answer them. When supported,
+    // the returned lists are sorted, OGRNullFID terminated and must be
+    // freed with CPLFree().
+    virtual bool      SupportsRangeQueries() const;
+    virtual GIntBig  *GetRangeMatches( const OGRField *psMin, bool bMinIncluded,
+                                       const OGRField *psMax, bool bMaxIncluded,
+                                       int *pnFIDCount );
+    virtual GIntBig  *GetPrefixMatches( const char *pszPrefix,
+                                        int *pnFIDCount );
+    virtual GIntBig  *GetNullMatches( int *pnFIDCount );
 };
 
 /************************************************************************/
@@ -90,6 +102,7 @@ public:
 };
 
 OGRLayerAttrIndex CPL_DLL *OGRCreateDefaultLayerIndex();
+OGRLayerAttrIndex CPL_DLL *OGRCreateBTreeLayerIndex();
 
 //! @endcond
 
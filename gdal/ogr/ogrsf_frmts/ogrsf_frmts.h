@@ -67,6 +67,10 @@ class OGRSFDriver;
 /* Note: any virtual method added to this class must also be added in the */
 /* OGRLayerDecorator and OGRMutexedLayer classes. */
 
+struct ArrowArrayStream;
+struct ArrowSchema;
+struct ArrowArray;
+
 class CPL_DLL OGRLayer : public GDALMajorObject
 {
   private:
@@ -103,12 +107,26 @@ class CPL_DLL OGRLayer : public GDALMajorObject
                                      // filter is active.
 
     int          FilterGeometry( OGRGeometry * );
+    int          FilterWKBGeometry( const GByte* pabyWKB, size_t nWKBSize );
+    int          FilterGeometryEnvelope( const OGREnvelope& sGeomEnv );
     //int          FilterGeometry( OGRGeometry *, OGREnvelope* psGeometryEnvelope);
     int          InstallFilter( OGRGeometry * );
 
     OGRErr       GetExtentInternal(int iGeomField, OGREnvelope *psExtent, int bForce );
+
+    static int StaticGetArrowSchema(struct ArrowArrayStream*,
+                                    struct ArrowSchema* out_schema);
+    static int StaticGetNextArrowArray(struct ArrowArrayStream*,
+                                       struct ArrowArray* out_array);
+
+    CPLStringList m_aosArrowArrayStreamOptions{};
 //! @endcond
 
+    virtual int GetArrowSchema(struct ArrowArrayStream*,
+                               struct ArrowSchema* out_schema);
+    virtual int GetNextArrowArray(struct ArrowArrayStream*,
+                                  struct ArrowArray* out_array);
+
     virtual OGRErr      ISetFeature( OGRFeature *poFeature ) CPL_WARN_UNUSED_RESULT;
     virtual OGRErr      ICreateFeature( OGRFeature *poFeature )  CPL_WARN_UNUSED_RESULT;
 
@@ -148,6 +166,12 @@ class CPL_DLL OGRLayer : public GDALMajorObject
     virtual OGRErr      SetNextByIndex( GIntBig nIndex );
     virtual OGRFeature *GetFeature( GIntBig nFID )  CPL_WARN_UNUSED_RESULT;
 
+    virtual bool        GetArrowStream(struct ArrowArrayStream* out_stream,
+                                       CSLConstList papszOptions = nullptr);
+    virtual bool        WriteArrowBatch(const struct ArrowSchema* schema,
+                                        const struct ArrowArray* array,
+                                        CSLConstList papszOptions = nullptr);
+
     OGRErr      SetFeature( OGRFeature *poFeature )  CPL_WARN_UNUSED_RESULT;
     OGRErr      CreateFeature( OGRFeature *poFeature ) CPL_WARN_UNUSED_RESULT;
 
@@ -192,6 +216,8 @@ class CPL_DLL OGRLayer : public GDALMajorObject
 
     virtual OGRErr      SetIgnoredFields( const char **papszFields );
 
+    virtual GIntBig     GetMemoryUsage();
+
     OGRErr              Intersection( OGRLayer *pLayerMethod,
                                       OGRLayer *pLayerResult,
                                       char** papszOptions = nullptr,
@@ -243,6 +269,7 @@ class CPL_DLL OGRLayer : public GDALMajorObject
 
     /* consider these private */
     OGRErr               InitializeIndexSupport( const char * );
+    OGRErr               InitializeBTreeIndexSupport( const char * );
     OGRLayerAttrIndex   *GetIndex() { return m_poAttrIndex; }
     int                 GetGeomFieldFilter() const { return m_iGeomFieldFilter; }
     const char          *GetAttrQueryString() const { return m_pszAttrQueryString; }
@@ -252,6 +252,21 @@ class FileGDBIndexIterator final : public FileGDBIndexIteratorBase
         int                  nStrLen = 0;
         char                 szUUID[UUID_LEN_AS_STRING + 1];
 
+        /* Optional second bound of a range, checked once eOp matches */
+        FileGDBSQLOp         eEndOp = FGSO_ISNOTNULL;
+        OGRField             sEndValue;
+        GUInt16              asEndUTF16Str[MAX_CAR_COUNT_STR];
+        char                 szEndUUID[UUID_LEN_AS_STRING + 1];
+
+        int                  SetValue(OGRFieldType eOGRFieldType,
+                                      const OGRField* psSrcValue,
+                                      OGRField& sDstValue,
+                                      GUInt16* pasDstUTF16Str,
+                                      char* pszDstUUID);
+        int                  CompareCurrentValue(const OGRField& sRefValue,
+                                                 const GUInt16* pasRefUTF16Str,
+                                                 const char* pszRefUUID);
+
         OGRField             sMin, sMax;
         char                 szMin[MAX_UTF8_LEN_STR+1];
         char                 szMax[MAX_UTF8_LEN_STR+1];
@@ -267,6 +282,9 @@ class FileGDBIndexIterator final : public FileGDBIndexIteratorBase
         int                  SetConstraint(int nFieldIdx, FileGDBSQLOp op,
                                            OGRFieldType eOGRFieldType,
                                            const OGRField* psValue);
+        int                  SetEndConstraint(FileGDBSQLOp op,
+                                              OGRFieldType eOGRFieldType,
+                                              const OGRField* psValue);
 
         template <class Getter> void GetMinMaxSumCount(
                                                   double& dfMin, double& dfMax,
@@ -280,6 +298,14 @@ class FileGDBIndexIterator final : public FileGDBIndexIteratorBase
                                            FileGDBSQLOp op,
                                            OGRFieldType eOGRFieldType,
                                            const OGRField* psValue);
+        static FileGDBIterator*      BuildRange(FileGDBTable* poParent,
+                                                int nFieldIdx,
+                                                int bAscending,
+                                                FileGDBSQLOp eLowerOp,
+                                                const OGRField* psLowerValue,
+                                                FileGDBSQLOp eUpperOp,
+                                                const OGRField* psUpperValue,
+                                                OGRFieldType eOGRFieldType);
 
         virtual int                  GetNextRowSortedByFID() override;
         virtual int                  GetRowCount() override;
@@ -355,6 +381,25 @@ FileGDBIterator* FileGDBIterator::Build(FileGDBTable* poParent,
                                        op, eOGRFieldType, psValue);
 }
 
+/************************************************************************/
+/*                            BuildRange()                              */
+/************************************************************************/
+
+FileGDBIterator* FileGDBIterator::BuildRange(FileGDBTable* poParent,
+                                             int nFieldIdx,
+                                             int bAscending,
+                                             FileGDBSQLOp eLowerOp,
+                                             const OGRField* psLowerValue,
+                                             FileGDBSQLOp eUpperOp,
+                                             const OGRField* psUpperValue,
+                                             OGRFieldType eOGRFieldType)
+{
+    return FileGDBIndexIterator::BuildRange(poParent, nFieldIdx, bAscending,
+                                            eLowerOp, psLowerValue,
+                                            eUpperOp, psUpperValue,
+                                            eOGRFieldType);
+}
+
 /************************************************************************/
 /*                           BuildIsNotNull()                           */
 /************************************************************************/
@@ -771,6 +816,39 @@ FileGDBIterator* FileGDBIndexIterator::Build( FileGDBTable* poParent,
     return nullptr;
 }
 
+/************************************************************************/
+/*                            BuildRange()                              */
+/************************************************************************/
+
+FileGDBIterator* FileGDBIndexIterator::BuildRange( FileGDBTable* poParent,
+                                                   int nFieldIdx,
+                                                   int bAscending,
+                                                   FileGDBSQLOp eLowerOp,
+                                                   const OGRField* psLowerValue,
+                                                   FileGDBSQLOp eUpperOp,
+                                                   const OGRField* psUpperValue,
+                                                   OGRFieldType eOGRFieldType )
+{
+    CPLAssert(eLowerOp == FGSO_GE || eLowerOp == FGSO_GT);
+    CPLAssert(eUpperOp == FGSO_LE || eUpperOp == FGSO_LT);
+
+    /* The bound from which the iteration starts is used to locate the */
+    /* first page, and the other one to stop the iteration */
+    FileGDBIndexIterator* poIndexIterator =
+                new FileGDBIndexIterator(poParent, bAscending);
+    const bool bOK = bAscending ?
+        poIndexIterator->SetConstraint(nFieldIdx, eLowerOp, eOGRFieldType, psLowerValue) &&
+        poIndexIterator->SetEndConstraint(eUpperOp, eOGRFieldType, psUpperValue) :
+        poIndexIterator->SetConstraint(nFieldIdx, eUpperOp, eOGRFieldType, psUpperValue) &&
+        poIndexIterator->SetEndConstraint(eLowerOp, eOGRFieldType, psLowerValue);
+    if( bOK )
+    {
+        return poIndexIterator;
+    }
+    delete poIndexIterator;
+    return nullptr;
+}
+
 /************************************************************************/
 /*                           FileGDBSQLOpToStr()                        */
 /************************************************************************/
@@ -896,35 +974,15 @@ int FileGDBIndexIterator::SetConstraint(int nFieldIdx,
     {
         case FGFT_INT16:
             returnErrorIf(abyTrailer[0] != sizeof(GUInt16));
-            if( eOp != FGSO_ISNOTNULL )
-            {
-                returnErrorIf(eOGRFieldType != OFTInteger);
-                sValue.Integer = psValue->Integer;
-            }
             break;
         case FGFT_INT32:
             returnErrorIf(abyTrailer[0] != sizeof(GUInt32));
-            if( eOp != FGSO_ISNOTNULL )
-            {
-                returnErrorIf(eOGRFieldType != OFTInteger);
-                sValue.Integer = psValue->Integer;
-            }
             break;
         case FGFT_FLOAT32:
             returnErrorIf(abyTrailer[0] != sizeof(float));
-            if( eOp != FGSO_ISNOTNULL )
-            {
-                returnErrorIf(eOGRFieldType != OFTReal);
-                sValue.Real = psValue->Real;
-            }
             break;
         case FGFT_FLOAT64:
             returnErrorIf(abyTrailer[0] != sizeof(double));
-            if( eOp != FGSO_ISNOTNULL )
-            {
-                returnErrorIf(eOGRFieldType != OFTReal);
-                sValue.Real = psValue->Real;
-            }
             break;
         case FGFT_STRING:
         {
@@ -932,44 +990,12 @@ int FileGDBIndexIterator::SetConstraint(int nFieldIdx,
             returnErrorIf(abyTrailer[0] == 0);
             returnErrorIf(abyTrailer[0] > 2 * MAX_CAR_COUNT_STR);
             nStrLen = abyTrailer[0] / 2;
-            if( eOp != FGSO_ISNOTNULL )
-            {
-                returnErrorIf(eOGRFieldType != OFTString);
-                wchar_t *pWide = CPLRecodeToWChar( psValue->String,
-                                                CPL_ENC_UTF8,
-                                                CPL_ENC_UCS2 );
-                returnErrorIf(pWide == nullptr);
-                int nCount = 0;
-                while( pWide[nCount] != 0 )
-                {
-                    returnErrorAndCleanupIf(nCount == nStrLen, CPLFree(pWide));
-                    asUTF16Str[nCount] = pWide[nCount];
-                    nCount ++;
-                }
-                while( nCount < nStrLen )
-                {
-                    asUTF16Str[nCount] = 32; /* space character */
-                    nCount ++;
-                }
-                CPLFree(pWide);
-            }
             break;
         }
 
         case FGFT_DATETIME:
         {
             returnErrorIf( abyTrailer[0] != sizeof(double));
-            if( eOp != FGSO_ISNOTNULL )
-            {
-                returnErrorIf(eOGRFieldType != OFTReal &&
-                              eOGRFieldType != OFTDateTime &&
-                              eOGRFieldType != OFTDate &&
-                              eOGRFieldType != OFTTime);
-                if( eOGRFieldType == OFTReal )
-                    sValue.Real = psValue->Real;
-                else
-                    FileGDBOGRDateToDoubleDate(psValue, &(sValue.Real));
-            }
             break;
         }
 
@@ -977,17 +1003,6 @@ int FileGDBIndexIterator::SetConstraint(int nFieldIdx,
         case FGFT_UUID_2:
         {
             returnErrorIf(abyTrailer[0] != UUID_LEN_AS_STRING);
-            if( eOp != FGSO_ISNOTNULL )
-            {
-                returnErrorIf(eOGRFieldType != OFTString);
-                memset(szUUID, 0, UUID_LEN_AS_STRING + 1);
-                // cppcheck-suppress redundantCopy
-                strncpy(szUUID, psValue->String, UUID_LEN_AS_STRING);
-                bEvaluateToFALSE =
-                    eOp == FGSO_EQ &&
-                    strlen(psValue->String) !=
-                    static_cast<size_t>(UUID_LEN_AS_STRING);
-            }
             break;
         }
 
@@ -996,6 +1011,19 @@ int FileGDBIndexIterator::SetConstraint(int nFieldIdx,
             break;
     }
 
+    if( eOp != FGSO_ISNOTNULL )
+    {
+        returnErrorIf(!SetValue(eOGRFieldType, psValue,
+                                sValue, asUTF16Str, szUUID));
+        if( eFieldType == FGFT_UUID_1 || eFieldType == FGFT_UUID_2 )
+        {
+            bEvaluateToFALSE =
+                eOp == FGSO_EQ &&
+                strlen(psValue->String) !=
+                static_cast<size_t>(UUID_LEN_AS_STRING);
+        }
+    }
+
     if( nValueCountInIdx > 0 )
     {
         if( nIndexDepth == 1 )
@@ -1018,6 +1046,111 @@ int FileGDBIndexIterator::SetConstraint(int nFieldIdx,
     return TRUE;
 }
 
+/************************************************************************/
+/*                              SetValue()                              */
+/************************************************************************/
+
+/* Converts a value to the representation used in the index */
+int FileGDBIndexIterator::SetValue(OGRFieldType eOGRFieldType,
+                                   const OGRField* psSrcValue,
+                                   OGRField& sDstValue,
+                                   GUInt16* pasDstUTF16Str,
+                                   char* pszDstUUID)
+{
+    const int errorRetValue = FALSE;
+    switch( eFieldType )
+    {
+        case FGFT_INT16:
+        case FGFT_INT32:
+            returnErrorIf(eOGRFieldType != OFTInteger);
+            sDstValue.Integer = psSrcValue->Integer;
+            break;
+
+        case FGFT_FLOAT32:
+        case FGFT_FLOAT64:
+            returnErrorIf(eOGRFieldType != OFTReal);
+            sDstValue.Real = psSrcValue->Real;
+            break;
+
+        case FGFT_STRING:
+        {
+            returnErrorIf(eOGRFieldType != OFTString);
+            wchar_t *pWide = CPLRecodeToWChar( psSrcValue->String,
+                                            CPL_ENC_UTF8,
+                                            CPL_ENC_UCS2 );
+            returnErrorIf(pWide == nullptr);
+            int nCount = 0;
+            while( pWide[nCount] != 0 )
+            {
+                returnErrorAndCleanupIf(nCount == nStrLen, CPLFree(pWide));
+                pasDstUTF16Str[nCount] = pWide[nCount];
+                nCount ++;
+            }
+            while( nCount < nStrLen )
+            {
+                pasDstUTF16Str[nCount] = 32; /* space character */
+                nCount ++;
+            }
+            CPLFree(pWide);
+            break;
+        }
+
+        case FGFT_DATETIME:
+        {
+            returnErrorIf(eOGRFieldType != OFTReal &&
+                          eOGRFieldType != OFTDateTime &&
+                          eOGRFieldType != OFTDate &&
+                          eOGRFieldType != OFTTime);
+            if( eOGRFieldType == OFTReal )
+                sDstValue.Real = psSrcValue->Real;
+            else
+                FileGDBOGRDateToDoubleDate(psSrcValue, &(sDstValue.Real));
+            break;
+        }
+
+        case FGFT_UUID_1:
+        case FGFT_UUID_2:
+        {
+            returnErrorIf(eOGRFieldType != OFTString);
+            memset(pszDstUUID, 0, UUID_LEN_AS_STRING + 1);
+            // cppcheck-suppress redundantCopy
+            strncpy(pszDstUUID, psSrcValue->String, UUID_LEN_AS_STRING);
+            break;
+        }
+
+        default:
+            CPLAssert(false);
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                          SetEndConstraint()                          */
+/************************************************************************/
+
+/* Must be called after SetConstraint(). With a range, the iteration is */
+/* stopped as soon as the end bound is no longer satisfied. */
+int FileGDBIndexIterator::SetEndConstraint(FileGDBSQLOp op,
+                                           OGRFieldType eOGRFieldType,
+                                           const OGRField* psValue)
+{
+    const int errorRetValue = FALSE;
+    returnErrorIf(eOp == FGSO_ISNOTNULL || eOp == FGSO_EQ);
+    returnErrorIf(op == FGSO_ISNOTNULL || op == FGSO_EQ);
+    returnErrorIf(!SetValue(eOGRFieldType, psValue,
+                            sEndValue, asEndUTF16Str, szEndUUID));
+    eEndOp = op;
+
+    CPLDebug("OpenFileGDB", "Using index range end (%s %s)",
+            FileGDBSQLOpToStr(eEndOp),
+            FileGDBValueToStr(eOGRFieldType, psValue));
+
+    Reset();
+
+    return TRUE;
+}
+
 /************************************************************************/
 /*                          FileGDBUTF16StrCompare()                    */
 /************************************************************************/
@@ -1393,6 +1526,83 @@ int FileGDBIndexIteratorBase::LoadNextFeaturePage()
     return TRUE;
 }
 
+/************************************************************************/
+/*                        CompareCurrentValue()                         */
+/************************************************************************/
+
+/* Compares a reference value with the one of the current feature in */
+/* abyPageFeature: negative if the reference value is lower, 0 if equal, */
+/* positive if greater. */
+int FileGDBIndexIterator::CompareCurrentValue(const OGRField& sRefValue,
+                                              const GUInt16* pasRefUTF16Str,
+                                              const char* pszRefUUID)
+{
+    switch( eFieldType )
+    {
+        case FGFT_INT16:
+        {
+            const GInt16 nVal =
+                GetInt16(abyPageFeature + nOffsetFirstValInPage,
+                         iCurFeatureInPage);
+            return COMPARE(sRefValue.Integer, nVal);
+        }
+
+        case FGFT_INT32:
+        {
+            const GInt32 nVal =
+                GetInt32(abyPageFeature + nOffsetFirstValInPage,
+                         iCurFeatureInPage);
+            return COMPARE(sRefValue.Integer, nVal);
+        }
+
+        case FGFT_FLOAT32:
+        {
+            const float fVal =
+                GetFloat32(abyPageFeature + nOffsetFirstValInPage,
+                           iCurFeatureInPage);
+            return COMPARE(sRefValue.Real, fVal);
+        }
+
+        case FGFT_FLOAT64:
+        case FGFT_DATETIME:
+        {
+            const double dfVal =
+                GetFloat64(abyPageFeature + nOffsetFirstValInPage,
+                           iCurFeatureInPage);
+            return COMPARE(sRefValue.Real, dfVal);
+        }
+
+        case FGFT_STRING:
+        {
+#if defined(CPL_MSB) || defined(CPL_CPU_REQUIRES_ALIGNED_ACCESS)
+            GUInt16 asVal[MAX_CAR_COUNT_STR];
+            memcpy(asVal, abyPageFeature + nOffsetFirstValInPage +
+                            nStrLen * 2 * iCurFeatureInPage, nStrLen * 2);
+            for(int j=0;j<nStrLen;j++)
+                CPL_LSBPTR16(&asVal[j]);
+            return FileGDBUTF16StrCompare(pasRefUTF16Str, asVal, nStrLen);
+#else
+            return FileGDBUTF16StrCompare(pasRefUTF16Str,
+                        (GUInt16*)(abyPageFeature + nOffsetFirstValInPage +
+                            nStrLen * 2 * iCurFeatureInPage), nStrLen);
+#endif
+        }
+
+        case FGFT_UUID_1:
+        case FGFT_UUID_2:
+        {
+            return memcmp(pszRefUUID,
+                        abyPageFeature + nOffsetFirstValInPage +
+                        UUID_LEN_AS_STRING *iCurFeatureInPage,
+                        UUID_LEN_AS_STRING);
+        }
+
+        default:
+            CPLAssert(false);
+            return 0;
+    }
+}
+
 /************************************************************************/
 /*                              GetNextRow()                            */
 /************************************************************************/
@@ -1421,81 +1631,8 @@ int FileGDBIndexIterator::GetNextRow()
         }
         else
         {
-            int nComp = 0;
-            switch( eFieldType )
-            {
-                case FGFT_INT16:
-                {
-                    const GInt16 nVal =
-                        GetInt16(abyPageFeature + nOffsetFirstValInPage,
-                                 iCurFeatureInPage);
-                    nComp = COMPARE(sValue.Integer, nVal);
-                    break;
-                }
-
-                case FGFT_INT32:
-                {
-                    const GInt32 nVal =
-                        GetInt32(abyPageFeature + nOffsetFirstValInPage,
-                                 iCurFeatureInPage);
-                    nComp = COMPARE(sValue.Integer, nVal);
-                    break;
-                }
-
-                case FGFT_FLOAT32:
-                {
-                    const float fVal =
-                        GetFloat32(abyPageFeature + nOffsetFirstValInPage,
-                                   iCurFeatureInPage);
-                    nComp = COMPARE(sValue.Real, fVal);
-                    break;
-                }
-
-                case FGFT_FLOAT64:
-                case FGFT_DATETIME:
-                {
-                    const double dfVal =
-                        GetFloat64(abyPageFeature + nOffsetFirstValInPage,
-                                   iCurFeatureInPage);
-                    nComp = COMPARE(sValue.Real, dfVal);
-                    break;
-                }
-
-                case FGFT_STRING:
-                {
-#if defined(CPL_MSB) || defined(CPL_CPU_REQUIRES_ALIGNED_ACCESS)
-                    GUInt16 asVal[MAX_CAR_COUNT_STR];
-                    memcpy(asVal, abyPageFeature + nOffsetFirstValInPage +
-                                    nStrLen * 2 * iCurFeatureInPage, nStrLen * 2);
-                    for(int j=0;j<nStrLen;j++)
-                        CPL_LSBPTR16(&asVal[j]);
-                    nComp = FileGDBUTF16StrCompare(asUTF16Str, asVal, nStrLen);
-#else
-                    nComp = FileGDBUTF16StrCompare(asUTF16Str,
-                                (GUInt16*)(abyPageFeature + nOffsetFirstValInPage +
-                                    nStrLen * 2 * iCurFeatureInPage), nStrLen);
-#endif
-                    break;
-                }
-
-                case FGFT_UUID_1:
-                case FGFT_UUID_2:
-                {
-                    nComp = memcmp(szUUID,
-                                abyPageFeature + nOffsetFirstValInPage +
-                                UUID_LEN_AS_STRING *iCurFeatureInPage,
-                                UUID_LEN_AS_STRING);
-                    break;
-                }
-
-                default:
-                    CPLAssert(false);
-                    nComp = 0;
-                    break;
-            }
+            const int nComp = CompareCurrentValue(sValue, asUTF16Str, szUUID);
 
-            bMatch = false;
-            CPL_IGNORE_RET_VAL(bMatch);
             switch( eOp )
             {
                 case FGSO_LT:
@@ -1504,7 +1641,7 @@ int FileGDBIndexIterator::GetNextRow()
                         bEOF = true;
                         return -1;
                     }
-                    bMatch = true;
+                    bMatch = nComp > 0;
                     break;
 
                 case FGSO_LE:
@@ -1513,11 +1650,12 @@ int FileGDBIndexIterator::GetNextRow()
                         bEOF = true;
                         return -1;
                     }
-                    bMatch = true;
+                    bMatch = nComp >= 0;
                     break;
 
                 case FGSO_EQ:
-                    if( nComp < 0 && bAscending )
+                    if( (nComp < 0 && bAscending) ||
+                        (nComp > 0 && !bAscending) )
                     {
                         bEOF = true;
                         return -1;
@@ -1526,10 +1664,20 @@ int FileGDBIndexIterator::GetNextRow()
                     break;
 
                 case FGSO_GE:
+                    if( nComp > 0 && !bAscending )
+                    {
+                        bEOF = true;
+                        return -1;
+                    }
                     bMatch = nComp <= 0;
                     break;
 
                 case FGSO_GT:
+                    if( nComp >= 0 && !bAscending )
+                    {
+                        bEOF = true;
+                        return -1;
+                    }
                     bMatch = nComp < 0;
                     break;
 
@@ -1539,6 +1687,33 @@ int FileGDBIndexIterator::GetNextRow()
             }
         }
 
+        /* Stop as soon as we are past the end of the range, in the */
+        /* iteration order. */
+        if( bMatch && eEndOp != FGSO_ISNOTNULL )
+        {
+            const int nCompEnd =
+                CompareCurrentValue(sEndValue, asEndUTF16Str, szEndUUID);
+            bool bInRange = false;
+            switch( eEndOp )
+            {
+                case FGSO_LT: bInRange = nCompEnd > 0; break;
+                case FGSO_LE: bInRange = nCompEnd >= 0; break;
+                case FGSO_GE: bInRange = nCompEnd <= 0; break;
+                case FGSO_GT: bInRange = nCompEnd < 0; break;
+                default: CPLAssert(false); break;
+            }
+            if( !bInRange )
+            {
+                const bool bUpperEnd = eEndOp == FGSO_LT || eEndOp == FGSO_LE;
+                if( bUpperEnd == bAscending )
+                {
+                    bEOF = true;
+                    return -1;
+                }
+                bMatch = false;
+            }
+        }
+
         if( bMatch )
         {
             const GUInt32 nFID =
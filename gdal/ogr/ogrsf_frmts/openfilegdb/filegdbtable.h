@@ -377,6 +377,14 @@ class FileGDBIterator
                                            FileGDBSQLOp op,
                                            OGRFieldType eOGRFieldType,
                                            const OGRField* psValue);
+        static FileGDBIterator*      BuildRange(FileGDBTable* poParent,
+                                                int nFieldIdx,
+                                                int bAscending,
+                                                FileGDBSQLOp eLowerOp,
+                                                const OGRField* psLowerValue,
+                                                FileGDBSQLOp eUpperOp,
+                                                const OGRField* psUpperValue,
+                                                OGRFieldType eOGRFieldType);
         static FileGDBIterator*      BuildIsNotNull(FileGDBTable* poParent,
                                                     int nFieldIdx,
                                                     int bAscending);
@@ -126,6 +126,12 @@ public:
                                    int bAscending,
                                    int op,
                                    swq_expr_node* poValue);
+  FileGDBIterator*      BuildRangeIndex(const char* pszFieldName,
+                                        int bAscending,
+                                        int opLower,
+                                        swq_expr_node* poLowerValue,
+                                        int opUpper,
+                                        swq_expr_node* poUpperValue);
   SPIState              GetSpatialIndexState() const { return m_eSpatialIndexState; }
   int                   IsValidLayerDefn() { return BuildLayerDefinition(); }
 
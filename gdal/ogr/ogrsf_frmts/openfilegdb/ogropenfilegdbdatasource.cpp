@@ -1026,6 +1026,35 @@ int OGROpenFileGDBSimpleSQLLayer::TestCapability( const char * pszCap )
     return FALSE;
 }
 
+/***********************************************************************/
+/*                            IsColumnNode()                           */
+/***********************************************************************/
+
+/* At that stage, the expression has not been bound to the layer, so */
+/* column references may still appear as constants holding their name */
+static bool IsColumnNode(const swq_expr_node* poNode, const char* pszFieldName)
+{
+    return (poNode->eNodeType == SNT_COLUMN ||
+            poNode->eNodeType == SNT_CONSTANT) &&
+           poNode->field_type == SWQ_STRING &&
+           EQUAL(poNode->string_value, pszFieldName);
+}
+
+/***********************************************************************/
+/*                     IsSimpleComparisonOnColumn()                    */
+/***********************************************************************/
+
+static bool IsSimpleComparisonOnColumn(const swq_expr_node* poNode,
+                                       const char* pszFieldName)
+{
+    return poNode->eNodeType == SNT_OPERATION &&
+           OGROpenFileGDBIsComparisonOp(poNode->nOperation) &&
+           poNode->nOperation != SWQ_NE &&
+           poNode->nSubExprCount == 2 &&
+           IsColumnNode(poNode->papoSubExpr[0], pszFieldName) &&
+           poNode->papoSubExpr[1]->eNodeType == SNT_CONSTANT;
+}
+
 /***********************************************************************/
 /*                            ExecuteSQL()                             */
 /***********************************************************************/
@@ -1281,22 +1310,59 @@ OGRLayer* OGROpenFileGDBDataSource::ExecuteSQL( const char *pszSQLCommand,
                 poLayer->HasIndexForField(oSelect.order_defs[0].field_name) )
             {
                 OGRErr eErr = OGRERR_NONE;
-                if( oSelect.where_expr != nullptr )
+                const char* pszOrderField = oSelect.order_defs[0].field_name;
+                int op = -1;
+                swq_expr_node* poValue = nullptr;
+                int opUpper = -1;
+                swq_expr_node* poUpperValue = nullptr;
+                swq_expr_node* poWhere = oSelect.where_expr;
+                if( poWhere != nullptr )
                 {
                     /* The where must be a simple comparison on the column */
-                    /* that is used for ordering */
-                    if( oSelect.where_expr->eNodeType == SNT_OPERATION &&
-                        OGROpenFileGDBIsComparisonOp(oSelect.where_expr->nOperation) &&
-                        oSelect.where_expr->nOperation != SWQ_NE &&
-                        oSelect.where_expr->nSubExprCount == 2 &&
-                        (oSelect.where_expr->papoSubExpr[0]->eNodeType == SNT_COLUMN ||
-                         oSelect.where_expr->papoSubExpr[0]->eNodeType == SNT_CONSTANT) &&
-                        oSelect.where_expr->papoSubExpr[0]->field_type == SWQ_STRING &&
-                        EQUAL(oSelect.where_expr->papoSubExpr[0]->string_value,
-                              oSelect.order_defs[0].field_name) &&
-                        oSelect.where_expr->papoSubExpr[1]->eNodeType == SNT_CONSTANT )
+                    /* that is used for ordering, or a range on it */
+                    if( IsSimpleComparisonOnColumn(poWhere, pszOrderField) )
+                    {
+                        op = poWhere->nOperation;
+                        poValue = poWhere->papoSubExpr[1];
+                    }
+                    else if( poWhere->eNodeType == SNT_OPERATION &&
+                             poWhere->nOperation == SWQ_BETWEEN &&
+                             poWhere->nSubExprCount == 3 &&
+                             IsColumnNode(poWhere->papoSubExpr[0], pszOrderField) &&
+                             poWhere->papoSubExpr[1]->eNodeType == SNT_CONSTANT &&
+                             poWhere->papoSubExpr[2]->eNodeType == SNT_CONSTANT )
                     {
-                        /* ok */
+                        op = SWQ_GE;
+                        poValue = poWhere->papoSubExpr[1];
+                        opUpper = SWQ_LE;
+                        poUpperValue = poWhere->papoSubExpr[2];
+                    }
+                    else if( poWhere->eNodeType == SNT_OPERATION &&
+                             poWhere->nOperation == SWQ_AND &&
+                             poWhere->nSubExprCount == 2 &&
+                             IsSimpleComparisonOnColumn(poWhere->papoSubExpr[0],
+                                                        pszOrderField) &&
+                             IsSimpleComparisonOnColumn(poWhere->papoSubExpr[1],
+                                                        pszOrderField) )
+                    {
+                        for( int i = 0; i < 2; i++ )
+                        {
+                            swq_expr_node* poSubExpr = poWhere->papoSubExpr[i];
+                            if( poSubExpr->nOperation == SWQ_GE ||
+                                poSubExpr->nOperation == SWQ_GT )
+                            {
+                                op = poSubExpr->nOperation;
+                                poValue = poSubExpr->papoSubExpr[1];
+                            }
+                            else if( poSubExpr->nOperation == SWQ_LE ||
+                                     poSubExpr->nOperation == SWQ_LT )
+                            {
+                                opUpper = poSubExpr->nOperation;
+                                poUpperValue = poSubExpr->papoSubExpr[1];
+                            }
+                        }
+                        if( op < 0 || opUpper < 0 )
+                            eErr = OGRERR_FAILURE;
                     }
                     else
                         eErr = OGRERR_FAILURE;
@@ -1324,16 +1390,13 @@ OGRLayer* OGROpenFileGDBDataSource::ExecuteSQL( const char *pszSQLCommand,
                 }
                 if( eErr == OGRERR_NONE )
                 {
-                    int op = -1;
-                    swq_expr_node* poValue = nullptr;
-                    if( oSelect.where_expr != nullptr )
-                    {
-                        op = oSelect.where_expr->nOperation;
-                        poValue = oSelect.where_expr->papoSubExpr[1];
-                    }
-
-                    FileGDBIterator *poIter = poLayer->BuildIndex(
-                                    oSelect.order_defs[0].field_name,
+                    FileGDBIterator *poIter = (opUpper >= 0) ?
+                        poLayer->BuildRangeIndex(
+                                    pszOrderField,
+                                    oSelect.order_defs[0].ascending_flag,
+                                    op, poValue, opUpper, poUpperValue) :
+                        poLayer->BuildIndex(
+                                    pszOrderField,
                                     oSelect.order_defs[0].ascending_flag,
                                     op, poValue);
 
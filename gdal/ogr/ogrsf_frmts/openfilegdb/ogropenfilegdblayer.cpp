@@ -36,6 +36,7 @@
 #include <cstring>
 #include <algorithm>
 #include <string>
+#include <utility>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -1215,6 +1216,42 @@ static swq_expr_node* GetConstantSubNode(swq_expr_node* poNode)
     }
     return nullptr;
 }
+
+/***********************************************************************/
+/*                          GetRangeBound()                            */
+/***********************************************************************/
+
+/* Recognizes "column op constant" or "constant op column" with op one of */
+/* <, <=, >, >=, and returns the operator as if the column was on the */
+/* left side. */
+static bool GetRangeBound(swq_expr_node* poNode,
+                          swq_expr_node*& poColumn,
+                          int& op,
+                          swq_expr_node*& poValue)
+{
+    if( poNode->eNodeType != SNT_OPERATION ||
+        (poNode->nOperation != SWQ_LT && poNode->nOperation != SWQ_LE &&
+         poNode->nOperation != SWQ_GT && poNode->nOperation != SWQ_GE) )
+        return false;
+    poColumn = GetColumnSubNode(poNode);
+    poValue = GetConstantSubNode(poNode);
+    if( poColumn == nullptr || poValue == nullptr )
+        return false;
+    op = poNode->nOperation;
+    if( poColumn != poNode->papoSubExpr[0] )
+    {
+        switch( op )
+        {
+            case SWQ_LE: op = SWQ_GE; break;
+            case SWQ_LT: op = SWQ_GT; break;
+            case SWQ_GE: op = SWQ_LE; break;
+            case SWQ_GT: op = SWQ_LT; break;
+            default: CPLAssert(false); break;
+        }
+    }
+    return true;
+}
+
 /***********************************************************************/
 /*                     BuildIteratorFromExprNode()                     */
 /***********************************************************************/
@@ -1224,6 +1261,38 @@ FileGDBIterator* OGROpenFileGDBLayer::BuildIteratorFromExprNode(swq_expr_node* p
     if( m_bIteratorSufficientToEvaluateFilter == FALSE )
         return nullptr;
 
+    swq_expr_node* poColumn1 = nullptr;
+    swq_expr_node* poColumn2 = nullptr;
+    swq_expr_node* poValue1 = nullptr;
+    swq_expr_node* poValue2 = nullptr;
+    int op1 = 0;
+    int op2 = 0;
+    if( poNode->eNodeType == SNT_OPERATION &&
+        poNode->nOperation == SWQ_AND && poNode->nSubExprCount == 2 &&
+        GetRangeBound(poNode->papoSubExpr[0], poColumn1, op1, poValue1) &&
+        GetRangeBound(poNode->papoSubExpr[1], poColumn2, op2, poValue2) &&
+        poColumn1->field_index == poColumn2->field_index &&
+        poColumn1->field_index < GetLayerDefn()->GetFieldCount() &&
+        (op1 == SWQ_GE || op1 == SWQ_GT) != (op2 == SWQ_GE || op2 == SWQ_GT) )
+    {
+        /* "column >[=] a AND column <[=] b" (and BETWEEN, that has been */
+        /* rewritten as such): scan the index only once */
+        if( op1 == SWQ_LE || op1 == SWQ_LT )
+        {
+            std::swap(op1, op2);
+            std::swap(poValue1, poValue2);
+        }
+        OGRFieldDefn *poFieldDefn =
+            GetLayerDefn()->GetFieldDefn(poColumn1->field_index);
+        FileGDBIterator* poIter = BuildRangeIndex(
+            poFieldDefn->GetNameRef(), TRUE, op1, poValue1, op2, poValue2);
+        if( poIter != nullptr )
+        {
+            m_bIteratorSufficientToEvaluateFilter = TRUE;
+            return poIter;
+        }
+    }
+
     if( poNode->eNodeType == SNT_OPERATION &&
         poNode->nOperation == SWQ_AND && poNode->nSubExprCount == 2 )
     {
@@ -2075,6 +2144,50 @@ FileGDBIterator* OGROpenFileGDBLayer::BuildIndex(const char* pszFieldName,
     return nullptr;
 }
 
+/***********************************************************************/
+/*                          BuildRangeIndex()                          */
+/***********************************************************************/
+
+/* Builds an iterator on the values of pszFieldName that are within */
+/* [poLowerValue, poUpperValue] (opLower must be SWQ_GE or SWQ_GT, and */
+/* opUpper SWQ_LE or SWQ_LT), using a single traversal of the index. */
+FileGDBIterator* OGROpenFileGDBLayer::BuildRangeIndex(const char* pszFieldName,
+                                                      int bAscending,
+                                                      int opLower,
+                                                      swq_expr_node* poLowerValue,
+                                                      int opUpper,
+                                                      swq_expr_node* poUpperValue)
+{
+    if( !BuildLayerDefinition() )
+        return nullptr;
+
+    int idx = GetLayerDefn()->GetFieldIndex(pszFieldName);
+    if( idx < 0 )
+        return nullptr;
+    OGRFieldDefn* poFieldDefn = GetLayerDefn()->GetFieldDefn(idx);
+
+    int nTableColIdx = m_poLyrTable->GetFieldIdx(pszFieldName);
+    if( nTableColIdx >= 0 && m_poLyrTable->GetField(nTableColIdx)->HasIndex() )
+    {
+        if( (opLower != SWQ_GE && opLower != SWQ_GT) ||
+            (opUpper != SWQ_LE && opUpper != SWQ_LT) )
+            return nullptr;
+
+        OGRField sLowerValue;
+        OGRField sUpperValue;
+        if( FillTargetValueFromSrcExpr(poFieldDefn, &sLowerValue, poLowerValue) &&
+            FillTargetValueFromSrcExpr(poFieldDefn, &sUpperValue, poUpperValue) )
+        {
+            return FileGDBIterator::BuildRange(
+                            m_poLyrTable, nTableColIdx, bAscending,
+                            (opLower == SWQ_GE) ? FGSO_GE : FGSO_GT, &sLowerValue,
+                            (opUpper == SWQ_LE) ? FGSO_LE : FGSO_LT, &sUpperValue,
+                            poFieldDefn->GetType());
+        }
+    }
+    return nullptr;
+}
+
 /***********************************************************************/
 /*                          GetMinMaxValue()                           */
 /***********************************************************************/
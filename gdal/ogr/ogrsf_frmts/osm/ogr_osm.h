@@ -35,6 +35,7 @@
 
 #include "ogrsf_frmts.h"
 #include "cpl_string.h"
+#include "cpl_virtualmem.h"
 
 #include <array>
 #include <set>
@@ -330,6 +331,11 @@ class OGROSMDataSource final: public OGRDataSource
 
     std::vector<LonLat> m_asLonLatCache{};
 
+    // Number of threads used to resolve the nodes of ways
+    int                 m_nWayThreads = 1;
+    // Resolved coordinates of each way of the current batch
+    std::vector<std::vector<LonLat>> m_aasWayLonLats{};
+
     std::array<const char*, 7>  m_ignoredKeys;
 
     bool                bReportAllNodes;
@@ -363,6 +369,15 @@ class OGROSMDataSource final: public OGRDataSource
     bool                bCustomIndexing;
     bool                bCompressNodes;
 
+    // Dense node index: flat array of LonLat indexed by node id, in a sparse
+    // temporary file that is memory-mapped when possible.
+    bool                m_bDenseNodesIndex = false;
+    CPLVirtualMem      *m_psDenseNodesMapping = nullptr;
+    // Size in bytes of m_psDenseNodesMapping, or of the file written without
+    // mapping
+    GUIntBig            m_nDenseNodesSize = 0;
+    bool                m_bDenseNodesMMapFailed = false;
+
     unsigned int        nUnsortedReqIds;
     GIntBig            *panUnsortedReqIds;
 
@@ -434,6 +449,9 @@ class OGROSMDataSource final: public OGRDataSource
     bool                FlushCurrentSectorCompressedCase();
     bool                FlushCurrentSectorNonCompressedCase();
     bool                IndexPointCustom( OSMNode* psNode );
+    bool                GrowDenseNodesIndex( GIntBig nID );
+    bool                IndexPointDense( OSMNode* psNode );
+    void                ReleaseDenseNodesMapping();
 
     void                IndexWay(GIntBig nWayID, bool bIsArea,
                                  unsigned int nTags, IndexedKVP* pasTags,
@@ -444,6 +462,8 @@ class OGROSMDataSource final: public OGRDataSource
     bool                CommitTransactionCacheDB();
 
     int                 FindNode(GIntBig nID);
+    void                ResolveWayNodes(int iFirstPair, int iLastPair);
+    static void         ResolveWayNodesFunc(void* pData);
     void                ProcessWaysBatch();
 
     void                ProcessPolygonsStandalone();
@@ -453,6 +473,7 @@ class OGROSMDataSource final: public OGRDataSource
     void                LookupNodesCustom();
     void                LookupNodesCustomCompressedCase();
     void                LookupNodesCustomNonCompressedCase();
+    void                LookupNodesDense();
 
     unsigned int        LookupWays( std::map< GIntBig, std::pair<int,void*> >& aoMapWays,
                                     OSMRelation* psRelation );
@@ -480,6 +501,8 @@ class OGROSMDataSource final: public OGRDataSource
 
     virtual int         TestCapability( const char * ) override;
 
+    virtual GIntBig     GetDriverMemoryUsage() override;
+
     virtual OGRLayer *  ExecuteSQL( const char *pszSQLCommand,
                                     OGRGeometry *poSpatialFilter,
                                     const char *pszDialect ) override;
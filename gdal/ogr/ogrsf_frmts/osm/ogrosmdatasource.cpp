@@ -55,6 +55,8 @@
 #include "cpl_string.h"
 #include "cpl_time.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
+#include "gdal_thread_pool.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
 #include "ogr_feature.h"
@@ -96,6 +98,9 @@ static bool VALID_ID_FOR_CUSTOM_INDEXING( GIntBig _id )
         _id / NODE_PER_BUCKET < INT_MAX;
 }
 
+// Initial size in bytes of the dense node index. Grown by doubling.
+constexpr GUIntBig DENSE_NODES_INITIAL_SIZE = 64 * 1024 * 1024;
+
 // Minimum size of data written on disk, in *uncompressed* case.
 constexpr int SECTOR_SIZE = 512;
 // Which represents, 64 nodes
@@ -374,6 +379,7 @@ OGROSMDataSource::~OGROSMDataSource()
         delete psKD;
     }
 
+    ReleaseDenseNodesMapping();
     if( fpNodes )
         VSIFCloseL(fpNodes);
     if( !osNodesFilename.empty() && bMustUnlinkNodesFile )
@@ -485,6 +491,9 @@ bool OGROSMDataSource::IndexPoint( OSMNode* psNode )
     if( !bIndexPoints )
         return true;
 
+    if( m_bDenseNodesIndex )
+        return IndexPointDense(psNode);
+
     if( bCustomIndexing)
         return IndexPointCustom(psNode);
 
@@ -789,6 +798,105 @@ bool OGROSMDataSource::IndexPointCustom(OSMNode* psNode)
     return true;
 }
 
+/************************************************************************/
+/*                      ReleaseDenseNodesMapping()                      */
+/************************************************************************/
+
+void OGROSMDataSource::ReleaseDenseNodesMapping()
+{
+    if( m_psDenseNodesMapping )
+    {
+        CPLVirtualMemFree(m_psDenseNodesMapping);
+        m_psDenseNodesMapping = nullptr;
+    }
+}
+
+/************************************************************************/
+/*                        GrowDenseNodesIndex()                         */
+/************************************************************************/
+
+// Make sure that the memory mapping of the dense node index covers node nID.
+// If the file cannot be mapped, fall back to plain file I/O.
+bool OGROSMDataSource::GrowDenseNodesIndex( GIntBig nID )
+{
+    const GUIntBig nNeededSize =
+        (static_cast<GUIntBig>(nID) + 1) * sizeof(LonLat);
+    if( nNeededSize <= m_nDenseNodesSize )
+        return true;
+
+    // The file is sparse, so growing it does not consume disk space for the
+    // ranges of ids that are not used.
+    GUIntBig nNewSize = std::max(m_nDenseNodesSize * 2,
+                                 DENSE_NODES_INITIAL_SIZE);
+    while( nNewSize < nNeededSize )
+        nNewSize *= 2;
+
+    ReleaseDenseNodesMapping();
+    if( CPLIsVirtualMemFileMapAvailable() &&
+        nNewSize == static_cast<size_t>(nNewSize) &&
+        VSIFTruncateL(fpNodes, nNewSize) == 0 )
+    {
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        m_psDenseNodesMapping = CPLVirtualMemFileMapNew(
+            fpNodes, 0, nNewSize, VIRTUALMEM_READWRITE, nullptr, nullptr);
+        CPLPopErrorHandler();
+    }
+    if( m_psDenseNodesMapping == nullptr )
+    {
+        CPLDebug("OSM", "Cannot memory-map %s with a size of " CPL_FRMT_GUIB
+                 " bytes. Using file I/O instead",
+                 osNodesFilename.c_str(), nNewSize);
+        m_bDenseNodesMMapFailed = true;
+        return false;
+    }
+
+    m_nDenseNodesSize = nNewSize;
+    return true;
+}
+
+/************************************************************************/
+/*                          IndexPointDense()                           */
+/************************************************************************/
+
+bool OGROSMDataSource::IndexPointDense(OSMNode* psNode)
+{
+    if( !VALID_ID_FOR_CUSTOM_INDEXING(psNode->nID) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Unsupported node id value (" CPL_FRMT_GIB
+                  "). Use OSM_DENSE_NODES_INDEX=NO",
+                  psNode->nID);
+        bStopParsing = true;
+        return false;
+    }
+
+    LonLat sLonLat;
+    sLonLat.nLon = DBL_TO_INT(psNode->dfLon);
+    sLonLat.nLat = DBL_TO_INT(psNode->dfLat);
+
+    if( !m_bDenseNodesMMapFailed && GrowDenseNodesIndex(psNode->nID) )
+    {
+        static_cast<LonLat*>(CPLVirtualMemGetAddr(m_psDenseNodesMapping))
+            [psNode->nID] = sLonLat;
+        return true;
+    }
+
+    const vsi_l_offset nOffset =
+        static_cast<vsi_l_offset>(psNode->nID) * sizeof(LonLat);
+    if( (VSIFTellL(fpNodes) == nOffset ||
+         VSIFSeekL(fpNodes, nOffset, SEEK_SET) == 0) &&
+        VSIFWriteL(&sLonLat, sizeof(LonLat), 1, fpNodes) == 1 )
+    {
+        return true;
+    }
+
+    CPLError( CE_Failure, CPLE_AppDefined,
+              "Cannot write in temporary node file %s : %s",
+              osNodesFilename.c_str(), VSIStrerror(errno));
+    bStopParsing = true;
+    return false;
+}
+
 /************************************************************************/
 /*                             NotifyNodes()                            */
 /************************************************************************/
@@ -873,7 +981,9 @@ static void OGROSMNotifyNodes ( unsigned int nNodes,
 
 void OGROSMDataSource::LookupNodes( )
 {
-    if( bCustomIndexing )
+    if( m_bDenseNodesIndex )
+        LookupNodesDense();
+    else if( bCustomIndexing )
         LookupNodesCustom();
     else
         LookupNodesSQLite();
@@ -1359,6 +1469,94 @@ void OGROSMDataSource::LookupNodesCustomNonCompressedCase()
     nReqIds = j;
 }
 
+/************************************************************************/
+/*                          LookupNodesDense()                          */
+/************************************************************************/
+
+void OGROSMDataSource::LookupNodesDense()
+{
+    CPLAssert(
+        nUnsortedReqIds <= static_cast<unsigned int>(MAX_ACCUMULATED_NODES));
+
+    nReqIds = 0;
+    for( unsigned int i = 0; i < nUnsortedReqIds; i++ )
+    {
+        const GIntBig id = panUnsortedReqIds[i];
+        if( VALID_ID_FOR_CUSTOM_INDEXING(id) )
+            panReqIds[nReqIds++] = id;
+    }
+
+    std::sort(panReqIds, panReqIds + nReqIds);
+
+    /* Remove duplicates */
+    unsigned int j = 0;  // Used after for.
+    for( unsigned int i = 0; i < nReqIds; i++)
+    {
+        if( !(i > 0 && panReqIds[i] == panReqIds[i-1]) )
+            panReqIds[j++] = panReqIds[i];
+    }
+    nReqIds = j;
+
+    j = 0;
+    if( m_psDenseNodesMapping )
+    {
+        // A single memory load per node
+        const LonLat* pasDenseNodes = static_cast<const LonLat*>(
+            CPLVirtualMemGetAddr(m_psDenseNodesMapping));
+        const GUIntBig nMaxId = m_nDenseNodesSize / sizeof(LonLat);
+        for( unsigned int i = 0; i < nReqIds; i++ )
+        {
+            const GIntBig id = panReqIds[i];
+            if( static_cast<GUIntBig>(id) >= nMaxId )
+                break;
+            panReqIds[j] = id;
+            pasLonLatArray[j] = pasDenseNodes[id];
+            if( pasLonLatArray[j].nLon || pasLonLatArray[j].nLat )
+                j++;
+        }
+    }
+    else
+    {
+        // To be glibc friendly, we will do reads aligned on 4096 byte offsets
+        const int knDISK_SECTOR_SIZE = 4096;
+        GByte abyDiskSector[knDISK_SECTOR_SIZE];
+        // Offset in the nodes files for which abyDiskSector was read
+        vsi_l_offset nOldOffset = 0;
+        // Number of valid bytes in abyDiskSector
+        size_t nValidBytes = 0;
+        bool bHasRead = false;
+        for( unsigned int i = 0; i < nReqIds; i++ )
+        {
+            const GIntBig id = panReqIds[i];
+            const vsi_l_offset nOffset =
+                static_cast<vsi_l_offset>(id) * sizeof(LonLat);
+            if( !bHasRead || nOffset - nOldOffset >= knDISK_SECTOR_SIZE )
+            {
+                nOldOffset = nOffset &
+                    ~(static_cast<vsi_l_offset>(knDISK_SECTOR_SIZE) - 1);
+                VSIFSeekL(fpNodes, nOldOffset, SEEK_SET);
+                nValidBytes =
+                    VSIFReadL(abyDiskSector, 1, knDISK_SECTOR_SIZE, fpNodes);
+                bHasRead = true;
+            }
+            // Nodes beyond the end of file have not been written.
+            const size_t nOffsetInDiskSector =
+                static_cast<size_t>(nOffset - nOldOffset);
+            if( nValidBytes < sizeof(LonLat) ||
+                nOffsetInDiskSector > nValidBytes - sizeof(LonLat) )
+                break;
+            panReqIds[j] = id;
+            memcpy(&pasLonLatArray[j], abyDiskSector + nOffsetInDiskSector,
+                   sizeof(LonLat));
+            if( pasLonLatArray[j].nLon || pasLonLatArray[j].nLat )
+                j++;
+        }
+        // Restore the write position
+        VSIFSeekL(fpNodes, 0, SEEK_END);
+    }
+    nReqIds = j;
+}
+
 /************************************************************************/
 /*                            WriteVarInt()                             */
 /************************************************************************/
@@ -1662,22 +1860,20 @@ int OGROSMDataSource::FindNode(GIntBig nID)
 }
 
 /************************************************************************/
-/*                         ProcessWaysBatch()                           */
+/*                          ResolveWayNodes()                           */
 /************************************************************************/
 
-void OGROSMDataSource::ProcessWaysBatch()
+// Fetch the coordinates of the nodes of the ways [iFirstPair, iLastPair[
+// of the current batch, and build the line geometry of their feature.
+// Only reads the node lookup structures, so that ranges of ways may be
+// processed concurrently.
+void OGROSMDataSource::ResolveWayNodes(int iFirstPair, int iLastPair)
 {
-    if( nWayFeaturePairs == 0 ) return;
-
-    //printf("nodes = %d, features = %d\n", nUnsortedReqIds, nWayFeaturePairs);
-    LookupNodes();
-
-    for( int iPair = 0; iPair < nWayFeaturePairs; iPair ++)
+    for( int iPair = iFirstPair; iPair < iLastPair; iPair ++)
     {
         WayFeaturePair* psWayFeaturePairs = &pasWayFeaturePairs[iPair];
-
-        const EMULATED_BOOL bIsArea = psWayFeaturePairs->bIsArea;
-        m_asLonLatCache.clear();
+        std::vector<LonLat>& asLonLat = m_aasWayLonLats[iPair];
+        asLonLat.clear();
 
 #ifdef ENABLE_NODE_LOOKUP_BY_HASHING
         if( bHashedIndexValid )
@@ -1711,7 +1907,7 @@ void OGROSMDataSource::ProcessWaysBatch()
 
                 if( nIdx >= 0 )
                 {
-                    m_asLonLatCache.push_back(pasLonLatArray[nIdx]);
+                    asLonLat.push_back(pasLonLatArray[nIdx]);
                 }
             }
         }
@@ -1734,20 +1930,107 @@ void OGROSMDataSource::ProcessWaysBatch()
                     nIdx = FindNode( psWayFeaturePairs->panNodeRefs[i] );
                 if( nIdx >= 0 )
                 {
-                    m_asLonLatCache.push_back(pasLonLatArray[nIdx]);
+                    asLonLat.push_back(pasLonLatArray[nIdx]);
                 }
             }
         }
 
-        if( !m_asLonLatCache.empty() && bIsArea )
+        if( !asLonLat.empty() && psWayFeaturePairs->bIsArea )
         {
-            m_asLonLatCache.push_back(m_asLonLatCache[0]);
+            asLonLat.push_back(asLonLat[0]);
         }
 
-        if( m_asLonLatCache.size() < 2 )
+        if( asLonLat.size() < 2 || psWayFeaturePairs->poFeature == nullptr )
+        {
+            continue;
+        }
+
+        OGRLineString* poLS = new OGRLineString();
+
+        const int nPoints = static_cast<int>(asLonLat.size());
+        poLS->setNumPoints(nPoints);
+        for(int i=0;i<nPoints;i++)
+        {
+            poLS->setPoint(i,
+                        INT_TO_DBL(asLonLat[i].nLon),
+                        INT_TO_DBL(asLonLat[i].nLat));
+        }
+
+        psWayFeaturePairs->poFeature->SetGeometryDirectly(poLS);
+    }
+}
+
+/************************************************************************/
+/*                        ResolveWayNodesFunc()                         */
+/************************************************************************/
+
+namespace {
+struct ResolveWayNodesJob
+{
+    OGROSMDataSource* poDS;
+    int               iFirstPair;
+    int               iLastPair;
+};
+} // namespace
+
+void OGROSMDataSource::ResolveWayNodesFunc(void* pData)
+{
+    ResolveWayNodesJob* psJob = static_cast<ResolveWayNodesJob*>(pData);
+    psJob->poDS->ResolveWayNodes(psJob->iFirstPair, psJob->iLastPair);
+}
+
+/************************************************************************/
+/*                         ProcessWaysBatch()                           */
+/************************************************************************/
+
+void OGROSMDataSource::ProcessWaysBatch()
+{
+    if( nWayFeaturePairs == 0 ) return;
+
+    //printf("nodes = %d, features = %d\n", nUnsortedReqIds, nWayFeaturePairs);
+    LookupNodes();
+
+    if( static_cast<int>(m_aasWayLonLats.size()) < nWayFeaturePairs )
+        m_aasWayLonLats.resize(nWayFeaturePairs);
+
+    // Resolve the geometries of the ways by ranges of at least
+    // MIN_WAYS_PER_JOB ways in the GDAL thread pool, if worth it.
+    constexpr int MIN_WAYS_PER_JOB = 1000;
+    const int nJobs = std::min(m_nWayThreads,
+        (nWayFeaturePairs + MIN_WAYS_PER_JOB - 1) / MIN_WAYS_PER_JOB);
+    CPLWorkerThreadPool* poThreadPool =
+        nJobs > 1 ? GDALGetGlobalThreadPool(m_nWayThreads) : nullptr;
+    if( poThreadPool )
+    {
+        std::vector<ResolveWayNodesJob> asJobs(nJobs);
+        auto poQueue = poThreadPool->CreateJobQueue();
+        for( int i = 0; i < nJobs; i++ )
+        {
+            asJobs[i].poDS = this;
+            asJobs[i].iFirstPair = static_cast<int>(
+                static_cast<GIntBig>(nWayFeaturePairs) * i / nJobs);
+            asJobs[i].iLastPair = static_cast<int>(
+                static_cast<GIntBig>(nWayFeaturePairs) * (i + 1) / nJobs);
+            poQueue->SubmitJob(ResolveWayNodesFunc, &asJobs[i]);
+        }
+        poQueue->WaitCompletion();
+    }
+    else
+    {
+        ResolveWayNodes(0, nWayFeaturePairs);
+    }
+
+    for( int iPair = 0; iPair < nWayFeaturePairs; iPair ++)
+    {
+        WayFeaturePair* psWayFeaturePairs = &pasWayFeaturePairs[iPair];
+        std::vector<LonLat>& asLonLat = m_aasWayLonLats[iPair];
+
+        const EMULATED_BOOL bIsArea = psWayFeaturePairs->bIsArea;
+
+        if( asLonLat.size() < 2 )
         {
             CPLDebug("OSM", "Way " CPL_FRMT_GIB " with %d nodes that could be found. Discarding it",
-                    psWayFeaturePairs->nWayID, static_cast<int>(m_asLonLatCache.size()));
+                    psWayFeaturePairs->nWayID, static_cast<int>(asLonLat.size()));
             delete psWayFeaturePairs->poFeature;
             psWayFeaturePairs->poFeature = nullptr;
             psWayFeaturePairs->bIsArea = false;
@@ -1760,14 +2043,14 @@ void OGROSMDataSource::ProcessWaysBatch()
                      bIsArea != 0,
                      psWayFeaturePairs->nTags,
                      psWayFeaturePairs->pasTags,
-                     m_asLonLatCache.data(),
-                     static_cast<int>(m_asLonLatCache.size()),
+                     asLonLat.data(),
+                     static_cast<int>(asLonLat.size()),
                      &psWayFeaturePairs->sInfo);
         }
         else
             IndexWay(psWayFeaturePairs->nWayID, bIsArea != 0, 0, nullptr,
-                     m_asLonLatCache.data(),
-                     static_cast<int>(m_asLonLatCache.size()),
+                     asLonLat.data(),
+                     static_cast<int>(asLonLat.size()),
                      nullptr);
 
         if( psWayFeaturePairs->poFeature == nullptr )
@@ -1775,24 +2058,10 @@ void OGROSMDataSource::ProcessWaysBatch()
             continue;
         }
 
-        OGRLineString* poLS = new OGRLineString();
-        OGRGeometry* poGeom = poLS;
-
-        const int nPoints = static_cast<int>(m_asLonLatCache.size());
-        poLS->setNumPoints(nPoints);
-        for(int i=0;i<nPoints;i++)
-        {
-            poLS->setPoint(i,
-                        INT_TO_DBL(m_asLonLatCache[i].nLon),
-                        INT_TO_DBL(m_asLonLatCache[i].nLat));
-        }
-
-        psWayFeaturePairs->poFeature->SetGeometryDirectly(poGeom);
-
-        if( m_asLonLatCache.size() != psWayFeaturePairs->nRefs )
+        if( asLonLat.size() != psWayFeaturePairs->nRefs )
             CPLDebug("OSM", "For way " CPL_FRMT_GIB ", got only %d nodes instead of %d",
                    psWayFeaturePairs->nWayID,
-                   nPoints,
+                   static_cast<int>(asLonLat.size()),
                    psWayFeaturePairs->nRefs);
 
         int bFilteredOut = FALSE;
@@ -2786,6 +3055,13 @@ int OGROSMDataSource::Open( const char * pszFilename,
     if( psParser == nullptr )
         return FALSE;
 
+    // Same as the number of threads used by the PBF parser
+    const char* pszNumThreads =
+        CPLGetConfigOption("GDAL_NUM_THREADS", "ALL_CPUS");
+    m_nWayThreads = CPLGetNumCPUs();
+    if( !EQUAL(pszNumThreads, "ALL_CPUS") )
+        m_nWayThreads = std::max(1, std::min(m_nWayThreads, atoi(pszNumThreads)));
+
     if( CPLFetchBool(papszOpenOptionsIn, "INTERLEAVED_READING", false) )
         bInterleavedReading = TRUE;
 
@@ -2807,6 +3083,11 @@ int OGROSMDataSource::Open( const char * pszFilename,
                         CPLGetConfigOption("OSM_COMPRESS_NODES", "NO")));
     if( bCompressNodes )
         CPLDebug("OSM", "Using compression for nodes DB");
+    m_bDenseNodesIndex = bCustomIndexing && CPLTestBool(CSLFetchNameValueDef(
+            papszOpenOptionsIn, "DENSE_NODES_INDEX",
+                        CPLGetConfigOption("OSM_DENSE_NODES_INDEX", "NO")));
+    if( m_bDenseNodesIndex )
+        CPLDebug("OSM", "Using dense index for nodes");
 
     nLayers = 5;
     papoLayers = static_cast<OGROSMLayer **>(
@@ -2890,7 +3171,32 @@ int OGROSMDataSource::Open( const char * pszFilename,
         nSize = static_cast<GIntBig>(nMaxSizeForInMemoryDBInMB) * 1024 * 1024;
     }
 
-    if( bCustomIndexing )
+    if( m_bDenseNodesIndex )
+    {
+        // The dense index is a sparse file, indexed by node id, that we
+        // memory-map: it must be a real file.
+        pabySector = static_cast<GByte *>(VSI_CALLOC_VERBOSE(1, SECTOR_SIZE));
+        if( pabySector == nullptr )
+        {
+            return FALSE;
+        }
+
+        osNodesFilename = CPLGenerateTempFilename("osm_tmp_nodes");
+        fpNodes = VSIFOpenL(osNodesFilename, "wb+");
+        if( fpNodes == nullptr )
+        {
+            return FALSE;
+        }
+
+        const char* pszVal = CPLGetConfigOption("OSM_UNLINK_TMPFILE", "YES");
+        if( EQUAL(pszVal, "YES") )
+        {
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            bMustUnlinkNodesFile = VSIUnlink( osNodesFilename ) != 0;
+            CPLPopErrorHandler();
+        }
+    }
+    else if( bCustomIndexing )
     {
         pabySector = static_cast<GByte *>(VSI_CALLOC_VERBOSE(1, SECTOR_SIZE));
 
@@ -3837,6 +4143,10 @@ int OGROSMDataSource::MyResetReading()
         nBucketOld = -1;
         nOffInBucketReducedOld = -1;
 
+        ReleaseDenseNodesMapping();
+        m_nDenseNodesSize = 0;
+        m_bDenseNodesMMapFailed = false;
+
         VSIFSeekL(fpNodes, 0, SEEK_SET);
         VSIFTruncateL(fpNodes, 0);
         nNodesFileSize = 0;
@@ -4201,6 +4511,72 @@ int OGROSMDataSource::TestCapability( const char * pszCap )
     return EQUAL(pszCap, ODsCRandomLayerRead);
 }
 
+/************************************************************************/
+/*                        GetDriverMemoryUsage()                        */
+/************************************************************************/
+
+GIntBig OGROSMDataSource::GetDriverMemoryUsage()
+{
+    GIntBig nTotal = OGRDataSource::GetDriverMemoryUsage();
+
+    // Fixed size buffers allocated in Open()
+    if( panReqIds )
+        nTotal += MAX_ACCUMULATED_NODES * sizeof(GIntBig);
+    if( panUnsortedReqIds )
+        nTotal += MAX_ACCUMULATED_NODES * sizeof(GIntBig);
+    if( pasLonLatArray )
+        nTotal += MAX_ACCUMULATED_NODES * sizeof(LonLat);
+#ifdef ENABLE_NODE_LOOKUP_BY_HASHING
+    if( panHashedIndexes )
+        nTotal += HASHED_INDEXES_ARRAY_SIZE * sizeof(int);
+    if( psCollisionBuckets )
+        nTotal += COLLISION_BUCKET_ARRAY_SIZE * sizeof(CollisionBucket);
+#endif
+    if( pasWayFeaturePairs )
+        nTotal += MAX_DELAYED_FEATURES * sizeof(WayFeaturePair);
+    if( pasAccumulatedTags )
+        nTotal += MAX_ACCUMULATED_TAGS * sizeof(IndexedKVP);
+    if( pabyNonRedundantValues )
+        nTotal += MAX_NON_REDUNDANT_VALUES;
+    if( pabySector )
+        nTotal += SECTOR_SIZE;
+
+    // Node index buckets, and the pages holding their bitmaps or sector
+    // sizes, which are shared by consecutive buckets (see AllocBucket()).
+    const int nBucketsPerPage = bCompressNodes ?
+        knPAGE_SIZE / BUCKET_SECTOR_SIZE_ARRAY_SIZE :
+        knPAGE_SIZE / BUCKET_BITMAP_SIZE;
+    for( const auto& oIter: oMapBuckets )
+    {
+        nTotal += sizeof(oIter.first) + sizeof(oIter.second);
+        if( (oIter.first % nBucketsPerPage) == 0 &&
+            oIter.second.u.pabyBitmap != nullptr )
+        {
+            nTotal += knPAGE_SIZE;
+        }
+    }
+
+    nTotal += m_asLonLatCache.capacity() * sizeof(LonLat);
+    for( const auto& asWayLonLats: m_aasWayLonLats )
+        nTotal += asWayLonLats.capacity() * sizeof(LonLat);
+    nTotal += m_abyWayBuffer.capacity();
+
+    // Page caches of the temporary databases
+    for( sqlite3* hSQLiteDB: { hDB, hDBForComputedAttributes } )
+    {
+        int nCurrent = 0;
+        int nHighWater = 0;
+        if( hSQLiteDB &&
+            sqlite3_db_status(hSQLiteDB, SQLITE_DBSTATUS_CACHE_USED,
+                              &nCurrent, &nHighWater, FALSE) == SQLITE_OK )
+        {
+            nTotal += nCurrent;
+        }
+    }
+
+    return nTotal;
+}
+
 /************************************************************************/
 /*                              GetLayer()                              */
 /************************************************************************/
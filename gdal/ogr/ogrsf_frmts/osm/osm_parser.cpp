@@ -35,13 +35,18 @@
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
+#include <condition_variable>
 #include <exception>
+#include <mutex>
+#include <new>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cpl_config.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_error_internal.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
@@ -112,6 +117,8 @@ static void INIT_INFO( OSMInfo *sInfo )
 /*                            _OSMContext                               */
 /************************************************************************/
 
+struct OSMDecodedBlock;
+
 typedef struct
 {
     const GByte *pabySrc;
@@ -120,8 +127,18 @@ typedef struct
     size_t       nDstOffset;
     size_t       nDstSize;
     bool         bStatus;
+    // Set when the primitive block is decoded ahead by a worker thread
+    OSMDecodedBlock *psDecoded;
 } DecompressionJob;
 
+// Synchronization between the worker threads that decode primitive blocks
+// ahead and the thread that issues the notifications.
+struct OSMDecodingSync
+{
+    std::mutex              oMutex{};
+    std::condition_variable oCV{};
+};
+
 struct _OSMContext
 {
     char          *pszStrBuf;
@@ -164,6 +181,11 @@ struct _OSMContext
     int              nJobs;
     int              iNextJob;
 
+    // Number of primitive blocks that may be decoded ahead by poWTP.
+    // 0 when decoding is done sequentially.
+    int              nDecodingWindow;
+    OSMDecodingSync *poDecodingSync;
+
 #ifdef HAVE_EXPAT
     XML_Parser     hXMLParser;
     bool           bEOF;
@@ -1665,13 +1687,324 @@ static bool RunDecompressionJobs(OSMContext* psCtxt)
     return bRet;
 }
 
+/************************************************************************/
+/*                           OSMDecodedBlock                            */
+/************************************************************************/
+
+// Content of a primitive block decoded by a worker thread. The strings
+// still point to the uncompressed buffer of the main context, so the
+// notifications must be replayed before that buffer is reused.
+struct OSMDecodedBlock
+{
+    enum class Event
+    {
+        NODES,
+        WAY,
+        RELATION
+    };
+
+    OSMContext* psCtxt = nullptr;
+    const GByte* pabyData = nullptr;
+    const GByte* pabyDataLimit = nullptr;
+
+    // Protected by psCtxt->poDecodingSync->oMutex
+    bool bDone = false;
+
+    bool bStatus = false;
+    std::vector<CPLErrorHandlerAccumulatorStruct> aoErrors{};
+
+    // Sequence of notifications, with the number of nodes/ways/relations
+    std::vector<std::pair<Event, unsigned>> aoEvents{};
+
+    std::vector<OSMTag> asTags{};
+    std::vector<OSMNode> asNodes{};
+    std::vector<size_t> anNodeTagIdx{};
+    std::vector<OSMWay> asWays{};
+    std::vector<size_t> anWayTagIdx{};
+    std::vector<GIntBig> anNodeRefs{};
+    std::vector<size_t> anWayNodeRefIdx{};
+    std::vector<OSMRelation> asRelations{};
+    std::vector<size_t> anRelationTagIdx{};
+    std::vector<OSMMember> asMembers{};
+    std::vector<size_t> anRelationMemberIdx{};
+
+    void AddEvent(Event eEvent, unsigned nCount)
+    {
+        if( !aoEvents.empty() && aoEvents.back().first == eEvent )
+            aoEvents.back().second += nCount;
+        else
+            aoEvents.emplace_back(eEvent, nCount);
+    }
+
+    size_t AddTags(unsigned nTags, const OSMTag* pasTags)
+    {
+        const size_t nIdx = asTags.size();
+        if( nTags )
+            asTags.insert(asTags.end(), pasTags, pasTags + nTags);
+        return nIdx;
+    }
+
+    OSMTag* GetTags(unsigned nTags, size_t nIdx)
+    {
+        return nTags ? &asTags[nIdx] : nullptr;
+    }
+
+    void ResolvePointers();
+};
+
+/************************************************************************/
+/*                          ResolvePointers()                           */
+/************************************************************************/
+
+// Set the pointers to the tags, node refs and members once the arrays
+// have reached their final size.
+void OSMDecodedBlock::ResolvePointers()
+{
+    for( size_t i = 0; i < asNodes.size(); i++ )
+        asNodes[i].pasTags = GetTags(asNodes[i].nTags, anNodeTagIdx[i]);
+    for( size_t i = 0; i < asWays.size(); i++ )
+    {
+        asWays[i].pasTags = GetTags(asWays[i].nTags, anWayTagIdx[i]);
+        asWays[i].panNodeRefs =
+            asWays[i].nRefs ? &anNodeRefs[anWayNodeRefIdx[i]] : nullptr;
+    }
+    for( size_t i = 0; i < asRelations.size(); i++ )
+    {
+        asRelations[i].pasTags =
+            GetTags(asRelations[i].nTags, anRelationTagIdx[i]);
+        asRelations[i].pasMembers =
+            asRelations[i].nMembers ?
+                &asMembers[anRelationMemberIdx[i]] : nullptr;
+    }
+}
+
+/************************************************************************/
+/*                       Record notifications                           */
+/************************************************************************/
+
+static void RecordNodesFunc( unsigned int nNodes, OSMNode* pasNodes,
+                             OSMContext* /* psCtxt */, void* user_data )
+{
+    OSMDecodedBlock* psBlock = static_cast<OSMDecodedBlock*>(user_data);
+    for( unsigned int i = 0; i < nNodes; i++ )
+    {
+        psBlock->anNodeTagIdx.push_back(
+            psBlock->AddTags(pasNodes[i].nTags, pasNodes[i].pasTags));
+        psBlock->asNodes.push_back(pasNodes[i]);
+    }
+    psBlock->AddEvent(OSMDecodedBlock::Event::NODES, nNodes);
+}
+
+static void RecordWayFunc( OSMWay* psWay,
+                           OSMContext* /* psCtxt */, void* user_data )
+{
+    OSMDecodedBlock* psBlock = static_cast<OSMDecodedBlock*>(user_data);
+    psBlock->anWayTagIdx.push_back(
+        psBlock->AddTags(psWay->nTags, psWay->pasTags));
+    psBlock->anWayNodeRefIdx.push_back(psBlock->anNodeRefs.size());
+    psBlock->anNodeRefs.insert(psBlock->anNodeRefs.end(),
+                               psWay->panNodeRefs,
+                               psWay->panNodeRefs + psWay->nRefs);
+    psBlock->asWays.push_back(*psWay);
+    psBlock->AddEvent(OSMDecodedBlock::Event::WAY, 1);
+}
+
+static void RecordRelationFunc( OSMRelation* psRelation,
+                                OSMContext* /* psCtxt */, void* user_data )
+{
+    OSMDecodedBlock* psBlock = static_cast<OSMDecodedBlock*>(user_data);
+    psBlock->anRelationTagIdx.push_back(
+        psBlock->AddTags(psRelation->nTags, psRelation->pasTags));
+    psBlock->anRelationMemberIdx.push_back(psBlock->asMembers.size());
+    psBlock->asMembers.insert(psBlock->asMembers.end(),
+                              psRelation->pasMembers,
+                              psRelation->pasMembers + psRelation->nMembers);
+    psBlock->asRelations.push_back(*psRelation);
+    psBlock->AddEvent(OSMDecodedBlock::Event::RELATION, 1);
+}
+
+/************************************************************************/
+/*                           DecodeFunction()                           */
+/************************************************************************/
+
+static void DecodeFunction(void* pDataIn)
+{
+    OSMDecodedBlock* psBlock = static_cast<OSMDecodedBlock*>(pDataIn);
+
+    // Private parsing state: string table, granularity and work arrays
+    OSMContext* psWorkCtxt = static_cast<OSMContext*>(
+        VSI_CALLOC_VERBOSE(1, sizeof(OSMContext)));
+    if( psWorkCtxt != nullptr )
+    {
+        psWorkCtxt->bPBF = true;
+        psWorkCtxt->pfnNotifyNodes = RecordNodesFunc;
+        psWorkCtxt->pfnNotifyWay = RecordWayFunc;
+        psWorkCtxt->pfnNotifyRelation = RecordRelationFunc;
+        psWorkCtxt->user_data = psBlock;
+
+        // Errors are emitted by the thread that replays the block
+        CPLInstallErrorHandlerAccumulator(psBlock->aoErrors);
+        try
+        {
+            psBlock->bStatus = ReadPrimitiveBlock(psBlock->pabyData,
+                                                  psBlock->pabyDataLimit,
+                                                  psWorkCtxt);
+            psBlock->ResolvePointers();
+        }
+        catch( const std::bad_alloc& )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Out of memory when decoding primitive block");
+            psBlock->bStatus = false;
+        }
+        CPLUninstallErrorHandlerAccumulator();
+
+        VSIFree(psWorkCtxt->panStrOff);
+        VSIFree(psWorkCtxt->pasNodes);
+        VSIFree(psWorkCtxt->pasTags);
+        VSIFree(psWorkCtxt->pasMembers);
+        VSIFree(psWorkCtxt->panNodeRefs);
+        VSIFree(psWorkCtxt);
+    }
+
+    OSMDecodingSync* poSync = psBlock->psCtxt->poDecodingSync;
+    std::lock_guard<std::mutex> oLock(poSync->oMutex);
+    psBlock->bDone = true;
+    poSync->oCV.notify_all();
+}
+
+/************************************************************************/
+/*                         SubmitDecodingJob()                          */
+/************************************************************************/
+
+static bool SubmitDecodingJob(OSMContext* psCtxt, int iJob)
+{
+    DecompressionJob& sJob = psCtxt->asJobs[iJob];
+    CPLAssert( sJob.psDecoded == nullptr );
+    OSMDecodedBlock* psBlock = new (std::nothrow) OSMDecodedBlock();
+    if( psBlock == nullptr )
+        return false;
+    psBlock->psCtxt = psCtxt;
+    psBlock->pabyData = sJob.pabyDstBase + sJob.nDstOffset;
+    psBlock->pabyDataLimit = psBlock->pabyData + sJob.nDstSize;
+    if( !psCtxt->poWTP->SubmitJob(DecodeFunction, psBlock) )
+    {
+        delete psBlock;
+        return false;
+    }
+    sJob.psDecoded = psBlock;
+    return true;
+}
+
+/************************************************************************/
+/*                         StartDecodingJobs()                          */
+/************************************************************************/
+
+// Decode the first primitive blocks of the freshly uncompressed jobs in
+// the worker threads. Following blocks are submitted as soon as one is
+// consumed, so that at most nDecodingWindow blocks are held decoded.
+static void StartDecodingJobs(OSMContext* psCtxt)
+{
+    if( psCtxt->nDecodingWindow == 0 )
+        return;
+    const int nJobs = std::min(psCtxt->nJobs, psCtxt->nDecodingWindow);
+    for( int i = 0; i < nJobs; i++ )
+    {
+        // In case of failure, the block will just be decoded sequentially
+        if( !SubmitDecodingJob(psCtxt, i) )
+            break;
+    }
+}
+
+/************************************************************************/
+/*                        DiscardDecodingJobs()                         */
+/************************************************************************/
+
+static void DiscardDecodingJobs(OSMContext* psCtxt)
+{
+    if( psCtxt->poWTP == nullptr )
+        return;
+    psCtxt->poWTP->WaitCompletion();
+    for( int i = 0; i < psCtxt->nJobs; i++ )
+    {
+        delete psCtxt->asJobs[i].psDecoded;
+        psCtxt->asJobs[i].psDecoded = nullptr;
+    }
+}
+
+/************************************************************************/
+/*                         ReplayDecodedBlock()                         */
+/************************************************************************/
+
+static bool ReplayDecodedBlock(OSMContext* psCtxt, int iJob)
+{
+    OSMDecodedBlock* psBlock = psCtxt->asJobs[iJob].psDecoded;
+    {
+        std::unique_lock<std::mutex> oLock(psCtxt->poDecodingSync->oMutex);
+        psCtxt->poDecodingSync->oCV.wait(oLock,
+                                         [psBlock]{ return psBlock->bDone; });
+    }
+
+    // Keep the worker threads busy while notifying this block
+    const int iAheadJob = iJob + psCtxt->nDecodingWindow;
+    if( iAheadJob < psCtxt->nJobs &&
+        psCtxt->asJobs[iAheadJob].psDecoded == nullptr )
+    {
+        SubmitDecodingJob(psCtxt, iAheadJob);
+    }
+
+    size_t iNode = 0;
+    size_t iWay = 0;
+    size_t iRelation = 0;
+    for( const auto& oEvent: psBlock->aoEvents )
+    {
+        switch( oEvent.first )
+        {
+            case OSMDecodedBlock::Event::NODES:
+                psCtxt->pfnNotifyNodes(oEvent.second,
+                                       &psBlock->asNodes[iNode],
+                                       psCtxt, psCtxt->user_data);
+                iNode += oEvent.second;
+                break;
+
+            case OSMDecodedBlock::Event::WAY:
+                for( unsigned i = 0; i < oEvent.second; i++ )
+                {
+                    psCtxt->pfnNotifyWay(&psBlock->asWays[iWay++],
+                                         psCtxt, psCtxt->user_data);
+                }
+                break;
+
+            case OSMDecodedBlock::Event::RELATION:
+                for( unsigned i = 0; i < oEvent.second; i++ )
+                {
+                    psCtxt->pfnNotifyRelation(
+                        &psBlock->asRelations[iRelation++],
+                        psCtxt, psCtxt->user_data);
+                }
+                break;
+        }
+    }
+
+    for( const auto& oError: psBlock->aoErrors )
+    {
+        CPLError(oError.type, oError.no, "%s", oError.msg.c_str());
+    }
+
+    const bool bRet = psBlock->bStatus;
+
+    delete psBlock;
+    psCtxt->asJobs[iJob].psDecoded = nullptr;
+    return bRet;
+}
+
 /************************************************************************/
 /*                          ProcessSingleBlob()                         */
 /************************************************************************/
 
-static bool ProcessSingleBlob(OSMContext* psCtxt,
-                           DecompressionJob& sJob, BlobType eType)
+static bool ProcessSingleBlob(OSMContext* psCtxt, int iJob, BlobType eType)
 {
+    DecompressionJob& sJob = psCtxt->asJobs[iJob];
     if( eType == BLOB_OSMHEADER )
     {
         return ReadOSMHeader(
@@ -1682,6 +2015,8 @@ static bool ProcessSingleBlob(OSMContext* psCtxt,
     else
     {
         CPLAssert( eType == BLOB_OSMDATA );
+        if( sJob.psDecoded )
+            return ReplayDecodedBlock(psCtxt, iJob);
         return ReadPrimitiveBlock(
             sJob.pabyDstBase + sJob.nDstOffset,
             sJob.pabyDstBase + sJob.nDstOffset + sJob.nDstSize,
@@ -1702,7 +2037,7 @@ static bool RunDecompressionJobsAndProcessAll(OSMContext* psCtxt,
     }
     for( int i = 0; i < psCtxt->nJobs; i++ )
     {
-        if( !ProcessSingleBlob(psCtxt, psCtxt->asJobs[i], eType) )
+        if( !ProcessSingleBlob(psCtxt, i, eType) )
         {
             return false;
         }
@@ -1871,8 +2206,10 @@ bool ReadBlob( OSMContext* psCtxt, BlobType eType )
             {
                 THROW_OSM_PARSING_EXCEPTION;
             }
+            if( eType == BLOB_OSMDATA )
+                StartDecodingJobs(psCtxt);
             // Just process one blob at a time
-            if( !ProcessSingleBlob(psCtxt, psCtxt->asJobs[0], eType) )
+            if( !ProcessSingleBlob(psCtxt, 0, eType) )
             {
                 THROW_OSM_PARSING_EXCEPTION;
             }
@@ -1898,9 +2235,7 @@ static OSMRetCode PBF_ProcessBlock(OSMContext* psCtxt)
     // Process any remaining queued jobs one by one
     if (psCtxt->iNextJob < psCtxt->nJobs)
     {
-        if( !(ProcessSingleBlob(psCtxt,
-                                psCtxt->asJobs[psCtxt->iNextJob],
-                                BLOB_OSMDATA)) )
+        if( !(ProcessSingleBlob(psCtxt, psCtxt->iNextJob, BLOB_OSMDATA)) )
         {
             return OSM_ERROR;
         }
@@ -2767,6 +3102,13 @@ OSMContext* OSM_Open( const char* pszFilename,
             delete psCtxt->poWTP;
             psCtxt->poWTP = nullptr;
         }
+        else if( bPBF )
+        {
+            // Primitive blocks are decoded ahead in the worker threads,
+            // and their content notified in order by the calling thread.
+            psCtxt->poDecodingSync = new OSMDecodingSync();
+            psCtxt->nDecodingWindow = 2 * psCtxt->poWTP->GetThreadCount();
+        }
     }
 
     return psCtxt;
@@ -2799,7 +3141,9 @@ void OSM_Close(OSMContext* psCtxt)
     VSIFree(psCtxt->pasTags);
     VSIFree(psCtxt->pasMembers);
     VSIFree(psCtxt->panNodeRefs);
+    DiscardDecodingJobs(psCtxt);
     delete psCtxt->poWTP;
+    delete psCtxt->poDecodingSync;
 
     VSIFCloseL(psCtxt->fp);
     VSIFree(psCtxt);
@@ -2812,6 +3156,7 @@ void OSM_ResetReading( OSMContext* psCtxt )
 {
     VSIFSeekL(psCtxt->fp, 0, SEEK_SET);
 
+    DiscardDecodingJobs(psCtxt);
     psCtxt->nBytesRead = 0;
     psCtxt->nJobs = 0;
     psCtxt->iNextJob = 0;
@@ -182,6 +182,14 @@ class OGRPGLayer CPL_NON_FINAL: public OGRLayer
     OGRPGFeatureDefn   *poFeatureDefn = nullptr;
 
     int                 nCursorPage = 0;
+    // Whether nCursorPage is adjusted to the size of the fetched rows
+    bool                m_bAdaptiveCursorPage = false;
+    bool                m_bCursorPrefetch = false;
+    // Number of rows requested by the FETCH that returned hCursorResult
+    int                 m_nLastFetchCount = 0;
+    // Number of rows requested by the in-flight asynchronous FETCH, or 0
+    int                 m_nPrefetchCount = 0;
+    PGconn             *m_hPrefetchConn = nullptr;
     GIntBig             iNextShapeId = 0;
 
     static char        *GByteArrayToBYTEA( const GByte* pabyData, size_t nLen);
@@ -213,6 +221,10 @@ class OGRPGLayer CPL_NON_FINAL: public OGRLayer
 
     void                SetInitialQueryCursor();
     void                CloseCursor();
+    void                FetchNextCursorPage();
+    void                UpdateCursorPageSize();
+    void                PrefetchNextCursorPage();
+    void                DiscardCursorPrefetch();
 
     virtual CPLString   GetFromClauseForGetExtent() = 0;
     OGRErr              RunGetExtentRequest( OGREnvelope *psExtent, int bForce,
@@ -302,6 +314,15 @@ class OGRPGTableLayer final: public OGRPGLayer
     OGRErr              CreateFeatureViaCopy( OGRFeature *poFeature );
     OGRErr              CreateFeatureViaInsert( OGRFeature *poFeature );
     CPLString           BuildCopyFields();
+    OGRErr              PutCopyData( const char* pabyData, size_t nSize );
+
+    // Binary COPY: set by StartCopy() when all copied columns have a
+    // supported binary representation.
+    bool                m_bCopyBinary = false;
+    std::vector<Oid>    m_anCopyColumnTypes{};
+    bool                CanUseBinaryCopy( const CPLString& osFields );
+    bool                BuildBinaryCopyRow( OGRFeature *poFeature,
+                                            std::string& osRow );
 
     int                 bHasWarnedIncompatibleGeom = false;
     void                CheckGeomTypeCompatibility(int iGeomField, OGRGeometry* poGeom);
@@ -545,7 +566,10 @@ class OGRPGDataSource final: public OGRDataSource
                         OGRPGDataSource();
                         virtual ~OGRPGDataSource();
 
-    PGconn              *GetPGConn() { return hPGConn; }
+    // Waits for a pending asynchronous cursor FETCH, so that the
+    // connection can be used right away.
+    PGconn              *GetPGConn() { OGRPG_PQfinishAsyncQuery(hPGConn);
+                                       return hPGConn; }
 
     int                 FetchSRSId( OGRSpatialReference * poSRS );
     OGRSpatialReference *FetchSRS( int nSRSId );
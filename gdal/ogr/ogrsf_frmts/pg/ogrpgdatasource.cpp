@@ -85,6 +85,7 @@ OGRPGDataSource::~OGRPGDataSource()
         /* XXX - mloskot: After the connection is closed, valgrind still
          * reports 36 bytes definitely lost, somewhere in the libpq.
          */
+        OGRPG_PQdiscardAsyncResult( hPGConn, nullptr );
         PQfinish( hPGConn );
         hPGConn = nullptr;
     }
@@ -62,6 +62,7 @@ PROVIDE MAINTENANCE, SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include "cpl_conv.h"
 #include "cpl_string.h"
 
+#include <algorithm>
 #include <limits>
 
 #define PQexec this_is_an_error
@@ -80,7 +81,11 @@ CPL_CVSID("$Id$")
 /************************************************************************/
 
 OGRPGLayer::OGRPGLayer() :
-    nCursorPage(atoi(CPLGetConfigOption("OGR_PG_CURSOR_PAGE", "500")))
+    nCursorPage(atoi(CPLGetConfigOption("OGR_PG_CURSOR_PAGE", "500"))),
+    m_bAdaptiveCursorPage(
+        CPLGetConfigOption("OGR_PG_CURSOR_PAGE", nullptr) == nullptr),
+    m_bCursorPrefetch(
+        CPLTestBool(CPLGetConfigOption("OGR_PG_CURSOR_PREFETCH", "YES")))
 {
     pszCursorName = CPLStrdup(CPLSPrintf("OGRPGLayerReader%p", this));
 }
@@ -120,6 +125,8 @@ OGRPGLayer::~OGRPGLayer()
 
 void OGRPGLayer::CloseCursor()
 {
+    DiscardCursorPrefetch();
+
     PGconn      *hPGConn = poDS->GetPGConn();
 
     if( hCursorResult != nullptr )
@@ -1447,6 +1454,7 @@ void OGRPGLayer::SetInitialQueryCursor()
 
     osCommand.Printf( "FETCH %d in %s", nCursorPage, pszCursorName );
     hCursorResult = OGRPG_PQexec(hPGConn, osCommand );
+    m_nLastFetchCount = nCursorPage;
 
     CreateMapFromFieldNameToIndex(hCursorResult,
                                   poFeatureDefn,
@@ -1454,6 +1462,122 @@ void OGRPGLayer::SetInitialQueryCursor()
                                   m_panMapFieldNameToGeomIndex);
 
     nResultOffset = 0;
+
+    UpdateCursorPageSize();
+    PrefetchNextCursorPage();
+}
+
+/************************************************************************/
+/*                       UpdateCursorPageSize()                         */
+/*                                                                      */
+/*      Unless OGR_PG_CURSOR_PAGE is set, adjust the number of rows     */
+/*      of the next FETCH so that a page is about                       */
+/*      CURSOR_PAGE_TARGET_BYTES large, from the average size of the    */
+/*      rows of the page just received.                                 */
+/************************************************************************/
+
+constexpr int CURSOR_PAGE_TARGET_BYTES = 4 * 1024 * 1024;
+constexpr int CURSOR_PAGE_MIN_ROWS = 10;
+constexpr int CURSOR_PAGE_MAX_ROWS = 100000;
+
+void OGRPGLayer::UpdateCursorPageSize()
+{
+    if( !m_bAdaptiveCursorPage || hCursorResult == nullptr ||
+        PQresultStatus(hCursorResult) != PGRES_TUPLES_OK )
+        return;
+
+    const int nRows = PQntuples(hCursorResult);
+    if( nRows == 0 )
+        return;
+    const int nFields = PQnfields(hCursorResult);
+    GIntBig nBytes = 0;
+    for( int iRow = 0; iRow < nRows; iRow++ )
+    {
+        for( int iField = 0; iField < nFields; iField++ )
+            nBytes += PQgetlength(hCursorResult, iRow, iField);
+    }
+    const GIntBig nRowBytes = std::max<GIntBig>(1, nBytes / nRows);
+    nCursorPage = static_cast<int>(
+        std::max<GIntBig>(CURSOR_PAGE_MIN_ROWS,
+            std::min<GIntBig>(CURSOR_PAGE_MAX_ROWS,
+                              CURSOR_PAGE_TARGET_BYTES / nRowBytes)));
+}
+
+/************************************************************************/
+/*                      PrefetchNextCursorPage()                        */
+/*                                                                      */
+/*      Send the FETCH of the next page without waiting for its         */
+/*      result, so that the server produces it while the current page   */
+/*      is turned into features.                                        */
+/************************************************************************/
+
+void OGRPGLayer::PrefetchNextCursorPage()
+{
+    // Large objects are read with lo_xxx() calls during the decoding of
+    // the current page, which would wait for the prefetched page anyway.
+    if( !m_bCursorPrefetch || bWkbAsOid || m_nPrefetchCount > 0 ||
+        hCursorResult == nullptr ||
+        PQresultStatus(hCursorResult) != PGRES_TUPLES_OK ||
+        PQntuples(hCursorResult) != m_nLastFetchCount )
+    {
+        return;
+    }
+
+    PGconn *hPGConn = poDS->GetPGConn();
+    if( PQtransactionStatus(hPGConn) != PQTRANS_INTRANS )
+        return;
+
+    CPLString osCommand;
+    osCommand.Printf( "FETCH %d in %s", nCursorPage, pszCursorName );
+    if( OGRPG_PQsendQueryAsync(hPGConn, osCommand, this) )
+    {
+        m_nPrefetchCount = nCursorPage;
+        m_hPrefetchConn = hPGConn;
+    }
+}
+
+/************************************************************************/
+/*                      DiscardCursorPrefetch()                         */
+/************************************************************************/
+
+void OGRPGLayer::DiscardCursorPrefetch()
+{
+    if( m_nPrefetchCount > 0 )
+    {
+        OGRPG_PQdiscardAsyncResult(m_hPrefetchConn, this);
+        m_nPrefetchCount = 0;
+        m_hPrefetchConn = nullptr;
+    }
+}
+
+/************************************************************************/
+/*                       FetchNextCursorPage()                          */
+/************************************************************************/
+
+void OGRPGLayer::FetchNextCursorPage()
+{
+    OGRPGClearResult( hCursorResult );
+
+    if( m_nPrefetchCount > 0 )
+    {
+        hCursorResult = OGRPG_PQgetAsyncResult(m_hPrefetchConn, this);
+        m_nLastFetchCount = m_nPrefetchCount;
+        m_nPrefetchCount = 0;
+        m_hPrefetchConn = nullptr;
+    }
+    else
+    {
+        PGconn *hPGConn = poDS->GetPGConn();
+        CPLString osCommand;
+        osCommand.Printf( "FETCH %d in %s", nCursorPage, pszCursorName );
+        hCursorResult = OGRPG_PQexec(hPGConn, osCommand );
+        m_nLastFetchCount = nCursorPage;
+    }
+
+    nResultOffset = 0;
+
+    UpdateCursorPageSize();
+    PrefetchNextCursorPage();
 }
 
 /************************************************************************/
@@ -1463,9 +1587,6 @@ void OGRPGLayer::SetInitialQueryCursor()
 OGRFeature *OGRPGLayer::GetNextRawFeature()
 
 {
-    PGconn      *hPGConn = poDS->GetPGConn();
-    CPLString   osCommand;
-
     if( bInvalidated )
     {
         CPLError(CE_Failure, CPLE_AppDefined,
@@ -1500,17 +1621,19 @@ OGRFeature *OGRPGLayer::GetNextRawFeature()
 /*      Do we need to fetch more records?                               */
 /* -------------------------------------------------------------------- */
 
-    /* We test for PQntuples(hCursorResult) == 1 in the case the previous */
-    /* request was a SetNextByIndex() */
-    if( (PQntuples(hCursorResult) == 1 || PQntuples(hCursorResult) == nCursorPage) &&
+    /* A page shorter than requested means that the cursor is exhausted. */
+    /* m_nLastFetchCount is 1 when the previous request was a */
+    /* SetNextByIndex() */
+    if( PQntuples(hCursorResult) == m_nLastFetchCount &&
         nResultOffset == PQntuples(hCursorResult) )
     {
-        OGRPGClearResult( hCursorResult );
-
-        osCommand.Printf( "FETCH %d in %s", nCursorPage, pszCursorName );
-        hCursorResult = OGRPG_PQexec(hPGConn, osCommand );
-
-        nResultOffset = 0;
+        FetchNextCursorPage();
+    }
+    else if( m_nPrefetchCount > 0 && (nResultOffset % 64) == 0 )
+    {
+        /* Read what the server has already sent of the next page, so */
+        /* that it does not block on a full socket buffer. */
+        PQconsumeInput( m_hPrefetchConn );
     }
 
 /* -------------------------------------------------------------------- */
@@ -1569,18 +1692,19 @@ OGRErr OGRPGLayer::SetNextByIndex( GIntBig nIndex )
         return OGRERR_NONE;
     }
 
-    PGconn      *hPGConn = poDS->GetPGConn();
-    CPLString   osCommand;
-
     if (hCursorResult == nullptr )
     {
         SetInitialQueryCursor();
     }
 
+    DiscardCursorPrefetch();
     OGRPGClearResult( hCursorResult );
 
+    PGconn      *hPGConn = poDS->GetPGConn();
+    CPLString   osCommand;
     osCommand.Printf( "FETCH ABSOLUTE " CPL_FRMT_GIB " in %s", nIndex+1, pszCursorName );
     hCursorResult = OGRPG_PQexec(hPGConn, osCommand );
+    m_nLastFetchCount = 1;
 
     if (PQresultStatus(hCursorResult) != PGRES_TUPLES_OK ||
         PQntuples(hCursorResult) != 1)
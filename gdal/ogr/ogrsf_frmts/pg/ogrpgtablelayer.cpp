@@ -33,6 +33,9 @@
 #include "cpl_string.h"
 #include "cpl_error.h"
 #include "ogr_p.h"
+#include "cpl_time.h"
+
+#include <climits>
 
 #define PQexec this_is_an_error
 
@@ -1912,6 +1915,14 @@ OGRErr OGRPGTableLayer::CreateFeatureViaCopy( OGRFeature *poFeature )
     /* Tell the datasource we are now planning to copy data */
     poDS->StartCopy( this );
 
+    if( m_bCopyBinary )
+    {
+        std::string osRow;
+        if( !BuildBinaryCopyRow( poFeature, osRow ) )
+            return OGRERR_FAILURE;
+        return PutCopyData( osRow.data(), osRow.size() );
+    }
+
     /* First process geometry */
     for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
     {
@@ -1967,17 +1978,28 @@ OGRErr OGRPGTableLayer::CreateFeatureViaCopy( OGRFeature *poFeature )
     /* Add end of line marker */
     osCommand += "\n";
 
+#ifdef DEBUG_VERBOSE
+    CPLDebug("PG", "PQputCopyData(%s)", osCommand.c_str());
+#endif
+
+    return PutCopyData( osCommand.c_str(), osCommand.size() );
+}
+
+/************************************************************************/
+/*                            PutCopyData()                             */
+/************************************************************************/
+
+OGRErr OGRPGTableLayer::PutCopyData( const char* pabyData, size_t nSize )
+{
     /* ------------------------------------------------------------ */
     /*      Execute the copy.                                       */
     /* ------------------------------------------------------------ */
 
+    PGconn *hPGConn = poDS->GetPGConn();
     OGRErr result = OGRERR_NONE;
 
-    int copyResult = PQputCopyData(hPGConn, osCommand.c_str(),
-                                   static_cast<int>(osCommand.size()));
-#ifdef DEBUG_VERBOSE
-    CPLDebug("PG", "PQputCopyData(%s)", osCommand.c_str());
-#endif
+    int copyResult = PQputCopyData(hPGConn, pabyData,
+                                   static_cast<int>(nSize));
 
     switch (copyResult)
     {
@@ -1994,6 +2016,497 @@ OGRErr OGRPGTableLayer::CreateFeatureViaCopy( OGRFeature *poFeature )
     return result;
 }
 
+/************************************************************************/
+/*                     Binary COPY encoding helpers                     */
+/************************************************************************/
+
+// Values of the binary COPY format are in network byte order.
+
+static void AppendInt16BE( std::string& osBuf, GInt16 nVal )
+{
+    CPL_MSBPTR16(&nVal);
+    osBuf.append(reinterpret_cast<const char*>(&nVal), sizeof(nVal));
+}
+
+static void AppendInt32BE( std::string& osBuf, GInt32 nVal )
+{
+    CPL_MSBPTR32(&nVal);
+    osBuf.append(reinterpret_cast<const char*>(&nVal), sizeof(nVal));
+}
+
+static void AppendInt64BE( std::string& osBuf, GInt64 nVal )
+{
+    CPL_MSBPTR64(&nVal);
+    osBuf.append(reinterpret_cast<const char*>(&nVal), sizeof(nVal));
+}
+
+static void AppendFloat32BE( std::string& osBuf, float fVal )
+{
+    CPL_MSBPTR32(&fVal);
+    osBuf.append(reinterpret_cast<const char*>(&fVal), sizeof(fVal));
+}
+
+static void AppendFloat64BE( std::string& osBuf, double dfVal )
+{
+    CPL_MSBPTR64(&dfVal);
+    osBuf.append(reinterpret_cast<const char*>(&dfVal), sizeof(dfVal));
+}
+
+// Append a length-prefixed column value
+static void AppendBinaryValue( std::string& osBuf, const void* pData,
+                               size_t nSize )
+{
+    AppendInt32BE(osBuf, static_cast<GInt32>(nSize));
+    osBuf.append(static_cast<const char*>(pData), nSize);
+}
+
+// Append a geometry as WKB, or as EWKB if nSRSId > 0. This is the binary
+// equivalent of GeometryToBYTEA() / OGRGeometryToHexEWKB().
+static bool AppendBinaryGeometry( std::string& osBuf,
+                                  const OGRGeometry* poGeom,
+                                  int nSRSId,
+                                  int nPostGISMajor, int nPostGISMinor )
+{
+    const size_t nWkbSize = poGeom->WkbSize();
+    const size_t nSRIDSize = nSRSId > 0 ? sizeof(GUInt32) : 0;
+    if( nWkbSize < 5 ||
+        nWkbSize + nSRIDSize > static_cast<size_t>(INT_MAX) )
+    {
+        return false;
+    }
+
+    std::vector<GByte> abyWKB;
+    try
+    {
+        abyWKB.resize(nWkbSize);
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory, "Out of memory");
+        return false;
+    }
+
+    OGRwkbVariant eVariant =
+        (nPostGISMajor < 2) ? wkbVariantPostGIS1 : wkbVariantOldOgc;
+    if( (nPostGISMajor > 2 || (nPostGISMajor == 2 && nPostGISMinor >= 2)) &&
+        wkbFlatten(poGeom->getGeometryType()) == wkbPoint &&
+        poGeom->IsEmpty() )
+    {
+        eVariant = wkbVariantIso;
+    }
+    if( poGeom->exportToWkb( wkbNDR, abyWKB.data(), eVariant ) !=
+                                                            OGRERR_NONE )
+    {
+        return false;
+    }
+
+    AppendInt32BE(osBuf, static_cast<GInt32>(nWkbSize + nSRIDSize));
+    if( nSRSId > 0 )
+    {
+        constexpr GUInt32 WKBSRIDFLAG = 0x20000000;
+        GUInt32 nGeomType = 0;
+        memcpy(&nGeomType, abyWKB.data() + 1, sizeof(nGeomType));
+        nGeomType |= CPL_LSBWORD32(WKBSRIDFLAG);
+        const GUInt32 nSRID = CPL_LSBWORD32(static_cast<GUInt32>(nSRSId));
+        osBuf.append(reinterpret_cast<const char*>(abyWKB.data()), 1);
+        osBuf.append(reinterpret_cast<const char*>(&nGeomType),
+                     sizeof(nGeomType));
+        osBuf.append(reinterpret_cast<const char*>(&nSRID), sizeof(nSRID));
+        osBuf.append(reinterpret_cast<const char*>(abyWKB.data()) + 5,
+                     nWkbSize - 5);
+    }
+    else
+    {
+        osBuf.append(reinterpret_cast<const char*>(abyWKB.data()), nWkbSize);
+    }
+    return true;
+}
+
+// Number of seconds between 1970-01-01 and 2000-01-01, the PostgreSQL epoch.
+constexpr GIntBig PG_EPOCH_UNIX_TIME = 946684800;
+
+static GIntBig GetUnixTime( int nYear, int nMonth, int nDay,
+                            int nHour, int nMinute, int nSecond )
+{
+    struct tm brokendowntime;
+    brokendowntime.tm_year = nYear - 1900;
+    brokendowntime.tm_mon = nMonth - 1;
+    brokendowntime.tm_mday = nDay;
+    brokendowntime.tm_hour = nHour;
+    brokendowntime.tm_min = nMinute;
+    brokendowntime.tm_sec = nSecond;
+    return CPLYMDHMSToUnixTime(&brokendowntime);
+}
+
+/************************************************************************/
+/*                          CanUseBinaryCopy()                          */
+/************************************************************************/
+
+// Returns whether the columns of osFields can be written with the binary
+// COPY format, and fills m_anCopyColumnTypes with their types.
+bool OGRPGTableLayer::CanUseBinaryCopy( const CPLString& osFields )
+{
+    m_anCopyColumnTypes.clear();
+
+    if( !CPLTestBool(CPLGetConfigOption("PG_USE_COPY_BINARY", "NO")) )
+        return false;
+
+    PGconn *hPGConn = poDS->GetPGConn();
+
+    // Binary timestamps are 64 bit integers, except with the deprecated
+    // floating point datetimes.
+    const char* pszIntegerDateTimes =
+        PQparameterStatus(hPGConn, "integer_datetimes");
+    const bool bIntegerDateTimes =
+        pszIntegerDateTimes != nullptr && EQUAL(pszIntegerDateTimes, "on");
+
+    CPLString osCommand;
+    osCommand.Printf("SELECT %s FROM %s LIMIT 0",
+                     osFields.c_str(), pszSqlTableName);
+    PGresult *hResult = OGRPG_PQexec(hPGConn, osCommand);
+    if( !hResult || PQresultStatus(hResult) != PGRES_TUPLES_OK )
+    {
+        OGRPGClearResult( hResult );
+        return false;
+    }
+    for( int i = 0; i < PQnfields(hResult); i++ )
+        m_anCopyColumnTypes.push_back(PQftype(hResult, i));
+    OGRPGClearResult( hResult );
+
+    size_t iCol = 0;
+    const char* pszUnsupportedColumn = nullptr;
+
+    for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
+    {
+        OGRPGGeomFieldDefn* poGeomFieldDefn =
+            poFeatureDefn->GetGeomFieldDefn(i);
+        if( poGeomFieldDefn->ePostgisType != GEOM_TYPE_GEOMETRY &&
+            poGeomFieldDefn->ePostgisType != GEOM_TYPE_GEOGRAPHY &&
+            poGeomFieldDefn->ePostgisType != GEOM_TYPE_WKB )
+        {
+            pszUnsupportedColumn = poGeomFieldDefn->GetNameRef();
+            break;
+        }
+        iCol ++;
+    }
+
+    int nFIDIndex = -1;
+    if( pszUnsupportedColumn == nullptr && bFIDColumnInCopyFields )
+    {
+        nFIDIndex = poFeatureDefn->GetFieldIndex( pszFIDColumn );
+        if( iCol >= m_anCopyColumnTypes.size() ||
+            (m_anCopyColumnTypes[iCol] != INT4OID &&
+             m_anCopyColumnTypes[iCol] != INT8OID) )
+        {
+            pszUnsupportedColumn = pszFIDColumn;
+        }
+        iCol ++;
+    }
+
+    for( int i = 0; pszUnsupportedColumn == nullptr &&
+                    i < poFeatureDefn->GetFieldCount(); i++ )
+    {
+        if( i == nFIDIndex || m_abGeneratedColumns[i] )
+            continue;
+
+        OGRFieldDefn* poFieldDefn = poFeatureDefn->GetFieldDefn(i);
+        const Oid nType = iCol < m_anCopyColumnTypes.size() ?
+                                        m_anCopyColumnTypes[iCol] : 0;
+        iCol ++;
+
+        bool bSupported = false;
+        switch( poFieldDefn->GetType() )
+        {
+            case OFTInteger:
+                bSupported = nType == BOOLOID || nType == INT2OID ||
+                             nType == INT4OID || nType == INT8OID;
+                break;
+            case OFTInteger64:
+                bSupported = nType == INT8OID;
+                break;
+            case OFTReal:
+                bSupported = nType == FLOAT4OID || nType == FLOAT8OID;
+                break;
+            case OFTString:
+                bSupported = nType == TEXTOID || nType == VARCHAROID ||
+                             nType == BPCHAROID || nType == JSONOID ||
+                             nType == JSONBOID;
+                break;
+            case OFTBinary:
+                bSupported = nType == BYTEAOID;
+                break;
+            case OFTDate:
+                bSupported = nType == DATEOID;
+                break;
+            case OFTDateTime:
+                // The text form of timestamps with time zone may depend on
+                // the time zone of the session.
+                bSupported = nType == TIMESTAMPOID && bIntegerDateTimes;
+                break;
+            default:
+                break;
+        }
+        if( !bSupported )
+            pszUnsupportedColumn = poFieldDefn->GetNameRef();
+    }
+
+    if( pszUnsupportedColumn == nullptr &&
+        iCol != m_anCopyColumnTypes.size() )
+    {
+        pszUnsupportedColumn = "(unknown)";
+    }
+
+    if( pszUnsupportedColumn != nullptr )
+    {
+        CPLDebug("PG", "Binary COPY not possible for column %s of %s. "
+                 "Using text COPY", pszUnsupportedColumn, pszSqlTableName);
+        m_anCopyColumnTypes.clear();
+        return false;
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                         BuildBinaryCopyRow()                         */
+/************************************************************************/
+
+// Binary COPY equivalent of the text row built by CreateFeatureViaCopy()
+bool OGRPGTableLayer::BuildBinaryCopyRow( OGRFeature *poFeature,
+                                          std::string& osRow )
+{
+    AppendInt16BE(osRow, static_cast<GInt16>(m_anCopyColumnTypes.size()));
+
+    size_t iCol = 0;
+
+    /* First process geometry */
+    for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++, iCol++ )
+    {
+        OGRPGGeomFieldDefn* poGeomFieldDefn =
+            poFeatureDefn->GetGeomFieldDefn(i);
+        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(i);
+        if( poGeom == nullptr )
+        {
+            AppendInt32BE(osRow, -1);
+            continue;
+        }
+
+        CheckGeomTypeCompatibility(i, poGeom);
+
+        poGeom->closeRings();
+        poGeom->set3D(poGeomFieldDefn->GeometryTypeFlags & OGRGeometry::OGR_G_3D);
+        poGeom->setMeasured(poGeomFieldDefn->GeometryTypeFlags & OGRGeometry::OGR_G_MEASURED);
+
+        if( !AppendBinaryGeometry(osRow, poGeom,
+                                  poGeomFieldDefn->ePostgisType == GEOM_TYPE_WKB ?
+                                        0 : poGeomFieldDefn->nSRSId,
+                                  poDS->sPostGISVersion.nMajor,
+                                  poDS->sPostGISVersion.nMinor) )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "Cannot encode geometry of feature " CPL_FRMT_GIB,
+                     poFeature->GetFID());
+            return false;
+        }
+    }
+
+    /* Next process the field id column */
+    int nFIDIndex = -1;
+    if( bFIDColumnInCopyFields )
+    {
+        nFIDIndex = poFeatureDefn->GetFieldIndex( pszFIDColumn );
+        const GIntBig nFID = poFeature->GetFID();
+        if( nFID == OGRNullFID )
+        {
+            AppendInt32BE(osRow, -1);
+        }
+        else if( m_anCopyColumnTypes[iCol] == INT8OID )
+        {
+            AppendInt32BE(osRow, 8);
+            AppendInt64BE(osRow, nFID);
+        }
+        else if( nFID >= INT_MIN && nFID <= INT_MAX )
+        {
+            AppendInt32BE(osRow, 4);
+            AppendInt32BE(osRow, static_cast<GInt32>(nFID));
+        }
+        else
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "FID " CPL_FRMT_GIB " out of range for column %s",
+                     nFID, pszFIDColumn);
+            return false;
+        }
+        iCol ++;
+    }
+
+    /* Now process the remaining fields */
+    for( int i = 0; i < poFeatureDefn->GetFieldCount(); i++ )
+    {
+        if( i == nFIDIndex || m_abGeneratedColumns[i] )
+            continue;
+
+        const Oid nType = m_anCopyColumnTypes[iCol];
+        iCol ++;
+
+        if( !poFeature->IsFieldSetAndNotNull( i ) )
+        {
+            AppendInt32BE(osRow, -1);
+            continue;
+        }
+
+        OGRFieldDefn* poFieldDefn = poFeatureDefn->GetFieldDefn(i);
+        switch( poFieldDefn->GetType() )
+        {
+            case OFTInteger:
+            case OFTInteger64:
+            {
+                const GIntBig nVal = poFeature->GetFieldAsInteger64(i);
+                if( nType == BOOLOID )
+                {
+                    const GByte byVal = nVal != 0 ? 1 : 0;
+                    AppendBinaryValue(osRow, &byVal, 1);
+                }
+                else if( nType == INT8OID )
+                {
+                    AppendInt32BE(osRow, 8);
+                    AppendInt64BE(osRow, nVal);
+                }
+                else if( nType == INT4OID && nVal >= INT_MIN && nVal <= INT_MAX )
+                {
+                    AppendInt32BE(osRow, 4);
+                    AppendInt32BE(osRow, static_cast<GInt32>(nVal));
+                }
+                else if( nType == INT2OID && nVal >= SHRT_MIN && nVal <= SHRT_MAX )
+                {
+                    AppendInt32BE(osRow, 2);
+                    AppendInt16BE(osRow, static_cast<GInt16>(nVal));
+                }
+                else
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined,
+                             "Value " CPL_FRMT_GIB " out of range for column %s",
+                             nVal, poFieldDefn->GetNameRef());
+                    return false;
+                }
+                break;
+            }
+
+            case OFTReal:
+            {
+                const double dfVal = poFeature->GetFieldAsDouble(i);
+                if( nType == FLOAT4OID )
+                {
+                    AppendInt32BE(osRow, 4);
+                    AppendFloat32BE(osRow, static_cast<float>(dfVal));
+                }
+                else
+                {
+                    AppendInt32BE(osRow, 8);
+                    AppendFloat64BE(osRow, dfVal);
+                }
+                break;
+            }
+
+            case OFTString:
+            {
+                const char* pszStrValue = poFeature->GetFieldAsString(i);
+                size_t nLen = strlen(pszStrValue);
+
+                // Same truncation as OGRPGCommonAppendCopyFieldsExceptGeom()
+                const int nMaxWidth = poFieldDefn->GetWidth();
+                if( nMaxWidth > 0 )
+                {
+                    int iUTFChar = 0;
+                    for( size_t iChar = 0; iChar < nLen; iChar++ )
+                    {
+                        if( (pszStrValue[iChar] & 0xc0) != 0x80 )
+                        {
+                            if( iUTFChar == nMaxWidth )
+                            {
+                                CPLDebug( "PG",
+                                    "Truncated %s field value, it was too long.",
+                                    poFieldDefn->GetNameRef() );
+                                nLen = iChar;
+                                break;
+                            }
+                            iUTFChar++;
+                        }
+                    }
+                }
+
+                if( nType == JSONBOID )
+                {
+                    // jsonb binary format: version number, then text
+                    AppendInt32BE(osRow, static_cast<GInt32>(nLen + 1));
+                    osRow += '\x01';
+                    osRow.append(pszStrValue, nLen);
+                }
+                else
+                {
+                    AppendBinaryValue(osRow, pszStrValue, nLen);
+                }
+                break;
+            }
+
+            case OFTBinary:
+            {
+                int nLen = 0;
+                const GByte* pabyData = poFeature->GetFieldAsBinary(i, &nLen);
+                AppendBinaryValue(osRow, pabyData, nLen);
+                break;
+            }
+
+            case OFTDate:
+            case OFTDateTime:
+            {
+                int nYear = 0;
+                int nMonth = 0;
+                int nDay = 0;
+                int nHour = 0;
+                int nMinute = 0;
+                float fSecond = 0.0f;
+                int nTZFlag = 0;
+                poFeature->GetFieldAsDateTime(i, &nYear, &nMonth, &nDay,
+                                              &nHour, &nMinute, &fSecond,
+                                              &nTZFlag);
+                if( nType == DATEOID )
+                {
+                    const GIntBig nUnixTime =
+                        GetUnixTime(nYear, nMonth, nDay, 0, 0, 0);
+                    AppendInt32BE(osRow, 4);
+                    AppendInt32BE(osRow, static_cast<GInt32>(
+                        (nUnixTime - PG_EPOCH_UNIX_TIME) / 86400));
+                }
+                else
+                {
+                    // Time zone is ignored for timestamp without time zone,
+                    // as when converting from text. Text output of OGR
+                    // has a millisecond precision.
+                    const int nSecond = static_cast<int>(fSecond);
+                    const GIntBig nUnixTime =
+                        GetUnixTime(nYear, nMonth, nDay,
+                                    nHour, nMinute, nSecond);
+                    const GIntBig nMilliSec = static_cast<GIntBig>(
+                        floor((fSecond - nSecond) * 1000 + 0.5));
+                    AppendInt32BE(osRow, 8);
+                    AppendInt64BE(osRow,
+                        (nUnixTime - PG_EPOCH_UNIX_TIME) * 1000000 +
+                        nMilliSec * 1000);
+                }
+                break;
+            }
+
+            default:
+                CPLAssert(false);
+                AppendInt32BE(osRow, -1);
+                break;
+        }
+    }
+
+    return true;
+}
+
 /************************************************************************/
 /*                           TestCapability()                           */
 /************************************************************************/
@@ -2916,12 +3429,15 @@ OGRErr OGRPGTableLayer::StartCopy()
 
     CPLString osFields = BuildCopyFields();
 
+    m_bCopyBinary = CanUseBinaryCopy(osFields);
+
     size_t size = osFields.size() +  strlen(pszSqlTableName) + 100;
     char *pszCommand = static_cast<char *>(CPLMalloc(size));
 
     snprintf( pszCommand, size,
-             "COPY %s (%s) FROM STDIN;",
-             pszSqlTableName, osFields.c_str() );
+             "COPY %s (%s) FROM STDIN%s;",
+             pszSqlTableName, osFields.c_str(),
+             m_bCopyBinary ? " WITH BINARY" : "" );
 
     PGconn *hPGConn = poDS->GetPGConn();
     PGresult *hResult = OGRPG_PQexec(hPGConn, pszCommand);
@@ -2932,8 +3448,19 @@ OGRErr OGRPGTableLayer::StartCopy()
                   "%s", PQerrorMessage(hPGConn) );
     }
     else
+    {
         bCopyActive = TRUE;
 
+        if( m_bCopyBinary )
+        {
+            // Signature, flags and header extension length
+            std::string osHeader("PGCOPY\n\377\r\n\0", 11);
+            AppendInt32BE(osHeader, 0);
+            AppendInt32BE(osHeader, 0);
+            PutCopyData(osHeader.data(), osHeader.size());
+        }
+    }
+
     OGRPGClearResult( hResult );
     CPLFree( pszCommand );
 
@@ -2960,6 +3487,16 @@ OGRErr OGRPGTableLayer::EndCopy()
 
     bCopyActive = FALSE;
 
+    if( m_bCopyBinary )
+    {
+        // File trailer
+        std::string osTrailer;
+        AppendInt16BE(osTrailer, -1);
+        if( PutCopyData(osTrailer.data(), osTrailer.size()) != OGRERR_NONE )
+            result = OGRERR_FAILURE;
+        m_bCopyBinary = false;
+    }
+
     int copyResult = PQputCopyEnd(hPGConn, nullptr);
 
     switch (copyResult)
@@ -29,19 +29,21 @@
 #include "ogr_pg.h"
 #include "cpl_conv.h"
 
+#include <atomic>
+#include <map>
+#include <mutex>
+
 CPL_CVSID("$Id$")
 
 /************************************************************************/
-/*                         OGRPG_PQexec()                               */
+/*                        OGRPGReportResult()                           */
 /************************************************************************/
 
-PGresult *OGRPG_PQexec(PGconn *conn, const char *query, int bMultipleCommandAllowed,
-                       int bErrorAsDebug)
+static void OGRPGReportResult(PGconn *conn, PGresult* hResult,
+                              const char *query,
+                              int bMultipleCommandAllowed,
+                              int bErrorAsDebug)
 {
-    PGresult* hResult = bMultipleCommandAllowed
-        ? PQexec(conn, query)
-        : PQexecParams(conn, query, 0, nullptr, nullptr, nullptr, nullptr, 0);
-
 #ifdef DEBUG
     const char* pszRetCode = "UNKNOWN";
     char szNTuples[32] = {};
@@ -69,6 +71,9 @@ PGresult *OGRPG_PQexec(PGconn *conn, const char *query, int bMultipleCommandAllo
         CPLDebug("PG", "PQexec(%s) = %s%s", query, pszRetCode, szNTuples);
     else
         CPLDebug("PG", "PQexecParams(%s) = %s%s", query, pszRetCode, szNTuples);
+#else
+    CPL_IGNORE_RET_VAL(query);
+    CPL_IGNORE_RET_VAL(bMultipleCommandAllowed);
 #endif
 
 /* -------------------------------------------------------------------- */
@@ -82,6 +87,147 @@ PGresult *OGRPG_PQexec(PGconn *conn, const char *query, int bMultipleCommandAllo
         else
             CPLError( CE_Failure, CPLE_AppDefined, "%s", PQerrorMessage( conn ) );
     }
+}
+
+/************************************************************************/
+/*                       Asynchronous queries                           */
+/*                                                                      */
+/*      At most one query per connection may be sent with               */
+/*      OGRPG_PQsendQueryAsync(). Until its result has been             */
+/*      collected, the connection cannot be used for anything else,     */
+/*      so OGRPG_PQexec() and OGRPGDataSource::GetPGConn() call         */
+/*      OGRPG_PQfinishAsyncQuery() that collects and keeps the result   */
+/*      aside until its owner asks for it.                              */
+/************************************************************************/
+
+namespace {
+struct OGRPGAsyncQuery
+{
+    const void *pOwner = nullptr;
+    CPLString   osQuery{};
+    bool        bCollected = false;
+    PGresult   *hResult = nullptr;
+};
+} // namespace
+
+static std::mutex goAsyncQueriesMutex;
+static std::map<PGconn*, OGRPGAsyncQuery> goMapAsyncQueries;
+// Number of entries in goMapAsyncQueries, to avoid taking the mutex in the
+// common case where no asynchronous query is in flight.
+static std::atomic<int> gnAsyncQueries{0};
+
+/************************************************************************/
+/*                      OGRPGCollectAsyncResult()                       */
+/************************************************************************/
+
+// Must be called with goAsyncQueriesMutex held.
+static void OGRPGCollectAsyncResult(PGconn *conn, OGRPGAsyncQuery& oQuery)
+{
+    if( oQuery.bCollected )
+        return;
+    oQuery.hResult = PQgetResult(conn);
+    // Only one command was sent: consume up to the terminating NULL result
+    while( PGresult* hExtraResult = PQgetResult(conn) )
+        PQclear(hExtraResult);
+    oQuery.bCollected = true;
+}
+
+/************************************************************************/
+/*                       OGRPG_PQsendQueryAsync()                       */
+/************************************************************************/
+
+bool OGRPG_PQsendQueryAsync(PGconn *conn, const char *query,
+                            const void* pOwner)
+{
+    std::lock_guard<std::mutex> oLock(goAsyncQueriesMutex);
+    if( goMapAsyncQueries.find(conn) != goMapAsyncQueries.end() )
+        return false;
+    if( !PQsendQueryParams(conn, query, 0, nullptr, nullptr, nullptr,
+                           nullptr, 0) )
+    {
+        CPLDebug("PG", "PQsendQueryParams(%s) failed: %s",
+                 query, PQerrorMessage(conn));
+        return false;
+    }
+    OGRPGAsyncQuery& oQuery = goMapAsyncQueries[conn];
+    oQuery.pOwner = pOwner;
+    oQuery.osQuery = query;
+    ++gnAsyncQueries;
+    return true;
+}
+
+/************************************************************************/
+/*                       OGRPG_PQgetAsyncResult()                       */
+/************************************************************************/
+
+PGresult *OGRPG_PQgetAsyncResult(PGconn *conn, const void* pOwner)
+{
+    PGresult* hResult = nullptr;
+    CPLString osQuery;
+    {
+        std::lock_guard<std::mutex> oLock(goAsyncQueriesMutex);
+        auto oIter = goMapAsyncQueries.find(conn);
+        if( oIter == goMapAsyncQueries.end() ||
+            oIter->second.pOwner != pOwner )
+            return nullptr;
+        OGRPGCollectAsyncResult(conn, oIter->second);
+        hResult = oIter->second.hResult;
+        osQuery = oIter->second.osQuery;
+        goMapAsyncQueries.erase(oIter);
+        --gnAsyncQueries;
+    }
+    OGRPGReportResult(conn, hResult, osQuery, FALSE, FALSE);
+    return hResult;
+}
+
+/************************************************************************/
+/*                     OGRPG_PQdiscardAsyncResult()                     */
+/************************************************************************/
+
+void OGRPG_PQdiscardAsyncResult(PGconn *conn, const void* pOwner)
+{
+    if( gnAsyncQueries == 0 )
+        return;
+    std::lock_guard<std::mutex> oLock(goAsyncQueriesMutex);
+    auto oIter = goMapAsyncQueries.find(conn);
+    if( oIter == goMapAsyncQueries.end() ||
+        (pOwner != nullptr && oIter->second.pOwner != pOwner) )
+        return;
+    OGRPGCollectAsyncResult(conn, oIter->second);
+    OGRPGClearResult(oIter->second.hResult);
+    goMapAsyncQueries.erase(oIter);
+    --gnAsyncQueries;
+}
+
+/************************************************************************/
+/*                     OGRPG_PQfinishAsyncQuery()                       */
+/************************************************************************/
+
+void OGRPG_PQfinishAsyncQuery(PGconn *conn)
+{
+    if( gnAsyncQueries == 0 )
+        return;
+    std::lock_guard<std::mutex> oLock(goAsyncQueriesMutex);
+    auto oIter = goMapAsyncQueries.find(conn);
+    if( oIter != goMapAsyncQueries.end() )
+        OGRPGCollectAsyncResult(conn, oIter->second);
+}
+
+/************************************************************************/
+/*                         OGRPG_PQexec()                               */
+/************************************************************************/
+
+PGresult *OGRPG_PQexec(PGconn *conn, const char *query, int bMultipleCommandAllowed,
+                       int bErrorAsDebug)
+{
+    OGRPG_PQfinishAsyncQuery(conn);
+
+    PGresult* hResult = bMultipleCommandAllowed
+        ? PQexec(conn, query)
+        : PQexecParams(conn, query, 0, nullptr, nullptr, nullptr, nullptr, 0);
+
+    OGRPGReportResult(conn, hResult, query, bMultipleCommandAllowed,
+                      bErrorAsDebug);
 
     return hResult;
 }
@@ -36,6 +36,12 @@ PGresult *OGRPG_PQexec(PGconn *conn, const char *query,
                        int bMultipleCommandAllowed = FALSE,
                        int bErrorAsDebug = FALSE);
 
+bool OGRPG_PQsendQueryAsync(PGconn *conn, const char *query,
+                            const void* pOwner);
+PGresult *OGRPG_PQgetAsyncResult(PGconn *conn, const void* pOwner);
+void OGRPG_PQdiscardAsyncResult(PGconn *conn, const void* pOwner);
+void OGRPG_PQfinishAsyncQuery(PGconn *conn);
+
 /************************************************************************/
 /*                            OGRPGClearResult                          */
 /*                                                                      */
@@ -33,6 +33,7 @@
 #ifndef S57_H_INCLUDED
 #define S57_H_INCLUDED
 
+#include <map>
 #include <string>
 #include <vector>
 #include "ogr_feature.h"
@@ -294,6 +295,26 @@ class CPL_DLL S57Reader
     int                 Nall;               // see RecodeByDSSI() function
     bool                needAallNallSetup;  // see RecodeByDSSI() function
 
+    // Polygons of area features built ahead of time, in parallel, by
+    // PrepareAreaGeometries(), for the feature records in the
+    // [nPreparedFromFEIndex, nPreparedToFEIndex[ range.
+    struct PreparedArea
+    {
+        OGRGeometryCollection *poLines = nullptr;
+        OGRGeometry           *poPolygon = nullptr;
+        OGRErr                 eErr = OGRERR_NONE;
+    };
+    int                 nAssembleThreads;
+    int                 nPreparedFromFEIndex;
+    int                 nPreparedToFEIndex;
+    OGRFeatureDefn     *poPreparedTarget;
+    std::map<DDFRecord*, PreparedArea> oMapPreparedAreas;
+    struct BuildAreaGeometriesJob;
+
+    void                PrepareAreaGeometries( OGRFeatureDefn * );
+    void                ClearPreparedAreaGeometries();
+    static void         BuildAreaGeometriesFunc( void * );
+
     void                ClearPendingMultiPoint();
     OGRFeature         *NextPendingMultiPoint();
 
@@ -309,6 +330,7 @@ class CPL_DLL S57Reader
     void                AssemblePointGeometry( DDFRecord *, OGRFeature * );
     void                AssembleLineGeometry( DDFRecord *, OGRFeature * );
     void                AssembleAreaGeometry( DDFRecord *, OGRFeature * );
+    OGRGeometryCollection *CollectAreaEdges( DDFRecord *, const char * );
 
     bool                FetchPoint( int, int,
                                     double *, double *, double * = nullptr );
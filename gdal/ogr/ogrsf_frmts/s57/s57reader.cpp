@@ -29,6 +29,7 @@
 
 #include "cpl_conv.h"
 #include "cpl_string.h"
+#include "gdal_thread_pool.h"
 #include "ogr_api.h"
 #include "s57.h"
 
@@ -174,9 +175,21 @@ S57Reader::S57Reader( const char * pszFilename ) :
     Aall(0),  // See RecodeByDSSI() function.
     Nall(0),  // See RecodeByDSSI() function.
     needAallNallSetup(true),  // See RecodeByDSSI() function.
+    nAssembleThreads(1),
+    nPreparedFromFEIndex(0),
+    nPreparedToFEIndex(0),
+    poPreparedTarget(nullptr),
     bMissingWarningIssued(false),
     bAttrWarningIssued(false)
 {
+    const char* pszNumThreads =
+        CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszNumThreads != nullptr )
+    {
+        nAssembleThreads = EQUAL(pszNumThreads, "ALL_CPUS") ?
+            CPLGetNumCPUs() : atoi(pszNumThreads);
+        nAssembleThreads = std::max(1, std::min(128, nAssembleThreads));
+    }
 }
 
 /************************************************************************/
@@ -275,6 +288,7 @@ void S57Reader::Close()
         }
 
         ClearPendingMultiPoint();
+        ClearPreparedAreaGeometries();
 
         delete poModule;
         poModule = nullptr;
@@ -752,6 +766,14 @@ OGRFeature * S57Reader::ReadNextFeature( OGRFeatureDefn * poTarget )
             continue;
         }
 
+        if( nAssembleThreads > 1 &&
+            (nNextFEIndex < nPreparedFromFEIndex ||
+             nNextFEIndex >= nPreparedToFEIndex ||
+             poTarget != poPreparedTarget) )
+        {
+            PrepareAreaGeometries( poTarget );
+        }
+
         OGRFeature *poFeature = ReadFeature( nNextFEIndex++, poTarget );
         if( poFeature != nullptr )
         {
@@ -2356,11 +2378,11 @@ void S57Reader::AssembleLineGeometry( DDFRecord * poFRecord,
 }
 
 /************************************************************************/
-/*                        AssembleAreaGeometry()                        */
+/*                          CollectAreaEdges()                          */
 /************************************************************************/
 
-void S57Reader::AssembleAreaGeometry( DDFRecord * poFRecord,
-                                      OGRFeature * poFeature )
+OGRGeometryCollection *S57Reader::CollectAreaEdges( DDFRecord * poFRecord,
+                                                   const char * pszLayerName )
 
 {
     OGRGeometryCollection * const poLines = new OGRGeometryCollection();
@@ -2397,7 +2419,7 @@ void S57Reader::AssembleAreaGeometry( DDFRecord * poFRecord,
                           "Feature OBJL=%s, RCID=%d may have corrupt or"
                           "missing geometry.",
                           nRCID,
-                          poFeature->GetDefnRef()->GetName(),
+                          pszLayerName,
                           GetIntSubfield( poFSPT, "RCID", 0 ) );
                 continue;
             }
@@ -2459,14 +2481,45 @@ void S57Reader::AssembleAreaGeometry( DDFRecord * poFRecord,
         }
     }
 
+    return poLines;
+}
+
+/************************************************************************/
+/*                        AssembleAreaGeometry()                        */
+/************************************************************************/
+
+void S57Reader::AssembleAreaGeometry( DDFRecord * poFRecord,
+                                      OGRFeature * poFeature )
+
+{
+    OGRGeometry *poPolygon = nullptr;
+    OGRErr eErr = OGRERR_NONE;
+
+/* -------------------------------------------------------------------- */
+/*      Use the polygon built by PrepareAreaGeometries() if available.  */
+/* -------------------------------------------------------------------- */
+    auto oIter = oMapPreparedAreas.find( poFRecord );
+    if( oIter != oMapPreparedAreas.end() )
+    {
+        CPLAssert( oIter->second.poLines == nullptr );
+        poPolygon = oIter->second.poPolygon;
+        eErr = oIter->second.eErr;
+        oMapPreparedAreas.erase( oIter );
+    }
+    else
+    {
+        OGRGeometryCollection *poLines =
+            CollectAreaEdges( poFRecord, poFeature->GetDefnRef()->GetName() );
+
 /* -------------------------------------------------------------------- */
 /*      Build lines into a polygon.                                     */
 /* -------------------------------------------------------------------- */
-    OGRErr eErr;
+        poPolygon = reinterpret_cast<OGRGeometry *>(
+            OGRBuildPolygonFromEdges( reinterpret_cast<OGRGeometryH>( poLines ),
+                                      TRUE, FALSE, 0.0, &eErr ) );
+        delete poLines;
+    }
 
-    OGRGeometry  *poPolygon = reinterpret_cast<OGRGeometry *>(
-        OGRBuildPolygonFromEdges( reinterpret_cast<OGRGeometryH>( poLines ),
-                                  TRUE, FALSE, 0.0, &eErr ) );
     if( eErr != OGRERR_NONE )
     {
         CPLError( CE_Warning, CPLE_AppDefined,
@@ -2476,12 +2529,128 @@ void S57Reader::AssembleAreaGeometry( DDFRecord * poFRecord,
                   poFeature->GetFieldAsInteger( "FIDS" ) );
     }
 
-    delete poLines;
-
     if( poPolygon != nullptr )
         poFeature->SetGeometryDirectly( poPolygon );
 }
 
+/************************************************************************/
+/*                      BuildAreaGeometriesFunc()                       */
+/************************************************************************/
+
+struct S57Reader::BuildAreaGeometriesJob
+{
+    std::vector<PreparedArea*>::const_iterator oBegin{};
+    std::vector<PreparedArea*>::const_iterator oEnd{};
+};
+
+void S57Reader::BuildAreaGeometriesFunc( void *pData )
+
+{
+    const BuildAreaGeometriesJob* psJob =
+        static_cast<const BuildAreaGeometriesJob*>(pData);
+    for( auto oIter = psJob->oBegin; oIter != psJob->oEnd; ++oIter )
+    {
+        PreparedArea* psArea = *oIter;
+        psArea->poPolygon = reinterpret_cast<OGRGeometry *>(
+            OGRBuildPolygonFromEdges(
+                reinterpret_cast<OGRGeometryH>( psArea->poLines ),
+                TRUE, FALSE, 0.0, &psArea->eErr ) );
+        delete psArea->poLines;
+        psArea->poLines = nullptr;
+    }
+}
+
+/************************************************************************/
+/*                       PrepareAreaGeometries()                        */
+/*                                                                      */
+/*      Collect the edges of the area features that follow              */
+/*      nNextFEIndex, and assemble them into polygons with several      */
+/*      threads. Reading the ISO 8211 records is not thread-safe, so    */
+/*      only polygon building, which is usually the most expensive      */
+/*      step, is done in parallel.                                      */
+/************************************************************************/
+
+void S57Reader::PrepareAreaGeometries( OGRFeatureDefn *poTarget )
+
+{
+    ClearPreparedAreaGeometries();
+
+    const int nBatchSize = nAssembleThreads * 16;
+    std::vector<PreparedArea*> apsAreas;
+    int iFE = nNextFEIndex;
+    for( ; iFE < oFE_Index.GetCount() &&
+           static_cast<int>(apsAreas.size()) < nBatchSize; iFE++ )
+    {
+        DDFRecord *poRecord = oFE_Index.GetByIndex( iFE );
+        OGRFeatureDefn *poFeatureDefn
+          = static_cast<OGRFeatureDefn *>( oFE_Index.GetClientInfoByIndex( iFE ) );
+        if( poFeatureDefn == nullptr )
+        {
+            poFeatureDefn = FindFDefn( poRecord );
+            oFE_Index.SetClientInfoByIndex( iFE, poFeatureDefn );
+        }
+        if( poFeatureDefn == nullptr ||
+            (poTarget != nullptr && poFeatureDefn != poTarget) ||
+            poRecord->GetIntSubfield( "FRID", 0, "PRIM", 0 ) != PRIM_A )
+        {
+            continue;
+        }
+
+        PreparedArea& oArea = oMapPreparedAreas[poRecord];
+        oArea.poLines = CollectAreaEdges( poRecord, poFeatureDefn->GetName() );
+        apsAreas.push_back( &oArea );
+    }
+    nPreparedFromFEIndex = nNextFEIndex;
+    nPreparedToFEIndex = iFE;
+    poPreparedTarget = poTarget;
+
+    if( apsAreas.empty() )
+        return;
+
+    CPLWorkerThreadPool* poThreadPool = GDALGetGlobalThreadPool(nAssembleThreads);
+    const int nJobs = static_cast<int>(std::min<size_t>(
+        nAssembleThreads, apsAreas.size()));
+    const size_t nChunkSize = (apsAreas.size() + nJobs - 1) / nJobs;
+    std::vector<BuildAreaGeometriesJob> asJobs(nJobs);
+    for( int i = 0; i < nJobs; i++ )
+    {
+        asJobs[i].oBegin = apsAreas.cbegin() +
+            std::min(apsAreas.size(), i * nChunkSize);
+        asJobs[i].oEnd = apsAreas.cbegin() +
+            std::min(apsAreas.size(), (i + 1) * nChunkSize);
+    }
+
+    auto poJobQueue = poThreadPool ? poThreadPool->CreateJobQueue() : nullptr;
+    for( auto& sJob: asJobs )
+    {
+        if( poJobQueue == nullptr ||
+            !poJobQueue->SubmitJob(BuildAreaGeometriesFunc, &sJob) )
+        {
+            BuildAreaGeometriesFunc(&sJob);
+        }
+    }
+    if( poJobQueue )
+        poJobQueue->WaitCompletion();
+}
+
+/************************************************************************/
+/*                    ClearPreparedAreaGeometries()                     */
+/************************************************************************/
+
+void S57Reader::ClearPreparedAreaGeometries()
+
+{
+    for( auto& oIter: oMapPreparedAreas )
+    {
+        delete oIter.second.poLines;
+        delete oIter.second.poPolygon;
+    }
+    oMapPreparedAreas.clear();
+    nPreparedFromFEIndex = 0;
+    nPreparedToFEIndex = 0;
+    poPreparedTarget = nullptr;
+}
+
 /************************************************************************/
 /*                             FindFDefn()                              */
 /*                                                                      */
@@ -3175,6 +3344,9 @@ bool S57Reader::ApplyUpdates( DDFModule *poUpdateModule )
     if( !bFileIngested && !Ingest() )
         return false;
 
+    // Updated records would invalidate polygons assembled ahead of time.
+    ClearPreparedAreaGeometries();
+
 /* -------------------------------------------------------------------- */
 /*      Read records, and apply as updates.                             */
 /* -------------------------------------------------------------------- */
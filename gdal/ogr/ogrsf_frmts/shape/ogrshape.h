@@ -37,6 +37,8 @@
 #endif
 
 #include "ogrsf_frmts.h"
+#include "cpl_quad_tree.h"
+#include "cpl_virtualmem.h"
 #include "shapefil.h"
 #include "shp_vsi.h"
 #include "ogrlayerpool.h"
@@ -54,8 +56,20 @@
 /* ==================================================================== */
 OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                                OGRFeatureDefn * poDefn, int iShape,
-                               SHPObject *psShape, const char *pszSHPEncoding );
+                               SHPObject *psShape, const char *pszSHPEncoding,
+                               const GByte *pabySHPMapping = nullptr,
+                               size_t nSHPMappingSize = 0 );
+void SHPReadOGRFeatureField( DBFHandle hDBF, OGRFeature *poFeature,
+                             int iShape, int iField,
+                             const char *pszSHPEncoding );
 OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape );
+OGRGeometry *SHPReadOGRObjectFromMapping( SHPHandle hSHP, int iShape,
+                                          const GByte *pabyMapping,
+                                          size_t nMappingSize );
+bool SHPGetMappedRecordEnvelope( SHPHandle hSHP, int iShape,
+                                 const GByte *pabyMapping,
+                                 size_t nMappingSize,
+                                 OGREnvelope &sEnvelope );
 OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
                                        SHPHandle hSHP, DBFHandle hDBF,
                                        const char *pszSHPEncoding,
@@ -148,6 +162,13 @@ class OGRShapeLayer final: public OGRAbstractProxiedLayer
 
     bool                bSbnSbxDeleted;
 
+    // Quad tree of the shape bounding boxes, built on the first spatially
+    // filtered read when there is no .qix or .sbn.
+    CPLQuadTree        *m_hInMemorySPI = nullptr;
+    bool                m_bInMemorySPITried = false;
+    bool                BuildInMemorySpatialIndex();
+    void                ClearInMemorySpatialIndex();
+
     CPLString           ConvertCodePage( const char * );
     CPLString           osEncoding{};
 
@@ -187,6 +208,20 @@ class OGRShapeLayer final: public OGRAbstractProxiedLayer
     // Set of field names (in upper case). Built and invalidated when convenient
     std::set<CPLString> m_oSetUCFieldName{};
 
+    // Read-only mapping of the whole .shp, used to translate records
+    // without going through SHPReadObject(). Only set up for read-only
+    // layers on local files.
+    CPLVirtualMem      *m_psSHPMapping = nullptr;
+    bool                m_bSHPMappingTried = false;
+    const GByte        *GetSHPMapping( size_t &nSize );
+    void                ReleaseSHPMapping();
+
+    // Indices of the .dbf fields referenced by the attribute filter, when
+    // it can be evaluated on them alone before decoding the rest.
+    std::vector<int>    m_anAttrQueryFields{};
+    bool                m_bAttrQueryOnDBFOnly = false;
+    bool                EvaluateAttributeFilterOnDBF( int iShapeId );
+
     bool                StartUpdate( const char* pszOperation );
 
     void                CloseUnderlyingLayer() override;
@@ -293,6 +293,8 @@ OGRShapeLayer::~OGRShapeLayer()
     if( hDBF != nullptr )
         DBFClose( hDBF );
 
+    ReleaseSHPMapping();
+
     if( hSHP != nullptr )
         SHPClose( hSHP );
 
@@ -301,6 +303,9 @@ OGRShapeLayer::~OGRShapeLayer()
 
     if( hSBN != nullptr )
         SBNCloseDiskTree( hSBN );
+
+    if( m_hInMemorySPI != nullptr )
+        CPLQuadTreeDestroy( m_hInMemorySPI );
 }
 
 /************************************************************************/
@@ -512,6 +517,104 @@ bool OGRShapeLayer::CheckForQIX()
     return hQIX != nullptr;
 }
 
+/************************************************************************/
+/*                      BuildInMemorySpatialIndex()                     */
+/*                                                                      */
+/*      Index the bounding boxes of all shapes in a quad tree, so that  */
+/*      repeated spatially filtered reads of a layer without .qix or    */
+/*      .sbn do not have to go through all records.                     */
+/************************************************************************/
+
+bool OGRShapeLayer::BuildInMemorySpatialIndex()
+
+{
+    if( m_bInMemorySPITried )
+        return m_hInMemorySPI != nullptr;
+
+    m_bInMemorySPITried = true;
+
+    if( hSHP == nullptr || hSHP->nRecords == 0 ||
+        !CPLTestBool(
+            CPLGetConfigOption("SHAPE_IN_MEMORY_SPATIAL_INDEX", "YES")) )
+        return false;
+
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = hSHP->adBoundsMin[0];
+    sGlobalBounds.miny = hSHP->adBoundsMin[1];
+    sGlobalBounds.maxx = hSHP->adBoundsMax[0];
+    sGlobalBounds.maxy = hSHP->adBoundsMax[1];
+    m_hInMemorySPI = CPLQuadTreeCreate( &sGlobalBounds, nullptr );
+    CPLQuadTreeSetMaxDepth( m_hInMemorySPI,
+                            CPLQuadTreeGetAdvisedMaxDepth(hSHP->nRecords) );
+
+    size_t nMappingSize = 0;
+    const GByte *pabyMapping = GetSHPMapping( nMappingSize );
+
+    for( int iShape = 0; iShape < hSHP->nRecords; iShape++ )
+    {
+        OGREnvelope sEnvelope;
+        if( !SHPGetMappedRecordEnvelope( hSHP, iShape, pabyMapping,
+                                         nMappingSize, sEnvelope ) )
+        {
+            // Null and unreadable shapes never match a spatial filter, and
+            // degenerate bounds of non-point shapes are not trusted, as
+            // in FetchShape(), so recompute them from the vertices.
+            SHPObject *psShape = SHPReadObject( hSHP, iShape );
+            if( psShape == nullptr )
+                continue;
+            if( psShape->nSHPType == SHPT_NULL )
+            {
+                SHPDestroyObject( psShape );
+                continue;
+            }
+            if( psShape->nSHPType != SHPT_POINT &&
+                psShape->nSHPType != SHPT_POINTZ &&
+                psShape->nSHPType != SHPT_POINTM &&
+                (psShape->dfXMin == psShape->dfXMax ||
+                 psShape->dfYMin == psShape->dfYMax) )
+            {
+                SHPComputeExtents( psShape );
+            }
+            sEnvelope.MinX = psShape->dfXMin;
+            sEnvelope.MinY = psShape->dfYMin;
+            sEnvelope.MaxX = psShape->dfXMax;
+            sEnvelope.MaxY = psShape->dfYMax;
+            SHPDestroyObject( psShape );
+        }
+
+        CPLRectObj sBounds;
+        sBounds.minx = sEnvelope.MinX;
+        sBounds.miny = sEnvelope.MinY;
+        sBounds.maxx = sEnvelope.MaxX;
+        sBounds.maxy = sEnvelope.MaxY;
+        CPLQuadTreeInsertWithBounds(
+            m_hInMemorySPI,
+            reinterpret_cast<void*>(static_cast<GUIntptr_t>(iShape)),
+            &sBounds );
+    }
+
+    CPLDebug( "SHAPE", "Built in-memory spatial index of %s (%d shapes)",
+              pszFullName, hSHP->nRecords );
+
+    return true;
+}
+
+/************************************************************************/
+/*                      ClearInMemorySpatialIndex()                     */
+/************************************************************************/
+
+void OGRShapeLayer::ClearInMemorySpatialIndex()
+
+{
+    if( m_hInMemorySPI != nullptr )
+    {
+        CPLQuadTreeDestroy( m_hInMemorySPI );
+        m_hInMemorySPI = nullptr;
+        ClearSpatialFIDs();
+    }
+    m_bInMemorySPITried = false;
+}
+
 /************************************************************************/
 /*                            CheckForSBN()                             */
 /************************************************************************/
@@ -598,12 +701,15 @@ bool OGRShapeLayer::ScanIndices()
             CPL_IGNORE_RET_VAL(CheckForQIX());
         if( hQIX == nullptr && !bCheckedForSBN )
             CPL_IGNORE_RET_VAL(CheckForSBN());
+        if( hQIX == nullptr && hSBN == nullptr )
+            CPL_IGNORE_RET_VAL(BuildInMemorySpatialIndex());
     }
 
 /* -------------------------------------------------------------------- */
 /*      Compute spatial index if appropriate.                           */
 /* -------------------------------------------------------------------- */
-    if( bTryQIXorSBN && (hQIX != nullptr || hSBN != nullptr) &&
+    if( bTryQIXorSBN &&
+        (hQIX != nullptr || hSBN != nullptr || m_hInMemorySPI != nullptr) &&
         panSpatialFIDs == nullptr )
     {
         double adfBoundsMin[4] = {
@@ -621,10 +727,29 @@ bool OGRShapeLayer::ScanIndices()
             panSpatialFIDs = SHPSearchDiskTreeEx( hQIX,
                                                   adfBoundsMin, adfBoundsMax,
                                                   &nSpatialFIDCount );
-        else
+        else if( hSBN != nullptr )
             panSpatialFIDs = SBNSearchDiskTree( hSBN,
                                                 adfBoundsMin, adfBoundsMax,
                                                 &nSpatialFIDCount );
+        else
+        {
+            CPLRectObj sAOI;
+            sAOI.minx = oSpatialFilterEnvelope.MinX;
+            sAOI.miny = oSpatialFilterEnvelope.MinY;
+            sAOI.maxx = oSpatialFilterEnvelope.MaxX;
+            sAOI.maxy = oSpatialFilterEnvelope.MaxY;
+            int nFeatureCount = 0;
+            void** pahFeatures =
+                CPLQuadTreeSearch( m_hInMemorySPI, &sAOI, &nFeatureCount );
+            panSpatialFIDs = static_cast<int *>(
+                malloc(sizeof(int) * std::max(1, nFeatureCount)));
+            for( int i = 0; i < nFeatureCount; i++ )
+                panSpatialFIDs[i] = static_cast<int>(
+                    reinterpret_cast<GUIntptr_t>(pahFeatures[i]));
+            std::sort(panSpatialFIDs, panSpatialFIDs + nFeatureCount);
+            nSpatialFIDCount = nFeatureCount;
+            CPLFree(pahFeatures);
+        }
 
         CPLDebug( "SHAPE", "Used spatial index, got %d matches.",
                   nSpatialFIDCount );
@@ -768,7 +893,30 @@ OGRErr OGRShapeLayer::SetAttributeFilter( const char * pszAttributeFilter )
 {
     ClearMatchingFIDs();
 
-    return OGRLayer::SetAttributeFilter(pszAttributeFilter);
+    const OGRErr eErr = OGRLayer::SetAttributeFilter(pszAttributeFilter);
+
+    // Check if the filter only references .dbf fields (or the FID), in
+    // which case GetNextFeature() can evaluate it on those fields alone,
+    // and skip decoding the geometry and other fields of rejected records.
+    m_anAttrQueryFields.clear();
+    m_bAttrQueryOnDBFOnly = false;
+    if( m_poAttrQuery != nullptr )
+    {
+        char** papszUsedFields = m_poAttrQuery->GetUsedFields();
+        m_bAttrQueryOnDBFOnly = papszUsedFields != nullptr;
+        for( char** papszIter = papszUsedFields;
+             papszIter && *papszIter; ++papszIter )
+        {
+            const int iField = poFeatureDefn->GetFieldIndex(*papszIter);
+            if( iField >= 0 )
+                m_anAttrQueryFields.push_back(iField);
+            else if( !EQUAL(*papszIter, "FID") )
+                m_bAttrQueryOnDBFOnly = false;
+        }
+        CSLDestroy(papszUsedFields);
+    }
+
+    return eErr;
 }
 
 /************************************************************************/
@@ -797,6 +945,90 @@ OGRErr OGRShapeLayer::SetNextByIndex( GIntBig nIndex )
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                           GetSHPMapping()                            */
+/*                                                                      */
+/*      Lazily map the whole .shp file in memory, so that records can   */
+/*      be translated in place instead of being fseek()/fread() into    */
+/*      a SHPObject. Returns nullptr if that is not possible.           */
+/************************************************************************/
+
+const GByte *OGRShapeLayer::GetSHPMapping( size_t &nSize )
+{
+    if( !m_bSHPMappingTried )
+    {
+        m_bSHPMappingTried = true;
+#ifdef CPL_LSB
+        if( hSHP != nullptr && !bUpdateAccess &&
+            CPLIsVirtualMemFileMapAvailable() &&
+            CPLTestBool(CPLGetConfigOption("SHAPE_USE_MMAP", "YES")) )
+        {
+            VSILFILE *fp = VSI_SHP_GetVSIL( hSHP->fpSHP );
+            if( VSIFGetNativeFileDescriptorL( fp ) != nullptr &&
+                VSIFSeekL( fp, 0, SEEK_END ) == 0 )
+            {
+                const vsi_l_offset nFileSize = VSIFTellL( fp );
+                if( nFileSize > 100 &&
+                    nFileSize == static_cast<size_t>(nFileSize) )
+                {
+                    CPLErrorStateBackuper oErrorStateBackuper;
+                    CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
+                    m_psSHPMapping = CPLVirtualMemFileMapNew(
+                        fp, 0, nFileSize, VIRTUALMEM_READONLY,
+                        nullptr, nullptr );
+                }
+                if( m_psSHPMapping == nullptr )
+                    CPLDebug( "Shape", "Cannot map %s in memory",
+                              pszFullName );
+            }
+        }
+#endif
+    }
+
+    if( m_psSHPMapping == nullptr )
+    {
+        nSize = 0;
+        return nullptr;
+    }
+    nSize = CPLVirtualMemGetSize( m_psSHPMapping );
+    return static_cast<const GByte*>(CPLVirtualMemGetAddr( m_psSHPMapping ));
+}
+
+/************************************************************************/
+/*                         ReleaseSHPMapping()                          */
+/************************************************************************/
+
+void OGRShapeLayer::ReleaseSHPMapping()
+{
+    if( m_psSHPMapping != nullptr )
+        CPLVirtualMemFree( m_psSHPMapping );
+    m_psSHPMapping = nullptr;
+    m_bSHPMappingTried = false;
+}
+
+/************************************************************************/
+/*                    EvaluateAttributeFilterOnDBF()                    */
+/*                                                                      */
+/*      Evaluate the attribute filter on a feature with only the .dbf   */
+/*      fields it references decoded.                                   */
+/************************************************************************/
+
+bool OGRShapeLayer::EvaluateAttributeFilterOnDBF( int iShapeId )
+{
+    // Let SHPReadOGRFeature() report invalid or deleted records.
+    if( iShapeId < 0 || iShapeId >= hDBF->nRecords ||
+        DBFIsRecordDeleted( hDBF, iShapeId ) )
+        return true;
+
+    OGRFeature oFeature( poFeatureDefn );
+    oFeature.SetFID( iShapeId );
+    for( const int iField : m_anAttrQueryFields )
+        SHPReadOGRFeatureField( hDBF, &oFeature, iShapeId, iField,
+                                osEncoding );
+
+    return CPL_TO_BOOL(m_poAttrQuery->Evaluate( &oFeature ));
+}
+
 /************************************************************************/
 /*                             FetchShape()                             */
 /*                                                                      */
@@ -809,7 +1041,36 @@ OGRFeature *OGRShapeLayer::FetchShape( int iShapeId )
 {
     OGRFeature *poFeature = nullptr;
 
-    if( m_poFilterGeom != nullptr && hSHP != nullptr )
+    if( m_bAttrQueryOnDBFOnly && m_poAttrQuery != nullptr &&
+        hDBF != nullptr && !EvaluateAttributeFilterOnDBF( iShapeId ) )
+    {
+        return nullptr;
+    }
+
+    size_t nMappingSize = 0;
+    const GByte *pabyMapping = GetSHPMapping( nMappingSize );
+
+    if( m_poFilterGeom != nullptr && pabyMapping != nullptr )
+    {
+        // Check the record bounding box in place, without translating it.
+        OGREnvelope sShapeEnvelope;
+        if( SHPGetMappedRecordEnvelope( hSHP, iShapeId, pabyMapping,
+                                        nMappingSize, sShapeEnvelope ) &&
+            (m_sFilterEnvelope.MaxX < sShapeEnvelope.MinX
+             || m_sFilterEnvelope.MaxY < sShapeEnvelope.MinY
+             || sShapeEnvelope.MaxX < m_sFilterEnvelope.MinX
+             || sShapeEnvelope.MaxY < m_sFilterEnvelope.MinY) )
+        {
+            poFeature = nullptr;
+        }
+        else
+        {
+            poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
+                                           iShapeId, nullptr, osEncoding,
+                                           pabyMapping, nMappingSize );
+        }
+    }
+    else if( m_poFilterGeom != nullptr && hSHP != nullptr )
     {
         SHPObject *psShape = SHPReadObject( hSHP, iShapeId );
 
@@ -843,7 +1104,8 @@ OGRFeature *OGRShapeLayer::FetchShape( int iShapeId )
     else
     {
         poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
-                                       iShapeId, nullptr, osEncoding );
+                                       iShapeId, nullptr, osEncoding,
+                                       pabyMapping, nMappingSize );
     }
 
     return poFeature;
@@ -923,8 +1185,11 @@ OGRFeature *OGRShapeLayer::GetNextFeature()
 
             m_nFeaturesRead++;
 
+            // The attribute filter has already been evaluated by
+            // FetchShape() when it only depends on .dbf fields.
             if( (m_poFilterGeom == nullptr || FilterGeometry( poGeom ) )
                 && (m_poAttrQuery == nullptr ||
+                    (m_bAttrQueryOnDBFOnly && hDBF != nullptr) ||
                     m_poAttrQuery->Evaluate( poFeature )) )
             {
                 return poFeature;
@@ -945,10 +1210,12 @@ OGRFeature *OGRShapeLayer::GetFeature( GIntBig nFeatureId )
     if( !TouchLayer() || nFeatureId > INT_MAX )
         return nullptr;
 
+    size_t nMappingSize = 0;
+    const GByte *pabyMapping = GetSHPMapping( nMappingSize );
     OGRFeature *poFeature =
         SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
                            static_cast<int>(nFeatureId), nullptr,
-                           osEncoding );
+                           osEncoding, pabyMapping, nMappingSize );
 
     if( poFeature == nullptr ) {
         // Reading shape feature failed.
@@ -1009,6 +1276,7 @@ OGRErr OGRShapeLayer::ISetFeature( OGRFeature *poFeature )
     bHeaderDirty = true;
     if( CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
+    ClearInMemorySpatialIndex();
 
     unsigned int nOffset = 0;
     unsigned int nSize = 0;
@@ -1085,6 +1353,7 @@ OGRErr OGRShapeLayer::DeleteFeature( GIntBig nFID )
     bHeaderDirty = true;
     if( CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
+    ClearInMemorySpatialIndex();
     m_eNeedRepack = YES;
 
     return OGRERR_NONE;
@@ -1109,6 +1378,7 @@ OGRErr OGRShapeLayer::ICreateFeature( OGRFeature *poFeature )
     bHeaderDirty = true;
     if( CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
+    ClearInMemorySpatialIndex();
 
     poFeature->SetFID( OGRNullFID );
 
@@ -2547,6 +2817,8 @@ OGRErr OGRShapeLayer::Repack()
     if( !StartUpdate("Repack") )
         return OGRERR_FAILURE;
 
+    ClearInMemorySpatialIndex();
+
 /* -------------------------------------------------------------------- */
 /*      Build a list of records to be dropped.                          */
 /* -------------------------------------------------------------------- */
@@ -2692,6 +2964,7 @@ OGRErr OGRShapeLayer::Repack()
 /* -------------------------------------------------------------------- */
     if( CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
+    ClearInMemorySpatialIndex();
 
 /* -------------------------------------------------------------------- */
 /*      Create a new dbf file, matching the old.                        */
@@ -3410,6 +3683,8 @@ void OGRShapeLayer::CloseUnderlyingLayer()
         DBFClose( hDBF );
     hDBF = nullptr;
 
+    ReleaseSHPMapping();
+
     if( hSHP != nullptr )
         SHPClose( hSHP );
     hSHP = nullptr;
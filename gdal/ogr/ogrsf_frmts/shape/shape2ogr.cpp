@@ -31,6 +31,7 @@
 #include "cpl_port.h"
 #include "ogrshape.h"
 
+#include <climits>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
@@ -42,6 +43,7 @@
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_string.h"
+#include "gdal_perf_counters.h"
 #include "ogr_core.h"
 #include "ogr_feature.h"
 #include "ogr_geometry.h"
@@ -391,6 +393,434 @@ OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape )
     return poOGR;
 }
 
+/************************************************************************/
+/*                         SHPGetMappedRecord()                         */
+/*                                                                      */
+/*      Return a pointer to the start (record header included) of a     */
+/*      record in a memory mapping of the whole .shp file, or nullptr   */
+/*      if it cannot be safely accessed that way, in which case the     */
+/*      caller must go through SHPReadObject().                         */
+/************************************************************************/
+
+static const GByte *SHPGetMappedRecord( SHPHandle hSHP, int iShape,
+                                        const GByte *pabyMapping,
+                                        size_t nMappingSize,
+                                        int &nEntitySize )
+{
+    if( pabyMapping == nullptr || iShape < 0 || iShape >= hSHP->nRecords )
+        return nullptr;
+
+    // A zero offset means that the .shx entry has not been loaded yet.
+    const size_t nOffset = hSHP->panRecOffset[iShape];
+    if( nOffset == 0 ||
+        hSHP->panRecSize[iShape] > static_cast<unsigned>(INT_MAX - 8) )
+        return nullptr;
+
+    nEntitySize = static_cast<int>(hSHP->panRecSize[iShape]) + 8;
+    if( nEntitySize < 8 + 4 || nOffset > nMappingSize ||
+        static_cast<size_t>(nEntitySize) > nMappingSize - nOffset )
+        return nullptr;
+
+    return pabyMapping + nOffset;
+}
+
+static int SHPGetMappedInt( const GByte *pabyData )
+{
+    int nVal = 0;
+    memcpy( &nVal, pabyData, 4 );
+    CPL_LSBPTR32( &nVal );
+    return nVal;
+}
+
+static double SHPGetMappedDouble( const GByte *pabyData )
+{
+    double dfVal = 0.0;
+    memcpy( &dfVal, pabyData, 8 );
+    CPL_LSBPTR64( &dfVal );
+    return dfVal;
+}
+
+static void SHPReportCorruptedRecord( int iShape, int nEntitySize )
+{
+    CPLError( CE_Failure, CPLE_AppDefined,
+              "Corrupted .shp file : shape %d : nEntitySize = %d",
+              iShape, nEntitySize );
+}
+
+/************************************************************************/
+/*                     SHPGetMappedRecordEnvelope()                     */
+/*                                                                      */
+/*      Fetch the bounding box of a record directly from the mapped     */
+/*      .shp. Returns false for null shapes, unreachable records, and   */
+/*      degenerate bounds of non-point shapes, that can't be trusted.   */
+/************************************************************************/
+
+bool SHPGetMappedRecordEnvelope( SHPHandle hSHP, int iShape,
+                                 const GByte *pabyMapping,
+                                 size_t nMappingSize,
+                                 OGREnvelope &sEnvelope )
+{
+    int nEntitySize = 0;
+    const GByte *pabyRec = SHPGetMappedRecord( hSHP, iShape, pabyMapping,
+                                               nMappingSize, nEntitySize );
+    if( pabyRec == nullptr )
+        return false;
+
+    const int nSHPType = SHPGetMappedInt( pabyRec + 8 );
+    if( nSHPType == SHPT_POINT || nSHPType == SHPT_POINTM ||
+        nSHPType == SHPT_POINTZ )
+    {
+        if( 20 + 8 > nEntitySize )
+            return false;
+        sEnvelope.MinX = SHPGetMappedDouble( pabyRec + 12 );
+        sEnvelope.MinY = SHPGetMappedDouble( pabyRec + 20 );
+        sEnvelope.MaxX = sEnvelope.MinX;
+        sEnvelope.MaxY = sEnvelope.MinY;
+        return true;
+    }
+
+    if( nSHPType == SHPT_NULL || 8 + 4 + 32 > nEntitySize )
+        return false;
+
+    sEnvelope.MinX = SHPGetMappedDouble( pabyRec + 8 + 4 );
+    sEnvelope.MinY = SHPGetMappedDouble( pabyRec + 8 + 12 );
+    sEnvelope.MaxX = SHPGetMappedDouble( pabyRec + 8 + 20 );
+    sEnvelope.MaxY = SHPGetMappedDouble( pabyRec + 8 + 28 );
+    return sEnvelope.MinX != sEnvelope.MaxX &&
+           sEnvelope.MinY != sEnvelope.MaxY;
+}
+
+/************************************************************************/
+/*                    SHPReadOGRObjectFromMapping()                     */
+/*                                                                      */
+/*      Equivalent of SHPReadOGRObject(), but translating the record    */
+/*      directly from a read-only memory mapping of the .shp file,      */
+/*      without going through an intermediate SHPObject. Coordinates    */
+/*      are copied straight from the record into the OGR geometry,      */
+/*      which requires a little-endian host.                            */
+/************************************************************************/
+
+OGRGeometry *SHPReadOGRObjectFromMapping( SHPHandle hSHP, int iShape,
+                                          const GByte *pabyMapping,
+                                          size_t nMappingSize )
+{
+#ifdef CPL_MSB
+    (void)pabyMapping;
+    (void)nMappingSize;
+    return SHPReadOGRObject( hSHP, iShape, nullptr );
+#else
+    int nEntitySize = 0;
+    const GByte *pabyRec = SHPGetMappedRecord( hSHP, iShape, pabyMapping,
+                                               nMappingSize, nEntitySize );
+    if( pabyRec == nullptr )
+        return SHPReadOGRObject( hSHP, iShape, nullptr );
+
+    const int nSHPType = SHPGetMappedInt( pabyRec + 8 );
+
+/* -------------------------------------------------------------------- */
+/*      Point.                                                          */
+/* -------------------------------------------------------------------- */
+    if( nSHPType == SHPT_POINT || nSHPType == SHPT_POINTM ||
+        nSHPType == SHPT_POINTZ )
+    {
+        int nOffset = 20 + 8;
+        if( nOffset + (nSHPType == SHPT_POINTZ ? 8 : 0) > nEntitySize )
+        {
+            SHPReportCorruptedRecord( iShape, nEntitySize );
+            return nullptr;
+        }
+
+        const double dfX = SHPGetMappedDouble( pabyRec + 12 );
+        const double dfY = SHPGetMappedDouble( pabyRec + 20 );
+        double dfZ = 0.0;
+        if( nSHPType == SHPT_POINTZ )
+        {
+            dfZ = SHPGetMappedDouble( pabyRec + nOffset );
+            nOffset += 8;
+        }
+        const bool bMeasureIsUsed = nEntitySize >= nOffset + 8;
+        const double dfM =
+            bMeasureIsUsed ? SHPGetMappedDouble( pabyRec + nOffset ) : 0.0;
+
+        if( nSHPType == SHPT_POINT )
+            return new OGRPoint( dfX, dfY );
+        if( nSHPType == SHPT_POINTZ )
+        {
+            if( bMeasureIsUsed )
+                return new OGRPoint( dfX, dfY, dfZ, dfM );
+            return new OGRPoint( dfX, dfY, dfZ );
+        }
+        OGRPoint *poPoint = new OGRPoint( dfX, dfY, 0.0, dfM );
+        poPoint->set3D(FALSE);
+        return poPoint;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Multipoint.                                                     */
+/* -------------------------------------------------------------------- */
+    if( nSHPType == SHPT_MULTIPOINT || nSHPType == SHPT_MULTIPOINTM ||
+        nSHPType == SHPT_MULTIPOINTZ )
+    {
+        if( 44 + 4 > nEntitySize )
+        {
+            SHPReportCorruptedRecord( iShape, nEntitySize );
+            return nullptr;
+        }
+        const GUInt32 nPoints =
+            static_cast<GUInt32>(SHPGetMappedInt( pabyRec + 44 ));
+        if( nPoints > 50 * 1000 * 1000 )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Corrupted .shp file : shape %d : nPoints = %u",
+                      iShape, nPoints );
+            return nullptr;
+        }
+        const int nVertices = static_cast<int>(nPoints);
+        int nRequiredSize = 48 + nVertices * 16;
+        if( nSHPType == SHPT_MULTIPOINTZ )
+            nRequiredSize += 16 + nVertices * 8;
+        if( nRequiredSize > nEntitySize )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Corrupted .shp file : shape %d : nPoints = %u, "
+                      "nEntitySize = %d",
+                      iShape, nPoints, nEntitySize );
+            return nullptr;
+        }
+        if( nVertices == 0 )
+            return nullptr;
+
+        const GByte *pabyXY = pabyRec + 48;
+        int nOffset = 48 + 16 * nVertices;
+        const GByte *pabyZ = nullptr;
+        if( nSHPType == SHPT_MULTIPOINTZ )
+        {
+            pabyZ = pabyRec + nOffset + 16;
+            nOffset += 16 + 8 * nVertices;
+        }
+        const GByte *pabyM = nullptr;
+        if( nEntitySize >= nOffset + 16 + 8 * nVertices )
+            pabyM = pabyRec + nOffset + 16;
+
+        OGRMultiPoint *poOGRMPoint = new OGRMultiPoint();
+        for( int i = 0; i < nVertices; i++ )
+        {
+            const double dfX = SHPGetMappedDouble( pabyXY + 16 * i );
+            const double dfY = SHPGetMappedDouble( pabyXY + 16 * i + 8 );
+            OGRPoint *poPoint = nullptr;
+            if( pabyZ )
+            {
+                const double dfZ = SHPGetMappedDouble( pabyZ + 8 * i );
+                if( pabyM )
+                    poPoint = new OGRPoint( dfX, dfY, dfZ,
+                                    SHPGetMappedDouble( pabyM + 8 * i ) );
+                else
+                    poPoint = new OGRPoint( dfX, dfY, dfZ );
+            }
+            else if( nSHPType == SHPT_MULTIPOINTM && pabyM )
+            {
+                poPoint = new OGRPoint( dfX, dfY, 0.0,
+                                        SHPGetMappedDouble( pabyM + 8 * i ) );
+                poPoint->set3D(FALSE);
+            }
+            else
+            {
+                poPoint = new OGRPoint( dfX, dfY );
+            }
+            poOGRMPoint->addGeometryDirectly( poPoint );
+        }
+        return poOGRMPoint;
+    }
+
+    if( nSHPType != SHPT_ARC && nSHPType != SHPT_ARCM &&
+        nSHPType != SHPT_ARCZ && nSHPType != SHPT_POLYGON &&
+        nSHPType != SHPT_POLYGONM && nSHPType != SHPT_POLYGONZ )
+    {
+        // Null shapes, multipatches, and unknown types.
+        return SHPReadOGRObject( hSHP, iShape, nullptr );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Arc and Polygon: validate part and point counts, and part       */
+/*      starts, as SHPReadObject() does.                                */
+/* -------------------------------------------------------------------- */
+    if( 40 + 8 + 4 > nEntitySize )
+    {
+        SHPReportCorruptedRecord( iShape, nEntitySize );
+        return nullptr;
+    }
+    const GUInt32 nPoints =
+        static_cast<GUInt32>(SHPGetMappedInt( pabyRec + 40 + 8 ));
+    const GUInt32 nParts =
+        static_cast<GUInt32>(SHPGetMappedInt( pabyRec + 36 + 8 ));
+    if( nPoints > 50 * 1000 * 1000 || nParts > 10 * 1000 * 1000 )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Corrupted .shp file : shape %d, nPoints=%u, nParts=%u.",
+                  iShape, nPoints, nParts );
+        return nullptr;
+    }
+    const int nVertices = static_cast<int>(nPoints);
+    const int nPartCount = static_cast<int>(nParts);
+    const bool bHasZ = nSHPType == SHPT_POLYGONZ || nSHPType == SHPT_ARCZ;
+    int nRequiredSize = 44 + 8 + 4 * nPartCount + 16 * nVertices;
+    if( bHasZ )
+        nRequiredSize += 16 + 8 * nVertices;
+    if( nRequiredSize > nEntitySize )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Corrupted .shp file : shape %d, nPoints=%u, nParts=%u, "
+                  "nEntitySize=%d.",
+                  iShape, nPoints, nParts, nEntitySize );
+        return nullptr;
+    }
+
+    const GByte *pabyPartStart = pabyRec + 44 + 8;
+    for( int i = 0; i < nPartCount; i++ )
+    {
+        const int nStart = SHPGetMappedInt( pabyPartStart + 4 * i );
+        if( nStart < 0 || (nStart >= nVertices && nVertices > 0) ||
+            (nStart > 0 && nVertices == 0) )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Corrupted .shp file : shape %d : panPartStart[%d] = %d, "
+                      "nVertices = %d",
+                      iShape, i, nStart, nVertices );
+            return nullptr;
+        }
+        if( i > 0 )
+        {
+            const int nPrevStart =
+                SHPGetMappedInt( pabyPartStart + 4 * (i - 1) );
+            if( nStart <= nPrevStart )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "Corrupted .shp file : shape %d : "
+                          "panPartStart[%d] = %d, panPartStart[%d] = %d",
+                          iShape, i, nStart, i - 1, nPrevStart );
+                return nullptr;
+            }
+        }
+    }
+
+    if( nPartCount == 0 )
+        return nullptr;
+
+    // setPoints() and setPointsM() only memcpy() from those arrays, so
+    // they can point into the record regardless of its alignment.
+    int nOffset = 44 + 8 + 4 * nPartCount;
+    const OGRRawPoint *paoXY =
+        reinterpret_cast<const OGRRawPoint *>(pabyRec + nOffset);
+    nOffset += 16 * nVertices;
+    const double *padfZ = nullptr;
+    if( bHasZ )
+    {
+        padfZ = reinterpret_cast<const double *>(pabyRec + nOffset + 16);
+        nOffset += 16 + 8 * nVertices;
+    }
+    const double *padfM = nullptr;
+    if( nEntitySize >= nOffset + 16 + 8 * nVertices )
+        padfM = reinterpret_cast<const double *>(pabyRec + nOffset + 16);
+
+    const auto GetPart = [pabyPartStart, nPartCount, nVertices](
+                                    int iPart, int &nStart, int &nCount )
+    {
+        nStart = SHPGetMappedInt( pabyPartStart + 4 * iPart );
+        const int nEnd = iPart == nPartCount - 1 ? nVertices :
+                    SHPGetMappedInt( pabyPartStart + 4 * (iPart + 1) );
+        nCount = nEnd - nStart;
+    };
+
+/* -------------------------------------------------------------------- */
+/*      Arc (LineString)                                                */
+/* -------------------------------------------------------------------- */
+    if( nSHPType == SHPT_ARC || nSHPType == SHPT_ARCM ||
+        nSHPType == SHPT_ARCZ )
+    {
+        OGRMultiLineString *poOGRMulti =
+            nPartCount > 1 ? new OGRMultiLineString() : nullptr;
+        OGRLineString *poOGRLine = nullptr;
+        for( int iPart = 0; iPart < nPartCount; iPart++ )
+        {
+            int nStart = 0;
+            int nCount = 0;
+            GetPart( iPart, nStart, nCount );
+
+            poOGRLine = new OGRLineString();
+            if( nSHPType == SHPT_ARCZ )
+                poOGRLine->setPoints( nCount, paoXY + nStart, padfZ + nStart,
+                                      padfM ? padfM + nStart : nullptr );
+            else if( nSHPType == SHPT_ARCM && padfM != nullptr )
+                poOGRLine->setPointsM( nCount, paoXY + nStart,
+                                       padfM + nStart );
+            else
+                poOGRLine->setPoints( nCount, paoXY + nStart );
+
+            if( poOGRMulti )
+                poOGRMulti->addGeometryDirectly( poOGRLine );
+        }
+        if( poOGRMulti )
+            return poOGRMulti;
+        return poOGRLine;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Polygon                                                         */
+/* -------------------------------------------------------------------- */
+    const bool bHasM = bHasZ || nSHPType == SHPT_POLYGONM;
+    OGRPolygon **tabPolygons = new OGRPolygon*[nPartCount];
+    for( int iPart = 0; iPart < nPartCount; iPart++ )
+    {
+        int nStart = 0;
+        int nCount = 0;
+        GetPart( iPart, nStart, nCount );
+
+        OGRLinearRing *poRing = new OGRLinearRing();
+        if( nCount > 0 )
+        {
+            if( bHasZ )
+                poRing->setPoints( nCount, paoXY + nStart, padfZ + nStart,
+                                   padfM ? padfM + nStart : nullptr );
+            else if( bHasM )
+                poRing->setPointsM( nCount, paoXY + nStart,
+                                    padfM ? padfM + nStart : nullptr );
+            else
+                poRing->setPoints( nCount, paoXY + nStart );
+        }
+        tabPolygons[iPart] = new OGRPolygon();
+        tabPolygons[iPart]->addRingDirectly( poRing );
+    }
+
+    OGRGeometry *poOGR = nullptr;
+    if( nPartCount == 1 )
+    {
+        // Surely outer ring.
+        poOGR = tabPolygons[0];
+    }
+    else
+    {
+        int isValidGeometry = FALSE;
+        const char* papszOptions[] = { "METHOD=ONLY_CCW", nullptr };
+        OGRGeometry **tabGeom = reinterpret_cast<OGRGeometry**>(tabPolygons);
+        poOGR = OGRGeometryFactory::organizePolygons(
+            tabGeom, nPartCount, &isValidGeometry, papszOptions );
+
+        if( !isValidGeometry )
+        {
+            CPLError(
+                CE_Warning, CPLE_AppDefined,
+                "Geometry of polygon of fid %d cannot be translated to "
+                "Simple Geometry. "
+                "All polygons will be contained in a multipolygon.",
+                iShape);
+        }
+    }
+    delete[] tabPolygons;
+
+    return poOGR;
+#endif
+}
+
 /************************************************************************/
 /*                      CheckNonFiniteCoordinates()                     */
 /************************************************************************/
@@ -1194,13 +1624,146 @@ OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
     return poDefn;
 }
 
+/************************************************************************/
+/*                          SHPIsDBFValueNull()                         */
+/*                                                                      */
+/*      Same test as DBFIsAttributeNULL(), but on a value that has      */
+/*      already been fetched with DBFReadStringAttribute(), so that     */
+/*      each field is only extracted once from the record.              */
+/************************************************************************/
+
+static bool SHPIsDBFValueNull( char chType, const char *pszValue )
+{
+    if( pszValue == nullptr )
+        return true;
+
+    switch( chType )
+    {
+      case 'N':
+      case 'F':
+        // All asterisks or all blanks (trimmed on read).
+        return pszValue[0] == '*' || pszValue[0] == '\0';
+
+      case 'D':
+        return strncmp(pszValue, "00000000", 8) == 0;
+
+      case 'L':
+        return pszValue[0] == '?';
+
+      default:
+        return pszValue[0] == '\0';
+    }
+}
+
+/************************************************************************/
+/*                        SHPReadOGRFeatureField()                      */
+/*                                                                      */
+/*      Decode a single attribute of a DBF record into a feature.       */
+/*      Ignored fields are left unset.                                  */
+/************************************************************************/
+
+void SHPReadOGRFeatureField( DBFHandle hDBF, OGRFeature *poFeature,
+                             int iShape, int iField,
+                             const char *pszSHPEncoding )
+{
+    const OGRFieldDefn * const poFieldDefn = poFeature->GetFieldDefnRef(iField);
+    if( poFieldDefn->IsIgnored() )
+        return;
+
+    switch( poFieldDefn->GetType() )
+    {
+      case OFTString:
+      {
+          const char * const pszFieldVal =
+              DBFReadStringAttribute( hDBF, iShape, iField );
+          if( pszFieldVal != nullptr && pszFieldVal[0] != '\0' )
+          {
+            if( pszSHPEncoding[0] != '\0' )
+            {
+                char * const pszUTF8Field =
+                    CPLRecode( pszFieldVal, pszSHPEncoding, CPL_ENC_UTF8);
+                poFeature->SetField( iField, pszUTF8Field );
+                CPLFree( pszUTF8Field );
+            }
+            else
+                poFeature->SetField( iField, pszFieldVal );
+          }
+          else
+          {
+              poFeature->SetFieldNull(iField);
+          }
+          break;
+      }
+      case OFTInteger:
+      case OFTInteger64:
+      case OFTReal:
+      {
+          const char * const pszFieldVal =
+              DBFReadStringAttribute( hDBF, iShape, iField );
+          if( SHPIsDBFValueNull( DBFGetNativeFieldType( hDBF, iField ),
+                                 pszFieldVal ) )
+          {
+              poFeature->SetFieldNull(iField);
+          }
+          else
+          {
+              poFeature->SetField( iField, pszFieldVal );
+          }
+          break;
+      }
+      case OFTDate:
+      {
+          const char* const pszDateValue =
+              DBFReadStringAttribute(hDBF,iShape,iField);
+          if( SHPIsDBFValueNull( DBFGetNativeFieldType( hDBF, iField ),
+                                 pszDateValue ) )
+          {
+              poFeature->SetFieldNull(iField);
+              break;
+          }
+
+          // Some DBF files have fields filled with spaces
+          // (trimmed by DBFReadStringAttribute) to indicate null
+          // values for dates (#4265).
+          if( pszDateValue[0] == '\0' )
+              break;
+
+          OGRField sFld;
+          memset( &sFld, 0, sizeof(sFld) );
+
+          if( strlen(pszDateValue) >= 10 &&
+              pszDateValue[2] == '/' && pszDateValue[5] == '/' )
+          {
+              sFld.Date.Month = static_cast<GByte>(atoi(pszDateValue + 0));
+              sFld.Date.Day   = static_cast<GByte>(atoi(pszDateValue + 3));
+              sFld.Date.Year  = static_cast<GInt16>(atoi(pszDateValue + 6));
+          }
+          else
+          {
+              const int nFullDate = atoi(pszDateValue);
+              sFld.Date.Year = static_cast<GInt16>(nFullDate / 10000);
+              sFld.Date.Month = static_cast<GByte>((nFullDate / 100) % 100);
+              sFld.Date.Day = static_cast<GByte>(nFullDate % 100);
+          }
+
+          poFeature->SetField( iField, &sFld );
+          break;
+      }
+
+      default:
+        CPLAssert( false );
+    }
+}
+
 /************************************************************************/
 /*                         SHPReadOGRFeature()                          */
 /************************************************************************/
 
 OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                                OGRFeatureDefn * poDefn, int iShape,
-                               SHPObject *psShape, const char *pszSHPEncoding )
+                               SHPObject *psShape, const char *pszSHPEncoding,
+                               const GByte *pabySHPMapping,
+                               size_t nSHPMappingSize )
 
 {
     if( iShape < 0
@@ -1226,6 +1789,9 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
 
     OGRFeature  *poFeature = new OGRFeature( poDefn );
 
+    GDAL_PERF_COUNTER(poFeaturesCounter, "ESRI Shapefile.features_read");
+    poFeaturesCounter->Increment();
+
 /* -------------------------------------------------------------------- */
 /*      Fetch geometry from Shapefile to OGRFeature.                    */
 /* -------------------------------------------------------------------- */
@@ -1233,8 +1799,17 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
     {
         if( !poDefn->IsGeometryIgnored() )
         {
-            OGRGeometry* poGeometry =
-                SHPReadOGRObject( hSHP, iShape, psShape );
+            OGRGeometry* poGeometry;
+            {
+                GDAL_PERF_COUNTER(poGeomTimeCounter,
+                                  "ESRI Shapefile.geometry_parse_time_ns");
+                GDALPerfCounterTimer oTimer(poGeomTimeCounter);
+                poGeometry =
+                    psShape == nullptr && pabySHPMapping != nullptr ?
+                    SHPReadOGRObjectFromMapping( hSHP, iShape, pabySHPMapping,
+                                                 nSHPMappingSize ) :
+                    SHPReadOGRObject( hSHP, iShape, psShape );
+            }
 
             // Two possibilities are expected here (both are tested by
             // GDAL Autotests):
@@ -1284,97 +1859,12 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
 /* -------------------------------------------------------------------- */
 /*      Fetch feature attributes to OGRFeature fields.                  */
 /* -------------------------------------------------------------------- */
-
     for( int iField = 0;
          hDBF != nullptr && iField < poDefn->GetFieldCount();
          iField++ )
     {
-        const OGRFieldDefn * const poFieldDefn = poDefn->GetFieldDefn(iField);
-        if( poFieldDefn->IsIgnored() )
-            continue;
-
-        switch( poFieldDefn->GetType() )
-        {
-          case OFTString:
-          {
-              const char * const pszFieldVal =
-                  DBFReadStringAttribute( hDBF, iShape, iField );
-              if( pszFieldVal != nullptr && pszFieldVal[0] != '\0' )
-              {
-                if( pszSHPEncoding[0] != '\0' )
-                {
-                    char * const pszUTF8Field =
-                        CPLRecode( pszFieldVal, pszSHPEncoding, CPL_ENC_UTF8);
-                    poFeature->SetField( iField, pszUTF8Field );
-                    CPLFree( pszUTF8Field );
-                }
-                else
-                    poFeature->SetField( iField, pszFieldVal );
-              }
-              else
-              {
-                  poFeature->SetFieldNull(iField);
-              }
-              break;
-          }
-          case OFTInteger:
-          case OFTInteger64:
-          case OFTReal:
-          {
-              if( DBFIsAttributeNULL( hDBF, iShape, iField ) )
-              {
-                  poFeature->SetFieldNull(iField);
-              }
-              else
-              {
-                  poFeature->SetField(
-                      iField,
-                      DBFReadStringAttribute( hDBF, iShape, iField ) );
-              }
-              break;
-          }
-          case OFTDate:
-          {
-              if( DBFIsAttributeNULL( hDBF, iShape, iField ) )
-              {
-                  poFeature->SetFieldNull(iField);
-                  continue;
-              }
-
-              const char* const pszDateValue =
-                  DBFReadStringAttribute(hDBF,iShape,iField);
-
-              // Some DBF files have fields filled with spaces
-              // (trimmed by DBFReadStringAttribute) to indicate null
-              // values for dates (#4265).
-              if( pszDateValue[0] == '\0' )
-                  continue;
-
-              OGRField sFld;
-              memset( &sFld, 0, sizeof(sFld) );
-
-              if( strlen(pszDateValue) >= 10 &&
-                  pszDateValue[2] == '/' && pszDateValue[5] == '/' )
-              {
-                  sFld.Date.Month = static_cast<GByte>(atoi(pszDateValue + 0));
-                  sFld.Date.Day   = static_cast<GByte>(atoi(pszDateValue + 3));
-                  sFld.Date.Year  = static_cast<GInt16>(atoi(pszDateValue + 6));
-              }
-              else
-              {
-                  const int nFullDate = atoi(pszDateValue);
-                  sFld.Date.Year = static_cast<GInt16>(nFullDate / 10000);
-                  sFld.Date.Month = static_cast<GByte>((nFullDate / 100) % 100);
-                  sFld.Date.Day = static_cast<GByte>(nFullDate % 100);
-              }
-
-              poFeature->SetField( iField, &sFld );
-          }
-          break;
-
-          default:
-            CPLAssert( false );
-        }
+        SHPReadOGRFeatureField( hDBF, poFeature, iShape, iField,
+                                pszSHPEncoding );
     }
 
     if( poFeature != nullptr )
@@ -754,6 +754,8 @@ class OGRSQLiteBaseDataSource CPL_NON_FINAL: public GDALPamDataset
 
     virtual void        *GetInternalHandle( const char * ) override;
 
+    virtual GIntBig     GetDriverMemoryUsage() override;
+
     OGRErr              SoftStartTransaction();
     OGRErr              SoftCommitTransaction();
     OGRErr              SoftRollbackTransaction();
@@ -939,6 +939,27 @@ void *OGRSQLiteBaseDataSource::GetInternalHandle( const char * pszKey )
     return nullptr;
 }
 
+/************************************************************************/
+/*                        GetDriverMemoryUsage()                        */
+/************************************************************************/
+
+GIntBig OGRSQLiteBaseDataSource::GetDriverMemoryUsage()
+{
+    GIntBig nTotal = GDALPamDataset::GetDriverMemoryUsage();
+    if( hDB )
+    {
+        // Page cache of the database connection
+        int nCurrent = 0;
+        int nHighWater = 0;
+        if( sqlite3_db_status(hDB, SQLITE_DBSTATUS_CACHE_USED,
+                              &nCurrent, &nHighWater, FALSE) == SQLITE_OK )
+        {
+            nTotal += nCurrent;
+        }
+    }
+    return nTotal;
+}
+
 
 /************************************************************************/
 /*                               Create()                               */
@@ -346,6 +346,9 @@ typedef struct
 
     GByte         *pabyGeomBLOB;
     int            nGeomBLOBLen;
+
+    /* Whether SetIgnoredFields() has been called on poLayer */
+    int            bIgnoredFieldsSet;
 } OGR2SQLITE_vtab_cursor;
 
 /************************************************************************/
@@ -837,12 +840,28 @@ int OGR2SQLITE_BestIndex(sqlite3_vtab *pVTab, sqlite3_index_info* pIndex)
         }
     }
 
+    /* colUsed is available since SQLite 3.10. It enables us to ask the */
+    /* layer to skip the fields, and above all the geometries, that the */
+    /* query does not need. */
+    bool bHasColUsed = false;
+    sqlite3_uint64 nColUsed = 0;
+#if SQLITE_VERSION_NUMBER >= 3010000L
+    if( sqlite3_libversion_number() >= 3010000 &&
+        pMyVTab->poLayer->TestCapability(OLCIgnoreFields) )
+    {
+        bHasColUsed = true;
+        nColUsed = pIndex->colUsed;
+    }
+#endif
+
     int* panConstraints = nullptr;
 
-    if( nConstraints )
+    if( nConstraints || bHasColUsed )
     {
+        /* Layout: nConstraints, (column, operator) * nConstraints, */
+        /* and if idxNum == 1, the low and high 32 bits of colUsed */
         panConstraints = (int*)
-                    sqlite3_malloc( (int)sizeof(int) * (1 + 2 * nConstraints) );
+                    sqlite3_malloc( (int)sizeof(int) * (1 + 2 * nConstraints + 2) );
         panConstraints[0] = nConstraints;
 
         nConstraints = 0;
@@ -864,7 +883,16 @@ int OGR2SQLITE_BestIndex(sqlite3_vtab *pVTab, sqlite3_index_info* pIndex)
     pIndex->orderByConsumed = FALSE;
     pIndex->idxNum = 0;
 
-    if (nConstraints != 0)
+    if( bHasColUsed )
+    {
+        panConstraints[2 * nConstraints + 1] =
+            static_cast<int>(static_cast<GUInt32>(nColUsed));
+        panConstraints[2 * nConstraints + 2] =
+            static_cast<int>(static_cast<GUInt32>(nColUsed >> 32));
+        pIndex->idxNum = 1;
+    }
+
+    if (panConstraints != nullptr)
     {
         pIndex->idxStr = (char *) panConstraints;
         pIndex->needToFreeIdxStr = TRUE;
@@ -978,6 +1006,8 @@ int OGR2SQLITE_Close(sqlite3_vtab_cursor* pCursor)
     pMyVTab->nMyRef --;
 
     delete pMyCursor->poFeature;
+    if( pMyCursor->bIgnoredFieldsSet && pMyCursor->poDupDataSource == nullptr )
+        pMyCursor->poLayer->SetIgnoredFields(nullptr);
     delete pMyCursor->poDupDataSource;
 
     CPLFree(pMyCursor->pabyGeomBLOB);
@@ -987,13 +1017,74 @@ int OGR2SQLITE_Close(sqlite3_vtab_cursor* pCursor)
     return SQLITE_OK;
 }
 
+/************************************************************************/
+/*                     OGR2SQLITE_SetIgnoredFields()                    */
+/************************************************************************/
+
+/* Ignore the fields and geometry fields that are neither in the colUsed */
+/* mask computed by SQLite, nor in the constraints translated into the */
+/* attribute filter. */
+static void OGR2SQLITE_SetIgnoredFields(OGR2SQLITE_vtab_cursor* pMyCursor,
+                                        sqlite3_uint64 nColUsed,
+                                        const int* panConstraints)
+{
+    const auto IsUsed = [nColUsed, panConstraints](int iCol)
+    {
+        /* The last bit stands for all columns beyond the 63th */
+        if( (nColUsed & (static_cast<sqlite3_uint64>(1) << std::min(iCol, 63))) != 0 )
+            return true;
+        for( int i = 0; i < panConstraints[0]; i++ )
+        {
+            if( panConstraints[2 * i + 1] == iCol )
+                return true;
+        }
+        return false;
+    };
+
+    OGRLayer* poLayer = pMyCursor->poLayer;
+    OGRFeatureDefn* poFDefn = poLayer->GetLayerDefn();
+    const int nFieldCount = poFDefn->GetFieldCount();
+    CPLStringList aosIgnoredFields;
+    for( int i = 0; i < nFieldCount; i++ )
+    {
+        const char* pszName = poFDefn->GetFieldDefn(i)->GetNameRef();
+        /* Field names are looked up case insensitively by */
+        /* SetIgnoredFields(), so skip ambiguous ones */
+        if( !IsUsed(i) && poFDefn->GetFieldIndex(pszName) == i )
+            aosIgnoredFields.AddString(pszName);
+    }
+    if( !IsUsed(nFieldCount) )
+        aosIgnoredFields.AddString("OGR_STYLE");
+    for( int i = 0; i < poFDefn->GetGeomFieldCount(); i++ )
+    {
+        if( !IsUsed(nFieldCount + 1 + i) )
+        {
+            const char* pszName = poFDefn->GetGeomFieldDefn(i)->GetNameRef();
+            if( i == 0 && pszName[0] == '\0' )
+                aosIgnoredFields.AddString("OGR_GEOMETRY");
+            else if( poFDefn->GetGeomFieldIndex(pszName) == i )
+                aosIgnoredFields.AddString(pszName);
+        }
+    }
+
+#ifdef DEBUG_OGR2SQLITE
+    CPLDebug("OGR2SQLITE", "%d ignored field(s)", aosIgnoredFields.size());
+#endif
+
+    if( aosIgnoredFields.empty() && !pMyCursor->bIgnoredFieldsSet )
+        return;
+    poLayer->SetIgnoredFields(
+        const_cast<const char**>(aosIgnoredFields.List()));
+    pMyCursor->bIgnoredFieldsSet = TRUE;
+}
+
 /************************************************************************/
 /*                          OGR2SQLITE_Filter()                         */
 /************************************************************************/
 
 static
 int OGR2SQLITE_Filter(sqlite3_vtab_cursor* pCursor,
-                      CPL_UNUSED int idxNum,
+                      int idxNum,
                       const char *idxStr,
                       int argc,
                       sqlite3_value **argv)
@@ -1142,6 +1233,15 @@ int OGR2SQLITE_Filter(sqlite3_vtab_cursor* pCursor,
         return SQLITE_ERROR;
     }
 
+    if( idxNum == 1 )
+    {
+        const sqlite3_uint64 nColUsed =
+            static_cast<GUInt32>(panConstraints[2 * nConstraints + 1]) |
+            (static_cast<sqlite3_uint64>(
+                static_cast<GUInt32>(panConstraints[2 * nConstraints + 2])) << 32);
+        OGR2SQLITE_SetIgnoredFields(pMyCursor, nColUsed, panConstraints);
+    }
+
     if( pMyCursor->poLayer->TestCapability(OLCFastFeatureCount) )
         pMyCursor->nFeatureCount = pMyCursor->poLayer->GetFeatureCount();
     else
@@ -348,6 +348,12 @@ OGRLayer *OGRVRTDataSource::InstantiateWarpedLayer(
                            CPLAtof(pszExtentYMax));
     }
 
+    // Cache of warped geometries.
+    const char *pszGeomCacheSize =
+        CPLGetXMLValue(psLTree, "GeometryCacheSize", nullptr);
+    if( pszGeomCacheSize != nullptr )
+        poLayer->SetGeometryCacheSize(atoi(pszGeomCacheSize));
+
     return poLayer;
 }
 
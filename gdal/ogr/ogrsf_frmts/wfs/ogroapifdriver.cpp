@@ -34,9 +34,13 @@
 #include "parsexsd.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <memory>
-#include <vector>
+#include <mutex>
 #include <set>
+#include <thread>
+#include <vector>
 
 // g++ -Wshadow -Wextra -std=c++11 -fPIC -g -Wall ogr/ogrsf_frmts/wfs/ogroapif*.cpp -shared -o ogr_OAPIF.so -Iport -Igcore -Iogr -Iogr/ogrsf_frmts -Iogr/ogrsf_frmts/gml -Iogr/ogrsf_frmts/wfs -L. -lgdal
 
@@ -64,6 +68,7 @@ class OGROAPIFDataset final: public GDALDataset
         CPLString                              m_osUserQueryParams;
         CPLString                              m_osUserPwd;
         int                                    m_nPageSize = 10;
+        int                                    m_nPrefetchPages = 0;
         std::vector<std::unique_ptr<OGRLayer>> m_apoLayers;
 
         bool                                   m_bAPIDocLoaded = false;
@@ -79,13 +84,15 @@ class OGROAPIFDataset final: public GDALDataset
             const char* pszAccept,
             CPLString& osResult,
             CPLString& osContentType,
-            CPLStringList* paosHeaders = nullptr );
+            CPLStringList* paosHeaders = nullptr,
+            const char* pszPersistentName = nullptr );
 
         bool                    DownloadJSon(
             const CPLString& osURL,
             CPLJSONDocument& oDoc,
             const char* pszAccept = MEDIA_TYPE_GEOJSON ", " MEDIA_TYPE_JSON,
-            CPLStringList* paosHeaders = nullptr);
+            CPLStringList* paosHeaders = nullptr,
+            const char* pszPersistentName = nullptr );
 
         bool LoadJSONCollection(const CPLJSONObject& oCollection);
         bool LoadJSONCollections(const CPLString& osResultIn);
@@ -142,6 +149,34 @@ class OGROAPIFLayer final: public OGRLayer
         CPLJSONDocument m_oCurDoc{};
         int             m_iFeatureInPage = 0;
 
+        // A page of features, downloaded and opened with the GeoJSON driver.
+        struct Page
+        {
+            bool            bOK = false;
+            CPLJSONDocument oDoc{};
+            std::unique_ptr<GDALDataset> poDS{};
+            CPLString       osNextURL{};
+            CPLErr          eErrClass = CE_None;
+            CPLErrorNum     nErrNum = CPLE_None;
+            CPLString       osErrMsg{};
+        };
+
+        // Prefetching of the next pages by a background thread, which
+        // follows the next links, and keeps up to m_poDS->m_nPrefetchPages
+        // pages ahead of the one being read.
+        std::thread     m_oPrefetchThread{};
+        std::mutex      m_oPrefetchMutex{};
+        std::condition_variable m_oPrefetchCV{};
+        std::deque<std::unique_ptr<Page>> m_apoPrefetchedPages{};
+        bool            m_bStopPrefetching = false;
+        bool            m_bPrefetchingDone = false;
+
+        std::unique_ptr<Page> FetchPage(const CPLString& osURL,
+                                        const char* pszPersistentName);
+        std::unique_ptr<Page> GetNextPage();
+        void            PrefetchThreadFunc(CPLString osURL);
+        void            StopPrefetching();
+
         void            EstablishFeatureDefn();
         OGRFeature     *GetNextRawFeature();
         CPLString       AddFilters(const CPLString& osURL);
@@ -278,7 +313,8 @@ bool OGROAPIFDataset::Download(
             const char* pszAccept,
             CPLString& osResult,
             CPLString& osContentType,
-            CPLStringList* paosHeaders )
+            CPLStringList* paosHeaders,
+            const char* pszPersistentName )
 {
 #ifndef REMOVE_HACK
     VSIStatBufL sStatBuf;
@@ -301,9 +337,18 @@ bool OGROAPIFDataset::Download(
         papszOptions = CSLSetNameValue(papszOptions,
                                        "USERPWD", m_osUserPwd.c_str());
     }
-    m_bMustCleanPersistent = true;
-    papszOptions =
-        CSLAddString(papszOptions, CPLSPrintf("PERSISTENT=OAPIF:%p", this));
+    if( pszPersistentName )
+    {
+        // Connection used by another thread, and closed by its owner.
+        papszOptions = CSLSetNameValue(papszOptions,
+                                       "PERSISTENT", pszPersistentName);
+    }
+    else
+    {
+        m_bMustCleanPersistent = true;
+        papszOptions =
+            CSLAddString(papszOptions, CPLSPrintf("PERSISTENT=OAPIF:%p", this));
+    }
     CPLString osURLWithQueryParameters(osURL);
     if( !m_osUserQueryParams.empty() &&
         osURL.find('?' + m_osUserQueryParams) == std::string::npos &&
@@ -424,11 +469,13 @@ bool OGROAPIFDataset::Download(
 bool OGROAPIFDataset::DownloadJSon(const CPLString& osURL,
                                   CPLJSONDocument& oDoc,
                                   const char* pszAccept,
-                                  CPLStringList* paosHeaders)
+                                  CPLStringList* paosHeaders,
+                                  const char* pszPersistentName)
 {
     CPLString osResult;
     CPLString osContentType;
-    if( !Download(osURL, pszAccept, osResult, osContentType, paosHeaders) )
+    if( !Download(osURL, pszAccept, osResult, osContentType, paosHeaders,
+                  pszPersistentName) )
         return false;
     return oDoc.LoadMemory( osResult );
 }
@@ -752,6 +799,9 @@ bool OGROAPIFDataset::Open(GDALOpenInfo* poOpenInfo)
                              "FALSE"));
     m_nPageSize = atoi( CSLFetchNameValueDef(poOpenInfo->papszOpenOptions,
                             "PAGE_SIZE",CPLSPrintf("%d", m_nPageSize)) );
+    m_nPrefetchPages = std::max(0, std::min(100,
+        atoi( CSLFetchNameValueDef(poOpenInfo->papszOpenOptions,
+                                   "PREFETCH_PAGES", "0") )));
     m_osUserPwd =
         CSLFetchNameValueDef(poOpenInfo->papszOpenOptions, "USERPWD", "");
     CPLString osResult;
@@ -930,6 +980,7 @@ OGROAPIFLayer::OGROAPIFLayer(OGROAPIFDataset* poDS,
 
 OGROAPIFLayer::~OGROAPIFLayer()
 {
+    StopPrefetching();
     m_poFeatureDefn->Release();
 }
 
@@ -1336,6 +1387,7 @@ void OGROAPIFLayer::EstablishFeatureDefn()
 
 void OGROAPIFLayer::ResetReading()
 {
+    StopPrefetching();
     m_poUnderlyingDS.reset();
     m_poUnderlyingLayer = nullptr;
     m_nFID = 1;
@@ -1399,126 +1451,265 @@ CPLString OGROAPIFLayer::AddFilters(const CPLString& osURL)
 }
 
 /************************************************************************/
-/*                         GetNextRawFeature()                          */
+/*                             FetchPage()                              */
+/*                                                                      */
+/*      Download a page of features, open it with the GeoJSON driver    */
+/*      and find the link to the next page. May be called from the      */
+/*      prefetching thread, hence it must not modify the layer state.   */
 /************************************************************************/
 
-OGRFeature* OGROAPIFLayer::GetNextRawFeature()
+std::unique_ptr<OGROAPIFLayer::Page> OGROAPIFLayer::FetchPage(
+                    const CPLString& osURL, const char* pszPersistentName)
 {
-    if( !m_bFeatureDefnEstablished )
-        EstablishFeatureDefn();
+    std::unique_ptr<Page> poPage(new Page());
 
-    OGRFeature* poSrcFeature = nullptr;
-    while( true )
+    CPLStringList aosHeaders;
+    if( !m_poDS->DownloadJSon(osURL, poPage->oDoc,
+                              MEDIA_TYPE_GEOJSON ", " MEDIA_TYPE_JSON,
+                              &aosHeaders, pszPersistentName) )
     {
-        if( m_poUnderlyingLayer == nullptr )
-        {
-            if( m_osGetURL.empty() )
-                return nullptr;
-
-            m_oCurDoc = CPLJSONDocument();
-
-            CPLString osURL(m_osGetURL);
-            m_osGetURL.clear();
-            CPLStringList aosHeaders;
-            if( !m_poDS->DownloadJSon(osURL, m_oCurDoc,
-                                      MEDIA_TYPE_GEOJSON ", " MEDIA_TYPE_JSON,
-                                      &aosHeaders) )
-            {
-                return nullptr;
-            }
+        return nullptr;
+    }
 
-            CPLString osTmpFilename(CPLSPrintf("/vsimem/oapif_%p.json", this));
-            m_oCurDoc.Save(osTmpFilename);
-            m_poUnderlyingDS = std::unique_ptr<GDALDataset>(
-            reinterpret_cast<GDALDataset*>(
-                GDALOpenEx(osTmpFilename, GDAL_OF_VECTOR | GDAL_OF_INTERNAL,
-                        nullptr, nullptr, nullptr)));
-            VSIUnlink(osTmpFilename);
-            if( !m_poUnderlyingDS.get() )
-            {
-                return nullptr;
-            }
-            m_poUnderlyingLayer = m_poUnderlyingDS->GetLayer(0);
-            if( !m_poUnderlyingLayer )
-            {
-                m_poUnderlyingDS.reset();
-                return nullptr;
-            }
+    CPLString osTmpFilename(CPLSPrintf("/vsimem/oapif_%p.json", poPage.get()));
+    poPage->oDoc.Save(osTmpFilename);
+    poPage->poDS = std::unique_ptr<GDALDataset>(
+        reinterpret_cast<GDALDataset*>(
+            GDALOpenEx(osTmpFilename, GDAL_OF_VECTOR | GDAL_OF_INTERNAL,
+                    nullptr, nullptr, nullptr)));
+    VSIUnlink(osTmpFilename);
+    if( !poPage->poDS.get() )
+    {
+        return nullptr;
+    }
+    if( !poPage->poDS->GetLayer(0) )
+    {
+        return nullptr;
+    }
 
-            // To avoid issues with implementations having a non-relevant
-            // next link, make sure the current page is not empty
-            // We could even check that the feature count is the page size
-            // actually
-            if( m_poUnderlyingLayer->GetFeatureCount() > 0 && m_osGetID.empty() )
+    // To avoid issues with implementations having a non-relevant
+    // next link, make sure the current page is not empty
+    // We could even check that the feature count is the page size
+    // actually
+    if( poPage->poDS->GetLayer(0)->GetFeatureCount() > 0 && m_osGetID.empty() )
+    {
+        CPLJSONArray oLinks = poPage->oDoc.GetRoot().GetArray("links");
+        if( oLinks.IsValid() )
+        {
+            int nCountRelNext = 0;
+            CPLString osNextURL;
+            for( int i = 0; i < oLinks.Size(); i++ )
             {
-                CPLJSONArray oLinks = m_oCurDoc.GetRoot().GetArray("links");
-                if( oLinks.IsValid() )
+                CPLJSONObject oLink = oLinks[i];
+                if( !oLink.IsValid() ||
+                    oLink.GetType() != CPLJSONObject::Type::Object )
+                {
+                    continue;
+                }
+                if( oLink.GetString("rel") == "next" )
                 {
-                    int nCountRelNext = 0;
-                    CPLString osNextURL;
-                    for( int i = 0; i < oLinks.Size(); i++ )
+                    nCountRelNext ++;
+                    auto type = oLink.GetString("type");
+                    if (type == MEDIA_TYPE_GEOJSON ||
+                        type == MEDIA_TYPE_JSON )
                     {
-                        CPLJSONObject oLink = oLinks[i];
-                        if( !oLink.IsValid() ||
-                            oLink.GetType() != CPLJSONObject::Type::Object )
-                        {
-                            continue;
-                        }
-                        if( oLink.GetString("rel") == "next" )
-                        {
-                            nCountRelNext ++;
-                            auto type = oLink.GetString("type");
-                            if (type == MEDIA_TYPE_GEOJSON ||
-                                type == MEDIA_TYPE_JSON )
-                            {
-                                m_osGetURL = oLink.GetString("href");
-                                break;
-                            }
-                            else if( type.empty() )
-                            {
-                                osNextURL = oLink.GetString("href");
-                            }
-                        }
+                        poPage->osNextURL = oLink.GetString("href");
+                        break;
                     }
-                    if( nCountRelNext == 1 && m_osGetURL.empty() )
+                    else if( type.empty() )
                     {
-                        // In case we go a "rel": "next" without a "type"
-                        m_osGetURL = osNextURL;
+                        osNextURL = oLink.GetString("href");
                     }
                 }
+            }
+            if( nCountRelNext == 1 && poPage->osNextURL.empty() )
+            {
+                // In case we go a "rel": "next" without a "type"
+                poPage->osNextURL = osNextURL;
+            }
+        }
 
 #ifdef no_longer_used
-                // Recommendation /rec/core/link-header
-                if( m_osGetURL.empty() )
+        // Recommendation /rec/core/link-header
+        if( poPage->osNextURL.empty() )
+        {
+            for( int i = 0; i < aosHeaders.size(); i++ )
+            {
+                CPLDebug("OAPIF", "%s", aosHeaders[i]);
+                if( STARTS_WITH_CI(aosHeaders[i], "Link=") &&
+                    strstr(aosHeaders[i], "rel=\"next\"") &&
+                    strstr(aosHeaders[i], "type=\"" MEDIA_TYPE_GEOJSON "\"") )
                 {
-                    for( int i = 0; i < aosHeaders.size(); i++ )
+                    const char* pszStart = strchr(aosHeaders[i], '<');
+                    if( pszStart )
                     {
-                        CPLDebug("OAPIF", "%s", aosHeaders[i]);
-                        if( STARTS_WITH_CI(aosHeaders[i], "Link=") &&
-                            strstr(aosHeaders[i], "rel=\"next\"") &&
-                            strstr(aosHeaders[i], "type=\"" MEDIA_TYPE_GEOJSON "\"") )
+                        const char* pszEnd = strchr(pszStart + 1, '>');
+                        if( pszEnd )
                         {
-                            const char* pszStart = strchr(aosHeaders[i], '<');
-                            if( pszStart )
-                            {
-                                const char* pszEnd = strchr(pszStart + 1, '>');
-                                if( pszEnd )
-                                {
-                                    m_osGetURL = pszStart + 1;
-                                    m_osGetURL.resize(pszEnd - pszStart - 1);
-                                }
-                            }
-                            break;
+                            poPage->osNextURL = pszStart + 1;
+                            poPage->osNextURL.resize(pszEnd - pszStart - 1);
                         }
                     }
+                    break;
                 }
+            }
+        }
 #endif
 
-                if( !m_osGetURL.empty() )
-                {
-                    m_osGetURL = m_poDS->ReinjectAuthInURL(m_osGetURL);
-                }
+        if( !poPage->osNextURL.empty() )
+        {
+            poPage->osNextURL = m_poDS->ReinjectAuthInURL(poPage->osNextURL);
+        }
+}
+
+    poPage->bOK = true;
+    return poPage;
+}
+
+/************************************************************************/
+/*                         PrefetchThreadFunc()                         */
+/************************************************************************/
+
+void OGROAPIFLayer::PrefetchThreadFunc(CPLString osURL)
+{
+    // Errors are reported by GetNextPage() when the page is consumed.
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    const CPLString osPersistentName(CPLSPrintf("OAPIF:%p", this));
+    while( !osURL.empty() )
+    {
+        {
+            std::unique_lock<std::mutex> oLock(m_oPrefetchMutex);
+            m_oPrefetchCV.wait(oLock, [this]{
+                return m_bStopPrefetching ||
+                       static_cast<int>(m_apoPrefetchedPages.size()) <
+                                                m_poDS->m_nPrefetchPages; });
+            if( m_bStopPrefetching )
+                break;
+        }
+
+        CPLErrorReset();
+        auto poPage = FetchPage(osURL, osPersistentName.c_str());
+        if( !poPage )
+        {
+            poPage.reset(new Page());
+            poPage->eErrClass = CPLGetLastErrorType();
+            poPage->nErrNum = CPLGetLastErrorNo();
+            poPage->osErrMsg = CPLGetLastErrorMsg();
+        }
+        osURL = poPage->osNextURL;
+
+        {
+            std::lock_guard<std::mutex> oLock(m_oPrefetchMutex);
+            m_apoPrefetchedPages.push_back(std::move(poPage));
+        }
+        m_oPrefetchCV.notify_all();
+    }
+    CPLPopErrorHandler();
+
+    char **papszOptions =
+        CSLSetNameValue(nullptr, "CLOSE_PERSISTENT", osPersistentName);
+    CPLHTTPDestroyResult(CPLHTTPFetch(m_poDS->m_osRootURL, papszOptions));
+    CSLDestroy(papszOptions);
+
+    {
+        std::lock_guard<std::mutex> oLock(m_oPrefetchMutex);
+        m_bPrefetchingDone = true;
+    }
+    m_oPrefetchCV.notify_all();
+}
+
+/************************************************************************/
+/*                            GetNextPage()                             */
+/************************************************************************/
+
+std::unique_ptr<OGROAPIFLayer::Page> OGROAPIFLayer::GetNextPage()
+{
+    if( !m_oPrefetchThread.joinable() )
+    {
+        if( m_osGetURL.empty() )
+            return nullptr;
+        CPLString osURL(m_osGetURL);
+        m_osGetURL.clear();
+        m_bStopPrefetching = false;
+        m_bPrefetchingDone = false;
+        m_oPrefetchThread = std::thread(
+            [this, osURL]() { PrefetchThreadFunc(osURL); });
+    }
+
+    std::unique_ptr<Page> poPage;
+    {
+        std::unique_lock<std::mutex> oLock(m_oPrefetchMutex);
+        m_oPrefetchCV.wait(oLock, [this]{
+            return !m_apoPrefetchedPages.empty() || m_bPrefetchingDone; });
+        if( m_apoPrefetchedPages.empty() )
+            return nullptr;
+        poPage = std::move(m_apoPrefetchedPages.front());
+        m_apoPrefetchedPages.pop_front();
+    }
+    m_oPrefetchCV.notify_all();
+
+    if( !poPage->bOK )
+    {
+        if( poPage->eErrClass != CE_None )
+        {
+            CPLError(poPage->eErrClass, poPage->nErrNum, "%s",
+                     poPage->osErrMsg.c_str());
+        }
+        return nullptr;
+    }
+    return poPage;
+}
+
+/************************************************************************/
+/*                          StopPrefetching()                           */
+/************************************************************************/
+
+void OGROAPIFLayer::StopPrefetching()
+{
+    if( !m_oPrefetchThread.joinable() )
+        return;
+    {
+        std::lock_guard<std::mutex> oLock(m_oPrefetchMutex);
+        m_bStopPrefetching = true;
+    }
+    m_oPrefetchCV.notify_all();
+    m_oPrefetchThread.join();
+    m_apoPrefetchedPages.clear();
+}
+
+/************************************************************************/
+/*                         GetNextRawFeature()                          */
+/************************************************************************/
+
+OGRFeature* OGROAPIFLayer::GetNextRawFeature()
+{
+    if( !m_bFeatureDefnEstablished )
+        EstablishFeatureDefn();
+
+    OGRFeature* poSrcFeature = nullptr;
+    while( true )
+    {
+        if( m_poUnderlyingLayer == nullptr )
+        {
+            std::unique_ptr<Page> poPage;
+            if( m_poDS->m_nPrefetchPages > 0 && m_osGetID.empty() )
+            {
+                poPage = GetNextPage();
             }
+            else if( !m_osGetURL.empty() )
+            {
+                CPLString osURL(m_osGetURL);
+                m_osGetURL.clear();
+                poPage = FetchPage(osURL, nullptr);
+                if( poPage )
+                    m_osGetURL = poPage->osNextURL;
+            }
+            if( !poPage )
+                return nullptr;
+
+            m_oCurDoc = std::move(poPage->oDoc);
+            m_poUnderlyingDS = std::move(poPage->poDS);
+            m_poUnderlyingLayer = m_poUnderlyingDS->GetLayer(0);
         }
 
         poSrcFeature = m_poUnderlyingLayer->GetNextFeature();
@@ -2491,6 +2682,9 @@ void RegisterOGROAPIF()
         "description='URL to the landing page or a /collections/{id}' required='true'/>"
 "  <Option name='PAGE_SIZE' type='int' "
         "description='Maximum number of features to retrieve in a single request'/>"
+"  <Option name='PREFETCH_PAGES' type='int' "
+        "description='Number of next pages to download in the background' "
+        "default='0'/>"
 "  <Option name='USERPWD' type='string' "
         "description='Basic authentication as username:password'/>"
 "  <Option name='IGNORE_SCHEMA' type='boolean' "
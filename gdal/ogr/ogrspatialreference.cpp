@@ -89,6 +89,10 @@ struct OGRSpatialReference::Private
 
     PJ*             m_pj_crs = nullptr;
 
+    // Identifier of the canonical definition of m_pj_crs, when it comes from
+    // the interned CRS cache. 0 if unknown. See OSRGetCanonicalCRSId()
+    int             m_nCanonicalId = 0;
+
     // Temporary state used for object construction
     PJ_TYPE         m_pjType = PJ_TYPE_UNKNOWN;
     CPLString           m_osPrimeMeridianName{};
@@ -203,6 +207,7 @@ void OGRSpatialReference::Private::clear()
     proj_assign_context( m_pj_crs, getPROJContext() );
     proj_destroy(m_pj_crs);
     m_pj_crs = nullptr;
+    m_nCanonicalId = 0;
 
     delete m_poRoot;
     m_poRoot = nullptr;
@@ -245,6 +250,7 @@ void OGRSpatialReference::Private::setPjCRS(PJ* pj_crsIn,
     proj_assign_context( m_pj_crs, getPROJContext() );
     proj_destroy(m_pj_crs);
     m_pj_crs = pj_crsIn;
+    m_nCanonicalId = 0;
     if( m_pj_crs )
     {
         m_pjType = proj_get_type(m_pj_crs);
@@ -309,20 +315,36 @@ void OGRSpatialReference::Private::refreshRootFromProjObj()
         }
         aosOptions.SetNameValue("STRICT", "NO");
 
-        const char* pszWKT;
+        // Reuse the export of a previous object with the same definition
+        std::string osCachedWKT;
+        const char* pszWKT = nullptr;
+        if( m_nCanonicalId > 0 &&
+            OSRGetCanonicalCRSWKT1(m_nCanonicalId, m_bMorphToESRI,
+                                   osCachedWKT, m_bNodesWKT2) )
         {
-            CPLErrorStateBackuper oErrorStateBackuper;
-            CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
-            pszWKT = proj_as_wkt(getPROJContext(),
-                m_pj_crs, m_bMorphToESRI ? PJ_WKT1_ESRI : PJ_WKT1_GDAL,
-                aosOptions.List());
-            m_bNodesWKT2 = false;
+            pszWKT = osCachedWKT.c_str();
         }
-        if( !m_bMorphToESRI && pszWKT == nullptr )
+        else
         {
-             pszWKT = proj_as_wkt(getPROJContext(), m_pj_crs, PJ_WKT2_2018,
-                                  aosOptions.List());
-             m_bNodesWKT2 = true;
+            {
+                CPLErrorStateBackuper oErrorStateBackuper;
+                CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
+                pszWKT = proj_as_wkt(getPROJContext(),
+                    m_pj_crs, m_bMorphToESRI ? PJ_WKT1_ESRI : PJ_WKT1_GDAL,
+                    aosOptions.List());
+                m_bNodesWKT2 = false;
+            }
+            if( !m_bMorphToESRI && pszWKT == nullptr )
+            {
+                 pszWKT = proj_as_wkt(getPROJContext(), m_pj_crs, PJ_WKT2_2018,
+                                      aosOptions.List());
+                 m_bNodesWKT2 = true;
+            }
+            if( pszWKT && m_nCanonicalId > 0 )
+            {
+                OSRSetCanonicalCRSWKT1(m_nCanonicalId, m_bMorphToESRI,
+                                       pszWKT, m_bNodesWKT2);
+            }
         }
         if( pszWKT )
         {
@@ -858,8 +880,11 @@ OGRSpatialReference::operator=(const OGRSpatialReference &oSource)
 
         oSource.d->refreshProjObj();
         if( oSource.d->m_pj_crs )
+        {
             d->setPjCRS(proj_clone(
                 d->getPROJContext(), oSource.d->m_pj_crs));
+            d->m_nCanonicalId = oSource.d->m_nCanonicalId;
+        }
         if( oSource.d->m_axisMappingStrategy == OAMS_TRADITIONAL_GIS_ORDER )
             SetAxisMappingStrategy(OAMS_TRADITIONAL_GIS_ORDER);
         else if ( oSource.d->m_axisMappingStrategy == OAMS_CUSTOM )
@@ -1242,7 +1267,10 @@ OGRSpatialReference *OGRSpatialReference::Clone() const
 
     d->refreshProjObj();
     if( d->m_pj_crs != nullptr )
+    {
         poNewRef->d->setPjCRS(proj_clone(d->getPROJContext(), d->m_pj_crs));
+        poNewRef->d->m_nCanonicalId = d->m_nCanonicalId;
+    }
     if( d->m_bHasCenterLong && d->m_poRoot )
     {
         poNewRef->d->setRoot(d->m_poRoot->Clone());
@@ -1776,10 +1804,12 @@ OGRErr OGRSpatialReference::importFromWkt( const char ** ppszInput )
     if( **ppszInput )
     {
         osWkt = *ppszInput;
-        auto cachedObj = tlsCache->GetPJForWKT(osWkt);
+        int nCanonicalId = 0;
+        auto cachedObj = tlsCache->GetPJForWKT(osWkt, &nCanonicalId);
         if( cachedObj )
         {
             d->setPjCRS(cachedObj);
+            d->m_nCanonicalId = nCanonicalId;
         }
         else
         {
@@ -1829,7 +1859,7 @@ OGRErr OGRSpatialReference::importFromWkt( const char ** ppszInput )
 
     if( canCache )
     {
-        tlsCache->CachePJForWKT(osWkt, d->m_pj_crs);
+        tlsCache->CachePJForWKT(osWkt, d->m_pj_crs, &d->m_nCanonicalId);
     }
 
     if( strstr(*ppszInput, "CENTER_LONG") ) {
@@ -3576,13 +3606,24 @@ OGRErr OGRSpatialReference::SetFromUserInput( const char * pszDefinition )
          strstr(pszDefinition, "BoundCRS") ||
          strstr(pszDefinition, "CompoundCRS")) )
     {
-        auto obj = proj_create(d->getPROJContext(), pszDefinition);
+        auto tlsCache = OSRGetProjTLSCache();
+        int nCanonicalId = 0;
+        auto obj = tlsCache->GetPJForWKT(pszDefinition, &nCanonicalId);
+        if( obj )
+        {
+            Clear();
+            d->setPjCRS(obj);
+            d->m_nCanonicalId = nCanonicalId;
+            return OGRERR_NONE;
+        }
+        obj = proj_create(d->getPROJContext(), pszDefinition);
         if( !obj )
         {
             return OGRERR_FAILURE;
         }
         Clear();
         d->setPjCRS(obj);
+        tlsCache->CachePJForWKT(pszDefinition, obj, &d->m_nCanonicalId);
         return OGRERR_NONE;
     }
 
@@ -8956,6 +8997,14 @@ int OGRSpatialReference::IsSame( const OGRSpatialReference * poOtherSRS,
             return false;
     }
 
+    // Objects with the same canonical definition are equivalent whatever
+    // the criterion.
+    if( d->m_nCanonicalId > 0 &&
+        d->m_nCanonicalId == poOtherSRS->d->m_nCanonicalId )
+    {
+        return TRUE;
+    }
+
     bool reboundSelf = false;
     bool reboundOther = false;
     if( d->m_pjType == PJ_TYPE_BOUND_CRS &&
@@ -9696,6 +9745,7 @@ void OSRCleanup( void )
     CSVDeaccess( nullptr );
     CleanupSRSWGS84Mutex();
     OSRCTCleanCache();
+    OSRCleanupInternedCRS();
     OSRCleanupTLSContext();
 }
 
@@ -10773,10 +10823,13 @@ OGRErr OGRSpatialReference::importFromEPSGA( int nCode )
     auto tlsCache = OSRGetProjTLSCache();
     if( tlsCache )
     {
-        auto cachedObj = tlsCache->GetPJForEPSGCode(nCode, bUseNonDeprecated, bAddTOWGS84);
+        int nCanonicalId = 0;
+        auto cachedObj = tlsCache->GetPJForEPSGCode(nCode, bUseNonDeprecated,
+                                                    bAddTOWGS84, &nCanonicalId);
         if( cachedObj )
         {
             d->setPjCRS(cachedObj);
+            d->m_nCanonicalId = nCanonicalId;
             return OGRERR_NONE;
         }
     }
@@ -10825,7 +10878,8 @@ OGRErr OGRSpatialReference::importFromEPSGA( int nCode )
 
     if( tlsCache )
     {
-        tlsCache->CachePJForEPSGCode(nCode, bUseNonDeprecated, bAddTOWGS84, obj);
+        tlsCache->CachePJForEPSGCode(nCode, bUseNonDeprecated, bAddTOWGS84, obj,
+                                     &d->m_nCanonicalId);
     }
 
     return OGRERR_NONE;
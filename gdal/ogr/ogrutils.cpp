@@ -31,6 +31,7 @@
 #include "cpl_port.h"
 #include "ogr_p.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
@@ -196,6 +197,102 @@ std::string intelliround(std::string& s)
     return s;
 }
 
+// Formats val as "%.<precision>f" (bFixed) or "%.<precision>G" would do,
+// from its shortest round-trip representation, which is much faster than
+// going through the C library or iostreams. This is only done when the result
+// is provably identical, that is when the shortest representation has no
+// more digits than requested, and when the distance between val and that
+// representation, at most half an ULP, is below half a unit of the last
+// requested digit. Returns false otherwise.
+bool formatDoubleFromShortest(double val, int precision, bool bFixed,
+                              std::string& s)
+{
+    if( precision < 0 || precision > 100 )
+        return false;
+
+    if( val == 0 )
+    {
+        s = std::signbit(val) ? "-0" : "0";
+        if( bFixed && precision > 0 )
+        {
+            s += '.';
+            s.append(precision, '0');
+        }
+        return true;
+    }
+
+    // With %G, the exponent of the leading digit is >= -4, so no more than
+    // max(precision, 1) + 3 decimals are needed.
+    char szShortest[32];
+    const int nLen = CPLFormatDoubleShortestFixed(
+        szShortest, sizeof(szShortest), val,
+        bFixed ? precision : std::max(precision, 1) + 3);
+    if( nLen == 0 )
+        return false;
+
+    const char* pszDigits = szShortest + (szShortest[0] == '-' ? 1 : 0);
+    const char* pszPoint = strchr(pszDigits, '.');
+    const int nDecimals =
+        pszPoint ? static_cast<int>(strlen(pszPoint + 1)) : 0;
+
+    // Decimal exponent of the leading significant digit, and number of
+    // significant digits.
+    int nExp10 = 0;
+    int nSigDigits = 0;
+    if( pszDigits[0] != '0' )
+    {
+        const int nIntDigits = pszPoint ?
+            static_cast<int>(pszPoint - pszDigits) :
+            static_cast<int>(strlen(pszDigits));
+        nExp10 = nIntDigits - 1;
+        nSigDigits = nIntDigits + nDecimals;
+    }
+    else
+    {
+        // 0.000ddd
+        if( pszPoint == nullptr )
+            return false;
+        int nLeadingZeros = 0;
+        while( pszPoint[1 + nLeadingZeros] == '0' )
+            nLeadingZeros++;
+        nExp10 = -(nLeadingZeros + 1);
+        nSigDigits = nDecimals - nLeadingZeros;
+    }
+
+    const double dfAbs = std::fabs(val);
+    const double dfUlp =
+        std::nextafter(dfAbs, std::numeric_limits<double>::infinity()) - dfAbs;
+
+    if( bFixed )
+    {
+        if( nDecimals > precision ||
+            !(dfUlp <= 0.5 * std::pow(10.0, -precision)) )
+        {
+            return false;
+        }
+        s.assign(szShortest, nLen);
+        if( precision > 0 )
+        {
+            if( pszPoint == nullptr )
+                s += '.';
+            s.append(precision - nDecimals, '0');
+        }
+        return true;
+    }
+
+    // %G switches to exponential notation if the exponent is < -4 or
+    // >= precision, and strips trailing zeros.
+    const int nSigPrecision = precision == 0 ? 1 : precision;
+    if( nSigDigits > nSigPrecision || nExp10 < -4 ||
+        nExp10 >= nSigPrecision ||
+        !(dfUlp <= 0.5 * std::pow(10.0, nExp10 - nSigPrecision + 1)) )
+    {
+        return false;
+    }
+    s.assign(szShortest, nLen);
+    return true;
+}
+
 } // unnamed namespace
 
 /************************************************************************/
@@ -241,24 +338,28 @@ std::string OGRFormatDouble(double val, const OGRWktOptions& opts)
     if( CPLIsNan(val) )
         return "nan";
 
-    std::ostringstream oss;
-    oss.imbue(std::locale::classic());  // Make sure we output decimal points.
-    bool l_round(opts.round);
-    if (opts.format == OGRWktFormat::F ||
-        (opts.format == OGRWktFormat::Default && fabs(val) < 1))
-        oss << std::fixed;
-    else
+    const bool bFixed = opts.format == OGRWktFormat::F ||
+        (opts.format == OGRWktFormat::Default && fabs(val) < 1);
+
+    std::string sval;
+    if( !formatDoubleFromShortest(val, opts.precision, bFixed, sval) )
     {
-        // Uppercase because OGC spec says capital 'E'.
-        oss << std::uppercase;
-        l_round = false;
+        std::ostringstream oss;
+        // Make sure we output decimal points.
+        oss.imbue(std::locale::classic());
+        if( bFixed )
+            oss << std::fixed;
+        else
+        {
+            // Uppercase because OGC spec says capital 'E'.
+            oss << std::uppercase;
+        }
+        oss << std::setprecision(opts.precision);
+        oss << val;
+        sval = oss.str();
     }
-    oss << std::setprecision(opts.precision);
-    oss << val;
-
-    std::string sval = oss.str();
 
-    if (l_round)
+    if (bFixed && opts.round)
         sval = intelliround(sval);
     return removeTrailingZeros(sval);
 }
@@ -811,6 +912,101 @@ const char * OGRWktReadPointsM( const char * pszInput,
     return pszInput;
 }
 
+/************************************************************************/
+/*                        OGRWKTGetBoundingBox()                        */
+/*                                                                      */
+/*      Compute the envelope of a WKT geometry by scanning its          */
+/*      coordinates, without building a OGRGeometry. Returns false if   */
+/*      the string does not look like a linear WKT geometry (curve      */
+/*      geometries are not handled, as their envelope is not the one of */
+/*      their control points). The envelope is left uninitialized for   */
+/*      an empty geometry.                                              */
+/************************************************************************/
+
+bool OGRWKTGetBoundingBox( const char* pszWKT, OGREnvelope& sEnvelope )
+{
+    sEnvelope = OGREnvelope();
+
+    const char* pszIter = pszWKT;
+    while( isspace(static_cast<unsigned char>(*pszIter)) )
+        pszIter++;
+    if( !isalpha(static_cast<unsigned char>(*pszIter)) )
+        return false;
+
+    int nDepth = 0;
+    int iCoord = 0;
+    double dfX = 0.0;
+    while( *pszIter != '\0' )
+    {
+        const char ch = *pszIter;
+        if( isalpha(static_cast<unsigned char>(ch)) )
+        {
+            const char* pszWordStart = pszIter;
+            while( isalpha(static_cast<unsigned char>(*pszIter)) )
+                pszIter++;
+            const size_t nLen = static_cast<size_t>(pszIter - pszWordStart);
+            const auto WordIs = [pszWordStart, nLen](const char* pszWord)
+            {
+                return nLen == strlen(pszWord) &&
+                       EQUALN(pszWordStart, pszWord, nLen);
+            };
+            if( WordIs("CIRCULARSTRING") || WordIs("COMPOUNDCURVE") ||
+                WordIs("CURVEPOLYGON") || WordIs("MULTICURVE") ||
+                WordIs("MULTISURFACE") || WordIs("NAN") || WordIs("INF") )
+            {
+                return false;
+            }
+            // Coordinates are only expected after an opening parenthesis
+            if( iCoord != 0 )
+                return false;
+            continue;
+        }
+
+        if( ch == '(' || ch == ')' || ch == ',' )
+        {
+            // A tuple with a single coordinate is invalid
+            if( iCoord == 1 )
+                return false;
+            iCoord = 0;
+            if( ch == '(' )
+                nDepth++;
+            else if( ch == ')' && --nDepth < 0 )
+                return false;
+            pszIter++;
+        }
+        else if( (ch >= '0' && ch <= '9') || ch == '-' || ch == '+' ||
+                 ch == '.' )
+        {
+            if( nDepth == 0 )
+                return false;
+            char* pszEnd = nullptr;
+            const double dfVal = CPLStrtod(pszIter, &pszEnd);
+            if( pszEnd == pszIter )
+                return false;
+            pszIter = pszEnd;
+            if( iCoord == 0 )
+            {
+                dfX = dfVal;
+            }
+            else if( iCoord == 1 )
+            {
+                sEnvelope.Merge(dfX, dfVal);
+            }
+            iCoord++;
+        }
+        else if( isspace(static_cast<unsigned char>(ch)) )
+        {
+            pszIter++;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return nDepth == 0 && iCoord != 1;
+}
+
 /************************************************************************/
 /*                             OGRMalloc()                              */
 /*                                                                      */
@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: MIT
+# Copyright 2021 Even Rouault
+
+# Compares two JSON reports of autotest/cpp/gdal_benchmark, e.g. one for
+# the previous release and one for the current development version:
+#
+#   ./gdal_benchmark -format json -o new.json -repetitions 5
+#   python3 compare_benchmarks.py old.json new.json
+#
+# The exit code is 1 if a benchmark got slower than the threshold.
+
+import argparse
+import json
+import sys
+
+
+def load(filename):
+    with open(filename) as f:
+        report = json.load(f)
+    results = {}
+    for bench in report['benchmarks']:
+        # With repetitions, only use the median of each benchmark
+        if bench.get('run_type') == 'aggregate':
+            if bench.get('aggregate_name') != 'median':
+                continue
+        elif bench.get('repetitions', 1) > 1:
+            continue
+        results[bench.get('run_name', bench['name'])] = bench[options.time]
+    return report.get('context', {}), results
+
+
+parser = argparse.ArgumentParser(description='Compare two gdal_benchmark '
+                                             'JSON reports.')
+parser.add_argument('baseline')
+parser.add_argument('contender')
+parser.add_argument('--threshold', type=float, default=10,
+                    help='percentage of slowdown considered as a regression '
+                         '(default: 10)')
+parser.add_argument('--time', choices=['real_time', 'cpu_time'],
+                    default='real_time')
+options = parser.parse_args()
+
+ctx_base, base = load(options.baseline)
+ctx_new, new = load(options.contender)
+print('Baseline:  %s (%s)' % (ctx_base.get('gdal_version', '?'),
+                              options.baseline))
+print('Contender: %s (%s)' % (ctx_new.get('gdal_version', '?'),
+                              options.contender))
+print()
+print('%-60s %14s %14s %9s' % ('Benchmark', 'Baseline (ns)',
+                               'Contender (ns)', 'Change'))
+
+regressions = []
+for name in sorted(set(base) & set(new)):
+    if base[name] <= 0:
+        continue
+    change = (new[name] - base[name]) * 100.0 / base[name]
+    flag = ''
+    if change > options.threshold:
+        flag = ' <-- slower'
+        regressions.append(name)
+    elif change < -options.threshold:
+        flag = ' faster'
+    print('%-60s %14.0f %14.0f %+8.1f%%%s' % (name, base[name], new[name],
+                                               change, flag))
+
+for name in sorted(set(base) - set(new)):
+    print('%-60s only in baseline' % name)
+for name in sorted(set(new) - set(base)):
+    print('%-60s only in contender' % name)
+
+if regressions:
+    print()
+    print('%d benchmark(s) slower by more than %.1f%%' %
+          (len(regressions), options.threshold))
+    sys.exit(1)
@@ -54,6 +54,7 @@
 #include "cpl_conv.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cerrno>
 #include <climits>
@@ -73,11 +74,15 @@
 #include <set>
 #endif
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "cpl_config.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
+#include "cpl_vsi_virtual.h"
 #include "cpl_vsil_curl_priv.h"
 
 #ifdef DEBUG
@@ -94,8 +99,107 @@ void OGRAPISPYCPLSetThreadLocalConfigOption(const char*, const char*);
 
 CPL_CVSID("$Id$")
 
+// Global configuration options are an immutable NULL terminated list of
+// KEY=VALUE strings, read without locking by CPLGetConfigOption(). Writers,
+// serialized by hConfigMutex, publish a new list, sharing the unchanged
+// strings with the previous one. The replaced list and strings are retired,
+// and freed once the readers that might still access them are gone.
+//
+// Readers register in one of two counters, selected by the parity of
+// g_nConfigOptionsEpoch. After publishing, a writer switches the epoch, so
+// that new readers use the other counter, and waits for the counter of the
+// previous epoch to drain. Readers never wait, and the retired memory is
+// bounded by what a single writer replaces.
 static CPLMutex *hConfigMutex = nullptr;
-static volatile char **g_papszConfigOptions = nullptr;
+static std::atomic<char**> g_papszConfigOptions{nullptr};
+static std::vector<void*>* g_papRetiredConfigOptions = nullptr;
+static std::atomic<unsigned> g_nConfigOptionsEpoch{0};
+static std::atomic<int> g_anConfigOptionsReaders[2];
+
+namespace {
+
+/************************************************************************/
+/*                        CPLConfigOptionsReader                        */
+/************************************************************************/
+
+// Scoped access to the published list of global configuration options.
+class CPLConfigOptionsReader
+{
+    int m_iSlot = 0;
+
+    CPL_DISALLOW_COPY_ASSIGN(CPLConfigOptionsReader)
+
+  public:
+    CPLConfigOptionsReader()
+    {
+        while( true )
+        {
+            const unsigned nEpoch = g_nConfigOptionsEpoch.load();
+            m_iSlot = static_cast<int>(nEpoch & 1);
+            ++g_anConfigOptionsReaders[m_iSlot];
+            // If a writer switched the epoch in between, it might not wait
+            // for us: register again in the counter of the new epoch.
+            if( g_nConfigOptionsEpoch.load() == nEpoch )
+                break;
+            --g_anConfigOptionsReaders[m_iSlot];
+        }
+    }
+
+    ~CPLConfigOptionsReader()
+    {
+        --g_anConfigOptionsReaders[m_iSlot];
+    }
+
+    char** GetList() const { return g_papszConfigOptions.load(); }
+};
+
+} // namespace
+
+/************************************************************************/
+/*                     CPLRetireConfigOptionsItem()                     */
+/************************************************************************/
+
+// Must be called with hConfigMutex held.
+static void CPLRetireConfigOptionsItem( void* pItem )
+{
+    if( g_papRetiredConfigOptions == nullptr )
+        g_papRetiredConfigOptions = new std::vector<void*>();
+    g_papRetiredConfigOptions->push_back(pItem);
+}
+
+/************************************************************************/
+/*                    CPLPublishConfigOptionsList()                     */
+/************************************************************************/
+
+// Must be called with hConfigMutex held. If bRetireStrings, the strings
+// of the previous list are retired too, otherwise they are assumed to be
+// shared with the new list or to have been retired by the caller.
+static void CPLPublishConfigOptionsList( char** papszNew, bool bRetireStrings )
+{
+    char** papszOld = g_papszConfigOptions.exchange(papszNew);
+    if( papszOld != nullptr )
+    {
+        if( bRetireStrings )
+        {
+            for( char** papszIter = papszOld; *papszIter; ++papszIter )
+                CPLRetireConfigOptionsItem(*papszIter);
+        }
+        CPLRetireConfigOptionsItem(papszOld);
+    }
+    if( g_papRetiredConfigOptions == nullptr ||
+        g_papRetiredConfigOptions->empty() )
+        return;
+
+    // Readers of the previous epoch might still access the retired items.
+    // Readers registered in the new epoch can only see the new list.
+    const unsigned nEpoch = g_nConfigOptionsEpoch.fetch_add(1);
+    while( g_anConfigOptionsReaders[nEpoch & 1].load() != 0 )
+        std::this_thread::yield();
+
+    for( void* pItem: *g_papRetiredConfigOptions )
+        CPLFree(pItem);
+    g_papRetiredConfigOptions->clear();
+}
 
 // Used by CPLOpenShared() and friends.
 static CPLMutex *hSharedFileMutex = nullptr;
@@ -1670,6 +1774,10 @@ static void CPLAccessConfigOption( const char *pszKey, bool bGet )
   * in particular it will become invalid after a call to CPLSetConfigOption()
   * with the same key.
   *
+  * Starting with GDAL 3.4, looking up options set with CPLSetConfigOption()
+  * does not take any lock, so that this function can be called from hot
+  * paths of multi-threaded code.
+  *
   * To override temporary a potentially existing option with a new value, you
   * can use the following snippet :
   * <pre>
@@ -1709,10 +1817,11 @@ CPLGetConfigOption( const char *pszKey, const char *pszDefault )
 
     if( pszResult == nullptr )
     {
-        CPLMutexHolderD(&hConfigMutex);
-
-        pszResult =
-            CSLFetchNameValue(const_cast<char **>(g_papszConfigOptions), pszKey);
+        // Lock-free: the list is immutable once published.
+        CPLConfigOptionsReader oReader;
+        char** papszConfigOptions = oReader.GetList();
+        if( papszConfigOptions != nullptr )
+            pszResult = CSLFetchNameValue(papszConfigOptions, pszKey);
     }
 
     if( pszResult == nullptr )
@@ -1741,8 +1850,8 @@ CPLGetConfigOption( const char *pszKey, const char *pszDefault )
   */
 char** CPLGetConfigOptions(void)
 {
-    CPLMutexHolderD(&hConfigMutex);
-    return CSLDuplicate(const_cast<char**>(g_papszConfigOptions));
+    CPLConfigOptionsReader oReader;
+    return CSLDuplicate(oReader.GetList());
 }
 
 /************************************************************************/
@@ -1768,9 +1877,8 @@ char** CPLGetConfigOptions(void)
 void CPLSetConfigOptions(const char* const * papszConfigOptions)
 {
     CPLMutexHolderD(&hConfigMutex);
-    CSLDestroy(const_cast<char**>(g_papszConfigOptions));
-    g_papszConfigOptions = const_cast<volatile char**>(
-            CSLDuplicate(const_cast<char**>(papszConfigOptions)));
+    CPLPublishConfigOptionsList(
+        CSLDuplicate(const_cast<char**>(papszConfigOptions)), true);
 }
 
 /************************************************************************/
@@ -1806,11 +1914,15 @@ CPLGetThreadLocalConfigOption( const char *pszKey, const char *pszDefault )
 /************************************************************************/
 
 static void NotifyOtherComponentsConfigOptionChanged( const char *pszKey,
-                                                      const char * /*pszValue*/ )
+                                                      const char *pszValue )
 {
     // Hack
     if( STARTS_WITH_CI(pszKey, "AWS_") )
         VSICurlAuthParametersChanged();
+    else if( EQUAL(pszKey, "CPL_TRACE_FILE") )
+        CPLTraceFileConfigOptionChanged(pszValue);
+    else if( EQUAL(pszKey, "CPL_VSIL_IO_TRACE_FILE") )
+        VSIIOTraceFileConfigOptionChanged(pszValue);
 }
 
 /************************************************************************/
@@ -1858,9 +1970,44 @@ CPLSetConfigOption( const char *pszKey, const char *pszValue )
     OGRAPISPYCPLSetConfigOption(pszKey, pszValue);
 #endif
 
-    g_papszConfigOptions = const_cast<volatile char **>(
-        CSLSetNameValue(
-            const_cast<char **>(g_papszConfigOptions), pszKey, pszValue));
+    // Build a new list instead of modifying the published one in place
+    // (which CSLSetNameValue() would do), as readers do not lock.
+    char** papszOld = g_papszConfigOptions.load();
+    const int nCount = CSLCount(papszOld);
+    const int iKey = CSLFindName(papszOld, pszKey);
+    if( iKey < 0 && pszValue == nullptr )
+        return;
+
+    char** papszNew = static_cast<char**>(
+        CPLMalloc(sizeof(char*) * (nCount + 2)));
+    int iNew = 0;
+    for( int i = 0; i < nCount; ++i )
+    {
+        if( i != iKey )
+            papszNew[iNew++] = papszOld[i];
+    }
+    if( iKey >= 0 )
+        CPLRetireConfigOptionsItem(papszOld[iKey]);
+    if( pszValue != nullptr )
+    {
+        const size_t nLen = strlen(pszKey) + strlen(pszValue) + 2;
+        char* pszLine = static_cast<char*>(CPLMalloc(nLen));
+        snprintf(pszLine, nLen, "%s=%s", pszKey, pszValue);
+        if( iKey >= 0 )
+        {
+            // Keep the position of the option in the list.
+            memmove(papszNew + iKey + 1, papszNew + iKey,
+                    sizeof(char*) * (iNew - iKey));
+            papszNew[iKey] = pszLine;
+        }
+        else
+        {
+            papszNew[iNew] = pszLine;
+        }
+        iNew++;
+    }
+    papszNew[iNew] = nullptr;
+    CPLPublishConfigOptionsList(papszNew, false);
 }
 
 /************************************************************************/
@@ -1991,8 +2138,14 @@ void CPL_STDCALL CPLFreeConfig()
     {
         CPLMutexHolderD(&hConfigMutex);
 
-        CSLDestroy(const_cast<char **>(g_papszConfigOptions));
-        g_papszConfigOptions = nullptr;
+        CSLDestroy(g_papszConfigOptions.exchange(nullptr));
+        if( g_papRetiredConfigOptions )
+        {
+            for( void* pItem: *g_papRetiredConfigOptions )
+                CPLFree(pItem);
+            delete g_papRetiredConfigOptions;
+            g_papRetiredConfigOptions = nullptr;
+        }
 
         int bMemoryError = FALSE;
         char **papszTLConfigOptions = reinterpret_cast<char **>(
@@ -102,6 +102,17 @@ double CPL_DLL CPLStrtodDelim(const char *, char **, char);
 float CPL_DLL CPLStrtof(const char *, char **);
 float CPL_DLL CPLStrtofDelim(const char *, char **, char);
 
+/* -------------------------------------------------------------------- */
+/*      Convert floating point number to the shortest ASCII string      */
+/*      that converts back to the same value (NOT LOCALE AWARE).        */
+/* -------------------------------------------------------------------- */
+int CPL_DLL CPLFormatDoubleShortest(char *pszBuffer, size_t nBufferSize,
+                                    double dfValue);
+/*! @cond Doxygen_Suppress */
+int CPL_DLL CPLFormatDoubleShortestFixed(char *pszBuffer, size_t nBufferSize,
+                                         double dfValue, int nMaxDecimals);
+/*! @endcond */
+
 /* -------------------------------------------------------------------- */
 /*      Convert number to string.  This function is locale agnostic     */
 /*      (i.e. it will support "," or "." regardless of current locale)  */
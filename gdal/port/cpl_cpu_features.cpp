@@ -40,8 +40,14 @@ CPL_CVSID("$Id$")
 
 #define CPUID_SSE_EDX_BIT       25
 
+#define CPUID_AVX2_EBX_BIT      5
+#define CPUID_AVX512F_EBX_BIT   16
+
 #define BIT_XMM_STATE           (1 << 1)
 #define BIT_YMM_STATE           (2 << 1)
+#define BIT_OPMASK_STATE        (1 << 5)
+#define BIT_ZMM_HI256_STATE     (1 << 6)
+#define BIT_HI16_ZMM_STATE      (1 << 7)
 
 #define REG_EAX                 0
 #define REG_EBX                 1
@@ -65,12 +71,31 @@ CPL_CVSID("$Id$")
        : "0" (level))
 #endif
 
+#if defined(__x86_64)
+#define GCC_CPUID_COUNT(level, count, a, b, c, d)   \
+  __asm__ ("xchgq %%rbx, %q1\n"                 \
+           "cpuid\n"                            \
+           "xchgq %%rbx, %q1"                   \
+       : "=a" (a), "=r" (b), "=c" (c), "=d" (d) \
+       : "0" (level), "2" (count))
+#else
+#define GCC_CPUID_COUNT(level, count, a, b, c, d)   \
+  __asm__ ("xchgl %%ebx, %1\n"                  \
+           "cpuid\n"                            \
+           "xchgl %%ebx, %1"                    \
+       : "=a" (a), "=r" (b), "=c" (c), "=d" (d) \
+       : "0" (level), "2" (count))
+#endif
+
 #define CPL_CPUID(level, array) GCC_CPUID(level, array[0], array[1], array[2], array[3])
+#define CPL_CPUID_COUNT(level, count, array) \
+    GCC_CPUID_COUNT(level, count, array[0], array[1], array[2], array[3])
 
 #elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
 
 #include <intrin.h>
 #define CPL_CPUID(level, array) __cpuid(array, level)
+#define CPL_CPUID_COUNT(level, count, array) __cpuidex(array, level, count)
 
 #endif
 
@@ -210,4 +235,163 @@ bool CPLHaveRuntimeAVX()
 
 #endif // defined(HAVE_AVX_AT_COMPILE_TIME) && !defined(CPLHaveRuntimeAVX)
 
+#if defined(HAVE_AVX2_AT_COMPILE_TIME) && !defined(HAVE_INLINE_AVX2)
+
+/************************************************************************/
+/*                          CPLHaveRuntimeAVX2()                        */
+/************************************************************************/
+
+#if defined(__GNUC__) || \
+    (defined(_MSC_FULL_VER) && (_MSC_FULL_VER >= 160040219) && \
+     (defined(_M_IX86) || defined(_M_X64)))
+
+static bool CPLDetectRuntimeAVX2()
+{
+    int cpuinfo[4] = { 0, 0, 0, 0 };
+    CPL_CPUID(0, cpuinfo);
+    if( cpuinfo[REG_EAX] < 7 )
+        return false;
+
+    // Check OSXSAVE feature.
+    CPL_CPUID(1, cpuinfo);
+    if( (cpuinfo[REG_ECX] & (1 << CPUID_OSXSAVE_ECX_BIT)) == 0 )
+    {
+        return false;
+    }
+
+    // Check AVX2 feature.
+    CPL_CPUID_COUNT(7, 0, cpuinfo);
+    if( (cpuinfo[REG_EBX] & (1 << CPUID_AVX2_EBX_BIT)) == 0 )
+    {
+        return false;
+    }
+
+    // Issue XGETBV and check the XMM and YMM state bit.
+#if defined(__GNUC__)
+    unsigned int nXCRLow;
+    unsigned int nXCRHigh;
+    __asm__ ("xgetbv" : "=a" (nXCRLow), "=d" (nXCRHigh) : "c" (0));
+    CPL_IGNORE_RET_VAL(nXCRHigh); // unused
+#else
+    const unsigned __int64 nXCRLow = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
+#endif
+    if( (nXCRLow & ( BIT_XMM_STATE | BIT_YMM_STATE )) !=
+                ( BIT_XMM_STATE | BIT_YMM_STATE ) )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+#if defined(__GNUC__) && !defined(DEBUG)
+bool bCPLHasAVX2 = false;
+static void CPLHaveRuntimeAVX2Initialize() __attribute__ ((constructor));
+static void CPLHaveRuntimeAVX2Initialize()
+{
+    bCPLHasAVX2 = CPLDetectRuntimeAVX2();
+}
+#else
+bool CPLHaveRuntimeAVX2()
+{
+#ifdef DEBUG
+    if( !CPLTestBool(CPLGetConfigOption("GDAL_USE_AVX2", "YES")) )
+        return false;
+#endif
+    return CPLDetectRuntimeAVX2();
+}
+#endif
+
+#else
+
+bool CPLHaveRuntimeAVX2()
+{
+    return false;
+}
+
+#endif
+
+#endif // defined(HAVE_AVX2_AT_COMPILE_TIME) && !defined(HAVE_INLINE_AVX2)
+
+#if defined(HAVE_AVX512_AT_COMPILE_TIME) && !defined(HAVE_INLINE_AVX512)
+
+/************************************************************************/
+/*                         CPLHaveRuntimeAVX512()                       */
+/************************************************************************/
+
+#if defined(__GNUC__) || \
+    (defined(_MSC_FULL_VER) && (_MSC_FULL_VER >= 160040219) && \
+     (defined(_M_IX86) || defined(_M_X64)))
+
+static bool CPLDetectRuntimeAVX512()
+{
+    int cpuinfo[4] = { 0, 0, 0, 0 };
+    CPL_CPUID(0, cpuinfo);
+    if( cpuinfo[REG_EAX] < 7 )
+        return false;
+
+    // Check OSXSAVE feature.
+    CPL_CPUID(1, cpuinfo);
+    if( (cpuinfo[REG_ECX] & (1 << CPUID_OSXSAVE_ECX_BIT)) == 0 )
+    {
+        return false;
+    }
+
+    // Check AVX-512 Foundation feature.
+    CPL_CPUID_COUNT(7, 0, cpuinfo);
+    if( (cpuinfo[REG_EBX] & (1 << CPUID_AVX512F_EBX_BIT)) == 0 )
+    {
+        return false;
+    }
+
+    // Issue XGETBV and check that the OS saves the XMM, YMM, opmask and
+    // ZMM states.
+#if defined(__GNUC__)
+    unsigned int nXCRLow;
+    unsigned int nXCRHigh;
+    __asm__ ("xgetbv" : "=a" (nXCRLow), "=d" (nXCRHigh) : "c" (0));
+    CPL_IGNORE_RET_VAL(nXCRHigh); // unused
+#else
+    const unsigned __int64 nXCRLow = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
+#endif
+    const unsigned int nRequiredStates =
+        BIT_XMM_STATE | BIT_YMM_STATE | BIT_OPMASK_STATE |
+        BIT_ZMM_HI256_STATE | BIT_HI16_ZMM_STATE;
+    if( (nXCRLow & nRequiredStates) != nRequiredStates )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+#if defined(__GNUC__) && !defined(DEBUG)
+bool bCPLHasAVX512 = false;
+static void CPLHaveRuntimeAVX512Initialize() __attribute__ ((constructor));
+static void CPLHaveRuntimeAVX512Initialize()
+{
+    bCPLHasAVX512 = CPLDetectRuntimeAVX512();
+}
+#else
+bool CPLHaveRuntimeAVX512()
+{
+#ifdef DEBUG
+    if( !CPLTestBool(CPLGetConfigOption("GDAL_USE_AVX512", "YES")) )
+        return false;
+#endif
+    return CPLDetectRuntimeAVX512();
+}
+#endif
+
+#else
+
+bool CPLHaveRuntimeAVX512()
+{
+    return false;
+}
+
+#endif
+
+#endif // defined(HAVE_AVX512_AT_COMPILE_TIME) && !defined(HAVE_INLINE_AVX512)
+
 //! @endcond
@@ -76,6 +76,44 @@ bool CPLHaveRuntimeAVX();
 #endif
 #endif
 
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+#if __AVX2__
+#define HAVE_INLINE_AVX2
+static bool inline CPLHaveRuntimeAVX2()
+{
+#ifdef DEBUG
+    if( !CPLTestBool(CPLGetConfigOption("GDAL_USE_AVX2", "YES")) )
+        return false;
+#endif
+    return true;
+}
+#elif defined(__GNUC__) && !defined(DEBUG)
+extern bool bCPLHasAVX2;
+static bool inline CPLHaveRuntimeAVX2() { return bCPLHasAVX2; }
+#else
+bool CPLHaveRuntimeAVX2();
+#endif
+#endif
+
+#ifdef HAVE_AVX512_AT_COMPILE_TIME
+#if __AVX512F__
+#define HAVE_INLINE_AVX512
+static bool inline CPLHaveRuntimeAVX512()
+{
+#ifdef DEBUG
+    if( !CPLTestBool(CPLGetConfigOption("GDAL_USE_AVX512", "YES")) )
+        return false;
+#endif
+    return true;
+}
+#elif defined(__GNUC__) && !defined(DEBUG)
+extern bool bCPLHasAVX512;
+static bool inline CPLHaveRuntimeAVX512() { return bCPLHasAVX512; }
+#else
+bool CPLHaveRuntimeAVX512();
+#endif
+#endif
+
 //! @endcond
 
 #endif // CPL_CPU_FEATURES_H
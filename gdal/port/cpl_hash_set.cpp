@@ -30,37 +30,61 @@
 #include "cpl_hash_set.h"
 
 #include <cstring>
+#include <new>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
-#include "cpl_list.h"
+#include "cpl_open_hash_map.h"
 
 CPL_CVSID("$Id$")
 
-struct _CPLHashSet
+namespace {
+
+struct CPLHashSetHasher
 {
-    CPLHashSetHashFunc    fnHashFunc;
-    CPLHashSetEqualFunc   fnEqualFunc;
-    CPLHashSetFreeEltFunc fnFreeEltFunc;
-    CPLList**             tabList;
-    int                   nSize;
-    int                   nIndiceAllocatedSize;
-    int                   nAllocatedSize;
-    CPLList              *psRecyclingList;
-    int                   nRecyclingListSize;
-    bool                  bRehash;
-#ifdef HASH_DEBUG
-    int                   nCollisions;
-#endif
+    CPLHashSetHashFunc fnHashFunc;
+
+    explicit CPLHashSetHasher( CPLHashSetHashFunc fnHashFuncIn ):
+        fnHashFunc(fnHashFuncIn) {}
+
+    size_t operator()( const void* elt ) const
+    {
+        return static_cast<size_t>(fnHashFunc(elt));
+    }
 };
 
-constexpr int anPrimes[] =
+struct CPLHashSetEqual
 {
-    53, 97, 193, 389, 769, 1543, 3079, 6151,
-    12289, 24593, 49157, 98317, 196613, 393241,
-    786433, 1572869, 3145739, 6291469, 12582917,
-    25165843, 50331653, 100663319, 201326611,
-    402653189, 805306457, 1610612741
+    CPLHashSetEqualFunc fnEqualFunc;
+
+    explicit CPLHashSetEqual( CPLHashSetEqualFunc fnEqualFuncIn ):
+        fnEqualFunc(fnEqualFuncIn) {}
+
+    bool operator()( const void* elt1, const void* elt2 ) const
+    {
+        return fnEqualFunc(elt1, elt2) != FALSE;
+    }
+};
+
+struct CPLHashSetNoValue {};
+
+typedef CPLOpenHashMap<const void*, CPLHashSetNoValue,
+                       CPLHashSetHasher, CPLHashSetEqual> CPLHashSetMap;
+
+} // namespace
+
+struct _CPLHashSet
+{
+    CPLHashSetFreeEltFunc fnFreeEltFunc = nullptr;
+    CPLHashSetMap         oMap;
+    bool                  bRehash = false;
+
+    _CPLHashSet( CPLHashSetHashFunc fnHashFunc,
+                 CPLHashSetEqualFunc fnEqualFunc,
+                 CPLHashSetFreeEltFunc fnFreeEltFuncIn ):
+        fnFreeEltFunc(fnFreeEltFuncIn),
+        oMap(CPLHashSetHasher(fnHashFunc), CPLHashSetEqual(fnEqualFunc))
+    {}
 };
 
 /************************************************************************/
@@ -81,6 +105,10 @@ constexpr int anPrimes[] =
  * If fnFreeEltFunc is NULL, elements inserted into the hash set will not be
  * freed.
  *
+ * Since GDAL 3.4, the hash set uses open addressing with linear probing,
+ * which avoids an allocation per inserted element and is more cache
+ * friendly than the previous chained implementation.
+ *
  * @param fnHashFunc hash function. May be NULL.
  * @param fnEqualFunc equal function. May be NULL.
  * @param fnFreeEltFunc element free function. May be NULL.
@@ -92,21 +120,9 @@ CPLHashSet* CPLHashSetNew( CPLHashSetHashFunc fnHashFunc,
                            CPLHashSetEqualFunc fnEqualFunc,
                            CPLHashSetFreeEltFunc fnFreeEltFunc )
 {
-    CPLHashSet* set = static_cast<CPLHashSet *>(CPLMalloc(sizeof(CPLHashSet)));
-    set->fnHashFunc = fnHashFunc ? fnHashFunc : CPLHashSetHashPointer;
-    set->fnEqualFunc = fnEqualFunc ? fnEqualFunc : CPLHashSetEqualPointer;
-    set->fnFreeEltFunc = fnFreeEltFunc;
-    set->nSize = 0;
-    set->tabList = static_cast<CPLList**>(CPLCalloc(sizeof(CPLList*), 53));
-    set->nIndiceAllocatedSize = 0;
-    set->nAllocatedSize = 53;
-    set->psRecyclingList = nullptr;
-    set->nRecyclingListSize = 0;
-    set->bRehash = false;
-#ifdef HASH_DEBUG
-    set->nCollisions = 0;
-#endif
-    return set;
+    return new _CPLHashSet(fnHashFunc ? fnHashFunc : CPLHashSetHashPointer,
+                           fnEqualFunc ? fnEqualFunc : CPLHashSetEqualPointer,
+                           fnFreeEltFunc);
 }
 
 /************************************************************************/
@@ -126,68 +142,27 @@ CPLHashSet* CPLHashSetNew( CPLHashSetHashFunc fnHashFunc,
 int CPLHashSetSize( const CPLHashSet* set )
 {
     CPLAssert(set != nullptr);
-    return set->nSize;
-}
-
-/************************************************************************/
-/*                       CPLHashSetGetNewListElt()                      */
-/************************************************************************/
-
-static CPLList* CPLHashSetGetNewListElt( CPLHashSet* set )
-{
-    if( set->psRecyclingList )
-    {
-        CPLList* psRet = set->psRecyclingList;
-        psRet->pData = nullptr;
-        set->nRecyclingListSize--;
-        set->psRecyclingList = psRet->psNext;
-        return psRet;
-    }
-
-    return static_cast<CPLList *>(CPLMalloc(sizeof(CPLList)));
-}
-
-/************************************************************************/
-/*                       CPLHashSetReturnListElt()                      */
-/************************************************************************/
-
-static void CPLHashSetReturnListElt( CPLHashSet* set, CPLList* psList )
-{
-    if( set->nRecyclingListSize < 128 )
-    {
-        psList->psNext = set->psRecyclingList;
-        set->psRecyclingList = psList;
-        set->nRecyclingListSize++;
-    }
-    else
-    {
-        CPLFree(psList);
-    }
+    return static_cast<int>(set->oMap.Size());
 }
 
 /************************************************************************/
 /*                   CPLHashSetClearInternal()                          */
 /************************************************************************/
 
-static void CPLHashSetClearInternal( CPLHashSet* set, bool bFinalize )
+static void CPLHashSetClearInternal( CPLHashSet* set )
 {
     CPLAssert(set != nullptr);
-    for( int i = 0; i < set->nAllocatedSize; i++ )
+    if( set->fnFreeEltFunc )
     {
-        CPLList* cur = set->tabList[i];
-        while( cur )
-        {
-            if( set->fnFreeEltFunc )
-                set->fnFreeEltFunc(cur->pData);
-            CPLList* psNext = cur->psNext;
-            if( bFinalize )
-                CPLFree(cur);
-            else
-                CPLHashSetReturnListElt(set, cur);
-            cur = psNext;
-        }
-        set->tabList[i] = nullptr;
+        CPLHashSetFreeEltFunc fnFreeEltFunc = set->fnFreeEltFunc;
+        set->oMap.ForEach(
+            [fnFreeEltFunc](const void* const& elt, CPLHashSetNoValue&)
+            {
+                fnFreeEltFunc(const_cast<void*>(elt));
+                return true;
+            });
     }
+    set->oMap.Clear();
     set->bRehash = false;
 }
 
@@ -206,10 +181,8 @@ static void CPLHashSetClearInternal( CPLHashSet* set, bool bFinalize )
 
 void CPLHashSetDestroy( CPLHashSet* set )
 {
-    CPLHashSetClearInternal(set, true);
-    CPLFree(set->tabList);
-    CPLListDestroy(set->psRecyclingList);
-    CPLFree(set);
+    CPLHashSetClearInternal(set);
+    delete set;
 }
 
 /************************************************************************/
@@ -228,15 +201,7 @@ void CPLHashSetDestroy( CPLHashSet* set )
 
 void CPLHashSetClear( CPLHashSet* set )
 {
-    CPLHashSetClearInternal(set, false);
-    set->tabList = static_cast<CPLList**>(
-        CPLRealloc(set->tabList, sizeof(CPLList*) * 53));
-    set->nIndiceAllocatedSize = 0;
-    set->nAllocatedSize = 53;
-#ifdef HASH_DEBUG
-    set->nCollisions = 0;
-#endif
-    set->nSize = 0;
+    CPLHashSetClearInternal(set);
 }
 
 /************************************************************************/
@@ -266,73 +231,11 @@ void CPLHashSetForeach( CPLHashSet* set,
     CPLAssert(set != nullptr);
     if( !fnIterFunc ) return;
 
-    for( int i = 0; i < set->nAllocatedSize; i++ )
-    {
-        CPLList* cur = set->tabList[i];
-        while( cur )
+    set->oMap.ForEach(
+        [fnIterFunc, user_data](const void* const& elt, CPLHashSetNoValue&)
         {
-            if( !fnIterFunc(cur->pData, user_data) )
-                return;
-
-            cur = cur->psNext;
-        }
-    }
-}
-
-/************************************************************************/
-/*                        CPLHashSetRehash()                            */
-/************************************************************************/
-
-static void CPLHashSetRehash( CPLHashSet* set )
-{
-    int nNewAllocatedSize = anPrimes[set->nIndiceAllocatedSize];
-    CPLList** newTabList = static_cast<CPLList **>(
-        CPLCalloc(sizeof(CPLList*), nNewAllocatedSize));
-#ifdef HASH_DEBUG
-    CPLDebug("CPLHASH", "hashSet=%p, nSize=%d, nCollisions=%d, "
-             "fCollisionRate=%.02f",
-             set, set->nSize, set->nCollisions,
-             set->nCollisions * 100.0 / set->nSize);
-    set->nCollisions = 0;
-#endif
-    for( int i = 0; i < set->nAllocatedSize; i++ )
-    {
-        CPLList* cur = set->tabList[i];
-        while( cur )
-        {
-            const unsigned long nNewHashVal =
-                set->fnHashFunc(cur->pData) % nNewAllocatedSize;
-#ifdef HASH_DEBUG
-            if( newTabList[nNewHashVal] )
-                set->nCollisions++;
-#endif
-            CPLList* psNext = cur->psNext;
-            cur->psNext = newTabList[nNewHashVal];
-            newTabList[nNewHashVal] = cur;
-            cur = psNext;
-        }
-    }
-    CPLFree(set->tabList);
-    set->tabList = newTabList;
-    set->nAllocatedSize = nNewAllocatedSize;
-    set->bRehash = false;
-}
-
-/************************************************************************/
-/*                        CPLHashSetFindPtr()                           */
-/************************************************************************/
-
-static void** CPLHashSetFindPtr( CPLHashSet* set, const void* elt )
-{
-    const unsigned long nHashVal = set->fnHashFunc(elt) % set->nAllocatedSize;
-    CPLList* cur = set->tabList[nHashVal];
-    while( cur )
-    {
-        if( set->fnEqualFunc(cur->pData, elt) )
-            return &cur->pData;
-        cur = cur->psNext;
-    }
-    return nullptr;
+            return fnIterFunc(const_cast<void*>(elt), user_data) != FALSE;
+        });
 }
 
 /************************************************************************/
@@ -355,35 +258,33 @@ static void** CPLHashSetFindPtr( CPLHashSet* set, const void* elt )
 int CPLHashSetInsert( CPLHashSet* set, void* elt )
 {
     CPLAssert(set != nullptr);
-    void** pElt = CPLHashSetFindPtr(set, elt);
+    const void** pElt = set->oMap.FindKey(elt);
     if( pElt )
     {
         if( set->fnFreeEltFunc )
-            set->fnFreeEltFunc(*pElt);
+            set->fnFreeEltFunc(const_cast<void*>(*pElt));
 
         *pElt = elt;
         return FALSE;
     }
 
-    if( set->nSize >= 2 * set->nAllocatedSize / 3 ||
-        (set->bRehash && set->nIndiceAllocatedSize > 0 &&
-         set->nSize <= set->nAllocatedSize / 2) )
+    if( set->bRehash )
     {
-        set->nIndiceAllocatedSize++;
-        CPLHashSetRehash(set);
+        set->oMap.ShrinkToFit();
+        set->bRehash = false;
     }
 
-    const unsigned long nHashVal = set->fnHashFunc(elt) % set->nAllocatedSize;
-#ifdef HASH_DEBUG
-    if( set->tabList[nHashVal] )
-        set->nCollisions++;
-#endif
-
-    CPLList* new_elt = CPLHashSetGetNewListElt(set);
-    new_elt->pData = elt;
-    new_elt->psNext = set->tabList[nHashVal];
-    set->tabList[nHashVal] = new_elt;
-    set->nSize++;
+    try
+    {
+        set->oMap.Insert(elt, CPLHashSetNoValue());
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError(CE_Fatal, CPLE_OutOfMemory,
+                 "CPLHashSetInsert(): Out of memory allocating %u elements",
+                 static_cast<unsigned>(set->oMap.Size() + 1));
+        return FALSE;
+    }
 
     return TRUE;
 }
@@ -405,9 +306,9 @@ int CPLHashSetInsert( CPLHashSet* set, void* elt )
 void* CPLHashSetLookup( CPLHashSet* set, const void* elt )
 {
     CPLAssert(set != nullptr);
-    void** pElt = CPLHashSetFindPtr(set, elt);
+    const void** pElt = set->oMap.FindKey(elt);
     if( pElt )
-        return *pElt;
+        return const_cast<void*>(*pElt);
 
     return nullptr;
 }
@@ -421,42 +322,27 @@ bool CPLHashSetRemoveInternal( CPLHashSet* set, const void* elt,
                                bool bDeferRehash )
 {
     CPLAssert(set != nullptr);
-    if( set->nIndiceAllocatedSize > 0 && set->nSize <= set->nAllocatedSize / 2 )
+    const void** pElt = set->oMap.FindKey(elt);
+    if( pElt == nullptr )
+        return false;
+
+    void* pStoredElt = const_cast<void*>(*pElt);
+    set->oMap.Erase(elt);
+
+    if( bDeferRehash )
     {
-        set->nIndiceAllocatedSize--;
-        if( bDeferRehash )
-            set->bRehash = true;
-        else
-            CPLHashSetRehash(set);
+        set->bRehash = true;
     }
-
-    int nHashVal = static_cast<int>(set->fnHashFunc(elt) % set->nAllocatedSize);
-    CPLList* cur = set->tabList[nHashVal];
-    CPLList* prev = nullptr;
-    while( cur )
+    else
     {
-        if( set->fnEqualFunc(cur->pData, elt) )
-        {
-            if( prev )
-                prev->psNext = cur->psNext;
-            else
-                set->tabList[nHashVal] = cur->psNext;
-
-            if( set->fnFreeEltFunc )
-                set->fnFreeEltFunc(cur->pData);
-
-            CPLHashSetReturnListElt(set, cur);
-#ifdef HASH_DEBUG
-            if( set->tabList[nHashVal] )
-                set->nCollisions--;
-#endif
-            set->nSize--;
-            return true;
-        }
-        prev = cur;
-        cur = cur->psNext;
+        set->oMap.ShrinkToFit();
+        set->bRehash = false;
     }
-    return false;
+
+    if( set->fnFreeEltFunc )
+        set->fnFreeEltFunc(pStoredElt);
+
+    return true;
 }
 
 /************************************************************************/
@@ -85,6 +85,7 @@ static CPLMutex *hSessionMapMutex = nullptr;
 static bool bHasCheckVersion = false;
 static bool bSupportGZip = false;
 static bool bSupportHTTP2 = false;
+static CURLSH* hShareHandle = nullptr;
 #if defined(WIN32) && defined(HAVE_OPENSSL_CRYPTO)
 static std::vector<X509*> *poWindowsCertificateList = nullptr;
 
@@ -1816,6 +1817,49 @@ static const char* CPLFindWin32CurlCaBundleCrt()
 
 #endif // WIN32
 
+/************************************************************************/
+/*                        CPLHTTPGetShareHandle()                       */
+/************************************************************************/
+
+static std::mutex gaoShareMutexes[CURL_LOCK_DATA_LAST];
+
+static void CPLHTTPShareLock(CURL*, curl_lock_data data,
+                             curl_lock_access, void*)
+{
+    gaoShareMutexes[data].lock();
+}
+
+static void CPLHTTPShareUnlock(CURL*, curl_lock_data data, void*)
+{
+    gaoShareMutexes[data].unlock();
+}
+
+// Returns a process-wide share handle through which easy handles share
+// their DNS cache, TLS sessions and, with curl >= 7.57, their connection
+// cache, so that connections opened by one thread or one multi handle can
+// be reused by the others.
+void* CPLHTTPGetShareHandle()
+{
+    CPLMutexHolder oHolder( &hSessionMapMutex );
+    if( hShareHandle == nullptr )
+    {
+        hShareHandle = curl_share_init();
+        if( hShareHandle == nullptr )
+            return nullptr;
+        curl_share_setopt(hShareHandle, CURLSHOPT_LOCKFUNC, CPLHTTPShareLock);
+        curl_share_setopt(hShareHandle, CURLSHOPT_UNLOCKFUNC,
+                          CPLHTTPShareUnlock);
+        curl_share_setopt(hShareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(hShareHandle, CURLSHOPT_SHARE,
+                          CURL_LOCK_DATA_SSL_SESSION);
+#if CURL_AT_LEAST_VERSION(7,57,0)
+        curl_share_setopt(hShareHandle, CURLSHOPT_SHARE,
+                          CURL_LOCK_DATA_CONNECT);
+#endif
+    }
+    return hShareHandle;
+}
+
 /************************************************************************/
 /*                         CPLHTTPSetOptions()                          */
 /************************************************************************/
@@ -2368,6 +2412,11 @@ void CPLHTTPCleanup()
             delete poSessionMultiMap;
             poSessionMultiMap = nullptr;
         }
+        if( hShareHandle )
+        {
+            curl_share_cleanup( hShareHandle );
+            hShareHandle = nullptr;
+        }
     }
 
     // Not quite a safe sequence.
@@ -181,6 +181,7 @@ double CPLHTTPGetNewRetryDelay(int response_code, double dfOldDelay,
 void* CPLHTTPIgnoreSigPipe();
 void CPLHTTPRestoreSigPipeHandler(void* old_handler);
 bool CPLMultiPerformWait(void* hCurlMultiHandle, int& repeats);
+void* CPLHTTPGetShareHandle();
 /*! @endcond */
 
 bool CPLIsMachinePotentiallyGCEInstance();
@@ -28,6 +28,7 @@
 
 /*! @cond Doxygen_Suppress */
 
+#include <cmath>
 #include <vector>
 #include <string>
 
@@ -48,15 +49,16 @@ CPLJSonStreamingWriter::~CPLJSonStreamingWriter()
     CPLAssert( m_states.empty() );
 }
 
-void CPLJSonStreamingWriter::Print(const std::string& text)
+// pszText must be nul-terminated at nLen.
+void CPLJSonStreamingWriter::Print(const char* pszText, size_t nLen)
 {
     if( m_pfnSerializationFunc )
     {
-        m_pfnSerializationFunc(text.c_str(), m_pUserData);
+        m_pfnSerializationFunc(pszText, m_pUserData);
     }
     else
     {
-        m_osStr += text;
+        m_osStr.append(pszText, nLen);
     }
 }
 
@@ -82,12 +84,26 @@ void CPLJSonStreamingWriter::DecIndent()
         m_osIndentAcc.resize(m_osIndentAcc.size() - m_osIndent.size());
 }
 
-std::string CPLJSonStreamingWriter::FormatString(const std::string& str)
+void CPLJSonStreamingWriter::PrintString(const char* pszStr, size_t nLen)
 {
-    std::string ret;
+    // Escape directly into the output string, unless a serialization
+    // function is used.
+    std::string& ret = m_pfnSerializationFunc ? m_osTmp : m_osStr;
+    if( m_pfnSerializationFunc )
+        ret.clear();
     ret += '"';
-    for( char ch: str )
+    size_t iStart = 0;
+    for( size_t i = 0; i < nLen; ++i )
     {
+        const char ch = pszStr[i];
+        if( ch != '"' && ch != '\\' &&
+            static_cast<unsigned char>(ch) >= ' ' )
+        {
+            continue;
+        }
+        // Flush the run of characters that need no escaping
+        ret.append(pszStr + iStart, i - iStart);
+        iStart = i + 1;
         switch(ch)
         {
             case '"' : ret += "\\\""; break;
@@ -97,16 +113,15 @@ std::string CPLJSonStreamingWriter::FormatString(const std::string& str)
             case '\n': ret += "\\n";  break;
             case '\r': ret += "\\r";  break;
             case '\t': ret += "\\t";  break;
-            default: 
-                if( static_cast<unsigned char>(ch) < ' ' )
-                    ret += CPLSPrintf("\\u%04X", ch);
-                else
-                    ret += ch;
+            default:
+                ret += CPLSPrintf("\\u%04X", ch);
                 break;
         }
     }
+    ret.append(pszStr + iStart, nLen - iStart);
     ret += '"';
-    return ret;
+    if( m_pfnSerializationFunc )
+        m_pfnSerializationFunc(ret.c_str(), m_pUserData);
 }
 
 void CPLJSonStreamingWriter::EmitCommaIfNeeded()
@@ -189,7 +204,7 @@ void CPLJSonStreamingWriter::AddObjKey(const std::string& key)
     CPLAssert( m_states.back().bIsObj );
     CPLAssert(!m_bWaitForValue);
     EmitCommaIfNeeded();
-    Print(FormatString(key));
+    PrintString(key.c_str(), key.size());
     Print(m_bPretty ? ": " : ":");
     m_bWaitForValue = true;
 }
@@ -203,25 +218,30 @@ void CPLJSonStreamingWriter::Add(bool bVal)
 void CPLJSonStreamingWriter::Add(const std::string& str)
 {
     EmitCommaIfNeeded();
-    Print(FormatString(str));
+    PrintString(str.c_str(), str.size());
 }
 
 void CPLJSonStreamingWriter::Add(const char* pszStr)
 {
     EmitCommaIfNeeded();
-    Print(FormatString(pszStr));
+    PrintString(pszStr, strlen(pszStr));
 }
 
 void CPLJSonStreamingWriter::Add(GIntBig nVal)
 {
     EmitCommaIfNeeded();
-    Print(CPLSPrintf(CPL_FRMT_GIB, nVal));
+    char szBuffer[32];
+    const int nLen = CPLsnprintf(szBuffer, sizeof(szBuffer), CPL_FRMT_GIB, nVal);
+    Print(szBuffer, nLen);
 }
 
 void CPLJSonStreamingWriter::Add(GUInt64 nVal)
 {
     EmitCommaIfNeeded();
-    Print(CPLSPrintf(CPL_FRMT_GUIB, static_cast<GUIntBig>(nVal)));
+    char szBuffer[32];
+    const int nLen = CPLsnprintf(szBuffer, sizeof(szBuffer), CPL_FRMT_GUIB,
+                                 static_cast<GUIntBig>(nVal));
+    Print(szBuffer, nLen);
 }
 
 void CPLJSonStreamingWriter::Add(float fVal, int nPrecision)
@@ -237,9 +257,7 @@ void CPLJSonStreamingWriter::Add(float fVal, int nPrecision)
     }
     else
     {
-        char szFormatting[10];
-        snprintf(szFormatting, sizeof(szFormatting), "%%.%dg", nPrecision);
-        Print(CPLSPrintf(szFormatting, fVal));
+        PrintDouble(fVal, nPrecision);
     }
 }
 
@@ -256,10 +274,46 @@ void CPLJSonStreamingWriter::Add(double dfVal, int nPrecision)
     }
     else
     {
-        char szFormatting[10];
-        snprintf(szFormatting, sizeof(szFormatting), "%%.%dg", nPrecision);
-        Print(CPLSPrintf(szFormatting, dfVal));
+        PrintDouble(dfVal, nPrecision);
+    }
+}
+
+void CPLJSonStreamingWriter::PrintDouble(double dfVal, int nPrecision)
+{
+    char szBuffer[64];
+    // For precisions up to DBL_DIG, when the shortest representation of
+    // the value has no more significant digits than the precision, it is
+    // exactly what the "%.<nPrecision>g" format outputs. It can be computed
+    // without going through the C library in the common case.
+    int nLen = 0;
+    bool bUseShortest = nPrecision <= 15;
+    if( bUseShortest )
+    {
+        nLen = CPLFormatDoubleShortest(szBuffer, sizeof(szBuffer), dfVal);
+        bUseShortest = nLen > 0 && strchr(szBuffer, 'e') == nullptr;
+    }
+    if( bUseShortest )
+    {
+        int nSignificantDigits = 0;
+        bool bLeadingZeros = true;
+        for( int i = 0; i < nLen; ++i )
+        {
+            if( szBuffer[i] >= '1' && szBuffer[i] <= '9' )
+                bLeadingZeros = false;
+            if( !bLeadingZeros && szBuffer[i] >= '0' && szBuffer[i] <= '9' )
+                nSignificantDigits ++;
+        }
+        // "%g" switches to exponent notation for those values
+        const double dfAbs = fabs(dfVal);
+        bUseShortest = nSignificantDigits <= nPrecision &&
+                       dfAbs >= 1e-4 && dfAbs < std::pow(10.0, nPrecision);
+    }
+    if( !bUseShortest )
+    {
+        nLen = CPLsnprintf(szBuffer, sizeof(szBuffer), "%.*g",
+                           nPrecision, dfVal);
     }
+    Print(szBuffer, nLen);
 }
 
 void CPLJSonStreamingWriter::AddNull()
@@ -33,6 +33,7 @@
 
 #if defined(__cplusplus) && !defined(CPL_SUPRESS_CPLUSPLUS)
 
+#include <cstring>
 #include <vector>
 #include <string>
 #include "cpl_port.h"
@@ -47,6 +48,7 @@ private:
     CPLJSonStreamingWriter& operator=(const CPLJSonStreamingWriter&) = delete;
 
     std::string m_osStr{};
+    std::string m_osTmp{};
     SerializationFuncType m_pfnSerializationFunc = nullptr;
     void* m_pUserData = nullptr;
     bool m_bPretty = true;
@@ -63,10 +65,13 @@ private:
     std::vector<State> m_states{};
     bool m_bWaitForValue = false;
 
-    void Print(const std::string& text);
+    void Print(const char* pszText, size_t nLen);
+    void Print(const char* pszText) { Print(pszText, strlen(pszText)); }
+    void Print(const std::string& text) { Print(text.c_str(), text.size()); }
     void IncIndent();
     void DecIndent();
-    static std::string FormatString(const std::string& str);
+    void PrintString(const char* pszStr, size_t nLen);
+    void PrintDouble(double dfVal, int nPrecision);
     void EmitCommaIfNeeded();
 
 public:
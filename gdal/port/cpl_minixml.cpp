@@ -47,6 +47,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <limits>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -74,6 +75,23 @@ typedef struct
     CPLXMLNode *psLastChild;
 } StackContext;
 
+/* Block of memory holding the nodes and strings of a tree parsed with */
+/* CPLParseXMLStringArena(). The first node of the tree is at the */
+/* beginning of the data of the first block. */
+typedef struct CPLXMLArenaBlock CPLXMLArenaBlock;
+struct CPLXMLArenaBlock
+{
+    GUInt32           nMagic;
+    CPLXMLArenaBlock *psNext;
+    size_t            nSize;
+    size_t            nUsed;
+};
+
+constexpr GUInt32 CPL_XML_ARENA_MAGIC = 0x41524E41U;  // "ANRA"
+constexpr size_t CPL_XML_ARENA_HEADER_SIZE =
+    (sizeof(CPLXMLArenaBlock) + 15) / 16 * 16;
+constexpr size_t CPL_XML_ARENA_MAX_BLOCK_SIZE = 64 * 1024 * 1024;
+
 typedef struct {
     const char *pszInput;
     int        nInputOffset;
@@ -90,11 +108,18 @@ typedef struct {
 
     CPLXMLNode *psFirstNode;
     CPLXMLNode *psLastNode;
+
+    bool       bArena;
+    size_t     nArenaInitialSize;
+    CPLXMLArenaBlock *psArenaFirst;
+    CPLXMLArenaBlock *psArenaLast;
 } ParseContext;
 
 static CPLXMLNode *_CPLCreateXMLNode( CPLXMLNode *poParent,
                                       CPLXMLNodeType eType,
                                       const char *pszText );
+static CPLXMLNode *CPLParseXMLStringInternal( const char *pszString,
+                                              bool bArena );
 
 /************************************************************************/
 /*                              ReadChar()                              */
@@ -186,6 +211,40 @@ static CPL_INLINE bool _AddToToken( ParseContext *psContext, char chNewChar )
 #define AddToToken(psContext, chNewChar) \
     if( !_AddToToken(psContext, chNewChar)) goto fail;
 
+/************************************************************************/
+/*                          AddToTokenUntil()                           */
+/************************************************************************/
+
+/* Appends to the token all input characters up to, but not including, the */
+/* next chStop character or the end of the input. */
+static bool AddToTokenUntil( ParseContext *psContext, char chStop )
+
+{
+    const char *pszStart = psContext->pszInput + psContext->nInputOffset;
+    const char *pszIter = pszStart;
+    int nNewLines = 0;
+    while( *pszIter != chStop && *pszIter != '\0' )
+    {
+        if( *pszIter == 10 )
+            nNewLines++;
+        pszIter++;
+    }
+
+    const size_t nLen = static_cast<size_t>(pszIter - pszStart);
+    while( psContext->nTokenSize + nLen >= psContext->nTokenMaxSize - 2 )
+    {
+        if( !ReallocToken(psContext) )
+            return false;
+    }
+
+    memcpy(psContext->pszToken + psContext->nTokenSize, pszStart, nLen);
+    psContext->nTokenSize += nLen;
+    psContext->pszToken[psContext->nTokenSize] = '\0';
+    psContext->nInputOffset += static_cast<int>(nLen);
+    psContext->nInputLine += nNewLines;
+    return true;
+}
+
 /************************************************************************/
 /*                             ReadToken()                              */
 /************************************************************************/
@@ -384,9 +443,9 @@ static XMLTokenType ReadToken( ParseContext *psContext, CPLErr& eLastErrorType )
     {
         psContext->eTokenType = TString;
 
-        while( (chNext = ReadChar(psContext)) != '"'
-               && chNext != '\0' )
-            AddToToken( psContext, chNext );
+        if( !AddToTokenUntil( psContext, '"' ) )
+            goto fail;
+        chNext = ReadChar(psContext);
 
         if( chNext != '"' )
         {
@@ -412,9 +471,9 @@ static XMLTokenType ReadToken( ParseContext *psContext, CPLErr& eLastErrorType )
     {
         psContext->eTokenType = TString;
 
-        while( (chNext = ReadChar(psContext)) != '\''
-               && chNext != '\0' )
-            AddToToken( psContext, chNext );
+        if( !AddToTokenUntil( psContext, '\'' ) )
+            goto fail;
+        chNext = ReadChar(psContext);
 
         if( chNext != '\'' )
         {
@@ -445,10 +504,8 @@ static XMLTokenType ReadToken( ParseContext *psContext, CPLErr& eLastErrorType )
         psContext->eTokenType = TString;
 
         AddToToken( psContext, chNext );
-        while( (chNext = ReadChar(psContext)) != '<'
-               && chNext != '\0' )
-            AddToToken( psContext, chNext );
-        UnreadChar( psContext, chNext );
+        if( !AddToTokenUntil( psContext, '<' ) )
+            goto fail;
 
         // Do we need to unescape it?
         if( strchr(psContext->pszToken, '&') != nullptr )
@@ -496,6 +553,112 @@ fail:
     return TNone;
 }
 
+/************************************************************************/
+/*                             ArenaAlloc()                             */
+/************************************************************************/
+
+static void *ArenaAlloc( ParseContext *psContext, size_t nBytes, bool bAlign )
+
+{
+    CPLXMLArenaBlock *psBlock = psContext->psArenaLast;
+    if( psBlock != nullptr )
+    {
+        size_t nOffset = psBlock->nUsed;
+        if( bAlign )
+        {
+            constexpr size_t nAlign = alignof(CPLXMLNode);
+            nOffset = (nOffset + nAlign - 1) / nAlign * nAlign;
+        }
+        if( nOffset <= psBlock->nSize && nBytes <= psBlock->nSize - nOffset )
+        {
+            psBlock->nUsed = nOffset + nBytes;
+            return reinterpret_cast<GByte *>(psBlock) +
+                   CPL_XML_ARENA_HEADER_SIZE + nOffset;
+        }
+    }
+
+    size_t nBlockSize = psBlock == nullptr ? psContext->nArenaInitialSize :
+        std::min(psBlock->nSize * 2, CPL_XML_ARENA_MAX_BLOCK_SIZE);
+    nBlockSize = std::max(nBlockSize, nBytes);
+    if( nBlockSize > std::numeric_limits<size_t>::max() -
+                                            CPL_XML_ARENA_HEADER_SIZE )
+        return nullptr;
+    CPLXMLArenaBlock *psNewBlock = static_cast<CPLXMLArenaBlock *>(
+        VSIMalloc(CPL_XML_ARENA_HEADER_SIZE + nBlockSize));
+    if( psNewBlock == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate " CPL_FRMT_GUIB " bytes",
+                 static_cast<GUIntBig>(CPL_XML_ARENA_HEADER_SIZE + nBlockSize));
+        return nullptr;
+    }
+    psNewBlock->nMagic = CPL_XML_ARENA_MAGIC;
+    psNewBlock->psNext = nullptr;
+    psNewBlock->nSize = nBlockSize;
+    psNewBlock->nUsed = nBytes;
+    if( psBlock == nullptr )
+        psContext->psArenaFirst = psNewBlock;
+    else
+        psBlock->psNext = psNewBlock;
+    psContext->psArenaLast = psNewBlock;
+    return reinterpret_cast<GByte *>(psNewBlock) + CPL_XML_ARENA_HEADER_SIZE;
+}
+
+/************************************************************************/
+/*                           FreeArenaBlocks()                          */
+/************************************************************************/
+
+static void FreeArenaBlocks( CPLXMLArenaBlock *psBlock )
+
+{
+    while( psBlock != nullptr )
+    {
+        CPLXMLArenaBlock *psNext = psBlock->psNext;
+        VSIFree(psBlock);
+        psBlock = psNext;
+    }
+}
+
+/************************************************************************/
+/*                         CreateParsedNode()                           */
+/*                                                                      */
+/*      Create a node whose value is the current token, either in the   */
+/*      arena or with the regular allocator.                            */
+/************************************************************************/
+
+static CPLXMLNode *CreateParsedNode( ParseContext *psContext,
+                                     CPLXMLNode *poParent,
+                                     CPLXMLNodeType eType )
+
+{
+    if( !psContext->bArena )
+        return _CPLCreateXMLNode( poParent, eType, psContext->pszToken );
+
+    CPLXMLNode *psNode = static_cast<CPLXMLNode *>(
+        ArenaAlloc(psContext, sizeof(CPLXMLNode), true));
+    if( psNode == nullptr )
+        return nullptr;
+    char *pszValue = static_cast<char *>(
+        ArenaAlloc(psContext, psContext->nTokenSize + 1, false));
+    if( pszValue == nullptr )
+        return nullptr;
+    memcpy(pszValue, psContext->pszToken, psContext->nTokenSize + 1);
+
+    psNode->eType = eType;
+    psNode->pszValue = pszValue;
+    psNode->psNext = nullptr;
+    psNode->psChild = nullptr;
+
+    // Only used to attach the value of an attribute, which has no child yet.
+    if( poParent != nullptr )
+    {
+        CPLAssert( poParent->psChild == nullptr );
+        poParent->psChild = psNode;
+    }
+
+    return psNode;
+}
+
 /************************************************************************/
 /*                              PushNode()                              */
 /************************************************************************/
@@ -622,6 +785,59 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
         return nullptr;
     }
 
+    return CPLParseXMLStringInternal( pszString, false );
+}
+
+/************************************************************************/
+/*                       CPLParseXMLStringArena()                       */
+/************************************************************************/
+
+/**
+ * \brief Parse an XML string into a read-only tree.
+ *
+ * This function is similar to CPLParseXMLString(), except that all the
+ * nodes and strings of the returned tree are allocated in a few large
+ * memory blocks, which makes parsing and destruction of large documents
+ * significantly faster.
+ *
+ * The returned tree can be inspected with the regular functions
+ * (CPLGetXMLNode(), CPLGetXMLValue(), CPLSerializeXMLTree(),
+ * CPLCloneXMLTree(), etc.), but must not be modified, apart from temporarily
+ * changing node links, and no node of it may be passed to
+ * CPLDestroyXMLNode(), CPLSetXMLValue(), CPLRemoveXMLChild() or other
+ * functions that free or reallocate nodes or values. It must be freed with
+ * CPLDestroyXMLArenaTree(). CPLCloneXMLTree() can be used to get a regular
+ * copy of a subtree.
+ *
+ * @param pszString the document to parse.
+ *
+ * @return parsed tree or NULL on error.
+ *
+ * @since GDAL 3.4
+ */
+
+CPLXMLNode *CPLParseXMLStringArena( const char *pszString )
+
+{
+    if( pszString == nullptr )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "CPLParseXMLStringArena() called with NULL pointer." );
+        return nullptr;
+    }
+
+    return CPLParseXMLStringInternal( pszString, true );
+}
+
+/************************************************************************/
+/*                     CPLParseXMLStringInternal()                      */
+/************************************************************************/
+
+static CPLXMLNode *CPLParseXMLStringInternal( const char *pszString,
+                                              bool bArena )
+
+{
+
     // Save back error context.
     const CPLErr eErrClass = CPLGetLastErrorType();
     const CPLErrorNum nErrNum = CPLGetLastErrorNo();
@@ -664,6 +880,18 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
     sContext.papsStack = nullptr;
     sContext.psFirstNode = nullptr;
     sContext.psLastNode = nullptr;
+    sContext.bArena = bArena;
+    sContext.nArenaInitialSize = 0;
+    sContext.psArenaFirst = nullptr;
+    sContext.psArenaLast = nullptr;
+    if( bArena )
+    {
+        // Nodes and values usually take less than 1.5 times the size of
+        // the document.
+        const size_t nLen = strlen(pszString);
+        sContext.nArenaInitialSize = std::max(static_cast<size_t>(4096),
+            std::min(nLen + nLen / 2, CPL_XML_ARENA_MAX_BLOCK_SIZE));
+    }
 
 #ifdef DEBUG
     bool bRecoverableError = true;
@@ -693,8 +921,8 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
             CPLXMLNode *psElement = nullptr;
             if( sContext.pszToken[0] != '/' )
             {
-                psElement = _CPLCreateXMLNode( nullptr, CXT_Element,
-                                              sContext.pszToken );
+                psElement = CreateParsedNode( &sContext, nullptr,
+                                              CXT_Element );
                 if( !psElement ) break;
                 AttachNode( &sContext, psElement );
                 if( !PushNode( &sContext, psElement, eLastErrorType ) )
@@ -780,7 +1008,7 @@ end_processing_close:
         else if( sContext.eTokenType == TToken )
         {
             CPLXMLNode *psAttr =
-                _CPLCreateXMLNode(nullptr, CXT_Attribute, sContext.pszToken);
+                CreateParsedNode(&sContext, nullptr, CXT_Attribute);
             if( !psAttr ) break;
             AttachNode( &sContext, psAttr );
 
@@ -794,19 +1022,38 @@ end_processing_close:
                       sContext.papsStack[sContext.nStackSize - 1]
                               .psFirstNode->psChild == psAttr )
                 {
-                    CPLDestroyXMLNode(psAttr);
                     sContext.papsStack[sContext.nStackSize - 1]
                         .psFirstNode->psChild = nullptr;
                     sContext.papsStack[sContext.nStackSize - 1].psLastChild =
                         nullptr;
 
-                    sContext.papsStack[sContext.nStackSize - 1]
-                        .psFirstNode->pszValue = static_cast<char *>(CPLRealloc(
-                        sContext.papsStack[sContext.nStackSize - 1]
-                            .psFirstNode->pszValue,
+                    const size_t nNewSize =
                         strlen(sContext.papsStack[sContext.nStackSize - 1]
                                    .psFirstNode->pszValue) +
-                            1 + strlen(sContext.pszToken) + 1));
+                            1 + strlen(sContext.pszToken) + 1;
+                    if( sContext.bArena )
+                    {
+                        // The attribute node remains unused in the arena.
+                        char *pszNewValue = static_cast<char *>(
+                            ArenaAlloc(&sContext, nNewSize, false));
+                        if( pszNewValue == nullptr )
+                            break;
+                        strcpy(pszNewValue,
+                               sContext.papsStack[sContext.nStackSize - 1]
+                                   .psFirstNode->pszValue);
+                        sContext.papsStack[sContext.nStackSize - 1]
+                            .psFirstNode->pszValue = pszNewValue;
+                    }
+                    else
+                    {
+                        CPLDestroyXMLNode(psAttr);
+                        sContext.papsStack[sContext.nStackSize - 1]
+                            .psFirstNode->pszValue = static_cast<char *>(
+                                CPLRealloc(
+                                    sContext.papsStack[sContext.nStackSize - 1]
+                                        .psFirstNode->pszValue,
+                                    nNewSize));
+                    }
                     strcat(sContext.papsStack[sContext.nStackSize - 1]
                                .psFirstNode->pszValue,
                            " ");
@@ -854,7 +1101,7 @@ end_processing_close:
                 break;
             }
 
-            if( !_CPLCreateXMLNode( psAttr, CXT_Text, sContext.pszToken ) )
+            if( !CreateParsedNode( &sContext, psAttr, CXT_Text ) )
                 break;
         }
 
@@ -924,7 +1171,7 @@ end_processing_close:
         else if( sContext.eTokenType == TComment )
         {
             CPLXMLNode *psValue =
-                _CPLCreateXMLNode(nullptr, CXT_Comment, sContext.pszToken);
+                CreateParsedNode(&sContext, nullptr, CXT_Comment);
             if( !psValue ) break;
             AttachNode( &sContext, psValue );
         }
@@ -934,7 +1181,7 @@ end_processing_close:
         else if( sContext.eTokenType == TLiteral )
         {
             CPLXMLNode *psValue =
-                _CPLCreateXMLNode(nullptr, CXT_Literal, sContext.pszToken);
+                CreateParsedNode(&sContext, nullptr, CXT_Literal);
             if( !psValue ) break;
             AttachNode( &sContext, psValue );
         }
@@ -944,7 +1191,7 @@ end_processing_close:
         else if( sContext.eTokenType == TString && !sContext.bInElement )
         {
             CPLXMLNode *psValue =
-                _CPLCreateXMLNode(nullptr, CXT_Text, sContext.pszToken);
+                CreateParsedNode(&sContext, nullptr, CXT_Text);
             if( !psValue ) break;
             AttachNode( &sContext, psValue );
         }
@@ -998,10 +1245,21 @@ end_processing_close:
     // has been set we would never get failures
     if( eLastErrorType == CE_Failure )
     {
-        CPLDestroyXMLNode( sContext.psFirstNode );
+        if( bArena )
+            FreeArenaBlocks( sContext.psArenaFirst );
+        else
+            CPLDestroyXMLNode( sContext.psFirstNode );
         sContext.psFirstNode = nullptr;
         sContext.psLastNode = nullptr;
     }
+    else if( bArena && sContext.psFirstNode == nullptr )
+    {
+        FreeArenaBlocks( sContext.psArenaFirst );
+    }
+    CPLAssert( !bArena || sContext.psFirstNode == nullptr ||
+               reinterpret_cast<GByte *>(sContext.psFirstNode) ==
+                   reinterpret_cast<GByte *>(sContext.psArenaFirst) +
+                       CPL_XML_ARENA_HEADER_SIZE );
 
     if( eLastErrorType == CE_None )
     {
@@ -1434,6 +1692,38 @@ void CPLDestroyXMLNode( CPLXMLNode *psNode )
     }
 }
 
+/************************************************************************/
+/*                       CPLDestroyXMLArenaTree()                       */
+/************************************************************************/
+
+/**
+ * \brief Destroy a tree returned by CPLParseXMLStringArena().
+ *
+ * @param psTree the tree to free, as returned by CPLParseXMLStringArena() or
+ * CPLParseXMLFileArena(). NULL is safe.
+ *
+ * @since GDAL 3.4
+ */
+
+void CPLDestroyXMLArenaTree( CPLXMLNode *psTree )
+
+{
+    if( psTree == nullptr )
+        return;
+
+    CPLXMLArenaBlock *psBlock = reinterpret_cast<CPLXMLArenaBlock *>(
+        reinterpret_cast<GByte *>(psTree) - CPL_XML_ARENA_HEADER_SIZE);
+    if( psBlock->nMagic != CPL_XML_ARENA_MAGIC )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "CPLDestroyXMLArenaTree(): not a tree returned by "
+                 "CPLParseXMLStringArena()");
+        return;
+    }
+    psBlock->nMagic = 0;
+    FreeArenaBlocks( psBlock );
+}
+
 /************************************************************************/
 /*                           CPLSearchXMLNode()                         */
 /************************************************************************/
@@ -2151,6 +2441,38 @@ CPLXMLNode *CPLParseXMLFile( const char *pszFilename )
     return psTree;
 }
 
+/************************************************************************/
+/*                        CPLParseXMLFileArena()                        */
+/************************************************************************/
+
+/**
+ * \brief Parse XML file into a read-only tree.
+ *
+ * Same as CPLParseXMLFile(), but the document is parsed with
+ * CPLParseXMLStringArena(). The returned tree must be freed with
+ * CPLDestroyXMLArenaTree().
+ *
+ * @param pszFilename the file to open.
+ *
+ * @return NULL on failure, or the document tree on success.
+ *
+ * @since GDAL 3.4
+ */
+
+CPLXMLNode *CPLParseXMLFileArena( const char *pszFilename )
+
+{
+    GByte *pabyOut = nullptr;
+    if( !VSIIngestFile( nullptr, pszFilename, &pabyOut, nullptr, -1 ) )
+        return nullptr;
+
+    char *pszDoc = reinterpret_cast<char *>(pabyOut);
+    CPLXMLNode *psTree = CPLParseXMLStringArena( pszDoc );
+    CPLFree( pszDoc );
+
+    return psTree;
+}
+
 /************************************************************************/
 /*                     CPLSerializeXMLTreeToFile()                      */
 /************************************************************************/
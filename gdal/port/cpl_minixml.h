@@ -179,6 +179,10 @@ void       CPL_DLL CPLStripXMLNamespace( CPLXMLNode *psRoot,
 void       CPL_DLL CPLCleanXMLElementName( char * );
 
 CPLXMLNode CPL_DLL *CPLParseXMLFile( const char *pszFilename );
+
+CPLXMLNode CPL_DLL *CPLParseXMLStringArena( const char *pszString );
+CPLXMLNode CPL_DLL *CPLParseXMLFileArena( const char *pszFilename );
+void       CPL_DLL  CPLDestroyXMLArenaTree( CPLXMLNode *psTree );
 int        CPL_DLL CPLSerializeXMLTreeToFile( const CPLXMLNode *psTree,
                                               const char *pszFilename );
 
@@ -214,6 +218,26 @@ class CPLXMLTreeCloser: public std::unique_ptr<CPLXMLNode, CPLXMLTreeCloserDelet
   CPLXMLNode* getDocumentElement();
 };
 
+/*! @cond Doxygen_Suppress */
+struct CPLXMLArenaTreeCloserDeleter
+{
+    void operator()(CPLXMLNode* psNode) const { CPLDestroyXMLArenaTree(psNode); }
+};
+/*! @endcond */
+
+/** Manage a read-only tree returned by CPLParseXMLStringArena() or
+ * CPLParseXMLFileArena(), so that it is freed when the instance goes out of
+ * scope.
+ * @since GDAL 3.4
+ */
+class CPLXMLArenaTreeCloser: public std::unique_ptr<CPLXMLNode, CPLXMLArenaTreeCloserDeleter>
+{
+ public:
+  /** Constructor */
+  explicit CPLXMLArenaTreeCloser(CPLXMLNode* data):
+    std::unique_ptr<CPLXMLNode, CPLXMLArenaTreeCloserDeleter>(data) {}
+};
+
 } // extern "C++"
 
 #endif /* __cplusplus */
@@ -0,0 +1,270 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Open addressing hash map
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef CPL_OPEN_HASH_MAP_H_INCLUDED
+#define CPL_OPEN_HASH_MAP_H_INCLUDED
+
+/*! @cond Doxygen_Suppress */
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "cpl_port.h"
+
+/** Hash map using open addressing with linear probing.
+ *
+ * Keys and values are stored inline in a single power-of-two sized array,
+ * so that lookups do not allocate nor chase pointers. Deletion uses backward
+ * shifting, so that no tombstone is left in the table.
+ *
+ * The hash function result is mixed before use, so that weak hash functions,
+ * such as ones returning pointer values, are acceptable.
+ *
+ * Key and Value must be default constructible and copy or move assignable.
+ * Pointers returned by Find() or Insert() are invalidated by any subsequent
+ * insertion or removal.
+ */
+template<class Key, class Value,
+         class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+class CPLOpenHashMap
+{
+    struct Slot
+    {
+        Key   key{};
+        Value value{};
+        bool  bUsed = false;
+    };
+
+    std::vector<Slot> m_aoSlots{};
+    size_t            m_nSize = 0;
+    int               m_nShift = 64;
+    Hash              m_oHash;
+    KeyEqual          m_oEqual;
+
+    static constexpr size_t MIN_CAPACITY = 16;
+
+    size_t GetIdx(const Key& key) const
+    {
+        // Fibonacci hashing
+        const GUInt64 nHash =
+            static_cast<GUInt64>(m_oHash(key)) * 11400714819323198485ULL;
+        return static_cast<size_t>(nHash >> m_nShift);
+    }
+
+    size_t GetMask() const { return m_aoSlots.size() - 1; }
+
+    // Returns the index of the slot holding key, or of the empty slot where
+    // it should be inserted.
+    size_t Probe(const Key& key) const
+    {
+        const size_t nMask = GetMask();
+        size_t i = GetIdx(key);
+        while( m_aoSlots[i].bUsed && !m_oEqual(m_aoSlots[i].key, key) )
+            i = (i + 1) & nMask;
+        return i;
+    }
+
+    void Rehash(size_t nNewCapacity)
+    {
+        std::vector<Slot> aoOldSlots(nNewCapacity);
+        std::swap(aoOldSlots, m_aoSlots);
+        int nLog2 = 0;
+        while( (static_cast<size_t>(1) << nLog2) < nNewCapacity )
+            nLog2 ++;
+        m_nShift = 64 - nLog2;
+        const size_t nMask = GetMask();
+        for( auto& oSlot: aoOldSlots )
+        {
+            if( !oSlot.bUsed )
+                continue;
+            size_t i = GetIdx(oSlot.key);
+            while( m_aoSlots[i].bUsed )
+                i = (i + 1) & nMask;
+            m_aoSlots[i] = std::move(oSlot);
+        }
+    }
+
+    // Capacity such that the load factor stays below 3/4.
+    static size_t GetCapacityFor(size_t nElts)
+    {
+        size_t nCapacity = MIN_CAPACITY;
+        while( nCapacity / 4 * 3 < nElts + 1 )
+            nCapacity *= 2;
+        return nCapacity;
+    }
+
+  public:
+    explicit CPLOpenHashMap(const Hash& oHash = Hash(),
+                            const KeyEqual& oEqual = KeyEqual()):
+        m_oHash(oHash), m_oEqual(oEqual)
+    {}
+
+    /** Returns the number of elements. */
+    size_t Size() const { return m_nSize; }
+
+    /** Returns whether the map is empty. */
+    bool Empty() const { return m_nSize == 0; }
+
+    /** Removes all elements and releases memory. */
+    void Clear()
+    {
+        std::vector<Slot>().swap(m_aoSlots);
+        m_nSize = 0;
+        m_nShift = 64;
+    }
+
+    /** Makes room for at least nElts elements without rehashing. */
+    void Reserve(size_t nElts)
+    {
+        const size_t nCapacity = GetCapacityFor(nElts);
+        if( nCapacity > m_aoSlots.size() )
+            Rehash(nCapacity);
+    }
+
+    /** Returns a pointer to the value associated with key, or nullptr. */
+    Value* Find(const Key& key)
+    {
+        if( m_nSize == 0 )
+            return nullptr;
+        Slot& oSlot = m_aoSlots[Probe(key)];
+        return oSlot.bUsed ? &oSlot.value : nullptr;
+    }
+
+    /** Returns a pointer to the value associated with key, or nullptr. */
+    const Value* Find(const Key& key) const
+    {
+        if( m_nSize == 0 )
+            return nullptr;
+        const Slot& oSlot = m_aoSlots[Probe(key)];
+        return oSlot.bUsed ? &oSlot.value : nullptr;
+    }
+
+    /** Returns a pointer to the stored key equal to key, or nullptr.
+     *
+     * The stored key may be replaced through that pointer by a key that
+     * is equal to it and has the same hash.
+     */
+    Key* FindKey(const Key& key)
+    {
+        if( m_nSize == 0 )
+            return nullptr;
+        Slot& oSlot = m_aoSlots[Probe(key)];
+        return oSlot.bUsed ? &oSlot.key : nullptr;
+    }
+
+    /** Inserts (key, value) if key is not already present.
+     *
+     * @return a pointer to the value associated with key, and whether the
+     * insertion took place. If it did not, the existing value is left
+     * unchanged.
+     */
+    std::pair<Value*, bool> Insert(const Key& key, const Value& value)
+    {
+        if( m_aoSlots.empty() || (m_nSize + 1) > m_aoSlots.size() / 4 * 3 )
+        {
+            // Check first if the key is present to avoid useless growing.
+            Value* pExisting = Find(key);
+            if( pExisting )
+                return std::pair<Value*, bool>(pExisting, false);
+            Rehash(GetCapacityFor(m_nSize + 1));
+        }
+        Slot& oSlot = m_aoSlots[Probe(key)];
+        if( oSlot.bUsed )
+            return std::pair<Value*, bool>(&oSlot.value, false);
+        oSlot.key = key;
+        oSlot.value = value;
+        oSlot.bUsed = true;
+        m_nSize ++;
+        return std::pair<Value*, bool>(&oSlot.value, true);
+    }
+
+    /** Removes key. Returns whether it was present. */
+    bool Erase(const Key& key)
+    {
+        if( m_nSize == 0 )
+            return false;
+        const size_t nMask = GetMask();
+        size_t i = Probe(key);
+        if( !m_aoSlots[i].bUsed )
+            return false;
+
+        // Backward shift deletion: move back following elements of the
+        // cluster that are not at their ideal position.
+        size_t j = i;
+        while( true )
+        {
+            j = (j + 1) & nMask;
+            if( !m_aoSlots[j].bUsed )
+                break;
+            const size_t k = GetIdx(m_aoSlots[j].key);
+            // Skip elements whose ideal slot k is cyclically in ]i, j]
+            if( (i <= j) ? (i < k && k <= j) : (i < k || k <= j) )
+                continue;
+            m_aoSlots[i] = std::move(m_aoSlots[j]);
+            i = j;
+        }
+        m_aoSlots[i] = Slot();
+        m_nSize --;
+        return true;
+    }
+
+    /** Shrinks the storage if the load factor has fallen below 1/4.
+     *
+     * The hysteresis with the growth threshold avoids rehashing repeatedly
+     * when alternating insertions and removals.
+     */
+    void ShrinkToFit()
+    {
+        if( m_aoSlots.size() > MIN_CAPACITY && m_nSize < m_aoSlots.size() / 4 )
+            Rehash(GetCapacityFor(m_nSize));
+    }
+
+    /** Calls f(const Key&, Value&) on each element, in unspecified order,
+     * until it returns false.
+     *
+     * The map must not be modified during the walk.
+     *
+     * @return false if the walk was interrupted.
+     */
+    template<class F> bool ForEach(F&& f)
+    {
+        for( auto& oSlot: m_aoSlots )
+        {
+            if( oSlot.bUsed && !f(static_cast<const Key&>(oSlot.key),
+                                  oSlot.value) )
+                return false;
+        }
+        return true;
+    }
+};
+
+/*! @endcond */
+
+#endif // CPL_OPEN_HASH_MAP_H_INCLUDED
@@ -0,0 +1,257 @@
+/******************************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Static packed Hilbert R-tree
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_packed_rtree.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+CPL_CVSID("$Id$")
+
+//! @cond Doxygen_Suppress
+
+/************************************************************************/
+/*                          HilbertXYToIndex()                          */
+/************************************************************************/
+
+// Position along a Hilbert curve of order 16 of (x, y), x and y being in
+// [0, 65535]. Uses the branch-free algorithm of
+// http://threadlocalmutex.com/?p=126, also used by FlatGeobuf.
+static GUInt32 HilbertXYToIndex( GUInt32 x, GUInt32 y )
+{
+    GUInt32 a = x ^ y;
+    GUInt32 b = 0xFFFF ^ a;
+    GUInt32 c = 0xFFFF ^ (x | y);
+    GUInt32 d = x & (y ^ 0xFFFF);
+
+    GUInt32 A = a | (b >> 1);
+    GUInt32 B = (a >> 1) ^ a;
+    GUInt32 C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    GUInt32 D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+    a = A; b = B; c = C; d = D;
+    A = ((a & (a >> 2)) ^ (b & (b >> 2)));
+    B = ((a & (b >> 2)) ^ (b & ((a ^ b) >> 2)));
+    C ^= ((a & (c >> 2)) ^ (b & (d >> 2)));
+    D ^= ((b & (c >> 2)) ^ ((a ^ b) & (d >> 2)));
+
+    a = A; b = B; c = C; d = D;
+    A = ((a & (a >> 4)) ^ (b & (b >> 4)));
+    B = ((a & (b >> 4)) ^ (b & ((a ^ b) >> 4)));
+    C ^= ((a & (c >> 4)) ^ (b & (d >> 4)));
+    D ^= ((b & (c >> 4)) ^ ((a ^ b) & (d >> 4)));
+
+    a = A; b = B; c = C; d = D;
+    C ^= ((a & (c >> 8)) ^ (b & (d >> 8)));
+    D ^= ((b & (c >> 8)) ^ ((a ^ b) & (d >> 8)));
+
+    a = C ^ (C >> 1);
+    b = D ^ (D >> 1);
+
+    GUInt32 i0 = x ^ y;
+    GUInt32 i1 = b | (0xFFFF ^ (i0 | a));
+
+    i0 = (i0 | (i0 << 8)) & 0x00FF00FF;
+    i0 = (i0 | (i0 << 4)) & 0x0F0F0F0F;
+    i0 = (i0 | (i0 << 2)) & 0x33333333;
+    i0 = (i0 | (i0 << 1)) & 0x55555555;
+
+    i1 = (i1 | (i1 << 8)) & 0x00FF00FF;
+    i1 = (i1 | (i1 << 4)) & 0x0F0F0F0F;
+    i1 = (i1 | (i1 << 2)) & 0x33333333;
+    i1 = (i1 | (i1 << 1)) & 0x55555555;
+
+    return (i1 << 1) | i0;
+}
+
+/************************************************************************/
+/*                         GetHilbertCoord()                            */
+/************************************************************************/
+
+static GUInt32 GetHilbertCoord( double dfVal, double dfMin, double dfScale )
+{
+    const double dfCoord = (dfVal - dfMin) * dfScale;
+    // Also catches NaN
+    if( !(dfCoord >= 0) )
+        return 0;
+    if( dfCoord >= 65535 )
+        return 65535;
+    return static_cast<GUInt32>(dfCoord);
+}
+
+/************************************************************************/
+/*                            Overlaps()                                */
+/************************************************************************/
+
+static inline bool Overlaps( const CPLRectObj& a, const CPLRectObj& b )
+{
+    return !(a.minx > b.maxx || a.maxx < b.minx ||
+             a.miny > b.maxy || a.maxy < b.miny);
+}
+
+/************************************************************************/
+/*                          CPLPackedRTree()                            */
+/************************************************************************/
+
+/** Builds the tree.
+ *
+ * May throw std::bad_alloc.
+ *
+ * @param pasItemBounds array of nItems bounding boxes.
+ * @param nItems number of items.
+ * @param nNodeSize maximum number of children of a node. Must be >= 2.
+ */
+CPLPackedRTree::CPLPackedRTree( const CPLRectObj* pasItemBounds,
+                                size_t nItems, int nNodeSize ):
+    m_nItems(nItems),
+    m_nNodeSize(std::max(2, nNodeSize))
+{
+    if( nItems == 0 )
+        return;
+
+    // Compute the extent of the item centers.
+    double dfMinX = std::numeric_limits<double>::infinity();
+    double dfMinY = std::numeric_limits<double>::infinity();
+    double dfMaxX = -std::numeric_limits<double>::infinity();
+    double dfMaxY = -std::numeric_limits<double>::infinity();
+    for( size_t i = 0; i < nItems; i++ )
+    {
+        const double dfX = (pasItemBounds[i].minx + pasItemBounds[i].maxx) / 2;
+        const double dfY = (pasItemBounds[i].miny + pasItemBounds[i].maxy) / 2;
+        dfMinX = std::min(dfMinX, dfX);
+        dfMinY = std::min(dfMinY, dfY);
+        dfMaxX = std::max(dfMaxX, dfX);
+        dfMaxY = std::max(dfMaxY, dfY);
+    }
+    const double dfScaleX =
+        dfMaxX > dfMinX ? 65535.0 / (dfMaxX - dfMinX) : 0.0;
+    const double dfScaleY =
+        dfMaxY > dfMinY ? 65535.0 / (dfMaxY - dfMinY) : 0.0;
+
+    // Sort items along the Hilbert curve.
+    std::vector<std::pair<GUInt32, size_t>> aoHilbert;
+    aoHilbert.reserve(nItems);
+    for( size_t i = 0; i < nItems; i++ )
+    {
+        const double dfX = (pasItemBounds[i].minx + pasItemBounds[i].maxx) / 2;
+        const double dfY = (pasItemBounds[i].miny + pasItemBounds[i].maxy) / 2;
+        aoHilbert.emplace_back(
+            HilbertXYToIndex(GetHilbertCoord(dfX, dfMinX, dfScaleX),
+                             GetHilbertCoord(dfY, dfMinY, dfScaleY)), i);
+    }
+    std::sort(aoHilbert.begin(), aoHilbert.end());
+
+    // Compute the number of nodes of each level.
+    const size_t nMaxChildren = static_cast<size_t>(m_nNodeSize);
+    size_t nLevelNodes = nItems;
+    size_t nNodes = nItems;
+    m_anLevelEnds.push_back(nNodes);
+    while( nLevelNodes > 1 )
+    {
+        nLevelNodes = (nLevelNodes + nMaxChildren - 1) / nMaxChildren;
+        nNodes += nLevelNodes;
+        m_anLevelEnds.push_back(nNodes);
+    }
+
+    m_asNodeBounds.resize(nNodes);
+    m_anNodeIndices.resize(nNodes);
+    for( size_t i = 0; i < nItems; i++ )
+    {
+        m_asNodeBounds[i] = pasItemBounds[aoHilbert[i].second];
+        m_anNodeIndices[i] = aoHilbert[i].second;
+    }
+
+    // Build upper levels from the leaves.
+    size_t nPos = 0;
+    size_t nNewPos = nItems;
+    for( size_t iLevel = 0; iLevel + 1 < m_anLevelEnds.size(); iLevel++ )
+    {
+        const size_t nLevelEnd = m_anLevelEnds[iLevel];
+        while( nPos < nLevelEnd )
+        {
+            CPLRectObj sBounds = m_asNodeBounds[nPos];
+            m_anNodeIndices[nNewPos] = nPos;
+            const size_t nGroupEnd = std::min(nPos + nMaxChildren, nLevelEnd);
+            for( ++nPos; nPos < nGroupEnd; ++nPos )
+            {
+                const CPLRectObj& sChild = m_asNodeBounds[nPos];
+                sBounds.minx = std::min(sBounds.minx, sChild.minx);
+                sBounds.miny = std::min(sBounds.miny, sChild.miny);
+                sBounds.maxx = std::max(sBounds.maxx, sChild.maxx);
+                sBounds.maxy = std::max(sBounds.maxy, sChild.maxy);
+            }
+            m_asNodeBounds[nNewPos] = sBounds;
+            nNewPos ++;
+        }
+    }
+}
+
+/************************************************************************/
+/*                              Search()                                */
+/************************************************************************/
+
+/** Returns the indices of the items whose bounds intersect sAoi.
+ *
+ * The order of the returned indices is unspecified. anItems is cleared
+ * first, so that callers can reuse it between searches.
+ *
+ * This method is thread-safe.
+ */
+void CPLPackedRTree::Search( const CPLRectObj& sAoi,
+                             std::vector<size_t>& anItems ) const
+{
+    anItems.clear();
+    if( m_nItems == 0 )
+        return;
+
+    const size_t nMaxChildren = static_cast<size_t>(m_nNodeSize);
+    // Pairs of (index of first node of a group, level of that group)
+    std::vector<std::pair<size_t, size_t>> aoStack;
+    aoStack.emplace_back(m_asNodeBounds.size() - 1,
+                         m_anLevelEnds.size() - 1);
+    while( !aoStack.empty() )
+    {
+        const size_t nNodeIdx = aoStack.back().first;
+        const size_t nLevel = aoStack.back().second;
+        aoStack.pop_back();
+
+        const size_t nEnd = std::min(nNodeIdx + nMaxChildren,
+                                     m_anLevelEnds[nLevel]);
+        for( size_t nPos = nNodeIdx; nPos < nEnd; nPos++ )
+        {
+            if( !Overlaps(sAoi, m_asNodeBounds[nPos]) )
+                continue;
+            if( nLevel == 0 )
+                anItems.push_back(m_anNodeIndices[nPos]);
+            else
+                aoStack.emplace_back(m_anNodeIndices[nPos], nLevel - 1);
+        }
+    }
+}
+
+//! @endcond
@@ -0,0 +1,77 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Static packed Hilbert R-tree
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef CPL_PACKED_RTREE_H_INCLUDED
+#define CPL_PACKED_RTREE_H_INCLUDED
+
+/*! @cond Doxygen_Suppress */
+
+#include "cpl_port.h"
+#include "cpl_quad_tree.h"
+
+#include <cstddef>
+#include <vector>
+
+/** Static R-tree, bulk loaded by sorting items along a Hilbert curve.
+ *
+ * This is an alternative to CPLQuadTree when all items are known before
+ * the index is queried: construction is a single sort, nodes are stored
+ * contiguously, and the tree is immutable afterwards, so Search() may be
+ * called concurrently from several threads.
+ *
+ * Items are identified by their index in the array of bounds passed to the
+ * constructor.
+ */
+class CPL_DLL CPLPackedRTree
+{
+    size_t                   m_nItems = 0;
+    int                      m_nNodeSize = 0;
+    std::vector<CPLRectObj>  m_asNodeBounds{};
+    // For leaves, index of the item. For other nodes, index of the first
+    // child node.
+    std::vector<size_t>      m_anNodeIndices{};
+    // Index of the node just after the end of each level, from the leaves
+    // to the root.
+    std::vector<size_t>      m_anLevelEnds{};
+
+  public:
+    /** Default number of children per node */
+    static constexpr int DEFAULT_NODE_SIZE = 16;
+
+    CPLPackedRTree(const CPLRectObj* pasItemBounds, size_t nItems,
+                   int nNodeSize = DEFAULT_NODE_SIZE);
+
+    /** Returns the number of indexed items. */
+    size_t GetItemCount() const { return m_nItems; }
+
+    void Search(const CPLRectObj& sAoi, std::vector<size_t>& anItems) const;
+};
+
+/*! @endcond */
+
+#endif // CPL_PACKED_RTREE_H_INCLUDED
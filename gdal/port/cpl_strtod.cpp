@@ -30,13 +30,17 @@
 #include "cpl_port.h"
 #include "cpl_conv.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <cfloat>
+#include <cmath>
 #include <clocale>
 #include <cstring>
 #include <cstdlib>
 #include <limits>
 
 #include "cpl_config.h"
+#include "cpl_string.h"
 
 CPL_CVSID("$Id$")
 
@@ -210,6 +214,131 @@ static char* CPLReplacePointByLocalePoint( const char* pszNumber, char point )
     return nullptr;
 }
 
+/************************************************************************/
+/*                        CPLStrtodFastPath()                           */
+/************************************************************************/
+
+// Clinger's fast path, as used by the fast_float library: when the decimal
+// significand fits in 53 bits and the power of ten is exactly representable,
+// a single floating point multiplication or division gives the correctly
+// rounded value, without going through strtod().
+// This requires double arithmetic not to use extended precision.
+#if (defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0) || \
+    defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__) || \
+    defined(_M_ARM64)
+#define HAVE_STRTOD_FAST_PATH
+#endif
+
+#ifdef HAVE_STRTOD_FAST_PATH
+static bool CPLStrtodFastPath( const char* nptr, char point,
+                               double& dfValue, const char*& pszEnd )
+{
+    const char* p = nptr;
+    const bool bNegative = (*p == '-');
+    if( *p == '-' || *p == '+' )
+        ++p;
+
+    constexpr int MAX_SIG_DIGITS = 19;
+    GUInt64 nSignificand = 0;
+    int nSigDigits = 0;
+    int nExp10 = 0;
+    bool bHasDigits = false;
+    for( ; *p >= '0' && *p <= '9'; ++p )
+    {
+        bHasDigits = true;
+        if( nSigDigits == 0 && *p == '0' )
+            continue;
+        if( nSigDigits == MAX_SIG_DIGITS )
+            return false;
+        nSignificand = nSignificand * 10 + (*p - '0');
+        nSigDigits++;
+    }
+    // Hexadecimal floating point numbers
+    if( *p == 'x' || *p == 'X' )
+        return false;
+    if( *p == point )
+    {
+        for( ++p; *p >= '0' && *p <= '9'; ++p )
+        {
+            bHasDigits = true;
+            nExp10--;
+            if( nSigDigits == 0 && *p == '0' )
+                continue;
+            if( nSigDigits == MAX_SIG_DIGITS )
+                return false;
+            nSignificand = nSignificand * 10 + (*p - '0');
+            nSigDigits++;
+        }
+    }
+    if( !bHasDigits )
+        return false;
+
+    if( *p == 'e' || *p == 'E' )
+    {
+        const char* q = p + 1;
+        const bool bNegativeExp = (*q == '-');
+        if( *q == '-' || *q == '+' )
+            ++q;
+        if( *q >= '0' && *q <= '9' )
+        {
+            int nExp = 0;
+            for( ; *q >= '0' && *q <= '9'; ++q )
+            {
+                if( nExp < 100000 )
+                    nExp = nExp * 10 + (*q - '0');
+            }
+            nExp10 += bNegativeExp ? -nExp : nExp;
+            p = q;
+        }
+    }
+
+    static const double adfPow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+    constexpr int MAX_EXACT_POW10 = 22;
+    constexpr GUInt64 MAX_EXACT_SIGNIFICAND = static_cast<GUInt64>(1) << 53;
+
+    if( nSignificand == 0 )
+    {
+        dfValue = 0.0;
+    }
+    else if( nSignificand > MAX_EXACT_SIGNIFICAND )
+    {
+        return false;
+    }
+    else if( nExp10 >= 0 && nExp10 <= MAX_EXACT_POW10 )
+    {
+        dfValue = static_cast<double>(nSignificand) * adfPow10[nExp10];
+    }
+    else if( nExp10 < 0 && nExp10 >= -MAX_EXACT_POW10 )
+    {
+        dfValue = static_cast<double>(nSignificand) / adfPow10[-nExp10];
+    }
+    else if( nExp10 > MAX_EXACT_POW10 &&
+             nExp10 <= MAX_EXACT_POW10 + MAX_SIG_DIGITS )
+    {
+        // Move the excess power of ten into the significand if it remains
+        // exactly representable.
+        for( ; nExp10 > MAX_EXACT_POW10; nExp10-- )
+        {
+            nSignificand *= 10;
+            if( nSignificand > MAX_EXACT_SIGNIFICAND )
+                return false;
+        }
+        dfValue = static_cast<double>(nSignificand) * adfPow10[nExp10];
+    }
+    else
+    {
+        return false;
+    }
+
+    if( bNegative )
+        dfValue = -dfValue;
+    pszEnd = p;
+    return true;
+}
+#endif
+
 /************************************************************************/
 /*                          CPLStrtodDelim()                            */
 /************************************************************************/
@@ -280,6 +409,18 @@ double CPLStrtodDelim(const char *nptr, char **endptr, char point)
         return std::numeric_limits<double>::quiet_NaN();
     }
 
+#ifdef HAVE_STRTOD_FAST_PATH
+    {
+        double dfValue = 0.0;
+        const char* pszEnd = nullptr;
+        if( CPLStrtodFastPath(nptr, point, dfValue, pszEnd) )
+        {
+            if( endptr ) *endptr = const_cast<char *>(pszEnd);
+            return dfValue;
+        }
+    }
+#endif
+
 /* -------------------------------------------------------------------- */
 /*  We are implementing a simple method here: copy the input string     */
 /*  into the temporary buffer, replace the specified decimal delimiter  */
@@ -404,3 +545,148 @@ float CPLStrtof(const char *nptr, char **endptr)
 {
     return CPLStrtofDelim(nptr, endptr, '.');
 }
+
+/************************************************************************/
+/*                    CPLFormatDoubleShortestFixed()                    */
+/************************************************************************/
+
+/*! @cond Doxygen_Suppress */
+
+/** Fast path of CPLFormatDoubleShortest(): formats dfValue in fixed
+ * notation with the smallest number of decimals, at most nMaxDecimals (and
+ * 17), that round-trips. Returns 0 if there is no such representation, or if
+ * the value is not finite, zero or outside of [1e-5, 2^53[ in absolute value.
+ */
+int CPLFormatDoubleShortestFixed(char *pszBuffer, size_t nBufferSize,
+                                 double dfValue, int nMaxDecimals)
+{
+    // Find the smallest number of decimals k such that
+    // round(|dfValue| * 10^k) / 10^k == |dfValue|. As both operands
+    // of the division are exactly representable, the division is exactly
+    // what a correctly rounded strtod() computes on the resulting
+    // decimal string.
+    static const double adfPow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17 };
+    constexpr double dfTwoPow53 = 9007199254740992.0;
+    const double dfAbs = fabs(dfValue);
+    // Also excludes NaN
+    if( !(dfAbs >= 1e-5 && dfAbs < dfTwoPow53) )
+        return 0;
+    const int nMaxK = std::min(nMaxDecimals,
+                               static_cast<int>(CPL_ARRAYSIZE(adfPow10)) - 1);
+    for( int k = 0; k <= nMaxK; ++k )
+    {
+        const double dfScaled = dfAbs * adfPow10[k];
+        if( dfScaled >= dfTwoPow53 )
+            break;
+        const double dfRounded = std::round(dfScaled);
+        if( dfRounded / adfPow10[k] != dfAbs )
+            continue;
+
+        char szDigits[24];
+        int nDigits = 0;
+        GUInt64 nVal = static_cast<GUInt64>(dfRounded);
+        do
+        {
+            szDigits[nDigits++] = static_cast<char>('0' + nVal % 10);
+            nVal /= 10;
+        } while( nVal != 0 );
+
+        char szTmp[48];
+        int nLen = 0;
+        if( dfValue < 0 )
+            szTmp[nLen++] = '-';
+        if( nDigits <= k )
+        {
+            szTmp[nLen++] = '0';
+            szTmp[nLen++] = '.';
+            for( int i = nDigits; i < k; ++i )
+                szTmp[nLen++] = '0';
+        }
+        for( int i = nDigits - 1; i >= 0; --i )
+        {
+            if( i + 1 == k && nDigits > k )
+                szTmp[nLen++] = '.';
+            szTmp[nLen++] = szDigits[i];
+        }
+        if( static_cast<size_t>(nLen) >= nBufferSize )
+            return 0;
+        memcpy(pszBuffer, szTmp, nLen);
+        pszBuffer[nLen] = '\0';
+        return nLen;
+    }
+    return 0;
+}
+
+/*! @endcond */
+
+/************************************************************************/
+/*                      CPLFormatDoubleShortest()                       */
+/************************************************************************/
+
+/**
+ * Converts a floating point number to the shortest ASCII string that
+ * CPLStrtod() converts back to the same value.
+ *
+ * Values whose shortest decimal representation has at most 17 significant
+ * digits and no more than 17 decimals are formatted in fixed notation, and
+ * are processed without going through the C library formatting functions,
+ * which makes this function much faster than snprintf() in the usual case.
+ * Other values are formatted with the "%.15g", "%.16g" or "%.17g" format,
+ * whichever is the shortest that round-trips. The decimal delimiter is
+ * always '.'. NaN and infinite values are formatted as "nan", "inf" and
+ * "-inf".
+ *
+ * @param pszBuffer Output buffer. 32 bytes are always enough.
+ * @param nBufferSize Size of pszBuffer.
+ * @param dfValue Value to format.
+ *
+ * @return the length of the string written in pszBuffer, or 0 if it does not
+ * fit.
+ * @since GDAL 3.4
+ */
+int CPLFormatDoubleShortest(char *pszBuffer, size_t nBufferSize,
+                            double dfValue)
+{
+    char szTmp[32];
+    int nLen = 0;
+
+    if( CPLIsNan(dfValue) )
+    {
+        nLen = CPLsnprintf(szTmp, sizeof(szTmp), "nan");
+    }
+    else if( CPLIsInf(dfValue) )
+    {
+        nLen = CPLsnprintf(szTmp, sizeof(szTmp),
+                           dfValue > 0 ? "inf" : "-inf");
+    }
+    else if( dfValue == 0 )
+    {
+        nLen = CPLsnprintf(szTmp, sizeof(szTmp), "0");
+    }
+    else
+    {
+        nLen = CPLFormatDoubleShortestFixed(szTmp, sizeof(szTmp),
+                                            dfValue, 17);
+        if( nLen == 0 )
+        {
+            // CPLsnprintf() does not support the '*' precision.
+            for( const char* pszFormat : { "%.15g", "%.16g", "%.17g" } )
+            {
+                nLen = CPLsnprintf(szTmp, sizeof(szTmp), pszFormat, dfValue);
+                if( CPLStrtod(szTmp, nullptr) == dfValue )
+                    break;
+            }
+        }
+    }
+
+    if( nLen <= 0 || static_cast<size_t>(nLen) >= nBufferSize )
+    {
+        if( nBufferSize > 0 )
+            pszBuffer[0] = '\0';
+        return 0;
+    }
+    memcpy(pszBuffer, szTmp, nLen + 1);
+    return nLen;
+}
@@ -0,0 +1,568 @@
+/******************************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Lightweight tracing of scoped spans
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_trace.h"
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_json_streaming_writer.h"
+#include "cpl_multiproc.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+CPL_CVSID("$Id$")
+
+//! @cond Doxygen_Suppress
+
+namespace {
+
+struct TraceEvent
+{
+    const char*                     pszCategory = nullptr;
+    const char*                     pszName = nullptr;
+    GUInt64                         nSpanId = 0;
+    GUInt64                         nParentSpanId = 0;
+    GIntBig                         nStartNanoSec = 0;
+    GIntBig                         nEndNanoSec = 0;
+    int                             nThreadIdx = 0;
+    std::vector<CPLTraceSpan::Arg>  aoArgs{};
+};
+
+// Events of a thread. Buffers are registered in a global list and never
+// unregistered, so that events of terminated threads are kept.
+struct ThreadBuffer
+{
+    std::mutex              oMutex{};
+    int                     nThreadIdx = 0;
+    // Only accessed by the owning thread.
+    GUInt64                 nCurrentSpanId = 0;
+    std::vector<TraceEvent> aoEvents{};
+};
+
+enum
+{
+    STATE_UNINIT = -1,
+    STATE_DISABLED = 0,
+    STATE_ENABLED = 1
+};
+
+} // namespace
+
+static std::atomic<int> gnState{STATE_UNINIT};
+static std::atomic<GUInt64> gnNextSpanId{1};
+static std::atomic<GIntBig> gnEventCount{0};
+static std::atomic<GIntBig> gnDroppedEvents{0};
+
+// Protects the following variables.
+static std::mutex goMutex;
+static std::vector<std::shared_ptr<ThreadBuffer>> gapoBuffers;
+static std::string gosFilename;
+static bool gbOTLP = false;
+static GIntBig gnMaxEvents = 0;
+static std::chrono::steady_clock::time_point goStartTime;
+static GIntBig gnStartUnixNanoSec = 0;
+
+static thread_local std::shared_ptr<ThreadBuffer> tlpoBuffer;
+
+/************************************************************************/
+/*                         GetThreadBuffer()                            */
+/************************************************************************/
+
+static ThreadBuffer* GetThreadBuffer()
+{
+    if( !tlpoBuffer )
+    {
+        auto poBuffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> oLock(goMutex);
+        poBuffer->nThreadIdx = static_cast<int>(gapoBuffers.size()) + 1;
+        gapoBuffers.push_back(poBuffer);
+        tlpoBuffer = std::move(poBuffer);
+    }
+    return tlpoBuffer.get();
+}
+
+/************************************************************************/
+/*                               Now()                                  */
+/************************************************************************/
+
+// Nanoseconds since the start of the tracing session.
+static GIntBig Now()
+{
+    return static_cast<GIntBig>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - goStartTime).count());
+}
+
+/************************************************************************/
+/*                           StartLocked()                              */
+/************************************************************************/
+
+static bool StartLocked( const char* pszFilename, const char* pszFormat )
+{
+    if( pszFormat == nullptr || pszFormat[0] == '\0' )
+        pszFormat = "CHROME";
+    if( !EQUAL(pszFormat, "CHROME") && !EQUAL(pszFormat, "OTLP") )
+    {
+        CPLError(CE_Failure, CPLE_NotSupported,
+                 "Unsupported trace format: %s", pszFormat);
+        return false;
+    }
+
+    gosFilename = pszFilename;
+    gbOTLP = EQUAL(pszFormat, "OTLP");
+    gnMaxEvents = std::max(static_cast<GIntBig>(0), CPLAtoGIntBig(
+        CPLGetConfigOption("CPL_TRACE_MAX_EVENTS", "1000000")));
+    gnEventCount = 0;
+    gnDroppedEvents = 0;
+    for( auto& poBuffer: gapoBuffers )
+    {
+        std::lock_guard<std::mutex> oLock(poBuffer->oMutex);
+        poBuffer->aoEvents.clear();
+    }
+    goStartTime = std::chrono::steady_clock::now();
+    gnStartUnixNanoSec = static_cast<GIntBig>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    gnState.store(STATE_ENABLED, std::memory_order_release);
+    return true;
+}
+
+/************************************************************************/
+/*                           WriteChrome()                              */
+/************************************************************************/
+
+static void WriteToFile( const char* pszText, void* pUserData )
+{
+    VSILFILE* fp = static_cast<VSILFILE*>(pUserData);
+    VSIFWriteL(pszText, 1, strlen(pszText), fp);
+}
+
+static void WriteArgValue( CPLJSonStreamingWriter& oWriter,
+                           const CPLTraceSpan::Arg& oArg )
+{
+    if( oArg.bIsString )
+        oWriter.Add(oArg.osValue);
+    else
+        oWriter.Add(oArg.nValue);
+}
+
+// Chrome trace event format, with "complete" events.
+static void WriteChrome( CPLJSonStreamingWriter& oWriter,
+                         const std::vector<TraceEvent>& aoEvents )
+{
+    const int nPID = CPLGetCurrentProcessID();
+    auto oRoot = oWriter.MakeObjectContext();
+    oWriter.AddObjKey("traceEvents");
+    {
+        auto oArray = oWriter.MakeArrayContext();
+        for( const auto& oEvent: aoEvents )
+        {
+            auto oObj = oWriter.MakeObjectContext();
+            oWriter.AddObjKey("name");
+            oWriter.Add(oEvent.pszName);
+            oWriter.AddObjKey("cat");
+            oWriter.Add(oEvent.pszCategory);
+            oWriter.AddObjKey("ph");
+            oWriter.Add("X");
+            // Microseconds
+            oWriter.AddObjKey("ts");
+            oWriter.Add(static_cast<double>(oEvent.nStartNanoSec) / 1000, 15);
+            oWriter.AddObjKey("dur");
+            oWriter.Add(static_cast<double>(oEvent.nEndNanoSec -
+                                            oEvent.nStartNanoSec) / 1000, 15);
+            oWriter.AddObjKey("pid");
+            oWriter.Add(nPID);
+            oWriter.AddObjKey("tid");
+            oWriter.Add(oEvent.nThreadIdx);
+            if( !oEvent.aoArgs.empty() )
+            {
+                oWriter.AddObjKey("args");
+                auto oArgs = oWriter.MakeObjectContext();
+                for( const auto& oArg: oEvent.aoArgs )
+                {
+                    oWriter.AddObjKey(oArg.pszKey);
+                    WriteArgValue(oWriter, oArg);
+                }
+            }
+        }
+    }
+    oWriter.AddObjKey("displayTimeUnit");
+    oWriter.Add("ms");
+    oWriter.AddObjKey("otherData");
+    {
+        auto oObj = oWriter.MakeObjectContext();
+        oWriter.AddObjKey("dropped_events");
+        oWriter.Add(static_cast<GIntBig>(gnDroppedEvents));
+    }
+}
+
+/************************************************************************/
+/*                            WriteOTLP()                               */
+/************************************************************************/
+
+static void WriteOTLPAttribute( CPLJSonStreamingWriter& oWriter,
+                                const char* pszKey,
+                                const CPLTraceSpan::Arg& oArg )
+{
+    auto oObj = oWriter.MakeObjectContext();
+    oWriter.AddObjKey("key");
+    oWriter.Add(pszKey);
+    oWriter.AddObjKey("value");
+    auto oValue = oWriter.MakeObjectContext();
+    if( oArg.bIsString )
+    {
+        oWriter.AddObjKey("stringValue");
+        oWriter.Add(oArg.osValue);
+    }
+    else
+    {
+        // 64 bit integers are encoded as strings in OTLP/JSON
+        oWriter.AddObjKey("intValue");
+        oWriter.Add(CPLSPrintf(CPL_FRMT_GIB, oArg.nValue));
+    }
+}
+
+static CPLTraceSpan::Arg MakeArg( const char* pszValue )
+{
+    CPLTraceSpan::Arg oArg;
+    oArg.pszKey = nullptr;
+    oArg.osValue = pszValue;
+    oArg.nValue = 0;
+    oArg.bIsString = true;
+    return oArg;
+}
+
+static CPLTraceSpan::Arg MakeArg( GIntBig nValue )
+{
+    CPLTraceSpan::Arg oArg;
+    oArg.pszKey = nullptr;
+    oArg.nValue = nValue;
+    oArg.bIsString = false;
+    return oArg;
+}
+
+// OpenTelemetry protocol JSON encoding of an ExportTraceServiceRequest, as
+// accepted by the OTLP/HTTP receivers of collectors.
+static void WriteOTLP( CPLJSonStreamingWriter& oWriter,
+                       const std::vector<TraceEvent>& aoEvents )
+{
+    const int nPID = CPLGetCurrentProcessID();
+    const std::string osTraceId(CPLSPrintf("%016llx%08x%08x",
+        static_cast<unsigned long long>(gnStartUnixNanoSec),
+        static_cast<unsigned>(nPID),
+        static_cast<unsigned>(CPLGetPID())));
+
+    auto oRoot = oWriter.MakeObjectContext();
+    oWriter.AddObjKey("resourceSpans");
+    auto oResourceSpans = oWriter.MakeArrayContext();
+    auto oResourceSpan = oWriter.MakeObjectContext();
+    oWriter.AddObjKey("resource");
+    {
+        auto oResource = oWriter.MakeObjectContext();
+        oWriter.AddObjKey("attributes");
+        auto oAttributes = oWriter.MakeArrayContext();
+        WriteOTLPAttribute(oWriter, "service.name", MakeArg("gdal"));
+        WriteOTLPAttribute(oWriter, "process.pid", MakeArg(nPID));
+    }
+    oWriter.AddObjKey("scopeSpans");
+    auto oScopeSpans = oWriter.MakeArrayContext();
+    auto oScopeSpan = oWriter.MakeObjectContext();
+    oWriter.AddObjKey("scope");
+    {
+        auto oScope = oWriter.MakeObjectContext();
+        oWriter.AddObjKey("name");
+        oWriter.Add("gdal");
+    }
+    oWriter.AddObjKey("spans");
+    auto oSpans = oWriter.MakeArrayContext();
+    for( const auto& oEvent: aoEvents )
+    {
+        auto oSpan = oWriter.MakeObjectContext();
+        oWriter.AddObjKey("traceId");
+        oWriter.Add(osTraceId);
+        oWriter.AddObjKey("spanId");
+        oWriter.Add(CPLSPrintf("%016llx",
+            static_cast<unsigned long long>(oEvent.nSpanId)));
+        if( oEvent.nParentSpanId )
+        {
+            oWriter.AddObjKey("parentSpanId");
+            oWriter.Add(CPLSPrintf("%016llx",
+                static_cast<unsigned long long>(oEvent.nParentSpanId)));
+        }
+        oWriter.AddObjKey("name");
+        oWriter.Add(oEvent.pszName);
+        // SPAN_KIND_INTERNAL
+        oWriter.AddObjKey("kind");
+        oWriter.Add(1);
+        oWriter.AddObjKey("startTimeUnixNano");
+        oWriter.Add(CPLSPrintf(CPL_FRMT_GIB,
+                               gnStartUnixNanoSec + oEvent.nStartNanoSec));
+        oWriter.AddObjKey("endTimeUnixNano");
+        oWriter.Add(CPLSPrintf(CPL_FRMT_GIB,
+                               gnStartUnixNanoSec + oEvent.nEndNanoSec));
+        oWriter.AddObjKey("attributes");
+        auto oAttributes = oWriter.MakeArrayContext();
+        WriteOTLPAttribute(oWriter, "category", MakeArg(oEvent.pszCategory));
+        WriteOTLPAttribute(oWriter, "thread.id",
+                           MakeArg(static_cast<GIntBig>(oEvent.nThreadIdx)));
+        for( const auto& oArg: oEvent.aoArgs )
+            WriteOTLPAttribute(oWriter, oArg.pszKey, oArg);
+    }
+}
+
+/************************************************************************/
+/*                  CPLTraceFileConfigOptionChanged()                   */
+/************************************************************************/
+
+// Called by CPLSetConfigOption() when CPL_TRACE_FILE is set, so that
+// "--config CPL_TRACE_FILE out.json" works even if spans have already
+// been checked.
+void CPLTraceFileConfigOptionChanged( const char* pszValue )
+{
+    if( pszValue != nullptr && pszValue[0] != '\0' )
+    {
+        if( gnState.load() != STATE_ENABLED )
+        {
+            CPLTraceStart(pszValue,
+                          CPLGetConfigOption("CPL_TRACE_FORMAT", nullptr));
+        }
+    }
+    else if( gnState.load() == STATE_ENABLED )
+    {
+        CPLTraceStop();
+    }
+}
+
+//! @endcond
+
+/************************************************************************/
+/*                          CPLTraceIsEnabled()                         */
+/************************************************************************/
+
+/**
+ * \brief Returns whether tracing is enabled.
+ *
+ * On the first call, tracing is started if the CPL_TRACE_FILE configuration
+ * option is set.
+ *
+ * @since GDAL 3.4
+ */
+int CPLTraceIsEnabled()
+{
+    const int nState = gnState.load(std::memory_order_acquire);
+    if( nState != STATE_UNINIT )
+        return nState;
+
+    std::lock_guard<std::mutex> oLock(goMutex);
+    if( gnState.load() == STATE_UNINIT )
+    {
+        const char* pszFilename =
+            CPLGetConfigOption("CPL_TRACE_FILE", nullptr);
+        if( pszFilename == nullptr || pszFilename[0] == '\0' ||
+            !StartLocked(pszFilename,
+                         CPLGetConfigOption("CPL_TRACE_FORMAT", nullptr)) )
+        {
+            gnState = STATE_DISABLED;
+        }
+    }
+    return gnState.load();
+}
+
+/************************************************************************/
+/*                            CPLTraceStart()                           */
+/************************************************************************/
+
+/**
+ * \brief Starts a tracing session.
+ *
+ * Spans are collected in memory until CPLTraceStop() is called. A session
+ * already in progress is discarded. At most CPL_TRACE_MAX_EVENTS (default
+ * 1000000) spans are recorded.
+ *
+ * @param pszFilename output file.
+ * @param pszFormat "CHROME" for the Chrome trace event JSON format (default
+ * if NULL), or "OTLP" for the OpenTelemetry protocol JSON encoding.
+ * @return TRUE in case of success.
+ * @since GDAL 3.4
+ */
+int CPLTraceStart( const char* pszFilename, const char* pszFormat )
+{
+    std::lock_guard<std::mutex> oLock(goMutex);
+    return StartLocked(pszFilename, pszFormat);
+}
+
+/************************************************************************/
+/*                            CPLTraceStop()                            */
+/************************************************************************/
+
+/**
+ * \brief Stops the tracing session, and writes the trace file.
+ *
+ * Spans that are still running are not recorded.
+ *
+ * @return TRUE in case of success, or if no session was in progress.
+ * @since GDAL 3.4
+ */
+int CPLTraceStop()
+{
+    std::vector<TraceEvent> aoEvents;
+    std::string osFilename;
+    bool bOTLP;
+    {
+        std::lock_guard<std::mutex> oLock(goMutex);
+        if( gnState.load() != STATE_ENABLED )
+        {
+            gnState = STATE_DISABLED;
+            return TRUE;
+        }
+        gnState = STATE_DISABLED;
+        for( auto& poBuffer: gapoBuffers )
+        {
+            std::lock_guard<std::mutex> oBufferLock(poBuffer->oMutex);
+            std::move(poBuffer->aoEvents.begin(), poBuffer->aoEvents.end(),
+                      std::back_inserter(aoEvents));
+            poBuffer->aoEvents.clear();
+        }
+        osFilename = gosFilename;
+        bOTLP = gbOTLP;
+    }
+
+    std::sort(aoEvents.begin(), aoEvents.end(),
+              [](const TraceEvent& a, const TraceEvent& b)
+              { return a.nStartNanoSec < b.nStartNanoSec; });
+
+    VSILFILE* fp = VSIFOpenL(osFilename.c_str(), "wb");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s",
+                 osFilename.c_str());
+        return FALSE;
+    }
+    {
+        CPLJSonStreamingWriter oWriter(WriteToFile, fp);
+        oWriter.SetPrettyFormatting(false);
+        if( bOTLP )
+            WriteOTLP(oWriter, aoEvents);
+        else
+            WriteChrome(oWriter, aoEvents);
+    }
+    VSIFWriteL("\n", 1, 1, fp);
+    if( VSIFCloseL(fp) != 0 )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Error while writing %s",
+                 osFilename.c_str());
+        return FALSE;
+    }
+    if( gnDroppedEvents > 0 )
+    {
+        CPLDebug("TRACE", CPL_FRMT_GIB " spans were dropped. "
+                 "Increase CPL_TRACE_MAX_EVENTS to keep them",
+                 static_cast<GIntBig>(gnDroppedEvents));
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                         CPLTraceSpan::Begin()                        */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+void CPLTraceSpan::Begin()
+{
+    ThreadBuffer* poBuffer = GetThreadBuffer();
+    m_nSpanId = gnNextSpanId++;
+    m_nParentSpanId = poBuffer->nCurrentSpanId;
+    poBuffer->nCurrentSpanId = m_nSpanId;
+    m_bActive = true;
+    m_nStartNanoSec = Now();
+}
+
+/************************************************************************/
+/*                          CPLTraceSpan::End()                         */
+/************************************************************************/
+
+void CPLTraceSpan::End()
+{
+    const GIntBig nEnd = Now();
+    ThreadBuffer* poBuffer = tlpoBuffer.get();
+    poBuffer->nCurrentSpanId = m_nParentSpanId;
+    if( gnState.load(std::memory_order_relaxed) != STATE_ENABLED )
+        return;
+    if( ++gnEventCount > gnMaxEvents )
+    {
+        gnDroppedEvents ++;
+        return;
+    }
+
+    TraceEvent oEvent;
+    oEvent.pszCategory = m_pszCategory;
+    oEvent.pszName = m_pszName;
+    oEvent.nSpanId = m_nSpanId;
+    oEvent.nParentSpanId = m_nParentSpanId;
+    oEvent.nStartNanoSec = m_nStartNanoSec;
+    oEvent.nEndNanoSec = nEnd;
+    oEvent.nThreadIdx = poBuffer->nThreadIdx;
+    oEvent.aoArgs = std::move(m_aoArgs);
+    std::lock_guard<std::mutex> oLock(poBuffer->oMutex);
+    poBuffer->aoEvents.emplace_back(std::move(oEvent));
+}
+//! @endcond
+
+/************************************************************************/
+/*                        CPLTraceSpan::AddArg()                        */
+/************************************************************************/
+
+/** Adds a string argument to the span. */
+void CPLTraceSpan::AddArg( const char* pszKey, const char* pszValue )
+{
+    if( !m_bActive )
+        return;
+    Arg oArg;
+    oArg.pszKey = pszKey;
+    oArg.osValue = pszValue ? pszValue : "";
+    oArg.nValue = 0;
+    oArg.bIsString = true;
+    m_aoArgs.emplace_back(std::move(oArg));
+}
+
+/** Adds an integer argument to the span. */
+void CPLTraceSpan::AddArg( const char* pszKey, GIntBig nValue )
+{
+    if( !m_bActive )
+        return;
+    Arg oArg;
+    oArg.pszKey = pszKey;
+    oArg.nValue = nValue;
+    oArg.bIsString = false;
+    m_aoArgs.emplace_back(std::move(oArg));
+}
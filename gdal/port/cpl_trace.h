@@ -0,0 +1,144 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Lightweight tracing of scoped spans
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef CPL_TRACE_H_INCLUDED
+#define CPL_TRACE_H_INCLUDED
+
+#include "cpl_port.h"
+
+/**
+ * \file cpl_trace.h
+ *
+ * Tracing of scoped spans (I/O, decoding, computation...), with their
+ * duration, thread and nesting, written as a Chrome trace JSON file
+ * (viewable in chrome://tracing or https://ui.perfetto.dev) or as an
+ * OpenTelemetry OTLP/JSON file.
+ *
+ * Tracing is enabled by setting the CPL_TRACE_FILE configuration option
+ * to the output filename, before the first traced operation, or by calling
+ * CPLTraceStart(). The CPL_TRACE_FORMAT configuration option may be set to
+ * CHROME (default) or OTLP. The file is written by CPLTraceStop(), which is
+ * called by GDALDestroyDriverManager().
+ *
+ * When tracing is disabled, a span costs a function call and the test of
+ * a flag.
+ *
+ * @since GDAL 3.4
+ */
+
+CPL_C_START
+
+int CPL_DLL CPLTraceStart( const char* pszFilename, const char* pszFormat );
+int CPL_DLL CPLTraceStop( void );
+int CPL_DLL CPLTraceIsEnabled( void );
+
+CPL_C_END
+
+#if defined(__cplusplus) && !defined(CPL_SUPRESS_CPLUSPLUS)
+
+#include <string>
+#include <vector>
+
+/** Scoped span.
+ *
+ * The span starts at construction and ends at destruction. pszCategory and
+ * pszName must point to strings that outlive the tracing session, typically
+ * string literals.
+ *
+ * Arguments should only be added when IsActive() is true, so that their
+ * formatting costs nothing when tracing is disabled.
+ *
+ * @since GDAL 3.4
+ */
+class CPL_DLL CPLTraceSpan
+{
+  public:
+/*! @cond Doxygen_Suppress */
+    struct Arg
+    {
+        const char* pszKey;
+        std::string osValue;
+        GIntBig     nValue;
+        bool        bIsString;
+    };
+/*! @endcond */
+
+  private:
+    CPL_DISALLOW_COPY_ASSIGN(CPLTraceSpan)
+
+    bool             m_bActive = false;
+    const char*      m_pszCategory = nullptr;
+    const char*      m_pszName = nullptr;
+    GUInt64          m_nSpanId = 0;
+    GUInt64          m_nParentSpanId = 0;
+    GIntBig          m_nStartNanoSec = 0;
+    std::vector<Arg> m_aoArgs{};
+
+    void Begin();
+    void End();
+
+  public:
+    /** Starts a span if tracing is enabled. */
+    CPLTraceSpan( const char* pszCategory, const char* pszName ):
+        m_pszCategory(pszCategory), m_pszName(pszName)
+    {
+        if( CPLTraceIsEnabled() )
+            Begin();
+    }
+
+    /** Ends the span. */
+    ~CPLTraceSpan()
+    {
+        if( m_bActive )
+            End();
+    }
+
+    /** Returns whether the span is recorded. */
+    bool IsActive() const { return m_bActive; }
+
+    void AddArg( const char* pszKey, const char* pszValue );
+    void AddArg( const char* pszKey, GIntBig nValue );
+};
+
+/*! @cond Doxygen_Suppress */
+#define CPL_TRACE_CONCAT_INTERNAL(a, b) a ## b
+#define CPL_TRACE_CONCAT(a, b) CPL_TRACE_CONCAT_INTERNAL(a, b)
+/*! @endcond */
+
+/** Declares a span lasting until the end of the enclosing scope. */
+#define CPL_TRACE_SPAN(pszCategory, pszName) \
+    CPLTraceSpan CPL_TRACE_CONCAT(oCPLTraceSpan_, __LINE__)(pszCategory, pszName)
+
+/*! @cond Doxygen_Suppress */
+// Internal use only
+void CPLTraceFileConfigOptionChanged( const char* pszValue );
+/*! @endcond */
+
+#endif // __cplusplus
+
+#endif // CPL_TRACE_H_INCLUDED
@@ -29,10 +29,16 @@
 
 #ifdef ENABLE_UFFD
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cinttypes>
 #include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include <fcntl.h>
 #include <poll.h>
@@ -62,11 +68,12 @@
 
 static int64_t get_page_limit();
 static void cpl_uffd_fault_handler(void * ptr);
+static void cpl_uffd_callback_worker(void * ptr);
 static void signal_handler(int signal);
 static void uffd_cleanup(void * ptr);
 
 struct cpl_uffd_context {
-  bool keep_going = false;
+  std::atomic<bool> keep_going{false};
 
   int uffd = -1;
   struct uffdio_register uffdio_register = {};
@@ -83,6 +90,23 @@ struct cpl_uffd_context {
   size_t vma_size = 0;
   void * vma_ptr = nullptr;
   CPLJoinableThread* thread = nullptr;
+
+  // Only used by mappings created with CPLCreateUserFaultMappingWithCallback()
+  CPLUserFaultFillCbk pfn_fill = nullptr;
+  void * user_data = nullptr;
+  size_t data_size = 0;
+  size_t map_page_size = 0;
+  size_t map_page_count = 0;
+  int prefetch_pages = 0;
+  std::vector<CPLJoinableThread*> workers{};
+  std::atomic<size_t> last_fault_page{std::numeric_limits<size_t>::max()};
+
+  // Protects the members below
+  std::mutex page_mutex{};
+  std::vector<bool> page_present{};
+  std::vector<bool> page_loading{};
+  std::deque<size_t> resident_pages{};
+  size_t max_resident_pages = 0;
 };
 
 
@@ -99,6 +123,9 @@ static void uffd_cleanup(void * ptr)
       CPLJoinThread(ctx->thread);
       ctx->thread = nullptr;
   }
+  for( auto worker: ctx->workers )
+      CPLJoinThread(worker);
+  ctx->workers.clear();
 
   if (ctx->uffd != -1) {
     ioctl(ctx->uffd, UFFDIO_UNREGISTER, &ctx->uffdio_register);
@@ -355,6 +382,47 @@ bool CPLIsUserFaultMappingSupported()
   return nEnableUserFaultFD != FALSE;
 }
 
+/*
+ * Creates the userfaultfd file descriptor and registers ctx->vma_ptr with it.
+ */
+static bool uffd_open_and_register(cpl_uffd_context * ctx, const char * pszFunc)
+{
+  // Get userfaultfd
+  if ((ctx->uffd = static_cast<int>(syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK))) == -1) {
+    ctx->uffd = -1;
+    CPLError(CE_Failure, CPLE_AppDefined,
+             "%s(): syscall(__NR_userfaultfd) failed", pszFunc);
+    return false;
+  }
+
+  // Query API
+  {
+    struct uffdio_api uffdio_api = {};
+
+    uffdio_api.api = UFFD_API;
+    uffdio_api.features = 0;
+
+    if (ioctl(ctx->uffd, UFFDIO_API, &uffdio_api) == -1) {
+      CPLError(CE_Failure, CPLE_AppDefined,
+               "%s(): ioctl(UFFDIO_API) failed", pszFunc);
+      return false;
+    }
+  }
+
+  // Register memory range
+  ctx->uffdio_register.range.start = reinterpret_cast<uintptr_t>(ctx->vma_ptr);
+  ctx->uffdio_register.range.len = ctx->vma_size;
+  ctx->uffdio_register.mode = UFFDIO_REGISTER_MODE_MISSING;
+
+  if (ioctl(ctx->uffd, UFFDIO_REGISTER, &ctx->uffdio_register) == -1) {
+    CPLError(CE_Failure, CPLE_AppDefined,
+             "%s(): ioctl(UFFDIO_REGISTER) failed", pszFunc);
+    return false;
+  }
+
+  return true;
+}
+
 /*
  * Returns nullptr on failure, a valid pointer on success.
  */
@@ -409,50 +477,230 @@ cpl_uffd_context* CPLCreateUserFaultMapping(const char * pszFilename, void ** pp
     return nullptr;
   }
 
-  // Get userfaultfd
-  if ((ctx->uffd = static_cast<int>(syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK))) == -1) {
-    ctx->uffd = -1;
+  if (!uffd_open_and_register(ctx, "CPLCreateUserFaultMapping")) {
     uffd_cleanup(ctx);
-    CPLError(CE_Failure, CPLE_AppDefined,
-             "CPLCreateUserFaultMapping(): syscall(__NR_userfaultfd) failed");
     return nullptr;
   }
 
-  // Query API
+  // Start handler thread
+  ctx->thread = CPLCreateJoinableThread(cpl_uffd_fault_handler, ctx);
+  if( ctx->thread == nullptr )
   {
-    struct uffdio_api uffdio_api = {};
-
-    uffdio_api.api = UFFD_API;
-    uffdio_api.features = 0;
-
-    if (ioctl(ctx->uffd, UFFDIO_API, &uffdio_api) == -1) {
-      uffd_cleanup(ctx);
       CPLError(CE_Failure, CPLE_AppDefined,
-               "CPLCreateUserFaultMapping(): ioctl(UFFDIO_API) failed");
+               "CPLCreateUserFaultMapping(): CPLCreateJoinableThread() failed");
+      uffd_cleanup(ctx);
       return nullptr;
+  }
+
+  *ppVma = ctx->vma_ptr;
+  *pnVmaSize = ctx->vma_size;
+  return ctx;
+}
+
+/*
+ * Fills one page of a callback based mapping and hands it over to the
+ * kernel, which wakes up the threads waiting for it.
+ */
+static void cpl_uffd_service_page(cpl_uffd_context * ctx, size_t page,
+                                  void * scratch, bool prefetch)
+{
+  const size_t page_size = ctx->map_page_size;
+  const uintptr_t dst = reinterpret_cast<uintptr_t>(ctx->vma_ptr) + page * page_size;
+
+  {
+    std::lock_guard<std::mutex> lock(ctx->page_mutex);
+    if (ctx->page_loading[page]) {
+      // The copy done by the loading worker will wake the faulting thread
+      return;
+    }
+    if (ctx->page_present[page]) {
+      // The fault was reported before the page was copied
+      if (!prefetch) {
+        struct uffdio_range range;
+        range.start = dst;
+        range.len = page_size;
+        ioctl(ctx->uffd, UFFDIO_WAKE, &range);
+      }
+      return;
     }
+    ctx->page_loading[page] = true;
   }
 
-  // Register memory range
-  ctx->uffdio_register.range.start = reinterpret_cast<uintptr_t>(ctx->vma_ptr);
-  ctx->uffdio_register.range.len = ctx->vma_size;
-  ctx->uffdio_register.mode = UFFDIO_REGISTER_MODE_MISSING;
+  // Fill the page without holding the lock, so that other workers can
+  // service other pages in the meantime
+  const size_t offset = page * page_size;
+  const size_t to_fill = std::min(page_size, ctx->data_size - offset);
+  memset(scratch, 0, page_size);
+  ctx->pfn_fill(offset, scratch, to_fill, ctx->user_data);
+
+  std::lock_guard<std::mutex> lock(ctx->page_mutex);
+  ctx->page_loading[page] = false;
+
+  // Evict the oldest pages if needed. Threads accessing them afterwards
+  // will just fault again.
+  while (ctx->max_resident_pages > 0 &&
+         ctx->resident_pages.size() >= ctx->max_resident_pages) {
+    const size_t victim = ctx->resident_pages.front();
+    ctx->resident_pages.pop_front();
+    madvise(static_cast<GByte*>(ctx->vma_ptr) + victim * page_size,
+            page_size, MADV_DONTNEED);
+    ctx->page_present[victim] = false;
+  }
 
-  if (ioctl(ctx->uffd, UFFDIO_REGISTER, &ctx->uffdio_register) == -1) {
+  struct uffdio_copy uffdio_copy;
+  uffdio_copy.src = reinterpret_cast<uintptr_t>(scratch);
+  uffdio_copy.dst = dst;
+  uffdio_copy.len = page_size;
+  uffdio_copy.mode = 0;
+  uffdio_copy.copy = 0;
+  if (ioctl(ctx->uffd, UFFDIO_COPY, &uffdio_copy) == -1 && errno != EEXIST)
+    return;
+
+  ctx->page_present[page] = true;
+  ctx->resident_pages.push_back(page);
+}
+
+/*
+ * Worker thread of callback based mappings. Several of them may run
+ * concurrently on the same userfaultfd descriptor.
+ */
+static void cpl_uffd_callback_worker(void * ptr)
+{
+  struct cpl_uffd_context * ctx = static_cast<struct cpl_uffd_context *>(ptr);
+  struct pollfd pollfd;
+
+  pollfd.fd = ctx->uffd;
+  pollfd.events = POLLIN;
+
+  void * scratch = mmap(nullptr, ctx->map_page_size, PROT_READ|PROT_WRITE,
+                        MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  if (scratch == BAD_MMAP) return;
+
+  while (ctx->keep_going) {
+    if (poll(&pollfd, 1, 16) == -1) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    if ((pollfd.revents & POLLERR) || (pollfd.revents & POLLNVAL)) break;
+    if (!(pollfd.revents & POLLIN)) continue;
+
+    // Read a single event, so that other workers can take the next ones
+    struct uffd_msg msg;
+    const ssize_t bytes_read = read(ctx->uffd, &msg, sizeof(msg));
+    if (bytes_read != static_cast<ssize_t>(sizeof(msg))) {
+      if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        continue;
+      break;
+    }
+    if (msg.event != UFFD_EVENT_PAGEFAULT) continue;
+
+    const size_t page = static_cast<size_t>(
+        (msg.arg.pagefault.address - reinterpret_cast<uintptr_t>(ctx->vma_ptr)) /
+        ctx->map_page_size);
+    if (page >= ctx->map_page_count) continue;
+
+    cpl_uffd_service_page(ctx, page, scratch, false);
+
+    // Read ahead in the direction of access
+    if (ctx->prefetch_pages > 0) {
+      const size_t last_page = ctx->last_fault_page.exchange(page);
+      int direction = 0;
+      if (last_page != std::numeric_limits<size_t>::max()) {
+        if (page == last_page + 1) direction = 1;
+        else if (page + 1 == last_page) direction = -1;
+      }
+      for (int i = 1; direction != 0 && i <= ctx->prefetch_pages &&
+                      ctx->keep_going; ++i) {
+        size_t next_page;
+        if (direction > 0) {
+          next_page = page + i;
+          if (next_page >= ctx->map_page_count) break;
+        } else {
+          if (page < static_cast<size_t>(i)) break;
+          next_page = page - i;
+        }
+        cpl_uffd_service_page(ctx, next_page, scratch, true);
+      }
+    }
+  }
+
+  munmap(scratch, ctx->map_page_size);
+}
+
+/*
+ * Creates a read-only mapping of nSize bytes, whose pages of nPageSize bytes
+ * are filled by pfnFill on first access, from nThreads worker threads.
+ * At most nCacheSize bytes are kept resident (0 for no limit).
+ * Returns nullptr on failure, a valid pointer on success.
+ */
+cpl_uffd_context * CPLCreateUserFaultMappingWithCallback(size_t nSize, size_t nPageSize, size_t nCacheSize, int nThreads, CPLUserFaultFillCbk pfnFill, void * pUserData, void ** ppVma, uint64_t * pnVmaSize)
+{
+  if( !CPLIsUserFaultMappingSupported() )
+  {
+      CPLError(CE_Failure, CPLE_NotSupported,
+               "CPLCreateUserFaultMappingWithCallback(): Linux kernel 4.3 or newer needed");
+      return nullptr;
+  }
+
+  const size_t system_page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  if (nSize == 0 || nPageSize == 0 || (nPageSize % system_page_size) != 0 ||
+      nSize > std::numeric_limits<size_t>::max() - nPageSize) {
+    CPLError(CE_Failure, CPLE_AppDefined,
+             "CPLCreateUserFaultMappingWithCallback(): invalid sizes");
+    return nullptr;
+  }
+  nThreads = std::max(1, nThreads);
+
+  struct cpl_uffd_context * ctx = new cpl_uffd_context();
+  ctx->keep_going = true;
+  ctx->pfn_fill = pfnFill;
+  ctx->user_data = pUserData;
+  ctx->data_size = nSize;
+  ctx->map_page_size = nPageSize;
+  ctx->map_page_count = (nSize + nPageSize - 1) / nPageSize;
+  ctx->vma_size = ctx->map_page_count * nPageSize;
+  ctx->prefetch_pages = std::max(0, std::min(1024,
+      atoi(CPLGetConfigOption(GDAL_UFFD_PREFETCH_PAGES, "4"))));
+  try {
+    ctx->page_present.resize(ctx->map_page_count);
+    ctx->page_loading.resize(ctx->map_page_count);
+  } catch (const std::bad_alloc&) {
+    uffd_cleanup(ctx);
+    CPLError(CE_Failure, CPLE_OutOfMemory,
+             "CPLCreateUserFaultMappingWithCallback(): out of memory");
+    return nullptr;
+  }
+  if (nCacheSize > 0) {
+    // Make sure that a page being read by the application cannot be
+    // immediately evicted by the pages being prefetched by the workers
+    const size_t min_resident_pages =
+        2 * static_cast<size_t>(nThreads) * (ctx->prefetch_pages + 1) + 2;
+    ctx->max_resident_pages = std::max(nCacheSize / nPageSize, min_resident_pages);
+  }
+
+  ctx->vma_ptr = mmap(nullptr, ctx->vma_size, PROT_READ, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  if (ctx->vma_ptr == BAD_MMAP) {
+    ctx->vma_ptr = nullptr;
     uffd_cleanup(ctx);
     CPLError(CE_Failure, CPLE_AppDefined,
-             "CPLCreateUserFaultMapping(): ioctl(UFFDIO_REGISTER) failed");
+             "CPLCreateUserFaultMappingWithCallback(): mmap() failed");
     return nullptr;
   }
 
-  // Start handler thread
-  ctx->thread = CPLCreateJoinableThread(cpl_uffd_fault_handler, ctx);
-  if( ctx->thread == nullptr )
-  {
+  if (!uffd_open_and_register(ctx, "CPLCreateUserFaultMappingWithCallback")) {
+    uffd_cleanup(ctx);
+    return nullptr;
+  }
+
+  for (int i = 0; i < nThreads; ++i) {
+    CPLJoinableThread * worker = CPLCreateJoinableThread(cpl_uffd_callback_worker, ctx);
+    if (worker == nullptr) {
       CPLError(CE_Failure, CPLE_AppDefined,
-               "CPLCreateUserFaultMapping(): CPLCreateJoinableThread() failed");
+               "CPLCreateUserFaultMappingWithCallback(): CPLCreateJoinableThread() failed");
       uffd_cleanup(ctx);
       return nullptr;
+    }
+    ctx->workers.push_back(worker);
   }
 
   *ppVma = ctx->vma_ptr;
@@ -42,11 +42,18 @@
 
 
 #define GDAL_UFFD_LIMIT "GDAL_UFFD_LIMIT"
+#define GDAL_UFFD_PREFETCH_PAGES "GDAL_UFFD_PREFETCH_PAGES"
 
 typedef struct cpl_uffd_context cpl_uffd_context;
 
+/* Fills nToFill bytes of pPageToFill with the content at nOffset. May be
+ * called concurrently from the worker threads. */
+typedef void (*CPLUserFaultFillCbk)(size_t nOffset, void * pPageToFill,
+                                    size_t nToFill, void * pUserData);
+
 bool CPLIsUserFaultMappingSupported();
 cpl_uffd_context * CPLCreateUserFaultMapping(const char * pszFilename, void ** ppVma, uint64_t * pnVmaSize);
+cpl_uffd_context * CPLCreateUserFaultMappingWithCallback(size_t nSize, size_t nPageSize, size_t nCacheSize, int nThreads, CPLUserFaultFillCbk pfnFill, void * pUserData, void ** ppVma, uint64_t * pnVmaSize);
 void CPLDeleteUserFaultMapping(cpl_uffd_context * ctx);
 
 #endif
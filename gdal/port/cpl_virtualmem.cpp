@@ -62,6 +62,11 @@ CPL_CVSID("$Id$")
 #define HAVE_VIRTUAL_MEM_VMA
 #endif
 
+#if defined(ENABLE_UFFD) && defined(HAVE_VIRTUAL_MEM_VMA)
+#define HAVE_VIRTUAL_MEM_UFFD
+#include "cpl_userfaultfd.h"
+#endif
+
 #if defined(HAVE_MMAP) || defined(HAVE_VIRTUAL_MEM_VMA)
 #include <unistd.h>     // read, write, close, pipe, sysconf
 #include <sys/mman.h>   // mmap, munmap, mremap
@@ -70,7 +75,8 @@ CPL_CVSID("$Id$")
 typedef enum
 {
     VIRTUAL_MEM_TYPE_FILE_MEMORY_MAPPED,
-    VIRTUAL_MEM_TYPE_VMA
+    VIRTUAL_MEM_TYPE_VMA,
+    VIRTUAL_MEM_TYPE_USERFAULTFD
 } CPLVirtualMemType;
 
 struct CPLVirtualMem
@@ -549,7 +555,7 @@ static void CPLVirtualMemSIGUSR1Handler( int /* signum_unused */,
 
 void CPLVirtualMemDeclareThread( CPLVirtualMem* ctxt )
 {
-    if( ctxt->eType == VIRTUAL_MEM_TYPE_FILE_MEMORY_MAPPED )
+    if( ctxt->eType != VIRTUAL_MEM_TYPE_VMA )
         return;
 #ifndef HAVE_5ARGS_MREMAP
     CPLVirtualMemVMA* ctxtVMA = reinterpret_cast<CPLVirtualMemVMA *>(ctxt);
@@ -571,7 +577,7 @@ void CPLVirtualMemDeclareThread( CPLVirtualMem* ctxt )
 
 void CPLVirtualMemUnDeclareThread( CPLVirtualMem* ctxt )
 {
-    if( ctxt->eType == VIRTUAL_MEM_TYPE_FILE_MEMORY_MAPPED )
+    if( ctxt->eType != VIRTUAL_MEM_TYPE_VMA )
         return;
 #ifndef HAVE_5ARGS_MREMAP
     CPLVirtualMemVMA* ctxtVMA = reinterpret_cast<CPLVirtualMemVMA *>(ctxt);
@@ -1582,6 +1588,18 @@ void CPLVirtualMemPin( CPLVirtualMem* ctxt,
     if( ctxt->eType == VIRTUAL_MEM_TYPE_FILE_MEMORY_MAPPED )
         return;
 
+    if( ctxt->eType == VIRTUAL_MEM_TYPE_USERFAULTFD )
+    {
+        // Just touch the pages: the faults are serviced by the userfaultfd
+        // workers.
+        const volatile char* pBase = static_cast<const volatile char*>(
+            ALIGN_DOWN(pAddr, ctxt->nPageSize));
+        const char* pEnd = static_cast<const char*>(pAddr) + nSize;
+        for( ; pBase < pEnd; pBase += ctxt->nPageSize )
+            CPL_IGNORE_RET_VAL(*pBase);
+        return;
+    }
+
     CPLVirtualMemMsgToWorkerThread msg;
 
     memset(&msg, 0, sizeof(msg));
@@ -2136,6 +2154,120 @@ CPLVirtualMem *CPLVirtualMemFileMapNew(
 
 #endif  // HAVE_MMAP
 
+/************************************************************************/
+/*                  CPLIsVirtualMemUserFaultAvailable()                 */
+/************************************************************************/
+
+int CPLIsVirtualMemUserFaultAvailable( void )
+{
+#ifdef HAVE_VIRTUAL_MEM_UFFD
+    return CPLIsUserFaultMappingSupported();
+#else
+    return FALSE;
+#endif
+}
+
+#ifdef HAVE_VIRTUAL_MEM_UFFD
+
+typedef struct
+{
+    CPLVirtualMem               sBase;
+
+    cpl_uffd_context           *psUFFDContext;
+    CPLVirtualMemCachePageCbk   pfnCachePage;
+} CPLVirtualMemUFFD;
+
+/************************************************************************/
+/*                   CPLVirtualMemUserFaultFillPage()                   */
+/************************************************************************/
+
+static void CPLVirtualMemUserFaultFillPage( size_t nOffset,
+                                            void* pPageToFill,
+                                            size_t nToFill,
+                                            void* pUserData )
+{
+    CPLVirtualMemUFFD* ctxt = static_cast<CPLVirtualMemUFFD*>(pUserData);
+    ctxt->pfnCachePage(reinterpret_cast<CPLVirtualMem*>(ctxt),
+                       nOffset, pPageToFill, nToFill,
+                       ctxt->sBase.pCbkUserData);
+}
+
+/************************************************************************/
+/*                      CPLVirtualMemUserFaultNew()                     */
+/************************************************************************/
+
+CPLVirtualMem *CPLVirtualMemUserFaultNew(
+    size_t nSize,
+    size_t nCacheSize,
+    size_t nPageSizeHint,
+    int nThreads,
+    CPLVirtualMemCachePageCbk pfnCachePage,
+    CPLVirtualMemFreeUserData pfnFreeUserData,
+    void *pCbkUserData )
+{
+    IGNORE_OR_ASSERT_IN_DEBUG(nSize > 0);
+    IGNORE_OR_ASSERT_IN_DEBUG(pfnCachePage != nullptr);
+
+    const size_t nMinPageSize = CPLGetPageSize();
+    size_t nPageSize = DEFAULT_PAGE_SIZE;
+    if( nPageSizeHint >= nMinPageSize && nPageSizeHint <= MAXIMUM_PAGE_SIZE )
+    {
+        nPageSize =
+            (nPageSizeHint + nMinPageSize - 1) / nMinPageSize * nMinPageSize;
+    }
+    if( (nPageSize % nMinPageSize) != 0 )
+        nPageSize = nMinPageSize;
+
+    CPLVirtualMemUFFD* ctxt = static_cast<CPLVirtualMemUFFD *>(
+        VSI_CALLOC_VERBOSE(1, sizeof(CPLVirtualMemUFFD)));
+    if( ctxt == nullptr )
+        return nullptr;
+    ctxt->sBase.nRefCount = 1;
+    ctxt->sBase.eType = VIRTUAL_MEM_TYPE_USERFAULTFD;
+    ctxt->sBase.eAccessMode = VIRTUALMEM_READONLY_ENFORCED;
+    ctxt->sBase.nPageSize = nPageSize;
+    ctxt->sBase.nSize = nSize;
+    ctxt->sBase.bSingleThreadUsage = false;
+    ctxt->sBase.pfnFreeUserData = pfnFreeUserData;
+    ctxt->sBase.pCbkUserData = pCbkUserData;
+    ctxt->pfnCachePage = pfnCachePage;
+
+    void* pData = nullptr;
+    uint64_t nVMASize = 0;
+    ctxt->psUFFDContext = CPLCreateUserFaultMappingWithCallback(
+        nSize, nPageSize, nCacheSize, nThreads,
+        CPLVirtualMemUserFaultFillPage, ctxt, &pData, &nVMASize);
+    if( ctxt->psUFFDContext == nullptr )
+    {
+        CPLFree(ctxt);
+        return nullptr;
+    }
+    // Unmapped by CPLDeleteUserFaultMapping().
+    ctxt->sBase.pData = pData;
+    ctxt->sBase.pDataToFree = nullptr;
+
+    return reinterpret_cast<CPLVirtualMem*>(ctxt);
+}
+
+#else  // HAVE_VIRTUAL_MEM_UFFD
+
+CPLVirtualMem *CPLVirtualMemUserFaultNew(
+    size_t /* nSize */,
+    size_t /* nCacheSize */,
+    size_t /* nPageSizeHint */,
+    int /* nThreads */,
+    CPLVirtualMemCachePageCbk /* pfnCachePage */,
+    CPLVirtualMemFreeUserData /* pfnFreeUserData */,
+    void * /* pCbkUserData */ )
+{
+    CPLError(CE_Failure, CPLE_NotSupported,
+             "CPLVirtualMemUserFaultNew() unsupported on "
+             "this operating system / configuration");
+    return nullptr;
+}
+
+#endif  // HAVE_VIRTUAL_MEM_UFFD
+
 /************************************************************************/
 /*                         CPLGetPageSize()                             */
 /************************************************************************/
@@ -2189,6 +2321,11 @@ void CPLVirtualMemFree( CPLVirtualMem* ctxt )
       CPLVirtualMemFreeFileMemoryMapped(
           reinterpret_cast<CPLVirtualMemVMA*>(ctxt));
 #endif
+#ifdef HAVE_VIRTUAL_MEM_UFFD
+    if( ctxt->eType == VIRTUAL_MEM_TYPE_USERFAULTFD )
+        CPLDeleteUserFaultMapping(
+            reinterpret_cast<CPLVirtualMemUFFD*>(ctxt)->psUFFDContext);
+#endif
 
     if( ctxt->pfnFreeUserData != nullptr )
         ctxt->pfnFreeUserData(ctxt->pCbkUserData);
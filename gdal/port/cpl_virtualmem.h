@@ -174,6 +174,61 @@ CPLVirtualMem CPL_DLL *CPLVirtualMemNew(size_t nSize,
                                         CPLVirtualMemFreeUserData pfnFreeUserData,
                                         void *pCbkUserData);
 
+/** Return if virtual memory mappings serviced by userfaultfd are available.
+ *
+ * This requires GDAL to be built with userfaultfd support, a Linux kernel
+ * 4.3 or newer, and the permission to use the userfaultfd() system call.
+ *
+ * @return TRUE if CPLVirtualMemUserFaultNew() can be used.
+ * @since GDAL 3.4
+ */
+int CPL_DLL CPLIsVirtualMemUserFaultAvailable(void);
+
+/** Create a new read-only virtual memory mapping serviced by userfaultfd.
+ *
+ * This is similar to CPLVirtualMemNew() with VIRTUALMEM_READONLY_ENFORCED
+ * access mode, except that page faults are reported by the kernel through
+ * a userfaultfd file descriptor instead of a SIGSEGV handler. The
+ * application threads accessing the mapping need no special handling, and
+ * page faults are serviced concurrently by nThreads worker threads. When
+ * pages are accessed sequentially, the following pages in the direction of
+ * access are filled ahead of time. The number of pages read ahead can be
+ * set with the GDAL_UFFD_PREFETCH_PAGES configuration option (default 4,
+ * 0 to disable).
+ *
+ * As pfnCachePage may be called simultaneously from several worker threads,
+ * it must be thread-safe when nThreads is greater than 1.
+ *
+ * Only available on Linux.
+ *
+ * @param nSize size in bytes of the virtual memory mapping.
+ * @param nCacheSize   size in bytes of the maximum memory that will be really
+ *                     allocated (must ideally fit into RAM).
+ * @param nPageSizeHint hint for the page size. Must be a multiple of the
+ *                      system page size, returned by CPLGetPageSize().
+ *                      Might be set to 0 to let the function determine a
+ *                      default page size.
+ * @param nThreads number of worker threads servicing page faults.
+ * @param pfnCachePage callback triggered when a still unmapped page of virtual
+ *                     memory is accessed or prefetched.
+ * @param pfnFreeUserData callback that can be used to free pCbkUserData.
+ *                        Might be NULL
+ * @param pCbkUserData user data passed to pfnCachePage.
+ *
+ * @return a virtual memory object that must be freed by CPLVirtualMemFree(),
+ *         or NULL in case of failure.
+ *
+ * @since GDAL 3.4
+ */
+CPLVirtualMem CPL_DLL *CPLVirtualMemUserFaultNew(
+                                        size_t nSize,
+                                        size_t nCacheSize,
+                                        size_t nPageSizeHint,
+                                        int nThreads,
+                                        CPLVirtualMemCachePageCbk pfnCachePage,
+                                        CPLVirtualMemFreeUserData pfnFreeUserData,
+                                        void *pCbkUserData);
+
 /** Return if virtual memory mapping of a file is available.
  *
  * @return TRUE if virtual memory mapping of a file is available.
@@ -165,6 +165,16 @@ vsi_l_offset CPL_DLL VSIFTellL( VSILFILE * ) CPL_WARN_UNUSED_RESULT;
 void CPL_DLL    VSIRewindL( VSILFILE * );
 size_t CPL_DLL  VSIFReadL( void *, size_t, size_t, VSILFILE * ) EXPERIMENTAL_CPL_WARN_UNUSED_RESULT;
 int CPL_DLL     VSIFReadMultiRangeL( int nRanges, void ** ppData, const vsi_l_offset* panOffsets, const size_t* panSizes, VSILFILE * ) EXPERIMENTAL_CPL_WARN_UNUSED_RESULT;
+
+/** Callback called when the reads submitted with VSIFReadAsyncL() are
+ * completed.
+ * @param nRet 0 if all ranges have been read, -1 otherwise.
+ * @param pUserData user data passed to VSIFReadAsyncL().
+ * @since GDAL 3.4
+ */
+typedef void (*VSIReadAsyncCallback)( int nRet, void* pUserData );
+int CPL_DLL     VSIFReadAsyncL( int nRanges, void ** ppData, const vsi_l_offset* panOffsets, const size_t* panSizes, VSIReadAsyncCallback pfnCallback, void* pUserData, VSILFILE * ) EXPERIMENTAL_CPL_WARN_UNUSED_RESULT;
+void CPL_DLL    VSIFWaitAsyncL( VSILFILE * );
 size_t CPL_DLL  VSIFWriteL( const void *, size_t, size_t, VSILFILE * ) EXPERIMENTAL_CPL_WARN_UNUSED_RESULT;
 int CPL_DLL     VSIFEofL( VSILFILE * ) EXPERIMENTAL_CPL_WARN_UNUSED_RESULT;
 int CPL_DLL     VSIFTruncateL( VSILFILE *, vsi_l_offset ) EXPERIMENTAL_CPL_WARN_UNUSED_RESULT;
@@ -379,6 +389,12 @@ GIntBig CPL_DLL VSIGetDiskFreeSpace(const char *pszDirname);
 void CPL_DLL VSINetworkStatsReset( void );
 char CPL_DLL *VSINetworkStatsGetAsSerializedJSON( char** papszOptions );
 
+int CPL_DLL VSIIOTraceStart( const char* pszTraceFilename,
+                             CSLConstList papszOptions );
+int CPL_DLL VSIIOTraceStop( void );
+char CPL_DLL **VSIIOTraceReplay( const char* pszTraceFilename,
+                                 CSLConstList papszOptions );
+
 /* ==================================================================== */
 /*      Install special file access handlers.                           */
 /* ==================================================================== */
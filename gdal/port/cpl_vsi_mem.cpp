@@ -848,6 +848,32 @@ GIntBig VSIMemFilesystemHandler::GetDiskFreeSpace( const char* /*pszDirname*/ )
     return nRet;
 }
 
+/************************************************************************/
+/*                        VSIMemGetMemoryUsage()                        */
+/************************************************************************/
+
+// Return the number of bytes allocated for the content of /vsimem/ files.
+// Buffers not owned by their file (see VSIFileFromMemBuffer()) are not
+// counted.
+GIntBig VSIMemGetMemoryUsage()
+{
+    VSIMemFilesystemHandler *poHandler =
+        dynamic_cast<VSIMemFilesystemHandler *>(
+            VSIFileManager::GetHandler("/vsimem/"));
+    if( poHandler == nullptr )
+        return 0;
+
+    CPLMutexHolder oHolder( &poHandler->hMutex );
+    GIntBig nTotal = 0;
+    for( const auto& oIter: poHandler->oFileList )
+    {
+        const VSIMemFile* poFile = oIter.second;
+        if( poFile->bOwnData )
+            nTotal += static_cast<GIntBig>(poFile->nAllocLength);
+    }
+    return nTotal;
+}
+
 //! @endcond
 
 /************************************************************************/
@@ -61,6 +61,12 @@ class CPL_DLL VSIVirtualHandle {
     virtual int       ReadMultiRange( int nRanges, void ** ppData,
                                       const vsi_l_offset* panOffsets,
                                       const size_t* panSizes );
+    virtual int       ReadAsync( int nRanges, void ** ppData,
+                                 const vsi_l_offset* panOffsets,
+                                 const size_t* panSizes,
+                                 VSIReadAsyncCallback pfnCallback,
+                                 void* pUserData );
+    virtual void      WaitAsync();
     virtual size_t    Write( const void *pBuffer, size_t nSize,size_t nCount)=0;
     virtual int       Eof() = 0;
     virtual int       Flush() {return 0;}
@@ -73,6 +79,11 @@ class CPL_DLL VSIVirtualHandle {
                                           { return VSI_RANGE_STATUS_UNKNOWN; }
 
     virtual           ~VSIVirtualHandle() { }
+
+  private:
+    // Whether ReadAsync() has been called since the last WaitAsync(), so
+    // that closing a handle without asynchronous reads takes no lock.
+    bool              m_bHasAsyncReads = false;
 };
 
 /************************************************************************/
@@ -198,9 +209,18 @@ public:
     time_t       mTime = 0;
     vsi_l_offset nFileSize = 0;
     int nEntries = 0;
+    int nEntriesAlloc = 0;
     VSIArchiveEntry* entries = nullptr;
+    std::map<CPLString, int> oMapFileNameToEntry{};
 
+    VSIArchiveContent() = default;
     ~VSIArchiveContent();
+
+    VSIArchiveEntry* AddEntry(const CPLString& osFileName);
+    const VSIArchiveEntry* FindEntry(const char* pszFileName) const;
+
+private:
+    CPL_DISALLOW_COPY_ASSIGN(VSIArchiveContent)
 };
 
 class VSIArchiveReader
@@ -281,4 +301,21 @@ VSIVirtualHandle CPL_DLL *VSICreateGZipWritable( VSIVirtualHandle* poBaseHandle,
 
 VSIVirtualHandle *VSICreateUploadOnCloseFile( VSIVirtualHandle* poBaseHandle );
 
+//! @cond Doxygen_Suppress
+// Internal use only, see cpl_vsil_io_trace.cpp
+bool VSIIOTraceIsEnabled();
+VSIVirtualHandle* VSIIOTraceOpen( VSIFilesystemHandler* poFSHandler,
+                                  const char* pszFilename,
+                                  const char* pszAccess, bool bSetError,
+                                  CSLConstList papszOptions );
+int VSIIOTraceStat( VSIFilesystemHandler* poFSHandler,
+                    const char* pszFilename, VSIStatBufL* psStatBuf,
+                    int nFlags );
+void VSIIOTraceFileConfigOptionChanged( const char* pszValue );
+
+// Internal use only, see GDALGetMemoryUsageSummary()
+GIntBig VSICurlGetRegionCacheMemoryUsage();
+GIntBig VSIMemGetMemoryUsage();
+//! @endcond
+
 #endif /* ndef CPL_VSI_VIRTUAL_H_INCLUDED */
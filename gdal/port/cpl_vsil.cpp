@@ -40,9 +40,11 @@
 #endif
 
 #include <algorithm>
+#include <condition_variable>
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <utility>
@@ -52,7 +54,9 @@
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
+#include "cpl_trace.h"
 #include "cpl_vsi_virtual.h"
+#include "cpl_worker_thread_pool.h"
 
 
 CPL_CVSID("$Id$")
@@ -889,6 +893,9 @@ int VSIStatExL( const char * pszFilename, VSIStatBufL *psStatBuf, int nFlags )
         nFlags = VSI_STAT_EXISTS_FLAG | VSI_STAT_NATURE_FLAG |
             VSI_STAT_SIZE_FLAG;
 
+    if( VSIIOTraceIsEnabled() )
+        return VSIIOTraceStat( poFSHandler, pszFilename, psStatBuf, nFlags );
+
     return poFSHandler->Stat( pszFilename, psStatBuf, nFlags );
 }
 
@@ -1765,11 +1772,21 @@ VSILFILE *VSIFOpenEx2L( const char * pszFilename, const char * pszAccess,
     if( CPLStrnlen(pszFilename, knMaxPath) == knMaxPath )
         return nullptr;
 
+    CPLTraceSpan oSpan("vsi", "VSIFOpenL");
+    if( oSpan.IsActive() )
+    {
+        oSpan.AddArg("filename", pszFilename);
+        oSpan.AddArg("access", pszAccess);
+    }
+
     VSIFilesystemHandler *poFSHandler =
         VSIFileManager::GetHandler( pszFilename );
 
     VSILFILE* fp = reinterpret_cast<VSILFILE *>(
-        poFSHandler->Open( pszFilename, pszAccess, CPL_TO_BOOL(bSetError), papszOptions ) );
+        VSIIOTraceIsEnabled() ?
+            VSIIOTraceOpen( poFSHandler, pszFilename, pszAccess,
+                            CPL_TO_BOOL(bSetError), papszOptions ) :
+            poFSHandler->Open( pszFilename, pszAccess, CPL_TO_BOOL(bSetError), papszOptions ) );
 
     VSIDebug4( "VSIFOpenEx2L(%s,%s,%d) = %p",
                pszFilename, pszAccess, bSetError, fp );
@@ -1818,6 +1835,8 @@ int VSIFCloseL( VSILFILE * fp )
 
     VSIDebug1( "VSIFCloseL(%p)", fp );
 
+    poFileHandle->WaitAsync();
+
     const int nResult = poFileHandle->Close();
 
     delete poFileHandle;
@@ -2034,6 +2053,10 @@ size_t VSIFReadL( void * pBuffer, size_t nSize, size_t nCount, VSILFILE * fp )
 {
     VSIVirtualHandle *poFileHandle = reinterpret_cast<VSIVirtualHandle *>( fp );
 
+    CPLTraceSpan oSpan("vsi", "VSIFReadL");
+    if( oSpan.IsActive() )
+        oSpan.AddArg("bytes", static_cast<GIntBig>(nSize * nCount));
+
     return poFileHandle->Read( pBuffer, nSize, nCount );
 }
 
@@ -2095,9 +2118,108 @@ int VSIFReadMultiRangeL( int nRanges, void ** ppData,
 {
     VSIVirtualHandle *poFileHandle = reinterpret_cast<VSIVirtualHandle *>(fp);
 
+    CPLTraceSpan oSpan("vsi", "VSIFReadMultiRangeL");
+    if( oSpan.IsActive() )
+        oSpan.AddArg("ranges", static_cast<GIntBig>(nRanges));
+
     return poFileHandle->ReadMultiRange(nRanges, ppData, panOffsets, panSizes);
 }
 
+/************************************************************************/
+/*                           VSIFReadAsyncL()                           */
+/************************************************************************/
+
+/**
+ * \fn VSIVirtualHandle::ReadAsync( int nRanges, void ** ppData,
+ *                                  const vsi_l_offset* panOffsets,
+ *                                  const size_t* panSizes,
+ *                                  VSIReadAsyncCallback pfnCallback,
+ *                                  void* pUserData )
+ * \brief Submit the read of several ranges of bytes from file.
+ *
+ * See VSIFReadAsyncL()
+ *
+ * @since GDAL 3.4
+ */
+
+/**
+ * \brief Submit the read of several ranges of bytes from file.
+ *
+ * This is the asynchronous version of VSIFReadMultiRangeL(). It returns
+ * as soon as the read has been submitted, and pfnCallback is called, from
+ * another thread, once all ranges have been read. The callback may also be
+ * called before this function returns, if the data is immediately
+ * available, for example in the cache of a network file system.
+ *
+ * The buffers must remain valid until the callback has been called, and no
+ * other operation than VSIFWaitAsyncL(), VSIFReadAsyncL() or VSIFCloseL()
+ * must be done on the handle in the meantime. VSIFCloseL() waits for the
+ * completion of pending reads.
+ *
+ * Network file systems derived from /vsicurl/ serve ranges from their
+ * cache without leaving the calling thread, and otherwise download them
+ * with parallel requests. Other file systems read them from a pool of
+ * threads whose size is set with the VSI_ASYNC_READ_NUM_THREADS
+ * configuration option (default 4).
+ *
+ * @param nRanges number of ranges to read.
+ * @param ppData array of nRanges buffer into which the data should be read
+ *               (ppData[i] must be at list panSizes[i] bytes).
+ * @param panOffsets array of nRanges offsets at which the data should be read.
+ *                   Ranges must be sorted in ascending start offset, and
+ *                   must not overlap each other.
+ * @param panSizes array of nRanges sizes of objects to read (in bytes).
+ * @param pfnCallback callback called once the read is completed.
+ * @param pUserData user data passed to pfnCallback.
+ * @param fp file handle opened with VSIFOpenL().
+ *
+ * @return 0 if the read has been submitted, -1 otherwise. In that later
+ * case, the callback is not called.
+ * @since GDAL 3.4
+ */
+
+int VSIFReadAsyncL( int nRanges, void ** ppData,
+                    const vsi_l_offset* panOffsets,
+                    const size_t* panSizes,
+                    VSIReadAsyncCallback pfnCallback, void* pUserData,
+                    VSILFILE * fp )
+{
+    VSIVirtualHandle *poFileHandle = reinterpret_cast<VSIVirtualHandle *>(fp);
+
+    return poFileHandle->ReadAsync(nRanges, ppData, panOffsets, panSizes,
+                                   pfnCallback, pUserData);
+}
+
+/************************************************************************/
+/*                           VSIFWaitAsyncL()                           */
+/************************************************************************/
+
+/**
+ * \fn VSIVirtualHandle::WaitAsync()
+ * \brief Wait for the completion of reads submitted with ReadAsync().
+ *
+ * See VSIFWaitAsyncL()
+ *
+ * @since GDAL 3.4
+ */
+
+/**
+ * \brief Wait for the completion of reads submitted with VSIFReadAsyncL().
+ *
+ * When this function returns, the callbacks of all the reads submitted on
+ * this handle have been called.
+ *
+ * @param fp file handle opened with VSIFOpenL().
+ * @since GDAL 3.4
+ */
+
+void VSIFWaitAsyncL( VSILFILE * fp )
+{
+    VSIVirtualHandle *poFileHandle = reinterpret_cast<VSIVirtualHandle *>(fp);
+
+    poFileHandle->WaitAsync();
+}
+
 /************************************************************************/
 /*                             VSIFWriteL()                             */
 /************************************************************************/
@@ -2149,6 +2271,10 @@ size_t VSIFWriteL( const void *pBuffer, size_t nSize, size_t nCount,
 {
     VSIVirtualHandle *poFileHandle = reinterpret_cast<VSIVirtualHandle *>( fp );
 
+    CPLTraceSpan oSpan("vsi", "VSIFWriteL");
+    if( oSpan.IsActive() )
+        oSpan.AddArg("bytes", static_cast<GIntBig>(nSize * nCount));
+
     return poFileHandle->Write( pBuffer, nSize, nCount );
 }
 
@@ -2871,6 +2997,149 @@ void VSIFileManager::InstallHandler( const std::string& osPrefix,
         Get()->oHandlers[osPrefix] = poHandler;
 }
 
+/************************************************************************/
+/*                          VSIAsyncReadState                           */
+/************************************************************************/
+
+namespace {
+
+// Reads submitted with the default implementation of ReadAsync() on a
+// given handle.
+struct VSIAsyncReadState
+{
+    std::mutex              oMutex{};
+    std::condition_variable oCV{};
+    int                     nPending = 0;
+    // Serializes the reads, since handles are not thread-safe.
+    std::mutex              oIOMutex{};
+};
+
+struct VSIAsyncReadJob
+{
+    VSIVirtualHandle                   *poHandle = nullptr;
+    std::shared_ptr<VSIAsyncReadState>  poState{};
+    std::vector<void*>                  apData{};
+    std::vector<vsi_l_offset>           anOffsets{};
+    std::vector<size_t>                 anSizes{};
+    VSIReadAsyncCallback                pfnCallback = nullptr;
+    void                               *pUserData = nullptr;
+};
+
+} // namespace
+
+static std::mutex goAsyncReadMutex;
+static std::map<VSIVirtualHandle*, std::shared_ptr<VSIAsyncReadState>>
+                                                        goMapAsyncReadState;
+static std::unique_ptr<CPLWorkerThreadPool> gpoAsyncReadPool;
+static std::unique_ptr<CPLJobQueue> gpoAsyncReadQueue;
+
+/************************************************************************/
+/*                          VSIAsyncReadFunc()                          */
+/************************************************************************/
+
+static void VSIAsyncReadFunc( void* pData )
+{
+    std::unique_ptr<VSIAsyncReadJob> poJob(
+        static_cast<VSIAsyncReadJob*>(pData));
+    int nRet;
+    {
+        std::lock_guard<std::mutex> oLock(poJob->poState->oIOMutex);
+        nRet = poJob->poHandle->ReadMultiRange(
+            static_cast<int>(poJob->apData.size()), poJob->apData.data(),
+            poJob->anOffsets.data(), poJob->anSizes.data());
+    }
+    poJob->pfnCallback(nRet, poJob->pUserData);
+
+    {
+        std::lock_guard<std::mutex> oLock(poJob->poState->oMutex);
+        poJob->poState->nPending--;
+    }
+    poJob->poState->oCV.notify_all();
+}
+
+/************************************************************************/
+/*                             ReadAsync()                              */
+/************************************************************************/
+
+int VSIVirtualHandle::ReadAsync( int nRanges, void ** ppData,
+                                 const vsi_l_offset* panOffsets,
+                                 const size_t* panSizes,
+                                 VSIReadAsyncCallback pfnCallback,
+                                 void* pUserData )
+{
+    if( nRanges < 0 || pfnCallback == nullptr )
+        return -1;
+
+    std::unique_ptr<VSIAsyncReadJob> poJob(new VSIAsyncReadJob());
+    poJob->poHandle = this;
+    poJob->apData.assign(ppData, ppData + nRanges);
+    poJob->anOffsets.assign(panOffsets, panOffsets + nRanges);
+    poJob->anSizes.assign(panSizes, panSizes + nRanges);
+    poJob->pfnCallback = pfnCallback;
+    poJob->pUserData = pUserData;
+
+    std::lock_guard<std::mutex> oLock(goAsyncReadMutex);
+    if( gpoAsyncReadPool == nullptr )
+    {
+        const int nThreads = std::max(1, atoi(
+            CPLGetConfigOption("VSI_ASYNC_READ_NUM_THREADS", "4")));
+        std::unique_ptr<CPLWorkerThreadPool> poPool(new CPLWorkerThreadPool());
+        if( !poPool->Setup(nThreads, nullptr, nullptr, false) )
+            return -1;
+        gpoAsyncReadPool = std::move(poPool);
+        gpoAsyncReadQueue = gpoAsyncReadPool->CreateJobQueue();
+    }
+
+    auto& poState = goMapAsyncReadState[this];
+    if( poState == nullptr )
+        poState = std::make_shared<VSIAsyncReadState>();
+    poJob->poState = poState;
+    {
+        std::lock_guard<std::mutex> oStateLock(poState->oMutex);
+        poState->nPending++;
+    }
+    if( !gpoAsyncReadQueue->SubmitJob(VSIAsyncReadFunc, poJob.get()) )
+    {
+        std::lock_guard<std::mutex> oStateLock(poState->oMutex);
+        poState->nPending--;
+        return -1;
+    }
+    poJob.release();
+    m_bHasAsyncReads = true;
+    return 0;
+}
+
+/************************************************************************/
+/*                             WaitAsync()                              */
+/************************************************************************/
+
+void VSIVirtualHandle::WaitAsync()
+{
+    // ReadAsync() and WaitAsync() are called by the thread that owns the
+    // handle, so the flag needs no synchronization.
+    if( !m_bHasAsyncReads )
+        return;
+    m_bHasAsyncReads = false;
+
+    std::shared_ptr<VSIAsyncReadState> poState;
+    {
+        std::lock_guard<std::mutex> oLock(goAsyncReadMutex);
+        auto oIter = goMapAsyncReadState.find(this);
+        if( oIter == goMapAsyncReadState.end() )
+            return;
+        poState = oIter->second;
+    }
+
+    {
+        std::unique_lock<std::mutex> oLock(poState->oMutex);
+        poState->oCV.wait(oLock, [&poState]{ return poState->nPending == 0; });
+    }
+
+    // No other thread can submit reads on this handle while we wait.
+    std::lock_guard<std::mutex> oLock(goAsyncReadMutex);
+    goMapAsyncReadState.erase(this);
+}
+
 /************************************************************************/
 /*                       VSICleanupFileManager()                        */
 /************************************************************************/
@@ -2878,6 +3147,12 @@ void VSIFileManager::InstallHandler( const std::string& osPrefix,
 void VSICleanupFileManager()
 
 {
+    {
+        std::lock_guard<std::mutex> oLock(goAsyncReadMutex);
+        gpoAsyncReadQueue.reset();
+        gpoAsyncReadPool.reset();
+    }
+
     if( poManager )
     {
         delete poManager;
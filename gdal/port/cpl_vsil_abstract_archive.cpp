@@ -29,13 +29,13 @@
 #include "cpl_port.h"
 #include "cpl_vsi_virtual.h"
 
+#include <algorithm>
 #include <cstring>
 #if HAVE_SYS_STAT_H
 #  include <sys/stat.h>
 #endif
 #include <ctime>
 #include <map>
-#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -146,6 +146,45 @@ static CPLString GetStrippedFilename(const CPLString& osFileName,
     return osRet;
 }
 
+/************************************************************************/
+/*                            AddEntry()                                */
+/************************************************************************/
+
+// Entries are added through this method, so that the array grows
+// geometrically and the map used for lookups is kept in sync, which matters
+// for archives with hundreds of thousands of members.
+VSIArchiveEntry* VSIArchiveContent::AddEntry( const CPLString& osFileName )
+{
+    if( nEntries == nEntriesAlloc )
+    {
+        nEntriesAlloc = std::max(16, nEntriesAlloc + nEntriesAlloc / 2);
+        entries = static_cast<VSIArchiveEntry *>(
+            CPLRealloc(entries, sizeof(VSIArchiveEntry) * nEntriesAlloc));
+    }
+    oMapFileNameToEntry[osFileName] = nEntries;
+    VSIArchiveEntry* psEntry = &entries[nEntries];
+    nEntries++;
+    psEntry->fileName = CPLStrdup(osFileName);
+    psEntry->uncompressed_size = 0;
+    psEntry->file_pos = nullptr;
+    psEntry->bIsDir = FALSE;
+    psEntry->nModifiedTime = 0;
+    return psEntry;
+}
+
+/************************************************************************/
+/*                            FindEntry()                               */
+/************************************************************************/
+
+const VSIArchiveEntry* VSIArchiveContent::FindEntry(
+                                        const char* pszFileName ) const
+{
+    const auto oIter = oMapFileNameToEntry.find(pszFileName);
+    if( oIter == oMapFileNameToEntry.end() )
+        return nullptr;
+    return &entries[oIter->second];
+}
+
 /************************************************************************/
 /*                       GetContentOfArchive()                          */
 /************************************************************************/
@@ -153,12 +192,15 @@ static CPLString GetStrippedFilename(const CPLString& osFileName,
 const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
     const char* archiveFilename, VSIArchiveReader* poReader )
 {
-    CPLMutexHolder oHolder( &hMutex );
-
+    // Stat the archive before taking the mutex, so that threads opening
+    // members of already listed archives do not wait for each other on
+    // network file systems.
     VSIStatBufL sStat;
     if( VSIStatL(archiveFilename, &sStat) != 0 )
         return nullptr;
 
+    CPLMutexHolder oHolder( &hMutex );
+
     if( oFileList.find(archiveFilename) != oFileList.end() )
     {
         VSIArchiveContent* content = oFileList[archiveFilename];
@@ -195,12 +237,8 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
     VSIArchiveContent* content = new VSIArchiveContent;
     content->mTime = sStat.st_mtime;
     content->nFileSize = static_cast<vsi_l_offset>(sStat.st_size);
-    content->nEntries = 0;
-    content->entries = nullptr;
     oFileList[archiveFilename] = content;
 
-    std::set<CPLString> oSet;
-
     do
     {
         const CPLString osFileName = poReader->GetFileName();
@@ -210,71 +248,42 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
         if( osStrippedFilename.empty() )
             continue;
 
-        if( oSet.find(osStrippedFilename) == oSet.end() )
+        if( content->FindEntry(osStrippedFilename) == nullptr )
         {
-            oSet.insert(osStrippedFilename);
-
             // Add intermediate directory structure.
             const char* pszBegin = osStrippedFilename.c_str();
             for( const char* pszIter = pszBegin; *pszIter; pszIter++ )
             {
                 if( *pszIter == '/' )
                 {
-                    char* pszStrippedFileName2 = CPLStrdup(osStrippedFilename);
-                    pszStrippedFileName2[pszIter - pszBegin] = 0;
-                    if( oSet.find(pszStrippedFileName2) == oSet.end() )
+                    const CPLString osDir(pszBegin, pszIter - pszBegin);
+                    if( content->FindEntry(osDir) == nullptr )
                     {
-                        oSet.insert(pszStrippedFileName2);
-
-                        content->entries = static_cast<VSIArchiveEntry *>(
-                            CPLRealloc(
-                                content->entries,
-                                sizeof(VSIArchiveEntry) *
-                                (content->nEntries + 1)));
-                        content->entries[content->nEntries].fileName =
-                            pszStrippedFileName2;
-                        content->entries[content->nEntries].nModifiedTime =
-                            poReader->GetModifiedTime();
-                        content->entries[content->nEntries].uncompressed_size =
-                            0;
-                        content->entries[content->nEntries].bIsDir = TRUE;
-                        content->entries[content->nEntries].file_pos = nullptr;
+                        VSIArchiveEntry* psEntry = content->AddEntry(osDir);
+                        psEntry->nModifiedTime = poReader->GetModifiedTime();
+                        psEntry->bIsDir = TRUE;
 #ifdef DEBUG_VERBOSE
-                        const int nEntries = content->nEntries;
                         CPLDebug(
                             "VSIArchive", "[%d] %s : " CPL_FRMT_GUIB " bytes",
-                            content->nEntries + 1,
-                            content->entries[nEntries].fileName,
-                            content->entries[nEntries].uncompressed_size);
+                            content->nEntries,
+                            psEntry->fileName,
+                            psEntry->uncompressed_size);
 #endif
-                        content->nEntries++;
-                    }
-                    else
-                    {
-                        CPLFree(pszStrippedFileName2);
                     }
                 }
             }
 
-            content->entries = static_cast<VSIArchiveEntry *>(
-                CPLRealloc(content->entries,
-                           sizeof(VSIArchiveEntry) * (content->nEntries + 1)));
-            content->entries[content->nEntries].fileName =
-                CPLStrdup(osStrippedFilename);
-            content->entries[content->nEntries].nModifiedTime =
-                poReader->GetModifiedTime();
-            content->entries[content->nEntries].uncompressed_size =
-                poReader->GetFileSize();
-            content->entries[content->nEntries].bIsDir = bIsDir;
-            content->entries[content->nEntries].file_pos =
-                poReader->GetFileOffset();
+            VSIArchiveEntry* psEntry = content->AddEntry(osStrippedFilename);
+            psEntry->nModifiedTime = poReader->GetModifiedTime();
+            psEntry->uncompressed_size = poReader->GetFileSize();
+            psEntry->bIsDir = bIsDir;
+            psEntry->file_pos = poReader->GetFileOffset();
 #ifdef DEBUG_VERBOSE
             CPLDebug("VSIArchive", "[%d] %s : " CPL_FRMT_GUIB " bytes",
-                     content->nEntries+1,
-                     content->entries[content->nEntries].fileName,
-                     content->entries[content->nEntries].uncompressed_size);
+                     content->nEntries,
+                     psEntry->fileName,
+                     psEntry->uncompressed_size);
 #endif
-            content->nEntries++;
         }
 
     } while( poReader->GotoNextFile() );
@@ -301,14 +310,12 @@ VSIArchiveFilesystemHandler::FindFileInArchive(
     const VSIArchiveContent* content = GetContentOfArchive(archiveFilename);
     if( content )
     {
-        for( int i = 0; i < content->nEntries; i++ )
+        const VSIArchiveEntry* psEntry = content->FindEntry(fileInArchiveName);
+        if( psEntry )
         {
-            if( strcmp(fileInArchiveName, content->entries[i].fileName) == 0)
-            {
-                if( archiveEntry )
-                    *archiveEntry = &content->entries[i];
-                return TRUE;
-            }
+            if( archiveEntry )
+                *archiveEntry = psEntry;
+            return TRUE;
         }
     }
     return FALSE;
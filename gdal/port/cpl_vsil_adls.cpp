@@ -842,6 +842,7 @@ char** VSIADLSFSHandler::GetFileMetadata( const char* pszFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1017,6 +1018,7 @@ bool VSIADLSFSHandler::SetFileMetadata( const char * pszFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1329,6 +1331,7 @@ int VSIADLSFSHandler::Rename( const char *oldpath, const char *newpath )
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1473,6 +1476,7 @@ int VSIADLSFSHandler::MkdirInternal( const char *pszDirname, long nMode, bool bD
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1619,6 +1623,7 @@ int VSIADLSFSHandler::RmdirInternal( const char * pszDirname, bool bRecursive )
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1776,6 +1781,7 @@ int VSIADLSFSHandler::CopyObject( const char *oldpath, const char *newpath,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1926,6 +1932,7 @@ bool VSIADLSFSHandler::UploadFile(const CPLString& osFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
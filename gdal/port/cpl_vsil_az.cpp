@@ -60,6 +60,8 @@ void VSIInstallAzureFileHandler( void )
 
 namespace cpl {
 
+constexpr int knMAX_BLOCK_NUMBER = 50000; // Limitation from Azure
+
 const char GDAL_MARKER_FOR_DIR[] = ".gdal_marker_for_dir";
 
 /************************************************************************/
@@ -703,6 +705,7 @@ char** VSIAzureFSHandler::GetFileMetadata( const char* pszFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -918,6 +921,7 @@ bool VSIAzureFSHandler::SetFileMetadata( const char * pszFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -951,9 +955,13 @@ class VSIAzureWriteHandle final : public VSIAppendWriteHandle
 
     std::unique_ptr<VSIAzureBlobHandleHelper> m_poHandleHelper{};
     CPLStringList                             m_aosOptions{};
+    std::unique_ptr<VSIParallelPartUploader>  m_poUploader{};
+    int                                       m_nBlockNumber = 0;
 
     bool                Send(bool bIsLastBlock) override;
     bool                SendInternal(bool bInitOnly, bool bIsLastBlock);
+    bool                SubmitBlock();
+    bool                SendBlocks(bool bIsLastBlock);
 
     void                InvalidateParentDirectory();
 
@@ -1000,6 +1008,21 @@ VSIAzureWriteHandle::VSIAzureWriteHandle( VSIAzureFSHandler* poFS,
         m_poHandleHelper(poHandleHelper),
         m_aosOptions(papszOptions)
 {
+    // With several parts uploaded in parallel, write a block blob with
+    // PutBlock / PutBlockList requests, instead of an append blob whose
+    // blocks must be sent in sequence.
+    const int nMaxInFlight = VSIParallelPartUploader::GetMaxInFlight();
+    if( nMaxInFlight > 1 )
+    {
+        // coverity[tainted_data]
+        const int nMaxRetry = atoi(CPLGetConfigOption("GDAL_HTTP_MAX_RETRY",
+                                   CPLSPrintf("%d",CPL_HTTP_MAX_RETRY)));
+        // coverity[tainted_data]
+        const double dfRetryDelay = CPLAtof(CPLGetConfigOption(
+            "GDAL_HTTP_RETRY_DELAY", CPLSPrintf("%f", CPL_HTTP_RETRY_DELAY)));
+        m_poUploader.reset(new VSIParallelPartUploader(
+            poFS, pszFilename, nMaxRetry, dfRetryDelay, nMaxInFlight));
+    }
 }
 
 /************************************************************************/
@@ -1032,6 +1055,9 @@ void VSIAzureWriteHandle::InvalidateParentDirectory()
 
 bool VSIAzureWriteHandle::Send(bool bIsLastBlock)
 {
+    if( m_poUploader )
+        return SendBlocks(bIsLastBlock);
+
     if( !bIsLastBlock )
     {
         CPLAssert( m_nBufferOff == m_nBufferSize );
@@ -1045,6 +1071,61 @@ bool VSIAzureWriteHandle::Send(bool bIsLastBlock)
     return SendInternal( false, bIsLastBlock );
 }
 
+/************************************************************************/
+/*                            SubmitBlock()                             */
+/************************************************************************/
+
+bool VSIAzureWriteHandle::SubmitBlock()
+{
+    ++m_nBlockNumber;
+    if( m_nBlockNumber > knMAX_BLOCK_NUMBER )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "%d blocks have been uploaded for %s. This is the maximum.",
+                 knMAX_BLOCK_NUMBER, m_osFilename.c_str());
+        return false;
+    }
+    const bool bSubmitted = m_poUploader->Submit(
+        m_nBlockNumber, m_nCurOffset - m_nBufferOff,
+        m_pabyBuffer, m_nBufferOff);
+    m_pabyBuffer = m_poUploader->AcquireBuffer(m_nBufferSize);
+    m_nBufferOff = 0;
+    return bSubmitted && m_pabyBuffer != nullptr;
+}
+
+/************************************************************************/
+/*                             SendBlocks()                             */
+/************************************************************************/
+
+bool VSIAzureWriteHandle::SendBlocks(bool bIsLastBlock)
+{
+    if( !bIsLastBlock )
+        return SubmitBlock();
+
+    // Small enough to be sent in a single request.
+    if( m_nBlockNumber == 0 )
+        return SendInternal( false, true );
+
+    bool bSuccess = m_nBufferOff == 0 || SubmitBlock();
+    if( !m_poUploader->WaitAll() )
+        bSuccess = false;
+    if( bSuccess )
+    {
+        // coverity[tainted_data]
+        const int nMaxRetry = atoi(CPLGetConfigOption("GDAL_HTTP_MAX_RETRY",
+                                   CPLSPrintf("%d",CPL_HTTP_MAX_RETRY)));
+        // coverity[tainted_data]
+        const double dfRetryDelay = CPLAtof(CPLGetConfigOption(
+            "GDAL_HTTP_RETRY_DELAY", CPLSPrintf("%f", CPL_HTTP_RETRY_DELAY)));
+        bSuccess = cpl::down_cast<VSIAzureFSHandler*>(m_poFS)->PutBlockList(
+            m_osFilename, m_poUploader->GetETags(), m_poHandleHelper.get(),
+            nMaxRetry, dfRetryDelay);
+        if( bSuccess )
+            InvalidateParentDirectory();
+    }
+    return bSuccess;
+}
+
 /************************************************************************/
 /*                          SendInternal()                              */
 /************************************************************************/
@@ -1166,6 +1247,7 @@ bool VSIAzureWriteHandle::SendInternal(bool bInitOnly, bool bIsLastBlock)
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1502,6 +1584,7 @@ int VSIAzureFSHandler::CopyObject( const char *oldpath, const char *newpath,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1628,6 +1711,7 @@ CPLString VSIAzureFSHandler::PutBlock(const CPLString& osFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1730,6 +1814,7 @@ bool VSIAzureFSHandler::PutBlockList(const CPLString& osFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
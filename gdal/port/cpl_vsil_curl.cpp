@@ -43,10 +43,18 @@
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "cpl_time.h"
+#include "cpl_trace.h"
 #include "cpl_vsi.h"
 #include "cpl_vsi_virtual.h"
 #include "cpl_http.h"
 #include "cpl_mem_cache.h"
+#include "cpl_sha256.h"
+
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
 
 #ifndef S_IRUSR
 #define S_IRUSR     00400
@@ -117,6 +125,11 @@ int VSICurlUninstallReadCbk( VSILFILE* /* fp */ )
     return FALSE;
 }
 
+GIntBig VSICurlGetRegionCacheMemoryUsage()
+{
+    return 0;
+}
+
 #else
 
 //! @cond Doxygen_Suppress
@@ -138,6 +151,9 @@ void VSICurlAuthParametersChanged()
 
 namespace cpl {
 
+constexpr const char* DISK_CACHE_MAGIC = "GDALVSIC";
+constexpr int DISK_CACHE_HEADER_SIZE = 16;
+
 // Do not access those 2 variables directly !
 // Use VSICURLGetDownloadChunkSize() and GetMaxRegions()
 static int N_MAX_REGIONS_DO_NOT_USE_DIRECTLY = 1000;
@@ -424,12 +440,145 @@ VSICurlHandle::VSICurlHandle( VSICurlFilesystemHandler* poFSIn,
     poFS->GetCachedFileProp(m_pszURL, oFileProp);
 }
 
+/************************************************************************/
+/*                         GetBlocksToDownload()                        */
+/************************************************************************/
+
+// Called on a region cache miss at chunk index nChunk. Returns the number of
+// chunks to read ahead, which is at most nMaxBlocks (unless a previous
+// download was already larger than that).
+int VSICurlAccessPatternTracker::GetBlocksToDownload( vsi_l_offset nChunk,
+                                                      int nMaxBlocks )
+{
+    ++m_nMisses;
+
+    // Is it the continuation of a tracked stream, either exactly where its
+    // last download ended, or a bit further within its read-ahead distance
+    // (some formats skip small parts of the file while reading it
+    // sequentially) ?
+    int iStream = -1;
+    bool bExact = false;
+    for( int i = 0; i < knMAX_STREAMS; ++i )
+    {
+        const Stream& oStream = m_asStreams[i];
+        if( oStream.nNextChunk == VSI_L_OFFSET_MAX )
+            continue;
+        if( oStream.nNextChunk == nChunk )
+        {
+            iStream = i;
+            bExact = true;
+            break;
+        }
+        if( iStream < 0 && nChunk > oStream.nNextChunk &&
+            nChunk - oStream.nNextChunk <
+                static_cast<vsi_l_offset>(oStream.nBlocks) )
+        {
+            iStream = i;
+        }
+    }
+
+    const GIntBig nStride =
+        m_nLastMissChunk == VSI_L_OFFSET_MAX ? 0 :
+        static_cast<GIntBig>(nChunk - m_nLastMissChunk);
+
+    if( iStream >= 0 )
+    {
+        Stream& oStream = m_asStreams[iStream];
+        if( bExact && oStream.nBlocks < nMaxBlocks )
+            oStream.nBlocks *= 2;
+
+        // Another stream used among the last misses ?
+        m_eLastPattern = Pattern::SEQUENTIAL;
+        for( int i = 0; i < knMAX_STREAMS; ++i )
+        {
+            if( i != iStream && m_asStreams[i].nBlocks > 1 &&
+                m_asStreams[i].nLastUse + 2 * knMAX_STREAMS >= m_nMisses )
+            {
+                m_eLastPattern = Pattern::MULTI_STREAM;
+                break;
+            }
+        }
+    }
+    else
+    {
+        m_eLastPattern = nStride != 0 && nStride == m_nLastStride ?
+            Pattern::STRIDED : Pattern::RANDOM;
+
+        // Start tracking a new stream in the least recently used slot,
+        // sparing established streams so that random reads in between do
+        // not reset their read-ahead.
+        iStream = 0;
+        for( int i = 1; i < knMAX_STREAMS; ++i )
+        {
+            const bool bEstablished = m_asStreams[i].nBlocks > 1;
+            const bool bCurEstablished = m_asStreams[iStream].nBlocks > 1;
+            if( bEstablished != bCurEstablished ? bCurEstablished :
+                m_asStreams[i].nLastUse < m_asStreams[iStream].nLastUse )
+            {
+                iStream = i;
+            }
+        }
+        m_asStreams[iStream].nBlocks = 1;
+    }
+
+    m_asStreams[iStream].nLastUse = m_nMisses;
+    m_iCurStream = iStream;
+    m_nLastMissChunk = nChunk;
+    m_nLastStride = nStride;
+    m_anPatternCount[static_cast<int>(m_eLastPattern)]++;
+
+    return m_asStreams[iStream].nBlocks;
+}
+
+/************************************************************************/
+/*                            SetDownloaded()                           */
+/************************************************************************/
+
+// Records that nBlocks chunks have been downloaded from nChunk, after the
+// value returned by GetBlocksToDownload() has been adjusted to the request
+// size and to the content of the region cache.
+void VSICurlAccessPatternTracker::SetDownloaded( vsi_l_offset nChunk,
+                                                 int nBlocks )
+{
+    m_asStreams[m_iCurStream].nNextChunk = nChunk + nBlocks;
+    m_asStreams[m_iCurStream].nBlocks = nBlocks;
+    m_nDownloadedBlocks += nBlocks;
+}
+
+/************************************************************************/
+/*                          ReportStatistics()                          */
+/************************************************************************/
+
+void VSICurlAccessPatternTracker::ReportStatistics( const char* pszDebugKey,
+                                                    const char* pszFilename,
+                                                    int nChunkSize ) const
+{
+    if( m_nMisses == 0 )
+        return;
+    CPLDebug(pszDebugKey,
+             "Access pattern for %s: " CPL_FRMT_GUIB " cache misses "
+             "(sequential: " CPL_FRMT_GUIB ", multi-stream: " CPL_FRMT_GUIB
+             ", strided: " CPL_FRMT_GUIB ", random: " CPL_FRMT_GUIB "), "
+             CPL_FRMT_GUIB " bytes requested",
+             pszFilename, m_nMisses,
+             m_anPatternCount[static_cast<int>(Pattern::SEQUENTIAL)],
+             m_anPatternCount[static_cast<int>(Pattern::MULTI_STREAM)],
+             m_anPatternCount[static_cast<int>(Pattern::STRIDED)],
+             m_anPatternCount[static_cast<int>(Pattern::RANDOM)],
+             m_nDownloadedBlocks * nChunkSize);
+}
+
 /************************************************************************/
 /*                          ~VSICurlHandle()                            */
 /************************************************************************/
 
 VSICurlHandle::~VSICurlHandle()
 {
+    if( ENABLE_DEBUG )
+    {
+        m_oAccessPattern.ReportStatistics(poFS->GetDebugKey(), m_osFilename,
+                                          VSICURLGetDownloadChunkSize());
+    }
     if( !m_bCached )
     {
         poFS->InvalidateCachedData(m_pszURL);
@@ -843,7 +992,10 @@ void MultiPerform(CURLM* hCurlMultiHandle, CURL* hEasyHandle)
     CPLHTTPRestoreSigPipeHandler(old_handler);
 
     if( hEasyHandle )
+    {
+        NetworkStatisticsLogger::LogTimings(hEasyHandle);
         curl_multi_remove_handle(hCurlMultiHandle, hEasyHandle);
+    }
 }
 
 /************************************************************************/
@@ -880,6 +1032,10 @@ vsi_l_offset VSICurlHandle::GetFileSizeOrHeaders( bool bSetError, bool bGetHeade
     NetworkStatisticsFile oContextFile(m_osFilename);
     NetworkStatisticsAction oContextAction("GetFileSize");
 
+    CPLTraceSpan oSpan("network", "VSICurlHandle::GetFileSize");
+    if( oSpan.IsActive() )
+        oSpan.AddArg("url", m_pszURL);
+
     oFileProp.bHasComputedFileSize = true;
 
     CURLM* hCurlMultiHandle = poFS->GetCurlMultiHandleFor(m_pszURL);
@@ -1247,6 +1403,7 @@ retry:
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 CPLFree(sWriteFuncData.pBuffer);
                 CPLFree(sWriteFuncHeaderData.pBuffer);
@@ -1420,6 +1577,14 @@ std::string VSICurlHandle::DownloadRegion( const vsi_l_offset startOffset,
     if( oFileProp.eExists == EXIST_NO )
         return std::string();
 
+    CPLTraceSpan oSpan("network", "VSICurlHandle::DownloadRegion");
+    if( oSpan.IsActive() )
+    {
+        oSpan.AddArg("url", m_pszURL);
+        oSpan.AddArg("offset", static_cast<GIntBig>(startOffset));
+        oSpan.AddArg("blocks", static_cast<GIntBig>(nBlocks));
+    }
+
     CURLM* hCurlMultiHandle = poFS->GetCurlMultiHandleFor(m_pszURL);
 
     bool bHasExpired = false;
@@ -1553,6 +1718,7 @@ retry:
         CPLFree(sWriteFuncData.pBuffer);
         CPLFree(sWriteFuncHeaderData.pBuffer);
         curl_easy_cleanup(hCurlHandle);
+        NetworkStatisticsLogger::LogRetry();
         nRetryCount++;
         if( Authenticate() )
             goto retry;
@@ -1628,6 +1794,7 @@ retry:
                         dfRetryDelay);
             CPLSleep(dfRetryDelay);
             dfRetryDelay = dfNewRetryDelay;
+            NetworkStatisticsLogger::LogRetry();
             nRetryCount++;
             CPLFree(sWriteFuncData.pBuffer);
             CPLFree(sWriteFuncHeaderData.pBuffer);
@@ -1748,8 +1915,6 @@ void VSICurlHandle::DownloadRegionPostProcess( const vsi_l_offset startOffset,
                                                size_t nSize )
 {
     const int knDOWNLOAD_CHUNK_SIZE = VSICURLGetDownloadChunkSize();
-    lastDownloadedOffset = startOffset + nBlocks * knDOWNLOAD_CHUNK_SIZE;
-
     if( nSize > static_cast<size_t>(nBlocks) * knDOWNLOAD_CHUNK_SIZE )
     {
         if( ENABLE_DEBUG )
@@ -1781,6 +1946,83 @@ void VSICurlHandle::DownloadRegionPostProcess( const vsi_l_offset startOffset,
 
 }
 
+/************************************************************************/
+/*                       DownloadRegionParallel()                       */
+/************************************************************************/
+
+// Download nBlocks chunks starting at startOffset with nParts concurrent
+// range requests, issued by ReadMultiRange() over the curl multi handle.
+// Returns an empty string on failure, in which case the caller should
+// revert to DownloadRegion().
+std::string VSICurlHandle::DownloadRegionParallel( vsi_l_offset startOffset,
+                                                   int nBlocks, int nParts )
+{
+    if( (bInterrupted && bStopOnInterruptUntilUninstall) ||
+        !oFileProp.bHasComputedFileSize ||
+        startOffset >= oFileProp.fileSize )
+        return std::string();
+
+    const int knDOWNLOAD_CHUNK_SIZE = VSICURLGetDownloadChunkSize();
+    const vsi_l_offset nEndOffset = std::min(oFileProp.fileSize,
+        startOffset + static_cast<vsi_l_offset>(nBlocks) * knDOWNLOAD_CHUNK_SIZE);
+    const size_t nTotalSize = static_cast<size_t>(nEndOffset - startOffset);
+    const size_t nPartSize =
+        static_cast<size_t>((nBlocks + nParts - 1) / nParts) *
+        knDOWNLOAD_CHUNK_SIZE;
+
+    std::string osRet;
+    try
+    {
+        osRet.resize(nTotalSize);
+    }
+    catch( const std::exception& )
+    {
+        return std::string();
+    }
+
+    std::vector<void*> apData;
+    std::vector<vsi_l_offset> anOffsets;
+    std::vector<size_t> anSizes;
+    for( size_t nOffset = 0; nOffset < nTotalSize; nOffset += nPartSize )
+    {
+        apData.push_back(&osRet[nOffset]);
+        anOffsets.push_back(startOffset + nOffset);
+        anSizes.push_back(std::min(nPartSize, nTotalSize - nOffset));
+    }
+    if( apData.size() < 2 )
+        return std::string();
+
+    if( ENABLE_DEBUG )
+        CPLDebug(poFS->GetDebugKey(),
+                 "Downloading " CPL_FRMT_GUIB "-" CPL_FRMT_GUIB
+                 " with %d parallel requests",
+                 startOffset, nEndOffset - 1, static_cast<int>(apData.size()));
+
+    int nRet;
+    {
+        // Errors will be reported by DownloadRegion() if they persist.
+        CPLErrorHandlerPusher oErrorHandler(CPLQuietErrorHandler);
+        // ReadMultiRange() may revert to Seek() + Read() in some cases.
+        const vsi_l_offset nSavedOffset = curOffset;
+        const bool bSavedEOF = bEOF;
+        m_bInParallelDownload = true;
+        nRet = ReadMultiRange(static_cast<int>(apData.size()), apData.data(),
+                              anOffsets.data(), anSizes.data());
+        m_bInParallelDownload = false;
+        curOffset = nSavedOffset;
+        bEOF = bSavedEOF;
+    }
+    if( nRet != 0 )
+    {
+        CPLDebug(poFS->GetDebugKey(), "Parallel download failed. "
+                 "Reverting to a single request");
+        return std::string();
+    }
+
+    DownloadRegionPostProcess(startOffset, nBlocks, osRet.data(), osRet.size());
+    return osRet;
+}
+
 /************************************************************************/
 /*                                Read()                                */
 /************************************************************************/
@@ -1806,6 +2048,9 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
     vsi_l_offset iterOffset = curOffset;
     const int knMAX_REGIONS = GetMaxRegions();
     const int knDOWNLOAD_CHUNK_SIZE = VSICURLGetDownloadChunkSize();
+    // Number of concurrent range requests used to download a region.
+    const int nParallelRequests = std::max(1, std::min(64,
+        atoi(CPLGetConfigOption("CPL_VSIL_CURL_PARALLEL_READ", "1"))));
     while( nBufferRequestSize )
     {
         // Don't try to read after end of file.
@@ -1825,26 +2070,21 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
                 (iterOffset / knDOWNLOAD_CHUNK_SIZE) * knDOWNLOAD_CHUNK_SIZE;
         std::string osRegion;
         std::shared_ptr<std::string> psRegion = poFS->GetRegion(m_pszURL, nOffsetToDownload);
+        NetworkStatisticsLogger::LogRegionCacheAccess(psRegion != nullptr);
         if( psRegion != nullptr )
         {
             osRegion = *psRegion;
         }
         else
         {
-            if( nOffsetToDownload == lastDownloadedOffset )
-            {
-                // In case of consecutive reads (of small size), we use a
-                // heuristic that we will read the file sequentially, so
-                // we double the requested size to decrease the number of
-                // client/server roundtrips.
-                if( nBlocksToDownload < 100 )
-                    nBlocksToDownload *= 2;
-            }
-            else
-            {
-                // Random reads. Cancel the above heuristics.
-                nBlocksToDownload = 1;
-            }
+            // The read-ahead doubles on each miss of a sequential stream
+            // to decrease the number of client/server roundtrips, and is
+            // reset to the requested size for random reads.
+            // With parallel requests, allow a read-ahead growing up to
+            // the same size per request.
+            int nBlocksToDownload = m_oAccessPattern.GetBlocksToDownload(
+                nOffsetToDownload / knDOWNLOAD_CHUNK_SIZE,
+                100 * nParallelRequests);
 
             // Ensure that we will request at least the number of blocks
             // to satisfy the remaining buffer size to read.
@@ -1875,13 +2115,23 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
             if( nBlocksToDownload > knMAX_REGIONS )
                 nBlocksToDownload = knMAX_REGIONS;
 
-            osRegion = DownloadRegion(nOffsetToDownload, nBlocksToDownload);
+            if( nParallelRequests > 1 && nBlocksToDownload > 1 &&
+                !m_bInParallelDownload )
+            {
+                osRegion = DownloadRegionParallel(
+                    nOffsetToDownload, nBlocksToDownload,
+                    std::min(nParallelRequests, nBlocksToDownload));
+            }
+            if( osRegion.empty() )
+                osRegion = DownloadRegion(nOffsetToDownload, nBlocksToDownload);
             if( osRegion.empty() )
             {
                 if( !bInterrupted )
                     bEOF = true;
                 return 0;
             }
+            m_oAccessPattern.SetDownloaded(
+                nOffsetToDownload / knDOWNLOAD_CHUNK_SIZE, nBlocksToDownload);
         }
 
         const vsi_l_offset nRegionOffset = iterOffset - nOffsetToDownload;
@@ -1920,6 +2170,71 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
     return ret;
 }
 
+/************************************************************************/
+/*                        ReadFromRegionCache()                         */
+/************************************************************************/
+
+// Copies [nOffset, nOffset + nSize[ into pData if all the chunks it spans
+// are in the region cache, without doing any network request.
+bool VSICurlHandle::ReadFromRegionCache( void* pData, vsi_l_offset nOffset,
+                                         size_t nSize )
+{
+    const int knDOWNLOAD_CHUNK_SIZE = VSICURLGetDownloadChunkSize();
+    GByte* pabyData = static_cast<GByte*>(pData);
+    while( nSize > 0 )
+    {
+        const vsi_l_offset nChunkOffset =
+            (nOffset / knDOWNLOAD_CHUNK_SIZE) * knDOWNLOAD_CHUNK_SIZE;
+        std::shared_ptr<std::string> psRegion =
+            poFS->GetRegion(m_pszURL, nChunkOffset);
+        const size_t nOffsetInChunk =
+            static_cast<size_t>(nOffset - nChunkOffset);
+        if( psRegion == nullptr || psRegion->size() <= nOffsetInChunk )
+            return false;
+        const size_t nToCopy =
+            std::min(nSize, psRegion->size() - nOffsetInChunk);
+        memcpy(pabyData, psRegion->data() + nOffsetInChunk, nToCopy);
+        pabyData += nToCopy;
+        nOffset += nToCopy;
+        nSize -= nToCopy;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                             ReadAsync()                              */
+/************************************************************************/
+
+int VSICurlHandle::ReadAsync( int nRanges, void ** ppData,
+                              const vsi_l_offset* panOffsets,
+                              const size_t* panSizes,
+                              VSIReadAsyncCallback pfnCallback,
+                              void* pUserData )
+{
+    if( nRanges < 0 || pfnCallback == nullptr )
+        return -1;
+
+    // Serve the request immediately if it is entirely cached.
+    // ReadFromRegionCache() does not modify the state of the handle, so
+    // this is safe even if reads are pending in a worker thread.
+    bool bAllCached = true;
+    for( int i = 0; bAllCached && i < nRanges; ++i )
+    {
+        bAllCached = ReadFromRegionCache(ppData[i], panOffsets[i],
+                                         panSizes[i]);
+    }
+    if( bAllCached )
+    {
+        pfnCallback(0, pUserData);
+        return 0;
+    }
+
+    // Otherwise ReadMultiRange() is run in a worker thread, and downloads
+    // the ranges in parallel through its curl multi handle.
+    return VSIVirtualHandle::ReadAsync(nRanges, ppData, panOffsets,
+                                       panSizes, pfnCallback, pUserData);
+}
+
 /************************************************************************/
 /*                           ReadMultiRange()                           */
 /************************************************************************/
@@ -1935,6 +2250,13 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
     if( oFileProp.eExists == EXIST_NO )
         return -1;
 
+    CPLTraceSpan oSpan("network", "VSICurlHandle::ReadMultiRange");
+    if( oSpan.IsActive() )
+    {
+        oSpan.AddArg("url", m_pszURL);
+        oSpan.AddArg("ranges", static_cast<GIntBig>(nRanges));
+    }
+
     NetworkStatisticsFileSystem oContextFS(poFS->GetFSPrefix());
     NetworkStatisticsFile oContextFile(m_osFilename);
     NetworkStatisticsAction oContextAction("ReadMultiRange");
@@ -1988,8 +2310,9 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
     };
     std::vector<CurlErrBuffer> asCurlErrors(nRanges);
 
-    const bool bMergeConsecutiveRanges = CPLTestBool(CPLGetConfigOption(
-        "GDAL_HTTP_MERGE_CONSECUTIVE_RANGES", "TRUE"));
+    const bool bMergeConsecutiveRanges = !m_bInParallelDownload &&
+        CPLTestBool(CPLGetConfigOption(
+            "GDAL_HTTP_MERGE_CONSECUTIVE_RANGES", "TRUE"));
 
     for( int i = 0, iRequest = 0; i < nRanges; )
     {
@@ -2078,6 +2401,8 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
     if( !aHandles.empty() )
     {
         MultiPerform(hMultiHandle);
+        for( CURL* hCurlHandle: aHandles )
+            NetworkStatisticsLogger::LogTimings(hCurlHandle);
     }
 
     int nRet = 0;
@@ -2725,6 +3050,18 @@ CURLM* VSICurlFilesystemHandler::GetCurlMultiHandleFor(const CPLString& /*osURL*
     if( conn.hCurlMultiHandle == nullptr )
     {
         conn.hCurlMultiHandle = curl_multi_init();
+#if CURL_AT_LEAST_VERSION(7,30,0)
+        // Cap the number of simultaneous connections to a same host done
+        // through this handle. Pending transfers are queued by curl.
+        const int nMaxHostConnections = atoi(
+            CPLGetConfigOption("GDAL_HTTP_MAX_HOST_CONNECTIONS", "0"));
+        if( nMaxHostConnections > 0 )
+        {
+            curl_multi_setopt(conn.hCurlMultiHandle,
+                              CURLMOPT_MAX_HOST_CONNECTIONS,
+                              static_cast<long>(nMaxHostConnections));
+        }
+#endif
     }
     return conn.hCurlMultiHandle;
 }
@@ -2743,6 +3080,233 @@ VSICurlFilesystemHandler::RegionCacheType* VSICurlFilesystemHandler::GetRegionCa
     return m_poRegionCacheDoNotUseDirectly.get();
 }
 
+/************************************************************************/
+/*                     GetRegionCacheMemoryUsage()                      */
+/************************************************************************/
+
+GIntBig VSICurlFilesystemHandler::GetRegionCacheMemoryUsage()
+{
+    CPLMutexHolder oHolder( &hMutex );
+
+    if( m_poRegionCacheDoNotUseDirectly == nullptr )
+        return 0;
+    GIntBig nTotal = 0;
+    auto lambda = [&nTotal](
+        const lru11::KeyValuePair<FilenameOffsetPair,
+                                  std::shared_ptr<std::string>>& kv)
+    {
+        nTotal += static_cast<GIntBig>(kv.value->capacity());
+    };
+    m_poRegionCacheDoNotUseDirectly->cwalk(lambda);
+    return nTotal;
+}
+
+/************************************************************************/
+/*                        GetDiskCacheFilename()                        */
+/************************************************************************/
+
+// Returns the filename in the disk cache of the region of pszURL starting at
+// nFileOffsetStart, or an empty string if the disk cache is disabled or the
+// ETag of the file is unknown. Entries are addressed by a hash of the URL,
+// the ETag, the offset and the chunk size, so that a modified file, or a
+// process using a different chunk size, cannot get stale or misaligned data.
+std::string VSICurlFilesystemHandler::GetDiskCacheFilename(
+                                            const char* pszURL,
+                                            vsi_l_offset nFileOffsetStart )
+{
+    const char* pszDir =
+        CPLGetConfigOption("CPL_VSIL_CURL_DISK_CACHE_DIR", nullptr);
+    if( pszDir == nullptr || pszDir[0] == '\0' )
+        return std::string();
+
+    FileProp oFileProp;
+    {
+        CPLMutexHolder oHolder( &hMutex );
+        if( !oCacheFileProp.tryGet(std::string(pszURL), oFileProp) ||
+            oFileProp.ETag.empty() )
+        {
+            return std::string();
+        }
+    }
+
+    const std::string osKey(CPLSPrintf("%s\n%s\n" CPL_FRMT_GUIB "\n%d",
+                                       pszURL, oFileProp.ETag.c_str(),
+                                       static_cast<GUIntBig>(nFileOffsetStart),
+                                       VSICURLGetDownloadChunkSize()));
+    GByte abyHash[CPL_SHA256_HASH_SIZE];
+    CPL_SHA256(osKey.data(), osKey.size(), abyHash);
+    char* pszHex = CPLBinaryToHex(CPL_SHA256_HASH_SIZE, abyHash);
+    const std::string osHex(pszHex);
+    CPLFree(pszHex);
+
+    // Spread entries over 256 sub-directories to keep directories small.
+    return CPLFormFilename(
+        CPLFormFilename(pszDir, osHex.substr(0, 2).c_str(), nullptr),
+        osHex.c_str(), "bin");
+}
+
+/************************************************************************/
+/*                       GetRegionFromDiskCache()                       */
+/************************************************************************/
+
+std::shared_ptr<std::string>
+VSICurlFilesystemHandler::GetRegionFromDiskCache( const std::string& osFilename )
+{
+    VSILFILE* fp = VSIFOpenL(osFilename.c_str(), "rb");
+    if( fp == nullptr )
+        return nullptr;
+
+    // Entries are made of a magic, the size of the region as a little
+    // endian 64 bit integer and the region itself.
+    std::shared_ptr<std::string> out;
+    GByte abyHeader[DISK_CACHE_HEADER_SIZE];
+    if( VSIFReadL(abyHeader, 1, sizeof(abyHeader), fp) == sizeof(abyHeader) &&
+        memcmp(abyHeader, DISK_CACHE_MAGIC, strlen(DISK_CACHE_MAGIC)) == 0 )
+    {
+        GUInt64 nSize = 0;
+        memcpy(&nSize, abyHeader + strlen(DISK_CACHE_MAGIC), sizeof(nSize));
+        CPL_LSBPTR64(&nSize);
+        if( nSize <= static_cast<GUInt64>(VSICURLGetDownloadChunkSize()) )
+        {
+            out.reset(new std::string());
+            out->resize(static_cast<size_t>(nSize));
+            if( VSIFReadL(&(*out)[0], 1, out->size(), fp) != out->size() )
+                out.reset();
+        }
+    }
+    VSIFCloseL(fp);
+
+    if( out )
+    {
+        // Refresh the modification time, which is used for LRU eviction.
+#ifdef _WIN32
+        _utime(osFilename.c_str(), nullptr);
+#else
+        utime(osFilename.c_str(), nullptr);
+#endif
+    }
+    return out;
+}
+
+/************************************************************************/
+/*                        AddRegionToDiskCache()                        */
+/************************************************************************/
+
+void VSICurlFilesystemHandler::AddRegionToDiskCache( const std::string& osFilename,
+                                                     size_t nSize,
+                                                     const char *pData )
+{
+    const std::string osSubDir(CPLGetPath(osFilename.c_str()));
+    VSIStatBufL sStat;
+    if( VSIStatL(osSubDir.c_str(), &sStat) != 0 )
+    {
+        VSIMkdir(CPLGetPath(osSubDir.c_str()), 0755);
+        VSIMkdir(osSubDir.c_str(), 0755);
+    }
+
+    // Write to a temporary file renamed into place once complete, so that
+    // other processes never see partial entries.
+    const std::string osTmpFilename(
+        osFilename + CPLSPrintf(".%d." CPL_FRMT_GIB ".tmp",
+                                CPLGetCurrentProcessID(), CPLGetPID()));
+    VSILFILE* fp = VSIFOpenL(osTmpFilename.c_str(), "wb");
+    if( fp == nullptr )
+        return;
+    GByte abyHeader[DISK_CACHE_HEADER_SIZE];
+    memcpy(abyHeader, DISK_CACHE_MAGIC, strlen(DISK_CACHE_MAGIC));
+    GUInt64 nSize64 = nSize;
+    CPL_LSBPTR64(&nSize64);
+    memcpy(abyHeader + strlen(DISK_CACHE_MAGIC), &nSize64, sizeof(nSize64));
+    bool bOK = VSIFWriteL(abyHeader, 1, sizeof(abyHeader), fp) ==
+                                                        sizeof(abyHeader) &&
+               VSIFWriteL(pData, 1, nSize, fp) == nSize;
+    bOK = VSIFCloseL(fp) == 0 && bOK;
+    if( !bOK || VSIRename(osTmpFilename.c_str(), osFilename.c_str()) != 0 )
+    {
+        VSIUnlink(osTmpFilename.c_str());
+        return;
+    }
+
+    const GIntBig nMaxSize = CPLAtoGIntBig(
+        CPLGetConfigOption("CPL_VSIL_CURL_DISK_CACHE_SIZE", "1073741824"));
+    bool bTrim = false;
+    {
+        CPLMutexHolder oHolder( &hMutex );
+        m_nDiskCacheBytesWrittenSinceTrim +=
+            static_cast<GIntBig>(nSize + sizeof(abyHeader));
+        // Only scan the cache directory once 1/16th of its maximum size
+        // has been written, or at the first write, since other processes
+        // may have filled it.
+        if( !m_bDiskCacheTrimmed ||
+            m_nDiskCacheBytesWrittenSinceTrim > nMaxSize / 16 )
+        {
+            m_bDiskCacheTrimmed = true;
+            m_nDiskCacheBytesWrittenSinceTrim = 0;
+            bTrim = true;
+        }
+    }
+    if( bTrim )
+        TrimDiskCache(CPLGetPath(osSubDir.c_str()), nMaxSize);
+}
+
+/************************************************************************/
+/*                           TrimDiskCache()                            */
+/************************************************************************/
+
+// Removes the least recently used entries of the disk cache until its
+// size is below 90% of nMaxSize. Entries may be concurrently removed by
+// other processes, hence errors are silently ignored.
+void VSICurlFilesystemHandler::TrimDiskCache( const std::string& osDir,
+                                              GIntBig nMaxSize )
+{
+    struct Entry
+    {
+        std::string osFilename{};
+        GIntBig     nSize = 0;
+        GIntBig     nMTime = 0;
+    };
+    std::vector<Entry> aoEntries;
+    GIntBig nTotalSize = 0;
+    CPLStringList aosSubDirs(VSIReadDir(osDir.c_str()));
+    for( int i = 0; i < aosSubDirs.size(); ++i )
+    {
+        if( strlen(aosSubDirs[i]) != 2 )
+            continue;
+        const std::string osSubDir(
+            CPLFormFilename(osDir.c_str(), aosSubDirs[i], nullptr));
+        CPLStringList aosFiles(VSIReadDir(osSubDir.c_str()));
+        for( int j = 0; j < aosFiles.size(); ++j )
+        {
+            if( !EQUAL(CPLGetExtension(aosFiles[j]), "bin") )
+                continue;
+            Entry oEntry;
+            oEntry.osFilename =
+                CPLFormFilename(osSubDir.c_str(), aosFiles[j], nullptr);
+            VSIStatBufL sStat;
+            if( VSIStatL(oEntry.osFilename.c_str(), &sStat) != 0 )
+                continue;
+            oEntry.nSize = static_cast<GIntBig>(sStat.st_size);
+            oEntry.nMTime = static_cast<GIntBig>(sStat.st_mtime);
+            nTotalSize += oEntry.nSize;
+            aoEntries.emplace_back(std::move(oEntry));
+        }
+    }
+    if( nTotalSize <= nMaxSize )
+        return;
+
+    std::sort(aoEntries.begin(), aoEntries.end(),
+              [](const Entry& a, const Entry& b)
+              { return a.nMTime < b.nMTime; });
+    const GIntBig nTargetSize = nMaxSize / 10 * 9;
+    for( const auto& oEntry: aoEntries )
+    {
+        if( nTotalSize <= nTargetSize )
+            break;
+        VSIUnlink(oEntry.osFilename.c_str());
+        nTotalSize -= oEntry.nSize;
+    }
+}
+
 /************************************************************************/
 /*                          GetRegion()                                 */
 /************************************************************************/
@@ -2751,17 +3315,34 @@ std::shared_ptr<std::string>
 VSICurlFilesystemHandler::GetRegion( const char* pszURL,
                                      vsi_l_offset nFileOffsetStart )
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     const int knDOWNLOAD_CHUNK_SIZE = VSICURLGetDownloadChunkSize();
     nFileOffsetStart =
         (nFileOffsetStart / knDOWNLOAD_CHUNK_SIZE) * knDOWNLOAD_CHUNK_SIZE;
 
     std::shared_ptr<std::string> out;
-    if( GetRegionCache()->tryGet(
-        FilenameOffsetPair(std::string(pszURL), nFileOffsetStart), out) )
     {
-        return out;
+        CPLMutexHolder oHolder( &hMutex );
+
+        if( GetRegionCache()->tryGet(
+            FilenameOffsetPair(std::string(pszURL), nFileOffsetStart), out) )
+        {
+            return out;
+        }
+    }
+
+    const std::string osDiskCacheFilename =
+        GetDiskCacheFilename(pszURL, nFileOffsetStart);
+    if( !osDiskCacheFilename.empty() )
+    {
+        out = GetRegionFromDiskCache(osDiskCacheFilename);
+        if( out )
+        {
+            CPLMutexHolder oHolder( &hMutex );
+            GetRegionCache()->insert(
+                FilenameOffsetPair(std::string(pszURL), nFileOffsetStart),
+                out);
+            return out;
+        }
     }
 
     return nullptr;
@@ -2776,13 +3357,20 @@ void VSICurlFilesystemHandler::AddRegion( const char* pszURL,
                                           size_t nSize,
                                           const char *pData )
 {
-    CPLMutexHolder oHolder( &hMutex );
+    {
+        CPLMutexHolder oHolder( &hMutex );
 
-    std::shared_ptr<std::string> value(new std::string());
-    value->assign(pData, nSize);
-    GetRegionCache()->insert(
-        FilenameOffsetPair(std::string(pszURL), nFileOffsetStart),
-        value);
+        std::shared_ptr<std::string> value(new std::string());
+        value->assign(pData, nSize);
+        GetRegionCache()->insert(
+            FilenameOffsetPair(std::string(pszURL), nFileOffsetStart),
+            value);
+    }
+
+    const std::string osDiskCacheFilename =
+        GetDiskCacheFilename(pszURL, nFileOffsetStart);
+    if( !osDiskCacheFilename.empty() )
+        AddRegionToDiskCache(osDiskCacheFilename, nSize, pData);
 }
 
 /************************************************************************/
@@ -3034,6 +3622,12 @@ const char* VSICurlFilesystemHandler::GetActualURL(const char* pszFilename)
     "  </Option>" \
     "  <Option name='GDAL_HTTP_MULTIPLEX' type='boolean' " \
         "description='Whether to enable HTTP/2 multiplexing' default='YES'/>" \
+    "  <Option name='GDAL_HTTP_SHARE_CONNECTIONS' type='boolean' " \
+        "description='Whether to share DNS cache, TLS sessions and " \
+        "connections between all handles' default='NO'/>" \
+    "  <Option name='GDAL_HTTP_MAX_HOST_CONNECTIONS' type='integer' " \
+        "description='Maximum number of simultaneous connections to a " \
+        "host per thread. 0 means unlimited' default='0'/>" \
     "  <Option name='GDAL_HTTP_MERGE_CONSECUTIVE_RANGES' type='boolean' " \
         "description='Whether to merge consecutive ranges in multirange " \
         "requests' default='YES'/>" \
@@ -3061,6 +3655,11 @@ const char* VSICurlFilesystemHandler::GetActualURL(const char* pszFilename)
     "  <Option name='CPL_VSIL_CURL_CACHE_SIZE' type='integer' " \
         "description='Size in bytes of the global /vsicurl/ cache' " \
         "default='16384000'/>" \
+    "  <Option name='CPL_VSIL_CURL_DISK_CACHE_DIR' type='string' " \
+        "description='Directory of the persistent /vsicurl/ disk cache'/>" \
+    "  <Option name='CPL_VSIL_CURL_DISK_CACHE_SIZE' type='integer' " \
+        "description='Maximum size in bytes of the persistent /vsicurl/ " \
+        "disk cache' default='1073741824'/>" \
     "  <Option name='CPL_VSIL_CURL_IGNORE_GLACIER_STORAGE' type='boolean' " \
         "description='Whether to skip files with Glacier storage class in " \
         "directory listing.' default='YES'/>"
@@ -4747,6 +5346,91 @@ void NetworkStatisticsLogger::LogDELETE()
     }
 }
 
+void NetworkStatisticsLogger::LogRetry()
+{
+    if( !IsEnabled() ) return;
+    std::lock_guard<std::mutex> oLock(gInstance.m_mutex);
+    for( auto counters: gInstance.GetCountersForContext() )
+    {
+        counters->nRetries++;
+    }
+}
+
+void NetworkStatisticsLogger::LogRegionCacheAccess(bool bHit)
+{
+    if( !IsEnabled() ) return;
+    std::lock_guard<std::mutex> oLock(gInstance.m_mutex);
+    for( auto counters: gInstance.GetCountersForContext() )
+    {
+        if( bHit )
+            counters->nRegionCacheHits++;
+        else
+            counters->nRegionCacheMisses++;
+    }
+}
+
+// Upper bounds, in seconds, of the buckets of the time to first byte
+// histogram. The last bucket is unbounded.
+static const double kadfTTFBHistogramBounds[] = {
+    0.010, 0.050, 0.100, 0.250, 0.500, 1.0, 2.5 };
+static const char* const kapszTTFBHistogramNames[] = {
+    "0-10ms", "10-50ms", "50-100ms", "100-250ms", "250-500ms",
+    "500ms-1s", "1-2.5s", "2.5s+" };
+
+// Called once a request has completed, to account the durations of its
+// phases, as measured by curl. Those are cumulative from the start of the
+// request, and the ones of the connection phases are zero when an existing
+// connection is reused.
+void NetworkStatisticsLogger::LogTimings(CURL* hCurlHandle)
+{
+    if( !IsEnabled() ) return;
+
+    double dfNameLookup = 0;
+    double dfConnect = 0;
+    double dfAppConnect = 0;
+    double dfPreTransfer = 0;
+    double dfStartTransfer = 0;
+    double dfTotal = 0;
+    curl_easy_getinfo(hCurlHandle, CURLINFO_NAMELOOKUP_TIME, &dfNameLookup);
+    curl_easy_getinfo(hCurlHandle, CURLINFO_CONNECT_TIME, &dfConnect);
+    curl_easy_getinfo(hCurlHandle, CURLINFO_APPCONNECT_TIME, &dfAppConnect);
+    curl_easy_getinfo(hCurlHandle, CURLINFO_PRETRANSFER_TIME, &dfPreTransfer);
+    curl_easy_getinfo(hCurlHandle, CURLINFO_STARTTRANSFER_TIME,
+                      &dfStartTransfer);
+    curl_easy_getinfo(hCurlHandle, CURLINFO_TOTAL_TIME, &dfTotal);
+    if( dfTotal <= 0 )
+        return;
+
+    const double dfConnectTime = std::max(0.0, dfConnect - dfNameLookup);
+    const double dfTLSHandshakeTime =
+        dfAppConnect > 0 ? std::max(0.0, dfAppConnect - dfConnect) : 0.0;
+    const double dfServerTime =
+        dfStartTransfer > 0 ? std::max(0.0, dfStartTransfer - dfPreTransfer)
+                            : 0.0;
+    const double dfTransferTime =
+        dfStartTransfer > 0 ? std::max(0.0, dfTotal - dfStartTransfer) : 0.0;
+    const double dfTTFB = dfStartTransfer > 0 ? dfStartTransfer : dfTotal;
+    int iBucket = 0;
+    while( iBucket < static_cast<int>(CPL_ARRAYSIZE(kadfTTFBHistogramBounds)) &&
+           dfTTFB >= kadfTTFBHistogramBounds[iBucket] )
+    {
+        ++iBucket;
+    }
+
+    std::lock_guard<std::mutex> oLock(gInstance.m_mutex);
+    for( auto counters: gInstance.GetCountersForContext() )
+    {
+        counters->nTimedRequests++;
+        counters->dfNameLookupTime += dfNameLookup;
+        counters->dfConnectTime += dfConnectTime;
+        counters->dfTLSHandshakeTime += dfTLSHandshakeTime;
+        counters->dfServerTime += dfServerTime;
+        counters->dfTransferTime += dfTransferTime;
+        counters->dfTotalTime += dfTotal;
+        counters->anTimeToFirstByteHistogram[iBucket]++;
+    }
+}
+
 void NetworkStatisticsLogger::Reset()
 {
     std::lock_guard<std::mutex> oLock(gInstance.m_mutex);
@@ -4776,6 +5460,41 @@ void NetworkStatisticsLogger::Stats::AsJSON(CPLJSONObject& oJSON) const
     if( counters.nDELETE )
         oMethods.Add("DELETE/count", counters.nDELETE);
     oJSON.Add("methods", oMethods);
+    if( counters.nRetries )
+        oJSON.Add("retries/count", counters.nRetries);
+    if( counters.nRegionCacheHits || counters.nRegionCacheMisses )
+    {
+        CPLJSONObject oCache;
+        oCache.Add("hit_count", counters.nRegionCacheHits);
+        oCache.Add("miss_count", counters.nRegionCacheMisses);
+        oCache.Add("hit_ratio",
+                   static_cast<double>(counters.nRegionCacheHits) /
+                   (counters.nRegionCacheHits + counters.nRegionCacheMisses));
+        oJSON.Add("region_cache", oCache);
+    }
+    if( counters.nTimedRequests )
+    {
+        CPLJSONObject oTimings;
+        oTimings.Add("count", counters.nTimedRequests);
+        oTimings.Add("name_lookup_time_s", counters.dfNameLookupTime);
+        oTimings.Add("connect_time_s", counters.dfConnectTime);
+        oTimings.Add("tls_handshake_time_s", counters.dfTLSHandshakeTime);
+        oTimings.Add("server_time_s", counters.dfServerTime);
+        oTimings.Add("transfer_time_s", counters.dfTransferTime);
+        oTimings.Add("total_time_s", counters.dfTotalTime);
+        CPLJSONObject oHistogram;
+        for( int i = 0;
+             i < static_cast<int>(CPL_ARRAYSIZE(kapszTTFBHistogramNames)); ++i )
+        {
+            if( counters.anTimeToFirstByteHistogram[i] )
+            {
+                oHistogram.Add(kapszTTFBHistogramNames[i],
+                               counters.anTimeToFirstByteHistogram[i]);
+            }
+        }
+        oTimings.Add("time_to_first_byte_histogram", oHistogram);
+        oJSON.Add("timings", oTimings);
+    }
     CPLJSONObject oFiles;
     bool bFilesAdded = false;
     for( const auto &kv: children )
@@ -4882,6 +5601,15 @@ struct curl_slist* VSICurlSetOptions(
     struct curl_slist* headers = static_cast<struct curl_slist*>(
         CPLHTTPSetOptions(hCurlHandle, pszURL, papszOptions));
 
+    // Share DNS resolutions, TLS sessions and connections with all other
+    // handles of network file systems, whichever thread they run in.
+    if( CPLTestBool(CPLGetConfigOption("GDAL_HTTP_SHARE_CONNECTIONS", "NO")) )
+    {
+        void* hShareHandle = CPLHTTPGetShareHandle();
+        if( hShareHandle )
+            curl_easy_setopt(hCurlHandle, CURLOPT_SHARE, hShareHandle);
+    }
+
     long option = CURLFTPMETHOD_SINGLECWD;
     curl_easy_setopt(hCurlHandle, CURLOPT_FTP_FILEMETHOD, option);
 
@@ -5085,6 +5813,29 @@ void VSICurlPartialClearCache(const char* pszFilenamePrefix)
         poFSHandler->PartialClearCache(pszFilenamePrefix);
 }
 
+//! @cond Doxygen_Suppress
+/************************************************************************/
+/*                  VSICurlGetRegionCacheMemoryUsage()                  */
+/************************************************************************/
+
+// Return the number of bytes held by the in-memory region caches of
+// /vsicurl/ and related file systems.
+GIntBig VSICurlGetRegionCacheMemoryUsage()
+{
+    GIntBig nTotal = 0;
+    const CPLStringList aosPrefixes(VSIFileManager::GetPrefixes());
+    for( int i = 0; i < aosPrefixes.size(); ++i )
+    {
+        auto poFSHandler =
+            dynamic_cast<cpl::VSICurlFilesystemHandler*>(
+                VSIFileManager::GetHandler( aosPrefixes[i] ));
+        if( poFSHandler )
+            nTotal += poFSHandler->GetRegionCacheMemoryUsage();
+    }
+    return nTotal;
+}
+//! @endcond
+
 /************************************************************************/
 /*                        VSINetworkStatsReset()                        */
 /************************************************************************/
@@ -5118,6 +5869,20 @@ void VSINetworkStatsReset( void )
  * Statistics can also be emitted on standard output at process termination if
  * the CPL_VSIL_SHOW_NETWORK_STATS configuration option is set to YES.
  *
+ * Starting with GDAL 3.4, each level of the report may also contain:
+ * <ul>
+ * <li>"retries": the number of retried requests, after a transient error.</li>
+ * <li>"region_cache": the number of hits and misses in the /vsicurl/ region
+ *     cache by read operations, and the hit ratio.</li>
+ * <li>"timings": the number of timed requests, the cumulated durations, in
+ *     seconds, of the name lookup, TCP connection, TLS handshake, of the wait
+ *     for the first byte of the response after the request has been sent
+ *     (server_time_s), of the transfer of the response body and of whole
+ *     requests, and a histogram of the time to first byte (measured from the
+ *     start of the request). Durations of the connection phases are zero for
+ *     requests reusing an existing connection.</li>
+ * </ul>
+ *
  * Example of output:
  * <pre>
  * {
@@ -40,7 +40,9 @@
 #include "cpl_mem_cache.h"
 
 #include "cpl_curl_priv.h"
+#include "cpl_worker_thread_pool.h"
 
+#include <condition_variable>
 #include <set>
 #include <map>
 #include <memory>
@@ -192,6 +194,18 @@ class VSICurlFilesystemHandler : public VSIFilesystemHandler
     std::unique_ptr<RegionCacheType> m_poRegionCacheDoNotUseDirectly{}; // do not access directly. Use GetRegionCache();
     RegionCacheType* GetRegionCache();
 
+    bool                m_bDiskCacheTrimmed = false;
+    GIntBig             m_nDiskCacheBytesWrittenSinceTrim = 0;
+    std::string         GetDiskCacheFilename( const char* pszURL,
+                                              vsi_l_offset nFileOffsetStart );
+    static std::shared_ptr<std::string> GetRegionFromDiskCache(
+                                        const std::string& osFilename );
+    void                AddRegionToDiskCache( const std::string& osFilename,
+                                              size_t nSize,
+                                              const char *pData );
+    static void         TrimDiskCache( const std::string& osDir,
+                                       GIntBig nMaxSize );
+
     lru11::Cache<std::string, FileProp>  oCacheFileProp;
 
     int                                       nCachedFilesInDirList = 0;
@@ -289,6 +303,7 @@ public:
 
     virtual void        ClearCache();
     virtual void        PartialClearCache(const char* pszFilename);
+    GIntBig             GetRegionCacheMemoryUsage();
 
 
     bool                GetCachedDirList( const char* pszURL,
@@ -300,6 +315,54 @@ public:
     virtual CPLString GetURLFromFilename( const CPLString& osFilename );
 };
 
+/************************************************************************/
+/*                      VSICurlAccessPatternTracker                     */
+/************************************************************************/
+
+// Classifies the region cache misses of a handle, to decide how many
+// chunks to download. Several sequential streams are tracked at once, so
+// that interleaved sequential reads at different places of a file (such as
+// a .shp read along with its index, or several tables of a GeoPackage) each
+// keep their growing read-ahead, whereas random or strided accesses only
+// download what is requested.
+class VSICurlAccessPatternTracker
+{
+  public:
+    enum class Pattern
+    {
+        SEQUENTIAL,
+        MULTI_STREAM,
+        STRIDED,
+        RANDOM
+    };
+
+    int     GetBlocksToDownload( vsi_l_offset nChunk, int nMaxBlocks );
+    void    SetDownloaded( vsi_l_offset nChunk, int nBlocks );
+    Pattern GetLastPattern() const { return m_eLastPattern; }
+    void    ReportStatistics( const char* pszDebugKey,
+                              const char* pszFilename,
+                              int nChunkSize ) const;
+
+  private:
+    static constexpr int knMAX_STREAMS = 4;
+
+    struct Stream
+    {
+        vsi_l_offset nNextChunk = VSI_L_OFFSET_MAX;
+        int          nBlocks = 1;
+        GUIntBig     nLastUse = 0;
+    };
+
+    Stream       m_asStreams[knMAX_STREAMS]{};
+    int          m_iCurStream = 0;
+    GUIntBig     m_nMisses = 0;
+    vsi_l_offset m_nLastMissChunk = VSI_L_OFFSET_MAX;
+    GIntBig      m_nLastStride = 0;
+    Pattern      m_eLastPattern = Pattern::RANDOM;
+    GUIntBig     m_anPatternCount[4] = {0, 0, 0, 0};
+    GUIntBig     m_nDownloadedBlocks = 0;
+};
+
 /************************************************************************/
 /*                           VSICurlHandle                              */
 /************************************************************************/
@@ -321,8 +384,7 @@ class VSICurlHandle : public VSIVirtualHandle
 
     char          **m_papszHTTPOptions = nullptr;
 
-    vsi_l_offset    lastDownloadedOffset = VSI_L_OFFSET_MAX;
-    int             nBlocksToDownload = 1;
+    VSICurlAccessPatternTracker m_oAccessPattern{};
 
     bool                bStopOnInterruptUntilUninstall = false;
     bool                bInterrupted = false;
@@ -346,6 +408,12 @@ class VSICurlHandle : public VSIVirtualHandle
     bool            bEOF = false;
 
     virtual std::string DownloadRegion(vsi_l_offset startOffset, int nBlocks);
+    bool                ReadFromRegionCache(void* pData,
+                                            vsi_l_offset nOffset,
+                                            size_t nSize);
+    std::string         DownloadRegionParallel(vsi_l_offset startOffset,
+                                               int nBlocks, int nParts);
+    bool                m_bInParallelDownload = false;
 
     bool                m_bUseHead = false;
     bool                m_bUseRedirectURLIfNoQueryStringParams = false;
@@ -380,6 +448,11 @@ class VSICurlHandle : public VSIVirtualHandle
     int ReadMultiRange( int nRanges, void ** ppData,
                         const vsi_l_offset* panOffsets,
                         const size_t* panSizes ) override;
+    int ReadAsync( int nRanges, void ** ppData,
+                   const vsi_l_offset* panOffsets,
+                   const size_t* panSizes,
+                   VSIReadAsyncCallback pfnCallback,
+                   void* pUserData ) override;
     size_t Write( const void *pBuffer, size_t nSize, size_t nMemb ) override;
     int Eof() override;
     int Flush() override;
@@ -410,6 +483,8 @@ class IVSIS3LikeFSHandler: public VSICurlFilesystemHandler
 {
     CPL_DISALLOW_COPY_ASSIGN(IVSIS3LikeFSHandler)
 
+    friend class VSIParallelPartUploader;
+
     bool CopyFile(VSILFILE* fpIn,
                      vsi_l_offset nSourceSize,
                      const char* pszSource,
@@ -521,6 +596,62 @@ class IVSIS3LikeHandle:  public VSICurlHandle
     ~IVSIS3LikeHandle() override {}
 };
 
+/************************************************************************/
+/*                        VSIParallelPartUploader                       */
+/************************************************************************/
+
+// Uploads the parts of a multipart upload in worker threads, so that the
+// writer can fill its next buffer meanwhile. At most m_nMaxInFlight parts
+// are uploaded at the same time, Submit() blocking until one completes,
+// which bounds memory usage to m_nMaxInFlight + 1 buffers.
+class VSIParallelPartUploader
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSIParallelPartUploader)
+
+    struct Job
+    {
+        VSIParallelPartUploader *poUploader = nullptr;
+        int                      nPartNumber = 0;
+        vsi_l_offset             nPosition = 0;
+        GByte                   *pabyBuffer = nullptr;
+        size_t                   nSize = 0;
+    };
+
+    IVSIS3LikeFSHandler    *m_poFS = nullptr;
+    CPLString               m_osFilename{};
+    CPLString               m_osUploadID{};
+    int                     m_nMaxRetry = 0;
+    double                  m_dfRetryDelay = 0.0;
+    int                     m_nMaxInFlight = 0;
+
+    std::mutex              m_oMutex{};
+    std::condition_variable m_oCV{};
+    int                     m_nInFlight = 0;
+    bool                    m_bError = false;
+    std::vector<CPLString>  m_aosEtags{};
+    std::vector<GByte*>     m_apabyFreeBuffers{};
+    std::unique_ptr<CPLWorkerThreadPool> m_poPool{};
+
+    static void JobFunc(void* pData);
+
+  public:
+    VSIParallelPartUploader( IVSIS3LikeFSHandler* poFS,
+                             const char* pszFilename,
+                             int nMaxRetry, double dfRetryDelay,
+                             int nMaxInFlight );
+    ~VSIParallelPartUploader();
+
+    static int GetMaxInFlight();
+
+    void SetUploadID( const CPLString& osUploadID )
+        { m_osUploadID = osUploadID; }
+    bool Submit( int nPartNumber, vsi_l_offset nPosition,
+                 GByte* pabyBuffer, size_t nSize );
+    GByte* AcquireBuffer( size_t nSize );
+    bool WaitAll();
+    const std::vector<CPLString>& GetETags() const { return m_aosEtags; }
+};
+
 /************************************************************************/
 /*                            VSIS3WriteHandle                          */
 /************************************************************************/
@@ -557,6 +688,8 @@ class VSIS3WriteHandle final : public VSIVirtualHandle
     double              m_dfRetryDelay = 0.0;
     WriteFuncStruct     m_sWriteFuncHeaderData{};
 
+    std::unique_ptr<VSIParallelPartUploader> m_poUploader{};
+
     bool                UploadPart();
     bool                DoSinglePartPUT();
 
@@ -671,6 +804,20 @@ class NetworkStatisticsLogger
         GIntBig nPUTUploadedBytes = 0;
         GIntBig nPOSTDownloadedBytes = 0;
         GIntBig nPOSTUploadedBytes = 0;
+        GIntBig nRetries = 0;
+        GIntBig nRegionCacheHits = 0;
+        GIntBig nRegionCacheMisses = 0;
+        // Cumulated durations of the phases of timed requests, in seconds.
+        GIntBig nTimedRequests = 0;
+        double  dfNameLookupTime = 0;
+        double  dfConnectTime = 0;
+        double  dfTLSHandshakeTime = 0;
+        double  dfServerTime = 0;
+        double  dfTransferTime = 0;
+        double  dfTotalTime = 0;
+        // Histogram of the time to first byte, with the upper bounds of
+        // kadfTTFBHistogramBounds in cpl_vsil_curl.cpp.
+        GIntBig anTimeToFirstByteHistogram[8] = {0, 0, 0, 0, 0, 0, 0, 0};
     };
 
     enum class ContextPathType
@@ -747,6 +894,12 @@ public:
 
     static void LogDELETE();
 
+    static void LogRetry();
+
+    static void LogRegionCacheAccess(bool bHit);
+
+    static void LogTimings(CURL* hCurlHandle);
+
     static void Reset();
 
     static CPLString GetReportAsSerializedJSON();
@@ -380,6 +380,7 @@ char** VSIGSFSHandler::GetFileMetadata( const char* pszFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -495,6 +496,7 @@ bool VSIGSFSHandler::SetFileMetadata( const char * pszFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -680,6 +682,7 @@ int* VSIGSFSHandler::UnlinkBatch( CSLConstList papszFiles )
                                     dfRetryDelay);
                         CPLSleep(dfRetryDelay);
                         dfRetryDelay = dfNewRetryDelay;
+                        NetworkStatisticsLogger::LogRetry();
                         nRetryCount++;
                         bRetry = true;
                     }
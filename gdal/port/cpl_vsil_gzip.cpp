@@ -69,6 +69,19 @@
    in a .gz.properties file, so that we don't need to seek at the end of the
    file each time a Stat() is done.
 
+   For .gz files, an on-disk index of "checkpoints" can also be built, in the
+   way of the zran.c example of zlib. A checkpoint records, at a deflate block
+   boundary, the position in the compressed stream (with a bit granularity),
+   and the last 32 KB of uncompressed data, which is enough to restart
+   decompression from it. The index is built in one pass the first time a
+   random seek is done, and saved so that later handles can reuse it.
+
+   Files made of several gzip members, such as BGZF files, can be
+   uncompressed in parallel when GDAL_NUM_THREADS is set. Once the end of a
+   first member is reached, the compressed data is split in chunks starting
+   at a member header, that are uncompressed ahead of the reader by worker
+   threads.
+
    For .zip and .gz, both reading and writing are supported, but just one mode
    at a time (read-only or write-only).
 */
@@ -98,6 +111,8 @@
 #endif
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
@@ -110,6 +125,7 @@
 #include "cpl_minizip_ioapi.h"
 #include "cpl_minizip_unzip.h"
 #include "cpl_multiproc.h"
+#include "cpl_sha256.h"
 #include "cpl_string.h"
 #include "cpl_time.h"
 #include "cpl_vsi_virtual.h"
@@ -153,6 +169,901 @@ typedef struct
     vsi_l_offset  out;
 } GZipSnapshot;
 
+/************************************************************************/
+/* ==================================================================== */
+/*                          VSIGZipIndex                                */
+/* ==================================================================== */
+/************************************************************************/
+
+constexpr int GZIP_INDEX_WINDOW_SIZE = 1 << MAX_WBITS;
+constexpr const char* GZIP_INDEX_MAGIC = "GDALGZIX";
+// Magic, compressed size, modification time of the base file,
+// uncompressed size and number of checkpoints.
+constexpr int GZIP_INDEX_HEADER_SIZE = 8 + 4 * 8;
+// Input offset, output offset, CRC32, number of bits, and then the window.
+constexpr int GZIP_INDEX_CHECKPOINT_HEADER_SIZE = 8 + 8 + 4 + 4;
+constexpr int GZIP_INDEX_CHECKPOINT_SIZE =
+    GZIP_INDEX_CHECKPOINT_HEADER_SIZE + GZIP_INDEX_WINDOW_SIZE;
+
+class VSIGZipIndex
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSIGZipIndex)
+
+  public:
+    struct Checkpoint
+    {
+        vsi_l_offset  nIn = 0;   // offset in base file of first unused byte
+        vsi_l_offset  nOut = 0;  // offset in uncompressed data
+        GUInt32       nCRC = 0;  // CRC32 of current gzip member up to nOut
+        int           nBits = 0; // unused bits in the byte before nIn
+    };
+
+    std::string             m_osFilename{};
+    bool                    m_bTemporary = false;
+    vsi_l_offset            m_nUncompressedSize = 0;
+    std::vector<Checkpoint> m_aoCheckpoints{};
+
+    VSIGZipIndex() = default;
+    ~VSIGZipIndex();
+
+    static std::shared_ptr<VSIGZipIndex> Load( const std::string& osFilename,
+                                               vsi_l_offset nCompressedSize,
+                                               GIntBig nMTime );
+    static std::shared_ptr<VSIGZipIndex> Build( VSILFILE* fp,
+                                                vsi_l_offset nCompressedSize,
+                                                GIntBig nMTime,
+                                                const std::string& osFilename,
+                                                bool bTemporary,
+                                                vsi_l_offset nInterval,
+                                                bool& bCannotCreate );
+
+    bool ReadWindow( size_t iCheckpoint, GByte* pabyWindow ) const;
+};
+
+/************************************************************************/
+/*                           ~VSIGZipIndex()                            */
+/************************************************************************/
+
+VSIGZipIndex::~VSIGZipIndex()
+{
+    if( m_bTemporary )
+        VSIUnlink(m_osFilename.c_str());
+}
+
+/************************************************************************/
+/*                                Load()                                */
+/************************************************************************/
+
+std::shared_ptr<VSIGZipIndex> VSIGZipIndex::Load(
+                                            const std::string& osFilename,
+                                            vsi_l_offset nCompressedSize,
+                                            GIntBig nMTime )
+{
+    VSILFILE* fp = VSIFOpenL(osFilename.c_str(), "rb");
+    if( fp == nullptr )
+        return nullptr;
+
+    GByte abyHeader[GZIP_INDEX_HEADER_SIZE];
+    bool bOK = VSIFReadL(abyHeader, 1, sizeof(abyHeader), fp) ==
+                                                        sizeof(abyHeader) &&
+               memcmp(abyHeader, GZIP_INDEX_MAGIC, 8) == 0;
+    GUInt64 anValues[4] = { 0, 0, 0, 0 };
+    if( bOK )
+    {
+        memcpy(anValues, abyHeader + 8, sizeof(anValues));
+        for( auto& nVal: anValues )
+            CPL_LSBPTR64(&nVal);
+        bOK = anValues[0] == nCompressedSize &&
+              static_cast<GIntBig>(anValues[1]) == nMTime;
+    }
+
+    auto poIndex = std::make_shared<VSIGZipIndex>();
+    poIndex->m_osFilename = osFilename;
+    poIndex->m_nUncompressedSize = anValues[2];
+    const GUInt64 nCount = anValues[3];
+    if( bOK && nCount > nCompressedSize / 2 )
+        bOK = false;
+    for( GUInt64 i = 0; bOK && i < nCount; ++i )
+    {
+        GByte abyCheckpoint[GZIP_INDEX_CHECKPOINT_HEADER_SIZE];
+        if( VSIFSeekL(fp, GZIP_INDEX_HEADER_SIZE +
+                            i * GZIP_INDEX_CHECKPOINT_SIZE, SEEK_SET) != 0 ||
+            VSIFReadL(abyCheckpoint, 1, sizeof(abyCheckpoint), fp) !=
+                                                        sizeof(abyCheckpoint) )
+        {
+            bOK = false;
+            break;
+        }
+        Checkpoint oCheckpoint;
+        GUInt64 nIn = 0;
+        GUInt64 nOut = 0;
+        GUInt32 nCRC = 0;
+        GUInt32 nBits = 0;
+        memcpy(&nIn, abyCheckpoint, 8);
+        memcpy(&nOut, abyCheckpoint + 8, 8);
+        memcpy(&nCRC, abyCheckpoint + 16, 4);
+        memcpy(&nBits, abyCheckpoint + 20, 4);
+        CPL_LSBPTR64(&nIn);
+        CPL_LSBPTR64(&nOut);
+        CPL_LSBPTR32(&nCRC);
+        CPL_LSBPTR32(&nBits);
+        if( nIn == 0 || nIn > nCompressedSize || nBits > 7 ||
+            nOut > poIndex->m_nUncompressedSize ||
+            (!poIndex->m_aoCheckpoints.empty() &&
+             nOut <= poIndex->m_aoCheckpoints.back().nOut) )
+        {
+            bOK = false;
+            break;
+        }
+        oCheckpoint.nIn = nIn;
+        oCheckpoint.nOut = nOut;
+        oCheckpoint.nCRC = nCRC;
+        oCheckpoint.nBits = static_cast<int>(nBits);
+        poIndex->m_aoCheckpoints.push_back(oCheckpoint);
+    }
+    CPL_IGNORE_RET_VAL(VSIFCloseL(fp));
+
+    if( !bOK )
+    {
+        CPLDebug("GZIP", "Ignoring invalid or outdated index %s",
+                 osFilename.c_str());
+        return nullptr;
+    }
+    return poIndex;
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/************************************************************************/
+
+// Uncompresses the whole (possibly multi-member) gzip file fp and writes an
+// index with a checkpoint at the first deflate block boundary after each
+// nInterval bytes of uncompressed data. bCannotCreate is set if the index
+// file cannot be created, as opposed to an error in the gzip stream.
+std::shared_ptr<VSIGZipIndex> VSIGZipIndex::Build(
+                                            VSILFILE* fp,
+                                            vsi_l_offset nCompressedSize,
+                                            GIntBig nMTime,
+                                            const std::string& osFilename,
+                                            bool bTemporary,
+                                            vsi_l_offset nInterval,
+                                            bool& bCannotCreate )
+{
+    bCannotCreate = false;
+    const std::string osTmpFilename(
+        bTemporary ? osFilename : osFilename + ".tmp");
+    VSILFILE* fpIndex = VSIFOpenL(osTmpFilename.c_str(), "wb");
+    if( fpIndex == nullptr )
+    {
+        bCannotCreate = true;
+        return nullptr;
+    }
+
+    CPLDebug("GZIP", "Building index %s", osFilename.c_str());
+    GByte abyHeader[GZIP_INDEX_HEADER_SIZE] = {};
+    bool bOK = VSIFWriteL(abyHeader, 1, sizeof(abyHeader), fpIndex) ==
+                                                            sizeof(abyHeader) &&
+               VSIFSeekL(fp, 0, SEEK_SET) == 0;
+
+    z_stream sStream;
+    memset(&sStream, 0, sizeof(sStream));
+    if( bOK && inflateInit2(&sStream, -MAX_WBITS) != Z_OK )
+    {
+        CPL_IGNORE_RET_VAL(VSIFCloseL(fpIndex));
+        VSIUnlink(osTmpFilename.c_str());
+        return nullptr;
+    }
+
+    std::vector<GByte> abyIn(Z_BUFSIZE);
+    std::vector<GByte> abyWindow(GZIP_INDEX_WINDOW_SIZE);
+    std::vector<GByte> abyCheckpoint(GZIP_INDEX_CHECKPOINT_SIZE);
+    vsi_l_offset nReadBytes = 0;
+
+    const auto FillInput = [&]()
+    {
+        if( sStream.avail_in == 0 )
+        {
+            const size_t nToRead = static_cast<size_t>(std::min(
+                static_cast<vsi_l_offset>(Z_BUFSIZE),
+                nCompressedSize - nReadBytes));
+            const size_t nRead = VSIFReadL(abyIn.data(), 1, nToRead, fp);
+            nReadBytes += nRead;
+            sStream.next_in = abyIn.data();
+            sStream.avail_in = static_cast<uInt>(nRead);
+        }
+        return sStream.avail_in != 0;
+    };
+    const auto GetByte = [&]()
+    {
+        if( !FillInput() )
+            return EOF;
+        sStream.avail_in--;
+        return static_cast<int>(*(sStream.next_in++));
+    };
+
+    auto poIndex = std::make_shared<VSIGZipIndex>();
+    poIndex->m_osFilename = osFilename;
+    poIndex->m_bTemporary = bTemporary;
+    vsi_l_offset nTotalOut = 0;
+    vsi_l_offset nLastCheckpointOut = 0;
+    sStream.next_out = abyWindow.data();
+    sStream.avail_out = GZIP_INDEX_WINDOW_SIZE;
+    while( bOK )
+    {
+        // Parse the header of the gzip member.
+        if( GetByte() != gz_magic[0] || GetByte() != gz_magic[1] ||
+            GetByte() != Z_DEFLATED )
+        {
+            bOK = false;
+            break;
+        }
+        const int nFlags = GetByte();
+        if( nFlags == EOF || (nFlags & RESERVED) != 0 )
+        {
+            bOK = false;
+            break;
+        }
+        for( int i = 0; i < 6; ++i )
+            CPL_IGNORE_RET_VAL(GetByte());
+        if( (nFlags & EXTRA_FIELD) != 0 )
+        {
+            int nLen = GetByte();
+            nLen += GetByte() << 8;
+            while( nLen > 0 && GetByte() != EOF )
+                --nLen;
+        }
+        if( (nFlags & ORIG_NAME) != 0 )
+        {
+            int c;
+            while( (c = GetByte()) != 0 && c != EOF ) {}
+        }
+        if( (nFlags & COMMENT) != 0 )
+        {
+            int c;
+            while( (c = GetByte()) != 0 && c != EOF ) {}
+        }
+        if( (nFlags & HEAD_CRC) != 0 )
+        {
+            CPL_IGNORE_RET_VAL(GetByte());
+            CPL_IGNORE_RET_VAL(GetByte());
+        }
+
+        // Uncompress it, a deflate block at a time.
+        inflateReset(&sStream);
+        uLong nCRC = crc32(0, nullptr, 0);
+        while( true )
+        {
+            if( !FillInput() )
+            {
+                bOK = false;
+                break;
+            }
+            if( sStream.avail_out == 0 )
+            {
+                sStream.next_out = abyWindow.data();
+                sStream.avail_out = GZIP_INDEX_WINDOW_SIZE;
+            }
+            Bytef* pabyStart = sStream.next_out;
+            const int nRet = inflate(&sStream, Z_BLOCK);
+            const uInt nProduced =
+                static_cast<uInt>(sStream.next_out - pabyStart);
+            nCRC = crc32(nCRC, pabyStart, nProduced);
+            nTotalOut += nProduced;
+            if( nRet == Z_STREAM_END )
+                break;
+            if( nRet != Z_OK && nRet != Z_BUF_ERROR )
+            {
+                bOK = false;
+                break;
+            }
+
+            // At the end of a block that is not the last one of the member?
+            if( (sStream.data_type & 128) != 0 &&
+                (sStream.data_type & 64) == 0 &&
+                nTotalOut - nLastCheckpointOut >= nInterval )
+            {
+                Checkpoint oCheckpoint;
+                oCheckpoint.nIn = nReadBytes - sStream.avail_in;
+                oCheckpoint.nOut = nTotalOut;
+                oCheckpoint.nCRC = static_cast<GUInt32>(nCRC);
+                oCheckpoint.nBits = sStream.data_type & 7;
+
+                GUInt64 nIn = oCheckpoint.nIn;
+                GUInt64 nOut = oCheckpoint.nOut;
+                GUInt32 nCRC32 = oCheckpoint.nCRC;
+                GUInt32 nBits = static_cast<GUInt32>(oCheckpoint.nBits);
+                CPL_LSBPTR64(&nIn);
+                CPL_LSBPTR64(&nOut);
+                CPL_LSBPTR32(&nCRC32);
+                CPL_LSBPTR32(&nBits);
+                memcpy(&abyCheckpoint[0], &nIn, 8);
+                memcpy(&abyCheckpoint[8], &nOut, 8);
+                memcpy(&abyCheckpoint[16], &nCRC32, 4);
+                memcpy(&abyCheckpoint[20], &nBits, 4);
+                // abyWindow is a circular buffer, whose oldest byte is
+                // at next_out.
+                const uInt nLeft = sStream.avail_out;
+                GByte* pabyDst =
+                    &abyCheckpoint[GZIP_INDEX_CHECKPOINT_HEADER_SIZE];
+                memcpy(pabyDst,
+                       abyWindow.data() + GZIP_INDEX_WINDOW_SIZE - nLeft,
+                       nLeft);
+                memcpy(pabyDst + nLeft, abyWindow.data(),
+                       GZIP_INDEX_WINDOW_SIZE - nLeft);
+                if( VSIFWriteL(abyCheckpoint.data(), 1,
+                               abyCheckpoint.size(), fpIndex) !=
+                                                        abyCheckpoint.size() )
+                {
+                    bOK = false;
+                    break;
+                }
+                poIndex->m_aoCheckpoints.push_back(oCheckpoint);
+                nLastCheckpointOut = nTotalOut;
+            }
+        }
+        if( !bOK )
+            break;
+
+        // Check the CRC of the member, and skip its size.
+        uLong nReadCRC = 0;
+        for( int i = 0; i < 4; ++i )
+        {
+            const int c = GetByte();
+            if( c == EOF )
+            {
+                bOK = false;
+                break;
+            }
+            nReadCRC |= static_cast<uLong>(c) << (8 * i);
+        }
+        if( !bOK || nReadCRC != nCRC )
+        {
+            CPLDebug("GZIP", "CRC error while building index");
+            bOK = false;
+            break;
+        }
+        for( int i = 0; i < 4; ++i )
+            CPL_IGNORE_RET_VAL(GetByte());
+
+        if( !FillInput() )
+            break;
+    }
+    inflateEnd(&sStream);
+
+    if( bOK )
+    {
+        poIndex->m_nUncompressedSize = nTotalOut;
+        GUInt64 anValues[4] = {
+            nCompressedSize, static_cast<GUInt64>(nMTime), nTotalOut,
+            static_cast<GUInt64>(poIndex->m_aoCheckpoints.size()) };
+        for( auto& nVal: anValues )
+            CPL_LSBPTR64(&nVal);
+        memcpy(abyHeader, GZIP_INDEX_MAGIC, 8);
+        memcpy(abyHeader + 8, anValues, sizeof(anValues));
+        bOK = VSIFSeekL(fpIndex, 0, SEEK_SET) == 0 &&
+              VSIFWriteL(abyHeader, 1, sizeof(abyHeader), fpIndex) ==
+                                                            sizeof(abyHeader);
+    }
+    bOK = VSIFCloseL(fpIndex) == 0 && bOK;
+    if( bOK && !bTemporary &&
+        VSIRename(osTmpFilename.c_str(), osFilename.c_str()) != 0 )
+    {
+        bCannotCreate = true;
+        bOK = false;
+    }
+    if( !bOK )
+    {
+        VSIUnlink(osTmpFilename.c_str());
+        // Do not unlink again in the destructor.
+        poIndex->m_bTemporary = false;
+        return nullptr;
+    }
+    return poIndex;
+}
+
+/************************************************************************/
+/*                             ReadWindow()                             */
+/************************************************************************/
+
+bool VSIGZipIndex::ReadWindow( size_t iCheckpoint, GByte* pabyWindow ) const
+{
+    VSILFILE* fp = VSIFOpenL(m_osFilename.c_str(), "rb");
+    if( fp == nullptr )
+        return false;
+    const bool bOK =
+        VSIFSeekL(fp, GZIP_INDEX_HEADER_SIZE +
+                        static_cast<vsi_l_offset>(iCheckpoint) *
+                            GZIP_INDEX_CHECKPOINT_SIZE +
+                        GZIP_INDEX_CHECKPOINT_HEADER_SIZE, SEEK_SET) == 0 &&
+        VSIFReadL(pabyWindow, 1, GZIP_INDEX_WINDOW_SIZE, fp) ==
+                                                    GZIP_INDEX_WINDOW_SIZE;
+    CPL_IGNORE_RET_VAL(VSIFCloseL(fp));
+    return bOK;
+}
+
+/************************************************************************/
+/*                        VSIGZipGetNumThreads()                        */
+/************************************************************************/
+
+// Returns the number of threads set with GDAL_NUM_THREADS, or 1.
+static int VSIGZipGetNumThreads()
+{
+    const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
+    if( pszThreads == nullptr )
+        return 1;
+    int nThreads = 0;
+    if( EQUAL(pszThreads, "ALL_CPUS") )
+        nThreads = CPLGetNumCPUs();
+    else
+        nThreads = atoi(pszThreads);
+    return std::max(1, std::min(128, nThreads));
+}
+
+/************************************************************************/
+/*                        VSIGZipGetChunkSize()                         */
+/************************************************************************/
+
+// Returns the size of the chunks of data processed by each job of the
+// multi-threaded compression and decompression.
+static size_t VSIGZipGetChunkSize()
+{
+    const char* pszChunkSize = CPLGetConfigOption
+        ("CPL_VSIL_DEFLATE_CHUNK_SIZE", "1024K");
+    size_t nChunkSize = static_cast<size_t>(atoi(pszChunkSize));
+    if( strchr(pszChunkSize, 'K') )
+        nChunkSize *= 1024;
+    else if( strchr(pszChunkSize, 'M') )
+        nChunkSize *= 1024 * 1024;
+    return std::max(static_cast<size_t>(32 * 1024),
+                    std::min(static_cast<size_t>(UINT_MAX), nChunkSize));
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                       VSIGZipParallelReader                          */
+/* ==================================================================== */
+/************************************************************************/
+
+// Uncompresses a sequence of gzip members in worker threads. The compressed
+// data is read by the consumer thread and split in segments of about the
+// chunk size, each starting at what looks like a gzip header. A segment is
+// only valid if it is made of whole members, which validates the start of
+// the next one. As soon as a segment cannot be uncompressed, or no header is
+// found, Read() stops at its start, which is a member boundary, so that the
+// caller can go on with serial decompression. The start of members of the
+// segments read, which can be used to restart decompression, is appended to
+// the vector provided by the caller.
+class VSIGZipParallelReader
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSIGZipParallelReader)
+
+    struct Segment
+    {
+        VSIGZipParallelReader* poParent = nullptr;
+        vsi_l_offset       nInStart = 0;
+        std::vector<GByte> abyIn{};
+        std::vector<GByte> abyOut{};
+        // Offsets in abyIn and abyOut of some member starts.
+        std::vector<std::pair<size_t, size_t>> anMembers{};
+        bool               bDone = false;
+        bool               bOK = false;
+    };
+
+    VSILFILE          *m_fp = nullptr;
+    vsi_l_offset       m_nEnd = 0;
+    int                m_nThreads = 0;
+    size_t             m_nChunkSize = 0;
+    std::unique_ptr<CPLWorkerThreadPool> m_poPool{};
+    std::mutex         m_oMutex{};
+    std::condition_variable m_oCV{};
+    std::deque<std::unique_ptr<Segment>> m_apoSegments{};
+    size_t             m_nPosInSegment = 0;
+    vsi_l_offset       m_nOut = 0;
+    std::vector<std::pair<vsi_l_offset, vsi_l_offset>>& m_anSegmentStarts;
+    vsi_l_offset       m_nNextIn = 0;    // start of the next segment
+    std::vector<GByte> m_abyPending{};   // data read from m_nNextIn
+    bool               m_bPlanningDone = false;
+    bool               m_bStop = false;
+
+    static void Decompress( void* pData );
+    void ScheduleSegments();
+
+  public:
+    VSIGZipParallelReader( VSILFILE* fp, vsi_l_offset nStart,
+                           vsi_l_offset nEnd, vsi_l_offset nOut,
+                           int nThreads, size_t nChunkSize,
+                           std::vector<std::pair<vsi_l_offset, vsi_l_offset>>&
+                                                            anSegmentStarts );
+    ~VSIGZipParallelReader();
+
+    bool   Init();
+    size_t Read( GByte* pabyBuffer, size_t nLen );
+    void   GetCurrentSegmentStart( vsi_l_offset& nIn, size_t& nPos ) const;
+};
+
+/************************************************************************/
+/*                       VSIGZipIsLikelyHeader()                        */
+/************************************************************************/
+
+// Checks the 10 first bytes of a gzip member header. The XFL and OS bytes
+// make it unlikely to match in the middle of deflate data.
+static bool VSIGZipIsLikelyHeader( const GByte* pabyData )
+{
+    return pabyData[0] == gz_magic[0] && pabyData[1] == gz_magic[1] &&
+           pabyData[2] == Z_DEFLATED && (pabyData[3] & RESERVED) == 0 &&
+           (pabyData[8] == 0 || pabyData[8] == 2 || pabyData[8] == 4) &&
+           (pabyData[9] <= 13 || pabyData[9] == 255);
+}
+
+/************************************************************************/
+/*                         VSIGZipSkipHeader()                          */
+/************************************************************************/
+
+static bool VSIGZipSkipHeader( const GByte* pabyData, size_t nSize,
+                               size_t& nPos )
+{
+    if( nSize - nPos < 10 || !VSIGZipIsLikelyHeader(pabyData + nPos) )
+        return false;
+    const int nFlags = pabyData[nPos + 3];
+    nPos += 10;
+    if( (nFlags & EXTRA_FIELD) != 0 )
+    {
+        if( nSize - nPos < 2 )
+            return false;
+        const size_t nLen = pabyData[nPos] | (pabyData[nPos + 1] << 8);
+        nPos += 2;
+        if( nSize - nPos < nLen )
+            return false;
+        nPos += nLen;
+    }
+    for( const int nFlag: { ORIG_NAME, COMMENT } )
+    {
+        if( (nFlags & nFlag) != 0 )
+        {
+            const GByte* pabyEnd = static_cast<const GByte*>(
+                memchr(pabyData + nPos, 0, nSize - nPos));
+            if( pabyEnd == nullptr )
+                return false;
+            nPos = (pabyEnd - pabyData) + 1;
+        }
+    }
+    if( (nFlags & HEAD_CRC) != 0 )
+    {
+        if( nSize - nPos < 2 )
+            return false;
+        nPos += 2;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                       VSIGZipParallelReader()                        */
+/************************************************************************/
+
+VSIGZipParallelReader::VSIGZipParallelReader(
+            VSILFILE* fp, vsi_l_offset nStart, vsi_l_offset nEnd,
+            vsi_l_offset nOut, int nThreads, size_t nChunkSize,
+            std::vector<std::pair<vsi_l_offset, vsi_l_offset>>&
+                                                        anSegmentStarts ) :
+    m_fp(fp),
+    m_nEnd(nEnd),
+    m_nThreads(nThreads),
+    // Segments may grow up to 4 times the chunk size.
+    m_nChunkSize(std::min(nChunkSize, static_cast<size_t>(UINT_MAX / 8))),
+    m_nOut(nOut),
+    m_anSegmentStarts(anSegmentStarts),
+    m_nNextIn(nStart)
+{
+}
+
+/************************************************************************/
+/*                      ~VSIGZipParallelReader()                        */
+/************************************************************************/
+
+VSIGZipParallelReader::~VSIGZipParallelReader()
+{
+    if( m_poPool )
+    {
+        // Skip the segments whose decompression has not started yet.
+        {
+            std::lock_guard<std::mutex> oLock(m_oMutex);
+            m_bStop = true;
+        }
+        m_poPool->WaitCompletion();
+    }
+}
+
+/************************************************************************/
+/*                                Init()                                */
+/************************************************************************/
+
+bool VSIGZipParallelReader::Init()
+{
+    m_poPool.reset(new CPLWorkerThreadPool());
+    if( !m_poPool->Setup(m_nThreads, nullptr, nullptr, false) )
+    {
+        m_poPool.reset();
+        return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                             Decompress()                             */
+/************************************************************************/
+
+void VSIGZipParallelReader::Decompress( void* pData )
+{
+    Segment* psSegment = static_cast<Segment*>(pData);
+    {
+        std::lock_guard<std::mutex> oLock(psSegment->poParent->m_oMutex);
+        if( psSegment->poParent->m_bStop )
+            return;
+    }
+    const GByte* pabyIn = psSegment->abyIn.data();
+    const size_t nInSize = psSegment->abyIn.size();
+    // Beyond that, rather let the consumer uncompress the data itself than
+    // use too much memory.
+    const size_t nMaxOutSize =
+        static_cast<size_t>(32) * psSegment->poParent->m_nChunkSize;
+    std::vector<GByte>& abyOut = psSegment->abyOut;
+    size_t nOutSize = 0;
+
+    z_stream sStream;
+    memset(&sStream, 0, sizeof(sStream));
+    bool bOK = inflateInit2(&sStream, -MAX_WBITS) == Z_OK;
+    const bool bInitOK = bOK;
+    size_t nPos = 0;
+    while( bOK && nPos < nInSize )
+    {
+        const size_t nMemberHeader = nPos;
+        if( !VSIGZipSkipHeader(pabyIn, nInSize, nPos) )
+        {
+            bOK = false;
+            break;
+        }
+        if( psSegment->anMembers.empty() ||
+            nOutSize - psSegment->anMembers.back().second >= Z_BUFSIZE )
+        {
+            psSegment->anMembers.emplace_back(nMemberHeader, nOutSize);
+        }
+        inflateReset(&sStream);
+        sStream.next_in = const_cast<Bytef*>(pabyIn + nPos);
+        sStream.avail_in = static_cast<uInt>(nInSize - nPos);
+        const size_t nMemberStart = nOutSize;
+        int nRet = Z_OK;
+        while( nRet == Z_OK )
+        {
+            if( nOutSize == abyOut.size() )
+            {
+                if( abyOut.size() >= nMaxOutSize )
+                    break;
+                abyOut.resize(std::min(nMaxOutSize,
+                    std::max(static_cast<size_t>(Z_BUFSIZE),
+                             abyOut.size() * 2)));
+            }
+            sStream.next_out = abyOut.data() + nOutSize;
+            sStream.avail_out = static_cast<uInt>(std::min(
+                abyOut.size() - nOutSize, static_cast<size_t>(UINT_MAX)));
+            nRet = inflate(&sStream, Z_NO_FLUSH);
+            nOutSize = sStream.next_out - abyOut.data();
+        }
+        nPos = sStream.next_in - pabyIn;
+        if( nRet != Z_STREAM_END || nInSize - nPos < 8 )
+        {
+            bOK = false;
+            break;
+        }
+
+        // Check the CRC32 and the size of the member.
+        uLong nCRC = crc32(0, nullptr, 0);
+        for( size_t i = nMemberStart; i < nOutSize; )
+        {
+            const uInt nCount = static_cast<uInt>(
+                std::min(nOutSize - i, static_cast<size_t>(UINT_MAX)));
+            nCRC = crc32(nCRC, abyOut.data() + i, nCount);
+            i += nCount;
+        }
+        GUInt32 nReadCRC = 0;
+        GUInt32 nReadSize = 0;
+        memcpy(&nReadCRC, pabyIn + nPos, 4);
+        memcpy(&nReadSize, pabyIn + nPos + 4, 4);
+        CPL_LSBPTR32(&nReadCRC);
+        CPL_LSBPTR32(&nReadSize);
+        nPos += 8;
+        if( nReadCRC != static_cast<GUInt32>(nCRC) ||
+            nReadSize != static_cast<GUInt32>(nOutSize - nMemberStart) )
+        {
+            bOK = false;
+        }
+    }
+    if( bInitOK )
+        inflateEnd(&sStream);
+    abyOut.resize(bOK ? nOutSize : 0);
+    abyOut.shrink_to_fit();
+    {
+        std::vector<GByte>().swap(psSegment->abyIn);
+    }
+
+    VSIGZipParallelReader* poParent = psSegment->poParent;
+    {
+        std::lock_guard<std::mutex> oLock(poParent->m_oMutex);
+        psSegment->bOK = bOK;
+        psSegment->bDone = true;
+    }
+    poParent->m_oCV.notify_all();
+}
+
+/************************************************************************/
+/*                          ScheduleSegments()                          */
+/************************************************************************/
+
+void VSIGZipParallelReader::ScheduleSegments()
+{
+    while( !m_bPlanningDone &&
+           m_apoSegments.size() < static_cast<size_t>(2 * m_nThreads) )
+    {
+        // Find the first header after the chunk size.
+        size_t nSearchFrom = m_nChunkSize;
+        size_t nBoundary = 0;
+        bool bFound = false;
+        while( !bFound )
+        {
+            for( size_t i = nSearchFrom; i + 10 <= m_abyPending.size(); ++i )
+            {
+                const GByte* pabyCandidate = static_cast<const GByte*>(
+                    memchr(m_abyPending.data() + i, gz_magic[0],
+                           m_abyPending.size() - 9 - i));
+                if( pabyCandidate == nullptr )
+                    break;
+                i = pabyCandidate - m_abyPending.data();
+                if( VSIGZipIsLikelyHeader(pabyCandidate) )
+                {
+                    nBoundary = i;
+                    bFound = true;
+                    break;
+                }
+            }
+            if( bFound )
+                break;
+            if( m_abyPending.size() > nSearchFrom + 9 )
+                nSearchFrom = m_abyPending.size() - 9;
+
+            const vsi_l_offset nReadPos = m_nNextIn + m_abyPending.size();
+            if( nReadPos >= m_nEnd )
+            {
+                // The last segment goes up to the end of the file.
+                nBoundary = m_abyPending.size();
+                bFound = true;
+                m_bPlanningDone = true;
+                break;
+            }
+            if( m_abyPending.size() >= 4 * m_nChunkSize )
+            {
+                // Members are too large, or there is no member anymore.
+                m_bPlanningDone = true;
+                return;
+            }
+
+            const size_t nOldSize = m_abyPending.size();
+            const size_t nToRead = static_cast<size_t>(std::min(
+                static_cast<vsi_l_offset>(m_nChunkSize), m_nEnd - nReadPos));
+            m_abyPending.resize(nOldSize + nToRead);
+            const size_t nRead =
+                VSIFSeekL(m_fp, nReadPos, SEEK_SET) == 0 ?
+                    VSIFReadL(m_abyPending.data() + nOldSize, 1, nToRead,
+                              m_fp) : 0;
+            m_abyPending.resize(nOldSize + nRead);
+            if( nRead == 0 )
+            {
+                // Let serial decompression report the error.
+                m_bPlanningDone = true;
+                return;
+            }
+        }
+        if( nBoundary == 0 )
+        {
+            m_bPlanningDone = true;
+            return;
+        }
+
+        std::unique_ptr<Segment> psSegment(new Segment());
+        psSegment->poParent = this;
+        psSegment->nInStart = m_nNextIn;
+        psSegment->abyIn.assign(m_abyPending.begin(),
+                                m_abyPending.begin() + nBoundary);
+        m_abyPending.erase(m_abyPending.begin(),
+                           m_abyPending.begin() + nBoundary);
+        m_nNextIn += nBoundary;
+        if( !m_poPool->SubmitJob(Decompress, psSegment.get()) )
+        {
+            m_bPlanningDone = true;
+            return;
+        }
+        m_apoSegments.push_back(std::move(psSegment));
+    }
+}
+
+/************************************************************************/
+/*                                Read()                                */
+/************************************************************************/
+
+// Returns less than nLen bytes at the end of the data, or when the caller
+// must go on with serial decompression from GetCurrentSegmentStart().
+size_t VSIGZipParallelReader::Read( GByte* pabyBuffer, size_t nLen )
+{
+    size_t nDone = 0;
+    while( nDone < nLen )
+    {
+        ScheduleSegments();
+        if( m_apoSegments.empty() )
+            break;
+
+        Segment* psSegment = m_apoSegments.front().get();
+        {
+            std::unique_lock<std::mutex> oLock(m_oMutex);
+            while( !psSegment->bDone )
+                m_oCV.wait(oLock);
+        }
+        if( !psSegment->bOK )
+            break;
+
+        if( m_nPosInSegment == 0 )
+        {
+            for( const auto& oMember: psSegment->anMembers )
+            {
+                const vsi_l_offset nOut = m_nOut + oMember.second;
+                if( m_anSegmentStarts.empty() ||
+                    m_anSegmentStarts.back().second < nOut )
+                {
+                    m_anSegmentStarts.emplace_back(
+                        psSegment->nInStart + oMember.first, nOut);
+                }
+            }
+        }
+        const size_t nToCopy = std::min(
+            nLen - nDone, psSegment->abyOut.size() - m_nPosInSegment);
+        memcpy(pabyBuffer + nDone,
+               psSegment->abyOut.data() + m_nPosInSegment, nToCopy);
+        nDone += nToCopy;
+        m_nOut += nToCopy;
+        m_nPosInSegment += nToCopy;
+        if( m_nPosInSegment == psSegment->abyOut.size() )
+        {
+            m_apoSegments.pop_front();
+            m_nPosInSegment = 0;
+        }
+    }
+    return nDone;
+}
+
+/************************************************************************/
+/*                       GetCurrentSegmentStart()                       */
+/************************************************************************/
+
+// Returns the offset of the member at which the current segment starts,
+// and the number of uncompressed bytes already read from it.
+void VSIGZipParallelReader::GetCurrentSegmentStart( vsi_l_offset& nIn,
+                                                    size_t& nPos ) const
+{
+    if( m_apoSegments.empty() )
+    {
+        nIn = m_nNextIn;
+        nPos = 0;
+    }
+    else
+    {
+        nIn = m_apoSegments.front()->nInStart;
+        nPos = m_nPosInSegment;
+    }
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                       VSIGZipHandle                                  */
+/* ==================================================================== */
+/************************************************************************/
+
 class VSIGZipHandle final : public VSIVirtualHandle
 {
     VSIVirtualHandle* m_poBaseHandle = nullptr;
@@ -183,7 +1094,25 @@ class VSIGZipHandle final : public VSIVirtualHandle
     GZipSnapshot* snapshots = nullptr;
     vsi_l_offset snapshot_byte_interval = 0; /* number of compressed bytes at which we create a "snapshot" */
 
+    bool          m_bUseIndex = false;
+    bool          m_bIndexTried = false;
+    vsi_l_offset  m_nIndexInterval = 0;
+    std::shared_ptr<VSIGZipIndex> m_poIndex{};
+
+    int           m_nThreads = 1;
+    size_t        m_nParallelChunkSize = 0;
+    vsi_l_offset  m_nMinOutForParallelRead = 0;
+    std::unique_ptr<VSIGZipParallelReader> m_poParallelReader{};
+    // Offsets in base file and in uncompressed data of members found by
+    // parallel decompression, from where serial decompression can restart.
+    std::vector<std::pair<vsi_l_offset, vsi_l_offset>> m_anMemberStarts{};
+
     void check_header();
+    bool EnsureIndex();
+    bool RestoreFromIndex( vsi_l_offset nOffset );
+    void StartParallelRead( vsi_l_offset nMemberStart );
+    void StopParallelRead();
+    void ResumeSerialRead( vsi_l_offset nIn, vsi_l_offset nOut );
     int get_byte();
     bool gzseek( vsi_l_offset nOffset, int nWhence );
     int gzrewind ();
@@ -289,6 +1218,9 @@ VSIGZipHandle* VSIGZipHandle::Duplicate()
     }
 
     poHandle->m_nLastReadOffset = m_nLastReadOffset;
+    poHandle->m_bIndexTried = m_bIndexTried;
+    poHandle->m_poIndex = m_poIndex;
+    poHandle->m_anMemberStarts = m_anMemberStarts;
 
     // Most important: duplicate the snapshots!
 
@@ -393,6 +1325,28 @@ VSIGZipHandle::VSIGZipHandle( VSIVirtualHandle* poBaseHandle,
     if( offset == 0 ) check_header();  // Skip the .gz header.
     startOff = VSIFTellL(reinterpret_cast<VSILFILE*>(poBaseHandle)) - stream.avail_in;
 
+    // The index and parallel decompression are only available for /vsigzip/
+    // files, not for the members of a .zip.
+    if( pszBaseFileName != nullptr && offset == 0 && transparent == 0 )
+    {
+        m_nThreads = VSIGZipGetNumThreads();
+        if( m_nThreads > 1 )
+            m_nParallelChunkSize = VSIGZipGetChunkSize();
+    }
+    m_bUseIndex =
+        pszBaseFileName != nullptr && offset == 0 && transparent == 0 &&
+        CPLTestBool(CPLGetConfigOption("CPL_VSIL_GZIP_INDEX",
+            CPLGetConfigOption("CPL_VSIL_GZIP_INDEX_DIR", nullptr) ?
+                                                                "YES" : "NO"));
+    if( m_bUseIndex )
+    {
+        m_nIndexInterval = std::max(
+            static_cast<vsi_l_offset>(Z_BUFSIZE),
+            static_cast<vsi_l_offset>(CPLScanUIntBig(
+                CPLGetConfigOption("CPL_VSIL_GZIP_INDEX_INTERVAL", "1048576"),
+                40)));
+    }
+
     if( transparent == 0 )
     {
         snapshot_byte_interval = std::max(
@@ -622,6 +1576,218 @@ int VSIGZipHandle::gzrewind ()
     return VSIFSeekL(reinterpret_cast<VSILFILE*>(m_poBaseHandle), startOff, SEEK_SET);
 }
 
+/************************************************************************/
+/*                            EnsureIndex()                             */
+/************************************************************************/
+
+// Loads the checkpoint index of the file, or builds it if it does not exist
+// or is outdated. The index is stored in CPL_VSIL_GZIP_INDEX_DIR if set,
+// otherwise as a .gz.gzidx file next to local files, or in /vsimem/ for the
+// life time of the handle (and its duplicates) if it cannot be written.
+bool VSIGZipHandle::EnsureIndex()
+{
+    if( m_bIndexTried )
+        return m_poIndex != nullptr;
+    m_bIndexTried = true;
+
+    VSIStatBufL sStat;
+    const GIntBig nMTime =
+        VSIStatL(m_pszBaseFileName, &sStat) == 0 ?
+            static_cast<GIntBig>(sStat.st_mtime) : 0;
+
+    std::string osFilename;
+    bool bTemporary = false;
+    const char* pszDir =
+        CPLGetConfigOption("CPL_VSIL_GZIP_INDEX_DIR", nullptr);
+    if( pszDir != nullptr && pszDir[0] != '\0' )
+    {
+        GByte abyHash[CPL_SHA256_HASH_SIZE];
+        CPL_SHA256(m_pszBaseFileName, strlen(m_pszBaseFileName), abyHash);
+        char* pszHex = CPLBinaryToHex(CPL_SHA256_HASH_SIZE, abyHash);
+        osFilename = CPLFormFilename(pszDir, pszHex, "gzidx");
+        CPLFree(pszHex);
+    }
+    else if( !STARTS_WITH_CI(m_pszBaseFileName, "/vsi") ||
+             STARTS_WITH_CI(m_pszBaseFileName, "/vsimem/") )
+    {
+        osFilename = std::string(m_pszBaseFileName) + ".gzidx";
+    }
+    else
+    {
+        osFilename = CPLSPrintf("/vsimem/vsigzip_index_%p.gzidx", this);
+        bTemporary = true;
+    }
+
+    if( !bTemporary )
+        m_poIndex = VSIGZipIndex::Load(osFilename, m_compressed_size, nMTime);
+    if( m_poIndex == nullptr )
+    {
+        if( pszDir != nullptr && pszDir[0] != '\0' )
+            VSIMkdir(pszDir, 0755);
+        VSILFILE* fp = reinterpret_cast<VSILFILE*>(m_poBaseHandle);
+        const vsi_l_offset nPos = VSIFTellL(fp);
+        bool bCannotCreate = false;
+        m_poIndex = VSIGZipIndex::Build(fp, m_compressed_size, nMTime,
+                                        osFilename, bTemporary,
+                                        m_nIndexInterval, bCannotCreate);
+        if( m_poIndex == nullptr && bCannotCreate && !bTemporary )
+        {
+            CPLDebug("GZIP", "Cannot create %s. Using a temporary index",
+                     osFilename.c_str());
+            osFilename = CPLSPrintf("/vsimem/vsigzip_index_%p.gzidx", this);
+            m_poIndex = VSIGZipIndex::Build(fp, m_compressed_size, nMTime,
+                                            osFilename, true,
+                                            m_nIndexInterval, bCannotCreate);
+        }
+        if( VSIFSeekL(fp, nPos, SEEK_SET) != 0 )
+            CPLError(CE_Failure, CPLE_FileIO, "Seek() failed");
+    }
+
+    if( m_poIndex && m_uncompressed_size == 0 )
+        m_uncompressed_size = m_poIndex->m_nUncompressedSize;
+    return m_poIndex != nullptr;
+}
+
+/************************************************************************/
+/*                          RestoreFromIndex()                          */
+/************************************************************************/
+
+// Restarts decompression from the last checkpoint of the index before
+// nOffset, if that saves decompressing more than an index interval.
+bool VSIGZipHandle::RestoreFromIndex( vsi_l_offset nOffset )
+{
+    if( !m_bUseIndex || m_transparent ||
+        (nOffset >= out && nOffset - out < m_nIndexInterval) ||
+        !EnsureIndex() )
+    {
+        return false;
+    }
+
+    const auto& aoCheckpoints = m_poIndex->m_aoCheckpoints;
+    auto oIter = std::upper_bound(
+        aoCheckpoints.begin(), aoCheckpoints.end(), nOffset,
+        [](vsi_l_offset nVal, const VSIGZipIndex::Checkpoint& oCheckpoint)
+        { return nVal < oCheckpoint.nOut; });
+    if( oIter == aoCheckpoints.begin() )
+        return false;
+    --oIter;
+    // Going on from the current position, or from an in-memory snapshot,
+    // is cheaper.
+    if( nOffset >= out && oIter->nOut <= out )
+        return false;
+    for( unsigned int i = 0;
+         i < m_compressed_size / snapshot_byte_interval + 1;
+         i++ )
+    {
+        if( snapshots[i].posInBaseHandle == 0 )
+            continue;
+        if( snapshots[i].out > nOffset )
+            break;
+        if( snapshots[i].out >= oIter->nOut )
+            return false;
+    }
+
+    std::vector<GByte> abyWindow(GZIP_INDEX_WINDOW_SIZE);
+    if( !m_poIndex->ReadWindow(oIter - aoCheckpoints.begin(),
+                               abyWindow.data()) )
+        return false;
+
+    VSILFILE* fp = reinterpret_cast<VSILFILE*>(m_poBaseHandle);
+    GByte byPrevious = 0;
+    if( VSIFSeekL(fp, oIter->nIn - (oIter->nBits ? 1 : 0), SEEK_SET) != 0 ||
+        (oIter->nBits && VSIFReadL(&byPrevious, 1, 1, fp) != 1) ||
+        inflateReset(&stream) != Z_OK ||
+        (oIter->nBits &&
+         inflatePrime(&stream, oIter->nBits,
+                      byPrevious >> (8 - oIter->nBits)) != Z_OK) ||
+        inflateSetDictionary(&stream, abyWindow.data(),
+                             GZIP_INDEX_WINDOW_SIZE) != Z_OK )
+    {
+        // Leave the stream in a consistent state.
+        CPL_IGNORE_RET_VAL(gzrewind());
+        return false;
+    }
+
+#ifdef ENABLE_DEBUG
+    CPLDebug("GZIP", "Using index checkpoint at out=" CPL_FRMT_GUIB
+             " for offset=" CPL_FRMT_GUIB, oIter->nOut, nOffset);
+#endif
+    z_err = Z_OK;
+    z_eof = 0;
+    stream.avail_in = 0;
+    stream.next_in = inbuf;
+    crc = oIter->nCRC;
+    in = oIter->nIn - startOff;
+    out = oIter->nOut;
+    return true;
+}
+
+/************************************************************************/
+/*                         StartParallelRead()                          */
+/************************************************************************/
+
+// Called when the start of a new member is reached by serial decompression.
+void VSIGZipHandle::StartParallelRead( vsi_l_offset nMemberStart )
+{
+    m_poParallelReader.reset(new VSIGZipParallelReader(
+        reinterpret_cast<VSILFILE*>(m_poBaseHandle), nMemberStart,
+        offsetEndCompressedData, out, m_nThreads, m_nParallelChunkSize,
+        m_anMemberStarts));
+    if( !m_poParallelReader->Init() )
+    {
+        // Do not retry at each member.
+        m_poParallelReader.reset();
+        m_nThreads = 1;
+        return;
+    }
+    CPLDebug("GZIP", "Multi-member file: using %d threads for decompression",
+             m_nThreads);
+}
+
+/************************************************************************/
+/*                          StopParallelRead()                          */
+/************************************************************************/
+
+void VSIGZipHandle::StopParallelRead()
+{
+    vsi_l_offset nIn = 0;
+    size_t nPos = 0;
+    m_poParallelReader->GetCurrentSegmentStart(nIn, nPos);
+    m_poParallelReader.reset();
+    ResumeSerialRead(nIn, out - nPos);
+}
+
+/************************************************************************/
+/*                          ResumeSerialRead()                          */
+/************************************************************************/
+
+// Sets the state of serial decompression at the start of the member at nIn
+// of the base file, corresponding to nOut in the uncompressed data.
+void VSIGZipHandle::ResumeSerialRead( vsi_l_offset nIn, vsi_l_offset nOut )
+{
+    z_eof = 0;
+    stream.avail_in = 0;
+    stream.next_in = inbuf;
+    crc = 0;
+    in = nIn - startOff;
+    out = nOut;
+    if( nIn >= offsetEndCompressedData )
+    {
+        z_err = Z_STREAM_END;
+        return;
+    }
+    if( VSIFSeekL(reinterpret_cast<VSILFILE*>(m_poBaseHandle),
+                  nIn, SEEK_SET) != 0 )
+    {
+        z_err = Z_ERRNO;
+        return;
+    }
+    z_err = Z_OK;
+    check_header();
+    if( z_err == Z_OK )
+        inflateReset(&stream);
+}
+
 /************************************************************************/
 /*                              Seek()                                  */
 /************************************************************************/
@@ -699,8 +1865,15 @@ bool VSIGZipHandle::gzseek( vsi_l_offset offset, int whence )
     }
 
     // whence == SEEK_END is unsuppored in original gzseek.
+    if( m_poParallelReader && whence == SEEK_END )
+        StopParallelRead();
+
     if( whence == SEEK_END )
     {
+        // Building the index gives the uncompressed size in a single pass.
+        if( offset == 0 && m_uncompressed_size == 0 && m_bUseIndex )
+            CPL_IGNORE_RET_VAL(EnsureIndex());
+
         // If we known the uncompressed size, we can fake a jump to
         // the end of the stream.
         if( offset == 0 && m_uncompressed_size != 0 )
@@ -733,6 +1906,26 @@ bool VSIGZipHandle::gzseek( vsi_l_offset offset, int whence )
         offset += out;
     }
 
+    // Parallel decompression uncompresses data well ahead of the reader, so
+    // after a seek (other than a rewind), only start it once a few chunks
+    // have been read sequentially.
+    m_nMinOutForParallelRead =
+        offset + std::min(offset, static_cast<vsi_l_offset>(
+                    4 * static_cast<vsi_l_offset>(m_nParallelChunkSize)));
+
+    // Go on with parallel decompression for forward seeks, unless the index
+    // can be used.
+    if( m_poParallelReader &&
+        (offset < out ||
+         (m_bUseIndex && offset - out >= m_nIndexInterval)) )
+    {
+        StopParallelRead();
+    }
+
+    // Jump to the closest checkpoint before the target, if there is an index.
+    if( !m_poParallelReader )
+        CPL_IGNORE_RET_VAL(RestoreFromIndex(offset));
+
     // For a negative seek, rewind and use positive seek.
     if( offset >= out )
     {
@@ -750,42 +1943,70 @@ bool VSIGZipHandle::gzseek( vsi_l_offset offset, int whence )
         return false;
     }
 
+    // Find the last snapshot before the target. Snapshots may be sparse if
+    // decompression has been restarted from a checkpoint of the index.
+    unsigned int iBest = 0;
+    bool bHasBest = false;
     for( unsigned int i = 0;
+         !m_poParallelReader &&
          i < m_compressed_size / snapshot_byte_interval + 1;
          i++ )
     {
         if( snapshots[i].posInBaseHandle == 0 )
-            break;
-        if( snapshots[i].out <= out + offset &&
-            (i == m_compressed_size / snapshot_byte_interval ||
-             snapshots[i+1].out == 0 || snapshots[i+1].out > out+offset) )
         {
-            if( out >= snapshots[i].out )
-                break;
-
+            if( m_poIndex )
+                continue;
+            break;
+        }
+        if( snapshots[i].out > out + offset )
+            break;
+        iBest = i;
+        bHasBest = true;
+    }
+    if( bHasBest && out < snapshots[iBest].out )
+    {
+        const unsigned int i = iBest;
 #ifdef ENABLE_DEBUG
-            CPLDebug(
-                "SNAPSHOT", "using snapshot %d : "
-                "posInBaseHandle(snapshot)=" CPL_FRMT_GUIB
-                " in(snapshot)=" CPL_FRMT_GUIB
-                " out(snapshot)=" CPL_FRMT_GUIB
-                " out=" CPL_FRMT_GUIB
-                " offset=" CPL_FRMT_GUIB,
-                i, snapshots[i].posInBaseHandle, snapshots[i].in,
-                snapshots[i].out, out, offset);
+        CPLDebug(
+            "SNAPSHOT", "using snapshot %d : "
+            "posInBaseHandle(snapshot)=" CPL_FRMT_GUIB
+            " in(snapshot)=" CPL_FRMT_GUIB
+            " out(snapshot)=" CPL_FRMT_GUIB
+            " out=" CPL_FRMT_GUIB
+            " offset=" CPL_FRMT_GUIB,
+            i, snapshots[i].posInBaseHandle, snapshots[i].in,
+            snapshots[i].out, out, offset);
 #endif
-            offset = out + offset - snapshots[i].out;
-            if( VSIFSeekL(reinterpret_cast<VSILFILE*>(m_poBaseHandle),
-                          snapshots[i].posInBaseHandle, SEEK_SET) != 0 )
-                CPLError(CE_Failure, CPLE_FileIO, "Seek() failed");
-
-            inflateEnd(&stream);
-            inflateCopy(&stream, &snapshots[i].stream);
-            crc = snapshots[i].crc;
-            m_transparent = snapshots[i].transparent;
-            in = snapshots[i].in;
-            out = snapshots[i].out;
-            break;
+        offset = out + offset - snapshots[i].out;
+        if( VSIFSeekL(reinterpret_cast<VSILFILE*>(m_poBaseHandle),
+                      snapshots[i].posInBaseHandle, SEEK_SET) != 0 )
+            CPLError(CE_Failure, CPLE_FileIO, "Seek() failed");
+
+        inflateEnd(&stream);
+        inflateCopy(&stream, &snapshots[i].stream);
+        crc = snapshots[i].crc;
+        m_transparent = snapshots[i].transparent;
+        in = snapshots[i].in;
+        out = snapshots[i].out;
+    }
+
+    // Members found by parallel decompression are restart points too.
+    if( !m_poParallelReader && !m_anMemberStarts.empty() )
+    {
+        const vsi_l_offset nTarget = out + offset;
+        auto oIter = std::upper_bound(
+            m_anMemberStarts.begin(), m_anMemberStarts.end(), nTarget,
+            [](vsi_l_offset nVal,
+               const std::pair<vsi_l_offset, vsi_l_offset>& oMember)
+            { return nVal < oMember.second; });
+        if( oIter != m_anMemberStarts.begin() )
+        {
+            --oIter;
+            if( oIter->second > out )
+            {
+                ResumeSerialRead(oIter->first, oIter->second);
+                offset = nTarget - out;
+            }
         }
     }
 
@@ -897,6 +2118,23 @@ size_t VSIGZipHandle::Read( void * const buf, size_t const nSize,
              static_cast<int>(nMemb));
 #endif
 
+    if( m_poParallelReader )
+    {
+        const size_t nLen = nSize * nMemb;
+        size_t nRead =
+            m_poParallelReader->Read(static_cast<GByte*>(buf), nLen);
+        out += nRead;
+        if( nRead < nLen )
+        {
+            // End of file, or go on with serial decompression.
+            StopParallelRead();
+            if( z_err == Z_OK )
+                nRead += Read(static_cast<GByte*>(buf) + nRead, 1,
+                              nLen - nRead);
+        }
+        return nRead / nSize;
+    }
+
     if( (z_eof && in == 0) || z_err == Z_STREAM_END )
     {
         z_eof = 1;
@@ -1083,6 +2321,9 @@ size_t VSIGZipHandle::Read( void * const buf, size_t const nSize,
                 else
                 {
                     CPL_IGNORE_RET_VAL(getLong());
+                    const vsi_l_offset nMemberStart =
+                        VSIFTellL(reinterpret_cast<VSILFILE*>(m_poBaseHandle)) -
+                        stream.avail_in;
                     // The uncompressed length returned by above getlong() may
                     // be different from out in case of concatenated .gz files.
                     // Check for such files:
@@ -1091,16 +2332,24 @@ size_t VSIGZipHandle::Read( void * const buf, size_t const nSize,
                     {
                         inflateReset(& (stream));
                         crc = 0;
+                        if( m_nThreads > 1 && out >= m_nMinOutForParallelRead )
+                            StartParallelRead(nMemberStart);
                     }
                 }
             }
         }
-        if( z_err != Z_OK || z_eof )
+        if( z_err != Z_OK || z_eof || m_poParallelReader )
             break;
     }
     crc = crc32(crc, pStart, static_cast<uInt>(stream.next_out - pStart));
 
     size_t ret = (len - stream.avail_out) / nSize;
+    if( m_poParallelReader && stream.avail_out != 0 )
+    {
+        const size_t nDone = len - stream.avail_out;
+        ret = (nDone + Read(static_cast<GByte*>(buf) + nDone, 1,
+                            stream.avail_out)) / nSize;
+    }
     if( z_err != Z_OK && z_err != Z_STREAM_END )
     {
         z_eof = 1;
@@ -1261,15 +2510,7 @@ VSIGZipWriteHandleMT::VSIGZipWriteHandleMT(  VSIVirtualHandle* poBaseHandle,
     bAutoCloseBaseHandle_(bAutoCloseBaseHandleIn),
     nThreads_(nThreads)
 {
-    const char* pszChunkSize = CPLGetConfigOption
-        ("CPL_VSIL_DEFLATE_CHUNK_SIZE", "1024K");
-    nChunkSize_ = static_cast<size_t>(atoi(pszChunkSize));
-    if( strchr(pszChunkSize, 'K') )
-        nChunkSize_ *= 1024;
-    else if( strchr(pszChunkSize, 'M') )
-        nChunkSize_ *= 1024 * 1024;
-    nChunkSize_ = std::max(static_cast<size_t>(32 * 1024),
-                    std::min(static_cast<size_t>(UINT_MAX), nChunkSize_));
+    nChunkSize_ = VSIGZipGetChunkSize();
 
     for( int i = 0; i < 1 + nThreads_; i++ )
         aposBuffers_.emplace_back( new std::string() );
@@ -1863,23 +3104,14 @@ VSIVirtualHandle* VSICreateGZipWritable( VSIVirtualHandle* poBaseHandle,
                                          int nDeflateTypeIn,
                                          int bAutoCloseBaseHandle )
 {
-    const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", nullptr);
-    if( pszThreads )
+    const int nThreads = VSIGZipGetNumThreads();
+    if( nThreads > 1 )
     {
-        int nThreads = 0;
-        if( EQUAL(pszThreads, "ALL_CPUS") )
-            nThreads = CPLGetNumCPUs();
-        else
-            nThreads = atoi(pszThreads);
-        nThreads = std::max(1, std::min(128, nThreads));
-        if( nThreads > 1 )
-        {
-            // coverity[tainted_data]
-            return new VSIGZipWriteHandleMT( poBaseHandle,
-                                                nThreads,
-                                                nDeflateTypeIn,
-                                                CPL_TO_BOOL(bAutoCloseBaseHandle) );
-        }
+        // coverity[tainted_data]
+        return new VSIGZipWriteHandleMT( poBaseHandle,
+                                            nThreads,
+                                            nDeflateTypeIn,
+                                            CPL_TO_BOOL(bAutoCloseBaseHandle) );
     }
     return new VSIGZipWriteHandle( poBaseHandle,
                                    nDeflateTypeIn,
@@ -2420,10 +3652,21 @@ const char* VSIGZipFilesystemHandler::GetOptions()
     return
     "<Options>"
     "  <Option name='GDAL_NUM_THREADS' type='string' "
-        "description='Number of threads for compression. Either a integer or ALL_CPUS'/>"
+        "description='Number of threads for compression, and decompression "
+        "of multi-member files. Either a integer or ALL_CPUS'/>"
     "  <Option name='CPL_VSIL_DEFLATE_CHUNK_SIZE' type='string' "
-        "description='Chunk of uncompressed data for parallelization. "
+        "description='Chunk of uncompressed data for parallelization "
+        "(of compressed data for decompression). "
         "Use K(ilobytes) or M(egabytes) suffix' default='1M'/>"
+    "  <Option name='CPL_VSIL_GZIP_INDEX' type='boolean' "
+        "description='Whether to build and use an index of checkpoints for "
+        "random access' default='NO'/>"
+    "  <Option name='CPL_VSIL_GZIP_INDEX_DIR' type='string' "
+        "description='Directory where to store indexes. Implies "
+        "CPL_VSIL_GZIP_INDEX=YES'/>"
+    "  <Option name='CPL_VSIL_GZIP_INDEX_INTERVAL' type='int' "
+        "description='Number of uncompressed bytes between checkpoints' "
+        "default='1048576'/>"
     "</Options>";
 }
 
@@ -3099,10 +4342,21 @@ const char* VSIZipFilesystemHandler::GetOptions()
     return
     "<Options>"
     "  <Option name='GDAL_NUM_THREADS' type='string' "
-        "description='Number of threads for compression. Either a integer or ALL_CPUS'/>"
+        "description='Number of threads for compression, and decompression "
+        "of multi-member files. Either a integer or ALL_CPUS'/>"
     "  <Option name='CPL_VSIL_DEFLATE_CHUNK_SIZE' type='string' "
-        "description='Chunk of uncompressed data for parallelization. "
+        "description='Chunk of uncompressed data for parallelization "
+        "(of compressed data for decompression). "
         "Use K(ilobytes) or M(egabytes) suffix' default='1M'/>"
+    "  <Option name='CPL_VSIL_GZIP_INDEX' type='boolean' "
+        "description='Whether to build and use an index of checkpoints for "
+        "random access' default='NO'/>"
+    "  <Option name='CPL_VSIL_GZIP_INDEX_DIR' type='string' "
+        "description='Directory where to store indexes. Implies "
+        "CPL_VSIL_GZIP_INDEX=YES'/>"
+    "  <Option name='CPL_VSIL_GZIP_INDEX_INTERVAL' type='int' "
+        "description='Number of uncompressed bytes between checkpoints' "
+        "default='1048576'/>"
     "</Options>";
 }
 
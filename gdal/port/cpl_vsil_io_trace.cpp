@@ -0,0 +1,931 @@
+/******************************************************************************
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Recording and replay of the I/O pattern of VSI file accesses
+ *
+ ******************************************************************************
+ * Copyright (c) 2021, GDAL project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+// The trace is a text file, with a header line and one line per call:
+//
+// O <time> <duration> <handle_id> <success> <access> <filename>
+// R <time> <duration> <handle_id> <offset> <requested_bytes> <read_bytes>
+// M <time> <duration> <handle_id> <return> <offset>:<size>[,<offset>:<size>]*
+// A <time> <duration> <handle_id> <return> <offset>:<size>[,<offset>:<size>]*
+// S <time> <duration> <flags> <return> <filename>
+// C <time> <duration> <handle_id>
+//
+// Times and durations are in microseconds, times being relative to the start
+// of the recording. M is ReadMultiRange() and A is ReadAsync(), for which the
+// duration is the one of the submission. The filename is the end of the line.
+
+#include "cpl_port.h"
+#include "cpl_vsi_virtual.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+
+CPL_CVSID("$Id$")
+
+constexpr const char* TRACE_HEADER = "# GDAL VSI I/O trace v1";
+constexpr size_t FLUSH_THRESHOLD = 65536;
+
+//! @cond Doxygen_Suppress
+
+namespace {
+
+enum
+{
+    STATE_UNINIT = -1,
+    STATE_DISABLED = 0,
+    STATE_ENABLED = 1
+};
+
+} // namespace
+
+static std::atomic<int> gnState{STATE_UNINIT};
+static std::atomic<GUInt64> gnNextHandleId{1};
+
+// Protects the following variables.
+static std::mutex goMutex;
+static VSILFILE* gfpTrace = nullptr;
+static std::string gosTraceFilename;
+static std::string gosBuffer;
+static std::string gosPrefix;
+static double gdfSampling = 1.0;
+static std::chrono::steady_clock::time_point goStartTime;
+
+/************************************************************************/
+/*                               Now()                                  */
+/************************************************************************/
+
+// Microseconds since the start of the recording.
+static GIntBig Now()
+{
+    return static_cast<GIntBig>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - goStartTime).count());
+}
+
+/************************************************************************/
+/*                           FlushLocked()                              */
+/************************************************************************/
+
+static void FlushLocked()
+{
+    if( gfpTrace && !gosBuffer.empty() )
+    {
+        VSIFWriteL(gosBuffer.data(), 1, gosBuffer.size(), gfpTrace);
+        gosBuffer.clear();
+    }
+}
+
+/************************************************************************/
+/*                             Record()                                 */
+/************************************************************************/
+
+static void Record( const std::string& osLine )
+{
+    std::lock_guard<std::mutex> oLock(goMutex);
+    // Recording may have been stopped since the call started.
+    if( gnState.load() != STATE_ENABLED )
+        return;
+    gosBuffer += osLine;
+    gosBuffer += '\n';
+    if( gosBuffer.size() >= FLUSH_THRESHOLD )
+        FlushLocked();
+}
+
+/************************************************************************/
+/*                          ShouldRecord()                              */
+/************************************************************************/
+
+// Whether calls on a file are recorded. Sampling is done per file, with a
+// hash of its name, so that all the calls on a sampled file are recorded,
+// consistently between runs.
+static bool ShouldRecord( const char* pszFilename )
+{
+    // Filenames are at the end of the lines.
+    if( strchr(pszFilename, '\n') != nullptr )
+        return false;
+    std::lock_guard<std::mutex> oLock(goMutex);
+    if( gosTraceFilename == pszFilename )
+        return false;
+    if( !gosPrefix.empty() &&
+        strncmp(pszFilename, gosPrefix.c_str(), gosPrefix.size()) != 0 )
+        return false;
+    if( gdfSampling >= 1.0 )
+        return true;
+    // FNV-1a
+    GUInt32 nHash = 2166136261U;
+    for( const char* pszIter = pszFilename; *pszIter; ++pszIter )
+    {
+        nHash ^= static_cast<GByte>(*pszIter);
+        nHash *= 16777619U;
+    }
+    return (nHash % 1000000U) < gdfSampling * 1000000;
+}
+
+/************************************************************************/
+/*                          FormatRanges()                              */
+/************************************************************************/
+
+static std::string FormatRanges( int nRanges, const vsi_l_offset* panOffsets,
+                                 const size_t* panSizes )
+{
+    std::string osRanges;
+    for( int i = 0; i < nRanges; ++i )
+    {
+        if( i > 0 )
+            osRanges += ',';
+        osRanges += CPLSPrintf(CPL_FRMT_GUIB ":" CPL_FRMT_GUIB,
+                               static_cast<GUIntBig>(panOffsets[i]),
+                               static_cast<GUIntBig>(panSizes[i]));
+    }
+    return osRanges;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          VSIIOTraceHandle                            */
+/* ==================================================================== */
+/************************************************************************/
+
+class VSIIOTraceHandle final : public VSIVirtualHandle
+{
+    CPL_DISALLOW_COPY_ASSIGN(VSIIOTraceHandle)
+
+    VSIVirtualHandle* m_poBaseHandle = nullptr;
+    GUInt64           m_nId = 0;
+
+  public:
+    VSIIOTraceHandle( VSIVirtualHandle* poBaseHandle, GUInt64 nId ):
+        m_poBaseHandle(poBaseHandle), m_nId(nId) {}
+    ~VSIIOTraceHandle() override;
+
+    int Seek( vsi_l_offset nOffset, int nWhence ) override
+        { return m_poBaseHandle->Seek(nOffset, nWhence); }
+    vsi_l_offset Tell() override { return m_poBaseHandle->Tell(); }
+    size_t Read( void *pBuffer, size_t nSize, size_t nCount ) override;
+    int ReadMultiRange( int nRanges, void ** ppData,
+                        const vsi_l_offset* panOffsets,
+                        const size_t* panSizes ) override;
+    int ReadAsync( int nRanges, void ** ppData,
+                   const vsi_l_offset* panOffsets,
+                   const size_t* panSizes,
+                   VSIReadAsyncCallback pfnCallback,
+                   void* pUserData ) override;
+    void WaitAsync() override { m_poBaseHandle->WaitAsync(); }
+    size_t Write( const void *pBuffer, size_t nSize, size_t nCount ) override
+        { return m_poBaseHandle->Write(pBuffer, nSize, nCount); }
+    int Eof() override { return m_poBaseHandle->Eof(); }
+    int Flush() override { return m_poBaseHandle->Flush(); }
+    int Close() override;
+    int Truncate( vsi_l_offset nNewSize ) override
+        { return m_poBaseHandle->Truncate(nNewSize); }
+    void *GetNativeFileDescriptor() override
+        { return m_poBaseHandle->GetNativeFileDescriptor(); }
+    VSIRangeStatus GetRangeStatus( vsi_l_offset nOffset,
+                                   vsi_l_offset nLength ) override
+        { return m_poBaseHandle->GetRangeStatus(nOffset, nLength); }
+};
+
+VSIIOTraceHandle::~VSIIOTraceHandle()
+{
+    VSIIOTraceHandle::Close();
+}
+
+size_t VSIIOTraceHandle::Read( void *pBuffer, size_t nSize, size_t nCount )
+{
+    const vsi_l_offset nOffset = m_poBaseHandle->Tell();
+    const GIntBig nStart = Now();
+    const size_t nRet = m_poBaseHandle->Read(pBuffer, nSize, nCount);
+    const GIntBig nEnd = Now();
+    Record(CPLSPrintf("R " CPL_FRMT_GIB " " CPL_FRMT_GIB " " CPL_FRMT_GUIB
+                      " " CPL_FRMT_GUIB " " CPL_FRMT_GUIB " " CPL_FRMT_GUIB,
+                      nStart, nEnd - nStart,
+                      static_cast<GUIntBig>(m_nId),
+                      static_cast<GUIntBig>(nOffset),
+                      static_cast<GUIntBig>(nSize * nCount),
+                      static_cast<GUIntBig>(nSize * nRet)));
+    return nRet;
+}
+
+int VSIIOTraceHandle::ReadMultiRange( int nRanges, void ** ppData,
+                                      const vsi_l_offset* panOffsets,
+                                      const size_t* panSizes )
+{
+    const GIntBig nStart = Now();
+    const int nRet = m_poBaseHandle->ReadMultiRange(nRanges, ppData,
+                                                    panOffsets, panSizes);
+    const GIntBig nEnd = Now();
+    Record(std::string(CPLSPrintf("M " CPL_FRMT_GIB " " CPL_FRMT_GIB " "
+                                  CPL_FRMT_GUIB " %d ",
+                                  nStart, nEnd - nStart,
+                                  static_cast<GUIntBig>(m_nId), nRet)) +
+           FormatRanges(nRanges, panOffsets, panSizes));
+    return nRet;
+}
+
+int VSIIOTraceHandle::ReadAsync( int nRanges, void ** ppData,
+                                 const vsi_l_offset* panOffsets,
+                                 const size_t* panSizes,
+                                 VSIReadAsyncCallback pfnCallback,
+                                 void* pUserData )
+{
+    const GIntBig nStart = Now();
+    const int nRet = m_poBaseHandle->ReadAsync(nRanges, ppData,
+                                               panOffsets, panSizes,
+                                               pfnCallback, pUserData);
+    const GIntBig nEnd = Now();
+    Record(std::string(CPLSPrintf("A " CPL_FRMT_GIB " " CPL_FRMT_GIB " "
+                                  CPL_FRMT_GUIB " %d ",
+                                  nStart, nEnd - nStart,
+                                  static_cast<GUIntBig>(m_nId), nRet)) +
+           FormatRanges(nRanges, panOffsets, panSizes));
+    return nRet;
+}
+
+int VSIIOTraceHandle::Close()
+{
+    if( m_poBaseHandle == nullptr )
+        return 0;
+    const GIntBig nStart = Now();
+    const int nRet = m_poBaseHandle->Close();
+    delete m_poBaseHandle;
+    m_poBaseHandle = nullptr;
+    const GIntBig nEnd = Now();
+    Record(CPLSPrintf("C " CPL_FRMT_GIB " " CPL_FRMT_GIB " " CPL_FRMT_GUIB,
+                      nStart, nEnd - nStart, static_cast<GUIntBig>(m_nId)));
+    return nRet;
+}
+
+/************************************************************************/
+/*                           StartLocked()                              */
+/************************************************************************/
+
+static bool StartLocked( const char* pszTraceFilename,
+                         CSLConstList papszOptions )
+{
+    // Disabled while the trace file is opened, so that the opening is not
+    // recorded, and does not try to take the mutex again.
+    gnState = STATE_DISABLED;
+
+    const double dfSampling =
+        CPLAtof(CSLFetchNameValueDef(papszOptions, "SAMPLING", "1"));
+    if( !(dfSampling > 0 && dfSampling <= 1) )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "SAMPLING should be in ]0,1] range");
+        return false;
+    }
+
+    gfpTrace = VSIFOpenL(pszTraceFilename, "wb");
+    if( gfpTrace == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_FileIO, "Cannot create %s",
+                 pszTraceFilename);
+        return false;
+    }
+    gosTraceFilename = pszTraceFilename;
+    gosPrefix = CSLFetchNameValueDef(papszOptions, "PREFIX", "");
+    gdfSampling = dfSampling;
+    gosBuffer = TRACE_HEADER;
+    gosBuffer += '\n';
+    goStartTime = std::chrono::steady_clock::now();
+    gnState.store(STATE_ENABLED, std::memory_order_release);
+    return true;
+}
+
+/************************************************************************/
+/*                            StopLocked()                              */
+/************************************************************************/
+
+static bool StopLocked()
+{
+    gnState = STATE_DISABLED;
+    if( gfpTrace == nullptr )
+        return true;
+    FlushLocked();
+    const bool bRet = VSIFCloseL(gfpTrace) == 0;
+    gfpTrace = nullptr;
+    gosTraceFilename.clear();
+    return bRet;
+}
+
+/************************************************************************/
+/*                        VSIIOTraceIsEnabled()                         */
+/************************************************************************/
+
+// On the first call, recording is started if the CPL_VSIL_IO_TRACE_FILE
+// configuration option is set.
+bool VSIIOTraceIsEnabled()
+{
+    const int nState = gnState.load(std::memory_order_acquire);
+    if( nState != STATE_UNINIT )
+        return nState == STATE_ENABLED;
+
+    std::lock_guard<std::mutex> oLock(goMutex);
+    if( gnState.load() == STATE_UNINIT )
+    {
+        const char* pszFilename =
+            CPLGetConfigOption("CPL_VSIL_IO_TRACE_FILE", nullptr);
+        if( pszFilename == nullptr || pszFilename[0] == '\0' )
+        {
+            gnState = STATE_DISABLED;
+        }
+        else
+        {
+            CPLStringList aosOptions;
+            aosOptions.SetNameValue("SAMPLING",
+                CPLGetConfigOption("CPL_VSIL_IO_TRACE_SAMPLING", nullptr));
+            aosOptions.SetNameValue("PREFIX",
+                CPLGetConfigOption("CPL_VSIL_IO_TRACE_PREFIX", nullptr));
+            // Copy as opening the trace file may invalidate pszFilename
+            StartLocked(std::string(pszFilename).c_str(), aosOptions.List());
+        }
+    }
+    return gnState.load() == STATE_ENABLED;
+}
+
+/************************************************************************/
+/*                          VSIIOTraceOpen()                            */
+/************************************************************************/
+
+// Called by VSIFOpenEx2L() when recording is enabled.
+VSIVirtualHandle* VSIIOTraceOpen( VSIFilesystemHandler* poFSHandler,
+                                  const char* pszFilename,
+                                  const char* pszAccess, bool bSetError,
+                                  CSLConstList papszOptions )
+{
+    // Only read-only accesses are recorded, so that replaying a trace
+    // never modifies files.
+    const bool bReadOnly = strchr(pszAccess, 'r') != nullptr &&
+                           strchr(pszAccess, '+') == nullptr;
+    if( !bReadOnly || !ShouldRecord(pszFilename) )
+        return poFSHandler->Open(pszFilename, pszAccess, bSetError,
+                                 papszOptions);
+
+    const GIntBig nStart = Now();
+    VSIVirtualHandle* poHandle =
+        poFSHandler->Open(pszFilename, pszAccess, bSetError, papszOptions);
+    const GIntBig nEnd = Now();
+    const GUInt64 nId = poHandle ? gnNextHandleId++ : 0;
+    Record(CPLSPrintf("O " CPL_FRMT_GIB " " CPL_FRMT_GIB " " CPL_FRMT_GUIB
+                      " %d %s %s",
+                      nStart, nEnd - nStart, static_cast<GUIntBig>(nId),
+                      poHandle ? 1 : 0, pszAccess, pszFilename));
+    if( poHandle == nullptr )
+        return nullptr;
+    return new VSIIOTraceHandle(poHandle, nId);
+}
+
+/************************************************************************/
+/*                          VSIIOTraceStat()                            */
+/************************************************************************/
+
+// Called by VSIStatExL() when recording is enabled.
+int VSIIOTraceStat( VSIFilesystemHandler* poFSHandler,
+                    const char* pszFilename, VSIStatBufL* psStatBuf,
+                    int nFlags )
+{
+    if( !ShouldRecord(pszFilename) )
+        return poFSHandler->Stat(pszFilename, psStatBuf, nFlags);
+
+    const GIntBig nStart = Now();
+    const int nRet = poFSHandler->Stat(pszFilename, psStatBuf, nFlags);
+    const GIntBig nEnd = Now();
+    Record(CPLSPrintf("S " CPL_FRMT_GIB " " CPL_FRMT_GIB " %d %d %s",
+                      nStart, nEnd - nStart, nFlags, nRet, pszFilename));
+    return nRet;
+}
+
+/************************************************************************/
+/*                 VSIIOTraceFileConfigOptionChanged()                  */
+/************************************************************************/
+
+// Called by CPLSetConfigOption() when CPL_VSIL_IO_TRACE_FILE is set, so
+// that "--config CPL_VSIL_IO_TRACE_FILE trace.txt" works even if files have
+// already been opened.
+void VSIIOTraceFileConfigOptionChanged( const char* pszValue )
+{
+    if( pszValue != nullptr && pszValue[0] != '\0' )
+    {
+        if( gnState.load() != STATE_ENABLED )
+        {
+            CPLStringList aosOptions;
+            aosOptions.SetNameValue("SAMPLING",
+                CPLGetConfigOption("CPL_VSIL_IO_TRACE_SAMPLING", nullptr));
+            aosOptions.SetNameValue("PREFIX",
+                CPLGetConfigOption("CPL_VSIL_IO_TRACE_PREFIX", nullptr));
+            VSIIOTraceStart(pszValue, aosOptions.List());
+        }
+    }
+    else if( gnState.load() == STATE_ENABLED )
+    {
+        VSIIOTraceStop();
+    }
+}
+
+//! @endcond
+
+/************************************************************************/
+/*                          VSIIOTraceStart()                           */
+/************************************************************************/
+
+/**
+ * \brief Starts recording the I/O pattern of VSI file accesses.
+ *
+ * The opening, read, multi-range read and closing of files opened in
+ * read-only mode, and the VSIStatL() calls, are written to the trace file
+ * with their offsets, sizes and durations, so that VSIIOTraceReplay() can
+ * re-issue them later, possibly against another storage.
+ *
+ * Recording is also started by setting the CPL_VSIL_IO_TRACE_FILE
+ * configuration option, with the CPL_VSIL_IO_TRACE_SAMPLING and
+ * CPL_VSIL_IO_TRACE_PREFIX configuration options mapping to the below
+ * options. A recording already in progress is stopped.
+ *
+ * Options:
+ * <ul>
+ * <li>SAMPLING=ratio: ratio in ]0,1] of the files whose accesses are
+ * recorded. The selection is based on a hash of the filename, so that all
+ * accesses to a file are recorded or none. Defaults to 1.</li>
+ * <li>PREFIX=prefix: only record accesses to files whose name starts with
+ * this prefix, e.g. /vsis3/</li>
+ * </ul>
+ *
+ * @param pszTraceFilename output file.
+ * @param papszOptions NULL terminated list of options, or NULL.
+ * @return TRUE in case of success.
+ * @since GDAL 3.4
+ */
+int VSIIOTraceStart( const char* pszTraceFilename, CSLConstList papszOptions )
+{
+    std::lock_guard<std::mutex> oLock(goMutex);
+    StopLocked();
+    return StartLocked(pszTraceFilename, papszOptions);
+}
+
+/************************************************************************/
+/*                           VSIIOTraceStop()                           */
+/************************************************************************/
+
+/**
+ * \brief Stops recording, and closes the trace file.
+ *
+ * This is done by GDALDestroyDriverManager().
+ *
+ * @return TRUE in case of success, or if no recording was in progress.
+ * @since GDAL 3.4
+ */
+int VSIIOTraceStop()
+{
+    std::lock_guard<std::mutex> oLock(goMutex);
+    return StopLocked();
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                              Replay                                  */
+/* ==================================================================== */
+/************************************************************************/
+
+//! @cond Doxygen_Suppress
+
+namespace {
+
+enum
+{
+    OP_OPEN,
+    OP_READ,
+    OP_MULTIRANGE,
+    OP_STAT,
+    OP_CLOSE,
+    OP_COUNT
+};
+
+struct ReplayStats
+{
+    GIntBig anCount[OP_COUNT] = {};
+    GIntBig anRecordedTime[OP_COUNT] = {};
+    GIntBig anReplayedTime[OP_COUNT] = {};
+    GUIntBig nReadBytes = 0;
+    GIntBig nErrors = 0;
+    GIntBig nMismatches = 0;
+};
+
+} // namespace
+
+// Parses an unsigned integer followed by a space or separator.
+static bool ParseUInt( const char*& pszIter, GUIntBig& nVal )
+{
+    char* pszEnd = nullptr;
+    nVal = std::strtoull(pszIter, &pszEnd, 10);
+    if( pszEnd == pszIter )
+        return false;
+    pszIter = pszEnd;
+    if( *pszIter == ' ' )
+        ++pszIter;
+    return true;
+}
+
+static bool ParseInt( const char*& pszIter, GIntBig& nVal )
+{
+    char* pszEnd = nullptr;
+    nVal = std::strtoll(pszIter, &pszEnd, 10);
+    if( pszEnd == pszIter )
+        return false;
+    pszIter = pszEnd;
+    if( *pszIter == ' ' )
+        ++pszIter;
+    return true;
+}
+
+static bool ParseRanges( const char* pszIter,
+                         std::vector<vsi_l_offset>& anOffsets,
+                         std::vector<size_t>& anSizes )
+{
+    while( *pszIter )
+    {
+        GUIntBig nOffset = 0;
+        GUIntBig nSize = 0;
+        if( !ParseUInt(pszIter, nOffset) || *pszIter != ':' )
+            return false;
+        ++pszIter;
+        if( !ParseUInt(pszIter, nSize) )
+            return false;
+        anOffsets.push_back(static_cast<vsi_l_offset>(nOffset));
+        anSizes.push_back(static_cast<size_t>(nSize));
+        if( *pszIter == ',' )
+            ++pszIter;
+        else if( *pszIter != '\0' )
+            return false;
+    }
+    return !anOffsets.empty();
+}
+
+//! @endcond
+
+/************************************************************************/
+/*                          VSIIOTraceReplay()                          */
+/************************************************************************/
+
+/**
+ * \brief Replays a trace recorded with VSIIOTraceStart().
+ *
+ * The calls are issued from the calling thread, in the order in which they
+ * were recorded. The replayed reads discard the data, but the number of bytes
+ * returned is compared with the recorded one.
+ *
+ * Options:
+ * <ul>
+ * <li>SOURCE_PREFIX=prefix and TARGET_PREFIX=prefix: filenames starting with
+ * SOURCE_PREFIX have it replaced by TARGET_PREFIX, e.g. to replay accesses
+ * to /vsis3/bucket/ against a local copy.</li>
+ * <li>TIMING=FAST/ORIGINAL: with FAST (default), calls are issued without
+ * delay. With ORIGINAL, each call is not issued before its recorded time
+ * relative to the start of the trace, so that the think time of the
+ * application is reproduced.</li>
+ * </ul>
+ *
+ * @param pszTraceFilename trace file.
+ * @param papszOptions NULL terminated list of options, or NULL.
+ * @return a list of NAME=VALUE statistics, to free with CSLDestroy(), or
+ * NULL in case of error. For each of the OPEN, READ, MULTIRANGE (ReadMultiRange
+ * and ReadAsync), STAT and CLOSE operations, X_COUNT is the number of calls,
+ * X_RECORDED_TIME and X_REPLAYED_TIME the cumulated recorded and replayed
+ * durations in seconds. READ_BYTES is the number of bytes read,
+ * ERROR_COUNT the number of calls that failed while they succeeded when
+ * recorded, MISMATCH_COUNT the number of calls whose result differs from the
+ * recorded one, and WALL_TIME the duration of the replay in seconds.
+ * @since GDAL 3.4
+ */
+char** VSIIOTraceReplay( const char* pszTraceFilename,
+                         CSLConstList papszOptions )
+{
+    VSILFILE* fp = VSIFOpenL(pszTraceFilename, "rb");
+    if( fp == nullptr )
+    {
+        CPLError(CE_Failure, CPLE_OpenFailed, "Cannot open %s",
+                 pszTraceFilename);
+        return nullptr;
+    }
+    const char* pszLine = CPLReadLine2L(fp, 1024, nullptr);
+    if( pszLine == nullptr || strcmp(pszLine, TRACE_HEADER) != 0 )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined, "%s is not a VSI I/O trace",
+                 pszTraceFilename);
+        VSIFCloseL(fp);
+        return nullptr;
+    }
+
+    const std::string osSourcePrefix(
+        CSLFetchNameValueDef(papszOptions, "SOURCE_PREFIX", ""));
+    const std::string osTargetPrefix(
+        CSLFetchNameValueDef(papszOptions, "TARGET_PREFIX", ""));
+    const bool bOriginalTiming =
+        EQUAL(CSLFetchNameValueDef(papszOptions, "TIMING", "FAST"),
+              "ORIGINAL");
+    const auto GetTargetFilename = [&osSourcePrefix, &osTargetPrefix](
+                                                    const char* pszFilename)
+    {
+        if( !osSourcePrefix.empty() &&
+            strncmp(pszFilename, osSourcePrefix.c_str(),
+                    osSourcePrefix.size()) == 0 )
+        {
+            return osTargetPrefix + (pszFilename + osSourcePrefix.size());
+        }
+        return std::string(pszFilename);
+    };
+
+    ReplayStats sStats;
+    std::map<GUIntBig, VSILFILE*> oMapHandles;
+    std::vector<GByte> abyBuffer;
+    std::vector<vsi_l_offset> anOffsets;
+    std::vector<size_t> anSizes;
+    std::vector<void*> apData;
+    const auto nReplayStart = std::chrono::steady_clock::now();
+    const auto Elapsed = [](std::chrono::steady_clock::time_point nStart)
+    {
+        return static_cast<GIntBig>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - nStart).count());
+    };
+    int nLine = 1;
+    bool bError = false;
+
+    // Reads of a single call larger than this are skipped.
+    constexpr GUIntBig MAX_READ_SIZE = 1024 * 1024 * 1024;
+
+    while( !bError &&
+           (pszLine = CPLReadLine2L(fp, 1024 * 1024, nullptr)) != nullptr )
+    {
+        ++nLine;
+        if( pszLine[0] == '\0' || pszLine[0] == '#' )
+            continue;
+        const char chOp = pszLine[0];
+        const char* pszIter = pszLine + 1;
+        if( *pszIter == ' ' )
+            ++pszIter;
+        GIntBig nTime = 0;
+        GIntBig nDuration = 0;
+        if( !ParseInt(pszIter, nTime) || !ParseInt(pszIter, nDuration) )
+        {
+            bError = true;
+            break;
+        }
+        if( bOriginalTiming )
+        {
+            const GIntBig nWait = nTime - Elapsed(nReplayStart);
+            if( nWait > 0 )
+                std::this_thread::sleep_for(std::chrono::microseconds(nWait));
+        }
+
+        int nOp = OP_COUNT;
+        const auto nCallStart = std::chrono::steady_clock::now();
+        switch( chOp )
+        {
+            case 'O':
+            {
+                nOp = OP_OPEN;
+                GUIntBig nId = 0;
+                GIntBig nSuccess = 0;
+                if( !ParseUInt(pszIter, nId) || !ParseInt(pszIter, nSuccess) )
+                {
+                    bError = true;
+                    break;
+                }
+                const char* pszSpace = strchr(pszIter, ' ');
+                if( pszSpace == nullptr )
+                {
+                    bError = true;
+                    break;
+                }
+                const std::string osAccess(pszIter, pszSpace - pszIter);
+                const std::string osFilename(GetTargetFilename(pszSpace + 1));
+                VSILFILE* fpFile = VSIFOpenL(osFilename.c_str(),
+                                             osAccess.c_str());
+                if( (fpFile != nullptr) != (nSuccess != 0) )
+                {
+                    sStats.nMismatches++;
+                    if( fpFile == nullptr )
+                        sStats.nErrors++;
+                }
+                if( fpFile )
+                {
+                    if( nSuccess )
+                        oMapHandles[nId] = fpFile;
+                    else
+                        VSIFCloseL(fpFile);
+                }
+                break;
+            }
+
+            case 'R':
+            {
+                nOp = OP_READ;
+                GUIntBig nId = 0;
+                GUIntBig nOffset = 0;
+                GUIntBig nRequested = 0;
+                GUIntBig nRead = 0;
+                if( !ParseUInt(pszIter, nId) ||
+                    !ParseUInt(pszIter, nOffset) ||
+                    !ParseUInt(pszIter, nRequested) ||
+                    !ParseUInt(pszIter, nRead) )
+                {
+                    bError = true;
+                    break;
+                }
+                auto oIter = oMapHandles.find(nId);
+                if( oIter == oMapHandles.end() || nRequested > MAX_READ_SIZE )
+                {
+                    nOp = OP_COUNT;
+                    break;
+                }
+                if( abyBuffer.size() < nRequested )
+                    abyBuffer.resize(static_cast<size_t>(nRequested));
+                size_t nRet = 0;
+                if( VSIFSeekL(oIter->second, nOffset, SEEK_SET) == 0 )
+                {
+                    nRet = VSIFReadL(abyBuffer.data(), 1,
+                                     static_cast<size_t>(nRequested),
+                                     oIter->second);
+                }
+                sStats.nReadBytes += nRet;
+                if( nRet != nRead )
+                {
+                    sStats.nMismatches++;
+                    if( nRet < nRead )
+                        sStats.nErrors++;
+                }
+                break;
+            }
+
+            case 'M':
+            case 'A':
+            {
+                nOp = OP_MULTIRANGE;
+                GUIntBig nId = 0;
+                GIntBig nRet = 0;
+                anOffsets.clear();
+                anSizes.clear();
+                if( !ParseUInt(pszIter, nId) || !ParseInt(pszIter, nRet) ||
+                    !ParseRanges(pszIter, anOffsets, anSizes) )
+                {
+                    bError = true;
+                    break;
+                }
+                auto oIter = oMapHandles.find(nId);
+                GUIntBig nTotal = 0;
+                for( size_t nSize: anSizes )
+                    nTotal += nSize;
+                if( oIter == oMapHandles.end() || nTotal > MAX_READ_SIZE )
+                {
+                    nOp = OP_COUNT;
+                    break;
+                }
+                if( abyBuffer.size() < nTotal )
+                    abyBuffer.resize(static_cast<size_t>(nTotal));
+                apData.clear();
+                size_t nPos = 0;
+                for( size_t nSize: anSizes )
+                {
+                    apData.push_back(abyBuffer.data() + nPos);
+                    nPos += nSize;
+                }
+                const int nReplayRet = VSIFReadMultiRangeL(
+                    static_cast<int>(anOffsets.size()), apData.data(),
+                    anOffsets.data(), anSizes.data(), oIter->second);
+                if( nReplayRet == 0 )
+                    sStats.nReadBytes += nTotal;
+                if( nReplayRet != nRet )
+                {
+                    sStats.nMismatches++;
+                    if( nReplayRet != 0 )
+                        sStats.nErrors++;
+                }
+                break;
+            }
+
+            case 'S':
+            {
+                nOp = OP_STAT;
+                GIntBig nFlags = 0;
+                GIntBig nRet = 0;
+                if( !ParseInt(pszIter, nFlags) || !ParseInt(pszIter, nRet) )
+                {
+                    bError = true;
+                    break;
+                }
+                const std::string osFilename(GetTargetFilename(pszIter));
+                VSIStatBufL sStat;
+                const int nReplayRet = VSIStatExL(
+                    osFilename.c_str(), &sStat, static_cast<int>(nFlags));
+                if( nReplayRet != nRet )
+                {
+                    sStats.nMismatches++;
+                    if( nReplayRet != 0 )
+                        sStats.nErrors++;
+                }
+                break;
+            }
+
+            case 'C':
+            {
+                nOp = OP_CLOSE;
+                GUIntBig nId = 0;
+                if( !ParseUInt(pszIter, nId) )
+                {
+                    bError = true;
+                    break;
+                }
+                auto oIter = oMapHandles.find(nId);
+                if( oIter == oMapHandles.end() )
+                {
+                    nOp = OP_COUNT;
+                    break;
+                }
+                VSIFCloseL(oIter->second);
+                oMapHandles.erase(oIter);
+                break;
+            }
+
+            default:
+                bError = true;
+                break;
+        }
+        if( !bError && nOp != OP_COUNT )
+        {
+            sStats.anCount[nOp]++;
+            sStats.anRecordedTime[nOp] += nDuration;
+            sStats.anReplayedTime[nOp] += Elapsed(nCallStart);
+        }
+    }
+    const GIntBig nWallTime = Elapsed(nReplayStart);
+
+    for( auto& oIter: oMapHandles )
+        VSIFCloseL(oIter.second);
+    VSIFCloseL(fp);
+
+    if( bError )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Invalid line %d of %s", nLine, pszTraceFilename);
+        return nullptr;
+    }
+
+    static const char* const apszOpNames[OP_COUNT] =
+        { "OPEN", "READ", "MULTIRANGE", "STAT", "CLOSE" };
+    CPLStringList aosStats;
+    for( int i = 0; i < OP_COUNT; ++i )
+    {
+        aosStats.SetNameValue(CPLSPrintf("%s_COUNT", apszOpNames[i]),
+                              CPLSPrintf(CPL_FRMT_GIB, sStats.anCount[i]));
+        aosStats.SetNameValue(CPLSPrintf("%s_RECORDED_TIME", apszOpNames[i]),
+                              CPLSPrintf("%.6f",
+                                         sStats.anRecordedTime[i] * 1e-6));
+        aosStats.SetNameValue(CPLSPrintf("%s_REPLAYED_TIME", apszOpNames[i]),
+                              CPLSPrintf("%.6f",
+                                         sStats.anReplayedTime[i] * 1e-6));
+    }
+    aosStats.SetNameValue("READ_BYTES",
+                          CPLSPrintf(CPL_FRMT_GUIB, sStats.nReadBytes));
+    aosStats.SetNameValue("ERROR_COUNT",
+                          CPLSPrintf(CPL_FRMT_GIB, sStats.nErrors));
+    aosStats.SetNameValue("MISMATCH_COUNT",
+                          CPLSPrintf(CPL_FRMT_GIB, sStats.nMismatches));
+    aosStats.SetNameValue("WALL_TIME", CPLSPrintf("%.6f", nWallTime * 1e-6));
+    return aosStats.StealList();
+}
@@ -607,6 +607,166 @@ class VSIS3Handle final : public IVSIS3LikeHandle
 };
 
 
+/************************************************************************/
+/*                       VSIParallelPartUploader()                      */
+/************************************************************************/
+
+VSIParallelPartUploader::VSIParallelPartUploader( IVSIS3LikeFSHandler* poFS,
+                                                  const char* pszFilename,
+                                                  int nMaxRetry,
+                                                  double dfRetryDelay,
+                                                  int nMaxInFlight ) :
+    m_poFS(poFS),
+    m_osFilename(pszFilename),
+    m_nMaxRetry(nMaxRetry),
+    m_dfRetryDelay(dfRetryDelay),
+    m_nMaxInFlight(nMaxInFlight)
+{
+}
+
+/************************************************************************/
+/*                      ~VSIParallelPartUploader()                      */
+/************************************************************************/
+
+VSIParallelPartUploader::~VSIParallelPartUploader()
+{
+    WaitAll();
+    m_poPool.reset();
+    for( GByte* pabyBuffer: m_apabyFreeBuffers )
+        VSIFree(pabyBuffer);
+}
+
+/************************************************************************/
+/*                           GetMaxInFlight()                           */
+/************************************************************************/
+
+// Returns the number of parts that can be uploaded at the same time, as
+// set by the CPL_VSIL_CURL_PARALLEL_UPLOAD configuration option.
+int VSIParallelPartUploader::GetMaxInFlight()
+{
+    return std::max(1, std::min(64, atoi(
+        CPLGetConfigOption("CPL_VSIL_CURL_PARALLEL_UPLOAD", "1"))));
+}
+
+/************************************************************************/
+/*                           AcquireBuffer()                            */
+/************************************************************************/
+
+GByte* VSIParallelPartUploader::AcquireBuffer( size_t nSize )
+{
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        if( !m_apabyFreeBuffers.empty() )
+        {
+            GByte* pabyBuffer = m_apabyFreeBuffers.back();
+            m_apabyFreeBuffers.pop_back();
+            return pabyBuffer;
+        }
+    }
+    return static_cast<GByte*>(VSI_MALLOC_VERBOSE(nSize));
+}
+
+/************************************************************************/
+/*                               Submit()                               */
+/************************************************************************/
+
+// Takes ownership of pabyBuffer, which becomes available again through
+// AcquireBuffer() once uploaded.
+bool VSIParallelPartUploader::Submit( int nPartNumber, vsi_l_offset nPosition,
+                                      GByte* pabyBuffer, size_t nSize )
+{
+    std::unique_ptr<Job> poJob(new Job());
+    poJob->poUploader = this;
+    poJob->nPartNumber = nPartNumber;
+    poJob->nPosition = nPosition;
+    poJob->pabyBuffer = pabyBuffer;
+    poJob->nSize = nSize;
+
+    std::unique_lock<std::mutex> oLock(m_oMutex);
+    m_oCV.wait(oLock, [this]{ return m_nInFlight < m_nMaxInFlight; });
+    if( !m_bError && m_poPool == nullptr )
+    {
+        m_poPool.reset(new CPLWorkerThreadPool());
+        if( !m_poPool->Setup(m_nMaxInFlight, nullptr, nullptr) )
+        {
+            m_poPool.reset();
+            m_bError = true;
+        }
+    }
+    if( m_bError )
+    {
+        m_apabyFreeBuffers.push_back(pabyBuffer);
+        return false;
+    }
+    m_nInFlight++;
+    if( !m_poPool->SubmitJob(JobFunc, poJob.get()) )
+    {
+        m_nInFlight--;
+        m_bError = true;
+        m_apabyFreeBuffers.push_back(pabyBuffer);
+        return false;
+    }
+    poJob.release();
+    return true;
+}
+
+/************************************************************************/
+/*                              JobFunc()                               */
+/************************************************************************/
+
+void VSIParallelPartUploader::JobFunc( void* pData )
+{
+    std::unique_ptr<Job> poJob(static_cast<Job*>(pData));
+    VSIParallelPartUploader* poThis = poJob->poUploader;
+    IVSIS3LikeFSHandler* poFS = poThis->m_poFS;
+
+    // Handle helpers are modified by requests, so use one per job.
+    std::unique_ptr<IVSIS3LikeHandleHelper> poHandleHelper(
+        poFS->CreateHandleHelper(
+            poThis->m_osFilename.c_str() + poFS->GetFSPrefix().size(), false));
+    CPLString osEtag;
+    if( poHandleHelper )
+    {
+        poFS->UpdateHandleFromMap(poHandleHelper.get());
+        osEtag = poFS->UploadPart(poThis->m_osFilename, poJob->nPartNumber,
+                                  poThis->m_osUploadID, poJob->nPosition,
+                                  poJob->pabyBuffer, poJob->nSize,
+                                  poHandleHelper.get(),
+                                  poThis->m_nMaxRetry, poThis->m_dfRetryDelay);
+    }
+
+    {
+        std::lock_guard<std::mutex> oLock(poThis->m_oMutex);
+        if( osEtag.empty() )
+        {
+            poThis->m_bError = true;
+        }
+        else
+        {
+            if( static_cast<int>(poThis->m_aosEtags.size()) <
+                                                        poJob->nPartNumber )
+                poThis->m_aosEtags.resize(poJob->nPartNumber);
+            poThis->m_aosEtags[poJob->nPartNumber - 1] = osEtag;
+        }
+        poThis->m_apabyFreeBuffers.push_back(poJob->pabyBuffer);
+        poThis->m_nInFlight--;
+    }
+    poThis->m_oCV.notify_all();
+}
+
+/************************************************************************/
+/*                              WaitAll()                               */
+/************************************************************************/
+
+// Waits for the completion of all submitted parts, and returns whether
+// all of them have been successfully uploaded.
+bool VSIParallelPartUploader::WaitAll()
+{
+    std::unique_lock<std::mutex> oLock(m_oMutex);
+    m_oCV.wait(oLock, [this]{ return m_nInFlight == 0; });
+    return !m_bError;
+}
+
 /************************************************************************/
 /*                         VSIS3WriteHandle()                           */
 /************************************************************************/
@@ -658,6 +818,14 @@ VSIS3WriteHandle::VSIS3WriteHandle( IVSIS3LikeFSHandler* poFS,
                     "Cannot allocate working buffer for %s",
                      m_poFS->GetFSPrefix().c_str());
         }
+
+        const int nMaxInFlight = VSIParallelPartUploader::GetMaxInFlight();
+        if( nMaxInFlight > 1 )
+        {
+            m_poUploader.reset(new VSIParallelPartUploader(
+                m_poFS, m_osFilename, m_nMaxRetry, m_dfRetryDelay,
+                nMaxInFlight));
+        }
     }
 }
 
@@ -782,6 +950,7 @@ CPLString IVSIS3LikeFSHandler::InitiateMultipartUpload(
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -855,6 +1024,20 @@ bool VSIS3WriteHandle::UploadPart()
             m_osFilename.c_str());
         return false;
     }
+    if( m_poUploader )
+    {
+        // Hand the buffer to a worker thread, and go on with another one.
+        if( m_nPartNumber == 1 )
+            m_poUploader->SetUploadID(m_osUploadID);
+        const bool bSubmitted = m_poUploader->Submit(
+            m_nPartNumber,
+            static_cast<vsi_l_offset>(m_nBufferSize) * (m_nPartNumber-1),
+            m_pabyBuffer, m_nBufferOff);
+        m_pabyBuffer = m_poUploader->AcquireBuffer(m_nBufferSize);
+        m_nBufferOff = 0;
+        return bSubmitted && m_pabyBuffer != nullptr;
+    }
+
     const CPLString osEtag =
         m_poFS->UploadPart(m_osFilename, m_nPartNumber, m_osUploadID,
                            static_cast<vsi_l_offset>(m_nBufferSize) * (m_nPartNumber-1),
@@ -937,6 +1120,7 @@ CPLString IVSIS3LikeFSHandler::UploadPart(const CPLString& osFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1124,6 +1308,7 @@ VSIS3WriteHandle::WriteChunked( const void *pBuffer, size_t nSize, size_t nMemb
                                             dfRetryDelay);
                                 CPLSleep(dfRetryDelay);
                                 dfRetryDelay = dfNewRetryDelay;
+                                NetworkStatisticsLogger::LogRetry();
                                 nRetryCount++;
                                 bRetry = true;
                             }
@@ -1194,6 +1379,7 @@ VSIS3WriteHandle::WriteChunked( const void *pBuffer, size_t nSize, size_t nMemb
                                 dfRetryDelay);
                     CPLSleep(dfRetryDelay);
                     dfRetryDelay = dfNewRetryDelay;
+                    NetworkStatisticsLogger::LogRetry();
                     nRetryCount++;
                     bRetry = true;
                 }
@@ -1253,6 +1439,7 @@ int VSIS3WriteHandle::FinishChunkedTransfer()
     m_nChunkedBufferSize = 0;
 
     MultiPerform(m_hCurlMulti);
+    NetworkStatisticsLogger::LogTimings(m_hCurl);
 
     long response_code;
     curl_easy_getinfo(m_hCurl, CURLINFO_RESPONSE_CODE, &response_code);
@@ -1415,6 +1602,7 @@ bool VSIS3WriteHandle::DoSinglePartPUT()
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1557,6 +1745,7 @@ bool IVSIS3LikeFSHandler::CompleteMultipart(const CPLString& osFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1641,6 +1830,7 @@ bool IVSIS3LikeFSHandler::AbortMultipart(const CPLString& osFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -1778,6 +1968,7 @@ bool IVSIS3LikeFSHandler::AbortPendingUploads(const char* pszFilename)
                                 dfRetryDelay);
                     CPLSleep(dfRetryDelay);
                     dfRetryDelay = dfNewRetryDelay;
+                    NetworkStatisticsLogger::LogRetry();
                     nRetryCount++;
                     bRetry = true;
                 }
@@ -1899,16 +2090,32 @@ int VSIS3WriteHandle::Close()
         {
             if( m_bError )
             {
+                if( m_poUploader )
+                    m_poUploader->WaitAll();
                 if( !m_poFS->AbortMultipart(m_osFilename, m_osUploadID,
                                             m_poS3HandleHelper,
                                             m_nMaxRetry, m_dfRetryDelay) )
                     nRet = -1;
             }
             else if( m_nBufferOff > 0 && !UploadPart() )
+            {
+                if( m_poUploader )
+                    m_poUploader->WaitAll();
                 nRet = -1;
+            }
+            else if( m_poUploader && !m_poUploader->WaitAll() )
+            {
+                // A part failed in the background
+                m_poFS->AbortMultipart(m_osFilename, m_osUploadID,
+                                       m_poS3HandleHelper,
+                                       m_nMaxRetry, m_dfRetryDelay);
+                nRet = -1;
+            }
             else if( m_poFS->CompleteMultipart(
                                      m_osFilename, m_osUploadID,
-                                     m_aosEtags, m_nCurOffset,
+                                     m_poUploader ? m_poUploader->GetETags()
+                                                  : m_aosEtags,
+                                     m_nCurOffset,
                                      m_poS3HandleHelper,
                                      m_nMaxRetry, m_dfRetryDelay) )
             {
@@ -2325,6 +2532,7 @@ std::set<CPLString> VSIS3FSHandler::DeleteObjects(const char* pszBucket,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -2453,6 +2661,7 @@ char** VSIS3FSHandler::GetFileMetadata( const char* pszFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -2648,6 +2857,7 @@ bool VSIS3FSHandler::SetFileMetadata( const char * pszFilename,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -3126,6 +3336,7 @@ int IVSIS3LikeFSHandler::CopyObject( const char *oldpath, const char *newpath,
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
@@ -3231,6 +3442,7 @@ int IVSIS3LikeFSHandler::DeleteObject( const char *pszFilename )
                             dfRetryDelay);
                 CPLSleep(dfRetryDelay);
                 dfRetryDelay = dfNewRetryDelay;
+                NetworkStatisticsLogger::LogRetry();
                 nRetryCount++;
                 bRetry = true;
             }
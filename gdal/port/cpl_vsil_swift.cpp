@@ -636,6 +636,7 @@ char** VSISwiftFSHandler::GetFileList( const char *pszDirname,
                                 dfRetryDelay);
                     CPLSleep(dfRetryDelay);
                     dfRetryDelay = dfNewRetryDelay;
+                    NetworkStatisticsLogger::LogRetry();
                     nRetryCount++;
                     bRetry = true;
                     CPLFree(sWriteFuncData.pBuffer);
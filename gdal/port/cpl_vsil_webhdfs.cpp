@@ -1160,6 +1160,7 @@ retry:
                         dfRetryDelay);
             CPLSleep(dfRetryDelay);
             dfRetryDelay = dfNewRetryDelay;
+            NetworkStatisticsLogger::LogRetry();
             nRetryCount++;
             CPLFree(sWriteFuncData.pBuffer);
             curl_easy_cleanup(hCurlHandle);
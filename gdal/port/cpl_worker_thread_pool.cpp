@@ -29,8 +29,10 @@
 #include "cpl_port.h"
 #include "cpl_worker_thread_pool.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
+#include <new>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -39,11 +41,12 @@
 
 CPL_CVSID("$Id$")
 
-struct CPLWorkerThreadJob
-{
-    CPLThreadFunc  pfnFunc;
-    void          *pData;
-};
+// Worker thread running the current code, if any.
+static thread_local CPLWorkerThread* tl_psCurrentWorkerThread = nullptr;
+
+// Upper bound of the number of threads of a pool, so that aWT is never
+// reallocated while other threads are iterating over it to steal jobs.
+constexpr int knMaxThreads = 1024;
 
 /************************************************************************/
 /*                         CPLWorkerThreadPool()                        */
@@ -73,18 +76,14 @@ CPLWorkerThreadPool::~CPLWorkerThreadPool()
     {
         std::lock_guard<std::mutex> oGuard(m_mutex);
         eState = CPLWTS_STOP;
+        m_cvWorkers.notify_all();
     }
 
-    for( auto& wt: aWT )
+    const int nThreads = m_nThreads.load();
+    for( int i = 0; i < nThreads; ++i )
     {
-        {
-            std::lock_guard<std::mutex> oGuard(wt->m_mutex);
-            wt->m_cv.notify_one();
-        }
-        CPLJoinThread(wt->hThread);
+        CPLJoinThread(aWT[i]->hThread);
     }
-
-    CPLListDestroy(psWaitingWorkerThreadsList);
 }
 
 /************************************************************************/
@@ -95,93 +94,214 @@ void CPLWorkerThreadPool::WorkerThreadFunction(void* user_data)
 {
     CPLWorkerThread* psWT = static_cast<CPLWorkerThread*>(user_data);
     CPLWorkerThreadPool* poTP = psWT->poTP;
+    tl_psCurrentWorkerThread = psWT;
 
     if( psWT->pfnInitFunc )
         psWT->pfnInitFunc( psWT->pInitData );
 
-    while( true )
     {
-        CPLWorkerThreadJob* psJob = poTP->GetNextJob(psWT);
-        if( psJob == nullptr )
-            break;
+        std::lock_guard<std::mutex> oGuard(poTP->m_mutex);
+        poTP->m_nStartedThreads++;
+        poTP->m_cv.notify_all();
+    }
 
-        if( psJob->pfnFunc )
+    while( true )
+    {
+        CPLWorkerThreadJob sJob;
+        if( poTP->PopJob(psWT, nullptr, sJob) )
         {
-            psJob->pfnFunc(psJob->pData);
+            poTP->RunJob(sJob);
+            continue;
         }
-        CPLFree(psJob);
+
+        std::unique_lock<std::mutex> oGuard(poTP->m_mutex);
+        if( poTP->eState == CPLWTS_STOP )
+            break;
+        // Jobs are counted before waking up waiting threads, and waiting
+        // threads are counted before checking for jobs, so that a
+        // submission cannot be missed.
+        poTP->nWaitingWorkerThreads++;
+        if( poTP->m_nQueuedJobs.load() == 0 )
+        {
 #if DEBUG_VERBOSE
-        CPLDebug("JOB", "%p finished a job", psWT);
+            CPLDebug("JOB", "%p sleeping", psWT);
 #endif
-        poTP->DeclareJobFinished();
+            poTP->m_cvWorkers.wait(oGuard);
+        }
+        poTP->nWaitingWorkerThreads--;
     }
 }
 
 /************************************************************************/
-/*                             SubmitJob()                              */
+/*                       IsCurrentThreadWorker()                        */
 /************************************************************************/
 
-/** Queue a new job.
- *
- * @param pfnFunc Function to run for the job.
- * @param pData User data to pass to the job function.
- * @return true in case of success.
- */
-bool CPLWorkerThreadPool::SubmitJob( CPLThreadFunc pfnFunc, void* pData )
+bool CPLWorkerThreadPool::IsCurrentThreadWorker(
+                                CPLWorkerThread** ppsWorkerThread) const
 {
-    CPLAssert( !aWT.empty() );
-
-    CPLWorkerThreadJob* psJob = static_cast<CPLWorkerThreadJob *>(
-        VSI_MALLOC_VERBOSE(sizeof(CPLWorkerThreadJob)));
-    if( psJob == nullptr )
+    CPLWorkerThread* psWT = tl_psCurrentWorkerThread;
+    if( psWT == nullptr || psWT->poTP != this )
         return false;
-    psJob->pfnFunc = pfnFunc;
-    psJob->pData = pData;
+    if( ppsWorkerThread )
+        *ppsWorkerThread = psWT;
+    return true;
+}
+
+/************************************************************************/
+/*                              PushJob()                               */
+/************************************************************************/
+
+bool CPLWorkerThreadPool::PushJob(const CPLWorkerThreadJob& sJob)
+{
+    CPLAssert( m_nThreads.load() > 0 );
 
-    CPLList* psItem =
-        static_cast<CPLList *>(VSI_MALLOC_VERBOSE(sizeof(CPLList)));
-    if( psItem == nullptr )
+    nPendingJobs++;
+    try
+    {
+        CPLWorkerThread* psWT = nullptr;
+        if( IsCurrentThreadWorker(&psWT) )
+        {
+            std::lock_guard<std::mutex> oGuard(psWT->m_mutex);
+            psWT->m_aoJobs.push_back(sJob);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> oGuard(m_globalJobsMutex);
+            m_aoGlobalJobs.push_back(sJob);
+        }
+    }
+    catch( const std::bad_alloc& )
     {
-        VSIFree(psJob);
+        CPLError(CE_Failure, CPLE_OutOfMemory, "Cannot queue job");
+        DeclareJobFinished();
         return false;
     }
-    psItem->pData = psJob;
-
-    std::unique_lock<std::mutex> oGuard(m_mutex);
+    m_nQueuedJobs++;
+    return true;
+}
 
-    psItem->psNext = psJobQueue;
-    psJobQueue = psItem;
-    nPendingJobs++;
+/************************************************************************/
+/*                           WakeUpWorkers()                            */
+/************************************************************************/
 
-    if( psWaitingWorkerThreadsList )
+void CPLWorkerThreadPool::WakeUpWorkers(int nJobs)
+{
+    if( nWaitingWorkerThreads.load() > 0 )
     {
-        CPLWorkerThread* psWorkerThread =
-            static_cast<CPLWorkerThread *>(psWaitingWorkerThreadsList->pData);
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        if( nJobs == 1 )
+            m_cvWorkers.notify_one();
+        else
+            m_cvWorkers.notify_all();
+    }
+}
 
-        CPLAssert( psWorkerThread->bMarkedAsWaiting );
-        psWorkerThread->bMarkedAsWaiting = false;
+/************************************************************************/
+/*                              PopJob()                                */
+/************************************************************************/
 
-        CPLList* psNext = psWaitingWorkerThreadsList->psNext;
-        CPLList* psToFree = psWaitingWorkerThreadsList;
-        psWaitingWorkerThreadsList = psNext;
-        nWaitingWorkerThreads--;
+/* Takes a job, of poQueue if it is not null, from the local queue of
+ * psWorkerThread (if not null), then from the shared queue, and then from the
+ * local queues of the other threads.
+ */
+bool CPLWorkerThreadPool::PopJob(CPLWorkerThread* psWorkerThread,
+                                 const CPLJobQueue* poQueue,
+                                 CPLWorkerThreadJob& sJob)
+{
+    if( m_nQueuedJobs.load() == 0 )
+        return false;
 
-        // CPLAssert(
-        //   CPLListCount(psWaitingWorkerThreadsList) == nWaitingWorkerThreads);
+    const auto TakeFrom = [poQueue, &sJob](std::deque<CPLWorkerThreadJob>& aoJobs,
+                                           bool bFromBack)
+    {
+        if( aoJobs.empty() )
+            return false;
+        if( poQueue == nullptr )
+        {
+            if( bFromBack )
+            {
+                sJob = aoJobs.back();
+                aoJobs.pop_back();
+            }
+            else
+            {
+                sJob = aoJobs.front();
+                aoJobs.pop_front();
+            }
+            return true;
+        }
+        const auto oIter = std::find_if(aoJobs.begin(), aoJobs.end(),
+            [poQueue](const CPLWorkerThreadJob& sOther)
+            { return sOther.poQueue == poQueue; });
+        if( oIter == aoJobs.end() )
+            return false;
+        sJob = *oIter;
+        aoJobs.erase(oIter);
+        return true;
+    };
+
+    bool bFound = false;
+    if( psWorkerThread )
+    {
+        std::lock_guard<std::mutex> oGuard(psWorkerThread->m_mutex);
+        bFound = TakeFrom(psWorkerThread->m_aoJobs, true);
+    }
+    if( !bFound )
+    {
+        std::lock_guard<std::mutex> oGuard(m_globalJobsMutex);
+        bFound = TakeFrom(m_aoGlobalJobs, false);
+    }
+    if( !bFound )
+    {
+        const int nThreads = m_nThreads.load();
+        for( int i = 0; !bFound && i < nThreads; ++i )
+        {
+            CPLWorkerThread* psVictim = aWT[i].get();
+            if( psVictim == psWorkerThread )
+                continue;
+            std::lock_guard<std::mutex> oGuard(psVictim->m_mutex);
+            bFound = TakeFrom(psVictim->m_aoJobs, false);
+        }
+    }
+    if( bFound )
+        m_nQueuedJobs--;
+    return bFound;
+}
 
+/************************************************************************/
+/*                              RunJob()                                */
+/************************************************************************/
+
+void CPLWorkerThreadPool::RunJob(const CPLWorkerThreadJob& sJob)
+{
+    if( sJob.pfnFunc )
+        sJob.pfnFunc(sJob.pData);
 #if DEBUG_VERBOSE
-        CPLDebug("JOB", "Waking up %p", psWorkerThread);
+    CPLDebug("JOB", "%p finished a job", tl_psCurrentWorkerThread);
 #endif
+    if( sJob.poQueue )
+        sJob.poQueue->DeclareJobFinished();
+    DeclareJobFinished();
+}
 
-        {
-            std::lock_guard<std::mutex> oGuardWT(psWorkerThread->m_mutex);
-            oGuard.unlock();
-            psWorkerThread->m_cv.notify_one();
-        }
-
-        CPLFree(psToFree);
-    }
+/************************************************************************/
+/*                             SubmitJob()                              */
+/************************************************************************/
 
+/** Queue a new job.
+ *
+ * @param pfnFunc Function to run for the job.
+ * @param pData User data to pass to the job function.
+ * @return true in case of success.
+ */
+bool CPLWorkerThreadPool::SubmitJob( CPLThreadFunc pfnFunc, void* pData )
+{
+    CPLWorkerThreadJob sJob;
+    sJob.pfnFunc = pfnFunc;
+    sJob.pData = pData;
+    if( !PushJob(sJob) )
+        return false;
+    WakeUpWorkers(1);
     return true;
 }
 
@@ -198,92 +318,23 @@ bool CPLWorkerThreadPool::SubmitJob( CPLThreadFunc pfnFunc, void* pData )
 bool CPLWorkerThreadPool::SubmitJobs(CPLThreadFunc pfnFunc,
                                      const std::vector<void*>& apData)
 {
-    CPLAssert( !aWT.empty() );
-
-    std::unique_lock<std::mutex> oGuard(m_mutex);
-
-    CPLList* psJobQueueInit = psJobQueue;
     bool bRet = true;
-
-    for(size_t i=0;i<apData.size();i++)
+    int nSubmitted = 0;
+    for( void* pData: apData )
     {
-        CPLWorkerThreadJob* psJob = static_cast<CPLWorkerThreadJob*>(
-            VSI_MALLOC_VERBOSE(sizeof(CPLWorkerThreadJob)));
-        if( psJob == nullptr )
-        {
-            bRet = false;
-            break;
-        }
-        psJob->pfnFunc = pfnFunc;
-        psJob->pData = apData[i];
-
-        CPLList* psItem =
-            static_cast<CPLList *>(VSI_MALLOC_VERBOSE(sizeof(CPLList)));
-        if( psItem == nullptr )
+        CPLWorkerThreadJob sJob;
+        sJob.pfnFunc = pfnFunc;
+        sJob.pData = pData;
+        if( !PushJob(sJob) )
         {
-            VSIFree(psJob);
             bRet = false;
             break;
         }
-        psItem->pData = psJob;
-
-        psItem->psNext = psJobQueue;
-        psJobQueue = psItem;
-        nPendingJobs++;
-    }
-
-    if( !bRet )
-    {
-        for( CPLList* psIter = psJobQueue; psIter != psJobQueueInit; )
-        {
-            CPLList* psNext = psIter->psNext;
-            VSIFree(psIter->pData);
-            VSIFree(psIter);
-            nPendingJobs--;
-            psIter = psNext;
-        }
-        return false;
+        nSubmitted++;
     }
-
-    for(size_t i=0;i<apData.size();i++)
-    {
-        if( psWaitingWorkerThreadsList && psJobQueue )
-        {
-            CPLWorkerThread* psWorkerThread;
-
-            psWorkerThread = static_cast<CPLWorkerThread*>(psWaitingWorkerThreadsList->pData);
-
-            CPLAssert( psWorkerThread->bMarkedAsWaiting );
-            psWorkerThread->bMarkedAsWaiting = false;
-
-            CPLList* psNext = psWaitingWorkerThreadsList->psNext;
-            CPLList* psToFree = psWaitingWorkerThreadsList;
-            psWaitingWorkerThreadsList = psNext;
-            nWaitingWorkerThreads--;
-
-            // CPLAssert(
-            //    CPLListCount(psWaitingWorkerThreadsList) ==
-            //    nWaitingWorkerThreads);
-
-#if DEBUG_VERBOSE
-            CPLDebug("JOB", "Waking up %p", psWorkerThread);
-#endif
-            {
-                std::lock_guard<std::mutex> oGuardWT(psWorkerThread->m_mutex);
-                oGuard.unlock();
-                psWorkerThread->m_cv.notify_one();
-            }
-
-            CPLFree(psToFree);
-            oGuard.lock();
-        }
-        else
-        {
-            break;
-        }
-    }
-
-    return true;
+    if( nSubmitted > 0 )
+        WakeUpWorkers(nSubmitted);
+    return bRet;
 }
 
 /************************************************************************/
@@ -301,7 +352,7 @@ void CPLWorkerThreadPool::WaitCompletion(int nMaxRemainingJobs)
     if( nMaxRemainingJobs < 0 )
         nMaxRemainingJobs = 0;
     std::unique_lock<std::mutex> oGuard(m_mutex);
-    while( nPendingJobs > nMaxRemainingJobs )
+    while( nPendingJobs.load() > nMaxRemainingJobs )
     {
         m_cv.wait(oGuard);
     }
@@ -318,13 +369,13 @@ void CPLWorkerThreadPool::WaitEvent()
     std::unique_lock<std::mutex> oGuard(m_mutex);
     while( true )
     {
-        const int nPendingJobsBefore = nPendingJobs;
+        const int nPendingJobsBefore = nPendingJobs.load();
         if( nPendingJobsBefore == 0 )
         {
             break;
         }
         m_cv.wait(oGuard);
-        if( nPendingJobs < nPendingJobsBefore )
+        if( nPendingJobs.load() < nPendingJobsBefore )
         {
             break;
         }
@@ -365,31 +416,36 @@ bool CPLWorkerThreadPool::Setup(int nThreads,
                             bool bWaitallStarted)
 {
     CPLAssert( nThreads > 0 );
+    nThreads = std::min(nThreads, knMaxThreads);
 
     bool bRet = true;
-    for(int i=static_cast<int>(aWT.size());i<nThreads;i++)
+    if( aWT.empty() )
+        aWT.reserve(knMaxThreads);
+    for(int i=m_nThreads.load();i<nThreads;i++)
     {
         std::unique_ptr<CPLWorkerThread> wt(new CPLWorkerThread);
         wt->pfnInitFunc = pfnInitFunc;
         wt->pInitData = pasInitData ? pasInitData[i] : nullptr;
         wt->poTP = this;
-        wt->bMarkedAsWaiting = false;
-        wt->hThread =
-            CPLCreateJoinableThread(WorkerThreadFunction, wt.get());
-        if( wt->hThread == nullptr )
+        CPLWorkerThread* psWT = wt.get();
+        aWT.emplace_back(std::move(wt));
+        psWT->hThread =
+            CPLCreateJoinableThread(WorkerThreadFunction, psWT);
+        if( psWT->hThread == nullptr )
         {
+            aWT.pop_back();
             nThreads = i;
             bRet = false;
             break;
         }
-        aWT.emplace_back(std::move(wt));
+        m_nThreads++;
     }
 
     if( bWaitallStarted )
     {
         // Wait all threads to be started
         std::unique_lock<std::mutex> oGuard(m_mutex);
-        while( nWaitingWorkerThreads < nThreads )
+        while( m_nStartedThreads < nThreads )
         {
             m_cv.wait(oGuard);
         }
@@ -409,72 +465,7 @@ void CPLWorkerThreadPool::DeclareJobFinished()
 {
     std::lock_guard<std::mutex> oGuard(m_mutex);
     nPendingJobs --;
-    m_cv.notify_one();
-}
-
-/************************************************************************/
-/*                             GetNextJob()                             */
-/************************************************************************/
-
-CPLWorkerThreadJob *
-CPLWorkerThreadPool::GetNextJob( CPLWorkerThread* psWorkerThread )
-{
-    while(true)
-    {
-        std::unique_lock<std::mutex> oGuard(m_mutex);
-        if( eState == CPLWTS_STOP )
-        {
-            return nullptr;
-        }
-        CPLList* psTopJobIter = psJobQueue;
-        if( psTopJobIter )
-        {
-            psJobQueue = psTopJobIter->psNext;
-
-#if DEBUG_VERBOSE
-            CPLDebug("JOB", "%p got a job", psWorkerThread);
-#endif
-            CPLWorkerThreadJob* psJob =
-                static_cast<CPLWorkerThreadJob*>(psTopJobIter->pData);
-            CPLFree(psTopJobIter);
-            return psJob;
-        }
-
-        if( !psWorkerThread->bMarkedAsWaiting )
-        {
-            psWorkerThread->bMarkedAsWaiting = true;
-            nWaitingWorkerThreads++;
-
-            CPLList* psItem =
-                static_cast<CPLList *>(VSI_MALLOC_VERBOSE(sizeof(CPLList)));
-            if( psItem == nullptr )
-            {
-                eState = CPLWTS_ERROR;
-                m_cv.notify_one();
-
-                return nullptr;
-            }
-
-            psItem->pData = psWorkerThread;
-            psItem->psNext = psWaitingWorkerThreadsList;
-            psWaitingWorkerThreadsList = psItem;
-
-#if DEBUG_VERBOSE
-            CPLAssert(CPLListCount(psWaitingWorkerThreadsList) ==
-                      nWaitingWorkerThreads);
-#endif
-        }
-
-        m_cv.notify_one();
-
-#if DEBUG_VERBOSE
-        CPLDebug("JOB", "%p sleeping", psWorkerThread);
-#endif
-
-        std::unique_lock<std::mutex> oGuardThisThread(psWorkerThread->m_mutex);
-        oGuard.unlock();
-        psWorkerThread->m_cv.wait(oGuardThisThread);
-    }
+    m_cv.notify_all();
 }
 
 /************************************************************************/
@@ -511,29 +502,6 @@ CPLJobQueue::~CPLJobQueue()
     WaitCompletion();
 }
 
-/************************************************************************/
-/*                           JobQueueJob                                */
-/************************************************************************/
-
-struct JobQueueJob
-{
-    CPLJobQueue* poQueue = nullptr;
-    CPLThreadFunc pfnFunc = nullptr;
-    void* pData = nullptr;
-};
-
-/************************************************************************/
-/*                          JobQueueFunction()                          */
-/************************************************************************/
-
-void CPLJobQueue::JobQueueFunction(void* pData)
-{
-    JobQueueJob* poJob = static_cast<JobQueueJob*>(pData);
-    poJob->pfnFunc(poJob->pData);
-    poJob->poQueue->DeclareJobFinished();
-    delete poJob;
-}
-
 /************************************************************************/
 /*                          DeclareJobFinished()                        */
 /************************************************************************/
@@ -542,7 +510,7 @@ void CPLJobQueue::DeclareJobFinished()
 {
     std::lock_guard<std::mutex> oGuard(m_mutex);
     m_nPendingJobs --;
-    m_cv.notify_one();
+    m_cv.notify_all();
 }
 
 /************************************************************************/
@@ -557,20 +525,28 @@ void CPLJobQueue::DeclareJobFinished()
  */
 bool CPLJobQueue::SubmitJob(CPLThreadFunc pfnFunc, void* pData)
 {
-    JobQueueJob* poJob = new JobQueueJob;
-    poJob->poQueue = this;
-    poJob->pfnFunc = pfnFunc;
-    poJob->pData = pData;
+    CPLWorkerThreadJob sJob;
+    sJob.pfnFunc = pfnFunc;
+    sJob.pData = pData;
+    sJob.poQueue = this;
     {
         std::lock_guard<std::mutex> oGuard(m_mutex);
         m_nPendingJobs ++;
     }
-    bool bRet = m_poPool->SubmitJob(JobQueueFunction, poJob);
-    if( !bRet )
+    if( !m_poPool->PushJob(sJob) )
     {
-        delete poJob;
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        m_nPendingJobs --;
+        return false;
     }
-    return bRet;
+    {
+        // Wake up a worker thread of the pool waiting on this queue, which
+        // will run the job.
+        std::lock_guard<std::mutex> oGuard(m_mutex);
+        m_cv.notify_all();
+    }
+    m_poPool->WakeUpWorkers(1);
+    return true;
 }
 
 /************************************************************************/
@@ -578,6 +554,10 @@ bool CPLJobQueue::SubmitJob(CPLThreadFunc pfnFunc, void* pData)
 /************************************************************************/
 
 /** Wait for completion of part or whole jobs.
+ *
+ * When called from a worker thread of the pool, typically from a job
+ * that has submitted nested jobs, pending jobs of this queue are run by the
+ * calling thread while waiting, instead of blocking it.
  *
  * @param nMaxRemainingJobs Maximum number of pendings jobs that are allowed
  *                          in the queue after this method has completed. Might be
@@ -585,9 +565,26 @@ bool CPLJobQueue::SubmitJob(CPLThreadFunc pfnFunc, void* pData)
  */
 void CPLJobQueue::WaitCompletion(int nMaxRemainingJobs)
 {
+    CPLWorkerThread* psWT = nullptr;
+    const bool bHelp = m_poPool->IsCurrentThreadWorker(&psWT);
     std::unique_lock<std::mutex> oGuard(m_mutex);
     while( m_nPendingJobs > nMaxRemainingJobs )
     {
+        if( bHelp )
+        {
+            oGuard.unlock();
+            CPLWorkerThreadJob sJob;
+            const bool bFound = m_poPool->PopJob(psWT, this, sJob);
+            if( bFound )
+                m_poPool->RunJob(sJob);
+            oGuard.lock();
+            if( bFound )
+                continue;
+            // Remaining jobs are running in other threads, or will be
+            // submitted, which wakes us up.
+            if( m_nPendingJobs <= nMaxRemainingJobs )
+                break;
+        }
         m_cv.wait(oGuard);
     }
 }
@@ -33,7 +33,9 @@
 #include "cpl_multiproc.h"
 #include "cpl_list.h"
 
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -46,8 +48,15 @@
  */
 
 #ifndef DOXYGEN_SKIP
-struct CPLWorkerThreadJob;
 class CPLWorkerThreadPool;
+class CPLJobQueue;
+
+struct CPLWorkerThreadJob
+{
+    CPLThreadFunc  pfnFunc = nullptr;
+    void          *pData = nullptr;
+    CPLJobQueue   *poQueue = nullptr;
+};
 
 struct CPLWorkerThread
 {
@@ -58,10 +67,11 @@ struct CPLWorkerThread
     void                *pInitData = nullptr;
     CPLWorkerThreadPool *poTP = nullptr;
     CPLJoinableThread   *hThread = nullptr;
-    bool                 bMarkedAsWaiting = false;
 
-    std::mutex              m_mutex{};
-    std::condition_variable m_cv{};
+    // Jobs submitted from this thread. The thread pops them from the back,
+    // other threads steal them from the front.
+    std::mutex                     m_mutex{};
+    std::deque<CPLWorkerThreadJob> m_aoJobs{};
 };
 
 typedef enum
@@ -72,27 +82,45 @@ typedef enum
 } CPLWorkerThreadState;
 #endif  // ndef DOXYGEN_SKIP
 
-class CPLJobQueue;
-
-/** Pool of worker threads */
+/** Pool of worker threads.
+ *
+ * Starting with GDAL 3.4, jobs submitted from a worker thread of the pool go
+ * to a queue local to that thread, which it processes in last-in first-out
+ * order, and from which idle threads steal jobs. Jobs submitted from other
+ * threads go to a shared queue. Waiting for a CPLJobQueue from a worker
+ * thread of its pool runs the pending jobs of that queue, so that nested
+ * parallel sections do not deadlock.
+ */
 class CPL_DLL CPLWorkerThreadPool
 {
         CPL_DISALLOW_COPY_ASSIGN(CPLWorkerThreadPool)
 
         std::vector<std::unique_ptr<CPLWorkerThread>> aWT{};
+        std::atomic<int>        m_nThreads{0};
         std::mutex              m_mutex{};
         std::condition_variable m_cv{};
-        volatile CPLWorkerThreadState eState = CPLWTS_OK;
-        CPLList* psJobQueue = nullptr;
-        volatile int nPendingJobs = 0;
+        std::condition_variable m_cvWorkers{};
+        CPLWorkerThreadState    eState = CPLWTS_OK;
+        int                     m_nStartedThreads = 0;
+
+        std::mutex                     m_globalJobsMutex{};
+        std::deque<CPLWorkerThreadJob> m_aoGlobalJobs{};
 
-        CPLList* psWaitingWorkerThreadsList = nullptr;
-        int nWaitingWorkerThreads = 0;
+        std::atomic<int>        m_nQueuedJobs{0};
+        std::atomic<int>        nPendingJobs{0};
+        std::atomic<int>        nWaitingWorkerThreads{0};
 
         static void WorkerThreadFunction(void* user_data);
 
+        bool PushJob(const CPLWorkerThreadJob& sJob);
+        void WakeUpWorkers(int nJobs);
+        bool PopJob(CPLWorkerThread* psWorkerThread, const CPLJobQueue* poQueue,
+                    CPLWorkerThreadJob& sJob);
+        void RunJob(const CPLWorkerThreadJob& sJob);
         void DeclareJobFinished();
-        CPLWorkerThreadJob* GetNextJob(CPLWorkerThread* psWorkerThread);
+        bool IsCurrentThreadWorker(CPLWorkerThread** ppsWorkerThread) const;
+
+        friend class CPLJobQueue;
 
     public:
         CPLWorkerThreadPool();
@@ -115,10 +143,16 @@ class CPL_DLL CPLWorkerThreadPool
         void WaitEvent();
 
         /** Return the number of threads setup */
-        int GetThreadCount() const { return static_cast<int>(aWT.size()); }
+        int GetThreadCount() const { return m_nThreads.load(); }
 };
 
-/** Job queue */
+/** Job queue.
+ *
+ * A job queue is a group of jobs of a worker thread pool, whose completion
+ * can be waited for independently of the other jobs of the pool. Several job
+ * queues may share the same pool, and jobs may create their own job queue
+ * on the pool they run on.
+ */
 class CPL_DLL CPLJobQueue
 {
         CPL_DISALLOW_COPY_ASSIGN(CPLJobQueue)
@@ -127,7 +161,6 @@ class CPL_DLL CPLJobQueue
         std::condition_variable m_cv{};
         int m_nPendingJobs = 0;
 
-        static void JobQueueFunction(void*);
         void DeclareJobFinished();
 
 //! @cond Doxygen_Suppress
@@ -948,6 +948,15 @@ public:
   }
 %clear char **;
 
+%newobject GetReduction;
+%apply Pointer NONNULL {const char* operation};
+%apply (char **CSL) {char **};
+  GDALMDArrayHS* GetReduction(const char* operation, size_t iDim, char** options = 0)
+  {
+    return GDALMDArrayGetReduction(self, operation, iDim, options);
+  }
+%clear char **;
+
 %newobject AsClassicDataset;
   GDALDatasetShadow* AsClassicDataset(size_t iXDim, size_t iYDim)
   {
@@ -762,6 +762,97 @@ CPLErr ReadRaster1( double xoff, double yoff, double xsize, double ysize,
 %clear (int*);
 %clear (GIntBig*);
 
+%apply (int nList, int *pList ) { (int window_coords, int *pwindow_coords ) };
+%apply (int nList, int *pList ) { (int band_list, int *pband_list ) };
+%apply ( void **outPythonObject ) { (void **buf ) };
+%feature("kwargs") ReadRasterBatch1;
+CPLErr ReadRasterBatch1( int window_coords, int *pwindow_coords,
+                         void **buf,
+                         int band_list = 0, int *pband_list = 0 )
+{
+    *buf = NULL;
+
+    if( window_coords == 0 || (window_coords % 4) != 0 )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "window_coords should be a non-empty list of "
+                 "(xoff, yoff, xsize, ysize) values");
+        return CE_Failure;
+    }
+    const int nBandCount = band_list ? band_list : GDALGetRasterCount(self);
+    if( nBandCount <= 0 )
+        return CE_Failure;
+    const GDALDataType ntype = GDALGetRasterDataType(
+        GDALGetRasterBand(self, pband_list ? pband_list[0] : 1));
+    if( ntype == GDT_Unknown )
+        return CE_Failure;
+    const int ntypesize = GDALGetDataTypeSizeBytes( ntype );
+
+    /* Windows are read at full resolution, band sequential, and their */
+    /* buffers are concatenated in the output. */
+    const int nWindowCount = window_coords / 4;
+    std::vector<GDALRasterIOWindow> asWindows(nWindowCount);
+    size_t buf_size = 0;
+    for( int i = 0; i < nWindowCount; i++ )
+    {
+        GDALRasterIOWindow& sWindow = asWindows[i];
+        sWindow.nXOff = pwindow_coords[4 * i];
+        sWindow.nYOff = pwindow_coords[4 * i + 1];
+        sWindow.nXSize = pwindow_coords[4 * i + 2];
+        sWindow.nYSize = pwindow_coords[4 * i + 3];
+        sWindow.nBufXSize = sWindow.nXSize;
+        sWindow.nBufYSize = sWindow.nYSize;
+        sWindow.pData = NULL;
+        sWindow.nPixelSpace = 0;
+        sWindow.nLineSpace = 0;
+        sWindow.nBandSpace = 0;
+        if( sWindow.nXSize <= 0 || sWindow.nYSize <= 0 )
+        {
+            CPLError(CE_Failure, CPLE_IllegalArg, "Invalid window size");
+            return CE_Failure;
+        }
+        const GIntBig nWindowSize = static_cast<GIntBig>(sWindow.nXSize) *
+            sWindow.nYSize * ntypesize * nBandCount;
+        if( nWindowSize > static_cast<GIntBig>(INT_MAX) - static_cast<GIntBig>(buf_size) )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory, "Too large request");
+            return CE_Failure;
+        }
+        buf_size += static_cast<size_t>(nWindowSize);
+    }
+
+    char *data;
+    Py_buffer view;
+    void* inputOutputBuf = NULL;
+
+    if( !readraster_acquirebuffer(buf, inputOutputBuf, buf_size, ntype,
+                                  bUseExceptions, data, view) )
+    {
+        return CE_Failure;
+    }
+
+    size_t nOffset = 0;
+    for( int i = 0; i < nWindowCount; i++ )
+    {
+        GDALRasterIOWindow& sWindow = asWindows[i];
+        sWindow.pData = data + nOffset;
+        nOffset += static_cast<size_t>(sWindow.nXSize) *
+            sWindow.nYSize * ntypesize * nBandCount;
+    }
+
+    CPLErr eErr = GDALDatasetRasterIOBatch(self, nWindowCount, &asWindows[0],
+                                           ntype, band_list, pband_list,
+                                           NULL);
+
+    readraster_releasebuffer(eErr, buf, inputOutputBuf, view);
+
+    return eErr;
+}
+
+%clear (int window_coords, int *pwindow_coords );
+%clear (int band_list, int *pband_list );
+%clear (void **buf );
+
 %pythoncode %{
 
     def ReadAsArray(self, xoff=0, yoff=0, xsize=None, ysize=None, buf_obj=None,
@@ -854,6 +945,34 @@ CPLErr ReadRaster1( double xoff, double yoff, double xsize, double ysize,
                                             band_list, buf_pixel_space, buf_line_space, buf_band_space,
                                           resample_alg, callback, callback_data, buf_obj )
 
+    def ReadRasterBatch(self, windows, band_list=None):
+        """Read several full resolution windows at once, so that drivers can
+           fetch the data they need with fewer requests.
+           windows is a sequence of (xoff, yoff, xsize, ysize) tuples.
+           Returns a list with, for each window, its content as bytes,
+           band sequential, with the data type of the first requested band."""
+
+        window_coords = []
+        for window in windows:
+            if len(window) != 4:
+                raise ValueError('windows should be (xoff, yoff, xsize, ysize) tuples')
+            window_coords += [int(v) for v in window]
+        if not window_coords:
+            return []
+        if band_list is None:
+            band_list = list(range(1, self.RasterCount + 1))
+        buf = _gdal.Dataset_ReadRasterBatch1(self, window_coords, band_list)
+        if buf is None:
+            return None
+        dt_size = _gdal.GetDataTypeSize(self.GetRasterBand(band_list[0]).DataType) // 8
+        ret = []
+        offset = 0
+        for window in windows:
+            size = int(window[2]) * int(window[3]) * dt_size * len(band_list)
+            ret.append(buf[offset:offset + size])
+            offset += size
+        return ret
+
     def GetVirtualMemArray(self, eAccess=gdalconst.GF_Read, xoff=0, yoff=0,
                            xsize=None, ysize=None, bufxsize=None, bufysize=None,
                            datatype=None, band_list=None, band_sequential = True,
@@ -5443,6 +5443,86 @@ SWIGINTERN CPLErr GDALDatasetShadow_ReadRaster1(GDALDatasetShadow *self,double x
     return eErr;
 }
 
+SWIGINTERN CPLErr GDALDatasetShadow_ReadRasterBatch1(GDALDatasetShadow *self,int window_coords,int *pwindow_coords,void **buf,int band_list=0,int *pband_list=0){
+    *buf = NULL;
+
+    if( window_coords == 0 || (window_coords % 4) != 0 )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "window_coords should be a non-empty list of "
+                 "(xoff, yoff, xsize, ysize) values");
+        return CE_Failure;
+    }
+    const int nBandCount = band_list ? band_list : GDALGetRasterCount(self);
+    if( nBandCount <= 0 )
+        return CE_Failure;
+    const GDALDataType ntype = GDALGetRasterDataType(
+        GDALGetRasterBand(self, pband_list ? pband_list[0] : 1));
+    if( ntype == GDT_Unknown )
+        return CE_Failure;
+    const int ntypesize = GDALGetDataTypeSizeBytes( ntype );
+
+    /* Windows are read at full resolution, band sequential, and their */
+    /* buffers are concatenated in the output. */
+    const int nWindowCount = window_coords / 4;
+    std::vector<GDALRasterIOWindow> asWindows(nWindowCount);
+    size_t buf_size = 0;
+    for( int i = 0; i < nWindowCount; i++ )
+    {
+        GDALRasterIOWindow& sWindow = asWindows[i];
+        sWindow.nXOff = pwindow_coords[4 * i];
+        sWindow.nYOff = pwindow_coords[4 * i + 1];
+        sWindow.nXSize = pwindow_coords[4 * i + 2];
+        sWindow.nYSize = pwindow_coords[4 * i + 3];
+        sWindow.nBufXSize = sWindow.nXSize;
+        sWindow.nBufYSize = sWindow.nYSize;
+        sWindow.pData = NULL;
+        sWindow.nPixelSpace = 0;
+        sWindow.nLineSpace = 0;
+        sWindow.nBandSpace = 0;
+        if( sWindow.nXSize <= 0 || sWindow.nYSize <= 0 )
+        {
+            CPLError(CE_Failure, CPLE_IllegalArg, "Invalid window size");
+            return CE_Failure;
+        }
+        const GIntBig nWindowSize = static_cast<GIntBig>(sWindow.nXSize) *
+            sWindow.nYSize * ntypesize * nBandCount;
+        if( nWindowSize > static_cast<GIntBig>(INT_MAX) - static_cast<GIntBig>(buf_size) )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory, "Too large request");
+            return CE_Failure;
+        }
+        buf_size += static_cast<size_t>(nWindowSize);
+    }
+
+    char *data;
+    Py_buffer view;
+    void* inputOutputBuf = NULL;
+
+    if( !readraster_acquirebuffer(buf, inputOutputBuf, buf_size, ntype,
+                                  bUseExceptions, data, view) )
+    {
+        return CE_Failure;
+    }
+
+    size_t nOffset = 0;
+    for( int i = 0; i < nWindowCount; i++ )
+    {
+        GDALRasterIOWindow& sWindow = asWindows[i];
+        sWindow.pData = data + nOffset;
+        nOffset += static_cast<size_t>(sWindow.nXSize) *
+            sWindow.nYSize * ntypesize * nBandCount;
+    }
+
+    CPLErr eErr = GDALDatasetRasterIOBatch(self, nWindowCount, &asWindows[0],
+                                           ntype, band_list, pband_list,
+                                           NULL);
+
+    readraster_releasebuffer(eErr, buf, inputOutputBuf, view);
+
+    return eErr;
+}
+
 int GDALDatasetShadow_RasterXSize_get( GDALDatasetShadow *h ) {
   return GDALGetRasterXSize( h );
 }
@@ -6158,6 +6238,9 @@ SWIGINTERN GDALMDArrayHS *GDALMDArrayHS_GetUnscaled(GDALMDArrayHS *self){
 SWIGINTERN GDALMDArrayHS *GDALMDArrayHS_GetMask(GDALMDArrayHS *self,char **options=0){
     return GDALMDArrayGetMask(self, options);
   }
+SWIGINTERN GDALMDArrayHS *GDALMDArrayHS_GetReduction(GDALMDArrayHS *self,char const *operation,size_t iDim,char **options=0){
+    return GDALMDArrayGetReduction(self, operation, iDim, options);
+  }
 SWIGINTERN GDALDatasetShadow *GDALMDArrayHS_AsClassicDataset(GDALMDArrayHS *self,size_t iXDim,size_t iYDim){
     return (GDALDatasetShadow*)GDALMDArrayAsClassicDataset(self, iXDim, iYDim);
   }
@@ -21423,6 +21506,106 @@ fail:
 }
 
 
+SWIGINTERN PyObject *_wrap_Dataset_ReadRasterBatch1(PyObject *SWIGUNUSEDPARM(self), PyObject *args, PyObject *kwargs) {
+  PyObject *resultobj = 0; int bLocalUseExceptionsCode = bUseExceptions;
+  GDALDatasetShadow *arg1 = (GDALDatasetShadow *) 0 ;
+  int arg2 ;
+  int *arg3 = (int *) 0 ;
+  void **arg4 = (void **) 0 ;
+  int arg5 = (int) 0 ;
+  int *arg6 = (int *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  void *pyObject4 = NULL ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  char *  kwnames[] = {
+    (char *) "self",(char *) "window_coords",(char *) "band_list", NULL 
+  };
+  CPLErr result;
+  
+  {
+    /* %typemap(in,numinputs=0) ( void **outPythonObject ) ( void *pyObject4 = NULL ) */
+    arg4 = &pyObject4;
+  }
+  if (!PyArg_ParseTupleAndKeywords(args,kwargs,(char *)"OO|O:Dataset_ReadRasterBatch1",kwnames,&obj0,&obj1,&obj2)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_GDALDatasetShadow, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "Dataset_ReadRasterBatch1" "', argument " "1"" of type '" "GDALDatasetShadow *""'"); 
+  }
+  arg1 = reinterpret_cast< GDALDatasetShadow * >(argp1);
+  {
+    /* %typemap(in,numinputs=1) (int nList, int* pList)*/
+    arg3 = CreateCIntListFromSequence(obj1, &arg2);
+    if( arg2 < 0 ) {
+      SWIG_fail;
+    }
+  }
+  if (obj2) {
+    {
+      /* %typemap(in,numinputs=1) (int nList, int* pList)*/
+      arg6 = CreateCIntListFromSequence(obj2, &arg5);
+      if( arg5 < 0 ) {
+        SWIG_fail;
+      }
+    }
+  }
+  {
+    if ( bUseExceptions ) {
+      ClearErrorState();
+    }
+    {
+      SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+      CPL_IGNORE_RET_VAL(result = (CPLErr)GDALDatasetShadow_ReadRasterBatch1(arg1,arg2,arg3,arg4,arg5,arg6));
+      SWIG_PYTHON_THREAD_END_ALLOW;
+    }
+#ifndef SED_HACKS
+    if ( bUseExceptions ) {
+      CPLErr eclass = CPLGetLastErrorType();
+      if ( eclass == CE_Failure || eclass == CE_Fatal ) {
+        SWIG_exception( SWIG_RuntimeError, CPLGetLastErrorMsg() );
+      }
+    }
+#endif
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  {
+    /* %typemap(argout) ( void **outPythonObject ) */
+    Py_XDECREF(resultobj);
+    if (*arg4)
+    {
+      resultobj = (PyObject*)*arg4;
+    }
+    else
+    {
+      resultobj = Py_None;
+      Py_INCREF(resultobj);
+    }
+  }
+  {
+    /* %typemap(freearg) (int nList, int* pList) */
+    free(arg3);
+  }
+  {
+    /* %typemap(freearg) (int nList, int* pList) */
+    free(arg6);
+  }
+  if ( ReturnSame(bLocalUseExceptionsCode) ) { CPLErr eclass = CPLGetLastErrorType(); if ( eclass == CE_Failure || eclass == CE_Fatal ) { Py_XDECREF(resultobj); SWIG_Error( SWIG_RuntimeError, CPLGetLastErrorMsg() ); return NULL; } }
+  return resultobj;
+fail:
+  {
+    /* %typemap(freearg) (int nList, int* pList) */
+    free(arg3);
+  }
+  {
+    /* %typemap(freearg) (int nList, int* pList) */
+    free(arg6);
+  }
+  return NULL;
+}
+
+
 SWIGINTERN PyObject *Dataset_swigregister(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *obj;
   if (!PyArg_ParseTuple(args,(char *)"O:swigregister", &obj)) return NULL;
@@ -26094,6 +26277,93 @@ fail:
 }
 
 
+SWIGINTERN PyObject *_wrap_MDArray_GetReduction(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0; int bLocalUseExceptionsCode = bUseExceptions;
+  GDALMDArrayHS *arg1 = (GDALMDArrayHS *) 0 ;
+  char *arg2 = (char *) 0 ;
+  size_t arg3 ;
+  char **arg4 = (char **) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int res2 ;
+  char *buf2 = 0 ;
+  int alloc2 = 0 ;
+  size_t val3 ;
+  int ecode3 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  GDALMDArrayHS *result = 0 ;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OOO|O:MDArray_GetReduction",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_GDALMDArrayHS, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "MDArray_GetReduction" "', argument " "1"" of type '" "GDALMDArrayHS *""'"); 
+  }
+  arg1 = reinterpret_cast< GDALMDArrayHS * >(argp1);
+  res2 = SWIG_AsCharPtrAndSize(obj1, &buf2, NULL, &alloc2);
+  if (!SWIG_IsOK(res2)) {
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "MDArray_GetReduction" "', argument " "2"" of type '" "char const *""'");
+  }
+  arg2 = reinterpret_cast< char * >(buf2);
+  ecode3 = SWIG_AsVal_size_t(obj2, &val3);
+  if (!SWIG_IsOK(ecode3)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode3), "in method '" "MDArray_GetReduction" "', argument " "3"" of type '" "size_t""'");
+  } 
+  arg3 = static_cast< size_t >(val3);
+  if (obj3) {
+    {
+      /* %typemap(in) char **options */
+      int bErr = FALSE;
+      arg4 = CSLFromPySequence(obj3, &bErr);
+      if( bErr )
+      {
+        SWIG_fail;
+      }
+    }
+  }
+  {
+    if (!arg2) {
+      SWIG_exception(SWIG_ValueError,"Received a NULL pointer.");
+    }
+  }
+  {
+    if ( bUseExceptions ) {
+      ClearErrorState();
+    }
+    {
+      SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+      result = (GDALMDArrayHS *)GDALMDArrayHS_GetReduction(arg1,(char const *)arg2,arg3,arg4);
+      SWIG_PYTHON_THREAD_END_ALLOW;
+    }
+#ifndef SED_HACKS
+    if ( bUseExceptions ) {
+      CPLErr eclass = CPLGetLastErrorType();
+      if ( eclass == CE_Failure || eclass == CE_Fatal ) {
+        SWIG_exception( SWIG_RuntimeError, CPLGetLastErrorMsg() );
+      }
+    }
+#endif
+  }
+  resultobj = SWIG_NewPointerObj(SWIG_as_voidptr(result), SWIGTYPE_p_GDALMDArrayHS, SWIG_POINTER_OWN |  0 );
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  {
+    /* %typemap(freearg) char **options */
+    CSLDestroy( arg4 );
+  }
+  if ( ReturnSame(bLocalUseExceptionsCode) ) { CPLErr eclass = CPLGetLastErrorType(); if ( eclass == CE_Failure || eclass == CE_Fatal ) { Py_XDECREF(resultobj); SWIG_Error( SWIG_RuntimeError, CPLGetLastErrorMsg() ); return NULL; } }
+  return resultobj;
+fail:
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  {
+    /* %typemap(freearg) char **options */
+    CSLDestroy( arg4 );
+  }
+  return NULL;
+}
+
+
 SWIGINTERN PyObject *_wrap_MDArray_AsClassicDataset(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *resultobj = 0; int bLocalUseExceptionsCode = bUseExceptions;
   GDALMDArrayHS *arg1 = (GDALMDArrayHS *) 0 ;
@@ -43815,6 +44085,7 @@ static PyMethodDef SwigMethods[] = {
 	 { (char *)"Dataset_GetFieldDomain", _wrap_Dataset_GetFieldDomain, METH_VARARGS, (char *)"Dataset_GetFieldDomain(Dataset self, char const * name) -> FieldDomain"},
 	 { (char *)"Dataset_AddFieldDomain", _wrap_Dataset_AddFieldDomain, METH_VARARGS, (char *)"Dataset_AddFieldDomain(Dataset self, FieldDomain fieldDomain) -> bool"},
 	 { (char *)"Dataset_ReadRaster1", (PyCFunction) _wrap_Dataset_ReadRaster1, METH_VARARGS | METH_KEYWORDS, (char *)"Dataset_ReadRaster1(Dataset self, double xoff, double yoff, double xsize, double ysize, int * buf_xsize=None, int * buf_ysize=None, GDALDataType * buf_type=None, int band_list=0, GIntBig * buf_pixel_space=None, GIntBig * buf_line_space=None, GIntBig * buf_band_space=None, GDALRIOResampleAlg resample_alg, GDALProgressFunc callback=0, void * callback_data=None, void * inputOutputBuf=None) -> CPLErr"},
+	 { (char *)"Dataset_ReadRasterBatch1", (PyCFunction) _wrap_Dataset_ReadRasterBatch1, METH_VARARGS | METH_KEYWORDS, (char *)"Dataset_ReadRasterBatch1(Dataset self, int window_coords, int band_list=0) -> CPLErr"},
 	 { (char *)"Dataset_swigregister", Dataset_swigregister, METH_VARARGS, NULL},
 	 { (char *)"delete_Group", _wrap_delete_Group, METH_VARARGS, (char *)"delete_Group(Group self)"},
 	 { (char *)"Group_GetName", _wrap_Group_GetName, METH_VARARGS, (char *)"Group_GetName(Group self) -> char const *"},
@@ -43884,6 +44155,7 @@ static PyMethodDef SwigMethods[] = {
 	 { (char *)"MDArray_Transpose", _wrap_MDArray_Transpose, METH_VARARGS, (char *)"MDArray_Transpose(MDArray self, int nList) -> MDArray"},
 	 { (char *)"MDArray_GetUnscaled", _wrap_MDArray_GetUnscaled, METH_VARARGS, (char *)"MDArray_GetUnscaled(MDArray self) -> MDArray"},
 	 { (char *)"MDArray_GetMask", _wrap_MDArray_GetMask, METH_VARARGS, (char *)"MDArray_GetMask(MDArray self, char ** options=None) -> MDArray"},
+	 { (char *)"MDArray_GetReduction", _wrap_MDArray_GetReduction, METH_VARARGS, (char *)"MDArray_GetReduction(MDArray self, char const * operation, size_t iDim, char ** options=None) -> MDArray"},
 	 { (char *)"MDArray_AsClassicDataset", _wrap_MDArray_AsClassicDataset, METH_VARARGS, (char *)"MDArray_AsClassicDataset(MDArray self, size_t iXDim, size_t iYDim) -> Dataset"},
 	 { (char *)"MDArray_GetStatistics", (PyCFunction) _wrap_MDArray_GetStatistics, METH_VARARGS | METH_KEYWORDS, (char *)"MDArray_GetStatistics(MDArray self, Dataset ds=None, bool approx_ok=False, bool force=True, GDALProgressFunc callback=0, void * callback_data=None) -> Statistics"},
 	 { (char *)"MDArray_ComputeStatistics", (PyCFunction) _wrap_MDArray_ComputeStatistics, METH_VARARGS | METH_KEYWORDS, (char *)"MDArray_ComputeStatistics(MDArray self, Dataset ds=None, bool approx_ok=False, GDALProgressFunc callback=0, void * callback_data=None) -> Statistics"},
@@ -44,8 +44,9 @@ gdal_proximity.py srcfile dstfile [-srcband n] [-dstband n]
                   [-of format] [-co name=value]*
                   [-ot Byte/UInt16/UInt32/Float32/etc]
                   [-values n,n,n] [-distunits PIXEL/GEO]
-                  [-maxdist n] [-nodata n] [-use_input_nodata YES/NO]
-                  [-fixed-buf-val n] [-q] """)
+                  [-maxdist n] [-mindist n] [-nodata n]
+                  [-use_input_nodata YES/NO] [-fixed-buf-val n]
+                  [-num_threads n/ALL_CPUS] [-q] """)
     return 1
 
 
@@ -85,6 +86,14 @@ def main(argv):
             i = i + 1
             alg_options.append('MAXDIST=' + argv[i])
 
+        elif arg == '-mindist':
+            i = i + 1
+            alg_options.append('MINDIST=' + argv[i])
+
+        elif arg == '-num_threads':
+            i = i + 1
+            alg_options.append('NUM_THREADS=' + argv[i])
+
         elif arg == '-values':
             i = i + 1
             alg_options.append('VALUES=' + argv[i])
@@ -2496,6 +2496,11 @@ class Dataset(MajorObject):
         return _gdal.Dataset_ReadRaster1(self, *args, **kwargs)
 
 
+    def ReadRasterBatch1(self, *args, **kwargs):
+        """ReadRasterBatch1(Dataset self, int window_coords, int band_list=0) -> CPLErr"""
+        return _gdal.Dataset_ReadRasterBatch1(self, *args, **kwargs)
+
+
 
     def ReadAsArray(self, xoff=0, yoff=0, xsize=None, ysize=None, buf_obj=None,
                     buf_xsize=None, buf_ysize=None, buf_type=None,
@@ -2587,6 +2592,34 @@ class Dataset(MajorObject):
                                             band_list, buf_pixel_space, buf_line_space, buf_band_space,
                                           resample_alg, callback, callback_data, buf_obj )
 
+    def ReadRasterBatch(self, windows, band_list=None):
+        """Read several full resolution windows at once, so that drivers can
+           fetch the data they need with fewer requests.
+           windows is a sequence of (xoff, yoff, xsize, ysize) tuples.
+           Returns a list with, for each window, its content as bytes,
+           band sequential, with the data type of the first requested band."""
+
+        window_coords = []
+        for window in windows:
+            if len(window) != 4:
+                raise ValueError('windows should be (xoff, yoff, xsize, ysize) tuples')
+            window_coords += [int(v) for v in window]
+        if not window_coords:
+            return []
+        if band_list is None:
+            band_list = list(range(1, self.RasterCount + 1))
+        buf = _gdal.Dataset_ReadRasterBatch1(self, window_coords, band_list)
+        if buf is None:
+            return None
+        dt_size = _gdal.GetDataTypeSize(self.GetRasterBand(band_list[0]).DataType) // 8
+        ret = []
+        offset = 0
+        for window in windows:
+            size = int(window[2]) * int(window[3]) * dt_size * len(band_list)
+            ret.append(buf[offset:offset + size])
+            offset += size
+        return ret
+
     def GetVirtualMemArray(self, eAccess=gdalconst.GF_Read, xoff=0, yoff=0,
                            xsize=None, ysize=None, bufxsize=None, bufysize=None,
                            datatype=None, band_list=None, band_sequential = True,
@@ -3076,6 +3109,11 @@ class MDArray(_object):
         return _gdal.MDArray_GetMask(self, *args)
 
 
+    def GetReduction(self, *args):
+        """GetReduction(MDArray self, char const * operation, size_t iDim, char ** options=None) -> MDArray"""
+        return _gdal.MDArray_GetReduction(self, *args)
+
+
     def AsClassicDataset(self, *args):
         """AsClassicDataset(MDArray self, size_t iXDim, size_t iYDim) -> Dataset"""
         return _gdal.MDArray_AsClassicDataset(self, *args)